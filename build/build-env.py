@@ -282,6 +282,9 @@ def Environment():
                                        allowed_values=('cusp', 'cblas', 'cublas'))
     vars.Add(deviceblas_variable)
 
+    # add a variable to mark cusp entry points with NVTX ranges
+    vars.Add(BoolVariable('nvtx', 'Emit NVTX profiler ranges', 0))
+
     # create an Environment
     env = OldEnvironment(tools=getTools(), variables=vars)
 
@@ -318,6 +321,10 @@ def Environment():
     env.Append(CFLAGS   = ['-DCUSP_HOST_BLAS_SYSTEM=%s' % host_blas_backend_define])
     env.Append(CXXFLAGS = ['-DCUSP_HOST_BLAS_SYSTEM=%s' % host_blas_backend_define])
 
+    if env['nvtx']:
+        env.Append(CFLAGS   = ['-DCUSP_NVTX_RANGES=1'])
+        env.Append(CXXFLAGS = ['-DCUSP_NVTX_RANGES=1'])
+
     # get C compiler switches
     env.Append(CFLAGS=getCFLAGS(env['mode'], env['backend'], env['Wall'], env['Werror'], env['hostspblas'], env.subst('$CC')))
 
@@ -387,6 +394,9 @@ def Environment():
     if env['deviceblas'] == 'cublas':
         env.Append(LIBS=['cublas'])
 
+    if env['nvtx']:
+        env.Append(LIBS=['nvToolsExt'])
+
     if env['hostspblas'] == 'mkl':
         intel_lib = 'mkl_intel'
         if platform.machine()[-2:] == '64':
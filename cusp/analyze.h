@@ -0,0 +1,202 @@
+/*
+ *  Copyright 2008-2014 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+
+/*! \file analyze.h
+ *  \brief Structure analysis and storage format prediction for sparse matrices
+ */
+
+#pragma once
+
+#include <cusp/detail/config.h>
+
+#include <cusp/detail/execution_policy.h>
+
+#include <cstddef>
+
+namespace cusp
+{
+
+/*! \addtogroup algorithms Algorithms
+ *  \addtogroup matrix_algorithms Matrix Algorithms
+ *  \ingroup algorithms
+ *  \{
+ */
+
+/*! \brief Sparse storage formats considered by \p cusp::predict_storage.
+ */
+enum matrix_storage
+{
+    /*! \p cusp::coo_matrix */
+    coo_storage,
+
+    /*! \p cusp::csr_matrix */
+    csr_storage,
+
+    /*! \p cusp::dia_matrix */
+    dia_storage,
+
+    /*! \p cusp::ell_matrix */
+    ell_storage,
+
+    /*! \p cusp::hyb_matrix */
+    hyb_storage
+};
+
+/*! \brief Summary of the sparsity structure of a matrix computed by
+ * \p cusp::analyze.
+ *
+ * \par Overview
+ *  The fill ratios relate the number of values a format would store to the
+ *  number of entries of the matrix, a ratio of 1 means the format stores no
+ *  padding.
+ */
+struct matrix_profile
+{
+    /*! Number of rows. */
+    size_t num_rows;
+
+    /*! Number of columns. */
+    size_t num_cols;
+
+    /*! Number of stored entries. */
+    size_t num_entries;
+
+    /*! Length of the shortest row. */
+    size_t min_entries_per_row;
+
+    /*! Length of the longest row. */
+    size_t max_entries_per_row;
+
+    /*! Average row length. */
+    double mean_entries_per_row;
+
+    /*! Standard deviation of the row lengths. */
+    double stddev_entries_per_row;
+
+    /*! Number of occupied diagonals. */
+    size_t num_diagonals;
+
+    /*! Width of the ELL part of a \p hyb_matrix, see
+     * \p cusp::compute_optimal_entries_per_row. */
+    size_t optimal_entries_per_row;
+
+    /*! Values stored by a \p dia_matrix per entry. */
+    double dia_fill_ratio;
+
+    /*! Values stored by an \p ell_matrix per entry. */
+    double ell_fill_ratio;
+
+    matrix_profile(void)
+        : num_rows(0), num_cols(0), num_entries(0),
+          min_entries_per_row(0), max_entries_per_row(0),
+          mean_entries_per_row(0), stddev_entries_per_row(0),
+          num_diagonals(0), optimal_entries_per_row(0),
+          dia_fill_ratio(0), ell_fill_ratio(0) {}
+};
+
+/* \cond */
+template <typename DerivedPolicy,
+          typename MatrixType>
+cusp::matrix_profile
+analyze(const thrust::detail::execution_policy_base<DerivedPolicy>& exec,
+        const MatrixType& A);
+/* \endcond */
+
+/**
+ * \brief Compute the structure profile of a matrix
+ *
+ * \tparam MatrixType Type of input matrix
+ *
+ * \param A input matrix, \p coo_matrix and \p csr_matrix are analyzed in
+ * place, other formats are converted to \p coo_matrix first
+ * \return the \p matrix_profile of \p A
+ *
+ * \par Example
+ * \code
+ * #include <cusp/analyze.h>
+ * #include <cusp/csr_matrix.h>
+ * #include <cusp/gallery/poisson.h>
+ *
+ * #include <iostream>
+ *
+ * int main()
+ * {
+ *   // initialize 5x5 poisson matrix
+ *   cusp::csr_matrix<int,float,cusp::device_memory> A;
+ *   cusp::gallery::poisson5pt(A, 5, 5);
+ *
+ *   cusp::matrix_profile profile = cusp::analyze(A);
+ *
+ *   // prints 5
+ *   std::cout << profile.num_diagonals << std::endl;
+ * }
+ * \endcode
+ */
+template <typename MatrixType>
+cusp::matrix_profile
+analyze(const MatrixType& A);
+
+/* \cond */
+template <typename DerivedPolicy>
+cusp::matrix_storage
+predict_storage(const thrust::detail::execution_policy_base<DerivedPolicy>& exec,
+                const cusp::matrix_profile& profile);
+/* \endcond */
+
+/**
+ * \brief Predict the storage format with the fastest \p multiply for a
+ * matrix structure
+ *
+ * \tparam MemorySpace memory space whose system performs the \p multiply
+ *
+ * \param profile structure profile computed by \p cusp::analyze
+ * \return the predicted format
+ *
+ * \par Overview
+ *  The host systems predict \p csr_storage for every structure. The CUDA
+ *  system predicts \p dia_storage for banded matrices whose diagonals are
+ *  at least half full, \p ell_storage when the longest row is at most 1.5
+ *  times the average row, \p hyb_storage when enough rows fill an ELL part
+ *  and \p csr_storage otherwise. The prediction is a heuristic,
+ *  \p cusp::auto_matrix can confirm it with a timed trial.
+ *
+ * \par Example
+ * \code
+ * #include <cusp/analyze.h>
+ * #include <cusp/csr_matrix.h>
+ * #include <cusp/gallery/poisson.h>
+ *
+ * int main()
+ * {
+ *   cusp::csr_matrix<int,float,cusp::device_memory> A;
+ *   cusp::gallery::poisson5pt(A, 256, 256);
+ *
+ *   // dia_storage when compiled for the CUDA device system
+ *   cusp::matrix_storage storage =
+ *     cusp::predict_storage<cusp::device_memory>(cusp::analyze(A));
+ * }
+ * \endcode
+ */
+template <typename MemorySpace>
+cusp::matrix_storage
+predict_storage(const cusp::matrix_profile& profile);
+/*! \}
+ */
+
+} // end namespace cusp
+
+#include <cusp/detail/analyze.inl>
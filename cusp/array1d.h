@@ -141,6 +141,16 @@ public:
     explicit array1d(size_type n, const value_type &value)
         : Parent(n, value) {}
 
+    /*! This constructor creates a \p array1d vector with the given
+     *  size without initializing the elements.
+     *  \param n The number of elements to initially create.
+     */
+    array1d(size_type n, cusp::no_init_t)
+        : Parent()
+    {
+        resize(n, cusp::no_init);
+    }
+
     /*! Copy constructor copies from an exemplar \p array1d
      *  \param v The \p array1d to copy.
      */
@@ -306,6 +316,14 @@ public:
      */
     const_view subarray(size_type start_index, size_type num_entries) const;
 
+    using Parent::resize;
+
+    /*! Resize this \p array1d without initializing the new elements. The
+     *  first min(size(), new_size) elements are preserved.
+     *  \param new_size Number of elements this array1d should contain.
+     */
+    void resize(size_type new_size, cusp::no_init_t);
+
 }; // end class array1d
 /*! \}
  */
@@ -476,6 +494,14 @@ public :
      */
     void resize(size_type new_size);
 
+    /*! A view never initializes its elements, this is the same as
+     *  resize(new_size).
+     */
+    void resize(size_type new_size, cusp::no_init_t)
+    {
+        resize(new_size);
+    }
+
     /*! Extract a small vector from a \p array1d_view vector.
      *  \param start_index The starting index of the sub-array.
      *  \param num_entries The number of entries in the sub-array.
@@ -0,0 +1,212 @@
+/*
+ *  Copyright 2008-2014 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*! \file assemble.h
+ *  \brief Assembly of sparse matrices from unordered triplets.
+ */
+
+#pragma once
+
+#include <cusp/detail/config.h>
+
+#include <cusp/detail/execution_policy.h>
+
+namespace cusp
+{
+
+/*! \addtogroup algorithms Algorithms
+ *  \addtogroup matrix_algorithms Matrix Algorithms
+ *  \ingroup algorithms
+ *  \{
+ */
+
+/*! \cond */
+template <typename DerivedPolicy,
+          typename ArrayType1,
+          typename ArrayType2,
+          typename ArrayType3,
+          typename MatrixType>
+void assemble(const thrust::detail::execution_policy_base<DerivedPolicy>& exec,
+              const size_t num_rows,
+              const size_t num_cols,
+              const ArrayType1& row_indices,
+              const ArrayType2& column_indices,
+              const ArrayType3& values,
+                    MatrixType& A);
+/*! \endcond */
+
+/**
+ * \brief Build a sparse matrix from unordered (i,j,v) triplets
+ *
+ * \tparam ArrayType1 Type of triplet row indices
+ * \tparam ArrayType2 Type of triplet column indices
+ * \tparam ArrayType3 Type of triplet values
+ * \tparam MatrixType Type of output matrix
+ *
+ * \param num_rows number of rows of the output matrix
+ * \param num_cols number of columns of the output matrix
+ * \param row_indices row index of every triplet
+ * \param column_indices column index of every triplet
+ * \param values value of every triplet
+ * \param A output matrix
+ *
+ * \par Overview
+ *  The triplets may appear in any order and the values of triplets with the
+ *  same (i,j) index are summed, which is the usual outcome of finite-element
+ *  assembly where every element contributes to the entries it touches. The
+ *  entries of \p A are sorted by row and column.
+ *
+ *  The generic implementation sorts the triplets and reduces the duplicates.
+ *  On the CUDA system, triplets with \c int indices and \c float or \c double
+ *  values are accumulated in a hash table instead, so only the distinct
+ *  entries of \p A are sorted.
+ *
+ * \par Example
+ *  The following code snippet demonstrates how to use \p assemble.
+ *
+ *  \code
+ *  #include <cusp/array1d.h>
+ *  #include <cusp/assemble.h>
+ *  #include <cusp/csr_matrix.h>
+ *  #include <cusp/print.h>
+ *
+ *  int main(void)
+ *  {
+ *      // unordered triplets with duplicates
+ *      cusp::array1d<int,  cusp::device_memory> I(5);
+ *      cusp::array1d<int,  cusp::device_memory> J(5);
+ *      cusp::array1d<float,cusp::device_memory> V(5);
+ *
+ *      I[0] = 2; J[0] = 0; V[0] = 10;
+ *      I[1] = 0; J[1] = 2; V[1] = 10;
+ *      I[2] = 2; J[2] = 0; V[2] = 10;
+ *      I[3] = 1; J[3] = 1; V[3] = 10;
+ *      I[4] = 0; J[4] = 2; V[4] = 10;
+ *
+ *      // build a 3x3 matrix with 3 nonzeros
+ *      cusp::csr_matrix<int,float,cusp::device_memory> A;
+ *      cusp::assemble(3, 3, I, J, V, A);
+ *
+ *      // print A
+ *      cusp::print(A);
+ *
+ *      return 0;
+ *  }
+ *  \endcode
+ */
+template <typename ArrayType1,
+          typename ArrayType2,
+          typename ArrayType3,
+          typename MatrixType>
+void assemble(const size_t num_rows,
+              const size_t num_cols,
+              const ArrayType1& row_indices,
+              const ArrayType2& column_indices,
+              const ArrayType3& values,
+                    MatrixType& A);
+
+/*! \cond */
+template <typename DerivedPolicy,
+          typename ArrayType1,
+          typename ArrayType2,
+          typename ArrayType3,
+          typename MatrixType>
+void assemble_values(const thrust::detail::execution_policy_base<DerivedPolicy>& exec,
+                     const ArrayType1& row_indices,
+                     const ArrayType2& column_indices,
+                     const ArrayType3& values,
+                           MatrixType& A);
+/*! \endcond */
+
+/**
+ * \brief Assemble unordered (i,j,v) triplets into the values of a matrix
+ * with a known sparsity pattern
+ *
+ * \tparam ArrayType1 Type of triplet row indices
+ * \tparam ArrayType2 Type of triplet column indices
+ * \tparam ArrayType3 Type of triplet values
+ * \tparam MatrixType Type of output matrix
+ *
+ * \param row_indices row index of every triplet
+ * \param column_indices column index of every triplet
+ * \param values value of every triplet
+ * \param A \p csr_matrix or \p coo_matrix holding the pattern
+ *
+ * \par Overview
+ *  The structure of \p A is left unchanged and its values are overwritten
+ *  with the sum of the triplets that fall on each entry, entries without any
+ *  triplet become zero. This is the fast path for repeated assembly, e.g.
+ *  once per time step, into a pattern built by \p assemble: every triplet
+ *  is located with a binary search over the columns of its row and, on the
+ *  CUDA system with \c float or \c double values, added with an atomic
+ *  operation.
+ *
+ *  The columns of every row of \p A must be sorted.
+ *
+ * \throws cusp::invalid_input_exception if a triplet falls outside the
+ * pattern, in which case \p A is not modified.
+ *
+ * \par Example
+ *  The following code snippet demonstrates how to use \p assemble_values.
+ *
+ *  \code
+ *  #include <cusp/array1d.h>
+ *  #include <cusp/assemble.h>
+ *  #include <cusp/csr_matrix.h>
+ *  #include <cusp/print.h>
+ *
+ *  int main(void)
+ *  {
+ *      // unordered triplets with duplicates
+ *      cusp::array1d<int,  cusp::device_memory> I(5);
+ *      cusp::array1d<int,  cusp::device_memory> J(5);
+ *      cusp::array1d<float,cusp::device_memory> V(5);
+ *
+ *      I[0] = 2; J[0] = 0; V[0] = 10;
+ *      I[1] = 0; J[1] = 2; V[1] = 10;
+ *      I[2] = 2; J[2] = 0; V[2] = 10;
+ *      I[3] = 1; J[3] = 1; V[3] = 10;
+ *      I[4] = 0; J[4] = 2; V[4] = 10;
+ *
+ *      // build the pattern once
+ *      cusp::csr_matrix<int,float,cusp::device_memory> A;
+ *      cusp::assemble(3, 3, I, J, V, A);
+ *
+ *      // reassemble new values into the same pattern
+ *      V[3] = 20;
+ *      cusp::assemble_values(I, J, V, A);
+ *
+ *      // print A
+ *      cusp::print(A);
+ *
+ *      return 0;
+ *  }
+ *  \endcode
+ */
+template <typename ArrayType1,
+          typename ArrayType2,
+          typename ArrayType3,
+          typename MatrixType>
+void assemble_values(const ArrayType1& row_indices,
+                     const ArrayType2& column_indices,
+                     const ArrayType3& values,
+                           MatrixType& A);
+/*! \}
+ */
+
+} // end namespace cusp
+
+#include <cusp/detail/assemble.inl>
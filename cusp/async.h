@@ -0,0 +1,269 @@
+/*
+ *  Copyright 2008-2014 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+
+/*! \file async.h
+ *  \brief Asynchronous variants of multiply, convert, transpose and the
+ *  Krylov solvers
+ */
+
+#pragma once
+
+#include <cusp/detail/config.h>
+#include <cusp/detail/execution_policy.h>
+
+#if __cplusplus >= 201103L
+#include <future>
+#endif
+
+namespace cusp
+{
+namespace detail
+{
+/* \cond */
+class completion_state;
+/* \endcond */
+} // end namespace detail
+
+/*! \addtogroup utilities Utilities
+ *  \{
+ */
+
+/**
+ * \brief Handle to device work started by an asynchronous cusp call
+ *
+ * \par Overview
+ *  A \p completion_event owns a CUDA event recorded on the stream of the
+ *  call after its last kernel. Copies of a \p completion_event share the
+ *  event, it is destroyed with the last copy. Work on host memory
+ *  completes before the call returns and yields an event that already
+ *  completed. Copies must not be shared between threads.
+ */
+class completion_event
+{
+public:
+
+    /*! Construct a \p completion_event of work which already completed.
+     */
+    completion_event(void);
+
+    /*! \cond */
+    explicit completion_event(detail::completion_state* state);
+    /*! \endcond */
+
+    /*! Copy constructor, shares the event of \p other.
+     */
+    completion_event(const completion_event& other);
+
+    /*! Assignment operator, shares the event of \p other.
+     */
+    completion_event& operator=(const completion_event& other);
+
+    /*! Destructor, releases the event if this is its last handle without
+     *  waiting for the work.
+     */
+    ~completion_event(void);
+
+    /*! Return \c true if the work completed.
+     */
+    bool ready(void) const;
+
+    /*! Block until the work completed.
+     */
+    void wait(void) const;
+
+private:
+
+    detail::completion_state* state;
+
+    void release(void);
+};
+
+/**
+ * \brief Compute a product with \p cusp::multiply without waiting for
+ * the device
+ *
+ * \tparam DerivedPolicy execution policy, e.g. \c cusp::cuda::par.on(stream)
+ *
+ * \param exec execution policy whose stream runs the product
+ * \param A matrix or \p linear_operator
+ * \param B input vector or matrix
+ * \param C output vector or matrix
+ *
+ * \return a \p completion_event which completes with the product
+ *
+ * \par Overview
+ *  The kernels of the product are queued on the stream of \p exec and an
+ *  event is recorded after them, so the host thread may upload the next
+ *  right hand side or run other work while the device computes. \p A,
+ *  \p B and \p C must remain valid until the event completed and host
+ *  accesses to \p C must call \c wait first.
+ *
+ *  Sparse matrix-vector products do not wait for the device. Products
+ *  whose output size depends on the input, such as sparse matrix-matrix
+ *  products, read that size back before allocating \p C and therefore
+ *  return after the size is known; their remaining kernels still run
+ *  asynchronously.
+ *
+ * \par Example
+ *  \code
+ *  #include <cusp/async.h>
+ *  #include <cusp/csr_matrix.h>
+ *  #include <cusp/gallery/poisson.h>
+ *
+ *  int main(void)
+ *  {
+ *      cusp::csr_matrix<int,float,cusp::device_memory> A;
+ *      cusp::gallery::poisson5pt(A, 256, 256);
+ *
+ *      cusp::array1d<float,cusp::device_memory> x(A.num_cols, 1);
+ *      cusp::array1d<float,cusp::device_memory> y(A.num_rows);
+ *
+ *      cudaStream_t s;
+ *      cudaStreamCreate(&s);
+ *
+ *      cusp::completion_event done = cusp::multiply_async(cusp::cuda::par.on(s), A, x, y);
+ *
+ *      // host work overlapping the product
+ *
+ *      done.wait();
+ *      cudaStreamDestroy(s);
+ *
+ *      return 0;
+ *  }
+ *  \endcode
+ */
+template <typename DerivedPolicy,
+          typename LinearOperator,
+          typename MatrixOrVector1,
+          typename MatrixOrVector2>
+completion_event multiply_async(const thrust::detail::execution_policy_base<DerivedPolicy>& exec,
+                                const LinearOperator&  A,
+                                const MatrixOrVector1& B,
+                                      MatrixOrVector2& C);
+
+/**
+ * \brief Compute a product on the default stream of the memory space of
+ * the operands, see \p multiply_async above.
+ */
+template <typename LinearOperator,
+          typename MatrixOrVector1,
+          typename MatrixOrVector2>
+completion_event multiply_async(const LinearOperator&  A,
+                                const MatrixOrVector1& B,
+                                      MatrixOrVector2& C);
+
+/**
+ * \brief Convert a matrix with \p cusp::convert without waiting for the
+ * device
+ *
+ * \param exec execution policy whose stream runs the conversion
+ * \param src source matrix
+ * \param dst destination matrix
+ *
+ * \return a \p completion_event which completes with the conversion
+ *
+ * \par Overview
+ *  Conversions read sizes back from the device to allocate \p dst, such
+ *  as the number of occupied diagonals or the width of the ELL part, so
+ *  the call returns once \p dst is allocated while its fill kernels may
+ *  still be running.
+ */
+template <typename DerivedPolicy,
+          typename SourceType,
+          typename DestinationType>
+completion_event convert_async(const thrust::detail::execution_policy_base<DerivedPolicy>& exec,
+                               const SourceType& src,
+                                     DestinationType& dst);
+
+/**
+ * \brief Transpose a matrix with \p cusp::transpose without waiting for
+ * the device
+ *
+ * \param exec execution policy whose stream runs the transpose
+ * \param A input matrix
+ * \param At output matrix
+ *
+ * \return a \p completion_event which completes with the transpose
+ *
+ * \par Overview
+ *  Like \p convert_async the call may wait for sizes computed on the
+ *  device before it allocates \p At.
+ */
+template <typename DerivedPolicy,
+          typename MatrixType1,
+          typename MatrixType2>
+completion_event transpose_async(const thrust::detail::execution_policy_base<DerivedPolicy>& exec,
+                                 const MatrixType1& A,
+                                       MatrixType2& At);
+
+#if __cplusplus >= 201103L
+/**
+ * \brief Run a Krylov solve on a separate host thread
+ *
+ * \tparam Solver solver class with a \p solve method taking an execution
+ * policy, e.g. \p cusp::krylov::cg_solver
+ *
+ * \param solver solver owning the workspace of the solve
+ * \param A matrix or \p linear_operator
+ * \param x initial guess, overwritten by the solution
+ * \param b right hand side
+ * \param monitor monitors the iteration
+ * \param M preconditioner
+ *
+ * \return a \c std::future which becomes ready once \p x holds the
+ * solution, exceptions of the solve are rethrown by its \c get
+ *
+ * \par Overview
+ *  The iteration of a Krylov method reads the residual norm back on every
+ *  step, so a solve keeps its host thread busy. \p solve_async therefore
+ *  runs \p solver on a new thread, which issues the work of a device
+ *  solve on a private non-blocking stream. All arguments must remain
+ *  valid and unused by other threads until the future is ready. Requires
+ *  C++11.
+ *
+ * \par Example
+ *  \code
+ *  cusp::krylov::cg_solver<float, cusp::device_memory> solver(A.num_rows);
+ *  cusp::monitor<float> monitor(b, 100, 1e-6);
+ *  cusp::identity_operator<float, cusp::device_memory> M(A.num_rows, A.num_rows);
+ *
+ *  std::future<void> solved = cusp::solve_async(solver, A, x, b, monitor, M);
+ *
+ *  // prepare the next right hand side on the host
+ *
+ *  solved.get();
+ *  \endcode
+ */
+template <typename Solver,
+          typename LinearOperator,
+          typename VectorType1,
+          typename VectorType2,
+          typename Monitor,
+          typename Preconditioner>
+std::future<void> solve_async(Solver& solver,
+                              const LinearOperator& A,
+                                    VectorType1& x,
+                              const VectorType2& b,
+                                    Monitor& monitor,
+                                    Preconditioner& M);
+#endif
+/*! \}
+ */
+
+} // end namespace cusp
+
+#include <cusp/detail/async.inl>
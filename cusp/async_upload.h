@@ -0,0 +1,162 @@
+/*
+ *  Copyright 2008-2014 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+
+/*! \file async_upload.h
+ *  \brief Asynchronous host to device transfer of matrices
+ */
+
+#pragma once
+
+#include <cusp/detail/config.h>
+
+#include <cstddef>
+
+namespace cusp
+{
+namespace detail
+{
+/* \cond */
+class upload_stream;
+/* \endcond */
+} // end namespace detail
+
+/*! \addtogroup utilities Utilities
+ *  \{
+ */
+
+/**
+ * \brief Handle to a transfer started by \p async_upload
+ *
+ * \par Overview
+ *  An \p upload_event owns the stream and the pinned staging buffers of a
+ *  transfer. Copies of an \p upload_event share them, and they are
+ *  released after the transfer completed once the last copy is destroyed.
+ *  Copies must not be shared between threads.
+ */
+class upload_event
+{
+public:
+
+    /*! Construct an \p upload_event of a transfer which already completed.
+     */
+    upload_event(void);
+
+    /*! \cond */
+    explicit upload_event(detail::upload_stream* stream);
+
+    detail::upload_stream* stream_handle(void) const;
+    /*! \endcond */
+
+    /*! Copy constructor, shares the transfer of \p other.
+     */
+    upload_event(const upload_event& other);
+
+    /*! Assignment operator, shares the transfer of \p other.
+     */
+    upload_event& operator=(const upload_event& other);
+
+    /*! Destructor, waits for the transfer if this is its last handle.
+     */
+    ~upload_event(void);
+
+    /*! Return \c true if the transfer completed.
+     */
+    bool ready(void) const;
+
+    /*! Block until the transfer completed.
+     */
+    void wait(void) const;
+
+private:
+
+    detail::upload_stream* stream;
+
+    void release(void);
+};
+
+/**
+ * \brief Copy a matrix to device memory through pinned staging buffers
+ * without waiting for the transfer
+ *
+ * \tparam MatrixType1 Type of the source matrix
+ * \tparam MatrixType2 Type of the destination matrix
+ *
+ * \param src source \p array1d, \p coo_matrix, \p csr_matrix,
+ * \p ell_matrix, \p dia_matrix or \p hyb_matrix, or a view of one
+ * \param dst destination container of the same kind
+ * \param chunk_bytes size of each pinned staging buffer in bytes
+ * \param num_buffers number of pinned staging buffers
+ *
+ * \return an \p upload_event which completes with the transfer
+ *
+ * \par Overview
+ *  Copying a host matrix into a device container issues one blocking
+ *  transfer from pageable memory per array, during which the host idles.
+ *  \p async_upload instead resizes \p dst and streams the arrays of
+ *  \p src through a ring of \p num_buffers pinned buffers: while the
+ *  device copies one chunk the host fills the next buffer, so the load
+ *  runs at the speed of the host to device link. When \p src is the
+ *  matrix of a \p cusp::io::mapped_binary_file the pages of the file are
+ *  read while filling the buffers, overlapping the disk reads with the
+ *  transfer as well.
+ *
+ *  \p src is no longer accessed once \p async_upload returns, whereas
+ *  \p dst must not be destroyed or resized before the returned event
+ *  completed. Kernels launched on the default stream are ordered after
+ *  the transfer, host accesses to \p dst must call \c wait first. If the
+ *  format of \p src differs from that of \p dst or \p src is not in host
+ *  memory, \p src is first converted into a temporary host matrix. If
+ *  \p dst does not reside in CUDA device memory the matrix is copied
+ *  synchronously and the returned event has already completed.
+ *
+ * \par Example
+ *  \code
+ *  #include <cusp/async_upload.h>
+ *  #include <cusp/csr_matrix.h>
+ *  #include <cusp/io/mapped_binary.h>
+ *  #include <cusp/multiply.h>
+ *
+ *  int main(void)
+ *  {
+ *      typedef cusp::csr_matrix<int, float, cusp::host_memory> HostMatrix;
+ *
+ *      cusp::io::mapped_binary_file<HostMatrix> file("A.cbin");
+ *
+ *      cusp::csr_matrix<int, float, cusp::device_memory> A;
+ *      cusp::upload_event event = cusp::async_upload(file.matrix(), A);
+ *
+ *      // prepare the vectors while the matrix is transferred
+ *      cusp::array1d<float, cusp::device_memory> x(A.num_cols, 1);
+ *      cusp::array1d<float, cusp::device_memory> y(A.num_rows);
+ *
+ *      event.wait();
+ *      cusp::multiply(A, x, y);
+ *
+ *      return 0;
+ *  }
+ *  \endcode
+ */
+template <typename MatrixType1, typename MatrixType2>
+upload_event async_upload(const MatrixType1& src, MatrixType2& dst,
+                          const size_t chunk_bytes = 1 << 22,
+                          const size_t num_buffers = 3);
+/*! \}
+ */
+
+} // end namespace cusp
+
+#include <cusp/detail/async_upload.inl>
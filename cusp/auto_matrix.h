@@ -0,0 +1,185 @@
+/*
+ *  Copyright 2008-2014 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+
+/*! \file auto_matrix.h
+ *  \brief Sparse matrix stored in the format predicted fastest for its
+ *  structure
+ */
+
+#pragma once
+
+#include <cusp/detail/config.h>
+
+#include <cusp/analyze.h>
+#include <cusp/coo_matrix.h>
+#include <cusp/csr_matrix.h>
+#include <cusp/dia_matrix.h>
+#include <cusp/ell_matrix.h>
+#include <cusp/hyb_matrix.h>
+#include <cusp/linear_operator.h>
+
+namespace cusp
+{
+
+/*! \addtogroup sparse_matrices Sparse Matrices
+ *  \addtogroup sparse_matrix_containers Sparse Matrix Containers
+ *  \ingroup sparse_matrices
+ *  \{
+ */
+
+/**
+ * \brief Sparse matrix container that selects its storage format
+ *
+ * \tparam IndexType Type used for matrix indices (e.g. \c int).
+ * \tparam ValueType Type used for matrix values (e.g. \c float).
+ * \tparam MemorySpace A memory space (e.g. \c cusp::host_memory or \c cusp::device_memory)
+ *
+ * \par Overview
+ *  An \p auto_matrix analyzes the structure of the matrix it is built from
+ *  with \p cusp::analyze and stores it in the format returned by
+ *  \p cusp::predict_storage for \p MemorySpace. With \p timed_trial the
+ *  prediction is replaced by the format whose \p multiply measured fastest,
+ *  every format is tried except \p dia_matrix and \p ell_matrix when they
+ *  would store more than three values per entry.
+ *
+ *  An \p auto_matrix is a \p linear_operator, \p cusp::multiply and the
+ *  iterative solvers apply it through the held matrix. Only one of the
+ *  format members holds the matrix, the others are empty.
+ *
+ * \par Example
+ *  \code
+ *  #include <cusp/auto_matrix.h>
+ *  #include <cusp/array1d.h>
+ *  #include <cusp/multiply.h>
+ *  #include <cusp/gallery/poisson.h>
+ *
+ *  #include <iostream>
+ *
+ *  int main(void)
+ *  {
+ *      cusp::csr_matrix<int,float,cusp::host_memory> B;
+ *      cusp::gallery::poisson5pt(B, 256, 256);
+ *
+ *      // convert to the format predicted fastest on the device
+ *      cusp::auto_matrix<int,float,cusp::device_memory> A(B);
+ *
+ *      std::cout << "storage " << A.storage << std::endl;
+ *
+ *      cusp::array1d<float,cusp::device_memory> x(A.num_cols, 1);
+ *      cusp::array1d<float,cusp::device_memory> y(A.num_rows);
+ *
+ *      // y = A * x
+ *      cusp::multiply(A, x, y);
+ *
+ *      return 0;
+ *  }
+ *  \endcode
+ */
+template <typename IndexType, typename ValueType, class MemorySpace>
+class auto_matrix : public cusp::linear_operator<ValueType,MemorySpace,IndexType>
+{
+private:
+
+    typedef cusp::linear_operator<ValueType,MemorySpace,IndexType> Parent;
+
+public:
+
+    /*! \cond */
+    typedef cusp::coo_matrix<IndexType,ValueType,MemorySpace> coo_matrix_type;
+    typedef cusp::csr_matrix<IndexType,ValueType,MemorySpace> csr_matrix_type;
+    typedef cusp::dia_matrix<IndexType,ValueType,MemorySpace> dia_matrix_type;
+    typedef cusp::ell_matrix<IndexType,ValueType,MemorySpace> ell_matrix_type;
+    typedef cusp::hyb_matrix<IndexType,ValueType,MemorySpace> hyb_matrix_type;
+    /*! \endcond */
+
+    /*! Format that holds the matrix.
+     */
+    cusp::matrix_storage storage;
+
+    /*! Structure profile of the matrix.
+     */
+    cusp::matrix_profile profile;
+
+    /*! Matrix storage, only the member selected by \p storage is filled.
+     */
+    coo_matrix_type coo;
+    csr_matrix_type csr;
+    dia_matrix_type dia;
+    ell_matrix_type ell;
+    hyb_matrix_type hyb;
+
+    /*! Construct an empty \p auto_matrix.
+     */
+    auto_matrix(void)
+        : storage(cusp::csr_storage) {}
+
+    /*! Construct an \p auto_matrix from another matrix.
+     *
+     *  \tparam MatrixType Type of input matrix.
+     *
+     *  \param A Another sparse or dense matrix.
+     *  \param timed_trial Select the format whose \p multiply measures
+     *  fastest instead of the predicted one.
+     */
+    template <typename MatrixType>
+    auto_matrix(const MatrixType& A, bool timed_trial = false)
+        : storage(cusp::csr_storage)
+    {
+        assign(A, timed_trial);
+    }
+
+    /*! Analyze a matrix and store it in the selected format.
+     *
+     *  \tparam MatrixType Type of input matrix.
+     *
+     *  \param A Another sparse or dense matrix.
+     *  \param timed_trial Select the format whose \p multiply measures
+     *  fastest instead of the predicted one.
+     */
+    template <typename MatrixType>
+    void assign(const MatrixType& A, bool timed_trial = false);
+
+    /*! Apply the \p auto_matrix to vector x and produce vector y.
+     *
+     *  \param x Input vector.
+     *  \param y Output vector.
+     */
+    template <typename DerivedPolicy, typename VectorType1, typename VectorType2>
+    void operator()(thrust::execution_policy<DerivedPolicy>& exec, const VectorType1& x, VectorType2& y) const;
+
+    /*! Apply the \p auto_matrix to vector x and produce vector y.
+     *
+     *  \param x Input vector.
+     *  \param y Output vector.
+     */
+    template <typename VectorType1, typename VectorType2>
+    void operator()(const VectorType1& x, VectorType2& y) const;
+
+private:
+
+    void release(void);
+
+    void store(const csr_matrix_type& A, cusp::matrix_storage format);
+
+    cusp::matrix_storage fastest_storage(const csr_matrix_type& A);
+}; // class auto_matrix
+/*! \}
+ */
+
+} // end namespace cusp
+
+#include <cusp/detail/auto_matrix.inl>
@@ -23,8 +23,11 @@
 #include <cusp/detail/config.h>
 #include <cusp/detail/execution_policy.h>
 
+#include <cusp/array1d.h>
 #include <cusp/complex.h>
 
+#include <thrust/tuple.h>
+
 namespace cusp
 {
 namespace blas
@@ -179,6 +182,37 @@ void axpy(const ArrayType1& x,
                 ArrayType2& y,
           const ScalarType alpha);
 
+/**
+ * \brief scaled vector addition with the scale factor read from memory
+ * (y = alpha[0] * x + y)
+ *
+ * The scale factor is read by the kernel that updates \p y, so on the
+ * device no transfer to the host takes place and the operation is enqueued
+ * on the stream of \p exec like any other kernel. Combined with the
+ * \p dot, \p dotc and \p nrm2 variants that write their result to an
+ * array, whole solver iterations can be queued without synchronization.
+ *
+ * \tparam DerivedPolicy Type of the execution policy
+ * \tparam ArrayType1 Type of the input array
+ * \tparam ArrayType2 Type of the output array
+ * \tparam ScalarType Type of the scale factor
+ * \tparam MemorySpace Memory space of the scale factor
+ *
+ * \param exec The execution policy
+ * \param x The input array
+ * \param y The output array
+ * \param alpha Array whose first entry is the scale factor applied to x
+ */
+template <typename DerivedPolicy,
+          typename ArrayType1,
+          typename ArrayType2,
+          typename ScalarType,
+          typename MemorySpace>
+void axpy(const thrust::detail::execution_policy_base<DerivedPolicy> &exec,
+          const ArrayType1& x,
+                ArrayType2& y,
+          const cusp::array1d<ScalarType,MemorySpace>& alpha);
+
 /*! \cond */
 template <typename DerivedPolicy,
           typename ArrayType1,
@@ -342,6 +376,159 @@ void axpbypcz(const ArrayType1& x,
               const ScalarType2 beta,
               const ScalarType3 gamma);
 
+/*! \cond */
+template <typename DerivedPolicy,
+          typename ArrayType1,
+          typename ArrayType2,
+          typename ArrayType3,
+          typename ArrayType4,
+          typename ScalarType1,
+          typename ScalarType2>
+void axpy_axpy(const thrust::detail::execution_policy_base<DerivedPolicy> &exec,
+               const ArrayType1& x1,
+                     ArrayType2& y1,
+               const ScalarType1 alpha1,
+               const ArrayType3& x2,
+                     ArrayType4& y2,
+               const ScalarType2 alpha2);
+/*! \endcond */
+
+/**
+ * \brief compute two scaled vector additions in a single pass
+ * (y1 = alpha1 * x1 + y1 and y2 = alpha2 * x2 + y2)
+ *
+ * \tparam ArrayType1 Type of the first input array
+ * \tparam ArrayType2 Type of the first output array
+ * \tparam ArrayType3 Type of the second input array
+ * \tparam ArrayType4 Type of the second output array
+ * \tparam ScalarType1 Type of the first scale factor
+ * \tparam ScalarType2 Type of the second scale factor
+ *
+ * \param x1 The first input array
+ * \param y1 The first output array
+ * \param alpha1 The scale factor applied to array x1
+ * \param x2 The second input array
+ * \param y2 The second output array
+ * \param alpha2 The scale factor applied to array x2
+ *
+ * \par Example
+ * \code
+ * #include <cusp/array1d.h>
+ * #include <cusp/print.h>
+ *
+ * // include cusp blas header file
+ * #include <cusp/blas/blas.h>
+ *
+ * int main()
+ * {
+ *   cusp::array1d<float,cusp::host_memory> p(10, 1);
+ *   cusp::array1d<float,cusp::host_memory> q(10, 2);
+ *   cusp::array1d<float,cusp::host_memory> x(10, 0);
+ *   cusp::array1d<float,cusp::host_memory> r(10, 3);
+ *
+ *   // compute x = x + 0.5*p and r = r - 0.5*q
+ *   cusp::blas::axpy_axpy(p, x, 0.5, q, r, -0.5);
+ *
+ *   // print the updated arrays
+ *   cusp::print(x);
+ *   cusp::print(r);
+ *
+ *   return 0;
+ * }
+ * \endcode
+ */
+template <typename ArrayType1,
+          typename ArrayType2,
+          typename ArrayType3,
+          typename ArrayType4,
+          typename ScalarType1,
+          typename ScalarType2>
+void axpy_axpy(const ArrayType1& x1,
+                     ArrayType2& y1,
+               const ScalarType1 alpha1,
+               const ArrayType3& x2,
+                     ArrayType4& y2,
+               const ScalarType2 alpha2);
+
+/*! \cond */
+template <typename DerivedPolicy,
+          typename ArrayType1,
+          typename ArrayType2,
+          typename ArrayType3,
+          typename ArrayType4,
+          typename ScalarType1,
+          typename ScalarType2>
+typename ArrayType4::value_type
+axpy_axpy_dotc(const thrust::detail::execution_policy_base<DerivedPolicy> &exec,
+               const ArrayType1& x1,
+                     ArrayType2& y1,
+               const ScalarType1 alpha1,
+               const ArrayType3& x2,
+                     ArrayType4& y2,
+               const ScalarType2 alpha2);
+/*! \endcond */
+
+/**
+ * \brief compute two scaled vector additions and the squared norm of the
+ * second result in a single pass (y1 = alpha1 * x1 + y1, y2 = alpha2 * x2 + y2
+ * and conj(y2) * y2)
+ *
+ * \tparam ArrayType1 Type of the first input array
+ * \tparam ArrayType2 Type of the first output array
+ * \tparam ArrayType3 Type of the second input array
+ * \tparam ArrayType4 Type of the second output array
+ * \tparam ScalarType1 Type of the first scale factor
+ * \tparam ScalarType2 Type of the second scale factor
+ *
+ * \param x1 The first input array
+ * \param y1 The first output array
+ * \param alpha1 The scale factor applied to array x1
+ * \param x2 The second input array
+ * \param y2 The second output array
+ * \param alpha2 The scale factor applied to array x2
+ *
+ * \return dot product of the updated y2 with itself
+ *
+ * \par Example
+ * \code
+ * #include <cusp/array1d.h>
+ * #include <cusp/print.h>
+ *
+ * // include cusp blas header file
+ * #include <cusp/blas/blas.h>
+ *
+ * #include <iostream>
+ *
+ * int main()
+ * {
+ *   cusp::array1d<float,cusp::host_memory> p(10, 1);
+ *   cusp::array1d<float,cusp::host_memory> q(10, 2);
+ *   cusp::array1d<float,cusp::host_memory> x(10, 0);
+ *   cusp::array1d<float,cusp::host_memory> r(10, 3);
+ *
+ *   // compute x = x + 0.5*p, r = r - 0.5*q and <r,r>
+ *   float rr = cusp::blas::axpy_axpy_dotc(p, x, 0.5, q, r, -0.5);
+ *
+ *   std::cout << "<r,r> = " << rr << std::endl;
+ *
+ *   return 0;
+ * }
+ * \endcode
+ */
+template <typename ArrayType1,
+          typename ArrayType2,
+          typename ArrayType3,
+          typename ArrayType4,
+          typename ScalarType1,
+          typename ScalarType2>
+typename ArrayType4::value_type
+axpy_axpy_dotc(const ArrayType1& x1,
+                     ArrayType2& y1,
+               const ScalarType1 alpha1,
+               const ArrayType3& x2,
+                     ArrayType4& y2,
+               const ScalarType2 alpha2);
+
 /*! \cond */
 template <typename DerivedPolicy,
           typename ArrayType1,
@@ -462,6 +649,15 @@ dot(const thrust::detail::execution_policy_base<DerivedPolicy> &exec,
  * \param x The first input array
  * \param y The second input array
  *
+ * \par Overview
+ * The sum is accumulated in the precision of the arrays. With the policy
+ * returned by the \p compensated() member of a system's \p par, e.g.
+ * <tt>cusp::device_memory().compensated()</tt>, \p dot, \p dotc and
+ * \p nrm2 accumulate float data in double precision and recover the
+ * rounding errors of the partial sums, so the accuracy of the result does
+ * not degrade with the length of the arrays. Every other algorithm runs as
+ * with the system's \p par.
+ *
  * \par Example
  * \code
  * #include <cusp/array1d.h>
@@ -481,6 +677,9 @@ dot(const thrust::detail::execution_policy_base<DerivedPolicy> &exec,
  *   // compute dot product of array x into y
  *   float value = cusp::blas::dot(x, y);
  *
+ *   // compute it with compensated double accumulation
+ *   float accurate = cusp::blas::dot(cusp::host_memory().compensated(), x, y);
+ *
  *   return 0;
  * }
  * \endcode
@@ -539,6 +738,286 @@ typename ArrayType1::value_type
 dotc(const ArrayType1& x,
      const ArrayType2& y);
 
+/*! \cond */
+template <typename DerivedPolicy,
+          typename ArrayType1,
+          typename Array2dType,
+          typename ArrayType2>
+void dots(const thrust::detail::execution_policy_base<DerivedPolicy> &exec,
+          const ArrayType1& x,
+          const Array2dType& Y,
+                ArrayType2& results);
+/*! \endcond */
+
+/**
+ * \brief dot products of one array with every column of a matrix
+ * (results[j] = x^T * Y(:,j))
+ *
+ * All of the dot products are accumulated in a single pass over the
+ * arrays, and the results are returned with one synchronization instead of
+ * one per column.
+ *
+ * \tparam ArrayType1 Type of the input array
+ * \tparam Array2dType Type of the input matrix
+ * \tparam ArrayType2 Type of the output array
+ *
+ * \param x The input array
+ * \param Y The input matrix, with one column for each dot product
+ * \param results The output array, resized to Y.num_cols
+ *
+ * \par Example
+ * \code
+ * #include <cusp/array1d.h>
+ * #include <cusp/array2d.h>
+ * #include <cusp/print.h>
+ *
+ * // include cusp blas header file
+ * #include <cusp/blas/blas.h>
+ *
+ * int main()
+ * {
+ *   // create an array filled with 2s
+ *   cusp::array1d<float,cusp::host_memory> x(10, 2);
+ *
+ *   // create a matrix with three columns filled with 3s
+ *   cusp::array2d<float,cusp::host_memory,cusp::column_major> Y(10, 3, 3);
+ *
+ *   cusp::array1d<float,cusp::host_memory> results;
+ *
+ *   // compute the dot product of x with each column of Y
+ *   cusp::blas::dots(x, Y, results);
+ *
+ *   // print [60, 60, 60]
+ *   cusp::print(results);
+ *
+ *   return 0;
+ * }
+ * \endcode
+ */
+template <typename ArrayType1,
+          typename Array2dType,
+          typename ArrayType2>
+void dots(const ArrayType1& x,
+          const Array2dType& Y,
+                ArrayType2& results);
+
+/*! \cond */
+template <typename DerivedPolicy,
+          typename ArrayType1,
+          typename Array2dType,
+          typename ArrayType2>
+void dotcs(const thrust::detail::execution_policy_base<DerivedPolicy> &exec,
+           const ArrayType1& x,
+           const Array2dType& Y,
+                 ArrayType2& results);
+/*! \endcond */
+
+/**
+ * \brief conjugate dot products of one array with every column of a
+ * matrix (results[j] = conjugate(x)^T * Y(:,j))
+ *
+ * \tparam ArrayType1 Type of the input array
+ * \tparam Array2dType Type of the input matrix
+ * \tparam ArrayType2 Type of the output array
+ *
+ * \param x The input array
+ * \param Y The input matrix, with one column for each dot product
+ * \param results The output array, resized to Y.num_cols
+ *
+ * \see dots
+ */
+template <typename ArrayType1,
+          typename Array2dType,
+          typename ArrayType2>
+void dotcs(const ArrayType1& x,
+           const Array2dType& Y,
+                 ArrayType2& results);
+
+/*! \cond */
+template <typename DerivedPolicy,
+          typename ArrayType1,
+          typename ArrayType2>
+thrust::tuple<typename ArrayType1::value_type,
+              typename cusp::norm_type<typename ArrayType1::value_type>::type>
+dotc_nrm2(const thrust::detail::execution_policy_base<DerivedPolicy> &exec,
+          const ArrayType1& x,
+          const ArrayType2& y);
+/*! \endcond */
+
+/**
+ * \brief conjugate dot product and Euclidean norm of the first array in a
+ * single pass (conjugate(x)^T * y and sqrt(conjugate(x)^T * x))
+ *
+ * \tparam ArrayType1 Type of the first input array
+ * \tparam ArrayType2 Type of the second input array
+ *
+ * \param x The first input array
+ * \param y The second input array
+ *
+ * \return tuple of the dot product and the norm of x
+ *
+ * \par Example
+ * \code
+ * #include <cusp/array1d.h>
+ *
+ * // include cusp blas header file
+ * #include <cusp/blas/blas.h>
+ *
+ * #include <thrust/tuple.h>
+ *
+ * int main()
+ * {
+ *   cusp::array1d<float,cusp::host_memory> x(10, 2);
+ *   cusp::array1d<float,cusp::host_memory> y(10, 3);
+ *
+ *   float xy, norm;
+ *
+ *   // compute <x,y> = 60 and ||x|| = sqrt(40)
+ *   thrust::tie(xy, norm) = cusp::blas::dotc_nrm2(x, y);
+ *
+ *   return 0;
+ * }
+ * \endcode
+ */
+template <typename ArrayType1,
+          typename ArrayType2>
+thrust::tuple<typename ArrayType1::value_type,
+              typename cusp::norm_type<typename ArrayType1::value_type>::type>
+dotc_nrm2(const ArrayType1& x,
+          const ArrayType2& y);
+
+/**
+ * \brief sum partial reductions over the processes of an execution policy
+ *
+ * Solvers that fuse their inner products into custom reductions compute
+ * the partial results over the entries owned by the calling process and
+ * pass them through \p allreduce, so that the policies of
+ * \p cusp::distributed add the contributions of all ranks. The policies of
+ * a single process leave \p values unchanged.
+ *
+ * \tparam DerivedPolicy Type of the execution policy
+ * \tparam ArrayType Type of the array of partial results
+ *
+ * \param exec The execution policy
+ * \param values The partial results, replaced by their sums
+ */
+template <typename DerivedPolicy,
+          typename ArrayType>
+void allreduce(const thrust::detail::execution_policy_base<DerivedPolicy> &exec,
+                     ArrayType& values);
+
+/**
+ * \brief start summing partial reductions over the processes of an
+ * execution policy without waiting for the result
+ *
+ * The sum may overlap independent work such as the sparse matrix-vector
+ * products of a pipelined solver and is completed by \p allreduce_end,
+ * \p values must not be accessed in between. A policy has at most one
+ * pending reduction.
+ *
+ * \tparam DerivedPolicy Type of the execution policy
+ * \tparam ValueType Type of the partial results
+ *
+ * \param exec The execution policy
+ * \param values Pointer to \p n partial results in host memory
+ * \param n Number of partial results
+ *
+ * \see allreduce
+ */
+template <typename DerivedPolicy,
+          typename ValueType>
+void allreduce_begin(thrust::detail::execution_policy_base<DerivedPolicy> &exec,
+                     ValueType* values,
+                     const size_t n);
+
+/**
+ * \brief wait for the reduction started by \p allreduce_begin
+ *
+ * \tparam DerivedPolicy Type of the execution policy
+ *
+ * \param exec The execution policy passed to \p allreduce_begin
+ */
+template <typename DerivedPolicy>
+void allreduce_end(thrust::detail::execution_policy_base<DerivedPolicy> &exec);
+
+/**
+ * \brief dot product (x^T * y) written to memory
+ *
+ * The dot product is stored in the first entry of \p result, which is
+ * resized to one entry if it is empty. When the arrays and \p result
+ * reside on the device the reduction is enqueued on the stream of \p exec
+ * and the call returns without waiting for it, the value can be consumed
+ * by later kernels such as the \p axpy and \p scal variants taking the
+ * scale factor from an array.
+ *
+ * \tparam DerivedPolicy Type of the execution policy
+ * \tparam ArrayType1 Type of the first input array
+ * \tparam ArrayType2 Type of the second input array
+ * \tparam ArrayType3 Type of the output array
+ *
+ * \param exec The execution policy
+ * \param x The first input array
+ * \param y The second input array
+ * \param result The output array
+ *
+ * \par Example
+ * \code
+ * #include <cusp/array1d.h>
+ * #include <cusp/print.h>
+ *
+ * // include cusp blas header file
+ * #include <cusp/blas/blas.h>
+ *
+ * int main()
+ * {
+ *   cusp::array1d<float,cusp::device_memory> x(10, 2);
+ *   cusp::array1d<float,cusp::device_memory> y(10, 3);
+ *   cusp::array1d<float,cusp::device_memory> alpha(1);
+ *
+ *   // alpha = <x,y> and y = alpha * x + y without leaving the device
+ *   cusp::blas::dot(cusp::cuda::par, x, y, alpha);
+ *   cusp::blas::axpy(cusp::cuda::par, x, y, alpha);
+ *
+ *   // print [122, 122, ...]
+ *   cusp::print(y);
+ *
+ *   return 0;
+ * }
+ * \endcode
+ */
+template <typename DerivedPolicy,
+          typename ArrayType1,
+          typename ArrayType2,
+          typename ArrayType3>
+void dot(const thrust::detail::execution_policy_base<DerivedPolicy> &exec,
+         const ArrayType1& x,
+         const ArrayType2& y,
+               ArrayType3& result);
+
+/**
+ * \brief conjugate dot product (conjugate(x)^T * y) written to memory
+ *
+ * \tparam DerivedPolicy Type of the execution policy
+ * \tparam ArrayType1 Type of the first input array
+ * \tparam ArrayType2 Type of the second input array
+ * \tparam ArrayType3 Type of the output array
+ *
+ * \param exec The execution policy
+ * \param x The first input array
+ * \param y The second input array
+ * \param result The output array, the product is stored in its first entry
+ *
+ * \see dot
+ */
+template <typename DerivedPolicy,
+          typename ArrayType1,
+          typename ArrayType2,
+          typename ArrayType3>
+void dotc(const thrust::detail::execution_policy_base<DerivedPolicy> &exec,
+          const ArrayType1& x,
+          const ArrayType2& y,
+                ArrayType3& result);
+
 /*! \cond */
 template <typename DerivedPolicy,
           typename ArrayType,
@@ -666,6 +1145,26 @@ template <typename ArrayType>
 typename cusp::norm_type<typename ArrayType::value_type>::type
 nrm2(const ArrayType& x);
 
+/**
+ * \brief vector 2-norm (sqrt(x^T * x)) written to memory
+ *
+ * \tparam DerivedPolicy Type of the execution policy
+ * \tparam ArrayType1 Type of the input array
+ * \tparam ArrayType2 Type of the output array
+ *
+ * \param exec The execution policy
+ * \param x The input array
+ * \param result The output array, the norm is stored in its first entry
+ *
+ * \see dot
+ */
+template <typename DerivedPolicy,
+          typename ArrayType1,
+          typename ArrayType2>
+void nrm2(const thrust::detail::execution_policy_base<DerivedPolicy> &exec,
+          const ArrayType1& x,
+                ArrayType2& result);
+
 /*! \cond */
 template <typename DerivedPolicy,
           typename ArrayType>
@@ -754,6 +1253,28 @@ template <typename ArrayType,
 void scal(ArrayType& x,
           const ScalarType alpha);
 
+/**
+ * \brief scale an array by a factor read from memory (x = alpha[0] * x)
+ *
+ * \tparam DerivedPolicy Type of the execution policy
+ * \tparam ArrayType Type of the input and output array
+ * \tparam ScalarType Type of the scale factor
+ * \tparam MemorySpace Memory space of the scale factor
+ *
+ * \param exec The execution policy
+ * \param x The input and output array
+ * \param alpha Array whose first entry is the scale factor
+ *
+ * \see axpy
+ */
+template <typename DerivedPolicy,
+          typename ArrayType,
+          typename ScalarType,
+          typename MemorySpace>
+void scal(const thrust::detail::execution_policy_base<DerivedPolicy> &exec,
+                ArrayType& x,
+          const cusp::array1d<ScalarType,MemorySpace>& alpha);
+
 /*! \cond */
 template <typename DerivedPolicy,
           typename Array2d1,
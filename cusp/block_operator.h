@@ -0,0 +1,160 @@
+/*
+ *  Copyright 2008-2014 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*! \file block_operator.h
+ *  \brief Linear operator assembled from a grid of sub-operators
+ */
+
+#pragma once
+
+#include <cusp/detail/config.h>
+
+#include <cusp/array1d.h>
+#include <cusp/linear_operator.h>
+
+#include <cusp/detail/block_structure.h>
+
+namespace cusp
+{
+
+/*! \addtogroup containers Containers
+ *  \{
+ */
+
+/**
+ * \brief Linear operator whose blocks are other matrices or operators
+ *
+ * \tparam ValueType Type used for the vector values (e.g. \c float).
+ * \tparam MemorySpace Memory space of the vectors and of the blocks
+ * (e.g. \c cusp::device_memory).
+ * \tparam IndexType Type used for indices (e.g. \c int).
+ *
+ * \par Overview
+ *  A \p block_operator holds references to sub-operators arranged in a
+ *  grid of block rows and block columns, missing blocks are zero. The
+ *  first block set in a block row or column fixes its size and the other
+ *  blocks must agree with it. Any matrix format or operator accepted by
+ *  \p cusp::multiply can be a block, including another \p block_operator,
+ *  and the blocks must outlive the operator.
+ *
+ *  The block products of <tt>y = A x</tt> are independent of each other
+ *  and run at the same time: on the device every product is issued on its
+ *  own CUDA stream, forked from and joined into the default stream, and
+ *  on the host the smaller products run on separate OpenMP threads. The
+ *  first product of every block row writes its segment of \p y, the others
+ *  write to a workspace, and their sums are added once all products have
+ *  finished.
+ *
+ *  Blocks that do not accept an execution policy, such as user defined
+ *  operators with only <tt>operator()(x, y)</tt>, run on the default
+ *  stream and are serialized with the other products.
+ *
+ * \par Example
+ *  \code
+ *  #include <cusp/block_operator.h>
+ *  #include <cusp/csr_matrix.h>
+ *  #include <cusp/gallery/poisson.h>
+ *  #include <cusp/krylov/gmres.h>
+ *  #include <cusp/monitor.h>
+ *
+ *  int main(void)
+ *  {
+ *      typedef cusp::csr_matrix<int, float, cusp::device_memory> Matrix;
+ *
+ *      Matrix A, B;
+ *      cusp::gallery::poisson5pt(A, 64, 64);
+ *      cusp::gallery::poisson5pt(B, 32, 32);
+ *
+ *      // [A 0]
+ *      // [0 B]
+ *      cusp::block_operator<float, cusp::device_memory> K(2, 2);
+ *      K.set_block(0, 0, A);
+ *      K.set_block(1, 1, B);
+ *
+ *      cusp::array1d<float, cusp::device_memory> x(K.num_rows, 0), b(K.num_rows, 1);
+ *
+ *      cusp::monitor<float> monitor(b, 500, 1e-6);
+ *      cusp::krylov::gmres(K, x, b, 50, monitor);
+ *  }
+ *  \endcode
+ */
+template <typename ValueType, typename MemorySpace, typename IndexType = int>
+class block_operator : public cusp::linear_operator<ValueType,MemorySpace,IndexType>
+{
+  private:
+
+    typedef cusp::linear_operator<ValueType,MemorySpace,IndexType> Parent;
+    typedef cusp::detail::block_structure<ValueType,MemorySpace>   Structure;
+
+  public:
+
+    /*! Construct an empty grid of \p num_block_rows by \p num_block_cols
+     *  blocks.
+     *
+     *  \throws cusp::invalid_input_exception if either count is zero
+     */
+    block_operator(const size_t num_block_rows, const size_t num_block_cols);
+
+    /*! Number of block rows and block columns.
+     */
+    size_t num_block_rows(void) const;
+    size_t num_block_cols(void) const;
+
+    /*! Offsets of block row \p i and block column \p j.
+     */
+    size_t row_offset(const size_t i) const;
+    size_t col_offset(const size_t j) const;
+
+    /*! Whether block <tt>(i, j)</tt> is set.
+     */
+    bool has_block(const size_t i, const size_t j) const;
+
+    /*! Set block <tt>(i, j)</tt> to \p A, replacing an earlier block. The
+     *  operator keeps a reference to \p A.
+     *
+     *  \throws cusp::invalid_input_exception if the indices are out of
+     *  range or the shape of \p A does not match its block row or column
+     */
+    template <typename Operator>
+    void set_block(const size_t i, const size_t j, const Operator& A);
+
+    /*! Multiply the operator with \p x, y = A x.
+     *
+     *  \throws cusp::invalid_input_exception if the sizes of \p x or \p y
+     *  do not match the operator
+     */
+    template <typename VectorType1, typename VectorType2>
+    void operator()(const VectorType1& x, VectorType2& y) const;
+
+  private:
+
+    /*! \cond */
+    Structure blocks;
+
+    mutable cusp::array1d<ValueType,MemorySpace> workspace;
+    mutable cusp::array1d<ValueType,MemorySpace> x_buffer;
+    mutable cusp::array1d<ValueType,MemorySpace> y_buffer;
+
+    block_operator(const block_operator&);
+    block_operator& operator=(const block_operator&);
+    /*! \endcond */
+};
+/*! \}
+ */
+
+} // end namespace cusp
+
+#include <cusp/detail/block_operator.inl>
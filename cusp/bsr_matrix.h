@@ -0,0 +1,439 @@
+/*
+ *  Copyright 2008-2014 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*! \file bsr_matrix.h
+ *  \brief Block Compressed Sparse Row matrix format.
+ */
+
+#pragma once
+
+#include <cusp/detail/config.h>
+
+#include <cusp/array1d.h>
+#include <cusp/memory.h>
+
+#include <cusp/detail/format.h>
+#include <cusp/detail/matrix_base.h>
+#include <cusp/detail/type_traits.h>
+
+namespace cusp
+{
+
+// forward definition
+template <typename ArrayType1, typename ArrayType2, typename ArrayType3,
+          typename IndexType, typename ValueType, typename MemorySpace,
+          size_t BlockRows, size_t BlockCols> class bsr_matrix_view;
+
+/*! \addtogroup sparse_matrices Sparse Matrices
+ */
+
+/*! \addtogroup sparse_matrix_containers Sparse Matrix Containers
+ *  \ingroup sparse_matrices
+ *  \{
+ */
+
+/**
+ * \brief Block Compressed Sparse Row (BSR) representation of a sparse matrix
+ *
+ * \tparam IndexType Type used for matrix indices (e.g. \c int).
+ * \tparam ValueType Type used for matrix values (e.g. \c float).
+ * \tparam MemorySpace A memory space (e.g. \c cusp::host_memory or \c cusp::device_memory)
+ * \tparam BlockRows Number of rows in each dense block.
+ * \tparam BlockCols Number of columns in each dense block.
+ *
+ * \par Overview
+ *  A \p bsr_matrix is a sparse matrix container that stores dense
+ *  <tt>BlockRows x BlockCols</tt> blocks in a CSR structure over the block
+ *  rows of the matrix. One column index is stored per block rather than
+ *  per entry, and the entries of every block are stored contiguously in
+ *  row-major order, i.e. entry <tt>(r,c)</tt> of block \c k resides at
+ *  <tt>values[k * BlockRows * BlockCols + r * BlockCols + c]</tt>.
+ *
+ * \note \c num_entries counts every stored entry, including explicit zeros
+ *       inside the blocks, and equals <tt>num_blocks() * BlockRows * BlockCols</tt>.
+ * \note The number of rows and columns must be multiples of the block size.
+ * \note The block column indices of each block row should be sorted and
+ *       free of duplicates.
+ *
+ * \par Example
+ *  The following code snippet demonstrates how to create a 3x3 block
+ *  \p bsr_matrix from a \p csr_matrix and multiply it with a vector on the
+ *  device.
+ *
+ *  \code
+ *  // include the bsr_matrix header file
+ *  #include <cusp/bsr_matrix.h>
+ *  #include <cusp/csr_matrix.h>
+ *  #include <cusp/multiply.h>
+ *  #include <cusp/print.h>
+ *
+ *  int main()
+ *  {
+ *    // 6x6 matrix with two 3x3 blocks on the diagonal
+ *    cusp::csr_matrix<int,float,cusp::host_memory> A(6,6,18);
+ *    A.row_offsets[0] = 0;
+ *    for(int i = 0; i < 6; i++)
+ *    {
+ *      A.row_offsets[i + 1] = 3 * (i + 1);
+ *      for(int j = 0; j < 3; j++)
+ *      {
+ *        A.column_indices[3 * i + j] = 3 * (i / 3) + j;
+ *        A.values[3 * i + j] = i + j;
+ *      }
+ *    }
+ *
+ *    // convert to BSR on the device
+ *    cusp::bsr_matrix<int,float,cusp::device_memory,3,3> B(A);
+ *
+ *    cusp::array1d<float,cusp::device_memory> x(6, 1);
+ *    cusp::array1d<float,cusp::device_memory> y(6);
+ *    cusp::multiply(B, x, y);
+ *
+ *    cusp::print(y);
+ *  }
+ *  \endcode
+ */
+template <typename IndexType, typename ValueType, class MemorySpace, size_t BlockRows, size_t BlockCols>
+class bsr_matrix : public cusp::detail::matrix_base<IndexType,ValueType,MemorySpace,cusp::bsr_format>
+{
+private:
+
+    typedef cusp::detail::matrix_base<IndexType,ValueType,MemorySpace,cusp::bsr_format> Parent;
+
+public:
+
+    /*! Number of rows in each block.
+     */
+    const static size_t block_rows = BlockRows;
+
+    /*! Number of columns in each block.
+     */
+    const static size_t block_cols = BlockCols;
+
+    /*! \cond */
+    typedef typename cusp::array1d<IndexType, MemorySpace> row_offsets_array_type;
+    typedef typename cusp::array1d<IndexType, MemorySpace> column_indices_array_type;
+    typedef typename cusp::array1d<ValueType, MemorySpace> values_array_type;
+
+    typedef typename cusp::bsr_matrix<IndexType, ValueType, MemorySpace, BlockRows, BlockCols> container;
+
+    typedef typename cusp::bsr_matrix_view<typename row_offsets_array_type::view,
+            typename column_indices_array_type::view,
+            typename values_array_type::view,
+            IndexType, ValueType, MemorySpace, BlockRows, BlockCols> view;
+
+    typedef typename cusp::bsr_matrix_view<typename row_offsets_array_type::const_view,
+            typename column_indices_array_type::const_view,
+            typename values_array_type::const_view,
+            IndexType, ValueType, MemorySpace, BlockRows, BlockCols> const_view;
+
+    template<typename MemorySpace2>
+    struct rebind
+    {
+        typedef cusp::bsr_matrix<IndexType, ValueType, MemorySpace2, BlockRows, BlockCols> type;
+    };
+    /*! \endcond */
+
+    /*! Storage for the block row offsets of the BSR data structure.
+     */
+    row_offsets_array_type row_offsets;
+
+    /*! Storage for the block column indices of the BSR data structure.
+     */
+    column_indices_array_type column_indices;
+
+    /*! Storage for the entries of the blocks of the BSR data structure.
+     */
+    values_array_type values;
+
+    /*! Construct an empty \p bsr_matrix.
+     */
+    bsr_matrix(void) {}
+
+    /*! Construct a \p bsr_matrix with a specific shape and number of blocks.
+     *
+     *  \param num_rows Number of rows.
+     *  \param num_cols Number of columns.
+     *  \param num_blocks Number of stored blocks.
+     */
+    bsr_matrix(const size_t num_rows, const size_t num_cols, const size_t num_blocks);
+
+    /*! Construct a \p bsr_matrix from another matrix.
+     *
+     *  \param matrix Another sparse or dense matrix.
+     */
+    template <typename MatrixType>
+    bsr_matrix(const MatrixType& matrix);
+
+    /*! Number of block rows in the matrix.
+     */
+    size_t num_block_rows(void) const
+    {
+        return this->num_rows / BlockRows;
+    }
+
+    /*! Number of block columns in the matrix.
+     */
+    size_t num_block_cols(void) const
+    {
+        return this->num_cols / BlockCols;
+    }
+
+    /*! Number of stored blocks in the matrix.
+     */
+    size_t num_blocks(void) const
+    {
+        return column_indices.size();
+    }
+
+    /*! Resize matrix dimensions and underlying storage
+     *
+     *  \param num_rows Number of rows.
+     *  \param num_cols Number of columns.
+     *  \param num_blocks Number of stored blocks.
+     */
+    void resize(const size_t num_rows, const size_t num_cols, const size_t num_blocks);
+
+    /*! Swap the contents of two \p bsr_matrix objects.
+     *
+     *  \param matrix Another \p bsr_matrix with the same IndexType, ValueType
+     *  and block size.
+     */
+    void swap(bsr_matrix& matrix);
+
+    /*! Assignment from another matrix.
+     *
+     *  \tparam MatrixType Format type of input matrix.
+     *
+     *  \param matrix Another sparse or dense matrix.
+     */
+    template <typename MatrixType>
+    bsr_matrix& operator=(const MatrixType& matrix);
+}; // class bsr_matrix
+/*! \}
+ */
+
+/*! \addtogroup sparse_matrix_views Sparse Matrix Views
+ *  \ingroup sparse_matrices
+ *  \{
+ */
+
+/**
+ * \brief View of a \p bsr_matrix
+ *
+ * \tparam ArrayType1 Type of \c row_offsets array view
+ * \tparam ArrayType2 Type of \c column_indices array view
+ * \tparam ArrayType3 Type of \c values array view
+ * \tparam IndexType Type used for matrix indices (e.g. \c int).
+ * \tparam ValueType Type used for matrix values (e.g. \c float).
+ * \tparam MemorySpace A memory space (e.g. \c cusp::host_memory or \c cusp::device_memory)
+ * \tparam BlockRows Number of rows in each dense block.
+ * \tparam BlockCols Number of columns in each dense block.
+ */
+template <typename ArrayType1,
+          typename ArrayType2,
+          typename ArrayType3,
+          typename IndexType,
+          typename ValueType,
+          typename MemorySpace,
+          size_t BlockRows,
+          size_t BlockCols>
+class bsr_matrix_view : public cusp::detail::matrix_base<IndexType,ValueType,MemorySpace,cusp::bsr_format>
+{
+private:
+
+    typedef cusp::detail::matrix_base<IndexType,ValueType,MemorySpace,cusp::bsr_format> Parent;
+
+public:
+
+    /*! Number of rows in each block.
+     */
+    const static size_t block_rows = BlockRows;
+
+    /*! Number of columns in each block.
+     */
+    const static size_t block_cols = BlockCols;
+
+    /*! \cond */
+    typedef ArrayType1 row_offsets_array_type;
+    typedef ArrayType2 column_indices_array_type;
+    typedef ArrayType3 values_array_type;
+
+    typedef typename cusp::bsr_matrix<IndexType, ValueType, MemorySpace, BlockRows, BlockCols> container;
+    typedef typename cusp::bsr_matrix_view<ArrayType1, ArrayType2, ArrayType3, IndexType, ValueType, MemorySpace, BlockRows, BlockCols> view;
+    typedef typename cusp::bsr_matrix_view<ArrayType1, ArrayType2, ArrayType3, IndexType, ValueType, MemorySpace, BlockRows, BlockCols> const_view;
+    /*! \endcond */
+
+    /**
+     * View of the block row offsets of the BSR data structure.
+     */
+    row_offsets_array_type row_offsets;
+
+    /**
+     * View of the block column indices of the BSR data structure.
+     */
+    column_indices_array_type column_indices;
+
+    /**
+     * View for the block entries of the BSR data structure.
+     */
+    values_array_type values;
+
+    /**
+     * Construct an empty \p bsr_matrix_view.
+     */
+    bsr_matrix_view(void)
+        : Parent() {}
+
+    /*! Construct a \p bsr_matrix_view with a specific shape and number of
+     *  blocks from existing arrays denoting the block row offsets, block column
+     *  indices and values.
+     *
+     *  \param num_rows Number of rows.
+     *  \param num_cols Number of columns.
+     *  \param num_blocks Number of stored blocks.
+     *  \param row_offsets Array containing the block row offsets.
+     *  \param column_indices Array containing the block column indices.
+     *  \param values Array containing the block entries.
+     */
+    bsr_matrix_view(const size_t num_rows,
+                    const size_t num_cols,
+                    const size_t num_blocks,
+                    ArrayType1 row_offsets,
+                    ArrayType2 column_indices,
+                    ArrayType3 values)
+        : Parent(num_rows, num_cols, num_blocks * BlockRows * BlockCols),
+          row_offsets(row_offsets),
+          column_indices(column_indices),
+          values(values) {}
+
+    /*! Construct a \p bsr_matrix_view from a existing \p bsr_matrix.
+     *
+     *  \param matrix \p bsr_matrix used to create view.
+     */
+    bsr_matrix_view(bsr_matrix<IndexType,ValueType,MemorySpace,BlockRows,BlockCols>& matrix)
+        : Parent(matrix),
+          row_offsets(matrix.row_offsets),
+          column_indices(matrix.column_indices),
+          values(matrix.values) {}
+
+    /*! Construct a \p bsr_matrix_view from a existing const \p bsr_matrix.
+     *
+     *  \param matrix \p bsr_matrix used to create view.
+     */
+    bsr_matrix_view(const bsr_matrix<IndexType,ValueType,MemorySpace,BlockRows,BlockCols>& matrix)
+        : Parent(matrix),
+          row_offsets(matrix.row_offsets),
+          column_indices(matrix.column_indices),
+          values(matrix.values) {}
+
+    /*! Construct a \p bsr_matrix_view from a existing \p bsr_matrix_view.
+     *
+     *  \param matrix \p bsr_matrix_view used to create view.
+     */
+    bsr_matrix_view(bsr_matrix_view& matrix)
+        : Parent(matrix),
+          row_offsets(matrix.row_offsets),
+          column_indices(matrix.column_indices),
+          values(matrix.values) {}
+
+    /*! Construct a \p bsr_matrix_view from a existing const \p bsr_matrix_view.
+     *
+     *  \param matrix \p bsr_matrix_view used to create view.
+     */
+    bsr_matrix_view(const bsr_matrix_view& matrix)
+        : Parent(matrix),
+          row_offsets(matrix.row_offsets),
+          column_indices(matrix.column_indices),
+          values(matrix.values) {}
+
+    /*! Number of block rows in the matrix.
+     */
+    size_t num_block_rows(void) const
+    {
+        return this->num_rows / BlockRows;
+    }
+
+    /*! Number of block columns in the matrix.
+     */
+    size_t num_block_cols(void) const
+    {
+        return this->num_cols / BlockCols;
+    }
+
+    /*! Number of stored blocks in the matrix.
+     */
+    size_t num_blocks(void) const
+    {
+        return column_indices.size();
+    }
+
+    /*! Resize matrix dimensions and underlying storage
+     *
+     *  \param num_rows Number of rows.
+     *  \param num_cols Number of columns.
+     *  \param num_blocks Number of stored blocks.
+     */
+    void resize(const size_t num_rows, const size_t num_cols, const size_t num_blocks);
+};
+
+/**
+ *  This is a convenience function for generating an \p bsr_matrix_view
+ *  using an existing \p bsr_matrix.
+ *
+ *  \tparam IndexType  indices type
+ *  \tparam ValueType  values type
+ *  \tparam MemorySpace memory space of the arrays
+ *  \tparam BlockRows number of rows in each block
+ *  \tparam BlockCols number of columns in each block
+ *
+ *  \param m Exemplar \p bsr_matrix matrix to copy.
+ *
+ *  \return \p bsr_matrix_view constructed using input arrays.
+ */
+template <typename IndexType, typename ValueType, class MemorySpace, size_t BlockRows, size_t BlockCols>
+typename bsr_matrix<IndexType,ValueType,MemorySpace,BlockRows,BlockCols>::view
+make_bsr_matrix_view(bsr_matrix<IndexType,ValueType,MemorySpace,BlockRows,BlockCols>& m)
+{
+    return typename bsr_matrix<IndexType,ValueType,MemorySpace,BlockRows,BlockCols>::view(m);
+}
+
+/**
+ *  This is a convenience function for generating an \p bsr_matrix_view
+ *  using an existing const \p bsr_matrix.
+ *
+ *  \tparam IndexType  indices type
+ *  \tparam ValueType  values type
+ *  \tparam MemorySpace memory space of the arrays
+ *  \tparam BlockRows number of rows in each block
+ *  \tparam BlockCols number of columns in each block
+ *
+ *  \param m Exemplar \p bsr_matrix matrix to copy.
+ *
+ *  \return constant \p bsr_matrix_view constructed using input arrays.
+ */
+template <typename IndexType, typename ValueType, class MemorySpace, size_t BlockRows, size_t BlockCols>
+typename bsr_matrix<IndexType,ValueType,MemorySpace,BlockRows,BlockCols>::const_view
+make_bsr_matrix_view(const bsr_matrix<IndexType,ValueType,MemorySpace,BlockRows,BlockCols>& m)
+{
+    return typename bsr_matrix<IndexType,ValueType,MemorySpace,BlockRows,BlockCols>::const_view(m);
+}
+/*! \}
+ */
+
+} // end namespace cusp
+
+#include <cusp/detail/bsr_matrix.inl>
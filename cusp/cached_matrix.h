@@ -0,0 +1,241 @@
+/*
+ *  Copyright 2008-2014 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+
+/*! \file cached_matrix.h
+ *  \brief CSR matrix that keeps converted copies of itself for repeated
+ *  multiplication
+ */
+
+#pragma once
+
+#include <cusp/detail/config.h>
+
+#include <cusp/analyze.h>
+#include <cusp/csr_matrix.h>
+#include <cusp/ell_matrix.h>
+#include <cusp/hyb_matrix.h>
+#include <cusp/linear_operator.h>
+
+namespace cusp
+{
+
+/*! \addtogroup sparse_matrices Sparse Matrices
+ *  \addtogroup sparse_matrix_containers Sparse Matrix Containers
+ *  \ingroup sparse_matrices
+ *  \{
+ */
+
+/**
+ * \brief Sparse matrix container that caches alternative formats of a
+ * CSR matrix
+ *
+ * \tparam IndexType Type used for matrix indices (e.g. \c int).
+ * \tparam ValueType Type used for matrix values (e.g. \c float).
+ * \tparam MemorySpace A memory space (e.g. \c cusp::host_memory or \c cusp::device_memory)
+ *
+ * \par Overview
+ *  A \p cached_matrix holds a matrix in CSR format and builds further
+ *  representations of it only when they pay off for the calls actually
+ *  made. Once the matrix has been applied \p reuse_threshold times it is
+ *  converted to ELL or HYB if \p cusp::predict_storage prefers either
+ *  format for \p MemorySpace, and once \p cusp::multiply_transpose has
+ *  been called \p reuse_threshold times the transpose is stored in CSR
+ *  format. Later calls run on the cached copies.
+ *
+ *  The caches follow the values of \p csr only through \p update_values.
+ *  Code that writes to \p csr directly must call \p invalidate, which
+ *  also analyzes the matrix again when its structure changed.
+ *
+ *  A \p cached_matrix is a \p linear_operator, \p cusp::multiply and the
+ *  iterative solvers apply it like any other matrix.
+ *
+ * \par Example
+ *  \code
+ *  #include <cusp/cached_matrix.h>
+ *  #include <cusp/array1d.h>
+ *  #include <cusp/multiply.h>
+ *  #include <cusp/gallery/poisson.h>
+ *
+ *  int main(void)
+ *  {
+ *      cusp::csr_matrix<int,float,cusp::device_memory> B;
+ *      cusp::gallery::poisson5pt(B, 256, 256);
+ *
+ *      cusp::cached_matrix<int,float,cusp::device_memory> A(B);
+ *
+ *      cusp::array1d<float,cusp::device_memory> x(A.num_cols, 1);
+ *      cusp::array1d<float,cusp::device_memory> y(A.num_rows);
+ *
+ *      // the first products run on CSR, later ones on the cached format
+ *      for(int i = 0; i < 10; i++)
+ *          cusp::multiply(A, x, y);
+ *
+ *      // y = A^T * x through a cached transpose
+ *      for(int i = 0; i < 10; i++)
+ *          cusp::multiply_transpose(A, x, y);
+ *
+ *      // new values with the same sparsity pattern
+ *      cusp::array1d<float,cusp::device_memory> values(A.num_entries, 2);
+ *      A.update_values(values);
+ *
+ *      return 0;
+ *  }
+ *  \endcode
+ */
+template <typename IndexType, typename ValueType, class MemorySpace>
+class cached_matrix : public cusp::linear_operator<ValueType,MemorySpace,IndexType>
+{
+private:
+
+    typedef cusp::linear_operator<ValueType,MemorySpace,IndexType> Parent;
+
+public:
+
+    /*! \cond */
+    typedef cusp::csr_matrix<IndexType,ValueType,MemorySpace> csr_matrix_type;
+    typedef cusp::ell_matrix<IndexType,ValueType,MemorySpace> ell_matrix_type;
+    typedef cusp::hyb_matrix<IndexType,ValueType,MemorySpace> hyb_matrix_type;
+    /*! \endcond */
+
+    /*! Number of calls made on the CSR matrix before a cached format is
+     *  built for the following ones.
+     */
+    size_t reuse_threshold;
+
+    /*! Structure profile of the matrix.
+     */
+    cusp::matrix_profile profile;
+
+    /*! Format used by \p cusp::multiply once the cache is built, either
+     *  \p csr_storage, \p ell_storage or \p hyb_storage. Set by
+     *  \p invalidate from the prediction and may be overridden before the
+     *  cache is built.
+     */
+    cusp::matrix_storage storage;
+
+    /*! Primary storage of the matrix.
+     */
+    csr_matrix_type csr;
+
+    /*! Construct an empty \p cached_matrix.
+     */
+    cached_matrix(void)
+        : reuse_threshold(2), storage(cusp::csr_storage)
+    {
+        invalidate();
+    }
+
+    /*! Construct a \p cached_matrix from another matrix.
+     *
+     *  \tparam MatrixType Type of input matrix.
+     *
+     *  \param A Another sparse or dense matrix.
+     */
+    template <typename MatrixType>
+    cached_matrix(const MatrixType& A)
+        : reuse_threshold(2), storage(cusp::csr_storage)
+    {
+        assign(A);
+    }
+
+    /*! Store a matrix and drop all cached formats.
+     *
+     *  \tparam MatrixType Type of input matrix.
+     *
+     *  \param A Another sparse or dense matrix.
+     */
+    template <typename MatrixType>
+    void assign(const MatrixType& A);
+
+    /*! Replace the values of the matrix while keeping its sparsity
+     *  pattern, cached formats are rebuilt on their next use.
+     *
+     *  \tparam ArrayType Type of the value array.
+     *
+     *  \param values New values in the order of \p csr.values.
+     *
+     *  \throws cusp::invalid_input_exception if \p values does not hold
+     *  \p num_entries values.
+     */
+    template <typename ArrayType>
+    void update_values(const ArrayType& values);
+
+    /*! Drop all cached formats and analyze \p csr again, required after
+     *  writing to \p csr directly.
+     */
+    void invalidate(void);
+
+    /*! Whether a cached format serves \p cusp::multiply.
+     */
+    bool is_cached(void) const
+    {
+        return format_valid;
+    }
+
+    /*! Whether a cached transpose serves \p cusp::multiply_transpose.
+     */
+    bool is_transpose_cached(void) const
+    {
+        return transpose_valid;
+    }
+
+    /*! Apply the \p cached_matrix to vector x and produce vector y.
+     *
+     *  \param x Input vector.
+     *  \param y Output vector.
+     */
+    template <typename DerivedPolicy, typename VectorType1, typename VectorType2>
+    void operator()(thrust::execution_policy<DerivedPolicy>& exec, const VectorType1& x, VectorType2& y) const;
+
+    /*! Apply the \p cached_matrix to vector x and produce vector y.
+     *
+     *  \param x Input vector.
+     *  \param y Output vector.
+     */
+    template <typename VectorType1, typename VectorType2>
+    void operator()(const VectorType1& x, VectorType2& y) const;
+
+    /*! Apply the transpose of the \p cached_matrix to vector x and produce
+     *  vector y, \p cusp::multiply_transpose calls this method.
+     *
+     *  \param x Input vector.
+     *  \param y Output vector.
+     */
+    template <typename DerivedPolicy, typename VectorType1, typename VectorType2>
+    void apply_transpose(thrust::execution_policy<DerivedPolicy>& exec, const VectorType1& x, VectorType2& y) const;
+
+private:
+
+    // converted copies, built on demand by the const apply methods
+    mutable ell_matrix_type ell;
+    mutable hyb_matrix_type hyb;
+    mutable csr_matrix_type csr_transpose;
+
+    mutable bool   format_valid;
+    mutable bool   format_rejected;
+    mutable bool   transpose_valid;
+    mutable size_t num_applies;
+    mutable size_t num_transpose_applies;
+
+    bool prepare_format(void) const;
+}; // class cached_matrix
+/*! \}
+ */
+
+} // end namespace cusp
+
+#include <cusp/detail/cached_matrix.inl>
@@ -0,0 +1,162 @@
+/*
+ *  Copyright 2008-2014 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*! \file caching_allocator.h
+ *  \brief Caching allocator for temporary storage
+ */
+
+#pragma once
+
+#include <cusp/detail/config.h>
+
+#include <cusp/memory.h>
+
+#include <cstddef>
+#include <map>
+
+namespace cusp
+{
+
+/*! \addtogroup utilities Utilities
+ *  \{
+ */
+
+/**
+ * \brief Allocator caching freed blocks for reuse by later temporaries
+ *
+ * \tparam MemorySpace memory space of the blocks (e.g. \c cusp::device_memory)
+ *
+ * \par Overview
+ *  Algorithms allocate their temporary storage through the allocator of
+ *  the execution policy they are invoked with. Passing a
+ *  \p caching_allocator to a policy with \c par(alloc) routes every
+ *  \c temporary_array of the invoked algorithm through the allocator,
+ *  which rounds requests up to a power of two and keeps released blocks
+ *  in per-size free lists instead of returning them to the system.
+ *  Cached blocks are released by \p release or when the allocator is
+ *  destroyed.
+ *
+ * \note A \p caching_allocator is not thread-safe and blocks are reused
+ *  without synchronization, hence each host thread or CUDA stream should
+ *  use its own allocator.
+ *
+ * \par Example
+ *  \code
+ *  #include <cusp/caching_allocator.h>
+ *  #include <cusp/csr_matrix.h>
+ *  #include <cusp/multiply.h>
+ *  #include <cusp/gallery/poisson.h>
+ *
+ *  int main(void)
+ *  {
+ *      cusp::csr_matrix<int, float, cusp::device_memory> A, C;
+ *      cusp::gallery::poisson5pt(A, 100, 100);
+ *
+ *      cusp::caching_allocator<cusp::device_memory> alloc;
+ *
+ *      // the second product reuses the temporaries of the first
+ *      cusp::multiply(cusp::cuda::par(alloc), A, A, C);
+ *      cusp::multiply(cusp::cuda::par(alloc), A, A, C);
+ *
+ *      alloc.print();
+ *
+ *      return 0;
+ *  }
+ *  \endcode
+ */
+template <typename MemorySpace>
+class caching_allocator
+{
+public:
+
+    typedef char value_type;
+
+    /*! \p statistics_type counts the requests served by a \p caching_allocator
+     */
+    struct statistics_type
+    {
+        size_t cache_hits;              /*!< requests served from a free list */
+        size_t cache_misses;            /*!< requests allocated from the system */
+        size_t system_deallocations;    /*!< blocks returned to the system */
+        size_t bytes_in_use;            /*!< bytes held by live allocations */
+        size_t bytes_cached;            /*!< bytes held by the free lists */
+        size_t peak_bytes;              /*!< maximum of bytes_in_use + bytes_cached */
+
+        statistics_type(void)
+            : cache_hits(0), cache_misses(0), system_deallocations(0),
+              bytes_in_use(0), bytes_cached(0), peak_bytes(0) {}
+    };
+
+    /*! Construct an empty \p caching_allocator.
+     */
+    caching_allocator(void) {}
+
+    /*! Release all blocks to the system.
+     */
+    ~caching_allocator(void);
+
+    /*! Allocate at least \p num_bytes bytes, reusing a cached block if possible.
+     *
+     *  \param num_bytes Number of bytes to allocate.
+     *  \return Pointer to the allocated block.
+     */
+    char* allocate(std::ptrdiff_t num_bytes);
+
+    /*! Return a block to its free list.
+     *
+     *  \param ptr Pointer returned by \p allocate.
+     *  \param num_bytes Ignored, the size is recorded by \p allocate.
+     */
+    void deallocate(char* ptr, size_t num_bytes);
+
+    /*! Return all cached blocks to the system. Blocks in use are unaffected.
+     */
+    void release(void);
+
+    /*! Statistics accumulated since construction.
+     */
+    const statistics_type& statistics(void) const;
+
+    /*! Print the statistics of the \p caching_allocator.
+     */
+    void print(void) const;
+
+private:
+
+    /*! \cond */
+    typedef std::multimap<size_t, char*> free_blocks_type;
+    typedef std::map<char*, size_t>      allocated_blocks_type;
+
+    // not copyable, blocks are owned by a single allocator
+    caching_allocator(const caching_allocator&);
+    caching_allocator& operator=(const caching_allocator&);
+
+    static size_t bin_size(size_t num_bytes);
+
+    char* system_allocate(size_t num_bytes);
+    void  system_deallocate(char* ptr);
+
+    free_blocks_type      free_blocks;
+    allocated_blocks_type allocated_blocks;
+    statistics_type       stats;
+    /*! \endcond */
+};
+/*! \}
+ */
+
+} // end namespace cusp
+
+#include <cusp/detail/caching_allocator.inl>
@@ -0,0 +1,246 @@
+/*
+ *  Copyright 2008-2014 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+
+/*! \file cholesky.h
+ *  \brief Sparse LDL^T factorization and direct solver
+ */
+
+#pragma once
+
+#include <cusp/detail/config.h>
+
+#include <cusp/array1d.h>
+#include <cusp/blas/blas.h>
+#include <cusp/csr_matrix.h>
+#include <cusp/linear_operator.h>
+#include <cusp/triangular_solve.h>
+
+#include <cusp/detail/execution_policy.h>
+
+#include <vector>
+
+namespace cusp
+{
+
+/*! \addtogroup iterative_solvers Iterative Solvers
+ *  \{
+ */
+
+/*! \brief Fill-reducing orderings of \p cholesky_solver
+ */
+enum cholesky_ordering
+{
+    natural_ordering,   //!< factor the matrix as given
+    rcm_ordering        //!< reverse Cuthill-McKee, see \p cusp::graph::symmetric_rcm
+};
+
+/**
+ * \brief Sparse direct solver based on a supernodal LDL^T factorization
+ *
+ * \tparam ValueType Type of the matrix and vector entries (e.g. \c double).
+ * \tparam MemorySpace Memory space of the factors and of the solves
+ * (e.g. \c cusp::device_memory).
+ * \tparam IndexType Type used for indices (e.g. \c int).
+ *
+ * \par Overview
+ *  A \p cholesky_solver factors a symmetric matrix <tt>P A P^T = L D L^T</tt>
+ *  with unit lower triangular \c L, diagonal \c D and a fill-reducing
+ *  permutation \c P, and applies <tt>A^-1</tt> with two sparse triangular
+ *  solves. \c A stores both triangles, of which only the lower triangle
+ *  of <tt>P A P^T</tt> is read. Symmetric
+ *  positive definite matrices, for which this is the Cholesky factorization,
+ *  and quasi-definite matrices factor without pivoting, a zero pivot throws
+ *  a \p cusp::runtime_exception.
+ *
+ *  The factorization runs on the host. The symbolic phase computes the
+ *  elimination tree, the pattern of \c L and its fundamental supernodes,
+ *  i.e. runs of columns sharing one pattern, which the numeric phase
+ *  factors as dense blocks. The factors and the level schedule of both
+ *  triangular solves (see \p cusp::triangular_solve) are then stored in
+ *  \p MemorySpace, so a solve does not leave the memory space of its
+ *  vectors. \p refactor repeats only the numeric phase for a matrix with
+ *  the pattern of the first one.
+ *
+ *  The solver replaces the dense coarse solver of a multigrid hierarchy
+ *  whose coarsest level is too large for a dense factorization, e.g.
+ *  <tt>smoothed_aggregation<int, double, cusp::device_memory, Smoother,
+ *  cusp::cholesky_solver<double, cusp::device_memory> ></tt>.
+ *
+ * \par Example
+ *  \code
+ *  #include <cusp/cholesky.h>
+ *  #include <cusp/csr_matrix.h>
+ *  #include <cusp/gallery/poisson.h>
+ *
+ *  int main(void)
+ *  {
+ *      cusp::csr_matrix<int, double, cusp::device_memory> A;
+ *      cusp::gallery::poisson5pt(A, 100, 100);
+ *
+ *      // factor with a reverse Cuthill-McKee ordering
+ *      cusp::cholesky_solver<double, cusp::device_memory> solver(A);
+ *
+ *      cusp::array1d<double, cusp::device_memory> x(A.num_rows);
+ *      cusp::array1d<double, cusp::device_memory> b(A.num_rows, 1);
+ *
+ *      // x = A^-1 b
+ *      solver(b, x);
+ *
+ *      // new values on the same pattern
+ *      cusp::blas::scal(A.values, 2.0);
+ *      solver.refactor(A);
+ *      solver(b, x);
+ *
+ *      return 0;
+ *  }
+ *  \endcode
+ */
+template <typename ValueType, typename MemorySpace, typename IndexType = int>
+class cholesky_solver : public cusp::linear_operator<ValueType,MemorySpace,IndexType>
+{
+private:
+
+    typedef cusp::linear_operator<ValueType,MemorySpace,IndexType> Parent;
+
+public:
+
+    /*! \cond */
+    typedef cusp::csr_matrix<IndexType,ValueType,MemorySpace>     factor_type;
+    typedef cusp::triangular_solve_plan<IndexType,MemorySpace>    plan_type;
+    typedef cusp::array1d<IndexType,MemorySpace>                  index_array_type;
+    typedef cusp::array1d<ValueType,MemorySpace>                  value_array_type;
+    /*! \endcond */
+
+    /*! Strictly lower triangle of \c L and its transpose.
+     */
+    factor_type L;
+    factor_type U;
+
+    /*! Inverse of the diagonal \c D.
+     */
+    value_array_type inverse_diagonal;
+
+    /*! Row \c i of \c A is row <tt>permutation[i]</tt> of <tt>P A P^T</tt>,
+     *  and row \c i of <tt>P A P^T</tt> is row <tt>inverse_permutation[i]</tt>
+     *  of \c A.
+     */
+    index_array_type permutation;
+    index_array_type inverse_permutation;
+
+    /*! Level schedules of the solves with \c L and \c U.
+     */
+    plan_type lower_plan;
+    plan_type upper_plan;
+
+    /*! Construct an empty \p cholesky_solver.
+     */
+    cholesky_solver(void) : ordering(rcm_ordering) {}
+
+    /*! Factor the symmetric matrix \p A.
+     *
+     *  \param A symmetric matrix in any format and memory space
+     *  \param ordering fill-reducing ordering of the rows and columns
+     *
+     *  \throws cusp::invalid_input_exception if \p A is not square
+     *  \throws cusp::runtime_exception if a pivot is zero
+     */
+    template <typename MatrixType>
+    cholesky_solver(const MatrixType& A, const cholesky_ordering ordering = rcm_ordering);
+
+    /*! Construct a \p cholesky_solver from another solver, possibly in a
+     *  different memory space.
+     */
+    template <typename MemorySpace2>
+    cholesky_solver(const cholesky_solver<ValueType,MemorySpace2,IndexType>& solver);
+
+    /*! Factor the symmetric matrix \p A, discarding the previous factors.
+     */
+    template <typename MatrixType>
+    void factor(const MatrixType& A, const cholesky_ordering ordering = rcm_ordering);
+
+    /*! Factor \p A, which must have the pattern and the entry order of the
+     *  matrix given to \p factor, reusing the ordering and the symbolic
+     *  factorization.
+     *
+     *  \throws cusp::invalid_input_exception if the size of \p A differs
+     *  \throws cusp::runtime_exception if a pivot is zero
+     */
+    template <typename MatrixType>
+    void refactor(const MatrixType& A);
+
+    /*! Solve <tt>A x = b</tt>.
+     *
+     *  \param b right hand side
+     *  \param x solution, may be the same array as \p b
+     */
+    template <typename DerivedPolicy, typename VectorType1, typename VectorType2>
+    void operator()(thrust::execution_policy<DerivedPolicy>& exec, const VectorType1& b, VectorType2& x) const;
+
+    /*! Solve <tt>A x = b</tt>.
+     *
+     *  \param b right hand side
+     *  \param x solution, may be the same array as \p b
+     */
+    template <typename VectorType1, typename VectorType2>
+    void operator()(const VectorType1& b, VectorType2& x) const;
+
+    /*! Number of supernodes of the factorization.
+     */
+    size_t num_supernodes(void) const
+    {
+        return supernode_columns.empty() ? 0 : supernode_columns.size() - 1;
+    }
+
+    /*! Storage of the factors and the solve schedules in \p MemorySpace.
+     */
+    friend size_t operator_bytes(const cholesky_solver& M)
+    {
+        return M.factor_bytes();
+    }
+
+    /*! \cond */
+    // symbolic factorization on the host, shared with solvers in other
+    // memory spaces
+    cholesky_ordering      ordering;
+    std::vector<IndexType> host_permutation;
+    std::vector<IndexType> supernode_columns;
+    std::vector<IndexType> supernode_row_offsets;
+    std::vector<IndexType> supernode_rows;
+    std::vector<size_t>    supernode_value_offsets;
+    std::vector<size_t>    value_map;
+    /*! \endcond */
+
+private:
+
+    /*! \cond */
+    mutable value_array_type workspace;
+
+    template <typename HostMatrixType>
+    void analyze(const HostMatrixType& A);
+
+    template <typename HostMatrixType>
+    void numeric(const HostMatrixType& A);
+
+    size_t factor_bytes(void) const;
+    /*! \endcond */
+};
+/*! \}
+ */
+
+} // end namespace cusp
+
+#include <cusp/detail/cholesky.inl>
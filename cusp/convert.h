@@ -22,6 +22,7 @@
 
 #include <cusp/detail/config.h>
 #include <cusp/detail/execution_policy.h>
+#include <cusp/detail/type_traits.h>
 
 namespace cusp
 {
@@ -43,6 +44,20 @@ void convert(const thrust::detail::execution_policy_base<DerivedPolicy> &exec,
                    DestinationType& dst);
 /*! \endcond */
 
+/*! \cond */
+template <typename, typename, typename> class csr_pattern_matrix;
+
+// keeps the sparsity pattern of src, see csr_pattern_matrix
+template <typename DerivedPolicy,
+          typename SourceType,
+          typename IndexType,
+          typename ValueType,
+          typename MemorySpace>
+void convert(const thrust::detail::execution_policy_base<DerivedPolicy> &exec,
+             const SourceType& src,
+                   cusp::csr_pattern_matrix<IndexType,ValueType,MemorySpace>& dst);
+/*! \endcond */
+
 /**
  * \brief Convert between matrix formats
  *
@@ -90,6 +105,81 @@ template <typename SourceType,
           typename DestinationType>
 void convert(const SourceType& src,
                    DestinationType& dst);
+
+/*! \cond */
+template <typename DerivedPolicy,
+          typename SourceType,
+          typename DestinationType>
+void move_convert(const thrust::detail::execution_policy_base<DerivedPolicy> &exec,
+                  SourceType& src,
+                  DestinationType& dst);
+/*! \endcond */
+
+/**
+ * \brief Convert between matrix formats, consuming the source matrix
+ *
+ * \tparam SourceType Type of the input matrix to convert
+ * \tparam DestinationType Type of the output matrix to create
+ *
+ * \param src Input matrix to convert, left empty on return
+ * \param dst Output matrix created by converting src to the specified format
+ *
+ * \par Overview
+ * Converting from \p coo_matrix to \p csr_matrix, or back, with the same
+ * index type, value type and memory space reuses the column indices and
+ * values of \p src and only computes the row offsets (or the row
+ * indices). The peak footprint is one matrix plus one row array instead
+ * of two matrices. Other conversions perform \p convert and release the
+ * storage of \p src afterwards. With C++11, \p convert of an rvalue
+ * \p coo_matrix or \p csr_matrix, e.g. <tt>cusp::convert(std::move(A), B)</tt>,
+ * is the same as \p move_convert.
+ *
+ * \par Example
+ * \code
+ * #include <cusp/coo_matrix.h>
+ * #include <cusp/csr_matrix.h>
+ *
+ * #include <cusp/gallery/poisson.h>
+ *
+ * // include cusp convert header file
+ * #include <cusp/convert.h>
+ *
+ * int main()
+ * {
+ *   // create 2D Poisson problem
+ *   cusp::coo_matrix<int,float,cusp::device_memory> A;
+ *   cusp::gallery::poisson5pt(A, 4, 4);
+ *
+ *   // convert coo_matrix to csr_matrix, A is empty afterwards
+ *   cusp::csr_matrix<int,float,cusp::device_memory> B;
+ *   cusp::move_convert(A, B);
+ * }
+ * \endcode
+ *
+ * \see \p convert
+ */
+template <typename SourceType,
+          typename DestinationType>
+void move_convert(SourceType& src,
+                  DestinationType& dst);
+
+#if __cplusplus >= 201103L
+/*! \cond */
+template <typename IndexType,
+          typename ValueType,
+          typename MemorySpace,
+          typename DestinationType>
+void convert(cusp::coo_matrix<IndexType,ValueType,MemorySpace>&& src,
+             DestinationType& dst);
+
+template <typename IndexType,
+          typename ValueType,
+          typename MemorySpace,
+          typename DestinationType>
+void convert(cusp::csr_matrix<IndexType,ValueType,MemorySpace>&& src,
+             DestinationType& dst);
+/*! \endcond */
+#endif
 /*! \}
  */
 
@@ -169,6 +169,19 @@ public:
           column_indices(num_entries),
           values(num_entries) {}
 
+    /*! Construct a \p coo_matrix with a specific shape and number of nonzero
+     *  entries without initializing the storage.
+     *
+     *  \param num_rows Number of rows.
+     *  \param num_cols Number of columns.
+     *  \param num_entries Number of nonzero matrix entries.
+     */
+    coo_matrix(const size_t num_rows, const size_t num_cols, const size_t num_entries, cusp::no_init_t)
+        : Parent(num_rows, num_cols, num_entries),
+          row_indices(num_entries, cusp::no_init),
+          column_indices(num_entries, cusp::no_init),
+          values(num_entries, cusp::no_init) {}
+
     /*! Construct a \p coo_matrix from another matrix.
      *
      *  \param matrix Another sparse or dense matrix.
@@ -180,6 +193,15 @@ public:
      */
     void resize(size_t num_rows, size_t num_cols, size_t num_entries);
 
+    /*! Resize matrix dimensions and underlying storage without initializing
+     *  the new entries.
+     *
+     *  \param num_rows Number of rows.
+     *  \param num_cols Number of columns.
+     *  \param num_entries Number of nonzero matrix entries.
+     */
+    void resize(const size_t num_rows, const size_t num_cols, const size_t num_entries, cusp::no_init_t);
+
     /*! Swap the contents of two \p coo_matrix objects.
      *
      *  \param matrix Another \p coo_matrix with the same IndexType and ValueType.
@@ -440,6 +462,14 @@ public:
      */
     void resize(const size_t num_rows, const size_t num_cols, const size_t num_entries);
 
+    /*! A view never initializes its storage, this is the same as
+     *  resize(num_rows, num_cols, num_entries).
+     */
+    void resize(const size_t num_rows, const size_t num_cols, const size_t num_entries, cusp::no_init_t)
+    {
+        resize(num_rows, num_cols, num_entries);
+    }
+
     /*! Sort matrix elements by row index
      */
     void sort_by_row(void);
@@ -49,6 +49,7 @@ template <typename ArrayType1, typename ArrayType2, typename ArrayType3, typenam
  * \tparam IndexType Type used for matrix indices (e.g. \c int).
  * \tparam ValueType Type used for matrix values (e.g. \c float).
  * \tparam MemorySpace A memory space (e.g. \c cusp::host_memory or \c cusp::device_memory)
+ * \tparam OffsetType Type used for row offsets, defaults to \p IndexType.
  *
  * \par Overview
  *  A \p csr_matrix is a sparse matrix container that stores an offset to the
@@ -60,6 +61,10 @@ template <typename ArrayType1, typename ArrayType2, typename ArrayType3, typenam
  *
  * \note The matrix entries within the same row must be sorted by column index.
  * \note The matrix should not contain duplicate entries.
+ * \note A 64-bit \p OffsetType such as \c long \c long addresses more than
+ * 2^31 entries while 32-bit column indices keep the storage and bandwidth
+ * of \c column_indices unchanged, e.g.
+ * <tt>cusp::csr_matrix<int,float,cusp::device_memory,long long></tt>.
  *
  * \par Example
  *  The following code snippet demonstrates how to create a 4-by-3
@@ -103,7 +108,7 @@ template <typename ArrayType1, typename ArrayType2, typename ArrayType3, typenam
  *  }
  *  \endcode
  */
-template <typename IndexType, typename ValueType, class MemorySpace>
+template <typename IndexType, typename ValueType, class MemorySpace, typename OffsetType>
 class csr_matrix : public cusp::detail::matrix_base<IndexType,ValueType,MemorySpace,cusp::csr_format>
 {
 private:
@@ -113,11 +118,13 @@ private:
 public:
 
     /*! \cond */
-    typedef typename cusp::array1d<IndexType, MemorySpace> row_offsets_array_type;
+    typedef OffsetType offset_type;
+
+    typedef typename cusp::array1d<OffsetType, MemorySpace> row_offsets_array_type;
     typedef typename cusp::array1d<IndexType, MemorySpace> column_indices_array_type;
     typedef typename cusp::array1d<ValueType, MemorySpace> values_array_type;
 
-    typedef typename cusp::csr_matrix<IndexType, ValueType, MemorySpace> container;
+    typedef typename cusp::csr_matrix<IndexType, ValueType, MemorySpace, OffsetType> container;
 
     typedef typename cusp::csr_matrix_view<typename row_offsets_array_type::view,
             typename column_indices_array_type::view,
@@ -136,7 +143,7 @@ public:
     template<typename MemorySpace2>
     struct rebind
     {
-        typedef cusp::csr_matrix<IndexType, ValueType, MemorySpace2> type;
+        typedef cusp::csr_matrix<IndexType, ValueType, MemorySpace2, OffsetType> type;
     };
     /*! \endcond */
 
@@ -168,6 +175,19 @@ public:
           column_indices(num_entries),
           values(num_entries) {}
 
+    /*! Construct a \p csr_matrix with a specific shape and number of nonzero
+     *  entries without initializing the storage.
+     *
+     *  \param num_rows Number of rows.
+     *  \param num_cols Number of columns.
+     *  \param num_entries Number of nonzero matrix entries.
+     */
+    csr_matrix(const size_t num_rows, const size_t num_cols, const size_t num_entries, cusp::no_init_t)
+        : Parent(num_rows, num_cols, num_entries),
+          row_offsets(num_rows + 1, cusp::no_init),
+          column_indices(num_entries, cusp::no_init),
+          values(num_entries, cusp::no_init) {}
+
     /*! Construct a \p csr_matrix from another matrix.
      *
      *  \tparam MatrixType Type of input matrix used to create this \p
@@ -186,6 +206,15 @@ public:
      */
     void resize(const size_t num_rows, const size_t num_cols, const size_t num_entries);
 
+    /*! Resize matrix dimensions and underlying storage without initializing
+     *  the new entries.
+     *
+     *  \param num_rows Number of rows.
+     *  \param num_cols Number of columns.
+     *  \param num_entries Number of nonzero matrix entries.
+     */
+    void resize(const size_t num_rows, const size_t num_cols, const size_t num_entries, cusp::no_init_t);
+
     /*! Swap the contents of two \p csr_matrix objects.
      *
      *  \param matrix Another \p csr_matrix with the same IndexType and ValueType.
@@ -218,7 +247,8 @@ public:
  * \tparam ArrayType1 Type of \c row_offsets array view
  * \tparam ArrayType2 Type of \c column_indices array view
  * \tparam ArrayType3 Type of \c values array view
- * \tparam IndexType Type used for matrix indices (e.g. \c int).
+ * \tparam IndexType Type used for matrix indices (e.g. \c int), defaults to
+ * the value type of \c column_indices.
  * \tparam ValueType Type used for matrix values (e.g. \c float).
  * \tparam MemorySpace A memory space (e.g. \c cusp::host_memory or \c cusp::device_memory)
  *
@@ -294,7 +324,7 @@ public:
 template <typename ArrayType1,
           typename ArrayType2,
           typename ArrayType3,
-          typename IndexType   = typename ArrayType1::value_type,
+          typename IndexType   = typename ArrayType2::value_type,
           typename ValueType   = typename ArrayType3::value_type,
           typename MemorySpace = typename cusp::minimum_space<
                                     typename ArrayType1::memory_space,
@@ -313,7 +343,9 @@ public:
     typedef ArrayType2 column_indices_array_type;
     typedef ArrayType3 values_array_type;
 
-    typedef typename cusp::csr_matrix<IndexType, ValueType, MemorySpace> container;
+    typedef typename ArrayType1::value_type offset_type;
+
+    typedef typename cusp::csr_matrix<IndexType, ValueType, MemorySpace, offset_type> container;
     typedef typename cusp::csr_matrix_view<ArrayType1, ArrayType2, ArrayType3, IndexType, ValueType, MemorySpace> view;
     typedef typename cusp::csr_matrix_view<ArrayType1, ArrayType2, ArrayType3, IndexType, ValueType, MemorySpace> const_view;
 
@@ -368,7 +400,7 @@ public:
      *
      *  \param matrix \p csr_matrix used to create view.
      */
-    csr_matrix_view(csr_matrix<IndexType,ValueType,MemorySpace>& matrix)
+    csr_matrix_view(csr_matrix<IndexType,ValueType,MemorySpace,offset_type>& matrix)
         : Parent(matrix),
           row_offsets(matrix.row_offsets),
           column_indices(matrix.column_indices),
@@ -378,7 +410,7 @@ public:
      *
      *  \param matrix \p csr_matrix used to create view.
      */
-    csr_matrix_view(const csr_matrix<IndexType,ValueType,MemorySpace>& matrix)
+    csr_matrix_view(const csr_matrix<IndexType,ValueType,MemorySpace,offset_type>& matrix)
         : Parent(matrix),
           row_offsets(matrix.row_offsets),
           column_indices(matrix.column_indices),
@@ -411,6 +443,14 @@ public:
      *  \param num_entries Number of nonzero matrix entries.
      */
     void resize(const size_t num_rows, const size_t num_cols, const size_t num_entries);
+
+    /*! A view never initializes its storage, this is the same as
+     *  resize(num_rows, num_cols, num_entries).
+     */
+    void resize(const size_t num_rows, const size_t num_cols, const size_t num_entries, cusp::no_init_t)
+    {
+        resize(num_rows, num_cols, num_entries);
+    }
 };
 
 /* Convenience functions */
@@ -483,14 +523,15 @@ make_csr_matrix_view(const csr_matrix_view<ArrayType1,ArrayType2,ArrayType3,Inde
  *  \tparam IndexType  indices type
  *  \tparam ValueType  values type
  *  \tparam MemorySpace memory space of the arrays
+ *  \tparam OffsetType row offsets type
  *
  *  \param m Exemplar \p csr_matrix matrix to copy.
  *
  *  \return \p csr_matrix_view constructed using input arrays.
  */
-template <typename IndexType, typename ValueType, class MemorySpace>
-typename csr_matrix<IndexType,ValueType,MemorySpace>::view
-make_csr_matrix_view(csr_matrix<IndexType,ValueType,MemorySpace>& m)
+template <typename IndexType, typename ValueType, class MemorySpace, typename OffsetType>
+typename csr_matrix<IndexType,ValueType,MemorySpace,OffsetType>::view
+make_csr_matrix_view(csr_matrix<IndexType,ValueType,MemorySpace,OffsetType>& m)
 {
     return make_csr_matrix_view
            (m.num_rows, m.num_cols, m.num_entries,
@@ -506,14 +547,15 @@ make_csr_matrix_view(csr_matrix<IndexType,ValueType,MemorySpace>& m)
  *  \tparam IndexType  indices type
  *  \tparam ValueType  values type
  *  \tparam MemorySpace memory space of the arrays
+ *  \tparam OffsetType row offsets type
  *
  *  \param m Exemplar \p csr_matrix matrix to copy.
  *
  *  \return \p csr_matrix_view constructed using input arrays.
  */
-template <typename IndexType, typename ValueType, class MemorySpace>
-typename csr_matrix<IndexType,ValueType,MemorySpace>::const_view
-make_csr_matrix_view(const csr_matrix<IndexType,ValueType,MemorySpace>& m)
+template <typename IndexType, typename ValueType, class MemorySpace, typename OffsetType>
+typename csr_matrix<IndexType,ValueType,MemorySpace,OffsetType>::const_view
+make_csr_matrix_view(const csr_matrix<IndexType,ValueType,MemorySpace,OffsetType>& m)
 {
     return make_csr_matrix_view
            (m.num_rows, m.num_cols, m.num_entries,
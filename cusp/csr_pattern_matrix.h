@@ -0,0 +1,273 @@
+/*
+ *  Copyright 2008-2014 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*! \file csr_pattern_matrix.h
+ *  \brief Compressed Sparse Row sparsity pattern with implicit unit values.
+ */
+
+#pragma once
+
+#include <cusp/detail/config.h>
+
+#include <cusp/array1d.h>
+#include <cusp/csr_matrix.h>
+#include <cusp/memory.h>
+
+#include <cusp/detail/format.h>
+#include <cusp/detail/matrix_base.h>
+
+namespace cusp
+{
+
+/*! \addtogroup sparse_matrices Sparse Matrices
+ */
+
+/*! \addtogroup sparse_matrix_containers Sparse Matrix Containers
+ *  \ingroup sparse_matrices
+ *  \{
+ */
+
+/**
+ * \brief CSR sparsity pattern of a sparse matrix, e.g. a graph adjacency
+ * matrix
+ *
+ * \tparam IndexType Type used for matrix indices (e.g. \c int).
+ * \tparam ValueType Type of the implicit unit entries (e.g. \c int).
+ * \tparam MemorySpace A memory space (e.g. \c cusp::host_memory or \c cusp::device_memory)
+ *
+ * \par Overview
+ *  A \p csr_pattern_matrix stores the row offsets and column indices of a
+ *  \p csr_matrix, but no values. Every stored entry is one, the \c values
+ *  member is a \p constant_array that only records the number of entries,
+ *  so the pattern takes one third to one half less memory than a
+ *  \p csr_matrix with \c float or \c double values.
+ *
+ *  The format of the pattern is \p csr_format, so SpMV, generalized SpMV,
+ *  conversions to other formats and the graph algorithms of \p cusp::graph
+ *  use the CSR implementations directly. Their kernels read the values
+ *  through the \p constant_iterator of the pattern, i.e. without any memory
+ *  traffic for the values. Converting another matrix to a
+ *  \p csr_pattern_matrix keeps its sparsity pattern, including explicitly
+ *  stored zeros, and drops the values.
+ *
+ * \note The matrix entries within the same row must be sorted by column index.
+ * \note The matrix should not contain duplicate entries.
+ *
+ * \par Example
+ *  The following code snippet demonstrates how to extract the adjacency
+ *  pattern of a \p csr_matrix and traverse it on the device.
+ *
+ *  \code
+ *  #include <cusp/csr_matrix.h>
+ *  #include <cusp/csr_pattern_matrix.h>
+ *  #include <cusp/gallery/poisson.h>
+ *  #include <cusp/graph/breadth_first_search.h>
+ *  #include <cusp/print.h>
+ *
+ *  int main()
+ *  {
+ *    cusp::csr_matrix<int,float,cusp::host_memory> A;
+ *    cusp::gallery::poisson5pt(A, 4, 4);
+ *
+ *    // keep only the row offsets and column indices, on the device
+ *    cusp::csr_pattern_matrix<int,int,cusp::device_memory> G(A);
+ *
+ *    // breadth first search levels from vertex 0
+ *    cusp::array1d<int,cusp::device_memory> levels(G.num_rows);
+ *    cusp::graph::breadth_first_search(G, 0, levels);
+ *
+ *    cusp::print(levels);
+ *  }
+ *  \endcode
+ */
+template <typename IndexType, typename ValueType, class MemorySpace>
+class csr_pattern_matrix : public cusp::detail::matrix_base<IndexType,ValueType,MemorySpace,cusp::csr_format>
+{
+private:
+
+    typedef cusp::detail::matrix_base<IndexType,ValueType,MemorySpace,cusp::csr_format> Parent;
+
+public:
+
+    /*! \cond */
+    typedef typename cusp::array1d<IndexType, MemorySpace> row_offsets_array_type;
+    typedef typename cusp::array1d<IndexType, MemorySpace> column_indices_array_type;
+    typedef typename cusp::constant_array<ValueType>       values_array_type;
+
+    typedef typename cusp::csr_pattern_matrix<IndexType, ValueType, MemorySpace> container;
+
+    typedef typename cusp::csr_matrix_view<typename row_offsets_array_type::view,
+            typename column_indices_array_type::view,
+            typename values_array_type::view,
+            IndexType, ValueType, MemorySpace> view;
+
+    typedef typename cusp::csr_matrix_view<typename row_offsets_array_type::const_view,
+            typename column_indices_array_type::const_view,
+            typename values_array_type::const_view,
+            IndexType, ValueType, MemorySpace> const_view;
+
+    template<typename MemorySpace2>
+    struct rebind
+    {
+        typedef cusp::csr_pattern_matrix<IndexType, ValueType, MemorySpace2> type;
+    };
+    /*! \endcond */
+
+    /*! Storage for the row offsets of the CSR data structure.
+     */
+    row_offsets_array_type row_offsets;
+
+    /*! Storage for the column indices of the CSR data structure.
+     */
+    column_indices_array_type column_indices;
+
+    /*! The implicit unit entries, one per column index.
+     */
+    values_array_type values;
+
+    /*! Construct an empty \p csr_pattern_matrix.
+     */
+    csr_pattern_matrix(void)
+        : values(0, ValueType(1)) {}
+
+    /*! Construct a \p csr_pattern_matrix with a specific shape and number of nonzero entries.
+     *
+     *  \param num_rows Number of rows.
+     *  \param num_cols Number of columns.
+     *  \param num_entries Number of nonzero matrix entries.
+     */
+    csr_pattern_matrix(const size_t num_rows, const size_t num_cols, const size_t num_entries)
+        : Parent(num_rows, num_cols, num_entries),
+          row_offsets(num_rows + 1),
+          column_indices(num_entries),
+          values(num_entries, ValueType(1)) {}
+
+    /*! Construct a \p csr_pattern_matrix with a specific shape and number of
+     *  nonzero entries without initializing the storage.
+     *
+     *  \param num_rows Number of rows.
+     *  \param num_cols Number of columns.
+     *  \param num_entries Number of nonzero matrix entries.
+     */
+    csr_pattern_matrix(const size_t num_rows, const size_t num_cols, const size_t num_entries, cusp::no_init_t)
+        : Parent(num_rows, num_cols, num_entries),
+          row_offsets(num_rows + 1, cusp::no_init),
+          column_indices(num_entries, cusp::no_init),
+          values(num_entries, ValueType(1)) {}
+
+    /*! Construct a \p csr_pattern_matrix from the sparsity pattern of another matrix.
+     *
+     *  \tparam MatrixType Type of input matrix used to create this \p
+     *  csr_pattern_matrix.
+     *
+     *  \param matrix Another sparse or dense matrix.
+     */
+    template <typename MatrixType>
+    csr_pattern_matrix(const MatrixType& matrix);
+
+    /*! Resize matrix dimensions and underlying storage
+     *
+     *  \param num_rows Number of rows.
+     *  \param num_cols Number of columns.
+     *  \param num_entries Number of nonzero matrix entries.
+     */
+    void resize(const size_t num_rows, const size_t num_cols, const size_t num_entries);
+
+    /*! Resize matrix dimensions and underlying storage without initializing
+     *  the new entries.
+     *
+     *  \param num_rows Number of rows.
+     *  \param num_cols Number of columns.
+     *  \param num_entries Number of nonzero matrix entries.
+     */
+    void resize(const size_t num_rows, const size_t num_cols, const size_t num_entries, cusp::no_init_t);
+
+    /*! Swap the contents of two \p csr_pattern_matrix objects.
+     *
+     *  \param matrix Another \p csr_pattern_matrix with the same IndexType and ValueType.
+     */
+    void swap(csr_pattern_matrix& matrix);
+
+    /*! Assignment from the sparsity pattern of another matrix.
+     *
+     *  \tparam MatrixType Type of input matrix to copy into this \p
+     *  csr_pattern_matrix.
+     *
+     *  \param matrix Another sparse or dense matrix.
+     */
+    template <typename MatrixType>
+    csr_pattern_matrix& operator=(const MatrixType& matrix);
+
+}; // class csr_pattern_matrix
+/*! \}
+ */
+
+/*! \addtogroup sparse_matrix_views Sparse Matrix Views
+ *  \ingroup sparse_matrices
+ *  \{
+ */
+
+/**
+ *  This is a convenience function for generating a \p csr_matrix_view
+ *  using an existing \p csr_pattern_matrix.
+ *
+ *  \tparam IndexType  indices type
+ *  \tparam ValueType  values type
+ *  \tparam MemorySpace memory space of the arrays
+ *
+ *  \param m Exemplar \p csr_pattern_matrix matrix to copy.
+ *
+ *  \return \p csr_matrix_view constructed using input arrays.
+ */
+template <typename IndexType, typename ValueType, class MemorySpace>
+typename csr_pattern_matrix<IndexType,ValueType,MemorySpace>::view
+make_csr_matrix_view(csr_pattern_matrix<IndexType,ValueType,MemorySpace>& m)
+{
+    return typename csr_pattern_matrix<IndexType,ValueType,MemorySpace>::view
+           (m.num_rows, m.num_cols, m.num_entries,
+            make_array1d_view(m.row_offsets),
+            make_array1d_view(m.column_indices),
+            make_array1d_view(m.values));
+}
+
+/**
+ *  This is a convenience function for generating a const \p csr_matrix_view
+ *  using an existing \p csr_pattern_matrix.
+ *
+ *  \tparam IndexType  indices type
+ *  \tparam ValueType  values type
+ *  \tparam MemorySpace memory space of the arrays
+ *
+ *  \param m Exemplar \p csr_pattern_matrix matrix to copy.
+ *
+ *  \return \p csr_matrix_view constructed using input arrays.
+ */
+template <typename IndexType, typename ValueType, class MemorySpace>
+typename csr_pattern_matrix<IndexType,ValueType,MemorySpace>::const_view
+make_csr_matrix_view(const csr_pattern_matrix<IndexType,ValueType,MemorySpace>& m)
+{
+    return typename csr_pattern_matrix<IndexType,ValueType,MemorySpace>::const_view
+           (m.num_rows, m.num_cols, m.num_entries,
+            make_array1d_view(m.row_offsets),
+            make_array1d_view(m.column_indices),
+            make_array1d_view(m.values));
+}
+/*! \}
+ */
+
+} // end namespace cusp
+
+#include <cusp/detail/csr_pattern_matrix.inl>
@@ -0,0 +1,454 @@
+/*
+ *  Copyright 2008-2014 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*! \file dcsr_matrix.h
+ *  \brief Compressed Sparse Row matrix format with 16-bit column deltas.
+ */
+
+#pragma once
+
+#include <cusp/detail/config.h>
+
+#include <cusp/array1d.h>
+#include <cusp/memory.h>
+
+#include <cusp/detail/format.h>
+#include <cusp/detail/matrix_base.h>
+#include <cusp/detail/type_traits.h>
+
+namespace cusp
+{
+
+// forward definition
+template <typename ArrayType1, typename ArrayType2, typename ArrayType3, typename ArrayType4, typename ArrayType5,
+          typename IndexType, typename ValueType, typename MemorySpace> class dcsr_matrix_view;
+
+/*! \addtogroup sparse_matrices Sparse Matrices
+ */
+
+/*! \addtogroup sparse_matrix_containers Sparse Matrix Containers
+ *  \ingroup sparse_matrices
+ *  \{
+ */
+
+/**
+ * \brief Delta-compressed CSR representation of a sparse matrix
+ *
+ * \tparam IndexType Type used for matrix indices (e.g. \c int).
+ * \tparam ValueType Type used for matrix values (e.g. \c float).
+ * \tparam MemorySpace A memory space (e.g. \c cusp::host_memory or \c cusp::device_memory)
+ *
+ * \par Overview
+ *  A \p dcsr_matrix stores the row offsets and values of a matrix exactly like
+ *  a \p csr_matrix, but replaces the column index of every entry by its
+ *  16-bit offset from the diagonal, <tt>column_deltas[jj] = j - i</tt>. For
+ *  banded matrices, e.g. after reordering with \p symmetric_rcm, this halves
+ *  the index traffic of a sparse matrix-vector multiplication.
+ *
+ *  The rows are grouped into blocks of \c rows_per_block consecutive rows. If
+ *  any entry of a block lies further than \c max_delta from the diagonal, the
+ *  complete block falls back to full column indices, which are stored in
+ *  \c column_indices starting at position <tt>block_offsets[b]</tt>. Blocks
+ *  using deltas satisfy <tt>block_offsets[b] == block_offsets[b + 1]</tt>.
+ *
+ * \note The deltas of entries in blocks using full indices are unused.
+ * \note The matrix should not contain duplicate entries.
+ *
+ * \par Example
+ *  The following code snippet demonstrates how to create a \p dcsr_matrix
+ *  from a \p csr_matrix and copy it to the device.
+ *
+ *  \code
+ *  // include the dcsr_matrix header file
+ *  #include <cusp/csr_matrix.h>
+ *  #include <cusp/dcsr_matrix.h>
+ *  #include <cusp/gallery/poisson.h>
+ *  #include <cusp/print.h>
+ *
+ *  int main()
+ *  {
+ *    cusp::csr_matrix<int,float,cusp::host_memory> A;
+ *    cusp::gallery::poisson5pt(A, 4, 4);
+ *
+ *    // compress the column indices
+ *    cusp::dcsr_matrix<int,float,cusp::host_memory> B(A);
+ *
+ *    // copy to the device
+ *    cusp::dcsr_matrix<int,float,cusp::device_memory> C(B);
+ *
+ *    cusp::print(C);
+ *  }
+ *  \endcode
+ */
+template <typename IndexType, typename ValueType, class MemorySpace>
+class dcsr_matrix : public cusp::detail::matrix_base<IndexType,ValueType,MemorySpace,cusp::dcsr_format>
+{
+private:
+
+    typedef cusp::detail::matrix_base<IndexType,ValueType,MemorySpace,cusp::dcsr_format> Parent;
+
+public:
+
+    /*! Type used to store the column offsets relative to the diagonal.
+     */
+    typedef short delta_type;
+
+    /*! Number of consecutive rows sharing the same index representation.
+     */
+    const static size_t rows_per_block = 256;
+
+    /*! Largest distance from the diagonal representable by a \c delta_type.
+     */
+    const static IndexType max_delta = 32767;
+
+    /*! \cond */
+    typedef typename cusp::array1d<IndexType, MemorySpace>  row_offsets_array_type;
+    typedef typename cusp::array1d<IndexType, MemorySpace>  block_offsets_array_type;
+    typedef typename cusp::array1d<delta_type, MemorySpace> column_deltas_array_type;
+    typedef typename cusp::array1d<IndexType, MemorySpace>  column_indices_array_type;
+    typedef typename cusp::array1d<ValueType, MemorySpace>  values_array_type;
+
+    typedef typename cusp::dcsr_matrix<IndexType, ValueType, MemorySpace> container;
+
+    typedef typename cusp::dcsr_matrix_view<typename row_offsets_array_type::view,
+            typename block_offsets_array_type::view,
+            typename column_deltas_array_type::view,
+            typename column_indices_array_type::view,
+            typename values_array_type::view,
+            IndexType, ValueType, MemorySpace> view;
+
+    typedef typename cusp::dcsr_matrix_view<typename row_offsets_array_type::const_view,
+            typename block_offsets_array_type::const_view,
+            typename column_deltas_array_type::const_view,
+            typename column_indices_array_type::const_view,
+            typename values_array_type::const_view,
+            IndexType, ValueType, MemorySpace> const_view;
+
+    template<typename MemorySpace2>
+    struct rebind
+    {
+        typedef cusp::dcsr_matrix<IndexType, ValueType, MemorySpace2> type;
+    };
+    /*! \endcond */
+
+    /*! Storage for the row offsets of the CSR data structure.
+     */
+    row_offsets_array_type row_offsets;
+
+    /*! Storage for the offset of every row block into \c column_indices.
+     */
+    block_offsets_array_type block_offsets;
+
+    /*! Storage for the column offsets relative to the diagonal.
+     */
+    column_deltas_array_type column_deltas;
+
+    /*! Storage for the column indices of blocks using full indices.
+     */
+    column_indices_array_type column_indices;
+
+    /*! Storage for the nonzero entries of the CSR data structure.
+     */
+    values_array_type values;
+
+    /*! Construct an empty \p dcsr_matrix.
+     */
+    dcsr_matrix(void) {}
+
+    /*! Construct a \p dcsr_matrix with a specific shape, number of nonzero
+     *  entries and number of entries stored with full column indices.
+     *
+     *  \param num_rows Number of rows.
+     *  \param num_cols Number of columns.
+     *  \param num_entries Number of nonzero matrix entries.
+     *  \param num_full_entries Number of entries in blocks using full indices.
+     */
+    dcsr_matrix(const size_t num_rows, const size_t num_cols, const size_t num_entries,
+                const size_t num_full_entries = 0);
+
+    /*! Construct a \p dcsr_matrix from another matrix.
+     *
+     *  \param matrix Another sparse or dense matrix.
+     */
+    template <typename MatrixType>
+    dcsr_matrix(const MatrixType& matrix);
+
+    /*! Number of row blocks in the matrix.
+     */
+    size_t num_blocks(void) const
+    {
+        return block_offsets.size() == 0 ? 0 : block_offsets.size() - 1;
+    }
+
+    /*! Resize matrix dimensions and underlying storage
+     *
+     *  \param num_rows Number of rows.
+     *  \param num_cols Number of columns.
+     *  \param num_entries Number of nonzero matrix entries.
+     *  \param num_full_entries Number of entries in blocks using full indices.
+     */
+    void resize(const size_t num_rows, const size_t num_cols, const size_t num_entries,
+                const size_t num_full_entries = 0);
+
+    /*! Swap the contents of two \p dcsr_matrix objects.
+     *
+     *  \param matrix Another \p dcsr_matrix with the same IndexType and ValueType.
+     */
+    void swap(dcsr_matrix& matrix);
+
+    /*! Assignment from another matrix.
+     *
+     *  \tparam MatrixType Format type of input matrix.
+     *
+     *  \param matrix Another sparse or dense matrix.
+     */
+    template <typename MatrixType>
+    dcsr_matrix& operator=(const MatrixType& matrix);
+}; // class dcsr_matrix
+/*! \}
+ */
+
+/*! \addtogroup sparse_matrix_views Sparse Matrix Views
+ *  \ingroup sparse_matrices
+ *  \{
+ */
+
+/**
+ * \brief View of a \p dcsr_matrix
+ *
+ * \tparam ArrayType1 Type of \c row_offsets array view
+ * \tparam ArrayType2 Type of \c block_offsets array view
+ * \tparam ArrayType3 Type of \c column_deltas array view
+ * \tparam ArrayType4 Type of \c column_indices array view
+ * \tparam ArrayType5 Type of \c values array view
+ * \tparam IndexType Type used for matrix indices (e.g. \c int).
+ * \tparam ValueType Type used for matrix values (e.g. \c float).
+ * \tparam MemorySpace A memory space (e.g. \c cusp::host_memory or \c cusp::device_memory)
+ */
+template <typename ArrayType1,
+          typename ArrayType2,
+          typename ArrayType3,
+          typename ArrayType4,
+          typename ArrayType5,
+          typename IndexType   = typename ArrayType1::value_type,
+          typename ValueType   = typename ArrayType5::value_type,
+          typename MemorySpace = typename cusp::minimum_space<
+                                    typename ArrayType1::memory_space,
+                                    typename ArrayType3::memory_space,
+                                    typename ArrayType5::memory_space>::type >
+class dcsr_matrix_view : public cusp::detail::matrix_base<IndexType,ValueType,MemorySpace,cusp::dcsr_format>
+{
+private:
+
+    typedef cusp::detail::matrix_base<IndexType,ValueType,MemorySpace,cusp::dcsr_format> Parent;
+
+public:
+
+    /*! \cond */
+    typedef ArrayType1 row_offsets_array_type;
+    typedef ArrayType2 block_offsets_array_type;
+    typedef ArrayType3 column_deltas_array_type;
+    typedef ArrayType4 column_indices_array_type;
+    typedef ArrayType5 values_array_type;
+
+    typedef typename cusp::dcsr_matrix<IndexType, ValueType, MemorySpace> container;
+    typedef typename cusp::dcsr_matrix_view<ArrayType1, ArrayType2, ArrayType3, ArrayType4, ArrayType5, IndexType, ValueType, MemorySpace> view;
+    typedef typename cusp::dcsr_matrix_view<ArrayType1, ArrayType2, ArrayType3, ArrayType4, ArrayType5, IndexType, ValueType, MemorySpace> const_view;
+    /*! \endcond */
+
+    /**
+     * Type used to store the column offsets relative to the diagonal.
+     */
+    typedef typename container::delta_type delta_type;
+
+    /**
+     * Number of consecutive rows sharing the same index representation.
+     */
+    const static size_t rows_per_block = container::rows_per_block;
+
+    /**
+     * Largest distance from the diagonal representable by a \c delta_type.
+     */
+    const static IndexType max_delta = container::max_delta;
+
+    /**
+     * View of the row offsets of the DCSR data structure.
+     */
+    row_offsets_array_type row_offsets;
+
+    /**
+     * View of the block offsets of the DCSR data structure.
+     */
+    block_offsets_array_type block_offsets;
+
+    /**
+     * View of the column deltas of the DCSR data structure.
+     */
+    column_deltas_array_type column_deltas;
+
+    /**
+     * View of the full column indices of the DCSR data structure.
+     */
+    column_indices_array_type column_indices;
+
+    /**
+     * View for the nonzero entries of the DCSR data structure.
+     */
+    values_array_type values;
+
+    /**
+     * Construct an empty \p dcsr_matrix_view.
+     */
+    dcsr_matrix_view(void)
+        : Parent() {}
+
+    /*! Construct a \p dcsr_matrix_view with a specific shape and number of nonzero entries
+     *  from existing arrays denoting the row offsets, block offsets, column deltas,
+     *  full column indices and values.
+     *
+     *  \param num_rows Number of rows.
+     *  \param num_cols Number of columns.
+     *  \param num_entries Number of nonzero matrix entries.
+     *  \param row_offsets Array containing the row offsets.
+     *  \param block_offsets Array containing the block offsets.
+     *  \param column_deltas Array containing the column deltas.
+     *  \param column_indices Array containing the full column indices.
+     *  \param values Array containing the values.
+     */
+    dcsr_matrix_view(const size_t num_rows,
+                     const size_t num_cols,
+                     const size_t num_entries,
+                     ArrayType1 row_offsets,
+                     ArrayType2 block_offsets,
+                     ArrayType3 column_deltas,
+                     ArrayType4 column_indices,
+                     ArrayType5 values)
+        : Parent(num_rows, num_cols, num_entries),
+          row_offsets(row_offsets),
+          block_offsets(block_offsets),
+          column_deltas(column_deltas),
+          column_indices(column_indices),
+          values(values) {}
+
+    /*! Construct a \p dcsr_matrix_view from a existing \p dcsr_matrix.
+     *
+     *  \param matrix \p dcsr_matrix used to create view.
+     */
+    dcsr_matrix_view(dcsr_matrix<IndexType,ValueType,MemorySpace>& matrix)
+        : Parent(matrix),
+          row_offsets(matrix.row_offsets),
+          block_offsets(matrix.block_offsets),
+          column_deltas(matrix.column_deltas),
+          column_indices(matrix.column_indices),
+          values(matrix.values) {}
+
+    /*! Construct a \p dcsr_matrix_view from a existing const \p dcsr_matrix.
+     *
+     *  \param matrix \p dcsr_matrix used to create view.
+     */
+    dcsr_matrix_view(const dcsr_matrix<IndexType,ValueType,MemorySpace>& matrix)
+        : Parent(matrix),
+          row_offsets(matrix.row_offsets),
+          block_offsets(matrix.block_offsets),
+          column_deltas(matrix.column_deltas),
+          column_indices(matrix.column_indices),
+          values(matrix.values) {}
+
+    /*! Construct a \p dcsr_matrix_view from a existing \p dcsr_matrix_view.
+     *
+     *  \param matrix \p dcsr_matrix_view used to create view.
+     */
+    dcsr_matrix_view(dcsr_matrix_view& matrix)
+        : Parent(matrix),
+          row_offsets(matrix.row_offsets),
+          block_offsets(matrix.block_offsets),
+          column_deltas(matrix.column_deltas),
+          column_indices(matrix.column_indices),
+          values(matrix.values) {}
+
+    /*! Construct a \p dcsr_matrix_view from a existing const \p dcsr_matrix_view.
+     *
+     *  \param matrix \p dcsr_matrix_view used to create view.
+     */
+    dcsr_matrix_view(const dcsr_matrix_view& matrix)
+        : Parent(matrix),
+          row_offsets(matrix.row_offsets),
+          block_offsets(matrix.block_offsets),
+          column_deltas(matrix.column_deltas),
+          column_indices(matrix.column_indices),
+          values(matrix.values) {}
+
+    /*! Number of row blocks in the matrix.
+     */
+    size_t num_blocks(void) const
+    {
+        return block_offsets.size() == 0 ? 0 : block_offsets.size() - 1;
+    }
+
+    /*! Resize matrix dimensions and underlying storage
+     *
+     *  \param num_rows Number of rows.
+     *  \param num_cols Number of columns.
+     *  \param num_entries Number of nonzero matrix entries.
+     *  \param num_full_entries Number of entries in blocks using full indices.
+     */
+    void resize(const size_t num_rows, const size_t num_cols, const size_t num_entries,
+                const size_t num_full_entries = 0);
+};
+
+/**
+ *  This is a convenience function for generating an \p dcsr_matrix_view
+ *  using an existing \p dcsr_matrix.
+ *
+ *  \tparam IndexType  indices type
+ *  \tparam ValueType  values type
+ *  \tparam MemorySpace memory space of the arrays
+ *
+ *  \param m Exemplar \p dcsr_matrix matrix to copy.
+ *
+ *  \return \p dcsr_matrix_view constructed using input arrays.
+ */
+template <typename IndexType, typename ValueType, class MemorySpace>
+typename dcsr_matrix<IndexType,ValueType,MemorySpace>::view
+make_dcsr_matrix_view(dcsr_matrix<IndexType,ValueType,MemorySpace>& m)
+{
+    return typename dcsr_matrix<IndexType,ValueType,MemorySpace>::view(m);
+}
+
+/**
+ *  This is a convenience function for generating an \p dcsr_matrix_view
+ *  using an existing const \p dcsr_matrix.
+ *
+ *  \tparam IndexType  indices type
+ *  \tparam ValueType  values type
+ *  \tparam MemorySpace memory space of the arrays
+ *
+ *  \param m Exemplar \p dcsr_matrix matrix to copy.
+ *
+ *  \return constant \p dcsr_matrix_view constructed using input arrays.
+ */
+template <typename IndexType, typename ValueType, class MemorySpace>
+typename dcsr_matrix<IndexType,ValueType,MemorySpace>::const_view
+make_dcsr_matrix_view(const dcsr_matrix<IndexType,ValueType,MemorySpace>& m)
+{
+    return typename dcsr_matrix<IndexType,ValueType,MemorySpace>::const_view(m);
+}
+/*! \}
+ */
+
+} // end namespace cusp
+
+#include <cusp/detail/dcsr_matrix.inl>
@@ -0,0 +1,77 @@
+/*
+ *  Copyright 2008-2014 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+
+/*! \file analyze.inl
+ *  \brief Inline file for analyze.h.
+ */
+
+#include <cusp/detail/config.h>
+
+#include <cusp/system/detail/adl/analyze.h>
+#include <cusp/system/detail/generic/analyze.h>
+
+#include <thrust/system/detail/generic/select_system.h>
+
+namespace cusp
+{
+
+template <typename DerivedPolicy,
+          typename MatrixType>
+cusp::matrix_profile
+analyze(const thrust::detail::execution_policy_base<DerivedPolicy>& exec,
+        const MatrixType& A)
+{
+    using cusp::system::detail::generic::analyze;
+
+    return analyze(thrust::detail::derived_cast(thrust::detail::strip_const(exec)), A);
+}
+
+template <typename MatrixType>
+cusp::matrix_profile
+analyze(const MatrixType& A)
+{
+    using thrust::system::detail::generic::select_system;
+
+    typedef typename MatrixType::memory_space System;
+
+    System system;
+
+    return cusp::analyze(select_system(system), A);
+}
+
+template <typename DerivedPolicy>
+cusp::matrix_storage
+predict_storage(const thrust::detail::execution_policy_base<DerivedPolicy>& exec,
+                const cusp::matrix_profile& profile)
+{
+    using cusp::system::detail::generic::predict_storage;
+
+    return predict_storage(thrust::detail::derived_cast(thrust::detail::strip_const(exec)), profile);
+}
+
+template <typename MemorySpace>
+cusp::matrix_storage
+predict_storage(const cusp::matrix_profile& profile)
+{
+    using thrust::system::detail::generic::select_system;
+
+    MemorySpace system;
+
+    return cusp::predict_storage(select_system(system), profile);
+}
+
+} // end namespace cusp
@@ -45,6 +45,28 @@ array1d<T,MemorySpace>
     return const_view(Parent::begin() + start_index, Parent::begin() + start_index + num_entries);
 } // end array1d::subarray
 
+template<typename T, typename MemorySpace>
+void
+array1d<T,MemorySpace>
+::resize(size_type new_size, cusp::no_init_t)
+{
+    if (new_size <= Parent::capacity())
+    {
+        // the storage past the current size is left as it is
+        Parent::m_size = new_size;
+    }
+    else
+    {
+        array1d temp;
+        temp.m_storage.allocate(new_size);
+        temp.m_size = new_size;
+
+        thrust::copy(Parent::begin(), Parent::end(), temp.begin());
+
+        Parent::swap(temp);
+    }
+} // end array1d::resize
+
 template<typename RandomAccessIterator>
 array1d_view<RandomAccessIterator>&
 array1d_view<RandomAccessIterator>
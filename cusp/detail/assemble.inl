@@ -0,0 +1,119 @@
+/*
+ *  Copyright 2008-2014 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*! \file assemble.inl
+ *  \brief Inline file for assemble.h.
+ */
+
+#include <cusp/detail/config.h>
+
+#include <cusp/system/detail/adl/assemble.h>
+#include <cusp/system/detail/generic/assemble.h>
+
+#include <thrust/system/detail/generic/select_system.h>
+
+namespace cusp
+{
+
+template <typename DerivedPolicy,
+          typename ArrayType1,
+          typename ArrayType2,
+          typename ArrayType3,
+          typename MatrixType>
+void assemble(const thrust::detail::execution_policy_base<DerivedPolicy>& exec,
+              const size_t num_rows,
+              const size_t num_cols,
+              const ArrayType1& row_indices,
+              const ArrayType2& column_indices,
+              const ArrayType3& values,
+                    MatrixType& A)
+{
+    using cusp::system::detail::generic::assemble;
+
+    return assemble(thrust::detail::derived_cast(thrust::detail::strip_const(exec)),
+                    num_rows, num_cols, row_indices, column_indices, values, A);
+}
+
+template <typename ArrayType1,
+          typename ArrayType2,
+          typename ArrayType3,
+          typename MatrixType>
+void assemble(const size_t num_rows,
+              const size_t num_cols,
+              const ArrayType1& row_indices,
+              const ArrayType2& column_indices,
+              const ArrayType3& values,
+                    MatrixType& A)
+{
+    using thrust::system::detail::generic::select_system;
+
+    typedef typename ArrayType1::memory_space System1;
+    typedef typename ArrayType2::memory_space System2;
+    typedef typename ArrayType3::memory_space System3;
+    typedef typename MatrixType::memory_space System4;
+
+    System1 system1;
+    System2 system2;
+    System3 system3;
+    System4 system4;
+
+    return cusp::assemble(select_system(system1,system2,system3,system4),
+                          num_rows, num_cols, row_indices, column_indices, values, A);
+}
+
+template <typename DerivedPolicy,
+          typename ArrayType1,
+          typename ArrayType2,
+          typename ArrayType3,
+          typename MatrixType>
+void assemble_values(const thrust::detail::execution_policy_base<DerivedPolicy>& exec,
+                     const ArrayType1& row_indices,
+                     const ArrayType2& column_indices,
+                     const ArrayType3& values,
+                           MatrixType& A)
+{
+    using cusp::system::detail::generic::assemble_values;
+
+    return assemble_values(thrust::detail::derived_cast(thrust::detail::strip_const(exec)),
+                           row_indices, column_indices, values, A);
+}
+
+template <typename ArrayType1,
+          typename ArrayType2,
+          typename ArrayType3,
+          typename MatrixType>
+void assemble_values(const ArrayType1& row_indices,
+                     const ArrayType2& column_indices,
+                     const ArrayType3& values,
+                           MatrixType& A)
+{
+    using thrust::system::detail::generic::select_system;
+
+    typedef typename ArrayType1::memory_space System1;
+    typedef typename ArrayType2::memory_space System2;
+    typedef typename ArrayType3::memory_space System3;
+    typedef typename MatrixType::memory_space System4;
+
+    System1 system1;
+    System2 system2;
+    System3 system3;
+    System4 system4;
+
+    return cusp::assemble_values(select_system(system1,system2,system3,system4),
+                                 row_indices, column_indices, values, A);
+}
+
+} // end namespace cusp
@@ -0,0 +1,318 @@
+/*
+ *  Copyright 2008-2014 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include <cusp/detail/config.h>
+
+#include <cusp/convert.h>
+#include <cusp/exception.h>
+#include <cusp/memory.h>
+#include <cusp/multiply.h>
+#include <cusp/transpose.h>
+
+#include <thrust/system/detail/generic/select_system.h>
+
+#if THRUST_DEVICE_SYSTEM == THRUST_DEVICE_SYSTEM_CUDA
+#include <cusp/execution_policy.h>
+
+#include <cuda_runtime_api.h>
+
+#include <string>
+#endif
+
+namespace cusp
+{
+namespace detail
+{
+
+#if THRUST_DEVICE_SYSTEM == THRUST_DEVICE_SYSTEM_CUDA
+
+inline void check_completion_error(const cudaError_t error, const char* operation)
+{
+    if (error != cudaSuccess)
+        throw cusp::runtime_exception(std::string("completion_event: ") + operation +
+                                      " failed: " + cudaGetErrorString(error));
+}
+
+// event shared by the copies of a completion_event
+class completion_state
+{
+public:
+
+    int ref_count;
+
+    explicit completion_state(cudaStream_t s)
+        : ref_count(1), event(0)
+    {
+        check_completion_error(cudaEventCreateWithFlags(&event, cudaEventDisableTiming),
+                               "cudaEventCreate");
+
+        const cudaError_t error = cudaEventRecord(event, s);
+
+        if (error != cudaSuccess)
+        {
+            cudaEventDestroy(event);
+            check_completion_error(error, "cudaEventRecord");
+        }
+    }
+
+    ~completion_state(void)
+    {
+        cudaEventDestroy(event);
+    }
+
+    bool ready(void) const
+    {
+        const cudaError_t error = cudaEventQuery(event);
+
+        if (error == cudaErrorNotReady)
+            return false;
+
+        check_completion_error(error, "cudaEventQuery");
+
+        return true;
+    }
+
+    void wait(void) const
+    {
+        check_completion_error(cudaEventSynchronize(event), "cudaEventSynchronize");
+    }
+
+private:
+
+    cudaEvent_t event;
+
+    // completion_state is shared through completion_event only
+    completion_state(const completion_state&);
+    completion_state& operator=(const completion_state&);
+};
+
+// the work of a CUDA policy completes with its stream
+template <typename DerivedPolicy>
+completion_event record_completion(thrust::system::cuda::detail::execution_policy<DerivedPolicy>& exec)
+{
+    return completion_event(new completion_state(stream(thrust::detail::derived_cast(exec))));
+}
+
+#else
+
+// without a CUDA device system all work completes before returning
+class completion_state
+{
+public:
+
+    int ref_count;
+
+    bool ready(void) const
+    {
+        return true;
+    }
+
+    void wait(void) const {}
+};
+
+#endif
+
+// host policies finish their work before returning
+template <typename DerivedPolicy>
+completion_event record_completion(thrust::execution_policy<DerivedPolicy>& exec)
+{
+    return completion_event();
+}
+
+#if __cplusplus >= 201103L
+
+#if THRUST_DEVICE_SYSTEM == THRUST_DEVICE_SYSTEM_CUDA
+// non-blocking stream owned by a thread of solve_async
+class solve_stream
+{
+public:
+
+    cudaStream_t s;
+
+    solve_stream(void)
+    {
+        check_completion_error(cudaStreamCreateWithFlags(&s, cudaStreamNonBlocking),
+                               "cudaStreamCreate");
+    }
+
+    ~solve_stream(void)
+    {
+        cudaStreamSynchronize(s);
+        cudaStreamDestroy(s);
+    }
+
+private:
+
+    solve_stream(const solve_stream&);
+    solve_stream& operator=(const solve_stream&);
+};
+
+template <typename Solver, typename LinearOperator, typename VectorType1,
+          typename VectorType2, typename Monitor, typename Preconditioner>
+void solve_task(Solver& solver, const LinearOperator& A, VectorType1& x, const VectorType2& b,
+                Monitor& monitor, Preconditioner& M, cusp::device_memory)
+{
+    solve_stream stream;
+
+    solver.solve(cusp::cuda::par.on(stream.s), A, x, b, monitor, M);
+
+    check_completion_error(cudaStreamSynchronize(stream.s), "cudaStreamSynchronize");
+}
+#endif
+
+template <typename Solver, typename LinearOperator, typename VectorType1,
+          typename VectorType2, typename Monitor, typename Preconditioner, typename MemorySpace>
+void solve_task(Solver& solver, const LinearOperator& A, VectorType1& x, const VectorType2& b,
+                Monitor& monitor, Preconditioner& M, MemorySpace)
+{
+    solver.solve(A, x, b, monitor, M);
+}
+
+#endif
+
+} // end namespace detail
+
+inline completion_event::completion_event(void)
+    : state(0) {}
+
+inline completion_event::completion_event(detail::completion_state* state)
+    : state(state) {}
+
+inline completion_event::completion_event(const completion_event& other)
+    : state(other.state)
+{
+    if (state != 0)
+        state->ref_count++;
+}
+
+inline completion_event& completion_event::operator=(const completion_event& other)
+{
+    if (other.state != 0)
+        other.state->ref_count++;
+
+    release();
+    state = other.state;
+
+    return *this;
+}
+
+inline completion_event::~completion_event(void)
+{
+    release();
+}
+
+inline bool completion_event::ready(void) const
+{
+    return state == 0 || state->ready();
+}
+
+inline void completion_event::wait(void) const
+{
+    if (state != 0)
+        state->wait();
+}
+
+inline void completion_event::release(void)
+{
+    if (state != 0 && --state->ref_count == 0)
+        delete state;
+
+    state = 0;
+}
+
+template <typename DerivedPolicy,
+          typename LinearOperator,
+          typename MatrixOrVector1,
+          typename MatrixOrVector2>
+completion_event multiply_async(const thrust::detail::execution_policy_base<DerivedPolicy>& exec,
+                                const LinearOperator&  A,
+                                const MatrixOrVector1& B,
+                                      MatrixOrVector2& C)
+{
+    cusp::multiply(exec, A, B, C);
+
+    return detail::record_completion(thrust::detail::derived_cast(thrust::detail::strip_const(exec)));
+}
+
+template <typename LinearOperator,
+          typename MatrixOrVector1,
+          typename MatrixOrVector2>
+completion_event multiply_async(const LinearOperator&  A,
+                                const MatrixOrVector1& B,
+                                      MatrixOrVector2& C)
+{
+    using thrust::system::detail::generic::select_system;
+
+    typedef typename LinearOperator::memory_space  System1;
+    typedef typename MatrixOrVector1::memory_space System2;
+    typedef typename MatrixOrVector2::memory_space System3;
+
+    System1 system1;
+    System2 system2;
+    System3 system3;
+
+    return cusp::multiply_async(select_system(system1,system2,system3), A, B, C);
+}
+
+template <typename DerivedPolicy,
+          typename SourceType,
+          typename DestinationType>
+completion_event convert_async(const thrust::detail::execution_policy_base<DerivedPolicy>& exec,
+                               const SourceType& src,
+                                     DestinationType& dst)
+{
+    cusp::convert(exec, src, dst);
+
+    return detail::record_completion(thrust::detail::derived_cast(thrust::detail::strip_const(exec)));
+}
+
+template <typename DerivedPolicy,
+          typename MatrixType1,
+          typename MatrixType2>
+completion_event transpose_async(const thrust::detail::execution_policy_base<DerivedPolicy>& exec,
+                                 const MatrixType1& A,
+                                       MatrixType2& At)
+{
+    cusp::transpose(exec, A, At);
+
+    return detail::record_completion(thrust::detail::derived_cast(thrust::detail::strip_const(exec)));
+}
+
+#if __cplusplus >= 201103L
+template <typename Solver,
+          typename LinearOperator,
+          typename VectorType1,
+          typename VectorType2,
+          typename Monitor,
+          typename Preconditioner>
+std::future<void> solve_async(Solver& solver,
+                              const LinearOperator& A,
+                                    VectorType1& x,
+                              const VectorType2& b,
+                                    Monitor& monitor,
+                                    Preconditioner& M)
+{
+    typedef typename VectorType1::memory_space MemorySpace;
+
+    return std::async(std::launch::async,
+                      [&solver, &A, &x, &b, &monitor, &M]()
+                      {
+                          detail::solve_task(solver, A, x, b, monitor, M, MemorySpace());
+                      });
+}
+#endif
+
+} // end namespace cusp
@@ -0,0 +1,399 @@
+/*
+ *  Copyright 2008-2014 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+
+#include <cusp/detail/config.h>
+
+#include <cusp/array1d.h>
+#include <cusp/convert.h>
+#include <cusp/exception.h>
+#include <cusp/memory.h>
+
+#include <thrust/detail/type_traits.h>
+
+#if THRUST_DEVICE_SYSTEM == THRUST_DEVICE_SYSTEM_CUDA
+#include <cuda_runtime_api.h>
+
+#include <algorithm>
+#include <cstring>
+#include <string>
+#include <vector>
+#endif
+
+namespace cusp
+{
+namespace detail
+{
+
+#if THRUST_DEVICE_SYSTEM == THRUST_DEVICE_SYSTEM_CUDA
+
+inline void check_upload_error(const cudaError_t error, const char* operation)
+{
+    if (error != cudaSuccess)
+        throw cusp::runtime_exception(std::string("async_upload: ") + operation +
+                                      " failed: " + cudaGetErrorString(error));
+}
+
+// stream and ring of pinned staging buffers shared by the copies of an
+// upload_event, the stream is a blocking one so that the transfer is
+// ordered after the resize of the destination and before later work on
+// the default stream
+class upload_stream
+{
+public:
+
+    int ref_count;
+
+    upload_stream(const size_t chunk_bytes, const size_t num_buffers)
+        : ref_count(1), stream(0), chunk_bytes(std::max(chunk_bytes, size_t(1))), next(0)
+    {
+        try
+        {
+            check_upload_error(cudaStreamCreate(&stream), "cudaStreamCreate");
+
+            for (size_t i = 0; i < std::max(num_buffers, size_t(1)); i++)
+            {
+                void* buffer = 0;
+                check_upload_error(cudaHostAlloc(&buffer, this->chunk_bytes, cudaHostAllocDefault),
+                                   "cudaHostAlloc");
+                buffers.push_back(static_cast<char*>(buffer));
+
+                cudaEvent_t event;
+                check_upload_error(cudaEventCreateWithFlags(&event, cudaEventDisableTiming),
+                                   "cudaEventCreate");
+                events.push_back(event);
+            }
+        }
+        catch (...)
+        {
+            release();
+            throw;
+        }
+    }
+
+    ~upload_stream(void)
+    {
+        if (stream != 0)
+            cudaStreamSynchronize(stream);
+
+        release();
+    }
+
+    // the host fills one buffer while the device drains the others, a
+    // buffer is reused once the copy recorded by its event completed
+    void copy(const void* src, void* dst, const size_t num_bytes)
+    {
+        const char* src_bytes = static_cast<const char*>(src);
+        char* dst_bytes = static_cast<char*>(dst);
+
+        for (size_t offset = 0; offset < num_bytes; offset += chunk_bytes, next++)
+        {
+            const size_t slot = next % buffers.size();
+            const size_t length = std::min(chunk_bytes, num_bytes - offset);
+
+            check_upload_error(cudaEventSynchronize(events[slot]), "cudaEventSynchronize");
+
+            std::memcpy(buffers[slot], src_bytes + offset, length);
+
+            check_upload_error(cudaMemcpyAsync(dst_bytes + offset, buffers[slot], length,
+                                               cudaMemcpyHostToDevice, stream),
+                               "cudaMemcpyAsync");
+            check_upload_error(cudaEventRecord(events[slot], stream), "cudaEventRecord");
+        }
+    }
+
+    bool ready(void) const
+    {
+        const cudaError_t error = cudaStreamQuery(stream);
+
+        if (error == cudaErrorNotReady)
+            return false;
+
+        check_upload_error(error, "cudaStreamQuery");
+
+        return true;
+    }
+
+    void wait(void) const
+    {
+        check_upload_error(cudaStreamSynchronize(stream), "cudaStreamSynchronize");
+    }
+
+private:
+
+    cudaStream_t stream;
+    std::vector<char*> buffers;
+    std::vector<cudaEvent_t> events;
+    size_t chunk_bytes;
+    size_t next;
+
+    void release(void)
+    {
+        for (size_t i = 0; i < events.size(); i++)
+            cudaEventDestroy(events[i]);
+
+        for (size_t i = 0; i < buffers.size(); i++)
+            cudaFreeHost(buffers[i]);
+
+        if (stream != 0)
+            cudaStreamDestroy(stream);
+
+        events.clear();
+        buffers.clear();
+        stream = 0;
+    }
+
+    // upload_stream is shared through upload_event only
+    upload_stream(const upload_stream&);
+    upload_stream& operator=(const upload_stream&);
+};
+
+template <typename Array1, typename Array2>
+void stage_array(upload_stream& stream, const Array1& src, Array2& dst, thrust::detail::true_type)
+{
+    typedef typename Array2::value_type ValueType;
+
+    if (src.size() == 0)
+        return;
+
+    stream.copy(thrust::raw_pointer_cast(&src[0]),
+                thrust::raw_pointer_cast(&dst[0]),
+                src.size() * sizeof(ValueType));
+}
+
+template <typename Array1, typename Array2>
+void stage_array(upload_stream& stream, const Array1& src, Array2& dst, thrust::detail::false_type)
+{
+    typedef typename Array2::value_type ValueType;
+
+    // convert the elements on the host, the temporary is consumed before
+    // stage_array returns
+    cusp::array1d<ValueType, cusp::host_memory> tmp(src);
+
+    stage_array(stream, tmp, dst, thrust::detail::true_type());
+}
+
+template <typename Array1, typename Array2>
+void stage_array(upload_stream& stream, const Array1& src, Array2& dst)
+{
+    typedef typename Array1::value_type ValueType1;
+    typedef typename Array2::value_type ValueType2;
+
+    stage_array(stream, src, dst,
+                typename thrust::detail::is_same<ValueType1, ValueType2>::type());
+}
+
+template <typename Matrix1, typename Matrix2>
+void stage_matrix(upload_stream& stream, const Matrix1& src, Matrix2& dst, cusp::array1d_format)
+{
+    dst.resize(src.size());
+
+    stage_array(stream, src, dst);
+}
+
+template <typename Matrix1, typename Matrix2>
+void stage_matrix(upload_stream& stream, const Matrix1& src, Matrix2& dst, cusp::coo_format)
+{
+    dst.resize(src.num_rows, src.num_cols, src.num_entries);
+
+    stage_array(stream, src.row_indices,    dst.row_indices);
+    stage_array(stream, src.column_indices, dst.column_indices);
+    stage_array(stream, src.values,         dst.values);
+}
+
+template <typename Matrix1, typename Matrix2>
+void stage_matrix(upload_stream& stream, const Matrix1& src, Matrix2& dst, cusp::csr_format)
+{
+    dst.resize(src.num_rows, src.num_cols, src.num_entries);
+
+    stage_array(stream, src.row_offsets,    dst.row_offsets);
+    stage_array(stream, src.column_indices, dst.column_indices);
+    stage_array(stream, src.values,         dst.values);
+}
+
+// the padded arrays are copied as they are, which requires dst to use
+// the pitch of src
+template <typename Matrix1, typename Matrix2>
+void stage_matrix(upload_stream& stream, const Matrix1& src, Matrix2& dst, cusp::ell_format)
+{
+    const size_t num_entries_per_row = src.column_indices.num_cols;
+
+    dst.resize(src.num_rows, src.num_cols, src.num_entries, num_entries_per_row);
+    dst.column_indices.resize(src.num_rows, num_entries_per_row, src.column_indices.pitch);
+    dst.values.resize(src.num_rows, num_entries_per_row, src.values.pitch);
+
+    stage_array(stream, src.column_indices.values, dst.column_indices.values);
+    stage_array(stream, src.values.values,         dst.values.values);
+}
+
+template <typename Matrix1, typename Matrix2>
+void stage_matrix(upload_stream& stream, const Matrix1& src, Matrix2& dst, cusp::dia_format)
+{
+    const size_t num_diagonals = src.diagonal_offsets.size();
+
+    dst.resize(src.num_rows, src.num_cols, src.num_entries, num_diagonals);
+    dst.values.resize(src.num_rows, num_diagonals, src.values.pitch);
+
+    stage_array(stream, src.diagonal_offsets, dst.diagonal_offsets);
+    stage_array(stream, src.values.values,    dst.values.values);
+}
+
+template <typename Matrix1, typename Matrix2>
+void stage_matrix(upload_stream& stream, const Matrix1& src, Matrix2& dst, cusp::hyb_format)
+{
+    dst.resize(src.num_rows, src.num_cols,
+               src.ell.num_entries, src.coo.num_entries,
+               src.ell.column_indices.num_cols);
+
+    stage_matrix(stream, src.ell, dst.ell, cusp::ell_format());
+    stage_matrix(stream, src.coo, dst.coo, cusp::coo_format());
+}
+
+template <typename Matrix1, typename Matrix2>
+upload_event async_upload(const Matrix1& src, Matrix2& dst,
+                          const size_t chunk_bytes, const size_t num_buffers,
+                          thrust::detail::true_type)
+{
+    typedef typename Matrix2::format Format;
+
+    upload_event event(new upload_stream(chunk_bytes, num_buffers));
+
+    stage_matrix(*event.stream_handle(), src, dst, Format());
+
+    return event;
+}
+
+template <typename Matrix1, typename Matrix2>
+upload_event async_upload(const Matrix1& src, Matrix2& dst,
+                          const size_t chunk_bytes, const size_t num_buffers,
+                          thrust::detail::false_type)
+{
+    typedef typename Matrix2::template rebind<cusp::host_memory>::type HostMatrix;
+
+    // stage_matrix reads every host array before returning, so the
+    // temporary may be destroyed while the transfer is pending
+    HostMatrix tmp(src);
+
+    return async_upload(tmp, dst, chunk_bytes, num_buffers, thrust::detail::true_type());
+}
+
+template <typename Matrix1, typename Matrix2>
+upload_event async_upload(const Matrix1& src, Matrix2& dst,
+                          const size_t chunk_bytes, const size_t num_buffers,
+                          cusp::device_memory)
+{
+    typedef typename thrust::detail::is_same<typename Matrix1::format,
+                                             typename Matrix2::format>::type SameFormat;
+    typedef typename thrust::detail::is_convertible<typename Matrix1::memory_space,
+                                                    cusp::host_memory>::type InHostMemory;
+
+    return async_upload(src, dst, chunk_bytes, num_buffers,
+                        typename thrust::detail::and_<SameFormat, InHostMemory>::type());
+}
+
+#else
+
+// without a CUDA device system there are no transfers to overlap
+class upload_stream
+{
+public:
+
+    int ref_count;
+
+    bool ready(void) const
+    {
+        return true;
+    }
+
+    void wait(void) const {}
+};
+
+#endif
+
+template <typename Matrix1, typename Matrix2, typename MemorySpace>
+upload_event async_upload(const Matrix1& src, Matrix2& dst,
+                          const size_t chunk_bytes, const size_t num_buffers,
+                          MemorySpace)
+{
+    cusp::convert(src, dst);
+
+    return upload_event();
+}
+
+} // end namespace detail
+
+inline upload_event::upload_event(void)
+    : stream(0) {}
+
+inline upload_event::upload_event(detail::upload_stream* stream)
+    : stream(stream) {}
+
+inline upload_event::upload_event(const upload_event& other)
+    : stream(other.stream)
+{
+    if (stream != 0)
+        stream->ref_count++;
+}
+
+inline upload_event& upload_event::operator=(const upload_event& other)
+{
+    if (other.stream != 0)
+        other.stream->ref_count++;
+
+    release();
+    stream = other.stream;
+
+    return *this;
+}
+
+inline upload_event::~upload_event(void)
+{
+    release();
+}
+
+inline bool upload_event::ready(void) const
+{
+    return stream == 0 || stream->ready();
+}
+
+inline void upload_event::wait(void) const
+{
+    if (stream != 0)
+        stream->wait();
+}
+
+inline detail::upload_stream* upload_event::stream_handle(void) const
+{
+    return stream;
+}
+
+inline void upload_event::release(void)
+{
+    if (stream != 0 && --stream->ref_count == 0)
+        delete stream;
+
+    stream = 0;
+}
+
+template <typename MatrixType1, typename MatrixType2>
+upload_event async_upload(const MatrixType1& src, MatrixType2& dst,
+                          const size_t chunk_bytes, const size_t num_buffers)
+{
+    return detail::async_upload(src, dst, chunk_bytes, num_buffers,
+                                typename MatrixType2::memory_space());
+}
+
+} // end namespace cusp
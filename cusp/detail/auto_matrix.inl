@@ -0,0 +1,170 @@
+/*
+ *  Copyright 2008-2014 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+
+#include <cusp/array1d.h>
+#include <cusp/convert.h>
+#include <cusp/exception.h>
+#include <cusp/multiply.h>
+
+#include <cusp/detail/timer.h>
+
+namespace cusp
+{
+
+//////////////////////
+// Member Functions //
+//////////////////////
+
+template <typename IndexType, typename ValueType, class MemorySpace>
+template <typename MatrixType>
+void
+auto_matrix<IndexType,ValueType,MemorySpace>
+::assign(const MatrixType& A, bool timed_trial)
+{
+    release();
+
+    csr_matrix_type A_csr(A);
+
+    profile = cusp::analyze(A_csr);
+    storage = timed_trial ? fastest_storage(A_csr) : cusp::predict_storage<MemorySpace>(profile);
+
+    store(A_csr, storage);
+
+    Parent::resize(A_csr.num_rows, A_csr.num_cols, A_csr.num_entries);
+}
+
+template <typename IndexType, typename ValueType, class MemorySpace>
+template <typename DerivedPolicy, typename VectorType1, typename VectorType2>
+void
+auto_matrix<IndexType,ValueType,MemorySpace>
+::operator()(thrust::execution_policy<DerivedPolicy>& exec, const VectorType1& x, VectorType2& y) const
+{
+    switch(storage)
+    {
+    case cusp::coo_storage: cusp::multiply(exec, coo, x, y); break;
+    case cusp::csr_storage: cusp::multiply(exec, csr, x, y); break;
+    case cusp::dia_storage: cusp::multiply(exec, dia, x, y); break;
+    case cusp::ell_storage: cusp::multiply(exec, ell, x, y); break;
+    case cusp::hyb_storage: cusp::multiply(exec, hyb, x, y); break;
+    }
+}
+
+template <typename IndexType, typename ValueType, class MemorySpace>
+template <typename VectorType1, typename VectorType2>
+void
+auto_matrix<IndexType,ValueType,MemorySpace>
+::operator()(const VectorType1& x, VectorType2& y) const
+{
+    switch(storage)
+    {
+    case cusp::coo_storage: cusp::multiply(coo, x, y); break;
+    case cusp::csr_storage: cusp::multiply(csr, x, y); break;
+    case cusp::dia_storage: cusp::multiply(dia, x, y); break;
+    case cusp::ell_storage: cusp::multiply(ell, x, y); break;
+    case cusp::hyb_storage: cusp::multiply(hyb, x, y); break;
+    }
+}
+
+template <typename IndexType, typename ValueType, class MemorySpace>
+void
+auto_matrix<IndexType,ValueType,MemorySpace>
+::release(void)
+{
+    coo = coo_matrix_type();
+    csr = csr_matrix_type();
+    dia = dia_matrix_type();
+    ell = ell_matrix_type();
+    hyb = hyb_matrix_type();
+}
+
+template <typename IndexType, typename ValueType, class MemorySpace>
+void
+auto_matrix<IndexType,ValueType,MemorySpace>
+::store(const csr_matrix_type& A, cusp::matrix_storage format)
+{
+    switch(format)
+    {
+    case cusp::coo_storage: cusp::convert(A, coo); break;
+    case cusp::csr_storage: csr = A;               break;
+    case cusp::dia_storage: cusp::convert(A, dia); break;
+    case cusp::ell_storage: cusp::convert(A, ell); break;
+    case cusp::hyb_storage: cusp::convert(A, hyb); break;
+    }
+}
+
+template <typename IndexType, typename ValueType, class MemorySpace>
+cusp::matrix_storage
+auto_matrix<IndexType,ValueType,MemorySpace>
+::fastest_storage(const csr_matrix_type& A)
+{
+    // formats storing more padding than this are never competitive and
+    // may not fit in memory
+    const double max_fill   = 3.0;
+    const int    num_trials = 5;
+
+    const cusp::matrix_storage candidates[] =
+        { cusp::coo_storage, cusp::csr_storage, cusp::dia_storage, cusp::ell_storage, cusp::hyb_storage };
+
+    cusp::array1d<ValueType,MemorySpace> x(A.num_cols, ValueType(1));
+    cusp::array1d<ValueType,MemorySpace> y(A.num_rows);
+
+    cusp::matrix_storage fastest = cusp::predict_storage<MemorySpace>(profile);
+    double fastest_time = -1.0;
+
+    for(size_t i = 0; i < sizeof(candidates) / sizeof(candidates[0]); i++)
+    {
+        if(candidates[i] == cusp::dia_storage && profile.dia_fill_ratio > max_fill)
+            continue;
+
+        if(candidates[i] == cusp::ell_storage && profile.ell_fill_ratio > max_fill)
+            continue;
+
+        try
+        {
+            store(A, candidates[i]);
+        }
+        catch(const cusp::format_conversion_exception&)
+        {
+            release();
+            continue;
+        }
+
+        storage = candidates[i];
+
+        // warm up before timing
+        (*this)(x, y);
+
+        cusp::detail::timer t;
+
+        for(int trial = 0; trial < num_trials; trial++)
+            (*this)(x, y);
+
+        const double elapsed = t.seconds_elapsed();
+
+        if(fastest_time < 0.0 || elapsed < fastest_time)
+        {
+            fastest      = candidates[i];
+            fastest_time = elapsed;
+        }
+
+        release();
+    }
+
+    return fastest;
+}
+
+} // end namespace cusp
@@ -91,6 +91,24 @@ void axpy(const thrust::detail::execution_policy_base<DerivedPolicy>& exec,
     return axpy(thrust::detail::derived_cast(thrust::detail::strip_const(exec)), x, y, alpha);
 }
 
+template <typename DerivedPolicy,
+          typename ArrayType1,
+          typename ArrayType2,
+          typename ScalarType,
+          typename MemorySpace>
+void axpy(const thrust::detail::execution_policy_base<DerivedPolicy> &exec,
+          const ArrayType1& x,
+                ArrayType2& y,
+          const cusp::array1d<ScalarType,MemorySpace>& alpha)
+{
+    using cusp::system::detail::generic::blas::axpy_indirect;
+
+    if(alpha.empty())
+        throw cusp::invalid_input_exception("scale factor array is empty");
+
+    return axpy_indirect(thrust::detail::derived_cast(thrust::detail::strip_const(exec)), x, y, alpha);
+}
+
 template <typename ArrayType1,
           typename ArrayType2,
           typename ScalarType>
@@ -222,6 +240,104 @@ void axpbypcz(const ArrayType1& x,
     return cusp::blas::axpbypcz(select_system(system1,system2,system3,system4), x, y, z, output, alpha, beta, gamma);
 }
 
+template <typename DerivedPolicy,
+          typename ArrayType1,
+          typename ArrayType2,
+          typename ArrayType3,
+          typename ArrayType4,
+          typename ScalarType1,
+          typename ScalarType2>
+void axpy_axpy(const thrust::detail::execution_policy_base<DerivedPolicy> &exec,
+               const ArrayType1& x1,
+                     ArrayType2& y1,
+               const ScalarType1 alpha1,
+               const ArrayType3& x2,
+                     ArrayType4& y2,
+               const ScalarType2 alpha2)
+{
+    using cusp::system::detail::generic::blas::axpy_axpy;
+
+    return axpy_axpy(thrust::detail::derived_cast(thrust::detail::strip_const(exec)), x1, y1, alpha1, x2, y2, alpha2);
+}
+
+template <typename ArrayType1,
+          typename ArrayType2,
+          typename ArrayType3,
+          typename ArrayType4,
+          typename ScalarType1,
+          typename ScalarType2>
+void axpy_axpy(const ArrayType1& x1,
+                     ArrayType2& y1,
+               const ScalarType1 alpha1,
+               const ArrayType3& x2,
+                     ArrayType4& y2,
+               const ScalarType2 alpha2)
+{
+    using thrust::system::detail::generic::select_system;
+
+    typedef typename ArrayType1::memory_space System1;
+    typedef typename ArrayType2::memory_space System2;
+    typedef typename ArrayType3::memory_space System3;
+    typedef typename ArrayType4::memory_space System4;
+
+    System1 system1;
+    System2 system2;
+    System3 system3;
+    System4 system4;
+
+    return cusp::blas::axpy_axpy(select_system(system1,system2,system3,system4), x1, y1, alpha1, x2, y2, alpha2);
+}
+
+template <typename DerivedPolicy,
+          typename ArrayType1,
+          typename ArrayType2,
+          typename ArrayType3,
+          typename ArrayType4,
+          typename ScalarType1,
+          typename ScalarType2>
+typename ArrayType4::value_type
+axpy_axpy_dotc(const thrust::detail::execution_policy_base<DerivedPolicy> &exec,
+               const ArrayType1& x1,
+                     ArrayType2& y1,
+               const ScalarType1 alpha1,
+               const ArrayType3& x2,
+                     ArrayType4& y2,
+               const ScalarType2 alpha2)
+{
+    using cusp::system::detail::generic::blas::axpy_axpy_dotc;
+
+    return axpy_axpy_dotc(thrust::detail::derived_cast(thrust::detail::strip_const(exec)), x1, y1, alpha1, x2, y2, alpha2);
+}
+
+template <typename ArrayType1,
+          typename ArrayType2,
+          typename ArrayType3,
+          typename ArrayType4,
+          typename ScalarType1,
+          typename ScalarType2>
+typename ArrayType4::value_type
+axpy_axpy_dotc(const ArrayType1& x1,
+                     ArrayType2& y1,
+               const ScalarType1 alpha1,
+               const ArrayType3& x2,
+                     ArrayType4& y2,
+               const ScalarType2 alpha2)
+{
+    using thrust::system::detail::generic::select_system;
+
+    typedef typename ArrayType1::memory_space System1;
+    typedef typename ArrayType2::memory_space System2;
+    typedef typename ArrayType3::memory_space System3;
+    typedef typename ArrayType4::memory_space System4;
+
+    System1 system1;
+    System2 system2;
+    System3 system3;
+    System4 system4;
+
+    return cusp::blas::axpy_axpy_dotc(select_system(system1,system2,system3,system4), x1, y1, alpha1, x2, y2, alpha2);
+}
+
 template <typename DerivedPolicy,
           typename ArrayType1,
           typename ArrayType2,
@@ -373,6 +489,165 @@ dotc(const ArrayType1& x,
     return cusp::blas::dotc(select_system(system1,system2), x, y);
 }
 
+template <typename DerivedPolicy,
+          typename ArrayType1,
+          typename Array2dType,
+          typename ArrayType2>
+void dots(const thrust::detail::execution_policy_base<DerivedPolicy> &exec,
+          const ArrayType1& x,
+          const Array2dType& Y,
+                ArrayType2& results)
+{
+    using cusp::system::detail::generic::blas::dots;
+
+    return dots(thrust::detail::derived_cast(thrust::detail::strip_const(exec)), x, Y, results);
+}
+
+template <typename ArrayType1,
+          typename Array2dType,
+          typename ArrayType2>
+void dots(const ArrayType1& x,
+          const Array2dType& Y,
+                ArrayType2& results)
+{
+    using thrust::system::detail::generic::select_system;
+
+    typedef typename ArrayType1::memory_space  System1;
+    typedef typename Array2dType::memory_space System2;
+
+    System1 system1;
+    System2 system2;
+
+    return cusp::blas::dots(select_system(system1,system2), x, Y, results);
+}
+
+template <typename DerivedPolicy,
+          typename ArrayType1,
+          typename Array2dType,
+          typename ArrayType2>
+void dotcs(const thrust::detail::execution_policy_base<DerivedPolicy> &exec,
+           const ArrayType1& x,
+           const Array2dType& Y,
+                 ArrayType2& results)
+{
+    using cusp::system::detail::generic::blas::dotcs;
+
+    return dotcs(thrust::detail::derived_cast(thrust::detail::strip_const(exec)), x, Y, results);
+}
+
+template <typename ArrayType1,
+          typename Array2dType,
+          typename ArrayType2>
+void dotcs(const ArrayType1& x,
+           const Array2dType& Y,
+                 ArrayType2& results)
+{
+    using thrust::system::detail::generic::select_system;
+
+    typedef typename ArrayType1::memory_space  System1;
+    typedef typename Array2dType::memory_space System2;
+
+    System1 system1;
+    System2 system2;
+
+    return cusp::blas::dotcs(select_system(system1,system2), x, Y, results);
+}
+
+template <typename DerivedPolicy,
+          typename ArrayType1,
+          typename ArrayType2>
+thrust::tuple<typename ArrayType1::value_type,
+              typename cusp::norm_type<typename ArrayType1::value_type>::type>
+dotc_nrm2(const thrust::detail::execution_policy_base<DerivedPolicy> &exec,
+          const ArrayType1& x,
+          const ArrayType2& y)
+{
+    using cusp::system::detail::generic::blas::dotc_nrm2;
+
+    return dotc_nrm2(thrust::detail::derived_cast(thrust::detail::strip_const(exec)), x, y);
+}
+
+template <typename ArrayType1,
+          typename ArrayType2>
+thrust::tuple<typename ArrayType1::value_type,
+              typename cusp::norm_type<typename ArrayType1::value_type>::type>
+dotc_nrm2(const ArrayType1& x,
+          const ArrayType2& y)
+{
+    using thrust::system::detail::generic::select_system;
+
+    typedef typename ArrayType1::memory_space System1;
+    typedef typename ArrayType2::memory_space System2;
+
+    System1 system1;
+    System2 system2;
+
+    return cusp::blas::dotc_nrm2(select_system(system1,system2), x, y);
+}
+
+template <typename DerivedPolicy,
+          typename ArrayType>
+void allreduce(const thrust::detail::execution_policy_base<DerivedPolicy> &exec,
+                     ArrayType& values)
+{
+    using cusp::system::detail::generic::blas::allreduce;
+
+    allreduce(thrust::detail::derived_cast(thrust::detail::strip_const(exec)), values);
+}
+
+template <typename DerivedPolicy,
+          typename ValueType>
+void allreduce_begin(thrust::detail::execution_policy_base<DerivedPolicy> &exec,
+                     ValueType* values,
+                     const size_t n)
+{
+    using cusp::system::detail::generic::blas::allreduce_begin;
+
+    allreduce_begin(thrust::detail::derived_cast(exec), values, n);
+}
+
+template <typename DerivedPolicy>
+void allreduce_end(thrust::detail::execution_policy_base<DerivedPolicy> &exec)
+{
+    using cusp::system::detail::generic::blas::allreduce_end;
+
+    allreduce_end(thrust::detail::derived_cast(exec));
+}
+
+template <typename DerivedPolicy,
+          typename ArrayType1,
+          typename ArrayType2,
+          typename ArrayType3>
+void dot(const thrust::detail::execution_policy_base<DerivedPolicy> &exec,
+         const ArrayType1& x,
+         const ArrayType2& y,
+               ArrayType3& result)
+{
+    using cusp::system::detail::generic::blas::dot;
+
+    if(result.empty())
+        result.resize(1);
+
+    return dot(thrust::detail::derived_cast(thrust::detail::strip_const(exec)), x, y, result);
+}
+
+template <typename DerivedPolicy,
+          typename ArrayType1,
+          typename ArrayType2,
+          typename ArrayType3>
+void dotc(const thrust::detail::execution_policy_base<DerivedPolicy> &exec,
+          const ArrayType1& x,
+          const ArrayType2& y,
+                ArrayType3& result)
+{
+    using cusp::system::detail::generic::blas::dotc;
+
+    if(result.empty())
+        result.resize(1);
+
+    return dotc(thrust::detail::derived_cast(thrust::detail::strip_const(exec)), x, y, result);
+}
+
 template <typename DerivedPolicy,
           typename ArrayType,
           typename ScalarType>
@@ -461,6 +736,21 @@ nrm2(const ArrayType& x)
     return cusp::blas::nrm2(select_system(system), x);
 }
 
+template <typename DerivedPolicy,
+          typename ArrayType1,
+          typename ArrayType2>
+void nrm2(const thrust::detail::execution_policy_base<DerivedPolicy> &exec,
+          const ArrayType1& x,
+                ArrayType2& result)
+{
+    using cusp::system::detail::generic::blas::nrm2;
+
+    if(result.empty())
+        result.resize(1);
+
+    return nrm2(thrust::detail::derived_cast(thrust::detail::strip_const(exec)), x, result);
+}
+
 template <typename DerivedPolicy,
           typename ArrayType>
 typename cusp::norm_type<typename ArrayType::value_type>::type
@@ -497,6 +787,22 @@ void scal(const thrust::detail::execution_policy_base<DerivedPolicy> &exec,
     return scal(thrust::detail::derived_cast(thrust::detail::strip_const(exec)), x, alpha);
 }
 
+template <typename DerivedPolicy,
+          typename ArrayType,
+          typename ScalarType,
+          typename MemorySpace>
+void scal(const thrust::detail::execution_policy_base<DerivedPolicy> &exec,
+                ArrayType& x,
+          const cusp::array1d<ScalarType,MemorySpace>& alpha)
+{
+    using cusp::system::detail::generic::blas::scal_indirect;
+
+    if(alpha.empty())
+        throw cusp::invalid_input_exception("scale factor array is empty");
+
+    return scal_indirect(thrust::detail::derived_cast(thrust::detail::strip_const(exec)), x, alpha);
+}
+
 template <typename ArrayType,
           typename ScalarType>
 void scal(ArrayType& x,
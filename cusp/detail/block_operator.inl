@@ -0,0 +1,178 @@
+/*
+ *  Copyright 2008-2014 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include <cusp/blas/blas.h>
+#include <cusp/exception.h>
+
+#include <vector>
+
+namespace cusp
+{
+
+template <typename ValueType, typename MemorySpace, typename IndexType>
+block_operator<ValueType,MemorySpace,IndexType>
+::block_operator(const size_t num_block_rows, const size_t num_block_cols)
+    : Parent(), blocks(num_block_rows, num_block_cols, "block_operator")
+{
+}
+
+template <typename ValueType, typename MemorySpace, typename IndexType>
+size_t
+block_operator<ValueType,MemorySpace,IndexType>
+::num_block_rows(void) const
+{
+    return blocks.num_block_rows();
+}
+
+template <typename ValueType, typename MemorySpace, typename IndexType>
+size_t
+block_operator<ValueType,MemorySpace,IndexType>
+::num_block_cols(void) const
+{
+    return blocks.num_block_cols();
+}
+
+template <typename ValueType, typename MemorySpace, typename IndexType>
+size_t
+block_operator<ValueType,MemorySpace,IndexType>
+::row_offset(const size_t i) const
+{
+    return blocks.row_offset(i);
+}
+
+template <typename ValueType, typename MemorySpace, typename IndexType>
+size_t
+block_operator<ValueType,MemorySpace,IndexType>
+::col_offset(const size_t j) const
+{
+    return blocks.col_offset(j);
+}
+
+template <typename ValueType, typename MemorySpace, typename IndexType>
+bool
+block_operator<ValueType,MemorySpace,IndexType>
+::has_block(const size_t i, const size_t j) const
+{
+    return i < num_block_rows() && j < num_block_cols() && blocks.block(i, j) != 0;
+}
+
+template <typename ValueType, typename MemorySpace, typename IndexType>
+template <typename Operator>
+void
+block_operator<ValueType,MemorySpace,IndexType>
+::set_block(const size_t i, const size_t j, const Operator& A)
+{
+    blocks.set(i, j, A);
+
+    Parent::resize(blocks.num_rows(), blocks.num_cols(), blocks.num_entries());
+}
+
+template <typename ValueType, typename MemorySpace, typename IndexType>
+template <typename VectorType1, typename VectorType2>
+void
+block_operator<ValueType,MemorySpace,IndexType>
+::operator()(const VectorType1& x, VectorType2& y) const
+{
+    typedef typename Structure::view       View;
+    typedef typename Structure::const_view ConstView;
+    typedef typename Structure::product    Product;
+
+    if (x.size() != Parent::num_cols || y.size() != Parent::num_rows)
+        throw cusp::invalid_input_exception("block_operator: vector sizes do not match the operator");
+
+    const ConstView x_view = cusp::detail::block_input<VectorType1,ConstView>(x, x_buffer);
+    View y_view = cusp::detail::block_output<VectorType2,View>(y, y_buffer);
+
+    // the first block of every block row writes y, the others a workspace
+    // segment of the same length
+    size_t workspace_size = 0;
+
+    for (size_t i = 0; i < num_block_rows(); i++)
+    {
+        bool first = true;
+
+        for (size_t j = 0; j < num_block_cols(); j++)
+        {
+            if (blocks.block(i, j) == 0)
+                continue;
+
+            if (!first)
+                workspace_size += blocks.row_size(i);
+
+            first = false;
+        }
+    }
+
+    workspace.resize(workspace_size);
+
+    std::vector<Product> products;
+    std::vector<View> partials;
+    std::vector<size_t> partial_rows;
+    std::vector<size_t> empty_rows;
+
+    size_t position = 0;
+
+    for (size_t i = 0; i < num_block_rows(); i++)
+    {
+        bool first = true;
+
+        for (size_t j = 0; j < num_block_cols(); j++)
+        {
+            if (blocks.block(i, j) == 0)
+                continue;
+
+            const ConstView x_j = blocks.col_segment(x_view, j);
+
+            if (first)
+            {
+                products.push_back(Product(blocks.block(i, j), x_j, blocks.row_segment(y_view, i)));
+            }
+            else
+            {
+                View partial(workspace.begin() + position, workspace.begin() + position + blocks.row_size(i));
+                position += blocks.row_size(i);
+
+                products.push_back(Product(blocks.block(i, j), x_j, partial));
+                partials.push_back(partial);
+                partial_rows.push_back(i);
+            }
+
+            first = false;
+        }
+
+        if (first)
+            empty_rows.push_back(i);
+    }
+
+    blocks.run(products);
+
+    for (size_t k = 0; k < partials.size(); k++)
+    {
+        View y_i = blocks.row_segment(y_view, partial_rows[k]);
+        cusp::blas::axpy(partials[k], y_i, ValueType(1));
+    }
+
+    for (size_t k = 0; k < empty_rows.size(); k++)
+    {
+        View y_i = blocks.row_segment(y_view, empty_rows[k]);
+        cusp::blas::fill(y_i, ValueType(0));
+    }
+
+    cusp::detail::block_writeback(y, y_buffer,
+        typename cusp::detail::block_output_compatible<VectorType2,View>::type());
+}
+
+} // end namespace cusp
@@ -0,0 +1,458 @@
+/*
+ *  Copyright 2008-2014 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#pragma once
+
+#include <cusp/detail/config.h>
+
+#include <cusp/array1d.h>
+#include <cusp/blas/blas.h>
+#include <cusp/exception.h>
+#include <cusp/memory.h>
+#include <cusp/multiply.h>
+
+#include <thrust/detail/type_traits.h>
+
+#if THRUST_DEVICE_SYSTEM == THRUST_DEVICE_SYSTEM_CUDA
+#include <cusp/system/cuda/detail/par.h>
+#include <cuda_runtime_api.h>
+#endif
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#include <string>
+#include <vector>
+
+namespace cusp
+{
+namespace detail
+{
+
+// products of device blocks are issued on CUDA streams, all others on the
+// threads of OpenMP when available
+#if THRUST_DEVICE_SYSTEM == THRUST_DEVICE_SYSTEM_CUDA
+template <typename MemorySpace>
+struct block_uses_streams
+    : public thrust::detail::is_convertible<MemorySpace,cusp::device_memory> {};
+
+inline void block_check_error(const cudaError_t error, const char* operation)
+{
+    if (error != cudaSuccess)
+        throw cusp::runtime_exception(std::string("block_operator: ") + operation +
+                                      " failed: " + cudaGetErrorString(error));
+}
+#else
+template <typename MemorySpace>
+struct block_uses_streams : public thrust::detail::false_type {};
+#endif
+
+// a sub-operator with its type erased, held by reference
+template <typename ValueType, typename MemorySpace>
+class block_base
+{
+  public:
+
+    typedef typename cusp::array1d<ValueType,MemorySpace>::view       view;
+    typedef typename cusp::array1d<ValueType,MemorySpace>::const_view const_view;
+
+    const size_t num_rows;
+    const size_t num_cols;
+    const size_t num_entries;
+
+    block_base(const size_t num_rows, const size_t num_cols, const size_t num_entries)
+        : num_rows(num_rows), num_cols(num_cols), num_entries(num_entries) {}
+
+    virtual ~block_base(void) {}
+
+    virtual void multiply(const const_view& x, view& y) const = 0;
+
+#if THRUST_DEVICE_SYSTEM == THRUST_DEVICE_SYSTEM_CUDA
+    virtual void multiply(cudaStream_t s, const const_view& x, view& y) const = 0;
+#endif
+};
+
+template <typename Operator, typename ValueType, typename MemorySpace>
+class block_holder : public block_base<ValueType,MemorySpace>
+{
+  private:
+
+    typedef block_base<ValueType,MemorySpace> Parent;
+
+    const Operator& A;
+
+  public:
+
+    typedef typename Parent::view       view;
+    typedef typename Parent::const_view const_view;
+
+    block_holder(const Operator& A)
+        : Parent(A.num_rows, A.num_cols, A.num_entries), A(A) {}
+
+    void multiply(const const_view& x, view& y) const
+    {
+        cusp::multiply(A, x, y);
+    }
+
+#if THRUST_DEVICE_SYSTEM == THRUST_DEVICE_SYSTEM_CUDA
+    void multiply(cudaStream_t s, const const_view& x, view& y) const
+    {
+        multiply(s, x, y, typename block_uses_streams<MemorySpace>::type());
+    }
+
+  private:
+
+    void multiply(cudaStream_t s, const const_view& x, view& y, thrust::detail::true_type) const
+    {
+        cusp::multiply(cusp::cuda::par.on(s), A, x, y);
+    }
+
+    void multiply(cudaStream_t, const const_view& x, view& y, thrust::detail::false_type) const
+    {
+        cusp::multiply(A, x, y);
+    }
+#endif
+};
+
+// Grid of sub-operators with the offsets of the block rows and columns,
+// and the machinery that runs a batch of independent block products at
+// the same time.
+//
+// On a CUDA device every product of a batch is issued on its own stream,
+// forked from and joined into the default stream with events. The streams
+// are blocking, so sub-operators that do not accept an execution policy
+// and run on the default stream are serialized but remain ordered.
+//
+// With OpenMP the products that are small relative to the batch run side
+// by side, one per thread, and the large ones follow one after the other
+// with all threads, so the dominant block keeps the parallelism of the
+// system.
+template <typename ValueType, typename MemorySpace>
+class block_structure
+{
+  public:
+
+    typedef block_base<ValueType,MemorySpace>          block_type;
+    typedef typename block_type::view                  view;
+    typedef typename block_type::const_view            const_view;
+    typedef cusp::array1d<ValueType,MemorySpace>       array_type;
+
+    struct product
+    {
+        const block_type* block;
+        const_view x;
+        view y;
+
+        product(const block_type* block, const const_view& x, const view& y)
+            : block(block), x(x), y(y) {}
+    };
+
+    block_structure(const size_t num_block_rows, const size_t num_block_cols, const char* name)
+        : name(name),
+          grid(num_block_rows * num_block_cols, (block_type*) 0),
+          row_sizes(num_block_rows, 0), col_sizes(num_block_cols, 0),
+          row_set(num_block_rows, false), col_set(num_block_cols, false)
+#if THRUST_DEVICE_SYSTEM == THRUST_DEVICE_SYSTEM_CUDA
+          , fork_event(0)
+#endif
+    {
+        if (num_block_rows == 0 || num_block_cols == 0)
+            throw cusp::invalid_input_exception(std::string(name) + ": the number of blocks must be positive");
+    }
+
+    ~block_structure(void)
+    {
+        for (size_t k = 0; k < grid.size(); k++)
+            delete grid[k];
+
+        release_streams();
+    }
+
+    size_t num_block_rows(void) const { return row_sizes.size(); }
+    size_t num_block_cols(void) const { return col_sizes.size(); }
+
+    size_t num_rows(void) const { return offset(row_sizes, row_sizes.size()); }
+    size_t num_cols(void) const { return offset(col_sizes, col_sizes.size()); }
+
+    size_t row_offset(const size_t i) const { return offset(row_sizes, i); }
+    size_t col_offset(const size_t j) const { return offset(col_sizes, j); }
+
+    size_t row_size(const size_t i) const { return row_sizes[i]; }
+    size_t col_size(const size_t j) const { return col_sizes[j]; }
+
+    size_t num_entries(void) const
+    {
+        size_t total = 0;
+
+        for (size_t k = 0; k < grid.size(); k++)
+            if (grid[k])
+                total += grid[k]->num_entries;
+
+        return total;
+    }
+
+    const block_type* block(const size_t i, const size_t j) const
+    {
+        return grid[i * num_block_cols() + j];
+    }
+
+    // the first block of a block row or column fixes its size
+    template <typename Operator>
+    void set(const size_t i, const size_t j, const Operator& A)
+    {
+        if (i >= num_block_rows() || j >= num_block_cols())
+            throw cusp::invalid_input_exception(std::string(name) + ": block index out of range");
+
+        if ((row_set[i] && row_sizes[i] != size_t(A.num_rows)) ||
+            (col_set[j] && col_sizes[j] != size_t(A.num_cols)))
+            throw cusp::invalid_input_exception(std::string(name) + ": block shape does not match its block row or column");
+
+        block_type* holder = new block_holder<Operator,ValueType,MemorySpace>(A);
+
+        delete grid[i * num_block_cols() + j];
+        grid[i * num_block_cols() + j] = holder;
+
+        row_sizes[i] = A.num_rows;
+        col_sizes[j] = A.num_cols;
+        row_set[i] = true;
+        col_set[j] = true;
+    }
+
+    // segment of a vector covering block row i or block column j
+    template <typename ViewType>
+    ViewType row_segment(const ViewType& v, const size_t i) const
+    {
+        return ViewType(v.begin() + row_offset(i), v.begin() + row_offset(i) + row_sizes[i]);
+    }
+
+    template <typename ViewType>
+    ViewType col_segment(const ViewType& v, const size_t j) const
+    {
+        return ViewType(v.begin() + col_offset(j), v.begin() + col_offset(j) + col_sizes[j]);
+    }
+
+    // run the products, which must write disjoint outputs, and wait for all
+    void run(const std::vector<product>& products) const
+    {
+        if (products.size() == 1)
+        {
+            view y(products[0].y);
+            products[0].block->multiply(products[0].x, y);
+        }
+        else if (products.size() > 1)
+            run(products, typename block_uses_streams<MemorySpace>::type());
+    }
+
+  private:
+
+    const char* name;
+
+    std::vector<block_type*> grid;
+    std::vector<size_t> row_sizes;
+    std::vector<size_t> col_sizes;
+    std::vector<bool>   row_set;
+    std::vector<bool>   col_set;
+
+    static size_t offset(const std::vector<size_t>& sizes, const size_t n)
+    {
+        size_t total = 0;
+
+        for (size_t k = 0; k < n; k++)
+            total += sizes[k];
+
+        return total;
+    }
+
+    void run(const std::vector<product>& products, thrust::detail::false_type) const
+    {
+        const int num_products = products.size();
+
+#ifdef _OPENMP
+        const int num_threads = omp_get_max_threads();
+
+        size_t total = 0;
+        for (int k = 0; k < num_products; k++)
+            total += products[k].block->num_entries;
+
+        std::vector<int> concurrent, sequential;
+        for (int k = 0; k < num_products; k++)
+        {
+            if (num_threads > 1 && products[k].block->num_entries * num_threads < total)
+                concurrent.push_back(k);
+            else
+                sequential.push_back(k);
+        }
+
+        const int num_concurrent = concurrent.size();
+
+        #pragma omp parallel for schedule(dynamic, 1) if(num_concurrent > 1)
+        for (int k = 0; k < num_concurrent; k++)
+        {
+            const product& p = products[concurrent[k]];
+            view y(p.y);
+            p.block->multiply(p.x, y);
+        }
+
+        for (size_t k = 0; k < sequential.size(); k++)
+        {
+            const product& p = products[sequential[k]];
+            view y(p.y);
+            p.block->multiply(p.x, y);
+        }
+#else
+        for (int k = 0; k < num_products; k++)
+        {
+            view y(products[k].y);
+            products[k].block->multiply(products[k].x, y);
+        }
+#endif
+    }
+
+#if THRUST_DEVICE_SYSTEM == THRUST_DEVICE_SYSTEM_CUDA
+    mutable std::vector<cudaStream_t> streams;
+    mutable std::vector<cudaEvent_t>  join_events;
+    mutable cudaEvent_t               fork_event;
+
+    // the streams are created on first use and kept for later products
+    void reserve_streams(const size_t n) const
+    {
+        if (fork_event == 0)
+            block_check_error(cudaEventCreateWithFlags(&fork_event, cudaEventDisableTiming), "cudaEventCreate");
+
+        while (streams.size() < n)
+        {
+            cudaStream_t s;
+            cudaEvent_t  e;
+
+            block_check_error(cudaStreamCreate(&s), "cudaStreamCreate");
+            streams.push_back(s);
+
+            block_check_error(cudaEventCreateWithFlags(&e, cudaEventDisableTiming), "cudaEventCreate");
+            join_events.push_back(e);
+        }
+    }
+
+    void release_streams(void)
+    {
+        for (size_t k = 0; k < streams.size(); k++)
+        {
+            cudaStreamSynchronize(streams[k]);
+            cudaStreamDestroy(streams[k]);
+        }
+
+        for (size_t k = 0; k < join_events.size(); k++)
+            cudaEventDestroy(join_events[k]);
+
+        if (fork_event)
+            cudaEventDestroy(fork_event);
+
+        streams.clear();
+        join_events.clear();
+        fork_event = 0;
+    }
+
+    void run(const std::vector<product>& products, thrust::detail::true_type) const
+    {
+        const size_t num_products = products.size();
+
+        reserve_streams(num_products);
+
+        block_check_error(cudaEventRecord(fork_event, 0), "cudaEventRecord");
+
+        for (size_t k = 0; k < num_products; k++)
+        {
+            block_check_error(cudaStreamWaitEvent(streams[k], fork_event, 0), "cudaStreamWaitEvent");
+
+            view y(products[k].y);
+            products[k].block->multiply(streams[k], products[k].x, y);
+
+            block_check_error(cudaEventRecord(join_events[k], streams[k]), "cudaEventRecord");
+        }
+
+        for (size_t k = 0; k < num_products; k++)
+            block_check_error(cudaStreamWaitEvent(0, join_events[k], 0), "cudaStreamWaitEvent");
+    }
+#else
+    void release_streams(void) {}
+#endif
+
+    block_structure(const block_structure&);
+    block_structure& operator=(const block_structure&);
+};
+
+// vectors whose iterators convert to the views of the memory space are
+// used in place, others are staged through a buffer
+template <typename VectorType, typename ConstViewType>
+struct block_input_compatible
+    : public thrust::detail::is_convertible<typename VectorType::const_iterator, typename ConstViewType::iterator> {};
+
+template <typename VectorType, typename ViewType>
+struct block_output_compatible
+    : public thrust::detail::is_convertible<typename VectorType::iterator, typename ViewType::iterator> {};
+
+template <typename VectorType, typename ConstViewType, typename ArrayType>
+ConstViewType block_input(const VectorType& x, ArrayType&, thrust::detail::true_type)
+{
+    return ConstViewType(x.begin(), x.end());
+}
+
+template <typename VectorType, typename ConstViewType, typename ArrayType>
+ConstViewType block_input(const VectorType& x, ArrayType& buffer, thrust::detail::false_type)
+{
+    buffer.resize(x.size());
+    cusp::blas::copy(x, buffer);
+    return ConstViewType(buffer.begin(), buffer.end());
+}
+
+template <typename VectorType, typename ConstViewType, typename ArrayType>
+ConstViewType block_input(const VectorType& x, ArrayType& buffer)
+{
+    return block_input<VectorType,ConstViewType>(x, buffer,
+           typename block_input_compatible<VectorType,ConstViewType>::type());
+}
+
+template <typename VectorType, typename ViewType, typename ArrayType>
+ViewType block_output(VectorType& y, ArrayType&, thrust::detail::true_type)
+{
+    return ViewType(y.begin(), y.end());
+}
+
+template <typename VectorType, typename ViewType, typename ArrayType>
+ViewType block_output(VectorType& y, ArrayType& buffer, thrust::detail::false_type)
+{
+    buffer.resize(y.size());
+    return ViewType(buffer.begin(), buffer.end());
+}
+
+template <typename VectorType, typename ViewType, typename ArrayType>
+ViewType block_output(VectorType& y, ArrayType& buffer)
+{
+    return block_output<VectorType,ViewType>(y, buffer,
+           typename block_output_compatible<VectorType,ViewType>::type());
+}
+
+template <typename VectorType, typename ArrayType>
+void block_writeback(VectorType&, const ArrayType&, thrust::detail::true_type) {}
+
+template <typename VectorType, typename ArrayType>
+void block_writeback(VectorType& y, const ArrayType& buffer, thrust::detail::false_type)
+{
+    cusp::blas::copy(buffer, y);
+}
+
+} // end namespace detail
+} // end namespace cusp
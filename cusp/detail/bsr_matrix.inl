@@ -0,0 +1,103 @@
+/*
+ *  Copyright 2008-2014 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include <thrust/swap.h>
+
+namespace cusp
+{
+
+// Forward definitions
+template <typename T1, typename T2> void convert(const T1&, T2&);
+
+//////////////////
+// Constructors //
+//////////////////
+
+template <typename IndexType, typename ValueType, class MemorySpace, size_t BlockRows, size_t BlockCols>
+bsr_matrix<IndexType,ValueType,MemorySpace,BlockRows,BlockCols>
+::bsr_matrix(const size_t num_rows, const size_t num_cols, const size_t num_blocks)
+    : Parent(num_rows, num_cols, num_blocks * BlockRows * BlockCols),
+      row_offsets(num_rows / BlockRows + 1),
+      column_indices(num_blocks),
+      values(num_blocks * BlockRows * BlockCols) {}
+
+// construct from a different matrix
+template <typename IndexType, typename ValueType, class MemorySpace, size_t BlockRows, size_t BlockCols>
+template <typename MatrixType>
+bsr_matrix<IndexType,ValueType,MemorySpace,BlockRows,BlockCols>
+::bsr_matrix(const MatrixType& matrix)
+{
+    cusp::convert(matrix, *this);
+}
+
+//////////////////////
+// Member Functions //
+//////////////////////
+
+template <typename IndexType, typename ValueType, class MemorySpace, size_t BlockRows, size_t BlockCols>
+void
+bsr_matrix<IndexType,ValueType,MemorySpace,BlockRows,BlockCols>
+::resize(const size_t num_rows, const size_t num_cols, const size_t num_blocks)
+{
+    Parent::resize(num_rows, num_cols, num_blocks * BlockRows * BlockCols);
+    row_offsets.resize(num_rows / BlockRows + 1);
+    column_indices.resize(num_blocks);
+    values.resize(num_blocks * BlockRows * BlockCols);
+}
+
+template <typename IndexType, typename ValueType, class MemorySpace, size_t BlockRows, size_t BlockCols>
+void
+bsr_matrix<IndexType,ValueType,MemorySpace,BlockRows,BlockCols>
+::swap(bsr_matrix& matrix)
+{
+    Parent::swap(matrix);
+    row_offsets.swap(matrix.row_offsets);
+    column_indices.swap(matrix.column_indices);
+    values.swap(matrix.values);
+}
+
+// assignment from another matrix
+template <typename IndexType, typename ValueType, class MemorySpace, size_t BlockRows, size_t BlockCols>
+template <typename MatrixType>
+bsr_matrix<IndexType,ValueType,MemorySpace,BlockRows,BlockCols>&
+bsr_matrix<IndexType,ValueType,MemorySpace,BlockRows,BlockCols>
+::operator=(const MatrixType& matrix)
+{
+    cusp::convert(matrix, *this);
+
+    return *this;
+}
+
+///////////////////////////
+// View Member Functions //
+///////////////////////////
+
+template <typename ArrayType1, typename ArrayType2, typename ArrayType3,
+          typename IndexType, typename ValueType, typename MemorySpace,
+          size_t BlockRows, size_t BlockCols>
+void
+bsr_matrix_view<ArrayType1,ArrayType2,ArrayType3,IndexType,ValueType,MemorySpace,BlockRows,BlockCols>
+::resize(const size_t num_rows, const size_t num_cols, const size_t num_blocks)
+{
+    Parent::resize(num_rows, num_cols, num_blocks * BlockRows * BlockCols);
+    row_offsets.resize(num_rows / BlockRows + 1);
+    column_indices.resize(num_blocks);
+    values.resize(num_blocks * BlockRows * BlockCols);
+}
+
+} // end namespace cusp
+
+#include <cusp/convert.h>
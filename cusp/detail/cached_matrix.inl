@@ -0,0 +1,164 @@
+/*
+ *  Copyright 2008-2014 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+
+#include <cusp/convert.h>
+#include <cusp/copy.h>
+#include <cusp/exception.h>
+#include <cusp/multiply.h>
+#include <cusp/transpose.h>
+
+namespace cusp
+{
+
+//////////////////////
+// Member Functions //
+//////////////////////
+
+template <typename IndexType, typename ValueType, class MemorySpace>
+template <typename MatrixType>
+void
+cached_matrix<IndexType,ValueType,MemorySpace>
+::assign(const MatrixType& A)
+{
+    // release the cached formats before converting
+    ell = ell_matrix_type();
+    hyb = hyb_matrix_type();
+    csr_transpose = csr_matrix_type();
+
+    cusp::convert(A, csr);
+
+    invalidate();
+}
+
+template <typename IndexType, typename ValueType, class MemorySpace>
+template <typename ArrayType>
+void
+cached_matrix<IndexType,ValueType,MemorySpace>
+::update_values(const ArrayType& values)
+{
+    if(values.size() != csr.values.size())
+        throw cusp::invalid_input_exception("number of values does not match the number of entries");
+
+    cusp::copy(values, csr.values);
+
+    // the structure is unchanged, only the copies are stale
+    format_valid    = false;
+    transpose_valid = false;
+}
+
+template <typename IndexType, typename ValueType, class MemorySpace>
+void
+cached_matrix<IndexType,ValueType,MemorySpace>
+::invalidate(void)
+{
+    format_valid          = false;
+    format_rejected       = false;
+    transpose_valid       = false;
+    num_applies           = 0;
+    num_transpose_applies = 0;
+
+    profile = cusp::analyze(csr);
+    storage = cusp::predict_storage<MemorySpace>(profile);
+
+    // only the padded formats are worth a second copy of the matrix
+    if(storage != cusp::ell_storage && storage != cusp::hyb_storage)
+        storage = cusp::csr_storage;
+
+    Parent::resize(csr.num_rows, csr.num_cols, csr.num_entries);
+}
+
+template <typename IndexType, typename ValueType, class MemorySpace>
+bool
+cached_matrix<IndexType,ValueType,MemorySpace>
+::prepare_format(void) const
+{
+    if(storage == cusp::csr_storage || format_rejected)
+        return false;
+
+    if(format_valid)
+        return true;
+
+    if(++num_applies < reuse_threshold)
+        return false;
+
+    try
+    {
+        if(storage == cusp::ell_storage)
+            cusp::convert(csr, ell);
+        else
+            cusp::convert(csr, hyb);
+    }
+    catch(const cusp::format_conversion_exception&)
+    {
+        // keep multiplying with CSR when the fill-in is too large
+        format_rejected = true;
+        ell = ell_matrix_type();
+        return false;
+    }
+
+    format_valid = true;
+
+    return true;
+}
+
+template <typename IndexType, typename ValueType, class MemorySpace>
+template <typename DerivedPolicy, typename VectorType1, typename VectorType2>
+void
+cached_matrix<IndexType,ValueType,MemorySpace>
+::operator()(thrust::execution_policy<DerivedPolicy>& exec, const VectorType1& x, VectorType2& y) const
+{
+    if(!prepare_format())
+        cusp::multiply(exec, csr, x, y);
+    else if(storage == cusp::ell_storage)
+        cusp::multiply(exec, ell, x, y);
+    else
+        cusp::multiply(exec, hyb, x, y);
+}
+
+template <typename IndexType, typename ValueType, class MemorySpace>
+template <typename VectorType1, typename VectorType2>
+void
+cached_matrix<IndexType,ValueType,MemorySpace>
+::operator()(const VectorType1& x, VectorType2& y) const
+{
+    if(!prepare_format())
+        cusp::multiply(csr, x, y);
+    else if(storage == cusp::ell_storage)
+        cusp::multiply(ell, x, y);
+    else
+        cusp::multiply(hyb, x, y);
+}
+
+template <typename IndexType, typename ValueType, class MemorySpace>
+template <typename DerivedPolicy, typename VectorType1, typename VectorType2>
+void
+cached_matrix<IndexType,ValueType,MemorySpace>
+::apply_transpose(thrust::execution_policy<DerivedPolicy>& exec, const VectorType1& x, VectorType2& y) const
+{
+    if(!transpose_valid && ++num_transpose_applies >= reuse_threshold)
+    {
+        cusp::transpose(csr, csr_transpose);
+        transpose_valid = true;
+    }
+
+    if(transpose_valid)
+        cusp::multiply(exec, csr_transpose, x, y);
+    else
+        cusp::multiply_transpose(exec, csr, x, y);
+}
+
+} // end namespace cusp
@@ -0,0 +1,176 @@
+/*
+ *  Copyright 2008-2014 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include <cusp/exception.h>
+
+#include <thrust/memory.h>
+
+#include <algorithm>
+#include <iostream>
+#include <new>
+
+namespace cusp
+{
+
+template <typename MemorySpace>
+caching_allocator<MemorySpace>
+::~caching_allocator(void)
+{
+    release();
+
+    // blocks still in use are owned by the allocator as well
+    for (typename allocated_blocks_type::iterator i = allocated_blocks.begin(); i != allocated_blocks.end(); ++i)
+        system_deallocate(i->first);
+}
+
+template <typename MemorySpace>
+size_t
+caching_allocator<MemorySpace>
+::bin_size(size_t num_bytes)
+{
+    size_t size = 256;
+
+    while (size < num_bytes)
+        size *= 2;
+
+    return size;
+}
+
+template <typename MemorySpace>
+char*
+caching_allocator<MemorySpace>
+::system_allocate(size_t num_bytes)
+{
+    MemorySpace system;
+
+    char* ptr = NULL;
+
+    try
+    {
+        ptr = thrust::raw_pointer_cast(thrust::malloc<char>(system, num_bytes));
+    }
+    catch (std::bad_alloc&)
+    {
+        // return the cached blocks to the system and retry once
+        release();
+
+        ptr = thrust::raw_pointer_cast(thrust::malloc<char>(system, num_bytes));
+    }
+
+    return ptr;
+}
+
+template <typename MemorySpace>
+void
+caching_allocator<MemorySpace>
+::system_deallocate(char* ptr)
+{
+    MemorySpace system;
+
+    thrust::free(system, ptr);
+
+    stats.system_deallocations++;
+}
+
+template <typename MemorySpace>
+char*
+caching_allocator<MemorySpace>
+::allocate(std::ptrdiff_t num_bytes)
+{
+    const size_t size = bin_size(num_bytes);
+
+    char* ptr = NULL;
+
+    typename free_blocks_type::iterator block = free_blocks.find(size);
+
+    if (block != free_blocks.end())
+    {
+        ptr = block->second;
+        free_blocks.erase(block);
+
+        stats.cache_hits++;
+        stats.bytes_cached -= size;
+    }
+    else
+    {
+        ptr = system_allocate(size);
+
+        stats.cache_misses++;
+    }
+
+    allocated_blocks.insert(std::make_pair(ptr, size));
+
+    stats.bytes_in_use += size;
+    stats.peak_bytes    = std::max(stats.peak_bytes, stats.bytes_in_use + stats.bytes_cached);
+
+    return ptr;
+}
+
+template <typename MemorySpace>
+void
+caching_allocator<MemorySpace>
+::deallocate(char* ptr, size_t)
+{
+    typename allocated_blocks_type::iterator block = allocated_blocks.find(ptr);
+
+    if (block == allocated_blocks.end())
+        throw cusp::invalid_input_exception("caching_allocator: pointer was not allocated by this allocator");
+
+    const size_t size = block->second;
+
+    allocated_blocks.erase(block);
+    free_blocks.insert(std::make_pair(size, ptr));
+
+    stats.bytes_in_use -= size;
+    stats.bytes_cached += size;
+}
+
+template <typename MemorySpace>
+void
+caching_allocator<MemorySpace>
+::release(void)
+{
+    for (typename free_blocks_type::iterator i = free_blocks.begin(); i != free_blocks.end(); ++i)
+        system_deallocate(i->second);
+
+    free_blocks.clear();
+
+    stats.bytes_cached = 0;
+}
+
+template <typename MemorySpace>
+const typename caching_allocator<MemorySpace>::statistics_type&
+caching_allocator<MemorySpace>
+::statistics(void) const
+{
+    return stats;
+}
+
+template <typename MemorySpace>
+void
+caching_allocator<MemorySpace>
+::print(void) const
+{
+    std::cout << "caching_allocator: "
+              << stats.cache_hits << " cache hits, "
+              << stats.cache_misses << " cache misses, "
+              << stats.system_deallocations << " system deallocations" << std::endl;
+    std::cout << "  bytes in use : " << stats.bytes_in_use << std::endl;
+    std::cout << "  bytes cached : " << stats.bytes_cached << std::endl;
+    std::cout << "  peak bytes   : " << stats.peak_bytes << std::endl;
+}
+
+} // end namespace cusp
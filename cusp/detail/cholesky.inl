@@ -0,0 +1,533 @@
+/*
+ *  Copyright 2008-2014 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+
+#include <cusp/exception.h>
+#include <cusp/permutation_matrix.h>
+#include <cusp/transpose.h>
+
+#include <cusp/detail/num_bytes.h>
+#include <cusp/graph/symmetric_rcm.h>
+
+#include <thrust/gather.h>
+
+#include <algorithm>
+
+namespace cusp
+{
+
+//////////////////
+// Constructors //
+//////////////////
+
+template <typename ValueType, typename MemorySpace, typename IndexType>
+template <typename MatrixType>
+cholesky_solver<ValueType,MemorySpace,IndexType>
+::cholesky_solver(const MatrixType& A, const cholesky_ordering ordering)
+    : ordering(ordering)
+{
+    factor(A, ordering);
+}
+
+template <typename ValueType, typename MemorySpace, typename IndexType>
+template <typename MemorySpace2>
+cholesky_solver<ValueType,MemorySpace,IndexType>
+::cholesky_solver(const cholesky_solver<ValueType,MemorySpace2,IndexType>& solver)
+    : Parent(solver.num_rows, solver.num_cols, solver.num_entries),
+      L(solver.L), U(solver.U), inverse_diagonal(solver.inverse_diagonal),
+      permutation(solver.permutation), inverse_permutation(solver.inverse_permutation),
+      lower_plan(solver.lower_plan), upper_plan(solver.upper_plan),
+      ordering(solver.ordering), host_permutation(solver.host_permutation),
+      supernode_columns(solver.supernode_columns),
+      supernode_row_offsets(solver.supernode_row_offsets),
+      supernode_rows(solver.supernode_rows),
+      supernode_value_offsets(solver.supernode_value_offsets),
+      value_map(solver.value_map)
+{
+}
+
+//////////////////////
+// Member Functions //
+//////////////////////
+
+template <typename ValueType, typename MemorySpace, typename IndexType>
+template <typename MatrixType>
+void
+cholesky_solver<ValueType,MemorySpace,IndexType>
+::factor(const MatrixType& A, const cholesky_ordering ordering)
+{
+    if(A.num_rows != A.num_cols)
+        throw cusp::invalid_input_exception("cholesky_solver requires a square matrix");
+
+    this->ordering = ordering;
+
+    cusp::csr_matrix<IndexType,ValueType,cusp::host_memory> H(A);
+
+    analyze(H);
+    numeric(H);
+
+    // the patterns of the factors are fixed from here on
+    cusp::triangular_solve_analysis(L, lower_plan, true,  true);
+    cusp::triangular_solve_analysis(U, upper_plan, false, true);
+
+    const size_t n = H.num_rows;
+
+    std::vector<IndexType> inverse(n);
+    for(size_t i = 0; i < n; i++)
+        inverse[host_permutation[i]] = i;
+
+    permutation         = cusp::array1d<IndexType,cusp::host_memory>(host_permutation.begin(), host_permutation.end());
+    inverse_permutation = cusp::array1d<IndexType,cusp::host_memory>(inverse.begin(), inverse.end());
+}
+
+template <typename ValueType, typename MemorySpace, typename IndexType>
+template <typename MatrixType>
+void
+cholesky_solver<ValueType,MemorySpace,IndexType>
+::refactor(const MatrixType& A)
+{
+    cusp::csr_matrix<IndexType,ValueType,cusp::host_memory> H(A);
+
+    if(H.num_rows != host_permutation.size() || H.num_cols != H.num_rows || H.num_entries != value_map.size())
+        throw cusp::invalid_input_exception("matrix pattern does not match the factorization");
+
+    numeric(H);
+}
+
+// Symbolic factorization of P A P^T: the elimination tree by Liu's
+// algorithm with path compression, the pattern of every column of L by
+// traversing the row subtrees, and the fundamental supernodes, i.e.
+// chains j, j+1, ... in which j+1 is the only child of j and the pattern
+// of j is the pattern of j+1 plus j.
+template <typename ValueType, typename MemorySpace, typename IndexType>
+template <typename HostMatrixType>
+void
+cholesky_solver<ValueType,MemorySpace,IndexType>
+::analyze(const HostMatrixType& A)
+{
+    const IndexType n = A.num_rows;
+    const size_t    npos = size_t(-1);
+
+    // ordering
+    host_permutation.resize(n);
+
+    if(ordering == rcm_ordering && n > 0)
+    {
+        cusp::permutation_matrix<IndexType,cusp::host_memory> P(n);
+        cusp::graph::symmetric_rcm(A, P);
+        std::copy(P.permutation.begin(), P.permutation.end(), host_permutation.begin());
+    }
+    else
+    {
+        for(IndexType i = 0; i < n; i++)
+            host_permutation[i] = i;
+    }
+
+    // rows of the strictly lower triangle of P A P^T
+    std::vector<IndexType> lower_offsets(n + 1, 0);
+
+    for(IndexType i = 0; i < n; i++)
+        for(IndexType jj = A.row_offsets[i]; jj < A.row_offsets[i + 1]; jj++)
+            if(host_permutation[i] > host_permutation[A.column_indices[jj]])
+                lower_offsets[host_permutation[i] + 1]++;
+
+    for(IndexType i = 0; i < n; i++)
+        lower_offsets[i + 1] += lower_offsets[i];
+
+    std::vector<IndexType> lower_columns(lower_offsets[n]);
+    std::vector<IndexType> next(lower_offsets.begin(), lower_offsets.end() - 1);
+
+    for(IndexType i = 0; i < n; i++)
+    {
+        for(IndexType jj = A.row_offsets[i]; jj < A.row_offsets[i + 1]; jj++)
+        {
+            const IndexType pi = host_permutation[i];
+            const IndexType pj = host_permutation[A.column_indices[jj]];
+
+            if(pi > pj)
+                lower_columns[next[pi]++] = pj;
+        }
+    }
+
+    // elimination tree
+    std::vector<IndexType> parent(n, -1);
+    std::vector<IndexType> ancestor(n, -1);
+
+    for(IndexType i = 0; i < n; i++)
+    {
+        for(IndexType jj = lower_offsets[i]; jj < lower_offsets[i + 1]; jj++)
+        {
+            IndexType r = lower_columns[jj];
+
+            while(ancestor[r] != -1 && ancestor[r] != i)
+            {
+                const IndexType t = ancestor[r];
+                ancestor[r] = i;
+                r = t;
+            }
+
+            if(ancestor[r] == -1)
+            {
+                ancestor[r] = i;
+                parent[r]   = i;
+            }
+        }
+    }
+
+    // row i of L holds the nodes on the paths from the entries of row i
+    // of A up to i, the first pass counts them and the second one stores
+    // them column by column, in increasing row order
+    std::vector<IndexType> column_counts(n, 0);
+    std::vector<IndexType> mark(n, -1);
+
+    for(IndexType i = 0; i < n; i++)
+    {
+        mark[i] = i;
+
+        for(IndexType jj = lower_offsets[i]; jj < lower_offsets[i + 1]; jj++)
+            for(IndexType r = lower_columns[jj]; mark[r] != i; r = parent[r])
+            {
+                column_counts[r]++;
+                mark[r] = i;
+            }
+    }
+
+    std::vector<IndexType> column_offsets(n + 1, 0);
+    for(IndexType j = 0; j < n; j++)
+        column_offsets[j + 1] = column_offsets[j] + column_counts[j];
+
+    std::vector<IndexType> column_rows(column_offsets[n]);
+    std::copy(column_offsets.begin(), column_offsets.end() - 1, next.begin());
+    std::fill(mark.begin(), mark.end(), -1);
+
+    for(IndexType i = 0; i < n; i++)
+    {
+        mark[i] = i;
+
+        for(IndexType jj = lower_offsets[i]; jj < lower_offsets[i + 1]; jj++)
+            for(IndexType r = lower_columns[jj]; mark[r] != i; r = parent[r])
+            {
+                column_rows[next[r]++] = i;
+                mark[r] = i;
+            }
+    }
+
+    // fundamental supernodes
+    std::vector<IndexType> num_children(n, 0);
+    for(IndexType j = 0; j < n; j++)
+        if(parent[j] != -1)
+            num_children[parent[j]]++;
+
+    supernode_columns.clear();
+
+    for(IndexType j = 0; j < n; j++)
+    {
+        const bool merge = j > 0 &&
+                           parent[j - 1] == j &&
+                           num_children[j] == 1 &&
+                           column_counts[j - 1] == column_counts[j] + 1;
+
+        if(!merge)
+            supernode_columns.push_back(j);
+    }
+
+    supernode_columns.push_back(n);
+
+    // the rows of a supernode are its columns followed by the pattern of
+    // its last column, the values are stored column-major per supernode
+    const size_t num_supernodes = supernode_columns.size() - 1;
+
+    supernode_row_offsets.assign(1, 0);
+    supernode_value_offsets.assign(1, 0);
+    supernode_rows.clear();
+
+    for(size_t s = 0; s < num_supernodes; s++)
+    {
+        const IndexType first = supernode_columns[s];
+        const IndexType last  = supernode_columns[s + 1] - 1;
+
+        for(IndexType j = first; j <= last; j++)
+            supernode_rows.push_back(j);
+
+        supernode_rows.insert(supernode_rows.end(),
+                              column_rows.begin() + column_offsets[last],
+                              column_rows.begin() + column_offsets[last + 1]);
+
+        const size_t num_rows = supernode_rows.size() - supernode_row_offsets.back();
+        const size_t num_cols = last - first + 1;
+
+        supernode_row_offsets.push_back(supernode_rows.size());
+        supernode_value_offsets.push_back(supernode_value_offsets.back() + num_rows * num_cols);
+    }
+
+    // position of every entry of A in the supernode values
+    std::vector<IndexType> column_supernode(n);
+    for(size_t s = 0; s < num_supernodes; s++)
+        for(IndexType j = supernode_columns[s]; j < supernode_columns[s + 1]; j++)
+            column_supernode[j] = s;
+
+    value_map.assign(A.num_entries, npos);
+
+    for(IndexType i = 0; i < n; i++)
+    {
+        for(IndexType jj = A.row_offsets[i]; jj < A.row_offsets[i + 1]; jj++)
+        {
+            const IndexType pi = host_permutation[i];
+            const IndexType pj = host_permutation[A.column_indices[jj]];
+
+            if(pi < pj)
+                continue;
+
+            const IndexType s = column_supernode[pj];
+
+            const IndexType* rows_begin = &supernode_rows[0] + supernode_row_offsets[s];
+            const IndexType* rows_end   = &supernode_rows[0] + supernode_row_offsets[s + 1];
+            const size_t     num_rows   = rows_end - rows_begin;
+
+            const size_t row    = std::lower_bound(rows_begin, rows_end, pi) - rows_begin;
+            const size_t column = pj - supernode_columns[s];
+
+            value_map[jj] = supernode_value_offsets[s] + column * num_rows + row;
+        }
+    }
+}
+
+// Left-looking supernodal LDL^T. Every finished supernode K is kept in the
+// list of the next supernode its remaining rows belong to, which receives
+// the update L_K(rows, :) D_K L_K(columns, :)^T before its own dense
+// factorization.
+template <typename ValueType, typename MemorySpace, typename IndexType>
+template <typename HostMatrixType>
+void
+cholesky_solver<ValueType,MemorySpace,IndexType>
+::numeric(const HostMatrixType& A)
+{
+    const IndexType n = A.num_rows;
+    const size_t    npos = size_t(-1);
+    const size_t    num_supernodes = supernode_columns.size() - 1;
+
+    std::vector<ValueType> values(supernode_value_offsets.back(), ValueType(0));
+    std::vector<ValueType> diagonal(n);
+
+    for(size_t jj = 0; jj < value_map.size(); jj++)
+        if(value_map[jj] != npos)
+            values[value_map[jj]] += A.values[jj];
+
+    std::vector<IndexType> column_supernode(n);
+    for(size_t s = 0; s < num_supernodes; s++)
+        for(IndexType j = supernode_columns[s]; j < supernode_columns[s + 1]; j++)
+            column_supernode[j] = s;
+
+    std::vector<IndexType> head(num_supernodes, -1);
+    std::vector<IndexType> link(num_supernodes, -1);
+    std::vector<size_t>    position(num_supernodes, 0);
+    std::vector<IndexType> relative(n);
+    std::vector<ValueType> scaled;
+
+    for(size_t s = 0; s < num_supernodes; s++)
+    {
+        const IndexType  first    = supernode_columns[s];
+        const IndexType  last     = supernode_columns[s + 1] - 1;
+        const size_t     num_cols = last - first + 1;
+        const IndexType* rows     = &supernode_rows[supernode_row_offsets[s]];
+        const size_t     num_rows = supernode_row_offsets[s + 1] - supernode_row_offsets[s];
+        ValueType*       block    = &values[supernode_value_offsets[s]];
+
+        for(size_t r = 0; r < num_rows; r++)
+            relative[rows[r]] = r;
+
+        // updates from the descendants
+        for(IndexType K = head[s]; K != -1;)
+        {
+            const IndexType  next_K    = link[K];
+            const IndexType  K_first   = supernode_columns[K];
+            const size_t     K_cols    = supernode_columns[K + 1] - K_first;
+            const IndexType* K_rows    = &supernode_rows[supernode_row_offsets[K]];
+            const size_t     K_num_rows = supernode_row_offsets[K + 1] - supernode_row_offsets[K];
+            const ValueType* K_block   = &values[supernode_value_offsets[K]];
+
+            const size_t begin = position[K];
+            size_t end = begin;
+
+            while(end < K_num_rows && K_rows[end] <= last)
+                end++;
+
+            scaled.resize(K_cols);
+
+            for(size_t c = begin; c < end; c++)
+            {
+                ValueType* target = block + (K_rows[c] - first) * num_rows;
+
+                for(size_t t = 0; t < K_cols; t++)
+                    scaled[t] = K_block[t * K_num_rows + c] * diagonal[K_first + t];
+
+                for(size_t r = c; r < K_num_rows; r++)
+                {
+                    ValueType sum = ValueType(0);
+
+                    for(size_t t = 0; t < K_cols; t++)
+                        sum += K_block[t * K_num_rows + r] * scaled[t];
+
+                    target[relative[K_rows[r]]] -= sum;
+                }
+            }
+
+            position[K] = end;
+
+            if(end < K_num_rows)
+            {
+                const IndexType ancestor = column_supernode[K_rows[end]];
+                link[K] = head[ancestor];
+                head[ancestor] = K;
+            }
+
+            K = next_K;
+        }
+
+        // dense LDL^T of the supernode, the rows below the diagonal block
+        // are eliminated along with it
+        for(size_t k = 0; k < num_cols; k++)
+        {
+            ValueType* column = block + k * num_rows;
+            const ValueType d = column[k];
+
+            if(d == ValueType(0))
+                throw cusp::runtime_exception("cholesky_solver: zero pivot");
+
+            diagonal[first + k] = d;
+
+            for(size_t r = k + 1; r < num_rows; r++)
+                column[r] /= d;
+
+            for(size_t c = k + 1; c < num_cols; c++)
+            {
+                ValueType* target = block + c * num_rows;
+                const ValueType scale = column[c] * d;
+
+                for(size_t r = c; r < num_rows; r++)
+                    target[r] -= column[r] * scale;
+            }
+
+            column[k] = ValueType(1);
+        }
+
+        if(num_rows > num_cols)
+        {
+            const IndexType ancestor = column_supernode[rows[num_cols]];
+            position[s] = num_cols;
+            link[s] = head[ancestor];
+            head[ancestor] = s;
+        }
+    }
+
+    // row j of U = L^T is the strictly lower part of column j of L
+    size_t num_entries = 0;
+
+    for(size_t s = 0; s < num_supernodes; s++)
+    {
+        const size_t num_cols = supernode_columns[s + 1] - supernode_columns[s];
+        const size_t num_rows = supernode_row_offsets[s + 1] - supernode_row_offsets[s];
+
+        num_entries += num_cols * (num_rows - 1) - num_cols * (num_cols - 1) / 2;
+    }
+
+    cusp::csr_matrix<IndexType,ValueType,cusp::host_memory> U_host(n, n, num_entries);
+
+    num_entries = 0;
+    U_host.row_offsets[0] = 0;
+
+    for(size_t s = 0; s < num_supernodes; s++)
+    {
+        const IndexType  first    = supernode_columns[s];
+        const size_t     num_cols = supernode_columns[s + 1] - first;
+        const IndexType* rows     = &supernode_rows[supernode_row_offsets[s]];
+        const size_t     num_rows = supernode_row_offsets[s + 1] - supernode_row_offsets[s];
+        const ValueType* block    = &values[supernode_value_offsets[s]];
+
+        for(size_t k = 0; k < num_cols; k++)
+        {
+            for(size_t r = k + 1; r < num_rows; r++)
+            {
+                U_host.column_indices[num_entries] = rows[r];
+                U_host.values[num_entries]         = block[k * num_rows + r];
+                num_entries++;
+            }
+
+            U_host.row_offsets[first + k + 1] = num_entries;
+        }
+    }
+
+    cusp::csr_matrix<IndexType,ValueType,cusp::host_memory> L_host;
+    cusp::transpose(U_host, L_host);
+
+    cusp::array1d<ValueType,cusp::host_memory> inverse_diagonal_host(n);
+    for(IndexType i = 0; i < n; i++)
+        inverse_diagonal_host[i] = ValueType(1) / diagonal[i];
+
+    L = L_host;
+    U = U_host;
+    inverse_diagonal = inverse_diagonal_host;
+
+    Parent::resize(n, n, 2 * num_entries + n);
+}
+
+template <typename ValueType, typename MemorySpace, typename IndexType>
+template <typename DerivedPolicy, typename VectorType1, typename VectorType2>
+void
+cholesky_solver<ValueType,MemorySpace,IndexType>
+::operator()(thrust::execution_policy<DerivedPolicy>& exec, const VectorType1& b, VectorType2& x) const
+{
+    if(permutation.size() == 0)
+        return;
+
+    workspace.resize(permutation.size());
+
+    // z = L^-T D^-1 L^-1 P b, x = P^T z
+    thrust::gather(exec, inverse_permutation.begin(), inverse_permutation.end(), b.begin(), workspace.begin());
+
+    cusp::triangular_solve(exec, L, workspace, workspace, lower_plan);
+    cusp::blas::xmy(exec, inverse_diagonal, workspace, workspace);
+    cusp::triangular_solve(exec, U, workspace, workspace, upper_plan);
+
+    thrust::gather(exec, permutation.begin(), permutation.end(), workspace.begin(), x.begin());
+}
+
+template <typename ValueType, typename MemorySpace, typename IndexType>
+template <typename VectorType1, typename VectorType2>
+void
+cholesky_solver<ValueType,MemorySpace,IndexType>
+::operator()(const VectorType1& b, VectorType2& x) const
+{
+    MemorySpace system;
+
+    (*this)(system, b, x);
+}
+
+template <typename ValueType, typename MemorySpace, typename IndexType>
+size_t
+cholesky_solver<ValueType,MemorySpace,IndexType>
+::factor_bytes(void) const
+{
+    return cusp::detail::num_bytes(L) +
+           cusp::detail::num_bytes(U) +
+           cusp::detail::num_bytes(inverse_diagonal) +
+           cusp::detail::num_bytes(permutation) +
+           cusp::detail::num_bytes(inverse_permutation) +
+           cusp::detail::num_bytes(lower_plan.rows) +
+           cusp::detail::num_bytes(upper_plan.rows);
+}
+
+} // end namespace cusp
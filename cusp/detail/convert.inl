@@ -21,6 +21,9 @@
 #include <cusp/system/detail/generic/convert.h>
 
 #include <cusp/detail/execution_policy.h>
+#include <cusp/detail/format.h>
+#include <cusp/detail/profile.h>
+#include <cusp/detail/type_traits.h>
 #include <thrust/system/detail/generic/select_system.h>
 
 namespace cusp
@@ -35,9 +38,62 @@ void convert(const thrust::detail::execution_policy_base<DerivedPolicy> &exec,
 {
     using cusp::system::detail::generic::convert;
 
+    cusp::detail::profile_range range("cusp::convert");
+
     return convert(thrust::detail::derived_cast(thrust::detail::strip_const(exec)), src, dst);
 }
 
+namespace detail
+{
+
+// the CSR structure is copied as it is, the copy of the values only takes
+// over their number
+template <typename DerivedPolicy,
+          typename SourceType,
+          typename DestinationType>
+void convert_pattern(const thrust::detail::execution_policy_base<DerivedPolicy> &exec,
+                     const SourceType& src,
+                           DestinationType& dst,
+                     cusp::csr_format)
+{
+    cusp::copy(exec, src, dst);
+}
+
+// other formats go through a CSR matrix in the memory space of src
+template <typename DerivedPolicy,
+          typename SourceType,
+          typename DestinationType,
+          typename Format>
+void convert_pattern(const thrust::detail::execution_policy_base<DerivedPolicy> &exec,
+                     const SourceType& src,
+                           DestinationType& dst,
+                     Format)
+{
+    typedef typename SourceType::container ContainerType;
+    typename cusp::detail::as_csr_type<ContainerType>::type tmp;
+
+    cusp::convert(src, tmp);
+    cusp::copy(exec, tmp, dst);
+}
+
+} // end namespace detail
+
+template <typename DerivedPolicy,
+          typename SourceType,
+          typename IndexType,
+          typename ValueType,
+          typename MemorySpace>
+void convert(const thrust::detail::execution_policy_base<DerivedPolicy> &exec,
+             const SourceType& src,
+                   cusp::csr_pattern_matrix<IndexType,ValueType,MemorySpace>& dst)
+{
+    cusp::detail::profile_range range("cusp::convert");
+
+    typename SourceType::format format;
+
+    cusp::detail::convert_pattern(exec, src, dst, format);
+}
+
 template <typename SourceType,
           typename DestinationType>
 void convert(const SourceType& src,
@@ -54,5 +110,55 @@ void convert(const SourceType& src,
     return cusp::convert(select_system(system1,system2), src, dst);
 }
 
+template <typename DerivedPolicy,
+          typename SourceType,
+          typename DestinationType>
+void move_convert(const thrust::detail::execution_policy_base<DerivedPolicy> &exec,
+                  SourceType& src,
+                  DestinationType& dst)
+{
+    using cusp::system::detail::generic::move_convert;
+
+    return move_convert(thrust::detail::derived_cast(thrust::detail::strip_const(exec)), src, dst);
+}
+
+template <typename SourceType,
+          typename DestinationType>
+void move_convert(SourceType& src,
+                  DestinationType& dst)
+{
+    using thrust::system::detail::generic::select_system;
+
+    typedef typename SourceType::memory_space System1;
+    typedef typename DestinationType::memory_space System2;
+
+    System1 system1;
+    System2 system2;
+
+    return cusp::move_convert(select_system(system1,system2), src, dst);
+}
+
+#if __cplusplus >= 201103L
+template <typename IndexType,
+          typename ValueType,
+          typename MemorySpace,
+          typename DestinationType>
+void convert(cusp::coo_matrix<IndexType,ValueType,MemorySpace>&& src,
+             DestinationType& dst)
+{
+    cusp::move_convert(src, dst);
+}
+
+template <typename IndexType,
+          typename ValueType,
+          typename MemorySpace,
+          typename DestinationType>
+void convert(cusp::csr_matrix<IndexType,ValueType,MemorySpace>&& src,
+             DestinationType& dst)
+{
+    cusp::move_convert(src, dst);
+}
+#endif
+
 } // end namespace cusp
 
@@ -65,6 +65,17 @@ coo_matrix<IndexType,ValueType,MemorySpace>
     values.resize(num_entries);
 }
 
+template <typename IndexType, typename ValueType, class MemorySpace>
+void
+coo_matrix<IndexType,ValueType,MemorySpace>
+::resize(const size_t num_rows, const size_t num_cols, const size_t num_entries, cusp::no_init_t)
+{
+    Parent::resize(num_rows, num_cols, num_entries);
+    row_indices.resize(num_entries, cusp::no_init);
+    column_indices.resize(num_entries, cusp::no_init);
+    values.resize(num_entries, cusp::no_init);
+}
+
 template <typename IndexType, typename ValueType, class MemorySpace>
 void
 coo_matrix<IndexType,ValueType,MemorySpace>
@@ -112,7 +123,7 @@ bool
 coo_matrix<IndexType,ValueType,MemorySpace>
 ::is_sorted_by_row(void)
 {
-    return thrust::is_sorted(row_indices.begin(), row_indices.end());
+    return cusp::is_sorted_by_row(row_indices);
 }
 
 // determine whether matrix elements are sorted by row and column index
@@ -121,9 +132,7 @@ bool
 coo_matrix<IndexType,ValueType,MemorySpace>
 ::is_sorted_by_row_and_column(void)
 {
-    return thrust::is_sorted
-           (thrust::make_zip_iterator(thrust::make_tuple(row_indices.begin(), column_indices.begin())),
-            thrust::make_zip_iterator(thrust::make_tuple(row_indices.end(),   column_indices.end())));
+    return cusp::is_sorted_by_row_and_column(row_indices, column_indices);
 }
 
 ///////////////////////
@@ -377,7 +386,7 @@ bool
 coo_matrix_view<Array1,Array2,Array3,IndexType,ValueType,MemorySpace>
 ::is_sorted_by_row(void)
 {
-    return thrust::is_sorted(row_indices.begin(), row_indices.end());
+    return cusp::is_sorted_by_row(row_indices);
 }
 
 // determine whether matrix elements are sorted by row and column index
@@ -386,9 +395,7 @@ bool
 coo_matrix_view<Array1,Array2,Array3,IndexType,ValueType,MemorySpace>
 ::is_sorted_by_row_and_column(void)
 {
-    return thrust::is_sorted
-           (thrust::make_zip_iterator(thrust::make_tuple(row_indices.begin(), column_indices.begin())),
-            thrust::make_zip_iterator(thrust::make_tuple(row_indices.end(),   column_indices.end())));
+    return cusp::is_sorted_by_row_and_column(row_indices, column_indices);
 }
 
 } // end namespace cusp
@@ -27,9 +27,9 @@ template <typename T1, typename T2> void convert(const T1&, T2&);
 //////////////////
 
 // construct from a different matrix
-template <typename IndexType, typename ValueType, class MemorySpace>
+template <typename IndexType, typename ValueType, class MemorySpace, typename OffsetType>
 template <typename MatrixType>
-csr_matrix<IndexType,ValueType,MemorySpace>
+csr_matrix<IndexType,ValueType,MemorySpace,OffsetType>
 ::csr_matrix(const MatrixType& matrix)
 {
     cusp::convert(matrix, *this);
@@ -39,9 +39,9 @@ csr_matrix<IndexType,ValueType,MemorySpace>
 // Member Functions //
 //////////////////////
 
-template <typename IndexType, typename ValueType, class MemorySpace>
+template <typename IndexType, typename ValueType, class MemorySpace, typename OffsetType>
 void
-csr_matrix<IndexType,ValueType,MemorySpace>
+csr_matrix<IndexType,ValueType,MemorySpace,OffsetType>
 ::resize(const size_t num_rows, const size_t num_cols, const size_t num_entries)
 {
     Parent::resize(num_rows, num_cols, num_entries);
@@ -50,9 +50,20 @@ csr_matrix<IndexType,ValueType,MemorySpace>
     values.resize(num_entries);
 }
 
-template <typename IndexType, typename ValueType, class MemorySpace>
+template <typename IndexType, typename ValueType, class MemorySpace, typename OffsetType>
 void
-csr_matrix<IndexType,ValueType,MemorySpace>
+csr_matrix<IndexType,ValueType,MemorySpace,OffsetType>
+::resize(const size_t num_rows, const size_t num_cols, const size_t num_entries, cusp::no_init_t)
+{
+    Parent::resize(num_rows, num_cols, num_entries);
+    row_offsets.resize(num_rows + 1, cusp::no_init);
+    column_indices.resize(num_entries, cusp::no_init);
+    values.resize(num_entries, cusp::no_init);
+}
+
+template <typename IndexType, typename ValueType, class MemorySpace, typename OffsetType>
+void
+csr_matrix<IndexType,ValueType,MemorySpace,OffsetType>
 ::swap(csr_matrix& matrix)
 {
     Parent::swap(matrix);
@@ -62,10 +73,10 @@ csr_matrix<IndexType,ValueType,MemorySpace>
 }
 
 // assignment from another matrix
-template <typename IndexType, typename ValueType, class MemorySpace>
+template <typename IndexType, typename ValueType, class MemorySpace, typename OffsetType>
 template <typename MatrixType>
-csr_matrix<IndexType,ValueType,MemorySpace>&
-csr_matrix<IndexType,ValueType,MemorySpace>
+csr_matrix<IndexType,ValueType,MemorySpace,OffsetType>&
+csr_matrix<IndexType,ValueType,MemorySpace,OffsetType>
 ::operator=(const MatrixType& matrix)
 {
     cusp::convert(matrix, *this);
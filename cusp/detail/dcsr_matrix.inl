@@ -0,0 +1,113 @@
+/*
+ *  Copyright 2008-2014 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include <cusp/detail/utils.h>
+
+namespace cusp
+{
+
+// Forward definitions
+template <typename T1, typename T2> void convert(const T1&, T2&);
+
+//////////////////
+// Constructors //
+//////////////////
+
+template <typename IndexType, typename ValueType, class MemorySpace>
+dcsr_matrix<IndexType,ValueType,MemorySpace>
+::dcsr_matrix(const size_t num_rows, const size_t num_cols, const size_t num_entries,
+              const size_t num_full_entries)
+    : Parent(num_rows, num_cols, num_entries),
+      row_offsets(num_rows + 1),
+      block_offsets(cusp::detail::divide_into(num_rows, rows_per_block) + 1),
+      column_deltas(num_entries),
+      column_indices(num_full_entries),
+      values(num_entries) {}
+
+// construct from a different matrix
+template <typename IndexType, typename ValueType, class MemorySpace>
+template <typename MatrixType>
+dcsr_matrix<IndexType,ValueType,MemorySpace>
+::dcsr_matrix(const MatrixType& matrix)
+{
+    cusp::convert(matrix, *this);
+}
+
+//////////////////////
+// Member Functions //
+//////////////////////
+
+template <typename IndexType, typename ValueType, class MemorySpace>
+void
+dcsr_matrix<IndexType,ValueType,MemorySpace>
+::resize(const size_t num_rows, const size_t num_cols, const size_t num_entries,
+         const size_t num_full_entries)
+{
+    Parent::resize(num_rows, num_cols, num_entries);
+    row_offsets.resize(num_rows + 1);
+    block_offsets.resize(cusp::detail::divide_into(num_rows, rows_per_block) + 1);
+    column_deltas.resize(num_entries);
+    column_indices.resize(num_full_entries);
+    values.resize(num_entries);
+}
+
+template <typename IndexType, typename ValueType, class MemorySpace>
+void
+dcsr_matrix<IndexType,ValueType,MemorySpace>
+::swap(dcsr_matrix& matrix)
+{
+    Parent::swap(matrix);
+    row_offsets.swap(matrix.row_offsets);
+    block_offsets.swap(matrix.block_offsets);
+    column_deltas.swap(matrix.column_deltas);
+    column_indices.swap(matrix.column_indices);
+    values.swap(matrix.values);
+}
+
+// assignment from another matrix
+template <typename IndexType, typename ValueType, class MemorySpace>
+template <typename MatrixType>
+dcsr_matrix<IndexType,ValueType,MemorySpace>&
+dcsr_matrix<IndexType,ValueType,MemorySpace>
+::operator=(const MatrixType& matrix)
+{
+    cusp::convert(matrix, *this);
+
+    return *this;
+}
+
+///////////////////////////
+// View Member Functions //
+///////////////////////////
+
+template <typename ArrayType1, typename ArrayType2, typename ArrayType3, typename ArrayType4, typename ArrayType5,
+          typename IndexType, typename ValueType, typename MemorySpace>
+void
+dcsr_matrix_view<ArrayType1,ArrayType2,ArrayType3,ArrayType4,ArrayType5,IndexType,ValueType,MemorySpace>
+::resize(const size_t num_rows, const size_t num_cols, const size_t num_entries,
+         const size_t num_full_entries)
+{
+    Parent::resize(num_rows, num_cols, num_entries);
+    row_offsets.resize(num_rows + 1);
+    block_offsets.resize(cusp::detail::divide_into(num_rows, rows_per_block) + 1);
+    column_deltas.resize(num_entries);
+    column_indices.resize(num_full_entries);
+    values.resize(num_entries);
+}
+
+} // end namespace cusp
+
+#include <cusp/convert.h>
@@ -0,0 +1,643 @@
+/*
+ *  Copyright 2008-2014 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include <cusp/exception.h>
+
+#include <thrust/count.h>
+#include <thrust/extrema.h>
+#include <thrust/fill.h>
+#include <thrust/for_each.h>
+#include <thrust/functional.h>
+#include <thrust/reduce.h>
+#include <thrust/remove.h>
+#include <thrust/scan.h>
+#include <thrust/scatter.h>
+#include <thrust/sequence.h>
+#include <thrust/sort.h>
+#include <thrust/transform.h>
+#include <thrust/tuple.h>
+#include <thrust/unique.h>
+
+#include <thrust/iterator/constant_iterator.h>
+#include <thrust/iterator/counting_iterator.h>
+#include <thrust/iterator/permutation_iterator.h>
+#include <thrust/iterator/zip_iterator.h>
+
+namespace cusp
+{
+
+// Forward definitions
+template <typename T1, typename T2> void convert(const T1&, T2&);
+
+namespace detail
+{
+
+///////////////////////////////////
+// Helper functions and functors //
+///////////////////////////////////
+
+// capacity granted to a row holding n entries when it is (re)allocated
+template <typename IndexType>
+struct dynamic_csr_capacity : public thrust::unary_function<IndexType,IndexType>
+{
+    float     slack;
+    IndexType min_slack;
+
+    dynamic_csr_capacity(float slack, IndexType min_slack)
+        : slack(slack), min_slack(min_slack) {}
+
+    __host__ __device__
+    IndexType operator()(const IndexType n) const
+    {
+        const IndexType extra = IndexType(slack * float(n));
+        return n + (extra < min_slack ? min_slack : extra);
+    }
+};
+
+// keeps the last of several values inserted at the same position
+template <typename T>
+struct dynamic_csr_last_value : public thrust::binary_function<T,T,T>
+{
+    __host__ __device__
+    T operator()(const T&, const T& b) const
+    {
+        return b;
+    }
+};
+
+template <typename IndexType>
+struct dynamic_csr_found : public thrust::unary_function<IndexType,bool>
+{
+    __host__ __device__
+    bool operator()(const IndexType pos) const
+    {
+        return pos != IndexType(-1);
+    }
+};
+
+template <typename IndexType>
+struct dynamic_csr_in_range : public thrust::unary_function<IndexType,bool>
+{
+    IndexType num_rows;
+
+    dynamic_csr_in_range(IndexType num_rows)
+        : num_rows(num_rows) {}
+
+    __host__ __device__
+    bool operator()(const IndexType i) const
+    {
+        return i >= IndexType(0) && i < num_rows;
+    }
+};
+
+// position of (i,j) in the sorted row i, or -1 if the entry is not stored
+template <typename IndexType>
+struct dynamic_csr_locate
+{
+    const IndexType * offsets;
+    const IndexType * lengths;
+    const IndexType * cols;
+
+    dynamic_csr_locate(const IndexType * offsets, const IndexType * lengths, const IndexType * cols)
+        : offsets(offsets), lengths(lengths), cols(cols) {}
+
+    template <typename Tuple>
+    __host__ __device__
+    IndexType operator()(const Tuple& t) const
+    {
+        const IndexType i = thrust::get<0>(t);
+        const IndexType j = thrust::get<1>(t);
+
+        const IndexType end = offsets[i] + lengths[i];
+
+        IndexType lo = offsets[i];
+        IndexType hi = end;
+
+        while (lo < hi)
+        {
+            const IndexType mid = lo + (hi - lo) / 2;
+
+            if (cols[mid] < j)
+                lo = mid + 1;
+            else
+                hi = mid;
+        }
+
+        return (lo < end && cols[lo] == j) ? lo : IndexType(-1);
+    }
+};
+
+// flags rows of a batch which do not fit into their free capacity
+template <typename IndexType>
+struct dynamic_csr_overflow
+{
+    const IndexType * offsets;
+    const IndexType * lengths;
+    const IndexType * batch_rows;
+    const IndexType * batch_counts;
+
+    dynamic_csr_overflow(const IndexType * offsets, const IndexType * lengths,
+                         const IndexType * batch_rows, const IndexType * batch_counts)
+        : offsets(offsets), lengths(lengths), batch_rows(batch_rows), batch_counts(batch_counts) {}
+
+    __host__ __device__
+    bool operator()(const IndexType t) const
+    {
+        const IndexType i = batch_rows[t];
+        return lengths[i] + batch_counts[t] > offsets[i + 1] - offsets[i];
+    }
+};
+
+// rows which outgrow their capacity are reallocated, all others keep it
+template <typename IndexType>
+struct dynamic_csr_grow
+{
+    const IndexType * offsets;
+    const IndexType * required;
+    dynamic_csr_capacity<IndexType> capacity;
+
+    dynamic_csr_grow(const IndexType * offsets, const IndexType * required,
+                     dynamic_csr_capacity<IndexType> capacity)
+        : offsets(offsets), required(required), capacity(capacity) {}
+
+    __host__ __device__
+    IndexType operator()(const IndexType i) const
+    {
+        const IndexType current = offsets[i + 1] - offsets[i];
+        return required[i] > current ? capacity(required[i]) : current;
+    }
+};
+
+// copies the entries of a row into the reallocated storage
+template <typename IndexType, typename ValueType>
+struct dynamic_csr_move_row
+{
+    const IndexType * old_offsets;
+    const IndexType * new_offsets;
+    const IndexType * lengths;
+    const IndexType * old_cols;
+    const ValueType * old_vals;
+    IndexType * cols;
+    ValueType * vals;
+
+    dynamic_csr_move_row(const IndexType * old_offsets, const IndexType * new_offsets, const IndexType * lengths,
+                         const IndexType * old_cols, const ValueType * old_vals,
+                         IndexType * cols, ValueType * vals)
+        : old_offsets(old_offsets), new_offsets(new_offsets), lengths(lengths),
+          old_cols(old_cols), old_vals(old_vals), cols(cols), vals(vals) {}
+
+    __host__ __device__
+    void operator()(const IndexType i) const
+    {
+        const IndexType src = old_offsets[i];
+        const IndexType dst = new_offsets[i];
+
+        for (IndexType k = 0; k < lengths[i]; k++)
+        {
+            cols[dst + k] = old_cols[src + k];
+            vals[dst + k] = old_vals[src + k];
+        }
+    }
+};
+
+// merges the sorted new entries of a row into the row, back to front so
+// the stored entries are moved in place
+template <typename IndexType, typename ValueType>
+struct dynamic_csr_merge_row
+{
+    const IndexType * offsets;
+    IndexType * lengths;
+    IndexType * cols;
+    ValueType * vals;
+
+    const IndexType * batch_rows;
+    const IndexType * batch_starts;
+    const IndexType * batch_counts;
+    const IndexType * batch_cols;
+    const ValueType * batch_vals;
+
+    dynamic_csr_merge_row(const IndexType * offsets, IndexType * lengths, IndexType * cols, ValueType * vals,
+                          const IndexType * batch_rows, const IndexType * batch_starts, const IndexType * batch_counts,
+                          const IndexType * batch_cols, const ValueType * batch_vals)
+        : offsets(offsets), lengths(lengths), cols(cols), vals(vals),
+          batch_rows(batch_rows), batch_starts(batch_starts), batch_counts(batch_counts),
+          batch_cols(batch_cols), batch_vals(batch_vals) {}
+
+    __host__ __device__
+    void operator()(const IndexType t) const
+    {
+        const IndexType i = batch_rows[t];
+
+        const IndexType row_start   = offsets[i];
+        const IndexType batch_start = batch_starts[t];
+
+        IndexType a   = row_start + lengths[i];
+        IndexType b   = batch_start + batch_counts[t];
+        IndexType out = a + batch_counts[t];
+
+        lengths[i] += batch_counts[t];
+
+        while (b > batch_start)
+        {
+            --out;
+
+            if (a > row_start && cols[a - 1] > batch_cols[b - 1])
+            {
+                --a;
+                cols[out] = cols[a];
+                vals[out] = vals[a];
+            }
+            else
+            {
+                --b;
+                cols[out] = batch_cols[b];
+                vals[out] = batch_vals[b];
+            }
+        }
+    }
+};
+
+// removes the entries of a row marked with an invalid column
+template <typename IndexType, typename ValueType>
+struct dynamic_csr_compact_row
+{
+    const IndexType * offsets;
+    IndexType * lengths;
+    IndexType * cols;
+    ValueType * vals;
+
+    dynamic_csr_compact_row(const IndexType * offsets, IndexType * lengths, IndexType * cols, ValueType * vals)
+        : offsets(offsets), lengths(lengths), cols(cols), vals(vals) {}
+
+    __host__ __device__
+    void operator()(const IndexType i) const
+    {
+        const IndexType row_start = offsets[i];
+        const IndexType row_end   = row_start + lengths[i];
+
+        IndexType out = row_start;
+
+        for (IndexType k = row_start; k < row_end; k++)
+        {
+            if (cols[k] != IndexType(-1))
+            {
+                cols[out] = cols[k];
+                vals[out] = vals[k];
+                out++;
+            }
+        }
+
+        lengths[i] = out - row_start;
+    }
+};
+
+// moves every row of A into storage with the given row capacities
+template <typename MatrixType, typename ArrayType>
+void dynamic_csr_reallocate(MatrixType& A, const ArrayType& capacities)
+{
+    typedef typename MatrixType::index_type   IndexType;
+    typedef typename MatrixType::value_type   ValueType;
+    typedef typename MatrixType::memory_space MemorySpace;
+
+    MemorySpace system;
+
+    typename MatrixType::row_offsets_array_type row_offsets(A.num_rows + 1);
+    row_offsets[0] = 0;
+    thrust::inclusive_scan(system, capacities.begin(), capacities.end(), row_offsets.begin() + 1);
+
+    const size_t capacity = row_offsets[A.num_rows];
+
+    typename MatrixType::column_indices_array_type column_indices(capacity);
+    typename MatrixType::values_array_type         values(capacity);
+
+    thrust::for_each(system,
+                     thrust::counting_iterator<IndexType>(0),
+                     thrust::counting_iterator<IndexType>(A.num_rows),
+                     dynamic_csr_move_row<IndexType,ValueType>(
+                         thrust::raw_pointer_cast(A.row_offsets.data()),
+                         thrust::raw_pointer_cast(row_offsets.data()),
+                         thrust::raw_pointer_cast(A.row_lengths.data()),
+                         thrust::raw_pointer_cast(A.column_indices.data()),
+                         thrust::raw_pointer_cast(A.values.data()),
+                         thrust::raw_pointer_cast(column_indices.data()),
+                         thrust::raw_pointer_cast(values.data())));
+
+    A.row_offsets.swap(row_offsets);
+    A.column_indices.swap(column_indices);
+    A.values.swap(values);
+}
+
+} // end namespace detail
+
+//////////////////
+// Constructors //
+//////////////////
+
+template <typename IndexType, typename ValueType, class MemorySpace>
+dynamic_csr_matrix<IndexType,ValueType,MemorySpace>
+::dynamic_csr_matrix(const size_t num_rows, const size_t num_cols, const size_t row_capacity)
+    : Parent(num_rows, num_cols, 0),
+      row_offsets(num_rows + 1),
+      row_lengths(num_rows, IndexType(0)),
+      column_indices(num_rows * row_capacity),
+      values(num_rows * row_capacity),
+      slack(0.25f),
+      min_row_slack(2)
+{
+    thrust::sequence(row_offsets.begin(), row_offsets.end(), IndexType(0), IndexType(row_capacity));
+}
+
+// construct from a different matrix
+template <typename IndexType, typename ValueType, class MemorySpace>
+template <typename MatrixType>
+dynamic_csr_matrix<IndexType,ValueType,MemorySpace>
+::dynamic_csr_matrix(const MatrixType& matrix)
+    : slack(0.25f), min_row_slack(2)
+{
+    cusp::convert(matrix, *this);
+}
+
+//////////////////////
+// Member Functions //
+//////////////////////
+
+template <typename IndexType, typename ValueType, class MemorySpace>
+void
+dynamic_csr_matrix<IndexType,ValueType,MemorySpace>
+::resize(const size_t num_rows, const size_t num_cols, const size_t num_entries,
+         const size_t capacity)
+{
+    Parent::resize(num_rows, num_cols, num_entries);
+    row_offsets.resize(num_rows + 1);
+    row_lengths.resize(num_rows);
+    column_indices.resize(capacity);
+    values.resize(capacity);
+}
+
+template <typename IndexType, typename ValueType, class MemorySpace>
+void
+dynamic_csr_matrix<IndexType,ValueType,MemorySpace>
+::swap(dynamic_csr_matrix& matrix)
+{
+    Parent::swap(matrix);
+    row_offsets.swap(matrix.row_offsets);
+    row_lengths.swap(matrix.row_lengths);
+    column_indices.swap(matrix.column_indices);
+    values.swap(matrix.values);
+    thrust::swap(slack, matrix.slack);
+    thrust::swap(min_row_slack, matrix.min_row_slack);
+}
+
+template <typename IndexType, typename ValueType, class MemorySpace>
+template <typename ArrayType1, typename ArrayType2, typename ArrayType3>
+void
+dynamic_csr_matrix<IndexType,ValueType,MemorySpace>
+::insert(const ArrayType1& rows, const ArrayType2& cols, const ArrayType3& vals)
+{
+    typedef cusp::array1d<IndexType,MemorySpace> IndexArray;
+    typedef cusp::array1d<ValueType,MemorySpace> ValueArray;
+
+    if (rows.size() != cols.size() || rows.size() != vals.size())
+        throw cusp::invalid_input_exception("row, column and value arrays of the batch must have the same size");
+
+    if (rows.size() == 0)
+        return;
+
+    MemorySpace system;
+
+    IndexArray batch_rows(rows);
+    IndexArray batch_cols(cols);
+    ValueArray batch_vals(vals);
+
+    const thrust::pair<typename IndexArray::iterator, typename IndexArray::iterator>
+        row_range = thrust::minmax_element(system, batch_rows.begin(), batch_rows.end());
+    const thrust::pair<typename IndexArray::iterator, typename IndexArray::iterator>
+        col_range = thrust::minmax_element(system, batch_cols.begin(), batch_cols.end());
+
+    if (IndexType(*row_range.first) < IndexType(0) || size_t(IndexType(*row_range.second)) >= this->num_rows ||
+        IndexType(*col_range.first) < IndexType(0) || size_t(IndexType(*col_range.second)) >= this->num_cols)
+        throw cusp::invalid_input_exception("inserted entry lies outside the matrix");
+
+    // order the batch by row and column, the last of equal positions wins
+    thrust::stable_sort_by_key(system,
+                               thrust::make_zip_iterator(thrust::make_tuple(batch_rows.begin(), batch_cols.begin())),
+                               thrust::make_zip_iterator(thrust::make_tuple(batch_rows.end(),   batch_cols.end())),
+                               batch_vals.begin());
+
+    IndexArray unique_rows(batch_rows.size());
+    IndexArray unique_cols(batch_cols.size());
+    ValueArray unique_vals(batch_vals.size());
+
+    const size_t num_unique =
+        thrust::reduce_by_key(system,
+                              thrust::make_zip_iterator(thrust::make_tuple(batch_rows.begin(), batch_cols.begin())),
+                              thrust::make_zip_iterator(thrust::make_tuple(batch_rows.end(),   batch_cols.end())),
+                              batch_vals.begin(),
+                              thrust::make_zip_iterator(thrust::make_tuple(unique_rows.begin(), unique_cols.begin())),
+                              unique_vals.begin(),
+                              thrust::equal_to< thrust::tuple<IndexType,IndexType> >(),
+                              detail::dynamic_csr_last_value<ValueType>()).second - unique_vals.begin();
+
+    // stored entries only receive their new value
+    IndexArray positions(num_unique);
+    thrust::transform(system,
+                      thrust::make_zip_iterator(thrust::make_tuple(unique_rows.begin(), unique_cols.begin())),
+                      thrust::make_zip_iterator(thrust::make_tuple(unique_rows.begin(), unique_cols.begin())) + num_unique,
+                      positions.begin(),
+                      detail::dynamic_csr_locate<IndexType>(thrust::raw_pointer_cast(row_offsets.data()),
+                                                            thrust::raw_pointer_cast(row_lengths.data()),
+                                                            thrust::raw_pointer_cast(column_indices.data())));
+
+    thrust::scatter_if(system,
+                       unique_vals.begin(), unique_vals.begin() + num_unique,
+                       positions.begin(),
+                       positions.begin(),
+                       values.begin(),
+                       detail::dynamic_csr_found<IndexType>());
+
+    const size_t num_new =
+        thrust::remove_if(system,
+                          thrust::make_zip_iterator(thrust::make_tuple(unique_rows.begin(), unique_cols.begin(), unique_vals.begin())),
+                          thrust::make_zip_iterator(thrust::make_tuple(unique_rows.begin(), unique_cols.begin(), unique_vals.begin())) + num_unique,
+                          positions.begin(),
+                          detail::dynamic_csr_found<IndexType>())
+        - thrust::make_zip_iterator(thrust::make_tuple(unique_rows.begin(), unique_cols.begin(), unique_vals.begin()));
+
+    if (num_new == 0)
+        return;
+
+    // number of new entries of every affected row and their first position
+    IndexArray new_rows(num_new);
+    IndexArray new_counts(num_new);
+
+    const size_t num_new_rows =
+        thrust::reduce_by_key(system,
+                              unique_rows.begin(), unique_rows.begin() + num_new,
+                              thrust::constant_iterator<IndexType>(1),
+                              new_rows.begin(),
+                              new_counts.begin()).first - new_rows.begin();
+
+    IndexArray new_starts(num_new_rows);
+    thrust::exclusive_scan(system, new_counts.begin(), new_counts.begin() + num_new_rows, new_starts.begin());
+
+    const size_t num_overflows =
+        thrust::count_if(system,
+                         thrust::counting_iterator<IndexType>(0),
+                         thrust::counting_iterator<IndexType>(num_new_rows),
+                         detail::dynamic_csr_overflow<IndexType>(thrust::raw_pointer_cast(row_offsets.data()),
+                                                                 thrust::raw_pointer_cast(row_lengths.data()),
+                                                                 thrust::raw_pointer_cast(new_rows.data()),
+                                                                 thrust::raw_pointer_cast(new_counts.data())));
+
+    if (num_overflows > 0)
+    {
+        IndexArray required(row_lengths);
+
+        thrust::transform(system,
+                          thrust::make_permutation_iterator(required.begin(), new_rows.begin()),
+                          thrust::make_permutation_iterator(required.begin(), new_rows.begin()) + num_new_rows,
+                          new_counts.begin(),
+                          thrust::make_permutation_iterator(required.begin(), new_rows.begin()),
+                          thrust::plus<IndexType>());
+
+        IndexArray capacities(this->num_rows);
+        thrust::transform(system,
+                          thrust::counting_iterator<IndexType>(0),
+                          thrust::counting_iterator<IndexType>(this->num_rows),
+                          capacities.begin(),
+                          detail::dynamic_csr_grow<IndexType>(thrust::raw_pointer_cast(row_offsets.data()),
+                                                              thrust::raw_pointer_cast(required.data()),
+                                                              detail::dynamic_csr_capacity<IndexType>(slack, min_row_slack)));
+
+        detail::dynamic_csr_reallocate(*this, capacities);
+    }
+
+    thrust::for_each(system,
+                     thrust::counting_iterator<IndexType>(0),
+                     thrust::counting_iterator<IndexType>(num_new_rows),
+                     detail::dynamic_csr_merge_row<IndexType,ValueType>(
+                         thrust::raw_pointer_cast(row_offsets.data()),
+                         thrust::raw_pointer_cast(row_lengths.data()),
+                         thrust::raw_pointer_cast(column_indices.data()),
+                         thrust::raw_pointer_cast(values.data()),
+                         thrust::raw_pointer_cast(new_rows.data()),
+                         thrust::raw_pointer_cast(new_starts.data()),
+                         thrust::raw_pointer_cast(new_counts.data()),
+                         thrust::raw_pointer_cast(unique_cols.data()),
+                         thrust::raw_pointer_cast(unique_vals.data())));
+
+    this->num_entries += num_new;
+}
+
+template <typename IndexType, typename ValueType, class MemorySpace>
+template <typename ArrayType1, typename ArrayType2>
+void
+dynamic_csr_matrix<IndexType,ValueType,MemorySpace>
+::erase(const ArrayType1& rows, const ArrayType2& cols)
+{
+    typedef cusp::array1d<IndexType,MemorySpace> IndexArray;
+
+    if (rows.size() != cols.size())
+        throw cusp::invalid_input_exception("row and column arrays of the batch must have the same size");
+
+    if (rows.size() == 0)
+        return;
+
+    MemorySpace system;
+
+    IndexArray batch_rows(rows);
+    IndexArray batch_cols(cols);
+
+    // entries outside the matrix are not stored
+    IndexArray positions(batch_rows.size(), IndexType(-1));
+
+    thrust::transform_if(system,
+                         thrust::make_zip_iterator(thrust::make_tuple(batch_rows.begin(), batch_cols.begin())),
+                         thrust::make_zip_iterator(thrust::make_tuple(batch_rows.end(),   batch_cols.end())),
+                         batch_rows.begin(),
+                         positions.begin(),
+                         detail::dynamic_csr_locate<IndexType>(thrust::raw_pointer_cast(row_offsets.data()),
+                                                               thrust::raw_pointer_cast(row_lengths.data()),
+                                                               thrust::raw_pointer_cast(column_indices.data())),
+                         detail::dynamic_csr_in_range<IndexType>(this->num_rows));
+
+    // mark the stored entries, a position erased twice is marked twice
+    thrust::scatter_if(system,
+                       thrust::constant_iterator<IndexType>(IndexType(-1)),
+                       thrust::constant_iterator<IndexType>(IndexType(-1)) + positions.size(),
+                       positions.begin(),
+                       positions.begin(),
+                       column_indices.begin(),
+                       detail::dynamic_csr_found<IndexType>());
+
+    // compact every affected row once
+    const size_t num_found =
+        thrust::remove_if(system,
+                          batch_rows.begin(), batch_rows.end(),
+                          positions.begin(),
+                          thrust::not1(detail::dynamic_csr_found<IndexType>())) - batch_rows.begin();
+
+    if (num_found == 0)
+        return;
+
+    thrust::sort(system, batch_rows.begin(), batch_rows.begin() + num_found);
+
+    const size_t num_affected_rows =
+        thrust::unique(system, batch_rows.begin(), batch_rows.begin() + num_found) - batch_rows.begin();
+
+    thrust::for_each(system,
+                     batch_rows.begin(), batch_rows.begin() + num_affected_rows,
+                     detail::dynamic_csr_compact_row<IndexType,ValueType>(
+                         thrust::raw_pointer_cast(row_offsets.data()),
+                         thrust::raw_pointer_cast(row_lengths.data()),
+                         thrust::raw_pointer_cast(column_indices.data()),
+                         thrust::raw_pointer_cast(values.data())));
+
+    this->num_entries = thrust::reduce(system, row_lengths.begin(), row_lengths.end(), size_t(0));
+}
+
+template <typename IndexType, typename ValueType, class MemorySpace>
+void
+dynamic_csr_matrix<IndexType,ValueType,MemorySpace>
+::rebalance(void)
+{
+    MemorySpace system;
+
+    cusp::array1d<IndexType,MemorySpace> capacities(this->num_rows);
+
+    thrust::transform(system,
+                      row_lengths.begin(), row_lengths.end(),
+                      capacities.begin(),
+                      detail::dynamic_csr_capacity<IndexType>(slack, min_row_slack));
+
+    detail::dynamic_csr_reallocate(*this, capacities);
+}
+
+// assignment from another matrix
+template <typename IndexType, typename ValueType, class MemorySpace>
+template <typename MatrixType>
+dynamic_csr_matrix<IndexType,ValueType,MemorySpace>&
+dynamic_csr_matrix<IndexType,ValueType,MemorySpace>
+::operator=(const MatrixType& matrix)
+{
+    cusp::convert(matrix, *this);
+
+    return *this;
+}
+
+} // end namespace cusp
+
+#include <cusp/convert.h>
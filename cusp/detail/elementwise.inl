@@ -96,5 +96,89 @@ void subtract(const MatrixType1& A,
     cusp::elementwise(A, B, C, op);
 }
 
+template <typename DerivedPolicy,
+          typename MatrixType1,
+          typename MatrixType2,
+          typename MatrixType3,
+          typename PlanType>
+void add_symbolic(const thrust::detail::execution_policy_base<DerivedPolicy>& exec,
+                  const MatrixType1& A,
+                  const MatrixType2& B,
+                        MatrixType3& C,
+                        PlanType& plan)
+{
+    using cusp::system::detail::generic::add_symbolic;
+
+    add_symbolic(thrust::detail::derived_cast(thrust::detail::strip_const(exec)), A, B, C, plan);
+}
+
+template <typename MatrixType1,
+          typename MatrixType2,
+          typename MatrixType3,
+          typename PlanType>
+void add_symbolic(const MatrixType1& A,
+                  const MatrixType2& B,
+                        MatrixType3& C,
+                        PlanType& plan)
+{
+    using thrust::system::detail::generic::select_system;
+
+    typedef typename MatrixType1::memory_space System1;
+    typedef typename MatrixType2::memory_space System2;
+    typedef typename MatrixType3::memory_space System3;
+
+    System1 system1;
+    System2 system2;
+    System3 system3;
+
+    cusp::add_symbolic(select_system(system1,system2,system3), A, B, C, plan);
+}
+
+template <typename DerivedPolicy,
+          typename MatrixType1,
+          typename MatrixType2,
+          typename MatrixType3,
+          typename PlanType,
+          typename ScalarType1,
+          typename ScalarType2>
+void add_numeric(const thrust::detail::execution_policy_base<DerivedPolicy>& exec,
+                 const MatrixType1& A,
+                 const MatrixType2& B,
+                       MatrixType3& C,
+                 const PlanType& plan,
+                 const ScalarType1 alpha,
+                 const ScalarType2 beta)
+{
+    using cusp::system::detail::generic::add_numeric;
+
+    add_numeric(thrust::detail::derived_cast(thrust::detail::strip_const(exec)), A, B, C, plan, alpha, beta);
+}
+
+template <typename MatrixType1,
+          typename MatrixType2,
+          typename MatrixType3,
+          typename PlanType,
+          typename ScalarType1,
+          typename ScalarType2>
+void add_numeric(const MatrixType1& A,
+                 const MatrixType2& B,
+                       MatrixType3& C,
+                 const PlanType& plan,
+                 const ScalarType1 alpha,
+                 const ScalarType2 beta)
+{
+    using thrust::system::detail::generic::select_system;
+
+    typedef typename MatrixType1::memory_space System1;
+    typedef typename MatrixType2::memory_space System2;
+    typedef typename MatrixType3::memory_space System3;
+
+    System1 system1;
+    System2 system2;
+    System3 system3;
+
+    cusp::add_numeric(select_system(system1,system2,system3), A, B, C, plan, alpha, beta);
+}
+
 } // end namespace cusp
 
@@ -0,0 +1,96 @@
+/*
+ *  Copyright 2008-2014 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include <cusp/detail/config.h>
+#include <thrust/system/detail/generic/select_system.h>
+
+#include <cusp/system/detail/generic/equilibrate.h>
+
+namespace cusp
+{
+
+template <typename DerivedPolicy, typename MatrixType, typename ArrayType>
+void scale_rows(const thrust::detail::execution_policy_base<DerivedPolicy> &exec,
+                MatrixType& A, const ArrayType& scale)
+{
+    using cusp::system::detail::generic::scale_rows;
+
+    return scale_rows(thrust::detail::derived_cast(thrust::detail::strip_const(exec)), A, scale);
+}
+
+template <typename MatrixType, typename ArrayType>
+void scale_rows(MatrixType& A, const ArrayType& scale)
+{
+    using thrust::system::detail::generic::select_system;
+
+    typedef typename MatrixType::memory_space System1;
+    typedef typename ArrayType::memory_space  System2;
+
+    System1 system1;
+    System2 system2;
+
+    return cusp::scale_rows(select_system(system1,system2), A, scale);
+}
+
+template <typename DerivedPolicy, typename MatrixType, typename ArrayType>
+void scale_columns(const thrust::detail::execution_policy_base<DerivedPolicy> &exec,
+                   MatrixType& A, const ArrayType& scale)
+{
+    using cusp::system::detail::generic::scale_columns;
+
+    return scale_columns(thrust::detail::derived_cast(thrust::detail::strip_const(exec)), A, scale);
+}
+
+template <typename MatrixType, typename ArrayType>
+void scale_columns(MatrixType& A, const ArrayType& scale)
+{
+    using thrust::system::detail::generic::select_system;
+
+    typedef typename MatrixType::memory_space System1;
+    typedef typename ArrayType::memory_space  System2;
+
+    System1 system1;
+    System2 system2;
+
+    return cusp::scale_columns(select_system(system1,system2), A, scale);
+}
+
+template <typename DerivedPolicy, typename MatrixType, typename ArrayType1, typename ArrayType2>
+void equilibrate(const thrust::detail::execution_policy_base<DerivedPolicy> &exec,
+                 MatrixType& A, ArrayType1& row_scale, ArrayType2& column_scale,
+                 const equilibration_method method, const size_t max_sweeps)
+{
+    using cusp::system::detail::generic::equilibrate;
+
+    return equilibrate(thrust::detail::derived_cast(thrust::detail::strip_const(exec)), A, row_scale, column_scale, method, max_sweeps);
+}
+
+template <typename MatrixType, typename ArrayType1, typename ArrayType2>
+void equilibrate(MatrixType& A, ArrayType1& row_scale, ArrayType2& column_scale,
+                 const equilibration_method method, const size_t max_sweeps)
+{
+    using thrust::system::detail::generic::select_system;
+
+    typedef typename MatrixType::memory_space System1;
+    typedef typename ArrayType1::memory_space System2;
+
+    System1 system1;
+    System2 system2;
+
+    return cusp::equilibrate(select_system(system1,system2), A, row_scale, column_scale, method, max_sweeps);
+}
+
+} // end namespace cusp
@@ -0,0 +1,329 @@
+/*
+ *  Copyright 2008-2014 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include <cusp/exception.h>
+#include <cusp/memory.h>
+
+#include <thrust/detail/type_traits.h>
+
+#include <limits>
+
+namespace cusp
+{
+namespace detail
+{
+
+// the pointers and iterators of the containers in MemorySpace, so the
+// views have the types of the container views
+template <typename T, typename MemorySpace>
+typename cusp::array1d<T,MemorySpace>::view
+external_array_view(T* data, const size_t size)
+{
+    typedef typename cusp::array1d<T,MemorySpace>::pointer  Pointer;
+    typedef typename cusp::array1d<T,MemorySpace>::iterator Iterator;
+    typedef typename cusp::array1d<T,MemorySpace>::view     View;
+
+    Pointer first(data);
+
+    return View(Iterator(first), Iterator(first + size));
+}
+
+template <typename T, typename MemorySpace>
+typename cusp::array1d<T,MemorySpace>::const_view
+external_array_view(const T* data, const size_t size)
+{
+    typedef typename cusp::array1d<T,MemorySpace>::const_pointer  Pointer;
+    typedef typename cusp::array1d<T,MemorySpace>::const_iterator Iterator;
+    typedef typename cusp::array1d<T,MemorySpace>::const_view     View;
+
+    Pointer first(data);
+
+    return View(Iterator(first), Iterator(first + size));
+}
+
+// elements spanned by a dense matrix, the padding after the last row or
+// column is not referenced
+inline size_t external_extent(const size_t num_major, const size_t num_minor, const size_t pitch)
+{
+    return (num_major == 0 || num_minor == 0) ? 0 : pitch * (num_major - 1) + num_minor;
+}
+
+template <typename Orientation>
+size_t external_extent(const size_t num_rows, const size_t num_cols, const size_t pitch)
+{
+    if (thrust::detail::is_same<Orientation,cusp::column_major>::value)
+        return external_extent(num_cols, num_rows, pitch);
+    else
+        return external_extent(num_rows, num_cols, pitch);
+}
+
+template <typename T>
+int dlpack_code(void)
+{
+    typedef std::numeric_limits<T> limits;
+
+    if (!limits::is_specialized)
+        return cusp::DLPACK_COMPLEX;
+    else if (limits::is_integer)
+        return limits::is_signed ? cusp::DLPACK_INT : cusp::DLPACK_UINT;
+    else
+        return cusp::DLPACK_FLOAT;
+}
+
+template <typename MemorySpace>
+bool dlpack_accessible(const int device_type)
+{
+    if (thrust::detail::is_convertible<MemorySpace,cusp::device_memory>::value)
+    {
+#if THRUST_DEVICE_SYSTEM == THRUST_DEVICE_SYSTEM_CUDA
+        return device_type == cusp::DLPACK_CUDA || device_type == cusp::DLPACK_CUDA_MANAGED;
+#else
+        return device_type == cusp::DLPACK_CPU || device_type == cusp::DLPACK_CUDA_HOST;
+#endif
+    }
+
+    return device_type == cusp::DLPACK_CPU ||
+           device_type == cusp::DLPACK_CUDA_HOST ||
+           device_type == cusp::DLPACK_CUDA_MANAGED;
+}
+
+template <typename ValueType, typename MemorySpace, typename TensorType>
+ValueType* dlpack_data(const TensorType& tensor, const int ndim)
+{
+    if (int(tensor.ndim) != ndim)
+        throw cusp::invalid_input_exception("DLPack tensor has the wrong number of dimensions");
+
+    if (int(tensor.dtype.code) != dlpack_code<ValueType>() ||
+        size_t(tensor.dtype.bits) != 8 * sizeof(ValueType) ||
+        int(tensor.dtype.lanes) != 1)
+        throw cusp::invalid_input_exception("DLPack tensor type does not match the value type");
+
+    if (!dlpack_accessible<MemorySpace>(int(tensor.device.device_type)))
+        throw cusp::invalid_input_exception("DLPack tensor is not addressable in the memory space");
+
+    for (int d = 0; d < ndim; d++)
+        if (tensor.shape[d] < 0)
+            throw cusp::invalid_input_exception("DLPack tensor has a negative extent");
+
+    return reinterpret_cast<ValueType*>(static_cast<char*>(tensor.data) + tensor.byte_offset);
+}
+
+} // end namespace detail
+
+template <typename MemorySpace, typename T>
+typename cusp::array1d<T,MemorySpace>::view
+make_array1d_view(MemorySpace, T* data, const size_t size)
+{
+    return cusp::detail::external_array_view<T,MemorySpace>(data, size);
+}
+
+template <typename MemorySpace, typename T>
+typename cusp::array1d<T,MemorySpace>::const_view
+make_array1d_view(MemorySpace, const T* data, const size_t size)
+{
+    return cusp::detail::external_array_view<T,MemorySpace>(data, size);
+}
+
+template <typename MemorySpace, typename T, typename Orientation>
+typename cusp::array2d<T,MemorySpace,Orientation>::view
+make_array2d_view(MemorySpace, T* data,
+                  const size_t num_rows, const size_t num_cols, const size_t pitch,
+                  Orientation)
+{
+    typedef typename cusp::array2d<T,MemorySpace,Orientation>::view View;
+
+    const size_t minor = thrust::detail::is_same<Orientation,cusp::column_major>::value ? num_rows : num_cols;
+
+    if (pitch < minor)
+        throw cusp::invalid_input_exception("array2d pitch is smaller than the rows or columns");
+
+    return View(num_rows, num_cols, pitch,
+                cusp::detail::external_array_view<T,MemorySpace>(data,
+                    cusp::detail::external_extent<Orientation>(num_rows, num_cols, pitch)));
+}
+
+template <typename MemorySpace, typename IndexType, typename ValueType>
+typename cusp::csr_matrix<IndexType,ValueType,MemorySpace>::view
+make_csr_matrix_view(MemorySpace,
+                     const size_t num_rows, const size_t num_cols, const size_t num_entries,
+                     IndexType* row_offsets, IndexType* column_indices, ValueType* values)
+{
+    typedef typename cusp::csr_matrix<IndexType,ValueType,MemorySpace>::view View;
+
+    return View(num_rows, num_cols, num_entries,
+                cusp::detail::external_array_view<IndexType,MemorySpace>(row_offsets, num_rows + 1),
+                cusp::detail::external_array_view<IndexType,MemorySpace>(column_indices, num_entries),
+                cusp::detail::external_array_view<ValueType,MemorySpace>(values, num_entries));
+}
+
+template <typename MemorySpace, typename IndexType, typename ValueType>
+typename cusp::csr_matrix<IndexType,ValueType,MemorySpace>::const_view
+make_csr_matrix_view(MemorySpace,
+                     const size_t num_rows, const size_t num_cols, const size_t num_entries,
+                     const IndexType* row_offsets, const IndexType* column_indices, const ValueType* values)
+{
+    typedef typename cusp::csr_matrix<IndexType,ValueType,MemorySpace>::const_view View;
+
+    return View(num_rows, num_cols, num_entries,
+                cusp::detail::external_array_view<IndexType,MemorySpace>(row_offsets, num_rows + 1),
+                cusp::detail::external_array_view<IndexType,MemorySpace>(column_indices, num_entries),
+                cusp::detail::external_array_view<ValueType,MemorySpace>(values, num_entries));
+}
+
+template <typename MemorySpace, typename IndexType, typename ValueType>
+typename cusp::coo_matrix<IndexType,ValueType,MemorySpace>::view
+make_coo_matrix_view(MemorySpace,
+                     const size_t num_rows, const size_t num_cols, const size_t num_entries,
+                     IndexType* row_indices, IndexType* column_indices, ValueType* values)
+{
+    typedef typename cusp::coo_matrix<IndexType,ValueType,MemorySpace>::view View;
+
+    return View(num_rows, num_cols, num_entries,
+                cusp::detail::external_array_view<IndexType,MemorySpace>(row_indices, num_entries),
+                cusp::detail::external_array_view<IndexType,MemorySpace>(column_indices, num_entries),
+                cusp::detail::external_array_view<ValueType,MemorySpace>(values, num_entries));
+}
+
+template <typename MemorySpace, typename IndexType, typename ValueType>
+typename cusp::coo_matrix<IndexType,ValueType,MemorySpace>::const_view
+make_coo_matrix_view(MemorySpace,
+                     const size_t num_rows, const size_t num_cols, const size_t num_entries,
+                     const IndexType* row_indices, const IndexType* column_indices, const ValueType* values)
+{
+    typedef typename cusp::coo_matrix<IndexType,ValueType,MemorySpace>::const_view View;
+
+    return View(num_rows, num_cols, num_entries,
+                cusp::detail::external_array_view<IndexType,MemorySpace>(row_indices, num_entries),
+                cusp::detail::external_array_view<IndexType,MemorySpace>(column_indices, num_entries),
+                cusp::detail::external_array_view<ValueType,MemorySpace>(values, num_entries));
+}
+
+template <typename MemorySpace, typename IndexType, typename ValueType>
+typename cusp::ell_matrix<IndexType,ValueType,MemorySpace>::view
+make_ell_matrix_view(MemorySpace,
+                     const size_t num_rows, const size_t num_cols, const size_t num_entries,
+                     const size_t num_entries_per_row, const size_t pitch,
+                     IndexType* column_indices, ValueType* values)
+{
+    typedef cusp::ell_matrix<IndexType,ValueType,MemorySpace> Matrix;
+    typedef typename Matrix::view View;
+    typedef typename Matrix::column_indices_array_type::view IndexView;
+    typedef typename Matrix::values_array_type::view ValueView;
+
+    if (pitch < num_rows)
+        throw cusp::invalid_input_exception("ell_matrix pitch is smaller than the number of rows");
+
+    const size_t size = pitch * num_entries_per_row;
+
+    return View(num_rows, num_cols, num_entries,
+                IndexView(num_rows, num_entries_per_row, pitch,
+                          cusp::detail::external_array_view<IndexType,MemorySpace>(column_indices, size)),
+                ValueView(num_rows, num_entries_per_row, pitch,
+                          cusp::detail::external_array_view<ValueType,MemorySpace>(values, size)));
+}
+
+template <typename MemorySpace, typename IndexType, typename ValueType>
+typename cusp::ell_matrix<IndexType,ValueType,MemorySpace>::const_view
+make_ell_matrix_view(MemorySpace,
+                     const size_t num_rows, const size_t num_cols, const size_t num_entries,
+                     const size_t num_entries_per_row, const size_t pitch,
+                     const IndexType* column_indices, const ValueType* values)
+{
+    typedef cusp::ell_matrix<IndexType,ValueType,MemorySpace> Matrix;
+    typedef typename Matrix::const_view View;
+    typedef typename Matrix::column_indices_array_type::const_view IndexView;
+    typedef typename Matrix::values_array_type::const_view ValueView;
+
+    if (pitch < num_rows)
+        throw cusp::invalid_input_exception("ell_matrix pitch is smaller than the number of rows");
+
+    const size_t size = pitch * num_entries_per_row;
+
+    return View(num_rows, num_cols, num_entries,
+                IndexView(num_rows, num_entries_per_row, pitch,
+                          cusp::detail::external_array_view<IndexType,MemorySpace>(column_indices, size)),
+                ValueView(num_rows, num_entries_per_row, pitch,
+                          cusp::detail::external_array_view<ValueType,MemorySpace>(values, size)));
+}
+
+template <typename ValueType, typename MemorySpace, typename TensorType>
+typename cusp::array1d<ValueType,MemorySpace>::view
+import_array1d_view(const TensorType& tensor)
+{
+    ValueType* data = cusp::detail::dlpack_data<ValueType,MemorySpace>(tensor, 1);
+
+    const size_t size = tensor.shape[0];
+
+    if (tensor.strides != 0 && tensor.strides[0] != 1 && size > 1)
+        throw cusp::invalid_input_exception("DLPack tensor must be contiguous");
+
+    return cusp::detail::external_array_view<ValueType,MemorySpace>(data, size);
+}
+
+template <typename ValueType, typename MemorySpace, typename Orientation, typename TensorType>
+typename cusp::array2d<ValueType,MemorySpace,Orientation>::view
+import_array2d_view(const TensorType& tensor)
+{
+    ValueType* data = cusp::detail::dlpack_data<ValueType,MemorySpace>(tensor, 2);
+
+    const size_t num_rows = tensor.shape[0];
+    const size_t num_cols = tensor.shape[1];
+
+    // strides are counted in elements, none means C order
+    const bool column_major = thrust::detail::is_same<Orientation,cusp::column_major>::value;
+
+    const size_t major = column_major ? 1 : 0;
+    const size_t minor = column_major ? 0 : 1;
+    const size_t num_minor = column_major ? num_rows : num_cols;
+
+    size_t pitch = num_minor;
+
+    if (tensor.strides != 0)
+    {
+        if (tensor.strides[minor] != 1 && num_minor > 1)
+            throw cusp::invalid_input_exception("DLPack tensor must be contiguous along the rows or columns of the orientation");
+
+        pitch = tensor.strides[major];
+    }
+    else if (column_major && num_rows > 1 && num_cols > 1)
+    {
+        throw cusp::invalid_input_exception("DLPack tensor must be contiguous along the rows or columns of the orientation");
+    }
+
+    return cusp::make_array2d_view(MemorySpace(), data, num_rows, num_cols, pitch, Orientation());
+}
+
+template <typename IndexType, typename ValueType, typename MemorySpace, typename TensorType>
+typename cusp::csr_matrix<IndexType,ValueType,MemorySpace>::view
+import_csr_matrix_view(const size_t num_rows, const size_t num_cols,
+                       const TensorType& row_offsets,
+                       const TensorType& column_indices,
+                       const TensorType& values)
+{
+    typename cusp::array1d<IndexType,MemorySpace>::view offsets_view = import_array1d_view<IndexType,MemorySpace>(row_offsets);
+    typename cusp::array1d<IndexType,MemorySpace>::view indices_view = import_array1d_view<IndexType,MemorySpace>(column_indices);
+    typename cusp::array1d<ValueType,MemorySpace>::view values_view  = import_array1d_view<ValueType,MemorySpace>(values);
+
+    if (offsets_view.size() != num_rows + 1 || indices_view.size() != values_view.size())
+        throw cusp::invalid_input_exception("DLPack CSR tensors have inconsistent lengths");
+
+    typedef typename cusp::csr_matrix<IndexType,ValueType,MemorySpace>::view View;
+
+    return View(num_rows, num_cols, values_view.size(),
+                offsets_view, indices_view, values_view);
+}
+
+} // end namespace cusp
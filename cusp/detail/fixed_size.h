@@ -0,0 +1,309 @@
+/*
+ *  Copyright 2008-2014 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*! \file fixed_size.h
+ *  \brief Small dense kernels for block sizes known at compile time
+ */
+
+#pragma once
+
+#include <cusp/detail/config.h>
+
+#include <cusp/complex.h>
+
+#include <cmath>
+#include <cstddef>
+
+namespace cusp
+{
+namespace detail
+{
+namespace fixed_size
+{
+
+// The kernels below follow the recursive templates of
+// cusp/system/detail/sequential/reference/fixed_size.h, but run on the host
+// and the device. Every size is a template argument, so the recursions
+// expand into straight-line code and the loops have constant trip counts
+// that the compilers unroll, keeping small blocks in registers. Matrices
+// are stored row-major; iterators may be raw pointers or any random access
+// iterator.
+
+// smallest and largest block size instantiated by dispatch_block_size
+const size_t MIN_BLOCK_SIZE = 2;
+const size_t MAX_BLOCK_SIZE = 8;
+
+/*
+ *  Dot product accumulated into sum, sum = reduce(sum, combine(X[i*SX], Y[i*SY])),
+ *  the strides let gemm walk the columns of B
+ */
+template <size_t N, size_t SX, size_t SY>
+struct _dot
+{
+    template <typename Iterator1, typename Iterator2, typename T, typename BinaryFunction1, typename BinaryFunction2>
+    __host__ __device__
+    static T apply(Iterator1 X, Iterator2 Y, T sum, BinaryFunction1 combine, BinaryFunction2 reduce)
+    {
+        return _dot<N - 1, SX, SY>::apply(X + SX, Y + SY, reduce(sum, combine(*X, *Y)), combine, reduce);
+    }
+};
+
+template <size_t SX, size_t SY>
+struct _dot<0, SX, SY>
+{
+    template <typename Iterator1, typename Iterator2, typename T, typename BinaryFunction1, typename BinaryFunction2>
+    __host__ __device__
+    static T apply(Iterator1, Iterator2, T sum, BinaryFunction1, BinaryFunction2)
+    {
+        return sum;
+    }
+};
+
+template <typename T>
+struct _multiplies
+{
+    __host__ __device__ T operator()(const T& a, const T& b) const { return a * b; }
+};
+
+template <typename T>
+struct _plus
+{
+    __host__ __device__ T operator()(const T& a, const T& b) const { return a + b; }
+};
+
+template <size_t N, typename Iterator1, typename Iterator2, typename T, typename BinaryFunction1, typename BinaryFunction2>
+__host__ __device__
+T dot(Iterator1 X, Iterator2 Y, T sum, BinaryFunction1 combine, BinaryFunction2 reduce)
+{
+    return _dot<N, 1, 1>::apply(X, Y, sum, combine, reduce);
+}
+
+template <size_t N, typename Iterator1, typename Iterator2, typename T>
+__host__ __device__
+T dot(Iterator1 X, Iterator2 Y, T sum)
+{
+    return _dot<N, 1, 1>::apply(X, Y, sum, _multiplies<T>(), _plus<T>());
+}
+
+/*
+ *  Matrix vector product Y[r] = reduce(Y[r], combine(A[r,c], X[c])) for an
+ *  M x N matrix A
+ */
+template <size_t M, size_t N>
+struct _gemv
+{
+    template <typename Iterator1, typename Iterator2, typename T, typename BinaryFunction1, typename BinaryFunction2>
+    __host__ __device__
+    static void apply(Iterator1 A, Iterator2 X, T * Y, BinaryFunction1 combine, BinaryFunction2 reduce)
+    {
+        *Y = dot<N>(A, X, *Y, combine, reduce);
+        _gemv<M - 1, N>::apply(A + N, X, Y + 1, combine, reduce);
+    }
+};
+
+template <size_t N>
+struct _gemv<0, N>
+{
+    template <typename Iterator1, typename Iterator2, typename T, typename BinaryFunction1, typename BinaryFunction2>
+    __host__ __device__
+    static void apply(Iterator1, Iterator2, T *, BinaryFunction1, BinaryFunction2) {}
+};
+
+template <size_t M, size_t N, typename Iterator1, typename Iterator2, typename T, typename BinaryFunction1, typename BinaryFunction2>
+__host__ __device__
+void gemv(Iterator1 A, Iterator2 X, T * Y, BinaryFunction1 combine, BinaryFunction2 reduce)
+{
+    _gemv<M, N>::apply(A, X, Y, combine, reduce);
+}
+
+// Y += A * X
+template <size_t M, size_t N, typename Iterator1, typename Iterator2, typename T>
+__host__ __device__
+void gemv(Iterator1 A, Iterator2 X, T * Y)
+{
+    _gemv<M, N>::apply(A, X, Y, _multiplies<T>(), _plus<T>());
+}
+
+// C += A * B, where C is L x N, A is L x M and B is M x N
+template <size_t L, size_t M, size_t N, typename Iterator1, typename Iterator2, typename T>
+__host__ __device__
+void gemm(Iterator1 A, Iterator2 B, T * C)
+{
+    for(size_t i = 0; i < L; i++)
+        for(size_t j = 0; j < N; j++)
+            C[i * N + j] = _dot<M, 1, N>::apply(A + i * M, B + j, C[i * N + j], _multiplies<T>(), _plus<T>());
+}
+
+/*
+ *  Inverse of an N x N matrix by Gauss-Jordan elimination with partial
+ *  pivoting. A is overwritten, the result is false when A is singular, in
+ *  which case Ainv holds the identity.
+ */
+template <size_t N, typename T>
+__host__ __device__
+bool invert(T * A, T * Ainv)
+{
+    for(size_t i = 0; i < N; i++)
+        for(size_t j = 0; j < N; j++)
+            Ainv[i * N + j] = (i == j) ? T(1) : T(0);
+
+    for(size_t k = 0; k < N; k++)
+    {
+        // largest remaining entry of column k
+        size_t pivot = k;
+        for(size_t i = k + 1; i < N; i++)
+            if(cusp::abs(A[i * N + k]) > cusp::abs(A[pivot * N + k]))
+                pivot = i;
+
+        if(A[pivot * N + k] == T(0))
+        {
+            for(size_t i = 0; i < N; i++)
+                for(size_t j = 0; j < N; j++)
+                    Ainv[i * N + j] = (i == j) ? T(1) : T(0);
+
+            return false;
+        }
+
+        if(pivot != k)
+        {
+            for(size_t j = 0; j < N; j++)
+            {
+                T a = A[k * N + j];    A[k * N + j]    = A[pivot * N + j];    A[pivot * N + j]    = a;
+                T b = Ainv[k * N + j]; Ainv[k * N + j] = Ainv[pivot * N + j]; Ainv[pivot * N + j] = b;
+            }
+        }
+
+        const T scale = T(1) / A[k * N + k];
+
+        for(size_t j = 0; j < N; j++)
+        {
+            A[k * N + j]    *= scale;
+            Ainv[k * N + j] *= scale;
+        }
+
+        for(size_t i = 0; i < N; i++)
+        {
+            if(i == k)
+                continue;
+
+            const T factor = A[i * N + k];
+
+            for(size_t j = 0; j < N; j++)
+            {
+                A[i * N + j]    -= factor * A[k * N + j];
+                Ainv[i * N + j] -= factor * Ainv[k * N + j];
+            }
+        }
+    }
+
+    return true;
+}
+
+/*
+ *  Thin QR factorization of a num_rows x N matrix A with N known at compile
+ *  time by modified Gram-Schmidt. A is overwritten by Q and R receives the
+ *  N x N upper triangular factor. Columns that are linearly dependent on
+ *  the previous ones, up to the relative tolerance, are set to zero together
+ *  with their diagonal entry of R. Returns the rank of A.
+ */
+template <size_t N, typename Iterator, typename T>
+__host__ __device__
+size_t qr(Iterator A, const size_t num_rows, T * R, const typename cusp::norm_type<T>::type tolerance = 1e-10)
+{
+    typedef typename cusp::norm_type<T>::type Real;
+
+    size_t rank = 0;
+
+    for(size_t i = 0; i < N * N; i++)
+        R[i] = T(0);
+
+    for(size_t k = 0; k < N; k++)
+    {
+        Real original = 0;
+        for(size_t i = 0; i < num_rows; i++)
+        {
+            const Real a = cusp::abs(T(A[i * N + k]));
+            original += a * a;
+        }
+
+        // remove the components along the previous columns
+        for(size_t j = 0; j < k; j++)
+        {
+            T r = T(0);
+            for(size_t i = 0; i < num_rows; i++)
+                r += cusp::conj(T(A[i * N + j])) * T(A[i * N + k]);
+
+            R[j * N + k] = r;
+
+            for(size_t i = 0; i < num_rows; i++)
+                A[i * N + k] = T(A[i * N + k]) - r * T(A[i * N + j]);
+        }
+
+        Real remaining = 0;
+        for(size_t i = 0; i < num_rows; i++)
+        {
+            const Real a = cusp::abs(T(A[i * N + k]));
+            remaining += a * a;
+        }
+
+        if(remaining == Real(0) || remaining <= tolerance * tolerance * original)
+        {
+            for(size_t i = 0; i < num_rows; i++)
+                A[i * N + k] = T(0);
+
+            continue;
+        }
+
+        using thrust::sqrt;
+        using std::sqrt;
+
+        const Real length = sqrt(remaining);
+
+        R[k * N + k] = length;
+
+        for(size_t i = 0; i < num_rows; i++)
+            A[i * N + k] = T(A[i * N + k]) / length;
+
+        rank++;
+    }
+
+    return rank;
+}
+
+/*
+ *  Calls f.template apply<N>() for the compile-time N equal to the runtime
+ *  block size n, MIN_BLOCK_SIZE <= n <= MAX_BLOCK_SIZE. Returns false when
+ *  n has no instantiation, leaving the fallback to the caller.
+ */
+template <typename Function>
+bool dispatch_block_size(const size_t n, Function& f)
+{
+    switch(n)
+    {
+        case 2: f.template apply<2>(); return true;
+        case 3: f.template apply<3>(); return true;
+        case 4: f.template apply<4>(); return true;
+        case 5: f.template apply<5>(); return true;
+        case 6: f.template apply<6>(); return true;
+        case 7: f.template apply<7>(); return true;
+        case 8: f.template apply<8>(); return true;
+        default: return false;
+    }
+}
+
+} // end namespace fixed_size
+} // end namespace detail
+} // end namespace cusp
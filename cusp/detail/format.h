@@ -42,6 +42,11 @@ struct csr_format         : public sparse_format {};
 struct dia_format         : public sparse_format {};
 struct ell_format         : public sparse_format {};
 struct hyb_format         : public sparse_format {};
+struct sell_format        : public sparse_format {};
+struct dcsr_format        : public sparse_format {};
+struct dynamic_csr_format : public sparse_format {};
+struct symmetric_format   : public sparse_format {};
+struct bsr_format         : public sparse_format {};
 
 template<typename is_transpose>
 struct orientation {
@@ -21,6 +21,11 @@
 #include <cusp/complex.h>
 #include <cusp/linear_operator.h>
 
+#include <cusp/detail/num_bytes.h>
+
+#include <thrust/for_each.h>
+#include <thrust/iterator/counting_iterator.h>
+
 #include <cmath>
 
 namespace cusp
@@ -151,8 +156,114 @@ public:
     {
         lu_solve(lu, pivot, x, y);
     }
+
+    // storage of the dense factors
+    friend size_t operator_bytes(const lu_solver& M)
+    {
+        return num_bytes(M.lu) + num_bytes(M.pivot);
+    }
+};
+
+// y[i] = sum_j inverse(i,j) * x[j] with one thread per row, the inverse is
+// stored column-major so adjacent rows read adjacent entries
+template <typename ValueType>
+struct inverse_solve_functor
+{
+    int num_cols;
+    int pitch;
+    const ValueType * inverse;
+    const ValueType * x;
+    ValueType * y;
+
+    inverse_solve_functor(int num_cols, int pitch, const ValueType * inverse, const ValueType * x, ValueType * y)
+        : num_cols(num_cols), pitch(pitch), inverse(inverse), x(x), y(y) {}
+
+    __host__ __device__
+    void operator()(const int i) const
+    {
+        ValueType sum = ValueType(0);
+
+        for (int j = 0; j < num_cols; j++)
+            sum += inverse[j * pitch + i] * x[j];
+
+        y[i] = sum;
+    }
+};
+
+// Coarse grid solver that factors A once on the host and keeps the explicit
+// inverse in MemorySpace, so every solve is a single matrix vector product
+// in the memory space of the hierarchy instead of a copy to the host, two
+// triangular solves and a copy back.  Singular matrices yield the same
+// (partial) solution as lu_solver.
+template <typename ValueType, typename MemorySpace>
+class inverse_solver : public cusp::linear_operator<ValueType,MemorySpace>
+{
+private:
+    typedef cusp::linear_operator<ValueType,MemorySpace> Parent;
+
+public:
+    cusp::array2d<ValueType,MemorySpace,cusp::column_major> inverse;
+
+    inverse_solver()
+        : linear_operator<ValueType,MemorySpace>()
+    { }
+
+    template <typename ValueType2, typename MemorySpace2>
+    inverse_solver(const inverse_solver<ValueType2,MemorySpace2>& M)
+        : Parent(M.num_rows, M.num_cols, M.num_entries), inverse(M.inverse)
+    { }
+
+    template <typename MatrixType>
+    inverse_solver(const MatrixType& A)
+        : Parent(A.num_rows, A.num_cols, A.num_entries)
+    {
+        const int n = A.num_rows;
+
+        cusp::array2d<ValueType,cusp::host_memory> lu(A);
+        cusp::array1d<int,cusp::host_memory> pivot(n);
+        lu_factor(lu,pivot);
+
+        cusp::array2d<ValueType,cusp::host_memory,cusp::column_major> inv(n, n);
+        cusp::array1d<ValueType,cusp::host_memory> e(n, ValueType(0));
+        cusp::array1d<ValueType,cusp::host_memory> column(n);
+
+        // column j of the inverse solves A x = e_j
+        for (int j = 0; j < n; j++)
+        {
+            e[j] = ValueType(1);
+            lu_solve(lu, pivot, e, column);
+            e[j] = ValueType(0);
+
+            for (int i = 0; i < n; i++)
+                inv(i,j) = column[i];
+        }
+
+        inverse = inv;
+    }
+
+    template <typename VectorType1, typename VectorType2>
+    void operator()(const VectorType1& x, VectorType2& y) const
+    {
+        if (inverse.num_rows == 0)
+            return;
+
+        MemorySpace system;
+
+        thrust::for_each(system,
+                         thrust::counting_iterator<int>(0),
+                         thrust::counting_iterator<int>(inverse.num_rows),
+                         inverse_solve_functor<ValueType>(inverse.num_cols, inverse.pitch,
+                                                          thrust::raw_pointer_cast(&inverse.values[0]),
+                                                          thrust::raw_pointer_cast(&x[0]),
+                                                          thrust::raw_pointer_cast(&y[0])));
+    }
+
+    // storage of the dense inverse
+    friend size_t operator_bytes(const inverse_solver& M)
+    {
+        return num_bytes(M.inverse);
+    }
 };
 
 } // end namespace detail
 } // end namespace cusp
-
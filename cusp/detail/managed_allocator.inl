@@ -0,0 +1,67 @@
+/*
+ *  Copyright 2008-2014 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+
+#include <thrust/memory.h>
+
+#include <new>
+
+#if THRUST_DEVICE_SYSTEM == THRUST_DEVICE_SYSTEM_CUDA
+#include <cuda_runtime_api.h>
+#endif
+
+namespace cusp
+{
+
+template <typename T>
+typename managed_allocator<T>::pointer
+managed_allocator<T>
+::allocate(size_type num_elements)
+{
+#if THRUST_DEVICE_SYSTEM == THRUST_DEVICE_SYSTEM_CUDA
+    if(num_elements == 0)
+        return pointer(static_cast<T*>(0));
+
+    void* ptr = 0;
+
+    if(cudaMallocManaged(&ptr, num_elements * sizeof(T), cudaMemAttachGlobal) != cudaSuccess)
+    {
+        // clear the error state of the runtime
+        cudaGetLastError();
+        throw std::bad_alloc();
+    }
+
+    return pointer(static_cast<T*>(ptr));
+#else
+    return Parent::allocate(num_elements);
+#endif
+}
+
+template <typename T>
+void managed_allocator<T>
+::deallocate(pointer ptr, size_type num_elements)
+{
+#if THRUST_DEVICE_SYSTEM == THRUST_DEVICE_SYSTEM_CUDA
+    T* raw_ptr = thrust::raw_pointer_cast(ptr);
+
+    if(raw_ptr != 0)
+        cudaFree(raw_ptr);
+#else
+    Parent::deallocate(ptr, num_elements);
+#endif
+}
+
+} // end namespace cusp
@@ -0,0 +1,113 @@
+/*
+ *  Copyright 2008-2014 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+
+#include <cusp/detail/config.h>
+
+#include <cusp/exception.h>
+
+#include <cusp/system/detail/adl/matrix_powers.h>
+#include <cusp/system/detail/generic/matrix_powers.h>
+
+#include <thrust/system/detail/generic/select_system.h>
+
+namespace cusp
+{
+
+template <typename DerivedPolicy,
+          typename MatrixType,
+          typename ArrayType,
+          typename Array2dType>
+void matrix_powers(const thrust::detail::execution_policy_base<DerivedPolicy>& exec,
+                   const MatrixType& A,
+                   const ArrayType& x,
+                         Array2dType& V,
+                   const size_t s)
+{
+    typedef typename Array2dType::value_type ValueType;
+
+    // the monomial basis
+    cusp::array1d<ValueType,cusp::host_memory> shifts(s, ValueType(0));
+
+    cusp::matrix_powers(exec, A, x, V, shifts);
+}
+
+template <typename DerivedPolicy,
+          typename MatrixType,
+          typename ArrayType,
+          typename Array2dType,
+          typename ShiftType>
+void matrix_powers(const thrust::detail::execution_policy_base<DerivedPolicy>& exec,
+                   const MatrixType& A,
+                   const ArrayType& x,
+                         Array2dType& V,
+                   const cusp::array1d<ShiftType,cusp::host_memory>& shifts)
+{
+    using cusp::system::detail::generic::matrix_powers;
+
+    typedef typename MatrixType::format Format;
+
+    Format format;
+
+    if(A.num_rows != A.num_cols)
+        throw cusp::invalid_input_exception("matrix_powers requires a square matrix");
+
+    if(x.size() != A.num_rows || V.num_rows != A.num_rows || V.num_cols < shifts.size() + 1)
+        throw cusp::invalid_input_exception("matrix_powers basis dimensions do not match");
+
+    matrix_powers(thrust::detail::derived_cast(thrust::detail::strip_const(exec)), A, x, V, shifts, format);
+}
+
+template <typename MatrixType,
+          typename ArrayType,
+          typename Array2dType>
+void matrix_powers(const MatrixType& A,
+                   const ArrayType& x,
+                         Array2dType& V,
+                   const size_t s)
+{
+    using thrust::system::detail::generic::select_system;
+
+    typedef typename MatrixType::memory_space  System1;
+    typedef typename Array2dType::memory_space System2;
+
+    System1 system1;
+    System2 system2;
+
+    cusp::matrix_powers(select_system(system1,system2), A, x, V, s);
+}
+
+template <typename MatrixType,
+          typename ArrayType,
+          typename Array2dType,
+          typename ShiftType>
+void matrix_powers(const MatrixType& A,
+                   const ArrayType& x,
+                         Array2dType& V,
+                   const cusp::array1d<ShiftType,cusp::host_memory>& shifts)
+{
+    using thrust::system::detail::generic::select_system;
+
+    typedef typename MatrixType::memory_space  System1;
+    typedef typename Array2dType::memory_space System2;
+
+    System1 system1;
+    System2 system2;
+
+    cusp::matrix_powers(select_system(system1,system2), A, x, V, shifts);
+}
+
+} // end namespace cusp
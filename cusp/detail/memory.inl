@@ -14,22 +14,68 @@
  *  limitations under the License.
  */
 
+#include <cusp/managed_allocator.h>
+#include <cusp/numa_allocator.h>
+#include <cusp/pinned_allocator.h>
+#include <cusp/tracking_allocator.h>
+
 #include <memory>
 
 #include <thrust/device_allocator.h>
 #include <thrust/device_malloc_allocator.h>
 #include <thrust/iterator/iterator_traits.h>
 
+#ifndef CUSP_NUMA_ALLOCATOR
+#if THRUST_HOST_SYSTEM == THRUST_HOST_SYSTEM_OMP
+#define CUSP_NUMA_ALLOCATOR 1
+#else
+#define CUSP_NUMA_ALLOCATOR 0
+#endif
+#endif
+
 namespace cusp
 {
+namespace detail
+{
+
+template<typename T>
+struct host_memory_allocator
+{
+#if CUSP_NUMA_ALLOCATOR
+    typedef cusp::numa_allocator<T> type;
+#else
+    typedef std::allocator<T> type;
+#endif
+};
 
 template<typename T, typename MemorySpace>
-struct default_memory_allocator
+struct system_memory_allocator
         : thrust::detail::eval_if<
         thrust::detail::is_same<MemorySpace, host_memory>::value,
-        thrust::detail::identity_< std::allocator<T> >,
+        cusp::detail::host_memory_allocator<T>,
+        thrust::detail::eval_if<
+        thrust::detail::is_same<MemorySpace, pinned_memory>::value,
+        thrust::detail::identity_< cusp::pinned_allocator<T> >,
+        thrust::detail::eval_if<
+        thrust::detail::is_same<MemorySpace, managed_memory>::value,
+        thrust::detail::identity_< cusp::managed_allocator<T> >,
         thrust::detail::identity_< thrust::device_malloc_allocator<T> >
+        > // if managed
+        > // if pinned
+        > // if host
+{};
+
+} // end namespace detail
+
+template<typename T, typename MemorySpace>
+struct default_memory_allocator
+#if CUSP_MEMORY_TRACKING
+        : thrust::detail::identity_<
+        cusp::tracking_allocator<typename cusp::detail::system_memory_allocator<T,MemorySpace>::type, MemorySpace>
         >
+#else
+        : cusp::detail::system_memory_allocator<T,MemorySpace>
+#endif
 {};
 
 template <typename MemorySpace1, typename MemorySpace2, typename MemorySpace3, typename MemorySpace4>
@@ -40,3 +86,6 @@ struct minimum_space
 
 } // end namespace cusp
 
+#if CUSP_MEMORY_TRACKING
+#include <cusp/memory_tracker.h>
+#endif
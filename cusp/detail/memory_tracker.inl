@@ -0,0 +1,379 @@
+/*
+ *  Copyright 2008-2014 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+
+#include <thrust/detail/type_traits.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <vector>
+
+#if __cplusplus >= 201103L
+#include <mutex>
+#endif
+
+namespace cusp
+{
+namespace detail
+{
+
+enum tracked_memory_space
+{
+    tracked_host_memory,
+    tracked_pinned_memory,
+    tracked_device_memory,
+    tracked_managed_memory,
+    num_tracked_memory_spaces
+};
+
+// the spaces follow the allocators chosen by default_memory_allocator
+template <typename MemorySpace>
+struct tracked_space_index
+{
+    static const int value =
+        thrust::detail::is_same<MemorySpace, cusp::pinned_memory>::value  ? tracked_pinned_memory  :
+        thrust::detail::is_same<MemorySpace, cusp::managed_memory>::value ? tracked_managed_memory :
+        thrust::detail::is_same<MemorySpace, cusp::host_memory>::value    ? tracked_host_memory    :
+                                                                            tracked_device_memory;
+};
+
+inline const char* tracked_space_name(const int space)
+{
+    static const char* names[num_tracked_memory_spaces] = { "host", "pinned", "device", "managed" };
+    return names[space];
+}
+
+struct memory_operation
+{
+    const char* name;
+    size_t      index;
+    bool        has_index;
+    size_t      token;
+
+    std::string label(void) const
+    {
+        if (!has_index)
+            return name;
+
+        char suffix[32];
+        std::sprintf(suffix, " %lu", (unsigned long) index);
+        return std::string(name) + suffix;
+    }
+};
+
+struct memory_space_record
+{
+    memory_statistics                        total;
+    std::map<std::string, memory_statistics> operations;
+};
+
+inline memory_space_record* get_memory_records(void)
+{
+    static memory_space_record records[num_tracked_memory_spaces];
+    return records;
+}
+
+#if __cplusplus >= 201103L
+inline std::mutex& get_memory_tracker_mutex(void)
+{
+    static std::mutex m;
+    return m;
+}
+#endif
+
+// the operations active on the calling thread, outermost first
+inline std::vector<memory_operation>& get_memory_operations(void)
+{
+#if __cplusplus >= 201103L
+    static thread_local std::vector<memory_operation> operations;
+#else
+    static std::vector<memory_operation> operations;
+#endif
+    return operations;
+}
+
+inline size_t push_memory_operation(const char* name, const size_t index, const bool has_index)
+{
+#if __cplusplus >= 201103L
+    static thread_local size_t next_token = 0;
+#else
+    static size_t next_token = 0;
+#endif
+
+    memory_operation op;
+    op.name      = name;
+    op.index     = index;
+    op.has_index = has_index;
+    op.token     = next_token++;
+
+    get_memory_operations().push_back(op);
+
+    return op.token;
+}
+
+// scopes of profiler ranges may end out of order, e.g. when a timer is
+// restarted, so the operation is looked up by its token
+inline void pop_memory_operation(const size_t token)
+{
+    std::vector<memory_operation>& operations = get_memory_operations();
+
+    for (size_t i = operations.size(); i > 0; i--)
+    {
+        if (operations[i - 1].token == token)
+        {
+            operations.erase(operations.begin() + (i - 1));
+            return;
+        }
+    }
+}
+
+inline std::string memory_operation_path(const std::vector<memory_operation>& operations)
+{
+    std::string path;
+
+    for (size_t i = 0; i < operations.size(); i++)
+    {
+        if (i > 0)
+            path += " / ";
+
+        path += operations[i].label();
+    }
+
+    return path;
+}
+
+inline void record_memory_allocation(const int space, const size_t num_bytes)
+{
+    const std::vector<memory_operation>& operations = get_memory_operations();
+
+#if __cplusplus >= 201103L
+    std::lock_guard<std::mutex> lock(get_memory_tracker_mutex());
+#endif
+
+    memory_space_record& record = get_memory_records()[space];
+    memory_statistics& total = record.total;
+
+    total.current_bytes   += num_bytes;
+    total.allocated_bytes += num_bytes;
+    total.allocations++;
+
+    if (total.current_bytes > total.peak_bytes)
+    {
+        total.peak_bytes     = total.current_bytes;
+        total.peak_operation = memory_operation_path(operations);
+    }
+
+    // the allocation is counted by the innermost operation, every active
+    // operation sees the usage of the whole space
+    for (size_t i = 0; i < operations.size(); i++)
+    {
+        memory_statistics& op = record.operations[operations[i].label()];
+
+        if (i + 1 == operations.size())
+        {
+            op.allocated_bytes += num_bytes;
+            op.allocations++;
+        }
+
+        if (total.current_bytes > op.peak_bytes)
+        {
+            op.peak_bytes     = total.current_bytes;
+            op.peak_operation = memory_operation_path(operations);
+        }
+    }
+}
+
+inline void record_memory_deallocation(const int space, const size_t num_bytes)
+{
+#if __cplusplus >= 201103L
+    std::lock_guard<std::mutex> lock(get_memory_tracker_mutex());
+#endif
+
+    memory_statistics& total = get_memory_records()[space].total;
+
+    // storage allocated before a reset may be released after it
+    total.current_bytes -= std::min(num_bytes, total.current_bytes);
+}
+
+inline void record_memory_failure(const int space, const size_t num_bytes)
+{
+    const std::vector<memory_operation>& operations = get_memory_operations();
+    const std::string path = memory_operation_path(operations);
+
+#if __cplusplus >= 201103L
+    std::lock_guard<std::mutex> lock(get_memory_tracker_mutex());
+#endif
+
+    memory_space_record& record = get_memory_records()[space];
+
+    record.total.failed_allocations++;
+    record.total.failed_operation = path;
+
+    if (!operations.empty())
+    {
+        memory_statistics& op = record.operations[operations.back().label()];
+        op.failed_allocations++;
+        op.failed_operation = path;
+    }
+
+    (void) num_bytes;
+}
+
+template <typename MemorySpace>
+void record_allocation(const size_t num_bytes)
+{
+    record_memory_allocation(tracked_space_index<MemorySpace>::value, num_bytes);
+}
+
+template <typename MemorySpace>
+void record_deallocation(const size_t num_bytes)
+{
+    record_memory_deallocation(tracked_space_index<MemorySpace>::value, num_bytes);
+}
+
+template <typename MemorySpace>
+void record_failed_allocation(const size_t num_bytes)
+{
+    record_memory_failure(tracked_space_index<MemorySpace>::value, num_bytes);
+}
+
+inline void write_memory_statistics_json(std::ostream& os, const memory_statistics& s)
+{
+    os << "\"current_bytes\": "      << s.current_bytes      << ", "
+       << "\"peak_bytes\": "         << s.peak_bytes         << ", "
+       << "\"allocated_bytes\": "    << s.allocated_bytes    << ", "
+       << "\"allocations\": "        << s.allocations        << ", "
+       << "\"failed_allocations\": " << s.failed_allocations << ", "
+       << "\"peak_operation\": \""   << s.peak_operation     << "\", "
+       << "\"failed_operation\": \"" << s.failed_operation   << "\"";
+}
+
+} // end namespace detail
+
+//////////////////
+// memory_scope //
+//////////////////
+
+inline
+memory_scope
+::memory_scope(const char* name)
+{
+#if CUSP_MEMORY_TRACKING
+    token = cusp::detail::push_memory_operation(name, 0, false);
+#else
+    (void) name;
+#endif
+}
+
+inline
+memory_scope
+::memory_scope(const char* name, const size_t index)
+{
+#if CUSP_MEMORY_TRACKING
+    token = cusp::detail::push_memory_operation(name, index, true);
+#else
+    (void) name;
+    (void) index;
+#endif
+}
+
+inline
+memory_scope
+::~memory_scope(void)
+{
+#if CUSP_MEMORY_TRACKING
+    cusp::detail::pop_memory_operation(token);
+#endif
+}
+
+/////////////
+// Queries //
+/////////////
+
+template <typename MemorySpace>
+memory_statistics memory_usage(void)
+{
+#if __cplusplus >= 201103L
+    std::lock_guard<std::mutex> lock(cusp::detail::get_memory_tracker_mutex());
+#endif
+
+    return cusp::detail::get_memory_records()[cusp::detail::tracked_space_index<MemorySpace>::value].total;
+}
+
+template <typename MemorySpace>
+std::map<std::string, memory_statistics> operation_memory_usage(void)
+{
+#if __cplusplus >= 201103L
+    std::lock_guard<std::mutex> lock(cusp::detail::get_memory_tracker_mutex());
+#endif
+
+    return cusp::detail::get_memory_records()[cusp::detail::tracked_space_index<MemorySpace>::value].operations;
+}
+
+inline void reset_memory_peaks(void)
+{
+#if __cplusplus >= 201103L
+    std::lock_guard<std::mutex> lock(cusp::detail::get_memory_tracker_mutex());
+#endif
+
+    for (int space = 0; space < cusp::detail::num_tracked_memory_spaces; space++)
+    {
+        cusp::detail::memory_space_record& record = cusp::detail::get_memory_records()[space];
+
+        const size_t current_bytes = record.total.current_bytes;
+
+        record.total = memory_statistics();
+        record.total.current_bytes = current_bytes;
+        record.total.peak_bytes    = current_bytes;
+
+        record.operations.clear();
+    }
+}
+
+inline void write_memory_usage_json(std::ostream& os)
+{
+#if __cplusplus >= 201103L
+    std::lock_guard<std::mutex> lock(cusp::detail::get_memory_tracker_mutex());
+#endif
+
+    typedef std::map<std::string, memory_statistics>::const_iterator Iterator;
+
+    os << "{";
+
+    for (int space = 0; space < cusp::detail::num_tracked_memory_spaces; space++)
+    {
+        const cusp::detail::memory_space_record& record = cusp::detail::get_memory_records()[space];
+
+        os << (space == 0 ? "\n" : ",\n");
+        os << "  \"" << cusp::detail::tracked_space_name(space) << "\": {";
+        cusp::detail::write_memory_statistics_json(os, record.total);
+        os << ", \"operations\": {";
+
+        for (Iterator iter = record.operations.begin(); iter != record.operations.end(); ++iter)
+        {
+            os << (iter == record.operations.begin() ? "\n" : ",\n");
+            os << "    \"" << iter->first << "\": {";
+            cusp::detail::write_memory_statistics_json(os, iter->second);
+            os << "}";
+        }
+
+        os << (record.operations.empty() ? "}}" : "\n  }}");
+    }
+
+    os << "\n}\n";
+}
+
+} // end namespace cusp
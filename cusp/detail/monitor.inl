@@ -16,6 +16,9 @@
 
 #include <cusp/blas/blas.h>
 
+#include <thrust/reduce.h>
+
+#include <algorithm>
 #include <limits>
 #include <iostream>
 #include <iomanip>
@@ -23,17 +26,99 @@
 namespace cusp
 {
 
+template <typename LinearOperator, typename MonitorType>
+template <typename DerivedPolicy, typename VectorType1, typename VectorType2>
+void
+monitored_operator<LinearOperator,MonitorType>
+::operator()(thrust::execution_policy<DerivedPolicy>& exec, const VectorType1& x, VectorType2& y) const
+{
+    double seconds = 0;
+
+    if (monitor.is_instrumented())
+    {
+        cusp::detail::timer t;
+        cusp::multiply(exec, A, x, y);
+        seconds = t.seconds_elapsed();
+    }
+    else
+    {
+        cusp::multiply(exec, A, x, y);
+    }
+
+    if (is_preconditioner)
+        monitor.record_preconditioner(seconds);
+    else
+        monitor.record_operator(seconds);
+}
+
+template <typename LinearOperator, typename MonitorType>
+template <typename VectorType1, typename VectorType2>
+void
+monitored_operator<LinearOperator,MonitorType>
+::operator()(const VectorType1& x, VectorType2& y) const
+{
+    using thrust::system::detail::generic::select_system;
+
+    typedef typename VectorType1::memory_space System1;
+    typedef typename VectorType2::memory_space System2;
+
+    System1 system1;
+    System2 system2;
+
+    (*this)(select_system(system1,system2), x, y);
+}
+
 template <typename ValueType>
 template <typename VectorType>
 monitor<ValueType>
-::monitor(const VectorType& b, size_t iteration_limit, Real relative_tolerance, Real absolute_tolerance, bool verbose)
+::monitor(const VectorType& b, size_t iteration_limit, Real relative_tolerance, Real absolute_tolerance, bool verbose,
+          size_t check_interval)
     : b_norm(cusp::blas::nrm2(b)),
       r_norm(std::numeric_limits<Real>::max()),
       iteration_limit_(iteration_limit),
       iteration_count_(0),
+      check_interval_(check_interval > 0 ? check_interval : 1),
       relative_tolerance_(relative_tolerance),
       absolute_tolerance_(absolute_tolerance),
-      verbose(verbose)
+      verbose(verbose),
+      instrumented(false),
+      operator_applications_(0),
+      preconditioner_applications_(0),
+      operator_seconds_(0),
+      preconditioner_seconds_(0),
+      iteration_started(false)
+{
+    if(verbose)
+    {
+        std::cout << "Solver will continue until ";
+        std::cout << "residual norm " << relative_tolerance << " or reaching ";
+        std::cout << iteration_limit << " iterations " << std::endl;
+        std::cout << "  Iteration Number  | Residual Norm" << std::endl;
+    }
+
+    residuals.reserve(iteration_limit);
+}
+
+template <typename ValueType>
+template <typename DerivedPolicy, typename VectorType>
+monitor<ValueType>
+::monitor(const thrust::detail::execution_policy_base<DerivedPolicy>& exec,
+          const VectorType& b, size_t iteration_limit, Real relative_tolerance, Real absolute_tolerance, bool verbose,
+          size_t check_interval)
+    : b_norm(cusp::blas::nrm2(exec, b)),
+      r_norm(std::numeric_limits<Real>::max()),
+      iteration_limit_(iteration_limit),
+      iteration_count_(0),
+      check_interval_(check_interval > 0 ? check_interval : 1),
+      relative_tolerance_(relative_tolerance),
+      absolute_tolerance_(absolute_tolerance),
+      verbose(verbose),
+      instrumented(false),
+      operator_applications_(0),
+      preconditioner_applications_(0),
+      operator_seconds_(0),
+      preconditioner_seconds_(0),
+      iteration_started(false)
 {
     if(verbose)
     {
@@ -52,6 +137,9 @@ monitor<ValueType>
 ::operator++(void)
 {
     ++iteration_count_;
+
+    if (iteration_range.is_active())
+        iteration_range.start("cusp::monitor iteration", iteration_count_);
 }
 
 template <typename ValueType>
@@ -86,6 +174,22 @@ monitor<ValueType>
     return iteration_limit_;
 }
 
+template <typename ValueType>
+size_t
+monitor<ValueType>
+::check_interval(void) const
+{
+    return check_interval_;
+}
+
+template <typename ValueType>
+void
+monitor<ValueType>
+::set_check_interval(const size_t check_interval)
+{
+    check_interval_ = check_interval > 0 ? check_interval : 1;
+}
+
 template <typename ValueType>
 typename monitor<ValueType>::Real
 monitor<ValueType>
@@ -136,6 +240,32 @@ monitor<ValueType>
     r_norm = std::numeric_limits<Real>::max();
     iteration_count_ = 0;
     residuals.resize(0);
+    iteration_times.resize(0);
+    operator_applications_ = 0;
+    preconditioner_applications_ = 0;
+    operator_seconds_ = 0;
+    preconditioner_seconds_ = 0;
+    iteration_started = false;
+    iteration_range.stop();
+}
+
+template <typename ValueType>
+template <typename DerivedPolicy, typename Vector>
+void
+monitor<ValueType>
+::reset(const thrust::detail::execution_policy_base<DerivedPolicy>& exec, const Vector& b)
+{
+    b_norm = cusp::blas::nrm2(exec, b);
+    r_norm = std::numeric_limits<Real>::max();
+    iteration_count_ = 0;
+    residuals.resize(0);
+    iteration_times.resize(0);
+    operator_applications_ = 0;
+    preconditioner_applications_ = 0;
+    operator_seconds_ = 0;
+    preconditioner_seconds_ = 0;
+    iteration_started = false;
+    iteration_range.stop();
 }
 
 template <typename ValueType>
@@ -173,6 +303,128 @@ monitor<ValueType>
     std::cout << "geometric convergence factor : " << geometric_rate() << std::endl;
     std::cout << "immediate convergence factor : " << immediate_rate() << std::endl;
     std::cout << "average convergence factor   : " << average_rate() << std::endl;
+
+    print_instrumentation();
+}
+
+template <typename ValueType>
+void
+monitor<ValueType>
+::print_instrumentation(void) const
+{
+    if (operator_applications() == 0 && preconditioner_applications() == 0 && iteration_times.size() == 0)
+        return;
+
+    std::cout << "operator applications        : " << operator_applications() << std::endl;
+    std::cout << "preconditioner applications  : " << preconditioner_applications() << std::endl;
+
+    if (!is_instrumented())
+        return;
+
+    const double total = solve_seconds();
+    const double other = total - operator_seconds() - preconditioner_seconds();
+
+    std::cout << std::fixed << std::setprecision(3);
+    std::cout << "solve time                   : " << 1e3 * total << " ms";
+    if (iteration_times.size() > 0)
+        std::cout << " (" << 1e3 * total / iteration_times.size() << " ms per iteration)";
+    std::cout << std::endl;
+    std::cout << "  operator                   : " << 1e3 * operator_seconds() << " ms" << std::endl;
+    std::cout << "  preconditioner             : " << 1e3 * preconditioner_seconds() << " ms" << std::endl;
+    std::cout << "  other                      : " << 1e3 * std::max(other, 0.0) << " ms" << std::endl;
+    std::cout.unsetf(std::ios::floatfield);
+}
+
+template <typename ValueType>
+void
+monitor<ValueType>
+::set_instrumented(bool instrumented_)
+{
+    instrumented = instrumented_;
+}
+
+template <typename ValueType>
+bool
+monitor<ValueType>
+::is_instrumented(void) const
+{
+    return instrumented;
+}
+
+template <typename ValueType>
+template <typename LinearOperator>
+monitored_operator<LinearOperator, monitor<ValueType> >
+monitor<ValueType>
+::instrument_operator(const LinearOperator& A)
+{
+    return monitored_operator<LinearOperator, monitor>(A, *this, false);
+}
+
+template <typename ValueType>
+template <typename LinearOperator>
+monitored_operator<LinearOperator, monitor<ValueType> >
+monitor<ValueType>
+::instrument_preconditioner(const LinearOperator& M)
+{
+    return monitored_operator<LinearOperator, monitor>(M, *this, true);
+}
+
+template <typename ValueType>
+void
+monitor<ValueType>
+::record_operator(const double seconds)
+{
+    operator_applications_++;
+    operator_seconds_ += seconds;
+}
+
+template <typename ValueType>
+void
+monitor<ValueType>
+::record_preconditioner(const double seconds)
+{
+    preconditioner_applications_++;
+    preconditioner_seconds_ += seconds;
+}
+
+template <typename ValueType>
+size_t
+monitor<ValueType>
+::operator_applications(void) const
+{
+    return operator_applications_;
+}
+
+template <typename ValueType>
+size_t
+monitor<ValueType>
+::preconditioner_applications(void) const
+{
+    return preconditioner_applications_;
+}
+
+template <typename ValueType>
+double
+monitor<ValueType>
+::operator_seconds(void) const
+{
+    return operator_seconds_;
+}
+
+template <typename ValueType>
+double
+monitor<ValueType>
+::preconditioner_seconds(void) const
+{
+    return preconditioner_seconds_;
+}
+
+template <typename ValueType>
+double
+monitor<ValueType>
+::solve_seconds(void) const
+{
+    return thrust::reduce(iteration_times.begin(), iteration_times.end(), 0.0);
 }
 
 template <typename ValueType>
@@ -181,23 +433,52 @@ bool monitor<ValueType>
 ::finished(thrust::execution_policy<DerivedPolicy> &exec,
            const Vector& r)
 {
+    // every iteration is a profiler range from the first test until the
+    // solver has finished
+    if (!iteration_range.is_active())
+        iteration_range.start("cusp::monitor iteration", iteration_count());
+
+    // an iteration lasts from one call to the next, the first call only
+    // starts the clock
+    if (instrumented)
+    {
+        if (iteration_started)
+            iteration_times.push_back(iteration_timer.seconds_elapsed());
+
+        iteration_timer.restart();
+        iteration_started = true;
+    }
+
+    // skip the reduction between residual tests
+    if ((iteration_count() % check_interval()) != 0 && iteration_count() < iteration_limit())
+        return false;
+
     r_norm = cusp::blas::nrm2(exec, r);
     residuals.push_back(r_norm);
 
     if(verbose)
     {
         std::cout << "       "  << std::setw(10) << iteration_count();
-        std::cout << "       "  << std::setw(10) << std::scientific << residual_norm() << std::endl;
+        std::cout << "       "  << std::setw(10) << std::scientific << residual_norm();
+        if (instrumented && iteration_times.size() > 0)
+            std::cout << "       "  << std::setw(10) << std::fixed << std::setprecision(3)
+                      << 1e3 * iteration_times[iteration_times.size() - 1] << " ms";
+        std::cout << std::endl;
+        std::cout.unsetf(std::ios::floatfield);
     }
 
     if (converged())
     {
         if(verbose) std::cout << "Successfully converged after " << iteration_count() << " iterations." << std::endl;
+        if(verbose) print_instrumentation();
+        iteration_range.stop();
         return true;
     }
     else if (iteration_count() >= iteration_limit())
     {
         if(verbose) std::cout << "Failed to converge after " << iteration_count() << " iterations." << std::endl;
+        if(verbose) print_instrumentation();
+        iteration_range.stop();
         return true;
     }
     else
@@ -26,21 +26,33 @@
 #include <cusp/detail/type_traits.h>
 
 #include <cusp/array1d.h>
+#include <cusp/array2d.h>
 #include <cusp/linear_operator.h>
 
 #include <cusp/precond/smoother/jacobi_smoother.h>
 
 #include <thrust/detail/use_default.h>
 
+#include <string>
+#include <utility>
+#include <vector>
+
+#if __cplusplus >= 201103L
+#include <mutex>
+#endif
+
 namespace cusp
 {
+
+template <typename ValueType, typename MemorySpace, typename IndexType> class cholesky_solver;
+
 namespace detail
 {
   template <typename FormatType, typename MemorySpace>
   struct select_format_type
   {
     typedef typename thrust::detail::eval_if<
-        thrust::detail::is_same<MemorySpace, cusp::host_memory>::value
+        thrust::detail::is_convertible<MemorySpace, cusp::host_memory>::value
       , thrust::detail::identity_<cusp::csr_format>
       , thrust::detail::identity_<cusp::hyb_format>
       >::type DefaultFormat;
@@ -64,17 +76,62 @@ namespace detail
       >::type type;
   };
 
+  // same smoother template instantiated for another memory space
+  template <typename SmootherType, typename MemorySpace>
+  struct rebind_smoother_type
+  {
+    typedef SmootherType type;
+  };
+
+  template <template <typename,typename> class SmootherBase, typename ValueType, typename MemorySpace1, typename MemorySpace2>
+  struct rebind_smoother_type<SmootherBase<ValueType,MemorySpace1>, MemorySpace2>
+  {
+    typedef SmootherBase<ValueType,MemorySpace2> type;
+  };
+
   template <typename SolverType, typename ValueType, typename MemorySpace>
   struct select_solver_type
   {
-    typedef cusp::detail::lu_solver<ValueType,cusp::host_memory> LUSolver;
+    typedef cusp::detail::inverse_solver<ValueType,MemorySpace> InverseSolver;
 
     typedef typename thrust::detail::eval_if<
           thrust::detail::is_same<SolverType, thrust::use_default>::value
-        , thrust::detail::identity_<LUSolver>
+        , thrust::detail::identity_<InverseSolver>
         , thrust::detail::identity_<SolverType>
       >::type type;
   };
+
+  // the default solver and the sparse direct solver of a hierarchy copied
+  // to the host apply their factors on the host, other solvers are kept as
+  // they are
+  template <typename SolverType, typename MemorySpace>
+  struct rebind_solver_type
+  {
+    typedef SolverType type;
+  };
+
+  template <typename ValueType, typename MemorySpace1, typename MemorySpace2>
+  struct rebind_solver_type<cusp::detail::inverse_solver<ValueType,MemorySpace1>, MemorySpace2>
+  {
+    typedef cusp::detail::inverse_solver<ValueType,MemorySpace2> type;
+  };
+
+  template <typename ValueType, typename MemorySpace1, typename IndexType, typename MemorySpace2>
+  struct rebind_solver_type<cusp::cholesky_solver<ValueType,MemorySpace1,IndexType>, MemorySpace2>
+  {
+    typedef cusp::cholesky_solver<ValueType,MemorySpace2,IndexType> type;
+  };
+
+#if __cplusplus >= 201103L
+  // setup phases of a hierarchy may run on several threads, which record
+  // their times under this lock
+  inline std::mutex& get_setup_time_mutex(void)
+  {
+    static std::mutex mutex;
+    return mutex;
+  }
+#endif
+
 } // end detail namespace
 
 /*! \addtogroup iterative_solvers Iterative Solvers
@@ -83,6 +140,68 @@ namespace detail
  *  \{
  */
 
+/*! Cycle applied by a \p multilevel hierarchy. \c V_CYCLE visits every
+ *  coarse level once, \c W_CYCLE twice and \c F_CYCLE solves each coarse
+ *  level with an F-cycle followed by a V-cycle. \c K_CYCLE accelerates every
+ *  coarse level correction with two iterations of flexible conjugate
+ *  gradient preconditioned by the cycle on that level, which requires a
+ *  symmetric positive definite operator.
+ */
+typedef enum
+{
+    V_CYCLE,
+    W_CYCLE,
+    F_CYCLE,
+    K_CYCLE
+} cycle_type;
+
+/*! Size and storage of one level of a \p multilevel hierarchy. All sizes
+ *  are in bytes.
+ */
+struct multilevel_level_report
+{
+    size_t num_rows;        //!< rows of the level matrix
+    size_t num_entries;     //!< nonzeros of the level matrix
+    size_t A_bytes;         //!< level matrix
+    size_t P_bytes;         //!< prolongation to this level from the next
+    size_t R_bytes;         //!< restriction from this level to the next
+    size_t smoother_bytes;  //!< smoother data, zero for unknown smoothers
+    size_t vector_bytes;    //!< solution, right hand side and cycle workspace
+
+    //! seconds spent in every setup phase of this level, including the
+    //! coarsening to the next level, in order of first appearance
+    std::vector< std::pair<std::string,double> > setup_times;
+    double setup_seconds;
+
+    multilevel_level_report(void)
+      : num_rows(0), num_entries(0), A_bytes(0), P_bytes(0), R_bytes(0),
+        smoother_bytes(0), vector_bytes(0), setup_seconds(0) {}
+};
+
+/*! Complexity, memory and setup time of a \p multilevel hierarchy as
+ *  returned by \p multilevel::report.
+ */
+struct multilevel_report
+{
+    size_t num_levels;
+    double operator_complexity;
+    double grid_complexity;
+
+    std::vector<multilevel_level_report> levels;
+
+    size_t solver_bytes;    //!< coarse solver
+    size_t host_bytes;      //!< coarse levels agglomerated onto the host
+    size_t total_bytes;     //!< storage owned by the hierarchy
+
+    //! seconds spent in every setup phase, in order of first appearance
+    std::vector< std::pair<std::string,double> > setup_times;
+    double setup_seconds;
+
+    multilevel_report(void)
+      : num_levels(0), operator_complexity(0), grid_complexity(0),
+        solver_bytes(0), host_bytes(0), total_bytes(0), setup_seconds(0) {}
+};
+
 /*! \p multilevel : multilevel hierarchy
  *
  *
@@ -104,10 +223,17 @@ private:
     typedef typename detail::select_smoother_type<SmootherType,ValueType,MemorySpace>::type		Smoother;
     typedef typename detail::select_solver_type<SolverType,ValueType,MemorySpace>::type			  Solver;
 
+    typedef typename detail::rebind_smoother_type<Smoother,cusp::host_memory>::type HostSmoother;
+    typedef typename detail::rebind_solver_type<Solver,cusp::host_memory>::type     HostSolver;
+
+    template <typename,typename,typename,typename,typename,typename> friend class multilevel;
+
 public:
 
 	typedef cusp::multilevel<IndexType, ValueType, MemorySpace, MatrixFormat, Smoother, Solver>	container;
 
+	typedef cusp::multilevel<IndexType, ValueType, cusp::host_memory, cusp::csr_format, HostSmoother, HostSolver> host_container;
+
     /* \cond */
     struct level
     {
@@ -118,6 +244,13 @@ public:
         cusp::array1d<ValueType,MemorySpace> b;               // per-level rhs
         cusp::array1d<ValueType,MemorySpace> residual;        // per-level residual
 
+        // K-cycle workspace, allocated on first use
+        cusp::array1d<ValueType,MemorySpace> v1, v2, w1, w2, r2;
+
+        // block cycle solution, rhs and residual, allocated on first use
+        typedef cusp::array2d<ValueType,MemorySpace,cusp::column_major> block_type;
+        block_type block_x, block_b, block_residual;
+
         Smoother smoother;
 
         level(void) {}
@@ -134,16 +267,27 @@ public:
 
     size_t min_level_size;
     size_t max_levels;
+    size_t host_level_size;
+    cycle_type cycle;
 
     Solver solver;
 
     std::vector<level> levels;
 
-    multilevel(size_t min_level_size=500, size_t max_levels=10) : A_ptr(NULL), min_level_size(min_level_size), max_levels(max_levels) {};
+    multilevel(size_t min_level_size=500, size_t max_levels=10)
+      : A_ptr(NULL), min_level_size(min_level_size), max_levels(max_levels),
+        host_level_size(0), cycle(V_CYCLE), host_level(0) {};
 
     template <typename MemorySpace2, typename Format2, typename SmootherType2, typename SolverType2>
     multilevel(const multilevel<IndexType,ValueType,MemorySpace2,Format2,SmootherType2,SolverType2>& M);
 
+    /*! Apply one cycle to \p x. If \p x and \p y are \p array2d blocks
+     *  all columns are cycled together: the smoothing, residual, restriction
+     *  and prolongation of every level multiply whole blocks, so each
+     *  hierarchy matrix is read once per cycle for all vectors. Block
+     *  cycles require CSR, ELL or HYB level matrices, a K-cycle is applied
+     *  to the columns one at a time.
+     */
     template <typename Array1, typename Array2>
     void operator()(const Array1& x, Array2& y);
 
@@ -159,30 +303,84 @@ public:
 
     void set_max_levels(size_t max_depth);
 
+    void set_cycle(cycle_type cycle);
+
+    /*! Solve the coarse levels with fewer than \p size rows on the host
+     *  to avoid the kernel launch latency that dominates small levels on
+     *  the device. A \p size of 0 disables the agglomeration.
+     */
+    void set_host_level_size(size_t size);
+
     double operator_complexity( void );
 
     double grid_complexity( void );
 
+    /*! Collect the per-level sizes, the storage and the setup times of the
+     *  hierarchy. The finest level matrix is only included in
+     *  \c total_bytes if the hierarchy holds a copy of it.
+     */
+    multilevel_report report( void );
+
 protected:
 
     SolveMatrixType A;
 
     cusp::array1d<ValueType, MemorySpace> update;
     cusp::array1d<ValueType, MemorySpace> residual;
-    cusp::array1d<ValueType, cusp::host_memory> temp_b;
-    cusp::array1d<ValueType, cusp::host_memory> temp_x;
+    cusp::array1d<ValueType, typename Solver::memory_space> temp_b;
+    cusp::array1d<ValueType, typename Solver::memory_space> temp_x;
+
+    // copy of the levels from host_level on, empty if not agglomerated
+    size_t host_level;
+    std::vector<host_container> host_hierarchy;
+    cusp::array1d<ValueType, cusp::host_memory> host_b;
+    cusp::array1d<ValueType, cusp::host_memory> host_x;
+
+    // accumulated seconds of every setup phase, in total and per level
+    std::vector< std::pair<std::string,double> > setup_times;
+    std::vector< std::vector< std::pair<std::string,double> > > level_setup_times;
+
+    void add_setup_time(const std::string& phase, const double seconds);
+
+    void add_setup_time(const std::string& phase, const double seconds, const size_t lvl);
+
+    void clear_setup_times(void);
 
     template <typename Array1, typename Array2>
     void _solve(const Array1& b, Array2& x, const size_t i);
 
+    template <typename Array1, typename Array2>
+    void _cycle(const Array1& b, Array2& x, const size_t i, const cycle_type c, const bool zero_initial_guess);
+
+    template <typename Array1, typename Array2>
+    void _kcycle(const Array1& b, Array2& x, const size_t i);
+
+    template <typename Array1, typename Array2>
+    void _apply(const Array1& b, Array2& x, cusp::array1d_format);
+
+    template <typename Array1, typename Array2>
+    void _apply(const Array1& b, Array2& x, cusp::array2d_format);
+
+    // cycles block_b into block_x of level i
+    void _block_cycle(const size_t i, const cycle_type c, const bool zero_initial_guess);
+
+    void resize_blocks(const size_t num_vectors);
+
     template <typename MatrixType2, typename Level>
     void setup_level(const size_t lvl, const MatrixType2& A, const Level& L);
 
+    // sets up level lvl in dst rather than in levels, e.g. on a second
+    // thread, swap_level exchanges it with the level of the hierarchy
+    template <typename MatrixType2, typename Level>
+    void setup_level(level& dst, const size_t lvl, const MatrixType2& A, const Level& L);
+
+    void swap_level(const size_t lvl, level& other);
+
     template <typename Level>
-    void set_multilevel_matrix(const SolveMatrixType& A, const Level& L);
+    void set_multilevel_matrix(level& dst, const SolveMatrixType& A, const Level& L);
 
     template <typename SolveMatrixType2, typename Level>
-    void set_multilevel_matrix(const SolveMatrixType2& A, const Level& L);
+    void set_multilevel_matrix(level& dst, const SolveMatrixType2& A, const Level& L);
 
     void copy_or_swap_matrix(SolveMatrixType& dst, SolveMatrixType& src);
 
@@ -190,6 +388,14 @@ protected:
     void copy_or_swap_matrix(SolveMatrixType& dst, SolveMatrixType2& src);
 
     void initialize_coarse_solver(void);
+
+    // the two parts of initialize_coarse_solver, the coarse solver only
+    // needs the coarsest level while the host levels copy all of them
+    void setup_coarse_solver(void);
+
+    void setup_host_levels(void);
+
+    void agglomerate_levels(void);
 };
 /*! \}
  */
@@ -17,15 +17,62 @@
 #include <cusp/multiply.h>
 #include <cusp/monitor.h>
 #include <cusp/blas/blas.h>
+#include <cusp/complex.h>
+
+#include <cusp/detail/num_bytes.h>
+#include <cusp/detail/timer.h>
 
 namespace cusp
 {
+namespace detail
+{
+
+inline void accumulate_setup_time(std::vector< std::pair<std::string,double> >& times,
+                                  const std::string& phase, const double seconds)
+{
+    for(size_t i = 0; i < times.size(); i++)
+    {
+        if(times[i].first == phase)
+        {
+            times[i].second += seconds;
+            return;
+        }
+    }
+
+    times.push_back(std::make_pair(phase, seconds));
+}
+
+// smooth the columns of a block one at a time, smoothers that can sweep a
+// whole block provide overloads found by argument dependent lookup
+template <typename Smoother, typename MatrixType, typename BlockType>
+void block_presmooth(Smoother& S, const MatrixType& A, const BlockType& B, BlockType& X, BlockType& workspace)
+{
+    for(size_t k = 0; k < X.num_cols; k++)
+    {
+        typename BlockType::column_view x(X.column(k));
+        S.presmooth(A, B.column(k), x);
+    }
+}
+
+template <typename Smoother, typename MatrixType, typename BlockType>
+void block_postsmooth(Smoother& S, const MatrixType& A, const BlockType& B, BlockType& X, BlockType& workspace)
+{
+    for(size_t k = 0; k < X.num_cols; k++)
+    {
+        typename BlockType::column_view x(X.column(k));
+        S.postsmooth(A, B.column(k), x);
+    }
+}
+
+} // end namespace detail
 
 template <typename IndexType, typename ValueType, typename MemorySpace, typename Format, typename SmootherType, typename SolverType>
 template <typename MemorySpace2, typename Format2, typename SmootherType2, typename SolverType2>
 multilevel<IndexType,ValueType,MemorySpace,Format,SmootherType,SolverType>
 ::multilevel(const multilevel<IndexType,ValueType,MemorySpace2,Format2,SmootherType2,SolverType2>& M)
-    : min_level_size(M.min_level_size), max_levels(M.max_levels), solver(M.solver)
+    : min_level_size(M.min_level_size), max_levels(M.max_levels),
+      host_level_size(M.host_level_size), cycle(M.cycle), solver(M.solver),
+      host_level(0), setup_times(M.setup_times), level_setup_times(M.level_setup_times)
 {
     for( size_t lvl = 0; lvl < M.levels.size(); lvl++ )
         levels.push_back(M.levels[lvl]);
@@ -37,6 +84,8 @@ multilevel<IndexType,ValueType,MemorySpace,Format,SmootherType,SolverType>
     update.resize(A_ptr->num_rows);
     temp_b.resize(levels.back().A.num_rows);
     temp_x.resize(levels.back().A.num_rows);
+
+    agglomerate_levels();
 }
 
 template <typename IndexType, typename ValueType, typename MemorySpace, typename Format, typename SmootherType, typename SolverType>
@@ -44,27 +93,53 @@ template <typename MatrixType2, typename Level>
 void multilevel<IndexType,ValueType,MemorySpace,Format,SmootherType,SolverType>
 ::setup_level(const size_t lvl, const MatrixType2& A, const Level& L)
 {
+    setup_level(levels[lvl], lvl, A, L);
+}
+
+template <typename IndexType, typename ValueType, typename MemorySpace, typename Format, typename SmootherType, typename SolverType>
+template <typename MatrixType2, typename Level>
+void multilevel<IndexType,ValueType,MemorySpace,Format,SmootherType,SolverType>
+::setup_level(level& dst, const size_t lvl, const MatrixType2& A, const Level& L)
+{
+    cusp::detail::profile_range range("cusp::multilevel setup level", lvl);
+
     size_t N = A.num_rows;
 
     // Allocate arrays used during cycling
-    levels[lvl].x.resize(N);
-    levels[lvl].b.resize(N);
-    levels[lvl].residual.resize(N);
+    dst.x.resize(N);
+    dst.b.resize(N);
+    dst.residual.resize(N);
 
     // Setup solve matrix for each level
     if(lvl == 0)
     {
-        set_multilevel_matrix(A, L);
+        set_multilevel_matrix(dst, A, L);
     }
     else
     {
-        copy_or_swap_matrix(levels[lvl].A, const_cast<MatrixType2&>(A));
+        copy_or_swap_matrix(dst.A, const_cast<MatrixType2&>(A));
 
         // Initialize smoother for each level
-        levels[lvl].smoother.initialize(levels[lvl].A, L);
+        cusp::detail::timer t("amg smoother");
+        dst.smoother.initialize(dst.A, L);
+        add_setup_time("smoother", t.seconds_elapsed(), lvl);
     }
 }
 
+template <typename IndexType, typename ValueType, typename MemorySpace, typename Format, typename SmootherType, typename SolverType>
+void multilevel<IndexType,ValueType,MemorySpace,Format,SmootherType,SolverType>
+::swap_level(const size_t lvl, level& other)
+{
+    // only the members written by setup_level, R, P and the cycle
+    // workspace stay with the level
+    levels[lvl].A.swap(other.A);
+    levels[lvl].x.swap(other.x);
+    levels[lvl].b.swap(other.b);
+    levels[lvl].residual.swap(other.residual);
+
+    std::swap(levels[lvl].smoother, other.smoother);
+}
+
 template <typename IndexType, typename ValueType, typename MemorySpace, typename Format, typename SmootherType, typename SolverType>
 void multilevel<IndexType,ValueType,MemorySpace,Format,SmootherType,SolverType>
 ::copy_or_swap_matrix(SolveMatrixType& dst, SolveMatrixType& src)
@@ -83,12 +158,14 @@ void multilevel<IndexType,ValueType,MemorySpace,Format,SmootherType,SolverType>
 template <typename IndexType, typename ValueType, typename MemorySpace, typename Format, typename SmootherType, typename SolverType>
 template <typename SolveMatrixType2, typename Level>
 void multilevel<IndexType,ValueType,MemorySpace,Format,SmootherType,SolverType>
-::set_multilevel_matrix(const SolveMatrixType2& A, const Level& L)
+::set_multilevel_matrix(level& dst, const SolveMatrixType2& A, const Level& L)
 {
     this->A = A;
     A_ptr = &this->A;
 
-    levels[0].smoother.initialize(this->A, L);
+    cusp::detail::timer t("amg smoother");
+    dst.smoother.initialize(this->A, L);
+    add_setup_time("smoother", t.seconds_elapsed(), 0);
 
     residual.resize(A.num_rows);
     update.resize(A.num_rows);
@@ -97,11 +174,13 @@ void multilevel<IndexType,ValueType,MemorySpace,Format,SmootherType,SolverType>
 template <typename IndexType, typename ValueType, typename MemorySpace, typename Format, typename SmootherType, typename SolverType>
 template <typename Level>
 void multilevel<IndexType,ValueType,MemorySpace,Format,SmootherType,SolverType>
-::set_multilevel_matrix(const SolveMatrixType& A, const Level& L)
+::set_multilevel_matrix(level& dst, const SolveMatrixType& A, const Level& L)
 {
     A_ptr = const_cast<SolveMatrixType*>(&A);
 
-    levels[0].smoother.initialize(A, L);
+    cusp::detail::timer t("amg smoother");
+    dst.smoother.initialize(A, L);
+    add_setup_time("smoother", t.seconds_elapsed(), 0);
 
     residual.resize(A.num_rows);
     update.resize(A.num_rows);
@@ -121,14 +200,133 @@ void multilevel<IndexType,ValueType,MemorySpace,Format,SmootherType,SolverType>
     max_levels = max_depth;
 }
 
+template <typename IndexType, typename ValueType, typename MemorySpace, typename Format, typename SmootherType, typename SolverType>
+void multilevel<IndexType,ValueType,MemorySpace,Format,SmootherType,SolverType>
+::set_cycle(cycle_type cycle)
+{
+    this->cycle = cycle;
+}
+
+template <typename IndexType, typename ValueType, typename MemorySpace, typename Format, typename SmootherType, typename SolverType>
+void multilevel<IndexType,ValueType,MemorySpace,Format,SmootherType,SolverType>
+::set_host_level_size(size_t size)
+{
+    host_level_size = size;
+
+    if(!levels.empty())
+        agglomerate_levels();
+}
+
 template <typename IndexType, typename ValueType, typename MemorySpace, typename Format, typename SmootherType, typename SolverType>
 void multilevel<IndexType,ValueType,MemorySpace,Format,SmootherType,SolverType>
 ::initialize_coarse_solver(void)
+{
+    setup_coarse_solver();
+    setup_host_levels();
+}
+
+template <typename IndexType, typename ValueType, typename MemorySpace, typename Format, typename SmootherType, typename SolverType>
+void multilevel<IndexType,ValueType,MemorySpace,Format,SmootherType,SolverType>
+::setup_coarse_solver(void)
 {
     temp_b.resize(levels.back().A.num_rows);
     temp_x.resize(levels.back().A.num_rows);
 
+    cusp::detail::timer t("amg coarse solver");
     solver = Solver(levels.back().A);
+    add_setup_time("coarse solver", t.seconds_elapsed(), levels.size() - 1);
+}
+
+template <typename IndexType, typename ValueType, typename MemorySpace, typename Format, typename SmootherType, typename SolverType>
+void multilevel<IndexType,ValueType,MemorySpace,Format,SmootherType,SolverType>
+::setup_host_levels(void)
+{
+    cusp::detail::timer t("amg host agglomeration");
+    agglomerate_levels();
+
+    if(!host_hierarchy.empty())
+        add_setup_time("host agglomeration", t.seconds_elapsed());
+}
+
+template <typename IndexType, typename ValueType, typename MemorySpace, typename Format, typename SmootherType, typename SolverType>
+void multilevel<IndexType,ValueType,MemorySpace,Format,SmootherType,SolverType>
+::add_setup_time(const std::string& phase, const double seconds)
+{
+#if __cplusplus >= 201103L
+    std::lock_guard<std::mutex> lock(detail::get_setup_time_mutex());
+#endif
+
+    detail::accumulate_setup_time(setup_times, phase, seconds);
+}
+
+template <typename IndexType, typename ValueType, typename MemorySpace, typename Format, typename SmootherType, typename SolverType>
+void multilevel<IndexType,ValueType,MemorySpace,Format,SmootherType,SolverType>
+::add_setup_time(const std::string& phase, const double seconds, const size_t lvl)
+{
+#if __cplusplus >= 201103L
+    std::lock_guard<std::mutex> lock(detail::get_setup_time_mutex());
+#endif
+
+    detail::accumulate_setup_time(setup_times, phase, seconds);
+
+    if(level_setup_times.size() <= lvl)
+        level_setup_times.resize(lvl + 1);
+
+    detail::accumulate_setup_time(level_setup_times[lvl], phase, seconds);
+}
+
+template <typename IndexType, typename ValueType, typename MemorySpace, typename Format, typename SmootherType, typename SolverType>
+void multilevel<IndexType,ValueType,MemorySpace,Format,SmootherType,SolverType>
+::clear_setup_times(void)
+{
+    setup_times.clear();
+    level_setup_times.clear();
+}
+
+template <typename IndexType, typename ValueType, typename MemorySpace, typename Format, typename SmootherType, typename SolverType>
+void multilevel<IndexType,ValueType,MemorySpace,Format,SmootherType,SolverType>
+::agglomerate_levels(void)
+{
+    host_hierarchy.clear();
+    host_level = levels.size();
+
+    if(thrust::detail::is_convertible<MemorySpace, cusp::host_memory>::value || host_level_size == 0)
+        return;
+
+    // the finest level is referenced rather than owned, so the search
+    // starts on the first coarse level
+    size_t lvl = 1;
+    while(lvl < levels.size() && levels[lvl].A.num_rows >= host_level_size)
+        lvl++;
+
+    // the coarsest level is already solved on the host
+    if(lvl + 1 >= levels.size())
+        return;
+
+    host_hierarchy.resize(1);
+    host_container& H = host_hierarchy[0];
+
+    H.min_level_size = min_level_size;
+    H.max_levels     = max_levels;
+    H.cycle          = cycle;
+    H.solver         = solver;
+
+    H.levels.reserve(levels.size() - lvl);
+    for(size_t i = lvl; i < levels.size(); i++)
+        H.levels.push_back(typename host_container::level(levels[i]));
+
+    const size_t N = H.levels[0].A.num_rows;
+
+    H.resize(N, H.levels[0].A.num_cols, H.levels[0].A.num_entries);
+    H.A_ptr = &H.levels[0].A;
+    H.residual.resize(N);
+    H.update.resize(N);
+    H.temp_b.resize(H.levels.back().A.num_rows);
+    H.temp_x.resize(H.levels.back().A.num_rows);
+
+    host_b.resize(N);
+    host_x.resize(N);
+    host_level = lvl;
 }
 
 template <typename IndexType, typename ValueType, typename MemorySpace, typename Format, typename SmootherType, typename SolverType>
@@ -136,10 +334,47 @@ template <typename Array1, typename Array2>
 void multilevel<IndexType,ValueType,MemorySpace,Format,SmootherType,SolverType>
 ::operator()(const Array1& b, Array2& x)
 {
-    // perform 1 V-cycle
+    typename Array2::format format;
+
+    // perform 1 cycle
+    _apply(b, x, format);
+}
+
+template <typename IndexType, typename ValueType, typename MemorySpace, typename Format, typename SmootherType, typename SolverType>
+template <typename Array1, typename Array2>
+void multilevel<IndexType,ValueType,MemorySpace,Format,SmootherType,SolverType>
+::_apply(const Array1& b, Array2& x, cusp::array1d_format)
+{
     _solve(b, x, 0);
 }
 
+template <typename IndexType, typename ValueType, typename MemorySpace, typename Format, typename SmootherType, typename SolverType>
+template <typename Array1, typename Array2>
+void multilevel<IndexType,ValueType,MemorySpace,Format,SmootherType,SolverType>
+::_apply(const Array1& b, Array2& x, cusp::array2d_format)
+{
+    level& L = levels[0];
+
+    resize_blocks(b.num_cols);
+    cusp::copy(b, L.block_b);
+
+    if(cycle == K_CYCLE)
+    {
+        // the K-cycle weights every vector with its own inner products
+        for(size_t k = 0; k < L.block_b.num_cols; k++)
+        {
+            typename level::block_type::column_view xk(L.block_x.column(k));
+            _solve(L.block_b.column(k), xk, 0);
+        }
+    }
+    else
+    {
+        _block_cycle(0, cycle, true);
+    }
+
+    cusp::copy(L.block_x, x);
+}
+
 template <typename IndexType, typename ValueType, typename MemorySpace, typename Format, typename SmootherType, typename SolverType>
 template <typename Array1, typename Array2>
 void multilevel<IndexType,ValueType,MemorySpace,Format,SmootherType,SolverType>
@@ -179,24 +414,55 @@ template <typename Array1, typename Array2>
 void multilevel<IndexType,ValueType,MemorySpace,Format,SmootherType,SolverType>
 ::_solve(const Array1& b, Array2& x, const size_t i)
 {
-    if (i + 1 == levels.size())
+    _cycle(b, x, i, cycle, true);
+}
+
+template <typename IndexType, typename ValueType, typename MemorySpace, typename Format, typename SmootherType, typename SolverType>
+template <typename Array1, typename Array2>
+void multilevel<IndexType,ValueType,MemorySpace,Format,SmootherType,SolverType>
+::_cycle(const Array1& b, Array2& x, const size_t i, const cycle_type c, const bool zero_initial_guess)
+{
+    // the range of a level encloses those of the coarser levels
+    cusp::detail::profile_range range("cusp::multilevel level", i);
+
+    if (!host_hierarchy.empty() && i == host_level)
+    {
+        // continue the cycle on the host copy of the remaining levels
+        cusp::copy(b, host_b);
+        if(!zero_initial_guess)
+            cusp::copy(x, host_x);
+        host_hierarchy[0]._cycle(host_b, host_x, 0, c, zero_initial_guess);
+        cusp::copy(host_x, x);
+    }
+    else if (i + 1 == levels.size())
     {
-        // coarse grid solve
-        // TODO streamline
+        // coarse grid solve, the default solver works in the memory space
+        // of the hierarchy so these copies do not leave the device
         cusp::copy(b, temp_b);
         solver(temp_b, temp_x);
         cusp::copy(temp_x, x);
     }
     else
     {
-        // initialize solution
-        cusp::blas::fill(x, ValueType(0));
-
-        // presmooth
-        if(i == 0)
-            levels[i].smoother.presmooth(*A_ptr, b, x);
+        if(zero_initial_guess)
+        {
+            // initialize solution
+            cusp::blas::fill(x, ValueType(0));
+
+            // presmooth
+            if(i == 0)
+                levels[i].smoother.presmooth(*A_ptr, b, x);
+            else
+                levels[i].smoother.presmooth(levels[i].A, b, x);
+        }
         else
-            levels[i].smoother.presmooth(levels[i].A, b, x);
+        {
+            // presmooth the given initial solution
+            if(i == 0)
+                levels[i].smoother.postsmooth(*A_ptr, b, x);
+            else
+                levels[i].smoother.postsmooth(levels[i].A, b, x);
+        }
 
         // compute residual <- b - A*x
         if(i == 0)
@@ -210,7 +476,22 @@ void multilevel<IndexType,ValueType,MemorySpace,Format,SmootherType,SolverType>
         cusp::multiply(levels[i].R, levels[i].residual, levels[i + 1].b);
 
         // compute coarse grid solution
-        _solve(levels[i + 1].b, levels[i + 1].x, i + 1);
+        switch(c)
+        {
+        case W_CYCLE:
+            _cycle(levels[i + 1].b, levels[i + 1].x, i + 1, W_CYCLE, true);
+            _cycle(levels[i + 1].b, levels[i + 1].x, i + 1, W_CYCLE, false);
+            break;
+        case F_CYCLE:
+            _cycle(levels[i + 1].b, levels[i + 1].x, i + 1, F_CYCLE, true);
+            _cycle(levels[i + 1].b, levels[i + 1].x, i + 1, V_CYCLE, false);
+            break;
+        case K_CYCLE:
+            _kcycle(levels[i + 1].b, levels[i + 1].x, i + 1);
+            break;
+        default:
+            _cycle(levels[i + 1].b, levels[i + 1].x, i + 1, V_CYCLE, true);
+        }
 
         // apply coarse grid correction
         cusp::multiply(levels[i].P, levels[i + 1].x, levels[i].residual);
@@ -224,34 +505,313 @@ void multilevel<IndexType,ValueType,MemorySpace,Format,SmootherType,SolverType>
     }
 }
 
+// Approximately solve A_i x = b with two steps of flexible CG preconditioned
+// by a K-cycle on level i (Notay and Vassilevski). The second step is
+// skipped if the first one already reduces the residual sufficiently.
+template <typename IndexType, typename ValueType, typename MemorySpace, typename Format, typename SmootherType, typename SolverType>
+template <typename Array1, typename Array2>
+void multilevel<IndexType,ValueType,MemorySpace,Format,SmootherType,SolverType>
+::_kcycle(const Array1& b, Array2& x, const size_t i)
+{
+    typedef typename cusp::norm_type<ValueType>::type NormType;
+
+    // residual reduction that makes the second iteration unnecessary
+    const NormType tolerance = 0.25;
+
+    if (!host_hierarchy.empty() && i == host_level)
+    {
+        cusp::copy(b, host_b);
+        host_hierarchy[0]._kcycle(host_b, host_x, 0);
+        cusp::copy(host_x, x);
+        return;
+    }
+
+    if (i + 1 == levels.size())
+    {
+        _cycle(b, x, i, K_CYCLE, true);
+        return;
+    }
+
+    level& L = levels[i];
+    const size_t N = L.A.num_rows;
+
+    if(L.r2.size() != N)
+    {
+        L.v1.resize(N); L.v2.resize(N);
+        L.w1.resize(N); L.w2.resize(N);
+        L.r2.resize(N);
+    }
+
+    // v1 <- B b, w1 <- A v1
+    _cycle(b, L.v1, i, K_CYCLE, true);
+    cusp::multiply(L.A, L.v1, L.w1);
+
+    const ValueType rho1   = cusp::blas::dotc(L.v1, b);
+    const ValueType alpha1 = cusp::blas::dotc(L.v1, L.w1);
+
+    if(alpha1 == ValueType(0))
+    {
+        cusp::blas::fill(x, ValueType(0));
+        return;
+    }
+
+    // r2 <- b - (rho1 / alpha1) w1
+    cusp::blas::axpby(b, L.w1, L.r2, ValueType(1), -rho1 / alpha1);
+
+    if(cusp::blas::nrm2(L.r2) <= tolerance * cusp::blas::nrm2(b))
+    {
+        cusp::blas::axpby(L.v1, L.v1, x, rho1 / alpha1, ValueType(0));
+        return;
+    }
+
+    // v2 <- B r2, w2 <- A v2
+    _cycle(L.r2, L.v2, i, K_CYCLE, true);
+    cusp::multiply(L.A, L.v2, L.w2);
+
+    const ValueType gamma  = cusp::blas::dotc(L.v2, L.w1);
+    const ValueType beta   = cusp::blas::dotc(L.v2, L.w2);
+    const ValueType rho2   = cusp::blas::dotc(L.v2, L.r2);
+    const ValueType alpha2 = beta - gamma * cusp::conj(gamma) / alpha1;
+
+    if(alpha2 == ValueType(0))
+    {
+        cusp::blas::axpby(L.v1, L.v1, x, rho1 / alpha1, ValueType(0));
+        return;
+    }
+
+    // x <- (rho1 / alpha1 - gamma rho2 / (alpha1 alpha2)) v1 + (rho2 / alpha2) v2
+    cusp::blas::axpby(L.v1, L.v2, x,
+                      rho1 / alpha1 - gamma * rho2 / (alpha1 * alpha2),
+                      rho2 / alpha2);
+}
+
+template <typename IndexType, typename ValueType, typename MemorySpace, typename Format, typename SmootherType, typename SolverType>
+void multilevel<IndexType,ValueType,MemorySpace,Format,SmootherType,SolverType>
+::resize_blocks(const size_t num_vectors)
+{
+    for(size_t i = 0; i < levels.size(); i++)
+    {
+        level& L = levels[i];
+        const size_t N = L.x.size();
+
+        if(L.block_x.num_rows == N && L.block_x.num_cols == num_vectors)
+            continue;
+
+        L.block_x.resize(N, num_vectors);
+        L.block_b.resize(N, num_vectors);
+        L.block_residual.resize(N, num_vectors);
+    }
+
+    if(!host_hierarchy.empty())
+        host_hierarchy[0].resize_blocks(num_vectors);
+}
+
+// Same recursion as _cycle, applied to all columns of block_b at once.
+// Every level matrix, P and R is read once per product for the whole block
+// while the coarse solver is applied to the columns one at a time.
+template <typename IndexType, typename ValueType, typename MemorySpace, typename Format, typename SmootherType, typename SolverType>
+void multilevel<IndexType,ValueType,MemorySpace,Format,SmootherType,SolverType>
+::_block_cycle(const size_t i, const cycle_type c, const bool zero_initial_guess)
+{
+    using cusp::detail::block_presmooth;
+    using cusp::detail::block_postsmooth;
+
+    cusp::detail::profile_range range("cusp::multilevel block level", i);
+
+    level& L = levels[i];
+
+    if (!host_hierarchy.empty() && i == host_level)
+    {
+        typename host_container::level& H = host_hierarchy[0].levels[0];
+
+        cusp::copy(L.block_b, H.block_b);
+        if(!zero_initial_guess)
+            cusp::copy(L.block_x, H.block_x);
+        host_hierarchy[0]._block_cycle(0, c, zero_initial_guess);
+        cusp::copy(H.block_x, L.block_x);
+    }
+    else if (i + 1 == levels.size())
+    {
+        for(size_t k = 0; k < L.block_b.num_cols; k++)
+        {
+            typename level::block_type::column_view xk(L.block_x.column(k));
+
+            cusp::copy(L.block_b.column(k), temp_b);
+            solver(temp_b, temp_x);
+            cusp::copy(temp_x, xk);
+        }
+    }
+    else
+    {
+        const SolveMatrixType& A_i = i == 0 ? *A_ptr : L.A;
+
+        if(zero_initial_guess)
+        {
+            cusp::blas::fill(L.block_x.values, ValueType(0));
+            block_presmooth(L.smoother, A_i, L.block_b, L.block_x, L.block_residual);
+        }
+        else
+        {
+            block_postsmooth(L.smoother, A_i, L.block_b, L.block_x, L.block_residual);
+        }
+
+        // compute residual <- b - A*x
+        cusp::multiply(A_i, L.block_x, L.block_residual);
+        cusp::blas::axpby(L.block_b.values, L.block_residual.values, L.block_residual.values, ValueType(1.0), ValueType(-1.0));
+
+        // restrict to coarse grid
+        cusp::multiply(L.R, L.block_residual, levels[i + 1].block_b);
+
+        // compute coarse grid solution
+        switch(c)
+        {
+        case W_CYCLE:
+            _block_cycle(i + 1, W_CYCLE, true);
+            _block_cycle(i + 1, W_CYCLE, false);
+            break;
+        case F_CYCLE:
+            _block_cycle(i + 1, F_CYCLE, true);
+            _block_cycle(i + 1, V_CYCLE, false);
+            break;
+        default:
+            _block_cycle(i + 1, V_CYCLE, true);
+        }
+
+        // apply coarse grid correction
+        cusp::multiply(L.P, levels[i + 1].block_x, L.block_residual);
+        cusp::blas::axpy(L.block_residual.values, L.block_x.values, ValueType(1.0));
+
+        // postsmooth
+        block_postsmooth(L.smoother, A_i, L.block_b, L.block_x, L.block_residual);
+    }
+}
+
 template <typename IndexType, typename ValueType, typename MemorySpace, typename Format, typename SmootherType, typename SolverType>
 void multilevel<IndexType,ValueType,MemorySpace,Format,SmootherType,SolverType>
 ::print( void )
 {
-    size_t num_levels = levels.size();
-    double nnz = this->num_entries;
+    const multilevel_report r = report();
+    const double MB = 1024.0 * 1024.0;
+
+    size_t num_levels = r.num_levels;
+    double nnz = 0;
+
+    for(size_t index = 0; index < num_levels; index++)
+        nnz += r.levels[index].num_entries;
 
     std::cout << "\tNumber of Levels    :\t" << num_levels << std::endl;
-    std::cout << "\tOperator Complexity :\t" << operator_complexity() << std::endl;
-    std::cout << "\tGrid Complexity     :\t" << grid_complexity() << std::endl;
-    std::cout << "\tlevel\tunknowns\tnonzeros" << std::endl;
+    std::cout << "\tOperator Complexity :\t" << r.operator_complexity << std::endl;
+    std::cout << "\tGrid Complexity     :\t" << r.grid_complexity << std::endl;
+    std::cout << "\tlevel\tunknowns\tnonzeros\t   A [MB]\t   P [MB]\t   R [MB]\tsmoother [MB]\tsetup [s]" << std::endl;
 
-    for(size_t index = 1; index < num_levels; index++)
-        nnz += levels[index].A.num_entries;
+    for(size_t index = 0; index < num_levels; index++)
+    {
+        const multilevel_level_report& L = r.levels[index];
+        double percent = L.num_entries / nnz;
+
+        std::cout << "\t" << index << "\t" << std::setw(8) << std::right << L.num_rows << "\t" \
+                  << std::setw(8) << std::right << L.num_entries << "  [" << 100*percent << "%]" \
+                  << "\t" << std::setw(9) << std::right << L.A_bytes / MB \
+                  << "\t" << std::setw(9) << std::right << L.P_bytes / MB \
+                  << "\t" << std::setw(9) << std::right << L.R_bytes / MB \
+                  << "\t" << std::setw(9) << std::right << L.smoother_bytes / MB \
+                  << "\t" << std::setw(9) << std::right << L.setup_seconds \
+                  << std::endl;
+    }
 
-    double percent = this->num_entries / nnz;
+    std::cout << "\tCoarse Solver [MB]  :\t" << r.solver_bytes / MB << std::endl;
 
-    std::cout << "\t" << 0 << "\t" << std::setw(8) << std::right << this->num_cols << "\t" \
-              << std::setw(8) << std::right << this->num_entries << "  [" << 100*percent << "%]" \
-              << std::endl;
+    if(r.host_bytes > 0)
+        std::cout << "\tHost Levels [MB]    :\t" << r.host_bytes / MB << std::endl;
 
-    for(size_t index = 1; index < num_levels; index++)
+    std::cout << "\tTotal Memory [MB]   :\t" << r.total_bytes / MB << std::endl;
+
+    if(!r.setup_times.empty())
     {
-        percent = levels[index].A.num_entries / nnz;
-        std::cout << "\t" << index << "\t" << std::setw(8) << std::right << levels[index].A.num_cols << "\t" \
-                  << std::setw(8) << std::right << levels[index].A.num_entries << "  [" << 100*percent << "%]" \
-                  << std::endl;
+        std::cout << "\tSetup Time [s]      :\t" << r.setup_seconds << std::endl;
+
+        for(size_t i = 0; i < r.setup_times.size(); i++)
+            std::cout << "\t\t" << std::setw(20) << std::left << r.setup_times[i].first \
+                      << std::setw(10) << std::right << r.setup_times[i].second << std::endl;
+    }
+}
+
+template <typename IndexType, typename ValueType, typename MemorySpace, typename Format, typename SmootherType, typename SolverType>
+multilevel_report multilevel<IndexType,ValueType,MemorySpace,Format,SmootherType,SolverType>
+::report( void )
+{
+    using cusp::detail::operator_bytes;
+
+    multilevel_report r;
+
+    r.num_levels = levels.size();
+
+    if(r.num_levels == 0)
+        return r;
+
+    r.operator_complexity = operator_complexity();
+    r.grid_complexity     = grid_complexity();
+    r.levels.resize(r.num_levels);
+
+    for(size_t index = 0; index < r.num_levels; index++)
+    {
+        const level& L = levels[index];
+        multilevel_level_report& R = r.levels[index];
+
+        const SolveMatrixType& A_level = (index == 0 && A_ptr != NULL) ? *A_ptr : L.A;
+
+        R.num_rows       = index == 0 ? this->num_rows    : L.A.num_rows;
+        R.num_entries    = index == 0 ? this->num_entries : L.A.num_entries;
+        R.A_bytes        = cusp::detail::num_bytes(A_level);
+        R.P_bytes        = cusp::detail::num_bytes(L.P);
+        R.R_bytes        = cusp::detail::num_bytes(L.R);
+        R.smoother_bytes = operator_bytes(L.smoother);
+        R.vector_bytes   = cusp::detail::num_bytes(L.x)  + cusp::detail::num_bytes(L.b)  +
+                           cusp::detail::num_bytes(L.residual) +
+                           cusp::detail::num_bytes(L.v1) + cusp::detail::num_bytes(L.v2) +
+                           cusp::detail::num_bytes(L.w1) + cusp::detail::num_bytes(L.w2) +
+                           cusp::detail::num_bytes(L.r2) +
+                           cusp::detail::num_bytes(L.block_x) + cusp::detail::num_bytes(L.block_b) +
+                           cusp::detail::num_bytes(L.block_residual);
+
+        // the finest matrix belongs to the caller unless it was copied
+        const bool owns_A = index > 0 || A_ptr == NULL || A_ptr == &A || A_ptr == &levels[0].A;
+
+        r.total_bytes += (owns_A ? R.A_bytes : 0) + R.P_bytes + R.R_bytes + R.smoother_bytes + R.vector_bytes;
     }
+
+    r.levels[0].vector_bytes += cusp::detail::num_bytes(update) + cusp::detail::num_bytes(residual) +
+                                cusp::detail::num_bytes(temp_b) + cusp::detail::num_bytes(temp_x) +
+                                cusp::detail::num_bytes(host_b) + cusp::detail::num_bytes(host_x);
+    r.total_bytes += cusp::detail::num_bytes(update) + cusp::detail::num_bytes(residual) +
+                     cusp::detail::num_bytes(temp_b) + cusp::detail::num_bytes(temp_x) +
+                     cusp::detail::num_bytes(host_b) + cusp::detail::num_bytes(host_x);
+
+    r.solver_bytes = operator_bytes(solver);
+    r.total_bytes += r.solver_bytes;
+
+    if(!host_hierarchy.empty())
+    {
+        r.host_bytes   = host_hierarchy[0].report().total_bytes;
+        r.total_bytes += r.host_bytes;
+    }
+
+    r.setup_times = setup_times;
+
+    for(size_t i = 0; i < setup_times.size(); i++)
+        r.setup_seconds += setup_times[i].second;
+
+    for(size_t index = 0; index < r.num_levels && index < level_setup_times.size(); index++)
+    {
+        multilevel_level_report& R = r.levels[index];
+
+        R.setup_times = level_setup_times[index];
+
+        for(size_t i = 0; i < R.setup_times.size(); i++)
+            R.setup_seconds += R.setup_times[i].second;
+    }
+
+    return r;
 }
 
 template <typename IndexType, typename ValueType, typename MemorySpace, typename Format, typename SmootherType, typename SolverType>
@@ -15,10 +15,14 @@
  */
 
 #include <cusp/detail/execution_policy.h>
+#include <cusp/detail/profile.h>
+#include <cusp/functional.h>
 
 #include <cusp/system/detail/adl/multiply.h>
 #include <cusp/system/detail/generic/multiply.h>
+#include <cusp/system/detail/generic/multiply/spgemm_workspace.h>
 
+#include <thrust/functional.h>
 #include <thrust/system/detail/generic/select_system.h>
 
 namespace cusp
@@ -35,6 +39,8 @@ void multiply(const thrust::detail::execution_policy_base<DerivedPolicy> &exec,
 {
     using cusp::system::detail::generic::multiply;
 
+    cusp::detail::profile_range range("cusp::multiply");
+
     return multiply(thrust::detail::derived_cast(thrust::detail::strip_const(exec)), A, B, C);
 }
 
@@ -58,6 +64,78 @@ void multiply(const LinearOperator&  A,
     return cusp::multiply(select_system(system1,system2,system3), A, B, C);
 }
 
+template <typename DerivedPolicy,
+          typename MatrixType,
+          typename VectorType1,
+          typename VectorType2>
+void multiply_transpose(const thrust::detail::execution_policy_base<DerivedPolicy> &exec,
+                        const MatrixType&  A,
+                        const VectorType1& x,
+                              VectorType2& y)
+{
+    using cusp::system::detail::generic::multiply_transpose;
+
+    cusp::detail::profile_range range("cusp::multiply_transpose");
+
+    return multiply_transpose(thrust::detail::derived_cast(thrust::detail::strip_const(exec)), A, x, y);
+}
+
+template <typename MatrixType,
+          typename VectorType1,
+          typename VectorType2>
+void multiply_transpose(const MatrixType&  A,
+                        const VectorType1& x,
+                              VectorType2& y)
+{
+    using thrust::system::detail::generic::select_system;
+
+    typedef typename MatrixType::memory_space  System1;
+    typedef typename VectorType1::memory_space System2;
+    typedef typename VectorType2::memory_space System3;
+
+    System1 system1;
+    System2 system2;
+    System3 system3;
+
+    return cusp::multiply_transpose(select_system(system1,system2,system3), A, x, y);
+}
+
+template <typename DerivedPolicy,
+          typename LinearOperator,
+          typename VectorType1,
+          typename VectorType2>
+typename VectorType2::value_type
+multiply_dotc(const thrust::detail::execution_policy_base<DerivedPolicy> &exec,
+              const LinearOperator& A,
+              const VectorType1&    x,
+                    VectorType2&    y)
+{
+    using cusp::system::detail::generic::multiply_dotc;
+
+    return multiply_dotc(thrust::detail::derived_cast(thrust::detail::strip_const(exec)), A, x, y);
+}
+
+template <typename LinearOperator,
+          typename VectorType1,
+          typename VectorType2>
+typename VectorType2::value_type
+multiply_dotc(const LinearOperator& A,
+              const VectorType1&    x,
+                    VectorType2&    y)
+{
+    using thrust::system::detail::generic::select_system;
+
+    typedef typename LinearOperator::memory_space System1;
+    typedef typename VectorType1::memory_space    System2;
+    typedef typename VectorType2::memory_space    System3;
+
+    System1 system1;
+    System2 system2;
+    System3 system3;
+
+    return cusp::multiply_dotc(select_system(system1,system2,system3), A, x, y);
+}
+
 template <typename DerivedPolicy,
           typename LinearOperator,
           typename MatrixOrVector1,
@@ -75,6 +153,8 @@ void multiply(const thrust::detail::execution_policy_base<DerivedPolicy> &exec,
 {
     using cusp::system::detail::generic::multiply;
 
+    cusp::detail::profile_range range("cusp::multiply");
+
     return multiply(thrust::detail::derived_cast(thrust::detail::strip_const(exec)), A, B, C, initialize, combine, reduce);
 }
 
@@ -150,6 +230,98 @@ void generalized_spgemm(const LinearOperator&  A,
     return cusp::generalized_spgemm(select_system(system1,system2,system3), A, B, C, initialize, combine, reduce);
 }
 
+template <typename DerivedPolicy,
+          typename MatrixType1,
+          typename MatrixType2,
+          typename MatrixType3,
+          typename MatrixType4,
+          typename UnaryFunction,
+          typename BinaryFunction1,
+          typename BinaryFunction2>
+void masked_spgemm(const thrust::detail::execution_policy_base<DerivedPolicy> &exec,
+                   const MatrixType1& A,
+                   const MatrixType2& B,
+                   const MatrixType3& M,
+                   MatrixType4& C,
+                   UnaryFunction   initialize,
+                   BinaryFunction1 combine,
+                   BinaryFunction2 reduce)
+{
+    using cusp::system::detail::generic::masked_spgemm;
+
+    return masked_spgemm(thrust::detail::derived_cast(thrust::detail::strip_const(exec)), A, B, M, C, initialize, combine, reduce);
+}
+
+template <typename MatrixType1,
+          typename MatrixType2,
+          typename MatrixType3,
+          typename MatrixType4,
+          typename UnaryFunction,
+          typename BinaryFunction1,
+          typename BinaryFunction2>
+void masked_spgemm(const MatrixType1& A,
+                   const MatrixType2& B,
+                   const MatrixType3& M,
+                   MatrixType4& C,
+                   UnaryFunction   initialize,
+                   BinaryFunction1 combine,
+                   BinaryFunction2 reduce)
+{
+    using thrust::system::detail::generic::select_system;
+
+    typedef typename MatrixType1::memory_space System1;
+    typedef typename MatrixType2::memory_space System2;
+    typedef typename MatrixType4::memory_space System3;
+
+    System1 system1;
+    System2 system2;
+    System3 system3;
+
+    return cusp::masked_spgemm(select_system(system1,system2,system3), A, B, M, C, initialize, combine, reduce);
+}
+
+template <typename DerivedPolicy,
+          typename MatrixType1,
+          typename MatrixType2,
+          typename MatrixType3,
+          typename MatrixType4>
+void masked_spgemm(const thrust::detail::execution_policy_base<DerivedPolicy> &exec,
+                   const MatrixType1& A,
+                   const MatrixType2& B,
+                   const MatrixType3& M,
+                   MatrixType4& C)
+{
+    typedef typename MatrixType4::value_type ValueType;
+
+    cusp::constant_functor<ValueType> initialize(0);
+    thrust::multiplies<ValueType> combine;
+    thrust::plus<ValueType> reduce;
+
+    cusp::masked_spgemm(exec, A, B, M, C, initialize, combine, reduce);
+}
+
+template <typename MatrixType1,
+          typename MatrixType2,
+          typename MatrixType3,
+          typename MatrixType4>
+void masked_spgemm(const MatrixType1& A,
+                   const MatrixType2& B,
+                   const MatrixType3& M,
+                   MatrixType4& C)
+{
+    using thrust::system::detail::generic::select_system;
+
+    typedef typename MatrixType1::memory_space System1;
+    typedef typename MatrixType2::memory_space System2;
+    typedef typename MatrixType4::memory_space System3;
+
+    System1 system1;
+    System2 system2;
+    System3 system3;
+
+    cusp::masked_spgemm(select_system(system1,system2,system3), A, B, M, C);
+}
+
 template <typename DerivedPolicy,
           typename LinearOperator,
           typename Vector1,
@@ -198,5 +370,135 @@ void generalized_spmv(const LinearOperator&  A,
     return cusp::generalized_spmv(select_system(system1,system2,system3,system4), A, x, y, z, combine, reduce);
 }
 
+template <typename DerivedPolicy,
+          typename MatrixType,
+          typename IndexType1, typename ValueType1, typename MemorySpace1,
+          typename IndexType2, typename ValueType2, typename MemorySpace2,
+          typename BinaryFunction1,
+          typename BinaryFunction2>
+void generalized_spmspv(const thrust::detail::execution_policy_base<DerivedPolicy> &exec,
+                        const MatrixType& A,
+                        const cusp::sparse_vector<IndexType1,ValueType1,MemorySpace1>& x,
+                              cusp::sparse_vector<IndexType2,ValueType2,MemorySpace2>& y,
+                        BinaryFunction1 combine,
+                        BinaryFunction2 reduce,
+                        const spmspv_method method)
+{
+    using cusp::system::detail::generic::generalized_spmspv;
+
+    generalized_spmspv(thrust::detail::derived_cast(thrust::detail::strip_const(exec)), A, x, y, combine, reduce, method);
+}
+
+template <typename MatrixType,
+          typename IndexType1, typename ValueType1, typename MemorySpace1,
+          typename IndexType2, typename ValueType2, typename MemorySpace2,
+          typename BinaryFunction1,
+          typename BinaryFunction2>
+void generalized_spmspv(const MatrixType& A,
+                        const cusp::sparse_vector<IndexType1,ValueType1,MemorySpace1>& x,
+                              cusp::sparse_vector<IndexType2,ValueType2,MemorySpace2>& y,
+                        BinaryFunction1 combine,
+                        BinaryFunction2 reduce,
+                        const spmspv_method method)
+{
+    using thrust::system::detail::generic::select_system;
+
+    typedef typename MatrixType::memory_space System1;
+    typedef MemorySpace1                      System2;
+    typedef MemorySpace2                      System3;
+
+    System1 system1;
+    System2 system2;
+    System3 system3;
+
+    cusp::generalized_spmspv(select_system(system1,system2,system3), A, x, y, combine, reduce, method);
+}
+
+template <typename DerivedPolicy,
+          typename MatrixType1,
+          typename MatrixType2,
+          typename MatrixType3,
+          typename PlanType>
+void spgemm_symbolic(const thrust::detail::execution_policy_base<DerivedPolicy> &exec,
+                     const MatrixType1& A,
+                     const MatrixType2& B,
+                           MatrixType3& C,
+                           PlanType& plan)
+{
+    using cusp::system::detail::generic::spgemm_symbolic;
+
+    spgemm_symbolic(thrust::detail::derived_cast(thrust::detail::strip_const(exec)), A, B, C, plan);
+}
+
+template <typename MatrixType1,
+          typename MatrixType2,
+          typename MatrixType3,
+          typename PlanType>
+void spgemm_symbolic(const MatrixType1& A,
+                     const MatrixType2& B,
+                           MatrixType3& C,
+                           PlanType& plan)
+{
+    using thrust::system::detail::generic::select_system;
+
+    typedef typename MatrixType1::memory_space System1;
+    typedef typename MatrixType2::memory_space System2;
+    typedef typename MatrixType3::memory_space System3;
+
+    System1 system1;
+    System2 system2;
+    System3 system3;
+
+    cusp::spgemm_symbolic(select_system(system1,system2,system3), A, B, C, plan);
+}
+
+template <typename DerivedPolicy,
+          typename MatrixType1,
+          typename MatrixType2,
+          typename MatrixType3,
+          typename PlanType>
+void spgemm_numeric(const thrust::detail::execution_policy_base<DerivedPolicy> &exec,
+                    const MatrixType1& A,
+                    const MatrixType2& B,
+                          MatrixType3& C,
+                    const PlanType& plan)
+{
+    using cusp::system::detail::generic::spgemm_numeric;
+
+    spgemm_numeric(thrust::detail::derived_cast(thrust::detail::strip_const(exec)), A, B, C, plan);
+}
+
+template <typename MatrixType1,
+          typename MatrixType2,
+          typename MatrixType3,
+          typename PlanType>
+void spgemm_numeric(const MatrixType1& A,
+                    const MatrixType2& B,
+                          MatrixType3& C,
+                    const PlanType& plan)
+{
+    using thrust::system::detail::generic::select_system;
+
+    typedef typename MatrixType1::memory_space System1;
+    typedef typename MatrixType2::memory_space System2;
+    typedef typename MatrixType3::memory_space System3;
+
+    System1 system1;
+    System2 system2;
+    System3 system3;
+
+    cusp::spgemm_numeric(select_system(system1,system2,system3), A, B, C, plan);
+}
+
+inline void set_spgemm_workspace_limit(const size_t bytes)
+{
+    cusp::system::detail::generic::spgemm_workspace_limit_state() = bytes;
+}
+
+inline size_t spgemm_workspace_limit(void)
+{
+    return cusp::system::detail::generic::spgemm_workspace_limit_state();
+}
+
 } // end namespace cusp
 
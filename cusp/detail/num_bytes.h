@@ -0,0 +1,157 @@
+/*
+ *  Copyright 2008-2014 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+
+/*! \file num_bytes.h
+ *  \brief Storage size of containers and operators
+ */
+
+#pragma once
+
+#include <cusp/detail/config.h>
+#include <cusp/detail/format.h>
+
+#include <cstddef>
+
+namespace cusp
+{
+
+template <typename> class constant_array;
+
+namespace detail
+{
+
+template <typename ArrayType>
+size_t num_bytes(const ArrayType& x, cusp::array1d_format)
+{
+    return x.size() * sizeof(typename ArrayType::value_type);
+}
+
+// e.g. the implicit unit values of a csr_pattern_matrix
+template <typename ValueType>
+size_t num_bytes(const cusp::constant_array<ValueType>&, cusp::array1d_format)
+{
+    return 0;
+}
+
+template <typename ArrayType>
+size_t num_bytes(const ArrayType& x, cusp::array2d_format)
+{
+    return x.values.size() * sizeof(typename ArrayType::value_type);
+}
+
+template <typename MatrixType>
+size_t num_bytes(const MatrixType& A, cusp::coo_format)
+{
+    return num_bytes(A.row_indices, cusp::array1d_format()) +
+           num_bytes(A.column_indices, cusp::array1d_format()) +
+           num_bytes(A.values, cusp::array1d_format());
+}
+
+template <typename MatrixType>
+size_t num_bytes(const MatrixType& A, cusp::csr_format)
+{
+    return num_bytes(A.row_offsets, cusp::array1d_format()) +
+           num_bytes(A.column_indices, cusp::array1d_format()) +
+           num_bytes(A.values, cusp::array1d_format());
+}
+
+template <typename MatrixType>
+size_t num_bytes(const MatrixType& A, cusp::dia_format)
+{
+    return num_bytes(A.diagonal_offsets, cusp::array1d_format()) +
+           num_bytes(A.values, cusp::array2d_format());
+}
+
+template <typename MatrixType>
+size_t num_bytes(const MatrixType& A, cusp::ell_format)
+{
+    return num_bytes(A.column_indices, cusp::array2d_format()) +
+           num_bytes(A.values, cusp::array2d_format());
+}
+
+template <typename MatrixType>
+size_t num_bytes(const MatrixType& A, cusp::hyb_format)
+{
+    return num_bytes(A.ell, cusp::ell_format()) +
+           num_bytes(A.coo, cusp::coo_format());
+}
+
+template <typename MatrixType>
+size_t num_bytes(const MatrixType& A, cusp::sell_format)
+{
+    return num_bytes(A.slice_offsets, cusp::array1d_format()) +
+           num_bytes(A.column_indices, cusp::array1d_format()) +
+           num_bytes(A.values, cusp::array1d_format()) +
+           num_bytes(A.row_permutation, cusp::array1d_format());
+}
+
+template <typename MatrixType>
+size_t num_bytes(const MatrixType& A, cusp::bsr_format)
+{
+    return num_bytes(A.row_offsets, cusp::array1d_format()) +
+           num_bytes(A.column_indices, cusp::array1d_format()) +
+           num_bytes(A.values, cusp::array1d_format());
+}
+
+template <typename MatrixType>
+size_t num_bytes(const MatrixType& A, cusp::dcsr_format)
+{
+    return num_bytes(A.row_offsets, cusp::array1d_format()) +
+           num_bytes(A.block_offsets, cusp::array1d_format()) +
+           num_bytes(A.column_deltas, cusp::array1d_format()) +
+           num_bytes(A.column_indices, cusp::array1d_format()) +
+           num_bytes(A.values, cusp::array1d_format());
+}
+
+template <typename MatrixType>
+size_t num_bytes(const MatrixType& A, cusp::dynamic_csr_format)
+{
+    return num_bytes(A.row_offsets, cusp::array1d_format()) +
+           num_bytes(A.row_lengths, cusp::array1d_format()) +
+           num_bytes(A.column_indices, cusp::array1d_format()) +
+           num_bytes(A.values, cusp::array1d_format());
+}
+
+// other formats are estimated by their entries and row pointers
+template <typename MatrixType>
+size_t num_bytes(const MatrixType& A, cusp::known_format)
+{
+    return (A.num_rows + 1) * sizeof(typename MatrixType::index_type) +
+           A.num_entries * (sizeof(typename MatrixType::index_type) + sizeof(typename MatrixType::value_type));
+}
+
+/*! Number of bytes held by the arrays of a vector or matrix.
+ */
+template <typename MatrixOrVector>
+size_t num_bytes(const MatrixOrVector& x)
+{
+    typename MatrixOrVector::format format;
+
+    return num_bytes(x, format);
+}
+
+/*! Number of bytes held by a smoother or solver. Operators that do not
+ *  provide an overload are reported as zero bytes.
+ */
+template <typename Operator>
+size_t operator_bytes(const Operator&)
+{
+    return 0;
+}
+
+} // end namespace detail
+} // end namespace cusp
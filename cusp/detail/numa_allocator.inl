@@ -0,0 +1,56 @@
+/*
+ *  Copyright 2008-2014 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include <cstring>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+namespace cusp
+{
+
+template <typename T>
+T* numa_allocator<T>
+::allocate(size_t num_elements, const void* hint)
+{
+    T* ptr = Parent::allocate(num_elements);
+
+#ifdef _OPENMP
+    if(num_elements * sizeof(T) < first_touch_threshold)
+        return ptr;
+
+    char* bytes = reinterpret_cast<char*>(ptr);
+
+    #pragma omp parallel
+    {
+        const size_t num_threads = omp_get_num_threads();
+        const size_t thread_id   = omp_get_thread_num();
+
+        // same partition as schedule(static) over the elements
+        const size_t chunk     = num_elements / num_threads;
+        const size_t remainder = num_elements % num_threads;
+        const size_t begin     = thread_id * chunk + (thread_id < remainder ? thread_id : remainder);
+        const size_t end       = begin + chunk + (thread_id < remainder ? 1 : 0);
+
+        std::memset(bytes + begin * sizeof(T), 0, (end - begin) * sizeof(T));
+    }
+#endif
+
+    return ptr;
+}
+
+} // end namespace cusp
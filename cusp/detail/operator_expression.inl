@@ -0,0 +1,354 @@
+/*
+ *  Copyright 2008-2014 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include <cusp/blas/blas.h>
+#include <cusp/exception.h>
+#include <cusp/functional.h>
+#include <cusp/multiply.h>
+
+#include <thrust/functional.h>
+#include <thrust/system/detail/generic/select_system.h>
+
+namespace cusp
+{
+namespace detail
+{
+
+// products of the SpMV scaled by alpha
+template <typename T>
+struct scaled_multiplies : public thrust::binary_function<T,T,T>
+{
+    const T alpha;
+
+    scaled_multiplies(const T alpha)
+        : alpha(alpha) {}
+
+    __host__ __device__
+    T operator()(const T& a, const T& x) const
+    {
+        return alpha * a * x;
+    }
+};
+
+struct expression_operand {};
+struct sparse_operand {};
+struct generic_operand {};
+
+template <typename Operator>
+struct operand_category
+{
+    typedef typename thrust::detail::eval_if<
+              is_operator_expression<Operator>::value,
+              thrust::detail::identity_<expression_operand>,
+              thrust::detail::eval_if<
+                thrust::detail::is_convertible<typename Operator::format,cusp::sparse_format>::value,
+                thrust::detail::identity_<sparse_operand>,
+                thrust::detail::identity_<generic_operand>
+              >
+            >::type type;
+};
+
+// nested expressions apply themselves
+template <typename DerivedPolicy, typename Operator, typename VectorType1, typename VectorType2,
+          typename ValueType, typename WorkspaceType>
+void apply_operand(thrust::execution_policy<DerivedPolicy>& exec,
+                   const Operator& A, const VectorType1& x, VectorType2& y,
+                   const ValueType alpha, const ValueType beta,
+                   WorkspaceType&, expression_operand)
+{
+    A.apply(exec, x, y, alpha, beta);
+}
+
+// y = alpha * A * x + beta * y for sparse matrices, the scales are folded
+// into the initialization and the products of a single SpMV
+template <typename DerivedPolicy, typename Operator, typename VectorType1, typename VectorType2,
+          typename ValueType, typename WorkspaceType>
+void apply_operand(thrust::execution_policy<DerivedPolicy>& exec,
+                   const Operator& A, const VectorType1& x, VectorType2& y,
+                   const ValueType alpha, const ValueType beta,
+                   WorkspaceType&, sparse_operand)
+{
+    typedef typename VectorType2::value_type OutputType;
+
+    if(alpha == ValueType(1) && beta == ValueType(0))
+        cusp::multiply(exec, A, x, y);
+    else if(beta == ValueType(0))
+        cusp::multiply(exec, A, x, y,
+                       cusp::constant_functor<OutputType>(0),
+                       scaled_multiplies<OutputType>(alpha),
+                       thrust::plus<OutputType>());
+    else
+        cusp::multiply(exec, A, x, y,
+                       cusp::multiplies_value<OutputType>(beta),
+                       scaled_multiplies<OutputType>(alpha),
+                       thrust::plus<OutputType>());
+}
+
+// other operators are applied into the workspace unless the result is
+// unscaled and overwrites y
+template <typename DerivedPolicy, typename Operator, typename VectorType1, typename VectorType2,
+          typename ValueType, typename WorkspaceType>
+void apply_operand(thrust::execution_policy<DerivedPolicy>& exec,
+                   const Operator& A, const VectorType1& x, VectorType2& y,
+                   const ValueType alpha, const ValueType beta,
+                   WorkspaceType& workspace, generic_operand)
+{
+    if(alpha == ValueType(1) && beta == ValueType(0))
+    {
+        cusp::multiply(exec, A, x, y);
+        return;
+    }
+
+    workspace.resize(A.num_rows);
+    cusp::multiply(exec, A, x, workspace);
+
+    if(beta == ValueType(0))
+        cusp::blas::axpby(exec, workspace, workspace, y, alpha, ValueType(0));
+    else
+        cusp::blas::axpby(exec, workspace, y, y, alpha, beta);
+}
+
+template <typename DerivedPolicy, typename Operator, typename VectorType1, typename VectorType2,
+          typename ValueType, typename WorkspaceType>
+void apply_operand(thrust::execution_policy<DerivedPolicy>& exec,
+                   const Operator& A, const VectorType1& x, VectorType2& y,
+                   const ValueType alpha, const ValueType beta,
+                   WorkspaceType& workspace)
+{
+    apply_operand(exec, A, x, y, alpha, beta, workspace, typename operand_category<Operator>::type());
+}
+
+template <typename Operator, typename VectorType1, typename VectorType2>
+void select_and_apply(const Operator& A, const VectorType1& x, VectorType2& y)
+{
+    using thrust::system::detail::generic::select_system;
+
+    typedef typename VectorType1::memory_space System1;
+    typedef typename VectorType2::memory_space System2;
+
+    System1 system1;
+    System2 system2;
+
+    A(select_system(system1,system2), x, y);
+}
+
+} // end namespace detail
+
+//////////////////
+// sum_operator //
+//////////////////
+
+template <typename Operator1, typename Operator2>
+sum_operator<Operator1,Operator2>
+::sum_operator(const Operator1& A, const Operator2& B)
+    : Parent(A.num_rows, A.num_cols, A.num_entries + B.num_entries), A(A), B(B)
+{
+    if(A.num_rows != B.num_rows || A.num_cols != B.num_cols)
+        throw cusp::invalid_input_exception("sum_operator operands must have the same shape");
+}
+
+template <typename Operator1, typename Operator2>
+template <typename DerivedPolicy, typename VectorType1, typename VectorType2>
+void
+sum_operator<Operator1,Operator2>
+::apply(thrust::execution_policy<DerivedPolicy>& exec, const VectorType1& x, VectorType2& y,
+        const ValueType alpha, const ValueType beta) const
+{
+    cusp::detail::apply_operand(exec, A, x, y, alpha, beta, workspace);
+    cusp::detail::apply_operand(exec, B, x, y, alpha, ValueType(1), workspace);
+}
+
+template <typename Operator1, typename Operator2>
+template <typename DerivedPolicy, typename VectorType1, typename VectorType2>
+void
+sum_operator<Operator1,Operator2>
+::operator()(thrust::execution_policy<DerivedPolicy>& exec, const VectorType1& x, VectorType2& y) const
+{
+    apply(exec, x, y, ValueType(1), ValueType(0));
+}
+
+template <typename Operator1, typename Operator2>
+template <typename VectorType1, typename VectorType2>
+void
+sum_operator<Operator1,Operator2>
+::operator()(const VectorType1& x, VectorType2& y) const
+{
+    cusp::detail::select_and_apply(*this, x, y);
+}
+
+//////////////////////
+// product_operator //
+//////////////////////
+
+template <typename Operator1, typename Operator2>
+product_operator<Operator1,Operator2>
+::product_operator(const Operator1& A, const Operator2& B)
+    : Parent(A.num_rows, B.num_cols, A.num_entries + B.num_entries), A(A), B(B)
+{
+    if(A.num_cols != B.num_rows)
+        throw cusp::invalid_input_exception("product_operator operands have incompatible shapes");
+}
+
+template <typename Operator1, typename Operator2>
+template <typename DerivedPolicy, typename VectorType1, typename VectorType2>
+void
+product_operator<Operator1,Operator2>
+::apply(thrust::execution_policy<DerivedPolicy>& exec, const VectorType1& x, VectorType2& y,
+        const ValueType alpha, const ValueType beta) const
+{
+    intermediate.resize(B.num_rows);
+
+    cusp::detail::apply_operand(exec, B, x, intermediate, ValueType(1), ValueType(0), workspace);
+    cusp::detail::apply_operand(exec, A, intermediate, y, alpha, beta, workspace);
+}
+
+template <typename Operator1, typename Operator2>
+template <typename DerivedPolicy, typename VectorType1, typename VectorType2>
+void
+product_operator<Operator1,Operator2>
+::operator()(thrust::execution_policy<DerivedPolicy>& exec, const VectorType1& x, VectorType2& y) const
+{
+    apply(exec, x, y, ValueType(1), ValueType(0));
+}
+
+template <typename Operator1, typename Operator2>
+template <typename VectorType1, typename VectorType2>
+void
+product_operator<Operator1,Operator2>
+::operator()(const VectorType1& x, VectorType2& y) const
+{
+    cusp::detail::select_and_apply(*this, x, y);
+}
+
+/////////////////////
+// scaled_operator //
+/////////////////////
+
+template <typename Operator>
+scaled_operator<Operator>
+::scaled_operator(const ValueType alpha, const Operator& A)
+    : Parent(A.num_rows, A.num_cols, A.num_entries), alpha(alpha), A(A)
+{
+}
+
+template <typename Operator>
+template <typename DerivedPolicy, typename VectorType1, typename VectorType2>
+void
+scaled_operator<Operator>
+::apply(thrust::execution_policy<DerivedPolicy>& exec, const VectorType1& x, VectorType2& y,
+        const ValueType scale, const ValueType beta) const
+{
+    cusp::detail::apply_operand(exec, A, x, y, scale * alpha, beta, workspace);
+}
+
+template <typename Operator>
+template <typename DerivedPolicy, typename VectorType1, typename VectorType2>
+void
+scaled_operator<Operator>
+::operator()(thrust::execution_policy<DerivedPolicy>& exec, const VectorType1& x, VectorType2& y) const
+{
+    apply(exec, x, y, ValueType(1), ValueType(0));
+}
+
+template <typename Operator>
+template <typename VectorType1, typename VectorType2>
+void
+scaled_operator<Operator>
+::operator()(const VectorType1& x, VectorType2& y) const
+{
+    cusp::detail::select_and_apply(*this, x, y);
+}
+
+//////////////////////
+// shifted_operator //
+//////////////////////
+
+template <typename Operator>
+shifted_operator<Operator>
+::shifted_operator(const Operator& A, const ValueType sigma)
+    : Parent(A.num_rows, A.num_cols, A.num_entries + A.num_rows), A(A), sigma(sigma)
+{
+    if(A.num_rows != A.num_cols)
+        throw cusp::invalid_input_exception("shifted_operator operand must be square");
+}
+
+template <typename Operator>
+template <typename DerivedPolicy, typename VectorType1, typename VectorType2>
+void
+shifted_operator<Operator>
+::apply(thrust::execution_policy<DerivedPolicy>& exec, const VectorType1& x, VectorType2& y,
+        const ValueType alpha, const ValueType beta) const
+{
+    // y = alpha * sigma * x + beta * y, then A accumulates onto y
+    if(beta == ValueType(0))
+        cusp::blas::axpby(exec, x, x, y, alpha * sigma, ValueType(0));
+    else
+        cusp::blas::axpby(exec, x, y, y, alpha * sigma, beta);
+
+    cusp::detail::apply_operand(exec, A, x, y, alpha, ValueType(1), workspace);
+}
+
+template <typename Operator>
+template <typename DerivedPolicy, typename VectorType1, typename VectorType2>
+void
+shifted_operator<Operator>
+::operator()(thrust::execution_policy<DerivedPolicy>& exec, const VectorType1& x, VectorType2& y) const
+{
+    apply(exec, x, y, ValueType(1), ValueType(0));
+}
+
+template <typename Operator>
+template <typename VectorType1, typename VectorType2>
+void
+shifted_operator<Operator>
+::operator()(const VectorType1& x, VectorType2& y) const
+{
+    cusp::detail::select_and_apply(*this, x, y);
+}
+
+///////////////
+// Factories //
+///////////////
+
+template <typename Operator1, typename Operator2>
+sum_operator<Operator1,Operator2>
+sum(const Operator1& A, const Operator2& B)
+{
+    return sum_operator<Operator1,Operator2>(A, B);
+}
+
+template <typename Operator1, typename Operator2>
+product_operator<Operator1,Operator2>
+product(const Operator1& A, const Operator2& B)
+{
+    return product_operator<Operator1,Operator2>(A, B);
+}
+
+template <typename Operator>
+scaled_operator<Operator>
+scaled(const typename Operator::value_type alpha, const Operator& A)
+{
+    return scaled_operator<Operator>(alpha, A);
+}
+
+template <typename Operator>
+shifted_operator<Operator>
+shifted(const Operator& A, const typename Operator::value_type sigma)
+{
+    return shifted_operator<Operator>(A, sigma);
+}
+
+} // end namespace cusp
@@ -0,0 +1,191 @@
+/*
+ *  Copyright 2008-2014 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+
+#include <cusp/copy.h>
+#include <cusp/exception.h>
+#include <cusp/multiply.h>
+
+#include <thrust/for_each.h>
+#include <thrust/gather.h>
+#include <thrust/scatter.h>
+#include <thrust/iterator/counting_iterator.h>
+#include <thrust/system/detail/generic/select_system.h>
+
+namespace cusp
+{
+namespace detail
+{
+
+// one thread per row of P A P^T: row i reads row inverse[i] of A and
+// gathers x through the permutation of the column indices
+template <typename IndexType, typename ValueType, typename Iterator1, typename Iterator2>
+struct permuted_csr_spmv_functor
+{
+    const IndexType * Ap;
+    const IndexType * Aj;
+    const ValueType * Ax;
+    const IndexType * permutation;
+    const IndexType * inverse;
+    Iterator1 x;
+    Iterator2 y;
+
+    permuted_csr_spmv_functor(const IndexType * Ap, const IndexType * Aj, const ValueType * Ax,
+                              const IndexType * permutation, const IndexType * inverse,
+                              Iterator1 x, Iterator2 y)
+        : Ap(Ap), Aj(Aj), Ax(Ax), permutation(permutation), inverse(inverse), x(x), y(y) {}
+
+    __host__ __device__
+    void operator()(const IndexType i) const
+    {
+        const IndexType row = inverse[i];
+
+        ValueType sum = 0;
+
+        for(IndexType jj = Ap[row]; jj < Ap[row + 1]; jj++)
+            sum += Ax[jj] * x[permutation[Aj[jj]]];
+
+        y[i] = sum;
+    }
+};
+
+template <typename ArrayType>
+const typename ArrayType::value_type * permuted_pointer(const ArrayType& array)
+{
+    return array.size() == 0 ? 0 : thrust::raw_pointer_cast(&array[0]);
+}
+
+} // end namespace detail
+
+template <typename ArrayType1, typename ArrayType2>
+cusp::array1d_view< thrust::permutation_iterator<typename ArrayType1::iterator, typename ArrayType2::const_iterator> >
+make_permuted_array1d_view(ArrayType1& v, const ArrayType2& indices)
+{
+    typedef thrust::permutation_iterator<typename ArrayType1::iterator, typename ArrayType2::const_iterator> Iterator;
+
+    Iterator first(v.begin(), indices.begin());
+
+    return cusp::array1d_view<Iterator>(first, first + indices.size());
+}
+
+template <typename ArrayType1, typename ArrayType2>
+cusp::array1d_view< thrust::permutation_iterator<typename ArrayType1::const_iterator, typename ArrayType2::const_iterator> >
+make_permuted_array1d_view(const ArrayType1& v, const ArrayType2& indices)
+{
+    typedef thrust::permutation_iterator<typename ArrayType1::const_iterator, typename ArrayType2::const_iterator> Iterator;
+
+    Iterator first(v.begin(), indices.begin());
+
+    return cusp::array1d_view<Iterator>(first, first + indices.size());
+}
+
+//////////////////
+// Constructors //
+//////////////////
+
+template <typename MatrixType>
+template <typename PermutationType>
+permuted_operator<MatrixType>
+::permuted_operator(const MatrixType& A, const PermutationType& P)
+    : Parent(A.num_rows, A.num_cols, A.num_entries),
+      permutation(P.permutation), inverse(P.permutation.size()), A(&A)
+{
+    if(A.num_rows != A.num_cols)
+        throw cusp::invalid_input_exception("permuted_operator requires a square matrix");
+
+    if(P.num_rows != A.num_rows)
+        throw cusp::invalid_input_exception("permutation size does not match the matrix");
+
+    thrust::scatter(thrust::counting_iterator<IndexType>(0),
+                    thrust::counting_iterator<IndexType>(permutation.size()),
+                    permutation.begin(),
+                    inverse.begin());
+}
+
+//////////////////////
+// Member Functions //
+//////////////////////
+
+template <typename MatrixType>
+template <typename DerivedPolicy, typename VectorType1, typename VectorType2>
+void
+permuted_operator<MatrixType>
+::operator()(thrust::execution_policy<DerivedPolicy>& exec, const VectorType1& x, VectorType2& y) const
+{
+    apply(exec, x, y, typename MatrixType::format());
+}
+
+template <typename MatrixType>
+template <typename VectorType1, typename VectorType2>
+void
+permuted_operator<MatrixType>
+::operator()(const VectorType1& x, VectorType2& y) const
+{
+    using thrust::system::detail::generic::select_system;
+
+    typedef typename VectorType1::memory_space System1;
+    typedef typename VectorType2::memory_space System2;
+
+    MemorySpace system1;
+    System1     system2;
+    System2     system3;
+
+    apply(select_system(system1,system2,system3), x, y, typename MatrixType::format());
+}
+
+template <typename MatrixType>
+template <typename DerivedPolicy, typename VectorType1, typename VectorType2>
+void
+permuted_operator<MatrixType>
+::apply(const thrust::detail::execution_policy_base<DerivedPolicy>& policy, const VectorType1& x, VectorType2& y, cusp::csr_format) const
+{
+    DerivedPolicy& exec = thrust::detail::derived_cast(thrust::detail::strip_const(policy));
+
+    typedef detail::permuted_csr_spmv_functor<IndexType, ValueType,
+                                              typename VectorType1::const_iterator,
+                                              typename VectorType2::iterator> Functor;
+
+    thrust::for_each(exec,
+                     thrust::counting_iterator<IndexType>(0),
+                     thrust::counting_iterator<IndexType>(A->num_rows),
+                     Functor(detail::permuted_pointer(A->row_offsets),
+                             detail::permuted_pointer(A->column_indices),
+                             detail::permuted_pointer(A->values),
+                             detail::permuted_pointer(permutation),
+                             detail::permuted_pointer(inverse),
+                             x.begin(), y.begin()));
+}
+
+template <typename MatrixType>
+template <typename DerivedPolicy, typename VectorType1, typename VectorType2, typename Format>
+void
+permuted_operator<MatrixType>
+::apply(const thrust::detail::execution_policy_base<DerivedPolicy>& policy, const VectorType1& x, VectorType2& y, Format) const
+{
+    DerivedPolicy& exec = thrust::detail::derived_cast(thrust::detail::strip_const(policy));
+
+    // P^T x in the order of A, then P (A P^T x)
+    x_workspace.resize(A->num_cols);
+    y_workspace.resize(A->num_rows);
+
+    thrust::gather(exec, permutation.begin(), permutation.end(), x.begin(), x_workspace.begin());
+
+    cusp::multiply(exec, *A, x_workspace, y_workspace);
+
+    thrust::gather(exec, inverse.begin(), inverse.end(), y_workspace.begin(), y.begin());
+}
+
+} // end namespace cusp
@@ -0,0 +1,62 @@
+/*
+ *  Copyright 2008-2014 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+
+#include <new>
+
+#if THRUST_DEVICE_SYSTEM == THRUST_DEVICE_SYSTEM_CUDA
+#include <cuda_runtime_api.h>
+#endif
+
+namespace cusp
+{
+
+template <typename T>
+T* pinned_allocator<T>
+::allocate(size_t num_elements, const void* hint)
+{
+#if THRUST_DEVICE_SYSTEM == THRUST_DEVICE_SYSTEM_CUDA
+    if(num_elements == 0)
+        return 0;
+
+    void* ptr = 0;
+
+    if(cudaMallocHost(&ptr, num_elements * sizeof(T)) != cudaSuccess)
+    {
+        // clear the error state of the runtime
+        cudaGetLastError();
+        throw std::bad_alloc();
+    }
+
+    return static_cast<T*>(ptr);
+#else
+    return Parent::allocate(num_elements);
+#endif
+}
+
+template <typename T>
+void pinned_allocator<T>
+::deallocate(T* ptr, size_t num_elements)
+{
+#if THRUST_DEVICE_SYSTEM == THRUST_DEVICE_SYSTEM_CUDA
+    if(ptr != 0)
+        cudaFreeHost(ptr);
+#else
+    Parent::deallocate(ptr, num_elements);
+#endif
+}
+
+} // end namespace cusp
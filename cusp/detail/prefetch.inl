@@ -0,0 +1,178 @@
+/*
+ *  Copyright 2008-2014 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+
+#include <cusp/detail/format.h>
+
+#include <thrust/memory.h>
+#include <thrust/detail/type_traits.h>
+
+#if THRUST_DEVICE_SYSTEM == THRUST_DEVICE_SYSTEM_CUDA
+#include <cuda_runtime_api.h>
+#endif
+
+namespace cusp
+{
+namespace detail
+{
+
+#if THRUST_DEVICE_SYSTEM == THRUST_DEVICE_SYSTEM_CUDA
+
+inline int location_device(cusp::host_memory)
+{
+    return cudaCpuDeviceId;
+}
+
+inline int location_device(cusp::device_memory)
+{
+    int device = 0;
+    cudaGetDevice(&device);
+    return device;
+}
+
+// hints are optional, failures (e.g. devices without concurrent managed
+// access) are cleared from the error state of the runtime and ignored
+struct prefetch_range
+{
+    int device;
+
+    prefetch_range(int device) : device(device) {}
+
+    void operator()(const void* ptr, size_t num_bytes) const
+    {
+        if(cudaMemPrefetchAsync(ptr, num_bytes, device, 0) != cudaSuccess)
+            cudaGetLastError();
+    }
+};
+
+struct advise_range
+{
+    cudaMemoryAdvise advice;
+    int device;
+
+    advise_range(memory_advice advice, int device)
+        : advice(advice == advise_read_mostly        ? cudaMemAdviseSetReadMostly :
+                 advice == advise_preferred_location ? cudaMemAdviseSetPreferredLocation :
+                                                       cudaMemAdviseSetAccessedBy),
+          device(device) {}
+
+    void operator()(const void* ptr, size_t num_bytes) const
+    {
+        if(cudaMemAdvise(ptr, num_bytes, advice, device) != cudaSuccess)
+            cudaGetLastError();
+    }
+};
+
+template <typename Array, typename RangeOperation>
+void apply_to_storage(const Array& a, const RangeOperation& op)
+{
+    typedef typename Array::value_type ValueType;
+
+    if(a.size() > 0)
+        op(thrust::raw_pointer_cast(&a[0]), a.size() * sizeof(ValueType));
+}
+
+template <typename MatrixType, typename RangeOperation>
+void apply_to_storage(const MatrixType& A, const RangeOperation& op, cusp::array1d_format)
+{
+    apply_to_storage(A, op);
+}
+
+template <typename MatrixType, typename RangeOperation>
+void apply_to_storage(const MatrixType& A, const RangeOperation& op, cusp::array2d_format)
+{
+    apply_to_storage(A.values, op);
+}
+
+template <typename MatrixType, typename RangeOperation>
+void apply_to_storage(const MatrixType& A, const RangeOperation& op, cusp::coo_format)
+{
+    apply_to_storage(A.row_indices, op);
+    apply_to_storage(A.column_indices, op);
+    apply_to_storage(A.values, op);
+}
+
+template <typename MatrixType, typename RangeOperation>
+void apply_to_storage(const MatrixType& A, const RangeOperation& op, cusp::csr_format)
+{
+    apply_to_storage(A.row_offsets, op);
+    apply_to_storage(A.column_indices, op);
+    apply_to_storage(A.values, op);
+}
+
+template <typename MatrixType, typename RangeOperation>
+void apply_to_storage(const MatrixType& A, const RangeOperation& op, cusp::dia_format)
+{
+    apply_to_storage(A.diagonal_offsets, op);
+    apply_to_storage(A.values.values, op);
+}
+
+template <typename MatrixType, typename RangeOperation>
+void apply_to_storage(const MatrixType& A, const RangeOperation& op, cusp::ell_format)
+{
+    apply_to_storage(A.column_indices.values, op);
+    apply_to_storage(A.values.values, op);
+}
+
+template <typename MatrixType, typename RangeOperation>
+void apply_to_storage(const MatrixType& A, const RangeOperation& op, cusp::hyb_format)
+{
+    apply_to_storage(A.ell, op, cusp::ell_format());
+    apply_to_storage(A.coo, op, cusp::coo_format());
+}
+
+template <typename MatrixType, typename RangeOperation>
+void apply_to_managed_storage(const MatrixType& A, const RangeOperation& op, thrust::detail::true_type)
+{
+    apply_to_storage(A, op, typename MatrixType::format());
+}
+
+// only managed containers take hints
+template <typename MatrixType, typename RangeOperation>
+void apply_to_managed_storage(const MatrixType& A, const RangeOperation& op, thrust::detail::false_type)
+{
+}
+
+template <typename MatrixType, typename RangeOperation>
+void apply_to_managed_storage(const MatrixType& A, const RangeOperation& op)
+{
+    typedef typename thrust::detail::is_same<typename MatrixType::memory_space,
+                                             cusp::managed_memory>::type IsManaged;
+
+    apply_to_managed_storage(A, op, IsManaged());
+}
+
+#endif
+
+} // end namespace detail
+
+template <typename MatrixType, typename MemorySpace>
+void prefetch(const MatrixType& A, MemorySpace location)
+{
+#if THRUST_DEVICE_SYSTEM == THRUST_DEVICE_SYSTEM_CUDA
+    cusp::detail::apply_to_managed_storage(A, cusp::detail::prefetch_range(cusp::detail::location_device(location)));
+#endif
+}
+
+template <typename MatrixType, typename MemorySpace>
+void advise(const MatrixType& A, memory_advice advice, MemorySpace location)
+{
+#if THRUST_DEVICE_SYSTEM == THRUST_DEVICE_SYSTEM_CUDA
+    cusp::detail::apply_to_managed_storage(A, cusp::detail::advise_range(advice, cusp::detail::location_device(location)));
+#endif
+}
+
+} // end namespace cusp
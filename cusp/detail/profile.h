@@ -0,0 +1,172 @@
+/*
+ *  Copyright 2008-2014 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+
+/*! \file profile.h
+ *  \brief Named ranges shown on the timeline of NVTX based profilers
+ */
+
+#pragma once
+
+#include <cusp/detail/config.h>
+
+#include <cusp/memory_tracker.h>
+
+// Ranges are compiled in when CUSP_NVTX_RANGES is 1, the application then
+// links with -lnvToolsExt. Otherwise a range is an empty object.
+#ifndef CUSP_NVTX_RANGES
+#define CUSP_NVTX_RANGES 0
+#endif
+
+// with CUSP_MEMORY_TRACKING the ranges also attribute the allocations made
+// inside them to their name, see cusp::memory_scope
+#define CUSP_PROFILE_RANGES (CUSP_NVTX_RANGES || CUSP_MEMORY_TRACKING)
+
+#if CUSP_NVTX_RANGES
+#include <nvToolsExt.h>
+#include <cstdio>
+#endif
+
+namespace cusp
+{
+namespace detail
+{
+
+// marks the interval from construction, or the last call to start, until
+// destruction or stop, with the given name in the profiler timeline. The
+// ranges are identified by handles rather than pushed on the thread stack,
+// so a range may outlive the scope that started it. Names must outlive
+// the range.
+class profile_range
+{
+public:
+
+    profile_range(void)
+#if CUSP_PROFILE_RANGES
+      : active(false)
+#endif
+    {}
+
+    explicit profile_range(const char* name)
+#if CUSP_PROFILE_RANGES
+      : active(false)
+#endif
+    {
+        start(name);
+    }
+
+    // the name is followed by the index, e.g. the level of a hierarchy
+    profile_range(const char* name, const size_t index)
+#if CUSP_PROFILE_RANGES
+      : active(false)
+#endif
+    {
+        start(name, index);
+    }
+
+    // copies do not own the range of the original
+    profile_range(const profile_range&)
+#if CUSP_PROFILE_RANGES
+      : active(false)
+#endif
+    {}
+
+    profile_range& operator=(const profile_range&)
+    {
+        return *this;
+    }
+
+    ~profile_range(void)
+    {
+        stop();
+    }
+
+    // ends the current range and starts a new one
+    void start(const char* name)
+    {
+#if CUSP_PROFILE_RANGES
+        stop();
+#if CUSP_NVTX_RANGES
+        id = nvtxRangeStartA(name);
+#endif
+#if CUSP_MEMORY_TRACKING
+        memory_token = push_memory_operation(name, 0, false);
+#endif
+        active = true;
+#else
+        (void) name;
+#endif
+    }
+
+    void start(const char* name, const size_t index)
+    {
+#if CUSP_PROFILE_RANGES
+        stop();
+#if CUSP_NVTX_RANGES
+        char label[128];
+        std::sprintf(label, "%.100s %lu", name, (unsigned long) index);
+        id = nvtxRangeStartA(label);
+#endif
+#if CUSP_MEMORY_TRACKING
+        memory_token = push_memory_operation(name, index, true);
+#endif
+        active = true;
+#else
+        (void) name;
+        (void) index;
+#endif
+    }
+
+    void stop(void)
+    {
+#if CUSP_PROFILE_RANGES
+        if (active)
+        {
+#if CUSP_NVTX_RANGES
+            nvtxRangeEnd(id);
+#endif
+#if CUSP_MEMORY_TRACKING
+            pop_memory_operation(memory_token);
+#endif
+        }
+        active = false;
+#endif
+    }
+
+    bool is_active(void) const
+    {
+#if CUSP_PROFILE_RANGES
+        return active;
+#else
+        return false;
+#endif
+    }
+
+private:
+
+#if CUSP_NVTX_RANGES
+    nvtxRangeId_t id;
+#endif
+#if CUSP_MEMORY_TRACKING
+    size_t        memory_token;
+#endif
+#if CUSP_PROFILE_RANGES
+    bool          active;
+#endif
+};
+
+} // end namespace detail
+} // end namespace cusp
@@ -0,0 +1,211 @@
+/*
+ *  Copyright 2008-2014 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include <ios>
+
+namespace cusp
+{
+
+// pending events are polled once this many calls are outstanding, which
+// bounds the number of events without waiting for the device
+#define CUSP_PROFILING_MAX_PENDING 64
+
+inline
+profiling_log::entry
+::entry(void)
+    : calls(0), wall_time(0), kernel_time(0), bytes_read(0), bytes_written(0)
+{
+}
+
+inline
+profiling_log
+::profiling_log(void)
+{
+}
+
+inline
+profiling_log
+::~profiling_log(void)
+{
+#if THRUST_DEVICE_SYSTEM == THRUST_DEVICE_SYSTEM_CUDA
+    for (size_t i = 0; i < m_pending.size(); i++)
+    {
+        cudaEventDestroy(m_pending[i].start);
+        cudaEventDestroy(m_pending[i].stop);
+    }
+
+    for (size_t i = 0; i < m_free_events.size(); i++)
+        cudaEventDestroy(m_free_events[i]);
+#endif
+}
+
+inline
+void
+profiling_log
+::record(const char* name, const double seconds,
+         const size_t bytes_read, const size_t bytes_written)
+{
+    entry& e = m_entries[name];
+
+    e.calls         += 1;
+    e.wall_time     += seconds;
+    e.bytes_read    += bytes_read;
+    e.bytes_written += bytes_written;
+}
+
+#if THRUST_DEVICE_SYSTEM == THRUST_DEVICE_SYSTEM_CUDA
+inline
+void
+profiling_log
+::record(const char* name, const double seconds,
+         const size_t bytes_read, const size_t bytes_written,
+         cudaEvent_t start, cudaEvent_t stop)
+{
+    record(name, seconds, bytes_read, bytes_written);
+
+    pending_call call;
+    call.target = &m_entries[name];
+    call.start  = start;
+    call.stop   = stop;
+
+    m_pending.push_back(call);
+
+    if (m_pending.size() >= CUSP_PROFILING_MAX_PENDING)
+        resolve(false);
+}
+
+inline
+cudaEvent_t
+profiling_log
+::event(void)
+{
+    cudaEvent_t e;
+
+    if (m_free_events.empty())
+    {
+        cudaEventCreate(&e);
+    }
+    else
+    {
+        e = m_free_events.back();
+        m_free_events.pop_back();
+    }
+
+    return e;
+}
+#endif
+
+inline
+void
+profiling_log
+::resolve(const bool wait) const
+{
+#if THRUST_DEVICE_SYSTEM == THRUST_DEVICE_SYSTEM_CUDA
+    // the events complete in the order they were recorded
+    size_t completed = 0;
+
+    for (; completed < m_pending.size(); completed++)
+    {
+        const pending_call& call = m_pending[completed];
+
+        if (wait)
+            cudaEventSynchronize(call.stop);
+        else if (cudaEventQuery(call.stop) != cudaSuccess)
+            break;
+
+        float milliseconds = 0;
+        cudaEventElapsedTime(&milliseconds, call.start, call.stop);
+
+        call.target->kernel_time += 1e-3 * milliseconds;
+
+        m_free_events.push_back(call.start);
+        m_free_events.push_back(call.stop);
+    }
+
+    m_pending.erase(m_pending.begin(), m_pending.begin() + completed);
+#else
+    (void) wait;
+#endif
+}
+
+inline
+const profiling_log::entry_map&
+profiling_log
+::entries(void) const
+{
+    resolve(true);
+
+    return m_entries;
+}
+
+inline
+profiling_log::entry
+profiling_log
+::operator[](const std::string& name) const
+{
+    resolve(true);
+
+    entry_map::const_iterator iter = m_entries.find(name);
+
+    return iter == m_entries.end() ? entry() : iter->second;
+}
+
+inline
+void
+profiling_log
+::reset(void)
+{
+    resolve(true);
+
+    m_entries.clear();
+}
+
+inline
+void
+profiling_log
+::write_json(std::ostream& os) const
+{
+    resolve(true);
+
+    std::ios::fmtflags flags = os.flags();
+    std::streamsize precision = os.precision(9);
+
+    os.unsetf(std::ios::floatfield);
+
+    os << "{";
+
+    for (entry_map::const_iterator iter = m_entries.begin(); iter != m_entries.end(); ++iter)
+    {
+        const entry& e = iter->second;
+
+        os << (iter == m_entries.begin() ? "\n" : ",\n");
+        os << "  \"" << iter->first << "\": {"
+           << "\"calls\": "            << e.calls         << ", "
+           << "\"wall_seconds\": "     << e.wall_time     << ", "
+           << "\"kernel_seconds\": "   << e.kernel_time   << ", "
+           << "\"bytes_read\": "       << e.bytes_read    << ", "
+           << "\"bytes_written\": "    << e.bytes_written << "}";
+    }
+
+    os << (m_entries.empty() ? "}\n" : "\n}\n");
+
+    os.flags(flags);
+    os.precision(precision);
+}
+
+#undef CUSP_PROFILING_MAX_PENDING
+
+} // end namespace cusp
@@ -0,0 +1,126 @@
+/*
+ *  Copyright 2008-2014 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include <cusp/detail/utils.h>
+
+#include <thrust/swap.h>
+
+namespace cusp
+{
+
+// Forward definitions
+template <typename T1, typename T2> void convert(const T1&, T2&);
+
+//////////////////
+// Constructors //
+//////////////////
+
+template <typename IndexType, typename ValueType, class MemorySpace>
+sell_matrix<IndexType,ValueType,MemorySpace>
+::sell_matrix(const size_t num_rows, const size_t num_cols, const size_t num_entries,
+              const size_t num_stored_entries, const size_t slice_size)
+    : Parent(num_rows, num_cols, num_entries),
+      slice_size(slice_size),
+      sigma(1024),
+      slice_offsets(cusp::detail::divide_into(num_rows, slice_size) + 1),
+      column_indices(num_stored_entries),
+      values(num_stored_entries),
+      row_permutation(num_rows) {}
+
+// construct from a different matrix
+template <typename IndexType, typename ValueType, class MemorySpace>
+template <typename MatrixType>
+sell_matrix<IndexType,ValueType,MemorySpace>
+::sell_matrix(const MatrixType& matrix)
+    : slice_size(32), sigma(1024)
+{
+    cusp::convert(matrix, *this);
+}
+
+//////////////////////
+// Member Functions //
+//////////////////////
+
+template <typename IndexType, typename ValueType, class MemorySpace>
+void
+sell_matrix<IndexType,ValueType,MemorySpace>
+::resize(const size_t num_rows, const size_t num_cols, const size_t num_entries,
+         const size_t num_stored_entries)
+{
+    Parent::resize(num_rows, num_cols, num_entries);
+    slice_offsets.resize(cusp::detail::divide_into(num_rows, slice_size) + 1);
+    column_indices.resize(num_stored_entries);
+    values.resize(num_stored_entries);
+    row_permutation.resize(num_rows);
+}
+
+template <typename IndexType, typename ValueType, class MemorySpace>
+void
+sell_matrix<IndexType,ValueType,MemorySpace>
+::resize(const size_t num_rows, const size_t num_cols, const size_t num_entries,
+         const size_t num_stored_entries, const size_t slice_size)
+{
+    this->slice_size = slice_size;
+    resize(num_rows, num_cols, num_entries, num_stored_entries);
+}
+
+template <typename IndexType, typename ValueType, class MemorySpace>
+void
+sell_matrix<IndexType,ValueType,MemorySpace>
+::swap(sell_matrix& matrix)
+{
+    Parent::swap(matrix);
+    thrust::swap(slice_size, matrix.slice_size);
+    thrust::swap(sigma,      matrix.sigma);
+    slice_offsets.swap(matrix.slice_offsets);
+    column_indices.swap(matrix.column_indices);
+    values.swap(matrix.values);
+    row_permutation.swap(matrix.row_permutation);
+}
+
+// assignment from another matrix
+template <typename IndexType, typename ValueType, class MemorySpace>
+template <typename MatrixType>
+sell_matrix<IndexType,ValueType,MemorySpace>&
+sell_matrix<IndexType,ValueType,MemorySpace>
+::operator=(const MatrixType& matrix)
+{
+    cusp::convert(matrix, *this);
+
+    return *this;
+}
+
+///////////////////////////
+// View Member Functions //
+///////////////////////////
+
+template <typename ArrayType1, typename ArrayType2, typename ArrayType3, typename ArrayType4,
+          typename IndexType, typename ValueType, typename MemorySpace>
+void
+sell_matrix_view<ArrayType1,ArrayType2,ArrayType3,ArrayType4,IndexType,ValueType,MemorySpace>
+::resize(const size_t num_rows, const size_t num_cols, const size_t num_entries,
+         const size_t num_stored_entries)
+{
+    Parent::resize(num_rows, num_cols, num_entries);
+    slice_offsets.resize(cusp::detail::divide_into(num_rows, slice_size) + 1);
+    column_indices.resize(num_stored_entries);
+    values.resize(num_stored_entries);
+    row_permutation.resize(num_rows);
+}
+
+} // end namespace cusp
+
+#include <cusp/convert.h>
@@ -161,5 +161,55 @@ void sort_by_row_and_column(ArrayType1& row_indices,
     return cusp::sort_by_row_and_column(select_system(system1,system2,system3), row_indices, column_indices, values, min_row, max_row, min_col, max_col);
 }
 
+template <typename DerivedPolicy,
+          typename ArrayType>
+bool is_sorted_by_row(const thrust::detail::execution_policy_base<DerivedPolicy> &exec,
+                      const ArrayType& row_indices)
+{
+    using cusp::system::detail::generic::is_sorted_by_row;
+
+    return is_sorted_by_row(thrust::detail::derived_cast(thrust::detail::strip_const(exec)), row_indices);
+}
+
+template <typename ArrayType>
+bool is_sorted_by_row(const ArrayType& row_indices)
+{
+    using thrust::system::detail::generic::select_system;
+
+    typedef typename ArrayType::memory_space System;
+
+    System system;
+
+    return cusp::is_sorted_by_row(select_system(system), row_indices);
+}
+
+template <typename DerivedPolicy,
+          typename ArrayType1,
+          typename ArrayType2>
+bool is_sorted_by_row_and_column(const thrust::detail::execution_policy_base<DerivedPolicy> &exec,
+                                 const ArrayType1& row_indices,
+                                 const ArrayType2& column_indices)
+{
+    using cusp::system::detail::generic::is_sorted_by_row_and_column;
+
+    return is_sorted_by_row_and_column(thrust::detail::derived_cast(thrust::detail::strip_const(exec)), row_indices, column_indices);
+}
+
+template <typename ArrayType1,
+          typename ArrayType2>
+bool is_sorted_by_row_and_column(const ArrayType1& row_indices,
+                                 const ArrayType2& column_indices)
+{
+    using thrust::system::detail::generic::select_system;
+
+    typedef typename ArrayType1::memory_space System1;
+    typedef typename ArrayType2::memory_space System2;
+
+    System1 system1;
+    System2 system2;
+
+    return cusp::is_sorted_by_row_and_column(select_system(system1,system2), row_indices, column_indices);
+}
+
 } // end namespace cusp
 
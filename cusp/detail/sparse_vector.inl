@@ -0,0 +1,91 @@
+/*
+ *  Copyright 2008-2014 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include <thrust/copy.h>
+#include <thrust/count.h>
+#include <thrust/swap.h>
+
+#include <thrust/iterator/counting_iterator.h>
+#include <thrust/iterator/zip_iterator.h>
+
+namespace cusp
+{
+namespace detail
+{
+
+template <typename ValueType>
+struct sparse_vector_nonzero
+{
+    __host__ __device__
+    bool operator()(const ValueType& v) const
+    {
+        return v != ValueType(0);
+    }
+};
+
+} // end namespace detail
+
+//////////////////
+// Constructors //
+//////////////////
+
+// keeps the nonzero entries of a dense array
+template <typename IndexType, typename ValueType, class MemorySpace>
+template <typename ArrayType>
+sparse_vector<IndexType,ValueType,MemorySpace>
+::sparse_vector(const ArrayType& x)
+    : length(x.size()), num_entries(0)
+{
+    cusp::array1d<ValueType,MemorySpace> dense(x);
+
+    detail::sparse_vector_nonzero<ValueType> nonzero;
+
+    resize(length, thrust::count_if(dense.begin(), dense.end(), nonzero));
+
+    thrust::copy_if(thrust::make_zip_iterator(thrust::make_tuple(thrust::counting_iterator<IndexType>(0), dense.begin())),
+                    thrust::make_zip_iterator(thrust::make_tuple(thrust::counting_iterator<IndexType>(0), dense.begin())) + dense.size(),
+                    dense.begin(),
+                    thrust::make_zip_iterator(thrust::make_tuple(indices.begin(), values.begin())),
+                    nonzero);
+}
+
+//////////////////////
+// Member Functions //
+//////////////////////
+
+template <typename IndexType, typename ValueType, class MemorySpace>
+void
+sparse_vector<IndexType,ValueType,MemorySpace>
+::resize(const size_t length, const size_t num_entries)
+{
+    this->length      = length;
+    this->num_entries = num_entries;
+    indices.resize(num_entries);
+    values.resize(num_entries);
+}
+
+template <typename IndexType, typename ValueType, class MemorySpace>
+void
+sparse_vector<IndexType,ValueType,MemorySpace>
+::swap(sparse_vector& v)
+{
+    thrust::swap(length,      v.length);
+    thrust::swap(num_entries, v.num_entries);
+    indices.swap(v.indices);
+    values.swap(v.values);
+}
+
+} // end namespace cusp
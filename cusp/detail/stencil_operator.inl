@@ -0,0 +1,168 @@
+/*
+ *  Copyright 2008-2014 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+
+#include <cusp/exception.h>
+
+#include <cusp/gallery/stencil.h>
+
+#include <cusp/system/detail/adl/stencil_operator.h>
+#include <cusp/system/detail/generic/stencil_operator.h>
+
+#include <thrust/tuple.h>
+#include <thrust/system/detail/generic/select_system.h>
+
+namespace cusp
+{
+
+//////////////////
+// Constructors //
+//////////////////
+
+template <int Dims, int Points, typename ValueType, typename MemorySpace, typename IndexType>
+stencil_operator<Dims,Points,ValueType,MemorySpace,IndexType>
+::stencil_operator(void)
+    : Parent()
+{
+    for(int d = 0; d < Dims; d++)
+        grid[d] = 0;
+
+    for(int p = 0; p < Points; p++)
+    {
+        for(int d = 0; d < Dims; d++)
+            displacements[p][d] = 0;
+
+        coefficients[p] = ValueType(0);
+    }
+}
+
+template <int Dims, int Points, typename ValueType, typename MemorySpace, typename IndexType>
+template <typename StencilPoint, typename MemorySpace2, typename GridDimension>
+stencil_operator<Dims,Points,ValueType,MemorySpace,IndexType>
+::stencil_operator(const cusp::array1d<StencilPoint,MemorySpace2>& stencil,
+                   const GridDimension& grid_dimensions)
+    : Parent()
+{
+    typedef typename thrust::tuple_element<0,StencilPoint>::type StencilIndex;
+
+    if(stencil.size() != size_t(Points))
+        throw cusp::invalid_input_exception("stencil_operator stencil size differs from the number of points");
+
+    if(thrust::tuple_size<GridDimension>::value != Dims || thrust::tuple_size<StencilIndex>::value != Dims)
+        throw cusp::invalid_input_exception("stencil_operator grid and stencil dimensions differ from Dims");
+
+    cusp::array1d<StencilPoint,cusp::host_memory> stencil_host(stencil);
+
+    cusp::gallery::detail::unpack_tuple(grid_dimensions, grid);
+
+    size_t num_rows    = 1;
+    size_t num_entries = 0;
+
+    for(int d = 0; d < Dims; d++)
+        num_rows *= grid[d];
+
+    for(int p = 0; p < Points; p++)
+    {
+        cusp::gallery::detail::unpack_tuple(thrust::get<0>(stencil_host[p]), displacements[p]);
+        coefficients[p] = thrust::get<1>(stencil_host[p]);
+
+        // grid points whose neighbor p lies inside the grid
+        size_t num_inside = 1;
+
+        for(int d = 0; d < Dims; d++)
+        {
+            const IndexType distance = displacements[p][d] < 0 ? -displacements[p][d] : displacements[p][d];
+
+            num_inside *= distance < grid[d] ? size_t(grid[d] - distance) : size_t(0);
+        }
+
+        num_entries += num_inside;
+    }
+
+    Parent::resize(num_rows, num_rows, num_entries);
+}
+
+//////////////////////
+// Member Functions //
+//////////////////////
+
+template <int Dims, int Points, typename ValueType, typename MemorySpace, typename IndexType>
+typename stencil_operator<Dims,Points,ValueType,MemorySpace,IndexType>::descriptor_type
+stencil_operator<Dims,Points,ValueType,MemorySpace,IndexType>
+::descriptor(void) const
+{
+    descriptor_type desc;
+
+    IndexType stride = 1;
+
+    for(int d = 0; d < Dims; d++)
+        desc.grid[d] = grid[d];
+
+    for(int p = 0; p < Points; p++)
+    {
+        desc.offsets[p]      = 0;
+        desc.coefficients[p] = coefficients[p];
+    }
+
+    for(int d = 0; d < Dims; d++)
+    {
+        for(int p = 0; p < Points; p++)
+        {
+            desc.displacements[p][d] = displacements[p][d];
+            desc.offsets[p] += stride * displacements[p][d];
+        }
+
+        stride *= grid[d];
+    }
+
+    desc.values = values.num_entries == 0 ? NULL : thrust::raw_pointer_cast(&values.values[0]);
+    desc.pitch  = values.pitch;
+
+    return desc;
+}
+
+template <int Dims, int Points, typename ValueType, typename MemorySpace, typename IndexType>
+template <typename DerivedPolicy, typename VectorType1, typename VectorType2>
+void
+stencil_operator<Dims,Points,ValueType,MemorySpace,IndexType>
+::operator()(thrust::execution_policy<DerivedPolicy>& exec, const VectorType1& x, VectorType2& y) const
+{
+    using cusp::system::detail::generic::stencil_multiply;
+
+    if(values.num_entries != 0 && (values.num_rows != Parent::num_rows || values.num_cols != size_t(Points)))
+        throw cusp::invalid_input_exception("stencil_operator values must be num_rows by Points");
+
+    stencil_multiply(thrust::detail::derived_cast(exec), *this, x, y);
+}
+
+template <int Dims, int Points, typename ValueType, typename MemorySpace, typename IndexType>
+template <typename VectorType1, typename VectorType2>
+void
+stencil_operator<Dims,Points,ValueType,MemorySpace,IndexType>
+::operator()(const VectorType1& x, VectorType2& y) const
+{
+    using thrust::system::detail::generic::select_system;
+
+    typedef typename VectorType1::memory_space System1;
+    typedef typename VectorType2::memory_space System2;
+
+    System1 system1;
+    System2 system2;
+
+    (*this)(select_system(system1,system2), x, y);
+}
+
+} // end namespace cusp
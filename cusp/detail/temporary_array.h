@@ -75,6 +75,9 @@ public:
     TEMP_HOST_DEVICE_DECORATORS
     temporary_array(int uninit, thrust::execution_policy<System> &system, size_type n) : super_t(uninit, system, n) {};
 
+    TEMP_HOST_DEVICE_DECORATORS
+    temporary_array(thrust::execution_policy<System> &system, size_type n, cusp::no_init_t) : super_t(0, system, n) {};
+
     template<typename InputIterator>
     TEMP_HOST_DEVICE_DECORATORS
     temporary_array(thrust::execution_policy<System> &system,
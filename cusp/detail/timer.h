@@ -0,0 +1,104 @@
+/*
+ *  Copyright 2008-2014 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+
+/*! \file timer.h
+ *  \brief Wall clock timer used to profile setup phases
+ */
+
+#pragma once
+
+#include <cusp/detail/config.h>
+#include <cusp/detail/profile.h>
+
+#if THRUST_DEVICE_SYSTEM == THRUST_DEVICE_SYSTEM_CUDA
+#include <cuda_runtime_api.h>
+#endif
+
+#if defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <sys/time.h>
+#endif
+
+namespace cusp
+{
+namespace detail
+{
+
+// seconds since an arbitrary origin, read from the host clock without
+// waiting for pending device work
+inline double wall_clock_seconds(void)
+{
+#if defined(_WIN32)
+    LARGE_INTEGER frequency, counter;
+    QueryPerformanceFrequency(&frequency);
+    QueryPerformanceCounter(&counter);
+    return double(counter.QuadPart) / double(frequency.QuadPart);
+#else
+    struct timeval tv;
+    gettimeofday(&tv, NULL);
+    return tv.tv_sec + 1e-6 * tv.tv_usec;
+#endif
+}
+
+// measures wall clock time, pending device work is included by
+// synchronizing before every reading. A named timer also marks the timed
+// phase as a profiler range, which ends when the timer is restarted or
+// destroyed.
+class timer
+{
+    double start;
+    profile_range range;
+
+    static double now(void)
+    {
+#if THRUST_DEVICE_SYSTEM == THRUST_DEVICE_SYSTEM_CUDA
+        cudaDeviceSynchronize();
+#endif
+
+        return wall_clock_seconds();
+    }
+
+public:
+
+    timer(void) : start(now()) {}
+
+    explicit timer(const char* phase) : start(now()), range(phase) {}
+
+    void restart(void)
+    {
+        range.stop();
+        start = now();
+    }
+
+    void restart(const char* phase)
+    {
+        start = now();
+        range.start(phase);
+    }
+
+    double seconds_elapsed(void) const
+    {
+        return now() - start;
+    }
+};
+
+} // end namespace detail
+} // end namespace cusp
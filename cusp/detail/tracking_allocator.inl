@@ -0,0 +1,55 @@
+/*
+ *  Copyright 2008-2014 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+
+namespace cusp
+{
+
+template <typename Allocator, typename MemorySpace>
+typename tracking_allocator<Allocator,MemorySpace>::pointer
+tracking_allocator<Allocator,MemorySpace>
+::allocate(size_type num_elements)
+{
+    const size_t num_bytes = num_elements * sizeof(value_type);
+
+    pointer ptr;
+
+    try
+    {
+        ptr = Parent::allocate(num_elements);
+    }
+    catch(...)
+    {
+        cusp::detail::record_failed_allocation<MemorySpace>(num_bytes);
+        throw;
+    }
+
+    cusp::detail::record_allocation<MemorySpace>(num_bytes);
+
+    return ptr;
+}
+
+template <typename Allocator, typename MemorySpace>
+void
+tracking_allocator<Allocator,MemorySpace>
+::deallocate(pointer ptr, size_type num_elements)
+{
+    Parent::deallocate(ptr, num_elements);
+
+    cusp::detail::record_deallocation<MemorySpace>(num_elements * sizeof(value_type));
+}
+
+} // end namespace cusp
@@ -19,6 +19,7 @@
  */
 
 #include <cusp/detail/config.h>
+#include <cusp/detail/profile.h>
 
 #include <cusp/system/detail/adl/transpose.h>
 #include <cusp/system/detail/generic/transpose.h>
@@ -37,6 +38,8 @@ void transpose(const thrust::detail::execution_policy_base<DerivedPolicy>& exec,
 {
     using cusp::system::detail::generic::transpose;
 
+    cusp::detail::profile_range range("cusp::transpose");
+
     return transpose(thrust::detail::derived_cast(thrust::detail::strip_const(exec)), A, At);
 }
 
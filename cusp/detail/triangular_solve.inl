@@ -0,0 +1,100 @@
+/*
+ *  Copyright 2008-2014 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*! \file triangular_solve.inl
+ *  \brief Inline file for triangular_solve.h.
+ */
+
+#include <cusp/detail/config.h>
+
+#include <cusp/system/detail/generic/triangular_solve.h>
+
+#include <thrust/system/detail/generic/select_system.h>
+
+namespace cusp
+{
+
+template <typename DerivedPolicy,
+          typename MatrixType,
+          typename PlanType>
+void triangular_solve_analysis(const thrust::detail::execution_policy_base<DerivedPolicy>& exec,
+                               const MatrixType& A,
+                                     PlanType& plan,
+                               const bool lower,
+                               const bool unit_diagonal)
+{
+    using cusp::system::detail::generic::triangular_solve_analysis;
+
+    triangular_solve_analysis(thrust::detail::derived_cast(thrust::detail::strip_const(exec)), A, plan, lower, unit_diagonal);
+}
+
+template <typename MatrixType,
+          typename PlanType>
+void triangular_solve_analysis(const MatrixType& A,
+                                     PlanType& plan,
+                               const bool lower,
+                               const bool unit_diagonal)
+{
+    using thrust::system::detail::generic::select_system;
+
+    typedef typename MatrixType::memory_space System1;
+    typedef typename PlanType::memory_space   System2;
+
+    System1 system1;
+    System2 system2;
+
+    cusp::triangular_solve_analysis(select_system(system1,system2), A, plan, lower, unit_diagonal);
+}
+
+template <typename DerivedPolicy,
+          typename MatrixType,
+          typename ArrayType1,
+          typename ArrayType2,
+          typename PlanType>
+void triangular_solve(const thrust::detail::execution_policy_base<DerivedPolicy>& exec,
+                      const MatrixType& A,
+                      const ArrayType1& b,
+                            ArrayType2& x,
+                      const PlanType& plan)
+{
+    using cusp::system::detail::generic::triangular_solve;
+
+    triangular_solve(thrust::detail::derived_cast(thrust::detail::strip_const(exec)), A, b, x, plan);
+}
+
+template <typename MatrixType,
+          typename ArrayType1,
+          typename ArrayType2,
+          typename PlanType>
+void triangular_solve(const MatrixType& A,
+                      const ArrayType1& b,
+                            ArrayType2& x,
+                      const PlanType& plan)
+{
+    using thrust::system::detail::generic::select_system;
+
+    typedef typename MatrixType::memory_space System1;
+    typedef typename ArrayType1::memory_space System2;
+    typedef typename ArrayType2::memory_space System3;
+
+    System1 system1;
+    System2 system2;
+    System3 system3;
+
+    cusp::triangular_solve(select_system(system1,system2,system3), A, b, x, plan);
+}
+
+} // end namespace cusp
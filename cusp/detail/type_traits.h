@@ -40,9 +40,13 @@ template <typename, typename>           class array1d;
 template <typename, typename, typename> class array2d;
 template <typename, typename, typename> class dia_matrix;
 template <typename, typename, typename> class coo_matrix;
-template <typename, typename, typename> class csr_matrix;
+template <typename IndexType, typename, typename, typename = IndexType> class csr_matrix;
 template <typename, typename, typename> class ell_matrix;
 template <typename, typename, typename> class hyb_matrix;
+template <typename, typename, typename> class sell_matrix;
+template <typename, typename, typename> class dcsr_matrix;
+template <typename, typename, typename> class dynamic_csr_matrix;
+template <typename, typename, typename> class symmetric_matrix;
 
 template <typename> class array1d_view;
 template <typename, typename, typename, typename, typename, typename> class coo_matrix_view;
@@ -63,6 +67,11 @@ template<typename MatrixType> struct is_csr     : is_matrix_type<MatrixType,csr_
 template<typename MatrixType> struct is_dia     : is_matrix_type<MatrixType,dia_format> {};
 template<typename MatrixType> struct is_ell     : is_matrix_type<MatrixType,ell_format> {};
 template<typename MatrixType> struct is_hyb     : is_matrix_type<MatrixType,hyb_format> {};
+template<typename MatrixType> struct is_sell    : is_matrix_type<MatrixType,sell_format> {};
+template<typename MatrixType> struct is_bsr     : is_matrix_type<MatrixType,bsr_format> {};
+template<typename MatrixType> struct is_dcsr    : is_matrix_type<MatrixType,dcsr_format> {};
+template<typename MatrixType> struct is_dynamic_csr : is_matrix_type<MatrixType,dynamic_csr_format> {};
+template<typename MatrixType> struct is_symmetric : is_matrix_type<MatrixType,symmetric_format> {};
 
 template<typename IndexType, typename ValueType, typename MemorySpace, typename FormatTag> struct matrix_type {};
 
@@ -108,6 +117,30 @@ struct matrix_type<IndexType,ValueType,MemorySpace,hyb_format>
     typedef cusp::hyb_matrix<IndexType,ValueType,MemorySpace> type;
 };
 
+template<typename IndexType, typename ValueType, typename MemorySpace>
+struct matrix_type<IndexType,ValueType,MemorySpace,sell_format>
+{
+    typedef cusp::sell_matrix<IndexType,ValueType,MemorySpace> type;
+};
+
+template<typename IndexType, typename ValueType, typename MemorySpace>
+struct matrix_type<IndexType,ValueType,MemorySpace,dcsr_format>
+{
+    typedef cusp::dcsr_matrix<IndexType,ValueType,MemorySpace> type;
+};
+
+template<typename IndexType, typename ValueType, typename MemorySpace>
+struct matrix_type<IndexType,ValueType,MemorySpace,dynamic_csr_format>
+{
+    typedef cusp::dynamic_csr_matrix<IndexType,ValueType,MemorySpace> type;
+};
+
+template<typename IndexType, typename ValueType, typename MemorySpace>
+struct matrix_type<IndexType,ValueType,MemorySpace,symmetric_format>
+{
+    typedef cusp::symmetric_matrix<IndexType,ValueType,MemorySpace> type;
+};
+
 template<typename MatrixType, typename Format = typename MatrixType::format>
 struct get_index_type
 {
@@ -120,6 +153,19 @@ struct get_index_type<MatrixType,array1d_format>
     typedef int type;
 };
 
+// type of the row offsets, which may be wider than the column indices
+template<typename MatrixType, typename Format = typename MatrixType::format>
+struct get_offset_type
+{
+    typedef typename get_index_type<MatrixType,Format>::type type;
+};
+
+template<typename MatrixType>
+struct get_offset_type<MatrixType,csr_format>
+{
+    typedef typename MatrixType::row_offsets_array_type::value_type type;
+};
+
 template<typename MatrixType, typename MemorySpace, typename FormatTag>
 struct as_matrix_type
 {
@@ -147,6 +193,18 @@ struct as_ell_type : as_matrix_type<MatrixType,MemorySpace,ell_format> {};
 template<typename MatrixType,typename MemorySpace=typename MatrixType::memory_space>
 struct as_hyb_type : as_matrix_type<MatrixType,MemorySpace,hyb_format> {};
 
+template<typename MatrixType,typename MemorySpace=typename MatrixType::memory_space>
+struct as_sell_type : as_matrix_type<MatrixType,MemorySpace,sell_format> {};
+
+template<typename MatrixType,typename MemorySpace=typename MatrixType::memory_space>
+struct as_dcsr_type : as_matrix_type<MatrixType,MemorySpace,dcsr_format> {};
+
+template<typename MatrixType,typename MemorySpace=typename MatrixType::memory_space>
+struct as_dynamic_csr_type : as_matrix_type<MatrixType,MemorySpace,dynamic_csr_format> {};
+
+template<typename MatrixType,typename MemorySpace=typename MatrixType::memory_space>
+struct as_symmetric_type : as_matrix_type<MatrixType,MemorySpace,symmetric_format> {};
+
 template<typename MatrixType,typename FormatTag = typename MatrixType::format>
 struct coo_view_type{};
 
@@ -27,6 +27,12 @@ IntegralType round_up(IntegralType n, IntegralType k)
     return k * ((n + k - 1) / k);
 }
 
+template <typename IntegralType>
+IntegralType divide_into(IntegralType n, IntegralType k)
+{
+    return (n + k - 1) / k;
+}
+
 } // end namespace detail
 } // end namespace cusp
 
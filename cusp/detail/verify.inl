@@ -14,16 +14,30 @@
  *  limitations under the License.
  */
 
+#include <cusp/array1d.h>
+#include <cusp/format_utils.h>
 #include <cusp/detail/format.h>
 #include <cusp/exception.h>
 
-#include <thrust/sort.h>
+#include <thrust/copy.h>
 #include <thrust/count.h>
+#include <thrust/equal.h>
 #include <thrust/extrema.h>
 #include <thrust/functional.h>
+#include <thrust/sort.h>
+#include <thrust/transform_reduce.h>
+#include <thrust/tuple.h>
+#include <thrust/unique.h>
+#include <thrust/iterator/counting_iterator.h>
+#include <thrust/iterator/zip_iterator.h>
 
+#include <algorithm>
 #include <sstream>
 
+// entries (COO) or rows (CSR) checked by one reduction of the validation
+// pass, which stops after the first chunk with an invalid entry
+#define CUSP_VALIDATE_CHUNK_SIZE (1 << 22)
+
 namespace cusp
 {
 namespace detail
@@ -89,6 +103,156 @@ struct is_ell_entry_in_bounds
 };
 
 
+//////////////////////////
+// Fused validation pass //
+//////////////////////////
+//
+// Every entry (COO) or row (CSR) is checked against its predecessor and
+// the bounds of the matrix, and the findings are combined into a mask of
+// flags with a bitwise-or reduction.  The error flags make the matrix
+// invalid, the structure flags only describe it.  Duplicates are found
+// among adjacent entries, so they are exact for sorted matrices only.
+
+enum validate_flags
+{
+    VALIDATE_ROW_NEGATIVE    = 1,
+    VALIDATE_ROW_TOO_LARGE   = 2,
+    VALIDATE_COL_NEGATIVE    = 4,
+    VALIDATE_COL_TOO_LARGE   = 8,
+    VALIDATE_ROW_ORDER       = 16,
+    VALIDATE_OFFSET_ORDER    = 32,
+    VALIDATE_COL_ORDER       = 64,
+    VALIDATE_DUPLICATES      = 128,
+
+    VALIDATE_ERRORS          = 63
+};
+
+template <typename RowIterator, typename ColumnIterator>
+struct validate_coo_entry
+{
+    RowIterator    rows;
+    ColumnIterator cols;
+    long long      num_rows;
+    long long      num_cols;
+
+    validate_coo_entry(RowIterator rows, ColumnIterator cols, long long num_rows, long long num_cols)
+        : rows(rows), cols(cols), num_rows(num_rows), num_cols(num_cols) {}
+
+    __host__ __device__
+    unsigned int operator()(const size_t n) const
+    {
+        const long long i = rows[n];
+        const long long j = cols[n];
+
+        unsigned int flags = 0;
+
+        if (i < 0)         flags |= VALIDATE_ROW_NEGATIVE;
+        if (i >= num_rows) flags |= VALIDATE_ROW_TOO_LARGE;
+        if (j < 0)         flags |= VALIDATE_COL_NEGATIVE;
+        if (j >= num_cols) flags |= VALIDATE_COL_TOO_LARGE;
+
+        if (n > 0)
+        {
+            const long long pi = rows[n - 1];
+            const long long pj = cols[n - 1];
+
+            if (pi > i)
+                flags |= VALIDATE_ROW_ORDER;
+            else if (pi == i && pj > j)
+                flags |= VALIDATE_COL_ORDER;
+            else if (pi == i && pj == j)
+                flags |= VALIDATE_DUPLICATES;
+        }
+
+        return flags;
+    }
+};
+
+template <typename OffsetIterator, typename ColumnIterator>
+struct validate_csr_row
+{
+    OffsetIterator offsets;
+    ColumnIterator cols;
+    long long      num_entries;
+    long long      num_cols;
+
+    validate_csr_row(OffsetIterator offsets, ColumnIterator cols, long long num_entries, long long num_cols)
+        : offsets(offsets), cols(cols), num_entries(num_entries), num_cols(num_cols) {}
+
+    __host__ __device__
+    unsigned int operator()(const size_t i) const
+    {
+        const long long start = offsets[i];
+        const long long end   = offsets[i + 1];
+
+        // the entries of the row are only read within [0, num_entries)
+        if (start < 0 || start > end || end > num_entries)
+            return VALIDATE_OFFSET_ORDER;
+
+        unsigned int flags = 0;
+
+        for (long long k = start; k < end; k++)
+        {
+            const long long j = cols[k];
+
+            if (j < 0)         flags |= VALIDATE_COL_NEGATIVE;
+            if (j >= num_cols) flags |= VALIDATE_COL_TOO_LARGE;
+
+            if (k > start)
+            {
+                const long long pj = cols[k - 1];
+
+                if (pj > j)
+                    flags |= VALIDATE_COL_ORDER;
+                else if (pj == j)
+                    flags |= VALIDATE_DUPLICATES;
+            }
+        }
+
+        return flags;
+    }
+};
+
+template <typename System, typename UnaryFunction>
+unsigned int validate_pass(System& system, UnaryFunction f, const size_t n)
+{
+    unsigned int flags = 0;
+
+    for (size_t first = 0; first < n; first += CUSP_VALIDATE_CHUNK_SIZE)
+    {
+        const size_t last = std::min(n, first + size_t(CUSP_VALIDATE_CHUNK_SIZE));
+
+        flags |= thrust::transform_reduce(system,
+                                          thrust::counting_iterator<size_t>(first),
+                                          thrust::counting_iterator<size_t>(last),
+                                          f, 0u, thrust::bit_or<unsigned int>());
+
+        if (flags & VALIDATE_ERRORS)
+            break;
+    }
+
+    return flags;
+}
+
+template <typename RowIterator, typename ColumnIterator, typename System>
+unsigned int validate_coo_entries(System& system, RowIterator rows, ColumnIterator cols,
+                                  const size_t num_rows, const size_t num_cols, const size_t num_entries)
+{
+    return validate_pass(system,
+                         validate_coo_entry<RowIterator,ColumnIterator>(rows, cols, num_rows, num_cols),
+                         num_entries);
+}
+
+template <typename OffsetIterator, typename ColumnIterator, typename System>
+unsigned int validate_csr_rows(System& system, OffsetIterator offsets, ColumnIterator cols,
+                               const size_t num_rows, const size_t num_cols, const size_t num_entries)
+{
+    return validate_pass(system,
+                         validate_csr_row<OffsetIterator,ColumnIterator>(offsets, cols, num_entries, num_cols),
+                         num_rows);
+}
+
+
 ///////////////////////////////
 // Matrix-Specific Functions //
 ///////////////////////////////
@@ -96,9 +260,12 @@ struct is_ell_entry_in_bounds
 template <typename MatrixType, typename OutputStream>
 bool is_valid_matrix(const MatrixType& A,
                      OutputStream& ostream,
+                     unsigned int& flags,
                      cusp::coo_format)
 {
-    typedef typename MatrixType::index_type IndexType;
+    typedef typename MatrixType::memory_space System;
+
+    flags = 0;
 
     // we could relax some of these conditions if necessary
     if (A.row_indices.size() != A.num_entries)
@@ -122,40 +289,40 @@ bool is_valid_matrix(const MatrixType& A,
         return false;
     }
 
-    if (A.num_entries > 0)
+    System system;
+
+    flags = validate_coo_entries(system, A.row_indices.begin(), A.column_indices.begin(),
+                                 A.num_rows, A.num_cols, A.num_entries);
+
+    // check that row indices are within [0, num_rows)
+    if (flags & VALIDATE_ROW_NEGATIVE)
     {
-        // check that row indices are within [0, num_rows)
-        thrust::pair<IndexType,IndexType> min_max_row = index_range(A.row_indices);
-        if (min_max_row.first < 0)
-        {
-            ostream << "row indices should be non-negative";
-            return false;
-        }
-        if (static_cast<size_t>(min_max_row.second) >= A.num_rows)
-        {
-            ostream << "row indices should be less than num_row (" << A.num_rows << ")";
-            return false;
-        }
+        ostream << "row indices should be non-negative";
+        return false;
+    }
+    if (flags & VALIDATE_ROW_TOO_LARGE)
+    {
+        ostream << "row indices should be less than num_row (" << A.num_rows << ")";
+        return false;
+    }
 
-        // check that row_indices is a non-decreasing sequence
-        if (!thrust::is_sorted(A.row_indices.begin(), A.row_indices.end()))
-        {
-            ostream << "row indices should form a non-decreasing sequence";
-            return false;
-        }
+    // check that row_indices is a non-decreasing sequence
+    if (flags & VALIDATE_ROW_ORDER)
+    {
+        ostream << "row indices should form a non-decreasing sequence";
+        return false;
+    }
 
-        // check that column indices are within [0, num_cols)
-        thrust::pair<IndexType,IndexType> min_max_col = index_range(A.column_indices);
-        if (min_max_col.first < 0)
-        {
-            ostream << "column indices should be non-negative";
-            return false;
-        }
-        if (static_cast<size_t>(min_max_col.second) >= A.num_cols)
-        {
-            ostream << "column indices should be less than num_cols (" << A.num_cols << ")";
-            return false;
-        }
+    // check that column indices are within [0, num_cols)
+    if (flags & VALIDATE_COL_NEGATIVE)
+    {
+        ostream << "column indices should be non-negative";
+        return false;
+    }
+    if (flags & VALIDATE_COL_TOO_LARGE)
+    {
+        ostream << "column indices should be less than num_cols (" << A.num_cols << ")";
+        return false;
     }
 
     return true;
@@ -165,9 +332,13 @@ bool is_valid_matrix(const MatrixType& A,
 template <typename MatrixType, typename OutputStream>
 bool is_valid_matrix(const MatrixType& A,
                      OutputStream& ostream,
+                     unsigned int& flags,
                      cusp::csr_format)
 {
-    typedef typename MatrixType::index_type IndexType;
+    typedef typename MatrixType::index_type   IndexType;
+    typedef typename MatrixType::memory_space System;
+
+    flags = 0;
 
     // we could relax some of these conditions if necessary
 
@@ -207,34 +378,52 @@ bool is_valid_matrix(const MatrixType& A,
         return false;
     }
 
+    System system;
+
+    flags = validate_csr_rows(system, A.row_offsets.begin(), A.column_indices.begin(),
+                              A.num_rows, A.num_cols, A.num_entries);
+
     // check that row_offsets is a non-decreasing sequence
-    if (!thrust::is_sorted(A.row_offsets.begin(), A.row_offsets.end()))
+    if (flags & VALIDATE_OFFSET_ORDER)
     {
         ostream << "row offsets should form a non-decreasing sequence";
         return false;
     }
 
-    if (A.num_entries > 0)
+    // check that column indices are within [0, num_cols)
+    if (flags & VALIDATE_COL_NEGATIVE)
     {
-        // check that column indices are within [0, num_cols)
-        thrust::pair<IndexType,IndexType> min_max = index_range(A.column_indices);
-
-        if (min_max.first < 0)
-        {
-            ostream << "column indices should be non-negative";
-            return false;
-        }
-        if (static_cast<size_t>(min_max.second) >= A.num_cols)
-        {
-            ostream << "column indices should be less than num_cols (" << A.num_cols << ")";
-            return false;
-        }
+        ostream << "column indices should be non-negative";
+        return false;
+    }
+    if (flags & VALIDATE_COL_TOO_LARGE)
+    {
+        ostream << "column indices should be less than num_cols (" << A.num_cols << ")";
+        return false;
     }
 
     return true;
 }
 
 
+template <typename MatrixType, typename OutputStream>
+bool is_valid_matrix(const MatrixType& A,
+                     OutputStream& ostream,
+                     cusp::coo_format format)
+{
+    unsigned int flags;
+    return is_valid_matrix(A, ostream, flags, format);
+}
+
+template <typename MatrixType, typename OutputStream>
+bool is_valid_matrix(const MatrixType& A,
+                     OutputStream& ostream,
+                     cusp::csr_format format)
+{
+    unsigned int flags;
+    return is_valid_matrix(A, ostream, flags, format);
+}
+
 template <typename MatrixType, typename OutputStream>
 bool is_valid_matrix(const MatrixType& A,
                      OutputStream& ostream,
@@ -379,6 +568,122 @@ bool is_valid_matrix(const MatrixType& A,
     return true;
 }
 
+
+
+/////////////////////////
+// Structure Functions //
+/////////////////////////
+
+// fills in the duplicate and symmetry flags of a valid pattern given as
+// (row, column) pairs, which is reordered in the process
+template <typename IndexArray>
+void pattern_structure(IndexArray& rows, IndexArray& cols,
+                       const bool sorted, const bool check_symmetry,
+                       cusp::matrix_structure& structure)
+{
+    typedef typename IndexArray::memory_space System;
+    typedef typename IndexArray::iterator     Iterator;
+    typedef thrust::zip_iterator< thrust::tuple<Iterator,Iterator> > ZipIterator;
+
+    System system;
+
+    ZipIterator first = thrust::make_zip_iterator(thrust::make_tuple(rows.begin(), cols.begin()));
+    ZipIterator last  = first + rows.size();
+
+    if (!sorted)
+        thrust::sort(system, first, last);
+
+    // the pattern is sorted now, so duplicates are adjacent
+    size_t num_unique = thrust::unique(system, first, last) - first;
+
+    structure.has_duplicates = num_unique != rows.size();
+
+    if (!check_symmetry)
+        return;
+
+    // the transposed pattern of a symmetric pattern is the pattern itself
+    IndexArray trows(cols.begin(), cols.begin() + num_unique);
+    IndexArray tcols(rows.begin(), rows.begin() + num_unique);
+
+    ZipIterator tfirst = thrust::make_zip_iterator(thrust::make_tuple(trows.begin(), tcols.begin()));
+
+    thrust::sort(system, tfirst, tfirst + num_unique);
+
+    structure.symmetric_pattern = thrust::equal(system, first, first + num_unique, tfirst);
+}
+
+template <typename MatrixType>
+void validate_matrix(const MatrixType& A,
+                     const bool check_symmetry,
+                     cusp::matrix_structure& structure,
+                     cusp::coo_format format)
+{
+    typedef typename MatrixType::index_type   IndexType;
+    typedef typename MatrixType::memory_space MemorySpace;
+
+    std::ostringstream oss;
+    unsigned int flags;
+
+    structure.valid = is_valid_matrix(A, oss, flags, format);
+
+    if (!structure.valid)
+        return;
+
+    structure.sorted         = !(flags & VALIDATE_COL_ORDER);
+    structure.has_duplicates = (flags & VALIDATE_DUPLICATES) != 0;
+
+    // adjacent entries of a sorted matrix tell about duplicates already
+    if (structure.sorted && !(check_symmetry && A.num_rows == A.num_cols))
+        return;
+
+    cusp::array1d<IndexType,MemorySpace> rows(A.row_indices.begin(), A.row_indices.end());
+    cusp::array1d<IndexType,MemorySpace> cols(A.column_indices.begin(), A.column_indices.end());
+
+    pattern_structure(rows, cols, structure.sorted, check_symmetry && A.num_rows == A.num_cols, structure);
+}
+
+template <typename MatrixType>
+void validate_matrix(const MatrixType& A,
+                     const bool check_symmetry,
+                     cusp::matrix_structure& structure,
+                     cusp::csr_format format)
+{
+    typedef typename MatrixType::index_type   IndexType;
+    typedef typename MatrixType::memory_space MemorySpace;
+
+    std::ostringstream oss;
+    unsigned int flags;
+
+    structure.valid = is_valid_matrix(A, oss, flags, format);
+
+    if (!structure.valid)
+        return;
+
+    structure.sorted         = !(flags & VALIDATE_COL_ORDER);
+    structure.has_duplicates = (flags & VALIDATE_DUPLICATES) != 0;
+
+    if (structure.sorted && !(check_symmetry && A.num_rows == A.num_cols))
+        return;
+
+    cusp::array1d<IndexType,MemorySpace> rows(A.num_entries);
+    cusp::array1d<IndexType,MemorySpace> cols(A.column_indices.begin(), A.column_indices.end());
+
+    cusp::offsets_to_indices(A.row_offsets, rows);
+
+    pattern_structure(rows, cols, structure.sorted, check_symmetry && A.num_rows == A.num_cols, structure);
+}
+
+// the remaining formats are only checked for validity, their structure
+// flags keep the conservative defaults
+template <typename MatrixType, typename Format>
+void validate_matrix(const MatrixType& A,
+                     const bool check_symmetry,
+                     cusp::matrix_structure& structure,
+                     Format)
+{
+    structure.valid = cusp::is_valid_matrix(A);
+}
+
 } // end namespace detail
 
 
@@ -400,6 +705,17 @@ bool is_valid_matrix(const MatrixType& A, OutputStream& ostream)
     return detail::is_valid_matrix(A, ostream, typename MatrixType::format());
 }
 
+template <typename MatrixType>
+matrix_structure validate_matrix(const MatrixType& matrix, const bool check_symmetry)
+{
+    matrix_structure structure;
+
+    // dispatch on matrix format
+    detail::validate_matrix(matrix, check_symmetry, structure, typename MatrixType::format());
+
+    return structure;
+}
+
 template <typename MatrixType>
 void assert_is_valid_matrix(const MatrixType& A)
 {
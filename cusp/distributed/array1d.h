@@ -0,0 +1,292 @@
+/*
+ *  Copyright 2008-2014 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*! \file cusp/distributed/array1d.h
+ *  \brief One-dimensional array whose entries are distributed over MPI ranks
+ */
+
+#pragma once
+
+#include <cusp/detail/config.h>
+
+#include <cusp/array1d.h>
+#include <cusp/complex.h>
+#include <cusp/memory.h>
+
+#include <cusp/distributed/csr_matrix.h>
+#include <cusp/distributed/execution_policy.h>
+
+#include <mpi.h>
+
+namespace cusp
+{
+namespace distributed
+{
+
+/*! \cond */
+namespace detail
+{
+
+template <typename MemorySpace>
+struct policy_of
+{
+    typedef cusp::distributed::device_policy type;
+};
+
+template <>
+struct policy_of<cusp::host_memory>
+{
+    typedef cusp::distributed::host_policy type;
+};
+
+} // end namespace detail
+/*! \endcond */
+
+/*! \addtogroup containers Containers
+ *  \{
+ */
+
+/**
+ * \brief Local entries of a vector distributed over the ranks of a
+ * communicator
+ *
+ * \tparam ValueType Type of the entries (e.g. \c float).
+ * \tparam MemorySpace A memory space (e.g. \c cusp::host_memory or \c cusp::device_memory)
+ *
+ * \par Overview
+ *  The array is a \p cusp::array1d holding the entries owned by the calling
+ *  rank, the entries of all ranks taken in rank order form the global
+ *  vector. Every algorithm accepting a \p cusp::array1d operates on the
+ *  local entries, so the updates of \p cusp::blas such as \p axpy,
+ *  \p axpby and \p scal need no communication.
+ *
+ *  The reductions \p cusp::blas::dot, \p dotc, \p nrm2, \p asum,
+ *  \p nrmmax and \p amax of arrays whose first argument is a
+ *  \p distributed::array1d evaluate the local entries in a single pass and
+ *  combine the partial results of all ranks in a single
+ *  \c MPI_Allreduce, \p amax returns the global index. Passing
+ *  \p policy() to the execution policy overloads of the \p cusp::krylov
+ *  solvers and of the \p cusp::monitor constructor applies the same
+ *  reductions inside the solvers, the fused reductions of the pipelined
+ *  solvers are summed with a nonblocking \c MPI_Iallreduce that overlaps
+ *  the sparse matrix-vector products.
+ *
+ * \note The reductions are collective over the communicator.
+ *
+ * \par Example
+ *  \code
+ *  #include <cusp/csr_matrix.h>
+ *  #include <cusp/monitor.h>
+ *  #include <cusp/distributed/array1d.h>
+ *  #include <cusp/distributed/csr_matrix.h>
+ *  #include <cusp/gallery/poisson.h>
+ *  #include <cusp/krylov/pipelined_cg.h>
+ *
+ *  int main(int argc, char** argv)
+ *  {
+ *      MPI_Init(&argc, &argv);
+ *
+ *      cusp::csr_matrix<int, double, cusp::host_memory> G, L;
+ *      cusp::gallery::poisson5pt(G, 512, 512);
+ *      cusp::distributed::local_rows(G, MPI_COMM_WORLD, L);
+ *
+ *      cusp::distributed::csr_matrix<int, double, cusp::device_memory> A(L, MPI_COMM_WORLD);
+ *
+ *      // vectors with the row layout of A
+ *      cusp::distributed::array1d<double, cusp::device_memory> x(A, 0);
+ *      cusp::distributed::array1d<double, cusp::device_memory> b(A, 1);
+ *
+ *      // reductions over all ranks
+ *      double norm = cusp::blas::nrm2(b);
+ *
+ *      cusp::monitor<double> monitor(b.policy(), b, 100, 1e-8);
+ *      cusp::identity_operator<double, cusp::device_memory> M(A.num_rows, A.num_rows);
+ *
+ *      cusp::krylov::pipelined_cg(b.policy(), A, x, b, monitor, M);
+ *
+ *      MPI_Finalize();
+ *
+ *      return 0;
+ *  }
+ *  \endcode
+ */
+template <typename ValueType, typename MemorySpace>
+class array1d : public cusp::array1d<ValueType,MemorySpace>
+{
+private:
+
+    typedef cusp::array1d<ValueType,MemorySpace> Parent;
+
+public:
+
+    /*! \cond */
+    typedef typename detail::policy_of<MemorySpace>::type policy_type;
+    typedef Parent                                        local_type;
+    /*! \endcond */
+
+    /*! Construct an empty array.
+     *
+     *  \param comm Communicator over which the entries are distributed.
+     */
+    explicit array1d(MPI_Comm comm);
+
+    /*! Construct an array with \p n local entries.
+     *
+     *  \param n Number of entries owned by this rank.
+     *  \param comm Communicator over which the entries are distributed.
+     */
+    array1d(const size_t n, MPI_Comm comm);
+
+    /*! Construct an array with \p n local entries set to \p value.
+     *
+     *  \param n Number of entries owned by this rank.
+     *  \param value Initial value of the entries.
+     *  \param comm Communicator over which the entries are distributed.
+     */
+    array1d(const size_t n, const ValueType& value, MPI_Comm comm);
+
+    /*! Construct an array from the local entries \p x.
+     *
+     *  \param x Entries owned by this rank.
+     *  \param comm Communicator over which the entries are distributed.
+     */
+    template <typename OtherT, typename OtherMem>
+    array1d(const cusp::array1d<OtherT,OtherMem>& x, MPI_Comm comm);
+
+    /*! Construct an array from the local entries \p x.
+     *
+     *  \param x Entries owned by this rank.
+     *  \param comm Communicator over which the entries are distributed.
+     */
+    template <typename Iterator>
+    array1d(const cusp::array1d_view<Iterator>& x, MPI_Comm comm);
+
+    /*! Construct an array with the row layout of \p A whose entries are
+     *  \p value.
+     *
+     *  \param A Distributed matrix, the array holds one entry per local row.
+     *  \param value Initial value of the entries.
+     */
+    template <typename IndexType, typename MemorySpace2>
+    explicit array1d(const cusp::distributed::csr_matrix<IndexType,ValueType,MemorySpace2>& A,
+                     const ValueType& value = ValueType(0));
+
+    /*! Copy the local entries of \p x and keep the communicator.
+     */
+    template <typename ArrayType>
+    array1d& operator=(const ArrayType& x);
+
+    /*! Communicator over which the entries are distributed.
+     */
+    MPI_Comm communicator(void) const;
+
+    /*! Execution policy whose reductions span the communicator.
+     */
+    policy_type policy(void) const;
+
+    /*! Number of entries of all ranks.
+     *
+     *  \note This function is collective over the communicator.
+     */
+    size_t global_size(void) const;
+
+private:
+
+    /*! \cond */
+    MPI_Comm m_comm;
+    /*! \endcond */
+}; // class array1d
+/*! \}
+ */
+
+} // end namespace distributed
+
+namespace blas
+{
+
+/*! \addtogroup blas BLAS
+ *  \{
+ */
+
+/**
+ * \brief dot product over all ranks (x^T * y)
+ *
+ * \param x The local entries of the first vector
+ * \param y The local entries of the second vector
+ *
+ * \return the global dot product on every rank
+ */
+template <typename ValueType, typename MemorySpace, typename ArrayType>
+ValueType dot(const cusp::distributed::array1d<ValueType,MemorySpace>& x,
+              const ArrayType& y);
+
+/**
+ * \brief conjugate dot product over all ranks (conjugate(x)^T * y)
+ *
+ * \param x The local entries of the first vector
+ * \param y The local entries of the second vector
+ *
+ * \return the global dot product on every rank
+ */
+template <typename ValueType, typename MemorySpace, typename ArrayType>
+ValueType dotc(const cusp::distributed::array1d<ValueType,MemorySpace>& x,
+               const ArrayType& y);
+
+/**
+ * \brief Euclidean norm over all ranks
+ *
+ * \param x The local entries of the vector
+ */
+template <typename ValueType, typename MemorySpace>
+typename cusp::norm_type<ValueType>::type
+nrm2(const cusp::distributed::array1d<ValueType,MemorySpace>& x);
+
+/**
+ * \brief sum of the magnitudes over all ranks
+ *
+ * \param x The local entries of the vector
+ */
+template <typename ValueType, typename MemorySpace>
+typename cusp::norm_type<ValueType>::type
+asum(const cusp::distributed::array1d<ValueType,MemorySpace>& x);
+
+/**
+ * \brief largest magnitude over all ranks
+ *
+ * \param x The local entries of the vector
+ */
+template <typename ValueType, typename MemorySpace>
+typename cusp::norm_type<ValueType>::type
+nrmmax(const cusp::distributed::array1d<ValueType,MemorySpace>& x);
+
+/**
+ * \brief global index of the entry of largest magnitude
+ *
+ * The entries of all ranks are numbered in rank order and the first of
+ * several entries of equal magnitude is returned.
+ *
+ * \param x The local entries of the vector
+ */
+template <typename ValueType, typename MemorySpace>
+int amax(const cusp::distributed::array1d<ValueType,MemorySpace>& x);
+
+/*! \}
+ */
+
+} // end namespace blas
+} // end namespace cusp
+
+#include <cusp/distributed/detail/array1d.inl>
@@ -0,0 +1,274 @@
+/*
+ *  Copyright 2008-2014 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*! \file cusp/distributed/csr_matrix.h
+ *  \brief Row distributed CSR matrix with MPI halo exchange
+ */
+
+#pragma once
+
+#include <cusp/detail/config.h>
+
+#include <cusp/array1d.h>
+#include <cusp/csr_matrix.h>
+#include <cusp/linear_operator.h>
+
+#include <cusp/distributed/execution_policy.h>
+#include <cusp/distributed/detail/mpi.h>
+
+#include <mpi.h>
+
+#include <vector>
+
+namespace cusp
+{
+namespace distributed
+{
+
+/*! \addtogroup sparse_matrices Sparse Matrices
+ */
+
+/*! \addtogroup sparse_matrix_containers Sparse Matrix Containers
+ *  \ingroup sparse_matrices
+ *  \{
+ */
+
+/**
+ * \brief Sparse matrix whose rows are partitioned over the ranks of an MPI
+ * communicator
+ *
+ * \tparam IndexType Type used for matrix indices (e.g. \c int).
+ * \tparam ValueType Type used for matrix values (e.g. \c float).
+ * \tparam MemorySpace A memory space (e.g. \c cusp::host_memory or \c cusp::device_memory)
+ *
+ * \par Overview
+ *  Each rank owns a contiguous block of rows and the entries of the
+ *  vectors with the same indices, so vectors are ordinary \p array1d
+ *  objects holding the local rows. The local rows are split into the
+ *  \p diagonal_block, whose columns are owned by the same rank, and the
+ *  \p off_diagonal_block, whose columns are compressed to the ghost
+ *  entries listed in \p ghost_columns. Square matrices partition their
+ *  columns like their rows, rectangular operators such as the transfer
+ *  operators of a multigrid hierarchy are given their own column
+ *  partition.
+ *
+ *  \p multiply gathers the entries requested by the neighbouring ranks,
+ *  posts nonblocking sends and receives for the halo, multiplies the
+ *  \p diagonal_block while the messages are in flight and then adds the
+ *  product of the \p off_diagonal_block with the received ghost values.
+ *  Device buffers are handed to MPI directly when \c CUSP_CUDA_AWARE_MPI
+ *  is nonzero, which is detected for Open MPI and may be defined for other
+ *  libraries, and are staged through host memory otherwise.
+ *
+ *  The matrix is a \p linear_operator with the local number of rows and
+ *  columns, so the \p cusp::krylov solvers accept it unchanged when they
+ *  are called with the policy of \p host_par or \p device_par, whose
+ *  reductions span the communicator. The \p monitor must be constructed
+ *  with the same policy so that all ranks agree on the norm of the
+ *  right-hand side. Preconditioners are applied locally, e.g.
+ *  \p cusp::precond::diagonal built from the \p diagonal_block.
+ *
+ * \note All ranks of the communicator must construct the matrix and take
+ *  part in every product.
+ *
+ * \par Example
+ *  \code
+ *  #include <cusp/csr_matrix.h>
+ *  #include <cusp/monitor.h>
+ *  #include <cusp/distributed/csr_matrix.h>
+ *  #include <cusp/gallery/poisson.h>
+ *  #include <cusp/krylov/cg.h>
+ *
+ *  int main(int argc, char** argv)
+ *  {
+ *      MPI_Init(&argc, &argv);
+ *
+ *      // every rank generates the global matrix and keeps its rows
+ *      cusp::csr_matrix<int, float, cusp::host_memory> G, L;
+ *      cusp::gallery::poisson5pt(G, 256, 256);
+ *      cusp::distributed::local_rows(G, MPI_COMM_WORLD, L);
+ *
+ *      cusp::distributed::csr_matrix<int, float, cusp::device_memory> A(L, MPI_COMM_WORLD);
+ *
+ *      // local parts of the solution and right-hand side
+ *      cusp::array1d<float, cusp::device_memory> x(A.num_rows, 0);
+ *      cusp::array1d<float, cusp::device_memory> b(A.num_rows, 1);
+ *
+ *      cusp::distributed::device_policy exec = cusp::distributed::device_par(MPI_COMM_WORLD);
+ *
+ *      cusp::monitor<float> monitor(exec, b, 1000, 1e-6);
+ *      cusp::identity_operator<float, cusp::device_memory> M(A.num_rows, A.num_rows);
+ *
+ *      cusp::krylov::cg(exec, A, x, b, monitor, M);
+ *
+ *      MPI_Finalize();
+ *
+ *      return 0;
+ *  }
+ *  \endcode
+ */
+template <typename IndexType, typename ValueType, class MemorySpace>
+class csr_matrix : public cusp::linear_operator<ValueType,MemorySpace,IndexType>
+{
+private:
+
+    typedef cusp::linear_operator<ValueType,MemorySpace,IndexType> Parent;
+
+public:
+
+    /*! \cond */
+    typedef cusp::csr_matrix<IndexType,ValueType,MemorySpace> local_matrix_type;
+    /*! \endcond */
+
+    /*! Local rows whose columns are owned by this rank, in local indices.
+     */
+    local_matrix_type diagonal_block;
+
+    /*! Local rows whose columns are owned by other ranks, the column
+     *  indices refer to \p ghost_columns.
+     */
+    local_matrix_type off_diagonal_block;
+
+    /*! Global index of the first row of every rank, followed by the
+     *  number of global rows.
+     */
+    cusp::array1d<IndexType,cusp::host_memory> row_starts;
+
+    /*! Global index of the first column of every rank, followed by the
+     *  number of global columns. Equal to \p row_starts for square
+     *  matrices.
+     */
+    cusp::array1d<IndexType,cusp::host_memory> col_starts;
+
+    /*! Sorted global indices of the ghost columns.
+     */
+    cusp::array1d<IndexType,cusp::host_memory> ghost_columns;
+
+    /*! Construct an empty \p csr_matrix on \c MPI_COMM_NULL.
+     */
+    csr_matrix(void);
+
+    /*! Construct a \p csr_matrix from the rows owned by this rank.
+     *
+     *  \tparam MatrixType Type of the local rows.
+     *
+     *  \param A The consecutive rows owned by this rank with global column
+     *  indices, <tt>A.num_cols</tt> is the global number of columns. The
+     *  ranks own the rows in the order of their rank.
+     *  \param comm Communicator over which the rows are distributed.
+     *
+     *  \note This constructor is collective over \p comm.
+     */
+    template <typename MatrixType>
+    csr_matrix(const MatrixType& A, MPI_Comm comm);
+
+    /*! Construct a rectangular \p csr_matrix whose columns are partitioned
+     *  independently of its rows, e.g. a prolongation operator.
+     *
+     *  \tparam MatrixType Type of the local rows.
+     *
+     *  \param A The consecutive rows owned by this rank with global column
+     *  indices.
+     *  \param num_local_cols Number of consecutive columns owned by this
+     *  rank, i.e. the size of the local part of the input vector.
+     *  \param comm Communicator over which the rows are distributed.
+     *
+     *  \note This constructor is collective over \p comm.
+     */
+    template <typename MatrixType>
+    csr_matrix(const MatrixType& A, const size_t num_local_cols, MPI_Comm comm);
+
+    /*! Communicator over which the rows are distributed.
+     */
+    MPI_Comm communicator(void) const;
+
+    /*! Global index of the first row owned by this rank.
+     */
+    size_t first_row(void) const;
+
+    /*! Global number of rows.
+     */
+    size_t num_global_rows(void) const;
+
+    /*! Global number of columns.
+     */
+    size_t num_global_cols(void) const;
+
+    /*! Multiply the \p csr_matrix with the local rows of \p x, y = A x.
+     *
+     *  \param x Local rows of the input vector.
+     *  \param y Local rows of the output vector.
+     */
+    template <typename DerivedPolicy, typename VectorType1, typename VectorType2>
+    void operator()(thrust::execution_policy<DerivedPolicy>& exec, const VectorType1& x, VectorType2& y) const;
+
+    /*! Multiply the \p csr_matrix with the local rows of \p x, y = A x.
+     *
+     *  \param x Local rows of the input vector.
+     *  \param y Local rows of the output vector.
+     */
+    template <typename VectorType1, typename VectorType2>
+    void operator()(const VectorType1& x, VectorType2& y) const;
+
+private:
+
+    /*! \cond */
+    MPI_Comm comm;
+    int rank;
+
+    // halo exchange plan, the ghost values of each neighbour are contiguous
+    std::vector<int> send_ranks;
+    std::vector<int> send_offsets;
+    std::vector<int> recv_ranks;
+    std::vector<int> recv_offsets;
+
+    cusp::array1d<IndexType,MemorySpace> send_indices;
+
+    mutable cusp::array1d<ValueType,MemorySpace>       send_buffer;
+    mutable cusp::array1d<ValueType,MemorySpace>       ghost_values;
+    mutable cusp::array1d<ValueType,cusp::host_memory> send_staging;
+    mutable cusp::array1d<ValueType,cusp::host_memory> recv_staging;
+    mutable std::vector<MPI_Request>                   requests;
+
+    template <typename MatrixType>
+    void setup(const MatrixType& A, const size_t num_local_cols);
+
+    void begin_exchange(void) const;
+    void end_exchange(void) const;
+    /*! \endcond */
+}; // class csr_matrix
+
+/**
+ * \brief Copies the rows of a replicated matrix owned by this rank
+ *
+ * \tparam MatrixType1 Type of the global matrix
+ * \tparam MatrixType2 Type of the local rows
+ *
+ * \param A global matrix, identical on every rank
+ * \param comm communicator over which the rows are distributed
+ * \param B rows <tt>[rank * N / size, (rank + 1) * N / size)</tt> of \p A
+ * with global column indices
+ */
+template <typename MatrixType1, typename MatrixType2>
+void local_rows(const MatrixType1& A, MPI_Comm comm, MatrixType2& B);
+
+/*! \}
+ */
+
+} // end namespace distributed
+} // end namespace cusp
+
+#include <cusp/distributed/detail/csr_matrix.inl>
@@ -0,0 +1,170 @@
+/*
+ *  Copyright 2008-2014 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include <cusp/blas/blas.h>
+
+#include <cusp/distributed/detail/mpi.h>
+
+namespace cusp
+{
+namespace distributed
+{
+
+template <typename ValueType, typename MemorySpace>
+array1d<ValueType,MemorySpace>
+::array1d(MPI_Comm comm)
+    : Parent(), m_comm(comm)
+{
+}
+
+template <typename ValueType, typename MemorySpace>
+array1d<ValueType,MemorySpace>
+::array1d(const size_t n, MPI_Comm comm)
+    : Parent(n), m_comm(comm)
+{
+}
+
+template <typename ValueType, typename MemorySpace>
+array1d<ValueType,MemorySpace>
+::array1d(const size_t n, const ValueType& value, MPI_Comm comm)
+    : Parent(n, value), m_comm(comm)
+{
+}
+
+template <typename ValueType, typename MemorySpace>
+template <typename OtherT, typename OtherMem>
+array1d<ValueType,MemorySpace>
+::array1d(const cusp::array1d<OtherT,OtherMem>& x, MPI_Comm comm)
+    : Parent(x), m_comm(comm)
+{
+}
+
+template <typename ValueType, typename MemorySpace>
+template <typename Iterator>
+array1d<ValueType,MemorySpace>
+::array1d(const cusp::array1d_view<Iterator>& x, MPI_Comm comm)
+    : Parent(x), m_comm(comm)
+{
+}
+
+template <typename ValueType, typename MemorySpace>
+template <typename IndexType, typename MemorySpace2>
+array1d<ValueType,MemorySpace>
+::array1d(const cusp::distributed::csr_matrix<IndexType,ValueType,MemorySpace2>& A,
+          const ValueType& value)
+    : Parent(A.num_rows, value), m_comm(A.communicator())
+{
+}
+
+template <typename ValueType, typename MemorySpace>
+template <typename ArrayType>
+array1d<ValueType,MemorySpace>&
+array1d<ValueType,MemorySpace>
+::operator=(const ArrayType& x)
+{
+    Parent::operator=(x);
+
+    return *this;
+}
+
+template <typename ValueType, typename MemorySpace>
+MPI_Comm
+array1d<ValueType,MemorySpace>
+::communicator(void) const
+{
+    return m_comm;
+}
+
+template <typename ValueType, typename MemorySpace>
+typename array1d<ValueType,MemorySpace>::policy_type
+array1d<ValueType,MemorySpace>
+::policy(void) const
+{
+    return policy_type(m_comm);
+}
+
+template <typename ValueType, typename MemorySpace>
+size_t
+array1d<ValueType,MemorySpace>
+::global_size(void) const
+{
+    long long n = (long long) Parent::size();
+
+    cusp::distributed::detail::allreduce_sum(m_comm, &n, 1);
+
+    return size_t(n);
+}
+
+} // end namespace distributed
+
+namespace blas
+{
+
+template <typename ValueType, typename MemorySpace, typename ArrayType>
+ValueType dot(const cusp::distributed::array1d<ValueType,MemorySpace>& x,
+              const ArrayType& y)
+{
+    typename cusp::distributed::array1d<ValueType,MemorySpace>::policy_type exec = x.policy();
+
+    return cusp::blas::dot(exec, x, y);
+}
+
+template <typename ValueType, typename MemorySpace, typename ArrayType>
+ValueType dotc(const cusp::distributed::array1d<ValueType,MemorySpace>& x,
+               const ArrayType& y)
+{
+    typename cusp::distributed::array1d<ValueType,MemorySpace>::policy_type exec = x.policy();
+
+    return cusp::blas::dotc(exec, x, y);
+}
+
+template <typename ValueType, typename MemorySpace>
+typename cusp::norm_type<ValueType>::type
+nrm2(const cusp::distributed::array1d<ValueType,MemorySpace>& x)
+{
+    typename cusp::distributed::array1d<ValueType,MemorySpace>::policy_type exec = x.policy();
+
+    return cusp::blas::nrm2(exec, x);
+}
+
+template <typename ValueType, typename MemorySpace>
+typename cusp::norm_type<ValueType>::type
+asum(const cusp::distributed::array1d<ValueType,MemorySpace>& x)
+{
+    typename cusp::distributed::array1d<ValueType,MemorySpace>::policy_type exec = x.policy();
+
+    return cusp::blas::asum(exec, x);
+}
+
+template <typename ValueType, typename MemorySpace>
+typename cusp::norm_type<ValueType>::type
+nrmmax(const cusp::distributed::array1d<ValueType,MemorySpace>& x)
+{
+    typename cusp::distributed::array1d<ValueType,MemorySpace>::policy_type exec = x.policy();
+
+    return cusp::blas::nrmmax(exec, x);
+}
+
+template <typename ValueType, typename MemorySpace>
+int amax(const cusp::distributed::array1d<ValueType,MemorySpace>& x)
+{
+    typename cusp::distributed::array1d<ValueType,MemorySpace>::policy_type exec = x.policy();
+
+    return cusp::blas::amax(exec, x);
+}
+
+} // end namespace blas
+} // end namespace cusp
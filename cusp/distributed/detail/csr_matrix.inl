@@ -0,0 +1,403 @@
+/*
+ *  Copyright 2008-2014 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include <cusp/array1d.h>
+#include <cusp/csr_matrix.h>
+#include <cusp/exception.h>
+#include <cusp/multiply.h>
+
+#include <thrust/copy.h>
+#include <thrust/fill.h>
+#include <thrust/functional.h>
+#include <thrust/gather.h>
+#include <thrust/detail/type_traits.h>
+
+#include <algorithm>
+#include <vector>
+
+namespace cusp
+{
+namespace distributed
+{
+namespace detail
+{
+
+// device buffers are staged through host memory unless MPI can read them
+template <typename MemorySpace>
+bool staged_exchange(void)
+{
+#if THRUST_DEVICE_SYSTEM == THRUST_DEVICE_SYSTEM_CUDA && !CUSP_CUDA_AWARE_MPI
+    return !thrust::detail::is_convertible<MemorySpace, cusp::host_memory>::value;
+#else
+    return false;
+#endif
+}
+
+// kernels filling device buffers must complete before MPI reads them
+template <typename MemorySpace>
+void synchronize_exchange(void)
+{
+#if THRUST_DEVICE_SYSTEM == THRUST_DEVICE_SYSTEM_CUDA
+    if (!thrust::detail::is_convertible<MemorySpace, cusp::host_memory>::value)
+        cudaDeviceSynchronize();
+#endif
+}
+
+template <typename Array>
+typename Array::value_type* buffer_pointer(Array& a)
+{
+    return a.size() == 0 ? NULL : thrust::raw_pointer_cast(&a[0]);
+}
+
+template <typename T>
+T* buffer_pointer(std::vector<T>& a)
+{
+    return a.empty() ? NULL : &a[0];
+}
+
+} // end namespace detail
+
+template <typename IndexType, typename ValueType, class MemorySpace>
+csr_matrix<IndexType,ValueType,MemorySpace>
+::csr_matrix(void)
+    : comm(MPI_COMM_NULL), rank(0) {}
+
+template <typename IndexType, typename ValueType, class MemorySpace>
+template <typename MatrixType>
+csr_matrix<IndexType,ValueType,MemorySpace>
+::csr_matrix(const MatrixType& A, MPI_Comm comm)
+    : comm(comm), rank(0)
+{
+    setup(A, A.num_rows);
+}
+
+template <typename IndexType, typename ValueType, class MemorySpace>
+template <typename MatrixType>
+csr_matrix<IndexType,ValueType,MemorySpace>
+::csr_matrix(const MatrixType& A, const size_t num_local_cols, MPI_Comm comm)
+    : comm(comm), rank(0)
+{
+    setup(A, num_local_cols);
+}
+
+template <typename IndexType, typename ValueType, class MemorySpace>
+MPI_Comm
+csr_matrix<IndexType,ValueType,MemorySpace>
+::communicator(void) const
+{
+    return comm;
+}
+
+template <typename IndexType, typename ValueType, class MemorySpace>
+size_t
+csr_matrix<IndexType,ValueType,MemorySpace>
+::first_row(void) const
+{
+    return row_starts.size() == 0 ? 0 : row_starts[rank];
+}
+
+template <typename IndexType, typename ValueType, class MemorySpace>
+size_t
+csr_matrix<IndexType,ValueType,MemorySpace>
+::num_global_rows(void) const
+{
+    return row_starts.size() == 0 ? 0 : row_starts.back();
+}
+
+template <typename IndexType, typename ValueType, class MemorySpace>
+size_t
+csr_matrix<IndexType,ValueType,MemorySpace>
+::num_global_cols(void) const
+{
+    return col_starts.size() == 0 ? 0 : col_starts.back();
+}
+
+template <typename IndexType, typename ValueType, class MemorySpace>
+template <typename MatrixType>
+void
+csr_matrix<IndexType,ValueType,MemorySpace>
+::setup(const MatrixType& A, const size_t num_local_cols)
+{
+    using cusp::distributed::detail::buffer_pointer;
+
+    cusp::csr_matrix<IndexType,ValueType,cusp::host_memory> H(A);
+
+    int size;
+    MPI_Comm_size(comm, &size);
+    MPI_Comm_rank(comm, &rank);
+
+    const size_t num_rows = H.num_rows;
+
+    // global row and column partitions
+    long long local_sizes[2] = {(long long) H.num_rows, (long long) num_local_cols};
+    std::vector<long long> counts(2 * size);
+
+    MPI_Allgather(local_sizes, 2, MPI_LONG_LONG, &counts[0], 2, MPI_LONG_LONG, comm);
+
+    row_starts.resize(size + 1);
+    col_starts.resize(size + 1);
+    row_starts[0] = 0;
+    col_starts[0] = 0;
+
+    for (int p = 0; p < size; p++)
+    {
+        row_starts[p + 1] = row_starts[p] + IndexType(counts[2 * p]);
+        col_starts[p + 1] = col_starts[p] + IndexType(counts[2 * p + 1]);
+    }
+
+    if (size_t(col_starts[size]) != H.num_cols)
+        throw cusp::invalid_input_exception("distributed::csr_matrix: local columns do not partition the matrix columns");
+
+    const IndexType begin = col_starts[rank];
+    const IndexType end   = col_starts[rank + 1];
+
+    // sorted ghost columns
+    std::vector<IndexType> ghosts;
+
+    for (size_t n = 0; n < H.num_entries; n++)
+    {
+        const IndexType j = H.column_indices[n];
+
+        if (j < begin || j >= end)
+            ghosts.push_back(j);
+    }
+
+    std::sort(ghosts.begin(), ghosts.end());
+    ghosts.erase(std::unique(ghosts.begin(), ghosts.end()), ghosts.end());
+
+    ghost_columns = cusp::array1d<IndexType,cusp::host_memory>(ghosts.begin(), ghosts.end());
+
+    // split the local rows into the diagonal and off-diagonal blocks
+    size_t num_diagonal = 0;
+
+    for (size_t n = 0; n < H.num_entries; n++)
+        if (H.column_indices[n] >= begin && H.column_indices[n] < end)
+            num_diagonal++;
+
+    cusp::csr_matrix<IndexType,ValueType,cusp::host_memory> D(num_rows, num_local_cols, num_diagonal);
+    cusp::csr_matrix<IndexType,ValueType,cusp::host_memory> O(num_rows, ghosts.size(), H.num_entries - num_diagonal);
+
+    size_t d = 0;
+    size_t o = 0;
+
+    for (size_t i = 0; i < num_rows; i++)
+    {
+        D.row_offsets[i] = d;
+        O.row_offsets[i] = o;
+
+        for (IndexType n = H.row_offsets[i]; n < H.row_offsets[i + 1]; n++)
+        {
+            const IndexType j = H.column_indices[n];
+
+            if (j >= begin && j < end)
+            {
+                D.column_indices[d] = j - begin;
+                D.values[d++] = H.values[n];
+            }
+            else
+            {
+                O.column_indices[o] = std::lower_bound(ghosts.begin(), ghosts.end(), j) - ghosts.begin();
+                O.values[o++] = H.values[n];
+            }
+        }
+    }
+
+    D.row_offsets[num_rows] = d;
+    O.row_offsets[num_rows] = o;
+
+    diagonal_block     = D;
+    off_diagonal_block = O;
+
+    // the ghosts are sorted, so those of each owner are contiguous
+    std::vector<int> recv_counts(size, 0);
+
+    for (size_t g = 0; g < ghosts.size(); g++)
+    {
+        const int owner = std::upper_bound(col_starts.begin(), col_starts.end(), ghosts[g]) - col_starts.begin() - 1;
+        recv_counts[owner]++;
+    }
+
+    // tell every owner which of its entries are needed
+    std::vector<int> send_counts(size, 0);
+
+    MPI_Alltoall(&recv_counts[0], 1, MPI_INT, &send_counts[0], 1, MPI_INT, comm);
+
+    std::vector<int> recv_displs(size + 1, 0);
+    std::vector<int> send_displs(size + 1, 0);
+
+    for (int p = 0; p < size; p++)
+    {
+        recv_displs[p + 1] = recv_displs[p] + recv_counts[p];
+        send_displs[p + 1] = send_displs[p] + send_counts[p];
+    }
+
+    std::vector<long long> requested(ghosts.begin(), ghosts.end());
+    std::vector<long long> needed(send_displs[size]);
+
+    MPI_Alltoallv(buffer_pointer(requested), &recv_counts[0], &recv_displs[0], MPI_LONG_LONG,
+                  buffer_pointer(needed),    &send_counts[0], &send_displs[0], MPI_LONG_LONG, comm);
+
+    send_ranks.clear();
+    recv_ranks.clear();
+    send_offsets.assign(1, 0);
+    recv_offsets.assign(1, 0);
+
+    for (int p = 0; p < size; p++)
+    {
+        if (recv_counts[p] > 0)
+        {
+            recv_ranks.push_back(p);
+            recv_offsets.push_back(recv_displs[p + 1]);
+        }
+
+        if (send_counts[p] > 0)
+        {
+            send_ranks.push_back(p);
+            send_offsets.push_back(send_displs[p + 1]);
+        }
+    }
+
+    cusp::array1d<IndexType,cusp::host_memory> indices(needed.size());
+
+    for (size_t n = 0; n < needed.size(); n++)
+        indices[n] = IndexType(needed[n]) - begin;
+
+    send_indices = indices;
+
+    send_buffer.resize(needed.size());
+    ghost_values.resize(ghosts.size());
+
+    if (cusp::distributed::detail::staged_exchange<MemorySpace>())
+    {
+        send_staging.resize(needed.size());
+        recv_staging.resize(ghosts.size());
+    }
+
+    requests.resize(send_ranks.size() + recv_ranks.size());
+
+    Parent::resize(num_rows, num_local_cols, H.num_entries);
+}
+
+template <typename IndexType, typename ValueType, class MemorySpace>
+void
+csr_matrix<IndexType,ValueType,MemorySpace>
+::begin_exchange(void) const
+{
+    using cusp::distributed::detail::buffer_pointer;
+
+    const bool staged = cusp::distributed::detail::staged_exchange<MemorySpace>();
+    const int  tag    = 0;
+
+    ValueType* recv = staged ? buffer_pointer(recv_staging) : buffer_pointer(ghost_values);
+    ValueType* send = staged ? buffer_pointer(send_staging) : buffer_pointer(send_buffer);
+
+    for (size_t i = 0; i < recv_ranks.size(); i++)
+        MPI_Irecv(recv + recv_offsets[i], (recv_offsets[i + 1] - recv_offsets[i]) * sizeof(ValueType), MPI_BYTE,
+                  recv_ranks[i], tag, comm, &requests[i]);
+
+    for (size_t i = 0; i < send_ranks.size(); i++)
+        MPI_Isend(send + send_offsets[i], (send_offsets[i + 1] - send_offsets[i]) * sizeof(ValueType), MPI_BYTE,
+                  send_ranks[i], tag, comm, &requests[recv_ranks.size() + i]);
+}
+
+template <typename IndexType, typename ValueType, class MemorySpace>
+void
+csr_matrix<IndexType,ValueType,MemorySpace>
+::end_exchange(void) const
+{
+    if (!requests.empty())
+        MPI_Waitall(requests.size(), &requests[0], MPI_STATUSES_IGNORE);
+
+    if (cusp::distributed::detail::staged_exchange<MemorySpace>())
+        thrust::copy(recv_staging.begin(), recv_staging.end(), ghost_values.begin());
+}
+
+template <typename IndexType, typename ValueType, class MemorySpace>
+template <typename DerivedPolicy, typename VectorType1, typename VectorType2>
+void
+csr_matrix<IndexType,ValueType,MemorySpace>
+::operator()(thrust::execution_policy<DerivedPolicy>& exec, const VectorType1& x, VectorType2& y) const
+{
+    // gather the entries requested by the neighbours
+    if (send_indices.size() > 0)
+    {
+        thrust::gather(exec, send_indices.begin(), send_indices.end(), x.begin(), send_buffer.begin());
+
+        if (cusp::distributed::detail::staged_exchange<MemorySpace>())
+            thrust::copy(send_buffer.begin(), send_buffer.end(), send_staging.begin());
+        else
+            cusp::distributed::detail::synchronize_exchange<MemorySpace>();
+    }
+
+    begin_exchange();
+
+    // the local product overlaps the halo exchange, ranks without local
+    // entries, e.g. those left out of a gathered coarse level, only clear y
+    if (diagonal_block.num_entries > 0)
+        cusp::multiply(exec, diagonal_block, x, y);
+    else
+        thrust::fill(exec, y.begin(), y.end(), ValueType(0));
+
+    end_exchange();
+
+    // y <- y + off_diagonal_block * ghost_values
+    if (off_diagonal_block.num_entries > 0)
+        cusp::multiply(exec, off_diagonal_block, ghost_values, y,
+                       thrust::identity<ValueType>(), thrust::multiplies<ValueType>(), thrust::plus<ValueType>());
+}
+
+template <typename IndexType, typename ValueType, class MemorySpace>
+template <typename VectorType1, typename VectorType2>
+void
+csr_matrix<IndexType,ValueType,MemorySpace>
+::operator()(const VectorType1& x, VectorType2& y) const
+{
+    MemorySpace system;
+
+    (*this)(system, x, y);
+}
+
+template <typename MatrixType1, typename MatrixType2>
+void local_rows(const MatrixType1& A, MPI_Comm comm, MatrixType2& B)
+{
+    typedef typename MatrixType1::index_type IndexType;
+    typedef typename MatrixType1::value_type ValueType;
+
+    cusp::csr_matrix<IndexType,ValueType,cusp::host_memory> H(A);
+
+    int size;
+    int rank;
+    MPI_Comm_size(comm, &size);
+    MPI_Comm_rank(comm, &rank);
+
+    const size_t begin = (H.num_rows * size_t(rank))     / size;
+    const size_t end   = (H.num_rows * size_t(rank + 1)) / size;
+
+    const IndexType offset = H.row_offsets[begin];
+
+    cusp::csr_matrix<IndexType,ValueType,cusp::host_memory> L(end - begin, H.num_cols, H.row_offsets[end] - offset);
+
+    for (size_t i = begin; i <= end; i++)
+        L.row_offsets[i - begin] = H.row_offsets[i] - offset;
+
+    thrust::copy(H.column_indices.begin() + offset, H.column_indices.begin() + H.row_offsets[end], L.column_indices.begin());
+    thrust::copy(H.values.begin()         + offset, H.values.begin()         + H.row_offsets[end], L.values.begin());
+
+    B = L;
+}
+
+} // end namespace distributed
+} // end namespace cusp
@@ -0,0 +1,208 @@
+/*
+ *  Copyright 2008-2014 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#pragma once
+
+#include <cusp/detail/config.h>
+
+#include <cusp/array1d.h>
+#include <cusp/complex.h>
+#include <cusp/memory.h>
+
+#include <thrust/copy.h>
+
+#include <mpi.h>
+
+#include <cstddef>
+#include <cstring>
+#include <vector>
+
+// Device buffers are handed to MPI directly when the library is CUDA-aware,
+// otherwise the halo exchange is staged through host memory. Open MPI
+// reports CUDA support in mpi-ext.h, other libraries require the macro to
+// be defined explicitly.
+#ifndef CUSP_CUDA_AWARE_MPI
+#  if defined(OPEN_MPI) && OPEN_MPI
+#    include <mpi-ext.h>
+#  endif
+#  if defined(MPIX_CUDA_AWARE_SUPPORT) && MPIX_CUDA_AWARE_SUPPORT
+#    define CUSP_CUDA_AWARE_MPI 1
+#  else
+#    define CUSP_CUDA_AWARE_MPI 0
+#  endif
+#endif
+
+namespace cusp
+{
+namespace distributed
+{
+namespace detail
+{
+
+template <typename T> struct mpi_datatype;
+
+template <> struct mpi_datatype<int>       { static MPI_Datatype value(void) { return MPI_INT;       } };
+template <> struct mpi_datatype<long>      { static MPI_Datatype value(void) { return MPI_LONG;      } };
+template <> struct mpi_datatype<long long> { static MPI_Datatype value(void) { return MPI_LONG_LONG; } };
+template <> struct mpi_datatype<float>     { static MPI_Datatype value(void) { return MPI_FLOAT;     } };
+template <> struct mpi_datatype<double>    { static MPI_Datatype value(void) { return MPI_DOUBLE;    } };
+
+// complex values are summed componentwise as pairs of their real type
+template <typename T>
+void allreduce_sum(MPI_Comm comm, T* values, const size_t n)
+{
+    typedef typename cusp::norm_type<T>::type Real;
+
+    const int count = int(n * (sizeof(T) / sizeof(Real)));
+
+    MPI_Allreduce(MPI_IN_PLACE, values, count, mpi_datatype<Real>::value(), MPI_SUM, comm);
+}
+
+// starts summing the values in host memory over all ranks, the values must
+// not be accessed until wait completes the request, MPI-2 libraries
+// without nonblocking collectives complete the sum immediately
+template <typename T>
+void iallreduce_sum(MPI_Comm comm, T* values, const size_t n, MPI_Request& request)
+{
+    typedef typename cusp::norm_type<T>::type Real;
+
+    const int count = int(n * (sizeof(T) / sizeof(Real)));
+
+#if MPI_VERSION >= 3
+    MPI_Iallreduce(MPI_IN_PLACE, values, count, mpi_datatype<Real>::value(), MPI_SUM, comm, &request);
+#else
+    MPI_Allreduce(MPI_IN_PLACE, values, count, mpi_datatype<Real>::value(), MPI_SUM, comm);
+    request = MPI_REQUEST_NULL;
+#endif
+}
+
+inline void wait(MPI_Request& request)
+{
+    if (request != MPI_REQUEST_NULL)
+        MPI_Wait(&request, MPI_STATUS_IGNORE);
+}
+
+template <typename T>
+T allreduce_max(MPI_Comm comm, T value)
+{
+    MPI_Allreduce(MPI_IN_PLACE, &value, 1, mpi_datatype<T>::value(), MPI_MAX, comm);
+
+    return value;
+}
+
+// pairs of a value and an index reduced with MPI_MAXLOC
+template <typename T> struct mpi_value_index_datatype;
+
+template <> struct mpi_value_index_datatype<float>  { static MPI_Datatype value(void) { return MPI_FLOAT_INT;  } };
+template <> struct mpi_value_index_datatype<double> { static MPI_Datatype value(void) { return MPI_DOUBLE_INT; } };
+
+// returns the largest value over all ranks and the index passed with it,
+// ties are resolved towards the smallest index
+template <typename T>
+int allreduce_maxloc(MPI_Comm comm, const T value, const int index)
+{
+    struct { T value; int index; } in, out;
+
+    in.value = value;
+    in.index = index;
+
+    MPI_Allreduce(&in, &out, 1, mpi_value_index_datatype<T>::value(), MPI_MAXLOC, comm);
+
+    return out.index;
+}
+
+// index of the first local entry of this rank when the entries of all
+// ranks are numbered in rank order
+inline size_t exclusive_offset(MPI_Comm comm, const size_t local_size)
+{
+    int rank;
+    MPI_Comm_rank(comm, &rank);
+
+    long long local  = (long long) local_size;
+    long long offset = 0;
+
+    MPI_Exscan(&local, &offset, 1, MPI_LONG_LONG, MPI_SUM, comm);
+
+    return rank == 0 ? 0 : size_t(offset);
+}
+
+// sums an array of partial results over all ranks through host memory
+template <typename Array>
+void allreduce_sum(MPI_Comm comm, Array& values)
+{
+    typedef typename Array::value_type ValueType;
+
+    if (values.size() == 0)
+        return;
+
+    cusp::array1d<ValueType, cusp::host_memory> host_values(values);
+
+    allreduce_sum(comm, &host_values[0], host_values.size());
+
+    thrust::copy(host_values.begin(), host_values.end(), values.begin());
+}
+
+// sends send[p] to rank p and returns the entries received from rank p in
+// recv[p], the entries are trivially copyable and travel as bytes
+template <typename T>
+void alltoallv(MPI_Comm comm,
+               const std::vector< std::vector<T> >& send,
+                     std::vector< std::vector<T> >& recv)
+{
+    int size;
+    MPI_Comm_size(comm, &size);
+
+    std::vector<int> send_counts(size);
+    std::vector<int> recv_counts(size);
+
+    for (int p = 0; p < size; p++)
+        send_counts[p] = int(send[p].size() * sizeof(T));
+
+    MPI_Alltoall(&send_counts[0], 1, MPI_INT, &recv_counts[0], 1, MPI_INT, comm);
+
+    std::vector<int> send_displs(size + 1, 0);
+    std::vector<int> recv_displs(size + 1, 0);
+
+    for (int p = 0; p < size; p++)
+    {
+        send_displs[p + 1] = send_displs[p] + send_counts[p];
+        recv_displs[p + 1] = recv_displs[p] + recv_counts[p];
+    }
+
+    std::vector<char> send_bytes(send_displs[size] + 1);
+    std::vector<char> recv_bytes(recv_displs[size] + 1);
+
+    for (int p = 0; p < size; p++)
+        if (send_counts[p] > 0)
+            std::memcpy(&send_bytes[send_displs[p]], &send[p][0], send_counts[p]);
+
+    MPI_Alltoallv(&send_bytes[0], &send_counts[0], &send_displs[0], MPI_BYTE,
+                  &recv_bytes[0], &recv_counts[0], &recv_displs[0], MPI_BYTE, comm);
+
+    recv.assign(size, std::vector<T>());
+
+    for (int p = 0; p < size; p++)
+    {
+        recv[p].resize(recv_counts[p] / sizeof(T));
+
+        if (recv_counts[p] > 0)
+            std::memcpy(&recv[p][0], &recv_bytes[recv_displs[p]], recv_counts[p]);
+    }
+}
+
+} // end namespace detail
+} // end namespace distributed
+} // end namespace cusp
@@ -0,0 +1,668 @@
+/*
+ *  Copyright 2008-2014 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include <cusp/array1d.h>
+#include <cusp/blas/blas.h>
+#include <cusp/complex.h>
+#include <cusp/csr_matrix.h>
+#include <cusp/exception.h>
+
+#include <cusp/detail/profile.h>
+
+#include <cusp/distributed/detail/mpi.h>
+#include <cusp/precond/aggregation/aggregate.h>
+#include <cusp/precond/aggregation/strength.h>
+
+#include <thrust/copy.h>
+
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+namespace cusp
+{
+namespace distributed
+{
+namespace detail
+{
+
+// global entry of a sparse matrix on its way to the owner of its row
+template <typename IndexType, typename ValueType>
+struct sa_entry
+{
+    IndexType row;
+    IndexType column;
+    ValueType value;
+
+    bool operator<(const sa_entry& other) const
+    {
+        return row < other.row || (row == other.row && column < other.column);
+    }
+};
+
+// sorts the entries and sums those with the same position
+template <typename Entry>
+void combine_entries(std::vector<Entry>& entries)
+{
+    std::sort(entries.begin(), entries.end());
+
+    size_t n = 0;
+
+    for (size_t k = 0; k < entries.size(); k++)
+    {
+        if (n > 0 && entries[n - 1].row == entries[k].row && entries[n - 1].column == entries[k].column)
+            entries[n - 1].value += entries[k].value;
+        else
+            entries[n++] = entries[k];
+    }
+
+    entries.resize(n);
+}
+
+// rows [first_row, first_row + num_rows) of the matrix formed by the entries
+template <typename Entry, typename MatrixType>
+void assemble_rows(std::vector<Entry>& entries, const size_t first_row,
+                   const size_t num_rows, const size_t num_cols, MatrixType& A)
+{
+    combine_entries(entries);
+
+    A.resize(num_rows, num_cols, entries.size());
+
+    std::fill(A.row_offsets.begin(), A.row_offsets.end(), 0);
+
+    for (size_t k = 0; k < entries.size(); k++)
+    {
+        A.row_offsets[entries[k].row - first_row + 1]++;
+        A.column_indices[k] = entries[k].column;
+        A.values[k]         = entries[k].value;
+    }
+
+    for (size_t i = 0; i < num_rows; i++)
+        A.row_offsets[i + 1] += A.row_offsets[i];
+}
+
+template <typename IndexType>
+int owner_of(const std::vector<IndexType>& starts, const IndexType i)
+{
+    return std::upper_bound(starts.begin(), starts.end(), i) - starts.begin() - 1;
+}
+
+// sends every entry to the owner of its row under the partition starts and
+// assembles the local rows of the result with global column indices
+template <typename Entry, typename IndexType, typename MatrixType>
+void redistribute_entries(MPI_Comm comm, const std::vector<Entry>& entries,
+                          const std::vector<IndexType>& starts, const size_t num_cols, MatrixType& A)
+{
+    int rank;
+    int size;
+    MPI_Comm_rank(comm, &rank);
+    MPI_Comm_size(comm, &size);
+
+    std::vector< std::vector<Entry> > send(size);
+    std::vector< std::vector<Entry> > recv;
+
+    for (size_t k = 0; k < entries.size(); k++)
+        send[owner_of(starts, entries[k].row)].push_back(entries[k]);
+
+    alltoallv(comm, send, recv);
+
+    std::vector<Entry> local;
+
+    for (int p = 0; p < size; p++)
+        local.insert(local.end(), recv[p].begin(), recv[p].end());
+
+    assemble_rows(local, starts[rank], starts[rank + 1] - starts[rank], num_cols, A);
+}
+
+// copies the rows with the sorted global indices requested from their
+// owners, the local rows of B hold global column indices
+template <typename IndexType, typename MatrixType>
+void fetch_rows(MPI_Comm comm, const std::vector<IndexType>& starts, const MatrixType& B,
+                const std::vector<IndexType>& requested, MatrixType& result)
+{
+    typedef typename MatrixType::value_type ValueType;
+    typedef sa_entry<IndexType,ValueType>   Entry;
+
+    int rank;
+    int size;
+    MPI_Comm_rank(comm, &rank);
+    MPI_Comm_size(comm, &size);
+
+    std::vector< std::vector<IndexType> > requests(size);
+    std::vector< std::vector<IndexType> > received;
+
+    for (size_t k = 0; k < requested.size(); k++)
+        requests[owner_of(starts, requested[k])].push_back(requested[k]);
+
+    alltoallv(comm, requests, received);
+
+    std::vector< std::vector<Entry> > replies(size);
+    std::vector< std::vector<Entry> > rows;
+
+    for (int p = 0; p < size; p++)
+    {
+        for (size_t k = 0; k < received[p].size(); k++)
+        {
+            const IndexType i = received[p][k] - starts[rank];
+
+            for (IndexType n = B.row_offsets[i]; n < B.row_offsets[i + 1]; n++)
+            {
+                Entry e = {received[p][k], B.column_indices[n], B.values[n]};
+                replies[p].push_back(e);
+            }
+        }
+    }
+
+    alltoallv(comm, replies, rows);
+
+    std::vector<Entry> entries;
+
+    for (int p = 0; p < size; p++)
+    {
+        for (size_t k = 0; k < rows[p].size(); k++)
+        {
+            Entry e = rows[p][k];
+            e.row = std::lower_bound(requested.begin(), requested.end(), e.row) - requested.begin();
+            entries.push_back(e);
+        }
+    }
+
+    assemble_rows(entries, 0, requested.size(), B.num_cols, result);
+}
+
+// C = A B for the local rows of A with global columns, the rows of B are
+// B_local for the columns in [begin, end) and B_ghost for the ghosts
+template <typename IndexType, typename MatrixType>
+void multiply_rows(const MatrixType& A, const IndexType begin, const IndexType end,
+                   const MatrixType& B_local, const MatrixType& B_ghost,
+                   const std::vector<IndexType>& ghosts, MatrixType& C)
+{
+    typedef typename MatrixType::value_type ValueType;
+    typedef sa_entry<IndexType,ValueType>   Entry;
+
+    std::vector<Entry> entries;
+
+    for (size_t i = 0; i < A.num_rows; i++)
+    {
+        for (IndexType n = A.row_offsets[i]; n < A.row_offsets[i + 1]; n++)
+        {
+            const IndexType j = A.column_indices[n];
+
+            const MatrixType& B = (j >= begin && j < end) ? B_local : B_ghost;
+            const IndexType   r = (j >= begin && j < end) ? j - begin
+                                : IndexType(std::lower_bound(ghosts.begin(), ghosts.end(), j) - ghosts.begin());
+
+            for (IndexType m = B.row_offsets[r]; m < B.row_offsets[r + 1]; m++)
+            {
+                Entry e = {IndexType(i), B.column_indices[m], A.values[n] * B.values[m]};
+                entries.push_back(e);
+            }
+        }
+    }
+
+    assemble_rows(entries, 0, A.num_rows, B_local.num_cols, C);
+}
+
+// local rows of a distributed matrix with global column indices
+template <typename MatrixType1, typename MatrixType2>
+void global_rows(const MatrixType1& A, MatrixType2& H)
+{
+    typedef typename MatrixType2::index_type IndexType;
+
+    int rank;
+    MPI_Comm_rank(A.communicator(), &rank);
+
+    const MatrixType2 D(A.diagonal_block);
+    const MatrixType2 O(A.off_diagonal_block);
+
+    const IndexType first_col = A.col_starts[rank];
+
+    H.resize(A.num_rows, A.num_global_cols(), D.num_entries + O.num_entries);
+
+    size_t k = 0;
+
+    for (size_t i = 0; i < A.num_rows; i++)
+    {
+        H.row_offsets[i] = k;
+
+        for (IndexType n = D.row_offsets[i]; n < D.row_offsets[i + 1]; n++, k++)
+        {
+            H.column_indices[k] = D.column_indices[n] + first_col;
+            H.values[k]         = D.values[n];
+        }
+
+        for (IndexType n = O.row_offsets[i]; n < O.row_offsets[i + 1]; n++, k++)
+        {
+            H.column_indices[k] = A.ghost_columns[O.column_indices[n]];
+            H.values[k]         = O.values[n];
+        }
+    }
+
+    H.row_offsets[A.num_rows] = k;
+}
+
+} // end namespace detail
+
+template <typename IndexType, typename ValueType, class MemorySpace>
+smoothed_aggregation<IndexType,ValueType,MemorySpace>
+::smoothed_aggregation(const matrix_type& A,
+                       const double theta,
+                       const size_t min_rows_per_rank,
+                       const size_t max_coarse_rows,
+                       const size_t max_levels)
+    : Parent(A.num_rows, A.num_rows), A_ptr(&A)
+{
+    setup(cusp::array1d<ValueType,cusp::host_memory>(A.num_rows, ValueType(1)),
+          theta, min_rows_per_rank, max_coarse_rows, max_levels);
+}
+
+template <typename IndexType, typename ValueType, class MemorySpace>
+template <typename ArrayType>
+smoothed_aggregation<IndexType,ValueType,MemorySpace>
+::smoothed_aggregation(const matrix_type& A,
+                       const ArrayType& B,
+                       const double theta,
+                       const size_t min_rows_per_rank,
+                       const size_t max_coarse_rows,
+                       const size_t max_levels)
+    : Parent(A.num_rows, A.num_rows), A_ptr(&A)
+{
+    setup(cusp::array1d<ValueType,cusp::host_memory>(B), theta, min_rows_per_rank, max_coarse_rows, max_levels);
+}
+
+template <typename IndexType, typename ValueType, class MemorySpace>
+template <typename ArrayType>
+void
+smoothed_aggregation<IndexType,ValueType,MemorySpace>
+::setup(const ArrayType& B_fine,
+        const double theta,
+        const size_t min_rows_per_rank,
+        const size_t max_coarse_rows,
+        const size_t max_levels)
+{
+    typedef cusp::csr_matrix<IndexType,ValueType,cusp::host_memory> HostMatrix;
+    typedef detail::sa_entry<IndexType,ValueType>                   Entry;
+    typedef typename cusp::norm_type<ValueType>::type               NormType;
+
+    MPI_Comm comm = A_ptr->communicator();
+
+    int rank;
+    int size;
+    MPI_Comm_rank(comm, &rank);
+    MPI_Comm_size(comm, &size);
+
+    if (B_fine.size() != A_ptr->num_rows)
+        throw cusp::invalid_input_exception("distributed::smoothed_aggregation: candidate size does not match the local rows");
+
+    // local rows with global columns and the row partition of the level
+    HostMatrix A;
+    detail::global_rows(*A_ptr, A);
+
+    std::vector<IndexType> starts(A_ptr->row_starts.begin(), A_ptr->row_starts.end());
+    cusp::array1d<ValueType,cusp::host_memory> B(B_fine);
+
+    int active = 0;
+
+    for (int p = 0; p < size; p++)
+        if (starts[p + 1] > starts[p])
+            active++;
+
+    levels.clear();
+
+    for (size_t lvl = 0; ; lvl++)
+    {
+        const IndexType begin = starts[rank];
+        const IndexType end   = starts[rank + 1];
+        const size_t    n     = end - begin;
+        const size_t    N     = starts[size];
+
+        levels.push_back(level());
+        level& L = levels.back();
+
+        if (lvl > 0)
+            L.A = matrix_type(A, comm);
+
+        const matrix_type& M = lvl == 0 ? *A_ptr : L.A;
+
+        long long entries = A.num_entries;
+        detail::allreduce_sum(comm, &entries, 1);
+
+        L.num_global_rows    = N;
+        L.num_global_entries = size_t(entries);
+        L.num_active_ranks   = active;
+
+        // the coarsest level is owned by a single rank and solved directly
+        if (active <= 1 && (N <= max_coarse_rows || lvl + 1 >= max_levels))
+        {
+            if (n > 0)
+                solver = cusp::detail::lu_solver<ValueType,cusp::host_memory>(HostMatrix(M.diagonal_block));
+
+            coarse_b.resize(n);
+            coarse_x.resize(n);
+            break;
+        }
+
+        // Jacobi damping from the bound max_i sum_j |A_ij| / |A_ii|
+        std::vector<ValueType> diagonal(n, ValueType(0));
+        NormType bound = 0;
+
+        for (size_t i = 0; i < n; i++)
+        {
+            NormType row_sum = 0;
+
+            for (IndexType k = A.row_offsets[i]; k < A.row_offsets[i + 1]; k++)
+            {
+                row_sum += cusp::abs(A.values[k]);
+
+                if (A.column_indices[k] == begin + IndexType(i))
+                    diagonal[i] = A.values[k];
+            }
+
+            if (diagonal[i] != ValueType(0))
+                bound = std::max(bound, NormType(row_sum / cusp::abs(diagonal[i])));
+        }
+
+        bound = detail::allreduce_max(comm, bound);
+
+        const NormType omega = bound > 0 ? NormType(4) / (NormType(3) * bound) : NormType(0);
+
+        cusp::array1d<ValueType,cusp::host_memory> diagonal_inverse(n, ValueType(0));
+
+        for (size_t i = 0; i < n; i++)
+            if (diagonal[i] != ValueType(0))
+                diagonal_inverse[i] = ValueType(omega) / diagonal[i];
+
+        L.diagonal_inverse = diagonal_inverse;
+
+        // decoupled aggregation of the strong connections within the rank
+        cusp::array1d<IndexType,cusp::host_memory> aggregates(n, IndexType(-1));
+        IndexType num_aggregates = 0;
+
+        if (n > 0)
+        {
+            HostMatrix D(M.diagonal_block);
+            HostMatrix S;
+
+            cusp::precond::aggregation::symmetric_strength_of_connection(D, S, theta);
+            cusp::precond::aggregation::standard_aggregate(S, aggregates);
+
+            num_aggregates = *std::max_element(aggregates.begin(), aggregates.end()) + 1;
+        }
+
+        // the coarse unknowns of every rank follow those of the lower ranks
+        long long local_aggregates = num_aggregates;
+        std::vector<long long> counts(size);
+
+        MPI_Allgather(&local_aggregates, 1, MPI_LONG_LONG, &counts[0], 1, MPI_LONG_LONG, comm);
+
+        IndexType first_aggregate = 0;
+        size_t    Nc              = 0;
+
+        for (int p = 0; p < size; p++)
+        {
+            if (p < rank)
+                first_aggregate += IndexType(counts[p]);
+
+            Nc += size_t(counts[p]);
+        }
+
+        // tentative prolongator, the candidate is normalized on every aggregate
+        std::vector<NormType> norms(num_aggregates, NormType(0));
+
+        for (size_t i = 0; i < n; i++)
+            if (aggregates[i] >= 0)
+                norms[aggregates[i]] += cusp::abs(B[i]) * cusp::abs(B[i]);
+
+        std::vector<Entry> T_entries;
+
+        for (size_t i = 0; i < n; i++)
+        {
+            if (aggregates[i] < 0)
+                continue;
+
+            Entry e = {IndexType(i), first_aggregate + aggregates[i], B[i] / ValueType(std::sqrt(norms[aggregates[i]]))};
+            T_entries.push_back(e);
+        }
+
+        HostMatrix T;
+        detail::assemble_rows(T_entries, 0, n, Nc, T);
+
+        // rows of T and P are needed for the ghost columns of A
+        std::vector<IndexType> ghosts;
+
+        for (size_t k = 0; k < A.num_entries; k++)
+            if (A.column_indices[k] < begin || A.column_indices[k] >= end)
+                ghosts.push_back(A.column_indices[k]);
+
+        std::sort(ghosts.begin(), ghosts.end());
+        ghosts.erase(std::unique(ghosts.begin(), ghosts.end()), ghosts.end());
+
+        // P = (I - omega D^-1 A) T
+        HostMatrix T_ghost;
+        HostMatrix AT;
+
+        detail::fetch_rows(comm, starts, T, ghosts, T_ghost);
+        detail::multiply_rows(A, begin, end, T, T_ghost, ghosts, AT);
+
+        std::vector<Entry> P_entries;
+
+        for (size_t i = 0; i < n; i++)
+        {
+            for (IndexType k = T.row_offsets[i]; k < T.row_offsets[i + 1]; k++)
+            {
+                Entry e = {IndexType(i), T.column_indices[k], T.values[k]};
+                P_entries.push_back(e);
+            }
+
+            for (IndexType k = AT.row_offsets[i]; k < AT.row_offsets[i + 1]; k++)
+            {
+                Entry e = {IndexType(i), AT.column_indices[k], -diagonal_inverse[i] * AT.values[k]};
+                P_entries.push_back(e);
+            }
+        }
+
+        HostMatrix P;
+        detail::assemble_rows(P_entries, 0, n, Nc, P);
+
+        HostMatrix P_ghost;
+        HostMatrix AP;
+
+        detail::fetch_rows(comm, starts, P, ghosts, P_ghost);
+        detail::multiply_rows(A, begin, end, P, P_ghost, ghosts, AP);
+
+        // the next level is gathered onto fewer ranks when it is small
+        int coarse_active = active;
+
+        if (Nc / std::max(min_rows_per_rank, size_t(1)) < size_t(coarse_active))
+            coarse_active = int(std::max(Nc / std::max(min_rows_per_rank, size_t(1)), size_t(1)));
+
+        if (Nc <= max_coarse_rows || lvl + 2 >= max_levels)
+            coarse_active = 1;
+
+        std::vector<IndexType> coarse_starts(size + 1);
+
+        for (int p = 0; p <= size; p++)
+            coarse_starts[p] = IndexType((Nc * size_t(std::min(p, coarse_active))) / coarse_active);
+
+        // Galerkin product from the local contributions P_i^T (A P)_i
+        std::vector<Entry> RAP_entries;
+
+        for (size_t i = 0; i < n; i++)
+        {
+            for (IndexType k = P.row_offsets[i]; k < P.row_offsets[i + 1]; k++)
+            {
+                for (IndexType m = AP.row_offsets[i]; m < AP.row_offsets[i + 1]; m++)
+                {
+                    Entry e = {P.column_indices[k], AP.column_indices[m], P.values[k] * AP.values[m]};
+                    RAP_entries.push_back(e);
+                }
+            }
+        }
+
+        detail::combine_entries(RAP_entries);
+
+        HostMatrix A_coarse;
+        detail::redistribute_entries(comm, RAP_entries, coarse_starts, Nc, A_coarse);
+
+        // R = P^T is formed on the owners of the coarse rows
+        std::vector<Entry> R_entries;
+
+        for (size_t i = 0; i < n; i++)
+        {
+            for (IndexType k = P.row_offsets[i]; k < P.row_offsets[i + 1]; k++)
+            {
+                Entry e = {P.column_indices[k], begin + IndexType(i), P.values[k]};
+                R_entries.push_back(e);
+            }
+        }
+
+        HostMatrix R;
+        detail::redistribute_entries(comm, R_entries, coarse_starts, N, R);
+
+        // the coarse candidate moves with the coarse rows
+        std::vector<Entry> B_entries;
+
+        for (IndexType a = 0; a < num_aggregates; a++)
+        {
+            Entry e = {first_aggregate + a, 0, ValueType(std::sqrt(norms[a]))};
+            B_entries.push_back(e);
+        }
+
+        HostMatrix B_coarse;
+        detail::redistribute_entries(comm, B_entries, coarse_starts, 1, B_coarse);
+
+        const size_t n_coarse = coarse_starts[rank + 1] - coarse_starts[rank];
+
+        B.resize(n_coarse);
+
+        for (size_t i = 0; i < n_coarse; i++)
+            B[i] = B_coarse.row_offsets[i + 1] > B_coarse.row_offsets[i] ? B_coarse.values[B_coarse.row_offsets[i]] : ValueType(0);
+
+        L.P = matrix_type(P, n_coarse, comm);
+        L.R = matrix_type(R, n,        comm);
+        L.residual.resize(n);
+
+        A      = A_coarse;
+        starts = coarse_starts;
+        active = coarse_active;
+    }
+
+    // right-hand side and solution of every coarse level
+    for (size_t lvl = 1; lvl < levels.size(); lvl++)
+    {
+        levels[lvl].b.resize(levels[lvl].A.num_rows);
+        levels[lvl].x.resize(levels[lvl].A.num_rows);
+    }
+}
+
+template <typename IndexType, typename ValueType, class MemorySpace>
+size_t
+smoothed_aggregation<IndexType,ValueType,MemorySpace>
+::num_levels(void) const
+{
+    return levels.size();
+}
+
+template <typename IndexType, typename ValueType, class MemorySpace>
+void
+smoothed_aggregation<IndexType,ValueType,MemorySpace>
+::print(void) const
+{
+    int rank;
+    MPI_Comm_rank(A_ptr->communicator(), &rank);
+
+    if (rank != 0)
+        return;
+
+    std::cout << "\tNumber of Levels:\t" << levels.size() << std::endl;
+    std::cout << "\tlevel\tranks\trows\tnonzeros" << std::endl;
+
+    for (size_t lvl = 0; lvl < levels.size(); lvl++)
+        std::cout << "\t" << lvl
+                  << "\t" << levels[lvl].num_active_ranks
+                  << "\t" << levels[lvl].num_global_rows
+                  << "\t" << levels[lvl].num_global_entries << std::endl;
+}
+
+template <typename IndexType, typename ValueType, class MemorySpace>
+template <typename VectorType1, typename VectorType2>
+void
+smoothed_aggregation<IndexType,ValueType,MemorySpace>
+::cycle(const size_t i, const VectorType1& b, VectorType2& x) const
+{
+    cusp::detail::profile_range range("cusp::distributed::smoothed_aggregation level", i);
+
+    const level& L = levels[i];
+
+    if (i + 1 == levels.size())
+    {
+        // only the rank owning the coarsest level has work to do
+        if (coarse_b.size() > 0)
+        {
+            thrust::copy(b.begin(), b.end(), coarse_b.begin());
+            solver(coarse_b, coarse_x);
+            thrust::copy(coarse_x.begin(), coarse_x.end(), x.begin());
+        }
+
+        return;
+    }
+
+    const matrix_type& A = i == 0 ? *A_ptr : L.A;
+
+    // presmooth from a zero initial guess
+    cusp::blas::xmy(L.diagonal_inverse, b, x);
+
+    // restrict the residual b - A x
+    A(x, L.residual);
+    cusp::blas::axpby(b, L.residual, L.residual, ValueType(1), ValueType(-1));
+    L.R(L.residual, levels[i + 1].b);
+
+    cycle(i + 1, levels[i + 1].b, levels[i + 1].x);
+
+    // apply the coarse grid correction
+    L.P(levels[i + 1].x, L.residual);
+    cusp::blas::axpy(L.residual, x, ValueType(1));
+
+    // postsmooth
+    A(x, L.residual);
+    cusp::blas::axpby(b, L.residual, L.residual, ValueType(1), ValueType(-1));
+    cusp::blas::xmy(L.diagonal_inverse, L.residual, L.residual);
+    cusp::blas::axpy(L.residual, x, ValueType(1));
+}
+
+template <typename IndexType, typename ValueType, class MemorySpace>
+template <typename DerivedPolicy, typename VectorType1, typename VectorType2>
+void
+smoothed_aggregation<IndexType,ValueType,MemorySpace>
+::operator()(thrust::execution_policy<DerivedPolicy>& exec, const VectorType1& x, VectorType2& y) const
+{
+    // the cycle has no reductions, its products communicate themselves
+    cycle(0, x, y);
+}
+
+template <typename IndexType, typename ValueType, class MemorySpace>
+template <typename VectorType1, typename VectorType2>
+void
+smoothed_aggregation<IndexType,ValueType,MemorySpace>
+::operator()(const VectorType1& x, VectorType2& y) const
+{
+    cycle(0, x, y);
+}
+
+} // end namespace distributed
+} // end namespace cusp
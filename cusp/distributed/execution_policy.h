@@ -0,0 +1,91 @@
+/*
+ *  Copyright 2008-2014 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*! \file cusp/distributed/execution_policy.h
+ *  \brief Execution policies for rows distributed over MPI ranks
+ */
+
+#pragma once
+
+#include <cusp/detail/config.h>
+
+#include <cusp/execution_policy.h>
+
+#include <cusp/system/detail/distributed/execution_policy.h>
+#include <cusp/system/detail/distributed/blas.h>
+
+#include <mpi.h>
+
+namespace cusp
+{
+namespace distributed
+{
+
+/*! \addtogroup utilities Utilities
+ *  \{
+ */
+
+/*! \brief Policy running on the host system with reductions over MPI ranks */
+typedef cusp::system::detail::distributed::execute_distributed<
+          cusp::system::__THRUST_HOST_SYSTEM_NAMESPACE::detail::execution_policy>   host_policy;
+
+/*! \brief Policy running on the device system with reductions over MPI ranks */
+typedef cusp::system::detail::distributed::execute_distributed<
+          cusp::system::__THRUST_DEVICE_SYSTEM_NAMESPACE::detail::execution_policy> device_policy;
+
+/**
+ * \brief Returns a host policy whose reductions span the ranks of \p comm
+ *
+ * \param comm communicator over which the rows of the vectors are distributed
+ *
+ * \par Overview
+ *  Every algorithm runs on the rows owned by the calling rank, but the
+ *  \p cusp::blas reductions \p dot, \p dotc, \p nrm2, \p asum,
+ *  \p nrmmax, \p dots, \p dotcs, \p dotc_nrm2 and \p axpy_axpy_dotc sum
+ *  their partial results over \p comm with \c MPI_Allreduce, and \p amax
+ *  returns the global index of the entry of largest magnitude. The fused
+ *  reductions of the solvers pass through \p cusp::blas::allreduce, or
+ *  through \p allreduce_begin and \p allreduce_end, which start an
+ *  \c MPI_Iallreduce that the pipelined solvers overlap with their sparse
+ *  matrix-vector products. Passing the policy together with a
+ *  \p cusp::distributed::csr_matrix to the execution policy overloads of
+ *  the \p cusp::krylov solvers and to the \p cusp::monitor constructor
+ *  runs the unmodified solvers on the distributed system.
+ *
+ * \see device_par
+ */
+inline host_policy host_par(MPI_Comm comm)
+{
+    return host_policy(comm);
+}
+
+/**
+ * \brief Returns a device policy whose reductions span the ranks of \p comm
+ *
+ * \param comm communicator over which the rows of the vectors are distributed
+ *
+ * \see host_par
+ */
+inline device_policy device_par(MPI_Comm comm)
+{
+    return device_policy(comm);
+}
+
+/*! \}
+ */
+
+} // end namespace distributed
+} // end namespace cusp
@@ -0,0 +1,235 @@
+/*
+ *  Copyright 2008-2014 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*! \file cusp/distributed/smoothed_aggregation.h
+ *  \brief Smoothed aggregation multigrid on a row distributed matrix
+ */
+
+#pragma once
+
+#include <cusp/detail/config.h>
+
+#include <cusp/array1d.h>
+#include <cusp/linear_operator.h>
+#include <cusp/detail/lu.h>
+
+#include <cusp/distributed/csr_matrix.h>
+
+#include <mpi.h>
+
+#include <vector>
+
+namespace cusp
+{
+namespace distributed
+{
+
+/*! \addtogroup preconditioners Preconditioners
+ *  \{
+ */
+
+/**
+ * \brief Smoothed aggregation preconditioner for a
+ * \p cusp::distributed::csr_matrix
+ *
+ * \tparam IndexType Type used for matrix indices (e.g. \c int).
+ * \tparam ValueType Type used for matrix values (e.g. \c float).
+ * \tparam MemorySpace A memory space (e.g. \c cusp::host_memory or \c cusp::device_memory)
+ *
+ * \par Overview
+ *  The hierarchy follows \p cusp::precond::aggregation::smoothed_aggregation
+ *  with decoupled aggregation: every rank aggregates the strong connections
+ *  of its diagonal block with \p standard_aggregate, so aggregates never
+ *  span ranks and the coarse unknowns of each rank are numbered after those
+ *  of the lower ranks. The tentative prolongator fits the near nullspace
+ *  candidate on every aggregate and is smoothed with one damped Jacobi step
+ *  across ranks, P = (I - omega D^-1 A) T, using the rows of T owned by the
+ *  neighbours. The Galerkin product R A P with R = P^T is formed from the
+ *  rank-local contributions, which are summed by the owners of the coarse
+ *  rows.
+ *
+ *  The coarse levels are progressively gathered onto fewer ranks: level
+ *  l + 1 is owned by the first <tt>N / min_rows_per_rank</tt> ranks that
+ *  own level l, so small levels do not pay for communication with idle
+ *  ranks. The coarsest level, with at most \p max_coarse_rows rows, lives
+ *  on a single rank and is solved with a dense LU factorization.
+ *
+ *  Every level is smoothed with one step of damped Jacobi before and after
+ *  the coarse grid correction, the damping 4 / (3 rho) uses the bound
+ *  rho <= max_i sum_j |A_ij| / |A_ii| on the spectral radius of D^-1 A,
+ *  which needs a single reduction. The V-cycle is symmetric and suitable
+ *  for \p cusp::krylov::cg called with the policy of \p host_par or
+ *  \p device_par.
+ *
+ *  The hierarchy is set up in host memory and the operators of every level
+ *  are copied to \p MemorySpace.
+ *
+ * \note The preconditioner keeps a reference to the finest matrix, and the
+ *  constructor and every application are collective over its communicator.
+ *
+ * \par Example
+ *  \code
+ *  #include <cusp/csr_matrix.h>
+ *  #include <cusp/monitor.h>
+ *  #include <cusp/distributed/csr_matrix.h>
+ *  #include <cusp/distributed/smoothed_aggregation.h>
+ *  #include <cusp/gallery/poisson.h>
+ *  #include <cusp/krylov/cg.h>
+ *
+ *  int main(int argc, char** argv)
+ *  {
+ *      MPI_Init(&argc, &argv);
+ *
+ *      cusp::csr_matrix<int, double, cusp::host_memory> G, L;
+ *      cusp::gallery::poisson5pt(G, 512, 512);
+ *      cusp::distributed::local_rows(G, MPI_COMM_WORLD, L);
+ *
+ *      cusp::distributed::csr_matrix<int, double, cusp::device_memory> A(L, MPI_COMM_WORLD);
+ *      cusp::distributed::smoothed_aggregation<int, double, cusp::device_memory> M(A);
+ *
+ *      cusp::array1d<double, cusp::device_memory> x(A.num_rows, 0);
+ *      cusp::array1d<double, cusp::device_memory> b(A.num_rows, 1);
+ *
+ *      cusp::distributed::device_policy exec = cusp::distributed::device_par(MPI_COMM_WORLD);
+ *      cusp::monitor<double> monitor(exec, b, 100, 1e-8);
+ *
+ *      cusp::krylov::cg(exec, A, x, b, monitor, M);
+ *
+ *      M.print();
+ *
+ *      MPI_Finalize();
+ *
+ *      return 0;
+ *  }
+ *  \endcode
+ */
+template <typename IndexType, typename ValueType, class MemorySpace>
+class smoothed_aggregation : public cusp::linear_operator<ValueType,MemorySpace,IndexType>
+{
+private:
+
+    typedef cusp::linear_operator<ValueType,MemorySpace,IndexType> Parent;
+
+public:
+
+    /*! \cond */
+    typedef cusp::distributed::csr_matrix<IndexType,ValueType,MemorySpace> matrix_type;
+    typedef cusp::array1d<ValueType,MemorySpace>                          array_type;
+
+    struct level
+    {
+        matrix_type A;     // operator of the level, the finest is referenced
+        matrix_type R;     // restriction to the next level
+        matrix_type P;     // prolongation from the next level
+
+        array_type diagonal_inverse;   // omega / A_ii
+
+        mutable array_type b;
+        mutable array_type x;
+        mutable array_type residual;
+
+        size_t num_global_rows;
+        size_t num_global_entries;
+        int    num_active_ranks;
+    };
+
+    std::vector<level> levels;
+    /*! \endcond */
+
+    /*! Construct the hierarchy of \p A with the constant near nullspace
+     *  candidate.
+     *
+     *  \param A finest level matrix
+     *  \param theta strength of connection threshold
+     *  \param min_rows_per_rank coarse levels are gathered onto fewer ranks
+     *  until every active rank owns at least this many rows
+     *  \param max_coarse_rows number of rows below which the coarsening stops
+     *  \param max_levels maximum number of levels
+     */
+    smoothed_aggregation(const matrix_type& A,
+                         const double theta = 0.0,
+                         const size_t min_rows_per_rank = 1000,
+                         const size_t max_coarse_rows = 256,
+                         const size_t max_levels = 10);
+
+    /*! Construct the hierarchy of \p A with a near nullspace candidate.
+     *
+     *  \param A finest level matrix
+     *  \param B local rows of the near nullspace candidate
+     *  \param theta strength of connection threshold
+     *  \param min_rows_per_rank coarse levels are gathered onto fewer ranks
+     *  until every active rank owns at least this many rows
+     *  \param max_coarse_rows number of rows below which the coarsening stops
+     *  \param max_levels maximum number of levels
+     */
+    template <typename ArrayType>
+    smoothed_aggregation(const matrix_type& A,
+                         const ArrayType& B,
+                         const double theta = 0.0,
+                         const size_t min_rows_per_rank = 1000,
+                         const size_t max_coarse_rows = 256,
+                         const size_t max_levels = 10);
+
+    /*! Number of levels of the hierarchy.
+     */
+    size_t num_levels(void) const;
+
+    /*! Print the size and the number of active ranks of every level on
+     *  rank 0.
+     */
+    void print(void) const;
+
+    /*! Apply one V-cycle with a zero initial guess, y = M x.
+     *
+     *  \param x Local rows of the input vector.
+     *  \param y Local rows of the output vector.
+     */
+    template <typename DerivedPolicy, typename VectorType1, typename VectorType2>
+    void operator()(thrust::execution_policy<DerivedPolicy>& exec, const VectorType1& x, VectorType2& y) const;
+
+    /*! Apply one V-cycle with a zero initial guess, y = M x.
+     *
+     *  \param x Local rows of the input vector.
+     *  \param y Local rows of the output vector.
+     */
+    template <typename VectorType1, typename VectorType2>
+    void operator()(const VectorType1& x, VectorType2& y) const;
+
+private:
+
+    /*! \cond */
+    const matrix_type* A_ptr;
+
+    cusp::detail::lu_solver<ValueType,cusp::host_memory> solver;
+
+    mutable cusp::array1d<ValueType,cusp::host_memory> coarse_b;
+    mutable cusp::array1d<ValueType,cusp::host_memory> coarse_x;
+
+    template <typename ArrayType>
+    void setup(const ArrayType& B, const double theta, const size_t min_rows_per_rank,
+               const size_t max_coarse_rows, const size_t max_levels);
+
+    template <typename VectorType1, typename VectorType2>
+    void cycle(const size_t i, const VectorType1& b, VectorType2& x) const;
+    /*! \endcond */
+}; // class smoothed_aggregation
+/*! \}
+ */
+
+} // end namespace distributed
+} // end namespace cusp
+
+#include <cusp/distributed/detail/smoothed_aggregation.inl>
@@ -0,0 +1,247 @@
+/*
+ *  Copyright 2008-2014 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*! \file dynamic_csr_matrix.h
+ *  \brief Compressed Sparse Row matrix format with free capacity per row.
+ */
+
+#pragma once
+
+#include <cusp/detail/config.h>
+
+#include <cusp/array1d.h>
+#include <cusp/memory.h>
+
+#include <cusp/detail/format.h>
+#include <cusp/detail/matrix_base.h>
+#include <cusp/detail/type_traits.h>
+
+namespace cusp
+{
+
+/*! \addtogroup sparse_matrices Sparse Matrices
+ */
+
+/*! \addtogroup sparse_matrix_containers Sparse Matrix Containers
+ *  \ingroup sparse_matrices
+ *  \{
+ */
+
+/**
+ * \brief CSR representation of a sparse matrix which accepts new entries
+ * without being rebuilt
+ *
+ * \tparam IndexType Type used for matrix indices (e.g. \c int).
+ * \tparam ValueType Type used for matrix values (e.g. \c float).
+ * \tparam MemorySpace A memory space (e.g. \c cusp::host_memory or \c cusp::device_memory)
+ *
+ * \par Overview
+ *  A \p dynamic_csr_matrix stores every row in a segment of
+ *  \c column_indices and \c values which is larger than the row itself.
+ *  Row \c i starts at <tt>row_offsets[i]</tt>, holds <tt>row_lengths[i]</tt>
+ *  entries sorted by column, and may grow up to
+ *  <tt>row_offsets[i + 1]</tt> before the storage has to be reallocated.
+ *  The slots past the end of a row are unused.
+ *
+ *  Batches of entries are inserted or erased in the memory space of the
+ *  matrix with \p insert and \p erase, which only move the entries of the
+ *  affected rows. Rows running out of capacity are reallocated together in
+ *  a single pass, which grants them <tt>slack * length</tt>, but at least
+ *  \c min_row_slack, free slots. Conversions from other formats grant the
+ *  same free capacity to every row.
+ *
+ *  A matrix-vector multiplication reads one row length per row in addition
+ *  to the CSR data and otherwise runs like the CSR kernels. The conversion
+ *  to a \p csr_matrix removes the free slots with a scan and a gather.
+ *
+ * \note Entries within a row are kept sorted by column and unique.
+ *
+ * \par Example
+ *  The following code snippet demonstrates how to add entries to a
+ *  \p dynamic_csr_matrix on the device and compact it to a \p csr_matrix.
+ *
+ *  \code
+ *  // include the dynamic_csr_matrix header file
+ *  #include <cusp/csr_matrix.h>
+ *  #include <cusp/dynamic_csr_matrix.h>
+ *  #include <cusp/gallery/poisson.h>
+ *  #include <cusp/print.h>
+ *
+ *  int main()
+ *  {
+ *    cusp::csr_matrix<int,float,cusp::device_memory> A;
+ *    cusp::gallery::poisson5pt(A, 4, 4);
+ *
+ *    // keep free capacity in every row
+ *    cusp::dynamic_csr_matrix<int,float,cusp::device_memory> B(A);
+ *
+ *    // couple the corners of the grid
+ *    cusp::array1d<int,cusp::device_memory>   rows(2), cols(2);
+ *    cusp::array1d<float,cusp::device_memory> vals(2, -1.0f);
+ *    rows[0] = 0;  cols[0] = 15;
+ *    rows[1] = 15; cols[1] = 0;
+ *
+ *    B.insert(rows, cols, vals);
+ *
+ *    // remove the free slots
+ *    cusp::csr_matrix<int,float,cusp::device_memory> C(B);
+ *
+ *    cusp::print(C);
+ *  }
+ *  \endcode
+ */
+template <typename IndexType, typename ValueType, class MemorySpace>
+class dynamic_csr_matrix : public cusp::detail::matrix_base<IndexType,ValueType,MemorySpace,cusp::dynamic_csr_format>
+{
+private:
+
+    typedef cusp::detail::matrix_base<IndexType,ValueType,MemorySpace,cusp::dynamic_csr_format> Parent;
+
+public:
+
+    /*! \cond */
+    typedef typename cusp::array1d<IndexType, MemorySpace> row_offsets_array_type;
+    typedef typename cusp::array1d<IndexType, MemorySpace> row_lengths_array_type;
+    typedef typename cusp::array1d<IndexType, MemorySpace> column_indices_array_type;
+    typedef typename cusp::array1d<ValueType, MemorySpace> values_array_type;
+
+    typedef typename cusp::dynamic_csr_matrix<IndexType, ValueType, MemorySpace> container;
+
+    template<typename MemorySpace2>
+    struct rebind
+    {
+        typedef cusp::dynamic_csr_matrix<IndexType, ValueType, MemorySpace2> type;
+    };
+    /*! \endcond */
+
+    /*! Storage for the first slot of every row, the last value is the
+     *  capacity of the matrix.
+     */
+    row_offsets_array_type row_offsets;
+
+    /*! Storage for the number of entries stored in every row.
+     */
+    row_lengths_array_type row_lengths;
+
+    /*! Storage for the column indices, including the unused slots.
+     */
+    column_indices_array_type column_indices;
+
+    /*! Storage for the values, including the unused slots.
+     */
+    values_array_type values;
+
+    /*! Free capacity granted to a row which is (re)allocated, as a
+     *  fraction of its length.
+     */
+    float slack;
+
+    /*! Lower bound on the free capacity granted to a (re)allocated row.
+     */
+    size_t min_row_slack;
+
+    /*! Construct an empty \p dynamic_csr_matrix.
+     */
+    dynamic_csr_matrix(void)
+        : slack(0.25f), min_row_slack(2) {}
+
+    /*! Construct a \p dynamic_csr_matrix without entries whose rows have
+     *  the same capacity.
+     *
+     *  \param num_rows Number of rows.
+     *  \param num_cols Number of columns.
+     *  \param row_capacity Number of entries every row can hold.
+     */
+    dynamic_csr_matrix(const size_t num_rows, const size_t num_cols, const size_t row_capacity);
+
+    /*! Construct a \p dynamic_csr_matrix from another matrix.
+     *
+     *  \param matrix Another sparse or dense matrix.
+     */
+    template <typename MatrixType>
+    dynamic_csr_matrix(const MatrixType& matrix);
+
+    /*! Number of entries the matrix can hold without a reallocation.
+     */
+    size_t capacity(void) const
+    {
+        return column_indices.size();
+    }
+
+    /*! Resize matrix dimensions and underlying storage. The layout of the
+     *  rows is left to the caller.
+     *
+     *  \param num_rows Number of rows.
+     *  \param num_cols Number of columns.
+     *  \param num_entries Number of nonzero matrix entries.
+     *  \param capacity Number of slots of \c column_indices and \c values.
+     */
+    void resize(const size_t num_rows, const size_t num_cols, const size_t num_entries,
+                const size_t capacity);
+
+    /*! Swap the contents of two \p dynamic_csr_matrix objects.
+     *
+     *  \param matrix Another \p dynamic_csr_matrix with the same IndexType and ValueType.
+     */
+    void swap(dynamic_csr_matrix& matrix);
+
+    /*! Insert a batch of entries.
+     *
+     *  Entries which are already stored receive the new value. When a
+     *  position occurs more than once in the batch the last occurrence
+     *  wins. Rows without enough free capacity are reallocated.
+     *
+     *  \param rows Array of row indices.
+     *  \param cols Array of column indices.
+     *  \param vals Array of values.
+     *
+     *  \throws cusp::invalid_input_exception if the arrays differ in size
+     *  or an index lies outside the matrix
+     */
+    template <typename ArrayType1, typename ArrayType2, typename ArrayType3>
+    void insert(const ArrayType1& rows, const ArrayType2& cols, const ArrayType3& vals);
+
+    /*! Erase a batch of entries. Positions which are not stored are
+     *  ignored, the capacity of the rows is kept.
+     *
+     *  \param rows Array of row indices.
+     *  \param cols Array of column indices.
+     *
+     *  \throws cusp::invalid_input_exception if the arrays differ in size
+     */
+    template <typename ArrayType1, typename ArrayType2>
+    void erase(const ArrayType1& rows, const ArrayType2& cols);
+
+    /*! Reallocate every row with the free capacity granted by \c slack
+     *  and \c min_row_slack, e.g. after many entries were erased.
+     */
+    void rebalance(void);
+
+    /*! Assignment from another matrix.
+     *
+     *  \tparam MatrixType Format type of input matrix.
+     *
+     *  \param matrix Another sparse or dense matrix.
+     */
+    template <typename MatrixType>
+    dynamic_csr_matrix& operator=(const MatrixType& matrix);
+}; // class dynamic_csr_matrix
+/*! \}
+ */
+
+} // end namespace cusp
+
+#include <cusp/detail/dynamic_csr_matrix.inl>
@@ -82,6 +82,78 @@ namespace eigen
 template <typename Matrix, typename Array2d>
 void arnoldi(const Matrix& A, Array2d& H, size_t k = 10);
 
+/**
+ * \brief Implicitly restarted Arnoldi method
+ *
+ * \tparam Matrix type of a sparse or dense matrix
+ * \tparam Array1d type of the array of complex eigenvalues
+ *
+ * \param A matrix of the linear system
+ * \param eigVals eigenvalues, the size of \p eigVals on input is the
+ * number of eigenvalues to compute
+ * \param maxBasis maximum number of Arnoldi vectors
+ * \param maxRestarts maximum number of implicit restarts
+ * \param tol relative tolerance on the Ritz residual norms
+ *
+ * \return true if all requested eigenvalues converged
+ *
+ * \par Overview
+ * Computes the eigenvalues of largest magnitude of a real, possibly
+ * nonsymmetric, matrix with the implicitly restarted Arnoldi method
+ * (IRAM). The Arnoldi basis never grows beyond \p maxBasis vectors:
+ * it is stored in a single column-major \p array2d and every new vector
+ * is orthogonalized against it twice with \p blas::dotcs and
+ * \p blas::gemv. Once the basis is full, the unwanted Ritz values are
+ * applied as exact shifts through implicit QR steps on the Hessenberg
+ * matrix. Complex conjugate shifts are applied together as double
+ * shifts, so the basis stays real. The factorization is then contracted
+ * to the wanted Ritz vectors and extended again.
+ *
+ * A Ritz value \f$\theta\f$ is converged if its residual norm is below
+ * \p tol times \f$\max(|\theta|, \epsilon^{2/3})\f$. \p eigVals
+ * holds the eigenvalues in order of decreasing magnitude and must have
+ * a complex value type.
+ *
+ * \note \p maxBasis must be at least the number of requested
+ * eigenvalues plus two.
+ *
+ * \par Example
+ *  The following code snippet demonstrates how to use \p
+ *  implicitly_restarted_arnoldi to compute the three eigenvalues of
+ *  largest magnitude of a 100x100 Laplacian matrix with a basis of at
+ *  most 10 vectors.
+ *
+ *  \code
+ *  #include <cusp/complex.h>
+ *  #include <cusp/csr_matrix.h>
+ *  #include <cusp/eigen/arnoldi.h>
+ *  #include <cusp/gallery/poisson.h>
+ *
+ *  int main(void)
+ *  {
+ *      // create an empty sparse matrix structure (CSR format)
+ *      cusp::csr_matrix<int, double, cusp::device_memory> A;
+ *
+ *      // initialize matrix
+ *      cusp::gallery::poisson5pt(A, 10, 10);
+ *
+ *      // compute the three eigenvalues of largest magnitude
+ *      cusp::array1d<cusp::complex<double>, cusp::host_memory> eigVals(3);
+ *      bool converged = cusp::eigen::implicitly_restarted_arnoldi(A, eigVals, 10);
+ *
+ *      std::cout << "Spectral radius of A : " << cusp::abs(eigVals[0]) << std::endl;
+ *
+ *      return 0;
+ *  }
+ *  \endcode
+ */
+template <typename Matrix, typename Array1d>
+bool implicitly_restarted_arnoldi(const Matrix& A,
+                                  Array1d& eigVals,
+                                  size_t maxBasis = 20,
+                                  size_t maxRestarts = 100,
+                                  double tol = 1e-6);
+
 /*! \}
  */
 
@@ -0,0 +1,141 @@
+/*
+ *  Copyright 2008-2014 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*! \file block_lanczos.h
+ *  \brief Block Lanczos method
+ */
+
+#pragma once
+
+#include <cusp/detail/config.h>
+
+#include <cusp/eigen/lanczos_options.h>
+
+namespace cusp
+{
+namespace eigen
+{
+
+/*! \addtogroup iterative_solvers Iterative Solvers
+ *  \addtogroup eigensolvers EigenSolvers
+ *  \ingroup iterative_solvers
+ *  \{
+ */
+
+/* \cond */
+template <typename LinearOperator,
+          typename Array1d>
+void block_lanczos(const LinearOperator& A,
+                         Array1d& eigVals);
+
+template <typename LinearOperator,
+          typename Array1d,
+          typename Array2d>
+void block_lanczos(const LinearOperator& A,
+                         Array1d& eigVals,
+                         Array2d& eigVecs);
+/* \endcond */
+
+/**
+ * \brief Block Lanczos method
+ *
+ * \tparam LinearOperator is a matrix or subclass of \p linear_operator
+ * \tparam Array1d array of eigenvalues
+ * \tparam Array2d matrix of eigenvectors
+ *
+ * \param A matrix of the linear system
+ * \param eigVals eigenvalues, the size of \p eigVals on input is the
+ * number of eigenpairs to compute
+ * \param eigVecs eigenvectors
+ * \param options Lanczos options
+ *
+ * \par Overview
+ * Computes the extreme eigenpairs of real symmetric linear systems
+ * A x = s x. The Krylov space is grown \p options.blockSize vectors at a
+ * time, so each step applies \p A to a whole block with a single sparse
+ * matrix - dense matrix product and several eigenpairs, including
+ * multiple ones, converge together with far fewer passes over \p A than
+ * \p lanczos needs.
+ *
+ * Every new block is fully reorthogonalized against the basis with two
+ * block projections W - V (V^T W) and orthonormalized with two passes of
+ * Cholesky QR. The projected block tridiagonal matrix is solved on the
+ * host with \p cusp::lapack::syev every \p options.stride vectors once
+ * the basis holds \p options.minIter vectors.
+ *
+ * The basis is not restarted, it grows up to \p options.maxIter vectors
+ * until the residual norms of the wanted Ritz pairs drop below
+ * \p options.tol relative to the largest Ritz value. \p options.blockSize
+ * defaults to min(eigVals.size(), 16), \p options.minIter to twice the
+ * number of eigenpairs requested. The eigenvalues are returned in
+ * ascending order.
+ *
+ * \note \p A must be real and symmetric.
+ *
+ * \par Example
+ *  The following code snippet demonstrates how to use \p block_lanczos to
+ *  compute the 50 smallest eigenpairs of a 2D Laplacian matrix.
+ *
+ *  \code
+ *  #include <cusp/csr_matrix.h>
+ *  #include <cusp/eigen/block_lanczos.h>
+ *  #include <cusp/gallery/poisson.h>
+ *
+ *  int main(void)
+ *  {
+ *      // create an empty sparse matrix structure (CSR format)
+ *      cusp::csr_matrix<int, double, cusp::device_memory> A;
+ *
+ *      // initialize matrix
+ *      cusp::gallery::poisson5pt(A, 100, 100);
+ *
+ *      // allocate storage for 50 eigenpairs
+ *      cusp::array1d<double, cusp::device_memory> eigvals(50, 0);
+ *      cusp::array2d<double, cusp::device_memory, cusp::column_major> eigvecs;
+ *
+ *      // initialize Lanzcos option
+ *      cusp::eigen::lanczos_options<double> options;
+ *      options.tol             = 1e-8;
+ *      options.blockSize       = 16;
+ *      options.eigPart         = cusp::eigen::SA;
+ *      options.computeEigVecs  = true;
+ *
+ *      // compute the smallest eigenpairs of A
+ *      cusp::eigen::block_lanczos(A, eigvals, eigvecs, options);
+ *
+ *      // print smallest eigenvalue
+ *      std::cout << "Smallest eigenvalue : " << eigvals[0] << std::endl;
+ *
+ *      return 0;
+ *  }
+ *  \endcode
+ */
+template <typename LinearOperator,
+          typename Array1d,
+          typename Array2d,
+          typename LanczosOptions>
+void block_lanczos(const LinearOperator& A,
+                         Array1d& eigVals,
+                         Array2d& eigVecs,
+                         LanczosOptions& options);
+
+/*! \}
+ */
+
+} // end namespace eigen
+} // end namespace cusp
+
+#include <cusp/eigen/detail/block_lanczos.inl>
@@ -14,27 +14,117 @@
  *  limitations under the License.
  */
 
-
 #pragma once
 
 #include <cusp/detail/config.h>
 
 #include <cusp/array1d.h>
+#include <cusp/array2d.h>
+#include <cusp/complex.h>
+#include <cusp/copy.h>
+#include <cusp/exception.h>
+#include <cusp/functional.h>
 #include <cusp/multiply.h>
 
 #include <cusp/blas/blas.h>
+#include <cusp/eigen/detail/hessenberg_qr.inl>
+
+#include <thrust/copy.h>
+#include <thrust/transform.h>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
 
 namespace cusp
 {
 namespace eigen
 {
+namespace detail
+{
+
+// extends the Arnoldi factorization A V(:,0:j) = V(:,0:j+1) H(0:j+1,0:j)
+// of the contiguous column-major basis V from j = start to j = end, and
+// returns the number of basis vectors, which is less than end if an
+// invariant subspace was found. Every new vector is orthogonalized twice
+// against the whole basis with a projection and a gemv.
+template <typename Matrix, typename Array2d1, typename Array2d2>
+size_t arnoldi_extend(const Matrix& A, Array2d1& V, Array2d2& H, const size_t start, const size_t end)
+{
+    typedef typename Array2d1::value_type   ValueType;
+    typedef typename Array2d1::memory_space MemorySpace;
+    typedef typename Array2d1::column_view  ColumnView;
+    typedef typename cusp::norm_type<ValueType>::type NormType;
+
+    const size_t N = V.num_rows;
+
+    cusp::array1d<ValueType,MemorySpace> h;
+    cusp::array1d<ValueType,cusp::host_memory> h_host;
+
+    for(size_t j = start; j < end; j++)
+    {
+        ColumnView w(V.column(j + 1));
+
+        cusp::multiply(A, V.column(j), w);
+
+        // the first j + 1 basis vectors
+        typename Array2d1::view Vj(N, j + 1, N, V.values.subarray(0, (j + 1) * N));
+
+        for(size_t pass = 0; pass < 2; pass++)
+        {
+            // h <- V^H w, w <- w - V h
+            cusp::blas::dotcs(w, Vj, h);
+            thrust::transform(h.begin(), h.end(), h.begin(), cusp::conj_functor<ValueType>());
+            cusp::blas::gemv(Vj, h, w, ValueType(-1), ValueType(1));
+
+            h_host = h;
+
+            for(size_t i = 0; i <= j; i++)
+                H(i,j) += h_host[i];
+        }
+
+        NormType beta = cusp::blas::nrm2(w);
+        H(j + 1, j) = beta;
+
+        if(beta < 1e-10) return j + 1;
+
+        cusp::blas::scal(w, ValueType(1) / beta);
+    }
+
+    return end;
+}
+
+// orders Ritz values by decreasing magnitude, with the member of a
+// complex conjugate pair having positive imaginary part first
+struct ritz_magnitude_order
+{
+    const cusp::array1d<double,cusp::host_memory>& wr;
+    const cusp::array1d<double,cusp::host_memory>& wi;
+
+    ritz_magnitude_order(const cusp::array1d<double,cusp::host_memory>& wr,
+                         const cusp::array1d<double,cusp::host_memory>& wi)
+        : wr(wr), wi(wi) {}
+
+    bool operator()(const size_t a, const size_t b) const
+    {
+        const double ma = cusp::abs(cusp::complex<double>(wr[a], wi[a]));
+        const double mb = cusp::abs(cusp::complex<double>(wr[b], wi[b]));
+
+        if(ma != mb) return ma > mb;
+        if(wr[a] != wr[b]) return wr[a] > wr[b];
+        return wi[a] > wi[b];
+    }
+};
+
+} // end namespace detail
 
 template <typename Matrix, typename Array2d>
 void arnoldi(const Matrix& A, Array2d& H, size_t k)
 {
     typedef typename Matrix::value_type   ValueType;
     typedef typename Matrix::memory_space MemorySpace;
-    typedef typename cusp::norm_type<ValueType>::type NormType;
+    typedef cusp::array2d<ValueType,MemorySpace,cusp::column_major> Basis;
+    typedef typename Basis::column_view ColumnView;
 
     size_t N = A.num_rows;
 
@@ -42,46 +132,162 @@ void arnoldi(const Matrix& A, Array2d& H, size_t k)
 
     Array2d H_(maxiter + 1, maxiter, 0);
 
-    // allocate workspace of k + 1 vectors
-    std::vector< cusp::array1d<ValueType,MemorySpace> > V(maxiter + 1);
-    for (size_t i = 0; i < maxiter + 1; i++)
-        V[i].resize(N);
+    // allocate a contiguous basis of k + 1 vectors
+    Basis V(N, maxiter + 1);
+    ColumnView v0(V.column(0));
 
     // initialize starting vector to random values in [0,1)
-    cusp::copy(cusp::random_array<ValueType>(N), V[0]);
+    cusp::copy(cusp::random_array<ValueType>(N), v0);
 
     // normalize v0
-    cusp::blas::scal(V[0], ValueType(1) / cusp::blas::nrm2(V[0]));
+    cusp::blas::scal(v0, ValueType(1) / cusp::blas::nrm2(v0));
+
+    size_t j = detail::arnoldi_extend(A, V, H_, 0, maxiter);
+
+    H.resize(j,j);
+    for( size_t row = 0; row < j; row++ )
+        for( size_t col = 0; col < j; col++ )
+            H(row,col) = H_(row,col);
+}
+
+template <typename Matrix, typename Array1d>
+bool implicitly_restarted_arnoldi(const Matrix& A, Array1d& eigVals, size_t maxBasis, size_t maxRestarts, double tol)
+{
+    typedef typename Matrix::value_type   ValueType;
+    typedef typename Matrix::memory_space MemorySpace;
+    typedef cusp::array2d<ValueType,MemorySpace,cusp::column_major>    Basis;
+    typedef cusp::array2d<double,cusp::host_memory,cusp::column_major> SmallMatrix;
+    typedef typename Basis::column_view ColumnView;
+    typedef typename Array1d::value_type ComplexType;
+
+    const size_t N   = A.num_rows;
+    const size_t nev = eigVals.size();
+    const size_t m   = std::min(maxBasis, N);
+
+    if(nev == 0 || nev + 2 > m)
+        throw cusp::invalid_input_exception("implicitly_restarted_arnoldi: the basis must hold at least two more vectors than the number of eigenvalues requested");
+
+    const double eps23 = std::pow(std::numeric_limits<double>::epsilon(), 2.0 / 3.0);
+
+    // the basis and the restarted block, nev + 1 vectors and the residual
+    Basis V(N, m + 1);
+    Basis T(N, nev + 2);
+    SmallMatrix H(m + 1, m, 0.0);
+    SmallMatrix Q(m, m);
+
+    cusp::array1d<ValueType,MemorySpace> q(m);
+    cusp::array1d<ValueType,cusp::host_memory> q_host(m);
+    cusp::array1d<double,cusp::host_memory> wr;
+    cusp::array1d<double,cusp::host_memory> wi;
+    cusp::array1d<size_t,cusp::host_memory> order;
 
-    NormType beta = 0.0;
+    typename Basis::view Vm(N, m, N, V.values.subarray(0, m * N));
 
-    size_t j;
+    // initialize starting vector to random values in [0,1)
+    ColumnView v0(V.column(0));
+    cusp::copy(cusp::random_array<ValueType>(N), v0);
+    cusp::blas::scal(v0, ValueType(1) / cusp::blas::nrm2(v0));
+
+    size_t len = detail::arnoldi_extend(A, V, H, 0, m);
+    bool converged = false;
 
-    for(j = 0; j < maxiter; j++)
+    for(size_t restart = 0; ; restart++)
     {
-        cusp::multiply(A, V[j], V[j + 1]);
+        // Ritz values of the current factorization, wanted ones first
+        detail::hessenberg_eigenvalues(H, len, wr, wi);
+
+        order.resize(len);
+        for(size_t i = 0; i < len; i++)
+            order[i] = i;
+        std::sort(order.begin(), order.end(), detail::ritz_magnitude_order(wr, wi));
+
+        if(len < nev)
+            throw cusp::runtime_exception("implicitly_restarted_arnoldi: invariant subspace is smaller than the number of eigenvalues requested");
+
+        // the residual of the Ritz pair (theta, V y) is beta |e_m^T y|,
+        // an invariant subspace has zero residuals
+        const double beta = len < m ? 0.0 : H(m, m - 1);
 
-        for(size_t i = 0; i <= j; i++)
+        converged = true;
+
+        for(size_t i = 0; i < nev && converged; i++)
         {
-            H_(i,j) = cusp::blas::dotc(V[i], V[j + 1]);
+            const cusp::complex<double> theta(wr[order[i]], wi[order[i]]);
+            const double residual = beta == 0.0 ? 0.0 : beta * detail::hessenberg_bottom_component(H, len, theta);
 
-            cusp::blas::axpy(V[i], V[j + 1], -H_(i,j));
+            converged = residual <= tol * std::max(cusp::abs(theta), eps23);
         }
 
-        beta = cusp::blas::nrm2(V[j + 1]);
-        H_(j + 1, j) = beta;
+        if(converged || restart == maxRestarts)
+            break;
+
+        // keep complex conjugate pairs together
+        size_t k = nev;
+        if(wi[order[k - 1]] > 0.0)
+            k++;
 
-        if(beta < 1e-10) break;
+        // apply the unwanted Ritz values as exact shifts
+        for(size_t i = 0; i < m; i++)
+            for(size_t j = 0; j < m; j++)
+                Q(i,j) = i == j ? 1.0 : 0.0;
 
-        cusp::blas::scal(V[j + 1], ValueType(1) / H_(j+1,j));
+        for(size_t i = k; i < m; i++)
+        {
+            const double re = wr[order[i]];
+            const double im = wi[order[i]];
+
+            if(im == 0.0)
+                detail::hessenberg_single_shift(H, Q, m, re);
+            else if(im > 0.0)
+                detail::hessenberg_double_shift(H, Q, m, 2.0 * re, re * re + im * im);
+        }
+
+        // V(:,0:k+1) <- V Q(:,0:k+1), the new residual is
+        // V(:,k) H(k,k-1) + beta Q(m-1,k-1) V(:,m)
+        for(size_t i = 0; i <= k; i++)
+        {
+            for(size_t r = 0; r < m; r++)
+                q_host[r] = Q(r,i);
+            q = q_host;
+
+            ColumnView ti(T.column(i));
+            cusp::blas::gemv(Vm, q, ti);
+        }
+
+        ColumnView f(T.column(k));
+        cusp::blas::axpby(f, V.column(m), f, ValueType(H(k, k - 1)), ValueType(beta * Q(m - 1, k - 1)));
+
+        thrust::copy(T.values.begin(), T.values.begin() + k * N, V.values.begin());
+
+        for(size_t i = 0; i <= m; i++)
+            for(size_t j = 0; j < m; j++)
+                if(i >= k || j >= k)
+                    H(i,j) = 0.0;
+
+        const double beta_k = cusp::blas::nrm2(f);
+        H(k, k - 1) = beta_k;
+
+        if(beta_k < 1e-10)
+        {
+            // the first k basis vectors span an invariant subspace
+            len = k;
+            continue;
+        }
+
+        ColumnView vk(V.column(k));
+        cusp::blas::copy(f, vk);
+        cusp::blas::scal(vk, ValueType(1) / ValueType(beta_k));
+
+        len = detail::arnoldi_extend(A, V, H, k, m);
     }
 
-    H.resize(j,j);
-    for( size_t row = 0; row < j; row++ )
-        for( size_t col = 0; col < j; col++ )
-            H(row,col) = H_(row,col);
+    cusp::array1d<ComplexType,cusp::host_memory> vals(nev);
+    for(size_t i = 0; i < nev; i++)
+        vals[i] = ComplexType(wr[order[i]], wi[order[i]]);
+    eigVals = vals;
+
+    return converged;
 }
 
 } // end namespace eigen
 } // end namespace cusp
-
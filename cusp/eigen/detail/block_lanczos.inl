@@ -0,0 +1,399 @@
+/*
+ *  Copyright 2008-2014 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#pragma once
+
+#include <cusp/detail/config.h>
+
+#include <cusp/array1d.h>
+#include <cusp/array2d.h>
+#include <cusp/copy.h>
+#include <cusp/exception.h>
+#include <cusp/functional.h>
+#include <cusp/multiply.h>
+
+#include <cusp/blas/blas.h>
+#include <cusp/lapack/lapack.h>
+
+#include <cusp/detail/temporary_array.h>
+
+#include <cusp/eigen/detail/block_products.inl>
+
+#include <thrust/copy.h>
+#include <thrust/fill.h>
+#include <thrust/for_each.h>
+#include <thrust/reduce.h>
+#include <thrust/tuple.h>
+#include <thrust/iterator/counting_iterator.h>
+#include <thrust/iterator/discard_iterator.h>
+#include <thrust/iterator/transform_iterator.h>
+#include <thrust/iterator/zip_iterator.h>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include <iostream>
+#include <iomanip>
+
+namespace cusp
+{
+namespace eigen
+{
+namespace block_lanczos_detail
+{
+
+// W <- W R^{-1} with W = Q R, applied twice (CholQR2) so that the columns
+// of W are orthonormal to working precision; B <- R_2 R_1 accumulates the
+// triangular factor. Returns false if W is rank deficient.
+template <typename DerivedPolicy, typename Array2d, typename Array1d>
+bool orthonormalize(thrust::execution_policy<DerivedPolicy>& exec,
+                    Array2d& W,
+                    Array2d& T,
+                    Array1d& B)
+{
+    typedef typename Array2d::value_type ValueType;
+    typedef typename Array2d::memory_space MemorySpace;
+
+    const size_t s = W.num_cols;
+
+    cusp::array1d<ValueType, MemorySpace> G;
+    cusp::array1d<ValueType, MemorySpace> C;
+    cusp::array1d<double, cusp::host_memory> G_host;
+    cusp::array1d<double, cusp::host_memory> R(s * s);
+    cusp::array1d<double, cusp::host_memory> Rinv;
+    cusp::array1d<double, cusp::host_memory> Bprev;
+
+    B.resize(s * s);
+    thrust::fill(B.begin(), B.end(), 0.0);
+    for (size_t i = 0; i < s; i++)
+        B[i * s + i] = 1.0;
+
+    for (size_t pass = 0; pass < 2; pass++)
+    {
+        // G <- W^T W
+        detail::block_project(exec, W, s, W, G);
+        G_host = G;
+
+        if (!detail::block_cholesky_upper(G_host, R, s))
+            return false;
+
+        // W <- W R^{-1}
+        detail::block_invert_upper(R, Rinv, s);
+        C = Rinv;
+        detail::block_combine(exec, W, W, s, C, T, ValueType(1), ValueType(0));
+        W.swap(T);
+
+        // B <- R B
+        Bprev = B;
+        for (size_t i = 0; i < s; i++)
+            for (size_t j = 0; j < s; j++)
+            {
+                double t = 0.0;
+                for (size_t k = i; k < s; k++)
+                    t += R[i * s + k] * Bprev[k * s + j];
+                B[i * s + j] = t;
+            }
+    }
+
+    return true;
+}
+
+} // end block_lanczos_detail namespace
+
+template <typename LinearOperator, typename Array1d, typename Array2d, typename LanczosOptions>
+void block_lanczos(const LinearOperator& A, Array1d& eigVals, Array2d& eigVecs, LanczosOptions& options)
+{
+    typedef typename LinearOperator::value_type                          ValueType;
+    typedef typename LinearOperator::memory_space                        MemorySpace;
+    typedef cusp::array2d<ValueType, MemorySpace, cusp::column_major>    Block;
+    typedef cusp::array2d<double, cusp::host_memory, cusp::column_major> SmallMatrix;
+
+    assert(A.num_rows == A.num_cols);        // sanity check
+
+    const size_t N = A.num_rows;
+    const size_t neigWanted = eigVals.size();
+
+    if (neigWanted == 0 || neigWanted > N)
+        throw cusp::invalid_input_exception("block_lanczos: invalid number of eigenpairs requested");
+
+    size_t neigLow = 0, neigHigh = 0;
+
+    if(options.eigPart == cusp::eigen::LA)
+        neigHigh = neigWanted;
+    else if(options.eigPart == cusp::eigen::SA)
+        neigLow = neigWanted;
+    else if(options.eigPart == cusp::eigen::BE)
+    {
+        neigLow = neigWanted / 2;
+        neigHigh = neigWanted - neigLow;
+    }
+    else
+    {
+        throw cusp::runtime_exception("Invalid spectrum part specified!");
+    }
+
+    // setup the default parameters, the basis dimensions are counted in
+    // vectors and rounded down to whole blocks
+    if(options.blockSize == 0)
+        options.blockSize = std::min(neigWanted, size_t(16));
+
+    const size_t b = std::min(options.blockSize, N);
+
+    if(options.minIter == 0)
+        options.minIter = std::max(2 * neigWanted, 4 * b);
+
+    if(options.maxIter == 0)
+        options.maxIter = 500 + options.defaultMaxIterFactor * neigWanted;
+
+    options.minIter = std::min(options.minIter, N);
+    options.maxIter = std::max(std::min(options.maxIter, N), options.minIter);
+
+    if(options.stride == 0)
+        options.stride = 10;
+
+    if(options.tol < 0.0)
+        options.tol = std::sqrt(std::numeric_limits<ValueType>::epsilon());
+
+    if(options.verbose)
+        options.print();
+
+    const size_t maxBasis = std::max(options.maxIter / b, size_t(1)) * b;
+
+    MemorySpace system;
+
+    // the Krylov basis grows by memoryExpansionFactor when it is full
+    size_t capacity = std::min(std::max((options.minIter + b - 1) / b, size_t(2)) * b, maxBasis);
+
+    Block V(N, capacity);
+    Block W(N, b);
+    Block T(N, b);
+
+    cusp::array1d<ValueType, MemorySpace> H;
+    cusp::array1d<double, cusp::host_memory> H_host;
+
+    // diagonal blocks A_j and subdiagonal blocks B_j of the block
+    // tridiagonal projection, b*b row-major entries per step
+    cusp::array1d<double, cusp::host_memory> diagBlocks;
+    cusp::array1d<double, cusp::host_memory> offBlocks;
+    cusp::array1d<double, cusp::host_memory> Bj;
+
+    SmallMatrix S;
+    cusp::array1d<double, cusp::host_memory> ritzVal;
+    cusp::array1d<double, cusp::host_memory> residual;
+
+    // V_0 <- orthonormalized random block
+    cusp::random_array<ValueType> rand(N * b);
+    cusp::copy(rand, W.values);
+
+    if (!block_lanczos_detail::orthonormalize(system, W, T, Bj))
+        throw cusp::runtime_exception("block_lanczos: random starting block is rank deficient");
+
+    thrust::copy(system, W.values.begin(), W.values.end(), V.values.begin());
+
+    size_t p = b;
+    size_t steps = 0;
+    size_t lastCheck = 0;
+    bool converged = false;
+    double maxErr = 0.0;
+
+    while (true)
+    {
+        const size_t j = steps++;
+
+        // W <- A V_j
+        cusp::multiply(A, cusp::make_array2d_view(N, b, N, V.values.subarray(j * b * N, b * N), cusp::column_major()), W);
+
+        // block reorthogonalization against the whole basis, applied twice;
+        // the projections onto V_j accumulate into the diagonal block A_j
+        diagBlocks.resize(steps * b * b, 0.0);
+
+        for (size_t pass = 0; pass < 2; pass++)
+        {
+            // H <- V^T W, W <- W - V H
+            detail::block_project(system, V, p, W, H);
+            detail::block_combine(system, W, V, p, H, W, ValueType(-1), ValueType(1));
+
+            H_host = H;
+
+            for (size_t r = 0; r < b; r++)
+                for (size_t c = 0; c < b; c++)
+                    diagBlocks[j * b * b + r * b + c] += H_host[(j * b + r) * b + c];
+        }
+
+        // W <- V_{j+1} B_j
+        const bool breakdown = !block_lanczos_detail::orthonormalize(system, W, T, Bj);
+
+        offBlocks.resize(steps * b * b, 0.0);
+        if (!breakdown)
+            thrust::copy(Bj.begin(), Bj.end(), offBlocks.begin() + j * b * b);
+
+        const bool exhausted = breakdown || p + b > maxBasis;
+
+        if ((p >= options.minIter && (steps - lastCheck) * b >= options.stride) || exhausted)
+        {
+            lastCheck = steps;
+
+            // assemble the symmetric block tridiagonal projection
+            SmallMatrix Tj(p, p, 0.0);
+
+            for (size_t k = 0; k < steps; k++)
+                for (size_t r = 0; r < b; r++)
+                    for (size_t c = 0; c < b; c++)
+                    {
+                        const double a = 0.5 * (diagBlocks[k * b * b + r * b + c] + diagBlocks[k * b * b + c * b + r]);
+                        Tj(k * b + r, k * b + c) = a;
+
+                        if (k + 1 < steps)
+                        {
+                            Tj((k + 1) * b + r, k * b + c) = offBlocks[k * b * b + r * b + c];
+                            Tj(k * b + c, (k + 1) * b + r) = offBlocks[k * b * b + r * b + c];
+                        }
+                    }
+
+            S.resize(p, p);
+            cusp::lapack::syev(Tj, ritzVal, S);
+
+            // the residual of Ritz pair i is || B_j S(p-b:p, i) ||
+            const double normT = std::max(std::abs(ritzVal[0]), std::abs(ritzVal[p - 1]));
+
+            residual.resize(p);
+            maxErr = 0.0;
+
+            for (size_t i = 0; i < p; i++)
+            {
+                double r2 = 0.0;
+
+                if (!breakdown)
+                {
+                    for (size_t r = 0; r < b; r++)
+                    {
+                        double t = 0.0;
+                        for (size_t c = r; c < b; c++)
+                            t += Bj[r * b + c] * S(p - b + c, i);
+                        r2 += t * t;
+                    }
+                }
+
+                residual[i] = std::sqrt(r2);
+
+                if (i < neigLow || i >= p - neigHigh)
+                    maxErr = std::max(maxErr, residual[i] / normT);
+            }
+
+            if(options.verbose)
+                std::cout << "Block Lanczos : basis " << std::setw(6) << p
+                          << ", max relative residual " << std::scientific << maxErr << std::endl;
+
+            converged = p >= neigWanted && maxErr <= options.tol;
+
+            if (converged || exhausted)
+                break;
+        }
+
+        // grow the basis and append V_{j+1}
+        if (p + b > capacity)
+        {
+            capacity = std::min(std::max(size_t(capacity * options.memoryExpansionFactor) / b * b, capacity + b), maxBasis);
+
+            Block Vnew(N, capacity);
+            thrust::copy(system, V.values.begin(), V.values.begin() + p * N, Vnew.values.begin());
+            V.swap(Vnew);
+        }
+
+        thrust::copy(system, W.values.begin(), W.values.end(), V.values.begin() + p * N);
+        p += b;
+    }
+
+    if (p < neigWanted)
+        throw cusp::runtime_exception("block_lanczos: Krylov space is smaller than the number of eigenpairs requested");
+
+    // select the wanted Ritz pairs, lowest first
+    cusp::array1d<size_t, cusp::host_memory> wanted(neigWanted);
+
+    for (size_t i = 0; i < neigLow; i++)
+        wanted[i] = i;
+    for (size_t i = 0; i < neigHigh; i++)
+        wanted[neigLow + i] = p - neigHigh + i;
+
+    cusp::array1d<ValueType, cusp::host_memory> vals(neigWanted);
+    for (size_t i = 0; i < neigWanted; i++)
+        vals[i] = ritzVal[wanted[i]];
+    eigVals = vals;
+
+    if(options.computeEigVecs)
+    {
+        // eigVecs <- V S(:, wanted)
+        cusp::array1d<ValueType, cusp::host_memory> C_host(p * neigWanted);
+        for (size_t r = 0; r < p; r++)
+            for (size_t i = 0; i < neigWanted; i++)
+                C_host[r * neigWanted + i] = S(r, wanted[i]);
+
+        cusp::array1d<ValueType, MemorySpace> C(C_host);
+        Block E(N, neigWanted, ValueType(0));
+
+        detail::block_combine(system, E, V, p, C, E, ValueType(1), ValueType(0));
+
+        eigVecs = E;
+    }
+
+    if(options.verbose)
+    {
+        std::cout << std::endl;
+        std::cout << "Max relative residual : " << maxErr << std::endl;
+        std::cout << "Eigenvalues : " << std::endl;
+        std::cout << std::scientific << std::setprecision(7);
+
+        std::cout << "eig id     eigenvalues      residual norm" << std::endl;
+        for(size_t i = 0; i < neigWanted; i++)
+            std::cout << std::setw(6) << i << std::setw(17) << vals[i]
+                      << std::setw(17) << residual[wanted[i]] << std::endl;
+        std::cout.unsetf(std::ios::floatfield);
+
+        std::cout << std::endl;
+        std::cout << "Block Size          : " << b << std::endl;
+        std::cout << "Block Step Count    : " << steps << std::endl;
+        std::cout << "Basis Dimension     : " << p << std::endl;
+        std::cout << "Converged           : " << (converged ? "yes" : "no") << std::endl;
+        std::cout << std::endl;
+    }
+}
+
+template <typename LinearOperator, typename Array1d, typename Array2d>
+void block_lanczos(const LinearOperator& A, Array1d& eigVals, Array2d& eigVecs)
+{
+    typedef typename LinearOperator::value_type   ValueType;
+
+    cusp::eigen::lanczos_options<ValueType> options;
+    options.computeEigVecs = true;
+
+    cusp::eigen::block_lanczos(A, eigVals, eigVecs, options);
+}
+
+template <typename LinearOperator, typename Array1d>
+void block_lanczos(const LinearOperator& A, Array1d& eigVals)
+{
+    typedef typename LinearOperator::value_type   ValueType;
+    typedef typename LinearOperator::memory_space MemorySpace;
+
+    cusp::eigen::lanczos_options<ValueType> options;
+    cusp::array2d<ValueType,MemorySpace,cusp::column_major> eigVecs;
+
+    cusp::eigen::block_lanczos(A, eigVals, eigVecs, options);
+}
+
+} // end namespace eigen
+} // end namespace cusp
@@ -0,0 +1,212 @@
+/*
+ *  Copyright 2008-2014 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#pragma once
+
+#include <cusp/detail/config.h>
+
+#include <cusp/functional.h>
+
+#include <thrust/fill.h>
+#include <thrust/for_each.h>
+#include <thrust/reduce.h>
+#include <thrust/tuple.h>
+#include <thrust/iterator/counting_iterator.h>
+#include <thrust/iterator/discard_iterator.h>
+#include <thrust/iterator/transform_iterator.h>
+#include <thrust/iterator/zip_iterator.h>
+
+#include <cmath>
+
+namespace cusp
+{
+namespace eigen
+{
+namespace detail
+{
+
+// All blocks are stored column-major with N rows, so column j of a block
+// starts at offset j * N of its values. Small coefficient matrices are
+// stored row-major.
+
+// H(i,j) <- <V(:,i), W(:,j)>, one term per entry of [0, p*s*N)
+template <typename ValueType>
+struct block_project_functor
+{
+    const ValueType* V;
+    const ValueType* W;
+    size_t N;
+    size_t s;
+
+    block_project_functor(const ValueType* V, const ValueType* W, size_t N, size_t s)
+        : V(V), W(W), N(N), s(s) {}
+
+    __host__ __device__
+    ValueType operator()(const size_t n) const
+    {
+        const size_t pair = n / N;
+        const size_t k    = n % N;
+
+        return V[(pair / s) * N + k] * W[(pair % s) * N + k];
+    }
+};
+
+// Z(k,j) <- beta * Y(k,j) + alpha * sum_i V(k,i) * C(i,j)
+template <typename ValueType>
+struct block_combine_functor
+{
+    const ValueType* V;
+    const ValueType* C;
+    size_t N;
+    size_t p;
+    size_t s;
+    ValueType alpha;
+    ValueType beta;
+
+    block_combine_functor(const ValueType* V, const ValueType* C, size_t N, size_t p, size_t s,
+                    ValueType alpha, ValueType beta)
+        : V(V), C(C), N(N), p(p), s(s), alpha(alpha), beta(beta) {}
+
+    template <typename Tuple>
+    __host__ __device__
+    void operator()(Tuple t) const
+    {
+        const size_t n = thrust::get<2>(t);
+        const size_t k = n % N;
+        const size_t j = n / N;
+
+        ValueType sum(0);
+
+        for (size_t i = 0; i < p; i++)
+            sum += V[i * N + k] * C[i * s + j];
+
+        if (beta == ValueType(0))
+            thrust::get<1>(t) = alpha * sum;
+        else
+            thrust::get<1>(t) = beta * thrust::get<0>(t) + alpha * sum;
+    }
+};
+
+// H <- V(:,0:p)^T W, left in the memory space of the policy
+template <typename DerivedPolicy, typename Array2d1, typename Array2d2, typename Array1d>
+void block_project(thrust::execution_policy<DerivedPolicy>& exec,
+                   const Array2d1& V,
+                   const size_t p,
+                   const Array2d2& W,
+                         Array1d& H)
+{
+    typedef typename Array2d1::value_type ValueType;
+
+    const size_t N = W.num_rows;
+    const size_t s = W.num_cols;
+
+    H.resize(p * s);
+
+    thrust::reduce_by_key(exec,
+                          thrust::make_transform_iterator(thrust::counting_iterator<size_t>(0), cusp::divide_value<size_t>(N)),
+                          thrust::make_transform_iterator(thrust::counting_iterator<size_t>(p * s * N), cusp::divide_value<size_t>(N)),
+                          thrust::make_transform_iterator(thrust::counting_iterator<size_t>(0),
+                                                          block_project_functor<ValueType>(thrust::raw_pointer_cast(&V.values[0]),
+                                                                                           thrust::raw_pointer_cast(&W.values[0]), N, s)),
+                          thrust::make_discard_iterator(),
+                          H.begin());
+}
+
+// Z <- beta * Y + alpha * V(:,0:p) C with a row-major p-by-s matrix C
+// resident in the memory space of the policy; Y may alias Z and is not
+// read when beta is zero
+template <typename DerivedPolicy, typename Array2d1, typename Array2d2, typename Array1d, typename Array2d3>
+void block_combine(thrust::execution_policy<DerivedPolicy>& exec,
+                   const Array2d1& Y,
+                   const Array2d2& V,
+                   const size_t p,
+                   const Array1d& C,
+                         Array2d3& Z,
+                   const typename Array2d1::value_type alpha,
+                   const typename Array2d1::value_type beta)
+{
+    typedef typename Array2d1::value_type ValueType;
+
+    const size_t N = Z.num_rows;
+    const size_t s = Z.num_cols;
+
+    thrust::for_each(exec,
+                     thrust::make_zip_iterator(thrust::make_tuple(Y.values.begin(), Z.values.begin(), thrust::counting_iterator<size_t>(0))),
+                     thrust::make_zip_iterator(thrust::make_tuple(Y.values.begin(), Z.values.begin(), thrust::counting_iterator<size_t>(0))) + N * s,
+                     block_combine_functor<ValueType>(thrust::raw_pointer_cast(&V.values[0]),
+                                                      thrust::raw_pointer_cast(&C[0]), N, p, s, alpha, beta));
+}
+
+// G = R^T R for the s-by-s Gram matrix G, stored row-major on the host;
+// returns false if G is not numerically positive definite
+template <typename Array1d>
+bool block_cholesky_upper(const Array1d& G, Array1d& R, const size_t s)
+{
+    R.resize(s * s);
+    thrust::fill(R.begin(), R.end(), 0.0);
+
+    for (size_t i = 0; i < s; i++)
+    {
+        double d = G[i * s + i];
+
+        for (size_t k = 0; k < i; k++)
+            d -= R[k * s + i] * R[k * s + i];
+
+        if (!(d > 0.0))
+            return false;
+
+        R[i * s + i] = std::sqrt(d);
+
+        for (size_t j = i + 1; j < s; j++)
+        {
+            double t = 0.5 * (G[i * s + j] + G[j * s + i]);
+
+            for (size_t k = 0; k < i; k++)
+                t -= R[k * s + i] * R[k * s + j];
+
+            R[i * s + j] = t / R[i * s + i];
+        }
+    }
+
+    return true;
+}
+
+// Rinv <- R^{-1} for an upper triangular row-major R
+template <typename Array1d>
+void block_invert_upper(const Array1d& R, Array1d& Rinv, const size_t s)
+{
+    Rinv.resize(s * s);
+    thrust::fill(Rinv.begin(), Rinv.end(), 0.0);
+
+    for (size_t j = 0; j < s; j++)
+    {
+        Rinv[j * s + j] = 1.0 / R[j * s + j];
+
+        for (size_t i = j; i-- > 0;)
+        {
+            double t = 0.0;
+
+            for (size_t k = i + 1; k <= j; k++)
+                t += R[i * s + k] * Rinv[k * s + j];
+
+            Rinv[i * s + j] = -t / R[i * s + i];
+        }
+    }
+}
+
+} // end detail namespace
+} // end eigen namespace
+} // end cusp namespace
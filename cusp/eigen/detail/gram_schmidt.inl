@@ -19,6 +19,7 @@
 #include <cusp/detail/config.h>
 
 #include <cusp/array1d.h>
+#include <cusp/array2d.h>
 #include <cusp/blas/blas.h>
 
 #include <limits>
@@ -67,10 +68,33 @@ void modifiedGramSchmidt(const Array2d& Q, Array1d& v,
     }
 }
 
+// v <- v - Q(:,first:last) Q(:,first:last)^T v, with the projections
+// computed in a single pass and left in the memory space of Q
+template<typename Array2d, typename Array1d1, typename Array1d2>
+void classicalGramSchmidt(const Array2d& Q, Array1d1& v, Array1d2& projections,
+                          const size_t first, const size_t last)
+{
+    typedef typename Array2d::value_type ValueType;
+
+    if(first >= last)
+        return;
+
+    typename Array2d::const_view Q_range =
+        cusp::make_array2d_view(Q.num_rows, last - first, Q.pitch,
+                                cusp::make_array1d_view(Q.values.begin() + first * Q.pitch,
+                                                        Q.values.begin() + last  * Q.pitch),
+                                cusp::column_major());
+
+    cusp::blas::dots(v, Q_range, projections);
+    cusp::blas::gemv(Q_range, projections, v, ValueType(-1), ValueType(1));
+}
+
 template<typename ValueType, typename MemorySpace1, typename MemorySpace2>
 void modifiedGramSchmidt(cusp::array2d<ValueType,MemorySpace1,cusp::column_major>& Q,
                          cusp::array2d<ValueType,MemorySpace2>& R)
 {
+    cusp::array1d<ValueType,cusp::host_memory> projections;
+
     for(size_t i = 0; i < Q.num_cols; i++)
     {
         R(i,i) = cusp::blas::nrm2(Q.column(i));
@@ -80,9 +104,17 @@ void modifiedGramSchmidt(cusp::array2d<ValueType,MemorySpace1,cusp::column_major
 
         cusp::blas::scal(Q.column(i), 1.0/R(i,i));
 
+        // the projections of the remaining columns onto column i do not
+        // depend on each other, so they are computed in a single pass
+        cusp::blas::dots(Q.column(i),
+                         cusp::make_array2d_view(Q.num_rows, Q.num_cols - i - 1, Q.pitch,
+                                                 cusp::make_array1d_view(Q.values.begin() + (i+1) * Q.pitch, Q.values.end()),
+                                                 cusp::column_major()),
+                         projections);
+
         for(size_t j = i+1; j < Q.num_cols; j++)
         {
-            R(i,j) = cusp::blas::dot(Q.column(i), Q.column(j));
+            R(i,j) = projections[j - i - 1];
             cusp::blas::axpy(Q.column(i), Q.column(j), -R(i,j));
         }
     }
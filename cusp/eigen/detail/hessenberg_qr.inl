@@ -0,0 +1,529 @@
+/*
+ *  Copyright 2008-2014 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#pragma once
+
+#include <cusp/detail/config.h>
+
+#include <cusp/array1d.h>
+#include <cusp/array2d.h>
+#include <cusp/complex.h>
+#include <cusp/exception.h>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+// Host routines on small real upper Hessenberg matrices used by the
+// implicitly restarted Arnoldi method.
+
+namespace cusp
+{
+namespace eigen
+{
+namespace detail
+{
+
+inline double hessenberg_sign(const double a, const double b)
+{
+    return b >= 0.0 ? std::abs(a) : -std::abs(a);
+}
+
+// eigenvalues wr + i wi of the leading n-by-n block of the upper Hessenberg
+// matrix H using the Francis double shift QR algorithm (EISPACK hqr)
+template <typename Array2d, typename Array1d>
+void hessenberg_eigenvalues(const Array2d& H, const size_t n, Array1d& wr, Array1d& wi)
+{
+    cusp::array2d<double, cusp::host_memory> a(n, n);
+
+    double anorm = 0.0;
+    for (size_t i = 0; i < n; i++)
+        for (size_t j = 0; j < n; j++)
+        {
+            a(i,j) = (i <= j + 1) ? double(H(i,j)) : 0.0;
+            anorm += std::abs(a(i,j));
+        }
+
+    wr.resize(n);
+    wi.resize(n);
+
+    int nn = int(n) - 1;
+    double t = 0.0;
+
+    while (nn >= 0)
+    {
+        int its = 0;
+        int l;
+
+        do
+        {
+            // look for a single small subdiagonal element
+            for (l = nn; l >= 1; l--)
+            {
+                double s = std::abs(a(l-1,l-1)) + std::abs(a(l,l));
+                if (s == 0.0) s = anorm;
+                if (std::abs(a(l,l-1)) + s == s)
+                {
+                    a(l,l-1) = 0.0;
+                    break;
+                }
+            }
+
+            double x = a(nn,nn);
+
+            if (l == nn)
+            {
+                // one root found
+                wr[nn] = x + t;
+                wi[nn] = 0.0;
+                nn--;
+            }
+            else
+            {
+                double y = a(nn-1,nn-1);
+                double w = a(nn,nn-1) * a(nn-1,nn);
+
+                if (l == nn - 1)
+                {
+                    // two roots found
+                    double p = 0.5 * (y - x);
+                    double q = p * p + w;
+                    double z = std::sqrt(std::abs(q));
+
+                    x += t;
+
+                    if (q >= 0.0)
+                    {
+                        z = p + hessenberg_sign(z, p);
+                        wr[nn-1] = wr[nn] = x + z;
+                        if (z != 0.0) wr[nn] = x - w / z;
+                        wi[nn-1] = wi[nn] = 0.0;
+                    }
+                    else
+                    {
+                        wr[nn-1] = wr[nn] = x + p;
+                        wi[nn-1] = -z;
+                        wi[nn]   =  z;
+                    }
+
+                    nn -= 2;
+                }
+                else
+                {
+                    if (its == 60)
+                        throw cusp::runtime_exception("hessenberg_eigenvalues: QR iteration did not converge");
+
+                    // exceptional shift
+                    if (its == 10 || its == 20 || its == 40)
+                    {
+                        t += x;
+                        for (int i = 0; i <= nn; i++)
+                            a(i,i) -= x;
+                        double s = std::abs(a(nn,nn-1)) + std::abs(a(nn-1,nn-2));
+                        y = x = 0.75 * s;
+                        w = -0.4375 * s * s;
+                    }
+
+                    ++its;
+
+                    // look for two consecutive small subdiagonal elements
+                    int m;
+                    double p = 0.0, q = 0.0, r = 0.0, z;
+
+                    for (m = nn - 2; m >= l; m--)
+                    {
+                        z = a(m,m);
+                        r = x - z;
+                        double s = y - z;
+                        p = (r * s - w) / a(m+1,m) + a(m,m+1);
+                        q = a(m+1,m+1) - z - r - s;
+                        r = a(m+2,m+1);
+                        s = std::abs(p) + std::abs(q) + std::abs(r);
+                        p /= s;
+                        q /= s;
+                        r /= s;
+
+                        if (m == l) break;
+
+                        double u = std::abs(a(m,m-1)) * (std::abs(q) + std::abs(r));
+                        double v = std::abs(p) * (std::abs(a(m-1,m-1)) + std::abs(z) + std::abs(a(m+1,m+1)));
+                        if (u + v == v) break;
+                    }
+
+                    for (int i = m + 2; i <= nn; i++)
+                    {
+                        a(i,i-2) = 0.0;
+                        if (i != m + 2) a(i,i-3) = 0.0;
+                    }
+
+                    // double QR step on rows l to nn and columns m to nn
+                    for (int k = m; k <= nn - 1; k++)
+                    {
+                        if (k != m)
+                        {
+                            p = a(k,k-1);
+                            q = a(k+1,k-1);
+                            r = 0.0;
+                            if (k != nn - 1) r = a(k+2,k-1);
+                            if ((x = std::abs(p) + std::abs(q) + std::abs(r)) != 0.0)
+                            {
+                                p /= x;
+                                q /= x;
+                                r /= x;
+                            }
+                        }
+
+                        double s = hessenberg_sign(std::sqrt(p * p + q * q + r * r), p);
+
+                        if (s != 0.0)
+                        {
+                            if (k == m)
+                            {
+                                if (l != m) a(k,k-1) = -a(k,k-1);
+                            }
+                            else
+                            {
+                                a(k,k-1) = -s * x;
+                            }
+
+                            p += s;
+                            x = p / s;
+                            y = q / s;
+                            z = r / s;
+                            q /= p;
+                            r /= p;
+
+                            for (int j = k; j <= nn; j++)
+                            {
+                                p = a(k,j) + q * a(k+1,j);
+                                if (k != nn - 1)
+                                {
+                                    p += r * a(k+2,j);
+                                    a(k+2,j) -= p * z;
+                                }
+                                a(k+1,j) -= p * y;
+                                a(k,j) -= p * x;
+                            }
+
+                            int mmin = nn < k + 3 ? nn : k + 3;
+
+                            for (int i = l; i <= mmin; i++)
+                            {
+                                p = x * a(i,k) + y * a(i,k+1);
+                                if (k != nn - 1)
+                                {
+                                    p += z * a(i,k+2);
+                                    a(i,k+2) -= p * r;
+                                }
+                                a(i,k+1) -= p * q;
+                                a(i,k) -= p;
+                            }
+                        }
+                    }
+                }
+            }
+        } while (l < nn - 1);
+    }
+}
+
+// H <- G^T H G and Q <- Q G for the rotation G acting on columns k and k+1,
+// where G^T zeroes b in the pair (a,b)
+template <typename Array2d1, typename Array2d2>
+void hessenberg_rotate(Array2d1& H, Array2d2& Q, const size_t n, const size_t k,
+                       const double a, const double b, const size_t first_col)
+{
+    const double r = std::sqrt(a * a + b * b);
+
+    if (r == 0.0)
+        return;
+
+    const double c = a / r;
+    const double s = b / r;
+
+    for (size_t j = first_col; j < n; j++)
+    {
+        const double h0 = H(k,j);
+        const double h1 = H(k+1,j);
+        H(k,j)   =  c * h0 + s * h1;
+        H(k+1,j) = -s * h0 + c * h1;
+    }
+
+    for (size_t i = 0; i < std::min(k + 3, n); i++)
+    {
+        const double h0 = H(i,k);
+        const double h1 = H(i,k+1);
+        H(i,k)   =  c * h0 + s * h1;
+        H(i,k+1) = -s * h0 + c * h1;
+    }
+
+    for (size_t i = 0; i < Q.num_rows; i++)
+    {
+        const double q0 = Q(i,k);
+        const double q1 = Q(i,k+1);
+        Q(i,k)   =  c * q0 + s * q1;
+        Q(i,k+1) = -s * q0 + c * q1;
+    }
+}
+
+// H <- P H P and Q <- Q P for the Householder reflector P acting on
+// rows and columns k, k+1 and k+2 that maps (x,y,z) onto the first axis
+template <typename Array2d1, typename Array2d2>
+void hessenberg_reflect(Array2d1& H, Array2d2& Q, const size_t n, const size_t k,
+                        const double x, const double y, const double z, const size_t first_col)
+{
+    const double norm = std::sqrt(x * x + y * y + z * z);
+
+    if (norm == 0.0)
+        return;
+
+    const double v0 = x + hessenberg_sign(norm, x);
+    const double v1 = y;
+    const double v2 = z;
+    const double beta = 2.0 / (v0 * v0 + v1 * v1 + v2 * v2);
+
+    for (size_t j = first_col; j < n; j++)
+    {
+        const double d = beta * (v0 * H(k,j) + v1 * H(k+1,j) + v2 * H(k+2,j));
+        H(k,j)   -= d * v0;
+        H(k+1,j) -= d * v1;
+        H(k+2,j) -= d * v2;
+    }
+
+    for (size_t i = 0; i < std::min(k + 4, n); i++)
+    {
+        const double d = beta * (v0 * H(i,k) + v1 * H(i,k+1) + v2 * H(i,k+2));
+        H(i,k)   -= d * v0;
+        H(i,k+1) -= d * v1;
+        H(i,k+2) -= d * v2;
+    }
+
+    for (size_t i = 0; i < Q.num_rows; i++)
+    {
+        const double d = beta * (v0 * Q(i,k) + v1 * Q(i,k+1) + v2 * Q(i,k+2));
+        Q(i,k)   -= d * v0;
+        Q(i,k+1) -= d * v1;
+        Q(i,k+2) -= d * v2;
+    }
+}
+
+// one implicit QR step with the real shift mu on the leading n-by-n block
+// of H, accumulating the orthogonal transformation into Q
+template <typename Array2d1, typename Array2d2>
+void hessenberg_single_shift(Array2d1& H, Array2d2& Q, const size_t n, const double mu)
+{
+    if (n < 2)
+        return;
+
+    double a = H(0,0) - mu;
+    double b = H(1,0);
+
+    for (size_t k = 0; k + 1 < n; k++)
+    {
+        hessenberg_rotate(H, Q, n, k, a, b, k == 0 ? 0 : k - 1);
+
+        if (k + 2 < n)
+        {
+            // chase the bulge at (k+2,k)
+            a = H(k+1,k);
+            b = H(k+2,k);
+        }
+    }
+
+    for (size_t i = 2; i < n; i++)
+        for (size_t j = 0; j + 1 < i; j++)
+            H(i,j) = 0.0;
+}
+
+// one implicit Francis double shift QR step with the shifts mu and conj(mu),
+// given as s = 2 Re(mu) and t = |mu|^2, on the leading n-by-n block of H
+template <typename Array2d1, typename Array2d2>
+void hessenberg_double_shift(Array2d1& H, Array2d2& Q, const size_t n, const double s, const double t)
+{
+    if (n < 3)
+        return;
+
+    double x = H(0,0) * H(0,0) + H(0,1) * H(1,0) - s * H(0,0) + t;
+    double y = H(1,0) * (H(0,0) + H(1,1) - s);
+    double z = H(1,0) * H(2,1);
+
+    for (size_t k = 0; k + 2 < n; k++)
+    {
+        hessenberg_reflect(H, Q, n, k, x, y, z, k == 0 ? 0 : k - 1);
+
+        x = H(k+1,k);
+        y = H(k+2,k);
+        z = (k + 3 < n) ? H(k+3,k) : 0.0;
+    }
+
+    hessenberg_rotate(H, Q, n, n - 2, x, y, n - 3);
+
+    for (size_t i = 2; i < n; i++)
+        for (size_t j = 0; j + 1 < i; j++)
+            H(i,j) = 0.0;
+}
+
+// |e_n^T y| for the unit eigenvector y of the leading n-by-n block of H
+// belonging to the eigenvalue theta, computed by inverse iteration
+template <typename Array2d>
+double hessenberg_bottom_component(const Array2d& H, const size_t n, const cusp::complex<double> theta)
+{
+    typedef cusp::complex<double> Complex;
+
+    double hnorm = 0.0;
+    for (size_t i = 0; i < n; i++)
+        for (size_t j = 0; j < n; j++)
+            hnorm = std::max(hnorm, std::abs(double(H(i,j))));
+
+    const double tiny = std::numeric_limits<double>::epsilon() * std::max(hnorm, 1.0);
+
+    cusp::array2d<Complex, cusp::host_memory> LU(n, n);
+    cusp::array1d<size_t, cusp::host_memory> pivot(n);
+    cusp::array1d<Complex, cusp::host_memory> y(n, Complex(1.0));
+
+    for (size_t i = 0; i < n; i++)
+        for (size_t j = 0; j < n; j++)
+            LU(i,j) = Complex((i <= j + 1) ? double(H(i,j)) : 0.0) - (i == j ? theta : Complex(0.0));
+
+    // LU factorization with partial pivoting, a zero pivot is replaced by
+    // a tiny perturbation as the shift is an eigenvalue of H
+    for (size_t k = 0; k < n; k++)
+    {
+        size_t p = k;
+        for (size_t i = k + 1; i < n; i++)
+            if (cusp::abs(LU(i,k)) > cusp::abs(LU(p,k)))
+                p = i;
+
+        pivot[k] = p;
+
+        if (p != k)
+            for (size_t j = 0; j < n; j++)
+                std::swap(LU(k,j), LU(p,j));
+
+        if (cusp::abs(LU(k,k)) < tiny)
+            LU(k,k) = Complex(tiny);
+
+        for (size_t i = k + 1; i < n; i++)
+        {
+            LU(i,k) /= LU(k,k);
+            for (size_t j = k + 1; j < n; j++)
+                LU(i,j) -= LU(i,k) * LU(k,j);
+        }
+    }
+
+    for (size_t iter = 0; iter < 2; iter++)
+    {
+        for (size_t k = 0; k < n; k++)
+        {
+            std::swap(y[k], y[pivot[k]]);
+            for (size_t i = k + 1; i < n; i++)
+                y[i] -= LU(i,k) * y[k];
+        }
+
+        for (size_t k = n; k-- > 0;)
+        {
+            for (size_t j = k + 1; j < n; j++)
+                y[k] -= LU(k,j) * y[j];
+            y[k] /= LU(k,k);
+        }
+
+        double norm = 0.0;
+        for (size_t i = 0; i < n; i++)
+            norm += cusp::abs(y[i]) * cusp::abs(y[i]);
+        norm = std::sqrt(norm);
+
+        for (size_t i = 0; i < n; i++)
+            y[i] /= norm;
+    }
+
+    return cusp::abs(y[n - 1]);
+}
+
+// unit eigenvector y of the leading n-by-n block of H belonging to the
+// real eigenvalue theta, computed by inverse iteration
+template <typename Array2d, typename Array1d>
+void hessenberg_eigenvector(const Array2d& H, const size_t n, const double theta, Array1d& y)
+{
+    double hnorm = 0.0;
+    for (size_t i = 0; i < n; i++)
+        for (size_t j = 0; j < n; j++)
+            hnorm = std::max(hnorm, std::abs(double(H(i,j))));
+
+    const double tiny = std::numeric_limits<double>::epsilon() * std::max(hnorm, 1.0);
+
+    cusp::array2d<double, cusp::host_memory> LU(n, n);
+    cusp::array1d<size_t, cusp::host_memory> pivot(n);
+
+    y.resize(n);
+    for (size_t i = 0; i < n; i++)
+        y[i] = 1.0;
+
+    for (size_t i = 0; i < n; i++)
+        for (size_t j = 0; j < n; j++)
+            LU(i,j) = ((i <= j + 1) ? double(H(i,j)) : 0.0) - (i == j ? theta : 0.0);
+
+    for (size_t k = 0; k < n; k++)
+    {
+        size_t p = k;
+        for (size_t i = k + 1; i < n; i++)
+            if (std::abs(LU(i,k)) > std::abs(LU(p,k)))
+                p = i;
+
+        pivot[k] = p;
+
+        if (p != k)
+            for (size_t j = 0; j < n; j++)
+                std::swap(LU(k,j), LU(p,j));
+
+        if (std::abs(LU(k,k)) < tiny)
+            LU(k,k) = tiny;
+
+        for (size_t i = k + 1; i < n; i++)
+        {
+            LU(i,k) /= LU(k,k);
+            for (size_t j = k + 1; j < n; j++)
+                LU(i,j) -= LU(i,k) * LU(k,j);
+        }
+    }
+
+    for (size_t iter = 0; iter < 2; iter++)
+    {
+        for (size_t k = 0; k < n; k++)
+        {
+            std::swap(y[k], y[pivot[k]]);
+            for (size_t i = k + 1; i < n; i++)
+                y[i] -= LU(i,k) * y[k];
+        }
+
+        for (size_t k = n; k-- > 0;)
+        {
+            for (size_t j = k + 1; j < n; j++)
+                y[k] -= LU(k,j) * y[j];
+            y[k] /= LU(k,k);
+        }
+
+        double norm = 0.0;
+        for (size_t i = 0; i < n; i++)
+            norm += y[i] * y[i];
+        norm = std::sqrt(norm);
+
+        for (size_t i = 0; i < n; i++)
+            y[i] /= norm;
+    }
+}
+
+} // end namespace detail
+} // end namespace eigen
+} // end namespace cusp
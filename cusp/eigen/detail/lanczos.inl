@@ -30,6 +30,8 @@
 #include <cusp/eigen/detail/gram_schmidt.inl>
 
 #include <algorithm>
+#include <utility>
+#include <vector>
 
 #include <iostream>
 #include <iomanip>
@@ -38,6 +40,74 @@ namespace cusp
 {
 namespace eigen
 {
+namespace detail
+{
+
+// Simon's omega recurrence: given the estimates omega(k) ~ v_j^T v_k and
+// omega_old(k) ~ v_{j-1}^T v_k, overwrite them with the estimates for
+// v_{j+1} and v_j, where beta_j is the norm of the new vector before
+// normalization. The recurrence follows from the three-term recurrence
+// of the Lanczos vectors, and eps1 models the rounding of one step.
+template <typename Array1d1, typename Array1d2>
+void updateOmega(const Array1d1& alphas, const Array1d1& betas,
+                 Array1d2& omega, Array1d2& omega_old,
+                 const size_t j, const double eps1)
+{
+    Array1d2 omega_new(j + 2);
+
+    for(size_t k = 0; k < j; k++)
+    {
+        double t = betas[k] * omega[k + 1] + (alphas[k] - alphas[j]) * omega[k];
+
+        if(k > 0)
+            t += betas[k - 1] * omega[k - 1];
+        if(j > 0)
+            t -= betas[j - 1] * omega_old[k];
+
+        t = (betas[j] > 0.0) ? t / betas[j] : 1.0;
+
+        omega_new[k] = t + (t < 0.0 ? -eps1 : eps1);
+    }
+
+    omega_new[j]     = eps1;
+    omega_new[j + 1] = 1.0;
+
+    omega_old.swap(omega);
+    omega.swap(omega_new);
+}
+
+// the columns [first, last) of the basis to reorthogonalize against: every
+// estimate above delta together with its neighbours above eta
+template <typename Array1d>
+void orthogonalityIntervals(const Array1d& omega, const size_t num_cols,
+                            const double delta, const double eta,
+                            std::vector< std::pair<size_t,size_t> >& intervals)
+{
+    intervals.clear();
+
+    for(size_t k = 0; k < num_cols; k++)
+    {
+        if(std::abs(omega[k]) <= delta)
+            continue;
+
+        size_t first = k;
+        size_t last  = k + 1;
+
+        while(first > 0 && std::abs(omega[first - 1]) > eta)
+            first--;
+        while(last < num_cols && std::abs(omega[last]) > eta)
+            last++;
+
+        if(!intervals.empty() && first <= intervals.back().second)
+            intervals.back().second = last;
+        else
+            intervals.push_back(std::make_pair(first, last));
+
+        k = last;
+    }
+}
+
+} // end namespace detail
 
 template <typename Matrix, typename Array1d, typename Array2d, typename LanczosOptions>
 void lanczos(const Matrix& A, Array1d& eigVals, Array2d& eigVecs, LanczosOptions& options)
@@ -131,6 +201,11 @@ void lanczos(const Matrix& A, Array1d& eigVals, Array2d& eigVecs, LanczosOptions
 
     cusp::array1d<bool,cusp::host_memory> flag;
 
+    // orthogonality estimates of partial reorthogonalization
+    std::vector<double> omega(1, 1.0), omega_old;
+    std::vector< std::pair<size_t,size_t> > intervals;
+    bool reorthNext = false;
+
     // allocate device workspace
     cusp::array1d<ValueType,MemorySpace> v0(N, 0);
     cusp::array1d<ValueType,MemorySpace> v1(N);
@@ -141,6 +216,7 @@ void lanczos(const Matrix& A, Array1d& eigVals, Array2d& eigVecs, LanczosOptions
     cusp::blas::scal(v1, 1.0/cusp::blas::nrm2(v1));
 
     cusp::array2d<ValueType,MemorySpace,cusp::column_major> V;
+    cusp::array1d<ValueType,MemorySpace> projections;
 
     if(!options.reorth==None)
         V.resize(N, options.minIter);
@@ -164,11 +240,11 @@ void lanczos(const Matrix& A, Array1d& eigVals, Array2d& eigVecs, LanczosOptions
             alphas.resize(memorySize);
             betas.resize(memorySize);
 
-            if(options.reorth==Full)
+            if(options.reorth != None)
                 V.resize(N, memorySize);
         }
 
-        if(options.reorth==Full)
+        if(options.reorth != None)
             cusp::blas::copy(v1, V.column(iter));
 
         cusp::multiply(A, v1, v2);
@@ -190,7 +266,7 @@ void lanczos(const Matrix& A, Array1d& eigVals, Array2d& eigVecs, LanczosOptions
             break;
         }
 
-        if((options.reorth == cusp::eigen::Full || iter+1 < N) && (iter+1 >= minIter) && (iter+1-minIter)%options.stride == 0)
+        if((options.reorth != cusp::eigen::None || iter+1 < N) && (iter+1 >= minIter) && (iter+1-minIter)%options.stride == 0)
         {
             cusp::array2d<double, cusp::host_memory, cusp::column_major> tempV;
 
@@ -319,6 +395,66 @@ void lanczos(const Matrix& A, Array1d& eigVals, Array2d& eigVecs, LanczosOptions
 
             betas[iter] = bb;
         }
+        else if(options.reorth == cusp::eigen::Partial)
+        {
+            detail::updateOmega(alphas, betas, omega, omega_old, iter, eps1);
+
+            ValueType omegaMax = 0.0;
+            for(size_t k = 0; k <= iter; k++)
+                omegaMax = std::max(omegaMax, ValueType(std::abs(omega[k])));
+
+            // the vector after a reorthogonalized one is reorthogonalized
+            // against the same columns, since its recurrence inherits the
+            // loss of orthogonality of the previous vector
+            if(reorthNext || omegaMax > delta)
+            {
+                if(reorthNext)
+                {
+                    if(!intervals.empty())
+                        intervals.back().second = iter + 1;
+                }
+                else
+                {
+                    detail::orthogonalityIntervals(omega, iter + 1, delta, eta, intervals);
+                }
+
+                reorthIterCount++;
+
+                for(size_t i = 0; i < intervals.size(); i++)
+                {
+                    reorthVectorCount += intervals[i].second - intervals[i].first;
+                    detail::classicalGramSchmidt(V, v2, projections, intervals[i].first, intervals[i].second);
+                }
+
+                bb_old = bb;
+                bb = cusp::blas::nrm2(v2);
+
+                if(options.doubleReorthGamma >= 1.0 || bb < options.doubleReorthGamma*bb_old)
+                {
+                    if(options.verbose)
+                        std::cout << "At iteration #" << iter+1 <<
+                                  ", reorthogonalization is doubled" << std::endl;
+
+                    doubleReorthIterCount++;
+
+                    for(size_t i = 0; i < intervals.size(); i++)
+                    {
+                        doubleReorthVectorCount += intervals[i].second - intervals[i].first;
+                        detail::classicalGramSchmidt(V, v2, projections, intervals[i].first, intervals[i].second);
+                    }
+
+                    bb = cusp::blas::nrm2(v2);
+                }
+
+                betas[iter] = bb;
+
+                for(size_t i = 0; i < intervals.size(); i++)
+                    for(size_t k = intervals[i].first; k < intervals[i].second; k++)
+                        omega[k] = eps1;
+
+                reorthNext = !reorthNext;
+            }
+        }
 
         if(bb < betaSum*eps || bb == 0.0)
         {
@@ -330,6 +466,10 @@ void lanczos(const Matrix& A, Array1d& eigVals, Array2d& eigVecs, LanczosOptions
             detail::modifiedGramSchmidt(V, v2, flag, iter+1);
             bb = cusp::blas::nrm2(v2);
             betas[iter] = 0.0;
+
+            // a restarted vector is orthogonal to the basis
+            std::fill(omega.begin(), omega.end() - 1, eps1);
+            reorthNext = false;
         }
 
         cusp::blas::scal(v2, 1.0/bb);
@@ -357,7 +497,7 @@ void lanczos(const Matrix& A, Array1d& eigVals, Array2d& eigVecs, LanczosOptions
 
     if(allEigenvaluesCheckedConverged == false)
     {
-        if((options.reorth == cusp::eigen::Full || options.maxIter < N) && (options.minIter != options.maxIter))
+        if((options.reorth != cusp::eigen::None || options.maxIter < N) && (options.minIter != options.maxIter))
             std::cout << "Maximum number of Lanczos iterations " << iter
                       << " is met, but the desired eigenvalues may not be converged!" << std::endl;
 
@@ -38,6 +38,7 @@ lanczos_options<ValueType>
     maxIter               = opts.maxIter;
     extraIter             = opts.extraIter;
     stride                = opts.stride;
+    blockSize             = opts.blockSize;
     defaultMinIterFactor  = opts.defaultMinIterFactor;
     defaultMaxIterFactor  = opts.defaultMaxIterFactor;
 
@@ -62,9 +63,10 @@ lanczos_options<ValueType>
     spectrumNames[LA] = "Largest";
     spectrumNames[BE] = "Both Ends";
 
-    std::string reorthNames[2];
+    std::string reorthNames[3];
     reorthNames[Full]    = "Full";
     reorthNames[None]    = "None";
+    reorthNames[Partial] = "Partial";
 
     std::cout << "Lanczos( target range : " << spectrumNames[eigPart]
               << ", reorthogonalization strategy : " << reorthNames[reorth]
@@ -79,6 +81,7 @@ lanczos_options<ValueType>
     std::cout << "\tLow Eigenvalue Cut      : " << eigLowCut  << std::endl;
     std::cout << "\tHigh Eigenvalue Cut     : " << eigHighCut << std::endl;
     std::cout << "\tConvergence Stride      : " << stride  << std::endl;
+    std::cout << "\tBlock Size              : " << blockSize << std::endl;
     std::cout << "\tConvergence Tolerance   : " << tol << std::endl;
     std::cout << "\tdouble reorthogonalization gamma : " << doubleReorthGamma << std::endl;
     std::cout << "\tlocal reorthogonalization gamma  : " << localReorthGamma << std::endl;
@@ -16,16 +16,127 @@
 
 #include <cusp/array1d.h>
 #include <cusp/array2d.h>
+#include <cusp/blas.h>
+#include <cusp/copy.h>
+#include <cusp/exception.h>
 #include <cusp/monitor.h>
 #include <cusp/linear_operator.h>
 #include <cusp/multiply.h>
 
-#include <cusp/lapack/lapack.h>
+#include <cusp/eigen/detail/block_products.inl>
+#include <cusp/lapack/batched.h>
+
+#include <thrust/copy.h>
+#include <thrust/for_each.h>
+#include <thrust/iterator/counting_iterator.h>
+
+#include <algorithm>
+#include <vector>
 
 namespace cusp
 {
 namespace eigen
 {
+namespace detail
+{
+
+// inner_products[i] <- x^T y without returning the value to the host
+template <typename Array1, typename Array2, typename Array3>
+void lobpcg_dot(const Array1& x, const Array2& y, Array3& inner_products, const size_t i)
+{
+    typedef typename Array3::memory_space System;
+
+    System system;
+    typename Array3::view entry(inner_products.subarray(i, 1));
+
+    cusp::blas::dot(system, x, y, entry);
+}
+
+// assembles the Gram matrices of the Rayleigh-Ritz procedure from the
+// inner products xaw, waw, xbw, xap, wap, pap, xbp and wbp
+template <typename ValueType>
+struct lobpcg_gram_functor
+{
+    const ValueType* inner_products;
+    double lambda;
+    double* gramA;
+    double* gramB;
+    int gram_size;
+
+    lobpcg_gram_functor(const ValueType* inner_products, const double lambda,
+                        double* gramA, double* gramB, const int gram_size)
+      : inner_products(inner_products), lambda(lambda),
+        gramA(gramA), gramB(gramB), gram_size(gram_size) {}
+
+    __host__ __device__
+    void operator()(const int) const
+    {
+        const int n = gram_size;
+
+        const double xaw = inner_products[0];
+        const double waw = inner_products[1];
+        const double xbw = inner_products[2];
+
+        gramA[0 * n + 0] = lambda;
+        gramA[0 * n + 1] = xaw;
+        gramA[1 * n + 0] = xaw;
+        gramA[1 * n + 1] = waw;
+
+        gramB[0 * n + 0] = 1.0;
+        gramB[0 * n + 1] = xbw;
+        gramB[1 * n + 0] = xbw;
+        gramB[1 * n + 1] = 1.0;
+
+        if(n == 3)
+        {
+            const double xap = inner_products[3];
+            const double wap = inner_products[4];
+            const double pap = inner_products[5];
+            const double xbp = inner_products[6];
+            const double wbp = inner_products[7];
+
+            gramA[0 * n + 2] = xap;
+            gramA[2 * n + 0] = xap;
+            gramA[1 * n + 2] = wap;
+            gramA[2 * n + 1] = wap;
+            gramA[2 * n + 2] = pap;
+
+            gramB[0 * n + 2] = xbp;
+            gramB[2 * n + 0] = xbp;
+            gramB[1 * n + 2] = wbp;
+            gramB[2 * n + 1] = wbp;
+            gramB[2 * n + 2] = 1.0;
+        }
+    }
+};
+
+// packs the status, the selected Ritz value and its coefficients so that
+// a single transfer returns them to the host
+template <typename IndexType>
+struct lobpcg_ritz_functor
+{
+    const double* eigvals;
+    const double* eigvecs;
+    const IndexType* info;
+    double* ritz;
+    int gram_size;
+    int start_index;
+
+    lobpcg_ritz_functor(const double* eigvals, const double* eigvecs, const IndexType* info,
+                        double* ritz, const int gram_size, const int start_index)
+      : eigvals(eigvals), eigvecs(eigvecs), info(info), ritz(ritz),
+        gram_size(gram_size), start_index(start_index) {}
+
+    __host__ __device__
+    void operator()(const int) const
+    {
+        ritz[0] = info[0];
+        ritz[1] = eigvals[start_index];
+
+        for(int i = 0; i < gram_size; i++)
+            ritz[2 + i] = eigvecs[start_index * gram_size + i];
+    }
+};
 
 template <typename LinearOperator,
           typename Array1d,
@@ -37,12 +148,16 @@ void lobpcg(LinearOperator& A,
             Array2d& X,
             Monitor& monitor,
             Preconditioner& M,
-            bool largest)
+            bool largest,
+            cusp::array1d_format)
 {
     typedef typename LinearOperator::value_type   ValueType;
 
+    typedef typename Array1d::memory_space        MemorySpace;
+
     typedef typename cusp::array1d<double,cusp::host_memory> VectorHost;
-    typedef typename cusp::array2d<double,cusp::host_memory,cusp::column_major> Array2dHost;
+    typedef typename cusp::array1d<double,MemorySpace> VectorGram;
+    typedef typename cusp::array2d<double,MemorySpace,cusp::column_major> Array2dGram;
 
     const size_t N = A.num_rows;
 
@@ -64,6 +179,17 @@ void lobpcg(LinearOperator& A,
 
     ValueType _lambda = cusp::blas::dot(blockVectorX, blockVectorAX);
 
+    // workspace of the Rayleigh-Ritz procedure
+    MemorySpace system;
+    cusp::array1d<ValueType,MemorySpace> inner_products(8, ValueType(0));
+    cusp::array1d<int,MemorySpace> info;
+    Array2dGram gramA;
+    Array2dGram gramB;
+    Array2dGram eigvecs;
+    VectorGram  eigvals;
+    VectorGram  ritz(5, 0.0);
+    VectorHost  ritz_h(5, 0.0);
+
     while (monitor.iteration_count() < std::min(N,monitor.iteration_limit()))
     {
         cusp::blas::axpby(blockVectorX, blockVectorAX, blockVectorR, -_lambda, ValueType(1));
@@ -96,73 +222,59 @@ void lobpcg(LinearOperator& A,
         }
 
         // Perform the Rayleigh-Ritz procedure :
-        // Compute symmetric Gram matrices
-        size_t gram_size = monitor.iteration_count() > 0 ? 3 : 2;
-
-        Array2dHost gramA(gram_size, gram_size, ValueType(0));
-        Array2dHost gramB(gram_size, gram_size, ValueType(0));
+        // Compute symmetric Gram matrices, the inner products and the
+        // projected eigenproblem stay in the memory space of the vectors
+        const int gram_size = monitor.iteration_count() > 0 ? 3 : 2;
 
-        ValueType xaw = cusp::blas::dot( blockVectorX,        activeBlockVectorAR );
-        ValueType waw = cusp::blas::dot( activeBlockVectorR, 	activeBlockVectorAR );
-        ValueType xbw = cusp::blas::dot( blockVectorX, 	 	    activeBlockVectorR );
+        detail::lobpcg_dot( blockVectorX,       activeBlockVectorAR, inner_products, 0 );
+        detail::lobpcg_dot( activeBlockVectorR, activeBlockVectorAR, inner_products, 1 );
+        detail::lobpcg_dot( blockVectorX,       activeBlockVectorR,  inner_products, 2 );
 
         if( monitor.iteration_count() > 0 )
         {
-            ValueType xap = cusp::blas::dot( blockVectorX,       blockVectorAP );
-            ValueType wap = cusp::blas::dot( activeBlockVectorR, blockVectorAP );
-            ValueType pap = cusp::blas::dot( blockVectorP, 	     blockVectorAP );
-            ValueType xbp = cusp::blas::dot( blockVectorX,       blockVectorP );
-            ValueType wbp = cusp::blas::dot( activeBlockVectorR, blockVectorP );
-
-            gramA(0,0) = _lambda;
-            gramA(0,1) = xaw;
-            gramA(0,2) = xap;
-            gramA(1,0) = xaw;
-            gramA(1,1) = waw;
-            gramA(1,2) = wap;
-            gramA(2,0) = xap;
-            gramA(2,1) = wap;
-            gramA(2,2) = pap;
-
-            gramB(0,0) = 1.0;
-            gramB(0,1) = xbw;
-            gramB(0,2) = xbp;
-            gramB(1,0) = xbw;
-            gramB(1,1) = 1.0;
-            gramB(1,2) = wbp;
-            gramB(2,0) = xbp;
-            gramB(2,1) = wbp;
-            gramB(2,2) = 1.0;
+            detail::lobpcg_dot( blockVectorX,       blockVectorAP, inner_products, 3 );
+            detail::lobpcg_dot( activeBlockVectorR, blockVectorAP, inner_products, 4 );
+            detail::lobpcg_dot( blockVectorP,       blockVectorAP, inner_products, 5 );
+            detail::lobpcg_dot( blockVectorX,       blockVectorP,  inner_products, 6 );
+            detail::lobpcg_dot( activeBlockVectorR, blockVectorP,  inner_products, 7 );
         }
-        else
+
+        if( gramA.num_rows != size_t(gram_size) )
         {
-            gramA(0,0) = _lambda;
-            gramA(0,1) = xaw;
-            gramA(1,0) = xaw;
-            gramA(1,1) = waw;
-
-            gramB(0,0) = 1.0;
-            gramB(0,1) = xbw;
-            gramB(1,0) = xbw;
-            gramB(1,1) = 1.0;
+            gramA.resize(gram_size, gram_size);
+            gramB.resize(gram_size, gram_size);
         }
 
+        thrust::for_each(system, thrust::counting_iterator<int>(0), thrust::counting_iterator<int>(1),
+                         detail::lobpcg_gram_functor<ValueType>(thrust::raw_pointer_cast(&inner_products[0]), _lambda,
+                                                                thrust::raw_pointer_cast(&gramA(0,0)),
+                                                                thrust::raw_pointer_cast(&gramB(0,0)), gram_size));
+
         // Solve the generalized eigenvalue problem.
-        VectorHost _lambda_h(gramA.num_rows, ValueType(0));
-        Array2dHost eigBlockVector_h(gramA.num_rows, gramA.num_cols, ValueType(0));
+        cusp::lapack::batched_sygv(gramA, gramB, eigvals, eigvecs, info);
 
-        cusp::lapack::sygv(gramA, gramB, _lambda_h, eigBlockVector_h);
+        int start_index = largest ? gram_size-1 : 0;
 
-        int start_index = largest ? gramA.num_rows-1 : 0;
+        thrust::for_each(system, thrust::counting_iterator<int>(0), thrust::counting_iterator<int>(1),
+                         detail::lobpcg_ritz_functor<int>(thrust::raw_pointer_cast(&eigvals[0]),
+                                                          thrust::raw_pointer_cast(&eigvecs(0,0)),
+                                                          thrust::raw_pointer_cast(&info[0]),
+                                                          thrust::raw_pointer_cast(&ritz[0]),
+                                                          gram_size, start_index));
 
-        _lambda = _lambda_h[start_index];
-        ValueType eigBlockVectorX = eigBlockVector_h(0,start_index);
-        ValueType eigBlockVectorR = eigBlockVector_h(1,start_index);
+        ritz_h = ritz;
+
+        if( ritz_h[0] != 0 )
+            throw cusp::runtime_exception("sygv failed");
+
+        _lambda = ritz_h[1];
+        ValueType eigBlockVectorX = ritz_h[2];
+        ValueType eigBlockVectorR = ritz_h[3];
 
         // Compute Ritz vectors
         if( monitor.iteration_count() > 0 )
         {
-            ValueType eigBlockVectorP = eigBlockVector_h(2,start_index);
+            ValueType eigBlockVectorP = ritz_h[4];
 
             cusp::blas::axpby( activeBlockVectorR,  blockVectorP,  blockVectorP,  eigBlockVectorR, eigBlockVectorP );
             cusp::blas::axpby( activeBlockVectorAR, blockVectorAP, blockVectorAP, eigBlockVectorR, eigBlockVectorP );
@@ -182,6 +294,403 @@ void lobpcg(LinearOperator& A,
     S[0] = _lambda;
 }
 
+// C <- R^{-1} for the Cholesky factor R of W^T W, resident in the memory
+// space of the policy; returns false if the columns of W are numerically
+// linearly dependent
+template <typename DerivedPolicy, typename Array2d, typename Array1d>
+bool lobpcg_cholesky(thrust::execution_policy<DerivedPolicy>& exec,
+                     const Array2d& W,
+                           Array1d& C)
+{
+    const size_t s = W.num_cols;
+
+    Array1d G;
+    cusp::array1d<double,cusp::host_memory> G_host;
+    cusp::array1d<double,cusp::host_memory> R;
+    cusp::array1d<double,cusp::host_memory> Rinv;
+
+    block_project(exec, W, s, W, G);
+    G_host = G;
+
+    if(!block_cholesky_upper(G_host, R, s))
+        return false;
+
+    block_invert_upper(R, Rinv, s);
+    C = Rinv;
+
+    return true;
+}
+
+// Z <- Z C for a row-major square coefficient matrix C, through the
+// workspace T
+template <typename DerivedPolicy, typename Array2d1, typename Array1d, typename Array2d2>
+void lobpcg_transform(thrust::execution_policy<DerivedPolicy>& exec,
+                      Array2d1& Z,
+                      const Array1d& C,
+                      Array2d2& T)
+{
+    typedef typename Array2d1::value_type ValueType;
+
+    T.resize(Z.num_rows, Z.num_cols);
+    block_combine(exec, T, Z, Z.num_cols, C, T, ValueType(1), ValueType(0));
+    thrust::copy(exec, T.values.begin(), T.values.end(), Z.values.begin());
+}
+
+// solves the projected eigenproblem gramA y = theta gramB y and gathers
+// the k wanted Ritz values together with their coefficients as a
+// row-major n-by-k matrix; returns false if gramB is not numerically
+// positive definite
+template <typename Array2d, typename Array1d>
+bool lobpcg_rayleigh_ritz(const Array2d& gramA,
+                          const Array2d& gramB,
+                          const size_t k,
+                          const bool largest,
+                          Array1d& lambda,
+                          Array1d& coefficients)
+{
+    const size_t n = gramA.num_rows;
+
+    Array2d eigvecs;
+    Array1d eigvals;
+    cusp::array1d<int,cusp::host_memory> info;
+
+    cusp::lapack::batched_sygv(gramA, gramB, eigvals, eigvecs, info);
+
+    if(info[0] != 0)
+        return false;
+
+    lambda.resize(k);
+    coefficients.resize(n * k);
+
+    for(size_t j = 0; j < k; j++)
+    {
+        const size_t e = largest ? n - 1 - j : j;
+
+        lambda[j] = eigvals[e];
+
+        for(size_t i = 0; i < n; i++)
+            coefficients[i * k + j] = eigvecs(i, e);
+    }
+
+    return true;
+}
+
+// Block LOBPCG with soft locking : every column of X takes part in the
+// Rayleigh-Ritz procedure, but only the columns whose residual is above
+// the tolerance contribute a preconditioned residual and a search
+// direction, so the cost of an iteration shrinks as the eigenpairs
+// converge. A converged column stays locked.
+template <typename LinearOperator,
+          typename Array1d,
+          typename Array2d,
+          typename Monitor,
+          typename Preconditioner>
+void lobpcg(LinearOperator& A,
+            Array1d& S,
+            Array2d& X,
+            Monitor& monitor,
+            Preconditioner& M,
+            bool largest,
+            cusp::array2d_format)
+{
+    typedef typename LinearOperator::value_type                          ValueType;
+    typedef typename Array2d::memory_space                               MemorySpace;
+
+    typedef cusp::array2d<ValueType,MemorySpace,cusp::column_major>      Block;
+    typedef typename Block::view                                         BlockView;
+    typedef typename Block::column_view                                  ColumnView;
+    typedef cusp::array1d<ValueType,MemorySpace>                         Coefficients;
+    typedef cusp::array1d<double,cusp::host_memory>                      VectorHost;
+    typedef cusp::array2d<double,cusp::host_memory,cusp::column_major>   Array2dHost;
+
+    const size_t N = A.num_rows;
+    const size_t k = X.num_cols;
+
+    if(X.num_rows != N || k == 0 || 3 * k > N)
+        throw cusp::invalid_input_exception("lobpcg: X must have N rows and at most N/3 columns");
+
+    MemorySpace system;
+
+    Block blockVectorX(X);
+    Block blockVectorAX(N, k);
+    Block blockVectorP(N, k);
+    Block blockVectorAP(N, k);
+    Block blockVectorR(N, k);
+    Block blockVectorT(N, k);
+    Block blockVectorAT(N, k);
+
+    // the active preconditioned residuals followed by the active search
+    // directions, and their images under A
+    Block blockVectorWP;
+    Block blockVectorAWP;
+    Block workspace;
+
+    Coefficients C;
+    Coefficients Cx;
+    Coefficients Cb;
+    Coefficients xab, bab, xb, bb;
+
+    VectorHost lambda;
+    VectorHost coefficients;
+    VectorHost Cx_h;
+    VectorHost Cb_h;
+    VectorHost xab_h, bab_h, xb_h, bb_h;
+    VectorHost residuals(k, 0.0);
+
+    Array2dHost gramA;
+    Array2dHost gramB;
+
+    // orthonormalize X and solve the Rayleigh-Ritz problem on its span
+    if(!lobpcg_cholesky(system, blockVectorX, C))
+        throw cusp::invalid_input_exception("lobpcg: columns of X are linearly dependent");
+
+    lobpcg_transform(system, blockVectorX, C, workspace);
+
+    cusp::multiply(A, blockVectorX, blockVectorAX);
+
+    block_project(system, blockVectorX, k, blockVectorAX, xab);
+    xab_h = xab;
+
+    gramA.resize(k, k);
+    gramB.resize(k, k);
+
+    for(size_t i = 0; i < k; i++)
+        for(size_t j = 0; j < k; j++)
+        {
+            gramA(i,j) = 0.5 * (xab_h[i * k + j] + xab_h[j * k + i]);
+            gramB(i,j) = i == j ? 1.0 : 0.0;
+        }
+
+    if(!lobpcg_rayleigh_ritz(gramA, gramB, k, largest, lambda, coefficients))
+        throw cusp::runtime_exception("sygv failed");
+
+    C = coefficients;
+    lobpcg_transform(system, blockVectorX, C, workspace);
+    lobpcg_transform(system, blockVectorAX, C, workspace);
+
+    std::vector<size_t> active;
+    for(size_t i = 0; i < k; i++)
+        active.push_back(i);
+
+    bool hasP = false;
+
+    while (monitor.iteration_count() < std::min(N,monitor.iteration_limit()))
+    {
+        // residuals of the active columns, a column whose residual drops
+        // below the tolerance is locked
+        std::vector<size_t> stillActive;
+
+        for(size_t c = 0; c < active.size(); c++)
+        {
+            const size_t i = active[c];
+
+            ColumnView x(blockVectorX.column(i));
+            ColumnView ax(blockVectorAX.column(i));
+            ColumnView r(blockVectorR.column(i));
+
+            cusp::blas::axpby(x, ax, r, ValueType(-lambda[i]), ValueType(1));
+
+            residuals[i] = cusp::blas::nrm2(r);
+
+            if( residuals[i] >= monitor.relative_tolerance() )
+                stillActive.push_back(i);
+        }
+
+        active.swap(stillActive);
+
+        monitor.residuals.push_back(*std::max_element(residuals.begin(), residuals.end()));
+
+        if(monitor.is_verbose())
+        {
+            std::cout << "Iteration      : " << monitor.iteration_count() << std::endl;
+            std::cout << "Active columns : " << active.size() << " of " << k << std::endl;
+            std::cout << "Eigenvalues    :";
+            for(size_t i = 0; i < k; i++)
+                std::cout << " " << lambda[i];
+            std::cout << std::endl;
+            std::cout << "Residual norms :";
+            for(size_t i = 0; i < k; i++)
+                std::cout << " " << residuals[i];
+            std::cout << std::endl << std::endl;
+        }
+
+        if( active.empty() ) break; // All eigenpairs converged
+
+        const size_t a = active.size();
+
+        blockVectorWP.resize(N, 2 * a);
+        blockVectorAWP.resize(N, 2 * a);
+
+        BlockView blockVectorW(cusp::make_array2d_view(N, a, N, blockVectorWP.values.subarray(0, a * N), cusp::column_major()));
+        BlockView blockVectorAW(cusp::make_array2d_view(N, a, N, blockVectorAWP.values.subarray(0, a * N), cusp::column_major()));
+
+        // Apply preconditioner, M, to the active residuals
+        for(size_t c = 0; c < a; c++)
+        {
+            ColumnView r(blockVectorR.column(active[c]));
+            ColumnView w(blockVectorWP.column(c));
+
+            cusp::multiply(M, r, w);
+        }
+
+        // W <- W - X X^T W, then orthonormalize
+        block_project(system, blockVectorX, k, blockVectorW, C);
+        block_combine(system, blockVectorW, blockVectorX, k, C, blockVectorW, ValueType(-1), ValueType(1));
+
+        if(!lobpcg_cholesky(system, blockVectorW, C))
+            throw cusp::runtime_exception("lobpcg: preconditioned residuals are linearly dependent");
+
+        lobpcg_transform(system, blockVectorW, C, workspace);
+
+        cusp::multiply(A, blockVectorW, blockVectorAW);
+
+        // gather and orthonormalize the search directions of the active
+        // columns, restarting without them if they have become dependent
+        if( hasP )
+        {
+            for(size_t c = 0; c < a; c++)
+            {
+                const size_t i = active[c];
+
+                thrust::copy(system, blockVectorP.values.begin() + i * N, blockVectorP.values.begin() + (i + 1) * N,
+                             blockVectorWP.values.begin() + (a + c) * N);
+                thrust::copy(system, blockVectorAP.values.begin() + i * N, blockVectorAP.values.begin() + (i + 1) * N,
+                             blockVectorAWP.values.begin() + (a + c) * N);
+            }
+
+            BlockView activeP(cusp::make_array2d_view(N, a, N, blockVectorWP.values.subarray(a * N, a * N), cusp::column_major()));
+            BlockView activeAP(cusp::make_array2d_view(N, a, N, blockVectorAWP.values.subarray(a * N, a * N), cusp::column_major()));
+
+            hasP = lobpcg_cholesky(system, activeP, C);
+
+            if( hasP )
+            {
+                lobpcg_transform(system, activeP, C, workspace);
+                lobpcg_transform(system, activeAP, C, workspace);
+            }
+        }
+
+        // Perform the Rayleigh-Ritz procedure on [X, W, P] :
+        // the X block is diagonal since X holds the current Ritz vectors
+        // and W and P are orthonormal, so only the coupling blocks are
+        // computed; the projected problem is of order k + 2a at most
+        while( true )
+        {
+            const size_t nb = hasP ? 2 * a : a;
+            const size_t n  = k + nb;
+
+            BlockView blockVectorB(cusp::make_array2d_view(N, nb, N, blockVectorWP.values.subarray(0, nb * N), cusp::column_major()));
+            BlockView blockVectorAB(cusp::make_array2d_view(N, nb, N, blockVectorAWP.values.subarray(0, nb * N), cusp::column_major()));
+
+            block_project(system, blockVectorX, k, blockVectorAB, xab);
+            block_project(system, blockVectorB, nb, blockVectorAB, bab);
+            block_project(system, blockVectorX, k, blockVectorB, xb);
+            block_project(system, blockVectorB, nb, blockVectorB, bb);
+
+            xab_h = xab;
+            bab_h = bab;
+            xb_h  = xb;
+            bb_h  = bb;
+
+            gramA.resize(n, n);
+            gramB.resize(n, n);
+
+            for(size_t i = 0; i < n; i++)
+                for(size_t j = 0; j < n; j++)
+                {
+                    if(i < k && j < k)
+                    {
+                        gramA(i,j) = i == j ? lambda[i] : 0.0;
+                        gramB(i,j) = i == j ? 1.0 : 0.0;
+                    }
+                    else if(i < k)
+                    {
+                        gramA(i,j) = xab_h[i * nb + (j - k)];
+                        gramB(i,j) = xb_h[i * nb + (j - k)];
+                    }
+                    else if(j < k)
+                    {
+                        gramA(i,j) = xab_h[j * nb + (i - k)];
+                        gramB(i,j) = xb_h[j * nb + (i - k)];
+                    }
+                    else
+                    {
+                        const size_t p = i - k;
+                        const size_t q = j - k;
+
+                        gramA(i,j) = 0.5 * (bab_h[p * nb + q] + bab_h[q * nb + p]);
+                        gramB(i,j) = 0.5 * (bb_h[p * nb + q] + bb_h[q * nb + p]);
+                    }
+                }
+
+            // Solve the generalized eigenvalue problem.
+            if(lobpcg_rayleigh_ritz(gramA, gramB, k, largest, lambda, coefficients))
+                break;
+
+            if( !hasP )
+                throw cusp::runtime_exception("sygv failed");
+
+            hasP = false;
+        }
+
+        const size_t nb = hasP ? 2 * a : a;
+
+        BlockView blockVectorB(cusp::make_array2d_view(N, nb, N, blockVectorWP.values.subarray(0, nb * N), cusp::column_major()));
+        BlockView blockVectorAB(cusp::make_array2d_view(N, nb, N, blockVectorAWP.values.subarray(0, nb * N), cusp::column_major()));
+
+        Cx_h.resize(k * k);
+        Cb_h.resize(nb * k);
+
+        for(size_t i = 0; i < k; i++)
+            for(size_t j = 0; j < k; j++)
+                Cx_h[i * k + j] = coefficients[i * k + j];
+
+        for(size_t i = 0; i < nb; i++)
+            for(size_t j = 0; j < k; j++)
+                Cb_h[i * k + j] = coefficients[(k + i) * k + j];
+
+        Cx = Cx_h;
+        Cb = Cb_h;
+
+        // Compute Ritz vectors : P <- [W, P] Cb and X <- X Cx + P
+        block_combine(system, blockVectorT, blockVectorB, nb, Cb, blockVectorT, ValueType(1), ValueType(0));
+        block_combine(system, blockVectorAT, blockVectorAB, nb, Cb, blockVectorAT, ValueType(1), ValueType(0));
+
+        block_combine(system, blockVectorT, blockVectorX, k, Cx, blockVectorP, ValueType(1), ValueType(1));
+        block_combine(system, blockVectorAT, blockVectorAX, k, Cx, blockVectorAP, ValueType(1), ValueType(1));
+
+        blockVectorX.swap(blockVectorP);
+        blockVectorAX.swap(blockVectorAP);
+        blockVectorP.swap(blockVectorT);
+        blockVectorAP.swap(blockVectorAT);
+
+        hasP = true;
+
+        ++monitor;
+    }
+
+    S.resize(k);
+    thrust::copy(lambda.begin(), lambda.end(), S.begin());
+
+    cusp::copy(blockVectorX, X);
+}
+} // end namespace detail
+
+template <typename LinearOperator,
+          typename Array1d,
+          typename Array2d,
+          typename Monitor,
+          typename Preconditioner>
+void lobpcg(LinearOperator& A,
+            Array1d& S,
+            Array2d& X,
+            Monitor& monitor,
+            Preconditioner& M,
+            bool largest)
+{
+    detail::lobpcg(A, S, X, monitor, M, largest, typename Array2d::format());
+}
+
 template <typename LinearOperator,
           typename Array1d,
           typename Array2d,
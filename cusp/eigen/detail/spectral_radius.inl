@@ -29,7 +29,10 @@
 
 #include <thrust/extrema.h>
 #include <thrust/transform.h>
+#include <thrust/transform_reduce.h>
+#include <thrust/tuple.h>
 #include <thrust/iterator/counting_iterator.h>
+#include <thrust/iterator/zip_iterator.h>
 #include <thrust/reduce.h>
 
 #include <thrust/detail/integer_traits.h>
@@ -165,6 +168,46 @@ void lanczos_estimate(const Matrix& A, Array2d& H, size_t k)
             H(row,col) = H_(row,col);
 }
 
+// x^T A x and x^T D x, whose ratio is the Rayleigh quotient of D^-1 A
+// in the D inner product
+struct jacobi_quotient_functor
+{
+    template <typename Tuple>
+    __host__ __device__
+    thrust::tuple<double,double> operator()(const Tuple& t) const
+    {
+        const double x = thrust::get<0>(t);
+
+        return thrust::make_tuple(x * double(thrust::get<1>(t)), double(thrust::get<2>(t)) * x * x);
+    }
+};
+
+struct jacobi_quotient_plus
+{
+    __host__ __device__
+    thrust::tuple<double,double> operator()(const thrust::tuple<double,double>& a,
+                                            const thrust::tuple<double,double>& b) const
+    {
+        return thrust::make_tuple(thrust::get<0>(a) + thrust::get<0>(b),
+                                  thrust::get<1>(a) + thrust::get<1>(b));
+    }
+};
+
+// x <- D^-1 y / lambda, rows with a zero diagonal are only scaled
+template <typename ValueType>
+struct jacobi_scale_functor
+{
+    const ValueType lambda;
+
+    jacobi_scale_functor(const ValueType lambda) : lambda(lambda) {}
+
+    __host__ __device__
+    ValueType operator()(const ValueType y, const ValueType d) const
+    {
+        return d == ValueType(0) ? y / lambda : y / (d * lambda);
+    }
+};
+
 } // end detail namespace
 
 template <typename MatrixType>
@@ -175,10 +218,21 @@ double disks_spectral_radius(const MatrixType& A)
 
 template <typename MatrixType>
 double estimate_rho_Dinv_A(const MatrixType& A)
+{
+    typedef typename MatrixType::value_type   ValueType;
+    typedef typename MatrixType::memory_space MemorySpace;
+
+    cusp::array1d<ValueType, MemorySpace> x;
+
+    return cusp::eigen::estimate_rho_Dinv_A(A, x);
+}
+
+template <typename MatrixType, typename Array1d>
+double estimate_rho_Dinv_A(const MatrixType& A, Array1d& x, double tol, size_t maxiter)
 {
     detail::Dinv_A<MatrixType> Dinv_A(A);
 
-    return cusp::eigen::ritz_spectral_radius(Dinv_A, 8);
+    return cusp::eigen::adaptive_spectral_radius(Dinv_A, x, tol, maxiter);
 }
 
 template <typename MatrixType>
@@ -222,6 +276,188 @@ double ritz_spectral_radius(const MatrixType& A, size_t k, bool symmetric)
     return estimate_spectral_radius(H);
 }
 
+template <typename MatrixType>
+double restarted_spectral_radius(const MatrixType& A, size_t maxBasis, double tol)
+{
+    // the restarted method needs room for the dominant Ritz value and
+    // two shifts
+    if(A.num_rows < 3)
+        return ritz_spectral_radius(A, A.num_rows);
+
+    cusp::array1d<cusp::complex<double>, cusp::host_memory> eigVals(1);
+
+    cusp::eigen::implicitly_restarted_arnoldi(A, eigVals, std::max(maxBasis, size_t(3)), 100, tol);
+
+    return cusp::abs(eigVals[0]);
+}
+
+template <typename MatrixType, typename Array1d>
+double adaptive_spectral_radius(const MatrixType& A, Array1d& x, double tol, size_t maxiter)
+{
+    typedef typename MatrixType::value_type   ValueType;
+    typedef typename MatrixType::memory_space MemorySpace;
+    typedef typename cusp::norm_type<ValueType>::type NormType;
+    typedef cusp::array2d<ValueType,MemorySpace,cusp::column_major>    Basis;
+    typedef cusp::array2d<double,cusp::host_memory,cusp::column_major> SmallMatrix;
+    typedef typename Basis::column_view ColumnView;
+
+    const size_t N = A.num_rows;
+    const size_t m = std::min(N, maxiter);
+
+    if(m == 0)
+        return 0.0;
+
+    Basis V(N, m + 1);
+    SmallMatrix H(m + 1, m, 0.0);
+    ColumnView v0(V.column(0));
+
+    // start from the Ritz vector of a previous estimate when one is given
+    if(x.size() == N)
+        cusp::copy(x, v0);
+    else
+        cusp::copy(cusp::random_array<ValueType>(N), v0);
+
+    NormType norm = cusp::blas::nrm2(v0);
+
+    if(norm == NormType(0))
+    {
+        cusp::copy(cusp::random_array<ValueType>(N), v0);
+        norm = cusp::blas::nrm2(v0);
+    }
+
+    cusp::blas::scal(v0, ValueType(1) / norm);
+
+    cusp::array1d<double,cusp::host_memory> wr;
+    cusp::array1d<double,cusp::host_memory> wi;
+
+    double rho   = 0.0;
+    double theta = 0.0;
+    size_t j     = 0;
+
+    // one Arnoldi step at a time until two successive dominant Ritz
+    // values agree or an invariant subspace is found
+    while(j < m)
+    {
+        detail::arnoldi_extend(A, V, H, j, j + 1);
+        j++;
+
+        const bool invariant = H(j, j - 1) < 1e-10;
+
+        detail::hessenberg_eigenvalues(H, j, wr, wi);
+
+        double rho_j = 0.0;
+
+        for(size_t i = 0; i < j; i++)
+        {
+            const double magnitude = cusp::abs(cusp::complex<double>(wr[i], wi[i]));
+
+            if(magnitude > rho_j)
+            {
+                rho_j = magnitude;
+                theta = wr[i];
+            }
+        }
+
+        const bool agree = j > 1 && std::abs(rho_j - rho) <= tol * rho_j;
+
+        rho = rho_j;
+
+        if(invariant || agree)
+            break;
+    }
+
+    // x <- V y for the dominant Ritz pair (theta, y)
+    cusp::array1d<double,cusp::host_memory> y;
+    detail::hessenberg_eigenvector(H, j, theta, y);
+
+    cusp::array1d<ValueType,MemorySpace> y_d(y);
+    cusp::array1d<ValueType,MemorySpace> ritz(N);
+    typename Basis::view Vj(N, j, N, V.values.subarray(0, j * N));
+
+    cusp::blas::gemv(Vj, y_d, ritz);
+    cusp::copy(ritz, x);
+
+    return rho;
+}
+
+template <typename MatrixType>
+double adaptive_spectral_radius(const MatrixType& A, double tol, size_t maxiter)
+{
+    typedef typename MatrixType::value_type   ValueType;
+    typedef typename MatrixType::memory_space MemorySpace;
+
+    cusp::array1d<ValueType, MemorySpace> x;
+
+    return cusp::eigen::adaptive_spectral_radius(A, x, tol, maxiter);
+}
+
+template <typename MatrixType, typename Array1d>
+double jacobi_power_spectral_radius(const MatrixType& A, Array1d& x, double tol, size_t maxiter)
+{
+    typedef typename MatrixType::value_type   ValueType;
+    typedef typename MatrixType::memory_space MemorySpace;
+
+    const size_t N = A.num_rows;
+
+    cusp::array1d<ValueType, MemorySpace> diagonal(N);
+    cusp::array1d<ValueType, MemorySpace> y(N);
+
+    cusp::extract_diagonal(A, diagonal);
+
+    // resume the iteration of a previous estimate when one is given
+    if(x.size() != N || cusp::blas::nrmmax(x) == 0)
+    {
+        x.resize(N);
+        cusp::copy(cusp::random_array<ValueType>(N), x);
+    }
+
+    double lambda      = 0.0;
+    double lambda_prev = 0.0;
+
+    for(size_t i = 0; i < maxiter; i++)
+    {
+        cusp::multiply(A, x, y);
+
+        // the Rayleigh quotient and the Jacobi scaling of the next
+        // iterate each take a single pass over the vectors
+        thrust::tuple<double,double> quotient =
+            thrust::transform_reduce(thrust::make_zip_iterator(thrust::make_tuple(x.begin(), y.begin(), diagonal.begin())),
+                                     thrust::make_zip_iterator(thrust::make_tuple(x.end(), y.end(), diagonal.end())),
+                                     detail::jacobi_quotient_functor(),
+                                     thrust::make_tuple(0.0, 0.0),
+                                     detail::jacobi_quotient_plus());
+
+        if(thrust::get<1>(quotient) == 0.0)
+            break;
+
+        lambda = thrust::get<0>(quotient) / thrust::get<1>(quotient);
+
+        if(lambda == 0.0)
+            break;
+
+        thrust::transform(y.begin(), y.end(), diagonal.begin(), x.begin(),
+                          detail::jacobi_scale_functor<ValueType>(ValueType(lambda)));
+
+        if(i > 0 && std::abs(lambda - lambda_prev) <= tol * std::abs(lambda))
+            break;
+
+        lambda_prev = lambda;
+    }
+
+    return std::abs(lambda);
+}
+
+template <typename MatrixType>
+double jacobi_power_spectral_radius(const MatrixType& A, double tol, size_t maxiter)
+{
+    typedef typename MatrixType::value_type   ValueType;
+    typedef typename MatrixType::memory_space MemorySpace;
+
+    cusp::array1d<ValueType, MemorySpace> x;
+
+    return cusp::eigen::jacobi_power_spectral_radius(A, x, tol, maxiter);
+}
+
 } // end namespace eigen
 } // end namespace cusp
 
@@ -63,6 +63,17 @@ void lanczos(const MatrixType& A,
  * \par Overview
  * Computes the extreme eigenpairs of hermitian linear systems A x = s x.
  *
+ * The Lanczos vectors lose orthogonality in floating point arithmetic as
+ * Ritz values converge. \p options.reorth selects the remedy:
+ * \c cusp::eigen::Full reorthogonalizes every new vector against the
+ * basis, while \c cusp::eigen::Partial estimates the loss of orthogonality
+ * with Simon's omega recurrence on the host and reorthogonalizes two
+ * consecutive vectors only when an estimate exceeds <tt>sqrt(eps)</tt>,
+ * against the columns whose estimates exceed <tt>eps^(3/4)</tt>. The
+ * projections onto these columns of the basis, which stays in the memory
+ * space of \p A, are computed with one batched dot product per range of
+ * columns, so long runs remain dominated by the cost of multiplying by \p A.
+ *
  * \note \p A must be symmetric.
  *
  * \par Example
@@ -43,6 +43,7 @@ typedef enum
 {
     None,
     Full,
+    Partial,
 } ReorthStrategy;
 
 template<typename ValueType>
@@ -57,6 +58,7 @@ public:
     size_t maxIter;
     size_t extraIter;
     size_t stride;
+    size_t blockSize;
 
     ReorthStrategy reorth;
     SpectrumPart eigPart;
@@ -74,7 +76,7 @@ public:
 
     lanczos_options() :
         computeEigVecs(false), verbose(false), minIter(0), maxIter(0), extraIter(10),
-        stride(10), reorth(None), eigPart(LA), memoryExpansionFactor(1.2), tol(1e-4),
+        stride(10), blockSize(0), reorth(None), eigPart(LA), memoryExpansionFactor(1.2), tol(1e-4),
         doubleReorthGamma(1.0/std::sqrt(2.0)), localReorthGamma(1.0/std::sqrt(2.0)),
         defaultMinIterFactor(5), defaultMaxIterFactor(50),
         eigLowCut(std::numeric_limits<ValueType>::infinity()),
@@ -63,16 +63,33 @@ void lobpcg(LinearOperator& A,
  *
  * \param A matrix of the linear system
  * \param S eigenvalues
- * \param X eigenvectors
+ * \param X eigenvectors, an \p array1d for a single eigenpair or an
+ * \p array2d with one column per eigenpair
  * \param monitor monitors iteration and determines stopping conditions
  * \param M preconditioner for A
- * \param largest If true compute the eigenpair corresponding to the largest
- * eigenvalue otherwise compute the smallest.
+ * \param largest If true compute the eigenpairs corresponding to the largest
+ * eigenvalues otherwise compute the smallest.
  *
  * \par Overview
  * Computes the extreme eigenpairs of hermitian linear systems A x = s x
  * using LOBPCG.
  *
+ * When \p X is an \p array2d with \c k columns the \c k extreme
+ * eigenpairs are computed together and \p S is resized to \c k, ordered
+ * from the most extreme eigenvalue inwards. The columns of \p X are the
+ * initial guesses and must be linearly independent, and \c 3k must not
+ * exceed the dimension of \p A. An eigenpair whose residual norm drops
+ * below the relative tolerance of \p monitor is soft locked : its Ritz
+ * vector still takes part in the Rayleigh-Ritz procedure, but it no
+ * longer contributes a preconditioned residual or a search direction, so
+ * the applications of \p A and \p M and the order of the projected
+ * eigenproblem shrink as the eigenpairs converge.
+ *
+ * \p M is applied to one residual at a time, so any preconditioner that
+ * can be passed to \p cusp::krylov::cg may be used, in particular a
+ * \p smoothed_aggregation hierarchy that was built once and is reused
+ * across calls; each application performs a single cycle.
+ *
  * \note \p A and \p M must be symmetric.
  *
  * \see https://en.wikipedia.org/wiki/LOBPCG
@@ -119,6 +136,39 @@ void lobpcg(LinearOperator& A,
  *  }
  *  \endcode
  *
+ *  The following code snippet computes the four smallest eigenpairs of
+ *  the same problem with a \p smoothed_aggregation preconditioner.
+ *
+ *  \code
+ *  #include <cusp/csr_matrix.h>
+ *  #include <cusp/monitor.h>
+ *  #include <cusp/eigen/lobpcg.h>
+ *  #include <cusp/gallery/poisson.h>
+ *  #include <cusp/precond/aggregation/smoothed_aggregation.h>
+ *
+ *  int main(void)
+ *  {
+ *      cusp::csr_matrix<int, double, cusp::device_memory> A;
+ *      cusp::gallery::poisson5pt(A, 10, 10);
+ *
+ *      // one initial guess per wanted eigenpair
+ *      cusp::random_array<double> randx(4 * A.num_rows);
+ *      cusp::array2d<double, cusp::device_memory, cusp::column_major> X(A.num_rows, 4);
+ *      cusp::copy(randx, X.values);
+ *      cusp::array1d<double, cusp::device_memory> S;
+ *
+ *      cusp::array1d<double, cusp::device_memory> b(A.num_rows, 1);
+ *      cusp::monitor<double> monitor(b, 100, 1e-6);
+ *
+ *      // the hierarchy may be reused by later solves with the same A
+ *      cusp::precond::aggregation::smoothed_aggregation<int, double, cusp::device_memory> M(A);
+ *
+ *      cusp::eigen::lobpcg(A, S, X, monitor, M, false);
+ *
+ *      return 0;
+ *  }
+ *  \endcode
+ *
  *  \see \p monitor
  *
  */
@@ -90,7 +90,8 @@ double disks_spectral_radius(const MatrixType& A);
  * \par Overview
  * Approximates the spectral radius (D^-1)A, where D is a diagonal matrix
  * containing the diagonal entries of A. The spectral radius of (D^-1)A is
- * computed using either Lanczos or Arnoldi.
+ * computed with \p adaptive_spectral_radius using at most 8 Arnoldi
+ * steps.
  *
  * \par Example
  *  The following code snippet demonstrates how to use \p estimate_rho_Dinv_A to
@@ -121,6 +122,31 @@ double disks_spectral_radius(const MatrixType& A);
 template <typename MatrixType>
 double estimate_rho_Dinv_A(const MatrixType& A);
 
+/**
+ * \brief Approximate spectral radius of (D^-1)A from a warm start
+ *
+ * \tparam MatrixType type of a sparse or dense matrix
+ * \tparam Array1d type of the starting vector
+ *
+ * \param A matrix of the linear system
+ * \param x starting vector, replaced by the dominant Ritz vector of (D^-1)A
+ * \param tol relative agreement of two successive estimates at which the
+ * iteration stops
+ * \param maxiter maximum number of Arnoldi steps
+ *
+ * \return spectral radius approximation
+ *
+ * \par Overview
+ * Same as \p estimate_rho_Dinv_A, but the Arnoldi process starts from
+ * \p x when it has one entry per row of \p A and from a random vector
+ * otherwise. Passing the \p x returned by a previous estimate of a matrix
+ * whose values have changed slightly, as when an AMG hierarchy is rebuilt
+ * with \p update_values, usually lets the estimate stop after two or
+ * three steps.
+ */
+template <typename MatrixType, typename Array1d>
+double estimate_rho_Dinv_A(const MatrixType& A, Array1d& x, double tol = 1e-3, size_t maxiter = 8);
+
 /**
  * \brief Approximate spectral radius of A using Lanczos
  *
@@ -207,6 +233,154 @@ double estimate_spectral_radius(const MatrixType& A, size_t k = 20);
 template <typename MatrixType>
 double ritz_spectral_radius(const MatrixType& A, size_t k = 10, bool symmetric=false);
 
+/**
+ * \brief Approximate spectral radius of A using implicitly restarted Arnoldi
+ *
+ * \tparam MatrixType type of a sparse or dense matrix
+ *
+ * \param A matrix of the linear system
+ * \param maxBasis maximum number of Arnoldi vectors
+ * \param tol relative tolerance on the residual norm of the dominant
+ * Ritz value
+ *
+ * \return spectral radius approximation
+ *
+ * \par Overview
+ * Approximates the spectral radius of a real, possibly nonsymmetric,
+ * matrix as the magnitude of its dominant eigenvalue computed with
+ * \p implicitly_restarted_arnoldi. Unlike \p ritz_spectral_radius the
+ * estimate keeps improving over restarts with a basis of at most
+ * \p maxBasis vectors, which makes it reliable for nonsymmetric smoothing
+ * operators whose dominant eigenvalues are complex.
+ *
+ * \par Example
+ *  The following code snippet demonstrates how to use \p
+ *  restarted_spectral_radius to compute the spectral radius of a 16x16
+ *  Laplacian matrix.
+ *
+ *  \code
+ *  #include <cusp/csr_matrix.h>
+ *  #include <cusp/eigen/spectral_radius.h>
+ *  #include <cusp/gallery/poisson.h>
+ *
+ *  int main(void)
+ *  {
+ *      // create an empty sparse matrix structure (CSR format)
+ *      cusp::csr_matrix<int, float, cusp::device_memory> A;
+ *
+ *      // initialize matrix
+ *      cusp::gallery::poisson5pt(A, 4, 4);
+ *
+ *      // compute the spectral radius of A using at most 8 Arnoldi vectors
+ *      float rho = cusp::eigen::restarted_spectral_radius(A, 8);
+ *      std::cout << "Spectral radius of A : " << rho << std::endl;
+ *
+ *      return 0;
+ *  }
+ *  \endcode
+ */
+template <typename MatrixType>
+double restarted_spectral_radius(const MatrixType& A, size_t maxBasis = 20, double tol = 1e-4);
+
+/* \cond */
+template <typename MatrixType>
+double adaptive_spectral_radius(const MatrixType& A, double tol = 1e-3, size_t maxiter = 20);
+/* \endcond */
+
+/**
+ * \brief Approximate spectral radius of A using Arnoldi until successive
+ * estimates agree
+ *
+ * \tparam MatrixType type of a sparse or dense matrix
+ * \tparam Array1d type of the starting vector
+ *
+ * \param A matrix of the linear system
+ * \param x starting vector, replaced by the dominant Ritz vector of A
+ * \param tol relative agreement of two successive estimates at which the
+ * iteration stops
+ * \param maxiter maximum number of Arnoldi steps
+ *
+ * \return spectral radius approximation
+ *
+ * \par Overview
+ * Approximates the spectral radius of a real matrix as the magnitude of
+ * the dominant Ritz value of an Arnoldi factorization that is extended
+ * one step at a time. The iteration stops as soon as two successive
+ * estimates agree to within \p tol, when an invariant subspace is found
+ * or after \p maxiter steps, so unlike \p ritz_spectral_radius the number
+ * of matrix-vector products adapts to the matrix. The process starts from
+ * \p x when it has one entry per row of \p A and from a random vector
+ * otherwise, and on return \p x holds the dominant Ritz vector so that it
+ * can warm start a later estimate.
+ *
+ * \par Example
+ *  The following code snippet demonstrates how to use \p
+ *  adaptive_spectral_radius to compute the spectral radius of a 16x16
+ *  Laplacian matrix.
+ *
+ *  \code
+ *  #include <cusp/csr_matrix.h>
+ *  #include <cusp/eigen/spectral_radius.h>
+ *  #include <cusp/gallery/poisson.h>
+ *
+ *  int main(void)
+ *  {
+ *      // create an empty sparse matrix structure (CSR format)
+ *      cusp::csr_matrix<int, float, cusp::device_memory> A;
+ *
+ *      // initialize matrix
+ *      cusp::gallery::poisson5pt(A, 4, 4);
+ *
+ *      // compute the spectral radius of A, x receives the Ritz vector
+ *      cusp::array1d<float, cusp::device_memory> x;
+ *      float rho = cusp::eigen::adaptive_spectral_radius(A, x);
+ *
+ *      // a second estimate starts from x
+ *      rho = cusp::eigen::adaptive_spectral_radius(A, x);
+ *      std::cout << "Spectral radius of A : " << rho << std::endl;
+ *
+ *      return 0;
+ *  }
+ *  \endcode
+ */
+template <typename MatrixType, typename Array1d>
+double adaptive_spectral_radius(const MatrixType& A, Array1d& x, double tol = 1e-3, size_t maxiter = 20);
+
+/* \cond */
+template <typename MatrixType>
+double jacobi_power_spectral_radius(const MatrixType& A, double tol = 1e-3, size_t maxiter = 50);
+/* \endcond */
+
+/**
+ * \brief Approximate spectral radius of (D^-1)A using a Jacobi scaled
+ * power iteration
+ *
+ * \tparam MatrixType type of a sparse or dense matrix
+ * \tparam Array1d type of the starting vector
+ *
+ * \param A symmetric matrix with a nonnegative diagonal
+ * \param x starting vector, replaced by the last iterate
+ * \param tol relative agreement of two successive estimates at which the
+ * iteration stops
+ * \param maxiter maximum number of iterations
+ *
+ * \return spectral radius approximation
+ *
+ * \par Overview
+ * Runs the power iteration on (D^-1)A, where D is the diagonal of A, and
+ * estimates the dominant eigenvalue with the Rayleigh quotient
+ * <tt>x^T A x / x^T D x</tt>, which converges twice as fast as the
+ * iterates since \p A is symmetric. Besides the product with \p A every
+ * iteration makes one pass that forms both terms of the quotient and one
+ * pass that applies the diagonal scaling, so an iteration is cheaper than
+ * an Arnoldi step, although more iterations are needed. The iteration stops when two
+ * successive quotients agree to within \p tol. It starts from \p x when
+ * it has one entry per row of \p A and is nonzero, and on return \p x
+ * holds the last iterate so that it can warm start a later estimate.
+ */
+template <typename MatrixType, typename Array1d>
+double jacobi_power_spectral_radius(const MatrixType& A, Array1d& x, double tol = 1e-3, size_t maxiter = 50);
+
 /*! \}
  */
 
@@ -22,6 +22,8 @@
 
 #include <cusp/detail/config.h>
 
+#include <cusp/array1d.h>
+
 #include <cusp/detail/execution_policy.h>
 
 namespace cusp
@@ -215,6 +217,179 @@ template <typename MatrixType1,
 void subtract(const MatrixType1& A,
               const MatrixType2& B,
                     MatrixType3& C);
+
+/**
+ * \brief Structure of a sparse matrix sum for repeated evaluation
+ *
+ * \tparam IndexType Type used for indices (e.g. \c int).
+ * \tparam MemorySpace A memory space (e.g. \c cusp::host_memory or \c cusp::device_memory)
+ *
+ * \par Overview
+ *  An \p add_plan is produced by \p add_symbolic and records, for the
+ *  entries of \c A followed by the entries of \c B, the order in which they
+ *  are reduced and the entry of \c C each contributes to. The plan is only
+ *  valid for the sparsity patterns it was computed with.
+ */
+template <typename IndexType, typename MemorySpace>
+struct add_plan
+{
+    /*! \cond */
+    typedef IndexType   index_type;
+    typedef MemorySpace memory_space;
+    /*! \endcond */
+
+    /*! Number of entries of \c A, \c B and \c C the plan was computed for.
+     */
+    size_t A_num_entries;
+    size_t B_num_entries;
+    size_t C_num_entries;
+
+    /*! Entries of \c A and \c B in the order of \c C, the entries of \c B
+     *  are numbered after those of \c A.
+     */
+    cusp::array1d<IndexType,MemorySpace> permutation;
+
+    /*! Entry of \c C that each permuted entry is reduced into.
+     */
+    cusp::array1d<IndexType,MemorySpace> output_keys;
+
+    /*! Construct an empty \p add_plan.
+     */
+    add_plan(void)
+        : A_num_entries(0), B_num_entries(0), C_num_entries(0) {}
+};
+
+/*! \cond */
+template <typename DerivedPolicy,
+          typename MatrixType1,
+          typename MatrixType2,
+          typename MatrixType3,
+          typename PlanType>
+void add_symbolic(const thrust::detail::execution_policy_base<DerivedPolicy>& exec,
+                  const MatrixType1& A,
+                  const MatrixType2& B,
+                        MatrixType3& C,
+                        PlanType& plan);
+/*! \endcond */
+
+/**
+ * \brief Computes the sparsity pattern of a sparse matrix sum
+ *
+ * \par Overview
+ *
+ * \p add_symbolic resizes \c C to the union of the patterns of \c A and
+ * \c B with zero values and records in \p plan how the entries of \c A and
+ * \c B map into \c C. Subsequent calls to \p add_numeric evaluate
+ * <tt>C = alpha * A + beta * B</tt> for new values of \c A and \c B
+ * without merging or sorting their patterns again. Entries which cancel
+ * out are kept, so the pattern of \c C does not depend on the values.
+ *
+ * \tparam MatrixType1 Type of first matrix
+ * \tparam MatrixType2 Type of second matrix
+ * \tparam MatrixType3 Type of output matrix, \p coo_matrix or \p csr_matrix
+ * \tparam PlanType Type of \p add_plan
+ *
+ * \param A first input matrix
+ * \param B second input matrix
+ * \param C output matrix
+ * \param plan structure of the sum
+ *
+ * \par Example
+ *
+ *  The following code snippet forms the shifted operator <tt>A - sigma M</tt>
+ *  for several shifts with a single symbolic phase.
+ *
+ *  \code
+ *  #include <cusp/csr_matrix.h>
+ *  #include <cusp/elementwise.h>
+ *  #include <cusp/gallery/poisson.h>
+ *
+ *  int main(void)
+ *  {
+ *      cusp::csr_matrix<int,float,cusp::device_memory> A, M, C;
+ *      cusp::gallery::poisson5pt(A, 100, 100);
+ *      cusp::gallery::poisson9pt(M, 100, 100);
+ *
+ *      cusp::add_plan<int,cusp::device_memory> plan;
+ *      cusp::add_symbolic(A, M, C, plan);
+ *
+ *      for(int step = 1; step <= 10; step++)
+ *      {
+ *          float sigma = 0.1f * step;
+ *          cusp::add_numeric(A, M, C, plan, 1.0f, -sigma);
+ *      }
+ *
+ *      return 0;
+ *  }
+ *  \endcode
+ *
+ * \see \p add_numeric
+ */
+template <typename MatrixType1,
+          typename MatrixType2,
+          typename MatrixType3,
+          typename PlanType>
+void add_symbolic(const MatrixType1& A,
+                  const MatrixType2& B,
+                        MatrixType3& C,
+                        PlanType& plan);
+
+/*! \cond */
+template <typename DerivedPolicy,
+          typename MatrixType1,
+          typename MatrixType2,
+          typename MatrixType3,
+          typename PlanType,
+          typename ScalarType1,
+          typename ScalarType2>
+void add_numeric(const thrust::detail::execution_policy_base<DerivedPolicy>& exec,
+                 const MatrixType1& A,
+                 const MatrixType2& B,
+                       MatrixType3& C,
+                 const PlanType& plan,
+                 const ScalarType1 alpha,
+                 const ScalarType2 beta);
+/*! \endcond */
+
+/**
+ * \brief Computes the values of a scaled sparse matrix sum
+ *
+ * \par Overview
+ *
+ * \p add_numeric refills \c C.values with <tt>alpha * A + beta * B</tt>
+ * using the pattern and \p add_plan computed by \p add_symbolic. \c A and
+ * \c B must have the same patterns as in the symbolic phase, an
+ * \p invalid_input_exception is thrown if their (or C's) number of entries
+ * differs from the plan.
+ *
+ * \tparam MatrixType1 Type of first matrix
+ * \tparam MatrixType2 Type of second matrix
+ * \tparam MatrixType3 Type of output matrix, \p coo_matrix or \p csr_matrix
+ * \tparam PlanType Type of \p add_plan
+ * \tparam ScalarType1 Type of \p alpha
+ * \tparam ScalarType2 Type of \p beta
+ *
+ * \param A first input matrix
+ * \param B second input matrix
+ * \param C output matrix
+ * \param plan structure of the sum
+ * \param alpha scale factor of \c A
+ * \param beta scale factor of \c B
+ *
+ * \see \p add_symbolic
+ */
+template <typename MatrixType1,
+          typename MatrixType2,
+          typename MatrixType3,
+          typename PlanType,
+          typename ScalarType1,
+          typename ScalarType2>
+void add_numeric(const MatrixType1& A,
+                 const MatrixType2& B,
+                       MatrixType3& C,
+                 const PlanType& plan,
+                 const ScalarType1 alpha,
+                 const ScalarType2 beta);
 /*! \}
  */
 
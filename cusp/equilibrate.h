@@ -0,0 +1,201 @@
+/*
+ *  Copyright 2008-2014 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*! \file equilibrate.h
+ *  \brief Diagonal scaling and equilibration of sparse matrices
+ */
+
+#pragma once
+
+#include <cusp/detail/config.h>
+#include <cusp/detail/execution_policy.h>
+
+namespace cusp
+{
+
+/*! \addtogroup algorithms Algorithms
+ *  \ingroup algorithms
+ *  \{
+ */
+
+/*! \brief Equilibration methods of \p equilibrate
+ */
+enum equilibration_method
+{
+    jacobi_equilibration,   //!< symmetric scaling by the inverse square root of the diagonal
+    ruiz_equilibration      //!< Ruiz iteration towards unit row and column max-norms
+};
+
+/* \cond */
+template <typename DerivedPolicy,
+          typename MatrixType,
+          typename ArrayType>
+void scale_rows(const thrust::detail::execution_policy_base<DerivedPolicy> &exec,
+                      MatrixType& A,
+                const ArrayType& scale);
+
+template <typename DerivedPolicy,
+          typename MatrixType,
+          typename ArrayType>
+void scale_columns(const thrust::detail::execution_policy_base<DerivedPolicy> &exec,
+                         MatrixType& A,
+                   const ArrayType& scale);
+
+template <typename DerivedPolicy,
+          typename MatrixType,
+          typename ArrayType1,
+          typename ArrayType2>
+void equilibrate(const thrust::detail::execution_policy_base<DerivedPolicy> &exec,
+                       MatrixType& A,
+                       ArrayType1& row_scale,
+                       ArrayType2& column_scale,
+                 const equilibration_method method = ruiz_equilibration,
+                 const size_t max_sweeps = 10);
+/* \endcond */
+
+/**
+ * \brief Scale the rows of a matrix in place, <tt>A <- diag(scale) A</tt>
+ *
+ * \tparam MatrixType Type of the matrix, a \p coo_matrix, \p csr_matrix,
+ * \p ell_matrix, \p hyb_matrix or \p dia_matrix or a view of one
+ * \tparam ArrayType Type of the scaling factors
+ *
+ * \param A The matrix, its values are overwritten
+ * \param scale One factor per row
+ *
+ * \throw cusp::invalid_input_exception if \p scale has the wrong size
+ *
+ * \par Overview
+ * The values are scaled where they are stored, the pattern and the
+ * padding of \p A are not touched.
+ *
+ * \par Example
+ * \code
+ * #include <cusp/array1d.h>
+ * #include <cusp/csr_matrix.h>
+ * #include <cusp/equilibrate.h>
+ * #include <cusp/gallery/poisson.h>
+ *
+ * int main()
+ * {
+ *   cusp::csr_matrix<int,float,cusp::device_memory> A;
+ *   cusp::gallery::poisson5pt(A, 5, 5);
+ *
+ *   // halve every row
+ *   cusp::array1d<float,cusp::device_memory> scale(A.num_rows, 0.5f);
+ *   cusp::scale_rows(A, scale);
+ * }
+ * \endcode
+ */
+template <typename MatrixType,
+          typename ArrayType>
+void scale_rows(MatrixType& A,
+                const ArrayType& scale);
+
+/**
+ * \brief Scale the columns of a matrix in place, <tt>A <- A diag(scale)</tt>
+ *
+ * \tparam MatrixType Type of the matrix, see \p scale_rows
+ * \tparam ArrayType Type of the scaling factors
+ *
+ * \param A The matrix, its values are overwritten
+ * \param scale One factor per column
+ *
+ * \throw cusp::invalid_input_exception if \p scale has the wrong size
+ */
+template <typename MatrixType,
+          typename ArrayType>
+void scale_columns(MatrixType& A,
+                   const ArrayType& scale);
+
+/**
+ * \brief Equilibrate a matrix in place, <tt>A <- diag(row_scale) A diag(column_scale)</tt>
+ *
+ * \tparam MatrixType Type of the matrix, see \p scale_rows
+ * \tparam ArrayType1 Type of the row scaling factors
+ * \tparam ArrayType2 Type of the column scaling factors
+ *
+ * \param A The matrix, its values are overwritten
+ * \param row_scale On return the row scaling factors
+ * \param column_scale On return the column scaling factors
+ * \param method \p jacobi_equilibration or \p ruiz_equilibration
+ * \param max_sweeps Largest number of Ruiz sweeps
+ *
+ * \throw cusp::invalid_input_exception if \p A is not square and
+ * \p method is \p jacobi_equilibration
+ *
+ * \par Overview
+ * Jacobi equilibration scales both sides by the inverse square root of the
+ * magnitude of the diagonal, which keeps a symmetric matrix symmetric and
+ * gives a unit diagonal. Rows with a zero diagonal are left unscaled.
+ *
+ * Every Ruiz sweep divides the rows and the columns by the square roots of
+ * their largest magnitudes, which converges to a matrix whose rows and
+ * columns all have a max-norm of one. The sweeps stop once all of them
+ * lie within one percent of one. A symmetric matrix gets equal row and
+ * column factors. Empty rows and columns are left unscaled.
+ *
+ * The factors are computed on a temporary coordinate copy of the values,
+ * with row and column reductions on the device, and then applied in place
+ * as with \p scale_rows and \p scale_columns. A system <tt>A x = b</tt> is
+ * solved through the equilibrated matrix with
+ * \p cusp::krylov::equilibrated_solve.
+ *
+ * \par Example
+ * \code
+ * #include <cusp/array1d.h>
+ * #include <cusp/csr_matrix.h>
+ * #include <cusp/equilibrate.h>
+ * #include <cusp/monitor.h>
+ * #include <cusp/krylov/cg.h>
+ * #include <cusp/krylov/equilibrated_solve.h>
+ * #include <cusp/gallery/poisson.h>
+ *
+ * int main()
+ * {
+ *   cusp::csr_matrix<int,double,cusp::device_memory> A;
+ *   cusp::gallery::poisson5pt(A, 100, 100);
+ *
+ *   cusp::array1d<double,cusp::device_memory> r;
+ *   cusp::array1d<double,cusp::device_memory> c;
+ *   cusp::equilibrate(A, r, c, cusp::jacobi_equilibration);
+ *
+ *   cusp::array1d<double,cusp::device_memory> x(A.num_rows, 0);
+ *   cusp::array1d<double,cusp::device_memory> b(A.num_rows, 1);
+ *
+ *   // solves the original system through diag(r) A diag(c)
+ *   cusp::krylov::cg_solver<double,cusp::device_memory> solver(A.num_rows);
+ *   cusp::monitor<double> monitor(b, 1000, 1e-8);
+ *   cusp::identity_operator<double,cusp::device_memory> M(A.num_rows, A.num_rows);
+ *
+ *   cusp::krylov::equilibrated_solve(A, x, b, r, c, solver, monitor, M);
+ * }
+ * \endcode
+ */
+template <typename MatrixType,
+          typename ArrayType1,
+          typename ArrayType2>
+void equilibrate(MatrixType& A,
+                 ArrayType1& row_scale,
+                 ArrayType2& column_scale,
+                 const equilibration_method method = ruiz_equilibration,
+                 const size_t max_sweeps = 10);
+/*! \}
+ */
+
+} // end namespace cusp
+
+#include <cusp/detail/equilibrate.inl>
@@ -0,0 +1,293 @@
+/*
+ *  Copyright 2008-2014 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*! \file external_view.h
+ *  \brief Views of arrays and matrices in externally owned memory
+ */
+
+#pragma once
+
+#include <cusp/detail/config.h>
+
+#include <cusp/array1d.h>
+#include <cusp/array2d.h>
+#include <cusp/coo_matrix.h>
+#include <cusp/csr_matrix.h>
+#include <cusp/ell_matrix.h>
+
+#include <cstddef>
+
+namespace cusp
+{
+
+/*! \addtogroup containers Containers
+ *  \{
+ */
+
+/*! \brief Device types of a DLPack tensor accepted by the import functions.
+ */
+enum dlpack_device_type
+{
+    DLPACK_CPU          = 1,
+    DLPACK_CUDA         = 2,
+    DLPACK_CUDA_HOST    = 3,
+    DLPACK_CUDA_MANAGED = 13
+};
+
+/*! \brief Type codes of a DLPack tensor accepted by the import functions.
+ */
+enum dlpack_type_code
+{
+    DLPACK_INT     = 0,
+    DLPACK_UINT    = 1,
+    DLPACK_FLOAT   = 2,
+    DLPACK_COMPLEX = 5
+};
+
+/**
+ * \brief Wrap \p size elements at \p data in \p MemorySpace as an
+ * \p array1d_view.
+ *
+ * \tparam MemorySpace memory space of \p data (e.g. \c cusp::device_memory)
+ * \tparam T value type
+ *
+ * \param space memory space tag, e.g. <tt>cusp::device_memory()</tt>
+ * \param data first element, owned by the caller
+ * \param size number of elements
+ *
+ * \return view of the same type as <tt>cusp::array1d<T,MemorySpace>::view</tt>,
+ * or \c const_view for a pointer to const
+ *
+ * \par Overview
+ *  The functions of this header never copy or allocate: the views refer
+ *  to the caller's storage, which must outlive them. Their types are the
+ *  view types of the corresponding containers, so they are accepted by
+ *  every algorithm that accepts a view of a container, with the system
+ *  selected by \p MemorySpace.
+ *
+ * \par Example
+ *  \code
+ *  #include <cusp/external_view.h>
+ *  #include <cusp/csr_matrix.h>
+ *  #include <cusp/multiply.h>
+ *
+ *  // arrays allocated and filled by the application with cudaMalloc
+ *  void spmv(int n, int nnz, int* d_offsets, int* d_columns, float* d_values,
+ *            float* d_x, float* d_y)
+ *  {
+ *      cusp::device_memory device;
+ *
+ *      cusp::csr_matrix<int, float, cusp::device_memory>::view A =
+ *          cusp::make_csr_matrix_view(device, n, n, nnz, d_offsets, d_columns, d_values);
+ *
+ *      cusp::array1d<float, cusp::device_memory>::view x = cusp::make_array1d_view(device, d_x, n);
+ *      cusp::array1d<float, cusp::device_memory>::view y = cusp::make_array1d_view(device, d_y, n);
+ *
+ *      cusp::multiply(A, x, y);
+ *  }
+ *  \endcode
+ */
+template <typename MemorySpace, typename T>
+typename cusp::array1d<T,MemorySpace>::view
+make_array1d_view(MemorySpace space, T* data, const size_t size);
+
+/*! \cond */
+template <typename MemorySpace, typename T>
+typename cusp::array1d<T,MemorySpace>::const_view
+make_array1d_view(MemorySpace space, const T* data, const size_t size);
+/*! \endcond */
+
+/**
+ * \brief Wrap a dense matrix at \p data as an \p array2d_view.
+ *
+ * \param space memory space tag
+ * \param data first element, owned by the caller
+ * \param num_rows number of rows
+ * \param num_cols number of columns
+ * \param pitch distance between consecutive rows (\c row_major) or
+ * columns (\c column_major), in elements
+ * \param orientation \c cusp::row_major() or \c cusp::column_major()
+ */
+template <typename MemorySpace, typename T, typename Orientation>
+typename cusp::array2d<T,MemorySpace,Orientation>::view
+make_array2d_view(MemorySpace space, T* data,
+                  const size_t num_rows, const size_t num_cols, const size_t pitch,
+                  Orientation orientation);
+
+/**
+ * \brief Wrap CSR arrays as a \p csr_matrix_view.
+ *
+ * \param space memory space tag
+ * \param num_rows number of rows
+ * \param num_cols number of columns
+ * \param num_entries number of entries
+ * \param row_offsets <tt>num_rows + 1</tt> row offsets
+ * \param column_indices \p num_entries column indices
+ * \param values \p num_entries values
+ *
+ * \return view of the same type as <tt>cusp::csr_matrix<IndexType,ValueType,MemorySpace>::view</tt>,
+ * or \c const_view for pointers to const
+ */
+template <typename MemorySpace, typename IndexType, typename ValueType>
+typename cusp::csr_matrix<IndexType,ValueType,MemorySpace>::view
+make_csr_matrix_view(MemorySpace space,
+                     const size_t num_rows, const size_t num_cols, const size_t num_entries,
+                     IndexType* row_offsets, IndexType* column_indices, ValueType* values);
+
+/*! \cond */
+template <typename MemorySpace, typename IndexType, typename ValueType>
+typename cusp::csr_matrix<IndexType,ValueType,MemorySpace>::const_view
+make_csr_matrix_view(MemorySpace space,
+                     const size_t num_rows, const size_t num_cols, const size_t num_entries,
+                     const IndexType* row_offsets, const IndexType* column_indices, const ValueType* values);
+/*! \endcond */
+
+/**
+ * \brief Wrap COO arrays as a \p coo_matrix_view.
+ *
+ * \param space memory space tag
+ * \param num_rows number of rows
+ * \param num_cols number of columns
+ * \param num_entries number of entries
+ * \param row_indices \p num_entries row indices, sorted
+ * \param column_indices \p num_entries column indices
+ * \param values \p num_entries values
+ */
+template <typename MemorySpace, typename IndexType, typename ValueType>
+typename cusp::coo_matrix<IndexType,ValueType,MemorySpace>::view
+make_coo_matrix_view(MemorySpace space,
+                     const size_t num_rows, const size_t num_cols, const size_t num_entries,
+                     IndexType* row_indices, IndexType* column_indices, ValueType* values);
+
+/*! \cond */
+template <typename MemorySpace, typename IndexType, typename ValueType>
+typename cusp::coo_matrix<IndexType,ValueType,MemorySpace>::const_view
+make_coo_matrix_view(MemorySpace space,
+                     const size_t num_rows, const size_t num_cols, const size_t num_entries,
+                     const IndexType* row_indices, const IndexType* column_indices, const ValueType* values);
+/*! \endcond */
+
+/**
+ * \brief Wrap ELL arrays as an \p ell_matrix_view.
+ *
+ * \param space memory space tag
+ * \param num_rows number of rows
+ * \param num_cols number of columns
+ * \param num_entries number of stored entries
+ * \param num_entries_per_row number of columns of the ELL arrays
+ * \param pitch distance between the columns of the ELL arrays, at least
+ * \p num_rows
+ * \param column_indices <tt>pitch * num_entries_per_row</tt> column
+ * indices in column-major order, padded with
+ * <tt>cusp::ell_matrix<...>::invalid_index</tt>
+ * \param values <tt>pitch * num_entries_per_row</tt> values in
+ * column-major order
+ */
+template <typename MemorySpace, typename IndexType, typename ValueType>
+typename cusp::ell_matrix<IndexType,ValueType,MemorySpace>::view
+make_ell_matrix_view(MemorySpace space,
+                     const size_t num_rows, const size_t num_cols, const size_t num_entries,
+                     const size_t num_entries_per_row, const size_t pitch,
+                     IndexType* column_indices, ValueType* values);
+
+/*! \cond */
+template <typename MemorySpace, typename IndexType, typename ValueType>
+typename cusp::ell_matrix<IndexType,ValueType,MemorySpace>::const_view
+make_ell_matrix_view(MemorySpace space,
+                     const size_t num_rows, const size_t num_cols, const size_t num_entries,
+                     const size_t num_entries_per_row, const size_t pitch,
+                     const IndexType* column_indices, const ValueType* values);
+/*! \endcond */
+
+/**
+ * \brief Import a one-dimensional DLPack tensor as an \p array1d_view.
+ *
+ * \tparam ValueType value type of the tensor
+ * \tparam MemorySpace memory space of the tensor
+ * \tparam TensorType \c DLTensor or any type with the same members
+ *
+ * \par Overview
+ *  The tensor is described by the members \c data, \c device.device_type,
+ *  \c ndim, \c dtype (\c code, \c bits and \c lanes), \c shape, \c strides
+ *  and \c byte_offset of the DLPack \c DLTensor, so tensors exported by
+ *  other frameworks are imported without a dependency on the DLPack
+ *  header. The tensor must be contiguous, its type must match
+ *  \p ValueType, and its device type must be addressable by
+ *  \p MemorySpace: \c DLPACK_CPU or \c DLPACK_CUDA_HOST for host memory
+ *  and \c DLPACK_CUDA or \c DLPACK_CUDA_MANAGED for device memory on
+ *  CUDA. The view refers to the storage of the tensor, which must
+ *  outlive it.
+ *
+ * \throws cusp::invalid_input_exception if the tensor does not satisfy
+ * these conditions
+ *
+ * \par Example
+ *  \code
+ *  #include <cusp/external_view.h>
+ *  #include <dlpack/dlpack.h>
+ *
+ *  void scale(DLManagedTensor* t)
+ *  {
+ *      cusp::array1d<float, cusp::device_memory>::view v =
+ *          cusp::import_array1d_view<float, cusp::device_memory>(t->dl_tensor);
+ *
+ *      cusp::blas::scal(v, 2.0f);
+ *  }
+ *  \endcode
+ */
+template <typename ValueType, typename MemorySpace, typename TensorType>
+typename cusp::array1d<ValueType,MemorySpace>::view
+import_array1d_view(const TensorType& tensor);
+
+/**
+ * \brief Import a two-dimensional DLPack tensor as an \p array2d_view.
+ *
+ * \par Overview
+ *  As \p import_array1d_view, but the tensor must have two dimensions and
+ *  unit stride along the rows (\c row_major) or columns (\c column_major),
+ *  the other stride becomes the pitch of the view.
+ *
+ * \throws cusp::invalid_input_exception if the tensor does not satisfy
+ * these conditions
+ */
+template <typename ValueType, typename MemorySpace, typename Orientation, typename TensorType>
+typename cusp::array2d<ValueType,MemorySpace,Orientation>::view
+import_array2d_view(const TensorType& tensor);
+
+/**
+ * \brief Import three one-dimensional DLPack tensors as a
+ * \p csr_matrix_view.
+ *
+ * \param num_rows number of rows, \p row_offsets must have
+ * <tt>num_rows + 1</tt> elements
+ * \param num_cols number of columns
+ * \param row_offsets, column_indices, values tensors of the CSR arrays
+ *
+ * \throws cusp::invalid_input_exception if a tensor is not accepted by
+ * \p import_array1d_view or the lengths do not agree
+ */
+template <typename IndexType, typename ValueType, typename MemorySpace, typename TensorType>
+typename cusp::csr_matrix<IndexType,ValueType,MemorySpace>::view
+import_csr_matrix_view(const size_t num_rows, const size_t num_cols,
+                       const TensorType& row_offsets,
+                       const TensorType& column_indices,
+                       const TensorType& values);
+/*! \}
+ */
+
+} // end namespace cusp
+
+#include <cusp/detail/external_view.inl>
@@ -39,7 +39,6 @@ void diffusion(MatrixType& matrix,
 {
     typedef typename MatrixType::index_type       IndexType;
     typedef typename MatrixType::value_type       ValueType;
-    typedef typename MatrixType::memory_space     MemorySpace;
     typedef thrust::tuple<IndexType,IndexType>    StencilIndex;
     typedef thrust::tuple<StencilIndex,ValueType> StencilPoint;
 
@@ -82,7 +81,7 @@ void diffusion(MatrixType& matrix,
         throw cusp::invalid_input_exception("unrecognized discretization method");
     }
 
-    cusp::array1d<StencilPoint, MemorySpace> stencil;
+    cusp::array1d<StencilPoint, cusp::host_memory> stencil;
 
     stencil.push_back(StencilPoint(StencilIndex( -1, -1), a));
     stencil.push_back(StencilPoint(StencilIndex(  0, -1), b));
@@ -19,8 +19,22 @@
 #include <cusp/detail/config.h>
 
 #include <cusp/coo_matrix.h>
-#include <thrust/unique.h>
+#include <cusp/convert.h>
+#include <cusp/exception.h>
+#include <cusp/format_utils.h>
+#include <cusp/iterator/random_iterator.h>
+
+#include <thrust/fill.h>
+#include <thrust/scan.h>
 #include <thrust/sort.h>
+#include <thrust/transform.h>
+#include <thrust/unique.h>
+
+#include <thrust/iterator/counting_iterator.h>
+#include <thrust/iterator/zip_iterator.h>
+
+#include <algorithm>
+#include <cmath>
 
 #include <stdlib.h> // XXX remove when we switch RNGs
 
@@ -29,6 +43,201 @@ namespace cusp
 namespace gallery
 {
 
+namespace detail
+{
+
+// counter-based generator, draw i of a given seed is a hash of i
+struct random_draw
+{
+    cusp::detail::random_integer_functor<unsigned long long,unsigned long long> hash;
+
+    random_draw(const size_t seed) : hash(seed) {}
+
+    __host__ __device__
+    unsigned long long integer(const unsigned long long i) const
+    {
+        return hash(i);
+    }
+
+    // uniform in [0,1)
+    __host__ __device__
+    double uniform(const unsigned long long i) const
+    {
+        return double(hash(i) >> 11) * (1.0 / 9007199254740992.0);
+    }
+};
+
+// columns within bandwidth of the scaled diagonal, empty when not banded
+struct random_band
+{
+    size_t num_rows;
+    size_t num_cols;
+    size_t bandwidth;
+    bool   banded;
+
+    random_band(const size_t num_rows, const size_t num_cols, const size_t bandwidth, const bool banded)
+        : num_rows(num_rows), num_cols(num_cols), bandwidth(bandwidth), banded(banded) {}
+
+    __host__ __device__
+    size_t first(const size_t row) const
+    {
+        const size_t center = (unsigned long long) row * num_cols / num_rows;
+        return center > bandwidth ? center - bandwidth : 0;
+    }
+
+    __host__ __device__
+    size_t length(const size_t row) const
+    {
+        if (!banded)
+            return 0;
+
+        const size_t center = (unsigned long long) row * num_cols / num_rows;
+        const size_t last   = center + bandwidth < num_cols ? center + bandwidth : num_cols - 1;
+
+        return last - first(row) + 1;
+    }
+};
+
+template <typename IndexType>
+struct power_law_row_length : public thrust::unary_function<IndexType,IndexType>
+{
+    random_draw draw;
+    double min_length;
+    double max_length;
+    double exponent;
+
+    power_law_row_length(const size_t seed, const size_t min_length, const size_t max_length, const double alpha)
+        : draw(seed), min_length(min_length), max_length(max_length), exponent(-1.0 / (alpha - 1.0)) {}
+
+    __host__ __device__
+    IndexType operator()(const IndexType row) const
+    {
+        // inverse transform sampling of the Pareto distribution
+        const double length = min_length * pow(1.0 - draw.uniform(row), exponent);
+
+        return length < max_length ? IndexType(length) : IndexType(max_length);
+    }
+};
+
+template <typename IndexType>
+struct bimodal_row_length : public thrust::unary_function<IndexType,IndexType>
+{
+    random_draw draw;
+    IndexType short_length;
+    IndexType long_length;
+    double long_fraction;
+
+    bimodal_row_length(const size_t seed, const size_t short_length, const size_t long_length, const double long_fraction)
+        : draw(seed), short_length(short_length), long_length(long_length), long_fraction(long_fraction) {}
+
+    __host__ __device__
+    IndexType operator()(const IndexType row) const
+    {
+        return draw.uniform(row) < long_fraction ? long_length : short_length;
+    }
+};
+
+template <typename IndexType>
+struct banded_row_length : public thrust::unary_function<IndexType,IndexType>
+{
+    random_band band;
+    IndexType noise;
+
+    banded_row_length(const random_band& band, const size_t noise)
+        : band(band), noise(noise) {}
+
+    __host__ __device__
+    IndexType operator()(const IndexType row) const
+    {
+        return band.length(row) + noise;
+    }
+};
+
+// the leading entries of each row fill its band, the rest are random columns
+template <typename IndexType>
+struct random_column
+{
+    random_draw draw;
+    random_band band;
+    const IndexType * row_offsets;
+
+    random_column(const size_t seed, const random_band& band, const IndexType * row_offsets)
+        : draw(seed), band(band), row_offsets(row_offsets) {}
+
+    template <typename Tuple>
+    __host__ __device__
+    IndexType operator()(const Tuple& t) const
+    {
+        const IndexType row  = thrust::get<0>(t);
+        const IndexType n    = thrust::get<1>(t);
+        const size_t    rank = n - row_offsets[row];
+
+        if (rank < band.length(row))
+            return band.first(row) + rank;
+        else
+            return draw.integer(n) % band.num_cols;
+    }
+};
+
+template <typename MatrixType, typename RowLengthFunctor>
+void random_rows(MatrixType& matrix,
+                 const size_t num_rows,
+                 const size_t num_cols,
+                 const RowLengthFunctor& row_length,
+                 const random_band& band,
+                 const size_t seed)
+{
+    typedef typename MatrixType::index_type   IndexType;
+    typedef typename MatrixType::value_type   ValueType;
+    typedef typename MatrixType::memory_space MemorySpace;
+
+    cusp::coo_matrix<IndexType,ValueType,MemorySpace> coo(num_rows, num_cols, 0);
+
+    if (num_rows == 0 || num_cols == 0)
+    {
+        cusp::convert(coo, matrix);
+        return;
+    }
+
+    cusp::array1d<IndexType,MemorySpace> row_offsets(num_rows + 1);
+
+    thrust::fill(row_offsets.begin(), row_offsets.begin() + 1, IndexType(0));
+    thrust::transform(thrust::counting_iterator<IndexType>(0),
+                      thrust::counting_iterator<IndexType>(num_rows),
+                      row_offsets.begin() + 1,
+                      row_length);
+    thrust::inclusive_scan(row_offsets.begin(), row_offsets.end(), row_offsets.begin());
+
+    const size_t num_samples = row_offsets[num_rows];
+
+    coo.resize(num_rows, num_cols, num_samples);
+
+    if (num_samples > 0)
+    {
+        cusp::offsets_to_indices(row_offsets, coo.row_indices);
+
+        // the columns draw from a different sequence than the row lengths
+        thrust::transform(thrust::make_zip_iterator(thrust::make_tuple(coo.row_indices.begin(), thrust::counting_iterator<IndexType>(0))),
+                          thrust::make_zip_iterator(thrust::make_tuple(coo.row_indices.end(),   thrust::counting_iterator<IndexType>(num_samples))),
+                          coo.column_indices.begin(),
+                          random_column<IndexType>(~seed, band, thrust::raw_pointer_cast(&row_offsets[0])));
+        thrust::fill(coo.values.begin(), coo.values.end(), ValueType(1));
+
+        // the rows are already ordered, only the columns within them need sorting
+        coo.sort_by_row_and_column();
+
+        size_t num_entries = thrust::unique(thrust::make_zip_iterator(thrust::make_tuple(coo.row_indices.begin(), coo.column_indices.begin())),
+                                            thrust::make_zip_iterator(thrust::make_tuple(coo.row_indices.end(),   coo.column_indices.end())))
+                             - thrust::make_zip_iterator(thrust::make_tuple(coo.row_indices.begin(), coo.column_indices.begin()));
+
+        coo.resize(num_rows, num_cols, num_entries);
+    }
+
+    cusp::convert(coo, matrix);
+}
+
+} // end namespace detail
+
 template <typename MatrixType>
 void random(MatrixType& matrix,
             const size_t m,
@@ -61,6 +270,73 @@ void random(MatrixType& matrix,
     matrix = coo;
 }
 
+template <typename MatrixType>
+void random_power_law(MatrixType& matrix,
+                      const size_t num_rows,
+                      const size_t num_cols,
+                      const size_t min_entries_per_row,
+                      const size_t max_entries_per_row,
+                      const double alpha,
+                      const size_t seed)
+{
+    typedef typename MatrixType::index_type IndexType;
+
+    if (alpha <= 1.0)
+        throw cusp::invalid_input_exception("power-law exponent must be greater than one");
+
+    if (min_entries_per_row > max_entries_per_row)
+        throw cusp::invalid_input_exception("min_entries_per_row exceeds max_entries_per_row");
+
+    const size_t max_length = std::min(max_entries_per_row, num_cols);
+    const size_t min_length = std::min(min_entries_per_row, max_length);
+
+    detail::random_rows(matrix, num_rows, num_cols,
+                        detail::power_law_row_length<IndexType>(seed, min_length, max_length, alpha),
+                        detail::random_band(num_rows, num_cols, 0, false),
+                        seed);
+}
+
+template <typename MatrixType>
+void random_bimodal(MatrixType& matrix,
+                    const size_t num_rows,
+                    const size_t num_cols,
+                    const size_t short_row_length,
+                    const size_t long_row_length,
+                    const double long_row_fraction,
+                    const size_t seed)
+{
+    typedef typename MatrixType::index_type IndexType;
+
+    if (long_row_fraction < 0.0 || long_row_fraction > 1.0)
+        throw cusp::invalid_input_exception("long_row_fraction must lie in [0,1]");
+
+    detail::random_rows(matrix, num_rows, num_cols,
+                        detail::bimodal_row_length<IndexType>(seed,
+                                                              std::min(short_row_length, num_cols),
+                                                              std::min(long_row_length, num_cols),
+                                                              long_row_fraction),
+                        detail::random_band(num_rows, num_cols, 0, false),
+                        seed);
+}
+
+template <typename MatrixType>
+void random_banded(MatrixType& matrix,
+                   const size_t num_rows,
+                   const size_t num_cols,
+                   const size_t bandwidth,
+                   const size_t noise_per_row,
+                   const size_t seed)
+{
+    typedef typename MatrixType::index_type IndexType;
+
+    detail::random_band band(num_rows, num_cols, bandwidth, true);
+
+    detail::random_rows(matrix, num_rows, num_cols,
+                        detail::banded_row_length<IndexType>(band, noise_per_row),
+                        band,
+                        seed);
+}
+
 } // end namespace gallery
 } // end namespace cusp
 
@@ -14,14 +14,20 @@
  *  limitations under the License.
  */
 
+#include <cusp/convert.h>
 #include <cusp/copy.h>
+#include <cusp/csr_matrix.h>
 #include <cusp/dia_matrix.h>
 
 #include <thrust/tuple.h>
 #include <thrust/reduce.h>
 #include <thrust/scan.h>
 #include <thrust/count.h>
+#include <thrust/for_each.h>
 #include <thrust/functional.h>
+#include <thrust/sequence.h>
+#include <thrust/sort.h>
+#include <thrust/transform.h>
 
 namespace cusp
 {
@@ -133,43 +139,170 @@ struct fill_diagonal_entries
     }
 };
 
-} // end namespace detail
+// flattened stencil whose arrays reside in the memory space of the matrix,
+// the displacements of point p are displacements[p * Dims, (p + 1) * Dims)
+template <typename IndexType, typename ValueType, int Dims>
+struct stencil_rows
+{
+    IndexType grid[Dims];
+    IndexType num_points;
+    const IndexType * displacements;
+    const IndexType * offsets;
+    const ValueType * coefficients;
 
-template <typename IndexType,
-          typename ValueType,
-          typename MemorySpace,
-          typename StencilPoint,
-          typename GridDimension>
-void generate_matrix_from_stencil(cusp::dia_matrix<IndexType,ValueType,MemorySpace>& matrix,
-                                  const cusp::array1d<StencilPoint,MemorySpace>& stencil,
-                                  const GridDimension& grid)
+    // true if point p of the stencil centered at row is a nonzero
+    __host__ __device__
+    bool contributes(const IndexType * coords, const IndexType p) const
+    {
+        if (coefficients[p] == ValueType(0))
+            return false;
+
+        for (int d = 0; d < Dims; d++)
+        {
+            const IndexType c = coords[d] + displacements[p * Dims + d];
+
+            if (c < 0 || c >= grid[d])
+                return false;
+        }
+
+        return true;
+    }
+
+    __host__ __device__
+    void coordinates(IndexType row, IndexType * coords) const
+    {
+        for (int d = 0; d < Dims; d++)
+        {
+            coords[d] = row % grid[d];
+            row /= grid[d];
+        }
+    }
+};
+
+template <typename IndexType, typename ValueType, int Dims>
+struct count_stencil_entries : public thrust::unary_function<IndexType,IndexType>
 {
-    IndexType num_dimensions = thrust::tuple_size<GridDimension>::value;
+    stencil_rows<IndexType,ValueType,Dims> rows;
+
+    count_stencil_entries(const stencil_rows<IndexType,ValueType,Dims>& rows)
+        : rows(rows) {}
+
+    __host__ __device__
+    IndexType operator()(const IndexType row) const
+    {
+        IndexType coords[Dims];
+        rows.coordinates(row, coords);
+
+        IndexType count = 0;
 
-    cusp::array1d<IndexType,MemorySpace> grid_indices(num_dimensions);
-    detail::unpack_tuple(grid, grid_indices.begin());
+        for (IndexType p = 0; p < rows.num_points; p++)
+            if (rows.contributes(coords, p))
+                count++;
 
-    IndexType num_rows = thrust::reduce(grid_indices.begin(), grid_indices.end(), IndexType(1), thrust::multiplies<IndexType>());
+        return count;
+    }
+};
 
-    IndexType num_diagonals = stencil.size();
+template <typename IndexType, typename ValueType, int Dims>
+struct fill_stencil_entries
+{
+    stencil_rows<IndexType,ValueType,Dims> rows;
+    const IndexType * row_offsets;
+    IndexType * column_indices;
+    ValueType * values;
 
-    cusp::array1d<IndexType,MemorySpace> strides(grid_indices.size());
-    thrust::exclusive_scan(grid_indices.begin(), grid_indices.end(), strides.begin(), IndexType(1), thrust::multiplies<IndexType>());
+    fill_stencil_entries(const stencil_rows<IndexType,ValueType,Dims>& rows,
+                         const IndexType * row_offsets, IndexType * column_indices, ValueType * values)
+        : rows(rows), row_offsets(row_offsets), column_indices(column_indices), values(values) {}
+
+    __host__ __device__
+    void operator()(const IndexType row) const
+    {
+        IndexType coords[Dims];
+        rows.coordinates(row, coords);
+
+        IndexType n = row_offsets[row];
+
+        // the points are sorted by offset, so the columns come out sorted
+        for (IndexType p = 0; p < rows.num_points; p++)
+        {
+            if (rows.contributes(coords, p))
+            {
+                column_indices[n] = row + rows.offsets[p];
+                values[n]         = rows.coefficients[p];
+                n++;
+            }
+        }
+    }
+};
+
+// copies the stencil to the host and linearizes the displacement of every
+// point into an offset in the grid whose first dimension varies fastest
+template <typename IndexType, typename ValueType, typename StencilPoint, typename MemorySpace, typename GridDimension>
+size_t unpack_stencil(const cusp::array1d<StencilPoint,MemorySpace>& stencil,
+                      const GridDimension& grid,
+                      IndexType * grid_sizes,
+                      cusp::array1d<IndexType,cusp::host_memory>& displacements,
+                      cusp::array1d<IndexType,cusp::host_memory>& offsets,
+                      cusp::array1d<ValueType,cusp::host_memory>& coefficients)
+{
+    const int num_dimensions = thrust::tuple_size<GridDimension>::value;
+    const size_t num_points  = stencil.size();
 
-    cusp::array1d<IndexType,MemorySpace> offsets(stencil.size(), 0);
     cusp::array1d<StencilPoint,cusp::host_memory> stencil_host(stencil);
 
-    for(size_t i = 0; i < offsets.size(); i++)
+    unpack_tuple(grid, grid_sizes);
+
+    displacements.resize(num_points * num_dimensions);
+    offsets.resize(num_points);
+    coefficients.resize(num_points);
+
+    size_t num_rows = 1;
+    for (int d = 0; d < num_dimensions; d++)
+        num_rows *= grid_sizes[d];
+
+    for (size_t i = 0; i < num_points; i++)
     {
-        cusp::array1d<IndexType,MemorySpace> stencil_indices(num_dimensions);
-        detail::unpack_tuple(thrust::get<0>(stencil_host[i]), stencil_indices.begin());
+        unpack_tuple(thrust::get<0>(stencil_host[i]), displacements.begin() + i * num_dimensions);
+        coefficients[i] = thrust::get<1>(stencil_host[i]);
 
-        for(IndexType j = 0; j < num_dimensions; j++)
+        IndexType stride = 1;
+        offsets[i] = 0;
+
+        for (int d = 0; d < num_dimensions; d++)
         {
-            offsets[i] += strides[j] * stencil_indices[j];
+            offsets[i] += stride * displacements[i * num_dimensions + d];
+            stride *= grid_sizes[d];
         }
     }
 
+    return num_rows;
+}
+
+} // end namespace detail
+
+template <typename IndexType,
+          typename ValueType,
+          typename MemorySpace1,
+          typename StencilPoint,
+          typename MemorySpace2,
+          typename GridDimension>
+void generate_matrix_from_stencil(cusp::dia_matrix<IndexType,ValueType,MemorySpace1>& matrix,
+                                  const cusp::array1d<StencilPoint,MemorySpace2>& stencil,
+                                  const GridDimension& grid)
+{
+    const int num_dimensions = thrust::tuple_size<GridDimension>::value;
+
+    IndexType grid_sizes[num_dimensions];
+    cusp::array1d<IndexType,cusp::host_memory> displacements;
+    cusp::array1d<IndexType,cusp::host_memory> offsets;
+    cusp::array1d<ValueType,cusp::host_memory> coefficients;
+
+    const IndexType num_rows      = detail::unpack_stencil(stencil, grid, grid_sizes, displacements, offsets, coefficients);
+    const IndexType num_diagonals = stencil.size();
+
+    cusp::array1d<StencilPoint,cusp::host_memory> stencil_host(stencil);
+
     // TODO compute num_entries directly from stencil
     matrix.resize(num_rows, num_rows, 0, num_diagonals); // XXX we set NNZ to zero for now
 
@@ -181,13 +314,91 @@ void generate_matrix_from_stencil(cusp::dia_matrix<IndexType,ValueType,MemorySpa
         thrust::transform(thrust::counting_iterator<IndexType>(0),
                           thrust::counting_iterator<IndexType>(num_rows),
                           matrix.values.values.begin() + matrix.values.pitch * i,
-                          detail::fill_diagonal_entries<IndexType,ValueType,StencilPoint,GridDimension>(stencil[i], grid));
+                          detail::fill_diagonal_entries<IndexType,ValueType,StencilPoint,GridDimension>(stencil_host[i], grid));
     }
 
     matrix.num_entries = matrix.values.values.size() - thrust::count(matrix.values.values.begin(), matrix.values.values.end(), ValueType(0));
 }
 
-// TODO add an entry point and make this the default path
+// the rows are counted and filled independently in the memory space of the
+// matrix, no intermediate format is built
+template <typename IndexType,
+          typename ValueType,
+          typename MemorySpace1,
+          typename StencilPoint,
+          typename MemorySpace2,
+          typename GridDimension>
+void generate_matrix_from_stencil(cusp::csr_matrix<IndexType,ValueType,MemorySpace1>& matrix,
+                                  const cusp::array1d<StencilPoint,MemorySpace2>& stencil,
+                                  const GridDimension& grid)
+{
+    const int num_dimensions = thrust::tuple_size<GridDimension>::value;
+
+    IndexType grid_sizes[num_dimensions];
+    cusp::array1d<IndexType,cusp::host_memory> displacements;
+    cusp::array1d<IndexType,cusp::host_memory> offsets;
+    cusp::array1d<ValueType,cusp::host_memory> coefficients;
+
+    const IndexType num_rows   = detail::unpack_stencil(stencil, grid, grid_sizes, displacements, offsets, coefficients);
+    const IndexType num_points = stencil.size();
+
+    // order the points by offset to produce sorted column indices
+    cusp::array1d<IndexType,cusp::host_memory> permutation(num_points);
+    thrust::sequence(permutation.begin(), permutation.end());
+    thrust::stable_sort_by_key(offsets.begin(), offsets.end(), permutation.begin());
+
+    cusp::array1d<IndexType,cusp::host_memory> sorted_displacements(displacements.size());
+    cusp::array1d<ValueType,cusp::host_memory> sorted_coefficients(num_points);
+
+    for(IndexType i = 0; i < num_points; i++)
+    {
+        for(int d = 0; d < num_dimensions; d++)
+            sorted_displacements[i * num_dimensions + d] = displacements[permutation[i] * num_dimensions + d];
+
+        sorted_coefficients[i] = coefficients[permutation[i]];
+    }
+
+    cusp::array1d<IndexType,MemorySpace1> point_displacements(sorted_displacements);
+    cusp::array1d<IndexType,MemorySpace1> point_offsets(offsets);
+    cusp::array1d<ValueType,MemorySpace1> point_coefficients(sorted_coefficients);
+
+    detail::stencil_rows<IndexType,ValueType,num_dimensions> rows;
+
+    for(int d = 0; d < num_dimensions; d++)
+        rows.grid[d] = grid_sizes[d];
+
+    rows.num_points    = num_points;
+    rows.displacements = num_points == 0 ? NULL : thrust::raw_pointer_cast(&point_displacements[0]);
+    rows.offsets       = num_points == 0 ? NULL : thrust::raw_pointer_cast(&point_offsets[0]);
+    rows.coefficients  = num_points == 0 ? NULL : thrust::raw_pointer_cast(&point_coefficients[0]);
+
+    // row_offsets[i + 1] holds the length of row i before the scan
+    matrix.resize(num_rows, num_rows, 0, cusp::no_init);
+
+    thrust::fill(matrix.row_offsets.begin(), matrix.row_offsets.begin() + 1, IndexType(0));
+    thrust::transform(thrust::counting_iterator<IndexType>(0),
+                      thrust::counting_iterator<IndexType>(num_rows),
+                      matrix.row_offsets.begin() + 1,
+                      detail::count_stencil_entries<IndexType,ValueType,num_dimensions>(rows));
+    thrust::inclusive_scan(matrix.row_offsets.begin(), matrix.row_offsets.end(), matrix.row_offsets.begin());
+
+    const IndexType num_entries = matrix.row_offsets[num_rows];
+
+    // resizing keeps the row offsets, every entry is written below
+    matrix.resize(num_rows, num_rows, num_entries, cusp::no_init);
+
+    if(num_entries == 0)
+        return;
+
+    thrust::for_each(thrust::counting_iterator<IndexType>(0),
+                     thrust::counting_iterator<IndexType>(num_rows),
+                     detail::fill_stencil_entries<IndexType,ValueType,num_dimensions>(rows,
+                                                                                      thrust::raw_pointer_cast(&matrix.row_offsets[0]),
+                                                                                      thrust::raw_pointer_cast(&matrix.column_indices[0]),
+                                                                                      thrust::raw_pointer_cast(&matrix.values[0])));
+}
+
+// other formats are converted from a csr_matrix in their memory space
 template <typename MatrixType,
           typename StencilPoint,
           typename MemorySpace,
@@ -198,11 +409,12 @@ void generate_matrix_from_stencil(MatrixType& matrix,
 {
     typedef typename MatrixType::index_type   IndexType;
     typedef typename MatrixType::value_type   ValueType;
+    typedef typename MatrixType::memory_space MemorySpace2;
 
-    cusp::dia_matrix<IndexType,ValueType,MemorySpace> dia;
-    generate_matrix_from_stencil(dia, stencil, grid);
+    cusp::csr_matrix<IndexType,ValueType,MemorySpace2> csr;
+    generate_matrix_from_stencil(csr, stencil, grid);
 
-    cusp::convert(dia, matrix);
+    cusp::move_convert(csr, matrix);
 }
 
 } // end namespace gallery
@@ -67,6 +67,101 @@ void random(MatrixType& matrix,
             const size_t m,
             const size_t n,
             const size_t num_samples);
+
+/*! \p random_power_law: Create a matrix whose row lengths follow a
+ * power-law (Pareto) distribution
+ *
+ * The length of every row is drawn independently from a Pareto distribution
+ * with exponent \p alpha whose smallest value is \p min_entries_per_row,
+ * clamped to \p max_entries_per_row. The column indices are uniformly
+ * distributed and duplicates are merged, so a row may end up shorter than
+ * its drawn length. The matrix is generated in parallel in the memory space
+ * of \p matrix with a counter-based random number generator, so the result
+ * depends only on the arguments and \p seed.
+ *
+ * \param matrix output
+ * \param num_rows number of rows
+ * \param num_cols number of columns
+ * \param min_entries_per_row shortest row length
+ * \param max_entries_per_row longest row length
+ * \param alpha exponent of the distribution, must be greater than one
+ * \param seed seed of the random sequence
+ * \tparam MatrixType matrix container
+ *
+ * \code
+ * #include <cusp/gallery/random.h>
+ * #include <cusp/csr_matrix.h>
+ * #include <cusp/print.h>
+ *
+ * int main(void)
+ * {
+ *     cusp::csr_matrix<int, float, cusp::device_memory> A;
+ *
+ *     // create a 1000x1000 matrix with between 2 and 500 entries per row
+ *     cusp::gallery::random_power_law(A, 1000, 1000, 2, 500, 2.0);
+ *
+ *     // print matrix
+ *     cusp::print(A);
+ *
+ *     return 0;
+ * }
+ * \endcode
+ */
+template <typename MatrixType>
+void random_power_law(MatrixType& matrix,
+                      const size_t num_rows,
+                      const size_t num_cols,
+                      const size_t min_entries_per_row,
+                      const size_t max_entries_per_row,
+                      const double alpha,
+                      const size_t seed = 0);
+
+/*! \p random_bimodal: Create a matrix with a mix of short and long rows
+ *
+ * Every row independently has \p long_row_length entries with probability
+ * \p long_row_fraction and \p short_row_length entries otherwise. The
+ * column indices are uniformly distributed and duplicates are merged.
+ *
+ * \param matrix output
+ * \param num_rows number of rows
+ * \param num_cols number of columns
+ * \param short_row_length length of the short rows
+ * \param long_row_length length of the long rows
+ * \param long_row_fraction probability that a row is long
+ * \param seed seed of the random sequence
+ * \tparam MatrixType matrix container
+ */
+template <typename MatrixType>
+void random_bimodal(MatrixType& matrix,
+                    const size_t num_rows,
+                    const size_t num_cols,
+                    const size_t short_row_length,
+                    const size_t long_row_length,
+                    const double long_row_fraction,
+                    const size_t seed = 0);
+
+/*! \p random_banded: Create a banded matrix with random entries outside
+ * the band
+ *
+ * Row \c i holds every column within \p bandwidth of its scaled diagonal
+ * \c i*num_cols/num_rows plus \p noise_per_row uniformly distributed
+ * columns. Duplicates are merged.
+ *
+ * \param matrix output
+ * \param num_rows number of rows
+ * \param num_cols number of columns
+ * \param bandwidth half width of the band
+ * \param noise_per_row number of random entries in every row
+ * \param seed seed of the random sequence
+ * \tparam MatrixType matrix container
+ */
+template <typename MatrixType>
+void random_banded(MatrixType& matrix,
+                   const size_t num_rows,
+                   const size_t num_cols,
+                   const size_t bandwidth,
+                   const size_t noise_per_row,
+                   const size_t seed = 0);
 /*! \}
  */
 
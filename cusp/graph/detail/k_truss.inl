@@ -0,0 +1,58 @@
+/*
+ *  Copyright 2008-2014 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include <cusp/detail/config.h>
+#include <thrust/system/detail/generic/select_system.h>
+
+#include <cusp/system/detail/generic/graph/k_truss.h>
+
+namespace cusp
+{
+namespace graph
+{
+
+template <typename DerivedPolicy,
+          typename MatrixType1,
+          typename MatrixType2>
+size_t k_truss(const thrust::detail::execution_policy_base<DerivedPolicy>& exec,
+               const MatrixType1& G,
+               const size_t k,
+                     MatrixType2& T)
+{
+    using cusp::system::detail::generic::k_truss;
+
+    return k_truss(thrust::detail::derived_cast(thrust::detail::strip_const(exec)), G, k, T);
+}
+
+template <typename MatrixType1,
+          typename MatrixType2>
+size_t k_truss(const MatrixType1& G,
+               const size_t k,
+                     MatrixType2& T)
+{
+    using thrust::system::detail::generic::select_system;
+
+    typedef typename MatrixType1::memory_space System1;
+    typedef typename MatrixType2::memory_space System2;
+
+    System1 system1;
+    System2 system2;
+
+    return cusp::graph::k_truss(select_system(system1,system2), G, k, T);
+}
+
+} // end namespace graph
+} // end namespace cusp
@@ -0,0 +1,92 @@
+/*
+ *  Copyright 2008-2014 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include <cusp/detail/config.h>
+#include <thrust/system/detail/generic/select_system.h>
+
+#include <cusp/system/detail/generic/graph/multi_source_bfs.h>
+
+namespace cusp
+{
+namespace graph
+{
+
+template <typename DerivedPolicy,
+          typename MatrixType,
+          typename ArrayType1,
+          typename ArrayType2>
+void multi_source_bfs(const thrust::detail::execution_policy_base<DerivedPolicy>& exec,
+                      const MatrixType& G,
+                      const ArrayType1& sources,
+                            ArrayType2& distances)
+{
+    using cusp::system::detail::generic::multi_source_bfs;
+
+    multi_source_bfs(thrust::detail::derived_cast(thrust::detail::strip_const(exec)), G, sources, distances);
+}
+
+template <typename MatrixType,
+          typename ArrayType1,
+          typename ArrayType2>
+void multi_source_bfs(const MatrixType& G,
+                      const ArrayType1& sources,
+                            ArrayType2& distances)
+{
+    using thrust::system::detail::generic::select_system;
+
+    typedef typename MatrixType::memory_space System1;
+    typedef typename ArrayType2::memory_space System2;
+
+    System1 system1;
+    System2 system2;
+
+    cusp::graph::multi_source_bfs(select_system(system1,system2), G, sources, distances);
+}
+
+template <typename DerivedPolicy,
+          typename MatrixType,
+          typename ArrayType1,
+          typename ArrayType2>
+void multi_source_eccentricity(const thrust::detail::execution_policy_base<DerivedPolicy>& exec,
+                               const MatrixType& G,
+                               const ArrayType1& sources,
+                                     ArrayType2& eccentricities)
+{
+    using cusp::system::detail::generic::multi_source_eccentricity;
+
+    multi_source_eccentricity(thrust::detail::derived_cast(thrust::detail::strip_const(exec)), G, sources, eccentricities);
+}
+
+template <typename MatrixType,
+          typename ArrayType1,
+          typename ArrayType2>
+void multi_source_eccentricity(const MatrixType& G,
+                               const ArrayType1& sources,
+                                     ArrayType2& eccentricities)
+{
+    using thrust::system::detail::generic::select_system;
+
+    typedef typename MatrixType::memory_space System1;
+    typedef typename ArrayType2::memory_space System2;
+
+    System1 system1;
+    System2 system2;
+
+    cusp::graph::multi_source_eccentricity(select_system(system1,system2), G, sources, eccentricities);
+}
+
+} // end namespace graph
+} // end namespace cusp
@@ -0,0 +1,163 @@
+/*
+ *  Copyright 2008-2014 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+
+#include <cusp/detail/config.h>
+#include <thrust/system/detail/generic/select_system.h>
+
+#include <cusp/array2d.h>
+#include <cusp/exception.h>
+
+#include <cusp/graph/hilbert_curve.h>
+#include <cusp/graph/symmetric_rcm.h>
+
+#include <thrust/extrema.h>
+#include <thrust/transform.h>
+
+namespace cusp
+{
+namespace graph
+{
+namespace detail
+{
+
+template <typename ValueType>
+struct scale_to_unit
+{
+    const ValueType lower;
+    const ValueType scale;
+
+    scale_to_unit(const ValueType lower, const ValueType scale)
+        : lower(lower), scale(scale) {}
+
+    __host__ __device__
+    ValueType operator()(const ValueType x) const
+    {
+        return (x - lower) * scale;
+    }
+};
+
+} // end namespace detail
+
+template <typename DerivedPolicy,
+          typename MatrixType1,
+          typename MatrixType2,
+          typename PermutationType>
+void optimize_layout(const thrust::detail::execution_policy_base<DerivedPolicy>& exec,
+                     const MatrixType1& A,
+                           MatrixType2& B,
+                           PermutationType& P)
+{
+    if(A.num_rows != A.num_cols)
+        throw cusp::invalid_input_exception("matrix must be square");
+
+    P.resize(A.num_rows);
+
+    cusp::graph::symmetric_rcm(exec, A, P);
+
+    B = A;
+    P.symmetric_permute(B);
+}
+
+template <typename DerivedPolicy,
+          typename MatrixType1,
+          typename Array2dType,
+          typename MatrixType2,
+          typename PermutationType>
+void optimize_layout(const thrust::detail::execution_policy_base<DerivedPolicy>& exec,
+                     const MatrixType1& A,
+                     const Array2dType& coord,
+                           MatrixType2& B,
+                           PermutationType& P)
+{
+    typedef typename Array2dType::value_type   ValueType;
+    typedef typename Array2dType::memory_space MemorySpace;
+    typedef typename cusp::array2d<ValueType,MemorySpace,cusp::column_major>::column_view::iterator Iterator;
+
+    if(A.num_rows != A.num_cols)
+        throw cusp::invalid_input_exception("matrix must be square");
+
+    if(coord.num_rows != A.num_rows)
+        throw cusp::invalid_input_exception("number of coordinates must match the matrix dimensions");
+
+    // hilbert_curve requires coordinates in the unit box
+    cusp::array2d<ValueType,MemorySpace,cusp::column_major> unit_coord(coord);
+
+    for(size_t i = 0; i < unit_coord.num_cols; i++)
+    {
+        thrust::pair<Iterator,Iterator> bounds =
+            thrust::minmax_element(thrust::detail::derived_cast(thrust::detail::strip_const(exec)),
+                                   unit_coord.column(i).begin(), unit_coord.column(i).end());
+
+        const ValueType lower = *bounds.first;
+        const ValueType upper = *bounds.second;
+        const ValueType scale = upper > lower ? ValueType(1) / (upper - lower) : ValueType(0);
+
+        thrust::transform(thrust::detail::derived_cast(thrust::detail::strip_const(exec)),
+                          unit_coord.column(i).begin(), unit_coord.column(i).end(),
+                          unit_coord.column(i).begin(),
+                          detail::scale_to_unit<ValueType>(lower, scale));
+    }
+
+    // one part per point numbers the points along the curve
+    P.resize(A.num_rows);
+
+    cusp::graph::hilbert_curve(exec, unit_coord, A.num_rows, P.permutation);
+
+    B = A;
+    P.symmetric_permute(B);
+}
+
+template <typename MatrixType1,
+          typename MatrixType2,
+          typename PermutationType>
+void optimize_layout(const MatrixType1& A,
+                           MatrixType2& B,
+                           PermutationType& P)
+{
+    using thrust::system::detail::generic::select_system;
+
+    typedef typename MatrixType1::memory_space     System1;
+    typedef typename PermutationType::memory_space System2;
+
+    System1 system1;
+    System2 system2;
+
+    cusp::graph::optimize_layout(select_system(system1,system2), A, B, P);
+}
+
+template <typename MatrixType1,
+          typename Array2dType,
+          typename MatrixType2,
+          typename PermutationType>
+void optimize_layout(const MatrixType1& A,
+                     const Array2dType& coord,
+                           MatrixType2& B,
+                           PermutationType& P)
+{
+    using thrust::system::detail::generic::select_system;
+
+    typedef typename Array2dType::memory_space     System1;
+    typedef typename PermutationType::memory_space System2;
+
+    System1 system1;
+    System2 system2;
+
+    cusp::graph::optimize_layout(select_system(system1,system2), A, coord, B, P);
+}
+
+} // end namespace graph
+} // end namespace cusp
@@ -0,0 +1,100 @@
+/*
+ *  Copyright 2008-2014 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include <cusp/detail/config.h>
+#include <thrust/system/detail/generic/select_system.h>
+
+#include <cusp/system/detail/generic/graph/pagerank.h>
+
+namespace cusp
+{
+namespace graph
+{
+
+template <typename DerivedPolicy,
+          typename MatrixType,
+          typename ArrayType>
+size_t pagerank(const thrust::detail::execution_policy_base<DerivedPolicy>& exec,
+                const MatrixType& G,
+                      ArrayType& ranks,
+                const double damping,
+                const double tolerance,
+                const size_t max_iterations)
+{
+    using cusp::system::detail::generic::pagerank;
+
+    return pagerank(thrust::detail::derived_cast(thrust::detail::strip_const(exec)), G, ranks, damping, tolerance, max_iterations);
+}
+
+template <typename MatrixType,
+          typename ArrayType>
+size_t pagerank(const MatrixType& G,
+                      ArrayType& ranks,
+                const double damping,
+                const double tolerance,
+                const size_t max_iterations)
+{
+    using thrust::system::detail::generic::select_system;
+
+    typedef typename MatrixType::memory_space System1;
+    typedef typename ArrayType::memory_space  System2;
+
+    System1 system1;
+    System2 system2;
+
+    return cusp::graph::pagerank(select_system(system1,system2), G, ranks, damping, tolerance, max_iterations);
+}
+
+template <typename DerivedPolicy,
+          typename MatrixType,
+          typename ArrayType1,
+          typename ArrayType2>
+size_t personalized_pagerank(const thrust::detail::execution_policy_base<DerivedPolicy>& exec,
+                             const MatrixType& G,
+                             const ArrayType1& teleport,
+                                   ArrayType2& ranks,
+                             const double damping,
+                             const double tolerance,
+                             const size_t max_iterations)
+{
+    using cusp::system::detail::generic::personalized_pagerank;
+
+    return personalized_pagerank(thrust::detail::derived_cast(thrust::detail::strip_const(exec)), G, teleport, ranks, damping, tolerance, max_iterations);
+}
+
+template <typename MatrixType,
+          typename ArrayType1,
+          typename ArrayType2>
+size_t personalized_pagerank(const MatrixType& G,
+                             const ArrayType1& teleport,
+                                   ArrayType2& ranks,
+                             const double damping,
+                             const double tolerance,
+                             const size_t max_iterations)
+{
+    using thrust::system::detail::generic::select_system;
+
+    typedef typename MatrixType::memory_space System1;
+    typedef typename ArrayType2::memory_space System2;
+
+    System1 system1;
+    System2 system2;
+
+    return cusp::graph::personalized_pagerank(select_system(system1,system2), G, teleport, ranks, damping, tolerance, max_iterations);
+}
+
+} // end namespace graph
+} // end namespace cusp
@@ -0,0 +1,112 @@
+/*
+ *  Copyright 2008-2014 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*! \file k_truss.h
+ *  \brief Compute the k-truss of a graph
+ */
+
+#pragma once
+
+#include <cusp/detail/config.h>
+#include <cusp/detail/execution_policy.h>
+
+#include <cstddef>
+
+namespace cusp
+{
+namespace graph
+{
+
+/*! \addtogroup algorithms Algorithms
+ *  \addtogroup graph_algorithms Graph Algorithms
+ *  \ingroup algorithms
+ *  \{
+ */
+
+/* \cond */
+template <typename DerivedPolicy,
+          typename MatrixType1,
+          typename MatrixType2>
+size_t k_truss(const thrust::detail::execution_policy_base<DerivedPolicy>& exec,
+               const MatrixType1& G,
+               const size_t k,
+                     MatrixType2& T);
+/* \endcond */
+
+/**
+ * \brief Computes the k-truss of an undirected graph
+ *
+ * \tparam MatrixType1 Type of input matrix
+ * \tparam MatrixType2 Type of output matrix
+ *
+ * \param G A symmetric matrix that represents the graph, its diagonal and
+ * values are ignored
+ * \param k Every edge of the truss belongs to at least <tt>k - 2</tt>
+ * triangles of the truss
+ * \param T Symmetric pattern of the edges of the truss with unit values
+ *
+ * \return The number of undirected edges of the truss
+ *
+ * \throw cusp::invalid_input_exception if \p G is not square or \p k is
+ * less than 2
+ *
+ * \par Overview
+ *
+ * The support of every edge, the number of triangles containing it, is the
+ * masked product <tt>(A * A) .* A</tt> of the remaining graph \c A. Edges
+ * with a support below <tt>k - 2</tt> are removed and the supports are
+ * recomputed until no edge is removed.
+ *
+ * \see masked_spgemm
+ * \see triangle_count
+ *
+ * \par Example
+ *
+ * \code
+ * #include <cusp/csr_matrix.h>
+ * #include <cusp/gallery/poisson.h>
+ *
+ * //include k-truss header file
+ * #include <cusp/graph/k_truss.h>
+ *
+ * #include <iostream>
+ *
+ * int main()
+ * {
+ *    cusp::csr_matrix<int,float,cusp::device_memory> G;
+ *    cusp::gallery::poisson9pt(G, 8, 8);
+ *
+ *    cusp::csr_matrix<int,float,cusp::device_memory> T;
+ *    size_t num_edges = cusp::graph::k_truss(G, 4, T);
+ *
+ *    std::cout << "The 4-truss has " << num_edges << " edges." << std::endl;
+ *
+ *    return 0;
+ * }
+ * \endcode
+ */
+template <typename MatrixType1,
+          typename MatrixType2>
+size_t k_truss(const MatrixType1& G,
+               const size_t k,
+                     MatrixType2& T);
+/*! \}
+ */
+
+} // end namespace graph
+} // end namespace cusp
+
+#include <cusp/graph/detail/k_truss.inl>
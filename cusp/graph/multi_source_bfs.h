@@ -0,0 +1,157 @@
+/*
+ *  Copyright 2008-2014 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*! \file multi_source_bfs.h
+ *  \brief Breadth-first traversals from many sources at once
+ */
+
+#pragma once
+
+#include <cusp/detail/config.h>
+#include <cusp/detail/execution_policy.h>
+
+namespace cusp
+{
+namespace graph
+{
+
+/*! \addtogroup algorithms Algorithms
+ *  \addtogroup graph_algorithms Graph Algorithms
+ *  \ingroup algorithms
+ *  \{
+ */
+
+/* \cond */
+template <typename DerivedPolicy,
+          typename MatrixType,
+          typename ArrayType1,
+          typename ArrayType2>
+void multi_source_bfs(const thrust::detail::execution_policy_base<DerivedPolicy>& exec,
+                      const MatrixType& G,
+                      const ArrayType1& sources,
+                            ArrayType2& distances);
+
+template <typename DerivedPolicy,
+          typename MatrixType,
+          typename ArrayType1,
+          typename ArrayType2>
+void multi_source_eccentricity(const thrust::detail::execution_policy_base<DerivedPolicy>& exec,
+                               const MatrixType& G,
+                               const ArrayType1& sources,
+                                     ArrayType2& eccentricities);
+/* \endcond */
+
+/**
+ * \brief Computes the level sets of breadth-first traversals from many sources
+ *
+ * \tparam MatrixType Type of input matrix
+ * \tparam ArrayType1 Type of sources array
+ * \tparam ArrayType2 Type of distances array, an \p array2d
+ *
+ * \param G A symmetric matrix that represents the graph
+ * \param sources Source vertices of the traversals
+ * \param distances An \p array2d of <tt>G.num_rows</tt> rows and
+ * <tt>sources.size()</tt> columns, entry <tt>(v,s)</tt> holds the number of
+ * edges between \c sources[s] and \c v or -1 if \c v is unreachable
+ *
+ * \throw cusp::invalid_input_exception if \p G is not square, a source is
+ * out of range or \p distances has the wrong shape
+ *
+ * \par Overview
+ *
+ * The traversals of up to 64 sources advance together. Every vertex keeps
+ * one bit per source in a 64-bit mask of the traversals which visited it,
+ * and the next frontier of all of them is a single SpMV in the semiring of
+ * bitwise or and selection, followed by masking out the visited bits. The
+ * edges are traversed once per level for the whole batch instead of once
+ * per source.
+ *
+ * \see breadth_first_search
+ *
+ * \par Example
+ *
+ * \code
+ * #include <cusp/array1d.h>
+ * #include <cusp/array2d.h>
+ * #include <cusp/csr_matrix.h>
+ * #include <cusp/print.h>
+ * #include <cusp/gallery/grid.h>
+ *
+ * //include multi-source bfs header file
+ * #include <cusp/graph/multi_source_bfs.h>
+ *
+ * int main()
+ * {
+ *    cusp::csr_matrix<int,float,cusp::device_memory> G;
+ *    cusp::gallery::grid2d(G, 4, 4);
+ *
+ *    cusp::array1d<int,cusp::device_memory> sources(2);
+ *    sources[0] = 0;
+ *    sources[1] = 15;
+ *
+ *    cusp::array2d<int,cusp::device_memory> distances(G.num_rows, sources.size());
+ *    cusp::graph::multi_source_bfs(G, sources, distances);
+ *
+ *    cusp::print(distances);
+ *
+ *    return 0;
+ * }
+ * \endcode
+ */
+template <typename MatrixType,
+          typename ArrayType1,
+          typename ArrayType2>
+void multi_source_bfs(const MatrixType& G,
+                      const ArrayType1& sources,
+                            ArrayType2& distances);
+
+/**
+ * \brief Computes the eccentricities of many vertices
+ *
+ * \tparam MatrixType Type of input matrix
+ * \tparam ArrayType1 Type of sources array
+ * \tparam ArrayType2 Type of eccentricities array
+ *
+ * \param G A symmetric matrix that represents the graph
+ * \param sources Vertices whose eccentricity is computed
+ * \param eccentricities Largest distance from every source to a vertex of
+ * its connected component
+ *
+ * \throw cusp::invalid_input_exception if \p G is not square, a source is
+ * out of range or \p eccentricities is smaller than \p sources
+ *
+ * \par Overview
+ *
+ * Performs the same batched traversals as \p multi_source_bfs without
+ * storing the distances, the eccentricity of a source is the last level at
+ * which its traversal reached a vertex. This selects e.g. the candidates of
+ * a pseudo-peripheral vertex for \p symmetric_rcm.
+ *
+ * \see multi_source_bfs
+ */
+template <typename MatrixType,
+          typename ArrayType1,
+          typename ArrayType2>
+void multi_source_eccentricity(const MatrixType& G,
+                               const ArrayType1& sources,
+                                     ArrayType2& eccentricities);
+/*! \}
+ */
+
+} // end namespace graph
+} // end namespace cusp
+
+#include <cusp/graph/detail/multi_source_bfs.inl>
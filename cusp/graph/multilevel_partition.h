@@ -0,0 +1,119 @@
+/*
+ *  Copyright 2008-2014 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+
+/*! \file multilevel_partition.h
+ *  \brief Multilevel k-way partitioning of a graph
+ */
+
+#pragma once
+
+#include <cusp/detail/config.h>
+#include <cusp/detail/execution_policy.h>
+
+namespace cusp
+{
+namespace graph
+{
+
+/*! \addtogroup algorithms Algorithms
+ *  \addtogroup graph_algorithms Graph Algorithms
+ *  \ingroup algorithms
+ *  \{
+ */
+
+/* \cond */
+template <typename DerivedPolicy,
+          typename MatrixType,
+          typename ArrayType>
+size_t multilevel_partition(const thrust::detail::execution_policy_base<DerivedPolicy>& exec,
+                            const MatrixType& G,
+                            const size_t num_parts,
+                                  ArrayType& parts,
+                            const double imbalance = 0.03);
+/* \endcond */
+
+/**
+ * \brief Partition a graph into parts of equal size with few cut edges
+ *
+ * \tparam MatrixType Type of input matrix
+ * \tparam ArrayType Type of parts array
+ *
+ * \param G A symmetric matrix that represents the graph
+ * \param num_parts Number of parts to construct
+ * \param parts Part assigned to each vertex
+ * \param imbalance Allowed relative excess of the part sizes over
+ * <tt>num_rows / num_parts</tt>
+ *
+ * \return The number of edges between different parts
+ *
+ * \par Overview
+ *
+ * The graph is coarsened by heavy edge matching: matched pairs of vertices
+ * become the aggregates of the next level and the coarse graph is their
+ * Galerkin product with the graph, whose entries weigh the edges between
+ * aggregates. Coarsening stops at about <tt>20 * num_parts</tt> vertices
+ * or when the matching no longer shrinks the graph. The coarsest graph is
+ * split into pieces of equal weight along a Cuthill-McKee ordering on the
+ * host. The partition is then projected back level by level and refined on
+ * every level by label propagation, moving boundary vertices to the
+ * adjacent part they are most connected to while the parts stay below the
+ * size limit. Matching and refinement run in the memory space of the graph.
+ *
+ * Minimizing the cut edges minimizes the halo exchanged between the parts
+ * of a distributed SpMV.
+ *
+ * \par Example
+ *
+ * \code
+ * #include <cusp/array1d.h>
+ * #include <cusp/csr_matrix.h>
+ * #include <cusp/gallery/poisson.h>
+ *
+ * //include multilevel partition header file
+ * #include <cusp/graph/multilevel_partition.h>
+ *
+ * #include <iostream>
+ *
+ * int main()
+ * {
+ *    cusp::csr_matrix<int,float,cusp::device_memory> G;
+ *    cusp::gallery::poisson5pt(G, 256, 256);
+ *
+ *    cusp::array1d<int,cusp::device_memory> parts(G.num_rows);
+ *
+ *    // split the grid into 8 parts
+ *    size_t num_cut_edges = cusp::graph::multilevel_partition(G, 8, parts);
+ *
+ *    std::cout << "cut edges : " << num_cut_edges << std::endl;
+ *
+ *    return 0;
+ * }
+ * \endcode
+ */
+template <typename MatrixType,
+          typename ArrayType>
+size_t multilevel_partition(const MatrixType& G,
+                            const size_t num_parts,
+                                  ArrayType& parts,
+                            const double imbalance = 0.03);
+/*! \}
+ */
+
+} // end namespace graph
+} // end namespace cusp
+
+#include <cusp/graph/detail/multilevel_partition.inl>
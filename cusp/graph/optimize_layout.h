@@ -0,0 +1,163 @@
+/*
+ *  Copyright 2008-2014 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+
+/*! \file optimize_layout.h
+ *  \brief Locality improving reordering of a sparse matrix
+ */
+
+#pragma once
+
+#include <cusp/detail/config.h>
+#include <cusp/detail/execution_policy.h>
+
+namespace cusp
+{
+namespace graph
+{
+
+/*! \addtogroup algorithms Algorithms
+ *  \addtogroup graph_algorithms Graph Algorithms
+ *  \ingroup algorithms
+ *  \{
+ */
+
+/* \cond */
+template <typename DerivedPolicy,
+          typename MatrixType1,
+          typename MatrixType2,
+          typename PermutationType>
+void optimize_layout(const thrust::detail::execution_policy_base<DerivedPolicy>& exec,
+                     const MatrixType1& A,
+                           MatrixType2& B,
+                           PermutationType& P);
+
+template <typename DerivedPolicy,
+          typename MatrixType1,
+          typename Array2dType,
+          typename MatrixType2,
+          typename PermutationType>
+void optimize_layout(const thrust::detail::execution_policy_base<DerivedPolicy>& exec,
+                     const MatrixType1& A,
+                     const Array2dType& coord,
+                           MatrixType2& B,
+                           PermutationType& P);
+/* \endcond */
+
+/**
+ * \brief Reorder a matrix to improve the memory locality of SpMV
+ *
+ * \tparam MatrixType1 Type of input matrix
+ * \tparam MatrixType2 Type of output matrix
+ * \tparam PermutationType Type of permutation matrix
+ *
+ * \param A A structurally symmetric square matrix
+ * \param B The reordered matrix, P * A * P^T
+ * \param P The permutation matrix of the reordering
+ *
+ * \par Overview
+ *
+ * Computes a Reverse Cuthill-McKee ordering of \p A with \p symmetric_rcm
+ * and applies it with \p permutation_matrix::symmetric_permute. Neighboring
+ * rows are numbered close to each other, which narrows the band of the
+ * matrix and the range of \p x gathered by consecutive rows of an SpMV.
+ *
+ * Systems with the reordered matrix are solved with permuted vectors,
+ * <tt>multiply(b, P, b_p)</tt> moves \p b to the new ordering and
+ * <tt>multiply(P, x_p, x)</tt> moves the solution back.
+ *
+ * \par Example
+ *
+ * \code
+ * #include <cusp/csr_matrix.h>
+ * #include <cusp/multiply.h>
+ * #include <cusp/permutation_matrix.h>
+ * #include <cusp/gallery/poisson.h>
+ * #include <cusp/krylov/cg.h>
+ *
+ * // include optimize layout header file
+ * #include <cusp/graph/optimize_layout.h>
+ *
+ * int main()
+ * {
+ *    cusp::csr_matrix<int,float,cusp::device_memory> A;
+ *    cusp::gallery::poisson5pt(A, 256, 256);
+ *
+ *    cusp::array1d<float,cusp::device_memory> x(A.num_rows, 0);
+ *    cusp::array1d<float,cusp::device_memory> b(A.num_rows, 1);
+ *
+ *    // reorder A
+ *    cusp::csr_matrix<int,float,cusp::device_memory> B;
+ *    cusp::permutation_matrix<int,cusp::device_memory> P;
+ *    cusp::graph::optimize_layout(A, B, P);
+ *
+ *    // solve with the reordered matrix and permuted vectors
+ *    cusp::array1d<float,cusp::device_memory> x_p(A.num_rows, 0);
+ *    cusp::array1d<float,cusp::device_memory> b_p(A.num_rows);
+ *    cusp::multiply(b, P, b_p);
+ *
+ *    cusp::krylov::cg(B, x_p, b_p);
+ *
+ *    cusp::multiply(P, x_p, x);
+ *
+ *    return 0;
+ * }
+ * \endcode
+ */
+template <typename MatrixType1,
+          typename MatrixType2,
+          typename PermutationType>
+void optimize_layout(const MatrixType1& A,
+                           MatrixType2& B,
+                           PermutationType& P);
+
+/**
+ * \brief Reorder a matrix along a Hilbert curve through its coordinates
+ *
+ * \tparam MatrixType1 Type of input matrix
+ * \tparam Array2dType Type of coordinates array
+ * \tparam MatrixType2 Type of output matrix
+ * \tparam PermutationType Type of permutation matrix
+ *
+ * \param A A square matrix
+ * \param coord Coordinates in 2 or 3-D space of every row of \p A
+ * \param B The reordered matrix, P * A * P^T
+ * \param P The permutation matrix of the reordering
+ *
+ * \par Overview
+ *
+ * Numbers the rows in the order of a Hilbert space filling curve through
+ * \p coord, computed with \p hilbert_curve, and applies the ordering with
+ * \p permutation_matrix::symmetric_permute. Rows of nearby mesh points get
+ * nearby indices, which on unstructured meshes usually gives better SpMV
+ * locality than RCM. The coordinates are scaled to the unit box first and
+ * may have any range.
+ */
+template <typename MatrixType1,
+          typename Array2dType,
+          typename MatrixType2,
+          typename PermutationType>
+void optimize_layout(const MatrixType1& A,
+                     const Array2dType& coord,
+                           MatrixType2& B,
+                           PermutationType& P);
+/*! \}
+ */
+
+} // end namespace graph
+} // end namespace cusp
+
+#include <cusp/graph/detail/optimize_layout.inl>
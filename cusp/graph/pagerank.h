@@ -0,0 +1,183 @@
+/*
+ *  Copyright 2008-2014 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*! \file pagerank.h
+ *  \brief PageRank and batched personalized PageRank
+ */
+
+#pragma once
+
+#include <cusp/detail/config.h>
+#include <cusp/detail/execution_policy.h>
+
+namespace cusp
+{
+namespace graph
+{
+
+/*! \addtogroup algorithms Algorithms
+ *  \addtogroup graph_algorithms Graph Algorithms
+ *  \ingroup algorithms
+ *  \{
+ */
+
+/* \cond */
+template <typename DerivedPolicy,
+          typename MatrixType,
+          typename ArrayType>
+size_t pagerank(const thrust::detail::execution_policy_base<DerivedPolicy>& exec,
+                const MatrixType& G,
+                      ArrayType& ranks,
+                const double damping = 0.85,
+                const double tolerance = 1e-6,
+                const size_t max_iterations = 100);
+
+template <typename DerivedPolicy,
+          typename MatrixType,
+          typename ArrayType1,
+          typename ArrayType2>
+size_t personalized_pagerank(const thrust::detail::execution_policy_base<DerivedPolicy>& exec,
+                             const MatrixType& G,
+                             const ArrayType1& teleport,
+                                   ArrayType2& ranks,
+                             const double damping = 0.85,
+                             const double tolerance = 1e-6,
+                             const size_t max_iterations = 100);
+/* \endcond */
+
+/**
+ * \brief Computes the PageRank of the vertices of a directed graph
+ *
+ * \tparam MatrixType Type of input matrix
+ * \tparam ArrayType Type of ranks array
+ *
+ * \param G A matrix whose entry <tt>(i,j)</tt> is an edge from \c i to
+ * \c j, only its pattern is read
+ * \param ranks Probability of every vertex in the stationary distribution
+ * of the random surfer, resized to <tt>G.num_rows</tt>
+ * \param damping Probability of following an edge instead of teleporting
+ * \param tolerance The iteration stops once the 1-norm of the change of
+ * the ranks falls below \p tolerance
+ * \param max_iterations Largest number of iterations
+ *
+ * \return The number of iterations performed
+ *
+ * \throw cusp::invalid_input_exception if \p G is not square or \p damping
+ * is not in <tt>[0,1)</tt>
+ *
+ * \par Overview
+ *
+ * Power iteration of the Google matrix. The edges are traversed in the
+ * pull direction on the transposed pattern of \p G, stored once as a
+ * \p csr_pattern_matrix, and a single kernel per iteration gathers the
+ * ranks of the in-neighbors scaled by their inverse out-degree and adds
+ * the teleport term. The rank of the vertices without out-edges
+ * (dangling vertices) is summed up front and redistributed through the
+ * teleport term of the same kernel, and the 1-norm of the change is
+ * reduced on the device, so only one scalar per iteration reaches the
+ * host.
+ *
+ * \see personalized_pagerank
+ *
+ * \par Example
+ *
+ * \code
+ * #include <cusp/array1d.h>
+ * #include <cusp/csr_pattern_matrix.h>
+ * #include <cusp/print.h>
+ * #include <cusp/gallery/random.h>
+ *
+ * //include pagerank header file
+ * #include <cusp/graph/pagerank.h>
+ *
+ * int main()
+ * {
+ *    cusp::coo_matrix<int,float,cusp::host_memory> A;
+ *    cusp::gallery::random(A, 100, 100, 500);
+ *
+ *    cusp::csr_pattern_matrix<int,int,cusp::device_memory> G(A);
+ *    cusp::array1d<float,cusp::device_memory> ranks;
+ *
+ *    cusp::graph::pagerank(G, ranks);
+ *
+ *    cusp::print(ranks);
+ *
+ *    return 0;
+ * }
+ * \endcode
+ */
+template <typename MatrixType,
+          typename ArrayType>
+size_t pagerank(const MatrixType& G,
+                      ArrayType& ranks,
+                const double damping = 0.85,
+                const double tolerance = 1e-6,
+                const size_t max_iterations = 100);
+
+/**
+ * \brief Computes the personalized PageRank of many teleport distributions
+ *
+ * \tparam MatrixType Type of input matrix
+ * \tparam ArrayType1 Type of teleport array, an \p array2d
+ * \tparam ArrayType2 Type of ranks array, an \p array2d
+ *
+ * \param G A matrix whose entry <tt>(i,j)</tt> is an edge from \c i to
+ * \c j, only its pattern is read
+ * \param teleport An \p array2d of <tt>G.num_rows</tt> rows whose columns
+ * are the nonnegative teleport distributions, each one is normalized to
+ * sum one
+ * \param ranks An \p array2d of the shape of \p teleport, column \c c holds
+ * the ranks of teleport distribution \c c
+ * \param damping Probability of following an edge instead of teleporting
+ * \param tolerance The iteration stops once the sum of the 1-norms of the
+ * changes of all rank vectors falls below \p tolerance
+ * \param max_iterations Largest number of iterations
+ *
+ * \return The number of iterations performed
+ *
+ * \throw cusp::invalid_input_exception if \p G is not square, \p damping
+ * is not in <tt>[0,1)</tt>, \p teleport or \p ranks have the wrong shape
+ * or a teleport distribution sums to zero
+ *
+ * \par Overview
+ *
+ * Runs the power iterations of \p pagerank for all teleport distributions
+ * together. The rank vectors are stored interleaved, one row of
+ * <tt>teleport.num_cols</tt> values per vertex, so the kernel is a
+ * sparse-dense matrix product in which the threads of a vertex share its
+ * in-neighbors and read contiguous rows of the ranks. The edges are read
+ * once per iteration for the whole batch. The rank of the dangling
+ * vertices is redistributed according to the teleport distribution of
+ * every column.
+ *
+ * \see pagerank
+ */
+template <typename MatrixType,
+          typename ArrayType1,
+          typename ArrayType2>
+size_t personalized_pagerank(const MatrixType& G,
+                             const ArrayType1& teleport,
+                                   ArrayType2& ranks,
+                             const double damping = 0.85,
+                             const double tolerance = 1e-6,
+                             const size_t max_iterations = 100);
+/*! \}
+ */
+
+} // end namespace graph
+} // end namespace cusp
+
+#include <cusp/graph/detail/pagerank.inl>
@@ -0,0 +1,134 @@
+/*
+ *  Copyright 2008-2014 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*! \file space_filling_curve.h
+ *  \brief Order points along a Hilbert or Morton space filling curve
+ */
+
+#pragma once
+
+#include <cusp/detail/config.h>
+#include <cusp/detail/execution_policy.h>
+
+namespace cusp
+{
+namespace graph
+{
+
+/*! \addtogroup algorithms Algorithms
+ *  \addtogroup graph_algorithms Graph Algorithms
+ *  \ingroup algorithms
+ *  \{
+ */
+
+/**
+ * \brief Space filling curves traversing the points
+ */
+typedef enum
+{
+    HILBERT_CURVE, /*!< Hilbert curve, consecutive cells are always adjacent */
+    MORTON_CURVE   /*!< Morton (Z-order) curve, interleaves the coordinate bits */
+} curve_type;
+
+/* \cond */
+template <typename DerivedPolicy,
+          typename Array2dType,
+          typename PermutationType>
+void space_filling_curve(const thrust::detail::execution_policy_base<DerivedPolicy>& exec,
+                         const Array2dType& coord,
+                               PermutationType& P,
+                         const curve_type curve = HILBERT_CURVE);
+/* \endcond */
+
+/**
+ * \brief Compute the ordering of points along a space filling curve
+ *
+ * \tparam Array2dType Type of input coordinates array
+ * \tparam PermutationType Type of permutation matrix
+ *
+ * \param coord Set of points in 2 or 3-D space, one point per row
+ * \param P The permutation matrix that moves every point to its position
+ * on the curve
+ * \param curve The curve to follow, \p HILBERT_CURVE or \p MORTON_CURVE
+ *
+ * \throw cusp::invalid_input_exception if \p coord does not have 2 or 3
+ * columns
+ *
+ * \par Overview
+ *
+ * Scales the points into their bounding box and quantizes every coordinate
+ * to 32 bits in 2-D or 21 bits in 3-D. The 64-bit key of a point is
+ * computed directly with bitwise operations, the Morton key interleaves
+ * the coordinate bits and the 2-D Hilbert key resolves the orientation of
+ * all levels with a parallel prefix scan instead of a state table walked
+ * level by level. A single radix sort of the keys orders the points.
+ *
+ * Applying \p P symmetrically to the matrix of an unstructured mesh
+ * numbers nearby vertices consecutively, which improves the locality of
+ * SpMV. Unlike \p hilbert_curve, which partitions the points, the whole
+ * ordering is returned.
+ *
+ * \see hilbert_curve
+ * \see http://en.wikipedia.org/wiki/Hilbert_curve
+ * \see http://en.wikipedia.org/wiki/Z-order_curve
+ *
+ * \par Example
+ *
+ * \code
+ * #include <cusp/array2d.h>
+ * #include <cusp/permutation_matrix.h>
+ * #include <cusp/print.h>
+ *
+ * //include space filling curve header file
+ * #include <cusp/graph/space_filling_curve.h>
+ *
+ * int main()
+ * {
+ *    // Coordinates of the points of a 4x4 grid
+ *    cusp::array2d<float,cusp::host_memory> coords(16, 2);
+ *    for(int i = 0; i < 16; i++)
+ *    {
+ *        coords(i,0) = i % 4;
+ *        coords(i,1) = i / 4;
+ *    }
+ *
+ *    cusp::array2d<float,cusp::device_memory> d_coords(coords);
+ *
+ *    // Allocate permutation matrix P
+ *    cusp::permutation_matrix<int,cusp::device_memory> P(16);
+ *
+ *    // Order the points along the Hilbert curve
+ *    cusp::graph::space_filling_curve(d_coords, P);
+ *
+ *    // Print the position of every point on the curve
+ *    cusp::print(P.permutation);
+ *
+ *    return 0;
+ * }
+ * \endcode
+ */
+template <typename Array2dType,
+          typename PermutationType>
+void space_filling_curve(const Array2dType& coord,
+                               PermutationType& P,
+                         const curve_type curve = HILBERT_CURVE);
+/*! \}
+ */
+
+} // end namespace graph
+} // end namespace cusp
+
+#include <cusp/graph/detail/space_filling_curve.inl>
@@ -0,0 +1,120 @@
+/*
+ *  Copyright 2008-2014 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*! \file sssp.h
+ *  \brief Single-source shortest paths of a weighted graph
+ */
+
+#pragma once
+
+#include <cusp/detail/config.h>
+#include <cusp/detail/execution_policy.h>
+
+namespace cusp
+{
+namespace graph
+{
+
+/*! \addtogroup algorithms Algorithms
+ *  \addtogroup graph_algorithms Graph Algorithms
+ *  \ingroup algorithms
+ *  \{
+ */
+
+/* \cond */
+template <typename DerivedPolicy,
+          typename MatrixType,
+          typename ArrayType>
+void sssp(const thrust::detail::execution_policy_base<DerivedPolicy>& exec,
+          const MatrixType& G,
+          const typename MatrixType::index_type src,
+                ArrayType& distances,
+          const double delta = 0);
+/* \endcond */
+
+/**
+ * \brief Computes the shortest distances from a source vertex to all vertices
+ *
+ * \tparam MatrixType Type of input matrix
+ * \tparam ArrayType Type of distances array
+ *
+ * \param G A square matrix whose entry <tt>G(i,j)</tt> is the nonnegative
+ * weight of the edge from \c i to \c j
+ * \param src Source vertex
+ * \param distances Shortest distance from \p src to every vertex,
+ * <tt>std::numeric_limits<T>::infinity()</tt> (or \c max() for types without
+ * infinity) for unreachable vertices
+ * \param delta Width of the distance buckets, a nonpositive value selects
+ * the largest weight divided by the average degree
+ *
+ * \throw cusp::invalid_input_exception if \p G is not square, \p src is out
+ * of range or \p G has negative weights
+ *
+ * \par Overview
+ *
+ * Delta-stepping processes the vertices in buckets of distances of width
+ * \p delta. The vertices of the lowest nonempty bucket form a sparse
+ * frontier whose light edges, those not heavier than \p delta, are relaxed
+ * with a min-plus \p generalized_spmspv until the bucket no longer changes.
+ * The heavy edges of the settled vertices are then relaxed once, since they
+ * can only reach later buckets. Each relaxation only touches the rows of the
+ * frontier. A small \p delta approaches Dijkstra and a large one
+ * Bellman-Ford.
+ *
+ * \see http://en.wikipedia.org/wiki/Shortest_path_problem
+ *
+ * \par Example
+ *
+ * \code
+ * #include <cusp/array1d.h>
+ * #include <cusp/csr_matrix.h>
+ * #include <cusp/print.h>
+ * #include <cusp/gallery/poisson.h>
+ *
+ * //include sssp header file
+ * #include <cusp/graph/sssp.h>
+ *
+ * int main()
+ * {
+ *    cusp::csr_matrix<int,float,cusp::device_memory> G;
+ *    cusp::gallery::poisson5pt(G, 4, 4);
+ *
+ *    // the negative couplings of the stencil become unit weights
+ *    thrust::fill(G.values.begin(), G.values.end(), 1.0f);
+ *
+ *    cusp::array1d<float,cusp::device_memory> distances(G.num_rows);
+ *
+ *    cusp::graph::sssp(G, 0, distances);
+ *
+ *    cusp::print(distances);
+ *
+ *    return 0;
+ * }
+ * \endcode
+ */
+template <typename MatrixType,
+          typename ArrayType>
+void sssp(const MatrixType& G,
+          const typename MatrixType::index_type src,
+                ArrayType& distances,
+          const double delta = 0);
+/*! \}
+ */
+
+} // end namespace graph
+} // end namespace cusp
+
+#include <cusp/graph/detail/sssp.inl>
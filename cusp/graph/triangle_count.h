@@ -0,0 +1,116 @@
+/*
+ *  Copyright 2008-2014 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*! \file triangle_count.h
+ *  \brief Count the triangles of a graph
+ */
+
+#pragma once
+
+#include <cusp/detail/config.h>
+#include <cusp/detail/execution_policy.h>
+
+#include <cstddef>
+
+namespace cusp
+{
+namespace graph
+{
+
+/*! \addtogroup algorithms Algorithms
+ *  \addtogroup graph_algorithms Graph Algorithms
+ *  \ingroup algorithms
+ *  \{
+ */
+
+/* \cond */
+template <typename DerivedPolicy,
+          typename MatrixType,
+          typename ArrayType>
+size_t triangle_count(const thrust::detail::execution_policy_base<DerivedPolicy>& exec,
+                      const MatrixType& G,
+                            ArrayType& triangles);
+/* \endcond */
+
+/**
+ * \brief Counts the triangles of an undirected graph
+ *
+ * \tparam MatrixType Type of input matrix
+ * \tparam ArrayType Type of triangles array
+ *
+ * \param G A symmetric matrix that represents the graph, its diagonal and
+ * values are ignored
+ * \param triangles Number of triangles each vertex belongs to
+ *
+ * \return The number of triangles of the graph
+ *
+ * \throw cusp::invalid_input_exception if \p G is not square
+ *
+ * \par Overview
+ *
+ * Every edge is oriented from the endpoint of lower degree to the endpoint
+ * of higher degree, ties broken by index, which yields an acyclic graph
+ * \c U whose vertices have few outgoing edges. A triangle then appears
+ * exactly once in the masked product <tt>(U * U) .* U</tt>, whose entry
+ * <tt>(i,j)</tt> counts the triangles with lowest vertex \c i and highest
+ * vertex \c j. The per vertex counts add the masked product
+ * <tt>(U^T * U) .* U</tt> counting the triangles by their middle vertex.
+ *
+ * The local clustering coefficient of vertex \c v of degree \c d is
+ * <tt>2 * triangles[v] / (d * (d - 1))</tt>.
+ *
+ * \see masked_spgemm
+ *
+ * \par Example
+ *
+ * \code
+ * #include <cusp/array1d.h>
+ * #include <cusp/csr_matrix.h>
+ * #include <cusp/print.h>
+ * #include <cusp/gallery/poisson.h>
+ *
+ * //include triangle count header file
+ * #include <cusp/graph/triangle_count.h>
+ *
+ * #include <iostream>
+ *
+ * int main()
+ * {
+ *    cusp::csr_matrix<int,float,cusp::device_memory> G;
+ *    cusp::gallery::poisson9pt(G, 4, 4);
+ *
+ *    cusp::array1d<int,cusp::device_memory> triangles(G.num_rows);
+ *
+ *    size_t num_triangles = cusp::graph::triangle_count(G, triangles);
+ *
+ *    std::cout << "Found " << num_triangles << " triangles." << std::endl;
+ *    cusp::print(triangles);
+ *
+ *    return 0;
+ * }
+ * \endcode
+ */
+template <typename MatrixType,
+          typename ArrayType>
+size_t triangle_count(const MatrixType& G,
+                            ArrayType& triangles);
+/*! \}
+ */
+
+} // end namespace graph
+} // end namespace cusp
+
+#include <cusp/graph/detail/triangle_count.inl>
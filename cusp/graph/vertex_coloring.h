@@ -89,6 +89,92 @@ template<typename MatrixType,
          typename ArrayType>
 size_t vertex_coloring(const MatrixType& G,
                              ArrayType& colors);
+
+/*! \p coloring_method : algorithm used by \p vertex_coloring
+ */
+typedef enum
+{
+    GREEDY,                 /*!< sequential first fit in the order of the vertices */
+    JONES_PLASSMANN_LUBY,   /*!< independent sets of hashed priority maxima */
+    SPECULATIVE_GREEDY      /*!< parallel first fit with conflict resolution */
+} coloring_method;
+
+/*! \cond */
+template <typename DerivedPolicy,
+          typename MatrixType,
+          typename ArrayType>
+size_t vertex_coloring(const thrust::detail::execution_policy_base<DerivedPolicy>& exec,
+                       const MatrixType& G,
+                             ArrayType& colors,
+                       const coloring_method method,
+                       const size_t max_colors = 0,
+                       const bool balance = false);
+/*! \endcond */
+
+/**
+ * \brief Performs a vertex coloring of a graph with a chosen algorithm.
+ *
+ * \par Overview
+ * \p GREEDY is the coloring computed by the two argument version.
+ * \p JONES_PLASSMANN_LUBY colors in every round the uncolored vertices
+ * whose hashed priority exceeds that of all their uncolored neighbors, so
+ * each round is an independent set colored in parallel. \p SPECULATIVE_GREEDY
+ * colors interleaved batches of vertices in parallel by first fit against
+ * the colors of the previous batches and recolors the larger endpoint of
+ * every conflicting edge in the next round; it usually needs fewer colors
+ * than \p JONES_PLASSMANN_LUBY in fewer rounds. Both run in the memory
+ * space of the graph.
+ *
+ * The number of colors is the number of sweeps needed by multicolor
+ * smoothers and the class sizes bound their parallelism. If \p max_colors
+ * is nonzero and the coloring uses more colors, the color classes are
+ * recolored by first fit from the last class to the first, which never
+ * increases the number of colors, until at most \p max_colors are used or
+ * a pass makes no progress. If \p balance is \c true, vertices of classes
+ * larger than the average are moved to admissible smaller classes, one
+ * class at a time, to equalize the class sizes.
+ *
+ * \tparam MatrixType Type of input matrix
+ * \tparam ArrayType Type of colors array
+ *
+ * \param G A symmetric matrix that represents the graph
+ * \param colors Contains to the color associated with each vertex
+ * computed during the coloring routine
+ * \param method Coloring algorithm
+ * \param max_colors Number of colors to reduce the coloring to, \c 0
+ * keeps the colors found by \p method
+ * \param balance Equalize the sizes of the color classes
+ * \return The number of colors
+ *
+ *  \par Example
+ *
+ *  \code
+ *  #include <cusp/csr_matrix.h>
+ *  #include <cusp/gallery/poisson.h>
+ *  #include <cusp/graph/vertex_coloring.h>
+ *
+ *  int main()
+ *  {
+ *     cusp::csr_matrix<int,float,cusp::device_memory> G;
+ *     cusp::gallery::poisson27pt(G, 32, 32, 32);
+ *
+ *     cusp::array1d<int,cusp::device_memory> colors(G.num_rows);
+ *
+ *     // color on the device with balanced color classes
+ *     size_t num_colors =
+ *       cusp::graph::vertex_coloring(G, colors, cusp::graph::SPECULATIVE_GREEDY, 0, true);
+ *
+ *     return 0;
+ *  }
+ *  \endcode
+ */
+template<typename MatrixType,
+         typename ArrayType>
+size_t vertex_coloring(const MatrixType& G,
+                             ArrayType& colors,
+                       const coloring_method method,
+                       const size_t max_colors = 0,
+                       const bool balance = false);
 /*! \}
  */
 
@@ -40,7 +40,7 @@ namespace io
  *
  * \tparam Matrix matrix container
  *
- * \param mtx a matrix container (e.g. \p csr_matrix or \p coo_matrix)
+ * \param mtx a matrix container (e.g. \p csr_matrix or \p coo_matrix) or \p array1d
  * \param filename file name of the binary file
  *
  * \par Overview
@@ -73,7 +73,7 @@ void read_binary_file(Matrix& mtx, const std::string& filename);
  * \tparam Matrix matrix container
  * \tparam Stream stream type
  *
- * \param mtx a matrix container (e.g. \p csr_matrix or \p coo_matrix)
+ * \param mtx a matrix container (e.g. \p csr_matrix or \p coo_matrix) or \p array1d
  * \param input stream from which to read the binary contents
  *
  * \par Overview
@@ -106,7 +106,7 @@ void read_binary_stream(Matrix& mtx, Stream& input);
  *
  * \tparam Matrix matrix container
  *
- * \param mtx a matrix container (e.g. \p csr_matrix or \p coo_matrix)
+ * \param mtx a matrix container (e.g. \p csr_matrix or \p coo_matrix) or \p array1d
  * \param filename file name of the binary file
  *
  * \par Overview
@@ -144,7 +144,7 @@ void write_binary_file(const Matrix& mtx, const std::string& filename);
  * \tparam Matrix matrix container
  * \tparam Stream stream type
  *
- * \param mtx a matrix container (e.g. \p csr_matrix or \p coo_matrix)
+ * \param mtx a matrix container (e.g. \p csr_matrix or \p coo_matrix) or \p array1d
  * \param output stream to which the binary contents will be written
  *
  * \par Example
@@ -173,6 +173,118 @@ void write_binary_file(const Matrix& mtx, const std::string& filename);
 template <typename Matrix, typename Stream>
 void write_binary_stream(const Matrix& mtx, Stream& output);
 
+/**
+ * \brief Write a binary file in the compressed format
+ *
+ * \tparam Matrix matrix container
+ *
+ * \param mtx a sparse matrix container (e.g. \p csr_matrix or \p coo_matrix) or \p array1d
+ * \param filename file name of the compressed binary file
+ *
+ * \par Overview
+ * The entries of \p mtx are sorted by row and column and split into
+ * blocks of 65536 entries which are compressed independently and in
+ * parallel. Within a block the row and column indices are stored as
+ * bit-packed differences to the previous entry, and every value is
+ * stored as the nonzero low order bytes of its XOR with the previous
+ * value, which removes the redundancy left in sign, exponent and repeated
+ * values. Matrices from stencil discretizations shrink to about 40% of
+ * the size written by \p write_binary_file, which pays off whenever the
+ * file is read over a link slower than the decoding.
+ *
+ * \note if the file already exists it will be overwritten
+ * \note the file records the byte order, index type and value type and is
+ * only readable into a container of the same types
+ *
+ * \par Example
+ * \code
+ * #include <cusp/csr_matrix.h>
+ * #include <cusp/gallery/poisson.h>
+ * #include <cusp/io/binary.h>
+ *
+ * int main(void)
+ * {
+ *     cusp::csr_matrix<int, double, cusp::host_memory> A;
+ *     cusp::gallery::poisson5pt(A, 100, 100);
+ *
+ *     // save A into a compressed binary file
+ *     cusp::io::write_compressed_binary_file(A, "A.cbz");
+ *
+ *     return 0;
+ * }
+ * \endcode
+ *
+ * \see read_compressed_binary_file
+ */
+template <typename Matrix>
+void write_compressed_binary_file(const Matrix& mtx, const std::string& filename);
+
+/**
+ * \brief Write binary data in the compressed format to a stream.
+ *
+ * \tparam Matrix matrix container
+ * \tparam Stream stream type
+ *
+ * \param mtx a sparse matrix container (e.g. \p csr_matrix or \p coo_matrix) or \p array1d
+ * \param output stream to which the compressed contents will be written
+ *
+ * \see write_compressed_binary_file
+ */
+template <typename Matrix, typename Stream>
+void write_compressed_binary_stream(const Matrix& mtx, Stream& output);
+
+/**
+ * \brief Read a binary file in the compressed format
+ *
+ * \tparam Matrix matrix container
+ *
+ * \param mtx a matrix container (e.g. \p csr_matrix or \p coo_matrix) or \p array1d
+ * \param filename file name of the compressed binary file
+ *
+ * \par Overview
+ * The blocks are read in order and decompressed in parallel by OpenMP
+ * threads, one batch of blocks at a time. When \p mtx resides in device
+ * memory only the bit-packed differences are unpacked on the host and
+ * the indices are recovered by a segmented prefix sum on the device.
+ *
+ * \note any contents of \p mtx will be overwritten
+ * \note a file with other index or value types, or a corrupt file,
+ * raises \p cusp::io_exception
+ *
+ * \par Example
+ * \code
+ * #include <cusp/csr_matrix.h>
+ * #include <cusp/io/binary.h>
+ *
+ * int main(void)
+ * {
+ *     // read the matrix stored in A.cbz into a csr_matrix
+ *     cusp::csr_matrix<int, double, cusp::device_memory> A;
+ *     cusp::io::read_compressed_binary_file(A, "A.cbz");
+ *
+ *     return 0;
+ * }
+ * \endcode
+ *
+ * \see write_compressed_binary_file
+ */
+template <typename Matrix>
+void read_compressed_binary_file(Matrix& mtx, const std::string& filename);
+
+/**
+ * \brief Read binary data in the compressed format from a stream.
+ *
+ * \tparam Matrix matrix container
+ * \tparam Stream stream type
+ *
+ * \param mtx a matrix container (e.g. \p csr_matrix or \p coo_matrix) or \p array1d
+ * \param input stream from which to read the compressed contents
+ *
+ * \see read_compressed_binary_file
+ */
+template <typename Matrix, typename Stream>
+void read_compressed_binary_stream(Matrix& mtx, Stream& input);
+
 /*! \}
  */
 
@@ -180,4 +292,5 @@ void write_binary_stream(const Matrix& mtx, Stream& output);
 } //end namespace cusp
 
 #include <cusp/io/detail/binary.inl>
+#include <cusp/io/detail/compressed_binary.inl>
 
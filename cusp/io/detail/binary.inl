@@ -17,6 +17,7 @@
 
 #pragma once
 
+#include <cusp/array1d.h>
 #include <cusp/array2d.h>
 #include <cusp/coo_matrix.h>
 #include <cusp/convert.h>
@@ -43,9 +44,7 @@ namespace detail
 template <typename IndexType, typename ValueType, typename Stream>
 void read_binary_stream(cusp::coo_matrix<IndexType,ValueType,cusp::host_memory>& coo, Stream& input)
 {
-    size_t num_rows, num_cols, num_entries;
-    IndexType ientry;
-    ValueType ventry;
+    size_t num_rows = 0, num_cols = 0, num_entries = 0;
 
     input.read(reinterpret_cast<char *>(&num_rows), sizeof(size_t));
     input.read(reinterpret_cast<char *>(&num_cols), sizeof(size_t));
@@ -53,31 +52,35 @@ void read_binary_stream(cusp::coo_matrix<IndexType,ValueType,cusp::host_memory>&
 
     coo.resize(num_rows, num_cols, num_entries);
 
-    size_t index = 0;
-    while( index < num_entries )
+    if(num_entries > 0)
     {
-        input.read(reinterpret_cast<char *>(&ientry), sizeof(IndexType));
-        coo.row_indices[index++] = ientry;
-    }
-
-    index = 0;
-    while( index < num_entries )
-    {
-        input.read(reinterpret_cast<char *>(&ientry), sizeof(IndexType));
-        coo.column_indices[index++] = ientry;
-    }
-
-    index = 0;
-    while( index < num_entries )
-    {
-        input.read(reinterpret_cast<char *>(&ventry), sizeof(ValueType));
-        coo.values[index++] = ventry;
+        input.read(reinterpret_cast<char *>(&coo.row_indices[0]), num_entries*sizeof(IndexType));
+        input.read(reinterpret_cast<char *>(&coo.column_indices[0]), num_entries*sizeof(IndexType));
+        input.read(reinterpret_cast<char *>(&coo.values[0]), num_entries*sizeof(ValueType));
     }
 
     // sort indices by (row,column)
     coo.sort_by_row_and_column();
 }
 
+template <typename Array, typename Stream>
+void read_binary_stream(Array& a, Stream& input, cusp::array1d_format)
+{
+    typedef typename Array::value_type ValueType;
+
+    size_t size = 0;
+
+    input.read(reinterpret_cast<char *>(&size), sizeof(size_t));
+
+    // read into contiguous host storage and copy over in a single transfer
+    cusp::array1d<ValueType,cusp::host_memory> temp(size);
+
+    if(size > 0)
+        input.read(reinterpret_cast<char *>(&temp[0]), size*sizeof(ValueType));
+
+    a = temp;
+}
+
 template <typename Matrix, typename Stream, typename Format>
 void read_binary_stream(Matrix& mtx, Stream& input, Format)
 {
@@ -99,9 +102,28 @@ void write_binary_stream(const cusp::coo_matrix<IndexType,ValueType,cusp::host_m
     output.write(reinterpret_cast<const char *>(&coo.num_rows), sizeof(size_t));
     output.write(reinterpret_cast<const char *>(&coo.num_cols), sizeof(size_t));
     output.write(reinterpret_cast<const char *>(&coo.num_entries), sizeof(size_t));
-    output.write(reinterpret_cast<const char *>(&coo.row_indices[0]), coo.num_entries*sizeof(IndexType));
-    output.write(reinterpret_cast<const char *>(&coo.column_indices[0]), coo.num_entries*sizeof(IndexType));
-    output.write(reinterpret_cast<const char *>(&coo.values[0]), coo.num_entries*sizeof(ValueType));
+
+    if(coo.num_entries > 0)
+    {
+        output.write(reinterpret_cast<const char *>(&coo.row_indices[0]), coo.num_entries*sizeof(IndexType));
+        output.write(reinterpret_cast<const char *>(&coo.column_indices[0]), coo.num_entries*sizeof(IndexType));
+        output.write(reinterpret_cast<const char *>(&coo.values[0]), coo.num_entries*sizeof(ValueType));
+    }
+}
+
+template <typename Array, typename Stream>
+void write_binary_stream(const Array& a, Stream& output, cusp::array1d_format)
+{
+    typedef typename Array::value_type ValueType;
+
+    cusp::array1d<ValueType,cusp::host_memory> temp(a);
+
+    const size_t size = temp.size();
+
+    output.write(reinterpret_cast<const char *>(&size), sizeof(size_t));
+
+    if(size > 0)
+        output.write(reinterpret_cast<const char *>(&temp[0]), size*sizeof(ValueType));
 }
 
 template <typename Matrix, typename Stream>
@@ -0,0 +1,770 @@
+/*
+ *  Copyright 2008-2014 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+
+#pragma once
+
+#include <cusp/array1d.h>
+#include <cusp/coo_matrix.h>
+#include <cusp/convert.h>
+#include <cusp/exception.h>
+#include <cusp/functional.h>
+#include <cusp/io/mapped_binary.h>
+
+#include <thrust/scan.h>
+
+#include <thrust/iterator/counting_iterator.h>
+#include <thrust/iterator/transform_iterator.h>
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+namespace cusp
+{
+namespace io
+{
+namespace detail
+{
+
+// Layout of a compressed binary file (version 1)
+//
+//   [ header | size of block 0 | block 0 | size of block 1 | block 1 | ... ]
+//
+// The entries are split into blocks of block_size consecutive entries which
+// are encoded independently, each preceded by its size in bytes as a 64-bit
+// integer.  A block of a sparse matrix holds the encoded row indices, column
+// indices and values, a block of an array1d only the values:
+//
+//   index array : [ width (1 byte) | zigzag encoded deltas of width bits ]
+//   values      : [ 4-bit tag of every word | significant bytes ]
+//
+// Index deltas are taken from the previous entry of the same block and from
+// zero for its first entry.  Values are split into words of 8, 4 or 1 bytes,
+// every word is XORed with the same word of the previous value.  A tag t of
+// at most 8 stores the low t bytes of the XOR, a tag 8 + t the high t bytes,
+// whichever drops more zero bytes: values which differ only in sign or
+// exponent leave mostly trailing zeros, values which differ only in the
+// last digits mostly leading zeros.
+const unsigned long long compressed_binary_version      = 1;
+const unsigned long long compressed_binary_sparse       = 1;
+const unsigned long long compressed_binary_array1d      = 2;
+const size_t             compressed_binary_block_size   = 1 << 16;
+
+struct compressed_binary_header
+{
+    char               magic[8];
+    unsigned long long byte_order;
+    unsigned long long version;
+    unsigned long long kind;
+    unsigned long long index_kind;
+    unsigned long long index_size;
+    unsigned long long value_kind;
+    unsigned long long value_size;
+    unsigned long long num_rows;
+    unsigned long long num_cols;
+    unsigned long long num_entries;
+    unsigned long long block_size;
+    unsigned long long num_blocks;
+};
+
+inline const char* compressed_binary_magic(void)
+{
+    return "CUSPCBZ";
+}
+
+template <size_t Size, bool Wide = (Size % 8 == 0), bool Narrow = (Size % 4 == 0)>
+struct compressed_word
+{
+    typedef unsigned char type;
+};
+
+template <size_t Size>
+struct compressed_word<Size,true,true>
+{
+    typedef unsigned long long type;
+};
+
+template <size_t Size>
+struct compressed_word<Size,false,true>
+{
+    typedef unsigned int type;
+};
+
+inline unsigned long long zigzag_encode(const long long delta)
+{
+    return (static_cast<unsigned long long>(delta) << 1) ^ static_cast<unsigned long long>(delta >> 63);
+}
+
+inline long long zigzag_decode(const unsigned long long code)
+{
+    return static_cast<long long>(code >> 1) ^ -static_cast<long long>(code & 1);
+}
+
+inline size_t bit_width(unsigned long long value)
+{
+    size_t width = 0;
+
+    while (value != 0)
+    {
+        width++;
+        value >>= 1;
+    }
+
+    return width;
+}
+
+// little endian bit stream, fields wider than 32 bits are split in two
+class bit_writer
+{
+    std::vector<unsigned char>& output;
+    unsigned long long buffer;
+    size_t num_bits;
+
+    void put_bits(const unsigned long long value, const size_t width)
+    {
+        buffer |= value << num_bits;
+        num_bits += width;
+
+        while (num_bits >= 8)
+        {
+            output.push_back(static_cast<unsigned char>(buffer & 0xff));
+            buffer >>= 8;
+            num_bits -= 8;
+        }
+    }
+
+public:
+
+    bit_writer(std::vector<unsigned char>& output)
+        : output(output), buffer(0), num_bits(0) {}
+
+    void put(unsigned long long value, size_t width)
+    {
+        if (width > 32)
+        {
+            put_bits(value & 0xffffffffull, 32);
+            value >>= 32;
+            width -= 32;
+        }
+
+        put_bits(value, width);
+    }
+
+    void flush(void)
+    {
+        if (num_bits > 0)
+            output.push_back(static_cast<unsigned char>(buffer & 0xff));
+
+        buffer   = 0;
+        num_bits = 0;
+    }
+};
+
+class bit_reader
+{
+    const unsigned char* first;
+    unsigned long long buffer;
+    size_t num_bits;
+
+    unsigned long long get_bits(const size_t width)
+    {
+        while (num_bits < width)
+        {
+            buffer |= static_cast<unsigned long long>(*first++) << num_bits;
+            num_bits += 8;
+        }
+
+        const unsigned long long value = buffer & ((1ull << width) - 1);
+
+        buffer >>= width;
+        num_bits -= width;
+
+        return value;
+    }
+
+public:
+
+    // the caller guarantees the stream holds all fields it reads
+    bit_reader(const unsigned char* first)
+        : first(first), buffer(0), num_bits(0) {}
+
+    unsigned long long get(const size_t width)
+    {
+        if (width > 32)
+        {
+            const unsigned long long low = get_bits(32);
+            return low | (get_bits(width - 32) << 32);
+        }
+
+        return get_bits(width);
+    }
+};
+
+inline size_t packed_bytes(const size_t num_entries, const size_t width)
+{
+    return (num_entries * width + 7) / 8;
+}
+
+// largest encoding of a block, used to reject corrupt block sizes
+template <typename ValueType>
+size_t max_compressed_block_bytes(const size_t num_entries, const bool has_indices)
+{
+    typedef typename compressed_word<sizeof(ValueType)>::type Word;
+
+    const size_t num_words = num_entries * (sizeof(ValueType) / sizeof(Word));
+    const size_t value_bytes = (num_words + 1) / 2 + num_words * sizeof(Word);
+
+    return value_bytes + (has_indices ? 2 * (1 + packed_bytes(num_entries, 64)) : 0);
+}
+
+template <typename IndexType>
+void encode_index_block(const IndexType* indices, const size_t num_entries,
+                        std::vector<unsigned char>& output)
+{
+    size_t width = 0;
+    long long previous = 0;
+
+    for (size_t i = 0; i < num_entries; i++)
+    {
+        const long long index = static_cast<long long>(indices[i]);
+        width = std::max(width, bit_width(zigzag_encode(index - previous)));
+        previous = index;
+    }
+
+    output.push_back(static_cast<unsigned char>(width));
+
+    bit_writer writer(output);
+    previous = 0;
+
+    for (size_t i = 0; i < num_entries; i++)
+    {
+        const long long index = static_cast<long long>(indices[i]);
+        writer.put(zigzag_encode(index - previous), width);
+        previous = index;
+    }
+
+    writer.flush();
+}
+
+// decodes the indices, or only their deltas when accumulate is false so
+// that the prefix sums can be formed elsewhere; returns NULL if the block
+// is malformed
+template <typename IndexType>
+const unsigned char* decode_index_block(const unsigned char* first, const unsigned char* last,
+                                        IndexType* indices, const size_t num_entries,
+                                        const bool accumulate)
+{
+    if (first == last)
+        return NULL;
+
+    const size_t width = *first++;
+
+    if (width > 64 || size_t(last - first) < packed_bytes(num_entries, width))
+        return NULL;
+
+    bit_reader reader(first);
+    long long previous = 0;
+
+    for (size_t i = 0; i < num_entries; i++)
+    {
+        const long long delta = zigzag_decode(reader.get(width));
+
+        if (accumulate)
+        {
+            previous += delta;
+            indices[i] = static_cast<IndexType>(previous);
+        }
+        else
+        {
+            indices[i] = static_cast<IndexType>(delta);
+        }
+    }
+
+    return first + packed_bytes(num_entries, width);
+}
+
+template <typename ValueType>
+void encode_value_block(const ValueType* values, const size_t num_entries,
+                        std::vector<unsigned char>& output)
+{
+    typedef typename compressed_word<sizeof(ValueType)>::type Word;
+
+    const size_t stride    = sizeof(ValueType) / sizeof(Word);
+    const size_t num_words = num_entries * stride;
+    const char*  bytes     = reinterpret_cast<const char*>(values);
+
+    const size_t lengths = output.size();
+    output.resize(lengths + (num_words + 1) / 2, 0);
+
+    for (size_t k = 0; k < num_words; k++)
+    {
+        Word word, previous = 0;
+        std::memcpy(&word, bytes + k * sizeof(Word), sizeof(Word));
+
+        if (k >= stride)
+            std::memcpy(&previous, bytes + (k - stride) * sizeof(Word), sizeof(Word));
+
+        const Word code = word ^ previous;
+
+        // highest and lowest nonzero byte of the XOR
+        size_t high = 0, low = sizeof(Word);
+
+        for (size_t b = 0; b < sizeof(Word); b++)
+        {
+            if (((code >> (8 * b)) & 0xff) != 0)
+            {
+                high = b + 1;
+                low  = std::min(low, b);
+            }
+        }
+
+        // keep the low bytes up to the highest nonzero one, or the high
+        // bytes down to the lowest nonzero one when that is shorter
+        size_t length = high, first_byte = 0, tag = high;
+
+        if (high > 0 && sizeof(Word) - low < high)
+        {
+            length     = sizeof(Word) - low;
+            first_byte = low;
+            tag        = 8 + length;
+        }
+
+        for (size_t b = first_byte; b < first_byte + length; b++)
+            output.push_back(static_cast<unsigned char>((code >> (8 * b)) & 0xff));
+
+        output[lengths + k / 2] |= static_cast<unsigned char>(tag << (4 * (k % 2)));
+    }
+}
+
+template <typename ValueType>
+const unsigned char* decode_value_block(const unsigned char* first, const unsigned char* last,
+                                        ValueType* values, const size_t num_entries)
+{
+    typedef typename compressed_word<sizeof(ValueType)>::type Word;
+
+    const size_t stride    = sizeof(ValueType) / sizeof(Word);
+    const size_t num_words = num_entries * stride;
+    char*        bytes     = reinterpret_cast<char*>(values);
+
+    if (size_t(last - first) < (num_words + 1) / 2)
+        return NULL;
+
+    const unsigned char* lengths = first;
+    first += (num_words + 1) / 2;
+
+    for (size_t k = 0; k < num_words; k++)
+    {
+        const size_t tag = (lengths[k / 2] >> (4 * (k % 2))) & 0xf;
+
+        const bool low_bytes  = tag <= sizeof(Word);
+        const bool high_bytes = tag > 8 && tag - 8 < sizeof(Word);
+
+        const size_t length     = high_bytes ? tag - 8 : tag;
+        const size_t first_byte = high_bytes ? sizeof(Word) - length : 0;
+
+        if (!(low_bytes || high_bytes) || size_t(last - first) < length)
+            return NULL;
+
+        Word word = 0;
+
+        for (size_t b = 0; b < length; b++)
+            word |= static_cast<Word>(static_cast<Word>(first[b]) << (8 * (first_byte + b)));
+
+        first += length;
+
+        if (k >= stride)
+        {
+            Word previous;
+            std::memcpy(&previous, bytes + (k - stride) * sizeof(Word), sizeof(Word));
+            word ^= previous;
+        }
+
+        std::memcpy(bytes + k * sizeof(Word), &word, sizeof(Word));
+    }
+
+    return first;
+}
+
+template <typename IndexType, typename ValueType>
+void encode_compressed_block(const IndexType* row_indices, const IndexType* column_indices,
+                             const ValueType* values, const size_t num_entries,
+                             std::vector<unsigned char>& output)
+{
+    output.clear();
+
+    if (row_indices != NULL)
+    {
+        encode_index_block(row_indices,    num_entries, output);
+        encode_index_block(column_indices, num_entries, output);
+    }
+
+    encode_value_block(values, num_entries, output);
+}
+
+template <typename IndexType, typename ValueType>
+bool decode_compressed_block(const std::vector<unsigned char>& input,
+                             IndexType* row_indices, IndexType* column_indices,
+                             ValueType* values, const size_t num_entries,
+                             const bool accumulate)
+{
+    const unsigned char* first = input.empty() ? NULL : &input[0];
+    const unsigned char* last  = first + input.size();
+
+    if (row_indices != NULL)
+    {
+        first = decode_index_block(first, last, row_indices, num_entries, accumulate);
+
+        if (first != NULL)
+            first = decode_index_block(first, last, column_indices, num_entries, accumulate);
+
+        if (first == NULL)
+            return false;
+    }
+
+    first = decode_value_block(first, last, values, num_entries);
+
+    return first == last;
+}
+
+template <typename IndexType, typename ValueType>
+compressed_binary_header make_compressed_binary_header(const unsigned long long kind,
+                                                       const size_t num_rows,
+                                                       const size_t num_cols,
+                                                       const size_t num_entries)
+{
+    compressed_binary_header header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, compressed_binary_magic(), sizeof(header.magic));
+
+    header.byte_order  = mapped_binary_byte_order;
+    header.version     = compressed_binary_version;
+    header.kind        = kind;
+    header.index_kind  = mapped_type_kind<IndexType>::value;
+    header.index_size  = sizeof(IndexType);
+    header.value_kind  = mapped_type_kind<ValueType>::value;
+    header.value_size  = sizeof(ValueType);
+    header.num_rows    = num_rows;
+    header.num_cols    = num_cols;
+    header.num_entries = num_entries;
+    header.block_size  = compressed_binary_block_size;
+    header.num_blocks  = (num_entries + compressed_binary_block_size - 1) / compressed_binary_block_size;
+
+    return header;
+}
+
+template <typename IndexType, typename ValueType, typename Stream>
+compressed_binary_header read_compressed_binary_header(Stream& input, const unsigned long long kind)
+{
+    compressed_binary_header header;
+
+    input.read(reinterpret_cast<char *>(&header), sizeof(header));
+
+    if (!input || std::memcmp(header.magic, compressed_binary_magic(), sizeof(header.magic)) != 0)
+        throw cusp::io_exception("invalid compressed binary file");
+
+    if (header.byte_order != mapped_binary_byte_order)
+        throw cusp::io_exception("compressed binary file was written with a different byte order");
+
+    if (header.version != compressed_binary_version)
+        throw cusp::io_exception("unsupported compressed binary file version");
+
+    if (header.kind != kind)
+        throw cusp::io_exception("compressed binary file holds a different kind of container");
+
+    if (header.index_kind != mapped_type_kind<IndexType>::value || header.index_size != sizeof(IndexType) ||
+        header.value_kind != mapped_type_kind<ValueType>::value || header.value_size != sizeof(ValueType))
+        throw cusp::io_exception("compressed binary file holds different index or value types");
+
+    if (header.block_size == 0 || header.block_size > (1ull << 32) ||
+        header.num_blocks != (header.num_entries + header.block_size - 1) / header.block_size)
+        throw cusp::io_exception("inconsistent block layout in compressed binary file");
+
+    return header;
+}
+
+inline size_t compressed_batch_blocks(const size_t num_blocks)
+{
+#ifdef _OPENMP
+    return std::min<size_t>(num_blocks, 4 * omp_get_max_threads());
+#else
+    return std::min<size_t>(num_blocks, 1);
+#endif
+}
+
+// blocks are encoded in parallel, one batch at a time so that memory use
+// stays bounded, and written in order
+template <typename IndexType, typename ValueType, typename Stream>
+void write_compressed_blocks(Stream& output, const compressed_binary_header& header,
+                             const IndexType* row_indices, const IndexType* column_indices,
+                             const ValueType* values)
+{
+    const size_t num_blocks   = header.num_blocks;
+    const size_t block_size   = header.block_size;
+    const size_t batch_blocks = compressed_batch_blocks(num_blocks);
+
+    std::vector< std::vector<unsigned char> > buffers(batch_blocks);
+
+    for (size_t first_block = 0; first_block < num_blocks; first_block += batch_blocks)
+    {
+        const int count = std::min(batch_blocks, num_blocks - first_block);
+
+#ifdef _OPENMP
+        #pragma omp parallel for schedule(dynamic)
+#endif
+        for (int c = 0; c < count; c++)
+        {
+            const size_t first = (first_block + c) * block_size;
+            const size_t last  = std::min<size_t>(first + block_size, header.num_entries);
+
+            encode_compressed_block(row_indices    == NULL ? row_indices    : row_indices + first,
+                                    column_indices == NULL ? column_indices : column_indices + first,
+                                    values + first, last - first, buffers[c]);
+        }
+
+        for (int c = 0; c < count; c++)
+        {
+            const unsigned long long num_bytes = buffers[c].size();
+
+            output.write(reinterpret_cast<const char *>(&num_bytes), sizeof(num_bytes));
+
+            if (num_bytes > 0)
+                output.write(reinterpret_cast<const char *>(&buffers[c][0]), num_bytes);
+        }
+    }
+}
+
+// blocks are read in order, one batch at a time, and decoded in parallel
+// while the next batch waits to be read
+template <typename IndexType, typename ValueType, typename Stream>
+void read_compressed_blocks(Stream& input, const compressed_binary_header& header,
+                            IndexType* row_indices, IndexType* column_indices,
+                            ValueType* values, const bool accumulate)
+{
+    const size_t num_blocks   = header.num_blocks;
+    const size_t block_size   = header.block_size;
+    const size_t batch_blocks = compressed_batch_blocks(num_blocks);
+
+    std::vector< std::vector<unsigned char> > buffers(batch_blocks);
+    std::vector<int> valid(batch_blocks);
+
+    for (size_t first_block = 0; first_block < num_blocks; first_block += batch_blocks)
+    {
+        const int count = std::min(batch_blocks, num_blocks - first_block);
+
+        for (int c = 0; c < count; c++)
+        {
+            const size_t first = (first_block + c) * block_size;
+            const size_t last  = std::min<size_t>(first + block_size, header.num_entries);
+
+            unsigned long long num_bytes = 0;
+            input.read(reinterpret_cast<char *>(&num_bytes), sizeof(num_bytes));
+
+            if (!input || num_bytes > max_compressed_block_bytes<ValueType>(last - first, row_indices != NULL))
+                throw cusp::io_exception("invalid block size in compressed binary file");
+
+            buffers[c].resize(num_bytes);
+
+            if (num_bytes > 0)
+                input.read(reinterpret_cast<char *>(&buffers[c][0]), num_bytes);
+
+            if (!input)
+                throw cusp::io_exception("unexpected end of compressed binary file");
+        }
+
+#ifdef _OPENMP
+        #pragma omp parallel for schedule(dynamic)
+#endif
+        for (int c = 0; c < count; c++)
+        {
+            const size_t first = (first_block + c) * block_size;
+            const size_t last  = std::min<size_t>(first + block_size, header.num_entries);
+
+            valid[c] = decode_compressed_block(buffers[c],
+                                               row_indices    == NULL ? row_indices    : row_indices + first,
+                                               column_indices == NULL ? column_indices : column_indices + first,
+                                               values + first, last - first, accumulate);
+        }
+
+        for (int c = 0; c < count; c++)
+            if (!valid[c])
+                throw cusp::io_exception("corrupt block in compressed binary file");
+    }
+}
+
+template <typename Array>
+typename Array::value_type* compressed_data(Array& a)
+{
+    return a.empty() ? NULL : &a[0];
+}
+
+template <typename Array>
+const typename Array::value_type* compressed_data(const Array& a)
+{
+    return a.empty() ? NULL : &a[0];
+}
+
+// the blocks were decoded into final indices on the host
+template <typename IndexType, typename ValueType, typename Matrix>
+void finish_compressed_indices(cusp::coo_matrix<IndexType,ValueType,cusp::host_memory>& coo,
+                               const compressed_binary_header&,
+                               Matrix& mtx, cusp::host_memory)
+{
+    cusp::convert(coo, mtx);
+}
+
+// the blocks hold index deltas, which are summed up block by block in the
+// memory space of the destination
+template <typename IndexType, typename ValueType, typename Matrix, typename MemorySpace>
+void finish_compressed_indices(cusp::coo_matrix<IndexType,ValueType,cusp::host_memory>& coo,
+                               const compressed_binary_header& header,
+                               Matrix& mtx, MemorySpace)
+{
+    cusp::coo_matrix<IndexType,ValueType,MemorySpace> temp(coo);
+
+    thrust::transform_iterator< cusp::divide_value<size_t>, thrust::counting_iterator<size_t> >
+        blocks(thrust::counting_iterator<size_t>(0), cusp::divide_value<size_t>(header.block_size));
+
+    thrust::inclusive_scan_by_key(blocks, blocks + temp.num_entries,
+                                  temp.row_indices.begin(), temp.row_indices.begin());
+    thrust::inclusive_scan_by_key(blocks, blocks + temp.num_entries,
+                                  temp.column_indices.begin(), temp.column_indices.begin());
+
+    cusp::convert(temp, mtx);
+}
+
+template <typename Array, typename Stream>
+void read_compressed_binary_stream(Array& a, Stream& input, cusp::array1d_format)
+{
+    typedef typename Array::value_type ValueType;
+
+    const compressed_binary_header header =
+        read_compressed_binary_header<int,ValueType>(input, compressed_binary_array1d);
+
+    cusp::array1d<ValueType,cusp::host_memory> temp(header.num_entries);
+
+    read_compressed_blocks(input, header, (int*) NULL, (int*) NULL, compressed_data(temp), true);
+
+    a = temp;
+}
+
+template <typename Matrix, typename Stream, typename Format>
+void read_compressed_binary_stream(Matrix& mtx, Stream& input, Format)
+{
+    // general case
+    typedef typename Matrix::index_type   IndexType;
+    typedef typename Matrix::value_type   ValueType;
+    typedef typename Matrix::memory_space MemorySpace;
+
+    const compressed_binary_header header =
+        read_compressed_binary_header<IndexType,ValueType>(input, compressed_binary_sparse);
+
+    cusp::coo_matrix<IndexType,ValueType,cusp::host_memory> coo(header.num_rows, header.num_cols, header.num_entries);
+
+    // host destinations take the prefix sums while decoding
+    const bool accumulate = thrust::detail::is_same<MemorySpace,cusp::host_memory>::value;
+
+    read_compressed_blocks(input, header,
+                           compressed_data(coo.row_indices), compressed_data(coo.column_indices),
+                           compressed_data(coo.values), accumulate);
+
+    finish_compressed_indices(coo, header, mtx, MemorySpace());
+}
+
+template <typename Array, typename Stream>
+void write_compressed_binary_stream(const Array& a, Stream& output, cusp::array1d_format)
+{
+    typedef typename Array::value_type ValueType;
+
+    cusp::array1d<ValueType,cusp::host_memory> temp(a);
+
+    const compressed_binary_header header =
+        make_compressed_binary_header<int,ValueType>(compressed_binary_array1d, temp.size(), 1, temp.size());
+
+    output.write(reinterpret_cast<const char *>(&header), sizeof(header));
+
+    write_compressed_blocks(output, header, (const int*) NULL, (const int*) NULL, compressed_data(temp));
+}
+
+template <typename Matrix, typename Stream>
+void write_compressed_binary_stream(const Matrix& mtx, Stream& output, cusp::sparse_format)
+{
+    // general sparse case
+    typedef typename Matrix::index_type IndexType;
+    typedef typename Matrix::value_type ValueType;
+
+    cusp::coo_matrix<IndexType,ValueType,cusp::host_memory> coo(mtx);
+
+    // sorted entries have small deltas and need no sort when read back
+    if (!coo.is_sorted_by_row_and_column())
+        coo.sort_by_row_and_column();
+
+    const compressed_binary_header header =
+        make_compressed_binary_header<IndexType,ValueType>(compressed_binary_sparse,
+                                                           coo.num_rows, coo.num_cols, coo.num_entries);
+
+    output.write(reinterpret_cast<const char *>(&header), sizeof(header));
+
+    write_compressed_blocks(output, header,
+                            compressed_data(coo.row_indices), compressed_data(coo.column_indices),
+                            compressed_data(coo.values));
+}
+
+} // end namespace detail
+
+
+template <typename Matrix>
+void read_compressed_binary_file(Matrix& mtx, const std::string& filename)
+{
+    std::ifstream file(filename.c_str(), std::ios::binary);
+
+    if (!file)
+        throw cusp::io_exception(std::string("unable to open file \"") + filename + std::string("\" for reading"));
+
+    cusp::io::read_compressed_binary_stream(mtx, file);
+}
+
+template <typename Matrix, typename Stream>
+void read_compressed_binary_stream(Matrix& mtx, Stream& input)
+{
+    cusp::io::detail::read_compressed_binary_stream(mtx, input, typename Matrix::format());
+}
+
+template <typename Matrix>
+void write_compressed_binary_file(const Matrix& mtx, const std::string& filename)
+{
+    std::ofstream file(filename.c_str(), std::ios::binary);
+
+    if (!file)
+        throw cusp::io_exception(std::string("unable to open file \"") + filename + std::string("\" for writing"));
+
+    cusp::io::write_compressed_binary_stream(mtx, file);
+}
+
+template <typename Matrix, typename Stream>
+void write_compressed_binary_stream(const Matrix& mtx, Stream& output)
+{
+    cusp::io::detail::write_compressed_binary_stream(mtx, output, typename Matrix::format());
+}
+
+} // end namespace io
+} // end namespace cusp
@@ -152,24 +152,55 @@ read_dimacs_stream(Matrix& mtx, Stream& input, Format)
     return ret;
 }
 
+// formats arc i as "a <tail> <head> <capacity>", capacities are integral
+template <typename IndexType, typename ValueType>
+struct dimacs_line_formatter
+{
+    static const size_t max_line_length = 72;
+
+    const IndexType* row_indices;
+    const IndexType* column_indices;
+    const ValueType* values;
+
+    dimacs_line_formatter(const IndexType* row_indices, const IndexType* column_indices, const ValueType* values)
+        : row_indices(row_indices), column_indices(column_indices), values(values) {}
+
+    size_t operator()(char* buffer, size_t i) const
+    {
+        int val = values[i];
+
+        size_t length = 0;
+        buffer[length++] = 'a';
+        buffer[length++] = ' ';
+        length += format_integer(buffer + length, static_cast<long long>(row_indices[i]) + 1);
+        buffer[length++] = ' ';
+        length += format_integer(buffer + length, static_cast<long long>(column_indices[i]) + 1);
+        buffer[length++] = ' ';
+        length += format_integer(buffer + length, val);
+        buffer[length++] = '\n';
+        return length;
+    }
+};
+
 template <typename IndexType, typename ValueType, typename Stream>
 void write_dimacs_stream(const cusp::coo_matrix<IndexType,ValueType,cusp::host_memory>& coo,
                          const thrust::tuple<IndexType,IndexType>& t,
                          Stream& output)
 {
-    output << "p max " << coo.num_rows << " " << coo.num_entries << std::endl;
-    output << "n " << (thrust::get<0>(t) + 1) << " s" << std::endl;
-    output << "n " << (thrust::get<1>(t) + 1) << " t" << std::endl;
+    output << "p max " << coo.num_rows << " " << coo.num_entries << "\n";
+    output << "n " << (thrust::get<0>(t) + 1) << " s" << "\n";
+    output << "n " << (thrust::get<1>(t) + 1) << " t" << "\n";
 
-    for(size_t i = 0; i < coo.num_entries; i++)
+    if (coo.num_entries > 0)
     {
-        output << "a ";
-        output << (coo.row_indices[i]    + 1) << " ";
-        output << (coo.column_indices[i] + 1) << " ";
+        dimacs_line_formatter<IndexType,ValueType> format(thrust::raw_pointer_cast(&coo.row_indices[0]),
+                                                        thrust::raw_pointer_cast(&coo.column_indices[0]),
+                                                        thrust::raw_pointer_cast(&coo.values[0]));
 
-        int val = coo.values[i];
-        output << val << std::endl;
+        cusp::io::detail::write_lines(output, coo.num_entries, format);
     }
+
+    output.flush();
 }
 
 template <typename Matrix, typename Stream>
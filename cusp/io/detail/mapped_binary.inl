@@ -0,0 +1,480 @@
+/*
+ *  Copyright 2008-2014 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#pragma once
+
+#include <cusp/array1d.h>
+#include <cusp/array2d.h>
+#include <cusp/coo_matrix.h>
+#include <cusp/csr_matrix.h>
+#include <cusp/dia_matrix.h>
+#include <cusp/ell_matrix.h>
+#include <cusp/hyb_matrix.h>
+#include <cusp/complex.h>
+#include <cusp/exception.h>
+
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <string>
+
+namespace cusp
+{
+namespace io
+{
+namespace detail
+{
+
+// Layout of a mapped binary file (version 1)
+//
+//   [ header | pad | array 0 | pad | array 1 | pad | ... ]
+//
+// Every array starts at a multiple of mapped_binary_alignment bytes from the
+// beginning of the file.  All header fields are 64-bit so the layout does not
+// depend on the compiler; the byte_order field rejects files written on a
+// machine with a different endianness.
+const unsigned long long mapped_binary_version    = 1;
+const unsigned long long mapped_binary_byte_order = 0x0102030405060708ull;
+const size_t             mapped_binary_alignment  = 64;
+const size_t             mapped_binary_max_arrays = 5;
+
+struct mapped_binary_header
+{
+    char               magic[8];
+    unsigned long long byte_order;
+    unsigned long long version;
+    unsigned long long format;
+    unsigned long long index_kind;
+    unsigned long long index_size;
+    unsigned long long value_kind;
+    unsigned long long value_size;
+    unsigned long long num_rows;
+    unsigned long long num_cols;
+    unsigned long long num_entries;
+    unsigned long long parameters[4];                      // format specific shape information
+    unsigned long long offsets[mapped_binary_max_arrays];  // byte offset of each array
+    unsigned long long lengths[mapped_binary_max_arrays];  // number of elements in each array
+};
+
+inline const char* mapped_binary_magic(void)
+{
+    return "CUSPBIN";
+}
+
+// 1 = signed integer, 2 = unsigned integer, 3 = real, 4 = complex
+template <typename T>
+struct mapped_type_kind
+{
+    static const unsigned long long value =
+        std::numeric_limits<T>::is_integer ? (std::numeric_limits<T>::is_signed ? 1 : 2) : 3;
+};
+
+template <typename T>
+struct mapped_type_kind< cusp::complex<T> >
+{
+    static const unsigned long long value = 4;
+};
+
+inline size_t round_up_to_alignment(size_t n)
+{
+    return (n + mapped_binary_alignment - 1) / mapped_binary_alignment * mapped_binary_alignment;
+}
+
+// array slot of a matrix being written: where it lives and how large it is
+struct mapped_array
+{
+    const char* data;
+    size_t      length;
+    size_t      element_size;
+
+    mapped_array(void) : data(NULL), length(0), element_size(0) {}
+
+    template <typename Array>
+    mapped_array(const Array& a)
+        : data(a.size() > 0 ? reinterpret_cast<const char*>(thrust::raw_pointer_cast(&a[0])) : NULL),
+          length(a.size()), element_size(sizeof(typename Array::value_type)) {}
+};
+
+template <typename T>
+cusp::array1d_view<const T*> mapped_array_view(const mapped_binary_header& header, const char* base, size_t i)
+{
+    const T* first = reinterpret_cast<const T*>(base + header.offsets[i]);
+    return cusp::array1d_view<const T*>(first, first + header.lengths[i]);
+}
+
+inline void check_mapped_array(const mapped_binary_header& header, size_t i, size_t expected_length)
+{
+    if (header.lengths[i] != expected_length)
+        throw cusp::io_exception("inconsistent array length in mapped binary file");
+}
+
+template <typename IndexType, typename ValueType, typename Format>
+struct mapped_format_traits;
+
+template <typename IndexType, typename ValueType>
+struct mapped_format_traits<IndexType,ValueType,cusp::coo_format>
+{
+    typedef cusp::array1d_view<const IndexType*> IndexView;
+    typedef cusp::array1d_view<const ValueType*> ValueView;
+
+    typedef cusp::coo_matrix<IndexType,ValueType,cusp::host_memory> container;
+    typedef cusp::coo_matrix_view<IndexView,IndexView,ValueView>   view;
+
+    static const unsigned long long format_id  = 1;
+    static const size_t             num_arrays = 3;
+
+    static size_t element_size(size_t i)
+    {
+        return i < 2 ? sizeof(IndexType) : sizeof(ValueType);
+    }
+
+    static void describe(const container& A, mapped_binary_header& header, mapped_array* arrays)
+    {
+        arrays[0] = mapped_array(A.row_indices);
+        arrays[1] = mapped_array(A.column_indices);
+        arrays[2] = mapped_array(A.values);
+    }
+
+    static view make_view(const mapped_binary_header& header, const char* base)
+    {
+        check_mapped_array(header, 0, header.num_entries);
+        check_mapped_array(header, 1, header.num_entries);
+        check_mapped_array(header, 2, header.num_entries);
+
+        return view(header.num_rows, header.num_cols, header.num_entries,
+                    mapped_array_view<IndexType>(header, base, 0),
+                    mapped_array_view<IndexType>(header, base, 1),
+                    mapped_array_view<ValueType>(header, base, 2));
+    }
+};
+
+template <typename IndexType, typename ValueType>
+struct mapped_format_traits<IndexType,ValueType,cusp::csr_format>
+{
+    typedef cusp::array1d_view<const IndexType*> IndexView;
+    typedef cusp::array1d_view<const ValueType*> ValueView;
+
+    typedef cusp::csr_matrix<IndexType,ValueType,cusp::host_memory> container;
+    typedef cusp::csr_matrix_view<IndexView,IndexView,ValueView>   view;
+
+    static const unsigned long long format_id  = 2;
+    static const size_t             num_arrays = 3;
+
+    static size_t element_size(size_t i)
+    {
+        return i < 2 ? sizeof(IndexType) : sizeof(ValueType);
+    }
+
+    static void describe(const container& A, mapped_binary_header& header, mapped_array* arrays)
+    {
+        arrays[0] = mapped_array(A.row_offsets);
+        arrays[1] = mapped_array(A.column_indices);
+        arrays[2] = mapped_array(A.values);
+    }
+
+    static view make_view(const mapped_binary_header& header, const char* base)
+    {
+        check_mapped_array(header, 0, header.num_rows + 1);
+        check_mapped_array(header, 1, header.num_entries);
+        check_mapped_array(header, 2, header.num_entries);
+
+        return view(header.num_rows, header.num_cols, header.num_entries,
+                    mapped_array_view<IndexType>(header, base, 0),
+                    mapped_array_view<IndexType>(header, base, 1),
+                    mapped_array_view<ValueType>(header, base, 2));
+    }
+};
+
+template <typename IndexType, typename ValueType>
+struct mapped_format_traits<IndexType,ValueType,cusp::ell_format>
+{
+    typedef cusp::array1d_view<const IndexType*>                IndexView;
+    typedef cusp::array1d_view<const ValueType*>                ValueView;
+    typedef cusp::array2d_view<IndexView,cusp::column_major>    IndexView2d;
+    typedef cusp::array2d_view<ValueView,cusp::column_major>    ValueView2d;
+
+    typedef cusp::ell_matrix<IndexType,ValueType,cusp::host_memory> container;
+    typedef cusp::ell_matrix_view<IndexView2d,ValueView2d>         view;
+
+    static const unsigned long long format_id  = 3;
+    static const size_t             num_arrays = 2;
+
+    static size_t element_size(size_t i)
+    {
+        return i < 1 ? sizeof(IndexType) : sizeof(ValueType);
+    }
+
+    // parameters: entries per row, column index pitch, value pitch
+    static void describe(const container& A, mapped_binary_header& header, mapped_array* arrays)
+    {
+        header.parameters[0] = A.column_indices.num_cols;
+        header.parameters[1] = A.column_indices.pitch;
+        header.parameters[2] = A.values.pitch;
+
+        arrays[0] = mapped_array(A.column_indices.values);
+        arrays[1] = mapped_array(A.values.values);
+    }
+
+    template <typename ArrayView>
+    static cusp::array2d_view<ArrayView,cusp::column_major>
+    make_view2d(size_t num_rows, size_t num_cols, size_t pitch, const ArrayView& values)
+    {
+        if (num_cols > 0 && pitch < num_rows)
+            throw cusp::io_exception("inconsistent pitch in mapped binary file");
+
+        if (values.size() != pitch * num_cols)
+            throw cusp::io_exception("inconsistent array length in mapped binary file");
+
+        return cusp::array2d_view<ArrayView,cusp::column_major>(num_rows, num_cols, pitch, values);
+    }
+
+    static view make_view(const mapped_binary_header& header, const char* base)
+    {
+        return view(header.num_rows, header.num_cols, header.num_entries,
+                    make_view2d(header.num_rows, header.parameters[0], header.parameters[1],
+                                mapped_array_view<IndexType>(header, base, 0)),
+                    make_view2d(header.num_rows, header.parameters[0], header.parameters[2],
+                                mapped_array_view<ValueType>(header, base, 1)));
+    }
+};
+
+template <typename IndexType, typename ValueType>
+struct mapped_format_traits<IndexType,ValueType,cusp::dia_format>
+{
+    typedef cusp::array1d_view<const IndexType*>                IndexView;
+    typedef cusp::array1d_view<const ValueType*>                ValueView;
+    typedef cusp::array2d_view<ValueView,cusp::column_major>    ValueView2d;
+
+    typedef cusp::dia_matrix<IndexType,ValueType,cusp::host_memory> container;
+    typedef cusp::dia_matrix_view<IndexView,ValueView2d>           view;
+
+    static const unsigned long long format_id  = 4;
+    static const size_t             num_arrays = 2;
+
+    static size_t element_size(size_t i)
+    {
+        return i < 1 ? sizeof(IndexType) : sizeof(ValueType);
+    }
+
+    // parameters: number of diagonals, value pitch
+    static void describe(const container& A, mapped_binary_header& header, mapped_array* arrays)
+    {
+        header.parameters[0] = A.values.num_cols;
+        header.parameters[1] = A.values.pitch;
+
+        arrays[0] = mapped_array(A.diagonal_offsets);
+        arrays[1] = mapped_array(A.values.values);
+    }
+
+    static view make_view(const mapped_binary_header& header, const char* base)
+    {
+        check_mapped_array(header, 0, header.parameters[0]);
+
+        return view(header.num_rows, header.num_cols, header.num_entries,
+                    mapped_array_view<IndexType>(header, base, 0),
+                    mapped_format_traits<IndexType,ValueType,cusp::ell_format>::make_view2d(
+                        header.num_rows, header.parameters[0], header.parameters[1],
+                        mapped_array_view<ValueType>(header, base, 1)));
+    }
+};
+
+template <typename IndexType, typename ValueType>
+struct mapped_format_traits<IndexType,ValueType,cusp::hyb_format>
+{
+    typedef mapped_format_traits<IndexType,ValueType,cusp::ell_format> EllTraits;
+    typedef mapped_format_traits<IndexType,ValueType,cusp::coo_format> CooTraits;
+
+    typedef cusp::hyb_matrix<IndexType,ValueType,cusp::host_memory>              container;
+    typedef cusp::hyb_matrix_view<typename EllTraits::view,typename CooTraits::view> view;
+
+    static const unsigned long long format_id  = 5;
+    static const size_t             num_arrays = 5;
+
+    // ELL column indices and values followed by the COO arrays
+    static size_t element_size(size_t i)
+    {
+        return i < 2 ? EllTraits::element_size(i) : CooTraits::element_size(i - 2);
+    }
+
+    // parameters: ELL entries per row, ELL column index pitch, ELL value
+    // pitch, number of ELL entries
+    static void describe(const container& A, mapped_binary_header& header, mapped_array* arrays)
+    {
+        EllTraits::describe(A.ell, header, arrays);
+        header.parameters[3] = A.ell.num_entries;
+
+        arrays[2] = mapped_array(A.coo.row_indices);
+        arrays[3] = mapped_array(A.coo.column_indices);
+        arrays[4] = mapped_array(A.coo.values);
+    }
+
+    static view make_view(const mapped_binary_header& header, const char* base)
+    {
+        if (header.parameters[3] > header.num_entries)
+            throw cusp::io_exception("inconsistent number of entries in mapped binary file");
+
+        const size_t num_ell_entries = header.parameters[3];
+        const size_t num_coo_entries = header.num_entries - num_ell_entries;
+
+        typename EllTraits::view ell(header.num_rows, header.num_cols, num_ell_entries,
+                                     EllTraits::make_view2d(header.num_rows, header.parameters[0], header.parameters[1],
+                                                            mapped_array_view<IndexType>(header, base, 0)),
+                                     EllTraits::make_view2d(header.num_rows, header.parameters[0], header.parameters[2],
+                                                            mapped_array_view<ValueType>(header, base, 1)));
+
+        check_mapped_array(header, 2, num_coo_entries);
+        check_mapped_array(header, 3, num_coo_entries);
+        check_mapped_array(header, 4, num_coo_entries);
+
+        typename CooTraits::view coo(header.num_rows, header.num_cols, num_coo_entries,
+                                     mapped_array_view<IndexType>(header, base, 2),
+                                     mapped_array_view<IndexType>(header, base, 3),
+                                     mapped_array_view<ValueType>(header, base, 4));
+
+        return view(ell, coo);
+    }
+};
+
+template <typename Matrix>
+struct mapped_matrix_traits
+    : public mapped_format_traits<typename Matrix::index_type,
+                                  typename Matrix::value_type,
+                                  typename Matrix::format>
+{
+    typedef typename Matrix::index_type IndexType;
+    typedef typename Matrix::value_type ValueType;
+
+    static void initialize_header(mapped_binary_header& header)
+    {
+        std::memset(&header, 0, sizeof(mapped_binary_header));
+        std::strncpy(header.magic, mapped_binary_magic(), sizeof(header.magic));
+
+        header.byte_order = mapped_binary_byte_order;
+        header.version    = mapped_binary_version;
+        header.format     = mapped_matrix_traits::format_id;
+        header.index_kind = mapped_type_kind<IndexType>::value;
+        header.index_size = sizeof(IndexType);
+        header.value_kind = mapped_type_kind<ValueType>::value;
+        header.value_size = sizeof(ValueType);
+    }
+
+    static void check_header(const mapped_binary_header& header, size_t file_size)
+    {
+        if (std::strncmp(header.magic, mapped_binary_magic(), sizeof(header.magic)) != 0)
+            throw cusp::io_exception("not a mapped binary matrix file");
+
+        if (header.byte_order != mapped_binary_byte_order)
+            throw cusp::io_exception("mapped binary file was written with a different byte order");
+
+        if (header.version != mapped_binary_version)
+            throw cusp::io_exception("unsupported mapped binary file version");
+
+        if (header.format != mapped_matrix_traits::format_id)
+            throw cusp::io_exception("mapped binary file holds a different matrix format");
+
+        if (header.index_kind != mapped_type_kind<IndexType>::value || header.index_size != sizeof(IndexType))
+            throw cusp::io_exception("mapped binary file holds a different index type");
+
+        if (header.value_kind != mapped_type_kind<ValueType>::value || header.value_size != sizeof(ValueType))
+            throw cusp::io_exception("mapped binary file holds a different value type");
+
+        for (size_t i = 0; i < mapped_matrix_traits::num_arrays; i++)
+        {
+            if (header.offsets[i] % mapped_binary_alignment != 0)
+                throw cusp::io_exception("misaligned array in mapped binary file");
+
+            if (header.offsets[i] > file_size ||
+                header.lengths[i] > (file_size - header.offsets[i]) / mapped_matrix_traits::element_size(i))
+                throw cusp::io_exception("mapped binary file is truncated");
+        }
+    }
+
+    static typename mapped_matrix_traits::view map(const mapped_file& file, const std::string& filename)
+    {
+        mapped_binary_header header;
+
+        if (file.size() < sizeof(header))
+            throw cusp::io_exception(std::string("file \"") + filename + std::string("\" is not a mapped binary matrix file"));
+
+        std::memcpy(&header, file.begin(), sizeof(header));
+
+        check_header(header, file.size());
+
+        return mapped_matrix_traits::make_view(header, file.begin());
+    }
+};
+
+} // end namespace detail
+
+template <typename Matrix>
+void write_mapped_binary_file(const Matrix& mtx, const std::string& filename)
+{
+    typedef cusp::io::detail::mapped_matrix_traits<Matrix> Traits;
+    typedef typename Traits::container                       Container;
+
+    Container A(mtx);
+
+    cusp::io::detail::mapped_binary_header header;
+    cusp::io::detail::mapped_array arrays[cusp::io::detail::mapped_binary_max_arrays];
+
+    Traits::initialize_header(header);
+    Traits::describe(A, header, arrays);
+
+    header.num_rows    = A.num_rows;
+    header.num_cols    = A.num_cols;
+    header.num_entries = A.num_entries;
+
+    size_t offset = cusp::io::detail::round_up_to_alignment(sizeof(header));
+
+    for (size_t i = 0; i < Traits::num_arrays; i++)
+    {
+        header.offsets[i] = offset;
+        header.lengths[i] = arrays[i].length;
+        offset = cusp::io::detail::round_up_to_alignment(offset + arrays[i].length * arrays[i].element_size);
+    }
+
+    std::ofstream file(filename.c_str(), std::ios::binary);
+
+    if (!file)
+        throw cusp::io_exception(std::string("unable to open file \"") + filename + std::string("\" for writing"));
+
+    const char padding[cusp::io::detail::mapped_binary_alignment] = {0};
+
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    size_t position = sizeof(header);
+
+    for (size_t i = 0; i < Traits::num_arrays; i++)
+    {
+        file.write(padding, header.offsets[i] - position);
+        file.write(arrays[i].data, arrays[i].length * arrays[i].element_size);
+        position = header.offsets[i] + arrays[i].length * arrays[i].element_size;
+    }
+
+    if (!file)
+        throw cusp::io_exception(std::string("error writing file \"") + filename + std::string("\""));
+}
+
+template <typename Matrix>
+mapped_binary_file<Matrix>
+::mapped_binary_file(const std::string& filename)
+    : file_(filename),
+      view_(cusp::io::detail::mapped_matrix_traits<Matrix>::map(file_, filename))
+{
+}
+
+} //end namespace io
+} //end namespace cusp
+
@@ -0,0 +1,128 @@
+/*
+ *  Copyright 2008-2014 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+
+#pragma once
+
+#include <cusp/detail/config.h>
+#include <cusp/exception.h>
+
+#include <string>
+#include <vector>
+#include <fstream>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace cusp
+{
+namespace io
+{
+namespace detail
+{
+
+// read-only view of a whole file, memory mapped where the platform allows it
+class mapped_file
+{
+public:
+    mapped_file(const std::string& filename)
+        : data_(NULL), size_(0)
+    {
+#if defined(__unix__) || defined(__APPLE__)
+        map_ = NULL;
+
+        int fd = ::open(filename.c_str(), O_RDONLY);
+
+        if (fd < 0)
+            throw cusp::io_exception(std::string("unable to open file \"") + filename + std::string("\" for reading"));
+
+        struct stat st;
+
+        if (::fstat(fd, &st) != 0)
+        {
+            ::close(fd);
+            throw cusp::io_exception(std::string("unable to stat file \"") + filename + std::string("\""));
+        }
+
+        size_ = st.st_size;
+
+        if (size_ > 0)
+        {
+            map_ = ::mmap(NULL, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+
+            if (map_ == MAP_FAILED)
+            {
+                ::close(fd);
+                throw cusp::io_exception(std::string("unable to map file \"") + filename + std::string("\""));
+            }
+
+            ::madvise(map_, size_, MADV_SEQUENTIAL);
+            data_ = static_cast<const char*>(map_);
+        }
+
+        ::close(fd);
+#else
+        std::ifstream file(filename.c_str(), std::ios::in | std::ios::binary);
+
+        if (!file)
+            throw cusp::io_exception(std::string("unable to open file \"") + filename + std::string("\" for reading"));
+
+        file.seekg(0, std::ios::end);
+        buffer_.resize(static_cast<size_t>(file.tellg()));
+        file.seekg(0, std::ios::beg);
+
+        if (!buffer_.empty())
+            file.read(&buffer_[0], buffer_.size());
+
+        size_ = buffer_.size();
+        data_ = size_ > 0 ? &buffer_[0] : NULL;
+#endif
+    }
+
+    ~mapped_file(void)
+    {
+#if defined(__unix__) || defined(__APPLE__)
+        if (map_ != NULL)
+            ::munmap(map_, size_);
+#endif
+    }
+
+    const char* begin(void) const { return data_; }
+    const char* end(void)   const { return data_ + size_; }
+    size_t      size(void)  const { return size_; }
+
+private:
+    // noncopyable
+    mapped_file(const mapped_file&);
+    mapped_file& operator=(const mapped_file&);
+
+    const char* data_;
+    size_t      size_;
+#if defined(__unix__) || defined(__APPLE__)
+    void*       map_;
+#else
+    std::vector<char> buffer_;
+#endif
+};
+
+} // end namespace detail
+} // end namespace io
+} // end namespace cusp
+
@@ -17,12 +17,17 @@
 
 #pragma once
 
+#include <cusp/array1d.h>
 #include <cusp/array2d.h>
 #include <cusp/coo_matrix.h>
 #include <cusp/complex.h>
 #include <cusp/convert.h>
+#include <cusp/copy.h>
+#include <cusp/csr_matrix.h>
 #include <cusp/exception.h>
+#include <cusp/io/detail/mapped_file.h>
 
+#include <thrust/fill.h>
 #include <thrust/sort.h>
 
 #include <vector>
@@ -31,6 +36,15 @@
 #include <sstream>
 #include <iostream>
 #include <algorithm>
+#include <limits>
+#include <utility>
+#include <cstdlib>
+#include <cstring>
+#include <stdio.h>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 
 namespace cusp
 {
@@ -111,18 +125,6 @@ void assign_complex(cusp::complex<ScalarType>& value, double real, double imag)
     value.imag(imag);
 }
 
-template <typename Stream, typename ScalarType>
-void write_value(Stream& output, const ScalarType& value)
-{
-    output << value;
-}
-
-template <typename Stream, typename ScalarType>
-void write_value(Stream& output, const cusp::complex<ScalarType>& value)
-{
-    output << value.real() << " " << value.imag();
-}
-
 template<typename Stream>
 thrust::tuple<size_t,size_t,size_t>
 read_input_size(Stream& input)
@@ -152,12 +154,10 @@ read_input_size(Stream& input)
     return thrust::tie(num_rows, num_cols, num_entries);
 }
 
-template <typename MatrixType, typename Stream>
-void read_coordinate_stream(MatrixType& coo,
-                            Stream& input,
-                            const matrix_market_banner& banner,
-                            cusp::host_memory,
-                            cusp::coo_format)
+// validates the base-1 indices read from a coordinate file, converts them to
+// base-0, expands symmetric storage and sorts the entries by (row,column)
+template <typename MatrixType>
+void finalize_coordinate_entries(MatrixType& coo, const matrix_market_banner& banner)
 {
     typedef typename MatrixType::index_type IndexType;
     typedef typename MatrixType::value_type ValueType;
@@ -165,61 +165,6 @@ void read_coordinate_stream(MatrixType& coo,
     size_t num_rows = coo.num_rows;
     size_t num_cols = coo.num_cols;
 
-    size_t num_entries_read = 0;
-
-    // read file contents
-    if (banner.type == "pattern")
-    {
-        while(num_entries_read < coo.num_entries && !input.eof())
-        {
-            input >> coo.row_indices[num_entries_read];
-            input >> coo.column_indices[num_entries_read];
-            num_entries_read++;
-        }
-
-        std::fill(coo.values.begin(), coo.values.end(), ValueType(1));
-    }
-    else if (banner.type == "real" || banner.type == "integer")
-    {
-        while(num_entries_read < coo.num_entries && !input.eof())
-        {
-            double real;
-
-            input >> coo.row_indices[num_entries_read];
-            input >> coo.column_indices[num_entries_read];
-            input >> real;
-
-            coo.values[num_entries_read] = real;
-            num_entries_read++;
-        }
-    }
-    else if (banner.type == "complex")
-    {
-        while(num_entries_read < coo.num_entries && !input.eof())
-        {
-            double real, imag;
-
-            input >> coo.row_indices[num_entries_read];
-            input >> coo.column_indices[num_entries_read];
-            input >> real;
-            input >> imag;
-
-            assign_complex(coo.values[num_entries_read], real, imag);
-
-            num_entries_read++;
-        }
-    }
-    else
-    {
-        throw cusp::io_exception("invalid MatrixMarket data type");
-    }
-
-    if(num_entries_read != coo.num_entries)
-    {
-        std::cerr << " Read " << num_entries_read << " out of " << coo.num_entries << " expected entries!" << std::endl;
-        throw cusp::io_exception("unexpected EOF while reading MatrixMarket entries");
-    }
-
     // check validity of row and column index data
     if (coo.num_entries > 0)
     {
@@ -278,13 +223,47 @@ void read_coordinate_stream(MatrixType& coo,
         }
         else if (banner.symmetry == "hermitian")
         {
-            throw cusp::not_implemented_exception("MatrixMarket I/O does not currently support hermitian matrices");
-            //TODO
+            size_t nnz = 0;
+
+            for (size_t n = 0; n < coo.num_entries; n++)
+            {
+                // copy entry over
+                general.row_indices[nnz]    = coo.row_indices[n];
+                general.column_indices[nnz] = coo.column_indices[n];
+                general.values[nnz]         = coo.values[n];
+                nnz++;
+
+                // mirror off-diagonals as their conjugates
+                if (coo.row_indices[n] != coo.column_indices[n])
+                {
+                    general.row_indices[nnz]    = coo.column_indices[n];
+                    general.column_indices[nnz] = coo.row_indices[n];
+                    general.values[nnz]         = cusp::conj(coo.values[n]);
+                    nnz++;
+                }
+            }
         }
         else if (banner.symmetry == "skew-symmetric")
         {
-            //TODO
-            throw cusp::not_implemented_exception("MatrixMarket I/O does not currently support skew-symmetric matrices");
+            size_t nnz = 0;
+
+            for (size_t n = 0; n < coo.num_entries; n++)
+            {
+                // copy entry over
+                general.row_indices[nnz]    = coo.row_indices[n];
+                general.column_indices[nnz] = coo.column_indices[n];
+                general.values[nnz]         = coo.values[n];
+                nnz++;
+
+                // mirror off-diagonals with opposite sign
+                if (coo.row_indices[n] != coo.column_indices[n])
+                {
+                    general.row_indices[nnz]    = coo.column_indices[n];
+                    general.column_indices[nnz] = coo.row_indices[n];
+                    general.values[nnz]         = -coo.values[n];
+                    nnz++;
+                }
+            }
         }
 
         // store full matrix in coo
@@ -295,6 +274,73 @@ void read_coordinate_stream(MatrixType& coo,
     coo.sort_by_row_and_column();
 }
 
+template <typename MatrixType, typename Stream>
+void read_coordinate_stream(MatrixType& coo,
+                            Stream& input,
+                            const matrix_market_banner& banner,
+                            cusp::host_memory,
+                            cusp::coo_format)
+{
+    typedef typename MatrixType::value_type ValueType;
+
+    size_t num_entries_read = 0;
+
+    // read file contents
+    if (banner.type == "pattern")
+    {
+        while(num_entries_read < coo.num_entries && !input.eof())
+        {
+            input >> coo.row_indices[num_entries_read];
+            input >> coo.column_indices[num_entries_read];
+            num_entries_read++;
+        }
+
+        std::fill(coo.values.begin(), coo.values.end(), ValueType(1));
+    }
+    else if (banner.type == "real" || banner.type == "integer")
+    {
+        while(num_entries_read < coo.num_entries && !input.eof())
+        {
+            double real;
+
+            input >> coo.row_indices[num_entries_read];
+            input >> coo.column_indices[num_entries_read];
+            input >> real;
+
+            coo.values[num_entries_read] = real;
+            num_entries_read++;
+        }
+    }
+    else if (banner.type == "complex")
+    {
+        while(num_entries_read < coo.num_entries && !input.eof())
+        {
+            double real, imag;
+
+            input >> coo.row_indices[num_entries_read];
+            input >> coo.column_indices[num_entries_read];
+            input >> real;
+            input >> imag;
+
+            assign_complex(coo.values[num_entries_read], real, imag);
+
+            num_entries_read++;
+        }
+    }
+    else
+    {
+        throw cusp::io_exception("invalid MatrixMarket data type");
+    }
+
+    if(num_entries_read != coo.num_entries)
+    {
+        std::cerr << " Read " << num_entries_read << " out of " << coo.num_entries << " expected entries!" << std::endl;
+        throw cusp::io_exception("unexpected EOF while reading MatrixMarket entries");
+    }
+
+    finalize_coordinate_entries(coo, banner);
+}
+
 template <typename IndexType, typename ValueType, typename Stream>
 void read_coordinate_stream(cusp::csr_matrix<IndexType,ValueType,cusp::host_memory>& csr, Stream& input, const matrix_market_banner& banner)
 {
@@ -420,6 +466,149 @@ void read_array_stream(cusp::array2d<ValueType,cusp::host_memory>& mtx, Stream&
 
 
 
+// formats value into buffer the way an ostream with default flags would,
+// returns the number of characters written
+inline size_t format_integer(char* buffer, long long value)
+{
+    char digits[24];
+    size_t num_digits = 0;
+
+    unsigned long long v = value < 0 ? 0ull - static_cast<unsigned long long>(value) : value;
+
+    do
+    {
+        digits[num_digits++] = '0' + (v % 10);
+        v /= 10;
+    } while (v != 0);
+
+    size_t length = 0;
+
+    if (value < 0)
+        buffer[length++] = '-';
+
+    while (num_digits > 0)
+        buffer[length++] = digits[--num_digits];
+
+    return length;
+}
+
+template <typename ScalarType>
+size_t format_value(char* buffer, const ScalarType& value)
+{
+    return format_integer(buffer, static_cast<long long>(value));
+}
+
+inline size_t format_value(char* buffer, const double& value)
+{
+    return ::snprintf(buffer, 32, "%g", value);
+}
+
+inline size_t format_value(char* buffer, const float& value)
+{
+    return format_value(buffer, static_cast<double>(value));
+}
+
+template <typename ScalarType>
+size_t format_value(char* buffer, const cusp::complex<ScalarType>& value)
+{
+    size_t length = format_value(buffer, value.real());
+    buffer[length++] = ' ';
+    return length + format_value(buffer + length, value.imag());
+}
+
+// Writes num_lines lines produced by format(buffer, i) to output.  Lines
+// are formatted in chunks by separate OpenMP threads into private buffers
+// and the buffers are written to output in order, one batch of chunks at
+// a time so that memory use stays bounded.
+template <typename Stream, typename LineFormatter>
+void write_lines(Stream& output, size_t num_lines, const LineFormatter& format)
+{
+    const size_t chunk_lines = 16384;
+    const size_t num_chunks  = (num_lines + chunk_lines - 1) / chunk_lines;
+
+#ifdef _OPENMP
+    const size_t batch_chunks = std::min<size_t>(num_chunks, 4 * omp_get_max_threads());
+#else
+    const size_t batch_chunks = std::min<size_t>(num_chunks, 1);
+#endif
+
+    const size_t buffer_size = std::min(num_lines, chunk_lines) * LineFormatter::max_line_length;
+
+    std::vector< std::vector<char> > buffers(batch_chunks, std::vector<char>(buffer_size));
+    std::vector<size_t> lengths(batch_chunks);
+
+    for (size_t first_chunk = 0; first_chunk < num_chunks; first_chunk += batch_chunks)
+    {
+        const int count = std::min(batch_chunks, num_chunks - first_chunk);
+
+#ifdef _OPENMP
+        #pragma omp parallel for schedule(dynamic)
+#endif
+        for (int c = 0; c < count; c++)
+        {
+            const size_t first = (first_chunk + c) * chunk_lines;
+            const size_t last  = std::min(first + chunk_lines, num_lines);
+
+            char*  buffer = &buffers[c][0];
+            size_t length = 0;
+
+            for (size_t i = first; i < last; i++)
+                length += format(buffer + length, i);
+
+            lengths[c] = length;
+        }
+
+        for (int c = 0; c < count; c++)
+            output.write(&buffers[c][0], lengths[c]);
+    }
+}
+
+template <typename IndexType, typename ValueType>
+struct coordinate_line_formatter
+{
+    static const size_t max_line_length = 128;
+
+    const IndexType* row_indices;
+    const IndexType* column_indices;
+    const ValueType* values;
+
+    coordinate_line_formatter(const IndexType* row_indices, const IndexType* column_indices, const ValueType* values)
+        : row_indices(row_indices), column_indices(column_indices), values(values) {}
+
+    size_t operator()(char* buffer, size_t i) const
+    {
+        size_t length = 0;
+        length += format_integer(buffer + length, static_cast<long long>(row_indices[i]) + 1);
+        buffer[length++] = ' ';
+        length += format_integer(buffer + length, static_cast<long long>(column_indices[i]) + 1);
+        buffer[length++] = ' ';
+        length += format_value(buffer + length, values[i]);
+        buffer[length++] = '\n';
+        return length;
+    }
+};
+
+template <typename ValueType>
+struct array_line_formatter
+{
+    static const size_t max_line_length = 64;
+
+    const ValueType* values;
+    size_t num_rows;
+    size_t pitch;
+
+    array_line_formatter(const ValueType* values, size_t num_rows, size_t pitch)
+        : values(values), num_rows(num_rows), pitch(pitch) {}
+
+    // line i holds entry (i % num_rows, i / num_rows) of a column-major array
+    size_t operator()(char* buffer, size_t i) const
+    {
+        size_t length = format_value(buffer, values[(i / num_rows) * pitch + (i % num_rows)]);
+        buffer[length++] = '\n';
+        return length;
+    }
+};
+
 template <typename IndexType, typename ValueType, typename Stream>
 void write_coordinate_stream(const cusp::coo_matrix<IndexType,ValueType,cusp::host_memory>& coo, Stream& output)
 {
@@ -432,13 +621,14 @@ void write_coordinate_stream(const cusp::coo_matrix<IndexType,ValueType,cusp::ho
 
     output << "\t" << coo.num_rows << "\t" << coo.num_cols << "\t" << coo.num_entries << "\n";
 
-    for(size_t i = 0; i < coo.num_entries; i++)
-    {
-        output << (coo.row_indices[i]    + 1) << " ";
-        output << (coo.column_indices[i] + 1) << " ";
-        cusp::io::detail::write_value(output, coo.values[i]);
-        output << "\n";
-    }
+    if (coo.num_entries == 0)
+        return;
+
+    coordinate_line_formatter<IndexType,ValueType> format(thrust::raw_pointer_cast(&coo.row_indices[0]),
+                                                        thrust::raw_pointer_cast(&coo.column_indices[0]),
+                                                        thrust::raw_pointer_cast(&coo.values[0]));
+
+    write_lines(output, coo.num_entries, format);
 }
 
 
@@ -479,68 +669,814 @@ void read_matrix_market_stream(Matrix& mtx, Stream& input, cusp::array1d_format)
     cusp::convert(temp, mtx);
 }
 
-template <typename Matrix, typename Stream>
-void write_matrix_market_stream(const Matrix& mtx, Stream& output, cusp::sparse_format)
+inline bool is_blank(char c)
 {
-    // general sparse case
-    typedef typename Matrix::index_type IndexType;
-    typedef typename Matrix::value_type ValueType;
+    return c == ' ' || c == '\t' || c == '\r';
+}
 
-    cusp::coo_matrix<IndexType,ValueType,cusp::host_memory> coo(mtx);
+inline const char* skip_blanks(const char* first, const char* last)
+{
+    while (first != last && is_blank(*first)) ++first;
+    return first;
+}
 
-    cusp::io::detail::write_coordinate_stream(coo, output);
+inline const char* next_line(const char* first, const char* last)
+{
+    if (first == last) return last;
+
+    const char* eol = static_cast<const char*>(std::memchr(first, '\n', last - first));
+    return eol == NULL ? last : eol + 1;
 }
 
-template <typename Matrix, typename Stream>
-void write_matrix_market_stream(const Matrix& mtx, Stream& output, cusp::array1d_format)
+// true if [first,last) holds a coordinate entry rather than a blank line
+inline bool is_entry_line(const char* first, const char* last)
 {
-    typedef typename Matrix::value_type ValueType;
+    first = skip_blanks(first, last);
+    return first != last && *first != '\n' && *first != '%';
+}
 
-    bool is_complex = thrust::detail::is_same<ValueType, cusp::complex<typename cusp::norm_type<ValueType>::type> >::value;
+// parses a decimal integer, returns NULL on failure
+inline const char* parse_integer(const char* first, const char* last, long long& value)
+{
+    first = skip_blanks(first, last);
 
-    if (is_complex)
-        output << "%%MatrixMarket matrix array complex general\n";
-    else
-        output << "%%MatrixMarket matrix array real general\n";
+    bool negative = false;
 
-    output << "\t" << mtx.size() << "\t1\n";
+    if (first != last && (*first == '-' || *first == '+'))
+        negative = *first++ == '-';
 
-    for(size_t i = 0; i < mtx.size(); i++)
-    {
-        write_value(output, mtx[i]);
-        output << "\n";
+    const char* digits = first;
+    unsigned long long v = 0;
+
+    while (first != last && *first >= '0' && *first <= '9')
+        v = 10 * v + (*first++ - '0');
+
+    if (first == digits || (first != last && !is_blank(*first) && *first != '\n'))
+        return NULL;
+
+    value = negative ? -static_cast<long long>(v) : static_cast<long long>(v);
+
+    return first;
+}
+
+// parses a floating point number, returns NULL on failure
+//
+// Plain decimals with at most 15 significant digits and a small exponent
+// are converted exactly with one multiplication or division, which gives
+// the same correctly rounded result as strtod.  Anything else is handed to
+// strtod so the value always agrees with the stream based reader.
+inline const char* parse_real(const char* first, const char* last, double& value)
+{
+    static const double powers_of_ten[] =
+    {
+        1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+        1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+    };
+
+    first = skip_blanks(first, last);
+
+    const char* token = first;
+    const char* p     = first;
+
+    bool negative = false;
+
+    if (p != last && (*p == '-' || *p == '+'))
+        negative = *p++ == '-';
+
+    unsigned long long mantissa = 0;
+    int  significant = 0;
+    int  exponent    = 0;
+    bool any_digits  = false;
+
+    for (; p != last && *p >= '0' && *p <= '9'; ++p)
+    {
+        any_digits = true;
+        if (mantissa == 0 && *p == '0') continue;
+        if (++significant <= 19) mantissa = 10 * mantissa + (*p - '0');
+        else                     exponent++;
+    }
+
+    if (p != last && *p == '.')
+    {
+        for (++p; p != last && *p >= '0' && *p <= '9'; ++p)
+        {
+            any_digits = true;
+            if (mantissa == 0 && *p == '0') {
+                exponent--;
+                continue;
+            }
+            if (++significant <= 19) {
+                mantissa = 10 * mantissa + (*p - '0');
+                exponent--;
+            }
+        }
+    }
+
+    if (any_digits && p != last && (*p == 'e' || *p == 'E'))
+    {
+        const char* q = p + 1;
+        bool negative_exponent = false;
+
+        if (q != last && (*q == '-' || *q == '+'))
+            negative_exponent = *q++ == '-';
+
+        const char* exponent_digits = q;
+        int e = 0;
+
+        for (; q != last && *q >= '0' && *q <= '9'; ++q)
+            if (e < 100000) e = 10 * e + (*q - '0');
+
+        if (q != exponent_digits)
+        {
+            exponent += negative_exponent ? -e : e;
+            p = q;
+        }
     }
+
+    bool delimited = p == last || is_blank(*p) || *p == '\n';
+
+    if (any_digits && delimited && significant <= 15 && exponent >= -22 && exponent <= 22)
+    {
+        double v = static_cast<double>(mantissa);
+        v = exponent < 0 ? v / powers_of_ten[-exponent] : v * powers_of_ten[exponent];
+        value = negative ? -v : v;
+        return p;
+    }
+
+    // general case: copy the token so strtod never reads past the mapping
+    const char* token_end = token;
+    while (token_end != last && !is_blank(*token_end) && *token_end != '\n') ++token_end;
+
+    char buffer[128];
+    size_t length = token_end - token;
+
+    if (length == 0 || length >= sizeof(buffer))
+        return NULL;
+
+    std::memcpy(buffer, token, length);
+    buffer[length] = '\0';
+
+    char* parsed;
+    value = std::strtod(buffer, &parsed);
+
+    return parsed == buffer + length ? token_end : NULL;
 }
 
-template <typename Matrix, typename Stream>
-void write_matrix_market_stream(const Matrix& mtx, Stream& output, cusp::array2d_format)
+// parses the entries of lines [first,last) into positions [offset,num_entries)
+// of the coordinate arrays, returns false on a malformed entry
+template <typename IndexType, typename ValueType>
+bool parse_coordinate_chunk(const char* first, const char* last,
+                            const matrix_market_banner& banner,
+                            size_t offset, size_t num_entries,
+                            IndexType* row_indices, IndexType* column_indices, ValueType* values)
+{
+    const bool is_pattern = banner.type == "pattern";
+    const bool is_complex = banner.type == "complex";
+
+    while (first != last && offset < num_entries)
+    {
+        const char* eol = next_line(first, last);
+
+        if (is_entry_line(first, eol))
+        {
+            long long i, j;
+            double real = 0, imag = 0;
+
+            first = parse_integer(first, eol, i);
+            if (first == NULL) return false;
+            first = parse_integer(first, eol, j);
+            if (first == NULL) return false;
+
+            if (!is_pattern)
+            {
+                first = parse_real(first, eol, real);
+                if (first == NULL) return false;
+
+                if (is_complex)
+                {
+                    first = parse_real(first, eol, imag);
+                    if (first == NULL) return false;
+                }
+
+                if (is_complex) assign_complex(values[offset], real, imag);
+                else            values[offset] = real;
+            }
+
+            row_indices[offset]    = static_cast<IndexType>(i);
+            column_indices[offset] = static_cast<IndexType>(j);
+            offset++;
+        }
+
+        first = eol;
+    }
+
+    return true;
+}
+
+// reads the size line of a mapped coordinate file whose entries start at data
+inline thrust::tuple<size_t,size_t,size_t>
+read_coordinate_size(const mapped_file& file, const char* data)
+{
+    std::istringstream header(std::string(file.begin(), data));
+    std::string line;
+    std::getline(header, line);
+    return read_input_size(header);
+}
+
+inline int num_coordinate_chunks(void)
+{
+#ifdef _OPENMP
+    return 4 * omp_get_max_threads();
+#else
+    return 1;
+#endif
+}
+
+// Splits the entries in [data,end) into chunks that start at the beginning
+// of a line and counts the entries of each chunk, so that offsets[c] is the
+// index of the first entry of chunk c.
+inline void split_coordinate_chunks(const char* data, const char* end, size_t num_entries,
+                                    std::vector<const char*>& bounds, std::vector<size_t>& offsets)
+{
+    const int    num_chunks = bounds.size() - 1;
+    const size_t num_bytes  = end - data;
+
+    bounds[0]          = data;
+    bounds[num_chunks] = end;
+
+    for (int c = 1; c < num_chunks; c++)
+    {
+        const char* bound = data + (num_bytes / num_chunks) * c;
+        bound     = std::max(bound, bounds[c - 1]);
+        bounds[c] = bound == data ? data : next_line(bound - 1, end);
+    }
+
+    offsets.assign(num_chunks + 1, 0);
+
+#ifdef _OPENMP
+    #pragma omp parallel for schedule(dynamic)
+#endif
+    for (int c = 0; c < num_chunks; c++)
+    {
+        size_t count = 0;
+
+        for (const char* line = bounds[c]; line != bounds[c + 1];)
+        {
+            const char* eol = next_line(line, bounds[c + 1]);
+            if (is_entry_line(line, eol)) count++;
+            line = eol;
+        }
+
+        offsets[c + 1] = count;
+    }
+
+    for (int c = 0; c < num_chunks; c++)
+        offsets[c + 1] += offsets[c];
+
+    if (offsets[num_chunks] < num_entries)
+    {
+        std::cerr << " Read " << offsets[num_chunks] << " out of " << num_entries << " expected entries!" << std::endl;
+        throw cusp::io_exception("unexpected EOF while reading MatrixMarket entries");
+    }
+}
+
+template <typename IndexType, typename ValueType>
+void read_coordinate_file(cusp::coo_matrix<IndexType,ValueType,cusp::host_memory>& coo,
+                          const mapped_file& file, const char* data,
+                          const matrix_market_banner& banner)
+{
+    size_t num_rows, num_cols, num_entries;
+    thrust::tie(num_rows, num_cols, num_entries) = read_coordinate_size(file, data);
+
+    const int num_chunks = num_coordinate_chunks();
+
+    std::vector<const char*> bounds(num_chunks + 1);
+    std::vector<size_t>      offsets;
+
+    split_coordinate_chunks(data, file.end(), num_entries, bounds, offsets);
+
+    coo.resize(num_rows, num_cols, num_entries);
+
+    if (num_entries > 0)
+    {
+        IndexType* row_indices    = thrust::raw_pointer_cast(&coo.row_indices[0]);
+        IndexType* column_indices = thrust::raw_pointer_cast(&coo.column_indices[0]);
+        ValueType* values         = thrust::raw_pointer_cast(&coo.values[0]);
+
+        std::vector<char> valid(num_chunks, 1);
+
+#ifdef _OPENMP
+        #pragma omp parallel for schedule(dynamic)
+#endif
+        for (int c = 0; c < num_chunks; c++)
+            valid[c] = parse_coordinate_chunk(bounds[c], bounds[c + 1], banner,
+                                              offsets[c], num_entries,
+                                              row_indices, column_indices, values);
+
+        if (std::find(valid.begin(), valid.end(), 0) != valid.end())
+            throw cusp::io_exception("invalid MatrixMarket coordinate entry");
+
+        if (banner.type == "pattern")
+            std::fill(coo.values.begin(), coo.values.end(), ValueType(1));
+    }
+
+    finalize_coordinate_entries(coo, banner);
+}
+
+// range of the base-1 indices seen by one chunk
+struct coordinate_index_range
+{
+    long long min_row, max_row, min_col, max_col;
+
+    coordinate_index_range(void)
+        : min_row(std::numeric_limits<long long>::max()), max_row(std::numeric_limits<long long>::min()),
+          min_col(std::numeric_limits<long long>::max()), max_col(std::numeric_limits<long long>::min()) {}
+
+    void merge(long long i, long long j)
+    {
+        min_row = std::min(min_row, i);
+        max_row = std::max(max_row, i);
+        min_col = std::min(min_col, j);
+        max_col = std::max(max_col, j);
+    }
+
+    void merge(const coordinate_index_range& r)
+    {
+        min_row = std::min(min_row, r.min_row);
+        max_row = std::max(max_row, r.max_row);
+        min_col = std::min(min_col, r.min_col);
+        max_col = std::max(max_col, r.max_col);
+    }
+};
+
+// first pass of the CSR loader: counts the entries (and mirrored entries)
+// of every row into row_counts[row + 1], returns false on a malformed entry
+template <typename IndexType>
+bool count_coordinate_chunk(const char* first, const char* last,
+                            size_t offset, size_t num_entries,
+                            size_t num_rows, size_t num_cols, bool mirror,
+                            IndexType* row_counts, coordinate_index_range& range)
+{
+    while (first != last && offset < num_entries)
+    {
+        const char* eol = next_line(first, last);
+
+        if (is_entry_line(first, eol))
+        {
+            long long i, j;
+
+            first = parse_integer(first, eol, i);
+            if (first == NULL) return false;
+            first = parse_integer(first, eol, j);
+            if (first == NULL) return false;
+
+            range.merge(i, j);
+
+            // out of range indices are reported once all chunks are counted
+            if (i >= 1 && j >= 1 && size_t(i) <= num_rows && size_t(j) <= num_cols)
+            {
+#ifdef _OPENMP
+                #pragma omp atomic
+#endif
+                row_counts[i]++;
+
+                if (mirror && i != j)
+                {
+#ifdef _OPENMP
+                    #pragma omp atomic
+#endif
+                    row_counts[j]++;
+                }
+            }
+
+            offset++;
+        }
+
+        first = eol;
+    }
+
+    return true;
+}
+
+template <typename ValueType>
+ValueType mirror_value(const ValueType& value, const matrix_market_banner& banner)
+{
+    if (banner.symmetry == "hermitian")      return cusp::conj(value);
+    if (banner.symmetry == "skew-symmetric") return -value;
+    return value;
+}
+
+// second pass of the CSR loader: scatters the entries of [first,last) into
+// their rows, row_cursors[row] is the next free position of each row
+template <typename IndexType, typename ValueType>
+bool scatter_coordinate_chunk(const char* first, const char* last,
+                              size_t offset, size_t num_entries,
+                              const matrix_market_banner& banner,
+                              IndexType* row_cursors, IndexType* column_indices, ValueType* values)
+{
+    const bool is_pattern = banner.type == "pattern";
+    const bool is_complex = banner.type == "complex";
+    const bool mirror     = banner.symmetry != "general";
+
+    while (first != last && offset < num_entries)
+    {
+        const char* eol = next_line(first, last);
+
+        if (is_entry_line(first, eol))
+        {
+            long long i, j;
+            double real = 0, imag = 0;
+            ValueType value(1);
+
+            first = parse_integer(first, eol, i);
+            if (first == NULL) return false;
+            first = parse_integer(first, eol, j);
+            if (first == NULL) return false;
+
+            if (!is_pattern)
+            {
+                first = parse_real(first, eol, real);
+                if (first == NULL) return false;
+
+                if (is_complex)
+                {
+                    first = parse_real(first, eol, imag);
+                    if (first == NULL) return false;
+                }
+
+                if (is_complex) assign_complex(value, real, imag);
+                else            value = real;
+            }
+
+            const IndexType n = row_cursors[i - 1]++;
+            column_indices[n] = static_cast<IndexType>(j - 1);
+            values[n]         = value;
+
+            if (mirror && i != j)
+            {
+                const IndexType m = row_cursors[j - 1]++;
+                column_indices[m] = static_cast<IndexType>(i - 1);
+                values[m]         = mirror_value(value, banner);
+            }
+
+            offset++;
+        }
+
+        first = eol;
+    }
+
+    return true;
+}
+
+template <typename IndexType, typename ValueType>
+struct column_less
+{
+    bool operator()(const std::pair<IndexType,ValueType>& a, const std::pair<IndexType,ValueType>& b) const
+    {
+        return a.first < b.first;
+    }
+};
+
+// stable sort of the entries of every row by column index, rows that are
+// already sorted (the common case) are left untouched
+template <typename IndexType, typename ValueType>
+void sort_csr_rows(cusp::csr_matrix<IndexType,ValueType,cusp::host_memory>& csr)
+{
+    if (csr.num_entries == 0)
+        return;
+
+    const IndexType* row_offsets    = thrust::raw_pointer_cast(&csr.row_offsets[0]);
+    IndexType*       column_indices = thrust::raw_pointer_cast(&csr.column_indices[0]);
+    ValueType*       values         = thrust::raw_pointer_cast(&csr.values[0]);
+
+    const size_t block_size = 4096;
+    const int    num_blocks = (csr.num_rows + block_size - 1) / block_size;
+
+#ifdef _OPENMP
+    #pragma omp parallel for schedule(dynamic)
+#endif
+    for (int b = 0; b < num_blocks; b++)
+    {
+        std::vector< std::pair<IndexType,ValueType> > row;
+
+        const size_t row_end = std::min(size_t(b + 1) * block_size, csr.num_rows);
+
+        for (size_t r = size_t(b) * block_size; r < row_end; r++)
+        {
+            const IndexType first = row_offsets[r];
+            const IndexType last  = row_offsets[r + 1];
+
+            bool sorted = true;
+            for (IndexType n = first + 1; n < last && sorted; n++)
+                sorted = column_indices[n - 1] <= column_indices[n];
+
+            if (sorted)
+                continue;
+
+            row.clear();
+            for (IndexType n = first; n < last; n++)
+                row.push_back(std::make_pair(column_indices[n], values[n]));
+
+            std::stable_sort(row.begin(), row.end(), column_less<IndexType,ValueType>());
+
+            for (IndexType n = first; n < last; n++)
+            {
+                column_indices[n] = row[n - first].first;
+                values[n]         = row[n - first].second;
+            }
+        }
+    }
+}
+
+// Loads a coordinate file straight into CSR storage in two passes over the
+// mapped file: the first counts the entries of every row, the second
+// scatters them into the final arrays.  No COO copy is made, so peak memory
+// is the size of the resulting matrix.  Entries of a row keep their file
+// order until the final in-row sort, which makes the result identical to
+// loading into COO, sorting and converting.
+template <typename IndexType, typename ValueType>
+void read_coordinate_file(cusp::csr_matrix<IndexType,ValueType,cusp::host_memory>& csr,
+                          const mapped_file& file, const char* data,
+                          const matrix_market_banner& banner)
 {
+    size_t num_rows, num_cols, num_entries;
+    thrust::tie(num_rows, num_cols, num_entries) = read_coordinate_size(file, data);
+
+    const int  num_chunks = num_coordinate_chunks();
+    const bool mirror     = banner.symmetry != "general";
+
+    std::vector<const char*> bounds(num_chunks + 1);
+    std::vector<size_t>      offsets;
+
+    split_coordinate_chunks(data, file.end(), num_entries, bounds, offsets);
+
+    csr.resize(num_rows, num_cols, 0);
+    thrust::fill(csr.row_offsets.begin(), csr.row_offsets.end(), IndexType(0));
+
+    IndexType* row_offsets = thrust::raw_pointer_cast(&csr.row_offsets[0]);
+
+    // pass 1: count the entries of every row
+    {
+        std::vector<char> valid(num_chunks, 1);
+        std::vector<coordinate_index_range> ranges(num_chunks);
+
+#ifdef _OPENMP
+        #pragma omp parallel for schedule(dynamic)
+#endif
+        for (int c = 0; c < num_chunks; c++)
+            valid[c] = count_coordinate_chunk(bounds[c], bounds[c + 1],
+                                              offsets[c], num_entries,
+                                              num_rows, num_cols, mirror,
+                                              row_offsets, ranges[c]);
+
+        if (std::find(valid.begin(), valid.end(), 0) != valid.end())
+            throw cusp::io_exception("invalid MatrixMarket coordinate entry");
+
+        coordinate_index_range range;
+        for (int c = 0; c < num_chunks; c++)
+            range.merge(ranges[c]);
+
+        if (num_entries > 0)
+        {
+            if (range.min_row < 1)                   throw cusp::io_exception("found invalid row index (index < 1)");
+            if (range.min_col < 1)                   throw cusp::io_exception("found invalid column index (index < 1)");
+            if (size_t(range.max_row) > num_rows)    throw cusp::io_exception("found invalid row index (index > num_rows)");
+            if (size_t(range.max_col) > num_cols)    throw cusp::io_exception("found invalid column index (index > num_columns)");
+        }
+    }
+
+    for (size_t r = 0; r < num_rows; r++)
+        row_offsets[r + 1] += row_offsets[r];
+
+    const size_t general_num_entries = row_offsets[num_rows];
+
+    csr.resize(num_rows, num_cols, general_num_entries);
+
+    // pass 2: scatter the entries in file order, row_offsets[r] serves as
+    // the insertion cursor of row r and ends up at the start of row r + 1
+    if (general_num_entries > 0)
+    {
+        row_offsets = thrust::raw_pointer_cast(&csr.row_offsets[0]);
+
+        IndexType* column_indices = thrust::raw_pointer_cast(&csr.column_indices[0]);
+        ValueType* values         = thrust::raw_pointer_cast(&csr.values[0]);
+
+        for (int c = 0; c < num_chunks; c++)
+            if (!scatter_coordinate_chunk(bounds[c], bounds[c + 1], offsets[c], num_entries,
+                                          banner, row_offsets, column_indices, values))
+                throw cusp::io_exception("invalid MatrixMarket coordinate entry");
+
+        for (size_t r = num_rows; r > 0; r--)
+            row_offsets[r] = row_offsets[r - 1];
+        row_offsets[0] = 0;
+    }
+
+    sort_csr_rows(csr);
+}
+
+template <typename Matrix>
+void read_coordinate_file(Matrix& mtx,
+                          const mapped_file& file, const char* data,
+                          const matrix_market_banner& banner,
+                          cusp::csr_format)
+{
+    typedef typename Matrix::index_type IndexType;
     typedef typename Matrix::value_type ValueType;
 
-    bool is_complex = thrust::detail::is_same<ValueType, cusp::complex<typename cusp::norm_type<ValueType>::type> >::value;
+    cusp::csr_matrix<IndexType,ValueType,cusp::host_memory> temp;
 
-    if (is_complex)
-        output << "%%MatrixMarket matrix array complex general\n";
+    read_coordinate_file(temp, file, data, banner);
+
+    cusp::copy(temp, mtx);
+}
+
+template <typename Matrix>
+void read_coordinate_file(Matrix& mtx,
+                          const mapped_file& file, const char* data,
+                          const matrix_market_banner& banner,
+                          cusp::sparse_format)
+{
+    typedef typename Matrix::index_type IndexType;
+    typedef typename Matrix::value_type ValueType;
+
+    cusp::coo_matrix<IndexType,ValueType,cusp::host_memory> temp;
+
+    read_coordinate_file(temp, file, data, banner);
+
+    cusp::convert(temp, mtx);
+}
+
+template <typename Matrix>
+void read_coordinate_file(Matrix& mtx,
+                          const mapped_file& file, const char* data,
+                          const matrix_market_banner& banner)
+{
+    read_coordinate_file(mtx, file, data, banner, typename Matrix::format());
+}
+
+// reads the banner and the size line, the stream is left at the first entry
+template <typename Stream>
+cusp::io::matrix_market_header read_header_stream(Stream& input)
+{
+    matrix_market_banner banner;
+    read_matrix_market_banner(banner, input);
+
+    cusp::io::matrix_market_header header;
+    header.storage  = banner.storage;
+    header.type     = banner.type;
+    header.symmetry = banner.symmetry;
+
+    std::string line;
+    std::vector<std::string> tokens;
+
+    // skip over comments and blank lines
+    while (std::getline(input, line))
+    {
+        tokens.clear();
+        detail::tokenize(tokens, line);
+
+        if (!tokens.empty() && tokens[0][0] != '%')
+            break;
+    }
+
+    // line contains [num_rows num_columns num_entries] or [num_rows num_columns]
+    if (tokens.size() != (banner.storage == "coordinate" ? 3 : 2))
+        throw cusp::io_exception("invalid MatrixMarket size line");
+
+    std::istringstream(tokens[0]) >> header.num_rows;
+    std::istringstream(tokens[1]) >> header.num_cols;
+
+    if (banner.storage == "coordinate")
+        std::istringstream(tokens[2]) >> header.num_entries;
     else
-        output << "%%MatrixMarket matrix array real general\n";
+        header.num_entries = header.num_rows * header.num_cols;
 
-    output << "\t" << mtx.num_rows << "\t" << mtx.num_cols << "\n";
+    return header;
+}
+
+// hands the first num_entries slots of block to f and makes room for the next block
+template <typename Matrix, typename BlockFunction>
+void deliver_block(Matrix& block, size_t num_entries, size_t block_size,
+                   const cusp::io::matrix_market_header& header, BlockFunction& f)
+{
+    block.resize(header.num_rows, header.num_cols, num_entries);
+    f(block);
+    block.resize(header.num_rows, header.num_cols, block_size);
+}
+
+template <typename IndexType, typename ValueType, typename Stream, typename BlockFunction>
+size_t read_coordinate_blocks(cusp::coo_matrix<IndexType,ValueType,cusp::host_memory>& block,
+                              Stream& input, size_t block_size, BlockFunction f)
+{
+    if (block_size == 0)
+        throw cusp::invalid_input_exception("block size must be positive");
+
+    const cusp::io::matrix_market_header header = read_header_stream(input);
+
+    if (header.storage != "coordinate")
+        throw cusp::io_exception("blocked reading requires a MatrixMarket coordinate file");
 
-    for(size_t j = 0; j < mtx.num_cols; j++)
+    matrix_market_banner banner;
+    banner.storage  = header.storage;
+    banner.type     = header.type;
+    banner.symmetry = header.symmetry;
+
+    const bool is_general = banner.symmetry == "general";
+    const bool is_pattern = banner.type == "pattern";
+
+    block.resize(header.num_rows, header.num_cols, block_size);
+
+    IndexType* row_indices    = thrust::raw_pointer_cast(&block.row_indices[0]);
+    IndexType* column_indices = thrust::raw_pointer_cast(&block.column_indices[0]);
+    ValueType* values         = thrust::raw_pointer_cast(&block.values[0]);
+
+    size_t num_entries_read = 0;
+    size_t num_delivered    = 0;
+    size_t count            = 0;
+
+    std::string line;
+
+    while (num_entries_read < header.num_entries && std::getline(input, line))
     {
-        for(size_t i = 0; i < mtx.num_rows; i++)
+        const char* first = line.data();
+        const char* last  = first + line.size();
+
+        if (!is_entry_line(first, last))
+            continue;
+
+        if (!parse_coordinate_chunk(first, last, banner, count, count + 1,
+                                    row_indices, column_indices, values))
+            throw cusp::io_exception("invalid MatrixMarket coordinate entry");
+
+        if (is_pattern)
+            values[count] = ValueType(1);
+
+        const IndexType i = row_indices[count];
+        const IndexType j = column_indices[count];
+
+        if (i < 1)                        throw cusp::io_exception("found invalid row index (index < 1)");
+        if (j < 1)                        throw cusp::io_exception("found invalid column index (index < 1)");
+        if (size_t(i) > header.num_rows)  throw cusp::io_exception("found invalid row index (index > num_rows)");
+        if (size_t(j) > header.num_cols)  throw cusp::io_exception("found invalid column index (index > num_columns)");
+
+        // convert base-1 indices to base-0
+        row_indices[count]    = i - 1;
+        column_indices[count] = j - 1;
+
+        const ValueType value = values[count];
+
+        num_entries_read++;
+
+        if (++count == block_size)
         {
-            write_value(output, mtx(i,j));
-            output << "\n";
+            deliver_block(block, count, block_size, header, f);
+            num_delivered += count;
+            count = 0;
+
+            row_indices    = thrust::raw_pointer_cast(&block.row_indices[0]);
+            column_indices = thrust::raw_pointer_cast(&block.column_indices[0]);
+            values         = thrust::raw_pointer_cast(&block.values[0]);
+        }
+
+        // expand symmetric formats to "general" format
+        if (!is_general && i != j)
+        {
+            row_indices[count]    = j - 1;
+            column_indices[count] = i - 1;
+            values[count]         = mirror_value(value, banner);
+
+            if (++count == block_size)
+            {
+                deliver_block(block, count, block_size, header, f);
+                num_delivered += count;
+                count = 0;
+
+                row_indices    = thrust::raw_pointer_cast(&block.row_indices[0]);
+                column_indices = thrust::raw_pointer_cast(&block.column_indices[0]);
+                values         = thrust::raw_pointer_cast(&block.values[0]);
+            }
         }
     }
-}
 
-} // end namespace detail
+    if (num_entries_read != header.num_entries)
+    {
+        std::cerr << " Read " << num_entries_read << " out of " << header.num_entries << " expected entries!" << std::endl;
+        throw cusp::io_exception("unexpected EOF while reading MatrixMarket entries");
+    }
 
+    if (count > 0)
+    {
+        deliver_block(block, count, block_size, header, f);
+        num_delivered += count;
+    }
+
+    block.resize(header.num_rows, header.num_cols, 0);
+
+    return num_delivered;
+}
 
 template <typename Matrix>
-void read_matrix_market_file(Matrix& mtx, const std::string& filename)
+void read_matrix_market_file(Matrix& mtx, const std::string& filename, cusp::known_format)
 {
     std::ifstream file(filename.c_str());
 
@@ -561,12 +1497,161 @@ void read_matrix_market_file(Matrix& mtx, const std::string& filename)
 #endif
 }
 
+template <typename Matrix>
+void read_matrix_market_file_parallel(Matrix& mtx, const std::string& filename, cusp::sparse_format)
+{
+    mapped_file file(filename);
+
+    // the banner, comments and size line are short, parse them with the
+    // same routines as the stream based reader
+    const char* data = file.begin();
+
+    data = next_line(data, file.end());
+    while (data != file.end() && *data == '%')
+        data = next_line(data, file.end());
+    data = next_line(data, file.end());
+
+    matrix_market_banner banner;
+
+    {
+        std::istringstream header(std::string(file.begin(), next_line(file.begin(), file.end())));
+        read_matrix_market_banner(banner, header);
+    }
+
+    if (banner.storage == "coordinate")
+        read_coordinate_file(mtx, file, data, banner);
+    else
+        read_matrix_market_file(mtx, filename, cusp::known_format());
+}
+
+// dense containers gain nothing from the parallel reader
+template <typename Matrix>
+void read_matrix_market_file_parallel(Matrix& mtx, const std::string& filename, cusp::array1d_format)
+{
+    read_matrix_market_file(mtx, filename, cusp::known_format());
+}
+
+template <typename Matrix>
+void read_matrix_market_file_parallel(Matrix& mtx, const std::string& filename, cusp::array2d_format)
+{
+    read_matrix_market_file(mtx, filename, cusp::known_format());
+}
+
+// CSR containers are loaded without a COO intermediate
+template <typename Matrix>
+void read_matrix_market_file(Matrix& mtx, const std::string& filename, cusp::csr_format)
+{
+    cusp::io::detail::read_matrix_market_file_parallel(mtx, filename, cusp::sparse_format());
+}
+
+template <typename Matrix, typename Stream>
+void write_matrix_market_stream(const Matrix& mtx, Stream& output, cusp::sparse_format)
+{
+    // general sparse case
+    typedef typename Matrix::index_type IndexType;
+    typedef typename Matrix::value_type ValueType;
+
+    cusp::coo_matrix<IndexType,ValueType,cusp::host_memory> coo(mtx);
+
+    cusp::io::detail::write_coordinate_stream(coo, output);
+}
+
+template <typename Matrix, typename Stream>
+void write_matrix_market_stream(const Matrix& mtx, Stream& output, cusp::array1d_format)
+{
+    typedef typename Matrix::value_type ValueType;
+
+    bool is_complex = thrust::detail::is_same<ValueType, cusp::complex<typename cusp::norm_type<ValueType>::type> >::value;
+
+    if (is_complex)
+        output << "%%MatrixMarket matrix array complex general\n";
+    else
+        output << "%%MatrixMarket matrix array real general\n";
+
+    output << "\t" << mtx.size() << "\t1\n";
+
+    if (mtx.size() == 0)
+        return;
+
+    cusp::array1d<ValueType,cusp::host_memory> values(mtx);
+
+    write_lines(output, values.size(),
+                array_line_formatter<ValueType>(thrust::raw_pointer_cast(&values[0]), values.size(), values.size()));
+}
+
+template <typename Matrix, typename Stream>
+void write_matrix_market_stream(const Matrix& mtx, Stream& output, cusp::array2d_format)
+{
+    typedef typename Matrix::value_type ValueType;
+
+    bool is_complex = thrust::detail::is_same<ValueType, cusp::complex<typename cusp::norm_type<ValueType>::type> >::value;
+
+    if (is_complex)
+        output << "%%MatrixMarket matrix array complex general\n";
+    else
+        output << "%%MatrixMarket matrix array real general\n";
+
+    output << "\t" << mtx.num_rows << "\t" << mtx.num_cols << "\n";
+
+    if (mtx.num_rows == 0 || mtx.num_cols == 0)
+        return;
+
+    cusp::array2d<ValueType,cusp::host_memory,cusp::column_major> values(mtx);
+
+    write_lines(output, values.num_rows * values.num_cols,
+                array_line_formatter<ValueType>(thrust::raw_pointer_cast(&values.values[0]), values.num_rows, values.pitch));
+}
+
+} // end namespace detail
+
+
+template <typename Matrix>
+void read_matrix_market_file(Matrix& mtx, const std::string& filename)
+{
+    cusp::io::detail::read_matrix_market_file(mtx, filename, typename Matrix::format());
+}
+
+template <typename Matrix>
+void read_matrix_market_file_parallel(Matrix& mtx, const std::string& filename)
+{
+    cusp::io::detail::read_matrix_market_file_parallel(mtx, filename, typename Matrix::format());
+}
+
 template <typename Matrix, typename Stream>
 void read_matrix_market_stream(Matrix& mtx, Stream& input)
 {
     cusp::io::detail::read_matrix_market_stream(mtx, input, typename Matrix::format());
 }
 
+inline matrix_market_header read_matrix_market_header(const std::string& filename)
+{
+    std::ifstream file(filename.c_str());
+
+    if (!file)
+        throw cusp::io_exception(std::string("unable to open file \"") + filename + std::string("\" for reading"));
+
+    return cusp::io::detail::read_header_stream(file);
+}
+
+template <typename Matrix, typename BlockFunction>
+size_t read_matrix_market_file_blocks(Matrix& block, const std::string& filename,
+                                      size_t block_size, BlockFunction f)
+{
+    std::ifstream file(filename.c_str());
+
+    if (!file)
+        throw cusp::io_exception(std::string("unable to open file \"") + filename + std::string("\" for reading"));
+
+    return cusp::io::detail::read_coordinate_blocks(block, file, block_size, f);
+}
+
+template <typename Matrix, typename Stream, typename BlockFunction>
+size_t read_matrix_market_stream_blocks(Matrix& block, Stream& input,
+                                        size_t block_size, BlockFunction f)
+{
+    return cusp::io::detail::read_coordinate_blocks(block, input, block_size, f);
+}
+
 template <typename Matrix>
 void write_matrix_market_file(const Matrix& mtx, const std::string& filename)
 {
@@ -0,0 +1,167 @@
+/*
+ *  Copyright 2008-2014 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*! \file mapped_binary.h
+ *  \brief Memory mapped binary matrix files
+ */
+
+#pragma once
+
+#include <cusp/detail/config.h>
+#include <cusp/io/detail/mapped_file.h>
+
+#include <string>
+
+namespace cusp
+{
+namespace io
+{
+namespace detail
+{
+/* \cond */
+template <typename Matrix> struct mapped_matrix_traits;
+/* \endcond */
+} // end namespace detail
+
+/**
+ *  \addtogroup io Input/Output
+ *  \ingroup utilities
+ *  \{
+ */
+
+/**
+ * \brief Write a matrix in the memory mapped binary format
+ *
+ * \tparam Matrix matrix container
+ *
+ * \param mtx a \p coo_matrix, \p csr_matrix, \p ell_matrix, \p dia_matrix or
+ * \p hyb_matrix (or a view of one) in any memory space
+ * \param filename file name of the binary file
+ *
+ * \par Overview
+ * The file holds a versioned header followed by the raw arrays of \p mtx,
+ * each starting at a 64-byte aligned offset, in the storage format of
+ * \p mtx. Unlike \p write_binary_file the arrays are stored exactly as they
+ * are laid out in memory, including the padding of ELL and DIA matrices,
+ * so that \p mapped_binary_file can use them in place.
+ *
+ * \note if the file already exists it will be overwritten
+ * \note the file records the byte order, index type and value type and is
+ * only readable by a \p mapped_binary_file of the same types
+ *
+ * \par Example
+ * \code
+ * #include <cusp/csr_matrix.h>
+ * #include <cusp/gallery/poisson.h>
+ * #include <cusp/io/mapped_binary.h>
+ *
+ * int main(void)
+ * {
+ *     cusp::csr_matrix<int, float, cusp::host_memory> A;
+ *     cusp::gallery::poisson5pt(A, 100, 100);
+ *
+ *     cusp::io::write_mapped_binary_file(A, "A.cbin");
+ *
+ *     return 0;
+ * }
+ * \endcode
+ *
+ * \see \p mapped_binary_file
+ */
+template <typename Matrix>
+void write_mapped_binary_file(const Matrix& mtx, const std::string& filename);
+
+/**
+ * \brief Matrix view over a memory mapped binary file
+ *
+ * \tparam Matrix host matrix container type naming the storage format, index
+ * type and value type of the file (e.g. <tt>csr_matrix<int,float,host_memory></tt>)
+ *
+ * \par Overview
+ * The file written by \p write_mapped_binary_file is memory mapped and
+ * exposed as a host matrix view whose arrays point directly into the mapped
+ * pages, so no parsing or copying takes place when the file is opened. Pages
+ * are read from disk on first access. The view is valid for the lifetime
+ * of the \p mapped_binary_file object. Constructing a device container from
+ * the view copies the arrays straight from the mapping.
+ *
+ * \par Example
+ * \code
+ * #include <cusp/csr_matrix.h>
+ * #include <cusp/multiply.h>
+ * #include <cusp/io/mapped_binary.h>
+ *
+ * int main(void)
+ * {
+ *     typedef cusp::csr_matrix<int, float, cusp::host_memory> Matrix;
+ *
+ *     cusp::io::mapped_binary_file<Matrix> file("A.cbin");
+ *
+ *     cusp::array1d<float, cusp::host_memory> x(file.matrix().num_cols, 1);
+ *     cusp::array1d<float, cusp::host_memory> y(file.matrix().num_rows);
+ *
+ *     // multiply using the mapped arrays
+ *     cusp::multiply(file.matrix(), x, y);
+ *
+ *     // upload to the device
+ *     cusp::csr_matrix<int, float, cusp::device_memory> A(file.matrix());
+ *
+ *     return 0;
+ * }
+ * \endcode
+ *
+ * \see \p write_mapped_binary_file
+ */
+template <typename Matrix>
+class mapped_binary_file
+{
+public:
+
+    /*! Type of the matrix view over the mapped arrays */
+    typedef typename cusp::io::detail::mapped_matrix_traits<Matrix>::view view;
+
+    /*! Map a file written by \p write_mapped_binary_file
+     *
+     *  \param filename file name of the binary file
+     *
+     *  \throws cusp::io_exception if the file cannot be mapped or does not
+     *  hold a matrix with the format, index type and value type of \p Matrix
+     */
+    mapped_binary_file(const std::string& filename);
+
+    /*! View of the mapped matrix */
+    const view& matrix(void) const
+    {
+        return view_;
+    }
+
+private:
+
+    // noncopyable
+    mapped_binary_file(const mapped_binary_file&);
+    mapped_binary_file& operator=(const mapped_binary_file&);
+
+    cusp::io::detail::mapped_file file_;
+    view view_;
+};
+/*! \}
+ */
+
+} //end namespace io
+} //end namespace cusp
+
+#include <cusp/io/detail/mapped_binary.inl>
+
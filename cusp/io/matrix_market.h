@@ -68,6 +68,45 @@ namespace io
 template <typename Matrix>
 void read_matrix_market_file(Matrix& mtx, const std::string& filename);
 
+/**
+ * \brief Read a MatrixMarket file using multiple threads.
+ *
+ * \tparam Matrix matrix container
+ *
+ * \param mtx a matrix container (e.g. \p csr_matrix or \p coo_matrix)
+ * \param filename file name of the MatrixMarket file
+ *
+ * \par Overview
+ * The file is memory mapped and the coordinate entries are split into
+ * chunks at line boundaries, each of which is parsed by a separate OpenMP
+ * thread directly into the arrays of a host \p coo_matrix. The result is
+ * identical to \p read_matrix_market_file, including the expansion of
+ * symmetric, skew-symmetric and hermitian matrices. Without OpenMP the
+ * file is parsed by a single thread. Dense (array) files are read with
+ * \p read_matrix_market_file.
+ *
+ * \note any contents of \p mtx will be overwritten
+ *
+ * \par Example
+ * \code
+ * #include <cusp/io/matrix_market.h>
+ * #include <cusp/coo_matrix.h>
+ *
+ * int main(void)
+ * {
+ *     // read matrix stored in A.mtx into a coo_matrix
+ *     cusp::coo_matrix<int, float, cusp::device_memory> A;
+ *     cusp::io::read_matrix_market_file_parallel(A, "A.mtx");
+ *
+ *     return 0;
+ * }
+ * \endcode
+ *
+ * \see \p read_matrix_market_file
+ */
+template <typename Matrix>
+void read_matrix_market_file_parallel(Matrix& mtx, const std::string& filename);
+
 /**
  * \brief Read MatrixMarket data from a stream.
  *
@@ -102,6 +141,142 @@ template <typename Matrix, typename Stream>
 void read_matrix_market_stream(Matrix& mtx, Stream& input);
 
 
+/**
+ * \brief Size and type information of a MatrixMarket file.
+ *
+ * \par Overview
+ * Filled by \p read_matrix_market_header from the banner and the size
+ * line of a file. \p num_entries counts the entries stored in the file,
+ * symmetric, skew-symmetric and hermitian files expand to at most twice
+ * as many entries when read.
+ */
+struct matrix_market_header
+{
+    std::string storage;    //!< "array" or "coordinate"
+    std::string type;       //!< "complex", "real", "integer", or "pattern"
+    std::string symmetry;   //!< "general", "symmetric", "hermitian", or "skew-symmetric"
+
+    size_t num_rows;        //!< number of rows
+    size_t num_cols;        //!< number of columns
+    size_t num_entries;     //!< number of stored entries
+};
+
+/**
+ * \brief Read the banner and dimensions of a MatrixMarket file without
+ * reading its entries.
+ *
+ * \param filename file name of the MatrixMarket file
+ *
+ * \return the \p matrix_market_header of the file
+ *
+ * \par Example
+ * \code
+ * #include <cusp/io/matrix_market.h>
+ * #include <cusp/coo_matrix.h>
+ *
+ * int main(void)
+ * {
+ *     cusp::io::matrix_market_header header =
+ *         cusp::io::read_matrix_market_header("A.mtx");
+ *
+ *     // preallocate storage for the entries stored in the file
+ *     cusp::coo_matrix<int, float, cusp::host_memory>
+ *         A(header.num_rows, header.num_cols, header.num_entries);
+ *
+ *     return 0;
+ * }
+ * \endcode
+ */
+matrix_market_header read_matrix_market_header(const std::string& filename);
+
+/**
+ * \brief Read a MatrixMarket coordinate file in blocks of entries.
+ *
+ * \tparam Matrix host \p coo_matrix used as block buffer
+ * \tparam BlockFunction function object called as \p f(block)
+ *
+ * \param block buffer the entries are read into
+ * \param filename file name of the MatrixMarket file
+ * \param block_size maximum number of entries per block
+ * \param f function object receiving every block
+ *
+ * \return the total number of entries delivered to \p f
+ *
+ * \par Overview
+ * The entries are parsed in file order into \p block, which is handed to
+ * \p f whenever it holds \p block_size entries and once more with the
+ * remaining entries at the end of the file. Every block has the
+ * dimensions of the whole matrix, base-0 indices and expanded symmetric,
+ * skew-symmetric and hermitian storage, but its entries are not sorted.
+ * Only one block is held in memory, so matrices larger than host memory
+ * can be partitioned, filtered or uploaded piecewise, for instance with
+ * \p cusp::async_upload. \p f may modify or swap out the block. Dense
+ * (array) files are rejected with \p cusp::io_exception.
+ *
+ * \note any contents of \p block will be overwritten, it is empty on return
+ *
+ * \par Example
+ * \code
+ * #include <cusp/io/matrix_market.h>
+ * #include <cusp/coo_matrix.h>
+ *
+ * #include <iostream>
+ *
+ * struct count_diagonal
+ * {
+ *     size_t* count;
+ *
+ *     template <typename Matrix>
+ *     void operator()(Matrix& block)
+ *     {
+ *         for (size_t n = 0; n < block.num_entries; n++)
+ *             if (block.row_indices[n] == block.column_indices[n])
+ *                 (*count)++;
+ *     }
+ * };
+ *
+ * int main(void)
+ * {
+ *     size_t num_diagonal = 0;
+ *     count_diagonal f = { &num_diagonal };
+ *
+ *     // parse A.mtx one million entries at a time
+ *     cusp::coo_matrix<int, float, cusp::host_memory> block;
+ *     cusp::io::read_matrix_market_file_blocks(block, "A.mtx", 1 << 20, f);
+ *
+ *     std::cout << num_diagonal << " diagonal entries" << std::endl;
+ *
+ *     return 0;
+ * }
+ * \endcode
+ * \see \p read_matrix_market_stream_blocks
+ * \see \p read_matrix_market_header
+ */
+template <typename Matrix, typename BlockFunction>
+size_t read_matrix_market_file_blocks(Matrix& block, const std::string& filename,
+                                      size_t block_size, BlockFunction f);
+
+/**
+ * \brief Read MatrixMarket coordinate data from a stream in blocks of
+ * entries.
+ *
+ * \tparam Matrix host \p coo_matrix used as block buffer
+ * \tparam Stream stream type
+ * \tparam BlockFunction function object called as \p f(block)
+ *
+ * \param block buffer the entries are read into
+ * \param input stream from which to read the MatrixMarket contents
+ * \param block_size maximum number of entries per block
+ * \param f function object receiving every block
+ *
+ * \return the total number of entries delivered to \p f
+ *
+ * \see \p read_matrix_market_file_blocks
+ */
+template <typename Matrix, typename Stream, typename BlockFunction>
+size_t read_matrix_market_stream_blocks(Matrix& block, Stream& input,
+                                        size_t block_size, BlockFunction f);
+
 /**
  * \brief Write a MatrixMarket file
  *
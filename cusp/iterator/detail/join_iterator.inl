@@ -0,0 +1,143 @@
+/*
+ *  Copyright 2008-2014 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#pragma once
+
+#include <thrust/copy.h>
+#include <thrust/transform.h>
+
+#include <thrust/detail/type_traits.h>
+#include <thrust/iterator/counting_iterator.h>
+#include <thrust/iterator/iterator_traits.h>
+#include <thrust/system/detail/generic/select_system.h>
+
+namespace cusp
+{
+namespace detail
+{
+
+// a join of two ranges whose indices are the identity, i.e. a concatenation
+template <typename Iterator>
+struct is_concatenation : thrust::detail::false_type {};
+
+template <typename Iterator1, typename Iterator2, typename IndexType>
+struct is_concatenation<
+    thrust::transform_iterator<
+        cusp::join_select< thrust::tuple<Iterator1,Iterator2,thrust::counting_iterator<IndexType> > >,
+        thrust::counting_iterator<IndexType> > >
+    : thrust::detail::true_type {};
+
+// copy the positions [a, b) of the first and of the second range separately
+template <typename DerivedPolicy, typename Tuple, typename IndexType, typename OutputIterator, typename UnaryFunction>
+OutputIterator join_transform(thrust::execution_policy<DerivedPolicy>& exec,
+                              thrust::transform_iterator<cusp::join_select<Tuple>, thrust::counting_iterator<IndexType> > first,
+                              thrust::transform_iterator<cusp::join_select<Tuple>, thrust::counting_iterator<IndexType> > last,
+                              OutputIterator result, UnaryFunction op,
+                              thrust::detail::true_type)
+{
+    typedef typename cusp::join_select<Tuple>::difference_type DifferenceType;
+
+    const cusp::join_select<Tuple> f = first.functor();
+
+    const DifferenceType split = thrust::get<0>(f.t1);
+    const DifferenceType a     = *first.base();
+    const DifferenceType b     = *last.base();
+    const DifferenceType mid   = split < a ? a : (split > b ? b : split);
+
+    // the second range is offset by the size of the first one
+    if (a < mid)
+        result = thrust::transform(exec, thrust::get<0>(f.t2) + a, thrust::get<0>(f.t2) + mid, result, op);
+    if (mid < b)
+        result = thrust::transform(exec, thrust::get<1>(f.t2) + mid, thrust::get<1>(f.t2) + b, result, op);
+
+    return result;
+}
+
+template <typename DerivedPolicy, typename InputIterator, typename OutputIterator, typename UnaryFunction>
+OutputIterator join_transform(thrust::execution_policy<DerivedPolicy>& exec,
+                              InputIterator first, InputIterator last, OutputIterator result, UnaryFunction op,
+                              thrust::detail::false_type)
+{
+    return thrust::transform(exec, first, last, result, op);
+}
+
+template <typename DerivedPolicy, typename InputIterator, typename OutputIterator>
+OutputIterator join_copy(thrust::execution_policy<DerivedPolicy>& exec,
+                         InputIterator first, InputIterator last, OutputIterator result,
+                         thrust::detail::true_type)
+{
+    typedef typename thrust::iterator_value<InputIterator>::type ValueType;
+
+    return join_transform(exec, first, last, result, thrust::identity<ValueType>(), thrust::detail::true_type());
+}
+
+template <typename DerivedPolicy, typename InputIterator, typename OutputIterator>
+OutputIterator join_copy(thrust::execution_policy<DerivedPolicy>& exec,
+                         InputIterator first, InputIterator last, OutputIterator result,
+                         thrust::detail::false_type)
+{
+    return thrust::copy(exec, first, last, result);
+}
+
+} // end namespace detail
+
+template <typename DerivedPolicy, typename InputIterator, typename OutputIterator>
+OutputIterator join_copy(const thrust::detail::execution_policy_base<DerivedPolicy>& exec,
+                         InputIterator first, InputIterator last, OutputIterator result)
+{
+    return cusp::detail::join_copy(thrust::detail::derived_cast(thrust::detail::strip_const(exec)),
+                                   first, last, result,
+                                   typename cusp::detail::is_concatenation<InputIterator>::type());
+}
+
+template <typename InputIterator, typename OutputIterator>
+OutputIterator join_copy(InputIterator first, InputIterator last, OutputIterator result)
+{
+    using thrust::system::detail::generic::select_system;
+
+    typedef typename thrust::iterator_system<InputIterator>::type  System1;
+    typedef typename thrust::iterator_system<OutputIterator>::type System2;
+
+    System1 system1;
+    System2 system2;
+
+    return cusp::join_copy(select_system(system1, system2), first, last, result);
+}
+
+template <typename DerivedPolicy, typename InputIterator, typename OutputIterator, typename UnaryFunction>
+OutputIterator join_transform(const thrust::detail::execution_policy_base<DerivedPolicy>& exec,
+                              InputIterator first, InputIterator last, OutputIterator result, UnaryFunction op)
+{
+    return cusp::detail::join_transform(thrust::detail::derived_cast(thrust::detail::strip_const(exec)),
+                                        first, last, result, op,
+                                        typename cusp::detail::is_concatenation<InputIterator>::type());
+}
+
+template <typename InputIterator, typename OutputIterator, typename UnaryFunction>
+OutputIterator join_transform(InputIterator first, InputIterator last, OutputIterator result, UnaryFunction op)
+{
+    using thrust::system::detail::generic::select_system;
+
+    typedef typename thrust::iterator_system<InputIterator>::type  System1;
+    typedef typename thrust::iterator_system<OutputIterator>::type System2;
+
+    System1 system1;
+    System2 system2;
+
+    return cusp::join_transform(select_system(system1, system2), first, last, result, op);
+}
+
+} // end namespace cusp
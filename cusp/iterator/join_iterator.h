@@ -73,6 +73,39 @@ struct join_search<T,V,2>
         return i >= T(thrust::get<0>(t1)) ? thrust::get<1>(t2)[i] : thrust::get<0>(t2)[i];
     }
 };
+
+template <typename Tuple>
+struct join_select
+    : public thrust::unary_function<
+        typename thrust::iterator_difference<typename thrust::tuple_element<0,Tuple>::type>::type,
+        typename thrust::iterator_value<typename thrust::tuple_element<0,Tuple>::type>::type>
+{
+    typedef typename thrust::tuple_element<0,Tuple>::type          Iterator1;
+    typedef typename thrust::iterator_value<Iterator1>::type       value_type;
+    typedef typename thrust::iterator_difference<Iterator1>::type  difference_type;
+
+    const static size_t tuple_size = thrust::tuple_size<Tuple>::value;
+
+    typedef typename constant_tuple<tuple_size-1,size_t>::type     SizesTuple;
+
+    // cumulative sizes of the joined ranges
+    SizesTuple t1;
+    // joined ranges, offset by the preceding sizes, and the indices
+    Tuple t2;
+
+    __host__ __device__
+    join_select(void) {}
+
+    __host__ __device__
+    join_select(const SizesTuple& t1, const Tuple& t2)
+        : t1(t1), t2(t2) {}
+
+    __host__ __device__
+    value_type operator()(const difference_type& i)
+    {
+        return join_search<difference_type,value_type,tuple_size-1>()(t1,t2,i);
+    }
+};
 /*! \endcond */
 
 
@@ -154,31 +187,10 @@ public:
 
     const static size_t tuple_size = thrust::tuple_size<Tuple>::value;
 
-    // forward definition
-    struct join_select_functor;
-
-    typedef typename constant_tuple<tuple_size-1,size_t>::type            SizesTuple;
+    typedef cusp::join_select<Tuple>                                      join_select_functor;
+    typedef typename join_select_functor::SizesTuple                      SizesTuple;
     typedef typename thrust::tuple_element<tuple_size-1,Tuple>::type      IndexIterator;
     typedef thrust::transform_iterator<join_select_functor,IndexIterator> TransformIterator;
-
-    struct join_select_functor : public thrust::unary_function<difference_type,value_type>
-    {
-        SizesTuple t1;
-        Tuple t2;
-
-        __host__ __device__
-        join_select_functor(void) {}
-
-        __host__ __device__
-        join_select_functor(const SizesTuple& t1, const Tuple& t2)
-            : t1(t1), t2(t2) {}
-
-        __host__ __device__
-        value_type operator()(const difference_type& i)
-        {
-            return join_search<difference_type,value_type,tuple_size-1>()(t1,t2,i);
-        }
-    };
     /*! \endcond */
 
     // type of the join_iterator
@@ -312,8 +324,107 @@ make_join_iterator(const size_t s1, const size_t s2, const size_t s3, const size
                                 thrust::make_tuple(t1, t2-s1, t3-s1-s2, t4-s1-s2-s3, t5-s1-s2-s3-s4, t6-s1-s2-s3-s4-s5, t7-s1-s2-s3-s4-s5-s6, t8-s1-s2-s3-s4-s5-s6-s7, t9-s1-s2-s3-s4-s5-s6-s7-s8, t10)).begin();
 }
 
+/*! \brief Copy a range, reading the two ranges of a \p join_iterator
+ *  with separate contiguous copies when possible.
+ *
+ * \tparam DerivedPolicy Execution policy of the copy.
+ * \tparam InputIterator Type of the input range, any iterator.
+ * \tparam OutputIterator Type of the output range.
+ *
+ * \param exec Thrust execution policy.
+ * \param first Beginning of the input range.
+ * \param last End of the input range.
+ * \param result Beginning of the output range.
+ *
+ * \return End of the output range.
+ *
+ * \par Overview
+ *  Every dereference of a \p join_iterator selects its source range with a
+ *  comparison and reads it through the index iterator. When the indices of
+ *  a join of two ranges are a \p thrust::counting_iterator, i.e. the join
+ *  is a plain concatenation, \p join_copy instead copies the part of each
+ *  range covered by <tt>[first, last)</tt> with its own \p thrust::copy,
+ *  which reads both ranges contiguously. Any other input, including joins
+ *  with permuted indices, is copied by \p thrust::copy. Sort keys are
+ *  typically gathered from a join with \p join_copy before sorting.
+ *
+ * \par Example
+ *  \code
+ *  #include <cusp/array1d.h>
+ *  #include <cusp/iterator/join_iterator.h>
+ *
+ *  #include <thrust/iterator/counting_iterator.h>
+ *
+ *  int main(void)
+ *  {
+ *    cusp::array1d<int,cusp::device_memory> a(4, 1);
+ *    cusp::array1d<int,cusp::device_memory> b(5, 2);
+ *    cusp::array1d<int,cusp::device_memory> c(9);
+ *
+ *    // c = [1, 1, 1, 1, 2, 2, 2, 2, 2] with two contiguous copies
+ *    cusp::join_copy(cusp::make_join_iterator(4, 5, a.begin(), b.begin(), thrust::counting_iterator<int>(0)),
+ *                    cusp::make_join_iterator(4, 5, a.begin(), b.begin(), thrust::counting_iterator<int>(0)) + 9,
+ *                    c.begin());
+ *
+ *    return 0;
+ *  }
+ *  \endcode
+ */
+template <typename DerivedPolicy, typename InputIterator, typename OutputIterator>
+OutputIterator join_copy(const thrust::detail::execution_policy_base<DerivedPolicy>& exec,
+                         InputIterator first, InputIterator last, OutputIterator result);
+
+/*! \brief Copy a range, reading the two ranges of a \p join_iterator
+ *  with separate contiguous copies when possible.
+ *
+ * \param first Beginning of the input range.
+ * \param last End of the input range.
+ * \param result Beginning of the output range.
+ *
+ * \return End of the output range.
+ */
+template <typename InputIterator, typename OutputIterator>
+OutputIterator join_copy(InputIterator first, InputIterator last, OutputIterator result);
+
+/*! \brief Transform a range, reading the two ranges of a \p join_iterator
+ *  with separate contiguous transforms when possible.
+ *
+ * \tparam DerivedPolicy Execution policy of the transform.
+ * \tparam InputIterator Type of the input range, any iterator.
+ * \tparam OutputIterator Type of the output range.
+ * \tparam UnaryFunction Type of the function applied to each entry.
+ *
+ * \param exec Thrust execution policy.
+ * \param first Beginning of the input range.
+ * \param last End of the input range.
+ * \param result Beginning of the output range.
+ * \param op Function applied to each entry.
+ *
+ * \return End of the output range.
+ *
+ * \see join_copy
+ */
+template <typename DerivedPolicy, typename InputIterator, typename OutputIterator, typename UnaryFunction>
+OutputIterator join_transform(const thrust::detail::execution_policy_base<DerivedPolicy>& exec,
+                              InputIterator first, InputIterator last, OutputIterator result, UnaryFunction op);
+
+/*! \brief Transform a range, reading the two ranges of a \p join_iterator
+ *  with separate contiguous transforms when possible.
+ *
+ * \param first Beginning of the input range.
+ * \param last End of the input range.
+ * \param result Beginning of the output range.
+ * \param op Function applied to each entry.
+ *
+ * \return End of the output range.
+ */
+template <typename InputIterator, typename OutputIterator, typename UnaryFunction>
+OutputIterator join_transform(InputIterator first, InputIterator last, OutputIterator result, UnaryFunction op);
+
 /*! \} // end iterators
  */
 
 } // end namespace cusp
 
+#include <cusp/iterator/detail/join_iterator.inl>
+
@@ -0,0 +1,172 @@
+/*
+ *  Copyright 2008-2014 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*! \file batched_cg.h
+ *  \brief Batched Conjugate Gradient (CG) method
+ */
+
+#pragma once
+
+#include <cusp/detail/config.h>
+
+#include <cusp/detail/execution_policy.h>
+
+#include <cstddef>
+
+namespace cusp
+{
+namespace krylov
+{
+
+/*! \addtogroup iterative_solvers Iterative Solvers
+ *  \addtogroup krylov_methods Krylov Methods
+ *  \ingroup iterative_solvers
+ *  \{
+ */
+
+/* \cond */
+template <typename DerivedPolicy,
+          typename LinearOperator,
+          typename VectorType1,
+          typename VectorType2,
+          typename Monitor,
+          typename Preconditioner>
+void batched_cg(const thrust::detail::execution_policy_base<DerivedPolicy> &exec,
+                const LinearOperator& A,
+                      VectorType1& x,
+                const VectorType2& b,
+                const size_t block_size,
+                      Monitor& monitor,
+                      Preconditioner& M);
+
+template <typename LinearOperator,
+          typename VectorType1,
+          typename VectorType2,
+          typename Monitor>
+void batched_cg(const LinearOperator& A,
+                      VectorType1& x,
+                const VectorType2& b,
+                const size_t block_size,
+                      Monitor& monitor);
+
+template <typename LinearOperator,
+          typename VectorType1,
+          typename VectorType2>
+void batched_cg(const LinearOperator& A,
+                      VectorType1& x,
+                const VectorType2& b,
+                const size_t block_size);
+/* \endcond */
+
+/**
+ * \brief Batched Conjugate Gradient method
+ *
+ * \tparam LinearOperator is a matrix or subclass of \p linear_operator
+ * \tparam VectorType1 x input vector type
+ * \tparam VectorType2 b output vector type
+ * \tparam Monitor is a \p monitor
+ * \tparam Preconditioner is a matrix or subclass of \p linear_operator
+ *
+ * \param A block diagonal matrix of the linear systems
+ * \param x approximate solutions of the linear systems
+ * \param b right-hand sides of the linear systems
+ * \param block_size number of rows of each diagonal block
+ * \param monitor provides the tolerances and the iteration limit
+ * \param M block diagonal preconditioner for A
+ *
+ * \par Overview
+ * Solves the independent symmetric, positive-definite linear systems
+ * A_i x_i = b_i formed by the diagonal blocks of \p A, for example a batch
+ * of matrices sharing one sparsity pattern assembled into a single block
+ * diagonal matrix. Each iteration applies \p A and \p M to the whole batch
+ * and computes the inner products of all systems with segmented
+ * reductions, hence the number of launches per iteration does not depend
+ * on the number of systems.
+ *
+ * System \c i stops iterating once ||b_i - A_i x_i|| <= absolute_tolerance +
+ * relative_tolerance * ||b_i||, and the solver returns when all systems
+ * have converged or the iteration limit of \p monitor is reached. On
+ * return \p monitor reports the number of iterations and the residual
+ * norm of the whole batch.
+ *
+ * \note \p A and \p M must be symmetric and positive-definite, and the
+ * number of rows of \p A must be a multiple of \p block_size.
+ *
+ * \par Example
+ *  The following code snippet demonstrates how to use \p batched_cg to
+ *  solve 1000 independent 10x10 Poisson problems.
+ *
+ *  \code
+ *  #include <cusp/coo_matrix.h>
+ *  #include <cusp/csr_matrix.h>
+ *  #include <cusp/monitor.h>
+ *  #include <cusp/krylov/batched_cg.h>
+ *  #include <cusp/gallery/poisson.h>
+ *
+ *  int main(void)
+ *  {
+ *      const size_t num_systems = 1000;
+ *
+ *      cusp::coo_matrix<int, float, cusp::host_memory> P;
+ *      cusp::gallery::poisson5pt(P, 10, 10);
+ *
+ *      // replicate P along the diagonal
+ *      cusp::coo_matrix<int, float, cusp::host_memory>
+ *          B(num_systems * P.num_rows, num_systems * P.num_cols, num_systems * P.num_entries);
+ *
+ *      for (size_t i = 0; i < num_systems; i++)
+ *      {
+ *          for (size_t n = 0; n < P.num_entries; n++)
+ *          {
+ *              B.row_indices[i * P.num_entries + n]    = i * P.num_rows + P.row_indices[n];
+ *              B.column_indices[i * P.num_entries + n] = i * P.num_cols + P.column_indices[n];
+ *              B.values[i * P.num_entries + n]         = P.values[n];
+ *          }
+ *      }
+ *
+ *      cusp::csr_matrix<int, float, cusp::device_memory> A(B);
+ *
+ *      cusp::array1d<float, cusp::device_memory> x(A.num_rows, 0);
+ *      cusp::array1d<float, cusp::device_memory> b(A.num_rows, 1);
+ *
+ *      cusp::monitor<float> monitor(b, 100, 1e-6);
+ *
+ *      cusp::krylov::batched_cg(A, x, b, P.num_rows, monitor);
+ *
+ *      return 0;
+ *  }
+ *  \endcode
+ *
+ *  \see \p cg
+ */
+template <typename LinearOperator,
+          typename VectorType1,
+          typename VectorType2,
+          typename Monitor,
+          typename Preconditioner>
+void batched_cg(const LinearOperator& A,
+                      VectorType1& x,
+                const VectorType2& b,
+                const size_t block_size,
+                      Monitor& monitor,
+                      Preconditioner& M);
+/*! \}
+ */
+
+} // end namespace krylov
+} // end namespace cusp
+
+#include <cusp/krylov/detail/batched_cg.inl>
@@ -22,6 +22,8 @@
 
 #include <cusp/detail/config.h>
 
+#include <cusp/array1d.h>
+
 #include <cusp/detail/execution_policy.h>
 
 namespace cusp
@@ -137,6 +139,102 @@ void bicgstab(const LinearOperator& A,
               const VectorType2& b,
                     Monitor& monitor,
                     Preconditioner& M);
+
+/**
+ * \brief Biconjugate Gradient Stabilized solver owning its workspace
+ *
+ * \tparam ValueType scalar type of the linear system (e.g. \c float)
+ * \tparam MemorySpace memory space of the workspace (e.g. \c cusp::device_memory)
+ *
+ * \par Overview
+ * A \p bicgstab_solver performs the same iteration as \p bicgstab but keeps its
+ * work vectors between calls to \p solve. Repeated solves of systems
+ * with the same number of rows therefore perform no allocations.
+ *
+ *  \see \p bicgstab
+ */
+template <typename ValueType, typename MemorySpace>
+class bicgstab_solver
+{
+public:
+
+    /*! Construct a \p bicgstab_solver without workspace.
+     */
+    bicgstab_solver(void) {}
+
+    /*! Construct a \p bicgstab_solver with workspace for \p N unknowns.
+     *
+     *  \param N number of rows of the linear systems to solve.
+     */
+    bicgstab_solver(const size_t N);
+
+    /*! Resize the workspace for \p N unknowns.
+     *
+     *  \param N number of rows of the linear systems to solve.
+     */
+    void resize(const size_t N);
+
+    /*! Solve A x = b with preconditioner \p M, see \p bicgstab.
+     */
+    template <typename DerivedPolicy,
+              typename LinearOperator,
+              typename VectorType1,
+              typename VectorType2,
+              typename Monitor,
+              typename Preconditioner>
+    void solve(const thrust::detail::execution_policy_base<DerivedPolicy> &exec,
+               const LinearOperator& A,
+                     VectorType1& x,
+               const VectorType2& b,
+                     Monitor& monitor,
+                     Preconditioner& M);
+
+    /*! Solve A x = b with preconditioner \p M, see \p bicgstab.
+     */
+    template <typename LinearOperator,
+              typename VectorType1,
+              typename VectorType2,
+              typename Monitor,
+              typename Preconditioner>
+    void solve(const LinearOperator& A,
+                     VectorType1& x,
+               const VectorType2& b,
+                     Monitor& monitor,
+                     Preconditioner& M);
+
+    /*! Solve A x = b without preconditioner, see \p bicgstab.
+     */
+    template <typename LinearOperator,
+              typename VectorType1,
+              typename VectorType2,
+              typename Monitor>
+    void solve(const LinearOperator& A,
+                     VectorType1& x,
+               const VectorType2& b,
+                     Monitor& monitor);
+
+    /*! Solve A x = b with the default \p monitor, see \p bicgstab.
+     */
+    template <typename LinearOperator,
+              typename VectorType1,
+              typename VectorType2>
+    void solve(const LinearOperator& A,
+                     VectorType1& x,
+               const VectorType2& b);
+
+private:
+
+    /*! \cond */
+    cusp::array1d<ValueType,MemorySpace> p;
+    cusp::array1d<ValueType,MemorySpace> r;
+    cusp::array1d<ValueType,MemorySpace> r_star;
+    cusp::array1d<ValueType,MemorySpace> s;
+    cusp::array1d<ValueType,MemorySpace> Mp;
+    cusp::array1d<ValueType,MemorySpace> AMp;
+    cusp::array1d<ValueType,MemorySpace> Ms;
+    cusp::array1d<ValueType,MemorySpace> AMs;
+    /*! \endcond */
+};
 /*! \}
  */
 
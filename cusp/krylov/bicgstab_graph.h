@@ -0,0 +1,157 @@
+/*
+ *  Copyright 2008-2014 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*! \file bicgstab_graph.h
+ *  \brief Biconjugate Gradient Stabilized (BiCGstab) method replayed from a captured CUDA graph
+ */
+
+#pragma once
+
+#include <cusp/detail/config.h>
+
+#include <cusp/detail/execution_policy.h>
+
+namespace cusp
+{
+namespace krylov
+{
+
+/*! \addtogroup iterative_solvers Iterative Solvers
+ *  \addtogroup krylov_methods Krylov Methods
+ *  \ingroup iterative_solvers
+ *  \{
+ */
+
+/* \cond */
+template <typename DerivedPolicy,
+          typename LinearOperator,
+          typename VectorType1,
+          typename VectorType2,
+          typename Monitor,
+          typename Preconditioner>
+void bicgstab_graph(const thrust::detail::execution_policy_base<DerivedPolicy> &exec,
+                    const LinearOperator& A,
+                          VectorType1& x,
+                    const VectorType2& b,
+                          Monitor& monitor,
+                          Preconditioner& M);
+
+template <typename LinearOperator,
+          typename VectorType1,
+          typename VectorType2,
+          typename Monitor>
+void bicgstab_graph(const LinearOperator& A,
+                          VectorType1& x,
+                    const VectorType2& b,
+                          Monitor& monitor);
+
+template <typename LinearOperator,
+          typename VectorType1,
+          typename VectorType2>
+void bicgstab_graph(const LinearOperator& A,
+                          VectorType1& x,
+                    const VectorType2& b);
+/* \endcond */
+
+/**
+ * \brief Biconjugate Gradient Stabilized method with iterations replayed
+ * from a CUDA graph
+ *
+ * \tparam LinearOperator is a matrix or subclass of \p linear_operator
+ * \tparam VectorType1 vector
+ * \tparam Monitor is a \p monitor
+ * \tparam Preconditioner is a matrix or subclass of \p linear_operator
+ *
+ * \param A matrix of the linear system
+ * \param x approximate solution of the linear system
+ * \param b right-hand side of the linear system
+ * \param monitor montiors iteration and determines stopping conditions
+ * \param M preconditioner for A
+ *
+ * \par Overview
+ * Solves the linear system A x = b with preconditioner \p M using the
+ * recurrences of \p bicgstab. In device memory one iteration is captured
+ * into a CUDA graph and replayed, the recurrence scalars stay on the
+ * device and the residual is only transferred when the \p monitor tests
+ * it, every \p check_interval iterations. Unlike \p bicgstab the
+ * intermediate residual \c s is not tested, an iteration that converges
+ * half way finishes with a vanishing correction.
+ *
+ * If \p M cannot be captured the iteration is captured as two graphs and
+ * \p M is applied between them, if \p A cannot be captured the solver
+ * runs \p bicgstab. In host memory \p bicgstab_graph is \p bicgstab.
+ *
+ * \note \p x and \p b must be contiguous and the operators must issue
+ * their work on the stream of the execution policy they are given.
+ *
+ * \par Example
+ *
+ *  The following code snippet demonstrates how to use \p bicgstab_graph
+ *  to solve a 300x300 Poisson problem, testing the residual every 10
+ *  iterations.
+ *
+ *  \code
+ *  #include <cusp/csr_matrix.h>
+ *  #include <cusp/monitor.h>
+ *  #include <cusp/krylov/bicgstab_graph.h>
+ *  #include <cusp/gallery/poisson.h>
+ *
+ *  int main(void)
+ *  {
+ *      // create an empty sparse matrix structure (CSR format)
+ *      cusp::csr_matrix<int, float, cusp::device_memory> A;
+ *
+ *      // initialize matrix
+ *      cusp::gallery::poisson5pt(A, 300, 300);
+ *
+ *      // allocate storage for solution (x) and right hand side (b)
+ *      cusp::array1d<float, cusp::device_memory> x(A.num_rows, 0);
+ *      cusp::array1d<float, cusp::device_memory> b(A.num_rows, 1);
+ *
+ *      // set stopping criteria:
+ *      //  iteration_limit    = 1000
+ *      //  relative_tolerance = 1e-6
+ *      //  check_interval     = 10
+ *      cusp::monitor<float> monitor(b, 1000, 1e-6, 0, false, 10);
+ *
+ *      // solve the linear system A x = b
+ *      cusp::krylov::bicgstab_graph(A, x, b, monitor);
+ *
+ *      return 0;
+ *  }
+ *  \endcode
+ *
+ *  \see \p bicgstab
+ *  \see \p monitor
+ *  \see \p cusp::system::cuda::stream_graph
+ */
+template <typename LinearOperator,
+          typename VectorType1,
+          typename VectorType2,
+          typename Monitor,
+          typename Preconditioner>
+void bicgstab_graph(const LinearOperator& A,
+                          VectorType1& x,
+                    const VectorType2& b,
+                          Monitor& monitor,
+                          Preconditioner& M);
+/*! \}
+ */
+
+} // end namespace krylov
+} // end namespace cusp
+
+#include <cusp/krylov/detail/bicgstab_graph.inl>
@@ -0,0 +1,150 @@
+/*
+ *  Copyright 2008-2014 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*! \file block_cg.h
+ *  \brief Block Conjugate Gradient (block CG) method
+ */
+
+#pragma once
+
+#include <cusp/detail/config.h>
+
+#include <cusp/detail/execution_policy.h>
+
+namespace cusp
+{
+namespace krylov
+{
+
+/*! \addtogroup iterative_solvers Iterative Solvers
+ *  \addtogroup krylov_methods Krylov Methods
+ *  \ingroup iterative_solvers
+ *  \{
+ */
+
+/* \cond */
+template <typename DerivedPolicy,
+          typename LinearOperator,
+          typename Array2d1,
+          typename Array2d2,
+          typename Monitor,
+          typename Preconditioner>
+void block_cg(const thrust::detail::execution_policy_base<DerivedPolicy> &exec,
+              const LinearOperator& A,
+                    Array2d1& X,
+              const Array2d2& B,
+                    Monitor& monitor,
+                    Preconditioner& M);
+
+template <typename LinearOperator,
+          typename Array2d1,
+          typename Array2d2,
+          typename Monitor>
+void block_cg(const LinearOperator& A,
+                    Array2d1& X,
+              const Array2d2& B,
+                    Monitor& monitor);
+
+template <typename LinearOperator,
+          typename Array2d1,
+          typename Array2d2>
+void block_cg(const LinearOperator& A,
+                    Array2d1& X,
+              const Array2d2& B);
+/* \endcond */
+
+/**
+ * \brief Block Conjugate Gradient method
+ *
+ * \tparam LinearOperator is a matrix or subclass of \p linear_operator
+ * \tparam Array2d1 X input matrix type
+ * \tparam Array2d2 B output matrix type
+ * \tparam Monitor is a \p monitor
+ * \tparam Preconditioner is a matrix or subclass of \p linear_operator
+ *
+ * \param A matrix of the linear system
+ * \param X approximate solutions, one per column
+ * \param B right-hand sides, one per column
+ * \param monitor monitors iteration and determines stopping conditions
+ * \param M preconditioner for A
+ *
+ * \par Overview
+ * Solves the symmetric, positive-definite linear system A X = B for all
+ * columns of \p B at once with the block CG method of O'Leary. Every
+ * iteration applies \p A and \p M to all search directions with a single
+ * sparse matrix - dense matrix product and computes the small
+ * <tt>s x s</tt> projections, where \c s is the number of columns of \p B,
+ * on the host. Since the search space of every column contains the
+ * directions of all other columns, block CG typically needs fewer
+ * iterations than independent \p cg solves.
+ *
+ * The \p monitor is applied to the Frobenius norm of the residual block,
+ * i.e. to all columns of B - A X stored in one vector, hence it should be
+ * constructed from the values of \p B.
+ *
+ * \note \p A and \p M must be symmetric and positive-definite. \p A and \p M
+ * must support multiplication with \p array2d matrices, which holds for
+ * \p csr_matrix and \p identity_operator. The right-hand sides should be
+ * linearly independent, otherwise the projections become singular and the
+ * iteration breaks down.
+ *
+ * \par Example
+ *  \code
+ *  #include <cusp/array1d.h>
+ *  #include <cusp/array2d.h>
+ *  #include <cusp/copy.h>
+ *  #include <cusp/csr_matrix.h>
+ *  #include <cusp/monitor.h>
+ *  #include <cusp/krylov/block_cg.h>
+ *  #include <cusp/gallery/poisson.h>
+ *
+ *  int main(void)
+ *  {
+ *      cusp::csr_matrix<int, float, cusp::device_memory> A;
+ *      cusp::gallery::poisson5pt(A, 100, 100);
+ *
+ *      // 8 right-hand sides
+ *      cusp::array2d<float, cusp::device_memory, cusp::column_major> X(A.num_rows, 8, 0);
+ *      cusp::array2d<float, cusp::device_memory, cusp::column_major> B(A.num_rows, 8);
+ *      cusp::copy(cusp::random_array<float>(B.num_entries), B.values);
+ *
+ *      cusp::monitor<float> monitor(B.values, 100, 1e-6);
+ *
+ *      cusp::krylov::block_cg(A, X, B, monitor);
+ *
+ *      return 0;
+ *  }
+ *  \endcode
+ *
+ *  \see \p cg
+ */
+template <typename LinearOperator,
+          typename Array2d1,
+          typename Array2d2,
+          typename Monitor,
+          typename Preconditioner>
+void block_cg(const LinearOperator& A,
+                    Array2d1& X,
+              const Array2d2& B,
+                    Monitor& monitor,
+                    Preconditioner& M);
+/*! \}
+ */
+
+} // end namespace krylov
+} // end namespace cusp
+
+#include <cusp/krylov/detail/block_cg.inl>
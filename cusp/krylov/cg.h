@@ -22,6 +22,8 @@
 
 #include <cusp/detail/config.h>
 
+#include <cusp/array1d.h>
+
 #include <cusp/detail/execution_policy.h>
 
 namespace cusp
@@ -141,6 +143,109 @@ void cg(const LinearOperator& A,
         const VectorType2& b,
               Monitor& monitor,
               Preconditioner& M);
+
+/**
+ * \brief Conjugate Gradient solver owning its workspace
+ *
+ * \tparam ValueType scalar type of the linear system (e.g. \c float)
+ * \tparam MemorySpace memory space of the workspace (e.g. \c cusp::device_memory)
+ *
+ * \par Overview
+ * A \p cg_solver performs the same iteration as \p cg but keeps its
+ * work vectors between calls to \p solve. Repeated solves of systems
+ * with the same number of rows therefore perform no allocations.
+ *
+ * \par Example
+ *  \code
+ *  cusp::krylov::cg_solver<float, cusp::device_memory> solver(A.num_rows);
+ *
+ *  for (int step = 0; step < num_steps; step++)
+ *  {
+ *      cusp::monitor<float> monitor(b, 100, 1e-6);
+ *      solver.solve(A, x, b, monitor, M);
+ *  }
+ *  \endcode
+ *
+ *  \see \p cg
+ */
+template <typename ValueType, typename MemorySpace>
+class cg_solver
+{
+public:
+
+    /*! Construct a \p cg_solver without workspace.
+     */
+    cg_solver(void) {}
+
+    /*! Construct a \p cg_solver with workspace for \p N unknowns.
+     *
+     *  \param N number of rows of the linear systems to solve.
+     */
+    cg_solver(const size_t N);
+
+    /*! Resize the workspace for \p N unknowns.
+     *
+     *  \param N number of rows of the linear systems to solve.
+     */
+    void resize(const size_t N);
+
+    /*! Solve A x = b with preconditioner \p M, see \p cg.
+     */
+    template <typename DerivedPolicy,
+              typename LinearOperator,
+              typename VectorType1,
+              typename VectorType2,
+              typename Monitor,
+              typename Preconditioner>
+    void solve(const thrust::detail::execution_policy_base<DerivedPolicy> &exec,
+               const LinearOperator& A,
+                     VectorType1& x,
+               const VectorType2& b,
+                     Monitor& monitor,
+                     Preconditioner& M);
+
+    /*! Solve A x = b with preconditioner \p M, see \p cg.
+     */
+    template <typename LinearOperator,
+              typename VectorType1,
+              typename VectorType2,
+              typename Monitor,
+              typename Preconditioner>
+    void solve(const LinearOperator& A,
+                     VectorType1& x,
+               const VectorType2& b,
+                     Monitor& monitor,
+                     Preconditioner& M);
+
+    /*! Solve A x = b without preconditioner, see \p cg.
+     */
+    template <typename LinearOperator,
+              typename VectorType1,
+              typename VectorType2,
+              typename Monitor>
+    void solve(const LinearOperator& A,
+                     VectorType1& x,
+               const VectorType2& b,
+                     Monitor& monitor);
+
+    /*! Solve A x = b with the default \p monitor, see \p cg.
+     */
+    template <typename LinearOperator,
+              typename VectorType1,
+              typename VectorType2>
+    void solve(const LinearOperator& A,
+                     VectorType1& x,
+               const VectorType2& b);
+
+private:
+
+    /*! \cond */
+    cusp::array1d<ValueType,MemorySpace> y;
+    cusp::array1d<ValueType,MemorySpace> z;
+    cusp::array1d<ValueType,MemorySpace> r;
+    cusp::array1d<ValueType,MemorySpace> p;
+    /*! \endcond */
+};
 /*! \}
  */
 
@@ -0,0 +1,161 @@
+/*
+ *  Copyright 2008-2014 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*! \file cg_graph.h
+ *  \brief Conjugate Gradient (CG) method replayed from a captured CUDA graph
+ */
+
+#pragma once
+
+#include <cusp/detail/config.h>
+
+#include <cusp/detail/execution_policy.h>
+
+namespace cusp
+{
+namespace krylov
+{
+
+/*! \addtogroup iterative_solvers Iterative Solvers
+ *  \addtogroup krylov_methods Krylov Methods
+ *  \ingroup iterative_solvers
+ *  \{
+ */
+
+/* \cond */
+template <typename DerivedPolicy,
+          typename LinearOperator,
+          typename VectorType1,
+          typename VectorType2,
+          typename Monitor,
+          typename Preconditioner>
+void cg_graph(const thrust::detail::execution_policy_base<DerivedPolicy> &exec,
+              const LinearOperator& A,
+                    VectorType1& x,
+              const VectorType2& b,
+                    Monitor& monitor,
+                    Preconditioner& M);
+
+template <typename LinearOperator,
+          typename VectorType1,
+          typename VectorType2,
+          typename Monitor>
+void cg_graph(const LinearOperator& A,
+                    VectorType1& x,
+              const VectorType2& b,
+                    Monitor& monitor);
+
+template <typename LinearOperator,
+          typename VectorType1,
+          typename VectorType2>
+void cg_graph(const LinearOperator& A,
+                    VectorType1& x,
+              const VectorType2& b);
+/* \endcond */
+
+/**
+ * \brief Conjugate Gradient method with iterations replayed from a CUDA graph
+ *
+ * \tparam LinearOperator is a matrix or subclass of \p linear_operator
+ * \tparam VectorType1 x input vector type
+ * \tparam VectorType2 b output vector type
+ * \tparam Monitor is a \p monitor
+ * \tparam Preconditioner is a matrix or subclass of \p linear_operator
+ *
+ * \param A matrix of the linear system
+ * \param x approximate solution of the linear system
+ * \param b right-hand side of the linear system
+ * \param monitor monitors iteration and determines stopping conditions
+ * \param M preconditioner for A
+ *
+ * \par Overview
+ * Solves the symmetric, positive-definite linear system A x = b
+ * with preconditioner \p M using the same recurrences as \p cg. In
+ * device memory the recurrence scalars stay on the device and one
+ * iteration is captured into a CUDA graph once, every further iteration
+ * is a single graph launch. The residual is only transferred to the
+ * host when the \p monitor tests it, so pairing the solver with a
+ * \p monitor whose \p check_interval is \c k > 1 checks convergence
+ * every \c k replays.
+ *
+ * If \p M cannot be captured, for instance a \p multilevel
+ * preconditioner whose coarse solve runs on the host, the work before
+ * and after \p M is captured into two graphs and \p M is applied
+ * between them. If \p A cannot be captured the solver runs \p cg.
+ * In host memory \p cg_graph is \p cg.
+ *
+ * \note \p A and \p M must be symmetric and positive-definite,
+ * \p x and \p b must be contiguous and the operators must issue their
+ * work on the stream of the execution policy they are given.
+ *
+ * \par Example
+ *  The following code snippet demonstrates how to use \p cg_graph to
+ *  solve a 300x300 Poisson problem, testing the residual every 10
+ *  iterations.
+ *
+ *  \code
+ *  #include <cusp/csr_matrix.h>
+ *  #include <cusp/monitor.h>
+ *  #include <cusp/krylov/cg_graph.h>
+ *  #include <cusp/gallery/poisson.h>
+ *
+ *  int main(void)
+ *  {
+ *      // create an empty sparse matrix structure (CSR format)
+ *      cusp::csr_matrix<int, float, cusp::device_memory> A;
+ *
+ *      // initialize matrix
+ *      cusp::gallery::poisson5pt(A, 300, 300);
+ *
+ *      // allocate storage for solution (x) and right hand side (b)
+ *      cusp::array1d<float, cusp::device_memory> x(A.num_rows, 0);
+ *      cusp::array1d<float, cusp::device_memory> b(A.num_rows, 1);
+ *
+ *      // set stopping criteria:
+ *      //  iteration_limit    = 1000
+ *      //  relative_tolerance = 1e-6
+ *      //  check_interval     = 10
+ *      cusp::monitor<float> monitor(b, 1000, 1e-6, 0, false, 10);
+ *
+ *      // solve the linear system A x = b
+ *      cusp::krylov::cg_graph(A, x, b, monitor);
+ *
+ *      return 0;
+ *  }
+ *  \endcode
+ *
+ *  \see \p cg
+ *  \see \p monitor
+ *  \see \p cusp::system::cuda::stream_graph
+ *
+ */
+template <typename LinearOperator,
+          typename VectorType1,
+          typename VectorType2,
+          typename Monitor,
+          typename Preconditioner>
+void cg_graph(const LinearOperator& A,
+                    VectorType1& x,
+              const VectorType2& b,
+                    Monitor& monitor,
+                    Preconditioner& M);
+/*! \}
+ */
+
+} // end namespace krylov
+} // end namespace cusp
+
+#include <cusp/krylov/detail/cg_graph.inl>
@@ -79,6 +79,13 @@ void cg_m(const LinearOperator& A,
  * for some set of constant shifts \p sigma for the price of the smallest shift
  * iteratively, for sparse A, without additional matrix-vector multiplication.
  *
+ * The solutions of all shifts are stored either in an array1d of
+ * <tt>N * N_s</tt> entries or in the columns of an <tt>N</tt>-by-<tt>N_s</tt>
+ * column-major array2d, and every iteration updates them in one pass.
+ * The residual of every shifted system is a known multiple of the
+ * unshifted residual, so a shift whose residual satisfies the tolerance
+ * of the \p monitor is frozen and skipped by the remaining iterations.
+ *
  * \see http://arxiv.org/abs/hep-lat/9612014
  *
  * \par Example
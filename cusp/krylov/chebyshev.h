@@ -0,0 +1,164 @@
+/*
+ *  Copyright 2008-2014 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*! \file chebyshev.h
+ *  \brief Chebyshev iteration
+ */
+
+#pragma once
+
+#include <cusp/detail/config.h>
+
+#include <cusp/array1d.h>
+
+#include <cusp/detail/execution_policy.h>
+
+namespace cusp
+{
+namespace krylov
+{
+
+/*! \addtogroup iterative_solvers Iterative Solvers
+ *  \addtogroup krylov_methods Krylov Methods
+ *  \ingroup iterative_solvers
+ *  \{
+ */
+
+/* \cond */
+template <typename DerivedPolicy,
+          typename LinearOperator,
+          typename VectorType1,
+          typename VectorType2,
+          typename Monitor,
+          typename Preconditioner,
+          typename RealType>
+void chebyshev(const thrust::detail::execution_policy_base<DerivedPolicy> &exec,
+               const LinearOperator& A,
+                     VectorType1& x,
+               const VectorType2& b,
+                     Monitor& monitor,
+                     Preconditioner& M,
+               const RealType lambda_min,
+               const RealType lambda_max);
+
+template <typename LinearOperator,
+          typename VectorType1,
+          typename VectorType2,
+          typename Monitor,
+          typename RealType>
+void chebyshev(const LinearOperator& A,
+                     VectorType1& x,
+               const VectorType2& b,
+                     Monitor& monitor,
+               const RealType lambda_min,
+               const RealType lambda_max);
+/* \endcond */
+
+/**
+ * \brief Chebyshev iteration
+ *
+ * \tparam LinearOperator is a matrix or subclass of \p linear_operator
+ * \tparam VectorType1 x input vector type
+ * \tparam VectorType2 b output vector type
+ * \tparam Monitor is a \p monitor
+ * \tparam Preconditioner is a matrix or subclass of \p linear_operator
+ * \tparam RealType type of the spectral bounds
+ *
+ * \param A matrix of the linear system
+ * \param x approximate solution of the linear system
+ * \param b right-hand side of the linear system
+ * \param monitor monitors iteration and determines stopping conditions
+ * \param M preconditioner for A
+ * \param lambda_min lower bound of the spectrum of M A
+ * \param lambda_max upper bound of the spectrum of M A
+ *
+ * \par Overview
+ * Solves the symmetric, positive-definite linear system A x = b with
+ * preconditioner \p M by the Chebyshev iteration on the interval
+ * [\p lambda_min, \p lambda_max], for instance with \p lambda_max from
+ * \p cusp::eigen::estimate_spectral_radius. The iteration performs one
+ * product with \p A, one application of \p M and three vector updates,
+ * but no inner products; the only global reductions are the residual
+ * norms computed by the \p monitor, so pairing the solver with a
+ * \p monitor whose \p check_interval is \c k > 1 synchronizes once every
+ * \c k iterations.
+ *
+ * The convergence rate depends on the ratio of the bounds; the
+ * iteration converges for any bounds that enclose the spectrum and
+ * diverges if \p lambda_max underestimates it.
+ *
+ * \note \p A and \p M must be symmetric and positive-definite, and
+ * <tt>0 < lambda_min < lambda_max</tt>.
+ *
+ * \par Example
+ *  The following code snippet demonstrates how to use \p chebyshev to
+ *  solve a 10x10 Poisson problem, whose spectrum lies in (0, 8).
+ *
+ *  \code
+ *  #include <cusp/csr_matrix.h>
+ *  #include <cusp/monitor.h>
+ *  #include <cusp/krylov/chebyshev.h>
+ *  #include <cusp/gallery/poisson.h>
+ *
+ *  int main(void)
+ *  {
+ *      // create an empty sparse matrix structure (CSR format)
+ *      cusp::csr_matrix<int, float, cusp::device_memory> A;
+ *
+ *      // initialize matrix
+ *      cusp::gallery::poisson5pt(A, 10, 10);
+ *
+ *      // allocate storage for solution (x) and right hand side (b)
+ *      cusp::array1d<float, cusp::device_memory> x(A.num_rows, 0);
+ *      cusp::array1d<float, cusp::device_memory> b(A.num_rows, 1);
+ *
+ *      // set stopping criteria:
+ *      //  iteration_limit    = 500
+ *      //  relative_tolerance = 1e-6
+ *      //  check_interval     = 10
+ *      cusp::monitor<float> monitor(b, 500, 1e-6, 0, false, 10);
+ *
+ *      // solve the linear system A x = b
+ *      cusp::krylov::chebyshev(A, x, b, monitor, 0.16f, 8.0f);
+ *
+ *      return 0;
+ *  }
+ *  \endcode
+ *
+ *  \see \p cg
+ *  \see \p monitor
+ *
+ */
+template <typename LinearOperator,
+          typename VectorType1,
+          typename VectorType2,
+          typename Monitor,
+          typename Preconditioner,
+          typename RealType>
+void chebyshev(const LinearOperator& A,
+                     VectorType1& x,
+               const VectorType2& b,
+                     Monitor& monitor,
+                     Preconditioner& M,
+               const RealType lambda_min,
+               const RealType lambda_max);
+/*! \}
+ */
+
+} // end namespace krylov
+} // end namespace cusp
+
+#include <cusp/krylov/detail/chebyshev.inl>
@@ -0,0 +1,194 @@
+/*
+ *  Copyright 2008-2014 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#pragma once
+
+#include <cusp/detail/config.h>
+
+#include <cusp/complex.h>
+#include <cusp/functional.h>
+
+#include <thrust/for_each.h>
+#include <thrust/reduce.h>
+#include <thrust/transform.h>
+#include <thrust/tuple.h>
+#include <thrust/iterator/constant_iterator.h>
+#include <thrust/iterator/counting_iterator.h>
+#include <thrust/iterator/discard_iterator.h>
+#include <thrust/iterator/permutation_iterator.h>
+#include <thrust/iterator/transform_iterator.h>
+#include <thrust/iterator/zip_iterator.h>
+
+#include <cmath>
+
+namespace cusp
+{
+namespace krylov
+{
+namespace batched_detail
+{
+
+// Helpers for solving the independent systems on the diagonal blocks of a
+// block diagonal matrix. Vectors of length num_blocks * block_size are
+// processed with a fixed number of launches, independent of num_blocks,
+// and per block scalars are stored in arrays of length num_blocks.
+
+typedef thrust::transform_iterator< cusp::divide_value<size_t>, thrust::counting_iterator<size_t> > block_key_iterator;
+
+inline block_key_iterator make_block_keys(const size_t block_size)
+{
+    return block_key_iterator(thrust::counting_iterator<size_t>(0), cusp::divide_value<size_t>(block_size));
+}
+
+template <typename ValueType>
+struct dotc_functor
+{
+    template <typename Tuple>
+    __host__ __device__
+    ValueType operator()(const Tuple& t) const
+    {
+        return cusp::conj(ValueType(thrust::get<0>(t))) * ValueType(thrust::get<1>(t));
+    }
+};
+
+// z <- a * x + b * y
+template <typename ValueType>
+struct axpby_functor
+{
+    template <typename Tuple>
+    __host__ __device__
+    void operator()(Tuple t) const
+    {
+        thrust::get<2>(t) = ValueType(thrust::get<3>(t)) * ValueType(thrust::get<0>(t)) +
+                            ValueType(thrust::get<4>(t)) * ValueType(thrust::get<1>(t));
+    }
+};
+
+// active <- ||r|| > tolerance
+template <typename ValueType>
+struct active_functor
+{
+    typedef typename cusp::norm_type<ValueType>::type Real;
+
+    template <typename Tuple>
+    __host__ __device__
+    int operator()(const Tuple& t) const
+    {
+        return std::sqrt(cusp::abs(ValueType(thrust::get<0>(t)))) > Real(thrust::get<1>(t)) ? 1 : 0;
+    }
+};
+
+// tolerance <- absolute + relative * ||b||
+template <typename ValueType>
+struct tolerance_functor
+{
+    typedef typename cusp::norm_type<ValueType>::type Real;
+
+    Real relative_tolerance;
+    Real absolute_tolerance;
+
+    tolerance_functor(const Real relative_tolerance, const Real absolute_tolerance)
+        : relative_tolerance(relative_tolerance), absolute_tolerance(absolute_tolerance) {}
+
+    __host__ __device__
+    Real operator()(const ValueType& bb) const
+    {
+        return absolute_tolerance + relative_tolerance * std::sqrt(cusp::abs(bb));
+    }
+};
+
+// c <- active ? a / b : 0
+template <typename ValueType>
+struct masked_divide_functor
+{
+    template <typename Tuple>
+    __host__ __device__
+    ValueType operator()(const Tuple& t) const
+    {
+        return thrust::get<0>(t) ? ValueType(thrust::get<1>(t)) / ValueType(thrust::get<2>(t)) : ValueType(0);
+    }
+};
+
+// result[i] <- <x, y> over block i
+template <typename DerivedPolicy, typename Array1, typename Array2, typename Array3>
+void block_dotc(thrust::execution_policy<DerivedPolicy>& exec,
+                const Array1& x,
+                const Array2& y,
+                const size_t block_size,
+                      Array3& result)
+{
+    typedef typename Array3::value_type ValueType;
+
+    block_key_iterator keys = make_block_keys(block_size);
+
+    thrust::reduce_by_key(exec,
+                          keys, keys + x.size(),
+                          thrust::make_transform_iterator(thrust::make_zip_iterator(thrust::make_tuple(x.begin(), y.begin())),
+                                                          dotc_functor<ValueType>()),
+                          thrust::make_discard_iterator(),
+                          result.begin());
+}
+
+// z <- a[i] * x + b[i] * y over block i
+template <typename DerivedPolicy, typename Array1, typename Array2, typename Array3,
+          typename Iterator1, typename Iterator2>
+void block_axpby(thrust::execution_policy<DerivedPolicy>& exec,
+                 const Array1& x,
+                 const Array2& y,
+                       Array3& z,
+                 Iterator1 a,
+                 Iterator2 b,
+                 const size_t block_size)
+{
+    typedef typename Array3::value_type ValueType;
+
+    block_key_iterator keys = make_block_keys(block_size);
+
+    thrust::for_each(exec,
+                     thrust::make_zip_iterator(thrust::make_tuple(x.begin(), y.begin(), z.begin(),
+                                                                  thrust::make_permutation_iterator(a, keys),
+                                                                  thrust::make_permutation_iterator(b, keys))),
+                     thrust::make_zip_iterator(thrust::make_tuple(x.begin(), y.begin(), z.begin(),
+                                                                  thrust::make_permutation_iterator(a, keys),
+                                                                  thrust::make_permutation_iterator(b, keys))) + x.size(),
+                     axpby_functor<ValueType>());
+}
+
+// active[i] <- ||r|| > tolerance[i] over block i, returns the number of active blocks
+template <typename DerivedPolicy, typename Array1, typename Array2, typename Array3, typename Array4>
+size_t update_active(thrust::execution_policy<DerivedPolicy>& exec,
+                     const Array1& r,
+                     const Array2& tolerance,
+                     const size_t block_size,
+                           Array3& rr,
+                           Array4& active)
+{
+    typedef typename Array3::value_type ValueType;
+
+    block_dotc(exec, r, r, block_size, rr);
+
+    thrust::transform(exec,
+                      thrust::make_zip_iterator(thrust::make_tuple(rr.begin(), tolerance.begin())),
+                      thrust::make_zip_iterator(thrust::make_tuple(rr.end(),   tolerance.end())),
+                      active.begin(),
+                      active_functor<ValueType>());
+
+    return thrust::reduce(exec, active.begin(), active.end(), size_t(0));
+}
+
+} // end batched_detail namespace
+} // end namespace krylov
+} // end namespace cusp
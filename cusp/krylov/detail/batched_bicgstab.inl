@@ -0,0 +1,269 @@
+/*
+ *  Copyright 2008-2014 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include <cusp/array1d.h>
+#include <cusp/exception.h>
+#include <cusp/linear_operator.h>
+#include <cusp/multiply.h>
+#include <cusp/monitor.h>
+
+#include <cusp/blas/blas.h>
+
+#include <cusp/detail/temporary_array.h>
+
+#include <cusp/krylov/detail/batched.h>
+
+#include <thrust/functional.h>
+
+namespace cusp
+{
+namespace krylov
+{
+namespace batched_detail
+{
+
+// beta <- (rho_new / rho) * (alpha / omega), zero for finished systems
+template <typename ValueType>
+struct bicgstab_beta_functor
+{
+    template <typename Tuple>
+    __host__ __device__
+    ValueType operator()(const Tuple& t) const
+    {
+        const ValueType omega = thrust::get<4>(t);
+
+        if (!thrust::get<0>(t) || omega == ValueType(0))
+            return ValueType(0);
+
+        return (ValueType(thrust::get<1>(t)) / ValueType(thrust::get<2>(t))) * (ValueType(thrust::get<3>(t)) / omega);
+    }
+};
+
+template <typename DerivedPolicy,
+          typename LinearOperator,
+          typename VectorType1,
+          typename VectorType2,
+          typename Monitor,
+          typename Preconditioner>
+void batched_bicgstab(thrust::execution_policy<DerivedPolicy> &exec,
+                      const LinearOperator& A,
+                            VectorType1& x,
+                      const VectorType2& b,
+                      const size_t block_size,
+                            Monitor& monitor,
+                            Preconditioner& M)
+{
+    typedef typename LinearOperator::value_type           ValueType;
+    typedef typename cusp::norm_type<ValueType>::type     Real;
+
+    assert(A.num_rows == A.num_cols);        // sanity check
+
+    if (block_size == 0 || A.num_rows % block_size != 0)
+        throw cusp::invalid_input_exception("number of rows must be a multiple of block_size");
+
+    const size_t N = A.num_rows;
+    const size_t num_blocks = N / block_size;
+
+    thrust::constant_iterator<ValueType> ones(1);
+    thrust::negate<ValueType> negate;
+
+    // allocate workspace
+    cusp::detail::temporary_array<ValueType, DerivedPolicy>      p(exec, N);
+    cusp::detail::temporary_array<ValueType, DerivedPolicy>      r(exec, N);
+    cusp::detail::temporary_array<ValueType, DerivedPolicy> r_star(exec, N);
+    cusp::detail::temporary_array<ValueType, DerivedPolicy>      s(exec, N);
+    cusp::detail::temporary_array<ValueType, DerivedPolicy>     Mp(exec, N);
+    cusp::detail::temporary_array<ValueType, DerivedPolicy>    AMp(exec, N);
+    cusp::detail::temporary_array<ValueType, DerivedPolicy>     Ms(exec, N);
+    cusp::detail::temporary_array<ValueType, DerivedPolicy>    AMs(exec, N);
+
+    // per block scalars
+    cusp::detail::temporary_array<ValueType, DerivedPolicy>  rho(exec, num_blocks);
+    cusp::detail::temporary_array<ValueType, DerivedPolicy>  rho_old(exec, num_blocks);
+    cusp::detail::temporary_array<ValueType, DerivedPolicy>  dot1(exec, num_blocks);
+    cusp::detail::temporary_array<ValueType, DerivedPolicy>  dot2(exec, num_blocks);
+    cusp::detail::temporary_array<ValueType, DerivedPolicy>  rr(exec, num_blocks);
+    cusp::detail::temporary_array<ValueType, DerivedPolicy>  alpha(exec, num_blocks);
+    cusp::detail::temporary_array<ValueType, DerivedPolicy>  omega(exec, num_blocks);
+    cusp::detail::temporary_array<ValueType, DerivedPolicy>  beta(exec, num_blocks);
+    cusp::detail::temporary_array<Real, DerivedPolicy>       tolerance(exec, num_blocks);
+    cusp::detail::temporary_array<int, DerivedPolicy>        active(exec, num_blocks);
+    cusp::detail::temporary_array<int, DerivedPolicy>        s_active(exec, num_blocks);
+
+    // tolerance <- absolute_tolerance + relative_tolerance * ||b_i||
+    block_dotc(exec, b, b, block_size, rr);
+    thrust::transform(exec, rr.begin(), rr.end(), tolerance.begin(),
+                      tolerance_functor<ValueType>(monitor.relative_tolerance(), monitor.absolute_tolerance()));
+
+    // r <- Ax
+    cusp::multiply(exec, A, x, r);
+
+    // r <- b - A*x
+    cusp::blas::axpby(exec, b, r, r, ValueType(1), ValueType(-1));
+
+    // p <- r
+    cusp::blas::copy(exec, r, p);
+
+    // r_star <- r
+    cusp::blas::copy(exec, r, r_star);
+
+    // rho = <r_star, r>
+    block_dotc(exec, r_star, r, block_size, rho);
+
+    while (update_active(exec, r, tolerance, block_size, rr, active) > 0 &&
+           monitor.iteration_count() < monitor.iteration_limit())
+    {
+        // Mp = M*p
+        cusp::multiply(exec, M, p, Mp);
+
+        // AMp = A*Mp
+        cusp::multiply(exec, A, Mp, AMp);
+
+        // alpha = (r_j, r_star) / (A*M*p, r_star), zero for converged systems
+        block_dotc(exec, r_star, AMp, block_size, dot1);
+        thrust::transform(exec,
+                          thrust::make_zip_iterator(thrust::make_tuple(active.begin(), rho.begin(), dot1.begin())),
+                          thrust::make_zip_iterator(thrust::make_tuple(active.end(),   rho.end(),   dot1.end())),
+                          alpha.begin(),
+                          masked_divide_functor<ValueType>());
+
+        // s_j = r_j - alpha * AMp
+        block_axpby(exec, r, AMp, s, ones, thrust::make_transform_iterator(alpha.begin(), negate), block_size);
+
+        // systems with a small s finish with x += alpha*M*p_j below
+        update_active(exec, s, tolerance, block_size, rr, s_active);
+
+        // Ms = M*s_j
+        cusp::multiply(exec, M, s, Ms);
+
+        // AMs = A*Ms
+        cusp::multiply(exec, A, Ms, AMs);
+
+        // omega = (AMs, s) / (AMs, AMs)
+        block_dotc(exec, AMs, s,   block_size, dot1);
+        block_dotc(exec, AMs, AMs, block_size, dot2);
+        thrust::transform(exec,
+                          thrust::make_zip_iterator(thrust::make_tuple(s_active.begin(), dot1.begin(), dot2.begin())),
+                          thrust::make_zip_iterator(thrust::make_tuple(s_active.end(),   dot1.end(),   dot2.end())),
+                          omega.begin(),
+                          masked_divide_functor<ValueType>());
+
+        // x_{j+1} = x_j + alpha*M*p_j + omega*M*s_j
+        block_axpby(exec, x, Mp, x, ones, alpha.begin(), block_size);
+        block_axpby(exec, x, Ms, x, ones, omega.begin(), block_size);
+
+        // r_{j+1} = s_j - omega*A*M*s
+        block_axpby(exec, s, AMs, r, ones, thrust::make_transform_iterator(omega.begin(), negate), block_size);
+
+        // beta_j = (r_{j+1}, r_star) / (r_j, r_star) * (alpha/omega)
+        rho.swap(rho_old);
+        block_dotc(exec, r_star, r, block_size, rho);
+        thrust::transform(exec,
+                          thrust::make_zip_iterator(thrust::make_tuple(s_active.begin(), rho.begin(), rho_old.begin(), alpha.begin(), omega.begin())),
+                          thrust::make_zip_iterator(thrust::make_tuple(s_active.end(),   rho.end(),   rho_old.end(),   alpha.end(),   omega.end())),
+                          beta.begin(),
+                          bicgstab_beta_functor<ValueType>());
+
+        // p_{j+1} = r_{j+1} + beta*(p_j - omega*A*M*p)
+        block_axpby(exec, p, AMp, p, ones, thrust::make_transform_iterator(omega.begin(), negate), block_size);
+        block_axpby(exec, r, p, p, ones, beta.begin(), block_size);
+
+        ++monitor;
+    }
+
+    // record the residual of the whole batch
+    monitor.finished(exec, r);
+}
+
+} // end batched_detail namespace
+
+template <typename DerivedPolicy,
+          typename LinearOperator,
+          typename VectorType1,
+          typename VectorType2,
+          typename Monitor,
+          typename Preconditioner>
+void batched_bicgstab(const thrust::detail::execution_policy_base<DerivedPolicy> &exec,
+                      const LinearOperator& A,
+                            VectorType1& x,
+                      const VectorType2& b,
+                      const size_t block_size,
+                            Monitor& monitor,
+                            Preconditioner& M)
+{
+    using cusp::krylov::batched_detail::batched_bicgstab;
+
+    return batched_bicgstab(thrust::detail::derived_cast(thrust::detail::strip_const(exec)), A, x, b, block_size, monitor, M);
+}
+
+template <typename LinearOperator,
+          typename VectorType1,
+          typename VectorType2,
+          typename Monitor,
+          typename Preconditioner>
+void batched_bicgstab(const LinearOperator& A,
+                            VectorType1& x,
+                      const VectorType2& b,
+                      const size_t block_size,
+                            Monitor& monitor,
+                            Preconditioner& M)
+{
+    using thrust::system::detail::generic::select_system;
+
+    typedef typename LinearOperator::memory_space System1;
+    typedef typename VectorType2::memory_space    System2;
+
+    System1 system1;
+    System2 system2;
+
+    return cusp::krylov::batched_bicgstab(select_system(system1,system2), A, x, b, block_size, monitor, M);
+}
+
+template <typename LinearOperator,
+          typename VectorType1,
+          typename VectorType2,
+          typename Monitor>
+void batched_bicgstab(const LinearOperator& A,
+                            VectorType1& x,
+                      const VectorType2& b,
+                      const size_t block_size,
+                            Monitor& monitor)
+{
+    typedef typename LinearOperator::value_type   ValueType;
+    typedef typename LinearOperator::memory_space MemorySpace;
+
+    cusp::identity_operator<ValueType,MemorySpace> M(A.num_rows, A.num_cols);
+
+    return cusp::krylov::batched_bicgstab(A, x, b, block_size, monitor, M);
+}
+
+template <typename LinearOperator,
+          typename VectorType1,
+          typename VectorType2>
+void batched_bicgstab(const LinearOperator& A,
+                            VectorType1& x,
+                      const VectorType2& b,
+                      const size_t block_size)
+{
+    typedef typename LinearOperator::value_type   ValueType;
+
+    cusp::monitor<ValueType> monitor(b);
+
+    return cusp::krylov::batched_bicgstab(A, x, b, block_size, monitor);
+}
+
+} // end namespace krylov
+} // end namespace cusp
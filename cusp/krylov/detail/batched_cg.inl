@@ -0,0 +1,223 @@
+/*
+ *  Copyright 2008-2014 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include <cusp/array1d.h>
+#include <cusp/exception.h>
+#include <cusp/linear_operator.h>
+#include <cusp/multiply.h>
+#include <cusp/monitor.h>
+
+#include <cusp/blas/blas.h>
+
+#include <cusp/detail/temporary_array.h>
+
+#include <cusp/krylov/detail/batched.h>
+
+#include <thrust/functional.h>
+
+namespace cusp
+{
+namespace krylov
+{
+namespace batched_detail
+{
+
+template <typename DerivedPolicy,
+          typename LinearOperator,
+          typename VectorType1,
+          typename VectorType2,
+          typename Monitor,
+          typename Preconditioner>
+void batched_cg(thrust::execution_policy<DerivedPolicy> &exec,
+                const LinearOperator& A,
+                      VectorType1& x,
+                const VectorType2& b,
+                const size_t block_size,
+                      Monitor& monitor,
+                      Preconditioner& M)
+{
+    typedef typename LinearOperator::value_type           ValueType;
+    typedef typename cusp::norm_type<ValueType>::type     Real;
+
+    assert(A.num_rows == A.num_cols);        // sanity check
+
+    if (block_size == 0 || A.num_rows % block_size != 0)
+        throw cusp::invalid_input_exception("number of rows must be a multiple of block_size");
+
+    const size_t N = A.num_rows;
+    const size_t num_blocks = N / block_size;
+
+    thrust::constant_iterator<ValueType> ones(1);
+
+    // allocate workspace
+    cusp::detail::temporary_array<ValueType, DerivedPolicy> y(exec, N);
+    cusp::detail::temporary_array<ValueType, DerivedPolicy> z(exec, N);
+    cusp::detail::temporary_array<ValueType, DerivedPolicy> r(exec, N);
+    cusp::detail::temporary_array<ValueType, DerivedPolicy> p(exec, N);
+
+    // per block scalars
+    cusp::detail::temporary_array<ValueType, DerivedPolicy> rz(exec, num_blocks);
+    cusp::detail::temporary_array<ValueType, DerivedPolicy> rz_old(exec, num_blocks);
+    cusp::detail::temporary_array<ValueType, DerivedPolicy> yp(exec, num_blocks);
+    cusp::detail::temporary_array<ValueType, DerivedPolicy> rr(exec, num_blocks);
+    cusp::detail::temporary_array<ValueType, DerivedPolicy> alpha(exec, num_blocks);
+    cusp::detail::temporary_array<ValueType, DerivedPolicy> beta(exec, num_blocks);
+    cusp::detail::temporary_array<Real, DerivedPolicy>      tolerance(exec, num_blocks);
+    cusp::detail::temporary_array<int, DerivedPolicy>       active(exec, num_blocks);
+
+    // tolerance <- absolute_tolerance + relative_tolerance * ||b_i||
+    block_dotc(exec, b, b, block_size, rr);
+    thrust::transform(exec, rr.begin(), rr.end(), tolerance.begin(),
+                      tolerance_functor<ValueType>(monitor.relative_tolerance(), monitor.absolute_tolerance()));
+
+    // y <- Ax
+    cusp::multiply(exec, A, x, y);
+
+    // r <- b - A*x
+    cusp::blas::axpby(exec, b, y, r, ValueType(1), ValueType(-1));
+
+    // z <- M*r
+    cusp::multiply(exec, M, r, z);
+
+    // p <- z
+    cusp::blas::copy(exec, z, p);
+
+    // rz = <r^H, z>
+    block_dotc(exec, r, z, block_size, rz);
+
+    while (update_active(exec, r, tolerance, block_size, rr, active) > 0 &&
+           monitor.iteration_count() < monitor.iteration_limit())
+    {
+        // y <- Ap
+        cusp::multiply(exec, A, p, y);
+
+        // alpha <- <r,z>/<y,p>, zero for converged systems
+        block_dotc(exec, y, p, block_size, yp);
+        thrust::transform(exec,
+                          thrust::make_zip_iterator(thrust::make_tuple(active.begin(), rz.begin(), yp.begin())),
+                          thrust::make_zip_iterator(thrust::make_tuple(active.end(),   rz.end(),   yp.end())),
+                          alpha.begin(),
+                          masked_divide_functor<ValueType>());
+
+        // x <- x + alpha * p
+        block_axpby(exec, x, p, x, ones, alpha.begin(), block_size);
+
+        // r <- r - alpha * y
+        block_axpby(exec, r, y, r, ones, thrust::make_transform_iterator(alpha.begin(), thrust::negate<ValueType>()), block_size);
+
+        // z <- M*r
+        cusp::multiply(exec, M, r, z);
+
+        // rz = <r^H, z>
+        rz.swap(rz_old);
+        block_dotc(exec, r, z, block_size, rz);
+
+        // beta <- <r_{i+1},r_{i+1}>/<r,r>
+        thrust::transform(exec,
+                          thrust::make_zip_iterator(thrust::make_tuple(active.begin(), rz.begin(), rz_old.begin())),
+                          thrust::make_zip_iterator(thrust::make_tuple(active.end(),   rz.end(),   rz_old.end())),
+                          beta.begin(),
+                          masked_divide_functor<ValueType>());
+
+        // p <- z + beta*p
+        block_axpby(exec, z, p, p, ones, beta.begin(), block_size);
+
+        ++monitor;
+    }
+
+    // record the residual of the whole batch
+    monitor.finished(exec, r);
+}
+
+} // end batched_detail namespace
+
+template <typename DerivedPolicy,
+          typename LinearOperator,
+          typename VectorType1,
+          typename VectorType2,
+          typename Monitor,
+          typename Preconditioner>
+void batched_cg(const thrust::detail::execution_policy_base<DerivedPolicy> &exec,
+                const LinearOperator& A,
+                      VectorType1& x,
+                const VectorType2& b,
+                const size_t block_size,
+                      Monitor& monitor,
+                      Preconditioner& M)
+{
+    using cusp::krylov::batched_detail::batched_cg;
+
+    return batched_cg(thrust::detail::derived_cast(thrust::detail::strip_const(exec)), A, x, b, block_size, monitor, M);
+}
+
+template <typename LinearOperator,
+          typename VectorType1,
+          typename VectorType2,
+          typename Monitor,
+          typename Preconditioner>
+void batched_cg(const LinearOperator& A,
+                      VectorType1& x,
+                const VectorType2& b,
+                const size_t block_size,
+                      Monitor& monitor,
+                      Preconditioner& M)
+{
+    using thrust::system::detail::generic::select_system;
+
+    typedef typename LinearOperator::memory_space System1;
+    typedef typename VectorType2::memory_space    System2;
+
+    System1 system1;
+    System2 system2;
+
+    return cusp::krylov::batched_cg(select_system(system1,system2), A, x, b, block_size, monitor, M);
+}
+
+template <typename LinearOperator,
+          typename VectorType1,
+          typename VectorType2,
+          typename Monitor>
+void batched_cg(const LinearOperator& A,
+                      VectorType1& x,
+                const VectorType2& b,
+                const size_t block_size,
+                      Monitor& monitor)
+{
+    typedef typename LinearOperator::value_type   ValueType;
+    typedef typename LinearOperator::memory_space MemorySpace;
+
+    cusp::identity_operator<ValueType,MemorySpace> M(A.num_rows, A.num_cols);
+
+    return cusp::krylov::batched_cg(A, x, b, block_size, monitor, M);
+}
+
+template <typename LinearOperator,
+          typename VectorType1,
+          typename VectorType2>
+void batched_cg(const LinearOperator& A,
+                      VectorType1& x,
+                const VectorType2& b,
+                const size_t block_size)
+{
+    typedef typename LinearOperator::value_type   ValueType;
+
+    cusp::monitor<ValueType> monitor(b);
+
+    return cusp::krylov::batched_cg(A, x, b, block_size, monitor);
+}
+
+} // end namespace krylov
+} // end namespace cusp
@@ -24,6 +24,8 @@
 
 #include <cusp/detail/temporary_array.h>
 
+#include <thrust/tuple.h>
+
 namespace blas = cusp::blas;
 
 namespace cusp
@@ -38,30 +40,28 @@ template <typename DerivedPolicy,
           typename VectorType1,
           typename VectorType2,
           typename Monitor,
-          typename Preconditioner>
+          typename Preconditioner,
+          typename ArrayType>
 void bicgstab(thrust::execution_policy<DerivedPolicy> &exec,
               const LinearOperator& A,
                     VectorType1& x,
               const VectorType2& b,
                     Monitor& monitor,
-                    Preconditioner& M)
+                    Preconditioner& M,
+                    ArrayType& p,
+                    ArrayType& r,
+                    ArrayType& r_star,
+                    ArrayType& s,
+                    ArrayType& Mp,
+                    ArrayType& AMp,
+                    ArrayType& Ms,
+                    ArrayType& AMs)
 {
     typedef typename LinearOperator::value_type           ValueType;
+    typedef typename cusp::norm_type<ValueType>::type     NormType;
 
     assert(A.num_rows == A.num_cols);        // sanity check
 
-    const size_t N = A.num_rows;
-
-    // allocate workspace
-    cusp::detail::temporary_array<ValueType, DerivedPolicy>   p(exec, N);
-    cusp::detail::temporary_array<ValueType, DerivedPolicy>   r(exec, N);
-    cusp::detail::temporary_array<ValueType, DerivedPolicy> r_star(exec, N);
-    cusp::detail::temporary_array<ValueType, DerivedPolicy>   s(exec, N);
-    cusp::detail::temporary_array<ValueType, DerivedPolicy>  Mp(exec, N);
-    cusp::detail::temporary_array<ValueType, DerivedPolicy> AMp(exec, N);
-    cusp::detail::temporary_array<ValueType, DerivedPolicy>  Ms(exec, N);
-    cusp::detail::temporary_array<ValueType, DerivedPolicy> AMs(exec, N);
-
     // r <- Ax
     cusp::multiply(exec, A, x, r);
 
@@ -102,8 +102,9 @@ void bicgstab(thrust::execution_policy<DerivedPolicy> &exec,
         // AMs = A*Ms
         cusp::multiply(exec, A, Ms, AMs);
 
-        // omega = (AMs, s) / (AMs, AMs)
-        ValueType omega = blas::dotc(exec, AMs, s) / blas::dotc(exec, AMs, AMs);
+        // omega = (AMs, s) / (AMs, AMs), both from a single pass over AMs
+        thrust::tuple<ValueType,NormType> AMs_s = blas::dotc_nrm2(exec, AMs, s);
+        ValueType omega = thrust::get<0>(AMs_s) / (thrust::get<1>(AMs_s) * thrust::get<1>(AMs_s));
 
         // x_{j+1} = x_j + alpha*M*p_j + omega*M*s_j
         blas::axpbypcz(exec, x, Mp, Ms, x, ValueType(1), alpha, omega);
@@ -123,6 +124,36 @@ void bicgstab(thrust::execution_policy<DerivedPolicy> &exec,
     }
 }
 
+template <typename DerivedPolicy,
+          typename LinearOperator,
+          typename VectorType1,
+          typename VectorType2,
+          typename Monitor,
+          typename Preconditioner>
+void bicgstab(thrust::execution_policy<DerivedPolicy> &exec,
+              const LinearOperator& A,
+                    VectorType1& x,
+              const VectorType2& b,
+                    Monitor& monitor,
+                    Preconditioner& M)
+{
+    typedef typename LinearOperator::value_type           ValueType;
+
+    const size_t N = A.num_rows;
+
+    // allocate workspace
+    cusp::detail::temporary_array<ValueType, DerivedPolicy>   p(exec, N);
+    cusp::detail::temporary_array<ValueType, DerivedPolicy>   r(exec, N);
+    cusp::detail::temporary_array<ValueType, DerivedPolicy> r_star(exec, N);
+    cusp::detail::temporary_array<ValueType, DerivedPolicy>   s(exec, N);
+    cusp::detail::temporary_array<ValueType, DerivedPolicy>  Mp(exec, N);
+    cusp::detail::temporary_array<ValueType, DerivedPolicy> AMp(exec, N);
+    cusp::detail::temporary_array<ValueType, DerivedPolicy>  Ms(exec, N);
+    cusp::detail::temporary_array<ValueType, DerivedPolicy> AMs(exec, N);
+
+    bicgstab(exec, A, x, b, monitor, M, p, r, r_star, s, Mp, AMp, Ms, AMs);
+}
+
 } // end bicg_detail namespace
 
 template <typename DerivedPolicy,
@@ -196,6 +227,110 @@ void bicgstab(const LinearOperator& A,
     return cusp::krylov::bicgstab(A, x, b, monitor);
 }
 
+/////////////////////
+// bicgstab_solver //
+/////////////////////
+
+template <typename ValueType, typename MemorySpace>
+bicgstab_solver<ValueType,MemorySpace>
+::bicgstab_solver(const size_t N)
+    : p(N), r(N), r_star(N), s(N), Mp(N), AMp(N), Ms(N), AMs(N) {}
+
+template <typename ValueType, typename MemorySpace>
+void
+bicgstab_solver<ValueType,MemorySpace>
+::resize(const size_t N)
+{
+    p.resize(N);
+    r.resize(N);
+    r_star.resize(N);
+    s.resize(N);
+    Mp.resize(N);
+    AMp.resize(N);
+    Ms.resize(N);
+    AMs.resize(N);
+}
+
+template <typename ValueType, typename MemorySpace>
+template <typename DerivedPolicy,
+          typename LinearOperator,
+          typename VectorType1,
+          typename VectorType2,
+          typename Monitor,
+          typename Preconditioner>
+void
+bicgstab_solver<ValueType,MemorySpace>
+::solve(const thrust::detail::execution_policy_base<DerivedPolicy> &exec,
+        const LinearOperator& A,
+              VectorType1& x,
+        const VectorType2& b,
+              Monitor& monitor,
+              Preconditioner& M)
+{
+    using cusp::krylov::bicg_detail::bicgstab;
+
+    resize(A.num_rows);
+
+    bicgstab(thrust::detail::derived_cast(thrust::detail::strip_const(exec)), A, x, b, monitor, M, p, r, r_star, s, Mp, AMp, Ms, AMs);
+}
+
+template <typename ValueType, typename MemorySpace>
+template <typename LinearOperator,
+          typename VectorType1,
+          typename VectorType2,
+          typename Monitor,
+          typename Preconditioner>
+void
+bicgstab_solver<ValueType,MemorySpace>
+::solve(const LinearOperator& A,
+              VectorType1& x,
+        const VectorType2& b,
+              Monitor& monitor,
+              Preconditioner& M)
+{
+    using thrust::system::detail::generic::select_system;
+
+    typedef typename LinearOperator::memory_space System1;
+    typedef typename VectorType2::memory_space    System2;
+
+    System1 system1;
+    System2 system2;
+
+    solve(select_system(system1,system2), A, x, b, monitor, M);
+}
+
+template <typename ValueType, typename MemorySpace>
+template <typename LinearOperator,
+          typename VectorType1,
+          typename VectorType2,
+          typename Monitor>
+void
+bicgstab_solver<ValueType,MemorySpace>
+::solve(const LinearOperator& A,
+              VectorType1& x,
+        const VectorType2& b,
+              Monitor& monitor)
+{
+    cusp::identity_operator<ValueType,MemorySpace> M(A.num_rows, A.num_cols);
+
+    solve(A, x, b, monitor, M);
+}
+
+template <typename ValueType, typename MemorySpace>
+template <typename LinearOperator,
+          typename VectorType1,
+          typename VectorType2>
+void
+bicgstab_solver<ValueType,MemorySpace>
+::solve(const LinearOperator& A,
+              VectorType1& x,
+        const VectorType2& b)
+{
+    cusp::monitor<ValueType> monitor(b);
+
+    solve(A, x, b, monitor);
+}
+
 } // end namespace krylov
 } // end namespace cusp
 
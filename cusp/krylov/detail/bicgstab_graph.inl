@@ -0,0 +1,487 @@
+/*
+ *  Copyright 2008-2014 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include <cusp/array1d.h>
+#include <cusp/linear_operator.h>
+#include <cusp/multiply.h>
+#include <cusp/monitor.h>
+
+#include <cusp/detail/temporary_array.h>
+
+#include <cusp/blas/blas.h>
+#include <cusp/krylov/bicgstab.h>
+
+#if THRUST_DEVICE_SYSTEM == THRUST_DEVICE_SYSTEM_CUDA
+#include <cusp/system/cuda/stream_graph.h>
+#include <cusp/system/cuda/detail/stream_graph_blas.h>
+#endif
+
+namespace cusp
+{
+namespace krylov
+{
+namespace bicg_detail
+{
+
+// graphs are specific to the CUDA backend, elsewhere the iteration is bicgstab
+template <typename DerivedPolicy,
+          typename LinearOperator,
+          typename VectorType1,
+          typename VectorType2,
+          typename Monitor,
+          typename Preconditioner>
+void bicgstab_graph(thrust::execution_policy<DerivedPolicy> &exec,
+                    const LinearOperator& A,
+                          VectorType1& x,
+                    const VectorType2& b,
+                          Monitor& monitor,
+                          Preconditioner& M)
+{
+    bicgstab(exec, A, x, b, monitor, M);
+}
+
+#if THRUST_DEVICE_SYSTEM == THRUST_DEVICE_SYSTEM_CUDA
+
+// positions of the recurrence scalars in device memory
+enum { BICGSTAB_RHO = 0, BICGSTAB_ALPHA = 1, BICGSTAB_OMEGA = 2, BICGSTAB_BETA = 3, BICGSTAB_NUM_SCALARS = 4 };
+
+template <typename ValueType>
+struct bicgstab_store_rho
+{
+    __host__ __device__
+    void operator()(ValueType * s, const ValueType * dots) const
+    {
+        s[BICGSTAB_RHO] = dots[0];
+    }
+};
+
+// alpha = (r_j, r_star) / (A*M*p, r_star)
+template <typename ValueType>
+struct bicgstab_alpha
+{
+    __host__ __device__
+    void operator()(ValueType * s, const ValueType * dots) const
+    {
+        s[BICGSTAB_ALPHA] = dots[0] == ValueType(0) ? ValueType(0) : s[BICGSTAB_RHO] / dots[0];
+    }
+};
+
+// omega = (AMs, s) / (AMs, AMs)
+template <typename ValueType>
+struct bicgstab_omega
+{
+    __host__ __device__
+    void operator()(ValueType * s, const ValueType * dots) const
+    {
+        s[BICGSTAB_OMEGA] = dots[1] == ValueType(0) ? ValueType(0) : dots[0] / dots[1];
+    }
+};
+
+// beta_j = (r_{j+1}, r_star) / (r_j, r_star) * (alpha/omega)
+template <typename ValueType>
+struct bicgstab_beta
+{
+    __host__ __device__
+    void operator()(ValueType * s, const ValueType * dots) const
+    {
+        if(s[BICGSTAB_RHO] == ValueType(0) || s[BICGSTAB_OMEGA] == ValueType(0))
+            s[BICGSTAB_BETA] = ValueType(0);
+        else
+            s[BICGSTAB_BETA] = (dots[0] / s[BICGSTAB_RHO]) * (s[BICGSTAB_ALPHA] / s[BICGSTAB_OMEGA]);
+
+        s[BICGSTAB_RHO] = dots[0];
+    }
+};
+
+// s_j = r_j - alpha * AMp
+template <typename ValueType>
+struct bicgstab_update_s
+{
+    ValueType * s;
+    const ValueType * r;
+    const ValueType * AMp;
+    const ValueType * scalars;
+
+    bicgstab_update_s(ValueType * s, const ValueType * r, const ValueType * AMp, const ValueType * scalars)
+      : s(s), r(r), AMp(AMp), scalars(scalars) {}
+
+    __device__
+    void operator()(const int i) const
+    {
+        s[i] = r[i] - scalars[BICGSTAB_ALPHA] * AMp[i];
+    }
+};
+
+// x_{j+1} = x_j + alpha*M*p_j + omega*M*s_j and r_{j+1} = s_j - omega*A*M*s
+template <typename ValueType>
+struct bicgstab_update_xr
+{
+    ValueType * x;
+    ValueType * r;
+    const ValueType * Mp;
+    const ValueType * Ms;
+    const ValueType * s;
+    const ValueType * AMs;
+    const ValueType * scalars;
+
+    bicgstab_update_xr(ValueType * x, ValueType * r,
+                       const ValueType * Mp, const ValueType * Ms,
+                       const ValueType * s, const ValueType * AMs,
+                       const ValueType * scalars)
+      : x(x), r(r), Mp(Mp), Ms(Ms), s(s), AMs(AMs), scalars(scalars) {}
+
+    __device__
+    void operator()(const int i) const
+    {
+        const ValueType alpha = scalars[BICGSTAB_ALPHA];
+        const ValueType omega = scalars[BICGSTAB_OMEGA];
+
+        x[i] += alpha * Mp[i] + omega * Ms[i];
+        r[i]  = s[i] - omega * AMs[i];
+    }
+};
+
+// p_{j+1} = r_{j+1} + beta*(p_j - omega*A*M*p)
+template <typename ValueType>
+struct bicgstab_update_p
+{
+    ValueType * p;
+    const ValueType * r;
+    const ValueType * AMp;
+    const ValueType * scalars;
+
+    bicgstab_update_p(ValueType * p, const ValueType * r, const ValueType * AMp, const ValueType * scalars)
+      : p(p), r(r), AMp(AMp), scalars(scalars) {}
+
+    __device__
+    void operator()(const int i) const
+    {
+        const ValueType beta  = scalars[BICGSTAB_BETA];
+        const ValueType omega = scalars[BICGSTAB_OMEGA];
+
+        p[i] = r[i] + beta * (p[i] - omega * AMp[i]);
+    }
+};
+
+// one BiCGstab iteration, or the parts of it selected by steps, issued on
+// the stream of the policy it is called with
+template <typename LinearOperator,
+          typename VectorType,
+          typename Preconditioner,
+          typename ArrayType>
+struct bicgstab_graph_iteration
+{
+    typedef typename LinearOperator::value_type ValueType;
+
+    enum { APPLY_M_P = 1, UPDATE_S = 2, APPLY_M_S = 4, UPDATE_R = 8, ALL_STEPS = 15 };
+
+    const LinearOperator& A;
+    Preconditioner& M;
+    ArrayType& p;
+    ArrayType& s;
+
+    // without preconditioning Mp and Ms alias p and s
+    ArrayType& Mp;
+    ArrayType& AMp;
+    ArrayType& Ms;
+    ArrayType& AMs;
+
+    const size_t N;
+    const bool identity;
+
+    ValueType * x_ptr;
+    ValueType * p_ptr;
+    ValueType * r_ptr;
+    ValueType * r_star_ptr;
+    ValueType * s_ptr;
+    ValueType * Mp_ptr;
+    ValueType * AMp_ptr;
+    ValueType * Ms_ptr;
+    ValueType * AMs_ptr;
+    ValueType * scalars_ptr;
+    ValueType * partials_ptr;
+
+    int steps;
+
+    bicgstab_graph_iteration(const LinearOperator& A, VectorType& x, Preconditioner& M,
+                             ArrayType& p, ArrayType& r, ArrayType& r_star, ArrayType& s,
+                             ArrayType& Mp, ArrayType& AMp, ArrayType& Ms, ArrayType& AMs,
+                             ArrayType& scalars, ArrayType& partials)
+      : A(A), M(M), p(p), s(s),
+        Mp(cusp::system::cuda::detail::is_identity_operator<Preconditioner>::value ? p : Mp), AMp(AMp),
+        Ms(cusp::system::cuda::detail::is_identity_operator<Preconditioner>::value ? s : Ms), AMs(AMs),
+        N(A.num_rows), identity(cusp::system::cuda::detail::is_identity_operator<Preconditioner>::value),
+        steps(ALL_STEPS)
+    {
+        x_ptr        = thrust::raw_pointer_cast(&x[0]);
+        p_ptr        = thrust::raw_pointer_cast(&p[0]);
+        r_ptr        = thrust::raw_pointer_cast(&r[0]);
+        r_star_ptr   = thrust::raw_pointer_cast(&r_star[0]);
+        s_ptr        = thrust::raw_pointer_cast(&s[0]);
+        Mp_ptr       = thrust::raw_pointer_cast(&this->Mp[0]);
+        AMp_ptr      = thrust::raw_pointer_cast(&AMp[0]);
+        Ms_ptr       = thrust::raw_pointer_cast(&this->Ms[0]);
+        AMs_ptr      = thrust::raw_pointer_cast(&AMs[0]);
+        scalars_ptr  = thrust::raw_pointer_cast(&scalars[0]);
+        partials_ptr = thrust::raw_pointer_cast(&partials[0]);
+    }
+
+    template <typename Policy>
+    void operator()(Policy& exec)
+    {
+        using namespace cusp::system::cuda::detail;
+
+        const int num_partials = graph_num_partials(N);
+
+        if((steps & APPLY_M_P) && !identity)
+        {
+            // Mp = M*p
+            cusp::multiply(exec, M, p, Mp);
+        }
+
+        if(steps & UPDATE_S)
+        {
+            // AMp = A*Mp
+            cusp::multiply(exec, A, Mp, AMp);
+
+            // alpha = (r_j, r_star) / (A*M*p, r_star)
+            graph_dotc(exec, N, r_star_ptr, AMp_ptr, partials_ptr);
+            graph_scalar<1>(exec, N, partials_ptr, scalars_ptr, bicgstab_alpha<ValueType>());
+
+            // s_j = r_j - alpha * AMp
+            graph_for_each(exec, N, bicgstab_update_s<ValueType>(s_ptr, r_ptr, AMp_ptr, scalars_ptr));
+        }
+
+        if((steps & APPLY_M_S) && !identity)
+        {
+            // Ms = M*s_j
+            cusp::multiply(exec, M, s, Ms);
+        }
+
+        if(steps & UPDATE_R)
+        {
+            // AMs = A*Ms
+            cusp::multiply(exec, A, Ms, AMs);
+
+            // omega = (AMs, s) / (AMs, AMs)
+            graph_dotc(exec, N, AMs_ptr, s_ptr,   partials_ptr);
+            graph_dotc(exec, N, AMs_ptr, AMs_ptr, partials_ptr + num_partials);
+            graph_scalar<2>(exec, N, partials_ptr, scalars_ptr, bicgstab_omega<ValueType>());
+
+            // x_{j+1} = x_j + alpha*M*p_j + omega*M*s_j and r_{j+1} = s_j - omega*A*M*s
+            graph_for_each(exec, N, bicgstab_update_xr<ValueType>(x_ptr, r_ptr, Mp_ptr, Ms_ptr, s_ptr, AMs_ptr, scalars_ptr));
+
+            // beta_j = (r_{j+1}, r_star) / (r_j, r_star) * (alpha/omega)
+            graph_dotc(exec, N, r_star_ptr, r_ptr, partials_ptr);
+            graph_scalar<1>(exec, N, partials_ptr, scalars_ptr, bicgstab_beta<ValueType>());
+
+            // p_{j+1} = r_{j+1} + beta*(p_j - omega*A*M*p)
+            graph_for_each(exec, N, bicgstab_update_p<ValueType>(p_ptr, r_ptr, AMp_ptr, scalars_ptr));
+        }
+    }
+};
+
+template <typename DerivedPolicy,
+          typename LinearOperator,
+          typename VectorType1,
+          typename VectorType2,
+          typename Monitor,
+          typename Preconditioner>
+void bicgstab_graph(cusp::cuda::execution_policy<DerivedPolicy> &exec,
+                    const LinearOperator& A,
+                          VectorType1& x,
+                    const VectorType2& b,
+                          Monitor& monitor,
+                          Preconditioner& M)
+{
+    using namespace cusp::system::cuda::detail;
+
+    typedef typename LinearOperator::value_type                ValueType;
+    typedef cusp::detail::temporary_array<ValueType, DerivedPolicy> ArrayType;
+    typedef bicgstab_graph_iteration<LinearOperator,VectorType1,Preconditioner,ArrayType> Iteration;
+
+    assert(A.num_rows == A.num_cols);        // sanity check
+
+    const size_t N = A.num_rows;
+
+    if(N == 0)
+    {
+        bicgstab(exec, A, x, b, monitor, M);
+        return;
+    }
+
+    graph_solver_stream solver_stream(stream(thrust::detail::derived_cast(exec)));
+    const cudaStream_t stream_s = solver_stream.get();
+
+    execute_on_stream sexec(stream_s);
+
+    const bool identity = is_identity_operator<Preconditioner>::value;
+
+    // allocate workspace
+    ArrayType p(exec, N);
+    ArrayType r(exec, N);
+    ArrayType r_star(exec, N);
+    ArrayType s(exec, N);
+    ArrayType Mp(exec, identity ? 0 : N);
+    ArrayType AMp(exec, N);
+    ArrayType Ms(exec, identity ? 0 : N);
+    ArrayType AMs(exec, N);
+    ArrayType scalars(exec, BICGSTAB_NUM_SCALARS);
+    ArrayType partials(exec, 2 * graph_num_partials(N));
+
+    Iteration iteration(A, x, M, p, r, r_star, s, Mp, AMp, Ms, AMs, scalars, partials);
+
+    // r <- Ax
+    cusp::multiply(sexec, A, x, r);
+
+    // r <- b - A*x
+    cusp::blas::axpby(sexec, b, r, r, ValueType(1), ValueType(-1));
+
+    // p <- r
+    cusp::blas::copy(sexec, r, p);
+
+    // r_star <- r
+    cusp::blas::copy(sexec, r, r_star);
+
+    // rho = (r_star, r), kept on the device
+    graph_dotc(sexec, N, iteration.r_star_ptr, iteration.r_ptr, iteration.partials_ptr);
+    graph_scalar<1>(sexec, N, iteration.partials_ptr, iteration.scalars_ptr, bicgstab_store_rho<ValueType>());
+
+    cusp::system::cuda::stream_graph full;
+    cusp::system::cuda::stream_graph update_s;
+    cusp::system::cuda::stream_graph update_r;
+
+    bool split = false;
+
+    if(!full.capture(stream_s, iteration) && !identity)
+    {
+        // M could not be captured, capture the work between its applications
+        iteration.steps = Iteration::UPDATE_S;
+
+        if(update_s.capture(stream_s, iteration))
+        {
+            iteration.steps = Iteration::UPDATE_R;
+            split = update_r.capture(stream_s, iteration);
+        }
+    }
+
+    if(full.empty() && !split)
+    {
+        // A could not be captured
+        bicgstab(exec, A, x, b, monitor, M);
+        return;
+    }
+
+    while (!monitor.finished(sexec, r))
+    {
+        if(split)
+        {
+            // Mp = M*p
+            cusp::multiply(sexec, M, p, Mp);
+
+            update_s.launch(stream_s);
+
+            // Ms = M*s_j
+            cusp::multiply(sexec, M, s, Ms);
+
+            update_r.launch(stream_s);
+        }
+        else
+        {
+            full.launch(stream_s);
+        }
+
+        ++monitor;
+    }
+}
+
+#endif
+
+} // end bicg_detail namespace
+
+template <typename DerivedPolicy,
+          typename LinearOperator,
+          typename VectorType1,
+          typename VectorType2,
+          typename Monitor,
+          typename Preconditioner>
+void bicgstab_graph(const thrust::detail::execution_policy_base<DerivedPolicy> &exec,
+                    const LinearOperator& A,
+                          VectorType1& x,
+                    const VectorType2& b,
+                          Monitor& monitor,
+                          Preconditioner& M)
+{
+    using cusp::krylov::bicg_detail::bicgstab_graph;
+
+    return bicgstab_graph(thrust::detail::derived_cast(thrust::detail::strip_const(exec)), A, x, b, monitor, M);
+}
+
+template <typename LinearOperator,
+          typename VectorType1,
+          typename VectorType2,
+          typename Monitor,
+          typename Preconditioner>
+void bicgstab_graph(const LinearOperator& A,
+                          VectorType1& x,
+                    const VectorType2& b,
+                          Monitor& monitor,
+                          Preconditioner& M)
+{
+    using thrust::system::detail::generic::select_system;
+
+    typedef typename LinearOperator::memory_space System1;
+    typedef typename VectorType2::memory_space    System2;
+
+    System1 system1;
+    System2 system2;
+
+    return cusp::krylov::bicgstab_graph(select_system(system1,system2), A, x, b, monitor, M);
+}
+
+template <typename LinearOperator,
+          typename VectorType1,
+          typename VectorType2,
+          typename Monitor>
+void bicgstab_graph(const LinearOperator& A,
+                          VectorType1& x,
+                    const VectorType2& b,
+                          Monitor& monitor)
+{
+    typedef typename LinearOperator::value_type   ValueType;
+    typedef typename LinearOperator::memory_space MemorySpace;
+
+    cusp::identity_operator<ValueType,MemorySpace> M(A.num_rows, A.num_cols);
+
+    return cusp::krylov::bicgstab_graph(A, x, b, monitor, M);
+}
+
+template <typename LinearOperator,
+          typename VectorType1,
+          typename VectorType2>
+void bicgstab_graph(const LinearOperator& A,
+                          VectorType1& x,
+                    const VectorType2& b)
+{
+    typedef typename LinearOperator::value_type   ValueType;
+
+    cusp::monitor<ValueType> monitor(b);
+
+    return cusp::krylov::bicgstab_graph(A, x, b, monitor);
+}
+
+} // end namespace krylov
+} // end namespace cusp
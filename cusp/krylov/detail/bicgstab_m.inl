@@ -19,6 +19,8 @@
 #include <cusp/multiply.h>
 #include <cusp/monitor.h>
 
+#include <cusp/krylov/detail/multi_mass.h>
+
 #include <thrust/copy.h>
 #include <thrust/fill.h>
 #include <thrust/functional.h>
@@ -65,20 +67,6 @@ namespace trans_m
   void compute_b_m(const Array1& z_1_s, const Array2& z_0_s,
 		Array3& beta_0_s, ScalarType beta_0);
 
-  template <typename InputIterator1, typename InputIterator2,
-            typename InputIterator3, typename OutputIterator,
-            typename ScalarType>
-  void compute_a_m(InputIterator1 z_0_s_b, InputIterator1 z_0_s_e,
-		InputIterator2 z_1_s_b, InputIterator3 beta_0_s_b,
-                OutputIterator alpha_0_s_b,
-		ScalarType beta_0, ScalarType alpha_0);
-
-  template <typename Array1, typename Array2, typename Array3,
-            typename Array4, typename ScalarType>
-  void compute_a_m(const Array1& z_0_s, const Array2& z_1_s,
-                const Array3& beta_0_s, Array4& alpha_0_s,
-		ScalarType beta_0, ScalarType alpha_0);
-
   template <typename Array1, typename Array2, typename Array3,
             typename Array4, typename Array5, typename Array6, typename Array7>
   void compute_x_m(const Array1& beta_0_s, const Array2& chi_0_s,
@@ -159,55 +147,76 @@ namespace trans_m
 // are specific to CG-M
 namespace detail_m
 {
-// computes new \zeta, \beta
-template <typename ScalarType>
-struct KERNEL_ZB
+// computes new \zeta, \beta, \chi, \rho and \alpha of every shift, shifts
+// whose residual \zeta_0^\sigma \rho_0^\sigma r_0 has converged are frozen
+template <typename ScalarType, typename NormType>
+struct KERNEL_ZBCRA
 {
     ScalarType beta_m1;
     ScalarType beta_0;
+    ScalarType alpha_m1;
     ScalarType alpha_0;
-
-    KERNEL_ZB(ScalarType _beta_m1, ScalarType _beta_0, ScalarType _alpha_0)
-        : beta_m1(_beta_m1), beta_0(_beta_0), alpha_0(_alpha_0)
+    ScalarType chi_0;
+    NormType   residual_norm;
+    NormType   tolerance;
+
+    KERNEL_ZBCRA(ScalarType _beta_m1, ScalarType _beta_0,
+                 ScalarType _alpha_m1, ScalarType _alpha_0, ScalarType _chi_0,
+                 NormType _residual_norm, NormType _tolerance)
+        : beta_m1(_beta_m1), beta_0(_beta_0),
+          alpha_m1(_alpha_m1), alpha_0(_alpha_0), chi_0(_chi_0),
+          residual_norm(_residual_norm), tolerance(_tolerance)
     {}
 
     template <typename Tuple>
     __host__ __device__
     void operator()(Tuple t)
     {
-        // compute \zeta_1^\sigma
-        ScalarType z1, b0, z0=thrust::get<2>(t), zm1 = thrust::get<3>(t),
-                           sigma = thrust::get<4>(t);
-        z1 = z0*zm1*beta_m1/(beta_0*alpha_0*(zm1-z0)
+        ScalarType z0 = thrust::get<0>(t), zm1 = thrust::get<1>(t),
+                   rho0 = thrust::get<5>(t), sigma = thrust::get<9>(t);
+
+        if (!thrust::get<8>(t))
+            return;
+
+        if (cusp::krylov::multi_mass_detail::shift_converged(z0*rho0, residual_norm, tolerance))
+        {
+            thrust::get<8>(t) = false;
+            return;
+        }
+
+        // compute \zeta_1^\sigma, \beta_0^\sigma
+        ScalarType z1, b0;
+        z1 = z0*zm1*beta_m1/(beta_0*alpha_m1*(zm1-z0)
                              +beta_m1*zm1*(ScalarType(1)-beta_0*sigma));
         b0 = beta_0*z1/z0;
-        if ( abs(z1) < ScalarType(1e-30) )
+        if ( cusp::abs(z1) < NormType(1e-30) )
             z1 = ScalarType(1e-18);
-        thrust::get<0>(t) = z1;
-        thrust::get<1>(t) = b0;
+        thrust::get<2>(t) = z1;
+        thrust::get<3>(t) = b0;
+
+        // compute \alpha_0^\sigma
+        thrust::get<4>(t) = alpha_0/beta_0*z1*b0/z0;
+
+        // compute \chi_0^\sigma, \rho_1^\sigma
+        ScalarType den = ScalarType(1.0)+chi_0*sigma;
+        thrust::get<7>(t) = chi_0/den;
+        thrust::get<6>(t) = rho0/den;
     }
 };
 
-// computes new alpha
-template <typename ScalarType>
-struct KERNEL_A
+// recycles \zeta_i^\sigma and \rho_i^\sigma of the active shifts
+struct KERNEL_RECYCLE
 {
-    ScalarType beta_0;
-    ScalarType alpha_0;
-
-    // note: only the ratio alpha_0/beta_0 enters in the computation, it might
-    // be better just to pass this ratio
-    KERNEL_A(ScalarType _beta_0, ScalarType _alpha_0)
-        : beta_0(_beta_0), alpha_0(_alpha_0)
-    {}
-
     template <typename Tuple>
     __host__ __device__
     void operator()(Tuple t)
     {
-        // compute \alpha_0^\sigma
-        thrust::get<0>(t)=alpha_0/beta_0*thrust::get<2>(t)*thrust::get<3>(t)/
-                          thrust::get<1>(t);
+        if (!thrust::get<5>(t))
+            return;
+
+        thrust::get<0>(t) = thrust::get<1>(t);
+        thrust::get<1>(t) = thrust::get<2>(t);
+        thrust::get<3>(t) = thrust::get<4>(t);
     }
 };
 
@@ -245,29 +254,12 @@ struct KERNEL_S
     }
 };
 
-// computes new \chi_0^\sigma \rho_1^\sigma
-template <typename ScalarType>
-struct KERNEL_CHIRHO
-{
-    ScalarType chi_0;
-    KERNEL_CHIRHO(ScalarType _chi_0) : chi_0(_chi_0)
-    {}
-
-    template <typename Tuple>
-    __host__ __device__
-    void operator()(Tuple t)
-    {
-        ScalarType den = ScalarType(1.0)+chi_0*thrust::get<3>(t);
-        thrust::get<0>(t)=chi_0/den;
-        thrust::get<1>(t)=thrust::get<2>(t)/den;
-    }
-};
-
-// computes new s
+// computes new x and s of every active shift in a single pass over the
+// column-major N-by-N_s solutions
 template <typename ScalarType>
 struct KERNEL_XS
 {
-    int N;
+    size_t N;
     const ScalarType *rp_beta_0_s;
     const ScalarType *rp_chi_0_s;
     const ScalarType *rp_rho_0_s;
@@ -278,8 +270,9 @@ struct KERNEL_XS
     const ScalarType *rp_r_0;
     const ScalarType *rp_r_1;
     const ScalarType *rp_w_1;
+    const bool *rp_active_s;
 
-    KERNEL_XS(int _N, const ScalarType *_rp_beta_0_s,
+    KERNEL_XS(size_t _N, const ScalarType *_rp_beta_0_s,
               const ScalarType *_rp_chi_0_s,
               const ScalarType *_rp_rho_0_s,
               const ScalarType *_rp_zeta_0_s,
@@ -288,7 +281,8 @@ struct KERNEL_XS
               const ScalarType *_rp_zeta_1_s,
               const ScalarType *_rp_r_0,
               const ScalarType *_rp_r_1,
-              const ScalarType *_rp_w_1) :
+              const ScalarType *_rp_w_1,
+              const bool *_rp_active_s) :
         N(_N),
         rp_beta_0_s(_rp_beta_0_s),
         rp_chi_0_s(_rp_chi_0_s),
@@ -299,16 +293,20 @@ struct KERNEL_XS
         rp_zeta_1_s(_rp_zeta_1_s),
         rp_r_0(_rp_r_0),
         rp_r_1(_rp_r_1),
-        rp_w_1(_rp_w_1)
+        rp_w_1(_rp_w_1),
+        rp_active_s(_rp_active_s)
     {}
 
     template <typename Tuple>
     __host__ __device__
     void operator()(Tuple t)
     {
-        int index = thrust::get<2>(t);
-        int N_s = index / N;
-        int N_n = index % N;
+        size_t index = thrust::get<2>(t);
+        size_t N_s = index / N;
+        size_t N_n = index % N;
+
+        if (!rp_active_s[N_s])
+            return;
 
         // return the transformed result
         ScalarType z1s = rp_zeta_1_s[N_s];
@@ -426,88 +424,77 @@ struct KERNEL_VCOPY : thrust::unary_function<int, ScalarType>
 // a struct from cusp::krylov::detail_m.
 namespace trans_m
 {
-// compute \zeta_1^\sigma, \beta_0^\sigma using iterators
-// uses detail_m::KERNEL_ZB
-template <typename InputIterator1, typename InputIterator2,
-         typename InputIterator3,
-         typename OutputIterator1, typename OutputIterator2,
-         typename ScalarType>
-void compute_zb_m(InputIterator1 z_0_s_b, InputIterator1 z_0_s_e,
-                  InputIterator2 z_m1_s_b, InputIterator3 sig_b,
-                  OutputIterator1 z_1_s_b, OutputIterator2 b_0_s_b,
-                  ScalarType beta_m1, ScalarType beta_0, ScalarType alpha_0)
-{
-    size_t N = z_0_s_e - z_0_s_b;
-    thrust::for_each(
-        thrust::make_zip_iterator(thrust::make_tuple(z_1_s_b,b_0_s_b,z_0_s_b,z_m1_s_b,sig_b)),
-        thrust::make_zip_iterator(thrust::make_tuple(z_1_s_b,b_0_s_b,z_0_s_b,z_m1_s_b,sig_b))+N,
-        cusp::krylov::bicg_detail::detail_m::KERNEL_ZB<ScalarType>(beta_m1,beta_0,alpha_0)
-    );
-}
-
-// compute \zeta_1^\sigma, \beta_0^\sigma using arrays
-template <typename Array1, typename Array2, typename Array3,
-         typename Array4, typename Array5, typename ScalarType>
-void compute_zb_m(const Array1& z_0_s, const Array2& z_m1_s,
-                  const Array3& sig, Array4& z_1_s, Array5& b_0_s,
-                  ScalarType beta_m1, ScalarType beta_0, ScalarType alpha_0)
+// compute \zeta_1^\sigma, \beta_0^\sigma, \alpha_0^\sigma, \chi_0^\sigma and
+// \rho_1^\sigma in a single pass over the shifts
+// uses detail_m::KERNEL_ZBCRA
+template <typename DerivedPolicy,
+         typename Array1, typename Array2, typename Array3,
+         typename Array4, typename Array5, typename Array6,
+         typename Array7, typename Array8, typename Array9, typename Array10,
+         typename ScalarType, typename NormType>
+void compute_zbcra_m(thrust::execution_policy<DerivedPolicy> &exec,
+                     const Array1& z_0_s, const Array2& z_m1_s, Array3& z_1_s,
+                     Array4& b_0_s, Array5& a_0_s,
+                     const Array6& rho_0_s, Array7& rho_1_s, Array8& chi_0_s,
+                     Array9& active_s, const Array10& sig,
+                     ScalarType beta_m1, ScalarType beta_0,
+                     ScalarType alpha_m1, ScalarType alpha_0, ScalarType chi_0,
+                     NormType residual_norm, NormType tolerance)
 {
     // sanity checks
     cusp::assert_same_dimensions(z_0_s,z_m1_s,z_1_s);
-    cusp::assert_same_dimensions(z_1_s,b_0_s,sig);
+    cusp::assert_same_dimensions(b_0_s,a_0_s,sig);
+    cusp::assert_same_dimensions(rho_0_s,rho_1_s,chi_0_s);
+    cusp::assert_same_dimensions(z_0_s,rho_0_s,active_s);
 
-    // compute
-    cusp::krylov::bicg_detail::trans_m::compute_zb_m(z_0_s.begin(),z_0_s.end(),
-                                        z_m1_s.begin(),sig.begin(),z_1_s.begin(),b_0_s.begin(),
-                                        beta_m1,beta_0,alpha_0);
+    size_t N = z_0_s.end() - z_0_s.begin();
 
+    // compute
+    thrust::for_each(exec,
+        thrust::make_zip_iterator(thrust::make_tuple(z_0_s.begin(),z_m1_s.begin(),z_1_s.begin(),b_0_s.begin(),a_0_s.begin(),
+                                                     rho_0_s.begin(),rho_1_s.begin(),chi_0_s.begin(),active_s.begin(),sig.begin())),
+        thrust::make_zip_iterator(thrust::make_tuple(z_0_s.begin(),z_m1_s.begin(),z_1_s.begin(),b_0_s.begin(),a_0_s.begin(),
+                                                     rho_0_s.begin(),rho_1_s.begin(),chi_0_s.begin(),active_s.begin(),sig.begin()))+N,
+        cusp::krylov::bicg_detail::detail_m::KERNEL_ZBCRA<ScalarType,NormType>(beta_m1,beta_0,alpha_m1,alpha_0,chi_0,
+                                                                               residual_norm,tolerance));
 }
 
-// compute \alpha_0^\sigma using iterators
-// uses detail_m::KERNEL_A
-template <typename InputIterator1, typename InputIterator2,
-         typename InputIterator3, typename OutputIterator,
-         typename ScalarType>
-void compute_a_m(InputIterator1 z_0_s_b, InputIterator1 z_0_s_e,
-                 InputIterator2 z_1_s_b, InputIterator3 beta_0_s_b,
-                 OutputIterator alpha_0_s_b,
-                 ScalarType beta_0, ScalarType alpha_0)
-{
-    size_t N = z_0_s_e - z_0_s_b;
-    thrust::for_each(
-        thrust::make_zip_iterator(thrust::make_tuple(alpha_0_s_b,z_0_s_b,z_1_s_b,beta_0_s_b)),
-        thrust::make_zip_iterator(thrust::make_tuple(alpha_0_s_b,z_0_s_b,z_1_s_b,beta_0_s_b))+N,
-        cusp::krylov::bicg_detail::detail_m::KERNEL_A<ScalarType>(beta_0,alpha_0));
-}
-
-// compute \alpha_0^\sigma using arrays
-template <typename Array1, typename Array2, typename Array3,
-         typename Array4, typename ScalarType>
-void compute_a_m(const Array1& z_0_s, const Array2& z_1_s,
-                 const Array3& beta_0_s, Array4& alpha_0_s,
-                 ScalarType beta_0, ScalarType alpha_0)
+// recycle \zeta_i^\sigma, \rho_i^\sigma of the active shifts
+// uses detail_m::KERNEL_RECYCLE
+template <typename DerivedPolicy,
+         typename Array1, typename Array2, typename Array3,
+         typename Array4, typename Array5, typename Array6>
+void recycle_m(thrust::execution_policy<DerivedPolicy> &exec,
+               Array1& z_m1_s, Array2& z_0_s, const Array3& z_1_s,
+               Array4& rho_0_s, const Array5& rho_1_s, const Array6& active_s)
 {
     // sanity checks
-    cusp::assert_same_dimensions(z_0_s,z_1_s);
-    cusp::assert_same_dimensions(z_0_s,alpha_0_s,beta_0_s);
+    cusp::assert_same_dimensions(z_m1_s,z_0_s,z_1_s);
+    cusp::assert_same_dimensions(rho_0_s,rho_1_s,active_s);
 
-    // compute
-    cusp::krylov::bicg_detail::trans_m::compute_a_m(z_0_s.begin(), z_0_s.end(),
-                                       z_1_s.begin(), beta_0_s.begin(), alpha_0_s.begin(),
-                                       beta_0, alpha_0);
+    size_t N = z_0_s.end() - z_0_s.begin();
+
+    // recycle
+    thrust::for_each(exec,
+        thrust::make_zip_iterator(thrust::make_tuple(z_m1_s.begin(),z_0_s.begin(),z_1_s.begin(),rho_0_s.begin(),rho_1_s.begin(),active_s.begin())),
+        thrust::make_zip_iterator(thrust::make_tuple(z_m1_s.begin(),z_0_s.begin(),z_1_s.begin(),rho_0_s.begin(),rho_1_s.begin(),active_s.begin()))+N,
+        cusp::krylov::bicg_detail::detail_m::KERNEL_RECYCLE());
 }
 
-// compute x^\sigma, s^\sigma
+// compute x^\sigma, s^\sigma of the active shifts
 // uses detail_m::KERNEL_XS
-template <typename Array1, typename Array2, typename Array3, typename Array4,
+template <typename DerivedPolicy,
+         typename Array1, typename Array2, typename Array3, typename Array4,
          typename Array5, typename Array6, typename Array7, typename Array8,
-         typename Array9, typename Array10, typename Array11,typename Array12>
-void compute_xs_m(const Array1& beta_0_s, const Array2& chi_0_s,
+         typename Array9, typename Array10, typename Array11,typename Array12,
+         typename Array13>
+void compute_xs_m(thrust::execution_policy<DerivedPolicy> &exec,
+                  const Array1& beta_0_s, const Array2& chi_0_s,
                   const Array3& rho_0_s, const Array4& zeta_0_s,
                   const Array5& alpha_1_s, const Array6& rho_1_s,
-                  const Array7& zeta_1_s,
-                  const Array8& r_0, Array9& r_1,
-                  const Array10& w_1, Array11& s_0_s, Array12& x)
+                  const Array7& zeta_1_s, const Array8& active_s,
+                  const Array9& r_0, Array10& r_1,
+                  const Array11& w_1, Array12& s_0_s, Array13& x)
 {
     // sanity check
     cusp::assert_same_dimensions(beta_0_s,chi_0_s,rho_0_s);
@@ -521,8 +508,8 @@ void compute_xs_m(const Array1& beta_0_s, const Array2& chi_0_s,
     size_t N_t = s_0_s.end()-s_0_s.begin();
     assert (N_t == N*N_s);
 
-    // counting iterators to pass to thrust::transform
-    thrust::counting_iterator<int> count(0);
+    // counting iterators to pass to thrust::for_each
+    thrust::counting_iterator<size_t> count(0);
 
     // get raw pointers for passing to kernels
     typedef typename Array1::value_type   ScalarType;
@@ -536,12 +523,13 @@ void compute_xs_m(const Array1& beta_0_s, const Array2& chi_0_s,
     const ScalarType *raw_ptr_r_0       = thrust::raw_pointer_cast(&r_0[0]);
     const ScalarType *raw_ptr_r_1       = thrust::raw_pointer_cast(&r_1[0]);
     const ScalarType *raw_ptr_w_1       = thrust::raw_pointer_cast(&w_1[0]);
+    const bool       *raw_ptr_active_s  = thrust::raw_pointer_cast(&active_s[0]);
 
     // compute x
-    thrust::for_each(
+    thrust::for_each(exec,
         thrust::make_zip_iterator(thrust::make_tuple(s_0_s.begin(),x.begin(),count)),
         thrust::make_zip_iterator(thrust::make_tuple(s_0_s.begin(),x.begin(),count))+N_t,
-        cusp::krylov::bicg_detail::detail_m::KERNEL_XS<ScalarType>(N, raw_ptr_beta_0_s, raw_ptr_chi_0_s, raw_ptr_rho_0_s, raw_ptr_zeta_0_s, raw_ptr_alpha_1_s, raw_ptr_rho_1_s, raw_ptr_zeta_1_s, raw_ptr_r_0, raw_ptr_r_1, raw_ptr_w_1));
+        cusp::krylov::bicg_detail::detail_m::KERNEL_XS<ScalarType>(N, raw_ptr_beta_0_s, raw_ptr_chi_0_s, raw_ptr_rho_0_s, raw_ptr_zeta_0_s, raw_ptr_alpha_1_s, raw_ptr_rho_1_s, raw_ptr_zeta_1_s, raw_ptr_r_0, raw_ptr_r_1, raw_ptr_w_1, raw_ptr_active_s));
 }
 
 template <typename InputIterator1, typename InputIterator2,
@@ -627,45 +615,6 @@ void compute_s_0_m(const Array1& r_1,
                                          As.begin(),s_0.begin(),alpha_1,chi_0);
 }
 
-template <typename InputIterator1,
-          typename InputIterator2,
-          typename OutputIterator1,
-          typename OutputIterator2,
-          typename ScalarType>
-void compute_chirho_m(InputIterator1 rho_0_s_b,
-                      InputIterator1 rho_0_s_e,
-                      InputIterator2 sigma_b,
-                      OutputIterator1 chi_0_s_b,
-                      OutputIterator2 rho_1_s_b,
-                      ScalarType chi_0)
-{
-    size_t N = rho_0_s_e-rho_0_s_b;
-    thrust::for_each(
-        thrust::make_zip_iterator(thrust::make_tuple(chi_0_s_b,rho_1_s_b,rho_0_s_b,sigma_b)),
-        thrust::make_zip_iterator(thrust::make_tuple(chi_0_s_b,rho_1_s_b,rho_0_s_b,sigma_b))+N,
-        cusp::krylov::bicg_detail::detail_m::KERNEL_CHIRHO<ScalarType>(chi_0));
-}
-
-template <typename Array1,
-          typename Array2,
-          typename Array3,
-          typename Array4,
-          typename ScalarType>
-void compute_chirho_m(const Array1& rho_0_s,
-                      const Array2& sigma,
-                            Array3& chi_0_s,
-                            Array4& rho_1_s,
-                            ScalarType chi_0)
-{
-    // sanity checks
-    cusp::assert_same_dimensions(sigma,rho_0_s,rho_1_s);
-    cusp::assert_same_dimensions(chi_0_s,rho_1_s);
-
-    // compute
-    cusp::krylov::bicg_detail::trans_m::compute_chirho_m(rho_0_s.begin(),rho_0_s.end(),
-                                            sigma.begin(),chi_0_s.begin(),rho_1_s.begin(),chi_0);
-}
-
 // multiple copy of array to another array
 // this is just a vectorization of blas::copy
 // uses detail_m::KERNEL_VCOPY
@@ -700,19 +649,20 @@ template <typename DerivedPolicy,
           typename VectorType2,
           typename VectorType3,
           typename Monitor>
-void bicgstab_m(thrust::execution_policy<DerivedPolicy> &exec,
-                LinearOperator& A,
-                VectorType1& x,
-                VectorType2& b,
-                VectorType3& sigma,
-                Monitor& monitor)
+void bicgstab_m_solve(thrust::execution_policy<DerivedPolicy> &exec,
+                      LinearOperator& A,
+                      VectorType1& x,
+                      VectorType2& b,
+                      VectorType3& sigma,
+                      Monitor& monitor)
 {
     //
     // This bit is initialization of the solver.
     //
 
     // shorthand for typenames
-    typedef typename LinearOperator::value_type   ValueType;
+    typedef typename LinearOperator::value_type        ValueType;
+    typedef typename cusp::norm_type<ValueType>::type  NormType;
 
     // sanity checking
     const size_t N = A.num_rows;
@@ -750,6 +700,10 @@ void bicgstab_m(thrust::execution_policy<DerivedPolicy> &exec,
     cusp::detail::temporary_array<ValueType, DerivedPolicy> rho_1_s(exec, N_s);
     cusp::detail::temporary_array<ValueType, DerivedPolicy> chi_0_s(exec, N_s);
 
+    // shifts that have not converged yet
+    cusp::detail::temporary_array<bool, DerivedPolicy> active_s(exec, N_s, true);
+    const NormType tolerance = monitor.tolerance();
+
     // stores parameters used in the iteration for the undeformed system
     ValueType beta_m1, beta_0(ValueType(1));
     ValueType alpha_0(ValueType(0));
@@ -783,15 +737,14 @@ void bicgstab_m(thrust::execution_policy<DerivedPolicy> &exec,
     //
     while (!monitor.finished(r_0))
     {
+        // norm of the unshifted residual, the shifted residuals are multiples of it
+        const NormType residual_norm = cusp::blas::nrm2(exec, r_0);
+
         // recycle iterates
         beta_m1 = beta_0;
         beta_0 = ValueType(-1.0)/phi_0;
         delta_0 = delta_1;
 
-        // compute \zeta_1^\sigma, \beta_0^\sigma
-        cusp::krylov::bicg_detail::trans_m::compute_zb_m(z_0_s, z_m1_s, sigma, z_1_s, beta_0_s,
-                                            beta_m1, beta_0, alpha_0);
-
         // call w_1 kernel
         cusp::krylov::bicg_detail::trans_m::compute_w_1_m(r_0, As, w_1, beta_0);
 
@@ -808,6 +761,7 @@ void bicgstab_m(thrust::execution_policy<DerivedPolicy> &exec,
         delta_1 = cusp::blas::dotc(w_0,r_1);
 
         // compute new alpha
+        ValueType alpha_m1 = alpha_0;
         alpha_0 = -beta_0*delta_1/delta_0/chi_0;
 
         // compute s_0
@@ -819,33 +773,49 @@ void bicgstab_m(thrust::execution_policy<DerivedPolicy> &exec,
         // compute new phi
         phi_0 = cusp::blas::dotc(w_0,As)/delta_1;
 
-        // compute shifted rho, chi
-        cusp::krylov::bicg_detail::trans_m::compute_chirho_m(rho_0_s,sigma,chi_0_s,rho_1_s,
-                                                chi_0);
-
-        // calculate \alpha_0^\sigma
-        cusp::krylov::bicg_detail::trans_m::compute_a_m(z_0_s, z_1_s, beta_0_s,
-                                           alpha_0_s, beta_0, alpha_0);
+        // compute the shifted coefficients, freezing the shifts that have
+        // converged
+        cusp::krylov::bicg_detail::trans_m::compute_zbcra_m(exec, z_0_s, z_m1_s, z_1_s, beta_0_s, alpha_0_s,
+                                                            rho_0_s, rho_1_s, chi_0_s, active_s, sigma,
+                                                            beta_m1, beta_0, alpha_m1, alpha_0, chi_0,
+                                                            residual_norm, tolerance);
 
         // compute the new solution and s_0^sigma
-        cusp::krylov::bicg_detail::trans_m::compute_xs_m(beta_0_s, chi_0_s, rho_0_s, z_0_s,
-                                            alpha_0_s, rho_1_s, z_1_s, r_0, r_1, w_1, s_0_s, x);
+        cusp::krylov::bicg_detail::trans_m::compute_xs_m(exec, beta_0_s, chi_0_s, rho_0_s, z_0_s,
+                                            alpha_0_s, rho_1_s, z_1_s, active_s, r_0, r_1, w_1, s_0_s, x);
 
         // recycle r_i
         cusp::blas::copy(r_1,r_0);
 
-        // recycle \zeta_i^\sigma
-        cusp::blas::copy(z_0_s,z_m1_s);
-        cusp::blas::copy(z_1_s,z_0_s);
-
-        // recycle \rho_i^\sigma
-        cusp::blas::copy(rho_1_s,rho_0_s);
+        // recycle \zeta_i^\sigma, \rho_i^\sigma
+        cusp::krylov::bicg_detail::trans_m::recycle_m(exec, z_m1_s, z_0_s, z_1_s, rho_0_s, rho_1_s, active_s);
 
         ++monitor;
 
     }// finished iteration
 
-} // end bicgstab_m
+} // end bicgstab_m_solve
+
+template <typename DerivedPolicy,
+          typename LinearOperator,
+          typename VectorType1,
+          typename VectorType2,
+          typename VectorType3,
+          typename Monitor>
+void bicgstab_m(thrust::execution_policy<DerivedPolicy> &exec,
+                LinearOperator& A,
+                VectorType1& x,
+                VectorType2& b,
+                VectorType3& sigma,
+                Monitor& monitor)
+{
+    const size_t N   = A.num_rows;
+    const size_t N_s = sigma.end()-sigma.begin();
+
+    bicgstab_m_solve(exec, A,
+                     cusp::krylov::multi_mass_detail::shifted_solutions(x, N, N_s, typename VectorType1::format()),
+                     b, sigma, monitor);
+}
 
 template <typename DerivedPolicy,
           typename LinearOperator,
@@ -0,0 +1,370 @@
+/*
+ *  Copyright 2008-2014 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include <cusp/array1d.h>
+#include <cusp/array2d.h>
+#include <cusp/complex.h>
+#include <cusp/exception.h>
+#include <cusp/functional.h>
+#include <cusp/linear_operator.h>
+#include <cusp/monitor.h>
+#include <cusp/multiply.h>
+
+#include <cusp/blas/blas.h>
+
+#include <cusp/detail/lu.h>
+#include <cusp/detail/temporary_array.h>
+
+#include <thrust/for_each.h>
+#include <thrust/reduce.h>
+#include <thrust/tuple.h>
+#include <thrust/iterator/counting_iterator.h>
+#include <thrust/iterator/discard_iterator.h>
+#include <thrust/iterator/transform_iterator.h>
+#include <thrust/iterator/zip_iterator.h>
+
+namespace cusp
+{
+namespace krylov
+{
+namespace block_cg_detail
+{
+
+// All blocks are stored column-major with N rows and s columns, so column j
+// of a block starts at offset j * N of its values.
+
+// G(i,j) <- <P(:,i), Q(:,j)>, one term per entry of [0, s*s*N)
+template <typename ValueType>
+struct gram_functor
+{
+    const ValueType* P;
+    const ValueType* Q;
+    size_t N;
+    size_t s;
+
+    gram_functor(const ValueType* P, const ValueType* Q, size_t N, size_t s)
+        : P(P), Q(Q), N(N), s(s) {}
+
+    __host__ __device__
+    ValueType operator()(const size_t n) const
+    {
+        const size_t pair = n / N;
+        const size_t k    = n % N;
+
+        return cusp::conj(P[(pair / s) * N + k]) * Q[(pair % s) * N + k];
+    }
+};
+
+// Z(k,j) <- Y(k,j) + sum_i W(k,i) * C(i,j)
+template <typename ValueType>
+struct block_update_functor
+{
+    const ValueType* W;
+    const ValueType* C;
+    size_t N;
+    size_t s;
+
+    block_update_functor(const ValueType* W, const ValueType* C, size_t N, size_t s)
+        : W(W), C(C), N(N), s(s) {}
+
+    template <typename Tuple>
+    __host__ __device__
+    void operator()(Tuple t) const
+    {
+        const size_t n = thrust::get<2>(t);
+        const size_t k = n % N;
+        const size_t j = n / N;
+
+        ValueType sum = thrust::get<0>(t);
+
+        for (size_t i = 0; i < s; i++)
+            sum += W[i * N + k] * C[i * s + j];
+
+        thrust::get<1>(t) = sum;
+    }
+};
+
+// G <- P^H Q on the host
+template <typename DerivedPolicy, typename Array2d1, typename Array2d2, typename Array2d3>
+void gram(thrust::execution_policy<DerivedPolicy>& exec,
+          const Array2d1& P,
+          const Array2d2& Q,
+                Array2d3& G)
+{
+    typedef typename Array2d1::value_type ValueType;
+
+    const size_t N = P.num_rows;
+    const size_t s = P.num_cols;
+
+    cusp::detail::temporary_array<ValueType, DerivedPolicy> g(exec, s * s);
+
+    thrust::reduce_by_key(exec,
+                          thrust::make_transform_iterator(thrust::counting_iterator<size_t>(0), cusp::divide_value<size_t>(N)),
+                          thrust::make_transform_iterator(thrust::counting_iterator<size_t>(s * s * N), cusp::divide_value<size_t>(N)),
+                          thrust::make_transform_iterator(thrust::counting_iterator<size_t>(0),
+                                                          gram_functor<ValueType>(thrust::raw_pointer_cast(&P.values[0]),
+                                                                                  thrust::raw_pointer_cast(&Q.values[0]), N, s)),
+                          thrust::make_discard_iterator(),
+                          g.begin());
+
+    cusp::blas::allreduce(exec, g);
+
+    cusp::array1d<ValueType, cusp::host_memory> g_host(g.begin(), g.end());
+
+    for (size_t i = 0; i < s; i++)
+        for (size_t j = 0; j < s; j++)
+            G(i,j) = g_host[i * s + j];
+}
+
+// Z <- Y + W C with a small host matrix C
+template <typename DerivedPolicy, typename Array2d1, typename Array2d2, typename Array2d3, typename Array2d4>
+void block_update(thrust::execution_policy<DerivedPolicy>& exec,
+                  const Array2d1& Y,
+                  const Array2d2& W,
+                  const Array2d3& C,
+                        Array2d4& Z)
+{
+    typedef typename Array2d1::value_type ValueType;
+
+    const size_t N = W.num_rows;
+    const size_t s = W.num_cols;
+
+    cusp::array1d<ValueType, cusp::host_memory> c_host(s * s);
+
+    for (size_t i = 0; i < s; i++)
+        for (size_t j = 0; j < s; j++)
+            c_host[i * s + j] = C(i,j);
+
+    cusp::array1d<ValueType, typename Array2d2::memory_space> c(c_host);
+
+    thrust::for_each(exec,
+                     thrust::make_zip_iterator(thrust::make_tuple(Y.values.begin(), Z.values.begin(), thrust::counting_iterator<size_t>(0))),
+                     thrust::make_zip_iterator(thrust::make_tuple(Y.values.begin(), Z.values.begin(), thrust::counting_iterator<size_t>(0))) + N * s,
+                     block_update_functor<ValueType>(thrust::raw_pointer_cast(&W.values[0]),
+                                                     thrust::raw_pointer_cast(&c[0]), N, s));
+}
+
+// C <- G^{-1} H on the host
+template <typename Array2d1, typename Array2d2, typename Array2d3>
+void small_solve(const Array2d1& G, const Array2d2& H, Array2d3& C)
+{
+    typedef typename Array2d1::value_type ValueType;
+
+    const size_t s = G.num_rows;
+
+    cusp::array2d<ValueType, cusp::host_memory> LU(G);
+    cusp::array1d<int, cusp::host_memory> pivot(s);
+    cusp::array1d<ValueType, cusp::host_memory> h(s);
+    cusp::array1d<ValueType, cusp::host_memory> c(s);
+
+    cusp::detail::lu_factor(LU, pivot);
+
+    for (size_t j = 0; j < s; j++)
+    {
+        for (size_t i = 0; i < s; i++)
+            h[i] = H(i,j);
+
+        if (cusp::detail::lu_solve(LU, pivot, h, c) != 0)
+            throw cusp::runtime_exception("block_cg: singular projection, right-hand sides are linearly dependent");
+
+        for (size_t i = 0; i < s; i++)
+            C(i,j) = c[i];
+    }
+}
+
+template <typename DerivedPolicy, typename Preconditioner, typename Array2d1, typename Array2d2>
+void precondition(thrust::execution_policy<DerivedPolicy>& exec,
+                  Preconditioner& M,
+                  const Array2d1& R,
+                        Array2d2& Z)
+{
+    cusp::multiply(exec, M, R, Z);
+}
+
+template <typename DerivedPolicy, typename ValueType, typename MemorySpace, typename IndexType, typename Array2d1, typename Array2d2>
+void precondition(thrust::execution_policy<DerivedPolicy>& exec,
+                  cusp::identity_operator<ValueType,MemorySpace,IndexType>& M,
+                  const Array2d1& R,
+                        Array2d2& Z)
+{
+    cusp::blas::copy(exec, R.values, Z.values);
+}
+
+template <typename DerivedPolicy,
+          typename LinearOperator,
+          typename Array2d1,
+          typename Array2d2,
+          typename Monitor,
+          typename Preconditioner>
+void block_cg(thrust::execution_policy<DerivedPolicy> &exec,
+              const LinearOperator& A,
+                    Array2d1& X,
+              const Array2d2& B,
+                    Monitor& monitor,
+                    Preconditioner& M)
+{
+    typedef typename LinearOperator::value_type                         ValueType;
+    typedef typename cusp::minimum_space<
+              typename LinearOperator::memory_space,
+              typename Array2d1::memory_space>::type                    MemorySpace;
+    typedef cusp::array2d<ValueType, MemorySpace, cusp::column_major>  Block;
+    typedef cusp::array2d<ValueType, cusp::host_memory>                 SmallMatrix;
+
+    assert(A.num_rows == A.num_cols);        // sanity check
+
+    const size_t N = A.num_rows;
+    const size_t s = B.num_cols;
+
+    // allocate workspace
+    Block Xb(X);
+    Block Bb(B);
+    Block R(N, s);
+    Block Z(N, s);
+    Block P(N, s);
+    Block Q(N, s);
+    Block T(N, s);
+
+    SmallMatrix PQ(s, s);
+    SmallMatrix RZ(s, s);
+    SmallMatrix RZ_old(s, s);
+    SmallMatrix alpha(s, s);
+    SmallMatrix beta(s, s);
+
+    // R <- B - A*X
+    cusp::multiply(exec, A, Xb, R);
+    cusp::blas::axpby(exec, Bb.values, R.values, R.values, ValueType(1), ValueType(-1));
+
+    // Z <- M*R
+    precondition(exec, M, R, Z);
+
+    // P <- Z
+    cusp::blas::copy(exec, Z.values, P.values);
+
+    // RZ <- R^H Z
+    gram(exec, R, Z, RZ);
+
+    while (!monitor.finished(exec, R.values))
+    {
+        // Q <- A*P
+        cusp::multiply(exec, A, P, Q);
+
+        // alpha <- (P^H Q)^{-1} (R^H Z)
+        gram(exec, P, Q, PQ);
+        small_solve(PQ, RZ, alpha);
+
+        // X <- X + P alpha
+        block_update(exec, Xb, P, alpha, Xb);
+
+        // R <- R - Q alpha
+        for (size_t i = 0; i < s; i++)
+            for (size_t j = 0; j < s; j++)
+                alpha(i,j) = -alpha(i,j);
+
+        block_update(exec, R, Q, alpha, R);
+
+        // Z <- M*R
+        precondition(exec, M, R, Z);
+
+        // beta <- (R^H Z)_old^{-1} (R^H Z)
+        RZ_old.swap(RZ);
+        gram(exec, R, Z, RZ);
+        small_solve(RZ_old, RZ, beta);
+
+        // P <- Z + P beta
+        block_update(exec, Z, P, beta, T);
+        P.swap(T);
+
+        ++monitor;
+    }
+
+    X = Xb;
+}
+
+} // end block_cg_detail namespace
+
+template <typename DerivedPolicy,
+          typename LinearOperator,
+          typename Array2d1,
+          typename Array2d2,
+          typename Monitor,
+          typename Preconditioner>
+void block_cg(const thrust::detail::execution_policy_base<DerivedPolicy> &exec,
+              const LinearOperator& A,
+                    Array2d1& X,
+              const Array2d2& B,
+                    Monitor& monitor,
+                    Preconditioner& M)
+{
+    using cusp::krylov::block_cg_detail::block_cg;
+
+    return block_cg(thrust::detail::derived_cast(thrust::detail::strip_const(exec)), A, X, B, monitor, M);
+}
+
+template <typename LinearOperator,
+          typename Array2d1,
+          typename Array2d2,
+          typename Monitor,
+          typename Preconditioner>
+void block_cg(const LinearOperator& A,
+                    Array2d1& X,
+              const Array2d2& B,
+                    Monitor& monitor,
+                    Preconditioner& M)
+{
+    using thrust::system::detail::generic::select_system;
+
+    typedef typename LinearOperator::memory_space System1;
+    typedef typename Array2d2::memory_space       System2;
+
+    System1 system1;
+    System2 system2;
+
+    return cusp::krylov::block_cg(select_system(system1,system2), A, X, B, monitor, M);
+}
+
+template <typename LinearOperator,
+          typename Array2d1,
+          typename Array2d2,
+          typename Monitor>
+void block_cg(const LinearOperator& A,
+                    Array2d1& X,
+              const Array2d2& B,
+                    Monitor& monitor)
+{
+    typedef typename LinearOperator::value_type   ValueType;
+    typedef typename LinearOperator::memory_space MemorySpace;
+
+    cusp::identity_operator<ValueType,MemorySpace> M(A.num_rows, A.num_cols);
+
+    return cusp::krylov::block_cg(A, X, B, monitor, M);
+}
+
+template <typename LinearOperator,
+          typename Array2d1,
+          typename Array2d2>
+void block_cg(const LinearOperator& A,
+                    Array2d1& X,
+              const Array2d2& B)
+{
+    typedef typename LinearOperator::value_type   ValueType;
+
+    cusp::monitor<ValueType> monitor(B.values);
+
+    return cusp::krylov::block_cg(A, X, B, monitor);
+}
+
+} // end namespace krylov
+} // end namespace cusp
@@ -37,28 +37,23 @@ template <typename DerivedPolicy,
           typename VectorType1,
           typename VectorType2,
           typename Monitor,
-          typename Preconditioner>
+          typename Preconditioner,
+          typename ArrayType>
 void cg(thrust::execution_policy<DerivedPolicy> &exec,
         const LinearOperator& A,
               VectorType1& x,
         const VectorType2& b,
               Monitor& monitor,
-              Preconditioner& M)
+              Preconditioner& M,
+              ArrayType& y,
+              ArrayType& z,
+              ArrayType& r,
+              ArrayType& p)
 {
     typedef typename LinearOperator::value_type           ValueType;
 
     assert(A.num_rows == A.num_cols);        // sanity check
 
-    const size_t N = A.num_rows;
-
-    // allocate workspace
-    cusp::detail::temporary_array<ValueType, DerivedPolicy> y(exec, N);
-    cusp::detail::temporary_array<ValueType, DerivedPolicy> z(exec, N);
-    cusp::detail::temporary_array<ValueType, DerivedPolicy> r(exec, N);
-    cusp::detail::temporary_array<ValueType, DerivedPolicy> p(exec, N);
-
-    assert(A.num_rows == A.num_cols);        // sanity check
-
     // y <- Ax
     cusp::multiply(exec, A, x, y);
 
@@ -106,6 +101,32 @@ void cg(thrust::execution_policy<DerivedPolicy> &exec,
     }
 }
 
+template <typename DerivedPolicy,
+          typename LinearOperator,
+          typename VectorType1,
+          typename VectorType2,
+          typename Monitor,
+          typename Preconditioner>
+void cg(thrust::execution_policy<DerivedPolicy> &exec,
+        const LinearOperator& A,
+              VectorType1& x,
+        const VectorType2& b,
+              Monitor& monitor,
+              Preconditioner& M)
+{
+    typedef typename LinearOperator::value_type           ValueType;
+
+    const size_t N = A.num_rows;
+
+    // allocate workspace
+    cusp::detail::temporary_array<ValueType, DerivedPolicy> y(exec, N);
+    cusp::detail::temporary_array<ValueType, DerivedPolicy> z(exec, N);
+    cusp::detail::temporary_array<ValueType, DerivedPolicy> r(exec, N);
+    cusp::detail::temporary_array<ValueType, DerivedPolicy> p(exec, N);
+
+    cg(exec, A, x, b, monitor, M, y, z, r, p);
+}
+
 } // end cg_detail namespace
 
 template <typename DerivedPolicy,
@@ -179,6 +200,106 @@ void cg(const LinearOperator& A,
     return cusp::krylov::cg(A, x, b, monitor);
 }
 
+///////////////
+// cg_solver //
+///////////////
+
+template <typename ValueType, typename MemorySpace>
+cg_solver<ValueType,MemorySpace>
+::cg_solver(const size_t N)
+    : y(N), z(N), r(N), p(N) {}
+
+template <typename ValueType, typename MemorySpace>
+void
+cg_solver<ValueType,MemorySpace>
+::resize(const size_t N)
+{
+    y.resize(N);
+    z.resize(N);
+    r.resize(N);
+    p.resize(N);
+}
+
+template <typename ValueType, typename MemorySpace>
+template <typename DerivedPolicy,
+          typename LinearOperator,
+          typename VectorType1,
+          typename VectorType2,
+          typename Monitor,
+          typename Preconditioner>
+void
+cg_solver<ValueType,MemorySpace>
+::solve(const thrust::detail::execution_policy_base<DerivedPolicy> &exec,
+        const LinearOperator& A,
+              VectorType1& x,
+        const VectorType2& b,
+              Monitor& monitor,
+              Preconditioner& M)
+{
+    using cusp::krylov::cg_detail::cg;
+
+    resize(A.num_rows);
+
+    cg(thrust::detail::derived_cast(thrust::detail::strip_const(exec)), A, x, b, monitor, M, y, z, r, p);
+}
+
+template <typename ValueType, typename MemorySpace>
+template <typename LinearOperator,
+          typename VectorType1,
+          typename VectorType2,
+          typename Monitor,
+          typename Preconditioner>
+void
+cg_solver<ValueType,MemorySpace>
+::solve(const LinearOperator& A,
+              VectorType1& x,
+        const VectorType2& b,
+              Monitor& monitor,
+              Preconditioner& M)
+{
+    using thrust::system::detail::generic::select_system;
+
+    typedef typename LinearOperator::memory_space System1;
+    typedef typename VectorType2::memory_space    System2;
+
+    System1 system1;
+    System2 system2;
+
+    solve(select_system(system1,system2), A, x, b, monitor, M);
+}
+
+template <typename ValueType, typename MemorySpace>
+template <typename LinearOperator,
+          typename VectorType1,
+          typename VectorType2,
+          typename Monitor>
+void
+cg_solver<ValueType,MemorySpace>
+::solve(const LinearOperator& A,
+              VectorType1& x,
+        const VectorType2& b,
+              Monitor& monitor)
+{
+    cusp::identity_operator<ValueType,MemorySpace> M(A.num_rows, A.num_cols);
+
+    solve(A, x, b, monitor, M);
+}
+
+template <typename ValueType, typename MemorySpace>
+template <typename LinearOperator,
+          typename VectorType1,
+          typename VectorType2>
+void
+cg_solver<ValueType,MemorySpace>
+::solve(const LinearOperator& A,
+              VectorType1& x,
+        const VectorType2& b)
+{
+    cusp::monitor<ValueType> monitor(b);
+
+    solve(A, x, b, monitor);
+}
+
 } // end namespace krylov
 } // end namespace cusp
 
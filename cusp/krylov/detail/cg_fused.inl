@@ -0,0 +1,230 @@
+/*
+ *  Copyright 2008-2014 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include <cusp/array1d.h>
+#include <cusp/linear_operator.h>
+#include <cusp/multiply.h>
+#include <cusp/monitor.h>
+
+#include <cusp/detail/temporary_array.h>
+
+#include <cusp/blas/blas.h>
+
+namespace cusp
+{
+namespace krylov
+{
+namespace cg_detail
+{
+
+template <typename DerivedPolicy,
+          typename LinearOperator,
+          typename VectorType1,
+          typename VectorType2,
+          typename Monitor,
+          typename Preconditioner>
+void cg_fused(thrust::execution_policy<DerivedPolicy> &exec,
+              const LinearOperator& A,
+                    VectorType1& x,
+              const VectorType2& b,
+                    Monitor& monitor,
+                    Preconditioner& M)
+{
+    typedef typename LinearOperator::value_type           ValueType;
+
+    assert(A.num_rows == A.num_cols);        // sanity check
+
+    const size_t N = A.num_rows;
+
+    // allocate workspace
+    cusp::detail::temporary_array<ValueType, DerivedPolicy> y(exec, N);
+    cusp::detail::temporary_array<ValueType, DerivedPolicy> z(exec, N);
+    cusp::detail::temporary_array<ValueType, DerivedPolicy> r(exec, N);
+    cusp::detail::temporary_array<ValueType, DerivedPolicy> p(exec, N);
+
+    // y <- Ax
+    cusp::multiply(exec, A, x, y);
+
+    // r <- b - A*x
+    cusp::blas::axpby(exec, b, y, r, ValueType(1), ValueType(-1));
+
+    // z <- M*r
+    cusp::multiply(exec, M, r, z);
+
+    // p <- z
+    cusp::blas::copy(exec, z, p);
+
+    // rz = <r^H, z>
+    ValueType rz = cusp::blas::dotc(exec, r, z);
+
+    while (!monitor.finished(exec, r))
+    {
+        // y <- Ap and alpha <- <r,z>/<y,p>
+        ValueType alpha = rz / cusp::multiply_dotc(exec, A, p, y);
+
+        // x <- x + alpha * p and r <- r - alpha * y
+        cusp::blas::axpy_axpy(exec, p, x, alpha, y, r, -alpha);
+
+        // z <- M*r
+        cusp::multiply(exec, M, r, z);
+
+        ValueType rz_old = rz;
+
+        // rz = <r^H, z>
+        rz = cusp::blas::dotc(exec, r, z);
+
+        // beta <- <r_{i+1},r_{i+1}>/<r,r>
+        ValueType beta = rz / rz_old;
+
+        // p <- z + beta*p
+        cusp::blas::axpby(exec, z, p, p, ValueType(1), beta);
+
+        ++monitor;
+    }
+}
+
+// without preconditioning z = r, hence <r,r> is computed with the update of r
+template <typename DerivedPolicy,
+          typename LinearOperator,
+          typename VectorType1,
+          typename VectorType2,
+          typename Monitor,
+          typename ValueType,
+          typename MemorySpace,
+          typename IndexType>
+void cg_fused(thrust::execution_policy<DerivedPolicy> &exec,
+              const LinearOperator& A,
+                    VectorType1& x,
+              const VectorType2& b,
+                    Monitor& monitor,
+                    cusp::identity_operator<ValueType,MemorySpace,IndexType>& M)
+{
+    assert(A.num_rows == A.num_cols);        // sanity check
+
+    const size_t N = A.num_rows;
+
+    // allocate workspace
+    cusp::detail::temporary_array<ValueType, DerivedPolicy> y(exec, N);
+    cusp::detail::temporary_array<ValueType, DerivedPolicy> r(exec, N);
+    cusp::detail::temporary_array<ValueType, DerivedPolicy> p(exec, N);
+
+    // y <- Ax
+    cusp::multiply(exec, A, x, y);
+
+    // r <- b - A*x
+    cusp::blas::axpby(exec, b, y, r, ValueType(1), ValueType(-1));
+
+    // p <- r
+    cusp::blas::copy(exec, r, p);
+
+    // rr = <r^H, r>
+    ValueType rr = cusp::blas::dotc(exec, r, r);
+
+    while (!monitor.finished(exec, r))
+    {
+        // y <- Ap and alpha <- <r,r>/<y,p>
+        ValueType alpha = rr / cusp::multiply_dotc(exec, A, p, y);
+
+        ValueType rr_old = rr;
+
+        // x <- x + alpha * p, r <- r - alpha * y and rr = <r^H, r>
+        rr = cusp::blas::axpy_axpy_dotc(exec, p, x, alpha, y, r, -alpha);
+
+        // beta <- <r_{i+1},r_{i+1}>/<r,r>
+        ValueType beta = rr / rr_old;
+
+        // p <- r + beta*p
+        cusp::blas::axpby(exec, r, p, p, ValueType(1), beta);
+
+        ++monitor;
+    }
+}
+
+} // end cg_detail namespace
+
+template <typename DerivedPolicy,
+          typename LinearOperator,
+          typename VectorType1,
+          typename VectorType2,
+          typename Monitor,
+          typename Preconditioner>
+void cg_fused(const thrust::detail::execution_policy_base<DerivedPolicy> &exec,
+              const LinearOperator& A,
+                    VectorType1& x,
+              const VectorType2& b,
+                    Monitor& monitor,
+                    Preconditioner& M)
+{
+    using cusp::krylov::cg_detail::cg_fused;
+
+    return cg_fused(thrust::detail::derived_cast(thrust::detail::strip_const(exec)), A, x, b, monitor, M);
+}
+
+template <typename LinearOperator,
+          typename VectorType1,
+          typename VectorType2,
+          typename Monitor,
+          typename Preconditioner>
+void cg_fused(const LinearOperator& A,
+                    VectorType1& x,
+              const VectorType2& b,
+                    Monitor& monitor,
+                    Preconditioner& M)
+{
+    using thrust::system::detail::generic::select_system;
+
+    typedef typename LinearOperator::memory_space System1;
+    typedef typename VectorType2::memory_space    System2;
+
+    System1 system1;
+    System2 system2;
+
+    return cusp::krylov::cg_fused(select_system(system1,system2), A, x, b, monitor, M);
+}
+
+template <typename LinearOperator,
+          typename VectorType1,
+          typename VectorType2,
+          typename Monitor>
+void cg_fused(const LinearOperator& A,
+                    VectorType1& x,
+              const VectorType2& b,
+                    Monitor& monitor)
+{
+    typedef typename LinearOperator::value_type   ValueType;
+    typedef typename LinearOperator::memory_space MemorySpace;
+
+    cusp::identity_operator<ValueType,MemorySpace> M(A.num_rows, A.num_cols);
+
+    return cusp::krylov::cg_fused(A, x, b, monitor, M);
+}
+
+template <typename LinearOperator,
+          typename VectorType1,
+          typename VectorType2>
+void cg_fused(const LinearOperator& A,
+                    VectorType1& x,
+              const VectorType2& b)
+{
+    typedef typename LinearOperator::value_type   ValueType;
+
+    cusp::monitor<ValueType> monitor(b);
+
+    return cusp::krylov::cg_fused(A, x, b, monitor);
+}
+
+} // end namespace krylov
+} // end namespace cusp
@@ -0,0 +1,407 @@
+/*
+ *  Copyright 2008-2014 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include <cusp/array1d.h>
+#include <cusp/linear_operator.h>
+#include <cusp/multiply.h>
+#include <cusp/monitor.h>
+
+#include <cusp/detail/temporary_array.h>
+
+#include <cusp/blas/blas.h>
+#include <cusp/krylov/cg.h>
+
+#if THRUST_DEVICE_SYSTEM == THRUST_DEVICE_SYSTEM_CUDA
+#include <cusp/system/cuda/stream_graph.h>
+#include <cusp/system/cuda/detail/stream_graph_blas.h>
+#endif
+
+namespace cusp
+{
+namespace krylov
+{
+namespace cg_detail
+{
+
+// graphs are specific to the CUDA backend, elsewhere the iteration is cg
+template <typename DerivedPolicy,
+          typename LinearOperator,
+          typename VectorType1,
+          typename VectorType2,
+          typename Monitor,
+          typename Preconditioner>
+void cg_graph(thrust::execution_policy<DerivedPolicy> &exec,
+              const LinearOperator& A,
+                    VectorType1& x,
+              const VectorType2& b,
+                    Monitor& monitor,
+                    Preconditioner& M)
+{
+    cg(exec, A, x, b, monitor, M);
+}
+
+#if THRUST_DEVICE_SYSTEM == THRUST_DEVICE_SYSTEM_CUDA
+
+// positions of the recurrence scalars in device memory
+enum { CG_RZ = 0, CG_ALPHA = 1, CG_BETA = 2, CG_NUM_SCALARS = 3 };
+
+template <typename ValueType>
+struct cg_store_rz
+{
+    __host__ __device__
+    void operator()(ValueType * s, const ValueType * dots) const
+    {
+        s[CG_RZ] = dots[0];
+    }
+};
+
+// alpha <- <r,z>/<y,p>, a vanishing <y,p> stops the update
+template <typename ValueType>
+struct cg_alpha
+{
+    __host__ __device__
+    void operator()(ValueType * s, const ValueType * dots) const
+    {
+        s[CG_ALPHA] = dots[0] == ValueType(0) ? ValueType(0) : s[CG_RZ] / dots[0];
+    }
+};
+
+// beta <- <r_{i+1},z_{i+1}>/<r,z>
+template <typename ValueType>
+struct cg_beta
+{
+    __host__ __device__
+    void operator()(ValueType * s, const ValueType * dots) const
+    {
+        s[CG_BETA] = s[CG_RZ] == ValueType(0) ? ValueType(0) : dots[0] / s[CG_RZ];
+        s[CG_RZ]   = dots[0];
+    }
+};
+
+// x <- x + alpha * p and r <- r - alpha * y
+template <typename ValueType>
+struct cg_update_xr
+{
+    ValueType * x;
+    ValueType * r;
+    const ValueType * p;
+    const ValueType * y;
+    const ValueType * s;
+
+    cg_update_xr(ValueType * x, ValueType * r, const ValueType * p, const ValueType * y, const ValueType * s)
+      : x(x), r(r), p(p), y(y), s(s) {}
+
+    __device__
+    void operator()(const int i) const
+    {
+        const ValueType alpha = s[CG_ALPHA];
+
+        x[i] += alpha * p[i];
+        r[i] -= alpha * y[i];
+    }
+};
+
+// p <- z + beta * p
+template <typename ValueType>
+struct cg_update_p
+{
+    ValueType * p;
+    const ValueType * z;
+    const ValueType * s;
+
+    cg_update_p(ValueType * p, const ValueType * z, const ValueType * s)
+      : p(p), z(z), s(s) {}
+
+    __device__
+    void operator()(const int i) const
+    {
+        p[i] = z[i] + s[CG_BETA] * p[i];
+    }
+};
+
+// one CG iteration, or the parts of it selected by steps, issued on the
+// stream of the policy it is called with
+template <typename LinearOperator,
+          typename VectorType,
+          typename Preconditioner,
+          typename ArrayType>
+struct cg_graph_iteration
+{
+    typedef typename LinearOperator::value_type ValueType;
+
+    enum { APPLY_A = 1, APPLY_M = 2, UPDATE_P = 4, ALL_STEPS = 7 };
+
+    const LinearOperator& A;
+    Preconditioner& M;
+    ArrayType& y;
+    ArrayType& z;
+    ArrayType& r;
+    ArrayType& p;
+
+    const size_t N;
+    const bool identity;
+
+    ValueType * x_ptr;
+    ValueType * y_ptr;
+    ValueType * z_ptr;
+    ValueType * r_ptr;
+    ValueType * p_ptr;
+    ValueType * s_ptr;
+    ValueType * partials_ptr;
+
+    int steps;
+
+    cg_graph_iteration(const LinearOperator& A, VectorType& x, Preconditioner& M,
+                       ArrayType& y, ArrayType& z, ArrayType& r, ArrayType& p,
+                       ArrayType& scalars, ArrayType& partials)
+      : A(A), M(M), y(y), z(z), r(r), p(p),
+        N(A.num_rows), identity(cusp::system::cuda::detail::is_identity_operator<Preconditioner>::value),
+        steps(ALL_STEPS)
+    {
+        x_ptr = thrust::raw_pointer_cast(&x[0]);
+        y_ptr = thrust::raw_pointer_cast(&y[0]);
+        r_ptr = thrust::raw_pointer_cast(&r[0]);
+        p_ptr = thrust::raw_pointer_cast(&p[0]);
+        s_ptr = thrust::raw_pointer_cast(&scalars[0]);
+        partials_ptr = thrust::raw_pointer_cast(&partials[0]);
+
+        // without preconditioning z aliases r
+        z_ptr = identity ? r_ptr : thrust::raw_pointer_cast(&z[0]);
+    }
+
+    template <typename Policy>
+    void operator()(Policy& exec)
+    {
+        using namespace cusp::system::cuda::detail;
+
+        if(steps & APPLY_A)
+        {
+            // y <- Ap and alpha <- <r,z>/<y,p>
+            cusp::multiply(exec, A, p, y);
+            graph_dotc(exec, N, y_ptr, p_ptr, partials_ptr);
+            graph_scalar<1>(exec, N, partials_ptr, s_ptr, cg_alpha<ValueType>());
+
+            // x <- x + alpha * p and r <- r - alpha * y
+            graph_for_each(exec, N, cg_update_xr<ValueType>(x_ptr, r_ptr, p_ptr, y_ptr, s_ptr));
+        }
+
+        if((steps & APPLY_M) && !identity)
+        {
+            // z <- M*r
+            cusp::multiply(exec, M, r, z);
+        }
+
+        if(steps & UPDATE_P)
+        {
+            // rz = <r^H, z> and beta <- <r_{i+1},z_{i+1}>/<r,z>
+            graph_dotc(exec, N, r_ptr, z_ptr, partials_ptr);
+            graph_scalar<1>(exec, N, partials_ptr, s_ptr, cg_beta<ValueType>());
+
+            // p <- z + beta*p
+            graph_for_each(exec, N, cg_update_p<ValueType>(p_ptr, z_ptr, s_ptr));
+        }
+    }
+};
+
+template <typename DerivedPolicy,
+          typename LinearOperator,
+          typename VectorType1,
+          typename VectorType2,
+          typename Monitor,
+          typename Preconditioner>
+void cg_graph(cusp::cuda::execution_policy<DerivedPolicy> &exec,
+              const LinearOperator& A,
+                    VectorType1& x,
+              const VectorType2& b,
+                    Monitor& monitor,
+                    Preconditioner& M)
+{
+    using namespace cusp::system::cuda::detail;
+
+    typedef typename LinearOperator::value_type                ValueType;
+    typedef cusp::detail::temporary_array<ValueType, DerivedPolicy> ArrayType;
+    typedef cg_graph_iteration<LinearOperator,VectorType1,Preconditioner,ArrayType> Iteration;
+
+    assert(A.num_rows == A.num_cols);        // sanity check
+
+    const size_t N = A.num_rows;
+
+    if(N == 0)
+    {
+        cg(exec, A, x, b, monitor, M);
+        return;
+    }
+
+    graph_solver_stream solver_stream(stream(thrust::detail::derived_cast(exec)));
+    const cudaStream_t s = solver_stream.get();
+
+    execute_on_stream sexec(s);
+
+    const bool identity = is_identity_operator<Preconditioner>::value;
+
+    // allocate workspace
+    ArrayType y(exec, N);
+    ArrayType z(exec, identity ? 0 : N);
+    ArrayType r(exec, N);
+    ArrayType p(exec, N);
+    ArrayType scalars(exec, CG_NUM_SCALARS);
+    ArrayType partials(exec, graph_num_partials(N));
+
+    Iteration iteration(A, x, M, y, z, r, p, scalars, partials);
+
+    // y <- Ax
+    cusp::multiply(sexec, A, x, y);
+
+    // r <- b - A*x
+    cusp::blas::axpby(sexec, b, y, r, ValueType(1), ValueType(-1));
+
+    // z <- M*r and p <- z
+    if(identity)
+    {
+        cusp::blas::copy(sexec, r, p);
+    }
+    else
+    {
+        cusp::multiply(sexec, M, r, z);
+        cusp::blas::copy(sexec, z, p);
+    }
+
+    // rz = <r^H, z>, kept on the device
+    graph_dotc(sexec, N, iteration.r_ptr, iteration.z_ptr, iteration.partials_ptr);
+    graph_scalar<1>(sexec, N, iteration.partials_ptr, iteration.s_ptr, cg_store_rz<ValueType>());
+
+    cusp::system::cuda::stream_graph full;
+    cusp::system::cuda::stream_graph before_M;
+    cusp::system::cuda::stream_graph after_M;
+
+    bool split = false;
+
+    if(!full.capture(s, iteration) && !identity)
+    {
+        // M could not be captured, capture the work around it
+        iteration.steps = Iteration::APPLY_A;
+
+        if(before_M.capture(s, iteration))
+        {
+            iteration.steps = Iteration::UPDATE_P;
+            split = after_M.capture(s, iteration);
+        }
+    }
+
+    if(full.empty() && !split)
+    {
+        // A could not be captured
+        cg(exec, A, x, b, monitor, M);
+        return;
+    }
+
+    while (!monitor.finished(sexec, r))
+    {
+        if(split)
+        {
+            before_M.launch(s);
+
+            // z <- M*r
+            cusp::multiply(sexec, M, r, z);
+
+            after_M.launch(s);
+        }
+        else
+        {
+            full.launch(s);
+        }
+
+        ++monitor;
+    }
+}
+
+#endif
+
+} // end cg_detail namespace
+
+template <typename DerivedPolicy,
+          typename LinearOperator,
+          typename VectorType1,
+          typename VectorType2,
+          typename Monitor,
+          typename Preconditioner>
+void cg_graph(const thrust::detail::execution_policy_base<DerivedPolicy> &exec,
+              const LinearOperator& A,
+                    VectorType1& x,
+              const VectorType2& b,
+                    Monitor& monitor,
+                    Preconditioner& M)
+{
+    using cusp::krylov::cg_detail::cg_graph;
+
+    return cg_graph(thrust::detail::derived_cast(thrust::detail::strip_const(exec)), A, x, b, monitor, M);
+}
+
+template <typename LinearOperator,
+          typename VectorType1,
+          typename VectorType2,
+          typename Monitor,
+          typename Preconditioner>
+void cg_graph(const LinearOperator& A,
+                    VectorType1& x,
+              const VectorType2& b,
+                    Monitor& monitor,
+                    Preconditioner& M)
+{
+    using thrust::system::detail::generic::select_system;
+
+    typedef typename LinearOperator::memory_space System1;
+    typedef typename VectorType2::memory_space    System2;
+
+    System1 system1;
+    System2 system2;
+
+    return cusp::krylov::cg_graph(select_system(system1,system2), A, x, b, monitor, M);
+}
+
+template <typename LinearOperator,
+          typename VectorType1,
+          typename VectorType2,
+          typename Monitor>
+void cg_graph(const LinearOperator& A,
+                    VectorType1& x,
+              const VectorType2& b,
+                    Monitor& monitor)
+{
+    typedef typename LinearOperator::value_type   ValueType;
+    typedef typename LinearOperator::memory_space MemorySpace;
+
+    cusp::identity_operator<ValueType,MemorySpace> M(A.num_rows, A.num_cols);
+
+    return cusp::krylov::cg_graph(A, x, b, monitor, M);
+}
+
+template <typename LinearOperator,
+          typename VectorType1,
+          typename VectorType2>
+void cg_graph(const LinearOperator& A,
+                    VectorType1& x,
+              const VectorType2& b)
+{
+    typedef typename LinearOperator::value_type   ValueType;
+
+    cusp::monitor<ValueType> monitor(b);
+
+    return cusp::krylov::cg_graph(A, x, b, monitor);
+}
+
+} // end namespace krylov
+} // end namespace cusp
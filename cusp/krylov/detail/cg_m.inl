@@ -23,6 +23,8 @@
 
 #include <cusp/blas/blas.h>
 
+#include <cusp/krylov/detail/multi_mass.h>
+
 #include <cusp/detail/temporary_array.h>
 
 #include <thrust/copy.h>
@@ -34,6 +36,8 @@
 
 #include <thrust/iterator/transform_iterator.h>
 
+#include <cmath>
+
 /*
  * The point of these routines is to solve systems of the type
  *
@@ -65,86 +69,92 @@ namespace cg_detail
 // are specific to CG-M
 namespace detail_m
 {
-// computes new \zeta, \beta
-template <typename ScalarType>
-struct KERNEL_ZB
+// computes new \zeta, \beta, \alpha of every shift and recycles \zeta,
+// shifts whose residual \zeta_0^\sigma r_0 has converged are frozen
+template <typename ScalarType, typename NormType>
+struct KERNEL_ZBA
 {
     ScalarType beta_m1;
     ScalarType beta_0;
+    ScalarType alpha_m1;
     ScalarType alpha_0;
-
-    KERNEL_ZB(ScalarType _beta_m1, ScalarType _beta_0, ScalarType _alpha_0)
-        : beta_m1(_beta_m1), beta_0(_beta_0), alpha_0(_alpha_0)
+    NormType   residual_norm;
+    NormType   tolerance;
+
+    KERNEL_ZBA(ScalarType _beta_m1, ScalarType _beta_0,
+               ScalarType _alpha_m1, ScalarType _alpha_0,
+               NormType _residual_norm, NormType _tolerance)
+        : beta_m1(_beta_m1), beta_0(_beta_0),
+          alpha_m1(_alpha_m1), alpha_0(_alpha_0),
+          residual_norm(_residual_norm), tolerance(_tolerance)
     {}
 
     template <typename Tuple>
     __host__ __device__
     void operator()(Tuple t)
     {
-        typedef typename cusp::norm_type<ScalarType>::type NormType;
+        ScalarType z0 = thrust::get<0>(t), zm1 = thrust::get<1>(t),
+                   sigma = thrust::get<5>(t);
+
+        if (!thrust::get<4>(t))
+            return;
+
+        if (cusp::krylov::multi_mass_detail::shift_converged(z0, residual_norm, tolerance))
+        {
+            thrust::get<4>(t) = false;
+            return;
+        }
 
         // compute \zeta_1^\sigma
-        ScalarType z1, b0, z0=thrust::get<2>(t), zm1 = thrust::get<3>(t),
-                           sigma = thrust::get<4>(t);
-        z1 = z0*zm1*beta_m1/(beta_0*alpha_0*(zm1-z0)
+        ScalarType z1, b0;
+        z1 = z0*zm1*beta_m1/(beta_0*alpha_m1*(zm1-z0)
                              +beta_m1*zm1*(ScalarType(1)-beta_0*sigma));
         b0 = beta_0*z1/z0;
         if ( cusp::abs(z1) < NormType(1e-30) )
             z1 = ScalarType(1e-18);
-        thrust::get<0>(t) = z1;
-        thrust::get<1>(t) = b0;
-    }
-};
-
-// computes new alpha
-template <typename ScalarType>
-struct KERNEL_A
-{
-    ScalarType beta_0;
-    ScalarType alpha_0;
 
-    // note: only the ratio alpha_0/beta_0 enters in the computation, it might
-    // be better just to pass this ratio
-    KERNEL_A(ScalarType _beta_0, ScalarType _alpha_0)
-        : beta_0(_beta_0), alpha_0(_alpha_0)
-    {}
+        // compute \beta_0^\sigma, \alpha_0^\sigma
+        thrust::get<2>(t) = b0;
+        thrust::get<3>(t) = alpha_0/beta_0*z1*b0/z0;
 
-    template <typename Tuple>
-    __host__ __device__
-    void operator()(Tuple t)
-    {
-        // compute \alpha_0^\sigma
-        thrust::get<0>(t)=alpha_0/beta_0*thrust::get<2>(t)*thrust::get<3>(t)/
-                          thrust::get<1>(t);
+        // recycle \zeta_i^\sigma
+        thrust::get<1>(t) = z0;
+        thrust::get<0>(t) = z1;
     }
 };
 
-// computes new x
+// computes new x and p of every active shift in a single pass over the
+// column-major N-by-N_s solutions
 template <typename ScalarType>
 struct KERNEL_XP
 {
-    int N;
+    size_t N;
     const ScalarType *alpha_0_s;
     const ScalarType *beta_0_s;
     const ScalarType *z_1_s;
+    const bool *active_s;
     const ScalarType *r_0;
 
-    KERNEL_XP(int _N, const ScalarType *_alpha_0_s, const ScalarType *_beta_0_s,
-              const ScalarType *_z_1_s, const ScalarType *_r_0) :
+    KERNEL_XP(size_t _N, const ScalarType *_alpha_0_s, const ScalarType *_beta_0_s,
+              const ScalarType *_z_1_s, const bool *_active_s, const ScalarType *_r_0) :
         N(_N), alpha_0_s(_alpha_0_s),
-        beta_0_s(_beta_0_s), z_1_s(_z_1_s), r_0(_r_0) {}
+        beta_0_s(_beta_0_s), z_1_s(_z_1_s), active_s(_active_s), r_0(_r_0) {}
 
     template <typename Tuple>
     __host__ __device__
     void operator()(Tuple t)
     {
+        size_t index = thrust::get<2>(t);
+
+        size_t N_s = index / N;
+        size_t N_i = index % N;
+
+        if (!active_s[N_s])
+            return;
+
         // return the transformed result
         ScalarType x = thrust::get<0>(t);
         ScalarType p_0 = thrust::get<1>(t);
-        int index = thrust::get<2>(t);
-
-        int N_s = index / N;
-        int N_i = index % N;
 
         x = x-beta_0_s[N_s]*p_0;
         p_0 = z_1_s[N_s]*r_0[N_i]+alpha_0_s[N_s]*p_0;
@@ -174,19 +184,6 @@ struct KERNEL_VCOPY : thrust::unary_function<int, ScalarType>
 
 };
 
-struct KERNEL_DCOPY
-{
-    KERNEL_DCOPY() {}
-
-    template <typename Tuple>
-    __host__ __device__
-    void operator()(Tuple t)
-    {
-        thrust::get<2>(t)=thrust::get<1>(t);
-        thrust::get<1>(t)=thrust::get<0>(t);
-    }
-};
-
 template <typename T>
 struct XPAY : public thrust::binary_function<T,T,T>
 {
@@ -214,86 +211,43 @@ struct XPAY : public thrust::binary_function<T,T,T>
 // a struct from cusp::krylov::detail_m.
 namespace trans_m
 {
-// compute \zeta_1^\sigma, \beta_0^\sigma using iterators
-// uses detail_m::KERNEL_ZB
-template <typename InputIterator1, typename InputIterator2,
-         typename InputIterator3,
-         typename OutputIterator1, typename OutputIterator2,
-         typename ScalarType>
-void compute_zb_m(InputIterator1 z_0_s_b, InputIterator1 z_0_s_e,
-                  InputIterator2 z_m1_s_b, InputIterator3 sig_b,
-                  OutputIterator1 z_1_s_b, OutputIterator2 b_0_s_b,
-                  ScalarType beta_m1, ScalarType beta_0, ScalarType alpha_0)
-{
-    size_t N = z_0_s_e - z_0_s_b;
-    thrust::for_each(
-        thrust::make_zip_iterator(thrust::make_tuple(z_1_s_b,b_0_s_b,z_0_s_b,z_m1_s_b,sig_b)),
-        thrust::make_zip_iterator(thrust::make_tuple(z_1_s_b,b_0_s_b,z_0_s_b,z_m1_s_b,sig_b))+N,
-        cusp::krylov::cg_detail::detail_m::KERNEL_ZB<ScalarType>(beta_m1,beta_0,alpha_0)
-    );
-}
-
-// compute \zeta_1^\sigma, \beta_0^\sigma using arrays
-template <typename Array1, typename Array2, typename Array3,
-         typename Array4, typename Array5, typename ScalarType>
-void compute_zb_m(const Array1& z_0_s, const Array2& z_m1_s,
-                  const Array3& sig, Array4& z_1_s, Array5& b_0_s,
-                  ScalarType beta_m1, ScalarType beta_0, ScalarType alpha_0)
+// compute \zeta_1^\sigma, \beta_0^\sigma, \alpha_0^\sigma and recycle
+// \zeta_i^\sigma in a single pass over the shifts
+// uses detail_m::KERNEL_ZBA
+template <typename DerivedPolicy,
+         typename Array1, typename Array2, typename Array3,
+         typename Array4, typename Array5, typename Array6,
+         typename ScalarType, typename NormType>
+void compute_zba_m(thrust::execution_policy<DerivedPolicy> &exec,
+                   const Array1& sig, Array2& z_0_s, Array3& z_m1_s,
+                   Array4& b_0_s, Array5& a_0_s, Array6& active_s,
+                   ScalarType beta_m1, ScalarType beta_0,
+                   ScalarType alpha_m1, ScalarType alpha_0,
+                   NormType residual_norm, NormType tolerance)
 {
     // sanity checks
-    cusp::assert_same_dimensions(z_0_s,z_m1_s,z_1_s);
-    cusp::assert_same_dimensions(z_1_s,b_0_s,sig);
+    cusp::assert_same_dimensions(sig, z_0_s, z_m1_s);
+    cusp::assert_same_dimensions(b_0_s, a_0_s, active_s);
 
-    // compute
-    cusp::krylov::cg_detail::trans_m::compute_zb_m(z_0_s.begin(),z_0_s.end(),
-                                        z_m1_s.begin(),sig.begin(),z_1_s.begin(),b_0_s.begin(),
-                                        beta_m1,beta_0,alpha_0);
-
-}
-
-// compute \alpha_0^\sigma, and swap \zeta_i^\sigma using iterators
-// uses detail_m::KERNEL_A
-template <typename InputIterator1, typename InputIterator2,
-         typename InputIterator3, typename OutputIterator,
-         typename ScalarType>
-void compute_a_m(InputIterator1 z_0_s_b, InputIterator1 z_0_s_e,
-                 InputIterator2 z_1_s_b, InputIterator3 beta_0_s_b,
-                 OutputIterator alpha_0_s_b,
-                 ScalarType beta_0, ScalarType alpha_0)
-{
-    size_t N = z_0_s_e - z_0_s_b;
-    thrust::for_each(
-        thrust::make_zip_iterator(thrust::make_tuple(alpha_0_s_b,z_0_s_b,z_1_s_b,beta_0_s_b)),
-        thrust::make_zip_iterator(thrust::make_tuple(alpha_0_s_b,z_0_s_b,z_1_s_b,beta_0_s_b))+N,
-        cusp::krylov::cg_detail::detail_m::KERNEL_A<ScalarType>(beta_0,alpha_0));
-}
-
-// compute \alpha_0^\sigma, and swap \zeta_i^\sigma using arrays
-template <typename Array1, typename Array2, typename Array3,
-         typename Array4, typename ScalarType>
-void compute_a_m(const Array1& z_0_s, const Array2& z_1_s,
-                 const Array3& beta_0_s, Array4& alpha_0_s,
-                 ScalarType beta_0, ScalarType alpha_0)
-{
-    // sanity checks
-    cusp::assert_same_dimensions(z_0_s,z_1_s);
-    cusp::assert_same_dimensions(z_0_s,alpha_0_s,beta_0_s);
+    size_t N = z_0_s.end() - z_0_s.begin();
 
     // compute
-    cusp::krylov::cg_detail::trans_m::compute_a_m(z_0_s.begin(), z_0_s.end(),
-                                       z_1_s.begin(), beta_0_s.begin(), alpha_0_s.begin(),
-                                       beta_0, alpha_0);
+    thrust::for_each(exec,
+        thrust::make_zip_iterator(thrust::make_tuple(z_0_s.begin(),z_m1_s.begin(),b_0_s.begin(),a_0_s.begin(),active_s.begin(),sig.begin())),
+        thrust::make_zip_iterator(thrust::make_tuple(z_0_s.begin(),z_m1_s.begin(),b_0_s.begin(),a_0_s.begin(),active_s.begin(),sig.begin()))+N,
+        cusp::krylov::cg_detail::detail_m::KERNEL_ZBA<ScalarType,NormType>(beta_m1,beta_0,alpha_m1,alpha_0,
+                                                                           residual_norm,tolerance));
 }
 
-// compute x^\sigma, p^\sigma
-// this is currently done by calling two different kernels... this is likely
-// not optimal
+// compute x^\sigma, p^\sigma of the active shifts
 // uses detail_m::KERNEL_XP
-template <typename Array1, typename Array2, typename Array3,
-         typename Array4, typename Array5, typename Array6>
-void compute_xp_m(const Array1& alpha_0_s, const Array2& z_1_s,
-                  const Array3& beta_0_s, const Array4& r_0,
-                  Array5& x_0_s, Array6& p_0_s)
+template <typename DerivedPolicy,
+         typename Array1, typename Array2, typename Array3,
+         typename Array4, typename Array5, typename Array6, typename Array7>
+void compute_xp_m(thrust::execution_policy<DerivedPolicy> &exec,
+                  const Array1& alpha_0_s, const Array2& z_1_s,
+                  const Array3& beta_0_s, const Array4& active_s,
+                  const Array5& r_0, Array6& x_0_s, Array7& p_0_s)
 {
     // sanity check
     cusp::assert_same_dimensions(alpha_0_s, z_1_s, beta_0_s);
@@ -303,35 +257,23 @@ void compute_xp_m(const Array1& alpha_0_s, const Array2& z_1_s,
     size_t N_t = x_0_s.end() - x_0_s.begin();
     assert (N_t == N*N_s);
 
-    // counting iterators to pass to thrust::transform
-    thrust::counting_iterator<int> counter(0);
+    // counting iterators to pass to thrust::for_each
+    thrust::counting_iterator<size_t> counter(0);
 
     // get raw pointers for passing to kernels
     typedef typename Array1::value_type   ScalarType;
     const ScalarType *raw_ptr_alpha_0_s = thrust::raw_pointer_cast(&alpha_0_s[0]);
     const ScalarType *raw_ptr_z_1_s     = thrust::raw_pointer_cast(&z_1_s[0]);
     const ScalarType *raw_ptr_beta_0_s  = thrust::raw_pointer_cast(&beta_0_s[0]);
+    const bool       *raw_ptr_active_s  = thrust::raw_pointer_cast(&active_s[0]);
     const ScalarType *raw_ptr_r_0       = thrust::raw_pointer_cast(&r_0[0]);
 
     // compute new x,p
-    thrust::for_each(
+    thrust::for_each(exec,
         thrust::make_zip_iterator(thrust::make_tuple(x_0_s.begin(), p_0_s.begin(),counter)),
         thrust::make_zip_iterator(thrust::make_tuple(x_0_s.begin(), p_0_s.begin(),counter))+N_t,
-        cusp::krylov::cg_detail::detail_m::KERNEL_XP<ScalarType>(N, raw_ptr_alpha_0_s, raw_ptr_beta_0_s, raw_ptr_z_1_s, raw_ptr_r_0));
-}
-
-template <typename Array1, typename Array2, typename Array3>
-void doublecopy(const Array1& s, Array2& sd, Array3& d)
-{
-    // sanity check
-    cusp::assert_same_dimensions(s, sd, d);
-    size_t N = s.end() - s.begin();
-
-    // recycle
-    thrust::for_each(
-        thrust::make_zip_iterator(thrust::make_tuple(s.begin(), sd.begin(), d.begin())),
-        thrust::make_zip_iterator(thrust::make_tuple(s.begin(), sd.begin(), d.begin())) + N,
-        cusp::krylov::cg_detail::detail_m::KERNEL_DCOPY());
+        cusp::krylov::cg_detail::detail_m::KERNEL_XP<ScalarType>(N, raw_ptr_alpha_0_s, raw_ptr_beta_0_s,
+                                                                 raw_ptr_z_1_s, raw_ptr_active_s, raw_ptr_r_0));
 }
 
 // multiple copy of array to another array
@@ -382,19 +324,19 @@ void xpay(const Array1& x,
 
 } // end namespace trans_m
 
-// CG-M routine that takes a user specified monitor
+// CG-M iteration on the shifted solutions stored contiguously in x
 template <typename DerivedPolicy,
           typename LinearOperator,
           typename VectorType1,
           typename VectorType2,
           typename VectorType3,
           typename Monitor>
-void cg_m(thrust::execution_policy<DerivedPolicy> &exec,
-          const LinearOperator& A,
-                VectorType1& x,
-          const VectorType2& b,
-          const VectorType3& sigma,
-                Monitor& monitor)
+void cg_m_solve(thrust::execution_policy<DerivedPolicy> &exec,
+                const LinearOperator& A,
+                      VectorType1& x,
+                const VectorType2& b,
+                const VectorType3& sigma,
+                      Monitor& monitor)
 {
     //
     // This bit is initialization of the solver.
@@ -402,6 +344,7 @@ void cg_m(thrust::execution_policy<DerivedPolicy> &exec,
 
     // shorthand for typenames
     typedef typename LinearOperator::value_type        ValueType;
+    typedef typename cusp::norm_type<ValueType>::type  NormType;
 
     // sanity checking
     const size_t N = A.num_rows;
@@ -424,11 +367,14 @@ void cg_m(thrust::execution_policy<DerivedPolicy> &exec,
     // stores parameters used in the iteration
     cusp::detail::temporary_array<ValueType, DerivedPolicy> z_m1_s(exec, N_s, ValueType(1));
     cusp::detail::temporary_array<ValueType, DerivedPolicy> z_0_s(exec, N_s, ValueType(1));
-    cusp::detail::temporary_array<ValueType, DerivedPolicy> z_1_s(exec, N_s);
 
     cusp::detail::temporary_array<ValueType, DerivedPolicy> alpha_0_s(exec, N_s, ValueType(0));
     cusp::detail::temporary_array<ValueType, DerivedPolicy> beta_0_s(exec, N_s);
 
+    // shifts that have not converged yet
+    cusp::detail::temporary_array<bool, DerivedPolicy> active_s(exec, N_s, true);
+    const NormType tolerance = monitor.tolerance();
+
     // stores parameters used in the iteration for the undeformed system
     ValueType beta_m1, beta_0(ValueType(1));
     ValueType alpha_0(ValueType(0));
@@ -476,31 +422,51 @@ void cg_m(thrust::execution_policy<DerivedPolicy> &exec,
         // compute the new residual
         cusp::blas::axpy(exec, Ap, r_0, beta_0);
 
-        // compute \zeta_1^\sigma, \beta_0^\sigma
-        cusp::krylov::cg_detail::trans_m::compute_zb_m(z_0_s, z_m1_s, sigma, z_1_s, beta_0_s,
-                                            beta_m1, beta_0, alpha_0);
-
         // compute \alpha_0
+        ValueType alpha_m1 = alpha_0;
         rsq_1 = cusp::blas::dotc(exec, r_0, r_0);
         alpha_0 = rsq_1 / rsq_0;
         cusp::krylov::cg_detail::trans_m::xpay(r_0, p_0, alpha_0);
 
-        // calculate \alpha_0^\sigma
-        cusp::krylov::cg_detail::trans_m::compute_a_m(z_0_s, z_1_s, beta_0_s,
-                                                      alpha_0_s, beta_0, alpha_0);
-
-        // compute x_0^\sigma, p_0^\sigma
-        cusp::krylov::cg_detail::trans_m::compute_xp_m(alpha_0_s, z_1_s, beta_0_s, r_0,
-                                                       x, p_0_s);
+        // compute \zeta_1^\sigma, \beta_0^\sigma, \alpha_0^\sigma and
+        // recycle \zeta_i^\sigma, freezing the shifts that have converged
+        cusp::krylov::cg_detail::trans_m::compute_zba_m(exec, sigma, z_0_s, z_m1_s, beta_0_s,
+                                                        alpha_0_s, active_s, beta_m1, beta_0,
+                                                        alpha_m1, alpha_0,
+                                                        NormType(std::sqrt(cusp::abs(rsq_0))),
+                                                        tolerance);
 
-        // recycle \zeta_i^\sigma
-        cusp::krylov::cg_detail::trans_m::doublecopy(z_1_s, z_0_s, z_m1_s);
+        // compute x_0^\sigma, p_0^\sigma of the active shifts
+        cusp::krylov::cg_detail::trans_m::compute_xp_m(exec, alpha_0_s, z_0_s, beta_0_s, active_s,
+                                                       r_0, x, p_0_s);
 
         ++monitor;
 
     }// finished iteration
 
-} // end cg_m
+} // end cg_m_solve
+
+// CG-M routine that takes a user specified monitor
+template <typename DerivedPolicy,
+          typename LinearOperator,
+          typename VectorType1,
+          typename VectorType2,
+          typename VectorType3,
+          typename Monitor>
+void cg_m(thrust::execution_policy<DerivedPolicy> &exec,
+          const LinearOperator& A,
+                VectorType1& x,
+          const VectorType2& b,
+          const VectorType3& sigma,
+                Monitor& monitor)
+{
+    const size_t N   = A.num_rows;
+    const size_t N_s = sigma.end() - sigma.begin();
+
+    cg_m_solve(exec, A,
+               cusp::krylov::multi_mass_detail::shifted_solutions(x, N, N_s, typename VectorType1::format()),
+               b, sigma, monitor);
+}
 
 } // end cg_detail namespace
 
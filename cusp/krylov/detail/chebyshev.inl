@@ -0,0 +1,186 @@
+/*
+ *  Copyright 2008-2014 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include <cusp/array1d.h>
+#include <cusp/exception.h>
+#include <cusp/linear_operator.h>
+#include <cusp/multiply.h>
+#include <cusp/monitor.h>
+
+#include <cusp/detail/temporary_array.h>
+
+#include <cusp/blas/blas.h>
+
+namespace blas = cusp::blas;
+
+namespace cusp
+{
+namespace krylov
+{
+namespace chebyshev_detail
+{
+
+template <typename DerivedPolicy,
+          typename LinearOperator,
+          typename VectorType1,
+          typename VectorType2,
+          typename Monitor,
+          typename Preconditioner,
+          typename RealType>
+void chebyshev(thrust::execution_policy<DerivedPolicy> &exec,
+               const LinearOperator& A,
+                     VectorType1& x,
+               const VectorType2& b,
+                     Monitor& monitor,
+                     Preconditioner& M,
+               const RealType lambda_min,
+               const RealType lambda_max)
+{
+    typedef typename LinearOperator::value_type           ValueType;
+
+    assert(A.num_rows == A.num_cols);        // sanity check
+
+    if (!(lambda_min > RealType(0)) || !(lambda_min < lambda_max))
+        throw cusp::invalid_input_exception("chebyshev: spectral bounds must satisfy 0 < lambda_min < lambda_max");
+
+    const size_t N = A.num_rows;
+
+    // allocate workspace
+    cusp::detail::temporary_array<ValueType, DerivedPolicy> y(exec, N);
+    cusp::detail::temporary_array<ValueType, DerivedPolicy> z(exec, N);
+    cusp::detail::temporary_array<ValueType, DerivedPolicy> r(exec, N);
+    cusp::detail::temporary_array<ValueType, DerivedPolicy> d(exec, N);
+
+    // center and half-width of the interval
+    const RealType theta = (lambda_max + lambda_min) / RealType(2);
+    const RealType delta = (lambda_max - lambda_min) / RealType(2);
+    const RealType sigma = theta / delta;
+
+    RealType rho = RealType(1) / sigma;
+
+    // y <- Ax
+    cusp::multiply(exec, A, x, y);
+
+    // r <- b - A*x
+    blas::axpby(exec, b, y, r, ValueType(1), ValueType(-1));
+
+    // z <- M*r
+    cusp::multiply(exec, M, r, z);
+
+    // d <- z / theta
+    blas::axpby(exec, z, z, d, ValueType(RealType(1) / theta), ValueType(0));
+
+    while (!monitor.finished(exec, r))
+    {
+        // x <- x + d
+        blas::axpy(exec, d, x, ValueType(1));
+
+        // y <- Ad
+        cusp::multiply(exec, A, d, y);
+
+        // r <- r - y
+        blas::axpy(exec, y, r, ValueType(-1));
+
+        // z <- M*r
+        cusp::multiply(exec, M, r, z);
+
+        // rho_{k+1} <- 1 / (2 sigma - rho_k)
+        RealType rho_next = RealType(1) / (RealType(2) * sigma - rho);
+
+        // d <- rho_{k+1} rho_k d + (2 rho_{k+1} / delta) z
+        blas::axpby(exec, z, d, d,
+                    ValueType(RealType(2) * rho_next / delta),
+                    ValueType(rho_next * rho));
+
+        rho = rho_next;
+
+        ++monitor;
+    }
+}
+
+} // end chebyshev_detail namespace
+
+template <typename DerivedPolicy,
+          typename LinearOperator,
+          typename VectorType1,
+          typename VectorType2,
+          typename Monitor,
+          typename Preconditioner,
+          typename RealType>
+void chebyshev(const thrust::detail::execution_policy_base<DerivedPolicy> &exec,
+               const LinearOperator& A,
+                     VectorType1& x,
+               const VectorType2& b,
+                     Monitor& monitor,
+                     Preconditioner& M,
+               const RealType lambda_min,
+               const RealType lambda_max)
+{
+    using cusp::krylov::chebyshev_detail::chebyshev;
+
+    return chebyshev(thrust::detail::derived_cast(thrust::detail::strip_const(exec)),
+                     A, x, b, monitor, M, lambda_min, lambda_max);
+}
+
+template <typename LinearOperator,
+          typename VectorType1,
+          typename VectorType2,
+          typename Monitor,
+          typename Preconditioner,
+          typename RealType>
+void chebyshev(const LinearOperator& A,
+                     VectorType1& x,
+               const VectorType2& b,
+                     Monitor& monitor,
+                     Preconditioner& M,
+               const RealType lambda_min,
+               const RealType lambda_max)
+{
+    using thrust::system::detail::generic::select_system;
+
+    typedef typename LinearOperator::memory_space System1;
+    typedef typename VectorType2::memory_space    System2;
+
+    System1 system1;
+    System2 system2;
+
+    return cusp::krylov::chebyshev(select_system(system1,system2),
+                                   A, x, b, monitor, M, lambda_min, lambda_max);
+}
+
+template <typename LinearOperator,
+          typename VectorType1,
+          typename VectorType2,
+          typename Monitor,
+          typename RealType>
+void chebyshev(const LinearOperator& A,
+                     VectorType1& x,
+               const VectorType2& b,
+                     Monitor& monitor,
+               const RealType lambda_min,
+               const RealType lambda_max)
+{
+    typedef typename LinearOperator::value_type   ValueType;
+    typedef typename LinearOperator::memory_space MemorySpace;
+
+    cusp::identity_operator<ValueType,MemorySpace> M(A.num_rows, A.num_cols);
+
+    return cusp::krylov::chebyshev(A, x, b, monitor, M, lambda_min, lambda_max);
+}
+
+} // end namespace krylov
+} // end namespace cusp
+
@@ -35,29 +35,27 @@ template <typename DerivedPolicy,
           typename VectorType1,
           typename VectorType2,
           typename Monitor,
-          typename Preconditioner>
+          typename Preconditioner,
+          typename ArrayType>
 void cr(thrust::execution_policy<DerivedPolicy> &exec,
         const LinearOperator& A,
               VectorType1& x,
         const VectorType2& b,
               Monitor& monitor,
-              Preconditioner& M)
+              Preconditioner& M,
+              ArrayType& y,
+              ArrayType& z,
+              ArrayType& r,
+              ArrayType& p,
+              ArrayType& Az,
+              ArrayType& Ax)
 {
     typedef typename LinearOperator::value_type           ValueType;
 
     assert(A.num_rows == A.num_cols);        // sanity check
 
-    const size_t N = A.num_rows;
     const size_t recompute_r = 8;	     // interval to update r
 
-    // allocate workspace
-    cusp::detail::temporary_array<ValueType, DerivedPolicy> y(exec, N);
-    cusp::detail::temporary_array<ValueType, DerivedPolicy> z(exec, N);
-    cusp::detail::temporary_array<ValueType, DerivedPolicy> r(exec, N);
-    cusp::detail::temporary_array<ValueType, DerivedPolicy> p(exec, N);
-    cusp::detail::temporary_array<ValueType, DerivedPolicy> Az(exec, N);
-    cusp::detail::temporary_array<ValueType, DerivedPolicy> Ax(exec, N);
-
     // y <- A*x
     cusp::multiply(exec, A, x, Ax);
 
@@ -126,6 +124,34 @@ void cr(thrust::execution_policy<DerivedPolicy> &exec,
     }
 }
 
+template <typename DerivedPolicy,
+          typename LinearOperator,
+          typename VectorType1,
+          typename VectorType2,
+          typename Monitor,
+          typename Preconditioner>
+void cr(thrust::execution_policy<DerivedPolicy> &exec,
+        const LinearOperator& A,
+              VectorType1& x,
+        const VectorType2& b,
+              Monitor& monitor,
+              Preconditioner& M)
+{
+    typedef typename LinearOperator::value_type           ValueType;
+
+    const size_t N = A.num_rows;
+
+    // allocate workspace
+    cusp::detail::temporary_array<ValueType, DerivedPolicy> y(exec, N);
+    cusp::detail::temporary_array<ValueType, DerivedPolicy> z(exec, N);
+    cusp::detail::temporary_array<ValueType, DerivedPolicy> r(exec, N);
+    cusp::detail::temporary_array<ValueType, DerivedPolicy> p(exec, N);
+    cusp::detail::temporary_array<ValueType, DerivedPolicy> Az(exec, N);
+    cusp::detail::temporary_array<ValueType, DerivedPolicy> Ax(exec, N);
+
+    cr(exec, A, x, b, monitor, M, y, z, r, p, Az, Ax);
+}
+
 } // end cr_detail namespace
 
 template <typename DerivedPolicy,
@@ -199,6 +225,107 @@ void cr(const LinearOperator& A,
     cusp::krylov::cr(A, x, b, monitor);
 }
 
+///////////////
+// cr_solver //
+///////////////
+
+template <typename ValueType, typename MemorySpace>
+cr_solver<ValueType,MemorySpace>
+::cr_solver(const size_t N)
+    : y(N), z(N), r(N), p(N), Az(N), Ax(N) {}
+
+template <typename ValueType, typename MemorySpace>
+void
+cr_solver<ValueType,MemorySpace>
+::resize(const size_t N)
+{
+    y.resize(N);
+    z.resize(N);
+    r.resize(N);
+    p.resize(N);
+    Az.resize(N);
+    Ax.resize(N);
+}
+
+template <typename ValueType, typename MemorySpace>
+template <typename DerivedPolicy,
+          typename LinearOperator,
+          typename VectorType1,
+          typename VectorType2,
+          typename Monitor,
+          typename Preconditioner>
+void
+cr_solver<ValueType,MemorySpace>
+::solve(const thrust::detail::execution_policy_base<DerivedPolicy> &exec,
+        const LinearOperator& A,
+              VectorType1& x,
+        const VectorType2& b,
+              Monitor& monitor,
+              Preconditioner& M)
+{
+    using cusp::krylov::cr_detail::cr;
+
+    resize(A.num_rows);
+
+    cr(thrust::detail::derived_cast(thrust::detail::strip_const(exec)), A, x, b, monitor, M, y, z, r, p, Az, Ax);
+}
+
+template <typename ValueType, typename MemorySpace>
+template <typename LinearOperator,
+          typename VectorType1,
+          typename VectorType2,
+          typename Monitor,
+          typename Preconditioner>
+void
+cr_solver<ValueType,MemorySpace>
+::solve(const LinearOperator& A,
+              VectorType1& x,
+        const VectorType2& b,
+              Monitor& monitor,
+              Preconditioner& M)
+{
+    using thrust::system::detail::generic::select_system;
+
+    typedef typename LinearOperator::memory_space System1;
+    typedef typename VectorType2::memory_space    System2;
+
+    System1 system1;
+    System2 system2;
+
+    solve(select_system(system1,system2), A, x, b, monitor, M);
+}
+
+template <typename ValueType, typename MemorySpace>
+template <typename LinearOperator,
+          typename VectorType1,
+          typename VectorType2,
+          typename Monitor>
+void
+cr_solver<ValueType,MemorySpace>
+::solve(const LinearOperator& A,
+              VectorType1& x,
+        const VectorType2& b,
+              Monitor& monitor)
+{
+    cusp::identity_operator<ValueType,MemorySpace> M(A.num_rows, A.num_cols);
+
+    solve(A, x, b, monitor, M);
+}
+
+template <typename ValueType, typename MemorySpace>
+template <typename LinearOperator,
+          typename VectorType1,
+          typename VectorType2>
+void
+cr_solver<ValueType,MemorySpace>
+::solve(const LinearOperator& A,
+              VectorType1& x,
+        const VectorType2& b)
+{
+    cusp::monitor<ValueType> monitor(b);
+
+    solve(A, x, b, monitor);
+}
 
 } // end namespace krylov
 } // end namespace cusp
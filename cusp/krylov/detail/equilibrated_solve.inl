@@ -0,0 +1,136 @@
+/*
+ *  Copyright 2008-2014 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include <cusp/array1d.h>
+#include <cusp/monitor.h>
+
+#include <cusp/blas/blas.h>
+
+#include <cusp/detail/temporary_array.h>
+
+#include <thrust/functional.h>
+#include <thrust/transform.h>
+
+namespace cusp
+{
+namespace krylov
+{
+namespace equilibrated_solve_detail
+{
+
+template <typename DerivedPolicy,
+          typename LinearOperator,
+          typename VectorType1,
+          typename VectorType2,
+          typename ArrayType1,
+          typename ArrayType2,
+          typename Solver,
+          typename Monitor,
+          typename Preconditioner>
+void equilibrated_solve(thrust::execution_policy<DerivedPolicy> &exec,
+                        const LinearOperator& A,
+                              VectorType1& x,
+                        const VectorType2& b,
+                        const ArrayType1& row_scale,
+                        const ArrayType2& column_scale,
+                              Solver& solver,
+                              Monitor& monitor,
+                              Preconditioner& M)
+{
+    typedef typename LinearOperator::value_type   ValueType;
+    typedef typename LinearOperator::memory_space MemorySpace;
+
+    assert(A.num_rows == row_scale.size());        // sanity check
+    assert(A.num_cols == column_scale.size());     // sanity check
+
+    const size_t N = A.num_rows;
+
+    // the factors in the memory space of the solve
+    cusp::array1d<ValueType,MemorySpace> r(row_scale);
+    cusp::array1d<ValueType,MemorySpace> c(column_scale);
+
+    cusp::detail::temporary_array<ValueType, DerivedPolicy> y(exec, N);
+    cusp::detail::temporary_array<ValueType, DerivedPolicy> rb(exec, N);
+
+    // y <- x / c, rb <- r * b
+    thrust::transform(exec, x.begin(), x.end(), c.begin(), y.begin(), thrust::divides<ValueType>());
+    cusp::blas::xmy(exec, r, b, rb);
+
+    monitor.reset(exec, rb);
+    solver.solve(A, y, rb, monitor, M);
+
+    // x <- c * y
+    cusp::blas::xmy(exec, c, y, x);
+}
+
+} // end equilibrated_solve_detail namespace
+
+template <typename DerivedPolicy,
+          typename LinearOperator,
+          typename VectorType1,
+          typename VectorType2,
+          typename ArrayType1,
+          typename ArrayType2,
+          typename Solver,
+          typename Monitor,
+          typename Preconditioner>
+void equilibrated_solve(const thrust::detail::execution_policy_base<DerivedPolicy> &exec,
+                        const LinearOperator& A,
+                              VectorType1& x,
+                        const VectorType2& b,
+                        const ArrayType1& row_scale,
+                        const ArrayType2& column_scale,
+                              Solver& solver,
+                              Monitor& monitor,
+                              Preconditioner& M)
+{
+    using cusp::krylov::equilibrated_solve_detail::equilibrated_solve;
+
+    return equilibrated_solve(thrust::detail::derived_cast(thrust::detail::strip_const(exec)),
+                              A, x, b, row_scale, column_scale, solver, monitor, M);
+}
+
+template <typename LinearOperator,
+          typename VectorType1,
+          typename VectorType2,
+          typename ArrayType1,
+          typename ArrayType2,
+          typename Solver,
+          typename Monitor,
+          typename Preconditioner>
+void equilibrated_solve(const LinearOperator& A,
+                              VectorType1& x,
+                        const VectorType2& b,
+                        const ArrayType1& row_scale,
+                        const ArrayType2& column_scale,
+                              Solver& solver,
+                              Monitor& monitor,
+                              Preconditioner& M)
+{
+    using thrust::system::detail::generic::select_system;
+
+    typedef typename LinearOperator::memory_space System1;
+    typedef typename VectorType1::memory_space    System2;
+
+    System1 system1;
+    System2 system2;
+
+    return cusp::krylov::equilibrated_solve(select_system(system1,system2),
+                                            A, x, b, row_scale, column_scale, solver, monitor, M);
+}
+
+} // end namespace krylov
+} // end namespace cusp
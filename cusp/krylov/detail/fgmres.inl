@@ -0,0 +1,355 @@
+/*
+ *  Copyright 2008-2014 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include <cusp/array1d.h>
+#include <cusp/array2d.h>
+#include <cusp/linear_operator.h>
+#include <cusp/monitor.h>
+#include <cusp/multiply.h>
+
+#include <cusp/blas/blas.h>
+
+#include <cusp/detail/temporary_array.h>
+
+namespace cusp
+{
+namespace krylov
+{
+namespace fgmres_detail
+{
+
+template <typename DerivedPolicy,
+          typename LinearOperator,
+          typename VectorType1,
+          typename VectorType2,
+          typename Monitor,
+          typename Preconditioner,
+          typename ArrayType1,
+          typename Array2dType1,
+          typename Array2dType2,
+          typename ArrayType2>
+void fgmres(thrust::execution_policy<DerivedPolicy> &exec,
+            const LinearOperator &A,
+                  VectorType1 &x,
+            const VectorType2 &b,
+            const size_t restart,
+                  Monitor &monitor,
+                  Preconditioner &M,
+                  ArrayType1 &w,
+                  ArrayType1 &V0,
+                  Array2dType1 &V,
+                  Array2dType1 &Z,
+                  ArrayType1 &sDev,
+                  Array2dType2 &H,
+                  ArrayType2 &s,
+                  ArrayType2 &cs,
+                  ArrayType2 &sn,
+                  ArrayType2 &resid,
+                  ArrayType2 &h,
+            const gmres_orthogonalization orthogonalization)
+{
+    namespace blas = cusp::blas;
+
+    using cusp::krylov::gmres_detail::ClassicalGramSchmidt;
+    using cusp::krylov::gmres_detail::PlaneRotation;
+
+    typedef typename LinearOperator::value_type ValueType;
+    typedef typename cusp::norm_type<ValueType>::type NormType;
+
+    assert(A.num_rows == A.num_cols);  // sanity check
+
+    const int R = restart;
+    int i, j, k;
+    NormType beta = 0;
+
+    cusp::host_memory host_exec;
+
+    do
+    {
+        // compute initial residual and its norm
+        cusp::multiply(exec, A, x, w);                // V(0) = A*x
+        blas::axpy(exec, b, w, ValueType(-1));        // V(0) = V(0) - b
+        beta = blas::nrm2(exec, w);                   // beta = norm(V(0))
+        blas::scal(exec, w, ValueType(-1.0 / beta));  // V(0) = -V(0)/beta
+        blas::copy(exec, w, V.column(0));
+
+        // s = 0 //
+        blas::fill(host_exec, s, ValueType(0.0));
+        s[0] = beta;
+        i = -1;
+        resid[0] = cusp::abs(s[0]);
+        if (monitor.finished(resid))
+        {
+            break;
+        }
+
+        do
+        {
+            ++i;
+            ++monitor;
+
+            // Z(i) = M*V(i), the preconditioner may differ at every step
+            cusp::multiply(exec, M, w, V0);
+            blas::copy(exec, V0, Z.column(i));
+            // V(i+1) = A*Z(i)
+            cusp::multiply(exec, A, V0, w);
+
+            if (orthogonalization == classical_gram_schmidt)
+            {
+                // H(0:i,i) = V(0:i)^H V(i+1), V(i+1) -= V(0:i) H(0:i,i)
+                ClassicalGramSchmidt(exec, V, w, sDev, i + 1);
+                blas::copy(sDev, h);
+
+                for (k = 0; k <= i; k++)
+                    H(k, i) = h[k];
+
+                // reorthogonalize to recover the lost orthogonality
+                ClassicalGramSchmidt(exec, V, w, sDev, i + 1);
+                blas::copy(sDev, h);
+
+                for (k = 0; k <= i; k++)
+                    H(k, i) += h[k];
+            }
+            else
+            {
+                for (k = 0; k <= i; k++)
+                {
+                    //  H(k,i) = <V(i+1),V(k)>
+                    H(k, i) = blas::dotc(exec, V.column(k), w);
+                    // V(i+1) -= H(k, i) * V(k)
+                    blas::axpy(exec, V.column(k), w, -H(k, i));
+                }
+            }
+
+            H(i + 1, i) = blas::nrm2(exec, w);
+            // V(i+1) = V(i+1) / H(i+1, i)
+            blas::scal(exec, w, ValueType(1.0) / H(i + 1, i));
+            blas::copy(exec, w, V.column(i + 1));
+
+            PlaneRotation(H, cs, sn, s, i);
+
+            resid[0] = cusp::abs(s[i + 1]);
+
+            // check convergence condition
+            if (monitor.finished(resid))
+            {
+                break;
+            }
+        }
+        while (i + 1 < R && monitor.iteration_count() + 1 <= monitor.iteration_limit());
+
+        // solve upper triangular system in place
+        for (j = i; j >= 0; j--) {
+            s[j] /= H(j, j);
+            // S(0:j) = s(0:j) - s[j] H(0:j,j)
+            for (k = j - 1; k >= 0; k--) {
+                s[k] -= H(k, j) * s[j];
+            }
+        }
+
+        // update the solution from the preconditioned basis
+        // x = Z(1:N,0:i)*s(0:i)+x
+        for (j = 0; j <= i; j++) {
+            // x = x + s[j] * Z(j)
+            blas::axpy(exec, Z.column(j), x, s[j]);
+        }
+    } while (!monitor.finished(resid));
+}
+
+template <typename DerivedPolicy,
+          typename LinearOperator,
+          typename VectorType1,
+          typename VectorType2,
+          typename Monitor,
+          typename Preconditioner>
+void fgmres(thrust::execution_policy<DerivedPolicy> &exec,
+            const LinearOperator &A,
+                  VectorType1 &x,
+            const VectorType2 &b,
+            const size_t restart,
+                  Monitor &monitor,
+                  Preconditioner &M,
+            const gmres_orthogonalization orthogonalization)
+{
+    typedef typename LinearOperator::value_type ValueType;
+    typedef typename cusp::minimum_space<
+    typename LinearOperator::memory_space, typename VectorType1::memory_space,
+             typename Preconditioner::memory_space>::type MemorySpace;
+
+    const size_t N = A.num_rows;
+    const int R = restart;
+
+    // allocate workspace
+    cusp::detail::temporary_array<ValueType, DerivedPolicy>   w(exec, N);
+    cusp::detail::temporary_array<ValueType, DerivedPolicy>   V0(exec, N);
+    // Arnoldi matrix
+    cusp::array2d<ValueType, MemorySpace, cusp::column_major> V(N, R + 1, ValueType(0.0));
+    // preconditioned basis
+    cusp::array2d<ValueType, MemorySpace, cusp::column_major> Z(N, R, ValueType(0.0));
+
+    cusp::detail::temporary_array<ValueType, DerivedPolicy> sDev(exec, R + 1);
+
+    // HOST WORKSPACE
+    cusp::array2d<ValueType, cusp::host_memory, cusp::column_major> H(R + 1, R);  // Hessenberg matrix
+    cusp::array1d<ValueType, cusp::host_memory> s(R + 1);
+    cusp::array1d<ValueType, cusp::host_memory> cs(R);
+    cusp::array1d<ValueType, cusp::host_memory> sn(R);
+    cusp::array1d<ValueType, cusp::host_memory> resid(1);
+    cusp::array1d<ValueType, cusp::host_memory> h(R + 1);
+
+    fgmres(exec, A, x, b, restart, monitor, M, w, V0, V, Z, sDev, H, s, cs, sn, resid, h, orthogonalization);
+}
+
+template <typename DerivedPolicy,
+          typename LinearOperator,
+          typename VectorType1,
+          typename VectorType2,
+          typename Monitor,
+          typename Preconditioner>
+void fgmres(thrust::execution_policy<DerivedPolicy> &exec,
+            const LinearOperator &A,
+                  VectorType1 &x,
+            const VectorType2 &b,
+            const size_t restart,
+                  Monitor &monitor,
+                  Preconditioner &M)
+{
+    fgmres(exec, A, x, b, restart, monitor, M, modified_gram_schmidt);
+}
+
+}  // end fgmres_detail namespace
+
+template <typename DerivedPolicy,
+          typename LinearOperator,
+          typename VectorType1,
+          typename VectorType2,
+          typename Monitor,
+          typename Preconditioner>
+void fgmres(const thrust::detail::execution_policy_base<DerivedPolicy> &exec,
+            const LinearOperator &A,
+                  VectorType1 &x,
+            const VectorType2 &b,
+            const size_t restart,
+                  Monitor &monitor,
+                  Preconditioner &M)
+{
+    using cusp::krylov::fgmres_detail::fgmres;
+
+    return fgmres(thrust::detail::derived_cast(thrust::detail::strip_const(exec)), A, x, b, restart, monitor, M);
+}
+
+template <typename DerivedPolicy,
+          typename LinearOperator,
+          typename VectorType1,
+          typename VectorType2,
+          typename Monitor,
+          typename Preconditioner>
+void fgmres(const thrust::detail::execution_policy_base<DerivedPolicy> &exec,
+            const LinearOperator &A,
+                  VectorType1 &x,
+            const VectorType2 &b,
+            const size_t restart,
+                  Monitor &monitor,
+                  Preconditioner &M,
+            const gmres_orthogonalization orthogonalization)
+{
+    using cusp::krylov::fgmres_detail::fgmres;
+
+    return fgmres(thrust::detail::derived_cast(thrust::detail::strip_const(exec)), A, x, b, restart, monitor, M, orthogonalization);
+}
+
+template <typename LinearOperator,
+          typename VectorType1,
+          typename VectorType2,
+          typename Monitor,
+          typename Preconditioner>
+void fgmres(const LinearOperator &A,
+                  VectorType1 &x,
+            const VectorType2 &b,
+            const size_t restart,
+                  Monitor &monitor,
+                  Preconditioner &M)
+{
+    using thrust::system::detail::generic::select_system;
+
+    typedef typename LinearOperator::memory_space System1;
+    typedef typename VectorType1::memory_space System2;
+
+    System1 system1;
+    System2 system2;
+
+    return cusp::krylov::fgmres(select_system(system1, system2), A, x, b, restart, monitor, M);
+}
+
+template <typename LinearOperator,
+          typename VectorType1,
+          typename VectorType2,
+          typename Monitor,
+          typename Preconditioner>
+void fgmres(const LinearOperator &A,
+                  VectorType1 &x,
+            const VectorType2 &b,
+            const size_t restart,
+                  Monitor &monitor,
+                  Preconditioner &M,
+            const gmres_orthogonalization orthogonalization)
+{
+    using thrust::system::detail::generic::select_system;
+
+    typedef typename LinearOperator::memory_space System1;
+    typedef typename VectorType1::memory_space System2;
+
+    System1 system1;
+    System2 system2;
+
+    return cusp::krylov::fgmres(select_system(system1, system2), A, x, b, restart, monitor, M, orthogonalization);
+}
+
+template <typename LinearOperator,
+          typename VectorType1,
+          typename VectorType2,
+          typename Monitor>
+void fgmres(const LinearOperator &A,
+                  VectorType1 &x,
+            const VectorType2 &b,
+            const size_t restart,
+                  Monitor &monitor)
+{
+    typedef typename LinearOperator::value_type ValueType;
+    typedef typename LinearOperator::memory_space MemorySpace;
+
+    cusp::identity_operator<ValueType, MemorySpace> M(A.num_rows, A.num_cols);
+
+    return cusp::krylov::fgmres(A, x, b, restart, monitor, M);
+}
+
+template <typename LinearOperator,
+          typename VectorType1,
+          typename VectorType2>
+void fgmres(const LinearOperator &A,
+                  VectorType1 &x,
+            const VectorType2 &b,
+            const size_t restart)
+{
+    typedef typename LinearOperator::value_type ValueType;
+
+    cusp::monitor<ValueType> monitor(b);
+
+    return cusp::krylov::fgmres(A, x, b, restart, monitor);
+}
+
+}  // end namespace krylov
+}  // end namespace cusp
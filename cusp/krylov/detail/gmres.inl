@@ -16,6 +16,7 @@
 
 #include <cusp/array1d.h>
 #include <cusp/complex.h>
+#include <cusp/functional.h>
 #include <cusp/linear_operator.h>
 #include <cusp/monitor.h>
 #include <cusp/multiply.h>
@@ -24,6 +25,12 @@
 
 #include <cusp/detail/temporary_array.h>
 
+#include <thrust/for_each.h>
+#include <thrust/reduce.h>
+#include <thrust/iterator/counting_iterator.h>
+#include <thrust/iterator/discard_iterator.h>
+#include <thrust/iterator/transform_iterator.h>
+
 namespace blas = cusp::blas;
 
 namespace cusp
@@ -71,6 +78,89 @@ void GeneratePlaneRotation(const ValueType1& dx,
     }
 }
 
+// h(j) <- <V(:,j), w>, one term per entry of [0, (i+1)*N)
+template <typename ValueType>
+struct projection_functor
+{
+    const ValueType* V;
+    const ValueType* w;
+    size_t N;
+    size_t pitch;
+
+    projection_functor(const ValueType* V, const ValueType* w, size_t N, size_t pitch)
+        : V(V), w(w), N(N), pitch(pitch) {}
+
+    __host__ __device__
+    ValueType operator()(const size_t n) const
+    {
+        const size_t j = n / N;
+        const size_t k = n % N;
+
+        return cusp::conj(V[j * pitch + k]) * w[k];
+    }
+};
+
+// w(k) <- w(k) - sum_j V(k,j) * h(j)
+template <typename ValueType>
+struct correction_functor
+{
+    const ValueType* V;
+    const ValueType* h;
+    ValueType* w;
+    size_t num_vectors;
+    size_t pitch;
+
+    correction_functor(const ValueType* V, const ValueType* h, ValueType* w, size_t num_vectors, size_t pitch)
+        : V(V), h(h), w(w), num_vectors(num_vectors), pitch(pitch) {}
+
+    __host__ __device__
+    void operator()(const size_t k) const
+    {
+        ValueType sum = w[k];
+
+        for (size_t j = 0; j < num_vectors; j++)
+            sum -= V[j * pitch + k] * h[j];
+
+        w[k] = sum;
+    }
+};
+
+// One classical Gram-Schmidt pass against the first num_vectors columns of V,
+// h <- V^H w followed by w <- w - V h
+template <typename DerivedPolicy,
+          typename Array2dType,
+          typename ArrayType>
+void ClassicalGramSchmidt(thrust::execution_policy<DerivedPolicy> &exec,
+                          const Array2dType &V,
+                                ArrayType &w,
+                                ArrayType &h,
+                          const size_t num_vectors)
+{
+    typedef typename Array2dType::value_type ValueType;
+
+    const size_t N = w.size();
+
+    thrust::reduce_by_key(exec,
+                          thrust::make_transform_iterator(thrust::counting_iterator<size_t>(0), cusp::divide_value<size_t>(N)),
+                          thrust::make_transform_iterator(thrust::counting_iterator<size_t>(num_vectors * N), cusp::divide_value<size_t>(N)),
+                          thrust::make_transform_iterator(thrust::counting_iterator<size_t>(0),
+                                                          projection_functor<ValueType>(thrust::raw_pointer_cast(&V.values[0]),
+                                                                                        thrust::raw_pointer_cast(&w[0]), N, V.pitch)),
+                          thrust::make_discard_iterator(),
+                          h.begin());
+
+    // sum the projections over the processes of exec
+    cusp::array1d_view<typename ArrayType::iterator> projections(h.begin(), h.begin() + num_vectors);
+    cusp::blas::allreduce(exec, projections);
+
+    thrust::for_each(exec,
+                     thrust::counting_iterator<size_t>(0),
+                     thrust::counting_iterator<size_t>(N),
+                     correction_functor<ValueType>(thrust::raw_pointer_cast(&V.values[0]),
+                                                   thrust::raw_pointer_cast(&h[0]),
+                                                   thrust::raw_pointer_cast(&w[0]), num_vectors, V.pitch));
+}
+
 template <typename LinearOperator,
           typename VectorType1,
           typename VectorType2,
@@ -95,45 +185,40 @@ template <typename DerivedPolicy,
           typename VectorType1,
           typename VectorType2,
           typename Monitor,
-          typename Preconditioner>
+          typename Preconditioner,
+          typename ArrayType1,
+          typename Array2dType1,
+          typename Array2dType2,
+          typename ArrayType2>
 void gmres(thrust::execution_policy<DerivedPolicy> &exec,
            const LinearOperator &A,
                  VectorType1 &x,
            const VectorType2 &b,
            const size_t restart,
                  Monitor &monitor,
-                 Preconditioner &M)
+                 Preconditioner &M,
+                 ArrayType1 &w,
+                 ArrayType1 &V0,
+                 Array2dType1 &V,
+                 ArrayType1 &sDev,
+                 Array2dType2 &H,
+                 ArrayType2 &s,
+                 ArrayType2 &cs,
+                 ArrayType2 &sn,
+                 ArrayType2 &resid,
+                 ArrayType2 &h,
+           const gmres_orthogonalization orthogonalization)
 {
     typedef typename LinearOperator::value_type ValueType;
     typedef typename cusp::norm_type<ValueType>::type NormType;
-    typedef typename cusp::minimum_space<
-    typename LinearOperator::memory_space, typename VectorType1::memory_space,
-             typename Preconditioner::memory_space>::type MemorySpace;
 
     assert(A.num_rows == A.num_cols);  // sanity check
 
-    const size_t N = A.num_rows;
     const int R = restart;
     int i, j, k;
     NormType beta = 0;
 
-    // allocate workspace
-    cusp::detail::temporary_array<ValueType, DerivedPolicy>   w(exec, N);
-    // Arnoldi matrix pos 0
-    cusp::detail::temporary_array<ValueType, DerivedPolicy>   V0(exec, N);
-    // Arnoldi matrix
-    cusp::array2d<ValueType, MemorySpace, cusp::column_major> V(N, R + 1, ValueType(0.0));
-
-    // duplicate copy of s on GPU
-    cusp::detail::temporary_array<ValueType, DerivedPolicy> sDev(exec, R + 1);
-
-    // HOST WORKSPACE
     cusp::host_memory host_exec;
-    cusp::array2d<ValueType, cusp::host_memory, cusp::column_major> H(R + 1, R);  // Hessenberg matrix
-    cusp::array1d<ValueType, cusp::host_memory> s(R + 1);
-    cusp::array1d<ValueType, cusp::host_memory> cs(R);
-    cusp::array1d<ValueType, cusp::host_memory> sn(R);
-    cusp::array1d<ValueType, cusp::host_memory> resid(1);
 
     do
     {
@@ -166,12 +251,31 @@ void gmres(thrust::execution_policy<DerivedPolicy> &exec,
             // V(i+1) = A*w = M*A*V(i)
             cusp::multiply(exec, M, V0, w);
 
-            for (k = 0; k <= i; k++)
+            if (orthogonalization == classical_gram_schmidt)
+            {
+                // H(0:i,i) = V(0:i)^H V(i+1), V(i+1) -= V(0:i) H(0:i,i)
+                ClassicalGramSchmidt(exec, V, w, sDev, i + 1);
+                blas::copy(sDev, h);
+
+                for (k = 0; k <= i; k++)
+                    H(k, i) = h[k];
+
+                // reorthogonalize to recover the lost orthogonality
+                ClassicalGramSchmidt(exec, V, w, sDev, i + 1);
+                blas::copy(sDev, h);
+
+                for (k = 0; k <= i; k++)
+                    H(k, i) += h[k];
+            }
+            else
             {
-                //  H(k,i) = <V(i+1),V(k)>
-                H(k, i) = blas::dotc(exec, V.column(k), w);
-                // V(i+1) -= H(k, i) * V(k)
-                blas::axpy(exec, V.column(k), w, -H(k, i));
+                for (k = 0; k <= i; k++)
+                {
+                    //  H(k,i) = <V(i+1),V(k)>
+                    H(k, i) = blas::dotc(exec, V.column(k), w);
+                    // V(i+1) -= H(k, i) * V(k)
+                    blas::axpy(exec, V.column(k), w, -H(k, i));
+                }
             }
 
             H(i + 1, i) = blas::nrm2(exec, w);
@@ -212,6 +316,67 @@ void gmres(thrust::execution_policy<DerivedPolicy> &exec,
     } while (!monitor.finished(resid));
 }
 
+template <typename DerivedPolicy,
+          typename LinearOperator,
+          typename VectorType1,
+          typename VectorType2,
+          typename Monitor,
+          typename Preconditioner>
+void gmres(thrust::execution_policy<DerivedPolicy> &exec,
+           const LinearOperator &A,
+                 VectorType1 &x,
+           const VectorType2 &b,
+           const size_t restart,
+                 Monitor &monitor,
+                 Preconditioner &M,
+           const gmres_orthogonalization orthogonalization)
+{
+    typedef typename LinearOperator::value_type ValueType;
+    typedef typename cusp::minimum_space<
+    typename LinearOperator::memory_space, typename VectorType1::memory_space,
+             typename Preconditioner::memory_space>::type MemorySpace;
+
+    const size_t N = A.num_rows;
+    const int R = restart;
+
+    // allocate workspace
+    cusp::detail::temporary_array<ValueType, DerivedPolicy>   w(exec, N);
+    // Arnoldi matrix pos 0
+    cusp::detail::temporary_array<ValueType, DerivedPolicy>   V0(exec, N);
+    // Arnoldi matrix
+    cusp::array2d<ValueType, MemorySpace, cusp::column_major> V(N, R + 1, ValueType(0.0));
+
+    // duplicate copy of s on GPU
+    cusp::detail::temporary_array<ValueType, DerivedPolicy> sDev(exec, R + 1);
+
+    // HOST WORKSPACE
+    cusp::array2d<ValueType, cusp::host_memory, cusp::column_major> H(R + 1, R);  // Hessenberg matrix
+    cusp::array1d<ValueType, cusp::host_memory> s(R + 1);
+    cusp::array1d<ValueType, cusp::host_memory> cs(R);
+    cusp::array1d<ValueType, cusp::host_memory> sn(R);
+    cusp::array1d<ValueType, cusp::host_memory> resid(1);
+    cusp::array1d<ValueType, cusp::host_memory> h(R + 1);
+
+    gmres(exec, A, x, b, restart, monitor, M, w, V0, V, sDev, H, s, cs, sn, resid, h, orthogonalization);
+}
+
+template <typename DerivedPolicy,
+          typename LinearOperator,
+          typename VectorType1,
+          typename VectorType2,
+          typename Monitor,
+          typename Preconditioner>
+void gmres(thrust::execution_policy<DerivedPolicy> &exec,
+           const LinearOperator &A,
+                 VectorType1 &x,
+           const VectorType2 &b,
+           const size_t restart,
+                 Monitor &monitor,
+                 Preconditioner &M)
+{
+    gmres(exec, A, x, b, restart, monitor, M, modified_gram_schmidt);
+}
+
 }  // end gmres_detail namespace
 
 template <typename DerivedPolicy,
@@ -233,6 +398,26 @@ void gmres(const thrust::detail::execution_policy_base<DerivedPolicy> &exec,
     return gmres(thrust::detail::derived_cast(thrust::detail::strip_const(exec)), A, x, b, restart, monitor, M);
 }
 
+template <typename DerivedPolicy,
+          typename LinearOperator,
+          typename VectorType1,
+          typename VectorType2,
+          typename Monitor,
+          typename Preconditioner>
+void gmres(const thrust::detail::execution_policy_base<DerivedPolicy> &exec,
+           const LinearOperator &A,
+                 VectorType1 &x,
+           const VectorType2 &b,
+           const size_t restart,
+                 Monitor &monitor,
+                 Preconditioner &M,
+           const gmres_orthogonalization orthogonalization)
+{
+    using cusp::krylov::gmres_detail::gmres;
+
+    return gmres(thrust::detail::derived_cast(thrust::detail::strip_const(exec)), A, x, b, restart, monitor, M, orthogonalization);
+}
+
 template <typename LinearOperator,
           typename VectorType1,
           typename VectorType2,
@@ -256,6 +441,30 @@ void gmres(const LinearOperator &A,
     return cusp::krylov::gmres(select_system(system1, system2), A, x, b, restart, monitor, M);
 }
 
+template <typename LinearOperator,
+          typename VectorType1,
+          typename VectorType2,
+          typename Monitor,
+          typename Preconditioner>
+void gmres(const LinearOperator &A,
+                 VectorType1 &x,
+           const VectorType2 &b,
+           const size_t restart,
+                 Monitor &monitor,
+                 Preconditioner &M,
+           const gmres_orthogonalization orthogonalization)
+{
+    using thrust::system::detail::generic::select_system;
+
+    typedef typename LinearOperator::memory_space System1;
+    typedef typename VectorType1::memory_space System2;
+
+    System1 system1;
+    System2 system2;
+
+    return cusp::krylov::gmres(select_system(system1, system2), A, x, b, restart, monitor, M, orthogonalization);
+}
+
 template <typename LinearOperator,
           typename VectorType1,
           typename VectorType2,
@@ -289,6 +498,122 @@ void gmres(const LinearOperator &A,
     return cusp::krylov::gmres(A, x, b, restart, monitor);
 }
 
+//////////////////
+// gmres_solver //
+//////////////////
+
+template <typename ValueType, typename MemorySpace>
+gmres_solver<ValueType,MemorySpace>
+::gmres_solver(const size_t N, const size_t restart,
+               const gmres_orthogonalization orthogonalization)
+    : orthogonalization(orthogonalization)
+{
+    resize(N, restart);
+}
+
+template <typename ValueType, typename MemorySpace>
+void
+gmres_solver<ValueType,MemorySpace>
+::resize(const size_t N, const size_t restart)
+{
+    w.resize(N);
+    V0.resize(N);
+    V.resize(N, restart + 1);
+    sDev.resize(restart + 1);
+
+    H.resize(restart + 1, restart);
+    s.resize(restart + 1);
+    cs.resize(restart);
+    sn.resize(restart);
+    resid.resize(1);
+    h.resize(restart + 1);
+}
+
+template <typename ValueType, typename MemorySpace>
+template <typename DerivedPolicy,
+          typename LinearOperator,
+          typename VectorType1,
+          typename VectorType2,
+          typename Monitor,
+          typename Preconditioner>
+void
+gmres_solver<ValueType,MemorySpace>
+::solve(const thrust::detail::execution_policy_base<DerivedPolicy> &exec,
+        const LinearOperator &A,
+              VectorType1 &x,
+        const VectorType2 &b,
+        const size_t restart,
+              Monitor &monitor,
+              Preconditioner &M)
+{
+    using cusp::krylov::gmres_detail::gmres;
+
+    resize(A.num_rows, restart);
+
+    gmres(thrust::detail::derived_cast(thrust::detail::strip_const(exec)), A, x, b, restart, monitor, M,
+          w, V0, V, sDev, H, s, cs, sn, resid, h, orthogonalization);
+}
+
+template <typename ValueType, typename MemorySpace>
+template <typename LinearOperator,
+          typename VectorType1,
+          typename VectorType2,
+          typename Monitor,
+          typename Preconditioner>
+void
+gmres_solver<ValueType,MemorySpace>
+::solve(const LinearOperator &A,
+              VectorType1 &x,
+        const VectorType2 &b,
+        const size_t restart,
+              Monitor &monitor,
+              Preconditioner &M)
+{
+    using thrust::system::detail::generic::select_system;
+
+    typedef typename LinearOperator::memory_space System1;
+    typedef typename VectorType1::memory_space System2;
+
+    System1 system1;
+    System2 system2;
+
+    solve(select_system(system1, system2), A, x, b, restart, monitor, M);
+}
+
+template <typename ValueType, typename MemorySpace>
+template <typename LinearOperator,
+          typename VectorType1,
+          typename VectorType2,
+          typename Monitor>
+void
+gmres_solver<ValueType,MemorySpace>
+::solve(const LinearOperator &A,
+              VectorType1 &x,
+        const VectorType2 &b,
+        const size_t restart,
+              Monitor &monitor)
+{
+    cusp::identity_operator<ValueType, MemorySpace> M(A.num_rows, A.num_cols);
+
+    solve(A, x, b, restart, monitor, M);
+}
+
+template <typename ValueType, typename MemorySpace>
+template <typename LinearOperator,
+          typename VectorType1,
+          typename VectorType2>
+void
+gmres_solver<ValueType,MemorySpace>
+::solve(const LinearOperator &A,
+              VectorType1 &x,
+        const VectorType2 &b,
+        const size_t restart)
+{
+    cusp::monitor<ValueType> monitor(b);
+
+    solve(A, x, b, restart, monitor);
+}
+
 }  // end namespace krylov
 }  // end namespace cusp
 
@@ -0,0 +1,387 @@
+/*
+ *  Copyright 2011 The Regents of the University of California
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include <cusp/array1d.h>
+#include <cusp/array2d.h>
+#include <cusp/complex.h>
+#include <cusp/copy.h>
+#include <cusp/exception.h>
+#include <cusp/linear_operator.h>
+#include <cusp/monitor.h>
+#include <cusp/multiply.h>
+
+#include <cusp/blas/blas.h>
+
+#include <cusp/detail/temporary_array.h>
+
+#include <thrust/copy.h>
+#include <thrust/for_each.h>
+#include <thrust/tuple.h>
+#include <thrust/iterator/counting_iterator.h>
+
+namespace blas = cusp::blas;
+
+namespace cusp
+{
+namespace krylov
+{
+namespace idr_detail
+{
+
+// w <- w + V(:,first:first+count) h for a column-major V
+template <typename ValueType>
+struct combine_functor
+{
+    const ValueType* V;
+    const ValueType* h;
+    ValueType* w;
+    size_t first;
+    size_t count;
+    size_t pitch;
+
+    combine_functor(const ValueType* V, const ValueType* h, ValueType* w,
+                    size_t first, size_t count, size_t pitch)
+        : V(V), h(h), w(w), first(first), count(count), pitch(pitch) {}
+
+    __host__ __device__
+    void operator()(const size_t k) const
+    {
+        ValueType sum = w[k];
+
+        for (size_t j = 0; j < count; j++)
+            sum += V[(first + j) * pitch + k] * h[j];
+
+        w[k] = sum;
+    }
+};
+
+// Adds count columns of V starting at first, weighted by the host
+// coefficients h, to w
+template <typename DerivedPolicy,
+          typename Array2dType,
+          typename ArrayType1,
+          typename ArrayType2,
+          typename ArrayType3>
+void combine(thrust::execution_policy<DerivedPolicy> &exec,
+             const Array2dType& V,
+             const size_t first,
+             const size_t count,
+             const ArrayType1& h,
+                   ArrayType2& h_device,
+                   ArrayType3& w)
+{
+    typedef typename Array2dType::value_type ValueType;
+
+    if (count == 0)
+        return;
+
+    thrust::copy(h.begin(), h.begin() + count, h_device.begin());
+
+    thrust::for_each(exec,
+                     thrust::counting_iterator<size_t>(0),
+                     thrust::counting_iterator<size_t>(w.size()),
+                     combine_functor<ValueType>(thrust::raw_pointer_cast(&V.values[0]),
+                                                thrust::raw_pointer_cast(&h_device[0]),
+                                                thrust::raw_pointer_cast(&w[0]),
+                                                first, count, V.pitch));
+}
+
+// h(j) <- <P(:,j), w> for all shadow vectors in a single reduction
+template <typename DerivedPolicy,
+          typename Array2dType,
+          typename ArrayType1,
+          typename ArrayType2>
+void project(thrust::execution_policy<DerivedPolicy> &exec,
+             const Array2dType& P,
+             const ArrayType1& w,
+                   ArrayType2& h)
+{
+    blas::dotcs(exec, w, P, h);
+
+    // dotcs conjugates w, the projection conjugates P
+    for (size_t j = 0; j < h.size(); j++)
+        h[j] = cusp::conj(h[j]);
+}
+
+template <typename DerivedPolicy,
+          typename LinearOperator,
+          typename VectorType1,
+          typename VectorType2,
+          typename Monitor,
+          typename Preconditioner>
+void idr(thrust::execution_policy<DerivedPolicy> &exec,
+         const LinearOperator& A,
+               VectorType1& x,
+         const VectorType2& b,
+         const size_t s,
+               Monitor& monitor,
+               Preconditioner& M)
+{
+    typedef typename LinearOperator::value_type                        ValueType;
+    typedef typename cusp::norm_type<ValueType>::type                  NormType;
+    typedef typename cusp::minimum_space<
+              typename LinearOperator::memory_space,
+              typename VectorType1::memory_space,
+              typename Preconditioner::memory_space>::type             MemorySpace;
+    typedef cusp::array2d<ValueType, MemorySpace, cusp::column_major> Block;
+    typedef typename Block::column_view                                Column;
+
+    assert(A.num_rows == A.num_cols);        // sanity check
+
+    const size_t N = A.num_rows;
+
+    if (s == 0 || s > N)
+        throw cusp::invalid_input_exception("idr: shadow space dimension must lie in [1, N]");
+
+    // minimum angle between A v and r accepted for omega
+    const NormType kappa(0.7);
+
+    // allocate workspace
+    cusp::detail::temporary_array<ValueType, DerivedPolicy> r(exec, N);
+    cusp::detail::temporary_array<ValueType, DerivedPolicy> v(exec, N);
+    cusp::detail::temporary_array<ValueType, DerivedPolicy> z(exec, N);
+    cusp::detail::temporary_array<ValueType, DerivedPolicy> t(exec, N);
+    cusp::detail::temporary_array<ValueType, DerivedPolicy> g(exec, N);
+    cusp::detail::temporary_array<ValueType, DerivedPolicy> h_device(exec, s);
+
+    // shadow space, and the bases of G and U = M^{-1} G
+    Block P(N, s);
+    Block G(N, s, ValueType(0));
+    Block U(N, s, ValueType(0));
+
+    // HOST WORKSPACE
+    // PG(i,j) = <P(:,i), G(:,j)> is lower triangular by construction
+    cusp::array2d<ValueType, cusp::host_memory> PG(s, s, ValueType(0));
+    cusp::array1d<ValueType, cusp::host_memory> f(s);
+    cusp::array1d<ValueType, cusp::host_memory> c(s);
+    cusp::array1d<ValueType, cusp::host_memory> m(s);
+    cusp::array1d<ValueType, cusp::host_memory> alpha(s);
+
+    for (size_t i = 0; i < s; i++)
+        PG(i,i) = ValueType(1);
+
+    // P <- orthonormalized random vectors
+    cusp::copy(cusp::random_array<ValueType>(N * s), P.values);
+
+    for (size_t j = 0; j < s; j++)
+    {
+        Column Pj(P.column(j));
+
+        for (size_t i = 0; i < j; i++)
+        {
+            Column Pi(P.column(i));
+            blas::axpy(exec, Pi, Pj, -blas::dotc(exec, Pi, Pj));
+        }
+
+        blas::scal(exec, Pj, ValueType(NormType(1) / blas::nrm2(exec, Pj)));
+    }
+
+    // r <- b - A*x
+    cusp::multiply(exec, A, x, t);
+    blas::axpby(exec, b, t, r, ValueType(1), ValueType(-1));
+
+    ValueType omega(1);
+
+    bool done = monitor.finished(exec, r);
+
+    while (!done)
+    {
+        // f <- P^H r
+        project(exec, P, r, f);
+
+        for (size_t k = 0; k < s && !done; k++)
+        {
+            // solve PG(k:s,k:s) c = f(k:s)
+            for (size_t i = k; i < s; i++)
+            {
+                ValueType sum = f[i];
+
+                for (size_t j = k; j < i; j++)
+                    sum -= PG(i,j) * c[j - k];
+
+                c[i - k] = sum / PG(i,i);
+            }
+
+            // v <- r - G(:,k:s) c
+            blas::copy(exec, r, v);
+
+            for (size_t i = 0; i < s - k; i++)
+                alpha[i] = -c[i];
+
+            combine(exec, G, k, s - k, alpha, h_device, v);
+
+            // z <- M*v
+            cusp::multiply(exec, M, v, z);
+
+            // t <- omega z + U(:,k:s) c
+            blas::copy(exec, z, t);
+            blas::scal(exec, t, omega);
+            combine(exec, U, k, s - k, c, h_device, t);
+
+            // g <- A*t
+            cusp::multiply(exec, A, t, g);
+
+            // biorthogonalize g against P(:,0:k) with a single reduction
+            project(exec, P, g, m);
+
+            for (size_t i = 0; i < k; i++)
+            {
+                alpha[i] = m[i] / PG(i,i);
+
+                for (size_t j = i; j < s; j++)
+                    m[j] -= alpha[i] * PG(j,i);
+
+                alpha[i] = -alpha[i];
+            }
+
+            combine(exec, G, 0, k, alpha, h_device, g);
+            combine(exec, U, 0, k, alpha, h_device, t);
+
+            Column Gk(G.column(k));
+            Column Uk(U.column(k));
+            blas::copy(exec, g, Gk);
+            blas::copy(exec, t, Uk);
+
+            for (size_t i = k; i < s; i++)
+                PG(i,k) = m[i];
+
+            // r <- r - beta g, x <- x + beta t
+            ValueType beta = f[k] / PG(k,k);
+            blas::axpy_axpy(exec, g, r, -beta, t, x, beta);
+
+            for (size_t i = k + 1; i < s; i++)
+                f[i] -= beta * PG(i,k);
+
+            ++monitor;
+
+            done = monitor.finished(exec, r);
+        }
+
+        if (done)
+            break;
+
+        // dimension reduction step, z <- M*r and t <- A*z
+        cusp::multiply(exec, M, r, z);
+        cusp::multiply(exec, A, z, t);
+
+        // omega <- <t,r> / <t,t>, enlarged when t and r are nearly orthogonal
+        thrust::tuple<ValueType,NormType> tr_t = blas::dotc_nrm2(exec, t, r);
+        ValueType tr = thrust::get<0>(tr_t);
+        NormType  nt = thrust::get<1>(tr_t);
+        NormType  nr = blas::nrm2(exec, r);
+
+        if (nt == NormType(0) || nr == NormType(0))
+            break;
+
+        omega = tr / ValueType(nt * nt);
+
+        NormType rho = cusp::abs(tr) / (nt * nr);
+
+        if (rho < kappa)
+        {
+            ValueType phase = (rho == NormType(0)) ? ValueType(1) : tr / ValueType(cusp::abs(tr));
+            omega = ValueType(kappa * nr / nt) * phase;
+        }
+
+        // r <- r - omega t, x <- x + omega z
+        blas::axpy_axpy(exec, t, r, -omega, z, x, omega);
+
+        ++monitor;
+
+        done = monitor.finished(exec, r);
+    }
+}
+
+} // end idr_detail namespace
+
+template <typename DerivedPolicy,
+          typename LinearOperator,
+          typename VectorType1,
+          typename VectorType2,
+          typename Monitor,
+          typename Preconditioner>
+void idr(const thrust::detail::execution_policy_base<DerivedPolicy> &exec,
+         const LinearOperator& A,
+               VectorType1& x,
+         const VectorType2& b,
+         const size_t s,
+               Monitor& monitor,
+               Preconditioner& M)
+{
+    using cusp::krylov::idr_detail::idr;
+
+    return idr(thrust::detail::derived_cast(thrust::detail::strip_const(exec)), A, x, b, s, monitor, M);
+}
+
+template <typename LinearOperator,
+          typename VectorType1,
+          typename VectorType2,
+          typename Monitor,
+          typename Preconditioner>
+void idr(const LinearOperator& A,
+               VectorType1& x,
+         const VectorType2& b,
+         const size_t s,
+               Monitor& monitor,
+               Preconditioner& M)
+{
+    using thrust::system::detail::generic::select_system;
+
+    typedef typename LinearOperator::memory_space System1;
+    typedef typename VectorType2::memory_space    System2;
+
+    System1 system1;
+    System2 system2;
+
+    return cusp::krylov::idr(select_system(system1,system2), A, x, b, s, monitor, M);
+}
+
+template <typename LinearOperator,
+          typename VectorType1,
+          typename VectorType2,
+          typename Monitor>
+void idr(const LinearOperator& A,
+               VectorType1& x,
+         const VectorType2& b,
+         const size_t s,
+               Monitor& monitor)
+{
+    typedef typename LinearOperator::value_type   ValueType;
+    typedef typename LinearOperator::memory_space MemorySpace;
+
+    cusp::identity_operator<ValueType,MemorySpace> M(A.num_rows, A.num_cols);
+
+    return cusp::krylov::idr(A, x, b, s, monitor, M);
+}
+
+template <typename LinearOperator,
+          typename VectorType1,
+          typename VectorType2>
+void idr(const LinearOperator& A,
+               VectorType1& x,
+         const VectorType2& b,
+         const size_t s)
+{
+    typedef typename LinearOperator::value_type   ValueType;
+
+    cusp::monitor<ValueType> monitor(b);
+
+    return cusp::krylov::idr(A, x, b, s, monitor);
+}
+
+} // end namespace krylov
+} // end namespace cusp
+
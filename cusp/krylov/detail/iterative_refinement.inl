@@ -0,0 +1,176 @@
+/*
+ *  Copyright 2008-2014 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include <cusp/array1d.h>
+#include <cusp/linear_operator.h>
+#include <cusp/monitor.h>
+#include <cusp/multiply.h>
+
+#include <cusp/blas/blas.h>
+
+#include <cusp/detail/temporary_array.h>
+
+#include <thrust/copy.h>
+
+namespace cusp
+{
+namespace krylov
+{
+namespace iterative_refinement_detail
+{
+
+template <typename DerivedPolicy,
+          typename LinearOperator1,
+          typename VectorType1,
+          typename VectorType2,
+          typename Monitor1,
+          typename LinearOperator2,
+          typename InnerSolver,
+          typename Monitor2,
+          typename Preconditioner>
+void iterative_refinement(thrust::execution_policy<DerivedPolicy> &exec,
+                          const LinearOperator1& A,
+                                VectorType1& x,
+                          const VectorType2& b,
+                                Monitor1& monitor,
+                          const LinearOperator2& A_inner,
+                                InnerSolver& solver,
+                                Monitor2& inner_monitor,
+                                Preconditioner& M)
+{
+    typedef typename LinearOperator1::value_type ValueType;
+    typedef typename LinearOperator2::value_type   InnerValueType;
+    typedef typename LinearOperator2::memory_space InnerMemorySpace;
+
+    assert(A.num_rows == A.num_cols);              // sanity check
+    assert(A_inner.num_rows == A.num_rows);        // sanity check
+
+    const size_t N = A.num_rows;
+
+    // allocate workspace
+    cusp::detail::temporary_array<ValueType, DerivedPolicy> r(exec, N);
+    cusp::detail::temporary_array<ValueType, DerivedPolicy> d(exec, N);
+
+    // the inner solver works on containers of its own precision
+    cusp::array1d<InnerValueType, InnerMemorySpace> r_inner(N);
+    cusp::array1d<InnerValueType, InnerMemorySpace> d_inner(N);
+
+    // r <- b - A*x
+    cusp::multiply(exec, A, x, r);
+    cusp::blas::axpby(exec, b, r, r, ValueType(1), ValueType(-1));
+
+    while (!monitor.finished(exec, r))
+    {
+        // solve A_inner d = r in the inner precision
+        thrust::copy(r.begin(), r.end(), r_inner.begin());
+        cusp::blas::fill(d_inner, InnerValueType(0));
+
+        inner_monitor.reset(r_inner);
+        solver.solve(A_inner, d_inner, r_inner, inner_monitor, M);
+
+        // x <- x + d
+        thrust::copy(d_inner.begin(), d_inner.end(), d.begin());
+        cusp::blas::axpy(exec, d, x, ValueType(1));
+
+        // r <- b - A*x
+        cusp::multiply(exec, A, x, r);
+        cusp::blas::axpby(exec, b, r, r, ValueType(1), ValueType(-1));
+
+        ++monitor;
+    }
+}
+
+} // end iterative_refinement_detail namespace
+
+template <typename DerivedPolicy,
+          typename LinearOperator1,
+          typename VectorType1,
+          typename VectorType2,
+          typename Monitor1,
+          typename LinearOperator2,
+          typename InnerSolver,
+          typename Monitor2,
+          typename Preconditioner>
+void iterative_refinement(const thrust::detail::execution_policy_base<DerivedPolicy> &exec,
+                          const LinearOperator1& A,
+                                VectorType1& x,
+                          const VectorType2& b,
+                                Monitor1& monitor,
+                          const LinearOperator2& A_inner,
+                                InnerSolver& solver,
+                                Monitor2& inner_monitor,
+                                Preconditioner& M)
+{
+    using cusp::krylov::iterative_refinement_detail::iterative_refinement;
+
+    return iterative_refinement(thrust::detail::derived_cast(thrust::detail::strip_const(exec)),
+                                A, x, b, monitor, A_inner, solver, inner_monitor, M);
+}
+
+template <typename LinearOperator1,
+          typename VectorType1,
+          typename VectorType2,
+          typename Monitor1,
+          typename LinearOperator2,
+          typename InnerSolver,
+          typename Monitor2,
+          typename Preconditioner>
+void iterative_refinement(const LinearOperator1& A,
+                                VectorType1& x,
+                          const VectorType2& b,
+                                Monitor1& monitor,
+                          const LinearOperator2& A_inner,
+                                InnerSolver& solver,
+                                Monitor2& inner_monitor,
+                                Preconditioner& M)
+{
+    using thrust::system::detail::generic::select_system;
+
+    typedef typename LinearOperator1::memory_space System1;
+    typedef typename VectorType1::memory_space     System2;
+
+    System1 system1;
+    System2 system2;
+
+    return cusp::krylov::iterative_refinement(select_system(system1,system2),
+                                              A, x, b, monitor, A_inner, solver, inner_monitor, M);
+}
+
+template <typename LinearOperator1,
+          typename VectorType1,
+          typename VectorType2,
+          typename Monitor1,
+          typename LinearOperator2,
+          typename InnerSolver,
+          typename Monitor2>
+void iterative_refinement(const LinearOperator1& A,
+                                VectorType1& x,
+                          const VectorType2& b,
+                                Monitor1& monitor,
+                          const LinearOperator2& A_inner,
+                                InnerSolver& solver,
+                                Monitor2& inner_monitor)
+{
+    typedef typename LinearOperator2::value_type   ValueType;
+    typedef typename LinearOperator2::memory_space MemorySpace;
+
+    cusp::identity_operator<ValueType,MemorySpace> M(A_inner.num_rows, A_inner.num_cols);
+
+    return cusp::krylov::iterative_refinement(A, x, b, monitor, A_inner, solver, inner_monitor, M);
+}
+
+} // end namespace krylov
+} // end namespace cusp
@@ -0,0 +1,67 @@
+/*
+ *  Copyright 2008-2014 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#pragma once
+
+#include <cusp/detail/config.h>
+#include <cusp/detail/format.h>
+
+#include <cusp/complex.h>
+#include <cusp/exception.h>
+
+#include <thrust/detail/type_traits.h>
+
+namespace cusp
+{
+namespace krylov
+{
+namespace multi_mass_detail
+{
+
+// The shifted solutions of CG-M and BiCGStab-M are stored either in an
+// array1d of N * N_s entries or in the columns of an N-by-N_s column-major
+// array2d; both layouts hold the solution of shift i in [i * N, (i + 1) * N)
+template <typename Array1d>
+Array1d& shifted_solutions(Array1d& x, const size_t N, const size_t N_s, cusp::array1d_format)
+{
+    return x;
+}
+
+template <typename Array2d>
+typename Array2d::values_array_type&
+shifted_solutions(Array2d& x, const size_t N, const size_t N_s, cusp::array2d_format)
+{
+    const bool column_major =
+        thrust::detail::is_same<typename Array2d::orientation, cusp::column_major>::value;
+
+    if(!column_major || x.num_rows != N || x.num_cols != N_s || size_t(x.pitch) != N)
+        throw cusp::invalid_input_exception("shifted solutions must be stored in an N-by-N_s column-major array2d");
+
+    return x.values;
+}
+
+// shifts whose residual, a known multiple of the unshifted residual, has
+// reached the tolerance are frozen and skipped by the per-shift kernels
+template <typename ScalarType, typename NormType>
+__host__ __device__
+bool shift_converged(const ScalarType scale, const NormType residual_norm, const NormType tolerance)
+{
+    return cusp::abs(scale) * residual_norm <= tolerance;
+}
+
+} // end namespace multi_mass_detail
+} // end namespace krylov
+} // end namespace cusp
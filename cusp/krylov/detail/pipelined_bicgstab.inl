@@ -0,0 +1,388 @@
+/*
+ *  Copyright 2008-2014 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include <cusp/array1d.h>
+#include <cusp/complex.h>
+#include <cusp/linear_operator.h>
+#include <cusp/multiply.h>
+#include <cusp/monitor.h>
+
+#include <cusp/detail/temporary_array.h>
+
+#include <cusp/blas/blas.h>
+
+#include <thrust/for_each.h>
+#include <thrust/transform_reduce.h>
+#include <thrust/tuple.h>
+#include <thrust/iterator/zip_iterator.h>
+
+namespace cusp
+{
+namespace krylov
+{
+namespace bicg_detail
+{
+
+// Notation: u = M r, w = A u, wh = M w, t = A wh, ph = M p, s = A ph,
+// sh = M s, z = A sh, zh = M z, v = A zh, qh = M q and y = A qh, where q
+// corresponds to s in bicgstab.
+
+// updates (u, wh, ph, sh, zh, qh)
+template <typename ValueType>
+struct pipelined_bicgstab_direction
+{
+    ValueType alpha;
+    ValueType beta;
+    ValueType omega;
+
+    pipelined_bicgstab_direction(ValueType _alpha, ValueType _beta, ValueType _omega)
+        : alpha(_alpha), beta(_beta), omega(_omega) {}
+
+    template <typename Tuple>
+    __host__ __device__
+    void operator()(Tuple t)
+    {
+        const ValueType u  = thrust::get<0>(t);
+        const ValueType sh = thrust::get<3>(t);
+
+        // ph <- u + beta*(ph - omega*sh), sh <- wh + beta*(sh - omega*zh)
+        const ValueType ph_new = u + beta * (ValueType(thrust::get<2>(t)) - omega * sh);
+        const ValueType sh_new = ValueType(thrust::get<1>(t)) + beta * (sh - omega * ValueType(thrust::get<4>(t)));
+
+        thrust::get<2>(t) = ph_new;
+        thrust::get<3>(t) = sh_new;
+
+        // qh <- u - alpha*sh
+        thrust::get<5>(t) = u - alpha * sh_new;
+    }
+};
+
+// updates (w, t, s, z, v, r, q, y) and returns ((y,q), (y,y))
+template <typename ValueType>
+struct pipelined_bicgstab_stabilize
+{
+    ValueType alpha;
+    ValueType beta;
+    ValueType omega;
+
+    pipelined_bicgstab_stabilize(ValueType _alpha, ValueType _beta, ValueType _omega)
+        : alpha(_alpha), beta(_beta), omega(_omega) {}
+
+    template <typename Tuple>
+    __host__ __device__
+    thrust::tuple<ValueType,ValueType> operator()(Tuple t)
+    {
+        const ValueType w = thrust::get<0>(t);
+        const ValueType z = thrust::get<3>(t);
+
+        // s <- w + beta*(s - omega*z), z <- t + beta*(z - omega*v)
+        const ValueType s_new = w + beta * (ValueType(thrust::get<2>(t)) - omega * z);
+        const ValueType z_new = ValueType(thrust::get<1>(t)) + beta * (z - omega * ValueType(thrust::get<4>(t)));
+
+        // q <- r - alpha*s, y <- w - alpha*z
+        const ValueType q = ValueType(thrust::get<5>(t)) - alpha * s_new;
+        const ValueType y = w - alpha * z_new;
+
+        thrust::get<2>(t) = s_new;
+        thrust::get<3>(t) = z_new;
+        thrust::get<6>(t) = q;
+        thrust::get<7>(t) = y;
+
+        return thrust::make_tuple(cusp::conj(y) * q, cusp::conj(y) * y);
+    }
+};
+
+// updates (x, ph, qh, u, wh, zh)
+template <typename ValueType>
+struct pipelined_bicgstab_solution
+{
+    ValueType alpha;
+    ValueType omega;
+
+    pipelined_bicgstab_solution(ValueType _alpha, ValueType _omega)
+        : alpha(_alpha), omega(_omega) {}
+
+    template <typename Tuple>
+    __host__ __device__
+    void operator()(Tuple t)
+    {
+        const ValueType qh = thrust::get<2>(t);
+
+        // x <- x + alpha*ph + omega*qh
+        thrust::get<0>(t) = ValueType(thrust::get<0>(t)) + alpha * ValueType(thrust::get<1>(t)) + omega * qh;
+
+        // u <- qh - omega*(wh - alpha*zh)
+        thrust::get<3>(t) = qh - omega * (ValueType(thrust::get<4>(t)) - alpha * ValueType(thrust::get<5>(t)));
+    }
+};
+
+// updates (q, y, r, t, v, w, r_star, s, z) and returns
+// ((r_star,r), (r_star,w), (r_star,s), (r_star,z))
+template <typename ValueType>
+struct pipelined_bicgstab_residual
+{
+    ValueType alpha;
+    ValueType omega;
+
+    pipelined_bicgstab_residual(ValueType _alpha, ValueType _omega)
+        : alpha(_alpha), omega(_omega) {}
+
+    template <typename Tuple>
+    __host__ __device__
+    thrust::tuple<ValueType,ValueType,ValueType,ValueType> operator()(Tuple t)
+    {
+        const ValueType y = thrust::get<1>(t);
+
+        // r <- q - omega*y, w <- y - omega*(t - alpha*v)
+        const ValueType r = ValueType(thrust::get<0>(t)) - omega * y;
+        const ValueType w = y - omega * (ValueType(thrust::get<3>(t)) - alpha * ValueType(thrust::get<4>(t)));
+
+        thrust::get<2>(t) = r;
+        thrust::get<5>(t) = w;
+
+        const ValueType r_star = cusp::conj(ValueType(thrust::get<6>(t)));
+
+        return thrust::make_tuple(r_star * r,
+                                  r_star * w,
+                                  r_star * ValueType(thrust::get<7>(t)),
+                                  r_star * ValueType(thrust::get<8>(t)));
+    }
+};
+
+template <typename ValueType>
+struct pipelined_bicgstab_plus
+{
+    __host__ __device__
+    thrust::tuple<ValueType,ValueType> operator()(const thrust::tuple<ValueType,ValueType>& a,
+                                                  const thrust::tuple<ValueType,ValueType>& b) const
+    {
+        return thrust::make_tuple(thrust::get<0>(a) + thrust::get<0>(b),
+                                  thrust::get<1>(a) + thrust::get<1>(b));
+    }
+
+    __host__ __device__
+    thrust::tuple<ValueType,ValueType,ValueType,ValueType>
+    operator()(const thrust::tuple<ValueType,ValueType,ValueType,ValueType>& a,
+               const thrust::tuple<ValueType,ValueType,ValueType,ValueType>& b) const
+    {
+        return thrust::make_tuple(thrust::get<0>(a) + thrust::get<0>(b),
+                                  thrust::get<1>(a) + thrust::get<1>(b),
+                                  thrust::get<2>(a) + thrust::get<2>(b),
+                                  thrust::get<3>(a) + thrust::get<3>(b));
+    }
+};
+
+template <typename DerivedPolicy,
+          typename LinearOperator,
+          typename VectorType1,
+          typename VectorType2,
+          typename Monitor,
+          typename Preconditioner>
+void pipelined_bicgstab(thrust::execution_policy<DerivedPolicy> &exec,
+                        const LinearOperator& A,
+                              VectorType1& x,
+                        const VectorType2& b,
+                              Monitor& monitor,
+                              Preconditioner& M)
+{
+    typedef typename LinearOperator::value_type                      ValueType;
+    typedef thrust::tuple<ValueType,ValueType>                       DotType2;
+    typedef thrust::tuple<ValueType,ValueType,ValueType,ValueType>   DotType4;
+
+    assert(A.num_rows == A.num_cols);        // sanity check
+
+    const size_t N = A.num_rows;
+
+    // allocate workspace, the search directions start at zero
+    cusp::detail::temporary_array<ValueType, DerivedPolicy>      r(exec, N);
+    cusp::detail::temporary_array<ValueType, DerivedPolicy> r_star(exec, N);
+    cusp::detail::temporary_array<ValueType, DerivedPolicy>      u(exec, N);
+    cusp::detail::temporary_array<ValueType, DerivedPolicy>      w(exec, N);
+    cusp::detail::temporary_array<ValueType, DerivedPolicy>     wh(exec, N);
+    cusp::detail::temporary_array<ValueType, DerivedPolicy>      t(exec, N);
+    cusp::detail::temporary_array<ValueType, DerivedPolicy>      q(exec, N);
+    cusp::detail::temporary_array<ValueType, DerivedPolicy>     qh(exec, N);
+    cusp::detail::temporary_array<ValueType, DerivedPolicy>      y(exec, N);
+    cusp::detail::temporary_array<ValueType, DerivedPolicy>     ph(exec, N, ValueType(0));
+    cusp::detail::temporary_array<ValueType, DerivedPolicy>      s(exec, N, ValueType(0));
+    cusp::detail::temporary_array<ValueType, DerivedPolicy>     sh(exec, N, ValueType(0));
+    cusp::detail::temporary_array<ValueType, DerivedPolicy>      z(exec, N, ValueType(0));
+    cusp::detail::temporary_array<ValueType, DerivedPolicy>     zh(exec, N, ValueType(0));
+    cusp::detail::temporary_array<ValueType, DerivedPolicy>      v(exec, N, ValueType(0));
+
+    // r <- b - A*x
+    cusp::multiply(exec, A, x, w);
+    cusp::blas::axpby(exec, b, w, r, ValueType(1), ValueType(-1));
+
+    // r_star <- r
+    cusp::blas::copy(exec, r, r_star);
+
+    // u <- M*r, w <- A*u, wh <- M*w, t <- A*wh
+    cusp::multiply(exec, M, r, u);
+    cusp::multiply(exec, A, u, w);
+    cusp::multiply(exec, M, w, wh);
+    cusp::multiply(exec, A, wh, t);
+
+    ValueType rho   = cusp::blas::dotc(exec, r_star, r);
+    ValueType alpha = rho / cusp::blas::dotc(exec, r_star, w);
+    ValueType beta(0);
+    ValueType omega(0);
+
+    while (!monitor.finished(exec, r))
+    {
+        // search directions and the intermediate residual q
+        thrust::for_each(exec,
+                         thrust::make_zip_iterator(thrust::make_tuple(u.begin(), wh.begin(), ph.begin(), sh.begin(), zh.begin(), qh.begin())),
+                         thrust::make_zip_iterator(thrust::make_tuple(u.begin(), wh.begin(), ph.begin(), sh.begin(), zh.begin(), qh.begin())) + N,
+                         pipelined_bicgstab_direction<ValueType>(alpha, beta, omega));
+
+        DotType2 dots2 =
+            thrust::transform_reduce(exec,
+                                     thrust::make_zip_iterator(thrust::make_tuple(w.begin(), t.begin(), s.begin(), z.begin(),
+                                                                                  v.begin(), r.begin(), q.begin(), y.begin())),
+                                     thrust::make_zip_iterator(thrust::make_tuple(w.begin(), t.begin(), s.begin(), z.begin(),
+                                                                                  v.begin(), r.begin(), q.begin(), y.begin())) + N,
+                                     pipelined_bicgstab_stabilize<ValueType>(alpha, beta, omega),
+                                     DotType2(ValueType(0), ValueType(0)),
+                                     pipelined_bicgstab_plus<ValueType>());
+
+        // the partial inner products are summed over the processes of exec
+        // while the preconditioner and the operator are applied
+        ValueType sums2[2] = { thrust::get<0>(dots2), thrust::get<1>(dots2) };
+
+        cusp::blas::allreduce_begin(exec, sums2, 2);
+
+        // zh <- M*z, v <- A*zh
+        cusp::multiply(exec, M, z, zh);
+        cusp::multiply(exec, A, zh, v);
+
+        cusp::blas::allreduce_end(exec);
+
+        // omega = (y, q) / (y, y)
+        omega = sums2[0] / sums2[1];
+
+        // solution and the next residual
+        thrust::for_each(exec,
+                         thrust::make_zip_iterator(thrust::make_tuple(x.begin(), ph.begin(), qh.begin(), u.begin(), wh.begin(), zh.begin())),
+                         thrust::make_zip_iterator(thrust::make_tuple(x.begin(), ph.begin(), qh.begin(), u.begin(), wh.begin(), zh.begin())) + N,
+                         pipelined_bicgstab_solution<ValueType>(alpha, omega));
+
+        DotType4 dots4 =
+            thrust::transform_reduce(exec,
+                                     thrust::make_zip_iterator(thrust::make_tuple(q.begin(), y.begin(), r.begin(), t.begin(), v.begin(),
+                                                                                  w.begin(), r_star.begin(), s.begin(), z.begin())),
+                                     thrust::make_zip_iterator(thrust::make_tuple(q.begin(), y.begin(), r.begin(), t.begin(), v.begin(),
+                                                                                  w.begin(), r_star.begin(), s.begin(), z.begin())) + N,
+                                     pipelined_bicgstab_residual<ValueType>(alpha, omega),
+                                     DotType4(ValueType(0), ValueType(0), ValueType(0), ValueType(0)),
+                                     pipelined_bicgstab_plus<ValueType>());
+
+        ValueType sums4[4] = { thrust::get<0>(dots4), thrust::get<1>(dots4), thrust::get<2>(dots4), thrust::get<3>(dots4) };
+
+        cusp::blas::allreduce_begin(exec, sums4, 4);
+
+        // wh <- M*w, t <- A*wh
+        cusp::multiply(exec, M, w, wh);
+        cusp::multiply(exec, A, wh, t);
+
+        cusp::blas::allreduce_end(exec);
+
+        // beta = (r_{j+1}, r_star) / (r_j, r_star) * (alpha/omega)
+        const ValueType rho_new = sums4[0];
+
+        beta  = (rho_new / rho) * (alpha / omega);
+        alpha = rho_new / (sums4[1] + beta * sums4[2] - beta * omega * sums4[3]);
+        rho   = rho_new;
+
+        ++monitor;
+    }
+}
+
+} // end bicg_detail namespace
+
+template <typename DerivedPolicy,
+          typename LinearOperator,
+          typename VectorType1,
+          typename VectorType2,
+          typename Monitor,
+          typename Preconditioner>
+void pipelined_bicgstab(const thrust::detail::execution_policy_base<DerivedPolicy> &exec,
+                        const LinearOperator& A,
+                              VectorType1& x,
+                        const VectorType2& b,
+                              Monitor& monitor,
+                              Preconditioner& M)
+{
+    using cusp::krylov::bicg_detail::pipelined_bicgstab;
+
+    return pipelined_bicgstab(thrust::detail::derived_cast(thrust::detail::strip_const(exec)), A, x, b, monitor, M);
+}
+
+template <typename LinearOperator,
+          typename VectorType1,
+          typename VectorType2,
+          typename Monitor,
+          typename Preconditioner>
+void pipelined_bicgstab(const LinearOperator& A,
+                              VectorType1& x,
+                        const VectorType2& b,
+                              Monitor& monitor,
+                              Preconditioner& M)
+{
+    using thrust::system::detail::generic::select_system;
+
+    typedef typename LinearOperator::memory_space System1;
+    typedef typename VectorType2::memory_space    System2;
+
+    System1 system1;
+    System2 system2;
+
+    return cusp::krylov::pipelined_bicgstab(select_system(system1,system2), A, x, b, monitor, M);
+}
+
+template <typename LinearOperator,
+          typename VectorType1,
+          typename VectorType2,
+          typename Monitor>
+void pipelined_bicgstab(const LinearOperator& A,
+                              VectorType1& x,
+                        const VectorType2& b,
+                              Monitor& monitor)
+{
+    typedef typename LinearOperator::value_type   ValueType;
+    typedef typename LinearOperator::memory_space MemorySpace;
+
+    cusp::identity_operator<ValueType,MemorySpace> M(A.num_rows, A.num_cols);
+
+    return cusp::krylov::pipelined_bicgstab(A, x, b, monitor, M);
+}
+
+template <typename LinearOperator,
+          typename VectorType1,
+          typename VectorType2>
+void pipelined_bicgstab(const LinearOperator& A,
+                              VectorType1& x,
+                        const VectorType2& b)
+{
+    typedef typename LinearOperator::value_type   ValueType;
+
+    cusp::monitor<ValueType> monitor(b);
+
+    return cusp::krylov::pipelined_bicgstab(A, x, b, monitor);
+}
+
+} // end namespace krylov
+} // end namespace cusp
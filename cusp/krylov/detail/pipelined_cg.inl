@@ -0,0 +1,266 @@
+/*
+ *  Copyright 2008-2014 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include <cusp/array1d.h>
+#include <cusp/complex.h>
+#include <cusp/linear_operator.h>
+#include <cusp/multiply.h>
+#include <cusp/monitor.h>
+
+#include <cusp/detail/temporary_array.h>
+
+#include <cusp/blas/blas.h>
+
+#include <thrust/transform_reduce.h>
+#include <thrust/tuple.h>
+#include <thrust/iterator/zip_iterator.h>
+
+namespace cusp
+{
+namespace krylov
+{
+namespace cg_detail
+{
+
+// updates (n, m, z, q, s, p, x, r, u, w) and returns ((r,u), (w,u))
+template <typename ValueType>
+struct pipelined_cg_update
+{
+    ValueType alpha;
+    ValueType beta;
+
+    pipelined_cg_update(ValueType _alpha, ValueType _beta)
+        : alpha(_alpha), beta(_beta) {}
+
+    template <typename Tuple>
+    __host__ __device__
+    thrust::tuple<ValueType,ValueType> operator()(Tuple t)
+    {
+        const ValueType n = thrust::get<0>(t);
+        const ValueType m = thrust::get<1>(t);
+
+        // z <- n + beta*z, q <- m + beta*q, s <- w + beta*s, p <- u + beta*p
+        const ValueType z = n + beta * ValueType(thrust::get<2>(t));
+        const ValueType q = m + beta * ValueType(thrust::get<3>(t));
+        const ValueType s = ValueType(thrust::get<9>(t)) + beta * ValueType(thrust::get<4>(t));
+        const ValueType p = ValueType(thrust::get<8>(t)) + beta * ValueType(thrust::get<5>(t));
+
+        // x <- x + alpha*p, r <- r - alpha*s, u <- u - alpha*q, w <- w - alpha*z
+        const ValueType r = ValueType(thrust::get<7>(t)) - alpha * s;
+        const ValueType u = ValueType(thrust::get<8>(t)) - alpha * q;
+        const ValueType w = ValueType(thrust::get<9>(t)) - alpha * z;
+
+        thrust::get<2>(t) = z;
+        thrust::get<3>(t) = q;
+        thrust::get<4>(t) = s;
+        thrust::get<5>(t) = p;
+        thrust::get<6>(t) = ValueType(thrust::get<6>(t)) + alpha * p;
+        thrust::get<7>(t) = r;
+        thrust::get<8>(t) = u;
+        thrust::get<9>(t) = w;
+
+        return thrust::make_tuple(cusp::conj(r) * u, cusp::conj(w) * u);
+    }
+};
+
+template <typename ValueType>
+struct pipelined_cg_plus
+{
+    __host__ __device__
+    thrust::tuple<ValueType,ValueType> operator()(const thrust::tuple<ValueType,ValueType>& a,
+                                                  const thrust::tuple<ValueType,ValueType>& b) const
+    {
+        return thrust::make_tuple(thrust::get<0>(a) + thrust::get<0>(b),
+                                  thrust::get<1>(a) + thrust::get<1>(b));
+    }
+};
+
+template <typename DerivedPolicy,
+          typename LinearOperator,
+          typename VectorType1,
+          typename VectorType2,
+          typename Monitor,
+          typename Preconditioner>
+void pipelined_cg(thrust::execution_policy<DerivedPolicy> &exec,
+                  const LinearOperator& A,
+                        VectorType1& x,
+                  const VectorType2& b,
+                        Monitor& monitor,
+                        Preconditioner& M)
+{
+    typedef typename LinearOperator::value_type           ValueType;
+    typedef thrust::tuple<ValueType,ValueType>            DotType;
+
+    assert(A.num_rows == A.num_cols);        // sanity check
+
+    const size_t N = A.num_rows;
+
+    // allocate workspace, the search directions start at zero
+    cusp::detail::temporary_array<ValueType, DerivedPolicy> r(exec, N);
+    cusp::detail::temporary_array<ValueType, DerivedPolicy> u(exec, N);
+    cusp::detail::temporary_array<ValueType, DerivedPolicy> w(exec, N);
+    cusp::detail::temporary_array<ValueType, DerivedPolicy> m(exec, N);
+    cusp::detail::temporary_array<ValueType, DerivedPolicy> n(exec, N);
+    cusp::detail::temporary_array<ValueType, DerivedPolicy> z(exec, N, ValueType(0));
+    cusp::detail::temporary_array<ValueType, DerivedPolicy> q(exec, N, ValueType(0));
+    cusp::detail::temporary_array<ValueType, DerivedPolicy> s(exec, N, ValueType(0));
+    cusp::detail::temporary_array<ValueType, DerivedPolicy> p(exec, N, ValueType(0));
+
+    // r <- b - A*x
+    cusp::multiply(exec, A, x, w);
+    cusp::blas::axpby(exec, b, w, r, ValueType(1), ValueType(-1));
+
+    // u <- M*r
+    cusp::multiply(exec, M, r, u);
+
+    // w <- A*u
+    cusp::multiply(exec, A, u, w);
+
+    // gamma = <r^H, u>, delta = <w^H, u>
+    ValueType gamma = cusp::blas::dotc(exec, r, u);
+    ValueType delta = cusp::blas::dotc(exec, w, u);
+
+    // m <- M*w, n <- A*m
+    cusp::multiply(exec, M, w, m);
+    cusp::multiply(exec, A, m, n);
+
+    ValueType alpha(0);
+    ValueType gamma_old(0);
+
+    bool first = true;
+
+    while (!monitor.finished(exec, r))
+    {
+        ValueType beta(0);
+
+        if (first)
+        {
+            alpha = gamma / delta;
+            first = false;
+        }
+        else
+        {
+            beta  = gamma / gamma_old;
+            alpha = gamma / (delta - beta * gamma / alpha);
+        }
+
+        gamma_old = gamma;
+
+        // update all vectors and compute the next inner products in one pass
+        DotType dots =
+            thrust::transform_reduce(exec,
+                                     thrust::make_zip_iterator(thrust::make_tuple(n.begin(), m.begin(), z.begin(), q.begin(), s.begin(),
+                                                                                  p.begin(), x.begin(), r.begin(), u.begin(), w.begin())),
+                                     thrust::make_zip_iterator(thrust::make_tuple(n.begin(), m.begin(), z.begin(), q.begin(), s.begin(),
+                                                                                  p.begin(), x.begin(), r.begin(), u.begin(), w.begin())) + N,
+                                     pipelined_cg_update<ValueType>(alpha, beta),
+                                     DotType(ValueType(0), ValueType(0)),
+                                     pipelined_cg_plus<ValueType>());
+
+        // the partial inner products are summed over the processes of exec
+        // while the preconditioner and the operator are applied
+        ValueType sums[2] = { thrust::get<0>(dots), thrust::get<1>(dots) };
+
+        cusp::blas::allreduce_begin(exec, sums, 2);
+
+        // m <- M*w, n <- A*m
+        cusp::multiply(exec, M, w, m);
+        cusp::multiply(exec, A, m, n);
+
+        cusp::blas::allreduce_end(exec);
+
+        gamma = sums[0];
+        delta = sums[1];
+
+        ++monitor;
+    }
+}
+
+} // end cg_detail namespace
+
+template <typename DerivedPolicy,
+          typename LinearOperator,
+          typename VectorType1,
+          typename VectorType2,
+          typename Monitor,
+          typename Preconditioner>
+void pipelined_cg(const thrust::detail::execution_policy_base<DerivedPolicy> &exec,
+                  const LinearOperator& A,
+                        VectorType1& x,
+                  const VectorType2& b,
+                        Monitor& monitor,
+                        Preconditioner& M)
+{
+    using cusp::krylov::cg_detail::pipelined_cg;
+
+    return pipelined_cg(thrust::detail::derived_cast(thrust::detail::strip_const(exec)), A, x, b, monitor, M);
+}
+
+template <typename LinearOperator,
+          typename VectorType1,
+          typename VectorType2,
+          typename Monitor,
+          typename Preconditioner>
+void pipelined_cg(const LinearOperator& A,
+                        VectorType1& x,
+                  const VectorType2& b,
+                        Monitor& monitor,
+                        Preconditioner& M)
+{
+    using thrust::system::detail::generic::select_system;
+
+    typedef typename LinearOperator::memory_space System1;
+    typedef typename VectorType2::memory_space    System2;
+
+    System1 system1;
+    System2 system2;
+
+    return cusp::krylov::pipelined_cg(select_system(system1,system2), A, x, b, monitor, M);
+}
+
+template <typename LinearOperator,
+          typename VectorType1,
+          typename VectorType2,
+          typename Monitor>
+void pipelined_cg(const LinearOperator& A,
+                        VectorType1& x,
+                  const VectorType2& b,
+                        Monitor& monitor)
+{
+    typedef typename LinearOperator::value_type   ValueType;
+    typedef typename LinearOperator::memory_space MemorySpace;
+
+    cusp::identity_operator<ValueType,MemorySpace> M(A.num_rows, A.num_cols);
+
+    return cusp::krylov::pipelined_cg(A, x, b, monitor, M);
+}
+
+template <typename LinearOperator,
+          typename VectorType1,
+          typename VectorType2>
+void pipelined_cg(const LinearOperator& A,
+                        VectorType1& x,
+                  const VectorType2& b)
+{
+    typedef typename LinearOperator::value_type   ValueType;
+
+    cusp::monitor<ValueType> monitor(b);
+
+    return cusp::krylov::pipelined_cg(A, x, b, monitor);
+}
+
+} // end namespace krylov
+} // end namespace cusp
@@ -0,0 +1,466 @@
+/*
+ *  Copyright 2008-2014 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include <cusp/array1d.h>
+#include <cusp/array2d.h>
+#include <cusp/linear_operator.h>
+#include <cusp/multiply.h>
+#include <cusp/monitor.h>
+
+#include <cusp/blas/blas.h>
+#include <cusp/eigen/detail/block_products.inl>
+#include <cusp/lapack/batched.h>
+
+#include <thrust/copy.h>
+
+#include <algorithm>
+#include <cmath>
+
+namespace cusp
+{
+namespace krylov
+{
+
+////////////////////////
+// recycled_cg_solver //
+////////////////////////
+
+template <typename ValueType, typename MemorySpace>
+recycled_cg_solver<ValueType,MemorySpace>
+::recycled_cg_solver(void)
+    : max_vectors(8), harvest_size(24) {}
+
+template <typename ValueType, typename MemorySpace>
+recycled_cg_solver<ValueType,MemorySpace>
+::recycled_cg_solver(const size_t N, const size_t num_vectors, const size_t num_harvest)
+    : max_vectors(num_vectors), harvest_size(num_harvest)
+{
+    resize(N);
+}
+
+template <typename ValueType, typename MemorySpace>
+void
+recycled_cg_solver<ValueType,MemorySpace>
+::resize(const size_t N)
+{
+    if(W.num_rows != N)
+        reset();
+
+    y.resize(N);
+    z.resize(N);
+    r.resize(N);
+    p.resize(N);
+
+    V.resize(N, harvest_size);
+}
+
+template <typename ValueType, typename MemorySpace>
+void
+recycled_cg_solver<ValueType,MemorySpace>
+::reset(void)
+{
+    W.resize(0, 0);
+    AW.resize(0, 0);
+    Einv.resize(0, 0);
+    U.resize(0);
+    E.resize(0);
+}
+
+template <typename ValueType, typename MemorySpace>
+size_t
+recycled_cg_solver<ValueType,MemorySpace>
+::deflation_size(void) const
+{
+    return W.num_cols;
+}
+
+// AW <- A W and Einv <- (W^T A W)^{-1} for the current matrix, the basis is
+// dropped if W^T A W is not positive definite
+template <typename ValueType, typename MemorySpace>
+template <typename DerivedPolicy, typename LinearOperator>
+void
+recycled_cg_solver<ValueType,MemorySpace>
+::refresh(thrust::execution_policy<DerivedPolicy> &exec,
+          const LinearOperator& A)
+{
+    typedef typename Block::column_view                 ColumnView;
+    typedef cusp::array1d<double,cusp::host_memory>     VectorHost;
+
+    const size_t N = W.num_rows;
+    const size_t k = W.num_cols;
+
+    if(k == 0)
+        return;
+
+    AW.resize(N, k);
+
+    for(size_t j = 0; j < k; j++)
+    {
+        ColumnView w  = W.column(j);
+        ColumnView aw = AW.column(j);
+
+        cusp::multiply(exec, A, w, aw);
+    }
+
+    cusp::array1d<ValueType,MemorySpace> E_d;
+    cusp::eigen::detail::block_project(exec, W, k, AW, E_d);
+    E = E_d;
+
+    VectorHost R;
+    VectorHost Rinv;
+
+    if(!cusp::eigen::detail::block_cholesky_upper(E, R, k))
+    {
+        reset();
+        return;
+    }
+
+    cusp::eigen::detail::block_invert_upper(R, Rinv, k);
+
+    // (R^T R)^{-1} = R^{-1} R^{-T}
+    cusp::array2d<ValueType,cusp::host_memory> Einv_h(k, k);
+
+    for(size_t i = 0; i < k; i++)
+        for(size_t j = 0; j < k; j++)
+        {
+            double t = 0.0;
+
+            for(size_t l = std::max(i, j); l < k; l++)
+                t += Rinv[i * k + l] * Rinv[j * k + l];
+
+            Einv_h(i,j) = ValueType(t);
+        }
+
+    Einv = Einv_h;
+
+    mu.resize(k);
+    U.resize(k * harvest_size);
+}
+
+// mu <- (W^T A W)^{-1} B^T v
+template <typename ValueType, typename MemorySpace>
+template <typename DerivedPolicy, typename Array1d>
+void
+recycled_cg_solver<ValueType,MemorySpace>
+::project(thrust::execution_policy<DerivedPolicy> &exec,
+          const Block& B,
+          const Array1d& v)
+{
+    cusp::blas::dotcs(exec, v, B, h);
+    cusp::blas::gemv(exec, Einv, h, mu);
+}
+
+// keeps z / sqrt(<r,z>) as the next Lanczos vector together with the
+// coefficients mu of its component along W
+template <typename ValueType, typename MemorySpace>
+template <typename DerivedPolicy>
+void
+recycled_cg_solver<ValueType,MemorySpace>
+::store_lanczos(thrust::execution_policy<DerivedPolicy> &exec,
+                const ValueType rz)
+{
+    typedef typename Block::column_view ColumnView;
+
+    const size_t n   = scales.size();
+    const size_t k   = W.num_cols;
+    const double rho = std::sqrt(double(rz));
+
+    ColumnView v = V.column(n);
+    cusp::blas::axpby(exec, z, z, v, ValueType(1.0 / rho), ValueType(0));
+
+    if(k > 0)
+        thrust::copy(exec, mu.begin(), mu.end(), U.begin() + n * k);
+
+    scales.push_back(rho);
+}
+
+// replaces W by the Ritz vectors of the smallest Ritz values of M^{-1} A
+// on span [W V], the Galerkin matrix is
+//
+//   [ W^T A W   W^T A V          ]
+//   [ V^T A W   T + U^T W^T A W U ]
+//
+// where T is the tridiagonal matrix of the CG recurrence; both W and V
+// are M-orthonormal and M-orthogonal to each other so the Gram matrix is I
+template <typename ValueType, typename MemorySpace>
+template <typename DerivedPolicy>
+void
+recycled_cg_solver<ValueType,MemorySpace>
+::harvest(thrust::execution_policy<DerivedPolicy> &exec)
+{
+    typedef cusp::array1d<ValueType,MemorySpace>                        Coefficients;
+    typedef cusp::array1d<double,cusp::host_memory>                     VectorHost;
+    typedef cusp::array2d<double,cusp::host_memory,cusp::column_major>  Array2dHost;
+
+    const size_t N = V.num_rows;
+    const size_t k = W.num_cols;
+    const size_t m = std::min(alphas.size(), scales.size());
+
+    if(m == 0 || max_vectors == 0)
+        return;
+
+    const size_t n = k + m;
+
+    Array2dHost G(n, n, 0.0);
+
+    for(size_t i = 0; i < k; i++)
+        for(size_t j = 0; j < k; j++)
+            G(i,j) = 0.5 * (E[i * k + j] + E[j * k + i]);
+
+    if(k > 0)
+    {
+        Coefficients H;
+        cusp::eigen::detail::block_project(exec, V, m, AW, H);
+
+        VectorHost H_h(H);
+        VectorHost U_h(U);
+
+        for(size_t i = 0; i < m; i++)
+            for(size_t j = 0; j < k; j++)
+                G(j, k + i) = G(k + i, j) = H_h[i * k + j];
+
+        // components of the Lanczos vectors along W
+        for(size_t i = 0; i < m; i++)
+            for(size_t j = 0; j < m; j++)
+            {
+                double t = 0.0;
+
+                for(size_t a = 0; a < k; a++)
+                    for(size_t c = 0; c < k; c++)
+                        t += U_h[i * k + a] * G(a,c) * U_h[j * k + c];
+
+                G(k + i, k + j) = t / (scales[i] * scales[j]);
+            }
+    }
+
+    for(size_t j = 0; j < m; j++)
+    {
+        G(k + j, k + j) += 1.0 / alphas[j] + (j > 0 ? betas[j - 1] / alphas[j - 1] : 0.0);
+
+        if(j + 1 < m)
+        {
+            const double t = -std::sqrt(betas[j]) / alphas[j];
+
+            G(k + j, k + j + 1) += t;
+            G(k + j + 1, k + j) += t;
+        }
+    }
+
+    VectorHost  eigvals;
+    Array2dHost eigvecs;
+
+    cusp::lapack::batched_syev(G, eigvals, eigvecs);
+
+    const size_t s = std::min(max_vectors, n);
+
+    VectorHost Cv(m * s);
+    VectorHost Cw(k * s);
+
+    for(size_t e = 0; e < s; e++)
+    {
+        for(size_t i = 0; i < k; i++)
+            Cw[i * s + e] = eigvecs(i, e);
+
+        for(size_t i = 0; i < m; i++)
+            Cv[i * s + e] = eigvecs(k + i, e);
+    }
+
+    Block Wnext(N, s);
+    Coefficients C(Cv);
+
+    cusp::eigen::detail::block_combine(exec, Wnext, V, m, C, Wnext, ValueType(1), ValueType(0));
+
+    if(k > 0)
+    {
+        C = Cw;
+        cusp::eigen::detail::block_combine(exec, Wnext, W, k, C, Wnext, ValueType(1), ValueType(1));
+    }
+
+    W.swap(Wnext);
+}
+
+template <typename ValueType, typename MemorySpace>
+template <typename DerivedPolicy,
+          typename LinearOperator,
+          typename VectorType1,
+          typename VectorType2,
+          typename Monitor,
+          typename Preconditioner>
+void
+recycled_cg_solver<ValueType,MemorySpace>
+::solve(const thrust::detail::execution_policy_base<DerivedPolicy> &exec_base,
+        const LinearOperator& A,
+              VectorType1& x,
+        const VectorType2& b,
+              Monitor& monitor,
+              Preconditioner& M)
+{
+    thrust::execution_policy<DerivedPolicy>& exec =
+        thrust::detail::derived_cast(thrust::detail::strip_const(exec_base));
+
+    assert(A.num_rows == A.num_cols);        // sanity check
+
+    resize(A.num_rows);
+    refresh(exec, A);
+
+    const size_t k = W.num_cols;
+
+    alphas.clear();
+    betas.clear();
+    scales.clear();
+
+    // y <- Ax
+    cusp::multiply(exec, A, x, y);
+
+    // r <- b - A*x
+    cusp::blas::axpby(exec, b, y, r, ValueType(1), ValueType(-1));
+
+    if(k > 0)
+    {
+        // x <- x + W (W^T A W)^{-1} W^T r, leaving r orthogonal to W
+        project(exec, W, r);
+        cusp::blas::gemv(exec, W, mu, x, ValueType(1), ValueType(1));
+        cusp::blas::gemv(exec, AW, mu, r, ValueType(-1), ValueType(1));
+    }
+
+    // z <- M*r
+    cusp::multiply(exec, M, r, z);
+
+    // p <- z - W (W^T A W)^{-1} (AW)^T z
+    cusp::blas::copy(exec, z, p);
+
+    if(k > 0)
+    {
+        project(exec, AW, z);
+        cusp::blas::gemv(exec, W, mu, p, ValueType(-1), ValueType(1));
+    }
+
+    // rz = <r^H, z>
+    ValueType rz = cusp::blas::dotc(exec, r, z);
+
+    if(harvest_size > 0 && rz > ValueType(0))
+        store_lanczos(exec, rz);
+
+    while (!monitor.finished(exec, r))
+    {
+        // y <- Ap
+        cusp::multiply(exec, A, p, y);
+
+        // alpha <- <r,z>/<y,p>
+        ValueType alpha =  rz / cusp::blas::dotc(exec, y, p);
+
+        // x <- x + alpha * p
+        cusp::blas::axpy(exec, p, x, alpha);
+
+        // r <- r - alpha * y
+        cusp::blas::axpy(exec, y, r, -alpha);
+
+        // z <- M*r
+        cusp::multiply(exec, M, r, z);
+
+        ValueType rz_old = rz;
+
+        // rz = <r^H, z>
+        rz = cusp::blas::dotc(exec, r, z);
+
+        // beta <- <r_{i+1},r_{i+1}>/<r,r>
+        ValueType beta = rz / rz_old;
+
+        // p <- z + beta*p - W (W^T A W)^{-1} (AW)^T z
+        cusp::blas::axpby(exec, z, p, p, ValueType(1), beta);
+
+        if(k > 0)
+        {
+            project(exec, AW, z);
+            cusp::blas::gemv(exec, W, mu, p, ValueType(-1), ValueType(1));
+        }
+
+        if(alphas.size() < harvest_size)
+        {
+            alphas.push_back(alpha);
+
+            if(scales.size() < harvest_size && rz > ValueType(0))
+            {
+                betas.push_back(beta);
+                store_lanczos(exec, rz);
+            }
+        }
+
+        ++monitor;
+    }
+
+    harvest(exec);
+}
+
+template <typename ValueType, typename MemorySpace>
+template <typename LinearOperator,
+          typename VectorType1,
+          typename VectorType2,
+          typename Monitor,
+          typename Preconditioner>
+void
+recycled_cg_solver<ValueType,MemorySpace>
+::solve(const LinearOperator& A,
+              VectorType1& x,
+        const VectorType2& b,
+              Monitor& monitor,
+              Preconditioner& M)
+{
+    using thrust::system::detail::generic::select_system;
+
+    typedef typename LinearOperator::memory_space System1;
+    typedef typename VectorType2::memory_space    System2;
+
+    System1 system1;
+    System2 system2;
+
+    solve(select_system(system1,system2), A, x, b, monitor, M);
+}
+
+template <typename ValueType, typename MemorySpace>
+template <typename LinearOperator,
+          typename VectorType1,
+          typename VectorType2,
+          typename Monitor>
+void
+recycled_cg_solver<ValueType,MemorySpace>
+::solve(const LinearOperator& A,
+              VectorType1& x,
+        const VectorType2& b,
+              Monitor& monitor)
+{
+    cusp::identity_operator<ValueType,MemorySpace> M(A.num_rows, A.num_cols);
+
+    solve(A, x, b, monitor, M);
+}
+
+template <typename ValueType, typename MemorySpace>
+template <typename LinearOperator,
+          typename VectorType1,
+          typename VectorType2>
+void
+recycled_cg_solver<ValueType,MemorySpace>
+::solve(const LinearOperator& A,
+              VectorType1& x,
+        const VectorType2& b)
+{
+    cusp::monitor<ValueType> monitor(b);
+
+    solve(A, x, b, monitor);
+}
+
+} // end namespace krylov
+} // end namespace cusp
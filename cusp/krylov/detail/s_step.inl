@@ -0,0 +1,159 @@
+/*
+ *  Copyright 2008-2014 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+
+#pragma once
+
+#include <cusp/detail/config.h>
+
+#include <cusp/array1d.h>
+#include <cusp/array2d.h>
+
+#include <cusp/eigen/detail/block_products.inl>
+
+#include <cmath>
+
+namespace cusp
+{
+namespace krylov
+{
+namespace s_step_detail
+{
+
+// The coefficient matrices of the s-step methods are small, they are kept
+// row-major on the host in double precision and moved to the memory space
+// of the policy before they are applied to a block.
+typedef cusp::array1d<double,cusp::host_memory> HostArray;
+
+// E with A V(:,0:s) = V E for the basis V(:,k+1) = (A - shifts[k] I) V(:,k),
+// stored as an (s+1)-by-s matrix
+template <typename ShiftArray>
+void basis_change_matrix(const ShiftArray& shifts, HostArray& E)
+{
+    const size_t s = shifts.size();
+
+    E.resize((s + 1) * s);
+    thrust::fill(E.begin(), E.end(), 0.0);
+
+    for(size_t k = 0; k < s; k++)
+    {
+        E[k * s + k]       = shifts[k];
+        E[(k + 1) * s + k] = 1.0;
+    }
+}
+
+// C <- op(A) B for an m-by-k op(A) and a k-by-n B, op(A) = A^T if transpose
+inline void small_gemm(const HostArray& A, const HostArray& B, HostArray& C,
+                       const size_t m, const size_t k, const size_t n,
+                       const bool transpose = false)
+{
+    C.resize(m * n);
+
+    for(size_t i = 0; i < m; i++)
+        for(size_t j = 0; j < n; j++)
+        {
+            double sum = 0.0;
+
+            for(size_t l = 0; l < k; l++)
+                sum += (transpose ? A[l * m + i] : A[i * k + l]) * B[l * n + j];
+
+            C[i * n + j] = sum;
+        }
+}
+
+// G = R^T R for the s-by-s symmetric G. The powers of A scale the columns
+// of a basis very differently, so the factorization works on the Gram
+// matrix equilibrated to a unit diagonal and scales R back; returns false
+// if G is not numerically positive definite
+inline bool equilibrated_cholesky(const HostArray& G, HostArray& R, const size_t s)
+{
+    HostArray scale(s);
+    HostArray Gs(s * s);
+
+    for(size_t i = 0; i < s; i++)
+    {
+        if(!(G[i * s + i] > 0.0))
+            return false;
+
+        scale[i] = 1.0 / std::sqrt(G[i * s + i]);
+    }
+
+    for(size_t i = 0; i < s; i++)
+        for(size_t j = 0; j < s; j++)
+            Gs[i * s + j] = scale[i] * G[i * s + j] * scale[j];
+
+    if(!cusp::eigen::detail::block_cholesky_upper(Gs, R, s))
+        return false;
+
+    for(size_t i = 0; i < s; i++)
+        for(size_t j = i; j < s; j++)
+            R[i * s + j] /= scale[j];
+
+    return true;
+}
+
+// Y <- R^{-T} Y for an upper triangular R and an s-by-n Y
+inline void solve_upper_transpose(const HostArray& R, HostArray& Y, const size_t s, const size_t n)
+{
+    for(size_t j = 0; j < n; j++)
+        for(size_t i = 0; i < s; i++)
+        {
+            double t = Y[i * n + j];
+
+            for(size_t k = 0; k < i; k++)
+                t -= R[k * s + i] * Y[k * n + j];
+
+            Y[i * n + j] = t / R[i * s + i];
+        }
+}
+
+// Y <- R^{-1} Y for an upper triangular R and an s-by-n Y
+inline void solve_upper(const HostArray& R, HostArray& Y, const size_t s, const size_t n)
+{
+    for(size_t j = 0; j < n; j++)
+        for(size_t i = s; i-- > 0;)
+        {
+            double t = Y[i * n + j];
+
+            for(size_t k = i + 1; k < s; k++)
+                t -= R[i * s + k] * Y[k * n + j];
+
+            Y[i * n + j] = t / R[i * s + i];
+        }
+}
+
+// columns [first, first + num_cols) of a column-major block
+template <typename Array2d>
+typename Array2d::view
+column_range(Array2d& V, const size_t first, const size_t num_cols)
+{
+    return cusp::make_array2d_view(V.num_rows, num_cols, V.pitch,
+                                   cusp::make_array1d_view(V.values.begin() + first * V.pitch,
+                                                           V.values.begin() + (first + num_cols) * V.pitch),
+                                   cusp::column_major());
+}
+
+// a vector as a block with one column
+template <typename Array1d>
+cusp::array2d_view<typename Array1d::view, cusp::column_major>
+column_block(Array1d& x)
+{
+    return cusp::make_array2d_view(x.size(), 1, x.size(), cusp::make_array1d_view(x), cusp::column_major());
+}
+
+} // end namespace s_step_detail
+} // end namespace krylov
+} // end namespace cusp
@@ -0,0 +1,267 @@
+/*
+ *  Copyright 2008-2014 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+
+#include <cusp/array1d.h>
+#include <cusp/array2d.h>
+#include <cusp/matrix_powers.h>
+#include <cusp/monitor.h>
+#include <cusp/multiply.h>
+
+#include <cusp/blas/blas.h>
+#include <cusp/eigen/detail/block_products.inl>
+#include <cusp/krylov/detail/s_step.inl>
+
+namespace cusp
+{
+namespace krylov
+{
+namespace cg_detail
+{
+
+template <typename DerivedPolicy,
+          typename LinearOperator,
+          typename VectorType1,
+          typename VectorType2,
+          typename Monitor,
+          typename ShiftType>
+void s_step_cg(thrust::execution_policy<DerivedPolicy> &exec,
+               const LinearOperator& A,
+                     VectorType1& x,
+               const VectorType2& b,
+                     Monitor& monitor,
+               const cusp::array1d<ShiftType,cusp::host_memory>& shifts)
+{
+    typedef typename LinearOperator::value_type                     ValueType;
+    typedef typename LinearOperator::memory_space                   MemorySpace;
+    typedef cusp::array1d<ValueType,MemorySpace>                    Array;
+    typedef cusp::array2d<ValueType,MemorySpace,cusp::column_major> Block;
+    typedef typename Block::view                                    BlockView;
+    typedef cusp::krylov::s_step_detail::HostArray                  HostArray;
+
+    using namespace cusp::krylov::s_step_detail;
+    using cusp::eigen::detail::block_project;
+    using cusp::eigen::detail::block_combine;
+
+    assert(A.num_rows == A.num_cols);        // sanity check
+
+    const size_t N = A.num_rows;
+    const size_t s = shifts.size();
+
+    if(s == 0)
+        throw cusp::invalid_input_exception("s_step_cg requires s > 0");
+
+    // Q = [A P, V] holds the products of the previous search directions
+    // and the basis V = [r, ..., A^s r], so that all inner products come
+    // from one block product; Q and P alternate between two copies
+    Block Q[2] = { Block(N, 2 * s + 1, ValueType(0)), Block(N, 2 * s + 1, ValueType(0)) };
+    Block P[2] = { Block(N, s), Block(N, s) };
+
+    Array r(N);
+    Array H, E_d, B_d, a_d;
+
+    HostArray E, H_h, C, G, KAK, W, R, R_old, B, CB, a;
+
+    basis_change_matrix(shifts, E);
+    E_d = E;
+
+    // r <- b - A*x
+    cusp::multiply(exec, A, x, r);
+    cusp::blas::axpby(exec, b, r, r, ValueType(1), ValueType(-1));
+
+    cusp::array2d_view<typename VectorType1::view,cusp::column_major> x_block = column_block(x);
+    BlockView r_block = column_block(r);
+
+    size_t current = 0;
+    bool   first   = true;
+
+    while(!monitor.finished(exec, r))
+    {
+        Block& Q0 = Q[current];
+        Block& Q1 = Q[1 - current];
+
+        BlockView AP_old = column_range(Q0, 0, s);
+        BlockView V      = column_range(Q0, s, s + 1);
+        BlockView K      = column_range(Q0, s, s);
+        BlockView AP     = column_range(Q1, 0, s);
+
+        cusp::matrix_powers(exec, A, r, V, shifts);
+
+        // H = [A P, K]^T V
+        block_project(exec, Q0, 2 * s, V, H);
+        H_h = H;
+
+        // C = (A P)^T K, G = K^T V, K^T A K = G E
+        C.resize(s * s);
+        G.resize(s * (s + 1));
+
+        for(size_t i = 0; i < s; i++)
+        {
+            for(size_t j = 0; j < s; j++)
+                C[i * s + j] = H_h[i * (s + 1) + j];
+
+            for(size_t j = 0; j <= s; j++)
+                G[i * (s + 1) + j] = H_h[(s + i) * (s + 1) + j];
+        }
+
+        small_gemm(G, E, KAK, s, s + 1, s);
+
+        // B = (P^T A P)^{-1} C makes K - P B conjugate to P, and
+        // W = (K - P B)^T A (K - P B) = K^T A K - C^T B
+        W = KAK;
+
+        if(!first)
+        {
+            B = C;
+            solve_upper_transpose(R_old, B, s, s);
+            solve_upper(R_old, B, s, s);
+
+            small_gemm(C, B, CB, s, s, s, true);
+
+            for(size_t i = 0; i < s * s; i++)
+                W[i] -= CB[i];
+        }
+
+        // the residual is orthogonal to the previous directions, so the
+        // step solves W a = K^T r
+        a.resize(s);
+        for(size_t i = 0; i < s; i++)
+            a[i] = G[i * (s + 1)];
+
+        if(!equilibrated_cholesky(W, R, s))
+        {
+            // the basis lost rank, start over from the true residual
+            if(first)
+                break;
+
+            cusp::multiply(exec, A, x, r);
+            cusp::blas::axpby(exec, b, r, r, ValueType(1), ValueType(-1));
+
+            first = true;
+            continue;
+        }
+
+        solve_upper_transpose(R, a, s, 1);
+        solve_upper(R, a, s, 1);
+
+        // P <- K - P B, A P <- V E - (A P) B
+        Block& P0 = P[current];
+        Block& P1 = P[1 - current];
+
+        if(first)
+        {
+            cusp::blas::copy(exec, K.values, P1.values);
+            block_combine(exec, AP, V, s + 1, E_d, AP, ValueType(1), ValueType(0));
+        }
+        else
+        {
+            B_d = B;
+            block_combine(exec, K, P0, s, B_d, P1, ValueType(-1), ValueType(1));
+            block_combine(exec, AP, V, s + 1, E_d, AP, ValueType(1), ValueType(0));
+            block_combine(exec, AP, AP_old, s, B_d, AP, ValueType(-1), ValueType(1));
+        }
+
+        // x <- x + P a, r <- r - A P a
+        a_d = a;
+        block_combine(exec, x_block, P1, s, a_d, x_block, ValueType(1), ValueType(1));
+        block_combine(exec, r_block, AP, s, a_d, r_block, ValueType(-1), ValueType(1));
+
+        R_old.swap(R);
+
+        current = 1 - current;
+        first   = false;
+
+        for(size_t k = 0; k < s; k++)
+            ++monitor;
+    }
+}
+
+} // end cg_detail namespace
+
+template <typename DerivedPolicy,
+          typename LinearOperator,
+          typename VectorType1,
+          typename VectorType2,
+          typename Monitor,
+          typename ShiftType>
+void s_step_cg(const thrust::detail::execution_policy_base<DerivedPolicy> &exec,
+               const LinearOperator& A,
+                     VectorType1& x,
+               const VectorType2& b,
+                     Monitor& monitor,
+               const cusp::array1d<ShiftType,cusp::host_memory>& shifts)
+{
+    using cusp::krylov::cg_detail::s_step_cg;
+
+    return s_step_cg(thrust::detail::derived_cast(thrust::detail::strip_const(exec)), A, x, b, monitor, shifts);
+}
+
+template <typename LinearOperator,
+          typename VectorType1,
+          typename VectorType2,
+          typename Monitor,
+          typename ShiftType>
+void s_step_cg(const LinearOperator& A,
+                     VectorType1& x,
+               const VectorType2& b,
+                     Monitor& monitor,
+               const cusp::array1d<ShiftType,cusp::host_memory>& shifts)
+{
+    using thrust::system::detail::generic::select_system;
+
+    typedef typename LinearOperator::memory_space System1;
+    typedef typename VectorType2::memory_space    System2;
+
+    System1 system1;
+    System2 system2;
+
+    return cusp::krylov::s_step_cg(select_system(system1,system2), A, x, b, monitor, shifts);
+}
+
+template <typename LinearOperator,
+          typename VectorType1,
+          typename VectorType2,
+          typename Monitor>
+void s_step_cg(const LinearOperator& A,
+                     VectorType1& x,
+               const VectorType2& b,
+                     Monitor& monitor,
+               const size_t s)
+{
+    typedef typename LinearOperator::value_type ValueType;
+
+    // the monomial basis
+    cusp::array1d<ValueType,cusp::host_memory> shifts(s, ValueType(0));
+
+    return cusp::krylov::s_step_cg(A, x, b, monitor, shifts);
+}
+
+template <typename LinearOperator,
+          typename VectorType1,
+          typename VectorType2>
+void s_step_cg(const LinearOperator& A,
+                     VectorType1& x,
+               const VectorType2& b)
+{
+    typedef typename LinearOperator::value_type ValueType;
+
+    cusp::monitor<ValueType> monitor(b);
+
+    return cusp::krylov::s_step_cg(A, x, b, monitor);
+}
+
+} // end namespace krylov
+} // end namespace cusp
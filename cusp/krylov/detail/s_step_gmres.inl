@@ -0,0 +1,275 @@
+/*
+ *  Copyright 2008-2014 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+
+#include <cusp/array1d.h>
+#include <cusp/array2d.h>
+#include <cusp/matrix_powers.h>
+#include <cusp/monitor.h>
+#include <cusp/multiply.h>
+
+#include <cusp/blas/blas.h>
+#include <cusp/eigen/detail/block_products.inl>
+#include <cusp/krylov/detail/s_step.inl>
+
+#include <algorithm>
+
+namespace cusp
+{
+namespace krylov
+{
+namespace gmres_detail
+{
+
+template <typename DerivedPolicy,
+          typename LinearOperator,
+          typename VectorType1,
+          typename VectorType2,
+          typename Monitor,
+          typename ShiftType>
+void s_step_gmres(thrust::execution_policy<DerivedPolicy> &exec,
+                  const LinearOperator& A,
+                        VectorType1& x,
+                  const VectorType2& b,
+                  const size_t restart,
+                        Monitor& monitor,
+                  const cusp::array1d<ShiftType,cusp::host_memory>& shifts)
+{
+    typedef typename LinearOperator::value_type                     ValueType;
+    typedef typename LinearOperator::memory_space                   MemorySpace;
+    typedef cusp::array1d<ValueType,MemorySpace>                    Array;
+    typedef cusp::array2d<ValueType,MemorySpace,cusp::column_major> Block;
+    typedef typename Block::view                                    BlockView;
+    typedef cusp::krylov::s_step_detail::HostArray                  HostArray;
+
+    using namespace cusp::krylov::s_step_detail;
+    using cusp::eigen::detail::block_project;
+    using cusp::eigen::detail::block_combine;
+    using cusp::eigen::detail::block_invert_upper;
+
+    assert(A.num_rows == A.num_cols);        // sanity check
+
+    const size_t N = A.num_rows;
+    const size_t s = shifts.size();
+
+    if(s == 0)
+        throw cusp::invalid_input_exception("s_step_gmres requires s > 0");
+
+    // the restart length is a whole number of blocks
+    const size_t m = s * std::max(size_t(1), restart / s);
+
+    // Q = [Z, V] holds the orthonormal images Z = A K of the directions K
+    // of the current cycle followed by the basis V = [r, ..., A^s r] of
+    // the next block
+    Block Q(N, m + s + 1, ValueType(0));
+    Block K(N, m, ValueType(0));
+    Block T(N, s);
+
+    Array r(N);
+    Array H, F_d, D_d, Rinv_d, h_d;
+
+    HostArray E, H_h, VV, ZV, VE, G, C, CC, R, Rinv, F, D, h;
+
+    basis_change_matrix(shifts, E);
+
+    // r <- b - A*x
+    cusp::multiply(exec, A, x, r);
+    cusp::blas::axpby(exec, b, r, r, ValueType(1), ValueType(-1));
+
+    cusp::array2d_view<typename VectorType1::view,cusp::column_major> x_block = column_block(x);
+    BlockView r_block = column_block(r);
+
+    size_t j = 0;
+
+    while(!monitor.finished(exec, r))
+    {
+        BlockView V  = column_range(Q, j, s + 1);
+        BlockView Kj = column_range(K, j, s);
+
+        cusp::matrix_powers(exec, A, r, V, shifts);
+
+        // H = [Z, V]^T V
+        block_project(exec, Q, j + s + 1, V, H);
+        H_h = H;
+
+        ZV.resize(j * (s + 1));
+        VV.resize((s + 1) * (s + 1));
+
+        std::copy(H_h.begin(), H_h.begin() + j * (s + 1), ZV.begin());
+        std::copy(H_h.begin() + j * (s + 1), H_h.end(), VV.begin());
+
+        // W = A V(:,0:s) = V E, G = W^T W and h = W^T r
+        small_gemm(VV, E, VE, s + 1, s + 1, s);
+        small_gemm(E, VE, G, s, s + 1, s, true);
+
+        h.resize(s);
+        for(size_t i = 0; i < s; i++)
+            h[i] = VE[i];
+
+        // orthogonalize W against Z: W - Z C with C = Z^T W, and the
+        // residual against the updated directions
+        if(j > 0)
+        {
+            small_gemm(ZV, E, C, j, s + 1, s);
+            small_gemm(C, C, CC, s, j, s, true);
+
+            for(size_t i = 0; i < s * s; i++)
+                G[i] -= CC[i];
+
+            for(size_t i = 0; i < s; i++)
+                for(size_t l = 0; l < j; l++)
+                    h[i] -= C[l * s + i] * ZV[l * (s + 1)];
+        }
+
+        // Cholesky QR of the orthogonalized block, T = (W - Z C) R^{-1}
+        if(!equilibrated_cholesky(G, R, s))
+        {
+            // the basis lost rank, start a new cycle from the true residual
+            if(j == 0)
+                break;
+
+            cusp::multiply(exec, A, x, r);
+            cusp::blas::axpby(exec, b, r, r, ValueType(1), ValueType(-1));
+
+            j = 0;
+            continue;
+        }
+
+        block_invert_upper(R, Rinv, s);
+        solve_upper_transpose(R, h, s, 1);
+
+        // T = V (E R^{-1}) - Z (C R^{-1}), K(:,j:j+s) = V(:,0:s) R^{-1} - K (C R^{-1})
+        small_gemm(E, Rinv, F, s + 1, s, s);
+
+        F_d    = F;
+        Rinv_d = Rinv;
+
+        block_combine(exec, T, V, s + 1, F_d, T, ValueType(1), ValueType(0));
+        block_combine(exec, Kj, V, s, Rinv_d, Kj, ValueType(1), ValueType(0));
+
+        if(j > 0)
+        {
+            small_gemm(C, Rinv, D, j, s, s);
+            D_d = D;
+
+            block_combine(exec, T, Q, j, D_d, T, ValueType(-1), ValueType(1));
+            block_combine(exec, Kj, K, j, D_d, Kj, ValueType(-1), ValueType(1));
+        }
+
+        // minimize the residual over the new directions
+        h_d = h;
+        block_combine(exec, x_block, Kj, s, h_d, x_block, ValueType(1), ValueType(1));
+        block_combine(exec, r_block, T, s, h_d, r_block, ValueType(-1), ValueType(1));
+
+        BlockView Zj = column_range(Q, j, s);
+        cusp::blas::copy(exec, T.values, Zj.values);
+
+        for(size_t k = 0; k < s; k++)
+            ++monitor;
+
+        j += s;
+
+        if(j == m)
+        {
+            // restart from the true residual
+            cusp::multiply(exec, A, x, r);
+            cusp::blas::axpby(exec, b, r, r, ValueType(1), ValueType(-1));
+
+            j = 0;
+        }
+    }
+}
+
+} // end gmres_detail namespace
+
+template <typename DerivedPolicy,
+          typename LinearOperator,
+          typename VectorType1,
+          typename VectorType2,
+          typename Monitor,
+          typename ShiftType>
+void s_step_gmres(const thrust::detail::execution_policy_base<DerivedPolicy> &exec,
+                  const LinearOperator& A,
+                        VectorType1& x,
+                  const VectorType2& b,
+                  const size_t restart,
+                        Monitor& monitor,
+                  const cusp::array1d<ShiftType,cusp::host_memory>& shifts)
+{
+    using cusp::krylov::gmres_detail::s_step_gmres;
+
+    return s_step_gmres(thrust::detail::derived_cast(thrust::detail::strip_const(exec)), A, x, b, restart, monitor, shifts);
+}
+
+template <typename LinearOperator,
+          typename VectorType1,
+          typename VectorType2,
+          typename Monitor,
+          typename ShiftType>
+void s_step_gmres(const LinearOperator& A,
+                        VectorType1& x,
+                  const VectorType2& b,
+                  const size_t restart,
+                        Monitor& monitor,
+                  const cusp::array1d<ShiftType,cusp::host_memory>& shifts)
+{
+    using thrust::system::detail::generic::select_system;
+
+    typedef typename LinearOperator::memory_space System1;
+    typedef typename VectorType2::memory_space    System2;
+
+    System1 system1;
+    System2 system2;
+
+    return cusp::krylov::s_step_gmres(select_system(system1,system2), A, x, b, restart, monitor, shifts);
+}
+
+template <typename LinearOperator,
+          typename VectorType1,
+          typename VectorType2,
+          typename Monitor>
+void s_step_gmres(const LinearOperator& A,
+                        VectorType1& x,
+                  const VectorType2& b,
+                  const size_t restart,
+                        Monitor& monitor,
+                  const size_t s)
+{
+    typedef typename LinearOperator::value_type ValueType;
+
+    // the monomial basis
+    cusp::array1d<ValueType,cusp::host_memory> shifts(s, ValueType(0));
+
+    return cusp::krylov::s_step_gmres(A, x, b, restart, monitor, shifts);
+}
+
+template <typename LinearOperator,
+          typename VectorType1,
+          typename VectorType2>
+void s_step_gmres(const LinearOperator& A,
+                        VectorType1& x,
+                  const VectorType2& b,
+                  const size_t restart)
+{
+    typedef typename LinearOperator::value_type ValueType;
+
+    cusp::monitor<ValueType> monitor(b);
+
+    return cusp::krylov::s_step_gmres(A, x, b, restart, monitor);
+}
+
+} // end namespace krylov
+} // end namespace cusp
@@ -0,0 +1,110 @@
+/*
+ *  Copyright 2008-2014 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*! \file equilibrated_solve.h
+ *  \brief Solve through an equilibrated matrix
+ */
+
+#pragma once
+
+#include <cusp/detail/config.h>
+
+#include <cusp/detail/execution_policy.h>
+
+namespace cusp
+{
+namespace krylov
+{
+
+/*! \addtogroup iterative_solvers Iterative Solvers
+ *  \addtogroup krylov_methods Krylov Methods
+ *  \ingroup iterative_solvers
+ *  \{
+ */
+
+/* \cond */
+template <typename DerivedPolicy,
+          typename LinearOperator,
+          typename VectorType1,
+          typename VectorType2,
+          typename ArrayType1,
+          typename ArrayType2,
+          typename Solver,
+          typename Monitor,
+          typename Preconditioner>
+void equilibrated_solve(const thrust::detail::execution_policy_base<DerivedPolicy> &exec,
+                        const LinearOperator& A,
+                              VectorType1& x,
+                        const VectorType2& b,
+                        const ArrayType1& row_scale,
+                        const ArrayType2& column_scale,
+                              Solver& solver,
+                              Monitor& monitor,
+                              Preconditioner& M);
+/* \endcond */
+
+/**
+ * \brief Solves a linear system through its equilibrated matrix
+ *
+ * \tparam LinearOperator is a matrix or subclass of \p linear_operator
+ * \tparam VectorType1 vector
+ * \tparam VectorType2 vector
+ * \tparam ArrayType1 vector of row scaling factors
+ * \tparam ArrayType2 vector of column scaling factors
+ * \tparam Solver is a solver object such as \p cg_solver
+ * \tparam Monitor is a \p monitor
+ * \tparam Preconditioner is a matrix or subclass of \p linear_operator
+ *
+ * \param A the equilibrated matrix <tt>diag(row_scale) A0 diag(column_scale)</tt>
+ * \param x approximate solution of <tt>A0 x = b</tt>, also the initial guess
+ * \param b right-hand side of the original system
+ * \param row_scale row factors returned by \p cusp::equilibrate
+ * \param column_scale column factors returned by \p cusp::equilibrate
+ * \param solver solver object providing <tt>solver.solve(A, y, b, monitor, M)</tt>
+ * \param monitor monitors the iteration on the equilibrated system
+ * \param M preconditioner for \p A
+ *
+ * \par Overview
+ * Solves <tt>A y = diag(row_scale) b</tt> for <tt>y = x / column_scale</tt>
+ * and unscales the solution, <tt>x = diag(column_scale) y</tt>. The
+ * \p monitor is reset to the scaled right-hand side, its tolerances refer
+ * to the residual of the equilibrated system.
+ *
+ * \see \p equilibrate
+ */
+template <typename LinearOperator,
+          typename VectorType1,
+          typename VectorType2,
+          typename ArrayType1,
+          typename ArrayType2,
+          typename Solver,
+          typename Monitor,
+          typename Preconditioner>
+void equilibrated_solve(const LinearOperator& A,
+                              VectorType1& x,
+                        const VectorType2& b,
+                        const ArrayType1& row_scale,
+                        const ArrayType2& column_scale,
+                              Solver& solver,
+                              Monitor& monitor,
+                              Preconditioner& M);
+/*! \}
+ */
+
+} // end namespace krylov
+} // end namespace cusp
+
+#include <cusp/krylov/detail/equilibrated_solve.inl>
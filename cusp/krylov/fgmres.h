@@ -0,0 +1,194 @@
+/*
+ *  Copyright 2008-2014 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*! \file fgmres.h
+ *  \brief Flexible Generalized Minimum Residual (FGMRES) method
+ */
+
+#pragma once
+
+#include <cusp/detail/config.h>
+
+#include <cusp/krylov/gmres.h>
+
+#include <cusp/detail/execution_policy.h>
+
+#include <cstddef>
+
+namespace cusp
+{
+namespace krylov
+{
+
+/*! \addtogroup iterative_solvers Iterative Solvers
+ *  \addtogroup krylov_methods Krylov Methods
+ *  \ingroup iterative_solvers
+ *  \{
+ */
+
+/* \cond */
+
+template <typename DerivedPolicy,
+          typename LinearOperator,
+          typename VectorType1,
+          typename VectorType2,
+          typename Monitor,
+          typename Preconditioner>
+void fgmres(const thrust::detail::execution_policy_base<DerivedPolicy> &exec,
+            const LinearOperator& A,
+                  VectorType1& x,
+            const VectorType2& b,
+            const size_t restart,
+                  Monitor& monitor,
+                  Preconditioner& M);
+
+template <typename DerivedPolicy,
+          typename LinearOperator,
+          typename VectorType1,
+          typename VectorType2,
+          typename Monitor,
+          typename Preconditioner>
+void fgmres(const thrust::detail::execution_policy_base<DerivedPolicy> &exec,
+            const LinearOperator& A,
+                  VectorType1& x,
+            const VectorType2& b,
+            const size_t restart,
+                  Monitor& monitor,
+                  Preconditioner& M,
+            const gmres_orthogonalization orthogonalization);
+
+template <typename LinearOperator,
+          typename VectorType1,
+          typename VectorType2,
+          typename Monitor>
+void fgmres(const LinearOperator& A,
+                  VectorType1& x,
+            const VectorType2& b,
+            const size_t restart,
+                  Monitor& monitor);
+
+template <typename LinearOperator,
+          typename VectorType1,
+          typename VectorType2>
+void fgmres(const LinearOperator& A,
+                  VectorType1& x,
+            const VectorType2& b,
+            const size_t restart);
+
+/* \endcond */
+
+/**
+ * \brief Flexible GMRES method
+ *
+ * \tparam LinearOperator is a matrix or subclass of \p linear_operator
+ * \tparam VectorType1 vector
+ * \tparam Monitor is a monitor such as \p default_monitor or \p verbose_monitor
+ * \tparam Preconditioner is a matrix or subclass of \p linear_operator
+ *
+ * \param A matrix of the linear system
+ * \param x approximate solution of the linear system
+ * \param b right-hand side of the linear system
+ * \param restart the method every restart inner iterations
+ * \param monitor montiors iteration and determines stopping conditions
+ * \param M preconditioner for A
+ *
+ * \par Overview
+ * Solves the nonsymmetric, linear system A x = b with right
+ * preconditioner \p M. Unlike \p gmres the preconditioned Krylov vectors
+ * are stored, so \p M may change from one application to the next, e.g.
+ * a few AMG cycles or an inexact inner Krylov solve. This costs one more
+ * vector of storage per inner iteration. Since the preconditioner is
+ * applied from the right, \p monitor tracks the unpreconditioned residual
+ * norm. As with \p gmres, an overload taking a trailing
+ * \p gmres_orthogonalization argument selects the orthogonalization.
+ *
+ * \par Example
+ *
+ *  The following code snippet demonstrates how to use \p fgmres to
+ *  solve a 10x10 Poisson problem with a smoothed aggregation
+ *  preconditioner.
+ *
+ *  \code
+ *  #include <cusp/csr_matrix.h>
+ *  #include <cusp/monitor.h>
+ *  #include <cusp/krylov/fgmres.h>
+ *  #include <cusp/gallery/poisson.h>
+ *  #include <cusp/precond/aggregation/smoothed_aggregation.h>
+ *
+ *  int main(void)
+ *  {
+ *      // create an empty sparse matrix structure (CSR format)
+ *      cusp::csr_matrix<int, float, cusp::device_memory> A;
+ *
+ *      // initialize matrix
+ *      cusp::gallery::poisson5pt(A, 10, 10);
+ *
+ *      // allocate storage for solution (x) and right hand side (b)
+ *      cusp::array1d<float, cusp::device_memory> x(A.num_rows, 0);
+ *      cusp::array1d<float, cusp::device_memory> b(A.num_rows, 1);
+ *
+ *      // set stopping criteria:
+ *      //  iteration_limit    = 100
+ *      //  relative_tolerance = 1e-6
+ *      cusp::monitor<float> monitor(b, 100, 1e-6);
+ *      int restart = 20;
+ *
+ *      // set preconditioner (one V-cycle per application)
+ *      cusp::precond::aggregation::smoothed_aggregation<int, float, cusp::device_memory> M(A);
+ *
+ *      // solve the linear system A x = b
+ *      cusp::krylov::fgmres(A, x, b, restart, monitor, M);
+ *
+ *      return 0;
+ *  }
+ *  \endcode
+
+ *  \see \p gmres
+ *
+ */
+template <typename LinearOperator,
+          typename VectorType1,
+          typename VectorType2,
+          typename Monitor,
+          typename Preconditioner>
+void fgmres(const LinearOperator& A,
+                  VectorType1& x,
+            const VectorType2& b,
+            const size_t restart,
+                  Monitor& monitor,
+                  Preconditioner& M);
+
+/*! \cond */
+template <typename LinearOperator,
+          typename VectorType1,
+          typename VectorType2,
+          typename Monitor,
+          typename Preconditioner>
+void fgmres(const LinearOperator& A,
+                  VectorType1& x,
+            const VectorType2& b,
+            const size_t restart,
+                  Monitor& monitor,
+                  Preconditioner& M,
+            const gmres_orthogonalization orthogonalization);
+/*! \endcond */
+/*! \}
+*/
+
+} // end namespace krylov
+} // end namespace cusp
+
+#include <cusp/krylov/detail/fgmres.inl>
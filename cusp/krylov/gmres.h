@@ -22,6 +22,9 @@
 
 #include <cusp/detail/config.h>
 
+#include <cusp/array1d.h>
+#include <cusp/array2d.h>
+
 #include <cusp/detail/execution_policy.h>
 
 #include <cstddef>
@@ -37,6 +40,23 @@ namespace krylov
  *  \{
  */
 
+/**
+ * \brief Orthogonalization of the Krylov basis in \p gmres
+ *
+ * \par Overview
+ * \c modified_gram_schmidt orthogonalizes each new basis vector against the
+ * previous ones one at a time, which costs one \c dotc and one \c axpy per
+ * basis vector. \c classical_gram_schmidt projects against all previous
+ * basis vectors at once and repeats the projection a second time (CGS2) to
+ * retain the orthogonality of the modified variant, so every iteration
+ * performs a fixed number of reductions regardless of the restart length.
+ */
+enum gmres_orthogonalization
+{
+    modified_gram_schmidt,
+    classical_gram_schmidt
+};
+
 /* \cond */
 
 template <typename DerivedPolicy,
@@ -53,6 +73,21 @@ void gmres(const thrust::detail::execution_policy_base<DerivedPolicy> &exec,
                  Monitor& monitor,
                  Preconditioner& M);
 
+template <typename DerivedPolicy,
+          typename LinearOperator,
+          typename VectorType1,
+          typename VectorType2,
+          typename Monitor,
+          typename Preconditioner>
+void gmres(const thrust::detail::execution_policy_base<DerivedPolicy> &exec,
+           const LinearOperator& A,
+                 VectorType1& x,
+           const VectorType2& b,
+           const size_t restart,
+                 Monitor& monitor,
+                 Preconditioner& M,
+           const gmres_orthogonalization orthogonalization);
+
 template <typename LinearOperator,
           typename VectorType1,
           typename VectorType2,
@@ -90,7 +125,9 @@ void gmres(const LinearOperator& A,
  *
  * \par Overview
  * Solves the nonsymmetric, linear system A x = b
- * with preconditioner \p M.
+ * with preconditioner \p M. The Krylov basis is orthogonalized with
+ * modified Gram-Schmidt, an overload taking a trailing
+ * \p gmres_orthogonalization argument selects the alternatives.
  *
  * \par Example
  *
@@ -147,6 +184,138 @@ void gmres(const LinearOperator& A,
            const size_t restart,
                  Monitor& monitor,
                  Preconditioner& M);
+
+/*! \cond */
+template <typename LinearOperator,
+          typename VectorType1,
+          typename VectorType2,
+          typename Monitor,
+          typename Preconditioner>
+void gmres(const LinearOperator& A,
+                 VectorType1& x,
+           const VectorType2& b,
+           const size_t restart,
+                 Monitor& monitor,
+                 Preconditioner& M,
+           const gmres_orthogonalization orthogonalization);
+/*! \endcond */
+
+/**
+ * \brief GMRES solver owning its workspace
+ *
+ * \tparam ValueType scalar type of the linear system (e.g. \c float)
+ * \tparam MemorySpace memory space of the workspace (e.g. \c cusp::device_memory)
+ *
+ * \par Overview
+ * A \p gmres_solver performs the same iteration as \p gmres but keeps its
+ * Krylov basis and Hessenberg matrix between calls to \p solve. Repeated
+ * solves of systems with the same number of rows and restart length
+ * therefore perform no allocations.
+ *
+ *  \see \p gmres
+ */
+template <typename ValueType, typename MemorySpace>
+class gmres_solver
+{
+public:
+
+    /*! Construct a \p gmres_solver without workspace.
+     */
+    gmres_solver(void) : orthogonalization(modified_gram_schmidt) {}
+
+    /*! Construct a \p gmres_solver with workspace for \p N unknowns.
+     *
+     *  \param N number of rows of the linear systems to solve.
+     *  \param restart number of iterations between restarts.
+     *  \param orthogonalization orthogonalization of the Krylov basis.
+     */
+    gmres_solver(const size_t N, const size_t restart,
+                 const gmres_orthogonalization orthogonalization = modified_gram_schmidt);
+
+    /*! Set the orthogonalization of the Krylov basis used by \p solve.
+     */
+    void set_orthogonalization(const gmres_orthogonalization orthogonalization)
+    {
+        this->orthogonalization = orthogonalization;
+    }
+
+    /*! Resize the workspace for \p N unknowns.
+     *
+     *  \param N number of rows of the linear systems to solve.
+     *  \param restart number of iterations between restarts.
+     */
+    void resize(const size_t N, const size_t restart);
+
+    /*! Solve A x = b with preconditioner \p M, see \p gmres.
+     */
+    template <typename DerivedPolicy,
+              typename LinearOperator,
+              typename VectorType1,
+              typename VectorType2,
+              typename Monitor,
+              typename Preconditioner>
+    void solve(const thrust::detail::execution_policy_base<DerivedPolicy> &exec,
+               const LinearOperator& A,
+                     VectorType1& x,
+               const VectorType2& b,
+               const size_t restart,
+                     Monitor& monitor,
+                     Preconditioner& M);
+
+    /*! Solve A x = b with preconditioner \p M, see \p gmres.
+     */
+    template <typename LinearOperator,
+              typename VectorType1,
+              typename VectorType2,
+              typename Monitor,
+              typename Preconditioner>
+    void solve(const LinearOperator& A,
+                     VectorType1& x,
+               const VectorType2& b,
+               const size_t restart,
+                     Monitor& monitor,
+                     Preconditioner& M);
+
+    /*! Solve A x = b without preconditioner, see \p gmres.
+     */
+    template <typename LinearOperator,
+              typename VectorType1,
+              typename VectorType2,
+              typename Monitor>
+    void solve(const LinearOperator& A,
+                     VectorType1& x,
+               const VectorType2& b,
+               const size_t restart,
+                     Monitor& monitor);
+
+    /*! Solve A x = b with the default \p monitor, see \p gmres.
+     */
+    template <typename LinearOperator,
+              typename VectorType1,
+              typename VectorType2>
+    void solve(const LinearOperator& A,
+                     VectorType1& x,
+               const VectorType2& b,
+               const size_t restart);
+
+private:
+
+    /*! \cond */
+    cusp::array1d<ValueType,MemorySpace> w;
+    cusp::array1d<ValueType,MemorySpace> V0;
+    cusp::array2d<ValueType,MemorySpace,cusp::column_major> V;
+    cusp::array1d<ValueType,MemorySpace> sDev;
+
+    cusp::array2d<ValueType,cusp::host_memory,cusp::column_major> H;
+    cusp::array1d<ValueType,cusp::host_memory> s;
+    cusp::array1d<ValueType,cusp::host_memory> cs;
+    cusp::array1d<ValueType,cusp::host_memory> sn;
+    cusp::array1d<ValueType,cusp::host_memory> resid;
+    cusp::array1d<ValueType,cusp::host_memory> h;
+
+    gmres_orthogonalization orthogonalization;
+    /*! \endcond */
+};
 /*! \}
 */
 
@@ -0,0 +1,170 @@
+/*
+ *  Copyright 2008-2014 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*! \file iterative_refinement.h
+ *  \brief Mixed-precision iterative refinement
+ */
+
+#pragma once
+
+#include <cusp/detail/config.h>
+
+#include <cusp/detail/execution_policy.h>
+
+namespace cusp
+{
+namespace krylov
+{
+
+/*! \addtogroup iterative_solvers Iterative Solvers
+ *  \addtogroup krylov_methods Krylov Methods
+ *  \ingroup iterative_solvers
+ *  \{
+ */
+
+/* \cond */
+template <typename DerivedPolicy,
+          typename LinearOperator1,
+          typename VectorType1,
+          typename VectorType2,
+          typename Monitor1,
+          typename LinearOperator2,
+          typename InnerSolver,
+          typename Monitor2,
+          typename Preconditioner>
+void iterative_refinement(const thrust::detail::execution_policy_base<DerivedPolicy> &exec,
+                          const LinearOperator1& A,
+                                VectorType1& x,
+                          const VectorType2& b,
+                                Monitor1& monitor,
+                          const LinearOperator2& A_inner,
+                                InnerSolver& solver,
+                                Monitor2& inner_monitor,
+                                Preconditioner& M);
+
+template <typename LinearOperator1,
+          typename VectorType1,
+          typename VectorType2,
+          typename Monitor1,
+          typename LinearOperator2,
+          typename InnerSolver,
+          typename Monitor2>
+void iterative_refinement(const LinearOperator1& A,
+                                VectorType1& x,
+                          const VectorType2& b,
+                                Monitor1& monitor,
+                          const LinearOperator2& A_inner,
+                                InnerSolver& solver,
+                                Monitor2& inner_monitor);
+/* \endcond */
+
+/**
+ * \brief Mixed-precision iterative refinement
+ *
+ * \tparam LinearOperator1 is a matrix or subclass of \p linear_operator
+ * \tparam VectorType1 vector
+ * \tparam VectorType2 vector
+ * \tparam Monitor1 is a monitor such as \p default_monitor or \p verbose_monitor
+ * \tparam LinearOperator2 is a matrix or subclass of \p linear_operator
+ * \tparam InnerSolver is a solver object such as \p cg_solver
+ * \tparam Monitor2 is a monitor such as \p default_monitor or \p verbose_monitor
+ * \tparam Preconditioner is a matrix or subclass of \p linear_operator
+ *
+ * \param A matrix of the linear system
+ * \param x approximate solution of the linear system
+ * \param b right-hand side of the linear system
+ * \param monitor monitors the refinement steps and their residual
+ * \param A_inner copy of \p A in the precision of the inner solver
+ * \param solver inner solver for the correction equation
+ * \param inner_monitor stopping criteria of each inner solve, reset
+ *        to the current residual before every refinement step
+ * \param M preconditioner for \p A_inner
+ *
+ * \par Overview
+ * Solves A x = b by repeatedly solving the correction equation
+ * A_inner d = r for the residual r = b - A x in the lower precision of
+ * \p A_inner, then updating x += d and the residual in the precision of
+ * \p A. The inner solves only need to reduce the residual by a modest
+ * factor, while memory bound kernels like SpMV move half the bytes in
+ * single precision. The final accuracy is determined by the residual
+ * computed with \p A.
+ *
+ * \p solver may be any object providing
+ * <tt>solver.solve(A_inner, d, r, inner_monitor, M)</tt>, e.g. \p cg_solver,
+ * \p cr_solver or \p bicgstab_solver, or a small wrapper around \p gmres
+ * binding the restart length. A preconditioner such as
+ * \p smoothed_aggregation should be constructed from \p A_inner, so
+ * that its hierarchy is stored in the lower precision as well.
+ *
+ * \par Example
+ *
+ *  \code
+ *  #include <cusp/csr_matrix.h>
+ *  #include <cusp/monitor.h>
+ *  #include <cusp/krylov/cg.h>
+ *  #include <cusp/krylov/iterative_refinement.h>
+ *  #include <cusp/gallery/poisson.h>
+ *  #include <cusp/precond/aggregation/smoothed_aggregation.h>
+ *
+ *  int main(void)
+ *  {
+ *      cusp::csr_matrix<int, double, cusp::device_memory> A;
+ *      cusp::gallery::poisson5pt(A, 256, 256);
+ *
+ *      // single precision copy of the matrix and its AMG hierarchy
+ *      cusp::csr_matrix<int, float, cusp::device_memory> A_float(A);
+ *      cusp::precond::aggregation::smoothed_aggregation<int, float, cusp::device_memory> M(A_float);
+ *
+ *      cusp::array1d<double, cusp::device_memory> x(A.num_rows, 0);
+ *      cusp::array1d<double, cusp::device_memory> b(A.num_rows, 1);
+ *
+ *      // solve to 1e-12 in double, each inner solve reduces by 1e-4 in float
+ *      cusp::monitor<double> monitor(b, 20, 1e-12);
+ *      cusp::monitor<float>  inner_monitor(b, 100, 1e-4);
+ *
+ *      cusp::krylov::cg_solver<float, cusp::device_memory> solver(A.num_rows);
+ *
+ *      cusp::krylov::iterative_refinement(A, x, b, monitor, A_float, solver, inner_monitor, M);
+ *
+ *      return 0;
+ *  }
+ *  \endcode
+ *
+ *  \see \p monitor
+ */
+template <typename LinearOperator1,
+          typename VectorType1,
+          typename VectorType2,
+          typename Monitor1,
+          typename LinearOperator2,
+          typename InnerSolver,
+          typename Monitor2,
+          typename Preconditioner>
+void iterative_refinement(const LinearOperator1& A,
+                                VectorType1& x,
+                          const VectorType2& b,
+                                Monitor1& monitor,
+                          const LinearOperator2& A_inner,
+                                InnerSolver& solver,
+                                Monitor2& inner_monitor,
+                                Preconditioner& M);
+/*! \}
+ */
+
+} // end namespace krylov
+} // end namespace cusp
+
+#include <cusp/krylov/detail/iterative_refinement.inl>
@@ -0,0 +1,155 @@
+/*
+ *  Copyright 2008-2014 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*! \file pipelined_bicgstab.h
+ *  \brief Pipelined Biconjugate Gradient Stabilized (BiCGstab) method
+ */
+
+#pragma once
+
+#include <cusp/detail/config.h>
+
+#include <cusp/detail/execution_policy.h>
+
+namespace cusp
+{
+namespace krylov
+{
+
+/*! \addtogroup iterative_solvers Iterative Solvers
+ *  \addtogroup krylov_methods Krylov Methods
+ *  \ingroup iterative_solvers
+ *  \{
+ */
+
+/* \cond */
+template <typename DerivedPolicy,
+          typename LinearOperator,
+          typename VectorType1,
+          typename VectorType2,
+          typename Monitor,
+          typename Preconditioner>
+void pipelined_bicgstab(const thrust::detail::execution_policy_base<DerivedPolicy> &exec,
+                        const LinearOperator& A,
+                              VectorType1& x,
+                        const VectorType2& b,
+                              Monitor& monitor,
+                              Preconditioner& M);
+
+template <typename LinearOperator,
+          typename VectorType1,
+          typename VectorType2,
+          typename Monitor>
+void pipelined_bicgstab(const LinearOperator& A,
+                              VectorType1& x,
+                        const VectorType2& b,
+                              Monitor& monitor);
+
+template <typename LinearOperator,
+          typename VectorType1,
+          typename VectorType2>
+void pipelined_bicgstab(const LinearOperator& A,
+                              VectorType1& x,
+                        const VectorType2& b);
+/* \endcond */
+
+/**
+ * \brief Pipelined Biconjugate Gradient Stabilized method
+ *
+ * \tparam LinearOperator is a matrix or subclass of \p linear_operator
+ * \tparam VectorType1 x input vector type
+ * \tparam VectorType2 b output vector type
+ * \tparam Monitor is a \p monitor
+ * \tparam Preconditioner is a matrix or subclass of \p linear_operator
+ *
+ * \param A matrix of the linear system
+ * \param x approximate solution of the linear system
+ * \param b right-hand side of the linear system
+ * \param monitor monitors iteration and determines stopping conditions
+ * \param M preconditioner for A
+ *
+ * \par Overview
+ * Solves the linear system A x = b with right preconditioner \p M using
+ * the recurrences of Cools and Vanroose. The products with \p A and \p M
+ * of the search directions are carried along as auxiliary vectors, hence
+ * the two inner products needed for \c omega and the four inner products
+ * needed for \c alpha and \c beta are each computed in a single pass
+ * together with the vector updates. An iteration performs two global
+ * reductions, in addition to the residual norm computed by the
+ * \p monitor, compared to four for \p bicgstab. With the policies of
+ * \p cusp::distributed both reductions are summed over the ranks with a
+ * nonblocking \c MPI_Iallreduce while the following products with \p M
+ * and \p A are computed.
+ *
+ * \note The recurrences accumulate rounding errors faster than those of
+ * \p bicgstab, hence the attainable accuracy may be slightly lower. The
+ * workspace holds fifteen vectors of length \p N.
+ *
+ * \par Example
+ *  The following code snippet demonstrates how to use \p pipelined_bicgstab
+ *  to solve a 10x10 Poisson problem.
+ *
+ *  \code
+ *  #include <cusp/csr_matrix.h>
+ *  #include <cusp/monitor.h>
+ *  #include <cusp/krylov/pipelined_bicgstab.h>
+ *  #include <cusp/gallery/poisson.h>
+ *
+ *  int main(void)
+ *  {
+ *      // create an empty sparse matrix structure (CSR format)
+ *      cusp::csr_matrix<int, float, cusp::device_memory> A;
+ *
+ *      // initialize matrix
+ *      cusp::gallery::poisson5pt(A, 10, 10);
+ *
+ *      // allocate storage for solution (x) and right hand side (b)
+ *      cusp::array1d<float, cusp::device_memory> x(A.num_rows, 0);
+ *      cusp::array1d<float, cusp::device_memory> b(A.num_rows, 1);
+ *
+ *      // set stopping criteria:
+ *      //  iteration_limit    = 100
+ *      //  relative_tolerance = 1e-6
+ *      cusp::monitor<float> monitor(b, 100, 1e-6, 0, true);
+ *
+ *      // solve the linear system A x = b
+ *      cusp::krylov::pipelined_bicgstab(A, x, b, monitor);
+ *
+ *      return 0;
+ *  }
+ *  \endcode
+ *
+ *  \see \p bicgstab
+ *  \see \p monitor
+ *
+ */
+template <typename LinearOperator,
+          typename VectorType1,
+          typename VectorType2,
+          typename Monitor,
+          typename Preconditioner>
+void pipelined_bicgstab(const LinearOperator& A,
+                              VectorType1& x,
+                        const VectorType2& b,
+                              Monitor& monitor,
+                              Preconditioner& M);
+/*! \}
+ */
+
+} // end namespace krylov
+} // end namespace cusp
+
+#include <cusp/krylov/detail/pipelined_bicgstab.inl>
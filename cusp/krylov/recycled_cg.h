@@ -0,0 +1,231 @@
+/*
+ *  Copyright 2008-2014 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*! \file recycled_cg.h
+ *  \brief Deflated Conjugate Gradient method recycling a subspace across
+ *  sequences of related systems
+ */
+
+#pragma once
+
+#include <cusp/detail/config.h>
+
+#include <cusp/array1d.h>
+#include <cusp/array2d.h>
+
+#include <cusp/detail/execution_policy.h>
+
+#include <vector>
+
+namespace cusp
+{
+namespace krylov
+{
+
+/*! \addtogroup iterative_solvers Iterative Solvers
+ *  \addtogroup krylov_methods Krylov Methods
+ *  \ingroup iterative_solvers
+ *  \{
+ */
+
+/**
+ * \brief Deflated Conjugate Gradient solver recycling a subspace between
+ * solves
+ *
+ * \tparam ValueType real scalar type of the linear systems (e.g. \c float)
+ * \tparam MemorySpace memory space of the workspace and of the recycled
+ * subspace (e.g. \c cusp::device_memory)
+ *
+ * \par Overview
+ * A \p recycled_cg_solver solves a sequence of slowly varying symmetric
+ * positive-definite systems A_i x = b_i, as they arise in time stepping,
+ * with the deflated preconditioned CG method of Saad, Yeung, Erhel and
+ * Guyomarc'h. Every iterate is kept A-orthogonal to a deflation basis
+ * \c W of at most \p num_vectors columns, which removes the slowest
+ * converging part of the spectrum of M^{-1} A from the iteration.
+ *
+ * \c W is harvested from the solves themselves: the first
+ * \p num_harvest preconditioned residuals of every solve are kept as
+ * Lanczos vectors, and the Lanczos relation of CG turns the recurrence
+ * coefficients into the projection of \c A onto them. A Rayleigh-Ritz
+ * step on the span of the old basis and these vectors, whose matrix is
+ * assembled on the host without further products with \c A or \c M,
+ * selects the Ritz vectors of the smallest Ritz values as the basis of
+ * the next solve. The basis stays in \p MemorySpace between calls.
+ *
+ * At the start of every solve \c AW is recomputed for the current
+ * matrix, costing \c num_vectors products with \c A that the
+ * \p monitor does not count. The first solve is plain preconditioned CG.
+ * Call \p reset when the sequence of systems changes abruptly.
+ *
+ * \note \p A and \p M must be symmetric and positive-definite.
+ *
+ * \par Example
+ *  \code
+ *  cusp::krylov::recycled_cg_solver<float, cusp::device_memory> solver(A.num_rows);
+ *
+ *  for (int step = 0; step < num_steps; step++)
+ *  {
+ *      update_system(A, b, step);
+ *
+ *      cusp::monitor<float> monitor(b, 100, 1e-6);
+ *      solver.solve(A, x, b, monitor, M);
+ *  }
+ *  \endcode
+ *
+ *  \see \p cg_solver
+ */
+template <typename ValueType, typename MemorySpace>
+class recycled_cg_solver
+{
+public:
+
+    /*! Construct a \p recycled_cg_solver without workspace.
+     */
+    recycled_cg_solver(void);
+
+    /*! Construct a \p recycled_cg_solver with workspace for \p N unknowns.
+     *
+     *  \param N number of rows of the linear systems to solve.
+     *  \param num_vectors maximum number of columns of the deflation basis.
+     *  \param num_harvest number of Lanczos vectors kept from every solve.
+     */
+    recycled_cg_solver(const size_t N,
+                       const size_t num_vectors = 8,
+                       const size_t num_harvest = 24);
+
+    /*! Resize the workspace for \p N unknowns, discarding the deflation
+     *  basis if \p N changes.
+     *
+     *  \param N number of rows of the linear systems to solve.
+     */
+    void resize(const size_t N);
+
+    /*! Discard the deflation basis, the next solve is plain CG.
+     */
+    void reset(void);
+
+    /*! Number of columns of the current deflation basis.
+     */
+    size_t deflation_size(void) const;
+
+    /*! Solve A x = b with preconditioner \p M and update the deflation
+     *  basis.
+     */
+    template <typename DerivedPolicy,
+              typename LinearOperator,
+              typename VectorType1,
+              typename VectorType2,
+              typename Monitor,
+              typename Preconditioner>
+    void solve(const thrust::detail::execution_policy_base<DerivedPolicy> &exec,
+               const LinearOperator& A,
+                     VectorType1& x,
+               const VectorType2& b,
+                     Monitor& monitor,
+                     Preconditioner& M);
+
+    /*! Solve A x = b with preconditioner \p M and update the deflation
+     *  basis.
+     */
+    template <typename LinearOperator,
+              typename VectorType1,
+              typename VectorType2,
+              typename Monitor,
+              typename Preconditioner>
+    void solve(const LinearOperator& A,
+                     VectorType1& x,
+               const VectorType2& b,
+                     Monitor& monitor,
+                     Preconditioner& M);
+
+    /*! Solve A x = b without preconditioner and update the deflation
+     *  basis.
+     */
+    template <typename LinearOperator,
+              typename VectorType1,
+              typename VectorType2,
+              typename Monitor>
+    void solve(const LinearOperator& A,
+                     VectorType1& x,
+               const VectorType2& b,
+                     Monitor& monitor);
+
+    /*! Solve A x = b with the default \p monitor and update the deflation
+     *  basis.
+     */
+    template <typename LinearOperator,
+              typename VectorType1,
+              typename VectorType2>
+    void solve(const LinearOperator& A,
+                     VectorType1& x,
+               const VectorType2& b);
+
+private:
+
+    /*! \cond */
+    typedef cusp::array2d<ValueType,MemorySpace,cusp::column_major> Block;
+
+    template <typename DerivedPolicy, typename LinearOperator>
+    void refresh(thrust::execution_policy<DerivedPolicy> &exec,
+                 const LinearOperator& A);
+
+    template <typename DerivedPolicy, typename Array1d>
+    void project(thrust::execution_policy<DerivedPolicy> &exec,
+                 const Block& B,
+                 const Array1d& v);
+
+    template <typename DerivedPolicy>
+    void store_lanczos(thrust::execution_policy<DerivedPolicy> &exec,
+                       const ValueType rz);
+
+    template <typename DerivedPolicy>
+    void harvest(thrust::execution_policy<DerivedPolicy> &exec);
+
+    size_t max_vectors;
+    size_t harvest_size;
+
+    cusp::array1d<ValueType,MemorySpace> y;
+    cusp::array1d<ValueType,MemorySpace> z;
+    cusp::array1d<ValueType,MemorySpace> r;
+    cusp::array1d<ValueType,MemorySpace> p;
+
+    // deflation basis, its image under A and (W^T A W)^{-1}
+    Block W;
+    Block AW;
+    cusp::array2d<ValueType,MemorySpace> Einv;
+
+    // Lanczos vectors of the current solve and the coefficients of their
+    // components along W
+    Block V;
+    cusp::array1d<ValueType,MemorySpace> U;
+
+    cusp::array1d<ValueType,MemorySpace> h;
+    cusp::array1d<ValueType,MemorySpace> mu;
+
+    cusp::array1d<double,cusp::host_memory> E;
+    std::vector<double> alphas;
+    std::vector<double> betas;
+    std::vector<double> scales;
+    /*! \endcond */
+};
+/*! \}
+ */
+
+} // end namespace krylov
+} // end namespace cusp
+
+#include <cusp/krylov/detail/recycled_cg.inl>
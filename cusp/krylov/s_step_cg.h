@@ -0,0 +1,162 @@
+/*
+ *  Copyright 2008-2014 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+
+/*! \file s_step_cg.h
+ *  \brief s-step (communication-avoiding) Conjugate Gradient method
+ */
+
+#pragma once
+
+#include <cusp/detail/config.h>
+
+#include <cusp/array1d.h>
+
+#include <cusp/detail/execution_policy.h>
+
+namespace cusp
+{
+namespace krylov
+{
+
+/*! \addtogroup iterative_solvers Iterative Solvers
+ *  \addtogroup krylov_methods Krylov Methods
+ *  \ingroup iterative_solvers
+ *  \{
+ */
+
+/* \cond */
+template <typename DerivedPolicy,
+          typename LinearOperator,
+          typename VectorType1,
+          typename VectorType2,
+          typename Monitor,
+          typename ShiftType>
+void s_step_cg(const thrust::detail::execution_policy_base<DerivedPolicy> &exec,
+               const LinearOperator& A,
+                     VectorType1& x,
+               const VectorType2& b,
+                     Monitor& monitor,
+               const cusp::array1d<ShiftType,cusp::host_memory>& shifts);
+
+template <typename LinearOperator,
+          typename VectorType1,
+          typename VectorType2,
+          typename Monitor,
+          typename ShiftType>
+void s_step_cg(const LinearOperator& A,
+                     VectorType1& x,
+               const VectorType2& b,
+                     Monitor& monitor,
+               const cusp::array1d<ShiftType,cusp::host_memory>& shifts);
+
+template <typename LinearOperator,
+          typename VectorType1,
+          typename VectorType2>
+void s_step_cg(const LinearOperator& A,
+                     VectorType1& x,
+               const VectorType2& b);
+/* \endcond */
+
+/**
+ * \brief s-step Conjugate Gradient method
+ *
+ * \tparam LinearOperator is a matrix or subclass of \p linear_operator
+ * \tparam VectorType1 x input vector type
+ * \tparam VectorType2 b output vector type
+ * \tparam Monitor is a \p monitor
+ *
+ * \param A matrix of the linear system
+ * \param x approximate solution of the linear system
+ * \param b right-hand side of the linear system
+ * \param monitor monitors iteration and determines stopping conditions
+ * \param s number of CG iterations per outer iteration
+ *
+ * \par Overview
+ * Solves the symmetric, positive-definite linear system A x = b with the
+ * s-step method of Chronopoulos and Gear. An outer iteration computes the
+ * basis <tt>K = [r, A r, ..., A^(s-1) r]</tt> and <tt>A K</tt> with
+ * \p cusp::matrix_powers, makes \c K conjugate to the previous block of
+ * search directions and minimizes the A-norm of the error over the new
+ * block, which is \c s iterations of \p cg in exact arithmetic. All inner
+ * products of an outer iteration come from one block product of the basis
+ * and the previous directions, so the method needs one global reduction
+ * per \c s iterations, plus the residual norm computed by the \p monitor,
+ * instead of three per iteration. The \p monitor counts \c s iterations
+ * per outer iteration.
+ *
+ * The overload taking \c s shifts builds the Newton basis instead of the
+ * monomial one, see \p cusp::matrix_powers, which keeps larger \c s
+ * stable. With the monomial basis \c s should not exceed 5 or so.
+ *
+ * \note \p A must be symmetric, positive-definite and real. The workspace
+ * holds <tt>6 s + 3</tt> vectors of length \p N.
+ *
+ * \par Example
+ *  The following code snippet demonstrates how to use \p s_step_cg to
+ *  solve a 10x10 Poisson problem.
+ *
+ *  \code
+ *  #include <cusp/csr_matrix.h>
+ *  #include <cusp/monitor.h>
+ *  #include <cusp/krylov/s_step_cg.h>
+ *  #include <cusp/gallery/poisson.h>
+ *
+ *  int main(void)
+ *  {
+ *      // create an empty sparse matrix structure (CSR format)
+ *      cusp::csr_matrix<int, double, cusp::device_memory> A;
+ *
+ *      // initialize matrix
+ *      cusp::gallery::poisson5pt(A, 10, 10);
+ *
+ *      // allocate storage for solution (x) and right hand side (b)
+ *      cusp::array1d<double, cusp::device_memory> x(A.num_rows, 0);
+ *      cusp::array1d<double, cusp::device_memory> b(A.num_rows, 1);
+ *
+ *      // set stopping criteria:
+ *      //  iteration_limit    = 100
+ *      //  relative_tolerance = 1e-6
+ *      cusp::monitor<double> monitor(b, 100, 1e-6, 0, true);
+ *
+ *      // solve the linear system A x = b, four iterations at a time
+ *      cusp::krylov::s_step_cg(A, x, b, monitor, 4);
+ *
+ *      return 0;
+ *  }
+ *  \endcode
+ *
+ *  \see \p cg
+ *  \see \p matrix_powers
+ *  \see \p monitor
+ *
+ */
+template <typename LinearOperator,
+          typename VectorType1,
+          typename VectorType2,
+          typename Monitor>
+void s_step_cg(const LinearOperator& A,
+                     VectorType1& x,
+               const VectorType2& b,
+                     Monitor& monitor,
+               const size_t s = 4);
+/*! \}
+ */
+
+} // end namespace krylov
+} // end namespace cusp
+
+#include <cusp/krylov/detail/s_step_cg.inl>
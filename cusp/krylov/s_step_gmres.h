@@ -0,0 +1,168 @@
+/*
+ *  Copyright 2008-2014 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+
+/*! \file s_step_gmres.h
+ *  \brief s-step (communication-avoiding) GMRES method
+ */
+
+#pragma once
+
+#include <cusp/detail/config.h>
+
+#include <cusp/array1d.h>
+
+#include <cusp/detail/execution_policy.h>
+
+namespace cusp
+{
+namespace krylov
+{
+
+/*! \addtogroup iterative_solvers Iterative Solvers
+ *  \addtogroup krylov_methods Krylov Methods
+ *  \ingroup iterative_solvers
+ *  \{
+ */
+
+/* \cond */
+template <typename DerivedPolicy,
+          typename LinearOperator,
+          typename VectorType1,
+          typename VectorType2,
+          typename Monitor,
+          typename ShiftType>
+void s_step_gmres(const thrust::detail::execution_policy_base<DerivedPolicy> &exec,
+                  const LinearOperator& A,
+                        VectorType1& x,
+                  const VectorType2& b,
+                  const size_t restart,
+                        Monitor& monitor,
+                  const cusp::array1d<ShiftType,cusp::host_memory>& shifts);
+
+template <typename LinearOperator,
+          typename VectorType1,
+          typename VectorType2,
+          typename Monitor,
+          typename ShiftType>
+void s_step_gmres(const LinearOperator& A,
+                        VectorType1& x,
+                  const VectorType2& b,
+                  const size_t restart,
+                        Monitor& monitor,
+                  const cusp::array1d<ShiftType,cusp::host_memory>& shifts);
+
+template <typename LinearOperator,
+          typename VectorType1,
+          typename VectorType2>
+void s_step_gmres(const LinearOperator& A,
+                        VectorType1& x,
+                  const VectorType2& b,
+                  const size_t restart);
+/* \endcond */
+
+/**
+ * \brief s-step GMRES method
+ *
+ * \tparam LinearOperator is a matrix or subclass of \p linear_operator
+ * \tparam VectorType1 x input vector type
+ * \tparam VectorType2 b output vector type
+ * \tparam Monitor is a \p monitor
+ *
+ * \param A matrix of the linear system
+ * \param x approximate solution of the linear system
+ * \param b right-hand side of the linear system
+ * \param restart the method every restart inner iterations, rounded down
+ * to a multiple of \c s
+ * \param monitor monitors iteration and determines stopping conditions
+ * \param s number of inner iterations per block
+ *
+ * \par Overview
+ * Solves the nonsymmetric, linear system A x = b with an s-step variant of
+ * restarted \p gmres. A block computes the basis
+ * <tt>V = [r, A r, ..., A^s r]</tt> with \p cusp::matrix_powers and all
+ * inner products of \c V and of the orthonormal images \c Z of the
+ * previous search directions with one block product. The block
+ * orthogonalization of <tt>A V(:,0:s)</tt> against \c Z and the Cholesky
+ * QR of the remainder then run on the small Gram matrices on the host,
+ * and the residual is minimized over the new directions as in GCR, which
+ * is \c s iterations of \p gmres in exact arithmetic. The method needs one
+ * global reduction per \c s iterations, plus the residual norm computed by
+ * the \p monitor, and counts \c s iterations per block.
+ *
+ * The overload taking \c s shifts builds the Newton basis instead of the
+ * monomial one, see \p cusp::matrix_powers. If the basis loses rank the
+ * method restarts early.
+ *
+ * \note \p A must be real. The workspace holds <tt>2 restart + 2 s + 2</tt>
+ * vectors of length \p N.
+ *
+ * \par Example
+ *  The following code snippet demonstrates how to use \p s_step_gmres to
+ *  solve a 10x10 Poisson problem.
+ *
+ *  \code
+ *  #include <cusp/csr_matrix.h>
+ *  #include <cusp/monitor.h>
+ *  #include <cusp/krylov/s_step_gmres.h>
+ *  #include <cusp/gallery/poisson.h>
+ *
+ *  int main(void)
+ *  {
+ *      // create an empty sparse matrix structure (CSR format)
+ *      cusp::csr_matrix<int, double, cusp::device_memory> A;
+ *
+ *      // initialize matrix
+ *      cusp::gallery::poisson5pt(A, 10, 10);
+ *
+ *      // allocate storage for solution (x) and right hand side (b)
+ *      cusp::array1d<double, cusp::device_memory> x(A.num_rows, 0);
+ *      cusp::array1d<double, cusp::device_memory> b(A.num_rows, 1);
+ *
+ *      // set stopping criteria:
+ *      //  iteration_limit    = 100
+ *      //  relative_tolerance = 1e-6
+ *      cusp::monitor<double> monitor(b, 100, 1e-6, 0, true);
+ *
+ *      // solve the linear system A x = b, restarting every 20 iterations
+ *      cusp::krylov::s_step_gmres(A, x, b, 20, monitor, 4);
+ *
+ *      return 0;
+ *  }
+ *  \endcode
+ *
+ *  \see \p gmres
+ *  \see \p matrix_powers
+ *  \see \p monitor
+ *
+ */
+template <typename LinearOperator,
+          typename VectorType1,
+          typename VectorType2,
+          typename Monitor>
+void s_step_gmres(const LinearOperator& A,
+                        VectorType1& x,
+                  const VectorType2& b,
+                  const size_t restart,
+                        Monitor& monitor,
+                  const size_t s = 4);
+/*! \}
+ */
+
+} // end namespace krylov
+} // end namespace cusp
+
+#include <cusp/krylov/detail/s_step_gmres.inl>
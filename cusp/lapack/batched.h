@@ -0,0 +1,386 @@
+/*
+ *  Copyright 2008-2014 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*! \file batched.h
+ *  \brief Batched dense factorizations and eigensolvers for many small matrices
+ */
+
+#pragma once
+
+#include <cusp/detail/config.h>
+
+#include <cusp/detail/execution_policy.h>
+
+namespace cusp
+{
+namespace lapack
+{
+
+/*! \addtogroup dense Dense Algorithms
+ *  \addtogroup lapack LAPACK
+ *  \ingroup dense
+ *  \{
+ */
+
+/*! \p batched_gemm, \p batched_getrf, \p batched_getrs, \p batched_potrf,
+ *  \p batched_syev and \p batched_sygv operate on a batch of small dense
+ *  matrices that are stored side by side in a single \p array2d : the
+ *  <tt>k</tt>-th m-by-n matrix of a batch occupies columns
+ *  <tt>[k*n, (k+1)*n)</tt> of an m-by-(n*num_matrices) matrix. Per matrix
+ *  vectors such as pivots and eigenvalues are stored contiguously in an
+ *  \p array1d of length n*num_matrices and per matrix status codes in an
+ *  \p array1d of length num_matrices.
+ *
+ *  Each matrix is processed by one thread of the execution policy, so the
+ *  routines run where the batch resides and do not require LAPACK. They
+ *  are intended for matrices of order up to a few dozen, such as the
+ *  projected problems of block eigensolvers and Krylov methods.
+ */
+
+/*! \cond */
+template<typename DerivedPolicy,
+         typename Array2d1,
+         typename Array2d2,
+         typename Array2d3>
+void batched_gemm(const thrust::detail::execution_policy_base<DerivedPolicy> &exec,
+                  const Array2d1& A,
+                  const Array2d2& B,
+                        Array2d3& C,
+                  const typename Array2d1::value_type alpha = 1.0,
+                  const typename Array2d1::value_type beta  = 0.0);
+/*! \endcond */
+
+/**
+ * \brief Multiplies each matrix of a batch by the corresponding matrix of
+ * a second batch
+ *
+ * \tparam Array2d1 Type of the first input batch
+ * \tparam Array2d2 Type of the second input batch
+ * \tparam Array2d3 Type of the output batch
+ *
+ * \param A Batch of m-by-k matrices, stored as an m-by-(k*num_matrices) matrix
+ * \param B Batch of k-by-n matrices, stored as a k-by-(n*num_matrices) matrix
+ * \param C Batch of m-by-n matrices, stored as an m-by-(n*num_matrices) matrix
+ * \param alpha Scale factor of the products
+ * \param beta Scale factor of the initial contents of \p C
+ *
+ * \par Overview
+ * Computes <tt>C_k = alpha * A_k * B_k + beta * C_k</tt> for every matrix
+ * of the batch. The number of matrices is <tt>A.num_cols / B.num_rows</tt>.
+ * When \p beta is zero the initial contents of \p C are not read.
+ *
+ * \par Example
+ * \code
+ * #include <cusp/array2d.h>
+ * #include <cusp/print.h>
+ *
+ * // include cusp batched lapack header file
+ * #include <cusp/lapack/batched.h>
+ *
+ * int main()
+ * {
+ *   // two 2x2 matrices stored side by side
+ *   cusp::array2d<float,cusp::device_memory> A(2, 4, 1.0f);
+ *   cusp::array2d<float,cusp::device_memory> B(2, 4, 2.0f);
+ *   cusp::array2d<float,cusp::device_memory> C(2, 4);
+ *
+ *   // compute C_k = A_k * B_k
+ *   cusp::lapack::batched_gemm(A, B, C);
+ *
+ *   // print the products
+ *   cusp::print(C);
+ * }
+ * \endcode
+ */
+template<typename Array2d1,
+         typename Array2d2,
+         typename Array2d3>
+void batched_gemm(const Array2d1& A,
+                  const Array2d2& B,
+                        Array2d3& C,
+                  const typename Array2d1::value_type alpha = 1.0,
+                  const typename Array2d1::value_type beta  = 0.0);
+
+/*! \cond */
+template<typename DerivedPolicy,
+         typename Array2d,
+         typename Array1d1,
+         typename Array1d2>
+void batched_getrf(const thrust::detail::execution_policy_base<DerivedPolicy> &exec,
+                   Array2d& A,
+                   Array1d1& piv,
+                   Array1d2& info);
+/*! \endcond */
+
+/**
+ * \brief Computes the LU factorization of each matrix of a batch
+ *
+ * \tparam Array2d Type of the batch to factor
+ * \tparam Array1d1 Type of the pivot array
+ * \tparam Array1d2 Type of the status array
+ *
+ * \param A Batch of n-by-n matrices, stored as an n-by-(n*num_matrices) matrix
+ * \param piv On return contains the pivots of every matrix
+ * \param info On return contains the status of every factorization
+ *
+ * \par Overview
+ * Each matrix is factored in place as <tt>A_k = P_k * L_k * U_k</tt> with
+ * partial pivoting, as \p getrf does. Row <tt>i</tt> of matrix
+ * <tt>k</tt> was interchanged with row <tt>piv[k*n + i] - 1</tt>, the
+ * pivots are one based as in LAPACK. <tt>info[k]</tt> is zero on success
+ * and <tt>j+1</tt> if <tt>U_k(j,j)</tt> is exactly zero, in which case the
+ * factorization is completed but \p batched_getrs must not be used.
+ *
+ * \par Example
+ * \code
+ * #include <cusp/array1d.h>
+ * #include <cusp/array2d.h>
+ * #include <cusp/print.h>
+ *
+ * #include <cusp/gallery/poisson.h>
+ *
+ * // include cusp batched lapack header file
+ * #include <cusp/lapack/batched.h>
+ *
+ * int main()
+ * {
+ *   // create a batch holding a single 2D Poisson problem
+ *   cusp::array2d<float,cusp::host_memory> A;
+ *   cusp::gallery::poisson5pt(A, 4, 4);
+ *
+ *   cusp::array2d<float,cusp::device_memory> A_d(A);
+ *   cusp::array1d<int,cusp::device_memory> piv;
+ *   cusp::array1d<int,cusp::device_memory> info;
+ *
+ *   // compute the LU factorization of every matrix
+ *   cusp::lapack::batched_getrf(A_d, piv, info);
+ *
+ *   // print the status of the factorizations
+ *   cusp::print(info);
+ * }
+ * \endcode
+ */
+template<typename Array2d,
+         typename Array1d1,
+         typename Array1d2>
+void batched_getrf(Array2d& A,
+                   Array1d1& piv,
+                   Array1d2& info);
+
+/*! \cond */
+template<typename DerivedPolicy,
+         typename Array2d1,
+         typename Array1d,
+         typename Array2d2>
+void batched_getrs(const thrust::detail::execution_policy_base<DerivedPolicy> &exec,
+                   const Array2d1& A,
+                   const Array1d& piv,
+                         Array2d2& B);
+/*! \endcond */
+
+/**
+ * \brief Solves a linear system with each matrix of a factored batch
+ *
+ * \tparam Array2d1 Type of the factored batch
+ * \tparam Array1d Type of the pivot array
+ * \tparam Array2d2 Type of the right hand sides
+ *
+ * \param A Batch of LU factorizations computed by \p batched_getrf
+ * \param piv Pivots computed by \p batched_getrf
+ * \param B Batch of n-by-nrhs right hand sides, stored as an
+ * n-by-(nrhs*num_matrices) matrix, overwritten by the solutions
+ *
+ * \par Overview
+ * Solves <tt>A_k * X_k = B_k</tt> for every matrix of the batch.
+ */
+template<typename Array2d1,
+         typename Array1d,
+         typename Array2d2>
+void batched_getrs(const Array2d1& A,
+                   const Array1d& piv,
+                         Array2d2& B);
+
+/*! \cond */
+template<typename DerivedPolicy,
+         typename Array2d,
+         typename Array1d>
+void batched_potrf(const thrust::detail::execution_policy_base<DerivedPolicy> &exec,
+                   Array2d& A,
+                   Array1d& info,
+                   char uplo = 'U');
+/*! \endcond */
+
+/**
+ * \brief Computes the Cholesky factorization of each matrix of a batch
+ *
+ * \tparam Array2d Type of the batch to factor
+ * \tparam Array1d Type of the status array
+ *
+ * \param A Batch of real symmetric positive definite n-by-n matrices,
+ * stored as an n-by-(n*num_matrices) matrix
+ * \param info On return contains the status of every factorization
+ * \param uplo Indicates whether the upper or lower triangle of each
+ * matrix is referenced and overwritten
+ *
+ * \par Overview
+ * Each matrix is factored in place as <tt>A_k = U_k^T * U_k</tt> when
+ * \p uplo is 'U' and as <tt>A_k = L_k * L_k^T</tt> when \p uplo is 'L', as
+ * \p potrf does. The other strict triangle is not referenced.
+ * <tt>info[k]</tt> is zero on success and <tt>j+1</tt> if the leading
+ * minor of order <tt>j+1</tt> is not positive definite.
+ */
+template<typename Array2d,
+         typename Array1d>
+void batched_potrf(Array2d& A,
+                   Array1d& info,
+                   char uplo = 'U');
+
+/*! \cond */
+template<typename DerivedPolicy,
+         typename Array2d1,
+         typename Array1d,
+         typename Array2d2>
+void batched_syev(const thrust::detail::execution_policy_base<DerivedPolicy> &exec,
+                  const Array2d1& A,
+                        Array1d& eigvals,
+                        Array2d2& eigvecs,
+                  char uplo = 'U');
+/*! \endcond */
+
+/**
+ * \brief Computes all eigenvalues and eigenvectors of each matrix of a
+ * batch of real symmetric matrices
+ *
+ * \tparam Array2d1 Type of the input batch
+ * \tparam Array1d Type of the eigenvalue array
+ * \tparam Array2d2 Type of the eigenvector batch
+ *
+ * \param A Batch of real symmetric n-by-n matrices, stored as an
+ * n-by-(n*num_matrices) matrix
+ * \param eigvals On return contains the eigenvalues of every matrix
+ * \param eigvecs On return contains the orthonormal eigenvectors of every
+ * matrix, stored like \p A
+ * \param uplo Indicates whether the upper or lower triangle of each
+ * matrix is referenced
+ *
+ * \par Overview
+ * The eigenvalues of matrix <tt>k</tt> are stored in ascending order in
+ * <tt>eigvals[k*n, (k+1)*n)</tt> and column <tt>i</tt> of the
+ * <tt>k</tt>-th eigenvector matrix belongs to eigenvalue
+ * <tt>eigvals[k*n + i]</tt>, as \p syev computes them. Every matrix is
+ * diagonalized with cyclic Jacobi rotations, which are accurate to
+ * working precision and need no workspace beyond a copy of the matrix.
+ *
+ * \par Example
+ * \code
+ * #include <cusp/array1d.h>
+ * #include <cusp/array2d.h>
+ * #include <cusp/print.h>
+ *
+ * #include <cusp/gallery/poisson.h>
+ *
+ * // include cusp batched lapack header file
+ * #include <cusp/lapack/batched.h>
+ *
+ * int main()
+ * {
+ *   // create a batch holding a single 1D Poisson problem
+ *   cusp::array2d<float,cusp::host_memory> A;
+ *   cusp::gallery::poisson5pt(A, 4, 1);
+ *
+ *   cusp::array2d<float,cusp::device_memory> A_d(A);
+ *   cusp::array1d<float,cusp::device_memory> eigvals;
+ *   cusp::array2d<float,cusp::device_memory> eigvecs;
+ *
+ *   // compute the eigenpairs of every matrix
+ *   cusp::lapack::batched_syev(A_d, eigvals, eigvecs);
+ *
+ *   // print the eigenvalues
+ *   cusp::print(eigvals);
+ * }
+ * \endcode
+ */
+template<typename Array2d1,
+         typename Array1d,
+         typename Array2d2>
+void batched_syev(const Array2d1& A,
+                        Array1d& eigvals,
+                        Array2d2& eigvecs,
+                  char uplo = 'U');
+
+/*! \cond */
+template<typename DerivedPolicy,
+         typename Array2d1,
+         typename Array2d2,
+         typename Array1d1,
+         typename Array2d3,
+         typename Array1d2>
+void batched_sygv(const thrust::detail::execution_policy_base<DerivedPolicy> &exec,
+                  const Array2d1& A,
+                  const Array2d2& B,
+                        Array1d1& eigvals,
+                        Array2d3& eigvecs,
+                        Array1d2& info);
+/*! \endcond */
+
+/**
+ * \brief Computes all eigenvalues and eigenvectors of each problem of a
+ * batch of real generalized symmetric definite eigenproblems
+ *
+ * \tparam Array2d1 Type of the first input batch
+ * \tparam Array2d2 Type of the second input batch
+ * \tparam Array1d1 Type of the eigenvalue array
+ * \tparam Array2d3 Type of the eigenvector batch
+ * \tparam Array1d2 Type of the status array
+ *
+ * \param A Batch of real symmetric n-by-n matrices, stored as an
+ * n-by-(n*num_matrices) matrix
+ * \param B Batch of real symmetric positive definite n-by-n matrices,
+ * stored like \p A
+ * \param eigvals On return contains the eigenvalues of every problem
+ * \param eigvecs On return contains the eigenvectors of every problem,
+ * stored like \p A
+ * \param info On return contains the status of every problem
+ *
+ * \par Overview
+ * Solves <tt>A_k * x = λ * B_k * x</tt> for every problem of the batch,
+ * referencing the upper triangles of \p A and \p B. As with \p sygv the
+ * eigenvalues are stored in ascending order and the eigenvectors are
+ * normalized so that <tt>X_k^T * B_k * X_k = I</tt>. The problem is reduced
+ * to a standard one with the Cholesky factorization of <tt>B_k</tt> and
+ * solved as in \p batched_syev. <tt>info[k]</tt> is zero on success and
+ * <tt>n+j+1</tt> if the leading minor of order <tt>j+1</tt> of
+ * <tt>B_k</tt> is not positive definite, in which case the eigenpairs of
+ * that problem are not computed.
+ */
+template<typename Array2d1,
+         typename Array2d2,
+         typename Array1d1,
+         typename Array2d3,
+         typename Array1d2>
+void batched_sygv(const Array2d1& A,
+                  const Array2d2& B,
+                        Array1d1& eigvals,
+                        Array2d3& eigvecs,
+                        Array1d2& info);
+
+/*! \}
+ */
+
+} // end namespace lapack
+} // end namespace cusp
+
+#include <cusp/lapack/detail/batched.inl>
@@ -0,0 +1,825 @@
+/*
+ *  Copyright 2008-2014 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*! \file batched.h
+ *  \brief Generic implementation of the batched dense routines
+ */
+
+#pragma once
+
+#include <cusp/detail/config.h>
+
+#include <cusp/complex.h>
+#include <cusp/exception.h>
+#include <cusp/detail/array2d_format_utils.h>
+#include <cusp/detail/temporary_array.h>
+
+#include <thrust/for_each.h>
+#include <thrust/iterator/counting_iterator.h>
+
+#include <cmath>
+#include <limits>
+#include <string>
+
+namespace cusp
+{
+namespace lapack
+{
+namespace detail
+{
+
+// one matrix of a batch, entry (i,j) is stored at base[index_of(i,j,pitch)]
+template <typename T, typename Orientation>
+struct batched_block
+{
+    typedef T value_type;
+
+    T* base;
+    size_t pitch;
+
+    __host__ __device__
+    batched_block(T* base, const size_t pitch)
+      : base(base), pitch(pitch) {}
+
+    __host__ __device__
+    T& operator()(const int i, const int j) const
+    {
+        return base[cusp::detail::index_of(size_t(i), size_t(j), pitch, Orientation())];
+    }
+};
+
+// the k-th n column wide block of a batch stored side by side
+template <typename T, typename Orientation>
+__host__ __device__
+batched_block<T,Orientation> block_of(T* values, const size_t pitch, const size_t k, const size_t n, Orientation)
+{
+    return batched_block<T,Orientation>(values + cusp::detail::index_of(size_t(0), k * n, pitch, Orientation()), pitch);
+}
+
+// the k-th matrix of a column-major workspace holding n-by-n matrices
+template <typename T>
+__host__ __device__
+batched_block<T,cusp::column_major> workspace_of(T* values, const size_t k, const size_t n)
+{
+    return batched_block<T,cusp::column_major>(values + k * n * n, n);
+}
+
+template <typename ValueType, typename Orientation1, typename Orientation2, typename Orientation3>
+struct batched_gemm_functor
+{
+    const ValueType* A;
+    const ValueType* B;
+    ValueType* C;
+    size_t pitch_A, pitch_B, pitch_C;
+    int m, k, n;
+    ValueType alpha, beta;
+
+    batched_gemm_functor(const ValueType* A, const size_t pitch_A,
+                         const ValueType* B, const size_t pitch_B,
+                         ValueType* C, const size_t pitch_C,
+                         const int m, const int k, const int n,
+                         const ValueType alpha, const ValueType beta)
+      : A(A), B(B), C(C), pitch_A(pitch_A), pitch_B(pitch_B), pitch_C(pitch_C),
+        m(m), k(k), n(n), alpha(alpha), beta(beta) {}
+
+    __host__ __device__
+    void operator()(const size_t l) const
+    {
+        batched_block<const ValueType,Orientation1> A_l = block_of(A, pitch_A, l, k, Orientation1());
+        batched_block<const ValueType,Orientation2> B_l = block_of(B, pitch_B, l, n, Orientation2());
+        batched_block<ValueType,Orientation3>       C_l = block_of(C, pitch_C, l, n, Orientation3());
+
+        for(int j = 0; j < n; j++)
+        {
+            for(int i = 0; i < m; i++)
+            {
+                ValueType sum = ValueType(0);
+
+                for(int p = 0; p < k; p++)
+                    sum += A_l(i,p) * B_l(p,j);
+
+                // as in BLAS, C is not read when beta is zero
+                C_l(i,j) = beta == ValueType(0) ? alpha * sum : alpha * sum + beta * C_l(i,j);
+            }
+        }
+    }
+};
+
+template <typename ValueType, typename IndexType, typename Orientation>
+struct batched_getrf_functor
+{
+    ValueType* A;
+    size_t pitch;
+    IndexType* piv;
+    IndexType* info;
+    int n;
+
+    batched_getrf_functor(ValueType* A, const size_t pitch, IndexType* piv, IndexType* info, const int n)
+      : A(A), pitch(pitch), piv(piv), info(info), n(n) {}
+
+    __host__ __device__
+    void operator()(const size_t k) const
+    {
+        typedef typename cusp::norm_type<ValueType>::type NormType;
+
+        batched_block<ValueType,Orientation> A_k = block_of(A, pitch, k, n, Orientation());
+        IndexType* piv_k = piv + k * n;
+        IndexType status = 0;
+
+        for(int j = 0; j < n; j++)
+        {
+            // find the entry of largest magnitude in column j
+            int p = j;
+            NormType max_abs = cusp::abs(A_k(j,j));
+
+            for(int i = j + 1; i < n; i++)
+            {
+                NormType a = cusp::abs(A_k(i,j));
+
+                if(a > max_abs)
+                {
+                    p = i;
+                    max_abs = a;
+                }
+            }
+
+            piv_k[j] = p + 1;
+
+            // a zero pivot is recorded and the column is skipped, as in LAPACK
+            if(max_abs == NormType(0))
+            {
+                if(status == 0)
+                    status = j + 1;
+
+                continue;
+            }
+
+            if(p != j)
+            {
+                for(int c = 0; c < n; c++)
+                {
+                    ValueType t = A_k(j,c);
+                    A_k(j,c) = A_k(p,c);
+                    A_k(p,c) = t;
+                }
+            }
+
+            const ValueType pivot = A_k(j,j);
+
+            for(int i = j + 1; i < n; i++)
+                A_k(i,j) /= pivot;
+
+            for(int c = j + 1; c < n; c++)
+            {
+                const ValueType a_jc = A_k(j,c);
+
+                for(int i = j + 1; i < n; i++)
+                    A_k(i,c) -= A_k(i,j) * a_jc;
+            }
+        }
+
+        info[k] = status;
+    }
+};
+
+template <typename ValueType, typename IndexType, typename Orientation1, typename Orientation2>
+struct batched_getrs_functor
+{
+    const ValueType* A;
+    size_t pitch_A;
+    const IndexType* piv;
+    ValueType* B;
+    size_t pitch_B;
+    int n, nrhs;
+
+    batched_getrs_functor(const ValueType* A, const size_t pitch_A, const IndexType* piv,
+                          ValueType* B, const size_t pitch_B, const int n, const int nrhs)
+      : A(A), pitch_A(pitch_A), piv(piv), B(B), pitch_B(pitch_B), n(n), nrhs(nrhs) {}
+
+    __host__ __device__
+    void operator()(const size_t k) const
+    {
+        batched_block<const ValueType,Orientation1> A_k = block_of(A, pitch_A, k, n, Orientation1());
+        batched_block<ValueType,Orientation2>       B_k = block_of(B, pitch_B, k, nrhs, Orientation2());
+        const IndexType* piv_k = piv + k * n;
+
+        for(int c = 0; c < nrhs; c++)
+        {
+            // apply the row interchanges
+            for(int i = 0; i < n; i++)
+            {
+                const int p = piv_k[i] - 1;
+
+                if(p != i)
+                {
+                    ValueType t = B_k(i,c);
+                    B_k(i,c) = B_k(p,c);
+                    B_k(p,c) = t;
+                }
+            }
+
+            // solve L y = P b
+            for(int i = 0; i < n; i++)
+            {
+                ValueType sum = B_k(i,c);
+
+                for(int p = 0; p < i; p++)
+                    sum -= A_k(i,p) * B_k(p,c);
+
+                B_k(i,c) = sum;
+            }
+
+            // solve U x = y
+            for(int i = n - 1; i >= 0; i--)
+            {
+                ValueType sum = B_k(i,c);
+
+                for(int p = i + 1; p < n; p++)
+                    sum -= A_k(i,p) * B_k(p,c);
+
+                B_k(i,c) = sum / A_k(i,i);
+            }
+        }
+    }
+};
+
+// lower triangle of a symmetric matrix of which either triangle is stored,
+// entry (i,j) with i >= j refers to (j,i) of the block when upper is set
+template <typename T, typename Orientation>
+struct lower_triangle_of
+{
+    typedef T value_type;
+
+    batched_block<T,Orientation> block;
+    bool upper;
+
+    __host__ __device__
+    lower_triangle_of(const batched_block<T,Orientation>& block, const bool upper)
+      : block(block), upper(upper) {}
+
+    __host__ __device__
+    T& operator()(const int i, const int j) const
+    {
+        return upper ? block(j,i) : block(i,j);
+    }
+};
+
+// overwrites the lower triangle of L with its Cholesky factor, returns
+// zero or the order of the first leading minor that is not positive
+template <typename Triangle>
+__host__ __device__
+int cholesky_in_place(const Triangle& L, const int n)
+{
+    using thrust::sqrt;
+    using std::sqrt;
+
+    for(int j = 0; j < n; j++)
+    {
+        typename Triangle::value_type d = L(j,j);
+
+        for(int p = 0; p < j; p++)
+            d -= L(j,p) * L(j,p);
+
+        if(!(d > 0))
+            return j + 1;
+
+        d = sqrt(d);
+        L(j,j) = d;
+
+        for(int i = j + 1; i < n; i++)
+        {
+            typename Triangle::value_type sum = L(i,j);
+
+            for(int p = 0; p < j; p++)
+                sum -= L(i,p) * L(j,p);
+
+            L(i,j) = sum / d;
+        }
+    }
+
+    return 0;
+}
+
+template <typename ValueType, typename IndexType, typename Orientation>
+struct batched_potrf_functor
+{
+    ValueType* A;
+    size_t pitch;
+    IndexType* info;
+    int n;
+    bool upper;
+
+    batched_potrf_functor(ValueType* A, const size_t pitch, IndexType* info, const int n, const bool upper)
+      : A(A), pitch(pitch), info(info), n(n), upper(upper) {}
+
+    __host__ __device__
+    void operator()(const size_t k) const
+    {
+        lower_triangle_of<ValueType,Orientation> L_k(block_of(A, pitch, k, n, Orientation()), upper);
+
+        info[k] = cholesky_in_place(L_k, n);
+    }
+};
+
+// Diagonalizes the symmetric matrix C = V D V^T with cyclic Jacobi
+// rotations. C is overwritten, the eigenvalues are stored in ascending
+// order in w and the corresponding eigenvectors in the columns of V.
+template <typename ValueType, typename Block1, typename Block2>
+__host__ __device__
+void jacobi_eigensolve(const Block1& C, const Block2& V, ValueType* w, const int n, const ValueType eps)
+{
+    using thrust::sqrt;
+    using std::sqrt;
+
+    const int max_sweeps = 64;
+
+    for(int i = 0; i < n; i++)
+        for(int j = 0; j < n; j++)
+            V(i,j) = i == j ? ValueType(1) : ValueType(0);
+
+    for(int sweep = 0; sweep < max_sweeps; sweep++)
+    {
+        ValueType off  = 0;
+        ValueType diag = 0;
+
+        for(int j = 0; j < n; j++)
+        {
+            diag += C(j,j) * C(j,j);
+
+            for(int i = 0; i < j; i++)
+                off += C(i,j) * C(i,j);
+        }
+
+        if(off <= eps * eps * (diag + 2 * off))
+            break;
+
+        for(int p = 0; p < n - 1; p++)
+        {
+            for(int q = p + 1; q < n; q++)
+            {
+                const ValueType c_pq = C(p,q);
+
+                if(c_pq == ValueType(0))
+                    continue;
+
+                // rotation annihilating C(p,q), t is the smaller root of
+                // t^2 + 2 theta t - 1 = 0
+                const ValueType theta = (C(q,q) - C(p,p)) / (2 * c_pq);
+                const ValueType abs_theta = theta < 0 ? -theta : theta;
+                const ValueType t = (theta < 0 ? ValueType(-1) : ValueType(1)) / (abs_theta + sqrt(theta * theta + 1));
+                const ValueType c = ValueType(1) / sqrt(t * t + 1);
+                const ValueType s = t * c;
+
+                for(int i = 0; i < n; i++)
+                {
+                    const ValueType c_ip = C(i,p);
+                    const ValueType c_iq = C(i,q);
+                    C(i,p) = c * c_ip - s * c_iq;
+                    C(i,q) = s * c_ip + c * c_iq;
+                }
+
+                for(int j = 0; j < n; j++)
+                {
+                    const ValueType c_pj = C(p,j);
+                    const ValueType c_qj = C(q,j);
+                    C(p,j) = c * c_pj - s * c_qj;
+                    C(q,j) = s * c_pj + c * c_qj;
+                }
+
+                C(p,q) = ValueType(0);
+                C(q,p) = ValueType(0);
+
+                for(int i = 0; i < n; i++)
+                {
+                    const ValueType v_ip = V(i,p);
+                    const ValueType v_iq = V(i,q);
+                    V(i,p) = c * v_ip - s * v_iq;
+                    V(i,q) = s * v_ip + c * v_iq;
+                }
+            }
+        }
+    }
+
+    for(int i = 0; i < n; i++)
+        w[i] = C(i,i);
+
+    // selection sort of the eigenpairs, n is small
+    for(int i = 0; i < n - 1; i++)
+    {
+        int m = i;
+
+        for(int j = i + 1; j < n; j++)
+            if(w[j] < w[m])
+                m = j;
+
+        if(m != i)
+        {
+            ValueType t = w[i];
+            w[i] = w[m];
+            w[m] = t;
+
+            for(int r = 0; r < n; r++)
+            {
+                ValueType v = V(r,i);
+                V(r,i) = V(r,m);
+                V(r,m) = v;
+            }
+        }
+    }
+}
+
+template <typename ValueType, typename Orientation1, typename Orientation2>
+struct batched_syev_functor
+{
+    const ValueType* A;
+    size_t pitch_A;
+    ValueType* eigvals;
+    ValueType* eigvecs;
+    size_t pitch_V;
+    ValueType* work;
+    int n;
+    bool upper;
+    ValueType eps;
+
+    batched_syev_functor(const ValueType* A, const size_t pitch_A,
+                         ValueType* eigvals, ValueType* eigvecs, const size_t pitch_V,
+                         ValueType* work, const int n, const bool upper)
+      : A(A), pitch_A(pitch_A), eigvals(eigvals), eigvecs(eigvecs), pitch_V(pitch_V),
+        work(work), n(n), upper(upper), eps(std::numeric_limits<ValueType>::epsilon()) {}
+
+    __host__ __device__
+    void operator()(const size_t k) const
+    {
+        batched_block<const ValueType,Orientation1> A_k = block_of(A, pitch_A, k, n, Orientation1());
+        batched_block<ValueType,Orientation2>       V_k = block_of(eigvecs, pitch_V, k, n, Orientation2());
+        batched_block<ValueType,cusp::column_major> C_k = workspace_of(work, k, n);
+
+        // expand the referenced triangle into a full symmetric copy
+        for(int j = 0; j < n; j++)
+        {
+            for(int i = 0; i <= j; i++)
+            {
+                const ValueType a = upper ? A_k(i,j) : A_k(j,i);
+                C_k(i,j) = a;
+                C_k(j,i) = a;
+            }
+        }
+
+        jacobi_eigensolve(C_k, V_k, eigvals + k * n, n, eps);
+    }
+};
+
+template <typename ValueType, typename IndexType, typename Orientation1, typename Orientation2, typename Orientation3>
+struct batched_sygv_functor
+{
+    const ValueType* A;
+    size_t pitch_A;
+    const ValueType* B;
+    size_t pitch_B;
+    ValueType* eigvals;
+    ValueType* eigvecs;
+    size_t pitch_V;
+    IndexType* info;
+    ValueType* work;
+    int n;
+    ValueType eps;
+
+    batched_sygv_functor(const ValueType* A, const size_t pitch_A,
+                         const ValueType* B, const size_t pitch_B,
+                         ValueType* eigvals, ValueType* eigvecs, const size_t pitch_V,
+                         IndexType* info, ValueType* work, const int n)
+      : A(A), pitch_A(pitch_A), B(B), pitch_B(pitch_B), eigvals(eigvals), eigvecs(eigvecs),
+        pitch_V(pitch_V), info(info), work(work), n(n), eps(std::numeric_limits<ValueType>::epsilon()) {}
+
+    __host__ __device__
+    void operator()(const size_t k) const
+    {
+        batched_block<const ValueType,Orientation1> A_k = block_of(A, pitch_A, k, n, Orientation1());
+        batched_block<const ValueType,Orientation2> B_k = block_of(B, pitch_B, k, n, Orientation2());
+        batched_block<ValueType,Orientation3>       V_k = block_of(eigvecs, pitch_V, k, n, Orientation3());
+
+        // three n-by-n workspace matrices per problem
+        batched_block<ValueType,cusp::column_major> L_k = workspace_of(work, 3 * k + 0, n);
+        batched_block<ValueType,cusp::column_major> W_k = workspace_of(work, 3 * k + 1, n);
+        batched_block<ValueType,cusp::column_major> C_k = workspace_of(work, 3 * k + 2, n);
+
+        // B = L L^T from the upper triangle of B
+        for(int j = 0; j < n; j++)
+            for(int i = j; i < n; i++)
+                L_k(i,j) = B_k(j,i);
+
+        const int status = cholesky_in_place(L_k, n);
+
+        if(status != 0)
+        {
+            info[k] = n + status;
+            return;
+        }
+
+        // W = L^{-1} A
+        for(int c = 0; c < n; c++)
+        {
+            for(int i = 0; i < n; i++)
+            {
+                ValueType sum = i <= c ? A_k(i,c) : A_k(c,i);
+
+                for(int p = 0; p < i; p++)
+                    sum -= L_k(i,p) * W_k(p,c);
+
+                W_k(i,c) = sum / L_k(i,i);
+            }
+        }
+
+        // C = L^{-1} W^T = L^{-1} A L^{-T}
+        for(int c = 0; c < n; c++)
+        {
+            for(int i = 0; i < n; i++)
+            {
+                ValueType sum = W_k(c,i);
+
+                for(int p = 0; p < i; p++)
+                    sum -= L_k(i,p) * C_k(p,c);
+
+                C_k(i,c) = sum / L_k(i,i);
+            }
+        }
+
+        // symmetrize the rounding errors of the two solves
+        for(int j = 0; j < n; j++)
+        {
+            for(int i = 0; i < j; i++)
+            {
+                const ValueType c_ij = (C_k(i,j) + C_k(j,i)) / 2;
+                C_k(i,j) = c_ij;
+                C_k(j,i) = c_ij;
+            }
+        }
+
+        jacobi_eigensolve(C_k, V_k, eigvals + k * n, n, eps);
+
+        // X = L^{-T} Y, so that X^T B X = I
+        for(int c = 0; c < n; c++)
+        {
+            for(int i = n - 1; i >= 0; i--)
+            {
+                ValueType sum = V_k(i,c);
+
+                for(int p = i + 1; p < n; p++)
+                    sum -= L_k(p,i) * V_k(p,c);
+
+                V_k(i,c) = sum / L_k(i,i);
+            }
+        }
+
+        info[k] = 0;
+    }
+};
+
+} // end namespace detail
+
+namespace generic
+{
+
+template<typename DerivedPolicy, typename Array2d1, typename Array2d2, typename Array2d3, typename ScalarType>
+void batched_gemm( thrust::execution_policy<DerivedPolicy> &exec,
+                   const Array2d1& A, const Array2d2& B, Array2d3& C,
+                   const ScalarType alpha, const ScalarType beta )
+{
+    typedef typename Array2d1::value_type  ValueType;
+    typedef typename Array2d1::orientation Orientation1;
+    typedef typename Array2d2::orientation Orientation2;
+    typedef typename Array2d3::orientation Orientation3;
+
+    if(A.num_cols == 0 && B.num_cols == 0)
+        return;
+
+    if(B.num_rows == 0 || A.num_cols % B.num_rows != 0)
+        throw cusp::invalid_input_exception("batched_gemm: A.num_cols is not a multiple of B.num_rows");
+
+    const size_t k = B.num_rows;
+    const size_t num_matrices = A.num_cols / k;
+
+    if(B.num_cols % num_matrices != 0)
+        throw cusp::invalid_input_exception("batched_gemm: B.num_cols is not a multiple of the number of matrices");
+
+    if(C.num_rows != A.num_rows || C.num_cols != B.num_cols)
+        throw cusp::invalid_input_exception("batched_gemm: C has the wrong dimensions");
+
+    const size_t m = A.num_rows;
+    const size_t n = B.num_cols / num_matrices;
+
+    if(m == 0 || n == 0)
+        return;
+
+    cusp::lapack::detail::batched_gemm_functor<ValueType,Orientation1,Orientation2,Orientation3>
+        f(thrust::raw_pointer_cast(&A(0,0)), A.pitch,
+          thrust::raw_pointer_cast(&B(0,0)), B.pitch,
+          thrust::raw_pointer_cast(&C(0,0)), C.pitch,
+          m, k, n, ValueType(alpha), ValueType(beta));
+
+    thrust::for_each(exec,
+                     thrust::counting_iterator<size_t>(0),
+                     thrust::counting_iterator<size_t>(num_matrices),
+                     f);
+}
+
+// number of n-by-n matrices of a batch stored side by side
+template<typename Array2d>
+size_t batched_num_matrices(const Array2d& A, const char * routine)
+{
+    if(A.num_rows == 0)
+    {
+        if(A.num_cols != 0)
+            throw cusp::invalid_input_exception(std::string(routine) + ": batch of empty matrices has columns");
+
+        return 0;
+    }
+
+    if(A.num_cols % A.num_rows != 0)
+        throw cusp::invalid_input_exception(std::string(routine) + ": A.num_cols is not a multiple of A.num_rows");
+
+    return A.num_cols / A.num_rows;
+}
+
+template<typename DerivedPolicy, typename Array2d, typename Array1d1, typename Array1d2>
+void batched_getrf( thrust::execution_policy<DerivedPolicy> &exec,
+                    Array2d& A, Array1d1& piv, Array1d2& info )
+{
+    typedef typename Array2d::value_type  ValueType;
+    typedef typename Array2d::orientation Orientation;
+    typedef typename Array1d1::value_type IndexType;
+
+    const size_t num_matrices = batched_num_matrices(A, "batched_getrf");
+    const size_t n = A.num_rows;
+
+    piv.resize(n * num_matrices);
+    info.resize(num_matrices);
+
+    if(num_matrices == 0)
+        return;
+
+    cusp::lapack::detail::batched_getrf_functor<ValueType,IndexType,Orientation>
+        f(thrust::raw_pointer_cast(&A(0,0)), A.pitch,
+          thrust::raw_pointer_cast(&piv[0]), thrust::raw_pointer_cast(&info[0]), n);
+
+    thrust::for_each(exec,
+                     thrust::counting_iterator<size_t>(0),
+                     thrust::counting_iterator<size_t>(num_matrices),
+                     f);
+}
+
+template<typename DerivedPolicy, typename Array2d1, typename Array1d, typename Array2d2>
+void batched_getrs( thrust::execution_policy<DerivedPolicy> &exec,
+                    const Array2d1& A, const Array1d& piv, Array2d2& B )
+{
+    typedef typename Array2d1::value_type  ValueType;
+    typedef typename Array2d1::orientation Orientation1;
+    typedef typename Array2d2::orientation Orientation2;
+    typedef typename Array1d::value_type   IndexType;
+
+    const size_t num_matrices = batched_num_matrices(A, "batched_getrs");
+    const size_t n = A.num_rows;
+
+    if(num_matrices == 0)
+        return;
+
+    if(piv.size() != n * num_matrices)
+        throw cusp::invalid_input_exception("batched_getrs: piv has the wrong size");
+
+    if(B.num_rows != n || B.num_cols % num_matrices != 0)
+        throw cusp::invalid_input_exception("batched_getrs: B has the wrong dimensions");
+
+    const size_t nrhs = B.num_cols / num_matrices;
+
+    if(nrhs == 0)
+        return;
+
+    cusp::lapack::detail::batched_getrs_functor<ValueType,IndexType,Orientation1,Orientation2>
+        f(thrust::raw_pointer_cast(&A(0,0)), A.pitch, thrust::raw_pointer_cast(&piv[0]),
+          thrust::raw_pointer_cast(&B(0,0)), B.pitch, n, nrhs);
+
+    thrust::for_each(exec,
+                     thrust::counting_iterator<size_t>(0),
+                     thrust::counting_iterator<size_t>(num_matrices),
+                     f);
+}
+
+template<typename DerivedPolicy, typename Array2d, typename Array1d>
+void batched_potrf( thrust::execution_policy<DerivedPolicy> &exec,
+                    Array2d& A, Array1d& info, char uplo )
+{
+    typedef typename Array2d::value_type  ValueType;
+    typedef typename Array2d::orientation Orientation;
+    typedef typename Array1d::value_type  IndexType;
+
+    if(uplo != 'U' && uplo != 'L')
+        throw cusp::invalid_input_exception("batched_potrf: uplo must be 'U' or 'L'");
+
+    const size_t num_matrices = batched_num_matrices(A, "batched_potrf");
+    const size_t n = A.num_rows;
+
+    info.resize(num_matrices);
+
+    if(num_matrices == 0)
+        return;
+
+    cusp::lapack::detail::batched_potrf_functor<ValueType,IndexType,Orientation>
+        f(thrust::raw_pointer_cast(&A(0,0)), A.pitch,
+          thrust::raw_pointer_cast(&info[0]), n, uplo == 'U');
+
+    thrust::for_each(exec,
+                     thrust::counting_iterator<size_t>(0),
+                     thrust::counting_iterator<size_t>(num_matrices),
+                     f);
+}
+
+template<typename DerivedPolicy, typename Array2d1, typename Array1d, typename Array2d2>
+void batched_syev( thrust::execution_policy<DerivedPolicy> &exec,
+                   const Array2d1& A, Array1d& eigvals, Array2d2& eigvecs, char uplo )
+{
+    typedef typename Array2d1::value_type  ValueType;
+    typedef typename Array2d1::orientation Orientation1;
+    typedef typename Array2d2::orientation Orientation2;
+
+    if(uplo != 'U' && uplo != 'L')
+        throw cusp::invalid_input_exception("batched_syev: uplo must be 'U' or 'L'");
+
+    const size_t num_matrices = batched_num_matrices(A, "batched_syev");
+    const size_t n = A.num_rows;
+
+    eigvals.resize(n * num_matrices);
+    eigvecs.resize(A.num_rows, A.num_cols);
+
+    if(num_matrices == 0)
+        return;
+
+    cusp::detail::temporary_array<ValueType, DerivedPolicy> work(exec, n * n * num_matrices);
+
+    cusp::lapack::detail::batched_syev_functor<ValueType,Orientation1,Orientation2>
+        f(thrust::raw_pointer_cast(&A(0,0)), A.pitch,
+          thrust::raw_pointer_cast(&eigvals[0]),
+          thrust::raw_pointer_cast(&eigvecs(0,0)), eigvecs.pitch,
+          thrust::raw_pointer_cast(&work[0]), n, uplo == 'U');
+
+    thrust::for_each(exec,
+                     thrust::counting_iterator<size_t>(0),
+                     thrust::counting_iterator<size_t>(num_matrices),
+                     f);
+}
+
+template<typename DerivedPolicy, typename Array2d1, typename Array2d2, typename Array1d1, typename Array2d3, typename Array1d2>
+void batched_sygv( thrust::execution_policy<DerivedPolicy> &exec,
+                   const Array2d1& A, const Array2d2& B,
+                   Array1d1& eigvals, Array2d3& eigvecs, Array1d2& info )
+{
+    typedef typename Array2d1::value_type  ValueType;
+    typedef typename Array2d1::orientation Orientation1;
+    typedef typename Array2d2::orientation Orientation2;
+    typedef typename Array2d3::orientation Orientation3;
+    typedef typename Array1d2::value_type  IndexType;
+
+    const size_t num_matrices = batched_num_matrices(A, "batched_sygv");
+    const size_t n = A.num_rows;
+
+    if(B.num_rows != A.num_rows || B.num_cols != A.num_cols)
+        throw cusp::invalid_input_exception("batched_sygv: A and B have different dimensions");
+
+    eigvals.resize(n * num_matrices);
+    eigvecs.resize(A.num_rows, A.num_cols);
+    info.resize(num_matrices);
+
+    if(num_matrices == 0)
+        return;
+
+    cusp::detail::temporary_array<ValueType, DerivedPolicy> work(exec, 3 * n * n * num_matrices);
+
+    cusp::lapack::detail::batched_sygv_functor<ValueType,IndexType,Orientation1,Orientation2,Orientation3>
+        f(thrust::raw_pointer_cast(&A(0,0)), A.pitch,
+          thrust::raw_pointer_cast(&B(0,0)), B.pitch,
+          thrust::raw_pointer_cast(&eigvals[0]),
+          thrust::raw_pointer_cast(&eigvecs(0,0)), eigvecs.pitch,
+          thrust::raw_pointer_cast(&info[0]),
+          thrust::raw_pointer_cast(&work[0]), n);
+
+    thrust::for_each(exec,
+                     thrust::counting_iterator<size_t>(0),
+                     thrust::counting_iterator<size_t>(num_matrices),
+                     f);
+}
+
+} // end namespace generic
+} // end namespace lapack
+} // end namespace cusp
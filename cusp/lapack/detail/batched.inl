@@ -0,0 +1,188 @@
+/*
+ *  Copyright 2008-2014 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*! \file batched.inl
+ *  \brief Definition of batched dense routines
+ */
+
+#include <cusp/array1d.h>
+#include <cusp/array2d.h>
+
+#include <cusp/lapack/detail/batched.h>
+
+namespace cusp
+{
+namespace lapack
+{
+
+template<typename DerivedPolicy, typename Array2d1, typename Array2d2, typename Array2d3>
+void batched_gemm( const thrust::detail::execution_policy_base<DerivedPolicy> &exec,
+                   const Array2d1& A, const Array2d2& B, Array2d3& C,
+                   const typename Array2d1::value_type alpha,
+                   const typename Array2d1::value_type beta )
+{
+    using cusp::lapack::generic::batched_gemm;
+
+    return batched_gemm(thrust::detail::derived_cast(thrust::detail::strip_const(exec)), A, B, C, alpha, beta);
+}
+
+template<typename Array2d1, typename Array2d2, typename Array2d3>
+void batched_gemm( const Array2d1& A, const Array2d2& B, Array2d3& C,
+                   const typename Array2d1::value_type alpha,
+                   const typename Array2d1::value_type beta )
+{
+    using thrust::system::detail::generic::select_system;
+
+    typedef typename Array2d1::memory_space System1;
+    typedef typename Array2d2::memory_space System2;
+    typedef typename Array2d3::memory_space System3;
+
+    System1 system1;
+    System2 system2;
+    System3 system3;
+
+    return cusp::lapack::batched_gemm(select_system(system1, system2, system3), A, B, C, alpha, beta);
+}
+
+template<typename DerivedPolicy, typename Array2d, typename Array1d1, typename Array1d2>
+void batched_getrf( const thrust::detail::execution_policy_base<DerivedPolicy> &exec,
+                    Array2d& A, Array1d1& piv, Array1d2& info )
+{
+    using cusp::lapack::generic::batched_getrf;
+
+    return batched_getrf(thrust::detail::derived_cast(thrust::detail::strip_const(exec)), A, piv, info);
+}
+
+template<typename Array2d, typename Array1d1, typename Array1d2>
+void batched_getrf( Array2d& A, Array1d1& piv, Array1d2& info )
+{
+    using thrust::system::detail::generic::select_system;
+
+    typedef typename Array2d::memory_space  System1;
+    typedef typename Array1d1::memory_space System2;
+    typedef typename Array1d2::memory_space System3;
+
+    System1 system1;
+    System2 system2;
+    System3 system3;
+
+    return cusp::lapack::batched_getrf(select_system(system1, system2, system3), A, piv, info);
+}
+
+template<typename DerivedPolicy, typename Array2d1, typename Array1d, typename Array2d2>
+void batched_getrs( const thrust::detail::execution_policy_base<DerivedPolicy> &exec,
+                    const Array2d1& A, const Array1d& piv, Array2d2& B )
+{
+    using cusp::lapack::generic::batched_getrs;
+
+    return batched_getrs(thrust::detail::derived_cast(thrust::detail::strip_const(exec)), A, piv, B);
+}
+
+template<typename Array2d1, typename Array1d, typename Array2d2>
+void batched_getrs( const Array2d1& A, const Array1d& piv, Array2d2& B )
+{
+    using thrust::system::detail::generic::select_system;
+
+    typedef typename Array2d1::memory_space System1;
+    typedef typename Array1d::memory_space  System2;
+    typedef typename Array2d2::memory_space System3;
+
+    System1 system1;
+    System2 system2;
+    System3 system3;
+
+    return cusp::lapack::batched_getrs(select_system(system1, system2, system3), A, piv, B);
+}
+
+template<typename DerivedPolicy, typename Array2d, typename Array1d>
+void batched_potrf( const thrust::detail::execution_policy_base<DerivedPolicy> &exec,
+                    Array2d& A, Array1d& info, char uplo )
+{
+    using cusp::lapack::generic::batched_potrf;
+
+    return batched_potrf(thrust::detail::derived_cast(thrust::detail::strip_const(exec)), A, info, uplo);
+}
+
+template<typename Array2d, typename Array1d>
+void batched_potrf( Array2d& A, Array1d& info, char uplo )
+{
+    using thrust::system::detail::generic::select_system;
+
+    typedef typename Array2d::memory_space System1;
+    typedef typename Array1d::memory_space System2;
+
+    System1 system1;
+    System2 system2;
+
+    return cusp::lapack::batched_potrf(select_system(system1, system2), A, info, uplo);
+}
+
+template<typename DerivedPolicy, typename Array2d1, typename Array1d, typename Array2d2>
+void batched_syev( const thrust::detail::execution_policy_base<DerivedPolicy> &exec,
+                   const Array2d1& A, Array1d& eigvals, Array2d2& eigvecs, char uplo )
+{
+    using cusp::lapack::generic::batched_syev;
+
+    return batched_syev(thrust::detail::derived_cast(thrust::detail::strip_const(exec)), A, eigvals, eigvecs, uplo);
+}
+
+template<typename Array2d1, typename Array1d, typename Array2d2>
+void batched_syev( const Array2d1& A, Array1d& eigvals, Array2d2& eigvecs, char uplo )
+{
+    using thrust::system::detail::generic::select_system;
+
+    typedef typename Array2d1::memory_space System1;
+    typedef typename Array1d::memory_space  System2;
+    typedef typename Array2d2::memory_space System3;
+
+    System1 system1;
+    System2 system2;
+    System3 system3;
+
+    return cusp::lapack::batched_syev(select_system(system1, system2, system3), A, eigvals, eigvecs, uplo);
+}
+
+template<typename DerivedPolicy, typename Array2d1, typename Array2d2, typename Array1d1, typename Array2d3, typename Array1d2>
+void batched_sygv( const thrust::detail::execution_policy_base<DerivedPolicy> &exec,
+                   const Array2d1& A, const Array2d2& B,
+                   Array1d1& eigvals, Array2d3& eigvecs, Array1d2& info )
+{
+    using cusp::lapack::generic::batched_sygv;
+
+    return batched_sygv(thrust::detail::derived_cast(thrust::detail::strip_const(exec)), A, B, eigvals, eigvecs, info);
+}
+
+template<typename Array2d1, typename Array2d2, typename Array1d1, typename Array2d3, typename Array1d2>
+void batched_sygv( const Array2d1& A, const Array2d2& B,
+                   Array1d1& eigvals, Array2d3& eigvecs, Array1d2& info )
+{
+    using thrust::system::detail::generic::select_system;
+
+    typedef typename Array2d1::memory_space System1;
+    typedef typename Array2d2::memory_space System2;
+    typedef typename Array1d1::memory_space System3;
+    typedef typename Array2d3::memory_space System4;
+
+    System1 system1;
+    System2 system2;
+    System3 system3;
+    System4 system4;
+
+    return cusp::lapack::batched_sygv(select_system(system1, system2, system3, system4), A, B, eigvals, eigvecs, info);
+}
+
+} // end namespace lapack
+} // end namespace cusp
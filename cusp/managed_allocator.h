@@ -0,0 +1,146 @@
+/*
+ *  Copyright 2008-2014 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+
+/*! \file managed_allocator.h
+ *  \brief Device allocator returning CUDA Unified Memory
+ */
+
+#pragma once
+
+#include <cusp/detail/config.h>
+
+#include <thrust/device_malloc_allocator.h>
+
+namespace cusp
+{
+
+/*! \addtogroup utilities Utilities
+ *  \{
+ */
+
+/**
+ * \brief Device allocator returning CUDA Unified (managed) Memory
+ *
+ * \tparam T element type
+ *
+ * \par Overview
+ *  Managed memory is addressable from the host and the device, the driver
+ *  migrates its pages to the processor touching them. On devices which
+ *  support it, managed allocations may exceed the device memory, the pages
+ *  which do not fit are evicted to the host and brought back on demand.
+ *  \p managed_allocator hands out device pointers, so containers using it
+ *  dispatch to the device system like \p cusp::device_memory containers.
+ *  It is the \c default_memory_allocator of \p cusp::managed_memory.
+ *  Failed allocations throw \c std::bad_alloc. Without a CUDA device
+ *  system \p managed_allocator behaves like
+ *  \c thrust::device_malloc_allocator.
+ *
+ * \par Example
+ *  \code
+ *  #include <cusp/csr_matrix.h>
+ *  #include <cusp/gallery/poisson.h>
+ *  #include <cusp/krylov/cg.h>
+ *  #include <cusp/precond/aggregation/smoothed_aggregation.h>
+ *
+ *  int main(void)
+ *  {
+ *      typedef cusp::managed_memory MemorySpace;
+ *
+ *      // the matrix and the hierarchy may exceed the device memory
+ *      cusp::csr_matrix<int, double, MemorySpace> A;
+ *      cusp::gallery::poisson5pt(A, 4000, 4000);
+ *
+ *      cusp::precond::aggregation::smoothed_aggregation<int, double, MemorySpace> M(A);
+ *
+ *      cusp::array1d<double, MemorySpace> x(A.num_rows, 0);
+ *      cusp::array1d<double, MemorySpace> b(A.num_rows, 1);
+ *
+ *      cusp::krylov::cg(A, x, b, M);
+ *
+ *      return 0;
+ *  }
+ *  \endcode
+ */
+template <typename T>
+class managed_allocator : public thrust::device_malloc_allocator<T>
+{
+private:
+
+    typedef thrust::device_malloc_allocator<T> Parent;
+
+public:
+
+    /*! \cond */
+    typedef typename Parent::pointer   pointer;
+    typedef typename Parent::size_type size_type;
+
+    template <typename U>
+    struct rebind
+    {
+        typedef managed_allocator<U> other;
+    };
+    /*! \endcond */
+
+    /*! Construct a \p managed_allocator.
+     */
+    managed_allocator(void) {}
+
+    /*! Copy constructor, \p managed_allocator is stateless.
+     */
+    managed_allocator(const managed_allocator& other) : Parent(other) {}
+
+    /*! Converting constructor from a \p managed_allocator of another type.
+     */
+    template <typename U>
+    managed_allocator(const managed_allocator<U>&) {}
+
+    /*! Allocate managed storage for \p num_elements elements of type \c T.
+     *
+     *  \param num_elements Number of elements to allocate.
+     *  \return Device pointer to the storage, which holds no constructed elements.
+     */
+    pointer allocate(size_type num_elements);
+
+    /*! Release storage returned by \p allocate.
+     *
+     *  \param ptr Pointer returned by \p allocate.
+     *  \param num_elements Number of elements passed to \p allocate.
+     */
+    void deallocate(pointer ptr, size_type num_elements);
+};
+
+/*! Return \c true, managed allocators are interchangeable.
+ */
+template <typename T, typename U>
+bool operator==(const managed_allocator<T>&, const managed_allocator<U>&)
+{
+    return true;
+}
+
+/*! Return \c false, managed allocators are interchangeable.
+ */
+template <typename T, typename U>
+bool operator!=(const managed_allocator<T>&, const managed_allocator<U>&)
+{
+    return false;
+}
+/*! \}
+ */
+
+} // end namespace cusp
+
+#include <cusp/detail/managed_allocator.inl>
@@ -0,0 +1,137 @@
+/*
+ *  Copyright 2008-2014 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+
+/*! \file matrix_powers.h
+ *  \brief Matrix powers kernel for s-step Krylov methods
+ */
+
+#pragma once
+
+#include <cusp/detail/config.h>
+
+#include <cusp/array1d.h>
+
+#include <cusp/detail/execution_policy.h>
+
+namespace cusp
+{
+
+/*! \addtogroup algorithms Algorithms
+ *  \addtogroup matrix_algorithms Matrix Algorithms
+ *  \ingroup algorithms
+ *  \{
+ */
+
+/* \cond */
+template <typename DerivedPolicy,
+          typename MatrixType,
+          typename ArrayType,
+          typename Array2dType>
+void matrix_powers(const thrust::detail::execution_policy_base<DerivedPolicy>& exec,
+                   const MatrixType& A,
+                   const ArrayType& x,
+                         Array2dType& V,
+                   const size_t s);
+
+template <typename DerivedPolicy,
+          typename MatrixType,
+          typename ArrayType,
+          typename Array2dType,
+          typename ShiftType>
+void matrix_powers(const thrust::detail::execution_policy_base<DerivedPolicy>& exec,
+                   const MatrixType& A,
+                   const ArrayType& x,
+                         Array2dType& V,
+                   const cusp::array1d<ShiftType,cusp::host_memory>& shifts);
+
+template <typename MatrixType,
+          typename ArrayType,
+          typename Array2dType,
+          typename ShiftType>
+void matrix_powers(const MatrixType& A,
+                   const ArrayType& x,
+                         Array2dType& V,
+                   const cusp::array1d<ShiftType,cusp::host_memory>& shifts);
+/* \endcond */
+
+/**
+ * \brief Computes the Krylov basis <tt>[x, A x, A^2 x, ..., A^s x]</tt>
+ *
+ * \tparam MatrixType Type of the square matrix or \p linear_operator
+ * \tparam ArrayType Type of the start vector
+ * \tparam Array2dType Type of the column-major basis
+ *
+ * \param A square matrix
+ * \param x start vector
+ * \param V basis with <tt>A.num_rows</tt> rows and at least
+ * <tt>s + 1</tt> columns, column \c k receives <tt>A^k x</tt>
+ * \param s number of products with \p A
+ *
+ * \par Overview
+ *  The matrix powers kernel produces the vectors an s-step Krylov method
+ *  needs for \c s iterations without any inner product in between. The
+ *  overload taking an array of \c s shifts computes the Newton basis
+ *  <tt>V(:,k+1) = (A - shifts[k] I) V(:,k)</tt>, whose columns stay far
+ *  better conditioned than the monomial ones when the shifts are spread
+ *  over the spectrum of \p A, e.g. Leja-ordered Chebyshev points.
+ *
+ *  DIA matrices on the CUDA backend whose diagonals lie within \c w of
+ *  the main diagonal, e.g. banded matrices after a reverse Cuthill-McKee
+ *  ordering, compute all powers in one kernel: every block stages the
+ *  rows of \p x it needs for \c s products, its own rows plus <tt>s w</tt>
+ *  rows on each side, in shared memory and keeps the intermediate vectors
+ *  there, so \p x and the powers cross global memory once. Other formats
+ *  and wider bands apply \p A once per power.
+ *
+ * \throws cusp::invalid_input_exception if \p A is not square or the
+ * sizes of \p x and \p V do not match
+ *
+ * \par Example
+ *  \code
+ *  #include <cusp/array2d.h>
+ *  #include <cusp/dia_matrix.h>
+ *  #include <cusp/matrix_powers.h>
+ *  #include <cusp/gallery/poisson.h>
+ *
+ *  int main(void)
+ *  {
+ *      cusp::dia_matrix<int, float, cusp::device_memory> A;
+ *      cusp::gallery::poisson5pt(A, 10, 10);
+ *
+ *      cusp::array1d<float, cusp::device_memory> x(A.num_rows, 1);
+ *      cusp::array2d<float, cusp::device_memory, cusp::column_major> V(A.num_rows, 5);
+ *
+ *      // V = [x, A x, A^2 x, A^3 x, A^4 x]
+ *      cusp::matrix_powers(A, x, V, 4);
+ *
+ *      return 0;
+ *  }
+ *  \endcode
+ */
+template <typename MatrixType,
+          typename ArrayType,
+          typename Array2dType>
+void matrix_powers(const MatrixType& A,
+                   const ArrayType& x,
+                         Array2dType& V,
+                   const size_t s);
+/*! \}
+ */
+
+} // end namespace cusp
+
+#include <cusp/detail/matrix_powers.inl>
@@ -27,6 +27,48 @@
 namespace cusp
 {
 
+/*! \brief Memory space of page-locked host storage.
+ *
+ *  Containers in \p pinned_memory behave exactly like containers in
+ *  \p host_memory and run their algorithms on the host system, but their
+ *  storage is allocated by \p pinned_allocator. Transfers between pinned
+ *  and device containers avoid the intermediate copy of pageable memory
+ *  and may proceed asynchronously. Page-locked memory is a scarce system
+ *  resource and should be reserved for buffers which are transferred
+ *  often. Without a CUDA device system \p pinned_memory is ordinary host
+ *  memory.
+ */
+struct pinned_memory : public host_memory {};
+
+/*! \brief Memory space of CUDA Unified Memory.
+ *
+ *  Containers in \p managed_memory behave exactly like containers in
+ *  \p device_memory and run their algorithms on the device system, but
+ *  their storage is allocated by \p managed_allocator. Managed pages
+ *  migrate between host and device on demand, which allows the data of a
+ *  computation (e.g. a multigrid hierarchy) to exceed the memory of the
+ *  device. \p cusp::prefetch and \p cusp::advise in \p <cusp/prefetch.h>
+ *  control the placement of the pages. Without a CUDA device system
+ *  \p managed_memory is ordinary device memory.
+ */
+struct managed_memory : public device_memory {};
+
+/*! \brief Type of the \p cusp::no_init tag.
+ */
+struct no_init_t {};
+
+/*! \brief Requests uninitialized storage from a container.
+ *
+ *  Passing \p no_init to the size constructor or \p resize of
+ *  \p array1d, \p coo_matrix or \p csr_matrix leaves the new elements
+ *  unspecified instead of value-initializing them. This saves a pass over
+ *  the storage when the next operation overwrites every element, e.g. the
+ *  output of a conversion or of a sparse matrix-matrix product. It is
+ *  meant for value types which need no construction, such as the
+ *  integral, floating point and complex types.
+ */
+static const no_init_t no_init = no_init_t();
+
 template<typename T, typename MemorySpace>
 struct default_memory_allocator;
 
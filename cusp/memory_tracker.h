@@ -0,0 +1,183 @@
+/*
+ *  Copyright 2008-2014 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+
+/*! \file memory_tracker.h
+ *  \brief Current and peak memory usage of the containers per memory space
+ */
+
+#pragma once
+
+#include <cusp/detail/config.h>
+
+#include <cusp/memory.h>
+#include <cusp/tracking_allocator.h>
+
+#include <cstddef>
+#include <map>
+#include <ostream>
+#include <string>
+
+namespace cusp
+{
+
+/*! \addtogroup utilities Utilities
+ *  \{
+ */
+
+/*! \brief Memory usage of one memory space, or of one memory space during
+ *  one operation.
+ */
+struct memory_statistics
+{
+    size_t current_bytes;          //!< bytes held by live allocations
+    size_t peak_bytes;             //!< maximum of \p current_bytes
+    size_t allocated_bytes;        //!< bytes allocated in total
+    size_t allocations;            //!< number of allocations
+    size_t failed_allocations;     //!< number of allocations which threw
+
+    /*! Operations active on the allocating thread when \p peak_bytes was
+     *  reached, outermost first and separated by " / ", e.g.
+     *  <tt>"cusp::smoothed_aggregation level 2 / amg galerkin product / cusp::multiply"</tt>.
+     */
+    std::string peak_operation;
+
+    /*! Operations active when the last failed allocation was requested.
+     */
+    std::string failed_operation;
+
+    memory_statistics(void)
+        : current_bytes(0), peak_bytes(0), allocated_bytes(0),
+          allocations(0), failed_allocations(0) {}
+};
+
+/**
+ * \brief Attributes the allocations of the calling thread to a named operation
+ *
+ * \par Overview
+ *  Allocations of tracked containers are attributed to all operations
+ *  whose scope is active on the allocating thread. The library opens
+ *  scopes around its own operations, e.g. \p cusp::convert,
+ *  \p cusp::multiply (including sparse matrix-matrix products),
+ *  \p cusp::transpose and every level and phase of a multigrid setup,
+ *  and applications may open scopes around their own stages. A scope
+ *  is an empty object unless \c CUSP_MEMORY_TRACKING is 1.
+ *
+ * \par Example
+ *  \code
+ *  #define CUSP_MEMORY_TRACKING 1
+ *
+ *  #include <cusp/memory_tracker.h>
+ *  #include <cusp/csr_matrix.h>
+ *  #include <cusp/multiply.h>
+ *  #include <cusp/gallery/poisson.h>
+ *
+ *  #include <iostream>
+ *
+ *  int main(void)
+ *  {
+ *      cusp::csr_matrix<int, float, cusp::device_memory> A, C;
+ *      cusp::gallery::poisson5pt(A, 1000, 1000);
+ *
+ *      {
+ *          cusp::memory_scope scope("square");
+ *          cusp::multiply(A, A, C);
+ *      }
+ *
+ *      // peak device bytes and the operation which reached them
+ *      cusp::memory_statistics device = cusp::memory_usage<cusp::device_memory>();
+ *      std::cout << device.peak_bytes << " bytes in " << device.peak_operation << std::endl;
+ *
+ *      // peak device bytes while "square" was active
+ *      std::cout << cusp::operation_memory_usage<cusp::device_memory>()["square"].peak_bytes << std::endl;
+ *
+ *      cusp::write_memory_usage_json(std::cout);
+ *
+ *      return 0;
+ *  }
+ *  \endcode
+ */
+class memory_scope
+{
+public:
+
+    /*! Attribute allocations to \p name until the scope is destroyed.
+     *  \p name must outlive the scope.
+     */
+    explicit memory_scope(const char* name);
+
+    /*! Attribute allocations to \p name followed by \p index, e.g. the
+     *  level of a hierarchy.
+     */
+    memory_scope(const char* name, const size_t index);
+
+    ~memory_scope(void);
+
+private:
+
+    /*! \cond */
+#if CUSP_MEMORY_TRACKING
+    size_t token;
+#endif
+
+    memory_scope(const memory_scope&);
+    memory_scope& operator=(const memory_scope&);
+    /*! \endcond */
+};
+
+/*! \brief Usage of \p MemorySpace since the start of the program or the
+ *  last \p reset_memory_peaks.
+ *
+ *  Pinned and managed memory are tracked separately from host and device
+ *  memory.
+ */
+template <typename MemorySpace>
+memory_statistics memory_usage(void);
+
+/*! \brief Usage of \p MemorySpace during each operation, keyed by the
+ *  name of the operation.
+ *
+ *  \p peak_bytes of an entry is the peak of the whole memory space while
+ *  the operation was active, \p allocated_bytes and \p allocations count
+ *  the allocations made while the operation was the innermost one and
+ *  \p current_bytes is unused.
+ */
+template <typename MemorySpace>
+std::map<std::string, memory_statistics> operation_memory_usage(void);
+
+/*! \brief Set the peaks to the current usage and discard the totals and
+ *  the usage of the operations.
+ */
+void reset_memory_peaks(void);
+
+/*! \brief Write the usage of every memory space and operation as a JSON
+ *  object, e.g. <tt>{"device": {"current_bytes": ..., "peak_bytes": ...,
+ *  "peak_operation": ..., "operations": {"cusp::convert": {...}}}}</tt>.
+ */
+void write_memory_usage_json(std::ostream& os);
+
+/*! \brief Whether the containers are tracked, i.e. \c CUSP_MEMORY_TRACKING is 1.
+ */
+inline bool memory_tracking_enabled(void)
+{
+    return CUSP_MEMORY_TRACKING != 0;
+}
+/*! \}
+ */
+
+} // end namespace cusp
+
+#include <cusp/detail/memory_tracker.inl>
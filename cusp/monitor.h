@@ -23,6 +23,11 @@
 #include <cusp/detail/config.h>
 #include <cusp/blas/blas.h>
 #include <cusp/complex.h>
+#include <cusp/linear_operator.h>
+#include <cusp/multiply.h>
+
+#include <cusp/detail/profile.h>
+#include <cusp/detail/timer.h>
 
 #include <limits>
 #include <iostream>
@@ -37,6 +42,62 @@ namespace cusp
  *  \{
  */
 
+/**
+ * \brief Applies a linear operator and reports every application to a monitor
+ *
+ * \tparam LinearOperator type of the wrapped matrix or operator
+ * \tparam MonitorType type of the monitor receiving the reports
+ *
+ * \par Overview
+ *  Returned by \p monitor::instrument_operator and
+ *  \p monitor::instrument_preconditioner and passed to a solver in place
+ *  of the wrapped operator. The wrapper holds references to the operator
+ *  and the monitor, which must outlive it.
+ */
+template <typename LinearOperator, typename MonitorType>
+class monitored_operator
+    : public cusp::linear_operator<typename LinearOperator::value_type,
+                                   typename LinearOperator::memory_space,
+                                   typename LinearOperator::index_type>
+{
+private:
+
+    typedef cusp::linear_operator<typename LinearOperator::value_type,
+                                  typename LinearOperator::memory_space,
+                                  typename LinearOperator::index_type> Parent;
+
+    const LinearOperator& A;
+    MonitorType& monitor;
+    bool is_preconditioner;
+
+public:
+
+    /*! Construct a \p monitored_operator.
+     *
+     *  \param A operator to apply
+     *  \param monitor monitor receiving every application
+     *  \param is_preconditioner record the applications as preconditioner
+     *  rather than operator applications
+     */
+    monitored_operator(const LinearOperator& A, MonitorType& monitor, bool is_preconditioner)
+        : Parent(A.num_rows, A.num_cols, A.num_entries),
+          A(A), monitor(monitor), is_preconditioner(is_preconditioner) {}
+
+    template <typename DerivedPolicy, typename VectorType1, typename VectorType2>
+    void operator()(thrust::execution_policy<DerivedPolicy>& exec, const VectorType1& x, VectorType2& y) const;
+
+    /*! Apply the wrapped operator to vector x and produce vector y.
+     *
+     * \tparam VectorType1 Type of the input vector
+     * \tparam VectorType2 Type of the output vector
+     *
+     *  \param x Input vector.
+     *  \param y Output vector.
+     */
+    template <typename VectorType1, typename VectorType2>
+    void operator()(const VectorType1& x, VectorType2& y) const;
+}; // monitored_operator
+
 /**
  * \brief Implements standard convergence criteria and reporting for iterative solvers.
  *
@@ -47,6 +108,22 @@ namespace cusp
  *  satisfies the condition
  *       ||b - A x|| <= absolute_tolerance + relative_tolerance * ||b||
  *  or when the iteration limit is reached.
+ *  By default the residual norm is computed on every call to \p finished,
+ *  which requires a reduction and a transfer of the result to the host.
+ *  Setting a \p check_interval of \c k > 1 tests the residual only every
+ *  \c k iterations (and when the iteration limit is reached), so the solver
+ *  may run up to <tt>k - 1</tt> iterations past convergence in exchange
+ *  for fewer synchronizations.
+ *
+ *  The cost of a solve is recorded by \p set_instrumented. An instrumented
+ *  monitor stores the wall time of every iteration in \p iteration_times
+ *  and times the operator and preconditioner applications made through the
+ *  wrappers returned by \p instrument_operator and
+ *  \p instrument_preconditioner, which also count the applications
+ *  when timing is off. Timing synchronizes the device on every reading,
+ *  so it is disabled by default. Comparing \p preconditioner_seconds with
+ *  \p operator_seconds over a whole solve tells whether a cheaper
+ *  preconditioner would pay for the extra iterations it needs.
  *  Classes to monitor iterative solver progress, check for convergence, etc.
  *  Follows the implementation of Iteration in the ITL:
  *  \see http://www.osl.iu.edu/research/itl/doc/Iteration.html
@@ -113,13 +190,40 @@ public:
      *  \param relative_tolerance determines convergence criteria
      *  \param absolute_tolerance determines convergence criteria
      *  \param verbose Controls printing status updates during execution
+     *  \param check_interval number of iterations between residual tests
      */
     template <typename VectorType>
     monitor(const VectorType& b,
             const size_t iteration_limit = 500,
             const Real relative_tolerance = 1e-5,
             const Real absolute_tolerance = 0,
-            const bool verbose = false);
+            const bool verbose = false,
+            const size_t check_interval = 1);
+
+    /**
+     *  \brief Constructs a \p monitor whose norm of \p b is evaluated
+     *  with an execution policy, e.g. one whose reductions span the ranks
+     *  of a \p cusp::distributed::csr_matrix
+     *
+     *  \tparam DerivedPolicy Execution policy type
+     *  \tparam VectorType Type of initial vector
+     *
+     *  \param exec execution policy used to compute the norm of \p b
+     *  \param b right-hand-side of the linear system A x = b
+     *  \param iteration_limit maximum number of solver iterations to allow
+     *  \param relative_tolerance determines convergence criteria
+     *  \param absolute_tolerance determines convergence criteria
+     *  \param verbose Controls printing status updates during execution
+     *  \param check_interval number of iterations between residual tests
+     */
+    template <typename DerivedPolicy, typename VectorType>
+    monitor(const thrust::detail::execution_policy_base<DerivedPolicy>& exec,
+            const VectorType& b,
+            const size_t iteration_limit = 500,
+            const Real relative_tolerance = 1e-5,
+            const Real absolute_tolerance = 0,
+            const bool verbose = false,
+            const size_t check_interval = 1);
 
     /**
      * \brief Increments the iteration count
@@ -154,6 +258,20 @@ public:
      */
     size_t iteration_limit(void) const;
 
+    /**
+     * \brief Returns the number of iterations between residual tests
+     *
+     * \return Residual check interval
+     */
+    size_t check_interval(void) const;
+
+    /**
+     * \brief Sets the number of iterations between residual tests
+     *
+     * \param check_interval_ Test the residual every \p check_interval_ iterations.
+     */
+    void set_check_interval(const size_t check_interval_);
+
     /**
      * \brief Returns the relative tolerance
      *
@@ -211,11 +329,107 @@ public:
     template <typename Vector>
     void reset(const Vector& b);
 
+    /**
+     *  \brief Resets the monitor, the norm of \p b is evaluated with \p exec
+     *
+     *  \tparam DerivedPolicy Execution policy type
+     *  \tparam Vector vector
+     *  \param exec execution policy used to compute the norm of \p b
+     *  \param b initial right hand side
+     */
+    template <typename DerivedPolicy, typename Vector>
+    void reset(const thrust::detail::execution_policy_base<DerivedPolicy>& exec, const Vector& b);
+
     /**
      *  \brief Prints the number of iterations and convergence history information.
      */
     void print(void);
 
+    /**
+     *  \brief Enables the timing of iterations and operator applications
+     *
+     *  \param instrumented_ If \c true record the wall time of every
+     *  iteration and of the applications made through the wrappers returned
+     *  by \p instrument_operator and \p instrument_preconditioner.
+     */
+    void set_instrumented(bool instrumented_ = true);
+
+    /**
+     *  \brief Indicates whether the monitor records timings
+     *
+     *  \return \c true if timings are recorded.
+     */
+    bool is_instrumented(void) const;
+
+    /**
+     *  \brief Wraps an operator whose applications are counted and timed
+     *
+     *  \tparam LinearOperator type of the operator
+     *  \param A operator the solver applies, e.g. the system matrix
+     *  \return operator passed to the solver in place of \p A
+     */
+    template <typename LinearOperator>
+    monitored_operator<LinearOperator, monitor> instrument_operator(const LinearOperator& A);
+
+    /**
+     *  \brief Wraps a preconditioner whose applications are counted and timed
+     *
+     *  \tparam LinearOperator type of the preconditioner
+     *  \param M preconditioner the solver applies
+     *  \return operator passed to the solver in place of \p M
+     */
+    template <typename LinearOperator>
+    monitored_operator<LinearOperator, monitor> instrument_preconditioner(const LinearOperator& M);
+
+    /**
+     *  \brief Records one application of the operator
+     *
+     *  \param seconds time of the application, zero when not timed
+     */
+    void record_operator(const double seconds = 0);
+
+    /**
+     *  \brief Records one application of the preconditioner
+     *
+     *  \param seconds time of the application, zero when not timed
+     */
+    void record_preconditioner(const double seconds = 0);
+
+    /**
+     *  \brief Returns the number of operator applications
+     *
+     *  \return applications of the operator since the last reset.
+     */
+    size_t operator_applications(void) const;
+
+    /**
+     *  \brief Returns the number of preconditioner applications
+     *
+     *  \return applications of the preconditioner since the last reset.
+     */
+    size_t preconditioner_applications(void) const;
+
+    /**
+     *  \brief Returns the time spent applying the operator
+     *
+     *  \return seconds spent in operator applications since the last reset.
+     */
+    double operator_seconds(void) const;
+
+    /**
+     *  \brief Returns the time spent applying the preconditioner
+     *
+     *  \return seconds spent in preconditioner applications since the last reset.
+     */
+    double preconditioner_seconds(void) const;
+
+    /**
+     *  \brief Returns the time of all recorded iterations
+     *
+     *  \return sum of \p iteration_times.
+     */
+    double solve_seconds(void) const;
+
     /**
      *  \brief Returns the immedidate convergence rate.
      *
@@ -242,6 +456,12 @@ public:
      */
     cusp::array1d<Real,cusp::host_memory> residuals;
 
+    /*
+     * Array holding the wall time of every iteration of an instrumented
+     * monitor, measured between consecutive calls to finished
+     */
+    cusp::array1d<double,cusp::host_memory> iteration_times;
+
 private:
 
     /*! \cond */
@@ -249,9 +469,23 @@ private:
     Real r_norm;
     size_t iteration_limit_;
     size_t iteration_count_;
+    size_t check_interval_;
     Real relative_tolerance_;
     Real absolute_tolerance_;
     bool verbose;
+    bool instrumented;
+
+    size_t operator_applications_;
+    size_t preconditioner_applications_;
+    double operator_seconds_;
+    double preconditioner_seconds_;
+
+    bool iteration_started;
+    cusp::detail::timer iteration_timer;
+
+    cusp::detail::profile_range iteration_range;
+
+    void print_instrumentation(void) const;
     /*! \endcond */
 };
 
@@ -23,6 +23,8 @@
 #include <cusp/detail/config.h>
 #include <cusp/detail/execution_policy.h>
 
+#include <cusp/array1d.h>
+
 namespace cusp
 {
 
@@ -51,6 +53,11 @@ void multiply(const thrust::detail::execution_policy_base<DerivedPolicy> &exec,
  * \p multiply can be used with dense matrices, sparse matrices, and user-defined
  * \p linear_operator objects.
  *
+ * The computation is carried out in the value type of the output. Hence the
+ * entries of a sparse matrix may be stored in a narrower type, e.g. a
+ * <tt>csr_matrix<int,float></tt> multiplied with <tt>array1d<double></tt>
+ * vectors accumulates in double precision.
+ *
  * \tparam LinearOperator Type of first matrix
  * \tparam MatrixOrVector1 Type of second matrix or vector
  * \tparam MatrixOrVector2 Type of output matrix or vector
@@ -102,6 +109,152 @@ void multiply(const LinearOperator&  A,
               const MatrixOrVector1& B,
                     MatrixOrVector2& C);
 
+/*! \cond */
+template <typename DerivedPolicy,
+          typename MatrixType,
+          typename VectorType1,
+          typename VectorType2>
+void multiply_transpose(const thrust::detail::execution_policy_base<DerivedPolicy> &exec,
+                        const MatrixType&  A,
+                        const VectorType1& x,
+                              VectorType2& y);
+/*! \endcond */
+
+/**
+ * \brief Implements transposed matrix-vector multiplication
+ *
+ * \par Overview
+ *
+ * \p multiply_transpose computes <tt>y = A^T x</tt> without forming the
+ * transpose of \p A. The \p csr_matrix and \p coo_matrix formats scatter
+ * the products of every row into \p y directly, which avoids the memory and
+ * setup time of \p transpose, other formats are transposed into a temporary
+ * \p coo_matrix.
+ *
+ * \tparam MatrixType Type of matrix
+ * \tparam VectorType1 Type of input vector
+ * \tparam VectorType2 Type of output vector
+ *
+ * \param A input matrix
+ * \param x input vector of size <tt>A.num_rows</tt>
+ * \param y output vector of size <tt>A.num_cols</tt>
+ *
+ * \note The products are accumulated in arbitrary order on the host with
+ * OpenMP and on the device, hence the result may differ from
+ * <tt>transpose(A)</tt> times \p x by rounding.
+ *
+ * \par Example
+ *
+ *  The following code snippet demonstrates how to use \p multiply_transpose
+ *  to compute a transposed matrix-vector product.
+ *
+ *  \code
+ *  #include <cusp/array1d.h>
+ *  #include <cusp/csr_matrix.h>
+ *  #include <cusp/multiply.h>
+ *  #include <cusp/print.h>
+ *
+ *  #include <cusp/gallery/random.h>
+ *
+ *  int main(void)
+ *  {
+ *      // initialize a 4x3 matrix
+ *      cusp::csr_matrix<int, float, cusp::host_memory> A;
+ *      cusp::gallery::random(A, 4, 3, 6);
+ *
+ *      // initialize input vector
+ *      cusp::array1d<float, cusp::host_memory> x(4, 1);
+ *
+ *      // allocate output vector
+ *      cusp::array1d<float, cusp::host_memory> y(3);
+ *
+ *      // compute y = A^T * x
+ *      cusp::multiply_transpose(A, x, y);
+ *
+ *      // print y
+ *      cusp::print(y);
+ *
+ *      return 0;
+ *  }
+ *  \endcode
+ */
+template <typename MatrixType,
+          typename VectorType1,
+          typename VectorType2>
+void multiply_transpose(const MatrixType&  A,
+                        const VectorType1& x,
+                              VectorType2& y);
+
+/*! \cond */
+template <typename DerivedPolicy,
+          typename LinearOperator,
+          typename VectorType1,
+          typename VectorType2>
+typename VectorType2::value_type
+multiply_dotc(const thrust::detail::execution_policy_base<DerivedPolicy> &exec,
+              const LinearOperator& A,
+              const VectorType1&    x,
+                    VectorType2&    y);
+/*! \endcond */
+
+/**
+ * \brief Implements matrix-vector multiplication followed by a dot product
+ *
+ * \par Overview
+ *
+ * \p multiply_dotc computes <tt>y = A x</tt> and returns the dot product
+ * <tt>conj(y) * x</tt>, which is the denominator of the step length in
+ * conjugate gradient type methods. For \p csr_matrix the dot product is
+ * accumulated while the rows of \p y are written, which saves reading \p x
+ * and \p y a second time. All other operators use \p multiply followed by
+ * \p dotc.
+ *
+ * \tparam LinearOperator Type of matrix
+ * \tparam VectorType1 Type of input vector
+ * \tparam VectorType2 Type of output vector
+ *
+ * \param A input matrix
+ * \param x input vector
+ * \param y output vector
+ *
+ * \return dot product of the output vector with the input vector
+ *
+ * \par Example
+ *
+ *  \code
+ *  #include <cusp/array1d.h>
+ *  #include <cusp/csr_matrix.h>
+ *  #include <cusp/multiply.h>
+ *
+ *  #include <cusp/gallery/poisson.h>
+ *
+ *  #include <iostream>
+ *
+ *  int main(void)
+ *  {
+ *      cusp::csr_matrix<int, float, cusp::host_memory> A;
+ *      cusp::gallery::poisson5pt(A, 10, 10);
+ *
+ *      cusp::array1d<float, cusp::host_memory> p(A.num_rows, 1);
+ *      cusp::array1d<float, cusp::host_memory> q(A.num_rows);
+ *
+ *      // compute q = A * p and <q,p>
+ *      float qp = cusp::multiply_dotc(A, p, q);
+ *
+ *      std::cout << "<Ap,p> = " << qp << std::endl;
+ *
+ *      return 0;
+ *  }
+ *  \endcode
+ */
+template <typename LinearOperator,
+          typename VectorType1,
+          typename VectorType2>
+typename VectorType2::value_type
+multiply_dotc(const LinearOperator& A,
+              const VectorType1&    x,
+                    VectorType2&    y);
+
 /*! \cond */
 template <typename DerivedPolicy,
           typename LinearOperator,
@@ -290,6 +443,148 @@ void generalized_spgemm(const LinearOperator&  A,
                               BinaryFunction1 combine,
                               BinaryFunction2 reduce);
 
+/*! \cond */
+template <typename DerivedPolicy,
+          typename MatrixType1,
+          typename MatrixType2,
+          typename MatrixType3,
+          typename MatrixType4,
+          typename UnaryFunction,
+          typename BinaryFunction1,
+          typename BinaryFunction2>
+void masked_spgemm(const thrust::detail::execution_policy_base<DerivedPolicy> &exec,
+                   const MatrixType1& A,
+                   const MatrixType2& B,
+                   const MatrixType3& M,
+                         MatrixType4& C,
+                         UnaryFunction   initialize,
+                         BinaryFunction1 combine,
+                         BinaryFunction2 reduce);
+/*! \endcond */
+
+/**
+ * \brief Implements masked sparse matrix-matrix multiplication
+ *
+ * \par Overview
+ *
+ * \p masked_spgemm computes <tt>C = A * B</tt> restricted to the sparsity
+ * pattern of the mask \p M, i.e. only the entries <tt>C(i,j)</tt> for which
+ * <tt>M(i,j)</tt> is stored are evaluated. Each such entry is the sparse inner
+ * product of row \c i of \p A with column \c j of \p B, hence the work is
+ * proportional to the number of entries of \p M instead of the number of
+ * intermediate products of <tt>A * B</tt>. Entries of \p M whose row and
+ * column share no index are omitted from \p C, so \p C holds exactly the
+ * structural nonzeros of <tt>A * B</tt> inside the mask. The values of \p M
+ * are ignored.
+ *
+ * Unlike \p generalized_spgemm, the output pattern does not have to be
+ * allocated in \p C beforehand, and \p M may be a different matrix (for
+ * example \p A itself when counting triangles of a graph).
+ *
+ * \tparam MatrixType1     Type of first matrix
+ * \tparam MatrixType2     Type of second matrix
+ * \tparam MatrixType3     Type of mask matrix
+ * \tparam MatrixType4     Type of output matrix
+ * \tparam UnaryFunction   Type of unary function to initialize each entry
+ * \tparam BinaryFunction1 Type of binary function to combine entries
+ * \tparam BinaryFunction2 Type of binary function to reduce entries
+ *
+ * \param A first input matrix
+ * \param B second input matrix
+ * \param M mask matrix
+ * \param C output matrix
+ * \param initialize unary function applied to zero to start each entry
+ * \param combine binary function used to combine entries of \p A and \p B
+ * \param reduce binary function used to reduce combined entries
+ *
+ * \par Example
+ *
+ *  The following code snippet demonstrates how to use \p masked_spgemm to
+ *  count the triangles of an undirected graph.
+ *
+ *  \code
+ *  #include <cusp/csr_matrix.h>
+ *  #include <cusp/multiply.h>
+ *
+ *  #include <cusp/gallery/poisson.h>
+ *
+ *  #include <thrust/reduce.h>
+ *
+ *  int main(void)
+ *  {
+ *      // adjacency matrix of a graph
+ *      cusp::csr_matrix<int,float,cusp::host_memory> A;
+ *      cusp::gallery::poisson9pt(A, 10, 10);
+ *      thrust::fill(A.values.begin(), A.values.end(), 1);
+ *
+ *      // compute C = (A * A) .* A
+ *      cusp::csr_matrix<int,float,cusp::host_memory> C;
+ *      cusp::masked_spgemm(A, A, A, C);
+ *
+ *      // every triangle is counted six times
+ *      float triangles = thrust::reduce(C.values.begin(), C.values.end()) / 6;
+ *
+ *      return 0;
+ *  }
+ *  \endcode
+ */
+template <typename MatrixType1,
+          typename MatrixType2,
+          typename MatrixType3,
+          typename MatrixType4,
+          typename UnaryFunction,
+          typename BinaryFunction1,
+          typename BinaryFunction2>
+void masked_spgemm(const MatrixType1& A,
+                   const MatrixType2& B,
+                   const MatrixType3& M,
+                         MatrixType4& C,
+                         UnaryFunction   initialize,
+                         BinaryFunction1 combine,
+                         BinaryFunction2 reduce);
+
+/*! \cond */
+template <typename DerivedPolicy,
+          typename MatrixType1,
+          typename MatrixType2,
+          typename MatrixType3,
+          typename MatrixType4>
+void masked_spgemm(const thrust::detail::execution_policy_base<DerivedPolicy> &exec,
+                   const MatrixType1& A,
+                   const MatrixType2& B,
+                   const MatrixType3& M,
+                         MatrixType4& C);
+/*! \endcond */
+
+/**
+ * \brief Implements masked sparse matrix-matrix multiplication
+ *
+ * \par Overview
+ *
+ * Computes <tt>C = A * B</tt> restricted to the sparsity pattern of \p M
+ * using the conventional multiplication and addition.
+ *
+ * \tparam MatrixType1 Type of first matrix
+ * \tparam MatrixType2 Type of second matrix
+ * \tparam MatrixType3 Type of mask matrix
+ * \tparam MatrixType4 Type of output matrix
+ *
+ * \param A first input matrix
+ * \param B second input matrix
+ * \param M mask matrix
+ * \param C output matrix
+ *
+ * \see masked_spgemm
+ */
+template <typename MatrixType1,
+          typename MatrixType2,
+          typename MatrixType3,
+          typename MatrixType4>
+void masked_spgemm(const MatrixType1& A,
+                   const MatrixType2& B,
+                   const MatrixType3& M,
+                         MatrixType4& C);
+
 /*! \cond */
 template <typename DerivedPolicy,
           typename LinearOperator,
@@ -380,6 +675,323 @@ void generalized_spmv(const LinearOperator&  A,
                             Vector3& z,
                             BinaryFunction1 combine,
                             BinaryFunction2 reduce);
+
+/*! \cond */
+template <typename, typename, typename> class sparse_vector;
+/*! \endcond */
+
+/**
+ * \brief Strategies merging the products of a sparse matrix sparse vector product
+ */
+typedef enum
+{
+    SPMSPV_SORT,   /*!< Radix sort the products by index and reduce equal indices, suits devices */
+    SPMSPV_BUCKET  /*!< Distribute the products to buckets of indices reduced with a dense map, suits hosts and large inputs */
+} spmspv_method;
+
+/*! \cond */
+template <typename DerivedPolicy,
+          typename MatrixType,
+          typename IndexType1, typename ValueType1, typename MemorySpace1,
+          typename IndexType2, typename ValueType2, typename MemorySpace2,
+          typename BinaryFunction1,
+          typename BinaryFunction2>
+void generalized_spmspv(const thrust::detail::execution_policy_base<DerivedPolicy> &exec,
+                        const MatrixType& A,
+                        const cusp::sparse_vector<IndexType1,ValueType1,MemorySpace1>& x,
+                              cusp::sparse_vector<IndexType2,ValueType2,MemorySpace2>& y,
+                        BinaryFunction1 combine,
+                        BinaryFunction2 reduce,
+                        const spmspv_method method = SPMSPV_SORT);
+/*! \endcond */
+
+/**
+ * \brief Implements generalized sparse matrix sparse vector multiplication
+ *
+ * \par Overview
+ *
+ * Computes <tt>y(j) = reduce_i combine(A(i,j), x(i))</tt> over the stored
+ * entries \c i of \p x, i.e. the rows of \p A selected by \p x are merged
+ * into \p y. This is the product of the transpose of \p A with \p x, which
+ * equals <tt>A * x</tt> for the symmetric adjacency matrix of a graph, and
+ * only touches the rows of the frontier of a traversal. The work is
+ * proportional to the number of entries in these rows rather than to the
+ * size of \p A. Matrices in formats other than CSR are converted first.
+ *
+ * \tparam MatrixType Type of sparse matrix
+ * \tparam BinaryFunction1 Type of the functor combining entries of \p A and \p x
+ * \tparam BinaryFunction2 Type of the functor reducing the combined entries
+ *
+ * \param A input matrix with \c x.length rows
+ * \param x input sparse vector
+ * \param y output sparse vector of length \c A.num_cols with sorted indices
+ * \param combine functor applied to <tt>A(i,j)</tt> and <tt>x(i)</tt>
+ * \param reduce associative and commutative functor merging the combined entries
+ * \param method strategy merging the products
+ *
+ * \throw cusp::invalid_input_exception if \c x.length differs from \c A.num_rows
+ *
+ * \par Example
+ *
+ *  \code
+ *  #include <cusp/csr_matrix.h>
+ *  #include <cusp/multiply.h>
+ *  #include <cusp/print.h>
+ *  #include <cusp/sparse_vector.h>
+ *
+ *  #include <cusp/gallery/poisson.h>
+ *
+ *  int main(void)
+ *  {
+ *      cusp::csr_matrix<int, float, cusp::device_memory> A;
+ *      cusp::gallery::poisson5pt(A, 4, 4);
+ *
+ *      // frontier holding the vertex 5
+ *      cusp::sparse_vector<int, float, cusp::device_memory> x(A.num_rows, 1);
+ *      x.indices[0] = 5;
+ *      x.values[0]  = 1;
+ *
+ *      // the neighbors of the frontier
+ *      cusp::sparse_vector<int, float, cusp::device_memory> y;
+ *      cusp::generalized_spmspv(A, x, y, thrust::multiplies<float>(), thrust::plus<float>());
+ *
+ *      cusp::print(y.indices);
+ *
+ *      return 0;
+ *  }
+ *  \endcode
+ */
+template <typename MatrixType,
+          typename IndexType1, typename ValueType1, typename MemorySpace1,
+          typename IndexType2, typename ValueType2, typename MemorySpace2,
+          typename BinaryFunction1,
+          typename BinaryFunction2>
+void generalized_spmspv(const MatrixType& A,
+                        const cusp::sparse_vector<IndexType1,ValueType1,MemorySpace1>& x,
+                              cusp::sparse_vector<IndexType2,ValueType2,MemorySpace2>& y,
+                        BinaryFunction1 combine,
+                        BinaryFunction2 reduce,
+                        const spmspv_method method = SPMSPV_SORT);
+
+/**
+ * \brief Reusable structure of a sparse matrix-matrix product
+ *
+ * \tparam IndexType Type used for indices (e.g. \c int).
+ * \tparam MemorySpace A memory space (e.g. \c cusp::host_memory or \c cusp::device_memory)
+ *
+ * \par Overview
+ *  A \p spgemm_plan is produced by \p spgemm_symbolic and records, for every
+ *  product <tt>A(i,j) * B(j,k)</tt>, the entries of \c A and \c B it combines
+ *  and the entry of \c C it contributes to. Backends which recompute this
+ *  information cheaply from the pattern of \c C may leave the arrays empty.
+ *  The plan is only valid for the execution system and the sparsity patterns
+ *  it was computed with.
+ */
+template <typename IndexType, typename MemorySpace>
+struct spgemm_plan
+{
+    /*! \cond */
+    typedef IndexType   index_type;
+    typedef MemorySpace memory_space;
+    /*! \endcond */
+
+    /*! Number of entries of \c A, \c B and \c C the plan was computed for.
+     */
+    size_t A_num_entries;
+    size_t B_num_entries;
+    size_t C_num_entries;
+
+    /*! Entries of \c A and \c B combined by each product.
+     */
+    cusp::array1d<IndexType,MemorySpace> A_gather_locations;
+    cusp::array1d<IndexType,MemorySpace> B_gather_locations;
+
+    /*! Entry of \c C that each product is reduced into.
+     */
+    cusp::array1d<IndexType,MemorySpace> output_keys;
+
+    /*! Construct an empty \p spgemm_plan.
+     */
+    spgemm_plan(void)
+        : A_num_entries(0), B_num_entries(0), C_num_entries(0) {}
+};
+
+/*! \cond */
+template <typename DerivedPolicy,
+          typename MatrixType1,
+          typename MatrixType2,
+          typename MatrixType3,
+          typename PlanType>
+void spgemm_symbolic(const thrust::detail::execution_policy_base<DerivedPolicy> &exec,
+                     const MatrixType1& A,
+                     const MatrixType2& B,
+                           MatrixType3& C,
+                           PlanType& plan);
+/*! \endcond */
+
+/**
+ * \brief Computes the sparsity pattern of a sparse matrix-matrix product
+ *
+ * \par Overview
+ *
+ * \p spgemm_symbolic computes the pattern of <tt>C = A * B</tt> and a
+ * \p spgemm_plan which allows \p spgemm_numeric to recompute the values of
+ * \c C whenever the values, but not the patterns, of \c A and \c B change.
+ * All structurally nonzero entries are kept in \c C, including those whose
+ * values cancel, and \c C.values is set to zero.
+ *
+ * \tparam MatrixType1 Type of first matrix
+ * \tparam MatrixType2 Type of second matrix
+ * \tparam MatrixType3 Type of output matrix, \p coo_matrix or \p csr_matrix
+ * \tparam PlanType Type of \p spgemm_plan
+ *
+ * \param A first input matrix
+ * \param B second input matrix
+ * \param C output matrix
+ * \param plan structure of the product
+ *
+ * \par Example
+ *
+ *  The following code snippet demonstrates how to use \p spgemm_symbolic
+ *  and \p spgemm_numeric to repeatedly compute a matrix-matrix product.
+ *
+ *  \code
+ *  #include <cusp/csr_matrix.h>
+ *  #include <cusp/multiply.h>
+ *  #include <cusp/print.h>
+ *
+ *  #include <cusp/gallery/poisson.h>
+ *
+ *  int main(void)
+ *  {
+ *      // initialize matrix
+ *      cusp::csr_matrix<int,float,cusp::device_memory> A;
+ *      cusp::gallery::poisson5pt(A, 10, 10);
+ *
+ *      // compute the pattern of C = A * A
+ *      cusp::csr_matrix<int,float,cusp::device_memory> C;
+ *      cusp::spgemm_plan<int,cusp::device_memory> plan;
+ *      cusp::spgemm_symbolic(A, A, C, plan);
+ *
+ *      for (int i = 1; i <= 3; i++)
+ *      {
+ *          // change the values of A
+ *          thrust::fill(A.values.begin(), A.values.end(), float(i));
+ *
+ *          // recompute the values of C = A * A
+ *          cusp::spgemm_numeric(A, A, C, plan);
+ *      }
+ *
+ *      // print C
+ *      cusp::print(C);
+ *
+ *      return 0;
+ *  }
+ *  \endcode
+ */
+template <typename MatrixType1,
+          typename MatrixType2,
+          typename MatrixType3,
+          typename PlanType>
+void spgemm_symbolic(const MatrixType1& A,
+                     const MatrixType2& B,
+                           MatrixType3& C,
+                           PlanType& plan);
+
+/*! \cond */
+template <typename DerivedPolicy,
+          typename MatrixType1,
+          typename MatrixType2,
+          typename MatrixType3,
+          typename PlanType>
+void spgemm_numeric(const thrust::detail::execution_policy_base<DerivedPolicy> &exec,
+                    const MatrixType1& A,
+                    const MatrixType2& B,
+                          MatrixType3& C,
+                    const PlanType& plan);
+/*! \endcond */
+
+/**
+ * \brief Computes the values of a sparse matrix-matrix product
+ *
+ * \par Overview
+ *
+ * \p spgemm_numeric refills \c C.values with <tt>A * B</tt> using the pattern
+ * and \p spgemm_plan computed by \p spgemm_symbolic. \c A and \c B must have
+ * the same patterns as in the symbolic phase, an \p invalid_input_exception
+ * is thrown if their (or C's) number of entries differs from the plan.
+ *
+ * \tparam MatrixType1 Type of first matrix
+ * \tparam MatrixType2 Type of second matrix
+ * \tparam MatrixType3 Type of output matrix, \p coo_matrix or \p csr_matrix
+ * \tparam PlanType Type of \p spgemm_plan
+ *
+ * \param A first input matrix
+ * \param B second input matrix
+ * \param C output matrix
+ * \param plan structure of the product
+ *
+ * \see \p spgemm_symbolic
+ */
+template <typename MatrixType1,
+          typename MatrixType2,
+          typename MatrixType3,
+          typename PlanType>
+void spgemm_numeric(const MatrixType1& A,
+                    const MatrixType2& B,
+                          MatrixType3& C,
+                    const PlanType& plan);
+
+/**
+ * \brief Limits the workspace of sparse matrix-matrix multiplication
+ *
+ * \par Overview
+ *
+ * The expand, sort and compress method behind the COO sparse matrix-matrix
+ * products materializes every intermediate product <tt>A(i,k) * B(k,j)</tt>
+ * before combining them. When the intermediate products exceed the
+ * workspace the rows of \c A are processed in consecutive chunks whose
+ * boundaries are found by a prefix sum over the number of products of each
+ * row, so the workspace never exceeds the given number of bytes (besides
+ * the partial results and the output itself). The hash tables of the CUDA
+ * products respect the same limit and fall back to the expand, sort and
+ * compress method if a single row does not fit.
+ *
+ * By default (or after setting the limit to zero) the workspace is sized
+ * from the available device memory. A \p runtime_exception is thrown if the
+ * products of a single row of \c A do not fit into the limit.
+ *
+ * \param bytes maximum workspace in bytes, zero selects the default
+ *
+ * \note The limit is global and not thread safe.
+ *
+ * \par Example
+ * \code
+ * #include <cusp/csr_matrix.h>
+ * #include <cusp/multiply.h>
+ * #include <cusp/gallery/poisson.h>
+ *
+ * int main(void)
+ * {
+ *   cusp::csr_matrix<int,float,cusp::device_memory> A, C;
+ *   cusp::gallery::poisson27pt(A, 100, 100, 100);
+ *
+ *   // use up to 1 GB of workspace
+ *   cusp::set_spgemm_workspace_limit(size_t(1) << 30);
+ *
+ *   cusp::multiply(A, A, C);
+ * }
+ * \endcode
+ */
+inline void set_spgemm_workspace_limit(const size_t bytes);
+
+/**
+ * \brief Returns the workspace limit of sparse matrix-matrix multiplication
+ * in bytes, zero if the default is used.
+ *
+ * \see \p set_spgemm_workspace_limit
+ */
+inline size_t spgemm_workspace_limit(void);
 /*! \}
  */
 
@@ -0,0 +1,149 @@
+/*
+ *  Copyright 2008-2014 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*! \file numa_allocator.h
+ *  \brief Host allocator placing pages by parallel first touch
+ */
+
+#pragma once
+
+#include <cusp/detail/config.h>
+
+#include <cstddef>
+#include <memory>
+
+namespace cusp
+{
+
+/*! \addtogroup utilities Utilities
+ *  \{
+ */
+
+/**
+ * \brief Host allocator distributing its pages over the NUMA nodes of the
+ * threads which will later process them
+ *
+ * \tparam T element type
+ *
+ * \par Overview
+ *  Operating systems place a page on the NUMA node of the thread which
+ *  touches it first. Host containers are initialized by a single thread,
+ *  which puts all of their pages on one socket and halves the memory
+ *  bandwidth of multi-socket OpenMP kernels. \p numa_allocator zeroes
+ *  every block it allocates in an OpenMP parallel region, handing thread
+ *  \c t the \c t-th contiguous range of elements exactly as the static
+ *  schedule of the OpenMP kernels does, so afterwards each thread mostly
+ *  touches memory local to its socket. Blocks smaller than
+ *  \c first_touch_threshold bytes are served from pages of the heap which
+ *  are already placed and are left alone.
+ *
+ *  \p numa_allocator is the \c default_memory_allocator of host memory
+ *  when the Thrust host system is OpenMP, which makes the storage of every
+ *  host container, e.g. \p array1d and \p csr_matrix, NUMA-local. Define
+ *  \c CUSP_NUMA_ALLOCATOR to 1 to also use it with other host systems
+ *  (e.g. when calling the OpenMP backend through \c cusp::omp::par), or
+ *  to 0 to use \c std::allocator instead.
+ *
+ * \note Pages are placed when they are allocated. A container resized by
+ *  a later operation receives a new block which is placed anew, whereas
+ *  the placement of an existing block is never changed. The number of
+ *  threads used by the OpenMP kernels should therefore be fixed before
+ *  the containers are allocated.
+ *
+ * \par Example
+ *  \code
+ *  // compile with -fopenmp -DTHRUST_HOST_SYSTEM=THRUST_HOST_SYSTEM_OMP
+ *  #include <cusp/csr_matrix.h>
+ *  #include <cusp/io/matrix_market.h>
+ *  #include <cusp/multiply.h>
+ *
+ *  int main(void)
+ *  {
+ *      cusp::csr_matrix<int, double, cusp::host_memory> A;
+ *
+ *      // read serially, the storage of A is NUMA-local nonetheless
+ *      cusp::io::read_matrix_market_file(A, "A.mtx");
+ *
+ *      cusp::array1d<double, cusp::host_memory> x(A.num_cols, 1);
+ *      cusp::array1d<double, cusp::host_memory> y(A.num_rows);
+ *
+ *      cusp::multiply(A, x, y);
+ *
+ *      return 0;
+ *  }
+ *  \endcode
+ */
+template <typename T>
+class numa_allocator : public std::allocator<T>
+{
+private:
+
+    typedef std::allocator<T> Parent;
+
+public:
+
+    /*! Smallest block in bytes whose pages are placed by first touch.
+     */
+    static const size_t first_touch_threshold = 1 << 17;
+
+    /*! \cond */
+    template <typename U>
+    struct rebind
+    {
+        typedef numa_allocator<U> other;
+    };
+    /*! \endcond */
+
+    /*! Construct a \p numa_allocator.
+     */
+    numa_allocator(void) {}
+
+    /*! Copy constructor, \p numa_allocator is stateless.
+     */
+    numa_allocator(const numa_allocator& other) : Parent(other) {}
+
+    /*! Converting constructor from a \p numa_allocator of another type.
+     */
+    template <typename U>
+    numa_allocator(const numa_allocator<U>& other) : Parent(other) {}
+
+    /*! Allocate storage for \p num_elements elements of type \c T and
+     *  place its pages by a parallel first touch.
+     *
+     *  \param num_elements Number of elements to allocate.
+     *  \param hint Ignored.
+     *  \return Pointer to the storage, which holds no constructed elements.
+     */
+    T* allocate(size_t num_elements, const void* hint = 0);
+};
+/*! \}
+ */
+
+template <typename T1, typename T2>
+bool operator==(const numa_allocator<T1>&, const numa_allocator<T2>&)
+{
+    return true;
+}
+
+template <typename T1, typename T2>
+bool operator!=(const numa_allocator<T1>&, const numa_allocator<T2>&)
+{
+    return false;
+}
+
+} // end namespace cusp
+
+#include <cusp/detail/numa_allocator.inl>
@@ -0,0 +1,66 @@
+/*
+ *  Copyright 2008-2013 Steven Dalton
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#pragma once
+
+#include <cusp/detail/config.h>
+
+namespace cusp
+{
+namespace opengl
+{
+namespace spy
+{
+
+/**
+ * @file density_grid.h
+ * Downsampling of a sparse matrix into a grid of nonzero counts, used by
+ * the matrix_canvas to draw views which hold more rows or columns than
+ * the window has pixels.
+ */
+
+/**
+ * Count the nonzeros of a CSR matrix that fall into each cell of a
+ * grid_rows x grid_cols grid laid over the rows [r1,r2) and columns
+ * [c1,c2) of the matrix.
+ *
+ * The counts are computed in the memory space of the matrix, so a device
+ * matrix is binned on the device with one thread per row and atomic
+ * increments, and only the grid is copied back for display. Entries of a
+ * row that fall into the same cell, e.g. runs of sorted columns, are
+ * added with a single atomic. The window is clipped to the matrix.
+ *
+ * @param A csr_matrix or csr_matrix_view
+ * @param r1 first row of the window
+ * @param c1 first column of the window
+ * @param r2 one past the last row of the window
+ * @param c2 one past the last column of the window
+ * @param grid_rows number of rows of the grid
+ * @param grid_cols number of columns of the grid
+ * @param counts array1d of unsigned int in the memory space of \p A,
+ *        resized to grid_rows * grid_cols and stored row by row
+ */
+template <typename MatrixType, typename ArrayType>
+void bin_nonzeros(const MatrixType& A,
+                  int r1, int c1, int r2, int c2,
+                  const int grid_rows, const int grid_cols,
+                  ArrayType& counts);
+
+} // end spy
+} // end opengl
+} // end cusp
+
+#include <cusp/opengl/spy/detail/density_grid.inl>
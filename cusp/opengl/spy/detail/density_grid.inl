@@ -0,0 +1,153 @@
+/*
+ *  Copyright 2008-2013 Steven Dalton
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include <cusp/opengl/spy/density_grid.h>
+
+#include <cusp/blas/blas.h>
+
+#include <thrust/for_each.h>
+#include <thrust/iterator/counting_iterator.h>
+
+#include <algorithm>
+
+namespace cusp
+{
+namespace opengl
+{
+namespace spy
+{
+namespace detail
+{
+
+template <typename IndexType>
+struct bin_row_functor
+{
+    const IndexType * row_offsets;
+    const IndexType * column_indices;
+    unsigned int * counts;
+
+    int r1, c1, rows, cols;
+    int grid_rows, grid_cols;
+
+    bin_row_functor(const IndexType * row_offsets, const IndexType * column_indices,
+                    unsigned int * counts,
+                    int r1, int c1, int rows, int cols,
+                    int grid_rows, int grid_cols)
+        : row_offsets(row_offsets), column_indices(column_indices), counts(counts),
+          r1(r1), c1(c1), rows(rows), cols(cols),
+          grid_rows(grid_rows), grid_cols(grid_cols) {}
+
+    __host__ __device__
+    void add(unsigned int * cell, const unsigned int n) const
+    {
+#if defined(__CUDA_ARCH__)
+        atomicAdd(cell, n);
+#else
+        *cell += n;
+#endif
+    }
+
+    __host__ __device__
+    void operator()(const IndexType i) const
+    {
+        const long long grid_row = (long long)(i - r1) * grid_rows / rows;
+
+        unsigned int * cells = counts + grid_row * grid_cols;
+
+        long long cell = -1;
+        unsigned int run = 0;
+
+        for (IndexType k = row_offsets[i]; k < row_offsets[i + 1]; k++)
+        {
+            const long long j = (long long) column_indices[k] - c1;
+
+            if (j < 0 || j >= cols)
+                continue;
+
+            const long long grid_col = j * grid_cols / cols;
+
+            if (grid_col != cell)
+            {
+                if (run > 0)
+                    add(cells + cell, run);
+
+                cell = grid_col;
+                run = 0;
+            }
+
+            run++;
+        }
+
+        if (run > 0)
+            add(cells + cell, run);
+    }
+};
+
+template <typename IndexType>
+void bin_rows(const bin_row_functor<IndexType>& f, const int r1, const int r2, cusp::host_memory)
+{
+    for (int i = r1; i < r2; i++)
+        f(IndexType(i));
+}
+
+template <typename IndexType>
+void bin_rows(const bin_row_functor<IndexType>& f, const int r1, const int r2, cusp::device_memory)
+{
+#if THRUST_DEVICE_SYSTEM == THRUST_DEVICE_SYSTEM_CUDA && defined(__CUDACC__)
+    thrust::for_each(thrust::device,
+                     thrust::counting_iterator<IndexType>(r1),
+                     thrust::counting_iterator<IndexType>(r2),
+                     f);
+#else
+    // the memory of the other device systems is addressable by the host
+    bin_rows(f, r1, r2, cusp::host_memory());
+#endif
+}
+
+} // end namespace detail
+
+template <typename MatrixType, typename ArrayType>
+void bin_nonzeros(const MatrixType& A,
+                  int r1, int c1, int r2, int c2,
+                  const int grid_rows, const int grid_cols,
+                  ArrayType& counts)
+{
+    typedef typename MatrixType::index_type   IndexType;
+    typedef typename MatrixType::memory_space MemorySpace;
+
+    r1 = std::max(r1, 0);
+    c1 = std::max(c1, 0);
+    r2 = std::min(r2, int(A.num_rows));
+    c2 = std::min(c2, int(A.num_cols));
+
+    counts.resize(size_t(std::max(grid_rows, 0)) * size_t(std::max(grid_cols, 0)));
+    cusp::blas::fill(counts, 0u);
+
+    if (counts.empty() || r1 >= r2 || c1 >= c2 || A.num_entries == 0)
+        return;
+
+    detail::bin_row_functor<IndexType> f(thrust::raw_pointer_cast(&A.row_offsets[0]),
+                                         thrust::raw_pointer_cast(&A.column_indices[0]),
+                                         thrust::raw_pointer_cast(&counts[0]),
+                                         r1, c1, r2 - r1, c2 - c1,
+                                         grid_rows, grid_cols);
+
+    detail::bin_rows(f, r1, r2, MemorySpace());
+}
+
+} // end spy
+} // end opengl
+} // end cusp
@@ -39,6 +39,10 @@
 #include <cusp/opengl/spy/matrix_canvas.h>
 #include <cusp/opengl/spy/colormaps.h>
 
+#include <thrust/copy.h>
+#include <thrust/functional.h>
+#include <thrust/reduce.h>
+#include <thrust/transform.h>
 #include <thrust/iterator/constant_iterator.h>
 #include <thrust/iterator/counting_iterator.h>
 
@@ -60,6 +64,7 @@ matrix_canvas<IndexType,ValueType,MemorySpace>::matrix_canvas(int w, int h)
     matrix_filename(""),
     matrix_loaded(false),
     matrix_display_list(0),
+    density_texture(0),
     point_alpha(0.5f),
     data_panel_visible(false),
     permutation_state(no_permutation),
@@ -75,6 +80,8 @@ matrix_canvas<IndexType,ValueType,MemorySpace>::matrix_canvas(int w, int h)
     border_color[0]=1.0f;
     border_color[1]=1.0f;
     border_color[2]=1.0f;
+
+    std::fill(density_window, density_window + 6, -1);
 }
 
 
@@ -124,7 +131,11 @@ void matrix_canvas<IndexType,ValueType,MemorySpace>::draw()
     int r1=(int)floor(y1),r2=(int)floor(y2);
     int c1=(int)floor(x1),c2=(int)floor(x2);
 
-    if (std::max(x2-x1,y2-y1) < 16384)
+    if (use_density(r1,c1,r2,c2))
+    {
+        draw_density(r1,c1,r2,c2);
+    }
+    else if (std::max(x2-x1,y2-y1) < 16384)
     {
         //std::cout << "drawing partial matrix (" << r1 << ", " << c1 << ") - ("
         //     << r2 << ", " << c2 << ")" << std::endl;
@@ -321,6 +332,121 @@ void matrix_canvas<IndexType,ValueType,MemorySpace>::draw_partial_matrix(int r1,
     draw_matrix_dispatch<true>(r1,c1,r2,c2);
 }
 
+/**
+ * Large views are drawn from the density grid: the matrix has more than
+ * large_scale_nz nonzeros and the visible window holds more rows or
+ * columns than pixels, so points would overlap anyway.  Permuted views
+ * are drawn point by point.
+ */
+template< typename IndexType, typename ValueType, typename MemorySpace >
+bool matrix_canvas<IndexType,ValueType,MemorySpace>::use_density(int r1, int c1, int r2, int c2)
+{
+    if (_m.num_entries <= large_scale_nz || permutation_state != no_permutation) {
+        return false;
+    }
+
+    float pixels_per_entry = 1.0f/std::fabs(scale_to_world(1.0f));
+
+    int rows = (std::min)(r2+1,(int)_m.num_rows) - (std::max)(r1,0);
+    int cols = (std::min)(c2+1,(int)_m.num_cols) - (std::max)(c1,0);
+
+    return (rows > 0 && cols > 0 && pixels_per_entry < 1.0f);
+}
+
+/**
+ * Draw the visible window of the matrix as a texture with one texel per
+ * pixel.  The nonzeros are binned in the memory space of the matrix and
+ * only the counts are copied to the host, and only when the window or
+ * its resolution changed since the last frame.
+ */
+template< typename IndexType, typename ValueType, typename MemorySpace >
+void matrix_canvas<IndexType,ValueType,MemorySpace>::draw_density(int r1, int c1, int r2, int c2)
+{
+    r1=(std::max)(r1,0);
+    c1=(std::max)(c1,0);
+    r2=(std::min)(r2+1,(int)_m.num_rows);
+    c2=(std::min)(c2+1,(int)_m.num_cols);
+
+    float pixels_per_entry = 1.0f/std::fabs(scale_to_world(1.0f));
+
+    int grid_rows = (std::max)(1,(std::min)(r2-r1,(int)ceil((r2-r1)*pixels_per_entry)));
+    int grid_cols = (std::max)(1,(std::min)(c2-c1,(int)ceil((c2-c1)*pixels_per_entry)));
+
+    int window[6] = {r1, c1, r2, c2, grid_rows, grid_cols};
+
+    if (!std::equal(window, window + 6, density_window))
+    {
+        bin_nonzeros(_m, r1, c1, r2, c2, grid_rows, grid_cols, density_counts);
+
+        density_host_counts.resize(density_counts.size());
+        thrust::copy(density_counts.begin(), density_counts.end(), density_host_counts.begin());
+
+        std::copy(window, window + 6, density_window);
+    }
+
+    // log scaled counts through the colormap, empty cells are transparent
+    unsigned int max_count = 0;
+    for (size_t i = 0; i < density_host_counts.size(); ++i) {
+        max_count = (std::max)(max_count, density_host_counts[i]);
+    }
+
+    float inv_log_max = max_count > 1 ? 1.0f/std::log(1.0f + max_count) : 1.0f;
+
+    density_image.resize(4*density_host_counts.size());
+
+    for (size_t i = 0; i < density_host_counts.size(); ++i)
+    {
+        float *texel = &density_image[4*i];
+
+        if (density_host_counts[i] == 0) {
+            texel[0] = texel[1] = texel[2] = texel[3] = 0.0f;
+            continue;
+        }
+
+        float v = max_count > 1 ? std::log(1.0f + density_host_counts[i])*inv_log_max : 1.0f;
+
+        int colormap_entry = (int)(v*(colormap.size-1));
+        if (colormap_invert) {
+            colormap_entry = colormap.size-1-colormap_entry;
+        }
+
+        texel[0] = colormap.map[colormap_entry*3];
+        texel[1] = colormap.map[colormap_entry*3+1];
+        texel[2] = colormap.map[colormap_entry*3+2];
+        texel[3] = 1.0f;
+    }
+
+    if (density_texture == 0) {
+        glGenTextures(1, &density_texture);
+    }
+
+    glEnable(GL_TEXTURE_2D);
+    glBindTexture(GL_TEXTURE_2D, density_texture);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glTexEnvi(GL_TEXTURE_ENV, GL_TEXTURE_ENV_MODE, GL_REPLACE);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, grid_cols, grid_rows, 0,
+                 GL_RGBA, GL_FLOAT, &density_image[0]);
+
+    // texel rows follow the matrix rows, like the points of draw_matrix
+    glBegin(GL_QUADS);
+    glTexCoord2f(0.0f, 0.0f);
+    glVertex2f(c1-0.5f, r1-0.5f);
+    glTexCoord2f(1.0f, 0.0f);
+    glVertex2f(c2-0.5f, r1-0.5f);
+    glTexCoord2f(1.0f, 1.0f);
+    glVertex2f(c2-0.5f, r2-0.5f);
+    glTexCoord2f(0.0f, 1.0f);
+    glVertex2f(c1-0.5f, r2-0.5f);
+    glEnd();
+
+    glDisable(GL_TEXTURE_2D);
+}
+
 /**
  * Compute a point_alpha from the current zoom level.
  *
@@ -547,7 +673,6 @@ bool matrix_canvas<IndexType,ValueType,MemorySpace>::load_matrix(const MatrixTyp
     _m = A;
 
     int m = A.num_rows;
-    int n = A.num_cols;
 
     matrix_loaded = true;
     init_window();
@@ -556,29 +681,67 @@ bool matrix_canvas<IndexType,ValueType,MemorySpace>::load_matrix(const MatrixTyp
     //
     // compute matrix stats
     //
+    // the reductions run in the memory space of the matrix, the row and
+    // column norms are only needed for the normalized views and are
+    // computed on request
+    //
 
-    matrix_stats.max_degree = 0;
-    matrix_stats.min_degree = std::numeric_limits<IndexType>::max();
-    matrix_stats.max_val = std::numeric_limits<ValueType>::min();
-    matrix_stats.min_val = std::numeric_limits<ValueType>::max();
+    cusp::array1d<IndexType, MemorySpace> degrees(m);
+    thrust::transform(_m.row_offsets.begin() + 1, _m.row_offsets.end(),
+                      _m.row_offsets.begin(), degrees.begin(),
+                      thrust::minus<IndexType>());
+
+    matrix_stats.max_degree = thrust::reduce(degrees.begin(), degrees.end(),
+                                             IndexType(0), thrust::maximum<IndexType>());
+    matrix_stats.min_degree = thrust::reduce(degrees.begin(), degrees.end(),
+                                             std::numeric_limits<IndexType>::max(),
+                                             thrust::minimum<IndexType>());
+    matrix_stats.max_val = thrust::reduce(_m.values.begin(), _m.values.end(),
+                                          -std::numeric_limits<ValueType>::max(),
+                                          thrust::maximum<ValueType>());
+    matrix_stats.min_val = thrust::reduce(_m.values.begin(), _m.values.end(),
+                                          std::numeric_limits<ValueType>::max(),
+                                          thrust::minimum<ValueType>());
+
+    rnorm.clear();
+    cnorm.clear();
+
+    std::fill(density_window, density_window + 6, -1);
+
+    if (normalization_state != no_normalization) {
+        compute_norms();
+    }
+
+    return (true);
+}
+
+/**
+ * Compute the inverse 2-norms of the rows and columns for the normalized
+ * views from a host copy of the matrix.
+ */
+template< typename IndexType, typename ValueType, typename MemorySpace >
+void matrix_canvas<IndexType,ValueType,MemorySpace>::compute_norms()
+{
+    if (!matrix_loaded || !rnorm.empty()) {
+        return;
+    }
+
+    cusp::csr_matrix<IndexType, ValueType, cusp::host_memory> h(_m);
+
+    int m = h.num_rows;
+    int n = h.num_cols;
 
     rnorm.resize(m);
     cnorm.resize(n);
 
     for (IndexType r = 0; r < m; ++r)
     {
-        IndexType deg = _m.row_offsets[r+1] - _m.row_offsets[r];
-        matrix_stats.max_degree = std::max(matrix_stats.max_degree, deg);
-        matrix_stats.min_degree = std::min(matrix_stats.min_degree, deg);
-
-        for (IndexType ri = _m.row_offsets[r]; ri < _m.row_offsets[r+1]; ++ri)
+        for (IndexType ri = h.row_offsets[r]; ri < h.row_offsets[r+1]; ++ri)
         {
-            ValueType val = _m.values[ri];
-            matrix_stats.max_val = std::max(matrix_stats.max_val, val);
-            matrix_stats.min_val = std::min(matrix_stats.min_val, val);
+            ValueType val = h.values[ri];
 
             rnorm[r] += val*val;
-            cnorm[_m.column_indices[ri]] += val*val;
+            cnorm[h.column_indices[ri]] += val*val;
         }
     }
     for (IndexType r=0; r<m; ++r) {
@@ -587,8 +750,6 @@ bool matrix_canvas<IndexType,ValueType,MemorySpace>::load_matrix(const MatrixTyp
     for (IndexType r=0; r<n; ++r) {
         cnorm[r]=1.0/std::sqrt(cnorm[r]);
     }
-
-    return (true);
 }
 
 template< typename IndexType, typename ValueType, typename MemorySpace >
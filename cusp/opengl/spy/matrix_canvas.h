@@ -21,7 +21,9 @@
 #include <cmath>
 #include <vector>
 
+#include <cusp/array1d.h>
 #include <cusp/csr_matrix.h>
+#include <cusp/opengl/spy/density_grid.h>
 #include <cusp/opengl/spy/glut_2d_canvas.h>
 #include <cusp/opengl/spy/matrix_data_panel.h>
 #include <cusp/opengl/spy/matrix_data_cursor.h>
@@ -74,6 +76,15 @@ protected:
 
     GLuint matrix_display_list;
 
+    // views of large matrices with more than one row or column per pixel
+    // are drawn from a grid of nonzero counts binned in MemorySpace, which
+    // is only recomputed when the visible window changes (zoom and pan)
+    cusp::array1d<unsigned int, MemorySpace> density_counts;
+    std::vector<unsigned int> density_host_counts;
+    std::vector<float> density_image;
+    int density_window[6];
+    GLuint density_texture;
+
 public:
     matrix_canvas(int w, int h);
 
@@ -141,6 +152,7 @@ public:
         permutation_state = p;
     }
     void set_normalization(normalization_state_type n) {
+        if (n != no_normalization) compute_norms();
         normalization_state = n;
     }
 
@@ -168,6 +180,9 @@ protected:
     void draw_full_matrix();
     void draw_partial_matrix(int r1, int c1, int r2, int c2);
 
+    bool use_density(int r1, int c1, int r2, int c2);
+    void draw_density(int r1, int c1, int r2, int c2);
+
     template <bool partial, class NRMap, class NCMap, class PRMap, class PCMap>
     void draw_matrix(int r1, int c1, int r2, int c2,
                      ValueType min, ValueType inv_val_range, float alpha,
@@ -210,6 +225,8 @@ protected:
     void init_display_list();
     void init_menu();
 
+    void compute_norms();
+
     ValueType matrix_value(IndexType r, IndexType c);
     const std::string& row_label(IndexType r);
     const std::string& column_label(IndexType r);
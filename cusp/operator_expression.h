@@ -0,0 +1,381 @@
+/*
+ *  Copyright 2008-2014 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*! \file operator_expression.h
+ *  \brief Lazy sums, products, scalings and shifts of linear operators
+ */
+
+#pragma once
+
+#include <cusp/detail/config.h>
+
+#include <cusp/array1d.h>
+#include <cusp/linear_operator.h>
+
+#include <thrust/detail/type_traits.h>
+
+namespace cusp
+{
+
+/*! \cond */
+template <typename Operator1, typename Operator2> class sum_operator;
+template <typename Operator1, typename Operator2> class product_operator;
+template <typename Operator> class scaled_operator;
+template <typename Operator> class shifted_operator;
+
+namespace detail
+{
+
+template <typename Operator>
+struct is_operator_expression : public thrust::detail::false_type {};
+
+template <typename Operator1, typename Operator2>
+struct is_operator_expression< sum_operator<Operator1,Operator2> > : public thrust::detail::true_type {};
+
+template <typename Operator1, typename Operator2>
+struct is_operator_expression< product_operator<Operator1,Operator2> > : public thrust::detail::true_type {};
+
+template <typename Operator>
+struct is_operator_expression< scaled_operator<Operator> > : public thrust::detail::true_type {};
+
+template <typename Operator>
+struct is_operator_expression< shifted_operator<Operator> > : public thrust::detail::true_type {};
+
+// matrices and user operators are referenced, nested expressions are
+// small and held by value so temporaries may be composed
+template <typename Operator>
+struct operand_storage
+{
+    typedef typename thrust::detail::eval_if<
+              is_operator_expression<Operator>::value,
+              thrust::detail::identity_<const Operator>,
+              thrust::detail::identity_<const Operator&>
+            >::type type;
+};
+
+} // end namespace detail
+/*! \endcond */
+
+/*! \addtogroup sparse_matrices Sparse Matrices
+ */
+
+/*! \addtogroup sparse_matrix_containers Sparse Matrix Containers
+ *  \ingroup sparse_matrices
+ *  \{
+ */
+
+/**
+ * \brief Lazy sum of two linear operators, <tt>A + B</tt>
+ *
+ * \tparam Operator1 Type of the first operand
+ * \tparam Operator2 Type of the second operand
+ *
+ * \par Overview
+ *  Operator expressions compose matrices and \p linear_operator objects
+ *  without forming the result. Every node applies itself as
+ *  <tt>y = alpha * op(x) + beta * y</tt>, so a sparse matrix operand
+ *  accumulates into \p y inside its SpMV, with the scale folded into the
+ *  products, and no intermediate vector is needed. Other operands are
+ *  applied into a workspace owned by the node and reused on every
+ *  application.
+ *
+ *  Matrices and user operators are held by reference and must outlive the
+ *  expression. The nodes are \p linear_operator objects, so they can be
+ *  passed to \p multiply and to every solver in \p cusp::krylov.
+ *
+ * \see sum
+ * \see product
+ * \see scaled
+ * \see shifted
+ *
+ * \par Example
+ *  \code
+ * #include <cusp/csr_matrix.h>
+ * #include <cusp/monitor.h>
+ * #include <cusp/operator_expression.h>
+ * #include <cusp/gallery/poisson.h>
+ * #include <cusp/krylov/cg.h>
+ *
+ * int main(void)
+ * {
+ *   cusp::csr_matrix<int, float, cusp::device_memory> A;
+ *   cusp::gallery::poisson5pt(A, 10, 10);
+ *
+ *   cusp::array1d<float, cusp::device_memory> x(A.num_rows, 0);
+ *   cusp::array1d<float, cusp::device_memory> b(A.num_rows, 1);
+ *
+ *   cusp::monitor<float> monitor(b, 100, 1e-6);
+ *
+ *   // solve (A + 0.5 I) x = b without forming A + 0.5 I
+ *   cusp::krylov::cg(cusp::shifted(A, 0.5f), x, b, monitor);
+ * }
+ *  \endcode
+ */
+template <typename Operator1, typename Operator2>
+class sum_operator
+    : public cusp::linear_operator<typename Operator1::value_type, typename Operator1::memory_space, typename Operator1::index_type>
+{
+private:
+
+    typedef cusp::linear_operator<typename Operator1::value_type, typename Operator1::memory_space, typename Operator1::index_type> Parent;
+
+    typedef typename Operator1::value_type   ValueType;
+    typedef typename Operator1::memory_space MemorySpace;
+
+    mutable cusp::array1d<ValueType,MemorySpace> workspace;
+
+public:
+
+    /*! First operand.
+     */
+    typename cusp::detail::operand_storage<Operator1>::type A;
+
+    /*! Second operand.
+     */
+    typename cusp::detail::operand_storage<Operator2>::type B;
+
+    /*! Construct the sum of two operators.
+     *
+     *  \throws cusp::invalid_input_exception if the shapes differ.
+     */
+    sum_operator(const Operator1& A, const Operator2& B);
+
+    /*! Compute <tt>y = alpha * (A + B) * x + beta * y</tt>.
+     */
+    template <typename DerivedPolicy, typename VectorType1, typename VectorType2>
+    void apply(thrust::execution_policy<DerivedPolicy>& exec, const VectorType1& x, VectorType2& y,
+               const ValueType alpha, const ValueType beta) const;
+
+    /*! Compute <tt>y = (A + B) * x</tt>.
+     */
+    template <typename DerivedPolicy, typename VectorType1, typename VectorType2>
+    void operator()(thrust::execution_policy<DerivedPolicy>& exec, const VectorType1& x, VectorType2& y) const;
+
+    /*! Compute <tt>y = (A + B) * x</tt>.
+     */
+    template <typename VectorType1, typename VectorType2>
+    void operator()(const VectorType1& x, VectorType2& y) const;
+}; // class sum_operator
+
+/**
+ * \brief Lazy product of two linear operators, <tt>A * B</tt>
+ *
+ * \tparam Operator1 Type of the left operand
+ * \tparam Operator2 Type of the right operand
+ *
+ * \par Overview
+ *  Applies \p B into an intermediate vector owned by the node and \p A to
+ *  the intermediate, see \p sum_operator.
+ */
+template <typename Operator1, typename Operator2>
+class product_operator
+    : public cusp::linear_operator<typename Operator1::value_type, typename Operator1::memory_space, typename Operator1::index_type>
+{
+private:
+
+    typedef cusp::linear_operator<typename Operator1::value_type, typename Operator1::memory_space, typename Operator1::index_type> Parent;
+
+    typedef typename Operator1::value_type   ValueType;
+    typedef typename Operator1::memory_space MemorySpace;
+
+    mutable cusp::array1d<ValueType,MemorySpace> intermediate;
+    mutable cusp::array1d<ValueType,MemorySpace> workspace;
+
+public:
+
+    /*! Left operand.
+     */
+    typename cusp::detail::operand_storage<Operator1>::type A;
+
+    /*! Right operand.
+     */
+    typename cusp::detail::operand_storage<Operator2>::type B;
+
+    /*! Construct the product of two operators.
+     *
+     *  \throws cusp::invalid_input_exception if the inner dimensions differ.
+     */
+    product_operator(const Operator1& A, const Operator2& B);
+
+    /*! Compute <tt>y = alpha * A * B * x + beta * y</tt>.
+     */
+    template <typename DerivedPolicy, typename VectorType1, typename VectorType2>
+    void apply(thrust::execution_policy<DerivedPolicy>& exec, const VectorType1& x, VectorType2& y,
+               const ValueType alpha, const ValueType beta) const;
+
+    /*! Compute <tt>y = A * B * x</tt>.
+     */
+    template <typename DerivedPolicy, typename VectorType1, typename VectorType2>
+    void operator()(thrust::execution_policy<DerivedPolicy>& exec, const VectorType1& x, VectorType2& y) const;
+
+    /*! Compute <tt>y = A * B * x</tt>.
+     */
+    template <typename VectorType1, typename VectorType2>
+    void operator()(const VectorType1& x, VectorType2& y) const;
+}; // class product_operator
+
+/**
+ * \brief Lazy scaling of a linear operator, <tt>alpha * A</tt>
+ *
+ * \tparam Operator Type of the operand
+ *
+ * \par Overview
+ *  The scale is folded into the application of \p A, see \p sum_operator.
+ */
+template <typename Operator>
+class scaled_operator
+    : public cusp::linear_operator<typename Operator::value_type, typename Operator::memory_space, typename Operator::index_type>
+{
+private:
+
+    typedef cusp::linear_operator<typename Operator::value_type, typename Operator::memory_space, typename Operator::index_type> Parent;
+
+    typedef typename Operator::value_type   ValueType;
+    typedef typename Operator::memory_space MemorySpace;
+
+    mutable cusp::array1d<ValueType,MemorySpace> workspace;
+
+public:
+
+    /*! Scale of the operand.
+     */
+    ValueType alpha;
+
+    /*! Operand.
+     */
+    typename cusp::detail::operand_storage<Operator>::type A;
+
+    /*! Construct the scaling of an operator.
+     */
+    scaled_operator(const ValueType alpha, const Operator& A);
+
+    /*! Compute <tt>y = scale * alpha * A * x + beta * y</tt>.
+     */
+    template <typename DerivedPolicy, typename VectorType1, typename VectorType2>
+    void apply(thrust::execution_policy<DerivedPolicy>& exec, const VectorType1& x, VectorType2& y,
+               const ValueType scale, const ValueType beta) const;
+
+    /*! Compute <tt>y = alpha * A * x</tt>.
+     */
+    template <typename DerivedPolicy, typename VectorType1, typename VectorType2>
+    void operator()(thrust::execution_policy<DerivedPolicy>& exec, const VectorType1& x, VectorType2& y) const;
+
+    /*! Compute <tt>y = alpha * A * x</tt>.
+     */
+    template <typename VectorType1, typename VectorType2>
+    void operator()(const VectorType1& x, VectorType2& y) const;
+}; // class scaled_operator
+
+/**
+ * \brief Lazy shift of a linear operator, <tt>A + sigma * I</tt>
+ *
+ * \tparam Operator Type of the operand
+ *
+ * \par Overview
+ *  Writes <tt>sigma * x</tt> to the output and lets \p A accumulate onto
+ *  it, see \p sum_operator.
+ */
+template <typename Operator>
+class shifted_operator
+    : public cusp::linear_operator<typename Operator::value_type, typename Operator::memory_space, typename Operator::index_type>
+{
+private:
+
+    typedef cusp::linear_operator<typename Operator::value_type, typename Operator::memory_space, typename Operator::index_type> Parent;
+
+    typedef typename Operator::value_type   ValueType;
+    typedef typename Operator::memory_space MemorySpace;
+
+    mutable cusp::array1d<ValueType,MemorySpace> workspace;
+
+public:
+
+    /*! Operand.
+     */
+    typename cusp::detail::operand_storage<Operator>::type A;
+
+    /*! Shift of the diagonal.
+     */
+    ValueType sigma;
+
+    /*! Construct the shift of an operator.
+     *
+     *  \throws cusp::invalid_input_exception if \p A is not square.
+     */
+    shifted_operator(const Operator& A, const ValueType sigma);
+
+    /*! Compute <tt>y = alpha * (A + sigma * I) * x + beta * y</tt>.
+     */
+    template <typename DerivedPolicy, typename VectorType1, typename VectorType2>
+    void apply(thrust::execution_policy<DerivedPolicy>& exec, const VectorType1& x, VectorType2& y,
+               const ValueType alpha, const ValueType beta) const;
+
+    /*! Compute <tt>y = (A + sigma * I) * x</tt>.
+     */
+    template <typename DerivedPolicy, typename VectorType1, typename VectorType2>
+    void operator()(thrust::execution_policy<DerivedPolicy>& exec, const VectorType1& x, VectorType2& y) const;
+
+    /*! Compute <tt>y = (A + sigma * I) * x</tt>.
+     */
+    template <typename VectorType1, typename VectorType2>
+    void operator()(const VectorType1& x, VectorType2& y) const;
+}; // class shifted_operator
+
+/**
+ * \brief Compose the lazy sum <tt>A + B</tt>
+ *
+ * \param A First operand
+ * \param B Second operand
+ */
+template <typename Operator1, typename Operator2>
+sum_operator<Operator1,Operator2>
+sum(const Operator1& A, const Operator2& B);
+
+/**
+ * \brief Compose the lazy product <tt>A * B</tt>
+ *
+ * \param A Left operand
+ * \param B Right operand
+ */
+template <typename Operator1, typename Operator2>
+product_operator<Operator1,Operator2>
+product(const Operator1& A, const Operator2& B);
+
+/**
+ * \brief Compose the lazy scaling <tt>alpha * A</tt>
+ *
+ * \param alpha Scale
+ * \param A Operand
+ */
+template <typename Operator>
+scaled_operator<Operator>
+scaled(const typename Operator::value_type alpha, const Operator& A);
+
+/**
+ * \brief Compose the lazy shift <tt>A + sigma * I</tt>
+ *
+ * \param A Operand
+ * \param sigma Shift of the diagonal
+ */
+template <typename Operator>
+shifted_operator<Operator>
+shifted(const Operator& A, const typename Operator::value_type sigma);
+/*! \}
+ */
+
+} // end namespace cusp
+
+#include <cusp/detail/operator_expression.inl>
@@ -0,0 +1,231 @@
+/*
+ *  Copyright 2008-2014 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+
+/*! \file permuted_operator.h
+ *  \brief Symmetrically permuted matrix applied without forming it
+ */
+
+#pragma once
+
+#include <cusp/detail/config.h>
+
+#include <cusp/array1d.h>
+#include <cusp/linear_operator.h>
+
+#include <thrust/iterator/permutation_iterator.h>
+
+namespace cusp
+{
+
+/*! \addtogroup containers Containers
+ *  \{
+ */
+
+/**
+ * \brief View of a vector through an index array
+ *
+ * \tparam ArrayType1 Type of the viewed vector.
+ * \tparam ArrayType2 Type of the index array.
+ *
+ * \param v Vector to view.
+ * \param indices Indices of the entries of \p v in the order of the view.
+ *
+ * \return \p array1d_view whose entry \c i is <tt>v[indices[i]]</tt>
+ *
+ * \par Overview
+ *  Reading and writing the view gathers from and scatters to \p v, so a
+ *  solver can work on a reordered vector without a reordered copy. Both
+ *  \p v and \p indices must outlive the view.
+ */
+template <typename ArrayType1, typename ArrayType2>
+cusp::array1d_view< thrust::permutation_iterator<typename ArrayType1::iterator, typename ArrayType2::const_iterator> >
+make_permuted_array1d_view(ArrayType1& v, const ArrayType2& indices);
+
+/*! \cond */
+template <typename ArrayType1, typename ArrayType2>
+cusp::array1d_view< thrust::permutation_iterator<typename ArrayType1::const_iterator, typename ArrayType2::const_iterator> >
+make_permuted_array1d_view(const ArrayType1& v, const ArrayType2& indices);
+/*! \endcond */
+
+/**
+ * \brief Linear operator applying a symmetrically permuted matrix
+ *
+ * \tparam MatrixType Type of the unpermuted matrix.
+ *
+ * \par Overview
+ *  A \p permuted_operator applies <tt>B = P A P^T</tt>, the matrix that
+ *  <tt>P.symmetric_permute(A)</tt> would produce, without a second copy
+ *  of \p A. Entry <tt>(i, j)</tt> of \p B is entry
+ *  <tt>(inverse[i], inverse[j])</tt> of \p A, where \p inverse is the
+ *  inverse of the permutation of \p P.
+ *
+ *  For CSR matrices the row permutation is folded into the row lookup and
+ *  the column permutation into the gather from \p x, so <tt>y = B x</tt>
+ *  reads \p A once and neither vector is reordered. Other formats permute
+ *  \p x into a workspace, multiply with \p A and gather the result.
+ *
+ *  \p permuted_view presents a vector stored in the order of \p A in the
+ *  order of \p B, which avoids reordering the right hand side and the
+ *  solution of a solve with an explicitly permuted matrix.
+ *
+ *  The operator keeps a reference to \p A, which must outlive it, and a
+ *  copy of the permutation.
+ *
+ * \par Example
+ *  \code
+ *  #include <cusp/permuted_operator.h>
+ *  #include <cusp/copy.h>
+ *  #include <cusp/csr_matrix.h>
+ *  #include <cusp/permutation_matrix.h>
+ *  #include <cusp/gallery/poisson.h>
+ *  #include <cusp/graph/symmetric_rcm.h>
+ *  #include <cusp/krylov/cg.h>
+ *  #include <cusp/monitor.h>
+ *
+ *  int main(void)
+ *  {
+ *      cusp::csr_matrix<int, float, cusp::device_memory> A;
+ *      cusp::gallery::poisson5pt(A, 256, 256);
+ *
+ *      cusp::permutation_matrix<int, cusp::device_memory> P(A.num_rows);
+ *      cusp::graph::symmetric_rcm(A, P);
+ *
+ *      // B = P A P^T
+ *      cusp::permuted_operator< cusp::csr_matrix<int, float, cusp::device_memory> > B(A, P);
+ *
+ *      // x and b are stored in the original order
+ *      cusp::array1d<float, cusp::device_memory> x(A.num_rows, 0);
+ *      cusp::array1d<float, cusp::device_memory> b(A.num_rows, 1);
+ *
+ *      // solve (P A P^T) (P x) = P b without reordering x or b
+ *      cusp::array1d<float, cusp::device_memory> Pb(B.permuted_view(b));
+ *      cusp::array1d<float, cusp::device_memory> Px(B.permuted_view(x));
+ *
+ *      cusp::monitor<float> monitor(Pb, 100, 1e-6);
+ *      cusp::krylov::cg(B, Px, Pb, monitor);
+ *
+ *      // write the solution back in the original order
+ *      cusp::array1d_view< thrust::permutation_iterator<
+ *          cusp::array1d<float, cusp::device_memory>::iterator,
+ *          cusp::array1d<int, cusp::device_memory>::const_iterator> > x_view(B.permuted_view(x));
+ *      cusp::copy(Px, x_view);
+ *  }
+ *  \endcode
+ */
+template <typename MatrixType>
+class permuted_operator
+  : public cusp::linear_operator<typename MatrixType::value_type,
+                                 typename MatrixType::memory_space,
+                                 typename MatrixType::index_type>
+{
+  private:
+
+    typedef typename MatrixType::index_type   IndexType;
+    typedef typename MatrixType::value_type   ValueType;
+    typedef typename MatrixType::memory_space MemorySpace;
+
+    typedef cusp::linear_operator<ValueType,MemorySpace,IndexType> Parent;
+
+  public:
+
+    /*! \cond */
+    typedef cusp::array1d<IndexType,MemorySpace> permutation_array_type;
+    /*! \endcond */
+
+    /*! Permutation of the rows and columns, row \c i of \p A is row
+     *  <tt>permutation[i]</tt> of \p B.
+     */
+    permutation_array_type permutation;
+
+    /*! Inverse of \p permutation, row \c i of \p B is row
+     *  <tt>inverse[i]</tt> of \p A.
+     */
+    permutation_array_type inverse;
+
+    /*! Construct the operator <tt>P A P^T</tt>.
+     *
+     *  \tparam PermutationType \p permutation_matrix or
+     *  \p permutation_matrix_view
+     *
+     *  \param A square matrix, referenced by the operator.
+     *  \param P permutation of the rows and columns of \p A.
+     *
+     *  \throws cusp::invalid_input_exception if \p A is not square or \p P
+     *  does not match its size
+     */
+    template <typename PermutationType>
+    permuted_operator(const MatrixType& A, const PermutationType& P);
+
+    /*! Multiply the permuted matrix with \p x, y = P A P^T x.
+     *
+     *  \param x Input vector.
+     *  \param y Output vector.
+     */
+    template <typename DerivedPolicy, typename VectorType1, typename VectorType2>
+    void operator()(thrust::execution_policy<DerivedPolicy>& exec, const VectorType1& x, VectorType2& y) const;
+
+    /*! Multiply the permuted matrix with \p x, y = P A P^T x.
+     *
+     *  \param x Input vector.
+     *  \param y Output vector.
+     */
+    template <typename VectorType1, typename VectorType2>
+    void operator()(const VectorType1& x, VectorType2& y) const;
+
+    /*! View of the vector \p v, stored in the order of \p A, in the order
+     *  of the permuted matrix: entry \c i of the view is
+     *  <tt>v[inverse[i]]</tt>.
+     */
+    template <typename ArrayType>
+    cusp::array1d_view< thrust::permutation_iterator<typename ArrayType::iterator,
+                                                     typename permutation_array_type::const_iterator> >
+    permuted_view(ArrayType& v) const
+    {
+        return cusp::make_permuted_array1d_view(v, inverse);
+    }
+
+    /*! \cond */
+    template <typename ArrayType>
+    cusp::array1d_view< thrust::permutation_iterator<typename ArrayType::const_iterator,
+                                                     typename permutation_array_type::const_iterator> >
+    permuted_view(const ArrayType& v) const
+    {
+        return cusp::make_permuted_array1d_view(v, inverse);
+    }
+    /*! \endcond */
+
+  private:
+
+    /*! \cond */
+    const MatrixType* A;
+
+    mutable cusp::array1d<ValueType,MemorySpace> x_workspace;
+    mutable cusp::array1d<ValueType,MemorySpace> y_workspace;
+
+    template <typename DerivedPolicy, typename VectorType1, typename VectorType2>
+    void apply(const thrust::detail::execution_policy_base<DerivedPolicy>& policy, const VectorType1& x, VectorType2& y, cusp::csr_format) const;
+
+    template <typename DerivedPolicy, typename VectorType1, typename VectorType2, typename Format>
+    void apply(const thrust::detail::execution_policy_base<DerivedPolicy>& policy, const VectorType1& x, VectorType2& y, Format) const;
+    /*! \endcond */
+};
+/*! \}
+ */
+
+} // end namespace cusp
+
+#include <cusp/detail/permuted_operator.inl>
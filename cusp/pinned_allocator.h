@@ -0,0 +1,119 @@
+/*
+ *  Copyright 2008-2014 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+
+/*! \file pinned_allocator.h
+ *  \brief Host allocator returning page-locked memory
+ */
+
+#pragma once
+
+#include <cusp/detail/config.h>
+
+#include <cstddef>
+#include <memory>
+
+namespace cusp
+{
+
+/*! \addtogroup utilities Utilities
+ *  \{
+ */
+
+/**
+ * \brief Host allocator returning page-locked (pinned) memory
+ *
+ * \tparam T element type
+ *
+ * \par Overview
+ *  The device can access page-locked memory directly, so copies between
+ *  page-locked host storage and device storage run at the full speed of
+ *  the link and need not block the host, whereas copies from pageable
+ *  memory are staged through a driver buffer. \p pinned_allocator is the
+ *  \c default_memory_allocator of \p cusp::pinned_memory. Allocations
+ *  which cannot be page-locked throw \c std::bad_alloc. Without a CUDA
+ *  device system \p pinned_allocator behaves like \c std::allocator.
+ *
+ * \par Example
+ *  \code
+ *  #include <cusp/array1d.h>
+ *  #include <cusp/csr_matrix.h>
+ *  #include <cusp/gallery/poisson.h>
+ *
+ *  int main(void)
+ *  {
+ *      // assemble the matrix in page-locked host memory
+ *      cusp::csr_matrix<int, float, cusp::pinned_memory> A;
+ *      cusp::gallery::poisson5pt(A, 1000, 1000);
+ *
+ *      // the transfer reads the pinned arrays directly
+ *      cusp::csr_matrix<int, float, cusp::device_memory> B(A);
+ *
+ *      return 0;
+ *  }
+ *  \endcode
+ */
+template <typename T>
+class pinned_allocator : public std::allocator<T>
+{
+private:
+
+    typedef std::allocator<T> Parent;
+
+public:
+
+    /*! \cond */
+    template <typename U>
+    struct rebind
+    {
+        typedef pinned_allocator<U> other;
+    };
+    /*! \endcond */
+
+    /*! Construct a \p pinned_allocator.
+     */
+    pinned_allocator(void) {}
+
+    /*! Copy constructor, \p pinned_allocator is stateless.
+     */
+    pinned_allocator(const pinned_allocator& other) : Parent(other) {}
+
+    /*! Converting constructor from a \p pinned_allocator of another type.
+     */
+    template <typename U>
+    pinned_allocator(const pinned_allocator<U>& other) : Parent(other) {}
+
+    /*! Allocate page-locked storage for \p num_elements elements of type \c T.
+     *
+     *  \param num_elements Number of elements to allocate.
+     *  \param hint Ignored.
+     *  \return Pointer to the storage, which holds no constructed elements.
+     */
+    T* allocate(size_t num_elements, const void* hint = 0);
+
+    /*! Release storage returned by \p allocate.
+     *
+     *  \param ptr Pointer returned by \p allocate.
+     *  \param num_elements Number of elements passed to \p allocate.
+     */
+    void deallocate(T* ptr, size_t num_elements);
+};
+/*! \}
+ */
+
+} // end namespace cusp
+
+#include <cusp/detail/pinned_allocator.inl>
@@ -73,6 +73,45 @@ template <typename MatrixType,
 void mis_aggregate(const MatrixType& C,
                          ArrayType& aggregates);
 
+/* \cond */
+template <typename DerivedPolicy,
+          typename MatrixType,
+          typename ArrayType1,
+          typename ArrayType2>
+void mis2_aggregate(const thrust::detail::execution_policy_base<DerivedPolicy> &exec,
+                    const MatrixType& C,
+                          ArrayType1& aggregates,
+                          ArrayType2& roots,
+                    const size_t num_rounds = 5);
+/* \endcond */
+
+/*! \brief On-device aggregation based on a distance-2 maximal independent set
+ *
+ * Runs \p num_rounds Luby rounds on the 2-ring of \p C with hashed random
+ * priorities instead of iterating until the independent set is maximal,
+ * which avoids a host synchronization per round. The selected nodes become
+ * roots whose aggregates absorb their 2-ring. A fix-up pass then attaches
+ * the remaining nodes to adjacent aggregates or seeds new aggregates among
+ * them, so every node is aggregated and every aggregate is connected.
+ *
+ * \param C strength of connection matrix
+ * \param aggregates aggregate index of every node
+ * \param roots root node of every aggregate
+ * \param num_rounds number of independent set rounds
+ */
+template <typename MatrixType,
+          typename ArrayType1,
+          typename ArrayType2>
+void mis2_aggregate(const MatrixType& C,
+                          ArrayType1& aggregates,
+                          ArrayType2& roots,
+                    const size_t num_rounds = 5);
+
+template <typename MatrixType,
+          typename ArrayType>
+void mis2_aggregate(const MatrixType& C,
+                          ArrayType& aggregates);
+
 /* \cond */
 template <typename DerivedPolicy,
           typename MatrixType,
@@ -96,6 +135,71 @@ template <typename MatrixType,
 void aggregate(const MatrixType& C,
                      ArrayType& aggregates);
 
+/* \cond */
+template <typename DerivedPolicy,
+          typename MatrixType,
+          typename ArrayType1,
+          typename ArrayType2>
+void aggressive_aggregate(const thrust::detail::execution_policy_base<DerivedPolicy> &exec,
+                          const MatrixType& C,
+                                ArrayType1& aggregates,
+                                ArrayType2& roots);
+/* \endcond */
+
+/*! \brief Aggressive aggregation, aggregating the graph of the aggregates
+ *
+ * The nodes of \p C are aggregated with \p aggregate, the graph joining
+ * aggregates that hold adjacent nodes is aggregated again and both
+ * aggregations are composed. The aggregates span at least the distance-2
+ * neighborhoods of their roots, which reduces the size of the next level
+ * several times more than a single aggregation.
+ */
+template <typename MatrixType,
+          typename ArrayType1,
+          typename ArrayType2>
+void aggressive_aggregate(const MatrixType& C,
+                                ArrayType1& aggregates,
+                                ArrayType2& roots);
+
+template <typename MatrixType,
+          typename ArrayType>
+void aggressive_aggregate(const MatrixType& C,
+                                ArrayType& aggregates);
+
+/* \cond */
+template <typename DerivedPolicy,
+          typename MatrixType,
+          typename ArrayType1,
+          typename ArrayType2>
+void bound_aggregates(const thrust::detail::execution_policy_base<DerivedPolicy> &exec,
+                      const MatrixType& C,
+                            ArrayType1& aggregates,
+                            ArrayType2& roots,
+                      const size_t min_size,
+                      const size_t max_size);
+/* \endcond */
+
+/*! \brief Merge small aggregates and split large ones
+ *
+ * Every aggregate with fewer than \p min_size nodes joins the adjacent
+ * aggregate that stays within \p max_size, the smallest one if several
+ * do, and every aggregate with more than \p max_size nodes is then cut
+ * into pieces of balanced size holding consecutive nodes. Aggregates are
+ * renumbered and every aggregate keeps its root if it still holds it.
+ *
+ * With <tt>min_size <= max_size / 2</tt> all aggregates end up within both
+ * bounds, except small aggregates without neighbors. Zero disables either
+ * bound.
+ */
+template <typename MatrixType,
+          typename ArrayType1,
+          typename ArrayType2>
+void bound_aggregates(const MatrixType& C,
+                            ArrayType1& aggregates,
+                            ArrayType2& roots,
+                      const size_t min_size,
+                      const size_t max_size);
+
 } // end namespace aggregation
 } // end namespace precond
 } // end namespace cusp
@@ -18,6 +18,8 @@
 
 #include <cusp/precond/aggregation/system/detail/generic/standard_aggregate.h>
 #include <cusp/precond/aggregation/system/detail/generic/mis_aggregate.h>
+#include <cusp/precond/aggregation/system/detail/generic/mis2_aggregate.h>
+#include <cusp/precond/aggregation/system/detail/generic/bounded_aggregate.h>
 
 namespace cusp
 {
@@ -126,6 +128,55 @@ void mis_aggregate(const MatrixType& A,
     return mis_aggregate(A, aggregates, roots);
 }
 
+template <typename DerivedPolicy,
+          typename MatrixType,
+          typename ArrayType1,
+          typename ArrayType2>
+void mis2_aggregate(const thrust::detail::execution_policy_base<DerivedPolicy> &exec,
+                    const MatrixType& A,
+                          ArrayType1& aggregates,
+                          ArrayType2& roots,
+                    const size_t num_rounds)
+{
+    using cusp::precond::aggregation::detail::mis2_aggregate;
+
+    return mis2_aggregate(thrust::detail::derived_cast(thrust::detail::strip_const(exec)), A, aggregates, roots, num_rounds);
+}
+
+template <typename MatrixType,
+          typename ArrayType1,
+          typename ArrayType2>
+void mis2_aggregate(const MatrixType& A,
+                          ArrayType1& aggregates,
+                          ArrayType2& roots,
+                    const size_t num_rounds)
+{
+    using thrust::system::detail::generic::select_system;
+
+    typedef typename MatrixType::memory_space System1;
+    typedef typename ArrayType1::memory_space System2;
+    typedef typename ArrayType2::memory_space System3;
+
+    System1 system1;
+    System2 system2;
+    System3 system3;
+
+    return mis2_aggregate(select_system(system1,system2,system3), A, aggregates, roots, num_rounds);
+}
+
+template <typename MatrixType,
+          typename ArrayType>
+void mis2_aggregate(const MatrixType& A,
+                          ArrayType& aggregates)
+{
+    typedef typename MatrixType::index_type   IndexType;
+    typedef typename ArrayType::memory_space  MemorySpace;
+
+    cusp::array1d<IndexType, MemorySpace> roots(A.num_rows);
+
+    return mis2_aggregate(A, aggregates, roots);
+}
+
 template <typename DerivedPolicy,
           typename MatrixType,
           typename ArrayType1,
@@ -149,7 +200,7 @@ aggregate(thrust::execution_policy<DerivedPolicy> &exec,
                 ArrayType1& aggregates,
                 ArrayType2& roots)
 {
-    return mis_aggregate(exec, A, aggregates, roots);
+    return mis2_aggregate(exec, A, aggregates, roots);
 }
 
 template <typename DerivedPolicy,
@@ -197,6 +248,91 @@ void aggregate(const MatrixType& A,
     return aggregate(A, aggregates, roots);
 }
 
+template <typename DerivedPolicy,
+          typename MatrixType,
+          typename ArrayType1,
+          typename ArrayType2>
+void aggressive_aggregate(const thrust::detail::execution_policy_base<DerivedPolicy> &exec,
+                          const MatrixType& C,
+                                ArrayType1& aggregates,
+                                ArrayType2& roots)
+{
+    using cusp::precond::aggregation::detail::aggressive_aggregate;
+
+    return aggressive_aggregate(thrust::detail::derived_cast(thrust::detail::strip_const(exec)), C, aggregates, roots);
+}
+
+template <typename MatrixType,
+          typename ArrayType1,
+          typename ArrayType2>
+void aggressive_aggregate(const MatrixType& C,
+                                ArrayType1& aggregates,
+                                ArrayType2& roots)
+{
+    using thrust::system::detail::generic::select_system;
+
+    typedef typename MatrixType::memory_space System1;
+    typedef typename ArrayType1::memory_space System2;
+    typedef typename ArrayType2::memory_space System3;
+
+    System1 system1;
+    System2 system2;
+    System3 system3;
+
+    return cusp::precond::aggregation::aggressive_aggregate(select_system(system1,system2,system3), C, aggregates, roots);
+}
+
+template <typename MatrixType,
+          typename ArrayType>
+void aggressive_aggregate(const MatrixType& C,
+                                ArrayType& aggregates)
+{
+    typedef typename MatrixType::index_type   IndexType;
+    typedef typename ArrayType::memory_space  MemorySpace;
+
+    cusp::array1d<IndexType, MemorySpace> roots(C.num_rows);
+
+    return aggressive_aggregate(C, aggregates, roots);
+}
+
+template <typename DerivedPolicy,
+          typename MatrixType,
+          typename ArrayType1,
+          typename ArrayType2>
+void bound_aggregates(const thrust::detail::execution_policy_base<DerivedPolicy> &exec,
+                      const MatrixType& C,
+                            ArrayType1& aggregates,
+                            ArrayType2& roots,
+                      const size_t min_size,
+                      const size_t max_size)
+{
+    using cusp::precond::aggregation::detail::bound_aggregates;
+
+    return bound_aggregates(thrust::detail::derived_cast(thrust::detail::strip_const(exec)), C, aggregates, roots, min_size, max_size);
+}
+
+template <typename MatrixType,
+          typename ArrayType1,
+          typename ArrayType2>
+void bound_aggregates(const MatrixType& C,
+                            ArrayType1& aggregates,
+                            ArrayType2& roots,
+                      const size_t min_size,
+                      const size_t max_size)
+{
+    using thrust::system::detail::generic::select_system;
+
+    typedef typename MatrixType::memory_space System1;
+    typedef typename ArrayType1::memory_space System2;
+    typedef typename ArrayType2::memory_space System3;
+
+    System1 system1;
+    System2 system2;
+    System3 system3;
+
+    return cusp::precond::aggregation::bound_aggregates(select_system(system1,system2,system3), C, aggregates, roots, min_size, max_size);
+}
+
 } // end namespace aggregation
 } // end namespace precond
 } // end namespace cusp
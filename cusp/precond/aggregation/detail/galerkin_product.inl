@@ -38,10 +38,10 @@ void galerkin_product(thrust::execution_policy<DerivedPolicy> &exec,
                       const MatrixType1& P,
                             MatrixType3& RAP)
 {
-    // TODO test speed of R * (A * P) vs. (R * A) * P
-    MatrixType3 AP;
-    cusp::multiply(exec, A, P, AP);
-    cusp::multiply(exec, R, AP, RAP);
+    using cusp::system::detail::generic::galerkin_product;
+
+    // backends may compute R * A * P row by row without forming A * P
+    galerkin_product(exec, R, A, P, RAP);
 }
 
 } // end detail
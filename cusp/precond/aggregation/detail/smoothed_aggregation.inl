@@ -15,14 +15,24 @@
  */
 
 #include <cusp/array1d.h>
+#include <cusp/exception.h>
 #include <cusp/precond/aggregation/strength.h>
 #include <cusp/precond/aggregation/aggregate.h>
 #include <cusp/precond/aggregation/tentative.h>
 #include <cusp/precond/aggregation/smooth_prolongator.h>
 #include <cusp/precond/aggregation/restrict.h>
 #include <cusp/precond/aggregation/galerkin_product.h>
+#include <cusp/precond/aggregation/truncate.h>
 
 #include <cusp/detail/temporary_array.h>
+#include <cusp/detail/timer.h>
+
+#include <cusp/eigen/spectral_radius.h>
+#include <cusp/io/binary.h>
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
 
 namespace cusp
 {
@@ -30,12 +40,51 @@ namespace precond
 {
 namespace aggregation
 {
+namespace detail
+{
+
+// leading bytes of a binary smoothed_aggregation hierarchy
+static const char sa_binary_tag[8] = {'c','u','s','p','S','A','0','1'};
+
+template <typename T, typename Stream>
+void write_binary_value(const T& value, Stream& output)
+{
+    output.write(reinterpret_cast<const char *>(&value), sizeof(T));
+}
+
+template <typename T, typename Stream>
+void read_binary_value(T& value, Stream& input)
+{
+    input.read(reinterpret_cast<char *>(&value), sizeof(T));
+}
+
+#if __cplusplus >= 201103L
+// runs a setup phase on a new thread, which uses the device of the caller
+template <typename Function>
+std::future<void> launch_setup_task(const Function& f)
+{
+#if THRUST_DEVICE_SYSTEM == THRUST_DEVICE_SYSTEM_CUDA
+    int device = 0;
+    cudaGetDevice(&device);
+
+    return std::async(std::launch::async, [device, f]() { cudaSetDevice(device); f(); });
+#else
+    return std::async(std::launch::async, f);
+#endif
+}
+#endif
+
+} // end namespace detail
 
 template <typename IndexType, typename ValueType, typename MemorySpace, typename SmootherType, typename SolverType, typename Format>
 template <typename MatrixType>
 smoothed_aggregation<IndexType,ValueType,MemorySpace,SmootherType,SolverType,Format>
 ::smoothed_aggregation(const MatrixType& A)
-    : ML()
+    : ML(),
+      prolongator_theta(0), prolongator_max_entries(0),
+      operator_theta(0), operator_max_entries(0),
+      min_aggregate_size(0), max_aggregate_size(0), aggressive_levels(0),
+      overlap_setup(false)
 {
     initialize(A);
 }
@@ -44,7 +93,11 @@ template <typename IndexType, typename ValueType, typename MemorySpace, typename
 template <typename MatrixType, typename ArrayType>
 smoothed_aggregation<IndexType,ValueType,MemorySpace,SmootherType,SolverType,Format>
 ::smoothed_aggregation(const MatrixType& A, const ArrayType& B)
-    : ML()
+    : ML(),
+      prolongator_theta(0), prolongator_max_entries(0),
+      operator_theta(0), operator_max_entries(0),
+      min_aggregate_size(0), max_aggregate_size(0), aggressive_levels(0),
+      overlap_setup(false)
 {
     initialize(A, B);
 }
@@ -53,7 +106,11 @@ template <typename IndexType, typename ValueType, typename MemorySpace, typename
 template <typename MemorySpace2, typename SmootherType2, typename SolverType2, typename Format2>
 smoothed_aggregation<IndexType,ValueType,MemorySpace,SmootherType,SolverType,Format>
 ::smoothed_aggregation(const smoothed_aggregation<IndexType,ValueType,MemorySpace2,SmootherType2,SolverType2,Format2>& M)
-    : ML(M)
+    : ML(M),
+      prolongator_theta(M.prolongator_theta), prolongator_max_entries(M.prolongator_max_entries),
+      operator_theta(M.operator_theta), operator_max_entries(M.operator_max_entries),
+      min_aggregate_size(M.min_aggregate_size), max_aggregate_size(M.max_aggregate_size),
+      aggressive_levels(M.aggressive_levels), overlap_setup(M.overlap_setup)
 {
     for( size_t lvl = 0; lvl < M.sa_levels.size(); lvl++ )
         sa_levels.push_back(M.sa_levels[lvl]);
@@ -100,6 +157,7 @@ void smoothed_aggregation<IndexType,ValueType,MemorySpace,SmootherType,SolverTyp
         ML::levels.resize(0);
     }
 
+    ML::clear_setup_times();
     ML::resize(A.num_rows, A.num_cols, A.num_entries);
     ML::levels.reserve(ML::max_levels); // avoid reallocations which force matrix copies
     ML::levels.push_back(Level());
@@ -107,25 +165,264 @@ void smoothed_aggregation<IndexType,ValueType,MemorySpace,SmootherType,SolverTyp
     sa_levels.push_back(sa_level<SetupMatrixType>());
     sa_levels.back().B = B;
 
+    // the smoother of a level may be set up while the next level is formed,
+    // the setup of level i moves the matrix of level i so it starts once
+    // extend_hierarchy is done with it
+    setup_task task;
+
     // Setup the first level using a COO view
     if(A.num_rows > ML::min_level_size)
     {
         View A_(A);
         extend_hierarchy(exec, A_);
-        ML::setup_level(0, A, sa_levels[0]);
+        setup_level_task(0, A, task);
     }
 
     // Iteratively setup lower levels until stopping criteria are reached
     while ((sa_levels.back().A_.num_rows > ML::min_level_size) &&
             (sa_levels.size() < ML::max_levels))
-        extend_hierarchy(exec, sa_levels.back().A_);
+    {
+        const size_t lvl = sa_levels.size() - 1;
 
-    // Setup multilevel arrays and matrices on each level
-    for( size_t lvl = 1; lvl < sa_levels.size(); lvl++ )
-        ML::setup_level(lvl, sa_levels[lvl].A_, sa_levels[lvl]);
+        extend_hierarchy(exec, sa_levels[lvl].A_);
+        setup_level_task(lvl, sa_levels[lvl].A_, task);
+    }
 
-    // Initialize coarse solver
-    ML::initialize_coarse_solver();
+    // the coarse solver may be factored while the last smoother is set up
+    const size_t coarsest = sa_levels.size() - 1;
+
+    if(coarsest > 0)
+        ML::setup_level(coarsest, sa_levels[coarsest].A_, sa_levels[coarsest]);
+
+    ML::setup_coarse_solver();
+
+    finish_level_task(task);
+
+    ML::setup_host_levels();
+}
+
+template <typename IndexType, typename ValueType, typename MemorySpace, typename SmootherType, typename SolverType, typename Format>
+template <typename MatrixType>
+void smoothed_aggregation<IndexType,ValueType,MemorySpace,SmootherType,SolverType,Format>
+::update_values(const MatrixType& A)
+{
+    using thrust::system::detail::generic::select_system;
+
+    typedef typename MatrixType::memory_space System;
+
+    System system;
+
+    update_values(select_system(system), A);
+}
+
+template <typename IndexType, typename ValueType, typename MemorySpace, typename SmootherType, typename SolverType, typename Format>
+template <typename DerivedPolicy, typename MatrixType>
+void smoothed_aggregation<IndexType,ValueType,MemorySpace,SmootherType,SolverType,Format>
+::update_values(const thrust::detail::execution_policy_base<DerivedPolicy> &exec,
+                const MatrixType& A)
+{
+    typedef typename detail::select_sa_matrix_view<MatrixType>::type View;
+
+    if(A.num_rows != ML::num_rows || A.num_cols != ML::num_cols)
+        throw cusp::invalid_input_exception("matrix dimensions do not match the existing hierarchy");
+
+    // a hierarchy without coarse levels has nothing to reuse
+    if(sa_levels.size() < 2)
+    {
+        cusp::array1d<ValueType,MemorySpace> B(sa_levels[0].B);
+        initialize(exec, A, B);
+        return;
+    }
+
+    ML::clear_setup_times();
+
+    // recompute the operators of every level from the aggregates of the
+    // previous setup, the coarse matrices are rebuilt top down and the
+    // smoothers of the finished levels may be refreshed meanwhile
+    setup_task task;
+
+    {
+        View A_(A);
+        update_level(exec, A_, 0);
+        setup_level_task(0, A, task);
+    }
+
+    for( size_t lvl = 1; lvl + 1 < sa_levels.size(); lvl++ )
+    {
+        update_level(exec, sa_levels[lvl].A_, lvl);
+        setup_level_task(lvl, sa_levels[lvl].A_, task);
+    }
+
+    // Refactor coarse solver
+    const size_t coarsest = sa_levels.size() - 1;
+
+    ML::setup_level(coarsest, sa_levels[coarsest].A_, sa_levels[coarsest]);
+    ML::setup_coarse_solver();
+
+    finish_level_task(task);
+
+    ML::setup_host_levels();
+}
+
+template <typename IndexType, typename ValueType, typename MemorySpace, typename SmootherType, typename SolverType, typename Format>
+template <typename DerivedPolicy, typename MatrixType>
+void smoothed_aggregation<IndexType,ValueType,MemorySpace,SmootherType,SolverType,Format>
+::update_level(const thrust::detail::execution_policy_base<DerivedPolicy> &exec,
+               const MatrixType& A,
+               const size_t lvl)
+{
+    cusp::detail::profile_range range("cusp::smoothed_aggregation level", lvl);
+
+    SetupMatrixType P;
+    cusp::detail::timer t("amg spectral radius");
+
+    // the new values change the spectral radius only slightly, so the
+    // estimate starts from the Ritz vector of the previous setup
+    sa_levels[lvl].rho_DinvA = cusp::eigen::estimate_rho_Dinv_A(A, sa_levels[lvl].rho_x);
+    ML::add_setup_time("spectral radius", t.seconds_elapsed(), lvl);
+
+    // the tentative prolongator only depends on the aggregates and the
+    // near nullspace candidates, so only the smoothing step is repeated
+    t.restart("amg smooth prolongator");
+    smooth_prolongator(exec, A, sa_levels[lvl].T, P, sa_levels[lvl].rho_DinvA);
+    ML::add_setup_time("smooth prolongator", t.seconds_elapsed(), lvl);
+
+    if(prolongator_theta > 0 || prolongator_max_entries > 0)
+    {
+        t.restart("amg truncation");
+        truncate_prolongator(exec, P, P, prolongator_theta, prolongator_max_entries);
+        ML::add_setup_time("truncation", t.seconds_elapsed(), lvl);
+    }
+
+    // compute restriction operator (transpose of prolongator)
+    t.restart("amg restriction");
+    SetupMatrixType R;
+    form_restriction(exec, P, R);
+    ML::add_setup_time("restriction", t.seconds_elapsed(), lvl);
+
+    // recompute the values of the Galerkin product R*A*P in the storage
+    // of the coarse matrix
+    t.restart("amg galerkin product");
+    SetupMatrixType& RAP = sa_levels[lvl + 1].A_;
+    reclaim_matrix(RAP, ML::levels[lvl + 1].A);
+    form_coarse_operator(exec, R, A, P, RAP, sa_levels[lvl]);
+    ML::add_setup_time("galerkin product", t.seconds_elapsed(), lvl);
+
+    if(operator_theta > 0 || operator_max_entries > 0)
+    {
+        t.restart("amg truncation");
+        truncate_operator(exec, RAP, RAP, operator_theta, operator_max_entries);
+        ML::add_setup_time("truncation", t.seconds_elapsed(), lvl);
+    }
+
+    ML::copy_or_swap_matrix(ML::levels[lvl].R, R);
+    ML::copy_or_swap_matrix(ML::levels[lvl].P, P);
+}
+
+template <typename IndexType, typename ValueType, typename MemorySpace, typename SmootherType, typename SolverType, typename Format>
+template <typename DerivedPolicy, typename MatrixType>
+void smoothed_aggregation<IndexType,ValueType,MemorySpace,SmootherType,SolverType,Format>
+::form_coarse_operator(const thrust::detail::execution_policy_base<DerivedPolicy> &exec,
+                       const SetupMatrixType& R,
+                       const MatrixType& A,
+                       const SetupMatrixType& P,
+                       SetupMatrixType& RAP,
+                       sa_level<SetupMatrixType>& L)
+{
+    // a truncated operator has no fixed pattern to fill
+    if(operator_theta > 0 || operator_max_entries > 0)
+    {
+        galerkin_product(exec, R, A, P, RAP);
+        return;
+    }
+
+    // the plans of the previous setup stay valid while R, A, P and the
+    // products keep their patterns. A truncated prolongator may change its
+    // pattern with the values, the product of the unaggregated case may drop
+    // entries which cancel and hierarchies copied from another memory space
+    // have no plans, in all of these cases the structure is recomputed.
+    const bool planned = L.RA_plan.A_num_entries  == R.num_entries &&
+                         L.RA_plan.B_num_entries  == A.num_entries &&
+                         L.RA_plan.C_num_entries  == L.RA.num_entries &&
+                         L.RAP_plan.A_num_entries == L.RA.num_entries &&
+                         L.RAP_plan.B_num_entries == P.num_entries &&
+                         L.RAP_plan.C_num_entries == RAP.num_entries &&
+                         prolongator_theta == 0 && prolongator_max_entries == 0;
+
+    if(!planned)
+    {
+        cusp::spgemm_symbolic(exec, R, A, L.RA, L.RA_plan);
+        cusp::spgemm_symbolic(exec, L.RA, P, RAP, L.RAP_plan);
+    }
+
+    cusp::spgemm_numeric(exec, R, A, L.RA, L.RA_plan);
+    cusp::spgemm_numeric(exec, L.RA, P, RAP, L.RAP_plan);
+}
+
+template <typename IndexType, typename ValueType, typename MemorySpace, typename SmootherType, typename SolverType, typename Format>
+template <typename MatrixType>
+void smoothed_aggregation<IndexType,ValueType,MemorySpace,SmootherType,SolverType,Format>
+::setup_level_task(const size_t lvl, const MatrixType& A, setup_task& task)
+{
+    // one level at a time, exceptions of the previous one are rethrown
+    finish_level_task(task);
+
+#if __cplusplus >= 201103L
+    if(overlap_setup)
+    {
+        // the task takes the level and the coarse matrix out of the
+        // hierarchy, which keeps growing while it runs
+        task.lvl = lvl;
+        task.L.num_iters = sa_levels[lvl].num_iters;
+        task.L.rho_DinvA = sa_levels[lvl].rho_DinvA;
+
+        ML::swap_level(lvl, task.level);
+
+        if(lvl > 0)
+            task.L.A_.swap(sa_levels[lvl].A_);
+
+        // the task reads the matrix formed by the calling thread
+        task.ready.record();
+
+        const MatrixType * A_ptr = &A;
+
+        task.future = detail::launch_setup_task([this, &task, A_ptr]()
+        {
+            task.ready.wait();
+
+            if(task.lvl == 0)
+                this->setup_level(task.level, 0, *A_ptr, task.L);
+            else
+                this->setup_level(task.level, task.lvl, task.L.A_, task.L);
+
+            task.done.record();
+        });
+
+        return;
+    }
+#endif
+
+    ML::setup_level(lvl, A, sa_levels[lvl]);
+}
+
+template <typename IndexType, typename ValueType, typename MemorySpace, typename SmootherType, typename SolverType, typename Format>
+void smoothed_aggregation<IndexType,ValueType,MemorySpace,SmootherType,SolverType,Format>
+::finish_level_task(setup_task& task)
+{
+#if __cplusplus >= 201103L
+    if(!task.future.valid())
+        return;
+
+    task.future.get();
+
+    // later work of the calling thread may use the level
+    task.done.wait();
+
+    ML::swap_level(task.lvl, task.level);
+
+    if(task.lvl > 0)
+        sa_levels[task.lvl].A_.swap(task.L.A_);
+#endif
 }
 
 template <typename IndexType, typename ValueType, typename MemorySpace, typename SmootherType, typename SolverType, typename Format>
@@ -136,33 +433,79 @@ void smoothed_aggregation<IndexType,ValueType,MemorySpace,SmootherType,SolverTyp
 {
     typedef typename ML::level Level;
 
+    // the phases are attributed to the level being coarsened
+    const size_t lvl = sa_levels.size() - 1;
+
+    cusp::detail::profile_range range("cusp::smoothed_aggregation level", lvl);
+    cusp::detail::timer t("amg strength");
+
     {
         // compute stength of connection matrix
         SetupMatrixType C;
         strength_of_connection(exec, A, C, sa_levels.back());
+        ML::add_setup_time("strength", t.seconds_elapsed(), lvl);
 
         // compute aggregates
+        t.restart("amg aggregation");
         sa_levels.back().aggregates.resize(A.num_rows, IndexType(0));
         sa_levels.back().roots.resize(A.num_rows);
-        aggregate(exec, C, sa_levels.back().aggregates, sa_levels.back().roots);
+
+        if(lvl < aggressive_levels)
+            aggressive_aggregate(exec, C, sa_levels.back().aggregates, sa_levels.back().roots);
+        else
+            aggregate(exec, C, sa_levels.back().aggregates, sa_levels.back().roots);
+
+        if(min_aggregate_size > 1 || max_aggregate_size > 0)
+            bound_aggregates(exec, C, sa_levels.back().aggregates, sa_levels.back().roots,
+                             min_aggregate_size, max_aggregate_size);
+
+        ML::add_setup_time("aggregation", t.seconds_elapsed(), lvl);
     }
 
     SetupMatrixType P;
     cusp::array1d<ValueType, MemorySpace> B_coarse;
 
     // compute tenative prolongator and coarse nullspace vector
+    t.restart("amg tentative prolongator");
     fit_candidates(exec, sa_levels.back().aggregates, sa_levels.back().B, sa_levels.back().T, B_coarse);
+    ML::add_setup_time("tentative prolongator", t.seconds_elapsed(), lvl);
+
+    // the estimate is cached on the level, where the smoother and later
+    // calls to update_values reuse it
+    t.restart("amg spectral radius");
+    sa_levels.back().rho_DinvA = cusp::eigen::estimate_rho_Dinv_A(A, sa_levels.back().rho_x);
+    ML::add_setup_time("spectral radius", t.seconds_elapsed(), lvl);
 
     // compute prolongation operator
+    t.restart("amg smooth prolongator");
     smooth_prolongator(exec, A, sa_levels.back().T, P, sa_levels.back().rho_DinvA);  // TODO if C != A then compute rho_Dinv_C
+    ML::add_setup_time("smooth prolongator", t.seconds_elapsed(), lvl);
+
+    if(prolongator_theta > 0 || prolongator_max_entries > 0)
+    {
+        t.restart("amg truncation");
+        truncate_prolongator(exec, P, P, prolongator_theta, prolongator_max_entries);
+        ML::add_setup_time("truncation", t.seconds_elapsed(), lvl);
+    }
 
     // compute restriction operator (transpose of prolongator)
+    t.restart("amg restriction");
     SetupMatrixType R;
     form_restriction(exec, P, R);
+    ML::add_setup_time("restriction", t.seconds_elapsed(), lvl);
 
     // construct Galerkin product R*A*P
+    t.restart("amg galerkin product");
     SetupMatrixType RAP;
-    galerkin_product(exec, R, A, P, RAP);
+    form_coarse_operator(exec, R, A, P, RAP, sa_levels.back());
+    ML::add_setup_time("galerkin product", t.seconds_elapsed(), lvl);
+
+    if(operator_theta > 0 || operator_max_entries > 0)
+    {
+        t.restart("amg truncation");
+        truncate_operator(exec, RAP, RAP, operator_theta, operator_max_entries);
+        ML::add_setup_time("truncation", t.seconds_elapsed(), lvl);
+    }
 
     // Setup components for next level in hierarchy
     sa_levels.push_back(sa_level<SetupMatrixType>());
@@ -175,6 +518,152 @@ void smoothed_aggregation<IndexType,ValueType,MemorySpace,SmootherType,SolverTyp
     ML::levels.push_back(Level());
 }
 
+template <typename IndexType, typename ValueType, typename MemorySpace, typename SmootherType, typename SolverType, typename Format>
+void smoothed_aggregation<IndexType,ValueType,MemorySpace,SmootherType,SolverType,Format>
+::write_binary_file(const std::string& filename) const
+{
+    std::ofstream file(filename.c_str(), std::ios::binary);
+
+    if (!file)
+        throw cusp::io_exception(std::string("unable to open file \"") + filename + std::string("\" for writing"));
+
+    write_binary_stream(file);
+}
+
+template <typename IndexType, typename ValueType, typename MemorySpace, typename SmootherType, typename SolverType, typename Format>
+template <typename Stream>
+void smoothed_aggregation<IndexType,ValueType,MemorySpace,SmootherType,SolverType,Format>
+::write_binary_stream(Stream& output) const
+{
+    const size_t num_levels = sa_levels.size();
+
+    if(num_levels == 0)
+        throw cusp::invalid_input_exception("smoothed_aggregation hierarchy has not been initialized");
+
+    output.write(detail::sa_binary_tag, sizeof(detail::sa_binary_tag));
+    detail::write_binary_value(sizeof(IndexType), output);
+    detail::write_binary_value(sizeof(ValueType), output);
+    detail::write_binary_value(num_levels, output);
+    detail::write_binary_value(ML::num_rows, output);
+    detail::write_binary_value(ML::num_cols, output);
+
+    for( size_t lvl = 0; lvl < num_levels; lvl++ )
+    {
+        const sa_level<SetupMatrixType>& L = sa_levels[lvl];
+        double rho_DinvA = L.rho_DinvA;
+
+        // store the estimate so reloaded smoothers skip it
+        if(rho_DinvA == 0.0 && lvl + 1 < num_levels)
+            rho_DinvA = lvl == 0 ? cusp::eigen::estimate_rho_Dinv_A(*ML::A_ptr)
+                                 : cusp::eigen::estimate_rho_Dinv_A(ML::levels[lvl].A);
+
+        detail::write_binary_value(L.num_iters, output);
+        detail::write_binary_value(rho_DinvA, output);
+
+        cusp::io::write_binary_stream(L.aggregates, output);
+        cusp::io::write_binary_stream(L.roots, output);
+        cusp::io::write_binary_stream(L.B, output);
+
+        if(lvl + 1 < num_levels)
+        {
+            cusp::io::write_binary_stream(L.T, output);
+            cusp::io::write_binary_stream(ML::levels[lvl].R, output);
+            cusp::io::write_binary_stream(ML::levels[lvl].P, output);
+        }
+
+        if(lvl > 0)
+            cusp::io::write_binary_stream(ML::levels[lvl].A, output);
+    }
+}
+
+template <typename IndexType, typename ValueType, typename MemorySpace, typename SmootherType, typename SolverType, typename Format>
+template <typename MatrixType>
+void smoothed_aggregation<IndexType,ValueType,MemorySpace,SmootherType,SolverType,Format>
+::read_binary_file(const MatrixType& A, const std::string& filename)
+{
+    std::ifstream file(filename.c_str(), std::ios::binary);
+
+    if (!file)
+        throw cusp::io_exception(std::string("unable to open file \"") + filename + std::string("\" for reading"));
+
+    read_binary_stream(A, file);
+}
+
+template <typename IndexType, typename ValueType, typename MemorySpace, typename SmootherType, typename SolverType, typename Format>
+template <typename MatrixType, typename Stream>
+void smoothed_aggregation<IndexType,ValueType,MemorySpace,SmootherType,SolverType,Format>
+::read_binary_stream(const MatrixType& A, Stream& input)
+{
+    typedef typename ML::level Level;
+
+    char tag[sizeof(detail::sa_binary_tag)];
+    size_t index_size, value_size, num_levels, num_rows, num_cols;
+
+    input.read(tag, sizeof(tag));
+    detail::read_binary_value(index_size, input);
+    detail::read_binary_value(value_size, input);
+    detail::read_binary_value(num_levels, input);
+    detail::read_binary_value(num_rows, input);
+    detail::read_binary_value(num_cols, input);
+
+    if(!input || std::memcmp(tag, detail::sa_binary_tag, sizeof(tag)) != 0 || num_levels == 0)
+        throw cusp::io_exception("invalid smoothed_aggregation hierarchy");
+
+    if(index_size != sizeof(IndexType) || value_size != sizeof(ValueType))
+        throw cusp::io_exception("smoothed_aggregation hierarchy was written with different index or value types");
+
+    if(num_rows != A.num_rows || num_cols != A.num_cols)
+        throw cusp::invalid_input_exception("matrix dimensions do not match the stored hierarchy");
+
+    sa_levels.resize(0);
+    ML::levels.resize(0);
+
+    ML::clear_setup_times();
+    ML::resize(A.num_rows, A.num_cols, A.num_entries);
+    ML::levels.reserve(std::max(ML::max_levels, num_levels)); // avoid reallocations which force matrix copies
+    sa_levels.reserve(num_levels);
+
+    for( size_t lvl = 0; lvl < num_levels; lvl++ )
+    {
+        ML::levels.push_back(Level());
+        sa_levels.push_back(sa_level<SetupMatrixType>());
+
+        sa_level<SetupMatrixType>& L = sa_levels.back();
+        double rho_DinvA;
+
+        detail::read_binary_value(L.num_iters, input);
+        detail::read_binary_value(rho_DinvA, input);
+        L.rho_DinvA = rho_DinvA;
+
+        cusp::io::read_binary_stream(L.aggregates, input);
+        cusp::io::read_binary_stream(L.roots, input);
+        cusp::io::read_binary_stream(L.B, input);
+
+        if(lvl + 1 < num_levels)
+        {
+            cusp::io::read_binary_stream(L.T, input);
+            cusp::io::read_binary_stream(ML::levels[lvl].R, input);
+            cusp::io::read_binary_stream(ML::levels[lvl].P, input);
+        }
+
+        if(lvl > 0)
+            cusp::io::read_binary_stream(L.A_, input);
+
+        if(!input)
+            throw cusp::io_exception("truncated smoothed_aggregation hierarchy");
+    }
+
+    // Setup multilevel arrays, matrices and smoothers on each level
+    if(num_levels > 1)
+        ML::setup_level(0, A, sa_levels[0]);
+
+    for( size_t lvl = 1; lvl < num_levels; lvl++ )
+        ML::setup_level(lvl, sa_levels[lvl].A_, sa_levels[lvl]);
+
+    // Initialize coarse solver
+    ML::initialize_coarse_solver();
+}
+
 } // end namespace aggregation
 } // end namespace precond
 } // end namespace cusp
@@ -0,0 +1,96 @@
+/*
+ *  Copyright 2008-2014 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include <cusp/detail/config.h>
+
+#include <cusp/precond/aggregation/system/detail/generic/truncate.h>
+
+namespace cusp
+{
+namespace precond
+{
+namespace aggregation
+{
+
+template <typename DerivedPolicy,
+          typename MatrixType1,
+          typename MatrixType2>
+void truncate_prolongator(const thrust::detail::execution_policy_base<DerivedPolicy> &exec,
+                          const MatrixType1& P,
+                                MatrixType2& P_truncated,
+                          const double theta,
+                          const size_t max_entries)
+{
+    using cusp::precond::aggregation::detail::truncate;
+
+    truncate(thrust::detail::derived_cast(thrust::detail::strip_const(exec)),
+             P, P_truncated, theta, max_entries, false);
+}
+
+template <typename MatrixType1,
+          typename MatrixType2>
+void truncate_prolongator(const MatrixType1& P,
+                                MatrixType2& P_truncated,
+                          const double theta,
+                          const size_t max_entries)
+{
+    using thrust::system::detail::generic::select_system;
+
+    typedef typename MatrixType1::memory_space System1;
+    typedef typename MatrixType2::memory_space System2;
+
+    System1 system1;
+    System2 system2;
+
+    cusp::precond::aggregation::truncate_prolongator(select_system(system1,system2), P, P_truncated, theta, max_entries);
+}
+
+template <typename DerivedPolicy,
+          typename MatrixType1,
+          typename MatrixType2>
+void truncate_operator(const thrust::detail::execution_policy_base<DerivedPolicy> &exec,
+                       const MatrixType1& A,
+                             MatrixType2& A_truncated,
+                       const double theta,
+                       const size_t max_entries)
+{
+    using cusp::precond::aggregation::detail::truncate;
+
+    truncate(thrust::detail::derived_cast(thrust::detail::strip_const(exec)),
+             A, A_truncated, theta, max_entries, true);
+}
+
+template <typename MatrixType1,
+          typename MatrixType2>
+void truncate_operator(const MatrixType1& A,
+                             MatrixType2& A_truncated,
+                       const double theta,
+                       const size_t max_entries)
+{
+    using thrust::system::detail::generic::select_system;
+
+    typedef typename MatrixType1::memory_space System1;
+    typedef typename MatrixType2::memory_space System2;
+
+    System1 system1;
+    System2 system2;
+
+    cusp::precond::aggregation::truncate_operator(select_system(system1,system2), A, A_truncated, theta, max_entries);
+}
+
+} // end namespace aggregation
+} // end namespace precond
+} // end namespace cusp
@@ -27,12 +27,21 @@
 
 #include <cusp/array1d.h>
 #include <cusp/complex.h>
+#include <cusp/multiply.h>
 #include <cusp/precond/aggregation/detail/sa_view_traits.h>
 
 #include <thrust/detail/use_default.h>
 
+#include <string>
 #include <vector> // TODO replace with host_vector
 
+#if __cplusplus >= 201103L
+#include <future>
+#if THRUST_DEVICE_SYSTEM == THRUST_DEVICE_SYSTEM_CUDA
+#include <cuda_runtime_api.h>
+#endif
+#endif
+
 namespace cusp
 {
 namespace precond
@@ -40,6 +49,57 @@ namespace precond
 namespace aggregation
 {
 
+/* \cond */
+namespace detail
+{
+
+#if __cplusplus >= 201103L
+// orders the device work of the calling thread and of the setup thread.
+// Every setup routine runs on the default stream of its thread, which is
+// only concurrent with the other thread's under --default-stream per-thread
+class setup_event
+{
+#if THRUST_DEVICE_SYSTEM == THRUST_DEVICE_SYSTEM_CUDA
+    cudaEvent_t event;
+
+    static cudaStream_t stream(void)
+    {
+#ifdef CUDA_API_PER_THREAD_DEFAULT_STREAM
+        return cudaStreamPerThread;
+#else
+        return cudaStreamLegacy;
+#endif
+    }
+
+  public:
+
+    setup_event(void)  { cudaEventCreateWithFlags(&event, cudaEventDisableTiming); }
+    ~setup_event(void) { cudaEventDestroy(event); }
+
+    // marks the work issued so far by the calling thread
+    void record(void) { cudaEventRecord(event, stream()); }
+
+    // work issued later by the calling thread waits for the recorded work
+    void wait(void)   { cudaStreamWaitEvent(stream(), event, 0); }
+#else
+  public:
+
+    setup_event(void) {}
+
+    void record(void) {}
+    void wait(void)   {}
+#endif
+
+  private:
+
+    setup_event(const setup_event&);
+    setup_event& operator=(const setup_event&);
+};
+#endif
+
+} // end namespace detail
+/* \endcond */
+
 /* \cond */
 template<typename MatrixType>
 struct sa_level
@@ -56,6 +116,10 @@ struct sa_level
     cusp::array1d<IndexType,MemorySpace> aggregates;      // aggregates
     cusp::array1d<IndexType,MemorySpace> roots;           // aggregates
     cusp::array1d<ValueType,MemorySpace> B;               // near-nullspace candidates
+    cusp::array1d<ValueType,MemorySpace> rho_x;           // Ritz vector of rho_DinvA
+    MatrixType RA;                                        // R * A of the Galerkin product
+    cusp::spgemm_plan<IndexType,MemorySpace> RA_plan;     // structure of R * A
+    cusp::spgemm_plan<IndexType,MemorySpace> RAP_plan;    // structure of (R * A) * P
 
     size_t   num_iters;
     NormType rho_DinvA;
@@ -65,8 +129,11 @@ struct sa_level
     template<typename SALevelType>
     sa_level(const SALevelType& L)
       : A_(L.A_),
+        T(L.T),
         aggregates(L.aggregates),
+        roots(L.roots),
         B(L.B),
+        rho_x(L.rho_x),
         num_iters(L.num_iters),
         rho_DinvA(L.rho_DinvA)
     {}
@@ -98,6 +165,11 @@ struct sa_level
  *  on each level of hierarchy and LU to solve the coarse matrix in host
  *  memory.
  *
+ *  When compiled as C++11 and \p overlap_setup is enabled, the smoother
+ *  of every level is set up on a second host thread while the next level
+ *  is coarsened, and the coarse solver is factored while the last
+ *  smoother is set up.
+ *
  *  \par Example
  *  The following code snippet demonstrates how to use a
  *  \p smoothed_aggregation preconditioner to solve a linear system.
@@ -172,10 +244,47 @@ class smoothed_aggregation :
     std::vector< sa_level<SetupMatrixType> > sa_levels;
     /* \endcond */
 
+    /*! Truncation of the smoothed prolongators and of the coarse operators,
+     *  applied on every level right after they are formed. Entries smaller
+     *  than theta times the largest entry of their row are dropped and at
+     *  most max_entries entries are kept per row, zero disables either
+     *  criterion. Both are disabled by default and take effect on the
+     *  next \p initialize or \p update_values.
+     */
+    double prolongator_theta;
+    size_t prolongator_max_entries;
+    double operator_theta;
+    size_t operator_max_entries;
+
+    /*! Bounds on the number of nodes per aggregate, enforced after every
+     *  aggregation by merging small and splitting large aggregates (see
+     *  \p bound_aggregates), and the number of finest levels aggregated
+     *  with \p aggressive_aggregate. Large aggregates make the rows of the
+     *  prolongator dense, small ones leave large coarse levels, both raise
+     *  the operator complexity. Zero disables each option, which take
+     *  effect on the next \p initialize.
+     */
+    size_t min_aggregate_size;
+    size_t max_aggregate_size;
+    size_t aggressive_levels;
+
+    /*! Set up the smoother of every level on a second host thread while
+     *  the next level is formed by \p initialize and \p update_values.
+     *  Requires C++11 and is disabled by default. The device work of both
+     *  threads only overlaps when compiled with nvcc --default-stream
+     *  per-thread, otherwise only their host work does.
+     */
+    bool overlap_setup;
+
     /**
      * Construct an empty \p smoothed_aggregation preconditioner.
      */
-    smoothed_aggregation(void) : ML() {};
+    smoothed_aggregation(void)
+      : ML(),
+        prolongator_theta(0), prolongator_max_entries(0),
+        operator_theta(0), operator_max_entries(0),
+        min_aggregate_size(0), max_aggregate_size(0), aggressive_levels(0),
+        overlap_setup(false) {};
 
     /*! Construct a \p smoothed_aggregation preconditioner from a matrix.
      *
@@ -237,6 +346,66 @@ class smoothed_aggregation :
                     const ArrayType&  B);
     /* \endcond */
 
+    /*! Update a \p smoothed_aggregation preconditioner after the values of
+     * the matrix changed while its sparsity pattern did not.
+     * The aggregates and tentative prolongators of the existing hierarchy
+     * are reused, only the prolongator smoothing, the smoothers and the
+     * coarse solver are recomputed. The Galerkin products reuse the
+     * \p spgemm_plan of every level and only recompute their values, unless
+     * the coarse operators are truncated, whose patterns depend on their
+     * values.
+     *
+     *  \param A matrix with the same sparsity pattern as the matrix used
+     *  to create the AMG hierarchy.
+     */
+    template <typename MatrixType>
+    void update_values(const MatrixType& A);
+
+    /* \cond */
+    template <typename DerivedPolicy,
+              typename MatrixType>
+    void update_values(const thrust::detail::execution_policy_base<DerivedPolicy> &exec,
+                       const MatrixType& A);
+    /* \endcond */
+
+    /*! Write the hierarchy of a \p smoothed_aggregation preconditioner to
+     * a binary file. The file holds the aggregates, near nullspace vectors,
+     * tentative prolongators, the R, P and coarse A of every level and the
+     * spectral radius estimates used by the smoothers, but not the finest
+     * level matrix.
+     *
+     *  \param filename file name of the binary file
+     */
+    void write_binary_file(const std::string& filename) const;
+
+    /*! Write the hierarchy of a \p smoothed_aggregation preconditioner to
+     * a stream.
+     *
+     *  \param output stream to which the binary contents will be written
+     */
+    template <typename Stream>
+    void write_binary_stream(Stream& output) const;
+
+    /*! Rebuild a \p smoothed_aggregation preconditioner from a hierarchy
+     * written by \p write_binary_file without repeating the setup. Only the
+     * smoothers and the coarse solver are initialized, the stored spectral
+     * radius estimates are reused.
+     *
+     *  \param A finest level matrix the hierarchy was created from.
+     *  \param filename file name of the binary file
+     */
+    template <typename MatrixType>
+    void read_binary_file(const MatrixType& A, const std::string& filename);
+
+    /*! Rebuild a \p smoothed_aggregation preconditioner from a hierarchy
+     * read from a stream.
+     *
+     *  \param A finest level matrix the hierarchy was created from.
+     *  \param input stream from which to read the binary contents
+     */
+    template <typename MatrixType, typename Stream>
+    void read_binary_stream(const MatrixType& A, Stream& input);
+
 protected:
 
     /* \cond */
@@ -244,6 +413,53 @@ protected:
               typename MatrixType>
     void extend_hierarchy(const thrust::detail::execution_policy_base<DerivedPolicy> &exec,
                           const MatrixType& A);
+
+    template <typename DerivedPolicy,
+              typename MatrixType>
+    void update_level(const thrust::detail::execution_policy_base<DerivedPolicy> &exec,
+                      const MatrixType& A,
+                      const size_t lvl);
+
+    template <typename DerivedPolicy,
+              typename MatrixType>
+    void form_coarse_operator(const thrust::detail::execution_policy_base<DerivedPolicy> &exec,
+                              const SetupMatrixType& R,
+                              const MatrixType& A,
+                              const SetupMatrixType& P,
+                              SetupMatrixType& RAP,
+                              sa_level<SetupMatrixType>& L);
+
+    // setup_level swaps a coarse matrix into the solve levels when both use
+    // the same type, update_level takes its storage back
+    void reclaim_matrix(SetupMatrixType& dst, SetupMatrixType& src) { dst.swap(src); }
+
+    template <typename MatrixType>
+    void reclaim_matrix(SetupMatrixType& dst, MatrixType& src) {}
+
+    // smoother setup of a level that runs while the next level is formed.
+    // The task owns the level and its matrix until finish_level_task moves
+    // them back into the hierarchy, it never runs without C++11
+    struct setup_task
+    {
+        size_t                    lvl;
+        typename ML::level        level;
+        sa_level<SetupMatrixType> L;
+#if __cplusplus >= 201103L
+        detail::setup_event       ready;
+        detail::setup_event       done;
+
+        // declared last, its destructor waits for the thread to finish
+        // before the state above is destroyed
+        std::future<void>         future;
+#endif
+
+        setup_task(void) : lvl(0) {}
+    };
+
+    template <typename MatrixType>
+    void setup_level_task(const size_t lvl, const MatrixType& A, setup_task& task);
+
+    void finish_level_task(setup_task& task);
     /* \endcond */
 };
 /*! \}
@@ -0,0 +1,496 @@
+/*
+ *  Copyright 2008-2014 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#pragma once
+
+#include <cusp/detail/config.h>
+#include <cusp/detail/temporary_array.h>
+
+#include <cusp/detail/type_traits.h>
+
+#include <cusp/array1d.h>
+#include <cusp/coo_matrix.h>
+#include <cusp/format_utils.h>
+#include <cusp/sort.h>
+
+#include <thrust/copy.h>
+#include <thrust/equal.h>
+#include <thrust/fill.h>
+#include <thrust/functional.h>
+#include <thrust/gather.h>
+#include <thrust/reduce.h>
+#include <thrust/scan.h>
+#include <thrust/scatter.h>
+#include <thrust/sequence.h>
+#include <thrust/transform.h>
+#include <thrust/unique.h>
+#include <thrust/iterator/counting_iterator.h>
+#include <thrust/iterator/discard_iterator.h>
+#include <thrust/iterator/permutation_iterator.h>
+#include <thrust/iterator/zip_iterator.h>
+
+namespace cusp
+{
+namespace precond
+{
+namespace aggregation
+{
+namespace detail
+{
+namespace bounded
+{
+
+typedef unsigned long long KeyType;
+
+const KeyType NO_TARGET = ~KeyType(0);
+
+// the aggregate the members of a small aggregate join: merges staying
+// within max_size first, then the smallest neighbor. small aggregates only
+// join small aggregates with a larger index, so the merges form no cycles
+template <typename IndexType>
+struct merge_candidate_functor
+{
+    const IndexType * row_offsets;
+    const IndexType * column_indices;
+    const IndexType * aggregates;
+    const IndexType * sizes;
+    IndexType min_size;
+    IndexType max_size;
+
+    merge_candidate_functor(const IndexType * row_offsets, const IndexType * column_indices,
+                            const IndexType * aggregates, const IndexType * sizes,
+                            const IndexType min_size, const IndexType max_size)
+        : row_offsets(row_offsets), column_indices(column_indices),
+          aggregates(aggregates), sizes(sizes), min_size(min_size), max_size(max_size) {}
+
+    __host__ __device__
+    KeyType operator()(const IndexType i) const
+    {
+        const IndexType a = aggregates[i];
+
+        KeyType best = NO_TARGET;
+
+        if(sizes[a] >= min_size)
+            return best;
+
+        for(IndexType jj = row_offsets[i]; jj < row_offsets[i + 1]; jj++)
+        {
+            const IndexType t = aggregates[column_indices[jj]];
+
+            if(t == a || (sizes[t] < min_size && t < a))
+                continue;
+
+            const bool exceeds = max_size > 0 && sizes[a] + sizes[t] > max_size;
+            const KeyType key  = (KeyType(exceeds) << 63) | (KeyType(sizes[t]) << 32) | KeyType(t);
+
+            if(key < best)
+                best = key;
+        }
+
+        return best;
+    }
+};
+
+template <typename IndexType>
+struct merge_target_functor
+{
+    __host__ __device__
+    IndexType operator()(const KeyType key, const IndexType a) const
+    {
+        return key == NO_TARGET ? a : IndexType(key & 0xffffffffULL);
+    }
+};
+
+template <typename IndexType>
+struct is_unmerged_functor
+{
+    __host__ __device__
+    IndexType operator()(const IndexType target, const IndexType a) const
+    {
+        return target == a ? 1 : 0;
+    }
+};
+
+template <typename IndexType>
+struct num_pieces_functor
+{
+    IndexType max_size;
+
+    num_pieces_functor(const IndexType max_size) : max_size(max_size) {}
+
+    __host__ __device__
+    IndexType operator()(const IndexType size) const
+    {
+        return (size + max_size - 1) / max_size;
+    }
+};
+
+// aggregate of the member at position p of the members sorted by aggregate,
+// large aggregates are cut into pieces of balanced size
+template <typename IndexType>
+struct split_functor
+{
+    const IndexType * sorted_aggregates;
+    const IndexType * offsets;
+    const IndexType * piece_offsets;
+    IndexType max_size;
+
+    split_functor(const IndexType * sorted_aggregates, const IndexType * offsets,
+                  const IndexType * piece_offsets, const IndexType max_size)
+        : sorted_aggregates(sorted_aggregates), offsets(offsets),
+          piece_offsets(piece_offsets), max_size(max_size) {}
+
+    __host__ __device__
+    IndexType operator()(const IndexType p) const
+    {
+        const IndexType a      = sorted_aggregates[p];
+        const IndexType size   = offsets[a + 1] - offsets[a];
+        const IndexType pieces = (size + max_size - 1) / max_size;
+        const IndexType rank   = p - offsets[a];
+
+        return piece_offsets[a] + IndexType((long long) rank * pieces / size);
+    }
+};
+
+// the previous root of an aggregate is preferred over its other members
+template <typename IndexType>
+struct root_key_functor
+{
+    const IndexType * old_aggregates;
+    const IndexType * old_roots;
+
+    root_key_functor(const IndexType * old_aggregates, const IndexType * old_roots)
+        : old_aggregates(old_aggregates), old_roots(old_roots) {}
+
+    __host__ __device__
+    KeyType operator()(const IndexType i) const
+    {
+        const bool is_root = old_roots[old_aggregates[i]] == i;
+
+        return (KeyType(is_root ? 0 : 1) << 32) | KeyType(i);
+    }
+};
+
+template <typename IndexType>
+struct root_index_functor
+{
+    __host__ __device__
+    IndexType operator()(const KeyType key) const
+    {
+        return IndexType(key & 0xffffffffULL);
+    }
+};
+
+// members of every aggregate in increasing order and the offsets and sizes
+// of the aggregates in that order
+template <typename DerivedPolicy, typename ArrayType, typename IndexArray>
+void group_members(thrust::execution_policy<DerivedPolicy> &exec,
+                   const ArrayType& aggregates,
+                   const size_t num_aggregates,
+                   IndexArray& sorted_aggregates,
+                   IndexArray& sorted_members,
+                   IndexArray& offsets,
+                   IndexArray& sizes)
+{
+    typedef typename IndexArray::value_type IndexType;
+
+    thrust::copy(exec, aggregates.begin(), aggregates.end(), sorted_aggregates.begin());
+    thrust::sequence(exec, sorted_members.begin(), sorted_members.end());
+    cusp::counting_sort_by_key(exec, sorted_aggregates, sorted_members, IndexType(0), IndexType(num_aggregates - 1));
+
+    cusp::indices_to_offsets(exec, sorted_aggregates, offsets);
+    thrust::transform(exec, offsets.begin() + 1, offsets.end(), offsets.begin(), sizes.begin(), thrust::minus<IndexType>());
+}
+
+} // end namespace bounded
+
+template <typename DerivedPolicy,
+          typename ArrayType1,
+          typename ArrayType2,
+          typename ArrayType3,
+          typename ArrayType4>
+void bound_aggregates_csr(thrust::execution_policy<DerivedPolicy> &exec,
+                          const size_t num_rows,
+                          const ArrayType1& row_offsets,
+                          const ArrayType2& column_indices,
+                                ArrayType3& aggregates,
+                                ArrayType4& roots,
+                          const size_t min_size,
+                          const size_t max_size)
+{
+    using namespace bounded;
+
+    typedef typename ArrayType2::value_type                       IndexType;
+    typedef cusp::detail::temporary_array<IndexType, DerivedPolicy> IndexArray;
+    typedef thrust::counting_iterator<IndexType>                  CountingIterator;
+
+    const IndexType N = num_rows;
+
+    if(N == 0 || (min_size <= 1 && max_size == 0))
+        return;
+
+    CountingIterator first(0);
+
+    IndexArray old_aggregates(exec, aggregates);
+    IndexArray old_roots(exec, roots);
+
+    IndexArray sorted_aggregates(exec, N);
+    IndexArray sorted_members(exec, N);
+
+    size_t num_aggregates = thrust::reduce(exec, aggregates.begin(), aggregates.end(), IndexType(0), thrust::maximum<IndexType>()) + 1;
+
+    // small aggregates join an adjacent aggregate, repeated since a group
+    // of merged small aggregates may still be small
+    while(min_size > 1)
+    {
+        IndexArray offsets(exec, num_aggregates + 1);
+        IndexArray sizes(exec, num_aggregates);
+        group_members(exec, aggregates, num_aggregates, sorted_aggregates, sorted_members, offsets, sizes);
+
+        cusp::detail::temporary_array<KeyType, DerivedPolicy> member_keys(exec, N);
+        cusp::detail::temporary_array<KeyType, DerivedPolicy> aggregate_keys(exec, num_aggregates);
+
+        thrust::transform(exec, first, first + N, member_keys.begin(),
+                          merge_candidate_functor<IndexType>(thrust::raw_pointer_cast(&row_offsets[0]),
+                                                             thrust::raw_pointer_cast(&column_indices[0]),
+                                                             thrust::raw_pointer_cast(&aggregates[0]),
+                                                             thrust::raw_pointer_cast(&sizes[0]),
+                                                             IndexType(min_size), IndexType(max_size)));
+
+        // the best candidate among the members of every aggregate
+        thrust::reduce_by_key(exec,
+                              sorted_aggregates.begin(), sorted_aggregates.end(),
+                              thrust::make_permutation_iterator(member_keys.begin(), sorted_members.begin()),
+                              thrust::make_discard_iterator(),
+                              aggregate_keys.begin(),
+                              thrust::equal_to<IndexType>(),
+                              thrust::minimum<KeyType>());
+
+        IndexArray targets(exec, num_aggregates);
+        IndexArray next_targets(exec, num_aggregates);
+
+        thrust::transform(exec, aggregate_keys.begin(), aggregate_keys.end(), first, targets.begin(),
+                          merge_target_functor<IndexType>());
+
+        // follow chains of merged small aggregates to their final target
+        while(true)
+        {
+            thrust::gather(exec, targets.begin(), targets.end(), targets.begin(), next_targets.begin());
+
+            if(thrust::equal(exec, targets.begin(), targets.end(), next_targets.begin()))
+                break;
+
+            thrust::copy(exec, next_targets.begin(), next_targets.end(), targets.begin());
+        }
+
+        // enumerate the remaining aggregates
+        IndexArray ids(exec, num_aggregates);
+        thrust::transform(exec, targets.begin(), targets.end(), first, next_targets.begin(), is_unmerged_functor<IndexType>());
+        thrust::exclusive_scan(exec, next_targets.begin(), next_targets.end(), ids.begin());
+
+        const size_t num_merged = size_t(ids[num_aggregates - 1] + next_targets[num_aggregates - 1]);
+
+        if(num_merged == num_aggregates)
+            break;
+
+        num_aggregates = num_merged;
+
+        thrust::gather(exec, targets.begin(), targets.end(), ids.begin(), next_targets.begin());
+        thrust::copy(exec, aggregates.begin(), aggregates.end(), sorted_aggregates.begin());
+        thrust::gather(exec, sorted_aggregates.begin(), sorted_aggregates.end(), next_targets.begin(), aggregates.begin());
+    }
+
+    // large aggregates are cut into pieces of consecutive members
+    if(max_size > 0)
+    {
+        IndexArray offsets(exec, num_aggregates + 1);
+        IndexArray sizes(exec, num_aggregates);
+        group_members(exec, aggregates, num_aggregates, sorted_aggregates, sorted_members, offsets, sizes);
+
+        IndexArray piece_offsets(exec, num_aggregates);
+        thrust::transform(exec, sizes.begin(), sizes.end(), piece_offsets.begin(), num_pieces_functor<IndexType>(max_size));
+        thrust::exclusive_scan(exec, piece_offsets.begin(), piece_offsets.end(), piece_offsets.begin());
+
+        num_aggregates = size_t(piece_offsets[num_aggregates - 1]) + (size_t(sizes[num_aggregates - 1]) + max_size - 1) / max_size;
+
+        IndexArray pieces(exec, N);
+        thrust::transform(exec, first, first + N, pieces.begin(),
+                          split_functor<IndexType>(thrust::raw_pointer_cast(&sorted_aggregates[0]),
+                                                   thrust::raw_pointer_cast(&offsets[0]),
+                                                   thrust::raw_pointer_cast(&piece_offsets[0]),
+                                                   IndexType(max_size)));
+        thrust::scatter(exec, pieces.begin(), pieces.end(), sorted_members.begin(), aggregates.begin());
+    }
+
+    // the root of every aggregate is its previous root, or its first member
+    {
+        IndexArray offsets(exec, num_aggregates + 1);
+        IndexArray sizes(exec, num_aggregates);
+        group_members(exec, aggregates, num_aggregates, sorted_aggregates, sorted_members, offsets, sizes);
+
+        cusp::detail::temporary_array<KeyType, DerivedPolicy> member_keys(exec, N);
+        cusp::detail::temporary_array<KeyType, DerivedPolicy> aggregate_keys(exec, num_aggregates);
+
+        thrust::transform(exec, first, first + N, member_keys.begin(),
+                          root_key_functor<IndexType>(thrust::raw_pointer_cast(&old_aggregates[0]),
+                                                      thrust::raw_pointer_cast(&old_roots[0])));
+
+        thrust::reduce_by_key(exec,
+                              sorted_aggregates.begin(), sorted_aggregates.end(),
+                              thrust::make_permutation_iterator(member_keys.begin(), sorted_members.begin()),
+                              thrust::make_discard_iterator(),
+                              aggregate_keys.begin(),
+                              thrust::equal_to<IndexType>(),
+                              thrust::minimum<KeyType>());
+
+        thrust::transform(exec, aggregate_keys.begin(), aggregate_keys.end(), roots.begin(), root_index_functor<IndexType>());
+    }
+}
+
+template <typename DerivedPolicy,
+          typename MatrixType,
+          typename ArrayType1,
+          typename ArrayType2>
+void bound_aggregates(thrust::execution_policy<DerivedPolicy> &exec,
+                      const MatrixType& C,
+                            ArrayType1& aggregates,
+                            ArrayType2& roots,
+                      const size_t min_size,
+                      const size_t max_size,
+                      cusp::csr_format)
+{
+    bound_aggregates_csr(exec, C.num_rows, C.row_offsets, C.column_indices, aggregates, roots, min_size, max_size);
+}
+
+template <typename DerivedPolicy,
+          typename MatrixType,
+          typename ArrayType1,
+          typename ArrayType2>
+void bound_aggregates(thrust::execution_policy<DerivedPolicy> &exec,
+                      const MatrixType& C,
+                            ArrayType1& aggregates,
+                            ArrayType2& roots,
+                      const size_t min_size,
+                      const size_t max_size,
+                      cusp::coo_format)
+{
+    typedef typename MatrixType::index_type IndexType;
+
+    // compress the (sorted) row indices
+    cusp::detail::temporary_array<IndexType, DerivedPolicy> row_offsets(exec, C.num_rows + 1);
+    cusp::indices_to_offsets(exec, C.row_indices, row_offsets);
+
+    bound_aggregates_csr(exec, C.num_rows, row_offsets, C.column_indices, aggregates, roots, min_size, max_size);
+}
+
+template <typename DerivedPolicy,
+          typename MatrixType,
+          typename ArrayType1,
+          typename ArrayType2>
+void bound_aggregates(thrust::execution_policy<DerivedPolicy> &exec,
+                      const MatrixType& C,
+                            ArrayType1& aggregates,
+                            ArrayType2& roots,
+                      const size_t min_size,
+                      const size_t max_size,
+                      cusp::known_format)
+{
+    typedef typename cusp::detail::as_csr_type<MatrixType>::type CsrMatrix;
+
+    CsrMatrix C_csr(C);
+
+    bound_aggregates_csr(exec, C_csr.num_rows, C_csr.row_offsets, C_csr.column_indices, aggregates, roots, min_size, max_size);
+}
+
+template <typename DerivedPolicy,
+          typename MatrixType,
+          typename ArrayType1,
+          typename ArrayType2>
+void bound_aggregates(thrust::execution_policy<DerivedPolicy> &exec,
+                      const MatrixType& C,
+                            ArrayType1& aggregates,
+                            ArrayType2& roots,
+                      const size_t min_size,
+                      const size_t max_size)
+{
+    typedef typename MatrixType::format Format;
+
+    Format format;
+
+    bound_aggregates(thrust::detail::derived_cast(exec), C, aggregates, roots, min_size, max_size, format);
+}
+
+// aggregates the graph of the aggregates of C, whose edges join aggregates
+// holding adjacent nodes, and composes both aggregations
+template <typename DerivedPolicy,
+          typename MatrixType,
+          typename ArrayType1,
+          typename ArrayType2>
+void aggressive_aggregate(thrust::execution_policy<DerivedPolicy> &exec,
+                          const MatrixType& C,
+                                ArrayType1& aggregates,
+                                ArrayType2& roots)
+{
+    typedef typename MatrixType::index_type                       IndexType;
+    typedef typename MatrixType::value_type                       ValueType;
+    typedef typename MatrixType::memory_space                     MemorySpace;
+    typedef typename cusp::detail::as_coo_type<MatrixType>::type  CooMatrix;
+
+    const size_t N = C.num_rows;
+
+    if(N == 0)
+        return;
+
+    cusp::array1d<IndexType, MemorySpace> fine_roots(N);
+    cusp::precond::aggregation::aggregate(exec, C, aggregates, fine_roots);
+
+    const size_t num_aggregates = thrust::reduce(exec, aggregates.begin(), aggregates.end(), IndexType(0), thrust::maximum<IndexType>()) + 1;
+
+    // edges of C between aggregates, duplicates removed
+    CooMatrix C_coo(C);
+    cusp::coo_matrix<IndexType, ValueType, MemorySpace> G(num_aggregates, num_aggregates, C_coo.num_entries);
+
+    thrust::gather(exec, C_coo.row_indices.begin(),    C_coo.row_indices.end(),    aggregates.begin(), G.row_indices.begin());
+    thrust::gather(exec, C_coo.column_indices.begin(), C_coo.column_indices.end(), aggregates.begin(), G.column_indices.begin());
+    thrust::fill(exec, G.values.begin(), G.values.end(), ValueType(1));
+
+    cusp::sort_by_row_and_column(exec, G.row_indices, G.column_indices, G.values, 0, num_aggregates, 0, num_aggregates);
+
+    const size_t num_edges =
+        thrust::unique(exec,
+                       thrust::make_zip_iterator(thrust::make_tuple(G.row_indices.begin(), G.column_indices.begin())),
+                       thrust::make_zip_iterator(thrust::make_tuple(G.row_indices.end(),   G.column_indices.end())))
+        - thrust::make_zip_iterator(thrust::make_tuple(G.row_indices.begin(), G.column_indices.begin()));
+
+    G.resize(num_aggregates, num_aggregates, num_edges);
+
+    cusp::array1d<IndexType, MemorySpace> coarse_aggregates(num_aggregates);
+    cusp::array1d<IndexType, MemorySpace> coarse_roots(num_aggregates);
+    cusp::precond::aggregation::aggregate(exec, G, coarse_aggregates, coarse_roots);
+
+    const size_t num_coarse_aggregates =
+        thrust::reduce(exec, coarse_aggregates.begin(), coarse_aggregates.end(), IndexType(0), thrust::maximum<IndexType>()) + 1;
+
+    // the root of a coarse aggregate is the root of its root aggregate
+    thrust::gather(exec, coarse_roots.begin(), coarse_roots.begin() + num_coarse_aggregates, fine_roots.begin(), roots.begin());
+    cusp::array1d<IndexType, MemorySpace> fine_aggregates(aggregates);
+    thrust::gather(exec, fine_aggregates.begin(), fine_aggregates.end(), coarse_aggregates.begin(), aggregates.begin());
+}
+
+} // end namespace detail
+} // end namespace aggregation
+} // end namespace precond
+} // end namespace cusp
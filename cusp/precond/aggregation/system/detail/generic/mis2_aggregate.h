@@ -0,0 +1,415 @@
+/*
+ *  Copyright 2008-2014 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#pragma once
+
+#include <cusp/detail/config.h>
+#include <cusp/detail/temporary_array.h>
+
+#include <cusp/detail/type_traits.h>
+
+#include <cusp/csr_matrix.h>
+#include <cusp/format_utils.h>
+#include <cusp/iterator/random_iterator.h>
+
+#include <thrust/fill.h>
+#include <thrust/for_each.h>
+#include <thrust/gather.h>
+#include <thrust/scan.h>
+#include <thrust/scatter.h>
+#include <thrust/swap.h>
+#include <thrust/transform.h>
+#include <thrust/iterator/counting_iterator.h>
+
+namespace cusp
+{
+namespace precond
+{
+namespace aggregation
+{
+namespace detail
+{
+namespace mis2
+{
+
+// node states, ordered so that MIS nodes dominate undecided nodes
+enum { OUT = 0, UNDECIDED = 1, IN = 2 };
+
+typedef unsigned long long KeyType;
+
+// (state, hashed priority, index) packed into a single comparable key
+__host__ __device__
+inline KeyType make_key(const unsigned int state, const unsigned int priority, const unsigned int i)
+{
+    return (KeyType(state) << 62) | (KeyType(priority >> 2) << 32) | KeyType(i);
+}
+
+__host__ __device__
+inline unsigned int key_index(const KeyType key)
+{
+    return (unsigned int) (key & 0xffffffffULL);
+}
+
+template <typename IndexType>
+struct key_functor
+{
+    const unsigned char * states;
+    cusp::detail::random_integer_functor<IndexType,unsigned int> hash;
+
+    key_functor(const unsigned char * states, const size_t seed)
+        : states(states), hash(seed) {}
+
+    __host__ __device__
+    KeyType operator()(const IndexType i) const
+    {
+        return make_key(states[i], hash(i), i);
+    }
+};
+
+// keys of the unassigned nodes, assigned nodes never win
+template <typename IndexType>
+struct unassigned_key_functor
+{
+    const IndexType * root;
+    cusp::detail::random_integer_functor<IndexType,unsigned int> hash;
+
+    unassigned_key_functor(const IndexType * root, const size_t seed)
+        : root(root), hash(seed) {}
+
+    __host__ __device__
+    KeyType operator()(const IndexType i) const
+    {
+        return root[i] < 0 ? make_key(UNDECIDED, hash(i), i) : KeyType(0);
+    }
+};
+
+// out[i] <- max(in[j]) over i and its neighbors j
+template <typename IndexType>
+struct ring_max_functor
+{
+    const IndexType * row_offsets;
+    const IndexType * column_indices;
+    const KeyType * in;
+
+    ring_max_functor(const IndexType * row_offsets, const IndexType * column_indices, const KeyType * in)
+        : row_offsets(row_offsets), column_indices(column_indices), in(in) {}
+
+    __host__ __device__
+    KeyType operator()(const IndexType i) const
+    {
+        KeyType key = in[i];
+
+        for(IndexType jj = row_offsets[i]; jj < row_offsets[i + 1]; jj++)
+        {
+            const KeyType other = in[column_indices[jj]];
+
+            if(other > key)
+                key = other;
+        }
+
+        return key;
+    }
+};
+
+// undecided nodes holding the largest key of their 2-ring join the MIS
+template <typename IndexType>
+struct select_functor
+{
+    unsigned char * states;
+    const KeyType * keys;
+    const KeyType * maximal_keys;
+
+    select_functor(unsigned char * states, const KeyType * keys, const KeyType * maximal_keys)
+        : states(states), keys(keys), maximal_keys(maximal_keys) {}
+
+    __host__ __device__
+    void operator()(const IndexType i) const
+    {
+        if(states[i] == UNDECIDED && maximal_keys[i] == keys[i])
+            states[i] = IN;
+    }
+};
+
+// undecided nodes within distance 2 of an MIS node leave the MIS
+template <typename IndexType>
+struct reject_functor
+{
+    unsigned char * states;
+    const KeyType * maximal_keys;
+
+    reject_functor(unsigned char * states, const KeyType * maximal_keys)
+        : states(states), maximal_keys(maximal_keys) {}
+
+    __host__ __device__
+    void operator()(const IndexType i) const
+    {
+        if(states[i] == UNDECIDED && states[key_index(maximal_keys[i])] == IN)
+            states[i] = OUT;
+    }
+};
+
+// unassigned nodes join the root of the neighbor with the largest key
+template <typename IndexType>
+struct attach_functor
+{
+    const IndexType * row_offsets;
+    const IndexType * column_indices;
+    const KeyType * keys;
+    const IndexType * root_in;
+
+    attach_functor(const IndexType * row_offsets, const IndexType * column_indices,
+                   const KeyType * keys, const IndexType * root_in)
+        : row_offsets(row_offsets), column_indices(column_indices), keys(keys), root_in(root_in) {}
+
+    __host__ __device__
+    IndexType operator()(const IndexType i) const
+    {
+        if(root_in[i] >= 0)
+            return root_in[i];
+
+        IndexType root = -1;
+        KeyType best = 0;
+
+        for(IndexType jj = row_offsets[i]; jj < row_offsets[i + 1]; jj++)
+        {
+            const IndexType j = column_indices[jj];
+
+            if(root_in[j] >= 0 && (root < 0 || keys[j] > best))
+            {
+                root = root_in[j];
+                best = keys[j];
+            }
+        }
+
+        return root;
+    }
+};
+
+// unassigned nodes with the largest key among their unassigned neighbors
+// (or every unassigned node if force is set) become new roots
+template <typename IndexType>
+struct promote_functor
+{
+    IndexType * root;
+    const KeyType * keys;
+    const KeyType * maximal_keys;
+    bool force;
+
+    promote_functor(IndexType * root, const KeyType * keys, const KeyType * maximal_keys, bool force)
+        : root(root), keys(keys), maximal_keys(maximal_keys), force(force) {}
+
+    __host__ __device__
+    void operator()(const IndexType i) const
+    {
+        if(root[i] < 0 && (force || maximal_keys[i] == keys[i]))
+            root[i] = i;
+    }
+};
+
+template <typename IndexType>
+struct initial_root_functor
+{
+    const unsigned char * states;
+
+    initial_root_functor(const unsigned char * states) : states(states) {}
+
+    __host__ __device__
+    IndexType operator()(const IndexType i) const
+    {
+        return states[i] == IN ? i : IndexType(-1);
+    }
+};
+
+template <typename IndexType>
+struct is_root_functor
+{
+    const IndexType * root;
+
+    is_root_functor(const IndexType * root) : root(root) {}
+
+    __host__ __device__
+    IndexType operator()(const IndexType i) const
+    {
+        return root[i] == i ? 1 : 0;
+    }
+};
+
+} // end namespace mis2
+
+template <typename DerivedPolicy,
+          typename ArrayType1,
+          typename ArrayType2,
+          typename ArrayType3,
+          typename ArrayType4>
+void mis2_aggregate_csr(thrust::execution_policy<DerivedPolicy> &exec,
+                        const size_t num_rows,
+                        const ArrayType1& row_offsets,
+                        const ArrayType2& column_indices,
+                              ArrayType3& aggregates,
+                              ArrayType4& roots,
+                        const size_t num_rounds)
+{
+    using namespace mis2;
+
+    typedef typename ArrayType2::value_type IndexType;
+    typedef thrust::counting_iterator<IndexType> CountingIterator;
+
+    const IndexType N = num_rows;
+
+    if(N == 0)
+        return;
+
+    cusp::detail::temporary_array<unsigned char, DerivedPolicy> states(exec, N, (unsigned char) UNDECIDED);
+    cusp::detail::temporary_array<KeyType,       DerivedPolicy> keys(exec, N);
+    cusp::detail::temporary_array<KeyType,       DerivedPolicy> ring1(exec, N);
+    cusp::detail::temporary_array<KeyType,       DerivedPolicy> ring2(exec, N);
+    cusp::detail::temporary_array<IndexType,     DerivedPolicy> root_storage(exec, 2 * N);
+
+    const IndexType * Ap = thrust::raw_pointer_cast(&row_offsets[0]);
+    const IndexType * Aj = thrust::raw_pointer_cast(&column_indices[0]);
+
+    unsigned char * states_ptr = thrust::raw_pointer_cast(&states[0]);
+    KeyType * keys_ptr  = thrust::raw_pointer_cast(&keys[0]);
+    KeyType * ring1_ptr = thrust::raw_pointer_cast(&ring1[0]);
+    KeyType * ring2_ptr = thrust::raw_pointer_cast(&ring2[0]);
+
+    // root node of every node (-1 while unassigned), double buffered
+    IndexType * root      = thrust::raw_pointer_cast(&root_storage[0]);
+    IndexType * next_root = root + N;
+
+    CountingIterator first(0);
+    CountingIterator last(N);
+
+    // a fixed number of Luby rounds on the 2-ring with fresh priorities in
+    // every round, nodes left undecided are handled by the fix-up below
+    for(size_t round = 0; round < num_rounds; round++)
+    {
+        thrust::transform(exec, first, last, keys_ptr,  key_functor<IndexType>(states_ptr, round));
+        thrust::transform(exec, first, last, ring1_ptr, ring_max_functor<IndexType>(Ap, Aj, keys_ptr));
+        thrust::transform(exec, first, last, ring2_ptr, ring_max_functor<IndexType>(Ap, Aj, ring1_ptr));
+        thrust::for_each(exec, first, last, select_functor<IndexType>(states_ptr, keys_ptr, ring2_ptr));
+        thrust::for_each(exec, first, last, reject_functor<IndexType>(states_ptr, ring2_ptr));
+    }
+
+    // MIS nodes are the roots, grow each aggregate by its 2-ring
+    thrust::transform(exec, first, last, keys_ptr, key_functor<IndexType>(states_ptr, num_rounds));
+    thrust::transform(exec, first, last, root, initial_root_functor<IndexType>(states_ptr));
+
+    for(size_t pass = 0; pass < 2; pass++)
+    {
+        thrust::transform(exec, first, last, next_root, attach_functor<IndexType>(Ap, Aj, keys_ptr, root));
+        thrust::swap(root, next_root);
+    }
+
+    // fix-up: nodes not reached by any aggregate join an adjacent aggregate
+    // or seed a new one among themselves, aggregates only grow through
+    // adjacent members and therefore stay connected
+    for(size_t pass = 0; pass < 2; pass++)
+    {
+        thrust::transform(exec, first, last, keys_ptr,  unassigned_key_functor<IndexType>(root, num_rounds + pass + 1));
+        thrust::transform(exec, first, last, ring1_ptr, ring_max_functor<IndexType>(Ap, Aj, keys_ptr));
+        thrust::for_each(exec, first, last, promote_functor<IndexType>(root, keys_ptr, ring1_ptr, false));
+
+        thrust::transform(exec, first, last, next_root, attach_functor<IndexType>(Ap, Aj, keys_ptr, root));
+        thrust::swap(root, next_root);
+    }
+
+    // whatever is still unassigned forms singleton aggregates
+    thrust::for_each(exec, first, last, promote_functor<IndexType>(root, keys_ptr, ring1_ptr, true));
+
+    // enumerate the roots and label every node with the index of its root
+    IndexType * is_root  = next_root;
+    cusp::detail::temporary_array<IndexType, DerivedPolicy> root_ids(exec, N);
+
+    thrust::transform(exec, first, last, is_root, is_root_functor<IndexType>(root));
+    thrust::exclusive_scan(exec, is_root, is_root + N, root_ids.begin());
+    thrust::scatter_if(exec, first, last, root_ids.begin(), is_root, roots.begin());
+    thrust::gather(exec, root, root + N, root_ids.begin(), aggregates.begin());
+}
+
+template <typename DerivedPolicy,
+          typename MatrixType,
+          typename ArrayType1,
+          typename ArrayType2>
+void mis2_aggregate(thrust::execution_policy<DerivedPolicy> &exec,
+                    const MatrixType& C,
+                          ArrayType1& aggregates,
+                          ArrayType2& roots,
+                    const size_t num_rounds,
+                    cusp::csr_format)
+{
+    mis2_aggregate_csr(exec, C.num_rows, C.row_offsets, C.column_indices, aggregates, roots, num_rounds);
+}
+
+template <typename DerivedPolicy,
+          typename MatrixType,
+          typename ArrayType1,
+          typename ArrayType2>
+void mis2_aggregate(thrust::execution_policy<DerivedPolicy> &exec,
+                    const MatrixType& C,
+                          ArrayType1& aggregates,
+                          ArrayType2& roots,
+                    const size_t num_rounds,
+                    cusp::coo_format)
+{
+    typedef typename MatrixType::index_type IndexType;
+
+    // compress the (sorted) row indices
+    cusp::detail::temporary_array<IndexType, DerivedPolicy> row_offsets(exec, C.num_rows + 1);
+    cusp::indices_to_offsets(exec, C.row_indices, row_offsets);
+
+    mis2_aggregate_csr(exec, C.num_rows, row_offsets, C.column_indices, aggregates, roots, num_rounds);
+}
+
+template <typename DerivedPolicy,
+          typename MatrixType,
+          typename ArrayType1,
+          typename ArrayType2>
+void mis2_aggregate(thrust::execution_policy<DerivedPolicy> &exec,
+                    const MatrixType& C,
+                          ArrayType1& aggregates,
+                          ArrayType2& roots,
+                    const size_t num_rounds,
+                    cusp::known_format)
+{
+    typedef typename cusp::detail::as_csr_type<MatrixType>::type CsrMatrix;
+
+    CsrMatrix C_csr(C);
+
+    mis2_aggregate_csr(exec, C_csr.num_rows, C_csr.row_offsets, C_csr.column_indices, aggregates, roots, num_rounds);
+}
+
+template <typename DerivedPolicy,
+          typename MatrixType,
+          typename ArrayType1,
+          typename ArrayType2>
+void mis2_aggregate(thrust::execution_policy<DerivedPolicy> &exec,
+                    const MatrixType& C,
+                          ArrayType1& aggregates,
+                          ArrayType2& roots,
+                    const size_t num_rounds)
+{
+    typedef typename MatrixType::format Format;
+
+    Format format;
+
+    mis2_aggregate(thrust::detail::derived_cast(exec), C, aggregates, roots, num_rounds, format);
+}
+
+} // end namespace detail
+} // end namespace aggregation
+} // end namespace precond
+} // end namespace cusp
@@ -14,6 +14,11 @@
  *  limitations under the License.
  */
 
+#pragma once
+
+#include <cusp/detail/config.h>
+#include <cusp/detail/format.h>
+#include <cusp/detail/temporary_array.h>
 
 #include <cusp/array1d.h>
 #include <cusp/complex.h>
@@ -23,10 +28,13 @@
 #include <cusp/format_utils.h>
 #include <cusp/functional.h>
 
-#include <thrust/count.h>
-#include <thrust/functional.h>
-#include <thrust/iterator/zip_iterator.h>
-#include <thrust/iterator/permutation_iterator.h>
+#include <thrust/copy.h>
+#include <thrust/fill.h>
+#include <thrust/for_each.h>
+#include <thrust/reduce.h>
+#include <thrust/scan.h>
+#include <thrust/transform.h>
+#include <thrust/iterator/counting_iterator.h>
 
 #include <cusp/precond/aggregation/system/detail/sequential/symmetric_strength.h>
 
@@ -39,93 +47,255 @@ namespace aggregation
 namespace detail
 {
 
-template <typename ValueType>
-struct is_strong_connection
+// |A(i,i)| of every row, zero if the row has no diagonal entry
+template <typename IndexType, typename ValueType, typename NormType>
+struct strength_diagonal_functor
 {
-    typedef typename cusp::norm_type<ValueType>::type NormType;
+    const IndexType * row_offsets;
+    const IndexType * column_indices;
+    const ValueType * values;
+
+    strength_diagonal_functor(const IndexType * row_offsets, const IndexType * column_indices,
+                              const ValueType * values)
+        : row_offsets(row_offsets), column_indices(column_indices), values(values) {}
+
+    __host__ __device__
+    NormType operator()(const IndexType i) const
+    {
+        for(IndexType jj = row_offsets[i]; jj < row_offsets[i + 1]; jj++)
+            if(column_indices[jj] == i)
+                return cusp::abs(values[jj]);
+
+        return NormType(0);
+    }
+};
+
+// count (row_indices == NULL) or copy the strong connections of every row,
+// |A(i,j)| >= theta * sqrt(|A(i,i)|*|A(j,j)|) is squared to avoid the sqrt()
+template <typename IndexType, typename ValueType, typename NormType>
+struct strength_row_functor
+{
+    const IndexType * row_offsets;
+    const IndexType * column_indices;
+    const ValueType * values;
+    const NormType * diagonal;
+    const NormType theta2;
 
-    NormType theta;
+    const IndexType * S_row_offsets;
+    IndexType * S_row_indices;
+    IndexType * S_column_indices;
+    ValueType * S_values;
 
-    is_strong_connection(const NormType theta) : theta(theta) {}
+    strength_row_functor(const IndexType * row_offsets, const IndexType * column_indices,
+                         const ValueType * values, const NormType * diagonal, const NormType theta,
+                         const IndexType * S_row_offsets = NULL, IndexType * S_row_indices = NULL,
+                         IndexType * S_column_indices = NULL, ValueType * S_values = NULL)
+        : row_offsets(row_offsets), column_indices(column_indices), values(values),
+          diagonal(diagonal), theta2(theta * theta),
+          S_row_offsets(S_row_offsets), S_row_indices(S_row_indices),
+          S_column_indices(S_column_indices), S_values(S_values) {}
 
-    template <typename Tuple>
     __host__ __device__
-    bool operator()(const Tuple& t) const
+    IndexType operator()(const IndexType i) const
     {
-        NormType nAij = cusp::abs(thrust::get<0>(t));
-        NormType nAii = cusp::abs(thrust::get<1>(t));
-        NormType nAjj = cusp::abs(thrust::get<2>(t));
+        const NormType nAii = diagonal[i];
 
-        // square everything to eliminate the sqrt()
-        return (nAij*nAij) >= ((theta*theta) * (nAii * nAjj));
+        IndexType n = S_column_indices == NULL ? 0 : S_row_offsets[i];
+
+        for(IndexType jj = row_offsets[i]; jj < row_offsets[i + 1]; jj++)
+        {
+            const IndexType j    = column_indices[jj];
+            const NormType  nAij = cusp::abs(values[jj]);
+
+            if(nAij * nAij < theta2 * (nAii * diagonal[j]))
+                continue;
+
+            if(S_column_indices != NULL)
+            {
+                if(S_row_indices != NULL)
+                    S_row_indices[n] = i;
+
+                S_column_indices[n] = j;
+                S_values[n]         = values[jj];
+            }
+
+            n++;
+        }
+
+        return S_column_indices == NULL ? n : n - S_row_offsets[i];
     }
 };
 
+template <typename MatrixType>
+typename MatrixType::index_type * strength_row_indices(MatrixType& S, cusp::coo_format)
+{
+    return thrust::raw_pointer_cast(&S.row_indices[0]);
+}
+
+template <typename MatrixType>
+typename MatrixType::index_type * strength_row_indices(MatrixType& S, cusp::csr_format)
+{
+    return NULL;
+}
+
+template <typename DerivedPolicy, typename ArrayType, typename MatrixType, typename Format>
+void strength_row_offsets(thrust::execution_policy<DerivedPolicy> &exec,
+                          const ArrayType& row_offsets, MatrixType& S, Format)
+{
+}
+
+template <typename DerivedPolicy, typename ArrayType, typename MatrixType>
+void strength_row_offsets(thrust::execution_policy<DerivedPolicy> &exec,
+                          const ArrayType& row_offsets, MatrixType& S, cusp::csr_format)
+{
+    thrust::copy(exec, row_offsets.begin(), row_offsets.end(), S.row_offsets.begin());
+}
+
+// two passes over the rows of A, the first counts the strong connections
+// of every row and the second writes them to S, the diagonal used by both
+// is gathered once per row
 template <typename DerivedPolicy,
+          typename ArrayType,
           typename MatrixType1,
           typename MatrixType2>
-void symmetric_strength_of_connection(thrust::execution_policy<DerivedPolicy> &exec,
-                                      const MatrixType1& A,
-                                            MatrixType2& S,
-                                      const double theta,
-                                      cusp::coo_format)
+void fused_symmetric_strength(thrust::execution_policy<DerivedPolicy> &exec,
+                              const ArrayType& row_offsets,
+                              const MatrixType1& A,
+                                    MatrixType2& S,
+                              const double theta)
 {
-    typedef typename MatrixType1::index_type   IndexType;
-    typedef typename MatrixType1::value_type   ValueType;
+    typedef typename MatrixType2::index_type IndexType;
+    typedef typename MatrixType2::value_type ValueType;
+    typedef typename MatrixType2::format     Format;
+    typedef typename cusp::norm_type<ValueType>::type NormType;
+    typedef thrust::counting_iterator<IndexType> CountingIterator;
+
+    const IndexType N = A.num_rows;
 
-    cusp::detail::temporary_array<ValueType, DerivedPolicy> diagonal(exec, A.num_rows);
-    cusp::extract_diagonal(exec, A, diagonal);
+    if(A.num_entries == 0)
+    {
+        S.resize(A.num_rows, A.num_cols, 0);
+        cusp::detail::temporary_array<IndexType, DerivedPolicy> S_row_offsets(exec, N + 1, IndexType(0));
+        strength_row_offsets(exec, S_row_offsets, S, Format());
+        return;
+    }
 
-    is_strong_connection<ValueType> pred(theta);
+    const IndexType * row_offsets_ptr    = thrust::raw_pointer_cast(&row_offsets[0]);
+    const IndexType * column_indices_ptr = thrust::raw_pointer_cast(&A.column_indices[0]);
+    const ValueType * values_ptr         = thrust::raw_pointer_cast(&A.values[0]);
 
-    cusp::detail::temporary_array<bool, DerivedPolicy> copyflags(exec, A.num_entries);
+    cusp::detail::temporary_array<NormType, DerivedPolicy> diagonal(exec, N);
+    thrust::transform(exec, CountingIterator(0), CountingIterator(N), diagonal.begin(),
+                      strength_diagonal_functor<IndexType,ValueType,NormType>(row_offsets_ptr, column_indices_ptr, values_ptr));
 
-    // this is just zipping up (A[i,j],A[i,i],A[j,j]) and applying is_strong_connection to each tuple
-    thrust::transform(exec,
-                      thrust::make_zip_iterator(thrust::make_tuple(A.values.begin(),
-                                                thrust::make_permutation_iterator(diagonal.begin(), A.row_indices.begin()),
-                                                thrust::make_permutation_iterator(diagonal.begin(), A.column_indices.begin()))),
-                      thrust::make_zip_iterator(thrust::make_tuple(A.values.begin(),
-                                                thrust::make_permutation_iterator(diagonal.begin(), A.row_indices.begin()),
-                                                thrust::make_permutation_iterator(diagonal.begin(), A.column_indices.begin()))) + A.num_entries,
-                      copyflags.begin(),
-                      pred);
+    const NormType * diagonal_ptr = thrust::raw_pointer_cast(&diagonal[0]);
 
+    // count the strong connections of every row
+    cusp::detail::temporary_array<IndexType, DerivedPolicy> S_row_offsets(exec, N + 1);
+    thrust::fill(exec, S_row_offsets.begin(), S_row_offsets.begin() + 1, IndexType(0));
+    thrust::transform(exec, CountingIterator(0), CountingIterator(N), S_row_offsets.begin() + 1,
+                      strength_row_functor<IndexType,ValueType,NormType>(row_offsets_ptr, column_indices_ptr, values_ptr,
+                                                                         diagonal_ptr, NormType(theta)));
+    thrust::inclusive_scan(exec, S_row_offsets.begin() + 1, S_row_offsets.end(), S_row_offsets.begin() + 1);
 
-    // compute number of entries in output
-    IndexType num_entries = thrust::count(exec, copyflags.begin(), copyflags.end(), true);
+    const IndexType num_entries = S_row_offsets[N];
 
-    // resize output
     S.resize(A.num_rows, A.num_cols, num_entries);
+    strength_row_offsets(exec, S_row_offsets, S, Format());
+
+    if(num_entries == 0)
+        return;
 
-    // copy strong connections to output
-    // thrust::copy_if(exec,
-    //                 thrust::make_zip_iterator(thrust::make_tuple(A.row_indices.begin(), A.column_indices.begin(), A.values.begin())),
-    //                 thrust::make_zip_iterator(thrust::make_tuple(A.row_indices.begin(), A.column_indices.begin(), A.values.begin())) + A.num_entries,
-    //                 copyflags.begin(),
-    //                 thrust::make_zip_iterator(thrust::make_tuple(S.row_indices.begin(), S.column_indices.begin(), S.values.begin())),
-    //                 thrust::identity<bool>());
-
-    // WAR for runtime error "cudaFuncGetAttributes: invalid device function"
-    // using zip_iterators
-    thrust::copy_if(exec,
-                    A.row_indices.begin(),
-                    A.row_indices.begin() + A.num_entries,
-                    copyflags.begin(),
-                    S.row_indices.begin(),
-                    thrust::identity<bool>());
-    thrust::copy_if(exec,
-                    A.column_indices.begin(),
-                    A.column_indices.begin() + A.num_entries,
-                    copyflags.begin(),
-                    S.column_indices.begin(),
-                    thrust::identity<bool>());
-    thrust::copy_if(exec,
-                    A.values.begin(),
-                    A.values.begin() + A.num_entries,
-                    copyflags.begin(),
-                    S.values.begin(),
-                    thrust::identity<bool>());
+    // copy the strong connections of every row to S
+    thrust::for_each(exec, CountingIterator(0), CountingIterator(N),
+                     strength_row_functor<IndexType,ValueType,NormType>(row_offsets_ptr, column_indices_ptr, values_ptr,
+                                                                        diagonal_ptr, NormType(theta),
+                                                                        thrust::raw_pointer_cast(&S_row_offsets[0]),
+                                                                        strength_row_indices(S, Format()),
+                                                                        thrust::raw_pointer_cast(&S.column_indices[0]),
+                                                                        thrust::raw_pointer_cast(&S.values[0])));
+}
+
+// S is written directly if it is a COO or CSR matrix
+template <typename DerivedPolicy,
+          typename ArrayType,
+          typename MatrixType1,
+          typename MatrixType2,
+          typename Format>
+void fused_symmetric_strength(thrust::execution_policy<DerivedPolicy> &exec,
+                              const ArrayType& row_offsets,
+                              const MatrixType1& A,
+                                    MatrixType2& S,
+                              const double theta,
+                              Format)
+{
+    typedef typename cusp::detail::as_csr_type<MatrixType2>::type CsrType;
+
+    CsrType S_;
+
+    fused_symmetric_strength(exec, row_offsets, A, S_, theta);
+
+    cusp::convert(exec, S_, S);
+}
+
+template <typename DerivedPolicy,
+          typename ArrayType,
+          typename MatrixType1,
+          typename MatrixType2>
+void fused_symmetric_strength(thrust::execution_policy<DerivedPolicy> &exec,
+                              const ArrayType& row_offsets,
+                              const MatrixType1& A,
+                                    MatrixType2& S,
+                              const double theta,
+                              cusp::csr_format)
+{
+    fused_symmetric_strength(exec, row_offsets, A, S, theta);
+}
+
+template <typename DerivedPolicy,
+          typename ArrayType,
+          typename MatrixType1,
+          typename MatrixType2>
+void fused_symmetric_strength(thrust::execution_policy<DerivedPolicy> &exec,
+                              const ArrayType& row_offsets,
+                              const MatrixType1& A,
+                                    MatrixType2& S,
+                              const double theta,
+                              cusp::coo_format)
+{
+    fused_symmetric_strength(exec, row_offsets, A, S, theta);
+}
+
+template <typename DerivedPolicy,
+          typename MatrixType1,
+          typename MatrixType2>
+void symmetric_strength_of_connection(thrust::execution_policy<DerivedPolicy> &exec,
+                                      const MatrixType1& A,
+                                            MatrixType2& S,
+                                      const double theta,
+                                      cusp::csr_format)
+{
+    typedef typename MatrixType2::format Format;
+
+    fused_symmetric_strength(exec, A.row_offsets, A, S, theta, Format());
+}
+
+template <typename DerivedPolicy,
+          typename MatrixType1,
+          typename MatrixType2>
+void symmetric_strength_of_connection(thrust::execution_policy<DerivedPolicy> &exec,
+                                      const MatrixType1& A,
+                                            MatrixType2& S,
+                                      const double theta,
+                                      cusp::coo_format)
+{
+    typedef typename MatrixType1::index_type IndexType;
+    typedef typename MatrixType2::format     Format;
+
+    cusp::detail::temporary_array<IndexType, DerivedPolicy> row_offsets(exec, A.num_rows + 1);
+    cusp::indices_to_offsets(exec, A.row_indices, row_offsets);
+
+    fused_symmetric_strength(exec, row_offsets, A, S, theta, Format());
 }
 
 template <typename DerivedPolicy,
@@ -138,14 +308,10 @@ void symmetric_strength_of_connection(thrust::execution_policy<DerivedPolicy> &e
                                       cusp::known_format)
 {
     typedef typename MatrixType1::const_coo_view_type MatrixViewType;
-    typedef typename cusp::detail::as_coo_type<MatrixType2>::type CooType;
 
     MatrixViewType A_(A);
-    CooType S_;
-
-    symmetric_strength_of_connection(exec, A_ , S_, theta, cusp::coo_format());
 
-    cusp::convert(exec, S_, S);
+    symmetric_strength_of_connection(exec, A_ , S, theta, cusp::coo_format());
 }
 
 template <typename DerivedPolicy,
@@ -167,4 +333,3 @@ void symmetric_strength_of_connection(thrust::execution_policy<DerivedPolicy> &e
 } // end namespace aggregation
 } // end namespace precond
 } // end namespace cusp
-
@@ -16,15 +16,27 @@
 
 
 #include <cusp/array1d.h>
+#include <cusp/array2d.h>
 #include <cusp/convert.h>
 #include <cusp/copy.h>
 #include <cusp/csr_matrix.h>
 #include <cusp/format_utils.h>
 #include <cusp/functional.h>
+#include <cusp/exception.h>
 #include <cusp/transpose.h>
 
+#include <cusp/detail/fixed_size.h>
+#include <cusp/detail/temporary_array.h>
+
+#include <thrust/binary_search.h>
+#include <thrust/copy.h>
 #include <thrust/count.h>
+#include <thrust/for_each.h>
 #include <thrust/functional.h>
+#include <thrust/gather.h>
+#include <thrust/scatter.h>
+#include <thrust/sort.h>
+#include <thrust/iterator/counting_iterator.h>
 #include <thrust/iterator/zip_iterator.h>
 #include <thrust/iterator/permutation_iterator.h>
 
@@ -48,7 +60,8 @@ void fit_candidates(thrust::execution_policy<DerivedPolicy> &exec,
                     const ArrayType1& aggregates,
                     const ArrayType2& B,
                     MatrixType& Q_,
-                    ArrayType3& R)
+                    ArrayType3& R,
+                    cusp::array1d_format)
 {
     typedef typename MatrixType::index_type IndexType;
     typedef typename MatrixType::value_type ValueType;
@@ -101,6 +114,245 @@ void fit_candidates(thrust::execution_policy<DerivedPolicy> &exec,
     cusp::convert(exec, Q, Q_);
 }
 
+// copies the K candidate values of the rows of every aggregate into a
+// contiguous row-major block, local row p holds B(perm[p],:)
+template <size_t K, typename IndexType, typename ValueType>
+struct gather_candidates_functor
+{
+    const IndexType * perm;
+    const ValueType * B;
+    size_t pitch;
+    ValueType * local;
+
+    gather_candidates_functor(const IndexType * perm, const ValueType * B, size_t pitch, ValueType * local)
+        : perm(perm), B(B), pitch(pitch), local(local) {}
+
+    __host__ __device__
+    void operator()(const IndexType p) const
+    {
+        const IndexType row = perm[p];
+
+        for(size_t k = 0; k < K; k++)
+            local[p * K + k] = B[row * pitch + k];
+    }
+};
+
+// thin QR of the rows of aggregate a, local is overwritten by Q and the
+// K x K factor is stored row-major at R + a K^2
+template <size_t K, typename IndexType, typename ValueType>
+struct qr_aggregate_functor
+{
+    const IndexType * offsets;
+    ValueType * local;
+    ValueType * R;
+
+    qr_aggregate_functor(const IndexType * offsets, ValueType * local, ValueType * R)
+        : offsets(offsets), local(local), R(R) {}
+
+    __host__ __device__
+    void operator()(const IndexType a) const
+    {
+        const IndexType start = offsets[a];
+
+        cusp::detail::fixed_size::qr<K>(local + start * K, offsets[a + 1] - start, R + a * K * K);
+    }
+};
+
+// entries of the t-th aggregated row of Q, columns aggregate * K + k
+template <size_t K, typename IndexType, typename ValueType>
+struct scatter_candidates_functor
+{
+    const IndexType * rows;
+    const IndexType * aggregates;
+    const IndexType * rank;
+    const ValueType * local;
+    IndexType * Qi;
+    IndexType * Qj;
+    ValueType * Qx;
+
+    scatter_candidates_functor(const IndexType * rows, const IndexType * aggregates, const IndexType * rank,
+                               const ValueType * local, IndexType * Qi, IndexType * Qj, ValueType * Qx)
+        : rows(rows), aggregates(aggregates), rank(rank), local(local), Qi(Qi), Qj(Qj), Qx(Qx) {}
+
+    __host__ __device__
+    void operator()(const IndexType t) const
+    {
+        const IndexType row = rows[t];
+        const IndexType p   = rank[row];
+        const IndexType a   = aggregates[row];
+
+        for(size_t k = 0; k < K; k++)
+        {
+            Qi[t * K + k] = row;
+            Qj[t * K + k] = a * K + k;
+            Qx[t * K + k] = local[p * K + k];
+        }
+    }
+};
+
+template <typename DerivedPolicy, typename IndexType, typename ValueType, typename MemorySpace>
+struct fit_candidates_blocks
+{
+    thrust::execution_policy<DerivedPolicy>& exec;
+    const IndexType * rows;
+    const IndexType * aggregates;
+    const IndexType * perm;
+    const IndexType * rank;
+    const IndexType * offsets;
+    const cusp::array2d<ValueType,MemorySpace,cusp::row_major>& B;
+    cusp::coo_matrix<IndexType,ValueType,MemorySpace>& Q;
+    cusp::array2d<ValueType,MemorySpace,cusp::row_major>& R;
+    IndexType num_aggregated;
+    IndexType num_aggregates;
+
+    fit_candidates_blocks(thrust::execution_policy<DerivedPolicy>& exec,
+                          const IndexType * rows, const IndexType * aggregates, const IndexType * perm,
+                          const IndexType * rank, const IndexType * offsets,
+                          const cusp::array2d<ValueType,MemorySpace,cusp::row_major>& B,
+                          cusp::coo_matrix<IndexType,ValueType,MemorySpace>& Q,
+                          cusp::array2d<ValueType,MemorySpace,cusp::row_major>& R,
+                          IndexType num_aggregated, IndexType num_aggregates)
+        : exec(exec), rows(rows), aggregates(aggregates), perm(perm), rank(rank), offsets(offsets),
+          B(B), Q(Q), R(R), num_aggregated(num_aggregated), num_aggregates(num_aggregates) {}
+
+    template <size_t K>
+    void apply(void)
+    {
+        cusp::detail::temporary_array<ValueType, DerivedPolicy> local(exec, num_aggregated * K);
+        ValueType * local_ptr = thrust::raw_pointer_cast(&local[0]);
+
+        thrust::for_each(exec,
+                         thrust::counting_iterator<IndexType>(0),
+                         thrust::counting_iterator<IndexType>(num_aggregated),
+                         gather_candidates_functor<K,IndexType,ValueType>(
+                             perm, thrust::raw_pointer_cast(&B.values[0]), B.pitch, local_ptr));
+
+        thrust::for_each(exec,
+                         thrust::counting_iterator<IndexType>(0),
+                         thrust::counting_iterator<IndexType>(num_aggregates),
+                         qr_aggregate_functor<K,IndexType,ValueType>(
+                             offsets, local_ptr, thrust::raw_pointer_cast(&R.values[0])));
+
+        thrust::for_each(exec,
+                         thrust::counting_iterator<IndexType>(0),
+                         thrust::counting_iterator<IndexType>(num_aggregated),
+                         scatter_candidates_functor<K,IndexType,ValueType>(
+                             rows, aggregates, rank, local_ptr,
+                             thrust::raw_pointer_cast(&Q.row_indices[0]),
+                             thrust::raw_pointer_cast(&Q.column_indices[0]),
+                             thrust::raw_pointer_cast(&Q.values[0])));
+    }
+};
+
+// Multiple candidates, the K columns of B, as in the rigid body modes of
+// elasticity. Every aggregate a contributes the K columns [a K, (a + 1) K)
+// of Q, orthonormalized by a thin QR factorization of the rows of B in the
+// aggregate, and R holds the stacked K x K factors, i.e. the coarse
+// candidates. The factorizations are independent and run in parallel with
+// the fixed size kernels of cusp::detail::fixed_size, 1 <= K <= 8.
+template <typename DerivedPolicy,
+          typename ArrayType1,
+          typename ArrayType2,
+          typename MatrixType,
+          typename ArrayType3>
+void fit_candidates(thrust::execution_policy<DerivedPolicy> &exec,
+                    const ArrayType1& aggregates,
+                    const ArrayType2& B,
+                    MatrixType& Q_,
+                    ArrayType3& R,
+                    cusp::array2d_format)
+{
+    typedef typename MatrixType::index_type IndexType;
+    typedef typename MatrixType::value_type ValueType;
+    typedef typename MatrixType::memory_space MemorySpace;
+
+    const size_t K = B.num_cols;
+    const IndexType num_rows = aggregates.size();
+
+    if(K == 0 || K > cusp::detail::fixed_size::MAX_BLOCK_SIZE)
+        throw cusp::invalid_input_exception("fit_candidates supports 1 through 8 candidate vectors");
+
+    IndexType num_unaggregated = thrust::count(exec, aggregates.begin(), aggregates.end(), -1);
+    IndexType num_aggregates   = *thrust::max_element(exec, aggregates.begin(), aggregates.end()) + 1;
+    IndexType num_aggregated   = num_rows - num_unaggregated;
+
+    cusp::array2d<ValueType,MemorySpace,cusp::row_major> B_row;
+    cusp::copy(exec, B, B_row);
+
+    cusp::coo_matrix<IndexType,ValueType,MemorySpace> Q(num_rows, num_aggregates * K, num_aggregated * K);
+    cusp::array2d<ValueType,MemorySpace,cusp::row_major> R_row(num_aggregates * K, K);
+
+    // aggregated rows in row order
+    cusp::detail::temporary_array<IndexType, DerivedPolicy> rows(exec, num_aggregated);
+    thrust::copy_if(exec,
+                    thrust::counting_iterator<IndexType>(0),
+                    thrust::counting_iterator<IndexType>(num_rows),
+                    aggregates.begin(),
+                    rows.begin(),
+                    _1 != -1);
+
+    // the same rows ordered by aggregate and the start of every aggregate
+    cusp::detail::temporary_array<IndexType, DerivedPolicy> keys(exec, num_aggregated);
+    cusp::detail::temporary_array<IndexType, DerivedPolicy> perm(exec, rows.begin(), rows.end());
+    thrust::gather(exec, rows.begin(), rows.end(), aggregates.begin(), keys.begin());
+    thrust::stable_sort_by_key(exec, keys.begin(), keys.end(), perm.begin());
+
+    cusp::detail::temporary_array<IndexType, DerivedPolicy> offsets(exec, num_aggregates + 1);
+    thrust::lower_bound(exec,
+                        keys.begin(), keys.end(),
+                        thrust::counting_iterator<IndexType>(0),
+                        thrust::counting_iterator<IndexType>(num_aggregates + 1),
+                        offsets.begin());
+
+    // position of every aggregated row in perm
+    cusp::detail::temporary_array<IndexType, DerivedPolicy> rank(exec, num_rows);
+    thrust::scatter(exec,
+                    thrust::counting_iterator<IndexType>(0),
+                    thrust::counting_iterator<IndexType>(num_aggregated),
+                    perm.begin(),
+                    rank.begin());
+
+    cusp::array1d<IndexType,MemorySpace> aggregates_(aggregates);
+
+    if(num_aggregated > 0)
+    {
+        fit_candidates_blocks<DerivedPolicy,IndexType,ValueType,MemorySpace>
+            op(exec,
+               thrust::raw_pointer_cast(&rows[0]),
+               thrust::raw_pointer_cast(&aggregates_[0]),
+               thrust::raw_pointer_cast(&perm[0]),
+               thrust::raw_pointer_cast(&rank[0]),
+               thrust::raw_pointer_cast(&offsets[0]),
+               B_row, Q, R_row, num_aggregated, num_aggregates);
+
+        if(K == 1)
+            op.template apply<1>();
+        else
+            cusp::detail::fixed_size::dispatch_block_size(K, op);
+    }
+
+    cusp::copy(exec, R_row, R);
+
+    // copy/convert Q to output matrix Q_
+    cusp::convert(exec, Q, Q_);
+}
+
+template <typename DerivedPolicy,
+          typename ArrayType1,
+          typename ArrayType2,
+          typename MatrixType,
+          typename ArrayType3>
+void fit_candidates(thrust::execution_policy<DerivedPolicy> &exec,
+                    const ArrayType1& aggregates,
+                    const ArrayType2& B,
+                    MatrixType& Q,
+                    ArrayType3& R)
+{
+    typedef typename ArrayType2::format Format;
+
+    fit_candidates(exec, aggregates, B, Q, R, Format());
+}
+
 } // end namepace detail
 } // end namespace aggregation
 } // end namespace precond
@@ -0,0 +1,373 @@
+/*
+ *  Copyright 2008-2014 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#pragma once
+
+#include <cusp/detail/config.h>
+#include <cusp/detail/format.h>
+#include <cusp/detail/temporary_array.h>
+
+#include <cusp/complex.h>
+#include <cusp/convert.h>
+#include <cusp/coo_matrix.h>
+
+#include <thrust/copy.h>
+#include <thrust/count.h>
+#include <thrust/fill.h>
+#include <thrust/for_each.h>
+#include <thrust/functional.h>
+#include <thrust/gather.h>
+#include <thrust/reduce.h>
+#include <thrust/scan.h>
+#include <thrust/scatter.h>
+#include <thrust/sequence.h>
+#include <thrust/sort.h>
+#include <thrust/transform.h>
+
+#include <thrust/iterator/constant_iterator.h>
+#include <thrust/iterator/counting_iterator.h>
+#include <thrust/iterator/permutation_iterator.h>
+#include <thrust/iterator/zip_iterator.h>
+
+namespace cusp
+{
+namespace precond
+{
+namespace aggregation
+{
+namespace detail
+{
+namespace truncation
+{
+
+// magnitude of an entry, diagonal entries that are always kept are
+// marked with a negative magnitude
+template <typename ValueType, typename NormType>
+struct magnitude_functor
+{
+    const bool keep_diagonal;
+
+    magnitude_functor(const bool keep_diagonal) : keep_diagonal(keep_diagonal) {}
+
+    template <typename Tuple>
+    __host__ __device__
+    NormType operator()(const Tuple& t) const
+    {
+        if(keep_diagonal && thrust::get<0>(t) == thrust::get<1>(t))
+            return NormType(-1);
+
+        return cusp::abs(ValueType(thrust::get<2>(t)));
+    }
+};
+
+template <typename NormType>
+struct keep_functor
+{
+    __host__ __device__
+    bool operator()(const NormType magnitude, const NormType threshold) const
+    {
+        return magnitude < NormType(0) || (magnitude > NormType(0) && magnitude >= threshold);
+    }
+};
+
+// drop every entry past the max_entries largest of its row, the entries
+// are visited in row major order of decreasing magnitude
+template <typename IndexType, typename NormType>
+struct limit_functor
+{
+    const IndexType * rank;
+    const IndexType * permutation;
+    const NormType * magnitude;
+    bool * keep;
+    const IndexType max_entries;
+
+    limit_functor(const IndexType * rank, const IndexType * permutation,
+                  const NormType * magnitude, bool * keep, const IndexType max_entries)
+        : rank(rank), permutation(permutation), magnitude(magnitude),
+          keep(keep), max_entries(max_entries) {}
+
+    __host__ __device__
+    void operator()(const IndexType n) const
+    {
+        const IndexType k = permutation[n];
+
+        if(rank[n] >= max_entries && magnitude[k] >= NormType(0))
+            keep[k] = false;
+    }
+};
+
+template <typename ValueType>
+struct select_value_functor
+{
+    const bool kept;
+
+    select_value_functor(const bool kept) : kept(kept) {}
+
+    __host__ __device__
+    ValueType operator()(const ValueType v, const bool keep) const
+    {
+        return keep == kept ? v : ValueType(0);
+    }
+};
+
+// operators: add the dropped entries of a row to its diagonal
+template <typename IndexType, typename ValueType>
+struct lump_functor
+{
+    const ValueType * dropped;
+
+    lump_functor(const ValueType * dropped) : dropped(dropped) {}
+
+    template <typename Tuple>
+    __host__ __device__
+    ValueType operator()(const Tuple& t) const
+    {
+        const IndexType i = thrust::get<0>(t);
+        const IndexType j = thrust::get<1>(t);
+        const ValueType v = thrust::get<2>(t);
+
+        return i == j ? v + dropped[i] : v;
+    }
+};
+
+// prolongators: rescale the kept entries of a row to its original sum
+template <typename IndexType, typename ValueType>
+struct rescale_functor
+{
+    const ValueType * kept;
+    const ValueType * dropped;
+
+    rescale_functor(const ValueType * kept, const ValueType * dropped)
+        : kept(kept), dropped(dropped) {}
+
+    __host__ __device__
+    ValueType operator()(const IndexType i, const ValueType v) const
+    {
+        if(kept[i] == ValueType(0))
+            return v;
+
+        return v * ((kept[i] + dropped[i]) / kept[i]);
+    }
+};
+
+// row sums of the entries selected by keep == kept, rows without entries
+// are zero
+template <typename DerivedPolicy, typename ArrayType1, typename ArrayType2, typename ArrayType3, typename ArrayType4>
+void row_sums(thrust::execution_policy<DerivedPolicy> &exec,
+              const ArrayType1& row_indices,
+              const ArrayType2& values,
+              const ArrayType3& keep,
+              const bool kept,
+                    ArrayType4& sums)
+{
+    typedef typename ArrayType1::value_type IndexType;
+    typedef typename ArrayType2::value_type ValueType;
+
+    const size_t N = row_indices.size();
+
+    cusp::detail::temporary_array<ValueType, DerivedPolicy> selected(exec, N);
+    cusp::detail::temporary_array<IndexType, DerivedPolicy> rows(exec, N);
+    cusp::detail::temporary_array<ValueType, DerivedPolicy> partial(exec, N);
+
+    thrust::transform(exec, values.begin(), values.end(), keep.begin(), selected.begin(),
+                      select_value_functor<ValueType>(kept));
+
+    size_t num_rows = thrust::reduce_by_key(exec,
+                                            row_indices.begin(), row_indices.end(),
+                                            selected.begin(),
+                                            rows.begin(), partial.begin()).first - rows.begin();
+
+    thrust::fill(exec, sums.begin(), sums.end(), ValueType(0));
+    thrust::scatter(exec, partial.begin(), partial.begin() + num_rows, rows.begin(), sums.begin());
+}
+
+} // end namespace truncation
+
+template <typename DerivedPolicy,
+          typename MatrixType1,
+          typename MatrixType2>
+void truncate(thrust::execution_policy<DerivedPolicy> &exec,
+              const MatrixType1& A,
+                    MatrixType2& B,
+              const double theta,
+              const size_t max_entries,
+              const bool is_operator,
+              cusp::coo_format,
+              cusp::coo_format)
+{
+    using namespace cusp::precond::aggregation::detail::truncation;
+
+    typedef typename MatrixType2::index_type IndexType;
+    typedef typename MatrixType2::value_type ValueType;
+    typedef typename MatrixType2::memory_space MemorySpace;
+    typedef typename cusp::norm_type<ValueType>::type NormType;
+    typedef thrust::counting_iterator<IndexType> CountingIterator;
+
+    const size_t N = A.num_entries;
+
+    if(N == 0)
+    {
+        B.resize(A.num_rows, A.num_cols, 0);
+        return;
+    }
+
+    // magnitude of every entry and largest magnitude of every row
+    cusp::detail::temporary_array<NormType, DerivedPolicy> magnitude(exec, N);
+    cusp::detail::temporary_array<NormType, DerivedPolicy> threshold(exec, A.num_rows, NormType(0));
+
+    thrust::transform(exec,
+                      thrust::make_zip_iterator(thrust::make_tuple(A.row_indices.begin(), A.column_indices.begin(), A.values.begin())),
+                      thrust::make_zip_iterator(thrust::make_tuple(A.row_indices.end(),   A.column_indices.end(),   A.values.end())),
+                      magnitude.begin(),
+                      magnitude_functor<ValueType,NormType>(is_operator));
+
+    {
+        cusp::detail::temporary_array<IndexType, DerivedPolicy> rows(exec, N);
+        cusp::detail::temporary_array<NormType,  DerivedPolicy> row_max(exec, N);
+
+        size_t num_rows = thrust::reduce_by_key(exec,
+                                                A.row_indices.begin(), A.row_indices.end(),
+                                                magnitude.begin(),
+                                                rows.begin(), row_max.begin(),
+                                                thrust::equal_to<IndexType>(),
+                                                thrust::maximum<NormType>()).first - rows.begin();
+
+        thrust::transform(exec, row_max.begin(), row_max.begin() + num_rows,
+                          thrust::constant_iterator<NormType>(theta), row_max.begin(),
+                          thrust::multiplies<NormType>());
+        thrust::scatter(exec, row_max.begin(), row_max.begin() + num_rows, rows.begin(), threshold.begin());
+    }
+
+    // drop the entries below the threshold of their row
+    cusp::detail::temporary_array<bool, DerivedPolicy> keep(exec, N);
+
+    thrust::transform(exec, magnitude.begin(), magnitude.end(),
+                      thrust::make_permutation_iterator(threshold.begin(), A.row_indices.begin()),
+                      keep.begin(), keep_functor<NormType>());
+
+    // keep at most max_entries of the largest entries in every row, diagonal
+    // entries of operators sort last and do not count
+    if(max_entries > 0)
+    {
+        cusp::detail::temporary_array<IndexType, DerivedPolicy> permutation(exec, N);
+        cusp::detail::temporary_array<NormType,  DerivedPolicy> keys(exec, magnitude.begin(), magnitude.end());
+        cusp::detail::temporary_array<IndexType, DerivedPolicy> rows(exec, N);
+        cusp::detail::temporary_array<IndexType, DerivedPolicy> rank(exec, N);
+
+        thrust::sequence(exec, permutation.begin(), permutation.end());
+        thrust::stable_sort_by_key(exec, keys.begin(), keys.end(), permutation.begin(), thrust::greater<NormType>());
+        thrust::gather(exec, permutation.begin(), permutation.end(), A.row_indices.begin(), rows.begin());
+        thrust::stable_sort_by_key(exec, rows.begin(), rows.end(), permutation.begin());
+
+        thrust::exclusive_scan_by_key(exec, rows.begin(), rows.end(),
+                                      thrust::constant_iterator<IndexType>(1), rank.begin());
+
+        thrust::for_each(exec, CountingIterator(0), CountingIterator(N),
+                         limit_functor<IndexType,NormType>(thrust::raw_pointer_cast(&rank[0]),
+                                                           thrust::raw_pointer_cast(&permutation[0]),
+                                                           thrust::raw_pointer_cast(&magnitude[0]),
+                                                           thrust::raw_pointer_cast(&keep[0]),
+                                                           IndexType(max_entries)));
+    }
+
+    // preserve the row sums of the dropped entries
+    cusp::detail::temporary_array<ValueType, DerivedPolicy> dropped(exec, A.num_rows);
+    cusp::detail::temporary_array<ValueType, DerivedPolicy> values(exec, N);
+
+    row_sums(exec, A.row_indices, A.values, keep, false, dropped);
+
+    if(is_operator)
+    {
+        thrust::transform(exec,
+                          thrust::make_zip_iterator(thrust::make_tuple(A.row_indices.begin(), A.column_indices.begin(), A.values.begin())),
+                          thrust::make_zip_iterator(thrust::make_tuple(A.row_indices.end(),   A.column_indices.end(),   A.values.end())),
+                          values.begin(),
+                          lump_functor<IndexType,ValueType>(thrust::raw_pointer_cast(&dropped[0])));
+    }
+    else
+    {
+        cusp::detail::temporary_array<ValueType, DerivedPolicy> kept(exec, A.num_rows);
+
+        row_sums(exec, A.row_indices, A.values, keep, true, kept);
+
+        thrust::transform(exec, A.row_indices.begin(), A.row_indices.end(), A.values.begin(), values.begin(),
+                          rescale_functor<IndexType,ValueType>(thrust::raw_pointer_cast(&kept[0]),
+                                                               thrust::raw_pointer_cast(&dropped[0])));
+    }
+
+    // compact the kept entries, A and B may be the same matrix
+    const size_t num_entries = thrust::count(exec, keep.begin(), keep.end(), true);
+
+    cusp::coo_matrix<IndexType,ValueType,MemorySpace> temp(A.num_rows, A.num_cols, num_entries);
+
+    thrust::copy_if(exec,
+                    thrust::make_zip_iterator(thrust::make_tuple(A.row_indices.begin(), A.column_indices.begin(), values.begin())),
+                    thrust::make_zip_iterator(thrust::make_tuple(A.row_indices.end(),   A.column_indices.end(),   values.end())),
+                    keep.begin(),
+                    thrust::make_zip_iterator(thrust::make_tuple(temp.row_indices.begin(), temp.column_indices.begin(), temp.values.begin())),
+                    thrust::identity<bool>());
+
+    B.swap(temp);
+}
+
+template <typename DerivedPolicy,
+          typename MatrixType1,
+          typename MatrixType2,
+          typename Format1,
+          typename Format2>
+void truncate(thrust::execution_policy<DerivedPolicy> &exec,
+              const MatrixType1& A,
+                    MatrixType2& B,
+              const double theta,
+              const size_t max_entries,
+              const bool is_operator,
+              Format1,
+              Format2)
+{
+    typedef typename MatrixType1::const_coo_view_type CooViewType1;
+    typedef typename cusp::detail::as_coo_type<MatrixType2>::type CooType2;
+
+    CooViewType1 A_(A);
+    CooType2 B_;
+
+    truncate(exec, A_, B_, theta, max_entries, is_operator, cusp::coo_format(), cusp::coo_format());
+
+    cusp::convert(exec, B_, B);
+}
+
+template <typename DerivedPolicy,
+          typename MatrixType1,
+          typename MatrixType2>
+void truncate(thrust::execution_policy<DerivedPolicy> &exec,
+              const MatrixType1& A,
+                    MatrixType2& B,
+              const double theta,
+              const size_t max_entries,
+              const bool is_operator)
+{
+    typedef typename MatrixType1::format Format1;
+    typedef typename MatrixType2::format Format2;
+
+    Format1 format1;
+    Format2 format2;
+
+    truncate(exec, A, B, theta, max_entries, is_operator, format1, format2);
+}
+
+} // end namespace detail
+} // end namespace aggregation
+} // end namespace precond
+} // end namespace cusp
@@ -0,0 +1,79 @@
+/*
+ *  Copyright 2008-2014 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#pragma once
+
+#include <cusp/detail/config.h>
+
+#include <cusp/detail/execution_policy.h>
+
+namespace cusp
+{
+namespace precond
+{
+namespace aggregation
+{
+
+/* \cond */
+template <typename DerivedPolicy,
+          typename MatrixType1,
+          typename MatrixType2>
+void truncate_prolongator(const thrust::detail::execution_policy_base<DerivedPolicy> &exec,
+                          const MatrixType1& P,
+                                MatrixType2& P_truncated,
+                          const double theta,
+                          const size_t max_entries = 0);
+/* \endcond */
+
+//   Truncated prolongator. Entries of a row smaller than theta times the
+//   largest entry of the row are dropped and at most max_entries of the
+//   largest entries are kept (zero keeps all). The remaining entries are
+//   rescaled so every row keeps its original row sum.
+template <typename MatrixType1,
+          typename MatrixType2>
+void truncate_prolongator(const MatrixType1& P,
+                                MatrixType2& P_truncated,
+                          const double theta,
+                          const size_t max_entries = 0);
+
+/* \cond */
+template <typename DerivedPolicy,
+          typename MatrixType1,
+          typename MatrixType2>
+void truncate_operator(const thrust::detail::execution_policy_base<DerivedPolicy> &exec,
+                       const MatrixType1& A,
+                             MatrixType2& A_truncated,
+                       const double theta,
+                       const size_t max_entries = 0);
+/* \endcond */
+
+//   Truncated coarse operator. Off-diagonal entries of a row smaller than
+//   theta times the largest off-diagonal entry of the row are dropped and
+//   at most max_entries of the largest off-diagonal entries are kept (zero
+//   keeps all). The diagonal is always kept and the dropped entries are
+//   added to it so every row keeps its original row sum.
+template <typename MatrixType1,
+          typename MatrixType2>
+void truncate_operator(const MatrixType1& A,
+                             MatrixType2& A_truncated,
+                       const double theta,
+                       const size_t max_entries = 0);
+
+} // end namespace aggregation
+} // end namespace precond
+} // end namespace cusp
+
+#include <cusp/precond/aggregation/detail/truncate.inl>
@@ -16,6 +16,10 @@
 
 /*! \file ainv.h
  *  \brief Approximate Inverse (AINV) preconditioner.
+ *
+ *  The factors are computed on the host.  When compiled with OpenMP the row
+ *  updates of each outer product step are distributed across threads, which
+ *  yields the same factors as the sequential factorization.
  */
 
 #pragma once
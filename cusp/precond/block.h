@@ -0,0 +1,246 @@
+/*
+ *  Copyright 2008-2014 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*! \file block.h
+ *  \brief Block diagonal and block triangular preconditioners
+ */
+
+#pragma once
+
+#include <cusp/detail/config.h>
+
+#include <cusp/array1d.h>
+#include <cusp/linear_operator.h>
+
+#include <cusp/detail/block_structure.h>
+
+namespace cusp
+{
+namespace precond
+{
+
+/*! \addtogroup iterative_solvers Iterative Solvers
+ *  \addtogroup preconditioners Preconditioners
+ *  \ingroup iterative_solvers
+ *  \{
+ */
+
+/**
+ * \brief Block diagonal preconditioner assembled from one preconditioner
+ * per diagonal block
+ *
+ * \tparam ValueType Type used for the vector values (e.g. \c float).
+ * \tparam MemorySpace Memory space of the vectors and of the blocks.
+ *
+ * \par Overview
+ *  Block \c i approximates the inverse of the diagonal block \c A_ii of a
+ *  \p cusp::block_operator, for example a \p cusp::precond::diagonal or
+ *  an AMG hierarchy of \c A_ii, and the preconditioner applies
+ *  <tt>y_i = M_i x_i</tt>. The block applications are independent and
+ *  run at the same time like the products of a \p cusp::block_operator.
+ *  The preconditioner keeps references to the blocks.
+ *
+ * \par Example
+ *  \code
+ *  #include <cusp/block_operator.h>
+ *  #include <cusp/csr_matrix.h>
+ *  #include <cusp/gallery/poisson.h>
+ *  #include <cusp/krylov/gmres.h>
+ *  #include <cusp/monitor.h>
+ *  #include <cusp/precond/block.h>
+ *  #include <cusp/precond/diagonal.h>
+ *
+ *  int main(void)
+ *  {
+ *      typedef cusp::csr_matrix<int, float, cusp::device_memory> Matrix;
+ *
+ *      Matrix A, B;
+ *      cusp::gallery::poisson5pt(A, 64, 64);
+ *      cusp::gallery::poisson5pt(B, 32, 32);
+ *
+ *      cusp::block_operator<float, cusp::device_memory> K(2, 2);
+ *      K.set_block(0, 0, A);
+ *      K.set_block(1, 1, B);
+ *
+ *      cusp::precond::diagonal<float, cusp::device_memory> DA(A), DB(B);
+ *
+ *      cusp::precond::block_diagonal<float, cusp::device_memory> M(2);
+ *      M.set_block(0, DA);
+ *      M.set_block(1, DB);
+ *
+ *      cusp::array1d<float, cusp::device_memory> x(K.num_rows, 0), b(K.num_rows, 1);
+ *
+ *      cusp::monitor<float> monitor(b, 500, 1e-6);
+ *      cusp::krylov::gmres(K, x, b, 50, monitor, M);
+ *  }
+ *  \endcode
+ */
+template <typename ValueType, typename MemorySpace>
+class block_diagonal : public cusp::linear_operator<ValueType,MemorySpace>
+{
+  private:
+
+    typedef cusp::linear_operator<ValueType,MemorySpace>         Parent;
+    typedef cusp::detail::block_structure<ValueType,MemorySpace> Structure;
+
+  public:
+
+    /*! Construct a preconditioner with \p num_blocks diagonal blocks.
+     *
+     *  \throws cusp::invalid_input_exception if \p num_blocks is zero
+     */
+    block_diagonal(const size_t num_blocks);
+
+    /*! Number of diagonal blocks.
+     */
+    size_t num_blocks(void) const;
+
+    /*! Set diagonal block \p i to the square operator \p M.
+     *
+     *  \throws cusp::invalid_input_exception if \p i is out of range or
+     *  \p M is not square
+     */
+    template <typename Operator>
+    void set_block(const size_t i, const Operator& M);
+
+    /*! Apply the preconditioner to \p x and store the result in \p y.
+     *
+     *  \throws cusp::invalid_input_exception if a block is not set or the
+     *  sizes of \p x or \p y do not match
+     */
+    template <typename VectorType1, typename VectorType2>
+    void operator()(const VectorType1& x, VectorType2& y) const;
+
+  private:
+
+    /*! \cond */
+    Structure blocks;
+
+    mutable cusp::array1d<ValueType,MemorySpace> x_buffer;
+    mutable cusp::array1d<ValueType,MemorySpace> y_buffer;
+
+    block_diagonal(const block_diagonal&);
+    block_diagonal& operator=(const block_diagonal&);
+    /*! \endcond */
+};
+
+/**
+ * \brief Block triangular preconditioner applied by block substitution
+ *
+ * \tparam ValueType Type used for the vector values (e.g. \c float).
+ * \tparam MemorySpace Memory space of the vectors and of the blocks.
+ *
+ * \par Overview
+ *  The preconditioner approximates the inverse of a block lower or upper
+ *  triangular operator. Its diagonal blocks are given as approximate
+ *  inverses \c M_i, as for \p block_diagonal, and its off-diagonal blocks
+ *  \c B_ij as the coupling operators themselves. The lower variant
+ *  applies, for <tt>i = 0, 1, ...</tt>,
+ *
+ *  <tt>y_i = M_i (x_i - sum_{j < i} B_ij y_j)</tt>
+ *
+ *  and the upper variant runs the same substitution backwards over the
+ *  blocks <tt>j > i</tt>. This is, for instance, the block triangular
+ *  preconditioner of a saddle point system with \c M_1 an approximate
+ *  inverse of the Schur complement. The coupling products of a block row
+ *  are independent and run at the same time like the products of a
+ *  \p cusp::block_operator, before they are subtracted from \c x_i. The
+ *  preconditioner keeps references to the blocks.
+ *
+ * \par Example
+ *  \code
+ *  // [A   0] preconditioned with diag(A)^-1 and diag(S)^-1
+ *  // [B   S]
+ *  cusp::precond::block_triangular<float, cusp::device_memory> M(2);
+ *  M.set_diagonal(0, DA);
+ *  M.set_diagonal(1, DS);
+ *  M.set_block(1, 0, B);
+ *
+ *  cusp::krylov::gmres(K, x, b, 50, monitor, M);
+ *  \endcode
+ */
+template <typename ValueType, typename MemorySpace>
+class block_triangular : public cusp::linear_operator<ValueType,MemorySpace>
+{
+  private:
+
+    typedef cusp::linear_operator<ValueType,MemorySpace>         Parent;
+    typedef cusp::detail::block_structure<ValueType,MemorySpace> Structure;
+
+  public:
+
+    /*! Construct a preconditioner with \p num_blocks diagonal blocks,
+     *  block lower triangular unless \p lower is \c false.
+     *
+     *  \throws cusp::invalid_input_exception if \p num_blocks is zero
+     */
+    block_triangular(const size_t num_blocks, const bool lower = true);
+
+    /*! Number of diagonal blocks.
+     */
+    size_t num_blocks(void) const;
+
+    /*! Whether the preconditioner is block lower triangular.
+     */
+    bool is_lower(void) const;
+
+    /*! Set the approximate inverse \p M of diagonal block \p i.
+     *
+     *  \throws cusp::invalid_input_exception if \p i is out of range or
+     *  \p M is not square
+     */
+    template <typename Operator>
+    void set_diagonal(const size_t i, const Operator& M);
+
+    /*! Set the coupling block <tt>(i, j)</tt> to \p B, with <tt>j < i</tt>
+     *  for the lower and <tt>j > i</tt> for the upper variant.
+     *
+     *  \throws cusp::invalid_input_exception if the block is not strictly
+     *  in the triangle or its shape does not match the diagonal blocks
+     */
+    template <typename Operator>
+    void set_block(const size_t i, const size_t j, const Operator& B);
+
+    /*! Apply the preconditioner to \p x and store the result in \p y.
+     *
+     *  \throws cusp::invalid_input_exception if a diagonal block is not
+     *  set or the sizes of \p x or \p y do not match
+     */
+    template <typename VectorType1, typename VectorType2>
+    void operator()(const VectorType1& x, VectorType2& y) const;
+
+  private:
+
+    /*! \cond */
+    Structure blocks;
+    bool lower;
+
+    mutable cusp::array1d<ValueType,MemorySpace> workspace;
+    mutable cusp::array1d<ValueType,MemorySpace> residual;
+    mutable cusp::array1d<ValueType,MemorySpace> x_buffer;
+    mutable cusp::array1d<ValueType,MemorySpace> y_buffer;
+
+    block_triangular(const block_triangular&);
+    block_triangular& operator=(const block_triangular&);
+    /*! \endcond */
+};
+/*! \}
+ */
+
+} // end namespace precond
+} // end namespace cusp
+
+#include <cusp/precond/detail/block.inl>
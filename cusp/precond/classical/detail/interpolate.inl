@@ -0,0 +1,58 @@
+/*
+ *  Copyright 2008-2014 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+
+#include <cusp/detail/config.h>
+
+#include <cusp/precond/classical/system/detail/generic/extended_interpolation.h>
+
+namespace cusp
+{
+namespace precond
+{
+namespace classical
+{
+
+template <typename DerivedPolicy, typename MatrixType1, typename MatrixType2, typename ArrayType, typename MatrixType3>
+void extended_interpolation(const thrust::detail::execution_policy_base<DerivedPolicy> &exec,
+                            const MatrixType1& A, const MatrixType2& S, const ArrayType& splitting, MatrixType3& P)
+{
+    using cusp::precond::classical::detail::extended_interpolation;
+
+    extended_interpolation(thrust::detail::derived_cast(thrust::detail::strip_const(exec)), A, S, splitting, P);
+}
+
+template <typename MatrixType1, typename MatrixType2, typename ArrayType, typename MatrixType3>
+void extended_interpolation(const MatrixType1& A, const MatrixType2& S, const ArrayType& splitting, MatrixType3& P)
+{
+    using thrust::system::detail::generic::select_system;
+
+    typedef typename MatrixType1::memory_space System1;
+    typedef typename MatrixType2::memory_space System2;
+    typedef typename ArrayType::memory_space   System3;
+    typedef typename MatrixType3::memory_space System4;
+
+    System1 system1;
+    System2 system2;
+    System3 system3;
+    System4 system4;
+
+    cusp::precond::classical::extended_interpolation(select_system(system1,system2,system3,system4), A, S, splitting, P);
+}
+
+} // end namespace classical
+} // end namespace precond
+} // end namespace cusp
@@ -0,0 +1,101 @@
+/*
+ *  Copyright 2008-2014 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+
+#include <cusp/detail/config.h>
+
+#include <cusp/precond/classical/system/detail/generic/pmis_splitting.h>
+#include <cusp/precond/classical/system/detail/sequential/rs_splitting.h>
+
+namespace cusp
+{
+namespace precond
+{
+namespace classical
+{
+
+template <typename DerivedPolicy, typename MatrixType, typename ArrayType>
+void pmis_splitting(const thrust::detail::execution_policy_base<DerivedPolicy> &exec,
+                    const MatrixType& S, ArrayType& splitting)
+{
+    using cusp::precond::classical::detail::pmis_splitting;
+
+    pmis_splitting(thrust::detail::derived_cast(thrust::detail::strip_const(exec)), S, splitting);
+}
+
+template <typename MatrixType, typename ArrayType>
+void pmis_splitting(const MatrixType& S, ArrayType& splitting)
+{
+    using thrust::system::detail::generic::select_system;
+
+    typedef typename MatrixType::memory_space System1;
+    typedef typename ArrayType::memory_space  System2;
+
+    System1 system1;
+    System2 system2;
+
+    cusp::precond::classical::pmis_splitting(select_system(system1,system2), S, splitting);
+}
+
+template <typename DerivedPolicy, typename MatrixType, typename ArrayType>
+void hmis_splitting(const thrust::detail::execution_policy_base<DerivedPolicy> &exec,
+                    const MatrixType& S, ArrayType& splitting)
+{
+    using cusp::precond::classical::detail::hmis_splitting;
+
+    hmis_splitting(thrust::detail::derived_cast(thrust::detail::strip_const(exec)), S, splitting);
+}
+
+template <typename MatrixType, typename ArrayType>
+void hmis_splitting(const MatrixType& S, ArrayType& splitting)
+{
+    using thrust::system::detail::generic::select_system;
+
+    typedef typename MatrixType::memory_space System1;
+    typedef typename ArrayType::memory_space  System2;
+
+    System1 system1;
+    System2 system2;
+
+    cusp::precond::classical::hmis_splitting(select_system(system1,system2), S, splitting);
+}
+
+template <typename DerivedPolicy, typename MatrixType, typename ArrayType>
+void aggressive_splitting(const thrust::detail::execution_policy_base<DerivedPolicy> &exec,
+                          const MatrixType& S, ArrayType& splitting)
+{
+    using cusp::precond::classical::detail::aggressive_splitting;
+
+    aggressive_splitting(thrust::detail::derived_cast(thrust::detail::strip_const(exec)), S, splitting);
+}
+
+template <typename MatrixType, typename ArrayType>
+void aggressive_splitting(const MatrixType& S, ArrayType& splitting)
+{
+    using thrust::system::detail::generic::select_system;
+
+    typedef typename MatrixType::memory_space System1;
+    typedef typename ArrayType::memory_space  System2;
+
+    System1 system1;
+    System2 system2;
+
+    cusp::precond::classical::aggressive_splitting(select_system(system1,system2), S, splitting);
+}
+
+} // end namespace classical
+} // end namespace precond
+} // end namespace cusp
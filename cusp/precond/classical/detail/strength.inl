@@ -0,0 +1,54 @@
+/*
+ *  Copyright 2008-2014 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+
+#include <cusp/detail/config.h>
+
+#include <cusp/precond/classical/system/detail/generic/classical_strength.h>
+
+namespace cusp
+{
+namespace precond
+{
+namespace classical
+{
+
+template <typename DerivedPolicy, typename MatrixType1, typename MatrixType2>
+void classical_strength_of_connection(const thrust::detail::execution_policy_base<DerivedPolicy> &exec,
+                                      const MatrixType1& A, MatrixType2& S, const double theta)
+{
+    using cusp::precond::classical::detail::classical_strength_of_connection;
+
+    classical_strength_of_connection(thrust::detail::derived_cast(thrust::detail::strip_const(exec)), A, S, theta);
+}
+
+template <typename MatrixType1, typename MatrixType2>
+void classical_strength_of_connection(const MatrixType1& A, MatrixType2& S, const double theta)
+{
+    using thrust::system::detail::generic::select_system;
+
+    typedef typename MatrixType1::memory_space System1;
+    typedef typename MatrixType2::memory_space System2;
+
+    System1 system1;
+    System2 system2;
+
+    cusp::precond::classical::classical_strength_of_connection(select_system(system1,system2), A, S, theta);
+}
+
+} // end namespace classical
+} // end namespace precond
+} // end namespace cusp
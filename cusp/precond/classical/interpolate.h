@@ -0,0 +1,81 @@
+/*
+ *  Copyright 2008-2014 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+
+/*! \file interpolate.h
+ *  \brief Interpolation operators for classical algebraic multigrid
+ */
+
+#pragma once
+
+#include <cusp/detail/config.h>
+
+#include <cusp/detail/execution_policy.h>
+
+namespace cusp
+{
+namespace precond
+{
+namespace classical
+{
+
+/* \cond */
+template <typename DerivedPolicy,
+          typename MatrixType1,
+          typename MatrixType2,
+          typename ArrayType,
+          typename MatrixType3>
+void extended_interpolation(const thrust::detail::execution_policy_base<DerivedPolicy> &exec,
+                            const MatrixType1& A,
+                            const MatrixType2& S,
+                            const ArrayType& splitting,
+                                  MatrixType3& P);
+/* \endcond */
+
+/*  Compute the extended+i interpolation operator of De Sterck, Falgout,
+ *  Nolting and Yang. An F-point i interpolates from its strong C-points
+ *  and from the strong C-points of its strong F-points, with the weights
+ *
+ *     w_ij = -(a_ij + sum_k a_ik abar_kj / sum_l abar_kl) / (a_ii + ...)
+ *
+ *  where k runs over the strong F-points of i, l over the interpolatory
+ *  points of i and i itself, and abar_kl is a_kl if its sign is opposite
+ *  to a_kk and zero otherwise. Weak connections are lumped into the
+ *  diagonal. Including i in the sums keeps the weights bounded where
+ *  plain extended interpolation breaks down. C-points are injected.
+ *
+ *  The sparsity pattern of P is built with a sparse matrix product, the
+ *  weights of every row are computed independently.
+ *
+ *  \param A matrix in csr format with real values and sorted columns
+ *  \param S strength of connection matrix of A in csr format
+ *  \param splitting F_POINT or C_POINT for every row of A
+ *  \param P interpolation operator in csr format
+ */
+template <typename MatrixType1,
+          typename MatrixType2,
+          typename ArrayType,
+          typename MatrixType3>
+void extended_interpolation(const MatrixType1& A,
+                            const MatrixType2& S,
+                            const ArrayType& splitting,
+                                  MatrixType3& P);
+
+} // end namespace classical
+} // end namespace precond
+} // end namespace cusp
+
+#include <cusp/precond/classical/detail/interpolate.inl>
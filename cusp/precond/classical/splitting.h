@@ -0,0 +1,122 @@
+/*
+ *  Copyright 2008-2014 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+
+/*! \file splitting.h
+ *  \brief C/F splittings for classical algebraic multigrid
+ */
+
+#pragma once
+
+#include <cusp/detail/config.h>
+
+#include <cusp/detail/execution_policy.h>
+
+namespace cusp
+{
+namespace precond
+{
+namespace classical
+{
+
+/*! Labels of a C/F splitting: F-points are interpolated from the C-points,
+ *  which form the next coarser level in their original order.
+ */
+enum { F_POINT = 0, C_POINT = 1 };
+
+/* \cond */
+template <typename DerivedPolicy,
+          typename MatrixType,
+          typename ArrayType>
+void pmis_splitting(const thrust::detail::execution_policy_base<DerivedPolicy> &exec,
+                    const MatrixType& S,
+                          ArrayType& splitting);
+/* \endcond */
+
+/*  Compute a C/F splitting with the parallel modified independent set
+ *  (PMIS) algorithm of De Sterck, Yang and Heys. Every point is weighted
+ *  by the number of points that strongly depend on it plus a random
+ *  fraction, points that are heavier than all undecided strong neighbors
+ *  become C-points and the undecided points that strongly depend on them
+ *  become F-points, until every point is decided. Points that no other
+ *  point depends on are F-points from the start.
+ *
+ *  All rounds run in parallel, which makes PMIS the default coarsening on
+ *  the device.
+ *
+ *  \param S strength of connection matrix in csr format
+ *  \param splitting F_POINT or C_POINT for every row of S
+ */
+template <typename MatrixType,
+          typename ArrayType>
+void pmis_splitting(const MatrixType& S,
+                          ArrayType& splitting);
+
+/* \cond */
+template <typename DerivedPolicy,
+          typename MatrixType,
+          typename ArrayType>
+void hmis_splitting(const thrust::detail::execution_policy_base<DerivedPolicy> &exec,
+                    const MatrixType& S,
+                          ArrayType& splitting);
+/* \endcond */
+
+/*  Compute a C/F splitting with the hybrid modified independent set
+ *  (HMIS) algorithm, which runs the first pass of the sequential
+ *  Ruge-Stuben coarsening on every subdomain and hands the undecided
+ *  points on subdomain boundaries to PMIS. Here the whole matrix is a
+ *  single subdomain, so the first pass decides every point. It keeps more
+ *  C-points than PMIS, which improves the interpolation at a higher
+ *  operator complexity, and runs on the host, strength matrices in device
+ *  memory are copied to the host and back.
+ *
+ *  \param S strength of connection matrix in csr format
+ *  \param splitting F_POINT or C_POINT for every row of S
+ */
+template <typename MatrixType,
+          typename ArrayType>
+void hmis_splitting(const MatrixType& S,
+                          ArrayType& splitting);
+
+/* \cond */
+template <typename DerivedPolicy,
+          typename MatrixType,
+          typename ArrayType>
+void aggressive_splitting(const thrust::detail::execution_policy_base<DerivedPolicy> &exec,
+                          const MatrixType& S,
+                                ArrayType& splitting);
+/* \endcond */
+
+/*  Coarsen an existing C/F splitting a second time. Two C-points are
+ *  connected if they are joined by a path of at most two strong
+ *  connections and PMIS is applied to this graph, the C-points it does
+ *  not select become F-points. The resulting coarse level is several
+ *  times smaller, which lowers the operator complexity at the price of
+ *  slower convergence.
+ *
+ *  \param S strength of connection matrix in csr format
+ *  \param splitting C/F splitting of S, refined in place
+ */
+template <typename MatrixType,
+          typename ArrayType>
+void aggressive_splitting(const MatrixType& S,
+                                ArrayType& splitting);
+
+} // end namespace classical
+} // end namespace precond
+} // end namespace cusp
+
+#include <cusp/precond/classical/detail/splitting.inl>
@@ -0,0 +1,66 @@
+/*
+ *  Copyright 2008-2014 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+
+/*! \file strength.h
+ *  \brief Classical strength of connection measure
+ */
+
+#pragma once
+
+#include <cusp/detail/config.h>
+
+#include <cusp/detail/execution_policy.h>
+
+namespace cusp
+{
+namespace precond
+{
+namespace classical
+{
+
+/* \cond */
+template <typename DerivedPolicy,
+          typename MatrixType1,
+          typename MatrixType2>
+void classical_strength_of_connection(const thrust::detail::execution_policy_base<DerivedPolicy> &exec,
+                                      const MatrixType1& A,
+                                            MatrixType2& S,
+                                      const double theta = 0.25);
+/* \endcond */
+
+/*  Compute a strength of connection matrix using the classical Ruge-Stuben
+ *  measure. With s = sign(A[i,i]), an off-diagonal connection A[i,j] is
+ *  strong iff::
+ *
+ *     -s * A[i,j] >= theta * max_{k != i} (-s * A[i,k])  and  -s * A[i,j] > 0
+ *
+ *  The strong connections of row i are the points i depends on. Unlike the
+ *  aggregation measures the diagonal is not stored in S.
+ *
+ *  Note: S is a csr_matrix, A must hold real values.
+ */
+template <typename MatrixType1,
+          typename MatrixType2>
+void classical_strength_of_connection(const MatrixType1& A,
+                                            MatrixType2& S,
+                                      const double theta = 0.25);
+
+} // end namespace classical
+} // end namespace precond
+} // end namespace cusp
+
+#include <cusp/precond/classical/detail/strength.inl>
@@ -0,0 +1,194 @@
+/*
+ *  Copyright 2008-2014 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+
+#pragma once
+
+#include <cusp/detail/config.h>
+#include <cusp/detail/temporary_array.h>
+
+#include <cusp/detail/type_traits.h>
+
+#include <cusp/convert.h>
+#include <cusp/csr_matrix.h>
+
+#include <thrust/copy.h>
+#include <thrust/fill.h>
+#include <thrust/functional.h>
+#include <thrust/reduce.h>
+#include <thrust/scan.h>
+#include <thrust/transform.h>
+#include <thrust/iterator/counting_iterator.h>
+
+namespace cusp
+{
+namespace precond
+{
+namespace classical
+{
+namespace detail
+{
+
+// flags the strong connections of row i and returns their number
+template <typename IndexType, typename ValueType>
+struct classical_strength_functor
+{
+    const IndexType * row_offsets;
+    const IndexType * column_indices;
+    const ValueType * values;
+    bool * strong;
+    ValueType theta;
+
+    classical_strength_functor(const IndexType * row_offsets, const IndexType * column_indices,
+                               const ValueType * values, bool * strong, const ValueType theta)
+        : row_offsets(row_offsets), column_indices(column_indices), values(values), strong(strong), theta(theta) {}
+
+    __host__ __device__
+    IndexType operator()(const IndexType i) const
+    {
+        const IndexType row_start = row_offsets[i];
+        const IndexType row_end   = row_offsets[i + 1];
+
+        // couplings of opposite sign to the diagonal are the strong candidates
+        ValueType sign = ValueType(1);
+
+        for(IndexType jj = row_start; jj < row_end; jj++)
+            if(column_indices[jj] == i && values[jj] < ValueType(0))
+                sign = ValueType(-1);
+
+        ValueType max_coupling = ValueType(0);
+
+        for(IndexType jj = row_start; jj < row_end; jj++)
+        {
+            const ValueType coupling = -sign * values[jj];
+
+            if(column_indices[jj] != i && coupling > max_coupling)
+                max_coupling = coupling;
+        }
+
+        const ValueType threshold = theta * max_coupling;
+        IndexType num_strong = 0;
+
+        for(IndexType jj = row_start; jj < row_end; jj++)
+        {
+            const ValueType coupling = -sign * values[jj];
+            const bool is_strong = column_indices[jj] != i && coupling > ValueType(0) && coupling >= threshold;
+
+            strong[jj] = is_strong;
+            num_strong += is_strong;
+        }
+
+        return num_strong;
+    }
+};
+
+template <typename DerivedPolicy,
+          typename MatrixType1,
+          typename MatrixType2>
+void classical_strength_of_connection(thrust::execution_policy<DerivedPolicy> &exec,
+                                      const MatrixType1& A,
+                                            MatrixType2& S,
+                                      const double theta,
+                                      cusp::csr_format)
+{
+    typedef typename MatrixType1::index_type   IndexType;
+    typedef typename MatrixType1::value_type   ValueType;
+
+    const IndexType N = A.num_rows;
+
+    if(A.num_entries == 0)
+    {
+        S.resize(A.num_rows, A.num_cols, 0);
+        thrust::fill(exec, S.row_offsets.begin(), S.row_offsets.end(), IndexType(0));
+        return;
+    }
+
+    cusp::detail::temporary_array<IndexType, DerivedPolicy> row_counts(exec, N);
+    cusp::detail::temporary_array<bool, DerivedPolicy> strong(exec, A.num_entries);
+
+    classical_strength_functor<IndexType,ValueType> pred(thrust::raw_pointer_cast(&A.row_offsets[0]),
+                                                         thrust::raw_pointer_cast(&A.column_indices[0]),
+                                                         thrust::raw_pointer_cast(&A.values[0]),
+                                                         thrust::raw_pointer_cast(&strong[0]),
+                                                         ValueType(theta));
+
+    thrust::transform(exec,
+                      thrust::counting_iterator<IndexType>(0),
+                      thrust::counting_iterator<IndexType>(N),
+                      row_counts.begin(),
+                      pred);
+
+    // compute number of entries in output
+    IndexType num_entries = thrust::reduce(exec, row_counts.begin(), row_counts.end());
+
+    // resize output
+    S.resize(A.num_rows, A.num_cols, num_entries);
+
+    // row offsets are the running sum of strong connections per row
+    thrust::fill(exec, S.row_offsets.begin(), S.row_offsets.begin() + 1, IndexType(0));
+    thrust::inclusive_scan(exec, row_counts.begin(), row_counts.end(), S.row_offsets.begin() + 1);
+
+    // copy strong connections to output, preserving the row order
+    thrust::copy_if(exec,
+                    A.column_indices.begin(),
+                    A.column_indices.begin() + A.num_entries,
+                    strong.begin(),
+                    S.column_indices.begin(),
+                    thrust::identity<bool>());
+    thrust::copy_if(exec,
+                    A.values.begin(),
+                    A.values.begin() + A.num_entries,
+                    strong.begin(),
+                    S.values.begin(),
+                    thrust::identity<bool>());
+}
+
+template <typename DerivedPolicy,
+          typename MatrixType1,
+          typename MatrixType2>
+void classical_strength_of_connection(thrust::execution_policy<DerivedPolicy> &exec,
+                                      const MatrixType1& A,
+                                            MatrixType2& S,
+                                      const double theta,
+                                      cusp::known_format)
+{
+    typedef typename cusp::detail::as_csr_type<MatrixType1>::type CsrType;
+
+    CsrType A_csr;
+    cusp::convert(exec, A, A_csr);
+
+    classical_strength_of_connection(exec, A_csr, S, theta, cusp::csr_format());
+}
+
+template <typename DerivedPolicy,
+          typename MatrixType1,
+          typename MatrixType2>
+void classical_strength_of_connection(thrust::execution_policy<DerivedPolicy> &exec,
+                                      const MatrixType1& A,
+                                            MatrixType2& S,
+                                      const double theta)
+{
+    typedef typename MatrixType1::format Format;
+
+    Format format;
+
+    classical_strength_of_connection(thrust::detail::derived_cast(exec), A, S, theta, format);
+}
+
+} // end namespace detail
+} // end namespace classical
+} // end namespace precond
+} // end namespace cusp
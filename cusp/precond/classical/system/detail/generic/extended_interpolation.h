@@ -0,0 +1,391 @@
+/*
+ *  Copyright 2008-2014 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+
+#pragma once
+
+#include <cusp/detail/config.h>
+#include <cusp/detail/temporary_array.h>
+
+#include <cusp/detail/type_traits.h>
+
+#include <cusp/csr_matrix.h>
+#include <cusp/multiply.h>
+
+#include <thrust/copy.h>
+#include <thrust/fill.h>
+#include <thrust/for_each.h>
+#include <thrust/gather.h>
+#include <thrust/reduce.h>
+#include <thrust/scan.h>
+#include <thrust/transform.h>
+#include <thrust/iterator/counting_iterator.h>
+
+namespace cusp
+{
+namespace precond
+{
+namespace classical
+{
+namespace detail
+{
+namespace interpolation
+{
+
+// position of j in the sorted range [first, first + length) or -1
+template <typename IndexType>
+__host__ __device__
+IndexType find_column(const IndexType * first, const IndexType length, const IndexType j)
+{
+    IndexType lower = 0;
+    IndexType upper = length;
+
+    while(lower < upper)
+    {
+        const IndexType middle = lower + (upper - lower) / 2;
+
+        if(first[middle] < j)
+            lower = middle + 1;
+        else
+            upper = middle;
+    }
+
+    return (lower < length && first[lower] == j) ? lower : IndexType(-1);
+}
+
+// F-points map to their strong C-points, C-points to themselves. With
+// fine == true F-points map to themselves and their strong F-points.
+template <typename IndexType>
+struct neighbor_count_functor
+{
+    const IndexType * row_offsets;
+    const IndexType * column_indices;
+    const IndexType * splitting;
+    const bool fine;
+
+    neighbor_count_functor(const IndexType * row_offsets, const IndexType * column_indices,
+                           const IndexType * splitting, const bool fine)
+        : row_offsets(row_offsets), column_indices(column_indices), splitting(splitting), fine(fine) {}
+
+    __host__ __device__
+    IndexType operator()(const IndexType i) const
+    {
+        if(splitting[i] == C_POINT)
+            return 1;
+
+        IndexType count = fine ? 1 : 0;
+
+        for(IndexType jj = row_offsets[i]; jj < row_offsets[i + 1]; jj++)
+            count += (splitting[column_indices[jj]] == (fine ? F_POINT : C_POINT));
+
+        return count;
+    }
+};
+
+template <typename IndexType, typename ValueType>
+struct neighbor_fill_functor
+{
+    const IndexType * row_offsets;
+    const IndexType * column_indices;
+    const IndexType * splitting;
+    const IndexType * output_offsets;
+    IndexType * output_indices;
+    ValueType * output_values;
+    const bool fine;
+
+    neighbor_fill_functor(const IndexType * row_offsets, const IndexType * column_indices,
+                          const IndexType * splitting, const IndexType * output_offsets,
+                          IndexType * output_indices, ValueType * output_values, const bool fine)
+        : row_offsets(row_offsets), column_indices(column_indices), splitting(splitting),
+          output_offsets(output_offsets), output_indices(output_indices), output_values(output_values), fine(fine) {}
+
+    __host__ __device__
+    void operator()(const IndexType i) const
+    {
+        IndexType n = output_offsets[i];
+
+        if(splitting[i] == C_POINT)
+        {
+            output_indices[n] = i;
+            output_values[n]  = ValueType(1);
+            return;
+        }
+
+        // keep the columns sorted when adding i itself
+        bool pending = fine;
+
+        for(IndexType jj = row_offsets[i]; jj < row_offsets[i + 1]; jj++)
+        {
+            const IndexType j = column_indices[jj];
+
+            if(pending && j > i)
+            {
+                output_indices[n] = i;
+                output_values[n++] = ValueType(1);
+                pending = false;
+            }
+
+            if(splitting[j] == (fine ? F_POINT : C_POINT))
+            {
+                output_indices[n] = j;
+                output_values[n++] = ValueType(1);
+            }
+        }
+
+        if(pending)
+        {
+            output_indices[n] = i;
+            output_values[n] = ValueType(1);
+        }
+    }
+};
+
+// extended+i weights of row i, the columns of P are still fine indices
+template <typename IndexType, typename ValueType>
+struct extended_weight_functor
+{
+    const IndexType * A_row_offsets;
+    const IndexType * A_column_indices;
+    const ValueType * A_values;
+    const IndexType * S_row_offsets;
+    const IndexType * S_column_indices;
+    const IndexType * splitting;
+    const IndexType * P_row_offsets;
+    const IndexType * P_column_indices;
+    ValueType * P_values;
+
+    extended_weight_functor(const IndexType * A_row_offsets, const IndexType * A_column_indices, const ValueType * A_values,
+                            const IndexType * S_row_offsets, const IndexType * S_column_indices,
+                            const IndexType * splitting,
+                            const IndexType * P_row_offsets, const IndexType * P_column_indices, ValueType * P_values)
+        : A_row_offsets(A_row_offsets), A_column_indices(A_column_indices), A_values(A_values),
+          S_row_offsets(S_row_offsets), S_column_indices(S_column_indices),
+          splitting(splitting),
+          P_row_offsets(P_row_offsets), P_column_indices(P_column_indices), P_values(P_values) {}
+
+    // a_kl if its sign is opposite to the diagonal of row k, zero otherwise
+    __host__ __device__
+    ValueType opposite(const ValueType a_kl, const ValueType a_kk) const
+    {
+        return (a_kl * a_kk < ValueType(0)) ? a_kl : ValueType(0);
+    }
+
+    __host__ __device__
+    void operator()(const IndexType i) const
+    {
+        const IndexType   P_start  = P_row_offsets[i];
+        const IndexType   P_length = P_row_offsets[i + 1] - P_start;
+        const IndexType * columns  = P_column_indices + P_start;
+        ValueType       * weights  = P_values + P_start;
+
+        if(splitting[i] == C_POINT)
+        {
+            weights[0] = ValueType(1);
+            return;
+        }
+
+        for(IndexType n = 0; n < P_length; n++)
+            weights[n] = ValueType(0);
+
+        const IndexType S_start  = S_row_offsets[i];
+        const IndexType S_length = S_row_offsets[i + 1] - S_start;
+
+        ValueType diagonal = ValueType(0);
+
+        for(IndexType jj = A_row_offsets[i]; jj < A_row_offsets[i + 1]; jj++)
+        {
+            const IndexType k    = A_column_indices[jj];
+            const ValueType a_ik = A_values[jj];
+
+            if(k == i)
+            {
+                diagonal += a_ik;
+                continue;
+            }
+
+            // direct connection to an interpolatory point
+            const IndexType n = find_column(columns, P_length, k);
+
+            if(n >= 0)
+            {
+                weights[n] += a_ik;
+                continue;
+            }
+
+            // weak connections and strong connections to F-points that
+            // cannot be distributed are lumped into the diagonal
+            if(splitting[k] != F_POINT || find_column(S_column_indices + S_start, S_length, k) < 0)
+            {
+                diagonal += a_ik;
+                continue;
+            }
+
+            ValueType a_kk = ValueType(0);
+
+            for(IndexType ll = A_row_offsets[k]; ll < A_row_offsets[k + 1]; ll++)
+                if(A_column_indices[ll] == k)
+                    a_kk += A_values[ll];
+
+            ValueType sum = ValueType(0);
+
+            for(IndexType ll = A_row_offsets[k]; ll < A_row_offsets[k + 1]; ll++)
+            {
+                const IndexType l = A_column_indices[ll];
+
+                if(l != k && (l == i || find_column(columns, P_length, l) >= 0))
+                    sum += opposite(A_values[ll], a_kk);
+            }
+
+            if(sum == ValueType(0))
+            {
+                diagonal += a_ik;
+                continue;
+            }
+
+            // distribute a_ik over the interpolatory points of k and i
+            const ValueType scale = a_ik / sum;
+
+            for(IndexType ll = A_row_offsets[k]; ll < A_row_offsets[k + 1]; ll++)
+            {
+                const IndexType l = A_column_indices[ll];
+
+                if(l == k)
+                    continue;
+
+                const ValueType a_kl = opposite(A_values[ll], a_kk);
+
+                if(l == i)
+                {
+                    diagonal += scale * a_kl;
+                }
+                else
+                {
+                    const IndexType m = find_column(columns, P_length, l);
+
+                    if(m >= 0)
+                        weights[m] += scale * a_kl;
+                }
+            }
+        }
+
+        // rows without a usable diagonal are not interpolated
+        const ValueType scale = (diagonal == ValueType(0)) ? ValueType(0) : -ValueType(1) / diagonal;
+
+        for(IndexType n = 0; n < P_length; n++)
+            weights[n] *= scale;
+    }
+};
+
+} // end namespace interpolation
+
+template <typename DerivedPolicy,
+          typename MatrixType1,
+          typename MatrixType2,
+          typename ArrayType,
+          typename MatrixType3>
+void extended_interpolation(thrust::execution_policy<DerivedPolicy> &exec,
+                            const MatrixType1& A,
+                            const MatrixType2& S,
+                            const ArrayType& splitting,
+                                  MatrixType3& P)
+{
+    using namespace interpolation;
+
+    typedef typename MatrixType1::index_type IndexType;
+    typedef typename MatrixType1::value_type ValueType;
+    typedef typename MatrixType1::memory_space MemorySpace;
+    typedef cusp::csr_matrix<IndexType,ValueType,MemorySpace> CsrType;
+    typedef thrust::counting_iterator<IndexType> CountingIterator;
+
+    const IndexType N = A.num_rows;
+
+    CountingIterator first(0);
+    CountingIterator last(N);
+
+    // C-points are numbered in their original order
+    const IndexType num_coarse = thrust::reduce(exec, splitting.begin(), splitting.begin() + N, IndexType(0));
+
+    if(num_coarse == 0)
+    {
+        P.resize(N, 0, 0);
+        thrust::fill(exec, P.row_offsets.begin(), P.row_offsets.end(), IndexType(0));
+        return;
+    }
+
+    cusp::detail::temporary_array<IndexType, DerivedPolicy> coarse_index(exec, N);
+    thrust::exclusive_scan(exec, splitting.begin(), splitting.begin() + N, coarse_index.begin());
+
+    const IndexType * Sp = thrust::raw_pointer_cast(&S.row_offsets[0]);
+    const IndexType * Sj = S.num_entries == 0 ? NULL : thrust::raw_pointer_cast(&S.column_indices[0]);
+    const IndexType * splitting_ptr = thrust::raw_pointer_cast(&splitting[0]);
+
+    // the interpolatory points of i are the columns of row i of E * B,
+    // where B maps F-points to their strong C-points and E maps F-points
+    // to themselves and their strong F-points
+    CsrType E, B;
+
+    for(int pass = 0; pass < 2; pass++)
+    {
+        const bool fine = pass == 0;
+        CsrType& M = fine ? E : B;
+
+        cusp::detail::temporary_array<IndexType, DerivedPolicy> row_counts(exec, N);
+
+        thrust::transform(exec, first, last, row_counts.begin(),
+                          neighbor_count_functor<IndexType>(Sp, Sj, splitting_ptr, fine));
+
+        const IndexType num_entries = thrust::reduce(exec, row_counts.begin(), row_counts.end());
+
+        M.resize(N, N, num_entries);
+        thrust::fill(exec, M.row_offsets.begin(), M.row_offsets.begin() + 1, IndexType(0));
+        thrust::inclusive_scan(exec, row_counts.begin(), row_counts.end(), M.row_offsets.begin() + 1);
+
+        if(num_entries > 0)
+            thrust::for_each(exec, first, last,
+                             neighbor_fill_functor<IndexType,ValueType>(Sp, Sj, splitting_ptr,
+                                                                        thrust::raw_pointer_cast(&M.row_offsets[0]),
+                                                                        thrust::raw_pointer_cast(&M.column_indices[0]),
+                                                                        thrust::raw_pointer_cast(&M.values[0]),
+                                                                        fine));
+    }
+
+    CsrType pattern;
+    cusp::multiply(exec, E, B, pattern);
+
+    // rows of pattern are sorted, the weights are computed in fine indices
+    P.resize(N, num_coarse, pattern.num_entries);
+    thrust::copy(exec, pattern.row_offsets.begin(), pattern.row_offsets.end(), P.row_offsets.begin());
+
+    if(pattern.num_entries == 0)
+        return;
+
+    thrust::for_each(exec, first, last,
+                     extended_weight_functor<IndexType,ValueType>(thrust::raw_pointer_cast(&A.row_offsets[0]),
+                                                                  thrust::raw_pointer_cast(&A.column_indices[0]),
+                                                                  thrust::raw_pointer_cast(&A.values[0]),
+                                                                  Sp, Sj, splitting_ptr,
+                                                                  thrust::raw_pointer_cast(&pattern.row_offsets[0]),
+                                                                  thrust::raw_pointer_cast(&pattern.column_indices[0]),
+                                                                  thrust::raw_pointer_cast(&P.values[0])));
+
+    thrust::gather(exec, pattern.column_indices.begin(), pattern.column_indices.end(),
+                   coarse_index.begin(), P.column_indices.begin());
+}
+
+} // end namespace detail
+} // end namespace classical
+} // end namespace precond
+} // end namespace cusp
@@ -0,0 +1,382 @@
+/*
+ *  Copyright 2008-2014 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+
+#pragma once
+
+#include <cusp/detail/config.h>
+#include <cusp/detail/temporary_array.h>
+
+#include <cusp/detail/type_traits.h>
+
+#include <cusp/array1d.h>
+#include <cusp/copy.h>
+#include <cusp/csr_matrix.h>
+#include <cusp/elementwise.h>
+#include <cusp/multiply.h>
+#include <cusp/transpose.h>
+#include <cusp/iterator/random_iterator.h>
+
+#include <thrust/copy.h>
+#include <thrust/count.h>
+#include <thrust/fill.h>
+#include <thrust/functional.h>
+#include <thrust/reduce.h>
+#include <thrust/scan.h>
+#include <thrust/transform.h>
+#include <thrust/iterator/counting_iterator.h>
+
+#include <cusp/precond/classical/system/detail/sequential/rs_splitting.h>
+
+namespace cusp
+{
+namespace precond
+{
+namespace classical
+{
+namespace detail
+{
+namespace pmis
+{
+
+enum { UNDECIDED = 2 };
+
+typedef unsigned long long KeyType;
+
+// number of strong dependents in the upper half, a random fraction below
+template <typename IndexType>
+struct weight_functor
+{
+    const IndexType * dependent_offsets;
+    cusp::detail::random_integer_functor<IndexType,unsigned int> hash;
+
+    weight_functor(const IndexType * dependent_offsets, const size_t seed)
+        : dependent_offsets(dependent_offsets), hash(seed) {}
+
+    __host__ __device__
+    KeyType operator()(const IndexType i) const
+    {
+        const KeyType num_dependents = dependent_offsets[i + 1] - dependent_offsets[i];
+
+        return (num_dependents << 32) | KeyType(hash(i));
+    }
+};
+
+// points nobody depends on are F-points, existing F-points stay F-points
+// and isolated points keep their label if keep_isolated is set
+template <typename IndexType>
+struct initial_state_functor
+{
+    const IndexType * row_offsets;
+    const IndexType * dependent_offsets;
+    const IndexType * splitting;
+    const bool keep_isolated;
+
+    initial_state_functor(const IndexType * row_offsets, const IndexType * dependent_offsets,
+                          const IndexType * splitting, const bool keep_isolated)
+        : row_offsets(row_offsets), dependent_offsets(dependent_offsets),
+          splitting(splitting), keep_isolated(keep_isolated) {}
+
+    __host__ __device__
+    IndexType operator()(const IndexType i) const
+    {
+        if(splitting != NULL && splitting[i] == F_POINT)
+            return F_POINT;
+
+        if(dependent_offsets[i] != dependent_offsets[i + 1])
+            return UNDECIDED;
+
+        if(keep_isolated && row_offsets[i] == row_offsets[i + 1])
+            return C_POINT;
+
+        return F_POINT;
+    }
+};
+
+// undecided points heavier than all undecided strong neighbors in either
+// direction become C-points, ties are broken by the index
+template <typename IndexType>
+struct select_functor
+{
+    const IndexType * row_offsets;
+    const IndexType * column_indices;
+    const IndexType * dependent_offsets;
+    const IndexType * dependents;
+    const KeyType * weights;
+    const IndexType * states;
+
+    select_functor(const IndexType * row_offsets, const IndexType * column_indices,
+                   const IndexType * dependent_offsets, const IndexType * dependents,
+                   const KeyType * weights, const IndexType * states)
+        : row_offsets(row_offsets), column_indices(column_indices),
+          dependent_offsets(dependent_offsets), dependents(dependents),
+          weights(weights), states(states) {}
+
+    __host__ __device__
+    bool dominated(const IndexType i, const IndexType j) const
+    {
+        return states[j] == UNDECIDED &&
+               (weights[j] > weights[i] || (weights[j] == weights[i] && j > i));
+    }
+
+    __host__ __device__
+    IndexType operator()(const IndexType i) const
+    {
+        if(states[i] != UNDECIDED)
+            return states[i];
+
+        for(IndexType jj = row_offsets[i]; jj < row_offsets[i + 1]; jj++)
+            if(dominated(i, column_indices[jj]))
+                return UNDECIDED;
+
+        for(IndexType jj = dependent_offsets[i]; jj < dependent_offsets[i + 1]; jj++)
+            if(dominated(i, dependents[jj]))
+                return UNDECIDED;
+
+        return C_POINT;
+    }
+};
+
+// undecided points that strongly depend on a C-point become F-points
+template <typename IndexType>
+struct reject_functor
+{
+    const IndexType * row_offsets;
+    const IndexType * column_indices;
+    const IndexType * states;
+
+    reject_functor(const IndexType * row_offsets, const IndexType * column_indices, const IndexType * states)
+        : row_offsets(row_offsets), column_indices(column_indices), states(states) {}
+
+    __host__ __device__
+    IndexType operator()(const IndexType i) const
+    {
+        if(states[i] != UNDECIDED)
+            return states[i];
+
+        for(IndexType jj = row_offsets[i]; jj < row_offsets[i + 1]; jj++)
+            if(states[column_indices[jj]] == C_POINT)
+                return F_POINT;
+
+        return UNDECIDED;
+    }
+};
+
+// flags the connections between two distinct C-points
+template <typename IndexType>
+struct coarse_connection_functor
+{
+    const IndexType * row_offsets;
+    const IndexType * column_indices;
+    const IndexType * splitting;
+    bool * keep;
+
+    coarse_connection_functor(const IndexType * row_offsets, const IndexType * column_indices,
+                              const IndexType * splitting, bool * keep)
+        : row_offsets(row_offsets), column_indices(column_indices), splitting(splitting), keep(keep) {}
+
+    __host__ __device__
+    IndexType operator()(const IndexType i) const
+    {
+        IndexType num_kept = 0;
+
+        for(IndexType jj = row_offsets[i]; jj < row_offsets[i + 1]; jj++)
+        {
+            const IndexType j = column_indices[jj];
+            const bool is_kept = splitting[i] == C_POINT && splitting[j] == C_POINT && i != j;
+
+            keep[jj] = is_kept;
+            num_kept += is_kept;
+        }
+
+        return num_kept;
+    }
+};
+
+} // end namespace pmis
+
+// decides every undecided point of states, which is overwritten in place
+template <typename DerivedPolicy,
+          typename MatrixType1,
+          typename MatrixType2,
+          typename ArrayType>
+void pmis_rounds(thrust::execution_policy<DerivedPolicy> &exec,
+                 const MatrixType1& S,
+                 const MatrixType2& St,
+                       ArrayType& states)
+{
+    using namespace pmis;
+
+    typedef typename MatrixType1::index_type IndexType;
+    typedef thrust::counting_iterator<IndexType> CountingIterator;
+
+    const IndexType N = S.num_rows;
+
+    cusp::detail::temporary_array<KeyType,   DerivedPolicy> weights(exec, N);
+    cusp::detail::temporary_array<IndexType, DerivedPolicy> selected(exec, N);
+
+    const IndexType * Sp = thrust::raw_pointer_cast(&S.row_offsets[0]);
+    const IndexType * Sj = thrust::raw_pointer_cast(&S.column_indices[0]);
+    const IndexType * Tp = thrust::raw_pointer_cast(&St.row_offsets[0]);
+    const IndexType * Tj = thrust::raw_pointer_cast(&St.column_indices[0]);
+
+    KeyType   * weights_ptr  = thrust::raw_pointer_cast(&weights[0]);
+    IndexType * states_ptr   = thrust::raw_pointer_cast(&states[0]);
+    IndexType * selected_ptr = thrust::raw_pointer_cast(&selected[0]);
+
+    CountingIterator first(0);
+    CountingIterator last(N);
+
+    thrust::transform(exec, first, last, weights_ptr, weight_functor<IndexType>(Tp, 0));
+
+    // the heaviest undecided point is selected in every round
+    while(thrust::count(exec, states_ptr, states_ptr + N, IndexType(UNDECIDED)) > 0)
+    {
+        thrust::transform(exec, first, last, selected_ptr, select_functor<IndexType>(Sp, Sj, Tp, Tj, weights_ptr, states_ptr));
+        thrust::transform(exec, first, last, states_ptr, reject_functor<IndexType>(Sp, Sj, selected_ptr));
+    }
+}
+
+template <typename DerivedPolicy,
+          typename MatrixType,
+          typename ArrayType>
+void pmis_splitting(thrust::execution_policy<DerivedPolicy> &exec,
+                    const MatrixType& S,
+                          ArrayType& splitting)
+{
+    using namespace pmis;
+
+    typedef typename MatrixType::index_type IndexType;
+    typedef typename cusp::detail::as_csr_type<MatrixType>::type CsrType;
+    typedef thrust::counting_iterator<IndexType> CountingIterator;
+
+    const IndexType N = S.num_rows;
+
+    // without strong connections every point is an F-point
+    if(S.num_entries == 0)
+    {
+        thrust::fill(exec, splitting.begin(), splitting.begin() + N, IndexType(F_POINT));
+        return;
+    }
+
+    // row i of St lists the points that strongly depend on i
+    CsrType St;
+    cusp::transpose(exec, S, St);
+
+    cusp::detail::temporary_array<IndexType, DerivedPolicy> states(exec, N);
+
+    thrust::transform(exec, CountingIterator(0), CountingIterator(N), states.begin(),
+                      initial_state_functor<IndexType>(thrust::raw_pointer_cast(&S.row_offsets[0]),
+                                                       thrust::raw_pointer_cast(&St.row_offsets[0]),
+                                                       (const IndexType *) NULL, false));
+
+    pmis_rounds(exec, S, St, states);
+
+    thrust::copy(exec, states.begin(), states.end(), splitting.begin());
+}
+
+template <typename DerivedPolicy,
+          typename MatrixType,
+          typename ArrayType>
+void aggressive_splitting(thrust::execution_policy<DerivedPolicy> &exec,
+                          const MatrixType& S,
+                                ArrayType& splitting)
+{
+    using namespace pmis;
+
+    typedef typename MatrixType::index_type IndexType;
+    typedef typename MatrixType::value_type ValueType;
+    typedef typename cusp::detail::as_csr_type<MatrixType>::type CsrType;
+    typedef thrust::counting_iterator<IndexType> CountingIterator;
+
+    const IndexType N = S.num_rows;
+
+    if(S.num_entries == 0)
+        return;
+
+    // paths of length one and two in the strength graph
+    CsrType S1(S);
+    thrust::fill(exec, S1.values.begin(), S1.values.end(), ValueType(1));
+
+    CsrType S1S1;
+    cusp::multiply(exec, S1, S1, S1S1);
+
+    CsrType paths;
+    cusp::elementwise(exec, S1, S1S1, paths, thrust::plus<ValueType>());
+
+    // restrict the paths to pairs of distinct C-points
+    cusp::detail::temporary_array<IndexType, DerivedPolicy> row_counts(exec, N);
+    cusp::detail::temporary_array<bool, DerivedPolicy> keep(exec, paths.num_entries);
+
+    const IndexType * splitting_ptr = thrust::raw_pointer_cast(&splitting[0]);
+
+    thrust::transform(exec, CountingIterator(0), CountingIterator(N), row_counts.begin(),
+                      coarse_connection_functor<IndexType>(thrust::raw_pointer_cast(&paths.row_offsets[0]),
+                                                           thrust::raw_pointer_cast(&paths.column_indices[0]),
+                                                           splitting_ptr,
+                                                           thrust::raw_pointer_cast(&keep[0])));
+
+    IndexType num_entries = thrust::reduce(exec, row_counts.begin(), row_counts.end());
+
+    // C-points that are far apart all stay C-points
+    if(num_entries == 0)
+        return;
+
+    CsrType S2(N, N, num_entries);
+    thrust::fill(exec, S2.row_offsets.begin(), S2.row_offsets.begin() + 1, IndexType(0));
+    thrust::inclusive_scan(exec, row_counts.begin(), row_counts.end(), S2.row_offsets.begin() + 1);
+    thrust::copy_if(exec, paths.column_indices.begin(), paths.column_indices.end(), keep.begin(),
+                    S2.column_indices.begin(), thrust::identity<bool>());
+    thrust::copy_if(exec, paths.values.begin(), paths.values.end(), keep.begin(),
+                    S2.values.begin(), thrust::identity<bool>());
+
+    CsrType S2t;
+    cusp::transpose(exec, S2, S2t);
+
+    cusp::detail::temporary_array<IndexType, DerivedPolicy> states(exec, N);
+
+    thrust::transform(exec, CountingIterator(0), CountingIterator(N), states.begin(),
+                      initial_state_functor<IndexType>(thrust::raw_pointer_cast(&S2.row_offsets[0]),
+                                                       thrust::raw_pointer_cast(&S2t.row_offsets[0]),
+                                                       splitting_ptr, true));
+
+    pmis_rounds(exec, S2, S2t, states);
+
+    thrust::copy(exec, states.begin(), states.end(), splitting.begin());
+}
+
+template <typename DerivedPolicy,
+          typename MatrixType,
+          typename ArrayType>
+void hmis_splitting(thrust::execution_policy<DerivedPolicy> &exec,
+                    const MatrixType& S,
+                          ArrayType& splitting)
+{
+    typedef typename MatrixType::index_type IndexType;
+    typedef typename MatrixType::value_type ValueType;
+
+    cusp::csr_matrix<IndexType,ValueType,cusp::host_memory> S_csr(S);
+    cusp::array1d<IndexType, cusp::host_memory> splitting_host(splitting);
+
+    cusp::precond::classical::hmis_splitting(S_csr, splitting_host);
+
+    cusp::copy(splitting_host, splitting);
+}
+
+} // end namespace detail
+} // end namespace classical
+} // end namespace precond
+} // end namespace cusp
@@ -0,0 +1,127 @@
+/*
+ *  Copyright 2008-2014 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+
+#pragma once
+
+#include <cusp/detail/config.h>
+
+#include <cusp/array1d.h>
+#include <cusp/csr_matrix.h>
+#include <cusp/transpose.h>
+
+#include <cusp/system/detail/sequential/execution_policy.h>
+
+#include <queue>
+#include <utility>
+#include <vector>
+
+namespace cusp
+{
+namespace precond
+{
+namespace classical
+{
+namespace detail
+{
+
+// first pass of the Ruge-Stuben coarsening, the point with the largest
+// number of undecided dependents becomes a C-point in every step
+template <typename DerivedPolicy,
+          typename MatrixType,
+          typename ArrayType>
+void hmis_splitting(thrust::cpp::execution_policy<DerivedPolicy> &exec,
+                    const MatrixType& S,
+                          ArrayType& splitting)
+{
+    typedef typename MatrixType::index_type IndexType;
+    typedef typename MatrixType::value_type ValueType;
+    typedef std::pair<IndexType,IndexType> Entry;
+
+    enum { UNDECIDED = 2 };
+
+    const IndexType N = S.num_rows;
+
+    // row i of St lists the points that strongly depend on i
+    cusp::csr_matrix<IndexType,ValueType,cusp::host_memory> St;
+    cusp::transpose(exec, S, St);
+
+    std::vector<IndexType> lambda(N);
+    std::priority_queue<Entry> queue;
+
+    for(IndexType i = 0; i < N; i++)
+    {
+        splitting[i] = UNDECIDED;
+        lambda[i] = St.row_offsets[i + 1] - St.row_offsets[i];
+        queue.push(Entry(lambda[i], i));
+    }
+
+    while(!queue.empty())
+    {
+        const Entry top = queue.top();
+        queue.pop();
+
+        const IndexType i = top.second;
+
+        // skip decided points and outdated weights
+        if(splitting[i] != UNDECIDED || top.first != lambda[i])
+            continue;
+
+        // the remaining points influence no undecided point
+        if(lambda[i] == 0)
+            break;
+
+        splitting[i] = C_POINT;
+
+        // undecided dependents of i become F-points, which makes the
+        // points they depend on more attractive C-points
+        for(IndexType jj = St.row_offsets[i]; jj < St.row_offsets[i + 1]; jj++)
+        {
+            const IndexType j = St.column_indices[jj];
+
+            if(splitting[j] != UNDECIDED)
+                continue;
+
+            splitting[j] = F_POINT;
+
+            for(IndexType kk = S.row_offsets[j]; kk < S.row_offsets[j + 1]; kk++)
+            {
+                const IndexType k = S.column_indices[kk];
+
+                if(splitting[k] == UNDECIDED)
+                    queue.push(Entry(++lambda[k], k));
+            }
+        }
+
+        // i no longer needs to be interpolated by the points it depends on
+        for(IndexType jj = S.row_offsets[i]; jj < S.row_offsets[i + 1]; jj++)
+        {
+            const IndexType j = S.column_indices[jj];
+
+            if(splitting[j] == UNDECIDED && lambda[j] > 0)
+                queue.push(Entry(--lambda[j], j));
+        }
+    }
+
+    for(IndexType i = 0; i < N; i++)
+        if(splitting[i] == UNDECIDED)
+            splitting[i] = F_POINT;
+}
+
+} // end namespace detail
+} // end namespace classical
+} // end namespace precond
+} // end namespace cusp
@@ -0,0 +1,255 @@
+/*
+ *  Copyright 2008-2014 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+
+/*! \file classical_amg.h
+ *  \brief Classical Ruge-Stuben algebraic multigrid preconditioner.
+ *
+ */
+
+#pragma once
+
+#include <cusp/detail/config.h>
+#include <cusp/detail/multilevel.h>
+#include <cusp/detail/execution_policy.h>
+
+#include <cusp/array1d.h>
+#include <cusp/csr_matrix.h>
+
+#include <thrust/detail/use_default.h>
+
+#include <vector>
+
+namespace cusp
+{
+namespace precond
+{
+namespace classical
+{
+
+/* \cond */
+template<typename MatrixType>
+struct classical_level
+{
+    public:
+
+    typedef typename MatrixType::index_type IndexType;
+    typedef typename MatrixType::value_type ValueType;
+    typedef typename MatrixType::memory_space MemorySpace;
+
+    MatrixType A_;                                        // matrix
+    cusp::array1d<IndexType,MemorySpace> splitting;       // C/F splitting
+
+    size_t    num_iters;
+    ValueType rho_DinvA;
+
+    classical_level(void) : num_iters(1), rho_DinvA(0) {}
+
+    template<typename LevelType>
+    classical_level(const LevelType& L)
+      : A_(L.A_),
+        splitting(L.splitting),
+        num_iters(L.num_iters),
+        rho_DinvA(L.rho_DinvA)
+    {}
+};
+/* \endcond */
+
+} // end namespace classical
+
+/*! \addtogroup iterative_solvers Iterative Solvers
+ *  \addtogroup preconditioners Preconditioners
+ *  \ingroup iterative_solvers
+ *  \{
+ */
+
+/*! Coarsening used by \p classical_amg to split the points of every level
+ *  into C-points and F-points. \c PMIS_COARSENING runs entirely in
+ *  parallel and yields the smallest coarse levels, \c HMIS_COARSENING
+ *  runs the first Ruge-Stuben pass on the host and keeps more C-points for
+ *  faster convergence.
+ */
+typedef enum
+{
+    PMIS_COARSENING,
+    HMIS_COARSENING
+} coarsening_type;
+
+/**
+ *  \brief Classical Ruge-Stuben algebraic multigrid preconditioner
+ *
+ *  \tparam IndexType Type used for matrix values (e.g. \c int or \c size_t).
+ *  \tparam ValueType Type used for matrix values (e.g. \c float or \c double).
+ *  \tparam MemorySpace A memory space (e.g. \c cusp::host_memory or \c cusp::device_memory)
+ *
+ *  \par Overview
+ *  Given a matrix \c A to precondition, the classical AMG preconditioner
+ *  splits the unknowns of every level into coarse (C) and fine (F) points
+ *  based on the classical strength of connection. The C-points form the
+ *  next level and the F-points are interpolated from them with
+ *  extended+i interpolation, the coarse matrix is the Galerkin product
+ *  <tt>R A P</tt> with <tt>R = P^T</tt>.
+ *
+ *  Classical AMG is often more robust than smoothed aggregation for
+ *  problems with strong anisotropies or convection, where the piecewise
+ *  constant tentative prolongators of aggregation converge poorly. The
+ *  default configuration uses a strength threshold of 0.25, PMIS
+ *  coarsening, Jacobi relaxation on each level of hierarchy and LU to
+ *  solve the coarse matrix in host memory. The first
+ *  \c num_aggressive_levels levels are coarsened a second time and
+ *  interpolate in two stages through the C-points of the first splitting,
+ *  which lowers the operator complexity and the memory footprint at the
+ *  price of slower convergence.
+ *
+ *  \note \c A must hold real values.
+ *
+ *  \par Example
+ *  The following code snippet demonstrates how to use a
+ *  \p classical_amg preconditioner to solve a linear system.
+ *
+ *  \code
+ *  #include <cusp/csr_matrix.h>
+ *  #include <cusp/gallery/poisson.h>
+ *  #include <cusp/krylov/cg.h>
+ *  #include <cusp/precond/classical_amg.h>
+ *
+ *  int main(int argc, char *argv[])
+ *  {
+ *      typedef int                 IndexType;
+ *      typedef double              ValueType;
+ *      typedef cusp::device_memory MemorySpace;
+ *
+ *      cusp::csr_matrix<IndexType, ValueType, MemorySpace> A;
+ *      cusp::gallery::poisson5pt(A, 256, 256);
+ *
+ *      // strength threshold 0.25, PMIS coarsening and one aggressive level
+ *      cusp::precond::classical_amg<IndexType, ValueType, MemorySpace>
+ *          M(A, 0.25, cusp::precond::PMIS_COARSENING, 1);
+ *
+ *      // print AMG statistics
+ *      M.print();
+ *
+ *      cusp::array1d<ValueType, MemorySpace> x(A.num_rows, 0);
+ *      cusp::array1d<ValueType, MemorySpace> b(A.num_rows, 1);
+ *
+ *      cusp::monitor<ValueType> monitor(b, 1000, 1e-10);
+ *      cusp::krylov::cg(A, x, b, monitor, M);
+ *
+ *      monitor.print();
+ *
+ *      return 0;
+ *  }
+ *  \endcode
+ */
+template <typename IndexType,
+          typename ValueType,
+          typename MemorySpace,
+          typename SmootherType = thrust::use_default,
+          typename SolverType   = thrust::use_default,
+          typename Format       = thrust::use_default>
+class classical_amg :
+    public cusp::multilevel<IndexType,ValueType,MemorySpace,Format,SmootherType,SolverType>::container
+{
+  private:
+
+    typedef cusp::csr_matrix<IndexType,ValueType,MemorySpace> SetupMatrixType;
+    typedef typename cusp::multilevel<IndexType,ValueType,MemorySpace,Format,SmootherType,SolverType>::container ML;
+
+  public:
+
+    /* \cond */
+    std::vector< classical::classical_level<SetupMatrixType> > cl_levels;
+    /* \endcond */
+
+    /*! Threshold of the classical strength of connection measure. */
+    double theta;
+
+    /*! Coarsening algorithm used on every level. */
+    coarsening_type coarsening;
+
+    /*! Number of finest levels that are coarsened aggressively. */
+    size_t num_aggressive_levels;
+
+    /**
+     * Construct an empty \p classical_amg preconditioner.
+     */
+    classical_amg(void)
+      : ML(), theta(0.25), coarsening(PMIS_COARSENING), num_aggressive_levels(0) {};
+
+    /*! Construct a \p classical_amg preconditioner from a matrix.
+     *
+     *  \param A matrix used to create the AMG hierarchy.
+     *  \param theta strength of connection threshold.
+     *  \param coarsening coarsening algorithm.
+     *  \param num_aggressive_levels number of finest levels that are
+     *  coarsened aggressively.
+     */
+    template <typename MatrixType>
+    classical_amg(const MatrixType& A,
+                  const double theta = 0.25,
+                  const coarsening_type coarsening = PMIS_COARSENING,
+                  const size_t num_aggressive_levels = 0);
+
+    /*! Construct a \p classical_amg preconditioner from an existing
+     * \p classical_amg preconditioner.
+     *
+     *  \param M other classical_amg preconditioner.
+     */
+    template <typename MemorySpace2,
+              typename SmootherType2,
+              typename SolverType2,
+              typename Format2>
+    classical_amg(const classical_amg<IndexType,ValueType,MemorySpace2,SmootherType2,SolverType2,Format2>& M);
+
+    /*! Initialize a \p classical_amg preconditioner from a matrix using the
+     * current parameters. Used to initialize a \p classical_amg
+     * preconditioner constructed with no input matrix specified.
+     *
+     *  \param A matrix used to create the AMG hierarchy.
+     */
+    template <typename MatrixType>
+    void initialize(const MatrixType& A);
+
+    /* \cond */
+    template <typename DerivedPolicy,
+              typename MatrixType>
+    void initialize(const thrust::detail::execution_policy_base<DerivedPolicy> &exec,
+                    const MatrixType& A);
+    /* \endcond */
+
+protected:
+
+    /* \cond */
+    template <typename DerivedPolicy,
+              typename MatrixType>
+    bool extend_hierarchy(const thrust::detail::execution_policy_base<DerivedPolicy> &exec,
+                          const MatrixType& A);
+
+    template <typename DerivedPolicy,
+              typename MatrixType>
+    void aggressive_interpolation(const thrust::detail::execution_policy_base<DerivedPolicy> &exec,
+                                  const MatrixType& A,
+                                  const SetupMatrixType& S,
+                                        SetupMatrixType& P);
+    /* \endcond */
+};
+/*! \}
+ */
+
+} // end namespace precond
+} // end namespace cusp
+
+#include <cusp/precond/detail/classical_amg.inl>
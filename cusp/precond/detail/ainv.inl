@@ -345,23 +345,66 @@ void vector_add_inplace_drop(detail::ainv_matrix_row<IndexType, ValueType> &resu
     }
 }
 
+// apply the updates of step j to every later row i with u_i != 0, that is
+// factor[i] += -(u_i / p) * factor[j]
+//
+// each update reads only the finished row j and writes a distinct row i, so
+// the rows are updated concurrently when OpenMP is enabled.  The sequence of
+// updates applied to any one row is unchanged, hence the factors are identical
+// to the sequential outer product sweep.
+template<typename IndexType, typename ValueType, typename ToleranceType>
+void update_later_rows(std::vector<detail::ainv_matrix_row<IndexType, ValueType> > &factor,
+                       const csr_matrix<IndexType, ValueType, host_memory> &A,
+                       IndexType j, const std::map<IndexType, ValueType> &u, ValueType p,
+                       ToleranceType tolerance, int nonzero_per_row, bool lin_dropping, int lin_param)
+{
+    std::vector<IndexType> rows;
+    std::vector<ValueType> mults;
+
+    for (typename std::map<IndexType, ValueType>::const_iterator u_iter = u.upper_bound(j); u_iter != u.end(); ++u_iter) {
+        rows.push_back(u_iter->first);
+        mults.push_back(-u_iter->second/p);
+    }
+
+    const int num_updates = rows.size();
+
+#ifdef _OPENMP
+    #pragma omp parallel for schedule(dynamic, 4) if(num_updates > 8)
+#endif
+    for (int k = 0; k < num_updates; k++) {
+        IndexType i = rows[k];
+        int row_count = nonzero_per_row;
+        if (lin_dropping) {
+            row_count = lin_param + (int) (A.row_offsets[i+1] - A.row_offsets[i]);
+            if (row_count < 1) row_count = 1;
+        }
+
+        detail::vector_add_inplace_drop(factor[i], mults[k], factor[j], (ValueType) tolerance, row_count);
+    }
+}
+
 template<typename IndexTypeA, typename ValueTypeA, typename IndexTypeB, typename ValueTypeB, typename MemorySpaceB>
 void convert_to_device_csr(const std::vector<detail::ainv_matrix_row<IndexTypeA, ValueTypeA> > &src, cusp::hyb_matrix<IndexTypeB, ValueTypeB, MemorySpaceB> &dst)
 {
     // convert wt to csr
-    IndexTypeA nnz = 0;
     IndexTypeA n = src.size();
 
+    cusp::array1d<IndexTypeA, host_memory> row_offsets(n + 1);
+    row_offsets[0] = 0;
+
     int i;
     for (i=0; i < n; i++)
-        nnz += src[i].size();
-
-    cusp::csr_matrix<IndexTypeA, ValueTypeA, host_memory> host_src(n, n, nnz);
+        row_offsets[i+1] = row_offsets[i] + src[i].size();
 
-    IndexTypeA pos = 0;
-    host_src.row_offsets[0] = 0;
+    cusp::csr_matrix<IndexTypeA, ValueTypeA, host_memory> host_src(n, n, row_offsets[n]);
+    host_src.row_offsets = row_offsets;
 
+    // every row owns a disjoint range of the output
+#ifdef _OPENMP
+    #pragma omp parallel for
+#endif
     for (i=0; i < n; i++) {
+        IndexTypeA pos = row_offsets[i];
         typename detail::ainv_matrix_row<IndexTypeA, ValueTypeA>::const_iterator src_iter = src[i].begin();
         while (src_iter != src[i].end()) {
             host_src.column_indices[pos] = src_iter->first;
@@ -370,7 +413,6 @@ void convert_to_device_csr(const std::vector<detail::ainv_matrix_row<IndexTypeA,
             ++src_iter;
             ++pos;
         }
-        host_src.row_offsets[i+1] = pos;
     }
 
     // copy to device & transpose
@@ -424,28 +466,8 @@ nonsym_bridson_ainv<ValueType,MemorySpace>
 
         // for i = j+1 to n, skipping where u_i == 0
         // this should be a O(1)-time operation, since u is a sparse vector
-        for (typename std::map<typename MatrixTypeA::index_type,typename MatrixTypeA::value_type>::const_iterator u_iter = u.upper_bound(j); u_iter != u.end(); ++u_iter) {
-            i = u_iter->first;
-            int row_count = nonzero_per_row;
-            if (lin_dropping) {
-                row_count = lin_param + (int) (host_A.row_offsets[i+1] - host_A.row_offsets[i]);
-                if (row_count < 1) row_count = 1;
-            }
-
-            detail::vector_add_inplace_drop(z_factor[i], -u_iter->second/p, z_factor[j], drop_tolerance, row_count);
-        }
-
-        for (typename std::map<typename MatrixTypeA::index_type,typename MatrixTypeA::value_type>::const_iterator l_iter = l.upper_bound(j); l_iter != l.end(); ++l_iter) {
-            i = l_iter->first;
-            int row_count = nonzero_per_row;
-            if (lin_dropping) {
-                row_count = lin_param + (int) (host_A.row_offsets[i+1] - host_A.row_offsets[i]);
-                if (row_count < 1) row_count = 1;
-            }
-
-            detail::vector_add_inplace_drop(wt_factor[i], -l_iter->second/p, wt_factor[j], drop_tolerance, row_count);
-        }
-
+        detail::update_later_rows(z_factor, host_A, j, u, p, drop_tolerance, nonzero_per_row, lin_dropping, lin_param);
+        detail::update_later_rows(wt_factor, host_A, j, l, p, drop_tolerance, nonzero_per_row, lin_dropping, lin_param);
     }
 
     // copy w_factor into w, w_t
@@ -506,16 +528,7 @@ bridson_ainv<ValueType,MemorySpace>
 
         // for i = j+1 to n, skipping where u_i == 0
         // this should be a O(1)-time operation, since u is a sparse vector
-        for (typename std::map<typename MatrixTypeA::index_type,typename MatrixTypeA::value_type>::const_iterator u_iter = u.upper_bound(j); u_iter != u.end(); ++u_iter) {
-            i = u_iter->first;
-            int row_count = nonzero_per_row;
-            if (lin_dropping) {
-                row_count = lin_param + (int) (host_A.row_offsets[i+1] - host_A.row_offsets[i]);
-                if (row_count < 1) row_count = 1;
-            }
-
-            detail::vector_add_inplace_drop(w_factor[i], -u_iter->second/p, w_factor[j], drop_tolerance, row_count);
-        }
+        detail::update_later_rows(w_factor, host_A, j, u, p, drop_tolerance, nonzero_per_row, lin_dropping, lin_param);
 
     }
 
@@ -569,15 +582,7 @@ scaled_bridson_ainv<ValueType,MemorySpace>
 
         // for i = j+1 to n, skipping where u_i == 0
         // this should be a O(1)-time operation, since u is a sparse vector
-        for (typename std::map<typename MatrixTypeA::index_type,typename MatrixTypeA::value_type>::const_iterator u_iter = u.upper_bound(j); u_iter != u.end(); ++u_iter) {
-            i = u_iter->first;
-            int row_count = nonzero_per_row;
-            if (lin_dropping) {
-                row_count = lin_param + (int) (host_A.row_offsets[i+1] - host_A.row_offsets[i]);
-                if (row_count < 1) row_count = 1;
-            }
-            detail::vector_add_inplace_drop(w_factor[i], -u_iter->second, w_factor[j], drop_tolerance, row_count);
-        }
+        detail::update_later_rows(w_factor, host_A, j, u, (typename MatrixTypeA::value_type) 1, drop_tolerance, nonzero_per_row, lin_dropping, lin_param);
 
     }
 
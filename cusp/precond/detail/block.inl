@@ -0,0 +1,243 @@
+/*
+ *  Copyright 2008-2014 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include <cusp/blas/blas.h>
+#include <cusp/exception.h>
+
+#include <algorithm>
+#include <vector>
+
+namespace cusp
+{
+namespace precond
+{
+
+////////////////////
+// block_diagonal //
+////////////////////
+
+template <typename ValueType, typename MemorySpace>
+block_diagonal<ValueType,MemorySpace>
+::block_diagonal(const size_t num_blocks)
+    : Parent(), blocks(num_blocks, num_blocks, "block_diagonal")
+{
+}
+
+template <typename ValueType, typename MemorySpace>
+size_t
+block_diagonal<ValueType,MemorySpace>
+::num_blocks(void) const
+{
+    return blocks.num_block_rows();
+}
+
+template <typename ValueType, typename MemorySpace>
+template <typename Operator>
+void
+block_diagonal<ValueType,MemorySpace>
+::set_block(const size_t i, const Operator& M)
+{
+    if (M.num_rows != M.num_cols)
+        throw cusp::invalid_input_exception("block_diagonal: blocks must be square");
+
+    blocks.set(i, i, M);
+
+    Parent::resize(blocks.num_rows(), blocks.num_cols(), blocks.num_entries());
+}
+
+template <typename ValueType, typename MemorySpace>
+template <typename VectorType1, typename VectorType2>
+void
+block_diagonal<ValueType,MemorySpace>
+::operator()(const VectorType1& x, VectorType2& y) const
+{
+    typedef typename Structure::view       View;
+    typedef typename Structure::const_view ConstView;
+    typedef typename Structure::product    Product;
+
+    for (size_t i = 0; i < num_blocks(); i++)
+        if (blocks.block(i, i) == 0)
+            throw cusp::invalid_input_exception("block_diagonal: every diagonal block must be set");
+
+    if (x.size() != Parent::num_cols || y.size() != Parent::num_rows)
+        throw cusp::invalid_input_exception("block_diagonal: vector sizes do not match the preconditioner");
+
+    const ConstView x_view = cusp::detail::block_input<VectorType1,ConstView>(x, x_buffer);
+    View y_view = cusp::detail::block_output<VectorType2,View>(y, y_buffer);
+
+    std::vector<Product> products;
+
+    for (size_t i = 0; i < num_blocks(); i++)
+        products.push_back(Product(blocks.block(i, i),
+                                   blocks.col_segment(x_view, i),
+                                   blocks.row_segment(y_view, i)));
+
+    blocks.run(products);
+
+    cusp::detail::block_writeback(y, y_buffer,
+        typename cusp::detail::block_output_compatible<VectorType2,View>::type());
+}
+
+//////////////////////
+// block_triangular //
+//////////////////////
+
+template <typename ValueType, typename MemorySpace>
+block_triangular<ValueType,MemorySpace>
+::block_triangular(const size_t num_blocks, const bool lower)
+    : Parent(), blocks(num_blocks, num_blocks, "block_triangular"), lower(lower)
+{
+}
+
+template <typename ValueType, typename MemorySpace>
+size_t
+block_triangular<ValueType,MemorySpace>
+::num_blocks(void) const
+{
+    return blocks.num_block_rows();
+}
+
+template <typename ValueType, typename MemorySpace>
+bool
+block_triangular<ValueType,MemorySpace>
+::is_lower(void) const
+{
+    return lower;
+}
+
+template <typename ValueType, typename MemorySpace>
+template <typename Operator>
+void
+block_triangular<ValueType,MemorySpace>
+::set_diagonal(const size_t i, const Operator& M)
+{
+    if (M.num_rows != M.num_cols)
+        throw cusp::invalid_input_exception("block_triangular: diagonal blocks must be square");
+
+    blocks.set(i, i, M);
+
+    Parent::resize(blocks.num_rows(), blocks.num_cols(), blocks.num_entries());
+}
+
+template <typename ValueType, typename MemorySpace>
+template <typename Operator>
+void
+block_triangular<ValueType,MemorySpace>
+::set_block(const size_t i, const size_t j, const Operator& B)
+{
+    if ((lower && j >= i) || (!lower && j <= i))
+        throw cusp::invalid_input_exception("block_triangular: coupling blocks must be strictly inside the triangle");
+
+    blocks.set(i, j, B);
+
+    Parent::resize(blocks.num_rows(), blocks.num_cols(), blocks.num_entries());
+}
+
+template <typename ValueType, typename MemorySpace>
+template <typename VectorType1, typename VectorType2>
+void
+block_triangular<ValueType,MemorySpace>
+::operator()(const VectorType1& x, VectorType2& y) const
+{
+    typedef typename Structure::view       View;
+    typedef typename Structure::const_view ConstView;
+    typedef typename Structure::product    Product;
+
+    const size_t n = num_blocks();
+
+    for (size_t i = 0; i < n; i++)
+        if (blocks.block(i, i) == 0)
+            throw cusp::invalid_input_exception("block_triangular: every diagonal block must be set");
+
+    if (x.size() != Parent::num_cols || y.size() != Parent::num_rows)
+        throw cusp::invalid_input_exception("block_triangular: vector sizes do not match the preconditioner");
+
+    const ConstView x_view = cusp::detail::block_input<VectorType1,ConstView>(x, x_buffer);
+    View y_view = cusp::detail::block_output<VectorType2,View>(y, y_buffer);
+
+    // the couplings of one block row are computed side by side
+    size_t workspace_size = 0;
+    size_t residual_size  = 0;
+
+    for (size_t i = 0; i < n; i++)
+    {
+        size_t num_couplings = 0;
+
+        for (size_t j = 0; j < n; j++)
+            if (j != i && blocks.block(i, j) != 0)
+                num_couplings++;
+
+        workspace_size = std::max(workspace_size, num_couplings * blocks.row_size(i));
+        residual_size  = std::max(residual_size, blocks.row_size(i));
+    }
+
+    workspace.resize(workspace_size);
+    residual.resize(residual_size);
+
+    for (size_t step = 0; step < n; step++)
+    {
+        const size_t i = lower ? step : n - 1 - step;
+        const size_t row_size = blocks.row_size(i);
+
+        std::vector<Product> products;
+        std::vector<View> partials;
+
+        size_t position = 0;
+
+        // the solved segments y_j precede block row i in the substitution
+        for (size_t j = 0; j < n; j++)
+        {
+            if (j == i || blocks.block(i, j) == 0)
+                continue;
+
+            View partial(workspace.begin() + position, workspace.begin() + position + row_size);
+            position += row_size;
+
+            products.push_back(Product(blocks.block(i, j), blocks.col_segment(ConstView(y_view.begin(), y_view.end()), j), partial));
+            partials.push_back(partial);
+        }
+
+        std::vector<Product> diagonal;
+
+        if (products.empty())
+        {
+            diagonal.push_back(Product(blocks.block(i, i),
+                                       blocks.row_segment(x_view, i),
+                                       blocks.row_segment(y_view, i)));
+        }
+        else
+        {
+            blocks.run(products);
+
+            View r(residual.begin(), residual.begin() + row_size);
+            cusp::blas::copy(blocks.row_segment(x_view, i), r);
+
+            for (size_t k = 0; k < partials.size(); k++)
+                cusp::blas::axpy(partials[k], r, ValueType(-1));
+
+            diagonal.push_back(Product(blocks.block(i, i), ConstView(r.begin(), r.end()),
+                                       blocks.row_segment(y_view, i)));
+        }
+
+        blocks.run(diagonal);
+    }
+
+    cusp::detail::block_writeback(y, y_buffer,
+        typename cusp::detail::block_output_compatible<VectorType2,View>::type());
+}
+
+} // end namespace precond
+} // end namespace cusp
@@ -0,0 +1,236 @@
+/*
+ *  Copyright 2008-2014 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+
+#include <cusp/convert.h>
+#include <cusp/multiply.h>
+#include <cusp/transpose.h>
+
+#include <cusp/detail/timer.h>
+
+#include <cusp/precond/aggregation/galerkin_product.h>
+#include <cusp/precond/classical/interpolate.h>
+#include <cusp/precond/classical/splitting.h>
+#include <cusp/precond/classical/strength.h>
+
+#include <thrust/copy.h>
+#include <thrust/functional.h>
+
+namespace cusp
+{
+namespace precond
+{
+
+template <typename IndexType, typename ValueType, typename MemorySpace, typename SmootherType, typename SolverType, typename Format>
+template <typename MatrixType>
+classical_amg<IndexType,ValueType,MemorySpace,SmootherType,SolverType,Format>
+::classical_amg(const MatrixType& A, const double theta,
+                const coarsening_type coarsening, const size_t num_aggressive_levels)
+    : ML(), theta(theta), coarsening(coarsening), num_aggressive_levels(num_aggressive_levels)
+{
+    initialize(A);
+}
+
+template <typename IndexType, typename ValueType, typename MemorySpace, typename SmootherType, typename SolverType, typename Format>
+template <typename MemorySpace2, typename SmootherType2, typename SolverType2, typename Format2>
+classical_amg<IndexType,ValueType,MemorySpace,SmootherType,SolverType,Format>
+::classical_amg(const classical_amg<IndexType,ValueType,MemorySpace2,SmootherType2,SolverType2,Format2>& M)
+    : ML(M), theta(M.theta), coarsening(M.coarsening), num_aggressive_levels(M.num_aggressive_levels)
+{
+    for( size_t lvl = 0; lvl < M.cl_levels.size(); lvl++ )
+        cl_levels.push_back(M.cl_levels[lvl]);
+}
+
+template <typename IndexType, typename ValueType, typename MemorySpace, typename SmootherType, typename SolverType, typename Format>
+template <typename MatrixType>
+void classical_amg<IndexType,ValueType,MemorySpace,SmootherType,SolverType,Format>
+::initialize(const MatrixType& A)
+{
+    using thrust::system::detail::generic::select_system;
+
+    typedef typename MatrixType::memory_space System;
+
+    System system;
+
+    initialize(select_system(system), A);
+}
+
+template <typename IndexType, typename ValueType, typename MemorySpace, typename SmootherType, typename SolverType, typename Format>
+template <typename DerivedPolicy, typename MatrixType>
+void classical_amg<IndexType,ValueType,MemorySpace,SmootherType,SolverType,Format>
+::initialize(const thrust::detail::execution_policy_base<DerivedPolicy> &exec,
+             const MatrixType& A)
+{
+    typedef typename ML::level Level;
+
+    if(cl_levels.size() > 0)
+    {
+        cl_levels.resize(0);
+        ML::levels.resize(0);
+    }
+
+    ML::clear_setup_times();
+    ML::resize(A.num_rows, A.num_cols, A.num_entries);
+    ML::levels.reserve(ML::max_levels); // avoid reallocations which force matrix copies
+    ML::levels.push_back(Level());
+
+    cl_levels.push_back(classical::classical_level<SetupMatrixType>());
+
+    // the setup works on rows, so the first level is converted to csr
+    SetupMatrixType A_;
+    cusp::convert(exec, A, A_);
+
+    if(A.num_rows > ML::min_level_size)
+        extend_hierarchy(exec, A_);
+
+    // Iteratively setup lower levels until stopping criteria are reached
+    while ((cl_levels.back().A_.num_rows > ML::min_level_size) &&
+            (cl_levels.size() < ML::max_levels))
+        if(!extend_hierarchy(exec, cl_levels.back().A_))
+            break;
+
+    // Setup multilevel arrays and matrices on each level
+    ML::setup_level(0, A, cl_levels[0]);
+
+    for( size_t lvl = 1; lvl < cl_levels.size(); lvl++ )
+        ML::setup_level(lvl, cl_levels[lvl].A_, cl_levels[lvl]);
+
+    // a matrix that could not be coarsened is solved directly
+    if(cl_levels.size() == 1)
+        ML::copy_or_swap_matrix(ML::levels[0].A, A_);
+
+    // Initialize coarse solver
+    ML::initialize_coarse_solver();
+}
+
+template <typename IndexType, typename ValueType, typename MemorySpace, typename SmootherType, typename SolverType, typename Format>
+template <typename DerivedPolicy, typename MatrixType>
+bool classical_amg<IndexType,ValueType,MemorySpace,SmootherType,SolverType,Format>
+::extend_hierarchy(const thrust::detail::execution_policy_base<DerivedPolicy> &exec,
+                   const MatrixType& A)
+{
+    typedef typename ML::level Level;
+
+    classical::classical_level<SetupMatrixType>& L = cl_levels.back();
+
+    // the phases are attributed to the level being coarsened
+    const size_t lvl = cl_levels.size() - 1;
+
+    // compute strength of connection matrix
+    cusp::detail::timer t("amg strength");
+    SetupMatrixType S;
+    classical::classical_strength_of_connection(exec, A, S, theta);
+    ML::add_setup_time("strength", t.seconds_elapsed(), lvl);
+
+    // split the points into C-points and F-points
+    t.restart("amg coarsening");
+    L.splitting.resize(A.num_rows);
+
+    if(coarsening == HMIS_COARSENING)
+        classical::hmis_splitting(exec, S, L.splitting);
+    else
+        classical::pmis_splitting(exec, S, L.splitting);
+    ML::add_setup_time("coarsening", t.seconds_elapsed(), lvl);
+
+    // compute interpolation operator
+    t.restart("amg interpolation");
+    SetupMatrixType P;
+    classical::extended_interpolation(exec, A, S, L.splitting, P);
+    ML::add_setup_time("interpolation", t.seconds_elapsed(), lvl);
+
+    // stop if the level did not coarsen
+    if(P.num_cols == 0 || P.num_cols == A.num_rows)
+        return false;
+
+    // aggressive levels interpolate in two stages, from the C-points of
+    // the first splitting to the C-points they keep after the second one
+    if(cl_levels.size() <= num_aggressive_levels)
+    {
+        t.restart("amg aggressive coarsening");
+        aggressive_interpolation(exec, A, S, P);
+        ML::add_setup_time("aggressive coarsening", t.seconds_elapsed(), lvl);
+    }
+
+    // compute restriction operator (transpose of interpolation)
+    t.restart("amg restriction");
+    SetupMatrixType R;
+    cusp::transpose(exec, P, R);
+    ML::add_setup_time("restriction", t.seconds_elapsed(), lvl);
+
+    // construct Galerkin product R*A*P
+    t.restart("amg galerkin product");
+    SetupMatrixType RAP;
+    cusp::precond::aggregation::galerkin_product(exec, R, A, P, RAP);
+    ML::add_setup_time("galerkin product", t.seconds_elapsed(), lvl);
+
+    // Setup components for next level in hierarchy
+    cl_levels.push_back(classical::classical_level<SetupMatrixType>());
+    cl_levels.back().A_.swap(RAP);
+
+    ML::copy_or_swap_matrix(ML::levels.back().R, R);
+    ML::copy_or_swap_matrix(ML::levels.back().P, P);
+    ML::levels.push_back(Level());
+
+    return true;
+}
+
+template <typename IndexType, typename ValueType, typename MemorySpace, typename SmootherType, typename SolverType, typename Format>
+template <typename DerivedPolicy, typename MatrixType>
+void classical_amg<IndexType,ValueType,MemorySpace,SmootherType,SolverType,Format>
+::aggressive_interpolation(const thrust::detail::execution_policy_base<DerivedPolicy> &exec,
+                           const MatrixType& A,
+                           const SetupMatrixType& S,
+                                 SetupMatrixType& P)
+{
+    classical::classical_level<SetupMatrixType>& L = cl_levels.back();
+
+    // the phases are attributed to the level being coarsened
+    const size_t lvl = cl_levels.size() - 1;
+
+    cusp::array1d<IndexType,MemorySpace> splitting(L.splitting);
+    classical::aggressive_splitting(exec, S, splitting);
+
+    // operator on the C-points of the first splitting
+    SetupMatrixType R1;
+    cusp::transpose(exec, P, R1);
+
+    SetupMatrixType A1;
+    cusp::precond::aggregation::galerkin_product(exec, R1, A, P, A1);
+
+    SetupMatrixType S1;
+    classical::classical_strength_of_connection(exec, A1, S1, theta);
+
+    // second splitting restricted to the C-points of the first one
+    cusp::array1d<IndexType,MemorySpace> coarse_splitting(A1.num_rows);
+    thrust::copy_if(exec, splitting.begin(), splitting.end(), L.splitting.begin(),
+                    coarse_splitting.begin(), thrust::identity<IndexType>());
+
+    SetupMatrixType P2;
+    classical::extended_interpolation(exec, A1, S1, coarse_splitting, P2);
+
+    // keep the first stage if the second one did not coarsen
+    if(P2.num_cols == 0 || P2.num_cols == A1.num_rows)
+        return;
+
+    SetupMatrixType P1;
+    P1.swap(P);
+    cusp::multiply(exec, P1, P2, P);
+
+    L.splitting.swap(splitting);
+}
+
+} // end namespace precond
+} // end namespace cusp
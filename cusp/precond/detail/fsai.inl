@@ -0,0 +1,317 @@
+/*
+ *  Copyright 2008-2014 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+
+/*! \file fsai.inl
+ *  \brief Inline file for fsai.h
+ */
+
+#include <cusp/coo_matrix.h>
+#include <cusp/exception.h>
+#include <cusp/multiply.h>
+#include <cusp/transpose.h>
+
+#include <thrust/copy.h>
+#include <thrust/count.h>
+#include <thrust/fill.h>
+#include <thrust/for_each.h>
+#include <thrust/scan.h>
+#include <thrust/transform.h>
+
+#include <thrust/iterator/counting_iterator.h>
+#include <thrust/iterator/zip_iterator.h>
+
+namespace cusp
+{
+namespace precond
+{
+namespace detail
+{
+
+struct fsai_lower_entry
+{
+    template <typename Tuple>
+    __host__ __device__
+    bool operator()(const Tuple& t) const
+    {
+        return thrust::get<0>(t) >= thrust::get<1>(t);
+    }
+};
+
+struct fsai_diagonal_entry
+{
+    template <typename Tuple>
+    __host__ __device__
+    bool operator()(const Tuple& t) const
+    {
+        return thrust::get<0>(t) == thrust::get<1>(t);
+    }
+};
+
+// storage of the dense system of row i
+template <typename IndexType>
+struct fsai_dense_size
+{
+    const IndexType * row_offsets;
+
+    fsai_dense_size(const IndexType * row_offsets)
+        : row_offsets(row_offsets) {}
+
+    __host__ __device__
+    size_t operator()(const IndexType i) const
+    {
+        const size_t m = row_offsets[i + 1] - row_offsets[i];
+        return m * m;
+    }
+};
+
+// row i of G with pattern J solves L L^T = A(J,J) followed by L^T g = e_m,
+// which is the row of A(J,J)^-1 e_m scaled to a unit diagonal of G A G^T
+template <typename IndexType, typename ValueType>
+struct fsai_row_functor
+{
+    const IndexType * A_row_offsets;
+    const IndexType * A_column_indices;
+    const ValueType * A_values;
+    const IndexType * G_row_offsets;
+    const IndexType * G_column_indices;
+    ValueType * G_values;
+    const size_t * dense_offsets;
+    ValueType * dense;
+
+    fsai_row_functor(const IndexType * A_row_offsets, const IndexType * A_column_indices,
+                     const ValueType * A_values, const IndexType * G_row_offsets,
+                     const IndexType * G_column_indices, ValueType * G_values,
+                     const size_t * dense_offsets, ValueType * dense)
+        : A_row_offsets(A_row_offsets), A_column_indices(A_column_indices), A_values(A_values),
+          G_row_offsets(G_row_offsets), G_column_indices(G_column_indices), G_values(G_values),
+          dense_offsets(dense_offsets), dense(dense) {}
+
+    __host__ __device__
+    void operator()(const IndexType i) const
+    {
+        using thrust::sqrt;
+        using std::sqrt;
+
+        const IndexType m = G_row_offsets[i + 1] - G_row_offsets[i];
+        const IndexType * J = G_column_indices + G_row_offsets[i];
+        ValueType * g = G_values + G_row_offsets[i];
+        ValueType * S = dense + dense_offsets[i];
+
+        // gather the lower triangle of A(J,J) in row-major order
+        for(IndexType r = 0; r < m; r++)
+        {
+            IndexType jj = A_row_offsets[J[r]];
+            const IndexType row_end = A_row_offsets[J[r] + 1];
+
+            for(IndexType c = 0; c <= r; c++)
+                S[r * m + c] = ValueType(0);
+
+            IndexType c = 0;
+
+            while(jj < row_end && c <= r)
+            {
+                const IndexType col = A_column_indices[jj];
+
+                if(col == J[c])
+                    S[r * m + c++] = A_values[jj++];
+                else if(col < J[c])
+                    jj++;
+                else
+                    c++;
+            }
+        }
+
+        const ValueType Aii = S[m * m - 1];
+
+        // Cholesky factorization of A(J,J)
+        bool positive = true;
+
+        for(IndexType k = 0; k < m; k++)
+        {
+            ValueType sum = S[k * m + k];
+
+            for(IndexType l = 0; l < k; l++)
+                sum -= S[k * m + l] * S[k * m + l];
+
+            if(!(sum > ValueType(0)))
+            {
+                positive = false;
+                break;
+            }
+
+            S[k * m + k] = sqrt(sum);
+
+            for(IndexType r = k + 1; r < m; r++)
+            {
+                ValueType s = S[r * m + k];
+
+                for(IndexType l = 0; l < k; l++)
+                    s -= S[r * m + l] * S[k * m + l];
+
+                S[r * m + k] = s / S[k * m + k];
+            }
+        }
+
+        if(!positive)
+        {
+            // fall back to the Jacobi scaling of row i
+            for(IndexType k = 0; k < m - 1; k++)
+                g[k] = ValueType(0);
+
+            const ValueType abs_Aii = Aii < ValueType(0) ? -Aii : Aii;
+            g[m - 1] = abs_Aii > ValueType(0) ? ValueType(1) / sqrt(abs_Aii) : ValueType(1);
+
+            return;
+        }
+
+        // solve L^T g = e_m
+        for(IndexType k = m - 1; k >= 0; k--)
+        {
+            ValueType s = k == m - 1 ? ValueType(1) : ValueType(0);
+
+            for(IndexType l = k + 1; l < m; l++)
+                s -= S[l * m + k] * g[l];
+
+            g[k] = s / S[k * m + k];
+        }
+    }
+};
+
+} // end namespace detail
+
+template <typename ValueType, typename MemorySpace>
+template<typename MatrixType>
+fsai<ValueType,MemorySpace>
+::fsai(const MatrixType& A, const size_t power)
+{
+    initialize(A, power);
+}
+
+template <typename ValueType, typename MemorySpace>
+template <typename ValueType2, typename MemorySpace2>
+fsai<ValueType,MemorySpace>
+::fsai(const fsai<ValueType2,MemorySpace2>& M)
+    : Parent(M.num_rows, M.num_cols, M.num_entries),
+      G(M.G), Gt(M.Gt), temp(M.num_rows)
+{
+}
+
+template <typename ValueType, typename MemorySpace>
+template<typename MatrixType>
+void fsai<ValueType,MemorySpace>
+::initialize(const MatrixType& A, const size_t power)
+{
+    typedef cusp::csr_matrix<int,ValueType,MemorySpace> CsrMatrix;
+    typedef cusp::coo_matrix<int,ValueType,MemorySpace> CooMatrix;
+
+    if(A.num_rows != A.num_cols)
+        throw cusp::invalid_input_exception("matrix must be square");
+
+    if(power < 1)
+        throw cusp::invalid_input_exception("power must be at least one");
+
+    MemorySpace system;
+
+    CsrMatrix A_csr(A);
+
+    // structure of A^power, the values are set to one so that no entry
+    // cancels in the products
+    CsrMatrix B(A_csr);
+    thrust::fill(B.values.begin(), B.values.end(), ValueType(1));
+
+    if(power > 1)
+    {
+        CsrMatrix Ak(B);
+
+        for(size_t k = 1; k < power; k++)
+        {
+            CsrMatrix C;
+            cusp::multiply(Ak, B, C);
+            Ak.swap(C);
+        }
+
+        B.swap(Ak);
+    }
+
+    // pattern of G is the lower triangle of B
+    CooMatrix B_coo(B);
+
+    const size_t num_lower = thrust::count_if(thrust::make_zip_iterator(thrust::make_tuple(B_coo.row_indices.begin(), B_coo.column_indices.begin())),
+                                              thrust::make_zip_iterator(thrust::make_tuple(B_coo.row_indices.end(),   B_coo.column_indices.end())),
+                                              detail::fsai_lower_entry());
+
+    const size_t num_diagonals = thrust::count_if(thrust::make_zip_iterator(thrust::make_tuple(B_coo.row_indices.begin(), B_coo.column_indices.begin())),
+                                                  thrust::make_zip_iterator(thrust::make_tuple(B_coo.row_indices.end(),   B_coo.column_indices.end())),
+                                                  detail::fsai_diagonal_entry());
+
+    if(num_diagonals != A.num_rows)
+        throw cusp::invalid_input_exception("matrix must have a diagonal entry in every row");
+
+    CooMatrix G_coo(A.num_rows, A.num_cols, num_lower);
+
+    thrust::copy_if(thrust::make_zip_iterator(thrust::make_tuple(B_coo.row_indices.begin(), B_coo.column_indices.begin(), B_coo.values.begin())),
+                    thrust::make_zip_iterator(thrust::make_tuple(B_coo.row_indices.end(),   B_coo.column_indices.end(),   B_coo.values.end())),
+                    thrust::make_zip_iterator(thrust::make_tuple(B_coo.row_indices.begin(), B_coo.column_indices.begin())),
+                    thrust::make_zip_iterator(thrust::make_tuple(G_coo.row_indices.begin(), G_coo.column_indices.begin(), G_coo.values.begin())),
+                    detail::fsai_lower_entry());
+
+    Parent::resize(A.num_rows, A.num_cols, 2 * num_lower);
+    G = G_coo;
+    temp.resize(A.num_rows);
+
+    if(G.num_entries > 0)
+    {
+        // offsets of the dense systems of the rows
+        cusp::array1d<size_t,MemorySpace> dense_offsets(A.num_rows + 1, 0);
+
+        thrust::transform(system,
+                          thrust::counting_iterator<int>(0),
+                          thrust::counting_iterator<int>(A.num_rows),
+                          dense_offsets.begin(),
+                          detail::fsai_dense_size<int>(thrust::raw_pointer_cast(&G.row_offsets[0])));
+        thrust::exclusive_scan(dense_offsets.begin(), dense_offsets.end(), dense_offsets.begin());
+
+        cusp::array1d<ValueType,MemorySpace> dense(dense_offsets[A.num_rows]);
+
+        thrust::for_each(system,
+                         thrust::counting_iterator<int>(0),
+                         thrust::counting_iterator<int>(A.num_rows),
+                         detail::fsai_row_functor<int,ValueType>(thrust::raw_pointer_cast(&A_csr.row_offsets[0]),
+                                                                 thrust::raw_pointer_cast(&A_csr.column_indices[0]),
+                                                                 thrust::raw_pointer_cast(&A_csr.values[0]),
+                                                                 thrust::raw_pointer_cast(&G.row_offsets[0]),
+                                                                 thrust::raw_pointer_cast(&G.column_indices[0]),
+                                                                 thrust::raw_pointer_cast(&G.values[0]),
+                                                                 thrust::raw_pointer_cast(&dense_offsets[0]),
+                                                                 thrust::raw_pointer_cast(&dense[0])));
+    }
+
+    cusp::transpose(G, Gt);
+}
+
+template <typename ValueType, typename MemorySpace>
+template <typename VectorType1, typename VectorType2>
+void fsai<ValueType,MemorySpace>
+::operator()(const VectorType1& x, VectorType2& y)
+{
+    // y <- G^T G x
+    cusp::multiply(G, x, temp);
+    cusp::multiply(Gt, temp, y);
+}
+
+} // end namespace precond
+} // end namespace cusp
@@ -0,0 +1,330 @@
+/*
+ *  Copyright 2008-2014 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*! \file ilu.inl
+ *  \brief Inline file for ilu.h
+ */
+
+#include <cusp/coo_matrix.h>
+#include <cusp/exception.h>
+#include <cusp/functional.h>
+#include <cusp/transpose.h>
+
+#include <thrust/copy.h>
+#include <thrust/count.h>
+#include <thrust/for_each.h>
+
+#include <thrust/iterator/counting_iterator.h>
+#include <thrust/iterator/zip_iterator.h>
+
+namespace cusp
+{
+namespace precond
+{
+namespace detail
+{
+
+struct is_lower_entry
+{
+    template <typename Tuple>
+    __host__ __device__
+    bool operator()(const Tuple& t) const
+    {
+        return thrust::get<0>(t) >= thrust::get<1>(t);
+    }
+};
+
+// IKJ variant of ILU(0) for row i = rows[n], the rows k < i referenced by
+// row i belong to earlier levels and are already factorized
+template <typename IndexType, typename ValueType>
+struct ilu0_row_functor
+{
+    const IndexType * rows;
+    const IndexType * row_offsets;
+    const IndexType * column_indices;
+    const IndexType * diagonal_indices;
+    ValueType * values;
+
+    ilu0_row_functor(const IndexType * rows, const IndexType * row_offsets,
+                     const IndexType * column_indices, const IndexType * diagonal_indices,
+                     ValueType * values)
+        : rows(rows), row_offsets(row_offsets), column_indices(column_indices),
+          diagonal_indices(diagonal_indices), values(values) {}
+
+    __host__ __device__
+    void operator()(const IndexType n) const
+    {
+        const IndexType i = rows[n];
+        const IndexType row_end = row_offsets[i + 1];
+
+        for(IndexType kk = row_offsets[i]; kk < row_end && column_indices[kk] < i; kk++)
+        {
+            const IndexType k = column_indices[kk];
+            const ValueType Lik = values[kk] / values[diagonal_indices[k]];
+
+            values[kk] = Lik;
+
+            // A(i,j) -= L(i,k) * U(k,j) for the entries j > k of row i in row k
+            IndexType jj = kk + 1;
+            IndexType kj = diagonal_indices[k] + 1;
+            const IndexType k_end = row_offsets[k + 1];
+
+            while(jj < row_end && kj < k_end)
+            {
+                const IndexType col_ij = column_indices[jj];
+                const IndexType col_kj = column_indices[kj];
+
+                if(col_ij == col_kj)
+                    values[jj++] -= Lik * values[kj++];
+                else if(col_ij < col_kj)
+                    jj++;
+                else
+                    kj++;
+            }
+        }
+    }
+};
+
+// row i = rows[n] of IC(0), L(i,k) = (A(i,k) - sum_{j<k} L(i,j) L(k,j)) / L(k,k)
+// and L(i,i) = sqrt(A(i,i) - sum_{j<i} L(i,j)^2)
+template <typename IndexType, typename ValueType>
+struct ic0_row_functor
+{
+    const IndexType * rows;
+    const IndexType * row_offsets;
+    const IndexType * column_indices;
+    const IndexType * diagonal_indices;
+    ValueType * values;
+
+    ic0_row_functor(const IndexType * rows, const IndexType * row_offsets,
+                    const IndexType * column_indices, const IndexType * diagonal_indices,
+                    ValueType * values)
+        : rows(rows), row_offsets(row_offsets), column_indices(column_indices),
+          diagonal_indices(diagonal_indices), values(values) {}
+
+    __host__ __device__
+    void operator()(const IndexType n) const
+    {
+        using thrust::sqrt;
+        using std::sqrt;
+
+        const IndexType i = rows[n];
+
+        for(IndexType kk = row_offsets[i]; kk < row_offsets[i + 1]; kk++)
+        {
+            const IndexType k = column_indices[kk];
+            const ValueType Aik = values[kk];
+
+            ValueType sum = Aik;
+
+            IndexType ij = row_offsets[i];
+            IndexType kj = row_offsets[k];
+            const IndexType k_end = diagonal_indices[k];
+
+            while(ij < kk && kj < k_end)
+            {
+                const IndexType col_ij = column_indices[ij];
+                const IndexType col_kj = column_indices[kj];
+
+                if(col_ij == col_kj)
+                    sum -= values[ij++] * values[kj++];
+                else if(col_ij < col_kj)
+                    ij++;
+                else
+                    kj++;
+            }
+
+            if(k < i)
+            {
+                values[kk] = sum / values[k_end];
+            }
+            else
+            {
+                // breakdown, fall back to the diagonal of A
+                if(!(sum > ValueType(0)))
+                    sum = Aik < ValueType(0) ? -Aik : Aik;
+
+                values[kk] = sqrt(sum);
+            }
+        }
+    }
+};
+
+// apply f to the positions of the rows of every level of plan in turn
+template <typename PlanType, typename Functor>
+void for_each_level(const PlanType& plan, const Functor& f)
+{
+    typedef typename PlanType::memory_space MemorySpace;
+
+    MemorySpace system;
+
+    for(size_t l = 0; l < plan.num_levels(); l++)
+        thrust::for_each(system,
+                         thrust::counting_iterator<int>(plan.level_offsets[l]),
+                         thrust::counting_iterator<int>(plan.level_offsets[l + 1]),
+                         f);
+}
+
+} // end namespace detail
+
+///////////
+// ILU(0) //
+///////////
+
+template <typename ValueType, typename MemorySpace>
+template<typename MatrixType>
+ilu0<ValueType,MemorySpace>
+::ilu0(const MatrixType& A)
+{
+    initialize(A);
+}
+
+template <typename ValueType, typename MemorySpace>
+template <typename ValueType2, typename MemorySpace2>
+ilu0<ValueType,MemorySpace>
+::ilu0(const ilu0<ValueType2,MemorySpace2>& M)
+    : Parent(M.num_rows, M.num_cols, M.num_entries),
+      LU(M.LU), lower_plan(M.lower_plan), upper_plan(M.upper_plan)
+{
+}
+
+template <typename ValueType, typename MemorySpace>
+template<typename MatrixType>
+void ilu0<ValueType,MemorySpace>
+::initialize(const MatrixType& A, const bool same_pattern)
+{
+    if(A.num_rows != A.num_cols)
+        throw cusp::invalid_input_exception("matrix must be square");
+
+    const bool analyze = !same_pattern || LU.num_rows != A.num_rows || LU.num_entries != A.num_entries;
+
+    Parent::resize(A.num_rows, A.num_cols, A.num_entries);
+    LU = A;
+
+    if(analyze)
+    {
+        cusp::triangular_solve_analysis(LU, lower_plan, true,  true);
+        cusp::triangular_solve_analysis(LU, upper_plan, false, false);
+    }
+
+    if(LU.num_entries == 0)
+        return;
+
+    // the factorization of row i depends on the rows of L(i,:)
+    detail::for_each_level(lower_plan,
+        detail::ilu0_row_functor<int,ValueType>(thrust::raw_pointer_cast(&lower_plan.rows[0]),
+                                                thrust::raw_pointer_cast(&LU.row_offsets[0]),
+                                                thrust::raw_pointer_cast(&LU.column_indices[0]),
+                                                thrust::raw_pointer_cast(&upper_plan.diagonal_indices[0]),
+                                                thrust::raw_pointer_cast(&LU.values[0])));
+}
+
+template <typename ValueType, typename MemorySpace>
+template <typename VectorType1, typename VectorType2>
+void ilu0<ValueType,MemorySpace>
+::operator()(const VectorType1& x, VectorType2& y) const
+{
+    // y <- L^-1 x
+    cusp::triangular_solve(LU, x, y, lower_plan);
+
+    // y <- U^-1 y
+    cusp::triangular_solve(LU, y, y, upper_plan);
+}
+
+///////////
+// IC(0) //
+///////////
+
+template <typename ValueType, typename MemorySpace>
+template<typename MatrixType>
+ic0<ValueType,MemorySpace>
+::ic0(const MatrixType& A)
+{
+    initialize(A);
+}
+
+template <typename ValueType, typename MemorySpace>
+template <typename ValueType2, typename MemorySpace2>
+ic0<ValueType,MemorySpace>
+::ic0(const ic0<ValueType2,MemorySpace2>& M)
+    : Parent(M.num_rows, M.num_cols, M.num_entries),
+      L(M.L), Lt(M.Lt), lower_plan(M.lower_plan), upper_plan(M.upper_plan)
+{
+}
+
+template <typename ValueType, typename MemorySpace>
+template<typename MatrixType>
+void ic0<ValueType,MemorySpace>
+::initialize(const MatrixType& A, const bool same_pattern)
+{
+    typedef cusp::coo_matrix<int,ValueType,MemorySpace> CooMatrix;
+
+    if(A.num_rows != A.num_cols)
+        throw cusp::invalid_input_exception("matrix must be square");
+
+    // lower triangle of A
+    CooMatrix A_coo(A);
+
+    const size_t num_lower = thrust::count_if(thrust::make_zip_iterator(thrust::make_tuple(A_coo.row_indices.begin(), A_coo.column_indices.begin())),
+                                              thrust::make_zip_iterator(thrust::make_tuple(A_coo.row_indices.end(),   A_coo.column_indices.end())),
+                                              detail::is_lower_entry());
+
+    const bool analyze = !same_pattern || L.num_rows != A.num_rows || L.num_entries != num_lower;
+
+    CooMatrix L_coo(A.num_rows, A.num_cols, num_lower);
+
+    thrust::copy_if(thrust::make_zip_iterator(thrust::make_tuple(A_coo.row_indices.begin(), A_coo.column_indices.begin(), A_coo.values.begin())),
+                    thrust::make_zip_iterator(thrust::make_tuple(A_coo.row_indices.end(),   A_coo.column_indices.end(),   A_coo.values.end())),
+                    thrust::make_zip_iterator(thrust::make_tuple(A_coo.row_indices.begin(), A_coo.column_indices.begin())),
+                    thrust::make_zip_iterator(thrust::make_tuple(L_coo.row_indices.begin(), L_coo.column_indices.begin(), L_coo.values.begin())),
+                    detail::is_lower_entry());
+
+    Parent::resize(A.num_rows, A.num_cols, 2 * num_lower);
+    L = L_coo;
+
+    if(analyze)
+        cusp::triangular_solve_analysis(L, lower_plan, true, false);
+
+    if(L.num_entries > 0)
+    {
+        detail::for_each_level(lower_plan,
+            detail::ic0_row_functor<int,ValueType>(thrust::raw_pointer_cast(&lower_plan.rows[0]),
+                                                   thrust::raw_pointer_cast(&L.row_offsets[0]),
+                                                   thrust::raw_pointer_cast(&L.column_indices[0]),
+                                                   thrust::raw_pointer_cast(&lower_plan.diagonal_indices[0]),
+                                                   thrust::raw_pointer_cast(&L.values[0])));
+    }
+
+    cusp::transpose(L, Lt);
+
+    if(analyze)
+        cusp::triangular_solve_analysis(Lt, upper_plan, false, false);
+}
+
+template <typename ValueType, typename MemorySpace>
+template <typename VectorType1, typename VectorType2>
+void ic0<ValueType,MemorySpace>
+::operator()(const VectorType1& x, VectorType2& y) const
+{
+    // y <- L^-1 x
+    cusp::triangular_solve(L, x, y, lower_plan);
+
+    // y <- L^-T y
+    cusp::triangular_solve(Lt, y, y, upper_plan);
+}
+
+} // end namespace precond
+} // end namespace cusp
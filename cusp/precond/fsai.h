@@ -0,0 +1,151 @@
+/*
+ *  Copyright 2008-2014 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+
+/*! \file fsai.h
+ *  \brief Factorized sparse approximate inverse preconditioner.
+ */
+
+#pragma once
+
+#include <cusp/detail/config.h>
+
+#include <cusp/array1d.h>
+#include <cusp/csr_matrix.h>
+#include <cusp/linear_operator.h>
+
+namespace cusp
+{
+namespace precond
+{
+/*! \addtogroup preconditioners Preconditioners
+ *  \ingroup preconditioners
+ *  \{
+ */
+
+/** \brief Factorized sparse approximate inverse preconditioner
+ *
+ *  \tparam ValueType Type used for matrix values (e.g. \c float or \c double).
+ *  \tparam MemorySpace A memory space (e.g. \c cusp::host_memory or \c cusp::device_memory)
+ *
+ *  \par Overview
+ *  The FSAI preconditioner of Kolotilina and Yeremin computes a lower
+ *  triangular \c G with a prescribed sparsity pattern such that
+ *  <tt>G^T G ~= A^-1</tt> for a symmetric positive definite matrix \c A,
+ *  and implements <tt>y = G^T G x</tt> when applied to a vector \p x. The
+ *  pattern of \c G is the lower triangle of <tt>A^power</tt>, where
+ *  <tt>power = 1</tt> keeps the pattern of \c A and larger powers trade
+ *  setup time and storage for a better approximation.
+ *
+ *  Every row \c i of \c G is computed independently from the small dense
+ *  system <tt>A(J,J) g = e_i</tt>, where \c J is the pattern of the row,
+ *  so the setup is parallel across rows and each dense system is solved
+ *  by a Cholesky factorization in the memory space of the preconditioner.
+ *  The setup needs storage for <tt>|J|^2</tt> values per row. Unlike
+ *  \p ilu0 and \p ic0 the application is two sparse matrix-vector
+ *  products without any triangular solve.
+ *
+ *  The matrix must have a nonzero diagonal entry in every row and sorted
+ *  column indices. If a dense system is not positive definite, the row
+ *  falls back to the Jacobi scaling <tt>1/sqrt(|a_ii|)</tt>.
+ *
+ *  \par Example
+ *  The following code snippet demonstrates how to use a
+ *  \p fsai preconditioner to solve a linear system.
+ *
+ *  \code
+ *  #include <cusp/precond/fsai.h>
+ *  #include <cusp/gallery/poisson.h>
+ *  #include <cusp/krylov/cg.h>
+ *
+ *  int main(void)
+ *  {
+ *    cusp::csr_matrix<int, float, cusp::device_memory> A;
+ *    cusp::gallery::poisson5pt(A, 256, 256);
+ *
+ *    // allocate storage for solution (x) and right hand side (b)
+ *    cusp::array1d<float, cusp::device_memory> x(A.num_rows, 0);
+ *    cusp::array1d<float, cusp::device_memory> b(A.num_rows, 1);
+ *
+ *    cusp::monitor<float> monitor(b, 100, 1e-6);
+ *
+ *    // setup preconditioner with the pattern of the lower triangle of A^2
+ *    cusp::precond::fsai<float, cusp::device_memory> M(A, 2);
+ *
+ *    // solve
+ *    cusp::krylov::cg(A, x, b, monitor, M);
+ *
+ *    return 0;
+ *  }
+ *  \endcode
+ */
+template <typename ValueType, typename MemorySpace>
+class fsai : public linear_operator<ValueType, MemorySpace>
+{
+    typedef linear_operator<ValueType, MemorySpace> Parent;
+
+public:
+    /*! lower triangular factor and its transpose */
+    cusp::csr_matrix<int, ValueType, MemorySpace> G;
+    cusp::csr_matrix<int, ValueType, MemorySpace> Gt;
+
+    /*! construct an empty \p fsai preconditioner
+     */
+    fsai(void) {}
+
+    /*! construct a \p fsai preconditioner
+     *
+     * \param A symmetric positive definite matrix to precondition
+     * \param power the pattern of \c G is the lower triangle of <tt>A^power</tt>
+     * \tparam MatrixType matrix
+     */
+    template<typename MatrixType>
+    fsai(const MatrixType& A, const size_t power = 1);
+
+    /*! construct a \p fsai preconditioner from another \p fsai
+     *  preconditioner, possibly in a different memory space
+     */
+    template <typename ValueType2, typename MemorySpace2>
+    fsai(const fsai<ValueType2,MemorySpace2>& M);
+
+    /*! compute the factor of a new matrix
+     *
+     * \param A symmetric positive definite matrix to precondition
+     * \param power the pattern of \c G is the lower triangle of <tt>A^power</tt>
+     */
+    template<typename MatrixType>
+    void initialize(const MatrixType& A, const size_t power = 1);
+
+    /*! apply the preconditioner to vector \p x and store the result in \p y
+     *
+     * \param x input vector
+     * \param y ouput vector
+     * \tparam VectorType1 vector
+     * \tparam VectorType2 vector
+     */
+    template <typename VectorType1, typename VectorType2>
+    void operator()(const VectorType1& x, VectorType2& y);
+
+protected:
+    cusp::array1d<ValueType, MemorySpace> temp;
+};
+/*! \}
+ */
+
+} // end namespace precond
+} // end namespace cusp
+
+#include <cusp/precond/detail/fsai.inl>
@@ -0,0 +1,249 @@
+/*
+ *  Copyright 2008-2014 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*! \file ilu.h
+ *  \brief Incomplete LU and incomplete Cholesky preconditioners.
+ */
+
+#pragma once
+
+#include <cusp/detail/config.h>
+
+#include <cusp/array1d.h>
+#include <cusp/csr_matrix.h>
+#include <cusp/linear_operator.h>
+#include <cusp/triangular_solve.h>
+
+namespace cusp
+{
+namespace precond
+{
+/*! \addtogroup preconditioners Preconditioners
+ *  \ingroup preconditioners
+ *  \{
+ */
+
+/** \brief Incomplete LU factorization preconditioner without fill-in
+ *
+ *  \tparam ValueType Type used for matrix values (e.g. \c float or \c double).
+ *  \tparam MemorySpace A memory space (e.g. \c cusp::host_memory or \c cusp::device_memory)
+ *
+ *  \par Overview
+ *  The ILU(0) preconditioner computes a unit lower triangular \c L and an
+ *  upper triangular \c U with the sparsity pattern of \c A such that
+ *  <tt>A ~= L U</tt> and implements <tt>y = U^-1 L^-1 x</tt> when applied
+ *  to a vector \p x. Both factors are stored in a single CSR matrix with
+ *  the pattern of \c A.
+ *
+ *  The rows of both triangular solves are grouped into levels once, by
+ *  \p triangular_solve_analysis, when the preconditioner is constructed.
+ *  The factorization reuses the levels of the lower solve. The rows of
+ *  each level are processed in parallel in the memory space of the
+ *  preconditioner, so the cost of one application is one kernel per
+ *  level. Matrices whose rows form long dependency chains (e.g.
+ *  banded matrices) have many levels and little parallelism.
+ *
+ *  The matrix must have a nonzero diagonal entry in every row and sorted
+ *  column indices.
+ *
+ *  \par Example
+ *  The following code snippet demonstrates how to use a
+ *  \p ilu0 preconditioner to solve a linear system.
+ *
+ *  \code
+ *  #include <cusp/precond/ilu.h>
+ *  #include <cusp/gallery/poisson.h>
+ *  #include <cusp/krylov/bicgstab.h>
+ *
+ *  int main(void)
+ *  {
+ *    cusp::csr_matrix<int, float, cusp::device_memory> A;
+ *    cusp::gallery::poisson5pt(A, 256, 256);
+ *
+ *    // allocate storage for solution (x) and right hand side (b)
+ *    cusp::array1d<float, cusp::device_memory> x(A.num_rows, 0);
+ *    cusp::array1d<float, cusp::device_memory> b(A.num_rows, 1);
+ *
+ *    cusp::monitor<float> monitor(b, 100, 1e-6);
+ *
+ *    // setup preconditioner
+ *    cusp::precond::ilu0<float, cusp::device_memory> M(A);
+ *
+ *    // solve
+ *    cusp::krylov::bicgstab(A, x, b, monitor, M);
+ *
+ *    return 0;
+ *  }
+ *  \endcode
+ */
+template <typename ValueType, typename MemorySpace>
+class ilu0 : public linear_operator<ValueType, MemorySpace>
+{
+    typedef linear_operator<ValueType, MemorySpace> Parent;
+
+public:
+    /*! L (strictly lower part, unit diagonal implied) and U (upper part) */
+    cusp::csr_matrix<int, ValueType, MemorySpace> LU;
+
+    /*! construct an empty \p ilu0 preconditioner
+     */
+    ilu0(void) {}
+
+    /*! construct a \p ilu0 preconditioner
+     *
+     * \param A matrix to precondition
+     * \tparam MatrixType matrix
+     */
+    template<typename MatrixType>
+    ilu0(const MatrixType& A);
+
+    /*! construct a \p ilu0 preconditioner from another \p ilu0
+     *  preconditioner, possibly in a different memory space
+     */
+    template <typename ValueType2, typename MemorySpace2>
+    ilu0(const ilu0<ValueType2,MemorySpace2>& M);
+
+    /*! factorize a new matrix, the analysis of the previous matrix is
+     *  reused if the sparsity pattern is unchanged
+     *
+     * \param A matrix to precondition
+     * \param same_pattern \c true if \p A has the sparsity pattern of the
+     * matrix the preconditioner was constructed with
+     */
+    template<typename MatrixType>
+    void initialize(const MatrixType& A, const bool same_pattern = false);
+
+    /*! apply the preconditioner to vector \p x and store the result in \p y
+     *
+     * \param x input vector
+     * \param y ouput vector
+     * \tparam VectorType1 vector
+     * \tparam VectorType2 vector
+     */
+    template <typename VectorType1, typename VectorType2>
+    void operator()(const VectorType1& x, VectorType2& y) const;
+
+    /*! level schedules of the solves with L and U */
+    cusp::triangular_solve_plan<int, MemorySpace> lower_plan;
+    cusp::triangular_solve_plan<int, MemorySpace> upper_plan;
+};
+
+/** \brief Incomplete Cholesky factorization preconditioner without fill-in
+ *
+ *  \tparam ValueType Type used for matrix values (e.g. \c float or \c double).
+ *  \tparam MemorySpace A memory space (e.g. \c cusp::host_memory or \c cusp::device_memory)
+ *
+ *  \par Overview
+ *  The IC(0) preconditioner computes a lower triangular \c L with the
+ *  sparsity pattern of the lower triangle of a symmetric positive definite
+ *  matrix \c A such that <tt>A ~= L L^T</tt> and implements
+ *  <tt>y = L^-T L^-1 x</tt> when applied to a vector \p x. \c L^T is kept
+ *  explicitly so both triangular solves traverse rows.
+ *
+ *  The factorization and the triangular solves use the same level
+ *  scheduling as \p ilu0. If a pivot is not positive, which may happen
+ *  for SPD matrices that are not M-matrices, the absolute value of the
+ *  diagonal entry of \c A is used instead.
+ *
+ *  \par Example
+ *  The following code snippet demonstrates how to use a
+ *  \p ic0 preconditioner to solve a linear system.
+ *
+ *  \code
+ *  #include <cusp/precond/ilu.h>
+ *  #include <cusp/gallery/poisson.h>
+ *  #include <cusp/krylov/cg.h>
+ *
+ *  int main(void)
+ *  {
+ *    cusp::csr_matrix<int, float, cusp::device_memory> A;
+ *    cusp::gallery::poisson5pt(A, 256, 256);
+ *
+ *    // allocate storage for solution (x) and right hand side (b)
+ *    cusp::array1d<float, cusp::device_memory> x(A.num_rows, 0);
+ *    cusp::array1d<float, cusp::device_memory> b(A.num_rows, 1);
+ *
+ *    cusp::monitor<float> monitor(b, 100, 1e-6);
+ *
+ *    // setup preconditioner
+ *    cusp::precond::ic0<float, cusp::device_memory> M(A);
+ *
+ *    // solve
+ *    cusp::krylov::cg(A, x, b, monitor, M);
+ *
+ *    return 0;
+ *  }
+ *  \endcode
+ */
+template <typename ValueType, typename MemorySpace>
+class ic0 : public linear_operator<ValueType, MemorySpace>
+{
+    typedef linear_operator<ValueType, MemorySpace> Parent;
+
+public:
+    /*! lower triangular factor and its transpose */
+    cusp::csr_matrix<int, ValueType, MemorySpace> L;
+    cusp::csr_matrix<int, ValueType, MemorySpace> Lt;
+
+    /*! construct an empty \p ic0 preconditioner
+     */
+    ic0(void) {}
+
+    /*! construct a \p ic0 preconditioner
+     *
+     * \param A symmetric positive definite matrix to precondition
+     * \tparam MatrixType matrix
+     */
+    template<typename MatrixType>
+    ic0(const MatrixType& A);
+
+    /*! construct a \p ic0 preconditioner from another \p ic0
+     *  preconditioner, possibly in a different memory space
+     */
+    template <typename ValueType2, typename MemorySpace2>
+    ic0(const ic0<ValueType2,MemorySpace2>& M);
+
+    /*! factorize a new matrix, the analysis of the previous matrix is
+     *  reused if the sparsity pattern is unchanged
+     *
+     * \param A symmetric positive definite matrix to precondition
+     * \param same_pattern \c true if \p A has the sparsity pattern of the
+     * matrix the preconditioner was constructed with
+     */
+    template<typename MatrixType>
+    void initialize(const MatrixType& A, const bool same_pattern = false);
+
+    /*! apply the preconditioner to vector \p x and store the result in \p y
+     *
+     * \param x input vector
+     * \param y ouput vector
+     * \tparam VectorType1 vector
+     * \tparam VectorType2 vector
+     */
+    template <typename VectorType1, typename VectorType2>
+    void operator()(const VectorType1& x, VectorType2& y) const;
+
+    /*! level schedules of the solves with L and L^T */
+    cusp::triangular_solve_plan<int, MemorySpace> lower_plan;
+    cusp::triangular_solve_plan<int, MemorySpace> upper_plan;
+};
+/*! \}
+ */
+
+} // end namespace precond
+} // end namespace cusp
+
+#include <cusp/precond/detail/ilu.inl>
@@ -0,0 +1,330 @@
+/*
+ *  Copyright 2008-2014 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*! \file block_jacobi_smoother.h
+ *  \brief Block Jacobi smoother for algebraic multigrid.
+ *
+ */
+
+#pragma once
+
+#include <cusp/detail/config.h>
+#include <cusp/detail/fixed_size.h>
+#include <cusp/detail/num_bytes.h>
+
+#include <cusp/array1d.h>
+#include <cusp/blas/blas.h>
+#include <cusp/csr_matrix.h>
+#include <cusp/exception.h>
+#include <cusp/multiply.h>
+
+#include <thrust/fill.h>
+#include <thrust/for_each.h>
+#include <thrust/iterator/counting_iterator.h>
+
+namespace cusp
+{
+namespace precond
+{
+namespace detail
+{
+
+// inverts the N x N diagonal block of rows [k N, (k + 1) N), the rows past
+// the end of the matrix are padded with the identity and a singular block
+// falls back to the inverse of its diagonal
+template <size_t N, typename IndexType, typename ValueType>
+struct block_inverse_functor
+{
+    const IndexType * row_offsets;
+    const IndexType * column_indices;
+    const ValueType * values;
+    ValueType * inverse;
+    IndexType num_rows;
+
+    block_inverse_functor(const IndexType * row_offsets, const IndexType * column_indices,
+                          const ValueType * values, ValueType * inverse, IndexType num_rows)
+        : row_offsets(row_offsets), column_indices(column_indices), values(values),
+          inverse(inverse), num_rows(num_rows) {}
+
+    __host__ __device__
+    void operator()(const IndexType k) const
+    {
+        const IndexType block_start = k * N;
+
+        ValueType block[N * N];
+
+        for(size_t n = 0; n < N * N; n++)
+            block[n] = ValueType(0);
+
+        for(size_t r = 0; r < N; r++)
+        {
+            const IndexType i = block_start + r;
+
+            if(i >= num_rows)
+            {
+                block[r * N + r] = ValueType(1);
+                continue;
+            }
+
+            for(IndexType jj = row_offsets[i]; jj < row_offsets[i + 1]; jj++)
+            {
+                const IndexType j = column_indices[jj];
+
+                if(j >= block_start && j < block_start + IndexType(N))
+                    block[r * N + (j - block_start)] += values[jj];
+            }
+        }
+
+        ValueType diagonal[N];
+
+        for(size_t r = 0; r < N; r++)
+            diagonal[r] = block[r * N + r];
+
+        ValueType * Dinv = inverse + k * N * N;
+
+        if(!cusp::detail::fixed_size::invert<N>(block, Dinv))
+        {
+            for(size_t r = 0; r < N; r++)
+                Dinv[r * N + r] = diagonal[r] == ValueType(0) ? ValueType(1) : ValueType(1) / diagonal[r];
+        }
+    }
+};
+
+// x <- x + omega * D^-1 * r over the rows of block k
+template <size_t N, typename IndexType, typename ValueType>
+struct block_jacobi_functor
+{
+    const ValueType * inverse;
+    const ValueType * r;
+    ValueType * x;
+    ValueType omega;
+    IndexType num_rows;
+
+    block_jacobi_functor(const ValueType * inverse, const ValueType * r, ValueType * x,
+                         ValueType omega, IndexType num_rows)
+        : inverse(inverse), r(r), x(x), omega(omega), num_rows(num_rows) {}
+
+    __host__ __device__
+    void operator()(const IndexType k) const
+    {
+        const IndexType block_start = k * N;
+
+        ValueType r_block[N];
+        ValueType y_block[N];
+
+        for(size_t n = 0; n < N; n++)
+        {
+            r_block[n] = block_start + IndexType(n) < num_rows ? r[block_start + n] : ValueType(0);
+            y_block[n] = ValueType(0);
+        }
+
+        cusp::detail::fixed_size::gemv<N,N>(inverse + k * N * N, r_block, y_block);
+
+        for(size_t n = 0; n < N; n++)
+            if(block_start + IndexType(n) < num_rows)
+                x[block_start + n] += omega * y_block[n];
+    }
+};
+
+} // end namespace detail
+
+/*! \addtogroup preconditioners Preconditioners
+ *  \ingroup preconditioners
+ *  \{
+ */
+
+/**
+ * \brief Block Jacobi smoother
+ *
+ * \par Overview
+ *  Damped Jacobi iteration with the diagonal replaced by the dense
+ *  diagonal blocks of \c block_size consecutive rows, e.g. the unknowns of
+ *  one node of a vector-valued PDE. The blocks are inverted once during
+ *  setup and applied as small dense matrix vector products, both by the
+ *  kernels of \p cusp::detail::fixed_size for the block size selected at
+ *  runtime; block sizes 1 through 8 are supported.
+ */
+template <typename ValueType, typename MemorySpace>
+class block_jacobi_smoother
+{
+public:
+    size_t num_iters;
+    size_t block_size;
+    ValueType omega;
+
+    cusp::array1d<ValueType,MemorySpace> inverse;
+    cusp::array1d<ValueType,MemorySpace> residual;
+
+    block_jacobi_smoother(void) {}
+
+    template <typename ValueType2, typename MemorySpace2>
+    block_jacobi_smoother(const block_jacobi_smoother<ValueType2,MemorySpace2>& M)
+        : num_iters(M.num_iters), block_size(M.block_size), omega(M.omega),
+          inverse(M.inverse), residual(M.residual) {}
+
+    template <typename MatrixType, typename Level>
+    block_jacobi_smoother(const MatrixType& A, const Level& L, size_t block_size=3, double weight=2.0/3.0)
+    {
+        initialize(A, L, block_size, weight);
+    }
+
+    template <typename MatrixType, typename Level>
+    void initialize(const MatrixType& A, const Level& L, size_t block_size=3, double weight=2.0/3.0)
+    {
+        cusp::csr_matrix<int,ValueType,MemorySpace> C(A);
+
+        num_iters        = L.num_iters;
+        this->block_size = block_size;
+        omega            = ValueType(weight);
+
+        inverse.resize(num_blocks(A.num_rows) * block_size * block_size);
+        residual.resize(A.num_rows);
+
+        if(A.num_rows == 0)
+            return;
+
+        thrust::fill(inverse.begin(), inverse.end(), ValueType(0));
+
+        invert_blocks op(C, inverse);
+        dispatch(op);
+    }
+
+    // ignores initial x
+    template<typename MatrixType, typename VectorType1, typename VectorType2>
+    void presmooth(const MatrixType& A, const VectorType1& b, VectorType2& x)
+    {
+        if(num_iters == 0)
+            return;
+
+        // x <- omega * D^-1 * b
+        thrust::fill(x.begin(), x.end(), ValueType(0));
+        update(b, x);
+
+        for(size_t i = 1; i < num_iters; i++)
+            sweep(A, b, x);
+    }
+
+    // smooths initial x
+    template<typename MatrixType, typename VectorType1, typename VectorType2>
+    void postsmooth(const MatrixType& A, const VectorType1& b, VectorType2& x)
+    {
+        for(size_t i = 0; i < num_iters; i++)
+            sweep(A, b, x);
+    }
+
+private:
+
+    size_t num_blocks(size_t num_rows) const
+    {
+        return (num_rows + block_size - 1) / block_size;
+    }
+
+    template <typename Function>
+    void dispatch(Function& f) const
+    {
+        if(block_size == 1)
+            f.template apply<1>();
+        else if(!cusp::detail::fixed_size::dispatch_block_size(block_size, f))
+            throw cusp::invalid_input_exception("block_jacobi_smoother supports block sizes 1 through 8");
+    }
+
+    struct invert_blocks
+    {
+        const cusp::csr_matrix<int,ValueType,MemorySpace>& A;
+        cusp::array1d<ValueType,MemorySpace>& inverse;
+
+        invert_blocks(const cusp::csr_matrix<int,ValueType,MemorySpace>& A, cusp::array1d<ValueType,MemorySpace>& inverse)
+            : A(A), inverse(inverse) {}
+
+        template <size_t N>
+        void apply(void)
+        {
+            MemorySpace system;
+
+            thrust::for_each(system,
+                             thrust::counting_iterator<int>(0),
+                             thrust::counting_iterator<int>((A.num_rows + N - 1) / N),
+                             detail::block_inverse_functor<N,int,ValueType>(
+                                 thrust::raw_pointer_cast(&A.row_offsets[0]),
+                                 thrust::raw_pointer_cast(&A.column_indices[0]),
+                                 thrust::raw_pointer_cast(&A.values[0]),
+                                 thrust::raw_pointer_cast(&inverse[0]),
+                                 A.num_rows));
+        }
+    };
+
+    template <typename VectorType1, typename VectorType2>
+    struct apply_blocks
+    {
+        const cusp::array1d<ValueType,MemorySpace>& inverse;
+        const VectorType1& r;
+        VectorType2& x;
+        ValueType omega;
+
+        apply_blocks(const cusp::array1d<ValueType,MemorySpace>& inverse, const VectorType1& r, VectorType2& x, ValueType omega)
+            : inverse(inverse), r(r), x(x), omega(omega) {}
+
+        template <size_t N>
+        void apply(void)
+        {
+            MemorySpace system;
+
+            thrust::for_each(system,
+                             thrust::counting_iterator<int>(0),
+                             thrust::counting_iterator<int>((x.size() + N - 1) / N),
+                             detail::block_jacobi_functor<N,int,ValueType>(
+                                 thrust::raw_pointer_cast(&inverse[0]),
+                                 thrust::raw_pointer_cast(&r[0]),
+                                 thrust::raw_pointer_cast(&x[0]),
+                                 omega, x.size()));
+        }
+    };
+
+    // x <- x + omega * D^-1 * r
+    template<typename VectorType1, typename VectorType2>
+    void update(const VectorType1& r, VectorType2& x)
+    {
+        if(x.size() == 0)
+            return;
+
+        apply_blocks<VectorType1,VectorType2> op(inverse, r, x, omega);
+        dispatch(op);
+    }
+
+    template<typename MatrixType, typename VectorType1, typename VectorType2>
+    void sweep(const MatrixType& A, const VectorType1& b, VectorType2& x)
+    {
+        // r <- b - A * x
+        cusp::multiply(A, x, residual);
+        cusp::blas::axpby(b, residual, residual, ValueType(1), ValueType(-1));
+
+        update(residual, x);
+    }
+};
+/*! \}
+ */
+
+/* \cond */
+template <typename ValueType, typename MemorySpace>
+size_t operator_bytes(const block_jacobi_smoother<ValueType,MemorySpace>& S)
+{
+    return cusp::detail::num_bytes(S.inverse) +
+           cusp::detail::num_bytes(S.residual);
+}
+/* \endcond */
+
+} // end namespace precond
+} // end namespace cusp
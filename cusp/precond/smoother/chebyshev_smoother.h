@@ -0,0 +1,229 @@
+/*
+ *  Copyright 2008-2014 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*! \file chebyshev_smoother.h
+ *  \brief Chebyshev polynomial smoother for algebraic multigrid.
+ *
+ */
+
+#pragma once
+
+#include <cusp/detail/config.h>
+#include <cusp/detail/num_bytes.h>
+
+#include <cusp/array1d.h>
+#include <cusp/format_utils.h>
+#include <cusp/functional.h>
+#include <cusp/multiply.h>
+#include <cusp/eigen/spectral_radius.h>
+
+#include <thrust/copy.h>
+#include <thrust/fill.h>
+#include <thrust/for_each.h>
+#include <thrust/functional.h>
+#include <thrust/transform.h>
+#include <thrust/iterator/zip_iterator.h>
+
+namespace cusp
+{
+namespace precond
+{
+namespace detail
+{
+
+// combine functor for y <- y - A*x
+template <typename ValueType>
+struct chebyshev_residual_functor
+{
+    __host__ __device__
+    ValueType operator()(const ValueType& a, const ValueType& x) const
+    {
+        return -a * x;
+    }
+};
+
+// (d, r, Dinv, x) -> d <- alpha * d + beta * Dinv * r, x <- x + d
+template <typename ValueType>
+struct chebyshev_update_functor
+{
+    ValueType alpha;
+    ValueType beta;
+
+    chebyshev_update_functor(ValueType alpha, ValueType beta) : alpha(alpha), beta(beta) {}
+
+    template <typename Tuple>
+    __host__ __device__
+    void operator()(Tuple t) const
+    {
+        const ValueType d = alpha * thrust::get<0>(t) + beta * thrust::get<2>(t) * thrust::get<1>(t);
+
+        thrust::get<0>(t)  = d;
+        thrust::get<3>(t) += d;
+    }
+};
+
+} // end namespace detail
+
+/*! \addtogroup preconditioners Preconditioners
+ *  \ingroup preconditioners
+ *  \{
+ */
+
+/**
+ * \brief Chebyshev polynomial smoother
+ *
+ * \par Overview
+ *  Applies a Chebyshev polynomial in <tt>D^-1 A</tt> that damps the
+ *  eigenvalues in <tt>[lower, upper]</tt>, where <tt>upper = 1.1 rho</tt>,
+ *  <tt>lower = upper / 30</tt> and \c rho is the spectral radius
+ *  \c sa_level::rho_DinvA (estimated if not yet known). The three-term
+ *  recurrence needs only the spectral bounds, so each step is one SpMV that
+ *  updates the residual in place and one fused vector update applying the
+ *  inverse diagonal, without any inner products or reductions.
+ */
+template <typename ValueType, typename MemorySpace>
+class chebyshev_smoother
+{
+public:
+    size_t num_iters;
+    size_t degree;
+    ValueType lower_bound;
+    ValueType upper_bound;
+
+    cusp::array1d<ValueType,MemorySpace> inv_diagonal;
+    cusp::array1d<ValueType,MemorySpace> residual;
+    cusp::array1d<ValueType,MemorySpace> direction;
+
+    chebyshev_smoother(void) {}
+
+    template <typename ValueType2, typename MemorySpace2>
+    chebyshev_smoother(const chebyshev_smoother<ValueType2,MemorySpace2>& A)
+        : num_iters(A.num_iters), degree(A.degree),
+          lower_bound(A.lower_bound), upper_bound(A.upper_bound),
+          inv_diagonal(A.inv_diagonal), residual(A.residual), direction(A.direction) {}
+
+    template <typename MatrixType, typename Level>
+    chebyshev_smoother(const MatrixType& A, const Level& L, size_t degree=3)
+    {
+        initialize(A, L, degree);
+    }
+
+    template <typename MatrixType, typename Level>
+    void initialize(const MatrixType& A, const Level& L, size_t degree=3)
+    {
+        num_iters    = L.num_iters;
+        this->degree = degree;
+
+        double rho = L.rho_DinvA;
+        if(rho == 0.0)
+            rho = cusp::eigen::estimate_rho_Dinv_A(A);
+
+        upper_bound = ValueType(1.1 * rho);
+        lower_bound = upper_bound / ValueType(30);
+
+        // store D^-1 so the sweeps only multiply
+        cusp::extract_diagonal(A, inv_diagonal);
+        thrust::transform(inv_diagonal.begin(), inv_diagonal.end(), inv_diagonal.begin(),
+                          cusp::reciprocal_functor<ValueType>());
+
+        residual.resize(A.num_rows);
+        direction.resize(A.num_rows, ValueType(0));
+    }
+
+    // ignores initial x
+    template<typename MatrixType, typename VectorType1, typename VectorType2>
+    void presmooth(const MatrixType& A, const VectorType1& b, VectorType2& x)
+    {
+        for(size_t i = 0; i < num_iters; i++)
+            apply(A, b, x, i == 0);
+    }
+
+    // smooths initial x
+    template<typename MatrixType, typename VectorType1, typename VectorType2>
+    void postsmooth(const MatrixType& A, const VectorType1& b, VectorType2& x)
+    {
+        for(size_t i = 0; i < num_iters; i++)
+            apply(A, b, x, false);
+    }
+
+private:
+
+    template<typename MatrixType, typename VectorType>
+    void update_residual(const MatrixType& A, const VectorType& x)
+    {
+        // residual <- residual - A*x
+        cusp::multiply(A, x, residual,
+                       thrust::identity<ValueType>(),
+                       detail::chebyshev_residual_functor<ValueType>(),
+                       thrust::plus<ValueType>());
+    }
+
+    template<typename VectorType>
+    void update(VectorType& x, const ValueType alpha, const ValueType beta)
+    {
+        thrust::for_each(thrust::make_zip_iterator(thrust::make_tuple(direction.begin(), residual.begin(), inv_diagonal.begin(), x.begin())),
+                         thrust::make_zip_iterator(thrust::make_tuple(direction.end(),   residual.end(),   inv_diagonal.end(),   x.end())),
+                         detail::chebyshev_update_functor<ValueType>(alpha, beta));
+    }
+
+    template<typename MatrixType, typename VectorType1, typename VectorType2>
+    void apply(const MatrixType& A, const VectorType1& b, VectorType2& x, bool zero_initial_guess)
+    {
+        const ValueType theta = (upper_bound + lower_bound) / ValueType(2);
+        const ValueType delta = (upper_bound - lower_bound) / ValueType(2);
+        const ValueType sigma = theta / delta;
+
+        // residual <- b - A*x
+        thrust::copy(b.begin(), b.end(), residual.begin());
+
+        if(zero_initial_guess)
+            thrust::fill(x.begin(), x.end(), ValueType(0));
+        else
+            update_residual(A, x);
+
+        // direction <- D^-1 * residual / theta, x <- x + direction
+        update(x, ValueType(0), ValueType(1) / theta);
+
+        ValueType rho_old = ValueType(1) / sigma;
+
+        for(size_t k = 1; k < degree; k++)
+        {
+            update_residual(A, direction);
+
+            const ValueType rho_new = ValueType(1) / (ValueType(2) * sigma - rho_old);
+
+            // direction <- rho_new * rho_old * direction + 2 * rho_new / delta * D^-1 * residual
+            update(x, rho_new * rho_old, ValueType(2) * rho_new / delta);
+
+            rho_old = rho_new;
+        }
+    }
+};
+/*! \}
+ */
+
+/* \cond */
+template <typename ValueType, typename MemorySpace>
+size_t operator_bytes(const chebyshev_smoother<ValueType,MemorySpace>& S)
+{
+    return cusp::detail::num_bytes(S.inv_diagonal) +
+           cusp::detail::num_bytes(S.residual) +
+           cusp::detail::num_bytes(S.direction);
+}
+/* \endcond */
+
+} // end namespace precond
+} // end namespace cusp
@@ -22,6 +22,7 @@
 #pragma once
 
 #include <cusp/detail/config.h>
+#include <cusp/detail/num_bytes.h>
 
 #include <cusp/array1d.h>
 #include <cusp/format_utils.h>
@@ -72,7 +73,10 @@ public:
     void initialize(const MatrixType& A, const Level& L)
     {
         num_iters = L.num_iters;
-        M = BaseSmoother(A);
+
+        // the coloring and the color contiguous copy of A are computed
+        // once here and reused by every cycle
+        M = BaseSmoother(A, cusp::relaxation::SYMMETRIC, true);
     }
 
     // smooths initial x
@@ -94,6 +98,18 @@ public:
 /*! \}
  */
 
+/* \cond */
+template <typename ValueType, typename MemorySpace>
+size_t operator_bytes(const gauss_seidel_smoother<ValueType,MemorySpace>& S)
+{
+    return cusp::detail::num_bytes(S.M.ordering) +
+           cusp::detail::num_bytes(S.M.color_offsets) +
+           cusp::detail::num_bytes(S.M.diagonal) +
+           cusp::detail::num_bytes(S.M.colored_A) +
+           cusp::detail::num_bytes(S.M.colored_diagonal);
+}
+/* \endcond */
+
 } // end namespace precond
 } // end namespace cusp
 
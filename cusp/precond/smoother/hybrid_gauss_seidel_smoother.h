@@ -0,0 +1,212 @@
+/*
+ *  Copyright 2008-2014 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*! \file hybrid_gauss_seidel_smoother.h
+ *  \brief Hybrid Gauss-Seidel/Jacobi smoother for algebraic multigrid.
+ *
+ */
+
+#pragma once
+
+#include <cusp/detail/config.h>
+#include <cusp/detail/num_bytes.h>
+
+#include <cusp/array1d.h>
+#include <cusp/csr_matrix.h>
+#include <cusp/precond/smoother/l1_jacobi_smoother.h>
+
+#include <thrust/copy.h>
+#include <thrust/extrema.h>
+#include <thrust/for_each.h>
+#include <thrust/iterator/counting_iterator.h>
+
+namespace cusp
+{
+namespace precond
+{
+namespace detail
+{
+
+// Gauss-Seidel sweep over the rows of one block, the columns outside of
+// the block read the values of x from before the sweep
+template <typename IndexType, typename ValueType>
+struct hybrid_gauss_seidel_functor
+{
+    const IndexType * row_offsets;
+    const IndexType * column_indices;
+    const ValueType * values;
+    const ValueType * diagonal;
+    const ValueType * b;
+    const ValueType * x_old;
+    ValueType * x;
+    IndexType num_rows;
+    IndexType block_size;
+    bool forward;
+
+    hybrid_gauss_seidel_functor(const IndexType * row_offsets, const IndexType * column_indices,
+                                const ValueType * values, const ValueType * diagonal,
+                                const ValueType * b, const ValueType * x_old, ValueType * x,
+                                IndexType num_rows, IndexType block_size, bool forward)
+        : row_offsets(row_offsets), column_indices(column_indices), values(values),
+          diagonal(diagonal), b(b), x_old(x_old), x(x),
+          num_rows(num_rows), block_size(block_size), forward(forward) {}
+
+    __host__ __device__
+    void operator()(const IndexType block) const
+    {
+        const IndexType block_start = block * block_size;
+        const IndexType block_stop  = thrust::min(block_start + block_size, num_rows);
+
+        for(IndexType k = 0; k < block_stop - block_start; k++)
+        {
+            const IndexType i = forward ? block_start + k : block_stop - 1 - k;
+
+            ValueType residual = b[i];
+
+            for(IndexType jj = row_offsets[i]; jj < row_offsets[i + 1]; jj++)
+            {
+                const IndexType j = column_indices[jj];
+                const bool local  = block_start <= j && j < block_stop;
+
+                residual -= values[jj] * (local ? x[j] : x_old[j]);
+            }
+
+            x[i] += residual / diagonal[i];
+        }
+    }
+};
+
+} // end namespace detail
+
+/*! \addtogroup preconditioners Preconditioners
+ *  \ingroup preconditioners
+ *  \{
+ */
+
+/**
+ * \brief Hybrid Gauss-Seidel/Jacobi smoother
+ *
+ * \par Overview
+ *  The rows are split into contiguous blocks of \c block_size rows. Each
+ *  block is relaxed by a symmetric Gauss-Seidel sweep using the latest
+ *  values inside the block, while the blocks are coupled Jacobi-style
+ *  through the values of x from before the sweep, so all blocks are
+ *  relaxed in parallel by one thread each. The diagonal is augmented by
+ *  the absolute values of each row's entries outside its block (L1 hybrid
+ *  Gauss-Seidel), which keeps the iteration convergent for symmetric
+ *  positive definite matrices without a damping weight.
+ */
+template <typename ValueType, typename MemorySpace>
+class hybrid_gauss_seidel_smoother
+{
+public:
+    size_t num_iters;
+    size_t block_size;
+
+    cusp::csr_matrix<int,ValueType,MemorySpace> csr_A;
+    cusp::array1d<ValueType,MemorySpace> diagonal;
+    cusp::array1d<ValueType,MemorySpace> x_old;
+
+    hybrid_gauss_seidel_smoother(void) {}
+
+    template <typename ValueType2, typename MemorySpace2>
+    hybrid_gauss_seidel_smoother(const hybrid_gauss_seidel_smoother<ValueType2,MemorySpace2>& M)
+        : num_iters(M.num_iters), block_size(M.block_size),
+          csr_A(M.csr_A), diagonal(M.diagonal), x_old(M.x_old) {}
+
+    template <typename MatrixType, typename Level>
+    hybrid_gauss_seidel_smoother(const MatrixType& A, const Level& L, size_t block_size=32)
+    {
+        initialize(A, L, block_size);
+    }
+
+    template <typename MatrixType, typename Level>
+    void initialize(const MatrixType& A, const Level& L, size_t block_size=32)
+    {
+        num_iters        = L.num_iters;
+        this->block_size = block_size;
+        csr_A            = A;
+
+        detail::l1_diagonal(csr_A, diagonal, block_size);
+        x_old.resize(A.num_rows);
+    }
+
+    // smooths initial x
+    template<typename MatrixType, typename VectorType1, typename VectorType2>
+    void presmooth(const MatrixType& A, const VectorType1& b, VectorType2& x)
+    {
+        for(size_t i = 0; i < num_iters; i++)
+            smooth(b, x);
+    }
+
+    // smooths initial x
+    template<typename MatrixType, typename VectorType1, typename VectorType2>
+    void postsmooth(const MatrixType& A, const VectorType1& b, VectorType2& x)
+    {
+        for(size_t i = 0; i < num_iters; i++)
+            smooth(b, x);
+    }
+
+private:
+
+    template<typename VectorType1, typename VectorType2>
+    void smooth(const VectorType1& b, VectorType2& x)
+    {
+        if(csr_A.num_rows == 0)
+            return;
+
+        sweep(b, x, true);
+        sweep(b, x, false);
+    }
+
+    template<typename VectorType1, typename VectorType2>
+    void sweep(const VectorType1& b, VectorType2& x, bool forward)
+    {
+        MemorySpace system;
+
+        const int num_blocks = (csr_A.num_rows + block_size - 1) / block_size;
+
+        thrust::copy(x.begin(), x.end(), x_old.begin());
+
+        thrust::for_each(system,
+                         thrust::counting_iterator<int>(0),
+                         thrust::counting_iterator<int>(num_blocks),
+                         detail::hybrid_gauss_seidel_functor<int,ValueType>(
+                             thrust::raw_pointer_cast(&csr_A.row_offsets[0]),
+                             thrust::raw_pointer_cast(&csr_A.column_indices[0]),
+                             thrust::raw_pointer_cast(&csr_A.values[0]),
+                             thrust::raw_pointer_cast(&diagonal[0]),
+                             thrust::raw_pointer_cast(&b[0]),
+                             thrust::raw_pointer_cast(&x_old[0]),
+                             thrust::raw_pointer_cast(&x[0]),
+                             csr_A.num_rows, block_size, forward));
+    }
+};
+/*! \}
+ */
+
+/* \cond */
+template <typename ValueType, typename MemorySpace>
+size_t operator_bytes(const hybrid_gauss_seidel_smoother<ValueType,MemorySpace>& S)
+{
+    return cusp::detail::num_bytes(S.csr_A) +
+           cusp::detail::num_bytes(S.diagonal) +
+           cusp::detail::num_bytes(S.x_old);
+}
+/* \endcond */
+
+} // end namespace precond
+} // end namespace cusp
@@ -22,12 +22,16 @@
 #pragma once
 
 #include <cusp/detail/config.h>
+#include <cusp/detail/num_bytes.h>
 
 #include <cusp/format_utils.h>
 #include <cusp/eigen/spectral_radius.h>
 #include <cusp/relaxation/jacobi.h>
 
+#include <cusp/multiply.h>
+
 #include <thrust/transform.h>
+#include <thrust/iterator/zip_iterator.h>
 
 namespace cusp
 {
@@ -48,6 +52,22 @@ struct jacobi_presmooth_functor
     }
 };
 
+template <typename ValueType>
+struct jacobi_postsmooth_functor
+{
+    ValueType omega;
+
+    jacobi_postsmooth_functor(ValueType omega) : omega(omega) {}
+
+    // x + omega * D^-1 * (b - A x)
+    template <typename Tuple>
+    __host__ __device__
+    ValueType operator()(const Tuple& t) const
+    {
+        return thrust::get<0>(t) + omega * (thrust::get<2>(t) - thrust::get<3>(t)) / thrust::get<1>(t);
+    }
+};
+
 /*! \addtogroup preconditioners Preconditioners
  *  \ingroup preconditioners
  *  \{
@@ -100,13 +120,46 @@ public:
     template<typename MatrixType, typename VectorType1, typename VectorType2>
     void postsmooth(const MatrixType& A, const VectorType1& b, VectorType2& x)
     {
-        for(size_t i = 0; i < num_iters; i++)
-          M(A, b, x);
+        // all sweeps are handed to the relaxation at once
+        M(A, b, x, M.default_omega, num_iters);
     }
 };
 /*! \}
  */
 
+/* \cond */
+template <typename ValueType, typename MemorySpace>
+size_t operator_bytes(const jacobi_smoother<ValueType,MemorySpace>& S)
+{
+    return cusp::detail::num_bytes(S.M.diagonal) +
+           cusp::detail::num_bytes(S.M.temp) +
+           cusp::detail::num_bytes(S.M.barrier);
+}
+
+// the residual of all columns is computed by one product with A per sweep
+template <typename ValueType, typename MemorySpace, typename MatrixType, typename BlockType>
+void block_postsmooth(jacobi_smoother<ValueType,MemorySpace>& S,
+                      const MatrixType& A, const BlockType& B, BlockType& X, BlockType& workspace)
+{
+    for(size_t i = 0; i < S.num_iters; i++)
+    {
+        cusp::multiply(A, X, workspace);
+
+        for(size_t k = 0; k < X.num_cols; k++)
+        {
+            typename BlockType::column_view       x(X.column(k));
+            typename BlockType::const_column_view b(B.column(k));
+            typename BlockType::column_view       y(workspace.column(k));
+
+            thrust::transform(thrust::make_zip_iterator(thrust::make_tuple(x.begin(), S.M.diagonal.begin(), b.begin(), y.begin())),
+                              thrust::make_zip_iterator(thrust::make_tuple(x.end(),   S.M.diagonal.end(),   b.end(),   y.end())),
+                              x.begin(),
+                              jacobi_postsmooth_functor<ValueType>(S.M.default_omega));
+        }
+    }
+}
+/* \endcond */
+
 } // end namespace precond
 } // end namespace cusp
 
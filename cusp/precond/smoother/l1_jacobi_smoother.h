@@ -0,0 +1,188 @@
+/*
+ *  Copyright 2008-2014 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*! \file l1_jacobi_smoother.h
+ *  \brief L1-Jacobi smoother for algebraic multigrid.
+ *
+ */
+
+#pragma once
+
+#include <cusp/detail/config.h>
+#include <cusp/detail/num_bytes.h>
+
+#include <cusp/array1d.h>
+#include <cusp/complex.h>
+#include <cusp/csr_matrix.h>
+#include <cusp/precond/smoother/jacobi_smoother.h>
+
+#include <thrust/extrema.h>
+#include <thrust/transform.h>
+#include <thrust/iterator/counting_iterator.h>
+
+namespace cusp
+{
+namespace precond
+{
+namespace detail
+{
+
+// d_i <- a_ii + sum |a_ij| over the columns j outside the block of rows
+// containing i, with block_size == 1 this is the L1 row sum of A
+template <typename IndexType, typename ValueType>
+struct l1_diagonal_functor
+{
+    const IndexType * row_offsets;
+    const IndexType * column_indices;
+    const ValueType * values;
+    IndexType num_rows;
+    IndexType block_size;
+
+    l1_diagonal_functor(const IndexType * row_offsets, const IndexType * column_indices,
+                        const ValueType * values, IndexType num_rows, IndexType block_size)
+        : row_offsets(row_offsets), column_indices(column_indices), values(values),
+          num_rows(num_rows), block_size(block_size) {}
+
+    __host__ __device__
+    ValueType operator()(const IndexType i) const
+    {
+        const IndexType block_start = (i / block_size) * block_size;
+        const IndexType block_stop  = thrust::min(block_start + block_size, num_rows);
+
+        ValueType sum(0);
+
+        for(IndexType jj = row_offsets[i]; jj < row_offsets[i + 1]; jj++)
+        {
+            const IndexType j = column_indices[jj];
+
+            if(j == i)
+                sum += values[jj];
+            else if(j < block_start || j >= block_stop)
+                sum += cusp::abs(values[jj]);
+        }
+
+        return sum;
+    }
+};
+
+template <typename MatrixType, typename ArrayType>
+void l1_diagonal(const MatrixType& A, ArrayType& diagonal, const int block_size)
+{
+    typedef typename MatrixType::value_type ValueType;
+
+    diagonal.resize(A.num_rows);
+
+    if(A.num_rows == 0)
+        return;
+
+    thrust::transform(thrust::counting_iterator<int>(0),
+                      thrust::counting_iterator<int>(A.num_rows),
+                      diagonal.begin(),
+                      l1_diagonal_functor<int,ValueType>(thrust::raw_pointer_cast(&A.row_offsets[0]),
+                                                         thrust::raw_pointer_cast(&A.column_indices[0]),
+                                                         thrust::raw_pointer_cast(&A.values[0]),
+                                                         A.num_rows, block_size));
+}
+
+} // end namespace detail
+
+/*! \addtogroup preconditioners Preconditioners
+ *  \ingroup preconditioners
+ *  \{
+ */
+
+/**
+ * \brief L1-Jacobi smoother
+ *
+ * \par Overview
+ *  Undamped Jacobi iteration with the diagonal replaced by
+ *  <tt>a_ii + sum_{j != i} |a_ij|</tt>. For symmetric positive definite
+ *  matrices the iteration converges without a spectral radius estimate or a
+ *  damping weight, which makes it robust on anisotropic problems where the
+ *  weighted \p jacobi_smoother may diverge. The modified diagonal is
+ *  computed in a single pass over the nonzeros during setup.
+ */
+template <typename ValueType, typename MemorySpace>
+class l1_jacobi_smoother
+{
+private:
+
+    typedef cusp::relaxation::jacobi<ValueType,MemorySpace> BaseSmoother;
+
+public:
+    size_t num_iters;
+    BaseSmoother M;
+
+    l1_jacobi_smoother(void) {}
+
+    template <typename ValueType2, typename MemorySpace2>
+    l1_jacobi_smoother(const l1_jacobi_smoother<ValueType2,MemorySpace2>& A) : num_iters(A.num_iters), M(A.M) {}
+
+    template <typename MatrixType, typename Level>
+    l1_jacobi_smoother(const MatrixType& A, const Level& L)
+    {
+        initialize(A, L);
+    }
+
+    template <typename MatrixType, typename Level>
+    void initialize(const MatrixType& A, const Level& L)
+    {
+        num_iters = L.num_iters;
+
+        cusp::csr_matrix<int,ValueType,MemorySpace> C(A);
+
+        M.default_omega = ValueType(1);
+        M.temp.resize(A.num_rows);
+        detail::l1_diagonal(C, M.diagonal, 1);
+    }
+
+    // ignores initial x
+    template<typename MatrixType, typename VectorType1, typename VectorType2>
+    void presmooth(const MatrixType& A, const VectorType1& b, VectorType2& x)
+    {
+        if(num_iters == 0)
+            return;
+
+        // x <- D^-1 * b
+        thrust::transform(b.begin(), b.end(), M.diagonal.begin(), x.begin(),
+                          jacobi_presmooth_functor<ValueType>(ValueType(1)));
+
+        for(size_t i = 1; i < num_iters; i++)
+            M(A, b, x);
+    }
+
+    // smooths initial x
+    template<typename MatrixType, typename VectorType1, typename VectorType2>
+    void postsmooth(const MatrixType& A, const VectorType1& b, VectorType2& x)
+    {
+        for(size_t i = 0; i < num_iters; i++)
+            M(A, b, x);
+    }
+};
+/*! \}
+ */
+
+/* \cond */
+template <typename ValueType, typename MemorySpace>
+size_t operator_bytes(const l1_jacobi_smoother<ValueType,MemorySpace>& S)
+{
+    return cusp::detail::num_bytes(S.M.diagonal) +
+           cusp::detail::num_bytes(S.M.temp);
+}
+/* \endcond */
+
+} // end namespace precond
+} // end namespace cusp
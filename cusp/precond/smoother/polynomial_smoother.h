@@ -22,6 +22,7 @@
 #pragma once
 
 #include <cusp/detail/config.h>
+#include <cusp/detail/num_bytes.h>
 
 #include <cusp/format_utils.h>
 #include <cusp/multiply.h>
@@ -72,44 +73,31 @@ public:
     template<typename MatrixType, typename VectorType1, typename VectorType2>
     void presmooth(const MatrixType& A, const VectorType1& b, VectorType2& x)
     {
-        // Ignore the initial x and use b as the residual
-        ValueType scale_factor = M.default_coefficients[0];
-        cusp::blas::axpby(b, x, x, scale_factor, ValueType(0));
-
-        for( size_t i = 1; i < M.default_coefficients.size(); i++ )
-        {
-            scale_factor = M.default_coefficients[i];
-
-            cusp::multiply(A, x, M.y);
-            cusp::blas::axpby(M.y, b, x, ValueType(1.0), scale_factor);
-        }
+        M.relax(A, b, x, M.default_coefficients, true);
     }
 
     // smooths initial x
     template<typename MatrixType, typename VectorType1, typename VectorType2>
     void postsmooth(const MatrixType& A, const VectorType1& b, VectorType2& x)
     {
-        // compute residual <- b - A*x
-        cusp::multiply(A, x, M.residual);
-        cusp::blas::axpby(b, M.residual, M.residual, ValueType(1), ValueType(-1));
-
-        ValueType scale_factor = M.default_coefficients[0];
-        cusp::blas::axpby(M.residual, M.h, M.h, scale_factor, ValueType(0));
-
-        for( size_t i = 1; i < M.default_coefficients.size(); i++ )
-        {
-            scale_factor = M.default_coefficients[i];
-
-            cusp::multiply(A, M.h, M.y);
-            cusp::blas::axpby(M.y, M.residual, M.h, ValueType(1.0), scale_factor);
-        }
-
-        cusp::blas::axpy(M.h, x, ValueType(1.0));
+        M.relax(A, b, x, M.default_coefficients, false);
     }
 };
 /*! \}
  */
 
+/* \cond */
+template <typename ValueType, typename MemorySpace>
+size_t operator_bytes(const polynomial_smoother<ValueType,MemorySpace>& S)
+{
+    return cusp::detail::num_bytes(S.M.default_coefficients) +
+           cusp::detail::num_bytes(S.M.residual) +
+           cusp::detail::num_bytes(S.M.h) +
+           cusp::detail::num_bytes(S.M.y) +
+           cusp::detail::num_bytes(S.M.barrier);
+}
+/* \endcond */
+
 } // end namespace precond
 } // end namespace cusp
 
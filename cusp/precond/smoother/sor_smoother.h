@@ -22,6 +22,7 @@
 #pragma once
 
 #include <cusp/detail/config.h>
+#include <cusp/detail/num_bytes.h>
 
 #include <cusp/eigen/spectral_radius.h>
 #include <cusp/relaxation/sor.h>
@@ -89,6 +90,19 @@ public:
 /*! \}
  */
 
+/* \cond */
+template <typename ValueType, typename MemorySpace>
+size_t operator_bytes(const sor_smoother<ValueType,MemorySpace>& S)
+{
+    return cusp::detail::num_bytes(S.M.temp) +
+           cusp::detail::num_bytes(S.M.gs.ordering) +
+           cusp::detail::num_bytes(S.M.gs.color_offsets) +
+           cusp::detail::num_bytes(S.M.gs.diagonal) +
+           cusp::detail::num_bytes(S.M.gs.colored_A) +
+           cusp::detail::num_bytes(S.M.gs.colored_diagonal);
+}
+/* \endcond */
+
 } // end namespace precond
 } // end namespace cusp
 
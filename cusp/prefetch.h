@@ -0,0 +1,143 @@
+/*
+ *  Copyright 2008-2014 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+
+/*! \file prefetch.h
+ *  \brief Placement hints for containers in managed memory
+ */
+
+#pragma once
+
+#include <cusp/detail/config.h>
+
+#include <cusp/memory.h>
+
+namespace cusp
+{
+
+/*! \addtogroup utilities Utilities
+ *  \{
+ */
+
+/*! \brief Usage hints accepted by \p cusp::advise.
+ */
+enum memory_advice
+{
+    /*! The data is mostly read, processors keep read-only copies of its pages. */
+    advise_read_mostly,
+
+    /*! The pages should reside at the given location and are migrated there
+     *  when they are evicted. */
+    advise_preferred_location,
+
+    /*! The data is accessed from the given location, whose page tables keep
+     *  a mapping of the pages wherever they reside. */
+    advise_accessed_by
+};
+
+/**
+ * \brief Migrate the storage of a managed container to a location ahead of
+ * its use.
+ *
+ * \tparam MatrixType type of the container
+ * \tparam MemorySpace \p cusp::host_memory or \p cusp::device_memory
+ *
+ * \param A \p array1d, \p array2d, \p coo_matrix, \p csr_matrix,
+ * \p dia_matrix, \p ell_matrix or \p hyb_matrix
+ * \param location memory space whose processor will access \p A next,
+ * device locations refer to the current device
+ *
+ * \par Overview
+ *  The migration is enqueued on the default stream and overlaps with host
+ *  work, kernels launched later on the default stream see the migrated
+ *  pages, avoiding the page faults they would otherwise take. \p prefetch
+ *  has no effect unless \p A resides in \p cusp::managed_memory, and it
+ *  is silently ignored by devices and systems without support for it.
+ *
+ * \par Example
+ *  \code
+ *  #include <cusp/csr_matrix.h>
+ *  #include <cusp/gallery/poisson.h>
+ *  #include <cusp/multiply.h>
+ *  #include <cusp/prefetch.h>
+ *
+ *  int main(void)
+ *  {
+ *      cusp::csr_matrix<int, float, cusp::managed_memory> A;
+ *      cusp::gallery::poisson5pt(A, 1000, 1000);
+ *
+ *      cusp::array1d<float, cusp::managed_memory> x(A.num_cols, 1);
+ *      cusp::array1d<float, cusp::managed_memory> y(A.num_rows);
+ *
+ *      // multiply on the device without page faults
+ *      cusp::prefetch(A, cusp::device_memory());
+ *      cusp::multiply(A, x, y);
+ *
+ *      // read the result on the host
+ *      cusp::prefetch(y, cusp::host_memory());
+ *
+ *      return 0;
+ *  }
+ *  \endcode
+ */
+template <typename MatrixType, typename MemorySpace>
+void prefetch(const MatrixType& A, MemorySpace location);
+
+/**
+ * \brief Declare how the storage of a managed container will be used.
+ *
+ * \tparam MatrixType type of the container
+ * \tparam MemorySpace \p cusp::host_memory or \p cusp::device_memory
+ *
+ * \param A \p array1d, \p array2d, \p coo_matrix, \p csr_matrix,
+ * \p dia_matrix, \p ell_matrix or \p hyb_matrix
+ * \param advice usage hint
+ * \param location location the hint refers to, ignored by
+ * \p advise_read_mostly; device locations refer to the current device
+ *
+ * \par Overview
+ *  Hints let the driver place the pages of a container which exceeds the
+ *  device memory sensibly, e.g. a multigrid hierarchy whose coarse levels
+ *  prefer host memory while the fine levels stay on the device. \p advise
+ *  has no effect unless \p A resides in \p cusp::managed_memory, and it
+ *  is silently ignored by devices and systems without support for it.
+ *
+ * \par Example
+ *  \code
+ *  #include <cusp/csr_matrix.h>
+ *  #include <cusp/gallery/poisson.h>
+ *  #include <cusp/prefetch.h>
+ *
+ *  int main(void)
+ *  {
+ *      cusp::csr_matrix<int, float, cusp::managed_memory> A;
+ *      cusp::gallery::poisson5pt(A, 1000, 1000);
+ *
+ *      // the matrix is not modified by the solver
+ *      cusp::advise(A, cusp::advise_read_mostly, cusp::device_memory());
+ *
+ *      return 0;
+ *  }
+ *  \endcode
+ */
+template <typename MatrixType, typename MemorySpace>
+void advise(const MatrixType& A, memory_advice advice, MemorySpace location);
+/*! \}
+ */
+
+} // end namespace cusp
+
+#include <cusp/detail/prefetch.inl>
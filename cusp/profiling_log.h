@@ -0,0 +1,186 @@
+/*
+ *  Copyright 2008-2014 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*! \file cusp/profiling_log.h
+ *  \brief Per function call counts, timings and traffic estimates
+ */
+
+#pragma once
+
+#include <cusp/detail/config.h>
+
+#if THRUST_DEVICE_SYSTEM == THRUST_DEVICE_SYSTEM_CUDA
+#include <cuda_runtime_api.h>
+#endif
+
+#include <cstddef>
+#include <map>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace cusp
+{
+
+/*! \addtogroup utilities Utilities
+ *  \{
+ */
+
+/**
+ * \brief Accumulates the calls recorded by a profiling execution policy
+ *
+ * \par Overview
+ *  Every call made through a policy returned by the \p profiling member of
+ *  a system's \p par, e.g. <tt>cusp::device_memory().profiling(log)</tt>,
+ *  adds one record to the entry of the called function: the number of
+ *  calls, the wall time on the host, the time between two CUDA events
+ *  recorded around the call on the default stream when the policy runs on
+ *  the CUDA system, and an estimate of the bytes read and written by the
+ *  call. The times are inclusive, so a \p cusp::multiply with a
+ *  preconditioner also contains the calls made by the preconditioner, which
+ *  are recorded under their own names as well.
+ *
+ *  Recording does not wait for the device. The wall time of an asynchronous
+ *  call measures its launch, while the elapsed time of its events is read
+ *  once the events have completed, which the log checks when it records
+ *  further calls and enforces when the entries are read.
+ *
+ * \note A log is not thread safe and must outlive the policies using it.
+ *
+ * \par Example
+ *  \code
+ *  #include <cusp/csr_matrix.h>
+ *  #include <cusp/monitor.h>
+ *  #include <cusp/profiling_policy.h>
+ *  #include <cusp/gallery/poisson.h>
+ *  #include <cusp/krylov/cg.h>
+ *
+ *  #include <iostream>
+ *
+ *  int main(void)
+ *  {
+ *      cusp::csr_matrix<int, float, cusp::device_memory> A;
+ *      cusp::gallery::poisson5pt(A, 256, 256);
+ *
+ *      cusp::array1d<float, cusp::device_memory> x(A.num_rows, 0);
+ *      cusp::array1d<float, cusp::device_memory> b(A.num_rows, 1);
+ *
+ *      cusp::profiling_log log;
+ *
+ *      cusp::monitor<float> monitor(b, 100, 1e-6);
+ *      cusp::krylov::cg(cusp::device_memory().profiling(log), A, x, b, monitor);
+ *
+ *      // calls, seconds and bytes of cusp::multiply, cusp::blas::dot, ...
+ *      log.write_json(std::cout);
+ *
+ *      return 0;
+ *  }
+ *  \endcode
+ */
+class profiling_log
+{
+public:
+
+    /*! Totals of the calls of one function.
+     */
+    struct entry
+    {
+        size_t calls;           //!< number of calls
+        double wall_time;       //!< inclusive host seconds
+        double kernel_time;     //!< inclusive device seconds, 0 on other systems
+        size_t bytes_read;      //!< estimated bytes read
+        size_t bytes_written;   //!< estimated bytes written
+
+        entry(void);
+    };
+
+    /*! \cond */
+    typedef std::map<std::string, entry> entry_map;
+    /*! \endcond */
+
+    /*! Construct an empty log.
+     */
+    profiling_log(void);
+
+    ~profiling_log(void);
+
+    /*! Add a call of \p name which took \p seconds on the host.
+     */
+    void record(const char* name, const double seconds,
+                const size_t bytes_read, const size_t bytes_written);
+
+#if THRUST_DEVICE_SYSTEM == THRUST_DEVICE_SYSTEM_CUDA
+    /*! Add a call of \p name whose device work is enclosed by the events
+     *  \p start and \p stop, which are returned to the log.
+     */
+    void record(const char* name, const double seconds,
+                const size_t bytes_read, const size_t bytes_written,
+                cudaEvent_t start, cudaEvent_t stop);
+
+    /*! An event owned by the log and returned by \p record.
+     */
+    cudaEvent_t event(void);
+#endif
+
+    /*! Totals of all functions called so far, keyed by function name.
+     */
+    const entry_map& entries(void) const;
+
+    /*! Totals of the function \p name, all zero if it was never called.
+     */
+    entry operator[](const std::string& name) const;
+
+    /*! Discard all records.
+     */
+    void reset(void);
+
+    /*! Write the totals as a JSON object with one member per function,
+     *  e.g. <tt>{"cusp::blas::dot": {"calls": 2, "wall_seconds": ...,
+     *  "kernel_seconds": ..., "bytes_read": 64, "bytes_written": 0}}</tt>.
+     */
+    void write_json(std::ostream& os) const;
+
+private:
+
+    /*! \cond */
+    mutable entry_map m_entries;
+
+#if THRUST_DEVICE_SYSTEM == THRUST_DEVICE_SYSTEM_CUDA
+    struct pending_call
+    {
+        entry*      target;
+        cudaEvent_t start;
+        cudaEvent_t stop;
+    };
+
+    mutable std::vector<pending_call> m_pending;
+    mutable std::vector<cudaEvent_t>  m_free_events;
+#endif
+
+    // adds the elapsed times of completed events, of all events if wait
+    void resolve(const bool wait) const;
+
+    // the log owns its events
+    profiling_log(const profiling_log&);
+    profiling_log& operator=(const profiling_log&);
+    /*! \endcond */
+}; // class profiling_log
+/*! \}
+ */
+
+} // end namespace cusp
+
+#include <cusp/detail/profiling_log.inl>
@@ -0,0 +1,63 @@
+/*
+ *  Copyright 2008-2014 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+
+/*! \file cusp/profiling_policy.h
+ *  \brief Execution policies recording the calls made through them
+ */
+
+#pragma once
+
+#include <cusp/detail/config.h>
+
+#include <cusp/execution_policy.h>
+#include <cusp/profiling_log.h>
+
+#include <cusp/system/detail/profiling/execution_policy.h>
+
+namespace cusp
+{
+
+/*! \addtogroup utilities Utilities
+ *  \{
+ */
+
+/**
+ * \brief Policy running on the device system and recording its calls
+ *
+ * \par Overview
+ *  The policy runs every algorithm on the device system, but the calls of
+ *  \p cusp::multiply, \p multiply_transpose, \p convert, \p transpose and
+ *  of the \p cusp::blas routines \p amax, \p asum, \p axpy, \p axpby,
+ *  \p axpbypcz, \p xmy, \p copy, \p dot, \p dotc, \p fill, \p nrm2,
+ *  \p nrmmax and \p scal are added to a \p cusp::profiling_log, including
+ *  the calls made inside the solvers and preconditioners the policy is
+ *  passed to. A policy for any system is returned by the \p profiling
+ *  member of its \p par, e.g. <tt>cusp::omp::par.profiling(log)</tt>.
+ *
+ * \see profiling_log
+ */
+typedef cusp::system::detail::profiling::execute_profiling<
+          cusp::system::__THRUST_DEVICE_SYSTEM_NAMESPACE::detail::execution_policy> profiling_policy;
+
+/*! \brief Policy running on the host system and recording its calls */
+typedef cusp::system::detail::profiling::execute_profiling<
+          cusp::system::__THRUST_HOST_SYSTEM_NAMESPACE::detail::execution_policy>   host_profiling_policy;
+
+/*! \}
+ */
+
+} // end namespace cusp
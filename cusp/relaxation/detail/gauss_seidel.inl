@@ -21,10 +21,20 @@
 #include <cusp/system/detail/generic/relaxation/gauss_seidel.h>
 #include <cusp/system/detail/adl/relaxation/gauss_seidel.h>
 
+#include <cusp/functional.h>
+
+#include <thrust/copy.h>
+#include <thrust/count.h>
+#include <thrust/gather.h>
 #include <thrust/reduce.h>
+#include <thrust/scatter.h>
 #include <thrust/sequence.h>
 #include <thrust/sort.h>
 
+#include <thrust/iterator/counting_iterator.h>
+#include <thrust/iterator/permutation_iterator.h>
+#include <thrust/iterator/zip_iterator.h>
+
 namespace cusp
 {
 namespace relaxation
@@ -33,9 +43,9 @@ namespace relaxation
 template <typename ValueType, typename MemorySpace>
 template<typename MatrixType>
 gauss_seidel<ValueType,MemorySpace>
-::gauss_seidel(const MatrixType& A, sweep default_direction,
+::gauss_seidel(const MatrixType& A, sweep default_direction, bool multicolor,
                typename thrust::detail::enable_if_convertible<typename MatrixType::format,cusp::csr_format>::type*)
-    : ordering(A.num_rows), default_direction(default_direction)
+    : ordering(A.num_rows), default_direction(default_direction), multicolor(multicolor)
 {
     cusp::array1d<int,MemorySpace> colors(A.num_rows);
     int max_colors = cusp::graph::vertex_coloring(A, colors);
@@ -53,6 +63,50 @@ gauss_seidel<ValueType,MemorySpace>
     color_offsets = temp;
 
     cusp::extract_diagonal(A, diagonal);
+
+    if(multicolor)
+        build_colored_matrix(A);
+}
+
+// stores the off-diagonal entries of row ordering[r] of A as row r of
+// colored_A, keeping the order of the entries within each row
+template <typename ValueType, typename MemorySpace>
+template<typename MatrixType>
+void gauss_seidel<ValueType,MemorySpace>
+::build_colored_matrix(const MatrixType& A)
+{
+    const size_t N = A.num_rows;
+
+    cusp::array1d<int,MemorySpace> rank(N);
+    thrust::scatter(thrust::counting_iterator<int>(0), thrust::counting_iterator<int>(N),
+                    ordering.begin(), rank.begin());
+
+    cusp::array1d<int,MemorySpace> row_indices(A.num_entries);
+    cusp::offsets_to_indices(A.row_offsets, row_indices);
+
+    const size_t num_offdiagonals =
+        A.num_entries - thrust::count_if(thrust::make_zip_iterator(thrust::make_tuple(row_indices.begin(), A.column_indices.begin())),
+                                         thrust::make_zip_iterator(thrust::make_tuple(row_indices.end(),   A.column_indices.end())),
+                                         cusp::equal_pair_functor<int>());
+
+    cusp::array1d<int,MemorySpace> colored_rows(num_offdiagonals);
+    colored_A.resize(N, N, num_offdiagonals);
+
+    thrust::copy_if(thrust::make_zip_iterator(thrust::make_tuple(thrust::make_permutation_iterator(rank.begin(), row_indices.begin()),
+                                                                 A.column_indices.begin(), A.values.begin())),
+                    thrust::make_zip_iterator(thrust::make_tuple(thrust::make_permutation_iterator(rank.begin(), row_indices.end()),
+                                                                 A.column_indices.end(), A.values.end())),
+                    thrust::make_zip_iterator(thrust::make_tuple(row_indices.begin(), A.column_indices.begin())),
+                    thrust::make_zip_iterator(thrust::make_tuple(colored_rows.begin(), colored_A.column_indices.begin(), colored_A.values.begin())),
+                    cusp::not_equal_pair_functor<int>());
+
+    thrust::stable_sort_by_key(colored_rows.begin(), colored_rows.end(),
+                               thrust::make_zip_iterator(thrust::make_tuple(colored_A.column_indices.begin(), colored_A.values.begin())));
+
+    cusp::indices_to_offsets(colored_rows, colored_A.row_offsets);
+
+    colored_diagonal.resize(N);
+    thrust::gather(ordering.begin(), ordering.end(), diagonal.begin(), colored_diagonal.begin());
 }
 
 // linear_operator
@@ -77,14 +131,12 @@ void gauss_seidel<ValueType,MemorySpace>
     if(direction == FORWARD)
     {
         for(size_t i = 0; i < color_offsets.size()-1; i++)
-            gauss_seidel_indexed(thrust::detail::derived_cast(system),
-                A, x, b, ordering, color_offsets[i], color_offsets[i+1], 1);
+            relax_color(A, b, x, color_offsets[i], color_offsets[i+1]);
     }
     else if(direction == BACKWARD)
     {
         for(size_t i = color_offsets.size()-1; i > 0; i--)
-            gauss_seidel_indexed(thrust::detail::derived_cast(system),
-                A, x, b, ordering, color_offsets[i-1], color_offsets[i], 1);
+            relax_color(A, b, x, color_offsets[i-1], color_offsets[i]);
     }
     else if(direction == SYMMETRIC)
     {
@@ -97,6 +149,22 @@ void gauss_seidel<ValueType,MemorySpace>
     }
 }
 
+template <typename ValueType, typename MemorySpace>
+template<typename MatrixType, typename VectorType1, typename VectorType2>
+void gauss_seidel<ValueType,MemorySpace>
+::relax_color(const MatrixType& A, const VectorType1& b, VectorType2& x,
+              const int row_start, const int row_stop)
+{
+    MemorySpace system;
+
+    if(multicolor)
+        gauss_seidel_multicolor(thrust::detail::derived_cast(system),
+            colored_A, colored_diagonal, ordering, x, b, row_start, row_stop, ValueType(1));
+    else
+        gauss_seidel_indexed(thrust::detail::derived_cast(system),
+            A, x, b, ordering, row_start, row_stop, 1);
+}
+
 } // end namespace relaxation
 } // end namespace cusp
 
@@ -14,42 +14,15 @@
  *  limitations under the License.
  */
 
-#include <cusp/multiply.h>
 #include <cusp/format_utils.h>
 
-#include <thrust/functional.h>
-#include <thrust/transform.h>
-#include <thrust/iterator/zip_iterator.h>
+#include <cusp/system/detail/generic/relaxation/jacobi.h>
+#include <cusp/system/detail/adl/relaxation/jacobi.h>
 
 namespace cusp
 {
 namespace relaxation
 {
-namespace detail
-{
-
-template <typename ValueType>
-struct jacobi_relax_functor
-{
-    ValueType omega;
-
-    jacobi_relax_functor(ValueType omega) : omega(omega) {}
-
-    template <typename Tuple>
-    __host__ __device__
-    ValueType operator()(const Tuple& t)
-    {
-        const ValueType x = thrust::get<0>(t);
-        const ValueType d = thrust::get<1>(t);
-        const ValueType b = thrust::get<2>(t);
-        const ValueType y = thrust::get<3>(t);
-
-        return x + omega * (b - y) / d;
-    }
-};
-
-} // end namespace detail
-
 
 template <typename ValueType, typename MemorySpace>
 template<typename MatrixType>
@@ -76,14 +49,20 @@ template<typename MatrixType, typename VectorType1, typename VectorType2>
 void jacobi<ValueType,MemorySpace>
 ::operator()(const MatrixType& A, const VectorType1& b, VectorType2& x, const ValueType omega)
 {
-    // y <- A*x
-    cusp::multiply(A, x, temp);
+    jacobi<ValueType,MemorySpace>::operator()(A,b,x,omega,1);
+}
+
+// several sweeps at once
+template <typename ValueType, typename MemorySpace>
+template<typename MatrixType, typename VectorType1, typename VectorType2>
+void jacobi<ValueType,MemorySpace>
+::operator()(const MatrixType& A, const VectorType1& b, VectorType2& x, const ValueType omega, const size_t num_sweeps)
+{
+    using cusp::system::detail::generic::jacobi_sweeps;
+
+    MemorySpace system;
 
-    // x <- x + omega * D^-1 * (b - y)
-    thrust::transform(thrust::make_zip_iterator(thrust::make_tuple(x.begin(), diagonal.begin(), b.begin(), temp.begin())),
-                      thrust::make_zip_iterator(thrust::make_tuple(x.end(),   diagonal.end(),   b.end(),   temp.end())),
-                      x.begin(),
-                      detail::jacobi_relax_functor<ValueType>(omega));
+    jacobi_sweeps(thrust::detail::derived_cast(system), A, diagonal, b, x, temp, barrier, omega, num_sweeps);
 }
 
 } // end namespace relaxation
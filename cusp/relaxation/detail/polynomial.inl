@@ -23,6 +23,9 @@
 #include <cusp/format_utils.h>
 #include <cusp/eigen/spectral_radius.h>
 
+#include <cusp/system/detail/generic/relaxation/polynomial.h>
+#include <cusp/system/detail/adl/relaxation/polynomial.h>
+
 #ifdef _WIN32
 	#define _USE_MATH_DEFINES
 #endif
@@ -116,29 +119,21 @@ template<typename MatrixType, typename VectorType1, typename VectorType2, typena
 void polynomial<ValueType,MemorySpace>
 ::operator()(const MatrixType& A, const VectorType1& b, VectorType2& x, const VectorType3& coefficients)
 {
-    if( cusp::blas::nrm2(x) == 0.0 )
-    {
-        residual = b;
-    }
-    else
-    {
-        // compute residual <- b - A*x
-        cusp::multiply(A, x, residual);
-        cusp::blas::axpby(b, residual, residual, ValueType(1), ValueType(-1));
-    }
-
-    ValueType scale_factor = coefficients[0];
-    cusp::blas::axpby(residual, h, h, scale_factor, ValueType(0));
-
-    for( size_t i = 1; i<coefficients.size(); i++ )
-    {
-        scale_factor = coefficients[i];
-
-        cusp::multiply(A, h, y);
-        cusp::blas::axpby(y, residual, h, ValueType(1.0), scale_factor);
-    }
-
-    cusp::blas::axpy(h, x, ValueType(1.0));
+    relax(A, b, x, coefficients, cusp::blas::nrm2(x) == 0.0);
+}
+
+template <typename ValueType, typename MemorySpace>
+template<typename MatrixType, typename VectorType1, typename VectorType2, typename VectorType3>
+void polynomial<ValueType,MemorySpace>
+::relax(const MatrixType& A, const VectorType1& b, VectorType2& x, const VectorType3& coefficients,
+        const bool zero_initial_guess)
+{
+    using cusp::system::detail::generic::polynomial_relax;
+
+    MemorySpace system;
+
+    polynomial_relax(thrust::detail::derived_cast(system), A, b, x, residual, h, y, barrier,
+                     coefficients, zero_initial_guess);
 }
 
 } // end namespace relaxation
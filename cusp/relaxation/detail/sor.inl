@@ -19,6 +19,7 @@
  */
 
 #include <cusp/blas/blas.h>
+#include <cusp/exception.h>
 
 namespace cusp
 {
@@ -40,9 +41,38 @@ template<typename MatrixType, typename VectorType1, typename VectorType2>
 void sor<ValueType,MemorySpace>
 ::operator()(const MatrixType& A, const VectorType1& b, VectorType2& x, const ValueType omega, sweep direction)
 {
-    temp = x;
-    gs(A, b, x, direction);
-    cusp::blas::axpby(temp, x, x, ValueType(1)-omega, omega);
+    if(!gs.multicolor)
+    {
+        temp = x;
+        gs(A, b, x, direction);
+        cusp::blas::axpby(temp, x, x, ValueType(1)-omega, omega);
+        return;
+    }
+
+    if(direction != FORWARD && direction != BACKWARD && direction != SYMMETRIC)
+        throw cusp::runtime_exception("Unknown SOR sweep direction specified.");
+
+    // the rows of a color are independent, so each color is one fused
+    // x <- (1 - omega) * x + omega * D^-1 * (b - (L + U) * x) update
+    MemorySpace system;
+
+    const size_t num_colors = gs.color_offsets.size() - 1;
+
+    if(direction == FORWARD || direction == SYMMETRIC)
+    {
+        for(size_t i = 0; i < num_colors; i++)
+            gauss_seidel_multicolor(thrust::detail::derived_cast(system),
+                gs.colored_A, gs.colored_diagonal, gs.ordering, x, b,
+                gs.color_offsets[i], gs.color_offsets[i+1], omega);
+    }
+
+    if(direction == BACKWARD || direction == SYMMETRIC)
+    {
+        for(size_t i = num_colors; i > 0; i--)
+            gauss_seidel_multicolor(thrust::detail::derived_cast(system),
+                gs.colored_A, gs.colored_diagonal, gs.ordering, x, b,
+                gs.color_offsets[i-1], gs.color_offsets[i], omega);
+    }
 }
 
 } // end namespace relaxation
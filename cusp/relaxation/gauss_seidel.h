@@ -21,6 +21,8 @@
 #pragma once
 
 #include <cusp/detail/config.h>
+#include <cusp/array1d.h>
+#include <cusp/csr_matrix.h>
 #include <cusp/linear_operator.h>
 
 namespace cusp
@@ -51,7 +53,18 @@ typedef enum
  * \tparam MemorySpace memory space of the array (\c cusp::host_memory or \c cusp::device_memory)
  *
  * \par Overview
- * Computes vertex coloring and performs indexed Gauss-Seidel relaxation
+ * Computes vertex coloring and performs indexed Gauss-Seidel relaxation.
+ * The rows of a color are independent of each other, the colors are
+ * relaxed in sequence.
+ *
+ * In multicolor mode the smoother additionally stores a copy of the
+ * off-diagonal entries of A with its rows permuted into color contiguous
+ * blocks, together with the diagonal in the same order. Every color is
+ * then relaxed by a single kernel reading consecutive rows, which
+ * coalesces the accesses to the matrix on the device, at the cost of
+ * storing A twice. Both modes produce the same result. Since the copy is
+ * taken at construction, a smoother in multicolor mode must be
+ * reconstructed when the values of A change.
  *
  * \par Example
  * \code
@@ -60,7 +73,9 @@ typedef enum
  * #include <cusp/monitor.h>
  *
  * #include <cusp/blas/blas.h>
- * #include <cusp/linear_operator.h>
+ * #include <cusp/array1d.h>
+#include <cusp/csr_matrix.h>
+#include <cusp/linear_operator.h>
  * #include <cusp/gallery/poisson.h>
  *
  * // include cusp gauss_seidel header file
@@ -109,12 +124,15 @@ public:
     cusp::array1d<int,MemorySpace> ordering;
     cusp::array1d<int,cusp::host_memory> color_offsets;
     cusp::array1d<ValueType,MemorySpace> diagonal;
+    cusp::csr_matrix<int,ValueType,MemorySpace> colored_A;
+    cusp::array1d<ValueType,MemorySpace> colored_diagonal;
     sweep default_direction;
+    bool multicolor;
     /* \endcond */
 
     /*! This constructor creates an empty \p gauss_seidel smoother.
      */
-    gauss_seidel(void) {}
+    gauss_seidel(void) : default_direction(SYMMETRIC), multicolor(false) {}
 
     /*! This constructor creates a \p gauss_seidel smoother using a given
      *  matrix and sweeping strategy (FORWARD, BACKWARD, SYMMETRIC).
@@ -125,9 +143,11 @@ public:
      *  \param A Input matrix used to create smoother.
      *  \param default_direction Sweep strategy used to perform Gauss-Seidel
      *  smoothing.
+     *  \param multicolor Store the rows of \p A in color contiguous order
+     *  and relax every color with one coalesced kernel.
      */
     template <typename MatrixType>
-    gauss_seidel(const MatrixType& A, sweep default_direction=SYMMETRIC,
+    gauss_seidel(const MatrixType& A, sweep default_direction=SYMMETRIC, bool multicolor=false,
                  typename thrust::detail::enable_if_convertible<typename MatrixType::format,cusp::csr_format>::type* = 0);
 
     /*! Copy constructor for \p gauss_seidel smoother.
@@ -138,7 +158,9 @@ public:
      */
     template<typename MemorySpace2>
     gauss_seidel(const gauss_seidel<ValueType,MemorySpace2>& A)
-        : ordering(A.ordering), color_offsets(A.color_offsets), default_direction(A.default_direction) {}
+        : ordering(A.ordering), color_offsets(A.color_offsets), diagonal(A.diagonal),
+          colored_A(A.colored_A), colored_diagonal(A.colored_diagonal),
+          default_direction(A.default_direction), multicolor(A.multicolor) {}
 
     /*! Perform Gauss-Seidel relaxation using default sweep specified during
      * construction of this \p gauss_seidel smoother
@@ -168,6 +190,17 @@ public:
      */
     template <typename MatrixType, typename VectorType1, typename VectorType2>
     void operator()(const MatrixType& A, const VectorType1& b, VectorType2& x, sweep direction);
+
+private:
+
+    /* \cond */
+    template <typename MatrixType>
+    void build_colored_matrix(const MatrixType& A);
+
+    template <typename MatrixType, typename VectorType1, typename VectorType2>
+    void relax_color(const MatrixType& A, const VectorType1& b, VectorType2& x,
+                     const int row_start, const int row_stop);
+    /* \endcond */
 };
 /*! \}
  */
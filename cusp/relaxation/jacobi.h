@@ -100,6 +100,7 @@ public:
     ValueType default_omega;
     cusp::array1d<ValueType,MemorySpace> diagonal;
     cusp::array1d<ValueType,MemorySpace> temp;
+    cusp::array1d<unsigned int,MemorySpace> barrier;
     /* \endcond */
 
     /*! This constructor creates an empty \p jacobi smoother.
@@ -155,6 +156,23 @@ public:
      */
     template <typename MatrixType, typename VectorType1, typename VectorType2>
     void operator()(const MatrixType& A, const VectorType1& b, VectorType2& x, const ValueType omega);
+
+    /*! Perform several Jacobi sweeps using specified omega damping factor.
+     *  On the device small CSR matrices perform all sweeps in a single
+     *  persistent kernel.
+     *
+     * \tparam MatrixType  Type of input matrix.
+     * \tparam VectorType1 Type of input right-hand side vector.
+     * \tparam VectorType2 Type of input approximate solution vector.
+     *
+     * \param A matrix of the linear system
+     * \param x approximate solution of the linear system
+     * \param b right-hand side of the linear system
+     * \param omega Damping factor used in Jacobi smoother.
+     * \param num_sweeps Number of sweeps to perform.
+     */
+    template <typename MatrixType, typename VectorType1, typename VectorType2>
+    void operator()(const MatrixType& A, const VectorType1& b, VectorType2& x, const ValueType omega, const size_t num_sweeps);
 };
 /*! \}
  */
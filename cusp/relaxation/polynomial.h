@@ -108,6 +108,7 @@ public:
     cusp::array1d<ValueType, MemorySpace> residual;
     cusp::array1d<ValueType, MemorySpace> h;
     cusp::array1d<ValueType, MemorySpace> y;
+    cusp::array1d<unsigned int, MemorySpace> barrier;
     /* \endcond */
 
     /*! This constructor creates an empty \p polynomial smoother.
@@ -176,6 +177,25 @@ public:
      */
     template <typename MatrixType, typename VectorType1, typename VectorType2, typename VectorType3>
     void operator()(const MatrixType& A, const VectorType1& b, VectorType2& x, const VectorType3& coefficients);
+
+    /*! Perform polynomial relaxation using specified coefficients without
+     *  testing whether the approximate solution is zero. On the device small
+     *  CSR matrices apply the whole polynomial in a single persistent kernel.
+     *
+     * \tparam MatrixType  Type of input matrix.
+     * \tparam VectorType1 Type of input right-hand side vector.
+     * \tparam VectorType2 Type of input approximate solution vector.
+     * \tparam VectorType3 Type of input coefficients vector.
+     *
+     * \param A matrix of the linear system
+     * \param x approximate solution of the linear system
+     * \param b right-hand side of the linear system
+     * \param coefficients Used in polynomial smoother.
+     * \param zero_initial_guess Ignore the input x and treat it as zero.
+     */
+    template <typename MatrixType, typename VectorType1, typename VectorType2, typename VectorType3>
+    void relax(const MatrixType& A, const VectorType1& b, VectorType2& x, const VectorType3& coefficients,
+               const bool zero_initial_guess);
 };
 /*! \}
  */
@@ -47,6 +47,11 @@ namespace relaxation
  * \par Overview
  * Computes vertex coloring and performs indexed Successive Over-Relaxation relaxation
  *
+ * With \p multicolor set the rows are stored in color contiguous order,
+ * shared with the multicolor \p gauss_seidel smoother, and every color is
+ * relaxed by one kernel that applies the weighting in the same pass; a
+ * SYMMETRIC sweep is then a multicolor SSOR iteration.
+ *
  * \par Example
  * \code
  * #include <cusp/array1d.h>
@@ -119,10 +124,12 @@ public:
      *  \param omega Damping factor used in SOR smoother.
      *  \param default_direction Sweep strategy used to perform Gauss-Seidel
      *  smoothing.
+     *  \param multicolor Relax every color with one fused SOR kernel on the
+     *  color contiguous rows of \p A.
      */
     template <typename MatrixType>
-    sor(const MatrixType& A, const ValueType omega, sweep default_direction=SYMMETRIC)
-      : default_omega(omega), temp(A.num_cols), gs(A, default_direction) {}
+    sor(const MatrixType& A, const ValueType omega, sweep default_direction=SYMMETRIC, bool multicolor=false)
+      : default_omega(omega), temp(A.num_cols), gs(A, default_direction, multicolor) {}
 
     /*! Copy constructor for \p sor smoother.
      *
@@ -0,0 +1,459 @@
+/*
+ *  Copyright 2008-2014 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*! \file sell_matrix.h
+ *  \brief Sliced ELLPACK (SELL-C-sigma) matrix format.
+ */
+
+#pragma once
+
+#include <cusp/detail/config.h>
+
+#include <cusp/array1d.h>
+#include <cusp/memory.h>
+
+#include <cusp/detail/format.h>
+#include <cusp/detail/matrix_base.h>
+#include <cusp/detail/type_traits.h>
+
+namespace cusp
+{
+
+// forward definition
+template <typename ArrayType1, typename ArrayType2, typename ArrayType3, typename ArrayType4,
+          typename IndexType, typename ValueType, typename MemorySpace> class sell_matrix_view;
+
+/*! \addtogroup sparse_matrices Sparse Matrices
+ */
+
+/*! \addtogroup sparse_matrix_containers Sparse Matrix Containers
+ *  \ingroup sparse_matrices
+ *  \{
+ */
+
+/**
+ * \brief Sliced ELLPACK (SELL-C-sigma) representation of a sparse matrix
+ *
+ * \tparam IndexType Type used for matrix indices (e.g. \c int).
+ * \tparam ValueType Type used for matrix values (e.g. \c float).
+ * \tparam MemorySpace A memory space (e.g. \c cusp::host_memory or \c cusp::device_memory)
+ *
+ * \par Overview
+ *  A \p sell_matrix partitions the rows of a matrix into slices of
+ *  \c slice_size (C) consecutive rows and stores every slice in a small
+ *  column-major ELL block that is padded only to the length of the longest
+ *  row in that slice. Before slicing, the rows inside every window of sigma
+ *  rows are sorted by decreasing length so that rows of similar length share
+ *  a slice. The original index of the i-th stored row is held in
+ *  \c row_permutation. Entry \c k of the stored row \c i = s * C + lane
+ *  resides at position <tt>slice_offsets[s] + k * C + lane</tt>.
+ *
+ * \note The slice size and sigma of the destination are honored by \p convert,
+ *       sigma = 1 disables sorting and sigma >= num_rows sorts globally.
+ * \note Padded entries are marked with \c invalid_index in \c column_indices.
+ * \note The matrix should not contain duplicate entries.
+ *
+ * \par Example
+ *  The following code snippet demonstrates how to create a \p sell_matrix
+ *  from a \p csr_matrix using slices of 2 rows sorted within windows of
+ *  4 rows and copies the matrix to the device.
+ *
+ *  \code
+ *  // include the sell_matrix header file
+ *  #include <cusp/csr_matrix.h>
+ *  #include <cusp/sell_matrix.h>
+ *  #include <cusp/gallery/poisson.h>
+ *  #include <cusp/print.h>
+ *
+ *  int main()
+ *  {
+ *    cusp::csr_matrix<int,float,cusp::host_memory> A;
+ *    cusp::gallery::poisson5pt(A, 4, 4);
+ *
+ *    // convert using C = 2 and sigma = 4
+ *    cusp::sell_matrix<int,float,cusp::host_memory> B;
+ *    B.slice_size = 2;
+ *    B.sigma      = 4;
+ *    cusp::convert(A, B);
+ *
+ *    // copy to the device
+ *    cusp::sell_matrix<int,float,cusp::device_memory> C(B);
+ *
+ *    cusp::print(C);
+ *  }
+ *  \endcode
+ */
+template <typename IndexType, typename ValueType, class MemorySpace>
+class sell_matrix : public cusp::detail::matrix_base<IndexType,ValueType,MemorySpace,cusp::sell_format>
+{
+private:
+
+    typedef cusp::detail::matrix_base<IndexType,ValueType,MemorySpace,cusp::sell_format> Parent;
+
+public:
+
+    /*! Value used to pad the slices of the column_indices array.
+     */
+    const static IndexType invalid_index = static_cast<IndexType>(-1);
+
+    /*! \cond */
+    typedef typename cusp::array1d<IndexType, MemorySpace> slice_offsets_array_type;
+    typedef typename cusp::array1d<IndexType, MemorySpace> column_indices_array_type;
+    typedef typename cusp::array1d<ValueType, MemorySpace> values_array_type;
+    typedef typename cusp::array1d<IndexType, MemorySpace> row_permutation_array_type;
+
+    typedef typename cusp::sell_matrix<IndexType, ValueType, MemorySpace> container;
+
+    typedef typename cusp::sell_matrix_view<typename slice_offsets_array_type::view,
+            typename column_indices_array_type::view,
+            typename values_array_type::view,
+            typename row_permutation_array_type::view,
+            IndexType, ValueType, MemorySpace> view;
+
+    typedef typename cusp::sell_matrix_view<typename slice_offsets_array_type::const_view,
+            typename column_indices_array_type::const_view,
+            typename values_array_type::const_view,
+            typename row_permutation_array_type::const_view,
+            IndexType, ValueType, MemorySpace> const_view;
+
+    template<typename MemorySpace2>
+    struct rebind
+    {
+        typedef cusp::sell_matrix<IndexType, ValueType, MemorySpace2> type;
+    };
+    /*! \endcond */
+
+    /*! Number of rows per slice (C).
+     */
+    size_t slice_size;
+
+    /*! Number of consecutive rows sorted by length before slicing (sigma).
+     */
+    size_t sigma;
+
+    /*! Storage for the offset of the first entry of each slice.
+     */
+    slice_offsets_array_type slice_offsets;
+
+    /*! Storage for the column indices of the padded slices.
+     */
+    column_indices_array_type column_indices;
+
+    /*! Storage for the values of the padded slices.
+     */
+    values_array_type values;
+
+    /*! Original row index of every stored row.
+     */
+    row_permutation_array_type row_permutation;
+
+    /*! Construct an empty \p sell_matrix.
+     */
+    sell_matrix(void) : slice_size(32), sigma(1024) {}
+
+    /*! Construct a \p sell_matrix with a specific shape, number of nonzero
+     *  entries, number of stored (padded) entries and slice size.
+     *
+     *  \param num_rows Number of rows.
+     *  \param num_cols Number of columns.
+     *  \param num_entries Number of nonzero matrix entries.
+     *  \param num_stored_entries Number of entries including padding.
+     *  \param slice_size Number of rows per slice (default 32).
+     */
+    sell_matrix(const size_t num_rows, const size_t num_cols, const size_t num_entries,
+                const size_t num_stored_entries, const size_t slice_size = 32);
+
+    /*! Construct a \p sell_matrix from another matrix.
+     *
+     *  \param matrix Another sparse or dense matrix.
+     */
+    template <typename MatrixType>
+    sell_matrix(const MatrixType& matrix);
+
+    /*! Number of slices in the matrix.
+     */
+    size_t num_slices(void) const
+    {
+        return slice_offsets.size() == 0 ? 0 : slice_offsets.size() - 1;
+    }
+
+    /*! Resize matrix dimensions and underlying storage
+     *
+     *  \param num_rows Number of rows.
+     *  \param num_cols Number of columns.
+     *  \param num_entries Number of nonzero matrix entries.
+     *  \param num_stored_entries Number of entries including padding.
+     */
+    void resize(const size_t num_rows, const size_t num_cols, const size_t num_entries,
+                const size_t num_stored_entries);
+
+    /*! Resize matrix dimensions and underlying storage
+     *
+     *  \param num_rows Number of rows.
+     *  \param num_cols Number of columns.
+     *  \param num_entries Number of nonzero matrix entries.
+     *  \param num_stored_entries Number of entries including padding.
+     *  \param slice_size Number of rows per slice.
+     */
+    void resize(const size_t num_rows, const size_t num_cols, const size_t num_entries,
+                const size_t num_stored_entries, const size_t slice_size);
+
+    /*! Swap the contents of two \p sell_matrix objects.
+     *
+     *  \param matrix Another \p sell_matrix with the same IndexType and ValueType.
+     */
+    void swap(sell_matrix& matrix);
+
+    /*! Assignment from another matrix.
+     *
+     *  \tparam MatrixType Format type of input matrix.
+     *
+     *  \param matrix Another sparse or dense matrix.
+     */
+    template <typename MatrixType>
+    sell_matrix& operator=(const MatrixType& matrix);
+}; // class sell_matrix
+/*! \}
+ */
+
+/*! \addtogroup sparse_matrix_views Sparse Matrix Views
+ *  \ingroup sparse_matrices
+ *  \{
+ */
+
+/**
+ * \brief View of a \p sell_matrix
+ *
+ * \tparam ArrayType1 Type of \c slice_offsets array view
+ * \tparam ArrayType2 Type of \c column_indices array view
+ * \tparam ArrayType3 Type of \c values array view
+ * \tparam ArrayType4 Type of \c row_permutation array view
+ * \tparam IndexType Type used for matrix indices (e.g. \c int).
+ * \tparam ValueType Type used for matrix values (e.g. \c float).
+ * \tparam MemorySpace A memory space (e.g. \c cusp::host_memory or \c cusp::device_memory)
+ */
+template <typename ArrayType1,
+          typename ArrayType2,
+          typename ArrayType3,
+          typename ArrayType4,
+          typename IndexType   = typename ArrayType1::value_type,
+          typename ValueType   = typename ArrayType3::value_type,
+          typename MemorySpace = typename cusp::minimum_space<
+                                    typename ArrayType1::memory_space,
+                                    typename ArrayType2::memory_space,
+                                    typename ArrayType3::memory_space>::type >
+class sell_matrix_view : public cusp::detail::matrix_base<IndexType,ValueType,MemorySpace,cusp::sell_format>
+{
+private:
+
+    typedef cusp::detail::matrix_base<IndexType,ValueType,MemorySpace,cusp::sell_format> Parent;
+
+public:
+
+    /*! \cond */
+    typedef ArrayType1 slice_offsets_array_type;
+    typedef ArrayType2 column_indices_array_type;
+    typedef ArrayType3 values_array_type;
+    typedef ArrayType4 row_permutation_array_type;
+
+    typedef typename cusp::sell_matrix<IndexType, ValueType, MemorySpace> container;
+    typedef typename cusp::sell_matrix_view<ArrayType1, ArrayType2, ArrayType3, ArrayType4, IndexType, ValueType, MemorySpace> view;
+    typedef typename cusp::sell_matrix_view<ArrayType1, ArrayType2, ArrayType3, ArrayType4, IndexType, ValueType, MemorySpace> const_view;
+    /*! \endcond */
+
+    /**
+     * Value used to pad the slices of the column_indices array.
+     */
+    const static IndexType invalid_index = container::invalid_index;
+
+    /**
+     * Number of rows per slice (C).
+     */
+    size_t slice_size;
+
+    /**
+     * Number of consecutive rows sorted by length before slicing (sigma).
+     */
+    size_t sigma;
+
+    /**
+     * View of the slice offsets of the SELL data structure.
+     */
+    slice_offsets_array_type slice_offsets;
+
+    /**
+     * View of the column indices of the SELL data structure.
+     */
+    column_indices_array_type column_indices;
+
+    /**
+     * View for the nonzero entries of the SELL data structure.
+     */
+    values_array_type values;
+
+    /**
+     * View of the original row index of every stored row.
+     */
+    row_permutation_array_type row_permutation;
+
+    /**
+     * Construct an empty \p sell_matrix_view.
+     */
+    sell_matrix_view(void)
+        : Parent(), slice_size(32), sigma(1024) {}
+
+    /*! Construct a \p sell_matrix_view with a specific shape and number of nonzero entries
+     *  from existing arrays denoting the slice offsets, column indices, values and
+     *  row permutation.
+     *
+     *  \param num_rows Number of rows.
+     *  \param num_cols Number of columns.
+     *  \param num_entries Number of nonzero matrix entries.
+     *  \param slice_size Number of rows per slice.
+     *  \param slice_offsets Array containing the slice offsets.
+     *  \param column_indices Array containing the column indices.
+     *  \param values Array containing the values.
+     *  \param row_permutation Array containing the original row indices.
+     */
+    sell_matrix_view(const size_t num_rows,
+                     const size_t num_cols,
+                     const size_t num_entries,
+                     const size_t slice_size,
+                     ArrayType1 slice_offsets,
+                     ArrayType2 column_indices,
+                     ArrayType3 values,
+                     ArrayType4 row_permutation)
+        : Parent(num_rows, num_cols, num_entries),
+          slice_size(slice_size),
+          sigma(slice_size),
+          slice_offsets(slice_offsets),
+          column_indices(column_indices),
+          values(values),
+          row_permutation(row_permutation) {}
+
+    /*! Construct a \p sell_matrix_view from a existing \p sell_matrix.
+     *
+     *  \param matrix \p sell_matrix used to create view.
+     */
+    sell_matrix_view(sell_matrix<IndexType,ValueType,MemorySpace>& matrix)
+        : Parent(matrix),
+          slice_size(matrix.slice_size),
+          sigma(matrix.sigma),
+          slice_offsets(matrix.slice_offsets),
+          column_indices(matrix.column_indices),
+          values(matrix.values),
+          row_permutation(matrix.row_permutation) {}
+
+    /*! Construct a \p sell_matrix_view from a existing const \p sell_matrix.
+     *
+     *  \param matrix \p sell_matrix used to create view.
+     */
+    sell_matrix_view(const sell_matrix<IndexType,ValueType,MemorySpace>& matrix)
+        : Parent(matrix),
+          slice_size(matrix.slice_size),
+          sigma(matrix.sigma),
+          slice_offsets(matrix.slice_offsets),
+          column_indices(matrix.column_indices),
+          values(matrix.values),
+          row_permutation(matrix.row_permutation) {}
+
+    /*! Construct a \p sell_matrix_view from a existing \p sell_matrix_view.
+     *
+     *  \param matrix \p sell_matrix_view used to create view.
+     */
+    sell_matrix_view(sell_matrix_view& matrix)
+        : Parent(matrix),
+          slice_size(matrix.slice_size),
+          sigma(matrix.sigma),
+          slice_offsets(matrix.slice_offsets),
+          column_indices(matrix.column_indices),
+          values(matrix.values),
+          row_permutation(matrix.row_permutation) {}
+
+    /*! Construct a \p sell_matrix_view from a existing const \p sell_matrix_view.
+     *
+     *  \param matrix \p sell_matrix_view used to create view.
+     */
+    sell_matrix_view(const sell_matrix_view& matrix)
+        : Parent(matrix),
+          slice_size(matrix.slice_size),
+          sigma(matrix.sigma),
+          slice_offsets(matrix.slice_offsets),
+          column_indices(matrix.column_indices),
+          values(matrix.values),
+          row_permutation(matrix.row_permutation) {}
+
+    /*! Number of slices in the matrix.
+     */
+    size_t num_slices(void) const
+    {
+        return slice_offsets.size() == 0 ? 0 : slice_offsets.size() - 1;
+    }
+
+    /*! Resize matrix dimensions and underlying storage
+     *
+     *  \param num_rows Number of rows.
+     *  \param num_cols Number of columns.
+     *  \param num_entries Number of nonzero matrix entries.
+     *  \param num_stored_entries Number of entries including padding.
+     */
+    void resize(const size_t num_rows, const size_t num_cols, const size_t num_entries,
+                const size_t num_stored_entries);
+};
+
+/**
+ *  This is a convenience function for generating an \p sell_matrix_view
+ *  using an existing \p sell_matrix.
+ *
+ *  \tparam IndexType  indices type
+ *  \tparam ValueType  values type
+ *  \tparam MemorySpace memory space of the arrays
+ *
+ *  \param m Exemplar \p sell_matrix matrix to copy.
+ *
+ *  \return \p sell_matrix_view constructed using input arrays.
+ */
+template <typename IndexType, typename ValueType, class MemorySpace>
+typename sell_matrix<IndexType,ValueType,MemorySpace>::view
+make_sell_matrix_view(sell_matrix<IndexType,ValueType,MemorySpace>& m)
+{
+    return typename sell_matrix<IndexType,ValueType,MemorySpace>::view(m);
+}
+
+/**
+ *  This is a convenience function for generating an \p sell_matrix_view
+ *  using an existing const \p sell_matrix.
+ *
+ *  \tparam IndexType  indices type
+ *  \tparam ValueType  values type
+ *  \tparam MemorySpace memory space of the arrays
+ *
+ *  \param m Exemplar \p sell_matrix matrix to copy.
+ *
+ *  \return constant \p sell_matrix_view constructed using input arrays.
+ */
+template <typename IndexType, typename ValueType, class MemorySpace>
+typename sell_matrix<IndexType,ValueType,MemorySpace>::const_view
+make_sell_matrix_view(const sell_matrix<IndexType,ValueType,MemorySpace>& m)
+{
+    return typename sell_matrix<IndexType,ValueType,MemorySpace>::const_view(m);
+}
+/*! \}
+ */
+
+} // end namespace cusp
+
+#include <cusp/detail/sell_matrix.inl>
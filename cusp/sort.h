@@ -264,6 +264,11 @@ void sort_by_row_and_column(const thrust::detail::execution_policy_base<DerivedP
  * \param min_col minimum column index
  * \param max_col maximum column index
  *
+ * \par Overview
+ *  Input that is already sorted is detected in a single pass and left
+ *  untouched. When the entries are grouped by row but some rows have their
+ *  columns out of order, only the entries of those rows are sorted.
+ *
  * \par Example
  *  The following code snippet demonstrates how to use \p
  *  sort_by_row_and_column.
@@ -306,6 +311,109 @@ void sort_by_row_and_column(ArrayType1& row_indices,
                             typename ArrayType1::value_type max_row = 0,
                             typename ArrayType2::value_type min_col = 0,
                             typename ArrayType2::value_type max_col = 0);
+
+/* \cond */
+template <typename DerivedPolicy,
+          typename ArrayType>
+bool is_sorted_by_row(const thrust::detail::execution_policy_base<DerivedPolicy> &exec,
+                      const ArrayType& row_indices);
+/* \endcond */
+
+/**
+ * \brief Determine whether matrix indices are sorted by row
+ *
+ * \tparam ArrayType Type of input matrix row indices
+ *
+ * \param row_indices input matrix row indices
+ *
+ * \return \c true if the row indices are in nondecreasing order; \c false, otherwise.
+ *
+ * \par Overview
+ *  The check is a single parallel pass over the row indices and is much
+ *  cheaper than a sort, \p sort_by_row and \p sort_by_row_and_column use it to
+ *  return early on input that is already ordered.
+ *
+ * \par Example
+ *  The following code snippet demonstrates how to use \p is_sorted_by_row.
+ *
+ *  \code
+ *  #include <cusp/coo_matrix.h>
+ *  #include <cusp/sort.h>
+ *
+ *  #include <iostream>
+ *
+ *  int main(void)
+ *  {
+ *      // allocate storage for (4,3) matrix with 3 nonzeros
+ *      cusp::coo_matrix<int,float,cusp::host_memory> A(4,3,3);
+ *
+ *      // initialize matrix entries on host
+ *      A.row_indices[0] = 0; A.column_indices[0] = 2; A.values[0] = 10;
+ *      A.row_indices[1] = 0; A.column_indices[1] = 0; A.values[1] = 20;
+ *      A.row_indices[2] = 3; A.column_indices[2] = 1; A.values[2] = 30;
+ *
+ *      // print 1, the entries are grouped by row
+ *      std::cout << cusp::is_sorted_by_row(A.row_indices) << std::endl;
+ *
+ *      return 0;
+ *  }
+ *  \endcode
+ */
+template <typename ArrayType>
+bool is_sorted_by_row(const ArrayType& row_indices);
+
+/* \cond */
+template <typename DerivedPolicy,
+          typename ArrayType1,
+          typename ArrayType2>
+bool is_sorted_by_row_and_column(const thrust::detail::execution_policy_base<DerivedPolicy> &exec,
+                                 const ArrayType1& row_indices,
+                                 const ArrayType2& column_indices);
+/* \endcond */
+
+/**
+ * \brief Determine whether matrix indices are sorted by row and column
+ *
+ * \tparam ArrayType1 Type of input matrix row indices
+ * \tparam ArrayType2 Type of input matrix column indices
+ *
+ * \param row_indices input matrix row indices
+ * \param column_indices input matrix column indices
+ *
+ * \return \c true if the (row,column) pairs are in lexicographically
+ * nondecreasing order; \c false, otherwise.
+ *
+ * \par Example
+ *  The following code snippet demonstrates how to use \p
+ *  is_sorted_by_row_and_column.
+ *
+ *  \code
+ *  #include <cusp/coo_matrix.h>
+ *  #include <cusp/sort.h>
+ *
+ *  #include <iostream>
+ *
+ *  int main(void)
+ *  {
+ *      // allocate storage for (4,3) matrix with 3 nonzeros
+ *      cusp::coo_matrix<int,float,cusp::host_memory> A(4,3,3);
+ *
+ *      // initialize matrix entries on host
+ *      A.row_indices[0] = 0; A.column_indices[0] = 2; A.values[0] = 10;
+ *      A.row_indices[1] = 0; A.column_indices[1] = 0; A.values[1] = 20;
+ *      A.row_indices[2] = 3; A.column_indices[2] = 1; A.values[2] = 30;
+ *
+ *      // print 0, the columns of row 0 are out of order
+ *      std::cout << cusp::is_sorted_by_row_and_column(A.row_indices, A.column_indices) << std::endl;
+ *
+ *      return 0;
+ *  }
+ *  \endcode
+ */
+template <typename ArrayType1,
+          typename ArrayType2>
+bool is_sorted_by_row_and_column(const ArrayType1& row_indices,
+                                 const ArrayType2& column_indices);
 /*! \}
  */
 
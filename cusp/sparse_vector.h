@@ -0,0 +1,164 @@
+/*
+ *  Copyright 2008-2014 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*! \file sparse_vector.h
+ *  \brief Vector storing only its nonzero entries.
+ */
+
+#pragma once
+
+#include <cusp/detail/config.h>
+
+#include <cusp/array1d.h>
+#include <cusp/memory.h>
+
+namespace cusp
+{
+
+/*! \addtogroup arrays Arrays
+ */
+
+/*! \addtogroup array_containers Array Containers
+ *  \ingroup arrays
+ *  \{
+ */
+
+/**
+ * \brief Sparse vector of sorted indices and their values
+ *
+ * \tparam IndexType Type used for the indices (e.g. \c int).
+ * \tparam ValueType Type used for the values (e.g. \c float).
+ * \tparam MemorySpace A memory space (e.g. \c cusp::host_memory or \c cusp::device_memory)
+ *
+ * \par Overview
+ *  A \p sparse_vector represents a vector of \c length entries by the
+ *  \c num_entries of them that are stored, e.g. the frontier of a graph
+ *  traversal. Entry \c k has the position <tt>indices[k]</tt> and the value
+ *  <tt>values[k]</tt>, all other entries are implicit. It is the input and
+ *  output of the sparse matrix sparse vector product \p generalized_spmspv.
+ *
+ * \note The indices must be sorted and must not contain duplicates.
+ *
+ * \par Example
+ *  \code
+ *  #include <cusp/array1d.h>
+ *  #include <cusp/sparse_vector.h>
+ *
+ *  int main()
+ *  {
+ *    // the vector [0 5 0 0 7]
+ *    cusp::sparse_vector<int,float,cusp::host_memory> x(5, 2);
+ *    x.indices[0] = 1; x.values[0] = 5;
+ *    x.indices[1] = 4; x.values[1] = 7;
+ *
+ *    // copy to the device
+ *    cusp::sparse_vector<int,float,cusp::device_memory> y(x);
+ *
+ *    // the nonzero entries of a dense vector
+ *    cusp::array1d<float,cusp::host_memory> z(5, 0);
+ *    z[3] = 2;
+ *    cusp::sparse_vector<int,float,cusp::host_memory> w(z);
+ *  }
+ *  \endcode
+ */
+template <typename IndexType, typename ValueType, class MemorySpace>
+class sparse_vector
+{
+public:
+
+    /*! \cond */
+    typedef IndexType   index_type;
+    typedef ValueType   value_type;
+    typedef MemorySpace memory_space;
+
+    typedef typename cusp::array1d<IndexType, MemorySpace> indices_array_type;
+    typedef typename cusp::array1d<ValueType, MemorySpace> values_array_type;
+
+    typedef typename cusp::sparse_vector<IndexType, ValueType, MemorySpace> container;
+
+    template<typename MemorySpace2>
+    struct rebind
+    {
+        typedef cusp::sparse_vector<IndexType, ValueType, MemorySpace2> type;
+    };
+    /*! \endcond */
+
+    /*! Number of entries of the vector, stored or implicit.
+     */
+    size_t length;
+
+    /*! Number of stored entries.
+     */
+    size_t num_entries;
+
+    /*! Storage for the sorted positions of the stored entries.
+     */
+    indices_array_type indices;
+
+    /*! Storage for the values of the stored entries.
+     */
+    values_array_type values;
+
+    /*! Construct an empty \p sparse_vector.
+     */
+    sparse_vector(void)
+        : length(0), num_entries(0) {}
+
+    /*! Construct a \p sparse_vector with a specific length and number of
+     *  stored entries.
+     *
+     *  \param length Number of entries of the vector.
+     *  \param num_entries Number of stored entries.
+     */
+    sparse_vector(const size_t length, const size_t num_entries)
+        : length(length), num_entries(num_entries),
+          indices(num_entries), values(num_entries) {}
+
+    /*! Construct a \p sparse_vector from another \p sparse_vector.
+     *
+     *  \param v Another \p sparse_vector, possibly in another memory space.
+     */
+    template <typename IndexType2, typename ValueType2, typename MemorySpace2>
+    sparse_vector(const sparse_vector<IndexType2,ValueType2,MemorySpace2>& v)
+        : length(v.length), num_entries(v.num_entries),
+          indices(v.indices), values(v.values) {}
+
+    /*! Construct a \p sparse_vector from the nonzero entries of a dense array.
+     *
+     *  \param x A dense \p array1d or \p array1d_view.
+     */
+    template <typename ArrayType>
+    explicit sparse_vector(const ArrayType& x);
+
+    /*! Resize the vector and the storage of its entries.
+     *
+     *  \param length Number of entries of the vector.
+     *  \param num_entries Number of stored entries.
+     */
+    void resize(const size_t length, const size_t num_entries);
+
+    /*! Swap the contents of two \p sparse_vector objects.
+     *
+     *  \param v Another \p sparse_vector with the same IndexType and ValueType.
+     */
+    void swap(sparse_vector& v);
+}; // class sparse_vector
+/*! \}
+ */
+
+} // end namespace cusp
+
+#include <cusp/detail/sparse_vector.inl>
@@ -0,0 +1,256 @@
+/*
+ *  Copyright 2008-2014 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+
+/*! \file stencil_operator.h
+ *  \brief Matrix-free operator applying a stencil on a structured grid
+ */
+
+#pragma once
+
+#include <cusp/detail/config.h>
+
+#include <cusp/array1d.h>
+#include <cusp/array2d.h>
+#include <cusp/linear_operator.h>
+
+namespace cusp
+{
+/* \cond */
+namespace detail
+{
+
+// plain description of a stencil passed by value to the kernels, offsets
+// are the distances between a grid point and its neighbors in the
+// linearized grid whose first dimension varies fastest
+template <int Dims, int Points, typename IndexType, typename ValueType>
+struct stencil_descriptor
+{
+    static const int dimensions = Dims;
+    static const int points     = Points;
+
+    IndexType grid[Dims];
+    IndexType displacements[Points][Dims];
+    IndexType offsets[Points];
+    ValueType coefficients[Points];
+
+    // variable coefficients laid out like the values of a dia_matrix,
+    // NULL for constant coefficients
+    const ValueType * values;
+    IndexType pitch;
+
+    __host__ __device__
+    void coordinates(IndexType row, IndexType * coords) const
+    {
+        for(int d = 0; d < Dims; d++)
+        {
+            coords[d] = row % grid[d];
+            row /= grid[d];
+        }
+    }
+
+    // moves coords to the next grid point
+    __host__ __device__
+    void advance(IndexType * coords) const
+    {
+        for(int d = 0; d < Dims; d++)
+        {
+            if(++coords[d] < grid[d])
+                return;
+
+            coords[d] = 0;
+        }
+    }
+
+    __host__ __device__
+    bool inside(const IndexType * coords, const int point) const
+    {
+        for(int d = 0; d < Dims; d++)
+        {
+            const IndexType c = coords[d] + displacements[point][d];
+
+            if(c < 0 || c >= grid[d])
+                return false;
+        }
+
+        return true;
+    }
+
+    __host__ __device__
+    ValueType coefficient(const IndexType row, const int point) const
+    {
+        return values == NULL ? coefficients[point] : values[row + pitch * point];
+    }
+
+    template <typename XType>
+    __host__ __device__
+    ValueType apply(const IndexType row, const IndexType * coords, const XType * x) const
+    {
+        ValueType sum(0);
+
+        for(int p = 0; p < Points; p++)
+            if(inside(coords, p))
+                sum += coefficient(row, p) * x[row + offsets[p]];
+
+        return sum;
+    }
+};
+
+} // end namespace detail
+/* \endcond */
+
+/*! \addtogroup sparse_matrices Sparse Matrices
+ *  \addtogroup sparse_matrix_containers Sparse Matrix Containers
+ *  \ingroup sparse_matrices
+ *  \{
+ */
+
+/**
+ * \brief Matrix-free operator applying a stencil on a structured grid
+ *
+ * \tparam Dims Number of grid dimensions.
+ * \tparam Points Number of stencil points.
+ * \tparam ValueType Type used for coefficients (e.g. \c float).
+ * \tparam MemorySpace A memory space (e.g. \c cusp::host_memory or \c cusp::device_memory)
+ * \tparam IndexType Type used for grid indices (e.g. \c int).
+ *
+ * \par Overview
+ *  A \p stencil_operator is the \p linear_operator of the matrix that
+ *  \p cusp::gallery::generate_matrix_from_stencil produces from the same
+ *  stencil and grid, without storing the matrix. The grid is linearized
+ *  with the first dimension varying fastest and neighbors outside the grid
+ *  are dropped.
+ *
+ *  The coefficients are constant by default. Resizing \p values to
+ *  <tt>num_rows</tt> by \p Points makes them vary per grid point, the
+ *  coefficient of stencil point \c p at grid point \c i is then
+ *  <tt>values(i,p)</tt>.
+ *
+ *  The CUDA system stages the window of \c x read by nearby stencil
+ *  points in shared memory, the OpenMP system processes contiguous blocks
+ *  of grid points per thread.
+ *
+ * \par Example
+ *  \code
+ *  #include <cusp/stencil_operator.h>
+ *  #include <cusp/array1d.h>
+ *  #include <cusp/monitor.h>
+ *  #include <cusp/krylov/cg.h>
+ *
+ *  int main(void)
+ *  {
+ *      typedef thrust::tuple<int,int>             StencilIndex;
+ *      typedef thrust::tuple<StencilIndex,float>  StencilPoint;
+ *
+ *      // 5-point Laplacian
+ *      cusp::array1d<StencilPoint, cusp::host_memory> stencil;
+ *      stencil.push_back(StencilPoint(StencilIndex( 0,-1), -1));
+ *      stencil.push_back(StencilPoint(StencilIndex(-1, 0), -1));
+ *      stencil.push_back(StencilPoint(StencilIndex( 0, 0),  4));
+ *      stencil.push_back(StencilPoint(StencilIndex( 1, 0), -1));
+ *      stencil.push_back(StencilPoint(StencilIndex( 0, 1), -1));
+ *
+ *      // operator on a 256x256 grid
+ *      cusp::stencil_operator<2, 5, float, cusp::device_memory> A(stencil, StencilIndex(256, 256));
+ *
+ *      cusp::array1d<float, cusp::device_memory> x(A.num_rows, 0);
+ *      cusp::array1d<float, cusp::device_memory> b(A.num_rows, 1);
+ *
+ *      cusp::monitor<float> monitor(b, 1000, 1e-6);
+ *
+ *      // solve A * x = b
+ *      cusp::krylov::cg(A, x, b, monitor);
+ *
+ *      return 0;
+ *  }
+ *  \endcode
+ */
+template <int Dims, int Points, typename ValueType, typename MemorySpace, typename IndexType = int>
+class stencil_operator : public cusp::linear_operator<ValueType,MemorySpace,IndexType>
+{
+private:
+
+    typedef cusp::linear_operator<ValueType,MemorySpace,IndexType> Parent;
+
+public:
+
+    /*! \cond */
+    typedef cusp::detail::stencil_descriptor<Dims,Points,IndexType,ValueType> descriptor_type;
+    typedef cusp::array2d<ValueType,MemorySpace,cusp::column_major>           values_array_type;
+    /*! \endcond */
+
+    /*! Number of grid points in every dimension.
+     */
+    IndexType grid[Dims];
+
+    /*! Displacement of every stencil point in every dimension.
+     */
+    IndexType displacements[Points][Dims];
+
+    /*! Constant coefficient of every stencil point.
+     */
+    ValueType coefficients[Points];
+
+    /*! Variable coefficients, empty for constant coefficients.
+     */
+    values_array_type values;
+
+    /*! Construct an empty \p stencil_operator.
+     */
+    stencil_operator(void);
+
+    /*! Construct a \p stencil_operator from a stencil and a grid.
+     *
+     *  \tparam StencilPoint tuple of a tuple of \p Dims displacements and a
+     *  coefficient, as accepted by \p generate_matrix_from_stencil.
+     *  \tparam GridDimension tuple of \p Dims grid sizes.
+     *
+     *  \param stencil \p Points stencil points.
+     *  \param grid grid dimensions.
+     *
+     *  \throws cusp::invalid_input_exception if the stencil does not have
+     *  \p Points points or the grid does not have \p Dims dimensions.
+     */
+    template <typename StencilPoint, typename MemorySpace2, typename GridDimension>
+    stencil_operator(const cusp::array1d<StencilPoint,MemorySpace2>& stencil,
+                     const GridDimension& grid);
+
+    /*! Description of the stencil passed to the kernels.
+     */
+    descriptor_type descriptor(void) const;
+
+    /*! Apply the \p stencil_operator to vector x and produce vector y.
+     *
+     *  \param x Input vector.
+     *  \param y Output vector.
+     */
+    template <typename DerivedPolicy, typename VectorType1, typename VectorType2>
+    void operator()(thrust::execution_policy<DerivedPolicy>& exec, const VectorType1& x, VectorType2& y) const;
+
+    /*! Apply the \p stencil_operator to vector x and produce vector y.
+     *
+     *  \param x Input vector.
+     *  \param y Output vector.
+     */
+    template <typename VectorType1, typename VectorType2>
+    void operator()(const VectorType1& x, VectorType2& y) const;
+}; // class stencil_operator
+/*! \}
+ */
+
+} // end namespace cusp
+
+#include <cusp/detail/stencil_operator.inl>
@@ -0,0 +1,178 @@
+/*
+ *  Copyright 2008-2014 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*! \file symmetric_matrix.h
+ *  \brief Symmetric matrix format storing only the upper triangle.
+ */
+
+#pragma once
+
+#include <cusp/detail/config.h>
+
+#include <cusp/csr_matrix.h>
+#include <cusp/memory.h>
+
+#include <cusp/detail/format.h>
+#include <cusp/detail/matrix_base.h>
+#include <cusp/detail/type_traits.h>
+
+namespace cusp
+{
+
+/*! \addtogroup sparse_matrices Sparse Matrices
+ */
+
+/*! \addtogroup sparse_matrix_containers Sparse Matrix Containers
+ *  \ingroup sparse_matrices
+ *  \{
+ */
+
+/**
+ * \brief Symmetric representation of a sparse matrix storing the upper triangle
+ *
+ * \tparam IndexType Type used for matrix indices (e.g. \c int).
+ * \tparam ValueType Type used for matrix values (e.g. \c float).
+ * \tparam MemorySpace A memory space (e.g. \c cusp::host_memory or \c cusp::device_memory)
+ *
+ * \par Overview
+ *  A \p symmetric_matrix represents a square matrix A = A^T by the entries
+ *  on and above the diagonal, which are held in the \p csr_matrix \c upper.
+ *  Converting any other matrix to a \p symmetric_matrix discards its strictly
+ *  lower triangle, converting a \p symmetric_matrix to another format
+ *  restores both triangles. \c num_entries counts the entries of both
+ *  triangles.
+ *
+ *  \p multiply computes <tt>y = A x</tt> by applying every stored entry
+ *  \c A(i,j) once to row \c i and, if <tt>i != j</tt>, once more transposed
+ *  to row \c j, which roughly halves the memory traffic of a full matrix.
+ *
+ * \note Since the transposed contributions of different rows are combined in
+ *       arbitrary order, \c reduce must be associative and commutative. On
+ *       the device the transposed contributions are accumulated with atomic
+ *       addition, hence only the default \c reduce (addition) is supported
+ *       for \c float and \c double values.
+ *
+ * \par Example
+ *  The following code snippet demonstrates how to create a \p symmetric_matrix
+ *  from a \p csr_matrix and use it within conjugate gradient.
+ *
+ *  \code
+ *  #include <cusp/csr_matrix.h>
+ *  #include <cusp/symmetric_matrix.h>
+ *  #include <cusp/gallery/poisson.h>
+ *  #include <cusp/krylov/cg.h>
+ *
+ *  int main()
+ *  {
+ *    cusp::csr_matrix<int,float,cusp::device_memory> A;
+ *    cusp::gallery::poisson5pt(A, 100, 100);
+ *
+ *    // store only the upper triangle
+ *    cusp::symmetric_matrix<int,float,cusp::device_memory> S(A);
+ *
+ *    cusp::array1d<float,cusp::device_memory> x(S.num_rows, 0);
+ *    cusp::array1d<float,cusp::device_memory> b(S.num_rows, 1);
+ *
+ *    cusp::krylov::cg(S, x, b);
+ *  }
+ *  \endcode
+ *
+ *  \see \p csr_matrix
+ */
+template <typename IndexType, typename ValueType, class MemorySpace>
+class symmetric_matrix : public cusp::detail::matrix_base<IndexType,ValueType,MemorySpace,cusp::symmetric_format>
+{
+private:
+
+    typedef cusp::detail::matrix_base<IndexType,ValueType,MemorySpace,cusp::symmetric_format> Parent;
+
+public:
+
+    /*! \cond */
+    typedef cusp::csr_matrix<IndexType,ValueType,MemorySpace> csr_matrix_type;
+
+    typedef typename cusp::symmetric_matrix<IndexType, ValueType, MemorySpace> container;
+
+    template<typename MemorySpace2>
+    struct rebind
+    {
+        typedef cusp::symmetric_matrix<IndexType, ValueType, MemorySpace2> type;
+    };
+    /*! \endcond */
+
+    /*! Storage for the entries on and above the diagonal.
+     */
+    csr_matrix_type upper;
+
+    /*! Construct an empty \p symmetric_matrix.
+     */
+    symmetric_matrix(void) {}
+
+    /*! Construct a \p symmetric_matrix with a specific shape and number of
+     *  stored entries in the upper triangle.
+     *
+     *  \param num_rows Number of rows and columns.
+     *  \param num_entries Number of nonzero matrix entries in both triangles.
+     *  \param num_upper_entries Number of entries on and above the diagonal.
+     */
+    symmetric_matrix(const size_t num_rows, const size_t num_entries, const size_t num_upper_entries)
+        : Parent(num_rows, num_rows, num_entries),
+          upper(num_rows, num_rows, num_upper_entries) {}
+
+    /*! Construct a \p symmetric_matrix from another matrix.
+     *
+     *  \param matrix Another sparse or dense matrix.
+     */
+    template <typename MatrixType>
+    symmetric_matrix(const MatrixType& matrix);
+
+    /*! Resize matrix dimensions and underlying storage
+     *
+     *  \param num_rows Number of rows and columns.
+     *  \param num_entries Number of nonzero matrix entries in both triangles.
+     *  \param num_upper_entries Number of entries on and above the diagonal.
+     */
+    void resize(const size_t num_rows, const size_t num_entries, const size_t num_upper_entries)
+    {
+        Parent::resize(num_rows, num_rows, num_entries);
+        upper.resize(num_rows, num_rows, num_upper_entries);
+    }
+
+    /*! Swap the contents of two \p symmetric_matrix objects.
+     *
+     *  \param matrix Another \p symmetric_matrix with the same IndexType and ValueType.
+     */
+    void swap(symmetric_matrix& matrix)
+    {
+        Parent::swap(matrix);
+        upper.swap(matrix.upper);
+    }
+
+    /*! Assignment from another matrix.
+     *
+     *  \tparam MatrixType Format type of input matrix.
+     *
+     *  \param matrix Another sparse or dense matrix.
+     */
+    template <typename MatrixType>
+    symmetric_matrix& operator=(const MatrixType& matrix);
+}; // class symmetric_matrix
+/*! \}
+ */
+
+} // end namespace cusp
+
+#include <cusp/detail/symmetric_matrix.inl>
@@ -20,6 +20,14 @@
 
 #include <thrust/extrema.h>
 
+#include <cuda_runtime_api.h>
+
+#include <map>
+
+#if __cplusplus >= 201103L
+#include <mutex>
+#endif
+
 #if THRUST_VERSION >= 100700
 #include <thrust/system/cuda/detail/detail/launch_calculator.h>
 #elif THRUST_VERSION >= 100600
@@ -43,7 +51,7 @@ namespace detail
 {
 
 template <typename KernelFunction>
-size_t max_active_blocks(KernelFunction kernel, const size_t CTA_SIZE, const size_t dynamic_smem_bytes)
+size_t compute_max_active_blocks(KernelFunction kernel, const size_t CTA_SIZE, const size_t dynamic_smem_bytes)
 {
 #if THRUST_VERSION >= 100700
   using namespace thrust::system::cuda::detail;
@@ -57,7 +65,131 @@ size_t max_active_blocks(KernelFunction kernel, const size_t CTA_SIZE, const siz
 #endif
 }
 
+// identifies one launch configuration, the occupancy of a kernel depends
+// on the device, the block size and the dynamic shared memory only
+struct launch_config_key
+{
+  int device;
+  const void * kernel;
+  size_t cta_size;
+  size_t dynamic_smem_bytes;
+
+  launch_config_key(int device, const void * kernel, size_t cta_size, size_t dynamic_smem_bytes)
+    : device(device), kernel(kernel), cta_size(cta_size), dynamic_smem_bytes(dynamic_smem_bytes) {}
+
+  bool operator<(const launch_config_key& other) const
+  {
+    if(device   != other.device)   return device   < other.device;
+    if(kernel   != other.kernel)   return kernel   < other.kernel;
+    if(cta_size != other.cta_size) return cta_size < other.cta_size;
+    return dynamic_smem_bytes < other.dynamic_smem_bytes;
+  }
+};
+
+typedef std::map<launch_config_key, size_t> launch_config_cache;
+
+// process-wide cache of max_active_blocks, guarded by get_launch_config_mutex
+inline launch_config_cache& get_launch_config_cache(void)
+{
+  static launch_config_cache cache;
+  return cache;
+}
+
+#if __cplusplus >= 201103L
+inline std::mutex& get_launch_config_mutex(void)
+{
+  static std::mutex mutex;
+  return mutex;
+}
+#endif
+
+template <typename KernelFunction>
+launch_config_key make_launch_config_key(KernelFunction kernel, const size_t CTA_SIZE, const size_t dynamic_smem_bytes)
+{
+  int device = 0;
+  cudaGetDevice(&device);
+
+  return launch_config_key(device, (const void *) kernel, CTA_SIZE, dynamic_smem_bytes);
+}
+
+/*
+ *  Number of blocks of CTA_SIZE threads of kernel that are co-resident on
+ *  the current device. Querying the device properties and the function
+ *  attributes costs several driver calls, so the result is computed once
+ *  per device and configuration and then served from the cache.
+ */
+template <typename KernelFunction>
+size_t max_active_blocks(KernelFunction kernel, const size_t CTA_SIZE, const size_t dynamic_smem_bytes)
+{
+  launch_config_cache& cache = get_launch_config_cache();
+  const launch_config_key key = make_launch_config_key(kernel, CTA_SIZE, dynamic_smem_bytes);
+
+  {
+#if __cplusplus >= 201103L
+    std::lock_guard<std::mutex> lock(get_launch_config_mutex());
+#endif
+
+    launch_config_cache::const_iterator iter = cache.find(key);
+
+    if(iter != cache.end())
+      return iter->second;
+  }
+
+  // the driver queries run unlocked, racing threads compute the same value
+  const size_t blocks = compute_max_active_blocks(kernel, CTA_SIZE, dynamic_smem_bytes);
+
+#if __cplusplus >= 201103L
+  std::lock_guard<std::mutex> lock(get_launch_config_mutex());
+#endif
+
+  cache.insert(std::make_pair(key, blocks));
+
+  return blocks;
+}
+
+/*
+ *  Grid size for a kernel with one work unit per units_per_block that loops
+ *  over the remaining units, i.e. min(max_active_blocks, ceil(num_units /
+ *  units_per_block)), at least one block.
+ */
+template <typename KernelFunction>
+size_t launch_blocks(KernelFunction kernel, const size_t CTA_SIZE, const size_t dynamic_smem_bytes,
+                     const size_t num_units, const size_t units_per_block)
+{
+  const size_t MAX_BLOCKS = max_active_blocks(kernel, CTA_SIZE, dynamic_smem_bytes);
+  const size_t NUM_BLOCKS = (num_units + units_per_block - 1) / units_per_block;
+
+  return thrust::max<size_t>(1, thrust::min<size_t>(MAX_BLOCKS, NUM_BLOCKS));
+}
+
 } // end namespace detail
+
+/*! \brief Computes and caches the launch configuration of a kernel
+ *
+ *  Subsequent launches of \p kernel with \p CTA_SIZE threads and
+ *  \p dynamic_smem_bytes bytes of dynamic shared memory on the current
+ *  device skip the occupancy query, e.g. to keep it out of timed regions.
+ */
+template <typename KernelFunction>
+size_t prewarm_launch_config(KernelFunction kernel, const size_t CTA_SIZE, const size_t dynamic_smem_bytes = 0)
+{
+  return detail::max_active_blocks(kernel, CTA_SIZE, dynamic_smem_bytes);
+}
+
+/*! \brief Number of cached launch configurations
+ */
+inline size_t launch_config_cache_size(void)
+{
+  return detail::get_launch_config_cache().size();
+}
+
+/*! \brief Drops the cached launch configurations, e.g. after cudaDeviceReset
+ */
+inline void clear_launch_config_cache(void)
+{
+  detail::get_launch_config_cache().clear();
+}
+
 } // end namespace cuda
 } // end namespace system
 } // end namespace cusp
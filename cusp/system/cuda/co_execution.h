@@ -0,0 +1,208 @@
+/*
+ *  Copyright 2008-2014 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*! \file co_execution.h
+ *  \brief Sparse matrix whose rows are multiplied partly by the host and
+ *  partly by the device
+ */
+
+#pragma once
+
+#include <cusp/detail/config.h>
+
+#include <cusp/array1d.h>
+#include <cusp/csr_matrix.h>
+#include <cusp/linear_operator.h>
+#include <cusp/memory.h>
+
+#include <cusp/system/cuda/detail/par.h>
+
+#include <cuda_runtime_api.h>
+
+namespace cusp
+{
+namespace system
+{
+namespace cuda
+{
+namespace co_execution
+{
+
+/*! \addtogroup containers Containers
+ *  \{
+ */
+
+/**
+ * \brief Sparse matrix whose products are computed by the host and the
+ * device at the same time
+ *
+ * \tparam IndexType Type used for matrix indices (e.g. \c int).
+ * \tparam ValueType Type used for matrix values (e.g. \c float).
+ *
+ * \par Overview
+ *  The rows are split in two consecutive blocks. The device multiplies the
+ *  leading rows on its compute stream, while the host multiplies the
+ *  trailing rows with the host system of Thrust, which is the OpenMP
+ *  backend when \c THRUST_HOST_SYSTEM is \c THRUST_HOST_SYSTEM_OMP. The
+ *  columns of the host rows are compressed, so only the entries of \c x
+ *  they reference are copied to the host, on a separate transfer stream
+ *  that overlaps the device product, and the host rows of \c y are copied
+ *  back in one transfer. Both vectors stay in device memory.
+ *
+ *  The split is given as the fraction of the entries assigned to the host.
+ *  With automatic balancing, the host and device throughputs measured over
+ *  a number of products set a new fraction, and the rows are split again
+ *  when that moves more than one percent of the rows.
+ *
+ *  The product is ordered with the work of the default stream.
+ *
+ * \par Example
+ *  \code
+ *  #include <cusp/csr_matrix.h>
+ *  #include <cusp/gallery/poisson.h>
+ *  #include <cusp/system/cuda/co_execution.h>
+ *
+ *  int main(void)
+ *  {
+ *      cusp::csr_matrix<int, float, cusp::host_memory> G;
+ *      cusp::gallery::poisson5pt(G, 1024, 1024);
+ *
+ *      // start with 10% of the entries on the host
+ *      cusp::system::cuda::co_execution::csr_matrix<int, float> A(G, 0.1);
+ *
+ *      cusp::array1d<float, cusp::device_memory> x(A.num_cols, 1), y(A.num_rows);
+ *
+ *      for (int i = 0; i < 100; i++)
+ *          A(x, y);
+ *
+ *      std::cout << "host fraction " << A.host_ratio() << std::endl;
+ *  }
+ *  \endcode
+ */
+template <typename IndexType, typename ValueType>
+class csr_matrix : public cusp::linear_operator<ValueType,cusp::device_memory,IndexType>
+{
+  private:
+
+    typedef cusp::linear_operator<ValueType,cusp::device_memory,IndexType> Parent;
+
+  public:
+
+    /*! \cond */
+    typedef cusp::csr_matrix<IndexType,ValueType,cusp::host_memory>   host_matrix_type;
+    typedef cusp::csr_matrix<IndexType,ValueType,cusp::device_memory> device_matrix_type;
+    /*! \endcond */
+
+    /*! Split \p A between the host and the device.
+     *
+     *  \param A square or rectangular matrix in any format
+     *  \param host_ratio fraction of the entries multiplied by the host,
+     *  in <tt>[0, 1]</tt>
+     *  \param auto_balance adjust the fraction from the measured
+     *  throughputs
+     *
+     *  \throws cusp::invalid_input_exception if \p host_ratio is not in
+     *  <tt>[0, 1]</tt>
+     */
+    template <typename MatrixType>
+    csr_matrix(const MatrixType& A, const double host_ratio = 0.1, const bool auto_balance = true);
+
+    ~csr_matrix(void);
+
+    /*! Fraction of the entries multiplied by the host.
+     */
+    double host_ratio(void) const;
+
+    /*! Number of rows multiplied by the host, the trailing rows.
+     */
+    size_t num_host_rows(void) const;
+
+    /*! Split the rows again so that the host multiplies the fraction
+     *  \p ratio of the entries.
+     *
+     *  \throws cusp::invalid_input_exception if \p ratio is not in
+     *  <tt>[0, 1]</tt>
+     */
+    void set_host_ratio(const double ratio);
+
+    /*! Enable or disable balancing, the throughputs are measured over
+     *  \p interval products before the split is revised.
+     */
+    void set_auto_balance(const bool enable, const size_t interval = 8);
+
+    /*! Rows computed by the device and the host.
+     */
+    const device_matrix_type& device_part(void) const;
+    const host_matrix_type& host_part(void) const;
+
+    /*! Multiply the matrix with \p x, y = A x, both in device memory.
+     *
+     *  \throws cusp::invalid_input_exception if the sizes of \p x or \p y
+     *  do not match the matrix
+     */
+    template <typename ArrayType1, typename ArrayType2>
+    void operator()(const ArrayType1& x, ArrayType2& y) const;
+
+  private:
+
+    /*! \cond */
+    host_matrix_type matrix;
+
+    // the split is revised by balancing during the products
+    mutable device_matrix_type device_rows;
+    mutable host_matrix_type   host_rows;
+
+    // columns referenced by the host rows, gathered from x for the host
+    mutable cusp::array1d<IndexType,cusp::device_memory>   host_columns;
+    mutable cusp::array1d<ValueType,cusp::device_memory>   send_buffer;
+    mutable cusp::array1d<ValueType,cusp::pinned_memory>   host_x;
+    mutable cusp::array1d<ValueType,cusp::pinned_memory>   host_y;
+
+    mutable size_t split;
+    mutable double ratio;
+    bool   balance;
+    size_t balance_interval;
+
+    // throughput samples since the last revision of the split
+    mutable size_t num_samples;
+    mutable double host_seconds;
+    mutable double device_seconds;
+
+    cudaStream_t compute;
+    cudaStream_t transfer;
+    cudaEvent_t  ready;
+    cudaEvent_t  device_start;
+    cudaEvent_t  device_done;
+    cudaEvent_t  received;
+    cudaEvent_t  finished;
+
+    csr_matrix(const csr_matrix&);
+    csr_matrix& operator=(const csr_matrix&);
+
+    void partition(const double ratio) const;
+    void rebalance(void) const;
+    void release(void);
+    /*! \endcond */
+};
+/*! \}
+ */
+
+} // end namespace co_execution
+} // end namespace cuda
+} // end namespace system
+} // end namespace cusp
+
+#include <cusp/system/cuda/detail/co_execution.inl>
@@ -0,0 +1,267 @@
+/*
+ *  Copyright 2008-2014 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*! \file cublas_handles.h
+ *  \brief Shared cuBLAS handles used by the CUDA BLAS routines
+ */
+
+#pragma once
+
+#include <cusp/detail/config.h>
+#include <cusp/exception.h>
+
+#include <cusp/system/cuda/detail/execution_policy.h>
+#include <cusp/system/cuda/detail/cublas/exception.h>
+
+#include <cublas_v2.h>
+#include <cuda_runtime_api.h>
+
+#include <map>
+#include <utility>
+
+#if __cplusplus >= 201103L
+#include <mutex>
+#endif
+
+// cublasSetWorkspace is available from cuBLAS 11.4
+#if defined(CUBLAS_VERSION) && (CUBLAS_VERSION >= 110400)
+#define CUSP_CUBLAS_HAS_SET_WORKSPACE 1
+#else
+#define CUSP_CUBLAS_HAS_SET_WORKSPACE 0
+#endif
+
+// workspace preallocated for every pooled handle, in bytes
+#ifndef CUSP_CUBLAS_WORKSPACE_SIZE
+#define CUSP_CUBLAS_WORKSPACE_SIZE (4 << 20)
+#endif
+
+namespace cusp
+{
+namespace system
+{
+namespace cuda
+{
+namespace detail
+{
+
+//////////////////////////////////////////////////////////////////////////////
+// Pool of cuBLAS handles
+//////////////////////////////////////////////////////////////////////////////
+//
+// Creating a handle takes milliseconds, so the BLAS routines called with
+// the plain CUDA execution policies share one handle per device and stream.
+// Each handle is bound to its stream when it is created and given its own
+// workspace, which cuBLAS would otherwise allocate on the first call of a
+// routine that needs one. Lookups and creation are serialized by a mutex;
+// handles of different streams are used concurrently without locking.
+
+class cublas_handle_pool
+{
+  private:
+
+    struct entry
+    {
+        cublasHandle_t handle;
+        void *         workspace;
+    };
+
+    typedef std::pair<int, cudaStream_t> key_type;
+    typedef std::map<key_type, entry>    map_type;
+
+    map_type entries;
+    size_t   workspace_size;
+
+#if __cplusplus >= 201103L
+    std::mutex mutex;
+#endif
+
+    entry create(const cudaStream_t s)
+    {
+        entry e;
+        e.handle    = 0;
+        e.workspace = 0;
+
+        cublasStatus_t stat = cublasCreate(&e.handle);
+        if (stat != CUBLAS_STATUS_SUCCESS)
+            throw cublas::cublas_exception("cublasCreate", stat);
+
+        cublasSetStream(e.handle, s);
+
+#if CUSP_CUBLAS_HAS_SET_WORKSPACE
+        if (workspace_size > 0 && cudaMalloc(&e.workspace, workspace_size) == cudaSuccess)
+        {
+            cublasSetWorkspace(e.handle, e.workspace, workspace_size);
+        }
+        else
+        {
+            // cuBLAS falls back to its own allocation
+            e.workspace = 0;
+            cudaGetLastError();
+        }
+#endif
+
+        return e;
+    }
+
+  public:
+
+    cublas_handle_pool(void) : workspace_size(CUSP_CUBLAS_WORKSPACE_SIZE) {}
+
+    // handle of the current device which issues its work on s
+    cublasHandle_t handle(const cudaStream_t s)
+    {
+        int device = 0;
+        cudaGetDevice(&device);
+
+        const key_type key(device, s);
+
+#if __cplusplus >= 201103L
+        std::lock_guard<std::mutex> lock(mutex);
+#endif
+
+        map_type::iterator it = entries.find(key);
+
+        if (it == entries.end())
+            it = entries.insert(std::make_pair(key, create(s))).first;
+
+        return it->second.handle;
+    }
+
+    void set_workspace_size(const size_t bytes)
+    {
+#if __cplusplus >= 201103L
+        std::lock_guard<std::mutex> lock(mutex);
+#endif
+
+        workspace_size = bytes;
+    }
+
+    void clear(void)
+    {
+#if __cplusplus >= 201103L
+        std::lock_guard<std::mutex> lock(mutex);
+#endif
+
+        int current = 0;
+        cudaGetDevice(&current);
+
+        for (map_type::iterator it = entries.begin(); it != entries.end(); ++it)
+        {
+            cudaSetDevice(it->first.first);
+
+            cublasDestroy(it->second.handle);
+
+            if (it->second.workspace)
+                cudaFree(it->second.workspace);
+        }
+
+        cudaSetDevice(current);
+
+        entries.clear();
+    }
+};
+
+// never destroyed: the CUDA runtime may be torn down before the static
+// destructors run, and the driver releases the handles at exit
+inline cublas_handle_pool& get_cublas_handle_pool(void)
+{
+    static cublas_handle_pool * pool = new cublas_handle_pool;
+    return *pool;
+}
+
+template <typename DerivedPolicy>
+cublasHandle_t pooled_cublas_handle(cuda::execution_policy<DerivedPolicy>& exec)
+{
+    return get_cublas_handle_pool().handle(stream(thrust::detail::derived_cast(exec)));
+}
+
+} // end namespace detail
+
+/*! \addtogroup algorithms Algorithms
+ *  \{
+ */
+
+/**
+ * \brief Shared cuBLAS handle of the current device for a stream.
+ *
+ * \param s stream the handle issues its work on
+ *
+ * \par Overview
+ *  When cuBLAS is the device BLAS system (\c CUSP_DEVICE_BLAS_SYSTEM is
+ *  \c CUSP_DEVICE_BLAS_CUBLAS), the \p cusp::blas routines called with
+ *  device arrays and the default or a stream execution policy, as well as
+ *  the dense products of \p cusp::multiply, use these handles. One handle
+ *  is created for every device and stream on first use, bound to the
+ *  stream, and given a preallocated workspace of
+ *  \c CUSP_CUBLAS_WORKSPACE_SIZE bytes, or the size set with
+ *  \p set_cublas_workspace_size. Calling this function during
+ *  initialization moves the cost of creating the handle out of the first
+ *  BLAS call. The function is thread-safe when compiled as C++11.
+ *
+ *  The handle remains owned by cusp and may be passed to
+ *  <tt>cusp::cuda::par.with(h)</tt>, but must not be destroyed or moved
+ *  to another stream.
+ *
+ * \par Example
+ *  \code
+ *  #include <cusp/system/cuda/cublas_handles.h>
+ *
+ *  int main(void)
+ *  {
+ *      cudaStream_t s;
+ *      cudaStreamCreate(&s);
+ *
+ *      // create the handle of s before the first request
+ *      cusp::system::cuda::cublas_handle(s);
+ *
+ *      // ...
+ *
+ *      cusp::system::cuda::clear_cublas_handles();
+ *      cudaStreamDestroy(s);
+ *  }
+ *  \endcode
+ */
+inline cublasHandle_t cublas_handle(const cudaStream_t s = 0)
+{
+    return detail::get_cublas_handle_pool().handle(s);
+}
+
+/**
+ * \brief Set the workspace preallocated for handles created afterwards.
+ *
+ * \param bytes workspace size, 0 leaves the allocation to cuBLAS
+ */
+inline void set_cublas_workspace_size(const size_t bytes)
+{
+    detail::get_cublas_handle_pool().set_workspace_size(bytes);
+}
+
+/**
+ * \brief Destroy the shared cuBLAS handles and their workspaces, e.g.
+ * before the streams they are bound to are destroyed. No BLAS routine may
+ * be running with them.
+ */
+inline void clear_cublas_handles(void)
+{
+    detail::get_cublas_handle_pool().clear();
+}
+
+/*! \}
+ */
+
+} // end namespace cuda
+} // end namespace system
+} // end namespace cusp
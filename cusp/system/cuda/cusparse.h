@@ -0,0 +1,88 @@
+/*
+ *  Copyright 2008-2014 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*! \file cusparse.h
+ *  \brief Sparse products computed by the cusparse library
+ */
+
+#pragma once
+
+#include <cusp/detail/config.h>
+
+#include <cusp/system/cuda/detail/par.h>
+#include <cusp/system/cuda/detail/cusparse/cusparse_csr_matrix.h>
+#include <cusp/system/cuda/detail/cusparse/multiply.h>
+
+/*! \addtogroup algorithms Algorithms
+ *  \{
+ */
+
+/*! \page cusparse_backend Cusparse backend
+ *
+ * \par Overview
+ *  Including this header lets the generic SpMV, SpMM and SpGEMM routines
+ *  of cusparse compute the products of device CSR matrices, which is
+ *  selected in two ways:
+ *
+ *  - <tt>cusp::multiply(cusp::cuda::par.with(h), A, B, C)</tt>, with \c h
+ *    a \c cusparseHandle_t created by the application, computes
+ *    <tt>A * x</tt>, <tt>A * X</tt> for a dense \c X, and <tt>A * B</tt>
+ *    for a CSR \c B with cusparse. <tt>par.on(s).with(h)</tt> moves the
+ *    handle onto the stream \c s.
+ *  - <tt>cusp::cuda::cusparse_csr_matrix<ValueType></tt> views a device
+ *    \p csr_matrix and computes its products with cusparse under every
+ *    CUDA execution policy. It keeps the matrix descriptor and, for each
+ *    stream, a handle and the external workspace from one product to the
+ *    next, so repeated products, as in the iterations of a solver, do not
+ *    create or allocate anything.
+ *
+ *  Products whose values are not all \c float, \c double or the complex
+ *  types of these, or with functors other than the standard (+, *)
+ *  semiring, use the cusp kernels. The program must be linked with
+ *  \c cusparse.
+ *
+ * \par Example
+ *  \code
+ *  #include <cusp/csr_matrix.h>
+ *  #include <cusp/gallery/poisson.h>
+ *  #include <cusp/krylov/cg.h>
+ *  #include <cusp/system/cuda/cusparse.h>
+ *
+ *  int main(void)
+ *  {
+ *      cusp::csr_matrix<int, float, cusp::device_memory> A;
+ *      cusp::gallery::poisson5pt(A, 1024, 1024);
+ *
+ *      // every product of cg reuses the descriptors and workspace
+ *      cusp::cuda::cusparse_csr_matrix<float> S(A);
+ *
+ *      cusp::array1d<float, cusp::device_memory> x(A.num_rows, 0), b(A.num_rows, 1);
+ *      cusp::krylov::cg(S, x, b);
+ *
+ *      // A * A with a handle owned by the application
+ *      cusparseHandle_t h;
+ *      cusparseCreate(&h);
+ *
+ *      cusp::csr_matrix<int, float, cusp::device_memory> C;
+ *      cusp::multiply(cusp::cuda::par.with(h), A, A, C);
+ *
+ *      cusparseDestroy(h);
+ *  }
+ *  \endcode
+ */
+
+/*! \}
+ */
@@ -0,0 +1,66 @@
+/*
+ *  Copyright 2008-2014 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+
+#pragma once
+
+#include <cusp/detail/config.h>
+
+#include <cusp/analyze.h>
+
+#include <cusp/system/cuda/detail/execution_policy.h>
+
+namespace cusp
+{
+namespace system
+{
+namespace cuda
+{
+namespace detail
+{
+
+// The spmv kernels of the padded formats assign one thread to each row and
+// read the matrix with coalesced column major loads, they win as long as the
+// padding stays small.  DIA also avoids loading column indices altogether.
+// HYB moves the long rows of irregular matrices into a COO part, while CSR
+// is kept for matrices with too few rows to fill an ELL part.
+template <typename DerivedPolicy>
+cusp::matrix_storage
+predict_storage(cuda::execution_policy<DerivedPolicy>& exec,
+                const cusp::matrix_profile& profile)
+{
+    const double max_dia_fill = 2.0;
+    const double max_ell_fill = 1.5;
+
+    if(profile.num_entries == 0)
+        return cusp::csr_storage;
+
+    if(profile.dia_fill_ratio <= max_dia_fill)
+        return cusp::dia_storage;
+
+    if(profile.ell_fill_ratio <= max_ell_fill)
+        return cusp::ell_storage;
+
+    if(profile.optimal_entries_per_row > 0)
+        return cusp::hyb_storage;
+
+    return cusp::csr_storage;
+}
+
+} // end namespace detail
+} // end namespace cuda
+} // end namespace system
+} // end namespace cusp
@@ -0,0 +1,311 @@
+/*
+ *  Copyright 2008-2014 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#pragma once
+
+#include <cusp/detail/config.h>
+#include <cusp/detail/format.h>
+#include <cusp/detail/temporary_array.h>
+
+#include <cusp/system/detail/generic/assemble.h>
+
+#include <cusp/system/cuda/utils.h>
+#include <cusp/system/cuda/detail/execution_policy.h>
+
+#include <thrust/copy.h>
+#include <thrust/count.h>
+#include <thrust/fill.h>
+#include <thrust/for_each.h>
+#include <thrust/sort.h>
+#include <thrust/transform.h>
+#include <thrust/tuple.h>
+#include <thrust/detail/type_traits.h>
+#include <thrust/iterator/zip_iterator.h>
+
+namespace cusp
+{
+namespace system
+{
+namespace cuda
+{
+namespace detail
+{
+
+//////////////////////////////////////////////////////////////////////////////
+// Atomic assembly
+//////////////////////////////////////////////////////////////////////////////
+//
+// Without a pattern every triplet (i,j,v) is inserted into an open
+// addressing table keyed by the packed 64-bit index (i << 32 | j), the key
+// is claimed with atomicCAS and the value accumulated with atomic addition.
+// The table holds twice as many slots as triplets so the probe sequences
+// stay short.  Only the distinct entries are compacted and sorted
+// afterwards, the triplet stream itself is never sorted.
+//
+// With a pattern the position of every triplet is found by binary search
+// and the values are added in place.
+//
+// Both paths need int indices and float or double values, every other
+// combination uses the generic sort based implementation.
+
+template <typename IndexType, typename ValueType>
+struct assemble_atomic_supported : thrust::detail::false_type {};
+
+template <>
+struct assemble_atomic_supported<int, float> : thrust::detail::true_type {};
+
+template <>
+struct assemble_atomic_supported<int, double> : thrust::detail::true_type {};
+
+#define CUSP_ASSEMBLE_EMPTY_KEY 0xffffffffffffffffULL
+
+struct assemble_occupied_slot
+{
+    template <typename Tuple>
+    __host__ __device__
+    bool operator()(const Tuple& t) const
+    {
+        return thrust::get<0>(t) != CUSP_ASSEMBLE_EMPTY_KEY;
+    }
+};
+
+template <typename IndexType>
+struct assemble_unpack_row : public thrust::unary_function<unsigned long long,IndexType>
+{
+    __host__ __device__
+    IndexType operator()(const unsigned long long key) const
+    {
+        return IndexType(key >> 32);
+    }
+};
+
+template <typename IndexType>
+struct assemble_unpack_column : public thrust::unary_function<unsigned long long,IndexType>
+{
+    __host__ __device__
+    IndexType operator()(const unsigned long long key) const
+    {
+        return IndexType(key & 0xffffffffULL);
+    }
+};
+
+#if defined(__CUDACC__)
+// finalizer of the 64-bit MurmurHash3, spreads neighbouring (i,j) keys
+// over the whole table
+__device__ inline unsigned long long assemble_hash(unsigned long long key)
+{
+    key ^= key >> 33;
+    key *= 0xff51afd7ed558ccdULL;
+    key ^= key >> 33;
+    key *= 0xc4ceb9fe1a85ec53ULL;
+    key ^= key >> 33;
+
+    return key;
+}
+
+template <typename ValueType>
+struct assemble_hash_insert
+{
+    unsigned long long * keys;
+    ValueType * values;
+    unsigned long long mask;
+
+    assemble_hash_insert(unsigned long long * keys, ValueType * values, const unsigned long long mask)
+        : keys(keys), values(values), mask(mask) {}
+
+    template <typename Tuple>
+    __device__
+    void operator()(const Tuple& t) const
+    {
+        const unsigned long long key =
+            ((unsigned long long) (unsigned int) thrust::get<0>(t) << 32) | (unsigned int) thrust::get<1>(t);
+
+        unsigned long long slot = assemble_hash(key) & mask;
+
+        while (true)
+        {
+            const unsigned long long old = atomicCAS(keys + slot, CUSP_ASSEMBLE_EMPTY_KEY, key);
+
+            if (old == CUSP_ASSEMBLE_EMPTY_KEY || old == key)
+            {
+                atomic_add(values + slot, ValueType(thrust::get<2>(t)));
+                return;
+            }
+
+            slot = (slot + 1) & mask;
+        }
+    }
+};
+
+template <typename ValueType>
+struct assemble_scatter_add
+{
+    ValueType * values;
+
+    assemble_scatter_add(ValueType * values)
+        : values(values) {}
+
+    template <typename Tuple>
+    __device__
+    void operator()(const Tuple& t) const
+    {
+        atomic_add(values + thrust::get<0>(t), ValueType(thrust::get<1>(t)));
+    }
+};
+#endif
+
+template <typename DerivedPolicy,
+          typename ArrayType1, typename ArrayType2, typename ArrayType3,
+          typename MatrixType>
+void assemble_hash(cuda::execution_policy<DerivedPolicy>& exec,
+                   const size_t num_rows, const size_t num_cols,
+                   const ArrayType1& row_indices, const ArrayType2& column_indices, const ArrayType3& values,
+                   MatrixType& A,
+                   thrust::detail::true_type)
+{
+    typedef typename MatrixType::index_type IndexType;
+    typedef typename MatrixType::value_type ValueType;
+
+    const size_t N = row_indices.size();
+
+    size_t table_size = 32;
+    while (table_size < 2 * N)
+        table_size *= 2;
+
+    cusp::detail::temporary_array<unsigned long long, DerivedPolicy> keys(exec, table_size, CUSP_ASSEMBLE_EMPTY_KEY);
+    cusp::detail::temporary_array<ValueType, DerivedPolicy> sums(exec, table_size, ValueType(0));
+
+    thrust::for_each(exec,
+                     thrust::make_zip_iterator(thrust::make_tuple(row_indices.begin(), column_indices.begin(), values.begin())),
+                     thrust::make_zip_iterator(thrust::make_tuple(row_indices.end(),   column_indices.end(),   values.end())),
+                     assemble_hash_insert<ValueType>(thrust::raw_pointer_cast(&keys[0]),
+                                                     thrust::raw_pointer_cast(&sums[0]),
+                                                     table_size - 1));
+
+    const size_t num_entries = table_size - thrust::count(exec, keys.begin(), keys.end(), CUSP_ASSEMBLE_EMPTY_KEY);
+
+    // every entry of the output is written below
+    A.resize(num_rows, num_cols, num_entries, cusp::no_init);
+
+    // compact the occupied slots and order the distinct entries by (i,j)
+    cusp::detail::temporary_array<unsigned long long, DerivedPolicy> entries(exec, num_entries);
+
+    thrust::copy_if(exec,
+                    thrust::make_zip_iterator(thrust::make_tuple(keys.begin(), sums.begin())),
+                    thrust::make_zip_iterator(thrust::make_tuple(keys.end(),   sums.end())),
+                    thrust::make_zip_iterator(thrust::make_tuple(entries.begin(), A.values.begin())),
+                    assemble_occupied_slot());
+
+    thrust::sort_by_key(exec, entries.begin(), entries.end(), A.values.begin());
+
+    thrust::transform(exec, entries.begin(), entries.end(), A.row_indices.begin(),    assemble_unpack_row<IndexType>());
+    thrust::transform(exec, entries.begin(), entries.end(), A.column_indices.begin(), assemble_unpack_column<IndexType>());
+}
+
+template <typename DerivedPolicy,
+          typename ArrayType1, typename ArrayType2, typename ArrayType3,
+          typename MatrixType>
+void assemble_hash(cuda::execution_policy<DerivedPolicy>& exec,
+                   const size_t num_rows, const size_t num_cols,
+                   const ArrayType1& row_indices, const ArrayType2& column_indices, const ArrayType3& values,
+                   MatrixType& A,
+                   thrust::detail::false_type)
+{
+    cusp::system::detail::generic::assemble(exec, num_rows, num_cols, row_indices, column_indices, values, A, cusp::coo_format());
+}
+
+template <typename DerivedPolicy,
+          typename ArrayType1, typename ArrayType2, typename ArrayType3,
+          typename MatrixType>
+void assemble(cuda::execution_policy<DerivedPolicy>& exec,
+              const size_t num_rows, const size_t num_cols,
+              const ArrayType1& row_indices, const ArrayType2& column_indices, const ArrayType3& values,
+              MatrixType& A,
+              cusp::coo_format)
+{
+    typedef typename MatrixType::index_type IndexType;
+    typedef typename MatrixType::value_type ValueType;
+    typedef assemble_atomic_supported<IndexType,ValueType> AtomicSupported;
+
+    if (row_indices.size() == 0)
+    {
+        A.resize(num_rows, num_cols, 0);
+        return;
+    }
+
+    assemble_hash(exec, num_rows, num_cols, row_indices, column_indices, values, A, AtomicSupported());
+}
+
+template <typename DerivedPolicy,
+          typename ArrayType1, typename ArrayType2, typename ArrayType3,
+          typename MatrixType>
+void assemble_scatter(cuda::execution_policy<DerivedPolicy>& exec,
+                      const ArrayType1& row_indices, const ArrayType2& column_indices, const ArrayType3& values,
+                      MatrixType& A,
+                      thrust::detail::true_type)
+{
+    typedef typename MatrixType::index_type IndexType;
+    typedef typename MatrixType::value_type ValueType;
+
+    cusp::detail::temporary_array<IndexType, DerivedPolicy> positions(exec, row_indices.size());
+    cusp::system::detail::generic::assemble_positions(exec, row_indices, column_indices, A, positions);
+
+    thrust::fill(exec, A.values.begin(), A.values.end(), ValueType(0));
+
+    if (row_indices.size() == 0)
+        return;
+
+    thrust::for_each(exec,
+                     thrust::make_zip_iterator(thrust::make_tuple(positions.begin(), values.begin())),
+                     thrust::make_zip_iterator(thrust::make_tuple(positions.end(),   values.end())),
+                     assemble_scatter_add<ValueType>(thrust::raw_pointer_cast(&A.values[0])));
+}
+
+template <typename DerivedPolicy,
+          typename ArrayType1, typename ArrayType2, typename ArrayType3,
+          typename MatrixType>
+void assemble_scatter(cuda::execution_policy<DerivedPolicy>& exec,
+                      const ArrayType1& row_indices, const ArrayType2& column_indices, const ArrayType3& values,
+                      MatrixType& A,
+                      thrust::detail::false_type)
+{
+    typedef typename MatrixType::format Format;
+
+    cusp::system::detail::generic::assemble_values(exec, row_indices, column_indices, values, A, Format());
+}
+
+template <typename DerivedPolicy,
+          typename ArrayType1, typename ArrayType2, typename ArrayType3,
+          typename MatrixType,
+          typename Format>
+void assemble_values(cuda::execution_policy<DerivedPolicy>& exec,
+                     const ArrayType1& row_indices, const ArrayType2& column_indices, const ArrayType3& values,
+                     MatrixType& A,
+                     Format)
+{
+    typedef typename MatrixType::index_type IndexType;
+    typedef typename MatrixType::value_type ValueType;
+    typedef assemble_atomic_supported<IndexType,ValueType> AtomicSupported;
+
+    assemble_scatter(exec, row_indices, column_indices, values, A, AtomicSupported());
+}
+
+#undef CUSP_ASSEMBLE_EMPTY_KEY
+
+} // end namespace detail
+} // end namespace cuda
+} // end namespace system
+} // end namespace cusp
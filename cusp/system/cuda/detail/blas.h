@@ -18,6 +18,467 @@
 #pragma once
 
 #include <cusp/detail/config.h>
+#include <cusp/detail/format.h>
+#include <cusp/detail/temporary_array.h>
 
-// this system has no blas implementation
+#include <cusp/system/detail/generic/blas.h>
 
+#include <cusp/system/cuda/arch.h>
+#include <cusp/system/cuda/utils.h>
+#include <cusp/system/cuda/detail/execution_policy.h>
+
+#include <thrust/copy.h>
+#include <thrust/extrema.h>
+#include <thrust/fill.h>
+#include <thrust/functional.h>
+#include <thrust/detail/type_traits.h>
+#include <thrust/iterator/detail/is_trivial_iterator.h>
+
+#if defined(__CUDACC__)
+#include <cusp/system/cuda/detail/stream_graph_blas.h>
+#endif
+
+#include <algorithm>
+#include <cmath>
+
+// the remaining blas routines are provided by the generic system
+
+namespace cusp
+{
+namespace system
+{
+namespace cuda
+{
+namespace detail
+{
+
+//////////////////////////////////////////////////////////////////////////////
+// fused dot products
+//////////////////////////////////////////////////////////////////////////////
+//
+// Every block strides over the rows and keeps DOTS_COLUMNS running sums per
+// thread, so x is loaded once for each group of DOTS_COLUMNS columns of Y,
+// and blockIdx.y selects the group.  The per block sums are reduced in
+// shared memory and written to a partials array, which a second kernel
+// reduces with one block per column before a single copy to the results.
+// Element types other than float and double, and row major matrices, use the
+// generic reduce_by_key implementation.
+
+template <typename ValueType, typename Orientation>
+struct dots_kernel_supported : thrust::detail::false_type {};
+
+template <>
+struct dots_kernel_supported<float, cusp::column_major> : thrust::detail::true_type {};
+
+template <>
+struct dots_kernel_supported<double, cusp::column_major> : thrust::detail::true_type {};
+
+#define CUSP_DOTS_COLUMNS 8
+
+#if defined(__CUDACC__)
+template <typename ValueType, unsigned int BLOCK_SIZE>
+__device__
+ValueType dots_block_sum(ValueType * sdata, const ValueType value)
+{
+    sdata[threadIdx.x] = value;
+    __syncthreads();
+
+    for(unsigned int offset = BLOCK_SIZE / 2; offset > 0; offset /= 2)
+    {
+        if(threadIdx.x < offset)
+            sdata[threadIdx.x] += sdata[threadIdx.x + offset];
+
+        __syncthreads();
+    }
+
+    const ValueType sum = sdata[0];
+    __syncthreads();
+
+    return sum;
+}
+
+template <typename ValueType, typename Iterator1, typename Iterator2, typename UnaryFunction, unsigned int BLOCK_SIZE, unsigned int COLUMNS>
+__launch_bounds__(BLOCK_SIZE,1)
+__global__ void
+dots_kernel(const int num_rows,
+            const int num_cols,
+            const int pitch,
+            const Iterator1 x,
+            const Iterator2 Y,
+            UnaryFunction op,
+            ValueType * partials)
+{
+    __shared__ ValueType sdata[BLOCK_SIZE];
+
+    const int thread_id  = BLOCK_SIZE * blockIdx.x + threadIdx.x;
+    const int grid_size  = BLOCK_SIZE * gridDim.x;
+    const int first_col  = COLUMNS * blockIdx.y;
+    const int group_cols = thrust::min(int(COLUMNS), num_cols - first_col);
+
+    ValueType sums[COLUMNS];
+
+    #pragma unroll
+    for(unsigned int c = 0; c < COLUMNS; c++)
+        sums[c] = ValueType(0);
+
+    for(int i = thread_id; i < num_rows; i += grid_size)
+    {
+        const ValueType xi = op(ValueType(x[i]));
+
+        #pragma unroll
+        for(unsigned int c = 0; c < COLUMNS; c++)
+            if(int(c) < group_cols)
+                sums[c] += xi * ValueType(Y[size_t(first_col + c) * pitch + i]);
+    }
+
+    // group_cols is uniform across the block
+    for(int c = 0; c < group_cols; c++)
+    {
+        const ValueType sum = dots_block_sum<ValueType,BLOCK_SIZE>(sdata, sums[c]);
+
+        if(threadIdx.x == 0)
+            partials[size_t(first_col + c) * gridDim.x + blockIdx.x] = sum;
+    }
+}
+
+template <typename ValueType, unsigned int BLOCK_SIZE>
+__launch_bounds__(BLOCK_SIZE,1)
+__global__ void
+dots_finalize_kernel(const int num_partials,
+                     const ValueType * partials,
+                     ValueType * sums)
+{
+    __shared__ ValueType sdata[BLOCK_SIZE];
+
+    const ValueType * column = partials + size_t(blockIdx.x) * num_partials;
+
+    ValueType sum = ValueType(0);
+
+    for(int n = threadIdx.x; n < num_partials; n += BLOCK_SIZE)
+        sum += column[n];
+
+    sum = dots_block_sum<ValueType,BLOCK_SIZE>(sdata, sum);
+
+    if(threadIdx.x == 0)
+        sums[blockIdx.x] = sum;
+}
+#endif
+
+template <typename DerivedPolicy,
+          typename Array1,
+          typename Array2d,
+          typename Array2,
+          typename UnaryFunction>
+void __dots(cuda::execution_policy<DerivedPolicy>& exec,
+            const Array1& x,
+            const Array2d& Y,
+                  Array2& results,
+            UnaryFunction op,
+            thrust::detail::false_type)
+{
+    cusp::system::detail::generic::blas::dots(exec, x, Y, results, op);
+}
+
+template <typename DerivedPolicy,
+          typename Array1,
+          typename Array2d,
+          typename Array2,
+          typename UnaryFunction>
+void __dots(cuda::execution_policy<DerivedPolicy>& exec,
+            const Array1& x,
+            const Array2d& Y,
+                  Array2& results,
+            UnaryFunction op,
+            thrust::detail::true_type)
+{
+#if defined(__CUDACC__)
+    typedef typename Array2::value_type                          ValueType;
+    typedef typename Array1::const_iterator                      Iterator1;
+    typedef typename Array2d::values_array_type::const_iterator  Iterator2;
+
+    const unsigned int BLOCK_SIZE = 256;
+    const unsigned int COLUMNS    = CUSP_DOTS_COLUMNS;
+
+    if(x.size() != Y.num_rows)
+        throw cusp::invalid_input_exception("array dimensions do not match");
+
+    results.resize(Y.num_cols);
+
+    if(Y.num_cols == 0)
+        return;
+
+    if(Y.num_rows == 0)
+    {
+        thrust::fill(results.begin(), results.end(), ValueType(0));
+        return;
+    }
+
+    const size_t NUM_GROUPS = DIVIDE_INTO(Y.num_cols, COLUMNS);
+    const size_t MAX_BLOCKS = cusp::system::cuda::detail::max_active_blocks(
+                                dots_kernel<ValueType, Iterator1, Iterator2, UnaryFunction, BLOCK_SIZE, COLUMNS>,
+                                BLOCK_SIZE, (size_t) 0);
+    const size_t NUM_BLOCKS = std::max<size_t>(1, std::min<size_t>(DIVIDE_INTO(MAX_BLOCKS, NUM_GROUPS), DIVIDE_INTO(Y.num_rows, BLOCK_SIZE)));
+
+    cusp::detail::temporary_array<ValueType, DerivedPolicy> partials(exec, NUM_BLOCKS * Y.num_cols);
+    cusp::detail::temporary_array<ValueType, DerivedPolicy> sums(exec, Y.num_cols);
+
+    cudaStream_t s = stream(thrust::detail::derived_cast(exec));
+
+    dots_kernel<ValueType, Iterator1, Iterator2, UnaryFunction, BLOCK_SIZE, COLUMNS> <<<dim3(NUM_BLOCKS, NUM_GROUPS), BLOCK_SIZE, 0, s>>>
+    (Y.num_rows, Y.num_cols, Y.pitch, x.begin(), Y.values.begin(), op, thrust::raw_pointer_cast(&partials[0]));
+
+    dots_finalize_kernel<ValueType, BLOCK_SIZE> <<<Y.num_cols, BLOCK_SIZE, 0, s>>>
+    (NUM_BLOCKS, thrust::raw_pointer_cast(&partials[0]), thrust::raw_pointer_cast(&sums[0]));
+
+    thrust::copy(sums.begin(), sums.end(), results.begin());
+#else
+    __dots(exec, x, Y, results, op, thrust::detail::false_type());
+#endif
+}
+
+template <typename DerivedPolicy,
+          typename Array1,
+          typename Array2d,
+          typename Array2>
+void dots(cuda::execution_policy<DerivedPolicy>& exec,
+          const Array1& x,
+          const Array2d& Y,
+                Array2& results)
+{
+    typedef typename Array2::value_type   ValueType;
+    typedef typename Array2d::orientation Orientation;
+
+    __dots(exec, x, Y, results, thrust::identity<ValueType>(),
+           typename dots_kernel_supported<ValueType,Orientation>::type());
+}
+
+template <typename DerivedPolicy,
+          typename Array1,
+          typename Array2d,
+          typename Array2>
+void dotcs(cuda::execution_policy<DerivedPolicy>& exec,
+           const Array1& x,
+           const Array2d& Y,
+                 Array2& results)
+{
+    typedef typename Array2::value_type   ValueType;
+    typedef typename Array2d::orientation Orientation;
+
+    // conjugation is the identity for the supported real types
+    __dots(exec, x, Y, results, cusp::conj_functor<ValueType>(),
+           typename dots_kernel_supported<ValueType,Orientation>::type());
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// reductions into device memory
+//////////////////////////////////////////////////////////////////////////////
+//
+// The per block partial sums of the graph solvers' dotc kernel are reduced
+// by a single block that writes the value straight into the result, so no
+// value is returned to the host and the call does not wait for the kernels.
+// The partial sums live in a temporary array, and releasing it through the
+// default allocator synchronizes with the device; a policy with a
+// cusp::caching_allocator avoids that. Arrays of other element types, or
+// arrays that are not contiguous, use the generic version.
+
+template <typename Array1, typename Array2, typename Array3, typename ValueType>
+struct reduce_indirect_supported
+  : thrust::detail::integral_constant<bool,
+      thrust::detail::is_same<typename Array1::value_type, ValueType>::value &&
+      thrust::detail::is_same<typename Array2::value_type, ValueType>::value &&
+      thrust::detail::is_same<typename Array3::value_type, ValueType>::value &&
+      thrust::detail::is_same<typename Array3::memory_space, cusp::device_memory>::value &&
+      thrust::detail::is_trivial_iterator<typename Array1::const_iterator>::value &&
+      thrust::detail::is_trivial_iterator<typename Array2::const_iterator>::value &&
+      thrust::detail::is_trivial_iterator<typename Array3::iterator>::value> {};
+
+template <typename ValueType>
+struct is_real_blas_type
+  : thrust::detail::integral_constant<bool,
+      thrust::detail::is_same<ValueType, float>::value ||
+      thrust::detail::is_same<ValueType, double>::value> {};
+
+template <typename ValueType>
+struct store_dot_scalar
+{
+    __host__ __device__
+    void operator()(ValueType * s, const ValueType * dots) const
+    {
+        s[0] = dots[0];
+    }
+};
+
+template <typename ValueType>
+struct store_nrm2_scalar
+{
+    __host__ __device__
+    void operator()(ValueType * s, const ValueType * dots) const
+    {
+        s[0] = sqrt(dots[0]);
+    }
+};
+
+template <typename DerivedPolicy,
+          typename Array1,
+          typename Array2,
+          typename Array3,
+          typename ScalarFunction>
+void __reduce_indirect(cuda::execution_policy<DerivedPolicy>& exec,
+                       const Array1& x,
+                       const Array2& y,
+                             Array3& result,
+                       ScalarFunction f)
+{
+#if defined(__CUDACC__)
+    typedef typename Array3::value_type ValueType;
+
+    cusp::assert_same_dimensions(x, y);
+
+    const size_t n = x.size();
+
+    cusp::detail::temporary_array<ValueType, DerivedPolicy> partials(exec, graph_num_partials(n));
+
+    graph_dotc(exec, n,
+               n == 0 ? (const ValueType *) NULL : thrust::raw_pointer_cast(&x[0]),
+               n == 0 ? (const ValueType *) NULL : thrust::raw_pointer_cast(&y[0]),
+               thrust::raw_pointer_cast(&partials[0]));
+
+    graph_scalar<1>(exec, n, thrust::raw_pointer_cast(&partials[0]), thrust::raw_pointer_cast(&result[0]), f);
+#else
+    throw cusp::not_implemented_exception("device reductions require compilation with nvcc");
+#endif
+}
+
+template <typename DerivedPolicy,
+          typename Array1,
+          typename Array2,
+          typename Array3>
+void __dot_indirect(cuda::execution_policy<DerivedPolicy>& exec,
+                    const Array1& x,
+                    const Array2& y,
+                          Array3& result,
+                    thrust::detail::false_type)
+{
+    result[0] = cusp::system::detail::generic::blas::dot(exec, x, y);
+}
+
+template <typename DerivedPolicy,
+          typename Array1,
+          typename Array2,
+          typename Array3>
+void __dot_indirect(cuda::execution_policy<DerivedPolicy>& exec,
+                    const Array1& x,
+                    const Array2& y,
+                          Array3& result,
+                    thrust::detail::true_type)
+{
+    typedef typename Array3::value_type ValueType;
+
+    __reduce_indirect(exec, x, y, result, store_dot_scalar<ValueType>());
+}
+
+template <typename DerivedPolicy,
+          typename Array1,
+          typename Array2,
+          typename Array3>
+void __dotc_indirect(cuda::execution_policy<DerivedPolicy>& exec,
+                     const Array1& x,
+                     const Array2& y,
+                           Array3& result,
+                     thrust::detail::false_type)
+{
+    result[0] = cusp::system::detail::generic::blas::dotc(exec, x, y);
+}
+
+template <typename DerivedPolicy,
+          typename Array1,
+          typename Array2,
+          typename Array3>
+void __dotc_indirect(cuda::execution_policy<DerivedPolicy>& exec,
+                     const Array1& x,
+                     const Array2& y,
+                           Array3& result,
+                     thrust::detail::true_type)
+{
+    typedef typename Array3::value_type ValueType;
+
+    __reduce_indirect(exec, x, y, result, store_dot_scalar<ValueType>());
+}
+
+template <typename DerivedPolicy,
+          typename Array1,
+          typename Array2>
+void __nrm2_indirect(cuda::execution_policy<DerivedPolicy>& exec,
+                     const Array1& x,
+                           Array2& result,
+                     thrust::detail::false_type)
+{
+    result[0] = cusp::system::detail::generic::blas::nrm2(exec, x);
+}
+
+template <typename DerivedPolicy,
+          typename Array1,
+          typename Array2>
+void __nrm2_indirect(cuda::execution_policy<DerivedPolicy>& exec,
+                     const Array1& x,
+                           Array2& result,
+                     thrust::detail::true_type)
+{
+    typedef typename Array2::value_type ValueType;
+
+    __reduce_indirect(exec, x, x, result, store_nrm2_scalar<ValueType>());
+}
+
+template <typename DerivedPolicy,
+          typename Array1,
+          typename Array2,
+          typename Array3>
+void dot(cuda::execution_policy<DerivedPolicy>& exec,
+         const Array1& x,
+         const Array2& y,
+               Array3& result)
+{
+    typedef typename Array3::value_type ValueType;
+
+    // the dotc kernel conjugates x, which only matches dot for real types
+    __dot_indirect(exec, x, y, result,
+                   typename thrust::detail::integral_constant<bool,
+                     reduce_indirect_supported<Array1,Array2,Array3,ValueType>::value &&
+                     is_real_blas_type<ValueType>::value>::type());
+}
+
+template <typename DerivedPolicy,
+          typename Array1,
+          typename Array2,
+          typename Array3>
+void dotc(cuda::execution_policy<DerivedPolicy>& exec,
+          const Array1& x,
+          const Array2& y,
+                Array3& result)
+{
+    typedef typename Array3::value_type ValueType;
+
+    __dotc_indirect(exec, x, y, result,
+                    typename reduce_indirect_supported<Array1,Array2,Array3,ValueType>::type());
+}
+
+template <typename DerivedPolicy,
+          typename Array1,
+          typename Array2>
+void nrm2(cuda::execution_policy<DerivedPolicy>& exec,
+          const Array1& x,
+                Array2& result)
+{
+    typedef typename Array2::value_type ValueType;
+
+    // complex norms are real, which the single type reduction cannot express
+    __nrm2_indirect(exec, x, result,
+                    typename thrust::detail::integral_constant<bool,
+                      reduce_indirect_supported<Array1,Array1,Array2,ValueType>::value &&
+                      is_real_blas_type<ValueType>::value>::type());
+}
+
+} // end namespace detail
+} // end namespace cuda
+} // end namespace system
+} // end namespace cusp
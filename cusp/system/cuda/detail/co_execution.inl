@@ -0,0 +1,358 @@
+/*
+ *  Copyright 2008-2014 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include <cusp/array1d.h>
+#include <cusp/exception.h>
+#include <cusp/multiply.h>
+
+#include <cusp/detail/timer.h>
+
+#include <thrust/gather.h>
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+namespace cusp
+{
+namespace system
+{
+namespace cuda
+{
+namespace co_execution
+{
+namespace detail
+{
+
+inline void check_error(const cudaError_t error, const char* operation)
+{
+    if (error != cudaSuccess)
+        throw cusp::runtime_exception(std::string("co_execution: ") + operation +
+                                      " failed: " + cudaGetErrorString(error));
+}
+
+inline void check_ratio(const double ratio)
+{
+    if (!(ratio >= 0.0 && ratio <= 1.0))
+        throw cusp::invalid_input_exception("co_execution::csr_matrix: the host ratio must be in [0, 1]");
+}
+
+} // end namespace detail
+
+template <typename IndexType, typename ValueType>
+template <typename MatrixType>
+csr_matrix<IndexType,ValueType>
+::csr_matrix(const MatrixType& A, const double host_ratio, const bool auto_balance)
+    : Parent(A.num_rows, A.num_cols, A.num_entries), matrix(A),
+      split(0), ratio(host_ratio), balance(auto_balance), balance_interval(8),
+      num_samples(0), host_seconds(0), device_seconds(0),
+      compute(0), transfer(0), ready(0), device_start(0), device_done(0), received(0), finished(0)
+{
+    detail::check_ratio(host_ratio);
+
+    try
+    {
+        detail::check_error(cudaStreamCreate(&compute),  "cudaStreamCreate");
+        detail::check_error(cudaStreamCreate(&transfer), "cudaStreamCreate");
+        detail::check_error(cudaEventCreateWithFlags(&ready,    cudaEventDisableTiming), "cudaEventCreate");
+        detail::check_error(cudaEventCreateWithFlags(&received, cudaEventDisableTiming), "cudaEventCreate");
+        detail::check_error(cudaEventCreateWithFlags(&finished, cudaEventDisableTiming), "cudaEventCreate");
+
+        // the device part is timed for balancing
+        detail::check_error(cudaEventCreate(&device_start), "cudaEventCreate");
+        detail::check_error(cudaEventCreate(&device_done),  "cudaEventCreate");
+
+        partition(host_ratio);
+    }
+    catch (...)
+    {
+        release();
+        throw;
+    }
+}
+
+template <typename IndexType, typename ValueType>
+csr_matrix<IndexType,ValueType>
+::~csr_matrix(void)
+{
+    release();
+}
+
+template <typename IndexType, typename ValueType>
+void
+csr_matrix<IndexType,ValueType>
+::release(void)
+{
+    if (compute)      { cudaStreamSynchronize(compute);  cudaStreamDestroy(compute); }
+    if (transfer)     { cudaStreamSynchronize(transfer); cudaStreamDestroy(transfer); }
+    if (ready)        cudaEventDestroy(ready);
+    if (device_start) cudaEventDestroy(device_start);
+    if (device_done)  cudaEventDestroy(device_done);
+    if (received)     cudaEventDestroy(received);
+    if (finished)     cudaEventDestroy(finished);
+
+    compute = transfer = 0;
+    ready = device_start = device_done = received = finished = 0;
+}
+
+template <typename IndexType, typename ValueType>
+double
+csr_matrix<IndexType,ValueType>
+::host_ratio(void) const
+{
+    return ratio;
+}
+
+template <typename IndexType, typename ValueType>
+size_t
+csr_matrix<IndexType,ValueType>
+::num_host_rows(void) const
+{
+    return matrix.num_rows - split;
+}
+
+template <typename IndexType, typename ValueType>
+void
+csr_matrix<IndexType,ValueType>
+::set_host_ratio(const double host_ratio)
+{
+    detail::check_ratio(host_ratio);
+
+    partition(host_ratio);
+}
+
+template <typename IndexType, typename ValueType>
+void
+csr_matrix<IndexType,ValueType>
+::set_auto_balance(const bool enable, const size_t interval)
+{
+    balance          = enable;
+    balance_interval = std::max<size_t>(interval, 1);
+    num_samples      = 0;
+    host_seconds     = 0;
+    device_seconds   = 0;
+}
+
+template <typename IndexType, typename ValueType>
+const typename csr_matrix<IndexType,ValueType>::device_matrix_type&
+csr_matrix<IndexType,ValueType>
+::device_part(void) const
+{
+    return device_rows;
+}
+
+template <typename IndexType, typename ValueType>
+const typename csr_matrix<IndexType,ValueType>::host_matrix_type&
+csr_matrix<IndexType,ValueType>
+::host_part(void) const
+{
+    return host_rows;
+}
+
+// rows [0, split) go to the device and rows [split, num_rows) to the host,
+// split is the first row at which the trailing rows hold at most the
+// fraction host_ratio of the entries
+template <typename IndexType, typename ValueType>
+void
+csr_matrix<IndexType,ValueType>
+::partition(const double host_ratio) const
+{
+    const size_t num_rows    = matrix.num_rows;
+    const size_t num_entries = matrix.num_entries;
+
+    // pending products may still read the previous parts
+    detail::check_error(cudaStreamSynchronize(compute),  "cudaStreamSynchronize");
+    detail::check_error(cudaStreamSynchronize(transfer), "cudaStreamSynchronize");
+
+    const IndexType device_entries = IndexType(num_entries - size_t(host_ratio * num_entries + 0.5));
+
+    split = std::lower_bound(matrix.row_offsets.begin(), matrix.row_offsets.end() - 1, device_entries) - matrix.row_offsets.begin();
+
+    if (host_ratio == 0.0)
+        split = num_rows;
+
+    ratio = host_ratio;
+
+    const IndexType split_entry = matrix.row_offsets[split];
+
+    // leading rows, all columns
+    {
+        host_matrix_type D(split, matrix.num_cols, split_entry);
+
+        std::copy(matrix.row_offsets.begin(), matrix.row_offsets.begin() + split + 1, D.row_offsets.begin());
+        std::copy(matrix.column_indices.begin(), matrix.column_indices.begin() + split_entry, D.column_indices.begin());
+        std::copy(matrix.values.begin(), matrix.values.begin() + split_entry, D.values.begin());
+
+        device_rows = D;
+    }
+
+    // trailing rows, columns compressed to those they reference
+    {
+        const size_t host_row_count   = num_rows - split;
+        const size_t host_entry_count = num_entries - split_entry;
+
+        std::vector<IndexType> columns(matrix.column_indices.begin() + split_entry, matrix.column_indices.end());
+        std::sort(columns.begin(), columns.end());
+        columns.erase(std::unique(columns.begin(), columns.end()), columns.end());
+
+        host_rows.resize(host_row_count, columns.size(), host_entry_count);
+
+        for (size_t i = 0; i <= host_row_count; i++)
+            host_rows.row_offsets[i] = matrix.row_offsets[split + i] - split_entry;
+
+        for (size_t n = 0; n < host_entry_count; n++)
+        {
+            const IndexType j = matrix.column_indices[split_entry + n];
+
+            host_rows.column_indices[n] = std::lower_bound(columns.begin(), columns.end(), j) - columns.begin();
+            host_rows.values[n]         = matrix.values[split_entry + n];
+        }
+
+        cusp::array1d<IndexType,cusp::host_memory> h_columns(columns.begin(), columns.end());
+        host_columns = h_columns;
+
+        send_buffer.resize(columns.size());
+        host_x.resize(columns.size());
+        host_y.resize(host_row_count);
+    }
+
+    num_samples    = 0;
+    host_seconds   = 0;
+    device_seconds = 0;
+}
+
+// each side processes entries at its measured rate, the new fraction
+// gives both sides the same time
+template <typename IndexType, typename ValueType>
+void
+csr_matrix<IndexType,ValueType>
+::rebalance(void) const
+{
+    const double host_entries   = double(host_rows.num_entries);
+    const double device_entries = double(device_rows.num_entries);
+
+    if (host_entries == 0 || device_entries == 0 || host_seconds <= 0 || device_seconds <= 0)
+        return;
+
+    const double host_rate   = host_entries / host_seconds;
+    const double device_rate = device_entries / device_seconds;
+
+    const double new_ratio = host_rate / (host_rate + device_rate);
+
+    const IndexType device_target = IndexType(matrix.num_entries - size_t(new_ratio * matrix.num_entries + 0.5));
+    const size_t new_split =
+        std::lower_bound(matrix.row_offsets.begin(), matrix.row_offsets.end() - 1, device_target) - matrix.row_offsets.begin();
+
+    const size_t moved = new_split > split ? new_split - split : split - new_split;
+
+    num_samples    = 0;
+    host_seconds   = 0;
+    device_seconds = 0;
+
+    // repartitioning costs more than a product, small changes are ignored
+    if (100 * moved > matrix.num_rows)
+        partition(new_ratio);
+}
+
+template <typename IndexType, typename ValueType>
+template <typename ArrayType1, typename ArrayType2>
+void
+csr_matrix<IndexType,ValueType>
+::operator()(const ArrayType1& x, ArrayType2& y) const
+{
+    typedef cusp::system::cuda::detail::execute_on_stream Policy;
+
+    if (x.size() != matrix.num_cols || y.size() != matrix.num_rows)
+        throw cusp::invalid_input_exception("co_execution::csr_matrix: vector sizes do not match the matrix");
+
+    const size_t num_rows       = matrix.num_rows;
+    const size_t host_row_count = num_rows - split;
+
+    // x is produced by the work issued to the default stream
+    detail::check_error(cudaEventRecord(ready, 0), "cudaEventRecord");
+    cudaStreamWaitEvent(compute,  ready, 0);
+    cudaStreamWaitEvent(transfer, ready, 0);
+
+    // the entries of x referenced by the host rows
+    if (host_row_count > 0 && host_columns.size() > 0)
+    {
+        Policy exec(transfer);
+
+        thrust::gather(exec, host_columns.begin(), host_columns.end(), x.begin(), send_buffer.begin());
+
+        detail::check_error(cudaMemcpyAsync(thrust::raw_pointer_cast(&host_x[0]),
+                                            thrust::raw_pointer_cast(&send_buffer[0]),
+                                            host_x.size() * sizeof(ValueType),
+                                            cudaMemcpyDeviceToHost, transfer),
+                            "cudaMemcpyAsync");
+    }
+
+    detail::check_error(cudaEventRecord(received, transfer), "cudaEventRecord");
+
+    // the device rows overlap the transfer and the host rows
+    detail::check_error(cudaEventRecord(device_start, compute), "cudaEventRecord");
+
+    if (split > 0)
+    {
+        Policy exec(compute);
+
+        cusp::array1d_view<typename ArrayType2::iterator> y_device(y.begin(), y.begin() + split);
+
+        cusp::multiply(exec, device_rows, x, y_device);
+    }
+
+    detail::check_error(cudaEventRecord(device_done, compute), "cudaEventRecord");
+
+    if (host_row_count > 0)
+    {
+        // the previous product may still be copying host_y
+        detail::check_error(cudaEventSynchronize(finished), "cudaEventSynchronize");
+        detail::check_error(cudaEventSynchronize(received), "cudaEventSynchronize");
+
+        const double start = cusp::detail::wall_clock_seconds();
+
+        cusp::multiply(host_rows, host_x, host_y);
+
+        host_seconds += cusp::detail::wall_clock_seconds() - start;
+
+        detail::check_error(cudaMemcpyAsync(thrust::raw_pointer_cast(&y[0]) + split,
+                                            thrust::raw_pointer_cast(&host_y[0]),
+                                            host_row_count * sizeof(ValueType),
+                                            cudaMemcpyHostToDevice, compute),
+                            "cudaMemcpyAsync");
+    }
+
+    // later work on the default stream reads y
+    detail::check_error(cudaEventRecord(finished, compute), "cudaEventRecord");
+    cudaStreamWaitEvent(0, finished, 0);
+
+    if (!balance)
+        return;
+
+    float milliseconds = 0;
+    detail::check_error(cudaEventSynchronize(device_done), "cudaEventSynchronize");
+    detail::check_error(cudaEventElapsedTime(&milliseconds, device_start, device_done), "cudaEventElapsedTime");
+
+    device_seconds += 1e-3 * milliseconds;
+
+    if (++num_samples >= balance_interval)
+        rebalance();
+}
+
+} // end namespace co_execution
+} // end namespace cuda
+} // end namespace system
+} // end namespace cusp
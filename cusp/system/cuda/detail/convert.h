@@ -18,9 +18,26 @@
 
 #include <cusp/detail/config.h>
 
+#include <cusp/detail/format.h>
+#include <cusp/detail/temporary_array.h>
+#include <cusp/detail/type_traits.h>
+
 #include <cusp/system/cuda/detail/execution_policy.h>
 
 #include <cusp/copy.h>
+#include <cusp/exception.h>
+#include <cusp/format_utils.h>
+#include <cusp/functional.h>
+
+#include <thrust/count.h>
+#include <thrust/for_each.h>
+#include <thrust/scan.h>
+#include <thrust/iterator/counting_iterator.h>
+#include <thrust/iterator/transform_iterator.h>
+
+#include <algorithm>
+#include <cassert>
+#include <string>
 
 namespace cusp
 {
@@ -48,6 +65,309 @@ void convert(thrust::system::cuda::detail::cross_system<System1,System2>& exec,
     cusp::copy(tmp, dst);
 }
 
+//////////////////////////////////////////////////////////////////////////////
+// CSR to ELL and HYB
+//////////////////////////////////////////////////////////////////////////////
+//
+// A thread per row writes the ELL part of its row, including the padding,
+// and moves the entries past the ELL width to the COO part, so the output
+// is written in one pass instead of through expanded row indices and
+// scatters.
+//
+// For HYB the ELL width is chosen on the device as well.  The row lengths
+// are counted into a histogram, a single thread finds the width with the
+// speed threshold of compute_optimal_entries_per_row, and the number of
+// overflow entries of every row is scanned into the COO positions.  The
+// width and the COO size are the only values read back to the host, they
+// are needed to allocate the output.  Rows longer than
+// relative_speed * num_entries / num_rows + 1 share the last bin of the
+// histogram, since fewer than num_rows / relative_speed rows can be that
+// long the width never exceeds this bound.
+
+#if defined(__CUDACC__)
+template <typename OffsetType>
+struct hyb_histogram_functor
+{
+    const OffsetType * row_offsets;
+    unsigned int * histogram;
+    size_t last_bin;
+
+    hyb_histogram_functor(const OffsetType * row_offsets, unsigned int * histogram, const size_t last_bin)
+        : row_offsets(row_offsets), histogram(histogram), last_bin(last_bin) {}
+
+    __device__
+    void operator()(const size_t row) const
+    {
+        const size_t row_length = row_offsets[row + 1] - row_offsets[row];
+
+        atomicAdd(histogram + (row_length < last_bin ? row_length : last_bin), 1u);
+    }
+};
+
+struct hyb_width_functor
+{
+    const unsigned int * histogram;
+    size_t last_bin;
+    cusp::detail::speed_threshold_functor threshold;
+    size_t * width;
+
+    hyb_width_functor(const unsigned int * histogram, const size_t last_bin,
+                      const cusp::detail::speed_threshold_functor& threshold, size_t * width)
+        : histogram(histogram), last_bin(last_bin), threshold(threshold), width(width) {}
+
+    __device__
+    void operator()(const size_t) const
+    {
+        size_t num_short_rows = 0;
+        size_t k = 0;
+
+        // number of rows with at most k entries
+        for(; k < last_bin; k++)
+        {
+            num_short_rows += histogram[k];
+
+            if(threshold(num_short_rows))
+                break;
+        }
+
+        *width = k;
+    }
+};
+
+template <typename OffsetType>
+struct hyb_overflow_functor
+{
+    const OffsetType * row_offsets;
+    const size_t * width;
+
+    hyb_overflow_functor(const OffsetType * row_offsets, const size_t * width)
+        : row_offsets(row_offsets), width(width) {}
+
+    __device__
+    size_t operator()(const size_t row) const
+    {
+        const size_t row_length = row_offsets[row + 1] - row_offsets[row];
+
+        return row_length > *width ? row_length - *width : 0;
+    }
+};
+
+template <typename OffsetType, typename IndexType, typename ValueType>
+struct hyb_fill_functor
+{
+    const OffsetType * row_offsets;
+    const IndexType  * column_indices;
+    const ValueType  * values;
+    size_t width;
+    size_t pitch;
+    IndexType * ell_column_indices;
+    ValueType * ell_values;
+    const size_t * coo_offsets;
+    IndexType * coo_row_indices;
+    IndexType * coo_column_indices;
+    ValueType * coo_values;
+
+    hyb_fill_functor(const OffsetType * row_offsets, const IndexType * column_indices, const ValueType * values,
+                     const size_t width, const size_t pitch,
+                     IndexType * ell_column_indices, ValueType * ell_values,
+                     const size_t * coo_offsets,
+                     IndexType * coo_row_indices, IndexType * coo_column_indices, ValueType * coo_values)
+        : row_offsets(row_offsets), column_indices(column_indices), values(values),
+          width(width), pitch(pitch),
+          ell_column_indices(ell_column_indices), ell_values(ell_values),
+          coo_offsets(coo_offsets),
+          coo_row_indices(coo_row_indices), coo_column_indices(coo_column_indices), coo_values(coo_values) {}
+
+    __device__
+    void operator()(const size_t row) const
+    {
+        const size_t row_start = row_offsets[row];
+        const size_t row_end   = row_offsets[row + 1];
+        const size_t ell_end   = row_end < row_start + width ? row_end : row_start + width;
+
+        size_t offset = row;
+        size_t jj     = row_start;
+
+        for(; jj < ell_end; jj++, offset += pitch)
+        {
+            ell_column_indices[offset] = column_indices[jj];
+            ell_values[offset]         = values[jj];
+        }
+
+        for(size_t n = ell_end - row_start; n < width; n++, offset += pitch)
+        {
+            ell_column_indices[offset] = IndexType(-1);
+            ell_values[offset]         = ValueType(0);
+        }
+
+        for(size_t k = coo_offsets[row]; jj < row_end; jj++, k++)
+        {
+            coo_row_indices[k]    = IndexType(row);
+            coo_column_indices[k] = column_indices[jj];
+            coo_values[k]         = values[jj];
+        }
+    }
+};
+#endif
+
+template <typename DerivedPolicy, typename SourceType, typename DestinationType>
+void
+convert(cuda::execution_policy<DerivedPolicy>& exec,
+        const SourceType& src,
+        DestinationType& dst,
+        cusp::csr_format&,
+        cusp::ell_format&,
+        size_t num_entries_per_row = 0,
+        size_t alignment = 32)
+{
+    typedef typename DestinationType::index_type                     IndexType;
+    typedef typename DestinationType::value_type                     ValueType;
+    typedef typename cusp::detail::get_offset_type<SourceType>::type OffsetType;
+
+    if(src.num_entries == 0)
+    {
+        dst.resize(src.num_rows, src.num_cols, src.num_entries, num_entries_per_row);
+        return;
+    }
+
+    if(num_entries_per_row == 0)
+    {
+        const size_t max_entries_per_row = cusp::compute_max_entries_per_row(exec, src.row_offsets);
+
+        const float max_fill  = 3.0;
+        const float threshold  = 1e6; // 1M entries
+        const float size       = float(max_entries_per_row) * float(src.num_rows);
+        const float fill_ratio = size / std::max(1.0f, float(src.num_entries));
+
+        if (max_fill < fill_ratio && size > threshold)
+            throw cusp::format_conversion_exception("ell_matrix fill-in would exceed maximum tolerance");
+
+        num_entries_per_row = max_entries_per_row;
+    }
+
+    size_t num_entries = src.num_entries - thrust::count(exec, src.values.begin(), src.values.end(), ValueType(0));
+
+    dst.resize(src.num_rows, src.num_cols, num_entries, num_entries_per_row, alignment);
+
+    assert(dst.column_indices.pitch == dst.values.pitch);
+
+    // no entry overflows the width, the COO positions are never read
+    thrust::for_each(exec,
+                     thrust::counting_iterator<size_t>(0),
+                     thrust::counting_iterator<size_t>(src.num_rows),
+                     hyb_fill_functor<OffsetType,IndexType,ValueType>(
+                         thrust::raw_pointer_cast(&src.row_offsets[0]),
+                         thrust::raw_pointer_cast(&src.column_indices[0]),
+                         thrust::raw_pointer_cast(&src.values[0]),
+                         num_entries_per_row, dst.column_indices.pitch,
+                         thrust::raw_pointer_cast(&dst.column_indices.values[0]),
+                         thrust::raw_pointer_cast(&dst.values.values[0]),
+                         NULL, NULL, NULL, NULL));
+}
+
+template <typename DerivedPolicy, typename SourceType, typename DestinationType>
+void
+convert(cuda::execution_policy<DerivedPolicy>& exec,
+        const SourceType& src,
+        DestinationType& dst,
+        cusp::csr_format&,
+        cusp::hyb_format&,
+        size_t num_entries_per_row = 0,
+        size_t alignment = 32)
+{
+    typedef typename DestinationType::index_type                     IndexType;
+    typedef typename DestinationType::value_type                     ValueType;
+    typedef typename cusp::detail::get_offset_type<SourceType>::type OffsetType;
+
+    const size_t num_rows = src.num_rows;
+
+    if(src.num_entries == 0)
+    {
+        dst.resize(src.num_rows, src.num_cols, 0, 0, num_entries_per_row);
+        return;
+    }
+
+    const OffsetType * row_offsets = thrust::raw_pointer_cast(&src.row_offsets[0]);
+
+    // COO offsets of the rows followed by the ELL width
+    cusp::detail::temporary_array<size_t, DerivedPolicy> offsets(exec, num_rows + 2, size_t(0));
+
+    size_t * coo_offsets = thrust::raw_pointer_cast(&offsets[0]);
+    size_t * width       = coo_offsets + num_rows + 1;
+
+    if(num_entries_per_row == 0)
+    {
+        const float  relative_speed      = 3.0;
+        const size_t breakeven_threshold = 4096;
+
+        const size_t last_bin = size_t(relative_speed * float(src.num_entries) / float(num_rows)) + 1;
+
+        cusp::detail::temporary_array<unsigned int, DerivedPolicy> histogram(exec, last_bin + 1, 0u);
+
+        thrust::for_each(exec,
+                         thrust::counting_iterator<size_t>(0),
+                         thrust::counting_iterator<size_t>(num_rows),
+                         hyb_histogram_functor<OffsetType>(row_offsets,
+                                                           thrust::raw_pointer_cast(&histogram[0]),
+                                                           last_bin));
+
+        thrust::for_each(exec,
+                         thrust::counting_iterator<size_t>(0),
+                         thrust::counting_iterator<size_t>(1),
+                         hyb_width_functor(thrust::raw_pointer_cast(&histogram[0]), last_bin,
+                                           cusp::detail::speed_threshold_functor(num_rows, relative_speed, breakeven_threshold),
+                                           width));
+    }
+    else
+    {
+        offsets[num_rows + 1] = num_entries_per_row;
+    }
+
+    thrust::inclusive_scan(exec,
+                           thrust::make_transform_iterator(thrust::counting_iterator<size_t>(0),
+                                                           hyb_overflow_functor<OffsetType>(row_offsets, width)),
+                           thrust::make_transform_iterator(thrust::counting_iterator<size_t>(num_rows),
+                                                           hyb_overflow_functor<OffsetType>(row_offsets, width)),
+                           offsets.begin() + 1);
+
+    // the number of COO entries and the width size the output
+    size_t sizes[2];
+
+    cudaStream_t s = stream(thrust::detail::derived_cast(exec));
+
+    cudaError_t error = cudaMemcpyAsync(sizes, coo_offsets + num_rows, sizeof(sizes), cudaMemcpyDeviceToHost, s);
+
+    if(error == cudaSuccess)
+        error = cudaStreamSynchronize(s);
+
+    if(error != cudaSuccess)
+        throw cusp::runtime_exception(std::string("csr to hyb conversion failed: ") + cudaGetErrorString(error));
+
+    const size_t num_coo_entries = sizes[0];
+    const size_t num_ell_entries = src.num_entries - num_coo_entries;
+
+    num_entries_per_row = sizes[1];
+
+    dst.resize(src.num_rows, src.num_cols, num_ell_entries, num_coo_entries, num_entries_per_row, alignment);
+
+    assert(dst.ell.column_indices.pitch == dst.ell.values.pitch);
+
+    thrust::for_each(exec,
+                     thrust::counting_iterator<size_t>(0),
+                     thrust::counting_iterator<size_t>(num_rows),
+                     hyb_fill_functor<OffsetType,IndexType,ValueType>(
+                         row_offsets,
+                         thrust::raw_pointer_cast(&src.column_indices[0]),
+                         thrust::raw_pointer_cast(&src.values[0]),
+                         num_entries_per_row, dst.ell.column_indices.pitch,
+                         num_entries_per_row == 0 ? NULL : thrust::raw_pointer_cast(&dst.ell.column_indices.values[0]),
+                         num_entries_per_row == 0 ? NULL : thrust::raw_pointer_cast(&dst.ell.values.values[0]),
+                         coo_offsets,
+                         num_coo_entries == 0 ? NULL : thrust::raw_pointer_cast(&dst.coo.row_indices[0]),
+                         num_coo_entries == 0 ? NULL : thrust::raw_pointer_cast(&dst.coo.column_indices[0]),
+                         num_coo_entries == 0 ? NULL : thrust::raw_pointer_cast(&dst.coo.values[0])));
+}
+
 } // end namespace detail
 } // end namespace cuda
 } // end namespace system
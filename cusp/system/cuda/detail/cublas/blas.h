@@ -48,7 +48,7 @@ int amax(cublas::execute_with_cublas_base<DerivedPolicy>& exec,
 
     int result;
 
-    cublasStatus_t stat = cublas::amax<0>(handle(exec), n, x_p, 1, result);
+    cublasStatus_t stat = cublas::amax<0>(bound_handle(exec), n, x_p, 1, result);
     if(stat != CUBLAS_STATUS_SUCCESS)
     {
         throw cublas_exception("amax", stat);
@@ -72,7 +72,7 @@ asum(cublas::execute_with_cublas_base<DerivedPolicy>& exec,
 
     Real result;
 
-    cublasStatus_t stat = cublas::asum<0>(handle(exec), n, x_p, 1, result);
+    cublasStatus_t stat = cublas::asum<0>(bound_handle(exec), n, x_p, 1, result);
     if(stat != CUBLAS_STATUS_SUCCESS)
     {
         throw cublas_exception("asum", stat);
@@ -97,7 +97,7 @@ void axpy(cublas::execute_with_cublas_base<DerivedPolicy>& exec,
     const ValueType* x_p = thrust::raw_pointer_cast(&x[0]);
           ValueType* y_p = thrust::raw_pointer_cast(&y[0]);
 
-    cublasStatus_t stat = cublas::axpy<0>(handle(exec), n, ValueType(alpha), x_p, 1, y_p, 1);
+    cublasStatus_t stat = cublas::axpy<0>(bound_handle(exec), n, ValueType(alpha), x_p, 1, y_p, 1);
     if(stat != CUBLAS_STATUS_SUCCESS)
     {
         throw cublas_exception("axpy", stat);
@@ -118,7 +118,7 @@ void copy(cublas::execute_with_cublas_base<DerivedPolicy>& exec,
     const ValueType* x_p = thrust::raw_pointer_cast(&x[0]);
           ValueType* y_p = thrust::raw_pointer_cast(&y[0]);
 
-    cublasStatus_t stat = cublas::copy<0>(handle(exec), n, x_p, 1, y_p, 1);
+    cublasStatus_t stat = cublas::copy<0>(bound_handle(exec), n, x_p, 1, y_p, 1);
     if(stat != CUBLAS_STATUS_SUCCESS)
     {
         throw cublas_exception("copy", stat);
@@ -142,7 +142,7 @@ dot(cublas::execute_with_cublas_base<DerivedPolicy>& exec,
 
     ValueType result;
 
-    cublasStatus_t stat = cublas::dot<0>(handle(exec), n, x_p, 1, y_p, 1, result);
+    cublasStatus_t stat = cublas::dot<0>(bound_handle(exec), n, x_p, 1, y_p, 1, result);
     if(stat != CUBLAS_STATUS_SUCCESS)
     {
         throw cublas_exception("dot", stat);
@@ -168,7 +168,7 @@ dotc(cublas::execute_with_cublas_base<DerivedPolicy>& exec,
 
     ValueType result;
 
-    cublasStatus_t stat = cublas::dotc<0>(handle(exec), n, x_p, 1, y_p, 1, &result);
+    cublasStatus_t stat = cublas::dotc<0>(bound_handle(exec), n, x_p, 1, y_p, 1, &result);
     if(stat != CUBLAS_STATUS_SUCCESS)
     {
         throw cublas_exception("dotc", stat);
@@ -192,7 +192,7 @@ nrm2(cublas::execute_with_cublas_base<DerivedPolicy>& exec,
 
     ResultType result;
 
-    cublasStatus_t stat = cublas::nrm2<0>(handle(exec), n, x_p, 1, result);
+    cublasStatus_t stat = cublas::nrm2<0>(bound_handle(exec), n, x_p, 1, result);
     if(stat != CUBLAS_STATUS_SUCCESS)
     {
         throw cublas_exception("nrm2", stat);
@@ -214,7 +214,7 @@ void scal(cublas::execute_with_cublas_base<DerivedPolicy>& exec,
 
     ValueType* x_p = thrust::raw_pointer_cast(&x[0]);
 
-    cublasStatus_t stat = cublas::scal<0>(handle(exec), n, alpha, x_p, 1);
+    cublasStatus_t stat = cublas::scal<0>(bound_handle(exec), n, alpha, x_p, 1);
     if(stat != CUBLAS_STATUS_SUCCESS)
     {
         throw cublas_exception("scal", stat);
@@ -235,7 +235,7 @@ void swap(cublas::execute_with_cublas_base<DerivedPolicy>& exec,
     ValueType* x_p = thrust::raw_pointer_cast(&x[0]);
     ValueType* y_p = thrust::raw_pointer_cast(&y[0]);
 
-    cublasStatus_t stat = cublas::swap<0>(handle(exec), n, x_p, 1, y_p, 1);
+    cublasStatus_t stat = cublas::swap<0>(bound_handle(exec), n, x_p, 1, y_p, 1);
     if(stat != CUBLAS_STATUS_SUCCESS)
     {
         throw cublas_exception("swap", stat);
@@ -272,7 +272,7 @@ void gemv(cublas::execute_with_cublas_base<DerivedPolicy>& exec,
           ValueType *y_p = thrust::raw_pointer_cast(&y[0]);
 
     cublasStatus_t stat =
-        cublas::gemv<0>(handle(exec), trans, m, n, alpha0,
+        cublas::gemv<0>(bound_handle(exec), trans, m, n, alpha0,
                         A_p, lda, x_p, 1, beta0, y_p, 1);
 
     if(stat != CUBLAS_STATUS_SUCCESS)
@@ -305,7 +305,7 @@ void ger(cublas::execute_with_cublas_base<DerivedPolicy>& exec,
           ValueType *A_p = thrust::raw_pointer_cast(&A(0,0));
 
     cublasStatus_t stat =
-        cublas::ger<0>(handle(exec), m, n, alpha0,
+        cublas::ger<0>(bound_handle(exec), m, n, alpha0,
                        x_p, 1, y_p, 1, A_p, lda);
 
     if(stat != CUBLAS_STATUS_SUCCESS)
@@ -342,7 +342,7 @@ void symv(cublas::execute_with_cublas_base<DerivedPolicy>& exec,
           ValueType *y_p = thrust::raw_pointer_cast(&y[0]);
 
     cublasStatus_t stat =
-        cublas::symv<0>(handle(exec), uplo, n, alpha0,
+        cublas::symv<0>(bound_handle(exec), uplo, n, alpha0,
                         A_p, lda, x_p, 1, beta0, y_p, 1);
 
     if(stat != CUBLAS_STATUS_SUCCESS)
@@ -373,7 +373,7 @@ void syr(cublas::execute_with_cublas_base<DerivedPolicy>& exec,
           ValueType *A_p = thrust::raw_pointer_cast(&A(0,0));
 
     cublasStatus_t stat =
-        cublas::syr<0>(handle(exec), uplo, n, alpha0,
+        cublas::syr<0>(bound_handle(exec), uplo, n, alpha0,
                        x_p, 1, A_p, lda);
 
     if(stat != CUBLAS_STATUS_SUCCESS)
@@ -403,7 +403,7 @@ void trmv(cublas::execute_with_cublas_base<DerivedPolicy>& exec,
           ValueType *x_p = thrust::raw_pointer_cast(&x[0]);
 
     cublasStatus_t stat =
-        cublas::trmv<0>(handle(exec), uplo, trans, diag, n,
+        cublas::trmv<0>(bound_handle(exec), uplo, trans, diag, n,
                         A_p, lda, x_p, 1);
 
     if(stat != CUBLAS_STATUS_SUCCESS)
@@ -433,7 +433,7 @@ void trsv(cublas::execute_with_cublas_base<DerivedPolicy>& exec,
           ValueType *x_p = thrust::raw_pointer_cast(&x[0]);
 
     cublasStatus_t stat =
-        cublas::trsv<0>(handle(exec), uplo, trans, diag, n,
+        cublas::trsv<0>(bound_handle(exec), uplo, trans, diag, n,
                         A_p, lda, x_p, 1);
 
     if(stat != CUBLAS_STATUS_SUCCESS)
@@ -498,7 +498,7 @@ void gemm(cublas::execute_with_cublas_base<DerivedPolicy>& exec,
     ValueType beta0  = ValueType(beta);
 
     cublasStatus_t stat =
-        cublas::gemm<0>(handle(exec), transa, transb,
+        cublas::gemm<0>(bound_handle(exec), transa, transb,
                         m, n, k, alpha0, A_p, lda,
                         B_p, ldb, beta0, C_p, ldc);
 
@@ -540,7 +540,7 @@ void symm(cublas::execute_with_cublas_base<DerivedPolicy>& exec,
           ValueType * C_p = thrust::raw_pointer_cast(&C(0,0));
 
     cublasStatus_t stat =
-        cublas::symm<0>(handle(exec), side, uplo,
+        cublas::symm<0>(bound_handle(exec), side, uplo,
                         m, n, alpha0, A_p, lda,
                         B_p, ldb, beta0, C_p, ldc);
 
@@ -579,7 +579,7 @@ void syrk(cublas::execute_with_cublas_base<DerivedPolicy>& exec,
           ValueType * B_p = thrust::raw_pointer_cast(&B(0,0));
 
     cublasStatus_t stat =
-        cublas::syrk<0>(handle(exec), uplo, trans,
+        cublas::syrk<0>(bound_handle(exec), uplo, trans,
                         n, k, alpha0, A_p, lda,
                         beta0, B_p, ldb);
 
@@ -622,7 +622,7 @@ void syr2k(cublas::execute_with_cublas_base<DerivedPolicy>& exec,
           ValueType * C_p = thrust::raw_pointer_cast(&C(0,0));
 
     cublasStatus_t stat =
-        cublas::syr2k<0>(handle(exec), uplo, trans,
+        cublas::syr2k<0>(bound_handle(exec), uplo, trans,
                          n, k, alpha0, A_p, lda,
                          B_p, ldb, beta0, C_p, ldc);
 
@@ -662,7 +662,7 @@ void trmm(cublas::execute_with_cublas_base<DerivedPolicy>& exec,
           ValueType * C_p = thrust::raw_pointer_cast(&B(0,0));
 
     cublasStatus_t stat =
-        cublas::trmm<0>(handle(exec), side, uplo, trans, diag,
+        cublas::trmm<0>(bound_handle(exec), side, uplo, trans, diag,
                         m, n, alpha0, A_p, lda,
                         B_p, ldb, C_p, ldc);
 
@@ -700,7 +700,7 @@ void trsm(cublas::execute_with_cublas_base<DerivedPolicy>& exec,
           ValueType * B_p = thrust::raw_pointer_cast(&B(0,0));
 
     cublasStatus_t stat =
-        cublas::trsm<0>(handle(exec), side, uplo, trans, diag,
+        cublas::trsm<0>(bound_handle(exec), side, uplo, trans, diag,
                         n, k, alpha0, A_p, lda, B_p, ldb);
 
     if(stat != CUBLAS_STATUS_SUCCESS)
@@ -724,7 +724,7 @@ nrm1(cublas::execute_with_cublas_base<DerivedPolicy>& exec,
 
     ResultType result;
 
-    cublasStatus_t stat = cublas::asum(handle(exec), n, x_p, 1, result);
+    cublasStatus_t stat = cublas::asum(bound_handle(exec), n, x_p, 1, result);
     if(stat != CUBLAS_STATUS_SUCCESS)
     {
         throw cublas_exception("nrm1", stat);
@@ -747,7 +747,7 @@ nrmmax(cublas::execute_with_cublas_base<DerivedPolicy>& exec,
 
     const ValueType* x_p = thrust::raw_pointer_cast(&x[0]);
 
-    cublasStatus_t stat = cublas::amax(handle(exec), n, x_p, 1, index);
+    cublasStatus_t stat = cublas::amax(bound_handle(exec), n, x_p, 1, index);
     if(stat != CUBLAS_STATUS_SUCCESS)
     {
         throw cublas_exception("nrmmax", stat);
@@ -762,3 +762,6 @@ nrmmax(cublas::execute_with_cublas_base<DerivedPolicy>& exec,
 } // end namespace system
 } // end namespace cusp
 
+
+// routes the plain CUDA policies to the pooled handles
+#include <cusp/system/cuda/detail/cublas/pooled_blas.h>
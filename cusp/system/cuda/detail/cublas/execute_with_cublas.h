@@ -39,10 +39,12 @@ class execute_with_cublas_base
 {
   public:
 
-    execute_with_cublas_base(void) {}
+    execute_with_cublas_base(void)
+      : m_stream(0), m_has_stream(false)
+    {}
 
     execute_with_cublas_base(const cublasHandle_t& handle)
-      : m_handle(handle)
+      : m_handle(handle), m_stream(0), m_has_stream(false)
     {}
 
     __host__ __device__
@@ -58,6 +60,17 @@ class execute_with_cublas_base
       return result;
     }
 
+    __host__ __device__
+    DerivedPolicy on(const cudaStream_t& s) const
+    {
+      DerivedPolicy result = thrust::detail::derived_cast(*this);
+
+      // bind s to the result, the handle is moved onto s at each call
+      result.set_stream(s);
+
+      return result;
+    }
+
   private:
 
     __host__ __device__
@@ -66,13 +79,44 @@ class execute_with_cublas_base
       return exec.m_handle;
     }
 
+    // the handle moved onto the policy's stream; a handle passed without
+    // a stream keeps whatever stream the caller set on it
+    friend inline cublasHandle_t const& bound_handle(const execute_with_cublas_base &exec)
+    {
+      if (exec.m_has_stream)
+        cublasSetStream(exec.m_handle, exec.m_stream);
+
+      return exec.m_handle;
+    }
+
+    __host__ __device__
+    friend inline cudaStream_t stream(const execute_with_cublas_base &exec)
+    {
+      return exec.m_stream;
+    }
+
+    __host__ __device__
+    friend inline cudaStream_t get_stream(const execute_with_cublas_base &exec)
+    {
+      return exec.m_stream;
+    }
+
     __host__ __device__
     inline void set_handle(const cublasHandle_t &h)
     {
       m_handle = h;
     }
 
+    __host__ __device__
+    inline void set_stream(const cudaStream_t &s)
+    {
+      m_stream = s;
+      m_has_stream = true;
+    }
+
     cublasHandle_t m_handle;
+    cudaStream_t   m_stream;
+    bool           m_has_stream;
 };
 
 class execute_with_cublas
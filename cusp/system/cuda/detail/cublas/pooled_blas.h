@@ -0,0 +1,480 @@
+/*
+ *  Copyright 2008-2014 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#pragma once
+
+#include <cusp/complex.h>
+#include <cusp/verify.h>
+
+#include <cusp/system/cuda/cublas_handles.h>
+#include <cusp/system/cuda/detail/execution_policy.h>
+#include <cusp/system/cuda/detail/cublas/execute_with_cublas.h>
+
+#include <thrust/detail/type_traits.h>
+#include <thrust/iterator/detail/is_trivial_iterator.h>
+
+namespace cusp
+{
+namespace system
+{
+namespace cuda
+{
+namespace detail
+{
+
+//////////////////////////////////////////////////////////////////////////////
+// cuBLAS with the plain CUDA execution policies
+//////////////////////////////////////////////////////////////////////////////
+//
+// Calls without a handle, e.g. cusp::blas::gemm on device arrays or with
+// cusp::cuda::par.on(s), run on the pooled handle of the current device and
+// the policy's stream. Arrays of other element types, or which are not
+// contiguous device storage, use the generic system. copy is left to
+// thrust, since cusp::copy dispatches through the same name. amax, asum,
+// nrm1 and nrmmax take |re| + |im| in cuBLAS, so only real arrays are
+// routed there.
+
+template <typename ValueType>
+struct is_cublas_type
+  : thrust::detail::integral_constant<bool,
+      thrust::detail::is_same<ValueType, float>::value ||
+      thrust::detail::is_same<ValueType, double>::value ||
+      thrust::detail::is_same<ValueType, cusp::complex<float> >::value ||
+      thrust::detail::is_same<ValueType, cusp::complex<double> >::value> {};
+
+template <typename ValueType>
+struct is_real_cublas_type
+  : thrust::detail::integral_constant<bool,
+      thrust::detail::is_same<ValueType, float>::value ||
+      thrust::detail::is_same<ValueType, double>::value> {};
+
+template <typename Array, typename ValueType>
+struct is_cublas_array1d
+  : thrust::detail::integral_constant<bool,
+      is_cublas_type<ValueType>::value &&
+      thrust::detail::is_same<typename Array::value_type, ValueType>::value &&
+      thrust::detail::is_convertible<typename Array::memory_space, cusp::device_memory>::value &&
+      thrust::detail::is_trivial_iterator<typename Array::const_iterator>::value> {};
+
+template <typename Array, typename ValueType>
+struct is_cublas_array2d
+  : is_cublas_array1d<typename Array::values_array_type, ValueType> {};
+
+template <typename Array1, typename Array2, typename Array3, typename ValueType>
+struct is_cublas_level2
+  : thrust::detail::integral_constant<bool,
+      is_cublas_array2d<Array1, ValueType>::value &&
+      is_cublas_array1d<Array2, ValueType>::value &&
+      is_cublas_array1d<Array3, ValueType>::value> {};
+
+template <typename Array1, typename Array2, typename Array3, typename ValueType>
+struct is_cublas_level3
+  : thrust::detail::integral_constant<bool,
+      is_cublas_array2d<Array1, ValueType>::value &&
+      is_cublas_array2d<Array2, ValueType>::value &&
+      is_cublas_array2d<Array3, ValueType>::value> {};
+
+template <typename DerivedPolicy,
+          typename Array>
+typename thrust::detail::enable_if<
+  is_real_cublas_type<typename Array::value_type>::value &&
+  is_cublas_array1d<Array, typename Array::value_type>::value, int>::type
+amax(cuda::execution_policy<DerivedPolicy>& exec,
+     const Array& x)
+{
+    cublas::execute_with_cublas policy(pooled_cublas_handle(exec));
+
+    return cublas::amax(policy, x);
+}
+
+template <typename DerivedPolicy,
+          typename Array>
+typename thrust::detail::enable_if<
+  is_real_cublas_type<typename Array::value_type>::value &&
+  is_cublas_array1d<Array, typename Array::value_type>::value,
+  typename cusp::norm_type<typename Array::value_type>::type>::type
+asum(cuda::execution_policy<DerivedPolicy>& exec,
+     const Array& x)
+{
+    cublas::execute_with_cublas policy(pooled_cublas_handle(exec));
+
+    return cublas::asum(policy, x);
+}
+
+template <typename DerivedPolicy,
+          typename Array1,
+          typename Array2,
+          typename ScalarType>
+typename thrust::detail::enable_if<
+  is_cublas_array1d<Array1, typename Array1::value_type>::value &&
+  is_cublas_array1d<Array2, typename Array1::value_type>::value>::type
+axpy(cuda::execution_policy<DerivedPolicy>& exec,
+     const Array1& x,
+           Array2& y,
+     const ScalarType alpha)
+{
+    cusp::assert_same_dimensions(x, y);
+
+    cublas::execute_with_cublas policy(pooled_cublas_handle(exec));
+
+    cublas::axpy(policy, x, y, typename Array1::value_type(alpha));
+}
+
+template <typename DerivedPolicy,
+          typename Array1,
+          typename Array2>
+typename thrust::detail::enable_if<
+  is_cublas_array1d<Array1, typename Array1::value_type>::value &&
+  is_cublas_array1d<Array2, typename Array1::value_type>::value,
+  typename Array1::value_type>::type
+dot(cuda::execution_policy<DerivedPolicy>& exec,
+    const Array1& x,
+    const Array2& y)
+{
+    cusp::assert_same_dimensions(x, y);
+
+    cublas::execute_with_cublas policy(pooled_cublas_handle(exec));
+
+    return cublas::dot(policy, x, y);
+}
+
+template <typename DerivedPolicy,
+          typename Array1,
+          typename Array2>
+typename thrust::detail::enable_if<
+  is_cublas_array1d<Array1, typename Array1::value_type>::value &&
+  is_cublas_array1d<Array2, typename Array1::value_type>::value,
+  typename Array1::value_type>::type
+dotc(cuda::execution_policy<DerivedPolicy>& exec,
+     const Array1& x,
+     const Array2& y)
+{
+    cusp::assert_same_dimensions(x, y);
+
+    cublas::execute_with_cublas policy(pooled_cublas_handle(exec));
+
+    return cublas::dotc(policy, x, y);
+}
+
+template <typename DerivedPolicy,
+          typename Array>
+typename thrust::detail::enable_if<
+  is_cublas_array1d<Array, typename Array::value_type>::value,
+  typename cusp::norm_type<typename Array::value_type>::type>::type
+nrm2(cuda::execution_policy<DerivedPolicy>& exec,
+     const Array& x)
+{
+    cublas::execute_with_cublas policy(pooled_cublas_handle(exec));
+
+    return cublas::nrm2(policy, x);
+}
+
+template <typename DerivedPolicy,
+          typename Array>
+typename thrust::detail::enable_if<
+  is_real_cublas_type<typename Array::value_type>::value &&
+  is_cublas_array1d<Array, typename Array::value_type>::value,
+  typename cusp::norm_type<typename Array::value_type>::type>::type
+nrm1(cuda::execution_policy<DerivedPolicy>& exec,
+     const Array& x)
+{
+    cublas::execute_with_cublas policy(pooled_cublas_handle(exec));
+
+    return cublas::nrm1(policy, x);
+}
+
+template <typename DerivedPolicy,
+          typename Array>
+typename thrust::detail::enable_if<
+  is_real_cublas_type<typename Array::value_type>::value &&
+  is_cublas_array1d<Array, typename Array::value_type>::value,
+  typename cusp::norm_type<typename Array::value_type>::type>::type
+nrmmax(cuda::execution_policy<DerivedPolicy>& exec,
+       const Array& x)
+{
+    cublas::execute_with_cublas policy(pooled_cublas_handle(exec));
+
+    return cublas::nrmmax(policy, x);
+}
+
+template <typename DerivedPolicy,
+          typename Array,
+          typename ScalarType>
+typename thrust::detail::enable_if<
+  is_cublas_array1d<Array, typename Array::value_type>::value>::type
+scal(cuda::execution_policy<DerivedPolicy>& exec,
+     Array& x,
+     const ScalarType alpha)
+{
+    cublas::execute_with_cublas policy(pooled_cublas_handle(exec));
+
+    cublas::scal(policy, x, typename Array::value_type(alpha));
+}
+
+template <typename DerivedPolicy,
+          typename Array2d,
+          typename Array1d1,
+          typename Array1d2,
+          typename ScalarType1,
+          typename ScalarType2>
+typename thrust::detail::enable_if<
+  is_cublas_level2<Array2d, Array1d1, Array1d2, typename Array2d::value_type>::value>::type
+gemv(cuda::execution_policy<DerivedPolicy>& exec,
+     const Array2d&  A,
+     const Array1d1& x,
+           Array1d2& y,
+     const ScalarType1 alpha,
+     const ScalarType2 beta)
+{
+    if(A.num_cols != x.size() || A.num_rows != y.size())
+        throw cusp::invalid_input_exception("array dimensions do not match");
+
+    cublas::execute_with_cublas policy(pooled_cublas_handle(exec));
+
+    cublas::gemv(policy, A, x, y, alpha, beta);
+}
+
+template <typename DerivedPolicy,
+          typename Array1d1,
+          typename Array1d2,
+          typename Array2d,
+          typename ScalarType>
+typename thrust::detail::enable_if<
+  is_cublas_level2<Array2d, Array1d1, Array1d2, typename Array2d::value_type>::value>::type
+ger(cuda::execution_policy<DerivedPolicy>& exec,
+    const Array1d1& x,
+    const Array1d2& y,
+          Array2d& A,
+    const ScalarType alpha)
+{
+    if(A.num_rows != x.size() || A.num_cols != y.size())
+        throw cusp::invalid_input_exception("array dimensions do not match");
+
+    cublas::execute_with_cublas policy(pooled_cublas_handle(exec));
+
+    cublas::ger(policy, x, y, A, alpha);
+}
+
+template <typename DerivedPolicy,
+          typename Array2d,
+          typename Array1d1,
+          typename Array1d2,
+          typename ScalarType1,
+          typename ScalarType2>
+typename thrust::detail::enable_if<
+  is_cublas_level2<Array2d, Array1d1, Array1d2, typename Array2d::value_type>::value>::type
+symv(cuda::execution_policy<DerivedPolicy>& exec,
+     const Array2d&  A,
+     const Array1d1& x,
+           Array1d2& y,
+     const ScalarType1 alpha,
+     const ScalarType2 beta)
+{
+    if(A.num_rows != A.num_cols || A.num_cols != x.size() || A.num_rows != y.size())
+        throw cusp::invalid_input_exception("array dimensions do not match");
+
+    cublas::execute_with_cublas policy(pooled_cublas_handle(exec));
+
+    cublas::symv(policy, A, x, y, alpha, beta);
+}
+
+template <typename DerivedPolicy,
+          typename Array1d,
+          typename Array2d,
+          typename ScalarType>
+typename thrust::detail::enable_if<
+  is_cublas_level2<Array2d, Array1d, Array1d, typename Array2d::value_type>::value>::type
+syr(cuda::execution_policy<DerivedPolicy>& exec,
+    const Array1d& x,
+          Array2d& A,
+    const ScalarType alpha)
+{
+    if(A.num_rows != A.num_cols || A.num_rows != x.size())
+        throw cusp::invalid_input_exception("array dimensions do not match");
+
+    cublas::execute_with_cublas policy(pooled_cublas_handle(exec));
+
+    cublas::syr(policy, x, A, alpha);
+}
+
+template <typename DerivedPolicy,
+          typename Array2d,
+          typename Array1d>
+typename thrust::detail::enable_if<
+  is_cublas_level2<Array2d, Array1d, Array1d, typename Array2d::value_type>::value>::type
+trmv(cuda::execution_policy<DerivedPolicy>& exec,
+     const Array2d& A,
+           Array1d& x)
+{
+    if(A.num_rows != A.num_cols || A.num_cols != x.size())
+        throw cusp::invalid_input_exception("array dimensions do not match");
+
+    cublas::execute_with_cublas policy(pooled_cublas_handle(exec));
+
+    cublas::trmv(policy, A, x);
+}
+
+template <typename DerivedPolicy,
+          typename Array2d,
+          typename Array1d>
+typename thrust::detail::enable_if<
+  is_cublas_level2<Array2d, Array1d, Array1d, typename Array2d::value_type>::value>::type
+trsv(cuda::execution_policy<DerivedPolicy>& exec,
+     const Array2d& A,
+           Array1d& x)
+{
+    if(A.num_rows != A.num_cols || A.num_cols != x.size())
+        throw cusp::invalid_input_exception("array dimensions do not match");
+
+    cublas::execute_with_cublas policy(pooled_cublas_handle(exec));
+
+    cublas::trsv(policy, A, x);
+}
+
+template <typename DerivedPolicy,
+          typename Array2d1,
+          typename Array2d2,
+          typename Array2d3,
+          typename ScalarType1,
+          typename ScalarType2>
+typename thrust::detail::enable_if<
+  is_cublas_level3<Array2d1, Array2d2, Array2d3, typename Array2d1::value_type>::value>::type
+gemm(cuda::execution_policy<DerivedPolicy>& exec,
+     const Array2d1& A,
+     const Array2d2& B,
+           Array2d3& C,
+     const ScalarType1 alpha,
+     const ScalarType2 beta)
+{
+    if(A.num_cols != B.num_rows || C.num_rows != A.num_rows || C.num_cols != B.num_cols)
+        throw cusp::invalid_input_exception("array dimensions do not match");
+
+    cublas::execute_with_cublas policy(pooled_cublas_handle(exec));
+
+    cublas::gemm(policy, A, B, C, alpha, beta);
+}
+
+template <typename DerivedPolicy,
+          typename Array2d1,
+          typename Array2d2,
+          typename Array2d3,
+          typename ScalarType1,
+          typename ScalarType2>
+typename thrust::detail::enable_if<
+  is_cublas_level3<Array2d1, Array2d2, Array2d3, typename Array2d1::value_type>::value>::type
+symm(cuda::execution_policy<DerivedPolicy>& exec,
+     const Array2d1& A,
+     const Array2d2& B,
+           Array2d3& C,
+     const ScalarType1 alpha,
+     const ScalarType2 beta)
+{
+    if(A.num_rows != A.num_cols || A.num_cols != B.num_rows ||
+       C.num_rows != A.num_rows || C.num_cols != B.num_cols)
+        throw cusp::invalid_input_exception("array dimensions do not match");
+
+    cublas::execute_with_cublas policy(pooled_cublas_handle(exec));
+
+    cublas::symm(policy, A, B, C, alpha, beta);
+}
+
+template <typename DerivedPolicy,
+          typename Array2d1,
+          typename Array2d2,
+          typename ScalarType1,
+          typename ScalarType2>
+typename thrust::detail::enable_if<
+  is_cublas_level3<Array2d1, Array2d2, Array2d2, typename Array2d1::value_type>::value>::type
+syrk(cuda::execution_policy<DerivedPolicy>& exec,
+     const Array2d1& A,
+           Array2d2& B,
+     const ScalarType1 alpha,
+     const ScalarType2 beta)
+{
+    if(B.num_rows != B.num_cols || B.num_rows != A.num_rows)
+        throw cusp::invalid_input_exception("array dimensions do not match");
+
+    cublas::execute_with_cublas policy(pooled_cublas_handle(exec));
+
+    cublas::syrk(policy, A, B, alpha, beta);
+}
+
+template <typename DerivedPolicy,
+          typename Array2d1,
+          typename Array2d2,
+          typename Array2d3,
+          typename ScalarType1,
+          typename ScalarType2>
+typename thrust::detail::enable_if<
+  is_cublas_level3<Array2d1, Array2d2, Array2d3, typename Array2d1::value_type>::value>::type
+syr2k(cuda::execution_policy<DerivedPolicy>& exec,
+      const Array2d1& A,
+      const Array2d2& B,
+            Array2d3& C,
+      const ScalarType1 alpha,
+      const ScalarType2 beta)
+{
+    if(A.num_rows != B.num_rows || A.num_cols != B.num_cols ||
+       C.num_rows != C.num_cols || C.num_rows != A.num_rows)
+        throw cusp::invalid_input_exception("array dimensions do not match");
+
+    cublas::execute_with_cublas policy(pooled_cublas_handle(exec));
+
+    cublas::syr2k(policy, A, B, C, alpha, beta);
+}
+
+template <typename DerivedPolicy,
+          typename Array2d1,
+          typename Array2d2,
+          typename ScalarType>
+typename thrust::detail::enable_if<
+  is_cublas_level3<Array2d1, Array2d2, Array2d2, typename Array2d1::value_type>::value>::type
+trmm(cuda::execution_policy<DerivedPolicy>& exec,
+     const Array2d1& A,
+           Array2d2& B,
+     const ScalarType alpha)
+{
+    if(A.num_rows != A.num_cols || A.num_cols != B.num_rows)
+        throw cusp::invalid_input_exception("array dimensions do not match");
+
+    cublas::execute_with_cublas policy(pooled_cublas_handle(exec));
+
+    cublas::trmm(policy, A, B, alpha);
+}
+
+template <typename DerivedPolicy,
+          typename Array2d1,
+          typename Array2d2,
+          typename ScalarType>
+typename thrust::detail::enable_if<
+  is_cublas_level3<Array2d1, Array2d2, Array2d2, typename Array2d1::value_type>::value>::type
+trsm(cuda::execution_policy<DerivedPolicy>& exec,
+     const Array2d1& A,
+           Array2d2& B,
+     const ScalarType alpha)
+{
+    if(A.num_rows != A.num_cols || A.num_cols != B.num_rows)
+        throw cusp::invalid_input_exception("array dimensions do not match");
+
+    cublas::execute_with_cublas policy(pooled_cublas_handle(exec));
+
+    cublas::trsm(policy, A, B, alpha);
+}
+
+} // end namespace detail
+} // end namespace cuda
+} // end namespace system
+} // end namespace cusp
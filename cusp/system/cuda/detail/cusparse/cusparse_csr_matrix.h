@@ -14,14 +14,20 @@
  *  limitations under the License.
  */
 
-
 #pragma once
 
+#include <cusp/detail/config.h>
+
 #include <cusp/csr_matrix.h>
+#include <cusp/exception.h>
+
+#include <cusp/system/cuda/detail/cusparse/defs.h>
+#include <cusp/system/cuda/detail/cusparse/exception.h>
 
-#include <cusparse_v2.h>
+#include <cuda_runtime_api.h>
+#include <cusparse.h>
 
-#include <thrust/system/cuda/vector.h>
+#include <vector>
 
 namespace cusp
 {
@@ -29,42 +35,313 @@ namespace system
 {
 namespace cuda
 {
+namespace detail
+{
+namespace cusparse
+{
+
+// Descriptors and workspace of the cusparse products with one matrix. The
+// matrix and vector descriptors are created on first use and refer to the
+// arrays of the matrix, the dense vector descriptors are pointed at the
+// operands of each product. Work on different streams may overlap, so each
+// stream has its own handle and workspace buffer, which grows to the
+// largest request and is kept for the next product on that stream.
+template <typename IndexType, typename ValueType>
+class csr_plan
+{
+  public:
+
+    csr_plan(void)
+      : matrix(0), x(0), y(0), spmv_bytes(0), has_spmv_bytes(false)
+    {}
+
+    // copies start empty, every plan owns its descriptors and buffers
+    csr_plan(const csr_plan&)
+      : matrix(0), x(0), y(0), spmv_bytes(0), has_spmv_bytes(false)
+    {}
+
+    csr_plan& operator=(const csr_plan&)
+    {
+        release();
+        return *this;
+    }
+
+    ~csr_plan(void)
+    {
+        release();
+    }
+
+    void release(void)
+    {
+#if CUSP_CUSPARSE_GENERIC_API
+        if (matrix) cusparseDestroySpMat(matrix);
+        if (x)      cusparseDestroyDnVec(x);
+        if (y)      cusparseDestroyDnVec(y);
+#endif
+
+        for (size_t i = 0; i < entries.size(); i++)
+        {
+            if (entries[i].handle) cusparseDestroy(entries[i].handle);
+            if (entries[i].buffer) cudaFree(entries[i].buffer);
+        }
+
+        matrix = 0;
+        x = 0;
+        y = 0;
+        spmv_bytes = 0;
+        has_spmv_bytes = false;
+        entries.clear();
+    }
+
+    // handle owned by the plan which issues its work on s
+    cusparseHandle_t handle(const cudaStream_t s)
+    {
+        stream_entry& entry = find(s);
+
+        if (entry.handle == 0)
+        {
+            check_status("cusparseCreate", cusparseCreate(&entry.handle));
+            check_status("cusparseSetStream", cusparseSetStream(entry.handle, s));
+        }
+
+        return entry.handle;
+    }
+
+    // workspace of at least bytes, only used by work on s
+    void * workspace(const cudaStream_t s, const size_t bytes)
+    {
+        stream_entry& entry = find(s);
+
+        if (bytes > entry.buffer_size)
+        {
+            if (entry.buffer) cudaFree(entry.buffer);
+
+            entry.buffer = 0;
+            entry.buffer_size = 0;
+
+            if (cudaMalloc(&entry.buffer, bytes) != cudaSuccess)
+                throw cusp::runtime_exception("cusparse: could not allocate the workspace");
+
+            entry.buffer_size = bytes;
+        }
+
+        return entry.buffer;
+    }
+
+#if CUSP_CUSPARSE_GENERIC_API
+
+    template <typename MatrixType>
+    cusparseSpMatDescr_t descriptor(const MatrixType& A)
+    {
+        if (matrix == 0)
+        {
+            check_status("cusparseCreateCsr",
+                cusparseCreateCsr(&matrix, A.num_rows, A.num_cols, A.num_entries,
+                                  (void *) thrust::raw_pointer_cast(&A.row_offsets[0]),
+                                  (void *) thrust::raw_pointer_cast(&A.column_indices[0]),
+                                  (void *) thrust::raw_pointer_cast(&A.values[0]),
+                                  index_type_traits<IndexType>::type,
+                                  index_type_traits<IndexType>::type,
+                                  CUSPARSE_INDEX_BASE_ZERO,
+                                  value_type_traits<ValueType>::type));
+        }
+
+        return matrix;
+    }
+
+    // y = alpha * A * x + beta * y
+    template <typename MatrixType>
+    void spmv(cusparseHandle_t handle, const cudaStream_t s, const MatrixType& A,
+              const ValueType * x_values, ValueType * y_values,
+              const ValueType alpha, const ValueType beta)
+    {
+        const cudaDataType type = value_type_traits<ValueType>::type;
+
+        cusparseSpMatDescr_t descr_A = descriptor(A);
+
+        if (x == 0)
+            check_status("cusparseCreateDnVec", cusparseCreateDnVec(&x, A.num_cols, (void *) x_values, type));
+        else
+            check_status("cusparseDnVecSetValues", cusparseDnVecSetValues(x, (void *) x_values));
 
-template <typename ValueType>
-class cusparse_csr_matrix : public cusp::csr_matrix_view< cusp::array1d_view<typename thrust::cuda::vector<int>::iterator>,
-                                                          cusp::array1d_view<typename thrust::cuda::vector<int>::iterator>,
-                                                          cusp::array1d_view<typename thrust::cuda::vector<ValueType>::iterator> >
+        if (y == 0)
+            check_status("cusparseCreateDnVec", cusparseCreateDnVec(&y, A.num_rows, (void *) y_values, type));
+        else
+            check_status("cusparseDnVecSetValues", cusparseDnVecSetValues(y, (void *) y_values));
+
+        // the size depends on the matrix and the algorithm only
+        if (!has_spmv_bytes)
+        {
+            check_status("cusparseSpMV_bufferSize",
+                cusparseSpMV_bufferSize(handle, CUSPARSE_OPERATION_NON_TRANSPOSE,
+                                        &alpha, descr_A, x, &beta, y, type,
+                                        spmv_algorithm, &spmv_bytes));
+            has_spmv_bytes = true;
+        }
+
+        void * buffer = workspace(s, spmv_bytes);
+
+        check_status("cusparseSpMV",
+            cusparseSpMV(handle, CUSPARSE_OPERATION_NON_TRANSPOSE,
+                         &alpha, descr_A, x, &beta, y, type,
+                         spmv_algorithm, buffer));
+    }
+
+    // Y = alpha * A * X + beta * Y for dense X and Y of num_vectors columns
+    template <typename MatrixType>
+    void spmm(cusparseHandle_t handle, const cudaStream_t s, const MatrixType& A,
+              const size_t num_vectors,
+              const ValueType * x_values, const size_t x_pitch,
+              ValueType * y_values, const size_t y_pitch,
+              const cusparseOrder_t order,
+              const ValueType alpha, const ValueType beta)
+    {
+        const cudaDataType type = value_type_traits<ValueType>::type;
+
+        cusparseSpMatDescr_t descr_A = descriptor(A);
+        cusparseDnMatDescr_t X = 0;
+        cusparseDnMatDescr_t Y = 0;
+
+        // the leading dimension is the distance between rows (row-major)
+        // or columns (column-major), which is the pitch of the array2d
+        cusparseStatus_t stat =
+            cusparseCreateDnMat(&X, A.num_cols, num_vectors, x_pitch, (void *) x_values, type, order);
+
+        if (stat == CUSPARSE_STATUS_SUCCESS)
+            stat = cusparseCreateDnMat(&Y, A.num_rows, num_vectors, y_pitch, (void *) y_values, type, order);
+
+        size_t bytes = 0;
+
+        if (stat == CUSPARSE_STATUS_SUCCESS)
+            stat = cusparseSpMM_bufferSize(handle,
+                                           CUSPARSE_OPERATION_NON_TRANSPOSE, CUSPARSE_OPERATION_NON_TRANSPOSE,
+                                           &alpha, descr_A, X, &beta, Y, type, spmm_algorithm, &bytes);
+
+        if (stat == CUSPARSE_STATUS_SUCCESS)
+            stat = cusparseSpMM(handle,
+                                CUSPARSE_OPERATION_NON_TRANSPOSE, CUSPARSE_OPERATION_NON_TRANSPOSE,
+                                &alpha, descr_A, X, &beta, Y, type, spmm_algorithm, workspace(s, bytes));
+
+        if (X) cusparseDestroyDnMat(X);
+        if (Y) cusparseDestroyDnMat(Y);
+
+        check_status("cusparseSpMM", stat);
+    }
+
+#endif
+
+  private:
+
+    struct stream_entry
+    {
+        cudaStream_t     stream;
+        cusparseHandle_t handle;
+        void *           buffer;
+        size_t           buffer_size;
+    };
+
+    stream_entry& find(const cudaStream_t s)
+    {
+        for (size_t i = 0; i < entries.size(); i++)
+            if (entries[i].stream == s)
+                return entries[i];
+
+        stream_entry entry;
+        entry.stream      = s;
+        entry.handle      = 0;
+        entry.buffer      = 0;
+        entry.buffer_size = 0;
+
+        entries.push_back(entry);
+
+        return entries.back();
+    }
+
+#if CUSP_CUSPARSE_GENERIC_API
+    cusparseSpMatDescr_t matrix;
+    cusparseDnVecDescr_t x;
+    cusparseDnVecDescr_t y;
+#else
+    void * matrix;
+    void * x;
+    void * y;
+#endif
+
+    size_t spmv_bytes;
+    bool   has_spmv_bytes;
+
+    std::vector<stream_entry> entries;
+};
+
+/**
+ * \brief View of a device CSR matrix whose products are computed by
+ * cusparse.
+ *
+ * \tparam ValueType Type used for matrix values (e.g. \c float).
+ * \tparam IndexType Type used for matrix indices, \c int or \c long long.
+ *
+ * \par Overview
+ *  The matrix keeps the cusparse matrix descriptor, and for every stream a
+ *  handle and the external workspace of the generic SpMV and SpMM, from
+ *  one product to the next, so repeated products only launch the cusparse
+ *  kernels. The arrays of the viewed matrix must outlive the view and keep
+ *  their storage; call \p reset after they were reallocated.
+ *
+ *  Products with the execution policy <tt>cusp::cuda::par.with(h)</tt>,
+ *  \c h a \c cusparseHandle_t, use \c h instead of the cached handles.
+ *  Products with functors other than the standard (+, *) semiring use
+ *  the cusp kernels.
+ */
+template <typename ValueType, typename IndexType = int>
+class cusparse_csr_matrix
+  : public cusp::csr_matrix<IndexType,ValueType,cusp::device_memory>::view
 {
-private:
+  private:
 
-    typedef typename thrust::cuda::vector<int>::iterator                    IndexIterator;
-    typedef typename thrust::cuda::vector<ValueType>::iterator              ValueIterator;
-    typedef cusp::array1d_view<IndexIterator>                               IndicesView;
-    typedef cusp::array1d_view<ValueIterator>                               ValuesView;
-    typedef cusp::csr_matrix_view<IndicesView,IndicesView,ValuesView>       Parent;
+    typedef typename cusp::csr_matrix<IndexType,ValueType,cusp::device_memory>::view Parent;
 
-public:
+  public:
 
-    cusparseMatDescr_t descr;
+    /*! \cond */
+    typedef csr_plan<IndexType,ValueType> plan_type;
+    /*! \endcond */
 
     /*! Construct an empty \p cusparse_csr_matrix.
      */
-    cusparse_csr_matrix(void) : descr(0) {}
+    cusparse_csr_matrix(void) {}
 
-    /*! Construct a \p csr_matrix with a specific shape and number of nonzero entries.
+    /*! Construct a \p cusparse_csr_matrix viewing \p A.
      *
-     *  \param num_rows Number of rows.
-     *  \param num_cols Number of columns.
-     *  \param num_entries Number of nonzero matrix entries.
+     *  \param A device \p csr_matrix or \p csr_matrix_view
+     */
+    template <typename MatrixType>
+    cusparse_csr_matrix(MatrixType& A)
+      : Parent(A)
+    {}
+
+    /*! Release the cached descriptors, handles and workspace.
      */
-    cusparse_csr_matrix(cusp::csr_matrix<int,ValueType,cusp::device_memory>& A)
-        : Parent(A)
+    void reset(void)
+    {
+        m_plan.release();
+    }
+
+    /*! \cond */
+    plan_type& plan(void) const
     {
-        /* create and setup matrix descriptor */
-        if (cusparseCreateMatDescr(&descr) != CUSPARSE_STATUS_SUCCESS) { throw cusp::runtime_exception("cusparseCreateMatDescr failed"); }
+        return m_plan;
     }
+    /*! \endcond */
+
+  private:
+
+    mutable plan_type m_plan;
+};
 
-}; // class csr_matrix
+} // end namespace cusparse
+} // end namespace detail
+
+using cusp::system::cuda::detail::cusparse::cusparse_csr_matrix;
 
 } // end namespace cuda
 } // end namespace system
@@ -78,4 +355,3 @@ using cusp::system::cuda::cusparse_csr_matrix;
 } // end cuda
 
 } // end namespace cusp
-
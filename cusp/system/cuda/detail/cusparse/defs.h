@@ -0,0 +1,129 @@
+/*
+ *  Copyright 2008-2014 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*! \file defs.h
+ *  \brief Cusparse utility definitions for the generic API
+ */
+
+#pragma once
+
+#include <cusp/detail/config.h>
+#include <cusp/complex.h>
+
+#include <thrust/functional.h>
+#include <thrust/detail/type_traits.h>
+
+#include <cusparse.h>
+#include <library_types.h>
+
+// the generic SpMV, SpMM and SpGEMM routines are complete from CUDA 11.0,
+// without them products with the cusparse policy use the cusp kernels
+#if defined(CUSPARSE_VERSION) && (CUSPARSE_VERSION >= 11000)
+#define CUSP_CUSPARSE_GENERIC_API 1
+#else
+#define CUSP_CUSPARSE_GENERIC_API 0
+#endif
+
+namespace cusp
+{
+namespace system
+{
+namespace cuda
+{
+namespace detail
+{
+namespace cusparse
+{
+
+#if CUSP_CUSPARSE_GENERIC_API
+
+// the algorithm enumerators were renamed in cuSPARSE 11.4
+#if CUSPARSE_VERSION >= 11400
+const cusparseSpMVAlg_t spmv_algorithm = CUSPARSE_SPMV_ALG_DEFAULT;
+const cusparseSpMMAlg_t spmm_algorithm = CUSPARSE_SPMM_ALG_DEFAULT;
+#else
+const cusparseSpMVAlg_t spmv_algorithm = CUSPARSE_MV_ALG_DEFAULT;
+const cusparseSpMMAlg_t spmm_algorithm = CUSPARSE_MM_ALG_DEFAULT;
+#endif
+
+#endif
+
+template <typename ValueType> struct value_type_traits
+{
+    static const bool supported = false;
+};
+
+template <> struct value_type_traits<float>
+{
+    static const bool supported = true;
+    static const cudaDataType type = CUDA_R_32F;
+};
+
+template <> struct value_type_traits<double>
+{
+    static const bool supported = true;
+    static const cudaDataType type = CUDA_R_64F;
+};
+
+template <> struct value_type_traits< cusp::complex<float> >
+{
+    static const bool supported = true;
+    static const cudaDataType type = CUDA_C_32F;
+};
+
+template <> struct value_type_traits< cusp::complex<double> >
+{
+    static const bool supported = true;
+    static const cudaDataType type = CUDA_C_64F;
+};
+
+template <typename IndexType> struct index_type_traits
+{
+    static const bool supported = false;
+};
+
+template <> struct index_type_traits<int>
+{
+    static const bool supported = true;
+    static const cusparseIndexType_t type = CUSPARSE_INDEX_32I;
+};
+
+template <> struct index_type_traits<long long>
+{
+    static const bool supported = true;
+    static const cusparseIndexType_t type = CUSPARSE_INDEX_64I;
+};
+
+// products handed to cusparse: every value has the same supported type
+// and the functors are the standard (+, *) semiring
+template <typename IndexType,
+          typename ValueType1, typename ValueType2, typename ValueType3,
+          typename BinaryFunction1, typename BinaryFunction2>
+struct is_standard_product
+  : thrust::detail::integral_constant<bool,
+      value_type_traits<ValueType3>::supported &&
+      index_type_traits<IndexType>::supported &&
+      thrust::detail::is_same<ValueType1,ValueType3>::value &&
+      thrust::detail::is_same<ValueType2,ValueType3>::value &&
+      thrust::detail::is_same<BinaryFunction1,thrust::multiplies<ValueType3> >::value &&
+      thrust::detail::is_same<BinaryFunction2,thrust::plus<ValueType3> >::value>
+{};
+
+} // end namespace cusparse
+} // end namespace detail
+} // end namespace cuda
+} // end namespace system
+} // end namespace cusp
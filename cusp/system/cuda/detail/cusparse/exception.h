@@ -0,0 +1,81 @@
+/*
+ *  Copyright 2008-2014 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*! \file exception.h
+ *  \brief Cusparse exceptions
+ */
+
+#pragma once
+
+#include <cusp/detail/config.h>
+#include <cusp/exception.h>
+
+#include <cusparse.h>
+
+#include <string>
+
+namespace cusp
+{
+namespace system
+{
+namespace cuda
+{
+namespace detail
+{
+namespace cusparse
+{
+
+class cusparse_exception : public cusp::exception
+{
+public:
+    cusparse_exception(const std::string name,
+                       const cusparseStatus_t stat)
+                      : exception(name + ": ")
+    {
+        if(stat == CUSPARSE_STATUS_NOT_INITIALIZED)
+          message += "CUSPARSE_STATUS_NOT_INITIALIZED";
+        else if(stat == CUSPARSE_STATUS_ALLOC_FAILED)
+          message += "CUSPARSE_STATUS_ALLOC_FAILED";
+        else if(stat == CUSPARSE_STATUS_INVALID_VALUE)
+          message += "CUSPARSE_STATUS_INVALID_VALUE";
+        else if(stat == CUSPARSE_STATUS_ARCH_MISMATCH)
+          message += "CUSPARSE_STATUS_ARCH_MISMATCH";
+        else if(stat == CUSPARSE_STATUS_EXECUTION_FAILED)
+          message += "CUSPARSE_STATUS_EXECUTION_FAILED";
+        else if(stat == CUSPARSE_STATUS_INTERNAL_ERROR)
+          message += "CUSPARSE_STATUS_INTERNAL_ERROR";
+        else if(stat == CUSPARSE_STATUS_MATRIX_TYPE_NOT_SUPPORTED)
+          message += "CUSPARSE_STATUS_MATRIX_TYPE_NOT_SUPPORTED";
+        else if(stat == CUSPARSE_STATUS_NOT_SUPPORTED)
+          message += "CUSPARSE_STATUS_NOT_SUPPORTED";
+        else if(stat == CUSPARSE_STATUS_INSUFFICIENT_RESOURCES)
+          message += "CUSPARSE_STATUS_INSUFFICIENT_RESOURCES";
+        else
+          message += "Unknown cusparseStatus_t";
+    }
+};
+
+inline void check_status(const char * name, const cusparseStatus_t stat)
+{
+    if (stat != CUSPARSE_STATUS_SUCCESS)
+        throw cusparse_exception(name, stat);
+}
+
+} // end namespace cusparse
+} // end namespace detail
+} // end namespace cuda
+} // end namespace system
+} // end namespace cusp
@@ -0,0 +1,150 @@
+/*
+ *  Copyright 2008-2014 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#pragma once
+
+#include <cusp/detail/config.h>
+
+#include <cusp/system/cuda/detail/execution_policy.h>
+
+#include <cusparse.h>
+
+namespace cusp
+{
+namespace system
+{
+namespace cuda
+{
+namespace detail
+{
+namespace cusparse
+{
+
+// execution policy whose sparse products are computed by cusparse with
+// the handle it carries, see cusp/system/cuda/cusparse.h
+template<typename DerivedPolicy>
+class execute_with_cusparse_base
+  : public cusp::cuda::execution_policy<DerivedPolicy>
+{
+  public:
+
+    execute_with_cusparse_base(void)
+      : m_stream(0), m_has_stream(false)
+    {}
+
+    execute_with_cusparse_base(const cusparseHandle_t& handle)
+      : m_handle(handle), m_stream(0), m_has_stream(false)
+    {}
+
+    __host__ __device__
+    DerivedPolicy with(const cusparseHandle_t& h) const
+    {
+      DerivedPolicy result = thrust::detail::derived_cast(*this);
+
+      result.set_handle(h);
+
+      return result;
+    }
+
+    __host__ __device__
+    DerivedPolicy on(const cudaStream_t& s) const
+    {
+      DerivedPolicy result = thrust::detail::derived_cast(*this);
+
+      // bind s to the result, the handle is moved onto s at each call
+      result.set_stream(s);
+
+      return result;
+    }
+
+  private:
+
+    __host__ __device__
+    friend inline cusparseHandle_t const& handle(const execute_with_cusparse_base &exec)
+    {
+      return exec.m_handle;
+    }
+
+    // the handle moved onto the policy's stream; a handle passed without
+    // a stream keeps whatever stream the caller set on it
+    friend inline cusparseHandle_t const& bound_handle(const execute_with_cusparse_base &exec)
+    {
+      if (exec.m_has_stream)
+        cusparseSetStream(exec.m_handle, exec.m_stream);
+
+      return exec.m_handle;
+    }
+
+    // the stream the work is issued on
+    friend inline cudaStream_t handle_stream(const execute_with_cusparse_base &exec)
+    {
+      if (exec.m_has_stream)
+        return exec.m_stream;
+
+      cudaStream_t s = 0;
+      cusparseGetStream(exec.m_handle, &s);
+
+      return s;
+    }
+
+    __host__ __device__
+    friend inline cudaStream_t stream(const execute_with_cusparse_base &exec)
+    {
+      return exec.m_stream;
+    }
+
+    __host__ __device__
+    friend inline cudaStream_t get_stream(const execute_with_cusparse_base &exec)
+    {
+      return exec.m_stream;
+    }
+
+    __host__ __device__
+    inline void set_handle(const cusparseHandle_t &h)
+    {
+      m_handle = h;
+    }
+
+    __host__ __device__
+    inline void set_stream(const cudaStream_t &s)
+    {
+      m_stream = s;
+      m_has_stream = true;
+    }
+
+    cusparseHandle_t m_handle;
+    cudaStream_t     m_stream;
+    bool             m_has_stream;
+};
+
+class execute_with_cusparse
+  : public execute_with_cusparse_base<execute_with_cusparse>
+{
+    typedef execute_with_cusparse_base<execute_with_cusparse> super_t;
+
+  public:
+
+    __host__ __device__
+    inline execute_with_cusparse(const cusparseHandle_t& h)
+      : super_t(h)
+    {}
+};
+
+} // end namespace cusparse
+} // end namespace detail
+} // end namespace cuda
+} // end namespace system
+} // end namespace cusp
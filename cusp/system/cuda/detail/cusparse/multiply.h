@@ -0,0 +1,587 @@
+/*
+ *  Copyright 2008-2014 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#pragma once
+
+#include <cusp/detail/config.h>
+
+#include <cusp/array1d.h>
+#include <cusp/array2d.h>
+#include <cusp/csr_matrix.h>
+#include <cusp/functional.h>
+
+#include <cusp/detail/format.h>
+#include <cusp/detail/temporary_array.h>
+
+#include <cusp/system/cuda/detail/multiply.h>
+#include <cusp/system/cuda/detail/cusparse/cusparse_csr_matrix.h>
+#include <cusp/system/cuda/detail/cusparse/defs.h>
+#include <cusp/system/cuda/detail/cusparse/exception.h>
+#include <cusp/system/cuda/detail/cusparse/execute_with_cusparse.h>
+
+#include <thrust/fill.h>
+#include <thrust/functional.h>
+
+namespace cusp
+{
+namespace system
+{
+namespace cuda
+{
+namespace detail
+{
+namespace cusparse
+{
+
+// cusparse computes y = alpha * A * x + beta * y, so the initial values of
+// y are expressed through beta and the other initializations are left to
+// the cusp kernels
+template <typename DerivedPolicy, typename ArrayType, typename UnaryFunction, typename ValueType>
+bool product_beta(cuda::execution_policy<DerivedPolicy>& exec, ArrayType& y,
+                  UnaryFunction initialize, ValueType& beta)
+{
+    return false;
+}
+
+template <typename DerivedPolicy, typename ArrayType, typename ValueType>
+bool product_beta(cuda::execution_policy<DerivedPolicy>& exec, ArrayType& y,
+                  cusp::constant_functor<ValueType> initialize, ValueType& beta)
+{
+    const ValueType value = initialize(ValueType(0));
+
+    if (value == ValueType(0))
+    {
+        beta = ValueType(0);
+    }
+    else
+    {
+        thrust::fill(exec, y.begin(), y.end(), value);
+        beta = ValueType(1);
+    }
+
+    return true;
+}
+
+template <typename DerivedPolicy, typename ArrayType, typename ValueType>
+bool product_beta(cuda::execution_policy<DerivedPolicy>& exec, ArrayType& y,
+                  thrust::identity<ValueType> initialize, ValueType& beta)
+{
+    beta = ValueType(1);
+    return true;
+}
+
+template <typename Orientation>
+cusparseOrder_t dense_order(Orientation)
+{
+    return CUSPARSE_ORDER_COL;
+}
+
+inline cusparseOrder_t dense_order(cusp::row_major)
+{
+    return CUSPARSE_ORDER_ROW;
+}
+
+template <typename DerivedPolicy,
+          typename Plan,
+          typename MatrixType,
+          typename VectorType1,
+          typename VectorType2,
+          typename UnaryFunction,
+          typename BinaryFunction1,
+          typename BinaryFunction2>
+void __spmv_cusparse(cuda::execution_policy<DerivedPolicy>& exec,
+                     Plan& plan, cusparseHandle_t handle, const cudaStream_t s,
+                     const MatrixType& A,
+                     const VectorType1& x,
+                     VectorType2& y,
+                     UnaryFunction   initialize,
+                     BinaryFunction1 combine,
+                     BinaryFunction2 reduce,
+                     thrust::detail::false_type)
+{
+    cusp::system::cuda::detail::multiply(exec, A, x, y, initialize, combine, reduce,
+                                         cusp::csr_format(), cusp::array1d_format(), cusp::array1d_format());
+}
+
+template <typename DerivedPolicy,
+          typename Plan,
+          typename MatrixType,
+          typename VectorType1,
+          typename VectorType2,
+          typename UnaryFunction,
+          typename BinaryFunction1,
+          typename BinaryFunction2>
+void __spmv_cusparse(cuda::execution_policy<DerivedPolicy>& exec,
+                     Plan& plan, cusparseHandle_t handle, const cudaStream_t s,
+                     const MatrixType& A,
+                     const VectorType1& x,
+                     VectorType2& y,
+                     UnaryFunction   initialize,
+                     BinaryFunction1 combine,
+                     BinaryFunction2 reduce,
+                     thrust::detail::true_type)
+{
+    typedef typename VectorType2::value_type ValueType;
+
+    ValueType beta;
+
+#if CUSP_CUSPARSE_GENERIC_API
+    if (A.num_entries > 0 && product_beta(exec, y, initialize, beta))
+    {
+        plan.spmv(handle, s, A,
+                  thrust::raw_pointer_cast(&x[0]), thrust::raw_pointer_cast(&y[0]),
+                  ValueType(1), beta);
+        return;
+    }
+#endif
+
+    __spmv_cusparse(exec, plan, handle, s, A, x, y, initialize, combine, reduce, thrust::detail::false_type());
+}
+
+template <typename DerivedPolicy,
+          typename Plan,
+          typename MatrixType,
+          typename VectorType1,
+          typename VectorType2,
+          typename UnaryFunction,
+          typename BinaryFunction1,
+          typename BinaryFunction2>
+void __spmm_cusparse(cuda::execution_policy<DerivedPolicy>& exec,
+                     Plan& plan, cusparseHandle_t handle, const cudaStream_t s,
+                     const MatrixType& A,
+                     const VectorType1& x,
+                     VectorType2& y,
+                     UnaryFunction   initialize,
+                     BinaryFunction1 combine,
+                     BinaryFunction2 reduce,
+                     thrust::detail::false_type)
+{
+    cusp::system::cuda::detail::multiply(exec, A, x, y, initialize, combine, reduce,
+                                         cusp::csr_format(), cusp::array2d_format(), cusp::array2d_format());
+}
+
+template <typename DerivedPolicy,
+          typename Plan,
+          typename MatrixType,
+          typename VectorType1,
+          typename VectorType2,
+          typename UnaryFunction,
+          typename BinaryFunction1,
+          typename BinaryFunction2>
+void __spmm_cusparse(cuda::execution_policy<DerivedPolicy>& exec,
+                     Plan& plan, cusparseHandle_t handle, const cudaStream_t s,
+                     const MatrixType& A,
+                     const VectorType1& x,
+                     VectorType2& y,
+                     UnaryFunction   initialize,
+                     BinaryFunction1 combine,
+                     BinaryFunction2 reduce,
+                     thrust::detail::true_type)
+{
+    typedef typename VectorType1::orientation Orientation1;
+    typedef typename VectorType2::orientation Orientation2;
+    typedef typename VectorType2::value_type  ValueType;
+
+    ValueType beta;
+
+#if CUSP_CUSPARSE_GENERIC_API
+    // both operands must have the same plain row-major or column-major layout
+    const bool plain_layout =
+        thrust::detail::is_same<Orientation1,Orientation2>::value &&
+        (thrust::detail::is_same<Orientation2,cusp::row_major>::value ||
+         thrust::detail::is_same<Orientation2,cusp::column_major>::value);
+
+    if (plain_layout &&
+        A.num_entries > 0 && x.num_cols > 0 &&
+        product_beta(exec, y.values, initialize, beta))
+    {
+        plan.spmm(handle, s, A, x.num_cols,
+                  thrust::raw_pointer_cast(&x.values[0]), x.pitch,
+                  thrust::raw_pointer_cast(&y.values[0]), y.pitch,
+                  dense_order(Orientation2()),
+                  ValueType(1), beta);
+        return;
+    }
+#endif
+
+    __spmm_cusparse(exec, plan, handle, s, A, x, y, initialize, combine, reduce, thrust::detail::false_type());
+}
+
+template <typename MatrixType, typename VectorType1, typename VectorType2,
+          typename BinaryFunction1, typename BinaryFunction2>
+struct is_standard_spmv
+  : is_standard_product<typename MatrixType::index_type,
+                        typename MatrixType::value_type,
+                        typename VectorType1::value_type,
+                        typename VectorType2::value_type,
+                        BinaryFunction1, BinaryFunction2>
+{};
+
+//////////////////////////////////////////////
+// SpMV and SpMM with the cusparse policy   //
+//////////////////////////////////////////////
+
+// any device CSR matrix, the descriptors and workspace last for one product
+template <typename DerivedPolicy,
+          typename MatrixType,
+          typename VectorType1,
+          typename VectorType2,
+          typename UnaryFunction,
+          typename BinaryFunction1,
+          typename BinaryFunction2>
+void multiply(execute_with_cusparse_base<DerivedPolicy>& exec,
+              const MatrixType& A,
+              const VectorType1& x,
+              VectorType2& y,
+              UnaryFunction   initialize,
+              BinaryFunction1 combine,
+              BinaryFunction2 reduce,
+              cusp::csr_format,
+              cusp::array1d_format,
+              cusp::array1d_format)
+{
+    typedef is_standard_spmv<MatrixType,VectorType1,VectorType2,BinaryFunction1,BinaryFunction2> Standard;
+
+    csr_plan<typename MatrixType::index_type, typename VectorType2::value_type> plan;
+
+    __spmv_cusparse(exec, plan, bound_handle(exec), handle_stream(exec),
+                    A, x, y, initialize, combine, reduce, typename Standard::type());
+}
+
+template <typename DerivedPolicy,
+          typename MatrixType,
+          typename VectorType1,
+          typename VectorType2,
+          typename UnaryFunction,
+          typename BinaryFunction1,
+          typename BinaryFunction2>
+void multiply(execute_with_cusparse_base<DerivedPolicy>& exec,
+              const MatrixType& A,
+              const VectorType1& x,
+              VectorType2& y,
+              UnaryFunction   initialize,
+              BinaryFunction1 combine,
+              BinaryFunction2 reduce,
+              cusp::csr_format,
+              cusp::array2d_format,
+              cusp::array2d_format)
+{
+    typedef is_standard_spmv<MatrixType,VectorType1,VectorType2,BinaryFunction1,BinaryFunction2> Standard;
+
+    csr_plan<typename MatrixType::index_type, typename VectorType2::value_type> plan;
+
+    __spmm_cusparse(exec, plan, bound_handle(exec), handle_stream(exec),
+                    A, x, y, initialize, combine, reduce, typename Standard::type());
+}
+
+// cusparse_csr_matrix with the cusparse policy, the handle of the policy
+// and the descriptors and workspace of the matrix
+template <typename DerivedPolicy,
+          typename ValueType,
+          typename IndexType,
+          typename VectorType1,
+          typename VectorType2,
+          typename UnaryFunction,
+          typename BinaryFunction1,
+          typename BinaryFunction2>
+void multiply(execute_with_cusparse_base<DerivedPolicy>& exec,
+              const cusparse_csr_matrix<ValueType,IndexType>& A,
+              const VectorType1& x,
+              VectorType2& y,
+              UnaryFunction   initialize,
+              BinaryFunction1 combine,
+              BinaryFunction2 reduce,
+              cusp::csr_format,
+              cusp::array1d_format,
+              cusp::array1d_format)
+{
+    typedef cusparse_csr_matrix<ValueType,IndexType> MatrixType;
+    typedef is_standard_spmv<MatrixType,VectorType1,VectorType2,BinaryFunction1,BinaryFunction2> Standard;
+
+    __spmv_cusparse(exec, A.plan(), bound_handle(exec), handle_stream(exec),
+                    A, x, y, initialize, combine, reduce, typename Standard::type());
+}
+
+template <typename DerivedPolicy,
+          typename ValueType,
+          typename IndexType,
+          typename VectorType1,
+          typename VectorType2,
+          typename UnaryFunction,
+          typename BinaryFunction1,
+          typename BinaryFunction2>
+void multiply(execute_with_cusparse_base<DerivedPolicy>& exec,
+              const cusparse_csr_matrix<ValueType,IndexType>& A,
+              const VectorType1& x,
+              VectorType2& y,
+              UnaryFunction   initialize,
+              BinaryFunction1 combine,
+              BinaryFunction2 reduce,
+              cusp::csr_format,
+              cusp::array2d_format,
+              cusp::array2d_format)
+{
+    typedef cusparse_csr_matrix<ValueType,IndexType> MatrixType;
+    typedef is_standard_spmv<MatrixType,VectorType1,VectorType2,BinaryFunction1,BinaryFunction2> Standard;
+
+    __spmm_cusparse(exec, A.plan(), bound_handle(exec), handle_stream(exec),
+                    A, x, y, initialize, combine, reduce, typename Standard::type());
+}
+
+// cusparse_csr_matrix with any other CUDA policy, the handle cached by the
+// matrix for the stream of the policy
+template <typename DerivedPolicy,
+          typename ValueType,
+          typename IndexType,
+          typename VectorType1,
+          typename VectorType2,
+          typename UnaryFunction,
+          typename BinaryFunction1,
+          typename BinaryFunction2>
+void multiply(cuda::execution_policy<DerivedPolicy>& exec,
+              const cusparse_csr_matrix<ValueType,IndexType>& A,
+              const VectorType1& x,
+              VectorType2& y,
+              UnaryFunction   initialize,
+              BinaryFunction1 combine,
+              BinaryFunction2 reduce,
+              cusp::csr_format,
+              cusp::array1d_format,
+              cusp::array1d_format)
+{
+    typedef cusparse_csr_matrix<ValueType,IndexType> MatrixType;
+    typedef is_standard_spmv<MatrixType,VectorType1,VectorType2,BinaryFunction1,BinaryFunction2> Standard;
+
+    const cudaStream_t s = stream(thrust::detail::derived_cast(exec));
+
+    __spmv_cusparse(exec, A.plan(), A.plan().handle(s), s,
+                    A, x, y, initialize, combine, reduce, typename Standard::type());
+}
+
+template <typename DerivedPolicy,
+          typename ValueType,
+          typename IndexType,
+          typename VectorType1,
+          typename VectorType2,
+          typename UnaryFunction,
+          typename BinaryFunction1,
+          typename BinaryFunction2>
+void multiply(cuda::execution_policy<DerivedPolicy>& exec,
+              const cusparse_csr_matrix<ValueType,IndexType>& A,
+              const VectorType1& x,
+              VectorType2& y,
+              UnaryFunction   initialize,
+              BinaryFunction1 combine,
+              BinaryFunction2 reduce,
+              cusp::csr_format,
+              cusp::array2d_format,
+              cusp::array2d_format)
+{
+    typedef cusparse_csr_matrix<ValueType,IndexType> MatrixType;
+    typedef is_standard_spmv<MatrixType,VectorType1,VectorType2,BinaryFunction1,BinaryFunction2> Standard;
+
+    const cudaStream_t s = stream(thrust::detail::derived_cast(exec));
+
+    __spmm_cusparse(exec, A.plan(), A.plan().handle(s), s,
+                    A, x, y, initialize, combine, reduce, typename Standard::type());
+}
+
+////////////////////////////////////////
+// SpGEMM with the cusparse policy    //
+////////////////////////////////////////
+
+// the plan holding the descriptor of an operand
+template <typename MatrixType, typename Plan>
+Plan& operand_plan(const MatrixType& A, Plan& local)
+{
+    return local;
+}
+
+template <typename ValueType, typename IndexType, typename Plan>
+Plan& operand_plan(const cusparse_csr_matrix<ValueType,IndexType>& A, Plan& local)
+{
+    return A.plan();
+}
+
+#if CUSP_CUSPARSE_GENERIC_API
+
+// releases the descriptors of one SpGEMM when it leaves scope
+struct spgemm_descriptors
+{
+    cusparseSpGEMMDescr_t spgemm;
+    cusparseSpMatDescr_t  C;
+
+    spgemm_descriptors(void) : spgemm(0), C(0) {}
+
+    ~spgemm_descriptors(void)
+    {
+        if (spgemm) cusparseSpGEMM_destroyDescr(spgemm);
+        if (C)      cusparseDestroySpMat(C);
+    }
+};
+
+#endif
+
+template <typename DerivedPolicy,
+          typename MatrixType1,
+          typename MatrixType2,
+          typename MatrixType3,
+          typename UnaryFunction,
+          typename BinaryFunction1,
+          typename BinaryFunction2>
+void __spgemm_cusparse(execute_with_cusparse_base<DerivedPolicy>& exec,
+                       const MatrixType1& A,
+                       const MatrixType2& B,
+                       MatrixType3& C,
+                       UnaryFunction   initialize,
+                       BinaryFunction1 combine,
+                       BinaryFunction2 reduce,
+                       thrust::detail::false_type)
+{
+    cuda::execution_policy<DerivedPolicy>& cuda_exec = exec;
+
+    cusp::system::cuda::detail::multiply(cuda_exec, A, B, C, initialize, combine, reduce,
+                                         cusp::csr_format(), cusp::csr_format(), cusp::csr_format());
+}
+
+template <typename DerivedPolicy,
+          typename MatrixType1,
+          typename MatrixType2,
+          typename MatrixType3,
+          typename UnaryFunction,
+          typename BinaryFunction1,
+          typename BinaryFunction2>
+void __spgemm_cusparse(execute_with_cusparse_base<DerivedPolicy>& exec,
+                       const MatrixType1& A,
+                       const MatrixType2& B,
+                       MatrixType3& C,
+                       UnaryFunction   initialize,
+                       BinaryFunction1 combine,
+                       BinaryFunction2 reduce,
+                       thrust::detail::true_type)
+{
+#if CUSP_CUSPARSE_GENERIC_API
+    typedef typename MatrixType3::index_type IndexType;
+    typedef typename MatrixType3::value_type ValueType;
+
+    // empty operands are handled by the cusp kernels
+    if (A.num_entries == 0 || B.num_entries == 0)
+    {
+        __spgemm_cusparse(exec, A, B, C, initialize, combine, reduce, thrust::detail::false_type());
+        return;
+    }
+
+    const cudaDataType        type       = value_type_traits<ValueType>::type;
+    const cusparseIndexType_t index_type = index_type_traits<IndexType>::type;
+    const cusparseOperation_t op         = CUSPARSE_OPERATION_NON_TRANSPOSE;
+
+    cusparseHandle_t h = bound_handle(exec);
+
+    csr_plan<IndexType,ValueType> A_local, B_local;
+    cusparseSpMatDescr_t descr_A = operand_plan(A, A_local).descriptor(A);
+    cusparseSpMatDescr_t descr_B = operand_plan(B, B_local).descriptor(B);
+
+    const ValueType alpha(1);
+    const ValueType beta(0);
+
+    spgemm_descriptors descr;
+
+    check_status("cusparseSpGEMM_createDescr", cusparseSpGEMM_createDescr(&descr.spgemm));
+    check_status("cusparseCreateCsr",
+        cusparseCreateCsr(&descr.C, A.num_rows, B.num_cols, 0, 0, 0, 0,
+                          index_type, index_type, CUSPARSE_INDEX_BASE_ZERO, type));
+
+    // the first call of each phase returns the size of its buffer
+    size_t estimation_bytes = 0;
+    check_status("cusparseSpGEMM_workEstimation",
+        cusparseSpGEMM_workEstimation(h, op, op, &alpha, descr_A, descr_B, &beta, descr.C, type,
+                                      CUSPARSE_SPGEMM_DEFAULT, descr.spgemm, &estimation_bytes, 0));
+
+    cusp::detail::temporary_array<char, DerivedPolicy> estimation(exec, estimation_bytes);
+    check_status("cusparseSpGEMM_workEstimation",
+        cusparseSpGEMM_workEstimation(h, op, op, &alpha, descr_A, descr_B, &beta, descr.C, type,
+                                      CUSPARSE_SPGEMM_DEFAULT, descr.spgemm, &estimation_bytes,
+                                      thrust::raw_pointer_cast(estimation.data())));
+
+    size_t compute_bytes = 0;
+    check_status("cusparseSpGEMM_compute",
+        cusparseSpGEMM_compute(h, op, op, &alpha, descr_A, descr_B, &beta, descr.C, type,
+                               CUSPARSE_SPGEMM_DEFAULT, descr.spgemm, &compute_bytes, 0));
+
+    cusp::detail::temporary_array<char, DerivedPolicy> compute(exec, compute_bytes);
+    check_status("cusparseSpGEMM_compute",
+        cusparseSpGEMM_compute(h, op, op, &alpha, descr_A, descr_B, &beta, descr.C, type,
+                               CUSPARSE_SPGEMM_DEFAULT, descr.spgemm, &compute_bytes,
+                               thrust::raw_pointer_cast(compute.data())));
+
+    int64_t C_num_rows, C_num_cols, C_num_entries;
+    check_status("cusparseSpMatGetSize", cusparseSpMatGetSize(descr.C, &C_num_rows, &C_num_cols, &C_num_entries));
+
+    C.resize(A.num_rows, B.num_cols, C_num_entries);
+
+    check_status("cusparseCsrSetPointers",
+        cusparseCsrSetPointers(descr.C,
+                               thrust::raw_pointer_cast(&C.row_offsets[0]),
+                               C_num_entries ? thrust::raw_pointer_cast(&C.column_indices[0]) : 0,
+                               C_num_entries ? thrust::raw_pointer_cast(&C.values[0]) : 0));
+
+    check_status("cusparseSpGEMM_copy",
+        cusparseSpGEMM_copy(h, op, op, &alpha, descr_A, descr_B, &beta, descr.C, type,
+                            CUSPARSE_SPGEMM_DEFAULT, descr.spgemm));
+#else
+    __spgemm_cusparse(exec, A, B, C, initialize, combine, reduce, thrust::detail::false_type());
+#endif
+}
+
+// C = A * B, entries which cancel out are kept in the pattern of C
+template <typename DerivedPolicy,
+          typename MatrixType1,
+          typename MatrixType2,
+          typename MatrixType3,
+          typename UnaryFunction,
+          typename BinaryFunction1,
+          typename BinaryFunction2>
+void multiply(execute_with_cusparse_base<DerivedPolicy>& exec,
+              const MatrixType1& A,
+              const MatrixType2& B,
+              MatrixType3& C,
+              UnaryFunction   initialize,
+              BinaryFunction1 combine,
+              BinaryFunction2 reduce,
+              cusp::csr_format,
+              cusp::csr_format,
+              cusp::csr_format)
+{
+    typedef typename MatrixType3::index_type IndexType;
+    typedef typename MatrixType3::value_type ValueType;
+
+    typedef thrust::detail::integral_constant<bool,
+        is_standard_product<IndexType,
+                            typename MatrixType1::value_type,
+                            typename MatrixType2::value_type,
+                            ValueType,
+                            BinaryFunction1, BinaryFunction2>::value &&
+        thrust::detail::is_same<typename MatrixType1::index_type,IndexType>::value &&
+        thrust::detail::is_same<typename MatrixType2::index_type,IndexType>::value> Standard;
+
+    __spgemm_cusparse(exec, A, B, C, initialize, combine, reduce, typename Standard::type());
+}
+
+} // end namespace cusparse
+} // end namespace detail
+} // end namespace cuda
+} // end namespace system
+} // end namespace cusp
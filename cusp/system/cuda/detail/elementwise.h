@@ -18,4 +18,233 @@
 
 #include <cusp/detail/config.h>
 
-// this system has no special version of this algorithm
+#include <cusp/detail/format.h>
+#include <cusp/detail/temporary_array.h>
+
+#include <cusp/exception.h>
+
+#include <cusp/system/cuda/arch.h>
+#include <cusp/system/cuda/utils.h>
+#include <cusp/system/detail/generic/elementwise.h>
+
+#include <thrust/copy.h>
+#include <thrust/extrema.h>
+#include <thrust/scan.h>
+
+#include <algorithm>
+
+namespace cusp
+{
+namespace system
+{
+namespace cuda
+{
+namespace detail
+{
+
+//////////////////////////////////////////////////////////////////////////////
+// Merge-based CSR elementwise operations
+//////////////////////////////////////////////////////////////////////////////
+//
+// Each thread merges row i of A with row i of B.  A first pass counts the
+// union of the column indices of every row and a second pass writes the
+// merged row, so the sorted rows of C are produced without the sort of
+// the COO implementation.  The first pass also detects rows with unsorted
+// or duplicate column indices, in which case the COO implementation is
+// used instead.
+
+template <typename IndexType, unsigned int BLOCK_SIZE>
+__launch_bounds__(BLOCK_SIZE,1)
+__global__ void
+csr_elementwise_count_kernel(const IndexType num_rows,
+                             const IndexType * Ap,
+                             const IndexType * Aj,
+                             const IndexType * Bp,
+                             const IndexType * Bj,
+                             IndexType * Cp,
+                             int * unsorted)
+{
+    const IndexType thread_id = BLOCK_SIZE * blockIdx.x + threadIdx.x;
+    const IndexType grid_size = BLOCK_SIZE * gridDim.x;
+
+    for (IndexType row = thread_id; row < num_rows; row += grid_size)
+    {
+        const IndexType A_end = Ap[row + 1];
+        const IndexType B_end = Bp[row + 1];
+
+        IndexType A_pos = Ap[row];
+        IndexType B_pos = Bp[row];
+        IndexType count = 0;
+
+        bool sorted = true;
+
+        for (IndexType jj = A_pos + 1; jj < A_end; jj++)
+            sorted = sorted && Aj[jj - 1] < Aj[jj];
+
+        for (IndexType jj = B_pos + 1; jj < B_end; jj++)
+            sorted = sorted && Bj[jj - 1] < Bj[jj];
+
+        if (!sorted)
+            *unsorted = 1;
+
+        while (A_pos < A_end && B_pos < B_end)
+        {
+            const IndexType A_j = Aj[A_pos];
+            const IndexType B_j = Bj[B_pos];
+
+            if (A_j <= B_j) A_pos++;
+            if (B_j <= A_j) B_pos++;
+
+            count++;
+        }
+
+        Cp[row] = count + (A_end - A_pos) + (B_end - B_pos);
+    }
+}
+
+template <typename IndexType, typename ValueType1, typename ValueType2, typename ValueType3,
+          typename BinaryFunction, unsigned int BLOCK_SIZE>
+__launch_bounds__(BLOCK_SIZE,1)
+__global__ void
+csr_elementwise_merge_kernel(const IndexType num_rows,
+                             const IndexType num_cols,
+                             const IndexType * Ap,
+                             const IndexType * Aj,
+                             const ValueType1 * Ax,
+                             const IndexType * Bp,
+                             const IndexType * Bj,
+                             const ValueType2 * Bx,
+                             const IndexType * Cp,
+                             IndexType * Cj,
+                             ValueType3 * Cx,
+                             BinaryFunction op)
+{
+    const IndexType thread_id = BLOCK_SIZE * blockIdx.x + threadIdx.x;
+    const IndexType grid_size = BLOCK_SIZE * gridDim.x;
+
+    for (IndexType row = thread_id; row < num_rows; row += grid_size)
+    {
+        const IndexType A_end = Ap[row + 1];
+        const IndexType B_end = Bp[row + 1];
+
+        IndexType A_pos = Ap[row];
+        IndexType B_pos = Bp[row];
+        IndexType C_pos = Cp[row];
+
+        while (A_pos < A_end || B_pos < B_end)
+        {
+            const IndexType A_j = A_pos < A_end ? Aj[A_pos] : num_cols;
+            const IndexType B_j = B_pos < B_end ? Bj[B_pos] : num_cols;
+
+            ValueType1 a = ValueType1(0);
+            ValueType2 b = ValueType2(0);
+
+            if (A_j <= B_j) a = Ax[A_pos];
+            if (B_j <= A_j) b = Bx[B_pos];
+
+            Cj[C_pos] = thrust::min(A_j, B_j);
+            Cx[C_pos] = op(a, b);
+
+            if (A_j <= B_j) A_pos++;
+            if (B_j <= A_j) B_pos++;
+
+            C_pos++;
+        }
+    }
+}
+
+template <typename DerivedPolicy,
+          typename MatrixType1,
+          typename MatrixType2,
+          typename MatrixType3,
+          typename BinaryFunction>
+void elementwise(cuda::execution_policy<DerivedPolicy>& exec,
+                 const MatrixType1& A,
+                 const MatrixType2& B,
+                 MatrixType3& C,
+                 BinaryFunction op,
+                 cusp::csr_format,
+                 cusp::csr_format,
+                 cusp::csr_format)
+{
+    typedef typename MatrixType3::index_type IndexType;
+    typedef typename MatrixType3::value_type ValueType;
+    typedef typename MatrixType1::value_type ValueType1;
+    typedef typename MatrixType2::value_type ValueType2;
+
+    const size_t BLOCK_SIZE = 256;
+
+    if(A.num_rows != B.num_rows || A.num_cols != B.num_cols)
+        throw cusp::invalid_input_exception("matrix dimensions do not match");
+
+    const size_t num_rows = A.num_rows;
+
+    cusp::detail::temporary_array<IndexType, DerivedPolicy> C_row_offsets(exec, num_rows + 1, IndexType(0));
+    cusp::detail::temporary_array<int, DerivedPolicy> unsorted(exec, 1, 0);
+
+    cudaStream_t s = stream(thrust::detail::derived_cast(exec));
+
+    if (num_rows > 0)
+    {
+        const size_t NUM_BLOCKS = cusp::system::cuda::detail::launch_blocks(
+                                      csr_elementwise_count_kernel<IndexType, BLOCK_SIZE>, BLOCK_SIZE, (size_t) 0,
+                                      num_rows, BLOCK_SIZE);
+
+        csr_elementwise_count_kernel<IndexType, BLOCK_SIZE> <<<NUM_BLOCKS, BLOCK_SIZE, 0, s>>>
+            (IndexType(num_rows),
+             thrust::raw_pointer_cast(&A.row_offsets[0]),
+             thrust::raw_pointer_cast(&A.column_indices[0]),
+             thrust::raw_pointer_cast(&B.row_offsets[0]),
+             thrust::raw_pointer_cast(&B.column_indices[0]),
+             thrust::raw_pointer_cast(&C_row_offsets[0]),
+             thrust::raw_pointer_cast(&unsorted[0]));
+    }
+
+    if (unsorted[0])
+    {
+        // the COO implementation handles duplicate and unsorted indices
+        cusp::system::detail::generic::elementwise(exec, A, B, C, op,
+                cusp::sparse_format(), cusp::sparse_format(), cusp::sparse_format());
+        return;
+    }
+
+    thrust::exclusive_scan(exec, C_row_offsets.begin(), C_row_offsets.end(), C_row_offsets.begin(), IndexType(0));
+
+    const size_t num_entries = C_row_offsets[num_rows];
+
+    // C may alias A or B
+    cusp::detail::temporary_array<IndexType, DerivedPolicy> C_column_indices(exec, num_entries);
+    cusp::detail::temporary_array<ValueType, DerivedPolicy> C_values(exec, num_entries);
+
+    if (num_entries > 0)
+    {
+        const size_t NUM_BLOCKS = cusp::system::cuda::detail::launch_blocks(
+                                      csr_elementwise_merge_kernel<IndexType, ValueType1, ValueType2, ValueType, BinaryFunction, BLOCK_SIZE>,
+                                      BLOCK_SIZE, (size_t) 0,
+                                      num_rows, BLOCK_SIZE);
+
+        csr_elementwise_merge_kernel<IndexType, ValueType1, ValueType2, ValueType, BinaryFunction, BLOCK_SIZE> <<<NUM_BLOCKS, BLOCK_SIZE, 0, s>>>
+            (IndexType(num_rows), IndexType(A.num_cols),
+             thrust::raw_pointer_cast(&A.row_offsets[0]),
+             thrust::raw_pointer_cast(&A.column_indices[0]),
+             thrust::raw_pointer_cast(&A.values[0]),
+             thrust::raw_pointer_cast(&B.row_offsets[0]),
+             thrust::raw_pointer_cast(&B.column_indices[0]),
+             thrust::raw_pointer_cast(&B.values[0]),
+             thrust::raw_pointer_cast(&C_row_offsets[0]),
+             thrust::raw_pointer_cast(&C_column_indices[0]),
+             thrust::raw_pointer_cast(&C_values[0]),
+             op);
+    }
+
+    C.resize(A.num_rows, A.num_cols, num_entries);
+
+    thrust::copy(exec, C_row_offsets.begin(),    C_row_offsets.end(),    C.row_offsets.begin());
+    thrust::copy(exec, C_column_indices.begin(), C_column_indices.end(), C.column_indices.begin());
+    thrust::copy(exec, C_values.begin(),         C_values.end(),         C.values.begin());
+}
+
+} // end namespace detail
+} // end namespace cuda
+} // end namespace system
+} // end namespace cusp
@@ -23,6 +23,7 @@
 
 #include <cusp/system/cuda/detail/execution_policy.h>
 #include <cusp/system/cuda/detail/graph/b40c.h>
+#include <cusp/system/detail/generic/graph/direction_optimizing_bfs.h>
 
 #include <thrust/fill.h>
 
@@ -100,13 +101,7 @@ void breadth_first_search(cuda::execution_policy<DerivedPolicy>& exec,
                           const bool mark_levels,
                           cusp::csr_format)
 {
-    if(G.num_rows != G.num_cols)
-        throw cusp::invalid_input_exception("matrix must be square");
-
-    if(mark_levels)
-        breadth_first_search<false>(exec, G, src, labels);
-    else
-        breadth_first_search<true>(exec, G, src, labels);
+    cusp::system::detail::generic::direction_optimizing_bfs(exec, G, src, labels, mark_levels);
 }
 
 } // end namespace detail
@@ -23,6 +23,7 @@
 
 #include <thrust/extrema.h>
 #include <thrust/gather.h>
+#include <thrust/scatter.h>
 #include <thrust/sort.h>
 #include <thrust/transform.h>
 
@@ -129,6 +130,23 @@ __constant__ static const unsigned int *s3d[] =
     istate3d +160, istate3d +168, istate3d +176, istate3d +184
 };
 
+// position i on the curve belongs to part i * num_parts / num_points
+template <typename PartType>
+struct hilbert_part : public thrust::unary_function<size_t,PartType>
+{
+    const size_t num_points;
+    const size_t num_parts;
+
+    hilbert_part(const size_t num_points, const size_t num_parts)
+        : num_points(num_points), num_parts(num_parts) {}
+
+    __host__ __device__
+    PartType operator()(const size_t i) const
+    {
+        return PartType(i * num_parts / num_points);
+    }
+};
+
 struct hilbert_transform_2d : public thrust::unary_function<double,double>
 {
     template<typename Tuple>
@@ -260,9 +278,9 @@ void hilbert_curve(cuda::execution_policy<DerivedPolicy>& exec,
 
     cusp::detail::temporary_array<PartType, DerivedPolicy> uniform_parts(exec, num_points);
     thrust::transform(exec,
-                      thrust::counting_iterator<PartType>(0), thrust::counting_iterator<PartType>(num_points),
-                      thrust::constant_iterator<PartType>(num_points/num_parts), uniform_parts.begin(), thrust::divides<PartType>());
-    thrust::gather(exec, perm.begin(), perm.end(), uniform_parts.begin(), parts.begin());
+                      thrust::counting_iterator<size_t>(0), thrust::counting_iterator<size_t>(num_points),
+                      uniform_parts.begin(), hilbert_part<PartType>(num_points, num_parts));
+    thrust::scatter(exec, uniform_parts.begin(), uniform_parts.end(), perm.begin(), parts.begin());
 }
 
 } // end namespace detail
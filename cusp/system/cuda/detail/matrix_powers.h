@@ -0,0 +1,209 @@
+/*
+ *  Copyright 2008-2014 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+
+#pragma once
+
+#include <cusp/detail/config.h>
+#include <cusp/detail/format.h>
+
+#include <cusp/array1d.h>
+#include <cusp/functional.h>
+
+#include <cusp/system/detail/generic/matrix_powers.h>
+
+#include <cusp/system/cuda/arch.h>
+#include <cusp/system/cuda/utils.h>
+#include <cusp/system/cuda/detail/execution_policy.h>
+
+#include <thrust/copy.h>
+#include <thrust/functional.h>
+#include <thrust/transform_reduce.h>
+#include <thrust/detail/type_traits.h>
+
+namespace cusp
+{
+namespace system
+{
+namespace cuda
+{
+namespace detail
+{
+
+//////////////////////////////////////////////////////////////////////////////
+// DIA matrix powers kernel
+//////////////////////////////////////////////////////////////////////////////
+//
+// Each block computes BLOCK_SIZE consecutive rows of every power. With all
+// diagonals within halo of the main diagonal, rows [base, base + BLOCK_SIZE)
+// of A^s x only depend on rows [base - s*halo, base + BLOCK_SIZE + s*halo)
+// of x. The block stages this window in shared memory and computes the
+// powers in place, the part of the window that is still exact shrinks by
+// halo rows on each side with every product. Requires s*halo <= BLOCK_SIZE.
+
+#if defined(__CUDACC__)
+template <typename IndexType, typename ValueType, unsigned int BLOCK_SIZE>
+__launch_bounds__(BLOCK_SIZE,1)
+__global__ void
+matrix_powers_dia_kernel(const IndexType num_rows,
+                         const IndexType num_diagonals,
+                         const IndexType pitch,
+                         const IndexType * diagonal_offsets,
+                         const ValueType * values,
+                         const ValueType * shifts,
+                         const IndexType s,
+                         const IndexType halo,
+                         ValueType * V,
+                         const IndexType ldv)
+{
+    // requires num_diagonals <= BLOCK_SIZE
+    __shared__ IndexType offsets[BLOCK_SIZE];
+    __shared__ ValueType window[2][3 * BLOCK_SIZE];
+
+    if(threadIdx.x < num_diagonals)
+        offsets[threadIdx.x] = diagonal_offsets[threadIdx.x];
+
+    const IndexType width = BLOCK_SIZE + 2 * s * halo;
+
+    for(IndexType base = BLOCK_SIZE * blockIdx.x; base < num_rows; base += BLOCK_SIZE * gridDim.x)
+    {
+        const IndexType start = base - s * halo;
+
+        for(IndexType i = threadIdx.x; i < width; i += BLOCK_SIZE)
+        {
+            const IndexType row = start + i;
+
+            window[0][i] = (row >= 0 && row < num_rows) ? V[row] : ValueType(0);
+        }
+
+        __syncthreads();
+
+        for(IndexType k = 0; k < s; k++)
+        {
+            const ValueType * in  = window[k % 2];
+                  ValueType * out = window[(k + 1) % 2];
+
+            const ValueType shift = shifts[k];
+
+            for(IndexType i = (k + 1) * halo + threadIdx.x; i < width - (k + 1) * halo; i += BLOCK_SIZE)
+            {
+                const IndexType row = start + i;
+
+                ValueType sum(0);
+
+                if(row >= 0 && row < num_rows)
+                {
+                    sum = -shift * in[i];
+
+                    // index into values array
+                    IndexType idx = row;
+
+                    for(IndexType n = 0; n < num_diagonals; n++)
+                    {
+                        const IndexType col = row + offsets[n];
+
+                        if(col >= 0 && col < num_rows)
+                            sum += values[idx] * in[i + offsets[n]];
+
+                        idx += pitch;
+                    }
+                }
+
+                out[i] = sum;
+            }
+
+            __syncthreads();
+
+            // the next product overwrites the other half of the window,
+            // which is no longer read by any thread
+            const IndexType row = base + threadIdx.x;
+
+            if(row < num_rows)
+                V[(k + 1) * ldv + row] = out[s * halo + threadIdx.x];
+        }
+
+        // wait until all threads are done reading the window
+        __syncthreads();
+    }
+}
+#endif
+
+template <typename DerivedPolicy,
+          typename MatrixType,
+          typename ArrayType,
+          typename Array2dType,
+          typename ShiftArray>
+void matrix_powers(cuda::execution_policy<DerivedPolicy>& exec,
+                   const MatrixType& A,
+                   const ArrayType& x,
+                         Array2dType& V,
+                   const ShiftArray& shifts,
+                   cusp::dia_format format)
+{
+    typedef typename MatrixType::index_type   IndexType;
+    typedef typename Array2dType::value_type  ValueType;
+    typedef typename Array2dType::orientation Orientation;
+
+    const unsigned int BLOCK_SIZE = 256;
+
+    const IndexType num_rows      = A.num_rows;
+    const IndexType num_diagonals = A.values.num_cols;
+    const IndexType s             = shifts.size();
+
+    const bool column_major =
+        thrust::detail::is_same<Orientation, cusp::column_major>::value;
+    const bool same_type =
+        thrust::detail::is_same<typename MatrixType::value_type, ValueType>::value;
+
+    IndexType halo = 0;
+
+    if(num_diagonals > 0)
+        halo = thrust::transform_reduce(exec, A.diagonal_offsets.begin(), A.diagonal_offsets.end(),
+                                        cusp::abs_functor<IndexType>(), IndexType(0), thrust::maximum<IndexType>());
+
+    // wide bands and general bases take one product per power
+    if(!column_major || !same_type || s == 0 || num_rows == 0 || num_diagonals == 0 ||
+       num_diagonals > IndexType(BLOCK_SIZE) || s * halo > IndexType(BLOCK_SIZE))
+    {
+        cusp::system::detail::generic::matrix_powers(exec, A, x, V, shifts, format);
+        return;
+    }
+
+    thrust::copy(exec, x.begin(), x.end(), V.values.begin());
+
+    cusp::array1d<ValueType,cusp::host_memory>   shifts_host(shifts.begin(), shifts.end());
+    cusp::array1d<ValueType,cusp::device_memory> shifts_device(shifts_host);
+
+    const size_t NUM_BLOCKS = cusp::system::cuda::detail::launch_blocks(
+                               matrix_powers_dia_kernel<IndexType, ValueType, BLOCK_SIZE>,
+                               BLOCK_SIZE, (size_t) sizeof(IndexType) * BLOCK_SIZE + 6 * sizeof(ValueType) * BLOCK_SIZE,
+                               num_rows, BLOCK_SIZE);
+
+    cudaStream_t stream_id = stream(thrust::detail::derived_cast(exec));
+
+    matrix_powers_dia_kernel<IndexType, ValueType, BLOCK_SIZE> <<<NUM_BLOCKS, BLOCK_SIZE, 0, stream_id>>>
+    (num_rows, num_diagonals, IndexType(A.values.pitch),
+     thrust::raw_pointer_cast(&A.diagonal_offsets[0]),
+     thrust::raw_pointer_cast(&A.values.values[0]),
+     thrust::raw_pointer_cast(&shifts_device[0]),
+     s, halo,
+     thrust::raw_pointer_cast(&V.values[0]), IndexType(V.pitch));
+}
+
+} // end namespace detail
+} // end namespace cuda
+} // end namespace system
+} // end namespace cusp
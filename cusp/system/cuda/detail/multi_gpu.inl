@@ -0,0 +1,747 @@
+/*
+ *  Copyright 2008-2014 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include <cusp/array1d.h>
+#include <cusp/blas/blas.h>
+#include <cusp/csr_matrix.h>
+#include <cusp/exception.h>
+#include <cusp/multiply.h>
+
+#include <thrust/copy.h>
+#include <thrust/functional.h>
+#include <thrust/gather.h>
+
+#include <algorithm>
+#include <cmath>
+#include <string>
+#include <vector>
+
+namespace cusp
+{
+namespace system
+{
+namespace cuda
+{
+namespace multi_gpu
+{
+namespace detail
+{
+
+inline void check_error(const cudaError_t error, const char* operation)
+{
+    if (error != cudaSuccess)
+        throw cusp::runtime_exception(std::string("multi_gpu: ") + operation +
+                                      " failed: " + cudaGetErrorString(error));
+}
+
+inline device_guard::device_guard(const int device)
+{
+    check_error(cudaGetDevice(&previous), "cudaGetDevice");
+    check_error(cudaSetDevice(device), "cudaSetDevice");
+}
+
+inline device_guard::~device_guard(void)
+{
+    cudaSetDevice(previous);
+}
+
+template <typename ValueType>
+ValueType* raw_pointer(cusp::array1d<ValueType,cusp::device_memory>& a, const size_t offset)
+{
+    return thrust::raw_pointer_cast(&a[0]) + offset;
+}
+
+template <typename ValueType>
+const ValueType* raw_pointer(const cusp::array1d<ValueType,cusp::device_memory>& a, const size_t offset)
+{
+    return thrust::raw_pointer_cast(&a[0]) + offset;
+}
+
+} // end namespace detail
+
+//////////////////////////////////////////////////////////////////////////////
+// array1d
+//////////////////////////////////////////////////////////////////////////////
+
+template <typename ValueType>
+template <typename IndexType>
+array1d<ValueType>
+::array1d(const csr_matrix<IndexType,ValueType>& A, const ValueType value)
+    : m_layout(&A.layout())
+{
+    // every part is allocated while its device is current
+    for (size_t p = 0; p < m_layout->num_parts(); p++)
+    {
+        detail::device_guard guard(m_layout->devices[p]);
+
+        parts.push_back(new part_type(m_layout->part_size(p), value));
+        scalars.push_back(new part_type(1));
+    }
+}
+
+template <typename ValueType>
+array1d<ValueType>
+::~array1d(void)
+{
+    for (size_t p = 0; p < parts.size(); p++)
+    {
+        detail::device_guard guard(m_layout->devices[p]);
+
+        cudaStreamSynchronize(m_layout->streams[p]);
+
+        delete parts[p];
+        delete scalars[p];
+    }
+}
+
+template <typename ValueType>
+size_t
+array1d<ValueType>
+::size(void) const
+{
+    return m_layout->row_starts.back();
+}
+
+template <typename ValueType>
+size_t
+array1d<ValueType>
+::num_parts(void) const
+{
+    return m_layout->num_parts();
+}
+
+template <typename ValueType>
+int
+array1d<ValueType>
+::device(const size_t p) const
+{
+    return m_layout->devices[p];
+}
+
+template <typename ValueType>
+cudaStream_t
+array1d<ValueType>
+::stream(const size_t p) const
+{
+    return m_layout->streams[p];
+}
+
+template <typename ValueType>
+typename array1d<ValueType>::part_type&
+array1d<ValueType>
+::part(const size_t p)
+{
+    return *parts[p];
+}
+
+template <typename ValueType>
+const typename array1d<ValueType>::part_type&
+array1d<ValueType>
+::part(const size_t p) const
+{
+    return *parts[p];
+}
+
+template <typename ValueType>
+template <typename ArrayType>
+void
+array1d<ValueType>
+::scatter(const ArrayType& x)
+{
+    if (x.size() != size())
+        throw cusp::invalid_input_exception("multi_gpu::array1d::scatter: vector size does not match the matrix");
+
+    cusp::array1d<ValueType,cusp::host_memory> h(x);
+    cusp::array1d<ValueType,cusp::host_memory> local;
+
+    for (size_t p = 0; p < parts.size(); p++)
+    {
+        local.resize(m_layout->part_size(p));
+
+        for (size_t i = 0; i < local.size(); i++)
+            local[i] = h[m_layout->permutation[m_layout->row_starts[p] + i]];
+
+        detail::device_guard guard(m_layout->devices[p]);
+
+        // the previous work on the part must not read the new values
+        detail::check_error(cudaStreamSynchronize(m_layout->streams[p]), "cudaStreamSynchronize");
+
+        thrust::copy(local.begin(), local.end(), parts[p]->begin());
+    }
+}
+
+template <typename ValueType>
+template <typename ArrayType>
+void
+array1d<ValueType>
+::gather(ArrayType& x) const
+{
+    cusp::array1d<ValueType,cusp::host_memory> h(size());
+    cusp::array1d<ValueType,cusp::host_memory> local;
+
+    for (size_t p = 0; p < parts.size(); p++)
+    {
+        {
+            detail::device_guard guard(m_layout->devices[p]);
+
+            detail::check_error(cudaStreamSynchronize(m_layout->streams[p]), "cudaStreamSynchronize");
+
+            local = *parts[p];
+        }
+
+        for (size_t i = 0; i < local.size(); i++)
+            h[m_layout->permutation[m_layout->row_starts[p] + i]] = local[i];
+    }
+
+    x = h;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// csr_matrix
+//////////////////////////////////////////////////////////////////////////////
+
+template <typename IndexType, typename ValueType>
+template <typename MatrixType>
+csr_matrix<IndexType,ValueType>
+::csr_matrix(const MatrixType& A, const std::vector<int>& devices)
+{
+    const size_t num_parts = std::max(devices.size(), size_t(1));
+
+    std::vector<int> row_parts(A.num_rows);
+
+    for (size_t p = 0; p < num_parts; p++)
+        for (size_t i = (A.num_rows * p) / num_parts; i < (A.num_rows * (p + 1)) / num_parts; i++)
+            row_parts[i] = p;
+
+    setup(A, row_parts, devices);
+}
+
+template <typename IndexType, typename ValueType>
+template <typename MatrixType, typename ArrayType>
+csr_matrix<IndexType,ValueType>
+::csr_matrix(const MatrixType& A, const ArrayType& parts, const std::vector<int>& devices)
+{
+    if (parts.size() != A.num_rows)
+        throw cusp::invalid_input_exception("multi_gpu::csr_matrix: parts must hold one entry per row");
+
+    cusp::array1d<int,cusp::host_memory> h(parts);
+
+    setup(A, std::vector<int>(h.begin(), h.end()), devices);
+}
+
+template <typename IndexType, typename ValueType>
+csr_matrix<IndexType,ValueType>
+::~csr_matrix(void)
+{
+    release();
+}
+
+template <typename IndexType, typename ValueType>
+void
+csr_matrix<IndexType,ValueType>
+::release(void)
+{
+    for (size_t p = 0; p < parts.size(); p++)
+    {
+        detail::device_guard guard(m_layout.devices[p]);
+
+        // a failed setup leaves the resources of the last part incomplete
+        if (p < m_layout.streams.size())
+        {
+            cudaStreamSynchronize(m_layout.streams[p]);
+            cudaStreamDestroy(m_layout.streams[p]);
+        }
+
+        if (parts[p]->transfer != 0)
+        {
+            cudaStreamSynchronize(parts[p]->transfer);
+            cudaStreamDestroy(parts[p]->transfer);
+        }
+
+        if (parts[p]->compute_done != 0) cudaEventDestroy(parts[p]->compute_done);
+        if (parts[p]->sent != 0)         cudaEventDestroy(parts[p]->sent);
+
+        delete parts[p];
+    }
+
+    parts.clear();
+    m_layout.streams.clear();
+}
+
+template <typename IndexType, typename ValueType>
+size_t
+csr_matrix<IndexType,ValueType>
+::num_parts(void) const
+{
+    return parts.size();
+}
+
+template <typename IndexType, typename ValueType>
+const typename csr_matrix<IndexType,ValueType>::local_matrix_type&
+csr_matrix<IndexType,ValueType>
+::diagonal_block(const size_t p) const
+{
+    return parts[p]->diagonal;
+}
+
+template <typename IndexType, typename ValueType>
+const typename csr_matrix<IndexType,ValueType>::local_matrix_type&
+csr_matrix<IndexType,ValueType>
+::off_diagonal_block(const size_t p) const
+{
+    return parts[p]->off_diagonal;
+}
+
+template <typename IndexType, typename ValueType>
+template <typename MatrixType>
+void
+csr_matrix<IndexType,ValueType>
+::setup(const MatrixType& A, const std::vector<int>& row_parts, const std::vector<int>& devices)
+{
+    cusp::csr_matrix<IndexType,ValueType,cusp::host_memory> H(A);
+
+    if (H.num_rows != H.num_cols)
+        throw cusp::invalid_input_exception("multi_gpu::csr_matrix: matrix must be square");
+
+    if (devices.empty())
+        throw cusp::invalid_input_exception("multi_gpu::csr_matrix: at least one device is required");
+
+    const size_t N         = H.num_rows;
+    const size_t num_parts = devices.size();
+
+    num_rows    = H.num_rows;
+    num_cols    = H.num_cols;
+    num_entries = H.num_entries;
+
+    for (size_t i = 0; i < N; i++)
+        if (row_parts[i] < 0 || size_t(row_parts[i]) >= num_parts)
+            throw cusp::invalid_input_exception("multi_gpu::csr_matrix: part index out of range");
+
+    // rows of every part in increasing order, owner and local index of each row
+    std::vector<size_t> counts(num_parts, 0);
+
+    for (size_t i = 0; i < N; i++)
+        counts[row_parts[i]]++;
+
+    m_layout.devices = devices;
+    m_layout.row_starts.assign(num_parts + 1, 0);
+
+    for (size_t p = 0; p < num_parts; p++)
+        m_layout.row_starts[p + 1] = m_layout.row_starts[p] + counts[p];
+
+    m_layout.permutation.resize(N);
+
+    std::vector<size_t> local(N);
+    std::vector<size_t> next(m_layout.row_starts.begin(), m_layout.row_starts.end() - 1);
+
+    for (size_t i = 0; i < N; i++)
+    {
+        const int p = row_parts[i];
+
+        local[i] = next[p] - m_layout.row_starts[p];
+        m_layout.permutation[next[p]++] = i;
+    }
+
+    // ghost entries of every part, identified by (owner, local index) so
+    // that those of each owner are contiguous after sorting
+    std::vector< std::vector<size_t> > ghosts(num_parts);
+
+    for (size_t p = 0; p < num_parts; p++)
+    {
+        for (size_t r = m_layout.row_starts[p]; r < m_layout.row_starts[p + 1]; r++)
+        {
+            const size_t i = m_layout.permutation[r];
+
+            for (IndexType n = H.row_offsets[i]; n < H.row_offsets[i + 1]; n++)
+            {
+                const size_t j = H.column_indices[n];
+
+                if (size_t(row_parts[j]) != p)
+                    ghosts[p].push_back(row_parts[j] * N + local[j]);
+            }
+        }
+
+        std::sort(ghosts[p].begin(), ghosts[p].end());
+        ghosts[p].erase(std::unique(ghosts[p].begin(), ghosts[p].end()), ghosts[p].end());
+    }
+
+    // create the streams and split the rows of every part
+    try
+    {
+        for (size_t p = 0; p < num_parts; p++)
+        {
+            detail::device_guard guard(devices[p]);
+
+            part_data* part = new part_data();
+            parts.push_back(part);
+
+            cudaStream_t compute;
+            detail::check_error(cudaStreamCreate(&compute), "cudaStreamCreate");
+            m_layout.streams.push_back(compute);
+
+            detail::check_error(cudaStreamCreate(&part->transfer), "cudaStreamCreate");
+            detail::check_error(cudaEventCreateWithFlags(&part->compute_done, cudaEventDisableTiming), "cudaEventCreate");
+            detail::check_error(cudaEventCreateWithFlags(&part->sent, cudaEventDisableTiming), "cudaEventCreate");
+
+            const size_t num_local = m_layout.part_size(p);
+            const std::vector<size_t>& g = ghosts[p];
+
+            size_t num_diagonal = 0;
+
+            for (size_t r = m_layout.row_starts[p]; r < m_layout.row_starts[p + 1]; r++)
+            {
+                const size_t i = m_layout.permutation[r];
+
+                for (IndexType n = H.row_offsets[i]; n < H.row_offsets[i + 1]; n++)
+                    if (size_t(row_parts[H.column_indices[n]]) == p)
+                        num_diagonal++;
+            }
+
+            size_t num_part_entries = 0;
+
+            for (size_t r = m_layout.row_starts[p]; r < m_layout.row_starts[p + 1]; r++)
+            {
+                const size_t i = m_layout.permutation[r];
+                num_part_entries += H.row_offsets[i + 1] - H.row_offsets[i];
+            }
+
+            cusp::csr_matrix<IndexType,ValueType,cusp::host_memory> D(num_local, num_local, num_diagonal);
+            cusp::csr_matrix<IndexType,ValueType,cusp::host_memory> O(num_local, g.size(), num_part_entries - num_diagonal);
+
+            size_t d = 0;
+            size_t o = 0;
+
+            for (size_t r = 0; r < num_local; r++)
+            {
+                const size_t i = m_layout.permutation[m_layout.row_starts[p] + r];
+
+                D.row_offsets[r] = d;
+                O.row_offsets[r] = o;
+
+                for (IndexType n = H.row_offsets[i]; n < H.row_offsets[i + 1]; n++)
+                {
+                    const size_t j = H.column_indices[n];
+
+                    if (size_t(row_parts[j]) == p)
+                    {
+                        D.column_indices[d] = local[j];
+                        D.values[d++] = H.values[n];
+                    }
+                    else
+                    {
+                        const size_t key = row_parts[j] * N + local[j];
+                        O.column_indices[o] = std::lower_bound(g.begin(), g.end(), key) - g.begin();
+                        O.values[o++] = H.values[n];
+                    }
+                }
+            }
+
+            D.row_offsets[num_local] = d;
+            O.row_offsets[num_local] = o;
+
+            part->diagonal     = D;
+            part->off_diagonal = O;
+            part->ghost_values.resize(g.size());
+        }
+    }
+    catch (...)
+    {
+        release();
+        throw;
+    }
+
+    // the ghosts of part p owned by part q are copied from the send buffer
+    // of q into a contiguous range of the ghost buffer of p
+    std::vector< std::vector<size_t> > send_lists(num_parts);
+
+    for (size_t p = 0; p < num_parts; p++)
+    {
+        const std::vector<size_t>& g = ghosts[p];
+
+        for (size_t begin = 0; begin < g.size();)
+        {
+            const size_t q = g[begin] / N;
+
+            size_t end = begin;
+
+            while (end < g.size() && g[end] / N == q)
+                end++;
+
+            part_data& source = *parts[q];
+
+            source.consumers.push_back(p);
+            source.send_offsets.push_back(send_lists[q].size());
+            source.ghost_offsets.push_back(begin);
+
+            for (size_t n = begin; n < end; n++)
+                send_lists[q].push_back(g[n] % N);
+
+            parts[p]->sources.push_back(q);
+
+            begin = end;
+        }
+    }
+
+    for (size_t q = 0; q < num_parts; q++)
+    {
+        detail::device_guard guard(devices[q]);
+
+        part_data& part = *parts[q];
+
+        part.send_offsets.push_back(send_lists[q].size());
+
+        cusp::array1d<IndexType,cusp::host_memory> indices(send_lists[q].begin(), send_lists[q].end());
+
+        part.send_indices = indices;
+        part.send_buffer.resize(indices.size());
+    }
+
+    // peer access lets the copies bypass host memory, pairs without it and
+    // pairs that were already enabled are left as they are
+    for (size_t p = 0; p < num_parts; p++)
+    {
+        for (size_t n = 0; n < parts[p]->sources.size(); n++)
+        {
+            const int dst = devices[p];
+            const int src = devices[parts[p]->sources[n]];
+
+            int can_access = 0;
+
+            if (dst == src || cudaDeviceCanAccessPeer(&can_access, dst, src) != cudaSuccess || !can_access)
+                continue;
+
+            detail::device_guard guard(dst);
+
+            if (cudaDeviceEnablePeerAccess(src, 0) != cudaSuccess)
+                cudaGetLastError();
+        }
+    }
+}
+
+template <typename IndexType, typename ValueType>
+void
+csr_matrix<IndexType,ValueType>
+::operator()(const array1d<ValueType>& x, array1d<ValueType>& y) const
+{
+    typedef cusp::system::cuda::detail::execute_on_stream Policy;
+
+    if (&x.layout() != &m_layout || &y.layout() != &m_layout)
+        throw cusp::invalid_input_exception("multi_gpu::csr_matrix: vectors were not created from this matrix");
+
+    const size_t num_parts = parts.size();
+
+    // the transfers read x and overwrite the ghost buffers, so they start
+    // after the work already issued to the compute streams
+    for (size_t p = 0; p < num_parts; p++)
+    {
+        detail::device_guard guard(m_layout.devices[p]);
+
+        detail::check_error(cudaEventRecord(parts[p]->compute_done, m_layout.streams[p]), "cudaEventRecord");
+    }
+
+    for (size_t q = 0; q < num_parts; q++)
+    {
+        const part_data& part = *parts[q];
+
+        if (part.consumers.empty())
+            continue;
+
+        detail::device_guard guard(m_layout.devices[q]);
+
+        cudaStreamWaitEvent(part.transfer, part.compute_done, 0);
+
+        for (size_t n = 0; n < part.consumers.size(); n++)
+            cudaStreamWaitEvent(part.transfer, parts[part.consumers[n]]->compute_done, 0);
+
+        Policy exec(part.transfer);
+
+        thrust::gather(exec, part.send_indices.begin(), part.send_indices.end(),
+                       x.part(q).begin(), part.send_buffer.begin());
+
+        for (size_t n = 0; n < part.consumers.size(); n++)
+        {
+            const int    p     = part.consumers[n];
+            const size_t count = part.send_offsets[n + 1] - part.send_offsets[n];
+
+            detail::check_error(cudaMemcpyPeerAsync(detail::raw_pointer(parts[p]->ghost_values, part.ghost_offsets[n]), m_layout.devices[p],
+                                                    detail::raw_pointer(part.send_buffer, part.send_offsets[n]), m_layout.devices[q],
+                                                    count * sizeof(ValueType), part.transfer),
+                                "cudaMemcpyPeerAsync");
+        }
+
+        detail::check_error(cudaEventRecord(part.sent, part.transfer), "cudaEventRecord");
+    }
+
+    // the diagonal blocks overlap the transfers
+    for (size_t p = 0; p < num_parts; p++)
+    {
+        const part_data& part = *parts[p];
+
+        detail::device_guard guard(m_layout.devices[p]);
+
+        Policy exec(m_layout.streams[p]);
+
+        cusp::multiply(exec, part.diagonal, x.part(p), y.part(p));
+
+        // later work on x must not overwrite the entries being sent
+        if (!part.consumers.empty())
+            cudaStreamWaitEvent(m_layout.streams[p], part.sent, 0);
+
+        if (part.sources.empty())
+            continue;
+
+        for (size_t n = 0; n < part.sources.size(); n++)
+            cudaStreamWaitEvent(m_layout.streams[p], parts[part.sources[n]]->sent, 0);
+
+        // y <- y + off_diagonal * ghost_values
+        cusp::multiply(exec, part.off_diagonal, part.ghost_values, y.part(p),
+                       thrust::identity<ValueType>(), thrust::multiplies<ValueType>(), thrust::plus<ValueType>());
+    }
+}
+
+template <typename IndexType, typename ValueType>
+void multiply(const csr_matrix<IndexType,ValueType>& A,
+              const array1d<ValueType>& x,
+                    array1d<ValueType>& y)
+{
+    A(x, y);
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// blas
+//////////////////////////////////////////////////////////////////////////////
+
+namespace blas
+{
+
+template <typename ValueType, typename ScalarType>
+void axpy(const array1d<ValueType>& x, array1d<ValueType>& y, const ScalarType alpha)
+{
+    for (size_t p = 0; p < x.num_parts(); p++)
+    {
+        multi_gpu::detail::device_guard guard(x.device(p));
+
+        cusp::blas::axpy(cusp::system::cuda::detail::execute_on_stream(x.stream(p)), x.part(p), y.part(p), alpha);
+    }
+}
+
+template <typename ValueType, typename ScalarType1, typename ScalarType2>
+void axpby(const array1d<ValueType>& x, const array1d<ValueType>& y, array1d<ValueType>& z,
+           const ScalarType1 alpha, const ScalarType2 beta)
+{
+    for (size_t p = 0; p < x.num_parts(); p++)
+    {
+        multi_gpu::detail::device_guard guard(x.device(p));
+
+        cusp::blas::axpby(cusp::system::cuda::detail::execute_on_stream(x.stream(p)), x.part(p), y.part(p), z.part(p), alpha, beta);
+    }
+}
+
+template <typename ValueType>
+void copy(const array1d<ValueType>& x, array1d<ValueType>& y)
+{
+    for (size_t p = 0; p < x.num_parts(); p++)
+    {
+        multi_gpu::detail::device_guard guard(x.device(p));
+
+        cusp::blas::copy(cusp::system::cuda::detail::execute_on_stream(x.stream(p)), x.part(p), y.part(p));
+    }
+}
+
+template <typename ValueType, typename ScalarType>
+void fill(array1d<ValueType>& x, const ScalarType alpha)
+{
+    for (size_t p = 0; p < x.num_parts(); p++)
+    {
+        multi_gpu::detail::device_guard guard(x.device(p));
+
+        cusp::blas::fill(cusp::system::cuda::detail::execute_on_stream(x.stream(p)), x.part(p), alpha);
+    }
+}
+
+template <typename ValueType, typename ScalarType>
+void scal(array1d<ValueType>& x, const ScalarType alpha)
+{
+    for (size_t p = 0; p < x.num_parts(); p++)
+    {
+        multi_gpu::detail::device_guard guard(x.device(p));
+
+        cusp::blas::scal(cusp::system::cuda::detail::execute_on_stream(x.stream(p)), x.part(p), alpha);
+    }
+}
+
+namespace detail
+{
+
+// the partial reductions are issued to all devices before any of them is
+// read back, so the devices reduce concurrently
+template <typename ValueType, bool Conjugate>
+ValueType reduce(const array1d<ValueType>& x, const array1d<ValueType>& y)
+{
+    for (size_t p = 0; p < x.num_parts(); p++)
+    {
+        multi_gpu::detail::device_guard guard(x.device(p));
+
+        cusp::system::cuda::detail::execute_on_stream exec(x.stream(p));
+
+        if (Conjugate)
+            cusp::blas::dotc(exec, x.part(p), y.part(p), x.scalar(p));
+        else
+            cusp::blas::dot(exec, x.part(p), y.part(p), x.scalar(p));
+    }
+
+    ValueType sum(0);
+
+    for (size_t p = 0; p < x.num_parts(); p++)
+    {
+        multi_gpu::detail::device_guard guard(x.device(p));
+
+        multi_gpu::detail::check_error(cudaStreamSynchronize(x.stream(p)), "cudaStreamSynchronize");
+
+        sum += ValueType(x.scalar(p)[0]);
+    }
+
+    return sum;
+}
+
+} // end namespace detail
+
+template <typename ValueType>
+ValueType dot(const array1d<ValueType>& x, const array1d<ValueType>& y)
+{
+    return detail::reduce<ValueType,false>(x, y);
+}
+
+template <typename ValueType>
+ValueType dotc(const array1d<ValueType>& x, const array1d<ValueType>& y)
+{
+    return detail::reduce<ValueType,true>(x, y);
+}
+
+template <typename ValueType>
+typename cusp::norm_type<ValueType>::type
+nrm2(const array1d<ValueType>& x)
+{
+    // x^H x is real, its magnitude drops the rounding in the imaginary part
+    return std::sqrt(cusp::abs(detail::reduce<ValueType,true>(x, x)));
+}
+
+} // end namespace blas
+
+} // end namespace multi_gpu
+} // end namespace cuda
+} // end namespace system
+} // end namespace cusp
@@ -26,12 +26,20 @@
 #include <cusp/system/cuda/detail/multiply/csr_vector_spmv.h>
 #endif
 
+#include <cusp/system/cuda/detail/multiply/bsr_spmv.h>
 #include <cusp/system/cuda/detail/multiply/csr_block_spmv.h>
+#include <cusp/system/cuda/detail/multiply/csr_spmv_dotc.h>
+#include <cusp/system/cuda/detail/multiply/dcsr_spmv.h>
 
 #include <cusp/system/cuda/detail/multiply/dense.h>
 #include <cusp/system/cuda/detail/multiply/dia_spmv.h>
+#include <cusp/system/cuda/detail/multiply/dynamic_csr_spmv.h>
 #include <cusp/system/cuda/detail/multiply/ell_spmv.h>
-// #include <cusp/system/cuda/detail/multiply/hyb_spmv.h>
+#include <cusp/system/cuda/detail/multiply/sell_spmv.h>
+#include <cusp/system/cuda/detail/multiply/symmetric_spmv.h>
+#include <cusp/system/cuda/detail/multiply/hyb_spmv.h>
+#include <cusp/system/cuda/detail/multiply/transpose_spmv.h>
 
+#include <cusp/system/cuda/detail/multiply/galerkin_product.h>
 #include <cusp/system/cuda/detail/multiply/spgemm.h>
 
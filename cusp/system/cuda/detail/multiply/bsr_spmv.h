@@ -0,0 +1,139 @@
+/*
+ *  Copyright 2008-2014 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#pragma once
+
+#include <cusp/bsr_matrix.h>
+#include <cusp/detail/fixed_size.h>
+#include <cusp/system/cuda/arch.h>
+#include <cusp/system/cuda/utils.h>
+
+#include <thrust/device_ptr.h>
+
+#include <algorithm>
+
+namespace cusp
+{
+namespace system
+{
+namespace cuda
+{
+namespace detail
+{
+
+// One thread is assigned to each row of the matrix, so the BLOCK_ROWS
+// threads sharing a block row read consecutive rows of every block and
+// together load each block contiguously.  The block size is known at
+// compile time and the product with the block columns is unrolled by
+// cusp::detail::fixed_size::dot.
+template <typename IndexType,
+          typename ValueType,
+          typename UnaryFunction,
+          typename BinaryFunction1,
+          typename BinaryFunction2,
+          size_t BLOCK_ROWS,
+          size_t BLOCK_COLS,
+          size_t BLOCK_SIZE>
+__launch_bounds__(BLOCK_SIZE,1)
+__global__ void
+spmv_bsr_kernel(const IndexType num_rows,
+                const IndexType * Ap,
+                const IndexType * Aj,
+                const ValueType * Ax,
+                const ValueType * x,
+                ValueType * y,
+                UnaryFunction initialize,
+                BinaryFunction1 combine,
+                BinaryFunction2 reduce)
+{
+    const IndexType thread_id = blockDim.x * blockIdx.x + threadIdx.x;
+    const IndexType grid_size = gridDim.x * blockDim.x;
+
+    for(IndexType row = thread_id; row < num_rows; row += grid_size)
+    {
+        const IndexType block_row  = row / BLOCK_ROWS;
+        const IndexType block_lane = row % BLOCK_ROWS;
+
+        const IndexType row_start = Ap[block_row];
+        const IndexType row_end   = Ap[block_row + 1];
+
+        ValueType sum = initialize(y[row]);
+
+        for(IndexType jj = row_start; jj < row_end; jj++)
+        {
+            const ValueType * A_block = Ax + jj * (BLOCK_ROWS * BLOCK_COLS) + block_lane * BLOCK_COLS;
+            const ValueType * x_block = x + Aj[jj] * BLOCK_COLS;
+
+            sum = cusp::detail::fixed_size::dot<BLOCK_COLS>(A_block, x_block, sum, combine, reduce);
+        }
+
+        y[row] = sum;
+    }
+}
+
+
+template <typename DerivedPolicy,
+          typename MatrixType,
+          typename VectorType1,
+          typename VectorType2,
+          typename UnaryFunction,
+          typename BinaryFunction1,
+          typename BinaryFunction2>
+void multiply(cuda::execution_policy<DerivedPolicy>& exec,
+              MatrixType& A,
+              VectorType1& x,
+              VectorType2& y,
+              UnaryFunction   initialize,
+              BinaryFunction1 combine,
+              BinaryFunction2 reduce,
+              cusp::bsr_format,
+              cusp::array1d_format,
+              cusp::array1d_format)
+{
+    typedef typename MatrixType::index_type IndexType;
+    typedef typename MatrixType::value_type ValueType;
+
+    const size_t BLOCK_ROWS = MatrixType::block_rows;
+    const size_t BLOCK_COLS = MatrixType::block_cols;
+
+    if(A.num_entries == 0)
+    {
+        thrust::transform(exec, y.begin(), y.end(), y.begin(), initialize);
+        return;
+    }
+
+    const size_t BLOCK_SIZE = 256;
+    const size_t NUM_BLOCKS = cusp::system::cuda::detail::launch_blocks(
+                                  spmv_bsr_kernel<IndexType,ValueType,UnaryFunction,BinaryFunction1,BinaryFunction2,BLOCK_ROWS,BLOCK_COLS,BLOCK_SIZE>, BLOCK_SIZE, (size_t) 0,
+                                  A.num_rows, BLOCK_SIZE);
+
+    const IndexType * P = thrust::raw_pointer_cast(&A.row_offsets[0]);
+    const IndexType * J = thrust::raw_pointer_cast(&A.column_indices[0]);
+    const ValueType * V = thrust::raw_pointer_cast(&A.values[0]);
+
+    const ValueType * x_ptr = thrust::raw_pointer_cast(&x[0]);
+    ValueType * y_ptr = thrust::raw_pointer_cast(&y[0]);
+
+    cudaStream_t s = stream(thrust::detail::derived_cast(exec));
+
+    spmv_bsr_kernel<IndexType,ValueType,UnaryFunction,BinaryFunction1,BinaryFunction2,BLOCK_ROWS,BLOCK_COLS,BLOCK_SIZE> <<<NUM_BLOCKS, BLOCK_SIZE, 0, s>>>
+    (A.num_rows, P, J, V, x_ptr, y_ptr, initialize, combine, reduce);
+}
+
+} // end namespace detail
+} // end namespace cuda
+} // end namespace system
+} // end namespace cusp
@@ -18,11 +18,15 @@
 
 #include <thrust/extrema.h>
 
+#include <cusp/detail/temporary_array.h>
+
 #include <cusp/system/cuda/arch.h>
 #include <cusp/system/cuda/utils.h>
+#include <cusp/system/cuda/detail/multiply/coo_lookback_spmv.h>
 #include <cusp/system/cuda/detail/multiply/coo_serial.h>
 
 #include <thrust/device_ptr.h>
+#include <thrust/transform.h>
 
 // Note: Unlike the other kernels this kernel implements y += A*x
 
@@ -402,11 +406,14 @@ void __spmv_coo_flat(cuda::execution_policy<DerivedPolicy>& exec,
     typedef typename VectorType1::const_iterator                            ValueIterator2;
     typedef typename VectorType2::iterator                                  ValueIterator3;
 
-    typedef typename cusp::array1d<IndexType,cusp::device_memory>::iterator IndexIterator;
-    typedef typename cusp::array1d<ValueType,cusp::device_memory>::iterator ValueIterator4;
+    typedef cusp::detail::temporary_array<IndexType, DerivedPolicy>         IndexArray;
+    typedef cusp::detail::temporary_array<ValueType, DerivedPolicy>         ValueArray;
+
+    typedef typename IndexArray::iterator                                   IndexIterator;
+    typedef typename ValueArray::iterator                                   ValueIterator4;
 
     if (InitializeY)
-        thrust::fill(y.begin(), y.begin() + A.num_rows, ValueType(0));
+        thrust::fill(exec, y.begin(), y.begin() + A.num_rows, ValueType(0));
 
     cudaStream_t s = stream(thrust::detail::derived_cast(exec));
 
@@ -442,8 +449,8 @@ void __spmv_coo_flat(cuda::execution_policy<DerivedPolicy>& exec,
 
     const unsigned int active_warps = (interval_size == 0) ? 0 : DIVIDE_INTO(tail, interval_size);
 
-    cusp::array1d<IndexType,cusp::device_memory> temp_rows(active_warps);
-    cusp::array1d<ValueType,cusp::device_memory> temp_vals(active_warps);
+    IndexArray temp_rows(exec, active_warps);
+    ValueArray temp_vals(exec, active_warps);
 
     spmv_coo_flat_kernel<IndexType, RowIterator, ColumnIterator,
                          ValueIterator1, ValueIterator2, ValueIterator3,
@@ -480,7 +487,7 @@ void multiply(cuda::execution_policy<DerivedPolicy>& exec,
               array1d_format,
               array1d_format)
 {
-    __spmv_coo_flat<false>(exec, A, x, y, initialize, combine, reduce);
+    __spmv_coo_lookback(exec, A, x, y, combine, reduce);
 }
 
 template <typename DerivedPolicy,
@@ -501,7 +508,8 @@ void multiply(cuda::execution_policy<DerivedPolicy>& exec,
               array1d_format,
               array1d_format)
 {
-    __spmv_coo_flat<true>(exec, A, x, y, initialize, combine, reduce);
+    thrust::transform(exec, y.begin(), y.end(), y.begin(), initialize);
+    __spmv_coo_lookback(exec, A, x, y, combine, reduce);
 }
 #endif
 
@@ -0,0 +1,367 @@
+/*
+ *  Copyright 2008-2014 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+
+#pragma once
+
+#include <cusp/detail/temporary_array.h>
+
+#include <cusp/system/cuda/arch.h>
+#include <cusp/system/cuda/utils.h>
+
+#include <thrust/extrema.h>
+
+namespace cusp
+{
+namespace system
+{
+namespace cuda
+{
+namespace detail
+{
+
+//////////////////////////////////////////////////////////////////////////////
+// COO SpMV kernel based on a single-pass segmented reduction
+//////////////////////////////////////////////////////////////////////////////
+//
+// spmv_coo_lookback_kernel
+//   The entries of the (row sorted) matrix are divided into tiles of
+//   BLOCK_SIZE * ITEMS_PER_THREAD entries which are claimed in order by
+//   the thread blocks through an atomic counter.  A tile is reduced by row
+//   in shared memory and the partial sum of the row in which the tile ends,
+//   its carry-out, is published to the tiles that follow.  A tile that
+//   starts inside a row looks back at the carry-outs of its predecessors
+//   (decoupled look-back): the walk stops at the first tile whose carry-out
+//   belongs to a different row or already includes all of the earlier
+//   tiles.  Every row is then written once by the thread which owns its
+//   last entry, y[row] = reduce(y[row], sum), so the matrix is read exactly
+//   once and no fix-up pass is required.
+//
+//  Note: y must have been initialized before the kernel is launched.
+
+// status of the carry-out of a tile
+const int COO_TILE_INVALID   = 0; // not published yet
+const int COO_TILE_AGGREGATE = 1; // carry-out of this tile alone
+const int COO_TILE_INCLUSIVE = 2; // carry-out including all earlier tiles
+
+// the carry-outs are exchanged between thread blocks through global memory
+// and must bypass the L1 cache, ValueType may be a complex type so it is
+// copied through volatile words
+template <typename T>
+__device__ __forceinline__
+void coo_lookback_store(T * ptr, const T& value)
+{
+    volatile int * dst = reinterpret_cast<volatile int *>(ptr);
+    const int    * src = reinterpret_cast<const int *>(&value);
+
+    for(unsigned int i = 0; i < sizeof(T) / sizeof(int); i++)
+        dst[i] = src[i];
+}
+
+template <typename T>
+__device__ __forceinline__
+T coo_lookback_load(const T * ptr)
+{
+    T value;
+
+    volatile const int * src = reinterpret_cast<volatile const int *>(ptr);
+    int                * dst = reinterpret_cast<int *>(&value);
+
+    for(unsigned int i = 0; i < sizeof(T) / sizeof(int); i++)
+        dst[i] = src[i];
+
+    return value;
+}
+
+template <typename IndexType, typename RowIterator, typename ColumnIterator, typename ValueIterator1,
+         typename ValueIterator2, typename ValueIterator3,
+         typename BinaryFunction1, typename BinaryFunction2,
+         unsigned int BLOCK_SIZE, unsigned int ITEMS_PER_THREAD>
+__launch_bounds__(BLOCK_SIZE)
+__global__ void
+spmv_coo_lookback_kernel(const IndexType num_entries,
+                         const unsigned int num_tiles,
+                         const RowIterator    Ai,
+                         const ColumnIterator Aj,
+                         const ValueIterator1 Ax,
+                         const ValueIterator2  x,
+                         ValueIterator3        y,
+                         int       * tile_status,
+                         IndexType * tile_rows,
+                         typename thrust::iterator_value<ValueIterator3>::type * tile_values,  // aggregates, then inclusive carry-outs
+                         unsigned int * tile_counter,
+                         BinaryFunction1 combine,
+                         BinaryFunction2 reduce)
+{
+    typedef typename thrust::iterator_value<ValueIterator3>::type ValueType;
+
+    const unsigned int TILE_SIZE = BLOCK_SIZE * ITEMS_PER_THREAD;
+
+    __shared__ IndexType rows[TILE_SIZE];
+    __shared__ ValueType products[TILE_SIZE];
+    __shared__ IndexType scan_rows[BLOCK_SIZE];
+    __shared__ ValueType scan_values[BLOCK_SIZE];
+
+    __shared__ unsigned int tile;
+    __shared__ IndexType    next_row;
+    __shared__ bool         has_next;
+    __shared__ IndexType    prefix_row;
+    __shared__ ValueType    prefix_value;
+    __shared__ bool         has_prefix;
+
+    if(threadIdx.x == 0)
+        tile = atomicAdd(tile_counter, 1);
+
+    __syncthreads();
+
+    const IndexType tile_start = IndexType(tile) * TILE_SIZE;
+    const IndexType num_items  = thrust::min(IndexType(TILE_SIZE), num_entries - tile_start);
+
+    // stage the tile with coalesced loads
+    for(IndexType i = threadIdx.x; i < num_items; i += BLOCK_SIZE)
+    {
+        rows[i]     = Ai[tile_start + i];
+        products[i] = combine(Ax[tile_start + i], x[Aj[tile_start + i]]);
+    }
+
+    if(threadIdx.x == 0)
+    {
+        has_next = tile_start + num_items < num_entries;
+        next_row = has_next ? IndexType(Ai[tile_start + num_items]) : IndexType(0);
+    }
+
+    __syncthreads();
+
+    // carry-out of the items owned by this thread
+    const IndexType thread_start  = threadIdx.x * ITEMS_PER_THREAD;
+    const IndexType thread_end    = thrust::min(IndexType(thread_start + ITEMS_PER_THREAD), num_items);
+    const IndexType active_thread = (num_items - 1) / ITEMS_PER_THREAD;
+
+    if(thread_start < thread_end)
+    {
+        IndexType row = rows[thread_start];
+        ValueType sum = products[thread_start];
+
+        for(IndexType i = thread_start + 1; i < thread_end; i++)
+        {
+            if(rows[i] == row)
+            {
+                sum = reduce(sum, products[i]);
+            }
+            else
+            {
+                row = rows[i];
+                sum = products[i];
+            }
+        }
+
+        scan_rows[threadIdx.x]   = row;
+        scan_values[threadIdx.x] = sum;
+    }
+
+    __syncthreads();
+
+    // inclusive segmented scan of the carry-outs of the threads, it is
+    // associative because the rows are sorted
+    for(unsigned int offset = 1; offset < BLOCK_SIZE; offset *= 2)
+    {
+        ValueType sum = ValueType(0);
+
+        const bool update = threadIdx.x >= offset && IndexType(threadIdx.x) <= active_thread &&
+                            scan_rows[threadIdx.x - offset] == scan_rows[threadIdx.x];
+
+        if(update)
+            sum = reduce(scan_values[threadIdx.x - offset], scan_values[threadIdx.x]);
+
+        __syncthreads();
+
+        if(update)
+            scan_values[threadIdx.x] = sum;
+
+        __syncthreads();
+    }
+
+    // publish the carry-out of the tile and look back for the prefix
+    if(threadIdx.x == 0)
+    {
+        const IndexType first_row = rows[0];
+        const IndexType last_row  = scan_rows[active_thread];
+        const ValueType aggregate = scan_values[active_thread];
+
+        // a tile spanning a single row cannot publish its inclusive carry-out
+        // before its prefix is known
+        const bool single_row = first_row == last_row;
+
+        const int status = (tile > 0 && single_row) ? COO_TILE_AGGREGATE : COO_TILE_INCLUSIVE;
+
+        tile_rows[tile] = last_row;
+        coo_lookback_store(tile_values + (status == COO_TILE_AGGREGATE ? tile : num_tiles + tile), aggregate);
+        __threadfence();
+        reinterpret_cast<volatile int *>(tile_status)[tile] = status;
+
+        bool      found = false;
+        ValueType sum   = ValueType(0);
+
+        for(int predecessor = int(tile) - 1; predecessor >= 0; predecessor--)
+        {
+            int predecessor_status;
+
+            do
+            {
+                predecessor_status = reinterpret_cast<volatile int *>(tile_status)[predecessor];
+            }
+            while(predecessor_status == COO_TILE_INVALID);
+
+            __threadfence();
+
+            const IndexType row = reinterpret_cast<volatile IndexType *>(tile_rows)[predecessor];
+
+            if(row != first_row)
+                break;
+
+            const ValueType value = predecessor_status == COO_TILE_AGGREGATE ?
+                                    coo_lookback_load(tile_values + predecessor) :
+                                    coo_lookback_load(tile_values + num_tiles + predecessor);
+
+            sum   = found ? reduce(value, sum) : value;
+            found = true;
+
+            if(predecessor_status == COO_TILE_INCLUSIVE)
+                break;
+        }
+
+        prefix_row   = first_row;
+        prefix_value = sum;
+        has_prefix   = found;
+
+        if(tile > 0 && single_row)
+        {
+            coo_lookback_store(tile_values + num_tiles + tile, found ? reduce(sum, aggregate) : aggregate);
+            __threadfence();
+            reinterpret_cast<volatile int *>(tile_status)[tile] = COO_TILE_INCLUSIVE;
+        }
+    }
+
+    __syncthreads();
+
+    if(thread_start >= thread_end)
+        return;
+
+    // exclusive prefix of this thread
+    bool      carry     = false;
+    IndexType carry_row = 0;
+    ValueType carry_sum = ValueType(0);
+
+    if(threadIdx.x > 0)
+    {
+        carry     = true;
+        carry_row = scan_rows[threadIdx.x - 1];
+        carry_sum = scan_values[threadIdx.x - 1];
+
+        if(has_prefix && prefix_row == carry_row)
+            carry_sum = reduce(prefix_value, carry_sum);
+    }
+    else if(has_prefix)
+    {
+        carry     = true;
+        carry_row = prefix_row;
+        carry_sum = prefix_value;
+    }
+
+    IndexType row = rows[thread_start];
+    ValueType sum = (carry && carry_row == row) ? reduce(carry_sum, products[thread_start]) : products[thread_start];
+
+    for(IndexType i = thread_start; i < thread_end; i++)
+    {
+        if(i > thread_start)
+        {
+            if(rows[i] == row)
+            {
+                sum = reduce(sum, products[i]);
+            }
+            else
+            {
+                row = rows[i];
+                sum = products[i];
+            }
+        }
+
+        // the owner of the last entry of a row writes it
+        const bool row_end = (i + 1 < num_items) ? rows[i + 1] != row : (!has_next || next_row != row);
+
+        if(row_end)
+            y[row] = reduce(y[row], sum);
+    }
+}
+
+template <typename DerivedPolicy,
+         typename MatrixType,
+         typename VectorType1,
+         typename VectorType2,
+         typename BinaryFunction1,
+         typename BinaryFunction2>
+void __spmv_coo_lookback(cuda::execution_policy<DerivedPolicy>& exec,
+                         const MatrixType& A,
+                         const VectorType1& x,
+                         VectorType2& y,
+                         BinaryFunction1 combine,
+                         BinaryFunction2 reduce)
+{
+    typedef typename MatrixType::index_type                                 IndexType;
+    typedef typename VectorType2::value_type                                ValueType;
+
+    typedef typename MatrixType::row_indices_array_type::const_iterator     RowIterator;
+    typedef typename MatrixType::column_indices_array_type::const_iterator  ColumnIterator;
+    typedef typename MatrixType::values_array_type::const_iterator          ValueIterator1;
+
+    typedef typename VectorType1::const_iterator                            ValueIterator2;
+    typedef typename VectorType2::iterator                                  ValueIterator3;
+
+    const unsigned int BLOCK_SIZE       = 128;
+    const unsigned int ITEMS_PER_THREAD = sizeof(ValueType) > 4 ? 5 : 7;
+    const unsigned int TILE_SIZE        = BLOCK_SIZE * ITEMS_PER_THREAD;
+
+    if(A.num_entries == 0)
+        return;
+
+    const size_t num_tiles = DIVIDE_INTO(A.num_entries, TILE_SIZE);
+
+    // the tile counter is stored after the status of the last tile
+    cusp::detail::temporary_array<int, DerivedPolicy>       tile_status(exec, num_tiles + 1);
+    cusp::detail::temporary_array<IndexType, DerivedPolicy> tile_rows(exec, num_tiles);
+    cusp::detail::temporary_array<ValueType, DerivedPolicy> tile_values(exec, 2 * num_tiles);
+
+    int * status = thrust::raw_pointer_cast(&tile_status[0]);
+
+    cudaStream_t s = stream(thrust::detail::derived_cast(exec));
+
+    cudaMemsetAsync(status, 0, (num_tiles + 1) * sizeof(int), s);
+
+    spmv_coo_lookback_kernel<IndexType, RowIterator, ColumnIterator, ValueIterator1, ValueIterator2, ValueIterator3,
+                             BinaryFunction1, BinaryFunction2, BLOCK_SIZE, ITEMS_PER_THREAD> <<<num_tiles, BLOCK_SIZE, 0, s>>>
+                             (IndexType(A.num_entries), (unsigned int) num_tiles,
+                              A.row_indices.begin(), A.column_indices.begin(), A.values.begin(), x.begin(), y.begin(),
+                              status,
+                              thrust::raw_pointer_cast(&tile_rows[0]),
+                              thrust::raw_pointer_cast(&tile_values[0]),
+                              reinterpret_cast<unsigned int *>(status + num_tiles),
+                              combine, reduce);
+}
+
+} // end namespace detail
+} // end namespace cuda
+} // end namespace system
+} // end namespace cusp
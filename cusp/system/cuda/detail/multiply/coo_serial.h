@@ -16,6 +16,8 @@
 
 #pragma once
 
+#include <cusp/system/cuda/detail/execution_policy.h>
+
 #include <thrust/device_ptr.h>
 
 namespace cusp
@@ -54,12 +56,14 @@ spmv_coo_serial_kernel(const int num_entries,
 }
 
 
-template <typename Matrix,
+template <typename DerivedPolicy,
+          typename Matrix,
           typename Array1,
           typename Array2,
           typename BinaryFunction1,
           typename BinaryFunction2>
-void spmv_coo_serial_device(const Matrix& A,
+void spmv_coo_serial_device(cuda::execution_policy<DerivedPolicy>& exec,
+                            const Matrix& A,
                             const Array1& x,
                                   Array2& y,
                             BinaryFunction1 combine,
@@ -71,7 +75,9 @@ void spmv_coo_serial_device(const Matrix& A,
     typedef typename Array1::const_iterator                            ValueIterator2;
     typedef typename Array2::iterator                                  ValueIterator3;
 
-    spmv_coo_serial_kernel<RowIterator,ColumnIterator,ValueIterator1,ValueIterator2,ValueIterator3,BinaryFunction1,BinaryFunction2> <<<1,1>>>
+    cudaStream_t s = stream(thrust::detail::derived_cast(exec));
+
+    spmv_coo_serial_kernel<RowIterator,ColumnIterator,ValueIterator1,ValueIterator2,ValueIterator3,BinaryFunction1,BinaryFunction2> <<<1,1,0,s>>>
     (A.num_entries, A.row_indices.begin(), A.column_indices.begin(), A.values.begin(), x.begin(), y.begin(), combine, reduce);
 }
 
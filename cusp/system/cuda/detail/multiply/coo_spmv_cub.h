@@ -53,6 +53,7 @@
 
 #include <cusp/system/cuda/arch.h>
 #include <cusp/system/cuda/utils.h>
+#include <cusp/system/cuda/detail/multiply/coo_lookback_spmv.h>
 #include <cusp/system/cuda/detail/multiply/coo_serial.h>
 
 #include <thrust/device_ptr.h>
@@ -963,7 +964,7 @@ void multiply(cuda::execution_policy<DerivedPolicy>& exec,
               cusp::array1d_format,
               cusp::array1d_format)
 {
-    cub_coo_spmv_detail::spmv_coo(exec, A, x, y, combine, reduce);
+    __spmv_coo_lookback(exec, A, x, y, combine, reduce);
 }
 
 template <typename DerivedPolicy,
@@ -985,7 +986,7 @@ void multiply(cuda::execution_policy<DerivedPolicy>& exec,
               cusp::array1d_format)
 {
     thrust::transform(exec, y.begin(), y.end(), y.begin(), initialize);
-    cub_coo_spmv_detail::spmv_coo(exec, A, x, y, combine, reduce);
+    __spmv_coo_lookback(exec, A, x, y, combine, reduce);
 }
 
 } // end namespace detail
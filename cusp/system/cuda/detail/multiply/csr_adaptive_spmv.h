@@ -0,0 +1,543 @@
+/*
+ *  Copyright 2008-2014 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+
+#pragma once
+
+#include <cusp/array1d.h>
+#include <cusp/exception.h>
+
+#include <cusp/detail/temporary_array.h>
+#include <cusp/detail/type_traits.h>
+
+#include <cusp/system/cuda/arch.h>
+#include <cusp/system/cuda/tuning.h>
+#include <cusp/system/cuda/utils.h>
+#include <cusp/system/cuda/detail/multiply/spmv_tuner.h>
+
+#include <thrust/extrema.h>
+
+#include <algorithm>
+#include <map>
+#include <vector>
+
+namespace cusp
+{
+namespace system
+{
+namespace cuda
+{
+namespace detail
+{
+
+//////////////////////////////////////////////////////////////////////////////
+// CSR SpMV kernels based on row bins (CSR-Adaptive)
+//////////////////////////////////////////////////////////////////////////////
+//
+// The rows of the matrix are binned by length once per operator and the
+// bins are cached in a csr_adaptive_plan.  Each bin is processed by the
+// kernel suited to its rows and the bins run concurrently on separate
+// streams, they write disjoint rows of y.
+//
+// spmv_csr_adaptive_stream_kernel
+//   Consecutive short rows are packed into blocks of at most
+//   CSR_ADAPTIVE_BLOCK_SIZE rows and CSR_ADAPTIVE_STREAM_ENTRIES entries.  A thread block
+//   computes the products of all entries of a row block with coalesced
+//   loads, stages them in shared memory and then every thread reduces one
+//   row.  Rows with only a handful of entries therefore no longer leave
+//   most lanes of a warp idle.
+//
+// spmv_csr_adaptive_vector_kernel
+//   Medium rows are processed by one warp each, as in the vector kernel,
+//   with the rows taken from a list.
+//
+// spmv_csr_adaptive_long_kernel
+//   Very long rows are split into chunks of CSR_ADAPTIVE_LONG_CHUNK entries,
+//   each reduced by one thread block into a carry value.
+//
+// spmv_csr_adaptive_long_fixup_kernel
+//   The carries of every long row are folded into y by one thread.
+//
+// The plan storage holds, in this order,
+//   stream_blocks  [2 * num_stream_blocks]  first and last + 1 row of each block
+//   vector_rows    [num_vector_rows]
+//   long_rows      [num_long_rows]
+//   long_offsets   [num_long_rows + 1]      first chunk of each long row
+//   chunk_begin    [num_chunks]             first entry of each chunk
+//   chunk_end      [num_chunks]             last + 1 entry of each chunk
+//
+//  Note: initialize is applied once per row by the thread which completes
+//        the row, all partial sums start from ValueType(0).
+
+const size_t CSR_ADAPTIVE_BLOCK_SIZE     = 128;
+const size_t CSR_ADAPTIVE_STREAM_ENTRIES = 1024;
+const size_t CSR_ADAPTIVE_SHORT_ROW      = 64;
+const size_t CSR_ADAPTIVE_LONG_ROW       = 8192;
+const size_t CSR_ADAPTIVE_LONG_CHUNK     = 2048;
+
+template <typename IndexType, typename RowIterator, typename ColumnIterator, typename ValueIterator1,
+         typename ValueIterator2, typename ValueIterator3,
+         typename UnaryFunction, typename BinaryFunction1, typename BinaryFunction2,
+         unsigned int BLOCK_SIZE, unsigned int STREAM_ENTRIES>
+__global__ void
+spmv_csr_adaptive_stream_kernel(const size_t num_blocks,
+                                const size_t * stream_blocks,
+                                const RowIterator    Ap,
+                                const ColumnIterator Aj,
+                                const ValueIterator1 Ax,
+                                const ValueIterator2  x,
+                                ValueIterator3        y,
+                                UnaryFunction initialize,
+                                BinaryFunction1 combine,
+                                BinaryFunction2 reduce)
+{
+    typedef typename thrust::iterator_value<ValueIterator3>::type ValueType;
+
+    __shared__ volatile ValueType products[STREAM_ENTRIES];
+
+    for(size_t block = blockIdx.x; block < num_blocks; block += gridDim.x)
+    {
+        const IndexType row_begin = stream_blocks[2 * block];
+        const IndexType row_end   = stream_blocks[2 * block + 1];
+
+        const IndexType block_start = Ap[row_begin];
+        const IndexType block_end   = Ap[row_end];
+
+        // the bins cannot overflow shared memory unless the plan is stale
+        const bool staged = block_end - block_start <= IndexType(STREAM_ENTRIES);
+
+        if(staged)
+        {
+            for(IndexType jj = block_start + threadIdx.x; jj < block_end; jj += BLOCK_SIZE)
+                products[jj - block_start] = combine(Ax[jj], x[Aj[jj]]);
+        }
+
+        __syncthreads();
+
+        const IndexType row = row_begin + threadIdx.x;
+
+        if(row < row_end)
+        {
+            const IndexType row_start = Ap[row];
+            const IndexType row_stop  = Ap[row + 1];
+
+            ValueType sum = ValueType(0);
+
+            // TODO: remove temp var WAR for MSVC
+            ValueType temp;
+
+            for(IndexType jj = row_start; jj < row_stop; jj++)
+            {
+                if(staged)
+                    temp = products[jj - block_start];
+                else
+                    temp = combine(Ax[jj], x[Aj[jj]]);
+
+                sum = reduce(sum, temp);
+            }
+
+            y[row] = reduce(initialize(y[row]), sum);
+        }
+
+        __syncthreads();
+    }
+}
+
+template <typename IndexType, typename RowIterator, typename ColumnIterator, typename ValueIterator1,
+         typename ValueIterator2, typename ValueIterator3,
+         typename UnaryFunction, typename BinaryFunction1, typename BinaryFunction2,
+         unsigned int VECTORS_PER_BLOCK>
+__global__ void
+spmv_csr_adaptive_vector_kernel(const size_t num_rows,
+                                const size_t * rows,
+                                const RowIterator    Ap,
+                                const ColumnIterator Aj,
+                                const ValueIterator1 Ax,
+                                const ValueIterator2  x,
+                                ValueIterator3        y,
+                                UnaryFunction initialize,
+                                BinaryFunction1 combine,
+                                BinaryFunction2 reduce)
+{
+    typedef typename thrust::iterator_value<ValueIterator3>::type ValueType;
+
+    const unsigned int THREADS_PER_VECTOR = 32;
+
+    __shared__ volatile ValueType sdata[VECTORS_PER_BLOCK * THREADS_PER_VECTOR + THREADS_PER_VECTOR / 2];  // padded to avoid reduction conditionals
+
+    const size_t thread_id   = VECTORS_PER_BLOCK * THREADS_PER_VECTOR * blockIdx.x + threadIdx.x;
+    const size_t thread_lane = threadIdx.x & (THREADS_PER_VECTOR - 1);
+    const size_t vector_id   = thread_id / THREADS_PER_VECTOR;
+    const size_t num_vectors = VECTORS_PER_BLOCK * gridDim.x;
+
+    for(size_t k = vector_id; k < num_rows; k += num_vectors)
+    {
+        const IndexType row       = rows[k];
+        const IndexType row_start = Ap[row];
+        const IndexType row_end   = Ap[row + 1];
+
+        ValueType sum = (thread_lane == 0) ? initialize(y[row]) : ValueType(0);
+
+        for(IndexType jj = row_start + thread_lane; jj < row_end; jj += THREADS_PER_VECTOR)
+            sum = reduce(sum, combine(Ax[jj], x[Aj[jj]]));
+
+        sdata[threadIdx.x] = sum;
+
+        // TODO: remove temp var WAR for MSVC
+        ValueType temp;
+
+        temp = sdata[threadIdx.x + 16]; sdata[threadIdx.x] = sum = reduce(sum, temp);
+        temp = sdata[threadIdx.x +  8]; sdata[threadIdx.x] = sum = reduce(sum, temp);
+        temp = sdata[threadIdx.x +  4]; sdata[threadIdx.x] = sum = reduce(sum, temp);
+        temp = sdata[threadIdx.x +  2]; sdata[threadIdx.x] = sum = reduce(sum, temp);
+        temp = sdata[threadIdx.x +  1]; sdata[threadIdx.x] = sum = reduce(sum, temp);
+
+        if(thread_lane == 0)
+            y[row] = ValueType(sdata[threadIdx.x]);
+    }
+}
+
+template <typename IndexType, typename ColumnIterator, typename ValueIterator1,
+         typename ValueIterator2, typename ValueIterator3,
+         typename BinaryFunction1, typename BinaryFunction2,
+         unsigned int BLOCK_SIZE>
+__global__ void
+spmv_csr_adaptive_long_kernel(const size_t num_chunks,
+                              const size_t * chunk_begin,
+                              const size_t * chunk_end,
+                              const ColumnIterator Aj,
+                              const ValueIterator1 Ax,
+                              const ValueIterator2  x,
+                              ValueIterator3        carries,
+                              BinaryFunction1 combine,
+                              BinaryFunction2 reduce)
+{
+    typedef typename thrust::iterator_value<ValueIterator3>::type ValueType;
+
+    __shared__ volatile ValueType sdata[BLOCK_SIZE];
+
+    for(size_t chunk = blockIdx.x; chunk < num_chunks; chunk += gridDim.x)
+    {
+        const IndexType chunk_start = chunk_begin[chunk];
+        const IndexType chunk_stop  = chunk_end[chunk];
+
+        ValueType sum = ValueType(0);
+
+        for(IndexType jj = chunk_start + threadIdx.x; jj < chunk_stop; jj += BLOCK_SIZE)
+            sum = reduce(sum, combine(Ax[jj], x[Aj[jj]]));
+
+        sdata[threadIdx.x] = sum;
+
+        __syncthreads();
+
+        // TODO: remove temp var WAR for MSVC
+        ValueType temp;
+
+        for(unsigned int offset = BLOCK_SIZE / 2; offset > 0; offset /= 2)
+        {
+            if(threadIdx.x < offset)
+            {
+                temp = sdata[threadIdx.x + offset];
+                sdata[threadIdx.x] = sum = reduce(sum, temp);
+            }
+
+            __syncthreads();
+        }
+
+        if(threadIdx.x == 0)
+            carries[chunk] = sum;
+
+        __syncthreads();
+    }
+}
+
+template <typename IndexType, typename ValueIterator1, typename ValueIterator2,
+         typename UnaryFunction, typename BinaryFunction>
+__global__ void
+spmv_csr_adaptive_long_fixup_kernel(const size_t num_rows,
+                                    const size_t * rows,
+                                    const size_t * offsets,
+                                    const ValueIterator1 carries,
+                                    ValueIterator2       y,
+                                    UnaryFunction initialize,
+                                    BinaryFunction reduce)
+{
+    typedef typename thrust::iterator_value<ValueIterator2>::type ValueType;
+
+    const size_t grid_size = blockDim.x * gridDim.x;
+
+    for(size_t k = blockDim.x * blockIdx.x + threadIdx.x; k < num_rows; k += grid_size)
+    {
+        const IndexType row = rows[k];
+
+        ValueType sum = ValueType(0);
+
+        for(size_t chunk = offsets[k]; chunk < offsets[k + 1]; chunk++)
+            sum = reduce(sum, ValueType(carries[chunk]));
+
+        y[row] = reduce(initialize(y[row]), sum);
+    }
+}
+
+// bins the rows of A, called once per operator
+template <typename MatrixType>
+void __build_csr_adaptive_plan(const MatrixType& A, csr_adaptive_plan& plan)
+{
+    typedef typename cusp::detail::get_offset_type<MatrixType>::type OffsetType;
+
+    cusp::array1d<OffsetType, cusp::host_memory> Ap(A.row_offsets);
+
+    std::vector<size_t> stream_blocks;
+    std::vector<size_t> vector_rows;
+    std::vector<size_t> long_rows;
+    std::vector<size_t> long_offsets(1, 0);
+    std::vector<size_t> chunk_begin;
+    std::vector<size_t> chunk_end;
+
+    size_t block_begin   = 0;
+    size_t block_entries = 0;
+
+    for(size_t row = 0; row <= A.num_rows; row++)
+    {
+        const size_t row_length = row < A.num_rows ? size_t(Ap[row + 1] - Ap[row]) : 0;
+        const bool   short_row  = row < A.num_rows && row_length <= CSR_ADAPTIVE_SHORT_ROW;
+
+        // close the current row block when the row does not fit in it
+        if(!short_row ||
+           row - block_begin == CSR_ADAPTIVE_BLOCK_SIZE ||
+           block_entries + row_length > CSR_ADAPTIVE_STREAM_ENTRIES)
+        {
+            if(row > block_begin)
+            {
+                stream_blocks.push_back(block_begin);
+                stream_blocks.push_back(row);
+            }
+
+            block_begin   = short_row ? row : row + 1;
+            block_entries = 0;
+        }
+
+        if(row == A.num_rows)
+            break;
+
+        if(short_row)
+        {
+            block_entries += row_length;
+        }
+        else if(row_length <= CSR_ADAPTIVE_LONG_ROW)
+        {
+            vector_rows.push_back(row);
+        }
+        else
+        {
+            long_rows.push_back(row);
+
+            for(size_t jj = Ap[row]; jj < size_t(Ap[row + 1]); jj += CSR_ADAPTIVE_LONG_CHUNK)
+            {
+                chunk_begin.push_back(jj);
+                chunk_end.push_back(std::min<size_t>(jj + CSR_ADAPTIVE_LONG_CHUNK, Ap[row + 1]));
+            }
+
+            long_offsets.push_back(chunk_begin.size());
+        }
+    }
+
+    plan.num_stream_blocks = stream_blocks.size() / 2;
+    plan.num_vector_rows   = vector_rows.size();
+    plan.num_long_rows     = long_rows.size();
+    plan.num_chunks        = chunk_begin.size();
+
+    std::vector<size_t> storage;
+    storage.insert(storage.end(), stream_blocks.begin(), stream_blocks.end());
+    storage.insert(storage.end(), vector_rows.begin(),   vector_rows.end());
+    storage.insert(storage.end(), long_rows.begin(),     long_rows.end());
+    storage.insert(storage.end(), long_offsets.begin(),  long_offsets.end());
+    storage.insert(storage.end(), chunk_begin.begin(),   chunk_begin.end());
+    storage.insert(storage.end(), chunk_end.begin(),     chunk_end.end());
+
+    if(cudaMalloc((void**) &plan.storage, storage.size() * sizeof(size_t)) != cudaSuccess)
+    {
+        plan.storage = 0;
+        throw cusp::runtime_exception("cudaMalloc failed while binning the rows for the CSR-Adaptive SpMV");
+    }
+
+    cudaMemcpy(plan.storage, &storage[0], storage.size() * sizeof(size_t), cudaMemcpyHostToDevice);
+
+    cudaEventCreateWithFlags(&plan.fork_event, cudaEventDisableTiming);
+
+    for(int i = 0; i < csr_adaptive_plan::NUM_STREAMS; i++)
+    {
+        cudaStreamCreateWithFlags(&plan.streams[i], cudaStreamNonBlocking);
+        cudaEventCreateWithFlags(&plan.join_events[i], cudaEventDisableTiming);
+    }
+}
+
+template <typename MatrixType>
+const csr_adaptive_plan& __csr_adaptive_plan(const MatrixType& A)
+{
+    std::map<spmv_tuning_key, csr_adaptive_plan>& plans = get_spmv_tuning_state().csr_adaptive_plans;
+
+    const spmv_tuning_key key = make_spmv_tuning_key(spmv_tuning_csr, A, A.column_indices);
+
+    // the plan is built once under the lock, threads sharing A wait for it
+#if __cplusplus >= 201103L
+    std::lock_guard<std::mutex> lock(get_spmv_tuning_state().mutex);
+#endif
+
+    std::map<spmv_tuning_key, csr_adaptive_plan>::iterator iter = plans.find(key);
+
+    if(iter == plans.end())
+    {
+        csr_adaptive_plan plan;
+        __build_csr_adaptive_plan(A, plan);
+        iter = plans.insert(std::make_pair(key, plan)).first;
+    }
+
+    return iter->second;
+}
+
+template <typename DerivedPolicy,
+         typename MatrixType,
+         typename VectorType1,
+         typename VectorType2,
+         typename UnaryFunction,
+         typename BinaryFunction1,
+         typename BinaryFunction2>
+void __spmv_csr_adaptive(cuda::execution_policy<DerivedPolicy>& exec,
+                         const MatrixType& A,
+                         const VectorType1& x,
+                         VectorType2& y,
+                         UnaryFunction   initialize,
+                         BinaryFunction1 combine,
+                         BinaryFunction2 reduce)
+{
+    // rows and entries are addressed with the type of the row offsets
+    typedef typename cusp::detail::get_offset_type<MatrixType>::type OffsetType;
+    typedef typename VectorType2::value_type ValueType;
+
+    typedef typename MatrixType::row_offsets_array_type::const_iterator     RowIterator;
+    typedef typename MatrixType::column_indices_array_type::const_iterator  ColumnIterator;
+    typedef typename MatrixType::values_array_type::const_iterator          ValueIterator1;
+
+    typedef typename VectorType1::const_iterator                            ValueIterator2;
+    typedef typename VectorType2::iterator                                  ValueIterator3;
+
+    typedef cusp::detail::temporary_array<ValueType, DerivedPolicy>         ValueArray;
+    typedef typename ValueArray::iterator                                   ValueIterator4;
+
+    const unsigned int BLOCK_SIZE        = CSR_ADAPTIVE_BLOCK_SIZE;
+    const unsigned int STREAM_ENTRIES    = CSR_ADAPTIVE_STREAM_ENTRIES;
+    const unsigned int VECTORS_PER_BLOCK = BLOCK_SIZE / 32;
+
+    if(A.num_rows == 0)
+        return;
+
+    const csr_adaptive_plan& plan = __csr_adaptive_plan(A);
+
+    const size_t * stream_blocks = plan.storage;
+    const size_t * vector_rows   = stream_blocks + 2 * plan.num_stream_blocks;
+    const size_t * long_rows     = vector_rows + plan.num_vector_rows;
+    const size_t * long_offsets  = long_rows + plan.num_long_rows;
+    const size_t * chunk_begin   = long_offsets + plan.num_long_rows + 1;
+    const size_t * chunk_end     = chunk_begin + plan.num_chunks;
+
+    cudaStream_t s = stream(thrust::detail::derived_cast(exec));
+
+    // the short and medium rows run beside the long rows on the plan streams,
+    // the fork event must not be recorded by another thread in between
+    {
+#if __cplusplus >= 201103L
+        std::lock_guard<std::mutex> lock(get_spmv_tuning_state().mutex);
+#endif
+
+        cudaEventRecord(plan.fork_event, s);
+
+        for(int i = 0; i < csr_adaptive_plan::NUM_STREAMS; i++)
+            cudaStreamWaitEvent(plan.streams[i], plan.fork_event, 0);
+    }
+
+    if(plan.num_stream_blocks > 0)
+    {
+        const size_t NUM_BLOCKS = cusp::system::cuda::detail::launch_blocks(
+                                      spmv_csr_adaptive_stream_kernel<OffsetType, RowIterator, ColumnIterator, ValueIterator1, ValueIterator2, ValueIterator3,
+                                      UnaryFunction, BinaryFunction1, BinaryFunction2, BLOCK_SIZE, STREAM_ENTRIES>,
+                                      BLOCK_SIZE, (size_t) 0,
+                                      plan.num_stream_blocks, 1);
+
+        spmv_csr_adaptive_stream_kernel<OffsetType, RowIterator, ColumnIterator, ValueIterator1, ValueIterator2, ValueIterator3,
+                                        UnaryFunction, BinaryFunction1, BinaryFunction2, BLOCK_SIZE, STREAM_ENTRIES>
+                                        <<<NUM_BLOCKS, BLOCK_SIZE, 0, plan.streams[0]>>>
+                                        (plan.num_stream_blocks, stream_blocks,
+                                         A.row_offsets.begin(), A.column_indices.begin(), A.values.begin(), x.begin(), y.begin(),
+                                         initialize, combine, reduce);
+    }
+
+    if(plan.num_vector_rows > 0)
+    {
+        const size_t NUM_BLOCKS = cusp::system::cuda::detail::launch_blocks(
+                                      spmv_csr_adaptive_vector_kernel<OffsetType, RowIterator, ColumnIterator, ValueIterator1, ValueIterator2, ValueIterator3,
+                                      UnaryFunction, BinaryFunction1, BinaryFunction2, VECTORS_PER_BLOCK>,
+                                      BLOCK_SIZE, (size_t) 0,
+                                      plan.num_vector_rows, VECTORS_PER_BLOCK);
+
+        spmv_csr_adaptive_vector_kernel<OffsetType, RowIterator, ColumnIterator, ValueIterator1, ValueIterator2, ValueIterator3,
+                                        UnaryFunction, BinaryFunction1, BinaryFunction2, VECTORS_PER_BLOCK>
+                                        <<<NUM_BLOCKS, BLOCK_SIZE, 0, plan.streams[1]>>>
+                                        (plan.num_vector_rows, vector_rows,
+                                         A.row_offsets.begin(), A.column_indices.begin(), A.values.begin(), x.begin(), y.begin(),
+                                         initialize, combine, reduce);
+    }
+
+    if(plan.num_long_rows > 0)
+    {
+        ValueArray carries(exec, plan.num_chunks);
+
+        const size_t NUM_BLOCKS = cusp::system::cuda::detail::launch_blocks(
+                                      spmv_csr_adaptive_long_kernel<OffsetType, ColumnIterator, ValueIterator1, ValueIterator2, ValueIterator4,
+                                      BinaryFunction1, BinaryFunction2, BLOCK_SIZE>,
+                                      BLOCK_SIZE, (size_t) 0,
+                                      plan.num_chunks, 1);
+
+        spmv_csr_adaptive_long_kernel<OffsetType, ColumnIterator, ValueIterator1, ValueIterator2, ValueIterator4,
+                                      BinaryFunction1, BinaryFunction2, BLOCK_SIZE>
+                                      <<<NUM_BLOCKS, BLOCK_SIZE, 0, s>>>
+                                      (plan.num_chunks, chunk_begin, chunk_end,
+                                       A.column_indices.begin(), A.values.begin(), x.begin(), carries.begin(),
+                                       combine, reduce);
+
+        const size_t NUM_FIXUP_BLOCKS = cusp::system::cuda::detail::launch_blocks(
+                                            spmv_csr_adaptive_long_fixup_kernel<OffsetType, ValueIterator4, ValueIterator3, UnaryFunction, BinaryFunction2>,
+                                            BLOCK_SIZE, (size_t) 0,
+                                            plan.num_long_rows, BLOCK_SIZE);
+
+        spmv_csr_adaptive_long_fixup_kernel<OffsetType, ValueIterator4, ValueIterator3, UnaryFunction, BinaryFunction2>
+            <<<NUM_FIXUP_BLOCKS, BLOCK_SIZE, 0, s>>>
+            (plan.num_long_rows, long_rows, long_offsets, carries.begin(), y.begin(), initialize, reduce);
+    }
+
+    // later work on s sees all of y, a join event recorded again by another
+    // thread meanwhile also covers this work
+    for(int i = 0; i < csr_adaptive_plan::NUM_STREAMS; i++)
+    {
+        cudaEventRecord(plan.join_events[i], plan.streams[i]);
+        cudaStreamWaitEvent(s, plan.join_events[i], 0);
+    }
+}
+
+} // end namespace detail
+} // end namespace cuda
+} // end namespace system
+} // end namespace cusp
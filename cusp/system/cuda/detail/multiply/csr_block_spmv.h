@@ -14,13 +14,15 @@
  *  limitations under the License.
  */
 
-
 #pragma once
 
+#include <cusp/detail/array2d_format_utils.h>
+
 #include <cusp/system/cuda/arch.h>
 #include <cusp/system/cuda/utils.h>
 
 #include <thrust/device_ptr.h>
+#include <thrust/extrema.h>
 
 #include <algorithm>
 
@@ -33,12 +35,33 @@ namespace cuda
 namespace detail
 {
 
-template <typename RowIterator, typename ColumnIterator, typename ValueIterator1,
+//////////////////////////////////////////////////////////////////////////////
+// CSR SpMM kernel for tall-skinny dense operands
+//////////////////////////////////////////////////////////////////////////////
+//
+// BlockSpmvKernel
+//   Multiplies a CSR matrix A by a dense matrix X with k columns.  Each row
+//   of A is assigned to a vector of THREADS_PER_VECTOR threads which stages
+//   a chunk of the row's column indices and values in shared memory.  Every
+//   thread of the vector then accumulates COLS_PER_THREAD columns of Y in
+//   registers, so the entries of A are read once for up to
+//   THREADS_PER_VECTOR * COLS_PER_THREAD columns of X.  Wider operands are
+//   processed in tiles of that many columns.
+//
+//   X and Y may be stored in row-major or column-major order.  With row-major
+//   storage consecutive threads of a vector access consecutive entries of a
+//   row of X, which yields coalesced loads.
+
+template <typename IndexType, typename RowIterator, typename ColumnIterator, typename ValueIterator1,
          typename ValueIterator2, typename ValueIterator3,
+         typename Orientation1, typename Orientation2,
          typename UnaryFunction, typename BinaryFunction1, typename BinaryFunction2,
-         unsigned int VECTORS_PER_BLOCK, unsigned int THREADS_PER_VECTOR>
+         unsigned int VECTORS_PER_BLOCK, unsigned int THREADS_PER_VECTOR, unsigned int COLS_PER_THREAD>
 __launch_bounds__(VECTORS_PER_BLOCK * THREADS_PER_VECTOR,1)
-__global__ void BlockSpmvKernel(const unsigned int A_num_rows,
+__global__ void BlockSpmvKernel(const IndexType A_num_rows,
+                                const IndexType X_num_cols,
+                                const IndexType X_pitch,
+                                const IndexType Y_pitch,
                                 const RowIterator A_row_offsets,
                                 const ColumnIterator A_column_indices,
                                 const ValueIterator1 A_values,
@@ -48,88 +71,86 @@ __global__ void BlockSpmvKernel(const unsigned int A_num_rows,
                                 BinaryFunction1 combine,
                                 BinaryFunction2 reduce)
 {
-    typedef typename thrust::iterator_value<RowIterator>::type    IndexType;
-    typedef typename thrust::iterator_value<ValueIterator1>::type ValueType;
+    typedef typename thrust::iterator_value<ValueIterator3>::type ValueType;
 
     __shared__ volatile IndexType ptrs[VECTORS_PER_BLOCK][2];
-    __shared__ volatile IndexType sdata[VECTORS_PER_BLOCK * THREADS_PER_VECTOR + THREADS_PER_VECTOR / 2];  // padded to avoid reduction conditionals
-    __shared__ volatile ValueType vdata[VECTORS_PER_BLOCK * THREADS_PER_VECTOR + THREADS_PER_VECTOR / 2];  // padded to avoid reduction conditionals
+    __shared__ volatile IndexType sdata[VECTORS_PER_BLOCK * THREADS_PER_VECTOR];
+    __shared__ volatile ValueType vdata[VECTORS_PER_BLOCK * THREADS_PER_VECTOR];
 
-    const int THREADS_PER_BLOCK = VECTORS_PER_BLOCK * THREADS_PER_VECTOR;
+    const IndexType THREADS_PER_BLOCK = VECTORS_PER_BLOCK * THREADS_PER_VECTOR;
+    const IndexType COLS_PER_TILE     = THREADS_PER_VECTOR * COLS_PER_THREAD;
 
-    const int thread_id   = THREADS_PER_BLOCK * blockIdx.x + threadIdx.x;    // global thread index
-    const int thread_lane = threadIdx.x & (THREADS_PER_VECTOR - 1);          // thread index within the vector
-    const int vector_id   = thread_id   /  THREADS_PER_VECTOR;               // global vector index
-    const int vector_lane = threadIdx.x /  THREADS_PER_VECTOR;               // vector index within the block
-    const int num_vectors = VECTORS_PER_BLOCK * gridDim.x;                   // total number of active vectors
+    const IndexType thread_id   = THREADS_PER_BLOCK * blockIdx.x + threadIdx.x;    // global thread index
+    const IndexType thread_lane = threadIdx.x & (THREADS_PER_VECTOR - 1);          // thread index within the vector
+    const IndexType vector_id   = thread_id   /  THREADS_PER_VECTOR;               // global vector index
+    const IndexType vector_lane = threadIdx.x /  THREADS_PER_VECTOR;               // vector index within the block
+    const IndexType num_vectors = VECTORS_PER_BLOCK * gridDim.x;                   // total number of active vectors
+
+    volatile IndexType * columns = sdata + vector_lane * THREADS_PER_VECTOR;
+    volatile ValueType * values  = vdata + vector_lane * THREADS_PER_VECTOR;
 
     for(IndexType row = vector_id; row < A_num_rows; row += num_vectors)
     {
         // use two threads to fetch Ap[row] and Ap[row+1]
-        // this is considerably faster than the straightforward version
         if(thread_lane < 2)
             ptrs[vector_lane][thread_lane] = A_row_offsets[row + thread_lane];
 
         const IndexType row_start = ptrs[vector_lane][0];                   //same as: row_start = Ap[row];
         const IndexType row_end   = ptrs[vector_lane][1];                   //same as: row_end   = Ap[row+1];
 
-        // initialize local sum
-        // ValueType sum = X_values[row*THREADS_PER_VECTOR + thread_lane] * (row_end - row_start);
-        ValueType sum = initialize(Y_values[row * THREADS_PER_VECTOR + thread_lane]);
-
-        // accumulate local sums
-        // for(IndexType jj = row_start; jj < row_end; jj += THREADS_PER_VECTOR)
-        // {
-        //     int num_cols = row_end - jj;
-
-        //     if(num_cols < THREADS_PER_VECTOR)
-        //     {
-        //         sdata[threadIdx.x] = thread_lane < num_cols ? A_column_indices[jj + thread_lane] : 0;
-
-        //         for(IndexType kk = 0; kk < num_cols; kk++)
-        //         {
-        //             IndexType col = sdata[vector_lane*THREADS_PER_VECTOR + kk];
-        //             sum -= X_values[col*THREADS_PER_VECTOR + thread_lane];
-        //         }
-        //     }
-        //     else
-        //     {
-        //         sdata[threadIdx.x] = A_column_indices[jj + thread_lane];
-
-        //         #pragma unroll
-        //         for(IndexType kk = 0; kk < THREADS_PER_VECTOR; kk++)
-        //         {
-        //             IndexType col = sdata[vector_lane*THREADS_PER_VECTOR + kk];
-        //             sum -= X_values[col*THREADS_PER_VECTOR + thread_lane];
-        //         }
-        //     }
-        // }
-        for(IndexType jj = row_start; jj < row_end; jj += THREADS_PER_VECTOR)
+        for(IndexType tile = 0; tile < X_num_cols; tile += COLS_PER_TILE)
         {
-            int num_cols = min(THREADS_PER_VECTOR,row_end - jj);
+            ValueType sum[COLS_PER_THREAD];
 
-            sdata[threadIdx.x] = 0;
-            vdata[threadIdx.x] = 0;
+            #pragma unroll
+            for(unsigned int c = 0; c < COLS_PER_THREAD; c++)
+            {
+                const IndexType k = tile + c * THREADS_PER_VECTOR + thread_lane;
 
-            if( thread_lane < num_cols )
+                if(k < X_num_cols)
+                    sum[c] = initialize(Y_values[cusp::detail::index_of(row, k, Y_pitch, Orientation2())]);
+            }
+
+            for(IndexType jj = row_start; jj < row_end; jj += THREADS_PER_VECTOR)
             {
-                sdata[threadIdx.x] = A_column_indices[jj + thread_lane];
-                vdata[threadIdx.x] = A_values[jj + thread_lane];
+                const IndexType num_entries = thrust::min(IndexType(THREADS_PER_VECTOR), row_end - jj);
+
+                if(thread_lane < num_entries)
+                {
+                    columns[thread_lane] = A_column_indices[jj + thread_lane];
+                    values[thread_lane]  = A_values[jj + thread_lane];
+                }
+
+                for(IndexType kk = 0; kk < num_entries; kk++)
+                {
+                    const IndexType col = columns[kk];
+                    const ValueType val = values[kk];
+
+                    #pragma unroll
+                    for(unsigned int c = 0; c < COLS_PER_THREAD; c++)
+                    {
+                        const IndexType k = tile + c * THREADS_PER_VECTOR + thread_lane;
+
+                        if(k < X_num_cols)
+                            sum[c] = reduce(sum[c], combine(val, X_values[cusp::detail::index_of(col, k, X_pitch, Orientation1())]));
+                    }
+                }
             }
 
-            for(IndexType kk = 0; kk < num_cols; kk++)
+            #pragma unroll
+            for(unsigned int c = 0; c < COLS_PER_THREAD; c++)
             {
-                IndexType col = sdata[vector_lane*THREADS_PER_VECTOR + kk];
-                ValueType val = vdata[vector_lane*THREADS_PER_VECTOR + kk];
-                sum = reduce(sum, combine(val, X_values[col*THREADS_PER_VECTOR + thread_lane]));
+                const IndexType k = tile + c * THREADS_PER_VECTOR + thread_lane;
+
+                if(k < X_num_cols)
+                    Y_values[cusp::detail::index_of(row, k, Y_pitch, Orientation2())] = sum[c];
             }
         }
-
-        Y_values[row*THREADS_PER_VECTOR + thread_lane] = sum;
     }
 }
 
-template<unsigned int NUM_COLS,
+template<unsigned int THREADS_PER_VECTOR,
+         unsigned int COLS_PER_THREAD,
          typename DerivedPolicy,
          typename MatrixType,
          typename VectorType1,
@@ -146,7 +167,6 @@ void __spmv_csr_block(cuda::execution_policy<DerivedPolicy>& exec,
                       BinaryFunction2 reduce)
 {
     typedef typename MatrixType::index_type IndexType;
-    typedef typename MatrixType::value_type ValueType;
 
     typedef typename MatrixType::row_offsets_array_type::const_iterator     RowIterator;
     typedef typename MatrixType::column_indices_array_type::const_iterator  ColumnIterator;
@@ -155,24 +175,32 @@ void __spmv_csr_block(cuda::execution_policy<DerivedPolicy>& exec,
     typedef typename VectorType1::values_array_type::const_iterator         ValueIterator2;
     typedef typename VectorType2::values_array_type::iterator               ValueIterator3;
 
+    typedef typename VectorType1::orientation                               Orientation1;
+    typedef typename VectorType2::orientation                               Orientation2;
+
     const size_t THREADS_PER_BLOCK  = 256;
-    const size_t THREADS_PER_VECTOR = NUM_COLS;
     const size_t VECTORS_PER_BLOCK  = THREADS_PER_BLOCK / THREADS_PER_VECTOR;
+
+    if(A.num_rows == 0)
+        return;
+
     const size_t MAX_BLOCKS = cusp::system::cuda::detail::max_active_blocks(
-                                  BlockSpmvKernel<RowIterator, ColumnIterator, ValueIterator1, ValueIterator2, ValueIterator3,
+                                  BlockSpmvKernel<IndexType, RowIterator, ColumnIterator, ValueIterator1, ValueIterator2, ValueIterator3,
+                                  Orientation1, Orientation2,
                                   UnaryFunction, BinaryFunction1, BinaryFunction2,
-                                  VECTORS_PER_BLOCK, THREADS_PER_VECTOR>,
+                                  VECTORS_PER_BLOCK, THREADS_PER_VECTOR, COLS_PER_THREAD>,
                                   THREADS_PER_BLOCK, (size_t) 0);
-    const size_t NUM_BLOCKS = std::min(20 * MAX_BLOCKS, DIVIDE_INTO(A.num_rows, VECTORS_PER_BLOCK));
+    const size_t NUM_BLOCKS = std::min<size_t>(20 * MAX_BLOCKS, DIVIDE_INTO(A.num_rows, VECTORS_PER_BLOCK));
 
     cudaStream_t s = stream(thrust::detail::derived_cast(exec));
 
-    // Reduce tiles into reduceDevice.
-    BlockSpmvKernel<RowIterator, ColumnIterator, ValueIterator1, ValueIterator2, ValueIterator3,
+    BlockSpmvKernel<IndexType, RowIterator, ColumnIterator, ValueIterator1, ValueIterator2, ValueIterator3,
+                    Orientation1, Orientation2,
                     UnaryFunction, BinaryFunction1, BinaryFunction2,
-                    VECTORS_PER_BLOCK, THREADS_PER_VECTOR>
+                    VECTORS_PER_BLOCK, THREADS_PER_VECTOR, COLS_PER_THREAD>
       <<<NUM_BLOCKS, THREADS_PER_BLOCK, 0, s>>>
-      (A.num_rows, A.row_offsets.begin(), A.column_indices.begin(), A.values.begin(),
+      (IndexType(A.num_rows), IndexType(x.num_cols), IndexType(x.pitch), IndexType(y.pitch),
+       A.row_offsets.begin(), A.column_indices.begin(), A.values.begin(),
        x.values.begin(), y.values.begin(),
        initialize, combine, reduce);
 }
@@ -195,32 +223,43 @@ void multiply(cuda::execution_policy<DerivedPolicy>& exec,
               cusp::array2d_format,
               cusp::array2d_format)
 {
-    if (x.num_cols ==  1) {
+    typedef typename VectorType1::orientation Orientation1;
+    typedef typename VectorType2::orientation Orientation2;
+
+    // a single column stored contiguously is an ordinary SpMV
+    if (x.num_cols == 1 &&
+        cusp::detail::index_of(size_t(1), size_t(0), size_t(x.pitch), Orientation1()) == 1 &&
+        cusp::detail::index_of(size_t(1), size_t(0), size_t(y.pitch), Orientation2()) == 1) {
         multiply(exec, A, x.values, y.values, initialize, combine, reduce);
         return;
     }
     if (x.num_cols <=  2) {
-        __spmv_csr_block<2>(exec, A, x, y, initialize, combine, reduce);
+        __spmv_csr_block<2,1>(exec, A, x, y, initialize, combine, reduce);
         return;
     }
     if (x.num_cols <=  4) {
-        __spmv_csr_block<4>(exec, A, x, y, initialize, combine, reduce);
+        __spmv_csr_block<4,1>(exec, A, x, y, initialize, combine, reduce);
         return;
     }
     if (x.num_cols <=  8) {
-        __spmv_csr_block<8>(exec, A, x, y, initialize, combine, reduce);
+        __spmv_csr_block<8,1>(exec, A, x, y, initialize, combine, reduce);
         return;
     }
     if (x.num_cols <= 16) {
-        __spmv_csr_block<16>(exec, A, x, y, initialize, combine, reduce);
+        __spmv_csr_block<16,1>(exec, A, x, y, initialize, combine, reduce);
+        return;
+    }
+    if (x.num_cols <= 32) {
+        __spmv_csr_block<32,1>(exec, A, x, y, initialize, combine, reduce);
         return;
     }
 
-    __spmv_csr_block<32>(exec, A, x, y, initialize, combine, reduce);
+    // up to 64 columns are accumulated in a single pass over A, wider
+    // operands are processed in tiles of 64 columns
+    __spmv_csr_block<32,2>(exec, A, x, y, initialize, combine, reduce);
 }
 
 } // end namespace detail
 } // end namespace cuda
 } // end namespace system
 } // end namespace cusp
-
@@ -0,0 +1,312 @@
+/*
+ *  Copyright 2008-2014 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#pragma once
+
+#include <cusp/array1d.h>
+#include <cusp/complex.h>
+
+#include <cusp/system/cuda/arch.h>
+#include <cusp/system/cuda/utils.h>
+
+#include <thrust/functional.h>
+#include <thrust/detail/type_traits.h>
+
+namespace cusp
+{
+namespace system
+{
+namespace cuda
+{
+namespace detail
+{
+
+//////////////////////////////////////////////////////////////////////////////
+// CSR SpMV kernel specialized for complex values (one vector per row)
+//////////////////////////////////////////////////////////////////////////////
+//
+// spmv_csr_complex_kernel
+//   Same decomposition as spmv_csr_vector_kernel for y = A * x with
+//   cusp::complex<float> or cusp::complex<double> values.  Every entry of
+//   A and x is read with a single 64-bit (float2) or 128-bit (double2)
+//   load instead of two scalar loads, x goes through the read-only cache,
+//   and the threads of a vector accumulate the real and imaginary parts
+//   separately and combine them with warp shuffles rather than through
+//   volatile complex values in shared memory.
+//
+//  Note: THREADS_PER_VECTOR must be one of [2,4,8,16,32]
+
+// vector type matching the layout of a complex value
+template <typename ValueType>
+struct csr_complex_vector_type
+{
+    typedef thrust::detail::false_type is_specialized;
+};
+
+template <>
+struct csr_complex_vector_type< cusp::complex<float> >
+{
+    typedef thrust::detail::true_type is_specialized;
+    typedef float2                    type;
+};
+
+template <>
+struct csr_complex_vector_type< cusp::complex<double> >
+{
+    typedef thrust::detail::true_type is_specialized;
+    typedef double2                   type;
+};
+
+// the kernel reads through raw pointers, so the arrays must be stored
+// contiguously in device memory
+template <typename Iterator, typename T>
+struct csr_complex_device_iterator
+  : thrust::detail::or_<
+      thrust::detail::is_same<Iterator, typename cusp::array1d<T,cusp::device_memory>::iterator>,
+      thrust::detail::is_same<Iterator, typename cusp::array1d<T,cusp::device_memory>::const_iterator>
+    >
+{};
+
+template <typename MatrixType, typename VectorType1, typename VectorType2>
+struct csr_complex_spmv_storage
+  : thrust::detail::and_<
+      csr_complex_device_iterator<typename MatrixType::row_offsets_array_type::const_iterator,
+                                  typename MatrixType::row_offsets_array_type::value_type>,
+      csr_complex_device_iterator<typename MatrixType::column_indices_array_type::const_iterator,
+                                  typename MatrixType::index_type>,
+      csr_complex_device_iterator<typename MatrixType::values_array_type::const_iterator,
+                                  typename VectorType2::value_type>,
+      csr_complex_device_iterator<typename VectorType1::const_iterator,
+                                  typename VectorType2::value_type>,
+      csr_complex_device_iterator<typename VectorType2::iterator,
+                                  typename VectorType2::value_type>
+    >
+{};
+
+template <typename MatrixType, typename VectorType1, typename VectorType2,
+          typename BinaryFunction1, typename BinaryFunction2>
+struct csr_complex_spmv_supported
+  : thrust::detail::and_<
+      typename csr_complex_vector_type<typename VectorType2::value_type>::is_specialized,
+      thrust::detail::is_same<BinaryFunction1, thrust::multiplies<typename VectorType2::value_type> >,
+      thrust::detail::is_same<BinaryFunction2, thrust::plus<typename VectorType2::value_type> >,
+      csr_complex_spmv_storage<MatrixType, VectorType1, VectorType2>
+    >
+{};
+
+template <typename VectorType>
+__device__ __forceinline__
+VectorType csr_complex_load_x(const VectorType * x)
+{
+#if __CUDA_ARCH__ >= 350
+    return __ldg(x);
+#else
+    return *x;
+#endif
+}
+
+template <typename RealType>
+__device__ __forceinline__
+RealType csr_complex_shfl_down(const RealType value, const unsigned int delta,
+                               const unsigned int mask, const int width)
+{
+#if CUDART_VERSION >= 9000
+    return __shfl_down_sync(mask, value, delta, width);
+#else
+    return __shfl_down(value, delta, width);
+#endif
+}
+
+template <typename OffsetType, typename IndexType, typename ValueType, typename VectorType,
+         typename UnaryFunction,
+         unsigned int VECTORS_PER_BLOCK, unsigned int THREADS_PER_VECTOR>
+__global__ void
+spmv_csr_complex_kernel(const unsigned int num_rows,
+                        const OffsetType * Ap,
+                        const IndexType  * Aj,
+                        const VectorType * Ax,
+                        const VectorType * x,
+                        VectorType       * y,
+                        UnaryFunction initialize)
+{
+    typedef typename ValueType::value_type RealType;
+
+    const OffsetType THREADS_PER_BLOCK = VECTORS_PER_BLOCK * THREADS_PER_VECTOR;
+
+    const OffsetType thread_id   = THREADS_PER_BLOCK * blockIdx.x + threadIdx.x;    // global thread index
+    const OffsetType thread_lane = threadIdx.x & (THREADS_PER_VECTOR - 1);          // thread index within the vector
+    const OffsetType vector_id   = thread_id   /  THREADS_PER_VECTOR;               // global vector index
+    const OffsetType num_vectors = VECTORS_PER_BLOCK * gridDim.x;                   // total number of active vectors
+
+    // lanes of the warp holding the threads of this vector
+    const unsigned int warp_lane = threadIdx.x & 31;
+    const unsigned int mask = (THREADS_PER_VECTOR == 32) ? 0xffffffffu :
+                              (((1u << THREADS_PER_VECTOR) - 1) << (warp_lane & ~(THREADS_PER_VECTOR - 1)));
+
+    for(OffsetType row = vector_id; row < num_rows; row += num_vectors)
+    {
+        const OffsetType row_start = Ap[row];
+        const OffsetType row_end   = Ap[row + 1];
+
+        RealType sum_re = RealType(0);
+        RealType sum_im = RealType(0);
+
+        if (thread_lane == 0)
+        {
+            const VectorType y_row = y[row];
+            const ValueType  init  = initialize(ValueType(y_row.x, y_row.y));
+
+            sum_re = init.real();
+            sum_im = init.imag();
+        }
+
+        OffsetType jj = row_start + thread_lane;
+
+        // ensure aligned memory access to Aj and Ax
+        if (THREADS_PER_VECTOR == 32 && row_end - row_start > 32)
+            jj -= row_start & (THREADS_PER_VECTOR - 1);
+
+        for(; jj < row_end; jj += THREADS_PER_VECTOR)
+        {
+            if (jj < row_start)
+                continue;
+
+            const VectorType a = Ax[jj];
+            const VectorType b = csr_complex_load_x(x + Aj[jj]);
+
+            sum_re += a.x * b.x - a.y * b.y;
+            sum_im += a.x * b.y + a.y * b.x;
+        }
+
+        // reduce local sums to the row sum
+        for(unsigned int offset = THREADS_PER_VECTOR / 2; offset > 0; offset /= 2)
+        {
+            sum_re += csr_complex_shfl_down(sum_re, offset, mask, THREADS_PER_VECTOR);
+            sum_im += csr_complex_shfl_down(sum_im, offset, mask, THREADS_PER_VECTOR);
+        }
+
+        // first thread writes the result
+        if (thread_lane == 0)
+        {
+            VectorType result;
+            result.x = sum_re;
+            result.y = sum_im;
+
+            y[row] = result;
+        }
+    }
+}
+
+template <unsigned int THREADS_PER_VECTOR,
+         unsigned int THREADS_PER_BLOCK,
+         typename DerivedPolicy,
+         typename MatrixType,
+         typename VectorType1,
+         typename VectorType2,
+         typename UnaryFunction,
+         typename BinaryFunction1,
+         typename BinaryFunction2>
+bool __spmv_csr_complex(cuda::execution_policy<DerivedPolicy>& exec,
+                        const MatrixType& A,
+                        const VectorType1& x,
+                        VectorType2& y,
+                        UnaryFunction   initialize,
+                        BinaryFunction1 combine,
+                        BinaryFunction2 reduce,
+                        thrust::detail::true_type)
+{
+    typedef typename MatrixType::row_offsets_array_type::value_type OffsetType;
+    typedef typename MatrixType::index_type                         IndexType;
+    typedef typename VectorType2::value_type                        ValueType;
+    typedef typename csr_complex_vector_type<ValueType>::type       VectorType;
+
+    const size_t VECTORS_PER_BLOCK  = THREADS_PER_BLOCK / THREADS_PER_VECTOR;
+
+    const OffsetType * Ap = thrust::raw_pointer_cast(&A.row_offsets[0]);
+    const IndexType  * Aj = A.num_entries > 0 ? thrust::raw_pointer_cast(&A.column_indices[0]) : 0;
+    const VectorType * Ax = A.num_entries > 0 ? reinterpret_cast<const VectorType *>(thrust::raw_pointer_cast(&A.values[0])) : 0;
+
+    const VectorType * x_ptr = A.num_cols > 0 ? reinterpret_cast<const VectorType *>(thrust::raw_pointer_cast(&x[0])) : 0;
+    VectorType       * y_ptr = reinterpret_cast<VectorType *>(thrust::raw_pointer_cast(&y[0]));
+
+    const size_t NUM_BLOCKS = cusp::system::cuda::detail::launch_blocks(
+                                  spmv_csr_complex_kernel<OffsetType, IndexType, ValueType, VectorType, UnaryFunction,
+                                  VECTORS_PER_BLOCK, THREADS_PER_VECTOR>, THREADS_PER_BLOCK, (size_t) 0,
+                                  A.num_rows, VECTORS_PER_BLOCK);
+
+    cudaStream_t s = stream(thrust::detail::derived_cast(exec));
+
+    spmv_csr_complex_kernel<OffsetType, IndexType, ValueType, VectorType, UnaryFunction,
+                            VECTORS_PER_BLOCK, THREADS_PER_VECTOR> <<<NUM_BLOCKS, THREADS_PER_BLOCK, 0, s>>>
+                            (A.num_rows, Ap, Aj, Ax, x_ptr, y_ptr, initialize);
+
+    return true;
+}
+
+template <unsigned int THREADS_PER_VECTOR,
+         unsigned int THREADS_PER_BLOCK,
+         typename DerivedPolicy,
+         typename MatrixType,
+         typename VectorType1,
+         typename VectorType2,
+         typename UnaryFunction,
+         typename BinaryFunction1,
+         typename BinaryFunction2>
+bool __spmv_csr_complex(cuda::execution_policy<DerivedPolicy>& exec,
+                        const MatrixType& A,
+                        const VectorType1& x,
+                        VectorType2& y,
+                        UnaryFunction   initialize,
+                        BinaryFunction1 combine,
+                        BinaryFunction2 reduce,
+                        thrust::detail::false_type)
+{
+    return false;
+}
+
+// runs the complex kernel when A, x and y hold the same complex type in
+// contiguous device storage and the operators are the default product and
+// sum, returns false otherwise
+template <unsigned int THREADS_PER_VECTOR,
+         unsigned int THREADS_PER_BLOCK,
+         typename DerivedPolicy,
+         typename MatrixType,
+         typename VectorType1,
+         typename VectorType2,
+         typename UnaryFunction,
+         typename BinaryFunction1,
+         typename BinaryFunction2>
+bool __try_spmv_csr_complex(cuda::execution_policy<DerivedPolicy>& exec,
+                            const MatrixType& A,
+                            const VectorType1& x,
+                            VectorType2& y,
+                            UnaryFunction   initialize,
+                            BinaryFunction1 combine,
+                            BinaryFunction2 reduce)
+{
+    typedef csr_complex_spmv_supported<MatrixType, VectorType1, VectorType2,
+                                       BinaryFunction1, BinaryFunction2> IsSupported;
+
+    if (A.num_rows == 0)
+        return false;
+
+    return __spmv_csr_complex<THREADS_PER_VECTOR, THREADS_PER_BLOCK>(exec, A, x, y, initialize, combine, reduce, IsSupported());
+}
+
+} // end namespace detail
+} // end namespace cuda
+} // end namespace system
+} // end namespace cusp
@@ -0,0 +1,275 @@
+/*
+ *  Copyright 2008-2014 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+
+#pragma once
+
+#include <cusp/format_utils.h>
+
+#include <cusp/detail/temporary_array.h>
+#include <cusp/detail/type_traits.h>
+
+#include <cusp/system/cuda/arch.h>
+#include <cusp/system/cuda/utils.h>
+
+#include <thrust/extrema.h>
+#include <thrust/pair.h>
+#include <thrust/reduce.h>
+
+#include <algorithm>
+
+namespace cusp
+{
+namespace system
+{
+namespace cuda
+{
+namespace detail
+{
+
+//////////////////////////////////////////////////////////////////////////////
+// CSR SpMV kernels based on a merge-path decomposition
+//////////////////////////////////////////////////////////////////////////////
+//
+// spmv_csr_merge_kernel
+//   The SpMV is viewed as a merge of the row end offsets (Ap[1:]) with the
+//   sequence of nonzero indices [0, num_entries).  Each thread is assigned
+//   an equal share, ITEMS_PER_THREAD, of the num_rows + num_entries merge
+//   items and locates its starting coordinate with a binary search along
+//   the corresponding cross diagonal.  Every thread therefore performs the
+//   same amount of work regardless of the distribution of row lengths.
+//   Rows completed by a thread are written directly to y, while the partial
+//   sum of the row in which a thread stops is written to a carry-out array.
+//
+// spmv_csr_merge_fixup_kernel
+//   Carry-out values are reduced by row and folded into y.  Each row is
+//   completed by exactly one thread in the first pass, so folding the
+//   carries afterwards requires no synchronization between threads.
+//
+//  Note: initialize is applied once per row by the thread which completes
+//        the row, all other partial sums start from ValueType(0).
+
+template <typename IndexType, typename RowIterator>
+__device__ __forceinline__
+thrust::pair<IndexType,IndexType>
+merge_path_search(const IndexType diagonal,
+                  const RowIterator row_end_offsets,
+                  const IndexType num_rows,
+                  const IndexType num_entries)
+{
+    IndexType x_min = diagonal > num_entries ? diagonal - num_entries : IndexType(0);
+    IndexType x_max = diagonal < num_rows ? diagonal : num_rows;
+
+    while(x_min < x_max)
+    {
+        const IndexType pivot = (x_min + x_max) >> 1;
+
+        if(IndexType(row_end_offsets[pivot]) <= diagonal - pivot - 1)
+            x_min = pivot + 1;  // contract range up A (down B)
+        else
+            x_max = pivot;      // contract range down A (up B)
+    }
+
+    return thrust::make_pair(x_min, diagonal - x_min);
+}
+
+template <typename IndexType, typename RowIterator, typename ColumnIterator, typename ValueIterator1,
+         typename ValueIterator2, typename ValueIterator3,
+         typename IndexIterator, typename ValueIterator4,
+         typename UnaryFunction, typename BinaryFunction1, typename BinaryFunction2,
+         unsigned int ITEMS_PER_THREAD>
+__global__ void
+spmv_csr_merge_kernel(const IndexType num_rows,
+                      const IndexType num_entries,
+                      const IndexType num_threads,
+                      const RowIterator    Ap,
+                      const ColumnIterator Aj,
+                      const ValueIterator1 Ax,
+                      const ValueIterator2  x,
+                      ValueIterator3        y,
+                      IndexIterator        carry_rows,
+                      ValueIterator4       carry_values,
+                      UnaryFunction initialize,
+                      BinaryFunction1 combine,
+                      BinaryFunction2 reduce)
+{
+    typedef typename thrust::iterator_value<ValueIterator3>::type ValueType;
+
+    const IndexType thread_id = blockDim.x * blockIdx.x + threadIdx.x;
+
+    if(thread_id >= num_threads)
+        return;
+
+    const IndexType num_merge_items = num_rows + num_entries;
+    const IndexType diagonal_start  = thrust::min(IndexType(thread_id * ITEMS_PER_THREAD), num_merge_items);
+    const IndexType diagonal_end    = thrust::min(IndexType(diagonal_start + ITEMS_PER_THREAD), num_merge_items);
+
+    // row end offsets are Ap[1:num_rows+1]
+    const RowIterator row_end_offsets = Ap + 1;
+
+    thrust::pair<IndexType,IndexType> start = merge_path_search(diagonal_start, row_end_offsets, num_rows, num_entries);
+    thrust::pair<IndexType,IndexType> end   = merge_path_search(diagonal_end,   row_end_offsets, num_rows, num_entries);
+
+    IndexType row = start.first;
+    IndexType nz  = start.second;
+
+    ValueType sum = ValueType(0);
+
+    // consume all rows which end within this thread's share of the merge path
+    for(; row < end.first; row++)
+    {
+        const IndexType row_end = row_end_offsets[row];
+
+        for(; nz < row_end; nz++)
+            sum = reduce(sum, combine(Ax[nz], x[Aj[nz]]));
+
+        y[row] = reduce(initialize(y[row]), sum);
+        sum = ValueType(0);
+    }
+
+    // accumulate the partial sum of the row in which this thread stops
+    for(; nz < end.second; nz++)
+        sum = reduce(sum, combine(Ax[nz], x[Aj[nz]]));
+
+    carry_rows[thread_id]   = end.first;
+    carry_values[thread_id] = sum;
+}
+
+template <typename IndexType, typename IndexIterator, typename ValueIterator1, typename ValueIterator2,
+         typename BinaryFunction>
+__global__ void
+spmv_csr_merge_fixup_kernel(const IndexType num_carries,
+                            const IndexType num_rows,
+                            const IndexIterator  carry_rows,
+                            const ValueIterator1 carry_values,
+                            ValueIterator2       y,
+                            BinaryFunction reduce)
+{
+    const IndexType grid_size = blockDim.x * gridDim.x;
+
+    for(IndexType i = blockDim.x * blockIdx.x + threadIdx.x; i < num_carries; i += grid_size)
+    {
+        const IndexType row = carry_rows[i];
+
+        // threads which stop at the end of the merge path have nothing to carry
+        if(row < num_rows)
+            y[row] = reduce(y[row], carry_values[i]);
+    }
+}
+
+template <typename DerivedPolicy,
+         typename MatrixType,
+         typename VectorType1,
+         typename VectorType2,
+         typename UnaryFunction,
+         typename BinaryFunction1,
+         typename BinaryFunction2>
+void __spmv_csr_merge(cuda::execution_policy<DerivedPolicy>& exec,
+                      const MatrixType& A,
+                      const VectorType1& x,
+                      VectorType2& y,
+                      UnaryFunction   initialize,
+                      BinaryFunction1 combine,
+                      BinaryFunction2 reduce)
+{
+    // merge path coordinates count rows plus entries, so they use the
+    // type of the row offsets
+    typedef typename cusp::detail::get_offset_type<MatrixType>::type OffsetType;
+    typedef typename VectorType2::value_type ValueType;
+
+    typedef typename MatrixType::row_offsets_array_type::const_iterator     RowIterator;
+    typedef typename MatrixType::column_indices_array_type::const_iterator  ColumnIterator;
+    typedef typename MatrixType::values_array_type::const_iterator          ValueIterator1;
+
+    typedef typename VectorType1::const_iterator                            ValueIterator2;
+    typedef typename VectorType2::iterator                                  ValueIterator3;
+
+    typedef cusp::detail::temporary_array<OffsetType, DerivedPolicy>        IndexArray;
+    typedef cusp::detail::temporary_array<ValueType, DerivedPolicy>         ValueArray;
+
+    typedef typename IndexArray::iterator                                   IndexIterator;
+    typedef typename ValueArray::iterator                                   ValueIterator4;
+
+    const unsigned int ITEMS_PER_THREAD  = sizeof(ValueType) > 4 ? 5 : 7;
+    const size_t       THREADS_PER_BLOCK = 128;
+
+    if(A.num_rows == 0)
+        return;
+
+    const OffsetType num_merge_items = A.num_rows + A.num_entries;
+    const OffsetType num_threads     = DIVIDE_INTO(num_merge_items, ITEMS_PER_THREAD);
+    const size_t     NUM_BLOCKS      = DIVIDE_INTO(num_threads, THREADS_PER_BLOCK);
+
+    IndexArray carry_rows(exec, num_threads);
+    ValueArray carry_values(exec, num_threads);
+
+    cudaStream_t s = stream(thrust::detail::derived_cast(exec));
+
+    spmv_csr_merge_kernel<OffsetType, RowIterator, ColumnIterator, ValueIterator1, ValueIterator2, ValueIterator3,
+                          IndexIterator, ValueIterator4,
+                          UnaryFunction, BinaryFunction1, BinaryFunction2,
+                          ITEMS_PER_THREAD> <<<NUM_BLOCKS, THREADS_PER_BLOCK, 0, s>>>
+                          (A.num_rows, A.num_entries, num_threads,
+                           A.row_offsets.begin(), A.column_indices.begin(), A.values.begin(), x.begin(), y.begin(),
+                           carry_rows.begin(), carry_values.begin(),
+                           initialize, combine, reduce);
+
+    // combine carries of threads which stopped inside the same row
+    IndexArray fixup_rows(exec, num_threads);
+    ValueArray fixup_values(exec, num_threads);
+
+    OffsetType num_fixups =
+        thrust::reduce_by_key(exec,
+                              carry_rows.begin(), carry_rows.end(),
+                              carry_values.begin(),
+                              fixup_rows.begin(),
+                              fixup_values.begin(),
+                              thrust::equal_to<OffsetType>(),
+                              reduce).first - fixup_rows.begin();
+
+    const size_t MAX_BLOCKS = cusp::system::cuda::detail::max_active_blocks(
+                                  spmv_csr_merge_fixup_kernel<OffsetType, IndexIterator, ValueIterator4, ValueIterator3, BinaryFunction2>,
+                                  THREADS_PER_BLOCK, (size_t) 0);
+    const size_t NUM_FIXUP_BLOCKS = std::min<size_t>(MAX_BLOCKS, DIVIDE_INTO(num_fixups, THREADS_PER_BLOCK));
+
+    spmv_csr_merge_fixup_kernel<OffsetType, IndexIterator, ValueIterator4, ValueIterator3, BinaryFunction2>
+        <<<NUM_FIXUP_BLOCKS, THREADS_PER_BLOCK, 0, s>>>
+        (num_fixups, OffsetType(A.num_rows), fixup_rows.begin(), fixup_values.begin(), y.begin(), reduce);
+}
+
+// Returns true when the row lengths of A are skewed enough that the
+// vector kernels would leave most warps idle while a few long rows are
+// processed.  The test requires a single pass over the row offsets.
+template <typename DerivedPolicy, typename MatrixType>
+bool __use_spmv_csr_merge(cuda::execution_policy<DerivedPolicy>& exec,
+                          const MatrixType& A)
+{
+    const size_t MIN_ENTRIES = 1 << 14;
+    const size_t SKEW_FACTOR = 16;
+
+    if(A.num_rows == 0 || A.num_entries < MIN_ENTRIES)
+        return false;
+
+    const size_t nnz_per_row = std::max<size_t>(1, A.num_entries / A.num_rows);
+    const size_t max_entries_per_row = cusp::compute_max_entries_per_row(exec, A.row_offsets);
+
+    return max_entries_per_row > std::max<size_t>(32, SKEW_FACTOR * nnz_per_row);
+}
+
+} // end namespace detail
+} // end namespace cuda
+} // end namespace system
+} // end namespace cusp
@@ -0,0 +1,431 @@
+/*
+ *  Copyright 2008-2014 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+
+#pragma once
+
+#include <cusp/system/cuda/arch.h>
+#include <cusp/system/cuda/utils.h>
+#include <cusp/system/detail/generic/multiply/generalized_spmv.h>
+
+#include <thrust/copy.h>
+#include <thrust/functional.h>
+#include <thrust/detail/type_traits.h>
+
+#include <cstring>
+#include <limits>
+
+namespace cusp
+{
+namespace system
+{
+namespace cuda
+{
+namespace detail
+{
+
+//////////////////////////////////////////////////////////////////////////////
+// CSR SpMV kernels specialized for semirings (one vector per row)
+//////////////////////////////////////////////////////////////////////////////
+//
+// spmv_csr_semiring_kernel
+//   Same decomposition as spmv_csr_vector_kernel, but the threads of a
+//   vector start from the identity of the reduction rather than from zero
+//   and combine their partial results with warp shuffles instead of a
+//   shared memory tree. Semirings are recognized by their reduction, so
+//   min-plus (SSSP), max-times and or-and (reachability) all use it. When
+//   the reduction has an annihilator, e.g. true for logical_or, a vector
+//   stops scanning its row as soon as one of its threads reaches it.
+//
+//  Note: THREADS_PER_VECTOR must be one of [2,4,8,16,32]
+
+// reductions without a specialized kernel
+template <typename BinaryFunction>
+struct semiring_reduce_traits
+{
+    typedef thrust::detail::false_type is_specialized;
+    typedef thrust::detail::false_type has_annihilator;
+};
+
+template <typename T>
+struct semiring_reduce_traits< thrust::minimum<T> >
+{
+    typedef thrust::detail::true_type  is_specialized;
+    typedef thrust::detail::false_type has_annihilator;
+
+    template <typename ValueType>
+    static ValueType identity(void)
+    {
+        return std::numeric_limits<ValueType>::has_infinity ?
+               std::numeric_limits<ValueType>::infinity() :
+               std::numeric_limits<ValueType>::max();
+    }
+};
+
+template <typename T>
+struct semiring_reduce_traits< thrust::maximum<T> >
+{
+    typedef thrust::detail::true_type  is_specialized;
+    typedef thrust::detail::false_type has_annihilator;
+
+    template <typename ValueType>
+    static ValueType identity(void)
+    {
+        return std::numeric_limits<ValueType>::has_infinity ?
+               -std::numeric_limits<ValueType>::infinity() :
+               (std::numeric_limits<ValueType>::is_integer ?
+                std::numeric_limits<ValueType>::min() :
+                -std::numeric_limits<ValueType>::max());
+    }
+};
+
+template <typename T>
+struct semiring_reduce_traits< thrust::logical_or<T> >
+{
+    typedef thrust::detail::true_type is_specialized;
+    typedef thrust::detail::true_type has_annihilator;
+
+    template <typename ValueType>
+    static ValueType identity(void)
+    {
+        return ValueType(0);
+    }
+
+    template <typename ValueType>
+    __device__
+    static bool annihilates(const ValueType& value)
+    {
+        return value != ValueType(0);
+    }
+};
+
+// shuffles a value of any type as a sequence of 32-bit words
+template <typename ValueType>
+__device__ __forceinline__
+ValueType semiring_shfl_down(const ValueType& value, const unsigned int delta,
+                             const unsigned int mask, const int width)
+{
+    const int WORDS = (sizeof(ValueType) + sizeof(int) - 1) / sizeof(int);
+
+    int input[WORDS];
+    int output[WORDS];
+
+    for(int w = 0; w < WORDS; w++)
+        input[w] = 0;
+
+    memcpy(input, &value, sizeof(ValueType));
+
+    for(int w = 0; w < WORDS; w++)
+    {
+#if CUDART_VERSION >= 9000
+        output[w] = __shfl_down_sync(mask, input[w], delta, width);
+#else
+        output[w] = __shfl_down(input[w], delta, width);
+#endif
+    }
+
+    ValueType result;
+    memcpy(&result, output, sizeof(ValueType));
+
+    return result;
+}
+
+__device__ __forceinline__
+bool semiring_any(const bool predicate, const unsigned int mask)
+{
+#if CUDART_VERSION >= 9000
+    return __any_sync(mask, predicate);
+#else
+    return __any(predicate);
+#endif
+}
+
+template <typename Traits, typename ValueType>
+__device__ __forceinline__
+bool semiring_annihilated(const ValueType& value, const unsigned int mask, thrust::detail::true_type)
+{
+    return semiring_any(Traits::annihilates(value), mask);
+}
+
+template <typename Traits, typename ValueType>
+__device__ __forceinline__
+bool semiring_annihilated(const ValueType&, const unsigned int, thrust::detail::false_type)
+{
+    return false;
+}
+
+template <typename RowIterator, typename ColumnIterator, typename ValueIterator1,
+         typename ValueIterator2, typename ValueIterator3,
+         typename UnaryFunction, typename BinaryFunction1, typename BinaryFunction2,
+         unsigned int VECTORS_PER_BLOCK, unsigned int THREADS_PER_VECTOR>
+__global__ void
+spmv_csr_semiring_kernel(const unsigned int num_rows,
+                         const RowIterator    Ap,
+                         const ColumnIterator Aj,
+                         const ValueIterator1 Ax,
+                         const ValueIterator2  x,
+                         ValueIterator3        y,
+                         const typename thrust::iterator_value<ValueIterator3>::type identity,
+                         UnaryFunction initialize,
+                         BinaryFunction1 combine,
+                         BinaryFunction2 reduce)
+{
+    typedef typename thrust::iterator_value<RowIterator>::type    IndexType;
+    typedef typename thrust::iterator_value<ValueIterator3>::type ValueType;
+
+    typedef semiring_reduce_traits<BinaryFunction2> Traits;
+    typedef typename Traits::has_annihilator        HasAnnihilator;
+
+    const IndexType THREADS_PER_BLOCK = VECTORS_PER_BLOCK * THREADS_PER_VECTOR;
+
+    const IndexType thread_id   = THREADS_PER_BLOCK * blockIdx.x + threadIdx.x;    // global thread index
+    const IndexType thread_lane = threadIdx.x & (THREADS_PER_VECTOR - 1);          // thread index within the vector
+    const IndexType vector_id   = thread_id   /  THREADS_PER_VECTOR;               // global vector index
+    const IndexType num_vectors = VECTORS_PER_BLOCK * gridDim.x;                   // total number of active vectors
+
+    // lanes of the warp holding the threads of this vector
+    const unsigned int warp_lane = threadIdx.x & 31;
+    const unsigned int mask = (THREADS_PER_VECTOR == 32) ? 0xffffffffu :
+                              (((1u << THREADS_PER_VECTOR) - 1) << (warp_lane & ~(THREADS_PER_VECTOR - 1)));
+
+    for(IndexType row = vector_id; row < num_rows; row += num_vectors)
+    {
+        const IndexType row_start = Ap[row];
+        const IndexType row_end   = Ap[row + 1];
+
+        // initialize local result
+        ValueType sum = (thread_lane == 0) ? reduce(identity, initialize(y[row])) : identity;
+
+        // every thread of the vector runs the same number of iterations so
+        // that the vote can exit early
+        for(IndexType base = row_start; base < row_end; base += THREADS_PER_VECTOR)
+        {
+            const IndexType jj = base + thread_lane;
+
+            if(jj < row_end)
+                sum = reduce(sum, combine(Ax[jj], x[Aj[jj]]));
+
+            if(semiring_annihilated<Traits>(sum, mask, HasAnnihilator()))
+                break;
+        }
+
+        // reduce local results to the row result
+        for(unsigned int offset = THREADS_PER_VECTOR / 2; offset > 0; offset /= 2)
+            sum = reduce(sum, semiring_shfl_down(sum, offset, mask, THREADS_PER_VECTOR));
+
+        // first thread writes the result
+        if (thread_lane == 0)
+            y[row] = sum;
+    }
+}
+
+template <unsigned int THREADS_PER_VECTOR,
+         unsigned int THREADS_PER_BLOCK,
+         typename DerivedPolicy,
+         typename MatrixType,
+         typename VectorType1,
+         typename VectorType2,
+         typename UnaryFunction,
+         typename BinaryFunction1,
+         typename BinaryFunction2>
+void __spmv_csr_semiring(cuda::execution_policy<DerivedPolicy>& exec,
+                         const MatrixType& A,
+                         const VectorType1& x,
+                         VectorType2& y,
+                         UnaryFunction   initialize,
+                         BinaryFunction1 combine,
+                         BinaryFunction2 reduce)
+{
+    typedef typename MatrixType::row_offsets_array_type::const_iterator     RowIterator;
+    typedef typename MatrixType::column_indices_array_type::const_iterator  ColumnIterator;
+    typedef typename MatrixType::values_array_type::const_iterator          ValueIterator1;
+
+    typedef typename VectorType1::const_iterator                            ValueIterator2;
+    typedef typename VectorType2::iterator                                  ValueIterator3;
+
+    typedef typename thrust::iterator_value<ValueIterator3>::type           ValueType;
+
+    const size_t VECTORS_PER_BLOCK  = THREADS_PER_BLOCK / THREADS_PER_VECTOR;
+
+    const ValueType identity = semiring_reduce_traits<BinaryFunction2>::template identity<ValueType>();
+
+    const size_t NUM_BLOCKS = cusp::system::cuda::detail::launch_blocks(
+                                  spmv_csr_semiring_kernel<RowIterator, ColumnIterator, ValueIterator1, ValueIterator2, ValueIterator3,
+                                  UnaryFunction, BinaryFunction1, BinaryFunction2,
+                                  VECTORS_PER_BLOCK, THREADS_PER_VECTOR>, THREADS_PER_BLOCK, (size_t) 0,
+                                  A.num_rows, VECTORS_PER_BLOCK);
+
+    cudaStream_t s = stream(thrust::detail::derived_cast(exec));
+
+    spmv_csr_semiring_kernel<RowIterator, ColumnIterator, ValueIterator1, ValueIterator2, ValueIterator3,
+                             UnaryFunction, BinaryFunction1, BinaryFunction2,
+                             VECTORS_PER_BLOCK, THREADS_PER_VECTOR> <<<NUM_BLOCKS, THREADS_PER_BLOCK, 0, s>>>
+                             (A.num_rows, A.row_offsets.begin(), A.column_indices.begin(), A.values.begin(), x.begin(), y.begin(),
+                              identity, initialize, combine, reduce);
+}
+
+template <typename DerivedPolicy,
+          typename MatrixType,
+          typename VectorType1,
+          typename VectorType2,
+          typename UnaryFunction,
+          typename BinaryFunction1,
+          typename BinaryFunction2>
+bool __spmv_csr_semiring(cuda::execution_policy<DerivedPolicy>& exec,
+                         const MatrixType& A,
+                         const VectorType1& x,
+                         VectorType2& y,
+                         UnaryFunction   initialize,
+                         BinaryFunction1 combine,
+                         BinaryFunction2 reduce,
+                         thrust::detail::true_type)
+{
+    typedef typename MatrixType::index_type IndexType;
+
+    const IndexType nnz_per_row = A.num_entries / A.num_rows;
+
+    if (nnz_per_row <=  2)
+        __spmv_csr_semiring<2,128>(exec, A, x, y, initialize, combine, reduce);
+    else if (nnz_per_row <=  4)
+        __spmv_csr_semiring<4,128>(exec, A, x, y, initialize, combine, reduce);
+    else if (nnz_per_row <=  8)
+        __spmv_csr_semiring<8,128>(exec, A, x, y, initialize, combine, reduce);
+    else if (nnz_per_row <= 16)
+        __spmv_csr_semiring<16,128>(exec, A, x, y, initialize, combine, reduce);
+    else
+        __spmv_csr_semiring<32,128>(exec, A, x, y, initialize, combine, reduce);
+
+    return true;
+}
+
+template <typename DerivedPolicy,
+          typename MatrixType,
+          typename VectorType1,
+          typename VectorType2,
+          typename UnaryFunction,
+          typename BinaryFunction1,
+          typename BinaryFunction2>
+bool __spmv_csr_semiring(cuda::execution_policy<DerivedPolicy>& exec,
+                         const MatrixType& A,
+                         const VectorType1& x,
+                         VectorType2& y,
+                         UnaryFunction   initialize,
+                         BinaryFunction1 combine,
+                         BinaryFunction2 reduce,
+                         thrust::detail::false_type)
+{
+    return false;
+}
+
+// runs the specialized kernel when the reduction is a known semiring
+// reduction, returns false otherwise
+template <typename DerivedPolicy,
+          typename MatrixType,
+          typename VectorType1,
+          typename VectorType2,
+          typename UnaryFunction,
+          typename BinaryFunction1,
+          typename BinaryFunction2>
+bool __try_spmv_csr_semiring(cuda::execution_policy<DerivedPolicy>& exec,
+                             const MatrixType& A,
+                             const VectorType1& x,
+                             VectorType2& y,
+                             UnaryFunction   initialize,
+                             BinaryFunction1 combine,
+                             BinaryFunction2 reduce)
+{
+    typedef typename semiring_reduce_traits<BinaryFunction2>::is_specialized IsSpecialized;
+
+    if (A.num_rows == 0)
+        return false;
+
+    return __spmv_csr_semiring(exec, A, x, y, initialize, combine, reduce, IsSpecialized());
+}
+
+template <typename DerivedPolicy,
+          typename MatrixType,
+          typename Vector1,
+          typename Vector2,
+          typename Vector3,
+          typename BinaryFunction1,
+          typename BinaryFunction2>
+void __generalized_spmv_csr(cuda::execution_policy<DerivedPolicy>& exec,
+                            const MatrixType& A,
+                            const Vector1& x,
+                            const Vector2& y,
+                            Vector3& z,
+                            BinaryFunction1 combine,
+                            BinaryFunction2 reduce,
+                            thrust::detail::true_type)
+{
+    typedef typename Vector3::value_type ValueType;
+
+    // z = reduce(y, A x) is a semiring SpMV accumulating into z
+    thrust::copy(exec, y.begin(), y.end(), z.begin());
+
+    if (A.num_rows > 0)
+        __spmv_csr_semiring(exec, A, x, z, thrust::identity<ValueType>(), combine, reduce, thrust::detail::true_type());
+}
+
+template <typename DerivedPolicy,
+          typename MatrixType,
+          typename Vector1,
+          typename Vector2,
+          typename Vector3,
+          typename BinaryFunction1,
+          typename BinaryFunction2>
+void __generalized_spmv_csr(cuda::execution_policy<DerivedPolicy>& exec,
+                            const MatrixType& A,
+                            const Vector1& x,
+                            const Vector2& y,
+                            Vector3& z,
+                            BinaryFunction1 combine,
+                            BinaryFunction2 reduce,
+                            thrust::detail::false_type)
+{
+    cusp::system::detail::generic::generalized_spmv(exec, A, x, y, z, combine, reduce,
+                                                    cusp::csr_format(), cusp::array1d_format(),
+                                                    cusp::array1d_format(), cusp::array1d_format());
+}
+
+template <typename DerivedPolicy,
+          typename MatrixType,
+          typename Vector1,
+          typename Vector2,
+          typename Vector3,
+          typename BinaryFunction1,
+          typename BinaryFunction2>
+void generalized_spmv(cuda::execution_policy<DerivedPolicy>& exec,
+                      const MatrixType& A,
+                      const Vector1& x,
+                      const Vector2& y,
+                      Vector3& z,
+                      BinaryFunction1 combine,
+                      BinaryFunction2 reduce,
+                      cusp::csr_format,
+                      cusp::array1d_format,
+                      cusp::array1d_format,
+                      cusp::array1d_format)
+{
+    typedef typename semiring_reduce_traits<BinaryFunction2>::is_specialized IsSpecialized;
+
+    __generalized_spmv_csr(exec, A, x, y, z, combine, reduce, IsSpecialized());
+}
+
+} // end namespace detail
+} // end namespace cuda
+} // end namespace system
+} // end namespace cusp
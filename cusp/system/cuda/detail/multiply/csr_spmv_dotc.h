@@ -0,0 +1,232 @@
+/*
+ *  Copyright 2008-2014 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#pragma once
+
+#include <cusp/complex.h>
+
+#include <cusp/detail/format.h>
+#include <cusp/detail/temporary_array.h>
+
+#include <cusp/system/cuda/arch.h>
+#include <cusp/system/cuda/utils.h>
+
+#include <thrust/device_ptr.h>
+#include <thrust/reduce.h>
+
+#include <algorithm>
+
+namespace cusp
+{
+namespace system
+{
+namespace cuda
+{
+namespace detail
+{
+
+//////////////////////////////////////////////////////////////////////////////
+// Fused CSR SpMV and dot product kernel
+//////////////////////////////////////////////////////////////////////////////
+//
+// spmv_csr_dotc_vector_kernel
+//   Identical to the CSR vector kernel, additionally the first thread of
+//   each vector accumulates conj(y[row]) * x[row] for the rows it writes.
+//   The partial sums are reduced per block and the block results are summed
+//   by a subsequent reduce, so x and y are not read again for the dot
+//   product.
+
+template <typename IndexType, typename ValueType1, typename ValueType2, typename ValueType3,
+          unsigned int VECTORS_PER_BLOCK, unsigned int THREADS_PER_VECTOR>
+__launch_bounds__(VECTORS_PER_BLOCK * THREADS_PER_VECTOR,1)
+__global__ void
+spmv_csr_dotc_vector_kernel(const IndexType num_rows,
+                            const IndexType * Ap,
+                            const IndexType * Aj,
+                            const ValueType1 * Ax,
+                            const ValueType2 * x,
+                            ValueType3 * y,
+                            ValueType3 * partials)
+{
+    typedef ValueType3 ValueType;
+
+    const unsigned int THREADS_PER_BLOCK = VECTORS_PER_BLOCK * THREADS_PER_VECTOR;
+
+    __shared__ volatile ValueType sdata[THREADS_PER_BLOCK + THREADS_PER_VECTOR / 2];  // padded to avoid reduction conditionals
+    __shared__ volatile IndexType ptrs[VECTORS_PER_BLOCK][2];
+
+    const IndexType thread_id   = THREADS_PER_BLOCK * blockIdx.x + threadIdx.x;    // global thread index
+    const IndexType thread_lane = threadIdx.x & (THREADS_PER_VECTOR - 1);          // thread index within the vector
+    const IndexType vector_id   = thread_id   /  THREADS_PER_VECTOR;               // global vector index
+    const IndexType vector_lane = threadIdx.x /  THREADS_PER_VECTOR;               // vector index within the block
+    const IndexType num_vectors = VECTORS_PER_BLOCK * gridDim.x;                   // total number of active vectors
+
+    ValueType dot = ValueType(0);
+
+    for(IndexType row = vector_id; row < num_rows; row += num_vectors)
+    {
+        // use two threads to fetch Ap[row] and Ap[row+1]
+        if(thread_lane < 2)
+            ptrs[vector_lane][thread_lane] = Ap[row + thread_lane];
+
+        const IndexType row_start = ptrs[vector_lane][0];                   //same as: row_start = Ap[row];
+        const IndexType row_end   = ptrs[vector_lane][1];                   //same as: row_end   = Ap[row+1];
+
+        // accumulate local sums
+        ValueType sum = ValueType(0);
+
+        for(IndexType jj = row_start + thread_lane; jj < row_end; jj += THREADS_PER_VECTOR)
+            sum += ValueType(Ax[jj]) * ValueType(x[Aj[jj]]);
+
+        // store local sum in shared memory
+        sdata[threadIdx.x] = sum;
+
+        ValueType temp;
+
+        // reduce local sums to row sum
+        if (THREADS_PER_VECTOR > 16) {
+            temp = sdata[threadIdx.x + 16];
+            sdata[threadIdx.x] = sum = sum + temp;
+        }
+        if (THREADS_PER_VECTOR >  8) {
+            temp = sdata[threadIdx.x +  8];
+            sdata[threadIdx.x] = sum = sum + temp;
+        }
+        if (THREADS_PER_VECTOR >  4) {
+            temp = sdata[threadIdx.x +  4];
+            sdata[threadIdx.x] = sum = sum + temp;
+        }
+        if (THREADS_PER_VECTOR >  2) {
+            temp = sdata[threadIdx.x +  2];
+            sdata[threadIdx.x] = sum = sum + temp;
+        }
+        if (THREADS_PER_VECTOR >  1) {
+            temp = sdata[threadIdx.x +  1];
+            sdata[threadIdx.x] = sum = sum + temp;
+        }
+
+        // first thread writes the result and accumulates the dot product
+        if (thread_lane == 0)
+        {
+            const ValueType yi = ValueType(sdata[threadIdx.x]);
+
+            y[row] = yi;
+            dot += cusp::conj(yi) * ValueType(x[row]);
+        }
+    }
+
+    // reduce the partial dot products of the block
+    __syncthreads();
+
+    sdata[threadIdx.x] = dot;
+
+    __syncthreads();
+
+    for(unsigned int offset = THREADS_PER_BLOCK / 2; offset > 0; offset /= 2)
+    {
+        if(threadIdx.x < offset)
+        {
+            ValueType temp = sdata[threadIdx.x + offset];
+            sdata[threadIdx.x] = dot = dot + temp;
+        }
+
+        __syncthreads();
+    }
+
+    if(threadIdx.x == 0)
+        partials[blockIdx.x] = dot;
+}
+
+template <unsigned int THREADS_PER_VECTOR,
+          typename DerivedPolicy,
+          typename MatrixType,
+          typename VectorType1,
+          typename VectorType2>
+typename VectorType2::value_type
+__spmv_csr_dotc_vector(cuda::execution_policy<DerivedPolicy>& exec,
+                       const MatrixType& A,
+                       const VectorType1& x,
+                       VectorType2& y)
+{
+    typedef typename MatrixType::index_type  IndexType;
+    typedef typename MatrixType::value_type  ValueType1;
+    typedef typename VectorType1::value_type ValueType2;
+    typedef typename VectorType2::value_type ValueType3;
+
+    const size_t THREADS_PER_BLOCK = 128;
+    const size_t VECTORS_PER_BLOCK = THREADS_PER_BLOCK / THREADS_PER_VECTOR;
+
+    const size_t NUM_BLOCKS = cusp::system::cuda::detail::launch_blocks(
+                                  spmv_csr_dotc_vector_kernel<IndexType, ValueType1, ValueType2, ValueType3,
+                                  VECTORS_PER_BLOCK, THREADS_PER_VECTOR>, THREADS_PER_BLOCK, (size_t) 0,
+                                  A.num_rows, VECTORS_PER_BLOCK);
+
+    cusp::detail::temporary_array<ValueType3, DerivedPolicy> partials(exec, NUM_BLOCKS);
+
+    const IndexType  * Ap = thrust::raw_pointer_cast(&A.row_offsets[0]);
+    const IndexType  * Aj = A.num_entries > 0 ? thrust::raw_pointer_cast(&A.column_indices[0]) : 0;
+    const ValueType1 * Ax = A.num_entries > 0 ? thrust::raw_pointer_cast(&A.values[0]) : 0;
+
+    const ValueType2 * x_ptr = thrust::raw_pointer_cast(&x[0]);
+    ValueType3 * y_ptr = thrust::raw_pointer_cast(&y[0]);
+    ValueType3 * p_ptr = thrust::raw_pointer_cast(&partials[0]);
+
+    cudaStream_t s = stream(thrust::detail::derived_cast(exec));
+
+    spmv_csr_dotc_vector_kernel<IndexType, ValueType1, ValueType2, ValueType3,
+                                VECTORS_PER_BLOCK, THREADS_PER_VECTOR> <<<NUM_BLOCKS, THREADS_PER_BLOCK, 0, s>>>
+                                (A.num_rows, Ap, Aj, Ax, x_ptr, y_ptr, p_ptr);
+
+    return thrust::reduce(exec, partials.begin(), partials.end(), ValueType3(0));
+}
+
+template <typename DerivedPolicy,
+          typename MatrixType,
+          typename VectorType1,
+          typename VectorType2>
+typename VectorType2::value_type
+multiply_dotc(cuda::execution_policy<DerivedPolicy>& exec,
+              const MatrixType& A,
+              const VectorType1& x,
+              VectorType2& y,
+              cusp::csr_format,
+              cusp::array1d_format,
+              cusp::array1d_format)
+{
+    typedef typename MatrixType::index_type  IndexType;
+    typedef typename VectorType2::value_type ValueType;
+
+    if (A.num_rows == 0)
+        return ValueType(0);
+
+    const IndexType nnz_per_row = A.num_entries / A.num_rows;
+
+    if (nnz_per_row <=  2)
+        return __spmv_csr_dotc_vector<2>(exec, A, x, y);
+    if (nnz_per_row <=  4)
+        return __spmv_csr_dotc_vector<4>(exec, A, x, y);
+    if (nnz_per_row <=  8)
+        return __spmv_csr_dotc_vector<8>(exec, A, x, y);
+    if (nnz_per_row <= 16)
+        return __spmv_csr_dotc_vector<16>(exec, A, x, y);
+
+    return __spmv_csr_dotc_vector<32>(exec, A, x, y);
+}
+
+} // end namespace detail
+} // end namespace cuda
+} // end namespace system
+} // end namespace cusp
@@ -19,6 +19,11 @@
 
 #include <cusp/system/cuda/arch.h>
 #include <cusp/system/cuda/utils.h>
+#include <cusp/system/cuda/detail/multiply/csr_adaptive_spmv.h>
+#include <cusp/system/cuda/detail/multiply/csr_complex_spmv.h>
+#include <cusp/system/cuda/detail/multiply/csr_merge_spmv.h>
+#include <cusp/system/cuda/detail/multiply/csr_semiring_spmv.h>
+#include <cusp/system/cuda/detail/multiply/spmv_tuner.h>
 
 #include <thrust/device_ptr.h>
 
@@ -72,7 +77,9 @@ spmv_csr_vector_kernel(const unsigned int num_rows,
                        BinaryFunction2 reduce)
 {
     typedef typename thrust::iterator_value<RowIterator>::type    IndexType;
-    typedef typename thrust::iterator_value<ValueIterator1>::type ValueType;
+    // products are accumulated in the value type of y, which may be wider
+    // than the type used to store the entries of A
+    typedef typename thrust::iterator_value<ValueIterator3>::type ValueType;
 
     __shared__ volatile ValueType sdata[VECTORS_PER_BLOCK * THREADS_PER_VECTOR + THREADS_PER_VECTOR / 2];  // padded to avoid reduction conditionals
     __shared__ volatile IndexType ptrs[VECTORS_PER_BLOCK][2];
@@ -154,6 +161,7 @@ spmv_csr_vector_kernel(const unsigned int num_rows,
 }
 
 template <unsigned int THREADS_PER_VECTOR,
+         unsigned int THREADS_PER_BLOCK,
          typename DerivedPolicy,
          typename MatrixType,
          typename VectorType1,
@@ -179,14 +187,17 @@ void __spmv_csr_vector(cuda::execution_policy<DerivedPolicy>& exec,
     typedef typename VectorType1::const_iterator                            ValueIterator2;
     typedef typename VectorType2::iterator                                  ValueIterator3;
 
-    const size_t THREADS_PER_BLOCK  = 128;
+    // complex values are loaded as float2 or double2 vectors
+    if (__try_spmv_csr_complex<THREADS_PER_VECTOR, THREADS_PER_BLOCK>(exec, A, x, y, initialize, combine, reduce))
+        return;
+
     const size_t VECTORS_PER_BLOCK  = THREADS_PER_BLOCK / THREADS_PER_VECTOR;
 
-    const size_t MAX_BLOCKS = cusp::system::cuda::detail::max_active_blocks(
+    const size_t NUM_BLOCKS = cusp::system::cuda::detail::launch_blocks(
                                   spmv_csr_vector_kernel<RowIterator, ColumnIterator, ValueIterator1, ValueIterator2, ValueIterator3,
                                   UnaryFunction, BinaryFunction1, BinaryFunction2,
-                                  VECTORS_PER_BLOCK, THREADS_PER_VECTOR>, THREADS_PER_BLOCK, (size_t) 0);
-    const size_t NUM_BLOCKS = std::min<size_t>(MAX_BLOCKS, DIVIDE_INTO(A.num_rows, VECTORS_PER_BLOCK));
+                                  VECTORS_PER_BLOCK, THREADS_PER_VECTOR>, THREADS_PER_BLOCK, (size_t) 0,
+                                  A.num_rows, VECTORS_PER_BLOCK);
 
     cudaStream_t s = stream(thrust::detail::derived_cast(exec));
 
@@ -197,6 +208,40 @@ void __spmv_csr_vector(cuda::execution_policy<DerivedPolicy>& exec,
                             initialize, combine, reduce);
 }
 
+// candidate configurations evaluated by the SpMV tuner
+template <typename DerivedPolicy,
+         typename MatrixType,
+         typename VectorType1,
+         typename VectorType2,
+         typename UnaryFunction,
+         typename BinaryFunction1,
+         typename BinaryFunction2>
+void __spmv_csr_candidate(const int candidate,
+                          cuda::execution_policy<DerivedPolicy>& exec,
+                          const MatrixType& A,
+                          const VectorType1& x,
+                          VectorType2& y,
+                          UnaryFunction   initialize,
+                          BinaryFunction1 combine,
+                          BinaryFunction2 reduce)
+{
+    switch(candidate)
+    {
+        case  0: __spmv_csr_vector< 2,128>(exec, A, x, y, initialize, combine, reduce); break;
+        case  1: __spmv_csr_vector< 4,128>(exec, A, x, y, initialize, combine, reduce); break;
+        case  2: __spmv_csr_vector< 8,128>(exec, A, x, y, initialize, combine, reduce); break;
+        case  3: __spmv_csr_vector<16,128>(exec, A, x, y, initialize, combine, reduce); break;
+        case  4: __spmv_csr_vector<32,128>(exec, A, x, y, initialize, combine, reduce); break;
+        case  5: __spmv_csr_vector< 2,256>(exec, A, x, y, initialize, combine, reduce); break;
+        case  6: __spmv_csr_vector< 4,256>(exec, A, x, y, initialize, combine, reduce); break;
+        case  7: __spmv_csr_vector< 8,256>(exec, A, x, y, initialize, combine, reduce); break;
+        case  8: __spmv_csr_vector<16,256>(exec, A, x, y, initialize, combine, reduce); break;
+        case  9: __spmv_csr_vector<32,256>(exec, A, x, y, initialize, combine, reduce); break;
+        case 10: __spmv_csr_merge(exec, A, x, y, initialize, combine, reduce); break;
+        default: __spmv_csr_adaptive(exec, A, x, y, initialize, combine, reduce); break;
+    }
+}
+
 template <typename DerivedPolicy,
           typename MatrixType,
           typename VectorType1,
@@ -217,26 +262,52 @@ void multiply(cuda::execution_policy<DerivedPolicy>& exec,
 {
     typedef typename MatrixType::index_type IndexType;
 
+    // semiring reductions such as min, max and logical_or use their own kernel
+    if (__try_spmv_csr_semiring(exec, A, x, y, initialize, combine, reduce))
+        return;
+
+    // time each candidate once, then reuse the fastest
+    if (spmv_tuning_enabled() && A.num_rows > 0) {
+        const int NUM_CANDIDATES = 12;
+
+        spmv_tuning_trial trial(make_spmv_tuning_key(spmv_tuning_csr, A, A.column_indices), NUM_CANDIDATES,
+                                stream(thrust::detail::derived_cast(exec)));
+        __spmv_csr_candidate(trial.candidate(), exec, A, x, y, initialize, combine, reduce);
+        trial.finish();
+        return;
+    }
+
+    if (get_csr_spmv_method() == csr_spmv_adaptive) {
+        __spmv_csr_adaptive(exec, A, x, y, initialize, combine, reduce);
+        return;
+    }
+
+    // skewed row lengths defeat the one-vector-per-row decomposition
+    if (get_csr_spmv_method() == csr_spmv_merge || __use_spmv_csr_merge(exec, A)) {
+        __spmv_csr_merge(exec, A, x, y, initialize, combine, reduce);
+        return;
+    }
+
     const IndexType nnz_per_row = A.num_entries / A.num_rows;
 
     if (nnz_per_row <=  2) {
-        __spmv_csr_vector<2>(exec, A, x, y, initialize, combine, reduce);
+        __spmv_csr_vector<2,128>(exec, A, x, y, initialize, combine, reduce);
         return;
     }
     if (nnz_per_row <=  4) {
-        __spmv_csr_vector<4>(exec, A, x, y, initialize, combine, reduce);
+        __spmv_csr_vector<4,128>(exec, A, x, y, initialize, combine, reduce);
         return;
     }
     if (nnz_per_row <=  8) {
-        __spmv_csr_vector<8>(exec, A, x, y, initialize, combine, reduce);
+        __spmv_csr_vector<8,128>(exec, A, x, y, initialize, combine, reduce);
         return;
     }
     if (nnz_per_row <= 16) {
-        __spmv_csr_vector<16>(exec, A, x, y, initialize, combine, reduce);
+        __spmv_csr_vector<16,128>(exec, A, x, y, initialize, combine, reduce);
         return;
     }
 
-    __spmv_csr_vector<32>(exec, A, x, y, initialize, combine, reduce);
+    __spmv_csr_vector<32,128>(exec, A, x, y, initialize, combine, reduce);
 }
 
 } // end namespace detail
@@ -0,0 +1,241 @@
+/*
+ *  Copyright 2008-2014 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#pragma once
+
+#include <cusp/dcsr_matrix.h>
+
+#include <cusp/system/cuda/arch.h>
+#include <cusp/system/cuda/utils.h>
+
+#include <thrust/device_ptr.h>
+
+#include <algorithm>
+
+namespace cusp
+{
+namespace system
+{
+namespace cuda
+{
+namespace detail
+{
+
+//////////////////////////////////////////////////////////////////////////////
+// DCSR SpMV kernel
+//////////////////////////////////////////////////////////////////////////////
+//
+// spmv_dcsr_vector_kernel
+//   Identical to the CSR vector kernel except for the column indices.  Each
+//   row is processed by a vector of THREADS_PER_VECTOR threads.  Rows of a
+//   block which fits into 16-bit deltas read column_deltas (2 bytes per
+//   entry), rows of the remaining blocks read column_indices.  Every vector
+//   fetches the three block descriptors of its row once, the descriptors of
+//   neighbouring rows coincide and are served from cache.
+
+template <typename IndexType, typename DeltaType, typename ValueType1, typename ValueType2, typename ValueType3,
+         typename UnaryFunction, typename BinaryFunction1, typename BinaryFunction2,
+         unsigned int ROWS_PER_BLOCK, unsigned int VECTORS_PER_BLOCK, unsigned int THREADS_PER_VECTOR>
+__launch_bounds__(VECTORS_PER_BLOCK * THREADS_PER_VECTOR,1)
+__global__ void
+spmv_dcsr_vector_kernel(const IndexType num_rows,
+                        const IndexType * Ap,
+                        const IndexType * Ab,
+                        const DeltaType * Ad,
+                        const IndexType * Aj,
+                        const ValueType1 * Ax,
+                        const ValueType2 * x,
+                        ValueType3 * y,
+                        UnaryFunction initialize,
+                        BinaryFunction1 combine,
+                        BinaryFunction2 reduce)
+{
+    // products are accumulated in the value type of y
+    typedef ValueType3 ValueType;
+
+    __shared__ volatile ValueType sdata[VECTORS_PER_BLOCK * THREADS_PER_VECTOR + THREADS_PER_VECTOR / 2];  // padded to avoid reduction conditionals
+    __shared__ volatile IndexType ptrs[VECTORS_PER_BLOCK][2];
+
+    const IndexType THREADS_PER_BLOCK = VECTORS_PER_BLOCK * THREADS_PER_VECTOR;
+
+    const IndexType thread_id   = THREADS_PER_BLOCK * blockIdx.x + threadIdx.x;    // global thread index
+    const IndexType thread_lane = threadIdx.x & (THREADS_PER_VECTOR - 1);          // thread index within the vector
+    const IndexType vector_id   = thread_id   /  THREADS_PER_VECTOR;               // global vector index
+    const IndexType vector_lane = threadIdx.x /  THREADS_PER_VECTOR;               // vector index within the block
+    const IndexType num_vectors = VECTORS_PER_BLOCK * gridDim.x;                   // total number of active vectors
+
+    for(IndexType row = vector_id; row < num_rows; row += num_vectors)
+    {
+        // use two threads to fetch Ap[row] and Ap[row+1]
+        if(thread_lane < 2)
+            ptrs[vector_lane][thread_lane] = Ap[row + thread_lane];
+
+        const IndexType row_start = ptrs[vector_lane][0];                   //same as: row_start = Ap[row];
+        const IndexType row_end   = ptrs[vector_lane][1];                   //same as: row_end   = Ap[row+1];
+
+        // locate the index representation of the row block
+        const IndexType block       = row / ROWS_PER_BLOCK;
+        const IndexType full_start  = Ab[block];
+        const bool      use_full    = Ab[block + 1] != full_start;
+
+        // initialize local sum
+        ValueType sum = (thread_lane == 0) ? initialize(y[row]) : ValueType(0);
+
+        if (use_full)
+        {
+            const IndexType full_offset = full_start - Ap[block * ROWS_PER_BLOCK];
+
+            for(IndexType jj = row_start + thread_lane; jj < row_end; jj += THREADS_PER_VECTOR)
+                sum = reduce(sum, combine(Ax[jj], x[Aj[full_offset + jj]]));
+        }
+        else
+        {
+            for(IndexType jj = row_start + thread_lane; jj < row_end; jj += THREADS_PER_VECTOR)
+                sum = reduce(sum, combine(Ax[jj], x[row + IndexType(Ad[jj])]));
+        }
+
+        // store local sum in shared memory
+        sdata[threadIdx.x] = sum;
+
+        ValueType temp;
+
+        // reduce local sums to row sum
+        if (THREADS_PER_VECTOR > 16) {
+            temp = sdata[threadIdx.x + 16];
+            sdata[threadIdx.x] = sum = reduce(sum, temp);
+        }
+        if (THREADS_PER_VECTOR >  8) {
+            temp = sdata[threadIdx.x +  8];
+            sdata[threadIdx.x] = sum = reduce(sum, temp);
+        }
+        if (THREADS_PER_VECTOR >  4) {
+            temp = sdata[threadIdx.x +  4];
+            sdata[threadIdx.x] = sum = reduce(sum, temp);
+        }
+        if (THREADS_PER_VECTOR >  2) {
+            temp = sdata[threadIdx.x +  2];
+            sdata[threadIdx.x] = sum = reduce(sum, temp);
+        }
+        if (THREADS_PER_VECTOR >  1) {
+            temp = sdata[threadIdx.x +  1];
+            sdata[threadIdx.x] = sum = reduce(sum, temp);
+        }
+
+        // first thread writes the result
+        if (thread_lane == 0)
+            y[row] = ValueType(sdata[threadIdx.x]);
+    }
+}
+
+template <unsigned int THREADS_PER_VECTOR,
+         typename DerivedPolicy,
+         typename MatrixType,
+         typename VectorType1,
+         typename VectorType2,
+         typename UnaryFunction,
+         typename BinaryFunction1,
+         typename BinaryFunction2>
+void __spmv_dcsr_vector(cuda::execution_policy<DerivedPolicy>& exec,
+                        const MatrixType& A,
+                        const VectorType1& x,
+                        VectorType2& y,
+                        UnaryFunction   initialize,
+                        BinaryFunction1 combine,
+                        BinaryFunction2 reduce)
+{
+    typedef typename MatrixType::index_type  IndexType;
+    typedef typename MatrixType::delta_type  DeltaType;
+    typedef typename MatrixType::value_type  ValueType1;
+    typedef typename VectorType1::value_type ValueType2;
+    typedef typename VectorType2::value_type ValueType3;
+
+    const size_t THREADS_PER_BLOCK = 128;
+    const size_t VECTORS_PER_BLOCK = THREADS_PER_BLOCK / THREADS_PER_VECTOR;
+    const unsigned int ROWS_PER_BLOCK = MatrixType::rows_per_block;
+
+    const size_t NUM_BLOCKS = cusp::system::cuda::detail::launch_blocks(
+                                  spmv_dcsr_vector_kernel<IndexType, DeltaType, ValueType1, ValueType2, ValueType3,
+                                  UnaryFunction, BinaryFunction1, BinaryFunction2,
+                                  ROWS_PER_BLOCK, VECTORS_PER_BLOCK, THREADS_PER_VECTOR>, THREADS_PER_BLOCK, (size_t) 0,
+                                  A.num_rows, VECTORS_PER_BLOCK);
+
+    const IndexType * Ap = thrust::raw_pointer_cast(&A.row_offsets[0]);
+    const IndexType * Ab = thrust::raw_pointer_cast(&A.block_offsets[0]);
+    const DeltaType * Ad = A.num_entries > 0 ? thrust::raw_pointer_cast(&A.column_deltas[0]) : 0;
+    const IndexType * Aj = A.column_indices.size() > 0 ? thrust::raw_pointer_cast(&A.column_indices[0]) : 0;
+    const ValueType1 * Ax = A.num_entries > 0 ? thrust::raw_pointer_cast(&A.values[0]) : 0;
+
+    const ValueType2 * x_ptr = thrust::raw_pointer_cast(&x[0]);
+    ValueType3 * y_ptr = thrust::raw_pointer_cast(&y[0]);
+
+    cudaStream_t s = stream(thrust::detail::derived_cast(exec));
+
+    spmv_dcsr_vector_kernel<IndexType, DeltaType, ValueType1, ValueType2, ValueType3,
+                            UnaryFunction, BinaryFunction1, BinaryFunction2,
+                            ROWS_PER_BLOCK, VECTORS_PER_BLOCK, THREADS_PER_VECTOR> <<<NUM_BLOCKS, THREADS_PER_BLOCK, 0, s>>>
+                            (A.num_rows, Ap, Ab, Ad, Aj, Ax, x_ptr, y_ptr,
+                             initialize, combine, reduce);
+}
+
+template <typename DerivedPolicy,
+          typename MatrixType,
+          typename VectorType1,
+          typename VectorType2,
+          typename UnaryFunction,
+          typename BinaryFunction1,
+          typename BinaryFunction2>
+void multiply(cuda::execution_policy<DerivedPolicy>& exec,
+              const MatrixType& A,
+              const VectorType1& x,
+              VectorType2& y,
+              UnaryFunction   initialize,
+              BinaryFunction1 combine,
+              BinaryFunction2 reduce,
+              cusp::dcsr_format,
+              cusp::array1d_format,
+              cusp::array1d_format)
+{
+    typedef typename MatrixType::index_type IndexType;
+
+    if (A.num_rows == 0)
+        return;
+
+    const IndexType nnz_per_row = A.num_entries / A.num_rows;
+
+    if (nnz_per_row <=  2) {
+        __spmv_dcsr_vector<2>(exec, A, x, y, initialize, combine, reduce);
+        return;
+    }
+    if (nnz_per_row <=  4) {
+        __spmv_dcsr_vector<4>(exec, A, x, y, initialize, combine, reduce);
+        return;
+    }
+    if (nnz_per_row <=  8) {
+        __spmv_dcsr_vector<8>(exec, A, x, y, initialize, combine, reduce);
+        return;
+    }
+    if (nnz_per_row <= 16) {
+        __spmv_dcsr_vector<16>(exec, A, x, y, initialize, combine, reduce);
+        return;
+    }
+
+    __spmv_dcsr_vector<32>(exec, A, x, y, initialize, combine, reduce);
+}
+
+} // end namespace detail
+} // end namespace cuda
+} // end namespace system
+} // end namespace cusp
@@ -22,6 +22,14 @@
 
 #include <cusp/detail/execution_policy.h>
 
+#if CUSP_DEVICE_BLAS_SYSTEM == CUSP_DEVICE_BLAS_CUBLAS
+#include <cusp/functional.h>
+#include <cusp/system/cuda/detail/cublas/blas.h>
+
+#include <thrust/fill.h>
+#include <thrust/functional.h>
+#endif
+
 namespace cusp
 {
 namespace system
@@ -31,6 +39,121 @@ namespace cuda
 namespace detail
 {
 
+#if CUSP_DEVICE_BLAS_SYSTEM == CUSP_DEVICE_BLAS_CUBLAS
+
+// Dense products over the standard (+, *) semiring of device arrays which
+// cuBLAS accepts run gemv and gemm on the pooled handle of the policy's
+// stream. Other semirings and operands are computed on the host.
+
+template <typename UnaryFunction, typename BinaryFunction1, typename BinaryFunction2, typename ValueType>
+struct is_blas_semiring : thrust::detail::false_type {};
+
+template <typename ValueType>
+struct is_blas_semiring<cusp::constant_functor<ValueType>, thrust::multiplies<ValueType>, thrust::plus<ValueType>, ValueType>
+  : thrust::detail::true_type {};
+
+template <typename ValueType>
+struct is_blas_semiring<thrust::identity<ValueType>, thrust::multiplies<ValueType>, thrust::plus<ValueType>, ValueType>
+  : thrust::detail::true_type {};
+
+// beta of y = A * x + beta * y which gives initialize(y) + A * x
+template <typename DerivedPolicy, typename ArrayType, typename ValueType>
+ValueType dense_beta(cuda::execution_policy<DerivedPolicy>& exec, ArrayType& y,
+                     cusp::constant_functor<ValueType> initialize)
+{
+    const ValueType value = initialize(ValueType(0));
+
+    if (value == ValueType(0))
+        return ValueType(0);
+
+    thrust::fill(exec, y.begin(), y.end(), value);
+
+    return ValueType(1);
+}
+
+template <typename DerivedPolicy, typename ArrayType, typename ValueType>
+ValueType dense_beta(cuda::execution_policy<DerivedPolicy>& exec, ArrayType& y,
+                     thrust::identity<ValueType> initialize)
+{
+    return ValueType(1);
+}
+
+template <typename DerivedPolicy,
+          typename MatrixType,
+          typename ArrayType1,
+          typename ArrayType2,
+          typename UnaryFunction>
+bool __dense_gemv(cuda::execution_policy<DerivedPolicy>& exec,
+                  MatrixType& A, ArrayType1& x, ArrayType2& y,
+                  UnaryFunction initialize,
+                  thrust::detail::false_type)
+{
+    return false;
+}
+
+template <typename DerivedPolicy,
+          typename MatrixType,
+          typename ArrayType1,
+          typename ArrayType2,
+          typename UnaryFunction>
+bool __dense_gemv(cuda::execution_policy<DerivedPolicy>& exec,
+                  MatrixType& A, ArrayType1& x, ArrayType2& y,
+                  UnaryFunction initialize,
+                  thrust::detail::true_type)
+{
+    typedef typename ArrayType2::value_type ValueType;
+
+    if (A.num_rows == 0 || A.num_cols == 0 ||
+        A.num_cols != x.size() || A.num_rows != y.size())
+        return false;
+
+    const ValueType beta = dense_beta(exec, y, initialize);
+
+    cusp::system::cuda::detail::gemv(exec, A, x, y, ValueType(1), beta);
+
+    return true;
+}
+
+template <typename DerivedPolicy,
+          typename MatrixType1,
+          typename MatrixType2,
+          typename MatrixType3,
+          typename UnaryFunction>
+bool __dense_gemm(cuda::execution_policy<DerivedPolicy>& exec,
+                  MatrixType1& A, MatrixType2& B, MatrixType3& C,
+                  UnaryFunction initialize,
+                  thrust::detail::false_type)
+{
+    return false;
+}
+
+template <typename DerivedPolicy,
+          typename MatrixType1,
+          typename MatrixType2,
+          typename MatrixType3,
+          typename UnaryFunction>
+bool __dense_gemm(cuda::execution_policy<DerivedPolicy>& exec,
+                  MatrixType1& A, MatrixType2& B, MatrixType3& C,
+                  UnaryFunction initialize,
+                  thrust::detail::true_type)
+{
+    typedef typename MatrixType3::value_type ValueType;
+
+    // C is produced with its current shape, views are not resized
+    if (A.num_rows == 0 || A.num_cols == 0 || B.num_cols == 0 ||
+        A.num_cols != B.num_rows ||
+        C.num_rows != A.num_rows || C.num_cols != B.num_cols)
+        return false;
+
+    const ValueType beta = dense_beta(exec, C.values, initialize);
+
+    cusp::system::cuda::detail::gemm(exec, A, B, C, ValueType(1), beta);
+
+    return true;
+}
+
+#endif
+
 template <typename DerivedPolicy,
           typename MatrixType,
           typename ArrayType1,
@@ -53,13 +176,21 @@ void multiply(cuda::execution_policy<DerivedPolicy>& exec,
     typedef typename ArrayType1::value_type ValueType1;
     typedef typename ArrayType2::value_type ValueType2;
 
+#if CUSP_DEVICE_BLAS_SYSTEM == CUSP_DEVICE_BLAS_CUBLAS
+    typedef typename thrust::detail::integral_constant<bool,
+        is_blas_semiring<UnaryFunction,BinaryFunction1,BinaryFunction2,ValueType2>::value &&
+        is_cublas_level2<MatrixType,ArrayType1,ArrayType2,ValueType2>::value>::type UseBlas;
+
+    if (__dense_gemv(exec, A, x, y, initialize, UseBlas()))
+        return;
+#endif
+
     Array2d A_(A);
     cusp::array1d<ValueType1,cusp::host_memory> x_(x);
     cusp::array1d<ValueType2,cusp::host_memory> y_(y.size());
 
     cusp::multiply(A_, x_, y_, initialize, combine, reduce);
 
-    std::cout << "copying to output" << std::endl;
     cusp::copy(y_, y);
 }
 
@@ -85,6 +216,16 @@ void multiply(cuda::execution_policy<DerivedPolicy>& exec,
     typedef typename cusp::detail::as_array2d_type<MatrixType2,cusp::host_memory>::type Array2dMatrix2;
     typedef typename cusp::detail::as_array2d_type<MatrixType3,cusp::host_memory>::type Array2dMatrix3;
 
+#if CUSP_DEVICE_BLAS_SYSTEM == CUSP_DEVICE_BLAS_CUBLAS
+    typedef typename MatrixType3::value_type ValueType;
+    typedef typename thrust::detail::integral_constant<bool,
+        is_blas_semiring<UnaryFunction,BinaryFunction1,BinaryFunction2,ValueType>::value &&
+        is_cublas_level3<MatrixType1,MatrixType2,MatrixType3,ValueType>::value>::type UseBlas;
+
+    if (__dense_gemm(exec, A, B, C, initialize, UseBlas()))
+        return;
+#endif
+
     Array2dMatrix1 A_(A);
     Array2dMatrix2 B_(B);
     Array2dMatrix3 C_(A.num_rows, B.num_cols);
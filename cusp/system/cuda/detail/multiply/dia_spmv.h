@@ -21,6 +21,7 @@
 
 #include <cusp/system/cuda/arch.h>
 #include <cusp/system/cuda/utils.h>
+#include <cusp/system/cuda/detail/multiply/spmv_tuner.h>
 
 #include <thrust/device_ptr.h>
 
@@ -54,6 +55,13 @@ namespace detail
 // spmv_dia_tex
 //   Same as spmv_dia, except x is accessed via texture cache.
 //
+// spmv_dia_tiled
+//   Same as spmv_dia, except each block stages the window of x read by a
+//   group of nearby diagonals in shared memory.  Stencil matrices have
+//   their diagonals clustered around a few offsets, e.g. the 27-point
+//   stencil has 9 groups of 3, so x is read from global memory once per
+//   group instead of once per diagonal.
+//
 
 
 template <typename OffsetsIterator, typename ValueIterator1, typename ValueIterator2, typename ValueIterator3, typename UnaryFunction, typename BinaryFunction1, typename BinaryFunction2, unsigned int BLOCK_SIZE>
@@ -119,23 +127,119 @@ spmv_dia_kernel(const int num_rows,
 }
 
 
-template <typename DerivedPolicy,
+template <typename OffsetsIterator, typename ValueIterator1, typename ValueIterator2, typename ValueIterator3, typename UnaryFunction, typename BinaryFunction1, typename BinaryFunction2, unsigned int BLOCK_SIZE>
+__launch_bounds__(BLOCK_SIZE,1)
+__global__ void
+spmv_dia_tiled_kernel(const int num_rows,
+                      const int num_cols,
+                      const int num_diagonals,
+                      const int pitch,
+                      const OffsetsIterator diagonal_offsets,
+                      const ValueIterator1 values,
+                      const ValueIterator2 x,
+                      ValueIterator3 y,
+                      UnaryFunction initialize,
+                      BinaryFunction1 combine,
+                      BinaryFunction2 reduce)
+{
+    typedef typename thrust::iterator_value<OffsetsIterator>::type IndexType;
+    typedef typename thrust::iterator_value<ValueIterator1>::type  ValueType;
+    typedef typename thrust::iterator_value<ValueIterator2>::type  XType;
+
+    // requires num_diagonals <= BLOCK_SIZE
+    __shared__ IndexType offsets[BLOCK_SIZE];
+    __shared__ XType     window[2 * BLOCK_SIZE];
+
+    if(threadIdx.x < num_diagonals)
+        offsets[threadIdx.x] = diagonal_offsets[threadIdx.x];
+
+    __syncthreads();
+
+    for(IndexType base = BLOCK_SIZE * blockIdx.x; base < num_rows; base += BLOCK_SIZE * gridDim.x)
+    {
+        const IndexType row = base + threadIdx.x;
+
+        ValueType sum = (row < num_rows) ? initialize(y[row]) : ValueType(0);
+
+        for(IndexType first = 0; first < num_diagonals;)
+        {
+            // extend the group while the offsets span at most BLOCK_SIZE
+            IndexType min_offset = offsets[first];
+            IndexType max_offset = offsets[first];
+            IndexType last       = first + 1;
+
+            for(; last < num_diagonals; last++)
+            {
+                const IndexType lo = thrust::min(min_offset, offsets[last]);
+                const IndexType hi = thrust::max(max_offset, offsets[last]);
+
+                if(hi - lo > IndexType(BLOCK_SIZE))
+                    break;
+
+                min_offset = lo;
+                max_offset = hi;
+            }
+
+            // stage the columns read by the rows of this block
+            const IndexType window_start = base + min_offset;
+            const IndexType window_size  = BLOCK_SIZE + max_offset - min_offset;
+
+            for(IndexType i = threadIdx.x; i < window_size; i += BLOCK_SIZE)
+            {
+                const IndexType col = window_start + i;
+
+                if(col >= 0 && col < num_cols)
+                    window[i] = x[col];
+            }
+
+            __syncthreads();
+
+            if(row < num_rows)
+            {
+                // index into values array
+                IndexType idx = row + pitch * first;
+
+                for(IndexType n = first; n < last; n++)
+                {
+                    const IndexType col = row + offsets[n];
+
+                    if(col >= 0 && col < num_cols)
+                    {
+                        const ValueType A_ij = values[idx];
+                        sum = reduce(sum, combine(A_ij, window[col - window_start]));
+                    }
+
+                    idx += pitch;
+                }
+            }
+
+            // wait until all threads are done reading the window
+            __syncthreads();
+
+            first = last;
+        }
+
+        if(row < num_rows)
+            y[row] = sum;
+    }
+}
+
+
+template <unsigned int BLOCK_SIZE,
+          typename DerivedPolicy,
           typename MatrixType,
           typename VectorType1,
           typename VectorType2,
           typename UnaryFunction,
           typename BinaryFunction1,
           typename BinaryFunction2>
-void multiply(cuda::execution_policy<DerivedPolicy>& exec,
-              MatrixType& A,
-              VectorType1& x,
-              VectorType2& y,
-              UnaryFunction   initialize,
-              BinaryFunction1 combine,
-              BinaryFunction2 reduce,
-              cusp::dia_format,
-              cusp::array1d_format,
-              cusp::array1d_format)
+void __spmv_dia(cuda::execution_policy<DerivedPolicy>& exec,
+                MatrixType& A,
+                VectorType1& x,
+                VectorType2& y,
+                UnaryFunction   initialize,
+                BinaryFunction1 combine,
+                BinaryFunction2 reduce)
 {
     typedef typename MatrixType::index_type IndexType;
     typedef typename MatrixType::value_type ValueType;
@@ -146,27 +250,117 @@ void multiply(cuda::execution_policy<DerivedPolicy>& exec,
     typedef typename VectorType1::const_iterator                                      ValueIterator2;
     typedef typename VectorType2::iterator                                            ValueIterator3;
 
-    const size_t BLOCK_SIZE = 256;
-    const size_t MAX_BLOCKS = cusp::system::cuda::detail::max_active_blocks(
+    const size_t NUM_BLOCKS = cusp::system::cuda::detail::launch_blocks(
                                spmv_dia_kernel<OffsetsIterator, ValueIterator1, ValueIterator2, ValueIterator3, UnaryFunction, BinaryFunction1, BinaryFunction2, BLOCK_SIZE>,
-                               BLOCK_SIZE, (size_t) sizeof(IndexType) * BLOCK_SIZE);
-    const size_t NUM_BLOCKS = std::min<size_t>(MAX_BLOCKS, DIVIDE_INTO(A.num_rows, BLOCK_SIZE));
+                               BLOCK_SIZE, (size_t) sizeof(IndexType) * BLOCK_SIZE,
+                               A.num_rows, BLOCK_SIZE);
 
     const IndexType num_diagonals = A.values.num_cols;
     const IndexType pitch         = A.values.pitch;
 
+    cudaStream_t s = stream(thrust::detail::derived_cast(exec));
+
+    spmv_dia_kernel<OffsetsIterator, ValueIterator1, ValueIterator2, ValueIterator3, UnaryFunction, BinaryFunction1, BinaryFunction2, BLOCK_SIZE> <<<NUM_BLOCKS, BLOCK_SIZE, 0, s>>>
+    (A.num_rows, A.num_cols, num_diagonals, pitch, A.diagonal_offsets.begin(), A.values.values.begin(), x.begin(), y.begin(), initialize, combine, reduce);
+}
+
+template <unsigned int BLOCK_SIZE,
+          typename DerivedPolicy,
+          typename MatrixType,
+          typename VectorType1,
+          typename VectorType2,
+          typename UnaryFunction,
+          typename BinaryFunction1,
+          typename BinaryFunction2>
+void __spmv_dia_tiled(cuda::execution_policy<DerivedPolicy>& exec,
+                      MatrixType& A,
+                      VectorType1& x,
+                      VectorType2& y,
+                      UnaryFunction   initialize,
+                      BinaryFunction1 combine,
+                      BinaryFunction2 reduce)
+{
+    typedef typename MatrixType::index_type IndexType;
+    typedef typename MatrixType::value_type ValueType;
+
+    typedef typename MatrixType::diagonal_offsets_array_type::const_iterator          OffsetsIterator;
+    typedef typename MatrixType::values_array_type::values_array_type::const_iterator ValueIterator1;
+
+    typedef typename VectorType1::const_iterator                                      ValueIterator2;
+    typedef typename VectorType2::iterator                                            ValueIterator3;
+
+    typedef typename thrust::iterator_value<ValueIterator2>::type                     XType;
+
+    const IndexType num_diagonals = A.values.num_cols;
+    const IndexType pitch         = A.values.pitch;
+
+    // the offsets must fit in shared memory at once
+    if(num_diagonals > IndexType(BLOCK_SIZE))
+    {
+        __spmv_dia<BLOCK_SIZE>(exec, A, x, y, initialize, combine, reduce);
+        return;
+    }
+
+    const size_t NUM_BLOCKS = cusp::system::cuda::detail::launch_blocks(
+                               spmv_dia_tiled_kernel<OffsetsIterator, ValueIterator1, ValueIterator2, ValueIterator3, UnaryFunction, BinaryFunction1, BinaryFunction2, BLOCK_SIZE>,
+                               BLOCK_SIZE, (size_t) (sizeof(IndexType) + 2 * sizeof(XType)) * BLOCK_SIZE,
+                               A.num_rows, BLOCK_SIZE);
+
+    cudaStream_t s = stream(thrust::detail::derived_cast(exec));
+
+    spmv_dia_tiled_kernel<OffsetsIterator, ValueIterator1, ValueIterator2, ValueIterator3, UnaryFunction, BinaryFunction1, BinaryFunction2, BLOCK_SIZE> <<<NUM_BLOCKS, BLOCK_SIZE, 0, s>>>
+    (A.num_rows, A.num_cols, num_diagonals, pitch, A.diagonal_offsets.begin(), A.values.values.begin(), x.begin(), y.begin(), initialize, combine, reduce);
+}
+
+template <typename DerivedPolicy,
+          typename MatrixType,
+          typename VectorType1,
+          typename VectorType2,
+          typename UnaryFunction,
+          typename BinaryFunction1,
+          typename BinaryFunction2>
+void multiply(cuda::execution_policy<DerivedPolicy>& exec,
+              MatrixType& A,
+              VectorType1& x,
+              VectorType2& y,
+              UnaryFunction   initialize,
+              BinaryFunction1 combine,
+              BinaryFunction2 reduce,
+              cusp::dia_format,
+              cusp::array1d_format,
+              cusp::array1d_format)
+{
     // TODO can this be removed?
-    if (num_diagonals == 0)
+    if (A.values.num_cols == 0)
     {
         // empty matrix
         thrust::transform(exec, y.begin(), y.begin() + A.num_rows, y.begin(), initialize);
         return;
     }
 
-    cudaStream_t s = stream(thrust::detail::derived_cast(exec));
+    // time each block size once, then reuse the fastest
+    if (spmv_tuning_enabled())
+    {
+        const int NUM_CANDIDATES = 6;
 
-    spmv_dia_kernel<OffsetsIterator, ValueIterator1, ValueIterator2, ValueIterator3, UnaryFunction, BinaryFunction1, BinaryFunction2, BLOCK_SIZE> <<<NUM_BLOCKS, BLOCK_SIZE, 0, s>>>
-    (A.num_rows, A.num_cols, num_diagonals, pitch, A.diagonal_offsets.begin(), A.values.values.begin(), x.begin(), y.begin(), initialize, combine, reduce);
+        spmv_tuning_trial trial(make_spmv_tuning_key(spmv_tuning_dia, A, A.diagonal_offsets), NUM_CANDIDATES,
+                                stream(thrust::detail::derived_cast(exec)));
+
+        switch(trial.candidate())
+        {
+            case  0: __spmv_dia<128>(exec, A, x, y, initialize, combine, reduce); break;
+            case  1: __spmv_dia<256>(exec, A, x, y, initialize, combine, reduce); break;
+            case  2: __spmv_dia<512>(exec, A, x, y, initialize, combine, reduce); break;
+            case  3: __spmv_dia_tiled<128>(exec, A, x, y, initialize, combine, reduce); break;
+            case  4: __spmv_dia_tiled<256>(exec, A, x, y, initialize, combine, reduce); break;
+            default: __spmv_dia_tiled<512>(exec, A, x, y, initialize, combine, reduce); break;
+        }
+
+        trial.finish();
+        return;
+    }
+
+    __spmv_dia_tiled<256>(exec, A, x, y, initialize, combine, reduce);
 }
 
 } // end namespace detail
@@ -22,6 +22,7 @@
 #include <cusp/ell_matrix.h>
 #include <cusp/system/cuda/arch.h>
 #include <cusp/system/cuda/utils.h>
+#include <cusp/system/cuda/detail/multiply/spmv_tuner.h>
 
 #include <thrust/device_ptr.h>
 
@@ -38,7 +39,9 @@ namespace detail
 {
 
 template <typename IndexType,
-          typename ValueType,
+          typename ValueType1,
+          typename ValueType2,
+          typename ValueType3,
           typename UnaryFunction,
           typename BinaryFunction1,
           typename BinaryFunction2,
@@ -50,14 +53,18 @@ spmv_ell_kernel(const IndexType num_rows,
                 const IndexType num_cols_per_row,
                 const IndexType pitch,
                 const IndexType * Aj,
-                const ValueType * Ax,
-                const ValueType * x,
-                ValueType * y,
+                const ValueType1 * Ax,
+                const ValueType2 * x,
+                ValueType3 * y,
                 UnaryFunction initialize,
                 BinaryFunction1 combine,
                 BinaryFunction2 reduce)
 {
-    const IndexType invalid_index = cusp::ell_matrix<IndexType, ValueType, cusp::device_memory>::invalid_index;
+    // entries of A may be stored in a narrower type than x and y, the
+    // products are always accumulated in the value type of y
+    typedef ValueType3 ValueType;
+
+    const IndexType invalid_index = cusp::ell_matrix<IndexType, ValueType1, cusp::device_memory>::invalid_index;
 
     const IndexType thread_id = blockDim.x * blockIdx.x + threadIdx.x;
     const IndexType grid_size = gridDim.x * blockDim.x;
@@ -74,7 +81,7 @@ spmv_ell_kernel(const IndexType num_rows,
 
             if (col != invalid_index)
             {
-                const ValueType A_ij = Ax[offset];
+                const ValueType1 A_ij = Ax[offset];
                 sum = reduce(sum, combine(A_ij, x[col]));
             }
 
@@ -86,6 +93,49 @@ spmv_ell_kernel(const IndexType num_rows,
 }
 
 
+template <size_t BLOCK_SIZE,
+          typename DerivedPolicy,
+          typename MatrixType,
+          typename VectorType1,
+          typename VectorType2,
+          typename UnaryFunction,
+          typename BinaryFunction1,
+          typename BinaryFunction2>
+void __spmv_ell(cuda::execution_policy<DerivedPolicy>& exec,
+                MatrixType& A,
+                VectorType1& x,
+                VectorType2& y,
+                UnaryFunction   initialize,
+                BinaryFunction1 combine,
+                BinaryFunction2 reduce)
+{
+    typedef typename MatrixType::index_type  IndexType;
+    typedef typename MatrixType::value_type  ValueType1;
+    typedef typename VectorType1::value_type ValueType2;
+    typedef typename VectorType2::value_type ValueType3;
+
+    const size_t NUM_BLOCKS = cusp::system::cuda::detail::launch_blocks(
+                                  spmv_ell_kernel<IndexType,ValueType1,ValueType2,ValueType3,UnaryFunction,BinaryFunction1,BinaryFunction2,BLOCK_SIZE>, BLOCK_SIZE, (size_t) 0,
+                                  A.num_rows, BLOCK_SIZE);
+
+    const IndexType pitch               = A.column_indices.pitch;
+    const IndexType num_entries_per_row = A.column_indices.num_cols;
+
+    const IndexType * J = thrust::raw_pointer_cast(&A.column_indices(0,0));
+    const ValueType1 * V = thrust::raw_pointer_cast(&A.values(0,0));
+
+    const ValueType2 * x_ptr = thrust::raw_pointer_cast(&x[0]);
+    ValueType3 * y_ptr = thrust::raw_pointer_cast(&y[0]);
+
+    // TODO generalize this
+    assert(A.column_indices.pitch == A.values.pitch);
+
+    cudaStream_t s = stream(thrust::detail::derived_cast(exec));
+
+    spmv_ell_kernel<IndexType,ValueType1,ValueType2,ValueType3,UnaryFunction,BinaryFunction1,BinaryFunction2,BLOCK_SIZE> <<<NUM_BLOCKS, BLOCK_SIZE, 0, s>>>
+    (A.num_rows, A.num_cols, num_entries_per_row, pitch, J, V, x_ptr, y_ptr, initialize, combine, reduce);
+}
+
 template <typename DerivedPolicy,
           typename MatrixType,
           typename VectorType1,
@@ -104,36 +154,32 @@ void multiply(cuda::execution_policy<DerivedPolicy>& exec,
               cusp::array1d_format,
               cusp::array1d_format)
 {
-    typedef typename MatrixType::index_type IndexType;
-    typedef typename MatrixType::value_type ValueType;
-
     if(A.num_entries == 0)
     {
-        thrust::transform(y.begin(), y.end(), y.begin(), initialize);
+        thrust::transform(exec, y.begin(), y.end(), y.begin(), initialize);
         return;
     }
 
-    const size_t BLOCK_SIZE = 256;
-    const size_t MAX_BLOCKS = cusp::system::cuda::detail::max_active_blocks(
-                                  spmv_ell_kernel<IndexType,ValueType,UnaryFunction,BinaryFunction1,BinaryFunction2,BLOCK_SIZE>, BLOCK_SIZE, (size_t) 0);
-    const size_t NUM_BLOCKS = std::min<size_t>(MAX_BLOCKS, DIVIDE_INTO(A.num_rows, BLOCK_SIZE));
-
-    const IndexType pitch               = A.column_indices.pitch;
-    const IndexType num_entries_per_row = A.column_indices.num_cols;
-
-    const IndexType * J = thrust::raw_pointer_cast(&A.column_indices(0,0));
-    const ValueType * V = thrust::raw_pointer_cast(&A.values(0,0));
+    // time each block size once, then reuse the fastest
+    if(spmv_tuning_enabled())
+    {
+        const int NUM_CANDIDATES = 3;
 
-    const ValueType * x_ptr = thrust::raw_pointer_cast(&x[0]);
-    ValueType * y_ptr = thrust::raw_pointer_cast(&y[0]);
+        spmv_tuning_trial trial(make_spmv_tuning_key(spmv_tuning_ell, A, A.column_indices.values), NUM_CANDIDATES,
+                                stream(thrust::detail::derived_cast(exec)));
 
-    // TODO generalize this
-    assert(A.column_indices.pitch == A.values.pitch);
+        switch(trial.candidate())
+        {
+            case  0: __spmv_ell<128>(exec, A, x, y, initialize, combine, reduce); break;
+            case  1: __spmv_ell<256>(exec, A, x, y, initialize, combine, reduce); break;
+            default: __spmv_ell<512>(exec, A, x, y, initialize, combine, reduce); break;
+        }
 
-    cudaStream_t s = stream(thrust::detail::derived_cast(exec));
+        trial.finish();
+        return;
+    }
 
-    spmv_ell_kernel<IndexType,ValueType,UnaryFunction,BinaryFunction1,BinaryFunction2,BLOCK_SIZE> <<<NUM_BLOCKS, BLOCK_SIZE, 0, s>>>
-    (A.num_rows, A.num_cols, num_entries_per_row, pitch, J, V, x_ptr, y_ptr, initialize, combine, reduce);
+    __spmv_ell<256>(exec, A, x, y, initialize, combine, reduce);
 }
 
 } // end namespace detail
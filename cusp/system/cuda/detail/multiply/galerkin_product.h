@@ -0,0 +1,500 @@
+/*
+ *  Copyright 2008-2014 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#pragma once
+
+#include <cusp/detail/config.h>
+#include <cusp/detail/format.h>
+#include <cusp/detail/temporary_array.h>
+
+#include <cusp/array1d.h>
+#include <cusp/format_utils.h>
+#include <cusp/sort.h>
+
+#include <cusp/system/cuda/arch.h>
+#include <cusp/system/cuda/utils.h>
+#include <cusp/system/cuda/detail/multiply/hash_spgemm.h>
+#include <cusp/system/detail/generic/multiply/galerkin_product.h>
+
+#include <thrust/binary_search.h>
+#include <thrust/copy.h>
+#include <thrust/fill.h>
+#include <thrust/functional.h>
+#include <thrust/scan.h>
+#include <thrust/transform.h>
+
+#include <algorithm>
+
+namespace cusp
+{
+namespace system
+{
+namespace cuda
+{
+namespace detail
+{
+
+//////////////////////////////////////////////////////////////////////////////
+// Fused Galerkin product
+//////////////////////////////////////////////////////////////////////////////
+//
+// Every coarse row RAP(I,:) = sum_i R(I,i) * (sum_j A(i,j) * P(j,:)) is
+// accumulated by one block in a hash table keyed by coarse column, using
+// the same tables and insertion as the hash SpGEMM, so A * P is never
+// stored.  The warps are assigned to the entries of R(I,:) and the lanes
+// to the entries of A(i,:).  For smoothed aggregation the tables are
+// bounded by the small number of coarse columns and the rows of the
+// smoothed tentative prolongator are short, so every lane only walks a
+// few entries of P(j,:).  A symbolic pass counts the entries of each
+// coarse row, a numeric pass writes them unordered before a final sort.
+
+template <typename IndexType, unsigned int BLOCK_SIZE>
+__launch_bounds__(BLOCK_SIZE,1)
+__global__ void
+galerkin_row_bounds_kernel(const IndexType num_rows,
+                           const IndexType num_cols,
+                           const IndexType * Rp,
+                           const IndexType * Rj,
+                           const IndexType * Ap,
+                           const IndexType * Aj,
+                           const IndexType * Pp,
+                           IndexType * bounds)
+{
+    const IndexType thread_id = BLOCK_SIZE * blockIdx.x + threadIdx.x;
+    const IndexType grid_size = BLOCK_SIZE * gridDim.x;
+
+    for (IndexType row = thread_id; row < num_rows; row += grid_size)
+    {
+        IndexType bound = 0;
+
+        for (IndexType ii = Rp[row]; ii < Rp[row + 1] && bound < num_cols; ii++)
+        {
+            const IndexType i = Rj[ii];
+
+            for (IndexType jj = Ap[i]; jj < Ap[i + 1]; jj++)
+                bound += Pp[Aj[jj] + 1] - Pp[Aj[jj]];
+        }
+
+        bounds[row] = thrust::min(bound, num_cols);
+    }
+}
+
+template <typename IndexType, typename ValueType1, typename ValueType2, typename ValueType3,
+          unsigned int BLOCK_SIZE, bool NUMERIC>
+__launch_bounds__(BLOCK_SIZE,1)
+__global__ void
+galerkin_hash_kernel(const IndexType num_chunk_rows,
+                     const IndexType row_begin,
+                     const IndexType * table_offsets,
+                     IndexType * table_keys,
+                     ValueType3 * table_values,
+                     const IndexType * Rp,
+                     const IndexType * Rj,
+                     const ValueType1 * Rx,
+                     const IndexType * Ap,
+                     const IndexType * Aj,
+                     const ValueType2 * Ax,
+                     const IndexType * Pp,
+                     const IndexType * Pj,
+                     const ValueType1 * Px,
+                     IndexType * Cp,
+                     IndexType * Cj,
+                     ValueType3 * Cx)
+{
+    const unsigned int WARPS_PER_BLOCK = BLOCK_SIZE / WARP_SIZE;
+
+    __shared__ IndexType count;
+
+    const IndexType warp_id = threadIdx.x / WARP_SIZE;
+    const IndexType lane    = threadIdx.x % WARP_SIZE;
+
+    const IndexType table_base = table_offsets[row_begin];
+
+    for (IndexType chunk_row = blockIdx.x; chunk_row < num_chunk_rows; chunk_row += gridDim.x)
+    {
+        const IndexType row        = row_begin + chunk_row;
+        const IndexType table_size = table_offsets[row + 1] - table_offsets[row];
+
+        IndexType  * keys   = table_keys   + (table_offsets[row] - table_base);
+        ValueType3 * values = table_values + (table_offsets[row] - table_base);
+
+        for (IndexType t = threadIdx.x; t < table_size; t += BLOCK_SIZE)
+        {
+            keys[t] = IndexType(-1);
+            if (NUMERIC) values[t] = ValueType3(0);
+        }
+
+        if (threadIdx.x == 0)
+            count = 0;
+
+        __syncthreads();
+
+        IndexType inserted = 0;
+
+        for (IndexType ii = Rp[row] + warp_id; ii < Rp[row + 1]; ii += WARPS_PER_BLOCK)
+        {
+            const IndexType  i   = Rj[ii];
+            const ValueType3 RIi = NUMERIC ? ValueType3(Rx[ii]) : ValueType3(0);
+
+            for (IndexType jj = Ap[i] + lane; jj < Ap[i + 1]; jj += WARP_SIZE)
+            {
+                const IndexType  j   = Aj[jj];
+                const ValueType3 RAj = NUMERIC ? RIi * ValueType3(Ax[jj]) : ValueType3(0);
+
+                for (IndexType kk = Pp[j]; kk < Pp[j + 1]; kk++)
+                {
+                    const ValueType3 value = NUMERIC ? RAj * ValueType3(Px[kk]) : ValueType3(0);
+
+                    if (spgemm_hash_insert<NUMERIC>(keys, values, table_size - 1, Pj[kk], value))
+                        inserted++;
+                }
+            }
+        }
+
+        if (!NUMERIC && inserted > 0)
+            atomicAdd(&count, inserted);
+
+        __syncthreads();
+
+        if (!NUMERIC)
+        {
+            if (threadIdx.x == 0)
+                Cp[row] = count;
+        }
+        else
+        {
+            const IndexType offset = Cp[row];
+
+            for (IndexType t = threadIdx.x; t < table_size; t += BLOCK_SIZE)
+            {
+                const IndexType key = keys[t];
+
+                if (key == IndexType(-1))
+                    continue;
+
+                const IndexType position = atomicAdd(&count, 1);
+
+                Cj[offset + position] = key;
+                Cx[offset + position] = values[t];
+            }
+        }
+
+        __syncthreads();
+    }
+}
+
+template <bool NUMERIC,
+          typename DerivedPolicy, typename IndexType, typename ArrayType,
+          typename MatrixType1, typename MatrixType2, typename ValueType>
+void galerkin_hash(cuda::execution_policy<DerivedPolicy>& exec,
+                   const IndexType * table_offsets,
+                   const ArrayType& table_offsets_host,
+                   const ArrayType& chunk_offsets,
+                   const MatrixType1& R,
+                   const IndexType * Rp,
+                   const MatrixType2& A,
+                   const IndexType * Ap,
+                   const MatrixType1& P,
+                   const IndexType * Pp,
+                   IndexType * Cp,
+                   IndexType * Cj,
+                   ValueType * Cx)
+{
+    typedef typename MatrixType1::value_type ValueType1;
+    typedef typename MatrixType2::value_type ValueType2;
+
+    const size_t BLOCK_SIZE = 256;
+
+    const size_t MAX_BLOCKS = cusp::system::cuda::detail::max_active_blocks(
+                                  galerkin_hash_kernel<IndexType, ValueType1, ValueType2, ValueType, BLOCK_SIZE, NUMERIC>,
+                                  BLOCK_SIZE, (size_t) 0);
+
+    cudaStream_t s = stream(thrust::detail::derived_cast(exec));
+
+    // the tables of all chunks share one workspace
+    size_t capacity = 0;
+
+    for (size_t chunk = 0; chunk + 1 < chunk_offsets.size(); chunk++)
+        capacity = std::max<size_t>(capacity, table_offsets_host[chunk_offsets[chunk + 1]] - table_offsets_host[chunk_offsets[chunk]]);
+
+    cusp::detail::temporary_array<IndexType, DerivedPolicy> table_keys(exec, capacity);
+    cusp::detail::temporary_array<ValueType, DerivedPolicy> table_values(exec, NUMERIC ? capacity : 1);
+
+    for (size_t chunk = 0; chunk + 1 < chunk_offsets.size(); chunk++)
+    {
+        const IndexType begin = chunk_offsets[chunk];
+        const IndexType end   = chunk_offsets[chunk + 1];
+
+        const size_t NUM_BLOCKS = std::min<size_t>(MAX_BLOCKS, end - begin);
+
+        galerkin_hash_kernel<IndexType, ValueType1, ValueType2, ValueType, BLOCK_SIZE, NUMERIC> <<<NUM_BLOCKS, BLOCK_SIZE, 0, s>>>
+            (end - begin, begin,
+             table_offsets,
+             thrust::raw_pointer_cast(&table_keys[0]),
+             thrust::raw_pointer_cast(&table_values[0]),
+             Rp,
+             thrust::raw_pointer_cast(&R.column_indices[0]),
+             thrust::raw_pointer_cast(&R.values[0]),
+             Ap,
+             thrust::raw_pointer_cast(&A.column_indices[0]),
+             thrust::raw_pointer_cast(&A.values[0]),
+             Pp,
+             thrust::raw_pointer_cast(&P.column_indices[0]),
+             thrust::raw_pointer_cast(&P.values[0]),
+             Cp, Cj, Cx);
+    }
+}
+
+// Computes RAP = R * A * P where the rows of R, A and P are delimited by
+// the given row offsets.  RAP is resized and its column indices and values
+// are written, sorted within each row, the row offsets are returned in
+// RAP_row_offsets and installed by the caller.  Returns false without
+// touching RAP if the table of a single coarse row does not fit into
+// device memory.
+template <typename DerivedPolicy,
+          typename MatrixType1,
+          typename ArrayType1,
+          typename MatrixType2,
+          typename ArrayType2,
+          typename ArrayType3,
+          typename MatrixType3,
+          typename ArrayType4>
+bool hash_galerkin_product(cuda::execution_policy<DerivedPolicy>& exec,
+                           const MatrixType1& R,
+                           const ArrayType1& R_row_offsets,
+                           const MatrixType2& A,
+                           const ArrayType2& A_row_offsets,
+                           const MatrixType1& P,
+                           const ArrayType3& P_row_offsets,
+                           MatrixType3& RAP,
+                           ArrayType4& RAP_row_offsets)
+{
+    typedef typename MatrixType3::index_type IndexType;
+    typedef typename MatrixType3::value_type ValueType;
+
+    const size_t num_rows = R.num_rows;
+
+    const IndexType * Rp = thrust::raw_pointer_cast(&R_row_offsets[0]);
+    const IndexType * Ap = thrust::raw_pointer_cast(&A_row_offsets[0]);
+    const IndexType * Pp = thrust::raw_pointer_cast(&P_row_offsets[0]);
+
+    // upper bound of the number of entries of each coarse row
+    cusp::detail::temporary_array<IndexType, DerivedPolicy> table_offsets(exec, num_rows + 1, IndexType(0));
+
+    {
+        const size_t BLOCK_SIZE = 256;
+        const size_t MAX_BLOCKS = cusp::system::cuda::detail::max_active_blocks(
+                                      galerkin_row_bounds_kernel<IndexType, BLOCK_SIZE>, BLOCK_SIZE, (size_t) 0);
+        const size_t NUM_BLOCKS = std::min<size_t>(MAX_BLOCKS, DIVIDE_INTO(num_rows, BLOCK_SIZE));
+
+        cudaStream_t s = stream(thrust::detail::derived_cast(exec));
+
+        galerkin_row_bounds_kernel<IndexType, BLOCK_SIZE> <<<NUM_BLOCKS, BLOCK_SIZE, 0, s>>>
+            (IndexType(num_rows), IndexType(P.num_cols),
+             Rp, thrust::raw_pointer_cast(&R.column_indices[0]),
+             Ap, thrust::raw_pointer_cast(&A.column_indices[0]),
+             Pp,
+             thrust::raw_pointer_cast(&table_offsets[0]));
+    }
+
+    // size the tables and split the coarse rows into chunks fitting the workspace
+    thrust::transform(exec, table_offsets.begin(), table_offsets.end() - 1, table_offsets.begin(), spgemm_table_size<IndexType>());
+    thrust::exclusive_scan(exec, table_offsets.begin(), table_offsets.end(), table_offsets.begin(), IndexType(0));
+
+    cusp::array1d<IndexType, cusp::host_memory> table_offsets_host(table_offsets.begin(), table_offsets.end());
+    cusp::array1d<IndexType, cusp::host_memory> chunk_offsets(1, IndexType(0));
+
+    {
+        size_t capacity;
+
+        {
+            size_t free, total;
+            cudaMemGetInfo(&free, &total);
+
+            capacity = cusp::system::detail::generic::spgemm_table_capacity<IndexType,ValueType>(free);
+        }
+
+        size_t begin = 0;
+
+        while (begin < num_rows)
+        {
+            // largest end such that the tables of [begin, end) fit the capacity
+            const size_t end = thrust::upper_bound(table_offsets_host.begin() + begin + 1, table_offsets_host.end(),
+                                                   size_t(table_offsets_host[begin]) + capacity) - table_offsets_host.begin() - 1;
+
+            // the table of a single row exceeds the workspace
+            if (end == begin)
+                return false;
+
+            chunk_offsets.push_back(IndexType(end));
+            begin = end;
+        }
+    }
+
+    const IndexType * T = thrust::raw_pointer_cast(&table_offsets[0]);
+
+    // symbolic phase, count the entries of every coarse row
+    RAP_row_offsets.resize(num_rows + 1);
+    thrust::fill(exec, RAP_row_offsets.begin(), RAP_row_offsets.end(), IndexType(0));
+
+    IndexType * Cp = thrust::raw_pointer_cast(&RAP_row_offsets[0]);
+
+    galerkin_hash<false>(exec, T, table_offsets_host, chunk_offsets, R, Rp, A, Ap, P, Pp, Cp, (IndexType *) 0, (ValueType *) 0);
+
+    thrust::exclusive_scan(exec, RAP_row_offsets.begin(), RAP_row_offsets.end(), RAP_row_offsets.begin(), IndexType(0));
+
+    const IndexType num_entries = RAP_row_offsets[num_rows];
+
+    RAP.resize(R.num_rows, P.num_cols, num_entries, cusp::no_init);
+
+    if (num_entries == 0)
+        return true;
+
+    // numeric phase, accumulate and write the coarse rows
+    IndexType * Cj = thrust::raw_pointer_cast(&RAP.column_indices[0]);
+    ValueType * Cx = thrust::raw_pointer_cast(&RAP.values[0]);
+
+    galerkin_hash<true>(exec, T, table_offsets_host, chunk_offsets, R, Rp, A, Ap, P, Pp, Cp, Cj, Cx);
+
+    // the rows are written unordered
+    cusp::detail::temporary_array<IndexType, DerivedPolicy> RAP_row_indices(exec, num_entries);
+    cusp::offsets_to_indices(exec, RAP_row_offsets, RAP_row_indices);
+    cusp::sort_by_row_and_column(exec, RAP_row_indices, RAP.column_indices, RAP.values);
+
+    return true;
+}
+
+template <typename DerivedPolicy,
+          typename MatrixType1,
+          typename ArrayType1,
+          typename MatrixType2,
+          typename ArrayType2,
+          typename ArrayType3,
+          typename MatrixType3,
+          typename ArrayType4>
+bool hash_galerkin_product(cuda::execution_policy<DerivedPolicy>& exec,
+                           const MatrixType1& R,
+                           const ArrayType1& R_row_offsets,
+                           const MatrixType2& A,
+                           const ArrayType2& A_row_offsets,
+                           const MatrixType1& P,
+                           const ArrayType3& P_row_offsets,
+                           MatrixType3& RAP,
+                           ArrayType4& RAP_row_offsets,
+                           thrust::detail::true_type)
+{
+    return hash_galerkin_product(exec, R, R_row_offsets, A, A_row_offsets, P, P_row_offsets, RAP, RAP_row_offsets);
+}
+
+template <typename DerivedPolicy,
+          typename MatrixType1,
+          typename ArrayType1,
+          typename MatrixType2,
+          typename ArrayType2,
+          typename ArrayType3,
+          typename MatrixType3,
+          typename ArrayType4>
+bool hash_galerkin_product(cuda::execution_policy<DerivedPolicy>& exec,
+                           const MatrixType1& R,
+                           const ArrayType1& R_row_offsets,
+                           const MatrixType2& A,
+                           const ArrayType2& A_row_offsets,
+                           const MatrixType1& P,
+                           const ArrayType3& P_row_offsets,
+                           MatrixType3& RAP,
+                           ArrayType4& RAP_row_offsets,
+                           thrust::detail::false_type)
+{
+    return false;
+}
+
+template <typename DerivedPolicy,
+          typename MatrixType1,
+          typename MatrixType2,
+          typename MatrixType3>
+void galerkin_product(cuda::execution_policy<DerivedPolicy>& exec,
+                      const MatrixType1& R,
+                      const MatrixType2& A,
+                      const MatrixType1& P,
+                            MatrixType3& RAP,
+                      cusp::coo_format,
+                      cusp::coo_format,
+                      cusp::coo_format)
+{
+    typedef typename MatrixType3::index_type IndexType;
+    typedef typename MatrixType3::value_type ValueType;
+    typedef hash_spgemm_supported<MatrixType1,MatrixType2,MatrixType3,thrust::plus<ValueType> > HashSupported;
+
+    if (HashSupported::value && R.num_entries > 0 && A.num_entries > 0 && P.num_entries > 0)
+    {
+        cusp::detail::temporary_array<IndexType, DerivedPolicy> R_row_offsets(exec, R.num_rows + 1);
+        cusp::detail::temporary_array<IndexType, DerivedPolicy> A_row_offsets(exec, A.num_rows + 1);
+        cusp::detail::temporary_array<IndexType, DerivedPolicy> P_row_offsets(exec, P.num_rows + 1);
+        cusp::detail::temporary_array<IndexType, DerivedPolicy> RAP_row_offsets(exec, R.num_rows + 1);
+
+        cusp::indices_to_offsets(exec, R.row_indices, R_row_offsets);
+        cusp::indices_to_offsets(exec, A.row_indices, A_row_offsets);
+        cusp::indices_to_offsets(exec, P.row_indices, P_row_offsets);
+
+        if (hash_galerkin_product(exec, R, R_row_offsets, A, A_row_offsets, P, P_row_offsets, RAP, RAP_row_offsets, HashSupported()))
+        {
+            cusp::offsets_to_indices(exec, RAP_row_offsets, RAP.row_indices);
+            return;
+        }
+    }
+
+    // compute A * P followed by R * (A * P)
+    cusp::system::detail::generic::galerkin_product(exec, R, A, P, RAP,
+                                                    cusp::sparse_format(), cusp::sparse_format(), cusp::sparse_format());
+}
+
+template <typename DerivedPolicy,
+          typename MatrixType1,
+          typename MatrixType2,
+          typename MatrixType3>
+void galerkin_product(cuda::execution_policy<DerivedPolicy>& exec,
+                      const MatrixType1& R,
+                      const MatrixType2& A,
+                      const MatrixType1& P,
+                            MatrixType3& RAP,
+                      cusp::csr_format,
+                      cusp::csr_format,
+                      cusp::csr_format)
+{
+    typedef typename MatrixType3::index_type IndexType;
+    typedef typename MatrixType3::value_type ValueType;
+    typedef hash_spgemm_supported<MatrixType1,MatrixType2,MatrixType3,thrust::plus<ValueType> > HashSupported;
+
+    if (HashSupported::value && R.num_entries > 0 && A.num_entries > 0 && P.num_entries > 0)
+    {
+        cusp::detail::temporary_array<IndexType, DerivedPolicy> RAP_row_offsets(exec, R.num_rows + 1);
+
+        if (hash_galerkin_product(exec, R, R.row_offsets, A, A.row_offsets, P, P.row_offsets, RAP, RAP_row_offsets, HashSupported()))
+        {
+            thrust::copy(exec, RAP_row_offsets.begin(), RAP_row_offsets.end(), RAP.row_offsets.begin());
+            return;
+        }
+    }
+
+    // compute A * P followed by R * (A * P)
+    cusp::system::detail::generic::galerkin_product(exec, R, A, P, RAP,
+                                                    cusp::sparse_format(), cusp::sparse_format(), cusp::sparse_format());
+}
+
+} // end namespace detail
+} // end namespace cuda
+} // end namespace system
+} // end namespace cusp
@@ -0,0 +1,1014 @@
+/*
+ *  Copyright 2008-2014 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#pragma once
+
+#include <cusp/format_utils.h>
+#include <cusp/sort.h>
+
+#include <cusp/detail/temporary_array.h>
+#include <cusp/detail/type_traits.h>
+
+#include <cusp/system/cuda/arch.h>
+#include <cusp/system/cuda/utils.h>
+#include <cusp/system/detail/generic/multiply/spgemm_workspace.h>
+
+#include <thrust/binary_search.h>
+#include <thrust/copy.h>
+#include <thrust/fill.h>
+#include <thrust/functional.h>
+#include <thrust/scan.h>
+#include <thrust/transform.h>
+#include <thrust/detail/type_traits.h>
+#include <thrust/iterator/counting_iterator.h>
+#include <thrust/iterator/permutation_iterator.h>
+
+#include <algorithm>
+
+namespace cusp
+{
+namespace system
+{
+namespace cuda
+{
+namespace detail
+{
+
+//////////////////////////////////////////////////////////////////////////////
+// Hash-based row-wise SpGEMM
+//////////////////////////////////////////////////////////////////////////////
+//
+// Each row C(i,:) = sum_k A(i,k) * B(k,:) is accumulated in a hash table
+// keyed by column index (Gustavson's algorithm).  The rows are binned by
+// an upper bound of their number of nonzeros and every bin is handled by
+// a kernel specialized for its size: tiny rows are merged by one thread
+// into a sorted list without hashing, warp-sized rows by one warp with a
+// table in shared memory, larger rows by one block with a table in shared
+// memory and the rows of the last bin use tables in global memory.  The
+// bins are independent and processed on separate streams so that the
+// kernels of small bins overlap with each other and with the large ones.
+// A symbolic pass counts the distinct columns of every row, then a numeric
+// pass accumulates the values and writes the row.  Within a block the
+// warps are assigned to the entries of A(i,:) and the lanes to the entries
+// of B(k,:).
+//
+// Unlike the expansion (ESC) approach the workspace only depends on the
+// output, never on the number of intermediate products.  Keys are claimed
+// with atomicCAS and values accumulated with atomic addition, hence the
+// hash kernels only handle int indices, float or double values and the
+// default reduction (addition); multiply falls back to ESC otherwise.
+// Row offsets wider than the column indices also take the ESC path.
+
+template <typename IndexType, typename ValueType, typename BinaryFunction>
+struct hash_spgemm_value_supported : thrust::detail::false_type {};
+
+template <>
+struct hash_spgemm_value_supported<int, float, thrust::plus<float> > : thrust::detail::true_type {};
+
+template <>
+struct hash_spgemm_value_supported<int, double, thrust::plus<double> > : thrust::detail::true_type {};
+
+template <typename MatrixType1, typename MatrixType2, typename MatrixType3, typename BinaryFunction>
+struct hash_spgemm_supported
+  : thrust::detail::and_<
+      hash_spgemm_value_supported<typename MatrixType3::index_type, typename MatrixType3::value_type, BinaryFunction>,
+      thrust::detail::is_same<typename MatrixType1::index_type, typename MatrixType3::index_type>,
+      thrust::detail::is_same<typename MatrixType2::index_type, typename MatrixType3::index_type>,
+      thrust::detail::and_<
+        thrust::detail::is_same<typename cusp::detail::get_offset_type<MatrixType1>::type, typename MatrixType3::index_type>,
+        thrust::detail::is_same<typename cusp::detail::get_offset_type<MatrixType2>::type, typename MatrixType3::index_type>,
+        thrust::detail::is_same<typename cusp::detail::get_offset_type<MatrixType3>::type, typename MatrixType3::index_type>
+      >
+    >
+{};
+
+#if defined(__CUDACC__)
+// insert key into the open addressing table, returns true if the key was
+// not present before
+template <bool NUMERIC, typename IndexType, typename ValueType>
+__device__ bool
+spgemm_hash_insert(IndexType * keys,
+                   ValueType * values,
+                   const IndexType mask,
+                   const IndexType key,
+                   const ValueType value)
+{
+    IndexType slot = IndexType((unsigned int) key * 107u) & mask;
+
+    while (true)
+    {
+        const IndexType old = atomicCAS(keys + slot, IndexType(-1), key);
+
+        if (old == IndexType(-1) || old == key)
+        {
+            if (NUMERIC)
+                atomic_add(values + slot, value);
+
+            return old == IndexType(-1);
+        }
+
+        slot = (slot + 1) & mask;
+    }
+}
+#endif
+
+// each thread merges the products of one row into a sorted list, the
+// number of products of the row must not exceed LIST_SIZE
+template <typename IndexType, typename ValueType1, typename ValueType2, typename ValueType3,
+          typename BinaryFunction, unsigned int BLOCK_SIZE, unsigned int LIST_SIZE, bool NUMERIC>
+__launch_bounds__(BLOCK_SIZE,1)
+__global__ void
+spgemm_tiny_kernel(const IndexType num_bin_rows,
+                   const IndexType * rows,
+                   const IndexType * Ap,
+                   const IndexType * Aj,
+                   const ValueType1 * Ax,
+                   const IndexType * Bp,
+                   const IndexType * Bj,
+                   const ValueType2 * Bx,
+                   IndexType * Cp,
+                   IndexType * Cj,
+                   ValueType3 * Cx,
+                   BinaryFunction combine)
+{
+    const IndexType thread_id = BLOCK_SIZE * blockIdx.x + threadIdx.x;
+    const IndexType grid_size = BLOCK_SIZE * gridDim.x;
+
+    for (IndexType bin_row = thread_id; bin_row < num_bin_rows; bin_row += grid_size)
+    {
+        const IndexType row = rows[bin_row];
+
+        IndexType  keys[LIST_SIZE];
+        ValueType3 values[NUMERIC ? LIST_SIZE : 1];
+        IndexType  length = 0;
+
+        for (IndexType jj = Ap[row]; jj < Ap[row + 1]; jj++)
+        {
+            const IndexType  k   = Aj[jj];
+            const ValueType1 Aik = Ax[jj];
+
+            for (IndexType kk = Bp[k]; kk < Bp[k + 1]; kk++)
+            {
+                const IndexType key = Bj[kk];
+
+                IndexType position = 0;
+
+                while (position < length && keys[position] < key)
+                    position++;
+
+                if (position < length && keys[position] == key)
+                {
+                    if (NUMERIC)
+                        values[position] += ValueType3(combine(Aik, Bx[kk]));
+
+                    continue;
+                }
+
+                // shift the larger keys to insert the new one
+                for (IndexType t = length; t > position; t--)
+                {
+                    keys[t] = keys[t - 1];
+                    if (NUMERIC) values[t] = values[t - 1];
+                }
+
+                keys[position] = key;
+                if (NUMERIC) values[position] = ValueType3(combine(Aik, Bx[kk]));
+
+                length++;
+            }
+        }
+
+        if (!NUMERIC)
+        {
+            Cp[row] = length;
+        }
+        else
+        {
+            const IndexType offset = Cp[row];
+
+            for (IndexType t = 0; t < length; t++)
+            {
+                Cj[offset + t] = keys[t];
+                Cx[offset + t] = values[t];
+            }
+        }
+    }
+}
+
+// each warp accumulates one row in its own shared memory table, the warps
+// of a block advance together so that __syncthreads separates the phases
+template <typename IndexType, typename ValueType1, typename ValueType2, typename ValueType3,
+          typename BinaryFunction, unsigned int BLOCK_SIZE, unsigned int TABLE_SIZE, bool NUMERIC>
+__launch_bounds__(BLOCK_SIZE,1)
+__global__ void
+spgemm_hash_warp_kernel(const IndexType num_bin_rows,
+                        const IndexType * rows,
+                        const IndexType * Ap,
+                        const IndexType * Aj,
+                        const ValueType1 * Ax,
+                        const IndexType * Bp,
+                        const IndexType * Bj,
+                        const ValueType2 * Bx,
+                        IndexType * Cp,
+                        IndexType * Cj,
+                        ValueType3 * Cx,
+                        BinaryFunction combine)
+{
+    const unsigned int WARPS_PER_BLOCK = BLOCK_SIZE / WARP_SIZE;
+
+    __shared__ IndexType  keys[WARPS_PER_BLOCK][TABLE_SIZE];
+    __shared__ ValueType3 values[WARPS_PER_BLOCK][NUMERIC ? TABLE_SIZE : 1];
+    __shared__ IndexType  count[WARPS_PER_BLOCK];
+
+    const IndexType warp_id = threadIdx.x / WARP_SIZE;
+    const IndexType lane    = threadIdx.x % WARP_SIZE;
+
+    for (IndexType base = WARPS_PER_BLOCK * blockIdx.x; base < num_bin_rows; base += WARPS_PER_BLOCK * gridDim.x)
+    {
+        const IndexType bin_row = base + warp_id;
+        const bool      active  = bin_row < num_bin_rows;
+        const IndexType row     = active ? rows[bin_row] : IndexType(0);
+
+        for (IndexType t = lane; t < IndexType(TABLE_SIZE); t += WARP_SIZE)
+        {
+            keys[warp_id][t] = IndexType(-1);
+            if (NUMERIC) values[warp_id][t] = ValueType3(0);
+        }
+
+        if (lane == 0)
+            count[warp_id] = 0;
+
+        __syncthreads();
+
+        IndexType inserted = 0;
+
+        if (active)
+        {
+            for (IndexType jj = Ap[row]; jj < Ap[row + 1]; jj++)
+            {
+                const IndexType  k   = Aj[jj];
+                const ValueType1 Aik = Ax[jj];
+
+                for (IndexType kk = Bp[k] + lane; kk < Bp[k + 1]; kk += WARP_SIZE)
+                {
+                    const ValueType3 value = NUMERIC ? ValueType3(combine(Aik, Bx[kk])) : ValueType3(0);
+
+                    if (spgemm_hash_insert<NUMERIC>(keys[warp_id], values[warp_id], IndexType(TABLE_SIZE - 1), Bj[kk], value))
+                        inserted++;
+                }
+            }
+        }
+
+        if (!NUMERIC && inserted > 0)
+            atomicAdd(&count[warp_id], inserted);
+
+        __syncthreads();
+
+        if (active)
+        {
+            if (!NUMERIC)
+            {
+                if (lane == 0)
+                    Cp[row] = count[warp_id];
+            }
+            else
+            {
+                const IndexType offset = Cp[row];
+
+                for (IndexType t = lane; t < IndexType(TABLE_SIZE); t += WARP_SIZE)
+                {
+                    const IndexType key = keys[warp_id][t];
+
+                    if (key == IndexType(-1))
+                        continue;
+
+                    IndexType rank = 0;
+
+                    for (IndexType u = 0; u < IndexType(TABLE_SIZE); u++)
+                    {
+                        const IndexType other = keys[warp_id][u];
+                        rank += (other != IndexType(-1) && other < key);
+                    }
+
+                    Cj[offset + rank] = key;
+                    Cx[offset + rank] = values[warp_id][t];
+                }
+            }
+        }
+
+        __syncthreads();
+    }
+}
+
+template <typename IndexType, typename ValueType1, typename ValueType2, typename ValueType3,
+          typename BinaryFunction, unsigned int BLOCK_SIZE, unsigned int TABLE_SIZE, bool NUMERIC>
+__launch_bounds__(BLOCK_SIZE,1)
+__global__ void
+spgemm_hash_shared_kernel(const IndexType num_bin_rows,
+                          const IndexType * rows,
+                          const IndexType * Ap,
+                          const IndexType * Aj,
+                          const ValueType1 * Ax,
+                          const IndexType * Bp,
+                          const IndexType * Bj,
+                          const ValueType2 * Bx,
+                          IndexType * Cp,
+                          IndexType * Cj,
+                          ValueType3 * Cx,
+                          BinaryFunction combine)
+{
+    const unsigned int WARPS_PER_BLOCK = BLOCK_SIZE / WARP_SIZE;
+
+    __shared__ IndexType  keys[TABLE_SIZE];
+    __shared__ ValueType3 values[NUMERIC ? TABLE_SIZE : 1];
+    __shared__ IndexType  count;
+
+    const IndexType warp_id = threadIdx.x / WARP_SIZE;
+    const IndexType lane    = threadIdx.x % WARP_SIZE;
+
+    for (IndexType bin_row = blockIdx.x; bin_row < num_bin_rows; bin_row += gridDim.x)
+    {
+        const IndexType row = rows[bin_row];
+
+        for (IndexType t = threadIdx.x; t < IndexType(TABLE_SIZE); t += BLOCK_SIZE)
+        {
+            keys[t] = IndexType(-1);
+            if (NUMERIC) values[t] = ValueType3(0);
+        }
+
+        if (threadIdx.x == 0)
+            count = 0;
+
+        __syncthreads();
+
+        IndexType inserted = 0;
+
+        for (IndexType jj = Ap[row] + warp_id; jj < Ap[row + 1]; jj += WARPS_PER_BLOCK)
+        {
+            const IndexType  k   = Aj[jj];
+            const ValueType1 Aik = Ax[jj];
+
+            for (IndexType kk = Bp[k] + lane; kk < Bp[k + 1]; kk += WARP_SIZE)
+            {
+                const ValueType3 value = NUMERIC ? ValueType3(combine(Aik, Bx[kk])) : ValueType3(0);
+
+                if (spgemm_hash_insert<NUMERIC>(keys, values, IndexType(TABLE_SIZE - 1), Bj[kk], value))
+                    inserted++;
+            }
+        }
+
+        if (!NUMERIC && inserted > 0)
+            atomicAdd(&count, inserted);
+
+        __syncthreads();
+
+        if (!NUMERIC)
+        {
+            if (threadIdx.x == 0)
+                Cp[row] = count;
+        }
+        else
+        {
+            // the rank of a key among the keys of the table is its position in the sorted row
+            const IndexType offset = Cp[row];
+
+            for (IndexType t = threadIdx.x; t < IndexType(TABLE_SIZE); t += BLOCK_SIZE)
+            {
+                const IndexType key = keys[t];
+
+                if (key == IndexType(-1))
+                    continue;
+
+                IndexType rank = 0;
+
+                for (IndexType u = 0; u < IndexType(TABLE_SIZE); u++)
+                {
+                    const IndexType other = keys[u];
+                    rank += (other != IndexType(-1) && other < key);
+                }
+
+                Cj[offset + rank] = key;
+                Cx[offset + rank] = values[t];
+            }
+        }
+
+        __syncthreads();
+    }
+}
+
+template <typename IndexType, typename ValueType1, typename ValueType2, typename ValueType3,
+          typename BinaryFunction, unsigned int BLOCK_SIZE, bool NUMERIC>
+__launch_bounds__(BLOCK_SIZE,1)
+__global__ void
+spgemm_hash_global_kernel(const IndexType num_bin_rows,
+                          const IndexType * rows,
+                          const IndexType * table_offsets,
+                          const IndexType table_base,
+                          IndexType * table_keys,
+                          ValueType3 * table_values,
+                          const IndexType * Ap,
+                          const IndexType * Aj,
+                          const ValueType1 * Ax,
+                          const IndexType * Bp,
+                          const IndexType * Bj,
+                          const ValueType2 * Bx,
+                          IndexType * Cp,
+                          IndexType * Cj,
+                          ValueType3 * Cx,
+                          BinaryFunction combine)
+{
+    const unsigned int WARPS_PER_BLOCK = BLOCK_SIZE / WARP_SIZE;
+
+    __shared__ IndexType count;
+
+    const IndexType warp_id = threadIdx.x / WARP_SIZE;
+    const IndexType lane    = threadIdx.x % WARP_SIZE;
+
+    for (IndexType bin_row = blockIdx.x; bin_row < num_bin_rows; bin_row += gridDim.x)
+    {
+        const IndexType row        = rows[bin_row];
+        const IndexType table_size = table_offsets[bin_row + 1] - table_offsets[bin_row];
+
+        IndexType  * keys   = table_keys   + (table_offsets[bin_row] - table_base);
+        ValueType3 * values = table_values + (table_offsets[bin_row] - table_base);
+
+        for (IndexType t = threadIdx.x; t < table_size; t += BLOCK_SIZE)
+        {
+            keys[t] = IndexType(-1);
+            if (NUMERIC) values[t] = ValueType3(0);
+        }
+
+        if (threadIdx.x == 0)
+            count = 0;
+
+        __syncthreads();
+
+        IndexType inserted = 0;
+
+        for (IndexType jj = Ap[row] + warp_id; jj < Ap[row + 1]; jj += WARPS_PER_BLOCK)
+        {
+            const IndexType  k   = Aj[jj];
+            const ValueType1 Aik = Ax[jj];
+
+            for (IndexType kk = Bp[k] + lane; kk < Bp[k + 1]; kk += WARP_SIZE)
+            {
+                const ValueType3 value = NUMERIC ? ValueType3(combine(Aik, Bx[kk])) : ValueType3(0);
+
+                if (spgemm_hash_insert<NUMERIC>(keys, values, table_size - 1, Bj[kk], value))
+                    inserted++;
+            }
+        }
+
+        if (!NUMERIC && inserted > 0)
+            atomicAdd(&count, inserted);
+
+        __syncthreads();
+
+        if (!NUMERIC)
+        {
+            if (threadIdx.x == 0)
+                Cp[row] = count;
+        }
+        else
+        {
+            // rows of this bin are compacted unordered and sorted afterwards
+            const IndexType offset = Cp[row];
+
+            for (IndexType t = threadIdx.x; t < table_size; t += BLOCK_SIZE)
+            {
+                const IndexType key = keys[t];
+
+                if (key == IndexType(-1))
+                    continue;
+
+                const IndexType position = atomicAdd(&count, 1);
+
+                Cj[offset + position] = key;
+                Cx[offset + position] = values[t];
+            }
+        }
+
+        __syncthreads();
+    }
+}
+
+template <typename IndexType, unsigned int BLOCK_SIZE>
+__launch_bounds__(BLOCK_SIZE,1)
+__global__ void
+spgemm_row_bounds_kernel(const IndexType num_rows,
+                         const IndexType num_cols,
+                         const IndexType * Ap,
+                         const IndexType * Aj,
+                         const IndexType * Bp,
+                         IndexType * bounds)
+{
+    const IndexType thread_id = BLOCK_SIZE * blockIdx.x + threadIdx.x;
+    const IndexType grid_size = BLOCK_SIZE * gridDim.x;
+
+    for (IndexType row = thread_id; row < num_rows; row += grid_size)
+    {
+        IndexType bound = 0;
+
+        for (IndexType jj = Ap[row]; jj < Ap[row + 1]; jj++)
+            bound += Bp[Aj[jj] + 1] - Bp[Aj[jj]];
+
+        bounds[row] = thrust::min(bound, num_cols);
+    }
+}
+
+// streams on which the bins of a pass run concurrently, they start after
+// the work issued to the parent stream so far and the parent stream waits
+// for all of them when the object is destroyed
+class spgemm_bin_streams
+{
+public:
+
+    static const int NUM_STREAMS = 5;
+
+    spgemm_bin_streams(cudaStream_t parent)
+        : parent(parent)
+    {
+        cudaEventCreateWithFlags(&fork_event, cudaEventDisableTiming);
+        cudaEventRecord(fork_event, parent);
+
+        for (int i = 0; i < NUM_STREAMS; i++)
+        {
+            cudaStreamCreateWithFlags(&streams[i], cudaStreamNonBlocking);
+            cudaStreamWaitEvent(streams[i], fork_event, 0);
+            cudaEventCreateWithFlags(&join_events[i], cudaEventDisableTiming);
+        }
+    }
+
+    ~spgemm_bin_streams(void)
+    {
+        for (int i = 0; i < NUM_STREAMS; i++)
+        {
+            cudaEventRecord(join_events[i], streams[i]);
+            cudaStreamWaitEvent(parent, join_events[i], 0);
+            cudaEventDestroy(join_events[i]);
+            cudaStreamDestroy(streams[i]);
+        }
+
+        cudaEventDestroy(fork_event);
+    }
+
+    cudaStream_t operator[](const int i) const
+    {
+        return streams[i];
+    }
+
+private:
+
+    cudaStream_t parent;
+    cudaStream_t streams[NUM_STREAMS];
+    cudaEvent_t  fork_event;
+    cudaEvent_t  join_events[NUM_STREAMS];
+};
+
+template <typename IndexType>
+struct spgemm_bin_predicate : public thrust::unary_function<IndexType,bool>
+{
+    IndexType lower;
+    IndexType upper;
+
+    spgemm_bin_predicate(const IndexType lower, const IndexType upper)
+        : lower(lower), upper(upper) {}
+
+    __host__ __device__
+    bool operator()(const IndexType bound) const
+    {
+        return bound > lower && bound <= upper;
+    }
+};
+
+// global tables are kept at most half full and their size a power of two
+template <typename IndexType>
+struct spgemm_table_size : public thrust::unary_function<IndexType,IndexType>
+{
+    __host__ __device__
+    IndexType operator()(const IndexType bound) const
+    {
+        IndexType size = 1;
+
+        while (size < 2 * bound)
+            size *= 2;
+
+        return size;
+    }
+};
+
+template <unsigned int BLOCK_SIZE, unsigned int LIST_SIZE, bool NUMERIC,
+          typename DerivedPolicy, typename IndexType, typename MatrixType1, typename MatrixType2,
+          typename ValueType, typename BinaryFunction>
+void spgemm_tiny(cuda::execution_policy<DerivedPolicy>& exec,
+                 cudaStream_t s,
+                 const IndexType * rows,
+                 const size_t num_bin_rows,
+                 const MatrixType1& A,
+                 const IndexType * Ap,
+                 const MatrixType2& B,
+                 const IndexType * Bp,
+                 IndexType * Cp,
+                 IndexType * Cj,
+                 ValueType * Cx,
+                 BinaryFunction combine)
+{
+    typedef typename MatrixType1::value_type ValueType1;
+    typedef typename MatrixType2::value_type ValueType2;
+
+    if (num_bin_rows == 0)
+        return;
+
+    const size_t MAX_BLOCKS = cusp::system::cuda::detail::max_active_blocks(
+                                  spgemm_tiny_kernel<IndexType, ValueType1, ValueType2, ValueType,
+                                  BinaryFunction, BLOCK_SIZE, LIST_SIZE, NUMERIC>, BLOCK_SIZE, (size_t) 0);
+    const size_t NUM_BLOCKS = std::min<size_t>(MAX_BLOCKS, DIVIDE_INTO(num_bin_rows, BLOCK_SIZE));
+
+    spgemm_tiny_kernel<IndexType, ValueType1, ValueType2, ValueType,
+                       BinaryFunction, BLOCK_SIZE, LIST_SIZE, NUMERIC> <<<NUM_BLOCKS, BLOCK_SIZE, 0, s>>>
+                       (IndexType(num_bin_rows), rows,
+                        Ap,
+                        thrust::raw_pointer_cast(&A.column_indices[0]),
+                        thrust::raw_pointer_cast(&A.values[0]),
+                        Bp,
+                        thrust::raw_pointer_cast(&B.column_indices[0]),
+                        thrust::raw_pointer_cast(&B.values[0]),
+                        Cp, Cj, Cx, combine);
+}
+
+template <unsigned int BLOCK_SIZE, unsigned int TABLE_SIZE, bool NUMERIC,
+          typename DerivedPolicy, typename IndexType, typename MatrixType1, typename MatrixType2,
+          typename ValueType, typename BinaryFunction>
+void spgemm_hash_warp(cuda::execution_policy<DerivedPolicy>& exec,
+                      cudaStream_t s,
+                      const IndexType * rows,
+                      const size_t num_bin_rows,
+                      const MatrixType1& A,
+                      const IndexType * Ap,
+                      const MatrixType2& B,
+                      const IndexType * Bp,
+                      IndexType * Cp,
+                      IndexType * Cj,
+                      ValueType * Cx,
+                      BinaryFunction combine)
+{
+    typedef typename MatrixType1::value_type ValueType1;
+    typedef typename MatrixType2::value_type ValueType2;
+
+    const size_t WARPS_PER_BLOCK = BLOCK_SIZE / WARP_SIZE;
+
+    if (num_bin_rows == 0)
+        return;
+
+    const size_t MAX_BLOCKS = cusp::system::cuda::detail::max_active_blocks(
+                                  spgemm_hash_warp_kernel<IndexType, ValueType1, ValueType2, ValueType,
+                                  BinaryFunction, BLOCK_SIZE, TABLE_SIZE, NUMERIC>, BLOCK_SIZE, (size_t) 0);
+    const size_t NUM_BLOCKS = std::min<size_t>(MAX_BLOCKS, DIVIDE_INTO(num_bin_rows, WARPS_PER_BLOCK));
+
+    spgemm_hash_warp_kernel<IndexType, ValueType1, ValueType2, ValueType,
+                            BinaryFunction, BLOCK_SIZE, TABLE_SIZE, NUMERIC> <<<NUM_BLOCKS, BLOCK_SIZE, 0, s>>>
+                            (IndexType(num_bin_rows), rows,
+                             Ap,
+                             thrust::raw_pointer_cast(&A.column_indices[0]),
+                             thrust::raw_pointer_cast(&A.values[0]),
+                             Bp,
+                             thrust::raw_pointer_cast(&B.column_indices[0]),
+                             thrust::raw_pointer_cast(&B.values[0]),
+                             Cp, Cj, Cx, combine);
+}
+
+template <unsigned int BLOCK_SIZE, unsigned int TABLE_SIZE, bool NUMERIC,
+          typename DerivedPolicy, typename IndexType, typename MatrixType1, typename MatrixType2,
+          typename ValueType, typename BinaryFunction>
+void spgemm_hash_shared(cuda::execution_policy<DerivedPolicy>& exec,
+                        cudaStream_t s,
+                        const IndexType * rows,
+                        const size_t num_bin_rows,
+                        const MatrixType1& A,
+                        const IndexType * Ap,
+                        const MatrixType2& B,
+                        const IndexType * Bp,
+                        IndexType * Cp,
+                        IndexType * Cj,
+                        ValueType * Cx,
+                        BinaryFunction combine)
+{
+    typedef typename MatrixType1::value_type ValueType1;
+    typedef typename MatrixType2::value_type ValueType2;
+
+    if (num_bin_rows == 0)
+        return;
+
+    const size_t MAX_BLOCKS = cusp::system::cuda::detail::max_active_blocks(
+                                  spgemm_hash_shared_kernel<IndexType, ValueType1, ValueType2, ValueType,
+                                  BinaryFunction, BLOCK_SIZE, TABLE_SIZE, NUMERIC>, BLOCK_SIZE, (size_t) 0);
+    const size_t NUM_BLOCKS = std::min<size_t>(MAX_BLOCKS, num_bin_rows);
+
+    spgemm_hash_shared_kernel<IndexType, ValueType1, ValueType2, ValueType,
+                              BinaryFunction, BLOCK_SIZE, TABLE_SIZE, NUMERIC> <<<NUM_BLOCKS, BLOCK_SIZE, 0, s>>>
+                              (IndexType(num_bin_rows), rows,
+                               Ap,
+                               thrust::raw_pointer_cast(&A.column_indices[0]),
+                               thrust::raw_pointer_cast(&A.values[0]),
+                               Bp,
+                               thrust::raw_pointer_cast(&B.column_indices[0]),
+                               thrust::raw_pointer_cast(&B.values[0]),
+                               Cp, Cj, Cx, combine);
+}
+
+template <bool NUMERIC,
+          typename DerivedPolicy, typename IndexType, typename ArrayType,
+          typename MatrixType1, typename MatrixType2,
+          typename ValueType, typename BinaryFunction>
+void spgemm_hash_global(cuda::execution_policy<DerivedPolicy>& exec,
+                        const IndexType * rows,
+                        const IndexType * table_offsets,
+                        const ArrayType& table_offsets_host,
+                        const ArrayType& chunk_offsets,
+                        const MatrixType1& A,
+                        const IndexType * Ap,
+                        const MatrixType2& B,
+                        const IndexType * Bp,
+                        IndexType * Cp,
+                        IndexType * Cj,
+                        ValueType * Cx,
+                        BinaryFunction combine)
+{
+    typedef typename MatrixType1::value_type ValueType1;
+    typedef typename MatrixType2::value_type ValueType2;
+
+    const size_t BLOCK_SIZE = 256;
+
+    const size_t MAX_BLOCKS = cusp::system::cuda::detail::max_active_blocks(
+                                  spgemm_hash_global_kernel<IndexType, ValueType1, ValueType2, ValueType,
+                                  BinaryFunction, BLOCK_SIZE, NUMERIC>, BLOCK_SIZE, (size_t) 0);
+
+    cudaStream_t s = stream(thrust::detail::derived_cast(exec));
+
+    // the tables of all chunks share one workspace
+    size_t capacity = 0;
+
+    for (size_t chunk = 0; chunk + 1 < chunk_offsets.size(); chunk++)
+        capacity = std::max<size_t>(capacity, table_offsets_host[chunk_offsets[chunk + 1]] - table_offsets_host[chunk_offsets[chunk]]);
+
+    cusp::detail::temporary_array<IndexType, DerivedPolicy> table_keys(exec, capacity);
+    cusp::detail::temporary_array<ValueType, DerivedPolicy> table_values(exec, NUMERIC ? capacity : 1);
+
+    for (size_t chunk = 0; chunk + 1 < chunk_offsets.size(); chunk++)
+    {
+        const IndexType begin = chunk_offsets[chunk];
+        const IndexType end   = chunk_offsets[chunk + 1];
+
+        const size_t NUM_BLOCKS = std::min<size_t>(MAX_BLOCKS, end - begin);
+
+        spgemm_hash_global_kernel<IndexType, ValueType1, ValueType2, ValueType,
+                                  BinaryFunction, BLOCK_SIZE, NUMERIC> <<<NUM_BLOCKS, BLOCK_SIZE, 0, s>>>
+                                  (end - begin,
+                                   rows + begin,
+                                   table_offsets + begin,
+                                   table_offsets_host[begin],
+                                   thrust::raw_pointer_cast(&table_keys[0]),
+                                   thrust::raw_pointer_cast(&table_values[0]),
+                                   Ap,
+                                   thrust::raw_pointer_cast(&A.column_indices[0]),
+                                   thrust::raw_pointer_cast(&A.values[0]),
+                                   Bp,
+                                   thrust::raw_pointer_cast(&B.column_indices[0]),
+                                   thrust::raw_pointer_cast(&B.values[0]),
+                                   Cp, Cj, Cx, combine);
+    }
+}
+
+// Computes C = A * B where the rows of A and B are delimited by A_row_offsets
+// and B_row_offsets.  C is resized to the size of the product and its column
+// indices and values are written, the row offsets of C are returned in
+// C_row_offsets and installed by the caller.  Returns false without touching
+// C if the global hash table of a single row does not fit into device memory.
+template <typename DerivedPolicy,
+          typename MatrixType1,
+          typename ArrayType1,
+          typename MatrixType2,
+          typename ArrayType2,
+          typename MatrixType3,
+          typename ArrayType3,
+          typename BinaryFunction>
+bool hash_spgemm(cuda::execution_policy<DerivedPolicy>& exec,
+                 const MatrixType1& A,
+                 const ArrayType1& A_row_offsets,
+                 const MatrixType2& B,
+                 const ArrayType2& B_row_offsets,
+                 MatrixType3& C,
+                 ArrayType3& C_row_offsets,
+                 BinaryFunction combine)
+{
+    typedef typename MatrixType3::index_type IndexType;
+    typedef typename MatrixType3::value_type ValueType;
+
+    const size_t num_rows = A.num_rows;
+
+    // upper bound of the number of nonzeros of each row of C
+    cusp::detail::temporary_array<IndexType, DerivedPolicy> bounds(exec, num_rows);
+
+    {
+        const size_t BLOCK_SIZE = 256;
+        const size_t MAX_BLOCKS = cusp::system::cuda::detail::max_active_blocks(
+                                      spgemm_row_bounds_kernel<IndexType, BLOCK_SIZE>, BLOCK_SIZE, (size_t) 0);
+        const size_t NUM_BLOCKS = std::min<size_t>(MAX_BLOCKS, DIVIDE_INTO(num_rows, BLOCK_SIZE));
+
+        cudaStream_t s = stream(thrust::detail::derived_cast(exec));
+
+        spgemm_row_bounds_kernel<IndexType, BLOCK_SIZE> <<<NUM_BLOCKS, BLOCK_SIZE, 0, s>>>
+            (IndexType(num_rows), IndexType(B.num_cols),
+             thrust::raw_pointer_cast(&A_row_offsets[0]),
+             thrust::raw_pointer_cast(&A.column_indices[0]),
+             thrust::raw_pointer_cast(&B_row_offsets[0]),
+             thrust::raw_pointer_cast(&bounds[0]));
+    }
+
+    // bin the rows by their bound: tiny rows are merged in registers, the
+    // next four bins use shared memory tables of twice the size of the bin
+    // and the last bin global tables, empty rows are skipped
+    const IndexType bin_bounds[7] = { 0, 16, 32, 128, 512, 1024, IndexType(B.num_cols) };
+
+    cusp::detail::temporary_array<IndexType, DerivedPolicy> rows(exec, num_rows);
+    size_t bin_offsets[7];
+
+    bin_offsets[0] = 0;
+
+    for (int bin = 0; bin < 6; bin++)
+    {
+        bin_offsets[bin + 1] =
+            thrust::copy_if(exec,
+                            thrust::counting_iterator<IndexType>(0),
+                            thrust::counting_iterator<IndexType>(num_rows),
+                            bounds.begin(),
+                            rows.begin() + bin_offsets[bin],
+                            spgemm_bin_predicate<IndexType>(bin_bounds[bin], bin_bounds[bin + 1])) - rows.begin();
+    }
+
+    const size_t num_global_rows = bin_offsets[6] - bin_offsets[5];
+
+    // size the global tables and split their rows into chunks fitting the workspace
+    cusp::detail::temporary_array<IndexType, DerivedPolicy> table_offsets(exec, num_global_rows + 1, IndexType(0));
+    cusp::array1d<IndexType, cusp::host_memory> table_offsets_host(1, IndexType(0));
+    cusp::array1d<IndexType, cusp::host_memory> chunk_offsets(1, IndexType(0));
+
+    if (num_global_rows > 0)
+    {
+        thrust::transform(exec,
+                          thrust::make_permutation_iterator(bounds.begin(), rows.begin() + bin_offsets[5]),
+                          thrust::make_permutation_iterator(bounds.begin(), rows.begin() + bin_offsets[6]),
+                          table_offsets.begin(),
+                          spgemm_table_size<IndexType>());
+        thrust::exclusive_scan(exec, table_offsets.begin(), table_offsets.end(), table_offsets.begin(), IndexType(0));
+
+        table_offsets_host.resize(num_global_rows + 1);
+        thrust::copy(table_offsets.begin(), table_offsets.end(), table_offsets_host.begin());
+
+        size_t capacity;
+
+        {
+            size_t free, total;
+            cudaMemGetInfo(&free, &total);
+
+            capacity = cusp::system::detail::generic::spgemm_table_capacity<IndexType,ValueType>(free);
+        }
+
+        size_t begin = 0;
+
+        while (begin < num_global_rows)
+        {
+            // largest end such that the tables of [begin, end) fit the capacity
+            const size_t end = thrust::upper_bound(table_offsets_host.begin() + begin + 1, table_offsets_host.end(),
+                                                   size_t(table_offsets_host[begin]) + capacity) - table_offsets_host.begin() - 1;
+
+            // the table of a single row exceeds the workspace
+            if (end == begin)
+                return false;
+
+            chunk_offsets.push_back(IndexType(end));
+            begin = end;
+        }
+    }
+
+    const IndexType * Ap = thrust::raw_pointer_cast(&A_row_offsets[0]);
+    const IndexType * Bp = thrust::raw_pointer_cast(&B_row_offsets[0]);
+    const IndexType * R  = thrust::raw_pointer_cast(&rows[0]);
+    const IndexType * T  = thrust::raw_pointer_cast(&table_offsets[0]);
+
+    // symbolic phase, count the nonzeros of every row
+    C_row_offsets.resize(num_rows + 1);
+    thrust::fill(exec, C_row_offsets.begin(), C_row_offsets.end(), IndexType(0));
+
+    IndexType * Cp = thrust::raw_pointer_cast(&C_row_offsets[0]);
+
+    {
+        // the global bin runs on the parent stream, the others beside it
+        spgemm_bin_streams streams(stream(thrust::detail::derived_cast(exec)));
+
+        spgemm_tiny      < 128,   16, false>(exec, streams[0], R + bin_offsets[0], bin_offsets[1] - bin_offsets[0], A, Ap, B, Bp, Cp, (IndexType *) 0, (ValueType *) 0, combine);
+        spgemm_hash_warp < 256,   64, false>(exec, streams[1], R + bin_offsets[1], bin_offsets[2] - bin_offsets[1], A, Ap, B, Bp, Cp, (IndexType *) 0, (ValueType *) 0, combine);
+        spgemm_hash_shared<  64,  256, false>(exec, streams[2], R + bin_offsets[2], bin_offsets[3] - bin_offsets[2], A, Ap, B, Bp, Cp, (IndexType *) 0, (ValueType *) 0, combine);
+        spgemm_hash_shared< 128, 1024, false>(exec, streams[3], R + bin_offsets[3], bin_offsets[4] - bin_offsets[3], A, Ap, B, Bp, Cp, (IndexType *) 0, (ValueType *) 0, combine);
+        spgemm_hash_shared< 256, 2048, false>(exec, streams[4], R + bin_offsets[4], bin_offsets[5] - bin_offsets[4], A, Ap, B, Bp, Cp, (IndexType *) 0, (ValueType *) 0, combine);
+
+        if (num_global_rows > 0)
+            spgemm_hash_global<false>(exec, R + bin_offsets[5], T, table_offsets_host, chunk_offsets, A, Ap, B, Bp, Cp, (IndexType *) 0, (ValueType *) 0, combine);
+    }
+
+    thrust::exclusive_scan(exec, C_row_offsets.begin(), C_row_offsets.end(), C_row_offsets.begin(), IndexType(0));
+
+    const IndexType num_entries = C_row_offsets[num_rows];
+
+    C.resize(A.num_rows, B.num_cols, num_entries, cusp::no_init);
+
+    if (num_entries == 0)
+        return true;
+
+    // numeric phase, accumulate and write the rows
+    IndexType * Cj = thrust::raw_pointer_cast(&C.column_indices[0]);
+    ValueType * Cx = thrust::raw_pointer_cast(&C.values[0]);
+
+    {
+        spgemm_bin_streams streams(stream(thrust::detail::derived_cast(exec)));
+
+        spgemm_tiny      < 128,   16, true>(exec, streams[0], R + bin_offsets[0], bin_offsets[1] - bin_offsets[0], A, Ap, B, Bp, Cp, Cj, Cx, combine);
+        spgemm_hash_warp < 256,   64, true>(exec, streams[1], R + bin_offsets[1], bin_offsets[2] - bin_offsets[1], A, Ap, B, Bp, Cp, Cj, Cx, combine);
+        spgemm_hash_shared<  64,  256, true>(exec, streams[2], R + bin_offsets[2], bin_offsets[3] - bin_offsets[2], A, Ap, B, Bp, Cp, Cj, Cx, combine);
+        spgemm_hash_shared< 128, 1024, true>(exec, streams[3], R + bin_offsets[3], bin_offsets[4] - bin_offsets[3], A, Ap, B, Bp, Cp, Cj, Cx, combine);
+        spgemm_hash_shared< 256, 2048, true>(exec, streams[4], R + bin_offsets[4], bin_offsets[5] - bin_offsets[4], A, Ap, B, Bp, Cp, Cj, Cx, combine);
+
+        if (num_global_rows > 0)
+            spgemm_hash_global<true>(exec, R + bin_offsets[5], T, table_offsets_host, chunk_offsets, A, Ap, B, Bp, Cp, Cj, Cx, combine);
+    }
+
+    if (num_global_rows > 0)
+    {
+        // the rows of the global bin are unordered
+        cusp::detail::temporary_array<IndexType, DerivedPolicy> C_row_indices(exec, num_entries);
+        cusp::offsets_to_indices(exec, C_row_offsets, C_row_indices);
+        cusp::sort_by_row_and_column(exec, C_row_indices, C.column_indices, C.values);
+    }
+
+    return true;
+}
+
+template <typename DerivedPolicy,
+          typename MatrixType1,
+          typename ArrayType1,
+          typename MatrixType2,
+          typename ArrayType2,
+          typename MatrixType3,
+          typename ArrayType3,
+          typename BinaryFunction>
+bool hash_spgemm(cuda::execution_policy<DerivedPolicy>& exec,
+                 const MatrixType1& A,
+                 const ArrayType1& A_row_offsets,
+                 const MatrixType2& B,
+                 const ArrayType2& B_row_offsets,
+                 MatrixType3& C,
+                 ArrayType3& C_row_offsets,
+                 BinaryFunction combine,
+                 thrust::detail::true_type)
+{
+    return hash_spgemm(exec, A, A_row_offsets, B, B_row_offsets, C, C_row_offsets, combine);
+}
+
+template <typename DerivedPolicy,
+          typename MatrixType1,
+          typename ArrayType1,
+          typename MatrixType2,
+          typename ArrayType2,
+          typename MatrixType3,
+          typename ArrayType3,
+          typename BinaryFunction>
+bool hash_spgemm(cuda::execution_policy<DerivedPolicy>& exec,
+                 const MatrixType1& A,
+                 const ArrayType1& A_row_offsets,
+                 const MatrixType2& B,
+                 const ArrayType2& B_row_offsets,
+                 MatrixType3& C,
+                 ArrayType3& C_row_offsets,
+                 BinaryFunction combine,
+                 thrust::detail::false_type)
+{
+    return false;
+}
+
+} // end namespace detail
+} // end namespace cuda
+} // end namespace system
+} // end namespace cusp
@@ -0,0 +1,200 @@
+/*
+ *  Copyright 2008-2014 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#pragma once
+
+#include <cusp/hyb_matrix.h>
+#include <cusp/system/cuda/arch.h>
+#include <cusp/system/cuda/utils.h>
+#include <cusp/system/cuda/detail/multiply/coo_lookback_spmv.h>
+
+#include <thrust/device_ptr.h>
+
+#include <cassert>
+#include <algorithm>
+
+namespace cusp
+{
+namespace system
+{
+namespace cuda
+{
+namespace detail
+{
+
+//////////////////////////////////////////////////////////////////////////////
+// HYB SpMV kernel fusing the ELL and COO parts
+//////////////////////////////////////////////////////////////////////////////
+//
+// spmv_hyb_kernel
+//   Each thread processes one row at a time with a grid-stride loop over a
+//   persistent grid.  The ELL part of the row is accumulated in a register,
+//   then the entries of the row in the COO tail are located with a binary
+//   search over the (sorted) COO row indices and added to the same sum.
+//   Consequently y is read and written exactly once per SpMV instead of
+//   once by the ELL kernel and again by the COO kernel.  The COO tail of a
+//   HYB matrix is small by construction so the search is served from cache.
+//   When the tail nevertheless holds more entries than there are rows the
+//   kernel only processes the ELL part and the tail is added by the
+//   single-pass COO kernel of coo_lookback_spmv.h.
+
+template <typename IndexType>
+__device__ __forceinline__
+IndexType hyb_coo_lower_bound(const IndexType * Ci, const IndexType num_entries, const IndexType row)
+{
+    IndexType first = 0;
+    IndexType last  = num_entries;
+
+    while(first < last)
+    {
+        const IndexType middle = (first + last) >> 1;
+
+        if(Ci[middle] < row)
+            first = middle + 1;
+        else
+            last = middle;
+    }
+
+    return first;
+}
+
+template <typename IndexType,
+          typename ValueType1,
+          typename ValueType2,
+          typename ValueType3,
+          typename UnaryFunction,
+          typename BinaryFunction1,
+          typename BinaryFunction2,
+          size_t BLOCK_SIZE>
+__launch_bounds__(BLOCK_SIZE,1)
+__global__ void
+spmv_hyb_kernel(const IndexType num_rows,
+                const IndexType num_cols_per_row,
+                const IndexType pitch,
+                const IndexType * Aj,
+                const ValueType1 * Ax,
+                const IndexType num_coo_entries,
+                const IndexType * Ci,
+                const IndexType * Cj,
+                const ValueType1 * Cx,
+                const ValueType2 * x,
+                ValueType3 * y,
+                UnaryFunction initialize,
+                BinaryFunction1 combine,
+                BinaryFunction2 reduce)
+{
+    // products are accumulated in the value type of y
+    typedef ValueType3 ValueType;
+
+    const IndexType invalid_index = cusp::ell_matrix<IndexType, ValueType1, cusp::device_memory>::invalid_index;
+
+    const IndexType thread_id = blockDim.x * blockIdx.x + threadIdx.x;
+    const IndexType grid_size = gridDim.x * blockDim.x;
+
+    for(IndexType row = thread_id; row < num_rows; row += grid_size)
+    {
+        ValueType sum = initialize(y[row]);
+
+        IndexType offset = row;
+
+        for(IndexType n = 0; n < num_cols_per_row; n++)
+        {
+            const IndexType col = Aj[offset];
+
+            if (col != invalid_index)
+            {
+                const ValueType1 A_ij = Ax[offset];
+                sum = reduce(sum, combine(A_ij, x[col]));
+            }
+
+            offset += pitch;
+        }
+
+        if(num_coo_entries > 0)
+        {
+            for(IndexType jj = hyb_coo_lower_bound(Ci, num_coo_entries, row); jj < num_coo_entries && Ci[jj] == row; jj++)
+                sum = reduce(sum, combine(Cx[jj], x[Cj[jj]]));
+        }
+
+        y[row] = sum;
+    }
+}
+
+
+template <typename DerivedPolicy,
+          typename MatrixType,
+          typename VectorType1,
+          typename VectorType2,
+          typename UnaryFunction,
+          typename BinaryFunction1,
+          typename BinaryFunction2>
+void multiply(cuda::execution_policy<DerivedPolicy>& exec,
+              MatrixType& A,
+              VectorType1& x,
+              VectorType2& y,
+              UnaryFunction   initialize,
+              BinaryFunction1 combine,
+              BinaryFunction2 reduce,
+              cusp::hyb_format,
+              cusp::array1d_format,
+              cusp::array1d_format)
+{
+    typedef typename MatrixType::index_type  IndexType;
+    typedef typename MatrixType::value_type  ValueType1;
+    typedef typename VectorType1::value_type ValueType2;
+    typedef typename VectorType2::value_type ValueType3;
+
+    if(A.num_rows == 0)
+        return;
+
+    const size_t BLOCK_SIZE = 256;
+    const size_t NUM_BLOCKS = cusp::system::cuda::detail::launch_blocks(
+                                  spmv_hyb_kernel<IndexType,ValueType1,ValueType2,ValueType3,UnaryFunction,BinaryFunction1,BinaryFunction2,BLOCK_SIZE>, BLOCK_SIZE, (size_t) 0,
+                                  A.num_rows, BLOCK_SIZE);
+
+    const IndexType pitch               = A.ell.column_indices.pitch;
+    const IndexType num_entries_per_row = A.ell.column_indices.num_cols;
+
+    // a long tail is reduced in one pass instead of searched for every row
+    const bool      separate_coo        = A.coo.num_entries > A.num_rows;
+    const IndexType num_coo_entries     = separate_coo ? 0 : A.coo.num_entries;
+
+    // TODO generalize this
+    assert(A.ell.column_indices.pitch == A.ell.values.pitch);
+
+    const IndexType * J = num_entries_per_row > 0 ? thrust::raw_pointer_cast(&A.ell.column_indices.values[0]) : 0;
+    const ValueType1 * V = num_entries_per_row > 0 ? thrust::raw_pointer_cast(&A.ell.values.values[0])         : 0;
+
+    const IndexType * CI = num_coo_entries > 0 ? thrust::raw_pointer_cast(&A.coo.row_indices[0])    : 0;
+    const IndexType * CJ = num_coo_entries > 0 ? thrust::raw_pointer_cast(&A.coo.column_indices[0]) : 0;
+    const ValueType1 * CV = num_coo_entries > 0 ? thrust::raw_pointer_cast(&A.coo.values[0])         : 0;
+
+    const ValueType2 * x_ptr = thrust::raw_pointer_cast(&x[0]);
+    ValueType3 * y_ptr = thrust::raw_pointer_cast(&y[0]);
+
+    cudaStream_t s = stream(thrust::detail::derived_cast(exec));
+
+    spmv_hyb_kernel<IndexType,ValueType1,ValueType2,ValueType3,UnaryFunction,BinaryFunction1,BinaryFunction2,BLOCK_SIZE> <<<NUM_BLOCKS, BLOCK_SIZE, 0, s>>>
+    (A.num_rows, num_entries_per_row, pitch, J, V, num_coo_entries, CI, CJ, CV, x_ptr, y_ptr, initialize, combine, reduce);
+
+    if(separate_coo)
+        __spmv_coo_lookback(exec, A.coo, x, y, combine, reduce);
+}
+
+} // end namespace detail
+} // end namespace cuda
+} // end namespace system
+} // end namespace cusp
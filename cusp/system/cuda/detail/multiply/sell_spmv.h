@@ -0,0 +1,140 @@
+/*
+ *  Copyright 2008-2014 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#pragma once
+
+#include <cusp/sell_matrix.h>
+#include <cusp/system/cuda/arch.h>
+#include <cusp/system/cuda/utils.h>
+
+#include <thrust/device_ptr.h>
+
+#include <algorithm>
+
+namespace cusp
+{
+namespace system
+{
+namespace cuda
+{
+namespace detail
+{
+
+// One thread is assigned to each stored row.  Entries of a slice are
+// interleaved by lane, so when slice_size is a multiple of the warp size
+// the loads of a warp are coalesced and threads in a warp only iterate
+// over the width of their own slice.
+template <typename IndexType,
+          typename ValueType,
+          typename UnaryFunction,
+          typename BinaryFunction1,
+          typename BinaryFunction2,
+          size_t BLOCK_SIZE>
+__launch_bounds__(BLOCK_SIZE,1)
+__global__ void
+spmv_sell_kernel(const IndexType num_rows,
+                 const IndexType slice_size,
+                 const IndexType * Ao,
+                 const IndexType * Aj,
+                 const ValueType * Ax,
+                 const IndexType * Ap,
+                 const ValueType * x,
+                 ValueType * y,
+                 UnaryFunction initialize,
+                 BinaryFunction1 combine,
+                 BinaryFunction2 reduce)
+{
+    const IndexType invalid_index = cusp::sell_matrix<IndexType, ValueType, cusp::device_memory>::invalid_index;
+
+    const IndexType thread_id = blockDim.x * blockIdx.x + threadIdx.x;
+    const IndexType grid_size = gridDim.x * blockDim.x;
+
+    for(IndexType position = thread_id; position < num_rows; position += grid_size)
+    {
+        const IndexType slice       = position / slice_size;
+        const IndexType slice_start = Ao[slice];
+        const IndexType slice_end   = Ao[slice + 1];
+
+        const IndexType row = Ap[position];
+
+        ValueType sum = initialize(y[row]);
+
+        for(IndexType offset = slice_start + position % slice_size; offset < slice_end; offset += slice_size)
+        {
+            const IndexType col = Aj[offset];
+
+            if (col != invalid_index)
+            {
+                const ValueType A_ij = Ax[offset];
+                sum = reduce(sum, combine(A_ij, x[col]));
+            }
+        }
+
+        y[row] = sum;
+    }
+}
+
+
+template <typename DerivedPolicy,
+          typename MatrixType,
+          typename VectorType1,
+          typename VectorType2,
+          typename UnaryFunction,
+          typename BinaryFunction1,
+          typename BinaryFunction2>
+void multiply(cuda::execution_policy<DerivedPolicy>& exec,
+              MatrixType& A,
+              VectorType1& x,
+              VectorType2& y,
+              UnaryFunction   initialize,
+              BinaryFunction1 combine,
+              BinaryFunction2 reduce,
+              cusp::sell_format,
+              cusp::array1d_format,
+              cusp::array1d_format)
+{
+    typedef typename MatrixType::index_type IndexType;
+    typedef typename MatrixType::value_type ValueType;
+
+    if(A.num_entries == 0)
+    {
+        thrust::transform(exec, y.begin(), y.end(), y.begin(), initialize);
+        return;
+    }
+
+    const size_t BLOCK_SIZE = 256;
+    const size_t NUM_BLOCKS = cusp::system::cuda::detail::launch_blocks(
+                                  spmv_sell_kernel<IndexType,ValueType,UnaryFunction,BinaryFunction1,BinaryFunction2,BLOCK_SIZE>, BLOCK_SIZE, (size_t) 0,
+                                  A.num_rows, BLOCK_SIZE);
+
+    const IndexType * O = thrust::raw_pointer_cast(&A.slice_offsets[0]);
+    const IndexType * J = thrust::raw_pointer_cast(&A.column_indices[0]);
+    const ValueType * V = thrust::raw_pointer_cast(&A.values[0]);
+    const IndexType * P = thrust::raw_pointer_cast(&A.row_permutation[0]);
+
+    const ValueType * x_ptr = thrust::raw_pointer_cast(&x[0]);
+    ValueType * y_ptr = thrust::raw_pointer_cast(&y[0]);
+
+    cudaStream_t s = stream(thrust::detail::derived_cast(exec));
+
+    spmv_sell_kernel<IndexType,ValueType,UnaryFunction,BinaryFunction1,BinaryFunction2,BLOCK_SIZE> <<<NUM_BLOCKS, BLOCK_SIZE, 0, s>>>
+    (A.num_rows, A.slice_size, O, J, V, P, x_ptr, y_ptr, initialize, combine, reduce);
+}
+
+} // end namespace detail
+} // end namespace cuda
+} // end namespace system
+} // end namespace cusp
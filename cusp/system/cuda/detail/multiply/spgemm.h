@@ -15,22 +15,31 @@
  */
 
 #include <cusp/array1d.h>
+#include <cusp/convert.h>
 #include <cusp/coo_matrix.h>
+#include <cusp/exception.h>
 #include <cusp/format_utils.h>
 #include <cusp/sort.h>
 
 #include <cusp/detail/temporary_array.h>
+#include <cusp/detail/type_traits.h>
+
+#include <cusp/system/cuda/detail/multiply/hash_spgemm.h>
+#include <cusp/system/detail/generic/multiply/spgemm_workspace.h>
 
 #include <thrust/binary_search.h>
+#include <thrust/count.h>
 #include <thrust/fill.h>
 #include <thrust/gather.h>
 #include <thrust/reduce.h>
 #include <thrust/scan.h>
 #include <thrust/scatter.h>
+#include <thrust/remove.h>
 #include <thrust/transform.h>
 #include <thrust/inner_product.h>
 #include <thrust/iterator/zip_iterator.h>
 #include <thrust/iterator/permutation_iterator.h>
+#include <thrust/functional.h>
 
 #include <list>
 
@@ -138,7 +147,7 @@ void coo_spmm_helper(cuda::execution_policy<DerivedPolicy>& exec,
                                           thrust::not_equal_to< thrust::tuple<IndexType,IndexType> >()) + 1;
 
     // allocate space for output
-    C.resize(A.num_rows, B.num_cols, NNZ);
+    C.resize(A.num_rows, B.num_cols, NNZ, cusp::no_init);
 
     // sum values with the same (i,j)
     thrust::reduce_by_key
@@ -159,28 +168,18 @@ template <typename DerivedPolicy,
           typename UnaryFunction,
           typename BinaryFunction1,
           typename BinaryFunction2>
-void multiply(cuda::execution_policy<DerivedPolicy>& exec,
-              const MatrixType1& A,
-              const MatrixType2& B,
-              MatrixType3& C,
-              UnaryFunction   initialize,
-              BinaryFunction1 combine,
-              BinaryFunction2 reduce,
-              cusp::coo_format,
-              cusp::coo_format,
-              cusp::coo_format)
+void esc_spgemm(cuda::execution_policy<DerivedPolicy>& exec,
+                const MatrixType1& A,
+                const MatrixType2& B,
+                MatrixType3& C,
+                UnaryFunction   initialize,
+                BinaryFunction1 combine,
+                BinaryFunction2 reduce)
 {
     typedef typename MatrixType3::index_type   IndexType;
     typedef typename MatrixType3::value_type   ValueType;
     typedef typename MatrixType3::memory_space MemorySpace;
 
-    // check whether matrices are empty
-    if (A.num_entries == 0 || B.num_entries == 0)
-    {
-        C.resize(A.num_rows, B.num_cols, 0);
-        return;
-    }
-
     // compute row offsets for B
 #if THRUST_VERSION >= 100800
     cusp::detail::temporary_array<IndexType, DerivedPolicy> B_row_offsets(exec, B.num_rows + 1);
@@ -226,17 +225,13 @@ void multiply(cuda::execution_policy<DerivedPolicy>& exec,
 
     size_t coo_num_nonzeros = output_ptr[A.num_entries];
 
-    size_t workspace_capacity = thrust::min<size_t>(coo_num_nonzeros, 16 << 20);
+    size_t workspace_capacity;
 
     {
         size_t free, total;
         cudaMemGetInfo(&free, &total);
 
-        // divide free bytes by the size of each workspace unit
-        size_t max_workspace_capacity = free / (4 * sizeof(IndexType) + sizeof(ValueType));
-
-        // use at most one third of the remaining capacity
-        workspace_capacity = thrust::min<size_t>(max_workspace_capacity / 3, workspace_capacity);
+        workspace_capacity = cusp::system::detail::generic::spgemm_workspace_capacity<IndexType,ValueType>(coo_num_nonzeros, free);
     }
 
     // workspace arrays
@@ -314,23 +309,19 @@ void multiply(cuda::execution_policy<DerivedPolicy>& exec,
             // find largest end_row such that the capacity of [begin_row, end_row) fits in the workspace_capacity
             size_t end_row = thrust::upper_bound(exec,
                                                  cummulative_row_workspace.begin() + begin_row, cummulative_row_workspace.end(),
-                                                 IndexType(total_work + workspace_capacity)) - cummulative_row_workspace.begin();
+                                                 IndexType(thrust::min<size_t>(total_work + workspace_capacity, coo_num_nonzeros))) - cummulative_row_workspace.begin();
+
+            // the products of a single row exceed the workspace
+            if (end_row == begin_row)
+                throw cusp::runtime_exception("SpGEMM workspace is too small for a single row of the product");
 
             size_t begin_segment = A_row_offsets[begin_row];
             size_t end_segment   = A_row_offsets[end_row];
 
-            // TODO throw exception signaling that there is insufficient memory (not necessarily bad_alloc)
-            //if (begin_row == end_row)
-            //    // workspace wasn't large enough, throw cusp::memory_allocation_failure?
-
             size_t workspace_size = output_ptr[end_segment] - output_ptr[begin_segment];
 
             total_work += workspace_size;
 
-            // TODO remove these when an exception is in place
-            assert(end_row > begin_row);
-            assert(workspace_size <= workspace_capacity);
-
             coo_spmm_helper(exec,
                             workspace_size,
                             begin_row, end_row,
@@ -366,7 +357,7 @@ void multiply(cuda::execution_policy<DerivedPolicy>& exec,
             C_num_entries += iter->num_entries;
 
         // resize output
-        C.resize(A.num_rows, B.num_cols, C_num_entries);
+        C.resize(A.num_rows, B.num_cols, C_num_entries, cusp::no_init);
 
         // copy slices into output
         size_t base = 0;
@@ -380,6 +371,131 @@ void multiply(cuda::execution_policy<DerivedPolicy>& exec,
     }
 }
 
+template <typename DerivedPolicy,
+          typename MatrixType1,
+          typename MatrixType2,
+          typename MatrixType3,
+          typename UnaryFunction,
+          typename BinaryFunction1,
+          typename BinaryFunction2>
+void multiply(cuda::execution_policy<DerivedPolicy>& exec,
+              const MatrixType1& A,
+              const MatrixType2& B,
+              MatrixType3& C,
+              UnaryFunction   initialize,
+              BinaryFunction1 combine,
+              BinaryFunction2 reduce,
+              cusp::coo_format,
+              cusp::coo_format,
+              cusp::coo_format)
+{
+    typedef typename MatrixType3::index_type IndexType;
+    typedef hash_spgemm_supported<MatrixType1,MatrixType2,MatrixType3,BinaryFunction2> HashSupported;
+
+    // check whether matrices are empty
+    if (A.num_entries == 0 || B.num_entries == 0)
+    {
+        C.resize(A.num_rows, B.num_cols, 0);
+        return;
+    }
+
+    if (HashSupported::value)
+    {
+        cusp::detail::temporary_array<IndexType, DerivedPolicy> A_row_offsets(exec, A.num_rows + 1);
+        cusp::detail::temporary_array<IndexType, DerivedPolicy> B_row_offsets(exec, B.num_rows + 1);
+        cusp::detail::temporary_array<IndexType, DerivedPolicy> C_row_offsets(exec, A.num_rows + 1);
+
+        cusp::indices_to_offsets(exec, A.row_indices, A_row_offsets);
+        cusp::indices_to_offsets(exec, B.row_indices, B_row_offsets);
+
+        if (hash_spgemm(exec, A, A_row_offsets, B, B_row_offsets, C, C_row_offsets, combine, HashSupported()))
+        {
+            cusp::offsets_to_indices(exec, C_row_offsets, C.row_indices);
+            return;
+        }
+    }
+
+    // expand, sort and compress the intermediate products
+    esc_spgemm(exec, A, B, C, initialize, combine, reduce);
+}
+
+template <typename DerivedPolicy,
+          typename MatrixType1,
+          typename MatrixType2,
+          typename MatrixType3,
+          typename UnaryFunction,
+          typename BinaryFunction1,
+          typename BinaryFunction2>
+void multiply(cuda::execution_policy<DerivedPolicy>& exec,
+              const MatrixType1& A,
+              const MatrixType2& B,
+              MatrixType3& C,
+              UnaryFunction   initialize,
+              BinaryFunction1 combine,
+              BinaryFunction2 reduce,
+              cusp::csr_format,
+              cusp::csr_format,
+              cusp::csr_format)
+{
+    typedef typename MatrixType3::index_type IndexType;
+    typedef typename MatrixType3::value_type ValueType;
+    typedef hash_spgemm_supported<MatrixType1,MatrixType2,MatrixType3,BinaryFunction2> HashSupported;
+
+    // check whether matrices are empty
+    if (A.num_entries == 0 || B.num_entries == 0)
+    {
+        C.resize(A.num_rows, B.num_cols, 0);
+        thrust::fill(exec, C.row_offsets.begin(), C.row_offsets.end(), IndexType(0));
+        return;
+    }
+
+    if (HashSupported::value)
+    {
+        cusp::detail::temporary_array<IndexType, DerivedPolicy> C_row_offsets(exec, A.num_rows + 1);
+
+        if (hash_spgemm(exec, A, A.row_offsets, B, B.row_offsets, C, C_row_offsets, combine, HashSupported()))
+        {
+            thrust::copy(exec, C_row_offsets.begin(), C_row_offsets.end(), C.row_offsets.begin());
+
+            // like the COO product, drop entries which cancelled out
+            size_t num_zeros = thrust::count(exec, C.values.begin(), C.values.end(), ValueType(0));
+
+            if (num_zeros != 0)
+            {
+                cusp::detail::temporary_array<IndexType, DerivedPolicy> C_row_indices(exec, C.num_entries);
+                cusp::offsets_to_indices(exec, C.row_offsets, C_row_indices);
+
+                size_t num_entries =
+                    thrust::remove_if(exec,
+                        thrust::make_zip_iterator(thrust::make_tuple(C_row_indices.begin(), C.column_indices.begin(), C.values.begin())),
+                        thrust::make_zip_iterator(thrust::make_tuple(C_row_indices.end(),   C.column_indices.end(),   C.values.end())),
+                        C.values.begin(),
+                        thrust::placeholders::_1 == ValueType(0)) -
+                    thrust::make_zip_iterator(thrust::make_tuple(C_row_indices.begin(), C.column_indices.begin(), C.values.begin()));
+
+                C.resize(C.num_rows, C.num_cols, num_entries);
+
+                cusp::indices_to_offsets(exec, cusp::make_array1d_view(C_row_indices.begin(), C_row_indices.begin() + num_entries), C.row_offsets);
+            }
+
+            return;
+        }
+    }
+
+    // fall back to the COO product
+    typedef typename MatrixType1::const_coo_view_type             CooMatrix1;
+    typedef typename MatrixType2::const_coo_view_type             CooMatrix2;
+    typedef typename cusp::detail::as_coo_type<MatrixType3>::type CooMatrix3;
+
+    CooMatrix1 A_(A);
+    CooMatrix2 B_(B);
+    CooMatrix3 C_;
+
+    esc_spgemm(exec, A_, B_, C_, initialize, combine, reduce);
+
+    cusp::convert(exec, C_, C);
+}
+
 } // end namespace detail
 } // end namespace cuda
 } // end namespace system
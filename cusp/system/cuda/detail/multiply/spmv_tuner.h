@@ -0,0 +1,158 @@
+/*
+ *  Copyright 2008-2014 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#pragma once
+
+#include <cusp/system/cuda/tuning.h>
+
+#include <thrust/detail/raw_pointer_cast.h>
+
+namespace cusp
+{
+namespace system
+{
+namespace cuda
+{
+namespace detail
+{
+
+//////////////////////////////////////////////////////////////////////////////
+// Runtime selection of SpMV kernel configurations
+//////////////////////////////////////////////////////////////////////////////
+//
+// spmv_tuning_trial
+//   Selects the kernel configuration for one SpMV call.  While the operator
+//   has untested candidates the next candidate is selected and the launch
+//   is timed with a pair of events on the execution stream.  finish()
+//   waits for the stop event and records the measurement.  Afterwards the
+//   fastest candidate is returned without any synchronization.
+
+enum spmv_tuning_format
+{
+    spmv_tuning_csr = 0,
+    spmv_tuning_ell = 1,
+    spmv_tuning_dia = 2
+};
+
+class spmv_tuning_trial
+{
+private:
+
+    spmv_tuning_record& record;
+    const int num_candidates;
+    cudaStream_t stream;
+    bool timed;
+    int selection;
+    cudaEvent_t start, stop;
+
+public:
+
+    spmv_tuning_trial(const spmv_tuning_key& key, int num_candidates, cudaStream_t stream)
+        : record(find_record(key)),
+          num_candidates(num_candidates),
+          stream(stream)
+    {
+        {
+#if __cplusplus >= 201103L
+            std::lock_guard<std::mutex> lock(get_spmv_tuning_state().mutex);
+#endif
+
+            timed     = record.num_trials < num_candidates;
+            selection = timed ? record.num_trials : record.best_candidate;
+        }
+
+        if(timed)
+        {
+            cudaEventCreate(&start);
+            cudaEventCreate(&stop);
+            cudaEventRecord(start, stream);
+        }
+    }
+
+    ~spmv_tuning_trial(void)
+    {
+        if(timed)
+        {
+            cudaEventDestroy(start);
+            cudaEventDestroy(stop);
+        }
+    }
+
+    int candidate(void) const
+    {
+        return selection;
+    }
+
+    void finish(void)
+    {
+        if(!timed)
+            return;
+
+        float elapsed = 0;
+
+        cudaEventRecord(stop, stream);
+        cudaEventSynchronize(stop);
+        cudaEventElapsedTime(&elapsed, start, stop);
+
+#if __cplusplus >= 201103L
+        std::lock_guard<std::mutex> lock(get_spmv_tuning_state().mutex);
+#endif
+
+        // another thread may have measured the same candidate meanwhile
+        if(record.num_trials != selection)
+            return;
+
+        if(record.num_trials == 0 || elapsed < record.best_time)
+        {
+            record.best_candidate = record.num_trials;
+            record.best_time      = elapsed;
+        }
+
+        record.num_trials++;
+    }
+
+private:
+
+    static spmv_tuning_record& find_record(const spmv_tuning_key& key)
+    {
+#if __cplusplus >= 201103L
+        std::lock_guard<std::mutex> lock(get_spmv_tuning_state().mutex);
+#endif
+
+        // references to map elements stay valid while others are inserted
+        return get_spmv_tuning_state().records[key];
+    }
+};
+
+inline bool spmv_tuning_enabled(void)
+{
+    return get_spmv_tuning_state().enabled;
+}
+
+template <typename MatrixType, typename ArrayType>
+spmv_tuning_key make_spmv_tuning_key(spmv_tuning_format format, const MatrixType& A, const ArrayType& signature)
+{
+    typedef typename MatrixType::value_type ValueType;
+
+    const void* address = signature.size() == 0 ? 0 : thrust::raw_pointer_cast(&signature[0]);
+
+    return spmv_tuning_key(format, sizeof(ValueType), A.num_rows, A.num_cols, A.num_entries, address);
+}
+
+} // end namespace detail
+} // end namespace cuda
+} // end namespace system
+} // end namespace cusp
@@ -0,0 +1,148 @@
+/*
+ *  Copyright 2008-2014 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#pragma once
+
+#include <cusp/symmetric_matrix.h>
+
+#include <cusp/system/cuda/arch.h>
+#include <cusp/system/cuda/utils.h>
+
+#include <thrust/device_ptr.h>
+#include <thrust/transform.h>
+
+#include <algorithm>
+
+namespace cusp
+{
+namespace system
+{
+namespace cuda
+{
+namespace detail
+{
+
+//////////////////////////////////////////////////////////////////////////////
+// Symmetric SpMV kernel
+//////////////////////////////////////////////////////////////////////////////
+//
+// spmv_symmetric_scalar_kernel
+//   Each row of the upper triangle is processed by one thread.  The row sum
+//   is accumulated in a register, the transposed contributions A(i,j) * x[i]
+//   are added to y[j] with atomic addition.  Since other threads add to y[i]
+//   concurrently the row sum is committed atomically as well, y must be
+//   initialized before the kernel is launched.
+
+template <typename IndexType, typename ValueType1, typename ValueType2, typename ValueType3,
+          typename BinaryFunction, unsigned int BLOCK_SIZE>
+__launch_bounds__(BLOCK_SIZE,1)
+__global__ void
+spmv_symmetric_scalar_kernel(const IndexType num_rows,
+                             const IndexType * Ap,
+                             const IndexType * Aj,
+                             const ValueType1 * Ax,
+                             const ValueType2 * x,
+                             ValueType3 * y,
+                             BinaryFunction combine)
+{
+    // products are accumulated in the value type of y
+    typedef ValueType3 ValueType;
+
+    const IndexType thread_id = BLOCK_SIZE * blockIdx.x + threadIdx.x;
+    const IndexType grid_size = BLOCK_SIZE * gridDim.x;
+
+    for(IndexType row = thread_id; row < num_rows; row += grid_size)
+    {
+        const IndexType row_start = Ap[row];
+        const IndexType row_end   = Ap[row + 1];
+
+        const ValueType2 xi = x[row];
+
+        ValueType sum = ValueType(0);
+
+        for(IndexType jj = row_start; jj < row_end; jj++)
+        {
+            const IndexType  j   = Aj[jj];
+            const ValueType1 Aij = Ax[jj];
+
+            sum += ValueType(combine(Aij, x[j]));
+
+            if(j != row)
+                atomic_add(y + j, ValueType(combine(Aij, xi)));
+        }
+
+        if(row_end > row_start)
+            atomic_add(y + row, sum);
+    }
+}
+
+template <typename DerivedPolicy,
+          typename MatrixType,
+          typename VectorType1,
+          typename VectorType2,
+          typename UnaryFunction,
+          typename BinaryFunction1,
+          typename BinaryFunction2>
+void multiply(cuda::execution_policy<DerivedPolicy>& exec,
+              const MatrixType& A,
+              const VectorType1& x,
+              VectorType2& y,
+              UnaryFunction   initialize,
+              BinaryFunction1 combine,
+              BinaryFunction2 reduce,
+              cusp::symmetric_format,
+              cusp::array1d_format,
+              cusp::array1d_format)
+{
+    typedef typename MatrixType::index_type  IndexType;
+    typedef typename MatrixType::value_type  ValueType1;
+    typedef typename VectorType1::value_type ValueType2;
+    typedef typename VectorType2::value_type ValueType3;
+
+    if (A.num_rows == 0)
+        return;
+
+    // the atomic updates perform the reduction, which is therefore always addition
+    thrust::transform(exec, y.begin(), y.begin() + A.num_rows, y.begin(), initialize);
+
+    if (A.upper.num_entries == 0)
+        return;
+
+    const size_t BLOCK_SIZE = 256;
+
+    const size_t NUM_BLOCKS = cusp::system::cuda::detail::launch_blocks(
+                                  spmv_symmetric_scalar_kernel<IndexType, ValueType1, ValueType2, ValueType3,
+                                  BinaryFunction1, BLOCK_SIZE>, BLOCK_SIZE, (size_t) 0,
+                                  A.num_rows, BLOCK_SIZE);
+
+    const IndexType  * Ap = thrust::raw_pointer_cast(&A.upper.row_offsets[0]);
+    const IndexType  * Aj = thrust::raw_pointer_cast(&A.upper.column_indices[0]);
+    const ValueType1 * Ax = thrust::raw_pointer_cast(&A.upper.values[0]);
+
+    const ValueType2 * x_ptr = thrust::raw_pointer_cast(&x[0]);
+    ValueType3 * y_ptr = thrust::raw_pointer_cast(&y[0]);
+
+    cudaStream_t s = stream(thrust::detail::derived_cast(exec));
+
+    spmv_symmetric_scalar_kernel<IndexType, ValueType1, ValueType2, ValueType3,
+                                 BinaryFunction1, BLOCK_SIZE> <<<NUM_BLOCKS, BLOCK_SIZE, 0, s>>>
+                                 (A.num_rows, Ap, Aj, Ax, x_ptr, y_ptr, combine);
+}
+
+} // end namespace detail
+} // end namespace cuda
+} // end namespace system
+} // end namespace cusp
@@ -0,0 +1,224 @@
+/*
+ *  Copyright 2008-2014 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#pragma once
+
+#include <cusp/detail/format.h>
+
+#include <cusp/system/cuda/arch.h>
+#include <cusp/system/cuda/utils.h>
+
+#include <thrust/device_ptr.h>
+#include <thrust/fill.h>
+
+#include <algorithm>
+
+namespace cusp
+{
+namespace system
+{
+namespace cuda
+{
+namespace detail
+{
+
+//////////////////////////////////////////////////////////////////////////////
+// Transposed SpMV kernels
+//////////////////////////////////////////////////////////////////////////////
+//
+// spmv_coo_transpose_kernel
+//   Each thread scatters the product of one entry into y with atomic
+//   addition.
+//
+// spmv_csr_transpose_vector_kernel
+//   Each row is processed by a vector of THREADS_PER_VECTOR threads which
+//   read the row coalesced and scatter A(i,j) * x[i] into y[j] with atomic
+//   addition.  x[i] is loaded once per row.
+
+template <typename IndexType, typename ValueType1, typename ValueType2, typename ValueType3,
+          unsigned int BLOCK_SIZE>
+__launch_bounds__(BLOCK_SIZE,1)
+__global__ void
+spmv_coo_transpose_kernel(const IndexType num_entries,
+                          const IndexType * Ai,
+                          const IndexType * Aj,
+                          const ValueType1 * Ax,
+                          const ValueType2 * x,
+                          ValueType3 * y)
+{
+    const IndexType thread_id = BLOCK_SIZE * blockIdx.x + threadIdx.x;
+    const IndexType grid_size = BLOCK_SIZE * gridDim.x;
+
+    for(IndexType n = thread_id; n < num_entries; n += grid_size)
+        atomic_add(y + Aj[n], ValueType3(Ax[n]) * ValueType3(x[Ai[n]]));
+}
+
+template <typename IndexType, typename ValueType1, typename ValueType2, typename ValueType3,
+          unsigned int VECTORS_PER_BLOCK, unsigned int THREADS_PER_VECTOR>
+__launch_bounds__(VECTORS_PER_BLOCK * THREADS_PER_VECTOR,1)
+__global__ void
+spmv_csr_transpose_vector_kernel(const IndexType num_rows,
+                                 const IndexType * Ap,
+                                 const IndexType * Aj,
+                                 const ValueType1 * Ax,
+                                 const ValueType2 * x,
+                                 ValueType3 * y)
+{
+    const IndexType THREADS_PER_BLOCK = VECTORS_PER_BLOCK * THREADS_PER_VECTOR;
+
+    const IndexType thread_id   = THREADS_PER_BLOCK * blockIdx.x + threadIdx.x;    // global thread index
+    const IndexType thread_lane = threadIdx.x & (THREADS_PER_VECTOR - 1);          // thread index within the vector
+    const IndexType vector_id   = thread_id   /  THREADS_PER_VECTOR;               // global vector index
+    const IndexType num_vectors = VECTORS_PER_BLOCK * gridDim.x;                   // total number of active vectors
+
+    for(IndexType row = vector_id; row < num_rows; row += num_vectors)
+    {
+        const IndexType row_start = Ap[row];
+        const IndexType row_end   = Ap[row + 1];
+
+        const ValueType3 xi = x[row];
+
+        for(IndexType jj = row_start + thread_lane; jj < row_end; jj += THREADS_PER_VECTOR)
+            atomic_add(y + Aj[jj], ValueType3(Ax[jj]) * xi);
+    }
+}
+
+template <unsigned int THREADS_PER_VECTOR,
+          typename DerivedPolicy,
+          typename MatrixType,
+          typename VectorType1,
+          typename VectorType2>
+void __spmv_csr_transpose_vector(cuda::execution_policy<DerivedPolicy>& exec,
+                                 const MatrixType& A,
+                                 const VectorType1& x,
+                                 VectorType2& y)
+{
+    typedef typename MatrixType::index_type  IndexType;
+    typedef typename MatrixType::value_type  ValueType1;
+    typedef typename VectorType1::value_type ValueType2;
+    typedef typename VectorType2::value_type ValueType3;
+
+    const size_t THREADS_PER_BLOCK = 128;
+    const size_t VECTORS_PER_BLOCK = THREADS_PER_BLOCK / THREADS_PER_VECTOR;
+
+    const size_t NUM_BLOCKS = cusp::system::cuda::detail::launch_blocks(
+                                  spmv_csr_transpose_vector_kernel<IndexType, ValueType1, ValueType2, ValueType3,
+                                  VECTORS_PER_BLOCK, THREADS_PER_VECTOR>, THREADS_PER_BLOCK, (size_t) 0,
+                                  A.num_rows, VECTORS_PER_BLOCK);
+
+    const IndexType  * Ap = thrust::raw_pointer_cast(&A.row_offsets[0]);
+    const IndexType  * Aj = thrust::raw_pointer_cast(&A.column_indices[0]);
+    const ValueType1 * Ax = thrust::raw_pointer_cast(&A.values[0]);
+
+    const ValueType2 * x_ptr = thrust::raw_pointer_cast(&x[0]);
+    ValueType3 * y_ptr = thrust::raw_pointer_cast(&y[0]);
+
+    cudaStream_t s = stream(thrust::detail::derived_cast(exec));
+
+    spmv_csr_transpose_vector_kernel<IndexType, ValueType1, ValueType2, ValueType3,
+                                     VECTORS_PER_BLOCK, THREADS_PER_VECTOR> <<<NUM_BLOCKS, THREADS_PER_BLOCK, 0, s>>>
+                                     (A.num_rows, Ap, Aj, Ax, x_ptr, y_ptr);
+}
+
+template <typename DerivedPolicy,
+          typename MatrixType,
+          typename VectorType1,
+          typename VectorType2>
+void multiply_transpose(cuda::execution_policy<DerivedPolicy>& exec,
+                        const MatrixType& A,
+                        const VectorType1& x,
+                        VectorType2& y,
+                        cusp::coo_format,
+                        cusp::array1d_format,
+                        cusp::array1d_format)
+{
+    typedef typename MatrixType::index_type  IndexType;
+    typedef typename MatrixType::value_type  ValueType1;
+    typedef typename VectorType1::value_type ValueType2;
+    typedef typename VectorType2::value_type ValueType3;
+
+    thrust::fill(exec, y.begin(), y.begin() + A.num_cols, ValueType3(0));
+
+    if (A.num_entries == 0)
+        return;
+
+    const size_t BLOCK_SIZE = 256;
+
+    const size_t NUM_BLOCKS = cusp::system::cuda::detail::launch_blocks(
+                                  spmv_coo_transpose_kernel<IndexType, ValueType1, ValueType2, ValueType3,
+                                  BLOCK_SIZE>, BLOCK_SIZE, (size_t) 0,
+                                  A.num_entries, BLOCK_SIZE);
+
+    const IndexType  * Ai = thrust::raw_pointer_cast(&A.row_indices[0]);
+    const IndexType  * Aj = thrust::raw_pointer_cast(&A.column_indices[0]);
+    const ValueType1 * Ax = thrust::raw_pointer_cast(&A.values[0]);
+
+    const ValueType2 * x_ptr = thrust::raw_pointer_cast(&x[0]);
+    ValueType3 * y_ptr = thrust::raw_pointer_cast(&y[0]);
+
+    cudaStream_t s = stream(thrust::detail::derived_cast(exec));
+
+    spmv_coo_transpose_kernel<IndexType, ValueType1, ValueType2, ValueType3,
+                              BLOCK_SIZE> <<<NUM_BLOCKS, BLOCK_SIZE, 0, s>>>
+                              (A.num_entries, Ai, Aj, Ax, x_ptr, y_ptr);
+}
+
+template <typename DerivedPolicy,
+          typename MatrixType,
+          typename VectorType1,
+          typename VectorType2>
+void multiply_transpose(cuda::execution_policy<DerivedPolicy>& exec,
+                        const MatrixType& A,
+                        const VectorType1& x,
+                        VectorType2& y,
+                        cusp::csr_format,
+                        cusp::array1d_format,
+                        cusp::array1d_format)
+{
+    typedef typename MatrixType::index_type  IndexType;
+    typedef typename VectorType2::value_type ValueType3;
+
+    thrust::fill(exec, y.begin(), y.begin() + A.num_cols, ValueType3(0));
+
+    if (A.num_entries == 0)
+        return;
+
+    const IndexType nnz_per_row = A.num_entries / A.num_rows;
+
+    if (nnz_per_row <=  2) {
+        __spmv_csr_transpose_vector<2>(exec, A, x, y);
+        return;
+    }
+    if (nnz_per_row <=  4) {
+        __spmv_csr_transpose_vector<4>(exec, A, x, y);
+        return;
+    }
+    if (nnz_per_row <=  8) {
+        __spmv_csr_transpose_vector<8>(exec, A, x, y);
+        return;
+    }
+    if (nnz_per_row <= 16) {
+        __spmv_csr_transpose_vector<16>(exec, A, x, y);
+        return;
+    }
+
+    __spmv_csr_transpose_vector<32>(exec, A, x, y);
+}
+
+} // end namespace detail
+} // end namespace cuda
+} // end namespace system
+} // end namespace cusp
@@ -0,0 +1,292 @@
+/*
+ *  Copyright 2008-2014 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include <cusp/array1d.h>
+#include <cusp/exception.h>
+#include <cusp/functional.h>
+
+#include <cusp/system/cuda/detail/par.h>
+#include <cusp/system/cuda/detail/multiply/csr_vector_spmv.h>
+
+#include <thrust/functional.h>
+
+#include <algorithm>
+#include <string>
+
+namespace cusp
+{
+namespace system
+{
+namespace cuda
+{
+namespace out_of_core
+{
+namespace detail
+{
+
+inline void check_error(const cudaError_t error, const char* operation)
+{
+    if (error != cudaSuccess)
+        throw cusp::runtime_exception(std::string("out_of_core: ") + operation +
+                                      " failed: " + cudaGetErrorString(error));
+}
+
+// the vector width of the CSR kernel follows the mean row length of a block
+template <typename DerivedPolicy, typename MatrixType, typename ArrayType1, typename ArrayType2>
+void multiply_block(cusp::system::cuda::execution_policy<DerivedPolicy>& exec,
+                    const MatrixType& A, const ArrayType1& x, ArrayType2& y)
+{
+    typedef typename MatrixType::value_type ValueType;
+
+    using cusp::system::cuda::detail::__spmv_csr_vector;
+
+    cusp::constant_functor<ValueType> initialize(0);
+    thrust::multiplies<ValueType> combine;
+    thrust::plus<ValueType> reduce;
+
+    const size_t nnz_per_row = A.num_entries / A.num_rows;
+
+    if (nnz_per_row <= 2)
+        __spmv_csr_vector<2,128>(exec, A, x, y, initialize, combine, reduce);
+    else if (nnz_per_row <= 4)
+        __spmv_csr_vector<4,128>(exec, A, x, y, initialize, combine, reduce);
+    else if (nnz_per_row <= 8)
+        __spmv_csr_vector<8,128>(exec, A, x, y, initialize, combine, reduce);
+    else if (nnz_per_row <= 16)
+        __spmv_csr_vector<16,128>(exec, A, x, y, initialize, combine, reduce);
+    else
+        __spmv_csr_vector<32,128>(exec, A, x, y, initialize, combine, reduce);
+}
+
+} // end namespace detail
+
+template <typename IndexType, typename ValueType>
+template <typename MatrixType>
+csr_matrix<IndexType,ValueType>
+::csr_matrix(const MatrixType& A, const size_t block_entries, const size_t num_buffers)
+    : Parent(A.num_rows, A.num_cols, A.num_entries), matrix(A), ready(0)
+{
+    if (block_entries == 0)
+        throw cusp::invalid_input_exception("out_of_core::csr_matrix: blocks must hold at least one entry");
+    if (num_buffers == 0)
+        throw cusp::invalid_input_exception("out_of_core::csr_matrix: at least one buffer is required");
+
+    const size_t num_rows = matrix.num_rows;
+
+    // greedy blocks of consecutive rows with at most block_entries entries
+    rows.push_back(0);
+
+    size_t max_rows    = 0;
+    size_t max_entries = 0;
+
+    while (rows.back() < num_rows)
+    {
+        const size_t first = rows.back();
+        const IndexType limit = IndexType(matrix.row_offsets[first] + block_entries);
+
+        size_t last = std::upper_bound(matrix.row_offsets.begin() + first + 1,
+                                       matrix.row_offsets.begin() + num_rows + 1,
+                                       limit) - matrix.row_offsets.begin() - 1;
+
+        // a row longer than a block is a block by itself
+        if (last == first)
+            last = first + 1;
+
+        rows.push_back(last);
+
+        max_rows    = std::max(max_rows, last - first);
+        max_entries = std::max(max_entries, size_t(matrix.row_offsets[last] - matrix.row_offsets[first]));
+    }
+
+    const size_t blocks = rows.size() - 1;
+
+    local_offsets.resize(num_rows + blocks);
+
+    for (size_t b = 0; b < blocks; b++)
+    {
+        const IndexType base = matrix.row_offsets[rows[b]];
+
+        for (size_t i = rows[b]; i <= rows[b + 1]; i++)
+            local_offsets[i + b] = matrix.row_offsets[i] - base;
+    }
+
+    try
+    {
+        detail::check_error(cudaEventCreateWithFlags(&ready, cudaEventDisableTiming), "cudaEventCreate");
+
+        for (size_t n = 0; n < std::min(num_buffers, std::max<size_t>(blocks, 1)); n++)
+        {
+            buffer* b = new buffer;
+            buffers.push_back(b);
+
+            detail::check_error(cudaStreamCreate(&b->stream), "cudaStreamCreate");
+            detail::check_error(cudaEventCreateWithFlags(&b->done, cudaEventDisableTiming), "cudaEventCreate");
+
+            b->row_offsets.resize(max_rows + 1);
+            b->column_indices.resize(max_entries);
+            b->values.resize(max_entries);
+        }
+    }
+    catch (...)
+    {
+        release();
+        throw;
+    }
+}
+
+template <typename IndexType, typename ValueType>
+csr_matrix<IndexType,ValueType>
+::~csr_matrix(void)
+{
+    release();
+}
+
+template <typename IndexType, typename ValueType>
+void
+csr_matrix<IndexType,ValueType>
+::release(void)
+{
+    for (size_t n = 0; n < buffers.size(); n++)
+    {
+        if (buffers[n]->stream)
+        {
+            cudaStreamSynchronize(buffers[n]->stream);
+            cudaStreamDestroy(buffers[n]->stream);
+        }
+
+        if (buffers[n]->done)
+            cudaEventDestroy(buffers[n]->done);
+
+        delete buffers[n];
+    }
+
+    buffers.clear();
+
+    if (ready)
+        cudaEventDestroy(ready);
+
+    ready = 0;
+}
+
+template <typename IndexType, typename ValueType>
+size_t
+csr_matrix<IndexType,ValueType>
+::num_blocks(void) const
+{
+    return rows.size() - 1;
+}
+
+template <typename IndexType, typename ValueType>
+size_t
+csr_matrix<IndexType,ValueType>
+::num_buffers(void) const
+{
+    return buffers.size();
+}
+
+template <typename IndexType, typename ValueType>
+const std::vector<size_t>&
+csr_matrix<IndexType,ValueType>
+::block_rows(void) const
+{
+    return rows;
+}
+
+template <typename IndexType, typename ValueType>
+template <typename ArrayType1, typename ArrayType2>
+void
+csr_matrix<IndexType,ValueType>
+::operator()(const ArrayType1& x, ArrayType2& y) const
+{
+    typedef cusp::system::cuda::detail::execute_on_stream Policy;
+
+    typedef typename cusp::array1d<IndexType,cusp::device_memory>::iterator IndexIterator;
+    typedef typename cusp::array1d<ValueType,cusp::device_memory>::iterator ValueIterator;
+    typedef typename ArrayType2::iterator                                   OutputIterator;
+
+    if (x.size() != matrix.num_cols || y.size() != matrix.num_rows)
+        throw cusp::invalid_input_exception("out_of_core::csr_matrix: vector sizes do not match the matrix");
+
+    const size_t blocks = num_blocks();
+
+    if (blocks == 0)
+        return;
+
+    // x is produced by the work issued to the default stream
+    detail::check_error(cudaEventRecord(ready, 0), "cudaEventRecord");
+
+    for (size_t n = 0; n < buffers.size(); n++)
+        cudaStreamWaitEvent(buffers[n]->stream, ready, 0);
+
+    // block b uses buffer b % num_buffers, the stream of the buffer orders
+    // its reuse after the product of the block it held before
+    for (size_t b = 0; b < blocks; b++)
+    {
+        const buffer& buf = *buffers[b % buffers.size()];
+
+        const size_t    first       = rows[b];
+        const size_t    block_rows  = rows[b + 1] - first;
+        const IndexType entry_start = matrix.row_offsets[first];
+        const size_t    num_entries = matrix.row_offsets[rows[b + 1]] - entry_start;
+
+        detail::check_error(cudaMemcpyAsync(thrust::raw_pointer_cast(&buf.row_offsets[0]),
+                                            thrust::raw_pointer_cast(&local_offsets[first + b]),
+                                            (block_rows + 1) * sizeof(IndexType),
+                                            cudaMemcpyHostToDevice, buf.stream),
+                            "cudaMemcpyAsync");
+
+        if (num_entries > 0)
+        {
+            detail::check_error(cudaMemcpyAsync(thrust::raw_pointer_cast(&buf.column_indices[0]),
+                                                thrust::raw_pointer_cast(&matrix.column_indices[entry_start]),
+                                                num_entries * sizeof(IndexType),
+                                                cudaMemcpyHostToDevice, buf.stream),
+                                "cudaMemcpyAsync");
+
+            detail::check_error(cudaMemcpyAsync(thrust::raw_pointer_cast(&buf.values[0]),
+                                                thrust::raw_pointer_cast(&matrix.values[entry_start]),
+                                                num_entries * sizeof(ValueType),
+                                                cudaMemcpyHostToDevice, buf.stream),
+                                "cudaMemcpyAsync");
+        }
+
+        cusp::csr_matrix_view<cusp::array1d_view<IndexIterator>,
+                              cusp::array1d_view<IndexIterator>,
+                              cusp::array1d_view<ValueIterator> >
+            A_block(block_rows, matrix.num_cols, num_entries,
+                    cusp::make_array1d_view(buf.row_offsets.begin(), buf.row_offsets.begin() + block_rows + 1),
+                    cusp::make_array1d_view(buf.column_indices.begin(), buf.column_indices.begin() + num_entries),
+                    cusp::make_array1d_view(buf.values.begin(), buf.values.begin() + num_entries));
+
+        cusp::array1d_view<OutputIterator> y_block(y.begin() + first, y.begin() + first + block_rows);
+
+        Policy exec(buf.stream);
+
+        detail::multiply_block(exec, A_block, x, y_block);
+    }
+
+    // later work on the default stream reads y
+    for (size_t n = 0; n < buffers.size(); n++)
+    {
+        detail::check_error(cudaEventRecord(buffers[n]->done, buffers[n]->stream), "cudaEventRecord");
+        cudaStreamWaitEvent(0, buffers[n]->done, 0);
+    }
+}
+
+} // end namespace out_of_core
+} // end namespace cuda
+} // end namespace system
+} // end namespace cusp
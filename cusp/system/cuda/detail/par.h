@@ -18,7 +18,10 @@
 
 #include <cusp/detail/config.h>
 #include <cusp/system/cuda/detail/execution_policy.h>
+#include <cusp/system/detail/compensated/execution_policy.h>
+#include <cusp/system/detail/profiling/execution_policy.h>
 #include <cusp/system/cuda/detail/cublas/execute_with_cublas.h>
+#include <cusp/system/cuda/detail/cusparse/execute_with_cusparse.h>
 
 #include <thrust/detail/execute_with_allocator.h>
 
@@ -31,6 +34,47 @@ namespace cuda
 namespace detail
 {
 
+// execution policy which carries a CUDA stream, every kernel launch,
+// temporary allocation and library call made by cusp on behalf of this
+// policy is issued on that stream
+class execute_on_stream
+  : public cusp::system::cuda::detail::execution_policy<execute_on_stream>
+{
+  public:
+
+  __host__ __device__
+  execute_on_stream(const cudaStream_t &s) : m_stream(s) {}
+
+  __host__ __device__
+  inline cublas::execute_with_cublas with(const cublasHandle_t &handle) const
+  {
+    return cublas::execute_with_cublas(handle).on(m_stream);
+  }
+
+  __host__ __device__
+  inline cusparse::execute_with_cusparse with(const cusparseHandle_t &handle) const
+  {
+    return cusparse::execute_with_cusparse(handle).on(m_stream);
+  }
+
+  private:
+
+  __host__ __device__
+  friend inline cudaStream_t stream(const execute_on_stream &exec)
+  {
+    return exec.m_stream;
+  }
+
+  // newer thrust backends query the stream under this name
+  __host__ __device__
+  friend inline cudaStream_t get_stream(const execute_on_stream &exec)
+  {
+    return exec.m_stream;
+  }
+
+  cudaStream_t m_stream;
+};
+
 struct par_t : public cusp::system::cuda::detail::execution_policy<par_t>
 {
   public:
@@ -43,11 +87,38 @@ struct par_t : public cusp::system::cuda::detail::execution_policy<par_t>
     return thrust::detail::execute_with_allocator<Allocator, cusp::system::cuda::detail::execution_policy>(alloc);
   }
 
+  // policy whose dot, dotc and nrm2 use compensated double accumulation
+  inline cusp::system::detail::compensated::execute_compensated<cusp::system::cuda::detail::execution_policy>
+    compensated() const
+  {
+    return cusp::system::detail::compensated::execute_compensated<cusp::system::cuda::detail::execution_policy>();
+  }
+
+  // policy recording the calls of cusp functions and their timings in log
+  inline cusp::system::detail::profiling::execute_profiling<cusp::system::cuda::detail::execution_policy>
+    profiling(cusp::profiling_log& log) const
+  {
+    return cusp::system::detail::profiling::execute_profiling<cusp::system::cuda::detail::execution_policy>(log);
+  }
+
   __host__ __device__
   inline cublas::execute_with_cublas with(const cublasHandle_t &handle) const
   {
     return cublas::execute_with_cublas(handle);
   }
+
+  // policy whose CSR products are computed by cusparse with handle
+  __host__ __device__
+  inline cusparse::execute_with_cusparse with(const cusparseHandle_t &handle) const
+  {
+    return cusparse::execute_with_cusparse(handle);
+  }
+
+  __host__ __device__
+  inline execute_on_stream on(const cudaStream_t &s) const
+  {
+    return execute_on_stream(s);
+  }
 };
 
 // overloads of select_system
@@ -0,0 +1,163 @@
+/*
+ *  Copyright 2008-2014 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#pragma once
+
+#include <cusp/detail/config.h>
+
+#include <cuda_runtime_api.h>
+
+namespace cusp
+{
+namespace system
+{
+namespace cuda
+{
+namespace detail
+{
+
+//////////////////////////////////////////////////////////////////////////////
+// Persistent kernels
+//////////////////////////////////////////////////////////////////////////////
+//
+// For small matrices the launch latency exceeds the time an SpMV spends on
+// the device, so algorithms that apply several SpMV and vector updates in
+// a row launch a single cooperative kernel instead. Every block stays
+// resident for the whole computation and the steps are separated by a grid
+// wide barrier. The cooperative launch guarantees that all blocks are
+// resident, hence the barrier cannot deadlock.
+
+// matrices with more rows are better served by one launch per step
+const size_t PERSISTENT_MAX_ROWS = 50000;
+
+// The barrier state is two words, an arrival count and a generation, which
+// must be zero when first used. The last block to arrive resets the count
+// and advances the generation, so the state is valid for the next barrier
+// and the next launch without being cleared again.
+__device__ inline void grid_barrier(unsigned int * state)
+{
+    volatile unsigned int * generation = state + 1;
+
+    __syncthreads();
+
+    if(threadIdx.x == 0)
+    {
+        const unsigned int current = *generation;
+
+        // publish the writes of this block before arriving
+        __threadfence();
+
+        if(atomicAdd(state, 1u) == gridDim.x - 1)
+        {
+            state[0] = 0;
+            __threadfence();
+            atomicAdd(state + 1, 1u);
+        }
+        else
+        {
+            while(*generation == current);
+        }
+
+        __threadfence();
+    }
+
+    __syncthreads();
+}
+
+// number of blocks of kernel that are resident on the current device at
+// once, 0 if the device does not support cooperative launches
+template <typename KernelFunction>
+size_t persistent_max_blocks(KernelFunction kernel, const size_t block_size)
+{
+#if CUDART_VERSION >= 9000
+    int device = 0;
+    int cooperative = 0;
+    int num_sms = 0;
+    int blocks_per_sm = 0;
+
+    if(cudaGetDevice(&device) != cudaSuccess ||
+       cudaDeviceGetAttribute(&cooperative, cudaDevAttrCooperativeLaunch, device) != cudaSuccess ||
+       cudaDeviceGetAttribute(&num_sms, cudaDevAttrMultiProcessorCount, device) != cudaSuccess ||
+       cudaOccupancyMaxActiveBlocksPerMultiprocessor(&blocks_per_sm, kernel, block_size, 0) != cudaSuccess)
+    {
+        cudaGetLastError();
+        return 0;
+    }
+
+    return cooperative ? size_t(blocks_per_sm) * size_t(num_sms) : 0;
+#else
+    return 0;
+#endif
+}
+
+// launches kernel(params) cooperatively, returns false without launching
+// anything if the configuration cannot be made resident
+template <typename KernelFunction, typename Parameters>
+bool persistent_launch(KernelFunction kernel,
+                       const size_t num_blocks,
+                       const size_t block_size,
+                       Parameters& params,
+                       cudaStream_t s)
+{
+#if CUDART_VERSION >= 9000
+    void * args[] = { &params };
+
+    if(cudaLaunchCooperativeKernel((const void *) kernel, dim3(num_blocks), dim3(block_size), args, 0, s) != cudaSuccess)
+    {
+        cudaGetLastError();
+        return false;
+    }
+
+    return true;
+#else
+    return false;
+#endif
+}
+
+// (A v)[row] for the CSR matrix (Ap,Aj,Ax) computed by the THREADS_PER_VECTOR
+// threads of a vector, the sum is valid in the first thread of the vector
+template <unsigned int THREADS_PER_VECTOR, typename IndexType, typename ValueType>
+__device__ ValueType
+persistent_csr_row_sum(const IndexType row_start,
+                       const IndexType row_end,
+                       const IndexType * Aj,
+                       const ValueType * Ax,
+                       const ValueType * v,
+                       const IndexType thread_lane,
+                       volatile ValueType * sdata)
+{
+    ValueType sum = ValueType(0);
+
+    for(IndexType jj = row_start + thread_lane; jj < row_end; jj += THREADS_PER_VECTOR)
+        sum += Ax[jj] * v[Aj[jj]];
+
+    sdata[threadIdx.x] = sum;
+
+    ValueType temp;
+
+    if (THREADS_PER_VECTOR > 16) { temp = sdata[threadIdx.x + 16]; sdata[threadIdx.x] = sum = sum + temp; }
+    if (THREADS_PER_VECTOR >  8) { temp = sdata[threadIdx.x +  8]; sdata[threadIdx.x] = sum = sum + temp; }
+    if (THREADS_PER_VECTOR >  4) { temp = sdata[threadIdx.x +  4]; sdata[threadIdx.x] = sum = sum + temp; }
+    if (THREADS_PER_VECTOR >  2) { temp = sdata[threadIdx.x +  2]; sdata[threadIdx.x] = sum = sum + temp; }
+    if (THREADS_PER_VECTOR >  1) { temp = sdata[threadIdx.x +  1]; sdata[threadIdx.x] = sum = sum + temp; }
+
+    return sum;
+}
+
+} // end namespace detail
+} // end namespace cuda
+} // end namespace system
+} // end namespace cusp
@@ -145,8 +145,7 @@ void gauss_seidel_spmv(cuda::execution_policy<DerivedPolicy>& exec,
     const size_t THREADS_PER_BLOCK  = 128;
     const size_t VECTORS_PER_BLOCK  = THREADS_PER_BLOCK / THREADS_PER_VECTOR;
 
-    const size_t MAX_BLOCKS = cusp::system::cuda::detail::max_active_blocks(gauss_seidel_kernel<IndexType, ValueType, VECTORS_PER_BLOCK, THREADS_PER_VECTOR>, THREADS_PER_BLOCK, (size_t) 0);
-    const size_t NUM_BLOCKS = std::min<size_t>(MAX_BLOCKS, DIVIDE_INTO(num_rows, VECTORS_PER_BLOCK));
+    const size_t NUM_BLOCKS = cusp::system::cuda::detail::launch_blocks(gauss_seidel_kernel<IndexType, ValueType, VECTORS_PER_BLOCK, THREADS_PER_VECTOR>, THREADS_PER_BLOCK, (size_t) 0, num_rows, VECTORS_PER_BLOCK);
 
     const IndexType * R = thrust::raw_pointer_cast(&A.row_offsets[0]);
     const IndexType * J = thrust::raw_pointer_cast(&A.column_indices[0]);
@@ -155,7 +154,9 @@ void gauss_seidel_spmv(cuda::execution_policy<DerivedPolicy>& exec,
     const ValueType * b_ptr = thrust::raw_pointer_cast(&b[0]);
     const IndexType * i_ptr = thrust::raw_pointer_cast(&indices[row_start]);
 
-    gauss_seidel_kernel<IndexType, ValueType, VECTORS_PER_BLOCK, THREADS_PER_VECTOR> <<<NUM_BLOCKS, THREADS_PER_BLOCK>>>
+    cudaStream_t s = stream(thrust::detail::derived_cast(exec));
+
+    gauss_seidel_kernel<IndexType, ValueType, VECTORS_PER_BLOCK, THREADS_PER_VECTOR> <<<NUM_BLOCKS, THREADS_PER_BLOCK, 0, s>>>
     (num_rows, R, J, V, x_ptr, b_ptr, i_ptr);
 }
 
@@ -196,6 +197,170 @@ void gauss_seidel_indexed(cuda::execution_policy<DerivedPolicy>& exec,
     gauss_seidel_spmv<32>(exec, A, x, b, indices, row_start, row_stop, row_step);
 }
 
+// Relaxes a contiguous range of rows of a color contiguous matrix C whose
+// row r holds the off-diagonal entries of row ordering[r].  Consecutive
+// vectors read consecutive rows of C, so the loads of the matrix coalesce
+// and neither the diagonal search nor the indirection through the ordering
+// is needed to locate a row.  The SOR weight omega is applied in the same
+// pass, omega = 1 is a Gauss-Seidel update.
+template <typename IndexType, typename ValueType, unsigned int VECTORS_PER_BLOCK, unsigned int THREADS_PER_VECTOR>
+__launch_bounds__(VECTORS_PER_BLOCK * THREADS_PER_VECTOR,1)
+__global__ void
+gauss_seidel_multicolor_kernel(const IndexType row_start,
+                               const IndexType row_stop,
+                               const IndexType * Cp,
+                               const IndexType * Cj,
+                               const ValueType * Cx,
+                               const ValueType * diagonal,
+                               const IndexType * ordering,
+                               ValueType * x,
+                               const ValueType * b,
+                               const ValueType omega)
+{
+    __shared__ volatile ValueType sdata[VECTORS_PER_BLOCK * THREADS_PER_VECTOR + THREADS_PER_VECTOR / 2];  // padded to avoid reduction conditionals
+    __shared__ volatile IndexType ptrs[VECTORS_PER_BLOCK][2];
+
+    const IndexType THREADS_PER_BLOCK = VECTORS_PER_BLOCK * THREADS_PER_VECTOR;
+
+    const IndexType thread_id   = THREADS_PER_BLOCK * blockIdx.x + threadIdx.x;    // global thread index
+    const IndexType thread_lane = threadIdx.x & (THREADS_PER_VECTOR - 1);          // thread index within the vector
+    const IndexType vector_id   = thread_id   /  THREADS_PER_VECTOR;               // global vector index
+    const IndexType vector_lane = threadIdx.x /  THREADS_PER_VECTOR;               // vector index within the block
+    const IndexType num_vectors = VECTORS_PER_BLOCK * gridDim.x;                   // total number of active vectors
+
+    for(IndexType r = row_start + vector_id; r < row_stop; r += num_vectors)
+    {
+        if(thread_lane < 2)
+            ptrs[vector_lane][thread_lane] = Cp[r + thread_lane];
+
+        const IndexType jj_start = ptrs[vector_lane][0];
+        const IndexType jj_end   = ptrs[vector_lane][1];
+
+        // initialize local sum
+        ValueType sum = 0;
+
+        if (THREADS_PER_VECTOR == 32 && jj_end - jj_start > 32)
+        {
+            // ensure aligned memory access to Cj and Cx
+            IndexType jj = jj_start - (jj_start & (THREADS_PER_VECTOR - 1)) + thread_lane;
+
+            if(jj >= jj_start && jj < jj_end)
+                sum += Cx[jj] * x[Cj[jj]];
+
+            for(jj += THREADS_PER_VECTOR; jj < jj_end; jj += THREADS_PER_VECTOR)
+                sum += Cx[jj] * x[Cj[jj]];
+        }
+        else
+        {
+            for(IndexType jj = jj_start + thread_lane; jj < jj_end; jj += THREADS_PER_VECTOR)
+                sum += Cx[jj] * x[Cj[jj]];
+        }
+
+        // store local sum in shared memory
+        sdata[threadIdx.x] = sum;
+
+        // reduce local sums to row sum
+        if (THREADS_PER_VECTOR > 16) sdata[threadIdx.x] = sum = sum + sdata[threadIdx.x + 16];
+        if (THREADS_PER_VECTOR >  8) sdata[threadIdx.x] = sum = sum + sdata[threadIdx.x +  8];
+        if (THREADS_PER_VECTOR >  4) sdata[threadIdx.x] = sum = sum + sdata[threadIdx.x +  4];
+        if (THREADS_PER_VECTOR >  2) sdata[threadIdx.x] = sum = sum + sdata[threadIdx.x +  2];
+        if (THREADS_PER_VECTOR >  1) sdata[threadIdx.x] = sum = sum + sdata[threadIdx.x +  1];
+
+        // first thread writes the result
+        if (thread_lane == 0)
+        {
+            const ValueType diag = diagonal[r];
+
+            if (diag != ValueType(0))
+            {
+                const IndexType row = ordering[r];
+                x[row] = (ValueType(1) - omega) * x[row] + omega * (b[row] - sdata[threadIdx.x]) / diag;
+            }
+        }
+    }
+}
+
+template <unsigned int THREADS_PER_VECTOR,
+         typename DerivedPolicy,
+         typename MatrixType,
+         typename ArrayType1,
+         typename ArrayType2,
+         typename ArrayType3>
+void gauss_seidel_multicolor_spmv(cuda::execution_policy<DerivedPolicy>& exec,
+                                  const MatrixType& C,
+                                  const ArrayType1& diagonal,
+                                  const ArrayType2& ordering,
+                                        ArrayType3& x,
+                                  const ArrayType3& b,
+                                  const int row_start,
+                                  const int row_stop,
+                                  const typename ArrayType3::value_type omega)
+{
+    typedef typename MatrixType::index_type IndexType;
+    typedef typename MatrixType::value_type ValueType;
+
+    const size_t num_rows = row_stop - row_start;
+    const size_t THREADS_PER_BLOCK  = 128;
+    const size_t VECTORS_PER_BLOCK  = THREADS_PER_BLOCK / THREADS_PER_VECTOR;
+
+    const size_t NUM_BLOCKS = cusp::system::cuda::detail::launch_blocks(gauss_seidel_multicolor_kernel<IndexType, ValueType, VECTORS_PER_BLOCK, THREADS_PER_VECTOR>, THREADS_PER_BLOCK, (size_t) 0, num_rows, VECTORS_PER_BLOCK);
+
+    if (num_rows == 0)
+        return;
+
+    const IndexType * P = thrust::raw_pointer_cast(&C.row_offsets[0]);
+    const IndexType * J = C.num_entries == 0 ? 0 : thrust::raw_pointer_cast(&C.column_indices[0]);
+    const ValueType * V = C.num_entries == 0 ? 0 : thrust::raw_pointer_cast(&C.values[0]);
+    const ValueType * d_ptr = thrust::raw_pointer_cast(&diagonal[0]);
+    const IndexType * o_ptr = thrust::raw_pointer_cast(&ordering[0]);
+    ValueType * x_ptr = thrust::raw_pointer_cast(&x[0]);
+    const ValueType * b_ptr = thrust::raw_pointer_cast(&b[0]);
+
+    cudaStream_t s = stream(thrust::detail::derived_cast(exec));
+
+    gauss_seidel_multicolor_kernel<IndexType, ValueType, VECTORS_PER_BLOCK, THREADS_PER_VECTOR> <<<NUM_BLOCKS, THREADS_PER_BLOCK, 0, s>>>
+    (row_start, row_stop, P, J, V, d_ptr, o_ptr, x_ptr, b_ptr, omega);
+}
+
+template<typename DerivedPolicy,
+         typename MatrixType,
+         typename ArrayType1,
+         typename ArrayType2,
+         typename ArrayType3>
+void gauss_seidel_multicolor(cuda::execution_policy<DerivedPolicy>& exec,
+                             const MatrixType& C,
+                             const ArrayType1& diagonal,
+                             const ArrayType2& ordering,
+                                   ArrayType3& x,
+                             const ArrayType3& b,
+                             const int row_start,
+                             const int row_stop,
+                             const typename ArrayType3::value_type omega)
+{
+    typedef typename MatrixType::index_type IndexType;
+
+    const IndexType nnz_per_row = C.num_rows == 0 ? 0 : C.num_entries / C.num_rows;
+
+    if (nnz_per_row <=  2) {
+        gauss_seidel_multicolor_spmv<2>(exec, C, diagonal, ordering, x, b, row_start, row_stop, omega);
+        return;
+    }
+    if (nnz_per_row <=  4) {
+        gauss_seidel_multicolor_spmv<4>(exec, C, diagonal, ordering, x, b, row_start, row_stop, omega);
+        return;
+    }
+    if (nnz_per_row <=  8) {
+        gauss_seidel_multicolor_spmv<8>(exec, C, diagonal, ordering, x, b, row_start, row_stop, omega);
+        return;
+    }
+    if (nnz_per_row <= 16) {
+        gauss_seidel_multicolor_spmv<16>(exec, C, diagonal, ordering, x, b, row_start, row_stop, omega);
+        return;
+    }
+
+    gauss_seidel_multicolor_spmv<32>(exec, C, diagonal, ordering, x, b, row_start, row_stop, omega);
+}
+
 } // end namespace detail
 } // end namespace cuda
 } // end namespace system
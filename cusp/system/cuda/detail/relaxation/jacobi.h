@@ -0,0 +1,411 @@
+/*
+ *  Copyright 2008-2014 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#pragma once
+
+#include <cusp/detail/config.h>
+#include <cusp/detail/format.h>
+
+#include <cusp/system/detail/generic/relaxation/jacobi.h>
+
+#include <cusp/system/cuda/arch.h>
+#include <cusp/system/cuda/utils.h>
+#include <cusp/system/cuda/detail/persistent.h>
+
+#include <thrust/device_ptr.h>
+
+#include <algorithm>
+
+namespace cusp
+{
+namespace system
+{
+namespace cuda
+{
+namespace detail
+{
+
+template <typename IndexType, typename ValueType>
+struct persistent_jacobi_params
+{
+    IndexType num_rows;
+    const IndexType * Ap;
+    const IndexType * Aj;
+    const ValueType * Ax;
+    const ValueType * diagonal;
+    const ValueType * b;
+    ValueType * x;
+    ValueType * temp;
+    unsigned int * barrier;
+    ValueType omega;
+    size_t num_sweeps;
+};
+
+// performs num_sweeps Jacobi sweeps in a single launch, alternating between
+// x and temp as the source of each sweep
+template <typename IndexType, typename ValueType, unsigned int VECTORS_PER_BLOCK, unsigned int THREADS_PER_VECTOR>
+__launch_bounds__(VECTORS_PER_BLOCK * THREADS_PER_VECTOR,1)
+__global__ void
+persistent_jacobi_kernel(const persistent_jacobi_params<IndexType,ValueType> params)
+{
+    __shared__ volatile ValueType sdata[VECTORS_PER_BLOCK * THREADS_PER_VECTOR + THREADS_PER_VECTOR / 2];  // padded to avoid reduction conditionals
+
+    const IndexType THREADS_PER_BLOCK = VECTORS_PER_BLOCK * THREADS_PER_VECTOR;
+
+    const IndexType thread_id   = THREADS_PER_BLOCK * blockIdx.x + threadIdx.x;    // global thread index
+    const IndexType thread_lane = threadIdx.x & (THREADS_PER_VECTOR - 1);          // thread index within the vector
+    const IndexType vector_id   = thread_id   /  THREADS_PER_VECTOR;               // global vector index
+    const IndexType num_vectors = VECTORS_PER_BLOCK * gridDim.x;                   // total number of active vectors
+
+    ValueType * src = params.x;
+    ValueType * dst = params.temp;
+
+    for(size_t sweep = 0; sweep < params.num_sweeps; sweep++)
+    {
+        for(IndexType row = vector_id; row < params.num_rows; row += num_vectors)
+        {
+            const ValueType sum =
+                persistent_csr_row_sum<THREADS_PER_VECTOR>(params.Ap[row], params.Ap[row + 1],
+                                                           params.Aj, params.Ax, src, thread_lane, sdata);
+
+            // x <- x + omega * D^-1 * (b - A*x)
+            if (thread_lane == 0)
+                dst[row] = src[row] + params.omega * (params.b[row] - sum) / params.diagonal[row];
+        }
+
+        grid_barrier(params.barrier);
+
+        ValueType * swap = src;
+        src = dst;
+        dst = swap;
+    }
+
+    // an odd number of sweeps leaves the solution in temp
+    if (params.num_sweeps % 2 == 1)
+        for(IndexType row = thread_id; row < params.num_rows; row += THREADS_PER_BLOCK * gridDim.x)
+            params.x[row] = params.temp[row];
+}
+
+template <unsigned int THREADS_PER_VECTOR,
+          typename DerivedPolicy,
+          typename MatrixType,
+          typename ArrayType1,
+          typename ArrayType2,
+          typename ArrayType3,
+          typename ArrayType4,
+          typename ArrayType5,
+          typename ValueType>
+bool persistent_jacobi(cuda::execution_policy<DerivedPolicy>& exec,
+                       const MatrixType& A,
+                       const ArrayType1& diagonal,
+                       const ArrayType2& b,
+                             ArrayType3& x,
+                             ArrayType4& temp,
+                             ArrayType5& barrier,
+                       const ValueType omega,
+                       const size_t num_sweeps)
+{
+    typedef typename MatrixType::index_type IndexType;
+    typedef typename ArrayType3::value_type ArrayValueType;
+
+    const size_t THREADS_PER_BLOCK  = 128;
+    const size_t VECTORS_PER_BLOCK  = THREADS_PER_BLOCK / THREADS_PER_VECTOR;
+
+    const size_t MAX_BLOCKS = persistent_max_blocks(persistent_jacobi_kernel<IndexType, ArrayValueType, VECTORS_PER_BLOCK, THREADS_PER_VECTOR>, THREADS_PER_BLOCK);
+    const size_t NUM_BLOCKS = std::min<size_t>(MAX_BLOCKS, DIVIDE_INTO(A.num_rows, VECTORS_PER_BLOCK));
+
+    if (NUM_BLOCKS == 0)
+        return false;
+
+    // the barrier state resets itself, so it is only zeroed when allocated
+    if (barrier.size() < 2)
+        barrier.resize(2, 0);
+
+    temp.resize(A.num_rows);
+
+    persistent_jacobi_params<IndexType,ArrayValueType> params;
+    params.num_rows   = A.num_rows;
+    params.Ap         = thrust::raw_pointer_cast(&A.row_offsets[0]);
+    params.Aj         = A.num_entries == 0 ? 0 : thrust::raw_pointer_cast(&A.column_indices[0]);
+    params.Ax         = A.num_entries == 0 ? 0 : thrust::raw_pointer_cast(&A.values[0]);
+    params.diagonal   = thrust::raw_pointer_cast(&diagonal[0]);
+    params.b          = thrust::raw_pointer_cast(&b[0]);
+    params.x          = thrust::raw_pointer_cast(&x[0]);
+    params.temp       = thrust::raw_pointer_cast(&temp[0]);
+    params.barrier    = thrust::raw_pointer_cast(&barrier[0]);
+    params.omega      = omega;
+    params.num_sweeps = num_sweeps;
+
+    cudaStream_t s = stream(thrust::detail::derived_cast(exec));
+
+    return persistent_launch(persistent_jacobi_kernel<IndexType, ArrayValueType, VECTORS_PER_BLOCK, THREADS_PER_VECTOR>,
+                             NUM_BLOCKS, THREADS_PER_BLOCK, params, s);
+}
+
+template<typename DerivedPolicy,
+         typename MatrixType,
+         typename ArrayType1,
+         typename ArrayType2,
+         typename ArrayType3,
+         typename ArrayType4,
+         typename ArrayType5,
+         typename ValueType,
+         typename Format>
+bool persistent_jacobi(cuda::execution_policy<DerivedPolicy>& exec,
+                       const MatrixType& A,
+                       const ArrayType1& diagonal,
+                       const ArrayType2& b,
+                             ArrayType3& x,
+                             ArrayType4& temp,
+                             ArrayType5& barrier,
+                       const ValueType omega,
+                       const size_t num_sweeps,
+                       Format)
+{
+    return false;
+}
+
+template<typename DerivedPolicy,
+         typename MatrixType,
+         typename ArrayType1,
+         typename ArrayType2,
+         typename ArrayType3,
+         typename ArrayType4,
+         typename ArrayType5,
+         typename ValueType>
+bool persistent_jacobi(cuda::execution_policy<DerivedPolicy>& exec,
+                       const MatrixType& A,
+                       const ArrayType1& diagonal,
+                       const ArrayType2& b,
+                             ArrayType3& x,
+                             ArrayType4& temp,
+                             ArrayType5& barrier,
+                       const ValueType omega,
+                       const size_t num_sweeps,
+                       cusp::csr_format)
+{
+    typedef typename MatrixType::index_type IndexType;
+
+    if (A.num_rows == 0 || A.num_rows > PERSISTENT_MAX_ROWS)
+        return false;
+
+    const IndexType nnz_per_row = A.num_entries / A.num_rows;
+
+    if (nnz_per_row <=  2)
+        return persistent_jacobi<2>(exec, A, diagonal, b, x, temp, barrier, omega, num_sweeps);
+    if (nnz_per_row <=  4)
+        return persistent_jacobi<4>(exec, A, diagonal, b, x, temp, barrier, omega, num_sweeps);
+    if (nnz_per_row <=  8)
+        return persistent_jacobi<8>(exec, A, diagonal, b, x, temp, barrier, omega, num_sweeps);
+    if (nnz_per_row <= 16)
+        return persistent_jacobi<16>(exec, A, diagonal, b, x, temp, barrier, omega, num_sweeps);
+
+    return persistent_jacobi<32>(exec, A, diagonal, b, x, temp, barrier, omega, num_sweeps);
+}
+
+// one sweep x_out <- x_in + omega * D^-1 * (b - A*x_in) with a vector of
+// threads per row, the row sum is reduced in shared memory and never stored
+template <typename IndexType, typename ValueType, unsigned int VECTORS_PER_BLOCK, unsigned int THREADS_PER_VECTOR>
+__launch_bounds__(VECTORS_PER_BLOCK * THREADS_PER_VECTOR,1)
+__global__ void
+fused_jacobi_kernel(const IndexType num_rows,
+                    const IndexType * Ap,
+                    const IndexType * Aj,
+                    const ValueType * Ax,
+                    const ValueType * diagonal,
+                    const ValueType * b,
+                    const ValueType * x_in,
+                    ValueType * x_out,
+                    const ValueType omega)
+{
+    __shared__ volatile ValueType sdata[VECTORS_PER_BLOCK * THREADS_PER_VECTOR + THREADS_PER_VECTOR / 2];  // padded to avoid reduction conditionals
+
+    const IndexType THREADS_PER_BLOCK = VECTORS_PER_BLOCK * THREADS_PER_VECTOR;
+
+    const IndexType thread_id   = THREADS_PER_BLOCK * blockIdx.x + threadIdx.x;    // global thread index
+    const IndexType thread_lane = threadIdx.x & (THREADS_PER_VECTOR - 1);          // thread index within the vector
+    const IndexType vector_id   = thread_id   /  THREADS_PER_VECTOR;               // global vector index
+    const IndexType num_vectors = VECTORS_PER_BLOCK * gridDim.x;                   // total number of active vectors
+
+    for(IndexType row = vector_id; row < num_rows; row += num_vectors)
+    {
+        const ValueType sum =
+            persistent_csr_row_sum<THREADS_PER_VECTOR>(Ap[row], Ap[row + 1], Aj, Ax, x_in, thread_lane, sdata);
+
+        if (thread_lane == 0)
+            x_out[row] = x_in[row] + omega * (b[row] - sum) / diagonal[row];
+    }
+}
+
+// sweep functor for generic::jacobi_ping_pong launching fused_jacobi_kernel
+template <unsigned int THREADS_PER_VECTOR, typename IndexType, typename ValueType>
+struct fused_jacobi_sweep
+{
+    IndexType num_rows;
+    const IndexType * Ap;
+    const IndexType * Aj;
+    const ValueType * Ax;
+    const ValueType * diagonal;
+    const ValueType * b;
+    ValueType omega;
+    cudaStream_t s;
+
+    bool operator()(const ValueType * x_in, ValueType * x_out) const
+    {
+        const size_t THREADS_PER_BLOCK  = 128;
+        const size_t VECTORS_PER_BLOCK  = THREADS_PER_BLOCK / THREADS_PER_VECTOR;
+
+        const size_t NUM_BLOCKS = cusp::system::cuda::detail::launch_blocks(
+                                      fused_jacobi_kernel<IndexType, ValueType, VECTORS_PER_BLOCK, THREADS_PER_VECTOR>,
+                                      THREADS_PER_BLOCK, (size_t) 0, num_rows, VECTORS_PER_BLOCK);
+
+        fused_jacobi_kernel<IndexType, ValueType, VECTORS_PER_BLOCK, THREADS_PER_VECTOR> <<<NUM_BLOCKS, THREADS_PER_BLOCK, 0, s>>>
+            (num_rows, Ap, Aj, Ax, diagonal, b, x_in, x_out, omega);
+
+        return true;
+    }
+};
+
+template <unsigned int THREADS_PER_VECTOR,
+          typename DerivedPolicy,
+          typename MatrixType,
+          typename ArrayType1,
+          typename ArrayType2,
+          typename ArrayType3,
+          typename ArrayType4,
+          typename ValueType>
+void fused_jacobi(cuda::execution_policy<DerivedPolicy>& exec,
+                  const MatrixType& A,
+                  const ArrayType1& diagonal,
+                  const ArrayType2& b,
+                        ArrayType3& x,
+                        ArrayType4& temp,
+                  const ValueType omega,
+                  const size_t num_sweeps)
+{
+    typedef typename MatrixType::index_type IndexType;
+    typedef typename ArrayType3::value_type ArrayValueType;
+
+    fused_jacobi_sweep<THREADS_PER_VECTOR, IndexType, ArrayValueType> sweep;
+    sweep.num_rows = A.num_rows;
+    sweep.Ap       = thrust::raw_pointer_cast(&A.row_offsets[0]);
+    sweep.Aj       = A.num_entries == 0 ? 0 : thrust::raw_pointer_cast(&A.column_indices[0]);
+    sweep.Ax       = A.num_entries == 0 ? 0 : thrust::raw_pointer_cast(&A.values[0]);
+    sweep.diagonal = thrust::raw_pointer_cast(&diagonal[0]);
+    sweep.b        = thrust::raw_pointer_cast(&b[0]);
+    sweep.omega    = omega;
+    sweep.s        = stream(thrust::detail::derived_cast(exec));
+
+    cusp::system::detail::generic::jacobi_ping_pong(exec, sweep, x, temp, num_sweeps);
+}
+
+template<typename DerivedPolicy,
+         typename MatrixType,
+         typename ArrayType1,
+         typename ArrayType2,
+         typename ArrayType3,
+         typename ArrayType4,
+         typename ArrayType5,
+         typename ValueType,
+         typename Format>
+bool fused_jacobi(cuda::execution_policy<DerivedPolicy>& exec,
+                  const MatrixType& A,
+                  const ArrayType1& diagonal,
+                  const ArrayType2& b,
+                        ArrayType3& x,
+                        ArrayType4& temp,
+                  const ValueType omega,
+                  const size_t num_sweeps,
+                  Format)
+{
+    return false;
+}
+
+template<typename DerivedPolicy,
+         typename MatrixType,
+         typename ArrayType1,
+         typename ArrayType2,
+         typename ArrayType3,
+         typename ArrayType4,
+         typename ValueType>
+bool fused_jacobi(cuda::execution_policy<DerivedPolicy>& exec,
+                  const MatrixType& A,
+                  const ArrayType1& diagonal,
+                  const ArrayType2& b,
+                        ArrayType3& x,
+                        ArrayType4& temp,
+                  const ValueType omega,
+                  const size_t num_sweeps,
+                  cusp::csr_format)
+{
+    typedef typename MatrixType::index_type IndexType;
+
+    if (A.num_rows == 0)
+        return true;
+
+    const IndexType nnz_per_row = A.num_entries / A.num_rows;
+
+    if (nnz_per_row <=  2)
+        fused_jacobi<2>(exec, A, diagonal, b, x, temp, omega, num_sweeps);
+    else if (nnz_per_row <=  4)
+        fused_jacobi<4>(exec, A, diagonal, b, x, temp, omega, num_sweeps);
+    else if (nnz_per_row <=  8)
+        fused_jacobi<8>(exec, A, diagonal, b, x, temp, omega, num_sweeps);
+    else if (nnz_per_row <= 16)
+        fused_jacobi<16>(exec, A, diagonal, b, x, temp, omega, num_sweeps);
+    else
+        fused_jacobi<32>(exec, A, diagonal, b, x, temp, omega, num_sweeps);
+
+    return true;
+}
+
+// small CSR matrices perform all sweeps in one persistent kernel, larger
+// ones (or a device without cooperative launch) launch one fused kernel per
+// sweep and the remaining formats use the generic fused sweeps
+template<typename DerivedPolicy,
+         typename MatrixType,
+         typename ArrayType1,
+         typename ArrayType2,
+         typename ArrayType3,
+         typename ArrayType4,
+         typename ArrayType5,
+         typename ValueType>
+void jacobi_sweeps(cuda::execution_policy<DerivedPolicy>& exec,
+                   const MatrixType& A,
+                   const ArrayType1& diagonal,
+                   const ArrayType2& b,
+                         ArrayType3& x,
+                         ArrayType4& temp,
+                         ArrayType5& barrier,
+                   const ValueType omega,
+                   const size_t num_sweeps)
+{
+    typedef typename MatrixType::format Format;
+
+    if (num_sweeps == 0)
+        return;
+
+    if (persistent_jacobi(exec, A, diagonal, b, x, temp, barrier, omega, num_sweeps, Format()))
+        return;
+
+    if (!fused_jacobi(exec, A, diagonal, b, x, temp, omega, num_sweeps, Format()))
+        cusp::system::detail::generic::jacobi_sweeps(exec, A, diagonal, b, x, temp, barrier, omega, num_sweeps);
+}
+
+} // end namespace detail
+} // end namespace cuda
+} // end namespace system
+} // end namespace cusp
@@ -0,0 +1,288 @@
+/*
+ *  Copyright 2008-2014 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#pragma once
+
+#include <cusp/detail/config.h>
+#include <cusp/detail/format.h>
+
+#include <cusp/system/detail/generic/relaxation/polynomial.h>
+
+#include <cusp/system/cuda/utils.h>
+#include <cusp/system/cuda/detail/persistent.h>
+
+#include <thrust/device_ptr.h>
+
+#include <algorithm>
+
+namespace cusp
+{
+namespace system
+{
+namespace cuda
+{
+namespace detail
+{
+
+// the coefficients are passed to the kernel by value
+const size_t PERSISTENT_MAX_COEFFICIENTS = 8;
+
+template <typename IndexType, typename ValueType>
+struct persistent_polynomial_params
+{
+    IndexType num_rows;
+    const IndexType * Ap;
+    const IndexType * Aj;
+    const ValueType * Ax;
+    const ValueType * b;
+    ValueType * x;
+    ValueType * residual;
+    ValueType * h;
+    ValueType * y;
+    unsigned int * barrier;
+    ValueType coefficients[PERSISTENT_MAX_COEFFICIENTS];
+    size_t num_coefficients;
+    bool zero_initial_guess;
+};
+
+// x <- x + p(A) (b - A*x) in a single launch, the Horner steps alternate
+// between h and y
+template <typename IndexType, typename ValueType, unsigned int VECTORS_PER_BLOCK, unsigned int THREADS_PER_VECTOR>
+__launch_bounds__(VECTORS_PER_BLOCK * THREADS_PER_VECTOR,1)
+__global__ void
+persistent_polynomial_kernel(const persistent_polynomial_params<IndexType,ValueType> params)
+{
+    __shared__ volatile ValueType sdata[VECTORS_PER_BLOCK * THREADS_PER_VECTOR + THREADS_PER_VECTOR / 2];  // padded to avoid reduction conditionals
+
+    const IndexType THREADS_PER_BLOCK = VECTORS_PER_BLOCK * THREADS_PER_VECTOR;
+
+    const IndexType thread_id   = THREADS_PER_BLOCK * blockIdx.x + threadIdx.x;    // global thread index
+    const IndexType thread_lane = threadIdx.x & (THREADS_PER_VECTOR - 1);          // thread index within the vector
+    const IndexType vector_id   = thread_id   /  THREADS_PER_VECTOR;               // global vector index
+    const IndexType num_vectors = VECTORS_PER_BLOCK * gridDim.x;                   // total number of active vectors
+
+    // the residual of the zero guess is b itself
+    const ValueType * r = params.zero_initial_guess ? params.b : params.residual;
+
+    // h <- c0 * (b - A*x)
+    for(IndexType row = vector_id; row < params.num_rows; row += num_vectors)
+    {
+        ValueType res = params.b[row];
+
+        if (!params.zero_initial_guess)
+            res -= persistent_csr_row_sum<THREADS_PER_VECTOR>(params.Ap[row], params.Ap[row + 1],
+                                                              params.Aj, params.Ax, params.x, thread_lane, sdata);
+
+        if (thread_lane == 0)
+        {
+            if (!params.zero_initial_guess)
+                params.residual[row] = res;
+
+            params.h[row] = params.coefficients[0] * res;
+        }
+    }
+
+    grid_barrier(params.barrier);
+
+    ValueType * src = params.h;
+    ValueType * dst = params.y;
+
+    // h <- A*h + ci * r
+    for(size_t i = 1; i < params.num_coefficients; i++)
+    {
+        const ValueType scale_factor = params.coefficients[i];
+
+        for(IndexType row = vector_id; row < params.num_rows; row += num_vectors)
+        {
+            const ValueType sum =
+                persistent_csr_row_sum<THREADS_PER_VECTOR>(params.Ap[row], params.Ap[row + 1],
+                                                           params.Aj, params.Ax, src, thread_lane, sdata);
+
+            if (thread_lane == 0)
+                dst[row] = sum + scale_factor * r[row];
+        }
+
+        grid_barrier(params.barrier);
+
+        ValueType * swap = src;
+        src = dst;
+        dst = swap;
+    }
+
+    // x <- x + h
+    for(IndexType row = thread_id; row < params.num_rows; row += THREADS_PER_BLOCK * gridDim.x)
+        params.x[row] = params.zero_initial_guess ? src[row] : params.x[row] + src[row];
+}
+
+template <unsigned int THREADS_PER_VECTOR,
+          typename DerivedPolicy,
+          typename MatrixType,
+          typename ArrayType1,
+          typename ArrayType2,
+          typename ArrayType3,
+          typename ArrayType4,
+          typename ArrayType5>
+bool persistent_polynomial(cuda::execution_policy<DerivedPolicy>& exec,
+                           const MatrixType& A,
+                           const ArrayType1& b,
+                                 ArrayType2& x,
+                                 ArrayType3& residual,
+                                 ArrayType3& h,
+                                 ArrayType3& y,
+                                 ArrayType4& barrier,
+                           const ArrayType5& coefficients,
+                           const bool zero_initial_guess)
+{
+    typedef typename MatrixType::index_type IndexType;
+    typedef typename ArrayType3::value_type ValueType;
+
+    const size_t THREADS_PER_BLOCK  = 128;
+    const size_t VECTORS_PER_BLOCK  = THREADS_PER_BLOCK / THREADS_PER_VECTOR;
+
+    const size_t MAX_BLOCKS = persistent_max_blocks(persistent_polynomial_kernel<IndexType, ValueType, VECTORS_PER_BLOCK, THREADS_PER_VECTOR>, THREADS_PER_BLOCK);
+    const size_t NUM_BLOCKS = std::min<size_t>(MAX_BLOCKS, DIVIDE_INTO(A.num_rows, VECTORS_PER_BLOCK));
+
+    if (NUM_BLOCKS == 0)
+        return false;
+
+    // the barrier state resets itself, so it is only zeroed when allocated
+    if (barrier.size() < 2)
+        barrier.resize(2, 0);
+
+    residual.resize(A.num_rows);
+    h.resize(A.num_rows);
+    y.resize(A.num_rows);
+
+    persistent_polynomial_params<IndexType,ValueType> params;
+    params.num_rows = A.num_rows;
+    params.Ap       = thrust::raw_pointer_cast(&A.row_offsets[0]);
+    params.Aj       = A.num_entries == 0 ? 0 : thrust::raw_pointer_cast(&A.column_indices[0]);
+    params.Ax       = A.num_entries == 0 ? 0 : thrust::raw_pointer_cast(&A.values[0]);
+    params.b        = thrust::raw_pointer_cast(&b[0]);
+    params.x        = thrust::raw_pointer_cast(&x[0]);
+    params.residual = thrust::raw_pointer_cast(&residual[0]);
+    params.h        = thrust::raw_pointer_cast(&h[0]);
+    params.y        = thrust::raw_pointer_cast(&y[0]);
+    params.barrier  = thrust::raw_pointer_cast(&barrier[0]);
+
+    for(size_t i = 0; i < coefficients.size(); i++)
+        params.coefficients[i] = coefficients[i];
+
+    params.num_coefficients   = coefficients.size();
+    params.zero_initial_guess = zero_initial_guess;
+
+    cudaStream_t s = stream(thrust::detail::derived_cast(exec));
+
+    return persistent_launch(persistent_polynomial_kernel<IndexType, ValueType, VECTORS_PER_BLOCK, THREADS_PER_VECTOR>,
+                             NUM_BLOCKS, THREADS_PER_BLOCK, params, s);
+}
+
+template<typename DerivedPolicy,
+         typename MatrixType,
+         typename ArrayType1,
+         typename ArrayType2,
+         typename ArrayType3,
+         typename ArrayType4,
+         typename ArrayType5,
+         typename Format>
+bool persistent_polynomial(cuda::execution_policy<DerivedPolicy>& exec,
+                           const MatrixType& A,
+                           const ArrayType1& b,
+                                 ArrayType2& x,
+                                 ArrayType3& residual,
+                                 ArrayType3& h,
+                                 ArrayType3& y,
+                                 ArrayType4& barrier,
+                           const ArrayType5& coefficients,
+                           const bool zero_initial_guess,
+                           Format)
+{
+    return false;
+}
+
+template<typename DerivedPolicy,
+         typename MatrixType,
+         typename ArrayType1,
+         typename ArrayType2,
+         typename ArrayType3,
+         typename ArrayType4,
+         typename ArrayType5>
+bool persistent_polynomial(cuda::execution_policy<DerivedPolicy>& exec,
+                           const MatrixType& A,
+                           const ArrayType1& b,
+                                 ArrayType2& x,
+                                 ArrayType3& residual,
+                                 ArrayType3& h,
+                                 ArrayType3& y,
+                                 ArrayType4& barrier,
+                           const ArrayType5& coefficients,
+                           const bool zero_initial_guess,
+                           cusp::csr_format)
+{
+    typedef typename MatrixType::index_type IndexType;
+
+    if (A.num_rows == 0 || A.num_rows > PERSISTENT_MAX_ROWS ||
+        coefficients.size() > PERSISTENT_MAX_COEFFICIENTS)
+        return false;
+
+    const IndexType nnz_per_row = A.num_entries / A.num_rows;
+
+    if (nnz_per_row <=  2)
+        return persistent_polynomial<2>(exec, A, b, x, residual, h, y, barrier, coefficients, zero_initial_guess);
+    if (nnz_per_row <=  4)
+        return persistent_polynomial<4>(exec, A, b, x, residual, h, y, barrier, coefficients, zero_initial_guess);
+    if (nnz_per_row <=  8)
+        return persistent_polynomial<8>(exec, A, b, x, residual, h, y, barrier, coefficients, zero_initial_guess);
+    if (nnz_per_row <= 16)
+        return persistent_polynomial<16>(exec, A, b, x, residual, h, y, barrier, coefficients, zero_initial_guess);
+
+    return persistent_polynomial<32>(exec, A, b, x, residual, h, y, barrier, coefficients, zero_initial_guess);
+}
+
+// small CSR matrices apply the whole polynomial in one persistent kernel,
+// anything else (or a device without cooperative launch) uses a launch per
+// step
+template<typename DerivedPolicy,
+         typename MatrixType,
+         typename ArrayType1,
+         typename ArrayType2,
+         typename ArrayType3,
+         typename ArrayType4,
+         typename ArrayType5>
+void polynomial_relax(cuda::execution_policy<DerivedPolicy>& exec,
+                      const MatrixType& A,
+                      const ArrayType1& b,
+                            ArrayType2& x,
+                            ArrayType3& residual,
+                            ArrayType3& h,
+                            ArrayType3& y,
+                            ArrayType4& barrier,
+                      const ArrayType5& coefficients,
+                      const bool zero_initial_guess)
+{
+    typedef typename MatrixType::format Format;
+
+    if (coefficients.size() == 0)
+        return;
+
+    if (!persistent_polynomial(exec, A, b, x, residual, h, y, barrier, coefficients, zero_initial_guess, Format()))
+        cusp::system::detail::generic::polynomial_relax(exec, A, b, x, residual, h, y, barrier, coefficients, zero_initial_guess);
+}
+
+} // end namespace detail
+} // end namespace cuda
+} // end namespace system
+} // end namespace cusp
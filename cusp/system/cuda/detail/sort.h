@@ -18,4 +18,299 @@
 
 #include <cusp/detail/config.h>
 
-// this system has no special version of this algorithm
+#include <cusp/detail/temporary_array.h>
+#include <cusp/exception.h>
+
+#include <cusp/system/detail/generic/sort.h>
+
+#include <cusp/system/cuda/arch.h>
+#include <cusp/system/cuda/utils.h>
+#include <cusp/system/cuda/detail/execution_policy.h>
+
+#include <thrust/copy.h>
+#include <thrust/extrema.h>
+#include <thrust/scan.h>
+
+#include <algorithm>
+#include <limits>
+
+namespace cusp
+{
+namespace system
+{
+namespace cuda
+{
+namespace detail
+{
+
+//////////////////////////////////////////////////////////////////////////////
+// Counting sort
+//////////////////////////////////////////////////////////////////////////////
+//
+// Stable least significant digit sort over the bits of the key range only,
+// one pass per 8-bit digit, i.e. one pass for ranges under 2^8 and two for
+// ranges under 2^16.  Every pass splits the keys into tiles, counts the
+// digits of each tile in a shared memory histogram, scans the digit-major
+// (digit, tile) counts and scatters every tile to its offsets.  Within a
+// tile the keys are scattered in chunks of BLOCK_SIZE in input order, a key
+// is ranked among the equal digits of its warp with ballots and among the
+// preceding warps with per-warp counts, so every pass is stable.
+
+const unsigned int COUNTING_SORT_RADIX_BITS = 8;
+const unsigned int COUNTING_SORT_RADIX      = 1 << COUNTING_SORT_RADIX_BITS;
+
+#if defined(__CUDACC__)
+template <typename KeyType>
+__device__ __forceinline__
+unsigned int counting_sort_digit(const KeyType key, const unsigned int shift)
+{
+    return static_cast<unsigned int>(key >> shift) & (COUNTING_SORT_RADIX - 1);
+}
+
+__device__ __forceinline__
+unsigned int counting_sort_ballot(const int predicate)
+{
+#if CUDART_VERSION >= 9000
+    return __ballot_sync(0xffffffff, predicate);
+#else
+    return __ballot(predicate);
+#endif
+}
+
+template <typename KeyType, unsigned int BLOCK_SIZE, unsigned int TILE_SIZE>
+__launch_bounds__(BLOCK_SIZE,1)
+__global__ void
+counting_sort_histogram_kernel(const unsigned int num_keys,
+                               const unsigned int num_tiles,
+                               const unsigned int shift,
+                               const KeyType * keys,
+                               unsigned int * counts)
+{
+    __shared__ unsigned int histogram[COUNTING_SORT_RADIX];
+
+    for(unsigned int d = threadIdx.x; d < COUNTING_SORT_RADIX; d += BLOCK_SIZE)
+        histogram[d] = 0;
+
+    __syncthreads();
+
+    const unsigned int tile_begin = blockIdx.x * TILE_SIZE;
+    const unsigned int tile_end   = thrust::min(tile_begin + TILE_SIZE, num_keys);
+
+    for(unsigned int i = tile_begin + threadIdx.x; i < tile_end; i += BLOCK_SIZE)
+        atomicAdd(&histogram[counting_sort_digit(keys[i], shift)], 1);
+
+    __syncthreads();
+
+    // digit-major, the scan yields the first output position of every (digit, tile)
+    for(unsigned int d = threadIdx.x; d < COUNTING_SORT_RADIX; d += BLOCK_SIZE)
+        counts[d * num_tiles + blockIdx.x] = histogram[d];
+}
+
+template <typename KeyType, typename ValueType, unsigned int BLOCK_SIZE, unsigned int TILE_SIZE>
+__launch_bounds__(BLOCK_SIZE,1)
+__global__ void
+counting_sort_scatter_kernel(const unsigned int num_keys,
+                             const unsigned int num_tiles,
+                             const unsigned int shift,
+                             const unsigned int * offsets,
+                             const KeyType * keys_in,
+                             const ValueType * vals_in,
+                             KeyType * keys_out,
+                             ValueType * vals_out)
+{
+    const unsigned int WARPS = BLOCK_SIZE / 32;
+
+    __shared__ unsigned int bin_offsets[COUNTING_SORT_RADIX];
+    __shared__ unsigned int warp_counts[WARPS][COUNTING_SORT_RADIX];
+
+    for(unsigned int d = threadIdx.x; d < COUNTING_SORT_RADIX; d += BLOCK_SIZE)
+        bin_offsets[d] = offsets[d * num_tiles + blockIdx.x];
+
+    const unsigned int warp         = threadIdx.x / 32;
+    const unsigned int lanes_before = (1u << (threadIdx.x % 32)) - 1;
+
+    const unsigned int tile_begin = blockIdx.x * TILE_SIZE;
+    const unsigned int tile_end   = thrust::min(tile_begin + TILE_SIZE, num_keys);
+
+    for(unsigned int base = tile_begin; base < tile_end; base += BLOCK_SIZE)
+    {
+        for(unsigned int d = threadIdx.x; d < COUNTING_SORT_RADIX; d += BLOCK_SIZE)
+            for(unsigned int w = 0; w < WARPS; w++)
+                warp_counts[w][d] = 0;
+
+        __syncthreads();
+
+        const unsigned int i     = base + threadIdx.x;
+        const bool         valid = i < tile_end;
+        const KeyType      key   = valid ? keys_in[i] : KeyType(0);
+        const unsigned int digit = counting_sort_digit(key, shift);
+
+        // lanes of this warp holding the same digit
+        unsigned int peers = counting_sort_ballot(valid);
+
+        for(unsigned int b = 0; b < COUNTING_SORT_RADIX_BITS; b++)
+        {
+            const unsigned int bit   = (digit >> b) & 1;
+            const unsigned int lanes = counting_sort_ballot(bit);
+            peers &= bit ? lanes : ~lanes;
+        }
+
+        const unsigned int rank = __popc(peers & lanes_before);
+
+        if(valid && rank == 0)
+            warp_counts[warp][digit] = __popc(peers);
+
+        __syncthreads();
+
+        if(valid)
+        {
+            unsigned int position = bin_offsets[digit] + rank;
+
+            for(unsigned int w = 0; w < warp; w++)
+                position += warp_counts[w][digit];
+
+            keys_out[position] = key;
+
+            if(vals_in != NULL)
+                vals_out[position] = vals_in[i];
+        }
+
+        __syncthreads();
+
+        // the next chunk of each digit follows this one
+        for(unsigned int d = threadIdx.x; d < COUNTING_SORT_RADIX; d += BLOCK_SIZE)
+            for(unsigned int w = 0; w < WARPS; w++)
+                bin_offsets[d] += warp_counts[w][d];
+    }
+}
+#endif
+
+// sorts keys[0,N) and, unless vals is NULL, vals[0,N) by keys in [0,max]
+template <typename DerivedPolicy, typename KeyType, typename ValueType>
+void counting_sort_passes(cuda::execution_policy<DerivedPolicy>& exec,
+                          KeyType * keys, ValueType * vals,
+                          const unsigned int N, const KeyType max)
+{
+    const unsigned int BLOCK_SIZE = 256;
+    const unsigned int TILE_SIZE  = 8 * BLOCK_SIZE;
+
+    const unsigned int bits = cusp::system::detail::generic::index_bits(max);
+
+    if(N < 2 || bits == 0)
+        return;
+
+    const unsigned int num_tiles = DIVIDE_INTO(N, TILE_SIZE);
+
+    cusp::detail::temporary_array<unsigned int, DerivedPolicy> counts(exec, COUNTING_SORT_RADIX * num_tiles);
+    cusp::detail::temporary_array<KeyType,      DerivedPolicy> temp_keys(exec, N);
+    cusp::detail::temporary_array<ValueType,    DerivedPolicy> temp_vals(exec, vals == NULL ? 0 : N);
+
+    KeyType   * keys_in  = keys;
+    ValueType * vals_in  = vals;
+    KeyType   * keys_out = thrust::raw_pointer_cast(&temp_keys[0]);
+    ValueType * vals_out = vals == NULL ? NULL : thrust::raw_pointer_cast(&temp_vals[0]);
+
+    unsigned int * counts_ptr = thrust::raw_pointer_cast(&counts[0]);
+
+    cudaStream_t s = stream(thrust::detail::derived_cast(exec));
+
+    for(unsigned int shift = 0; shift < bits; shift += COUNTING_SORT_RADIX_BITS)
+    {
+        counting_sort_histogram_kernel<KeyType, BLOCK_SIZE, TILE_SIZE> <<<num_tiles, BLOCK_SIZE, 0, s>>>
+        (N, num_tiles, shift, keys_in, counts_ptr);
+
+        thrust::exclusive_scan(exec, counts.begin(), counts.end(), counts.begin());
+
+        counting_sort_scatter_kernel<KeyType, ValueType, BLOCK_SIZE, TILE_SIZE> <<<num_tiles, BLOCK_SIZE, 0, s>>>
+        (N, num_tiles, shift, counts_ptr, keys_in, vals_in, keys_out, vals_out);
+
+        std::swap(keys_in, keys_out);
+        std::swap(vals_in, vals_out);
+    }
+
+    // an odd number of passes leaves the result in the temporary arrays
+    if(keys_in != keys)
+    {
+        thrust::copy(exec, keys_in, keys_in + N, keys);
+
+        if(vals != NULL)
+            thrust::copy(exec, vals_in, vals_in + N, vals);
+    }
+}
+
+template <typename DerivedPolicy, typename ArrayType>
+void counting_sort(cuda::execution_policy<DerivedPolicy>& exec,
+                   ArrayType& keys,
+                   typename ArrayType::value_type min,
+                   typename ArrayType::value_type max)
+{
+    typedef typename ArrayType::value_type IndexType;
+
+    if(min < IndexType(0))
+      throw cusp::invalid_input_exception("counting_sort min element less than 0");
+
+    if(max < min)
+      throw cusp::invalid_input_exception("counting_sort min element less than max element");
+
+    if(keys.size() < 2)
+      return;
+
+    // tile offsets are 32-bit
+    if(keys.size() > size_t(std::numeric_limits<unsigned int>::max()))
+    {
+        cusp::system::detail::generic::counting_sort(exec, keys, min, max);
+        return;
+    }
+
+    counting_sort_passes(exec, thrust::raw_pointer_cast(&keys[0]), (IndexType *) NULL, keys.size(), max);
+}
+
+template <typename DerivedPolicy, typename ArrayType1, typename ArrayType2>
+void counting_sort_by_key(cuda::execution_policy<DerivedPolicy>& exec,
+                          ArrayType1& keys, ArrayType2& vals,
+                          typename ArrayType1::value_type min,
+                          typename ArrayType1::value_type max)
+{
+    typedef typename ArrayType1::value_type IndexType1;
+
+    if(min < IndexType1(0))
+      throw cusp::invalid_input_exception("counting_sort min element less than 0");
+
+    if(max < min)
+      throw cusp::invalid_input_exception("counting_sort min element less than max element");
+
+    if(keys.size() < vals.size())
+      throw cusp::invalid_input_exception("counting_sort keys.size() less than vals.size()");
+
+    if(keys.size() < 2)
+      return;
+
+    if(keys.size() > size_t(std::numeric_limits<unsigned int>::max()))
+    {
+        cusp::system::detail::generic::counting_sort_by_key(exec, keys, vals, min, max);
+        return;
+    }
+
+    counting_sort_passes(exec, thrust::raw_pointer_cast(&keys[0]), thrust::raw_pointer_cast(&vals[0]), keys.size(), max);
+}
+
+// (row,column) pairs are packed into 32 or 64-bit keys and ordered by a single
+// radix sort instead of two stable sorts
+template <typename DerivedPolicy, typename ArrayType1, typename ArrayType2, typename ArrayType3>
+void stable_sort_by_row_and_column(cuda::execution_policy<DerivedPolicy>& exec,
+                                   ArrayType1& row_indices, ArrayType2& column_indices, ArrayType3& values,
+                                   typename ArrayType1::value_type min_row,
+                                   typename ArrayType1::value_type max_row,
+                                   typename ArrayType2::value_type min_col,
+                                   typename ArrayType2::value_type max_col)
+{
+    if(!cusp::system::detail::generic::packed_sort_by_row_and_column(exec, row_indices, column_indices, values,
+                                                                      min_row, max_row, min_col, max_col))
+        cusp::system::detail::generic::stable_sort_by_row_and_column(exec, row_indices, column_indices, values,
+                                                                      min_row, max_row, min_col, max_col);
+}
+
+} // end namespace detail
+} // end namespace cuda
+} // end namespace system
+} // end namespace cusp
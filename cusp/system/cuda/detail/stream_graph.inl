@@ -0,0 +1,121 @@
+/*
+ *  Copyright 2008-2014 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include <cusp/exception.h>
+
+namespace cusp
+{
+namespace system
+{
+namespace cuda
+{
+
+inline stream_graph::stream_graph(void)
+  : instance(0) {}
+
+inline stream_graph::~stream_graph(void)
+{
+    reset();
+}
+
+template <typename Function>
+bool stream_graph::capture(const cudaStream_t s, Function& f)
+{
+    reset();
+
+#if CUDART_VERSION >= 10000
+    if(s == 0)
+        return false;
+
+    // thread local mode rejects allocations and synchronizing calls made
+    // by this thread, so unsafe work ends the capture instead of running
+    if(cudaStreamBeginCapture(s, cudaStreamCaptureModeThreadLocal) != cudaSuccess)
+    {
+        cudaGetLastError();
+        return false;
+    }
+
+    bool recorded = true;
+
+    try
+    {
+        policy_type exec(s);
+        f(exec);
+    }
+    catch(...)
+    {
+        // the work is issued again outside of the capture by the caller,
+        // genuine errors are reported there
+        recorded = false;
+    }
+
+    cudaGraph_t graph = 0;
+    cudaError_t status = cudaStreamEndCapture(s, &graph);
+
+    if(recorded && status == cudaSuccess && graph != 0)
+    {
+#if CUDART_VERSION >= 12000
+        status = cudaGraphInstantiate(&instance, graph, 0);
+#else
+        status = cudaGraphInstantiate(&instance, graph, NULL, NULL, 0);
+#endif
+        if(status != cudaSuccess)
+            instance = 0;
+    }
+
+    if(graph != 0)
+        cudaGraphDestroy(graph);
+
+    // clear the error left behind by an invalidated capture
+    cudaGetLastError();
+
+    return instance != 0;
+#else
+    return false;
+#endif
+}
+
+inline void stream_graph::launch(const cudaStream_t s) const
+{
+#if CUDART_VERSION >= 10000
+    if(instance == 0)
+        throw cusp::runtime_exception("stream_graph::launch called on an empty graph");
+
+    if(cudaGraphLaunch(instance, s) != cudaSuccess)
+        throw cusp::runtime_exception("cudaGraphLaunch failed");
+#else
+    throw cusp::runtime_exception("stream_graph requires CUDA 10 or newer");
+#endif
+}
+
+inline bool stream_graph::empty(void) const
+{
+    return instance == 0;
+}
+
+inline void stream_graph::reset(void)
+{
+#if CUDART_VERSION >= 10000
+    if(instance != 0)
+        cudaGraphExecDestroy(instance);
+#endif
+
+    instance = 0;
+}
+
+} // end namespace cuda
+} // end namespace system
+} // end namespace cusp
@@ -0,0 +1,237 @@
+/*
+ *  Copyright 2008-2014 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#pragma once
+
+#include <cusp/complex.h>
+#include <cusp/exception.h>
+#include <cusp/linear_operator.h>
+
+#include <cusp/system/cuda/arch.h>
+#include <cusp/system/cuda/detail/execution_policy.h>
+#include <cusp/system/cuda/utils.h>
+
+#include <thrust/detail/type_traits.h>
+
+#include <algorithm>
+
+namespace cusp
+{
+namespace system
+{
+namespace cuda
+{
+namespace detail
+{
+
+//////////////////////////////////////////////////////////////////////////////
+// Vector operations with scalars kept in device memory
+//////////////////////////////////////////////////////////////////////////////
+//
+// The Krylov recurrences normally return every dot product to the host,
+// which prevents an iteration from being captured into a graph. These
+// kernels accumulate dot products into per-block partials, reduce the
+// partials and update the recurrence scalars in a single block, and read
+// the scalars from device memory when the vectors are updated, so an
+// iteration is a fixed sequence of launches on one stream.
+
+const unsigned int GRAPH_BLOCK_SIZE = 256;
+
+// an identity preconditioner is not applied, its output aliases its input
+template <typename LinearOperator>
+struct is_identity_operator : thrust::detail::false_type {};
+
+template <typename ValueType, typename MemorySpace, typename IndexType>
+struct is_identity_operator< cusp::identity_operator<ValueType,MemorySpace,IndexType> >
+  : thrust::detail::true_type {};
+
+// stream the graph solvers capture from, the policy's stream or a new
+// blocking stream when the policy runs on the default stream, which
+// cannot be captured but is ordered with blocking streams
+class graph_solver_stream
+{
+  public:
+
+    explicit graph_solver_stream(cudaStream_t s)
+      : s(s), owned(s == 0)
+    {
+        if(owned && cudaStreamCreate(&this->s) != cudaSuccess)
+            throw cusp::runtime_exception("cudaStreamCreate failed");
+    }
+
+    ~graph_solver_stream(void)
+    {
+        if(owned)
+        {
+            cudaStreamSynchronize(s);
+            cudaStreamDestroy(s);
+        }
+    }
+
+    cudaStream_t get(void) const
+    {
+        return s;
+    }
+
+  private:
+
+    graph_solver_stream(const graph_solver_stream&);
+    graph_solver_stream& operator=(const graph_solver_stream&);
+
+    cudaStream_t s;
+    bool owned;
+};
+
+// number of per-block partial sums written by graph_dotc for n entries
+inline int graph_num_partials(const size_t n)
+{
+    return static_cast<int>(std::max<size_t>(1, std::min<size_t>(GRAPH_BLOCK_SIZE, DIVIDE_INTO(n, GRAPH_BLOCK_SIZE))));
+}
+
+template <typename ValueType>
+__launch_bounds__(GRAPH_BLOCK_SIZE,1)
+__global__ void
+graph_dotc_kernel(const int n,
+                  const ValueType * x,
+                  const ValueType * y,
+                  ValueType * partials)
+{
+    __shared__ volatile ValueType sdata[GRAPH_BLOCK_SIZE];
+
+    ValueType sum = ValueType(0);
+
+    for(int i = blockIdx.x * GRAPH_BLOCK_SIZE + threadIdx.x; i < n; i += gridDim.x * GRAPH_BLOCK_SIZE)
+        sum += cusp::conj(x[i]) * y[i];
+
+    sdata[threadIdx.x] = sum;
+
+    __syncthreads();
+
+    for(unsigned int offset = GRAPH_BLOCK_SIZE / 2; offset > 0; offset /= 2)
+    {
+        if(threadIdx.x < offset)
+        {
+            ValueType temp = sdata[threadIdx.x + offset];
+            sdata[threadIdx.x] = sum = sum + temp;
+        }
+
+        __syncthreads();
+    }
+
+    if(threadIdx.x == 0)
+        partials[blockIdx.x] = sum;
+}
+
+// reduces NUM_DOTS consecutive groups of num_partials partials and calls
+// f(scalars, dots) once with the results
+template <unsigned int NUM_DOTS, typename ValueType, typename ScalarFunction>
+__launch_bounds__(GRAPH_BLOCK_SIZE,1)
+__global__ void
+graph_scalar_kernel(const int num_partials,
+                    const ValueType * partials,
+                    ValueType * scalars,
+                    ScalarFunction f)
+{
+    __shared__ volatile ValueType sdata[GRAPH_BLOCK_SIZE];
+
+    ValueType dots[NUM_DOTS > 0 ? NUM_DOTS : 1];
+
+    for(unsigned int d = 0; d < NUM_DOTS; d++)
+    {
+        ValueType sum = ValueType(0);
+
+        for(int i = threadIdx.x; i < num_partials; i += GRAPH_BLOCK_SIZE)
+            sum += partials[d * num_partials + i];
+
+        sdata[threadIdx.x] = sum;
+
+        __syncthreads();
+
+        for(unsigned int offset = GRAPH_BLOCK_SIZE / 2; offset > 0; offset /= 2)
+        {
+            if(threadIdx.x < offset)
+            {
+                ValueType temp = sdata[threadIdx.x + offset];
+                sdata[threadIdx.x] = sum = sum + temp;
+            }
+
+            __syncthreads();
+        }
+
+        dots[d] = sum;
+
+        __syncthreads();
+    }
+
+    if(threadIdx.x == 0)
+        f(scalars, dots);
+}
+
+template <typename UnaryFunction>
+__global__ void
+graph_for_each_kernel(const int n, UnaryFunction f)
+{
+    for(int i = blockIdx.x * blockDim.x + threadIdx.x; i < n; i += gridDim.x * blockDim.x)
+        f(i);
+}
+
+// partials[0,num_partials) <- per-block sums of conj(x[i]) * y[i]
+template <typename DerivedPolicy, typename ValueType>
+void graph_dotc(cuda::execution_policy<DerivedPolicy>& exec,
+                const size_t n,
+                const ValueType * x,
+                const ValueType * y,
+                ValueType * partials)
+{
+    cudaStream_t s = stream(thrust::detail::derived_cast(exec));
+
+    graph_dotc_kernel<ValueType> <<<graph_num_partials(n), GRAPH_BLOCK_SIZE, 0, s>>>
+    (n, x, y, partials);
+}
+
+template <unsigned int NUM_DOTS, typename DerivedPolicy, typename ValueType, typename ScalarFunction>
+void graph_scalar(cuda::execution_policy<DerivedPolicy>& exec,
+                  const size_t n,
+                  const ValueType * partials,
+                  ValueType * scalars,
+                  ScalarFunction f)
+{
+    cudaStream_t s = stream(thrust::detail::derived_cast(exec));
+
+    graph_scalar_kernel<NUM_DOTS, ValueType, ScalarFunction> <<<1, GRAPH_BLOCK_SIZE, 0, s>>>
+    (graph_num_partials(n), partials, scalars, f);
+}
+
+template <typename DerivedPolicy, typename UnaryFunction>
+void graph_for_each(cuda::execution_policy<DerivedPolicy>& exec,
+                    const size_t n,
+                    UnaryFunction f)
+{
+    if(n == 0)
+        return;
+
+    const size_t BLOCK_SIZE = 256;
+    const size_t NUM_BLOCKS = cusp::system::cuda::detail::launch_blocks(graph_for_each_kernel<UnaryFunction>, BLOCK_SIZE, (size_t) 0, n, BLOCK_SIZE);
+
+    cudaStream_t s = stream(thrust::detail::derived_cast(exec));
+
+    graph_for_each_kernel<UnaryFunction> <<<NUM_BLOCKS, BLOCK_SIZE, 0, s>>>(n, f);
+}
+
+} // end namespace detail
+} // end namespace cuda
+} // end namespace system
+} // end namespace cusp
@@ -17,5 +17,82 @@
 #pragma once
 
 #include <cusp/detail/config.h>
+#include <cusp/detail/format.h>
+#include <cusp/detail/temporary_array.h>
 
-// this system has no special version of this algorithm
+#include <cusp/format_utils.h>
+#include <cusp/sort.h>
+
+#include <cusp/system/detail/generic/transpose.h>
+
+#include <cusp/system/cuda/detail/execution_policy.h>
+
+#include <thrust/fill.h>
+#include <thrust/gather.h>
+#include <thrust/sequence.h>
+#include <thrust/tuple.h>
+#include <thrust/iterator/zip_iterator.h>
+
+namespace cusp
+{
+namespace system
+{
+namespace cuda
+{
+namespace detail
+{
+
+//////////////////////////////////////////////////////////////////////////////
+// CSR transpose
+//////////////////////////////////////////////////////////////////////////////
+//
+// The positions of the entries of A are ordered by their column indices
+// with the stable counting sort, which leaves the entries of every column
+// in the row order of A.  The sorted column indices become the row offsets
+// of At and the permutation gathers its column indices and values, so the
+// rows of At are sorted for any row length without a comparison sort.
+
+template <typename DerivedPolicy,
+          typename MatrixType1,
+          typename MatrixType2>
+void transpose(cuda::execution_policy<DerivedPolicy>& exec,
+               const MatrixType1& A,
+                     MatrixType2& At,
+               cusp::csr_format,
+               cusp::csr_format)
+{
+    typedef typename MatrixType2::index_type IndexType;
+
+    const size_t N = A.num_entries;
+
+    // every column index and value of At is written below
+    At.resize(A.num_cols, A.num_rows, N, cusp::no_init);
+
+    if (N == 0)
+    {
+        thrust::fill(exec, At.row_offsets.begin(), At.row_offsets.end(), IndexType(0));
+        return;
+    }
+
+    cusp::detail::temporary_array<IndexType, DerivedPolicy> keys(exec, A.column_indices);
+    cusp::detail::temporary_array<IndexType, DerivedPolicy> permutation(exec, N);
+    thrust::sequence(exec, permutation.begin(), permutation.end());
+
+    cusp::counting_sort_by_key(exec, keys, permutation, IndexType(0), IndexType(A.num_cols - 1));
+
+    cusp::indices_to_offsets(exec, keys, At.row_offsets);
+
+    // the rows of A become the column indices of At
+    cusp::detail::temporary_array<IndexType, DerivedPolicy> row_indices(exec, N);
+    cusp::offsets_to_indices(exec, A.row_offsets, row_indices);
+
+    thrust::gather(exec,
+                   permutation.begin(), permutation.end(),
+                   thrust::make_zip_iterator(thrust::make_tuple(row_indices.begin(),       A.values.begin())),
+                   thrust::make_zip_iterator(thrust::make_tuple(At.column_indices.begin(), At.values.begin())));
+}
+
+} // end namespace detail
+} // end namespace cuda
+} // end namespace system
+} // end namespace cusp
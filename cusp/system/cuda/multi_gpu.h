@@ -0,0 +1,409 @@
+/*
+ *  Copyright 2008-2014 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*! \file multi_gpu.h
+ *  \brief Sparse matrix and vector whose rows are partitioned over the
+ *  devices of a single node
+ */
+
+#pragma once
+
+#include <cusp/detail/config.h>
+
+#include <cusp/array1d.h>
+#include <cusp/csr_matrix.h>
+#include <cusp/complex.h>
+
+#include <cusp/system/cuda/detail/par.h>
+
+#include <cuda_runtime_api.h>
+
+#include <vector>
+
+namespace cusp
+{
+namespace system
+{
+namespace cuda
+{
+namespace multi_gpu
+{
+
+/*! \cond */
+namespace detail
+{
+
+// makes a device current for the lifetime of the object
+class device_guard
+{
+  public:
+
+    explicit device_guard(const int device);
+    ~device_guard(void);
+
+  private:
+
+    int previous;
+};
+
+// devices, streams and row ranges of the parts, shared by a matrix and the
+// vectors created from it
+struct placement
+{
+    std::vector<int>          devices;
+    std::vector<cudaStream_t> streams;
+
+    // rows of part p are [row_starts[p], row_starts[p + 1]) of the
+    // permuted ordering, permutation[i] is the original index of row i
+    std::vector<size_t> row_starts;
+    std::vector<size_t> permutation;
+
+    size_t num_parts(void) const { return devices.size(); }
+    size_t part_size(const size_t p) const { return row_starts[p + 1] - row_starts[p]; }
+};
+
+} // end namespace detail
+/*! \endcond */
+
+template <typename IndexType, typename ValueType> class csr_matrix;
+
+/*! \addtogroup containers Containers
+ *  \{
+ */
+
+/**
+ * \brief Vector whose entries are partitioned over devices like the rows of
+ * a \p multi_gpu::csr_matrix
+ *
+ * \tparam ValueType Type of the entries (e.g. \c float).
+ *
+ * \par Overview
+ *  Part \c p is a <tt>cusp::array1d<ValueType,cusp::device_memory></tt>
+ *  allocated on the device of part \c p of the matrix the vector was
+ *  created from, and the work on it is issued to the stream of that part.
+ *  \p scatter and \p gather convert from and to a vector in the original
+ *  ordering of the matrix rows.
+ *
+ * \note The matrix must outlive its vectors. Vectors are not copyable,
+ *  \p multi_gpu::blas::copy copies the values of vectors of the same matrix.
+ */
+template <typename ValueType>
+class array1d
+{
+  public:
+
+    /*! \cond */
+    typedef ValueType                                      value_type;
+    typedef cusp::array1d<ValueType,cusp::device_memory>   part_type;
+    /*! \endcond */
+
+    /*! Construct a vector with the layout of \p A whose entries are \p value.
+     */
+    template <typename IndexType>
+    explicit array1d(const csr_matrix<IndexType,ValueType>& A, const ValueType value = ValueType(0));
+
+    ~array1d(void);
+
+    /*! Total number of entries.
+     */
+    size_t size(void) const;
+
+    /*! Number of parts.
+     */
+    size_t num_parts(void) const;
+
+    /*! Device of part \p p.
+     */
+    int device(const size_t p) const;
+
+    /*! Stream on which the work on part \p p is issued.
+     */
+    cudaStream_t stream(const size_t p) const;
+
+    /*! Entries of part \p p, allocated on <tt>device(p)</tt>.
+     */
+    part_type& part(const size_t p);
+    const part_type& part(const size_t p) const;
+
+    /*! Copy the entries of \p x, which is in the original ordering of the
+     *  matrix rows, into the parts.
+     */
+    template <typename ArrayType>
+    void scatter(const ArrayType& x);
+
+    /*! Copy the parts into \p x in the original ordering of the matrix
+     *  rows, \p x is resized to \p size().
+     */
+    template <typename ArrayType>
+    void gather(ArrayType& x) const;
+
+    /*! \cond */
+    // one entry on the device of part p that receives its partial reduction
+    part_type& scalar(const size_t p) const { return *scalars[p]; }
+
+    const detail::placement& layout(void) const { return *m_layout; }
+    /*! \endcond */
+
+  private:
+
+    /*! \cond */
+    const detail::placement* m_layout;
+
+    std::vector<part_type*> parts;
+    std::vector<part_type*> scalars;
+
+    array1d(const array1d&);
+    array1d& operator=(const array1d&);
+    /*! \endcond */
+};
+
+/**
+ * \brief Sparse matrix whose rows are partitioned over the devices of a
+ * single node
+ *
+ * \tparam IndexType Type used for matrix indices (e.g. \c int).
+ * \tparam ValueType Type used for matrix values (e.g. \c float).
+ *
+ * \par Overview
+ *  Every part owns a set of rows, either consecutive blocks or the parts
+ *  computed by a graph partitioner such as
+ *  \p cusp::graph::multilevel_partition or \p cusp::graph::hilbert_curve,
+ *  and the entries of the vectors with the same indices. The rows of a
+ *  part are split into a square diagonal block, whose columns are owned by
+ *  the same part, and an off-diagonal block whose columns are compressed to
+ *  the ghost entries owned by the other parts.
+ *
+ *  \p multiply gathers the entries needed by the other parts on a
+ *  dedicated transfer stream of each part and copies them into the ghost
+ *  buffers of their consumers with peer-to-peer copies, while the compute
+ *  stream of each part multiplies its diagonal block. The compute stream
+ *  then waits for the copies from its neighbours and adds the product of
+ *  the off-diagonal block. Peer access is enabled between the devices that
+ *  support it, the other copies are staged by the driver. Several parts
+ *  may share a device.
+ *
+ *  The work is issued asynchronously, the reductions of
+ *  \p multi_gpu::blas and \p array1d::gather wait for it.
+ *
+ * \par Example
+ *  \code
+ *  #include <cusp/csr_matrix.h>
+ *  #include <cusp/gallery/poisson.h>
+ *  #include <cusp/system/cuda/multi_gpu.h>
+ *
+ *  int main(void)
+ *  {
+ *      cusp::csr_matrix<int, float, cusp::host_memory> G;
+ *      cusp::gallery::poisson5pt(G, 1024, 1024);
+ *
+ *      int count;
+ *      cudaGetDeviceCount(&count);
+ *
+ *      std::vector<int> devices;
+ *      for (int d = 0; d < count; d++)
+ *          devices.push_back(d);
+ *
+ *      namespace mg = cusp::system::cuda::multi_gpu;
+ *
+ *      mg::csr_matrix<int, float> A(G, devices);
+ *      mg::array1d<float> x(A, 1), y(A);
+ *
+ *      mg::multiply(A, x, y);
+ *
+ *      float norm = mg::blas::nrm2(y);
+ *  }
+ *  \endcode
+ */
+template <typename IndexType, typename ValueType>
+class csr_matrix
+{
+  public:
+
+    /*! \cond */
+    typedef IndexType                                                 index_type;
+    typedef ValueType                                                 value_type;
+    typedef cusp::csr_matrix<IndexType,ValueType,cusp::device_memory> local_matrix_type;
+    /*! \endcond */
+
+    /*! Number of rows, columns and entries of the whole matrix.
+     */
+    size_t num_rows;
+    size_t num_cols;
+    size_t num_entries;
+
+    /*! Partition \p A into consecutive blocks of rows of nearly equal size,
+     *  block \c p is placed on <tt>devices[p]</tt>.
+     *
+     *  \param A square matrix
+     *  \param devices device of every part
+     *
+     *  \throws cusp::invalid_input_exception if \p A is not square or
+     *  \p devices is empty
+     */
+    template <typename MatrixType>
+    csr_matrix(const MatrixType& A, const std::vector<int>& devices);
+
+    /*! Partition \p A by the part of every row, part \c p is placed on
+     *  <tt>devices[p]</tt>.
+     *
+     *  \param A square matrix
+     *  \param parts part of every row in <tt>[0, devices.size())</tt>
+     *  \param devices device of every part
+     *
+     *  \throws cusp::invalid_input_exception if \p A is not square, the size
+     *  of \p parts differs from the number of rows or a part is out of range
+     */
+    template <typename MatrixType, typename ArrayType>
+    csr_matrix(const MatrixType& A, const ArrayType& parts, const std::vector<int>& devices);
+
+    ~csr_matrix(void);
+
+    /*! Number of parts.
+     */
+    size_t num_parts(void) const;
+
+    /*! Diagonal block of part \p p, allocated on its device.
+     */
+    const local_matrix_type& diagonal_block(const size_t p) const;
+
+    /*! Off-diagonal block of part \p p, its columns index the ghost
+     *  entries of the part.
+     */
+    const local_matrix_type& off_diagonal_block(const size_t p) const;
+
+    /*! Multiply the matrix with \p x, y = A x.
+     */
+    void operator()(const array1d<ValueType>& x, array1d<ValueType>& y) const;
+
+    /*! \cond */
+    const detail::placement& layout(void) const { return m_layout; }
+    /*! \endcond */
+
+  private:
+
+    /*! \cond */
+    struct part_data
+    {
+        cudaStream_t transfer;
+        cudaEvent_t  compute_done;
+        cudaEvent_t  sent;
+
+        local_matrix_type diagonal;
+        local_matrix_type off_diagonal;
+
+        // entries needed by the consumers, those of each consumer are
+        // contiguous in send_buffer and copied to ghost_offsets in its
+        // ghost_values
+        std::vector<int>    consumers;
+        std::vector<size_t> send_offsets;
+        std::vector<size_t> ghost_offsets;
+
+        // parts whose entries are needed by this part
+        std::vector<int> sources;
+
+        cusp::array1d<IndexType,cusp::device_memory>         send_indices;
+        mutable cusp::array1d<ValueType,cusp::device_memory> send_buffer;
+        mutable cusp::array1d<ValueType,cusp::device_memory> ghost_values;
+
+        part_data(void) : transfer(0), compute_done(0), sent(0) {}
+    };
+
+    detail::placement       m_layout;
+    std::vector<part_data*> parts;
+
+    csr_matrix(const csr_matrix&);
+    csr_matrix& operator=(const csr_matrix&);
+
+    template <typename MatrixType>
+    void setup(const MatrixType& A, const std::vector<int>& row_parts, const std::vector<int>& devices);
+
+    void release(void);
+    /*! \endcond */
+};
+/*! \}
+ */
+
+/*! \addtogroup algorithms Algorithms
+ *  \{
+ */
+
+/**
+ * \brief Multiply a \p multi_gpu::csr_matrix with a vector of the same
+ * layout, y = A x.
+ *
+ * \param A matrix
+ * \param x input vector created from \p A
+ * \param y output vector created from \p A
+ */
+template <typename IndexType, typename ValueType>
+void multiply(const csr_matrix<IndexType,ValueType>& A,
+              const array1d<ValueType>& x,
+                    array1d<ValueType>& y);
+/*! \}
+ */
+
+/**
+ * \brief Level 1 BLAS on \p multi_gpu::array1d
+ *
+ * The updates are issued to the stream of every part and do not wait for
+ * the devices, the reductions combine the partial results of all devices
+ * on the host.
+ */
+namespace blas
+{
+
+/*! y = alpha * x + y */
+template <typename ValueType, typename ScalarType>
+void axpy(const array1d<ValueType>& x, array1d<ValueType>& y, const ScalarType alpha);
+
+/*! z = alpha * x + beta * y */
+template <typename ValueType, typename ScalarType1, typename ScalarType2>
+void axpby(const array1d<ValueType>& x, const array1d<ValueType>& y, array1d<ValueType>& z,
+           const ScalarType1 alpha, const ScalarType2 beta);
+
+/*! y = x */
+template <typename ValueType>
+void copy(const array1d<ValueType>& x, array1d<ValueType>& y);
+
+/*! x[i] = alpha */
+template <typename ValueType, typename ScalarType>
+void fill(array1d<ValueType>& x, const ScalarType alpha);
+
+/*! x = alpha * x */
+template <typename ValueType, typename ScalarType>
+void scal(array1d<ValueType>& x, const ScalarType alpha);
+
+/*! \return x^T y */
+template <typename ValueType>
+ValueType dot(const array1d<ValueType>& x, const array1d<ValueType>& y);
+
+/*! \return x^H y */
+template <typename ValueType>
+ValueType dotc(const array1d<ValueType>& x, const array1d<ValueType>& y);
+
+/*! \return the Euclidean norm of x */
+template <typename ValueType>
+typename cusp::norm_type<ValueType>::type
+nrm2(const array1d<ValueType>& x);
+
+} // end namespace blas
+
+} // end namespace multi_gpu
+} // end namespace cuda
+} // end namespace system
+} // end namespace cusp
+
+#include <cusp/system/cuda/detail/multi_gpu.inl>
@@ -0,0 +1,173 @@
+/*
+ *  Copyright 2008-2014 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*! \file out_of_core.h
+ *  \brief Sparse matrix kept in host memory whose products stream its rows
+ *  through the device
+ */
+
+#pragma once
+
+#include <cusp/detail/config.h>
+
+#include <cusp/array1d.h>
+#include <cusp/csr_matrix.h>
+#include <cusp/linear_operator.h>
+#include <cusp/memory.h>
+
+#include <cuda_runtime_api.h>
+
+#include <vector>
+
+namespace cusp
+{
+namespace system
+{
+namespace cuda
+{
+namespace out_of_core
+{
+
+/*! \addtogroup containers Containers
+ *  \{
+ */
+
+/**
+ * \brief CSR matrix in pinned host memory multiplied on the device
+ *
+ * \tparam IndexType Type used for matrix indices (e.g. \c int).
+ * \tparam ValueType Type used for matrix values (e.g. \c float).
+ *
+ * \par Overview
+ *  For matrices that exceed the memory of the device but not that of the
+ *  host. The rows are split into consecutive blocks of at most
+ *  \p block_entries entries (a longer row is a block by itself), and a
+ *  product copies every block into one of \p num_buffers device buffers,
+ *  each with its own stream, and multiplies it as soon as it has arrived.
+ *  The copy of the next blocks overlaps the product of the current one, so
+ *  the throughput approaches the bandwidth of the host to device link.
+ *  Only the vectors and the buffers are allocated on the device.
+ *
+ *  The product is ordered with the work of the default stream.
+ *
+ * \par Example
+ *  \code
+ *  #include <cusp/csr_matrix.h>
+ *  #include <cusp/io/matrix_market.h>
+ *  #include <cusp/system/cuda/out_of_core.h>
+ *
+ *  int main(void)
+ *  {
+ *      cusp::csr_matrix<int, double, cusp::host_memory> G;
+ *      cusp::io::read_matrix_market_file(G, "huge.mtx");
+ *
+ *      // three buffers of 16M entries
+ *      cusp::system::cuda::out_of_core::csr_matrix<int, double> A(G, 1 << 24, 3);
+ *
+ *      cusp::array1d<double, cusp::device_memory> x(A.num_cols, 1), y(A.num_rows);
+ *
+ *      A(x, y);
+ *  }
+ *  \endcode
+ */
+template <typename IndexType, typename ValueType>
+class csr_matrix : public cusp::linear_operator<ValueType,cusp::device_memory,IndexType>
+{
+  private:
+
+    typedef cusp::linear_operator<ValueType,cusp::device_memory,IndexType> Parent;
+
+  public:
+
+    /*! \cond */
+    typedef cusp::csr_matrix<IndexType,ValueType,cusp::pinned_memory> host_matrix_type;
+    /*! \endcond */
+
+    /*! Copy \p A into pinned host memory and allocate the device buffers.
+     *
+     *  \param A matrix in any format
+     *  \param block_entries target number of entries of a block
+     *  \param num_buffers number of device buffers, two or more overlap the
+     *  transfers with the products
+     *
+     *  \throws cusp::invalid_input_exception if \p block_entries or
+     *  \p num_buffers is zero
+     */
+    template <typename MatrixType>
+    csr_matrix(const MatrixType& A, const size_t block_entries = size_t(1) << 22, const size_t num_buffers = 3);
+
+    ~csr_matrix(void);
+
+    /*! Number of row blocks.
+     */
+    size_t num_blocks(void) const;
+
+    /*! Number of device buffers.
+     */
+    size_t num_buffers(void) const;
+
+    /*! First row of every block, and the number of rows at the end.
+     */
+    const std::vector<size_t>& block_rows(void) const;
+
+    /*! Multiply the matrix with \p x, y = A x, both in device memory.
+     *
+     *  \throws cusp::invalid_input_exception if the sizes of \p x or \p y
+     *  do not match the matrix
+     */
+    template <typename ArrayType1, typename ArrayType2>
+    void operator()(const ArrayType1& x, ArrayType2& y) const;
+
+  private:
+
+    /*! \cond */
+    struct buffer
+    {
+        cudaStream_t stream;
+        cudaEvent_t  done;
+
+        mutable cusp::array1d<IndexType,cusp::device_memory> row_offsets;
+        mutable cusp::array1d<IndexType,cusp::device_memory> column_indices;
+        mutable cusp::array1d<ValueType,cusp::device_memory> values;
+
+        buffer(void) : stream(0), done(0) {}
+    };
+
+    host_matrix_type matrix;
+
+    // row offsets of every block relative to its first entry, block b
+    // starts at local_offsets[rows[b] + b]
+    cusp::array1d<IndexType,cusp::pinned_memory> local_offsets;
+    std::vector<size_t> rows;
+
+    std::vector<buffer*> buffers;
+    cudaEvent_t ready;
+
+    csr_matrix(const csr_matrix&);
+    csr_matrix& operator=(const csr_matrix&);
+
+    void release(void);
+    /*! \endcond */
+};
+/*! \}
+ */
+
+} // end namespace out_of_core
+} // end namespace cuda
+} // end namespace system
+} // end namespace cusp
+
+#include <cusp/system/cuda/detail/out_of_core.inl>
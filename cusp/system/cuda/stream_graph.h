@@ -0,0 +1,155 @@
+/*
+ *  Copyright 2008-2014 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*! \file stream_graph.h
+ *  \brief Capture and replay of the work issued on a CUDA stream
+ */
+
+#pragma once
+
+#include <cusp/detail/config.h>
+
+#include <cusp/system/cuda/detail/par.h>
+
+#include <cuda_runtime_api.h>
+
+namespace cusp
+{
+namespace system
+{
+namespace cuda
+{
+
+/*! \addtogroup algorithms Algorithms
+ *  \{
+ */
+
+/**
+ * \brief A sequence of kernel launches captured from a CUDA stream that
+ * can be replayed with a single launch.
+ *
+ * \par Overview
+ *  \p capture begins a capture on the stream \p s, calls the function
+ *  object with the execution policy <tt>cusp::cuda::par.on(s)</tt> and
+ *  instantiates the recorded work as a CUDA graph. Nothing is executed
+ *  while capturing, every subsequent \p launch replays the recorded
+ *  kernels with the arguments they were recorded with, so the function
+ *  object must only operate on storage that outlives the graph.
+ *
+ *  The capture fails, and \p capture returns \c false, when the recorded
+ *  work synchronizes with the host, allocates memory or runs on another
+ *  stream, for example when a result is copied back to the host. The
+ *  caller is then expected to issue the work directly.
+ *
+ * \note The stream must not be the default stream and graphs require
+ * CUDA 10 or newer, otherwise \p capture always returns \c false.
+ *
+ * \par Example
+ * \code
+ * #include <cusp/csr_matrix.h>
+ * #include <cusp/multiply.h>
+ * #include <cusp/gallery/poisson.h>
+ * #include <cusp/system/cuda/stream_graph.h>
+ *
+ * struct spmv
+ * {
+ *   cusp::csr_matrix<int,float,cusp::device_memory>& A;
+ *   cusp::array1d<float,cusp::device_memory>& x;
+ *   cusp::array1d<float,cusp::device_memory>& y;
+ *
+ *   template <typename Policy>
+ *   void operator()(Policy& exec) { cusp::multiply(exec, A, x, y); }
+ * };
+ *
+ * int main(void)
+ * {
+ *   cusp::csr_matrix<int,float,cusp::device_memory> A;
+ *   cusp::gallery::poisson5pt(A, 256, 256);
+ *
+ *   cusp::array1d<float,cusp::device_memory> x(A.num_rows, 1);
+ *   cusp::array1d<float,cusp::device_memory> y(A.num_rows);
+ *
+ *   cudaStream_t s;
+ *   cudaStreamCreate(&s);
+ *
+ *   spmv f = {A, x, y};
+ *   cusp::system::cuda::stream_graph g;
+ *
+ *   if(g.capture(s, f))
+ *     for(int i = 0; i < 100; i++)
+ *       g.launch(s);
+ *
+ *   cudaStreamSynchronize(s);
+ *   cudaStreamDestroy(s);
+ * }
+ * \endcode
+ */
+class stream_graph
+{
+  public:
+
+    /*! Execution policy passed to the captured function object */
+    typedef cusp::system::cuda::detail::execute_on_stream policy_type;
+
+    /*! Construct an empty graph */
+    stream_graph(void);
+
+    ~stream_graph(void);
+
+    /*! Record the work issued by <tt>f(cusp::cuda::par.on(s))</tt>,
+     *  replacing any previously captured work.
+     *
+     * \param s non-default stream to capture from
+     * \param f function object called with a \p policy_type
+     *
+     * \return \c true if the work was captured, \c false if the capture
+     * failed, in which case the graph is empty and nothing was executed.
+     */
+    template <typename Function>
+    bool capture(const cudaStream_t s, Function& f);
+
+    /*! Replay the captured work on \p s.
+     *
+     * \throws cusp::runtime_exception if the graph is empty or the launch fails
+     */
+    void launch(const cudaStream_t s) const;
+
+    /*! \return \c true if no work has been captured */
+    bool empty(void) const;
+
+    /*! Release the captured work */
+    void reset(void);
+
+  private:
+
+    // graphs own device resources and are not copied
+    stream_graph(const stream_graph&);
+    stream_graph& operator=(const stream_graph&);
+
+#if CUDART_VERSION >= 10000
+    cudaGraphExec_t instance;
+#else
+    void* instance;
+#endif
+};
+/*! \}
+ */
+
+} // end namespace cuda
+} // end namespace system
+} // end namespace cusp
+
+#include <cusp/system/cuda/detail/stream_graph.inl>
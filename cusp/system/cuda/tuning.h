@@ -0,0 +1,280 @@
+/*
+ *  Copyright 2008-2014 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*! \file tuning.h
+ *  \brief Runtime tuning of the CUDA SpMV kernels
+ */
+
+#pragma once
+
+#include <cusp/detail/config.h>
+
+#include <cuda_runtime_api.h>
+
+#include <cstddef>
+#include <map>
+
+#if __cplusplus >= 201103L
+#include <mutex>
+#endif
+
+namespace cusp
+{
+namespace system
+{
+namespace cuda
+{
+namespace detail
+{
+
+// identifies an operator by its format, shape and storage, the address
+// of the index storage is used as the sparsity signature so that a
+// lookup never has to read device memory
+struct spmv_tuning_key
+{
+    int         format;
+    size_t      value_size;
+    size_t      num_rows;
+    size_t      num_cols;
+    size_t      num_entries;
+    const void* signature;
+
+    spmv_tuning_key(int format, size_t value_size,
+                    size_t num_rows, size_t num_cols, size_t num_entries,
+                    const void* signature)
+        : format(format), value_size(value_size),
+          num_rows(num_rows), num_cols(num_cols), num_entries(num_entries),
+          signature(signature) {}
+
+    bool operator<(const spmv_tuning_key& other) const
+    {
+        if(format      != other.format)      return format      < other.format;
+        if(value_size  != other.value_size)  return value_size  < other.value_size;
+        if(num_rows    != other.num_rows)    return num_rows    < other.num_rows;
+        if(num_cols    != other.num_cols)    return num_cols    < other.num_cols;
+        if(num_entries != other.num_entries) return num_entries < other.num_entries;
+        return signature < other.signature;
+    }
+};
+
+struct spmv_tuning_record
+{
+    int   num_trials;
+    int   best_candidate;
+    float best_time;
+
+    spmv_tuning_record(void)
+        : num_trials(0), best_candidate(0), best_time(0) {}
+};
+
+// row bins of a CSR matrix for the CSR-Adaptive SpMV, the bins live in a
+// single device allocation whose layout is described in csr_adaptive_spmv.h
+// and run on streams owned by the plan
+struct csr_adaptive_plan
+{
+    static const int NUM_STREAMS = 2;
+
+    size_t num_stream_blocks;
+    size_t num_vector_rows;
+    size_t num_long_rows;
+    size_t num_chunks;
+
+    size_t* storage;
+
+    cudaStream_t streams[NUM_STREAMS];
+    cudaEvent_t  fork_event;
+    cudaEvent_t  join_events[NUM_STREAMS];
+
+    csr_adaptive_plan(void)
+        : num_stream_blocks(0), num_vector_rows(0), num_long_rows(0), num_chunks(0), storage(0) {}
+
+    void release(void)
+    {
+        if(storage == 0)
+            return;
+
+        for(int i = 0; i < NUM_STREAMS; i++)
+        {
+            cudaEventDestroy(join_events[i]);
+            cudaStreamDestroy(streams[i]);
+        }
+
+        cudaEventDestroy(fork_event);
+        cudaFree(storage);
+
+        storage = 0;
+    }
+};
+
+// records and plans are shared by all host threads, lookups and updates
+// hold mutex
+struct spmv_tuning_state
+{
+    bool enabled;
+    int  csr_method;
+    std::map<spmv_tuning_key, spmv_tuning_record> records;
+    std::map<spmv_tuning_key, csr_adaptive_plan>  csr_adaptive_plans;
+
+#if __cplusplus >= 201103L
+    std::mutex mutex;
+#endif
+
+    spmv_tuning_state(void) : enabled(false), csr_method(0) {}
+
+    ~spmv_tuning_state(void)
+    {
+        clear_csr_adaptive_plans();
+    }
+
+    void clear_csr_adaptive_plans(void)
+    {
+        std::map<spmv_tuning_key, csr_adaptive_plan>::iterator iter;
+
+        for(iter = csr_adaptive_plans.begin(); iter != csr_adaptive_plans.end(); ++iter)
+            iter->second.release();
+
+        csr_adaptive_plans.clear();
+    }
+};
+
+inline spmv_tuning_state& get_spmv_tuning_state(void)
+{
+    static spmv_tuning_state state;
+    return state;
+}
+
+} // end namespace detail
+
+/*! \addtogroup algorithms Algorithms
+ *  \{
+ */
+
+/**
+ * \brief Enable runtime tuning of the CUDA SpMV kernels.
+ *
+ * \par Overview
+ *  When tuning is enabled the CSR, ELL and DIA SpMV implementations of the
+ *  CUDA backend execute a different candidate kernel configuration on each
+ *  of the first calls with a given operator and time it. Once every
+ *  candidate has been measured the fastest configuration is cached and used
+ *  for all subsequent calls with the same operator. Operators are
+ *  identified by their format, value type size, shape, number of entries
+ *  and the address of their index storage. Every call remains a single,
+ *  correct SpMV so no additional work is performed, but the timed calls
+ *  synchronize with the device.
+ *
+ * \note Host threads share the tuning cache, which is thread safe when
+ *  compiled as C++11. Enabling or disabling tuning is not synchronized
+ *  with SpMV calls in progress.
+ *
+ * \par Example
+ * \code
+ * #include <cusp/csr_matrix.h>
+ * #include <cusp/multiply.h>
+ * #include <cusp/gallery/poisson.h>
+ * #include <cusp/system/cuda/tuning.h>
+ *
+ * int main(void)
+ * {
+ *   cusp::csr_matrix<int,float,cusp::device_memory> A;
+ *   cusp::gallery::poisson5pt(A, 256, 256);
+ *
+ *   cusp::array1d<float,cusp::device_memory> x(A.num_rows, 1);
+ *   cusp::array1d<float,cusp::device_memory> y(A.num_rows);
+ *
+ *   cusp::system::cuda::enable_spmv_tuning();
+ *
+ *   // the first calls select the fastest kernel for A
+ *   for(int i = 0; i < 100; i++)
+ *     cusp::multiply(A, x, y);
+ * }
+ * \endcode
+ */
+inline void enable_spmv_tuning(void)
+{
+    detail::get_spmv_tuning_state().enabled = true;
+}
+
+/**
+ * \brief Disable runtime tuning of the CUDA SpMV kernels and revert to
+ * the default kernel selection heuristics. Cached results are retained.
+ */
+inline void disable_spmv_tuning(void)
+{
+    detail::get_spmv_tuning_state().enabled = false;
+}
+
+/**
+ * \brief Discard all cached tuning results and CSR-Adaptive row bins,
+ * e.g. after an operator has been deallocated and its storage may be
+ * reused by a different matrix. No SpMV may run concurrently.
+ */
+inline void clear_spmv_tuning(void)
+{
+    detail::spmv_tuning_state& state = detail::get_spmv_tuning_state();
+
+#if __cplusplus >= 201103L
+    std::lock_guard<std::mutex> lock(state.mutex);
+#endif
+
+    state.records.clear();
+    state.clear_csr_adaptive_plans();
+}
+
+/**
+ * \brief Kernels used by the CUDA CSR SpMV when tuning is disabled.
+ */
+enum csr_spmv_method
+{
+    csr_spmv_default  = 0, /**< vector kernels, merge-path for skewed row lengths */
+    csr_spmv_merge    = 1, /**< merge-path decomposition for every matrix */
+    csr_spmv_adaptive = 2  /**< CSR-Adaptive row bins */
+};
+
+/**
+ * \brief Select the kernels of the CUDA CSR SpMV.
+ *
+ * \par Overview
+ *  \p csr_spmv_adaptive bins the rows of each operator by length on the
+ *  first call. Runs of short rows are packed into blocks whose entries
+ *  are staged in shared memory (CSR-stream), medium rows are processed by
+ *  one warp each and very long rows are split across several thread
+ *  blocks. The three bins run concurrently on separate streams. The bins
+ *  are cached with the tuning results under the same operator key, so
+ *  clear_spmv_tuning must be called before the storage of a matrix is
+ *  reused for a different sparsity pattern.
+ *
+ * \note The selection is not synchronized, set it before other host
+ *  threads start calling the SpMV.
+ */
+inline void set_csr_spmv_method(const csr_spmv_method method)
+{
+    detail::get_spmv_tuning_state().csr_method = method;
+}
+
+/**
+ * \brief Returns the kernels used by the CUDA CSR SpMV.
+ */
+inline csr_spmv_method get_csr_spmv_method(void)
+{
+    return csr_spmv_method(detail::get_spmv_tuning_state().csr_method);
+}
+/*! \}
+ */
+
+} // end namespace cuda
+} // end namespace system
+} // end namespace cusp
@@ -17,6 +17,8 @@
 
 #pragma once
 
+#include <cusp/complex.h>
+
 #include <thrust/pair.h>
 
 namespace cusp
@@ -53,6 +55,46 @@ thrust::pair<T,T> uniform_splitting(const T N, const T granularity, const T max_
     return thrust::make_pair(interval_size, num_intervals);
 }
 
+#if defined(__CUDACC__)
+// atomic addition for float and double, the latter is emulated with
+// atomicCAS on devices without native support
+__device__ inline float atomic_add(float * address, const float val)
+{
+    return atomicAdd(address, val);
+}
+
+__device__ inline double atomic_add(double * address, const double val)
+{
+#if __CUDA_ARCH__ >= 600
+    return atomicAdd(address, val);
+#else
+    unsigned long long int * address_as_ull = (unsigned long long int *) address;
+    unsigned long long int old = *address_as_ull, assumed;
+
+    do {
+        assumed = old;
+        old = atomicCAS(address_as_ull, assumed,
+                        __double_as_longlong(val + __longlong_as_double(assumed)));
+    } while (assumed != old);
+
+    return __longlong_as_double(old);
+#endif
+}
+
+// complex values are added one part at a time, so concurrent additions
+// are atomic per part but not for the complex value as a whole
+template <typename T>
+__device__ inline cusp::complex<T> atomic_add(cusp::complex<T> * address, const cusp::complex<T> val)
+{
+    T * parts = reinterpret_cast<T *>(address);
+
+    const T real = atomic_add(parts,     val.real());
+    const T imag = atomic_add(parts + 1, val.imag());
+
+    return cusp::complex<T>(real, imag);
+}
+#endif
+
 } // end namespace cuda
 } // end namespace system
 } // end namespace cusp
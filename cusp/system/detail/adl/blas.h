@@ -23,6 +23,8 @@
 // code which uses adl to dispatch blas
 
 #include <cusp/system/detail/sequential/blas.h>
+#include <cusp/system/detail/compensated/blas.h>
+#include <cusp/system/detail/profiling/blas.h>
 
 // SCons can't see through the #defines below to figure out what this header
 // includes, so we fake it out by specifying all possible files we might end up
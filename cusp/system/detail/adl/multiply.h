@@ -23,6 +23,7 @@
 // code which uses adl to dispatch multiply
 
 #include <cusp/system/detail/sequential/multiply.h>
+#include <cusp/system/detail/profiling/multiply.h>
 
 // SCons can't see through the #defines below to figure out what this header
 // includes, so we fake it out by specifying all possible files we might end up
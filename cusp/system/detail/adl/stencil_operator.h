@@ -0,0 +1,41 @@
+/*
+ *  Copyright 2008-2014 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#pragma once
+
+#include <cusp/detail/config.h>
+
+// the purpose of this header is to #include the stencil_operator.h header
+// of the host and device systems. It should be #included in any
+// code which uses adl to dispatch stencil_operator
+
+// SCons can't see through the #defines below to figure out what this header
+// includes, so we fake it out by specifying all possible files we might end up
+// including inside an #if 0.
+#if 0
+#include <cusp/system/cpp/detail/stencil_operator.h>
+#include <cusp/system/cuda/detail/stencil_operator.h>
+#include <cusp/system/omp/detail/stencil_operator.h>
+#include <cusp/system/tbb/detail/stencil_operator.h>
+#endif
+
+#define __CUSP_HOST_SYSTEM_STENCIL_OPERATOR_HEADER <__CUSP_HOST_SYSTEM_ROOT/detail/stencil_operator.h>
+#include __CUSP_HOST_SYSTEM_STENCIL_OPERATOR_HEADER
+#undef __CUSP_HOST_SYSTEM_STENCIL_OPERATOR_HEADER
+
+#define __CUSP_DEVICE_SYSTEM_STENCIL_OPERATOR_HEADER <__CUSP_DEVICE_SYSTEM_ROOT/detail/stencil_operator.h>
+#include __CUSP_DEVICE_SYSTEM_STENCIL_OPERATOR_HEADER
+#undef __CUSP_DEVICE_SYSTEM_STENCIL_OPERATOR_HEADER
@@ -23,6 +23,7 @@
 // code which uses adl to dispatch transpose
 
 #include <cusp/system/detail/sequential/transpose.h>
+#include <cusp/system/detail/profiling/transpose.h>
 
 // SCons can't see through the #defines below to figure out what this header
 // includes, so we fake it out by specifying all possible files we might end up
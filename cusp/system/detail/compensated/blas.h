@@ -0,0 +1,226 @@
+/*
+ *  Copyright 2008-2014 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#pragma once
+
+#include <cusp/detail/config.h>
+
+#include <cusp/complex.h>
+#include <cusp/functional.h>
+#include <cusp/verify.h>
+
+#include <cusp/system/detail/compensated/execution_policy.h>
+
+#include <thrust/functional.h>
+#include <thrust/transform_reduce.h>
+#include <thrust/tuple.h>
+#include <thrust/iterator/zip_iterator.h>
+
+#include <cmath>
+
+namespace cusp
+{
+namespace system
+{
+namespace detail
+{
+namespace compensated
+{
+
+// float data is accumulated in double precision, the products of two
+// floats are then exact and only the sums need to be compensated
+template <typename T>
+struct accumulate_type
+{
+    typedef T type;
+};
+
+template <>
+struct accumulate_type<float>
+{
+    typedef double type;
+};
+
+template <>
+struct accumulate_type< cusp::complex<float> >
+{
+    typedef cusp::complex<double> type;
+};
+
+// adds two (sum, compensation) pairs, the rounding error of the sum is
+// recovered exactly (TwoSum) and carried in the compensation. The
+// operation is associative up to the compensation, so the reduction may
+// combine the pairs in any order. It relies on IEEE arithmetic and is
+// defeated by value-unsafe optimizations such as -ffast-math.
+template <typename T>
+struct COMPENSATED_PLUS
+  : public thrust::binary_function< thrust::tuple<T,T>, thrust::tuple<T,T>, thrust::tuple<T,T> >
+{
+    __host__ __device__
+    thrust::tuple<T,T> operator()(const thrust::tuple<T,T>& a, const thrust::tuple<T,T>& b) const
+    {
+        const T a_sum = thrust::get<0>(a);
+        const T b_sum = thrust::get<0>(b);
+
+        const T s  = a_sum + b_sum;
+        const T bp = s - a_sum;
+        const T e  = (a_sum - (s - bp)) + (b_sum - bp);
+
+        return thrust::make_tuple(s, thrust::get<1>(a) + thrust::get<1>(b) + e);
+    }
+};
+
+template <typename AccumulateType, bool Conjugate>
+struct COMPENSATED_DOT
+{
+    template <typename Tuple>
+    __host__ __device__
+    thrust::tuple<AccumulateType,AccumulateType> operator()(const Tuple& t) const
+    {
+        const AccumulateType x(thrust::get<0>(t));
+        const AccumulateType y(thrust::get<1>(t));
+
+        return thrust::make_tuple((Conjugate ? cusp::conj(x) : x) * y, AccumulateType(0));
+    }
+};
+
+template <typename AccumulateType, typename NormType>
+struct COMPENSATED_ABS_SQUARED
+{
+    template <typename ValueType>
+    __host__ __device__
+    thrust::tuple<NormType,NormType> operator()(const ValueType& v) const
+    {
+        const AccumulateType x(v);
+
+        return thrust::make_tuple(NormType(cusp::abs_squared_functor<AccumulateType>()(x)), NormType(0));
+    }
+};
+
+template <template <typename> class ExecutionPolicy,
+          typename Array1,
+          typename Array2,
+          bool Conjugate>
+typename Array1::value_type
+compensated_dot(execute_compensated<ExecutionPolicy>& exec,
+                const Array1& x,
+                const Array2& y,
+                thrust::detail::integral_constant<bool,Conjugate>)
+{
+    typedef typename Array1::value_type                    ValueType;
+    typedef typename accumulate_type<ValueType>::type      AccumulateType;
+    typedef thrust::tuple<AccumulateType,AccumulateType>  Pair;
+
+    cusp::assert_same_dimensions(x, y);
+
+    Pair init(AccumulateType(0), AccumulateType(0));
+
+    Pair result =
+      thrust::transform_reduce(exec,
+                               thrust::make_zip_iterator(thrust::make_tuple(x.begin(), y.begin())),
+                               thrust::make_zip_iterator(thrust::make_tuple(x.end(),   y.end())),
+                               COMPENSATED_DOT<AccumulateType,Conjugate>(),
+                               init,
+                               COMPENSATED_PLUS<AccumulateType>());
+
+    return ValueType(thrust::get<0>(result) + thrust::get<1>(result));
+}
+
+template <template <typename> class ExecutionPolicy,
+          typename Array1,
+          typename Array2>
+typename Array1::value_type
+dot(execute_compensated<ExecutionPolicy>& exec,
+    const Array1& x,
+    const Array2& y)
+{
+    return compensated_dot(exec, x, y, thrust::detail::false_type());
+}
+
+template <template <typename> class ExecutionPolicy,
+          typename Array1,
+          typename Array2>
+typename Array1::value_type
+dotc(execute_compensated<ExecutionPolicy>& exec,
+     const Array1& x,
+     const Array2& y)
+{
+    return compensated_dot(exec, x, y, thrust::detail::true_type());
+}
+
+template <template <typename> class ExecutionPolicy,
+          typename Array>
+typename cusp::norm_type<typename Array::value_type>::type
+nrm2(execute_compensated<ExecutionPolicy>& exec,
+     const Array& x)
+{
+    typedef typename Array::value_type                        ValueType;
+    typedef typename cusp::norm_type<ValueType>::type         NormType;
+    typedef typename accumulate_type<ValueType>::type         AccumulateType;
+    typedef typename cusp::norm_type<AccumulateType>::type    AccumulateNormType;
+    typedef thrust::tuple<AccumulateNormType,AccumulateNormType> Pair;
+
+    Pair init(AccumulateNormType(0), AccumulateNormType(0));
+
+    Pair result =
+      thrust::transform_reduce(exec, x.begin(), x.end(),
+                               COMPENSATED_ABS_SQUARED<AccumulateType,AccumulateNormType>(),
+                               init,
+                               COMPENSATED_PLUS<AccumulateNormType>());
+
+    return NormType(std::sqrt(thrust::get<0>(result) + thrust::get<1>(result)));
+}
+
+// the forms writing into an array store the accurate value, they take
+// precedence over the asynchronous device versions of the base system
+template <template <typename> class ExecutionPolicy,
+          typename Array1,
+          typename Array2,
+          typename Array3>
+void dot(execute_compensated<ExecutionPolicy>& exec,
+         const Array1& x,
+         const Array2& y,
+               Array3& result)
+{
+    result[0] = dot(exec, x, y);
+}
+
+template <template <typename> class ExecutionPolicy,
+          typename Array1,
+          typename Array2,
+          typename Array3>
+void dotc(execute_compensated<ExecutionPolicy>& exec,
+          const Array1& x,
+          const Array2& y,
+                Array3& result)
+{
+    result[0] = dotc(exec, x, y);
+}
+
+template <template <typename> class ExecutionPolicy,
+          typename Array1,
+          typename Array2>
+void nrm2(execute_compensated<ExecutionPolicy>& exec,
+          const Array1& x,
+                Array2& result)
+{
+    result[0] = nrm2(exec, x);
+}
+
+} // end namespace compensated
+} // end namespace detail
+} // end namespace system
+} // end namespace cusp
@@ -0,0 +1,52 @@
+/*
+ *  Copyright 2008-2014 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#pragma once
+
+/*! \file cusp/system/detail/compensated/execution_policy.h
+ *  \brief Execution policy adaptor selecting accurate BLAS-1 reductions.
+ */
+
+#include <cusp/detail/config.h>
+
+namespace cusp
+{
+namespace system
+{
+namespace detail
+{
+namespace compensated
+{
+
+// Runs every algorithm on the system of ExecutionPolicy, but cusp::blas::dot,
+// dotc and nrm2 accumulate float data in double precision and add the
+// partial sums with an error-free transformation. The policy is obtained
+// from the compensated() member of a system's par, e.g.
+// cusp::cuda::par.compensated() or cusp::device_memory().compensated().
+template <template <typename> class ExecutionPolicy>
+class execute_compensated
+  : public ExecutionPolicy< execute_compensated<ExecutionPolicy> >
+{
+  public:
+
+    __host__ __device__
+    execute_compensated(void) {}
+};
+
+} // end namespace compensated
+} // end namespace detail
+} // end namespace system
+} // end namespace cusp
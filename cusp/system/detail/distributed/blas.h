@@ -0,0 +1,314 @@
+/*
+ *  Copyright 2008-2014 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#pragma once
+
+#include <cusp/detail/config.h>
+
+#include <cusp/complex.h>
+#include <cusp/functional.h>
+#include <cusp/verify.h>
+
+#include <cusp/distributed/detail/mpi.h>
+#include <cusp/system/detail/distributed/execution_policy.h>
+#include <cusp/system/detail/generic/blas.h>
+
+#include <thrust/functional.h>
+#include <thrust/transform_reduce.h>
+#include <thrust/tuple.h>
+#include <thrust/iterator/zip_iterator.h>
+
+#include <cmath>
+#include <cstring>
+
+namespace cusp
+{
+namespace system
+{
+namespace detail
+{
+namespace distributed
+{
+
+// Each reduction is evaluated over the local rows by the generic
+// implementation on the system of the policy and the partial results are
+// then summed over the communicator. Norms are combined as sums of
+// squares, so the global value is exact up to the local rounding.
+
+template <template <typename> class ExecutionPolicy,
+          typename Array1,
+          typename Array2>
+typename Array1::value_type
+dot(execute_distributed<ExecutionPolicy>& exec,
+    const Array1& x,
+    const Array2& y)
+{
+    typename Array1::value_type result = cusp::system::detail::generic::blas::dot(exec, x, y);
+
+    cusp::distributed::detail::allreduce_sum(exec.communicator(), &result, 1);
+
+    return result;
+}
+
+template <template <typename> class ExecutionPolicy,
+          typename Array1,
+          typename Array2>
+typename Array1::value_type
+dotc(execute_distributed<ExecutionPolicy>& exec,
+     const Array1& x,
+     const Array2& y)
+{
+    typename Array1::value_type result = cusp::system::detail::generic::blas::dotc(exec, x, y);
+
+    cusp::distributed::detail::allreduce_sum(exec.communicator(), &result, 1);
+
+    return result;
+}
+
+template <template <typename> class ExecutionPolicy,
+          typename Array>
+typename cusp::norm_type<typename Array::value_type>::type
+nrm2(execute_distributed<ExecutionPolicy>& exec,
+     const Array& x)
+{
+    typedef typename Array::value_type                ValueType;
+    typedef typename cusp::norm_type<ValueType>::type NormType;
+
+    NormType result = thrust::transform_reduce(exec, x.begin(), x.end(),
+                                               cusp::abs_squared_functor<ValueType>(),
+                                               NormType(0),
+                                               thrust::plus<NormType>());
+
+    cusp::distributed::detail::allreduce_sum(exec.communicator(), &result, 1);
+
+    return std::sqrt(result);
+}
+
+template <template <typename> class ExecutionPolicy,
+          typename Array>
+typename cusp::norm_type<typename Array::value_type>::type
+asum(execute_distributed<ExecutionPolicy>& exec,
+     const Array& x)
+{
+    typename cusp::norm_type<typename Array::value_type>::type result =
+      cusp::system::detail::generic::blas::asum(exec, x);
+
+    cusp::distributed::detail::allreduce_sum(exec.communicator(), &result, 1);
+
+    return result;
+}
+
+template <template <typename> class ExecutionPolicy,
+          typename Array>
+typename cusp::norm_type<typename Array::value_type>::type
+nrmmax(execute_distributed<ExecutionPolicy>& exec,
+       const Array& x)
+{
+    typedef typename Array::value_type                ValueType;
+    typedef typename cusp::norm_type<ValueType>::type NormType;
+
+    NormType result = thrust::transform_reduce(exec, x.begin(), x.end(),
+                                               cusp::abs_functor<ValueType>(),
+                                               NormType(0),
+                                               thrust::maximum<NormType>());
+
+    return cusp::distributed::detail::allreduce_max(exec.communicator(), result);
+}
+
+// the index of the largest magnitude among all entries counted in rank
+// order, the first occurrence wins like in the serial version
+template <template <typename> class ExecutionPolicy,
+          typename Array>
+int amax(execute_distributed<ExecutionPolicy>& exec,
+         const Array& x)
+{
+    typedef typename Array::value_type                ValueType;
+    typedef typename cusp::norm_type<ValueType>::type NormType;
+
+    const size_t offset = cusp::distributed::detail::exclusive_offset(exec.communicator(), x.size());
+
+    int      index = 0;
+    NormType value = NormType(-1);
+
+    if (x.size() > 0)
+    {
+        index = cusp::system::detail::generic::blas::amax(exec, x);
+        value = cusp::abs(ValueType(x[index]));
+    }
+
+    return cusp::distributed::detail::allreduce_maxloc(exec.communicator(), value, int(offset) + index);
+}
+
+// the forms writing into an array store the global value, they take
+// precedence over the asynchronous device versions of the base system
+template <template <typename> class ExecutionPolicy,
+          typename Array1,
+          typename Array2,
+          typename Array3>
+void dot(execute_distributed<ExecutionPolicy>& exec,
+         const Array1& x,
+         const Array2& y,
+               Array3& result)
+{
+    result[0] = dot(exec, x, y);
+}
+
+template <template <typename> class ExecutionPolicy,
+          typename Array1,
+          typename Array2,
+          typename Array3>
+void dotc(execute_distributed<ExecutionPolicy>& exec,
+          const Array1& x,
+          const Array2& y,
+                Array3& result)
+{
+    result[0] = dotc(exec, x, y);
+}
+
+template <template <typename> class ExecutionPolicy,
+          typename Array1,
+          typename Array2>
+void nrm2(execute_distributed<ExecutionPolicy>& exec,
+          const Array1& x,
+                Array2& result)
+{
+    result[0] = nrm2(exec, x);
+}
+
+// the blocked products of a vector with the rows of Y owned by this rank
+// are summed in a single message
+template <template <typename> class ExecutionPolicy,
+          typename Array1,
+          typename Array2d,
+          typename Array2>
+void dots(execute_distributed<ExecutionPolicy>& exec,
+          const Array1& x,
+          const Array2d& Y,
+                Array2& results)
+{
+    cusp::system::detail::generic::blas::dots(exec, x, Y, results);
+
+    cusp::distributed::detail::allreduce_sum(exec.communicator(), results);
+}
+
+template <template <typename> class ExecutionPolicy,
+          typename Array1,
+          typename Array2d,
+          typename Array2>
+void dotcs(execute_distributed<ExecutionPolicy>& exec,
+           const Array1& x,
+           const Array2d& Y,
+                 Array2& results)
+{
+    cusp::system::detail::generic::blas::dotcs(exec, x, Y, results);
+
+    cusp::distributed::detail::allreduce_sum(exec.communicator(), results);
+}
+
+// the inner product and the squared norm travel in the same message
+template <template <typename> class ExecutionPolicy,
+          typename Array1,
+          typename Array2>
+thrust::tuple<typename Array1::value_type,
+              typename cusp::norm_type<typename Array1::value_type>::type>
+dotc_nrm2(execute_distributed<ExecutionPolicy>& exec,
+          const Array1& x,
+          const Array2& y)
+{
+    typedef typename Array1::value_type               ValueType;
+    typedef typename cusp::norm_type<ValueType>::type NormType;
+
+    cusp::assert_same_dimensions(x, y);
+
+    thrust::tuple<ValueType,NormType> init(ValueType(0), NormType(0));
+
+    thrust::tuple<ValueType,NormType> local =
+        thrust::transform_reduce(exec,
+                                 thrust::make_zip_iterator(thrust::make_tuple(x.begin(), y.begin())),
+                                 thrust::make_zip_iterator(thrust::make_tuple(x.end(),   y.end())),
+                                 cusp::system::detail::generic::blas::DOTC_NRM2<ValueType,NormType>(),
+                                 init,
+                                 cusp::system::detail::generic::blas::DOTC_NRM2_PLUS<ValueType,NormType>());
+
+    // pack the squared norm behind the components of the inner product
+    const size_t n = sizeof(ValueType) / sizeof(NormType);
+
+    ValueType result = thrust::get<0>(local);
+    NormType  sums[3];
+
+    std::memcpy(sums, &result, sizeof(ValueType));
+    sums[n] = thrust::get<1>(local);
+
+    cusp::distributed::detail::allreduce_sum(exec.communicator(), sums, n + 1);
+
+    std::memcpy(&result, sums, sizeof(ValueType));
+
+    return thrust::make_tuple(result, NormType(std::sqrt(sums[n])));
+}
+
+template <template <typename> class ExecutionPolicy,
+          typename Array1,
+          typename Array2,
+          typename Array3,
+          typename Array4,
+          typename ScalarType1,
+          typename ScalarType2>
+typename Array4::value_type
+axpy_axpy_dotc(execute_distributed<ExecutionPolicy>& exec,
+               const Array1& x1,
+                     Array2& y1,
+               const ScalarType1 alpha1,
+               const Array3& x2,
+                     Array4& y2,
+               const ScalarType2 alpha2)
+{
+    typename Array4::value_type result =
+      cusp::system::detail::generic::blas::axpy_axpy_dotc(exec, x1, y1, alpha1, x2, y2, alpha2);
+
+    cusp::distributed::detail::allreduce_sum(exec.communicator(), &result, 1);
+
+    return result;
+}
+
+// partial results of the fused reductions of the solvers
+template <template <typename> class ExecutionPolicy,
+          typename Array>
+void allreduce(execute_distributed<ExecutionPolicy>& exec,
+               Array& values)
+{
+    cusp::distributed::detail::allreduce_sum(exec.communicator(), values);
+}
+
+template <template <typename> class ExecutionPolicy,
+          typename ValueType>
+void allreduce_begin(execute_distributed<ExecutionPolicy>& exec,
+                     ValueType* values,
+                     const size_t n)
+{
+    cusp::distributed::detail::wait(exec.request());
+    cusp::distributed::detail::iallreduce_sum(exec.communicator(), values, n, exec.request());
+}
+
+template <template <typename> class ExecutionPolicy>
+void allreduce_end(execute_distributed<ExecutionPolicy>& exec)
+{
+    cusp::distributed::detail::wait(exec.request());
+}
+
+} // end namespace distributed
+} // end namespace detail
+} // end namespace system
+} // end namespace cusp
@@ -0,0 +1,72 @@
+/*
+ *  Copyright 2008-2014 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#pragma once
+
+/*! \file cusp/system/detail/distributed/execution_policy.h
+ *  \brief Execution policy adaptor summing BLAS-1 reductions over MPI ranks.
+ */
+
+#include <cusp/detail/config.h>
+
+#include <mpi.h>
+
+namespace cusp
+{
+namespace system
+{
+namespace detail
+{
+namespace distributed
+{
+
+// Runs every algorithm on the system of ExecutionPolicy over the rows owned
+// by this rank, but the results of cusp::blas reductions such as dot, dotc,
+// nrm2 and dotcs are combined over all ranks of the communicator, so every
+// rank observes the global values, and amax returns the global index. The
+// policy is obtained from cusp::distributed::host_par(comm) or
+// cusp::distributed::device_par(comm).
+template <template <typename> class ExecutionPolicy>
+class execute_distributed
+  : public ExecutionPolicy< execute_distributed<ExecutionPolicy> >
+{
+  public:
+
+    explicit execute_distributed(MPI_Comm comm)
+      : m_comm(comm), m_request(MPI_REQUEST_NULL) {}
+
+    MPI_Comm communicator(void) const
+    {
+        return m_comm;
+    }
+
+    // reduction started by cusp::blas::allreduce_begin and completed by
+    // cusp::blas::allreduce_end
+    MPI_Request& request(void)
+    {
+        return m_request;
+    }
+
+  private:
+
+    MPI_Comm    m_comm;
+    MPI_Request m_request;
+};
+
+} // end namespace distributed
+} // end namespace detail
+} // end namespace system
+} // end namespace cusp
@@ -0,0 +1,75 @@
+/*
+ *  Copyright 2008-2014 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+
+#pragma once
+
+#include <cusp/detail/config.h>
+
+#include <cusp/analyze.h>
+#include <cusp/detail/execution_policy.h>
+#include <cusp/detail/format.h>
+
+namespace cusp
+{
+namespace system
+{
+namespace detail
+{
+namespace generic
+{
+
+template <typename DerivedPolicy,
+          typename ArrayType1, typename ArrayType2, typename ArrayType3>
+cusp::matrix_profile
+analyze_structure(thrust::execution_policy<DerivedPolicy>& exec,
+                  const size_t num_rows, const size_t num_cols,
+                  const ArrayType1& row_offsets, const ArrayType2& row_indices, const ArrayType3& column_indices);
+
+template <typename DerivedPolicy, typename MatrixType>
+cusp::matrix_profile
+analyze(thrust::execution_policy<DerivedPolicy>& exec,
+        const MatrixType& A,
+        cusp::coo_format);
+
+template <typename DerivedPolicy, typename MatrixType>
+cusp::matrix_profile
+analyze(thrust::execution_policy<DerivedPolicy>& exec,
+        const MatrixType& A,
+        cusp::csr_format);
+
+template <typename DerivedPolicy, typename MatrixType, typename Format>
+cusp::matrix_profile
+analyze(thrust::execution_policy<DerivedPolicy>& exec,
+        const MatrixType& A,
+        Format);
+
+template <typename DerivedPolicy, typename MatrixType>
+cusp::matrix_profile
+analyze(thrust::execution_policy<DerivedPolicy>& exec,
+        const MatrixType& A);
+
+template <typename DerivedPolicy>
+cusp::matrix_storage
+predict_storage(thrust::execution_policy<DerivedPolicy>& exec,
+                const cusp::matrix_profile& profile);
+
+} // end namespace generic
+} // end namespace detail
+} // end namespace system
+} // end namespace cusp
+
+#include <cusp/system/detail/generic/analyze.inl>
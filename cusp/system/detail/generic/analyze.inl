@@ -0,0 +1,168 @@
+/*
+ *  Copyright 2008-2014 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+
+#include <cusp/analyze.h>
+#include <cusp/convert.h>
+#include <cusp/format_utils.h>
+#include <cusp/functional.h>
+
+#include <cusp/detail/format.h>
+#include <cusp/detail/temporary_array.h>
+#include <cusp/detail/type_traits.h>
+
+#include <thrust/functional.h>
+#include <thrust/reduce.h>
+#include <thrust/transform.h>
+#include <thrust/transform_reduce.h>
+
+#include <algorithm>
+#include <cmath>
+
+namespace cusp
+{
+namespace system
+{
+namespace detail
+{
+namespace generic
+{
+
+template <typename DerivedPolicy,
+          typename ArrayType1, typename ArrayType2, typename ArrayType3>
+cusp::matrix_profile
+analyze_structure(thrust::execution_policy<DerivedPolicy>& exec,
+                  const size_t num_rows, const size_t num_cols,
+                  const ArrayType1& row_offsets, const ArrayType2& row_indices, const ArrayType3& column_indices)
+{
+    typedef typename ArrayType1::value_type IndexType;
+
+    cusp::matrix_profile profile;
+
+    profile.num_rows    = num_rows;
+    profile.num_cols    = num_cols;
+    profile.num_entries = column_indices.size();
+
+    if(num_rows == 0)
+        return profile;
+
+    // distribution of nnz per row
+    cusp::detail::temporary_array<IndexType, DerivedPolicy> entries_per_row(exec, num_rows);
+    thrust::transform(exec,
+                      row_offsets.begin() + 1, row_offsets.end(),
+                      row_offsets.begin(),
+                      entries_per_row.begin(),
+                      thrust::minus<IndexType>());
+
+    profile.min_entries_per_row =
+        thrust::reduce(exec, entries_per_row.begin(), entries_per_row.end(),
+                       IndexType(profile.num_entries), thrust::minimum<IndexType>());
+    profile.max_entries_per_row =
+        thrust::reduce(exec, entries_per_row.begin(), entries_per_row.end(),
+                       IndexType(0), thrust::maximum<IndexType>());
+
+    const double sum_of_squares =
+        thrust::transform_reduce(exec, entries_per_row.begin(), entries_per_row.end(),
+                                 cusp::square_functor<double>(), 0.0, thrust::plus<double>());
+
+    const double mean     = double(profile.num_entries) / double(num_rows);
+    const double variance = sum_of_squares / double(num_rows) - mean * mean;
+
+    profile.mean_entries_per_row   = mean;
+    profile.stddev_entries_per_row = std::sqrt(std::max(0.0, variance));
+
+    if(profile.num_entries > 0)
+        profile.num_diagonals = cusp::count_diagonals(exec, num_rows, num_cols, row_indices, column_indices);
+
+    profile.optimal_entries_per_row = cusp::compute_optimal_entries_per_row(exec, row_offsets);
+
+    // values stored per entry, padding included
+    const double num_entries = std::max(1.0, double(profile.num_entries));
+
+    profile.dia_fill_ratio = double(profile.num_diagonals)       * double(num_rows) / num_entries;
+    profile.ell_fill_ratio = double(profile.max_entries_per_row) * double(num_rows) / num_entries;
+
+    return profile;
+}
+
+template <typename DerivedPolicy, typename MatrixType>
+cusp::matrix_profile
+analyze(thrust::execution_policy<DerivedPolicy>& exec,
+        const MatrixType& A,
+        cusp::coo_format)
+{
+    typedef typename MatrixType::index_type IndexType;
+
+    cusp::detail::temporary_array<IndexType, DerivedPolicy> row_offsets(exec, A.num_rows + 1);
+    cusp::indices_to_offsets(exec, A.row_indices, row_offsets);
+
+    return analyze_structure(exec, A.num_rows, A.num_cols, row_offsets, A.row_indices, A.column_indices);
+}
+
+template <typename DerivedPolicy, typename MatrixType>
+cusp::matrix_profile
+analyze(thrust::execution_policy<DerivedPolicy>& exec,
+        const MatrixType& A,
+        cusp::csr_format)
+{
+    typedef typename MatrixType::index_type IndexType;
+
+    cusp::detail::temporary_array<IndexType, DerivedPolicy> row_indices(exec, A.num_entries);
+    cusp::offsets_to_indices(exec, A.row_offsets, row_indices);
+
+    return analyze_structure(exec, A.num_rows, A.num_cols, A.row_offsets, row_indices, A.column_indices);
+}
+
+template <typename DerivedPolicy, typename MatrixType, typename Format>
+cusp::matrix_profile
+analyze(thrust::execution_policy<DerivedPolicy>& exec,
+        const MatrixType& A,
+        Format)
+{
+    // padded formats are analyzed through their explicit entries
+    typename cusp::detail::as_coo_type<MatrixType>::type A_coo;
+
+    cusp::convert(exec, A, A_coo);
+
+    return cusp::analyze(exec, A_coo);
+}
+
+template <typename DerivedPolicy, typename MatrixType>
+cusp::matrix_profile
+analyze(thrust::execution_policy<DerivedPolicy>& exec,
+        const MatrixType& A)
+{
+    typedef typename MatrixType::format Format;
+
+    Format format;
+
+    return analyze(thrust::detail::derived_cast(exec), A, format);
+}
+
+template <typename DerivedPolicy>
+cusp::matrix_storage
+predict_storage(thrust::execution_policy<DerivedPolicy>& exec,
+                const cusp::matrix_profile& profile)
+{
+    // CSR rows are traversed with contiguous loads by the host systems, the
+    // padded formats only add work there
+    return cusp::csr_storage;
+}
+
+} // end namespace generic
+} // end namespace detail
+} // end namespace system
+} // end namespace cusp
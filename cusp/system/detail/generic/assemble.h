@@ -0,0 +1,89 @@
+/*
+ *  Copyright 2008-2014 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#pragma once
+
+#include <cusp/detail/config.h>
+
+#include <cusp/detail/execution_policy.h>
+#include <cusp/detail/format.h>
+
+namespace cusp
+{
+namespace system
+{
+namespace detail
+{
+namespace generic
+{
+
+template <typename DerivedPolicy,
+          typename ArrayType1, typename ArrayType2, typename ArrayType3,
+          typename MatrixType>
+void assemble(thrust::execution_policy<DerivedPolicy>& exec,
+              const size_t num_rows, const size_t num_cols,
+              const ArrayType1& row_indices, const ArrayType2& column_indices, const ArrayType3& values,
+              MatrixType& A,
+              cusp::coo_format);
+
+template <typename DerivedPolicy,
+          typename ArrayType1, typename ArrayType2, typename ArrayType3,
+          typename MatrixType,
+          typename Format>
+void assemble(thrust::execution_policy<DerivedPolicy>& exec,
+              const size_t num_rows, const size_t num_cols,
+              const ArrayType1& row_indices, const ArrayType2& column_indices, const ArrayType3& values,
+              MatrixType& A,
+              Format);
+
+template <typename DerivedPolicy,
+          typename ArrayType1, typename ArrayType2, typename ArrayType3,
+          typename MatrixType>
+void assemble(thrust::execution_policy<DerivedPolicy>& exec,
+              const size_t num_rows, const size_t num_cols,
+              const ArrayType1& row_indices, const ArrayType2& column_indices, const ArrayType3& values,
+              MatrixType& A);
+
+template <typename DerivedPolicy,
+          typename ArrayType1, typename ArrayType2,
+          typename MatrixType, typename ArrayType3>
+void assemble_positions(thrust::execution_policy<DerivedPolicy>& exec,
+                        const ArrayType1& row_indices, const ArrayType2& column_indices,
+                        const MatrixType& A,
+                        ArrayType3& positions);
+
+template <typename DerivedPolicy,
+          typename ArrayType1, typename ArrayType2, typename ArrayType3,
+          typename MatrixType,
+          typename Format>
+void assemble_values(thrust::execution_policy<DerivedPolicy>& exec,
+                     const ArrayType1& row_indices, const ArrayType2& column_indices, const ArrayType3& values,
+                     MatrixType& A,
+                     Format);
+
+template <typename DerivedPolicy,
+          typename ArrayType1, typename ArrayType2, typename ArrayType3,
+          typename MatrixType>
+void assemble_values(thrust::execution_policy<DerivedPolicy>& exec,
+                     const ArrayType1& row_indices, const ArrayType2& column_indices, const ArrayType3& values,
+                     MatrixType& A);
+
+} // end namespace generic
+} // end namespace detail
+} // end namespace system
+} // end namespace cusp
+
+#include <cusp/system/detail/generic/assemble.inl>
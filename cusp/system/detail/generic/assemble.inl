@@ -0,0 +1,349 @@
+/*
+ *  Copyright 2008-2014 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include <cusp/array1d.h>
+#include <cusp/assemble.h>
+#include <cusp/convert.h>
+#include <cusp/coo_matrix.h>
+#include <cusp/sort.h>
+
+#include <cusp/detail/format.h>
+#include <cusp/detail/temporary_array.h>
+#include <cusp/detail/type_traits.h>
+
+#include <cusp/exception.h>
+
+#include <thrust/count.h>
+#include <thrust/fill.h>
+#include <thrust/functional.h>
+#include <thrust/inner_product.h>
+#include <thrust/reduce.h>
+#include <thrust/scatter.h>
+#include <thrust/transform.h>
+#include <thrust/tuple.h>
+
+#include <thrust/iterator/zip_iterator.h>
+
+namespace cusp
+{
+namespace system
+{
+namespace detail
+{
+namespace generic
+{
+
+// functors
+// locates (i,j) among the sorted columns of row i of a csr pattern,
+// returns -1 if the entry is not part of the pattern
+template <typename IndexType>
+struct csr_pattern_position : public thrust::unary_function<IndexType,IndexType>
+{
+    IndexType num_rows;
+    const IndexType * row_offsets;
+    const IndexType * column_indices;
+
+    csr_pattern_position(const IndexType num_rows,
+                         const IndexType * row_offsets,
+                         const IndexType * column_indices)
+        : num_rows(num_rows), row_offsets(row_offsets), column_indices(column_indices) {}
+
+    template <typename Tuple>
+    __host__ __device__
+    IndexType operator()(const Tuple& t) const
+    {
+        const IndexType i = thrust::get<0>(t);
+        const IndexType j = thrust::get<1>(t);
+
+        if(i < IndexType(0) || i >= num_rows)
+            return IndexType(-1);
+
+        IndexType first = row_offsets[i];
+        IndexType last  = row_offsets[i + 1];
+
+        while(first < last)
+        {
+            const IndexType middle = first + (last - first) / 2;
+
+            if(column_indices[middle] < j)
+                first = middle + 1;
+            else
+                last = middle;
+        }
+
+        return (first < row_offsets[i + 1] && column_indices[first] == j) ? first : IndexType(-1);
+    }
+};
+
+// locates (i,j) among the (row,column) sorted entries of a coo pattern,
+// returns -1 if the entry is not part of the pattern
+template <typename IndexType>
+struct coo_pattern_position : public thrust::unary_function<IndexType,IndexType>
+{
+    IndexType num_entries;
+    const IndexType * row_indices;
+    const IndexType * column_indices;
+
+    coo_pattern_position(const IndexType num_entries,
+                         const IndexType * row_indices,
+                         const IndexType * column_indices)
+        : num_entries(num_entries), row_indices(row_indices), column_indices(column_indices) {}
+
+    template <typename Tuple>
+    __host__ __device__
+    IndexType operator()(const Tuple& t) const
+    {
+        const IndexType i = thrust::get<0>(t);
+        const IndexType j = thrust::get<1>(t);
+
+        IndexType first = 0;
+        IndexType last  = num_entries;
+
+        while(first < last)
+        {
+            const IndexType middle = first + (last - first) / 2;
+
+            if(row_indices[middle] < i || (row_indices[middle] == i && column_indices[middle] < j))
+                first = middle + 1;
+            else
+                last = middle;
+        }
+
+        return (first < num_entries && row_indices[first] == i && column_indices[first] == j) ? first : IndexType(-1);
+    }
+};
+
+template <typename DerivedPolicy,
+          typename ArrayType1, typename ArrayType2, typename ArrayType3,
+          typename MatrixType>
+void assemble(thrust::execution_policy<DerivedPolicy>& exec,
+              const size_t num_rows, const size_t num_cols,
+              const ArrayType1& row_indices, const ArrayType2& column_indices, const ArrayType3& values,
+              MatrixType& A,
+              cusp::coo_format)
+{
+    typedef typename MatrixType::index_type IndexType;
+    typedef typename MatrixType::value_type ValueType;
+    typedef thrust::tuple<IndexType,IndexType> IndexTuple;
+
+    const size_t N = row_indices.size();
+
+    if(N == 0)
+    {
+        A.resize(num_rows, num_cols, 0);
+        return;
+    }
+
+    // sort copies of the triplets by (i,j) index
+    cusp::detail::temporary_array<IndexType, DerivedPolicy> rows(exec, row_indices);
+    cusp::detail::temporary_array<IndexType, DerivedPolicy> cols(exec, column_indices);
+    cusp::detail::temporary_array<ValueType, DerivedPolicy> vals(exec, values);
+
+    cusp::sort_by_row_and_column(exec, rows, cols, vals, 0, num_rows, 0, num_cols);
+
+    // compute unique number of nonzeros in the output
+    const size_t num_entries =
+        thrust::inner_product(exec,
+                              thrust::make_zip_iterator(thrust::make_tuple(rows.begin(), cols.begin())),
+                              thrust::make_zip_iterator(thrust::make_tuple(rows.end(),   cols.end())) - 1,
+                              thrust::make_zip_iterator(thrust::make_tuple(rows.begin(), cols.begin())) + 1,
+                              size_t(0),
+                              thrust::plus<size_t>(),
+                              thrust::not_equal_to<IndexTuple>()) + 1;
+
+    // every entry of the output is written below
+    A.resize(num_rows, num_cols, num_entries, cusp::no_init);
+
+    // sum values with the same (i,j) index
+    thrust::reduce_by_key(exec,
+                          thrust::make_zip_iterator(thrust::make_tuple(rows.begin(), cols.begin())),
+                          thrust::make_zip_iterator(thrust::make_tuple(rows.end(),   cols.end())),
+                          vals.begin(),
+                          thrust::make_zip_iterator(thrust::make_tuple(A.row_indices.begin(), A.column_indices.begin())),
+                          A.values.begin(),
+                          thrust::equal_to<IndexTuple>(),
+                          thrust::plus<ValueType>());
+}
+
+template <typename DerivedPolicy,
+          typename ArrayType1, typename ArrayType2, typename ArrayType3,
+          typename MatrixType,
+          typename Format>
+void assemble(thrust::execution_policy<DerivedPolicy>& exec,
+              const size_t num_rows, const size_t num_cols,
+              const ArrayType1& row_indices, const ArrayType2& column_indices, const ArrayType3& values,
+              MatrixType& A,
+              Format)
+{
+    // assemble into a coo_matrix and hand its storage over to A
+    typename cusp::detail::as_coo_type<MatrixType>::type A_coo;
+
+    cusp::assemble(exec, num_rows, num_cols, row_indices, column_indices, values, A_coo);
+
+    cusp::move_convert(exec, A_coo, A);
+}
+
+template <typename DerivedPolicy,
+          typename ArrayType1, typename ArrayType2, typename ArrayType3,
+          typename MatrixType>
+void assemble(thrust::execution_policy<DerivedPolicy>& exec,
+              const size_t num_rows, const size_t num_cols,
+              const ArrayType1& row_indices, const ArrayType2& column_indices, const ArrayType3& values,
+              MatrixType& A)
+{
+    typedef typename MatrixType::format Format;
+
+    Format format;
+
+    assemble(thrust::detail::derived_cast(exec), num_rows, num_cols, row_indices, column_indices, values, A, format);
+}
+
+template <typename DerivedPolicy,
+          typename ArrayType1, typename ArrayType2,
+          typename MatrixType, typename ArrayType3>
+void assemble_positions(thrust::execution_policy<DerivedPolicy>& exec,
+                        const ArrayType1& row_indices, const ArrayType2& column_indices,
+                        const MatrixType& A,
+                        ArrayType3& positions,
+                        cusp::csr_format)
+{
+    typedef typename MatrixType::index_type IndexType;
+
+    const IndexType * row_offsets = thrust::raw_pointer_cast(&A.row_offsets[0]);
+    const IndexType * columns     = A.num_entries == 0 ? NULL : thrust::raw_pointer_cast(&A.column_indices[0]);
+
+    thrust::transform(exec,
+                      thrust::make_zip_iterator(thrust::make_tuple(row_indices.begin(), column_indices.begin())),
+                      thrust::make_zip_iterator(thrust::make_tuple(row_indices.end(),   column_indices.end())),
+                      positions.begin(),
+                      csr_pattern_position<IndexType>(A.num_rows, row_offsets, columns));
+}
+
+template <typename DerivedPolicy,
+          typename ArrayType1, typename ArrayType2,
+          typename MatrixType, typename ArrayType3>
+void assemble_positions(thrust::execution_policy<DerivedPolicy>& exec,
+                        const ArrayType1& row_indices, const ArrayType2& column_indices,
+                        const MatrixType& A,
+                        ArrayType3& positions,
+                        cusp::coo_format)
+{
+    typedef typename MatrixType::index_type IndexType;
+
+    const IndexType * rows    = A.num_entries == 0 ? NULL : thrust::raw_pointer_cast(&A.row_indices[0]);
+    const IndexType * columns = A.num_entries == 0 ? NULL : thrust::raw_pointer_cast(&A.column_indices[0]);
+
+    thrust::transform(exec,
+                      thrust::make_zip_iterator(thrust::make_tuple(row_indices.begin(), column_indices.begin())),
+                      thrust::make_zip_iterator(thrust::make_tuple(row_indices.end(),   column_indices.end())),
+                      positions.begin(),
+                      coo_pattern_position<IndexType>(A.num_entries, rows, columns));
+}
+
+template <typename DerivedPolicy,
+          typename ArrayType1, typename ArrayType2,
+          typename MatrixType, typename ArrayType3,
+          typename Format>
+void assemble_positions(thrust::execution_policy<DerivedPolicy>& exec,
+                        const ArrayType1& row_indices, const ArrayType2& column_indices,
+                        const MatrixType& A,
+                        ArrayType3& positions,
+                        Format)
+{
+    throw cusp::not_implemented_exception("assemble_values requires a coo_matrix or csr_matrix pattern");
+}
+
+// computes the position of every triplet among the entries of the pattern A
+template <typename DerivedPolicy,
+          typename ArrayType1, typename ArrayType2,
+          typename MatrixType, typename ArrayType3>
+void assemble_positions(thrust::execution_policy<DerivedPolicy>& exec,
+                        const ArrayType1& row_indices, const ArrayType2& column_indices,
+                        const MatrixType& A,
+                        ArrayType3& positions)
+{
+    typedef typename MatrixType::index_type IndexType;
+    typedef typename MatrixType::format     Format;
+
+    Format format;
+
+    assemble_positions(exec, row_indices, column_indices, A, positions, format);
+
+    if(thrust::count(exec, positions.begin(), positions.end(), IndexType(-1)) > 0)
+        throw cusp::invalid_input_exception("assemble_values: triplet outside of the sparsity pattern");
+}
+
+// sums the values that share a position with a counting sort, systems with
+// atomic addition override this with a direct scatter
+template <typename DerivedPolicy,
+          typename ArrayType1, typename ArrayType2, typename ArrayType3,
+          typename MatrixType,
+          typename Format>
+void assemble_values(thrust::execution_policy<DerivedPolicy>& exec,
+                     const ArrayType1& row_indices, const ArrayType2& column_indices, const ArrayType3& values,
+                     MatrixType& A,
+                     Format)
+{
+    typedef typename MatrixType::index_type IndexType;
+    typedef typename MatrixType::value_type ValueType;
+
+    const size_t N = row_indices.size();
+
+    cusp::detail::temporary_array<IndexType, DerivedPolicy> positions(exec, N);
+    assemble_positions(exec, row_indices, column_indices, A, positions);
+
+    thrust::fill(exec, A.values.begin(), A.values.end(), ValueType(0));
+
+    if(N == 0)
+        return;
+
+    cusp::detail::temporary_array<ValueType, DerivedPolicy> vals(exec, values);
+    cusp::counting_sort_by_key(exec, positions, vals, IndexType(0), IndexType(A.num_entries));
+
+    cusp::detail::temporary_array<IndexType, DerivedPolicy> unique_positions(exec, N);
+    cusp::detail::temporary_array<ValueType, DerivedPolicy> sums(exec, N);
+
+    const size_t num_unique =
+        thrust::reduce_by_key(exec,
+                              positions.begin(), positions.end(),
+                              vals.begin(),
+                              unique_positions.begin(),
+                              sums.begin()).first - unique_positions.begin();
+
+    thrust::scatter(exec,
+                    sums.begin(), sums.begin() + num_unique,
+                    unique_positions.begin(),
+                    A.values.begin());
+}
+
+template <typename DerivedPolicy,
+          typename ArrayType1, typename ArrayType2, typename ArrayType3,
+          typename MatrixType>
+void assemble_values(thrust::execution_policy<DerivedPolicy>& exec,
+                     const ArrayType1& row_indices, const ArrayType2& column_indices, const ArrayType3& values,
+                     MatrixType& A)
+{
+    typedef typename MatrixType::format Format;
+
+    Format format;
+
+    assemble_values(thrust::detail::derived_cast(exec), row_indices, column_indices, values, A, format);
+}
+
+} // end namespace generic
+} // end namespace detail
+} // end namespace system
+} // end namespace cusp
@@ -21,14 +21,23 @@
 #include <cusp/exception.h>
 #include <cusp/functional.h>
 
+#include <cusp/detail/array2d_format_utils.h>
+#include <cusp/detail/temporary_array.h>
+
 #include <thrust/copy.h>
 #include <thrust/fill.h>
+#include <thrust/for_each.h>
 #include <thrust/functional.h>
+#include <thrust/reduce.h>
 #include <thrust/transform.h>
 #include <thrust/transform_reduce.h>
 #include <thrust/inner_product.h>
+#include <thrust/tuple.h>
 
+#include <thrust/iterator/counting_iterator.h>
+#include <thrust/iterator/discard_iterator.h>
 #include <thrust/iterator/transform_iterator.h>
+#include <thrust/iterator/zip_iterator.h>
 
 #include <cmath>
 
@@ -43,6 +52,135 @@ namespace generic
 namespace blas
 {
 
+// product of x(i) with Y(i,j) for the n-th entry of Y in column major order
+template <typename ValueType, typename Iterator1, typename Iterator2, typename Orientation, typename UnaryFunction>
+struct DOTS : public thrust::unary_function<size_t,ValueType>
+{
+    Iterator1 x;
+    Iterator2 Y;
+    size_t num_rows;
+    size_t pitch;
+    UnaryFunction op;
+
+    DOTS(Iterator1 x, Iterator2 Y, size_t num_rows, size_t pitch, UnaryFunction op)
+        : x(x), Y(Y), num_rows(num_rows), pitch(pitch), op(op) {}
+
+    __host__ __device__
+    ValueType operator()(const size_t n) const
+    {
+        const size_t i = n % num_rows;
+        const size_t j = n / num_rows;
+
+        return op(ValueType(x[i])) * ValueType(Y[cusp::detail::index_of(i, j, pitch, Orientation())]);
+    }
+};
+
+struct DOTS_COLUMN : public thrust::unary_function<size_t,size_t>
+{
+    size_t num_rows;
+
+    DOTS_COLUMN(size_t num_rows)
+        : num_rows(num_rows) {}
+
+    __host__ __device__
+    size_t operator()(const size_t n) const
+    {
+        return n / num_rows;
+    }
+};
+
+// y(i) <- alpha * sum_j A(i,j) x(j) + beta * y(i), one row per thread
+template <typename ValueType, typename Iterator1, typename Iterator2, typename Orientation>
+struct GEMV
+{
+    Iterator1 A;
+    Iterator2 x;
+    size_t num_cols;
+    size_t pitch;
+    ValueType alpha;
+    ValueType beta;
+
+    GEMV(Iterator1 A, Iterator2 x, size_t num_cols, size_t pitch, ValueType alpha, ValueType beta)
+        : A(A), x(x), num_cols(num_cols), pitch(pitch), alpha(alpha), beta(beta) {}
+
+    template <typename Tuple>
+    __host__ __device__
+    void operator()(Tuple t) const
+    {
+        const size_t i = thrust::get<1>(t);
+
+        ValueType sum(0);
+
+        for (size_t j = 0; j < num_cols; j++)
+            sum += ValueType(A[cusp::detail::index_of(i, j, pitch, Orientation())]) * ValueType(x[j]);
+
+        // y is not referenced when beta is zero
+        if (beta == ValueType(0))
+            thrust::get<0>(t) = alpha * sum;
+        else
+            thrust::get<0>(t) = alpha * sum + beta * ValueType(thrust::get<0>(t));
+    }
+};
+
+template <typename ValueType, typename NormType>
+struct DOTC_NRM2 : public thrust::unary_function< thrust::tuple<ValueType,ValueType>, thrust::tuple<ValueType,NormType> >
+{
+    template <typename Tuple>
+    __host__ __device__
+    thrust::tuple<ValueType,NormType> operator()(const Tuple& t) const
+    {
+        const ValueType x = thrust::get<0>(t);
+        const ValueType y = thrust::get<1>(t);
+
+        return thrust::make_tuple(cusp::conj_functor<ValueType>()(x) * y, cusp::abs_squared_functor<ValueType>()(x));
+    }
+};
+
+template <typename ValueType, typename NormType>
+struct DOTC_NRM2_PLUS : public thrust::binary_function< thrust::tuple<ValueType,NormType>, thrust::tuple<ValueType,NormType>, thrust::tuple<ValueType,NormType> >
+{
+    __host__ __device__
+    thrust::tuple<ValueType,NormType> operator()(const thrust::tuple<ValueType,NormType>& a,
+                                                 const thrust::tuple<ValueType,NormType>& b) const
+    {
+        return thrust::make_tuple(thrust::get<0>(a) + thrust::get<0>(b), thrust::get<1>(a) + thrust::get<1>(b));
+    }
+};
+
+// scale factors read from the first entry of an array when the functor runs
+template <typename Iterator>
+struct SCAL_INDIRECT
+{
+    Iterator alpha;
+
+    SCAL_INDIRECT(Iterator _alpha)
+        : alpha(_alpha) {}
+
+    template <typename T2>
+    __host__ __device__
+    void operator()(T2& x)
+    {
+        x = T2(alpha[0]) * x;
+    }
+};
+
+template <typename ValueType, typename Iterator>
+struct AXPY_INDIRECT
+{
+    Iterator alpha;
+
+    AXPY_INDIRECT(Iterator _alpha)
+        : alpha(_alpha) {}
+
+    template <typename Tuple>
+    __host__ __device__
+    void operator()(Tuple t)
+    {
+        thrust::get<1>(t) = ValueType(alpha[0]) * thrust::get<0>(t) +
+                            thrust::get<1>(t);
+    }
+};
+
 template <typename T>
 struct SCAL
 {
@@ -115,6 +253,49 @@ struct AXPBYPCZ
     }
 };
 
+template <typename T1, typename T2>
+struct AXPY_AXPY
+{
+    T1 alpha1;
+    T2 alpha2;
+
+    AXPY_AXPY(T1 _alpha1, T2 _alpha2)
+        : alpha1(_alpha1), alpha2(_alpha2) {}
+
+    template <typename Tuple>
+    __host__ __device__
+    void operator()(Tuple t)
+    {
+        thrust::get<1>(t) = alpha1 * thrust::get<0>(t) +
+                            thrust::get<1>(t);
+        thrust::get<3>(t) = alpha2 * thrust::get<2>(t) +
+                            thrust::get<3>(t);
+    }
+};
+
+template <typename T1, typename T2>
+struct AXPY_AXPY_DOTC
+{
+    T1 alpha1;
+    T2 alpha2;
+
+    AXPY_AXPY_DOTC(T1 _alpha1, T2 _alpha2)
+        : alpha1(_alpha1), alpha2(_alpha2) {}
+
+    template <typename Tuple>
+    __host__ __device__
+    T2 operator()(Tuple t)
+    {
+        thrust::get<1>(t) = alpha1 * thrust::get<0>(t) +
+                            thrust::get<1>(t);
+
+        T2 y2 = alpha2 * thrust::get<2>(t) + thrust::get<3>(t);
+        thrust::get<3>(t) = y2;
+
+        return cusp::conj(y2) * y2;
+    }
+};
+
 template <typename T>
 struct XMY : public thrust::binary_function<T,T,T>
 {
@@ -194,6 +375,29 @@ void axpy(thrust::execution_policy<DerivedPolicy>& exec,
                      AXPY<ValueType>(alpha));
 }
 
+template <typename DerivedPolicy,
+          typename Array1,
+          typename Array2,
+          typename ScalarType,
+          typename MemorySpace>
+void axpy_indirect(thrust::execution_policy<DerivedPolicy>& exec,
+                   const Array1& x,
+                         Array2& y,
+                   const cusp::array1d<ScalarType,MemorySpace>& alpha)
+{
+    typedef typename Array1::value_type                                      ValueType;
+    typedef typename cusp::array1d<ScalarType,MemorySpace>::const_iterator  Iterator;
+
+    cusp::assert_same_dimensions(x, y);
+
+    size_t N = x.size();
+
+    thrust::for_each(exec,
+                     thrust::make_zip_iterator(thrust::make_tuple(x.begin(), y.begin())),
+                     thrust::make_zip_iterator(thrust::make_tuple(x.begin(), y.begin())) + N,
+                     AXPY_INDIRECT<ValueType,Iterator>(alpha.begin()));
+}
+
 template <typename DerivedPolicy,
           typename Array1,
           typename Array2,
@@ -248,6 +452,65 @@ void axpbypcz(thrust::execution_policy<DerivedPolicy> &exec,
                      AXPBYPCZ<ValueType,ValueType,ValueType>(alpha, beta, gamma));
 }
 
+template <typename DerivedPolicy,
+          typename Array1,
+          typename Array2,
+          typename Array3,
+          typename Array4,
+          typename ScalarType1,
+          typename ScalarType2>
+void axpy_axpy(thrust::execution_policy<DerivedPolicy> &exec,
+               const Array1& x1,
+                     Array2& y1,
+               const ScalarType1 alpha1,
+               const Array3& x2,
+                     Array4& y2,
+               const ScalarType2 alpha2)
+{
+    typedef typename Array2::value_type ValueType1;
+    typedef typename Array4::value_type ValueType2;
+
+    cusp::assert_same_dimensions(x1, y1, x2, y2);
+
+    size_t N = x1.size();
+
+    thrust::for_each(exec,
+                     thrust::make_zip_iterator(thrust::make_tuple(x1.begin(), y1.begin(), x2.begin(), y2.begin())),
+                     thrust::make_zip_iterator(thrust::make_tuple(x1.begin(), y1.begin(), x2.begin(), y2.begin())) + N,
+                     AXPY_AXPY<ValueType1,ValueType2>(alpha1, alpha2));
+}
+
+template <typename DerivedPolicy,
+          typename Array1,
+          typename Array2,
+          typename Array3,
+          typename Array4,
+          typename ScalarType1,
+          typename ScalarType2>
+typename Array4::value_type
+axpy_axpy_dotc(thrust::execution_policy<DerivedPolicy> &exec,
+               const Array1& x1,
+                     Array2& y1,
+               const ScalarType1 alpha1,
+               const Array3& x2,
+                     Array4& y2,
+               const ScalarType2 alpha2)
+{
+    typedef typename Array2::value_type ValueType1;
+    typedef typename Array4::value_type ValueType2;
+
+    cusp::assert_same_dimensions(x1, y1, x2, y2);
+
+    size_t N = x1.size();
+
+    return thrust::transform_reduce(exec,
+                                    thrust::make_zip_iterator(thrust::make_tuple(x1.begin(), y1.begin(), x2.begin(), y2.begin())),
+                                    thrust::make_zip_iterator(thrust::make_tuple(x1.begin(), y1.begin(), x2.begin(), y2.begin())) + N,
+                                    AXPY_AXPY_DOTC<ValueType1,ValueType2>(alpha1, alpha2),
+                                    ValueType2(0),
+                                    thrust::plus<ValueType2>());
+}
+
 template <typename DerivedPolicy,
           typename Array1,
           typename Array2,
@@ -311,6 +574,134 @@ dotc(thrust::execution_policy<DerivedPolicy>& exec,
                                  y.begin(),
                                  OutputType(0));
 }
+// the host systems store the value directly, systems with a separate
+// memory provide their own version that does not wait for the reduction
+template <typename DerivedPolicy,
+          typename Array1,
+          typename Array2,
+          typename Array3>
+void dot(thrust::execution_policy<DerivedPolicy>& exec,
+         const Array1& x,
+         const Array2& y,
+               Array3& result)
+{
+    result[0] = dot(exec, x, y);
+}
+
+template <typename DerivedPolicy,
+          typename Array1,
+          typename Array2,
+          typename Array3>
+void dotc(thrust::execution_policy<DerivedPolicy>& exec,
+          const Array1& x,
+          const Array2& y,
+                Array3& result)
+{
+    result[0] = dotc(exec, x, y);
+}
+
+// reduces the products of every column of Y with x by key, the results are
+// copied out of the temporary array in a single transfer
+template <typename DerivedPolicy,
+          typename Array1,
+          typename Array2d,
+          typename Array2,
+          typename UnaryFunction>
+void dots(thrust::execution_policy<DerivedPolicy>& exec,
+          const Array1& x,
+          const Array2d& Y,
+                Array2& results,
+          UnaryFunction op)
+{
+    typedef typename Array2::value_type                          ValueType;
+    typedef typename Array1::const_iterator                      Iterator1;
+    typedef typename Array2d::values_array_type::const_iterator  Iterator2;
+    typedef typename Array2d::orientation                        Orientation;
+
+    if(x.size() != Y.num_rows)
+        throw cusp::invalid_input_exception("array dimensions do not match");
+
+    results.resize(Y.num_cols);
+
+    if(Y.num_cols == 0)
+        return;
+
+    if(Y.num_rows == 0)
+    {
+        thrust::fill(results.begin(), results.end(), ValueType(0));
+        return;
+    }
+
+    cusp::detail::temporary_array<ValueType, DerivedPolicy> sums(exec, Y.num_cols);
+
+    const size_t N = Y.num_rows * Y.num_cols;
+
+    thrust::reduce_by_key(exec,
+                          thrust::make_transform_iterator(thrust::counting_iterator<size_t>(0), DOTS_COLUMN(Y.num_rows)),
+                          thrust::make_transform_iterator(thrust::counting_iterator<size_t>(N), DOTS_COLUMN(Y.num_rows)),
+                          thrust::make_transform_iterator(thrust::counting_iterator<size_t>(0),
+                                                          DOTS<ValueType,Iterator1,Iterator2,Orientation,UnaryFunction>(x.begin(), Y.values.begin(), Y.num_rows, Y.pitch, op)),
+                          thrust::make_discard_iterator(),
+                          sums.begin());
+
+    thrust::copy(sums.begin(), sums.end(), results.begin());
+}
+
+template <typename DerivedPolicy,
+          typename Array1,
+          typename Array2d,
+          typename Array2>
+void dots(thrust::execution_policy<DerivedPolicy>& exec,
+          const Array1& x,
+          const Array2d& Y,
+                Array2& results)
+{
+    typedef typename Array2::value_type ValueType;
+
+    dots(exec, x, Y, results, thrust::identity<ValueType>());
+}
+
+template <typename DerivedPolicy,
+          typename Array1,
+          typename Array2d,
+          typename Array2>
+void dotcs(thrust::execution_policy<DerivedPolicy>& exec,
+           const Array1& x,
+           const Array2d& Y,
+                 Array2& results)
+{
+    typedef typename Array2::value_type ValueType;
+
+    dots(exec, x, Y, results, cusp::conj_functor<ValueType>());
+}
+
+template <typename DerivedPolicy,
+          typename Array1,
+          typename Array2>
+thrust::tuple<typename Array1::value_type,
+              typename cusp::norm_type<typename Array1::value_type>::type>
+dotc_nrm2(thrust::execution_policy<DerivedPolicy>& exec,
+          const Array1& x,
+          const Array2& y)
+{
+    typedef typename Array1::value_type               ValueType;
+    typedef typename cusp::norm_type<ValueType>::type NormType;
+
+    cusp::assert_same_dimensions(x, y);
+
+    thrust::tuple<ValueType,NormType> init(ValueType(0), NormType(0));
+
+    thrust::tuple<ValueType,NormType> result =
+        thrust::transform_reduce(exec,
+                                 thrust::make_zip_iterator(thrust::make_tuple(x.begin(), y.begin())),
+                                 thrust::make_zip_iterator(thrust::make_tuple(x.end(),   y.end())),
+                                 DOTC_NRM2<ValueType,NormType>(),
+                                 init,
+                                 DOTC_NRM2_PLUS<ValueType,NormType>());
+
+    return thrust::make_tuple(thrust::get<0>(result), NormType(std::sqrt(thrust::get<1>(result))));
+}
+
 
 template <typename DerivedPolicy,
           typename Array,
@@ -339,6 +730,16 @@ nrm2(thrust::execution_policy<DerivedPolicy>& exec,
     return std::sqrt(thrust::transform_reduce(exec, x.begin(), x.end(), unary_op, init, binary_op));
 }
 
+template <typename DerivedPolicy,
+          typename Array1,
+          typename Array2>
+void nrm2(thrust::execution_policy<DerivedPolicy>& exec,
+          const Array1& x,
+                Array2& result)
+{
+    result[0] = nrm2(exec, x);
+}
+
 template <typename DerivedPolicy,
           typename Array,
           typename ScalarType>
@@ -349,6 +750,19 @@ void scal(thrust::execution_policy<DerivedPolicy>& exec,
     thrust::for_each(exec, x.begin(), x.end(), SCAL<ScalarType>(alpha));
 }
 
+template <typename DerivedPolicy,
+          typename Array,
+          typename ScalarType,
+          typename MemorySpace>
+void scal_indirect(thrust::execution_policy<DerivedPolicy>& exec,
+                   Array& x,
+                   const cusp::array1d<ScalarType,MemorySpace>& alpha)
+{
+    typedef typename cusp::array1d<ScalarType,MemorySpace>::const_iterator Iterator;
+
+    thrust::for_each(exec, x.begin(), x.end(), SCAL_INDIRECT<Iterator>(alpha.begin()));
+}
+
 template<typename DerivedPolicy,
          typename Array2d,
          typename Array1d1,
@@ -362,7 +776,19 @@ void gemv(thrust::execution_policy<DerivedPolicy>& exec,
           const ScalarType1 alpha,
           const ScalarType2 beta)
 {
-    throw cusp::not_implemented_exception("CUSP GEMV not implemented");
+    typedef typename Array1d2::value_type                        ValueType;
+    typedef typename Array2d::values_array_type::const_iterator  Iterator1;
+    typedef typename Array1d1::const_iterator                    Iterator2;
+    typedef typename Array2d::orientation                        Orientation;
+
+    if(A.num_cols != x.size() || A.num_rows != y.size())
+        throw cusp::invalid_input_exception("array dimensions do not match");
+
+    thrust::for_each(exec,
+                     thrust::make_zip_iterator(thrust::make_tuple(y.begin(), thrust::counting_iterator<size_t>(0))),
+                     thrust::make_zip_iterator(thrust::make_tuple(y.begin(), thrust::counting_iterator<size_t>(0))) + A.num_rows,
+                     GEMV<ValueType,Iterator1,Iterator2,Orientation>(A.values.begin(), x.begin(), A.num_cols, A.pitch,
+                                                                     ValueType(alpha), ValueType(beta)));
 }
 
 template <typename DerivedPolicy,
@@ -513,6 +939,27 @@ void trsm(thrust::execution_policy<DerivedPolicy>& exec,
     throw cusp::not_implemented_exception("CUSP TRSM not implemented");
 }
 
+// a single process holds all entries, the partial results are final
+template <typename DerivedPolicy,
+          typename Array>
+void allreduce(thrust::execution_policy<DerivedPolicy>& exec,
+               Array& values)
+{
+}
+
+template <typename DerivedPolicy,
+          typename ValueType>
+void allreduce_begin(thrust::execution_policy<DerivedPolicy>& exec,
+                     ValueType* values,
+                     const size_t n)
+{
+}
+
+template <typename DerivedPolicy>
+void allreduce_end(thrust::execution_policy<DerivedPolicy>& exec)
+{
+}
+
 template <typename DerivedPolicy,
           typename Array>
 typename cusp::norm_type<typename Array::value_type>::type
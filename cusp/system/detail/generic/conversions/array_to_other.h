@@ -110,7 +110,7 @@ convert(thrust::execution_policy<DerivedPolicy>& exec,
 {
     size_t N = src.size();
 
-    dst.resize(N, 1, N);
+    dst.resize(N, 1, N, cusp::no_init);
 
     thrust::sequence(exec, dst.row_indices.begin(), dst.row_indices.end());
     thrust::fill(exec, dst.column_indices.begin(), dst.column_indices.end(), 0);
@@ -146,7 +146,7 @@ convert(thrust::execution_policy<DerivedPolicy>& exec,
     PermValueIterator   perm_values_begin(src.values.begin(),  perm_indices_begin);
 
     size_t num_coo_entries = thrust::count_if(exec, src.values.begin(), src.values.end(), _1 != ValueType(0));
-    dst.resize(src.num_rows, src.num_cols, num_coo_entries);
+    dst.resize(src.num_rows, src.num_cols, num_coo_entries, cusp::no_init);
 
     thrust::copy_if(exec,
                     thrust::make_zip_iterator(thrust::make_tuple(row_indices_begin, column_indices_begin, perm_values_begin)),
@@ -0,0 +1,129 @@
+/*
+ *  Copyright 2008-2014 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#pragma once
+
+#include <cusp/bsr_matrix.h>
+#include <cusp/copy.h>
+#include <cusp/format_utils.h>
+#include <cusp/functional.h>
+#include <cusp/sort.h>
+
+#include <cusp/detail/format.h>
+#include <cusp/detail/temporary_array.h>
+
+#include <thrust/copy.h>
+#include <thrust/count.h>
+#include <thrust/tuple.h>
+
+#include <thrust/iterator/counting_iterator.h>
+#include <thrust/iterator/permutation_iterator.h>
+#include <thrust/iterator/transform_iterator.h>
+#include <thrust/iterator/zip_iterator.h>
+
+namespace cusp
+{
+namespace system
+{
+namespace detail
+{
+namespace generic
+{
+
+// maps (storage index, block row or block column) to a row or column index
+template <typename IndexType, size_t BlockRows, size_t BlockCols, bool Row>
+struct bsr_coordinate_functor : public thrust::unary_function<IndexType,IndexType>
+{
+    template<typename Tuple>
+    __host__ __device__
+    IndexType operator()(const Tuple& t) const
+    {
+        IndexType index = thrust::get<0>(t) % IndexType(BlockRows * BlockCols);
+        IndexType block = thrust::get<1>(t);
+
+        return Row ? block * BlockRows + index / BlockCols
+                   : block * BlockCols + index % BlockCols;
+    }
+};
+
+template <typename DerivedPolicy, typename SourceType, typename DestinationType>
+void
+convert(thrust::execution_policy<DerivedPolicy>& exec,
+        const SourceType& src,
+        DestinationType& dst,
+        cusp::bsr_format&,
+        cusp::coo_format&)
+{
+    typedef typename DestinationType::index_type IndexType;
+    typedef typename DestinationType::value_type ValueType;
+
+    const size_t BlockRows = SourceType::block_rows;
+    const size_t BlockCols = SourceType::block_cols;
+
+    // define types used to programatically generate row and column indices
+    typedef cusp::detail::temporary_array<IndexType, DerivedPolicy>                          IndexArray;
+    typedef thrust::counting_iterator<IndexType>                                             IndexIterator;
+    typedef thrust::transform_iterator<cusp::divide_value<IndexType>, IndexIterator>         BlockIndexIterator;
+    typedef typename IndexArray::iterator                                                    BlockRowIterator;
+    typedef typename SourceType::column_indices_array_type::const_iterator                   BlockColumnIterator;
+    typedef thrust::permutation_iterator<BlockRowIterator, BlockIndexIterator>               PermBlockRowIterator;
+    typedef thrust::permutation_iterator<BlockColumnIterator, BlockIndexIterator>            PermBlockColumnIterator;
+    typedef bsr_coordinate_functor<IndexType,BlockRows,BlockCols,true>                       RowFunctor;
+    typedef bsr_coordinate_functor<IndexType,BlockRows,BlockCols,false>                      ColumnFunctor;
+    typedef thrust::zip_iterator< thrust::tuple<IndexIterator,PermBlockRowIterator> >        RowTupleIterator;
+    typedef thrust::zip_iterator< thrust::tuple<IndexIterator,PermBlockColumnIterator> >     ColumnTupleIterator;
+    typedef thrust::transform_iterator<RowFunctor, RowTupleIterator>                         RowIndexIterator;
+    typedef thrust::transform_iterator<ColumnFunctor, ColumnTupleIterator>                   ColumnIndexIterator;
+
+    const size_t num_blocks         = src.column_indices.size();
+    const size_t num_stored_entries = src.values.size();
+
+    // explicit zeros inside the blocks are dropped
+    const size_t num_entries = num_stored_entries -
+        thrust::count(exec, src.values.begin(), src.values.end(), ValueType(0));
+
+    // allocate output storage
+    dst.resize(src.num_rows, src.num_cols, num_entries, cusp::no_init);
+
+    if(num_entries == 0) return;
+
+    // expand block row offsets into block row indices
+    IndexArray block_rows(exec, num_blocks);
+    cusp::offsets_to_indices(exec, src.row_offsets, block_rows);
+
+    BlockIndexIterator  block_indices_begin(IndexIterator(0), cusp::divide_value<IndexType>(BlockRows * BlockCols));
+    RowIndexIterator    row_indices_begin(RowTupleIterator(thrust::make_tuple(IndexIterator(0),
+                                              PermBlockRowIterator(block_rows.begin(), block_indices_begin))), RowFunctor());
+    ColumnIndexIterator column_indices_begin(ColumnTupleIterator(thrust::make_tuple(IndexIterator(0),
+                                              PermBlockColumnIterator(src.column_indices.begin(), block_indices_begin))), ColumnFunctor());
+
+    // copy nonzero entries to COO format
+    thrust::copy_if
+     (exec,
+      thrust::make_zip_iterator(thrust::make_tuple(row_indices_begin, column_indices_begin, src.values.begin())),
+      thrust::make_zip_iterator(thrust::make_tuple(row_indices_begin, column_indices_begin, src.values.begin())) + num_stored_entries,
+      src.values.begin(),
+      thrust::make_zip_iterator(thrust::make_tuple(dst.row_indices.begin(), dst.column_indices.begin(), dst.values.begin())),
+      thrust::placeholders::_1 != ValueType(0));
+
+    // entries of a block row are ordered by block, restore row-major order
+    cusp::sort_by_row_and_column(exec, dst.row_indices, dst.column_indices, dst.values);
+}
+
+} // end namespace generic
+} // end namespace detail
+} // end namespace system
+} // end namespace cusp
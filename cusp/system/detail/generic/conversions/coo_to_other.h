@@ -19,13 +19,16 @@
 
 #include <cusp/copy.h>
 #include <cusp/coo_matrix.h>
+#include <cusp/exception.h>
 #include <cusp/format_utils.h>
+#include <cusp/functional.h>
 
 #include <cusp/blas/blas.h>
 
 #include <cusp/detail/format.h>
 #include <cusp/detail/temporary_array.h>
 
+#include <thrust/copy.h>
 #include <thrust/count.h>
 #include <thrust/gather.h>
 #include <thrust/inner_product.h>
@@ -71,6 +74,18 @@ struct array2d_map_functor : public thrust::unary_function<IndexType,IndexType>
     }
 };
 
+// selects entries (row, column) on or above the diagonal
+template <typename IndexType>
+struct upper_triangle_functor : public thrust::unary_function<IndexType,bool>
+{
+    template<typename Tuple>
+    __host__ __device__
+    bool operator()(const Tuple& t) const
+    {
+        return thrust::get<1>(t) >= thrust::get<0>(t);
+    }
+};
+
 template <typename DerivedPolicy, typename SourceType, typename DestinationType>
 void
 convert(thrust::execution_policy<DerivedPolicy>& exec,
@@ -121,9 +136,14 @@ convert(thrust::execution_policy<DerivedPolicy>& exec,
         cusp::coo_format&,
         cusp::csr_format&)
 {
-    dst.resize(src.num_rows, src.num_cols, src.num_entries);
+    if(src.num_entries == 0)
+    {
+        dst.resize(src.num_rows, src.num_cols, 0);
+        return;
+    }
 
-    if(src.num_entries == 0) return;
+    // every entry of the output is written below
+    dst.resize(src.num_rows, src.num_cols, src.num_entries, cusp::no_init);
 
     cusp::indices_to_offsets(exec, src.row_indices, dst.row_offsets);
     cusp::copy(exec, src.column_indices, dst.column_indices);
@@ -377,6 +397,107 @@ convert(thrust::execution_policy<DerivedPolicy>& exec,
 //                     less_than<size_t>(dst.ell.column_indices.values.size()));
 }
 
+template <typename DerivedPolicy, typename SourceType, typename DestinationType>
+void
+convert(thrust::execution_policy<DerivedPolicy>& exec,
+        const SourceType& src,
+        DestinationType& dst,
+        cusp::coo_format&,
+        cusp::sell_format&)
+{
+    // convert src -> csr_matrix -> dst
+    typename cusp::detail::as_csr_type<SourceType>::type tmp;
+
+    cusp::convert(exec, src, tmp);
+    cusp::convert(exec, tmp, dst);
+}
+
+template <typename DerivedPolicy, typename SourceType, typename DestinationType>
+void
+convert(thrust::execution_policy<DerivedPolicy>& exec,
+        const SourceType& src,
+        DestinationType& dst,
+        cusp::coo_format&,
+        cusp::bsr_format&)
+{
+    // convert src -> csr_matrix -> dst
+    typename cusp::detail::as_csr_type<SourceType>::type tmp;
+
+    cusp::convert(exec, src, tmp);
+    cusp::convert(exec, tmp, dst);
+}
+
+template <typename DerivedPolicy, typename SourceType, typename DestinationType>
+void
+convert(thrust::execution_policy<DerivedPolicy>& exec,
+        const SourceType& src,
+        DestinationType& dst,
+        cusp::coo_format&,
+        cusp::dcsr_format&)
+{
+    // convert src -> csr_matrix -> dst
+    typename cusp::detail::as_csr_type<SourceType>::type tmp;
+
+    cusp::convert(exec, src, tmp);
+    cusp::convert(exec, tmp, dst);
+}
+
+template <typename DerivedPolicy, typename SourceType, typename DestinationType>
+void
+convert(thrust::execution_policy<DerivedPolicy>& exec,
+        const SourceType& src,
+        DestinationType& dst,
+        cusp::coo_format&,
+        cusp::dynamic_csr_format&)
+{
+    // convert src -> csr_matrix -> dst
+    typename cusp::detail::as_csr_type<SourceType>::type tmp;
+
+    cusp::convert(exec, src, tmp);
+    cusp::convert(exec, tmp, dst);
+}
+
+template <typename DerivedPolicy, typename SourceType, typename DestinationType>
+void
+convert(thrust::execution_policy<DerivedPolicy>& exec,
+        const SourceType& src,
+        DestinationType& dst,
+        cusp::coo_format&,
+        cusp::symmetric_format&)
+{
+    typedef typename SourceType::index_type IndexType;
+    typedef typename SourceType::container  CooMatrix;
+
+    if(src.num_rows != src.num_cols)
+        throw cusp::format_conversion_exception("symmetric_matrix must be square");
+
+    // the strictly lower triangle is implied by symmetry
+    const size_t num_upper_entries =
+        thrust::count_if(exec,
+                         thrust::make_zip_iterator(thrust::make_tuple(src.row_indices.begin(), src.column_indices.begin())),
+                         thrust::make_zip_iterator(thrust::make_tuple(src.row_indices.end(),   src.column_indices.end())),
+                         upper_triangle_functor<IndexType>());
+
+    const size_t num_diagonal_entries =
+        thrust::count_if(exec,
+                         thrust::make_zip_iterator(thrust::make_tuple(src.row_indices.begin(), src.column_indices.begin())),
+                         thrust::make_zip_iterator(thrust::make_tuple(src.row_indices.end(),   src.column_indices.end())),
+                         cusp::equal_pair_functor<IndexType>());
+
+    CooMatrix upper(src.num_rows, src.num_cols, num_upper_entries);
+
+    thrust::copy_if(exec,
+                    thrust::make_zip_iterator(thrust::make_tuple(src.row_indices.begin(), src.column_indices.begin(), src.values.begin())),
+                    thrust::make_zip_iterator(thrust::make_tuple(src.row_indices.end(),   src.column_indices.end(),   src.values.end())),
+                    thrust::make_zip_iterator(thrust::make_tuple(src.row_indices.begin(), src.column_indices.begin())),
+                    thrust::make_zip_iterator(thrust::make_tuple(upper.row_indices.begin(), upper.column_indices.begin(), upper.values.begin())),
+                    upper_triangle_functor<IndexType>());
+
+    dst.resize(src.num_rows, 2 * num_upper_entries - num_diagonal_entries, num_upper_entries);
+
+    cusp::convert(exec, upper, dst.upper);
+}
+
 } // end namespace generic
 } // end namespace detail
 } // end namespace system
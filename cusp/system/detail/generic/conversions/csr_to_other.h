@@ -19,25 +19,39 @@
 
 #include <cusp/copy.h>
 #include <cusp/csr_matrix.h>
+#include <cusp/dynamic_csr_matrix.h>
+#include <cusp/exception.h>
 #include <cusp/format_utils.h>
+#include <cusp/functional.h>
 #include <cusp/sort.h>
 
 #include <cusp/blas/blas.h>
 
 #include <cusp/detail/format.h>
 #include <cusp/detail/temporary_array.h>
+#include <cusp/detail/utils.h>
 
+#include <thrust/copy.h>
 #include <thrust/count.h>
+#include <thrust/fill.h>
+#include <thrust/functional.h>
 #include <thrust/gather.h>
 #include <thrust/inner_product.h>
+#include <thrust/reduce.h>
 #include <thrust/replace.h>
 #include <thrust/scan.h>
 #include <thrust/scatter.h>
 #include <thrust/sequence.h>
+#include <thrust/sort.h>
+#include <thrust/transform.h>
 #include <thrust/tuple.h>
+#include <thrust/unique.h>
 
 #include <thrust/iterator/constant_iterator.h>
 #include <thrust/iterator/counting_iterator.h>
+#include <thrust/iterator/discard_iterator.h>
+#include <thrust/iterator/permutation_iterator.h>
+#include <thrust/iterator/transform_iterator.h>
 #include <thrust/iterator/zip_iterator.h>
 
 #include <algorithm>
@@ -52,6 +66,84 @@ namespace detail
 namespace generic
 {
 
+// maps (stored row, rank within row, slice offset) to a SELL storage index
+template <typename IndexType>
+struct sell_index_functor : public thrust::unary_function<IndexType,IndexType>
+{
+    IndexType slice_size;
+
+    sell_index_functor(IndexType slice_size)
+        : slice_size(slice_size) {}
+
+    template<typename Tuple>
+    __host__ __device__
+    IndexType operator()(const Tuple& t) const
+    {
+        IndexType position = thrust::get<0>(t);
+        IndexType rank     = thrust::get<1>(t);
+        IndexType offset   = thrust::get<2>(t);
+
+        return offset + rank * slice_size + position % slice_size;
+    }
+};
+
+// maps (block index, row, column) to a BSR storage index
+template <typename IndexType, size_t BlockRows, size_t BlockCols>
+struct bsr_index_functor : public thrust::unary_function<IndexType,IndexType>
+{
+    template<typename Tuple>
+    __host__ __device__
+    IndexType operator()(const Tuple& t) const
+    {
+        IndexType block = thrust::get<0>(t);
+        IndexType row   = thrust::get<1>(t);
+        IndexType col   = thrust::get<2>(t);
+
+        return block * IndexType(BlockRows * BlockCols) + (row % BlockRows) * BlockCols + (col % BlockCols);
+    }
+};
+
+// flags entries which lie further than max_delta from the diagonal
+template <typename IndexType>
+struct dcsr_overflow_functor : public thrust::unary_function<IndexType,IndexType>
+{
+    IndexType max_delta;
+
+    dcsr_overflow_functor(IndexType max_delta)
+        : max_delta(max_delta) {}
+
+    template<typename Tuple>
+    __host__ __device__
+    IndexType operator()(const Tuple& t) const
+    {
+        IndexType row = thrust::get<0>(t);
+        IndexType col = thrust::get<1>(t);
+
+        return (col > row + max_delta || row > col + max_delta) ? 1 : 0;
+    }
+};
+
+// maps (row, column) to the column offset from the diagonal, entries which
+// cannot be represented are stored with full indices and receive a zero delta
+template <typename IndexType, typename DeltaType>
+struct dcsr_delta_functor : public thrust::unary_function<IndexType,DeltaType>
+{
+    IndexType max_delta;
+
+    dcsr_delta_functor(IndexType max_delta)
+        : max_delta(max_delta) {}
+
+    template<typename Tuple>
+    __host__ __device__
+    DeltaType operator()(const Tuple& t) const
+    {
+        IndexType row = thrust::get<0>(t);
+        IndexType col = thrust::get<1>(t);
+
+        return (col > row + max_delta || row > col + max_delta) ? DeltaType(0) : DeltaType(col - row);
+    }
+};
+
 template <typename DerivedPolicy, typename SourceType, typename DestinationType>
 void
 convert(thrust::execution_policy<DerivedPolicy>& exec,
@@ -60,7 +152,7 @@ convert(thrust::execution_policy<DerivedPolicy>& exec,
         cusp::csr_format&,
         cusp::coo_format&)
 {
-    dst.resize(src.num_rows, src.num_cols, src.num_entries);
+    dst.resize(src.num_rows, src.num_cols, src.num_entries, cusp::no_init);
 
     if(src.num_entries == 0) return;
 
@@ -305,6 +397,390 @@ convert(thrust::execution_policy<DerivedPolicy>& exec,
                        cusp::less_value<size_t>(dst.ell.values.values.size()));
 }
 
+template <typename DerivedPolicy, typename SourceType, typename DestinationType>
+void
+convert(thrust::execution_policy<DerivedPolicy>& exec,
+        const SourceType& src,
+        DestinationType& dst,
+        cusp::csr_format&,
+        cusp::sell_format&)
+{
+    typedef typename DestinationType::index_type   IndexType;
+    typedef typename DestinationType::value_type   ValueType;
+
+    typedef cusp::detail::temporary_array<IndexType, DerivedPolicy> IndexArray;
+
+    // slice_size and sigma are taken from the destination
+    const IndexType slice_size = std::max<IndexType>(1, IndexType(dst.slice_size));
+    const IndexType sigma      = std::max<IndexType>(1, IndexType(dst.sigma));
+    const IndexType num_rows   = src.num_rows;
+    const IndexType num_slices = cusp::detail::divide_into(num_rows, slice_size);
+
+    if(num_rows == 0)
+    {
+        dst.resize(src.num_rows, src.num_cols, 0, 0, slice_size);
+        thrust::fill(exec, dst.slice_offsets.begin(), dst.slice_offsets.end(), IndexType(0));
+        return;
+    }
+
+    // compute the length of each row
+    IndexArray row_lengths(exec, num_rows);
+    thrust::transform(exec,
+                      src.row_offsets.begin() + 1, src.row_offsets.end(),
+                      src.row_offsets.begin(),
+                      row_lengths.begin(),
+                      thrust::minus<IndexType>());
+
+    // sort rows by decreasing length within windows of sigma consecutive rows
+    IndexArray permutation(exec, num_rows);
+    IndexArray keys(row_lengths);
+    thrust::sequence(exec, permutation.begin(), permutation.end());
+    thrust::stable_sort_by_key(exec, keys.begin(), keys.end(), permutation.begin(), thrust::greater<IndexType>());
+
+    if(sigma < num_rows)
+    {
+        thrust::transform(exec, permutation.begin(), permutation.end(), keys.begin(), cusp::divide_value<IndexType>(sigma));
+        thrust::stable_sort_by_key(exec, keys.begin(), keys.end(), permutation.begin());
+    }
+
+    // the width of each slice is the length of its longest row
+    IndexArray slice_widths(exec, num_slices);
+    thrust::reduce_by_key(exec,
+                          thrust::make_transform_iterator(thrust::counting_iterator<IndexType>(0), cusp::divide_value<IndexType>(slice_size)),
+                          thrust::make_transform_iterator(thrust::counting_iterator<IndexType>(num_rows), cusp::divide_value<IndexType>(slice_size)),
+                          thrust::make_permutation_iterator(row_lengths.begin(), permutation.begin()),
+                          thrust::make_discard_iterator(),
+                          slice_widths.begin(),
+                          thrust::equal_to<IndexType>(),
+                          thrust::maximum<IndexType>());
+
+    const size_t num_stored_entries =
+        size_t(slice_size) * thrust::reduce(exec, slice_widths.begin(), slice_widths.end(), size_t(0));
+
+    // allocate output storage
+    dst.resize(src.num_rows, src.num_cols, src.num_entries, num_stored_entries, slice_size);
+
+    thrust::exclusive_scan(exec,
+                           thrust::make_transform_iterator(slice_widths.begin(), cusp::multiplies_value<IndexType>(slice_size)),
+                           thrust::make_transform_iterator(slice_widths.end(),   cusp::multiplies_value<IndexType>(slice_size)),
+                           dst.slice_offsets.begin(),
+                           IndexType(0));
+    dst.slice_offsets[num_slices] = num_stored_entries;
+
+    cusp::copy(exec, permutation, dst.row_permutation);
+
+    // fill output with padding
+    thrust::fill(exec, dst.column_indices.begin(), dst.column_indices.end(), IndexType(-1));
+    thrust::fill(exec, dst.values.begin(),         dst.values.end(),         ValueType(0));
+
+    if(src.num_entries == 0) return;
+
+    // invert the permutation to find the stored position of each row
+    IndexArray positions(exec, num_rows);
+    thrust::scatter(exec,
+                    thrust::counting_iterator<IndexType>(0),
+                    thrust::counting_iterator<IndexType>(num_rows),
+                    permutation.begin(),
+                    positions.begin());
+
+    // expand row offsets into row indices
+    IndexArray row_indices(exec, src.num_entries);
+    cusp::offsets_to_indices(exec, src.row_offsets, row_indices);
+
+    // enumerate the entries within each row, e.g. [0, 1, 2, 0, 1, 2, 3, ...]
+    IndexArray indices(exec, src.num_entries);
+    thrust::exclusive_scan_by_key(exec,
+                                  row_indices.begin(), row_indices.end(),
+                                  thrust::constant_iterator<IndexType>(1),
+                                  indices.begin(),
+                                  IndexType(0));
+
+    // compute the SELL index of each entry
+    thrust::transform(exec,
+                      thrust::make_zip_iterator(thrust::make_tuple(
+                          thrust::make_permutation_iterator(positions.begin(), row_indices.begin()),
+                          indices.begin(),
+                          thrust::make_permutation_iterator(dst.slice_offsets.begin(),
+                              thrust::make_transform_iterator(
+                                  thrust::make_permutation_iterator(positions.begin(), row_indices.begin()),
+                                  cusp::divide_value<IndexType>(slice_size))))),
+                      thrust::make_zip_iterator(thrust::make_tuple(
+                          thrust::make_permutation_iterator(positions.begin(), row_indices.end()),
+                          indices.end(),
+                          thrust::make_permutation_iterator(dst.slice_offsets.begin(),
+                              thrust::make_transform_iterator(
+                                  thrust::make_permutation_iterator(positions.begin(), row_indices.end()),
+                                  cusp::divide_value<IndexType>(slice_size))))),
+                      indices.begin(),
+                      sell_index_functor<IndexType>(slice_size));
+
+    // scatter CSR entries to SELL
+    thrust::scatter(exec,
+                    src.column_indices.begin(), src.column_indices.end(),
+                    indices.begin(),
+                    dst.column_indices.begin());
+    thrust::scatter(exec,
+                    src.values.begin(), src.values.end(),
+                    indices.begin(),
+                    dst.values.begin());
+}
+
+template <typename DerivedPolicy, typename SourceType, typename DestinationType>
+void
+convert(thrust::execution_policy<DerivedPolicy>& exec,
+        const SourceType& src,
+        DestinationType& dst,
+        cusp::csr_format&,
+        cusp::bsr_format&)
+{
+    typedef typename DestinationType::index_type   IndexType;
+    typedef typename DestinationType::value_type   ValueType;
+
+    typedef cusp::detail::temporary_array<IndexType, DerivedPolicy> IndexArray;
+    typedef thrust::tuple<IndexType,IndexType>                       BlockTuple;
+
+    const size_t BlockRows = DestinationType::block_rows;
+    const size_t BlockCols = DestinationType::block_cols;
+
+    if(src.num_rows % BlockRows != 0 || src.num_cols % BlockCols != 0)
+        throw cusp::format_conversion_exception("bsr_matrix dimensions must be multiples of the block size");
+
+    if(src.num_entries == 0)
+    {
+        dst.resize(src.num_rows, src.num_cols, 0);
+        thrust::fill(exec, dst.row_offsets.begin(), dst.row_offsets.end(), IndexType(0));
+        return;
+    }
+
+    // expand row offsets into row indices
+    IndexArray row_indices(exec, src.num_entries);
+    cusp::offsets_to_indices(exec, src.row_offsets, row_indices);
+
+    // compute the block coordinates of every entry and sort by them
+    IndexArray block_rows(exec, src.num_entries);
+    IndexArray block_cols(exec, src.num_entries);
+    IndexArray permutation(exec, src.num_entries);
+    thrust::transform(exec, row_indices.begin(), row_indices.end(), block_rows.begin(), cusp::divide_value<IndexType>(BlockRows));
+    thrust::transform(exec, src.column_indices.begin(), src.column_indices.end(), block_cols.begin(), cusp::divide_value<IndexType>(BlockCols));
+    thrust::sequence(exec, permutation.begin(), permutation.end());
+
+    cusp::sort_by_row_and_column(exec, block_rows, block_cols, permutation);
+
+    // number the blocks by flagging the first entry of every block
+    IndexArray block_indices(exec, src.num_entries);
+    thrust::fill(exec, block_indices.begin(), block_indices.begin() + 1, IndexType(0));
+    thrust::transform(exec,
+                      thrust::make_zip_iterator(thrust::make_tuple(block_rows.begin(), block_cols.begin())) + 1,
+                      thrust::make_zip_iterator(thrust::make_tuple(block_rows.end(),   block_cols.end())),
+                      thrust::make_zip_iterator(thrust::make_tuple(block_rows.begin(), block_cols.begin())),
+                      block_indices.begin() + 1,
+                      thrust::not_equal_to<BlockTuple>());
+
+    const size_t num_blocks = thrust::count(exec, block_indices.begin(), block_indices.end(), IndexType(1)) + 1;
+
+    thrust::inclusive_scan(exec, block_indices.begin(), block_indices.end(), block_indices.begin());
+
+    // allocate output storage
+    dst.resize(src.num_rows, src.num_cols, num_blocks);
+
+    // compute block row offsets and block column indices
+    IndexArray unique_block_rows(exec, num_blocks);
+    thrust::unique_copy(exec,
+                        thrust::make_zip_iterator(thrust::make_tuple(block_rows.begin(), block_cols.begin())),
+                        thrust::make_zip_iterator(thrust::make_tuple(block_rows.end(),   block_cols.end())),
+                        thrust::make_zip_iterator(thrust::make_tuple(unique_block_rows.begin(), dst.column_indices.begin())));
+    cusp::indices_to_offsets(exec, unique_block_rows, dst.row_offsets);
+
+    // scatter CSR entries into the zero-filled blocks
+    thrust::fill(exec, dst.values.begin(), dst.values.end(), ValueType(0));
+    thrust::scatter(exec,
+                    thrust::make_permutation_iterator(src.values.begin(), permutation.begin()),
+                    thrust::make_permutation_iterator(src.values.begin(), permutation.end()),
+                    thrust::make_transform_iterator(
+                        thrust::make_zip_iterator(thrust::make_tuple(
+                            block_indices.begin(),
+                            thrust::make_permutation_iterator(row_indices.begin(), permutation.begin()),
+                            thrust::make_permutation_iterator(src.column_indices.begin(), permutation.begin()))),
+                        bsr_index_functor<IndexType,BlockRows,BlockCols>()),
+                    dst.values.begin());
+}
+
+template <typename DerivedPolicy, typename SourceType, typename DestinationType>
+void
+convert(thrust::execution_policy<DerivedPolicy>& exec,
+        const SourceType& src,
+        DestinationType& dst,
+        cusp::csr_format&,
+        cusp::dcsr_format&)
+{
+    typedef typename DestinationType::index_type IndexType;
+    typedef typename DestinationType::delta_type DeltaType;
+
+    typedef cusp::detail::temporary_array<IndexType, DerivedPolicy>               IndexArray;
+    typedef thrust::transform_iterator<cusp::divide_value<IndexType>,
+                                       typename IndexArray::iterator>             BlockIterator;
+
+    const IndexType rows_per_block = DestinationType::rows_per_block;
+    const IndexType max_delta      = DestinationType::max_delta;
+    const IndexType num_blocks     = cusp::detail::divide_into<IndexType>(src.num_rows, rows_per_block);
+
+    if(src.num_entries == 0)
+    {
+        dst.resize(src.num_rows, src.num_cols, 0, 0);
+        cusp::copy(exec, src.row_offsets, dst.row_offsets);
+        thrust::fill(exec, dst.block_offsets.begin(), dst.block_offsets.end(), IndexType(0));
+        return;
+    }
+
+    IndexArray rows(exec, src.num_entries);
+    cusp::offsets_to_indices(exec, src.row_offsets, rows);
+
+    BlockIterator blocks_begin(rows.begin(), cusp::divide_value<IndexType>(rows_per_block));
+    BlockIterator blocks_end(rows.end(),     cusp::divide_value<IndexType>(rows_per_block));
+
+    // flag entries whose offset from the diagonal overflows a delta
+    IndexArray overflow(exec, src.num_entries);
+    thrust::transform(exec,
+                      thrust::make_zip_iterator(thrust::make_tuple(rows.begin(), src.column_indices.begin())),
+                      thrust::make_zip_iterator(thrust::make_tuple(rows.end(),   src.column_indices.end())),
+                      overflow.begin(),
+                      dcsr_overflow_functor<IndexType>(max_delta));
+
+    // a block uses full indices if any of its entries overflows
+    IndexArray block_keys(exec, num_blocks);
+    IndexArray block_flags(exec, num_blocks);
+    IndexArray block_counts(exec, num_blocks);
+
+    IndexType num_nonempty_blocks =
+        thrust::reduce_by_key(exec,
+                              blocks_begin, blocks_end,
+                              overflow.begin(),
+                              block_keys.begin(),
+                              block_flags.begin(),
+                              thrust::equal_to<IndexType>(),
+                              thrust::maximum<IndexType>()).first - block_keys.begin();
+
+    thrust::reduce_by_key(exec,
+                          blocks_begin, blocks_end,
+                          thrust::constant_iterator<IndexType>(1),
+                          thrust::make_discard_iterator(),
+                          block_counts.begin());
+
+    // number of full indices stored by every block
+    IndexArray full_counts(exec, num_blocks + 1);
+    IndexArray block_full(exec, num_blocks);
+    thrust::fill(exec, full_counts.begin(), full_counts.end(), IndexType(0));
+    thrust::fill(exec, block_full.begin(), block_full.end(), IndexType(0));
+
+    thrust::transform(exec,
+                      block_flags.begin(), block_flags.begin() + num_nonempty_blocks,
+                      block_counts.begin(),
+                      block_counts.begin(),
+                      thrust::multiplies<IndexType>());
+
+    thrust::scatter(exec,
+                    block_counts.begin(), block_counts.begin() + num_nonempty_blocks,
+                    block_keys.begin(),
+                    full_counts.begin());
+
+    thrust::scatter(exec,
+                    block_flags.begin(), block_flags.begin() + num_nonempty_blocks,
+                    block_keys.begin(),
+                    block_full.begin());
+
+    const IndexType num_full_entries = thrust::reduce(exec, full_counts.begin(), full_counts.end());
+
+    // allocate output storage
+    dst.resize(src.num_rows, src.num_cols, src.num_entries, num_full_entries);
+
+    thrust::exclusive_scan(exec, full_counts.begin(), full_counts.end(), dst.block_offsets.begin());
+
+    cusp::copy(exec, src.row_offsets, dst.row_offsets);
+    cusp::copy(exec, src.values,      dst.values);
+
+    thrust::transform(exec,
+                      thrust::make_zip_iterator(thrust::make_tuple(rows.begin(), src.column_indices.begin())),
+                      thrust::make_zip_iterator(thrust::make_tuple(rows.end(),   src.column_indices.end())),
+                      dst.column_deltas.begin(),
+                      dcsr_delta_functor<IndexType,DeltaType>(max_delta));
+
+    // keep the full column indices of blocks which cannot use deltas
+    thrust::copy_if(exec,
+                    src.column_indices.begin(), src.column_indices.end(),
+                    thrust::make_permutation_iterator(block_full.begin(), blocks_begin),
+                    dst.column_indices.begin(),
+                    thrust::placeholders::_1 != IndexType(0));
+}
+
+template <typename DerivedPolicy, typename SourceType, typename DestinationType>
+void
+convert(thrust::execution_policy<DerivedPolicy>& exec,
+        const SourceType& src,
+        DestinationType& dst,
+        cusp::csr_format&,
+        cusp::dynamic_csr_format&)
+{
+    typedef typename DestinationType::index_type IndexType;
+
+    typedef cusp::detail::temporary_array<IndexType, DerivedPolicy> IndexArray;
+
+    // every row receives the free capacity configured in dst
+    IndexArray capacities(exec, src.num_rows);
+    thrust::transform(exec,
+                      src.row_offsets.begin() + 1, src.row_offsets.end(),
+                      src.row_offsets.begin(),
+                      capacities.begin(),
+                      thrust::minus<IndexType>());
+    thrust::transform(exec,
+                      capacities.begin(), capacities.end(),
+                      capacities.begin(),
+                      cusp::detail::dynamic_csr_capacity<IndexType>(dst.slack, dst.min_row_slack));
+
+    const size_t capacity = thrust::reduce(exec, capacities.begin(), capacities.end(), size_t(0));
+
+    // allocate output storage
+    dst.resize(src.num_rows, src.num_cols, src.num_entries, capacity);
+
+    thrust::fill(exec, dst.row_offsets.begin(), dst.row_offsets.begin() + 1, IndexType(0));
+    thrust::inclusive_scan(exec, capacities.begin(), capacities.end(), dst.row_offsets.begin() + 1);
+
+    thrust::transform(exec,
+                      src.row_offsets.begin() + 1, src.row_offsets.end(),
+                      src.row_offsets.begin(),
+                      dst.row_lengths.begin(),
+                      thrust::minus<IndexType>());
+
+    if(src.num_entries == 0) return;
+
+    IndexArray rows(exec, src.num_entries);
+    cusp::offsets_to_indices(exec, src.row_offsets, rows);
+
+    // entries move by the difference of the row offsets
+    IndexArray shifts(exec, src.num_rows);
+    thrust::transform(exec,
+                      dst.row_offsets.begin(), dst.row_offsets.begin() + src.num_rows,
+                      src.row_offsets.begin(),
+                      shifts.begin(),
+                      thrust::minus<IndexType>());
+
+    IndexArray positions(exec, src.num_entries);
+    thrust::transform(exec,
+                      thrust::counting_iterator<IndexType>(0),
+                      thrust::counting_iterator<IndexType>(src.num_entries),
+                      thrust::make_permutation_iterator(shifts.begin(), rows.begin()),
+                      positions.begin(),
+                      thrust::plus<IndexType>());
+
+    thrust::scatter(exec,
+                    src.column_indices.begin(), src.column_indices.end(),
+                    positions.begin(),
+                    dst.column_indices.begin());
+    thrust::scatter(exec,
+                    src.values.begin(), src.values.end(),
+                    positions.begin(),
+                    dst.values.begin());
+}
+
 } // end namespace generic
 } // end namespace detail
 } // end namespace system
@@ -0,0 +1,109 @@
+/*
+ *  Copyright 2008-2014 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#pragma once
+
+#include <cusp/copy.h>
+#include <cusp/dcsr_matrix.h>
+#include <cusp/format_utils.h>
+#include <cusp/functional.h>
+
+#include <cusp/detail/format.h>
+#include <cusp/detail/temporary_array.h>
+#include <cusp/detail/utils.h>
+
+#include <thrust/copy.h>
+#include <thrust/functional.h>
+#include <thrust/scatter.h>
+#include <thrust/transform.h>
+
+#include <thrust/iterator/counting_iterator.h>
+#include <thrust/iterator/permutation_iterator.h>
+#include <thrust/iterator/transform_iterator.h>
+
+namespace cusp
+{
+namespace system
+{
+namespace detail
+{
+namespace generic
+{
+
+template <typename DerivedPolicy, typename SourceType, typename DestinationType>
+void
+convert(thrust::execution_policy<DerivedPolicy>& exec,
+        const SourceType& src,
+        DestinationType& dst,
+        cusp::dcsr_format&,
+        cusp::coo_format&)
+{
+    typedef typename DestinationType::index_type IndexType;
+
+    typedef cusp::detail::temporary_array<IndexType, DerivedPolicy>      IndexArray;
+    typedef thrust::transform_iterator<cusp::divide_value<IndexType>,
+                                       typename DestinationType::row_indices_array_type::iterator> BlockIterator;
+
+    const IndexType rows_per_block   = SourceType::rows_per_block;
+    const IndexType num_blocks       = src.num_blocks();
+    const IndexType num_full_entries = src.column_indices.size();
+
+    // allocate output storage
+    dst.resize(src.num_rows, src.num_cols, src.num_entries, cusp::no_init);
+
+    if(src.num_entries == 0) return;
+
+    cusp::offsets_to_indices(exec, src.row_offsets, dst.row_indices);
+    cusp::copy(exec, src.values, dst.values);
+
+    // column = row + delta
+    thrust::transform(exec,
+                      dst.row_indices.begin(), dst.row_indices.end(),
+                      src.column_deltas.begin(),
+                      dst.column_indices.begin(),
+                      thrust::plus<IndexType>());
+
+    if(num_full_entries == 0) return;
+
+    // blocks storing full indices have a nonzero range in block_offsets
+    IndexArray block_full(exec, num_blocks);
+    thrust::transform(exec,
+                      src.block_offsets.begin() + 1, src.block_offsets.end(),
+                      src.block_offsets.begin(),
+                      block_full.begin(),
+                      thrust::minus<IndexType>());
+
+    BlockIterator blocks_begin(dst.row_indices.begin(), cusp::divide_value<IndexType>(rows_per_block));
+
+    // entries of those blocks are stored contiguously and in order
+    IndexArray positions(exec, num_full_entries);
+    thrust::copy_if(exec,
+                    thrust::counting_iterator<IndexType>(0),
+                    thrust::counting_iterator<IndexType>(src.num_entries),
+                    thrust::make_permutation_iterator(block_full.begin(), blocks_begin),
+                    positions.begin(),
+                    thrust::placeholders::_1 != IndexType(0));
+
+    thrust::scatter(exec,
+                    src.column_indices.begin(), src.column_indices.end(),
+                    positions.begin(),
+                    dst.column_indices.begin());
+}
+
+} // end namespace generic
+} // end namespace detail
+} // end namespace system
+} // end namespace cusp
@@ -80,7 +80,7 @@ convert(thrust::execution_policy<DerivedPolicy>& exec,
     typedef thrust::permutation_iterator<ValueIterator, PermIndexIterator>                                     PermValueIterator;
 
     // allocate output storage
-    dst.resize(src.num_rows, src.num_cols, src.num_entries);
+    dst.resize(src.num_rows, src.num_cols, src.num_entries, cusp::no_init);
 
     if( src.num_entries == 0 ) return;
 
@@ -131,10 +131,14 @@ convert(thrust::execution_policy<DerivedPolicy>& exec,
     typedef thrust::transform_iterator<PermFunctor, IndexIterator>                               PermIndexIterator;
     typedef thrust::permutation_iterator<ValueIterator, PermIndexIterator>                       PermValueIterator;
 
-    // allocate output storage
-    dst.resize(src.num_rows, src.num_cols, src.num_entries);
+    if( src.num_entries == 0 )
+    {
+        dst.resize(src.num_rows, src.num_cols, 0);
+        return;
+    }
 
-    if( src.num_entries == 0 ) return;
+    // allocate output storage, every entry is written below
+    dst.resize(src.num_rows, src.num_cols, src.num_entries, cusp::no_init);
 
     RowIndexIterator row_indices_begin(IndexIterator(0), cusp::divide_value<IndexType>(src.values.num_cols));
 
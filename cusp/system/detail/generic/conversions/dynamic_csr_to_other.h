@@ -0,0 +1,146 @@
+/*
+ *  Copyright 2008-2014 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#pragma once
+
+#include <cusp/dynamic_csr_matrix.h>
+#include <cusp/format_utils.h>
+
+#include <cusp/detail/format.h>
+#include <cusp/detail/temporary_array.h>
+
+#include <thrust/fill.h>
+#include <thrust/functional.h>
+#include <thrust/gather.h>
+#include <thrust/scan.h>
+#include <thrust/transform.h>
+
+#include <thrust/iterator/counting_iterator.h>
+#include <thrust/iterator/permutation_iterator.h>
+
+namespace cusp
+{
+namespace system
+{
+namespace detail
+{
+namespace generic
+{
+
+// computes the offsets of the compacted rows, the row of every entry and
+// the slot of every entry in the storage of src
+template <typename DerivedPolicy, typename MatrixType, typename ArrayType1, typename ArrayType2, typename ArrayType3>
+void dynamic_csr_compact_positions(thrust::execution_policy<DerivedPolicy>& exec,
+                                   const MatrixType& src,
+                                   ArrayType1& row_offsets,
+                                   ArrayType2& rows,
+                                   ArrayType3& positions)
+{
+    typedef typename MatrixType::index_type IndexType;
+
+    typedef cusp::detail::temporary_array<IndexType, DerivedPolicy> IndexArray;
+
+    thrust::fill(exec, row_offsets.begin(), row_offsets.begin() + 1, IndexType(0));
+    thrust::inclusive_scan(exec, src.row_lengths.begin(), src.row_lengths.end(), row_offsets.begin() + 1);
+
+    if(src.num_entries == 0) return;
+
+    cusp::offsets_to_indices(exec, row_offsets, rows);
+
+    // entries move by the difference of the row offsets
+    IndexArray shifts(exec, src.num_rows);
+    thrust::transform(exec,
+                      src.row_offsets.begin(), src.row_offsets.begin() + src.num_rows,
+                      row_offsets.begin(),
+                      shifts.begin(),
+                      thrust::minus<IndexType>());
+
+    thrust::transform(exec,
+                      thrust::counting_iterator<IndexType>(0),
+                      thrust::counting_iterator<IndexType>(src.num_entries),
+                      thrust::make_permutation_iterator(shifts.begin(), rows.begin()),
+                      positions.begin(),
+                      thrust::plus<IndexType>());
+}
+
+template <typename DerivedPolicy, typename SourceType, typename DestinationType>
+void
+convert(thrust::execution_policy<DerivedPolicy>& exec,
+        const SourceType& src,
+        DestinationType& dst,
+        cusp::dynamic_csr_format&,
+        cusp::csr_format&)
+{
+    typedef typename DestinationType::index_type IndexType;
+
+    typedef cusp::detail::temporary_array<IndexType, DerivedPolicy> IndexArray;
+
+    // allocate output storage
+    dst.resize(src.num_rows, src.num_cols, src.num_entries);
+
+    IndexArray rows(exec, src.num_entries);
+    IndexArray positions(exec, src.num_entries);
+
+    dynamic_csr_compact_positions(exec, src, dst.row_offsets, rows, positions);
+
+    if(src.num_entries == 0) return;
+
+    thrust::gather(exec,
+                   positions.begin(), positions.end(),
+                   src.column_indices.begin(),
+                   dst.column_indices.begin());
+    thrust::gather(exec,
+                   positions.begin(), positions.end(),
+                   src.values.begin(),
+                   dst.values.begin());
+}
+
+template <typename DerivedPolicy, typename SourceType, typename DestinationType>
+void
+convert(thrust::execution_policy<DerivedPolicy>& exec,
+        const SourceType& src,
+        DestinationType& dst,
+        cusp::dynamic_csr_format&,
+        cusp::coo_format&)
+{
+    typedef typename DestinationType::index_type IndexType;
+
+    typedef cusp::detail::temporary_array<IndexType, DerivedPolicy> IndexArray;
+
+    // allocate output storage
+    dst.resize(src.num_rows, src.num_cols, src.num_entries);
+
+    IndexArray row_offsets(exec, src.num_rows + 1);
+    IndexArray positions(exec, src.num_entries);
+
+    dynamic_csr_compact_positions(exec, src, row_offsets, dst.row_indices, positions);
+
+    if(src.num_entries == 0) return;
+
+    thrust::gather(exec,
+                   positions.begin(), positions.end(),
+                   src.column_indices.begin(),
+                   dst.column_indices.begin());
+    thrust::gather(exec,
+                   positions.begin(), positions.end(),
+                   src.values.begin(),
+                   dst.values.begin());
+}
+
+} // end namespace generic
+} // end namespace detail
+} // end namespace system
+} // end namespace cusp
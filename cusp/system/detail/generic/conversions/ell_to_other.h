@@ -80,7 +80,7 @@ convert(thrust::execution_policy<DerivedPolicy>& exec,
     PermValueIterator   perm_values_begin(src.values.values.begin(),  perm_indices_begin);
 
     // allocate output storage
-    dst.resize(src.num_rows, src.num_cols, src.num_entries);
+    dst.resize(src.num_rows, src.num_cols, src.num_entries, cusp::no_init);
 
     if(src.num_entries == 0) return;
 
@@ -121,10 +121,14 @@ convert(thrust::execution_policy<DerivedPolicy>& exec,
     PermColumnIndicesIterator   perm_column_indices_begin(src.column_indices.values.begin(),  perm_indices_begin);
     PermValueIterator   perm_values_begin(src.values.values.begin(),  perm_indices_begin);
 
-    // allocate output storage
-    dst.resize(src.num_rows, src.num_cols, src.num_entries);
+    if(src.num_entries == 0)
+    {
+        dst.resize(src.num_rows, src.num_cols, 0);
+        return;
+    }
 
-    if(src.num_entries == 0) return;
+    // allocate output storage, every entry is written below
+    dst.resize(src.num_rows, src.num_cols, src.num_entries, cusp::no_init);
 
     // create temporary row_indices array to capture valid ELL row indices
     cusp::detail::temporary_array<IndexType, DerivedPolicy> row_indices(exec, src.num_entries);
@@ -42,7 +42,7 @@ convert(thrust::execution_policy<DerivedPolicy>& exec,
     typedef typename DestinationType::index_type IndexType;
     typedef typename DestinationType::value_type ValueType;
 
-    dst.resize(src.num_rows, src.num_cols, src.num_entries);
+    dst.resize(src.num_rows, src.num_cols, src.num_entries, cusp::no_init);
 
     dst.row_offsets = cusp::counting_array<IndexType>(src.num_rows + 1);
     dst.column_indices = src.permutation;
@@ -60,7 +60,7 @@ convert(thrust::execution_policy<DerivedPolicy>& exec,
     typedef typename DestinationType::index_type IndexType;
     typedef typename DestinationType::value_type ValueType;
 
-    dst.resize(src.num_rows, src.num_cols, src.num_entries);
+    dst.resize(src.num_rows, src.num_cols, src.num_entries, cusp::no_init);
 
     dst.row_indices = cusp::counting_array<IndexType>(src.num_rows);
     dst.column_indices = src.permutation;
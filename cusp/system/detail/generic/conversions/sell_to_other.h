@@ -0,0 +1,135 @@
+/*
+ *  Copyright 2008-2014 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#pragma once
+
+#include <cusp/copy.h>
+#include <cusp/functional.h>
+#include <cusp/sell_matrix.h>
+#include <cusp/sort.h>
+
+#include <cusp/detail/format.h>
+#include <cusp/detail/temporary_array.h>
+
+#include <thrust/binary_search.h>
+#include <thrust/copy.h>
+#include <thrust/count.h>
+#include <thrust/functional.h>
+#include <thrust/transform.h>
+#include <thrust/tuple.h>
+
+#include <thrust/iterator/counting_iterator.h>
+#include <thrust/iterator/permutation_iterator.h>
+#include <thrust/iterator/transform_iterator.h>
+#include <thrust/iterator/zip_iterator.h>
+
+namespace cusp
+{
+namespace system
+{
+namespace detail
+{
+namespace generic
+{
+
+// maps (storage index, slice index + 1, slice offset) to a stored row,
+// positions past the last row only occur in padding and are clamped
+template <typename IndexType>
+struct sell_position_functor : public thrust::unary_function<IndexType,IndexType>
+{
+    IndexType slice_size;
+    IndexType num_rows;
+
+    sell_position_functor(IndexType slice_size, IndexType num_rows)
+        : slice_size(slice_size), num_rows(num_rows) {}
+
+    template<typename Tuple>
+    __host__ __device__
+    IndexType operator()(const Tuple& t) const
+    {
+        IndexType index  = thrust::get<0>(t);
+        IndexType slice  = thrust::get<1>(t) - 1;
+        IndexType offset = thrust::get<2>(t);
+
+        IndexType position = slice * slice_size + (index - offset) % slice_size;
+
+        return position < num_rows ? position : num_rows - 1;
+    }
+};
+
+template <typename DerivedPolicy, typename SourceType, typename DestinationType>
+void
+convert(thrust::execution_policy<DerivedPolicy>& exec,
+        const SourceType& src,
+        DestinationType& dst,
+        cusp::sell_format&,
+        cusp::coo_format&)
+{
+    typedef typename DestinationType::index_type IndexType;
+
+    const IndexType num_stored_entries = src.values.size();
+
+    const IndexType num_entries = num_stored_entries -
+        thrust::count(exec, src.column_indices.begin(), src.column_indices.end(), IndexType(-1));
+
+    // allocate output storage
+    dst.resize(src.num_rows, src.num_cols, num_entries, cusp::no_init);
+
+    if(num_entries == 0) return;
+
+    // locate the slice containing each stored entry
+    cusp::detail::temporary_array<IndexType, DerivedPolicy> positions(exec, num_stored_entries);
+    thrust::upper_bound(exec,
+                        src.slice_offsets.begin(), src.slice_offsets.end(),
+                        thrust::counting_iterator<IndexType>(0),
+                        thrust::counting_iterator<IndexType>(num_stored_entries),
+                        positions.begin());
+
+    // compute the stored row of each entry
+    thrust::transform(exec,
+                      thrust::make_zip_iterator(thrust::make_tuple(
+                          thrust::counting_iterator<IndexType>(0),
+                          positions.begin(),
+                          thrust::make_permutation_iterator(src.slice_offsets.begin(),
+                              thrust::make_transform_iterator(positions.begin(), cusp::plus_value<IndexType>(-1))))),
+                      thrust::make_zip_iterator(thrust::make_tuple(
+                          thrust::counting_iterator<IndexType>(num_stored_entries),
+                          positions.end(),
+                          thrust::make_permutation_iterator(src.slice_offsets.begin(),
+                              thrust::make_transform_iterator(positions.end(), cusp::plus_value<IndexType>(-1))))),
+                      positions.begin(),
+                      sell_position_functor<IndexType>(src.slice_size, src.num_rows));
+
+    // copy valid entries, mapping stored rows back to their original index
+    thrust::copy_if
+     (exec,
+      thrust::make_zip_iterator(thrust::make_tuple(
+          thrust::make_permutation_iterator(src.row_permutation.begin(), positions.begin()),
+          src.column_indices.begin(), src.values.begin())),
+      thrust::make_zip_iterator(thrust::make_tuple(
+          thrust::make_permutation_iterator(src.row_permutation.begin(), positions.end()),
+          src.column_indices.end(), src.values.end())),
+      src.column_indices.begin(),
+      thrust::make_zip_iterator(thrust::make_tuple(dst.row_indices.begin(), dst.column_indices.begin(), dst.values.begin())),
+      thrust::placeholders::_1 != IndexType(-1));
+
+    cusp::sort_by_row_and_column(exec, dst.row_indices, dst.column_indices, dst.values);
+}
+
+} // end namespace generic
+} // end namespace detail
+} // end namespace system
+} // end namespace cusp
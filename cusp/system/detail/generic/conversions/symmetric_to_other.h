@@ -0,0 +1,77 @@
+/*
+ *  Copyright 2008-2014 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#pragma once
+
+#include <cusp/copy.h>
+#include <cusp/format_utils.h>
+#include <cusp/functional.h>
+#include <cusp/sort.h>
+#include <cusp/symmetric_matrix.h>
+
+#include <cusp/detail/format.h>
+
+#include <thrust/copy.h>
+#include <thrust/tuple.h>
+
+#include <thrust/iterator/zip_iterator.h>
+
+namespace cusp
+{
+namespace system
+{
+namespace detail
+{
+namespace generic
+{
+
+template <typename DerivedPolicy, typename SourceType, typename DestinationType>
+void
+convert(thrust::execution_policy<DerivedPolicy>& exec,
+        const SourceType& src,
+        DestinationType& dst,
+        cusp::symmetric_format&,
+        cusp::coo_format&)
+{
+    typedef typename DestinationType::index_type IndexType;
+
+    const size_t num_upper_entries = src.upper.num_entries;
+
+    // allocate output storage
+    dst.resize(src.num_rows, src.num_cols, src.num_entries, cusp::no_init);
+
+    if(src.num_entries == 0) return;
+
+    // entries on and above the diagonal
+    cusp::offsets_to_indices(exec, src.upper.row_offsets, dst.row_indices);
+    thrust::copy(exec, src.upper.column_indices.begin(), src.upper.column_indices.end(), dst.column_indices.begin());
+    thrust::copy(exec, src.upper.values.begin(),         src.upper.values.end(),         dst.values.begin());
+
+    // mirror the strictly upper triangle into the remaining entries
+    thrust::copy_if(exec,
+                    thrust::make_zip_iterator(thrust::make_tuple(dst.column_indices.begin(), dst.row_indices.begin(), dst.values.begin())),
+                    thrust::make_zip_iterator(thrust::make_tuple(dst.column_indices.begin(), dst.row_indices.begin(), dst.values.begin())) + num_upper_entries,
+                    thrust::make_zip_iterator(thrust::make_tuple(dst.row_indices.begin(), dst.column_indices.begin())),
+                    thrust::make_zip_iterator(thrust::make_tuple(dst.row_indices.begin(), dst.column_indices.begin(), dst.values.begin())) + num_upper_entries,
+                    cusp::not_equal_pair_functor<IndexType>());
+
+    cusp::sort_by_row_and_column(exec, dst.row_indices, dst.column_indices, dst.values);
+}
+
+} // end namespace generic
+} // end namespace detail
+} // end namespace system
+} // end namespace cusp
@@ -20,9 +20,11 @@
 #include <cusp/detail/config.h>
 
 #include <cusp/detail/execution_policy.h>
+#include <cusp/detail/type_traits.h>
 
 namespace cusp
 {
+
 namespace system
 {
 namespace detail
@@ -58,6 +60,29 @@ void convert(thrust::execution_policy<DerivedPolicy> &exec,
              const SourceType& src,
                    DestinationType& dst);
 
+template <typename DerivedPolicy,
+          typename SourceType,
+          typename DestinationType>
+void move_convert(thrust::execution_policy<DerivedPolicy> &exec,
+                  SourceType& src,
+                  DestinationType& dst);
+
+template <typename DerivedPolicy,
+          typename IndexType,
+          typename ValueType,
+          typename MemorySpace>
+void move_convert(thrust::execution_policy<DerivedPolicy> &exec,
+                  cusp::coo_matrix<IndexType,ValueType,MemorySpace>& src,
+                  cusp::csr_matrix<IndexType,ValueType,MemorySpace>& dst);
+
+template <typename DerivedPolicy,
+          typename IndexType,
+          typename ValueType,
+          typename MemorySpace>
+void move_convert(thrust::execution_policy<DerivedPolicy> &exec,
+                  cusp::csr_matrix<IndexType,ValueType,MemorySpace>& src,
+                  cusp::coo_matrix<IndexType,ValueType,MemorySpace>& dst);
+
 } // end namespace generic
 } // end namespace detail
 } // end namespace system
@@ -21,12 +21,17 @@
 #include <cusp/detail/type_traits.h>
 
 #include <cusp/system/detail/generic/conversions/array_to_other.h>
+#include <cusp/system/detail/generic/conversions/bsr_to_other.h>
 #include <cusp/system/detail/generic/conversions/coo_to_other.h>
 #include <cusp/system/detail/generic/conversions/csr_to_other.h>
+#include <cusp/system/detail/generic/conversions/dcsr_to_other.h>
 #include <cusp/system/detail/generic/conversions/dia_to_other.h>
+#include <cusp/system/detail/generic/conversions/dynamic_csr_to_other.h>
 #include <cusp/system/detail/generic/conversions/ell_to_other.h>
 #include <cusp/system/detail/generic/conversions/hyb_to_other.h>
 #include <cusp/system/detail/generic/conversions/permutation_to_other.h>
+#include <cusp/system/detail/generic/conversions/sell_to_other.h>
+#include <cusp/system/detail/generic/conversions/symmetric_to_other.h>
 
 namespace cusp
 {
@@ -85,6 +90,94 @@ void convert(thrust::execution_policy<DerivedPolicy>& exec,
     convert(exec, src, dst, format1, format2);
 }
 
+// without a dedicated path the storage of src is released after converting
+template <typename DerivedPolicy,
+          typename SourceType,
+          typename DestinationType>
+void move_convert(thrust::execution_policy<DerivedPolicy>& exec,
+                  SourceType& src,
+                  DestinationType& dst)
+{
+    cusp::convert(exec, src, dst);
+
+    SourceType empty;
+    src.swap(empty);
+}
+
+template <typename DerivedPolicy,
+          typename IndexType,
+          typename ValueType,
+          typename MemorySpace>
+void move_convert(thrust::execution_policy<DerivedPolicy>& exec,
+                  cusp::coo_matrix<IndexType,ValueType,MemorySpace>& src,
+                  cusp::csr_matrix<IndexType,ValueType,MemorySpace>& dst)
+{
+    typedef cusp::csr_matrix<IndexType,ValueType,MemorySpace> CsrMatrix;
+    typedef cusp::coo_matrix<IndexType,ValueType,MemorySpace> CooMatrix;
+
+    const size_t num_rows    = src.num_rows;
+    const size_t num_cols    = src.num_cols;
+    const size_t num_entries = src.num_entries;
+
+    // release the previous contents of dst first
+    {
+        CsrMatrix empty;
+        dst.swap(empty);
+    }
+
+    typename CsrMatrix::row_offsets_array_type row_offsets(num_rows + 1, cusp::no_init);
+
+    if (num_entries == 0)
+        thrust::fill(exec, row_offsets.begin(), row_offsets.end(), IndexType(0));
+    else
+        cusp::indices_to_offsets(exec, src.row_indices, row_offsets);
+
+    // the column indices and values keep their storage
+    dst.row_offsets.swap(row_offsets);
+    dst.column_indices.swap(src.column_indices);
+    dst.values.swap(src.values);
+    dst.resize(num_rows, num_cols, num_entries);
+
+    CooMatrix empty;
+    src.swap(empty);
+}
+
+template <typename DerivedPolicy,
+          typename IndexType,
+          typename ValueType,
+          typename MemorySpace>
+void move_convert(thrust::execution_policy<DerivedPolicy>& exec,
+                  cusp::csr_matrix<IndexType,ValueType,MemorySpace>& src,
+                  cusp::coo_matrix<IndexType,ValueType,MemorySpace>& dst)
+{
+    typedef cusp::csr_matrix<IndexType,ValueType,MemorySpace> CsrMatrix;
+    typedef cusp::coo_matrix<IndexType,ValueType,MemorySpace> CooMatrix;
+
+    const size_t num_rows    = src.num_rows;
+    const size_t num_cols    = src.num_cols;
+    const size_t num_entries = src.num_entries;
+
+    // release the previous contents of dst first
+    {
+        CooMatrix empty;
+        dst.swap(empty);
+    }
+
+    typename CooMatrix::row_indices_array_type row_indices(num_entries, cusp::no_init);
+
+    if (num_entries > 0)
+        cusp::offsets_to_indices(exec, src.row_offsets, row_indices);
+
+    // the column indices and values keep their storage
+    dst.row_indices.swap(row_indices);
+    dst.column_indices.swap(src.column_indices);
+    dst.values.swap(src.values);
+    dst.resize(num_rows, num_cols, num_entries);
+
+    CsrMatrix empty;
+    src.swap(empty);
+}
+
 } // end namespace generic
 } // end namespace detail
 } // end namespace system
@@ -61,6 +61,36 @@ void copy(thrust::execution_policy<DerivedPolicy>& exec,
           cusp::hyb_format,
           cusp::hyb_format);
 
+template <typename DerivedPolicy, typename T1, typename T2>
+void copy(thrust::execution_policy<DerivedPolicy>& exec,
+          const T1& src, T2& dst,
+          cusp::sell_format,
+          cusp::sell_format);
+
+template <typename DerivedPolicy, typename T1, typename T2>
+void copy(thrust::execution_policy<DerivedPolicy>& exec,
+          const T1& src, T2& dst,
+          cusp::dcsr_format,
+          cusp::dcsr_format);
+
+template <typename DerivedPolicy, typename T1, typename T2>
+void copy(thrust::execution_policy<DerivedPolicy>& exec,
+          const T1& src, T2& dst,
+          cusp::dynamic_csr_format,
+          cusp::dynamic_csr_format);
+
+template <typename DerivedPolicy, typename T1, typename T2>
+void copy(thrust::execution_policy<DerivedPolicy>& exec,
+          const T1& src, T2& dst,
+          cusp::symmetric_format,
+          cusp::symmetric_format);
+
+template <typename DerivedPolicy, typename T1, typename T2>
+void copy(thrust::execution_policy<DerivedPolicy>& exec,
+          const T1& src, T2& dst,
+          cusp::bsr_format,
+          cusp::bsr_format);
+
 template <typename DerivedPolicy, typename T1, typename T2>
 void copy(thrust::execution_policy<DerivedPolicy>& exec,
           const T1& src, T2& dst,
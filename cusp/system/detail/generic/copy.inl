@@ -14,11 +14,15 @@
  *  limitations under the License.
  */
 
+#include <cusp/array1d.h>
+#include <cusp/exception.h>
+
 #include <cusp/detail/array2d_format_utils.h>
 #include <cusp/detail/format.h>
 
 #include <thrust/copy.h>
 #include <thrust/gather.h>
+#include <thrust/iterator/constant_iterator.h>
 #include <thrust/iterator/counting_iterator.h>
 #include <thrust/iterator/transform_iterator.h>
 #include <thrust/detail/type_traits.h>
@@ -52,6 +56,37 @@ void copy(thrust::execution_policy<DerivedPolicy>& exec,
     cusp::copy(exec, src.values,         dst.values);
 }
 
+template <typename DerivedPolicy, typename ArrayType1, typename ArrayType2>
+void copy_values(thrust::execution_policy<DerivedPolicy>& exec,
+                 const ArrayType1& src, ArrayType2& dst,
+                 thrust::detail::false_type)
+{
+    cusp::copy(exec, src, dst);
+}
+
+// the implicit unit values of a csr_pattern_matrix have no storage, only
+// the number of entries is taken over
+template <typename DerivedPolicy, typename ArrayType1, typename ArrayType2>
+void copy_values(thrust::execution_policy<DerivedPolicy>& exec,
+                 const ArrayType1& src, ArrayType2& dst,
+                 thrust::detail::true_type)
+{
+    typedef typename ArrayType2::value_type ValueType;
+
+    dst = cusp::constant_array<ValueType>(src.size(), *dst.begin());
+}
+
+template <typename DerivedPolicy, typename ArrayType1, typename ArrayType2>
+void copy_values(thrust::execution_policy<DerivedPolicy>& exec,
+                 const ArrayType1& src, ArrayType2& dst)
+{
+    typedef typename ArrayType2::value_type ValueType;
+    typedef typename thrust::detail::is_same<typename ArrayType2::iterator,
+                                             thrust::constant_iterator<ValueType> >::type is_constant;
+
+    copy_values(exec, src, dst, is_constant());
+}
+
 template <typename DerivedPolicy, typename T1, typename T2>
 void copy(thrust::execution_policy<DerivedPolicy>& exec,
           const T1& src, T2& dst,
@@ -61,7 +96,7 @@ void copy(thrust::execution_policy<DerivedPolicy>& exec,
     copy_matrix_dimensions(src, dst);
     cusp::copy(exec, src.row_offsets,    dst.row_offsets);
     cusp::copy(exec, src.column_indices, dst.column_indices);
-    cusp::copy(exec, src.values,         dst.values);
+    copy_values(exec, src.values, dst.values);
 }
 
 template <typename DerivedPolicy, typename T1, typename T2>
@@ -97,6 +132,75 @@ void copy(thrust::execution_policy<DerivedPolicy>& exec,
     cusp::copy(exec, src.coo, dst.coo);
 }
 
+template <typename DerivedPolicy, typename T1, typename T2>
+void copy(thrust::execution_policy<DerivedPolicy>& exec,
+          const T1& src, T2& dst,
+          cusp::sell_format,
+          cusp::sell_format)
+{
+    copy_matrix_dimensions(src, dst);
+    dst.slice_size = src.slice_size;
+    dst.sigma      = src.sigma;
+    cusp::copy(exec, src.slice_offsets,   dst.slice_offsets);
+    cusp::copy(exec, src.column_indices,  dst.column_indices);
+    cusp::copy(exec, src.values,          dst.values);
+    cusp::copy(exec, src.row_permutation, dst.row_permutation);
+}
+
+template <typename DerivedPolicy, typename T1, typename T2>
+void copy(thrust::execution_policy<DerivedPolicy>& exec,
+          const T1& src, T2& dst,
+          cusp::dcsr_format,
+          cusp::dcsr_format)
+{
+    copy_matrix_dimensions(src, dst);
+    cusp::copy(exec, src.row_offsets,    dst.row_offsets);
+    cusp::copy(exec, src.block_offsets,  dst.block_offsets);
+    cusp::copy(exec, src.column_deltas,  dst.column_deltas);
+    cusp::copy(exec, src.column_indices, dst.column_indices);
+    cusp::copy(exec, src.values,         dst.values);
+}
+
+template <typename DerivedPolicy, typename T1, typename T2>
+void copy(thrust::execution_policy<DerivedPolicy>& exec,
+          const T1& src, T2& dst,
+          cusp::dynamic_csr_format,
+          cusp::dynamic_csr_format)
+{
+    copy_matrix_dimensions(src, dst);
+    cusp::copy(exec, src.row_offsets,    dst.row_offsets);
+    cusp::copy(exec, src.row_lengths,    dst.row_lengths);
+    cusp::copy(exec, src.column_indices, dst.column_indices);
+    cusp::copy(exec, src.values,         dst.values);
+    dst.slack         = src.slack;
+    dst.min_row_slack = src.min_row_slack;
+}
+
+template <typename DerivedPolicy, typename T1, typename T2>
+void copy(thrust::execution_policy<DerivedPolicy>& exec,
+          const T1& src, T2& dst,
+          cusp::symmetric_format,
+          cusp::symmetric_format)
+{
+    copy_matrix_dimensions(src, dst);
+    cusp::copy(exec, src.upper, dst.upper);
+}
+
+template <typename DerivedPolicy, typename T1, typename T2>
+void copy(thrust::execution_policy<DerivedPolicy>& exec,
+          const T1& src, T2& dst,
+          cusp::bsr_format,
+          cusp::bsr_format)
+{
+    if(T1::block_rows != T2::block_rows || T1::block_cols != T2::block_cols)
+        throw cusp::invalid_input_exception("bsr_matrix block sizes do not match");
+
+    copy_matrix_dimensions(src, dst);
+    cusp::copy(exec, src.row_offsets,    dst.row_offsets);
+    cusp::copy(exec, src.column_indices, dst.column_indices);
+    cusp::copy(exec, src.values,         dst.values);
+}
+
 template <typename DerivedPolicy, typename T1, typename T2>
 void copy(thrust::execution_policy<DerivedPolicy>& exec,
           const T1& src, T2& dst,
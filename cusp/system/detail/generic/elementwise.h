@@ -65,6 +65,20 @@ void elementwise(thrust::execution_policy<DerivedPolicy>& exec,
                  const MatrixType1& A, const MatrixType2& B, MatrixType3& C,
                  BinaryFunction op);
 
+template <typename DerivedPolicy,
+          typename MatrixType1, typename MatrixType2, typename MatrixType3,
+          typename PlanType>
+void add_symbolic(thrust::execution_policy<DerivedPolicy>& exec,
+                  const MatrixType1& A, const MatrixType2& B, MatrixType3& C,
+                  PlanType& plan);
+
+template <typename DerivedPolicy,
+          typename MatrixType1, typename MatrixType2, typename MatrixType3,
+          typename PlanType, typename ScalarType1, typename ScalarType2>
+void add_numeric(thrust::execution_policy<DerivedPolicy>& exec,
+                 const MatrixType1& A, const MatrixType2& B, MatrixType3& C,
+                 const PlanType& plan, const ScalarType1 alpha, const ScalarType2 beta);
+
 } // end namespace generic
 } // end namespace detail
 } // end namespace system
@@ -25,11 +25,20 @@
 #include <cusp/detail/format.h>
 #include <cusp/detail/temporary_array.h>
 
+#include <cusp/exception.h>
+
+#include <thrust/copy.h>
+#include <thrust/fill.h>
 #include <thrust/functional.h>
 #include <thrust/inner_product.h>
 #include <thrust/reduce.h>
+#include <thrust/scan.h>
+#include <thrust/sequence.h>
 #include <thrust/transform.h>
+#include <thrust/unique.h>
 
+#include <thrust/iterator/discard_iterator.h>
+#include <thrust/iterator/transform_iterator.h>
 #include <thrust/iterator/zip_iterator.h>
 
 namespace cusp
@@ -300,6 +309,154 @@ void elementwise(thrust::execution_policy<DerivedPolicy>& exec,
     elementwise(thrust::detail::derived_cast(exec), A, B, C, op, format1, format2, format3);
 }
 
+template <typename IndexType, typename ValueIterator1, typename ValueIterator2, typename ValueType>
+struct add_numeric_functor : public thrust::unary_function<IndexType,ValueType>
+{
+    ValueIterator1 A_values;
+    ValueIterator2 B_values;
+    IndexType      A_num_entries;
+    ValueType      alpha;
+    ValueType      beta;
+
+    add_numeric_functor(ValueIterator1 A_values, ValueIterator2 B_values,
+                        const IndexType A_num_entries,
+                        const ValueType alpha, const ValueType beta)
+        : A_values(A_values), B_values(B_values),
+          A_num_entries(A_num_entries), alpha(alpha), beta(beta) {}
+
+    __host__ __device__
+    ValueType operator()(const IndexType n) const
+    {
+        return n < A_num_entries ? alpha * ValueType(A_values[n])
+                                 : beta  * ValueType(B_values[n - A_num_entries]);
+    }
+};
+
+template <typename DerivedPolicy,
+          typename MatrixType1,
+          typename MatrixType2,
+          typename MatrixType3,
+          typename PlanType>
+void add_symbolic(thrust::execution_policy<DerivedPolicy>& exec,
+                  const MatrixType1& A,
+                  const MatrixType2& B,
+                        MatrixType3& C,
+                        PlanType& plan)
+{
+    typedef typename MatrixType3::index_type   IndexType;
+    typedef typename MatrixType3::value_type   ValueType;
+    typedef typename MatrixType3::memory_space MemorySpace;
+
+    typedef typename MatrixType1::const_coo_view_type CooView1;
+    typedef typename MatrixType2::const_coo_view_type CooView2;
+
+    if(A.num_rows != B.num_rows || A.num_cols != B.num_cols)
+        throw cusp::invalid_input_exception("matrix dimensions do not match");
+
+    CooView1 A_(A);
+    CooView2 B_(B);
+
+    const size_t A_nnz = A.num_entries;
+    const size_t B_nnz = B.num_entries;
+    const size_t num_entries = A_nnz + B_nnz;
+
+    plan.A_num_entries = A_nnz;
+    plan.B_num_entries = B_nnz;
+
+    if (num_entries == 0)
+    {
+        plan.permutation.resize(0);
+        plan.output_keys.resize(0);
+        plan.C_num_entries = 0;
+
+        C.resize(A.num_rows, A.num_cols, 0);
+        return;
+    }
+
+    cusp::detail::temporary_array<IndexType, DerivedPolicy> rows(exec, num_entries);
+    cusp::detail::temporary_array<IndexType, DerivedPolicy> cols(exec, num_entries);
+
+    thrust::copy(exec, A_.row_indices.begin(),    A_.row_indices.end(),    rows.begin());
+    thrust::copy(exec, B_.row_indices.begin(),    B_.row_indices.end(),    rows.begin() + A_nnz);
+    thrust::copy(exec, A_.column_indices.begin(), A_.column_indices.end(), cols.begin());
+    thrust::copy(exec, B_.column_indices.begin(), B_.column_indices.end(), cols.begin() + A_nnz);
+
+    // sort the entries of A and B by (i,j) once and record the resulting order
+    plan.permutation.resize(num_entries);
+    thrust::sequence(exec, plan.permutation.begin(), plan.permutation.end());
+
+    cusp::sort_by_row_and_column(exec, rows, cols, plan.permutation, 0, A.num_rows, 0, A.num_cols);
+
+    // label each entry with the index of its entry in C
+    plan.output_keys.resize(num_entries);
+    plan.output_keys[0] = 0;
+    thrust::transform(exec,
+                      thrust::make_zip_iterator(thrust::make_tuple(rows.begin(), cols.begin())) + 1,
+                      thrust::make_zip_iterator(thrust::make_tuple(rows.end(),   cols.end())),
+                      thrust::make_zip_iterator(thrust::make_tuple(rows.begin(), cols.begin())),
+                      plan.output_keys.begin() + 1,
+                      thrust::not_equal_to< thrust::tuple<IndexType,IndexType> >());
+    thrust::inclusive_scan(exec, plan.output_keys.begin(), plan.output_keys.end(), plan.output_keys.begin());
+
+    const size_t C_nnz = plan.output_keys[num_entries - 1] + 1;
+
+    plan.C_num_entries = C_nnz;
+
+    // extract the pattern of C with explicit zero values
+    cusp::coo_matrix<IndexType,ValueType,MemorySpace> C_(A.num_rows, A.num_cols, C_nnz);
+
+    thrust::unique_copy(exec,
+                        thrust::make_zip_iterator(thrust::make_tuple(rows.begin(), cols.begin())),
+                        thrust::make_zip_iterator(thrust::make_tuple(rows.end(),   cols.end())),
+                        thrust::make_zip_iterator(thrust::make_tuple(C_.row_indices.begin(), C_.column_indices.begin())));
+    thrust::fill(exec, C_.values.begin(), C_.values.end(), ValueType(0));
+
+    cusp::convert(exec, C_, C);
+}
+
+template <typename DerivedPolicy,
+          typename MatrixType1,
+          typename MatrixType2,
+          typename MatrixType3,
+          typename PlanType,
+          typename ScalarType1,
+          typename ScalarType2>
+void add_numeric(thrust::execution_policy<DerivedPolicy>& exec,
+                 const MatrixType1& A,
+                 const MatrixType2& B,
+                       MatrixType3& C,
+                 const PlanType& plan,
+                 const ScalarType1 alpha,
+                 const ScalarType2 beta)
+{
+    typedef typename PlanType::index_type    IndexType;
+    typedef typename MatrixType3::value_type ValueType;
+
+    typedef typename MatrixType1::values_array_type::const_iterator ValueIterator1;
+    typedef typename MatrixType2::values_array_type::const_iterator ValueIterator2;
+    typedef add_numeric_functor<IndexType, ValueIterator1, ValueIterator2, ValueType> Functor;
+
+    if (A.num_entries != plan.A_num_entries ||
+        B.num_entries != plan.B_num_entries ||
+        C.num_entries != plan.C_num_entries)
+        throw cusp::invalid_input_exception("matrix sizes do not match the add plan");
+
+    if (plan.output_keys.size() == 0)
+        return;
+
+    Functor scale(A.values.begin(), B.values.begin(), IndexType(plan.A_num_entries), ValueType(alpha), ValueType(beta));
+
+    // scale the entries in the order recorded by the plan and sum those
+    // contributing to the same entry of C, no sorting is required
+    thrust::reduce_by_key(exec,
+                          plan.output_keys.begin(), plan.output_keys.end(),
+                          thrust::make_transform_iterator(plan.permutation.begin(), scale),
+                          thrust::make_discard_iterator(),
+                          C.values.begin(),
+                          thrust::equal_to<IndexType>(),
+                          thrust::plus<ValueType>());
+}
+
 } // end namespace generic
 } // end namespace detail
 } // end namespace system
@@ -0,0 +1,429 @@
+/*
+ *  Copyright 2008-2014 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#pragma once
+
+#include <cusp/detail/config.h>
+#include <cusp/detail/execution_policy.h>
+#include <cusp/detail/format.h>
+
+#include <cusp/array1d.h>
+#include <cusp/blas/blas.h>
+#include <cusp/convert.h>
+#include <cusp/coo_matrix.h>
+#include <cusp/copy.h>
+#include <cusp/exception.h>
+#include <cusp/format_utils.h>
+#include <cusp/functional.h>
+#include <cusp/sort.h>
+
+#include <thrust/fill.h>
+#include <thrust/for_each.h>
+#include <thrust/functional.h>
+#include <thrust/reduce.h>
+#include <thrust/scatter.h>
+#include <thrust/sequence.h>
+#include <thrust/sort.h>
+#include <thrust/transform.h>
+#include <thrust/transform_reduce.h>
+
+#include <thrust/iterator/counting_iterator.h>
+#include <thrust/iterator/permutation_iterator.h>
+
+#include <algorithm>
+#include <cmath>
+
+namespace cusp
+{
+namespace system
+{
+namespace detail
+{
+namespace generic
+{
+namespace equilibration
+{
+
+// factor of entry (i,j), either side may be missing
+template <typename IndexType, typename ValueType>
+struct entry_scale
+{
+    const ValueType * row_scale;
+    const ValueType * column_scale;
+
+    entry_scale(const ValueType * row_scale, const ValueType * column_scale)
+        : row_scale(row_scale), column_scale(column_scale) {}
+
+    __host__ __device__
+    ValueType operator()(const IndexType i, const IndexType j) const
+    {
+        ValueType s(1);
+
+        if(row_scale)
+            s *= row_scale[i];
+        if(column_scale)
+            s *= column_scale[j];
+
+        return s;
+    }
+};
+
+template <typename IndexType, typename ValueType>
+struct scale_coo_entry
+{
+    const IndexType * row_indices;
+    const IndexType * column_indices;
+    ValueType * values;
+    const entry_scale<IndexType,ValueType> scale;
+
+    scale_coo_entry(const IndexType * row_indices, const IndexType * column_indices,
+                    ValueType * values, const entry_scale<IndexType,ValueType> scale)
+        : row_indices(row_indices), column_indices(column_indices),
+          values(values), scale(scale) {}
+
+    __host__ __device__
+    void operator()(const IndexType n) const
+    {
+        values[n] *= scale(row_indices[n], column_indices[n]);
+    }
+};
+
+template <typename IndexType, typename ValueType>
+struct scale_csr_row
+{
+    const IndexType * row_offsets;
+    const IndexType * column_indices;
+    ValueType * values;
+    const entry_scale<IndexType,ValueType> scale;
+
+    scale_csr_row(const IndexType * row_offsets, const IndexType * column_indices,
+                  ValueType * values, const entry_scale<IndexType,ValueType> scale)
+        : row_offsets(row_offsets), column_indices(column_indices),
+          values(values), scale(scale) {}
+
+    __host__ __device__
+    void operator()(const IndexType i) const
+    {
+        for(IndexType jj = row_offsets[i]; jj < row_offsets[i + 1]; jj++)
+            values[jj] *= scale(i, column_indices[jj]);
+    }
+};
+
+// one slot of the column-major ELL storage, padding is skipped
+template <typename IndexType, typename ValueType>
+struct scale_ell_entry
+{
+    const IndexType * column_indices;
+    ValueType * values;
+    const IndexType pitch;
+    const IndexType num_rows;
+    const IndexType invalid_index;
+    const entry_scale<IndexType,ValueType> scale;
+
+    scale_ell_entry(const IndexType * column_indices, ValueType * values,
+                    const IndexType pitch, const IndexType num_rows,
+                    const IndexType invalid_index, const entry_scale<IndexType,ValueType> scale)
+        : column_indices(column_indices), values(values), pitch(pitch),
+          num_rows(num_rows), invalid_index(invalid_index), scale(scale) {}
+
+    __host__ __device__
+    void operator()(const IndexType t) const
+    {
+        const IndexType i = t % pitch;
+        const IndexType j = column_indices[t];
+
+        if(i < num_rows && j != invalid_index)
+            values[t] *= scale(i, j);
+    }
+};
+
+// one slot of the column-major DIA storage, slots outside the matrix are skipped
+template <typename IndexType, typename ValueType>
+struct scale_dia_entry
+{
+    const IndexType * diagonal_offsets;
+    ValueType * values;
+    const IndexType pitch;
+    const IndexType num_rows;
+    const IndexType num_cols;
+    const entry_scale<IndexType,ValueType> scale;
+
+    scale_dia_entry(const IndexType * diagonal_offsets, ValueType * values,
+                    const IndexType pitch, const IndexType num_rows,
+                    const IndexType num_cols, const entry_scale<IndexType,ValueType> scale)
+        : diagonal_offsets(diagonal_offsets), values(values), pitch(pitch),
+          num_rows(num_rows), num_cols(num_cols), scale(scale) {}
+
+    __host__ __device__
+    void operator()(const IndexType t) const
+    {
+        const IndexType i = t % pitch;
+        const IndexType j = i + diagonal_offsets[t / pitch];
+
+        if(i < num_rows && j >= 0 && j < num_cols)
+            values[t] *= scale(i, j);
+    }
+};
+
+// 1 / sqrt(|x|), or one for a zero
+template <typename ValueType>
+struct inverse_sqrt_magnitude
+{
+    __host__ __device__
+    ValueType operator()(const ValueType x) const
+    {
+        using std::sqrt;
+
+        const ValueType m = x < ValueType(0) ? -x : x;
+
+        return m > ValueType(0) ? ValueType(1) / sqrt(m) : ValueType(1);
+    }
+};
+
+// distance of a nonzero max-norm from one
+template <typename ValueType>
+struct unit_deviation
+{
+    __host__ __device__
+    ValueType operator()(const ValueType x) const
+    {
+        if(x == ValueType(0))
+            return ValueType(0);
+
+        return x > ValueType(1) ? x - ValueType(1) : ValueType(1) - x;
+    }
+};
+
+template <typename DerivedPolicy, typename MatrixType, typename ValueType>
+void scale_entries(thrust::execution_policy<DerivedPolicy>& exec,
+                   MatrixType& A, const ValueType * row_scale, const ValueType * column_scale,
+                   cusp::coo_format)
+{
+    typedef typename MatrixType::index_type IndexType;
+
+    scale_coo_entry<IndexType,ValueType> f(thrust::raw_pointer_cast(&A.row_indices[0]),
+                                           thrust::raw_pointer_cast(&A.column_indices[0]),
+                                           thrust::raw_pointer_cast(&A.values[0]),
+                                           entry_scale<IndexType,ValueType>(row_scale, column_scale));
+
+    thrust::for_each(exec,
+                     thrust::counting_iterator<IndexType>(0),
+                     thrust::counting_iterator<IndexType>(A.num_entries),
+                     f);
+}
+
+template <typename DerivedPolicy, typename MatrixType, typename ValueType>
+void scale_entries(thrust::execution_policy<DerivedPolicy>& exec,
+                   MatrixType& A, const ValueType * row_scale, const ValueType * column_scale,
+                   cusp::csr_format)
+{
+    typedef typename MatrixType::index_type IndexType;
+
+    scale_csr_row<IndexType,ValueType> f(thrust::raw_pointer_cast(&A.row_offsets[0]),
+                                         thrust::raw_pointer_cast(&A.column_indices[0]),
+                                         thrust::raw_pointer_cast(&A.values[0]),
+                                         entry_scale<IndexType,ValueType>(row_scale, column_scale));
+
+    thrust::for_each(exec,
+                     thrust::counting_iterator<IndexType>(0),
+                     thrust::counting_iterator<IndexType>(A.num_rows),
+                     f);
+}
+
+template <typename DerivedPolicy, typename MatrixType, typename ValueType>
+void scale_entries(thrust::execution_policy<DerivedPolicy>& exec,
+                   MatrixType& A, const ValueType * row_scale, const ValueType * column_scale,
+                   cusp::ell_format)
+{
+    typedef typename MatrixType::index_type IndexType;
+
+    scale_ell_entry<IndexType,ValueType> f(thrust::raw_pointer_cast(&A.column_indices.values[0]),
+                                           thrust::raw_pointer_cast(&A.values.values[0]),
+                                           A.values.pitch, A.num_rows, MatrixType::invalid_index,
+                                           entry_scale<IndexType,ValueType>(row_scale, column_scale));
+
+    thrust::for_each(exec,
+                     thrust::counting_iterator<IndexType>(0),
+                     thrust::counting_iterator<IndexType>(A.values.values.size()),
+                     f);
+}
+
+template <typename DerivedPolicy, typename MatrixType, typename ValueType>
+void scale_entries(thrust::execution_policy<DerivedPolicy>& exec,
+                   MatrixType& A, const ValueType * row_scale, const ValueType * column_scale,
+                   cusp::dia_format)
+{
+    typedef typename MatrixType::index_type IndexType;
+
+    scale_dia_entry<IndexType,ValueType> f(thrust::raw_pointer_cast(&A.diagonal_offsets[0]),
+                                           thrust::raw_pointer_cast(&A.values.values[0]),
+                                           A.values.pitch, A.num_rows, A.num_cols,
+                                           entry_scale<IndexType,ValueType>(row_scale, column_scale));
+
+    thrust::for_each(exec,
+                     thrust::counting_iterator<IndexType>(0),
+                     thrust::counting_iterator<IndexType>(A.values.values.size()),
+                     f);
+}
+
+template <typename DerivedPolicy, typename MatrixType, typename ValueType>
+void scale_entries(thrust::execution_policy<DerivedPolicy>& exec,
+                   MatrixType& A, const ValueType * row_scale, const ValueType * column_scale,
+                   cusp::hyb_format)
+{
+    scale_entries(exec, A.ell, row_scale, column_scale, cusp::ell_format());
+    scale_entries(exec, A.coo, row_scale, column_scale, cusp::coo_format());
+}
+
+// largest magnitude of every row (column) of a coordinate matrix whose
+// entries are visited in the order of keys, zero for empty rows
+template <typename DerivedPolicy, typename KeyArray, typename ValueIterator, typename IndexArray, typename Array>
+void key_maxima(thrust::execution_policy<DerivedPolicy>& exec,
+                const KeyArray& keys, ValueIterator values,
+                IndexArray& unique_keys, Array& maxima, Array& output)
+{
+    typedef typename Array::value_type ValueType;
+
+    const size_t n = thrust::reduce_by_key(exec,
+                                           keys.begin(), keys.end(), values,
+                                           unique_keys.begin(), maxima.begin(),
+                                           thrust::equal_to<typename KeyArray::value_type>(),
+                                           thrust::maximum<ValueType>()).first - unique_keys.begin();
+
+    thrust::fill(exec, output.begin(), output.end(), ValueType(0));
+    thrust::scatter(exec, maxima.begin(), maxima.begin() + n, unique_keys.begin(), output.begin());
+}
+
+} // end namespace equilibration
+
+template <typename DerivedPolicy, typename MatrixType, typename ArrayType>
+void scale_rows(thrust::execution_policy<DerivedPolicy>& exec,
+                MatrixType& A, const ArrayType& scale)
+{
+    typedef typename MatrixType::value_type   ValueType;
+    typedef typename MatrixType::memory_space MemorySpace;
+    typedef typename MatrixType::format       Format;
+
+    if(scale.size() != A.num_rows)
+        throw cusp::invalid_input_exception("scale_rows requires one factor per row");
+
+    // the factors in the memory space of the matrix
+    cusp::array1d<ValueType,MemorySpace> r(scale);
+
+    equilibration::scale_entries(exec, A, thrust::raw_pointer_cast(&r[0]), (const ValueType *) 0, Format());
+}
+
+template <typename DerivedPolicy, typename MatrixType, typename ArrayType>
+void scale_columns(thrust::execution_policy<DerivedPolicy>& exec,
+                   MatrixType& A, const ArrayType& scale)
+{
+    typedef typename MatrixType::value_type   ValueType;
+    typedef typename MatrixType::memory_space MemorySpace;
+    typedef typename MatrixType::format       Format;
+
+    if(scale.size() != A.num_cols)
+        throw cusp::invalid_input_exception("scale_columns requires one factor per column");
+
+    cusp::array1d<ValueType,MemorySpace> c(scale);
+
+    equilibration::scale_entries(exec, A, (const ValueType *) 0, thrust::raw_pointer_cast(&c[0]), Format());
+}
+
+template <typename DerivedPolicy, typename MatrixType, typename ArrayType1, typename ArrayType2>
+void equilibrate(thrust::execution_policy<DerivedPolicy>& exec,
+                 MatrixType& A, ArrayType1& row_scale, ArrayType2& column_scale,
+                 const cusp::equilibration_method method, const size_t max_sweeps)
+{
+    typedef typename MatrixType::index_type   IndexType;
+    typedef typename MatrixType::value_type   ValueType;
+    typedef typename MatrixType::memory_space MemorySpace;
+    typedef typename MatrixType::format       Format;
+    typedef cusp::array1d<IndexType,MemorySpace> IndexArray;
+    typedef cusp::array1d<ValueType,MemorySpace> Array;
+
+    const size_t N = A.num_rows;
+    const size_t M = A.num_cols;
+
+    Array r(N, ValueType(1));
+    Array c(M, ValueType(1));
+
+    if(method == cusp::jacobi_equilibration)
+    {
+        if(N != M)
+            throw cusp::invalid_input_exception("Jacobi equilibration requires a square matrix");
+
+        cusp::extract_diagonal(exec, A, r);
+        thrust::transform(exec, r.begin(), r.end(), r.begin(), equilibration::inverse_sqrt_magnitude<ValueType>());
+        cusp::copy(exec, r, c);
+    }
+    else
+    {
+        // magnitudes of the entries in coordinate order, and their column order
+        cusp::coo_matrix<IndexType,ValueType,MemorySpace> C;
+        cusp::convert(exec, A, C);
+        cusp::sort_by_row(exec, C.row_indices, C.column_indices, C.values);
+
+        thrust::transform(exec, C.values.begin(), C.values.end(), C.values.begin(), cusp::abs_functor<ValueType>());
+
+        IndexArray columns(C.column_indices);
+        IndexArray permutation(C.num_entries);
+        thrust::sequence(exec, permutation.begin(), permutation.end());
+        thrust::stable_sort_by_key(exec, columns.begin(), columns.end(), permutation.begin());
+
+        IndexArray keys(std::max(N, M));
+        Array maxima(std::max(N, M));
+        Array row_max(N);
+        Array column_max(M);
+
+        for(size_t sweep = 0; sweep < max_sweeps; sweep++)
+        {
+            equilibration::key_maxima(exec, C.row_indices, C.values.begin(), keys, maxima, row_max);
+            equilibration::key_maxima(exec, columns,
+                                      thrust::make_permutation_iterator(C.values.begin(), permutation.begin()),
+                                      keys, maxima, column_max);
+
+            const ValueType deviation =
+                std::max(thrust::transform_reduce(exec, row_max.begin(), row_max.end(),
+                                                  equilibration::unit_deviation<ValueType>(), ValueType(0), thrust::maximum<ValueType>()),
+                         thrust::transform_reduce(exec, column_max.begin(), column_max.end(),
+                                                  equilibration::unit_deviation<ValueType>(), ValueType(0), thrust::maximum<ValueType>()));
+
+            if(deviation < ValueType(0.01))
+                break;
+
+            thrust::transform(exec, row_max.begin(), row_max.end(), row_max.begin(), equilibration::inverse_sqrt_magnitude<ValueType>());
+            thrust::transform(exec, column_max.begin(), column_max.end(), column_max.begin(), equilibration::inverse_sqrt_magnitude<ValueType>());
+
+            equilibration::scale_entries(exec, C,
+                                         thrust::raw_pointer_cast(&row_max[0]),
+                                         thrust::raw_pointer_cast(&column_max[0]),
+                                         cusp::coo_format());
+
+            cusp::blas::xmy(exec, r, row_max, r);
+            cusp::blas::xmy(exec, c, column_max, c);
+        }
+    }
+
+    equilibration::scale_entries(exec, A, thrust::raw_pointer_cast(&r[0]), thrust::raw_pointer_cast(&c[0]), Format());
+
+    cusp::copy(exec, r, row_scale);
+    cusp::copy(exec, c, column_scale);
+}
+
+} // end namespace generic
+} // end namespace detail
+} // end namespace system
+} // end namespace cusp
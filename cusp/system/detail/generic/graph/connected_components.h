@@ -18,15 +18,27 @@
 #pragma once
 
 #include <cusp/detail/config.h>
+#include <cusp/detail/execution_policy.h>
+#include <cusp/detail/temporary_array.h>
 
-#include <cusp/graph/breadth_first_search.h>
+#include <cusp/exception.h>
 
-#include <cusp/detail/execution_policy.h>
-#include <thrust/fill.h>
-#include <thrust/find.h>
+#include <thrust/count.h>
+#include <thrust/copy.h>
+#include <thrust/equal.h>
+#include <thrust/extrema.h>
 #include <thrust/functional.h>
+#include <thrust/gather.h>
+#include <thrust/reduce.h>
+#include <thrust/scan.h>
+#include <thrust/scatter.h>
+#include <thrust/sequence.h>
+#include <thrust/sort.h>
+#include <thrust/transform.h>
 
 #include <thrust/iterator/constant_iterator.h>
+#include <thrust/iterator/counting_iterator.h>
+#include <thrust/iterator/transform_iterator.h>
 
 namespace cusp
 {
@@ -36,7 +48,205 @@ namespace detail
 {
 namespace generic
 {
+namespace cc
+{
+
+// roots are ordered by their index except for the root of the largest
+// component, which precedes all others so it never has to be hooked
+template <typename IndexType>
+struct root_key
+{
+    const IndexType largest;
+
+    root_key(const IndexType largest)
+        : largest(largest) {}
+
+    __host__ __device__
+    IndexType operator()(const IndexType r) const
+    {
+        return r == largest ? IndexType(-1) : r;
+    }
+};
+
+// smallest key of the roots of v and of the neighbors at positions
+// [first, last) of its row, a negative last selects the whole row
+template <typename IndexType>
+struct min_neighbor_root
+{
+    const IndexType * row_offsets;
+    const IndexType * column_indices;
+    const IndexType * parents;
+    const IndexType first;
+    const IndexType last;
+    const root_key<IndexType> key;
+
+    min_neighbor_root(const IndexType * row_offsets, const IndexType * column_indices,
+                      const IndexType * parents, const IndexType first, const IndexType last,
+                      const IndexType largest)
+        : row_offsets(row_offsets), column_indices(column_indices), parents(parents),
+          first(first), last(last), key(largest) {}
+
+    __host__ __device__
+    IndexType operator()(const IndexType v) const
+    {
+        IndexType best = key(parents[v]);
+
+        const IndexType row_start = row_offsets[v];
+        const IndexType row_end   = row_offsets[v + 1];
+        const IndexType begin     = row_start + first;
+        const IndexType end       = (last < 0 || row_start + last > row_end) ? row_end : row_start + last;
+
+        for(IndexType jj = begin; jj < end; jj++)
+        {
+            const IndexType u = column_indices[jj];
+
+            // skip invalid edges
+            if(u < 0)
+                continue;
+
+            const IndexType k = key(parents[u]);
+
+            if(k < best)
+                best = k;
+        }
+
+        return best;
+    }
+};
 
+// new parent of root r given the smallest key found in its tree
+template <typename IndexType>
+struct hook_root
+{
+    const root_key<IndexType> key;
+
+    hook_root(const IndexType largest)
+        : key(largest) {}
+
+    __host__ __device__
+    IndexType operator()(const IndexType r, const IndexType k) const
+    {
+        if(k < key(r))
+            return k < 0 ? key.largest : k;
+        else
+            return r;
+    }
+};
+
+// hooks every root to the smallest root adjacent to its tree through the
+// neighbors [first, last) of the given vertices, the parents must point to
+// roots on entry.  Returns true if any root was hooked.
+template <typename DerivedPolicy, typename MatrixType, typename ArrayType, typename Iterator>
+bool hook(thrust::execution_policy<DerivedPolicy>& exec,
+          const MatrixType& G,
+          ArrayType& parents,
+          Iterator vertices, const size_t num_vertices,
+          const typename MatrixType::index_type first,
+          const typename MatrixType::index_type last,
+          const typename MatrixType::index_type largest)
+{
+    typedef typename MatrixType::index_type IndexType;
+
+    if(num_vertices == 0)
+        return false;
+
+    cusp::detail::temporary_array<IndexType, DerivedPolicy> roots(exec, num_vertices);
+    cusp::detail::temporary_array<IndexType, DerivedPolicy> keys(exec, num_vertices);
+    cusp::detail::temporary_array<IndexType, DerivedPolicy> tree_roots(exec, num_vertices);
+    cusp::detail::temporary_array<IndexType, DerivedPolicy> tree_keys(exec, num_vertices);
+
+    thrust::gather(exec, vertices, vertices + num_vertices, parents.begin(), roots.begin());
+    thrust::transform(exec, vertices, vertices + num_vertices, keys.begin(),
+                      min_neighbor_root<IndexType>(thrust::raw_pointer_cast(&G.row_offsets[0]),
+                                                   thrust::raw_pointer_cast(&G.column_indices[0]),
+                                                   thrust::raw_pointer_cast(&parents[0]),
+                                                   first, last, largest));
+
+    // smallest key per tree, a root may only be written once
+    thrust::sort_by_key(exec, roots.begin(), roots.end(), keys.begin());
+
+    const size_t num_roots = thrust::reduce_by_key(exec,
+                                                   roots.begin(), roots.end(),
+                                                   keys.begin(),
+                                                   tree_roots.begin(),
+                                                   tree_keys.begin(),
+                                                   thrust::equal_to<IndexType>(),
+                                                   thrust::minimum<IndexType>()).first - tree_roots.begin();
+
+    thrust::transform(exec, tree_roots.begin(), tree_roots.begin() + num_roots, tree_keys.begin(), tree_keys.begin(),
+                      hook_root<IndexType>(largest));
+
+    if(thrust::equal(exec, tree_roots.begin(), tree_roots.begin() + num_roots, tree_keys.begin()))
+        return false;
+
+    thrust::scatter(exec, tree_keys.begin(), tree_keys.begin() + num_roots, tree_roots.begin(), parents.begin());
+
+    return true;
+}
+
+// pointer jumping until every vertex points to the root of its tree
+template <typename DerivedPolicy, typename ArrayType>
+void compress(thrust::execution_policy<DerivedPolicy>& exec,
+              ArrayType& parents)
+{
+    typedef typename ArrayType::value_type IndexType;
+
+    cusp::detail::temporary_array<IndexType, DerivedPolicy> grandparents(exec, parents.size());
+
+    while(true)
+    {
+        thrust::gather(exec, parents.begin(), parents.end(), parents.begin(), grandparents.begin());
+
+        if(thrust::equal(exec, parents.begin(), parents.end(), grandparents.begin()))
+            break;
+
+        thrust::copy(exec, grandparents.begin(), grandparents.end(), parents.begin());
+    }
+}
+
+template <typename IndexType>
+struct is_not_in_tree
+{
+    const IndexType * parents;
+    const IndexType root;
+
+    is_not_in_tree(const IndexType * parents, const IndexType root)
+        : parents(parents), root(root) {}
+
+    __host__ __device__
+    bool operator()(const IndexType v) const
+    {
+        return parents[v] != root;
+    }
+};
+
+template <typename IndexType>
+struct is_root
+{
+    const IndexType * parents;
+
+    is_root(const IndexType * parents)
+        : parents(parents) {}
+
+    __host__ __device__
+    IndexType operator()(const IndexType v) const
+    {
+        return parents[v] == v ? 1 : 0;
+    }
+};
+
+} // end namespace cc
+
+// Connected components in the spirit of Afforest (Sutton, Ben-Nun and
+// Barak).  Every vertex starts as its own tree.  The first neighbors of all
+// vertices are linked in a few sampling rounds, which already joins most of
+// the vertices of the largest component.  That component is then
+// identified from a sample of the vertices and only the remaining vertices
+// take part in the Shiloach-Vishkin iterations over their full rows, in
+// which each tree is hooked to the smallest adjacent tree and the trees are
+// flattened by pointer jumping.  Hooking is done by a segmented reduction
+// instead of atomics, so the work is independent of the number of
+// components and the result is deterministic.
 template <typename DerivedPolicy,
           typename MatrixType,
           typename ArrayType>
@@ -45,32 +255,78 @@ size_t connected_components(thrust::execution_policy<DerivedPolicy>& exec,
                             ArrayType& components,
                             cusp::csr_format)
 {
-    using namespace thrust::placeholders;
-
     typedef typename MatrixType::index_type VertexId;
 
-    const VertexId UNSET = -1;
-    size_t num_components = 0;
-    VertexId num_rows = G.num_rows;
-
-    thrust::fill(exec, components.begin(), components.end(), UNSET);
-    cusp::detail::temporary_array<VertexId, DerivedPolicy> levels(exec, G.num_rows, UNSET);
-    VertexId src = rand() % G.num_rows;
-
-    while(src < num_rows) {
-        cusp::graph::breadth_first_search(exec, G, src, levels);
-        thrust::transform_if( exec,
-                              thrust::constant_iterator<VertexId>(num_components),
-                              thrust::constant_iterator<VertexId>(num_components) + G.num_rows,
-                              levels.begin(),
-                              components.begin(),
-                              thrust::identity<VertexId>(),
-                              _1 != UNSET );
-        thrust::fill(exec, levels.begin(), levels.end(), UNSET);
-        src = thrust::find(exec, components.begin(), components.end(), UNSET) - components.begin();
-        num_components++;
+    const VertexId num_rows        = G.num_rows;
+    const VertexId num_samples     = 1024;
+    const VertexId neighbor_rounds = 2;
+
+    if(G.num_rows != G.num_cols)
+        throw cusp::invalid_input_exception("matrix must be square");
+
+    if(num_rows == 0)
+        return 0;
+
+    cusp::detail::temporary_array<VertexId, DerivedPolicy> parents(exec, num_rows);
+    thrust::sequence(exec, parents.begin(), parents.end());
+
+    thrust::counting_iterator<VertexId> all_vertices(0);
+
+    if(G.num_entries > 0)
+    {
+        // link the sampled neighbors of every vertex
+        for(VertexId r = 0; r < neighbor_rounds; r++)
+        {
+            cc::hook(exec, G, parents, all_vertices, num_rows, r, r + 1, VertexId(-1));
+            cc::compress(exec, parents);
+        }
+
+        // most frequent root among evenly spaced vertices
+        const VertexId sample_size = num_rows < num_samples ? num_rows : num_samples;
+
+        cusp::detail::temporary_array<VertexId, DerivedPolicy> sample(exec, sample_size);
+        cusp::detail::temporary_array<VertexId, DerivedPolicy> sampled_roots(exec, sample_size);
+        cusp::detail::temporary_array<VertexId, DerivedPolicy> counts(exec, sample_size);
+
+        thrust::gather(exec,
+                       thrust::make_transform_iterator(all_vertices, num_rows / sample_size * thrust::placeholders::_1),
+                       thrust::make_transform_iterator(all_vertices, num_rows / sample_size * thrust::placeholders::_1) + sample_size,
+                       parents.begin(), sample.begin());
+        thrust::sort(exec, sample.begin(), sample.end());
+
+        const size_t num_sampled_roots = thrust::reduce_by_key(exec,
+                                                               sample.begin(), sample.end(),
+                                                               thrust::constant_iterator<VertexId>(1),
+                                                               sampled_roots.begin(),
+                                                               counts.begin()).first - sampled_roots.begin();
+
+        const VertexId largest = sampled_roots[thrust::max_element(exec, counts.begin(), counts.begin() + num_sampled_roots) - counts.begin()];
+
+        // the vertices of the largest component are skipped, their edges to
+        // other trees are seen from the other side since G is symmetric
+        cusp::detail::temporary_array<VertexId, DerivedPolicy> vertices(exec, num_rows);
+
+        const size_t num_vertices = thrust::copy_if(exec,
+                                                    all_vertices, all_vertices + num_rows,
+                                                    vertices.begin(),
+                                                    cc::is_not_in_tree<VertexId>(thrust::raw_pointer_cast(&parents[0]), largest))
+                                    - vertices.begin();
+
+        while(cc::hook(exec, G, parents, vertices.begin(), num_vertices, VertexId(0), VertexId(-1), largest))
+            cc::compress(exec, parents);
     }
 
+    // number the components by their roots
+    cusp::detail::temporary_array<VertexId, DerivedPolicy> root_ids(exec, num_rows);
+
+    thrust::transform(exec, all_vertices, all_vertices + num_rows, root_ids.begin(),
+                      cc::is_root<VertexId>(thrust::raw_pointer_cast(&parents[0])));
+
+    const size_t num_components = thrust::reduce(exec, root_ids.begin(), root_ids.end(), size_t(0));
+
+    thrust::exclusive_scan(exec, root_ids.begin(), root_ids.end(), root_ids.begin());
+    thrust::gather(exec, parents.begin(), parents.end(), root_ids.begin(), components.begin());
+
     return num_components;
 }
 
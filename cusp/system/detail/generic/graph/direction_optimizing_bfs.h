@@ -0,0 +1,399 @@
+/*
+ *  Copyright 2008-2014 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+
+#pragma once
+
+#include <cusp/detail/config.h>
+#include <cusp/detail/execution_policy.h>
+#include <cusp/detail/temporary_array.h>
+#include <cusp/detail/type_traits.h>
+
+#include <cusp/exception.h>
+#include <cusp/transpose.h>
+
+#include <thrust/copy.h>
+#include <thrust/count.h>
+#include <thrust/fill.h>
+#include <thrust/for_each.h>
+#include <thrust/functional.h>
+#include <thrust/scan.h>
+#include <thrust/scatter.h>
+#include <thrust/transform.h>
+#include <thrust/swap.h>
+#include <thrust/transform_reduce.h>
+
+#include <thrust/iterator/constant_iterator.h>
+#include <thrust/iterator/counting_iterator.h>
+#include <thrust/iterator/zip_iterator.h>
+
+namespace cusp
+{
+namespace system
+{
+namespace detail
+{
+namespace generic
+{
+namespace bfs
+{
+
+template <typename IndexType>
+struct vertex_degree
+{
+    const IndexType * row_offsets;
+
+    vertex_degree(const IndexType * row_offsets)
+        : row_offsets(row_offsets) {}
+
+    __host__ __device__
+    IndexType operator()(const IndexType v) const
+    {
+        return row_offsets[v + 1] - row_offsets[v];
+    }
+};
+
+template <typename IndexType>
+struct frontier_degree
+{
+    const IndexType * row_offsets;
+    const unsigned char * frontier;
+
+    frontier_degree(const IndexType * row_offsets, const unsigned char * frontier)
+        : row_offsets(row_offsets), frontier(frontier) {}
+
+    __host__ __device__
+    size_t operator()(const IndexType v) const
+    {
+        return frontier[v] ? size_t(row_offsets[v + 1] - row_offsets[v]) : size_t(0);
+    }
+};
+
+// top-down step, the edges of queue[k] are written to the slots starting
+// at offsets[k], visited neighbors are marked with -1
+template <typename IndexType>
+struct expand_frontier
+{
+    const IndexType * row_offsets;
+    const IndexType * column_indices;
+    const IndexType * queue;
+    const IndexType * offsets;
+    const IndexType * levels;
+    IndexType * candidates;
+    IndexType * candidate_parents;
+
+    expand_frontier(const IndexType * row_offsets, const IndexType * column_indices,
+                    const IndexType * queue, const IndexType * offsets, const IndexType * levels,
+                    IndexType * candidates, IndexType * candidate_parents)
+        : row_offsets(row_offsets), column_indices(column_indices), queue(queue),
+          offsets(offsets), levels(levels), candidates(candidates),
+          candidate_parents(candidate_parents) {}
+
+    __host__ __device__
+    void operator()(const IndexType k) const
+    {
+        const IndexType u = queue[k];
+        IndexType slot = offsets[k];
+
+        for(IndexType jj = row_offsets[u]; jj < row_offsets[u + 1]; jj++, slot++)
+        {
+            const IndexType v = column_indices[jj];
+
+            candidates[slot] = (v >= 0 && levels[v] == -1) ? v : IndexType(-1);
+            candidate_parents[slot] = u;
+        }
+    }
+};
+
+template <typename IndexType>
+struct is_candidate
+{
+    __host__ __device__
+    bool operator()(const IndexType v) const
+    {
+        return v >= 0;
+    }
+};
+
+// a vertex reached by several edges is kept only for the edge whose slot
+// was stored last in winners
+template <typename IndexType>
+struct is_winner
+{
+    const IndexType * candidates;
+    const IndexType * winners;
+
+    is_winner(const IndexType * candidates, const IndexType * winners)
+        : candidates(candidates), winners(winners) {}
+
+    __host__ __device__
+    bool operator()(const IndexType slot) const
+    {
+        const IndexType v = candidates[slot];
+        return v >= 0 && winners[v] == slot;
+    }
+};
+
+// bottom-up step, every unvisited vertex looks for a parent among its
+// incoming edges in the frontier bitmap and stops at the first one, so each
+// vertex only writes its own entries
+template <typename IndexType>
+struct search_parent
+{
+    const IndexType * row_offsets;
+    const IndexType * column_indices;
+    const unsigned char * frontier;
+    unsigned char * next_frontier;
+    IndexType * levels;
+    IndexType * parents;
+    const IndexType depth;
+
+    search_parent(const IndexType * row_offsets, const IndexType * column_indices,
+                  const unsigned char * frontier, unsigned char * next_frontier,
+                  IndexType * levels, IndexType * parents, const IndexType depth)
+        : row_offsets(row_offsets), column_indices(column_indices), frontier(frontier),
+          next_frontier(next_frontier), levels(levels), parents(parents), depth(depth) {}
+
+    __host__ __device__
+    void operator()(const IndexType v) const
+    {
+        unsigned char found = 0;
+
+        if(levels[v] == -1)
+        {
+            for(IndexType jj = row_offsets[v]; jj < row_offsets[v + 1]; jj++)
+            {
+                const IndexType u = column_indices[jj];
+
+                if(u >= 0 && frontier[u])
+                {
+                    levels[v] = depth;
+                    parents[v] = u;
+                    found = 1;
+                    break;
+                }
+            }
+        }
+
+        next_frontier[v] = found;
+    }
+};
+
+// offsets of the edges of the queued vertices, returns the number of edges
+template <typename DerivedPolicy, typename MatrixType, typename ArrayType>
+size_t queue_offsets(thrust::execution_policy<DerivedPolicy>& exec,
+                     const MatrixType& G,
+                     const ArrayType& queue,
+                     const size_t queue_size,
+                     ArrayType& offsets)
+{
+    typedef typename MatrixType::index_type IndexType;
+
+    thrust::transform(exec,
+                      queue.begin(), queue.begin() + queue_size,
+                      offsets.begin(),
+                      vertex_degree<IndexType>(thrust::raw_pointer_cast(&G.row_offsets[0])));
+
+    const IndexType last_degree = offsets[queue_size - 1];
+
+    thrust::exclusive_scan(exec, offsets.begin(), offsets.begin() + queue_size, offsets.begin());
+
+    return size_t(offsets[queue_size - 1]) + size_t(last_degree);
+}
+
+} // end namespace bfs
+
+// Direction-optimizing breadth-first search of Beamer, Asanovic and
+// Patterson.  Small frontiers are expanded top-down from a queue of
+// vertices; once the edges leaving the frontier outnumber the edges of the
+// unvisited vertices by more than alpha, the search switches to bottom-up
+// steps in which every unvisited vertex scans its neighbors for a parent in
+// a frontier bitmap.  The search returns to top-down steps when the
+// frontier holds fewer than 1/beta of the vertices.  The incoming edges
+// scanned by the bottom-up steps are the rows of the transpose of G, which
+// is built the first time the search switches.
+template<typename DerivedPolicy,
+         typename MatrixType,
+         typename ArrayType>
+void direction_optimizing_bfs(thrust::execution_policy<DerivedPolicy>& exec,
+                              const MatrixType& G,
+                              const typename MatrixType::index_type src,
+                                    ArrayType& labels,
+                              const bool mark_levels,
+                              const size_t alpha = 14,
+                              const size_t beta = 24)
+{
+    typedef typename MatrixType::index_type IndexType;
+    typedef typename cusp::detail::as_csr_type<MatrixType>::type CsrMatrix;
+
+    if(G.num_rows != G.num_cols)
+        throw cusp::invalid_input_exception("matrix must be square");
+
+    if(labels.size() < G.num_rows)
+        throw cusp::runtime_exception("BFS traversal labels is not large enough for result.");
+
+    const size_t N = G.num_rows;
+
+    if(N == 0)
+        return;
+
+    cusp::detail::temporary_array<IndexType, DerivedPolicy> levels(exec, N, IndexType(-1));
+    cusp::detail::temporary_array<IndexType, DerivedPolicy> parents(exec, N, IndexType(-1));
+    cusp::detail::temporary_array<IndexType, DerivedPolicy> queue(exec, N);
+    cusp::detail::temporary_array<IndexType, DerivedPolicy> offsets(exec, N);
+    cusp::detail::temporary_array<IndexType, DerivedPolicy> winners(exec, N);
+    cusp::detail::temporary_array<IndexType, DerivedPolicy> candidates(exec, G.num_entries);
+    cusp::detail::temporary_array<IndexType, DerivedPolicy> candidate_parents(exec, G.num_entries);
+    cusp::detail::temporary_array<unsigned char, DerivedPolicy> bitmaps(exec, 2 * N);
+
+    const IndexType * row_offsets    = thrust::raw_pointer_cast(&G.row_offsets[0]);
+    const IndexType * column_indices = G.num_entries == 0 ? NULL : thrust::raw_pointer_cast(&G.column_indices[0]);
+
+    // current and next frontier bitmaps of the bottom-up steps
+    unsigned char * frontier      = thrust::raw_pointer_cast(&bitmaps[0]);
+    unsigned char * next_frontier = frontier + N;
+
+    levels[src]  = 0;
+    parents[src] = -2;
+    queue[0]     = src;
+
+    // incoming edges of the bottom-up steps
+    CsrMatrix Gt;
+    const IndexType * in_row_offsets    = NULL;
+    const IndexType * in_column_indices = NULL;
+
+    size_t frontier_size   = 1;
+    size_t edges_unvisited = G.num_entries;
+    bool   top_down        = true;
+
+    for(IndexType depth = 1; frontier_size > 0; depth++)
+    {
+        size_t edges_frontier = 0;
+
+        if(top_down)
+        {
+            edges_frontier = bfs::queue_offsets(exec, G, queue, frontier_size, offsets);
+            edges_unvisited -= edges_frontier;
+
+            if(edges_frontier > edges_unvisited / alpha)
+            {
+                // queue -> bitmap
+                thrust::fill(exec, frontier, frontier + N, (unsigned char) 0);
+                thrust::scatter(exec,
+                                thrust::constant_iterator<unsigned char>(1),
+                                thrust::constant_iterator<unsigned char>(1) + frontier_size,
+                                queue.begin(), frontier);
+                top_down = false;
+
+                if(in_row_offsets == NULL)
+                {
+                    cusp::transpose(exec, G, Gt);
+                    in_row_offsets    = thrust::raw_pointer_cast(&Gt.row_offsets[0]);
+                    in_column_indices = thrust::raw_pointer_cast(&Gt.column_indices[0]);
+                }
+            }
+        }
+        else
+        {
+            edges_frontier = thrust::transform_reduce(exec,
+                                                      thrust::counting_iterator<IndexType>(0),
+                                                      thrust::counting_iterator<IndexType>(N),
+                                                      bfs::frontier_degree<IndexType>(row_offsets, frontier),
+                                                      size_t(0),
+                                                      thrust::plus<size_t>());
+            edges_unvisited -= edges_frontier;
+
+            if(frontier_size < N / beta)
+            {
+                // bitmap -> queue
+                thrust::copy_if(exec,
+                                thrust::counting_iterator<IndexType>(0),
+                                thrust::counting_iterator<IndexType>(N),
+                                frontier,
+                                queue.begin(),
+                                thrust::identity<unsigned char>());
+                bfs::queue_offsets(exec, G, queue, frontier_size, offsets);
+                top_down = true;
+            }
+        }
+
+        if(top_down)
+        {
+            if(edges_frontier == 0)
+                break;
+
+            thrust::for_each(exec,
+                             thrust::counting_iterator<IndexType>(0),
+                             thrust::counting_iterator<IndexType>(frontier_size),
+                             bfs::expand_frontier<IndexType>(row_offsets, column_indices,
+                                                             thrust::raw_pointer_cast(&queue[0]),
+                                                             thrust::raw_pointer_cast(&offsets[0]),
+                                                             thrust::raw_pointer_cast(&levels[0]),
+                                                             thrust::raw_pointer_cast(&candidates[0]),
+                                                             thrust::raw_pointer_cast(&candidate_parents[0])));
+
+            // claim every newly reached vertex for one of its edges
+            thrust::scatter_if(exec,
+                               thrust::counting_iterator<IndexType>(0),
+                               thrust::counting_iterator<IndexType>(edges_frontier),
+                               candidates.begin(),
+                               candidates.begin(),
+                               winners.begin(),
+                               bfs::is_candidate<IndexType>());
+
+            frontier_size = thrust::copy_if(exec,
+                                            thrust::make_zip_iterator(thrust::make_tuple(candidates.begin(), candidate_parents.begin())),
+                                            thrust::make_zip_iterator(thrust::make_tuple(candidates.begin(), candidate_parents.begin())) + edges_frontier,
+                                            thrust::counting_iterator<IndexType>(0),
+                                            thrust::make_zip_iterator(thrust::make_tuple(queue.begin(), offsets.begin())),
+                                            bfs::is_winner<IndexType>(thrust::raw_pointer_cast(&candidates[0]),
+                                                                      thrust::raw_pointer_cast(&winners[0])))
+                            - thrust::make_zip_iterator(thrust::make_tuple(queue.begin(), offsets.begin()));
+
+            thrust::scatter(exec,
+                            thrust::constant_iterator<IndexType>(depth),
+                            thrust::constant_iterator<IndexType>(depth) + frontier_size,
+                            queue.begin(), levels.begin());
+            thrust::scatter(exec,
+                            offsets.begin(), offsets.begin() + frontier_size,
+                            queue.begin(), parents.begin());
+        }
+        else
+        {
+            thrust::for_each(exec,
+                             thrust::counting_iterator<IndexType>(0),
+                             thrust::counting_iterator<IndexType>(N),
+                             bfs::search_parent<IndexType>(in_row_offsets, in_column_indices,
+                                                           frontier, next_frontier,
+                                                           thrust::raw_pointer_cast(&levels[0]),
+                                                           thrust::raw_pointer_cast(&parents[0]),
+                                                           depth));
+
+            thrust::swap(frontier, next_frontier);
+            frontier_size = thrust::count(exec, frontier, frontier + N, (unsigned char) 1);
+        }
+    }
+
+    if(mark_levels)
+        thrust::copy(exec, levels.begin(), levels.end(), labels.begin());
+    else
+        thrust::copy(exec, parents.begin(), parents.end(), labels.begin());
+}
+
+} // end namespace generic
+} // end namespace detail
+} // end namespace system
+} // end namespace cusp
@@ -0,0 +1,118 @@
+/*
+ *  Copyright 2008-2014 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#pragma once
+
+#include <cusp/detail/config.h>
+#include <cusp/detail/execution_policy.h>
+
+#include <cusp/convert.h>
+#include <cusp/coo_matrix.h>
+#include <cusp/exception.h>
+#include <cusp/multiply.h>
+
+#include <cusp/system/detail/generic/graph/triangle_count.h>
+
+#include <thrust/copy.h>
+#include <thrust/count.h>
+#include <thrust/fill.h>
+
+#include <thrust/iterator/zip_iterator.h>
+
+namespace cusp
+{
+namespace system
+{
+namespace detail
+{
+namespace generic
+{
+namespace tc
+{
+
+template <typename IndexType>
+struct has_support
+{
+    const IndexType min_support;
+
+    has_support(const IndexType min_support)
+        : min_support(min_support) {}
+
+    __host__ __device__
+    bool operator()(const IndexType support) const
+    {
+        return support >= min_support;
+    }
+};
+
+} // end namespace tc
+
+template <typename DerivedPolicy,
+          typename MatrixType1,
+          typename MatrixType2>
+size_t k_truss(thrust::execution_policy<DerivedPolicy>& exec,
+               const MatrixType1& G,
+               const size_t k,
+                     MatrixType2& T)
+{
+    typedef typename MatrixType1::index_type   IndexType;
+    typedef typename MatrixType1::memory_space MemorySpace;
+    typedef cusp::coo_matrix<IndexType,IndexType,MemorySpace> PatternMatrix;
+
+    if(G.num_rows != G.num_cols)
+        throw cusp::invalid_input_exception("matrix must be square");
+
+    if(k < 2)
+        throw cusp::invalid_input_exception("k must be at least 2");
+
+    PatternMatrix A;
+    tc::off_diagonal_pattern(exec, G, A);
+
+    // every edge belongs to the 2-truss
+    const tc::has_support<IndexType> pred(k - 2);
+
+    while(k > 2 && A.num_entries > 0)
+    {
+        // edges without any triangle are absent from the supports
+        PatternMatrix S;
+        cusp::masked_spgemm(exec, A, A, A, S);
+
+        const size_t num_entries = thrust::count_if(exec, S.values.begin(), S.values.end(), pred);
+
+        if(num_entries == A.num_entries)
+            break;
+
+        A.resize(A.num_rows, A.num_cols, num_entries);
+
+        thrust::copy_if(exec,
+                        thrust::make_zip_iterator(thrust::make_tuple(S.row_indices.begin(), S.column_indices.begin())),
+                        thrust::make_zip_iterator(thrust::make_tuple(S.row_indices.end(), S.column_indices.end())),
+                        S.values.begin(),
+                        thrust::make_zip_iterator(thrust::make_tuple(A.row_indices.begin(), A.column_indices.begin())),
+                        pred);
+
+        thrust::fill(exec, A.values.begin(), A.values.end(), IndexType(1));
+    }
+
+    cusp::convert(exec, A, T);
+
+    return A.num_entries / 2;
+}
+
+} // end namespace generic
+} // end namespace detail
+} // end namespace system
+} // end namespace cusp
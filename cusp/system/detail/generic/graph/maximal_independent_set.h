@@ -25,6 +25,15 @@
 
 #include <cusp/detail/execution_policy.h>
 
+#include <thrust/copy.h>
+#include <thrust/count.h>
+#include <thrust/for_each.h>
+#include <thrust/sequence.h>
+#include <thrust/transform.h>
+
+#include <thrust/iterator/constant_iterator.h>
+#include <thrust/iterator/counting_iterator.h>
+
 namespace cusp
 {
 namespace system
@@ -164,6 +173,197 @@ void compute_mis_states(thrust::execution_policy<DerivedPolicy>& exec,
     } while (active_nodes > 0);
 }
 
+// vertex u beats vertex v if its (random value, index) is larger
+template <typename IndexType, typename RandomType>
+__host__ __device__
+bool mis_beats(const RandomType * random_values, const IndexType u, const IndexType v)
+{
+    return random_values[u] > random_values[v] || (random_values[u] == random_values[v] && u > v);
+}
+
+// an undecided vertex joins the set if it beats every undecided vertex
+// within distance k, the MIS vertices are never that close to it because
+// their k-rings are removed as soon as they are selected
+template <typename IndexType, typename RandomType, typename NodeStateType>
+struct select_mis_nodes
+{
+    const IndexType * row_offsets;
+    const IndexType * column_indices;
+    const RandomType * random_values;
+    const NodeStateType * states;
+    const IndexType * frontier;
+    const size_t k;
+    unsigned char * selected;
+
+    select_mis_nodes(const IndexType * row_offsets, const IndexType * column_indices,
+                     const RandomType * random_values, const NodeStateType * states,
+                     const IndexType * frontier, const size_t k, unsigned char * selected)
+        : row_offsets(row_offsets), column_indices(column_indices), random_values(random_values),
+          states(states), frontier(frontier), k(k), selected(selected) {}
+
+    __host__ __device__
+    bool beaten_by(const IndexType u, const IndexType v) const
+    {
+        return u >= 0 && u != v && states[u] == 1 && mis_beats(random_values, u, v);
+    }
+
+    __host__ __device__
+    void operator()(const IndexType i) const
+    {
+        const IndexType v = frontier[i];
+
+        for(IndexType jj = row_offsets[v]; jj < row_offsets[v + 1]; jj++)
+        {
+            const IndexType u = column_indices[jj];
+
+            if(beaten_by(u, v))
+            {
+                selected[i] = 0;
+                return;
+            }
+
+            if(k > 1 && u >= 0)
+            {
+                for(IndexType kk = row_offsets[u]; kk < row_offsets[u + 1]; kk++)
+                {
+                    if(beaten_by(column_indices[kk], v))
+                    {
+                        selected[i] = 0;
+                        return;
+                    }
+                }
+            }
+        }
+
+        selected[i] = 1;
+    }
+};
+
+// the selected vertices are at distance more than k from each other, so
+// the k-rings written here hold no other selected vertex
+template <typename IndexType, typename NodeStateType>
+struct mark_mis_nodes
+{
+    const IndexType * row_offsets;
+    const IndexType * column_indices;
+    const IndexType * frontier;
+    const unsigned char * selected;
+    const size_t k;
+    NodeStateType * states;
+
+    mark_mis_nodes(const IndexType * row_offsets, const IndexType * column_indices,
+                   const IndexType * frontier, const unsigned char * selected,
+                   const size_t k, NodeStateType * states)
+        : row_offsets(row_offsets), column_indices(column_indices), frontier(frontier),
+          selected(selected), k(k), states(states) {}
+
+    __host__ __device__
+    void remove(const IndexType u) const
+    {
+        if(u >= 0 && states[u] == 1)
+            states[u] = 0;
+    }
+
+    __host__ __device__
+    void operator()(const IndexType i) const
+    {
+        if(!selected[i])
+            return;
+
+        const IndexType v = frontier[i];
+
+        states[v] = 2;
+
+        for(IndexType jj = row_offsets[v]; jj < row_offsets[v + 1]; jj++)
+        {
+            const IndexType u = column_indices[jj];
+
+            if(u == v)
+                continue;
+
+            remove(u);
+
+            if(k > 1 && u >= 0)
+                for(IndexType kk = row_offsets[u]; kk < row_offsets[u + 1]; kk++)
+                    if(column_indices[kk] != v)
+                        remove(column_indices[kk]);
+        }
+    }
+};
+
+template <typename NodeStateType>
+struct is_undecided
+{
+    const NodeStateType * states;
+
+    is_undecided(const NodeStateType * states) : states(states) {}
+
+    template <typename IndexType>
+    __host__ __device__
+    bool operator()(const IndexType v) const
+    {
+        return states[v] == 1;
+    }
+};
+
+// Luby's algorithm on the undecided vertices only, the frontier shrinks
+// every round and its size, known from the compaction, ends the search
+template <typename DerivedPolicy,
+          typename MatrixType,
+          typename Array1,
+          typename Array2>
+void compute_mis_states_frontier(thrust::execution_policy<DerivedPolicy>& exec,
+                                 const size_t k,
+                                 const MatrixType& G,
+                                 const Array1& random_values,
+                                       Array2& states)
+{
+    typedef typename MatrixType::index_type IndexType;
+    typedef typename Array1::value_type     RandomType;
+    typedef typename Array2::value_type     NodeStateType;
+
+    const IndexType N = G.num_rows;
+
+    cusp::detail::temporary_array<IndexType, DerivedPolicy> frontier(exec, N);
+    cusp::detail::temporary_array<IndexType, DerivedPolicy> next_frontier(exec, N);
+    cusp::detail::temporary_array<unsigned char, DerivedPolicy> selected(exec, N);
+
+    const IndexType * row_offsets    = thrust::raw_pointer_cast(&G.row_offsets[0]);
+    const IndexType * column_indices = G.num_entries == 0 ? NULL : thrust::raw_pointer_cast(&G.column_indices[0]);
+
+    thrust::sequence(exec, frontier.begin(), frontier.end());
+
+    IndexType frontier_size = N;
+
+    while(frontier_size > 0)
+    {
+        thrust::for_each(exec,
+                         thrust::counting_iterator<IndexType>(0),
+                         thrust::counting_iterator<IndexType>(frontier_size),
+                         select_mis_nodes<IndexType,RandomType,NodeStateType>(row_offsets, column_indices,
+                                 thrust::raw_pointer_cast(&random_values[0]),
+                                 thrust::raw_pointer_cast(&states[0]),
+                                 thrust::raw_pointer_cast(&frontier[0]),
+                                 k, thrust::raw_pointer_cast(&selected[0])));
+
+        thrust::for_each(exec,
+                         thrust::counting_iterator<IndexType>(0),
+                         thrust::counting_iterator<IndexType>(frontier_size),
+                         mark_mis_nodes<IndexType,NodeStateType>(row_offsets, column_indices,
+                                 thrust::raw_pointer_cast(&frontier[0]),
+                                 thrust::raw_pointer_cast(&selected[0]),
+                                 k, thrust::raw_pointer_cast(&states[0])));
+
+        frontier_size = thrust::copy_if(exec,
+                                        frontier.begin(), frontier.begin() + frontier_size,
+                                        next_frontier.begin(),
+                                        is_undecided<NodeStateType>(thrust::raw_pointer_cast(&states[0])))
+                        - next_frontier.begin();
+
+        thrust::copy(exec, next_frontier.begin(), next_frontier.begin() + frontier_size, frontier.begin());
+    }
+}
+
 } // end namespace detail
 
 template <typename DerivedPolicy,
@@ -215,6 +415,30 @@ size_t maximal_independent_set(thrust::execution_policy<DerivedPolicy>& exec,
     typedef typename MatrixType::column_indices_array_type::const_view  ColView;
     typedef typename MatrixType::values_array_type::const_view          ValView;
 
+    // distances 1 and 2 are searched directly from the rows, processing
+    // only the undecided vertices in every round
+    if(k <= 2)
+    {
+        typedef unsigned int  RandomType;
+        typedef unsigned char NodeStateType;
+
+        const IndexType N = G.num_rows;
+
+        cusp::detail::temporary_array<RandomType, DerivedPolicy> random_values(exec, N);
+        cusp::copy(exec, cusp::random_array<RandomType>(N), random_values);
+
+        cusp::detail::temporary_array<NodeStateType, DerivedPolicy> states(exec, N, NodeStateType(1));
+        detail::compute_mis_states_frontier(exec, k, G, random_values, states);
+
+        stencil.resize(N);
+
+        thrust::transform(exec, states.begin(), states.end(),
+                          thrust::constant_iterator<NodeStateType>(2),
+                          stencil.begin(), thrust::equal_to<NodeStateType>());
+
+        return thrust::count(exec, stencil.begin(), stencil.end(), typename ArrayType::value_type(true));
+    }
+
     IndexArray row_indices(exec, G.num_entries);
     cusp::offsets_to_indices(exec, G.row_offsets, row_indices);
 
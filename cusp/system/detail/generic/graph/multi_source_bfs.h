@@ -0,0 +1,304 @@
+/*
+ *  Copyright 2008-2014 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#pragma once
+
+#include <cusp/detail/config.h>
+#include <cusp/detail/execution_policy.h>
+#include <cusp/detail/array2d_format_utils.h>
+
+#include <cusp/array1d.h>
+#include <cusp/exception.h>
+#include <cusp/multiply.h>
+
+#include <thrust/copy.h>
+#include <thrust/fill.h>
+#include <thrust/for_each.h>
+#include <thrust/functional.h>
+#include <thrust/reduce.h>
+#include <thrust/scatter.h>
+#include <thrust/transform.h>
+
+#include <thrust/iterator/counting_iterator.h>
+
+#include <algorithm>
+
+namespace cusp
+{
+namespace system
+{
+namespace detail
+{
+namespace generic
+{
+namespace msbfs
+{
+
+// one bit per traversal of a batch
+typedef unsigned long long MaskType;
+
+const size_t batch_size = 64;
+
+// the semiring product passes the mask of the neighbor through
+struct select_mask
+{
+    template <typename ValueType>
+    __host__ __device__
+    MaskType operator()(const ValueType&, const MaskType mask) const
+    {
+        return mask;
+    }
+};
+
+// bits which reached the vertex for the first time
+struct unvisited_bits
+{
+    __host__ __device__
+    MaskType operator()(const MaskType next, const MaskType visited) const
+    {
+        return next & ~visited;
+    }
+};
+
+// writes the level into the columns of the traversals which reached the vertex
+template <typename IndexType, typename ValueType, typename Orientation>
+struct mark_level
+{
+    const MaskType * frontier;
+    ValueType * distances;
+    const IndexType pitch;
+    const IndexType offset;
+    const IndexType count;
+    const ValueType level;
+
+    mark_level(const MaskType * frontier, ValueType * distances,
+               const IndexType pitch, const IndexType offset,
+               const IndexType count, const ValueType level)
+        : frontier(frontier), distances(distances), pitch(pitch),
+          offset(offset), count(count), level(level) {}
+
+    __host__ __device__
+    void operator()(const IndexType v) const
+    {
+        const MaskType mask = frontier[v];
+
+        if(mask == 0)
+            return;
+
+        for(IndexType b = 0; b < count; b++)
+            if(mask & (MaskType(1) << b))
+                distances[cusp::detail::index_of(v, offset + b, pitch, Orientation())] = level;
+    }
+};
+
+template <typename ArrayType>
+void check_sources(const ArrayType& sources, const size_t num_vertices)
+{
+    for(size_t i = 0; i < sources.size(); i++)
+        if(sources[i] < 0 || size_t(sources[i]) >= num_vertices)
+            throw cusp::invalid_input_exception("source vertex out of range");
+}
+
+// advances the traversals from sources[offset,offset+count) together and
+// hands every frontier, with the union of its masks, to the visitor
+template <typename DerivedPolicy,
+          typename MatrixType,
+          typename ArrayType,
+          typename Visitor>
+void traverse(thrust::execution_policy<DerivedPolicy>& exec,
+              const MatrixType& G,
+              const ArrayType& sources,
+              const size_t offset,
+              const size_t count,
+                    Visitor& visitor)
+{
+    typedef typename MatrixType::index_type   IndexType;
+    typedef typename MatrixType::memory_space MemorySpace;
+    typedef cusp::array1d<MaskType,MemorySpace> MaskArray;
+
+    const size_t N = G.num_rows;
+
+    // sources repeated within the batch share one vertex mask
+    cusp::array1d<IndexType,cusp::host_memory> vertices_h;
+    cusp::array1d<MaskType,cusp::host_memory>  masks_h;
+
+    for(size_t b = 0; b < count; b++)
+    {
+        const IndexType s = sources[offset + b];
+
+        size_t k = 0;
+        while(k < vertices_h.size() && vertices_h[k] != s)
+            k++;
+
+        if(k == vertices_h.size())
+        {
+            vertices_h.push_back(s);
+            masks_h.push_back(0);
+        }
+
+        masks_h[k] |= MaskType(1) << b;
+    }
+
+    cusp::array1d<IndexType,MemorySpace> vertices(vertices_h);
+    cusp::array1d<MaskType,MemorySpace>  masks(masks_h);
+
+    MaskArray frontier(N, MaskType(0));
+    MaskArray visited(N, MaskType(0));
+    MaskArray next(N);
+
+    thrust::scatter(exec, masks.begin(), masks.end(), vertices.begin(), frontier.begin());
+    thrust::scatter(exec, masks.begin(), masks.end(), vertices.begin(), visited.begin());
+
+    MaskType active = ~MaskType(0) >> (batch_size - count);
+
+    for(size_t level = 0; active != 0; level++)
+    {
+        visitor(frontier, active, level);
+
+        // next = visited | OR_{(v,u) in G} frontier[u]
+        cusp::generalized_spmv(exec, G, frontier, visited, next,
+                               select_mask(), thrust::bit_or<MaskType>());
+
+        thrust::transform(exec, next.begin(), next.end(), visited.begin(), frontier.begin(), unvisited_bits());
+        visited.swap(next);
+
+        active = thrust::reduce(exec, frontier.begin(), frontier.end(), MaskType(0), thrust::bit_or<MaskType>());
+    }
+}
+
+template <typename DerivedPolicy, typename ArrayType>
+struct distance_visitor
+{
+    typedef typename ArrayType::index_type  IndexType;
+    typedef typename ArrayType::value_type  ValueType;
+    typedef typename ArrayType::orientation Orientation;
+
+    thrust::execution_policy<DerivedPolicy>& exec;
+    ArrayType& distances;
+    const size_t offset;
+    const size_t count;
+
+    distance_visitor(thrust::execution_policy<DerivedPolicy>& exec, ArrayType& distances,
+                     const size_t offset, const size_t count)
+        : exec(exec), distances(distances), offset(offset), count(count) {}
+
+    template <typename MaskArray>
+    void operator()(const MaskArray& frontier, const MaskType, const size_t level)
+    {
+        mark_level<IndexType,ValueType,Orientation>
+            f(thrust::raw_pointer_cast(&frontier[0]),
+              thrust::raw_pointer_cast(&distances.values[0]),
+              distances.pitch, offset, count, ValueType(level));
+
+        thrust::for_each(exec,
+                         thrust::counting_iterator<IndexType>(0),
+                         thrust::counting_iterator<IndexType>(frontier.size()),
+                         f);
+    }
+};
+
+// the eccentricity of a source is the last level its traversal reached
+template <typename ArrayType>
+struct eccentricity_visitor
+{
+    ArrayType& eccentricities;
+    const size_t offset;
+
+    eccentricity_visitor(ArrayType& eccentricities, const size_t offset)
+        : eccentricities(eccentricities), offset(offset) {}
+
+    template <typename MaskArray>
+    void operator()(const MaskArray&, const MaskType active, const size_t level)
+    {
+        for(size_t b = 0; b < batch_size; b++)
+            if(active & (MaskType(1) << b))
+                eccentricities[offset + b] = level;
+    }
+};
+
+} // end namespace msbfs
+
+template <typename DerivedPolicy,
+          typename MatrixType,
+          typename ArrayType1,
+          typename ArrayType2>
+void multi_source_bfs(thrust::execution_policy<DerivedPolicy>& exec,
+                      const MatrixType& G,
+                      const ArrayType1& sources,
+                            ArrayType2& distances)
+{
+    typedef typename MatrixType::index_type IndexType;
+    typedef typename ArrayType2::value_type ValueType;
+
+    if(G.num_rows != G.num_cols)
+        throw cusp::invalid_input_exception("matrix must be square");
+
+    if(distances.num_rows != G.num_rows || distances.num_cols != sources.size())
+        throw cusp::invalid_input_exception("distances must have one row per vertex and one column per source");
+
+    cusp::array1d<IndexType,cusp::host_memory> sources_h(sources);
+    msbfs::check_sources(sources_h, G.num_rows);
+
+    thrust::fill(exec, distances.values.begin(), distances.values.end(), ValueType(-1));
+
+    for(size_t offset = 0; offset < sources_h.size(); offset += msbfs::batch_size)
+    {
+        const size_t count = std::min(msbfs::batch_size, sources_h.size() - offset);
+
+        msbfs::distance_visitor<DerivedPolicy,ArrayType2> visitor(exec, distances, offset, count);
+        msbfs::traverse(exec, G, sources_h, offset, count, visitor);
+    }
+}
+
+template <typename DerivedPolicy,
+          typename MatrixType,
+          typename ArrayType1,
+          typename ArrayType2>
+void multi_source_eccentricity(thrust::execution_policy<DerivedPolicy>& exec,
+                               const MatrixType& G,
+                               const ArrayType1& sources,
+                                     ArrayType2& eccentricities)
+{
+    typedef typename MatrixType::index_type IndexType;
+    typedef typename ArrayType2::value_type ValueType;
+
+    if(G.num_rows != G.num_cols)
+        throw cusp::invalid_input_exception("matrix must be square");
+
+    if(eccentricities.size() < sources.size())
+        throw cusp::invalid_input_exception("eccentricities must hold one entry per source");
+
+    cusp::array1d<IndexType,cusp::host_memory> sources_h(sources);
+    msbfs::check_sources(sources_h, G.num_rows);
+
+    // the levels are recorded per batch on the host and uploaded once
+    cusp::array1d<ValueType,cusp::host_memory> eccentricities_h(sources_h.size(), ValueType(0));
+
+    for(size_t offset = 0; offset < sources_h.size(); offset += msbfs::batch_size)
+    {
+        const size_t count = std::min(msbfs::batch_size, sources_h.size() - offset);
+
+        msbfs::eccentricity_visitor<cusp::array1d<ValueType,cusp::host_memory> > visitor(eccentricities_h, offset);
+        msbfs::traverse(exec, G, sources_h, offset, count, visitor);
+    }
+
+    thrust::copy(eccentricities_h.begin(), eccentricities_h.end(), eccentricities.begin());
+}
+
+} // end namespace generic
+} // end namespace detail
+} // end namespace system
+} // end namespace cusp
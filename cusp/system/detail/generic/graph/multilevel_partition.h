@@ -0,0 +1,705 @@
+/*
+ *  Copyright 2008-2014 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+
+#pragma once
+
+#include <cusp/detail/config.h>
+#include <cusp/detail/execution_policy.h>
+#include <cusp/detail/temporary_array.h>
+
+#include <cusp/array1d.h>
+#include <cusp/csr_matrix.h>
+#include <cusp/exception.h>
+#include <cusp/multiply.h>
+#include <cusp/permutation_matrix.h>
+#include <cusp/transpose.h>
+
+#include <cusp/graph/symmetric_rcm.h>
+#include <cusp/precond/aggregation/galerkin_product.h>
+
+#include <thrust/copy.h>
+#include <thrust/count.h>
+#include <thrust/fill.h>
+#include <thrust/for_each.h>
+#include <thrust/functional.h>
+#include <thrust/gather.h>
+#include <thrust/reduce.h>
+#include <thrust/scan.h>
+#include <thrust/scatter.h>
+#include <thrust/sequence.h>
+#include <thrust/sort.h>
+#include <thrust/transform.h>
+#include <thrust/transform_reduce.h>
+
+#include <thrust/iterator/counting_iterator.h>
+#include <thrust/iterator/zip_iterator.h>
+
+namespace cusp
+{
+namespace system
+{
+namespace detail
+{
+namespace generic
+{
+namespace partition
+{
+
+// priority of the edge {a,b}, identical from both endpoints so that mutual
+// proposals form along locally dominant edges
+__host__ __device__
+inline unsigned int edge_priority(const unsigned int a, const unsigned int b, const unsigned int seed)
+{
+    unsigned int h = (a < b ? a : b) * 0x9e3779b1u ^ ((a < b ? b : a) + seed) * 0x85ebca6bu;
+    h ^= h >> 16;
+    h *= 0x7feb352du;
+    h ^= h >> 15;
+    return h;
+}
+
+// every unmatched vertex proposes its heaviest unmatched neighbor whose
+// weight keeps the pair below the weight limit
+template <typename IndexType>
+struct propose_match
+{
+    const IndexType * row_offsets;
+    const IndexType * column_indices;
+    const IndexType * edge_weights;
+    const IndexType * vertex_weights;
+    const IndexType * match;
+    const IndexType max_vertex_weight;
+    const unsigned int seed;
+    IndexType * proposal;
+
+    propose_match(const IndexType * row_offsets, const IndexType * column_indices,
+                  const IndexType * edge_weights, const IndexType * vertex_weights,
+                  const IndexType * match, const IndexType max_vertex_weight,
+                  const unsigned int seed, IndexType * proposal)
+        : row_offsets(row_offsets), column_indices(column_indices), edge_weights(edge_weights),
+          vertex_weights(vertex_weights), match(match), max_vertex_weight(max_vertex_weight),
+          seed(seed), proposal(proposal) {}
+
+    __host__ __device__
+    void operator()(const IndexType v) const
+    {
+        IndexType best = -1;
+
+        if(match[v] < 0)
+        {
+            IndexType best_weight = 0;
+            unsigned int best_priority = 0;
+
+            for(IndexType jj = row_offsets[v]; jj < row_offsets[v + 1]; jj++)
+            {
+                const IndexType u = column_indices[jj];
+
+                if(u < 0 || u == v || match[u] >= 0 || vertex_weights[u] + vertex_weights[v] > max_vertex_weight)
+                    continue;
+
+                const IndexType w = edge_weights[jj];
+                const unsigned int priority = edge_priority(u, v, seed);
+
+                if(best < 0 || w > best_weight || (w == best_weight && priority > best_priority))
+                {
+                    best = u;
+                    best_weight = w;
+                    best_priority = priority;
+                }
+            }
+        }
+
+        proposal[v] = best;
+    }
+};
+
+template <typename IndexType>
+struct accept_match
+{
+    const IndexType * proposal;
+    IndexType * match;
+
+    accept_match(const IndexType * proposal, IndexType * match)
+        : proposal(proposal), match(match) {}
+
+    __host__ __device__
+    void operator()(const IndexType v) const
+    {
+        const IndexType u = proposal[v];
+
+        if(u >= 0 && proposal[u] == v)
+            match[v] = u;
+    }
+};
+
+// the smaller vertex of a pair, or an unmatched vertex, roots an aggregate
+template <typename IndexType>
+struct is_match_root
+{
+    const IndexType * match;
+
+    is_match_root(const IndexType * match) : match(match) {}
+
+    __host__ __device__
+    IndexType operator()(const IndexType v) const
+    {
+        return (match[v] < 0 || match[v] >= v) ? 1 : 0;
+    }
+};
+
+template <typename IndexType>
+struct match_aggregate
+{
+    const IndexType * match;
+    const IndexType * roots;
+
+    match_aggregate(const IndexType * match, const IndexType * roots)
+        : match(match), roots(roots) {}
+
+    __host__ __device__
+    IndexType operator()(const IndexType v) const
+    {
+        const IndexType u = match[v];
+        return roots[(u >= 0 && u < v) ? u : v];
+    }
+};
+
+// every vertex proposes the adjacent part it is most connected to among
+// those with room for it. Moves between a pair of parts only go one way
+// in a round so that neighbors do not swap parts, vertices of overweight
+// parts move regardless of the gain. The connectivity is computed by a
+// scan of the row per candidate part, the rows of the graphs partitioned
+// here are short.
+template <typename IndexType>
+struct propose_move
+{
+    const IndexType * row_offsets;
+    const IndexType * column_indices;
+    const IndexType * edge_weights;
+    const IndexType * vertex_weights;
+    const IndexType * parts;
+    const IndexType * part_weights;
+    const IndexType max_part_weight;
+    const bool upward;
+    IndexType * proposal;
+    IndexType * gain;
+
+    propose_move(const IndexType * row_offsets, const IndexType * column_indices,
+                 const IndexType * edge_weights, const IndexType * vertex_weights,
+                 const IndexType * parts, const IndexType * part_weights,
+                 const IndexType max_part_weight, const bool upward,
+                 IndexType * proposal, IndexType * gain)
+        : row_offsets(row_offsets), column_indices(column_indices), edge_weights(edge_weights),
+          vertex_weights(vertex_weights), parts(parts), part_weights(part_weights),
+          max_part_weight(max_part_weight), upward(upward), proposal(proposal), gain(gain) {}
+
+    __host__ __device__
+    IndexType connectivity(const IndexType v, const IndexType p) const
+    {
+        IndexType sum = 0;
+
+        for(IndexType jj = row_offsets[v]; jj < row_offsets[v + 1]; jj++)
+        {
+            const IndexType u = column_indices[jj];
+
+            if(u >= 0 && u != v && parts[u] == p)
+                sum += edge_weights[jj];
+        }
+
+        return sum;
+    }
+
+    __host__ __device__
+    void operator()(const IndexType v) const
+    {
+        const IndexType current = parts[v];
+        const bool overweight = part_weights[current] > max_part_weight;
+
+        IndexType best = -1;
+        IndexType best_connectivity = 0;
+
+        for(IndexType jj = row_offsets[v]; jj < row_offsets[v + 1]; jj++)
+        {
+            const IndexType u = column_indices[jj];
+
+            if(u < 0 || u == v)
+                continue;
+
+            const IndexType p = parts[u];
+
+            if(p == current || p == best)
+                continue;
+
+            if(!overweight && (upward ? p < current : p > current))
+                continue;
+
+            if(part_weights[p] + vertex_weights[v] > max_part_weight)
+                continue;
+
+            const IndexType c = connectivity(v, p);
+
+            if(best < 0 || c > best_connectivity || (c == best_connectivity && p < best))
+            {
+                best = p;
+                best_connectivity = c;
+            }
+        }
+
+        const IndexType g = best_connectivity - connectivity(v, current);
+
+        if(best >= 0 && (g > 0 || overweight))
+        {
+            proposal[v] = best;
+            gain[v] = g;
+        }
+        else
+        {
+            proposal[v] = -1;
+        }
+    }
+};
+
+template <typename IndexType>
+struct has_proposal
+{
+    __host__ __device__
+    bool operator()(const IndexType p) const
+    {
+        return p >= 0;
+    }
+};
+
+// the moves into a part are accepted in order of gain while they fit
+template <typename IndexType>
+struct accept_move
+{
+    const IndexType * vertex_weights;
+    const IndexType * part_weights;
+    const IndexType max_part_weight;
+    IndexType * parts;
+
+    accept_move(const IndexType * vertex_weights, const IndexType * part_weights,
+                const IndexType max_part_weight, IndexType * parts)
+        : vertex_weights(vertex_weights), part_weights(part_weights),
+          max_part_weight(max_part_weight), parts(parts) {}
+
+    template <typename Tuple>
+    __host__ __device__
+    void operator()(const Tuple& t) const
+    {
+        const IndexType v      = thrust::get<0>(t);
+        const IndexType target = thrust::get<1>(t);
+        const IndexType before = thrust::get<2>(t);
+
+        if(part_weights[target] + before + vertex_weights[v] <= max_part_weight)
+            parts[v] = target;
+    }
+};
+
+template <typename IndexType>
+struct cut_weight
+{
+    const IndexType * row_offsets;
+    const IndexType * column_indices;
+    const IndexType * edge_weights;
+    const IndexType * parts;
+
+    cut_weight(const IndexType * row_offsets, const IndexType * column_indices,
+               const IndexType * edge_weights, const IndexType * parts)
+        : row_offsets(row_offsets), column_indices(column_indices),
+          edge_weights(edge_weights), parts(parts) {}
+
+    __host__ __device__
+    IndexType operator()(const IndexType v) const
+    {
+        IndexType sum = 0;
+
+        for(IndexType jj = row_offsets[v]; jj < row_offsets[v + 1]; jj++)
+        {
+            const IndexType u = column_indices[jj];
+
+            if(u >= 0 && u != v && parts[u] != parts[v])
+                sum += edge_weights[jj];
+        }
+
+        return sum;
+    }
+};
+
+template <typename DerivedPolicy, typename ArrayType1, typename ArrayType2, typename ArrayType3>
+void part_weights(thrust::execution_policy<DerivedPolicy>& exec,
+                  const ArrayType1& parts,
+                  const ArrayType2& vertex_weights,
+                        ArrayType3& weights)
+{
+    typedef typename ArrayType1::value_type IndexType;
+
+    cusp::detail::temporary_array<IndexType, DerivedPolicy> keys(exec, parts.begin(), parts.end());
+    cusp::detail::temporary_array<IndexType, DerivedPolicy> values(exec, vertex_weights.begin(), vertex_weights.end());
+    cusp::detail::temporary_array<IndexType, DerivedPolicy> unique_keys(exec, parts.size());
+    cusp::detail::temporary_array<IndexType, DerivedPolicy> sums(exec, parts.size());
+
+    thrust::sort_by_key(exec, keys.begin(), keys.end(), values.begin());
+
+    const size_t num_keys = thrust::reduce_by_key(exec,
+                                                  keys.begin(), keys.end(), values.begin(),
+                                                  unique_keys.begin(), sums.begin()).first - unique_keys.begin();
+
+    thrust::fill(exec, weights.begin(), weights.end(), IndexType(0));
+    thrust::scatter(exec, sums.begin(), sums.begin() + num_keys, unique_keys.begin(), weights.begin());
+}
+
+// label propagation restricted to moves that keep every part below the
+// weight limit, or that take weight out of an overweight part
+template <typename DerivedPolicy, typename GraphType, typename ArrayType1, typename ArrayType2>
+void refine(thrust::execution_policy<DerivedPolicy>& exec,
+            const GraphType& A,
+            const ArrayType1& vertex_weights,
+            const size_t num_parts,
+            const typename GraphType::index_type max_part_weight,
+                  ArrayType2& parts)
+{
+    typedef typename GraphType::index_type IndexType;
+
+    const size_t max_rounds = 8;
+    const IndexType N = A.num_rows;
+
+    cusp::detail::temporary_array<IndexType, DerivedPolicy> weights(exec, num_parts);
+    cusp::detail::temporary_array<IndexType, DerivedPolicy> proposal(exec, N);
+    cusp::detail::temporary_array<IndexType, DerivedPolicy> gain(exec, N);
+    cusp::detail::temporary_array<IndexType, DerivedPolicy> movers(exec, N);
+    cusp::detail::temporary_array<IndexType, DerivedPolicy> targets(exec, N);
+    cusp::detail::temporary_array<IndexType, DerivedPolicy> mover_gains(exec, N);
+    cusp::detail::temporary_array<IndexType, DerivedPolicy> mover_weights(exec, N);
+
+    const IndexType * row_offsets    = thrust::raw_pointer_cast(&A.row_offsets[0]);
+    const IndexType * column_indices = A.num_entries == 0 ? NULL : thrust::raw_pointer_cast(&A.column_indices[0]);
+    const IndexType * edge_weights   = A.num_entries == 0 ? NULL : thrust::raw_pointer_cast(&A.values[0]);
+
+    for(size_t round = 0; round < max_rounds; round++)
+    {
+        part_weights(exec, parts, vertex_weights, weights);
+
+        thrust::for_each(exec,
+                         thrust::counting_iterator<IndexType>(0),
+                         thrust::counting_iterator<IndexType>(N),
+                         propose_move<IndexType>(row_offsets, column_indices, edge_weights,
+                                                 thrust::raw_pointer_cast(&vertex_weights[0]),
+                                                 thrust::raw_pointer_cast(&parts[0]),
+                                                 thrust::raw_pointer_cast(&weights[0]),
+                                                 max_part_weight, round % 2 == 0,
+                                                 thrust::raw_pointer_cast(&proposal[0]),
+                                                 thrust::raw_pointer_cast(&gain[0])));
+
+        const IndexType num_movers = thrust::copy_if(exec,
+                                                     thrust::counting_iterator<IndexType>(0),
+                                                     thrust::counting_iterator<IndexType>(N),
+                                                     proposal.begin(),
+                                                     movers.begin(),
+                                                     has_proposal<IndexType>()) - movers.begin();
+
+        if(num_movers == 0)
+            break;
+
+        // group the moves by target part, the largest gains first
+        thrust::gather(exec, movers.begin(), movers.begin() + num_movers, gain.begin(), mover_gains.begin());
+        thrust::stable_sort_by_key(exec, mover_gains.begin(), mover_gains.begin() + num_movers,
+                                   movers.begin(), thrust::greater<IndexType>());
+        thrust::gather(exec, movers.begin(), movers.begin() + num_movers, proposal.begin(), targets.begin());
+        thrust::stable_sort_by_key(exec, targets.begin(), targets.begin() + num_movers, movers.begin());
+
+        thrust::gather(exec, movers.begin(), movers.begin() + num_movers, vertex_weights.begin(), mover_weights.begin());
+        thrust::exclusive_scan_by_key(exec,
+                                      targets.begin(), targets.begin() + num_movers,
+                                      mover_weights.begin(), mover_weights.begin());
+
+        thrust::for_each(exec,
+                         thrust::make_zip_iterator(thrust::make_tuple(movers.begin(), targets.begin(), mover_weights.begin())),
+                         thrust::make_zip_iterator(thrust::make_tuple(movers.begin(), targets.begin(), mover_weights.begin())) + num_movers,
+                         accept_move<IndexType>(thrust::raw_pointer_cast(&vertex_weights[0]),
+                                                thrust::raw_pointer_cast(&weights[0]),
+                                                max_part_weight,
+                                                thrust::raw_pointer_cast(&parts[0])));
+    }
+}
+
+// splits a Cuthill-McKee ordering of the coarsest graph into pieces of
+// equal weight, this graph is small and is partitioned on the host
+template <typename DerivedPolicy, typename GraphType, typename ArrayType1, typename ArrayType2>
+void initial_partition(thrust::execution_policy<DerivedPolicy>& exec,
+                       const GraphType& A,
+                       const ArrayType1& vertex_weights,
+                       const size_t num_parts,
+                             ArrayType2& parts)
+{
+    typedef typename GraphType::index_type IndexType;
+
+    const size_t N = A.num_rows;
+
+    cusp::csr_matrix<IndexType,IndexType,cusp::host_memory> h_A(A);
+    cusp::array1d<IndexType,cusp::host_memory> h_weights(vertex_weights.begin(), vertex_weights.end());
+    cusp::permutation_matrix<IndexType,cusp::host_memory> P(N);
+
+    cusp::graph::symmetric_rcm(h_A, P);
+
+    cusp::array1d<IndexType,cusp::host_memory> order(N);
+    for(size_t i = 0; i < N; i++)
+        order[P.permutation[i]] = i;
+
+    size_t total_weight = 0;
+    for(size_t i = 0; i < N; i++)
+        total_weight += h_weights[i];
+
+    cusp::array1d<IndexType,cusp::host_memory> h_parts(N);
+
+    // a vertex belongs to the piece containing the middle of its weight
+    size_t weight_before = 0;
+    for(size_t i = 0; i < N; i++)
+    {
+        const IndexType v = order[i];
+        const size_t p = ((2 * weight_before + h_weights[v]) * num_parts) / (2 * total_weight);
+
+        h_parts[v] = p < num_parts ? p : num_parts - 1;
+        weight_before += h_weights[v];
+    }
+
+    thrust::copy(h_parts.begin(), h_parts.end(), parts.begin());
+}
+
+// heavy edge matching, the matched pairs are the aggregates of the next
+// level and the coarse graph is their Galerkin product with the graph
+template <typename DerivedPolicy, typename GraphType, typename ArrayType1, typename ArrayType2>
+size_t coarsen(thrust::execution_policy<DerivedPolicy>& exec,
+               const GraphType& A,
+               const ArrayType1& vertex_weights,
+               const typename GraphType::index_type max_vertex_weight,
+                     ArrayType2& aggregates,
+                     GraphType& A_coarse,
+                     ArrayType1& coarse_weights)
+{
+    typedef typename GraphType::index_type   IndexType;
+    typedef typename GraphType::memory_space MemorySpace;
+
+    const size_t num_rounds = 4;
+    const IndexType N = A.num_rows;
+
+    cusp::detail::temporary_array<IndexType, DerivedPolicy> match(exec, N, IndexType(-1));
+    cusp::detail::temporary_array<IndexType, DerivedPolicy> proposal(exec, N);
+    cusp::detail::temporary_array<IndexType, DerivedPolicy> roots(exec, N + 1);
+
+    const IndexType * row_offsets    = thrust::raw_pointer_cast(&A.row_offsets[0]);
+    const IndexType * column_indices = A.num_entries == 0 ? NULL : thrust::raw_pointer_cast(&A.column_indices[0]);
+    const IndexType * edge_weights   = A.num_entries == 0 ? NULL : thrust::raw_pointer_cast(&A.values[0]);
+
+    for(size_t round = 0; round < num_rounds; round++)
+    {
+        thrust::for_each(exec,
+                         thrust::counting_iterator<IndexType>(0),
+                         thrust::counting_iterator<IndexType>(N),
+                         propose_match<IndexType>(row_offsets, column_indices, edge_weights,
+                                                  thrust::raw_pointer_cast(&vertex_weights[0]),
+                                                  thrust::raw_pointer_cast(&match[0]),
+                                                  max_vertex_weight, round,
+                                                  thrust::raw_pointer_cast(&proposal[0])));
+
+        thrust::for_each(exec,
+                         thrust::counting_iterator<IndexType>(0),
+                         thrust::counting_iterator<IndexType>(N),
+                         accept_match<IndexType>(thrust::raw_pointer_cast(&proposal[0]),
+                                                 thrust::raw_pointer_cast(&match[0])));
+    }
+
+    thrust::transform(exec,
+                      thrust::counting_iterator<IndexType>(0),
+                      thrust::counting_iterator<IndexType>(N),
+                      roots.begin(),
+                      is_match_root<IndexType>(thrust::raw_pointer_cast(&match[0])));
+    thrust::exclusive_scan(exec, roots.begin(), roots.end(), roots.begin());
+
+    const IndexType num_aggregates = roots[N];
+
+    thrust::transform(exec,
+                      thrust::counting_iterator<IndexType>(0),
+                      thrust::counting_iterator<IndexType>(N),
+                      aggregates.begin(),
+                      match_aggregate<IndexType>(thrust::raw_pointer_cast(&match[0]),
+                                                 thrust::raw_pointer_cast(&roots[0])));
+
+    // piecewise constant prolongator of the aggregates
+    GraphType P(N, num_aggregates, N);
+    thrust::sequence(exec, P.row_offsets.begin(), P.row_offsets.end());
+    thrust::copy(exec, aggregates.begin(), aggregates.begin() + N, P.column_indices.begin());
+    thrust::fill(exec, P.values.begin(), P.values.end(), IndexType(1));
+
+    GraphType R;
+    cusp::transpose(exec, P, R);
+
+    cusp::precond::aggregation::galerkin_product(exec, R, A, P, A_coarse);
+
+    coarse_weights.resize(num_aggregates);
+    cusp::multiply(exec, R, vertex_weights, coarse_weights);
+
+    return num_aggregates;
+}
+
+template <typename DerivedPolicy, typename GraphType, typename ArrayType1, typename ArrayType2>
+void partition_level(thrust::execution_policy<DerivedPolicy>& exec,
+                     const GraphType& A,
+                     const ArrayType1& vertex_weights,
+                     const size_t num_parts,
+                     const typename GraphType::index_type max_part_weight,
+                     const size_t coarsest_size,
+                           ArrayType2& parts)
+{
+    typedef typename GraphType::index_type IndexType;
+
+    const IndexType N = A.num_rows;
+
+    if(size_t(N) > coarsest_size)
+    {
+        // pairs heavier than a fraction of a part are not formed, so the
+        // coarsest graph can still be split evenly
+        const IndexType max_vertex_weight = max_part_weight / 4 > 1 ? max_part_weight / 4 : 1;
+
+        cusp::array1d<IndexType, typename GraphType::memory_space> aggregates(N);
+        cusp::array1d<IndexType, typename GraphType::memory_space> coarse_weights;
+        GraphType A_coarse;
+
+        const size_t num_aggregates = coarsen(exec, A, vertex_weights, max_vertex_weight,
+                                              aggregates, A_coarse, coarse_weights);
+
+        // stop when the matching no longer shrinks the graph
+        if(10 * num_aggregates < 9 * size_t(N))
+        {
+            cusp::array1d<IndexType, typename GraphType::memory_space> coarse_parts(num_aggregates);
+
+            partition_level(exec, A_coarse, coarse_weights, num_parts, max_part_weight,
+                            coarsest_size, coarse_parts);
+
+            thrust::gather(exec, aggregates.begin(), aggregates.end(), coarse_parts.begin(), parts.begin());
+            refine(exec, A, vertex_weights, num_parts, max_part_weight, parts);
+
+            return;
+        }
+    }
+
+    initial_partition(exec, A, vertex_weights, num_parts, parts);
+    refine(exec, A, vertex_weights, num_parts, max_part_weight, parts);
+}
+
+} // end namespace partition
+
+template <typename DerivedPolicy,
+          typename MatrixType,
+          typename ArrayType>
+size_t multilevel_partition(thrust::execution_policy<DerivedPolicy>& exec,
+                            const MatrixType& G,
+                            const size_t num_parts,
+                                  ArrayType& parts,
+                            const double imbalance,
+                            cusp::csr_format)
+{
+    typedef typename MatrixType::index_type   IndexType;
+    typedef typename MatrixType::memory_space MemorySpace;
+    typedef cusp::csr_matrix<IndexType,IndexType,MemorySpace> GraphType;
+
+    if(G.num_rows != G.num_cols)
+        throw cusp::invalid_input_exception("matrix must be square");
+
+    if(num_parts == 0)
+        throw cusp::invalid_input_exception("number of parts must be positive");
+
+    if(imbalance < 0)
+        throw cusp::invalid_input_exception("imbalance must be nonnegative");
+
+    if(parts.size() < G.num_rows)
+        throw cusp::invalid_input_exception("parts array is not large enough for result");
+
+    const IndexType N = G.num_rows;
+
+    if(num_parts == 1 || N == 0)
+    {
+        thrust::fill(exec, parts.begin(), parts.begin() + N, IndexType(0));
+        return 0;
+    }
+
+    // every vertex and every edge has unit weight on the finest level
+    GraphType A(N, N, G.num_entries);
+    thrust::copy(exec, G.row_offsets.begin(), G.row_offsets.end(), A.row_offsets.begin());
+    thrust::copy(exec, G.column_indices.begin(), G.column_indices.end(), A.column_indices.begin());
+    thrust::fill(exec, A.values.begin(), A.values.end(), IndexType(1));
+
+    cusp::array1d<IndexType,MemorySpace> vertex_weights(N, IndexType(1));
+    cusp::array1d<IndexType,MemorySpace> work(N);
+
+    const IndexType max_part_weight = IndexType((1.0 + imbalance) * N / num_parts + 1);
+    const size_t coarsest_size = 20 * num_parts > 100 ? 20 * num_parts : 100;
+
+    partition::partition_level(exec, A, vertex_weights, num_parts, max_part_weight, coarsest_size, work);
+
+    thrust::copy(exec, work.begin(), work.end(), parts.begin());
+
+    const IndexType * column_indices = G.num_entries == 0 ? NULL : thrust::raw_pointer_cast(&A.column_indices[0]);
+    const IndexType * edge_weights   = G.num_entries == 0 ? NULL : thrust::raw_pointer_cast(&A.values[0]);
+
+    // every cut edge is seen from both of its endpoints
+    return thrust::transform_reduce(exec,
+                                    thrust::counting_iterator<IndexType>(0),
+                                    thrust::counting_iterator<IndexType>(N),
+                                    partition::cut_weight<IndexType>(thrust::raw_pointer_cast(&A.row_offsets[0]),
+                                                                     column_indices, edge_weights,
+                                                                     thrust::raw_pointer_cast(&work[0])),
+                                    IndexType(0),
+                                    thrust::plus<IndexType>()) / 2;
+}
+
+template <typename DerivedPolicy,
+          typename MatrixType,
+          typename ArrayType>
+size_t multilevel_partition(thrust::execution_policy<DerivedPolicy>& exec,
+                            const MatrixType& G,
+                            const size_t num_parts,
+                                  ArrayType& parts,
+                            const double imbalance,
+                            cusp::known_format)
+{
+    typedef typename cusp::detail::as_csr_type<MatrixType>::type CsrMatrix;
+
+    CsrMatrix G_csr(G);
+
+    return cusp::graph::multilevel_partition(exec, G_csr, num_parts, parts, imbalance);
+}
+
+template <typename DerivedPolicy,
+          typename MatrixType,
+          typename ArrayType>
+size_t multilevel_partition(thrust::execution_policy<DerivedPolicy>& exec,
+                            const MatrixType& G,
+                            const size_t num_parts,
+                                  ArrayType& parts,
+                            const double imbalance)
+{
+    typedef typename MatrixType::format Format;
+
+    Format format;
+
+    return multilevel_partition(thrust::detail::derived_cast(exec), G, num_parts, parts, imbalance, format);
+}
+
+} // end namespace generic
+} // end namespace detail
+} // end namespace system
+} // end namespace cusp
@@ -0,0 +1,433 @@
+/*
+ *  Copyright 2008-2014 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#pragma once
+
+#include <cusp/detail/config.h>
+#include <cusp/detail/execution_policy.h>
+#include <cusp/detail/array2d_format_utils.h>
+
+#include <cusp/array1d.h>
+#include <cusp/array2d.h>
+#include <cusp/convert.h>
+#include <cusp/coo_matrix.h>
+#include <cusp/copy.h>
+#include <cusp/csr_pattern_matrix.h>
+#include <cusp/exception.h>
+#include <cusp/format_utils.h>
+#include <cusp/sort.h>
+
+#include <thrust/copy.h>
+#include <thrust/fill.h>
+#include <thrust/for_each.h>
+#include <thrust/functional.h>
+#include <thrust/inner_product.h>
+#include <thrust/reduce.h>
+#include <thrust/transform.h>
+
+#include <thrust/iterator/counting_iterator.h>
+#include <thrust/iterator/discard_iterator.h>
+#include <thrust/iterator/transform_iterator.h>
+
+namespace cusp
+{
+namespace system
+{
+namespace detail
+{
+namespace generic
+{
+namespace power_iteration
+{
+
+template <typename IndexType, typename ValueType>
+struct inverse_out_degree
+{
+    const IndexType * offsets;
+
+    inverse_out_degree(const IndexType * offsets)
+        : offsets(offsets) {}
+
+    __host__ __device__
+    ValueType operator()(const IndexType i) const
+    {
+        const IndexType degree = offsets[i + 1] - offsets[i];
+
+        return degree > 0 ? ValueType(1) / ValueType(degree) : ValueType(0);
+    }
+};
+
+template <typename IndexType>
+struct is_dangling
+{
+    const IndexType * offsets;
+
+    is_dangling(const IndexType * offsets)
+        : offsets(offsets) {}
+
+    __host__ __device__
+    bool operator()(const IndexType i) const
+    {
+        return offsets[i + 1] == offsets[i];
+    }
+};
+
+template <typename IndexType>
+struct divide_by
+{
+    const IndexType n;
+
+    divide_by(const IndexType n)
+        : n(n) {}
+
+    __host__ __device__
+    IndexType operator()(const IndexType t) const
+    {
+        return t / n;
+    }
+};
+
+// entry (rows[t % n], t / n) of a row-major array with k columns, which
+// enumerates the entries column by column
+template <typename IndexType, typename ValueType>
+struct column_entry
+{
+    const IndexType * rows;
+    const ValueType * x;
+    const IndexType n;
+    const IndexType k;
+
+    column_entry(const IndexType * rows, const ValueType * x, const IndexType n, const IndexType k)
+        : rows(rows), x(x), n(n), k(k) {}
+
+    __host__ __device__
+    ValueType operator()(const IndexType t) const
+    {
+        const IndexType i = rows ? rows[t % n] : t % n;
+
+        return x[i * k + t / n];
+    }
+};
+
+// entry t of the new rank vectors: the ranks of the in-neighbors scaled by
+// their inverse out-degree, and the teleport term, which includes the rank
+// of the dangling vertices
+template <typename IndexType, typename ValueType>
+struct update_rank
+{
+    const IndexType * row_offsets;
+    const IndexType * column_indices;
+    const ValueType * inverse_degree;
+    const ValueType * x;
+    const ValueType * teleport;
+    const ValueType * dangling_rank;
+    const IndexType k;
+    const ValueType damping;
+    const ValueType uniform;
+
+    update_rank(const IndexType * row_offsets, const IndexType * column_indices,
+                const ValueType * inverse_degree, const ValueType * x,
+                const ValueType * teleport, const ValueType * dangling_rank,
+                const IndexType k, const ValueType damping, const ValueType uniform)
+        : row_offsets(row_offsets), column_indices(column_indices),
+          inverse_degree(inverse_degree), x(x), teleport(teleport),
+          dangling_rank(dangling_rank), k(k), damping(damping), uniform(uniform) {}
+
+    __host__ __device__
+    ValueType operator()(const IndexType t) const
+    {
+        const IndexType i = t / k;
+        const IndexType c = t - i * k;
+
+        ValueType sum(0);
+
+        for(IndexType jj = row_offsets[i]; jj < row_offsets[i + 1]; jj++)
+        {
+            const IndexType j = column_indices[jj];
+
+            sum += x[j * k + c] * inverse_degree[j];
+        }
+
+        const ValueType v = teleport ? teleport[t] : uniform;
+
+        return damping * sum + (ValueType(1) - damping + damping * dangling_rank[c]) * v;
+    }
+};
+
+struct absolute_difference
+{
+    template <typename ValueType>
+    __host__ __device__
+    ValueType operator()(const ValueType a, const ValueType b) const
+    {
+        return a > b ? a - b : b - a;
+    }
+};
+
+template <typename IndexType, typename ValueType>
+struct scale_columns
+{
+    const ValueType * scale;
+    const IndexType k;
+
+    scale_columns(const ValueType * scale, const IndexType k)
+        : scale(scale), k(k) {}
+
+    __host__ __device__
+    ValueType operator()(const IndexType t, const ValueType v) const
+    {
+        return v * scale[t % k];
+    }
+};
+
+// writes the interleaved rank vectors into an array2d
+template <typename IndexType, typename ValueType1, typename ValueType2, typename Orientation>
+struct store_interleaved
+{
+    const ValueType1 * x;
+    ValueType2 * values;
+    const IndexType pitch;
+    const IndexType k;
+
+    store_interleaved(const ValueType1 * x, ValueType2 * values, const IndexType pitch, const IndexType k)
+        : x(x), values(values), pitch(pitch), k(k) {}
+
+    __host__ __device__
+    void operator()(const IndexType t) const
+    {
+        values[cusp::detail::index_of(t / k, t % k, pitch, Orientation())] = ValueType2(x[t]);
+    }
+};
+
+inline void check_damping(const double damping)
+{
+    if(!(damping >= 0.0 && damping < 1.0))
+        throw cusp::invalid_input_exception("damping factor must lie in [0,1)");
+}
+
+// power iterations of the k interleaved rank vectors x, of the uniform
+// teleport distribution if teleport is empty
+template <typename DerivedPolicy,
+          typename MatrixType,
+          typename ArrayType>
+size_t iterate(thrust::execution_policy<DerivedPolicy>& exec,
+               const MatrixType& G,
+               const ArrayType& teleport,
+               const size_t k,
+                     ArrayType& x,
+               const double damping,
+               const double tolerance,
+               const size_t max_iterations)
+{
+    typedef typename MatrixType::index_type   IndexType;
+    typedef typename MatrixType::value_type   MatrixValueType;
+    typedef typename ArrayType::value_type    ValueType;
+    typedef typename ArrayType::memory_space  MemorySpace;
+
+    const IndexType N = G.num_rows;
+
+    // out-degrees of G and the pattern of G^T, along which the ranks are pulled
+    cusp::coo_matrix<IndexType,MatrixValueType,MemorySpace> C;
+    cusp::convert(exec, G, C);
+
+    cusp::array1d<IndexType,MemorySpace> offsets(N + 1);
+    cusp::indices_to_offsets(exec, C.row_indices, offsets);
+
+    ArrayType inverse_degree(N);
+    thrust::transform(exec,
+                      thrust::counting_iterator<IndexType>(0),
+                      thrust::counting_iterator<IndexType>(N),
+                      inverse_degree.begin(),
+                      inverse_out_degree<IndexType,ValueType>(thrust::raw_pointer_cast(&offsets[0])));
+
+    cusp::array1d<IndexType,MemorySpace> dangling(N);
+    dangling.resize(thrust::copy_if(exec,
+                                    thrust::counting_iterator<IndexType>(0),
+                                    thrust::counting_iterator<IndexType>(N),
+                                    dangling.begin(),
+                                    is_dangling<IndexType>(thrust::raw_pointer_cast(&offsets[0]))) - dangling.begin());
+
+    cusp::sort_by_row_and_column(exec, C.column_indices, C.row_indices, C.values);
+
+    cusp::csr_pattern_matrix<IndexType,IndexType,MemorySpace> P(N, N, C.num_entries);
+    cusp::indices_to_offsets(exec, C.column_indices, P.row_offsets);
+    cusp::copy(exec, C.row_indices, P.column_indices);
+
+    const IndexType num_dangling = dangling.size();
+
+    ArrayType y(x.size());
+    ArrayType dangling_rank(k, ValueType(0));
+
+    const ValueType * teleport_ptr = teleport.size() ? thrust::raw_pointer_cast(&teleport[0]) : 0;
+
+    size_t iteration = 0;
+
+    while(iteration < max_iterations)
+    {
+        // rank of the dangling vertices per column
+        if(num_dangling > 0)
+        {
+            thrust::reduce_by_key(exec,
+                                  thrust::make_transform_iterator(thrust::counting_iterator<IndexType>(0), divide_by<IndexType>(num_dangling)),
+                                  thrust::make_transform_iterator(thrust::counting_iterator<IndexType>(num_dangling * k), divide_by<IndexType>(num_dangling)),
+                                  thrust::make_transform_iterator(thrust::counting_iterator<IndexType>(0),
+                                          column_entry<IndexType,ValueType>(thrust::raw_pointer_cast(&dangling[0]),
+                                                                            thrust::raw_pointer_cast(&x[0]), num_dangling, k)),
+                                  thrust::make_discard_iterator(),
+                                  dangling_rank.begin());
+        }
+
+        update_rank<IndexType,ValueType> f(thrust::raw_pointer_cast(&P.row_offsets[0]),
+                                           thrust::raw_pointer_cast(&P.column_indices[0]),
+                                           thrust::raw_pointer_cast(&inverse_degree[0]),
+                                           thrust::raw_pointer_cast(&x[0]),
+                                           teleport_ptr,
+                                           thrust::raw_pointer_cast(&dangling_rank[0]),
+                                           k, ValueType(damping), ValueType(1) / ValueType(N));
+
+        thrust::transform(exec,
+                          thrust::counting_iterator<IndexType>(0),
+                          thrust::counting_iterator<IndexType>(x.size()),
+                          y.begin(), f);
+
+        const ValueType change = thrust::inner_product(exec, y.begin(), y.end(), x.begin(), ValueType(0),
+                                                       thrust::plus<ValueType>(), absolute_difference());
+
+        x.swap(y);
+        iteration++;
+
+        if(double(change) < tolerance)
+            break;
+    }
+
+    return iteration;
+}
+
+} // end namespace power_iteration
+
+template <typename DerivedPolicy,
+          typename MatrixType,
+          typename ArrayType>
+size_t pagerank(thrust::execution_policy<DerivedPolicy>& exec,
+                const MatrixType& G,
+                      ArrayType& ranks,
+                const double damping,
+                const double tolerance,
+                const size_t max_iterations)
+{
+    typedef typename ArrayType::value_type   ValueType;
+    typedef typename ArrayType::memory_space MemorySpace;
+    typedef cusp::array1d<ValueType,MemorySpace> Array;
+
+    if(G.num_rows != G.num_cols)
+        throw cusp::invalid_input_exception("matrix must be square");
+
+    power_iteration::check_damping(damping);
+
+    ranks.resize(G.num_rows);
+
+    if(G.num_rows == 0)
+        return 0;
+
+    Array teleport;
+    Array x(G.num_rows, ValueType(1) / ValueType(G.num_rows));
+
+    const size_t iterations = power_iteration::iterate(exec, G, teleport, 1, x, damping, tolerance, max_iterations);
+
+    thrust::copy(exec, x.begin(), x.end(), ranks.begin());
+
+    return iterations;
+}
+
+template <typename DerivedPolicy,
+          typename MatrixType,
+          typename ArrayType1,
+          typename ArrayType2>
+size_t personalized_pagerank(thrust::execution_policy<DerivedPolicy>& exec,
+                             const MatrixType& G,
+                             const ArrayType1& teleport,
+                                   ArrayType2& ranks,
+                             const double damping,
+                             const double tolerance,
+                             const size_t max_iterations)
+{
+    typedef typename MatrixType::index_type  IndexType;
+    typedef typename ArrayType2::value_type  ValueType;
+    typedef typename ArrayType2::memory_space MemorySpace;
+    typedef cusp::array1d<ValueType,MemorySpace> Array;
+
+    if(G.num_rows != G.num_cols)
+        throw cusp::invalid_input_exception("matrix must be square");
+
+    power_iteration::check_damping(damping);
+
+    if(teleport.num_rows != G.num_rows || teleport.num_cols == 0)
+        throw cusp::invalid_input_exception("teleport must have one row per vertex and at least one column");
+
+    if(ranks.num_rows != teleport.num_rows || ranks.num_cols != teleport.num_cols)
+        throw cusp::invalid_input_exception("ranks must have the shape of teleport");
+
+    const IndexType N = G.num_rows;
+    const IndexType k = teleport.num_cols;
+
+    // interleaved teleport distributions, normalized to sum one
+    cusp::array2d<ValueType,MemorySpace,cusp::row_major> T(teleport);
+    Array v(T.values);
+
+    Array sums(k);
+    thrust::reduce_by_key(exec,
+                          thrust::make_transform_iterator(thrust::counting_iterator<IndexType>(0), power_iteration::divide_by<IndexType>(N)),
+                          thrust::make_transform_iterator(thrust::counting_iterator<IndexType>(N * k), power_iteration::divide_by<IndexType>(N)),
+                          thrust::make_transform_iterator(thrust::counting_iterator<IndexType>(0),
+                                  power_iteration::column_entry<IndexType,ValueType>(0, thrust::raw_pointer_cast(&v[0]), N, k)),
+                          thrust::make_discard_iterator(),
+                          sums.begin());
+
+    cusp::array1d<ValueType,cusp::host_memory> scale(sums);
+
+    for(IndexType c = 0; c < k; c++)
+    {
+        if(!(scale[c] > ValueType(0)))
+            throw cusp::invalid_input_exception("teleport distributions must have a positive sum");
+
+        scale[c] = ValueType(1) / scale[c];
+    }
+
+    sums = scale;
+    thrust::transform(exec,
+                      thrust::counting_iterator<IndexType>(0),
+                      thrust::counting_iterator<IndexType>(N * k),
+                      v.begin(), v.begin(),
+                      power_iteration::scale_columns<IndexType,ValueType>(thrust::raw_pointer_cast(&sums[0]), k));
+
+    // the iteration starts from the teleport distributions
+    Array x(v);
+
+    const size_t iterations = power_iteration::iterate(exec, G, v, k, x, damping, tolerance, max_iterations);
+
+    thrust::for_each(exec,
+                     thrust::counting_iterator<IndexType>(0),
+                     thrust::counting_iterator<IndexType>(N * k),
+                     power_iteration::store_interleaved<IndexType,ValueType,typename ArrayType2::value_type,typename ArrayType2::orientation>
+                         (thrust::raw_pointer_cast(&x[0]), thrust::raw_pointer_cast(&ranks.values[0]), ranks.pitch, k));
+
+    return iterations;
+}
+
+} // end namespace generic
+} // end namespace detail
+} // end namespace system
+} // end namespace cusp
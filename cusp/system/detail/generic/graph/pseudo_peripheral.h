@@ -21,10 +21,18 @@
 #include <cusp/detail/execution_policy.h>
 #include <cusp/detail/temporary_array.h>
 
+#include <cusp/array1d.h>
+#include <cusp/exception.h>
 #include <cusp/graph/breadth_first_search.h>
 
-#include <thrust/count.h>
+#include <thrust/copy.h>
 #include <thrust/extrema.h>
+#include <thrust/functional.h>
+#include <thrust/gather.h>
+#include <thrust/sort.h>
+#include <thrust/transform.h>
+
+#include <thrust/iterator/counting_iterator.h>
 
 namespace cusp
 {
@@ -49,58 +57,70 @@ pseudo_peripheral_vertex(thrust::execution_policy<DerivedPolicy>& exec,
     if(G.num_rows != G.num_cols)
         throw cusp::invalid_input_exception("matrix must be square");
 
-    IndexType delta = 0;
-    IndexType x = rand() % G.num_rows;
-    IndexType y;
+    // number of last level vertices of smallest degree tried per sweep
+    const IndexType max_candidates = 5;
+
+    const IndexType N = G.num_rows;
 
-    cusp::detail::temporary_array<IndexType, DerivedPolicy> row_lengths(exec, G.num_rows);
+    cusp::detail::temporary_array<IndexType, DerivedPolicy> row_lengths(exec, N);
     thrust::transform(exec,
                       G.row_offsets.begin() + 1, G.row_offsets.end(),
                       G.row_offsets.begin(), row_lengths.begin(),
                       thrust::minus<IndexType>());
 
-    while(1)
-    {
-        cusp::graph::breadth_first_search(exec, G, x, levels);
-
-        typename ArrayType::iterator max_level_iter = thrust::max_element(exec, levels.begin(), levels.end());
-        int max_level = *max_level_iter;
-        int max_count = thrust::count(exec, levels.begin(), levels.end(), max_level);
-
-        if( max_count > 1 )
-        {
-            cusp::detail::temporary_array<IndexType, DerivedPolicy> max_level_vertices(exec, max_count);
-            cusp::detail::temporary_array<IndexType, DerivedPolicy> max_level_valence(exec, max_count);
-
-            thrust::copy_if(exec,
-                            thrust::counting_iterator<IndexType>(0),
-                            thrust::counting_iterator<IndexType>(G.num_rows),
-                            levels.begin(),
-                            max_level_vertices.begin(),
-                            thrust::placeholders::_1 == max_level);
+    cusp::detail::temporary_array<IndexType, DerivedPolicy> candidates(exec, N);
+    cusp::detail::temporary_array<IndexType, DerivedPolicy> candidate_degrees(exec, N);
+    cusp::array1d<IndexType, typename MatrixType::memory_space> candidate_levels(N);
 
-            thrust::gather(exec,
-                           thrust::counting_iterator<IndexType>(0),
-                           thrust::counting_iterator<IndexType>(max_count),
-                           row_lengths.begin(),
-                           max_level_valence.begin());
+    // start from a vertex of minimum degree
+    IndexType root = thrust::min_element(exec, row_lengths.begin(), row_lengths.end()) - row_lengths.begin();
 
-            int min_valence_pos = thrust::min_element(exec, max_level_valence.begin(), max_level_valence.end()) - max_level_valence.begin();
+    cusp::graph::breadth_first_search(exec, G, root, levels);
+    IndexType eccentricity = *thrust::max_element(exec, levels.begin(), levels.end());
 
-            y = max_level_vertices[min_valence_pos];
-        }
-        else
+    while(1)
+    {
+        // the last level sorted by degree, only its first vertices are tried
+        const IndexType num_last = thrust::copy_if(exec,
+                                                   thrust::counting_iterator<IndexType>(0),
+                                                   thrust::counting_iterator<IndexType>(N),
+                                                   levels.begin(),
+                                                   candidates.begin(),
+                                                   thrust::placeholders::_1 == eccentricity) - candidates.begin();
+
+        thrust::gather(exec,
+                       candidates.begin(), candidates.begin() + num_last,
+                       row_lengths.begin(),
+                       candidate_degrees.begin());
+        thrust::stable_sort_by_key(exec,
+                                   candidate_degrees.begin(), candidate_degrees.begin() + num_last,
+                                   candidates.begin());
+
+        const IndexType num_tried = num_last < max_candidates ? num_last : max_candidates;
+
+        bool improved = false;
+
+        for(IndexType i = 0; i < num_tried && !improved; i++)
         {
-            y = max_level_iter - levels.begin();
+            const IndexType candidate = candidates[i];
+
+            cusp::graph::breadth_first_search(exec, G, candidate, candidate_levels);
+            const IndexType candidate_eccentricity = *thrust::max_element(exec, candidate_levels.begin(), candidate_levels.end());
+
+            // a farther candidate becomes the root and its levels are kept
+            if(candidate_eccentricity > eccentricity)
+            {
+                root = candidate;
+                eccentricity = candidate_eccentricity;
+                thrust::copy(exec, candidate_levels.begin(), candidate_levels.end(), levels.begin());
+                improved = true;
+            }
         }
 
-        if( levels[y] <= delta ) break;
-
-        x = y;
-        delta = levels[y];
+        if(!improved) break;
     }
 
-    return y;
+    return root;
 }
 
 template<typename DerivedPolicy,
@@ -0,0 +1,343 @@
+/*
+ *  Copyright 2008-2014 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#pragma once
+
+#include <cusp/detail/config.h>
+#include <cusp/detail/execution_policy.h>
+#include <cusp/detail/temporary_array.h>
+
+#include <cusp/exception.h>
+#include <cusp/graph/space_filling_curve.h>
+
+#include <thrust/extrema.h>
+#include <thrust/scatter.h>
+#include <thrust/sequence.h>
+#include <thrust/sort.h>
+#include <thrust/transform.h>
+
+#include <thrust/iterator/counting_iterator.h>
+#include <thrust/iterator/zip_iterator.h>
+
+namespace cusp
+{
+namespace system
+{
+namespace detail
+{
+namespace generic
+{
+namespace sfc
+{
+
+typedef unsigned long long KeyType;
+
+// maps the bounding box of the points onto [0, 2^bits - 1] per dimension
+struct bounding_box
+{
+    double lower[3];
+    double scale[3];
+    double upper;
+
+    __host__ __device__
+    unsigned int quantize(const int dim, const double c) const
+    {
+        const double t = (c - lower[dim]) * scale[dim];
+
+        return (unsigned int) (t < upper ? t : upper);
+    }
+};
+
+// spreads the 32 bits of x to the even bits of the key
+__host__ __device__ inline
+KeyType spread_bits_2d(KeyType x)
+{
+    x &= 0xFFFFFFFFull;
+    x = (x | (x << 16)) & 0x0000FFFF0000FFFFull;
+    x = (x | (x <<  8)) & 0x00FF00FF00FF00FFull;
+    x = (x | (x <<  4)) & 0x0F0F0F0F0F0F0F0Full;
+    x = (x | (x <<  2)) & 0x3333333333333333ull;
+    x = (x | (x <<  1)) & 0x5555555555555555ull;
+    return x;
+}
+
+// spreads the 21 bits of x to every third bit of the key
+__host__ __device__ inline
+KeyType spread_bits_3d(KeyType x)
+{
+    x &= 0x1FFFFFull;
+    x = (x | (x << 32)) & 0x001F00000000FFFFull;
+    x = (x | (x << 16)) & 0x001F0000FF0000FFull;
+    x = (x | (x <<  8)) & 0x100F00F00F00F00Full;
+    x = (x | (x <<  4)) & 0x10C30C30C30C30C3ull;
+    x = (x | (x <<  2)) & 0x1249249249249249ull;
+    return x;
+}
+
+__host__ __device__ inline
+KeyType morton_2d(const unsigned int x, const unsigned int y)
+{
+    return (spread_bits_2d(x) << 1) | spread_bits_2d(y);
+}
+
+__host__ __device__ inline
+KeyType morton_3d(const unsigned int x, const unsigned int y, const unsigned int z)
+{
+    return (spread_bits_3d(x) << 2) | (spread_bits_3d(y) << 1) | spread_bits_3d(z);
+}
+
+// The quadrant transform of every level is one of four states, composing
+// them is associative, so a prefix scan over the 32 levels with shifts of
+// 1, 2, 4, 8 and 16 yields the transform in effect at every level. The
+// scan after http://threadlocalmutex.com/?p=126
+__host__ __device__ inline
+KeyType hilbert_2d(const unsigned int x, const unsigned int y)
+{
+    const unsigned int ones = 0xFFFFFFFFu;
+
+    unsigned int A, B, C, D;
+
+    // first round, primed with the coordinates
+    {
+        const unsigned int a = x ^ y;
+        const unsigned int b = ones ^ a;
+        const unsigned int c = ones ^ (x | y);
+        const unsigned int d = x & (y ^ ones);
+
+        A = a | (b >> 1);
+        B = (a >> 1) ^ a;
+        C = ((c >> 1) ^ (b & (d >> 1))) ^ c;
+        D = ((a & (c >> 1)) ^ (d >> 1)) ^ d;
+    }
+
+#define __CUSP_HILBERT_SCAN_ROUND(shift)                                   \
+    {                                                                      \
+        const unsigned int a = A, b = B, c = C, d = D;                     \
+        A = (a & (a >> shift)) ^ (b & (b >> shift));                       \
+        B = (a & (b >> shift)) ^ (b & ((a ^ b) >> shift));                 \
+        C ^= (a & (c >> shift)) ^ (b & (d >> shift));                      \
+        D ^= (b & (c >> shift)) ^ ((a ^ b) & (d >> shift));                \
+    }
+
+    __CUSP_HILBERT_SCAN_ROUND(2)
+    __CUSP_HILBERT_SCAN_ROUND(4)
+    __CUSP_HILBERT_SCAN_ROUND(8)
+
+#undef __CUSP_HILBERT_SCAN_ROUND
+
+    // last round only needs the transformed coordinates
+    {
+        const unsigned int a = A, b = B, c = C, d = D;
+        C ^= (a & (c >> 16)) ^ (b & (d >> 16));
+        D ^= (b & (c >> 16)) ^ ((a ^ b) & (d >> 16));
+    }
+
+    const unsigned int a = C ^ (C >> 1);
+    const unsigned int b = D ^ (D >> 1);
+
+    const unsigned int i0 = x ^ y;
+    const unsigned int i1 = b | (ones ^ (i0 | a));
+
+    return (spread_bits_2d(i1) << 1) | spread_bits_2d(i0);
+}
+
+// Skilling's transform of the axes to the transposed Hilbert index, every
+// level is a fixed sequence of masked exchanges and inversions without
+// branches, see "Programming the Hilbert curve", AIP Conf. Proc. 707, 2004
+__host__ __device__ inline
+KeyType hilbert_3d(unsigned int x, unsigned int y, unsigned int z)
+{
+    for(unsigned int Q = 1u << 20; Q > 1; Q >>= 1)
+    {
+        const unsigned int P = Q - 1;
+        unsigned int m, t;
+
+        // x: invert the low bits of x
+        m = 0u - ((x & Q) != 0);
+        x ^= m & P;
+
+        // y: invert the low bits of x or exchange them with y
+        m = 0u - ((y & Q) != 0);
+        x ^= m & P;
+        t = (x ^ y) & P & ~m;
+        x ^= t;
+        y ^= t;
+
+        // z: invert the low bits of x or exchange them with z
+        m = 0u - ((z & Q) != 0);
+        x ^= m & P;
+        t = (x ^ z) & P & ~m;
+        x ^= t;
+        z ^= t;
+    }
+
+    // Gray encode, the bits below every set bit of z are flipped
+    y ^= x;
+    z ^= y;
+
+    unsigned int t = z >> 1;
+    t ^= t >> 1;
+    t ^= t >> 2;
+    t ^= t >> 4;
+    t ^= t >> 8;
+    t ^= t >> 16;
+
+    return morton_3d(x ^ t, y ^ t, z ^ t);
+}
+
+template <cusp::graph::curve_type Curve>
+struct curve_key_2d : public thrust::unary_function<double,KeyType>
+{
+    const bounding_box box;
+
+    curve_key_2d(const bounding_box& box)
+        : box(box) {}
+
+    template <typename Tuple>
+    __host__ __device__
+    KeyType operator()(const Tuple& t) const
+    {
+        const unsigned int x = box.quantize(0, thrust::get<0>(t));
+        const unsigned int y = box.quantize(1, thrust::get<1>(t));
+
+        return Curve == cusp::graph::HILBERT_CURVE ? hilbert_2d(x, y) : morton_2d(x, y);
+    }
+};
+
+template <cusp::graph::curve_type Curve>
+struct curve_key_3d : public thrust::unary_function<double,KeyType>
+{
+    const bounding_box box;
+
+    curve_key_3d(const bounding_box& box)
+        : box(box) {}
+
+    template <typename Tuple>
+    __host__ __device__
+    KeyType operator()(const Tuple& t) const
+    {
+        const unsigned int x = box.quantize(0, thrust::get<0>(t));
+        const unsigned int y = box.quantize(1, thrust::get<1>(t));
+        const unsigned int z = box.quantize(2, thrust::get<2>(t));
+
+        return Curve == cusp::graph::HILBERT_CURVE ? hilbert_3d(x, y, z) : morton_3d(x, y, z);
+    }
+};
+
+template <typename DerivedPolicy, typename Array2d>
+bounding_box make_bounding_box(thrust::execution_policy<DerivedPolicy>& exec,
+                               const Array2d& coord,
+                               const int bits)
+{
+    typedef typename Array2d::const_column_view::iterator Iterator;
+
+    bounding_box box;
+    box.upper = double((1ull << bits) - 1);
+
+    for(size_t dim = 0; dim < coord.num_cols; dim++)
+    {
+        thrust::pair<Iterator,Iterator> iter =
+            thrust::minmax_element(exec, coord.column(dim).begin(), coord.column(dim).end());
+
+        const double lower = *iter.first;
+        const double upper = *iter.second;
+
+        box.lower[dim] = lower;
+        box.scale[dim] = upper > lower ? box.upper / (upper - lower) : 0.0;
+    }
+
+    return box;
+}
+
+template <typename DerivedPolicy, typename Array2d, typename ArrayType>
+void compute_keys(thrust::execution_policy<DerivedPolicy>& exec,
+                  const Array2d& coord,
+                  const cusp::graph::curve_type curve,
+                        ArrayType& keys)
+{
+    if(coord.num_cols == 2)
+    {
+        const bounding_box box = make_bounding_box(exec, coord, 32);
+
+        thrust::zip_iterator< thrust::tuple<typename Array2d::const_column_view::iterator,
+                                            typename Array2d::const_column_view::iterator> >
+            points(thrust::make_tuple(coord.column(0).begin(), coord.column(1).begin()));
+
+        if(curve == cusp::graph::HILBERT_CURVE)
+            thrust::transform(exec, points, points + coord.num_rows, keys.begin(),
+                              curve_key_2d<cusp::graph::HILBERT_CURVE>(box));
+        else
+            thrust::transform(exec, points, points + coord.num_rows, keys.begin(),
+                              curve_key_2d<cusp::graph::MORTON_CURVE>(box));
+    }
+    else
+    {
+        const bounding_box box = make_bounding_box(exec, coord, 21);
+
+        thrust::zip_iterator< thrust::tuple<typename Array2d::const_column_view::iterator,
+                                            typename Array2d::const_column_view::iterator,
+                                            typename Array2d::const_column_view::iterator> >
+            points(thrust::make_tuple(coord.column(0).begin(), coord.column(1).begin(), coord.column(2).begin()));
+
+        if(curve == cusp::graph::HILBERT_CURVE)
+            thrust::transform(exec, points, points + coord.num_rows, keys.begin(),
+                              curve_key_3d<cusp::graph::HILBERT_CURVE>(box));
+        else
+            thrust::transform(exec, points, points + coord.num_rows, keys.begin(),
+                              curve_key_3d<cusp::graph::MORTON_CURVE>(box));
+    }
+}
+
+} // end namespace sfc
+
+template <typename DerivedPolicy,
+          typename Array2d,
+          typename PermutationType>
+void space_filling_curve(thrust::execution_policy<DerivedPolicy>& exec,
+                         const Array2d& coord,
+                               PermutationType& P,
+                         const cusp::graph::curve_type curve)
+{
+    typedef typename PermutationType::index_type IndexType;
+
+    if((coord.num_cols != 2) && (coord.num_cols != 3))
+        throw cusp::invalid_input_exception("space filling curves only implemented for 2D or 3D data");
+
+    const size_t N = coord.num_rows;
+
+    P.resize(N);
+
+    if(N == 0)
+        return;
+
+    cusp::detail::temporary_array<sfc::KeyType, DerivedPolicy> keys(exec, N);
+    sfc::compute_keys(exec, coord, curve, keys);
+
+    // integral keys select the radix sort
+    cusp::detail::temporary_array<IndexType, DerivedPolicy> order(exec, N);
+    thrust::sequence(exec, order.begin(), order.end());
+    thrust::sort_by_key(exec, keys.begin(), keys.end(), order.begin());
+
+    thrust::scatter(exec,
+                    thrust::counting_iterator<IndexType>(0),
+                    thrust::counting_iterator<IndexType>(N),
+                    order.begin(), P.permutation.begin());
+}
+
+} // end namespace generic
+} // end namespace detail
+} // end namespace system
+} // end namespace cusp
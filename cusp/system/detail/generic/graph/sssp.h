@@ -0,0 +1,391 @@
+/*
+ *  Copyright 2008-2014 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#pragma once
+
+#include <cusp/detail/config.h>
+#include <cusp/detail/execution_policy.h>
+#include <cusp/detail/temporary_array.h>
+
+#include <cusp/coo_matrix.h>
+#include <cusp/convert.h>
+#include <cusp/csr_matrix.h>
+#include <cusp/exception.h>
+#include <cusp/multiply.h>
+#include <cusp/sparse_vector.h>
+
+#include <thrust/copy.h>
+#include <thrust/count.h>
+#include <thrust/extrema.h>
+#include <thrust/fill.h>
+#include <thrust/for_each.h>
+#include <thrust/functional.h>
+#include <thrust/gather.h>
+#include <thrust/transform_reduce.h>
+
+#include <thrust/detail/type_traits.h>
+#include <thrust/iterator/counting_iterator.h>
+#include <thrust/iterator/zip_iterator.h>
+
+#include <cmath>
+#include <limits>
+
+namespace cusp
+{
+namespace system
+{
+namespace detail
+{
+namespace generic
+{
+namespace delta_stepping
+{
+
+template <typename ValueType>
+ValueType unreachable(void)
+{
+    return std::numeric_limits<ValueType>::has_infinity ?
+           std::numeric_limits<ValueType>::infinity() :
+           std::numeric_limits<ValueType>::max();
+}
+
+template <typename ValueType>
+struct is_light
+{
+    const double delta;
+
+    is_light(const double delta)
+        : delta(delta) {}
+
+    __host__ __device__
+    bool operator()(const ValueType w) const
+    {
+        return double(w) <= delta;
+    }
+};
+
+template <typename ValueType>
+struct is_heavy
+{
+    const double delta;
+
+    is_heavy(const double delta)
+        : delta(delta) {}
+
+    __host__ __device__
+    bool operator()(const ValueType w) const
+    {
+        return double(w) > delta;
+    }
+};
+
+// active vertices whose distance lies below the end of the current bucket
+template <typename IndexType, typename ValueType>
+struct in_bucket
+{
+    const IndexType * active;
+    const ValueType * distances;
+    const double upper;
+
+    in_bucket(const IndexType * active, const ValueType * distances, const double upper)
+        : active(active), distances(distances), upper(upper) {}
+
+    __host__ __device__
+    bool operator()(const IndexType v) const
+    {
+        return active[v] && double(distances[v]) < upper;
+    }
+};
+
+template <typename IndexType>
+struct is_marked
+{
+    const IndexType * marks;
+
+    is_marked(const IndexType * marks)
+        : marks(marks) {}
+
+    __host__ __device__
+    bool operator()(const IndexType v) const
+    {
+        return marks[v] != 0;
+    }
+};
+
+// frontier vertices leave the active set and join the settled set of the bucket
+template <typename IndexType>
+struct settle
+{
+    IndexType * active;
+    IndexType * settled;
+
+    settle(IndexType * active, IndexType * settled)
+        : active(active), settled(settled) {}
+
+    __host__ __device__
+    void operator()(const IndexType v) const
+    {
+        active[v]  = 0;
+        settled[v] = 1;
+    }
+};
+
+// lowers the distances of the vertices reached by the relaxation, the
+// indices of the relaxed vector are unique
+template <typename IndexType, typename ValueType>
+struct relax
+{
+    const IndexType * indices;
+    const ValueType * values;
+    ValueType * distances;
+    IndexType * active;
+
+    relax(const IndexType * indices, const ValueType * values, ValueType * distances, IndexType * active)
+        : indices(indices), values(values), distances(distances), active(active) {}
+
+    __host__ __device__
+    void operator()(const IndexType k) const
+    {
+        const IndexType v = indices[k];
+
+        if(values[k] < distances[v])
+        {
+            distances[v] = values[k];
+            active[v]    = 1;
+        }
+    }
+};
+
+template <typename IndexType, typename ValueType>
+struct active_distance
+{
+    const IndexType * active;
+    const ValueType * distances;
+    const ValueType infinity;
+
+    active_distance(const IndexType * active, const ValueType * distances, const ValueType infinity)
+        : active(active), distances(distances), infinity(infinity) {}
+
+    __host__ __device__
+    ValueType operator()(const IndexType v) const
+    {
+        return active[v] ? distances[v] : infinity;
+    }
+};
+
+// keeps the edges of G selected by the predicate on their weight
+template <typename DerivedPolicy, typename CooMatrix, typename CsrMatrix, typename Predicate>
+void select_edges(thrust::execution_policy<DerivedPolicy>& exec,
+                  const CooMatrix& G,
+                        CsrMatrix& S,
+                  Predicate pred)
+{
+    CooMatrix T(G.num_rows, G.num_cols,
+                thrust::count_if(exec, G.values.begin(), G.values.end(), pred));
+
+    // the entries stay sorted by row
+    thrust::copy_if(exec,
+                    thrust::make_zip_iterator(thrust::make_tuple(G.row_indices.begin(), G.column_indices.begin(), G.values.begin())),
+                    thrust::make_zip_iterator(thrust::make_tuple(G.row_indices.end(), G.column_indices.end(), G.values.end())),
+                    G.values.begin(),
+                    thrust::make_zip_iterator(thrust::make_tuple(T.row_indices.begin(), T.column_indices.begin(), T.values.begin())),
+                    pred);
+
+    cusp::convert(exec, T, S);
+}
+
+// gathers the vertices selected by the predicate and their distances
+template <typename DerivedPolicy, typename ArrayType, typename SparseVector, typename Predicate>
+void make_frontier(thrust::execution_policy<DerivedPolicy>& exec,
+                   const ArrayType& distances,
+                         SparseVector& x,
+                   Predicate pred)
+{
+    typedef typename SparseVector::index_type IndexType;
+
+    const IndexType N = distances.size();
+
+    x.resize(N, thrust::count_if(exec,
+                                 thrust::counting_iterator<IndexType>(0),
+                                 thrust::counting_iterator<IndexType>(N),
+                                 pred));
+
+    thrust::copy_if(exec,
+                    thrust::counting_iterator<IndexType>(0),
+                    thrust::counting_iterator<IndexType>(N),
+                    x.indices.begin(),
+                    pred);
+
+    thrust::gather(exec, x.indices.begin(), x.indices.end(), distances.begin(), x.values.begin());
+}
+
+// relaxes the edges of A leaving the frontier x
+template <typename DerivedPolicy, typename MatrixType, typename SparseVector, typename ArrayType, typename FlagArray>
+void relax_edges(thrust::execution_policy<DerivedPolicy>& exec,
+                 const MatrixType& A,
+                 const SparseVector& x,
+                       SparseVector& y,
+                       ArrayType& distances,
+                       FlagArray& active,
+                 const cusp::spmspv_method method)
+{
+    typedef typename SparseVector::index_type IndexType;
+    typedef typename SparseVector::value_type ValueType;
+
+    if(x.num_entries == 0 || A.num_entries == 0)
+        return;
+
+    cusp::generalized_spmspv(exec, A, x, y, thrust::plus<ValueType>(), thrust::minimum<ValueType>(), method);
+
+    if(y.num_entries == 0)
+        return;
+
+    thrust::for_each(exec,
+                     thrust::counting_iterator<IndexType>(0),
+                     thrust::counting_iterator<IndexType>(y.num_entries),
+                     relax<IndexType, ValueType>(thrust::raw_pointer_cast(&y.indices[0]),
+                                                 thrust::raw_pointer_cast(&y.values[0]),
+                                                 thrust::raw_pointer_cast(&distances[0]),
+                                                 thrust::raw_pointer_cast(&active[0])));
+}
+
+} // end namespace delta_stepping
+
+template <typename DerivedPolicy,
+          typename MatrixType,
+          typename ArrayType>
+void sssp(thrust::execution_policy<DerivedPolicy>& exec,
+          const MatrixType& G,
+          const typename MatrixType::index_type src,
+                ArrayType& distances,
+          const double delta)
+{
+    typedef typename MatrixType::index_type   IndexType;
+    typedef typename ArrayType::value_type    ValueType;
+    typedef typename MatrixType::memory_space MemorySpace;
+
+    typedef cusp::coo_matrix<IndexType,ValueType,MemorySpace>    CooMatrix;
+    typedef cusp::csr_matrix<IndexType,ValueType,MemorySpace>    CsrMatrix;
+    typedef cusp::array1d<ValueType,MemorySpace>                 DistanceArray;
+    typedef cusp::sparse_vector<IndexType,ValueType,MemorySpace> SparseVector;
+
+    if(G.num_rows != G.num_cols)
+        throw cusp::invalid_input_exception("matrix must be square");
+
+    if(src < 0 || size_t(src) >= G.num_rows)
+        throw cusp::invalid_input_exception("source vertex is out of range");
+
+    if(distances.size() < G.num_rows)
+        throw cusp::invalid_input_exception("distances array is not large enough for result");
+
+    const IndexType N = G.num_rows;
+    const ValueType infinity = delta_stepping::unreachable<ValueType>();
+
+    CooMatrix G_coo;
+    cusp::convert(exec, G, G_coo);
+
+    ValueType max_weight = 0;
+
+    if(G_coo.num_entries > 0)
+    {
+        if(*thrust::min_element(exec, G_coo.values.begin(), G_coo.values.end()) < ValueType(0))
+            throw cusp::invalid_input_exception("edge weights must be nonnegative");
+
+        max_weight = *thrust::max_element(exec, G_coo.values.begin(), G_coo.values.end());
+    }
+
+    // buckets as wide as the weight of about one edge per vertex
+    double width = delta;
+
+    if(width <= 0)
+        width = double(max_weight) * N / thrust::max<size_t>(G_coo.num_entries, N);
+    if(width <= 0)
+        width = 1;
+
+    CsrMatrix light;
+    CsrMatrix heavy;
+
+    delta_stepping::select_edges(exec, G_coo, light, delta_stepping::is_light<ValueType>(width));
+    delta_stepping::select_edges(exec, G_coo, heavy, delta_stepping::is_heavy<ValueType>(width));
+
+    // the sort merge suits GPUs, the bucket merge the host and OpenMP
+#if THRUST_DEVICE_SYSTEM == THRUST_DEVICE_SYSTEM_CUDA
+    const cusp::spmspv_method method =
+        thrust::detail::is_convertible<MemorySpace, cusp::device_memory>::value ? cusp::SPMSPV_SORT : cusp::SPMSPV_BUCKET;
+#else
+    const cusp::spmspv_method method = cusp::SPMSPV_BUCKET;
+#endif
+
+    DistanceArray dist(N, infinity);
+    dist[src] = ValueType(0);
+
+    cusp::array1d<IndexType,MemorySpace> active(N, IndexType(0));
+    cusp::array1d<IndexType,MemorySpace> settled(N, IndexType(0));
+    active[src] = 1;
+
+    IndexType * active_ptr  = thrust::raw_pointer_cast(&active[0]);
+    IndexType * settled_ptr = thrust::raw_pointer_cast(&settled[0]);
+    ValueType * dist_ptr    = thrust::raw_pointer_cast(&dist[0]);
+
+    SparseVector x;
+    SparseVector y;
+
+    while(true)
+    {
+        // the lowest nonempty bucket
+        const ValueType lowest =
+            thrust::transform_reduce(exec,
+                                     thrust::counting_iterator<IndexType>(0),
+                                     thrust::counting_iterator<IndexType>(N),
+                                     delta_stepping::active_distance<IndexType,ValueType>(active_ptr, dist_ptr, infinity),
+                                     infinity,
+                                     thrust::minimum<ValueType>());
+
+        if(lowest == infinity)
+            break;
+
+        const double upper = (std::floor(double(lowest) / width) + 1) * width;
+
+        // light edges may move vertices within the bucket, repeat until it
+        // is settled
+        while(true)
+        {
+            delta_stepping::make_frontier(exec, dist, x,
+                                          delta_stepping::in_bucket<IndexType,ValueType>(active_ptr, dist_ptr, upper));
+
+            if(x.num_entries == 0)
+                break;
+
+            thrust::for_each(exec, x.indices.begin(), x.indices.end(),
+                             delta_stepping::settle<IndexType>(active_ptr, settled_ptr));
+
+            delta_stepping::relax_edges(exec, light, x, y, dist, active, method);
+        }
+
+        // heavy edges only reach later buckets, relax them once
+        delta_stepping::make_frontier(exec, dist, x, delta_stepping::is_marked<IndexType>(settled_ptr));
+        delta_stepping::relax_edges(exec, heavy, x, y, dist, active, method);
+
+        thrust::fill(exec, settled.begin(), settled.end(), IndexType(0));
+    }
+
+    thrust::copy(exec, dist.begin(), dist.end(), distances.begin());
+}
+
+} // end namespace generic
+} // end namespace detail
+} // end namespace system
+} // end namespace cusp
@@ -16,12 +16,30 @@
 
 #include <cusp/detail/config.h>
 
+#include <cusp/detail/temporary_array.h>
+#include <cusp/exception.h>
 #include <cusp/graph/pseudo_peripheral.h>
 
 #include <cusp/detail/execution_policy.h>
+#include <thrust/copy.h>
+#include <thrust/extrema.h>
+#include <thrust/fill.h>
+#include <thrust/for_each.h>
+#include <thrust/functional.h>
+#include <thrust/remove.h>
+#include <thrust/reverse.h>
+#include <thrust/scan.h>
 #include <thrust/sequence.h>
 #include <thrust/scatter.h>
 #include <thrust/sort.h>
+#include <thrust/transform.h>
+#include <thrust/unique.h>
+
+#include <thrust/detail/integer_traits.h>
+
+#include <thrust/iterator/counting_iterator.h>
+#include <thrust/iterator/transform_iterator.h>
+#include <thrust/iterator/zip_iterator.h>
 
 namespace cusp
 {
@@ -32,6 +50,95 @@ namespace detail
 namespace generic
 {
 
+namespace rcm
+{
+
+template <typename IndexType>
+struct frontier_degree
+{
+    const IndexType * row_offsets;
+    const IndexType * order;
+
+    frontier_degree(const IndexType * row_offsets, const IndexType * order)
+        : row_offsets(row_offsets), order(order) {}
+
+    __host__ __device__
+    IndexType operator()(const IndexType i) const
+    {
+        const IndexType v = order[i];
+        return row_offsets[v + 1] - row_offsets[v];
+    }
+};
+
+// degree of the unvisited vertices, visited vertices are never selected
+template <typename IndexType>
+struct unvisited_degree
+{
+    const IndexType * row_offsets;
+    const IndexType * position;
+
+    unvisited_degree(const IndexType * row_offsets, const IndexType * position)
+        : row_offsets(row_offsets), position(position) {}
+
+    __host__ __device__
+    IndexType operator()(const IndexType v) const
+    {
+        return position[v] < 0 ? row_offsets[v + 1] - row_offsets[v]
+                               : thrust::detail::integer_traits<IndexType>::const_max;
+    }
+};
+
+// every frontier vertex writes its unvisited neighbors, and its own
+// position as their parent, to its segment of the candidate arrays
+template <typename IndexType>
+struct expand_frontier
+{
+    const IndexType * row_offsets;
+    const IndexType * column_indices;
+    const IndexType * order;
+    const IndexType * position;
+    const IndexType * offsets;
+    const IndexType first;
+    IndexType * candidates;
+    IndexType * parents;
+
+    expand_frontier(const IndexType * row_offsets, const IndexType * column_indices,
+                    const IndexType * order, const IndexType * position,
+                    const IndexType * offsets, const IndexType first,
+                    IndexType * candidates, IndexType * parents)
+        : row_offsets(row_offsets), column_indices(column_indices), order(order),
+          position(position), offsets(offsets), first(first),
+          candidates(candidates), parents(parents) {}
+
+    __host__ __device__
+    void operator()(const IndexType i) const
+    {
+        const IndexType v = order[first + i];
+        IndexType k = offsets[i];
+
+        for(IndexType jj = row_offsets[v]; jj < row_offsets[v + 1]; jj++, k++)
+        {
+            const IndexType u = column_indices[jj];
+
+            candidates[k] = (u >= 0 && position[u] < 0) ? u : IndexType(-1);
+            parents[k] = first + i;
+        }
+    }
+};
+
+template <typename IndexType>
+struct is_visited
+{
+    template <typename Tuple>
+    __host__ __device__
+    bool operator()(const Tuple& t) const
+    {
+        return thrust::get<0>(t) < 0;
+    }
+};
+
+} // end namespace rcm
+
 template<typename DerivedPolicy,
          typename MatrixType,
          typename PermutationType>
@@ -41,25 +148,114 @@ void symmetric_rcm(thrust::execution_policy<DerivedPolicy>& exec,
                    cusp::csr_format)
 {
     typedef typename MatrixType::index_type IndexType;
+    typedef typename cusp::detail::temporary_array<IndexType,DerivedPolicy>::iterator Iterator;
+    typedef thrust::tuple<Iterator,Iterator> IteratorTuple;
+    typedef thrust::zip_iterator<IteratorTuple> ZipIterator;
 
     if(G.num_rows != G.num_cols)
         throw cusp::invalid_input_exception("matrix must be square");
 
     assert(P.num_rows == G.num_rows);
 
-    // find peripheral vertex and return BFS levels from vertex
-    cusp::graph::pseudo_peripheral_vertex(exec, G, P.permutation);
+    const IndexType N = G.num_rows;
+
+    if(N == 0)
+        return;
+
+    // the vertices in Cuthill-McKee order and the position of every vertex
+    // in it, -1 for the vertices not reached yet
+    cusp::detail::temporary_array<IndexType,DerivedPolicy> order(exec, N);
+    cusp::detail::temporary_array<IndexType,DerivedPolicy> position(exec, N, IndexType(-1));
+
+    // the edges leaving the frontier, with the position of their source
+    cusp::detail::temporary_array<IndexType,DerivedPolicy> offsets(exec, N + 1);
+    cusp::detail::temporary_array<IndexType,DerivedPolicy> candidates(exec, G.num_entries);
+    cusp::detail::temporary_array<IndexType,DerivedPolicy> parents(exec, G.num_entries);
+    cusp::detail::temporary_array<IndexType,DerivedPolicy> degrees(exec, G.num_entries);
+
+    const IndexType * row_offsets    = thrust::raw_pointer_cast(&G.row_offsets[0]);
+    const IndexType * column_indices = G.num_entries == 0 ? NULL : thrust::raw_pointer_cast(&G.column_indices[0]);
+
+    // start from a pseudo-peripheral vertex, later components from their
+    // vertex of minimum degree
+    IndexType root = cusp::graph::pseudo_peripheral_vertex(exec, G);
+
+    IndexType first = 0;
+    IndexType last  = 0;
+
+    while(last < N)
+    {
+        if(first == last)
+        {
+            if(last > 0)
+                root = *thrust::min_element(exec,
+                                            thrust::make_transform_iterator(thrust::counting_iterator<IndexType>(0),
+                                                    rcm::unvisited_degree<IndexType>(row_offsets, thrust::raw_pointer_cast(&position[0]))),
+                                            thrust::make_transform_iterator(thrust::counting_iterator<IndexType>(N),
+                                                    rcm::unvisited_degree<IndexType>(row_offsets, thrust::raw_pointer_cast(&position[0])))).base();
+
+            order[last] = root;
+            position[root] = last;
+            last++;
+        }
+
+        const IndexType frontier_size = last - first;
+
+        thrust::transform(exec,
+                          thrust::counting_iterator<IndexType>(first),
+                          thrust::counting_iterator<IndexType>(last),
+                          offsets.begin(),
+                          rcm::frontier_degree<IndexType>(row_offsets, thrust::raw_pointer_cast(&order[0])));
+        thrust::exclusive_scan(exec, offsets.begin(), offsets.begin() + frontier_size + 1, offsets.begin());
+
+        const IndexType num_edges = offsets[frontier_size];
+
+        thrust::for_each(exec,
+                         thrust::counting_iterator<IndexType>(0),
+                         thrust::counting_iterator<IndexType>(frontier_size),
+                         rcm::expand_frontier<IndexType>(row_offsets, column_indices,
+                                                         thrust::raw_pointer_cast(&order[0]),
+                                                         thrust::raw_pointer_cast(&position[0]),
+                                                         thrust::raw_pointer_cast(&offsets[0]),
+                                                         first,
+                                                         G.num_entries == 0 ? NULL : thrust::raw_pointer_cast(&candidates[0]),
+                                                         G.num_entries == 0 ? NULL : thrust::raw_pointer_cast(&parents[0])));
+
+        ZipIterator edges_begin(thrust::make_tuple(candidates.begin(), parents.begin()));
+        IndexType num_candidates = thrust::remove_if(exec, edges_begin, edges_begin + num_edges,
+                                                     rcm::is_visited<IndexType>()) - edges_begin;
+
+        // a vertex reached from several frontier vertices keeps the first
+        // of them, the parents are increasing so a stable sort keeps it first
+        thrust::stable_sort_by_key(exec, candidates.begin(), candidates.begin() + num_candidates, parents.begin());
+        num_candidates = thrust::unique_by_key(exec, candidates.begin(), candidates.begin() + num_candidates,
+                                               parents.begin()).first - candidates.begin();
+
+        // order the next level by parent position then by degree, the
+        // vertex index breaks the remaining ties
+        thrust::transform(exec,
+                          candidates.begin(), candidates.begin() + num_candidates,
+                          degrees.begin(),
+                          rcm::unvisited_degree<IndexType>(row_offsets, thrust::raw_pointer_cast(&position[0])));
+        thrust::stable_sort_by_key(exec, degrees.begin(), degrees.begin() + num_candidates, edges_begin);
+        thrust::stable_sort_by_key(exec, parents.begin(), parents.begin() + num_candidates, candidates.begin());
+
+        thrust::copy(exec, candidates.begin(), candidates.begin() + num_candidates, order.begin() + last);
+        thrust::scatter(exec,
+                        thrust::counting_iterator<IndexType>(last),
+                        thrust::counting_iterator<IndexType>(last + num_candidates),
+                        candidates.begin(), position.begin());
 
-    // sort vertices by level in BFS traversal
-    cusp::detail::temporary_array<IndexType,DerivedPolicy> levels(exec, G.num_rows);
-    thrust::sequence(exec, levels.begin(), levels.end());
-    thrust::sort_by_key(exec, P.permutation.begin(), P.permutation.end(), levels.begin());
+        first = last;
+        last += num_candidates;
+    }
 
-    // form RCM permutation matrix
+    // form RCM permutation matrix, reversing the Cuthill-McKee order
+    thrust::reverse(exec, order.begin(), order.end());
     thrust::scatter(exec,
                     thrust::counting_iterator<IndexType>(0),
-                    thrust::counting_iterator<IndexType>(G.num_rows),
-                    levels.begin(), P.permutation.begin());
+                    thrust::counting_iterator<IndexType>(N),
+                    order.begin(), P.permutation.begin());
 }
 
 template <typename DerivedPolicy,
@@ -0,0 +1,216 @@
+/*
+ *  Copyright 2008-2014 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#pragma once
+
+#include <cusp/detail/config.h>
+#include <cusp/detail/execution_policy.h>
+
+#include <cusp/array1d.h>
+#include <cusp/convert.h>
+#include <cusp/coo_matrix.h>
+#include <cusp/exception.h>
+#include <cusp/format_utils.h>
+#include <cusp/multiply.h>
+#include <cusp/transpose.h>
+
+#include <thrust/copy.h>
+#include <thrust/count.h>
+#include <thrust/fill.h>
+#include <thrust/functional.h>
+#include <thrust/reduce.h>
+#include <thrust/scatter.h>
+#include <thrust/sort.h>
+
+#include <thrust/iterator/zip_iterator.h>
+
+namespace cusp
+{
+namespace system
+{
+namespace detail
+{
+namespace generic
+{
+namespace tc
+{
+
+struct is_off_diagonal
+{
+    template <typename Tuple>
+    __host__ __device__
+    bool operator()(const Tuple& t) const
+    {
+        return thrust::get<0>(t) != thrust::get<1>(t);
+    }
+};
+
+// edge (i,j) points from the endpoint of lower degree to the one of higher
+// degree, ties broken by index
+template <typename IndexType>
+struct lower_degree_first
+{
+    const IndexType * row_offsets;
+
+    lower_degree_first(const IndexType * row_offsets)
+        : row_offsets(row_offsets) {}
+
+    template <typename Tuple>
+    __host__ __device__
+    bool operator()(const Tuple& t) const
+    {
+        const IndexType i = thrust::get<0>(t);
+        const IndexType j = thrust::get<1>(t);
+
+        const IndexType d_i = row_offsets[i + 1] - row_offsets[i];
+        const IndexType d_j = row_offsets[j + 1] - row_offsets[j];
+
+        return d_i < d_j || (d_i == d_j && i < j);
+    }
+};
+
+// copies the entries of A selected by the predicate on their coordinates
+// with unit values
+template <typename DerivedPolicy, typename MatrixType, typename Predicate>
+void select_entries(thrust::execution_policy<DerivedPolicy>& exec,
+                    const MatrixType& A,
+                          MatrixType& B,
+                    Predicate pred)
+{
+    typedef typename MatrixType::value_type ValueType;
+
+    const size_t num_entries =
+        thrust::count_if(exec,
+                         thrust::make_zip_iterator(thrust::make_tuple(A.row_indices.begin(), A.column_indices.begin())),
+                         thrust::make_zip_iterator(thrust::make_tuple(A.row_indices.end(), A.column_indices.end())),
+                         pred);
+
+    B.resize(A.num_rows, A.num_cols, num_entries);
+
+    thrust::copy_if(exec,
+                    thrust::make_zip_iterator(thrust::make_tuple(A.row_indices.begin(), A.column_indices.begin())),
+                    thrust::make_zip_iterator(thrust::make_tuple(A.row_indices.end(), A.column_indices.end())),
+                    thrust::make_zip_iterator(thrust::make_tuple(B.row_indices.begin(), B.column_indices.begin())),
+                    pred);
+
+    thrust::fill(exec, B.values.begin(), B.values.end(), ValueType(1));
+}
+
+// sorted COO pattern of G without its diagonal
+template <typename DerivedPolicy, typename MatrixType, typename PatternMatrix>
+void off_diagonal_pattern(thrust::execution_policy<DerivedPolicy>& exec,
+                          const MatrixType& G,
+                                PatternMatrix& A)
+{
+    PatternMatrix G_coo;
+    cusp::convert(exec, G, G_coo);
+
+    select_entries(exec, G_coo, A, is_off_diagonal());
+}
+
+} // end namespace tc
+
+template <typename DerivedPolicy,
+          typename MatrixType,
+          typename ArrayType>
+size_t triangle_count(thrust::execution_policy<DerivedPolicy>& exec,
+                      const MatrixType& G,
+                            ArrayType& triangles)
+{
+    typedef typename MatrixType::index_type   IndexType;
+    typedef typename MatrixType::memory_space MemorySpace;
+    typedef cusp::coo_matrix<IndexType,IndexType,MemorySpace> PatternMatrix;
+
+    if(G.num_rows != G.num_cols)
+        throw cusp::invalid_input_exception("matrix must be square");
+
+    if(triangles.size() < G.num_rows)
+        throw cusp::invalid_input_exception("triangles array is not large enough for result");
+
+    const IndexType N = G.num_rows;
+
+    thrust::fill(exec, triangles.begin(), triangles.begin() + N, 0);
+
+    PatternMatrix A;
+    tc::off_diagonal_pattern(exec, G, A);
+
+    if(A.num_entries == 0)
+        return 0;
+
+    // orient the edges by degree
+    PatternMatrix U;
+    {
+        cusp::array1d<IndexType,MemorySpace> row_offsets(N + 1);
+        cusp::indices_to_offsets(exec, A.row_indices, row_offsets);
+
+        tc::select_entries(exec, A, U,
+                           tc::lower_degree_first<IndexType>(thrust::raw_pointer_cast(&row_offsets[0])));
+    }
+
+    // triangles by their lowest and highest vertex
+    PatternMatrix C1;
+    cusp::masked_spgemm(exec, U, U, U, C1);
+
+    const size_t num_triangles =
+        thrust::reduce(exec, C1.values.begin(), C1.values.end(), size_t(0), thrust::plus<size_t>());
+
+    if(num_triangles == 0)
+        return 0;
+
+    // triangles by their middle and highest vertex
+    PatternMatrix Ut;
+    PatternMatrix C2;
+    cusp::transpose(exec, U, Ut);
+    cusp::masked_spgemm(exec, Ut, U, U, C2);
+
+    // every vertex collects the counts of the three roles
+    const size_t n1 = C1.num_entries;
+    const size_t n2 = C2.num_entries;
+
+    cusp::array1d<IndexType,MemorySpace> vertices(2 * n1 + n2);
+    cusp::array1d<IndexType,MemorySpace> counts(2 * n1 + n2);
+
+    thrust::copy(exec, C1.row_indices.begin(),    C1.row_indices.end(),    vertices.begin());
+    thrust::copy(exec, C1.column_indices.begin(), C1.column_indices.end(), vertices.begin() + n1);
+    thrust::copy(exec, C2.row_indices.begin(),    C2.row_indices.end(),    vertices.begin() + 2 * n1);
+    thrust::copy(exec, C1.values.begin(), C1.values.end(), counts.begin());
+    thrust::copy(exec, C1.values.begin(), C1.values.end(), counts.begin() + n1);
+    thrust::copy(exec, C2.values.begin(), C2.values.end(), counts.begin() + 2 * n1);
+
+    thrust::sort_by_key(exec, vertices.begin(), vertices.end(), counts.begin());
+
+    cusp::array1d<IndexType,MemorySpace> unique_vertices(N);
+    cusp::array1d<IndexType,MemorySpace> vertex_counts(N);
+
+    const size_t num_vertices =
+        thrust::reduce_by_key(exec,
+                              vertices.begin(), vertices.end(),
+                              counts.begin(),
+                              unique_vertices.begin(),
+                              vertex_counts.begin()).first - unique_vertices.begin();
+
+    thrust::scatter(exec,
+                    vertex_counts.begin(), vertex_counts.begin() + num_vertices,
+                    unique_vertices.begin(),
+                    triangles.begin());
+
+    return num_triangles;
+}
+
+} // end namespace generic
+} // end namespace detail
+} // end namespace system
+} // end namespace cusp
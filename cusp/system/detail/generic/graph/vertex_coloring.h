@@ -19,9 +19,30 @@
 
 #include <cusp/detail/config.h>
 #include <cusp/detail/type_traits.h>
+#include <cusp/detail/temporary_array.h>
 
+#include <cusp/array1d.h>
+#include <cusp/exception.h>
 #include <cusp/detail/execution_policy.h>
 
+#include <cusp/graph/vertex_coloring.h>
+
+#include <thrust/binary_search.h>
+#include <thrust/copy.h>
+#include <thrust/count.h>
+#include <thrust/extrema.h>
+#include <thrust/fill.h>
+#include <thrust/for_each.h>
+#include <thrust/gather.h>
+#include <thrust/scan.h>
+#include <thrust/scatter.h>
+#include <thrust/sequence.h>
+#include <thrust/sort.h>
+
+#include <thrust/iterator/constant_iterator.h>
+#include <thrust/iterator/counting_iterator.h>
+#include <thrust/iterator/zip_iterator.h>
+
 namespace cusp
 {
 namespace system
@@ -31,6 +52,604 @@ namespace detail
 namespace generic
 {
 
+namespace coloring
+{
+
+// smallest color not used by the neighbors of v, uncolored neighbors
+// are marked with -1 and ignored
+template <typename IndexType>
+__host__ __device__
+IndexType first_fit(const IndexType * row_offsets,
+                    const IndexType * column_indices,
+                    const IndexType * colors,
+                    const IndexType v)
+{
+    for(IndexType base = 0; ; base += 64)
+    {
+        unsigned long long used = 0;
+
+        for(IndexType jj = row_offsets[v]; jj < row_offsets[v + 1]; jj++)
+        {
+            const IndexType u = column_indices[jj];
+
+            if(u < 0 || u == v)
+                continue;
+
+            const IndexType c = colors[u] - base;
+
+            if(c >= 0 && c < 64)
+                used |= 1ull << c;
+        }
+
+        for(IndexType b = 0; b < 64; b++)
+            if(!((used >> b) & 1ull))
+                return base + b;
+    }
+}
+
+// hashed priority with the vertex index to break ties
+__host__ __device__
+inline unsigned int hash_priority(unsigned int a)
+{
+    a = (a + 0x7ed55d16) + (a << 12);
+    a = (a ^ 0xc761c23c) ^ (a >> 19);
+    a = (a + 0x165667b1) + (a <<  5);
+    a = (a + 0xd3a2646c) ^ (a <<  9);
+    a = (a + 0xfd7046c5) + (a <<  3);
+    a = (a ^ 0xb55a4f09) ^ (a >> 16);
+    return a;
+}
+
+template <typename IndexType>
+__host__ __device__
+bool higher_priority(const IndexType u, const IndexType v)
+{
+    const unsigned int hu = hash_priority(u);
+    const unsigned int hv = hash_priority(v);
+
+    return hu > hv || (hu == hv && u > v);
+}
+
+// an uncolored vertex is selected if its priority exceeds that of all its
+// uncolored neighbors
+template <typename IndexType>
+struct select_local_maxima
+{
+    const IndexType * row_offsets;
+    const IndexType * column_indices;
+    const IndexType * colors;
+    unsigned char * selected;
+
+    select_local_maxima(const IndexType * row_offsets, const IndexType * column_indices,
+                        const IndexType * colors, unsigned char * selected)
+        : row_offsets(row_offsets), column_indices(column_indices),
+          colors(colors), selected(selected) {}
+
+    __host__ __device__
+    void operator()(const IndexType v) const
+    {
+        unsigned char is_max = colors[v] < 0;
+
+        for(IndexType jj = row_offsets[v]; jj < row_offsets[v + 1] && is_max; jj++)
+        {
+            const IndexType u = column_indices[jj];
+
+            if(u >= 0 && u != v && colors[u] < 0 && higher_priority(u, v))
+                is_max = 0;
+        }
+
+        selected[v] = is_max;
+    }
+};
+
+// colors the vertices of an independent set, their neighbors are not
+// written concurrently
+template <typename IndexType>
+struct color_selected
+{
+    const IndexType * row_offsets;
+    const IndexType * column_indices;
+    const unsigned char * selected;
+    IndexType * colors;
+
+    color_selected(const IndexType * row_offsets, const IndexType * column_indices,
+                   const unsigned char * selected, IndexType * colors)
+        : row_offsets(row_offsets), column_indices(column_indices),
+          selected(selected), colors(colors) {}
+
+    __host__ __device__
+    void operator()(const IndexType v) const
+    {
+        if(selected[v])
+            colors[v] = first_fit(row_offsets, column_indices, colors, v);
+    }
+};
+
+// first fit of the vertex vertices[offset + j * stride] against the
+// committed colors, the tentative color is stored in position j
+template <typename IndexType>
+struct tentative_color
+{
+    const IndexType * row_offsets;
+    const IndexType * column_indices;
+    const IndexType * colors;
+    const IndexType * vertices;
+    const IndexType offset;
+    const IndexType stride;
+    IndexType * tentative;
+
+    tentative_color(const IndexType * row_offsets, const IndexType * column_indices,
+                    const IndexType * colors, const IndexType * vertices,
+                    const IndexType offset, const IndexType stride, IndexType * tentative)
+        : row_offsets(row_offsets), column_indices(column_indices), colors(colors),
+          vertices(vertices), offset(offset), stride(stride), tentative(tentative) {}
+
+    __host__ __device__
+    void operator()(const IndexType j) const
+    {
+        tentative[j] = first_fit(row_offsets, column_indices, colors, vertices[offset + j * stride]);
+    }
+};
+
+template <typename IndexType>
+struct commit_color
+{
+    const IndexType * vertices;
+    const IndexType offset;
+    const IndexType stride;
+    const IndexType * tentative;
+    IndexType * colors;
+
+    commit_color(const IndexType * vertices, const IndexType offset, const IndexType stride,
+                 const IndexType * tentative, IndexType * colors)
+        : vertices(vertices), offset(offset), stride(stride),
+          tentative(tentative), colors(colors) {}
+
+    __host__ __device__
+    void operator()(const IndexType j) const
+    {
+        colors[vertices[offset + j * stride]] = tentative[j];
+    }
+};
+
+// the larger endpoint of an edge with equal colors is recolored
+template <typename IndexType>
+struct has_conflict
+{
+    const IndexType * row_offsets;
+    const IndexType * column_indices;
+    const IndexType * colors;
+
+    has_conflict(const IndexType * row_offsets, const IndexType * column_indices,
+                 const IndexType * colors)
+        : row_offsets(row_offsets), column_indices(column_indices), colors(colors) {}
+
+    __host__ __device__
+    bool operator()(const IndexType v) const
+    {
+        for(IndexType jj = row_offsets[v]; jj < row_offsets[v + 1]; jj++)
+        {
+            const IndexType u = column_indices[jj];
+
+            if(u >= 0 && u < v && colors[u] == colors[v])
+                return true;
+        }
+
+        return false;
+    }
+};
+
+template <typename IndexType>
+struct recolor_vertex
+{
+    const IndexType * row_offsets;
+    const IndexType * column_indices;
+    IndexType * colors;
+
+    recolor_vertex(const IndexType * row_offsets, const IndexType * column_indices,
+                   IndexType * colors)
+        : row_offsets(row_offsets), column_indices(column_indices), colors(colors) {}
+
+    __host__ __device__
+    void operator()(const IndexType v) const
+    {
+        colors[v] = first_fit(row_offsets, column_indices, colors, v);
+    }
+};
+
+// the first excess vertices of the class of color c move to the first
+// admissible class below the target size, searching from a class that
+// depends on their rank so the moves are spread over the classes
+template <typename IndexType>
+struct move_to_smaller_class
+{
+    const IndexType * row_offsets;
+    const IndexType * column_indices;
+    const IndexType * class_offsets;
+    const IndexType num_colors;
+    const IndexType target;
+    const IndexType c;
+    IndexType * colors;
+
+    move_to_smaller_class(const IndexType * row_offsets, const IndexType * column_indices,
+                          const IndexType * class_offsets, const IndexType num_colors,
+                          const IndexType target, const IndexType c, IndexType * colors)
+        : row_offsets(row_offsets), column_indices(column_indices), class_offsets(class_offsets),
+          num_colors(num_colors), target(target), c(c), colors(colors) {}
+
+    template <typename Tuple>
+    __host__ __device__
+    void operator()(const Tuple& t) const
+    {
+        const IndexType v    = thrust::get<0>(t);
+        const IndexType rank = thrust::get<1>(t);
+
+        for(IndexType i = 0; i < num_colors; i++)
+        {
+            const IndexType d = (rank + i) % num_colors;
+
+            if(d == c || class_offsets[d + 1] - class_offsets[d] >= target)
+                continue;
+
+            bool admissible = true;
+
+            for(IndexType jj = row_offsets[v]; jj < row_offsets[v + 1] && admissible; jj++)
+            {
+                const IndexType u = column_indices[jj];
+
+                if(u >= 0 && u != v && colors[u] == d)
+                    admissible = false;
+            }
+
+            if(admissible)
+            {
+                colors[v] = d;
+                return;
+            }
+        }
+    }
+};
+
+// renumbers the colors in use to 0, 1, ... and returns their number
+template <typename DerivedPolicy, typename ArrayType>
+size_t compact_colors(thrust::execution_policy<DerivedPolicy>& exec,
+                      ArrayType& colors)
+{
+    typedef typename ArrayType::value_type IndexType;
+
+    if(colors.size() == 0)
+        return 0;
+
+    const IndexType max_color = *thrust::max_element(exec, colors.begin(), colors.end());
+
+    cusp::detail::temporary_array<IndexType, DerivedPolicy> used(exec, max_color + 1, IndexType(0));
+
+    thrust::scatter(exec,
+                    thrust::constant_iterator<IndexType>(1),
+                    thrust::constant_iterator<IndexType>(1) + colors.size(),
+                    colors.begin(), used.begin());
+
+    const size_t num_colors = thrust::count(exec, used.begin(), used.end(), IndexType(1));
+
+    thrust::exclusive_scan(exec, used.begin(), used.end(), used.begin());
+    thrust::gather(exec, colors.begin(), colors.end(), used.begin(), colors.begin());
+
+    return num_colors;
+}
+
+// vertices sorted by color and the offsets of the color classes, a copy
+// of the offsets is kept on the host to launch the class-wise passes
+template <typename DerivedPolicy, typename ArrayType1, typename ArrayType2, typename ArrayType3, typename ArrayType4>
+void color_classes(thrust::execution_policy<DerivedPolicy>& exec,
+                   const ArrayType1& colors,
+                   const size_t num_colors,
+                   ArrayType2& ordering,
+                   ArrayType3& offsets,
+                   ArrayType4& class_offsets)
+{
+    typedef typename ArrayType1::value_type IndexType;
+
+    cusp::detail::temporary_array<IndexType, DerivedPolicy> keys(exec, colors.begin(), colors.end());
+
+    thrust::sequence(exec, ordering.begin(), ordering.end());
+    thrust::stable_sort_by_key(exec, keys.begin(), keys.end(), ordering.begin());
+    thrust::lower_bound(exec,
+                        keys.begin(), keys.end(),
+                        thrust::counting_iterator<IndexType>(0),
+                        thrust::counting_iterator<IndexType>(num_colors + 1),
+                        offsets.begin());
+
+    class_offsets = cusp::array1d<IndexType, cusp::host_memory>(offsets.begin(), offsets.end());
+}
+
+template <typename DerivedPolicy, typename MatrixType, typename ArrayType>
+void jones_plassmann_luby(thrust::execution_policy<DerivedPolicy>& exec,
+                          const MatrixType& G,
+                          ArrayType& colors)
+{
+    typedef typename MatrixType::index_type IndexType;
+
+    const IndexType N = G.num_rows;
+
+    cusp::detail::temporary_array<unsigned char, DerivedPolicy> selected(exec, N);
+
+    const IndexType * row_offsets    = thrust::raw_pointer_cast(&G.row_offsets[0]);
+    const IndexType * column_indices = G.num_entries == 0 ? NULL : thrust::raw_pointer_cast(&G.column_indices[0]);
+
+    thrust::fill(exec, colors.begin(), colors.end(), IndexType(-1));
+
+    size_t num_uncolored = N;
+
+    while(num_uncolored > 0)
+    {
+        thrust::for_each(exec,
+                         thrust::counting_iterator<IndexType>(0),
+                         thrust::counting_iterator<IndexType>(N),
+                         select_local_maxima<IndexType>(row_offsets, column_indices,
+                                                        thrust::raw_pointer_cast(&colors[0]),
+                                                        thrust::raw_pointer_cast(&selected[0])));
+
+        thrust::for_each(exec,
+                         thrust::counting_iterator<IndexType>(0),
+                         thrust::counting_iterator<IndexType>(N),
+                         color_selected<IndexType>(row_offsets, column_indices,
+                                                   thrust::raw_pointer_cast(&selected[0]),
+                                                   thrust::raw_pointer_cast(&colors[0])));
+
+        num_uncolored = thrust::count(exec, colors.begin(), colors.end(), IndexType(-1));
+    }
+}
+
+template <typename DerivedPolicy, typename MatrixType, typename ArrayType>
+void speculative_greedy(thrust::execution_policy<DerivedPolicy>& exec,
+                        const MatrixType& G,
+                        ArrayType& colors)
+{
+    typedef typename MatrixType::index_type IndexType;
+
+    // number of interleaved batches per round, the vertices of a batch only
+    // see the colors of the previous batches
+    const IndexType num_batches = 16;
+
+    const IndexType N = G.num_rows;
+
+    cusp::detail::temporary_array<IndexType, DerivedPolicy> vertices(exec, N);
+    cusp::detail::temporary_array<IndexType, DerivedPolicy> conflicts(exec, N);
+    cusp::detail::temporary_array<IndexType, DerivedPolicy> tentative(exec, N / num_batches + 1);
+
+    const IndexType * row_offsets    = thrust::raw_pointer_cast(&G.row_offsets[0]);
+    const IndexType * column_indices = G.num_entries == 0 ? NULL : thrust::raw_pointer_cast(&G.column_indices[0]);
+
+    thrust::fill(exec, colors.begin(), colors.end(), IndexType(-1));
+    thrust::sequence(exec, vertices.begin(), vertices.end());
+
+    IndexType num_vertices = N;
+
+    while(num_vertices > 0)
+    {
+        for(IndexType batch = 0; batch < num_batches && batch < num_vertices; batch++)
+        {
+            const IndexType batch_size = (num_vertices - batch + num_batches - 1) / num_batches;
+
+            thrust::for_each(exec,
+                             thrust::counting_iterator<IndexType>(0),
+                             thrust::counting_iterator<IndexType>(batch_size),
+                             tentative_color<IndexType>(row_offsets, column_indices,
+                                                        thrust::raw_pointer_cast(&colors[0]),
+                                                        thrust::raw_pointer_cast(&vertices[0]),
+                                                        batch, num_batches,
+                                                        thrust::raw_pointer_cast(&tentative[0])));
+
+            thrust::for_each(exec,
+                             thrust::counting_iterator<IndexType>(0),
+                             thrust::counting_iterator<IndexType>(batch_size),
+                             commit_color<IndexType>(thrust::raw_pointer_cast(&vertices[0]),
+                                                     batch, num_batches,
+                                                     thrust::raw_pointer_cast(&tentative[0]),
+                                                     thrust::raw_pointer_cast(&colors[0])));
+        }
+
+        // conflicts can only occur inside a batch
+        num_vertices = thrust::copy_if(exec,
+                                       vertices.begin(), vertices.begin() + num_vertices,
+                                       conflicts.begin(),
+                                       has_conflict<IndexType>(row_offsets, column_indices,
+                                                               thrust::raw_pointer_cast(&colors[0])))
+                       - conflicts.begin();
+
+        thrust::scatter(exec,
+                        thrust::constant_iterator<IndexType>(-1),
+                        thrust::constant_iterator<IndexType>(-1) + num_vertices,
+                        conflicts.begin(), colors.begin());
+        thrust::copy(exec, conflicts.begin(), conflicts.begin() + num_vertices, vertices.begin());
+    }
+}
+
+// iterated greedy, the vertices are uncolored and recolored by first fit
+// one color class at a time from the last class to the first, the vertices
+// of a class are independent so each class is recolored in parallel and
+// the i-th class recolored gets colors smaller than i
+template <typename DerivedPolicy, typename MatrixType, typename ArrayType>
+size_t reduce_colors(thrust::execution_policy<DerivedPolicy>& exec,
+                     const MatrixType& G,
+                     ArrayType& colors,
+                     size_t num_colors,
+                     const size_t max_colors)
+{
+    typedef typename MatrixType::index_type IndexType;
+
+    const size_t max_passes = 10;
+
+    cusp::detail::temporary_array<IndexType, DerivedPolicy> ordering(exec, G.num_rows);
+    cusp::detail::temporary_array<IndexType, DerivedPolicy> offsets(exec, num_colors + 1);
+    cusp::array1d<IndexType, cusp::host_memory> class_offsets;
+
+    const IndexType * row_offsets    = thrust::raw_pointer_cast(&G.row_offsets[0]);
+    const IndexType * column_indices = G.num_entries == 0 ? NULL : thrust::raw_pointer_cast(&G.column_indices[0]);
+
+    for(size_t pass = 0; pass < max_passes && num_colors > max_colors; pass++)
+    {
+        color_classes(exec, colors, num_colors, ordering, offsets, class_offsets);
+
+        thrust::fill(exec, colors.begin(), colors.end(), IndexType(-1));
+
+        for(size_t c = num_colors; c > 0; c--)
+            thrust::for_each(exec,
+                             ordering.begin() + class_offsets[c - 1],
+                             ordering.begin() + class_offsets[c],
+                             recolor_vertex<IndexType>(row_offsets, column_indices,
+                                                       thrust::raw_pointer_cast(&colors[0])));
+
+        const size_t new_num_colors = compact_colors(exec, colors);
+
+        if(new_num_colors == num_colors)
+            break;
+
+        num_colors = new_num_colors;
+    }
+
+    return num_colors;
+}
+
+// moves vertices out of the color classes that are larger than the average
+template <typename DerivedPolicy, typename MatrixType, typename ArrayType>
+void balance_colors(thrust::execution_policy<DerivedPolicy>& exec,
+                    const MatrixType& G,
+                    ArrayType& colors,
+                    const size_t num_colors)
+{
+    typedef typename MatrixType::index_type IndexType;
+
+    const size_t max_passes = 3;
+    const IndexType N = G.num_rows;
+    const IndexType target = (N + num_colors - 1) / num_colors;
+
+    cusp::detail::temporary_array<IndexType, DerivedPolicy> ordering(exec, N);
+    cusp::detail::temporary_array<IndexType, DerivedPolicy> offsets(exec, num_colors + 1);
+    cusp::array1d<IndexType, cusp::host_memory> class_offsets;
+
+    const IndexType * row_offsets    = thrust::raw_pointer_cast(&G.row_offsets[0]);
+    const IndexType * column_indices = G.num_entries == 0 ? NULL : thrust::raw_pointer_cast(&G.column_indices[0]);
+
+    for(size_t pass = 0; pass < max_passes; pass++)
+    {
+        color_classes(exec, colors, num_colors, ordering, offsets, class_offsets);
+
+        bool balanced = true;
+
+        for(size_t c = 0; c < num_colors; c++)
+            balanced = balanced && class_offsets[c + 1] - class_offsets[c] <= target;
+
+        if(balanced)
+            break;
+
+        // the class sizes seen by the moves are those at the start of the
+        // pass, the rank dependent search order spreads the moved vertices
+        for(size_t c = 0; c < num_colors; c++)
+        {
+            const IndexType excess = class_offsets[c + 1] - class_offsets[c] - target;
+
+            if(excess <= 0)
+                continue;
+
+            thrust::for_each(exec,
+                             thrust::make_zip_iterator(thrust::make_tuple(ordering.begin() + class_offsets[c], thrust::counting_iterator<IndexType>(0))),
+                             thrust::make_zip_iterator(thrust::make_tuple(ordering.begin() + class_offsets[c], thrust::counting_iterator<IndexType>(0))) + excess,
+                             move_to_smaller_class<IndexType>(row_offsets, column_indices,
+                                                              thrust::raw_pointer_cast(&offsets[0]),
+                                                              num_colors, target, c,
+                                                              thrust::raw_pointer_cast(&colors[0])));
+        }
+    }
+}
+
+} // end namespace coloring
+
+template<typename DerivedPolicy,
+         typename MatrixType,
+         typename ArrayType>
+size_t vertex_coloring(thrust::execution_policy<DerivedPolicy>& exec,
+                       const MatrixType& G,
+                             ArrayType& colors,
+                       const cusp::graph::coloring_method method,
+                       const size_t max_colors,
+                       const bool balance,
+                       cusp::csr_format)
+{
+    typedef typename MatrixType::index_type IndexType;
+
+    if(G.num_rows != G.num_cols)
+        throw cusp::invalid_input_exception("matrix must be square");
+
+    if(colors.size() < G.num_rows)
+        throw cusp::invalid_input_exception("colors array is not large enough for result");
+
+    if(G.num_rows == 0)
+        return 0;
+
+    cusp::detail::temporary_array<IndexType, DerivedPolicy> work(exec, G.num_rows);
+
+    switch(method)
+    {
+        case cusp::graph::JONES_PLASSMANN_LUBY:
+            coloring::jones_plassmann_luby(exec, G, work);
+            break;
+        case cusp::graph::SPECULATIVE_GREEDY:
+            coloring::speculative_greedy(exec, G, work);
+            break;
+        default:
+            cusp::graph::vertex_coloring(exec, G, colors);
+            thrust::copy(exec, colors.begin(), colors.begin() + G.num_rows, work.begin());
+    }
+
+    size_t num_colors = coloring::compact_colors(exec, work);
+
+    if(max_colors > 0 && num_colors > max_colors)
+        num_colors = coloring::reduce_colors(exec, G, work, num_colors, max_colors);
+
+    if(balance && num_colors > 1)
+        coloring::balance_colors(exec, G, work, num_colors);
+
+    thrust::copy(exec, work.begin(), work.end(), colors.begin());
+
+    return num_colors;
+}
+
+template<typename DerivedPolicy,
+         typename MatrixType,
+         typename ArrayType>
+size_t vertex_coloring(thrust::execution_policy<DerivedPolicy>& exec,
+                       const MatrixType& G,
+                             ArrayType& colors,
+                       const cusp::graph::coloring_method method,
+                       const size_t max_colors,
+                       const bool balance,
+                       cusp::known_format)
+{
+    typedef typename cusp::detail::as_csr_type<MatrixType>::type CsrMatrix;
+
+    CsrMatrix G_csr(G);
+
+    return cusp::graph::vertex_coloring(exec, G_csr, colors, method, max_colors, balance);
+}
+
+template<typename DerivedPolicy,
+         typename MatrixType,
+         typename ArrayType>
+size_t vertex_coloring(thrust::execution_policy<DerivedPolicy>& exec,
+                       const MatrixType& G,
+                             ArrayType& colors,
+                       const cusp::graph::coloring_method method,
+                       const size_t max_colors,
+                       const bool balance)
+{
+    typedef typename MatrixType::format Format;
+
+    Format format;
+
+    return vertex_coloring(thrust::detail::derived_cast(exec), G, colors, method, max_colors, balance, format);
+}
+
 template<typename DerivedPolicy,
          typename MatrixType,
          typename ArrayType>
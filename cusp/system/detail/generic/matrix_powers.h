@@ -0,0 +1,71 @@
+/*
+ *  Copyright 2008-2014 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+
+#pragma once
+
+#include <cusp/detail/config.h>
+
+#include <cusp/blas/blas.h>
+#include <cusp/multiply.h>
+
+#include <cusp/detail/execution_policy.h>
+
+namespace cusp
+{
+namespace system
+{
+namespace detail
+{
+namespace generic
+{
+
+// one product with A per power, for any format and linear operator
+template <typename DerivedPolicy,
+          typename MatrixType,
+          typename ArrayType,
+          typename Array2dType,
+          typename ShiftArray,
+          typename Format>
+void matrix_powers(thrust::execution_policy<DerivedPolicy>& exec,
+                   const MatrixType& A,
+                   const ArrayType& x,
+                         Array2dType& V,
+                   const ShiftArray& shifts,
+                   Format)
+{
+    typedef typename Array2dType::value_type  ValueType;
+    typedef typename Array2dType::column_view ColumnView;
+
+    ColumnView v0 = V.column(0);
+    cusp::blas::copy(exec, x, v0);
+
+    for(size_t k = 0; k < shifts.size(); k++)
+    {
+        ColumnView vk  = V.column(k);
+        ColumnView vk1 = V.column(k + 1);
+
+        cusp::multiply(exec, A, vk, vk1);
+
+        if(shifts[k] != ValueType(0))
+            cusp::blas::axpy(exec, vk, vk1, -ValueType(shifts[k]));
+    }
+}
+
+} // end namespace generic
+} // end namespace detail
+} // end namespace system
+} // end namespace cusp
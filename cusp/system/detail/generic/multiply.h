@@ -67,6 +67,25 @@ multiply(thrust::execution_policy<DerivedPolicy> &exec,
          BinaryFunction1 combine,
          BinaryFunction2 reduce);
 
+template <typename DerivedPolicy,
+          typename MatrixType,
+          typename VectorType1,
+          typename VectorType2>
+void multiply_transpose(thrust::execution_policy<DerivedPolicy> &exec,
+                        const MatrixType&  A,
+                        const VectorType1& x,
+                              VectorType2& y);
+
+template <typename DerivedPolicy,
+          typename LinearOperator,
+          typename VectorType1,
+          typename VectorType2>
+typename VectorType2::value_type
+multiply_dotc(thrust::execution_policy<DerivedPolicy> &exec,
+              const LinearOperator& A,
+              const VectorType1&    x,
+                    VectorType2&    y);
+
 template <typename DerivedPolicy,
           typename LinearOperator,
           typename MatrixOrVector1,
@@ -82,6 +101,55 @@ void generalized_spgemm(thrust::execution_policy<DerivedPolicy> &exec,
                         BinaryFunction1 combine,
                         BinaryFunction2 reduce);
 
+template <typename DerivedPolicy,
+          typename MatrixType1,
+          typename MatrixType2,
+          typename MatrixType3,
+          typename MatrixType4,
+          typename UnaryFunction,
+          typename BinaryFunction1,
+          typename BinaryFunction2>
+void masked_spgemm(thrust::execution_policy<DerivedPolicy> &exec,
+                   const MatrixType1& A,
+                   const MatrixType2& B,
+                   const MatrixType3& M,
+                   MatrixType4& C,
+                   UnaryFunction   initialize,
+                   BinaryFunction1 combine,
+                   BinaryFunction2 reduce);
+
+template <typename DerivedPolicy,
+          typename MatrixType1,
+          typename MatrixType2,
+          typename MatrixType3,
+          typename PlanType>
+void spgemm_symbolic(thrust::execution_policy<DerivedPolicy> &exec,
+                     const MatrixType1& A,
+                     const MatrixType2& B,
+                           MatrixType3& C,
+                           PlanType& plan);
+
+template <typename DerivedPolicy,
+          typename MatrixType1,
+          typename MatrixType2,
+          typename MatrixType3,
+          typename PlanType>
+void spgemm_numeric(thrust::execution_policy<DerivedPolicy> &exec,
+                    const MatrixType1& A,
+                    const MatrixType2& B,
+                          MatrixType3& C,
+                    const PlanType& plan);
+
+template <typename DerivedPolicy,
+          typename MatrixType1,
+          typename MatrixType2,
+          typename MatrixType3>
+void galerkin_product(thrust::execution_policy<DerivedPolicy> &exec,
+                      const MatrixType1& R,
+                      const MatrixType2& A,
+                      const MatrixType1& P,
+                            MatrixType3& RAP);
+
 template <typename DerivedPolicy,
           typename LinearOperator,
           typename Vector1,
@@ -97,6 +165,20 @@ void generalized_spmv(thrust::execution_policy<DerivedPolicy> &exec,
                       BinaryFunction1 combine,
                       BinaryFunction2 reduce);
 
+template <typename DerivedPolicy,
+          typename MatrixType,
+          typename SparseVector1,
+          typename SparseVector2,
+          typename BinaryFunction1,
+          typename BinaryFunction2>
+void generalized_spmspv(thrust::execution_policy<DerivedPolicy> &exec,
+                        const MatrixType& A,
+                        const SparseVector1& x,
+                              SparseVector2& y,
+                        BinaryFunction1 combine,
+                        BinaryFunction2 reduce,
+                        const cusp::spmspv_method method);
+
 } // end namespace generic
 } // end namespace detail
 } // end namespace system
@@ -21,11 +21,16 @@
 
 #include <cusp/functional.h>
 
+#include <cusp/system/detail/generic/multiply/block_spmv.h>
+#include <cusp/system/detail/generic/multiply/galerkin_product.h>
 #include <cusp/system/detail/generic/multiply/generalized_spmv.h>
 #include <cusp/system/detail/generic/multiply/generalized_spgemm.h>
 #include <cusp/system/detail/generic/multiply/permute.h>
 #include <cusp/system/detail/generic/multiply/spgemm.h>
 #include <cusp/system/detail/generic/multiply/spmv.h>
+#include <cusp/system/detail/generic/multiply/spmspv.h>
+#include <cusp/system/detail/generic/multiply/spmv_dotc.h>
+#include <cusp/system/detail/generic/multiply/transpose_spmv.h>
 
 #include <thrust/functional.h>
 
@@ -95,7 +100,9 @@ multiply(thrust::execution_policy<DerivedPolicy> &exec,
          const MatrixOrVector1& B,
                MatrixOrVector2& C)
 {
-    typedef typename LinearOperator::value_type ValueType;
+    // the result type determines the precision of the computation, which
+    // allows the entries of A to be stored in a narrower type than x and y
+    typedef typename MatrixOrVector2::value_type ValueType;
 
     cusp::constant_functor<ValueType> initialize(0);
     thrust::multiplies<ValueType> combine;
@@ -131,6 +138,47 @@ multiply(thrust::execution_policy<DerivedPolicy> &exec,
     multiply(thrust::detail::derived_cast(exec), A, B, C, initialize, combine, reduce, format1, format2, format3);
 }
 
+template <typename DerivedPolicy,
+         typename MatrixType,
+         typename VectorType1,
+         typename VectorType2>
+void multiply_transpose(thrust::execution_policy<DerivedPolicy> &exec,
+                        const MatrixType&  A,
+                        const VectorType1& x,
+                              VectorType2& y)
+{
+    typedef typename MatrixType::format  Format1;
+    typedef typename VectorType1::format Format2;
+    typedef typename VectorType2::format Format3;
+
+    Format1 format1;
+    Format2 format2;
+    Format3 format3;
+
+    multiply_transpose(thrust::detail::derived_cast(exec), A, x, y, format1, format2, format3);
+}
+
+template <typename DerivedPolicy,
+         typename LinearOperator,
+         typename VectorType1,
+         typename VectorType2>
+typename VectorType2::value_type
+multiply_dotc(thrust::execution_policy<DerivedPolicy> &exec,
+              const LinearOperator& A,
+              const VectorType1&    x,
+                    VectorType2&    y)
+{
+    typedef typename LinearOperator::format Format1;
+    typedef typename VectorType1::format    Format2;
+    typedef typename VectorType2::format    Format3;
+
+    Format1 format1;
+    Format2 format2;
+    Format3 format3;
+
+    return multiply_dotc(thrust::detail::derived_cast(exec), A, x, y, format1, format2, format3);
+}
+
 template <typename DerivedPolicy,
          typename LinearOperator,
          typename MatrixOrVector1,
@@ -157,6 +205,104 @@ void generalized_spgemm(thrust::execution_policy<DerivedPolicy> &exec,
     generalized_spgemm(exec, A, B, C, initialize, combine, reduce, format1, format2, format3);
 }
 
+template <typename DerivedPolicy,
+         typename MatrixType1,
+         typename MatrixType2,
+         typename MatrixType3,
+         typename MatrixType4,
+         typename UnaryFunction,
+         typename BinaryFunction1,
+         typename BinaryFunction2>
+void masked_spgemm(thrust::execution_policy<DerivedPolicy> &exec,
+                   const MatrixType1& A,
+                   const MatrixType2& B,
+                   const MatrixType3& M,
+                   MatrixType4& C,
+                   UnaryFunction   initialize,
+                   BinaryFunction1 combine,
+                   BinaryFunction2 reduce)
+{
+    typedef typename MatrixType1::format Format1;
+    typedef typename MatrixType2::format Format2;
+    typedef typename MatrixType3::format Format3;
+
+    Format1 format1;
+    Format2 format2;
+    Format3 format3;
+
+    masked_spgemm(exec, A, B, M, C, initialize, combine, reduce, format1, format2, format3);
+}
+
+template <typename DerivedPolicy,
+         typename MatrixType1,
+         typename MatrixType2,
+         typename MatrixType3,
+         typename PlanType>
+void spgemm_symbolic(thrust::execution_policy<DerivedPolicy> &exec,
+                     const MatrixType1& A,
+                     const MatrixType2& B,
+                           MatrixType3& C,
+                           PlanType& plan)
+{
+    typedef typename MatrixType1::format Format1;
+    typedef typename MatrixType2::format Format2;
+    typedef typename MatrixType3::format Format3;
+
+    Format1 format1;
+    Format2 format2;
+    Format3 format3;
+
+    spgemm_symbolic(thrust::detail::derived_cast(exec), A, B, C, plan, format1, format2, format3);
+}
+
+template <typename DerivedPolicy,
+         typename MatrixType1,
+         typename MatrixType2,
+         typename MatrixType3,
+         typename PlanType>
+void spgemm_numeric(thrust::execution_policy<DerivedPolicy> &exec,
+                    const MatrixType1& A,
+                    const MatrixType2& B,
+                          MatrixType3& C,
+                    const PlanType& plan)
+{
+    typedef typename MatrixType3::value_type ValueType;
+
+    typedef typename MatrixType1::format Format1;
+    typedef typename MatrixType2::format Format2;
+    typedef typename MatrixType3::format Format3;
+
+    thrust::multiplies<ValueType> combine;
+    thrust::plus<ValueType> reduce;
+
+    Format1 format1;
+    Format2 format2;
+    Format3 format3;
+
+    spgemm_numeric(thrust::detail::derived_cast(exec), A, B, C, plan, combine, reduce, format1, format2, format3);
+}
+
+template <typename DerivedPolicy,
+         typename MatrixType1,
+         typename MatrixType2,
+         typename MatrixType3>
+void galerkin_product(thrust::execution_policy<DerivedPolicy> &exec,
+                      const MatrixType1& R,
+                      const MatrixType2& A,
+                      const MatrixType1& P,
+                            MatrixType3& RAP)
+{
+    typedef typename MatrixType1::format Format1;
+    typedef typename MatrixType2::format Format2;
+    typedef typename MatrixType3::format Format3;
+
+    Format1 format1;
+    Format2 format2;
+    Format3 format3;
+
+    galerkin_product(thrust::detail::derived_cast(exec), R, A, P, RAP, format1, format2, format3);
+}
+
 template <typename DerivedPolicy,
          typename LinearOperator,
          typename Vector1,
@@ -182,7 +328,28 @@ void generalized_spmv(thrust::execution_policy<DerivedPolicy> &exec,
     Format3 format3;
     Format4 format4;
 
-    generalized_spmv(exec, A, x, y, z, combine, reduce, format1, format2, format3, format4);
+    generalized_spmv(thrust::detail::derived_cast(exec), A, x, y, z, combine, reduce, format1, format2, format3, format4);
+}
+
+template <typename DerivedPolicy,
+          typename MatrixType,
+          typename SparseVector1,
+          typename SparseVector2,
+          typename BinaryFunction1,
+          typename BinaryFunction2>
+void generalized_spmspv(thrust::execution_policy<DerivedPolicy> &exec,
+                        const MatrixType& A,
+                        const SparseVector1& x,
+                              SparseVector2& y,
+                        BinaryFunction1 combine,
+                        BinaryFunction2 reduce,
+                        const cusp::spmspv_method method)
+{
+    typedef typename MatrixType::format Format;
+
+    Format format;
+
+    generalized_spmspv(exec, A, x, y, combine, reduce, method, format);
 }
 
 } // end namespace generic
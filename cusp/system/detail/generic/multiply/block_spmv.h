@@ -0,0 +1,257 @@
+/*
+ *  Copyright 2008-2014 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#pragma once
+
+#include <cusp/detail/config.h>
+#include <cusp/detail/execution_policy.h>
+#include <cusp/detail/format.h>
+#include <cusp/detail/array2d_format_utils.h>
+
+#include <thrust/for_each.h>
+#include <thrust/iterator/counting_iterator.h>
+
+namespace cusp
+{
+namespace system
+{
+namespace detail
+{
+namespace generic
+{
+
+// The functors below multiply an ELL or HYB matrix by a dense matrix with
+// k columns using one thread per row.  Every entry of the row is combined
+// with the k entries of the corresponding row of x before the next entry
+// is loaded, so the matrix is read once regardless of k.
+
+template <typename IndexType, typename MatrixValueType,
+          typename ValueType1, typename ValueType2,
+          typename Orientation1, typename Orientation2,
+          typename UnaryFunction, typename BinaryFunction1, typename BinaryFunction2>
+struct ell_block_spmv_functor
+{
+    IndexType num_entries_per_row;
+    IndexType pitch;
+    const IndexType * Aj;
+    const MatrixValueType * Ax;
+    IndexType invalid_index;
+
+    IndexType num_vectors;
+    IndexType x_pitch;
+    IndexType y_pitch;
+    const ValueType1 * x;
+    ValueType2 * y;
+
+    UnaryFunction   initialize;
+    BinaryFunction1 combine;
+    BinaryFunction2 reduce;
+
+    ell_block_spmv_functor(IndexType num_entries_per_row, IndexType pitch,
+                           const IndexType * Aj, const MatrixValueType * Ax, IndexType invalid_index,
+                           IndexType num_vectors, IndexType x_pitch, IndexType y_pitch,
+                           const ValueType1 * x, ValueType2 * y,
+                           UnaryFunction initialize, BinaryFunction1 combine, BinaryFunction2 reduce)
+        : num_entries_per_row(num_entries_per_row), pitch(pitch),
+          Aj(Aj), Ax(Ax), invalid_index(invalid_index),
+          num_vectors(num_vectors), x_pitch(x_pitch), y_pitch(y_pitch), x(x), y(y),
+          initialize(initialize), combine(combine), reduce(reduce) {}
+
+    __host__ __device__
+    void accumulate(const IndexType i, const IndexType j, const MatrixValueType Aij) const
+    {
+        for(IndexType k = 0; k < num_vectors; k++)
+        {
+            const IndexType xk = cusp::detail::index_of(j, k, x_pitch, Orientation1());
+            const IndexType yk = cusp::detail::index_of(i, k, y_pitch, Orientation2());
+
+            y[yk] = reduce(y[yk], combine(Aij, x[xk]));
+        }
+    }
+
+    __host__ __device__
+    void ell_row(const IndexType i) const
+    {
+        for(IndexType k = 0; k < num_vectors; k++)
+        {
+            const IndexType yk = cusp::detail::index_of(i, k, y_pitch, Orientation2());
+            y[yk] = initialize(y[yk]);
+        }
+
+        for(IndexType n = 0, offset = i; n < num_entries_per_row; n++, offset += pitch)
+        {
+            const IndexType j = Aj[offset];
+
+            if(j != invalid_index)
+                accumulate(i, j, Ax[offset]);
+        }
+    }
+
+    __host__ __device__
+    void operator()(const IndexType i) const
+    {
+        ell_row(i);
+    }
+};
+
+// the COO tail is sorted by row, the entries of row i are found by a binary search
+template <typename IndexType, typename MatrixValueType,
+          typename ValueType1, typename ValueType2,
+          typename Orientation1, typename Orientation2,
+          typename UnaryFunction, typename BinaryFunction1, typename BinaryFunction2>
+struct hyb_block_spmv_functor
+  : public ell_block_spmv_functor<IndexType,MatrixValueType,ValueType1,ValueType2,
+                                  Orientation1,Orientation2,
+                                  UnaryFunction,BinaryFunction1,BinaryFunction2>
+{
+    typedef ell_block_spmv_functor<IndexType,MatrixValueType,ValueType1,ValueType2,
+                                   Orientation1,Orientation2,
+                                   UnaryFunction,BinaryFunction1,BinaryFunction2> ELL;
+
+    IndexType num_coo_entries;
+    const IndexType * Ci;
+    const IndexType * Cj;
+    const MatrixValueType * Cx;
+
+    hyb_block_spmv_functor(const ELL& ell, IndexType num_coo_entries,
+                           const IndexType * Ci, const IndexType * Cj, const MatrixValueType * Cx)
+        : ELL(ell), num_coo_entries(num_coo_entries), Ci(Ci), Cj(Cj), Cx(Cx) {}
+
+    __host__ __device__
+    void operator()(const IndexType i) const
+    {
+        ELL::ell_row(i);
+
+        IndexType first = 0;
+        IndexType last  = num_coo_entries;
+
+        while(first < last)
+        {
+            const IndexType middle = (first + last) / 2;
+
+            if(Ci[middle] < i)
+                first = middle + 1;
+            else
+                last = middle;
+        }
+
+        for(IndexType jj = first; jj < num_coo_entries && Ci[jj] == i; jj++)
+            ELL::accumulate(i, Cj[jj], Cx[jj]);
+    }
+};
+
+template <typename ArrayType>
+typename ArrayType::value_type * block_spmv_pointer(ArrayType& array)
+{
+    return array.size() == 0 ? 0 : thrust::raw_pointer_cast(&array[0]);
+}
+
+template <typename ArrayType>
+const typename ArrayType::value_type * block_spmv_pointer(const ArrayType& array)
+{
+    return array.size() == 0 ? 0 : thrust::raw_pointer_cast(&array[0]);
+}
+
+template <typename MatrixType, typename VectorType1, typename VectorType2,
+          typename UnaryFunction, typename BinaryFunction1, typename BinaryFunction2>
+ell_block_spmv_functor<typename MatrixType::index_type, typename MatrixType::value_type,
+                       typename VectorType1::value_type, typename VectorType2::value_type,
+                       typename VectorType1::orientation, typename VectorType2::orientation,
+                       UnaryFunction, BinaryFunction1, BinaryFunction2>
+make_ell_block_spmv_functor(const MatrixType& A, const VectorType1& x, VectorType2& y,
+                            UnaryFunction initialize, BinaryFunction1 combine, BinaryFunction2 reduce)
+{
+    typedef typename MatrixType::index_type IndexType;
+
+    typedef ell_block_spmv_functor<IndexType, typename MatrixType::value_type,
+                                   typename VectorType1::value_type, typename VectorType2::value_type,
+                                   typename VectorType1::orientation, typename VectorType2::orientation,
+                                   UnaryFunction, BinaryFunction1, BinaryFunction2> Functor;
+
+    return Functor(IndexType(A.column_indices.num_cols), IndexType(A.column_indices.pitch),
+                   block_spmv_pointer(A.column_indices.values), block_spmv_pointer(A.values.values),
+                   IndexType(MatrixType::invalid_index),
+                   IndexType(x.num_cols), IndexType(x.pitch), IndexType(y.pitch),
+                   block_spmv_pointer(x.values), block_spmv_pointer(y.values),
+                   initialize, combine, reduce);
+}
+
+template <typename DerivedPolicy,
+          typename MatrixType,
+          typename VectorType1,
+          typename VectorType2,
+          typename UnaryFunction,
+          typename BinaryFunction1,
+          typename BinaryFunction2>
+void multiply(thrust::execution_policy<DerivedPolicy>& exec,
+              const MatrixType& A,
+              const VectorType1& x,
+              VectorType2& y,
+              UnaryFunction   initialize,
+              BinaryFunction1 combine,
+              BinaryFunction2 reduce,
+              cusp::ell_format,
+              cusp::array2d_format,
+              cusp::array2d_format)
+{
+    typedef typename MatrixType::index_type IndexType;
+
+    thrust::for_each(exec,
+                     thrust::counting_iterator<IndexType>(0),
+                     thrust::counting_iterator<IndexType>(A.num_rows),
+                     make_ell_block_spmv_functor(A, x, y, initialize, combine, reduce));
+}
+
+template <typename DerivedPolicy,
+          typename MatrixType,
+          typename VectorType1,
+          typename VectorType2,
+          typename UnaryFunction,
+          typename BinaryFunction1,
+          typename BinaryFunction2>
+void multiply(thrust::execution_policy<DerivedPolicy>& exec,
+              const MatrixType& A,
+              const VectorType1& x,
+              VectorType2& y,
+              UnaryFunction   initialize,
+              BinaryFunction1 combine,
+              BinaryFunction2 reduce,
+              cusp::hyb_format,
+              cusp::array2d_format,
+              cusp::array2d_format)
+{
+    typedef typename MatrixType::index_type IndexType;
+    typedef typename MatrixType::value_type MatrixValueType;
+
+    typedef hyb_block_spmv_functor<IndexType, MatrixValueType,
+                                   typename VectorType1::value_type, typename VectorType2::value_type,
+                                   typename VectorType1::orientation, typename VectorType2::orientation,
+                                   UnaryFunction, BinaryFunction1, BinaryFunction2> Functor;
+
+    thrust::for_each(exec,
+                     thrust::counting_iterator<IndexType>(0),
+                     thrust::counting_iterator<IndexType>(A.num_rows),
+                     Functor(make_ell_block_spmv_functor(A.ell, x, y, initialize, combine, reduce),
+                             IndexType(A.coo.num_entries),
+                             block_spmv_pointer(A.coo.row_indices),
+                             block_spmv_pointer(A.coo.column_indices),
+                             block_spmv_pointer(A.coo.values)));
+}
+
+} // end namespace generic
+} // end namespace detail
+} // end namespace system
+} // end namespace cusp
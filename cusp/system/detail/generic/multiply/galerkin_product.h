@@ -0,0 +1,53 @@
+/*
+ *  Copyright 2008-2014 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#pragma once
+
+#include <cusp/detail/config.h>
+#include <cusp/detail/format.h>
+
+namespace cusp
+{
+namespace system
+{
+namespace detail
+{
+namespace generic
+{
+
+template <typename DerivedPolicy,
+          typename MatrixType1,
+          typename MatrixType2,
+          typename MatrixType3>
+void galerkin_product(thrust::execution_policy<DerivedPolicy> &exec,
+                      const MatrixType1& R,
+                      const MatrixType2& A,
+                      const MatrixType1& P,
+                            MatrixType3& RAP,
+                      cusp::sparse_format,
+                      cusp::sparse_format,
+                      cusp::sparse_format)
+{
+    // TODO test speed of R * (A * P) vs. (R * A) * P
+    MatrixType3 AP;
+    cusp::multiply(exec, A, P, AP);
+    cusp::multiply(exec, R, AP, RAP);
+}
+
+} // end namespace generic
+} // end namespace detail
+} // end namespace system
+} // end namespace cusp
@@ -26,13 +26,20 @@
 #include <cusp/csr_matrix.h>
 #include <cusp/functional.h>
 
+#include <thrust/copy.h>
+#include <thrust/functional.h>
 #include <thrust/reduce.h>
+#include <thrust/remove.h>
+#include <thrust/sequence.h>
+#include <thrust/sort.h>
+#include <thrust/transform.h>
 
 #include <thrust/system/detail/generic/tag.h>
 #include <thrust/iterator/counting_iterator.h>
 #include <thrust/iterator/discard_iterator.h>
 #include <thrust/iterator/permutation_iterator.h>
 #include <thrust/iterator/transform_iterator.h>
+#include <thrust/iterator/zip_iterator.h>
 
 namespace cusp
 {
@@ -125,6 +132,68 @@ struct sparse_inner_functor
     }
 };
 
+// like sparse_inner_functor, but also reports whether A(row,:) and B(:,col)
+// share any index, so that empty entries of the mask can be dropped
+template<typename MatrixType1,
+         typename MatrixType2,
+         typename ArrayType,
+         typename UnaryFunction,
+         typename BinaryFunction1,
+         typename BinaryFunction2>
+struct masked_inner_functor
+  : public sparse_inner_functor<MatrixType1,MatrixType2,ArrayType,UnaryFunction,BinaryFunction1,BinaryFunction2>
+{
+    typedef sparse_inner_functor<MatrixType1,MatrixType2,ArrayType,UnaryFunction,BinaryFunction1,BinaryFunction2> Parent;
+
+    typedef typename Parent::IndexType IndexType;
+    typedef typename Parent::ValueType ValueType;
+
+    masked_inner_functor(const MatrixType1& A,
+                         const MatrixType2& B,
+                         const ArrayType& A_row_offsets,
+                         const ArrayType& B_row_offsets,
+                         const ArrayType& permutation,
+                         UnaryFunction   initialize,
+                         BinaryFunction1 combine,
+                         BinaryFunction2 reduce)
+        : Parent(A, B, A_row_offsets, B_row_offsets, permutation, initialize, combine, reduce)
+    {}
+
+    template <typename Tuple>
+    __host__ __device__
+    thrust::tuple<ValueType,bool> operator()(const Tuple& t) const
+    {
+        IndexType row = thrust::get<0>(t);
+        IndexType col = thrust::get<1>(t);
+        ValueType sum = Parent::initialize(ValueType(0));
+        bool found = false;
+
+        int A_pos = Parent::A_row_offsets[row];
+        int A_end = Parent::A_row_offsets[row + 1];
+        int B_pos = Parent::B_row_offsets[col];
+        int B_end = Parent::B_row_offsets[col + 1];
+
+        while(A_pos < A_end && B_pos < B_end) {
+            IndexType perm = Parent::permutation[B_pos];
+            IndexType A_j  = Parent::A_column_indices[A_pos];
+            IndexType B_j  = Parent::B_row_indices[perm];
+
+            if(A_j == B_j) {
+                sum = Parent::reduce(sum, Parent::combine(Parent::A_values[A_pos], Parent::B_values[perm]));
+                found = true;
+                A_pos++;
+                B_pos++;
+            } else if (A_j < B_j) {
+                A_pos++;
+            } else {
+                B_pos++;
+            }
+        }
+
+        return thrust::make_tuple(sum, found);
+    }
+};
+
 template <typename DerivedPolicy,
          typename LinearOperator,
          typename MatrixOrVector1,
@@ -208,6 +277,115 @@ void generalized_spgemm(thrust::execution_policy<DerivedPolicy>& exec,
     cusp::convert(exec, C_, C);
 }
 
+template <typename DerivedPolicy,
+          typename MatrixType1,
+          typename MatrixType2,
+          typename MatrixType3,
+          typename MatrixType4,
+          typename UnaryFunction,
+          typename BinaryFunction1,
+          typename BinaryFunction2>
+void masked_spgemm(thrust::execution_policy<DerivedPolicy>& exec,
+                   const MatrixType1& A,
+                   const MatrixType2& B,
+                   const MatrixType3& M,
+                         MatrixType4& C,
+                   UnaryFunction   initialize,
+                   BinaryFunction1 combine,
+                   BinaryFunction2 reduce,
+                   cusp::coo_format,
+                   cusp::coo_format,
+                   cusp::coo_format)
+{
+    typedef typename MatrixType4::index_type   IndexType;
+    typedef typename MatrixType4::value_type   ValueType;
+    typedef typename MatrixType4::memory_space MemorySpace;
+
+    typedef cusp::detail::temporary_array<IndexType, DerivedPolicy> ArrayType;
+    typedef masked_inner_functor<MatrixType1, MatrixType2, ArrayType, UnaryFunction, BinaryFunction1, BinaryFunction2> InnerOp;
+
+    if(M.num_entries == 0 || A.num_entries == 0 || B.num_entries == 0)
+    {
+        C.resize(A.num_rows, B.num_cols, 0);
+        return;
+    }
+
+    // visit B by columns
+    ArrayType B_row_offsets(exec, B.num_cols + 1);
+    ArrayType permutation(exec, B.num_entries);
+    thrust::sequence(exec, permutation.begin(), permutation.end());
+
+    {
+        ArrayType indices(exec, B.column_indices);
+        thrust::sort_by_key(exec, indices.begin(), indices.end(), permutation.begin());
+        cusp::indices_to_offsets(exec, indices, B_row_offsets);
+    }
+
+    ArrayType A_row_offsets(exec, A.num_rows + 1);
+    cusp::indices_to_offsets(exec, A.row_indices, A_row_offsets);
+
+    InnerOp inner_op(A, B, A_row_offsets, B_row_offsets, permutation, initialize, combine, reduce);
+
+    // one inner product per entry of the mask
+    cusp::coo_matrix<IndexType, ValueType, MemorySpace> C_(A.num_rows, B.num_cols, M.num_entries);
+    cusp::detail::temporary_array<bool, DerivedPolicy> found(exec, M.num_entries);
+
+    thrust::copy(exec, M.row_indices.begin(),    M.row_indices.end(),    C_.row_indices.begin());
+    thrust::copy(exec, M.column_indices.begin(), M.column_indices.end(), C_.column_indices.begin());
+
+    thrust::transform(exec,
+                      thrust::make_zip_iterator(thrust::make_tuple(M.row_indices.begin(), M.column_indices.begin())),
+                      thrust::make_zip_iterator(thrust::make_tuple(M.row_indices.end(),   M.column_indices.end())),
+                      thrust::make_zip_iterator(thrust::make_tuple(C_.values.begin(), found.begin())),
+                      inner_op);
+
+    // drop entries of the mask without any product
+    size_t num_entries =
+        thrust::remove_if(exec,
+            thrust::make_zip_iterator(thrust::make_tuple(C_.row_indices.begin(), C_.column_indices.begin(), C_.values.begin())),
+            thrust::make_zip_iterator(thrust::make_tuple(C_.row_indices.end(),   C_.column_indices.end(),   C_.values.end())),
+            found.begin(),
+            thrust::logical_not<bool>()) -
+        thrust::make_zip_iterator(thrust::make_tuple(C_.row_indices.begin(), C_.column_indices.begin(), C_.values.begin()));
+
+    C_.resize(A.num_rows, B.num_cols, num_entries);
+
+    cusp::convert(exec, C_, C);
+}
+
+template <typename DerivedPolicy,
+          typename MatrixType1,
+          typename MatrixType2,
+          typename MatrixType3,
+          typename MatrixType4,
+          typename UnaryFunction,
+          typename BinaryFunction1,
+          typename BinaryFunction2>
+void masked_spgemm(thrust::execution_policy<DerivedPolicy>& exec,
+                   const MatrixType1& A,
+                   const MatrixType2& B,
+                   const MatrixType3& M,
+                         MatrixType4& C,
+                   UnaryFunction   initialize,
+                   BinaryFunction1 combine,
+                   BinaryFunction2 reduce,
+                   cusp::sparse_format,
+                   cusp::sparse_format,
+                   cusp::sparse_format)
+{
+    // other formats use COO views
+    typedef typename MatrixType1::const_coo_view_type CooMatrix1;
+    typedef typename MatrixType2::const_coo_view_type CooMatrix2;
+    typedef typename MatrixType3::const_coo_view_type CooMatrix3;
+
+    CooMatrix1 A_(A);
+    CooMatrix2 B_(B);
+    CooMatrix3 M_(M);
+
+    masked_spgemm(exec, A_, B_, M_, C, initialize, combine, reduce,
+                  cusp::coo_format(), cusp::coo_format(), cusp::coo_format());
+}
+
 } // end namespace generic
 } // end namespace detail
 } // end namespace system
@@ -95,7 +95,7 @@ void multiply(thrust::execution_policy<DerivedPolicy> &exec,
               cusp::coo_format,
               cusp::coo_format)
 {
-    C.resize(B.num_rows, B.num_cols, B.num_entries);
+    C.resize(B.num_rows, B.num_cols, B.num_entries, cusp::no_init);
 
     thrust::gather(exec, B.row_indices.begin(), B.row_indices.end(), A.permutation.begin(), C.row_indices.begin());
 
@@ -123,7 +123,7 @@ void multiply(thrust::execution_policy<DerivedPolicy> &exec,
               cusp::permutation_format,
               cusp::coo_format)
 {
-    C.resize(A.num_rows, A.num_cols, A.num_entries);
+    C.resize(A.num_rows, A.num_cols, A.num_entries, cusp::no_init);
 
     thrust::gather(exec, A.column_indices.begin(), A.column_indices.end(), B.permutation.begin(), C.column_indices.begin());
 
@@ -16,19 +16,26 @@
 
 #include <cusp/detail/temporary_array.h>
 
+#include <cusp/system/detail/generic/multiply/spgemm_workspace.h>
+
 #include <cusp/array1d.h>
 #include <cusp/coo_matrix.h>
+#include <cusp/exception.h>
 #include <cusp/format_utils.h>
 #include <cusp/sort.h>
 
 #include <thrust/gather.h>
 #include <thrust/scan.h>
 #include <thrust/scatter.h>
+#include <thrust/sequence.h>
+#include <thrust/unique.h>
 #include <thrust/transform.h>
 #include <thrust/reduce.h>
 #include <thrust/inner_product.h>
 #include <thrust/iterator/zip_iterator.h>
 #include <thrust/iterator/permutation_iterator.h>
+#include <thrust/iterator/transform_iterator.h>
+#include <thrust/iterator/discard_iterator.h>
 
 #include <limits>
 #include <list>
@@ -42,6 +49,94 @@ namespace detail
 namespace generic
 {
 
+// computes the row offsets of B and, for each entry A(i,j), the number of
+// products generated with row B(j,:) together with their output offsets
+template <typename DerivedPolicy,
+          typename MatrixType1,
+          typename MatrixType2,
+          typename ArrayType>
+size_t coo_spmm_segments(thrust::execution_policy<DerivedPolicy>& exec,
+                         const MatrixType1& A,
+                         const MatrixType2& B,
+                         ArrayType& B_row_offsets,
+                         ArrayType& segment_lengths,
+                         ArrayType& output_ptr)
+{
+    typedef typename ArrayType::value_type IndexType;
+
+    // compute row offsets for B
+    cusp::indices_to_offsets(exec, B.row_indices, B_row_offsets);
+
+    // compute row lengths for B
+    cusp::detail::temporary_array<IndexType,DerivedPolicy> B_row_lengths(exec, B.num_rows);
+    thrust::transform(exec,
+                      B_row_offsets.begin() + 1,
+                      B_row_offsets.end(),
+                      B_row_offsets.begin(),
+                      B_row_lengths.begin(),
+                      thrust::minus<IndexType>());
+
+    // for each element A(i,j) compute the number of nonzero elements in B(j,:)
+    thrust::gather(exec,
+                   A.column_indices.begin(),
+                   A.column_indices.end(),
+                   B_row_lengths.begin(),
+                   segment_lengths.begin());
+
+    // output pointer
+    thrust::exclusive_scan(exec,
+                           segment_lengths.begin(),
+                           segment_lengths.end(),
+                           output_ptr.begin(),
+                           IndexType(0));
+
+    output_ptr[A.num_entries] = output_ptr[A.num_entries - 1] + segment_lengths[A.num_entries - 1]; // XXX is this necessary?
+
+    return output_ptr[A.num_entries];
+}
+
+// computes the locations in A and B of the entries combined by each product
+// A(i,j) * B(j,k) generated by the segments [begin_segment, end_segment) of A
+template <typename DerivedPolicy,
+          typename MatrixType,
+          typename ArrayType1,
+          typename ArrayType2>
+void coo_spmm_expand(thrust::execution_policy<DerivedPolicy>& exec,
+                     size_t begin_segment,
+                     size_t end_segment,
+                     const MatrixType& A,
+                     const ArrayType1& B_row_offsets,
+                     const ArrayType1& segment_lengths,
+                     const ArrayType1& output_ptr,
+                     ArrayType2& A_gather_locations,
+                     ArrayType2& B_gather_locations)
+{
+    typedef typename ArrayType1::value_type IndexType;
+
+    // compute gather locations of intermediate format
+    thrust::fill(exec, A_gather_locations.begin(), A_gather_locations.end(), 0);
+    thrust::scatter_if(exec,
+                       thrust::counting_iterator<IndexType>(begin_segment), thrust::counting_iterator<IndexType>(end_segment),
+                       output_ptr.begin() + begin_segment,
+                       segment_lengths.begin() + begin_segment,
+                       A_gather_locations.begin() - output_ptr[begin_segment]);
+    thrust::inclusive_scan(exec, A_gather_locations.begin(), A_gather_locations.end(), A_gather_locations.begin(), thrust::maximum<IndexType>());
+
+    // compute gather locations of intermediate format
+    thrust::fill(exec, B_gather_locations.begin(), B_gather_locations.end(), 1);
+    thrust::scatter_if(exec,
+                       thrust::make_permutation_iterator(B_row_offsets.begin(), A.column_indices.begin()) + begin_segment,
+                       thrust::make_permutation_iterator(B_row_offsets.begin(), A.column_indices.begin()) + end_segment,
+                       output_ptr.begin() + begin_segment,
+                       segment_lengths.begin() + begin_segment,
+                       B_gather_locations.begin() - output_ptr[begin_segment]);
+    thrust::inclusive_scan_by_key(exec,
+                                  A_gather_locations.begin(),
+                                  A_gather_locations.end(),
+                                  B_gather_locations.begin(),
+                                  B_gather_locations.begin());
+}
+
 template <typename DerivedPolicy,
           typename MatrixType1,
           typename MatrixType2,
@@ -85,29 +180,12 @@ void coo_spmm_helper(thrust::execution_policy<DerivedPolicy>& exec,
         return;
     }
 
-    // compute gather locations of intermediate format
-    thrust::fill(exec, A_gather_locations.begin(), A_gather_locations.end(), 0);
-    thrust::scatter_if(exec,
-                       thrust::counting_iterator<IndexType>(begin_segment), thrust::counting_iterator<IndexType>(end_segment),
-                       output_ptr.begin() + begin_segment,
-                       segment_lengths.begin() + begin_segment,
-                       A_gather_locations.begin() - output_ptr[begin_segment]);
-    thrust::inclusive_scan(exec, A_gather_locations.begin(), A_gather_locations.end(), A_gather_locations.begin(), thrust::maximum<IndexType>());
-
-    // compute gather locations of intermediate format
-    thrust::fill(exec, B_gather_locations.begin(), B_gather_locations.end(), 1);
-    thrust::scatter_if(exec,
-                       thrust::make_permutation_iterator(B_row_offsets.begin(), A.column_indices.begin()) + begin_segment,
-                       thrust::make_permutation_iterator(B_row_offsets.begin(), A.column_indices.begin()) + end_segment,
-                       output_ptr.begin() + begin_segment,
-                       segment_lengths.begin() + begin_segment,
-                       B_gather_locations.begin() - output_ptr[begin_segment]);
-    thrust::inclusive_scan_by_key(exec,
-                                  A_gather_locations.begin(),
-                                  A_gather_locations.end(),
-                                  B_gather_locations.begin(),
-                                  B_gather_locations.begin());
-
+    // expand the products A(i,j) * B(j,k) of the segments
+    coo_spmm_expand(exec,
+                    begin_segment, end_segment,
+                    A, B_row_offsets,
+                    segment_lengths, output_ptr,
+                    A_gather_locations, B_gather_locations);
 
     thrust::gather(exec,
                    A_gather_locations.begin(), A_gather_locations.end(),
@@ -138,7 +216,7 @@ void coo_spmm_helper(thrust::execution_policy<DerivedPolicy>& exec,
                                           thrust::not_equal_to< thrust::tuple<IndexType,IndexType> >()) + 1;
 
     // allocate space for output
-    C.resize(A.num_rows, B.num_cols, NNZ);
+    C.resize(A.num_rows, B.num_cols, NNZ, cusp::no_init);
 
     // sum values with the same (i,j)
     thrust::reduce_by_key
@@ -181,50 +259,14 @@ void multiply(thrust::execution_policy<DerivedPolicy>& exec,
         return;
     }
 
-    // compute row offsets for B
     cusp::detail::temporary_array<IndexType,DerivedPolicy> B_row_offsets(exec, B.num_rows + 1);
-    cusp::indices_to_offsets(exec, B.row_indices, B_row_offsets);
-
-    // compute row lengths for B
-    cusp::detail::temporary_array<IndexType,DerivedPolicy> B_row_lengths(exec, B.num_rows);
-    thrust::transform(exec,
-                      B_row_offsets.begin() + 1,
-                      B_row_offsets.end(),
-                      B_row_offsets.begin(),
-                      B_row_lengths.begin(),
-                      thrust::minus<IndexType>());
-
-    // for each element A(i,j) compute the number of nonzero elements in B(j,:)
     cusp::detail::temporary_array<IndexType,DerivedPolicy> segment_lengths(exec, A.num_entries);
-    thrust::gather(exec,
-                   A.column_indices.begin(),
-                   A.column_indices.end(),
-                   B_row_lengths.begin(),
-                   segment_lengths.begin());
-
-    // output pointer
     cusp::detail::temporary_array<IndexType,DerivedPolicy> output_ptr(exec, A.num_entries + 1);
-    thrust::exclusive_scan(exec,
-                           segment_lengths.begin(),
-                           segment_lengths.end(),
-                           output_ptr.begin(),
-                           IndexType(0));
 
-    output_ptr[A.num_entries] = output_ptr[A.num_entries - 1] + segment_lengths[A.num_entries - 1]; // XXX is this necessary?
+    size_t coo_num_nonzeros = coo_spmm_segments(exec, A, B, B_row_offsets, segment_lengths, output_ptr);
 
-    size_t coo_num_nonzeros = output_ptr[A.num_entries];
-
-    size_t workspace_capacity = thrust::min<size_t>(coo_num_nonzeros, 16 << 20);
-
-    {
-        size_t free = std::numeric_limits<unsigned int>::max();
-
-        // divide free bytes by the size of each workspace unit
-        size_t max_workspace_capacity = free / (4 * sizeof(IndexType) + sizeof(ValueType));
-
-        // use at most one third of the remaining capacity
-        workspace_capacity = thrust::min<size_t>(max_workspace_capacity / 3, workspace_capacity);
-    }
+    size_t workspace_capacity =
+        spgemm_workspace_capacity<IndexType,ValueType>(coo_num_nonzeros, std::numeric_limits<unsigned int>::max());
 
     // workspace arrays
     cusp::detail::temporary_array<IndexType, DerivedPolicy> A_gather_locations(exec);
@@ -284,23 +326,19 @@ void multiply(thrust::execution_policy<DerivedPolicy>& exec,
             // find largest end_row such that the capacity of [begin_row, end_row) fits in the workspace_capacity
             size_t end_row = thrust::upper_bound(exec,
                                                  cumulative_row_workspace.begin() + begin_row, cumulative_row_workspace.end(),
-                                                 IndexType(total_work + workspace_capacity)) - cumulative_row_workspace.begin();
+                                                 IndexType(thrust::min<size_t>(total_work + workspace_capacity, coo_num_nonzeros))) - cumulative_row_workspace.begin();
+
+            // the products of a single row exceed the workspace
+            if (end_row == begin_row)
+                throw cusp::runtime_exception("SpGEMM workspace is too small for a single row of the product");
 
             size_t begin_segment = A_row_offsets[begin_row];
             size_t end_segment   = A_row_offsets[end_row];
 
-            // TODO throw exception signaling that there is insufficient memory (not necessarily bad_alloc)
-            //if (begin_row == end_row)
-            //    // workspace wasn't large enough, throw cusp::memory_allocation_failure?
-
             size_t workspace_size = output_ptr[end_segment] - output_ptr[begin_segment];
 
             total_work += workspace_size;
 
-            // TODO remove these when an exception is in place
-            assert(end_row > begin_row);
-            assert(workspace_size <= workspace_capacity);
-
             coo_spmm_helper(exec,
                             workspace_size,
                             begin_row, end_row,
@@ -336,7 +374,7 @@ void multiply(thrust::execution_policy<DerivedPolicy>& exec,
             C_num_entries += iter->num_entries;
 
         // resize output
-        C.resize(A.num_rows, B.num_cols, C_num_entries);
+        C.resize(A.num_rows, B.num_cols, C_num_entries, cusp::no_init);
 
         // copy slices into output
         size_t base = 0;
@@ -404,6 +442,194 @@ void multiply(thrust::execution_policy<DerivedPolicy>& exec,
     cusp::convert(exec, C_, C);
 }
 
+
+template <typename BinaryFunction>
+struct spgemm_combine_functor
+{
+    BinaryFunction combine;
+
+    spgemm_combine_functor(BinaryFunction combine)
+        : combine(combine) {}
+
+    template <typename Tuple>
+    __host__ __device__
+    typename BinaryFunction::result_type
+    operator()(const Tuple& t) const
+    {
+        return combine(thrust::get<0>(t), thrust::get<1>(t));
+    }
+};
+
+template <typename DerivedPolicy,
+          typename MatrixType1,
+          typename MatrixType2,
+          typename MatrixType3,
+          typename PlanType>
+void spgemm_symbolic(thrust::execution_policy<DerivedPolicy>& exec,
+                     const MatrixType1& A,
+                     const MatrixType2& B,
+                     MatrixType3& C,
+                     PlanType& plan,
+                     cusp::sparse_format,
+                     cusp::sparse_format,
+                     cusp::sparse_format)
+{
+    typedef typename MatrixType3::index_type   IndexType;
+    typedef typename MatrixType3::value_type   ValueType;
+    typedef typename MatrixType3::memory_space MemorySpace;
+
+    typedef typename MatrixType1::const_coo_view_type CooMatrix1;
+    typedef typename MatrixType2::const_coo_view_type CooMatrix2;
+
+    CooMatrix1 A_(A);
+    CooMatrix2 B_(B);
+
+    plan.A_num_entries = A.num_entries;
+    plan.B_num_entries = B.num_entries;
+
+    // check whether matrices are empty
+    if (A.num_entries == 0 || B.num_entries == 0)
+    {
+        plan.A_gather_locations.resize(0);
+        plan.B_gather_locations.resize(0);
+        plan.output_keys.resize(0);
+        plan.C_num_entries = 0;
+
+        C.resize(A.num_rows, B.num_cols, 0);
+        return;
+    }
+
+    cusp::detail::temporary_array<IndexType,DerivedPolicy> B_row_offsets(exec, B.num_rows + 1);
+    cusp::detail::temporary_array<IndexType,DerivedPolicy> segment_lengths(exec, A.num_entries);
+    cusp::detail::temporary_array<IndexType,DerivedPolicy> output_ptr(exec, A.num_entries + 1);
+
+    size_t coo_num_nonzeros = coo_spmm_segments(exec, A_, B_, B_row_offsets, segment_lengths, output_ptr);
+
+    if (coo_num_nonzeros == 0)
+    {
+        plan.A_gather_locations.resize(0);
+        plan.B_gather_locations.resize(0);
+        plan.output_keys.resize(0);
+        plan.C_num_entries = 0;
+
+        C.resize(A.num_rows, B.num_cols, 0);
+        return;
+    }
+
+    // expand all products A(i,j) * B(j,k) at once
+    cusp::detail::temporary_array<IndexType,DerivedPolicy> A_gather_locations(exec, coo_num_nonzeros);
+    cusp::detail::temporary_array<IndexType,DerivedPolicy> B_gather_locations(exec, coo_num_nonzeros);
+
+    coo_spmm_expand(exec,
+                    0, A.num_entries,
+                    A_, B_row_offsets,
+                    segment_lengths, output_ptr,
+                    A_gather_locations, B_gather_locations);
+
+    cusp::detail::temporary_array<IndexType,DerivedPolicy> I(exec, coo_num_nonzeros);
+    cusp::detail::temporary_array<IndexType,DerivedPolicy> J(exec, coo_num_nonzeros);
+    cusp::detail::temporary_array<IndexType,DerivedPolicy> permutation(exec, coo_num_nonzeros);
+
+    thrust::gather(exec,
+                   A_gather_locations.begin(), A_gather_locations.end(),
+                   A_.row_indices.begin(),
+                   I.begin());
+    thrust::gather(exec,
+                   B_gather_locations.begin(), B_gather_locations.end(),
+                   B_.column_indices.begin(),
+                   J.begin());
+    thrust::sequence(exec, permutation.begin(), permutation.end());
+
+    // sort the products by (I,J) once and record the resulting order
+    cusp::sort_by_row_and_column(exec, I, J, permutation);
+
+    plan.A_gather_locations.resize(coo_num_nonzeros);
+    plan.B_gather_locations.resize(coo_num_nonzeros);
+    plan.output_keys.resize(coo_num_nonzeros);
+
+    thrust::gather(exec,
+                   permutation.begin(), permutation.end(),
+                   A_gather_locations.begin(),
+                   plan.A_gather_locations.begin());
+    thrust::gather(exec,
+                   permutation.begin(), permutation.end(),
+                   B_gather_locations.begin(),
+                   plan.B_gather_locations.begin());
+
+    // label each product with the index of its entry in C
+    plan.output_keys[0] = 0;
+    thrust::transform(exec,
+                      thrust::make_zip_iterator(thrust::make_tuple(I.begin(), J.begin())) + 1,
+                      thrust::make_zip_iterator(thrust::make_tuple(I.end(),   J.end())),
+                      thrust::make_zip_iterator(thrust::make_tuple(I.begin(), J.begin())),
+                      plan.output_keys.begin() + 1,
+                      thrust::not_equal_to< thrust::tuple<IndexType,IndexType> >());
+    thrust::inclusive_scan(exec, plan.output_keys.begin(), plan.output_keys.end(), plan.output_keys.begin());
+
+    size_t NNZ = plan.output_keys[coo_num_nonzeros - 1] + 1;
+
+    plan.C_num_entries = NNZ;
+
+    // extract the pattern of C with explicit zero values
+    cusp::coo_matrix<IndexType,ValueType,MemorySpace> C_(A.num_rows, B.num_cols, NNZ);
+
+    thrust::unique_copy(exec,
+                        thrust::make_zip_iterator(thrust::make_tuple(I.begin(), J.begin())),
+                        thrust::make_zip_iterator(thrust::make_tuple(I.end(),   J.end())),
+                        thrust::make_zip_iterator(thrust::make_tuple(C_.row_indices.begin(), C_.column_indices.begin())));
+    thrust::fill(exec, C_.values.begin(), C_.values.end(), ValueType(0));
+
+    cusp::convert(exec, C_, C);
+}
+
+template <typename DerivedPolicy,
+          typename MatrixType1,
+          typename MatrixType2,
+          typename MatrixType3,
+          typename PlanType,
+          typename BinaryFunction1,
+          typename BinaryFunction2>
+void spgemm_numeric(thrust::execution_policy<DerivedPolicy>& exec,
+                    const MatrixType1& A,
+                    const MatrixType2& B,
+                    MatrixType3& C,
+                    const PlanType& plan,
+                    BinaryFunction1 combine,
+                    BinaryFunction2 reduce,
+                    cusp::sparse_format,
+                    cusp::sparse_format,
+                    cusp::sparse_format)
+{
+    typedef typename MatrixType1::const_coo_view_type CooMatrix1;
+    typedef typename MatrixType2::const_coo_view_type CooMatrix2;
+
+    if (A.num_entries != plan.A_num_entries ||
+        B.num_entries != plan.B_num_entries ||
+        C.num_entries != plan.C_num_entries)
+        throw cusp::invalid_input_exception("matrix sizes do not match the spgemm plan");
+
+    if (plan.output_keys.size() == 0)
+        return;
+
+    CooMatrix1 A_(A);
+    CooMatrix2 B_(B);
+
+    // combine the products in the order recorded by the plan and sum those
+    // contributing to the same entry of C, no sorting is required
+    thrust::reduce_by_key
+    (exec,
+     plan.output_keys.begin(), plan.output_keys.end(),
+     thrust::make_transform_iterator(
+       thrust::make_zip_iterator(thrust::make_tuple(
+         thrust::make_permutation_iterator(A_.values.begin(), plan.A_gather_locations.begin()),
+         thrust::make_permutation_iterator(B_.values.begin(), plan.B_gather_locations.begin()))),
+       spgemm_combine_functor<BinaryFunction1>(combine)),
+     thrust::make_discard_iterator(),
+     C.values.begin(),
+     thrust::equal_to<typename PlanType::index_type>(),
+     reduce);
+}
+
 } // end namespace generic
 } // end namespace detail
 } // end namespace system
@@ -0,0 +1,78 @@
+/*
+ *  Copyright 2008-2014 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#pragma once
+
+#include <cusp/detail/config.h>
+
+#include <thrust/extrema.h>
+
+#include <cstddef>
+
+namespace cusp
+{
+namespace system
+{
+namespace detail
+{
+namespace generic
+{
+
+// workspace limit in bytes set by cusp::set_spgemm_workspace_limit,
+// zero selects the capacity from the available memory
+inline size_t& spgemm_workspace_limit_state(void)
+{
+    static size_t limit = 0;
+    return limit;
+}
+
+// number of intermediate products of the expand, sort and compress method
+// processed at once, each product occupies the gather locations and the
+// (I,J,V) tuple as well as the scratch space of sorting the tuples
+template <typename IndexType, typename ValueType>
+size_t spgemm_workspace_capacity(const size_t num_products, const size_t free_bytes)
+{
+    const size_t limit = spgemm_workspace_limit_state();
+
+    if (limit > 0)
+        return thrust::min<size_t>(num_products, limit / (6 * sizeof(IndexType) + 2 * sizeof(ValueType)));
+
+    size_t workspace_capacity = thrust::min<size_t>(num_products, 16 << 20);
+
+    // divide free bytes by the size of each workspace unit
+    size_t max_workspace_capacity = free_bytes / (4 * sizeof(IndexType) + sizeof(ValueType));
+
+    // use at most one third of the remaining capacity
+    return thrust::min<size_t>(max_workspace_capacity / 3, workspace_capacity);
+}
+
+// number of (key,value) slots of the hash tables allocated at once
+template <typename IndexType, typename ValueType>
+size_t spgemm_table_capacity(const size_t free_bytes)
+{
+    const size_t limit = spgemm_workspace_limit_state();
+
+    if (limit > 0)
+        return limit / (sizeof(IndexType) + sizeof(ValueType));
+
+    // use at most one third of the remaining memory
+    return free_bytes / (3 * (sizeof(IndexType) + sizeof(ValueType)));
+}
+
+} // end namespace generic
+} // end namespace detail
+} // end namespace system
+} // end namespace cusp
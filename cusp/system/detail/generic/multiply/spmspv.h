@@ -0,0 +1,549 @@
+/*
+ *  Copyright 2008-2014 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#pragma once
+
+#include <cusp/detail/config.h>
+#include <cusp/detail/format.h>
+#include <cusp/detail/temporary_array.h>
+#include <cusp/detail/type_traits.h>
+
+#include <cusp/convert.h>
+#include <cusp/csr_matrix.h>
+#include <cusp/exception.h>
+#include <cusp/sparse_vector.h>
+
+#include <thrust/fill.h>
+#include <thrust/for_each.h>
+#include <thrust/functional.h>
+#include <thrust/reduce.h>
+#include <thrust/scan.h>
+#include <thrust/sort.h>
+#include <thrust/transform.h>
+
+#include <thrust/iterator/counting_iterator.h>
+
+namespace cusp
+{
+namespace system
+{
+namespace detail
+{
+namespace generic
+{
+namespace spmspv
+{
+
+// number of products contributed by the k-th entry of x
+template <typename IndexType>
+struct row_length
+{
+    const IndexType * row_offsets;
+    const IndexType * x_indices;
+
+    row_length(const IndexType * row_offsets, const IndexType * x_indices)
+        : row_offsets(row_offsets), x_indices(x_indices) {}
+
+    __host__ __device__
+    IndexType operator()(const IndexType k) const
+    {
+        const IndexType i = x_indices[k];
+        return row_offsets[i + 1] - row_offsets[i];
+    }
+};
+
+// writes the products of row x_indices[k] of A with x_values[k] to the
+// slots starting at offsets[k]
+template <typename IndexType, typename ValueIterator, typename ValueType1, typename ValueType2, typename BinaryFunction>
+struct expand_rows
+{
+    const IndexType * row_offsets;
+    const IndexType * column_indices;
+    ValueIterator values;
+    const IndexType * x_indices;
+    const ValueType1 * x_values;
+    const IndexType * offsets;
+    IndexType * keys;
+    ValueType2 * products;
+    BinaryFunction combine;
+
+    expand_rows(const IndexType * row_offsets, const IndexType * column_indices, ValueIterator values,
+                const IndexType * x_indices, const ValueType1 * x_values, const IndexType * offsets,
+                IndexType * keys, ValueType2 * products, BinaryFunction combine)
+        : row_offsets(row_offsets), column_indices(column_indices), values(values),
+          x_indices(x_indices), x_values(x_values), offsets(offsets),
+          keys(keys), products(products), combine(combine) {}
+
+    __host__ __device__
+    void operator()(const IndexType k) const
+    {
+        const IndexType i = x_indices[k];
+        IndexType slot = offsets[k];
+
+        for(IndexType jj = row_offsets[i]; jj < row_offsets[i + 1]; jj++, slot++)
+        {
+            keys[slot]     = column_indices[jj];
+            products[slot] = combine(values[jj], x_values[k]);
+        }
+    }
+};
+
+// counts the products of chunk c falling into every bucket, the counts are
+// stored bucket-major so that their scan orders the chunks within a bucket
+template <typename IndexType>
+struct count_buckets
+{
+    const IndexType * keys;
+    IndexType * counts;
+    IndexType num_products;
+    IndexType num_chunks;
+    IndexType chunk_size;
+    IndexType bucket_width;
+
+    count_buckets(const IndexType * keys, IndexType * counts, IndexType num_products,
+                  IndexType num_chunks, IndexType chunk_size, IndexType bucket_width)
+        : keys(keys), counts(counts), num_products(num_products),
+          num_chunks(num_chunks), chunk_size(chunk_size), bucket_width(bucket_width) {}
+
+    __host__ __device__
+    void operator()(const IndexType c) const
+    {
+        const IndexType end = thrust::min(num_products, (c + 1) * chunk_size);
+
+        for(IndexType n = c * chunk_size; n < end; n++)
+            counts[(keys[n] / bucket_width) * num_chunks + c]++;
+    }
+};
+
+// moves the products of chunk c to their buckets, preserving their order
+template <typename IndexType, typename ValueType>
+struct fill_buckets
+{
+    const IndexType * keys;
+    const ValueType * products;
+    IndexType * cursors;
+    IndexType * bucket_keys;
+    ValueType * bucket_products;
+    IndexType num_products;
+    IndexType num_chunks;
+    IndexType chunk_size;
+    IndexType bucket_width;
+
+    fill_buckets(const IndexType * keys, const ValueType * products, IndexType * cursors,
+                 IndexType * bucket_keys, ValueType * bucket_products, IndexType num_products,
+                 IndexType num_chunks, IndexType chunk_size, IndexType bucket_width)
+        : keys(keys), products(products), cursors(cursors), bucket_keys(bucket_keys),
+          bucket_products(bucket_products), num_products(num_products),
+          num_chunks(num_chunks), chunk_size(chunk_size), bucket_width(bucket_width) {}
+
+    __host__ __device__
+    void operator()(const IndexType c) const
+    {
+        const IndexType end = thrust::min(num_products, (c + 1) * chunk_size);
+
+        for(IndexType n = c * chunk_size; n < end; n++)
+        {
+            const IndexType slot = cursors[(keys[n] / bucket_width) * num_chunks + c]++;
+
+            bucket_keys[slot]     = keys[n];
+            bucket_products[slot] = products[n];
+        }
+    }
+};
+
+// first slot of every bucket, bucket_offsets[num_buckets] is the number of
+// products
+template <typename IndexType>
+struct bucket_begin
+{
+    const IndexType * starts;
+    IndexType * bucket_offsets;
+    IndexType num_buckets;
+    IndexType num_chunks;
+    IndexType num_products;
+
+    bucket_begin(const IndexType * starts, IndexType * bucket_offsets, IndexType num_buckets,
+                 IndexType num_chunks, IndexType num_products)
+        : starts(starts), bucket_offsets(bucket_offsets), num_buckets(num_buckets),
+          num_chunks(num_chunks), num_products(num_products) {}
+
+    __host__ __device__
+    void operator()(const IndexType b) const
+    {
+        bucket_offsets[b] = b < num_buckets ? starts[b * num_chunks] : num_products;
+    }
+};
+
+// reduces the products of bucket b into the slots of its first occurrence
+// of every index, position maps an index of y to its slot
+template <typename IndexType, typename ValueType, typename BinaryFunction>
+struct accumulate_bucket
+{
+    const IndexType * bucket_offsets;
+    const IndexType * bucket_keys;
+    const ValueType * bucket_products;
+    IndexType * position;
+    IndexType * unique_keys;
+    ValueType * unique_values;
+    IndexType * unique_counts;
+    BinaryFunction reduce;
+
+    accumulate_bucket(const IndexType * bucket_offsets, const IndexType * bucket_keys,
+                      const ValueType * bucket_products, IndexType * position,
+                      IndexType * unique_keys, ValueType * unique_values,
+                      IndexType * unique_counts, BinaryFunction reduce)
+        : bucket_offsets(bucket_offsets), bucket_keys(bucket_keys), bucket_products(bucket_products),
+          position(position), unique_keys(unique_keys), unique_values(unique_values),
+          unique_counts(unique_counts), reduce(reduce) {}
+
+    __host__ __device__
+    void operator()(const IndexType b) const
+    {
+        const IndexType begin = bucket_offsets[b];
+        IndexType n = begin;
+
+        for(IndexType slot = begin; slot < bucket_offsets[b + 1]; slot++)
+        {
+            const IndexType j = bucket_keys[slot];
+            const IndexType p = position[j];
+
+            if(p < 0)
+            {
+                position[j]      = n;
+                unique_keys[n]   = j;
+                unique_values[n] = bucket_products[slot];
+                n++;
+            }
+            else
+            {
+                unique_values[p] = reduce(unique_values[p], bucket_products[slot]);
+            }
+        }
+
+        unique_counts[b] = n - begin;
+    }
+};
+
+// copies the reduced entries of bucket b to y
+template <typename IndexType, typename ValueType>
+struct compact_bucket
+{
+    const IndexType * bucket_offsets;
+    const IndexType * output_offsets;
+    const IndexType * unique_keys;
+    const ValueType * unique_values;
+    IndexType * y_indices;
+    ValueType * y_values;
+
+    compact_bucket(const IndexType * bucket_offsets, const IndexType * output_offsets,
+                   const IndexType * unique_keys, const ValueType * unique_values,
+                   IndexType * y_indices, ValueType * y_values)
+        : bucket_offsets(bucket_offsets), output_offsets(output_offsets), unique_keys(unique_keys),
+          unique_values(unique_values), y_indices(y_indices), y_values(y_values) {}
+
+    __host__ __device__
+    void operator()(const IndexType b) const
+    {
+        const IndexType begin = bucket_offsets[b];
+        const IndexType count = output_offsets[b + 1] - output_offsets[b];
+
+        for(IndexType n = 0; n < count; n++)
+        {
+            y_indices[output_offsets[b] + n] = unique_keys[begin + n];
+            y_values[output_offsets[b] + n]  = unique_values[begin + n];
+        }
+    }
+};
+
+// materializes every product A(i,j) * x(i), returns their number
+template <typename DerivedPolicy,
+          typename MatrixType,
+          typename SparseVector,
+          typename IndexArray,
+          typename ValueArray,
+          typename BinaryFunction>
+size_t expand(thrust::execution_policy<DerivedPolicy>& exec,
+              const MatrixType& A,
+              const SparseVector& x,
+                    IndexArray& keys,
+                    ValueArray& products,
+              BinaryFunction combine)
+{
+    typedef typename MatrixType::index_type                             IndexType;
+    typedef typename MatrixType::values_array_type::const_iterator      ValueIterator;
+    typedef typename SparseVector::value_type                           ValueType1;
+    typedef typename ValueArray::value_type                             ValueType2;
+
+    const IndexType * row_offsets = thrust::raw_pointer_cast(&A.row_offsets[0]);
+    const IndexType * x_indices   = thrust::raw_pointer_cast(&x.indices[0]);
+
+    cusp::detail::temporary_array<IndexType, DerivedPolicy> offsets(exec, x.num_entries + 1);
+
+    thrust::transform(exec,
+                      thrust::counting_iterator<IndexType>(0),
+                      thrust::counting_iterator<IndexType>(x.num_entries),
+                      offsets.begin(),
+                      row_length<IndexType>(row_offsets, x_indices));
+    offsets[x.num_entries] = 0;
+    thrust::exclusive_scan(exec, offsets.begin(), offsets.end(), offsets.begin());
+
+    const size_t num_products = offsets[x.num_entries];
+
+    keys.resize(num_products);
+    products.resize(num_products);
+
+    if(num_products == 0)
+        return 0;
+
+    thrust::for_each(exec,
+                     thrust::counting_iterator<IndexType>(0),
+                     thrust::counting_iterator<IndexType>(x.num_entries),
+                     expand_rows<IndexType, ValueIterator, ValueType1, ValueType2, BinaryFunction>(
+                         row_offsets,
+                         thrust::raw_pointer_cast(&A.column_indices[0]),
+                         A.values.begin(),
+                         x_indices,
+                         thrust::raw_pointer_cast(&x.values[0]),
+                         thrust::raw_pointer_cast(&offsets[0]),
+                         thrust::raw_pointer_cast(&keys[0]),
+                         thrust::raw_pointer_cast(&products[0]),
+                         combine));
+
+    return num_products;
+}
+
+// sorts the products by their index and reduces the runs of equal indices
+template <typename DerivedPolicy,
+          typename MatrixType,
+          typename SparseVector1,
+          typename SparseVector2,
+          typename BinaryFunction1,
+          typename BinaryFunction2>
+void sort_merge(thrust::execution_policy<DerivedPolicy>& exec,
+                const MatrixType& A,
+                const SparseVector1& x,
+                      SparseVector2& y,
+                BinaryFunction1 combine,
+                BinaryFunction2 reduce)
+{
+    typedef typename MatrixType::index_type   IndexType;
+    typedef typename SparseVector2::value_type ValueType;
+
+    cusp::detail::temporary_array<IndexType, DerivedPolicy> keys(exec, 0);
+    cusp::detail::temporary_array<ValueType, DerivedPolicy> products(exec, 0);
+
+    const size_t num_products = expand(exec, A, x, keys, products, combine);
+
+    y.resize(A.num_cols, num_products);
+
+    if(num_products == 0)
+        return;
+
+    thrust::stable_sort_by_key(exec, keys.begin(), keys.end(), products.begin());
+
+    const size_t num_entries =
+        thrust::reduce_by_key(exec,
+                              keys.begin(), keys.end(),
+                              products.begin(),
+                              y.indices.begin(),
+                              y.values.begin(),
+                              thrust::equal_to<IndexType>(),
+                              reduce).first - y.indices.begin();
+
+    y.resize(A.num_cols, num_entries);
+}
+
+// distributes the products to buckets of consecutive indices of y, counting
+// sort by chunks of products, and reduces every bucket with a dense map from
+// the indices of y to the slots of their partial results
+template <typename DerivedPolicy,
+          typename MatrixType,
+          typename SparseVector1,
+          typename SparseVector2,
+          typename BinaryFunction1,
+          typename BinaryFunction2>
+void bucket_merge(thrust::execution_policy<DerivedPolicy>& exec,
+                  const MatrixType& A,
+                  const SparseVector1& x,
+                        SparseVector2& y,
+                  BinaryFunction1 combine,
+                  BinaryFunction2 reduce)
+{
+    typedef typename MatrixType::index_type   IndexType;
+    typedef typename SparseVector2::value_type ValueType;
+
+    typedef cusp::detail::temporary_array<IndexType, DerivedPolicy> IndexArray;
+    typedef cusp::detail::temporary_array<ValueType, DerivedPolicy> ValueArray;
+
+    const IndexType CHUNK_SIZE          = 1024;
+    const IndexType PRODUCTS_PER_BUCKET = 64;
+    const IndexType MAX_BUCKETS         = 1024;
+
+    IndexArray keys(exec, 0);
+    ValueArray products(exec, 0);
+
+    const IndexType num_products = expand(exec, A, x, keys, products, combine);
+
+    if(num_products == 0)
+    {
+        y.resize(A.num_cols, 0);
+        return;
+    }
+
+    // the number of chunk and bucket pairs stays below the number of products
+    const IndexType num_cols     = A.num_cols;
+    const IndexType num_chunks   = (num_products + CHUNK_SIZE - 1) / CHUNK_SIZE;
+    const IndexType max_buckets  = thrust::max(IndexType(1), thrust::min(MAX_BUCKETS, num_products / PRODUCTS_PER_BUCKET));
+    const IndexType bucket_width = (num_cols + thrust::min(num_cols, max_buckets) - 1) / thrust::min(num_cols, max_buckets);
+    const IndexType num_buckets  = (num_cols + bucket_width - 1) / bucket_width;
+
+    IndexArray cursors(exec, num_buckets * num_chunks, IndexType(0));
+
+    thrust::for_each(exec,
+                     thrust::counting_iterator<IndexType>(0),
+                     thrust::counting_iterator<IndexType>(num_chunks),
+                     count_buckets<IndexType>(thrust::raw_pointer_cast(&keys[0]),
+                                              thrust::raw_pointer_cast(&cursors[0]),
+                                              num_products, num_chunks, CHUNK_SIZE, bucket_width));
+
+    thrust::exclusive_scan(exec, cursors.begin(), cursors.end(), cursors.begin());
+
+    IndexArray bucket_offsets(exec, num_buckets + 1);
+
+    thrust::for_each(exec,
+                     thrust::counting_iterator<IndexType>(0),
+                     thrust::counting_iterator<IndexType>(num_buckets + 1),
+                     bucket_begin<IndexType>(thrust::raw_pointer_cast(&cursors[0]),
+                                             thrust::raw_pointer_cast(&bucket_offsets[0]),
+                                             num_buckets, num_chunks, num_products));
+
+    IndexArray bucket_keys(exec, num_products);
+    ValueArray bucket_products(exec, num_products);
+
+    thrust::for_each(exec,
+                     thrust::counting_iterator<IndexType>(0),
+                     thrust::counting_iterator<IndexType>(num_chunks),
+                     fill_buckets<IndexType, ValueType>(thrust::raw_pointer_cast(&keys[0]),
+                                                        thrust::raw_pointer_cast(&products[0]),
+                                                        thrust::raw_pointer_cast(&cursors[0]),
+                                                        thrust::raw_pointer_cast(&bucket_keys[0]),
+                                                        thrust::raw_pointer_cast(&bucket_products[0]),
+                                                        num_products, num_chunks, CHUNK_SIZE, bucket_width));
+
+    // the products in their original order are no longer needed, their
+    // storage receives the reduced entries of every bucket
+    IndexArray position(exec, num_cols, IndexType(-1));
+    IndexArray output_offsets(exec, num_buckets + 1);
+
+    thrust::for_each(exec,
+                     thrust::counting_iterator<IndexType>(0),
+                     thrust::counting_iterator<IndexType>(num_buckets),
+                     accumulate_bucket<IndexType, ValueType, BinaryFunction2>(
+                         thrust::raw_pointer_cast(&bucket_offsets[0]),
+                         thrust::raw_pointer_cast(&bucket_keys[0]),
+                         thrust::raw_pointer_cast(&bucket_products[0]),
+                         thrust::raw_pointer_cast(&position[0]),
+                         thrust::raw_pointer_cast(&keys[0]),
+                         thrust::raw_pointer_cast(&products[0]),
+                         thrust::raw_pointer_cast(&output_offsets[0]),
+                         reduce));
+
+    output_offsets[num_buckets] = 0;
+    thrust::exclusive_scan(exec, output_offsets.begin(), output_offsets.end(), output_offsets.begin());
+
+    y.resize(A.num_cols, output_offsets[num_buckets]);
+
+    thrust::for_each(exec,
+                     thrust::counting_iterator<IndexType>(0),
+                     thrust::counting_iterator<IndexType>(num_buckets),
+                     compact_bucket<IndexType, ValueType>(
+                         thrust::raw_pointer_cast(&bucket_offsets[0]),
+                         thrust::raw_pointer_cast(&output_offsets[0]),
+                         thrust::raw_pointer_cast(&keys[0]),
+                         thrust::raw_pointer_cast(&products[0]),
+                         thrust::raw_pointer_cast(&y.indices[0]),
+                         thrust::raw_pointer_cast(&y.values[0])));
+
+    // the buckets are ordered, so sorting y only orders the indices within
+    // every bucket
+    thrust::sort_by_key(exec, y.indices.begin(), y.indices.end(), y.values.begin());
+}
+
+} // end namespace spmspv
+
+template <typename DerivedPolicy,
+          typename MatrixType,
+          typename SparseVector1,
+          typename SparseVector2,
+          typename BinaryFunction1,
+          typename BinaryFunction2>
+void generalized_spmspv(thrust::execution_policy<DerivedPolicy>& exec,
+                        const MatrixType& A,
+                        const SparseVector1& x,
+                              SparseVector2& y,
+                        BinaryFunction1 combine,
+                        BinaryFunction2 reduce,
+                        const cusp::spmspv_method method,
+                        cusp::csr_format)
+{
+    if(x.length != A.num_rows)
+        throw cusp::invalid_input_exception("sparse vector length does not match the number of matrix rows");
+
+    if(x.num_entries == 0 || A.num_entries == 0)
+    {
+        y.resize(A.num_cols, 0);
+        return;
+    }
+
+    switch(method)
+    {
+        case cusp::SPMSPV_SORT:
+            spmspv::sort_merge(exec, A, x, y, combine, reduce);
+            break;
+        case cusp::SPMSPV_BUCKET:
+            spmspv::bucket_merge(exec, A, x, y, combine, reduce);
+            break;
+        default:
+            throw cusp::invalid_input_exception("unrecognized spmspv method");
+    }
+}
+
+// other formats are converted to CSR
+template <typename DerivedPolicy,
+          typename MatrixType,
+          typename SparseVector1,
+          typename SparseVector2,
+          typename BinaryFunction1,
+          typename BinaryFunction2>
+void generalized_spmspv(thrust::execution_policy<DerivedPolicy>& exec,
+                        const MatrixType& A,
+                        const SparseVector1& x,
+                              SparseVector2& y,
+                        BinaryFunction1 combine,
+                        BinaryFunction2 reduce,
+                        const cusp::spmspv_method method,
+                        cusp::known_format)
+{
+    typedef typename MatrixType::container ContainerType;
+    typename cusp::detail::as_csr_type<ContainerType>::type A_csr(A);
+
+    generalized_spmspv(exec, A_csr, x, y, combine, reduce, method, cusp::csr_format());
+}
+
+} // end namespace generic
+} // end namespace detail
+} // end namespace system
+} // end namespace cusp
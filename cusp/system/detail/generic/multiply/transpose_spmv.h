@@ -0,0 +1,80 @@
+/*
+ *  Copyright 2008-2013 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#pragma once
+
+#include <cusp/detail/config.h>
+#include <cusp/detail/format.h>
+#include <cusp/detail/type_traits.h>
+
+#include <cusp/multiply.h>
+#include <cusp/transpose.h>
+
+namespace cusp
+{
+
+template <typename IndexType, typename ValueType, class MemorySpace>
+class cached_matrix;
+
+namespace system
+{
+namespace detail
+{
+namespace generic
+{
+
+// formats without a dedicated transposed kernel form A^T explicitly
+template <typename DerivedPolicy,
+          typename MatrixType,
+          typename VectorType1,
+          typename VectorType2,
+          typename Format>
+void multiply_transpose(thrust::execution_policy<DerivedPolicy> &exec,
+                        const MatrixType&  A,
+                        const VectorType1& x,
+                              VectorType2& y,
+                        Format,
+                        cusp::array1d_format,
+                        cusp::array1d_format)
+{
+    typename cusp::detail::as_coo_type<MatrixType>::type At;
+
+    cusp::transpose(exec, A, At);
+    cusp::multiply(exec, At, x, y);
+}
+
+// a cached_matrix applies its transpose through a cached copy of A^T
+template <typename DerivedPolicy,
+          typename IndexType,
+          typename ValueType,
+          typename MemorySpace,
+          typename VectorType1,
+          typename VectorType2>
+void multiply_transpose(thrust::execution_policy<DerivedPolicy> &exec,
+                        const cusp::cached_matrix<IndexType,ValueType,MemorySpace>& A,
+                        const VectorType1& x,
+                              VectorType2& y,
+                        cusp::unknown_format,
+                        cusp::array1d_format,
+                        cusp::array1d_format)
+{
+    A.apply_transpose(exec, x, y);
+}
+
+} // end namespace generic
+} // end namespace detail
+} // end namespace system
+} // end namespace cusp
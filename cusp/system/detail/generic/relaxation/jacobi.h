@@ -0,0 +1,441 @@
+/*
+ *  Copyright 2008-2014 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#pragma once
+
+#include <cusp/detail/config.h>
+#include <cusp/detail/execution_policy.h>
+#include <cusp/detail/format.h>
+
+#include <cusp/multiply.h>
+
+#include <thrust/copy.h>
+#include <thrust/for_each.h>
+#include <thrust/transform.h>
+#include <thrust/iterator/counting_iterator.h>
+#include <thrust/iterator/zip_iterator.h>
+
+namespace cusp
+{
+namespace system
+{
+namespace detail
+{
+namespace generic
+{
+
+template <typename ValueType>
+struct jacobi_relax_functor
+{
+    ValueType omega;
+
+    jacobi_relax_functor(ValueType omega) : omega(omega) {}
+
+    template <typename Tuple>
+    __host__ __device__
+    ValueType operator()(const Tuple& t)
+    {
+        const ValueType x = thrust::get<0>(t);
+        const ValueType d = thrust::get<1>(t);
+        const ValueType b = thrust::get<2>(t);
+        const ValueType y = thrust::get<3>(t);
+
+        return x + omega * (b - y) / d;
+    }
+};
+
+// The functors below perform one sweep x_out <- x_in + omega * D^-1 * (b - A*x_in)
+// with one thread per row, so the row sum of A*x_in never leaves a register
+// and x_in, b and the diagonal are read once.  ELL and DIA store their
+// entries column-major, which keeps the accesses of adjacent rows coalesced.
+
+template <typename IndexType, typename MatrixValueType, typename ValueType>
+struct jacobi_sweep_base
+{
+    const ValueType * diagonal;
+    const ValueType * b;
+    const ValueType * x_in;
+    ValueType * x_out;
+    ValueType omega;
+
+    jacobi_sweep_base(const ValueType * diagonal, const ValueType * b,
+                      const ValueType * x_in, ValueType * x_out, ValueType omega)
+        : diagonal(diagonal), b(b), x_in(x_in), x_out(x_out), omega(omega) {}
+
+    __host__ __device__
+    void relax(const IndexType i, const ValueType sum) const
+    {
+        x_out[i] = x_in[i] + omega * (b[i] - sum) / diagonal[i];
+    }
+};
+
+template <typename IndexType, typename MatrixValueType, typename ValueType>
+struct jacobi_csr_sweep_functor : public jacobi_sweep_base<IndexType,MatrixValueType,ValueType>
+{
+    typedef jacobi_sweep_base<IndexType,MatrixValueType,ValueType> Parent;
+
+    const IndexType * Ap;
+    const IndexType * Aj;
+    const MatrixValueType * Ax;
+
+    jacobi_csr_sweep_functor(const IndexType * Ap, const IndexType * Aj, const MatrixValueType * Ax, const Parent& parent)
+        : Parent(parent), Ap(Ap), Aj(Aj), Ax(Ax) {}
+
+    __host__ __device__
+    void operator()(const IndexType i) const
+    {
+        ValueType sum = ValueType(0);
+
+        for(IndexType jj = Ap[i]; jj < Ap[i + 1]; jj++)
+            sum += ValueType(Ax[jj]) * Parent::x_in[Aj[jj]];
+
+        Parent::relax(i, sum);
+    }
+};
+
+template <typename IndexType, typename MatrixValueType, typename ValueType>
+struct jacobi_ell_sweep_functor : public jacobi_sweep_base<IndexType,MatrixValueType,ValueType>
+{
+    typedef jacobi_sweep_base<IndexType,MatrixValueType,ValueType> Parent;
+
+    IndexType num_entries_per_row;
+    IndexType pitch;
+    const IndexType * Aj;
+    const MatrixValueType * Ax;
+    IndexType invalid_index;
+
+    jacobi_ell_sweep_functor(IndexType num_entries_per_row, IndexType pitch,
+                             const IndexType * Aj, const MatrixValueType * Ax,
+                             IndexType invalid_index, const Parent& parent)
+        : Parent(parent), num_entries_per_row(num_entries_per_row), pitch(pitch),
+          Aj(Aj), Ax(Ax), invalid_index(invalid_index) {}
+
+    __host__ __device__
+    ValueType row_sum(const IndexType i) const
+    {
+        ValueType sum = ValueType(0);
+
+        for(IndexType n = 0, offset = i; n < num_entries_per_row; n++, offset += pitch)
+        {
+            const IndexType j = Aj[offset];
+
+            if(j != invalid_index)
+                sum += ValueType(Ax[offset]) * Parent::x_in[j];
+        }
+
+        return sum;
+    }
+
+    __host__ __device__
+    void operator()(const IndexType i) const
+    {
+        Parent::relax(i, row_sum(i));
+    }
+};
+
+template <typename IndexType, typename MatrixValueType, typename ValueType>
+struct jacobi_dia_sweep_functor : public jacobi_sweep_base<IndexType,MatrixValueType,ValueType>
+{
+    typedef jacobi_sweep_base<IndexType,MatrixValueType,ValueType> Parent;
+
+    IndexType num_cols;
+    IndexType num_diagonals;
+    IndexType pitch;
+    const IndexType * offsets;
+    const MatrixValueType * values;
+
+    jacobi_dia_sweep_functor(IndexType num_cols, IndexType num_diagonals, IndexType pitch,
+                             const IndexType * offsets, const MatrixValueType * values,
+                             const Parent& parent)
+        : Parent(parent), num_cols(num_cols), num_diagonals(num_diagonals), pitch(pitch),
+          offsets(offsets), values(values) {}
+
+    __host__ __device__
+    void operator()(const IndexType i) const
+    {
+        ValueType sum = ValueType(0);
+
+        for(IndexType n = 0; n < num_diagonals; n++)
+        {
+            const IndexType j = i + offsets[n];
+
+            if(j >= 0 && j < num_cols)
+                sum += ValueType(values[n * pitch + i]) * Parent::x_in[j];
+        }
+
+        Parent::relax(i, sum);
+    }
+};
+
+// the COO tail is sorted by row, the entries of row i are found by a binary search
+template <typename IndexType, typename MatrixValueType, typename ValueType>
+struct jacobi_hyb_sweep_functor : public jacobi_ell_sweep_functor<IndexType,MatrixValueType,ValueType>
+{
+    typedef jacobi_ell_sweep_functor<IndexType,MatrixValueType,ValueType> ELL;
+    typedef jacobi_sweep_base<IndexType,MatrixValueType,ValueType>       Parent;
+
+    IndexType num_coo_entries;
+    const IndexType * Ci;
+    const IndexType * Cj;
+    const MatrixValueType * Cx;
+
+    jacobi_hyb_sweep_functor(const ELL& ell, IndexType num_coo_entries,
+                             const IndexType * Ci, const IndexType * Cj, const MatrixValueType * Cx)
+        : ELL(ell), num_coo_entries(num_coo_entries), Ci(Ci), Cj(Cj), Cx(Cx) {}
+
+    __host__ __device__
+    void operator()(const IndexType i) const
+    {
+        ValueType sum = ELL::row_sum(i);
+
+        IndexType first = 0;
+        IndexType last  = num_coo_entries;
+
+        while(first < last)
+        {
+            const IndexType middle = (first + last) / 2;
+
+            if(Ci[middle] < i)
+                first = middle + 1;
+            else
+                last = middle;
+        }
+
+        for(IndexType jj = first; jj < num_coo_entries && Ci[jj] == i; jj++)
+            sum += ValueType(Cx[jj]) * Parent::x_in[Cj[jj]];
+
+        Parent::relax(i, sum);
+    }
+};
+
+template <typename ArrayType>
+typename ArrayType::value_type * jacobi_raw_pointer(ArrayType& array)
+{
+    return array.size() == 0 ? 0 : thrust::raw_pointer_cast(&array[0]);
+}
+
+template <typename ArrayType>
+const typename ArrayType::value_type * jacobi_raw_pointer(const ArrayType& array)
+{
+    return array.size() == 0 ? 0 : thrust::raw_pointer_cast(&array[0]);
+}
+
+// formats without a fused sweep
+template<typename DerivedPolicy, typename MatrixType, typename ValueType, typename Format>
+bool jacobi_sweep(thrust::execution_policy<DerivedPolicy>& exec,
+                  const MatrixType& A,
+                  const jacobi_sweep_base<typename MatrixType::index_type, typename MatrixType::value_type, ValueType>& parent,
+                  Format)
+{
+    return false;
+}
+
+template<typename DerivedPolicy, typename MatrixType, typename ValueType>
+bool jacobi_sweep(thrust::execution_policy<DerivedPolicy>& exec,
+                  const MatrixType& A,
+                  const jacobi_sweep_base<typename MatrixType::index_type, typename MatrixType::value_type, ValueType>& parent,
+                  cusp::csr_format)
+{
+    typedef typename MatrixType::index_type IndexType;
+    typedef typename MatrixType::value_type MatrixValueType;
+
+    thrust::for_each(exec,
+                     thrust::counting_iterator<IndexType>(0),
+                     thrust::counting_iterator<IndexType>(A.num_rows),
+                     jacobi_csr_sweep_functor<IndexType,MatrixValueType,ValueType>(
+                         jacobi_raw_pointer(A.row_offsets), jacobi_raw_pointer(A.column_indices),
+                         jacobi_raw_pointer(A.values), parent));
+
+    return true;
+}
+
+template<typename DerivedPolicy, typename MatrixType, typename ValueType>
+bool jacobi_sweep(thrust::execution_policy<DerivedPolicy>& exec,
+                  const MatrixType& A,
+                  const jacobi_sweep_base<typename MatrixType::index_type, typename MatrixType::value_type, ValueType>& parent,
+                  cusp::ell_format)
+{
+    typedef typename MatrixType::index_type IndexType;
+    typedef typename MatrixType::value_type MatrixValueType;
+
+    thrust::for_each(exec,
+                     thrust::counting_iterator<IndexType>(0),
+                     thrust::counting_iterator<IndexType>(A.num_rows),
+                     jacobi_ell_sweep_functor<IndexType,MatrixValueType,ValueType>(
+                         A.column_indices.num_cols, A.column_indices.pitch,
+                         jacobi_raw_pointer(A.column_indices.values), jacobi_raw_pointer(A.values.values),
+                         MatrixType::invalid_index, parent));
+
+    return true;
+}
+
+template<typename DerivedPolicy, typename MatrixType, typename ValueType>
+bool jacobi_sweep(thrust::execution_policy<DerivedPolicy>& exec,
+                  const MatrixType& A,
+                  const jacobi_sweep_base<typename MatrixType::index_type, typename MatrixType::value_type, ValueType>& parent,
+                  cusp::dia_format)
+{
+    typedef typename MatrixType::index_type IndexType;
+    typedef typename MatrixType::value_type MatrixValueType;
+
+    thrust::for_each(exec,
+                     thrust::counting_iterator<IndexType>(0),
+                     thrust::counting_iterator<IndexType>(A.num_rows),
+                     jacobi_dia_sweep_functor<IndexType,MatrixValueType,ValueType>(
+                         A.num_cols, A.values.num_cols, A.values.pitch,
+                         jacobi_raw_pointer(A.diagonal_offsets), jacobi_raw_pointer(A.values.values),
+                         parent));
+
+    return true;
+}
+
+template<typename DerivedPolicy, typename MatrixType, typename ValueType>
+bool jacobi_sweep(thrust::execution_policy<DerivedPolicy>& exec,
+                  const MatrixType& A,
+                  const jacobi_sweep_base<typename MatrixType::index_type, typename MatrixType::value_type, ValueType>& parent,
+                  cusp::hyb_format)
+{
+    typedef typename MatrixType::index_type IndexType;
+    typedef typename MatrixType::value_type MatrixValueType;
+    typedef typename MatrixType::ell_matrix_type ELLMatrixType;
+
+    jacobi_ell_sweep_functor<IndexType,MatrixValueType,ValueType> ell(
+        A.ell.column_indices.num_cols, A.ell.column_indices.pitch,
+        jacobi_raw_pointer(A.ell.column_indices.values), jacobi_raw_pointer(A.ell.values.values),
+        ELLMatrixType::invalid_index, parent);
+
+    thrust::for_each(exec,
+                     thrust::counting_iterator<IndexType>(0),
+                     thrust::counting_iterator<IndexType>(A.num_rows),
+                     jacobi_hyb_sweep_functor<IndexType,MatrixValueType,ValueType>(
+                         ell, A.coo.num_entries,
+                         jacobi_raw_pointer(A.coo.row_indices), jacobi_raw_pointer(A.coo.column_indices),
+                         jacobi_raw_pointer(A.coo.values)));
+
+    return true;
+}
+
+// Runs num_sweeps sweeps of sweep(x_in, x_out), alternating between x and
+// temp as the source of each sweep instead of copying the result back after
+// every sweep.  Returns false, before touching x, when the first sweep has
+// no fused implementation.
+template<typename DerivedPolicy,
+         typename SweepFunction,
+         typename ArrayType1,
+         typename ArrayType2>
+bool jacobi_ping_pong(thrust::execution_policy<DerivedPolicy>& exec,
+                      SweepFunction sweep,
+                      ArrayType1& x,
+                      ArrayType2& temp,
+                      const size_t num_sweeps)
+{
+    typedef typename ArrayType1::value_type ValueType;
+
+    temp.resize(x.size());
+
+    ValueType * src = jacobi_raw_pointer(x);
+    ValueType * dst = jacobi_raw_pointer(temp);
+
+    for(size_t i = 0; i < num_sweeps; i++)
+    {
+        if(!sweep(src, dst))
+            return false;
+
+        ValueType * swap = src;
+        src = dst;
+        dst = swap;
+    }
+
+    // an odd number of sweeps leaves the solution in temp
+    if(num_sweeps % 2 == 1)
+        thrust::copy(exec, temp.begin(), temp.begin() + x.size(), x.begin());
+
+    return true;
+}
+
+template<typename DerivedPolicy, typename MatrixType, typename ValueType>
+struct jacobi_fused_sweep
+{
+    thrust::execution_policy<DerivedPolicy>& exec;
+    const MatrixType& A;
+    const ValueType * diagonal;
+    const ValueType * b;
+    ValueType omega;
+
+    jacobi_fused_sweep(thrust::execution_policy<DerivedPolicy>& exec, const MatrixType& A,
+                       const ValueType * diagonal, const ValueType * b, ValueType omega)
+        : exec(exec), A(A), diagonal(diagonal), b(b), omega(omega) {}
+
+    bool operator()(const ValueType * x_in, ValueType * x_out)
+    {
+        typedef typename MatrixType::index_type IndexType;
+        typedef typename MatrixType::value_type MatrixValueType;
+        typedef typename MatrixType::format     Format;
+
+        jacobi_sweep_base<IndexType,MatrixValueType,ValueType> parent(diagonal, b, x_in, x_out, omega);
+
+        return jacobi_sweep(exec, A, parent, Format());
+    }
+};
+
+template<typename DerivedPolicy,
+         typename MatrixType,
+         typename ArrayType1,
+         typename ArrayType2,
+         typename ArrayType3,
+         typename ArrayType4,
+         typename ArrayType5,
+         typename ValueType>
+void jacobi_sweeps(thrust::execution_policy<DerivedPolicy>& exec,
+                   const MatrixType& A,
+                   const ArrayType1& diagonal,
+                   const ArrayType2& b,
+                         ArrayType3& x,
+                         ArrayType4& temp,
+                         ArrayType5& barrier,
+                   const ValueType omega,
+                   const size_t num_sweeps)
+{
+    typedef typename ArrayType3::value_type ArrayValueType;
+
+    if(num_sweeps == 0 || A.num_rows == 0)
+        return;
+
+    // CSR, ELL, DIA and HYB compute each sweep in a single pass
+    jacobi_fused_sweep<DerivedPolicy,MatrixType,ArrayValueType>
+        sweep(exec, A, jacobi_raw_pointer(diagonal), jacobi_raw_pointer(b), ArrayValueType(omega));
+
+    if(jacobi_ping_pong(exec, sweep, x, temp, num_sweeps))
+        return;
+
+    for(size_t i = 0; i < num_sweeps; i++)
+    {
+        // y <- A*x
+        cusp::multiply(exec, A, x, temp);
+
+        // x <- x + omega * D^-1 * (b - y)
+        thrust::transform(exec,
+                          thrust::make_zip_iterator(thrust::make_tuple(x.begin(), diagonal.begin(), b.begin(), temp.begin())),
+                          thrust::make_zip_iterator(thrust::make_tuple(x.end(),   diagonal.end(),   b.end(),   temp.end())),
+                          x.begin(),
+                          jacobi_relax_functor<ValueType>(omega));
+    }
+}
+
+} // end namespace generic
+} // end namespace detail
+} // end namespace system
+} // end namespace cusp
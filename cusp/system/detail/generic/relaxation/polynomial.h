@@ -0,0 +1,110 @@
+/*
+ *  Copyright 2008-2014 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#pragma once
+
+#include <cusp/detail/config.h>
+#include <cusp/detail/execution_policy.h>
+
+#include <cusp/blas/blas.h>
+#include <cusp/multiply.h>
+
+namespace cusp
+{
+namespace system
+{
+namespace detail
+{
+namespace generic
+{
+
+// x <- x + p(A) r, or x <- p(A) r if x is ignored, evaluated with Horner's rule
+template<typename DerivedPolicy,
+         typename MatrixType,
+         typename ArrayType1,
+         typename ArrayType2,
+         typename ArrayType3,
+         typename ArrayType4>
+void polynomial_apply(thrust::execution_policy<DerivedPolicy>& exec,
+                      const MatrixType& A,
+                      const ArrayType1& r,
+                            ArrayType2& x,
+                            ArrayType3& h,
+                            ArrayType3& y,
+                      const ArrayType4& coefficients,
+                      const bool ignore_x)
+{
+    typedef typename ArrayType3::value_type ValueType;
+
+    ValueType scale_factor = coefficients[0];
+    cusp::blas::axpby(exec, r, h, h, scale_factor, ValueType(0));
+
+    for( size_t i = 1; i < coefficients.size(); i++ )
+    {
+        scale_factor = coefficients[i];
+
+        cusp::multiply(exec, A, h, y);
+        cusp::blas::axpby(exec, y, r, h, ValueType(1), scale_factor);
+    }
+
+    if(ignore_x)
+        cusp::blas::copy(exec, h, x);
+    else
+        cusp::blas::axpy(exec, h, x, ValueType(1));
+}
+
+template<typename DerivedPolicy,
+         typename MatrixType,
+         typename ArrayType1,
+         typename ArrayType2,
+         typename ArrayType3,
+         typename ArrayType4,
+         typename ArrayType5>
+void polynomial_relax(thrust::execution_policy<DerivedPolicy>& exec,
+                      const MatrixType& A,
+                      const ArrayType1& b,
+                            ArrayType2& x,
+                            ArrayType3& residual,
+                            ArrayType3& h,
+                            ArrayType3& y,
+                            ArrayType4& barrier,
+                      const ArrayType5& coefficients,
+                      const bool zero_initial_guess)
+{
+    typedef typename ArrayType3::value_type ValueType;
+
+    if(coefficients.size() == 0)
+        return;
+
+    if(zero_initial_guess)
+    {
+        // the residual of the zero guess is b itself
+        polynomial_apply(exec, A, b, x, h, y, coefficients, true);
+    }
+    else
+    {
+        // compute residual <- b - A*x
+        cusp::multiply(exec, A, x, residual);
+        cusp::blas::axpby(exec, b, residual, residual, ValueType(1), ValueType(-1));
+
+        polynomial_apply(exec, A, residual, x, h, y, coefficients, false);
+    }
+}
+
+} // end namespace generic
+} // end namespace detail
+} // end namespace system
+} // end namespace cusp
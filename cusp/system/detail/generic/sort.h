@@ -44,12 +44,36 @@ void counting_sort_by_key(thrust::execution_policy<DerivedPolicy>& exec,
                           ArrayType1& keys, ArrayType2& vals,
                           typename ArrayType1::value_type min, typename ArrayType1::value_type max);
 
+template <typename DerivedPolicy, typename ArrayType>
+bool is_sorted_by_row(thrust::execution_policy<DerivedPolicy> &exec,
+                      const ArrayType& row_indices);
+
+template <typename DerivedPolicy, typename ArrayType1, typename ArrayType2>
+bool is_sorted_by_row_and_column(thrust::execution_policy<DerivedPolicy> &exec,
+                                 const ArrayType1& row_indices, const ArrayType2& column_indices);
+
 template <typename DerivedPolicy, typename ArrayType1, typename ArrayType2, typename ArrayType3>
 void sort_by_row(thrust::execution_policy<DerivedPolicy> &exec,
                  ArrayType1& row_indices, ArrayType2& column_indices, ArrayType3& values,
                  typename ArrayType1::value_type min_row,
                  typename ArrayType1::value_type max_row);
 
+template <typename DerivedPolicy, typename ArrayType1, typename ArrayType2, typename ArrayType3>
+void stable_sort_by_row_and_column(thrust::execution_policy<DerivedPolicy> &exec,
+                                   ArrayType1& row_indices, ArrayType2& column_indices, ArrayType3& values,
+                                   typename ArrayType1::value_type min_row,
+                                   typename ArrayType1::value_type max_row,
+                                   typename ArrayType2::value_type min_col,
+                                   typename ArrayType2::value_type max_col);
+
+template <typename DerivedPolicy, typename ArrayType1, typename ArrayType2, typename ArrayType3>
+bool packed_sort_by_row_and_column(thrust::execution_policy<DerivedPolicy> &exec,
+                                   ArrayType1& row_indices, ArrayType2& column_indices, ArrayType3& values,
+                                   typename ArrayType1::value_type min_row,
+                                   typename ArrayType1::value_type max_row,
+                                   typename ArrayType2::value_type min_col,
+                                   typename ArrayType2::value_type max_col);
+
 template <typename DerivedPolicy, typename ArrayType1, typename ArrayType2, typename ArrayType3>
 void sort_by_row_and_column(thrust::execution_policy<DerivedPolicy> &exec,
                             ArrayType1& row_indices, ArrayType2& column_indices, ArrayType3& values,
@@ -23,7 +23,9 @@
 
 #include <thrust/binary_search.h>
 #include <thrust/copy.h>
+#include <thrust/count.h>
 #include <thrust/extrema.h>
+#include <thrust/functional.h>
 #include <thrust/gather.h>
 #include <thrust/fill.h>
 #include <thrust/scan.h>
@@ -31,6 +33,11 @@
 #include <thrust/sequence.h>
 #include <thrust/sort.h>
 #include <thrust/transform.h>
+#include <thrust/tuple.h>
+
+#include <thrust/iterator/counting_iterator.h>
+#include <thrust/iterator/reverse_iterator.h>
+#include <thrust/iterator/zip_iterator.h>
 
 namespace cusp
 {
@@ -41,6 +48,97 @@ namespace detail
 namespace generic
 {
 
+// functors
+// flags entry i when it is out of column order with respect to entry i - 1 of the same row
+template <typename IndexType>
+struct column_descent_functor : public thrust::unary_function<IndexType,IndexType>
+{
+    template <typename Tuple>
+    __host__ __device__
+    IndexType operator()(const Tuple& t) const
+    {
+        return (thrust::get<0>(t) == thrust::get<1>(t)) && (thrust::get<3>(t) < thrust::get<2>(t)) ? 1 : 0;
+    }
+};
+
+// packs a (row,column) pair into a single key with the column in the low bits
+template <typename KeyType>
+struct pack_row_column_functor : public thrust::unary_function<KeyType,KeyType>
+{
+    unsigned int column_bits;
+
+    pack_row_column_functor(unsigned int column_bits)
+        : column_bits(column_bits) {}
+
+    template <typename Tuple>
+    __host__ __device__
+    KeyType operator()(const Tuple& t) const
+    {
+        return (KeyType(thrust::get<0>(t)) << column_bits) | KeyType(thrust::get<1>(t));
+    }
+};
+
+template <typename KeyType, typename IndexType>
+struct unpack_row_functor : public thrust::unary_function<KeyType,IndexType>
+{
+    unsigned int column_bits;
+
+    unpack_row_functor(unsigned int column_bits)
+        : column_bits(column_bits) {}
+
+    __host__ __device__
+    IndexType operator()(const KeyType key) const
+    {
+        return IndexType(key >> column_bits);
+    }
+};
+
+template <typename KeyType, typename IndexType>
+struct unpack_column_functor : public thrust::unary_function<KeyType,IndexType>
+{
+    KeyType column_mask;
+
+    unpack_column_functor(unsigned int column_bits)
+        : column_mask((KeyType(1) << column_bits) - 1) {}
+
+    __host__ __device__
+    IndexType operator()(const KeyType key) const
+    {
+        return IndexType(key & column_mask);
+    }
+};
+
+// number of bits needed to represent the nonnegative integer n
+template <typename IndexType>
+unsigned int index_bits(IndexType n)
+{
+    unsigned int bits = 0;
+
+    while(n > IndexType(0))
+    {
+        n >>= 1;
+        bits++;
+    }
+
+    return bits;
+}
+
+template <typename DerivedPolicy, typename ArrayType>
+bool is_sorted_by_row(thrust::execution_policy<DerivedPolicy> &exec,
+                      const ArrayType& row_indices)
+{
+    return thrust::is_sorted(exec, row_indices.begin(), row_indices.end());
+}
+
+template <typename DerivedPolicy, typename ArrayType1, typename ArrayType2>
+bool is_sorted_by_row_and_column(thrust::execution_policy<DerivedPolicy> &exec,
+                                 const ArrayType1& row_indices, const ArrayType2& column_indices)
+{
+    return thrust::is_sorted(exec,
+                             thrust::make_zip_iterator(thrust::make_tuple(row_indices.begin(), column_indices.begin())),
+                             thrust::make_zip_iterator(thrust::make_tuple(row_indices.end(),   column_indices.end())));
+}
+
 template <typename DerivedPolicy, typename ArrayType1, typename ArrayType2, typename ArrayType3>
 void sort_by_row(thrust::execution_policy<DerivedPolicy> &exec,
                  ArrayType1& row_indices, ArrayType2& column_indices, ArrayType3& values,
@@ -52,6 +150,10 @@ void sort_by_row(thrust::execution_policy<DerivedPolicy> &exec,
 
     size_t N = row_indices.size();
 
+    // nothing to do if the entries are already grouped by row
+    if(cusp::is_sorted_by_row(exec, row_indices))
+        return;
+
     IndexType minr = min_row;
     IndexType maxr = max_row;
 
@@ -75,13 +177,16 @@ void sort_by_row(thrust::execution_policy<DerivedPolicy> &exec,
                    thrust::make_zip_iterator(thrust::make_tuple(column_indices.begin(), values.begin())));
 }
 
+// sorts by (row,column) with two stable counting sorts, first by column and
+// then by row. systems with a fast sort over integer keys override this with
+// packed_sort_by_row_and_column
 template <typename DerivedPolicy, typename ArrayType1, typename ArrayType2, typename ArrayType3>
-void sort_by_row_and_column(thrust::execution_policy<DerivedPolicy> &exec,
-                            ArrayType1& row_indices, ArrayType2& column_indices, ArrayType3& values,
-                            typename ArrayType1::value_type min_row,
-                            typename ArrayType1::value_type max_row,
-                            typename ArrayType2::value_type min_col,
-                            typename ArrayType2::value_type max_col)
+void stable_sort_by_row_and_column(thrust::execution_policy<DerivedPolicy> &exec,
+                                   ArrayType1& row_indices, ArrayType2& column_indices, ArrayType3& values,
+                                   typename ArrayType1::value_type min_row,
+                                   typename ArrayType1::value_type max_row,
+                                   typename ArrayType2::value_type min_col,
+                                   typename ArrayType2::value_type max_col)
 {
     typedef typename ArrayType1::value_type IndexType1;
     typedef typename ArrayType2::value_type IndexType2;
@@ -122,6 +227,181 @@ void sort_by_row_and_column(thrust::execution_policy<DerivedPolicy> &exec,
     }
 }
 
+template <typename KeyType, typename DerivedPolicy, typename ArrayType1, typename ArrayType2, typename ArrayType3>
+void packed_key_sort_by_row_and_column(thrust::execution_policy<DerivedPolicy> &exec,
+                                       ArrayType1& row_indices, ArrayType2& column_indices, ArrayType3& values,
+                                       unsigned int column_bits)
+{
+    typedef typename ArrayType1::value_type IndexType1;
+    typedef typename ArrayType2::value_type IndexType2;
+    typedef typename ArrayType3::value_type ValueType;
+
+    size_t N = row_indices.size();
+
+    cusp::detail::temporary_array<KeyType, DerivedPolicy> keys(exec, N);
+    thrust::transform(exec,
+                      thrust::make_zip_iterator(thrust::make_tuple(row_indices.begin(), column_indices.begin())),
+                      thrust::make_zip_iterator(thrust::make_tuple(row_indices.end(),   column_indices.end())),
+                      keys.begin(),
+                      pack_row_column_functor<KeyType>(column_bits));
+
+    cusp::detail::temporary_array<IndexType1, DerivedPolicy> permutation(exec, N);
+    thrust::sequence(exec, permutation.begin(), permutation.end());
+
+    // a single sort over unsigned integer keys, ties are identical (row,column) pairs
+    thrust::stable_sort_by_key(exec, keys.begin(), keys.end(), permutation.begin());
+
+    // the sorted indices are recovered from the keys instead of being gathered
+    thrust::transform(exec, keys.begin(), keys.end(), row_indices.begin(),
+                      unpack_row_functor<KeyType,IndexType1>(column_bits));
+    thrust::transform(exec, keys.begin(), keys.end(), column_indices.begin(),
+                      unpack_column_functor<KeyType,IndexType2>(column_bits));
+
+    // use permutation to reorder the values
+    cusp::detail::temporary_array<ValueType, DerivedPolicy> temp(exec, values);
+    thrust::gather(exec, permutation.begin(), permutation.end(), temp.begin(), values.begin());
+}
+
+// sorts by (row,column) with one radix-friendly sort over keys that pack the
+// row above the column, using 32-bit keys whenever the index ranges allow.
+// returns false, without modifying the matrix, when the indices need more
+// than 64 bits.
+template <typename DerivedPolicy, typename ArrayType1, typename ArrayType2, typename ArrayType3>
+bool packed_sort_by_row_and_column(thrust::execution_policy<DerivedPolicy> &exec,
+                                   ArrayType1& row_indices, ArrayType2& column_indices, ArrayType3& values,
+                                   typename ArrayType1::value_type min_row,
+                                   typename ArrayType1::value_type max_row,
+                                   typename ArrayType2::value_type min_col,
+                                   typename ArrayType2::value_type max_col)
+{
+    typedef typename ArrayType1::value_type IndexType1;
+    typedef typename ArrayType2::value_type IndexType2;
+
+    // negative indices do not pack
+    if(min_row < IndexType1(0) || min_col < IndexType2(0))
+        return false;
+
+    if(row_indices.size() == 0)
+        return true;
+
+    IndexType1 maxr = max_row;
+    IndexType2 maxc = max_col;
+
+    if(maxr == 0)
+        maxr = *thrust::max_element(exec, row_indices.begin(), row_indices.end());
+    if(maxc == 0)
+        maxc = *thrust::max_element(exec, column_indices.begin(), column_indices.end());
+
+    const unsigned int row_bits    = index_bits(maxr);
+    const unsigned int column_bits = index_bits(maxc);
+
+    // the column field must be narrower than the key so the shifts stay defined
+    if(row_bits + column_bits <= 32 && column_bits < 32)
+        packed_key_sort_by_row_and_column<unsigned int>(exec, row_indices, column_indices, values, column_bits);
+    else if(row_bits + column_bits <= 64 && column_bits < 64)
+        packed_key_sort_by_row_and_column<unsigned long long>(exec, row_indices, column_indices, values, column_bits);
+    else
+        return false;
+
+    return true;
+}
+
+// sorts the columns of each row of a matrix whose entries are already grouped by row.
+// only the entries of rows that are out of column order are gathered and sorted, the
+// remaining entries stay in place. returns false, without modifying the matrix, when
+// too many rows are unsorted for the gather and scatter to pay off.
+template <typename DerivedPolicy, typename ArrayType1, typename ArrayType2, typename ArrayType3>
+bool sort_columns_within_rows(thrust::execution_policy<DerivedPolicy> &exec,
+                              ArrayType1& row_indices, ArrayType2& column_indices, ArrayType3& values,
+                              typename ArrayType1::value_type min_row,
+                              typename ArrayType1::value_type max_row,
+                              typename ArrayType2::value_type min_col,
+                              typename ArrayType2::value_type max_col)
+{
+    typedef typename ArrayType1::value_type IndexType1;
+    typedef typename ArrayType2::value_type IndexType2;
+    typedef typename ArrayType3::value_type ValueType;
+
+    size_t N = row_indices.size();
+
+    // mark every entry that breaks the column order of its row
+    cusp::detail::temporary_array<IndexType1, DerivedPolicy> flags(exec, N);
+    thrust::fill_n(exec, flags.begin(), 1, IndexType1(0));
+    thrust::transform(exec,
+                      thrust::make_zip_iterator(thrust::make_tuple(row_indices.begin(), row_indices.begin() + 1,
+                                                                   column_indices.begin(), column_indices.begin() + 1)),
+                      thrust::make_zip_iterator(thrust::make_tuple(row_indices.end() - 1, row_indices.end(),
+                                                                   column_indices.end() - 1, column_indices.end())),
+                      flags.begin() + 1,
+                      column_descent_functor<IndexType1>());
+
+    // spread the marks over every entry of the unsorted rows
+    thrust::inclusive_scan_by_key(exec,
+                                  row_indices.begin(), row_indices.end(),
+                                  flags.begin(), flags.begin(),
+                                  thrust::equal_to<IndexType1>(), thrust::maximum<IndexType1>());
+    thrust::inclusive_scan_by_key(exec,
+                                  thrust::make_reverse_iterator(row_indices.end()),
+                                  thrust::make_reverse_iterator(row_indices.begin()),
+                                  thrust::make_reverse_iterator(flags.end()),
+                                  thrust::make_reverse_iterator(flags.end()),
+                                  thrust::equal_to<IndexType1>(), thrust::maximum<IndexType1>());
+
+    size_t M = thrust::count(exec, flags.begin(), flags.end(), IndexType1(1));
+
+    if(2 * M > N)
+        return false;
+
+    // gather the entries of the unsorted rows
+    cusp::detail::temporary_array<IndexType1, DerivedPolicy> positions(exec, M);
+    thrust::copy_if(exec,
+                    thrust::counting_iterator<IndexType1>(0),
+                    thrust::counting_iterator<IndexType1>(N),
+                    flags.begin(),
+                    positions.begin(),
+                    thrust::identity<IndexType1>());
+
+    cusp::detail::temporary_array<IndexType1, DerivedPolicy> rows(exec, M);
+    cusp::detail::temporary_array<IndexType2, DerivedPolicy> cols(exec, M);
+    thrust::gather(exec, positions.begin(), positions.end(), row_indices.begin(), rows.begin());
+    thrust::gather(exec, positions.begin(), positions.end(), column_indices.begin(), cols.begin());
+
+    // sort the gathered entries, the rows keep their relative order so every
+    // sorted entry goes back to a position owned by its own row
+    cusp::detail::temporary_array<IndexType1, DerivedPolicy> permutation(exec, positions);
+    stable_sort_by_row_and_column(exec, rows, cols, permutation, min_row, max_row, min_col, max_col);
+
+    thrust::scatter(exec, cols.begin(), cols.end(), positions.begin(), column_indices.begin());
+
+    {
+        cusp::detail::temporary_array<ValueType, DerivedPolicy> temp(exec, M);
+        thrust::gather(exec, permutation.begin(), permutation.end(), values.begin(), temp.begin());
+        thrust::scatter(exec, temp.begin(), temp.end(), positions.begin(), values.begin());
+    }
+
+    return true;
+}
+
+template <typename DerivedPolicy, typename ArrayType1, typename ArrayType2, typename ArrayType3>
+void sort_by_row_and_column(thrust::execution_policy<DerivedPolicy> &exec,
+                            ArrayType1& row_indices, ArrayType2& column_indices, ArrayType3& values,
+                            typename ArrayType1::value_type min_row,
+                            typename ArrayType1::value_type max_row,
+                            typename ArrayType2::value_type min_col,
+                            typename ArrayType2::value_type max_col)
+{
+    // nothing to do if the entries are already in (row,column) order
+    if(cusp::is_sorted_by_row_and_column(exec, row_indices, column_indices))
+        return;
+
+    // entries grouped by row only need their columns sorted within each row
+    if(cusp::is_sorted_by_row(exec, row_indices) &&
+       sort_columns_within_rows(exec, row_indices, column_indices, values, min_row, max_row, min_col, max_col))
+        return;
+
+    stable_sort_by_row_and_column(exec, row_indices, column_indices, values, min_row, max_row, min_col, max_col);
+}
+
 template <typename DerivedPolicy, typename ArrayType>
 void counting_sort(thrust::execution_policy<DerivedPolicy>& exec,
                    ArrayType& keys, typename ArrayType::value_type min, typename ArrayType::value_type max)
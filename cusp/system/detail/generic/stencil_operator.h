@@ -0,0 +1,84 @@
+/*
+ *  Copyright 2008-2014 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+
+#pragma once
+
+#include <cusp/detail/config.h>
+
+#include <cusp/detail/execution_policy.h>
+
+#include <thrust/functional.h>
+#include <thrust/transform.h>
+
+#include <thrust/iterator/counting_iterator.h>
+
+namespace cusp
+{
+namespace system
+{
+namespace detail
+{
+namespace generic
+{
+
+template <typename Descriptor, typename IndexType, typename ValueType, typename XType>
+struct stencil_row_functor : public thrust::unary_function<IndexType,ValueType>
+{
+    Descriptor desc;
+    const XType * x;
+
+    stencil_row_functor(const Descriptor& desc, const XType * x)
+        : desc(desc), x(x) {}
+
+    __host__ __device__
+    ValueType operator()(const IndexType row) const
+    {
+        IndexType coords[Descriptor::dimensions];
+        desc.coordinates(row, coords);
+
+        return desc.apply(row, coords, x);
+    }
+};
+
+template <typename DerivedPolicy,
+          typename StencilOperator,
+          typename VectorType1,
+          typename VectorType2>
+void stencil_multiply(thrust::execution_policy<DerivedPolicy>& exec,
+                      const StencilOperator& A,
+                      const VectorType1& x,
+                            VectorType2& y)
+{
+    typedef typename StencilOperator::index_type      IndexType;
+    typedef typename StencilOperator::value_type      ValueType;
+    typedef typename StencilOperator::descriptor_type Descriptor;
+    typedef typename VectorType1::value_type          XType;
+
+    if(A.num_rows == 0)
+        return;
+
+    thrust::transform(exec,
+                      thrust::counting_iterator<IndexType>(0),
+                      thrust::counting_iterator<IndexType>(IndexType(A.num_rows)),
+                      y.begin(),
+                      stencil_row_functor<Descriptor,IndexType,ValueType,XType>(A.descriptor(), thrust::raw_pointer_cast(&x[0])));
+}
+
+} // end namespace generic
+} // end namespace detail
+} // end namespace system
+} // end namespace cusp
@@ -0,0 +1,236 @@
+/*
+ *  Copyright 2008-2014 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#pragma once
+
+#include <cusp/detail/config.h>
+#include <cusp/detail/execution_policy.h>
+
+#include <cusp/array1d.h>
+#include <cusp/exception.h>
+
+#include <thrust/count.h>
+#include <thrust/for_each.h>
+#include <thrust/transform.h>
+
+#include <thrust/iterator/counting_iterator.h>
+
+#include <algorithm>
+#include <vector>
+
+namespace cusp
+{
+namespace system
+{
+namespace detail
+{
+namespace generic
+{
+namespace triangular
+{
+
+// position of the diagonal entry of every row, -1 if it is missing
+template <typename IndexType>
+struct diagonal_index_functor
+{
+    const IndexType * row_offsets;
+    const IndexType * column_indices;
+
+    diagonal_index_functor(const IndexType * row_offsets, const IndexType * column_indices)
+        : row_offsets(row_offsets), column_indices(column_indices) {}
+
+    __host__ __device__
+    IndexType operator()(const IndexType i) const
+    {
+        for(IndexType jj = row_offsets[i]; jj < row_offsets[i + 1]; jj++)
+            if(column_indices[jj] == i)
+                return jj;
+
+        return -1;
+    }
+};
+
+// x(i) = (b(i) - sum_{j in T} T(i,j) x(j)) / T(i,i) for row i = rows[n],
+// where T holds the columns j < i (lower) or j > i (upper) and the
+// diagonal is one if diagonal_indices is NULL, b and x may alias
+template <typename IndexType, typename ValueType1, typename ValueType2, typename ValueType3>
+struct solve_row_functor
+{
+    const IndexType * rows;
+    const IndexType * row_offsets;
+    const IndexType * column_indices;
+    const ValueType1 * values;
+    const IndexType * diagonal_indices;
+    const ValueType2 * b;
+    ValueType3 * x;
+    const bool lower;
+
+    solve_row_functor(const IndexType * rows, const IndexType * row_offsets,
+                      const IndexType * column_indices, const ValueType1 * values,
+                      const IndexType * diagonal_indices,
+                      const ValueType2 * b, ValueType3 * x, const bool lower)
+        : rows(rows), row_offsets(row_offsets), column_indices(column_indices),
+          values(values), diagonal_indices(diagonal_indices), b(b), x(x), lower(lower) {}
+
+    __host__ __device__
+    void operator()(const IndexType n) const
+    {
+        const IndexType i = rows[n];
+
+        ValueType3 sum = b[i];
+
+        for(IndexType jj = row_offsets[i]; jj < row_offsets[i + 1]; jj++)
+        {
+            const IndexType j = column_indices[jj];
+
+            if(lower ? j < i : j > i)
+                sum -= values[jj] * x[j];
+        }
+
+        x[i] = diagonal_indices == NULL ? sum : ValueType3(sum / values[diagonal_indices[i]]);
+    }
+};
+
+} // end namespace triangular
+
+template <typename DerivedPolicy,
+          typename MatrixType,
+          typename PlanType>
+void triangular_solve_analysis(thrust::execution_policy<DerivedPolicy>& exec,
+                               const MatrixType& A,
+                                     PlanType& plan,
+                               const bool lower,
+                               const bool unit_diagonal)
+{
+    typedef typename PlanType::index_type IndexType;
+    typedef thrust::counting_iterator<IndexType> CountingIterator;
+
+    if(A.num_rows != A.num_cols)
+        throw cusp::invalid_input_exception("triangular matrix must be square");
+
+    const IndexType N = A.num_rows;
+
+    plan.lower         = lower;
+    plan.unit_diagonal = unit_diagonal;
+    plan.num_rows      = A.num_rows;
+    plan.num_entries   = A.num_entries;
+
+    // the level of row i is one more than the largest level of the rows
+    // j < i (lower) or j > i (upper) it references
+    cusp::array1d<IndexType,cusp::host_memory> row_offsets(A.row_offsets);
+    cusp::array1d<IndexType,cusp::host_memory> column_indices(A.column_indices);
+    std::vector<IndexType> levels(N, 0);
+
+    IndexType num_levels = N == 0 ? 0 : 1;
+
+    for(IndexType n = 0; n < N; n++)
+    {
+        const IndexType i = lower ? n : N - 1 - n;
+
+        IndexType level = 0;
+
+        for(IndexType jj = row_offsets[i]; jj < row_offsets[i + 1]; jj++)
+        {
+            const IndexType j = column_indices[jj];
+
+            if(lower ? j < i : j > i)
+                level = std::max(level, IndexType(levels[j] + 1));
+        }
+
+        levels[i]  = level;
+        num_levels = std::max(num_levels, IndexType(level + 1));
+    }
+
+    // counting sort of the rows by level
+    plan.level_offsets.assign(num_levels + 1, 0);
+
+    for(IndexType i = 0; i < N; i++)
+        plan.level_offsets[levels[i] + 1]++;
+
+    for(IndexType l = 0; l < num_levels; l++)
+        plan.level_offsets[l + 1] += plan.level_offsets[l];
+
+    std::vector<IndexType> next(plan.level_offsets.begin(), plan.level_offsets.end() - 1);
+    cusp::array1d<IndexType,cusp::host_memory> rows(N);
+
+    for(IndexType i = 0; i < N; i++)
+        rows[next[levels[i]]++] = i;
+
+    plan.rows = rows;
+
+    if(unit_diagonal || N == 0)
+    {
+        plan.diagonal_indices.resize(0);
+        return;
+    }
+
+    plan.diagonal_indices.resize(N);
+
+    thrust::transform(exec, CountingIterator(0), CountingIterator(N), plan.diagonal_indices.begin(),
+                      triangular::diagonal_index_functor<IndexType>(thrust::raw_pointer_cast(&A.row_offsets[0]),
+                                                                    A.num_entries == 0 ? NULL : thrust::raw_pointer_cast(&A.column_indices[0])));
+
+    if(thrust::count(exec, plan.diagonal_indices.begin(), plan.diagonal_indices.end(), IndexType(-1)) > 0)
+        throw cusp::invalid_input_exception("triangular matrix requires a diagonal entry in every row");
+}
+
+template <typename DerivedPolicy,
+          typename MatrixType,
+          typename ArrayType1,
+          typename ArrayType2,
+          typename PlanType>
+void triangular_solve(thrust::execution_policy<DerivedPolicy>& exec,
+                      const MatrixType& A,
+                      const ArrayType1& b,
+                            ArrayType2& x,
+                      const PlanType& plan)
+{
+    typedef typename PlanType::index_type   IndexType;
+    typedef typename MatrixType::value_type ValueType1;
+    typedef typename ArrayType1::value_type ValueType2;
+    typedef typename ArrayType2::value_type ValueType3;
+    typedef thrust::counting_iterator<IndexType> CountingIterator;
+
+    if(size_t(A.num_rows) != plan.num_rows || size_t(A.num_entries) != plan.num_entries)
+        throw cusp::invalid_input_exception("matrix does not match the triangular_solve_plan");
+
+    if(b.size() != plan.num_rows || x.size() != plan.num_rows)
+        throw cusp::invalid_input_exception("array dimensions do not match the triangular_solve_plan");
+
+    if(plan.num_rows == 0)
+        return;
+
+    triangular::solve_row_functor<IndexType,ValueType1,ValueType2,ValueType3>
+        f(thrust::raw_pointer_cast(&plan.rows[0]),
+          thrust::raw_pointer_cast(&A.row_offsets[0]),
+          plan.num_entries == 0 ? NULL : thrust::raw_pointer_cast(&A.column_indices[0]),
+          plan.num_entries == 0 ? NULL : thrust::raw_pointer_cast(&A.values[0]),
+          plan.unit_diagonal ? NULL : thrust::raw_pointer_cast(&plan.diagonal_indices[0]),
+          thrust::raw_pointer_cast(&b[0]),
+          thrust::raw_pointer_cast(&x[0]),
+          plan.lower);
+
+    for(size_t l = 0; l < plan.num_levels(); l++)
+        thrust::for_each(exec,
+                         CountingIterator(plan.level_offsets[l]),
+                         CountingIterator(plan.level_offsets[l + 1]),
+                         f);
+}
+
+} // end namespace generic
+} // end namespace detail
+} // end namespace system
+} // end namespace cusp
@@ -0,0 +1,248 @@
+/*
+ *  Copyright 2008-2014 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#pragma once
+
+#include <cusp/detail/config.h>
+
+#include <cusp/complex.h>
+
+#include <cusp/system/detail/generic/blas.h>
+#include <cusp/system/detail/profiling/execution_policy.h>
+#include <cusp/system/detail/profiling/profiled_call.h>
+
+namespace cusp
+{
+namespace system
+{
+namespace detail
+{
+namespace profiling
+{
+
+// Every routine records its call and forwards to the overloads of the
+// system policy, so specialized implementations of the system are still
+// selected. The traffic is counted as one read of every input entry and
+// one write of every output entry.
+
+template <template <typename> class ExecutionPolicy,
+          typename Array>
+int amax(execute_profiling<ExecutionPolicy>& exec,
+         const Array& x)
+{
+    using cusp::system::detail::generic::blas::amax;
+
+    profiled_call<ExecutionPolicy> call(exec, "cusp::blas::amax", array_bytes(x));
+
+    return amax(exec.base(), x);
+}
+
+template <template <typename> class ExecutionPolicy,
+          typename Array>
+typename cusp::norm_type<typename Array::value_type>::type
+asum(execute_profiling<ExecutionPolicy>& exec,
+     const Array& x)
+{
+    using cusp::system::detail::generic::blas::asum;
+
+    profiled_call<ExecutionPolicy> call(exec, "cusp::blas::asum", array_bytes(x));
+
+    return asum(exec.base(), x);
+}
+
+template <template <typename> class ExecutionPolicy,
+          typename Array1,
+          typename Array2,
+          typename ScalarType>
+void axpy(execute_profiling<ExecutionPolicy>& exec,
+          const Array1& x,
+                Array2& y,
+          const ScalarType alpha)
+{
+    using cusp::system::detail::generic::blas::axpy;
+
+    profiled_call<ExecutionPolicy> call(exec, "cusp::blas::axpy",
+                                        array_bytes(x) + array_bytes(y), array_bytes(y));
+
+    axpy(exec.base(), x, y, alpha);
+}
+
+template <template <typename> class ExecutionPolicy,
+          typename Array1,
+          typename Array2,
+          typename Array3,
+          typename ScalarType1,
+          typename ScalarType2>
+void axpby(execute_profiling<ExecutionPolicy>& exec,
+           const Array1& x,
+           const Array2& y,
+                 Array3& z,
+           const ScalarType1 alpha,
+           const ScalarType2 beta)
+{
+    using cusp::system::detail::generic::blas::axpby;
+
+    profiled_call<ExecutionPolicy> call(exec, "cusp::blas::axpby",
+                                        array_bytes(x) + array_bytes(y), array_bytes(z));
+
+    axpby(exec.base(), x, y, z, alpha, beta);
+}
+
+template <template <typename> class ExecutionPolicy,
+          typename Array1,
+          typename Array2,
+          typename Array3,
+          typename Array4,
+          typename ScalarType1,
+          typename ScalarType2,
+          typename ScalarType3>
+void axpbypcz(execute_profiling<ExecutionPolicy>& exec,
+              const Array1& x,
+              const Array2& y,
+              const Array3& z,
+                    Array4& output,
+              const ScalarType1 alpha,
+              const ScalarType2 beta,
+              const ScalarType3 gamma)
+{
+    using cusp::system::detail::generic::blas::axpbypcz;
+
+    profiled_call<ExecutionPolicy> call(exec, "cusp::blas::axpbypcz",
+                                        array_bytes(x) + array_bytes(y) + array_bytes(z),
+                                        array_bytes(output));
+
+    axpbypcz(exec.base(), x, y, z, output, alpha, beta, gamma);
+}
+
+template <template <typename> class ExecutionPolicy,
+          typename Array1,
+          typename Array2,
+          typename Array3>
+void xmy(execute_profiling<ExecutionPolicy>& exec,
+         const Array1& x,
+         const Array2& y,
+               Array3& z)
+{
+    using cusp::system::detail::generic::blas::xmy;
+
+    profiled_call<ExecutionPolicy> call(exec, "cusp::blas::xmy",
+                                        array_bytes(x) + array_bytes(y), array_bytes(z));
+
+    xmy(exec.base(), x, y, z);
+}
+
+template <template <typename> class ExecutionPolicy,
+          typename Array1,
+          typename Array2>
+void copy(execute_profiling<ExecutionPolicy>& exec,
+          const Array1& x,
+                Array2& y)
+{
+    using cusp::system::detail::generic::blas::copy;
+
+    profiled_call<ExecutionPolicy> call(exec, "cusp::blas::copy", array_bytes(x), array_bytes(y));
+
+    copy(exec.base(), x, y);
+}
+
+template <template <typename> class ExecutionPolicy,
+          typename Array1,
+          typename Array2>
+typename Array1::value_type
+dot(execute_profiling<ExecutionPolicy>& exec,
+    const Array1& x,
+    const Array2& y)
+{
+    using cusp::system::detail::generic::blas::dot;
+
+    profiled_call<ExecutionPolicy> call(exec, "cusp::blas::dot", array_bytes(x) + array_bytes(y));
+
+    return dot(exec.base(), x, y);
+}
+
+template <template <typename> class ExecutionPolicy,
+          typename Array1,
+          typename Array2>
+typename Array1::value_type
+dotc(execute_profiling<ExecutionPolicy>& exec,
+     const Array1& x,
+     const Array2& y)
+{
+    using cusp::system::detail::generic::blas::dotc;
+
+    profiled_call<ExecutionPolicy> call(exec, "cusp::blas::dotc", array_bytes(x) + array_bytes(y));
+
+    return dotc(exec.base(), x, y);
+}
+
+template <template <typename> class ExecutionPolicy,
+          typename Array,
+          typename ScalarType>
+void fill(execute_profiling<ExecutionPolicy>& exec,
+          Array& x,
+          const ScalarType alpha)
+{
+    using cusp::system::detail::generic::blas::fill;
+
+    profiled_call<ExecutionPolicy> call(exec, "cusp::blas::fill", 0, array_bytes(x));
+
+    fill(exec.base(), x, alpha);
+}
+
+template <template <typename> class ExecutionPolicy,
+          typename Array>
+typename cusp::norm_type<typename Array::value_type>::type
+nrm2(execute_profiling<ExecutionPolicy>& exec,
+     const Array& x)
+{
+    using cusp::system::detail::generic::blas::nrm2;
+
+    profiled_call<ExecutionPolicy> call(exec, "cusp::blas::nrm2", array_bytes(x));
+
+    return nrm2(exec.base(), x);
+}
+
+template <template <typename> class ExecutionPolicy,
+          typename Array>
+typename cusp::norm_type<typename Array::value_type>::type
+nrmmax(execute_profiling<ExecutionPolicy>& exec,
+       const Array& x)
+{
+    using cusp::system::detail::generic::blas::nrmmax;
+
+    profiled_call<ExecutionPolicy> call(exec, "cusp::blas::nrmmax", array_bytes(x));
+
+    return nrmmax(exec.base(), x);
+}
+
+template <template <typename> class ExecutionPolicy,
+          typename Array,
+          typename ScalarType>
+void scal(execute_profiling<ExecutionPolicy>& exec,
+          Array& x,
+          const ScalarType alpha)
+{
+    using cusp::system::detail::generic::blas::scal;
+
+    profiled_call<ExecutionPolicy> call(exec, "cusp::blas::scal", array_bytes(x), array_bytes(x));
+
+    scal(exec.base(), x, alpha);
+}
+
+} // end namespace profiling
+} // end namespace detail
+} // end namespace system
+} // end namespace cusp
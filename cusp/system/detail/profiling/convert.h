@@ -0,0 +1,52 @@
+/*
+ *  Copyright 2008-2014 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+
+#pragma once
+
+#include <cusp/detail/config.h>
+
+#include <cusp/system/detail/generic/convert.h>
+#include <cusp/system/detail/profiling/execution_policy.h>
+#include <cusp/system/detail/profiling/profiled_call.h>
+
+namespace cusp
+{
+namespace system
+{
+namespace detail
+{
+namespace profiling
+{
+
+template <template <typename> class ExecutionPolicy,
+          typename SourceType,
+          typename DestinationType>
+void convert(execute_profiling<ExecutionPolicy>& exec,
+             const SourceType& src,
+                   DestinationType& dst)
+{
+    using cusp::system::detail::generic::convert;
+
+    profiled_call<ExecutionPolicy> call(exec, "cusp::convert");
+
+    convert(exec.base(), src, dst);
+}
+
+} // end namespace profiling
+} // end namespace detail
+} // end namespace system
+} // end namespace cusp
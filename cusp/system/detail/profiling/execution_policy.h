@@ -0,0 +1,73 @@
+/*
+ *  Copyright 2008-2014 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#pragma once
+
+/*! \file cusp/system/detail/profiling/execution_policy.h
+ *  \brief Execution policy adaptor recording the calls made through it.
+ */
+
+#include <cusp/detail/config.h>
+
+namespace cusp
+{
+
+class profiling_log;
+
+namespace system
+{
+namespace detail
+{
+namespace profiling
+{
+
+// Runs every algorithm on the system of ExecutionPolicy, but the calls of
+// cusp::multiply, multiply_transpose, convert, transpose and of the
+// cusp::blas level 1 routines are timed and added to a cusp::profiling_log
+// before they are forwarded to the implementations of the system. The
+// policy is obtained from the profiling() member of a system's par, e.g.
+// cusp::cuda::par.profiling(log) or cusp::device_memory().profiling(log).
+template <template <typename> class ExecutionPolicy>
+class execute_profiling
+  : public ExecutionPolicy< execute_profiling<ExecutionPolicy> >
+{
+  public:
+
+    typedef ExecutionPolicy< execute_profiling<ExecutionPolicy> > base_type;
+
+    explicit execute_profiling(cusp::profiling_log& log)
+      : m_log(&log) {}
+
+    cusp::profiling_log& log(void) const
+    {
+        return *m_log;
+    }
+
+    // the system policy, overloads taking it ignore the profiling
+    base_type& base(void)
+    {
+        return *this;
+    }
+
+  private:
+
+    cusp::profiling_log* m_log;
+};
+
+} // end namespace profiling
+} // end namespace detail
+} // end namespace system
+} // end namespace cusp
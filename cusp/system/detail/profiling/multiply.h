@@ -0,0 +1,168 @@
+/*
+ *  Copyright 2008-2014 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#pragma once
+
+#include <cusp/detail/config.h>
+#include <cusp/detail/format.h>
+
+#include <cusp/system/detail/generic/multiply.h>
+#include <cusp/system/detail/profiling/execution_policy.h>
+#include <cusp/system/detail/profiling/profiled_call.h>
+
+namespace cusp
+{
+namespace system
+{
+namespace detail
+{
+namespace profiling
+{
+
+// Bytes of A and x read by y = A x, following the model of
+// performance/spmv/bytes_per_spmv.h: every stored entry reads its value,
+// its indices and one entry of x. Formats without a model, such as linear
+// operators, count nothing.
+template <typename MatrixType, typename Format>
+size_t spmv_bytes_read(const MatrixType&, const size_t, Format)
+{
+    return 0;
+}
+
+template <typename MatrixType>
+size_t spmv_bytes_read(const MatrixType& A, const size_t x_bytes, cusp::coo_format)
+{
+    typedef typename MatrixType::index_type IndexType;
+    typedef typename MatrixType::value_type ValueType;
+
+    // row and column indices, A[i,j] and x[j]
+    return (2 * sizeof(IndexType) + sizeof(ValueType) + x_bytes) * A.num_entries;
+}
+
+template <typename MatrixType>
+size_t spmv_bytes_read(const MatrixType& A, const size_t x_bytes, cusp::csr_format)
+{
+    typedef typename MatrixType::index_type IndexType;
+    typedef typename MatrixType::value_type ValueType;
+
+    // row pointer, column index, A[i,j] and x[j]
+    return 2 * sizeof(IndexType) * A.num_rows
+         + (sizeof(IndexType) + sizeof(ValueType) + x_bytes) * A.num_entries;
+}
+
+template <typename MatrixType>
+size_t spmv_bytes_read(const MatrixType& A, const size_t x_bytes, cusp::dia_format)
+{
+    typedef typename MatrixType::value_type ValueType;
+
+    // A[i,j] and x[j], the diagonal offsets are neglected
+    return (sizeof(ValueType) + x_bytes) * A.num_entries;
+}
+
+template <typename MatrixType>
+size_t spmv_bytes_read(const MatrixType& A, const size_t x_bytes, cusp::ell_format)
+{
+    typedef typename MatrixType::index_type IndexType;
+    typedef typename MatrixType::value_type ValueType;
+
+    // A[i,j] including the padding, column index and x[j]
+    return sizeof(ValueType) * A.values.num_rows * A.values.num_cols
+         + (sizeof(IndexType) + x_bytes) * A.num_entries;
+}
+
+template <typename MatrixType>
+size_t spmv_bytes_read(const MatrixType& A, const size_t x_bytes, cusp::hyb_format)
+{
+    return spmv_bytes_read(A.ell, x_bytes, cusp::ell_format())
+         + spmv_bytes_read(A.coo, x_bytes, cusp::coo_format());
+}
+
+template <typename MatrixType>
+size_t spmv_bytes_read(const MatrixType& A, const size_t x_bytes, cusp::array2d_format)
+{
+    typedef typename MatrixType::value_type ValueType;
+
+    return sizeof(ValueType) * A.num_rows * A.num_cols + x_bytes * A.num_cols;
+}
+
+// matrix-matrix products count nothing
+template <typename LinearOperator, typename MatrixOrVector1, typename MatrixOrVector2, typename Format>
+void multiply_bytes(const LinearOperator&, const MatrixOrVector1&, const MatrixOrVector2&,
+                    size_t&, size_t&, Format)
+{
+}
+
+// y[i] is counted as read and written like in the SpMV benchmarks
+template <typename LinearOperator, typename MatrixOrVector1, typename MatrixOrVector2>
+void multiply_bytes(const LinearOperator& A, const MatrixOrVector1&, const MatrixOrVector2& C,
+                    size_t& bytes_read, size_t& bytes_written, cusp::array1d_format)
+{
+    typedef typename LinearOperator::format Format;
+
+    const size_t x_bytes = sizeof(typename MatrixOrVector1::value_type);
+
+    bytes_read = spmv_bytes_read(A, x_bytes, Format());
+
+    if (bytes_read > 0)
+    {
+        bytes_read   += array_bytes(C);
+        bytes_written = array_bytes(C);
+    }
+}
+
+template <template <typename> class ExecutionPolicy,
+          typename LinearOperator,
+          typename MatrixOrVector1,
+          typename MatrixOrVector2>
+void multiply(execute_profiling<ExecutionPolicy>& exec,
+              const LinearOperator&  A,
+              const MatrixOrVector1& B,
+                    MatrixOrVector2& C)
+{
+    using cusp::system::detail::generic::multiply;
+
+    typedef typename MatrixOrVector1::format Format;
+
+    size_t bytes_read    = 0;
+    size_t bytes_written = 0;
+
+    multiply_bytes(A, B, C, bytes_read, bytes_written, Format());
+
+    profiled_call<ExecutionPolicy> call(exec, "cusp::multiply", bytes_read, bytes_written);
+
+    multiply(exec.base(), A, B, C);
+}
+
+template <template <typename> class ExecutionPolicy,
+          typename MatrixType,
+          typename VectorType1,
+          typename VectorType2>
+void multiply_transpose(execute_profiling<ExecutionPolicy>& exec,
+                        const MatrixType&  A,
+                        const VectorType1& x,
+                              VectorType2& y)
+{
+    using cusp::system::detail::generic::multiply_transpose;
+
+    profiled_call<ExecutionPolicy> call(exec, "cusp::multiply_transpose");
+
+    multiply_transpose(exec.base(), A, x, y);
+}
+
+} // end namespace profiling
+} // end namespace detail
+} // end namespace system
+} // end namespace cusp
@@ -0,0 +1,132 @@
+/*
+ *  Copyright 2008-2014 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#pragma once
+
+#include <cusp/detail/config.h>
+#include <cusp/detail/timer.h>
+#include <cusp/profiling_log.h>
+
+#include <cusp/system/detail/profiling/execution_policy.h>
+
+#if THRUST_DEVICE_SYSTEM == THRUST_DEVICE_SYSTEM_CUDA
+#include <cusp/system/cuda/detail/execution_policy.h>
+#include <cuda_runtime_api.h>
+#endif
+
+namespace cusp
+{
+namespace system
+{
+namespace detail
+{
+namespace profiling
+{
+
+// bytes occupied by the entries of a one-dimensional array
+template <typename ArrayType>
+size_t array_bytes(const ArrayType& x)
+{
+    return sizeof(typename ArrayType::value_type) * x.size();
+}
+
+// host systems only measure the wall time
+template <template <typename> class ExecutionPolicy>
+class call_events
+{
+  public:
+
+    void start(cusp::profiling_log&) {}
+
+    void stop(cusp::profiling_log& log, const char* name, const double seconds,
+              const size_t bytes_read, const size_t bytes_written)
+    {
+        log.record(name, seconds, bytes_read, bytes_written);
+    }
+};
+
+#if THRUST_DEVICE_SYSTEM == THRUST_DEVICE_SYSTEM_CUDA
+// the device work of the call is enclosed by two events on the default
+// stream, their elapsed time is read by the log once they have completed
+template <>
+class call_events<cusp::system::cuda::detail::execution_policy>
+{
+  public:
+
+    void start(cusp::profiling_log& log)
+    {
+        m_start = log.event();
+        m_stop  = log.event();
+
+        cudaEventRecord(m_start, 0);
+    }
+
+    void stop(cusp::profiling_log& log, const char* name, const double seconds,
+              const size_t bytes_read, const size_t bytes_written)
+    {
+        cudaEventRecord(m_stop, 0);
+
+        log.record(name, seconds, bytes_read, bytes_written, m_start, m_stop);
+    }
+
+  private:
+
+    cudaEvent_t m_start;
+    cudaEvent_t m_stop;
+};
+#endif
+
+// records one call of name from construction until destruction, calls
+// made by the forwarded implementation are recorded separately
+template <template <typename> class ExecutionPolicy>
+class profiled_call
+{
+  public:
+
+    profiled_call(execute_profiling<ExecutionPolicy>& exec, const char* name,
+                  const size_t bytes_read = 0, const size_t bytes_written = 0)
+      : m_log(exec.log()), m_name(name),
+        m_bytes_read(bytes_read), m_bytes_written(bytes_written),
+        m_start(cusp::detail::wall_clock_seconds())
+    {
+        m_events.start(m_log);
+    }
+
+    ~profiled_call(void)
+    {
+        const double seconds = cusp::detail::wall_clock_seconds() - m_start;
+
+        m_events.stop(m_log, m_name, seconds, m_bytes_read, m_bytes_written);
+    }
+
+  private:
+
+    cusp::profiling_log& m_log;
+    const char*          m_name;
+    size_t               m_bytes_read;
+    size_t               m_bytes_written;
+    double               m_start;
+
+    call_events<ExecutionPolicy> m_events;
+
+    profiled_call(const profiled_call&);
+    profiled_call& operator=(const profiled_call&);
+};
+
+} // end namespace profiling
+} // end namespace detail
+} // end namespace system
+} // end namespace cusp
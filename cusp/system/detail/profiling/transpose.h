@@ -0,0 +1,52 @@
+/*
+ *  Copyright 2008-2014 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+
+#pragma once
+
+#include <cusp/detail/config.h>
+
+#include <cusp/system/detail/generic/transpose.h>
+#include <cusp/system/detail/profiling/execution_policy.h>
+#include <cusp/system/detail/profiling/profiled_call.h>
+
+namespace cusp
+{
+namespace system
+{
+namespace detail
+{
+namespace profiling
+{
+
+template <template <typename> class ExecutionPolicy,
+          typename MatrixType1,
+          typename MatrixType2>
+void transpose(execute_profiling<ExecutionPolicy>& exec,
+               const MatrixType1& A,
+                     MatrixType2& At)
+{
+    using cusp::system::detail::generic::transpose;
+
+    profiled_call<ExecutionPolicy> call(exec, "cusp::transpose");
+
+    transpose(exec.base(), A, At);
+}
+
+} // end namespace profiling
+} // end namespace detail
+} // end namespace system
+} // end namespace cusp
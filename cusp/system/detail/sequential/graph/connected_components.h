@@ -64,6 +64,7 @@ size_t connected_components(thrust::cpp::execution_policy<DerivedPolicy>& exec,
 
                 for(VertexId jj = G.row_offsets[top]; jj < G.row_offsets[top + 1]; jj++) {
                     const VertexId j = G.column_indices[jj];
+                    if(j < 0) continue;
                     if(components[j] == -1) {
                         DFS.push(j);
                         components[j] = component;
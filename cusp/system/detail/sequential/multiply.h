@@ -19,13 +19,20 @@
 #include <cusp/detail/config.h>
 #include <cusp/system/detail/sequential/execution_policy.h>
 
+#include <cusp/system/detail/sequential/multiply/bsr_spmv.h>
 #include <cusp/system/detail/sequential/multiply/coo_spmv.h>
 #include <cusp/system/detail/sequential/multiply/csr_spmv.h>
+#include <cusp/system/detail/sequential/multiply/csr_spmv_dotc.h>
+#include <cusp/system/detail/sequential/multiply/dcsr_spmv.h>
 #include <cusp/system/detail/sequential/multiply/dia_spmv.h>
+#include <cusp/system/detail/sequential/multiply/dynamic_csr_spmv.h>
 #include <cusp/system/detail/sequential/multiply/ell_spmv.h>
 #include <cusp/system/detail/sequential/multiply/hyb_spmv.h>
+#include <cusp/system/detail/sequential/multiply/sell_spmv.h>
+#include <cusp/system/detail/sequential/multiply/symmetric_spmv.h>
 
 #include <cusp/system/detail/sequential/multiply/csr_block_spmv.h>
+#include <cusp/system/detail/sequential/multiply/transpose_spmv.h>
 
 #include <cusp/system/detail/sequential/multiply/array2d_mv.h>
 #include <cusp/system/detail/sequential/multiply/array2d_mm.h>
@@ -21,6 +21,9 @@
 
 #include <cusp/system/detail/sequential/execution_policy.h>
 
+#include <algorithm>
+#include <vector>
+
 namespace cusp
 {
 namespace system
@@ -30,6 +33,171 @@ namespace detail
 namespace sequential
 {
 
+// Blocking of the dense product C = A * B.  C is computed in tiles of at
+// most MC x NC entries.  Each tile walks the inner dimension in blocks of
+// KC, packs the touched part of B into panels of NR columns and that of A
+// into panels of MR rows, and updates MR x NR register blocks of C from
+// the panels.  The packed panels are read with unit stride whatever the
+// orientation of A and B.  Every entry of C still reduces its products in
+// the order of k, so results are identical to the triple loop for any
+// combine and reduce.
+struct array2d_mm_blocking
+{
+    static const size_t MR = 4;
+    static const size_t NR = 8;
+    static const size_t KC = 256;
+    static const size_t MC = 64;
+    static const size_t NC = 256;
+
+    // products with less work run the plain triple loop
+    static const size_t min_blocked_work = 32 * 32 * 32;
+};
+
+template <typename MatrixType1,
+          typename MatrixType2,
+          typename MatrixType3,
+          typename UnaryFunction,
+          typename BinaryFunction1,
+          typename BinaryFunction2>
+void array2d_mm_loop(const MatrixType1& A,
+                     const MatrixType2& B,
+                     MatrixType3& C,
+                     const size_t row_begin, const size_t row_end,
+                     const size_t col_begin, const size_t col_end,
+                     UnaryFunction   initialize,
+                     BinaryFunction1 combine,
+                     BinaryFunction2 reduce)
+{
+    typedef typename MatrixType3::value_type ValueType;
+
+    for(size_t i = row_begin; i < row_end; i++)
+    {
+        for(size_t j = col_begin; j < col_end; j++)
+        {
+            ValueType v = initialize(C(i,j));
+
+            for(size_t k = 0; k < A.num_cols; k++)
+                v = reduce(v, combine(A(i,k), B(k,j)));
+
+            C(i,j) = v;
+        }
+    }
+}
+
+// computes rows [row_begin,row_end) and columns [col_begin,col_end) of C,
+// the range spans at most MC x NC entries when called for parallel tiles
+template <typename MatrixType1,
+          typename MatrixType2,
+          typename MatrixType3,
+          typename UnaryFunction,
+          typename BinaryFunction1,
+          typename BinaryFunction2>
+void array2d_mm_tile(const MatrixType1& A,
+                     const MatrixType2& B,
+                     MatrixType3& C,
+                     const size_t row_begin, const size_t row_end,
+                     const size_t col_begin, const size_t col_end,
+                     UnaryFunction   initialize,
+                     BinaryFunction1 combine,
+                     BinaryFunction2 reduce)
+{
+    typedef typename MatrixType1::value_type ValueType1;
+    typedef typename MatrixType2::value_type ValueType2;
+    typedef typename MatrixType3::value_type ValueType3;
+
+    const size_t MR = array2d_mm_blocking::MR;
+    const size_t NR = array2d_mm_blocking::NR;
+    const size_t KC = array2d_mm_blocking::KC;
+    const size_t MC = array2d_mm_blocking::MC;
+    const size_t NC = array2d_mm_blocking::NC;
+
+    const size_t K = A.num_cols;
+
+    if((row_end - row_begin) * (col_end - col_begin) * K < array2d_mm_blocking::min_blocked_work)
+    {
+        array2d_mm_loop(A, B, C, row_begin, row_end, col_begin, col_end, initialize, combine, reduce);
+        return;
+    }
+
+    // panels are padded to full MR rows and NR columns
+    std::vector<ValueType1> packed_A(((MC + MR - 1) / MR) * MR * KC);
+    std::vector<ValueType2> packed_B(((NC + NR - 1) / NR) * NR * KC);
+
+    for(size_t jb = col_begin; jb < col_end; jb += NC)
+    {
+        const size_t nc = std::min(NC, col_end - jb);
+
+        for(size_t kb = 0; kb < K; kb += KC)
+        {
+            const size_t kc = std::min(KC, K - kb);
+
+            // B(kb:kb+kc, jb:jb+nc) as column panels, row k of a panel is contiguous
+            for(size_t p = 0; p < nc; p += NR)
+            {
+                ValueType2 * panel = &packed_B[p * kc];
+
+                for(size_t k = 0; k < kc; k++)
+                    for(size_t jj = 0; jj < NR; jj++)
+                        panel[k * NR + jj] = p + jj < nc ? ValueType2(B(kb + k, jb + p + jj)) : ValueType2();
+            }
+
+            for(size_t ib = row_begin; ib < row_end; ib += MC)
+            {
+                const size_t mc = std::min(MC, row_end - ib);
+
+                // A(ib:ib+mc, kb:kb+kc) as row panels, column k of a panel is contiguous
+                for(size_t q = 0; q < mc; q += MR)
+                {
+                    ValueType1 * panel = &packed_A[q * kc];
+
+                    for(size_t k = 0; k < kc; k++)
+                        for(size_t ii = 0; ii < MR; ii++)
+                            panel[k * MR + ii] = q + ii < mc ? ValueType1(A(ib + q + ii, kb + k)) : ValueType1();
+                }
+
+                for(size_t q = 0; q < mc; q += MR)
+                {
+                    const size_t mr = std::min(MR, mc - q);
+                    const ValueType1 * a = &packed_A[q * kc];
+
+                    for(size_t p = 0; p < nc; p += NR)
+                    {
+                        const size_t nr = std::min(NR, nc - p);
+                        const ValueType2 * b = &packed_B[p * kc];
+
+                        ValueType3 acc[MR][NR];
+
+                        for(size_t ii = 0; ii < MR; ii++)
+                            for(size_t jj = 0; jj < NR; jj++)
+                                acc[ii][jj] = ValueType3();
+
+                        // the first block of k starts from the initialized C
+                        for(size_t ii = 0; ii < mr; ii++)
+                            for(size_t jj = 0; jj < nr; jj++)
+                                acc[ii][jj] = kb == 0 ? initialize(C(ib + q + ii, jb + p + jj))
+                                                      : C(ib + q + ii, jb + p + jj);
+
+                        for(size_t k = 0; k < kc; k++)
+                        {
+                            for(size_t ii = 0; ii < MR; ii++)
+                            {
+                                const ValueType1 aik = a[k * MR + ii];
+
+                                for(size_t jj = 0; jj < NR; jj++)
+                                    acc[ii][jj] = reduce(acc[ii][jj], combine(aik, b[k * NR + jj]));
+                            }
+                        }
+
+                        for(size_t ii = 0; ii < mr; ii++)
+                            for(size_t jj = 0; jj < nr; jj++)
+                                C(ib + q + ii, jb + p + jj) = acc[ii][jj];
+                    }
+                }
+            }
+        }
+    }
+}
+
 template <typename DerivedPolicy,
           typename MatrixType1,
           typename MatrixType2,
@@ -48,22 +216,9 @@ void multiply(thrust::cpp::execution_policy<DerivedPolicy>& exec,
               cusp::array2d_format,
               cusp::array2d_format)
 {
-    typedef typename MatrixType3::value_type ValueType;
-
     C.resize(A.num_rows, B.num_cols);
 
-    for(size_t i = 0; i < C.num_rows; i++)
-    {
-        for(size_t j = 0; j < C.num_cols; j++)
-        {
-            ValueType v = initialize(C(i,j));
-
-            for(size_t k = 0; k < A.num_cols; k++)
-                v = reduce(v, combine(A(i,k), B(k,j)));
-
-            C(i,j) = v;
-        }
-    }
+    array2d_mm_tile(A, B, C, 0, C.num_rows, 0, C.num_cols, initialize, combine, reduce);
 }
 
 } // end namespace sequential
@@ -69,7 +69,7 @@ void multiply(thrust::cpp::execution_policy<DerivedPolicy>& exec,
                        B_row_offsets, B.column_indices);
 
     // Resize output
-    C.resize(A.num_rows, B.num_cols, estimated_nonzeros);
+    C.resize(A.num_rows, B.num_cols, estimated_nonzeros, cusp::no_init);
 
     IndexType3 true_nonzeros =
         spmm_csr_pass2(exec, A.num_rows, B.num_cols,
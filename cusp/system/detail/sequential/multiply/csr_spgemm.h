@@ -19,6 +19,7 @@
 #include <cusp/detail/config.h>
 #include <cusp/detail/format.h>
 #include <cusp/detail/temporary_array.h>
+#include <cusp/detail/type_traits.h>
 
 #include <cusp/system/detail/sequential/execution_policy.h>
 
@@ -41,8 +42,10 @@ size_t spmm_csr_pass1(thrust::cpp::execution_policy<DerivedPolicy> &exec,
                       const Array1& A_row_offsets, const Array2& A_column_indices,
                       const Array3& B_row_offsets, const Array4& B_column_indices)
 {
-    typedef typename Array1::value_type IndexType1;
-    typedef typename Array2::value_type IndexType2;
+    typedef typename Array1::value_type OffsetType1;
+    typedef typename Array2::value_type IndexType1;
+    typedef typename Array3::value_type OffsetType2;
+    typedef typename Array4::value_type IndexType2;
 
     cusp::detail::temporary_array<size_t, DerivedPolicy> mask(exec, num_cols, static_cast<size_t>(-1));
 
@@ -51,11 +54,11 @@ size_t spmm_csr_pass1(thrust::cpp::execution_policy<DerivedPolicy> &exec,
 
     for(size_t i = 0; i < num_rows; i++)
     {
-        for(IndexType1 jj = A_row_offsets[i]; jj < A_row_offsets[i+1]; jj++)
+        for(OffsetType1 jj = A_row_offsets[i]; jj < A_row_offsets[i+1]; jj++)
         {
             IndexType1 j = A_column_indices[jj];
 
-            for(IndexType2 kk = B_row_offsets[j]; kk < B_row_offsets[j+1]; kk++)
+            for(OffsetType2 kk = B_row_offsets[j]; kk < B_row_offsets[j+1]; kk++)
             {
                 IndexType2 k = B_column_indices[kk];
 
@@ -83,7 +86,9 @@ size_t spmm_csr_pass2(thrust::cpp::execution_policy<DerivedPolicy> &exec,
                       Array7& C_row_offsets,       Array8& C_column_indices,       Array9& C_values,
                       UnaryFunction initialize,    BinaryFunction1 combine,        BinaryFunction2 reduce)
 {
-    typedef typename Array7::value_type IndexType;
+    typedef typename Array1::value_type OffsetType1;
+    typedef typename Array4::value_type OffsetType2;
+    typedef typename Array8::value_type IndexType;
     typedef typename Array9::value_type ValueType;
 
     size_t num_nonzeros = 0;
@@ -104,18 +109,18 @@ size_t spmm_csr_pass2(thrust::cpp::execution_policy<DerivedPolicy> &exec,
         IndexType head   = init;
         IndexType length =    0;
 
-        IndexType jj_start = A_row_offsets[i];
-        IndexType jj_end   = A_row_offsets[i+1];
+        OffsetType1 jj_start = A_row_offsets[i];
+        OffsetType1 jj_end   = A_row_offsets[i+1];
 
-        for(IndexType jj = jj_start; jj < jj_end; jj++)
+        for(OffsetType1 jj = jj_start; jj < jj_end; jj++)
         {
             IndexType j = A_column_indices[jj];
             ValueType v = A_values[jj];
 
-            IndexType kk_start = B_row_offsets[j];
-            IndexType kk_end   = B_row_offsets[j+1];
+            OffsetType2 kk_start = B_row_offsets[j];
+            OffsetType2 kk_end   = B_row_offsets[j+1];
 
-            for(IndexType kk = kk_start; kk < kk_end; kk++)
+            for(OffsetType2 kk = kk_start; kk < kk_end; kk++)
             {
                 IndexType k = B_column_indices[kk];
 
@@ -173,16 +178,16 @@ void multiply(thrust::cpp::execution_policy<DerivedPolicy>& exec,
               cusp::csr_format,
               cusp::csr_format)
 {
-    typedef typename MatrixType3::index_type IndexType;
+    typedef typename cusp::detail::get_offset_type<MatrixType3>::type OffsetType;
 
-    IndexType num_nonzeros =
+    OffsetType num_nonzeros =
         spmm_csr_pass1(exec,
                        A.num_rows, B.num_cols,
                        A.row_offsets, A.column_indices,
                        B.row_offsets, B.column_indices);
 
-    // Resize output
-    C.resize(A.num_rows, B.num_cols, num_nonzeros);
+    // Resize output, pass2 writes every entry
+    C.resize(A.num_rows, B.num_cols, num_nonzeros, cusp::no_init);
 
     num_nonzeros =
         spmm_csr_pass2(exec,
@@ -18,8 +18,10 @@
 
 #include <cusp/detail/config.h>
 #include <cusp/detail/format.h>
+#include <cusp/detail/type_traits.h>
 
 #include <cusp/system/detail/sequential/execution_policy.h>
+#include <cusp/system/detail/sequential/multiply/simd_spmv.h>
 
 #include <cstddef>
 
@@ -50,17 +52,21 @@ void multiply(thrust::cpp::execution_policy<DerivedPolicy>& exec,
               cusp::array1d_format,
               cusp::array1d_format)
 {
+    if(simd::spmv(A, x, y, initialize, combine, reduce, cusp::csr_format()))
+        return;
+
     typedef typename MatrixType::index_type  IndexType;
+    typedef typename cusp::detail::get_offset_type<MatrixType>::type OffsetType;
     typedef typename VectorType2::value_type ValueType;
 
     for(size_t i = 0; i < A.num_rows; i++)
     {
-        const IndexType& row_start = A.row_offsets[i];
-        const IndexType& row_end   = A.row_offsets[i+1];
+        const OffsetType& row_start = A.row_offsets[i];
+        const OffsetType& row_end   = A.row_offsets[i+1];
 
         ValueType accumulator = initialize(y[i]);
 
-        for (IndexType jj = row_start; jj < row_end; jj++)
+        for (OffsetType jj = row_start; jj < row_end; jj++)
         {
             const IndexType& j   = A.column_indices[jj];
             const ValueType& Aij = A.values[jj];
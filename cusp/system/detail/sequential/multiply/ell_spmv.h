@@ -21,6 +21,7 @@
 
 #include <cusp/functional.h>
 #include <cusp/system/detail/sequential/execution_policy.h>
+#include <cusp/system/detail/sequential/multiply/simd_spmv.h>
 
 namespace cusp
 {
@@ -49,6 +50,9 @@ void multiply(thrust::cpp::execution_policy<DerivedPolicy>& exec,
               cusp::array1d_format,
               cusp::array1d_format)
 {
+    if(simd::spmv(A, x, y, initialize, combine, reduce, cusp::ell_format()))
+        return;
+
     typedef typename MatrixType::index_type  IndexType;
     typedef typename VectorType2::value_type ValueType;
 
@@ -0,0 +1,102 @@
+/*
+ *  Copyright 2008-2014 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#pragma once
+
+#include <cusp/detail/config.h>
+#include <cusp/detail/format.h>
+
+#include <cusp/functional.h>
+#include <cusp/system/detail/sequential/execution_policy.h>
+#include <cusp/system/detail/sequential/multiply/simd_spmv.h>
+
+namespace cusp
+{
+namespace system
+{
+namespace detail
+{
+namespace sequential
+{
+
+template <typename DerivedPolicy,
+         typename MatrixType,
+         typename VectorType1,
+         typename VectorType2,
+         typename UnaryFunction,
+         typename BinaryFunction1,
+         typename BinaryFunction2>
+void multiply(thrust::cpp::execution_policy<DerivedPolicy>& exec,
+              const MatrixType& A,
+              const VectorType1& x,
+              VectorType2& y,
+              UnaryFunction   initialize,
+              BinaryFunction1 combine,
+              BinaryFunction2 reduce,
+              cusp::sell_format,
+              cusp::array1d_format,
+              cusp::array1d_format)
+{
+    if(simd::spmv(A, x, y, initialize, combine, reduce, cusp::sell_format()))
+        return;
+
+    typedef typename MatrixType::index_type  IndexType;
+    typedef typename VectorType2::value_type ValueType;
+
+    const size_t slice_size = A.slice_size;
+    const size_t num_slices = A.num_slices();
+
+    const IndexType invalid_index = MatrixType::invalid_index;
+
+    for(size_t s = 0; s < num_slices; s++)
+    {
+        const IndexType slice_start = A.slice_offsets[s];
+        const IndexType slice_width = (A.slice_offsets[s + 1] - slice_start) / slice_size;
+
+        for(size_t lane = 0; lane < slice_size; lane++)
+        {
+            const size_t position = s * slice_size + lane;
+
+            if(position >= A.num_rows)
+                break;
+
+            const IndexType i = A.row_permutation[position];
+
+            ValueType accumulator = initialize(y[i]);
+
+            for(IndexType n = 0; n < slice_width; n++)
+            {
+                const IndexType offset = slice_start + n * slice_size + lane;
+                const IndexType j      = A.column_indices[offset];
+
+                if (j != invalid_index)
+                {
+                    const ValueType Aij = A.values[offset];
+                    const ValueType xj  = x[j];
+
+                    accumulator = reduce(accumulator, combine(Aij, xj));
+                }
+            }
+
+            y[i] = accumulator;
+        }
+    }
+}
+
+} // end namespace sequential
+} // end namespace detail
+} // end namespace system
+} // end namespace cusp
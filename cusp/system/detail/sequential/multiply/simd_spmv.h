@@ -0,0 +1,611 @@
+/*
+ *  Copyright 2008-2014 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#pragma once
+
+#include <cusp/detail/config.h>
+#include <cusp/detail/format.h>
+
+#include <cusp/functional.h>
+
+#include <thrust/functional.h>
+#include <thrust/detail/type_traits.h>
+#include <thrust/iterator/detail/is_trivial_iterator.h>
+
+// Hand vectorized SpMV kernels for x86 hosts.  The kernels are compiled
+// with function level target attributes and selected at runtime from the
+// CPUID feature flags, so a binary built for the baseline architecture
+// still uses AVX2 or AVX-512 on nodes which support them.  Define
+// CUSP_SIMD_SPMV to 0 to disable them, or to 1 to force them on when the
+// default detection below is too conservative (e.g. recent nvcc versions
+// accept the intrinsic headers in host code).
+#ifndef CUSP_SIMD_SPMV
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__)) && !defined(__CUDACC__)
+#define CUSP_SIMD_SPMV 1
+#else
+#define CUSP_SIMD_SPMV 0
+#endif
+#endif
+
+#if CUSP_SIMD_SPMV
+#include <immintrin.h>
+#endif
+
+namespace cusp
+{
+namespace system
+{
+namespace detail
+{
+namespace sequential
+{
+namespace simd
+{
+
+enum simd_level
+{
+    SIMD_NONE,
+    SIMD_AVX2,
+    SIMD_AVX512
+};
+
+#if CUSP_SIMD_SPMV
+
+inline simd_level detect_simd_level(void)
+{
+    __builtin_cpu_init();
+
+    if(__builtin_cpu_supports("avx512f"))
+        return SIMD_AVX512;
+
+    if(__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma"))
+        return SIMD_AVX2;
+
+    return SIMD_NONE;
+}
+
+inline simd_level get_simd_level(void)
+{
+    static const simd_level level = detect_simd_level();
+    return level;
+}
+
+#define CUSP_TARGET_AVX2   __attribute__((target("avx2,fma")))
+#define CUSP_TARGET_AVX512 __attribute__((target("avx512f")))
+
+// Every operation takes the number of active lanes, lanes at or beyond
+// count and lanes holding an invalid (negative) column index contribute
+// nothing.  Masked loads never touch memory of inactive lanes.
+template <typename ValueType> struct avx2;
+template <typename ValueType> struct avx512;
+
+template <>
+struct avx2<float>
+{
+    typedef __m256 vector;
+    static const int width = 8;
+
+    static CUSP_TARGET_AVX2 inline __m256i lanes(int count)
+    {
+        return _mm256_cmpgt_epi32(_mm256_set1_epi32(count),
+                                  _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7));
+    }
+
+    static CUSP_TARGET_AVX2 inline vector zero(void)
+    {
+        return _mm256_setzero_ps();
+    }
+
+    static CUSP_TARGET_AVX2 inline vector load(const float* p, int count)
+    {
+        return _mm256_maskload_ps(p, lanes(count));
+    }
+
+    static CUSP_TARGET_AVX2 inline void store(float* p, vector v, int count)
+    {
+        _mm256_maskstore_ps(p, lanes(count), v);
+    }
+
+    static CUSP_TARGET_AVX2 inline vector fmadd(vector acc, const float* values,
+                                                const int* indices, const float* x)
+    {
+        const __m256i j  = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(indices));
+        const __m256  xj = _mm256_i32gather_ps(x, j, 4);
+        return _mm256_fmadd_ps(_mm256_loadu_ps(values), xj, acc);
+    }
+
+    static CUSP_TARGET_AVX2 inline vector fmadd(vector acc, const float* values,
+                                                const int* indices, const float* x, int count)
+    {
+        const __m256i active = lanes(count);
+        const __m256i j      = _mm256_maskload_epi32(indices, active);
+        const __m256i valid  = _mm256_andnot_si256(_mm256_cmpgt_epi32(_mm256_setzero_si256(), j), active);
+        const __m256  xj     = _mm256_mask_i32gather_ps(_mm256_setzero_ps(), x, j,
+                                                        _mm256_castsi256_ps(valid), 4);
+        return _mm256_fmadd_ps(_mm256_maskload_ps(values, valid), xj, acc);
+    }
+
+    static CUSP_TARGET_AVX2 inline float sum(vector v)
+    {
+        __m128 s = _mm_add_ps(_mm256_castps256_ps128(v), _mm256_extractf128_ps(v, 1));
+        s = _mm_add_ps(s, _mm_movehl_ps(s, s));
+        s = _mm_add_ss(s, _mm_shuffle_ps(s, s, 1));
+        return _mm_cvtss_f32(s);
+    }
+};
+
+template <>
+struct avx2<double>
+{
+    typedef __m256d vector;
+    static const int width = 4;
+
+    static CUSP_TARGET_AVX2 inline __m128i lanes(int count)
+    {
+        return _mm_cmpgt_epi32(_mm_set1_epi32(count), _mm_setr_epi32(0, 1, 2, 3));
+    }
+
+    static CUSP_TARGET_AVX2 inline vector zero(void)
+    {
+        return _mm256_setzero_pd();
+    }
+
+    static CUSP_TARGET_AVX2 inline vector load(const double* p, int count)
+    {
+        return _mm256_maskload_pd(p, _mm256_cvtepi32_epi64(lanes(count)));
+    }
+
+    static CUSP_TARGET_AVX2 inline void store(double* p, vector v, int count)
+    {
+        _mm256_maskstore_pd(p, _mm256_cvtepi32_epi64(lanes(count)), v);
+    }
+
+    static CUSP_TARGET_AVX2 inline vector fmadd(vector acc, const double* values,
+                                                const int* indices, const double* x)
+    {
+        const __m128i j  = _mm_loadu_si128(reinterpret_cast<const __m128i*>(indices));
+        const __m256d xj = _mm256_i32gather_pd(x, j, 8);
+        return _mm256_fmadd_pd(_mm256_loadu_pd(values), xj, acc);
+    }
+
+    static CUSP_TARGET_AVX2 inline vector fmadd(vector acc, const double* values,
+                                                const int* indices, const double* x, int count)
+    {
+        const __m128i active = lanes(count);
+        const __m128i j      = _mm_maskload_epi32(indices, active);
+        const __m256i valid  = _mm256_cvtepi32_epi64(_mm_andnot_si128(_mm_cmpgt_epi32(_mm_setzero_si128(), j), active));
+        const __m256d xj     = _mm256_mask_i32gather_pd(_mm256_setzero_pd(), x, j,
+                                                        _mm256_castsi256_pd(valid), 8);
+        return _mm256_fmadd_pd(_mm256_maskload_pd(values, valid), xj, acc);
+    }
+
+    static CUSP_TARGET_AVX2 inline double sum(vector v)
+    {
+        __m128d s = _mm_add_pd(_mm256_castpd256_pd128(v), _mm256_extractf128_pd(v, 1));
+        s = _mm_add_sd(s, _mm_unpackhi_pd(s, s));
+        return _mm_cvtsd_f64(s);
+    }
+};
+
+template <>
+struct avx512<float>
+{
+    typedef __m512 vector;
+    static const int width = 16;
+
+    static CUSP_TARGET_AVX512 inline __mmask16 lanes(int count)
+    {
+        return count >= width ? __mmask16(0xFFFF) : __mmask16((1u << count) - 1);
+    }
+
+    static CUSP_TARGET_AVX512 inline vector zero(void)
+    {
+        return _mm512_setzero_ps();
+    }
+
+    static CUSP_TARGET_AVX512 inline vector load(const float* p, int count)
+    {
+        return _mm512_maskz_loadu_ps(lanes(count), p);
+    }
+
+    static CUSP_TARGET_AVX512 inline void store(float* p, vector v, int count)
+    {
+        _mm512_mask_storeu_ps(p, lanes(count), v);
+    }
+
+    static CUSP_TARGET_AVX512 inline vector fmadd(vector acc, const float* values,
+                                                  const int* indices, const float* x)
+    {
+        const __m512i j  = _mm512_loadu_si512(indices);
+        const __m512  xj = _mm512_i32gather_ps(j, x, 4);
+        return _mm512_fmadd_ps(_mm512_loadu_ps(values), xj, acc);
+    }
+
+    static CUSP_TARGET_AVX512 inline vector fmadd(vector acc, const float* values,
+                                                  const int* indices, const float* x, int count)
+    {
+        const __mmask16 active = lanes(count);
+        const __m512i   j      = _mm512_maskz_loadu_epi32(active, indices);
+        const __mmask16 valid  = _mm512_mask_cmpge_epi32_mask(active, j, _mm512_setzero_si512());
+        const __m512    xj     = _mm512_mask_i32gather_ps(_mm512_setzero_ps(), valid, j, x, 4);
+        return _mm512_fmadd_ps(_mm512_maskz_loadu_ps(valid, values), xj, acc);
+    }
+
+    static CUSP_TARGET_AVX512 inline float sum(vector v)
+    {
+        return _mm512_reduce_add_ps(v);
+    }
+};
+
+template <>
+struct avx512<double>
+{
+    typedef __m512d vector;
+    static const int width = 8;
+
+    static CUSP_TARGET_AVX512 inline __mmask8 lanes(int count)
+    {
+        return count >= width ? __mmask8(0xFF) : __mmask8((1u << count) - 1);
+    }
+
+    static CUSP_TARGET_AVX512 inline vector zero(void)
+    {
+        return _mm512_setzero_pd();
+    }
+
+    static CUSP_TARGET_AVX512 inline vector load(const double* p, int count)
+    {
+        return _mm512_maskz_loadu_pd(lanes(count), p);
+    }
+
+    static CUSP_TARGET_AVX512 inline void store(double* p, vector v, int count)
+    {
+        _mm512_mask_storeu_pd(p, lanes(count), v);
+    }
+
+    static CUSP_TARGET_AVX512 inline vector fmadd(vector acc, const double* values,
+                                                  const int* indices, const double* x)
+    {
+        const __m256i j  = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(indices));
+        const __m512d xj = _mm512_i32gather_pd(j, x, 8);
+        return _mm512_fmadd_pd(_mm512_loadu_pd(values), xj, acc);
+    }
+
+    static CUSP_TARGET_AVX512 inline vector fmadd(vector acc, const double* values,
+                                                  const int* indices, const double* x, int count)
+    {
+        const __mmask8 active = lanes(count);
+        const __m512i  j      = _mm512_maskz_loadu_epi32(__mmask16(active), indices);
+        const __mmask8 valid  = __mmask8(_mm512_mask_cmpge_epi32_mask(__mmask16(active), j, _mm512_setzero_si512()));
+        const __m512d  xj     = _mm512_mask_i32gather_pd(_mm512_setzero_pd(), valid,
+                                                         _mm512_castsi512_si256(j), x, 8);
+        return _mm512_fmadd_pd(_mm512_maskz_loadu_pd(valid, values), xj, acc);
+    }
+
+    static CUSP_TARGET_AVX512 inline double sum(vector v)
+    {
+        return _mm512_reduce_add_pd(v);
+    }
+};
+
+// The kernels are spelled out once per instruction set since a function
+// can only be compiled for the targets it is annotated with.
+
+// CSR: vectorize along each row and reduce horizontally
+#define CUSP_SIMD_CSR_SPMV_KERNEL(NAME, ISA, TARGET)                            \
+template <typename ValueType>                                                   \
+TARGET void NAME(const int num_rows,                                            \
+                 const int* row_offsets, const int* column_indices,             \
+                 const ValueType* values, const ValueType* x, ValueType* y,     \
+                 const ValueType initial_value)                                 \
+{                                                                               \
+    typedef ISA<ValueType> ops;                                                 \
+                                                                                \
+    for(int i = 0; i < num_rows; i++)                                           \
+    {                                                                           \
+        const int row_end = row_offsets[i + 1];                                 \
+                                                                                \
+        typename ops::vector acc = ops::zero();                                 \
+                                                                                \
+        int jj = row_offsets[i];                                                \
+        for(; jj + ops::width <= row_end; jj += ops::width)                     \
+            acc = ops::fmadd(acc, values + jj, column_indices + jj, x);         \
+        if(jj < row_end)                                                        \
+            acc = ops::fmadd(acc, values + jj, column_indices + jj, x,          \
+                             row_end - jj);                                     \
+                                                                                \
+        y[i] = initial_value + ops::sum(acc);                                   \
+    }                                                                           \
+}
+
+// ELL: vectorize across consecutive rows of the column major slabs
+#define CUSP_SIMD_ELL_SPMV_KERNEL(NAME, ISA, TARGET)                            \
+template <typename ValueType>                                                   \
+TARGET void NAME(const int num_rows, const int num_entries_per_row,             \
+                 const int* column_indices, const int column_indices_pitch,     \
+                 const ValueType* values, const int values_pitch,               \
+                 const ValueType* x, ValueType* y,                              \
+                 const ValueType initial_value)                                 \
+{                                                                               \
+    typedef ISA<ValueType> ops;                                                 \
+                                                                                \
+    for(int i = 0; i < num_rows; i += ops::width)                               \
+    {                                                                           \
+        const int count = num_rows - i;                                         \
+                                                                                \
+        typename ops::vector acc = ops::zero();                                 \
+                                                                                \
+        for(int n = 0; n < num_entries_per_row; n++)                            \
+            acc = ops::fmadd(acc, values + n * values_pitch + i,                \
+                             column_indices + n * column_indices_pitch + i,     \
+                             x, count);                                         \
+                                                                                \
+        ValueType result[ops::width];                                           \
+        ops::store(result, acc, ops::width);                                    \
+                                                                                \
+        for(int k = 0; k < ops::width && k < count; k++)                        \
+            y[i + k] = initial_value + result[k];                               \
+    }                                                                           \
+}
+
+// SELL: vectorize across the lanes of a slice and scatter through the
+// row permutation
+#define CUSP_SIMD_SELL_SPMV_KERNEL(NAME, ISA, TARGET)                           \
+template <typename ValueType>                                                   \
+TARGET void NAME(const int num_rows, const int num_slices, const int slice_size,\
+                 const int* slice_offsets, const int* column_indices,           \
+                 const ValueType* values, const int* row_permutation,           \
+                 const ValueType* x, ValueType* y,                              \
+                 const ValueType initial_value)                                 \
+{                                                                               \
+    typedef ISA<ValueType> ops;                                                 \
+                                                                                \
+    for(int s = 0; s < num_slices; s++)                                         \
+    {                                                                           \
+        const int slice_start = slice_offsets[s];                               \
+        const int slice_width = (slice_offsets[s + 1] - slice_start) / slice_size; \
+                                                                                \
+        for(int lane = 0; lane < slice_size; lane += ops::width)                \
+        {                                                                       \
+            const int position = s * slice_size + lane;                         \
+                                                                                \
+            if(position >= num_rows)                                            \
+                break;                                                          \
+                                                                                \
+            int count = slice_size - lane;                                      \
+            if(count > num_rows - position)                                     \
+                count = num_rows - position;                                    \
+                                                                                \
+            typename ops::vector acc = ops::zero();                             \
+                                                                                \
+            for(int n = 0; n < slice_width; n++)                                \
+            {                                                                   \
+                const int offset = slice_start + n * slice_size + lane;         \
+                acc = ops::fmadd(acc, values + offset, column_indices + offset, \
+                                 x, count);                                     \
+            }                                                                   \
+                                                                                \
+            ValueType result[ops::width];                                       \
+            ops::store(result, acc, ops::width);                                \
+                                                                                \
+            for(int k = 0; k < ops::width && k < count; k++)                    \
+                y[row_permutation[position + k]] = initial_value + result[k];   \
+        }                                                                       \
+    }                                                                           \
+}
+
+CUSP_SIMD_CSR_SPMV_KERNEL(csr_spmv_avx2,    avx2,   CUSP_TARGET_AVX2)
+CUSP_SIMD_CSR_SPMV_KERNEL(csr_spmv_avx512,  avx512, CUSP_TARGET_AVX512)
+CUSP_SIMD_ELL_SPMV_KERNEL(ell_spmv_avx2,    avx2,   CUSP_TARGET_AVX2)
+CUSP_SIMD_ELL_SPMV_KERNEL(ell_spmv_avx512,  avx512, CUSP_TARGET_AVX512)
+CUSP_SIMD_SELL_SPMV_KERNEL(sell_spmv_avx2,   avx2,   CUSP_TARGET_AVX2)
+CUSP_SIMD_SELL_SPMV_KERNEL(sell_spmv_avx512, avx512, CUSP_TARGET_AVX512)
+
+#undef CUSP_SIMD_CSR_SPMV_KERNEL
+#undef CUSP_SIMD_ELL_SPMV_KERNEL
+#undef CUSP_SIMD_SELL_SPMV_KERNEL
+#undef CUSP_TARGET_AVX2
+#undef CUSP_TARGET_AVX512
+
+#else
+
+inline simd_level get_simd_level(void)
+{
+    return SIMD_NONE;
+}
+
+#endif // CUSP_SIMD_SPMV
+
+// An array is usable by the kernels if it is contiguous host storage of
+// the expected element type
+template <typename ArrayType, typename T>
+struct is_simd_array
+  : thrust::detail::integral_constant<bool,
+      thrust::detail::is_same<typename ArrayType::value_type, T>::value &&
+      thrust::detail::is_convertible<typename ArrayType::memory_space, cusp::host_memory>::value &&
+      thrust::detail::is_trivial_iterator<typename ArrayType::const_iterator>::value>
+{};
+
+template <typename MatrixType, typename ValueType, typename Format>
+struct is_simd_matrix : thrust::detail::false_type {};
+
+template <typename MatrixType, typename ValueType>
+struct is_simd_matrix<MatrixType,ValueType,cusp::csr_format>
+  : thrust::detail::integral_constant<bool,
+      is_simd_array<typename MatrixType::row_offsets_array_type, int>::value &&
+      is_simd_array<typename MatrixType::column_indices_array_type, int>::value &&
+      is_simd_array<typename MatrixType::values_array_type, ValueType>::value>
+{};
+
+template <typename MatrixType, typename ValueType>
+struct is_simd_matrix<MatrixType,ValueType,cusp::ell_format>
+  : thrust::detail::integral_constant<bool,
+      is_simd_array<typename MatrixType::column_indices_array_type::values_array_type, int>::value &&
+      is_simd_array<typename MatrixType::values_array_type::values_array_type, ValueType>::value &&
+      thrust::detail::is_same<typename MatrixType::column_indices_array_type::orientation, cusp::column_major>::value &&
+      thrust::detail::is_same<typename MatrixType::values_array_type::orientation, cusp::column_major>::value>
+{};
+
+template <typename MatrixType, typename ValueType>
+struct is_simd_matrix<MatrixType,ValueType,cusp::sell_format>
+  : thrust::detail::integral_constant<bool,
+      is_simd_array<typename MatrixType::slice_offsets_array_type, int>::value &&
+      is_simd_array<typename MatrixType::column_indices_array_type, int>::value &&
+      is_simd_array<typename MatrixType::values_array_type, ValueType>::value &&
+      is_simd_array<typename MatrixType::row_permutation_array_type, int>::value>
+{};
+
+// The kernels evaluate y = A * x (+ constant), i.e. only the default
+// operators of multiply on float and double values with int indices.
+template <typename MatrixType, typename VectorType1, typename VectorType2,
+          typename ValueType, typename Format>
+struct is_simd_spmv
+  : thrust::detail::integral_constant<bool,
+      CUSP_SIMD_SPMV &&
+      (thrust::detail::is_same<ValueType, float>::value ||
+       thrust::detail::is_same<ValueType, double>::value) &&
+      thrust::detail::is_same<typename MatrixType::index_type, int>::value &&
+      is_simd_matrix<MatrixType, ValueType, Format>::value &&
+      is_simd_array<VectorType1, ValueType>::value &&
+      is_simd_array<VectorType2, ValueType>::value>
+{};
+
+template <typename T>
+T* simd_pointer(T& ref)
+{
+    return &ref;
+}
+
+template <typename MatrixType, typename VectorType1, typename VectorType2,
+          typename ValueType, typename Format>
+bool spmv(const MatrixType& A, const VectorType1& x, VectorType2& y,
+          const ValueType initial_value, Format, thrust::detail::false_type)
+{
+    return false;
+}
+
+#if CUSP_SIMD_SPMV
+
+template <typename MatrixType, typename VectorType1, typename VectorType2, typename ValueType>
+bool spmv(const MatrixType& A, const VectorType1& x, VectorType2& y,
+          const ValueType initial_value, cusp::csr_format, thrust::detail::true_type)
+{
+    const simd_level level = get_simd_level();
+
+    if(level == SIMD_NONE || A.num_entries == 0)
+        return false;
+
+    const int*       Ap = simd_pointer(A.row_offsets[0]);
+    const int*       Aj = simd_pointer(A.column_indices[0]);
+    const ValueType* Ax = simd_pointer(A.values[0]);
+    const ValueType* xp = simd_pointer(x[0]);
+    ValueType*       yp = simd_pointer(y[0]);
+
+    if(level == SIMD_AVX512)
+        csr_spmv_avx512<ValueType>(A.num_rows, Ap, Aj, Ax, xp, yp, initial_value);
+    else
+        csr_spmv_avx2<ValueType>(A.num_rows, Ap, Aj, Ax, xp, yp, initial_value);
+
+    return true;
+}
+
+template <typename MatrixType, typename VectorType1, typename VectorType2, typename ValueType>
+bool spmv(const MatrixType& A, const VectorType1& x, VectorType2& y,
+          const ValueType initial_value, cusp::ell_format, thrust::detail::true_type)
+{
+    const simd_level level = get_simd_level();
+
+    if(level == SIMD_NONE || A.column_indices.num_cols == 0)
+        return false;
+
+    const int*       Aj = simd_pointer(A.column_indices.values[0]);
+    const ValueType* Ax = simd_pointer(A.values.values[0]);
+    const ValueType* xp = simd_pointer(x[0]);
+    ValueType*       yp = simd_pointer(y[0]);
+
+    if(level == SIMD_AVX512)
+        ell_spmv_avx512<ValueType>(A.num_rows, A.column_indices.num_cols,
+                                   Aj, A.column_indices.pitch, Ax, A.values.pitch,
+                                   xp, yp, initial_value);
+    else
+        ell_spmv_avx2<ValueType>(A.num_rows, A.column_indices.num_cols,
+                                 Aj, A.column_indices.pitch, Ax, A.values.pitch,
+                                 xp, yp, initial_value);
+
+    return true;
+}
+
+template <typename MatrixType, typename VectorType1, typename VectorType2, typename ValueType>
+bool spmv(const MatrixType& A, const VectorType1& x, VectorType2& y,
+          const ValueType initial_value, cusp::sell_format, thrust::detail::true_type)
+{
+    const simd_level level = get_simd_level();
+
+    if(level == SIMD_NONE || A.values.size() == 0)
+        return false;
+
+    const int*       As = simd_pointer(A.slice_offsets[0]);
+    const int*       Aj = simd_pointer(A.column_indices[0]);
+    const ValueType* Ax = simd_pointer(A.values[0]);
+    const int*       Ap = simd_pointer(A.row_permutation[0]);
+    const ValueType* xp = simd_pointer(x[0]);
+    ValueType*       yp = simd_pointer(y[0]);
+
+    if(level == SIMD_AVX512)
+        sell_spmv_avx512<ValueType>(A.num_rows, A.num_slices(), A.slice_size,
+                                    As, Aj, Ax, Ap, xp, yp, initial_value);
+    else
+        sell_spmv_avx2<ValueType>(A.num_rows, A.num_slices(), A.slice_size,
+                                  As, Aj, Ax, Ap, xp, yp, initial_value);
+
+    return true;
+}
+
+#endif // CUSP_SIMD_SPMV
+
+// Returns false if the operators, types or storage are not supported by
+// the vectorized kernels, in which case the caller runs the scalar kernel.
+template <typename MatrixType, typename VectorType1, typename VectorType2,
+          typename UnaryFunction, typename BinaryFunction1, typename BinaryFunction2,
+          typename Format>
+bool spmv(const MatrixType& A, const VectorType1& x, VectorType2& y,
+          UnaryFunction initialize, BinaryFunction1 combine, BinaryFunction2 reduce,
+          Format format)
+{
+    return false;
+}
+
+template <typename MatrixType, typename VectorType1, typename VectorType2,
+          typename ValueType, typename Format>
+bool spmv(const MatrixType& A, const VectorType1& x, VectorType2& y,
+          cusp::constant_functor<ValueType> initialize,
+          thrust::multiplies<ValueType> combine,
+          thrust::plus<ValueType> reduce,
+          Format format)
+{
+    typedef typename is_simd_spmv<MatrixType,VectorType1,VectorType2,ValueType,Format>::type supported;
+
+    if(A.num_rows == 0 || A.num_cols == 0)
+        return false;
+
+    return simd::spmv(A, x, y, initialize(ValueType(0)), format, supported());
+}
+
+} // end namespace simd
+} // end namespace sequential
+} // end namespace detail
+} // end namespace system
+} // end namespace cusp
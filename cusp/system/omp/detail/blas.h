@@ -19,9 +19,24 @@
 
 #include <cusp/detail/config.h>
 
+#include <cusp/detail/array2d_format_utils.h>
+#include <cusp/detail/temporary_array.h>
+
+#include <cusp/system/detail/generic/blas.h>
+
+#include <cusp/system/omp/detail/execution_policy.h>
+
 // this system inherits blas routines
 #include <cusp/system/cpp/detail/blas.h>
 
+#include <thrust/copy.h>
+#include <thrust/fill.h>
+#include <thrust/functional.h>
+
+#include <algorithm>
+
+#include <omp.h>
+
 namespace cusp
 {
 namespace system
@@ -31,6 +46,94 @@ namespace omp
 namespace detail
 {
     using cusp::system::detail::sequential::gemm;
+
+// The rows are split into one contiguous chunk per thread and every chunk
+// accumulates its own sums for all columns of Y, so x is read once.  The
+// chunk sums are combined in chunk order, which keeps the results
+// independent of thread scheduling.
+template <typename DerivedPolicy,
+          typename Array1,
+          typename Array2d,
+          typename Array2,
+          typename UnaryFunction>
+void __dots(omp::execution_policy<DerivedPolicy>& exec,
+            const Array1& x,
+            const Array2d& Y,
+                  Array2& results,
+            UnaryFunction op)
+{
+    typedef typename Array2::value_type   ValueType;
+    typedef typename Array2d::orientation Orientation;
+
+    if(x.size() != Y.num_rows)
+        throw cusp::invalid_input_exception("array dimensions do not match");
+
+    const size_t num_rows = Y.num_rows;
+    const size_t num_cols = Y.num_cols;
+    const size_t pitch    = Y.pitch;
+
+    results.resize(num_cols);
+
+    if(num_cols == 0)
+        return;
+
+    const int num_chunks = std::max(1, std::min(omp_get_max_threads(), int(num_rows)));
+
+    cusp::detail::temporary_array<ValueType, DerivedPolicy> partials(exec, num_chunks * num_cols, ValueType(0));
+
+    ValueType * partial_sums = thrust::raw_pointer_cast(&partials[0]);
+
+    #pragma omp parallel for schedule(static, 1)
+    for(int chunk = 0; chunk < num_chunks; chunk++)
+    {
+        const size_t row_start = (num_rows * chunk) / num_chunks;
+        const size_t row_end   = (num_rows * (chunk + 1)) / num_chunks;
+
+        ValueType * sums = partial_sums + chunk * num_cols;
+
+        for(size_t i = row_start; i < row_end; i++)
+        {
+            const ValueType xi = op(ValueType(x[i]));
+
+            for(size_t j = 0; j < num_cols; j++)
+                sums[j] += xi * ValueType(Y.values[cusp::detail::index_of(i, j, pitch, Orientation())]);
+        }
+    }
+
+    for(int chunk = 1; chunk < num_chunks; chunk++)
+        for(size_t j = 0; j < num_cols; j++)
+            partial_sums[j] += partial_sums[chunk * num_cols + j];
+
+    thrust::copy(partials.begin(), partials.begin() + num_cols, results.begin());
+}
+
+template <typename DerivedPolicy,
+          typename Array1,
+          typename Array2d,
+          typename Array2>
+void dots(omp::execution_policy<DerivedPolicy>& exec,
+          const Array1& x,
+          const Array2d& Y,
+                Array2& results)
+{
+    typedef typename Array2::value_type ValueType;
+
+    __dots(exec, x, Y, results, thrust::identity<ValueType>());
+}
+
+template <typename DerivedPolicy,
+          typename Array1,
+          typename Array2d,
+          typename Array2>
+void dotcs(omp::execution_policy<DerivedPolicy>& exec,
+           const Array1& x,
+           const Array2d& Y,
+                 Array2& results)
+{
+    typedef typename Array2::value_type ValueType;
+
+    __dots(exec, x, Y, results, cusp::conj_functor<ValueType>());
+}
 } // end namespace detail
 } // end namespace omp
 } // end namespace system
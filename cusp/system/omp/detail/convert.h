@@ -17,5 +17,263 @@
 #pragma once
 
 #include <cusp/detail/config.h>
+#include <cusp/detail/format.h>
+#include <cusp/detail/temporary_array.h>
 
-// this system has no special version of this algorithm
+#include <cusp/exception.h>
+#include <cusp/format_utils.h>
+
+#include <cusp/system/omp/detail/execution_policy.h>
+#include <cusp/system/omp/detail/format_utils.h>
+
+#include <thrust/count.h>
+
+#include <algorithm>
+#include <vector>
+
+#include <omp.h>
+
+namespace cusp
+{
+namespace system
+{
+namespace omp
+{
+namespace detail
+{
+
+// Direct CSR conversions: every row is converted by one thread in a
+// single pass that writes its padding together with its entries, instead
+// of the expansion to row indices, segmented scan, fill and scatter
+// passes of the generic versions.  The fill-in limits are those of the
+// generic versions.
+
+template <typename DerivedPolicy, typename SourceType, typename DestinationType>
+void
+convert(omp::execution_policy<DerivedPolicy>& exec,
+        const SourceType& src,
+        DestinationType& dst,
+        cusp::csr_format&,
+        cusp::dia_format&,
+        size_t alignment = 32)
+{
+    typedef typename DestinationType::index_type   IndexType;
+    typedef typename DestinationType::value_type   ValueType;
+
+    const long num_rows = src.num_rows;
+    const long num_cols = src.num_cols;
+
+    if(src.num_entries == 0)
+    {
+        dst.resize(src.num_rows, src.num_cols, src.num_entries, 0);
+        return;
+    }
+
+    // diagonal d holds the entries with column - row == d - num_rows
+    std::vector<IndexType> diagonal_map(num_rows + num_cols, 0);
+
+    #pragma omp parallel for schedule(dynamic, 256)
+    for(long i = 0; i < num_rows; i++)
+    {
+        const size_t row_start = src.row_offsets[i];
+        const size_t row_end   = src.row_offsets[i + 1];
+
+        for(size_t jj = row_start; jj < row_end; jj++)
+        {
+            IndexType& occupied = diagonal_map[long(src.column_indices[jj]) - i + num_rows];
+
+            #pragma omp atomic write
+            occupied = 1;
+        }
+    }
+
+    // enumerate the occupied diagonals
+    std::vector<IndexType> diagonal_offsets;
+
+    for(long d = 0; d < num_rows + num_cols; d++)
+    {
+        if(diagonal_map[d])
+        {
+            diagonal_map[d] = diagonal_offsets.size();
+            diagonal_offsets.push_back(IndexType(d - num_rows));
+        }
+    }
+
+    const IndexType num_diagonals = diagonal_offsets.size();
+
+    const float max_fill   = 3.0;
+    const float threshold  = 1e6; // 1M entries
+    const float size       = float(num_diagonals) * float(src.num_rows);
+    const float fill_ratio = size / std::max(1.0f, float(src.num_entries));
+
+    if (max_fill < fill_ratio && size > threshold)
+        throw cusp::format_conversion_exception("dia_matrix fill-in would exceed maximum tolerance");
+
+    dst.resize(src.num_rows, src.num_cols, src.num_entries, num_diagonals, alignment);
+
+    for(IndexType n = 0; n < num_diagonals; n++)
+        dst.diagonal_offsets[n] = diagonal_offsets[n];
+
+    #pragma omp parallel for schedule(dynamic, 256)
+    for(long i = 0; i < num_rows; i++)
+    {
+        for(IndexType n = 0; n < num_diagonals; n++)
+            dst.values(i, n) = ValueType(0);
+
+        const size_t row_start = src.row_offsets[i];
+        const size_t row_end   = src.row_offsets[i + 1];
+
+        for(size_t jj = row_start; jj < row_end; jj++)
+            dst.values(i, diagonal_map[long(src.column_indices[jj]) - i + num_rows]) = src.values[jj];
+    }
+}
+
+template <typename DerivedPolicy, typename SourceType, typename DestinationType>
+void
+convert(omp::execution_policy<DerivedPolicy>& exec,
+        const SourceType& src,
+        DestinationType& dst,
+        cusp::csr_format&,
+        cusp::ell_format&,
+        size_t num_entries_per_row = 0,
+        size_t alignment = 32)
+{
+    typedef typename DestinationType::index_type   IndexType;
+    typedef typename DestinationType::value_type   ValueType;
+
+    const long num_rows = src.num_rows;
+
+    if(src.num_entries == 0)
+    {
+        dst.resize(src.num_rows, src.num_cols, src.num_entries, num_entries_per_row);
+        return;
+    }
+
+    if(num_entries_per_row == 0)
+    {
+        const size_t max_entries_per_row = cusp::compute_max_entries_per_row(exec, src.row_offsets);
+
+        const float max_fill  = 3.0;
+        const float threshold  = 1e6; // 1M entries
+        const float size       = float(max_entries_per_row) * float(src.num_rows);
+        const float fill_ratio = size / std::max(1.0f, float(src.num_entries));
+
+        if (max_fill < fill_ratio && size > threshold)
+            throw cusp::format_conversion_exception("ell_matrix fill-in would exceed maximum tolerance");
+
+        num_entries_per_row = max_entries_per_row;
+    }
+
+    const size_t K = num_entries_per_row;
+
+    size_t num_entries = src.num_entries - thrust::count(exec, src.values.begin(), src.values.end(), ValueType(0));
+
+    dst.resize(src.num_rows, src.num_cols, num_entries, K, alignment);
+
+    #pragma omp parallel for schedule(dynamic, 256)
+    for(long i = 0; i < num_rows; i++)
+    {
+        const size_t row_start = src.row_offsets[i];
+        const size_t row_end   = std::min<size_t>(src.row_offsets[i + 1], row_start + K);
+
+        size_t n = 0;
+
+        for(size_t jj = row_start; jj < row_end; jj++, n++)
+        {
+            dst.column_indices(i, n) = src.column_indices[jj];
+            dst.values(i, n)         = src.values[jj];
+        }
+
+        for(; n < K; n++)
+        {
+            dst.column_indices(i, n) = IndexType(-1);
+            dst.values(i, n)         = ValueType(0);
+        }
+    }
+}
+
+template <typename DerivedPolicy, typename SourceType, typename DestinationType>
+void
+convert(omp::execution_policy<DerivedPolicy>& exec,
+        const SourceType& src,
+        DestinationType& dst,
+        cusp::csr_format&,
+        cusp::hyb_format&,
+        size_t num_entries_per_row = 0,
+        size_t alignment = 32)
+{
+    typedef typename DestinationType::index_type   IndexType;
+    typedef typename DestinationType::value_type   ValueType;
+
+    const long num_rows = src.num_rows;
+
+    if(src.num_entries == 0)
+    {
+        dst.resize(src.num_rows, src.num_cols, 0, 0, num_entries_per_row);
+        return;
+    }
+
+    if(num_entries_per_row == 0)
+    {
+        const float  relative_speed      = 3.0;
+        const size_t breakeven_threshold = 4096;
+
+        num_entries_per_row = cusp::compute_optimal_entries_per_row(exec, src.row_offsets, relative_speed, breakeven_threshold);
+    }
+
+    const size_t K = num_entries_per_row;
+
+    // entries past the first K of a row go to the COO part in row order
+    cusp::detail::temporary_array<size_t, DerivedPolicy> coo_offsets(exec, num_rows + 1);
+
+    #pragma omp parallel for
+    for(long i = 0; i < num_rows; i++)
+    {
+        const size_t row_length = src.row_offsets[i + 1] - src.row_offsets[i];
+        coo_offsets[i + 1] = row_length > K ? row_length - K : 0;
+    }
+
+    coo_offsets[0] = 0;
+
+    for(long i = 0; i < num_rows; i++)
+        coo_offsets[i + 1] += coo_offsets[i];
+
+    const size_t num_coo_entries = coo_offsets[num_rows];
+    const size_t num_ell_entries = src.num_entries - num_coo_entries;
+
+    dst.resize(src.num_rows, src.num_cols, num_ell_entries, num_coo_entries, K, alignment);
+
+    #pragma omp parallel for schedule(dynamic, 256)
+    for(long i = 0; i < num_rows; i++)
+    {
+        const size_t row_start = src.row_offsets[i];
+        const size_t row_end   = src.row_offsets[i + 1];
+        const size_t ell_end   = std::min(row_end, row_start + K);
+
+        size_t n = 0;
+
+        for(size_t jj = row_start; jj < ell_end; jj++, n++)
+        {
+            dst.ell.column_indices(i, n) = src.column_indices[jj];
+            dst.ell.values(i, n)         = src.values[jj];
+        }
+
+        for(; n < K; n++)
+        {
+            dst.ell.column_indices(i, n) = IndexType(-1);
+            dst.ell.values(i, n)         = ValueType(0);
+        }
+
+        for(size_t jj = ell_end, k = coo_offsets[i]; jj < row_end; jj++, k++)
+        {
+            dst.coo.row_indices[k]    = IndexType(i);
+            dst.coo.column_indices[k] = src.column_indices[jj];
+            dst.coo.values[k]         = src.values[jj];
+        }
+    }
+}
+
+} // end namespace detail
+} // end namespace omp
+} // end namespace system
+} // end namespace cusp
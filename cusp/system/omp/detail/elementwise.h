@@ -18,6 +18,7 @@
 #include <cusp/detail/format.h>
 #include <cusp/detail/temporary_array.h>
 
+#include <thrust/extrema.h>
 #include <thrust/scan.h>
 #include <cusp/system/cpp/detail/elementwise.h>
 
@@ -35,18 +36,12 @@ template <typename DerivedPolicy,
           typename MatrixType2,
           typename MatrixType3,
           typename BinaryFunction>
-void elementwise(omp::execution_policy<DerivedPolicy>& exec,
-                 const MatrixType1& A,
-                 const MatrixType2& B,
-                 MatrixType3& C,
-                 BinaryFunction op,
-                 cusp::csr_format,
-                 cusp::csr_format,
-                 cusp::csr_format)
+void csr_elementwise_accumulate(omp::execution_policy<DerivedPolicy>& exec,
+                                const MatrixType1& A,
+                                const MatrixType2& B,
+                                MatrixType3& C,
+                                BinaryFunction op)
 {
-    if(A.num_rows != B.num_rows || A.num_cols != B.num_cols)
-        throw cusp::invalid_input_exception("matrix dimensions do not match");
-
     //Method that works for duplicate and/or unsorted indices
     typedef typename MatrixType3::index_type IndexType;
     typedef typename MatrixType3::value_type ValueType;
@@ -162,6 +157,129 @@ void elementwise(omp::execution_policy<DerivedPolicy>& exec,
     cusp::copy(exec, C_values, C.values);
 } // csr_transform_elementwise
 
+// true if the column indices of row i are strictly increasing
+template <typename MatrixType>
+bool csr_row_is_sorted(const MatrixType& A, const size_t i)
+{
+    typedef typename MatrixType::index_type IndexType;
+
+    for(IndexType jj = A.row_offsets[i] + 1; jj < A.row_offsets[i + 1]; jj++)
+        if(A.column_indices[jj - 1] >= A.column_indices[jj])
+            return false;
+
+    return true;
+}
+
+template <typename DerivedPolicy,
+          typename MatrixType1,
+          typename MatrixType2,
+          typename MatrixType3,
+          typename BinaryFunction>
+void elementwise(omp::execution_policy<DerivedPolicy>& exec,
+                 const MatrixType1& A,
+                 const MatrixType2& B,
+                 MatrixType3& C,
+                 BinaryFunction op,
+                 cusp::csr_format,
+                 cusp::csr_format,
+                 cusp::csr_format)
+{
+    typedef typename MatrixType3::index_type  IndexType;
+    typedef typename MatrixType3::value_type  ValueType;
+    typedef typename MatrixType1::value_type  ValueType1;
+    typedef typename MatrixType2::value_type  ValueType2;
+
+    if(A.num_rows != B.num_rows || A.num_cols != B.num_cols)
+        throw cusp::invalid_input_exception("matrix dimensions do not match");
+
+    // count the union of every pair of rows with a merge, rows with
+    // unsorted or duplicate column indices are accumulated instead
+    cusp::detail::temporary_array<IndexType, DerivedPolicy> C_row_offsets(exec, A.num_rows + 1);
+
+    C_row_offsets[0] = 0;
+
+    int num_unsorted_rows = 0;
+
+    #pragma omp parallel for reduction(+:num_unsorted_rows)
+    for(int i = 0; i < int(A.num_rows); i++)
+    {
+        if(!csr_row_is_sorted(A, i) || !csr_row_is_sorted(B, i))
+        {
+            num_unsorted_rows++;
+            continue;
+        }
+
+        IndexType A_pos = A.row_offsets[i];
+        IndexType A_end = A.row_offsets[i + 1];
+        IndexType B_pos = B.row_offsets[i];
+        IndexType B_end = B.row_offsets[i + 1];
+        IndexType count = 0;
+
+        while(A_pos < A_end && B_pos < B_end)
+        {
+            IndexType A_j = A.column_indices[A_pos];
+            IndexType B_j = B.column_indices[B_pos];
+
+            if(A_j <= B_j) A_pos++;
+            if(B_j <= A_j) B_pos++;
+
+            count++;
+        }
+
+        C_row_offsets[i + 1] = count + (A_end - A_pos) + (B_end - B_pos);
+    }
+
+    if(num_unsorted_rows > 0)
+    {
+        csr_elementwise_accumulate(exec, A, B, C, op);
+        return;
+    }
+
+    thrust::inclusive_scan(exec, C_row_offsets.begin(), C_row_offsets.end(), C_row_offsets.begin());
+
+    size_t num_entries_in_C = C_row_offsets[A.num_rows];
+
+    // C may alias A or B
+    cusp::detail::temporary_array<IndexType, DerivedPolicy> C_column_indices(exec, num_entries_in_C);
+    cusp::detail::temporary_array<ValueType, DerivedPolicy> C_values(exec, num_entries_in_C);
+
+    #pragma omp parallel for
+    for(int i = 0; i < int(A.num_rows); i++)
+    {
+        IndexType A_pos = A.row_offsets[i];
+        IndexType A_end = A.row_offsets[i + 1];
+        IndexType B_pos = B.row_offsets[i];
+        IndexType B_end = B.row_offsets[i + 1];
+        IndexType C_pos = C_row_offsets[i];
+
+        while(A_pos < A_end || B_pos < B_end)
+        {
+            IndexType A_j = A_pos < A_end ? IndexType(A.column_indices[A_pos]) : IndexType(A.num_cols);
+            IndexType B_j = B_pos < B_end ? IndexType(B.column_indices[B_pos]) : IndexType(A.num_cols);
+
+            ValueType1 a = ValueType1(0);
+            ValueType2 b = ValueType2(0);
+
+            if(A_j <= B_j) a = A.values[A_pos];
+            if(B_j <= A_j) b = B.values[B_pos];
+
+            C_column_indices[C_pos] = thrust::min(A_j, B_j);
+            C_values[C_pos]         = op(a, b);
+
+            if(A_j <= B_j) A_pos++;
+            if(B_j <= A_j) B_pos++;
+
+            C_pos++;
+        }
+    }
+
+    C.resize(A.num_rows, A.num_cols, num_entries_in_C);
+
+    cusp::copy(exec, C_row_offsets, C.row_offsets);
+    cusp::copy(exec, C_column_indices, C.column_indices);
+    cusp::copy(exec, C_values, C.values);
+}
+
 } // end namespace detail
 } // end namespace omp
 } // end namespace system
@@ -17,6 +17,14 @@
 #pragma once
 
 #include <cusp/detail/config.h>
+#include <cusp/functional.h>
+
+#include <cusp/system/omp/detail/execution_policy.h>
+
+#include <algorithm>
+#include <vector>
+
+#include <omp.h>
 
 // this system inherits format_utils
 #include <cusp/system/cpp/detail/format_utils.h>
@@ -30,8 +38,126 @@ namespace omp
 namespace detail
 {
 
-using cusp::system::detail::sequential::offsets_to_indices;
-using cusp::system::detail::sequential::indices_to_offsets;
+template <typename DerivedPolicy,
+          typename OffsetArray,
+          typename IndexArray>
+void offsets_to_indices(omp::execution_policy<DerivedPolicy> &exec,
+                        const OffsetArray& offsets,
+                        IndexArray& indices)
+{
+    typedef typename IndexArray::value_type IndexType;
+
+    const long num_rows = long(offsets.size()) - 1;
+
+    #pragma omp parallel for schedule(dynamic, 1024)
+    for(long i = 0; i < num_rows; i++)
+    {
+        const size_t row_start = offsets[i];
+        const size_t row_end   = offsets[i + 1];
+
+        for(size_t j = row_start; j < row_end; j++)
+            indices[j] = IndexType(i);
+    }
+}
+
+// the indices are sorted, so every offset between two consecutive
+// indices is the position of the second one
+template <typename DerivedPolicy,
+          typename IndexArray,
+          typename OffsetArray>
+void indices_to_offsets(omp::execution_policy<DerivedPolicy> &exec,
+                        const IndexArray& indices,
+                        OffsetArray& offsets)
+{
+    typedef typename OffsetArray::value_type OffsetType;
+
+    const long   num_entries = indices.size();
+    const size_t num_offsets = offsets.size();
+
+    if(num_entries == 0)
+    {
+        #pragma omp parallel for
+        for(long i = 0; i < long(num_offsets); i++)
+            offsets[i] = 0;
+
+        return;
+    }
+
+    for(size_t i = 0; i <= size_t(indices[0]); i++)
+        offsets[i] = 0;
+
+    #pragma omp parallel for
+    for(long n = 1; n < num_entries; n++)
+        for(size_t i = size_t(indices[n - 1]) + 1; i <= size_t(indices[n]); i++)
+            offsets[i] = OffsetType(n);
+
+    for(size_t i = size_t(indices[num_entries - 1]) + 1; i < num_offsets; i++)
+        offsets[i] = OffsetType(num_entries);
+}
+
+template <typename DerivedPolicy, typename ArrayType>
+size_t compute_max_entries_per_row(omp::execution_policy<DerivedPolicy> &exec,
+                                   const ArrayType& row_offsets)
+{
+    const long num_rows = long(row_offsets.size()) - 1;
+
+    size_t max_entries_per_row = 0;
+
+    #pragma omp parallel
+    {
+        size_t local_max = 0;
+
+        #pragma omp for nowait
+        for(long i = 0; i < num_rows; i++)
+            local_max = std::max<size_t>(local_max, row_offsets[i + 1] - row_offsets[i]);
+
+        #pragma omp critical
+        max_entries_per_row = std::max(max_entries_per_row, local_max);
+    }
+
+    return max_entries_per_row;
+}
+
+// Row lengths are counted in one histogram per thread, which replaces
+// the sort of the row lengths made by the generic version.
+template <typename DerivedPolicy, typename ArrayType>
+size_t compute_optimal_entries_per_row(omp::execution_policy<DerivedPolicy> &exec,
+                                       const ArrayType& row_offsets,
+                                       float relative_speed,
+                                       size_t breakeven_threshold)
+{
+    const long   num_rows         = long(row_offsets.size()) - 1;
+    const size_t max_cols_per_row = compute_max_entries_per_row(exec, row_offsets);
+    const size_t num_bins         = max_cols_per_row + 1;
+    const int    num_threads      = omp_get_max_threads();
+
+    std::vector<size_t> histograms(num_threads * num_bins, 0);
+
+    #pragma omp parallel num_threads(num_threads)
+    {
+        size_t * histogram = &histograms[omp_get_thread_num() * num_bins];
+
+        #pragma omp for
+        for(long i = 0; i < num_rows; i++)
+            histogram[row_offsets[i + 1] - row_offsets[i]]++;
+    }
+
+    // number of rows with at most k entries
+    cusp::detail::speed_threshold_functor threshold(num_rows, relative_speed, breakeven_threshold);
+
+    size_t cumulative = 0;
+
+    for(size_t k = 0; k < max_cols_per_row; k++)
+    {
+        for(int t = 0; t < num_threads; t++)
+            cumulative += histograms[t * num_bins + k];
+
+        if(threshold(cumulative))
+            return k;
+    }
+
+    return max_cols_per_row;
+}
 
 } // end namespace detail
 } // end namespace omp
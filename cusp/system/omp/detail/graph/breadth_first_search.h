@@ -17,7 +17,10 @@
 #pragma once
 
 #include <cusp/detail/config.h>
-#include <cusp/system/cpp/detail/graph/breadth_first_search.h>
+#include <cusp/detail/format.h>
+
+#include <cusp/system/omp/detail/execution_policy.h>
+#include <cusp/system/detail/generic/graph/direction_optimizing_bfs.h>
 
 namespace cusp
 {
@@ -28,7 +31,16 @@ namespace omp
 namespace detail
 {
 
-using cusp::system::detail::sequential::breadth_first_search;
+template<typename DerivedPolicy, typename MatrixType, typename ArrayType>
+void breadth_first_search(omp::execution_policy<DerivedPolicy>& exec,
+                          const MatrixType& G,
+                          const typename MatrixType::index_type src,
+                          ArrayType& labels,
+                          const bool mark_levels,
+                          cusp::csr_format)
+{
+    cusp::system::detail::generic::direction_optimizing_bfs(exec, G, src, labels, mark_levels);
+}
 
 } // end namespace detail
 } // end namespace omp
@@ -18,9 +18,19 @@
 
 #include <cusp/detail/config.h>
 
+#include <cusp/system/omp/detail/multiply/array2d_mm.h>
+#include <cusp/system/omp/detail/multiply/bsr_spmv.h>
+#include <cusp/system/omp/detail/multiply/csr_block_spmv.h>
 #include <cusp/system/omp/detail/multiply/csr_spmv.h>
+#include <cusp/system/omp/detail/multiply/csr_spmv_dotc.h>
+#include <cusp/system/omp/detail/multiply/dcsr_spmv.h>
+#include <cusp/system/omp/detail/multiply/dynamic_csr_spmv.h>
+#include <cusp/system/omp/detail/multiply/sell_spmv.h>
+#include <cusp/system/omp/detail/multiply/symmetric_spmv.h>
+#include <cusp/system/omp/detail/multiply/transpose_spmv.h>
 #include <cusp/system/omp/detail/multiply/coo_spgemm.h>
 #include <cusp/system/omp/detail/multiply/csr_spgemm.h>
+#include <cusp/system/omp/detail/multiply/galerkin_product.h>
 
 // this system inherits multiply
 #include <cusp/system/cpp/detail/multiply.h>
@@ -0,0 +1,86 @@
+/*
+ *  Copyright 2008-2013 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#pragma once
+
+#include <cusp/detail/config.h>
+#include <cusp/detail/format.h>
+
+#include <cusp/system/omp/detail/execution_policy.h>
+#include <cusp/system/detail/sequential/multiply/array2d_mm.h>
+
+#include <algorithm>
+
+#include <omp.h>
+
+namespace cusp
+{
+namespace system
+{
+namespace omp
+{
+namespace detail
+{
+
+// Dense C = A * B split into the MC x NC tiles of the sequential blocked
+// product.  Tiles of C are disjoint and each one reduces over the whole
+// inner dimension, so the result matches the sequential product exactly.
+// A product with a single tile of C runs on one thread.
+template <typename DerivedPolicy,
+          typename MatrixType1,
+          typename MatrixType2,
+          typename MatrixType3,
+          typename UnaryFunction,
+          typename BinaryFunction1,
+          typename BinaryFunction2>
+void multiply(omp::execution_policy<DerivedPolicy>& exec,
+              const MatrixType1& A,
+              const MatrixType2& B,
+              MatrixType3& C,
+              UnaryFunction   initialize,
+              BinaryFunction1 combine,
+              BinaryFunction2 reduce,
+              cusp::array2d_format,
+              cusp::array2d_format,
+              cusp::array2d_format)
+{
+    typedef cusp::system::detail::sequential::array2d_mm_blocking Blocking;
+
+    C.resize(A.num_rows, B.num_cols);
+
+    const size_t num_row_tiles = (C.num_rows + Blocking::MC - 1) / Blocking::MC;
+    const size_t num_col_tiles = (C.num_cols + Blocking::NC - 1) / Blocking::NC;
+    const int    num_tiles     = num_row_tiles * num_col_tiles;
+
+    #pragma omp parallel for schedule(dynamic)
+    for(int t = 0; t < num_tiles; t++)
+    {
+        const size_t row_begin = (t % num_row_tiles) * Blocking::MC;
+        const size_t col_begin = (t / num_row_tiles) * Blocking::NC;
+        const size_t row_end   = std::min<size_t>(C.num_rows, row_begin + Blocking::MC);
+        const size_t col_end   = std::min<size_t>(C.num_cols, col_begin + Blocking::NC);
+
+        cusp::system::detail::sequential::array2d_mm_tile(A, B, C,
+                                                          row_begin, row_end,
+                                                          col_begin, col_end,
+                                                          initialize, combine, reduce);
+    }
+}
+
+} // end namespace detail
+} // end namespace omp
+} // end namespace system
+} // end namespace cusp
@@ -0,0 +1,99 @@
+/*
+ *  Copyright 2008-2013 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#pragma once
+
+#include <cusp/detail/config.h>
+#include <cusp/detail/format.h>
+#include <cusp/detail/array2d_format_utils.h>
+
+#include <cusp/system/omp/detail/execution_policy.h>
+
+namespace cusp
+{
+namespace system
+{
+namespace omp
+{
+namespace detail
+{
+
+// Multiplies a CSR matrix by a dense matrix with k columns.  The rows of
+// A are distributed among the threads and each row is accumulated directly
+// into the corresponding row of y, so every entry of A is read only once
+// regardless of k.  Both row-major and column-major operands are supported.
+template <typename DerivedPolicy,
+          typename MatrixType,
+          typename VectorType1,
+          typename VectorType2,
+          typename UnaryFunction,
+          typename BinaryFunction1,
+          typename BinaryFunction2>
+void multiply(omp::execution_policy<DerivedPolicy>& exec,
+              const MatrixType& A,
+              const VectorType1& x,
+              VectorType2& y,
+              UnaryFunction   initialize,
+              BinaryFunction1 combine,
+              BinaryFunction2 reduce,
+              cusp::csr_format,
+              cusp::array2d_format,
+              cusp::array2d_format)
+{
+    typedef typename MatrixType::index_type                     IndexType;
+    typedef typename VectorType2::values_array_type::value_type ValueType;
+
+    typedef typename VectorType1::orientation                   Orientation1;
+    typedef typename VectorType2::orientation                   Orientation2;
+
+    const int N = A.num_rows;
+    const int K = x.num_cols;
+
+    const size_t x_pitch = x.pitch;
+    const size_t y_pitch = y.pitch;
+
+    #pragma omp parallel for schedule(dynamic, 64)
+    for(int i = 0; i < N; i++)
+    {
+        const IndexType row_start = A.row_offsets[i];
+        const IndexType row_end   = A.row_offsets[i + 1];
+
+        for(int k = 0; k < K; k++)
+        {
+            const size_t yk = cusp::detail::index_of(size_t(i), size_t(k), y_pitch, Orientation2());
+            y.values[yk] = initialize(y.values[yk]);
+        }
+
+        for(IndexType jj = row_start; jj < row_end; jj++)
+        {
+            const IndexType j   = A.column_indices[jj];
+            const ValueType Aij = A.values[jj];
+
+            for(int k = 0; k < K; k++)
+            {
+                const size_t xk = cusp::detail::index_of(size_t(j), size_t(k), x_pitch, Orientation1());
+                const size_t yk = cusp::detail::index_of(size_t(i), size_t(k), y_pitch, Orientation2());
+
+                y.values[yk] = reduce(y.values[yk], combine(Aij, x.values[xk]));
+            }
+        }
+    }
+}
+
+} // end namespace detail
+} // end namespace omp
+} // end namespace system
+} // end namespace cusp
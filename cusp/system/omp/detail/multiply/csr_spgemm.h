@@ -16,12 +16,18 @@
 #pragma once
 
 #include <cusp/array1d.h>
+#include <cusp/exception.h>
 
 #include <cusp/detail/temporary_array.h>
 
+#include <thrust/fill.h>
+
+#include <algorithm>
 #include <iostream>
 #include <list>
 
+#include <omp.h>
+
 namespace cusp
 {
 namespace system
@@ -31,6 +37,244 @@ namespace omp
 namespace detail
 {
 
+// The rows of C are split into one contiguous chunk per thread such that
+// every chunk performs roughly the same number of products A(i,j) * B(j,k).
+// Each chunk accumulates its rows in a private sparse accumulator, which is
+// a dense array over the columns of C or, when the longest row of the chunk
+// is short compared to the number of columns, an open addressing hash table
+// small enough to remain in cache. Both passes use the same partition and
+// the rows of C are written with sorted column indices, so no global sort
+// is required.
+// splits the rows into chunks of roughly equal numbers of products given
+// the number of products of every row in cumulative_products[1:], which is
+// scanned in place
+template <typename DerivedPolicy, typename Array1, typename Array2>
+void spmm_csr_chunks(omp::execution_policy<DerivedPolicy>& exec,
+                     const size_t num_rows,
+                     Array1& cumulative_products,
+                     Array2& chunk_offsets, Array2& chunk_max_products)
+{
+    const int num_chunks = chunk_offsets.size() - 1;
+
+    cumulative_products[0] = 0;
+
+    for(size_t i = 0; i < num_rows; i++)
+        cumulative_products[i + 1] += cumulative_products[i];
+
+    const size_t total_products = cumulative_products[num_rows];
+
+    chunk_offsets[0] = 0;
+
+    for(int c = 1; c < num_chunks; c++)
+    {
+        const size_t target = (total_products / num_chunks) * c + (total_products % num_chunks) * c / num_chunks;
+
+        const size_t * first = thrust::raw_pointer_cast(cumulative_products.data());
+
+        chunk_offsets[c] = std::max(size_t(chunk_offsets[c - 1]),
+                                    size_t(std::lower_bound(first, first + num_rows, target) - first));
+    }
+
+    chunk_offsets[num_chunks] = num_rows;
+
+    #pragma omp parallel for schedule(static, 1)
+    for(int c = 0; c < num_chunks; c++)
+    {
+        size_t max_products = 0;
+
+        for(size_t i = chunk_offsets[c]; i < chunk_offsets[c + 1]; i++)
+            max_products = std::max(max_products, size_t(cumulative_products[i + 1] - cumulative_products[i]));
+
+        chunk_max_products[c] = max_products;
+    }
+}
+
+template <typename DerivedPolicy,
+          typename Array1, typename Array2,
+          typename Array3, typename Array4>
+void spmm_csr_partition(omp::execution_policy<DerivedPolicy>& exec,
+                        const size_t num_rows,
+                        const Array1& A_row_offsets, const Array2& A_column_indices,
+                        const Array3& B_row_offsets,
+                        Array4& chunk_offsets, Array4& chunk_max_products)
+{
+    typedef typename Array1::value_type OffsetType1;
+    typedef typename Array2::value_type IndexType1;
+
+    // upper bound on the number of entries of each row of C
+    cusp::detail::temporary_array<size_t, DerivedPolicy> cumulative_products(exec, num_rows + 1);
+
+    #pragma omp parallel for schedule(static, 1024)
+    for(int i = 0; i < int(num_rows); i++)
+    {
+        size_t num_products = 0;
+
+        for(OffsetType1 jj = A_row_offsets[i]; jj < A_row_offsets[i + 1]; jj++)
+        {
+            IndexType1 j = A_column_indices[jj];
+            num_products += B_row_offsets[j + 1] - B_row_offsets[j];
+        }
+
+        cumulative_products[i + 1] = num_products;
+    }
+
+    spmm_csr_chunks(exec, num_rows, cumulative_products, chunk_offsets, chunk_max_products);
+}
+
+template <typename IndexType, typename ValueType, typename DerivedPolicy>
+class spmm_csr_accumulator
+{
+public:
+
+    spmm_csr_accumulator(omp::execution_policy<DerivedPolicy>& exec,
+                         const size_t num_cols, const size_t max_products)
+        : capacity(hash_capacity(max_products)),
+          dense(capacity >= num_cols),
+          length(0),
+          keys(exec, dense ? num_cols : capacity, unseen()),
+          sums(exec, dense ? num_cols : capacity, ValueType(0)),
+          slots(exec, std::min(num_cols, max_products)),
+          keys_ptr(thrust::raw_pointer_cast(keys.data())),
+          sums_ptr(thrust::raw_pointer_cast(sums.data())),
+          slots_ptr(thrust::raw_pointer_cast(slots.data()))
+    {}
+
+    size_t size(void) const
+    {
+        return length;
+    }
+
+    void insert(const IndexType k)
+    {
+        const size_t slot = find(k);
+
+        if(keys_ptr[slot] == unseen())
+        {
+            keys_ptr[slot] = k;
+            slots_ptr[length++] = slot;
+        }
+    }
+
+    template <typename BinaryFunction>
+    void insert(const IndexType k, const ValueType v, BinaryFunction reduce)
+    {
+        const size_t slot = find(k);
+
+        if(keys_ptr[slot] == unseen())
+        {
+            keys_ptr[slot] = k;
+            slots_ptr[length++] = slot;
+        }
+
+        sums_ptr[slot] = reduce(sums_ptr[slot], v);
+    }
+
+    // writes the accumulated entries in ascending column order and resets
+    template <typename Array1, typename Array2>
+    void flush(const size_t offset, Array1& column_indices, Array2& values)
+    {
+        sort();
+
+        for(size_t n = 0; n < length; n++)
+        {
+            const size_t slot = slots_ptr[n];
+
+            column_indices[offset + n] = keys_ptr[slot];
+            values[offset + n] = sums_ptr[slot];
+
+            keys_ptr[slot] = unseen();
+            sums_ptr[slot] = ValueType(0);
+        }
+
+        length = 0;
+    }
+
+    // writes the accumulated columns in ascending order and resets
+    template <typename Array1>
+    void flush(const size_t offset, Array1& column_indices)
+    {
+        sort();
+
+        for(size_t n = 0; n < length; n++)
+        {
+            const size_t slot = slots_ptr[n];
+
+            column_indices[offset + n] = keys_ptr[slot];
+            keys_ptr[slot] = unseen();
+        }
+
+        length = 0;
+    }
+
+    void clear(void)
+    {
+        for(size_t n = 0; n < length; n++)
+            keys_ptr[slots_ptr[n]] = unseen();
+
+        length = 0;
+    }
+
+private:
+
+    static IndexType unseen(void)
+    {
+        return static_cast<IndexType>(-1);
+    }
+
+    struct slot_compare
+    {
+        const IndexType * keys;
+
+        slot_compare(const IndexType * keys) : keys(keys) {}
+
+        bool operator()(const size_t a, const size_t b) const
+        {
+            return keys[a] < keys[b];
+        }
+    };
+
+    static size_t hash_capacity(const size_t max_products)
+    {
+        size_t capacity = 1;
+
+        while(capacity < 2 * max_products)
+            capacity <<= 1;
+
+        return capacity;
+    }
+
+    size_t find(const IndexType k) const
+    {
+        if(dense)
+            return k;
+
+        size_t slot = (size_t(k) * 2654435761u) & (capacity - 1);
+
+        while(keys_ptr[slot] != k && keys_ptr[slot] != unseen())
+            slot = (slot + 1) & (capacity - 1);
+
+        return slot;
+    }
+
+    void sort(void)
+    {
+        if(length > 1)
+            std::sort(slots_ptr, slots_ptr + length, slot_compare(keys_ptr));
+    }
+
+    const size_t capacity;
+    const bool   dense;
+    size_t       length;
+
+    cusp::detail::temporary_array<IndexType, DerivedPolicy> keys;
+    cusp::detail::temporary_array<ValueType, DerivedPolicy> sums;
+    cusp::detail::temporary_array<size_t,    DerivedPolicy> slots;
+
+    IndexType * keys_ptr;
+    ValueType * sums_ptr;
+    size_t    * slots_ptr;
+};
+
 //MW: note that this function is also used by coo.h
 //MW: computes the total number of nonzeors of C
 template <typename DerivedPolicy,
@@ -43,43 +287,59 @@ size_t spmm_csr_pass1(omp::execution_policy<DerivedPolicy>& exec,
                       const Array3& B_row_offsets, const Array4& B_column_indices,
                       Array5& C_row_offsets)
 {
-    typedef typename Array1::value_type IndexType1;
-    typedef typename Array2::value_type IndexType2;
+    typedef typename Array1::value_type OffsetType1;
+    typedef typename Array2::value_type IndexType1;
+    typedef typename Array3::value_type OffsetType2;
+    typedef typename Array4::value_type IndexType2;
+    typedef typename Array5::value_type OffsetType;
+
+    const int num_chunks = std::max(1, std::min(omp_get_max_threads(), int(num_rows)));
+
+    cusp::detail::temporary_array<size_t, DerivedPolicy> chunk_offsets(exec, num_chunks + 1);
+    cusp::detail::temporary_array<size_t, DerivedPolicy> chunk_max_products(exec, num_chunks);
+    cusp::detail::temporary_array<size_t, DerivedPolicy> chunk_nonzeros(exec, num_chunks + 1, 0);
+
+    spmm_csr_partition(exec, num_rows,
+                       A_row_offsets, A_column_indices, B_row_offsets,
+                       chunk_offsets, chunk_max_products);
 
     C_row_offsets[0] = 0;
 
-    #pragma omp parallel
+    // Compute nnz in C (including explicit zeros)
+    #pragma omp parallel for schedule(static, 1)
+    for(int c = 0; c < num_chunks; c++)
     {
-        cusp::detail::temporary_array<int, DerivedPolicy> mask(exec, num_cols, -1);
+        spmm_csr_accumulator<IndexType2, char, DerivedPolicy> accumulator(exec, num_cols, chunk_max_products[c]);
 
-        // Compute nnz in C (including explicit zeros)
-        #pragma omp for
-        for(int i = 0; i < int(num_rows); i++)
-        {
-            size_t num_nonzeros = 0;
+        size_t chunk_num_nonzeros = 0;
 
-            for(IndexType1 jj = A_row_offsets[i]; jj < A_row_offsets[i + 1]; jj++)
+        for(size_t i = chunk_offsets[c]; i < chunk_offsets[c + 1]; i++)
+        {
+            for(OffsetType1 jj = A_row_offsets[i]; jj < A_row_offsets[i + 1]; jj++)
             {
                 IndexType1 j = A_column_indices[jj];
 
-                for(IndexType2 kk = B_row_offsets[j]; kk < B_row_offsets[j + 1]; kk++)
-                {
-                    IndexType2 k = B_column_indices[kk];
-
-                    if(mask[k] != i)
-                    {
-                        mask[k] = i;
-                        num_nonzeros++;
-                    }
-                }
+                for(OffsetType2 kk = B_row_offsets[j]; kk < B_row_offsets[j + 1]; kk++)
+                    accumulator.insert(B_column_indices[kk]);
             }
 
-            C_row_offsets[i + 1] = num_nonzeros;
-        } // end for loop
-    }// end omp parallel
+            chunk_num_nonzeros += accumulator.size();
+            C_row_offsets[i + 1] = chunk_num_nonzeros;
+
+            accumulator.clear();
+        }
+
+        chunk_nonzeros[c + 1] = chunk_num_nonzeros;
+    }
 
-    for(int i = 1; i < int(num_rows + 1); i++)
-      C_row_offsets[i] += C_row_offsets[i - 1];
+    for(int c = 0; c < num_chunks; c++)
+      chunk_nonzeros[c + 1] += chunk_nonzeros[c];
+
+    // shift the chunk local offsets
+    #pragma omp parallel for schedule(static, 1)
+    for(int c = 0; c < num_chunks; c++)
+        for(size_t i = chunk_offsets[c]; i < chunk_offsets[c + 1]; i++)
+            C_row_offsets[i + 1] += OffsetType(chunk_nonzeros[c]);
 
     return C_row_offsets[num_rows];
 }
@@ -97,68 +357,84 @@ void spmm_csr_pass2(omp::execution_policy<DerivedPolicy>& exec,
                     Array7& C_row_offsets,       Array8& C_column_indices,       Array9& C_values,
                     UnaryFunction initialize,    BinaryFunction1 combine,        BinaryFunction2 reduce)
 {
-    typedef typename Array7::value_type IndexType;
+    typedef typename Array1::value_type OffsetType1;
+    typedef typename Array4::value_type OffsetType2;
+    typedef typename Array8::value_type IndexType;
     typedef typename Array9::value_type ValueType;
 
-    const IndexType unseen = static_cast<IndexType>(-1);
-    const IndexType init   = static_cast<IndexType>(-2);
+    const int num_chunks = std::max(1, std::min(omp_get_max_threads(), int(num_rows)));
 
-    #pragma omp parallel
-    {
-        // Compute entries of C
-        cusp::detail::temporary_array<IndexType, DerivedPolicy> next(exec, num_cols, unseen);
-        cusp::detail::temporary_array<ValueType, DerivedPolicy> sums(exec, num_cols, ValueType(0));
+    cusp::detail::temporary_array<size_t, DerivedPolicy> chunk_offsets(exec, num_chunks + 1);
+    cusp::detail::temporary_array<size_t, DerivedPolicy> chunk_max_products(exec, num_chunks);
 
-        #pragma omp for
-        for (int i = 0; i < int(num_rows); i++)
-        {
-            IndexType head   = init;
-            IndexType length = 0;
+    spmm_csr_partition(exec, num_rows,
+                       A_row_offsets, A_column_indices, B_row_offsets,
+                       chunk_offsets, chunk_max_products);
 
-            IndexType jj_start = A_row_offsets[i];
-            IndexType jj_end   = A_row_offsets[i + 1];
+    // Compute entries of C
+    #pragma omp parallel for schedule(static, 1)
+    for(int c = 0; c < num_chunks; c++)
+    {
+        spmm_csr_accumulator<IndexType, ValueType, DerivedPolicy> accumulator(exec, num_cols, chunk_max_products[c]);
 
-            for (IndexType jj = jj_start; jj < jj_end; jj++)
+        for(size_t i = chunk_offsets[c]; i < chunk_offsets[c + 1]; i++)
+        {
+            for(OffsetType1 jj = A_row_offsets[i]; jj < A_row_offsets[i + 1]; jj++)
             {
                 IndexType j = A_column_indices[jj];
                 ValueType v = A_values[jj];
 
-                IndexType kk_start = B_row_offsets[j];
-                IndexType kk_end   = B_row_offsets[j + 1];
+                for(OffsetType2 kk = B_row_offsets[j]; kk < B_row_offsets[j + 1]; kk++)
+                    accumulator.insert(B_column_indices[kk], ValueType(combine(v, B_values[kk])), reduce);
+            }
 
-                for (IndexType kk = kk_start; kk < kk_end; kk++)
-                {
-                    IndexType k = B_column_indices[kk];
-                    ValueType b = B_values[kk];
+            accumulator.flush(C_row_offsets[i], C_column_indices, C_values);
+        }
+    }
+}
 
-                    sums[k] = reduce(sums[k], combine(v, b));
+// fills the column indices of each row of C in ascending order
+template <typename DerivedPolicy,
+          typename Array1, typename Array2,
+          typename Array3, typename Array4,
+          typename Array5, typename Array6>
+void spmm_csr_pattern(omp::execution_policy<DerivedPolicy>& exec,
+                      const size_t num_rows, const size_t num_cols,
+                      const Array1& A_row_offsets, const Array2& A_column_indices,
+                      const Array3& B_row_offsets, const Array4& B_column_indices,
+                      const Array5& C_row_offsets, Array6& C_column_indices)
+{
+    typedef typename Array1::value_type OffsetType1;
+    typedef typename Array3::value_type OffsetType2;
+    typedef typename Array6::value_type IndexType;
 
-                    if (next[k] == unseen)
-                    {
-                        next[k] = head;
-                        head = k;
-                        length++;
-                    }
-                }
-            }
+    const int num_chunks = std::max(1, std::min(omp_get_max_threads(), int(num_rows)));
 
-            size_t offset = C_row_offsets[i];
+    cusp::detail::temporary_array<size_t, DerivedPolicy> chunk_offsets(exec, num_chunks + 1);
+    cusp::detail::temporary_array<size_t, DerivedPolicy> chunk_max_products(exec, num_chunks);
 
-            for (IndexType jj = 0; jj < length; jj++)
-            {
-                C_column_indices[offset] = head;
-                C_values[offset] = sums[head];
-                offset++;
+    spmm_csr_partition(exec, num_rows,
+                       A_row_offsets, A_column_indices, B_row_offsets,
+                       chunk_offsets, chunk_max_products);
+
+    #pragma omp parallel for schedule(static, 1)
+    for(int c = 0; c < num_chunks; c++)
+    {
+        spmm_csr_accumulator<IndexType, char, DerivedPolicy> accumulator(exec, num_cols, chunk_max_products[c]);
 
-                IndexType temp = head;
-                head = next[head];
+        for(size_t i = chunk_offsets[c]; i < chunk_offsets[c + 1]; i++)
+        {
+            for(OffsetType1 jj = A_row_offsets[i]; jj < A_row_offsets[i + 1]; jj++)
+            {
+                IndexType j = A_column_indices[jj];
 
-                // clear arrays
-                next[temp] = unseen;
-                sums[temp] = ValueType(0);
+                for(OffsetType2 kk = B_row_offsets[j]; kk < B_row_offsets[j + 1]; kk++)
+                    accumulator.insert(B_column_indices[kk]);
             }
-        } // end for loop
-    } //omp parallel
+
+            accumulator.flush(C_row_offsets[i], C_column_indices);
+        }
+    }
 }
 
 template <typename DerivedPolicy,
@@ -197,6 +473,119 @@ void multiply(omp::execution_policy<DerivedPolicy>& exec,
                    initialize, combine, reduce);
 }
 
+
+template <typename DerivedPolicy,
+          typename MatrixType1,
+          typename MatrixType2,
+          typename MatrixType3,
+          typename PlanType>
+void spgemm_symbolic(omp::execution_policy<DerivedPolicy>& exec,
+                     const MatrixType1& A,
+                     const MatrixType2& B,
+                     MatrixType3& C,
+                     PlanType& plan,
+                     cusp::csr_format,
+                     cusp::csr_format,
+                     cusp::csr_format)
+{
+    typedef typename MatrixType3::value_type ValueType;
+
+    C.resize(A.num_rows, B.num_cols, 0);
+
+    size_t num_nonzeros =
+        spmm_csr_pass1(exec, A.num_rows, B.num_cols,
+                       A.row_offsets, A.column_indices,
+                       B.row_offsets, B.column_indices,
+                       C.row_offsets);
+
+    C.resize(A.num_rows, B.num_cols, num_nonzeros);
+
+    spmm_csr_pattern(exec, A.num_rows, B.num_cols,
+                     A.row_offsets, A.column_indices,
+                     B.row_offsets, B.column_indices,
+                     C.row_offsets, C.column_indices);
+
+    thrust::fill(exec, C.values.begin(), C.values.end(), ValueType(0));
+
+    // the numeric phase recomputes the products from the pattern of C
+    plan.A_num_entries = A.num_entries;
+    plan.B_num_entries = B.num_entries;
+    plan.C_num_entries = C.num_entries;
+    plan.A_gather_locations.resize(0);
+    plan.B_gather_locations.resize(0);
+    plan.output_keys.resize(0);
+}
+
+template <typename DerivedPolicy,
+          typename MatrixType1,
+          typename MatrixType2,
+          typename MatrixType3,
+          typename PlanType,
+          typename BinaryFunction1,
+          typename BinaryFunction2>
+void spgemm_numeric(omp::execution_policy<DerivedPolicy>& exec,
+                    const MatrixType1& A,
+                    const MatrixType2& B,
+                    MatrixType3& C,
+                    const PlanType& plan,
+                    BinaryFunction1 combine,
+                    BinaryFunction2 reduce,
+                    cusp::csr_format,
+                    cusp::csr_format,
+                    cusp::csr_format)
+{
+    typedef typename cusp::detail::get_offset_type<MatrixType1>::type OffsetType1;
+    typedef typename cusp::detail::get_offset_type<MatrixType2>::type OffsetType2;
+    typedef typename cusp::detail::get_offset_type<MatrixType3>::type OffsetType3;
+    typedef typename MatrixType3::index_type IndexType;
+    typedef typename MatrixType3::value_type ValueType;
+
+    if (A.num_entries != plan.A_num_entries ||
+        B.num_entries != plan.B_num_entries ||
+        C.num_entries != plan.C_num_entries)
+        throw cusp::invalid_input_exception("matrix sizes do not match the spgemm plan");
+
+    const int num_chunks = std::max(1, std::min(omp_get_max_threads(), int(A.num_rows)));
+
+    cusp::detail::temporary_array<size_t, DerivedPolicy> chunk_offsets(exec, num_chunks + 1);
+    cusp::detail::temporary_array<size_t, DerivedPolicy> chunk_max_products(exec, num_chunks);
+
+    spmm_csr_partition(exec, A.num_rows,
+                       A.row_offsets, A.column_indices, B.row_offsets,
+                       chunk_offsets, chunk_max_products);
+
+    #pragma omp parallel for schedule(static, 1)
+    for (int c = 0; c < num_chunks; c++)
+    {
+        cusp::detail::temporary_array<ValueType, DerivedPolicy> sums(exec, B.num_cols, ValueType(0));
+
+        for (size_t i = chunk_offsets[c]; i < chunk_offsets[c + 1]; i++)
+        {
+            for (OffsetType1 jj = A.row_offsets[i]; jj < A.row_offsets[i + 1]; jj++)
+            {
+                IndexType j = A.column_indices[jj];
+                ValueType v = A.values[jj];
+
+                for (OffsetType2 kk = B.row_offsets[j]; kk < B.row_offsets[j + 1]; kk++)
+                {
+                    IndexType k = B.column_indices[kk];
+
+                    sums[k] = reduce(sums[k], combine(v, B.values[kk]));
+                }
+            }
+
+            // gather the row of C from its known pattern
+            for (OffsetType3 jj = C.row_offsets[i]; jj < C.row_offsets[i + 1]; jj++)
+            {
+                IndexType k = C.column_indices[jj];
+
+                C.values[jj] = sums[k];
+                sums[k] = ValueType(0);
+            }
+        }
+    }
+}
+
 } // end namespace detail
 } // end namespace omp
 } // end namespace system
@@ -29,9 +29,14 @@
 #include <cusp/coo_matrix.h>
 #include <cusp/csr_matrix.h>
 
+#include <cusp/detail/temporary_array.h>
 #include <cusp/detail/utils.h>
 #include <cusp/detail/array2d_format_utils.h>
 
+#include <algorithm>
+
+#include <omp.h>
+
 namespace cusp
 {
 namespace system
@@ -41,8 +46,57 @@ namespace omp
 namespace detail
 {
 
+// Merge-path CSR SpMV: the rows and the nonzeros of A are viewed as one
+// sequence of num_rows + num_entries items (every row contributes its
+// nonzeros followed by its end) which is split evenly between the
+// threads, so every thread performs the same amount of work regardless of
+// the row lengths. A thread searches its starting row along the diagonal
+// of the merge path, completes every row that ends inside its range and
+// carries the partial sum of the row it ends in, the carries are reduced
+// into y once all threads finished. Since the partition only takes one
+// binary search per thread it is recomputed on every call.
+//
+// Defining CUSP_OMP_SPMV_PREFETCH_DISTANCE to a positive number of
+// nonzeros prefetches the entries of x that many nonzeros ahead.
+
+#ifndef CUSP_OMP_SPMV_PREFETCH_DISTANCE
+#define CUSP_OMP_SPMV_PREFETCH_DISTANCE 0
+#endif
+
+template <typename ValueType>
+inline void csr_spmv_prefetch(const ValueType& value)
+{
+#if defined(__GNUC__)
+    __builtin_prefetch(&value);
+#endif
+}
+
+// number of rows completed before the merge path reaches diagonal
+template <typename ArrayType, typename IndexType>
+IndexType csr_spmv_merge_path_search(const ArrayType& row_offsets,
+                                     const IndexType num_rows,
+                                     const IndexType num_entries,
+                                     const IndexType diagonal)
+{
+    IndexType lower = diagonal > num_entries ? diagonal - num_entries : IndexType(0);
+    IndexType upper = diagonal < num_rows    ? diagonal               : num_rows;
+
+    // the end of row i comes after the nonzeros of rows [0,i]
+    while(lower < upper)
+    {
+        IndexType pivot = lower + (upper - lower) / 2;
+
+        if(IndexType(row_offsets[pivot + 1]) <= diagonal - pivot - 1)
+            lower = pivot + 1;
+        else
+            upper = pivot;
+    }
+
+    return lower;
+}
+
 template <typename DerivedPolicy,
-		      typename MatrixType,
+          typename MatrixType,
           typename VectorType1,
           typename VectorType2,
           typename UnaryFunction,
@@ -59,30 +113,78 @@ void multiply(omp::execution_policy<DerivedPolicy>& exec,
               cusp::array1d_format,
               cusp::array1d_format)
 {
-    typedef typename MatrixType::index_type  IndexType;
+    // merge path coordinates count rows plus entries, so they use the
+    // type of the row offsets
+    typedef typename cusp::detail::get_offset_type<MatrixType>::type OffsetType;
     typedef typename VectorType2::value_type ValueType;
 
-	int N = A.num_rows;
+    const OffsetType num_rows    = A.num_rows;
+    const OffsetType num_entries = A.row_offsets[num_rows];
+
+    if(num_rows == 0)
+        return;
+
+    const int num_threads = std::max(1, std::min(omp_get_max_threads(), int(num_rows + num_entries)));
+
+    const OffsetType num_items        = num_rows + num_entries;
+    const OffsetType items_per_thread = (num_items + num_threads - 1) / num_threads;
 
-    #pragma omp parallel for
-    for(int i = 0; i < N; i++)
+    // partial sums of the rows the threads end in
+    cusp::detail::temporary_array<OffsetType, DerivedPolicy> carry_rows(exec, num_threads);
+    cusp::detail::temporary_array<ValueType,  DerivedPolicy> carry_values(exec, num_threads);
+    cusp::detail::temporary_array<char,       DerivedPolicy> carry_valid(exec, num_threads);
+
+    #pragma omp parallel for schedule(static, 1) num_threads(num_threads)
+    for(int t = 0; t < num_threads; t++)
     {
-        const IndexType row_start = A.row_offsets[i];
-        const IndexType row_end   = A.row_offsets[i+1];
+        const OffsetType diagonal_begin = std::min(num_items, OffsetType(t)     * items_per_thread);
+        const OffsetType diagonal_end   = std::min(num_items, OffsetType(t + 1) * items_per_thread);
+
+        OffsetType row     = csr_spmv_merge_path_search(A.row_offsets, num_rows, num_entries, diagonal_begin);
+        OffsetType jj      = diagonal_begin - row;
+        OffsetType row_end = csr_spmv_merge_path_search(A.row_offsets, num_rows, num_entries, diagonal_end);
+        OffsetType jj_end  = diagonal_end - row_end;
+
+        ValueType partial = ValueType(0);
+        bool      valid   = false;
 
-        ValueType accumulator = initialize(y[i]);
+        // rows ending in the range of this thread
+        for(; row < row_end; row++)
+        {
+            ValueType accumulator = initialize(y[row]);
+
+            for(const OffsetType end = A.row_offsets[row + 1]; jj < end; jj++)
+            {
+                if(CUSP_OMP_SPMV_PREFETCH_DISTANCE > 0 && jj + CUSP_OMP_SPMV_PREFETCH_DISTANCE < jj_end)
+                    csr_spmv_prefetch(x[A.column_indices[jj + CUSP_OMP_SPMV_PREFETCH_DISTANCE]]);
 
-        for (IndexType jj = row_start; jj < row_end; jj++)
+                accumulator = reduce(accumulator, combine(A.values[jj], x[A.column_indices[jj]]));
+            }
+
+            y[row] = accumulator;
+        }
+
+        // nonzeros of the row the range ends in
+        for(; jj < jj_end; jj++)
         {
-            const IndexType j   = A.column_indices[jj];
-            const ValueType Aij = A.values[jj];
-            const ValueType xj  = x[j];
+            if(CUSP_OMP_SPMV_PREFETCH_DISTANCE > 0 && jj + CUSP_OMP_SPMV_PREFETCH_DISTANCE < jj_end)
+                csr_spmv_prefetch(x[A.column_indices[jj + CUSP_OMP_SPMV_PREFETCH_DISTANCE]]);
+
+            ValueType product = combine(A.values[jj], x[A.column_indices[jj]]);
 
-            accumulator = reduce(accumulator, combine(Aij, xj));
+            partial = valid ? reduce(partial, product) : product;
+            valid   = true;
         }
 
-        y[i] = accumulator;
+        carry_rows[t]   = row_end;
+        carry_values[t] = partial;
+        carry_valid[t]  = valid;
     }
+
+    // the row a carry belongs to has been completed by a later thread
+    for(int t = 0; t < num_threads; t++)
+        if(carry_valid[t] && carry_rows[t] < num_rows)
+            y[carry_rows[t]] = reduce(y[carry_rows[t]], carry_values[t]);
 }
 
 } // end namespace detail
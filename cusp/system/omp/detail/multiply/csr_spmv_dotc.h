@@ -0,0 +1,86 @@
+/*
+ *  Copyright 2008-2013 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#pragma once
+
+#include <thrust/detail/config.h>
+
+#include <cusp/detail/format.h>
+
+#include <cusp/complex.h>
+
+namespace cusp
+{
+namespace system
+{
+namespace omp
+{
+namespace detail
+{
+
+template <typename DerivedPolicy,
+          typename MatrixType,
+          typename VectorType1,
+          typename VectorType2>
+typename VectorType2::value_type
+multiply_dotc(omp::execution_policy<DerivedPolicy>& exec,
+              const MatrixType& A,
+              const VectorType1& x,
+              VectorType2& y,
+              cusp::csr_format,
+              cusp::array1d_format,
+              cusp::array1d_format)
+{
+    typedef typename MatrixType::index_type  IndexType;
+    typedef typename VectorType2::value_type ValueType;
+
+    const int N = A.num_rows;
+
+    ValueType dot(0);
+
+    // each thread accumulates a private partial sum, which also works for
+    // complex values unsupported by the OpenMP reduction clause
+    #pragma omp parallel
+    {
+        ValueType partial(0);
+
+        #pragma omp for
+        for(int i = 0; i < N; i++)
+        {
+            const IndexType row_start = A.row_offsets[i];
+            const IndexType row_end   = A.row_offsets[i + 1];
+
+            ValueType accumulator(0);
+
+            for(IndexType jj = row_start; jj < row_end; jj++)
+                accumulator += ValueType(A.values[jj]) * ValueType(x[A.column_indices[jj]]);
+
+            y[i] = accumulator;
+
+            partial += cusp::conj(accumulator) * ValueType(x[i]);
+        }
+
+        #pragma omp critical
+        dot += partial;
+    }
+
+    return dot;
+}
+
+} // end namespace detail
+} // end namespace omp
+} // end namespace system
+} // end namespace cusp
@@ -0,0 +1,91 @@
+/*
+ *  Copyright 2008-2013 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#pragma once
+
+#include <thrust/detail/config.h>
+
+#include <cusp/detail/format.h>
+#include <cusp/dcsr_matrix.h>
+
+namespace cusp
+{
+namespace system
+{
+namespace omp
+{
+namespace detail
+{
+
+// Rows are distributed among the threads exactly like the CSR kernel, the
+// index representation of a row is determined by the block it belongs to.
+template <typename DerivedPolicy,
+          typename MatrixType,
+          typename VectorType1,
+          typename VectorType2,
+          typename UnaryFunction,
+          typename BinaryFunction1,
+          typename BinaryFunction2>
+void multiply(omp::execution_policy<DerivedPolicy>& exec,
+              const MatrixType& A,
+              const VectorType1& x,
+              VectorType2& y,
+              UnaryFunction   initialize,
+              BinaryFunction1 combine,
+              BinaryFunction2 reduce,
+              cusp::dcsr_format,
+              cusp::array1d_format,
+              cusp::array1d_format)
+{
+    typedef typename MatrixType::index_type  IndexType;
+    typedef typename VectorType2::value_type ValueType;
+
+    const int R = MatrixType::rows_per_block;
+    const int N = A.num_rows;
+
+    #pragma omp parallel for
+    for(int i = 0; i < N; i++)
+    {
+        const int b = i / R;
+
+        const IndexType block_start = A.row_offsets[b * R];
+        const IndexType full_start  = A.block_offsets[b];
+        const bool      use_full    = A.block_offsets[b + 1] != full_start;
+
+        const IndexType row_start = A.row_offsets[i];
+        const IndexType row_end   = A.row_offsets[i + 1];
+
+        ValueType accumulator = initialize(y[i]);
+
+        for (IndexType jj = row_start; jj < row_end; jj++)
+        {
+            const IndexType j = use_full ? IndexType(A.column_indices[full_start + jj - block_start])
+                                         : IndexType(IndexType(i) + A.column_deltas[jj]);
+
+            const ValueType Aij = A.values[jj];
+            const ValueType xj  = x[j];
+
+            accumulator = reduce(accumulator, combine(Aij, xj));
+        }
+
+        y[i] = accumulator;
+    }
+}
+
+} // end namespace detail
+} // end namespace omp
+} // end namespace system
+} // end namespace cusp
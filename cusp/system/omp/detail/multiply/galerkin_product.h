@@ -0,0 +1,174 @@
+/*
+ *  Copyright 2008-2014 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#pragma once
+
+#include <cusp/detail/config.h>
+#include <cusp/detail/format.h>
+#include <cusp/detail/temporary_array.h>
+
+#include <cusp/system/omp/detail/multiply/csr_spgemm.h>
+
+#include <thrust/functional.h>
+
+#include <algorithm>
+
+#include <omp.h>
+
+namespace cusp
+{
+namespace system
+{
+namespace omp
+{
+namespace detail
+{
+
+// Computes the Galerkin product RAP = R * A * P one coarse row at a time,
+// RAP(I,:) = sum_i R(I,i) * (sum_j A(i,j) * P(j,:)), so the fine-by-coarse
+// intermediate A * P is never stored.  The rows A(i,:) * P are recomputed
+// for every coarse row they contribute to, which is cheap for smoothed
+// aggregation since the rows of a smoothed tentative prolongator only hold
+// the few aggregates adjacent to a fine point.  The coarse rows are split
+// into chunks of equal triple products and every chunk uses a private
+// accumulator over the coarse columns, see spmm_csr_pass1 and pass2.
+template <typename DerivedPolicy,
+          typename MatrixType1,
+          typename MatrixType2,
+          typename MatrixType3>
+void galerkin_product(omp::execution_policy<DerivedPolicy>& exec,
+                      const MatrixType1& R,
+                      const MatrixType2& A,
+                      const MatrixType1& P,
+                            MatrixType3& RAP,
+                      cusp::csr_format,
+                      cusp::csr_format,
+                      cusp::csr_format)
+{
+    typedef typename MatrixType3::index_type IndexType;
+    typedef typename MatrixType3::value_type ValueType;
+
+    const size_t num_rows = R.num_rows;
+    const size_t num_cols = P.num_cols;
+
+    const int num_chunks = std::max(1, std::min(omp_get_max_threads(), int(num_rows)));
+
+    cusp::detail::temporary_array<size_t, DerivedPolicy> cumulative_products(exec, num_rows + 1);
+    cusp::detail::temporary_array<size_t, DerivedPolicy> chunk_offsets(exec, num_chunks + 1);
+    cusp::detail::temporary_array<size_t, DerivedPolicy> chunk_max_products(exec, num_chunks);
+    cusp::detail::temporary_array<size_t, DerivedPolicy> chunk_nonzeros(exec, num_chunks + 1, 0);
+
+    // number of triple products R(I,i) * A(i,j) * P(j,k) of every coarse row
+    #pragma omp parallel for schedule(static, 64)
+    for(int I = 0; I < int(num_rows); I++)
+    {
+        size_t num_products = 0;
+
+        for(IndexType ii = R.row_offsets[I]; ii < R.row_offsets[I + 1]; ii++)
+        {
+            IndexType i = R.column_indices[ii];
+
+            for(IndexType jj = A.row_offsets[i]; jj < A.row_offsets[i + 1]; jj++)
+            {
+                IndexType j = A.column_indices[jj];
+                num_products += P.row_offsets[j + 1] - P.row_offsets[j];
+            }
+        }
+
+        cumulative_products[I + 1] = num_products;
+    }
+
+    spmm_csr_chunks(exec, num_rows, cumulative_products, chunk_offsets, chunk_max_products);
+
+    RAP.resize(num_rows, num_cols, 0);
+    RAP.row_offsets[0] = 0;
+
+    // count the entries of every coarse row
+    #pragma omp parallel for schedule(static, 1)
+    for(int c = 0; c < num_chunks; c++)
+    {
+        spmm_csr_accumulator<IndexType, char, DerivedPolicy> accumulator(exec, num_cols, chunk_max_products[c]);
+
+        size_t chunk_num_nonzeros = 0;
+
+        for(size_t I = chunk_offsets[c]; I < chunk_offsets[c + 1]; I++)
+        {
+            for(IndexType ii = R.row_offsets[I]; ii < R.row_offsets[I + 1]; ii++)
+            {
+                IndexType i = R.column_indices[ii];
+
+                for(IndexType jj = A.row_offsets[i]; jj < A.row_offsets[i + 1]; jj++)
+                {
+                    IndexType j = A.column_indices[jj];
+
+                    for(IndexType kk = P.row_offsets[j]; kk < P.row_offsets[j + 1]; kk++)
+                        accumulator.insert(P.column_indices[kk]);
+                }
+            }
+
+            chunk_num_nonzeros += accumulator.size();
+            RAP.row_offsets[I + 1] = chunk_num_nonzeros;
+
+            accumulator.clear();
+        }
+
+        chunk_nonzeros[c + 1] = chunk_num_nonzeros;
+    }
+
+    for(int c = 0; c < num_chunks; c++)
+        chunk_nonzeros[c + 1] += chunk_nonzeros[c];
+
+    #pragma omp parallel for schedule(static, 1)
+    for(int c = 0; c < num_chunks; c++)
+        for(size_t I = chunk_offsets[c]; I < chunk_offsets[c + 1]; I++)
+            RAP.row_offsets[I + 1] += IndexType(chunk_nonzeros[c]);
+
+    RAP.resize(num_rows, num_cols, chunk_nonzeros[num_chunks]);
+
+    // accumulate and write the coarse rows
+    #pragma omp parallel for schedule(static, 1)
+    for(int c = 0; c < num_chunks; c++)
+    {
+        spmm_csr_accumulator<IndexType, ValueType, DerivedPolicy> accumulator(exec, num_cols, chunk_max_products[c]);
+
+        thrust::plus<ValueType> reduce;
+
+        for(size_t I = chunk_offsets[c]; I < chunk_offsets[c + 1]; I++)
+        {
+            for(IndexType ii = R.row_offsets[I]; ii < R.row_offsets[I + 1]; ii++)
+            {
+                IndexType i = R.column_indices[ii];
+                ValueType r = R.values[ii];
+
+                for(IndexType jj = A.row_offsets[i]; jj < A.row_offsets[i + 1]; jj++)
+                {
+                    IndexType j  = A.column_indices[jj];
+                    ValueType ra = r * ValueType(A.values[jj]);
+
+                    for(IndexType kk = P.row_offsets[j]; kk < P.row_offsets[j + 1]; kk++)
+                        accumulator.insert(P.column_indices[kk], ra * ValueType(P.values[kk]), reduce);
+                }
+            }
+
+            accumulator.flush(RAP.row_offsets[I], RAP.column_indices, RAP.values);
+        }
+    }
+}
+
+} // end namespace detail
+} // end namespace omp
+} // end namespace system
+} // end namespace cusp
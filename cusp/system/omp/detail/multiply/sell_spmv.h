@@ -0,0 +1,97 @@
+/*
+ *  Copyright 2008-2013 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#pragma once
+
+#include <thrust/detail/config.h>
+
+#include <cusp/detail/format.h>
+#include <cusp/sell_matrix.h>
+
+namespace cusp
+{
+namespace system
+{
+namespace omp
+{
+namespace detail
+{
+
+// Slices are independent and each thread processes whole slices, so the
+// stored rows of a slice are always written by the same thread.  Slices
+// differ in width, therefore they are handed out dynamically.
+template <typename DerivedPolicy,
+          typename MatrixType,
+          typename VectorType1,
+          typename VectorType2,
+          typename UnaryFunction,
+          typename BinaryFunction1,
+          typename BinaryFunction2>
+void multiply(omp::execution_policy<DerivedPolicy>& exec,
+              const MatrixType& A,
+              const VectorType1& x,
+              VectorType2& y,
+              UnaryFunction   initialize,
+              BinaryFunction1 combine,
+              BinaryFunction2 reduce,
+              cusp::sell_format,
+              cusp::array1d_format,
+              cusp::array1d_format)
+{
+    typedef typename MatrixType::index_type  IndexType;
+    typedef typename VectorType2::value_type ValueType;
+
+    const IndexType invalid_index = MatrixType::invalid_index;
+
+    const int C = A.slice_size;
+    const int N = A.num_rows;
+    const int S = A.num_slices();
+
+    #pragma omp parallel for schedule(dynamic)
+    for(int s = 0; s < S; s++)
+    {
+        const IndexType slice_start = A.slice_offsets[s];
+        const IndexType slice_width = (A.slice_offsets[s + 1] - slice_start) / C;
+
+        for(int lane = 0; lane < C && s * C + lane < N; lane++)
+        {
+            const IndexType i = A.row_permutation[s * C + lane];
+
+            ValueType accumulator = initialize(y[i]);
+
+            for(IndexType n = 0; n < slice_width; n++)
+            {
+                const IndexType offset = slice_start + n * C + lane;
+                const IndexType j      = A.column_indices[offset];
+
+                if (j != invalid_index)
+                {
+                    const ValueType Aij = A.values[offset];
+                    const ValueType xj  = x[j];
+
+                    accumulator = reduce(accumulator, combine(Aij, xj));
+                }
+            }
+
+            y[i] = accumulator;
+        }
+    }
+}
+
+} // end namespace detail
+} // end namespace omp
+} // end namespace system
+} // end namespace cusp
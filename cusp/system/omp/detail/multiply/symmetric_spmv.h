@@ -0,0 +1,166 @@
+/*
+ *  Copyright 2008-2013 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#pragma once
+
+#include <thrust/detail/config.h>
+
+#include <cusp/detail/format.h>
+#include <cusp/detail/temporary_array.h>
+#include <cusp/detail/utils.h>
+#include <cusp/symmetric_matrix.h>
+
+#include <algorithm>
+
+#include <omp.h>
+
+namespace cusp
+{
+namespace system
+{
+namespace omp
+{
+namespace detail
+{
+
+// The rows are split into one contiguous chunk per thread.  The transposed
+// contribution of an entry A(i,j) with j > i lands in the chunk owning row i
+// or in a later one, contributions inside the own chunk are accumulated in
+// place while the remaining ones are gathered in a private buffer covering
+// the rows between the end of the chunk and its largest column index.  The
+// buffers are folded into y afterwards, so no atomics are required.
+//
+// Note: the column indices of every row of A.upper must be sorted, which is
+//       guaranteed by the conversion to symmetric_matrix.
+template <typename DerivedPolicy,
+          typename MatrixType,
+          typename VectorType1,
+          typename VectorType2,
+          typename UnaryFunction,
+          typename BinaryFunction1,
+          typename BinaryFunction2>
+void multiply(omp::execution_policy<DerivedPolicy>& exec,
+              const MatrixType& A,
+              const VectorType1& x,
+              VectorType2& y,
+              UnaryFunction   initialize,
+              BinaryFunction1 combine,
+              BinaryFunction2 reduce,
+              cusp::symmetric_format,
+              cusp::array1d_format,
+              cusp::array1d_format)
+{
+    typedef typename MatrixType::index_type  IndexType;
+    typedef typename VectorType2::value_type ValueType;
+
+    const int N = A.num_rows;
+
+    if(N == 0) return;
+
+    const int num_chunks = std::max(1, std::min(omp_get_max_threads(), N));
+    const int chunk_size = cusp::detail::divide_into(N, num_chunks);
+
+    // rows [chunk_end, spill_end) of every chunk receive buffered contributions
+    cusp::detail::temporary_array<IndexType, DerivedPolicy> spill_offsets(exec, num_chunks + 1);
+
+    spill_offsets[0] = 0;
+
+    #pragma omp parallel for schedule(static, 1)
+    for(int c = 0; c < num_chunks; c++)
+    {
+        const int chunk_begin = std::min(N, c * chunk_size);
+        const int chunk_end   = std::min(N, chunk_begin + chunk_size);
+
+        IndexType spill_end = chunk_end;
+
+        for(int i = chunk_begin; i < chunk_end; i++)
+            if(A.upper.row_offsets[i + 1] > A.upper.row_offsets[i])
+                spill_end = std::max(spill_end, IndexType(A.upper.column_indices[A.upper.row_offsets[i + 1] - 1] + 1));
+
+        spill_offsets[c + 1] = spill_end - chunk_end;
+    }
+
+    for(int c = 0; c < num_chunks; c++)
+        spill_offsets[c + 1] += spill_offsets[c];
+
+    cusp::detail::temporary_array<ValueType, DerivedPolicy> spill(exec, spill_offsets[num_chunks], ValueType(0));
+
+    #pragma omp parallel for schedule(static, 1)
+    for(int c = 0; c < num_chunks; c++)
+    {
+        const int chunk_begin = std::min(N, c * chunk_size);
+        const int chunk_end   = std::min(N, chunk_begin + chunk_size);
+
+        const IndexType spill_start = spill_offsets[c] - chunk_end;
+
+        for(int i = chunk_begin; i < chunk_end; i++)
+            y[i] = initialize(y[i]);
+
+        for(int i = chunk_begin; i < chunk_end; i++)
+        {
+            const IndexType row_start = A.upper.row_offsets[i];
+            const IndexType row_end   = A.upper.row_offsets[i + 1];
+
+            const ValueType xi = x[i];
+
+            ValueType accumulator = y[i];
+
+            for(IndexType jj = row_start; jj < row_end; jj++)
+            {
+                const IndexType j   = A.upper.column_indices[jj];
+                const ValueType Aij = A.upper.values[jj];
+
+                accumulator = reduce(accumulator, combine(Aij, x[j]));
+
+                if(j == i)
+                    continue;
+
+                if(j < chunk_end)
+                    y[j] = reduce(y[j], combine(Aij, xi));
+                else
+                    spill[spill_start + j] = reduce(spill[spill_start + j], combine(Aij, xi));
+            }
+
+            y[i] = accumulator;
+        }
+    }
+
+    // fold the buffered contributions of preceding chunks into y
+    #pragma omp parallel for schedule(static, 1)
+    for(int c = 1; c < num_chunks; c++)
+    {
+        const int chunk_begin = std::min(N, c * chunk_size);
+        const int chunk_end   = std::min(N, chunk_begin + chunk_size);
+
+        for(int d = 0; d < c; d++)
+        {
+            const int       d_end       = std::min(N, (d + 1) * chunk_size);
+            const IndexType spill_start = spill_offsets[d];
+            const IndexType spill_stop  = spill_offsets[d + 1];
+
+            const int begin = std::max(chunk_begin, d_end);
+            const int end   = std::min(chunk_end,   int(d_end + spill_stop - spill_start));
+
+            for(int i = begin; i < end; i++)
+                y[i] = reduce(y[i], spill[spill_start + i - d_end]);
+        }
+    }
+}
+
+} // end namespace detail
+} // end namespace omp
+} // end namespace system
+} // end namespace cusp
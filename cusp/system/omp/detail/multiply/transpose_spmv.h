@@ -0,0 +1,235 @@
+/*
+ *  Copyright 2008-2013 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#pragma once
+
+#include <thrust/detail/config.h>
+
+#include <cusp/detail/format.h>
+#include <cusp/detail/temporary_array.h>
+#include <cusp/detail/utils.h>
+
+#include <thrust/detail/type_traits.h>
+
+#include <algorithm>
+
+#include <omp.h>
+
+namespace cusp
+{
+namespace system
+{
+namespace omp
+{
+namespace detail
+{
+
+// Every entry A(i,j) scatters A(i,j) * x[i] into y[j].  Different rows may
+// update the same entry of y.  Arithmetic value types are updated with omp
+// atomics, which do not accept other types such as cusp::complex, so those
+// are accumulated in one private copy of y per chunk of rows and the copies
+// are summed afterwards.
+
+// adds to y[j] atomically
+template <typename ValueType>
+struct transpose_atomic_sink
+{
+    typedef ValueType value_type;
+
+    ValueType * y;
+
+    transpose_atomic_sink(ValueType * y) : y(y) {}
+
+    void operator()(const int j, const ValueType value) const
+    {
+        ValueType& yj = y[j];
+
+        #pragma omp atomic
+        yj += value;
+    }
+};
+
+// adds to a copy of y private to the calling thread
+template <typename ValueType>
+struct transpose_private_sink
+{
+    typedef ValueType value_type;
+
+    ValueType * y;
+
+    transpose_private_sink(ValueType * y) : y(y) {}
+
+    void operator()(const int j, const ValueType value) const
+    {
+        y[j] += value;
+    }
+};
+
+// the products of entry n
+template <typename MatrixType, typename VectorType, typename Sink>
+void transpose_scatter(const MatrixType& A, const VectorType& x, const int n, const Sink& sink, cusp::coo_format)
+{
+    typedef typename Sink::value_type ValueType;
+
+    sink(A.column_indices[n], ValueType(A.values[n]) * ValueType(x[A.row_indices[n]]));
+}
+
+// the products of row i
+template <typename MatrixType, typename VectorType, typename Sink>
+void transpose_scatter(const MatrixType& A, const VectorType& x, const int i, const Sink& sink, cusp::csr_format)
+{
+    typedef typename MatrixType::index_type IndexType;
+    typedef typename Sink::value_type       ValueType;
+
+    const IndexType row_start = A.row_offsets[i];
+    const IndexType row_end   = A.row_offsets[i + 1];
+
+    const ValueType xi = x[i];
+
+    for(IndexType jj = row_start; jj < row_end; jj++)
+        sink(A.column_indices[jj], ValueType(A.values[jj]) * xi);
+}
+
+template <typename MatrixType>
+int transpose_scatter_units(const MatrixType& A, cusp::coo_format)
+{
+    return A.num_entries;
+}
+
+template <typename MatrixType>
+int transpose_scatter_units(const MatrixType& A, cusp::csr_format)
+{
+    return A.num_rows;
+}
+
+template <typename DerivedPolicy,
+          typename MatrixType,
+          typename VectorType1,
+          typename VectorType2,
+          typename Format>
+void multiply_transpose(omp::execution_policy<DerivedPolicy>& exec,
+                        const MatrixType& A,
+                        const VectorType1& x,
+                        VectorType2& y,
+                        Format format,
+                        thrust::detail::true_type)
+{
+    typedef typename VectorType2::value_type ValueType;
+
+    const int N = A.num_cols;
+    const int M = transpose_scatter_units(A, format);
+
+    #pragma omp parallel for
+    for(int j = 0; j < N; j++)
+        y[j] = ValueType(0);
+
+    if(N == 0) return;
+
+    const transpose_atomic_sink<ValueType> sink(thrust::raw_pointer_cast(&y[0]));
+
+    #pragma omp parallel for schedule(dynamic,64)
+    for(int i = 0; i < M; i++)
+        transpose_scatter(A, x, i, sink, format);
+}
+
+template <typename DerivedPolicy,
+          typename MatrixType,
+          typename VectorType1,
+          typename VectorType2,
+          typename Format>
+void multiply_transpose(omp::execution_policy<DerivedPolicy>& exec,
+                        const MatrixType& A,
+                        const VectorType1& x,
+                        VectorType2& y,
+                        Format format,
+                        thrust::detail::false_type)
+{
+    typedef typename VectorType2::value_type ValueType;
+
+    const int N = A.num_cols;
+    const int M = transpose_scatter_units(A, format);
+
+    if(N == 0) return;
+
+    const int num_chunks = std::max(1, std::min(omp_get_max_threads(), M));
+    const int chunk_size = cusp::detail::divide_into(M, num_chunks);
+
+    cusp::detail::temporary_array<ValueType, DerivedPolicy> partial(exec, size_t(num_chunks) * N, ValueType(0));
+
+    ValueType * partial_ptr = thrust::raw_pointer_cast(&partial[0]);
+
+    #pragma omp parallel for schedule(static, 1)
+    for(int c = 0; c < num_chunks; c++)
+    {
+        const int chunk_begin = std::min(M, c * chunk_size);
+        const int chunk_end   = std::min(M, chunk_begin + chunk_size);
+
+        const transpose_private_sink<ValueType> sink(partial_ptr + size_t(c) * N);
+
+        for(int i = chunk_begin; i < chunk_end; i++)
+            transpose_scatter(A, x, i, sink, format);
+    }
+
+    #pragma omp parallel for
+    for(int j = 0; j < N; j++)
+    {
+        ValueType sum(0);
+
+        for(int c = 0; c < num_chunks; c++)
+            sum += partial_ptr[size_t(c) * N + j];
+
+        y[j] = sum;
+    }
+}
+
+template <typename DerivedPolicy,
+          typename MatrixType,
+          typename VectorType1,
+          typename VectorType2>
+void multiply_transpose(omp::execution_policy<DerivedPolicy>& exec,
+                        const MatrixType& A,
+                        const VectorType1& x,
+                        VectorType2& y,
+                        cusp::coo_format format,
+                        cusp::array1d_format,
+                        cusp::array1d_format)
+{
+    typedef typename VectorType2::value_type ValueType;
+
+    multiply_transpose(exec, A, x, y, format, typename thrust::detail::is_arithmetic<ValueType>::type());
+}
+
+template <typename DerivedPolicy,
+          typename MatrixType,
+          typename VectorType1,
+          typename VectorType2>
+void multiply_transpose(omp::execution_policy<DerivedPolicy>& exec,
+                        const MatrixType& A,
+                        const VectorType1& x,
+                        VectorType2& y,
+                        cusp::csr_format format,
+                        cusp::array1d_format,
+                        cusp::array1d_format)
+{
+    typedef typename VectorType2::value_type ValueType;
+
+    multiply_transpose(exec, A, x, y, format, typename thrust::detail::is_arithmetic<ValueType>::type());
+}
+
+} // end namespace detail
+} // end namespace omp
+} // end namespace system
+} // end namespace cusp
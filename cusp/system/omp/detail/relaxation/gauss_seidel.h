@@ -32,6 +32,43 @@ namespace detail
 
 using cusp::system::detail::sequential::gauss_seidel_indexed;
 
+// the rows of a color are independent, so they are relaxed in parallel
+template<typename DerivedPolicy,
+         typename MatrixType,
+         typename ArrayType1,
+         typename ArrayType2,
+         typename ArrayType3>
+void gauss_seidel_multicolor(omp::execution_policy<DerivedPolicy>& exec,
+                             const MatrixType& C,
+                             const ArrayType1& diagonal,
+                             const ArrayType2& ordering,
+                                   ArrayType3& x,
+                             const ArrayType3& b,
+                             const int row_start,
+                             const int row_stop,
+                             const typename ArrayType3::value_type omega)
+{
+    typedef typename ArrayType3::value_type V;
+    typedef typename ArrayType2::value_type I;
+
+    #pragma omp parallel for schedule(static)
+    for(int r = row_start; r < row_stop; r++)
+    {
+        const V diag = diagonal[r];
+
+        if (diag == V(0))
+            continue;
+
+        const I i = ordering[r];
+        V rsum    = 0;
+
+        for(I jj = C.row_offsets[r]; jj < C.row_offsets[r + 1]; ++jj)
+            rsum += C.values[jj] * x[C.column_indices[jj]];
+
+        x[i] = (V(1) - omega) * x[i] + omega * (b[i] - rsum) / diag;
+    }
+}
+
 } // end namespace detail
 } // end namespace omp
 } // end namespace system
@@ -20,6 +20,9 @@
 
 // this system inherits sort
 #include <cusp/system/cpp/detail/sort.h>
+#include <cusp/system/detail/generic/sort.h>
+
+#include <cusp/system/omp/detail/execution_policy.h>
 
 namespace cusp
 {
@@ -33,6 +36,22 @@ namespace detail
 using cusp::system::detail::sequential::counting_sort;
 using cusp::system::detail::sequential::counting_sort_by_key;
 
+// the sequential counting sorts run on a single thread, packing (row,column)
+// pairs into a single key lets thrust's parallel sort do the work instead
+template <typename DerivedPolicy, typename ArrayType1, typename ArrayType2, typename ArrayType3>
+void stable_sort_by_row_and_column(omp::execution_policy<DerivedPolicy>& exec,
+                                   ArrayType1& row_indices, ArrayType2& column_indices, ArrayType3& values,
+                                   typename ArrayType1::value_type min_row,
+                                   typename ArrayType1::value_type max_row,
+                                   typename ArrayType2::value_type min_col,
+                                   typename ArrayType2::value_type max_col)
+{
+    if(!cusp::system::detail::generic::packed_sort_by_row_and_column(exec, row_indices, column_indices, values,
+                                                                      min_row, max_row, min_col, max_col))
+        cusp::system::detail::generic::stable_sort_by_row_and_column(exec, row_indices, column_indices, values,
+                                                                      min_row, max_row, min_col, max_col);
+}
+
 } // end namespace detail
 } // end namespace omp
 } // end namespace system
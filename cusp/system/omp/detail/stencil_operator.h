@@ -0,0 +1,88 @@
+/*
+ *  Copyright 2008-2014 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+
+#pragma once
+
+#include <cusp/detail/config.h>
+
+#include <cusp/system/detail/generic/stencil_operator.h>
+
+#include <cusp/system/omp/detail/execution_policy.h>
+
+#include <algorithm>
+
+namespace cusp
+{
+namespace system
+{
+namespace omp
+{
+namespace detail
+{
+
+// Every thread processes contiguous blocks of grid points. The grid
+// coordinates are decomposed once per block and advanced from point to
+// point, and the rows of x read by a block stay in cache while the
+// neighbors of consecutive points are visited.
+template <typename DerivedPolicy,
+          typename StencilOperator,
+          typename VectorType1,
+          typename VectorType2>
+void stencil_multiply(omp::execution_policy<DerivedPolicy>& exec,
+                      const StencilOperator& A,
+                      const VectorType1& x,
+                            VectorType2& y)
+{
+    typedef typename StencilOperator::index_type      IndexType;
+    typedef typename StencilOperator::descriptor_type Descriptor;
+    typedef typename VectorType1::value_type          XType;
+    typedef typename VectorType2::value_type          YType;
+
+    const IndexType BLOCK_SIZE = 1024;
+
+    const IndexType num_rows   = A.num_rows;
+    const IndexType num_blocks = (num_rows + BLOCK_SIZE - 1) / BLOCK_SIZE;
+
+    if(num_rows == 0)
+        return;
+
+    const Descriptor desc = A.descriptor();
+
+    const XType * x_ptr = thrust::raw_pointer_cast(&x[0]);
+    YType       * y_ptr = thrust::raw_pointer_cast(&y[0]);
+
+    #pragma omp parallel for schedule(static)
+    for(IndexType block = 0; block < num_blocks; block++)
+    {
+        const IndexType row_start = block * BLOCK_SIZE;
+        const IndexType row_end   = std::min(num_rows, row_start + BLOCK_SIZE);
+
+        IndexType coords[Descriptor::dimensions];
+        desc.coordinates(row_start, coords);
+
+        for(IndexType row = row_start; row < row_end; row++)
+        {
+            y_ptr[row] = desc.apply(row, coords, x_ptr);
+            desc.advance(coords);
+        }
+    }
+}
+
+} // end namespace detail
+} // end namespace omp
+} // end namespace system
+} // end namespace cusp
@@ -17,6 +17,15 @@
 #pragma once
 
 #include <cusp/detail/config.h>
+#include <cusp/detail/format.h>
+#include <cusp/detail/type_traits.h>
+
+#include <cusp/system/omp/detail/execution_policy.h>
+
+#include <algorithm>
+#include <vector>
+
+#include <omp.h>
 
 // this system inherits transpose
 #include <cusp/system/cpp/detail/transpose.h>
@@ -32,8 +41,238 @@ namespace detail
 
 using cusp::system::detail::sequential::transpose;
 
+// Parallel counting sort of the entries by column.  Every thread owns a
+// contiguous range of entries and counts them per column, the counts are
+// turned into one write position per (thread, column) so that the entries
+// of a thread follow those of the threads before it, and every thread
+// finally scatters its entries.  The entries of a column therefore keep
+// their input order, sorted rows stay sorted.  The counts take one entry
+// per thread and column, so fewer threads are used on wide matrices with
+// few entries.
+
+// number of threads for a transpose of num_entries entries in num_cols columns
+inline int transpose_num_threads(const size_t num_cols, const size_t num_entries)
+{
+    if(num_entries < 16384)
+        return 1;
+
+    const size_t max_threads = std::max(1, omp_get_max_threads());
+
+    // the counts of all threads hold at most four times the entries
+    return int(std::max<size_t>(1, std::min(max_threads, 4 * num_entries / std::max<size_t>(1, num_cols))));
+}
+
+// replaces counts[t * num_cols + col] by the position of the first entry
+// of thread t in column col and stores the column offsets in offsets
+template <typename Array1, typename Array2>
+void transpose_positions(Array1& counts, Array2& offsets,
+                         const int num_threads, const size_t num_cols)
+{
+    typedef typename Array1::value_type OffsetType;
+
+    // number of entries per column
+    #pragma omp parallel for
+    for(long col = 0; col < long(num_cols); col++)
+    {
+        OffsetType total = 0;
+
+        for(int t = 0; t < num_threads; t++)
+            total += counts[t * num_cols + col];
+
+        offsets[col + 1] = total;
+    }
+
+    // blocked scan of the column totals
+    const int    num_blocks = std::max(1, std::min(num_threads, int(num_cols)));
+    const size_t block_size = (num_cols + num_blocks - 1) / num_blocks;
+
+    std::vector<OffsetType> block_sums(num_blocks + 1, 0);
+
+    offsets[0] = 0;
+
+    #pragma omp parallel for num_threads(num_blocks)
+    for(int b = 0; b < num_blocks; b++)
+    {
+        const size_t first = std::min(num_cols, b * block_size);
+        const size_t last  = std::min(num_cols, first + block_size);
+
+        for(size_t col = first + 1; col < last; col++)
+            offsets[col + 1] += offsets[col];
+
+        block_sums[b + 1] = last > first ? OffsetType(offsets[last]) : OffsetType(0);
+    }
+
+    for(int b = 0; b < num_blocks; b++)
+        block_sums[b + 1] += block_sums[b];
+
+    #pragma omp parallel for num_threads(num_blocks)
+    for(int b = 1; b < num_blocks; b++)
+    {
+        const size_t first = std::min(num_cols, b * block_size);
+        const size_t last  = std::min(num_cols, first + block_size);
+
+        for(size_t col = first; col < last; col++)
+            offsets[col + 1] += block_sums[b];
+    }
+
+    // positions of the threads inside every column
+    #pragma omp parallel for
+    for(long col = 0; col < long(num_cols); col++)
+    {
+        OffsetType position = offsets[col];
+
+        for(int t = 0; t < num_threads; t++)
+        {
+            const OffsetType count = counts[t * num_cols + col];
+            counts[t * num_cols + col] = position;
+            position += count;
+        }
+    }
+}
+
+// COO format
+template <typename DerivedPolicy, typename MatrixType1, typename MatrixType2>
+void transpose(omp::execution_policy<DerivedPolicy>& exec,
+               const MatrixType1& A, MatrixType2& At,
+               cusp::coo_format, cusp::coo_format)
+{
+    typedef typename MatrixType2::index_type IndexType;
+
+    const size_t num_cols    = A.num_cols;
+    const size_t num_entries = A.num_entries;
+    const int    num_threads = transpose_num_threads(num_cols, num_entries);
+
+    if(num_threads == 1)
+    {
+        cusp::system::detail::sequential::transpose(exec, A, At, cusp::coo_format(), cusp::coo_format());
+        return;
+    }
+
+    At.resize(A.num_cols, A.num_rows, A.num_entries);
+
+    const size_t entries_per_thread = (num_entries + num_threads - 1) / num_threads;
+
+    std::vector<IndexType> counts(num_threads * num_cols);
+    std::vector<IndexType> offsets(num_cols + 1);
+
+    #pragma omp parallel for schedule(static, 1) num_threads(num_threads)
+    for(int t = 0; t < num_threads; t++)
+    {
+        IndexType * count = &counts[t * num_cols];
+
+        const size_t first = std::min(num_entries, t * entries_per_thread);
+        const size_t last  = std::min(num_entries, first + entries_per_thread);
+
+        for(size_t i = first; i < last; i++)
+            count[A.column_indices[i]]++;
+    }
+
+    transpose_positions(counts, offsets, num_threads, num_cols);
+
+    #pragma omp parallel for schedule(static, 1) num_threads(num_threads)
+    for(int t = 0; t < num_threads; t++)
+    {
+        IndexType * position = &counts[t * num_cols];
+
+        const size_t first = std::min(num_entries, t * entries_per_thread);
+        const size_t last  = std::min(num_entries, first + entries_per_thread);
+
+        for(size_t i = first; i < last; i++)
+        {
+            const IndexType j = position[A.column_indices[i]]++;
+
+            At.row_indices[j]    = A.column_indices[i];
+            At.column_indices[j] = A.row_indices[i];
+            At.values[j]         = A.values[i];
+        }
+    }
+}
+
+// CSR format
+template <typename DerivedPolicy, typename MatrixType1, typename MatrixType2>
+void transpose(omp::execution_policy<DerivedPolicy>& exec,
+               const MatrixType1& A, MatrixType2& At,
+               cusp::csr_format, cusp::csr_format)
+{
+    typedef typename MatrixType2::index_type                          IndexType;
+    typedef typename cusp::detail::get_offset_type<MatrixType2>::type OffsetType;
+
+    const size_t num_rows    = A.num_rows;
+    const size_t num_cols    = A.num_cols;
+    const size_t num_entries = A.num_entries;
+    const int    num_threads = transpose_num_threads(num_cols, num_entries);
+
+    if(num_threads == 1)
+    {
+        cusp::system::detail::sequential::transpose(exec, A, At, cusp::csr_format(), cusp::csr_format());
+        return;
+    }
+
+    At.resize(A.num_cols, A.num_rows, A.num_entries);
+
+    // rows of A split into ranges of about the same number of entries
+    std::vector<size_t> row_begin(num_threads + 1, num_rows);
+
+    row_begin[0] = 0;
+
+    for(int t = 1; t < num_threads; t++)
+    {
+        const size_t target = (num_entries * t) / num_threads;
+
+        size_t lower = row_begin[t - 1];
+        size_t upper = num_rows;
+
+        while(lower < upper)
+        {
+            const size_t middle = lower + (upper - lower) / 2;
+
+            if(size_t(A.row_offsets[middle]) < target)
+                lower = middle + 1;
+            else
+                upper = middle;
+        }
+
+        row_begin[t] = lower;
+    }
+
+    std::vector<OffsetType> counts(num_threads * num_cols);
+
+    #pragma omp parallel for schedule(static, 1) num_threads(num_threads)
+    for(int t = 0; t < num_threads; t++)
+    {
+        OffsetType * count = &counts[t * num_cols];
+
+        const size_t first = A.row_offsets[row_begin[t]];
+        const size_t last  = A.row_offsets[row_begin[t + 1]];
+
+        for(size_t i = first; i < last; i++)
+            count[A.column_indices[i]]++;
+    }
+
+    transpose_positions(counts, At.row_offsets, num_threads, num_cols);
+
+    #pragma omp parallel for schedule(static, 1) num_threads(num_threads)
+    for(int t = 0; t < num_threads; t++)
+    {
+        OffsetType * position = &counts[t * num_cols];
+
+        for(size_t row = row_begin[t]; row < row_begin[t + 1]; row++)
+        {
+            const size_t row_start = A.row_offsets[row];
+            const size_t row_end   = A.row_offsets[row + 1];
+
+            for(size_t i = row_start; i < row_end; i++)
+            {
+                const OffsetType j = position[A.column_indices[i]]++;
+
+                At.column_indices[j] = IndexType(row);
+                At.values[j]         = A.values[i];
+            }
+        }
+    }
+}
+
 } // end namespace detail
 } // end namespace omp
 } // end namespace system
 } // end namespace cusp
-
@@ -1,5 +1,5 @@
 /*
- *  Copyright 2008-2013 NVIDIA Corporation
+ *  Copyright 2008-2014 NVIDIA Corporation
  *
  *  Licensed under the Apache License, Version 2.0 (the "License");
  *  you may not use this file except in compliance with the License.
@@ -18,5 +18,88 @@
 
 #include <cusp/detail/config.h>
 
-// this system inherits transpose
-#include <cusp/system/cpp/detail/format_utils.h>
+#include <cusp/system/tbb/detail/execution_policy.h>
+#include <cusp/system/tbb/detail/multiply/csr_spmv.h>
+
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+
+#include <algorithm>
+
+namespace cusp
+{
+namespace system
+{
+namespace tbb
+{
+namespace detail
+{
+
+template <typename OffsetArray, typename IndexArray>
+struct offsets_to_indices_body
+{
+    typedef typename OffsetArray::value_type OffsetType;
+
+    const OffsetArray& offsets;
+    IndexArray&        indices;
+
+    offsets_to_indices_body(const OffsetArray& offsets, IndexArray& indices)
+        : offsets(offsets), indices(indices) {}
+
+    template <typename Range>
+    void operator()(const Range& r) const
+    {
+        for(size_t i = r.begin(); i < r.end(); i++)
+            for(OffsetType jj = offsets[i]; jj < offsets[i + 1]; jj++)
+                indices[jj] = i;
+    }
+};
+
+// the indices are sorted, so every offset is found by a binary search
+template <typename IndexArray, typename OffsetArray>
+struct indices_to_offsets_body
+{
+    typedef typename OffsetArray::value_type OffsetType;
+
+    const IndexArray& indices;
+    OffsetArray&      offsets;
+
+    indices_to_offsets_body(const IndexArray& indices, OffsetArray& offsets)
+        : indices(indices), offsets(offsets) {}
+
+    void operator()(const ::tbb::blocked_range<size_t>& r) const
+    {
+        for(size_t i = r.begin(); i < r.end(); i++)
+            offsets[i] = std::lower_bound(indices.begin(), indices.end(), OffsetType(i)) - indices.begin();
+    }
+};
+
+template <typename DerivedPolicy,
+          typename OffsetArray,
+          typename IndexArray>
+void offsets_to_indices(tbb::execution_policy<DerivedPolicy> &exec,
+                        const OffsetArray& offsets,
+                        IndexArray& indices)
+{
+    if(offsets.size() < 2)
+        return;
+
+    ::tbb::parallel_for(csr_row_range<OffsetArray>(offsets, 0, offsets.size() - 1),
+                        offsets_to_indices_body<OffsetArray,IndexArray>(offsets, indices));
+}
+
+template <typename DerivedPolicy,
+          typename IndexArray,
+          typename OffsetArray>
+void indices_to_offsets(tbb::execution_policy<DerivedPolicy> &exec,
+                        const IndexArray& indices,
+                        OffsetArray& offsets)
+{
+    ::tbb::parallel_for(::tbb::blocked_range<size_t>(0, offsets.size(), 1024),
+                        indices_to_offsets_body<IndexArray,OffsetArray>(indices, offsets));
+}
+
+} // end namespace detail
+} // end namespace tbb
+} // end namespace system
+} // end namespace cusp
@@ -18,5 +18,11 @@
 
 #include <cusp/detail/config.h>
 
+#include <cusp/system/tbb/detail/multiply/array2d_mm.h>
+#include <cusp/system/tbb/detail/multiply/coo_spmv.h>
+#include <cusp/system/tbb/detail/multiply/csr_spmv.h>
+#include <cusp/system/tbb/detail/multiply/coo_spgemm.h>
+#include <cusp/system/tbb/detail/multiply/csr_spgemm.h>
+
 // this system inherits multiply
 #include <cusp/system/cpp/detail/multiply.h>
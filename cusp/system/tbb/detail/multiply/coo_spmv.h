@@ -0,0 +1,196 @@
+/*
+ *  Copyright 2008-2014 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#pragma once
+
+#include <cusp/detail/config.h>
+#include <cusp/detail/format.h>
+
+#include <cusp/system/tbb/detail/execution_policy.h>
+
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+
+#include <algorithm>
+#include <cstddef>
+
+namespace cusp
+{
+namespace system
+{
+namespace tbb
+{
+namespace detail
+{
+
+// A range of COO entries, sorted by row, which is only split at row
+// boundaries so that every row is reduced by a single task.  An entry
+// range holding a single row is not divisible.
+template <typename IndexArray>
+class coo_entry_range
+{
+public:
+
+    coo_entry_range(const IndexArray& row_indices,
+                    const size_t entry_begin, const size_t entry_end,
+                    const size_t grainsize = 2048)
+        : row_indices(&row_indices),
+          entry_begin(entry_begin), entry_end(entry_end),
+          grainsize(grainsize) {}
+
+    coo_entry_range(coo_entry_range& other, ::tbb::split)
+        : row_indices(other.row_indices),
+          entry_begin(other.split_point()), entry_end(other.entry_end),
+          grainsize(other.grainsize)
+    {
+        other.entry_end = entry_begin;
+    }
+
+    bool empty(void) const
+    {
+        return entry_begin >= entry_end;
+    }
+
+    bool is_divisible(void) const
+    {
+        return entry_end - entry_begin > grainsize &&
+               (*row_indices)[entry_begin] != (*row_indices)[entry_end - 1];
+    }
+
+    size_t begin(void) const
+    {
+        return entry_begin;
+    }
+
+    size_t end(void) const
+    {
+        return entry_end;
+    }
+
+private:
+
+    const IndexArray* row_indices;
+    size_t entry_begin;
+    size_t entry_end;
+    size_t grainsize;
+
+    // first entry of the row holding the middle entry, or of the next row
+    // if the middle row starts the range
+    size_t split_point(void) const
+    {
+        typedef typename IndexArray::const_iterator Iterator;
+
+        const Iterator first  = row_indices->begin() + entry_begin;
+        const Iterator last   = row_indices->begin() + entry_end;
+        const Iterator middle = first + (entry_end - entry_begin) / 2;
+
+        Iterator split = std::lower_bound(first, last, *middle);
+
+        if(split == first)
+            split = std::upper_bound(first, last, *middle);
+
+        return entry_begin + (split - first);
+    }
+};
+
+template <typename VectorType, typename UnaryFunction>
+struct coo_spmv_initialize_body
+{
+    VectorType&   y;
+    UnaryFunction initialize;
+
+    coo_spmv_initialize_body(VectorType& y, UnaryFunction initialize)
+        : y(y), initialize(initialize) {}
+
+    void operator()(const ::tbb::blocked_range<size_t>& r) const
+    {
+        for(size_t i = r.begin(); i < r.end(); i++)
+            y[i] = initialize(y[i]);
+    }
+};
+
+template <typename MatrixType,
+          typename VectorType1,
+          typename VectorType2,
+          typename BinaryFunction1,
+          typename BinaryFunction2>
+struct coo_spmv_body
+{
+    typedef typename MatrixType::index_type  IndexType;
+    typedef typename VectorType2::value_type ValueType;
+
+    const MatrixType&  A;
+    const VectorType1& x;
+    VectorType2&       y;
+    BinaryFunction1    combine;
+    BinaryFunction2    reduce;
+
+    coo_spmv_body(const MatrixType& A, const VectorType1& x, VectorType2& y,
+                  BinaryFunction1 combine, BinaryFunction2 reduce)
+        : A(A), x(x), y(y), combine(combine), reduce(reduce) {}
+
+    template <typename Range>
+    void operator()(const Range& r) const
+    {
+        for(size_t n = r.begin(); n < r.end(); n++)
+        {
+            const IndexType i = A.row_indices[n];
+            const IndexType j = A.column_indices[n];
+
+            y[i] = reduce(y[i], combine(A.values[n], x[j]));
+        }
+    }
+};
+
+template <typename DerivedPolicy,
+          typename MatrixType,
+          typename VectorType1,
+          typename VectorType2,
+          typename UnaryFunction,
+          typename BinaryFunction1,
+          typename BinaryFunction2>
+void multiply(tbb::execution_policy<DerivedPolicy>& exec,
+              const MatrixType& A,
+              const VectorType1& x,
+              VectorType2& y,
+              UnaryFunction   initialize,
+              BinaryFunction1 combine,
+              BinaryFunction2 reduce,
+              cusp::coo_format,
+              cusp::array1d_format,
+              cusp::array1d_format)
+{
+    typedef typename MatrixType::row_indices_array_type RowIndices;
+
+    if(A.num_rows == 0)
+        return;
+
+    ::tbb::parallel_for(::tbb::blocked_range<size_t>(0, A.num_rows, 4096),
+                        coo_spmv_initialize_body<VectorType2,UnaryFunction>(y, initialize));
+
+    if(A.num_entries == 0)
+        return;
+
+    ::tbb::parallel_for(coo_entry_range<RowIndices>(A.row_indices, 0, A.num_entries),
+                        coo_spmv_body<MatrixType,VectorType1,VectorType2,
+                                      BinaryFunction1,BinaryFunction2>
+                                      (A, x, y, combine, reduce));
+}
+
+} // end namespace detail
+} // end namespace tbb
+} // end namespace system
+} // end namespace cusp
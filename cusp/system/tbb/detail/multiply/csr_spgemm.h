@@ -0,0 +1,310 @@
+/*
+ *  Copyright 2008-2014 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#pragma once
+
+#include <cusp/detail/config.h>
+#include <cusp/detail/format.h>
+#include <cusp/detail/temporary_array.h>
+
+#include <cusp/system/tbb/detail/execution_policy.h>
+#include <cusp/system/tbb/detail/multiply/csr_spmv.h>
+
+#include <thrust/copy.h>
+#include <thrust/fill.h>
+#include <thrust/scan.h>
+
+#include <tbb/enumerable_thread_specific.h>
+#include <tbb/parallel_for.h>
+
+#include <algorithm>
+#include <vector>
+
+namespace cusp
+{
+namespace system
+{
+namespace tbb
+{
+namespace detail
+{
+
+// Both passes split the rows of A into tasks of similar numbers of entries
+// with csr_row_range and process every row with a dense accumulator over
+// the columns of C.  Every worker thread owns one lazily created
+// accumulator, so the multiplication composes with an enclosing TBB
+// parallel algorithm without oversubscription.  The first pass counts the
+// entries of every row of C, the second pass writes them in ascending
+// column order.  Explicit zeros are kept.
+template <typename IndexType, typename ValueType>
+struct spmm_csr_accumulator
+{
+    std::vector<IndexType> next;
+    std::vector<ValueType> sums;
+    std::vector<IndexType> columns;
+
+    spmm_csr_accumulator(const size_t num_cols)
+        : next(num_cols, unseen()), sums(num_cols, ValueType(0)) {}
+
+    static IndexType unseen(void)
+    {
+        return static_cast<IndexType>(-1);
+    }
+};
+
+template <typename Array1, typename Array2, typename Array3, typename Array4,
+          typename Array5, typename Marks>
+struct spmm_csr_count_body
+{
+    typedef typename Array5::value_type IndexType;
+
+    const Array1& A_row_offsets;
+    const Array2& A_column_indices;
+    const Array3& B_row_offsets;
+    const Array4& B_column_indices;
+    Array5&       C_row_offsets;
+    Marks&        marks;
+
+    spmm_csr_count_body(const Array1& A_row_offsets, const Array2& A_column_indices,
+                        const Array3& B_row_offsets, const Array4& B_column_indices,
+                        Array5& C_row_offsets, Marks& marks)
+        : A_row_offsets(A_row_offsets), A_column_indices(A_column_indices),
+          B_row_offsets(B_row_offsets), B_column_indices(B_column_indices),
+          C_row_offsets(C_row_offsets), marks(marks) {}
+
+    template <typename Range>
+    void operator()(const Range& r) const
+    {
+        // the mark of a column is the last row it was seen in
+        IndexType* mark = &marks.local()[0];
+
+        for(size_t i = r.begin(); i < r.end(); i++)
+        {
+            IndexType num_entries = 0;
+
+            for(IndexType jj = A_row_offsets[i]; jj < A_row_offsets[i + 1]; jj++)
+            {
+                const IndexType j = A_column_indices[jj];
+
+                for(IndexType kk = B_row_offsets[j]; kk < B_row_offsets[j + 1]; kk++)
+                {
+                    const IndexType k = B_column_indices[kk];
+
+                    if(mark[k] != IndexType(i))
+                    {
+                        mark[k] = i;
+                        num_entries++;
+                    }
+                }
+            }
+
+            C_row_offsets[i + 1] = num_entries;
+        }
+    }
+};
+
+template <typename Array1, typename Array2, typename Array3,
+          typename Array4, typename Array5, typename Array6,
+          typename Array7, typename Array8, typename Array9,
+          typename BinaryFunction1, typename BinaryFunction2, typename Accumulators>
+struct spmm_csr_fill_body
+{
+    typedef typename Array7::value_type IndexType;
+    typedef typename Array9::value_type ValueType;
+
+    const Array1& A_row_offsets;
+    const Array2& A_column_indices;
+    const Array3& A_values;
+    const Array4& B_row_offsets;
+    const Array5& B_column_indices;
+    const Array6& B_values;
+    const Array7& C_row_offsets;
+    Array8&       C_column_indices;
+    Array9&       C_values;
+    BinaryFunction1 combine;
+    BinaryFunction2 reduce;
+    Accumulators& accumulators;
+
+    spmm_csr_fill_body(const Array1& A_row_offsets, const Array2& A_column_indices, const Array3& A_values,
+                       const Array4& B_row_offsets, const Array5& B_column_indices, const Array6& B_values,
+                       const Array7& C_row_offsets, Array8& C_column_indices, Array9& C_values,
+                       BinaryFunction1 combine, BinaryFunction2 reduce, Accumulators& accumulators)
+        : A_row_offsets(A_row_offsets), A_column_indices(A_column_indices), A_values(A_values),
+          B_row_offsets(B_row_offsets), B_column_indices(B_column_indices), B_values(B_values),
+          C_row_offsets(C_row_offsets), C_column_indices(C_column_indices), C_values(C_values),
+          combine(combine), reduce(reduce), accumulators(accumulators) {}
+
+    template <typename Range>
+    void operator()(const Range& r) const
+    {
+        typename Accumulators::reference accumulator = accumulators.local();
+
+        IndexType* next = &accumulator.next[0];
+        ValueType* sums = &accumulator.sums[0];
+        std::vector<IndexType>& columns = accumulator.columns;
+
+        const IndexType unseen = accumulator.unseen();
+
+        for(size_t i = r.begin(); i < r.end(); i++)
+        {
+            columns.clear();
+
+            for(IndexType jj = A_row_offsets[i]; jj < A_row_offsets[i + 1]; jj++)
+            {
+                const IndexType j = A_column_indices[jj];
+                const ValueType v = A_values[jj];
+
+                for(IndexType kk = B_row_offsets[j]; kk < B_row_offsets[j + 1]; kk++)
+                {
+                    const IndexType k = B_column_indices[kk];
+
+                    sums[k] = reduce(sums[k], combine(v, B_values[kk]));
+
+                    if(next[k] == unseen)
+                    {
+                        next[k] = k;
+                        columns.push_back(k);
+                    }
+                }
+            }
+
+            std::sort(columns.begin(), columns.end());
+
+            const IndexType offset = C_row_offsets[i];
+
+            for(size_t n = 0; n < columns.size(); n++)
+            {
+                const IndexType k = columns[n];
+
+                C_column_indices[offset + n] = k;
+                C_values[offset + n]         = sums[k];
+
+                next[k] = unseen;
+                sums[k] = ValueType(0);
+            }
+        }
+    }
+};
+
+template <typename DerivedPolicy,
+          typename Array1, typename Array2,
+          typename Array3, typename Array4,
+          typename Array5>
+size_t spmm_csr_pass1(tbb::execution_policy<DerivedPolicy>& exec,
+                      const size_t num_rows, const size_t num_cols,
+                      const Array1& A_row_offsets, const Array2& A_column_indices,
+                      const Array3& B_row_offsets, const Array4& B_column_indices,
+                      Array5& C_row_offsets)
+{
+    typedef typename Array5::value_type IndexType;
+    typedef ::tbb::enumerable_thread_specific< std::vector<IndexType> > Marks;
+
+    if(num_rows == 0 || num_cols == 0)
+    {
+        thrust::fill(exec, C_row_offsets.begin(), C_row_offsets.begin() + num_rows + 1, IndexType(0));
+        return 0;
+    }
+
+    C_row_offsets[0] = 0;
+
+    Marks marks(std::vector<IndexType>(num_cols, static_cast<IndexType>(-1)));
+
+    ::tbb::parallel_for(csr_row_range<Array1>(A_row_offsets, 0, num_rows),
+                        spmm_csr_count_body<Array1,Array2,Array3,Array4,Array5,Marks>
+                                           (A_row_offsets, A_column_indices,
+                                            B_row_offsets, B_column_indices,
+                                            C_row_offsets, marks));
+
+    thrust::inclusive_scan(exec, C_row_offsets.begin(), C_row_offsets.begin() + num_rows + 1,
+                           C_row_offsets.begin());
+
+    return C_row_offsets[num_rows];
+}
+
+template <typename DerivedPolicy,
+          typename Array1, typename Array2, typename Array3,
+          typename Array4, typename Array5, typename Array6,
+          typename Array7, typename Array8, typename Array9,
+          typename UnaryFunction, typename BinaryFunction1, typename BinaryFunction2>
+void spmm_csr_pass2(tbb::execution_policy<DerivedPolicy>& exec,
+                    const size_t num_rows, const size_t num_cols,
+                    const Array1& A_row_offsets, const Array2& A_column_indices, const Array3& A_values,
+                    const Array4& B_row_offsets, const Array5& B_column_indices, const Array6& B_values,
+                    const Array7& C_row_offsets, Array8& C_column_indices,       Array9& C_values,
+                    UnaryFunction initialize,    BinaryFunction1 combine,        BinaryFunction2 reduce)
+{
+    typedef typename Array7::value_type IndexType;
+    typedef typename Array9::value_type ValueType;
+    typedef spmm_csr_accumulator<IndexType, ValueType> Accumulator;
+    typedef ::tbb::enumerable_thread_specific<Accumulator> Accumulators;
+
+    if(num_rows == 0 || num_cols == 0)
+        return;
+
+    Accumulators accumulators((Accumulator(num_cols)));
+
+    ::tbb::parallel_for(csr_row_range<Array1>(A_row_offsets, 0, num_rows),
+                        spmm_csr_fill_body<Array1,Array2,Array3,Array4,Array5,Array6,Array7,Array8,Array9,
+                                           BinaryFunction1,BinaryFunction2,Accumulators>
+                                          (A_row_offsets, A_column_indices, A_values,
+                                           B_row_offsets, B_column_indices, B_values,
+                                           C_row_offsets, C_column_indices, C_values,
+                                           combine, reduce, accumulators));
+}
+
+template <typename DerivedPolicy,
+          typename MatrixType1,
+          typename MatrixType2,
+          typename MatrixType3,
+          typename UnaryFunction,
+          typename BinaryFunction1,
+          typename BinaryFunction2>
+void multiply(tbb::execution_policy<DerivedPolicy>& exec,
+              const MatrixType1& A,
+              const MatrixType2& B,
+              MatrixType3& C,
+              UnaryFunction   initialize,
+              BinaryFunction1 combine,
+              BinaryFunction2 reduce,
+              cusp::csr_format,
+              cusp::csr_format,
+              cusp::csr_format)
+{
+    typedef typename MatrixType3::index_type IndexType;
+
+    cusp::detail::temporary_array<IndexType, DerivedPolicy> C_row_offsets(exec, A.num_rows + 1);
+
+    size_t num_nonzeros =
+        spmm_csr_pass1(exec, A.num_rows, B.num_cols,
+                       A.row_offsets, A.column_indices,
+                       B.row_offsets, B.column_indices,
+                       C_row_offsets);
+
+    C.resize(A.num_rows, B.num_cols, num_nonzeros);
+
+    thrust::copy(exec, C_row_offsets.begin(), C_row_offsets.end(), C.row_offsets.begin());
+
+    spmm_csr_pass2(exec, A.num_rows, B.num_cols,
+                   A.row_offsets, A.column_indices, A.values,
+                   B.row_offsets, B.column_indices, B.values,
+                   C.row_offsets, C.column_indices, C.values,
+                   initialize, combine, reduce);
+}
+
+} // end namespace detail
+} // end namespace tbb
+} // end namespace system
+} // end namespace cusp
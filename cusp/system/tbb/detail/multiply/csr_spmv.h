@@ -0,0 +1,192 @@
+/*
+ *  Copyright 2008-2014 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#pragma once
+
+#include <cusp/detail/config.h>
+#include <cusp/detail/format.h>
+
+#include <cusp/system/tbb/detail/execution_policy.h>
+
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+
+#include <cstddef>
+
+namespace cusp
+{
+namespace system
+{
+namespace tbb
+{
+namespace detail
+{
+
+// A range of CSR rows which TBB splits into halves of equal work, where
+// the work of a row is one unit plus the number of its entries.  Long rows
+// therefore end up in small subranges and short rows in large ones, while
+// the scheduler remains free to steal and nest.  A single row is never
+// split.
+template <typename OffsetArray>
+class csr_row_range
+{
+public:
+
+    csr_row_range(const OffsetArray& row_offsets,
+                  const size_t row_begin, const size_t row_end,
+                  const size_t grainsize = 2048)
+        : row_offsets(&row_offsets),
+          row_begin(row_begin), row_end(row_end),
+          grainsize(grainsize) {}
+
+    csr_row_range(csr_row_range& other, ::tbb::split)
+        : row_offsets(other.row_offsets),
+          row_begin(other.split_point()), row_end(other.row_end),
+          grainsize(other.grainsize)
+    {
+        other.row_end = row_begin;
+    }
+
+    bool empty(void) const
+    {
+        return row_begin >= row_end;
+    }
+
+    bool is_divisible(void) const
+    {
+        return row_end - row_begin > 1 && work(row_begin, row_end) > grainsize;
+    }
+
+    size_t begin(void) const
+    {
+        return row_begin;
+    }
+
+    size_t end(void) const
+    {
+        return row_end;
+    }
+
+private:
+
+    const OffsetArray* row_offsets;
+    size_t row_begin;
+    size_t row_end;
+    size_t grainsize;
+
+    size_t work(const size_t first, const size_t last) const
+    {
+        return (last - first) + size_t((*row_offsets)[last] - (*row_offsets)[first]);
+    }
+
+    // first row at which half of the work is done, in (row_begin, row_end)
+    size_t split_point(void) const
+    {
+        const size_t target = work(row_begin, row_end) / 2;
+
+        size_t first = row_begin + 1;
+        size_t last  = row_end - 1;
+
+        while(first < last)
+        {
+            const size_t middle = first + (last - first) / 2;
+
+            if(work(row_begin, middle) < target)
+                first = middle + 1;
+            else
+                last = middle;
+        }
+
+        return first;
+    }
+};
+
+template <typename MatrixType,
+          typename VectorType1,
+          typename VectorType2,
+          typename UnaryFunction,
+          typename BinaryFunction1,
+          typename BinaryFunction2>
+struct csr_spmv_body
+{
+    typedef typename MatrixType::index_type  IndexType;
+    typedef typename VectorType2::value_type ValueType;
+
+    const MatrixType&  A;
+    const VectorType1& x;
+    VectorType2&       y;
+    UnaryFunction      initialize;
+    BinaryFunction1    combine;
+    BinaryFunction2    reduce;
+
+    csr_spmv_body(const MatrixType& A, const VectorType1& x, VectorType2& y,
+                  UnaryFunction initialize, BinaryFunction1 combine, BinaryFunction2 reduce)
+        : A(A), x(x), y(y), initialize(initialize), combine(combine), reduce(reduce) {}
+
+    template <typename Range>
+    void operator()(const Range& r) const
+    {
+        for(size_t i = r.begin(); i < r.end(); i++)
+        {
+            const IndexType row_start = A.row_offsets[i];
+            const IndexType row_end   = A.row_offsets[i + 1];
+
+            ValueType accumulator = initialize(y[i]);
+
+            for(IndexType jj = row_start; jj < row_end; jj++)
+            {
+                const IndexType j = A.column_indices[jj];
+                accumulator = reduce(accumulator, combine(A.values[jj], x[j]));
+            }
+
+            y[i] = accumulator;
+        }
+    }
+};
+
+template <typename DerivedPolicy,
+          typename MatrixType,
+          typename VectorType1,
+          typename VectorType2,
+          typename UnaryFunction,
+          typename BinaryFunction1,
+          typename BinaryFunction2>
+void multiply(tbb::execution_policy<DerivedPolicy>& exec,
+              const MatrixType& A,
+              const VectorType1& x,
+              VectorType2& y,
+              UnaryFunction   initialize,
+              BinaryFunction1 combine,
+              BinaryFunction2 reduce,
+              cusp::csr_format,
+              cusp::array1d_format,
+              cusp::array1d_format)
+{
+    typedef typename MatrixType::row_offsets_array_type RowOffsets;
+
+    if(A.num_rows == 0)
+        return;
+
+    ::tbb::parallel_for(csr_row_range<RowOffsets>(A.row_offsets, 0, A.num_rows),
+                        csr_spmv_body<MatrixType,VectorType1,VectorType2,
+                                      UnaryFunction,BinaryFunction1,BinaryFunction2>
+                                      (A, x, y, initialize, combine, reduce));
+}
+
+} // end namespace detail
+} // end namespace tbb
+} // end namespace system
+} // end namespace cusp
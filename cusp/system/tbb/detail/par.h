@@ -18,6 +18,8 @@
 
 #include <cusp/detail/config.h>
 #include <cusp/system/tbb/detail/execution_policy.h>
+#include <cusp/system/detail/compensated/execution_policy.h>
+#include <cusp/system/detail/profiling/execution_policy.h>
 #include <cusp/system/cpp/detail/par.h>
 
 #include <thrust/detail/execute_with_allocator.h>
@@ -43,6 +45,20 @@ struct par_t : public cusp::system::tbb::detail::execution_policy<par_t>
   {
     return thrust::detail::execute_with_allocator<Allocator, cusp::system::tbb::detail::execution_policy>(alloc);
   }
+
+  // policy whose dot, dotc and nrm2 use compensated double accumulation
+  inline cusp::system::detail::compensated::execute_compensated<cusp::system::tbb::detail::execution_policy>
+    compensated() const
+  {
+    return cusp::system::detail::compensated::execute_compensated<cusp::system::tbb::detail::execution_policy>();
+  }
+
+  // policy recording the calls of cusp functions and their timings in log
+  inline cusp::system::detail::profiling::execute_profiling<cusp::system::tbb::detail::execution_policy>
+    profiling(cusp::profiling_log& log) const
+  {
+    return cusp::system::detail::profiling::execute_profiling<cusp::system::tbb::detail::execution_policy>(log);
+  }
 };
 
 // overloads of select_system
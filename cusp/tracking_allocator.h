@@ -0,0 +1,121 @@
+/*
+ *  Copyright 2008-2014 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+
+/*! \file tracking_allocator.h
+ *  \brief Allocator recording its allocations with the memory tracker
+ */
+
+#pragma once
+
+#include <cusp/detail/config.h>
+
+#include <cstddef>
+
+// Tracking is compiled in when CUSP_MEMORY_TRACKING is 1, the containers
+// then allocate through tracking_allocator. Otherwise the queries of
+// <cusp/memory_tracker.h> return zeros and scopes are empty objects.
+#ifndef CUSP_MEMORY_TRACKING
+#define CUSP_MEMORY_TRACKING 0
+#endif
+
+namespace cusp
+{
+namespace detail
+{
+
+// defined in <cusp/memory_tracker.h>
+template <typename MemorySpace> void record_allocation(const size_t num_bytes);
+template <typename MemorySpace> void record_deallocation(const size_t num_bytes);
+template <typename MemorySpace> void record_failed_allocation(const size_t num_bytes);
+
+} // end namespace detail
+
+/*! \addtogroup utilities Utilities
+ *  \{
+ */
+
+/**
+ * \brief Allocator recording the allocations of another allocator
+ *
+ * \tparam Allocator allocator performing the allocations
+ * \tparam MemorySpace memory space the allocations are recorded under
+ *
+ * \par Overview
+ *  With \c CUSP_MEMORY_TRACKING defined to 1 before the first cusp header,
+ *  \c default_memory_allocator wraps the allocator of every memory space
+ *  in a \p tracking_allocator, so the storage of all containers is
+ *  recorded and attributed to the active operations, see
+ *  \p cusp::memory_usage in \p <cusp/memory_tracker.h>. Temporary storage
+ *  which algorithms allocate through their execution policy is not
+ *  recorded. Every allocation and release takes a process-wide lock.
+ */
+template <typename Allocator, typename MemorySpace>
+class tracking_allocator : public Allocator
+{
+private:
+
+    typedef Allocator Parent;
+
+public:
+
+    /*! \cond */
+    typedef typename Allocator::value_type value_type;
+    typedef typename Allocator::pointer    pointer;
+    typedef typename Allocator::size_type  size_type;
+
+    template <typename U>
+    struct rebind
+    {
+        typedef tracking_allocator<typename Allocator::template rebind<U>::other, MemorySpace> other;
+    };
+    /*! \endcond */
+
+    /*! Construct a \p tracking_allocator.
+     */
+    tracking_allocator(void) {}
+
+    /*! Copy constructor.
+     */
+    tracking_allocator(const tracking_allocator& other) : Parent(other) {}
+
+    /*! Converting constructor from a \p tracking_allocator of another type.
+     */
+    template <typename OtherAllocator>
+    tracking_allocator(const tracking_allocator<OtherAllocator,MemorySpace>& other)
+        : Parent(static_cast<const OtherAllocator&>(other)) {}
+
+    /*! Allocate storage for \p num_elements elements and record it. A
+     *  failed allocation is recorded before the exception propagates.
+     *
+     *  \param num_elements Number of elements to allocate.
+     *  \return Pointer to the storage, which holds no constructed elements.
+     */
+    pointer allocate(size_type num_elements);
+
+    /*! Record the release of storage returned by \p allocate and release it.
+     *
+     *  \param ptr Pointer returned by \p allocate.
+     *  \param num_elements Number of elements passed to \p allocate.
+     */
+    void deallocate(pointer ptr, size_type num_elements);
+};
+/*! \}
+ */
+
+} // end namespace cusp
+
+#include <cusp/detail/tracking_allocator.inl>
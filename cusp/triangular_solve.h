@@ -0,0 +1,225 @@
+/*
+ *  Copyright 2008-2014 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*! \file triangular_solve.h
+ *  \brief Sparse triangular solves for CSR matrices.
+ */
+
+#pragma once
+
+#include <cusp/detail/config.h>
+
+#include <cusp/array1d.h>
+
+#include <cusp/detail/execution_policy.h>
+
+#include <vector>
+
+namespace cusp
+{
+
+/*! \addtogroup algorithms Algorithms
+ *  \addtogroup matrix_algorithms Matrix Algorithms
+ *  \ingroup algorithms
+ *  \{
+ */
+
+/**
+ * \brief Structure of a sparse triangular solve for repeated evaluation
+ *
+ * \tparam IndexType Type used for indices (e.g. \c int).
+ * \tparam MemorySpace A memory space (e.g. \c cusp::host_memory or \c cusp::device_memory)
+ *
+ * \par Overview
+ *  A \p triangular_solve_plan is produced by \p triangular_solve_analysis
+ *  and groups the rows of a triangular matrix into levels. The rows of a
+ *  level only depend on rows of earlier levels, so \p triangular_solve
+ *  processes each level in parallel. The plan is only valid for the
+ *  sparsity pattern it was computed with.
+ */
+template <typename IndexType, typename MemorySpace>
+struct triangular_solve_plan
+{
+    /*! \cond */
+    typedef IndexType   index_type;
+    typedef MemorySpace memory_space;
+    /*! \endcond */
+
+    /*! Shape of the solve, \c true for the lower triangle and for an
+     *  implicit unit diagonal respectively.
+     */
+    bool lower;
+    bool unit_diagonal;
+
+    /*! Number of rows and entries of the matrix the plan was computed for.
+     */
+    size_t num_rows;
+    size_t num_entries;
+
+    /*! Rows ordered by level, the rows of level \c l are
+     *  <tt>rows[level_offsets[l], level_offsets[l+1])</tt>.
+     */
+    cusp::array1d<IndexType,MemorySpace> rows;
+    std::vector<IndexType> level_offsets;
+
+    /*! Position of the diagonal entry of every row, empty for an implicit
+     *  unit diagonal.
+     */
+    cusp::array1d<IndexType,MemorySpace> diagonal_indices;
+
+    /*! Construct an empty \p triangular_solve_plan.
+     */
+    triangular_solve_plan(void)
+        : lower(true), unit_diagonal(false), num_rows(0), num_entries(0) {}
+
+    /*! Construct a \p triangular_solve_plan from another plan, possibly in
+     *  a different memory space.
+     */
+    template <typename MemorySpace2>
+    triangular_solve_plan(const triangular_solve_plan<IndexType,MemorySpace2>& plan)
+        : lower(plan.lower), unit_diagonal(plan.unit_diagonal),
+          num_rows(plan.num_rows), num_entries(plan.num_entries),
+          rows(plan.rows), level_offsets(plan.level_offsets),
+          diagonal_indices(plan.diagonal_indices) {}
+
+    /*! Number of levels, the number of parallel steps of a solve.
+     */
+    size_t num_levels(void) const
+    {
+        return level_offsets.empty() ? 0 : level_offsets.size() - 1;
+    }
+};
+
+/*! \cond */
+template <typename DerivedPolicy,
+          typename MatrixType,
+          typename PlanType>
+void triangular_solve_analysis(const thrust::detail::execution_policy_base<DerivedPolicy>& exec,
+                               const MatrixType& A,
+                                     PlanType& plan,
+                               const bool lower = true,
+                               const bool unit_diagonal = false);
+/*! \endcond */
+
+/**
+ * \brief Computes the levels of a sparse triangular solve
+ *
+ * \par Overview
+ *
+ * \p triangular_solve_analysis records in \p plan the level of every row
+ * of the lower (or upper) triangle of the \p csr_matrix \c A. The level of
+ * a row is one more than the largest level of the rows it depends on. The
+ * levels are computed on the host in a single pass over the pattern, the
+ * plan itself lives in \c PlanType::memory_space. Entries on the other side
+ * of the diagonal are ignored, so one matrix holding both triangles (as an
+ * ILU factorization does) may be analyzed twice.
+ *
+ * Unless \p unit_diagonal is set, every row must contain its diagonal
+ * entry, otherwise an \p invalid_input_exception is thrown. The column
+ * indices of \c A need not be sorted.
+ *
+ * \tparam MatrixType Type of matrix, \p csr_matrix or \p csr_matrix_view
+ * \tparam PlanType Type of \p triangular_solve_plan
+ *
+ * \param A triangular matrix
+ * \param plan structure of the solve
+ * \param lower \c true for the lower, \c false for the upper triangle
+ * \param unit_diagonal \c true if the diagonal is one and not stored
+ *
+ * \par Example
+ *
+ *  \code
+ *  #include <cusp/csr_matrix.h>
+ *  #include <cusp/triangular_solve.h>
+ *  #include <cusp/gallery/poisson.h>
+ *
+ *  int main(void)
+ *  {
+ *      cusp::csr_matrix<int,float,cusp::device_memory> A;
+ *      cusp::gallery::poisson5pt(A, 100, 100);
+ *
+ *      cusp::array1d<float,cusp::device_memory> b(A.num_rows, 1);
+ *      cusp::array1d<float,cusp::device_memory> x(A.num_rows);
+ *
+ *      // solve with the lower triangle of A, L x = b
+ *      cusp::triangular_solve_plan<int,cusp::device_memory> plan;
+ *      cusp::triangular_solve_analysis(A, plan, true);
+ *      cusp::triangular_solve(A, b, x, plan);
+ *
+ *      return 0;
+ *  }
+ *  \endcode
+ *
+ * \see \p triangular_solve
+ */
+template <typename MatrixType,
+          typename PlanType>
+void triangular_solve_analysis(const MatrixType& A,
+                                     PlanType& plan,
+                               const bool lower = true,
+                               const bool unit_diagonal = false);
+
+/*! \cond */
+template <typename DerivedPolicy,
+          typename MatrixType,
+          typename ArrayType1,
+          typename ArrayType2,
+          typename PlanType>
+void triangular_solve(const thrust::detail::execution_policy_base<DerivedPolicy>& exec,
+                      const MatrixType& A,
+                      const ArrayType1& b,
+                            ArrayType2& x,
+                      const PlanType& plan);
+/*! \endcond */
+
+/**
+ * \brief Solves a sparse triangular system
+ *
+ * \par Overview
+ *
+ * \p triangular_solve computes <tt>x = T^-1 b</tt> where \c T is the lower
+ * or upper triangle of \c A described by \p plan, one parallel step per
+ * level. \c A must have the pattern \p plan was computed for, its values
+ * may differ. An \p invalid_input_exception is thrown if the number of
+ * rows or entries of \c A differs from the plan. \p b and \p x may be the
+ * same array.
+ *
+ * \tparam MatrixType Type of matrix, \p csr_matrix or \p csr_matrix_view
+ * \tparam ArrayType1 Type of right hand side
+ * \tparam ArrayType2 Type of solution
+ * \tparam PlanType Type of \p triangular_solve_plan
+ *
+ * \param A triangular matrix
+ * \param b right hand side
+ * \param x solution
+ * \param plan structure of the solve
+ *
+ * \see \p triangular_solve_analysis
+ */
+template <typename MatrixType,
+          typename ArrayType1,
+          typename ArrayType2,
+          typename PlanType>
+void triangular_solve(const MatrixType& A,
+                      const ArrayType1& b,
+                            ArrayType2& x,
+                      const PlanType& plan);
+/*! \}
+ */
+
+} // end namespace cusp
+
+#include <cusp/detail/triangular_solve.inl>
@@ -57,6 +57,77 @@ template <typename MatrixType,
 bool is_valid_matrix(const MatrixType& matrix,
                            OutputStream& ostream);
 
+/**
+ * \brief Structure of a matrix reported by \p validate_matrix
+ *
+ * \par Overview
+ *  The flags describe the stored entries and let callers skip work that
+ *  the structure makes redundant, e.g. sorting entries that are already
+ *  ordered before a format conversion. Every flag except \p valid is
+ *  conservative: a flag that could not be established is reported as
+ *  \p false for \p sorted and \p symmetric_pattern and as \p true for
+ *  \p has_duplicates.
+ */
+struct matrix_structure
+{
+    /*! the format is valid, see \p is_valid_matrix */
+    bool valid;
+
+    /*! the entries are ordered by row and by column within each row */
+    bool sorted;
+
+    /*! some (row, column) position is stored more than once */
+    bool has_duplicates;
+
+    /*! the matrix is square and stores (j,i) for every stored (i,j) */
+    bool symmetric_pattern;
+
+    matrix_structure(void)
+      : valid(false), sorted(false), has_duplicates(true), symmetric_pattern(false) {}
+};
+
+/**
+ * \brief Validate a matrix and report its structure
+ *
+ * \tparam MatrixType matrix container
+ *
+ * \param matrix A matrix container (e.g. \p csr_matrix or \p coo_matrix)
+ * \param check_symmetry also determine \p symmetric_pattern, which sorts
+ * a copy of the indices
+ * \return the \p matrix_structure of \p matrix
+ *
+ * \par Overview
+ *  For \p coo_matrix and \p csr_matrix the offsets, the index bounds,
+ *  the order of the entries and adjacent duplicates are checked in a
+ *  single parallel pass in the memory space of the matrix, which stops
+ *  after the first chunk that holds an invalid entry. Only matrices with
+ *  unsorted rows, and the symmetry check, take an additional sort. Other
+ *  formats are checked by \p is_valid_matrix and report conservative
+ *  flags.
+ *
+ * \par Example
+ *  \code
+ *  #include <cusp/csr_matrix.h>
+ *  #include <cusp/verify.h>
+ *  #include <cusp/gallery/poisson.h>
+ *
+ *  int main(void)
+ *  {
+ *      cusp::csr_matrix<int, float, cusp::device_memory> A;
+ *      cusp::gallery::poisson5pt(A, 10, 10);
+ *
+ *      cusp::matrix_structure s = cusp::validate_matrix(A, true);
+ *
+ *      // s.valid, s.sorted and s.symmetric_pattern are true,
+ *      // s.has_duplicates is false
+ *      return s.valid ? 0 : 1;
+ *  }
+ *  \endcode
+ */
+template <typename MatrixType>
+matrix_structure validate_matrix(const MatrixType& matrix,
+                                 const bool check_symmetry = false);
+
 /**
  * \brief Validate format of a given matrix and exit if invalid
  *
@@ -0,0 +1,46 @@
+#include <cusp/stencil_operator.h>
+#include <cusp/monitor.h>
+#include <cusp/krylov/cg.h>
+
+// This example solves the same 2D Poisson problem as stencil.cu with the
+// built-in cusp::stencil_operator, which applies the 5-point stencil
+//
+//                [  0 -1  0 ]
+//                [ -1  4 -1 ]
+//                [  0 -1  0 ]
+//
+// without storing the matrix.
+
+int main(void)
+{
+    typedef thrust::tuple<int,int>            StencilIndex;
+    typedef thrust::tuple<StencilIndex,float> StencilPoint;
+
+    // number of grid points in each dimension
+    const int N = 10;
+
+    // describe the stencil by the displacement and coefficient of every point
+    cusp::array1d<StencilPoint, cusp::host_memory> stencil;
+    stencil.push_back(StencilPoint(StencilIndex( 0, -1), -1));
+    stencil.push_back(StencilPoint(StencilIndex(-1,  0), -1));
+    stencil.push_back(StencilPoint(StencilIndex( 0,  0),  4));
+    stencil.push_back(StencilPoint(StencilIndex( 1,  0), -1));
+    stencil.push_back(StencilPoint(StencilIndex( 0,  1), -1));
+
+    // create a matrix-free linear operator
+    cusp::stencil_operator<2, 5, float, cusp::device_memory> A(stencil, StencilIndex(N, N));
+
+    // allocate storage for solution (x) and right hand side (b)
+    cusp::array1d<float, cusp::device_memory> x(A.num_rows, 0);
+    cusp::array1d<float, cusp::device_memory> b(A.num_rows, 1);
+
+    // set stopping criteria:
+    //  iteration_limit    = 100
+    //  relative_tolerance = 1e-5
+    cusp::monitor<float> monitor(b, 100, 1e-5, 0, true);
+
+    // solve the linear system A * x = b with the Conjugate Gradient method
+    cusp::krylov::cg(A, x, b, monitor);
+
+    return 0;
+}
@@ -0,0 +1,493 @@
+#include <cusp/blas/blas.h>
+#include <cusp/convert.h>
+#include <cusp/coo_matrix.h>
+#include <cusp/csr_matrix.h>
+#include <cusp/dia_matrix.h>
+#include <cusp/ell_matrix.h>
+#include <cusp/exception.h>
+#include <cusp/hyb_matrix.h>
+#include <cusp/linear_operator.h>
+#include <cusp/monitor.h>
+#include <cusp/multiply.h>
+#include <cusp/transpose.h>
+#include <cusp/version.h>
+
+#include <cusp/gallery/poisson.h>
+#include <cusp/io/binary.h>
+#include <cusp/io/matrix_market.h>
+#include <cusp/krylov/cg.h>
+#include <cusp/precond/aggregation/smoothed_aggregation.h>
+
+#include <thrust/version.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "statistics.h"
+#include "../spmv/bytes_per_spmv.h"
+
+// Runs a fixed suite of kernels on one matrix and writes the timings of
+// every kernel as JSON, see usage() for the options and compare.py for the
+// comparison against a baseline.
+
+typedef std::map<std::string, std::string> ArgumentMap;
+ArgumentMap args;
+
+void process_args(int argc, char ** argv)
+{
+    for(int i = 1; i < argc; i++)
+    {
+        std::string arg(argv[i]);
+
+        if (arg.substr(0,2) == "--")
+        {
+            std::string::size_type n = arg.find('=',2);
+
+            if (n == std::string::npos)
+                args[arg.substr(2)] = std::string();              // (key)
+            else
+                args[arg.substr(2, n - 2)] = arg.substr(n + 1);   // (key,value)
+        }
+        else
+        {
+            args["matrix"] = arg;
+        }
+    }
+}
+
+std::string get_arg(const std::string& key, const std::string& default_value)
+{
+    return args.count(key) ? args[key] : default_value;
+}
+
+void usage(char** argv)
+{
+    std::cout << "Usage:\n";
+    std::cout << "\t" << argv[0] << " [matrix] [options]\n\n";
+    std::cout << "Matrix (default poisson5pt:512x512):\n";
+    std::cout << "\tA.mtx                   MatrixMarket file\n";
+    std::cout << "\tA.bin                   cusp binary file\n";
+    std::cout << "\tpoisson5pt:NXxNY        also poisson9pt, poisson7pt:NXxNYxNZ, poisson27pt:NXxNYxNZ\n\n";
+    std::cout << "Options:\n";
+    std::cout << "\t--benchmarks=spmv,blas  comma separated prefixes of the benchmarks to run\n";
+    std::cout << "\t                        (spmv, blas, convert, transpose, cg, amg, default all)\n";
+    std::cout << "\t--value_type=double     float or double\n";
+    std::cout << "\t--memory=device         device or host\n";
+    std::cout << "\t--device=0              CUDA device\n";
+    std::cout << "\t--warmup=2              untimed calls before sampling\n";
+    std::cout << "\t--samples=15            timed samples of every benchmark\n";
+    std::cout << "\t--min_sample_time=0.02  seconds, short kernels are repeated within a sample\n";
+    std::cout << "\t--output=results.json   file receiving the results, default standard output\n";
+}
+
+std::vector<size_t> parse_dimensions(const std::string& spec)
+{
+    std::vector<size_t> dims;
+    std::istringstream stream(spec);
+    std::string token;
+
+    while (std::getline(stream, token, 'x'))
+        dims.push_back(std::atoi(token.c_str()));
+
+    return dims;
+}
+
+template <typename Matrix>
+void read_matrix(Matrix& A, const std::string& spec)
+{
+    const std::string::size_type colon = spec.find(':');
+
+    const std::string name = spec.substr(0, colon);
+    const std::vector<size_t> dims = colon == std::string::npos ? std::vector<size_t>() : parse_dimensions(spec.substr(colon + 1));
+
+    if      (name == "poisson5pt"  && dims.size() == 2) cusp::gallery::poisson5pt (A, dims[0], dims[1]);
+    else if (name == "poisson9pt"  && dims.size() == 2) cusp::gallery::poisson9pt (A, dims[0], dims[1]);
+    else if (name == "poisson7pt"  && dims.size() == 3) cusp::gallery::poisson7pt (A, dims[0], dims[1], dims[2]);
+    else if (name == "poisson27pt" && dims.size() == 3) cusp::gallery::poisson27pt(A, dims[0], dims[1], dims[2]);
+    else if (spec.size() > 4 && spec.substr(spec.size() - 4) == ".bin")
+        cusp::io::read_binary_file(A, spec);
+    else
+        cusp::io::read_matrix_market_file(A, spec);
+}
+
+bool selected(const std::string& name)
+{
+    if (!args.count("benchmarks"))
+        return true;
+
+    std::istringstream stream(args["benchmarks"]);
+    std::string prefix;
+
+    while (std::getline(stream, prefix, ','))
+        if (!prefix.empty() && name.compare(0, prefix.size(), prefix) == 0)
+            return true;
+
+    return false;
+}
+
+// kernels, every call leaves the inputs ready for the next one
+
+template <typename Matrix, typename Array>
+struct spmv_kernel
+{
+    const Matrix& A;
+    const Array&  x;
+    Array&        y;
+
+    spmv_kernel(const Matrix& A, const Array& x, Array& y) : A(A), x(x), y(y) {}
+
+    void operator()(void)
+    {
+        cusp::multiply(A, x, y);
+    }
+};
+
+template <typename Array>
+struct axpy_kernel
+{
+    const Array& x;
+    Array&       y;
+
+    axpy_kernel(const Array& x, Array& y) : x(x), y(y) {}
+
+    void operator()(void)
+    {
+        cusp::blas::axpy(x, y, typename Array::value_type(1e-6));
+    }
+};
+
+template <typename Array>
+struct dot_kernel
+{
+    const Array& x;
+    const Array& y;
+
+    dot_kernel(const Array& x, const Array& y) : x(x), y(y) {}
+
+    void operator()(void)
+    {
+        volatile typename Array::value_type result = cusp::blas::dot(x, y);
+        (void) result;
+    }
+};
+
+template <typename Array>
+struct nrm2_kernel
+{
+    const Array& x;
+
+    nrm2_kernel(const Array& x) : x(x) {}
+
+    void operator()(void)
+    {
+        volatile typename Array::value_type result = cusp::blas::nrm2(x);
+        (void) result;
+    }
+};
+
+template <typename Matrix1, typename Matrix2>
+struct convert_kernel
+{
+    const Matrix1& A;
+    Matrix2&       B;
+
+    convert_kernel(const Matrix1& A, Matrix2& B) : A(A), B(B) {}
+
+    void operator()(void)
+    {
+        cusp::convert(A, B);
+    }
+};
+
+template <typename Matrix>
+struct transpose_kernel
+{
+    const Matrix& A;
+    Matrix&       At;
+
+    transpose_kernel(const Matrix& A, Matrix& At) : A(A), At(At) {}
+
+    void operator()(void)
+    {
+        cusp::transpose(A, At);
+    }
+};
+
+// a fixed number of iterations, so the work does not depend on convergence
+template <typename Matrix, typename Array, typename Preconditioner>
+struct cg_kernel
+{
+    const Matrix&   A;
+    Array&          x;
+    const Array&    b;
+    Preconditioner& M;
+    size_t          iterations;
+
+    cg_kernel(const Matrix& A, Array& x, const Array& b, Preconditioner& M, size_t iterations)
+      : A(A), x(x), b(b), M(M), iterations(iterations) {}
+
+    void operator()(void)
+    {
+        typedef typename Array::value_type ValueType;
+
+        cusp::blas::fill(x, ValueType(0));
+
+        cusp::monitor<ValueType> monitor(b, iterations, 0, 0);
+        cusp::krylov::cg(A, x, b, monitor, M);
+    }
+};
+
+template <typename Matrix>
+struct amg_setup_kernel
+{
+    typedef typename Matrix::index_type   IndexType;
+    typedef typename Matrix::value_type   ValueType;
+    typedef typename Matrix::memory_space MemorySpace;
+
+    const Matrix& A;
+
+    amg_setup_kernel(const Matrix& A) : A(A) {}
+
+    void operator()(void)
+    {
+        cusp::precond::aggregation::smoothed_aggregation<IndexType, ValueType, MemorySpace> M(A);
+    }
+};
+
+template <typename HostMatrix, typename TestMatrix>
+void benchmark_spmv(const std::string& name,
+                    const cusp::csr_matrix<typename HostMatrix::index_type, typename HostMatrix::value_type, cusp::host_memory>& csr,
+                    const benchmark_settings& settings,
+                    std::vector<measurement>& results)
+{
+    typedef typename TestMatrix::value_type   ValueType;
+    typedef typename TestMatrix::memory_space MemorySpace;
+
+    if (!selected(name))
+        return;
+
+    HostMatrix host_matrix;
+
+    try
+    {
+        cusp::convert(csr, host_matrix);
+    }
+    catch (const cusp::format_conversion_exception&)
+    {
+        std::cerr << "  skipping " << name << ", the matrix does not fit the format" << std::endl;
+        return;
+    }
+
+    TestMatrix A(host_matrix);
+
+    cusp::array1d<ValueType, MemorySpace> x(A.num_cols, 1);
+    cusp::array1d<ValueType, MemorySpace> y(A.num_rows, 0);
+
+    measurement m = measure(name, spmv_kernel<TestMatrix, cusp::array1d<ValueType, MemorySpace> >(A, x, y), settings);
+
+    m.metrics["gflops"] = 2.0 * csr.num_entries / m.median() / 1e9;
+    m.metrics["gbytes"] = double(bytes_per_spmv(host_matrix)) / m.median() / 1e9;
+
+    results.push_back(m);
+}
+
+template <typename IndexType, typename ValueType, typename MemorySpace>
+void run_benchmarks(const cusp::csr_matrix<IndexType, ValueType, cusp::host_memory>& csr,
+                    const benchmark_settings& settings,
+                    std::vector<measurement>& results)
+{
+    typedef cusp::array1d<ValueType, MemorySpace>                    Array;
+    typedef cusp::csr_matrix<IndexType, ValueType, MemorySpace>      CsrMatrix;
+    typedef cusp::hyb_matrix<IndexType, ValueType, MemorySpace>      HybMatrix;
+
+    benchmark_spmv<cusp::coo_matrix<IndexType, ValueType, cusp::host_memory>, cusp::coo_matrix<IndexType, ValueType, MemorySpace> >("spmv_coo", csr, settings, results);
+    benchmark_spmv<cusp::csr_matrix<IndexType, ValueType, cusp::host_memory>, cusp::csr_matrix<IndexType, ValueType, MemorySpace> >("spmv_csr", csr, settings, results);
+    benchmark_spmv<cusp::dia_matrix<IndexType, ValueType, cusp::host_memory>, cusp::dia_matrix<IndexType, ValueType, MemorySpace> >("spmv_dia", csr, settings, results);
+    benchmark_spmv<cusp::ell_matrix<IndexType, ValueType, cusp::host_memory>, cusp::ell_matrix<IndexType, ValueType, MemorySpace> >("spmv_ell", csr, settings, results);
+    benchmark_spmv<cusp::hyb_matrix<IndexType, ValueType, cusp::host_memory>, cusp::hyb_matrix<IndexType, ValueType, MemorySpace> >("spmv_hyb", csr, settings, results);
+
+    CsrMatrix A(csr);
+
+    const size_t N = A.num_rows;
+
+    Array x(N, 1);
+    Array y(N, 2);
+
+    if (selected("blas_axpy"))
+    {
+        measurement m = measure("blas_axpy", axpy_kernel<Array>(x, y), settings);
+        m.metrics["gbytes"] = 3.0 * sizeof(ValueType) * N / m.median() / 1e9;
+        results.push_back(m);
+    }
+
+    if (selected("blas_dot"))
+    {
+        measurement m = measure("blas_dot", dot_kernel<Array>(x, y), settings);
+        m.metrics["gbytes"] = 2.0 * sizeof(ValueType) * N / m.median() / 1e9;
+        results.push_back(m);
+    }
+
+    if (selected("blas_nrm2"))
+    {
+        measurement m = measure("blas_nrm2", nrm2_kernel<Array>(x), settings);
+        m.metrics["gbytes"] = 1.0 * sizeof(ValueType) * N / m.median() / 1e9;
+        results.push_back(m);
+    }
+
+    if (selected("convert_csr_to_hyb"))
+    {
+        HybMatrix H;
+        results.push_back(measure("convert_csr_to_hyb", convert_kernel<CsrMatrix, HybMatrix>(A, H), settings));
+    }
+
+    if (selected("transpose_csr"))
+    {
+        CsrMatrix At;
+        results.push_back(measure("transpose_csr", transpose_kernel<CsrMatrix>(A, At), settings));
+    }
+
+    if (A.num_rows != A.num_cols)
+    {
+        std::cerr << "  skipping the solvers, the matrix is not square" << std::endl;
+        return;
+    }
+
+    const size_t cg_iterations = 100;
+    Array b(N, 1);
+
+    if (selected("cg"))
+    {
+        cusp::identity_operator<ValueType, MemorySpace> I(N, N);
+
+        measurement m = measure("cg", cg_kernel<CsrMatrix, Array, cusp::identity_operator<ValueType, MemorySpace> >(A, x, b, I, cg_iterations), settings);
+        m.metrics["iterations"]            = cg_iterations;
+        m.metrics["seconds_per_iteration"] = m.median() / cg_iterations;
+        results.push_back(m);
+    }
+
+    if (selected("amg_setup"))
+        results.push_back(measure("amg_setup", amg_setup_kernel<CsrMatrix>(A), settings));
+
+    if (selected("amg_cg"))
+    {
+        typedef cusp::precond::aggregation::smoothed_aggregation<IndexType, ValueType, MemorySpace> Preconditioner;
+
+        Preconditioner M(A);
+
+        const size_t amg_iterations = 20;
+
+        measurement m = measure("amg_cg", cg_kernel<CsrMatrix, Array, Preconditioner>(A, x, b, M, amg_iterations), settings);
+        m.metrics["iterations"]            = amg_iterations;
+        m.metrics["seconds_per_iteration"] = m.median() / amg_iterations;
+        m.metrics["levels"]                = M.levels.size();
+        results.push_back(m);
+    }
+}
+
+std::string device_name(int device_id)
+{
+    cudaDeviceProp properties;
+
+    if (cudaGetDeviceProperties(&properties, device_id) != cudaSuccess)
+        return "unknown";
+
+    return properties.name;
+}
+
+template <typename IndexType, typename ValueType>
+int run(const std::string& value_type)
+{
+    benchmark_settings settings;
+    settings.warmup             = std::atoi(get_arg("warmup",  "2").c_str());
+    settings.samples            = std::max(1, std::atoi(get_arg("samples", "15").c_str()));
+    settings.min_sample_seconds = std::atof(get_arg("min_sample_time", "0.02").c_str());
+
+    const int         device_id = std::atoi(get_arg("device", "0").c_str());
+    const std::string memory    = get_arg("memory", "device");
+    const std::string spec      = get_arg("matrix", "poisson5pt:512x512");
+
+    cudaSetDevice(device_id);
+
+    cusp::csr_matrix<IndexType, ValueType, cusp::host_memory> A;
+
+    try
+    {
+        read_matrix(A, spec);
+    }
+    catch (const cusp::exception& e)
+    {
+        std::cerr << "unable to read the matrix " << spec << ": " << e.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    std::cerr << "matrix " << spec << ": " << A.num_rows << " x " << A.num_cols
+              << ", " << A.num_entries << " entries" << std::endl;
+
+    std::vector<measurement> results;
+
+    if (memory == "host")
+        run_benchmarks<IndexType, ValueType, cusp::host_memory>(A, settings, results);
+    else
+        run_benchmarks<IndexType, ValueType, cusp::device_memory>(A, settings, results);
+
+    std::ofstream file;
+    if (args.count("output"))
+        file.open(args["output"].c_str());
+
+    std::ostream& os = args.count("output") ? file : std::cout;
+
+    os.precision(9);
+
+    os << "{\n";
+    os << "  \"cusp_version\": \""   << CUSP_MAJOR_VERSION << "." << CUSP_MINOR_VERSION << "." << CUSP_SUBMINOR_VERSION << "\",\n";
+    os << "  \"thrust_version\": \"" << THRUST_MAJOR_VERSION << "." << THRUST_MINOR_VERSION << "." << THRUST_SUBMINOR_VERSION << "\",\n";
+    os << "  \"device\": \""         << (memory == "host" ? std::string("host") : device_name(device_id)) << "\",\n";
+    os << "  \"memory\": \""         << memory << "\",\n";
+    os << "  \"value_type\": \""     << value_type << "\",\n";
+    os << "  \"matrix\": {\"source\": \"" << spec << "\", \"num_rows\": " << A.num_rows
+       << ", \"num_cols\": " << A.num_cols << ", \"num_entries\": " << A.num_entries << "},\n";
+    os << "  \"settings\": {\"warmup\": " << settings.warmup << ", \"samples\": " << settings.samples
+       << ", \"min_sample_seconds\": " << settings.min_sample_seconds << "},\n";
+    os << "  \"benchmarks\": [\n";
+
+    for (size_t i = 0; i < results.size(); i++)
+    {
+        write_json(os, results[i]);
+        os << (i + 1 < results.size() ? ",\n" : "\n");
+
+        std::cerr << "  " << results[i].name << ": " << 1e3 * results[i].median() << " ms" << std::endl;
+    }
+
+    os << "  ]\n";
+    os << "}\n";
+
+    return EXIT_SUCCESS;
+}
+
+int main(int argc, char** argv)
+{
+    process_args(argc, argv);
+
+    if (args.count("help"))
+    {
+        usage(argv);
+        return EXIT_SUCCESS;
+    }
+
+    const std::string value_type = get_arg("value_type", "double");
+
+    if (value_type == "float")
+        return run<int, float>(value_type);
+    else if (value_type == "double")
+        return run<int, double>(value_type);
+
+    usage(argv);
+
+    return EXIT_FAILURE;
+}
@@ -0,0 +1,115 @@
+#!/usr/bin/env python
+"""Compare two result files of the benchmark driver.
+
+Usage:
+    python compare.py baseline.json current.json [--threshold=0.05] [--sigma=3]
+
+A benchmark regresses when its median time grew by more than the threshold
+and by more than sigma times the combined spread of both runs, estimated
+from the median absolute deviation of the samples, so that noisy kernels
+are not flagged by chance. Benchmarks of the baseline missing from the
+current run are reported as well. The exit status is 1 when any regression
+or missing benchmark was found.
+"""
+
+from __future__ import print_function
+
+import json
+import sys
+
+# scales the median absolute deviation to the standard deviation of
+# normally distributed samples
+MAD_TO_SIGMA = 1.4826
+
+
+def parse_args(argv):
+    options = {'threshold': 0.05, 'sigma': 3.0}
+    files = []
+
+    for arg in argv:
+        if arg.startswith('--'):
+            key, _, value = arg[2:].partition('=')
+            if key not in options:
+                raise SystemExit('unknown option ' + arg)
+            options[key] = float(value)
+        else:
+            files.append(arg)
+
+    if len(files) != 2:
+        raise SystemExit(__doc__)
+
+    return files, options
+
+
+def load(filename):
+    with open(filename) as f:
+        results = json.load(f)
+
+    benchmarks = dict((b['name'], b) for b in results['benchmarks'])
+
+    return results, benchmarks
+
+
+def relative_spread(benchmark):
+    seconds = benchmark['seconds']
+
+    if seconds['median'] <= 0:
+        return 0.0
+
+    return MAD_TO_SIGMA * seconds['mad'] / seconds['median']
+
+
+def main(argv):
+    (baseline_file, current_file), options = parse_args(argv)
+
+    baseline, baseline_benchmarks = load(baseline_file)
+    current,  current_benchmarks  = load(current_file)
+
+    for key in ['matrix', 'value_type', 'memory', 'device']:
+        if baseline.get(key) != current.get(key):
+            print('warning: %s differs, %s vs %s' % (key, baseline.get(key), current.get(key)))
+
+    print('baseline cusp %s, current cusp %s\n' % (baseline.get('cusp_version'), current.get('cusp_version')))
+    print('%-24s %14s %14s %9s  %s' % ('benchmark', 'baseline [ms]', 'current [ms]', 'change', 'status'))
+
+    failures = 0
+
+    for name in sorted(set(baseline_benchmarks) | set(current_benchmarks)):
+        if name not in current_benchmarks:
+            print('%-24s %14s %14s %9s  %s' % (name, '', '', '', 'MISSING'))
+            failures += 1
+            continue
+
+        if name not in baseline_benchmarks:
+            print('%-24s %14s %14s %9s  %s' % (name, '', '', '', 'new'))
+            continue
+
+        old = baseline_benchmarks[name]['seconds']['median']
+        new = current_benchmarks[name]['seconds']['median']
+
+        if old <= 0:
+            continue
+
+        change = new / old - 1.0
+        noise  = options['sigma'] * (relative_spread(baseline_benchmarks[name]) +
+                                     relative_spread(current_benchmarks[name]))
+        limit  = max(options['threshold'], noise)
+
+        if change > limit:
+            status = 'REGRESSION'
+            failures += 1
+        elif change < -limit:
+            status = 'improved'
+        else:
+            status = 'ok'
+
+        print('%-24s %14.4f %14.4f %+8.1f%%  %s' % (name, 1e3 * old, 1e3 * new, 1e2 * change, status))
+
+    if failures:
+        print('\n%d benchmark(s) regressed or are missing' % failures)
+
+    return 1 if failures else 0
+
+
+if __name__ == '__main__':
+    sys.exit(main(sys.argv[1:]))
@@ -0,0 +1,154 @@
+#pragma once
+
+#include "../timer.h"
+
+#include <algorithm>
+#include <cmath>
+#include <map>
+#include <ostream>
+#include <string>
+#include <vector>
+
+// Settings shared by all measurements
+struct benchmark_settings
+{
+    size_t warmup;              // untimed calls before the first sample
+    size_t samples;             // number of timed samples
+    double min_sample_seconds;  // calls are batched until a sample lasts this long
+    size_t max_calls;           // largest batch of calls in one sample
+
+    benchmark_settings(void)
+      : warmup(2), samples(15), min_sample_seconds(0.02), max_calls(1000) {}
+};
+
+// Seconds per call of every sample, together with metrics derived from
+// them such as GFLOP/s or iteration counts
+struct measurement
+{
+    std::string                   name;
+    size_t                        calls_per_sample;
+    std::vector<double>           seconds;
+    std::map<std::string, double> metrics;
+
+    double min(void) const
+    {
+        return *std::min_element(seconds.begin(), seconds.end());
+    }
+
+    double max(void) const
+    {
+        return *std::max_element(seconds.begin(), seconds.end());
+    }
+
+    double median(void) const
+    {
+        return median_of(seconds);
+    }
+
+    double mean(void) const
+    {
+        double sum = 0;
+        for (size_t i = 0; i < seconds.size(); i++)
+            sum += seconds[i];
+        return sum / seconds.size();
+    }
+
+    // sample standard deviation
+    double stddev(void) const
+    {
+        if (seconds.size() < 2)
+            return 0;
+
+        const double m = mean();
+
+        double sum = 0;
+        for (size_t i = 0; i < seconds.size(); i++)
+            sum += (seconds[i] - m) * (seconds[i] - m);
+
+        return std::sqrt(sum / (seconds.size() - 1));
+    }
+
+    // median absolute deviation, a spread estimate insensitive to the
+    // occasional outlier caused by other processes or clock changes
+    double mad(void) const
+    {
+        const double m = median();
+
+        std::vector<double> deviations(seconds.size());
+        for (size_t i = 0; i < seconds.size(); i++)
+            deviations[i] = std::fabs(seconds[i] - m);
+
+        return median_of(deviations);
+    }
+
+    static double median_of(std::vector<double> values)
+    {
+        std::sort(values.begin(), values.end());
+
+        const size_t n = values.size();
+
+        return (n % 2) ? values[n / 2] : 0.5 * (values[n / 2 - 1] + values[n / 2]);
+    }
+};
+
+// Times kernel(), which must leave its arguments ready for the next
+// call. The warmup calls also estimate the cost of one call, which sets the
+// number of calls batched into each sample, so that short kernels are not
+// dominated by the resolution of the timer.
+template <typename Kernel>
+measurement measure(const std::string& name, Kernel kernel, const benchmark_settings& settings)
+{
+    measurement result;
+    result.name = name;
+
+    double estimate = 0;
+
+    for (size_t i = 0; i < std::max(settings.warmup, size_t(1)); i++)
+    {
+        timer t;
+        kernel();
+        estimate = t.seconds_elapsed();
+    }
+
+    size_t calls = 1;
+    if (estimate > 0 && estimate < settings.min_sample_seconds)
+        calls = std::min(settings.max_calls, size_t(std::ceil(settings.min_sample_seconds / estimate)));
+
+    result.calls_per_sample = calls;
+
+    for (size_t s = 0; s < settings.samples; s++)
+    {
+        timer t;
+
+        for (size_t i = 0; i < calls; i++)
+            kernel();
+
+        result.seconds.push_back(t.seconds_elapsed() / calls);
+    }
+
+    return result;
+}
+
+inline void write_json(std::ostream& os, const measurement& m)
+{
+    os << "    {\"name\": \"" << m.name << "\", "
+       << "\"samples\": " << m.seconds.size() << ", "
+       << "\"calls_per_sample\": " << m.calls_per_sample << ",\n"
+       << "     \"seconds\": {"
+       << "\"min\": "    << m.min()    << ", "
+       << "\"median\": " << m.median() << ", "
+       << "\"mean\": "   << m.mean()   << ", "
+       << "\"max\": "    << m.max()    << ", "
+       << "\"stddev\": " << m.stddev() << ", "
+       << "\"mad\": "    << m.mad()    << "},\n"
+       << "     \"metrics\": {";
+
+    for (std::map<std::string, double>::const_iterator iter = m.metrics.begin(); iter != m.metrics.end(); ++iter)
+    {
+        if (iter != m.metrics.begin())
+            os << ", ";
+        os << "\"" << iter->first << "\": " << iter->second;
+    }
+
+    os << "}}";
+}
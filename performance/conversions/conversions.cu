@@ -1,29 +1,59 @@
+// peak temporary memory of every conversion is read from the allocation tracker
+#define CUSP_MEMORY_TRACKING 1
+
+#include <cusp/bsr_matrix.h>
 #include <cusp/coo_matrix.h>
 #include <cusp/csr_matrix.h>
+#include <cusp/dcsr_matrix.h>
 #include <cusp/dia_matrix.h>
+#include <cusp/dynamic_csr_matrix.h>
 #include <cusp/ell_matrix.h>
 #include <cusp/hyb_matrix.h>
+#include <cusp/memory_tracker.h>
+#include <cusp/sell_matrix.h>
 
+#include <cusp/detail/num_bytes.h>
 #include <cusp/gallery/poisson.h>
 #include <cusp/io/matrix_market.h>
-#include <cusp/blas/blas.h>
-
-#include <thrust/binary_search.h>
 
 #include <iostream>
 #include <string>
-#include <map>
-#include <cmath>
+#include <vector>
 #include <stdio.h>
 
 #include "../timer.h"
+#include "sync_counter.h"
+
+// Converts the input matrix between every pair of formats in host and
+// device memory and prints one table per measure: milliseconds per
+// conversion, GB/s of output produced, peak temporary memory beyond the
+// source and the output, and host-device synchronizations per conversion.
+
+struct conversion_result
+{
+    bool   supported;
+    float  milliseconds;
+    size_t output_bytes;
+    size_t temporary_bytes;
+    size_t synchronizations;
 
+    conversion_result(void)
+      : supported(false), milliseconds(0), output_bytes(0), temporary_bytes(0), synchronizations(0) {}
+};
+
+typedef std::vector< std::vector<conversion_result> > result_table;
+
+sync_counter * counter = NULL;
 
 template <typename SourceType, typename DestinationType, typename InputType>
-float time_conversion(const InputType& A)
+conversion_result time_conversion(const InputType& A)
 {
+    typedef typename DestinationType::memory_space MemorySpace;
+
     unsigned int N = 10;
 
+    conversion_result result;
+
     SourceType S;
 
     try
@@ -32,16 +62,30 @@ float time_conversion(const InputType& A)
     }
     catch (cusp::format_conversion_exception)
     {
-        return -1;
+        return result;
     }
 
+    // the first conversion is measured for memory and synchronizations
     try
     {
+        const size_t source_bytes = cusp::memory_usage<MemorySpace>().current_bytes;
+        const size_t syncs        = counter->count();
+
+        cusp::reset_memory_peaks();
+
         DestinationType D(S);
+
+        result.synchronizations = counter->count() - syncs;
+        result.output_bytes     = cusp::detail::num_bytes(D);
+
+        const size_t peak_bytes = cusp::memory_usage<MemorySpace>().peak_bytes;
+
+        if (peak_bytes > source_bytes + result.output_bytes)
+            result.temporary_bytes = peak_bytes - source_bytes - result.output_bytes;
     }
     catch (cusp::format_conversion_exception)
     {
-        return -1;
+        return result;
     }
 
     timer t;
@@ -49,27 +93,71 @@ float time_conversion(const InputType& A)
     for(unsigned int i = 0; i < N; i++)
         DestinationType D(S);
 
-    return t.milliseconds_elapsed() / N;
+    result.milliseconds = t.milliseconds_elapsed() / N;
+    result.supported    = true;
+
+    return result;
 }
 
 template <typename SourceType, typename InputType>
-void for_each_destination(const InputType& A)
+std::vector<conversion_result> for_each_destination(const InputType& A)
 {
     typedef typename SourceType::index_type   I;
     typedef typename SourceType::value_type   V;
     typedef typename SourceType::memory_space M;
 
-    typedef cusp::coo_matrix<I,V,M> COO;
-    typedef cusp::csr_matrix<I,V,M> CSR;
-    typedef cusp::dia_matrix<I,V,M> DIA;
-    typedef cusp::ell_matrix<I,V,M> ELL;
-    typedef cusp::hyb_matrix<I,V,M> HYB;
-
-    printf(" %9.2f |", time_conversion<SourceType, COO>(A));
-    printf(" %9.2f |", time_conversion<SourceType, CSR>(A));
-    printf(" %9.2f |", time_conversion<SourceType, DIA>(A));
-    printf(" %9.2f |", time_conversion<SourceType, ELL>(A));
-    printf(" %9.2f |", time_conversion<SourceType, HYB>(A));
+    std::vector<conversion_result> row;
+
+    row.push_back(time_conversion<SourceType, cusp::coo_matrix<I,V,M> >(A));
+    row.push_back(time_conversion<SourceType, cusp::csr_matrix<I,V,M> >(A));
+    row.push_back(time_conversion<SourceType, cusp::dia_matrix<I,V,M> >(A));
+    row.push_back(time_conversion<SourceType, cusp::ell_matrix<I,V,M> >(A));
+    row.push_back(time_conversion<SourceType, cusp::hyb_matrix<I,V,M> >(A));
+    row.push_back(time_conversion<SourceType, cusp::sell_matrix<I,V,M> >(A));
+    row.push_back(time_conversion<SourceType, cusp::bsr_matrix<I,V,M,2,2> >(A));
+    row.push_back(time_conversion<SourceType, cusp::dcsr_matrix<I,V,M> >(A));
+    row.push_back(time_conversion<SourceType, cusp::dynamic_csr_matrix<I,V,M> >(A));
+
+    return row;
+}
+
+static const char * format_names[] = {"COO", "CSR", "DIA", "ELL", "HYB", "SELL", "BSR2x2", "DCSR", "DYNCSR"};
+
+static const size_t num_formats = sizeof(format_names) / sizeof(format_names[0]);
+
+enum measure { MILLISECONDS, GBYTES_PER_SECOND, TEMPORARY_MBYTES, SYNCHRONIZATIONS };
+
+void print_table(const char * title, const result_table& results, measure m)
+{
+    printf("%s\n", title);
+
+    printf(" From \\ To |");
+    for(size_t j = 0; j < num_formats; j++)
+        printf(" %9s |", format_names[j]);
+    printf("\n");
+
+    for(size_t i = 0; i < num_formats; i++)
+    {
+        printf(" %9s |", format_names[i]);
+
+        for(size_t j = 0; j < num_formats; j++)
+        {
+            const conversion_result& r = results[i][j];
+
+            if (!r.supported)
+                printf(" %9s |", "-");
+            else if (m == MILLISECONDS)
+                printf(" %9.2f |", r.milliseconds);
+            else if (m == GBYTES_PER_SECOND)
+                printf(" %9.2f |", r.output_bytes / (r.milliseconds * 1e6));
+            else if (m == TEMPORARY_MBYTES)
+                printf(" %9.2f |", r.temporary_bytes / 1e6);
+            else
+                printf(" %9d |", int(r.synchronizations));
+        }
+        printf("\n");
+    }
+    printf("\n");
 }
 
 template <typename MemorySpace, typename InputType>
@@ -84,30 +172,30 @@ void for_each_source(const InputType& A)
     typedef cusp::ell_matrix<I,V,MemorySpace> ELL;
     typedef cusp::hyb_matrix<I,V,MemorySpace> HYB;
 
-    printf(" From \\ To |    COO    |    CSR    |    DIA    |    ELL    |    HYB    |\n");
-    printf("    COO    |");
-    for_each_destination<COO>(A);
-    printf("\n");
-    printf("    CSR    |");
-    for_each_destination<CSR>(A);
-    printf("\n");
-    printf("    DIA    |");
-    for_each_destination<DIA>(A);
-    printf("\n");
-    printf("    ELL    |");
-    for_each_destination<ELL>(A);
-    printf("\n");
-    printf("    HYB    |");
-    for_each_destination<HYB>(A);
-    printf("\n\n");
+    result_table results;
+
+    results.push_back(for_each_destination<COO>(A));
+    results.push_back(for_each_destination<CSR>(A));
+    results.push_back(for_each_destination<DIA>(A));
+    results.push_back(for_each_destination<ELL>(A));
+    results.push_back(for_each_destination<HYB>(A));
+    results.push_back(for_each_destination< cusp::sell_matrix<I,V,MemorySpace> >(A));
+    results.push_back(for_each_destination< cusp::bsr_matrix<I,V,MemorySpace,2,2> >(A));
+    results.push_back(for_each_destination< cusp::dcsr_matrix<I,V,MemorySpace> >(A));
+    results.push_back(for_each_destination< cusp::dynamic_csr_matrix<I,V,MemorySpace> >(A));
+
+    print_table("Milliseconds per conversion",                  results, MILLISECONDS);
+    print_table("GB/s of output produced",                      results, GBYTES_PER_SECOND);
+    print_table("Peak temporary memory (MB)",                   results, TEMPORARY_MBYTES);
+    print_table("Host-device synchronizations per conversion",  results, SYNCHRONIZATIONS);
 
     printf(" To COO view |    COO    |    CSR    |    DIA    |    ELL    |    HYB    |\n");
     printf("\t     ");
-    printf("| %9.2f ", time_conversion<COO, typename COO::const_coo_view_type>(A));
-    printf("| %9.2f ", time_conversion<CSR, typename CSR::const_coo_view_type>(A));
-    printf("| %9.2f ", time_conversion<DIA, typename DIA::const_coo_view_type>(A));
-    printf("| %9.2f ", time_conversion<ELL, typename ELL::const_coo_view_type>(A));
-    printf("| %9.2f |", time_conversion<HYB, typename HYB::const_coo_view_type>(A));
+    printf("| %9.2f ", time_conversion<COO, typename COO::const_coo_view_type>(A).milliseconds);
+    printf("| %9.2f ", time_conversion<CSR, typename CSR::const_coo_view_type>(A).milliseconds);
+    printf("| %9.2f ", time_conversion<DIA, typename DIA::const_coo_view_type>(A).milliseconds);
+    printf("| %9.2f ", time_conversion<ELL, typename ELL::const_coo_view_type>(A).milliseconds);
+    printf("| %9.2f |", time_conversion<HYB, typename HYB::const_coo_view_type>(A).milliseconds);
     printf("\n");
 }
 
@@ -118,6 +206,9 @@ int main(int argc, char ** argv)
     typedef int    IndexType;
     typedef float  ValueType;
 
+    sync_counter syncs;
+    counter = &syncs;
+
     cusp::csr_matrix<IndexType, ValueType, cusp::host_memory> A;
 
     if (argc == 1)
@@ -133,14 +224,13 @@ int main(int argc, char ** argv)
 
     std::cout << "Input matrix has shape (" << A.num_rows << "," << A.num_cols << ") and " << A.num_entries << " entries" << "\n\n";
 
-    printf("Host Conversions (milliseconds per conversion)\n");
+    printf("Host Conversions\n\n");
     for_each_source<cusp::host_memory>(A);
 
     printf("\n\n");
 
-    printf("Device Conversions (milliseconds per conversion)\n");
+    printf("Device Conversions\n\n");
     for_each_source<cusp::device_memory>(A);
 
     return 0;
 }
-
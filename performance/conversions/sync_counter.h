@@ -0,0 +1,66 @@
+#pragma once
+
+// Counts the CUDA runtime calls which wait for the device
+
+#include <cuda_runtime_api.h>
+#include <cupti.h>
+
+#include <cstddef>
+#include <iostream>
+
+// Every call counted blocks the host until the device (or a stream of it)
+// is idle: explicit synchronizations, blocking copies and cudaFree, which
+// synchronizes the device implicitly. CUPTI admits a single subscriber per
+// process, so only one counter may exist at a time.
+class sync_counter
+{
+    CUpti_SubscriberHandle subscriber;
+    size_t                 calls;
+
+    static void CUPTIAPI callback(void * userdata, CUpti_CallbackDomain, CUpti_CallbackId id, const void * data)
+    {
+        const CUpti_CallbackData * info = static_cast<const CUpti_CallbackData *>(data);
+
+        if (info->callbackSite != CUPTI_API_ENTER)
+            return;
+
+        switch (id)
+        {
+            case CUPTI_RUNTIME_TRACE_CBID_cudaDeviceSynchronize_v3020:
+            case CUPTI_RUNTIME_TRACE_CBID_cudaThreadSynchronize_v3020:
+            case CUPTI_RUNTIME_TRACE_CBID_cudaStreamSynchronize_v3020:
+            case CUPTI_RUNTIME_TRACE_CBID_cudaEventSynchronize_v3020:
+            case CUPTI_RUNTIME_TRACE_CBID_cudaMemcpy_v3020:
+            case CUPTI_RUNTIME_TRACE_CBID_cudaMemcpy2D_v3020:
+            case CUPTI_RUNTIME_TRACE_CBID_cudaMemset_v3020:
+            case CUPTI_RUNTIME_TRACE_CBID_cudaFree_v3020:
+                static_cast<sync_counter *>(userdata)->calls++;
+                break;
+            default:
+                break;
+        }
+    }
+
+    // the callback holds the address of the counter
+    sync_counter(const sync_counter&);
+    sync_counter& operator=(const sync_counter&);
+
+public:
+
+    sync_counter(void) : calls(0)
+    {
+        if (cuptiSubscribe(&subscriber, (CUpti_CallbackFunc) callback, this) != CUPTI_SUCCESS ||
+            cuptiEnableDomain(1, subscriber, CUPTI_CB_DOMAIN_RUNTIME_API) != CUPTI_SUCCESS)
+            std::cerr << "CUPTI is unavailable, synchronizations are not counted" << std::endl;
+    }
+
+    ~sync_counter(void)
+    {
+        cuptiUnsubscribe(subscriber);
+    }
+
+    size_t count(void) const
+    {
+        return calls;
+    }
+};
@@ -0,0 +1,105 @@
+#!/usr/bin/env python
+"""Compare the graph benchmark results of builds for different backends.
+
+Usage:
+    python compare_graphs.py cuda.json omp.json tbb.json
+
+Every file is the --output of graph_suite built for one backend, e.g. with
+scons backend=omp. For every graph the BFS throughput in GTEPS, the times
+of the other algorithms in milliseconds and the quality of their results
+are printed side by side, one column per backend and memory space.
+"""
+
+from __future__ import print_function
+
+import json
+import sys
+
+
+def load(filename):
+    with open(filename) as f:
+        results = json.load(f)
+
+    backend = results.get('backend', filename)
+
+    columns = {}
+    for graph in results['graphs']:
+        for run in graph['runs']:
+            columns.setdefault(backend + '/' + run['memory'], {})[graph['name']] = (graph, run)
+
+    return columns
+
+
+def lookup(value, path):
+    for key in path:
+        if key not in value:
+            return None
+        value = value[key]
+    return value
+
+
+def row(name, values, scale, fmt):
+    cells = []
+    for value in values:
+        cells.append(' ' * 14 if value is None else fmt % (scale * value))
+    print('  %-34s%s' % (name, ''.join(cells)))
+
+
+def main(argv):
+    if len(argv) < 1:
+        raise SystemExit(__doc__)
+
+    columns = []
+    for filename in argv:
+        for label, graphs in sorted(load(filename).items()):
+            columns.append((label, graphs))
+
+    names = []
+    for _, graphs in columns:
+        for name in sorted(graphs):
+            if name not in names:
+                names.append(name)
+
+    for name in names:
+        present = [graphs.get(name) for _, graphs in columns]
+        graph = [p for p in present if p is not None][0][0]
+
+        print('%s: %d vertices, %d edges, bandwidth %d, profile %d' %
+              (name, graph['num_vertices'], graph['num_edges'], graph['bandwidth'], graph['profile']))
+        print('  %-34s%s' % ('', ''.join('%14s' % label for label, _ in columns)))
+
+        def values(path):
+            return [None if p is None else lookup(p[1], path) for p in present]
+
+        row('bfs [GTEPS]', values(['bfs', 'gteps']), 1.0, '%14.4f')
+        row('bfs median [ms]', values(['bfs', 'median_seconds']), 1e3, '%14.3f')
+        row('cc [ms]', values(['cc', 'seconds']), 1e3, '%14.3f')
+        row('mis [ms]', values(['mis', 'seconds']), 1e3, '%14.3f')
+
+        methods = []
+        for p in present:
+            if p is not None:
+                for method in sorted(p[1]['coloring']):
+                    if method not in methods:
+                        methods.append(method)
+
+        for method in methods:
+            row('color %s [ms]' % method, values(['coloring', method, 'seconds']), 1e3, '%14.3f')
+
+        row('rcm [ms]', values(['rcm', 'seconds']), 1e3, '%14.3f')
+
+        row('components', values(['cc', 'components']), 1, '%14d')
+        row('mis size', values(['mis', 'size']), 1, '%14d')
+
+        for method in methods:
+            row('colors %s' % method, values(['coloring', method, 'colors']), 1, '%14d')
+
+        row('rcm bandwidth', values(['rcm', 'bandwidth']), 1, '%14d')
+        row('rcm profile', values(['rcm', 'profile']), 1, '%14d')
+        print('')
+
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main(sys.argv[1:]))
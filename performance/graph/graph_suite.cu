@@ -0,0 +1,711 @@
+#include <cusp/array1d.h>
+#include <cusp/coo_matrix.h>
+#include <cusp/csr_matrix.h>
+#include <cusp/exception.h>
+#include <cusp/permutation_matrix.h>
+#include <cusp/version.h>
+
+#include <cusp/detail/timer.h>
+
+#include <cusp/gallery/grid.h>
+#include <cusp/gallery/poisson.h>
+#include <cusp/graph/breadth_first_search.h>
+#include <cusp/graph/connected_components.h>
+#include <cusp/graph/maximal_independent_set.h>
+#include <cusp/graph/symmetric_rcm.h>
+#include <cusp/graph/vertex_coloring.h>
+#include <cusp/io/binary.h>
+#include <cusp/io/dimacs.h>
+#include <cusp/io/matrix_market.h>
+
+#include <thrust/fill.h>
+#include <thrust/version.h>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <map>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Runs the graph algorithms of cusp on a collection of graphs: BFS from many
+// sources reported in GTEPS, connected components, maximal independent sets,
+// every coloring method and RCM, together with the quality of the results
+// (number of colors, bandwidth and profile after RCM). Every graph is
+// symmetrized and stripped of its self loops first. The algorithms run in
+// host and device memory; the CUDA, OMP and TBB backends are compared by
+// building with scons backend=cuda|omp|tbb, running each build with
+// --output and passing the files to compare_graphs.py.
+
+typedef std::map<std::string, std::string> ArgumentMap;
+ArgumentMap args;
+std::vector<std::string> graphs;
+
+void process_args(int argc, char ** argv)
+{
+    for(int i = 1; i < argc; i++)
+    {
+        std::string arg(argv[i]);
+
+        if (arg.substr(0,2) == "--")
+        {
+            std::string::size_type n = arg.find('=',2);
+
+            if (n == std::string::npos)
+                args[arg.substr(2)] = std::string();              // (key)
+            else
+                args[arg.substr(2, n - 2)] = arg.substr(n + 1);   // (key,value)
+        }
+        else
+        {
+            graphs.push_back(arg);
+        }
+    }
+}
+
+std::string get_arg(const std::string& key, const std::string& default_value)
+{
+    return args.count(key) ? args[key] : default_value;
+}
+
+void usage(char** argv)
+{
+    std::cout << "Usage:\n";
+    std::cout << "\t" << argv[0] << " [graph ...] [options]\n\n";
+    std::cout << "Graphs (default grid2d:1024x1024 grid3d:96x96x96 poisson27pt:64x64x64):\n";
+    std::cout << "\tG.gr, G.max, G.dimacs  DIMACS file (shortest path or max flow format)\n";
+    std::cout << "\tG.mtx                  MatrixMarket file\n";
+    std::cout << "\tG.bin                  cusp binary file\n";
+    std::cout << "\tgrid2d:NXxNY           also grid3d:NXxNYxNZ, poisson5pt, poisson9pt, poisson7pt, poisson27pt\n\n";
+    std::cout << "Options:\n";
+    std::cout << "\t--memory=host,device   memory spaces the algorithms run in\n";
+    std::cout << "\t--device=0             CUDA device\n";
+    std::cout << "\t--sources=16           number of BFS sources\n";
+    std::cout << "\t--seed=1               seed of the random BFS sources\n";
+    std::cout << "\t--repeat=3             runs of every measurement, the fastest is reported\n";
+    std::cout << "\t--output=graph.json    file receiving the results as JSON\n";
+}
+
+std::vector<size_t> parse_dimensions(const std::string& spec)
+{
+    std::vector<size_t> dims;
+    std::istringstream stream(spec);
+    std::string token;
+
+    while (std::getline(stream, token, 'x'))
+        dims.push_back(std::atoi(token.c_str()));
+
+    return dims;
+}
+
+bool has_suffix(const std::string& name, const std::string& suffix)
+{
+    return name.size() > suffix.size() && name.substr(name.size() - suffix.size()) == suffix;
+}
+
+template <typename Matrix>
+void read_graph(Matrix& A, const std::string& spec)
+{
+    const std::string::size_type colon = spec.find(':');
+
+    const std::string name = spec.substr(0, colon);
+    const std::vector<size_t> dims = colon == std::string::npos ? std::vector<size_t>() : parse_dimensions(spec.substr(colon + 1));
+
+    if      (name == "grid2d"      && dims.size() == 2) cusp::gallery::grid2d     (A, dims[0], dims[1]);
+    else if (name == "grid3d"      && dims.size() == 3) cusp::gallery::grid3d     (A, dims[0], dims[1], dims[2]);
+    else if (name == "poisson5pt"  && dims.size() == 2) cusp::gallery::poisson5pt (A, dims[0], dims[1]);
+    else if (name == "poisson9pt"  && dims.size() == 2) cusp::gallery::poisson9pt (A, dims[0], dims[1]);
+    else if (name == "poisson7pt"  && dims.size() == 3) cusp::gallery::poisson7pt (A, dims[0], dims[1], dims[2]);
+    else if (name == "poisson27pt" && dims.size() == 3) cusp::gallery::poisson27pt(A, dims[0], dims[1], dims[2]);
+    else if (has_suffix(spec, ".gr") || has_suffix(spec, ".max") || has_suffix(spec, ".dimacs"))
+        cusp::io::read_dimacs_file(A, spec);
+    else if (has_suffix(spec, ".bin"))
+        cusp::io::read_binary_file(A, spec);
+    else
+        cusp::io::read_matrix_market_file(A, spec);
+}
+
+// the pattern of A + A^T without the diagonal, the graph all algorithms
+// below expect
+template <typename IndexType, typename ValueType>
+void symmetrize(const cusp::coo_matrix<IndexType,ValueType,cusp::host_memory>& A,
+                cusp::csr_matrix<IndexType,IndexType,cusp::host_memory>& G)
+{
+    std::vector< std::pair<IndexType,IndexType> > edges;
+    edges.reserve(2 * A.num_entries);
+
+    for(size_t n = 0; n < A.num_entries; n++)
+    {
+        const IndexType i = A.row_indices[n];
+        const IndexType j = A.column_indices[n];
+
+        if (i == j)
+            continue;
+
+        edges.push_back(std::make_pair(i, j));
+        edges.push_back(std::make_pair(j, i));
+    }
+
+    std::sort(edges.begin(), edges.end());
+    edges.erase(std::unique(edges.begin(), edges.end()), edges.end());
+
+    const size_t N = std::max(A.num_rows, A.num_cols);
+
+    G.resize(N, N, edges.size());
+    thrust::fill(G.row_offsets.begin(), G.row_offsets.end(), IndexType(0));
+
+    for(size_t n = 0; n < edges.size(); n++)
+    {
+        G.row_offsets[edges[n].first + 1]++;
+        G.column_indices[n] = edges[n].second;
+        G.values[n] = 1;
+    }
+
+    for(size_t i = 0; i < N; i++)
+        G.row_offsets[i + 1] += G.row_offsets[i];
+}
+
+// largest |i - j| over the entries and the envelope size, the sum over the
+// rows of the distance from the first entry to the diagonal
+template <typename IndexType>
+void bandwidth_and_profile(const cusp::csr_matrix<IndexType,IndexType,cusp::host_memory>& G,
+                           size_t& bandwidth, size_t& profile)
+{
+    bandwidth = 0;
+    profile   = 0;
+
+    for(size_t i = 0; i < G.num_rows; i++)
+    {
+        size_t first = i;
+
+        for(IndexType jj = G.row_offsets[i]; jj < G.row_offsets[i + 1]; jj++)
+        {
+            const size_t j = G.column_indices[jj];
+
+            bandwidth = std::max(bandwidth, j > i ? j - i : i - j);
+            first     = std::min(first, j);
+        }
+
+        profile += i - first;
+    }
+}
+
+std::string backend_name(void)
+{
+#if   THRUST_DEVICE_SYSTEM == THRUST_DEVICE_SYSTEM_CUDA
+    return "cuda";
+#elif THRUST_DEVICE_SYSTEM == THRUST_DEVICE_SYSTEM_OMP
+    return "omp";
+#elif THRUST_DEVICE_SYSTEM == THRUST_DEVICE_SYSTEM_TBB
+    return "tbb";
+#else
+    return "cpp";
+#endif
+}
+
+std::string device_name(void)
+{
+#if THRUST_DEVICE_SYSTEM == THRUST_DEVICE_SYSTEM_CUDA
+    int device_id = 0;
+    cudaDeviceProp properties;
+
+    if (cudaGetDevice(&device_id) != cudaSuccess ||
+        cudaGetDeviceProperties(&properties, device_id) != cudaSuccess)
+        return "unknown";
+
+    return properties.name;
+#else
+    return "host";
+#endif
+}
+
+int num_threads(void)
+{
+#ifdef _OPENMP
+    return omp_get_max_threads();
+#else
+    return 1;
+#endif
+}
+
+struct bfs_result
+{
+    size_t num_sources;
+    double min_seconds;
+    double median_seconds;
+    double min_gteps;
+    double max_gteps;
+    double gteps;           // harmonic mean over the sources
+    double mean_reached;    // average fraction of the vertices reached
+    size_t max_depth;
+
+    bfs_result(void)
+      : num_sources(0), min_seconds(0), median_seconds(0), min_gteps(0),
+        max_gteps(0), gteps(0), mean_reached(0), max_depth(0) {}
+};
+
+struct coloring_result
+{
+    std::string method;
+    double seconds;
+    size_t num_colors;
+    size_t min_class_size;
+    size_t max_class_size;
+    size_t num_conflicts;   // edges joining vertices of the same color
+
+    coloring_result(void)
+      : seconds(0), num_colors(0), min_class_size(0), max_class_size(0), num_conflicts(0) {}
+};
+
+struct memory_result
+{
+    std::string memory;
+
+    bfs_result bfs;
+
+    double cc_seconds;
+    size_t num_components;
+
+    double mis_seconds;
+    size_t mis_size;
+
+    std::vector<coloring_result> colorings;
+
+    double rcm_seconds;
+    size_t rcm_bandwidth;
+    size_t rcm_profile;
+
+    memory_result(void)
+      : cc_seconds(0), num_components(0), mis_seconds(0), mis_size(0),
+        rcm_seconds(0), rcm_bandwidth(0), rcm_profile(0) {}
+};
+
+struct graph_result
+{
+    std::string name;
+    size_t num_vertices;
+    size_t num_edges;       // undirected edges
+    size_t bandwidth;
+    size_t profile;
+
+    std::vector<memory_result> runs;
+
+    graph_result(void) : num_vertices(0), num_edges(0), bandwidth(0), profile(0) {}
+};
+
+double median_of(std::vector<double> values)
+{
+    std::sort(values.begin(), values.end());
+
+    const size_t n = values.size();
+
+    return (n % 2) ? values[n / 2] : 0.5 * (values[n / 2 - 1] + values[n / 2]);
+}
+
+// best of repeat runs of f(), which must be repeatable
+template <typename Function>
+double time_best(Function f, size_t repeat)
+{
+    double best = std::numeric_limits<double>::max();
+
+    for(size_t r = 0; r < repeat; r++)
+    {
+        cusp::detail::timer t;
+        f();
+        best = std::min(best, t.seconds_elapsed());
+    }
+
+    return best;
+}
+
+template <typename Graph, typename Array>
+struct bfs_call
+{
+    const Graph& G; size_t src; Array& labels;
+    bfs_call(const Graph& G, size_t src, Array& labels) : G(G), src(src), labels(labels) {}
+    void operator()(void) { cusp::graph::breadth_first_search(G, src, labels, true); }
+};
+
+template <typename Graph, typename Array>
+struct cc_call
+{
+    const Graph& G; Array& components; size_t& count;
+    cc_call(const Graph& G, Array& components, size_t& count) : G(G), components(components), count(count) {}
+    void operator()(void) { count = cusp::graph::connected_components(G, components); }
+};
+
+template <typename Graph, typename Array>
+struct mis_call
+{
+    const Graph& G; Array& stencil; size_t& count;
+    mis_call(const Graph& G, Array& stencil, size_t& count) : G(G), stencil(stencil), count(count) {}
+    void operator()(void) { count = cusp::graph::maximal_independent_set(G, stencil); }
+};
+
+template <typename Graph, typename Array>
+struct coloring_call
+{
+    const Graph& G; Array& colors; cusp::graph::coloring_method method; size_t& count;
+    coloring_call(const Graph& G, Array& colors, cusp::graph::coloring_method method, size_t& count)
+      : G(G), colors(colors), method(method), count(count) {}
+    void operator()(void) { count = cusp::graph::vertex_coloring(G, colors, method); }
+};
+
+template <typename Graph, typename Permutation>
+struct rcm_call
+{
+    const Graph& G; Permutation& P;
+    rcm_call(const Graph& G, Permutation& P) : G(G), P(P) {}
+    void operator()(void) { cusp::graph::symmetric_rcm(G, P); }
+};
+
+// Times BFS from every source. A search traverses the undirected edges
+// incident to the vertices it reaches, the edge count of the Graph 500
+// TEPS metric, whose harmonic mean over the sources is reported.
+template <typename IndexType, typename MemorySpace>
+void benchmark_bfs(const cusp::csr_matrix<IndexType,IndexType,cusp::host_memory>& G_host,
+                   const std::vector<size_t>& sources, size_t repeat, bfs_result& r)
+{
+    typedef cusp::csr_matrix<IndexType,IndexType,MemorySpace> Graph;
+    typedef cusp::array1d<IndexType,MemorySpace>              Array;
+
+    const Graph G(G_host);
+    Array labels(G.num_rows);
+
+    std::vector<double> seconds, teps;
+    double reached = 0;
+
+    for(size_t s = 0; s < sources.size(); s++)
+    {
+        const double t = time_best(bfs_call<Graph,Array>(G, sources[s], labels), repeat);
+
+        const cusp::array1d<IndexType,cusp::host_memory> levels(labels);
+
+        size_t num_reached = 0, num_arcs = 0;
+
+        for(size_t i = 0; i < G_host.num_rows; i++)
+        {
+            if (levels[i] < 0)
+                continue;
+
+            num_reached++;
+            num_arcs   += G_host.row_offsets[i + 1] - G_host.row_offsets[i];
+            r.max_depth = std::max(r.max_depth, size_t(levels[i]));
+        }
+
+        seconds.push_back(t);
+        teps.push_back(t > 0 ? 0.5 * num_arcs / t : 0);
+        reached += double(num_reached) / G_host.num_rows;
+    }
+
+    double inverse_sum = 0;
+    for(size_t s = 0; s < teps.size(); s++)
+        inverse_sum += teps[s] > 0 ? 1.0 / teps[s] : 0;
+
+    r.num_sources    = sources.size();
+    r.min_seconds    = *std::min_element(seconds.begin(), seconds.end());
+    r.median_seconds = median_of(seconds);
+    r.min_gteps      = 1e-9 * *std::min_element(teps.begin(), teps.end());
+    r.max_gteps      = 1e-9 * *std::max_element(teps.begin(), teps.end());
+    r.gteps          = inverse_sum > 0 ? 1e-9 * teps.size() / inverse_sum : 0;
+    r.mean_reached   = reached / sources.size();
+}
+
+template <typename IndexType>
+coloring_result coloring_quality(const cusp::csr_matrix<IndexType,IndexType,cusp::host_memory>& G,
+                                 const cusp::array1d<IndexType,cusp::host_memory>& colors, size_t num_colors)
+{
+    coloring_result r;
+    r.num_colors = num_colors;
+
+    std::vector<size_t> class_sizes(num_colors, 0);
+
+    for(size_t i = 0; i < G.num_rows; i++)
+    {
+        if (size_t(colors[i]) < num_colors)
+            class_sizes[colors[i]]++;
+
+        for(IndexType jj = G.row_offsets[i]; jj < G.row_offsets[i + 1]; jj++)
+            if (size_t(G.column_indices[jj]) > i && colors[G.column_indices[jj]] == colors[i])
+                r.num_conflicts++;
+    }
+
+    if (num_colors > 0)
+    {
+        r.min_class_size = *std::min_element(class_sizes.begin(), class_sizes.end());
+        r.max_class_size = *std::max_element(class_sizes.begin(), class_sizes.end());
+    }
+
+    return r;
+}
+
+template <typename IndexType, typename MemorySpace>
+void benchmark_graph(const cusp::csr_matrix<IndexType,IndexType,cusp::host_memory>& G_host,
+                     const std::vector<size_t>& sources, size_t repeat, memory_result& r)
+{
+    typedef cusp::csr_matrix<IndexType,IndexType,MemorySpace> Graph;
+    typedef cusp::array1d<IndexType,MemorySpace>              Array;
+
+    benchmark_bfs<IndexType,MemorySpace>(G_host, sources, repeat, r.bfs);
+
+    const Graph G(G_host);
+    Array work(G.num_rows);
+
+    r.cc_seconds  = time_best(cc_call<Graph,Array>(G, work, r.num_components), repeat);
+    r.mis_seconds = time_best(mis_call<Graph,Array>(G, work, r.mis_size), repeat);
+
+    const cusp::graph::coloring_method methods[] = {cusp::graph::GREEDY,
+                                                    cusp::graph::JONES_PLASSMANN_LUBY,
+                                                    cusp::graph::SPECULATIVE_GREEDY};
+    const char* method_names[] = {"greedy", "jones_plassmann_luby", "speculative_greedy"};
+
+    for(size_t m = 0; m < 3; m++)
+    {
+        size_t num_colors = 0;
+
+        const double t = time_best(coloring_call<Graph,Array>(G, work, methods[m], num_colors), repeat);
+
+        coloring_result c = coloring_quality(G_host, cusp::array1d<IndexType,cusp::host_memory>(work), num_colors);
+        c.method  = method_names[m];
+        c.seconds = t;
+
+        r.colorings.push_back(c);
+    }
+
+    cusp::permutation_matrix<IndexType,MemorySpace> P(G.num_rows);
+
+    r.rcm_seconds = time_best(rcm_call<Graph, cusp::permutation_matrix<IndexType,MemorySpace> >(G, P), repeat);
+
+    Graph G_rcm(G);
+    P.symmetric_permute(G_rcm);
+
+    bandwidth_and_profile(cusp::csr_matrix<IndexType,IndexType,cusp::host_memory>(G_rcm), r.rcm_bandwidth, r.rcm_profile);
+}
+
+void print_result(const graph_result& g)
+{
+    std::cout << g.name << ": " << g.num_vertices << " vertices, " << g.num_edges << " edges, "
+              << "bandwidth " << g.bandwidth << ", profile " << g.profile << std::endl;
+
+    std::cout << std::fixed;
+
+    for(size_t n = 0; n < g.runs.size(); n++)
+    {
+        const memory_result& r = g.runs[n];
+
+        std::cout << "  " << r.memory << std::endl;
+        std::cout << std::setprecision(3)
+                  << "    BFS    " << r.bfs.num_sources << " sources, median " << 1e3 * r.bfs.median_seconds << " ms, "
+                  << std::setprecision(4) << r.bfs.gteps << " GTEPS (min " << r.bfs.min_gteps << ", max " << r.bfs.max_gteps << "), "
+                  << std::setprecision(1) << 1e2 * r.bfs.mean_reached << "% reached, depth " << r.bfs.max_depth << std::endl;
+        std::cout << std::setprecision(3)
+                  << "    CC     " << 1e3 * r.cc_seconds << " ms, " << r.num_components << " components" << std::endl;
+        std::cout << "    MIS    " << 1e3 * r.mis_seconds << " ms, " << r.mis_size << " vertices" << std::endl;
+
+        for(size_t m = 0; m < r.colorings.size(); m++)
+        {
+            const coloring_result& c = r.colorings[m];
+
+            std::cout << "    color  " << std::setw(22) << std::left << c.method << std::right
+                      << 1e3 * c.seconds << " ms, " << c.num_colors << " colors, classes "
+                      << c.min_class_size << " - " << c.max_class_size;
+
+            if (c.num_conflicts)
+                std::cout << ", " << c.num_conflicts << " CONFLICTS";
+
+            std::cout << std::endl;
+        }
+
+        std::cout << "    RCM    " << 1e3 * r.rcm_seconds << " ms, bandwidth " << r.rcm_bandwidth
+                  << ", profile " << r.rcm_profile << std::endl;
+    }
+
+    std::cout << std::endl;
+    std::cout.unsetf(std::ios::floatfield);
+}
+
+void write_json(std::ostream& os, const memory_result& r)
+{
+    os << "       {\"memory\": \"" << r.memory << "\",\n";
+    os << "        \"bfs\": {\"sources\": " << r.bfs.num_sources << ", \"min_seconds\": " << r.bfs.min_seconds
+       << ", \"median_seconds\": " << r.bfs.median_seconds << ", \"gteps\": " << r.bfs.gteps
+       << ", \"min_gteps\": " << r.bfs.min_gteps << ", \"max_gteps\": " << r.bfs.max_gteps
+       << ", \"mean_reached\": " << r.bfs.mean_reached << ", \"max_depth\": " << r.bfs.max_depth << "},\n";
+    os << "        \"cc\": {\"seconds\": " << r.cc_seconds << ", \"components\": " << r.num_components << "},\n";
+    os << "        \"mis\": {\"seconds\": " << r.mis_seconds << ", \"size\": " << r.mis_size << "},\n";
+    os << "        \"coloring\": {";
+
+    for(size_t m = 0; m < r.colorings.size(); m++)
+    {
+        const coloring_result& c = r.colorings[m];
+
+        os << (m ? ",\n                     " : "")
+           << "\"" << c.method << "\": {\"seconds\": " << c.seconds << ", \"colors\": " << c.num_colors
+           << ", \"min_class_size\": " << c.min_class_size << ", \"max_class_size\": " << c.max_class_size
+           << ", \"conflicts\": " << c.num_conflicts << "}";
+    }
+
+    os << "},\n";
+    os << "        \"rcm\": {\"seconds\": " << r.rcm_seconds << ", \"bandwidth\": " << r.rcm_bandwidth
+       << ", \"profile\": " << r.rcm_profile << "}}";
+}
+
+void write_json(std::ostream& os, const graph_result& g)
+{
+    os << "    {\"name\": \"" << g.name << "\", \"num_vertices\": " << g.num_vertices << ", \"num_edges\": " << g.num_edges
+       << ", \"bandwidth\": " << g.bandwidth << ", \"profile\": " << g.profile << ",\n";
+    os << "     \"runs\": [\n";
+
+    for(size_t n = 0; n < g.runs.size(); n++)
+    {
+        write_json(os, g.runs[n]);
+        os << (n + 1 < g.runs.size() ? ",\n" : "\n");
+    }
+
+    os << "     ]}";
+}
+
+// sources drawn uniformly from the vertices having neighbors
+template <typename IndexType>
+std::vector<size_t> choose_sources(const cusp::csr_matrix<IndexType,IndexType,cusp::host_memory>& G,
+                                   size_t num_sources, unsigned int seed)
+{
+    std::vector<size_t> candidates;
+
+    for(size_t i = 0; i < G.num_rows; i++)
+        if (G.row_offsets[i + 1] > G.row_offsets[i])
+            candidates.push_back(i);
+
+    if (candidates.empty())
+        candidates.push_back(0);
+
+    std::srand(seed);
+
+    std::vector<size_t> sources(num_sources);
+    for(size_t s = 0; s < num_sources; s++)
+        sources[s] = candidates[std::rand() % candidates.size()];
+
+    return sources;
+}
+
+int run(void)
+{
+    typedef int IndexType;
+
+    const size_t repeat      = std::max(1, std::atoi(get_arg("repeat", "3").c_str()));
+    const size_t num_sources = std::max(1, std::atoi(get_arg("sources", "16").c_str()));
+    const unsigned int seed  = std::atoi(get_arg("seed", "1").c_str());
+    const std::string memory = get_arg("memory", "host,device");
+
+    const bool run_host   = memory.find("host")   != std::string::npos;
+    const bool run_device = memory.find("device") != std::string::npos;
+
+#if THRUST_DEVICE_SYSTEM == THRUST_DEVICE_SYSTEM_CUDA
+    cudaSetDevice(std::atoi(get_arg("device", "0").c_str()));
+#endif
+
+    if (graphs.empty())
+    {
+        graphs.push_back("grid2d:1024x1024");
+        graphs.push_back("grid3d:96x96x96");
+        graphs.push_back("poisson27pt:64x64x64");
+    }
+
+    std::cout << "Backend " << backend_name() << " (" << device_name() << ", "
+              << num_threads() << " host threads)\n" << std::endl;
+
+    std::vector<graph_result> results;
+
+    for(size_t i = 0; i < graphs.size(); i++)
+    {
+        cusp::coo_matrix<IndexType, float, cusp::host_memory> A;
+
+        try
+        {
+            read_graph(A, graphs[i]);
+        }
+        catch (const cusp::exception& e)
+        {
+            std::cerr << "unable to read the graph " << graphs[i] << ": " << e.what() << std::endl;
+            return EXIT_FAILURE;
+        }
+
+        cusp::csr_matrix<IndexType, IndexType, cusp::host_memory> G;
+        symmetrize(A, G);
+
+        graph_result g;
+        g.name         = graphs[i];
+        g.num_vertices = G.num_rows;
+        g.num_edges    = G.num_entries / 2;
+        bandwidth_and_profile(G, g.bandwidth, g.profile);
+
+        const std::vector<size_t> sources = choose_sources(G, num_sources, seed);
+
+        if (run_host)
+        {
+            g.runs.push_back(memory_result());
+            g.runs.back().memory = "host";
+            benchmark_graph<IndexType, cusp::host_memory>(G, sources, repeat, g.runs.back());
+        }
+
+        if (run_device)
+        {
+            g.runs.push_back(memory_result());
+            g.runs.back().memory = "device";
+            benchmark_graph<IndexType, cusp::device_memory>(G, sources, repeat, g.runs.back());
+        }
+
+        print_result(g);
+        results.push_back(g);
+    }
+
+    if (args.count("output"))
+    {
+        std::ofstream os(args["output"].c_str());
+
+        os.precision(9);
+
+        os << "{\n";
+        os << "  \"cusp_version\": \""   << CUSP_MAJOR_VERSION << "." << CUSP_MINOR_VERSION << "." << CUSP_SUBMINOR_VERSION << "\",\n";
+        os << "  \"thrust_version\": \"" << THRUST_MAJOR_VERSION << "." << THRUST_MINOR_VERSION << "." << THRUST_SUBMINOR_VERSION << "\",\n";
+        os << "  \"backend\": \""        << backend_name() << "\",\n";
+        os << "  \"device\": \""         << device_name() << "\",\n";
+        os << "  \"threads\": "          << num_threads() << ",\n";
+        os << "  \"repeat\": "           << repeat << ",\n";
+        os << "  \"seed\": "             << seed << ",\n";
+        os << "  \"graphs\": [\n";
+
+        for(size_t i = 0; i < results.size(); i++)
+        {
+            write_json(os, results[i]);
+            os << (i + 1 < results.size() ? ",\n" : "\n");
+        }
+
+        os << "  ]\n";
+        os << "}\n";
+    }
+
+    return EXIT_SUCCESS;
+}
+
+int main(int argc, char** argv)
+{
+    process_args(argc, argv);
+
+    if (args.count("help"))
+    {
+        usage(argv);
+        return EXIT_SUCCESS;
+    }
+
+    return run();
+}
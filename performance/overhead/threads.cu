@@ -0,0 +1,93 @@
+#include <cusp/array1d.h>
+#include <cusp/csr_matrix.h>
+#include <cusp/linear_operator.h>
+#include <cusp/monitor.h>
+
+#include <cusp/gallery/poisson.h>
+#include <cusp/krylov/cg.h>
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <iomanip>
+#include <thread>
+#include <vector>
+
+// Throughput of independent small solves issued from several host threads.
+// Every thread owns its matrices and a non-blocking stream, so the solves
+// only share the device.  Requires C++11, e.g. nvcc -std=c++11.
+
+const int    grid_size         = 64;
+const size_t solves_per_thread = 64;
+
+void solve_loop(void)
+{
+    typedef cusp::csr_matrix<int, float, cusp::device_memory> Matrix;
+
+    Matrix A;
+    cusp::gallery::poisson5pt(A, grid_size, grid_size);
+
+    cusp::array1d<float, cusp::device_memory> b(A.num_rows, 1);
+    cusp::array1d<float, cusp::device_memory> x(A.num_rows);
+
+    cusp::identity_operator<float, cusp::device_memory> M(A.num_rows, A.num_rows);
+
+    cudaStream_t s;
+    cudaStreamCreateWithFlags(&s, cudaStreamNonBlocking);
+
+    for (size_t i = 0; i < solves_per_thread; i++)
+    {
+        thrust::fill(cusp::cuda::par.on(s), x.begin(), x.end(), 0.0f);
+
+        cusp::monitor<float> monitor(cusp::cuda::par.on(s), b, 50, 0);
+        cusp::krylov::cg(cusp::cuda::par.on(s), A, x, b, monitor, M);
+    }
+
+    cudaStreamSynchronize(s);
+    cudaStreamDestroy(s);
+}
+
+double solves_per_second(const size_t num_threads)
+{
+    std::chrono::high_resolution_clock::time_point start = std::chrono::high_resolution_clock::now();
+
+    std::vector<std::thread> threads;
+
+    for (size_t t = 0; t < num_threads; t++)
+        threads.push_back(std::thread(solve_loop));
+
+    for (size_t t = 0; t < num_threads; t++)
+        threads[t].join();
+
+    std::chrono::duration<double> elapsed = std::chrono::high_resolution_clock::now() - start;
+
+    return (num_threads * solves_per_thread) / elapsed.count();
+}
+
+int main(void)
+{
+    // warm up the context, the launch configuration cache and the handles
+    solve_loop();
+
+    const size_t max_threads = std::max<size_t>(1, std::thread::hardware_concurrency());
+
+    double base = 0;
+
+    std::cout << std::setw(12) << "threads"
+              << std::setw(16) << "solves/s"
+              << std::setw(12) << "speedup" << std::endl;
+
+    for (size_t num_threads = 1; num_threads <= max_threads && num_threads <= 32; num_threads *= 2)
+    {
+        const double rate = solves_per_second(num_threads);
+
+        if (num_threads == 1)
+            base = rate;
+
+        std::cout << std::setw(12) << num_threads
+                  << std::setw(16) << std::setiosflags(std::ios::fixed) << std::setprecision(1) << rate
+                  << std::setw(12) << std::setprecision(2) << rate / base << std::endl;
+    }
+
+    return 0;
+}
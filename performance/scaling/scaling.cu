@@ -0,0 +1,638 @@
+#include <cusp/array1d.h>
+#include <cusp/convert.h>
+#include <cusp/coo_matrix.h>
+#include <cusp/csr_matrix.h>
+#include <cusp/exception.h>
+#include <cusp/hyb_matrix.h>
+#include <cusp/monitor.h>
+#include <cusp/multiply.h>
+
+#include <cusp/blas/blas.h>
+#include <cusp/detail/timer.h>
+#include <cusp/gallery/poisson.h>
+#include <cusp/io/binary.h>
+#include <cusp/io/matrix_market.h>
+#include <cusp/krylov/cg.h>
+#include <cusp/precond/aggregation/smoothed_aggregation.h>
+#include <cusp/relaxation/gauss_seidel.h>
+
+#if THRUST_DEVICE_SYSTEM == THRUST_DEVICE_SYSTEM_OMP
+#include <omp.h>
+#elif THRUST_DEVICE_SYSTEM == THRUST_DEVICE_SYSTEM_TBB
+#include <tbb/global_control.h>
+#include <tbb/task_arena.h>
+#include <tbb/task_scheduler_observer.h>
+#endif
+
+#ifdef __linux__
+#include <sched.h>
+#endif
+
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// Strong scaling of the host backends. Every kernel runs once on the
+// sequential host system and then on the device system the program is
+// built for (scons backend=omp|tbb) for every thread count and every
+// binding of threads to cores. The speedup and parallel efficiency of each
+// run are reported against the sequential time, and kernels whose speedup
+// stops growing or whose efficiency drops below a threshold are flagged.
+//
+// The containers are allocated after the threads of a configuration are
+// bound, so with the OpenMP backend the first touch placement of
+// cusp::numa_allocator follows the threads of that configuration.
+
+typedef std::map<std::string, std::string> ArgumentMap;
+ArgumentMap args;
+
+void process_args(int argc, char ** argv)
+{
+    for(int i = 1; i < argc; i++)
+    {
+        std::string arg(argv[i]);
+
+        if (arg.substr(0,2) == "--")
+        {
+            std::string::size_type n = arg.find('=',2);
+
+            if (n == std::string::npos)
+                args[arg.substr(2)] = std::string();              // (key)
+            else
+                args[arg.substr(2, n - 2)] = arg.substr(n + 1);   // (key,value)
+        }
+        else
+        {
+            args["matrix"] = arg;
+        }
+    }
+}
+
+std::string get_arg(const std::string& key, const std::string& default_value)
+{
+    return args.count(key) ? args[key] : default_value;
+}
+
+void usage(char** argv)
+{
+    std::cout << "Usage:\n";
+    std::cout << "\t" << argv[0] << " [matrix] [options]\n\n";
+    std::cout << "Matrix (default poisson7pt:64x64x64):\n";
+    std::cout << "\tA.mtx                      MatrixMarket file\n";
+    std::cout << "\tA.bin                      cusp binary file\n";
+    std::cout << "\tpoisson5pt:NXxNY           also poisson9pt, poisson7pt:NXxNYxNZ, poisson27pt:NXxNYxNZ\n\n";
+    std::cout << "Options:\n";
+    std::cout << "\t--threads=1,2,4            thread counts, default powers of two up to all cores\n";
+    std::cout << "\t--bindings=close,spread    bindings of threads to cores (none, close, spread, default all)\n";
+    std::cout << "\t                           close fills the cores of one socket first, spread\n";
+    std::cout << "\t                           alternates between sockets, none leaves placement to the OS\n";
+    std::cout << "\t--repeat=5                 runs of every kernel, the fastest is reported\n";
+    std::cout << "\t--efficiency=0.5           parallel efficiency below which a kernel is flagged\n";
+    std::cout << "\t--min_gain=1.1             speedup growth per thread count below which a kernel is flagged\n";
+}
+
+std::vector<size_t> parse_list(const std::string& spec, char separator)
+{
+    std::vector<size_t> values;
+    std::istringstream stream(spec);
+    std::string token;
+
+    while (std::getline(stream, token, separator))
+        if (!token.empty())
+            values.push_back(std::atoi(token.c_str()));
+
+    return values;
+}
+
+template <typename Matrix>
+void read_matrix(Matrix& A, const std::string& spec)
+{
+    const std::string::size_type colon = spec.find(':');
+
+    const std::string name = spec.substr(0, colon);
+    const std::vector<size_t> dims = colon == std::string::npos ? std::vector<size_t>() : parse_list(spec.substr(colon + 1), 'x');
+
+    if      (name == "poisson5pt"  && dims.size() == 2) cusp::gallery::poisson5pt (A, dims[0], dims[1]);
+    else if (name == "poisson9pt"  && dims.size() == 2) cusp::gallery::poisson9pt (A, dims[0], dims[1]);
+    else if (name == "poisson7pt"  && dims.size() == 3) cusp::gallery::poisson7pt (A, dims[0], dims[1], dims[2]);
+    else if (name == "poisson27pt" && dims.size() == 3) cusp::gallery::poisson27pt(A, dims[0], dims[1], dims[2]);
+    else if (spec.size() > 4 && spec.substr(spec.size() - 4) == ".bin")
+        cusp::io::read_binary_file(A, spec);
+    else
+        cusp::io::read_matrix_market_file(A, spec);
+}
+
+std::string backend_name(void)
+{
+#if   THRUST_DEVICE_SYSTEM == THRUST_DEVICE_SYSTEM_OMP
+    return "omp";
+#elif THRUST_DEVICE_SYSTEM == THRUST_DEVICE_SYSTEM_TBB
+    return "tbb";
+#else
+    return "cpp";
+#endif
+}
+
+// thread placement
+
+#ifdef __linux__
+cpu_set_t initial_mask;
+#endif
+
+int read_topology(int cpu, const char * field, int default_value)
+{
+    std::ostringstream path;
+    path << "/sys/devices/system/cpu/cpu" << cpu << "/topology/" << field;
+
+    std::ifstream file(path.str().c_str());
+
+    int value = default_value;
+    file >> value;
+
+    return file ? value : default_value;
+}
+
+struct cpu_info
+{
+    int cpu, package, core, smt, rank;
+};
+
+bool close_order(const cpu_info& a, const cpu_info& b)
+{
+    if (a.smt     != b.smt)     return a.smt     < b.smt;
+    if (a.package != b.package) return a.package < b.package;
+    if (a.core    != b.core)    return a.core    < b.core;
+    return a.cpu < b.cpu;
+}
+
+bool spread_order(const cpu_info& a, const cpu_info& b)
+{
+    if (a.smt     != b.smt)     return a.smt     < b.smt;
+    if (a.rank    != b.rank)    return a.rank    < b.rank;
+    return a.package < b.package;
+}
+
+// the cpus the process may run on, in the order threads are bound to them:
+// physical cores before their hyperthreads, and either all cores of one
+// socket before the next (close) or the sockets in turn (spread)
+std::vector<int> cpu_order(const std::string& binding)
+{
+    std::vector<int> order;
+
+#ifdef __linux__
+    if (binding == "none")
+        return order;
+
+    std::vector<cpu_info> cpus;
+
+    for(int cpu = 0; cpu < CPU_SETSIZE; cpu++)
+    {
+        if (!CPU_ISSET(cpu, &initial_mask))
+            continue;
+
+        cpu_info info;
+        info.cpu     = cpu;
+        info.package = read_topology(cpu, "physical_package_id", 0);
+        info.core    = read_topology(cpu, "core_id", cpu);
+        info.smt     = 0;
+        info.rank    = 0;
+
+        for(size_t i = 0; i < cpus.size(); i++)
+            if (cpus[i].package == info.package && cpus[i].core == info.core)
+                info.smt++;
+
+        cpus.push_back(info);
+    }
+
+    std::sort(cpus.begin(), cpus.end(), close_order);
+
+    // position of every cpu among the cpus of its socket and hyperthread level
+    std::map< std::pair<int,int>, int > ranks;
+    for(size_t i = 0; i < cpus.size(); i++)
+        cpus[i].rank = ranks[std::make_pair(cpus[i].smt, cpus[i].package)]++;
+
+    if (binding == "spread")
+        std::sort(cpus.begin(), cpus.end(), spread_order);
+
+    for(size_t i = 0; i < cpus.size(); i++)
+        order.push_back(cpus[i].cpu);
+#endif
+
+    return order;
+}
+
+size_t num_cores(void)
+{
+#ifdef __linux__
+    return CPU_COUNT(&initial_mask);
+#elif THRUST_DEVICE_SYSTEM == THRUST_DEVICE_SYSTEM_OMP
+    return omp_get_num_procs();
+#else
+    return 1;
+#endif
+}
+
+// binds the calling thread to cpu, or releases it when cpu is negative
+void bind_thread(int cpu)
+{
+#ifdef __linux__
+    cpu_set_t mask = initial_mask;
+
+    if (cpu >= 0)
+    {
+        CPU_ZERO(&mask);
+        CPU_SET(cpu, &mask);
+    }
+
+    sched_setaffinity(0, sizeof(mask), &mask);
+#endif
+}
+
+#if THRUST_DEVICE_SYSTEM == THRUST_DEVICE_SYSTEM_TBB
+// binds every thread joining the arena to the cpu of its slot
+class binding_observer : public ::tbb::task_scheduler_observer
+{
+    std::vector<int> cpus;
+
+public:
+
+    binding_observer(const std::vector<int>& cpus) : cpus(cpus)
+    {
+        observe(true);
+    }
+
+    ~binding_observer(void)
+    {
+        observe(false);
+    }
+
+    void on_scheduler_entry(bool)
+    {
+        const int slot = ::tbb::this_task_arena::current_thread_index();
+
+        bind_thread(cpus.empty() ? -1 : cpus[slot % cpus.size()]);
+    }
+};
+#endif
+
+// limits the device system to num_threads threads bound as binding asks,
+// for as long as the object lives
+class thread_configuration
+{
+#if THRUST_DEVICE_SYSTEM == THRUST_DEVICE_SYSTEM_TBB
+    ::tbb::global_control control;
+    binding_observer      observer;
+#endif
+
+public:
+
+    thread_configuration(size_t num_threads, const std::vector<int>& cpus)
+#if THRUST_DEVICE_SYSTEM == THRUST_DEVICE_SYSTEM_TBB
+      : control(::tbb::global_control::max_allowed_parallelism, num_threads), observer(cpus)
+#endif
+    {
+#if THRUST_DEVICE_SYSTEM == THRUST_DEVICE_SYSTEM_OMP
+        omp_set_dynamic(0);
+        omp_set_num_threads(num_threads);
+
+        // the threads of the pool keep their binding in later parallel regions
+        #pragma omp parallel
+        bind_thread(cpus.empty() ? -1 : cpus[omp_get_thread_num() % cpus.size()]);
+#else
+        bind_thread(cpus.empty() ? -1 : cpus[0]);
+#endif
+    }
+};
+
+// kernels, every call leaves the inputs ready for the next one
+
+template <typename Kernel>
+double fastest_run(Kernel kernel, size_t repeat)
+{
+    kernel();
+
+    double best = std::numeric_limits<double>::max();
+
+    for(size_t i = 0; i < repeat; i++)
+    {
+        cusp::detail::timer t;
+        kernel();
+        best = std::min(best, t.seconds_elapsed());
+    }
+
+    return best;
+}
+
+template <typename Matrix, typename Array>
+struct spmv_kernel
+{
+    const Matrix& A;
+    const Array&  x;
+    Array&        y;
+
+    spmv_kernel(const Matrix& A, const Array& x, Array& y) : A(A), x(x), y(y) {}
+
+    void operator()(void)
+    {
+        cusp::multiply(A, x, y);
+    }
+};
+
+template <typename Matrix>
+struct spgemm_kernel
+{
+    const Matrix& A;
+    Matrix&       C;
+
+    spgemm_kernel(const Matrix& A, Matrix& C) : A(A), C(C) {}
+
+    void operator()(void)
+    {
+        cusp::multiply(A, A, C);
+    }
+};
+
+template <typename Matrix1, typename Matrix2>
+struct convert_kernel
+{
+    const Matrix1& A;
+    Matrix2&       B;
+
+    convert_kernel(const Matrix1& A, Matrix2& B) : A(A), B(B) {}
+
+    void operator()(void)
+    {
+        cusp::convert(A, B);
+    }
+};
+
+template <typename Array>
+struct axpy_kernel
+{
+    const Array& x;
+    Array&       y;
+
+    axpy_kernel(const Array& x, Array& y) : x(x), y(y) {}
+
+    void operator()(void)
+    {
+        cusp::blas::axpy(x, y, typename Array::value_type(1e-6));
+    }
+};
+
+template <typename Array>
+struct dot_kernel
+{
+    const Array& x;
+    const Array& y;
+
+    dot_kernel(const Array& x, const Array& y) : x(x), y(y) {}
+
+    void operator()(void)
+    {
+        volatile typename Array::value_type result = cusp::blas::dot(x, y);
+        (void) result;
+    }
+};
+
+template <typename Matrix, typename Array, typename Relaxation>
+struct relaxation_kernel
+{
+    const Matrix& A;
+    const Array&  b;
+    Array&        x;
+    Relaxation&   M;
+
+    relaxation_kernel(const Matrix& A, const Array& b, Array& x, Relaxation& M) : A(A), b(b), x(x), M(M) {}
+
+    void operator()(void)
+    {
+        M(A, b, x);
+    }
+};
+
+// hierarchy setup and a fixed number of iterations, so the work does not
+// depend on the rounding of the backend
+template <typename Matrix, typename Array>
+struct amg_cg_kernel
+{
+    typedef typename Matrix::index_type   IndexType;
+    typedef typename Matrix::value_type   ValueType;
+    typedef typename Matrix::memory_space MemorySpace;
+
+    const Matrix& A;
+    Array&        x;
+    const Array&  b;
+
+    amg_cg_kernel(const Matrix& A, Array& x, const Array& b) : A(A), x(x), b(b) {}
+
+    void operator()(void)
+    {
+        cusp::precond::aggregation::smoothed_aggregation<IndexType, ValueType, MemorySpace> M(A);
+
+        cusp::blas::fill(x, ValueType(0));
+
+        cusp::monitor<ValueType> monitor(b, 20, 0);
+        cusp::krylov::cg(A, x, b, monitor, M);
+    }
+};
+
+const char * kernel_names[] = {"spmv_csr", "spgemm_csr", "convert_csr_to_coo", "convert_csr_to_hyb",
+                               "blas_axpy", "blas_dot", "gauss_seidel", "amg_cg"};
+
+const size_t num_kernels = sizeof(kernel_names) / sizeof(kernel_names[0]);
+
+// seconds of every kernel in kernel_names, the containers are allocated here
+// so they are placed by the threads of the current configuration
+template <typename MemorySpace, typename IndexType, typename ValueType>
+std::vector<double> run_kernels(const cusp::csr_matrix<IndexType, ValueType, cusp::host_memory>& csr, size_t repeat)
+{
+    typedef cusp::array1d<ValueType, MemorySpace>               Array;
+    typedef cusp::csr_matrix<IndexType, ValueType, MemorySpace> CsrMatrix;
+    typedef cusp::coo_matrix<IndexType, ValueType, MemorySpace> CooMatrix;
+    typedef cusp::hyb_matrix<IndexType, ValueType, MemorySpace> HybMatrix;
+    typedef cusp::relaxation::gauss_seidel<ValueType, MemorySpace> Relaxation;
+
+    CsrMatrix A(csr);
+
+    Array x(A.num_cols, 1);
+    Array y(A.num_rows, 0);
+    Array b(A.num_rows, 1);
+
+    std::vector<double> seconds;
+
+    {
+        seconds.push_back(fastest_run(spmv_kernel<CsrMatrix, Array>(A, x, y), repeat));
+    }
+    {
+        CsrMatrix C;
+        seconds.push_back(fastest_run(spgemm_kernel<CsrMatrix>(A, C), repeat));
+    }
+    {
+        CooMatrix B;
+        seconds.push_back(fastest_run(convert_kernel<CsrMatrix, CooMatrix>(A, B), repeat));
+    }
+    {
+        HybMatrix B;
+        seconds.push_back(fastest_run(convert_kernel<CsrMatrix, HybMatrix>(A, B), repeat));
+    }
+
+    seconds.push_back(fastest_run(axpy_kernel<Array>(x, y), repeat));
+    seconds.push_back(fastest_run(dot_kernel<Array>(x, y), repeat));
+
+    {
+        // the multicolor sweep is the parallel one, the sequential run uses it as well
+        Relaxation M(A, cusp::relaxation::SYMMETRIC, true);
+        seconds.push_back(fastest_run(relaxation_kernel<CsrMatrix, Array, Relaxation>(A, b, x, M), repeat));
+    }
+
+    seconds.push_back(fastest_run(amg_cg_kernel<CsrMatrix, Array>(A, x, b), repeat));
+
+    return seconds;
+}
+
+template <typename IndexType, typename ValueType>
+int run(void)
+{
+    const size_t repeat     = std::max(1, std::atoi(get_arg("repeat", "5").c_str()));
+    const double efficiency = std::atof(get_arg("efficiency", "0.5").c_str());
+    const double min_gain   = std::atof(get_arg("min_gain", "1.1").c_str());
+
+    std::vector<size_t> thread_counts = parse_list(get_arg("threads", ""), ',');
+
+    if (thread_counts.empty())
+    {
+        for(size_t n = 1; n < num_cores(); n *= 2)
+            thread_counts.push_back(n);
+        thread_counts.push_back(num_cores());
+    }
+
+    std::vector<std::string> bindings;
+    {
+        std::istringstream stream(get_arg("bindings", "none,close,spread"));
+        std::string binding;
+
+        while (std::getline(stream, binding, ','))
+            if (binding == "none" || binding == "close" || binding == "spread")
+                bindings.push_back(binding);
+    }
+
+    cusp::csr_matrix<IndexType, ValueType, cusp::host_memory> A;
+
+    const std::string matrix = get_arg("matrix", "poisson7pt:64x64x64");
+
+    try
+    {
+        read_matrix(A, matrix);
+    }
+    catch (const cusp::exception& e)
+    {
+        std::cerr << "unable to read the matrix " << matrix << ": " << e.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    std::cout << "Backend " << backend_name() << ", " << num_cores() << " cores, matrix " << matrix
+              << " with shape (" << A.num_rows << "," << A.num_cols << ") and " << A.num_entries << " entries\n" << std::endl;
+
+    // the sequential baseline runs on the first core of a close binding
+    std::vector<double> sequential;
+    {
+        const std::vector<int> cpus = cpu_order("close");
+        bind_thread(cpus.empty() ? -1 : cpus[0]);
+
+        sequential = run_kernels<cusp::host_memory>(A, repeat);
+    }
+
+    std::vector<std::string> flagged;
+
+    for(size_t b = 0; b < bindings.size(); b++)
+    {
+        const std::vector<int> cpus = cpu_order(bindings[b]);
+
+        std::vector< std::vector<double> > seconds;
+
+        for(size_t t = 0; t < thread_counts.size(); t++)
+        {
+            thread_configuration configuration(thread_counts[t], cpus);
+            seconds.push_back(run_kernels<cusp::device_memory>(A, repeat));
+        }
+
+        std::cout << "binding " << bindings[b] << std::endl;
+        std::cout << std::setw(20) << "kernel" << std::setw(9) << "threads" << std::setw(13) << "seconds"
+                  << std::setw(10) << "speedup" << std::setw(12) << "efficiency" << std::endl;
+
+        for(size_t k = 0; k < num_kernels; k++)
+        {
+            std::cout << std::setw(20) << kernel_names[k] << std::setw(9) << "seq"
+                      << std::setw(13) << std::scientific << std::setprecision(3) << sequential[k] << std::endl;
+
+            double previous = 0;
+            bool   stopped  = false;
+
+            for(size_t t = 0; t < thread_counts.size(); t++)
+            {
+                const double speedup = sequential[k] / seconds[t][k];
+                const double parallel_efficiency = speedup / thread_counts[t];
+
+                // first thread count at which the kernel stops scaling
+                const bool stops = !stopped && t > 0 &&
+                                   (parallel_efficiency < efficiency || speedup < min_gain * previous);
+
+                std::cout << std::setw(20) << "" << std::setw(9) << thread_counts[t]
+                          << std::setw(13) << std::scientific << std::setprecision(3) << seconds[t][k]
+                          << std::setw(10) << std::fixed << std::setprecision(2) << speedup
+                          << std::setw(12) << parallel_efficiency
+                          << (stops ? "  <- stops scaling" : "") << std::endl;
+
+                if (stops)
+                {
+                    std::ostringstream note;
+                    note << kernel_names[k] << " (" << bindings[b] << "): speedup " << std::fixed << std::setprecision(2)
+                         << speedup << " at " << thread_counts[t] << " threads after " << previous
+                         << " at " << thread_counts[t - 1];
+                    flagged.push_back(note.str());
+                    stopped = true;
+                }
+
+                previous = speedup;
+            }
+        }
+
+        std::cout << std::endl;
+    }
+
+    if (!flagged.empty())
+    {
+        std::cout << "Kernels which stop scaling (efficiency below " << efficiency
+                  << " or speedup growing less than " << min_gain << "x):" << std::endl;
+
+        for(size_t i = 0; i < flagged.size(); i++)
+            std::cout << "  " << flagged[i] << std::endl;
+    }
+
+    return EXIT_SUCCESS;
+}
+
+int main(int argc, char** argv)
+{
+    process_args(argc, argv);
+
+    if (args.count("help"))
+    {
+        usage(argv);
+        return EXIT_SUCCESS;
+    }
+
+#ifdef __linux__
+    sched_getaffinity(0, sizeof(initial_mask), &initial_mask);
+#endif
+
+    return run<int, double>();
+}
@@ -0,0 +1,110 @@
+#!/usr/bin/env python
+"""Compare the setup costs measured by builds for different backends.
+
+Usage:
+    python compare_backends.py cuda.json omp.json tbb.json
+
+Every file is the --output of the setup benchmark built for one backend,
+e.g. with scons backend=omp. For every matrix the SpGEMM steps, the AMG
+setup phases and the setup time of every level are printed side by side in
+milliseconds, followed by the peak memory of the steps in MB and the number
+of solves after which the AMG setup pays off.
+"""
+
+from __future__ import print_function
+
+import json
+import sys
+
+MB = 1024.0 * 1024.0
+
+
+def load(filename):
+    with open(filename) as f:
+        results = json.load(f)
+
+    label = results.get('backend', filename)
+    matrices = dict((m['name'], m) for m in results['matrices'])
+
+    return label, matrices
+
+
+def row(name, values, scale, fmt='%12.3f'):
+    cells = []
+    for value in values:
+        cells.append(' ' * 12 if value is None else fmt % (scale * value))
+    print('  %-28s%s' % (name, ''.join(cells)))
+
+
+def lookup(matrix, path):
+    value = matrix
+    for key in path:
+        if isinstance(value, list):
+            if key >= len(value):
+                return None
+            value = value[key]
+        elif key in value:
+            value = value[key]
+        else:
+            return None
+    return value
+
+
+def main(argv):
+    if len(argv) < 1:
+        raise SystemExit(__doc__)
+
+    runs = [load(filename) for filename in argv]
+
+    names = []
+    for _, matrices in runs:
+        for name in sorted(matrices):
+            if name not in names:
+                names.append(name)
+
+    for name in names:
+        present = [matrices.get(name) for _, matrices in runs]
+        first = [m for m in present if m is not None][0]
+
+        print('%s: %d x %d, %d entries' % (name, first['num_rows'], first['num_cols'], first['num_entries']))
+        print('  %-28s%s' % ('[ms]', ''.join('%12s' % label for label, _ in runs)))
+
+        def values(path):
+            return [None if m is None else lookup(m, path) for m in present]
+
+        for step in ['multiply', 'symbolic', 'numeric']:
+            row('spgemm ' + step, values(['spgemm', step, 'seconds']), 1e3)
+
+        row('amg setup', values(['amg', 'setup', 'seconds']), 1e3)
+
+        phases = []
+        for m in present:
+            if m is not None:
+                for phase in m['amg']['phases']:
+                    if phase not in phases:
+                        phases.append(phase)
+
+        for phase in phases:
+            row('  ' + phase, values(['amg', 'phases', phase]), 1e3)
+
+        num_levels = max(len(m['amg']['levels']) for m in present if m is not None)
+        for lvl in range(num_levels):
+            row('  level %d' % lvl, values(['amg', 'levels', lvl, 'seconds']), 1e3)
+
+        print('  %-28s%s' % ('[MB]', ''.join('%12s' % label for label, _ in runs)))
+
+        for step in ['multiply', 'symbolic', 'numeric']:
+            row('spgemm ' + step + ' peak', values(['spgemm', step, 'peak_bytes']), 1.0 / MB)
+
+        row('amg setup peak', values(['amg', 'setup', 'peak_bytes']), 1.0 / MB)
+        row('amg hierarchy', values(['amg', 'hierarchy_bytes']), 1.0 / MB)
+
+        print('  %-28s%s' % ('[solves]', ''.join('%12s' % label for label, _ in runs)))
+        row('amg break even', values(['amg', 'solve', 'break_even_solves']), 1.0, '%12.1f')
+        print('')
+
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main(sys.argv[1:]))
@@ -0,0 +1,651 @@
+#include <cusp/array1d.h>
+#include <cusp/csr_matrix.h>
+#include <cusp/exception.h>
+#include <cusp/execution_policy.h>
+#include <cusp/monitor.h>
+#include <cusp/multiply.h>
+#include <cusp/version.h>
+
+#include <cusp/detail/num_bytes.h>
+#include <cusp/detail/timer.h>
+
+#include <cusp/gallery/poisson.h>
+#include <cusp/io/binary.h>
+#include <cusp/io/matrix_market.h>
+#include <cusp/krylov/cg.h>
+#include <cusp/precond/aggregation/smoothed_aggregation.h>
+
+#include <thrust/memory.h>
+#include <thrust/version.h>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <map>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Breaks the setup cost of smoothed aggregation AMG down into the phases of
+// every level and the SpGEMM it is built on into its symbolic and numeric
+// parts, together with the memory each step needs, for a collection of
+// matrices. Everything runs on the device system the program is built for,
+// so the CUDA, OMP and TBB backends are compared by building with
+// scons backend=cuda|omp|tbb, running each build with --output and passing
+// the files to compare_backends.py.
+
+typedef std::map<std::string, std::string> ArgumentMap;
+ArgumentMap args;
+std::vector<std::string> matrices;
+
+void process_args(int argc, char ** argv)
+{
+    for(int i = 1; i < argc; i++)
+    {
+        std::string arg(argv[i]);
+
+        if (arg.substr(0,2) == "--")
+        {
+            std::string::size_type n = arg.find('=',2);
+
+            if (n == std::string::npos)
+                args[arg.substr(2)] = std::string();              // (key)
+            else
+                args[arg.substr(2, n - 2)] = arg.substr(n + 1);   // (key,value)
+        }
+        else
+        {
+            matrices.push_back(arg);
+        }
+    }
+}
+
+std::string get_arg(const std::string& key, const std::string& default_value)
+{
+    return args.count(key) ? args[key] : default_value;
+}
+
+void usage(char** argv)
+{
+    std::cout << "Usage:\n";
+    std::cout << "\t" << argv[0] << " [matrix ...] [options]\n\n";
+    std::cout << "Matrices (default poisson5pt:256x256 poisson9pt:256x256 poisson7pt:48x48x48 poisson27pt:32x32x32):\n";
+    std::cout << "\tA.mtx                   MatrixMarket file\n";
+    std::cout << "\tA.bin                   cusp binary file\n";
+    std::cout << "\tpoisson5pt:NXxNY        also poisson9pt, poisson7pt:NXxNYxNZ, poisson27pt:NXxNYxNZ\n\n";
+    std::cout << "Options:\n";
+    std::cout << "\t--value_type=double     float or double\n";
+    std::cout << "\t--device=0              CUDA device\n";
+    std::cout << "\t--repeat=3              runs of every measurement, the fastest is reported\n";
+    std::cout << "\t--tolerance=1e-8        relative tolerance of the solves\n";
+    std::cout << "\t--output=setup.json     file receiving the results as JSON\n";
+}
+
+std::vector<size_t> parse_dimensions(const std::string& spec)
+{
+    std::vector<size_t> dims;
+    std::istringstream stream(spec);
+    std::string token;
+
+    while (std::getline(stream, token, 'x'))
+        dims.push_back(std::atoi(token.c_str()));
+
+    return dims;
+}
+
+template <typename Matrix>
+void read_matrix(Matrix& A, const std::string& spec)
+{
+    const std::string::size_type colon = spec.find(':');
+
+    const std::string name = spec.substr(0, colon);
+    const std::vector<size_t> dims = colon == std::string::npos ? std::vector<size_t>() : parse_dimensions(spec.substr(colon + 1));
+
+    if      (name == "poisson5pt"  && dims.size() == 2) cusp::gallery::poisson5pt (A, dims[0], dims[1]);
+    else if (name == "poisson9pt"  && dims.size() == 2) cusp::gallery::poisson9pt (A, dims[0], dims[1]);
+    else if (name == "poisson7pt"  && dims.size() == 3) cusp::gallery::poisson7pt (A, dims[0], dims[1], dims[2]);
+    else if (name == "poisson27pt" && dims.size() == 3) cusp::gallery::poisson27pt(A, dims[0], dims[1], dims[2]);
+    else if (spec.size() > 4 && spec.substr(spec.size() - 4) == ".bin")
+        cusp::io::read_binary_file(A, spec);
+    else
+        cusp::io::read_matrix_market_file(A, spec);
+}
+
+std::string backend_name(void)
+{
+#if   THRUST_DEVICE_SYSTEM == THRUST_DEVICE_SYSTEM_CUDA
+    return "cuda";
+#elif THRUST_DEVICE_SYSTEM == THRUST_DEVICE_SYSTEM_OMP
+    return "omp";
+#elif THRUST_DEVICE_SYSTEM == THRUST_DEVICE_SYSTEM_TBB
+    return "tbb";
+#else
+    return "cpp";
+#endif
+}
+
+std::string device_name(void)
+{
+#if THRUST_DEVICE_SYSTEM == THRUST_DEVICE_SYSTEM_CUDA
+    int device_id = 0;
+    cudaDeviceProp properties;
+
+    if (cudaGetDevice(&device_id) != cudaSuccess ||
+        cudaGetDeviceProperties(&properties, device_id) != cudaSuccess)
+        return "unknown";
+
+    return properties.name;
+#else
+    return "host";
+#endif
+}
+
+int num_threads(void)
+{
+#ifdef _OPENMP
+    return omp_get_max_threads();
+#else
+    return 1;
+#endif
+}
+
+// bytes allocated on the device by all users, zero on other systems
+size_t device_bytes_in_use(void)
+{
+#if THRUST_DEVICE_SYSTEM == THRUST_DEVICE_SYSTEM_CUDA
+    size_t free_bytes = 0, total_bytes = 0;
+    cudaMemGetInfo(&free_bytes, &total_bytes);
+    return total_bytes - free_bytes;
+#else
+    return 0;
+#endif
+}
+
+// Allocator passed to the policies of the measured calls, every temporary
+// array of the algorithms they invoke is allocated through it, so the peak
+// of the bytes it holds is the exact workspace high water mark of a call.
+template <typename MemorySpace>
+class tracking_allocator
+{
+public:
+
+    typedef char value_type;
+
+    size_t bytes_in_use;
+    size_t peak_bytes;
+
+    tracking_allocator(void) : bytes_in_use(0), peak_bytes(0) {}
+
+    char* allocate(std::ptrdiff_t num_bytes)
+    {
+        MemorySpace system;
+
+        char* ptr = thrust::raw_pointer_cast(thrust::malloc<char>(system, num_bytes));
+
+        blocks[ptr]   = num_bytes;
+        bytes_in_use += num_bytes;
+        peak_bytes    = std::max(peak_bytes, bytes_in_use);
+
+        return ptr;
+    }
+
+    void deallocate(char* ptr, size_t)
+    {
+        MemorySpace system;
+
+        bytes_in_use -= blocks[ptr];
+        blocks.erase(ptr);
+
+        thrust::free(system, ptr);
+    }
+
+    void reset_peak(void)
+    {
+        peak_bytes = bytes_in_use;
+    }
+
+private:
+
+    std::map<char*, size_t> blocks;
+};
+
+typedef std::vector< std::pair<std::string, double> > phase_times;
+
+// time and memory of one step, the peak adds the inputs, outputs and the
+// workspace high water mark, which bounds the memory the step needs
+struct step_result
+{
+    double seconds;
+    size_t workspace_bytes;
+    size_t peak_bytes;
+
+    step_result(void) : seconds(std::numeric_limits<double>::max()), workspace_bytes(0), peak_bytes(0) {}
+
+    void update(double s, size_t workspace, size_t persistent)
+    {
+        if (s < seconds)
+            seconds = s;
+
+        workspace_bytes = std::max(workspace_bytes, workspace);
+        peak_bytes      = std::max(peak_bytes, persistent + workspace);
+    }
+};
+
+struct spgemm_result
+{
+    size_t num_products;
+    size_t num_entries;
+    size_t plan_bytes;
+
+    step_result multiply;
+    step_result symbolic;
+    step_result numeric;
+
+    spgemm_result(void) : num_products(0), num_entries(0), plan_bytes(0) {}
+};
+
+struct level_result
+{
+    size_t num_rows;
+    size_t num_entries;
+    size_t bytes;
+    double seconds;
+    phase_times phases;
+};
+
+struct amg_result
+{
+    step_result setup;
+    size_t      hierarchy_bytes;
+    double      operator_complexity;
+    double      grid_complexity;
+    phase_times phases;
+
+    std::vector<level_result> levels;
+
+    size_t cg_iterations;
+    double cg_seconds;
+    size_t amg_iterations;
+    double amg_seconds;
+
+    amg_result(void)
+      : hierarchy_bytes(0), operator_complexity(0), grid_complexity(0),
+        cg_iterations(0), cg_seconds(0), amg_iterations(0), amg_seconds(0) {}
+
+    // number of solves after which the setup has paid for itself, zero if
+    // the preconditioned solve is not faster
+    double break_even_solves(void) const
+    {
+        return amg_seconds < cg_seconds ? setup.seconds / (cg_seconds - amg_seconds) : 0;
+    }
+};
+
+struct matrix_result
+{
+    std::string   name;
+    size_t        num_rows;
+    size_t        num_cols;
+    size_t        num_entries;
+    size_t        device_bytes;
+    spgemm_result spgemm;
+    amg_result    amg;
+};
+
+// number of products A(i,k) * A(k,j) of C = A * A
+template <typename Matrix>
+size_t count_products(const Matrix& A)
+{
+    size_t products = 0;
+
+    for(size_t n = 0; n < A.num_entries; n++)
+    {
+        const size_t k = A.column_indices[n];
+        products += A.row_offsets[k + 1] - A.row_offsets[k];
+    }
+
+    return products;
+}
+
+template <typename IndexType, typename ValueType, typename MemorySpace, typename HostMatrix>
+void benchmark_spgemm(const HostMatrix& A_host, const size_t repeat, spgemm_result& result)
+{
+    typedef cusp::csr_matrix<IndexType, ValueType, MemorySpace> Matrix;
+
+    tracking_allocator<MemorySpace> alloc;
+
+    const Matrix A(A_host);
+    const size_t A_bytes = cusp::detail::num_bytes(A);
+
+    result.num_products = count_products(A_host);
+
+    for(size_t i = 0; i < repeat; i++)
+    {
+        {
+            Matrix C;
+
+            alloc.reset_peak();
+            cusp::detail::timer t;
+            cusp::multiply(cusp::system::__THRUST_DEVICE_SYSTEM_NAMESPACE::par(alloc), A, A, C);
+            const double seconds = t.seconds_elapsed();
+
+            result.multiply.update(seconds, alloc.peak_bytes, A_bytes + cusp::detail::num_bytes(C));
+            result.num_entries = C.num_entries;
+        }
+
+        {
+            Matrix C;
+            cusp::spgemm_plan<IndexType, MemorySpace> plan;
+
+            alloc.reset_peak();
+            cusp::detail::timer t;
+            cusp::spgemm_symbolic(cusp::system::__THRUST_DEVICE_SYSTEM_NAMESPACE::par(alloc), A, A, C, plan);
+            double seconds = t.seconds_elapsed();
+
+            result.plan_bytes = cusp::detail::num_bytes(plan.A_gather_locations) +
+                                cusp::detail::num_bytes(plan.B_gather_locations) +
+                                cusp::detail::num_bytes(plan.output_keys);
+
+            const size_t persistent = A_bytes + cusp::detail::num_bytes(C) + result.plan_bytes;
+
+            result.symbolic.update(seconds, alloc.peak_bytes, persistent);
+
+            alloc.reset_peak();
+            t.restart();
+            cusp::spgemm_numeric(cusp::system::__THRUST_DEVICE_SYSTEM_NAMESPACE::par(alloc), A, A, C, plan);
+            seconds = t.seconds_elapsed();
+
+            result.numeric.update(seconds, alloc.peak_bytes, persistent);
+        }
+    }
+}
+
+template <typename IndexType, typename ValueType, typename MemorySpace, typename HostMatrix>
+void benchmark_amg(const HostMatrix& A_host, const size_t repeat, const double tolerance, amg_result& result)
+{
+    typedef cusp::csr_matrix<IndexType, ValueType, MemorySpace>                                 Matrix;
+    typedef cusp::array1d<ValueType, MemorySpace>                                               Array;
+    typedef cusp::precond::aggregation::smoothed_aggregation<IndexType, ValueType, MemorySpace> Preconditioner;
+
+    tracking_allocator<MemorySpace> alloc;
+
+    const Matrix A(A_host);
+    const Array  B(A.num_rows, ValueType(1));
+
+    Preconditioner M;
+
+    for(size_t i = 0; i < repeat; i++)
+    {
+        alloc.reset_peak();
+        cusp::detail::timer t;
+        M.initialize(cusp::system::__THRUST_DEVICE_SYSTEM_NAMESPACE::par(alloc), A, B);
+        const double seconds = t.seconds_elapsed();
+
+        const cusp::detail::multilevel_report report = M.report();
+
+        // the phases and levels are those of the fastest setup
+        if (seconds < result.setup.seconds)
+        {
+            result.hierarchy_bytes     = report.total_bytes;
+            result.operator_complexity = report.operator_complexity;
+            result.grid_complexity     = report.grid_complexity;
+            result.phases              = report.setup_times;
+
+            result.levels.resize(report.num_levels);
+
+            for(size_t lvl = 0; lvl < report.num_levels; lvl++)
+            {
+                const cusp::detail::multilevel_level_report& L = report.levels[lvl];
+
+                result.levels[lvl].num_rows    = L.num_rows;
+                result.levels[lvl].num_entries = L.num_entries;
+                result.levels[lvl].bytes       = L.A_bytes + L.P_bytes + L.R_bytes + L.smoother_bytes + L.vector_bytes;
+                result.levels[lvl].seconds     = L.setup_seconds;
+                result.levels[lvl].phases      = L.setup_times;
+            }
+        }
+
+        result.setup.update(seconds, alloc.peak_bytes, cusp::detail::num_bytes(A) + report.total_bytes);
+    }
+
+    // solves with and without the hierarchy decide whether the setup pays off
+    const Array b(A.num_rows, ValueType(1));
+
+    {
+        Array x(A.num_rows, ValueType(0));
+        cusp::monitor<ValueType> monitor(b, 10000, tolerance);
+
+        cusp::detail::timer t;
+        cusp::krylov::cg(A, x, b, monitor);
+        result.cg_seconds    = t.seconds_elapsed();
+        result.cg_iterations = monitor.iteration_count();
+    }
+
+    {
+        Array x(A.num_rows, ValueType(0));
+        cusp::monitor<ValueType> monitor(b, 10000, tolerance);
+
+        cusp::detail::timer t;
+        cusp::krylov::cg(A, x, b, monitor, M);
+        result.amg_seconds    = t.seconds_elapsed();
+        result.amg_iterations = monitor.iteration_count();
+    }
+}
+
+void print_step(const std::string& name, const step_result& step)
+{
+    const double MB = 1024.0 * 1024.0;
+
+    std::cout << "    " << std::setw(22) << std::left << name
+              << std::setw(10) << std::right << std::fixed << std::setprecision(3) << 1e3 * step.seconds << " ms"
+              << std::setw(10) << step.workspace_bytes / MB << " MB workspace"
+              << std::setw(10) << step.peak_bytes / MB << " MB peak" << std::endl;
+}
+
+void print_result(const matrix_result& r)
+{
+    const double MB = 1024.0 * 1024.0;
+
+    std::cout << r.name << ": " << r.num_rows << " x " << r.num_cols << ", " << r.num_entries << " entries" << std::endl;
+
+    std::cout << "  SpGEMM A * A: " << r.spgemm.num_products << " products, "
+              << r.spgemm.num_entries << " entries, plan " << r.spgemm.plan_bytes / MB << " MB" << std::endl;
+    print_step("multiply", r.spgemm.multiply);
+    print_step("symbolic", r.spgemm.symbolic);
+    print_step("numeric",  r.spgemm.numeric);
+
+    std::cout << "  AMG setup: " << r.amg.levels.size() << " levels, operator complexity "
+              << r.amg.operator_complexity << ", hierarchy " << r.amg.hierarchy_bytes / MB << " MB" << std::endl;
+    print_step("total", r.amg.setup);
+
+    for(size_t i = 0; i < r.amg.phases.size(); i++)
+        std::cout << "      " << std::setw(22) << std::left << r.amg.phases[i].first
+                  << std::setw(10) << std::right << 1e3 * r.amg.phases[i].second << " ms" << std::endl;
+
+    std::cout << "    level      rows   nonzeros  setup [ms]" << std::endl;
+
+    for(size_t lvl = 0; lvl < r.amg.levels.size(); lvl++)
+    {
+        const level_result& L = r.amg.levels[lvl];
+
+        std::cout << "    " << std::setw(5) << lvl << std::setw(10) << L.num_rows << std::setw(11) << L.num_entries
+                  << std::setw(12) << 1e3 * L.seconds << std::endl;
+    }
+
+    std::cout << "  CG: " << r.amg.cg_iterations << " iterations in " << 1e3 * r.amg.cg_seconds << " ms, "
+              << "AMG-CG: " << r.amg.amg_iterations << " iterations in " << 1e3 * r.amg.amg_seconds << " ms";
+
+    if (r.amg.break_even_solves() > 0)
+        std::cout << ", the setup pays off after " << r.amg.break_even_solves() << " solves";
+    else
+        std::cout << ", the setup does not pay off";
+
+    std::cout << std::endl;
+
+    if (r.device_bytes > 0)
+        std::cout << "  device memory in use after the runs: " << r.device_bytes / MB << " MB" << std::endl;
+
+    std::cout << std::endl;
+    std::cout.unsetf(std::ios::floatfield);
+}
+
+void write_json(std::ostream& os, const phase_times& phases)
+{
+    os << "{";
+
+    for(size_t i = 0; i < phases.size(); i++)
+        os << (i ? ", " : "") << "\"" << phases[i].first << "\": " << phases[i].second;
+
+    os << "}";
+}
+
+void write_json(std::ostream& os, const step_result& step)
+{
+    os << "{\"seconds\": " << step.seconds << ", \"workspace_bytes\": " << step.workspace_bytes
+       << ", \"peak_bytes\": " << step.peak_bytes << "}";
+}
+
+void write_json(std::ostream& os, const matrix_result& r)
+{
+    os << "    {\"name\": \"" << r.name << "\", \"num_rows\": " << r.num_rows << ", \"num_cols\": " << r.num_cols
+       << ", \"num_entries\": " << r.num_entries << ", \"device_bytes\": " << r.device_bytes << ",\n";
+
+    os << "     \"spgemm\": {\"num_products\": " << r.spgemm.num_products << ", \"num_entries\": " << r.spgemm.num_entries
+       << ", \"plan_bytes\": " << r.spgemm.plan_bytes << ",\n";
+    os << "                \"multiply\": "; write_json(os, r.spgemm.multiply); os << ",\n";
+    os << "                \"symbolic\": "; write_json(os, r.spgemm.symbolic); os << ",\n";
+    os << "                \"numeric\": ";  write_json(os, r.spgemm.numeric);  os << "},\n";
+
+    os << "     \"amg\": {\"setup\": "; write_json(os, r.amg.setup);
+    os << ", \"hierarchy_bytes\": " << r.amg.hierarchy_bytes
+       << ", \"operator_complexity\": " << r.amg.operator_complexity
+       << ", \"grid_complexity\": " << r.amg.grid_complexity << ",\n";
+    os << "             \"phases\": "; write_json(os, r.amg.phases); os << ",\n";
+    os << "             \"levels\": [";
+
+    for(size_t lvl = 0; lvl < r.amg.levels.size(); lvl++)
+    {
+        const level_result& L = r.amg.levels[lvl];
+
+        os << (lvl ? ",\n                        " : "")
+           << "{\"num_rows\": " << L.num_rows << ", \"num_entries\": " << L.num_entries
+           << ", \"bytes\": " << L.bytes << ", \"seconds\": " << L.seconds << ", \"phases\": ";
+        write_json(os, L.phases);
+        os << "}";
+    }
+
+    os << "],\n";
+    os << "             \"solve\": {\"cg_iterations\": " << r.amg.cg_iterations << ", \"cg_seconds\": " << r.amg.cg_seconds
+       << ", \"amg_iterations\": " << r.amg.amg_iterations << ", \"amg_seconds\": " << r.amg.amg_seconds
+       << ", \"break_even_solves\": " << r.amg.break_even_solves() << "}}}";
+}
+
+template <typename IndexType, typename ValueType>
+int run(const std::string& value_type)
+{
+    const size_t repeat    = std::max(1, std::atoi(get_arg("repeat", "3").c_str()));
+    const double tolerance = std::atof(get_arg("tolerance", "1e-8").c_str());
+
+#if THRUST_DEVICE_SYSTEM == THRUST_DEVICE_SYSTEM_CUDA
+    cudaSetDevice(std::atoi(get_arg("device", "0").c_str()));
+#endif
+
+    if (matrices.empty())
+    {
+        matrices.push_back("poisson5pt:256x256");
+        matrices.push_back("poisson9pt:256x256");
+        matrices.push_back("poisson7pt:48x48x48");
+        matrices.push_back("poisson27pt:32x32x32");
+    }
+
+    std::cout << "Backend " << backend_name() << " (" << device_name() << ", "
+              << num_threads() << " host threads), '" << value_type << "' values\n" << std::endl;
+
+    std::vector<matrix_result> results;
+
+    for(size_t i = 0; i < matrices.size(); i++)
+    {
+        cusp::csr_matrix<IndexType, ValueType, cusp::host_memory> A;
+
+        try
+        {
+            read_matrix(A, matrices[i]);
+        }
+        catch (const cusp::exception& e)
+        {
+            std::cerr << "unable to read the matrix " << matrices[i] << ": " << e.what() << std::endl;
+            return EXIT_FAILURE;
+        }
+
+        matrix_result r;
+        r.name        = matrices[i];
+        r.num_rows    = A.num_rows;
+        r.num_cols    = A.num_cols;
+        r.num_entries = A.num_entries;
+
+        benchmark_spgemm<IndexType, ValueType, cusp::device_memory>(A, repeat, r.spgemm);
+        benchmark_amg<IndexType, ValueType, cusp::device_memory>(A, repeat, tolerance, r.amg);
+
+        r.device_bytes = device_bytes_in_use();
+
+        print_result(r);
+        results.push_back(r);
+    }
+
+    if (args.count("output"))
+    {
+        std::ofstream os(args["output"].c_str());
+
+        os.precision(9);
+
+        os << "{\n";
+        os << "  \"cusp_version\": \""   << CUSP_MAJOR_VERSION << "." << CUSP_MINOR_VERSION << "." << CUSP_SUBMINOR_VERSION << "\",\n";
+        os << "  \"thrust_version\": \"" << THRUST_MAJOR_VERSION << "." << THRUST_MINOR_VERSION << "." << THRUST_SUBMINOR_VERSION << "\",\n";
+        os << "  \"backend\": \""        << backend_name() << "\",\n";
+        os << "  \"device\": \""         << device_name() << "\",\n";
+        os << "  \"threads\": "          << num_threads() << ",\n";
+        os << "  \"value_type\": \""     << value_type << "\",\n";
+        os << "  \"repeat\": "           << repeat << ",\n";
+        os << "  \"matrices\": [\n";
+
+        for(size_t i = 0; i < results.size(); i++)
+        {
+            write_json(os, results[i]);
+            os << (i + 1 < results.size() ? ",\n" : "\n");
+        }
+
+        os << "  ]\n";
+        os << "}\n";
+    }
+
+    return EXIT_SUCCESS;
+}
+
+int main(int argc, char** argv)
+{
+    process_args(argc, argv);
+
+    if (args.count("help"))
+    {
+        usage(argv);
+        return EXIT_SUCCESS;
+    }
+
+    const std::string value_type = get_arg("value_type", "double");
+
+    if (value_type == "float")
+        return run<int, float>(value_type);
+    else if (value_type == "double")
+        return run<int, double>(value_type);
+
+    usage(argv);
+
+    return EXIT_FAILURE;
+}
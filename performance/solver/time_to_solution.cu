@@ -0,0 +1,270 @@
+// peak memory of every configuration is read from the allocation tracker
+#define CUSP_MEMORY_TRACKING 1
+
+#include <cusp/csr_matrix.h>
+#include <cusp/linear_operator.h>
+#include <cusp/memory_tracker.h>
+#include <cusp/monitor.h>
+#include <cusp/gallery/poisson.h>
+#include <cusp/io/matrix_market.h>
+
+#include <cusp/krylov/bicgstab.h>
+#include <cusp/krylov/cg.h>
+#include <cusp/krylov/cr.h>
+#include <cusp/krylov/gmres.h>
+
+#include <cusp/precond/ainv.h>
+#include <cusp/precond/diagonal.h>
+#include <cusp/precond/aggregation/smoothed_aggregation.h>
+
+#include <cusp/precond/smoother/block_jacobi_smoother.h>
+#include <cusp/precond/smoother/chebyshev_smoother.h>
+#include <cusp/precond/smoother/gauss_seidel_smoother.h>
+#include <cusp/precond/smoother/hybrid_gauss_seidel_smoother.h>
+#include <cusp/precond/smoother/jacobi_smoother.h>
+#include <cusp/precond/smoother/l1_jacobi_smoother.h>
+#include <cusp/precond/smoother/polynomial_smoother.h>
+#include <cusp/precond/smoother/sor_smoother.h>
+
+#include <thrust/detail/type_traits.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <exception>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <string>
+
+#include "../timer.h"
+
+// Solves one system with every combination of Krylov solver, preconditioner
+// and memory space and reports the time to solution of each combination,
+// see usage() for the options.
+
+typedef std::map<std::string, std::string> ArgumentMap;
+ArgumentMap args;
+
+void process_args(int argc, char ** argv)
+{
+    for(int i = 1; i < argc; i++)
+    {
+        std::string arg(argv[i]);
+
+        if (arg.substr(0,2) == "--")
+        {
+            std::string::size_type n = arg.find('=',2);
+
+            if (n == std::string::npos)
+                args[arg.substr(2)] = std::string();              // (key)
+            else
+                args[arg.substr(2, n - 2)] = arg.substr(n + 1);   // (key,value)
+        }
+        else
+        {
+            args["matrix"] = arg;
+        }
+    }
+}
+
+std::string get_arg(const std::string& key, const std::string& default_value)
+{
+    return args.count(key) ? args[key] : default_value;
+}
+
+void usage(char** argv)
+{
+    std::cout << "Usage:\n";
+    std::cout << "\t" << argv[0] << " [matrix] [options]\n\n";
+    std::cout << "Matrix (default 5-pt Laplacian stencil on a 256x256 grid):\n";
+    std::cout << "\tA.mtx                      MatrixMarket file\n\n";
+    std::cout << "Options:\n";
+    std::cout << "\t--solvers=cg,gmres         comma separated solvers (cg, bicgstab, gmres, cr, default all)\n";
+    std::cout << "\t--preconditioners=sa       comma separated prefixes of the preconditioners\n";
+    std::cout << "\t                           (identity, diagonal, ainv, sa_<smoother>, default all)\n";
+    std::cout << "\t--memory=host,device       comma separated memory spaces, default both\n";
+    std::cout << "\t--max_iterations=2000      iteration limit of every solve\n";
+    std::cout << "\t--tolerance=1e-6           relative residual tolerance\n";
+    std::cout << "\t--restart=50               restart length of gmres\n";
+}
+
+// name matches one of the comma separated prefixes given for key
+bool selected(const std::string& key, const std::string& name)
+{
+    if (!args.count(key))
+        return true;
+
+    std::istringstream stream(args[key]);
+    std::string prefix;
+
+    while (std::getline(stream, prefix, ','))
+        if (!prefix.empty() && name.compare(0, prefix.size(), prefix) == 0)
+            return true;
+
+    return false;
+}
+
+// builds a preconditioner from the system matrix, the identity only needs its shape
+template <typename Preconditioner>
+struct preconditioner_setup
+{
+    Preconditioner M;
+
+    template <typename Matrix>
+    preconditioner_setup(const Matrix& A) : M(A) {}
+};
+
+template <typename ValueType, typename MemorySpace>
+struct preconditioner_setup< cusp::identity_operator<ValueType, MemorySpace> >
+{
+    cusp::identity_operator<ValueType, MemorySpace> M;
+
+    template <typename Matrix>
+    preconditioner_setup(const Matrix& A) : M(A.num_rows, A.num_cols) {}
+};
+
+template <typename Matrix, typename Array, typename Monitor, typename Preconditioner>
+void solve(const std::string& solver, const Matrix& A, Array& x, const Array& b, Monitor& monitor, Preconditioner& M)
+{
+    if      (solver == "cg")       cusp::krylov::cg(A, x, b, monitor, M);
+    else if (solver == "bicgstab") cusp::krylov::bicgstab(A, x, b, monitor, M);
+    else if (solver == "cr")       cusp::krylov::cr(A, x, b, monitor, M);
+    else if (solver == "gmres")    cusp::krylov::gmres(A, x, b, std::atoi(get_arg("restart", "50").c_str()), monitor, M);
+}
+
+void print_header(void)
+{
+    std::printf("%-7s %-9s %-26s %-9s %6s %10s %10s %10s %10s\n",
+                "memory", "solver", "preconditioner", "converged", "iters",
+                "setup(s)", "solve(s)", "total(s)", "peak(MB)");
+}
+
+template <typename Preconditioner, typename Matrix>
+void benchmark_preconditioner(const std::string& name, const Matrix& A)
+{
+    typedef typename Matrix::value_type   ValueType;
+    typedef typename Matrix::memory_space MemorySpace;
+
+    static const char * solvers[] = {"cg", "bicgstab", "gmres", "cr"};
+
+    if (!selected("preconditioners", name))
+        return;
+
+    const std::string memory = thrust::detail::is_same<MemorySpace, cusp::host_memory>::value ? "host" : "device";
+
+    const size_t    max_iterations = std::atoi(get_arg("max_iterations", "2000").c_str());
+    const ValueType tolerance      = std::atof(get_arg("tolerance", "1e-6").c_str());
+
+    cusp::array1d<ValueType, MemorySpace> b(A.num_rows, 1);
+
+    for (size_t i = 0; i < sizeof(solvers) / sizeof(solvers[0]); i++)
+    {
+        if (!selected("solvers", solvers[i]))
+            continue;
+
+        cusp::array1d<ValueType, MemorySpace> x(A.num_rows, 0);
+        cusp::monitor<ValueType> monitor(b, max_iterations, tolerance);
+
+        // every solver pays for its own setup, so every row is a complete time to solution
+        cusp::reset_memory_peaks();
+
+        float setup_time = 0;
+        float solve_time = 0;
+
+        try
+        {
+            timer t0;
+            preconditioner_setup<Preconditioner> P(A);
+            setup_time = t0.seconds_elapsed();
+
+            timer t1;
+            solve(solvers[i], A, x, b, monitor, P.M);
+            solve_time = t1.seconds_elapsed();
+        }
+        catch (const std::exception& e)
+        {
+            std::printf("%-7s %-9s %-26s failed: %s\n", memory.c_str(), solvers[i], name.c_str(), e.what());
+            continue;
+        }
+
+        const double peak = cusp::memory_usage<MemorySpace>().peak_bytes / 1e6;
+
+        std::printf("%-7s %-9s %-26s %-9s %6d %10.4f %10.4f %10.4f %10.1f\n",
+                    memory.c_str(), solvers[i], name.c_str(),
+                    monitor.converged() ? "yes" : "no", int(monitor.iteration_count()),
+                    setup_time, solve_time, setup_time + solve_time, peak);
+    }
+}
+
+template <typename Matrix>
+void benchmark_matrix(const Matrix& A)
+{
+    typedef typename Matrix::index_type   IndexType;
+    typedef typename Matrix::value_type   ValueType;
+    typedef typename Matrix::memory_space MemorySpace;
+
+    using namespace cusp::precond;
+
+    // every smoother runs on csr levels, gauss-seidel and sor require them
+    typedef cusp::csr_format Format;
+
+#define SA(Smoother) aggregation::smoothed_aggregation<IndexType, ValueType, MemorySpace, Smoother<ValueType, MemorySpace>, thrust::use_default, Format>
+
+    benchmark_preconditioner< cusp::identity_operator<ValueType, MemorySpace> >("identity", A);
+    benchmark_preconditioner< diagonal<ValueType, MemorySpace> >               ("diagonal", A);
+    benchmark_preconditioner< scaled_bridson_ainv<ValueType, MemorySpace> >    ("ainv", A);
+
+    benchmark_preconditioner< SA(jacobi_smoother) >                            ("sa_jacobi", A);
+    benchmark_preconditioner< SA(l1_jacobi_smoother) >                         ("sa_l1_jacobi", A);
+    benchmark_preconditioner< SA(block_jacobi_smoother) >                      ("sa_block_jacobi", A);
+    benchmark_preconditioner< SA(polynomial_smoother) >                        ("sa_polynomial", A);
+    benchmark_preconditioner< SA(chebyshev_smoother) >                         ("sa_chebyshev", A);
+    benchmark_preconditioner< SA(gauss_seidel_smoother) >                      ("sa_gauss_seidel", A);
+    benchmark_preconditioner< SA(hybrid_gauss_seidel_smoother) >               ("sa_hybrid_gauss_seidel", A);
+    benchmark_preconditioner< SA(sor_smoother) >                               ("sa_sor", A);
+
+#undef SA
+}
+
+int main(int argc, char** argv)
+{
+    typedef int    IndexType;
+    typedef double ValueType;
+
+    typedef cusp::csr_matrix<IndexType,ValueType,cusp::host_memory>   HostMatrix;
+    typedef cusp::csr_matrix<IndexType,ValueType,cusp::device_memory> DeviceMatrix;
+
+    process_args(argc, argv);
+
+    if (args.count("help"))
+    {
+        usage(argv);
+        return 0;
+    }
+
+    HostMatrix A;
+
+    if (!args.count("matrix"))
+    {
+        std::cout << "Using default matrix (5-pt Laplacian stencil)" << std::endl;
+        cusp::gallery::poisson5pt(A, 256, 256);
+    }
+    else
+    {
+        std::cout << "Reading matrix from file: " << args["matrix"] << std::endl;
+        cusp::io::read_matrix_market_file(A, args["matrix"]);
+    }
+
+    std::cout << "Matrix has shape (" << A.num_rows << "," << A.num_cols << ") and "
+              << A.num_entries << " entries" << std::endl;
+
+    print_header();
+
+    if (selected("memory", "host"))
+        benchmark_matrix(A);
+
+    if (selected("memory", "device"))
+        benchmark_matrix(DeviceMatrix(A));
+
+    return 0;
+}
@@ -1,19 +1,105 @@
 #pragma once
 
 #include <cusp/multiply.h>
+#include <cusp/blas/blas.h>
 #include <cusp/system/cuda/detail/multiply/coo_flat_k.h>
+#include <cusp/system/cuda/detail/multiply/csr_merge_spmv.h>
 #include <cusp/system/cuda/detail/multiply/csr_scalar.h>
 
+#include <thrust/copy.h>
+#include <thrust/equal.h>
+
 #include "bytes_per_spmv.h"
 #include "utility.h"
 #include "../timer.h"
 
 #include <string>
+#include <sstream>
 #include <iostream>
 #include <stdio.h>
 
 const char * BENCHMARK_OUTPUT_FILE_NAME = "benchmark_output.log";
 
+// Sustained device memory bandwidth in bytes per second, the best of
+// several runs of the STREAM copy (b = a) and triad (c = a + 3 b) kernels
+// over arrays much larger than the L2 cache. This is the roof against which
+// the bandwidth of the SpMV kernels is compared.
+template <typename ValueType>
+double stream_bandwidth(void)
+{
+    static double bandwidth = 0;
+
+    if (bandwidth > 0)
+        return bandwidth;
+
+    int current_device = -1;
+    cudaDeviceProp properties;
+    cudaGetDevice(&current_device);
+    cudaGetDeviceProperties(&properties, current_device);
+
+    // three arrays using at most a quarter of the device memory
+    const size_t N = std::min(size_t(1) << 25, properties.totalGlobalMem / (12 * sizeof(ValueType)));
+
+    cusp::array1d<ValueType, cusp::device_memory> a(N, ValueType(1));
+    cusp::array1d<ValueType, cusp::device_memory> b(N, ValueType(2));
+    cusp::array1d<ValueType, cusp::device_memory> c(N, ValueType(0));
+
+    for(size_t i = 0; i < 10; i++)
+    {
+        timer copy_timer;
+        thrust::copy(a.begin(), a.end(), b.begin());
+        cudaThreadSynchronize();
+        double copy_time = copy_timer.seconds_elapsed();
+
+        timer triad_timer;
+        cusp::blas::axpby(a, b, c, ValueType(1), ValueType(3));
+        cudaThreadSynchronize();
+        double triad_time = triad_timer.seconds_elapsed();
+
+        // the first run only warms up
+        if (i == 0)
+            continue;
+
+        if (copy_time > 0)
+            bandwidth = std::max(bandwidth, 2 * sizeof(ValueType) * N / copy_time);
+        if (triad_time > 0)
+            bandwidth = std::max(bandwidth, 3 * sizeof(ValueType) * N / triad_time);
+    }
+
+    return bandwidth;
+}
+
+// SpMV with the merge-path CSR kernel, which cusp::multiply only selects
+// for matrices with irregular rows
+template <typename MatrixType,
+          typename VectorType1,
+          typename VectorType2>
+void spmv_csr_merge(const MatrixType&  A,
+                    const VectorType1& x,
+                          VectorType2& y)
+{
+    using thrust::system::detail::generic::select_system;
+
+    typedef typename MatrixType::memory_space  System1;
+    typedef typename VectorType1::memory_space System2;
+    typedef typename VectorType2::memory_space System3;
+    typedef typename MatrixType::value_type ValueType;
+
+    System1 system1;
+    System2 system2;
+    System3 system3;
+
+    cusp::constant_functor<ValueType> initialize(0);
+    thrust::multiplies<ValueType> combine;
+    thrust::plus<ValueType> reduce;
+
+    cusp::system::cuda::detail::__spmv_csr_merge(
+        thrust::detail::derived_cast(
+          thrust::detail::strip_const(
+            select_system(system1,system2,system3))),
+        A, x, y, initialize, combine, reduce);
+}
+
 template <typename HostMatrix, typename TestMatrix, typename TestKernel>
 float check_spmv(HostMatrix& host_matrix, TestMatrix& test_matrix, TestKernel test_kernel)
 {
@@ -157,6 +243,29 @@ float time_spmv_block(TestMatrix& test_matrix, size_t num_cols, TestKernel test_
     return sec_per_iteration;
 }
 
+// Prints and records the rates of one kernel. GB/s counts the traffic of
+// the x_per_entry model, which earlier logs used as well, the cached GB/s
+// the x_cache_lines model. The roofline is the time the compulsory traffic
+// (x_once) would take at the STREAM bandwidth, so a kernel at 100% of the
+// roofline could only become faster by moving fewer bytes.
+inline void report_spmv(const std::string& kernel_name, float time, double flops, float error,
+                        size_t bytes, size_t cached_bytes, size_t min_bytes, double stream)
+{
+    float GFLOPs   = (time == 0) ? 0 : (flops / time)        / 1e9;
+    float GBYTEs   = (time == 0) ? 0 : (bytes / time)        / 1e9;
+    float CACHEDs  = (time == 0) ? 0 : (cached_bytes / time) / 1e9;
+    float ROOFLINE = (time == 0 || stream == 0) ? 0 : 100 * (min_bytes / stream) / time;
+
+    printf("\t%-20s: %8.4f ms ( %5.2f GFLOP/s %5.1f GB/s %5.1f GB/s cached %5.1f%% of roofline) [L2 error %f]\n",
+           kernel_name.c_str(), 1e3 * time, GFLOPs, GBYTEs, CACHEDs, ROOFLINE, error);
+
+    //record results to file
+    FILE * fid = fopen(BENCHMARK_OUTPUT_FILE_NAME, "a");
+    fprintf(fid, "kernel=%s gflops=%f gbytes=%f gbytes_cached=%f roofline=%f msec=%f\n",
+            kernel_name.c_str(), GFLOPs, GBYTEs, CACHEDs, ROOFLINE, 1e3 * time);
+    fclose(fid);
+}
+
 template <typename HostMatrix, typename TestMatrixOnHost, typename TestMatrixOnDevice, typename TestKernel>
 void test_spmv(std::string         kernel_name,
                HostMatrix&         host_matrix,
@@ -164,19 +273,16 @@ void test_spmv(std::string         kernel_name,
                TestMatrixOnDevice& test_matrix_on_device,
                TestKernel          test_spmv)
 {
+    typedef typename TestMatrixOnHost::value_type ValueType;
+
     float error = check_spmv(host_matrix, test_matrix_on_device, test_spmv);
     float time  = time_spmv(              test_matrix_on_device, test_spmv);
-    float gbyte = bytes_per_spmv(test_matrix_on_host);
 
-    float GFLOPs = (time == 0) ? 0 : (2 * host_matrix.num_entries / time) / 1e9;
-    float GBYTEs = (time == 0) ? 0 : (gbyte / time)                       / 1e9;
-
-    printf("\t%-20s: %8.4f ms ( %5.2f GFLOP/s %5.1f GB/s) [L2 error %f]\n", kernel_name.c_str(), 1e3 * time, GFLOPs, GBYTEs, error);
-
-    //record results to file
-    FILE * fid = fopen(BENCHMARK_OUTPUT_FILE_NAME, "a");
-    fprintf(fid, "kernel=%s gflops=%f gbytes=%f msec=%f\n", kernel_name.c_str(), GFLOPs, GBYTEs, 1e3 * time);
-    fclose(fid);
+    report_spmv(kernel_name, time, 2.0 * host_matrix.num_entries, error,
+                bytes_per_spmv(test_matrix_on_host, x_per_entry),
+                bytes_per_spmv(test_matrix_on_host, x_cache_lines),
+                bytes_per_spmv(test_matrix_on_host, x_once),
+                stream_bandwidth<ValueType>());
 }
 
 template <typename HostMatrix, typename TestMatrixOnHost, typename TestMatrixOnDevice, typename TestKernel>
@@ -191,19 +297,16 @@ void test_spmv_block(std::string         kernel_name,
     block_string << "(" << num_cols << ")";
     kernel_name += block_string.str();
 
+    typedef typename TestMatrixOnHost::value_type ValueType;
+
     float error = check_block_spmv(host_matrix, test_matrix_on_device, test_spmv, num_cols);
     float time  = time_spmv_block(test_matrix_on_device, num_cols, test_spmv);
-    float gbyte = bytes_per_spmv_block(test_matrix_on_host, num_cols);
 
-    float GFLOPs = (time == 0) ? 0 : (num_cols * 2 * host_matrix.num_entries / time) / 1e9;
-    float GBYTEs = (time == 0) ? 0 : (gbyte / time)                       / 1e9;
-
-    printf("\t%-20s: %8.4f ms ( %5.2f GFLOP/s %5.1f GB/s) [L2 error %f]\n", kernel_name.c_str(), 1e3 * time, GFLOPs, GBYTEs, error);
-
-    //record results to file
-    FILE * fid = fopen(BENCHMARK_OUTPUT_FILE_NAME, "a");
-    fprintf(fid, "kernel=%s gflops=%f gbytes=%f msec=%f\n", kernel_name.c_str(), GFLOPs, GBYTEs, 1e3 * time);
-    fclose(fid);
+    report_spmv(kernel_name, time, 2.0 * num_cols * host_matrix.num_entries, error,
+                bytes_per_spmv_block(test_matrix_on_host, num_cols, x_per_entry),
+                bytes_per_spmv_block(test_matrix_on_host, num_cols, x_cache_lines),
+                bytes_per_spmv_block(test_matrix_on_host, num_cols, x_once),
+                stream_bandwidth<ValueType>());
 }
 
 /////////////////////////////////////////////////////
@@ -244,6 +347,7 @@ void test_csr(HostMatrix& host_matrix)
 
     test_spmv("csr_vector", host_matrix, test_matrix_on_host, test_matrix_on_device, cusp::multiply<DeviceMatrix,DeviceArray,DeviceArray>);
     test_spmv("csr_scalar", host_matrix, test_matrix_on_host, test_matrix_on_device, cusp::system::cuda::detail::spmv_csr_scalar<DeviceMatrix,DeviceArray,DeviceArray>);
+    test_spmv("csr_merge",  host_matrix, test_matrix_on_host, test_matrix_on_device, spmv_csr_merge<DeviceMatrix,DeviceArray,DeviceArray>);
 
     for(size_t num_cols = 2; num_cols < 64; num_cols *= 2)
       test_spmv_block("csr_block",  num_cols, host_matrix, test_matrix_on_host, test_matrix_on_device, cusp::multiply<DeviceMatrix,DeviceArray2d,DeviceArray2d>);
@@ -320,3 +424,96 @@ void test_hyb(HostMatrix& host_matrix)
     test_spmv("hyb",     host_matrix, test_matrix_on_host, test_matrix_on_device, cusp::multiply<DeviceMatrix,DeviceArray,DeviceArray>);
 }
 
+template <typename HostMatrix>
+void test_sell(HostMatrix& host_matrix)
+{
+    typedef typename HostMatrix::index_type IndexType;
+    typedef typename HostMatrix::value_type ValueType;
+
+    // convert HostMatrix to TestMatrix on host
+    cusp::sell_matrix<IndexType, ValueType, cusp::host_memory> test_matrix_on_host(host_matrix);
+
+    // transfer TestMatrix to device
+    typedef typename cusp::sell_matrix<IndexType, ValueType, cusp::device_memory> DeviceMatrix;
+    typedef typename cusp::array1d<ValueType, cusp::device_memory>                DeviceArray;
+    DeviceMatrix test_matrix_on_device(test_matrix_on_host);
+
+    test_spmv("sell",    host_matrix, test_matrix_on_host, test_matrix_on_device, cusp::multiply<DeviceMatrix,DeviceArray,DeviceArray>);
+}
+
+template <size_t BlockSize, typename HostMatrix>
+void test_bsr(HostMatrix& host_matrix)
+{
+    typedef typename HostMatrix::index_type IndexType;
+    typedef typename HostMatrix::value_type ValueType;
+
+    std::ostringstream kernel_name;
+    kernel_name << "bsr(" << BlockSize << "x" << BlockSize << ")";
+
+    // convert HostMatrix to TestMatrix on host
+    cusp::bsr_matrix<IndexType, ValueType, cusp::host_memory, BlockSize, BlockSize> test_matrix_on_host;
+
+    try
+    {
+        test_matrix_on_host = host_matrix;
+    }
+    catch (cusp::format_conversion_exception)
+    {
+        std::cout << "\tRefusing to convert to " << kernel_name.str() << " format" << std::endl;
+        return;
+    }
+
+    // transfer TestMatrix to device
+    typedef typename cusp::bsr_matrix<IndexType, ValueType, cusp::device_memory, BlockSize, BlockSize> DeviceMatrix;
+    typedef typename cusp::array1d<ValueType, cusp::device_memory>                                     DeviceArray;
+    DeviceMatrix test_matrix_on_device(test_matrix_on_host);
+
+    test_spmv(kernel_name.str(), host_matrix, test_matrix_on_host, test_matrix_on_device, cusp::multiply<DeviceMatrix,DeviceArray,DeviceArray>);
+}
+
+template <typename HostMatrix>
+void test_dcsr(HostMatrix& host_matrix)
+{
+    typedef typename HostMatrix::index_type IndexType;
+    typedef typename HostMatrix::value_type ValueType;
+
+    // convert HostMatrix to TestMatrix on host
+    cusp::dcsr_matrix<IndexType, ValueType, cusp::host_memory> test_matrix_on_host(host_matrix);
+
+    // transfer TestMatrix to device
+    typedef typename cusp::dcsr_matrix<IndexType, ValueType, cusp::device_memory> DeviceMatrix;
+    typedef typename cusp::array1d<ValueType, cusp::device_memory>                DeviceArray;
+    DeviceMatrix test_matrix_on_device(test_matrix_on_host);
+
+    test_spmv("dcsr",    host_matrix, test_matrix_on_host, test_matrix_on_device, cusp::multiply<DeviceMatrix,DeviceArray,DeviceArray>);
+}
+
+template <typename HostMatrix>
+void test_symmetric(HostMatrix& host_matrix)
+{
+    typedef typename HostMatrix::index_type IndexType;
+    typedef typename HostMatrix::value_type ValueType;
+
+    // convert HostMatrix to TestMatrix on host
+    cusp::symmetric_matrix<IndexType, ValueType, cusp::host_memory> test_matrix_on_host(host_matrix);
+
+    // the conversion discards the lower triangle, which only loses
+    // information if the matrix is not symmetric
+    cusp::csr_matrix<IndexType, ValueType, cusp::host_memory> restored(test_matrix_on_host);
+
+    if (restored.num_entries != host_matrix.num_entries ||
+        !thrust::equal(restored.row_offsets.begin(),    restored.row_offsets.end(),    host_matrix.row_offsets.begin())    ||
+        !thrust::equal(restored.column_indices.begin(), restored.column_indices.end(), host_matrix.column_indices.begin()) ||
+        !thrust::equal(restored.values.begin(),         restored.values.end(),         host_matrix.values.begin()))
+    {
+        std::cout << "\tRefusing to convert a nonsymmetric matrix to symmetric format" << std::endl;
+        return;
+    }
+
+    // transfer TestMatrix to device
+    typedef typename cusp::symmetric_matrix<IndexType, ValueType, cusp::device_memory> DeviceMatrix;
+    typedef typename cusp::array1d<ValueType, cusp::device_memory>                     DeviceArray;
+    DeviceMatrix test_matrix_on_device(test_matrix_on_host);
+
+    test_spmv("symmetric", host_matrix, test_matrix_on_host, test_matrix_on_device, cusp::multiply<DeviceMatrix,DeviceArray,DeviceArray>);
+}
@@ -1,60 +1,129 @@
 #pragma once
 
+#include <cusp/bsr_matrix.h>
 #include <cusp/coo_matrix.h>
 #include <cusp/csr_matrix.h>
+#include <cusp/dcsr_matrix.h>
 #include <cusp/dia_matrix.h>
 #include <cusp/ell_matrix.h>
 #include <cusp/hyb_matrix.h>
+#include <cusp/sell_matrix.h>
+#include <cusp/symmetric_matrix.h>
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+// How the loads of the input vector x are counted. The kernels gather x[j]
+// for every stored entry, but how many of those gathers reach DRAM depends
+// on how well the caches capture the reuse of x:
+//
+//   x_per_entry   every gather loads x[j], i.e. no reuse at all (upper bound)
+//   x_cache_lines every window of X_CACHE_WINDOW_ROWS consecutive rows loads
+//                 each cache line of x it touches once, which approximates a
+//                 cache holding the part of x used by one thread block
+//   x_once        every x[j] is loaded exactly once, the compulsory traffic
+//                 a perfect cache would leave (lower bound, used for the
+//                 roofline)
+enum x_vector_model
+{
+    x_per_entry,
+    x_cache_lines,
+    x_once
+};
+
+const size_t X_CACHE_LINE_BYTES  = 128;
+const size_t X_CACHE_WINDOW_ROWS = 256;
+
+// bytes of x loaded by windows of rows under the x_cache_lines model
+template <typename Matrix>
+size_t x_cache_line_bytes(const Matrix& mtx)
+{
+    typedef typename Matrix::index_type IndexType;
+    typedef typename Matrix::value_type ValueType;
+
+    cusp::coo_matrix<IndexType,ValueType,cusp::host_memory> coo(mtx);
+
+    const size_t values_per_line = std::max(size_t(1), X_CACHE_LINE_BYTES / sizeof(ValueType));
+
+    // distinct (row window, cache line) pairs
+    std::vector< std::pair<size_t,size_t> > lines(coo.num_entries);
+    for(size_t n = 0; n < coo.num_entries; n++)
+        lines[n] = std::make_pair(size_t(coo.row_indices[n]) / X_CACHE_WINDOW_ROWS,
+                                  size_t(coo.column_indices[n]) / values_per_line);
+
+    std::sort(lines.begin(), lines.end());
+
+    return X_CACHE_LINE_BYTES * (std::unique(lines.begin(), lines.end()) - lines.begin());
+}
+
+// bytes of x loaded by a kernel gathering x num_gathers times
+template <typename Matrix>
+size_t x_bytes_per_spmv(const Matrix& mtx, size_t num_gathers, x_vector_model model)
+{
+    typedef typename Matrix::value_type ValueType;
+
+    switch(model)
+    {
+        case x_once:        return sizeof(ValueType) * std::min(size_t(mtx.num_cols), num_gathers);
+        case x_cache_lines: return std::min(x_cache_line_bytes(mtx), sizeof(ValueType) * num_gathers);
+        default:            return sizeof(ValueType) * num_gathers;
+    }
+}
 
 template <typename IndexType, typename ValueType>
-size_t bytes_per_spmv(const cusp::dia_matrix<IndexType,ValueType,cusp::host_memory>& mtx)
+size_t bytes_per_spmv(const cusp::dia_matrix<IndexType,ValueType,cusp::host_memory>& mtx, x_vector_model model = x_per_entry)
 {
     // note: this neglects diag_offsets, which is < 1% of other parts
     size_t bytes = 0;
-    bytes += 2*sizeof(ValueType) * mtx.num_entries;  // A[i,j] and x[j]
+    bytes += 1*sizeof(ValueType) * mtx.num_entries;  // A[i,j]
+    bytes += x_bytes_per_spmv(mtx, mtx.num_entries, model);  // x[j]
     bytes += 2*sizeof(ValueType) * mtx.num_rows;     // y[i] = y[i] + ...
     return bytes;
 }
 
 template <typename IndexType, typename ValueType>
-size_t bytes_per_spmv(const cusp::ell_matrix<IndexType,ValueType,cusp::host_memory>& mtx)
+size_t bytes_per_spmv(const cusp::ell_matrix<IndexType,ValueType,cusp::host_memory>& mtx, x_vector_model model = x_per_entry)
 {
     size_t bytes = 0;
     bytes += 1*sizeof(ValueType) * mtx.num_rows * mtx.values.num_cols; // A[i,j] and padding
     bytes += 1*sizeof(IndexType) * mtx.num_entries;  // column index
-    bytes += 1*sizeof(ValueType) * mtx.num_entries;  // x[j]
+    bytes += x_bytes_per_spmv(mtx, mtx.num_entries, model);  // x[j]
     bytes += 2*sizeof(ValueType) * mtx.num_rows;     // y[i] = y[i] + ...
     return bytes;
 }
 
 template <typename IndexType, typename ValueType>
-size_t bytes_per_spmv(const cusp::csr_matrix<IndexType,ValueType,cusp::host_memory>& mtx)
+size_t bytes_per_spmv(const cusp::csr_matrix<IndexType,ValueType,cusp::host_memory>& mtx, x_vector_model model = x_per_entry)
 {
     size_t bytes = 0;
     bytes += 2*sizeof(IndexType) * mtx.num_rows;     // row pointer
     bytes += 1*sizeof(IndexType) * mtx.num_entries;  // column index
-    bytes += 2*sizeof(ValueType) * mtx.num_entries;  // A[i,j] and x[j]
+    bytes += 1*sizeof(ValueType) * mtx.num_entries;  // A[i,j]
+    bytes += x_bytes_per_spmv(mtx, mtx.num_entries, model);  // x[j]
     bytes += 2*sizeof(ValueType) * mtx.num_rows;     // y[i] = y[i] + ...
     return bytes;
 }
 
 template <typename IndexType, typename ValueType>
-size_t bytes_per_spmv_block(const cusp::csr_matrix<IndexType,ValueType,cusp::host_memory>& mtx, size_t num_cols)
+size_t bytes_per_spmv_block(const cusp::csr_matrix<IndexType,ValueType,cusp::host_memory>& mtx, size_t num_cols, x_vector_model model = x_per_entry)
 {
     size_t bytes = 0;
     bytes += 2*sizeof(IndexType) * mtx.num_rows;     // row pointer
     bytes += 1*sizeof(IndexType) * mtx.num_entries;  // column index
-    bytes += (num_cols + 1)*sizeof(ValueType) * mtx.num_entries;  // A[i,j] and x[j]
+    bytes += 1*sizeof(ValueType) * mtx.num_entries;  // A[i,j]
+    bytes += num_cols * x_bytes_per_spmv(mtx, mtx.num_entries, model);  // x[j,:]
     bytes += (num_cols + 1)*sizeof(ValueType) * mtx.num_rows;     // y[i] = y[i] + ...
     return bytes;
 }
 
 template <typename IndexType, typename ValueType>
-size_t bytes_per_spmv(const cusp::coo_matrix<IndexType,ValueType,cusp::host_memory>& mtx)
+size_t bytes_per_spmv(const cusp::coo_matrix<IndexType,ValueType,cusp::host_memory>& mtx, x_vector_model model = x_per_entry)
 {
     size_t bytes = 0;
     bytes += 2*sizeof(IndexType) * mtx.num_entries; // row and column indices
-    bytes += 2*sizeof(ValueType) * mtx.num_entries; // A[i,j] and x[j]
+    bytes += 1*sizeof(ValueType) * mtx.num_entries; // A[i,j]
+    bytes += x_bytes_per_spmv(mtx, mtx.num_entries, model);  // x[j]
 
     std::vector<size_t> occupied_rows(mtx.num_rows, 0);
     for(size_t n = 0; n < mtx.num_entries; n++)
@@ -66,8 +135,77 @@ size_t bytes_per_spmv(const cusp::coo_matrix<IndexType,ValueType,cusp::host_memo
 }
 
 template <typename IndexType, typename ValueType>
-size_t bytes_per_spmv(const cusp::hyb_matrix<IndexType,ValueType,cusp::host_memory>& mtx)
+size_t bytes_per_spmv(const cusp::hyb_matrix<IndexType,ValueType,cusp::host_memory>& mtx, x_vector_model model = x_per_entry)
+{
+    // the ELL and COO parts are processed by separate kernels, both read x
+    return bytes_per_spmv(mtx.ell, model) + bytes_per_spmv(mtx.coo, model);
+}
+
+template <typename IndexType, typename ValueType>
+size_t bytes_per_spmv(const cusp::sell_matrix<IndexType,ValueType,cusp::host_memory>& mtx, x_vector_model model = x_per_entry)
+{
+    size_t bytes = 0;
+    bytes += 1*sizeof(IndexType) * (mtx.num_slices() + 1);   // slice offsets
+    bytes += 1*sizeof(IndexType) * mtx.num_rows;             // row permutation
+    bytes += 1*sizeof(IndexType) * mtx.column_indices.size(); // column index and padding
+    bytes += 1*sizeof(ValueType) * mtx.num_entries;          // A[i,j], padding is skipped
+    bytes += x_bytes_per_spmv(mtx, mtx.num_entries, model);  // x[j]
+    bytes += 2*sizeof(ValueType) * mtx.num_rows;             // y[i] = y[i] + ...
+    return bytes;
+}
+
+template <typename IndexType, typename ValueType, size_t BlockRows, size_t BlockCols>
+size_t bytes_per_spmv(const cusp::bsr_matrix<IndexType,ValueType,cusp::host_memory,BlockRows,BlockCols>& mtx, x_vector_model model = x_per_entry)
+{
+    // note: num_entries includes the explicit zeros inside the blocks
+    size_t bytes = 0;
+    bytes += 1*sizeof(IndexType) * (mtx.num_block_rows() + 1); // block row pointer
+    bytes += 1*sizeof(IndexType) * mtx.num_blocks();           // block column index
+    bytes += 1*sizeof(ValueType) * mtx.num_entries;            // A[i,j]
+    bytes += x_bytes_per_spmv(mtx, mtx.num_entries, model);    // x[j]
+    bytes += 2*sizeof(ValueType) * mtx.num_rows;               // y[i] = y[i] + ...
+    return bytes;
+}
+
+template <typename IndexType, typename ValueType>
+size_t bytes_per_spmv(const cusp::dcsr_matrix<IndexType,ValueType,cusp::host_memory>& mtx, x_vector_model model = x_per_entry)
 {
-    return bytes_per_spmv(mtx.ell) + bytes_per_spmv(mtx.coo);
+    typedef typename cusp::dcsr_matrix<IndexType,ValueType,cusp::host_memory>::delta_type DeltaType;
+
+    // only the blocks of rows falling back to full indices read column_indices
+    const size_t num_full_entries = mtx.column_indices.size();
+
+    size_t bytes = 0;
+    bytes += 2*sizeof(IndexType) * mtx.num_rows;         // row pointer
+    bytes += 1*sizeof(IndexType) * (mtx.num_blocks() + 1); // block offsets
+    bytes += 1*sizeof(DeltaType) * (mtx.num_entries - num_full_entries); // column delta
+    bytes += 1*sizeof(IndexType) * num_full_entries;     // column index
+    bytes += 1*sizeof(ValueType) * mtx.num_entries;      // A[i,j]
+    bytes += x_bytes_per_spmv(mtx, mtx.num_entries, model);  // x[j]
+    bytes += 2*sizeof(ValueType) * mtx.num_rows;         // y[i] = y[i] + ...
+    return bytes;
 }
 
+template <typename IndexType, typename ValueType>
+size_t bytes_per_spmv(const cusp::symmetric_matrix<IndexType,ValueType,cusp::host_memory>& mtx, x_vector_model model = x_per_entry)
+{
+    const cusp::csr_matrix<IndexType,ValueType,cusp::host_memory>& upper = mtx.upper;
+
+    size_t num_diagonal_entries = 0;
+    for(size_t i = 0; i < upper.num_rows; i++)
+        for(IndexType jj = upper.row_offsets[i]; jj < upper.row_offsets[i + 1]; jj++)
+            if(size_t(upper.column_indices[jj]) == i)
+                num_diagonal_entries++;
+
+    // every stored entry A[i,j] gathers x[j], every row i loads x[i] once
+    // for the transposed products, which are added to y[j] atomically
+    size_t bytes = 0;
+    bytes += 2*sizeof(IndexType) * upper.num_rows;       // row pointer
+    bytes += 1*sizeof(IndexType) * upper.num_entries;    // column index
+    bytes += 1*sizeof(ValueType) * upper.num_entries;    // A[i,j]
+    bytes += x_bytes_per_spmv(upper, upper.num_entries + upper.num_rows, model);  // x[j] and x[i]
+    bytes += 2*sizeof(ValueType) * upper.num_rows;       // y[i] = initialize(y[i])
+    bytes += 2*sizeof(ValueType) * upper.num_rows;       // y[i] += ...
+    bytes += 2*sizeof(ValueType) * (upper.num_entries - num_diagonal_entries); // y[j] += A[i,j] * x[i]
+    return bytes;
+}
@@ -99,6 +99,8 @@ def run_tests(value_type):
     
     write_csv('gflops') #GFLOP/s
     write_csv('gbytes') #GBytes/s
+    write_csv('gbytes_cached') #GBytes/s with cached x
+    write_csv('roofline') #percent of the STREAM roofline
 
 
 run_tests('float')
@@ -81,9 +81,13 @@ void test_all_formats(std::string& filename)
     std::cout << "with shape ("  << host_matrix.num_rows << "," << host_matrix.num_cols << ") and "
               << host_matrix.num_entries << " entries" << "\n\n";
 
+    double stream = stream_bandwidth<ValueType>();
+
+    std::cout << "Measured STREAM bandwidth " << stream / 1e9 << " GB/s" << "\n\n";
+
     FILE * fid = fopen(BENCHMARK_OUTPUT_FILE_NAME, "a");
-    fprintf(fid, "file=%s rows=%d cols=%d nonzeros=%d\n", filename.c_str(),
-            (int) host_matrix.num_rows, (int) host_matrix.num_cols, (int) host_matrix.num_entries);
+    fprintf(fid, "file=%s rows=%d cols=%d nonzeros=%d stream_gbytes=%f\n", filename.c_str(),
+            (int) host_matrix.num_rows, (int) host_matrix.num_cols, (int) host_matrix.num_entries, stream / 1e9);
     fclose(fid);
 
     test_coo(host_matrix);
@@ -91,6 +95,11 @@ void test_all_formats(std::string& filename)
     test_dia(host_matrix);
     test_ell(host_matrix);
     test_hyb(host_matrix);
+    test_sell(host_matrix);
+    test_bsr<2>(host_matrix);
+    test_bsr<4>(host_matrix);
+    test_dcsr(host_matrix);
+    test_symmetric(host_matrix);
 }
 
 int main(int argc, char** argv)
@@ -10,6 +10,8 @@
 
 #include <cusp/gallery/poisson.h>
 
+#include <thrust/extrema.h>
+
 template <class MemorySpace>
 void TestStandardAggregate(void)
 {
@@ -40,3 +42,89 @@ void TestMISAggregate(void)
 }
 DECLARE_HOST_DEVICE_UNITTEST(TestMISAggregate);
 
+template <class MemorySpace>
+void TestMIS2Aggregate(void)
+{
+    typedef typename cusp::precond::aggregation::detail::select_sa_matrix_type<int,float,MemorySpace>::type SetupMatrixType;
+
+    SetupMatrixType A;
+    cusp::gallery::poisson5pt(A, 10, 10);
+
+    cusp::array1d<int,MemorySpace> aggregates(A.num_rows);
+    cusp::array1d<int,MemorySpace> roots(A.num_rows);
+    cusp::precond::aggregation::mis2_aggregate(A, aggregates, roots);
+
+    cusp::array1d<int,cusp::host_memory> h_aggregates(aggregates);
+    cusp::array1d<int,cusp::host_memory> h_roots(roots);
+
+    int num_aggregates = *thrust::max_element(h_aggregates.begin(), h_aggregates.end()) + 1;
+
+    ASSERT_EQUAL(*thrust::min_element(h_aggregates.begin(), h_aggregates.end()) >= 0, true);
+    ASSERT_EQUAL(num_aggregates < int(A.num_rows), true);
+
+    // every aggregate owns its root node
+    for(int i = 0; i < num_aggregates; i++)
+        ASSERT_EQUAL(h_aggregates[h_roots[i]], i);
+}
+DECLARE_HOST_DEVICE_UNITTEST(TestMIS2Aggregate);
+
+
+template <class MemorySpace>
+void TestBoundAggregates(void)
+{
+    typedef typename cusp::precond::aggregation::detail::select_sa_matrix_type<int,float,MemorySpace>::type SetupMatrixType;
+
+    SetupMatrixType A;
+    cusp::gallery::poisson5pt(A, 30, 30);
+
+    cusp::array1d<int,MemorySpace> aggregates(A.num_rows);
+    cusp::array1d<int,MemorySpace> roots(A.num_rows);
+    cusp::precond::aggregation::aggregate(A, aggregates, roots);
+    cusp::precond::aggregation::bound_aggregates(A, aggregates, roots, 3, 6);
+
+    cusp::array1d<int,cusp::host_memory> h_aggregates(aggregates);
+    cusp::array1d<int,cusp::host_memory> h_roots(roots);
+
+    int num_aggregates = *thrust::max_element(h_aggregates.begin(), h_aggregates.end()) + 1;
+
+    cusp::array1d<int,cusp::host_memory> sizes(num_aggregates, 0);
+    for(size_t i = 0; i < h_aggregates.size(); i++)
+        sizes[h_aggregates[i]]++;
+
+    ASSERT_EQUAL(*thrust::min_element(sizes.begin(), sizes.end()) >= 3, true);
+    ASSERT_EQUAL(*thrust::max_element(sizes.begin(), sizes.end()) <= 6, true);
+
+    for(int i = 0; i < num_aggregates; i++)
+        ASSERT_EQUAL(h_aggregates[h_roots[i]], i);
+}
+DECLARE_HOST_DEVICE_UNITTEST(TestBoundAggregates);
+
+template <class MemorySpace>
+void TestAggressiveAggregate(void)
+{
+    typedef typename cusp::precond::aggregation::detail::select_sa_matrix_type<int,float,MemorySpace>::type SetupMatrixType;
+
+    SetupMatrixType A;
+    cusp::gallery::poisson5pt(A, 30, 30);
+
+    cusp::array1d<int,MemorySpace> aggregates(A.num_rows);
+    cusp::array1d<int,MemorySpace> roots(A.num_rows);
+    cusp::precond::aggregation::aggressive_aggregate(A, aggregates, roots);
+
+    cusp::array1d<int,MemorySpace> standard(A.num_rows);
+    cusp::precond::aggregation::aggregate(A, standard);
+
+    cusp::array1d<int,cusp::host_memory> h_aggregates(aggregates);
+    cusp::array1d<int,cusp::host_memory> h_roots(roots);
+    cusp::array1d<int,cusp::host_memory> h_standard(standard);
+
+    int num_aggregates = *thrust::max_element(h_aggregates.begin(), h_aggregates.end()) + 1;
+    int num_standard   = *thrust::max_element(h_standard.begin(), h_standard.end()) + 1;
+
+    ASSERT_EQUAL(*thrust::min_element(h_aggregates.begin(), h_aggregates.end()) >= 0, true);
+    ASSERT_EQUAL(2 * num_aggregates < num_standard, true);
+
+    for(int i = 0; i < num_aggregates; i++)
+        ASSERT_EQUAL(h_aggregates[h_roots[i]], i);
+}
+DECLARE_HOST_DEVICE_UNITTEST(TestAggressiveAggregate);
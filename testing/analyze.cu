@@ -0,0 +1,139 @@
+#include <unittest/unittest.h>
+
+#include <cusp/analyze.h>
+#include <cusp/auto_matrix.h>
+
+#include <cusp/array1d.h>
+#include <cusp/coo_matrix.h>
+#include <cusp/csr_matrix.h>
+#include <cusp/multiply.h>
+
+#include <cusp/gallery/poisson.h>
+
+#include <cmath>
+
+// one dense row on top of the main diagonal
+template <typename MatrixType>
+void initialize_arrow_example(MatrixType& A)
+{
+    const int N = 16;
+
+    cusp::coo_matrix<int, float, cusp::host_memory> B(N, N, 2 * N - 1);
+
+    for(int i = 0; i < N; i++)
+    {
+        B.row_indices[i] = 0;
+        B.column_indices[i] = i;
+        B.values[i] = 1;
+    }
+
+    for(int i = 1; i < N; i++)
+    {
+        B.row_indices[N + i - 1] = i;
+        B.column_indices[N + i - 1] = i;
+        B.values[N + i - 1] = 2;
+    }
+
+    A = B;
+}
+
+template <class SparseMatrix>
+void TestAnalyze(void)
+{
+    SparseMatrix A;
+    cusp::gallery::poisson5pt(A, 4, 4);
+
+    cusp::matrix_profile profile = cusp::analyze(A);
+
+    ASSERT_EQUAL(profile.num_rows,            16);
+    ASSERT_EQUAL(profile.num_cols,            16);
+    ASSERT_EQUAL(profile.num_entries,         64);
+    ASSERT_EQUAL(profile.min_entries_per_row,  3);
+    ASSERT_EQUAL(profile.max_entries_per_row,  5);
+    ASSERT_EQUAL(profile.num_diagonals,        5);
+
+    ASSERT_EQUAL(profile.mean_entries_per_row, 4.0);
+    ASSERT_ALMOST_EQUAL(profile.stddev_entries_per_row, std::sqrt(0.5));
+    ASSERT_EQUAL(profile.dia_fill_ratio, 1.25);
+    ASSERT_EQUAL(profile.ell_fill_ratio, 1.25);
+
+    // empty matrix
+    SparseMatrix B;
+    profile = cusp::analyze(B);
+
+    ASSERT_EQUAL(profile.num_rows,    0);
+    ASSERT_EQUAL(profile.num_entries, 0);
+}
+DECLARE_SPARSE_MATRIX_UNITTEST(TestAnalyze);
+
+template <typename MemorySpace>
+void TestPredictStorage(void)
+{
+    cusp::csr_matrix<int, float, MemorySpace> A;
+
+    cusp::gallery::poisson5pt(A, 4, 4);
+    cusp::matrix_profile banded = cusp::analyze(A);
+
+    initialize_arrow_example(A);
+    cusp::matrix_profile arrow = cusp::analyze(A);
+
+    ASSERT_EQUAL(arrow.num_diagonals, 16);
+    ASSERT_EQUAL(arrow.max_entries_per_row, 16);
+
+    ASSERT_EQUAL(cusp::predict_storage<cusp::host_memory>(banded), cusp::csr_storage);
+    ASSERT_EQUAL(cusp::predict_storage<cusp::host_memory>(arrow),  cusp::csr_storage);
+
+#if THRUST_DEVICE_SYSTEM == THRUST_DEVICE_SYSTEM_CUDA
+    ASSERT_EQUAL(cusp::predict_storage<cusp::device_memory>(banded), cusp::dia_storage);
+    ASSERT_EQUAL(cusp::predict_storage<cusp::device_memory>(arrow),  cusp::csr_storage);
+#endif
+}
+DECLARE_HOST_DEVICE_UNITTEST(TestPredictStorage);
+
+template <typename MemorySpace>
+void TestAutoMatrix(void)
+{
+    cusp::csr_matrix<int, float, MemorySpace> A;
+    cusp::gallery::poisson5pt(A, 10, 10);
+
+    cusp::array1d<float, MemorySpace> x(A.num_cols);
+    cusp::array1d<float, MemorySpace> y(A.num_rows, 0);
+    cusp::array1d<float, MemorySpace> z(A.num_rows, 0);
+
+    for(size_t i = 0; i < x.size(); i++)
+        x[i] = i % 7;
+
+    cusp::multiply(A, x, y);
+
+    cusp::auto_matrix<int, float, MemorySpace> B(A);
+
+    ASSERT_EQUAL(B.num_rows,    A.num_rows);
+    ASSERT_EQUAL(B.num_cols,    A.num_cols);
+    ASSERT_EQUAL(B.num_entries, A.num_entries);
+    ASSERT_EQUAL(B.storage, cusp::predict_storage<MemorySpace>(B.profile));
+
+    cusp::multiply(B, x, z);
+    ASSERT_EQUAL(z, y);
+
+    // timed trial on a host matrix
+    cusp::coo_matrix<int, float, cusp::host_memory> C(A);
+    B.assign(C, true);
+
+    thrust::fill(z.begin(), z.end(), 0.0f);
+    cusp::multiply(B, x, z);
+    ASSERT_EQUAL(z, y);
+
+    initialize_arrow_example(A);
+
+    x.resize(A.num_cols);
+    y.resize(A.num_rows);
+    z.resize(A.num_rows);
+    thrust::fill(x.begin(), x.end(), 1.0f);
+
+    cusp::multiply(A, x, y);
+
+    B.assign(A, true);
+    cusp::multiply(B, x, z);
+    ASSERT_EQUAL(z, y);
+}
+DECLARE_HOST_DEVICE_UNITTEST(TestAutoMatrix);
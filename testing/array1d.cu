@@ -165,6 +165,36 @@ void TestArray1dAssignment(void)
 DECLARE_HOST_DEVICE_UNITTEST(TestArray1dAssignment)
 
 
+template <typename MemorySpace>
+void TestArray1dNoInit(void)
+{
+    cusp::array1d<int, MemorySpace> a(4, cusp::no_init);
+    ASSERT_EQUAL(a.size(), 4);
+
+    a[0] = 10;
+    a[1] = 20;
+    a[2] = 30;
+    a[3] = 40;
+
+    // shrinking and growing within the capacity keeps the storage
+    a.resize(2, cusp::no_init);
+    ASSERT_EQUAL(a.size(), 2);
+    ASSERT_EQUAL(a[0], 10);
+    ASSERT_EQUAL(a[1], 20);
+
+    // growing beyond the capacity preserves the existing elements
+    a.resize(100, cusp::no_init);
+    ASSERT_EQUAL(a.size(), 100);
+    ASSERT_EQUAL(a[0], 10);
+    ASSERT_EQUAL(a[1], 20);
+
+    // the other resize overloads are still available
+    a.resize(101, 7);
+    ASSERT_EQUAL(a[100], 7);
+}
+DECLARE_HOST_DEVICE_UNITTEST(TestArray1dNoInit)
+
+
 template <typename MemorySpace>
 void TestArray1dEquality(void)
 {
@@ -0,0 +1,163 @@
+#include <unittest/unittest.h>
+
+#include <cusp/assemble.h>
+
+#include <cusp/array1d.h>
+#include <cusp/array2d.h>
+#include <cusp/coo_matrix.h>
+#include <cusp/csr_matrix.h>
+#include <cusp/dia_matrix.h>
+#include <cusp/ell_matrix.h>
+#include <cusp/hyb_matrix.h>
+
+// unordered (i,j,v) triplets with duplicates
+template <typename ArrayType1, typename ArrayType2>
+void initialize_assemble_example(ArrayType1& I, ArrayType1& J, ArrayType2& V)
+{
+    I.resize(10);
+    J.resize(10);
+    V.resize(10);
+
+    I[0] = 2; J[0] = 0; V[0] = 10;
+    I[1] = 0; J[1] = 2; V[1] = 10;
+    I[2] = 1; J[2] = 1; V[2] = 10;
+    I[3] = 2; J[3] = 0; V[3] = 10;
+    I[4] = 1; J[4] = 1; V[4] = 10;
+    I[5] = 0; J[5] = 0; V[5] = 10;
+    I[6] = 2; J[6] = 2; V[6] = 10;
+    I[7] = 0; J[7] = 0; V[7] = 10;
+    I[8] = 1; J[8] = 0; V[8] = 10;
+    I[9] = 0; J[9] = 0; V[9] = 10;
+}
+
+template <typename MatrixType>
+void verify_assemble_example(const MatrixType& A, const float scale = 1.0f)
+{
+    cusp::array2d<float, cusp::host_memory> dense(A);
+
+    ASSERT_EQUAL(A.num_rows,    3);
+    ASSERT_EQUAL(A.num_cols,    3);
+    ASSERT_EQUAL(A.num_entries, 6);
+
+    ASSERT_EQUAL(dense(0,0), 30 * scale);
+    ASSERT_EQUAL(dense(0,1),  0 * scale);
+    ASSERT_EQUAL(dense(0,2), 10 * scale);
+    ASSERT_EQUAL(dense(1,0), 10 * scale);
+    ASSERT_EQUAL(dense(1,1), 20 * scale);
+    ASSERT_EQUAL(dense(1,2),  0 * scale);
+    ASSERT_EQUAL(dense(2,0), 20 * scale);
+    ASSERT_EQUAL(dense(2,1),  0 * scale);
+    ASSERT_EQUAL(dense(2,2), 10 * scale);
+}
+
+template <class SparseMatrix>
+void TestAssemble(void)
+{
+    typedef typename SparseMatrix::index_type   IndexType;
+    typedef typename SparseMatrix::value_type   ValueType;
+    typedef typename SparseMatrix::memory_space MemorySpace;
+
+    cusp::array1d<IndexType, MemorySpace> I;
+    cusp::array1d<IndexType, MemorySpace> J;
+    cusp::array1d<ValueType, MemorySpace> V;
+
+    initialize_assemble_example(I, J, V);
+
+    SparseMatrix A;
+    cusp::assemble(3, 3, I, J, V, A);
+
+    verify_assemble_example(A);
+
+    // no triplets
+    I.resize(0);
+    J.resize(0);
+    V.resize(0);
+
+    cusp::assemble(4, 5, I, J, V, A);
+
+    ASSERT_EQUAL(A.num_rows,    4);
+    ASSERT_EQUAL(A.num_cols,    5);
+    ASSERT_EQUAL(A.num_entries, 0);
+}
+DECLARE_SPARSE_MATRIX_UNITTEST(TestAssemble);
+
+template <typename MatrixType>
+void TestAssembleValuesPattern(void)
+{
+    typedef typename MatrixType::index_type   IndexType;
+    typedef typename MatrixType::value_type   ValueType;
+    typedef typename MatrixType::memory_space MemorySpace;
+
+    cusp::array1d<IndexType, MemorySpace> I;
+    cusp::array1d<IndexType, MemorySpace> J;
+    cusp::array1d<ValueType, MemorySpace> V;
+
+    initialize_assemble_example(I, J, V);
+
+    // build the pattern once
+    MatrixType A;
+    cusp::assemble(3, 3, I, J, V, A);
+
+    // reassemble doubled values into the same pattern
+    cusp::array1d<ValueType, MemorySpace> W(V.size(), ValueType(20));
+    cusp::assemble_values(I, J, W, A);
+
+    verify_assemble_example(A, 2.0f);
+
+    // entries without triplets become zero, the pattern is kept
+    cusp::array1d<IndexType, MemorySpace> I2(I.begin(), I.begin() + 3);
+    cusp::array1d<IndexType, MemorySpace> J2(J.begin(), J.begin() + 3);
+    cusp::array1d<ValueType, MemorySpace> W2(W.begin(), W.begin() + 3);
+    cusp::assemble_values(I2, J2, W2, A);
+
+    cusp::array2d<float, cusp::host_memory> dense(A);
+
+    ASSERT_EQUAL(A.num_entries, 6);
+    ASSERT_EQUAL(dense(0,0),  0);
+    ASSERT_EQUAL(dense(0,2), 20);
+    ASSERT_EQUAL(dense(1,1), 20);
+    ASSERT_EQUAL(dense(2,0), 20);
+    ASSERT_EQUAL(dense(2,2),  0);
+
+    // triplets outside of the pattern are rejected
+    I2[0] = 1; J2[0] = 2;
+    ASSERT_THROWS(cusp::assemble_values(I2, J2, W2, A), cusp::invalid_input_exception);
+
+    // A is left untouched
+    cusp::array2d<float, cusp::host_memory> dense2(A);
+    ASSERT_EQUAL(dense2(1,1), 20);
+}
+
+template <typename MemorySpace>
+void TestAssembleValues(void)
+{
+    TestAssembleValuesPattern< cusp::coo_matrix<int, float,  MemorySpace> >();
+    TestAssembleValuesPattern< cusp::csr_matrix<int, float,  MemorySpace> >();
+    TestAssembleValuesPattern< cusp::csr_matrix<int, double, MemorySpace> >();
+}
+DECLARE_HOST_DEVICE_UNITTEST(TestAssembleValues);
+
+template <typename ArrayType1, typename ArrayType2, typename ArrayType3, typename MatrixType>
+void assemble(my_system& system, const size_t num_rows, const size_t num_cols,
+              const ArrayType1& I, const ArrayType2& J, const ArrayType3& V, MatrixType& A)
+{
+    system.validate_dispatch();
+    return;
+}
+
+void TestAssembleDispatch()
+{
+    // initialize testing variables
+    cusp::array1d<int,   cusp::device_memory> I, J;
+    cusp::array1d<float, cusp::device_memory> V;
+    cusp::csr_matrix<int, float, cusp::device_memory> A;
+
+    my_system sys(0);
+
+    // call with explicit dispatching
+    cusp::assemble(sys, 3, 3, I, J, V, A);
+
+    // check if dispatch policy was used
+    ASSERT_EQUAL(true, sys.is_valid());
+}
+DECLARE_UNITTEST(TestAssembleDispatch);
@@ -0,0 +1,107 @@
+#include <unittest/unittest.h>
+
+#include <cusp/array1d.h>
+#include <cusp/async.h>
+#include <cusp/coo_matrix.h>
+#include <cusp/csr_matrix.h>
+#include <cusp/hyb_matrix.h>
+#include <cusp/linear_operator.h>
+#include <cusp/monitor.h>
+#include <cusp/multiply.h>
+#include <cusp/transpose.h>
+
+#include <cusp/gallery/poisson.h>
+#include <cusp/gallery/random.h>
+#include <cusp/krylov/cg.h>
+
+template <class MemorySpace>
+void TestMultiplyAsync(void)
+{
+    cusp::csr_matrix<int, float, MemorySpace> A;
+    cusp::gallery::poisson5pt(A, 30, 20);
+
+    cusp::array1d<float, MemorySpace> x(A.num_cols);
+    for (size_t i = 0; i < x.size(); i++)
+        x[i] = float(i % 7);
+
+    cusp::array1d<float, MemorySpace> y(A.num_rows, 0);
+    cusp::array1d<float, MemorySpace> z(A.num_rows, 0);
+
+    cusp::multiply(A, x, y);
+
+    cusp::completion_event event = cusp::multiply_async(A, x, z);
+
+    // copies share the event
+    cusp::completion_event copy(event);
+    event = cusp::completion_event();
+    ASSERT_EQUAL(event.ready(), true);
+
+    copy.wait();
+    ASSERT_EQUAL(copy.ready(), true);
+    ASSERT_EQUAL(z, y);
+}
+DECLARE_HOST_DEVICE_UNITTEST(TestMultiplyAsync);
+
+void TestMultiplyAsyncStream(void)
+{
+    cusp::csr_matrix<int, float, cusp::device_memory> A;
+    cusp::gallery::random(A, 500, 400, 3000);
+
+    cusp::array1d<float, cusp::device_memory> x(A.num_cols, 1);
+    cusp::array1d<float, cusp::device_memory> y(A.num_rows, 0);
+    cusp::array1d<float, cusp::device_memory> z(A.num_rows, 0);
+
+    cusp::multiply(A, x, y);
+
+    cusp::hyb_matrix<int, float, cusp::device_memory> B;
+    cusp::csr_matrix<int, float, cusp::device_memory> At;
+
+    cudaStream_t s;
+    cudaStreamCreateWithFlags(&s, cudaStreamNonBlocking);
+
+    cusp::completion_event converted  = cusp::convert_async(cusp::cuda::par.on(s), A, B);
+    cusp::completion_event transposed = cusp::transpose_async(cusp::cuda::par.on(s), A, At);
+    cusp::completion_event multiplied = cusp::multiply_async(cusp::cuda::par.on(s), B, x, z);
+
+    multiplied.wait();
+    ASSERT_EQUAL(converted.ready(), true);
+    ASSERT_EQUAL(transposed.ready(), true);
+
+    cudaStreamDestroy(s);
+
+    ASSERT_EQUAL(B.num_entries, A.num_entries);
+    ASSERT_EQUAL(At.num_rows, A.num_cols);
+    ASSERT_EQUAL(At.num_entries, A.num_entries);
+    ASSERT_ALMOST_EQUAL(z, y);
+}
+DECLARE_UNITTEST(TestMultiplyAsyncStream);
+
+template <class MemorySpace>
+void TestSolveAsync(void)
+{
+#if __cplusplus >= 201103L
+    cusp::csr_matrix<int, float, MemorySpace> A;
+    cusp::gallery::poisson5pt(A, 20, 20);
+
+    cusp::array1d<float, MemorySpace> b(A.num_rows, 1);
+    cusp::array1d<float, MemorySpace> x(A.num_rows, 0);
+    cusp::array1d<float, MemorySpace> y(A.num_rows, 0);
+
+    cusp::identity_operator<float, MemorySpace> M(A.num_rows, A.num_rows);
+
+    // the same solve on the calling thread
+    cusp::monitor<float> expected_monitor(b, 100, 1e-5);
+    cusp::krylov::cg(A, y, b, expected_monitor, M);
+
+    cusp::krylov::cg_solver<float, MemorySpace> solver(A.num_rows);
+    cusp::monitor<float> monitor(b, 100, 1e-5);
+
+    std::future<void> solved = cusp::solve_async(solver, A, x, b, monitor, M);
+    solved.get();
+
+    ASSERT_EQUAL(monitor.converged(), true);
+    ASSERT_EQUAL(monitor.iteration_count(), expected_monitor.iteration_count());
+    ASSERT_ALMOST_EQUAL(x, y);
+#endif
+}
+DECLARE_HOST_DEVICE_UNITTEST(TestSolveAsync);
@@ -0,0 +1,73 @@
+#include <unittest/unittest.h>
+
+#include <cusp/array1d.h>
+#include <cusp/array2d.h>
+#include <cusp/async_upload.h>
+#include <cusp/coo_matrix.h>
+#include <cusp/csr_matrix.h>
+
+#include <cusp/gallery/poisson.h>
+
+template <typename SparseMatrix>
+void TestAsyncUpload(void)
+{
+    typedef typename SparseMatrix::value_type ValueType;
+    typedef typename SparseMatrix::template rebind<cusp::host_memory>::type HostMatrix;
+
+    HostMatrix A;
+    cusp::gallery::poisson5pt(A, 21, 17);
+
+    cusp::array2d<ValueType, cusp::host_memory> E(A);
+
+    // small buffers make every array span several chunks of the ring
+    SparseMatrix B;
+    cusp::upload_event event = cusp::async_upload(A, B, 64, 2);
+    event.wait();
+    ASSERT_EQUAL(event.ready(), true);
+
+    ASSERT_EQUAL(B.num_rows,    A.num_rows);
+    ASSERT_EQUAL(B.num_cols,    A.num_cols);
+    ASSERT_EQUAL(B.num_entries, A.num_entries);
+
+    cusp::array2d<ValueType, cusp::host_memory> D(B);
+    ASSERT_EQUAL(D == E, true);
+
+    // a source of another format is converted before the upload
+    cusp::coo_matrix<int, ValueType, cusp::host_memory> C(A);
+    SparseMatrix F;
+    cusp::async_upload(C, F, 256).wait();
+
+    cusp::array2d<ValueType, cusp::host_memory> G(F);
+    ASSERT_EQUAL(G == E, true);
+}
+DECLARE_SPARSE_MATRIX_UNITTEST(TestAsyncUpload);
+
+template <class MemorySpace>
+void TestAsyncUploadArray1d(void)
+{
+    cusp::array1d<float, cusp::host_memory> a(1000);
+    for (size_t i = 0; i < a.size(); i++)
+        a[i] = float(i % 13) - 6.0f;
+
+    cusp::array1d<float, MemorySpace> b;
+    cusp::upload_event event = cusp::async_upload(a, b, 100, 3);
+
+    // copies share the transfer
+    cusp::upload_event copy(event);
+    event = cusp::upload_event();
+    ASSERT_EQUAL(event.ready(), true);
+    copy.wait();
+
+    ASSERT_EQUAL(b, a);
+
+    // value type conversion and empty arrays
+    cusp::array1d<int, cusp::host_memory> c(a);
+    cusp::array1d<float, MemorySpace> d;
+    cusp::async_upload(c, d).wait();
+    ASSERT_EQUAL(d, a);
+
+    cusp::array1d<float, cusp::host_memory> e;
+    cusp::async_upload(e, d).wait();
+    ASSERT_EQUAL(d.size(), 0);
+}
+DECLARE_HOST_DEVICE_UNITTEST(TestAsyncUploadArray1d);
@@ -1,13 +1,18 @@
 #include <unittest/unittest.h>
 
+#include <cusp/coo_matrix.h>
 #include <cusp/csr_matrix.h>
 #include <cusp/linear_operator.h>
 #include <cusp/monitor.h>
 #include <cusp/multiply.h>
 
 #include <cusp/gallery/poisson.h>
+#include <cusp/krylov/batched_bicgstab.h>
 #include <cusp/krylov/bicg.h>
 #include <cusp/krylov/bicgstab.h>
+#include <cusp/krylov/bicgstab_graph.h>
+#include <cusp/krylov/pipelined_bicgstab.h>
+#include <cusp/precond/diagonal.h>
 
 template <class LinearOperator,
           class VectorType1,
@@ -180,3 +185,154 @@ void TestBiConjugateGradientStabilizedZeroResidual(void)
 }
 DECLARE_HOST_DEVICE_UNITTEST(TestBiConjugateGradientStabilizedZeroResidual)
 
+
+
+template <class MemorySpace>
+void TestPipelinedBiConjugateGradientStabilized(void)
+{
+    cusp::csr_matrix<int, float, MemorySpace> A;
+
+    cusp::gallery::poisson5pt(A, 10, 10);
+
+    cusp::array1d<float, MemorySpace> x(A.num_rows, 0.0f);
+    cusp::array1d<float, MemorySpace> b(A.num_rows, 1.0f);
+
+    cusp::monitor<float> monitor(b, 50, 1e-4);
+
+    cusp::krylov::pipelined_bicgstab(A, x, b, monitor);
+
+    ASSERT_EQUAL(monitor.converged(), true);
+
+    // the recurrences drift from the true residual, allow some slack
+    cusp::array1d<float, MemorySpace> residual(A.num_rows, 0.0f);
+    cusp::multiply(A, x, residual);
+    cusp::blas::axpby(residual, b, residual, -1.0f, 1.0f);
+
+    ASSERT_EQUAL(cusp::blas::nrm2(residual) < 1e-3 * cusp::blas::nrm2(b), true);
+}
+DECLARE_HOST_DEVICE_UNITTEST(TestPipelinedBiConjugateGradientStabilized)
+
+template <class MemorySpace>
+void TestBiConjugateGradientStabilizedGraph(void)
+{
+    cusp::csr_matrix<int, float, MemorySpace> A;
+
+    cusp::gallery::poisson5pt(A, 10, 10);
+
+    cusp::array1d<float, MemorySpace> x(A.num_rows, 0.0f);
+    cusp::array1d<float, MemorySpace> b(A.num_rows, 1.0f);
+
+    cusp::monitor<float> monitor(b, 20, 1e-4);
+
+    cusp::krylov::bicgstab_graph(A, x, b, monitor);
+
+    // check residual norm
+    cusp::array1d<float, MemorySpace> residual(A.num_rows, 0.0f);
+    cusp::multiply(A, x, residual);
+    cusp::blas::axpby(residual, b, residual, -1.0f, 1.0f);
+
+    ASSERT_EQUAL(cusp::blas::nrm2(residual) < 1e-4 * cusp::blas::nrm2(b), true);
+
+    // with a diagonal preconditioner, testing the residual every 3 replays
+    cusp::precond::diagonal<float, MemorySpace> M(A);
+    cusp::monitor<float> monitor2(b, 30, 1e-4, 0, false, 3);
+
+    cusp::blas::fill(x, 0.0f);
+    cusp::krylov::bicgstab_graph(A, x, b, monitor2, M);
+
+    ASSERT_EQUAL(monitor2.converged(), true);
+
+    cusp::multiply(A, x, residual);
+    cusp::blas::axpby(residual, b, residual, -1.0f, 1.0f);
+
+    ASSERT_EQUAL(cusp::blas::nrm2(residual) < 1e-4 * cusp::blas::nrm2(b), true);
+}
+DECLARE_HOST_DEVICE_UNITTEST(TestBiConjugateGradientStabilizedGraph)
+
+template <class MemorySpace>
+void TestBiConjugateGradientStabilizedSolver(void)
+{
+    cusp::csr_matrix<int, float, MemorySpace> A;
+
+    cusp::gallery::poisson5pt(A, 10, 10);
+
+    cusp::array1d<float, MemorySpace> x(A.num_rows, 0.0f);
+    cusp::array1d<float, MemorySpace> y(A.num_rows, 0.0f);
+    cusp::array1d<float, MemorySpace> b(A.num_rows, 1.0f);
+
+    cusp::monitor<float> monitor1(b, 20, 1e-4);
+    cusp::krylov::bicgstab(A, x, b, monitor1);
+
+    // the workspace is reused across solves
+    cusp::krylov::bicgstab_solver<float, MemorySpace> solver(A.num_rows);
+
+    for (int i = 0; i < 2; i++)
+    {
+        cusp::monitor<float> monitor2(b, 20, 1e-4);
+
+        cusp::blas::fill(y, 0.0f);
+        solver.solve(A, y, b, monitor2);
+
+        ASSERT_EQUAL(monitor2.iteration_count(), monitor1.iteration_count());
+        ASSERT_ALMOST_EQUAL(y, x);
+    }
+}
+DECLARE_HOST_DEVICE_UNITTEST(TestBiConjugateGradientStabilizedSolver)
+
+template <class MemorySpace>
+void TestBatchedBiConjugateGradientStabilized(void)
+{
+    const size_t num_systems = 3;
+
+    cusp::coo_matrix<int, float, cusp::host_memory> P;
+    cusp::gallery::poisson5pt(P, 5, 5);
+
+    const size_t N = P.num_rows;
+
+    // block diagonal matrix of scaled copies of P, the last system has b = 0
+    cusp::coo_matrix<int, float, cusp::host_memory> B(num_systems * N, num_systems * N, num_systems * P.num_entries);
+    cusp::array1d<float, cusp::host_memory> b_host(num_systems * N);
+
+    for (size_t i = 0; i < num_systems; i++)
+    {
+        for (size_t n = 0; n < P.num_entries; n++)
+        {
+            B.row_indices[i * P.num_entries + n]    = i * N + P.row_indices[n];
+            B.column_indices[i * P.num_entries + n] = i * N + P.column_indices[n];
+            B.values[i * P.num_entries + n]         = (i + 1) * P.values[n];
+        }
+
+        for (size_t n = 0; n < N; n++)
+            b_host[i * N + n] = (i + 1 < num_systems) ? float((n % 3) + i) : 0.0f;
+    }
+
+    cusp::csr_matrix<int, float, MemorySpace> A(B);
+    cusp::array1d<float, MemorySpace> x(A.num_rows, 0.0f);
+    cusp::array1d<float, MemorySpace> b(b_host);
+
+    cusp::monitor<float> monitor(b, 100, 1e-5);
+
+    cusp::krylov::batched_bicgstab(A, x, b, N, monitor);
+
+    ASSERT_EQUAL(monitor.iteration_count() < 100, true);
+
+    // check the residual of every system
+    cusp::array1d<float, MemorySpace> residual(A.num_rows, 0.0f);
+    cusp::multiply(A, x, residual);
+    cusp::blas::axpby(residual, b, residual, -1.0f, 1.0f);
+
+    cusp::array1d<float, cusp::host_memory> r(residual);
+    cusp::array1d<float, cusp::host_memory> x_host(x);
+
+    for (size_t i = 0; i < num_systems; i++)
+    {
+        float r_norm = cusp::blas::nrm2(r.subarray(i * N, N));
+        float b_norm = cusp::blas::nrm2(b_host.subarray(i * N, N));
+
+        ASSERT_EQUAL(r_norm <= 1e-4 * b_norm, true);
+    }
+
+    // the system with b = 0 is not touched
+    ASSERT_EQUAL(cusp::blas::nrm2(x_host.subarray((num_systems - 1) * N, N)), 0.0f);
+}
+DECLARE_HOST_DEVICE_UNITTEST(TestBatchedBiConjugateGradientStabilized)
@@ -4,9 +4,12 @@
 #include <cusp/coo_matrix.h>
 #include <cusp/csr_matrix.h>
 
+#include <cusp/gallery/poisson.h>
 #include <cusp/io/binary.h>
 
 #include <stdio.h>
+#include <sstream>
+#include <string>
 
 const char random_file_name[] = "test_93298409283221.bin";
 
@@ -127,3 +130,98 @@ void TestWriteBinaryFileCoordinateRealGeneral(void)
     ASSERT_EQUAL(D == E, true);
 }
 DECLARE_HOST_DEVICE_UNITTEST(TestWriteBinaryFileCoordinateRealGeneral)
+
+template <typename SparseMatrix>
+void TestCompressedBinaryFile(void)
+{
+    typedef typename SparseMatrix::value_type ValueType;
+
+    // several blocks with a partial last one
+    SparseMatrix A;
+    cusp::gallery::poisson5pt(A, 130, 110);
+
+    cusp::io::write_compressed_binary_file(A, random_file_name);
+
+    SparseMatrix B;
+    cusp::io::read_compressed_binary_file(B, random_file_name);
+
+    remove(random_file_name);
+
+    ASSERT_EQUAL(B.num_rows,    A.num_rows);
+    ASSERT_EQUAL(B.num_cols,    A.num_cols);
+    ASSERT_EQUAL(B.num_entries, A.num_entries);
+
+    cusp::array2d<ValueType, cusp::host_memory> D(B);
+    cusp::array2d<ValueType, cusp::host_memory> E(A);
+    ASSERT_EQUAL(D == E, true);
+}
+DECLARE_SPARSE_MATRIX_UNITTEST(TestCompressedBinaryFile);
+
+template <typename MemorySpace>
+void TestCompressedBinaryStream(void)
+{
+    // unsorted entries with irregular values
+    cusp::coo_matrix<int, double, cusp::host_memory> A(6, 1000, 5);
+    A.row_indices[0] = 4; A.column_indices[0] = 999; A.values[0] =  3.141592653589793;
+    A.row_indices[1] = 0; A.column_indices[1] =   2; A.values[1] = -1.0e-300;
+    A.row_indices[2] = 4; A.column_indices[2] =   0; A.values[2] =  2.0;
+    A.row_indices[3] = 5; A.column_indices[3] = 500; A.values[3] =  0.0;
+    A.row_indices[4] = 0; A.column_indices[4] =   1; A.values[4] = -2.0;
+
+    std::stringstream stream;
+    cusp::io::write_compressed_binary_stream(A, stream);
+
+    cusp::coo_matrix<int, double, MemorySpace> B;
+    cusp::io::read_compressed_binary_stream(B, stream);
+
+    A.sort_by_row_and_column();
+    ASSERT_EQUAL(B.row_indices,    A.row_indices);
+    ASSERT_EQUAL(B.column_indices, A.column_indices);
+    ASSERT_EQUAL(B.values,         A.values);
+
+    // array1d
+    cusp::array1d<float, cusp::host_memory> x(100000);
+    for (size_t i = 0; i < x.size(); i++)
+        x[i] = float(i % 17) * 0.125f - float(i % 5);
+
+    std::stringstream array_stream;
+    cusp::io::write_compressed_binary_stream(x, array_stream);
+
+    cusp::array1d<float, MemorySpace> y;
+    cusp::io::read_compressed_binary_stream(y, array_stream);
+    ASSERT_EQUAL(y, x);
+}
+DECLARE_HOST_DEVICE_UNITTEST(TestCompressedBinaryStream);
+
+void TestCompressedBinaryStreamInvalid(void)
+{
+    cusp::csr_matrix<int, float, cusp::host_memory> A;
+    cusp::gallery::poisson5pt(A, 10, 10);
+
+    std::stringstream stream;
+    cusp::io::write_compressed_binary_stream(A, stream);
+    const std::string contents = stream.str();
+
+    // different value type
+    {
+        std::stringstream input(contents);
+        cusp::csr_matrix<int, double, cusp::host_memory> B;
+        ASSERT_THROWS(cusp::io::read_compressed_binary_stream(B, input), cusp::io_exception);
+    }
+
+    // truncated
+    {
+        std::stringstream input(contents.substr(0, contents.size() - 10));
+        cusp::csr_matrix<int, float, cusp::host_memory> B;
+        ASSERT_THROWS(cusp::io::read_compressed_binary_stream(B, input), cusp::io_exception);
+    }
+
+    // uncompressed binary data
+    {
+        std::stringstream input;
+        cusp::io::write_binary_stream(A, input);
+        cusp::csr_matrix<int, float, cusp::host_memory> B;
+        ASSERT_THROWS(cusp::io::read_compressed_binary_stream(B, input), cusp::io_exception);
+    }
+}
+DECLARE_UNITTEST(TestCompressedBinaryStreamInvalid);
@@ -199,6 +199,97 @@ void TestAxpbypcz(void)
 DECLARE_HOST_DEVICE_UNITTEST(TestAxpbypcz)
 
 
+template <class MemorySpace>
+void TestAxpyAxpy(void)
+{
+    typedef typename cusp::array1d<float, MemorySpace>       Array;
+    typedef typename cusp::array1d<float, MemorySpace>::view View;
+
+    Array x1(4);
+    Array y1(4);
+    Array x2(4);
+    Array y2(4);
+
+    x1[0] =  7.0f;
+    y1[0] =  0.0f;
+    x2[0] =  1.0f;
+    y2[0] =  2.0f;
+    x1[1] =  5.0f;
+    y1[1] = -2.0f;
+    x2[1] =  0.0f;
+    y2[1] =  1.0f;
+    x1[2] =  4.0f;
+    y1[2] =  0.0f;
+    x2[2] = -1.0f;
+    y2[2] =  3.0f;
+    x1[3] = -3.0f;
+    y1[3] =  5.0f;
+    x2[3] =  2.0f;
+    y2[3] =  0.0f;
+
+    View view_x1(x1);
+    View view_y1(y1);
+    View view_x2(x2);
+    View view_y2(y2);
+
+    cusp::blas::axpy_axpy(view_x1, view_y1, 2.0f, view_x2, view_y2, -1.0f);
+
+    ASSERT_EQUAL(y1[0],  14.0);
+    ASSERT_EQUAL(y1[1],   8.0);
+    ASSERT_EQUAL(y1[2],   8.0);
+    ASSERT_EQUAL(y1[3],  -1.0);
+    ASSERT_EQUAL(y2[0],   1.0);
+    ASSERT_EQUAL(y2[1],   1.0);
+    ASSERT_EQUAL(y2[2],   4.0);
+    ASSERT_EQUAL(y2[3],  -2.0);
+
+    // test size checking
+    Array w(3);
+    ASSERT_THROWS(cusp::blas::axpy_axpy(x1, y1, 1.0f, x2, w, 1.0f), cusp::invalid_input_exception);
+}
+DECLARE_HOST_DEVICE_UNITTEST(TestAxpyAxpy)
+
+
+template <class MemorySpace>
+void TestAxpyAxpyDotc(void)
+{
+    typedef typename cusp::array1d<float, MemorySpace> Array;
+
+    Array x1(4, 1.0f);
+    Array y1(4, 2.0f);
+    Array x2(4);
+    Array y2(4, 1.0f);
+
+    x2[0] =  1.0f;
+    x2[1] =  0.0f;
+    x2[2] = -1.0f;
+    x2[3] =  2.0f;
+
+    // y2 = [3, 1, -1, 5]
+    float rr = cusp::blas::axpy_axpy_dotc(x1, y1, 0.5f, x2, y2, 2.0f);
+
+    ASSERT_EQUAL(rr, 36.0f);
+    ASSERT_EQUAL(y1[0],  2.5);
+    ASSERT_EQUAL(y1[3],  2.5);
+    ASSERT_EQUAL(y2[0],  3.0);
+    ASSERT_EQUAL(y2[1],  1.0);
+    ASSERT_EQUAL(y2[2], -1.0);
+    ASSERT_EQUAL(y2[3],  5.0);
+
+    typedef cusp::complex<float> ComplexType;
+
+    cusp::array1d<ComplexType, MemorySpace> a(2, ComplexType(0,0));
+    cusp::array1d<ComplexType, MemorySpace> c(2, ComplexType(1,1));
+    cusp::array1d<ComplexType, MemorySpace> d(2, ComplexType(0,1));
+
+    // d = [1 + 2i, 1 + 2i] and <d,d> = 10
+    ComplexType dd = cusp::blas::axpy_axpy_dotc(c, a, ComplexType(1,0), c, d, ComplexType(1,0));
+
+    ASSERT_EQUAL(dd, ComplexType(10,0));
+}
+DECLARE_HOST_DEVICE_UNITTEST(TestAxpyAxpyDotc)
+
+
 template <class MemorySpace>
 void TestXmy(void)
 {
@@ -353,6 +444,217 @@ void TestDotc(void)
 }
 DECLARE_HOST_DEVICE_UNITTEST(TestDotc)
 
+template <class MemorySpace>
+void TestDots(void)
+{
+    typedef typename cusp::array1d<double, MemorySpace>                     Array;
+    typedef typename cusp::array2d<double, MemorySpace, cusp::column_major> ColumnMajor;
+    typedef typename cusp::array2d<double, MemorySpace, cusp::row_major>    RowMajor;
+
+    // enough columns to span several column groups on the device
+    const size_t num_rows = 1000;
+    const size_t num_cols = 19;
+
+    Array x(num_rows);
+    ColumnMajor Y(num_rows, num_cols);
+
+    for (size_t i = 0; i < num_rows; i++)
+    {
+        x[i] = double(i % 7) - 3.0;
+
+        for (size_t j = 0; j < num_cols; j++)
+            Y(i,j) = double((i + 2 * j) % 5) - 1.0;
+    }
+
+    cusp::array1d<double, cusp::host_memory> expected(num_cols);
+
+    for (size_t j = 0; j < num_cols; j++)
+        expected[j] = cusp::blas::dot(x, Y.column(j));
+
+    cusp::array1d<double, MemorySpace> results;
+    cusp::blas::dots(x, Y, results);
+
+    ASSERT_EQUAL(results, expected);
+
+    cusp::array1d<double, cusp::host_memory> host_results;
+    cusp::blas::dots(x, RowMajor(Y), host_results);
+
+    ASSERT_EQUAL(host_results, expected);
+
+    // empty matrices
+    ColumnMajor Z(num_rows, 0);
+    cusp::blas::dots(x, Z, results);
+    ASSERT_EQUAL(results.size(), size_t(0));
+
+    // test size checking
+    Array w(3);
+    ASSERT_THROWS(cusp::blas::dots(w, Y, results), cusp::invalid_input_exception);
+}
+DECLARE_HOST_DEVICE_UNITTEST(TestDots)
+
+template <class MemorySpace>
+void TestDotcs(void)
+{
+    typedef cusp::complex<float> ValueType;
+
+    cusp::array1d<ValueType, MemorySpace> x(3);
+    cusp::array2d<ValueType, MemorySpace, cusp::column_major> Y(3, 2);
+
+    x[0] = ValueType(1.0f,  1.0f);
+    x[1] = ValueType(0.0f,  2.0f);
+    x[2] = ValueType(3.0f,  0.0f);
+
+    Y(0,0) = ValueType(1.0f,  0.0f); Y(0,1) = ValueType(0.0f,  1.0f);
+    Y(1,0) = ValueType(2.0f,  0.0f); Y(1,1) = ValueType(1.0f,  0.0f);
+    Y(2,0) = ValueType(0.0f, -1.0f); Y(2,1) = ValueType(1.0f,  1.0f);
+
+    cusp::array1d<ValueType, cusp::host_memory> results;
+    cusp::blas::dotcs(x, Y, results);
+
+    ASSERT_EQUAL(results.size(), size_t(2));
+    ASSERT_EQUAL(results[0], cusp::blas::dotc(x, Y.column(0)));
+    ASSERT_EQUAL(results[1], cusp::blas::dotc(x, Y.column(1)));
+}
+DECLARE_HOST_DEVICE_UNITTEST(TestDotcs)
+
+template <class MemorySpace>
+void TestDotcNrm2(void)
+{
+    typedef typename cusp::array1d<float, MemorySpace> Array;
+
+    Array x(4);
+    Array y(4);
+
+    x[0] =  1.0f; y[0] =  2.0f;
+    x[1] = -2.0f; y[1] =  1.0f;
+    x[2] =  2.0f; y[2] =  3.0f;
+    x[3] =  4.0f; y[3] = -1.0f;
+
+    float xy   = 0.0f;
+    float norm = 0.0f;
+
+    thrust::tie(xy, norm) = cusp::blas::dotc_nrm2(x, y);
+
+    ASSERT_EQUAL(xy,   2.0f);
+    ASSERT_EQUAL(norm, 5.0f);
+
+    // test size checking
+    Array w(3);
+    ASSERT_THROWS(cusp::blas::dotc_nrm2(x, w), cusp::invalid_input_exception);
+}
+DECLARE_HOST_DEVICE_UNITTEST(TestDotcNrm2)
+
+template <class MemorySpace>
+void TestReductionsIntoArrays(void)
+{
+    typedef typename cusp::array1d<float, MemorySpace> Array;
+
+    MemorySpace exec;
+
+    Array x(4);
+    Array y(4);
+
+    x[0] =  1.0f; y[0] =  2.0f;
+    x[1] = -2.0f; y[1] =  1.0f;
+    x[2] =  2.0f; y[2] =  3.0f;
+    x[3] =  4.0f; y[3] = -1.0f;
+
+    Array result;
+
+    cusp::blas::dot(exec, x, y, result);
+    ASSERT_EQUAL(result.size(), size_t(1));
+    ASSERT_EQUAL(result[0], 2.0f);
+
+    cusp::blas::dotc(exec, x, y, result);
+    ASSERT_EQUAL(result[0], 2.0f);
+
+    cusp::blas::nrm2(exec, x, result);
+    ASSERT_EQUAL(result[0], 5.0f);
+
+    // y = alpha[0] * x + y and x = alpha[0] * x with alpha in the same memory
+    Array alpha(1, 2.0f);
+
+    cusp::blas::axpy(exec, x, y, alpha);
+
+    ASSERT_EQUAL(y[0],  4.0f);
+    ASSERT_EQUAL(y[1], -3.0f);
+    ASSERT_EQUAL(y[2],  7.0f);
+    ASSERT_EQUAL(y[3],  7.0f);
+
+    cusp::blas::scal(exec, x, alpha);
+
+    ASSERT_EQUAL(x[0],  2.0f);
+    ASSERT_EQUAL(x[1], -4.0f);
+    ASSERT_EQUAL(x[2],  4.0f);
+    ASSERT_EQUAL(x[3],  8.0f);
+
+    // a chained update, the dot product feeds the axpy without a transfer
+    cusp::blas::dot(exec, x, x, alpha);
+    cusp::blas::scal(exec, y, alpha);
+
+    ASSERT_EQUAL(y[0], 400.0f);
+
+    // empty arrays reduce to zero
+    Array empty;
+    cusp::blas::dot(exec, empty, empty, result);
+    ASSERT_EQUAL(result[0], 0.0f);
+
+    Array w(3);
+    ASSERT_THROWS(cusp::blas::dotc(exec, x, w, result), cusp::invalid_input_exception);
+    ASSERT_THROWS(cusp::blas::scal(exec, x, empty), cusp::invalid_input_exception);
+}
+DECLARE_HOST_DEVICE_UNITTEST(TestReductionsIntoArrays)
+
+template <class MemorySpace>
+void TestCompensatedReductions(void)
+{
+    MemorySpace system;
+
+    // the two ones are lost next to 1e8 in float arithmetic
+    cusp::array1d<float, cusp::host_memory> a(4);
+    a[0] = 1e8f; a[1] = 1.0f; a[2] = -1e8f; a[3] = 1.0f;
+
+    cusp::array1d<float, MemorySpace> x(a);
+    cusp::array1d<float, MemorySpace> ones(4, 1.0f);
+
+    ASSERT_EQUAL(cusp::blas::dot(system.compensated(), x, ones), 2.0f);
+    ASSERT_EQUAL(cusp::blas::dotc(system.compensated(), x, ones), 2.0f);
+
+    cusp::array1d<cusp::complex<float>, MemorySpace> z(x);
+    cusp::array1d<cusp::complex<float>, MemorySpace> w(4, cusp::complex<float>(0.0f, 1.0f));
+
+    ASSERT_EQUAL(cusp::blas::dotc(system.compensated(), w, z), cusp::complex<float>(0.0f, -2.0f));
+
+    // double data is summed with compensation
+    cusp::array1d<double, cusp::host_memory> b(4);
+    b[0] = 1e17; b[1] = 1.0; b[2] = -1e17; b[3] = 1.0;
+
+    cusp::array1d<double, MemorySpace> y(b);
+    cusp::array1d<double, MemorySpace> ones_d(4, 1.0);
+
+    ASSERT_EQUAL(cusp::blas::dot(system.compensated(), y, ones_d), 2.0);
+
+    // N * 0.1f^2 and its square root are exact in double precision
+    const size_t N = 1 << 20;
+    cusp::array1d<float, MemorySpace> v(N, 0.1f);
+
+    ASSERT_EQUAL(cusp::blas::dot(system.compensated(), v, v), float(double(N) * double(0.1f) * double(0.1f)));
+    ASSERT_EQUAL(cusp::blas::nrm2(system.compensated(), v), 1024.0f * 0.1f);
+
+    // the forms writing into an array use the same reductions
+    cusp::array1d<float, MemorySpace> result(1);
+
+    cusp::blas::dot(system.compensated(), x, ones, result);
+    ASSERT_EQUAL(result[0], 2.0f);
+
+    cusp::blas::nrm2(system.compensated(), v, result);
+    ASSERT_EQUAL(result[0], 1024.0f * 0.1f);
+
+    cusp::array1d<float, MemorySpace> u(3, 1.0f);
+    ASSERT_THROWS(cusp::blas::dot(system.compensated(), x, u), cusp::invalid_input_exception);
+}
+DECLARE_HOST_DEVICE_UNITTEST(TestCompensatedReductions)
+
 
 template <class MemorySpace>
 void TestFill(void)
@@ -587,16 +889,47 @@ void TestScal(void)
 }
 DECLARE_HOST_DEVICE_UNITTEST(TestScal)
 
-template <class MemorySpace>
-void TestGemv(void)
+template <class MemorySpace, class Orientation>
+void TestGemvOrientation(void)
 {
-    typedef cusp::array2d<float, MemorySpace> Array2d;
+    typedef cusp::array2d<float, MemorySpace, Orientation> Array2d;
     typedef cusp::array1d<float, MemorySpace> Array1d;
 
-    Array2d A(6,6);
-    Array1d x(6);
+    cusp::array2d<float, cusp::host_memory, Orientation> A_h(3,4);
+    A_h(0,0) = 1.0f; A_h(0,1) =  2.0f; A_h(0,2) = 0.0f; A_h(0,3) = -1.0f;
+    A_h(1,0) = 3.0f; A_h(1,1) = -1.0f; A_h(1,2) = 2.0f; A_h(1,3) =  0.0f;
+    A_h(2,0) = 0.0f; A_h(2,1) =  4.0f; A_h(2,2) = 1.0f; A_h(2,3) =  2.0f;
+
+    cusp::array1d<float, cusp::host_memory> x_h(4);
+    x_h[0] = 1.0f; x_h[1] = 2.0f; x_h[2] = -1.0f; x_h[3] = 3.0f;
+
+    Array2d A(A_h);
+    Array1d x(x_h);
+    Array1d y(3, 1.0f);
+
+    // y <- A x
+    cusp::blas::gemv(A, x, y);
+
+    ASSERT_EQUAL(y[0],  2.0f);
+    ASSERT_EQUAL(y[1], -1.0f);
+    ASSERT_EQUAL(y[2], 13.0f);
 
-    ASSERT_THROWS(cusp::blas::gemv(A, x, x), cusp::not_implemented_exception);
+    // y <- 2 A x - y
+    cusp::blas::gemv(A, x, y, 2.0f, -1.0f);
+
+    ASSERT_EQUAL(y[0],  2.0f);
+    ASSERT_EQUAL(y[1], -1.0f);
+    ASSERT_EQUAL(y[2], 13.0f);
+
+    Array1d z(4);
+    ASSERT_THROWS(cusp::blas::gemv(A, x, z), cusp::invalid_input_exception);
+}
+
+template <class MemorySpace>
+void TestGemv(void)
+{
+    TestGemvOrientation<MemorySpace, cusp::row_major>();
+    TestGemvOrientation<MemorySpace, cusp::column_major>();
 }
 DECLARE_HOST_DEVICE_UNITTEST(TestGemv)
 
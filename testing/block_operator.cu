@@ -0,0 +1,295 @@
+#include <unittest/unittest.h>
+
+#include <cusp/block_operator.h>
+#include <cusp/precond/block.h>
+
+#include <cusp/array1d.h>
+#include <cusp/array2d.h>
+#include <cusp/blas/blas.h>
+#include <cusp/coo_matrix.h>
+#include <cusp/csr_matrix.h>
+#include <cusp/monitor.h>
+#include <cusp/multiply.h>
+
+#include <cusp/gallery/poisson.h>
+#include <cusp/krylov/gmres.h>
+#include <cusp/precond/diagonal.h>
+
+// rectangular coupling with two entries per row
+template <typename MemorySpace>
+cusp::coo_matrix<int, float, MemorySpace> Coupling(const int num_rows, const int num_cols)
+{
+    cusp::coo_matrix<int, float, cusp::host_memory> B(num_rows, num_cols, 2 * num_rows);
+
+    for(int i = 0; i < num_rows; i++)
+    {
+        B.row_indices[2 * i]        = i;
+        B.column_indices[2 * i]     = i % num_cols;
+        B.values[2 * i]             = 1.0f;
+
+        B.row_indices[2 * i + 1]    = i;
+        B.column_indices[2 * i + 1] = (i + 3) % num_cols;
+        B.values[2 * i + 1]         = 2.0f;
+    }
+
+    B.sort_by_row_and_column();
+
+    return cusp::coo_matrix<int, float, MemorySpace>(B);
+}
+
+// copies the block A into K at (row, col)
+template <typename MatrixType>
+void Place(cusp::array2d<float, cusp::host_memory>& K, const MatrixType& A, const size_t row, const size_t col)
+{
+    cusp::array2d<float, cusp::host_memory> D(A);
+
+    for(size_t i = 0; i < D.num_rows; i++)
+        for(size_t j = 0; j < D.num_cols; j++)
+            K(row + i, col + j) = D(i, j);
+}
+
+template <typename VectorType>
+cusp::array1d<float, cusp::host_memory> Segment(const VectorType& v, const size_t begin, const size_t end)
+{
+    cusp::array1d<float, cusp::host_memory> h_v(v);
+    return cusp::array1d<float, cusp::host_memory>(h_v.begin() + begin, h_v.begin() + end);
+}
+
+template <class MemorySpace>
+void TestBlockOperatorMultiply(void)
+{
+    typedef cusp::csr_matrix<int, float, MemorySpace> MatrixType;
+    typedef cusp::array1d<float, MemorySpace>         ArrayType;
+
+    MatrixType A, C;
+    cusp::gallery::poisson5pt(A, 4, 5);
+    cusp::gallery::poisson5pt(C, 3, 4);
+
+    cusp::coo_matrix<int, float, MemorySpace> B = Coupling<MemorySpace>(20, 12);
+    cusp::coo_matrix<int, float, MemorySpace> E = Coupling<MemorySpace>(12, 20);
+
+    // generic operator block, scales by 1/4 exactly
+    cusp::precond::diagonal<float, MemorySpace> D(C);
+
+    // [A   B   0]
+    // [E   C   D]
+    cusp::block_operator<float, MemorySpace> K(2, 3);
+    K.set_block(0, 0, A);
+    K.set_block(0, 1, B);
+    K.set_block(1, 0, E);
+    K.set_block(1, 1, C);
+    K.set_block(1, 2, D);
+
+    ASSERT_EQUAL(K.num_rows, 32);
+    ASSERT_EQUAL(K.num_cols, 44);
+    ASSERT_EQUAL(K.row_offset(1), 20);
+    ASSERT_EQUAL(K.col_offset(2), 32);
+    ASSERT_EQUAL(K.has_block(0, 2), false);
+
+    cusp::array2d<float, cusp::host_memory> h_K(32, 44, 0.0f);
+    Place(h_K, A, 0, 0);
+    Place(h_K, B, 0, 20);
+    Place(h_K, E, 20, 0);
+    Place(h_K, C, 20, 20);
+    for(size_t i = 0; i < 12; i++)
+        h_K(20 + i, 32 + i) = 0.25f;
+
+    cusp::array1d<float, cusp::host_memory> x(44);
+    for(size_t i = 0; i < x.size(); i++)
+        x[i] = float(i % 5);
+
+    cusp::array1d<float, cusp::host_memory> expected(32);
+    cusp::multiply(h_K, x, expected);
+
+    ArrayType d_x(x);
+    ArrayType d_y(32, 10.0f);
+    cusp::multiply(K, d_x, d_y);
+
+    ASSERT_EQUAL(d_y, expected);
+
+    // repeated products reuse the streams and workspace
+    cusp::multiply(K, d_x, d_y);
+    ASSERT_EQUAL(d_y, expected);
+
+    // nested block operators
+    cusp::coo_matrix<int, float, MemorySpace> F = Coupling<MemorySpace>(32, 20);
+
+    cusp::block_operator<float, MemorySpace> N(1, 2);
+    N.set_block(0, 0, K);
+    N.set_block(0, 1, F);
+
+    cusp::array1d<float, cusp::host_memory> z(64);
+    for(size_t i = 0; i < z.size(); i++)
+        z[i] = float(i % 3);
+
+    cusp::array1d<float, cusp::host_memory> Fz(32), nested(32);
+    cusp::multiply(h_K, Segment(z, 0, 44), nested);
+    cusp::multiply(cusp::coo_matrix<int, float, cusp::host_memory>(F), Segment(z, 44, 64), Fz);
+    cusp::blas::axpy(Fz, nested, 1.0f);
+
+    ArrayType d_z(z);
+    ArrayType d_w(32);
+    cusp::multiply(N, d_z, d_w);
+
+    ASSERT_EQUAL(d_w, nested);
+}
+DECLARE_HOST_DEVICE_UNITTEST(TestBlockOperatorMultiply);
+
+template <class MemorySpace>
+void TestBlockPreconditioners(void)
+{
+    typedef cusp::csr_matrix<int, float, MemorySpace> MatrixType;
+    typedef cusp::array1d<float, MemorySpace>         ArrayType;
+
+    MatrixType A, C;
+    cusp::gallery::poisson5pt(A, 4, 5);
+    cusp::gallery::poisson5pt(C, 3, 4);
+
+    cusp::coo_matrix<int, float, MemorySpace> B = Coupling<MemorySpace>(20, 12);
+    cusp::coo_matrix<int, float, MemorySpace> E = Coupling<MemorySpace>(12, 20);
+
+    cusp::precond::diagonal<float, MemorySpace> DA(A), DC(C);
+
+    cusp::array1d<float, cusp::host_memory> x(32);
+    for(size_t i = 0; i < x.size(); i++)
+        x[i] = float(i % 7);
+
+    ArrayType d_x(x);
+
+    cusp::array1d<float, cusp::host_memory> x0 = Segment(x, 0, 20);
+    cusp::array1d<float, cusp::host_memory> x1 = Segment(x, 20, 32);
+
+    // block diagonal, y = x / 4
+    {
+        cusp::precond::block_diagonal<float, MemorySpace> M(2);
+        M.set_block(0, DA);
+        M.set_block(1, DC);
+
+        ASSERT_EQUAL(M.num_rows, 32);
+
+        cusp::array1d<float, cusp::host_memory> expected(x);
+        for(size_t i = 0; i < expected.size(); i++)
+            expected[i] *= 0.25f;
+
+        ArrayType d_y(32, 10.0f);
+        cusp::multiply(M, d_x, d_y);
+
+        ASSERT_EQUAL(d_y, expected);
+    }
+
+    // block lower triangular, y0 = x0 / 4, y1 = (x1 - E y0) / 4
+    {
+        cusp::precond::block_triangular<float, MemorySpace> M(2);
+        M.set_diagonal(0, DA);
+        M.set_diagonal(1, DC);
+        M.set_block(1, 0, E);
+
+        cusp::array1d<float, cusp::host_memory> y0(x0), Ey0(12);
+        cusp::blas::scal(y0, 0.25f);
+        cusp::multiply(cusp::coo_matrix<int, float, cusp::host_memory>(E), y0, Ey0);
+
+        cusp::array1d<float, cusp::host_memory> expected(32);
+        for(size_t i = 0; i < 20; i++)
+            expected[i] = y0[i];
+        for(size_t i = 0; i < 12; i++)
+            expected[20 + i] = 0.25f * (x1[i] - Ey0[i]);
+
+        ArrayType d_y(32, 10.0f);
+        cusp::multiply(M, d_x, d_y);
+
+        ASSERT_EQUAL(d_y, expected);
+    }
+
+    // block upper triangular, y1 = x1 / 4, y0 = (x0 - B y1) / 4
+    {
+        cusp::precond::block_triangular<float, MemorySpace> M(2, false);
+        M.set_diagonal(0, DA);
+        M.set_diagonal(1, DC);
+        M.set_block(0, 1, B);
+
+        ASSERT_EQUAL(M.is_lower(), false);
+
+        cusp::array1d<float, cusp::host_memory> y1(x1), By1(20);
+        cusp::blas::scal(y1, 0.25f);
+        cusp::multiply(cusp::coo_matrix<int, float, cusp::host_memory>(B), y1, By1);
+
+        cusp::array1d<float, cusp::host_memory> expected(32);
+        for(size_t i = 0; i < 20; i++)
+            expected[i] = 0.25f * (x0[i] - By1[i]);
+        for(size_t i = 0; i < 12; i++)
+            expected[20 + i] = y1[i];
+
+        ArrayType d_y(32, 10.0f);
+        cusp::multiply(M, d_x, d_y);
+
+        ASSERT_EQUAL(d_y, expected);
+    }
+}
+DECLARE_HOST_DEVICE_UNITTEST(TestBlockPreconditioners);
+
+template <class MemorySpace>
+void TestBlockOperatorKrylov(void)
+{
+    typedef cusp::csr_matrix<int, float, MemorySpace> MatrixType;
+    typedef cusp::array1d<float, MemorySpace>         ArrayType;
+
+    MatrixType A, C;
+    cusp::gallery::poisson5pt(A, 10, 10);
+    cusp::gallery::poisson5pt(C, 6, 6);
+
+    cusp::coo_matrix<int, float, MemorySpace> E = Coupling<MemorySpace>(36, 100);
+
+    // [A  0]
+    // [E  C]
+    cusp::block_operator<float, MemorySpace> K(2, 2);
+    K.set_block(0, 0, A);
+    K.set_block(1, 0, E);
+    K.set_block(1, 1, C);
+
+    cusp::precond::diagonal<float, MemorySpace> DA(A), DC(C);
+
+    cusp::precond::block_triangular<float, MemorySpace> M(2);
+    M.set_diagonal(0, DA);
+    M.set_diagonal(1, DC);
+    M.set_block(1, 0, E);
+
+    ArrayType x(K.num_rows, 0.0f);
+    ArrayType b(K.num_rows, 1.0f);
+
+    cusp::monitor<float> monitor(b, 300, 1e-5);
+    cusp::krylov::gmres(K, x, b, 50, monitor, M);
+
+    ASSERT_EQUAL(monitor.converged(), true);
+}
+DECLARE_HOST_DEVICE_UNITTEST(TestBlockOperatorKrylov);
+
+template <class MemorySpace>
+void TestBlockOperatorInvalidInput(void)
+{
+    cusp::csr_matrix<int, float, MemorySpace> A;
+    cusp::gallery::poisson5pt(A, 4, 4);
+
+    cusp::coo_matrix<int, float, MemorySpace> B = Coupling<MemorySpace>(16, 9);
+
+    typedef cusp::block_operator<float, MemorySpace> BlockOperator;
+
+    ASSERT_THROWS(BlockOperator(0, 2), cusp::invalid_input_exception);
+
+    BlockOperator K(2, 2);
+    K.set_block(0, 0, A);
+
+    ASSERT_THROWS(K.set_block(2, 0, A), cusp::invalid_input_exception);
+    ASSERT_THROWS(K.set_block(0, 1, cusp::coo_matrix<int, float, MemorySpace>(9, 9, 0)), cusp::invalid_input_exception);
+
+    cusp::array1d<float, MemorySpace> x(17), y(16);
+    ASSERT_THROWS(cusp::multiply(K, x, y), cusp::invalid_input_exception);
+
+    cusp::precond::block_diagonal<float, MemorySpace> D(2);
+    ASSERT_THROWS(D.set_block(0, B), cusp::invalid_input_exception);
+    D.set_block(0, A);
+    ASSERT_THROWS(cusp::multiply(D, x, y), cusp::invalid_input_exception);
+
+    cusp::precond::block_triangular<float, MemorySpace> L(2);
+    ASSERT_THROWS(L.set_block(0, 1, B), cusp::invalid_input_exception);
+}
+DECLARE_HOST_DEVICE_UNITTEST(TestBlockOperatorInvalidInput);
@@ -160,6 +160,50 @@ void TestBreadthFirstSearch(void)
 }
 DECLARE_SPARSE_MATRIX_UNITTEST(TestBreadthFirstSearch)
 
+template <class MemorySpace>
+void TestBreadthFirstSearchLowDiameter(void)
+{
+    typedef int   IndexType;
+    typedef float ValueType;
+
+    // a ring of N vertices whose vertex 0 is also connected to every other
+    // vertex, the large second frontier exercises the bottom-up steps
+    const IndexType N = 1000;
+
+    cusp::coo_matrix<IndexType,ValueType,cusp::host_memory> A(N, N, 4 * (N - 1));
+
+    IndexType n = 0;
+    for(IndexType i = 1; i < N; i++)
+    {
+        const IndexType j = i + 1 < N ? i + 1 : 1;
+        A.row_indices[n] = 0; A.column_indices[n] = i; n++;
+        A.row_indices[n] = i; A.column_indices[n] = 0; n++;
+        A.row_indices[n] = i; A.column_indices[n] = j; n++;
+        A.row_indices[n] = j; A.column_indices[n] = i; n++;
+    }
+    thrust::fill(A.values.begin(), A.values.end(), ValueType(1));
+    A.sort_by_row_and_column();
+
+    cusp::csr_matrix<IndexType,ValueType,MemorySpace> G(A);
+
+    IndexType src = 500;
+
+    cusp::array1d<IndexType,MemorySpace> levels(N);
+    cusp::array1d<IndexType,MemorySpace> tree(N);
+    cusp::graph::breadth_first_search(G, src, levels, true);
+    cusp::graph::breadth_first_search(G, src, tree, false);
+
+    cusp::array1d<IndexType,cusp::host_memory> expected(N, 2);
+    expected[src] = 0;
+    expected[0] = 1;
+    expected[src - 1] = 1;
+    expected[src + 1] = 1;
+
+    ASSERT_EQUAL(levels, expected);
+    ASSERT_EQUAL(is_valid_level_set(G, tree, expected), true);
+}
+DECLARE_HOST_DEVICE_UNITTEST(TestBreadthFirstSearchLowDiameter);
+
 template <typename MatrixType, typename ArrayType>
 void breadth_first_search(my_system& system,
                           const MatrixType& G,
@@ -0,0 +1,109 @@
+#include <unittest/unittest.h>
+
+#include <cusp/bsr_matrix.h>
+#include <cusp/csr_matrix.h>
+#include <cusp/multiply.h>
+
+#include <cusp/gallery/poisson.h>
+
+template <class Space>
+void TestBsrMatrixBasicConstructor(void)
+{
+    cusp::bsr_matrix<int, float, Space, 3, 2> matrix(6, 4, 3);
+
+    ASSERT_EQUAL(matrix.num_rows,              6);
+    ASSERT_EQUAL(matrix.num_cols,              4);
+    ASSERT_EQUAL(matrix.num_entries,           18);
+    ASSERT_EQUAL(matrix.num_blocks(),          3);
+    ASSERT_EQUAL(matrix.num_block_rows(),      2);
+    ASSERT_EQUAL(matrix.num_block_cols(),      2);
+    ASSERT_EQUAL(matrix.row_offsets.size(),    3);
+    ASSERT_EQUAL(matrix.column_indices.size(), 3);
+    ASSERT_EQUAL(matrix.values.size(),         18);
+}
+DECLARE_HOST_DEVICE_UNITTEST(TestBsrMatrixBasicConstructor);
+
+template <class Space>
+void TestBsrMatrixConversion(void)
+{
+    // [10 20  0  0]
+    // [ 0 30  0  0]
+    // [ 0  0  0 40]
+    // [50  0 60  0]
+    cusp::csr_matrix<int, float, cusp::host_memory> A(4, 4, 6);
+    A.row_offsets[0] = 0;
+    A.row_offsets[1] = 2;
+    A.row_offsets[2] = 3;
+    A.row_offsets[3] = 4;
+    A.row_offsets[4] = 6;
+    A.column_indices[0] = 0; A.values[0] = 10;
+    A.column_indices[1] = 1; A.values[1] = 20;
+    A.column_indices[2] = 1; A.values[2] = 30;
+    A.column_indices[3] = 3; A.values[3] = 40;
+    A.column_indices[4] = 0; A.values[4] = 50;
+    A.column_indices[5] = 2; A.values[5] = 60;
+
+    cusp::bsr_matrix<int, float, Space, 2, 2> B(A);
+
+    ASSERT_EQUAL(B.num_rows,     4);
+    ASSERT_EQUAL(B.num_cols,     4);
+    ASSERT_EQUAL(B.num_blocks(), 3);
+    ASSERT_EQUAL(B.row_offsets[0], 0);
+    ASSERT_EQUAL(B.row_offsets[1], 1);
+    ASSERT_EQUAL(B.row_offsets[2], 3);
+    ASSERT_EQUAL(B.column_indices[0], 0);
+    ASSERT_EQUAL(B.column_indices[1], 0);
+    ASSERT_EQUAL(B.column_indices[2], 1);
+
+    ASSERT_EQUAL(B.values[ 0], 10); ASSERT_EQUAL(B.values[ 1], 20);
+    ASSERT_EQUAL(B.values[ 2],  0); ASSERT_EQUAL(B.values[ 3], 30);
+    ASSERT_EQUAL(B.values[ 4],  0); ASSERT_EQUAL(B.values[ 5],  0);
+    ASSERT_EQUAL(B.values[ 6], 50); ASSERT_EQUAL(B.values[ 7],  0);
+    ASSERT_EQUAL(B.values[ 8],  0); ASSERT_EQUAL(B.values[ 9], 40);
+    ASSERT_EQUAL(B.values[10], 60); ASSERT_EQUAL(B.values[11],  0);
+
+    // convert back to CSR
+    cusp::csr_matrix<int, float, Space> C(B);
+
+    ASSERT_EQUAL(C.row_offsets,    A.row_offsets);
+    ASSERT_EQUAL(C.column_indices, A.column_indices);
+    ASSERT_EQUAL(C.values,         A.values);
+
+    // dimensions must be multiples of the block size
+    cusp::csr_matrix<int, float, Space> D(3, 4, 0);
+    cusp::bsr_matrix<int, float, Space, 2, 2> E;
+    ASSERT_THROWS(cusp::convert(D, E), cusp::format_conversion_exception);
+}
+DECLARE_HOST_DEVICE_UNITTEST(TestBsrMatrixConversion);
+
+template <typename MemorySpace, size_t BlockRows, size_t BlockCols>
+void _TestBsrMatrixVectorMultiply(const cusp::csr_matrix<int, float, MemorySpace>& A)
+{
+    cusp::bsr_matrix<int, float, MemorySpace, BlockRows, BlockCols> B(A);
+
+    cusp::array1d<float, MemorySpace> x(A.num_cols);
+    for(size_t i = 0; i < A.num_cols; i++)
+        x[i] = i % 5;
+
+    cusp::array1d<float, MemorySpace> y(A.num_rows, 10);
+    cusp::array1d<float, MemorySpace> z(A.num_rows, 10);
+
+    cusp::multiply(A, x, y);
+    cusp::multiply(B, x, z);
+
+    ASSERT_EQUAL(z, y);
+}
+
+template <class MemorySpace>
+void TestBsrMatrixVectorMultiply(void)
+{
+    cusp::csr_matrix<int, float, MemorySpace> A;
+
+    // 3 and 5 components per grid point
+    cusp::gallery::poisson5pt(A, 15, 4);
+    _TestBsrMatrixVectorMultiply<MemorySpace,3,3>(A);
+    _TestBsrMatrixVectorMultiply<MemorySpace,5,5>(A);
+    _TestBsrMatrixVectorMultiply<MemorySpace,3,5>(A);
+    _TestBsrMatrixVectorMultiply<MemorySpace,1,1>(A);
+}
+DECLARE_HOST_DEVICE_UNITTEST(TestBsrMatrixVectorMultiply);
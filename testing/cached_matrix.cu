@@ -0,0 +1,148 @@
+#include <unittest/unittest.h>
+
+#include <cusp/array1d.h>
+#include <cusp/cached_matrix.h>
+#include <cusp/csr_matrix.h>
+#include <cusp/multiply.h>
+#include <cusp/transpose.h>
+
+#include <cusp/gallery/poisson.h>
+#include <cusp/gallery/random.h>
+
+template <class MemorySpace>
+void TestCachedMatrixMultiply(void)
+{
+    cusp::csr_matrix<int, float, MemorySpace> A;
+    cusp::gallery::poisson5pt(A, 10, 8);
+
+    cusp::array1d<float, MemorySpace> x(A.num_cols);
+    for(size_t i = 0; i < A.num_cols; i++)
+        x[i] = i % 7;
+
+    cusp::array1d<float, MemorySpace> y(A.num_rows, 0);
+    cusp::array1d<float, MemorySpace> z(A.num_rows, 0);
+
+    cusp::multiply(A, x, y);
+
+    const cusp::matrix_storage formats[] = { cusp::ell_storage, cusp::hyb_storage };
+
+    for(int i = 0; i < 2; i++)
+    {
+        cusp::cached_matrix<int, float, MemorySpace> B(A);
+
+        ASSERT_EQUAL(B.num_rows,    A.num_rows);
+        ASSERT_EQUAL(B.num_cols,    A.num_cols);
+        ASSERT_EQUAL(B.num_entries, A.num_entries);
+
+        B.storage = formats[i];
+
+        // the first product runs on CSR
+        cusp::multiply(B, x, z);
+        ASSERT_EQUAL(B.is_cached(), false);
+        ASSERT_EQUAL(z, y);
+
+        // the second one builds the cached format
+        thrust::fill(z.begin(), z.end(), 0.0f);
+        cusp::multiply(B, x, z);
+        ASSERT_EQUAL(B.is_cached(), true);
+        ASSERT_EQUAL(z, y);
+
+        thrust::fill(z.begin(), z.end(), 0.0f);
+        cusp::multiply(B, x, z);
+        ASSERT_EQUAL(z, y);
+    }
+}
+DECLARE_HOST_DEVICE_UNITTEST(TestCachedMatrixMultiply);
+
+template <class MemorySpace>
+void TestCachedMatrixMultiplyTranspose(void)
+{
+    cusp::csr_matrix<int, float, MemorySpace> A;
+    cusp::gallery::random(A, 50, 30, 200);
+
+    cusp::csr_matrix<int, float, MemorySpace> At;
+    cusp::transpose(A, At);
+
+    cusp::array1d<float, MemorySpace> x(A.num_rows);
+    for(size_t i = 0; i < A.num_rows; i++)
+        x[i] = i % 5;
+
+    cusp::array1d<float, MemorySpace> y(A.num_cols, 0);
+    cusp::array1d<float, MemorySpace> z(A.num_cols, 0);
+
+    cusp::multiply(At, x, y);
+
+    cusp::cached_matrix<int, float, MemorySpace> B(A);
+    B.reuse_threshold = 3;
+
+    for(int i = 0; i < 4; i++)
+    {
+        thrust::fill(z.begin(), z.end(), 0.0f);
+        cusp::multiply_transpose(B, x, z);
+
+        ASSERT_EQUAL(B.is_transpose_cached(), i >= 2);
+        ASSERT_ALMOST_EQUAL(z, y);
+    }
+}
+DECLARE_HOST_DEVICE_UNITTEST(TestCachedMatrixMultiplyTranspose);
+
+template <class MemorySpace>
+void TestCachedMatrixUpdateValues(void)
+{
+    cusp::csr_matrix<int, float, MemorySpace> A;
+    cusp::gallery::poisson5pt(A, 6, 6);
+
+    cusp::cached_matrix<int, float, MemorySpace> B(A);
+    B.storage = cusp::ell_storage;
+
+    cusp::array1d<float, MemorySpace> x(A.num_cols, 1);
+    cusp::array1d<float, MemorySpace> y(A.num_rows, 0);
+    cusp::array1d<float, MemorySpace> z(A.num_rows, 0);
+
+    cusp::multiply(B, x, z);
+    cusp::multiply(B, x, z);
+    cusp::multiply_transpose(B, x, z);
+    cusp::multiply_transpose(B, x, z);
+
+    ASSERT_EQUAL(B.is_cached(), true);
+    ASSERT_EQUAL(B.is_transpose_cached(), true);
+
+    // doubling the values drops both caches
+    for(size_t i = 0; i < A.num_entries; i++)
+        A.values[i] *= 2;
+
+    B.update_values(A.values);
+
+    ASSERT_EQUAL(B.is_cached(), false);
+    ASSERT_EQUAL(B.is_transpose_cached(), false);
+
+    cusp::multiply(A, x, y);
+    cusp::multiply(B, x, z);
+
+    ASSERT_EQUAL(B.is_cached(), true);
+    ASSERT_EQUAL(z, y);
+
+    cusp::multiply_transpose(B, x, z);
+
+    ASSERT_EQUAL(B.is_transpose_cached(), true);
+    ASSERT_EQUAL(z, y);
+
+    cusp::array1d<float, MemorySpace> values(A.num_entries + 1);
+    ASSERT_THROWS(B.update_values(values), cusp::invalid_input_exception);
+
+    // direct writes require invalidate
+    B.csr.values[0] = 100;
+    B.invalidate();
+    B.storage = cusp::ell_storage;
+
+    ASSERT_EQUAL(B.is_cached(), false);
+
+    A.values[0] = 100;
+    cusp::multiply(A, x, y);
+    cusp::multiply(B, x, z);
+    cusp::multiply(B, x, z);
+
+    ASSERT_EQUAL(B.is_cached(), true);
+    ASSERT_EQUAL(z, y);
+}
+DECLARE_HOST_DEVICE_UNITTEST(TestCachedMatrixUpdateValues);
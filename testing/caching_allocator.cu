@@ -0,0 +1,95 @@
+#include <unittest/unittest.h>
+
+#include <cusp/caching_allocator.h>
+#include <cusp/csr_matrix.h>
+#include <cusp/multiply.h>
+
+#include <cusp/gallery/poisson.h>
+
+template <typename MemorySpace>
+void TestCachingAllocator(void)
+{
+    typedef typename cusp::caching_allocator<MemorySpace>::statistics_type Statistics;
+
+    cusp::caching_allocator<MemorySpace> alloc;
+
+    char* ptr1 = alloc.allocate(1000);
+
+    {
+        const Statistics& stats = alloc.statistics();
+        ASSERT_EQUAL(stats.cache_misses, 1);
+        ASSERT_EQUAL(stats.bytes_in_use, 1024);
+        ASSERT_EQUAL(stats.bytes_cached, 0);
+    }
+
+    alloc.deallocate(ptr1, 1000);
+
+    // a request from the same bin reuses the block
+    char* ptr2 = alloc.allocate(600);
+
+    ASSERT_EQUAL(ptr2 == ptr1, true);
+
+    {
+        const Statistics& stats = alloc.statistics();
+        ASSERT_EQUAL(stats.cache_hits,   1);
+        ASSERT_EQUAL(stats.cache_misses, 1);
+        ASSERT_EQUAL(stats.bytes_in_use, 1024);
+    }
+
+    // a larger request does not
+    char* ptr3 = alloc.allocate(5000);
+
+    alloc.deallocate(ptr2, 0);
+    alloc.deallocate(ptr3, 0);
+
+    {
+        const Statistics& stats = alloc.statistics();
+        ASSERT_EQUAL(stats.cache_misses, 2);
+        ASSERT_EQUAL(stats.bytes_in_use, 0);
+        ASSERT_EQUAL(stats.bytes_cached, 1024 + 8192);
+        ASSERT_EQUAL(stats.peak_bytes,   1024 + 8192);
+    }
+
+    alloc.release();
+
+    {
+        const Statistics& stats = alloc.statistics();
+        ASSERT_EQUAL(stats.bytes_cached, 0);
+        ASSERT_EQUAL(stats.system_deallocations, 2);
+    }
+
+    ASSERT_THROWS(alloc.deallocate(ptr1, 0), cusp::invalid_input_exception);
+}
+DECLARE_HOST_DEVICE_UNITTEST(TestCachingAllocator);
+
+void TestCachingAllocatorTemporaries(void)
+{
+    cusp::csr_matrix<int, float, cusp::host_memory> A;
+    cusp::gallery::poisson5pt(A, 10, 10);
+
+    cusp::csr_matrix<int, float, cusp::host_memory> C1;
+    cusp::csr_matrix<int, float, cusp::host_memory> C2;
+
+    cusp::caching_allocator<cusp::host_memory> alloc;
+
+    cusp::multiply(A, A, C1);
+    cusp::multiply(cusp::cpp::par(alloc), A, A, C2);
+
+    ASSERT_EQUAL(C2.num_entries, C1.num_entries);
+    ASSERT_EQUAL(C2.row_offsets,    C1.row_offsets);
+    ASSERT_EQUAL(C2.column_indices, C1.column_indices);
+    ASSERT_EQUAL(C2.values,         C1.values);
+
+    // the temporaries of spgemm went through the allocator
+    size_t misses = alloc.statistics().cache_misses;
+
+    ASSERT_EQUAL(misses > 0, true);
+    ASSERT_EQUAL(alloc.statistics().bytes_in_use, 0);
+
+    // and are reused by a second product
+    cusp::multiply(cusp::cpp::par(alloc), A, A, C2);
+
+    ASSERT_EQUAL(alloc.statistics().cache_misses, misses);
+    ASSERT_EQUAL(alloc.statistics().cache_hits > 0, true);
+}
+DECLARE_UNITTEST(TestCachingAllocatorTemporaries);
@@ -1,12 +1,22 @@
 #include <unittest/unittest.h>
 
+#include <cusp/array2d.h>
+#include <cusp/coo_matrix.h>
 #include <cusp/csr_matrix.h>
 #include <cusp/linear_operator.h>
 #include <cusp/monitor.h>
 #include <cusp/multiply.h>
 
 #include <cusp/gallery/poisson.h>
+#include <cusp/krylov/batched_cg.h>
+#include <cusp/krylov/block_cg.h>
 #include <cusp/krylov/cg.h>
+#include <cusp/krylov/cg_fused.h>
+#include <cusp/krylov/cg_graph.h>
+#include <cusp/krylov/pipelined_cg.h>
+#include <cusp/krylov/recycled_cg.h>
+#include <cusp/krylov/s_step_cg.h>
+#include <cusp/precond/diagonal.h>
 
 template <class LinearOperator,
           class VectorType1,
@@ -98,3 +108,377 @@ void TestConjugateGradientZeroResidual(void)
 }
 DECLARE_HOST_DEVICE_UNITTEST(TestConjugateGradientZeroResidual)
 
+
+template <class MemorySpace>
+void TestConjugateGradientFused(void)
+{
+    cusp::csr_matrix<int, float, MemorySpace> A;
+
+    cusp::gallery::poisson5pt(A, 10, 10);
+
+    cusp::array1d<float, MemorySpace> x(A.num_rows, 0.0f);
+    cusp::array1d<float, MemorySpace> y(A.num_rows, 0.0f);
+    cusp::array1d<float, MemorySpace> b(A.num_rows, 1.0f);
+
+    // without preconditioner the iterates match cg
+    cusp::monitor<float> monitor1(b, 20, 1e-4);
+    cusp::monitor<float> monitor2(b, 20, 1e-4);
+
+    cusp::krylov::cg(A, x, b, monitor1);
+    cusp::krylov::cg_fused(A, y, b, monitor2);
+
+    ASSERT_EQUAL(monitor2.iteration_count(), monitor1.iteration_count());
+    ASSERT_ALMOST_EQUAL(y, x);
+
+    // check residual norm
+    cusp::array1d<float, MemorySpace> residual(A.num_rows, 0.0f);
+    cusp::multiply(A, y, residual);
+    cusp::blas::axpby(residual, b, residual, -1.0f, 1.0f);
+
+    ASSERT_EQUAL(cusp::blas::nrm2(residual) < 1e-4 * cusp::blas::nrm2(b), true);
+
+    // with a diagonal preconditioner
+    cusp::precond::diagonal<float, MemorySpace> M(A);
+    cusp::monitor<float> monitor3(b, 20, 1e-4);
+
+    cusp::blas::fill(y, 0.0f);
+    cusp::krylov::cg_fused(A, y, b, monitor3, M);
+
+    cusp::multiply(A, y, residual);
+    cusp::blas::axpby(residual, b, residual, -1.0f, 1.0f);
+
+    ASSERT_EQUAL(cusp::blas::nrm2(residual) < 1e-4 * cusp::blas::nrm2(b), true);
+}
+DECLARE_HOST_DEVICE_UNITTEST(TestConjugateGradientFused)
+
+template <class MemorySpace>
+void TestConjugateGradientGraph(void)
+{
+    cusp::csr_matrix<int, float, MemorySpace> A;
+
+    cusp::gallery::poisson5pt(A, 10, 10);
+
+    cusp::array1d<float, MemorySpace> x(A.num_rows, 0.0f);
+    cusp::array1d<float, MemorySpace> y(A.num_rows, 0.0f);
+    cusp::array1d<float, MemorySpace> b(A.num_rows, 1.0f);
+
+    // replaying the iteration follows the recurrences of cg
+    cusp::monitor<float> monitor1(b, 20, 1e-4);
+    cusp::monitor<float> monitor2(b, 20, 1e-4);
+
+    cusp::krylov::cg(A, x, b, monitor1);
+    cusp::krylov::cg_graph(A, y, b, monitor2);
+
+    ASSERT_EQUAL(monitor2.iteration_count(), monitor1.iteration_count());
+    ASSERT_ALMOST_EQUAL(y, x);
+
+    // check residual norm
+    cusp::array1d<float, MemorySpace> residual(A.num_rows, 0.0f);
+    cusp::multiply(A, y, residual);
+    cusp::blas::axpby(residual, b, residual, -1.0f, 1.0f);
+
+    ASSERT_EQUAL(cusp::blas::nrm2(residual) < 1e-4 * cusp::blas::nrm2(b), true);
+
+    // with a diagonal preconditioner, testing the residual every 4 replays
+    cusp::precond::diagonal<float, MemorySpace> M(A);
+    cusp::monitor<float> monitor3(b, 40, 1e-4, 0, false, 4);
+
+    cusp::blas::fill(y, 0.0f);
+    cusp::krylov::cg_graph(A, y, b, monitor3, M);
+
+    ASSERT_EQUAL(monitor3.converged(), true);
+    ASSERT_EQUAL(monitor3.iteration_count() % 4, size_t(0));
+
+    cusp::multiply(A, y, residual);
+    cusp::blas::axpby(residual, b, residual, -1.0f, 1.0f);
+
+    ASSERT_EQUAL(cusp::blas::nrm2(residual) < 1e-4 * cusp::blas::nrm2(b), true);
+}
+DECLARE_HOST_DEVICE_UNITTEST(TestConjugateGradientGraph)
+
+
+template <class MemorySpace>
+void TestPipelinedConjugateGradient(void)
+{
+    cusp::csr_matrix<int, float, MemorySpace> A;
+
+    cusp::gallery::poisson5pt(A, 10, 10);
+
+    cusp::array1d<float, MemorySpace> x(A.num_rows, 0.0f);
+    cusp::array1d<float, MemorySpace> b(A.num_rows, 1.0f);
+
+    cusp::monitor<float> monitor1(b, 50, 1e-4);
+
+    cusp::krylov::pipelined_cg(A, x, b, monitor1);
+
+    ASSERT_EQUAL(monitor1.converged(), true);
+
+    // the recurrences drift from the true residual, allow some slack
+    cusp::array1d<float, MemorySpace> residual(A.num_rows, 0.0f);
+    cusp::multiply(A, x, residual);
+    cusp::blas::axpby(residual, b, residual, -1.0f, 1.0f);
+
+    ASSERT_EQUAL(cusp::blas::nrm2(residual) < 1e-3 * cusp::blas::nrm2(b), true);
+
+    // with a diagonal preconditioner
+    cusp::precond::diagonal<float, MemorySpace> M(A);
+    cusp::monitor<float> monitor2(b, 50, 1e-4);
+
+    cusp::blas::fill(x, 0.0f);
+    cusp::krylov::pipelined_cg(A, x, b, monitor2, M);
+
+    ASSERT_EQUAL(monitor2.converged(), true);
+
+    cusp::multiply(A, x, residual);
+    cusp::blas::axpby(residual, b, residual, -1.0f, 1.0f);
+
+    ASSERT_EQUAL(cusp::blas::nrm2(residual) < 1e-3 * cusp::blas::nrm2(b), true);
+}
+DECLARE_HOST_DEVICE_UNITTEST(TestPipelinedConjugateGradient)
+
+template <class MemorySpace>
+void TestSStepConjugateGradient(void)
+{
+    cusp::csr_matrix<int, double, MemorySpace> A;
+
+    cusp::gallery::poisson5pt(A, 10, 10);
+
+    cusp::array1d<double, MemorySpace> x(A.num_rows, 0.0);
+    cusp::array1d<double, MemorySpace> b(A.num_rows, 1.0);
+
+    cusp::monitor<double> monitor1(b, 60, 1e-8);
+
+    cusp::krylov::s_step_cg(A, x, b, monitor1, 3);
+
+    ASSERT_EQUAL(monitor1.converged(), true);
+    ASSERT_EQUAL(monitor1.iteration_count() % 3, size_t(0));
+
+    cusp::array1d<double, MemorySpace> residual(A.num_rows, 0.0);
+    cusp::multiply(A, x, residual);
+    cusp::blas::axpby(residual, b, residual, -1.0, 1.0);
+
+    ASSERT_EQUAL(cusp::blas::nrm2(residual) < 1e-6 * cusp::blas::nrm2(b), true);
+
+    // a Newton basis with shifts spread over the spectrum [0,8]
+    cusp::array1d<double, cusp::host_memory> shifts(6);
+    shifts[0] = 7.9; shifts[1] = 0.1; shifts[2] = 4.0;
+    shifts[3] = 6.0; shifts[4] = 2.0; shifts[5] = 7.0;
+
+    cusp::monitor<double> monitor2(b, 60, 1e-8);
+
+    cusp::blas::fill(x, 0.0);
+    cusp::krylov::s_step_cg(A, x, b, monitor2, shifts);
+
+    ASSERT_EQUAL(monitor2.converged(), true);
+
+    cusp::multiply(A, x, residual);
+    cusp::blas::axpby(residual, b, residual, -1.0, 1.0);
+
+    ASSERT_EQUAL(cusp::blas::nrm2(residual) < 1e-6 * cusp::blas::nrm2(b), true);
+}
+DECLARE_HOST_DEVICE_UNITTEST(TestSStepConjugateGradient)
+
+template <class MemorySpace>
+void TestConjugateGradientSolver(void)
+{
+    cusp::csr_matrix<int, float, MemorySpace> A;
+
+    cusp::gallery::poisson5pt(A, 10, 10);
+
+    cusp::array1d<float, MemorySpace> x(A.num_rows, 0.0f);
+    cusp::array1d<float, MemorySpace> y(A.num_rows, 0.0f);
+    cusp::array1d<float, MemorySpace> b(A.num_rows, 1.0f);
+
+    cusp::monitor<float> monitor1(b, 20, 1e-4);
+    cusp::krylov::cg(A, x, b, monitor1);
+
+    // the workspace is reused across solves
+    cusp::krylov::cg_solver<float, MemorySpace> solver(A.num_rows);
+
+    for (int i = 0; i < 2; i++)
+    {
+        cusp::monitor<float> monitor2(b, 20, 1e-4);
+
+        cusp::blas::fill(y, 0.0f);
+        solver.solve(A, y, b, monitor2);
+
+        ASSERT_EQUAL(monitor2.iteration_count(), monitor1.iteration_count());
+        ASSERT_ALMOST_EQUAL(y, x);
+    }
+}
+DECLARE_HOST_DEVICE_UNITTEST(TestConjugateGradientSolver)
+
+template <class MemorySpace>
+void TestBatchedConjugateGradient(void)
+{
+    const size_t num_systems = 3;
+
+    cusp::coo_matrix<int, float, cusp::host_memory> P;
+    cusp::gallery::poisson5pt(P, 5, 5);
+
+    const size_t N = P.num_rows;
+
+    // block diagonal matrix of scaled copies of P, the last system has b = 0
+    cusp::coo_matrix<int, float, cusp::host_memory> B(num_systems * N, num_systems * N, num_systems * P.num_entries);
+    cusp::array1d<float, cusp::host_memory> b_host(num_systems * N);
+
+    for (size_t i = 0; i < num_systems; i++)
+    {
+        for (size_t n = 0; n < P.num_entries; n++)
+        {
+            B.row_indices[i * P.num_entries + n]    = i * N + P.row_indices[n];
+            B.column_indices[i * P.num_entries + n] = i * N + P.column_indices[n];
+            B.values[i * P.num_entries + n]         = (i + 1) * P.values[n];
+        }
+
+        for (size_t n = 0; n < N; n++)
+            b_host[i * N + n] = (i + 1 < num_systems) ? float((n % 3) + i) : 0.0f;
+    }
+
+    cusp::csr_matrix<int, float, MemorySpace> A(B);
+    cusp::array1d<float, MemorySpace> x(A.num_rows, 0.0f);
+    cusp::array1d<float, MemorySpace> b(b_host);
+
+    cusp::monitor<float> monitor(b, 100, 1e-5);
+
+    cusp::krylov::batched_cg(A, x, b, N, monitor);
+
+    ASSERT_EQUAL(monitor.iteration_count() < 100, true);
+
+    // check the residual of every system
+    cusp::array1d<float, MemorySpace> residual(A.num_rows, 0.0f);
+    cusp::multiply(A, x, residual);
+    cusp::blas::axpby(residual, b, residual, -1.0f, 1.0f);
+
+    cusp::array1d<float, cusp::host_memory> r(residual);
+    cusp::array1d<float, cusp::host_memory> x_host(x);
+
+    for (size_t i = 0; i < num_systems; i++)
+    {
+        float r_norm = cusp::blas::nrm2(r.subarray(i * N, N));
+        float b_norm = cusp::blas::nrm2(b_host.subarray(i * N, N));
+
+        ASSERT_EQUAL(r_norm <= 1e-4 * b_norm, true);
+    }
+
+    // the system with b = 0 is not touched
+    ASSERT_EQUAL(cusp::blas::nrm2(x_host.subarray((num_systems - 1) * N, N)), 0.0f);
+}
+DECLARE_HOST_DEVICE_UNITTEST(TestBatchedConjugateGradient)
+
+template <class MemorySpace>
+void TestBlockConjugateGradient(void)
+{
+    cusp::csr_matrix<int, float, MemorySpace> A;
+
+    cusp::gallery::poisson5pt(A, 10, 10);
+
+    const size_t N = A.num_rows;
+    const size_t s = 4;
+
+    // independent right-hand sides
+    cusp::array2d<float, cusp::host_memory> B_host(N, s);
+
+    for (size_t i = 0; i < N; i++)
+    {
+        B_host(i,0) = 1.0f;
+        B_host(i,1) = float(i % 7);
+        B_host(i,2) = (i % 2) ? 1.0f : -1.0f;
+        B_host(i,3) = float(i) / float(N);
+    }
+
+    cusp::array2d<float, MemorySpace> B(B_host);
+    cusp::array2d<float, MemorySpace> X(N, s, 0.0f);
+
+    cusp::monitor<float> monitor(B.values, 100, 1e-5);
+
+    cusp::krylov::block_cg(A, X, B, monitor);
+
+    ASSERT_EQUAL(monitor.converged(), true);
+
+    cusp::array2d<float, cusp::host_memory> X_host(X);
+
+    for (size_t j = 0; j < s; j++)
+    {
+        cusp::array1d<float, MemorySpace> x(N);
+        cusp::array1d<float, MemorySpace> b(N);
+        cusp::array1d<float, MemorySpace> residual(N, 0.0f);
+
+        for (size_t i = 0; i < N; i++)
+        {
+            x[i] = X_host(i,j);
+            b[i] = B_host(i,j);
+        }
+
+        cusp::multiply(A, x, residual);
+        cusp::blas::axpby(residual, b, residual, -1.0f, 1.0f);
+
+        ASSERT_EQUAL(cusp::blas::nrm2(residual) < 1e-3 * cusp::blas::nrm2(b), true);
+    }
+}
+DECLARE_HOST_DEVICE_UNITTEST(TestBlockConjugateGradient)
+
+template <class MemorySpace>
+void TestRecycledConjugateGradient(void)
+{
+    cusp::csr_matrix<int, float, cusp::host_memory> A_host;
+
+    cusp::gallery::poisson5pt(A_host, 16, 16);
+
+    const size_t N = A_host.num_rows;
+
+    cusp::array1d<float, MemorySpace> b(N);
+
+    for (size_t i = 0; i < N; i++)
+        b[i] = float(i % 7);
+
+    cusp::krylov::recycled_cg_solver<float, MemorySpace> solver(N);
+
+    size_t first_count = 0;
+
+    // a sequence of slowly varying shifted Poisson problems
+    for (int step = 0; step < 4; step++)
+    {
+        for (size_t i = 0; i < N; i++)
+            for (int jj = A_host.row_offsets[i]; jj < A_host.row_offsets[i + 1]; jj++)
+                if (size_t(A_host.column_indices[jj]) == i)
+                    A_host.values[jj] = 4.0f + 0.01f * step;
+
+        cusp::csr_matrix<int, float, MemorySpace> A(A_host);
+
+        cusp::array1d<float, MemorySpace> x(N, 0.0f);
+        cusp::array1d<float, MemorySpace> residual(N, 0.0f);
+
+        cusp::monitor<float> monitor(b, 200, 1e-5);
+        solver.solve(A, x, b, monitor);
+
+        ASSERT_EQUAL(monitor.converged(), true);
+        ASSERT_EQUAL(solver.deflation_size(), size_t(8));
+
+        cusp::multiply(A, x, residual);
+        cusp::blas::axpby(residual, b, residual, -1.0f, 1.0f);
+
+        ASSERT_EQUAL(cusp::blas::nrm2(residual) < 1e-4 * cusp::blas::nrm2(b), true);
+
+        if (step == 0)
+        {
+            // without a basis the solver performs plain CG
+            cusp::array1d<float, MemorySpace> y(N, 0.0f);
+            cusp::monitor<float> monitor2(b, 200, 1e-5);
+            cusp::krylov::cg(A, y, b, monitor2);
+
+            ASSERT_EQUAL(monitor.iteration_count(), monitor2.iteration_count());
+
+            first_count = monitor.iteration_count();
+        }
+        else
+        {
+            ASSERT_EQUAL(monitor.iteration_count() < first_count, true);
+        }
+    }
+
+    // a reset solver starts from plain CG again
+    solver.reset();
+    ASSERT_EQUAL(solver.deflation_size(), size_t(0));
+}
+DECLARE_HOST_DEVICE_UNITTEST(TestRecycledConjugateGradient)
@@ -0,0 +1,118 @@
+#include <unittest/unittest.h>
+
+#include <cusp/csr_matrix.h>
+#include <cusp/linear_operator.h>
+#include <cusp/monitor.h>
+#include <cusp/multiply.h>
+
+#include <cusp/gallery/poisson.h>
+#include <cusp/krylov/chebyshev.h>
+#include <cusp/precond/diagonal.h>
+
+template <class LinearOperator,
+          class VectorType1,
+          class VectorType2,
+          class Monitor,
+          class Preconditioner,
+          class RealType>
+void chebyshev(my_system& system,
+               const LinearOperator& A,
+                     VectorType1& x,
+               const VectorType2& b,
+                     Monitor& monitor,
+                     Preconditioner& M,
+               const RealType lambda_min,
+               const RealType lambda_max)
+{
+    system.validate_dispatch();
+    return;
+}
+
+void TestChebyshevDispatch()
+{
+    // initialize testing variables
+    cusp::csr_matrix<int, float, cusp::device_memory> A;
+    cusp::gallery::poisson5pt(A, 10, 10);
+    cusp::array1d<float, cusp::device_memory> x(A.num_rows, 0.0f);
+    cusp::monitor<float> monitor(x, 20, 1e-4);
+    cusp::identity_operator<float,cusp::device_memory> M(A.num_rows, A.num_cols);
+
+    my_system sys(0);
+
+    // call with explicit dispatching
+    cusp::krylov::chebyshev(sys, A, x, x, monitor, M, 0.16f, 8.0f);
+
+    // check if dispatch policy was used
+    ASSERT_EQUAL(true, sys.is_valid());
+}
+DECLARE_UNITTEST(TestChebyshevDispatch);
+
+template <class MemorySpace>
+void TestChebyshev(void)
+{
+    cusp::csr_matrix<int, float, MemorySpace> A;
+
+    cusp::gallery::poisson5pt(A, 10, 10);
+
+    cusp::array1d<float, MemorySpace> x(A.num_rows, 0.0f);
+    cusp::array1d<float, MemorySpace> b(A.num_rows, 1.0f);
+
+    // the spectrum of the 10x10 Poisson matrix lies in [0.16, 7.84]
+    cusp::monitor<float> monitor(b, 500, 1e-5);
+
+    cusp::krylov::chebyshev(A, x, b, monitor, 0.16f, 8.0f);
+
+    // check residual norm
+    cusp::array1d<float, MemorySpace> residual(A.num_rows, 0.0f);
+    cusp::multiply(A, x, residual);
+    cusp::blas::axpby(residual, b, residual, -1.0f, 1.0f);
+
+    ASSERT_EQUAL(monitor.converged(), true);
+    ASSERT_EQUAL(cusp::blas::nrm2(residual) < 1e-4 * cusp::blas::nrm2(b), true);
+}
+DECLARE_HOST_DEVICE_UNITTEST(TestChebyshev)
+
+template <class MemorySpace>
+void TestChebyshevPreconditioned(void)
+{
+    cusp::csr_matrix<int, float, MemorySpace> A;
+
+    cusp::gallery::poisson5pt(A, 10, 10);
+
+    cusp::array1d<float, MemorySpace> x(A.num_rows, 0.0f);
+    cusp::array1d<float, MemorySpace> b(A.num_rows, 1.0f);
+
+    // Jacobi scales the spectrum by 1/4, residuals are checked every 10 iterations
+    cusp::precond::diagonal<float, MemorySpace> M(A);
+    cusp::monitor<float> monitor(b, 500, 1e-5, 0, false, 10);
+
+    cusp::krylov::chebyshev(A, x, b, monitor, M, 0.04f, 2.0f);
+
+    // check residual norm
+    cusp::array1d<float, MemorySpace> residual(A.num_rows, 0.0f);
+    cusp::multiply(A, x, residual);
+    cusp::blas::axpby(residual, b, residual, -1.0f, 1.0f);
+
+    ASSERT_EQUAL(monitor.converged(), true);
+    ASSERT_EQUAL(monitor.iteration_count() % 10, size_t(0));
+    ASSERT_EQUAL(cusp::blas::nrm2(residual) < 1e-4 * cusp::blas::nrm2(b), true);
+}
+DECLARE_HOST_DEVICE_UNITTEST(TestChebyshevPreconditioned)
+
+template <class MemorySpace>
+void TestChebyshevInvalidBounds(void)
+{
+    cusp::csr_matrix<int, float, MemorySpace> A;
+
+    cusp::gallery::poisson5pt(A, 4, 4);
+
+    cusp::array1d<float, MemorySpace> x(A.num_rows, 0.0f);
+    cusp::array1d<float, MemorySpace> b(A.num_rows, 1.0f);
+
+    cusp::monitor<float> monitor(b, 20, 1e-5);
+
+    ASSERT_THROWS(cusp::krylov::chebyshev(A, x, b, monitor, 0.0f, 8.0f), cusp::invalid_input_exception);
+    ASSERT_THROWS(cusp::krylov::chebyshev(A, x, b, monitor, 8.0f, 0.5f), cusp::invalid_input_exception);
+}
+DECLARE_HOST_DEVICE_UNITTEST(TestChebyshevInvalidBounds)
+
@@ -0,0 +1,126 @@
+#include <unittest/unittest.h>
+
+#include <cusp/array1d.h>
+#include <cusp/blas.h>
+#include <cusp/cholesky.h>
+#include <cusp/coo_matrix.h>
+#include <cusp/csr_matrix.h>
+#include <cusp/monitor.h>
+#include <cusp/multiply.h>
+
+#include <cusp/gallery/poisson.h>
+#include <cusp/precond/aggregation/smoothed_aggregation.h>
+
+template <typename MemorySpace>
+void _TestCholeskySolve(const cusp::cholesky_ordering ordering)
+{
+    cusp::csr_matrix<int, double, MemorySpace> A;
+    cusp::gallery::poisson5pt(A, 21, 17);
+
+    cusp::cholesky_solver<double, MemorySpace> M(A, ordering);
+
+    ASSERT_EQUAL(M.num_rows, A.num_rows);
+    ASSERT_EQUAL(M.num_supernodes() > 0, true);
+    ASSERT_EQUAL(M.num_supernodes() <= size_t(A.num_rows), true);
+
+    cusp::array1d<double, MemorySpace> b(unittest::random_samples<double>(A.num_rows));
+    cusp::array1d<double, MemorySpace> x(A.num_rows, 0);
+    cusp::array1d<double, MemorySpace> y(A.num_rows, 0);
+
+    M(b, x);
+    cusp::multiply(A, x, y);
+
+    ASSERT_ALMOST_EQUAL(y, b);
+
+    // the solve may overwrite its right hand side
+    cusp::array1d<double, MemorySpace> z(b);
+    M(z, z);
+
+    ASSERT_ALMOST_EQUAL(z, x);
+}
+
+template <class MemorySpace>
+void TestCholeskySolve(void)
+{
+    _TestCholeskySolve<MemorySpace>(cusp::natural_ordering);
+    _TestCholeskySolve<MemorySpace>(cusp::rcm_ordering);
+}
+DECLARE_HOST_DEVICE_UNITTEST(TestCholeskySolve);
+
+template <class MemorySpace>
+void TestCholeskyRefactor(void)
+{
+    cusp::coo_matrix<int, double, MemorySpace> A;
+    cusp::gallery::poisson5pt(A, 15, 15);
+
+    cusp::cholesky_solver<double, MemorySpace> M(A);
+
+    // new values on the same pattern
+    cusp::blas::scal(A.values, 3.0);
+    M.refactor(A);
+
+    cusp::array1d<double, MemorySpace> b(unittest::random_samples<double>(A.num_rows));
+    cusp::array1d<double, MemorySpace> x(A.num_rows, 0);
+    cusp::array1d<double, MemorySpace> y(A.num_rows, 0);
+
+    M(b, x);
+    cusp::multiply(A, x, y);
+
+    ASSERT_ALMOST_EQUAL(y, b);
+
+    // factors copied to another memory space
+    cusp::cholesky_solver<double, cusp::host_memory> H(M);
+    cusp::array1d<double, cusp::host_memory> b_host(b);
+    cusp::array1d<double, cusp::host_memory> x_host(A.num_rows, 0);
+
+    H(b_host, x_host);
+
+    ASSERT_ALMOST_EQUAL(x_host, x);
+}
+DECLARE_HOST_DEVICE_UNITTEST(TestCholeskyRefactor);
+
+void TestCholeskyInvalidInput(void)
+{
+    typedef cusp::cholesky_solver<double, cusp::host_memory> Solver;
+
+    cusp::csr_matrix<int, double, cusp::host_memory> A(3, 4, 0);
+    ASSERT_THROWS(Solver M(A), cusp::invalid_input_exception);
+
+    // refactor requires the pattern of the factored matrix
+    cusp::csr_matrix<int, double, cusp::host_memory> B;
+    cusp::csr_matrix<int, double, cusp::host_memory> C;
+    cusp::gallery::poisson5pt(B, 5, 5);
+    cusp::gallery::poisson5pt(C, 5, 6);
+
+    Solver M(B);
+    ASSERT_THROWS(M.refactor(C), cusp::invalid_input_exception);
+
+    // a zero pivot
+    cusp::csr_matrix<int, double, cusp::host_memory> Z(2, 2, 2);
+    Z.row_offsets[0] = 0; Z.row_offsets[1] = 1; Z.row_offsets[2] = 2;
+    Z.column_indices[0] = 1; Z.values[0] = 1;
+    Z.column_indices[1] = 0; Z.values[1] = 1;
+
+    ASSERT_THROWS(Solver N(Z, cusp::natural_ordering), cusp::runtime_exception);
+}
+DECLARE_UNITTEST(TestCholeskyInvalidInput);
+
+template <class MemorySpace>
+void TestCholeskyCoarseSolver(void)
+{
+    typedef cusp::cholesky_solver<double, MemorySpace> Solver;
+
+    cusp::csr_matrix<int, double, MemorySpace> A;
+    cusp::gallery::poisson5pt(A, 50, 50);
+
+    cusp::precond::aggregation::smoothed_aggregation<int, double, MemorySpace, thrust::use_default, Solver> M(A);
+
+    cusp::array1d<double, MemorySpace> b(unittest::random_samples<double>(A.num_rows));
+    cusp::array1d<double, MemorySpace> x(A.num_rows, 0);
+
+    cusp::monitor<double> monitor(b, 40, 1e-6);
+    M.solve(b, x, monitor);
+
+    ASSERT_EQUAL(monitor.converged(), true);
+}
+DECLARE_HOST_DEVICE_UNITTEST(TestCholeskyCoarseSolver);
@@ -0,0 +1,121 @@
+#include <unittest/unittest.h>
+
+#include <cusp/precond/classical_amg.h>
+#include <cusp/precond/classical/splitting.h>
+#include <cusp/precond/classical/strength.h>
+
+#include <cusp/csr_matrix.h>
+#include <cusp/hyb_matrix.h>
+#include <cusp/monitor.h>
+
+#include <cusp/gallery/poisson.h>
+#include <cusp/krylov/cg.h>
+
+template <class MemorySpace>
+void TestPMISSplitting(void)
+{
+    cusp::csr_matrix<int,float,MemorySpace> A;
+    cusp::gallery::poisson5pt(A, 20, 20);
+
+    cusp::csr_matrix<int,float,MemorySpace> S;
+    cusp::precond::classical::classical_strength_of_connection(A, S);
+
+    cusp::array1d<int,MemorySpace> splitting(A.num_rows);
+    cusp::precond::classical::pmis_splitting(S, splitting);
+
+    cusp::csr_matrix<int,float,cusp::host_memory> h_S(S);
+    cusp::array1d<int,cusp::host_memory> h_splitting(splitting);
+
+    // C-points are independent and every F-point depends on a C-point
+    for(size_t i = 0; i < h_S.num_rows; i++)
+    {
+        bool has_coarse_neighbor = false;
+
+        for(int jj = h_S.row_offsets[i]; jj < h_S.row_offsets[i + 1]; jj++)
+            has_coarse_neighbor |= h_splitting[h_S.column_indices[jj]] == cusp::precond::classical::C_POINT;
+
+        if(h_splitting[i] == cusp::precond::classical::C_POINT)
+            ASSERT_EQUAL(has_coarse_neighbor, false);
+        else
+            ASSERT_EQUAL(has_coarse_neighbor, true);
+    }
+}
+DECLARE_HOST_DEVICE_UNITTEST(TestPMISSplitting);
+
+template <typename SparseMatrix>
+void TestClassicalAMG(void)
+{
+    typedef typename SparseMatrix::index_type   IndexType;
+    typedef typename SparseMatrix::value_type   ValueType;
+    typedef typename SparseMatrix::memory_space MemorySpace;
+
+    // Create 2D Poisson problem
+    SparseMatrix A;
+    cusp::gallery::poisson5pt(A, 100, 100);
+
+    // create classical AMG solver
+    cusp::precond::classical_amg<IndexType,ValueType,MemorySpace> M(A);
+
+    // test as standalone solver
+    {
+        cusp::array1d<ValueType,MemorySpace> b = unittest::random_samples<ValueType>(A.num_rows);
+        cusp::array1d<ValueType,MemorySpace> x = unittest::random_samples<ValueType>(A.num_rows);
+
+        // set stopping criteria (iteration_limit = 40, relative_tolerance = 1e-4)
+        cusp::monitor<ValueType> monitor(b, 40, 1e-4);
+        M.solve(b,x,monitor);
+
+        ASSERT_EQUAL(monitor.converged(), true);
+        ASSERT_EQUAL(monitor.geometric_rate() < 0.8, true);
+    }
+
+    // test as preconditioner
+    {
+        cusp::array1d<ValueType,MemorySpace> b = unittest::random_samples<ValueType>(A.num_rows);
+        cusp::array1d<ValueType,MemorySpace> x = unittest::random_samples<ValueType>(A.num_rows);
+
+        // set stopping criteria (iteration_limit = 20, relative_tolerance = 1e-4)
+        cusp::monitor<ValueType> monitor(b, 20, 1e-4);
+        cusp::krylov::cg(A, x, b, monitor, M);
+
+        ASSERT_EQUAL(monitor.converged(), true);
+        ASSERT_EQUAL(monitor.geometric_rate() < 0.5, true);
+    }
+}
+DECLARE_SPARSE_MATRIX_UNITTEST(TestClassicalAMG);
+
+template <class MemorySpace>
+void TestClassicalAMGAggressiveCoarsening(void)
+{
+    typedef cusp::csr_matrix<int,float,MemorySpace> SparseMatrix;
+
+    SparseMatrix A;
+    cusp::gallery::poisson5pt(A, 100, 100);
+
+    cusp::precond::classical_amg<int,float,MemorySpace> M(A);
+    cusp::precond::classical_amg<int,float,MemorySpace> M_hmis(A, 0.25, cusp::precond::HMIS_COARSENING);
+    cusp::precond::classical_amg<int,float,MemorySpace> M_aggressive(A, 0.25, cusp::precond::PMIS_COARSENING, 1);
+
+    // aggressive coarsening trades convergence for a smaller hierarchy
+    ASSERT_EQUAL(M_aggressive.operator_complexity() < M.operator_complexity(), true);
+    ASSERT_EQUAL(M_aggressive.levels[1].A.num_rows < M.levels[1].A.num_rows, true);
+
+    cusp::array1d<float,MemorySpace> b = unittest::random_samples<float>(A.num_rows);
+
+    {
+        cusp::array1d<float,MemorySpace> x(A.num_rows, 0);
+        cusp::monitor<float> monitor(b, 40, 1e-4);
+        cusp::krylov::cg(A, x, b, monitor, M_hmis);
+
+        ASSERT_EQUAL(monitor.converged(), true);
+    }
+
+    {
+        cusp::array1d<float,MemorySpace> x(A.num_rows, 0);
+        cusp::monitor<float> monitor(b, 60, 1e-4);
+        cusp::krylov::cg(A, x, b, monitor, M_aggressive);
+
+        ASSERT_EQUAL(monitor.converged(), true);
+    }
+}
+DECLARE_HOST_DEVICE_UNITTEST(TestClassicalAMGAggressiveCoarsening);
@@ -0,0 +1,87 @@
+#include <unittest/unittest.h>
+
+#if THRUST_DEVICE_SYSTEM == THRUST_DEVICE_SYSTEM_CUDA
+
+#include <cusp/array1d.h>
+#include <cusp/csr_matrix.h>
+#include <cusp/gallery/poisson.h>
+#include <cusp/multiply.h>
+
+#include <cusp/system/cuda/co_execution.h>
+
+namespace ce = cusp::system::cuda::co_execution;
+
+void TestCoExecutionMultiply(void)
+{
+    cusp::csr_matrix<int, float, cusp::host_memory> G;
+    cusp::gallery::poisson5pt(G, 17, 13);
+
+    cusp::array1d<float, cusp::host_memory> x = unittest::random_samples<float>(G.num_rows);
+    cusp::array1d<float, cusp::host_memory> expected(G.num_rows);
+    cusp::multiply(G, x, expected);
+
+    cusp::array1d<float, cusp::device_memory> d_x(x);
+
+    const double ratios[4] = { 0.0, 0.3, 0.75, 1.0 };
+
+    for (int n = 0; n < 4; n++)
+    {
+        ce::csr_matrix<int, float> A(G, ratios[n], false);
+
+        ASSERT_EQUAL(A.device_part().num_entries + A.host_part().num_entries, G.num_entries);
+        ASSERT_EQUAL(A.device_part().num_rows + A.num_host_rows(), G.num_rows);
+
+        cusp::array1d<float, cusp::device_memory> d_y(G.num_rows, -1.0f);
+
+        A(d_x, d_y);
+
+        cusp::array1d<float, cusp::host_memory> y(d_y);
+        ASSERT_ALMOST_EQUAL(y, expected);
+
+        // the buffers are reused by a second product
+        cusp::multiply(A, d_x, d_y);
+
+        y = d_y;
+        ASSERT_ALMOST_EQUAL(y, expected);
+    }
+
+    ASSERT_EQUAL(ce::csr_matrix<int, float>(G, 0.0, false).num_host_rows(), 0);
+    ASSERT_EQUAL(ce::csr_matrix<int, float>(G, 1.0, false).num_host_rows(), G.num_rows);
+}
+DECLARE_UNITTEST(TestCoExecutionMultiply);
+
+void TestCoExecutionBalance(void)
+{
+    cusp::csr_matrix<int, float, cusp::host_memory> G;
+    cusp::gallery::poisson5pt(G, 64, 64);
+
+    cusp::array1d<float, cusp::host_memory> x = unittest::random_samples<float>(G.num_rows);
+    cusp::array1d<float, cusp::host_memory> expected(G.num_rows);
+    cusp::multiply(G, x, expected);
+
+    cusp::array1d<float, cusp::device_memory> d_x(x);
+    cusp::array1d<float, cusp::device_memory> d_y(G.num_rows);
+
+    ce::csr_matrix<int, float> A(G, 0.5);
+    A.set_auto_balance(true, 2);
+
+    // the products stay correct while the split moves
+    for (int i = 0; i < 10; i++)
+    {
+        A(d_x, d_y);
+
+        cusp::array1d<float, cusp::host_memory> y(d_y);
+        ASSERT_ALMOST_EQUAL(y, expected);
+    }
+
+    ASSERT_EQUAL(A.host_ratio() >= 0.0 && A.host_ratio() <= 1.0, true);
+    ASSERT_EQUAL(A.device_part().num_entries + A.host_part().num_entries, G.num_entries);
+
+    ASSERT_THROWS(A.set_host_ratio(1.5), cusp::invalid_input_exception);
+
+    cusp::array1d<float, cusp::device_memory> z(G.num_rows + 1);
+    ASSERT_THROWS(A(d_x, z), cusp::invalid_input_exception);
+}
+DECLARE_UNITTEST(TestCoExecutionBalance);
+
+#endif
@@ -2,7 +2,96 @@
 
 #include <cusp/graph/connected_components.h>
 
+#include <cusp/coo_matrix.h>
 #include <cusp/csr_matrix.h>
+#include <cusp/ell_matrix.h>
+
+#include <cusp/gallery/poisson.h>
+
+#include <thrust/fill.h>
+#include <thrust/replace.h>
+
+template <class MemorySpace>
+void TestConnectedComponentsManyComponents(void)
+{
+    typedef int   IndexType;
+    typedef float ValueType;
+
+    // 500 disjoint paths of 3 vertices followed by 100 isolated vertices
+    const IndexType num_paths = 500;
+    const IndexType N = 3 * num_paths + 100;
+
+    cusp::coo_matrix<IndexType,ValueType,cusp::host_memory> A(N, N, 4 * num_paths);
+
+    for(IndexType i = 0; i < num_paths; i++)
+    {
+        A.row_indices[4 * i + 0] = 3 * i + 0; A.column_indices[4 * i + 0] = 3 * i + 1;
+        A.row_indices[4 * i + 1] = 3 * i + 1; A.column_indices[4 * i + 1] = 3 * i + 0;
+        A.row_indices[4 * i + 2] = 3 * i + 1; A.column_indices[4 * i + 2] = 3 * i + 2;
+        A.row_indices[4 * i + 3] = 3 * i + 2; A.column_indices[4 * i + 3] = 3 * i + 1;
+    }
+    thrust::fill(A.values.begin(), A.values.end(), ValueType(1));
+    A.sort_by_row_and_column();
+
+    cusp::csr_matrix<IndexType,ValueType,MemorySpace> G(A);
+    cusp::array1d<IndexType,MemorySpace> components(N);
+
+    size_t num_components = cusp::graph::connected_components(G, components);
+
+    ASSERT_EQUAL(num_components, size_t(num_paths + 100));
+
+    cusp::array1d<IndexType,cusp::host_memory> h_components(components);
+    cusp::array1d<IndexType,cusp::host_memory> counts(num_components, 0);
+
+    for(IndexType i = 0; i < num_paths; i++)
+    {
+        ASSERT_EQUAL(h_components[3 * i + 1], h_components[3 * i]);
+        ASSERT_EQUAL(h_components[3 * i + 2], h_components[3 * i]);
+    }
+
+    for(IndexType i = 0; i < N; i++)
+    {
+        ASSERT_EQUAL(h_components[i] >= 0 && h_components[i] < IndexType(num_components), true);
+        counts[h_components[i]]++;
+    }
+
+    // every label names a different component
+    for(size_t c = 0; c < num_components; c++)
+        ASSERT_EQUAL(counts[c] == 1 || counts[c] == 3, true);
+}
+DECLARE_HOST_DEVICE_UNITTEST(TestConnectedComponentsManyComponents);
+
+template <class MemorySpace>
+void TestConnectedComponentsInvalidEdges(void)
+{
+    typedef int   IndexType;
+    typedef float ValueType;
+
+    cusp::csr_matrix<IndexType,ValueType,MemorySpace> G;
+    cusp::gallery::poisson5pt(G, 20, 20);
+
+    // disconnect vertex 0
+    const IndexType X = cusp::ell_matrix<IndexType,ValueType,cusp::host_memory>::invalid_index;
+
+    thrust::fill(G.column_indices.begin() + G.row_offsets[0],
+                 G.column_indices.begin() + G.row_offsets[1],
+                 X);
+    thrust::replace(G.column_indices.begin(), G.column_indices.end(), 0, X);
+
+    cusp::array1d<IndexType,MemorySpace> components(G.num_rows);
+
+    size_t num_components = cusp::graph::connected_components(G, components);
+
+    ASSERT_EQUAL(num_components, size_t(2));
+
+    cusp::array1d<IndexType,cusp::host_memory> h_components(components);
+
+    for(size_t i = 2; i < G.num_rows; i++)
+        ASSERT_EQUAL(h_components[i], h_components[1]);
+
+    ASSERT_EQUAL(h_components[0] != h_components[1], true);
+}
+DECLARE_HOST_DEVICE_UNITTEST(TestConnectedComponentsInvalidEdges);
 
 template <typename MatrixType, typename ArrayType>
 size_t connected_components(my_system& system,
@@ -11,6 +11,8 @@
 
 #include <cusp/verify.h>
 
+#include <cusp/gallery/random.h>
+
 
 template <typename Matrix>
 void reset_view(Matrix& view, cusp::coo_format)
@@ -494,6 +496,69 @@ void TestConvertCsrToEllMatrixHost(void)
 }
 DECLARE_UNITTEST(TestConvertCsrToEllMatrixHost);
 
+// the device chooses the HYB width from a histogram of the row lengths,
+// the result has to match the host conversion
+void TestConvertCsrToHybMatrixDevice(void)
+{
+    cusp::csr_matrix<int, float, cusp::host_memory> A;
+    cusp::gallery::random(A, 6000, 5000, 30000);
+
+    // a few long rows move to the COO part
+    cusp::coo_matrix<int, float, cusp::host_memory> B(A);
+    cusp::coo_matrix<int, float, cusp::host_memory> C(A.num_rows, A.num_cols, B.num_entries + 3 * 200);
+
+    size_t n = 0;
+
+    for(size_t i = 0, k = 0; i < A.num_rows; i++)
+    {
+        for(; k < B.num_entries && B.row_indices[k] == int(i); k++, n++)
+        {
+            C.row_indices[n]    = i;
+            C.column_indices[n] = B.column_indices[k];
+            C.values[n]         = B.values[k];
+        }
+
+        if(i % 2000 == 7)
+        {
+            for(size_t j = 0; j < 200; j++, n++)
+            {
+                C.row_indices[n]    = i;
+                C.column_indices[n] = j * 25 + 1;
+                C.values[n]         = j;
+            }
+        }
+    }
+
+    C.resize(A.num_rows, A.num_cols, n);
+    C.sort_by_row_and_column();
+    cusp::convert(C, A);
+
+    cusp::hyb_matrix<int, float, cusp::host_memory> host_hyb(A);
+
+    cusp::csr_matrix<int, float, cusp::device_memory> d_A(A);
+    cusp::hyb_matrix<int, float, cusp::device_memory> d_hyb(d_A);
+    cusp::ell_matrix<int, float, cusp::device_memory> d_ell(d_A);
+
+    cusp::hyb_matrix<int, float, cusp::host_memory> device_hyb(d_hyb);
+
+    ASSERT_EQUAL(device_hyb.ell.column_indices.num_cols, host_hyb.ell.column_indices.num_cols);
+    ASSERT_EQUAL(device_hyb.ell.num_entries, host_hyb.ell.num_entries);
+    ASSERT_EQUAL(device_hyb.coo.num_entries, host_hyb.coo.num_entries);
+    ASSERT_EQUAL(device_hyb.ell.column_indices.values, host_hyb.ell.column_indices.values);
+    ASSERT_EQUAL(device_hyb.ell.values.values, host_hyb.ell.values.values);
+    ASSERT_EQUAL(device_hyb.coo.row_indices, host_hyb.coo.row_indices);
+    ASSERT_EQUAL(device_hyb.coo.column_indices, host_hyb.coo.column_indices);
+    ASSERT_EQUAL(device_hyb.coo.values, host_hyb.coo.values);
+
+    cusp::ell_matrix<int, float, cusp::host_memory> host_ell(A);
+    cusp::ell_matrix<int, float, cusp::host_memory> device_ell(d_ell);
+
+    ASSERT_EQUAL(device_ell.num_entries, host_ell.num_entries);
+    ASSERT_EQUAL(device_ell.column_indices.values, host_ell.column_indices.values);
+    ASSERT_EQUAL(device_ell.values.values, host_ell.values.values);
+}
+DECLARE_UNITTEST(TestConvertCsrToHybMatrixDevice);
+
 template <class Matrix>
 void TestConversionFromArray1dTo(void)
 {
@@ -666,6 +731,63 @@ void TestConversionFromPitchedArray2dToArray1d(void)
 }
 DECLARE_HOST_DEVICE_UNITTEST(TestConversionFromPitchedArray2dToArray1d);
 
+template <typename Space>
+void TestMoveConvert(void)
+{
+    cusp::coo_matrix<int, float, Space> coo;
+    initialize_conversion_example(coo);
+
+    cusp::csr_matrix<int, float, Space> expected;
+    cusp::convert(coo, expected);
+
+    // the previous contents of the destination are discarded
+    cusp::csr_matrix<int, float, Space> csr(2, 2, 2);
+    cusp::move_convert(coo, csr);
+
+    ASSERT_EQUAL(coo.num_entries,    0);
+    ASSERT_EQUAL(coo.values.size(),  0);
+    ASSERT_EQUAL(csr.num_rows,       expected.num_rows);
+    ASSERT_EQUAL(csr.num_cols,       expected.num_cols);
+    ASSERT_EQUAL(csr.num_entries,    expected.num_entries);
+    ASSERT_EQUAL(csr.row_offsets,    expected.row_offsets);
+    ASSERT_EQUAL(csr.column_indices, expected.column_indices);
+    ASSERT_EQUAL(csr.values,         expected.values);
+
+    // expand back into COO
+    cusp::move_convert(csr, coo);
+
+    ASSERT_EQUAL(csr.num_entries,        0);
+    ASSERT_EQUAL(csr.row_offsets.size(), 0);
+    verify_conversion_example(coo);
+
+    // other formats convert and release the source
+    cusp::ell_matrix<int, float, Space> ell;
+    cusp::move_convert(coo, ell);
+
+    ASSERT_EQUAL(coo.num_entries, 0);
+    verify_conversion_example(ell);
+
+    // empty matrices
+    cusp::coo_matrix<int, float, Space> empty(3, 2, 0);
+    cusp::move_convert(empty, csr);
+
+    ASSERT_EQUAL(csr.num_rows,    3);
+    ASSERT_EQUAL(csr.num_cols,    2);
+    ASSERT_EQUAL(csr.num_entries, 0);
+    ASSERT_EQUAL(csr.row_offsets, cusp::array1d<int, Space>(4, 0));
+
+#if __cplusplus >= 201103L
+    cusp::move_convert(ell, coo);
+
+    cusp::csr_matrix<int, float, Space> moved;
+    cusp::convert(std::move(coo), moved);
+
+    ASSERT_EQUAL(coo.num_entries, 0);
+    verify_conversion_example(moved);
+#endif
+}
+DECLARE_HOST_DEVICE_UNITTEST(TestMoveConvert);
+
 template <typename MatrixType1, typename MatrixType2>
 void convert(my_system& system, const MatrixType1& A, MatrixType2& At)
 {
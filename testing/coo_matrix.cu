@@ -70,6 +70,29 @@ void TestCooMatrixResize(void)
 }
 DECLARE_HOST_DEVICE_UNITTEST(TestCooMatrixResize);
 
+template <class Space>
+void TestCooMatrixNoInit(void)
+{
+    cusp::coo_matrix<int, float, Space> matrix(3, 2, 6, cusp::no_init);
+
+    ASSERT_EQUAL(matrix.num_rows,              3);
+    ASSERT_EQUAL(matrix.num_cols,              2);
+    ASSERT_EQUAL(matrix.num_entries,           6);
+    ASSERT_EQUAL(matrix.row_indices.size(),    6);
+    ASSERT_EQUAL(matrix.column_indices.size(), 6);
+    ASSERT_EQUAL(matrix.values.size(),         6);
+
+    matrix.resize(4, 3, 8, cusp::no_init);
+
+    ASSERT_EQUAL(matrix.num_rows,              4);
+    ASSERT_EQUAL(matrix.num_cols,              3);
+    ASSERT_EQUAL(matrix.num_entries,           8);
+    ASSERT_EQUAL(matrix.row_indices.size(),    8);
+    ASSERT_EQUAL(matrix.column_indices.size(), 8);
+    ASSERT_EQUAL(matrix.values.size(),         8);
+}
+DECLARE_HOST_DEVICE_UNITTEST(TestCooMatrixNoInit);
+
 template <class Space>
 void TestCooMatrixSwap(void)
 {
@@ -87,3 +87,32 @@ void TestConjugateResidualZeroResidual(void)
 }
 DECLARE_HOST_DEVICE_UNITTEST(TestConjugateResidualZeroResidual);
 
+template <class MemorySpace>
+void TestConjugateResidualSolver(void)
+{
+    cusp::csr_matrix<int, float, MemorySpace> A;
+
+    cusp::gallery::poisson5pt(A, 10, 10);
+
+    cusp::array1d<float, MemorySpace> x(A.num_rows, 0.0f);
+    cusp::array1d<float, MemorySpace> y(A.num_rows, 0.0f);
+    cusp::array1d<float, MemorySpace> b(A.num_rows, 1.0f);
+
+    cusp::monitor<float> monitor1(b, 20, 1e-4);
+    cusp::krylov::cr(A, x, b, monitor1);
+
+    // the workspace is reused across solves
+    cusp::krylov::cr_solver<float, MemorySpace> solver(A.num_rows);
+
+    for (int i = 0; i < 2; i++)
+    {
+        cusp::monitor<float> monitor2(b, 20, 1e-4);
+
+        cusp::blas::fill(y, 0.0f);
+        solver.solve(A, y, b, monitor2);
+
+        ASSERT_EQUAL(monitor2.iteration_count(), monitor1.iteration_count());
+        ASSERT_ALMOST_EQUAL(y, x);
+    }
+}
+DECLARE_HOST_DEVICE_UNITTEST(TestConjugateResidualSolver);
@@ -1,5 +1,11 @@
 #include <unittest/unittest.h>
+#include <cusp/array2d.h>
+#include <cusp/coo_matrix.h>
 #include <cusp/csr_matrix.h>
+#include <cusp/multiply.h>
+#include <cusp/transpose.h>
+
+#include <cusp/gallery/random.h>
 
 template <class Space>
 void TestCsrMatrixBasicConstructor(void)
@@ -69,6 +75,29 @@ void TestCsrMatrixResize(void)
 }
 DECLARE_HOST_DEVICE_UNITTEST(TestCsrMatrixResize);
 
+template <class Space>
+void TestCsrMatrixNoInit(void)
+{
+    cusp::csr_matrix<int, float, Space> matrix(3, 2, 6, cusp::no_init);
+
+    ASSERT_EQUAL(matrix.num_rows,              3);
+    ASSERT_EQUAL(matrix.num_cols,              2);
+    ASSERT_EQUAL(matrix.num_entries,           6);
+    ASSERT_EQUAL(matrix.row_offsets.size(),    4);
+    ASSERT_EQUAL(matrix.column_indices.size(), 6);
+    ASSERT_EQUAL(matrix.values.size(),         6);
+
+    matrix.resize(4, 3, 8, cusp::no_init);
+
+    ASSERT_EQUAL(matrix.num_rows,              4);
+    ASSERT_EQUAL(matrix.num_cols,              3);
+    ASSERT_EQUAL(matrix.num_entries,           8);
+    ASSERT_EQUAL(matrix.row_offsets.size(),    5);
+    ASSERT_EQUAL(matrix.column_indices.size(), 8);
+    ASSERT_EQUAL(matrix.values.size(),         8);
+}
+DECLARE_HOST_DEVICE_UNITTEST(TestCsrMatrixNoInit);
+
 template <class Space>
 void TestCsrMatrixSwap(void)
 {
@@ -128,3 +157,68 @@ void TestCsrMatrixRebind(void)
 }
 DECLARE_UNITTEST(TestCsrMatrixRebind);
 
+template <class Space>
+void TestCsrMatrixWideOffsets(void)
+{
+    typedef cusp::csr_matrix<int, float, Space>            CsrMatrix;
+    typedef cusp::csr_matrix<int, float, Space, long long> WideCsrMatrix;
+
+    CsrMatrix A;
+    cusp::gallery::random(A, 40, 30, 200);
+
+    WideCsrMatrix B(A);
+
+    ASSERT_EQUAL(sizeof(typename WideCsrMatrix::offset_type), sizeof(long long));
+    ASSERT_EQUAL(sizeof(typename WideCsrMatrix::index_type),  sizeof(int));
+
+    // conversions through COO and back
+    cusp::coo_matrix<int, float, Space> C(B);
+    CsrMatrix D(C);
+    WideCsrMatrix E(C);
+
+    cusp::array1d<int, Space> B_row_offsets(B.row_offsets);
+    cusp::array1d<int, Space> E_row_offsets(E.row_offsets);
+
+    ASSERT_EQUAL(B_row_offsets,    A.row_offsets);
+    ASSERT_EQUAL(E_row_offsets,    A.row_offsets);
+    ASSERT_EQUAL(D.row_offsets,    A.row_offsets);
+    ASSERT_EQUAL(D.column_indices, A.column_indices);
+    ASSERT_EQUAL(D.values,         A.values);
+
+    // views keep the type of the row offsets
+    typename WideCsrMatrix::view B_view(B);
+    ASSERT_EQUAL(B_view.num_entries, A.num_entries);
+
+    // matrix-vector product
+    cusp::array1d<float, Space> x(A.num_cols);
+    for(size_t i = 0; i < A.num_cols; i++)
+        x[i] = i % 7;
+
+    cusp::array1d<float, Space> y(A.num_rows, 1);
+    cusp::array1d<float, Space> z(A.num_rows, 1);
+
+    cusp::multiply(A, x, y);
+    cusp::multiply(B, x, z);
+
+    ASSERT_ALMOST_EQUAL(z, y);
+
+    // matrix-matrix product
+    CsrMatrix At;
+    cusp::transpose(A, At);
+    WideCsrMatrix Bt(At);
+
+    CsrMatrix     P;
+    WideCsrMatrix Q;
+
+    cusp::multiply(A, At, P);
+    cusp::multiply(B, Bt, Q);
+
+    ASSERT_EQUAL(Q.num_entries, P.num_entries);
+
+    // the backends may order the entries within a row differently
+    cusp::array2d<float, cusp::host_memory> P_dense(P);
+    cusp::array2d<float, cusp::host_memory> Q_dense(Q);
+
+    ASSERT_ALMOST_EQUAL(Q_dense.values, P_dense.values);
+}
+DECLARE_HOST_DEVICE_UNITTEST(TestCsrMatrixWideOffsets);
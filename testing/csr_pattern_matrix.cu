@@ -0,0 +1,136 @@
+#include <unittest/unittest.h>
+
+#include <cusp/coo_matrix.h>
+#include <cusp/csr_matrix.h>
+#include <cusp/csr_pattern_matrix.h>
+#include <cusp/multiply.h>
+
+#include <cusp/detail/num_bytes.h>
+
+#include <cusp/gallery/poisson.h>
+#include <cusp/gallery/random.h>
+
+#include <cusp/graph/breadth_first_search.h>
+#include <cusp/graph/connected_components.h>
+
+#include <thrust/fill.h>
+
+template <class Space>
+void TestCsrPatternMatrixBasicConstructor(void)
+{
+    cusp::csr_pattern_matrix<int, int, Space> matrix(3, 2, 6);
+
+    ASSERT_EQUAL(matrix.num_rows,              3);
+    ASSERT_EQUAL(matrix.num_cols,              2);
+    ASSERT_EQUAL(matrix.num_entries,           6);
+    ASSERT_EQUAL(matrix.row_offsets.size(),    4);
+    ASSERT_EQUAL(matrix.column_indices.size(), 6);
+    ASSERT_EQUAL(matrix.values.size(),         6);
+    ASSERT_EQUAL(matrix.values[5],             1);
+
+    matrix.resize(5, 4, 10);
+
+    ASSERT_EQUAL(matrix.row_offsets.size(),    6);
+    ASSERT_EQUAL(matrix.column_indices.size(), 10);
+    ASSERT_EQUAL(matrix.values.size(),         10);
+
+    // only the index arrays hold storage
+    ASSERT_EQUAL(cusp::detail::num_bytes(matrix), 16 * sizeof(int));
+}
+DECLARE_HOST_DEVICE_UNITTEST(TestCsrPatternMatrixBasicConstructor);
+
+template <class Space>
+void TestCsrPatternMatrixConversion(void)
+{
+    cusp::csr_matrix<int, float, cusp::host_memory> A;
+    cusp::gallery::poisson5pt(A, 6, 5);
+
+    cusp::csr_pattern_matrix<int, int, Space> P(A);
+
+    ASSERT_EQUAL(P.num_rows,       A.num_rows);
+    ASSERT_EQUAL(P.num_cols,       A.num_cols);
+    ASSERT_EQUAL(P.num_entries,    A.num_entries);
+    ASSERT_EQUAL(P.row_offsets,    A.row_offsets);
+    ASSERT_EQUAL(P.column_indices, A.column_indices);
+    ASSERT_EQUAL(P.values.size(),  A.num_entries);
+
+    // from a format other than CSR
+    cusp::coo_matrix<int, float, Space> B(A);
+    cusp::csr_pattern_matrix<int, int, Space> Q;
+    Q = B;
+
+    ASSERT_EQUAL(Q.row_offsets,    A.row_offsets);
+    ASSERT_EQUAL(Q.column_indices, A.column_indices);
+
+    // back to a matrix with unit values
+    cusp::coo_matrix<int, float, cusp::host_memory> C(P);
+    cusp::array1d<float, cusp::host_memory> ones(A.num_entries, 1);
+
+    ASSERT_EQUAL(C.num_entries,    A.num_entries);
+    ASSERT_EQUAL(C.column_indices, B.column_indices);
+    ASSERT_EQUAL(C.values,         ones);
+
+    // swap only exchanges the number of implicit entries
+    cusp::csr_pattern_matrix<int, int, Space> R(10, 10, 0);
+    R.swap(P);
+
+    ASSERT_EQUAL(R.values.size(), A.num_entries);
+    ASSERT_EQUAL(P.values.size(), 0);
+    ASSERT_EQUAL(P.num_rows,      10);
+}
+DECLARE_HOST_DEVICE_UNITTEST(TestCsrPatternMatrixConversion);
+
+template <class Space>
+void TestCsrPatternMatrixVectorMultiply(void)
+{
+    cusp::csr_matrix<int, float, Space> A;
+    cusp::gallery::random(A, 100, 80, 700);
+
+    cusp::csr_pattern_matrix<int, float, Space> P(A);
+
+    // the same pattern with explicit unit values
+    thrust::fill(A.values.begin(), A.values.end(), 1.0f);
+
+    cusp::array1d<float, Space> x(A.num_cols);
+    for(size_t i = 0; i < A.num_cols; i++)
+        x[i] = i % 5;
+
+    cusp::array1d<float, Space> y(A.num_rows, 10);
+    cusp::array1d<float, Space> z(A.num_rows, 10);
+
+    cusp::multiply(A, x, y);
+    cusp::multiply(P, x, z);
+
+    ASSERT_EQUAL(z, y);
+
+    // generalized SpMV with the implicit entries
+    cusp::array1d<float, Space> w(A.num_rows, 2);
+
+    cusp::generalized_spmv(A, x, w, y, thrust::multiplies<float>(), thrust::plus<float>());
+    cusp::generalized_spmv(P, x, w, z, thrust::multiplies<float>(), thrust::plus<float>());
+
+    ASSERT_EQUAL(z, y);
+}
+DECLARE_HOST_DEVICE_UNITTEST(TestCsrPatternMatrixVectorMultiply);
+
+template <class Space>
+void TestCsrPatternMatrixGraph(void)
+{
+    cusp::csr_matrix<int, float, Space> A;
+    cusp::gallery::poisson5pt(A, 10, 10);
+
+    cusp::csr_pattern_matrix<int, int, Space> G(A);
+
+    cusp::array1d<int, Space> levels_A(A.num_rows);
+    cusp::array1d<int, Space> levels_G(A.num_rows);
+
+    cusp::graph::breadth_first_search(A, 0, levels_A);
+    cusp::graph::breadth_first_search(G, 0, levels_G);
+
+    ASSERT_EQUAL(levels_G, levels_A);
+
+    cusp::array1d<int, Space> components(A.num_rows);
+
+    ASSERT_EQUAL(cusp::graph::connected_components(G, components), 1);
+}
+DECLARE_HOST_DEVICE_UNITTEST(TestCsrPatternMatrixGraph);
@@ -0,0 +1,139 @@
+#include <unittest/unittest.h>
+
+#include <cusp/coo_matrix.h>
+#include <cusp/csr_matrix.h>
+#include <cusp/dcsr_matrix.h>
+#include <cusp/multiply.h>
+
+#include <cusp/gallery/poisson.h>
+#include <cusp/gallery/random.h>
+
+// tridiagonal matrix with one far off-diagonal entry in the given row
+void InitializeBandedMatrix(cusp::csr_matrix<int, float, cusp::host_memory>& A,
+                            const int num_rows, const int num_cols, const int far_row, const int far_col)
+{
+    cusp::coo_matrix<int, float, cusp::host_memory> B(num_rows, num_cols, 3 * num_rows + 1);
+
+    int n = 0;
+    for(int i = 0; i < num_rows; i++)
+    {
+        for(int j = i - 1; j <= i + 1; j++)
+        {
+            if(j >= 0 && j < num_cols)
+            {
+                B.row_indices[n] = i; B.column_indices[n] = j; B.values[n] = (i + 2 * j) % 7 - 3;
+                n++;
+            }
+        }
+
+        if(i == far_row)
+        {
+            B.row_indices[n] = i; B.column_indices[n] = far_col; B.values[n] = 5;
+            n++;
+        }
+    }
+
+    B.resize(num_rows, num_cols, n);
+
+    A = B;
+}
+
+template <class Space>
+void TestDcsrMatrixBasicConstructor(void)
+{
+    cusp::dcsr_matrix<int, float, Space> matrix(600, 500, 1500, 40);
+
+    ASSERT_EQUAL(matrix.num_rows,              600);
+    ASSERT_EQUAL(matrix.num_cols,              500);
+    ASSERT_EQUAL(matrix.num_entries,           1500);
+    ASSERT_EQUAL(matrix.num_blocks(),          3);
+    ASSERT_EQUAL(matrix.row_offsets.size(),    601);
+    ASSERT_EQUAL(matrix.block_offsets.size(),  4);
+    ASSERT_EQUAL(matrix.column_deltas.size(),  1500);
+    ASSERT_EQUAL(matrix.column_indices.size(), 40);
+    ASSERT_EQUAL(matrix.values.size(),         1500);
+}
+DECLARE_HOST_DEVICE_UNITTEST(TestDcsrMatrixBasicConstructor);
+
+template <class Space>
+void TestDcsrMatrixConversion(void)
+{
+    // the far entry forces the second block of rows [256,512) to full indices
+    cusp::csr_matrix<int, float, cusp::host_memory> A;
+    InitializeBandedMatrix(A, 600, 50000, 300, 40000);
+
+    cusp::dcsr_matrix<int, float, Space> B(A);
+
+    const int block_entries = A.row_offsets[512] - A.row_offsets[256];
+
+    ASSERT_EQUAL(B.num_rows,     600);
+    ASSERT_EQUAL(B.num_cols,     50000);
+    ASSERT_EQUAL(B.num_entries,  A.num_entries);
+    ASSERT_EQUAL(B.num_blocks(), 3);
+    ASSERT_EQUAL(B.block_offsets[0], 0);
+    ASSERT_EQUAL(B.block_offsets[1], 0);
+    ASSERT_EQUAL(B.block_offsets[2], block_entries);
+    ASSERT_EQUAL(B.block_offsets[3], block_entries);
+    ASSERT_EQUAL(B.column_indices.size(), block_entries);
+
+    // entries of the first row are stored relative to the diagonal
+    ASSERT_EQUAL(B.column_deltas[0], 0);
+    ASSERT_EQUAL(B.column_deltas[1], 1);
+    ASSERT_EQUAL(B.column_deltas[2], -1);
+
+    // convert back to CSR
+    cusp::csr_matrix<int, float, Space> C(B);
+
+    ASSERT_EQUAL(C.row_offsets,    A.row_offsets);
+    ASSERT_EQUAL(C.column_indices, A.column_indices);
+    ASSERT_EQUAL(C.values,         A.values);
+
+    // without the far entry every block uses deltas
+    InitializeBandedMatrix(A, 600, 600, -1, 0);
+    B = A;
+
+    ASSERT_EQUAL(B.column_indices.size(), 0);
+    ASSERT_EQUAL(B.block_offsets[3], 0);
+
+    C = B;
+
+    ASSERT_EQUAL(C.column_indices, A.column_indices);
+}
+DECLARE_HOST_DEVICE_UNITTEST(TestDcsrMatrixConversion);
+
+template <typename TestMatrix>
+void _TestDcsrMatrixVectorMultiply(const TestMatrix& A)
+{
+    typedef typename TestMatrix::memory_space MemorySpace;
+
+    cusp::dcsr_matrix<int, float, MemorySpace> B(A);
+
+    cusp::array1d<float, MemorySpace> x(A.num_cols);
+    for(size_t i = 0; i < A.num_cols; i++)
+        x[i] = i % 5;
+
+    cusp::array1d<float, MemorySpace> y(A.num_rows, 10);
+    cusp::array1d<float, MemorySpace> z(A.num_rows, 10);
+
+    cusp::multiply(A, x, y);
+    cusp::multiply(B, x, z);
+
+    ASSERT_EQUAL(z, y);
+}
+
+template <class MemorySpace>
+void TestDcsrMatrixVectorMultiply(void)
+{
+    cusp::csr_matrix<int, float, cusp::host_memory> H;
+    InitializeBandedMatrix(H, 600, 50000, 300, 40000);
+
+    cusp::csr_matrix<int, float, MemorySpace> A(H);
+    _TestDcsrMatrixVectorMultiply(A);
+
+    cusp::gallery::poisson5pt(A, 30, 20);
+    _TestDcsrMatrixVectorMultiply(A);
+
+    cusp::gallery::random(A, 100, 80, 700);
+    _TestDcsrMatrixVectorMultiply(A);
+}
+DECLARE_HOST_DEVICE_UNITTEST(TestDcsrMatrixVectorMultiply);
@@ -0,0 +1,56 @@
+#include <unittest/unittest.h>
+
+#include <cusp/array2d.h>
+#include <cusp/csr_matrix.h>
+#include <cusp/gallery/poisson.h>
+
+#include <cusp/opengl/spy/density_grid.h>
+
+template <class MemorySpace>
+void TestBinNonzeros(void)
+{
+    // 4x4 dense block pattern
+    cusp::array2d<float, cusp::host_memory> D(4, 4, 0.0f);
+    D(0,0) = 1; D(0,1) = 1; D(0,3) = 1;
+    D(1,1) = 1;
+    D(2,2) = 1; D(2,3) = 1;
+    D(3,0) = 1; D(3,3) = 1;
+
+    cusp::csr_matrix<int, float, MemorySpace> A(D);
+    cusp::array1d<unsigned int, MemorySpace> counts;
+
+    // one cell per 2x2 block
+    cusp::opengl::spy::bin_nonzeros(A, 0, 0, 4, 4, 2, 2, counts);
+
+    ASSERT_EQUAL(counts.size(), 4);
+    ASSERT_EQUAL(counts[0], 3u);
+    ASSERT_EQUAL(counts[1], 1u);
+    ASSERT_EQUAL(counts[2], 1u);
+    ASSERT_EQUAL(counts[3], 3u);
+
+    // window clipped to the matrix
+    cusp::opengl::spy::bin_nonzeros(A, 2, 2, 8, 8, 1, 1, counts);
+
+    ASSERT_EQUAL(counts.size(), 1);
+    ASSERT_EQUAL(counts[0], 3u);
+}
+DECLARE_HOST_DEVICE_UNITTEST(TestBinNonzeros);
+
+template <class MemorySpace>
+void TestBinNonzerosTotal(void)
+{
+    cusp::csr_matrix<int, float, MemorySpace> A;
+    cusp::gallery::poisson5pt(A, 37, 23);
+
+    cusp::array1d<unsigned int, MemorySpace> counts;
+    cusp::opengl::spy::bin_nonzeros(A, 0, 0, A.num_rows, A.num_cols, 13, 7, counts);
+
+    cusp::array1d<unsigned int, cusp::host_memory> h_counts(counts);
+
+    size_t total = 0;
+    for (size_t i = 0; i < h_counts.size(); i++)
+        total += h_counts[i];
+
+    ASSERT_EQUAL(total, A.num_entries);
+}
+DECLARE_HOST_DEVICE_UNITTEST(TestBinNonzerosTotal);
@@ -141,3 +141,36 @@ void TestWriteDimacsFileCoordinateRealGeneral(void)
 }
 DECLARE_HOST_DEVICE_UNITTEST(TestWriteDimacsFileCoordinateRealGeneral);
 
+
+template <typename MemorySpace>
+void TestWriteDimacsFileLarge(void)
+{
+    // enough arcs to be split across several formatting chunks
+    cusp::coo_matrix<int, float, cusp::host_memory> E(4000, 4000, 40000);
+
+    for (size_t n = 0; n < E.num_entries; n++)
+    {
+        E.row_indices[n]    = n / 10;
+        E.column_indices[n] = (n * 7) % 4000;
+        E.values[n]         = float(n % 1000);
+    }
+    E.sort_by_row_and_column();
+
+    thrust::tuple<int,int> nodes(0, 3999);
+
+    cusp::coo_matrix<int, float, MemorySpace> A(E);
+    cusp::io::write_dimacs_file(A, nodes, random_file_name);
+
+    cusp::coo_matrix<int, float, cusp::host_memory> B;
+    thrust::tuple<int,int> read_nodes = cusp::io::read_dimacs_file(B, random_file_name);
+
+    remove(random_file_name);
+
+    ASSERT_EQUAL(thrust::get<0>(read_nodes), 0);
+    ASSERT_EQUAL(thrust::get<1>(read_nodes), 3999);
+    ASSERT_EQUAL(B.num_entries, E.num_entries);
+    ASSERT_EQUAL(B.row_indices,    E.row_indices);
+    ASSERT_EQUAL(B.column_indices, E.column_indices);
+    ASSERT_EQUAL(B.values,         E.values);
+}
+DECLARE_HOST_DEVICE_UNITTEST(TestWriteDimacsFileLarge);
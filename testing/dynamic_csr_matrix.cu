@@ -0,0 +1,207 @@
+#include <unittest/unittest.h>
+
+#include <cusp/coo_matrix.h>
+#include <cusp/csr_matrix.h>
+#include <cusp/dynamic_csr_matrix.h>
+#include <cusp/multiply.h>
+
+#include <cusp/gallery/poisson.h>
+#include <cusp/gallery/random.h>
+
+template <class Space>
+void TestDynamicCsrMatrixBasicConstructor(void)
+{
+    cusp::dynamic_csr_matrix<int, float, Space> matrix(3, 2, 4);
+
+    ASSERT_EQUAL(matrix.num_rows,              3);
+    ASSERT_EQUAL(matrix.num_cols,              2);
+    ASSERT_EQUAL(matrix.num_entries,           0);
+    ASSERT_EQUAL(matrix.capacity(),            12);
+    ASSERT_EQUAL(matrix.row_offsets.size(),    4);
+    ASSERT_EQUAL(matrix.row_lengths.size(),    3);
+    ASSERT_EQUAL(matrix.column_indices.size(), 12);
+    ASSERT_EQUAL(matrix.values.size(),         12);
+    ASSERT_EQUAL(matrix.row_offsets[2],        8);
+    ASSERT_EQUAL(matrix.row_lengths[2],        0);
+}
+DECLARE_HOST_DEVICE_UNITTEST(TestDynamicCsrMatrixBasicConstructor);
+
+template <class Space>
+void TestDynamicCsrMatrixConversion(void)
+{
+    cusp::csr_matrix<int, float, Space> A;
+    cusp::gallery::poisson5pt(A, 4, 3);
+
+    cusp::dynamic_csr_matrix<int, float, Space> B;
+    B.slack         = 0.5f;
+    B.min_row_slack = 1;
+    B = A;
+
+    ASSERT_EQUAL(B.num_rows,    A.num_rows);
+    ASSERT_EQUAL(B.num_cols,    A.num_cols);
+    ASSERT_EQUAL(B.num_entries, A.num_entries);
+
+    // a corner row holds 3 entries and receives 1 free slot, the next one 4 and 2
+    ASSERT_EQUAL(B.row_lengths[0], 3);
+    ASSERT_EQUAL(B.row_offsets[1], 4);
+    ASSERT_EQUAL(B.row_lengths[1], 4);
+    ASSERT_EQUAL(B.row_offsets[2], 10);
+    ASSERT_EQUAL(B.column_indices[4], A.column_indices[3]);
+
+    // compact to CSR and COO
+    cusp::csr_matrix<int, float, Space> C(B);
+
+    ASSERT_EQUAL(C.row_offsets,    A.row_offsets);
+    ASSERT_EQUAL(C.column_indices, A.column_indices);
+    ASSERT_EQUAL(C.values,         A.values);
+
+    cusp::coo_matrix<int, float, Space> D(A);
+    cusp::coo_matrix<int, float, Space> E(B);
+
+    ASSERT_EQUAL(E.row_indices,    D.row_indices);
+    ASSERT_EQUAL(E.column_indices, D.column_indices);
+    ASSERT_EQUAL(E.values,         D.values);
+}
+DECLARE_HOST_DEVICE_UNITTEST(TestDynamicCsrMatrixConversion);
+
+template <class Space>
+void TestDynamicCsrMatrixInsert(void)
+{
+    // rows 0 and 2 hold (0,0) and (2,1), every row has room for one more entry
+    cusp::coo_matrix<int, float, cusp::host_memory> A(3, 3, 2);
+    A.row_indices[0] = 0; A.column_indices[0] = 0; A.values[0] = 1;
+    A.row_indices[1] = 2; A.column_indices[1] = 1; A.values[1] = 2;
+
+    cusp::dynamic_csr_matrix<int, float, Space> B;
+    B.slack         = 0.0f;
+    B.min_row_slack = 1;
+    B = A;
+
+    ASSERT_EQUAL(B.capacity(), 5);
+
+    cusp::array1d<int, cusp::host_memory>   rows(6);
+    cusp::array1d<int, cusp::host_memory>   cols(6);
+    cusp::array1d<float, cusp::host_memory> vals(6);
+
+    // (2,1) is replaced, (1,2) is inserted twice, the last value wins
+    rows[0] = 2; cols[0] = 1; vals[0] = 5;
+    rows[1] = 1; cols[1] = 2; vals[1] = 3;
+    rows[2] = 2; cols[2] = 0; vals[2] = 4;
+    rows[3] = 1; cols[3] = 2; vals[3] = 6;
+    // row 0 outgrows its capacity
+    rows[4] = 0; cols[4] = 2; vals[4] = 7;
+    rows[5] = 0; cols[5] = 1; vals[5] = 8;
+
+    B.insert(rows, cols, vals);
+
+    ASSERT_EQUAL(B.num_entries, 6);
+    ASSERT_EQUAL(B.row_lengths[0], 3);
+    ASSERT_EQUAL(B.row_lengths[1], 1);
+    ASSERT_EQUAL(B.row_lengths[2], 2);
+
+    cusp::csr_matrix<int, float, Space> C(B);
+
+    ASSERT_EQUAL(C.row_offsets[0], 0);
+    ASSERT_EQUAL(C.row_offsets[1], 3);
+    ASSERT_EQUAL(C.row_offsets[2], 4);
+    ASSERT_EQUAL(C.row_offsets[3], 6);
+
+    ASSERT_EQUAL(C.column_indices[0], 0); ASSERT_EQUAL(C.values[0], 1);
+    ASSERT_EQUAL(C.column_indices[1], 1); ASSERT_EQUAL(C.values[1], 8);
+    ASSERT_EQUAL(C.column_indices[2], 2); ASSERT_EQUAL(C.values[2], 7);
+    ASSERT_EQUAL(C.column_indices[3], 2); ASSERT_EQUAL(C.values[3], 6);
+    ASSERT_EQUAL(C.column_indices[4], 0); ASSERT_EQUAL(C.values[4], 4);
+    ASSERT_EQUAL(C.column_indices[5], 1); ASSERT_EQUAL(C.values[5], 5);
+
+    // entries outside the matrix are rejected
+    rows.resize(1); cols.resize(1); vals.resize(1);
+    rows[0] = 3; cols[0] = 0;
+
+    ASSERT_THROWS(B.insert(rows, cols, vals), cusp::invalid_input_exception);
+}
+DECLARE_HOST_DEVICE_UNITTEST(TestDynamicCsrMatrixInsert);
+
+template <class Space>
+void TestDynamicCsrMatrixErase(void)
+{
+    cusp::csr_matrix<int, float, Space> A;
+    cusp::gallery::poisson5pt(A, 3, 3);
+
+    cusp::dynamic_csr_matrix<int, float, Space> B(A);
+
+    const size_t capacity = B.capacity();
+
+    cusp::array1d<int, cusp::host_memory> rows(4);
+    cusp::array1d<int, cusp::host_memory> cols(4);
+
+    // (0,2) is not stored and row 9 lies outside the matrix
+    rows[0] = 4; cols[0] = 1;
+    rows[1] = 4; cols[1] = 7;
+    rows[2] = 0; cols[2] = 2;
+    rows[3] = 9; cols[3] = 0;
+
+    B.erase(rows, cols);
+
+    ASSERT_EQUAL(B.num_entries, A.num_entries - 2);
+    ASSERT_EQUAL(B.capacity(), capacity);
+    ASSERT_EQUAL(B.row_lengths[4], 3);
+
+    cusp::csr_matrix<int, float, Space> C(B);
+
+    ASSERT_EQUAL(C.row_offsets[5] - C.row_offsets[4], 3);
+    ASSERT_EQUAL(C.column_indices[C.row_offsets[4] + 0], 3);
+    ASSERT_EQUAL(C.column_indices[C.row_offsets[4] + 1], 4);
+    ASSERT_EQUAL(C.column_indices[C.row_offsets[4] + 2], 5);
+
+    // rebalance releases the free slots of the emptied row
+    B.slack         = 0.0f;
+    B.min_row_slack = 0;
+    B.rebalance();
+
+    ASSERT_EQUAL(B.capacity(), B.num_entries);
+
+    cusp::csr_matrix<int, float, Space> D(B);
+
+    ASSERT_EQUAL(D.row_offsets,    C.row_offsets);
+    ASSERT_EQUAL(D.column_indices, C.column_indices);
+    ASSERT_EQUAL(D.values,         C.values);
+}
+DECLARE_HOST_DEVICE_UNITTEST(TestDynamicCsrMatrixErase);
+
+template <class MemorySpace>
+void TestDynamicCsrMatrixVectorMultiply(void)
+{
+    cusp::csr_matrix<int, float, MemorySpace> A;
+    cusp::gallery::random(A, 100, 80, 700);
+
+    cusp::dynamic_csr_matrix<int, float, MemorySpace> B(A);
+
+    // grow some rows past their capacity
+    cusp::array1d<int, cusp::host_memory>   rows(40);
+    cusp::array1d<int, cusp::host_memory>   cols(40);
+    cusp::array1d<float, cusp::host_memory> vals(40);
+
+    for(int n = 0; n < 40; n++)
+    {
+        rows[n] = (n * 7) % 10;
+        cols[n] = (n * 13) % 80;
+        vals[n] = n % 3 + 1;
+    }
+
+    B.insert(rows, cols, vals);
+
+    cusp::csr_matrix<int, float, MemorySpace> C(B);
+
+    cusp::array1d<float, MemorySpace> x(A.num_cols);
+    for(size_t i = 0; i < A.num_cols; i++)
+        x[i] = i % 5;
+
+    cusp::array1d<float, MemorySpace> y(A.num_rows, 10);
+    cusp::array1d<float, MemorySpace> z(A.num_rows, 10);
+
+    cusp::multiply(C, x, y);
+    cusp::multiply(B, x, z);
+
+    ASSERT_EQUAL(z, y);
+}
+DECLARE_HOST_DEVICE_UNITTEST(TestDynamicCsrMatrixVectorMultiply);
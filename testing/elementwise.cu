@@ -181,6 +181,94 @@ void TestSubtract(void)
 }
 DECLARE_SPARSE_MATRIX_UNITTEST(TestSubtract);
 
+template <class MemorySpace>
+void TestAddUnsortedRows(void)
+{
+    // row 0 is unsorted and row 2 contains a duplicate entry
+    cusp::csr_matrix<int, float, cusp::host_memory> A(3, 4, 6);
+    A.row_offsets[0] = 0;
+    A.row_offsets[1] = 2;
+    A.row_offsets[2] = 3;
+    A.row_offsets[3] = 6;
+    A.column_indices[0] = 3; A.values[0] = 1;
+    A.column_indices[1] = 0; A.values[1] = 2;
+    A.column_indices[2] = 1; A.values[2] = 3;
+    A.column_indices[3] = 2; A.values[3] = 4;
+    A.column_indices[4] = 2; A.values[4] = 5;
+    A.column_indices[5] = 3; A.values[5] = 6;
+
+    cusp::array2d<float, cusp::host_memory> dense_A(3, 4, 0);
+    dense_A(0,3) = 1; dense_A(0,0) = 2; dense_A(1,1) = 3; dense_A(2,2) = 9; dense_A(2,3) = 6;
+
+    cusp::array2d<float, cusp::host_memory> dense_B(3, 4, 0);
+    dense_B(0,0) = 1; dense_B(0,1) = 2; dense_B(1,1) = -3; dense_B(2,0) = 4; dense_B(2,3) = 5;
+
+    cusp::csr_matrix<int, float, MemorySpace> _A(A), _B(dense_B), _C;
+    cusp::add(_A, _B, _C);
+
+    cusp::array2d<float, cusp::host_memory> expected;
+    cusp::add(dense_A, dense_B, expected);
+
+    ASSERT_EQUAL(cusp::array2d<float, cusp::host_memory>(_C) == expected, true);
+}
+DECLARE_HOST_DEVICE_UNITTEST(TestAddUnsortedRows);
+
+template <typename SparseMatrix>
+void _TestAddSymbolicNumeric(void)
+{
+    typedef typename SparseMatrix::memory_space MemorySpace;
+    typedef cusp::array2d<float, cusp::host_memory> DenseMatrix;
+
+    cusp::csr_matrix<int, float, cusp::host_memory> A_host, M_host;
+    cusp::gallery::poisson5pt(A_host, 5, 4);
+    cusp::gallery::poisson9pt(M_host, 5, 4);
+
+    for(size_t n = 0; n < M_host.num_entries; n++)
+        M_host.values[n] = float(n % 5) + 1;
+
+    SparseMatrix A(A_host), M(M_host), C;
+    cusp::add_plan<int, MemorySpace> plan;
+
+    cusp::add_symbolic(A, M, C, plan);
+
+    ASSERT_EQUAL(C.num_rows, A.num_rows);
+    ASSERT_EQUAL(C.num_cols, A.num_cols);
+    ASSERT_EQUAL(C.num_entries, M.num_entries);
+
+    for(int step = 0; step < 3; step++)
+    {
+        float sigma = 0.5f * step;
+
+        cusp::add_numeric(A, M, C, plan, 1.0f, -sigma);
+
+        DenseMatrix dense_A(A), dense_M(M), expected(A.num_rows, A.num_cols);
+        for(size_t i = 0; i < expected.num_rows; i++)
+            for(size_t j = 0; j < expected.num_cols; j++)
+                expected(i,j) = dense_A(i,j) - sigma * dense_M(i,j);
+
+        // the pattern is kept even where entries cancel out
+        ASSERT_EQUAL(C.num_entries, M.num_entries);
+        ASSERT_EQUAL(DenseMatrix(C) == expected, true);
+
+        // change the values of A but not its pattern
+        for(size_t n = 0; n < A_host.num_entries; n++)
+            A_host.values[n] = float(n % 7) - 3;
+        A = A_host;
+    }
+
+    // the plan does not apply to a different pattern
+    SparseMatrix B(cusp::csr_matrix<int, float, cusp::host_memory>(A_host.num_rows, A_host.num_cols, 0));
+    ASSERT_THROWS(cusp::add_numeric(A, B, C, plan, 1.0f, 1.0f), cusp::invalid_input_exception);
+}
+
+template <class MemorySpace>
+void TestAddSymbolicNumeric(void)
+{
+    _TestAddSymbolicNumeric< cusp::csr_matrix<int, float, MemorySpace> >();
+    _TestAddSymbolicNumeric< cusp::coo_matrix<int, float, MemorySpace> >();
+}
+DECLARE_HOST_DEVICE_UNITTEST(TestAddSymbolicNumeric);
+
 template <typename MatrixType1, typename MatrixType2, typename MatrixType3, typename BinaryFunction>
 void elementwise(my_system& system, const MatrixType1& A, const MatrixType2& B, MatrixType3& C, BinaryFunction op)
 {
@@ -0,0 +1,190 @@
+#include <unittest/unittest.h>
+
+#include <cusp/equilibrate.h>
+
+#include <cusp/array1d.h>
+#include <cusp/array2d.h>
+#include <cusp/coo_matrix.h>
+#include <cusp/csr_matrix.h>
+#include <cusp/dia_matrix.h>
+#include <cusp/ell_matrix.h>
+#include <cusp/hyb_matrix.h>
+#include <cusp/linear_operator.h>
+#include <cusp/monitor.h>
+#include <cusp/multiply.h>
+
+#include <cusp/gallery/poisson.h>
+#include <cusp/krylov/cg.h>
+#include <cusp/krylov/equilibrated_solve.h>
+
+#include <algorithm>
+#include <cmath>
+
+// a Poisson matrix whose rows and columns are scaled over six orders of magnitude
+cusp::csr_matrix<int, double, cusp::host_memory> BadlyScaled(const int n)
+{
+    cusp::csr_matrix<int, double, cusp::host_memory> A;
+    cusp::gallery::poisson5pt(A, n, n);
+
+    for(size_t i = 0; i < A.num_rows; i++)
+        for(int jj = A.row_offsets[i]; jj < A.row_offsets[i + 1]; jj++)
+            A.values[jj] *= std::pow(10.0, double(i % 7) - 3) * std::pow(10.0, double(A.column_indices[jj] % 5) - 2);
+
+    return A;
+}
+
+template <typename MatrixType>
+void _TestScaleRowsColumns(void)
+{
+    typedef typename MatrixType::memory_space MemorySpace;
+
+    cusp::csr_matrix<int, double, cusp::host_memory> A;
+    cusp::gallery::poisson5pt(A, 6, 5);
+
+    cusp::array1d<double, cusp::host_memory> r(A.num_rows);
+    cusp::array1d<double, cusp::host_memory> c(A.num_cols);
+    for(size_t i = 0; i < r.size(); i++)
+    {
+        r[i] = 1 + i % 4;
+        c[i] = 0.5 * (1 + i % 3);
+    }
+
+    cusp::array2d<double, cusp::host_memory> expected(A);
+    for(size_t i = 0; i < A.num_rows; i++)
+        for(size_t j = 0; j < A.num_cols; j++)
+            expected(i, j) *= r[i] * c[j];
+
+    MatrixType B(A);
+    cusp::array1d<double, MemorySpace> d_r(r);
+    cusp::array1d<double, MemorySpace> d_c(c);
+
+    cusp::scale_rows(B, d_r);
+    cusp::scale_columns(B, d_c);
+
+    cusp::array2d<double, cusp::host_memory> result(B);
+
+    ASSERT_ALMOST_EQUAL(result.values, expected.values);
+}
+
+template <class MemorySpace>
+void TestScaleRowsColumns(void)
+{
+    _TestScaleRowsColumns< cusp::coo_matrix<int, double, MemorySpace> >();
+    _TestScaleRowsColumns< cusp::csr_matrix<int, double, MemorySpace> >();
+    _TestScaleRowsColumns< cusp::dia_matrix<int, double, MemorySpace> >();
+    _TestScaleRowsColumns< cusp::ell_matrix<int, double, MemorySpace> >();
+    _TestScaleRowsColumns< cusp::hyb_matrix<int, double, MemorySpace> >();
+}
+DECLARE_HOST_DEVICE_UNITTEST(TestScaleRowsColumns);
+
+template <class MemorySpace>
+void TestEquilibrateRuiz(void)
+{
+    cusp::csr_matrix<int, double, cusp::host_memory> A0 = BadlyScaled(12);
+    cusp::hyb_matrix<int, double, MemorySpace> A(A0);
+
+    cusp::array1d<double, MemorySpace> r;
+    cusp::array1d<double, MemorySpace> c;
+
+    cusp::equilibrate(A, r, c, cusp::ruiz_equilibration, 30);
+
+    ASSERT_EQUAL(r.size(), A.num_rows);
+    ASSERT_EQUAL(c.size(), A.num_cols);
+
+    // every row and column has a max-norm close to one
+    cusp::array2d<double, cusp::host_memory> B(A);
+    cusp::array1d<double, cusp::host_memory> row_max(B.num_rows, 0);
+    cusp::array1d<double, cusp::host_memory> column_max(B.num_cols, 0);
+
+    for(size_t i = 0; i < B.num_rows; i++)
+        for(size_t j = 0; j < B.num_cols; j++)
+        {
+            row_max[i]    = std::max(row_max[i], std::abs(B(i, j)));
+            column_max[j] = std::max(column_max[j], std::abs(B(i, j)));
+        }
+
+    for(size_t i = 0; i < B.num_rows; i++)
+    {
+        ASSERT_EQUAL(std::abs(row_max[i] - 1) < 0.02, true);
+        ASSERT_EQUAL(std::abs(column_max[i] - 1) < 0.02, true);
+    }
+
+    // the factors reproduce the equilibrated matrix
+    cusp::array1d<double, cusp::host_memory> h_r(r);
+    cusp::array1d<double, cusp::host_memory> h_c(c);
+    cusp::array2d<double, cusp::host_memory> expected(A0);
+
+    for(size_t i = 0; i < B.num_rows; i++)
+        for(size_t j = 0; j < B.num_cols; j++)
+            expected(i, j) *= h_r[i] * h_c[j];
+
+    ASSERT_ALMOST_EQUAL(B.values, expected.values);
+}
+DECLARE_HOST_DEVICE_UNITTEST(TestEquilibrateRuiz);
+
+template <class MemorySpace>
+void TestEquilibrateJacobi(void)
+{
+    cusp::csr_matrix<int, double, cusp::host_memory> P;
+    cusp::gallery::poisson5pt(P, 10, 10);
+
+    // symmetric scaling keeps the matrix SPD
+    cusp::array1d<double, cusp::host_memory> s(P.num_rows);
+    for(size_t i = 0; i < s.size(); i++)
+        s[i] = std::pow(10.0, double(i % 5) - 2);
+
+    cusp::csr_matrix<int, double, MemorySpace> A0(P);
+    cusp::array1d<double, MemorySpace> d_s(s);
+    cusp::scale_rows(A0, d_s);
+    cusp::scale_columns(A0, d_s);
+
+    cusp::csr_matrix<int, double, MemorySpace> A(A0);
+    cusp::array1d<double, MemorySpace> r;
+    cusp::array1d<double, MemorySpace> c;
+
+    cusp::equilibrate(A, r, c, cusp::jacobi_equilibration);
+
+    ASSERT_EQUAL(r, c);
+
+    cusp::array1d<double, MemorySpace> diagonal(A.num_rows);
+    cusp::extract_diagonal(A, diagonal);
+
+    cusp::array1d<double, MemorySpace> ones(A.num_rows, 1);
+    ASSERT_ALMOST_EQUAL(diagonal, ones);
+
+    // the solution of the original system through the equilibrated one
+    cusp::array1d<double, MemorySpace> x(A.num_rows, 0);
+    cusp::array1d<double, MemorySpace> b(A.num_rows, 1);
+
+    cusp::krylov::cg_solver<double, MemorySpace> solver(A.num_rows);
+    cusp::identity_operator<double, MemorySpace> M(A.num_rows, A.num_cols);
+    cusp::monitor<double> monitor(b, 200, 1e-10);
+
+    cusp::krylov::equilibrated_solve(A, x, b, r, c, solver, monitor, M);
+
+    ASSERT_EQUAL(monitor.converged(), true);
+
+    cusp::array1d<double, MemorySpace> y(A.num_rows);
+    cusp::multiply(A0, x, y);
+
+    ASSERT_ALMOST_EQUAL(y, b);
+}
+DECLARE_HOST_DEVICE_UNITTEST(TestEquilibrateJacobi);
+
+void TestEquilibrateInvalidInput(void)
+{
+    cusp::csr_matrix<int, double, cusp::host_memory> A;
+    cusp::gallery::poisson5pt(A, 4, 4);
+
+    cusp::array1d<double, cusp::host_memory> s(A.num_rows - 1, 1);
+
+    ASSERT_THROWS(cusp::scale_rows(A, s), cusp::invalid_input_exception);
+    ASSERT_THROWS(cusp::scale_columns(A, s), cusp::invalid_input_exception);
+
+    cusp::csr_matrix<int, double, cusp::host_memory> B(3, 4, 0);
+    cusp::array1d<double, cusp::host_memory> r;
+    cusp::array1d<double, cusp::host_memory> c;
+
+    ASSERT_THROWS(cusp::equilibrate(B, r, c, cusp::jacobi_equilibration), cusp::invalid_input_exception);
+}
+DECLARE_UNITTEST(TestEquilibrateInvalidInput);
@@ -0,0 +1,76 @@
+#include <unittest/unittest.h>
+
+#include <cusp/array1d.h>
+#include <cusp/array2d.h>
+#include <cusp/csr_matrix.h>
+#include <cusp/multiply.h>
+
+#include <cusp/blas/blas.h>
+#include <cusp/eigen/block_lanczos.h>
+#include <cusp/gallery/poisson.h>
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+template<typename ValueType>
+void TestBlockLanczos(void)
+{
+    const int n = 10;
+
+    cusp::csr_matrix<int, ValueType, cusp::host_memory> A;
+    cusp::gallery::poisson5pt(A, n, n);
+
+    // the eigenvalues of the 5-point Laplacian are known in closed form
+    std::vector<double> exact;
+    for (int i = 1; i <= n; i++)
+        for (int j = 1; j <= n; j++)
+            exact.push_back(4.0 - 2.0 * std::cos(M_PI * i / (n + 1)) - 2.0 * std::cos(M_PI * j / (n + 1)));
+    std::sort(exact.begin(), exact.end());
+
+    cusp::eigen::lanczos_options<ValueType> options;
+    options.tol            = 1e-4;
+    options.blockSize      = 3;
+    options.computeEigVecs = true;
+
+    // smallest eigenpairs, including the multiple ones
+    {
+        cusp::array1d<ValueType, cusp::host_memory> eigVals(6, 0);
+        cusp::array2d<ValueType, cusp::host_memory, cusp::column_major> eigVecs;
+
+        options.eigPart = cusp::eigen::SA;
+        cusp::eigen::block_lanczos(A, eigVals, eigVecs, options);
+
+        ASSERT_EQUAL(eigVecs.num_rows, A.num_rows);
+        ASSERT_EQUAL(eigVecs.num_cols, 6);
+
+        for (size_t i = 0; i < 6; i++)
+        {
+            ASSERT_LEQUAL(std::abs(eigVals[i] - exact[i]), 1e-3);
+
+            cusp::array1d<ValueType, cusp::host_memory> x(eigVecs.column(i));
+            cusp::array1d<ValueType, cusp::host_memory> Ax(A.num_rows);
+            cusp::multiply(A, x, Ax);
+            cusp::blas::axpy(x, Ax, -eigVals[i]);
+
+            ASSERT_LEQUAL(cusp::blas::nrm2(Ax), 1e-2);
+            ASSERT_LEQUAL(std::abs(cusp::blas::nrm2(x) - 1), 1e-3);
+        }
+    }
+
+    // largest eigenvalues only
+    {
+        cusp::array1d<ValueType, cusp::host_memory> eigVals(4, 0);
+
+        cusp::eigen::lanczos_options<ValueType> opts(options);
+        opts.eigPart        = cusp::eigen::LA;
+        opts.computeEigVecs = false;
+
+        cusp::array2d<ValueType, cusp::host_memory, cusp::column_major> eigVecs;
+        cusp::eigen::block_lanczos(A, eigVals, eigVecs, opts);
+
+        for (size_t i = 0; i < 4; i++)
+            ASSERT_LEQUAL(std::abs(eigVals[i] - exact[exact.size() - 4 + i]), 1e-3);
+    }
+}
+DECLARE_REAL_UNITTEST(TestBlockLanczos);
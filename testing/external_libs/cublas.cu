@@ -2,8 +2,10 @@
 
 #include <cusp/array2d.h>
 #include <cusp/blas/blas.h>
+#include <cusp/multiply.h>
 #include <cusp/gallery/poisson.h>
 
+#include <cusp/system/cuda/cublas_handles.h>
 #include <cusp/system/cuda/detail/cublas/blas.h>
 
 template<typename ValueType>
@@ -123,6 +125,54 @@ void TestCublasAxpy(void)
 }
 DECLARE_NUMERIC_UNITTEST(TestCublasAxpy);
 
+template<typename ValueType>
+void TestCublasAxpyOnStream(void)
+{
+    typedef cusp::array1d<ValueType, cusp::device_memory>  Array;
+
+    cublasHandle_t handle;
+
+    if(cublasCreate(&handle) != CUBLAS_STATUS_SUCCESS)
+    {
+      throw cusp::runtime_exception("cublasCreate failed");
+    }
+
+    cudaStream_t s;
+    cudaStreamCreate(&s);
+
+    Array x(4);
+    Array y(4);
+
+    x[0] =  7.0f;
+    y[0] =  0.0f;
+    x[1] =  5.0f;
+    y[1] = -2.0f;
+    x[2] =  4.0f;
+    y[2] =  0.0f;
+    x[3] = -3.0f;
+    y[3] =  5.0f;
+
+    cusp::blas::axpy(cusp::cuda::par.on(s).with(handle), x, y, 2.0f);
+    cudaStreamSynchronize(s);
+
+    ASSERT_EQUAL(y[0],  14.0);
+    ASSERT_EQUAL(y[1],   8.0);
+    ASSERT_EQUAL(y[2],   8.0);
+    ASSERT_EQUAL(y[3],  -1.0);
+
+    cudaStream_t handle_stream;
+    cublasGetStream(handle, &handle_stream);
+    ASSERT_EQUAL(handle_stream == s, true);
+
+    cudaStreamDestroy(s);
+
+    if(cublasDestroy(handle) != CUBLAS_STATUS_SUCCESS)
+    {
+      throw cusp::runtime_exception("cublasDestroy failed");
+    }
+}
+DECLARE_NUMERIC_UNITTEST(TestCublasAxpyOnStream);
+
 template<typename ValueType>
 void TestCublasCopy(void)
 {
@@ -549,3 +599,104 @@ void TestCublasGemm(void)
 }
 DECLARE_REAL_UNITTEST(TestCublasGemm);
 
+
+void TestCublasHandlePool(void)
+{
+    cudaStream_t s;
+    cudaStreamCreate(&s);
+
+    cublasHandle_t h0 = cusp::system::cuda::cublas_handle();
+    cublasHandle_t h1 = cusp::system::cuda::cublas_handle(s);
+
+    // one handle per stream, bound to it
+    ASSERT_EQUAL(h0 == cusp::system::cuda::cublas_handle(), true);
+    ASSERT_EQUAL(h1 == cusp::system::cuda::cublas_handle(s), true);
+    ASSERT_EQUAL(h0 == h1, false);
+
+    cudaStream_t bound;
+    cublasGetStream(h1, &bound);
+    ASSERT_EQUAL(bound == s, true);
+
+    cusp::system::cuda::clear_cublas_handles();
+    cudaStreamDestroy(s);
+}
+DECLARE_UNITTEST(TestCublasHandlePool);
+
+template<typename ValueType>
+void TestCublasPooledLevel1(void)
+{
+    typedef cusp::array1d<ValueType, cusp::device_memory> Array;
+
+    Array x(4);
+    Array y(4);
+
+    x[0] =  7.0f; y[0] =  0.0f;
+    x[1] =  5.0f; y[1] = -2.0f;
+    x[2] =  4.0f; y[2] =  1.0f;
+    x[3] = -3.0f; y[3] =  0.0f;
+
+    // the plain policies use the pooled handles
+    ASSERT_EQUAL(cusp::blas::dot(x, y), -6.0f);
+    ASSERT_EQUAL(cusp::blas::amax(x), 0);
+
+    cudaStream_t s;
+    cudaStreamCreate(&s);
+
+    cusp::blas::axpy(cusp::cuda::par.on(s), x, y, ValueType(2));
+    cudaStreamSynchronize(s);
+
+    ASSERT_EQUAL(y[0],  14.0f);
+    ASSERT_EQUAL(y[1],   8.0f);
+    ASSERT_EQUAL(y[2],   9.0f);
+    ASSERT_EQUAL(y[3],  -6.0f);
+
+    cusp::system::cuda::clear_cublas_handles();
+    cudaStreamDestroy(s);
+}
+DECLARE_REAL_UNITTEST(TestCublasPooledLevel1);
+
+template<typename ValueType, typename Orientation>
+void TestCublasPooledGemmOrientation(void)
+{
+    typedef cusp::array2d<ValueType, cusp::device_memory, Orientation> Array2dDev;
+    typedef typename Array2dDev::rebind<cusp::host_memory>::type       Array2dHost;
+
+    Array2dDev A(3, 4);
+    Array2dDev B(4, 3);
+
+    cusp::counting_array<ValueType> init_values(A.num_entries, 1);
+    A.values = init_values;
+    B.values = init_values;
+
+    Array2dHost A_h(A);
+    Array2dHost B_h(B);
+
+    Array2dHost C_h(A.num_rows, B.num_cols);
+    cusp::blas::gemm(A_h, B_h, C_h);
+
+    Array2dDev C(A.num_rows, B.num_cols);
+    cusp::blas::gemm(A, B, C);
+    ASSERT_EQUAL(C_h.values, C.values);
+
+    // dense products of cusp::multiply
+    Array2dDev D(A.num_rows, B.num_cols);
+    cusp::multiply(A, B, D);
+    ASSERT_EQUAL(C_h.values, D.values);
+
+    cusp::array1d<ValueType, cusp::device_memory> x(A.num_cols, ValueType(1));
+    cusp::array1d<ValueType, cusp::device_memory> y(A.num_rows, ValueType(-1));
+    cusp::multiply(A, x, y);
+
+    cusp::array1d<ValueType, cusp::host_memory> y_h(A.num_rows, ValueType(0));
+    cusp::array1d<ValueType, cusp::host_memory> x_h(x);
+    cusp::multiply(A_h, x_h, y_h);
+    ASSERT_EQUAL(y_h, y);
+}
+
+template<typename ValueType>
+void TestCublasPooledGemm(void)
+{
+    TestCublasPooledGemmOrientation<ValueType,cusp::row_major>();
+    TestCublasPooledGemmOrientation<ValueType,cusp::column_major>();
+}
+DECLARE_REAL_UNITTEST(TestCublasPooledGemm);
@@ -0,0 +1,175 @@
+#include <unittest/unittest.h>
+
+#include <cusp/array1d.h>
+#include <cusp/array2d.h>
+#include <cusp/blas/blas.h>
+#include <cusp/csr_matrix.h>
+#include <cusp/functional.h>
+#include <cusp/multiply.h>
+#include <cusp/gallery/poisson.h>
+
+#include <cusp/system/cuda/cusparse.h>
+
+template <typename ValueType>
+cusp::array1d<ValueType, cusp::device_memory> TestVector(const size_t n)
+{
+    cusp::array1d<ValueType, cusp::host_memory> x(n);
+
+    for (size_t i = 0; i < n; i++)
+        x[i] = ValueType(int(i % 7) - 3);
+
+    return cusp::array1d<ValueType, cusp::device_memory>(x);
+}
+
+template<typename ValueType>
+void TestCusparseMultiply(void)
+{
+    typedef cusp::csr_matrix<int, ValueType, cusp::device_memory> Matrix;
+    typedef cusp::array1d<ValueType, cusp::device_memory>         Array;
+
+    Matrix A;
+    cusp::gallery::poisson5pt(A, 20, 15);
+
+    Array x = TestVector<ValueType>(A.num_cols);
+    Array expected(A.num_rows);
+    cusp::multiply(A, x, expected);
+
+    cusp::cuda::cusparse_csr_matrix<ValueType> S(A);
+
+    // repeated products reuse the cached descriptors and workspace
+    Array y(A.num_rows, ValueType(5));
+    cusp::multiply(S, x, y);
+    ASSERT_ALMOST_EQUAL(y, expected);
+
+    cusp::multiply(S, x, y);
+    ASSERT_ALMOST_EQUAL(y, expected);
+
+    // a second stream gets its own handle and workspace
+    cudaStream_t s;
+    cudaStreamCreate(&s);
+
+    Array z(A.num_rows);
+    cusp::multiply(cusp::cuda::par.on(s), S, x, z);
+    cudaStreamSynchronize(s);
+    ASSERT_ALMOST_EQUAL(z, expected);
+
+    // a handle of the application with plain and cusparse matrices
+    cusparseHandle_t handle;
+
+    if(cusparseCreate(&handle) != CUSPARSE_STATUS_SUCCESS)
+    {
+      throw cusp::runtime_exception("cusparseCreate failed");
+    }
+
+    cusp::blas::fill(z, ValueType(0));
+    cusp::multiply(cusp::cuda::par.with(handle), A, x, z);
+    ASSERT_ALMOST_EQUAL(z, expected);
+
+    cusp::blas::fill(z, ValueType(0));
+    cusp::multiply(cusp::cuda::par.on(s).with(handle), S, x, z);
+    cudaStreamSynchronize(s);
+    ASSERT_ALMOST_EQUAL(z, expected);
+
+    // y = y + A * x through beta
+    Array w(A.num_rows, ValueType(1));
+    cusp::multiply(S, x, w, thrust::identity<ValueType>(), thrust::multiplies<ValueType>(), thrust::plus<ValueType>());
+    cusp::blas::axpy(Array(A.num_rows, ValueType(1)), expected, ValueType(1));
+    ASSERT_ALMOST_EQUAL(w, expected);
+
+    // other semirings use the cusp kernels
+    Array m(A.num_rows), m_expected(A.num_rows);
+    cusp::multiply(A, x, m_expected, cusp::constant_functor<ValueType>(0), thrust::multiplies<ValueType>(), thrust::maximum<ValueType>());
+    cusp::multiply(S, x, m, cusp::constant_functor<ValueType>(0), thrust::multiplies<ValueType>(), thrust::maximum<ValueType>());
+    ASSERT_EQUAL(m, m_expected);
+
+    cudaStreamDestroy(s);
+
+    if(cusparseDestroy(handle) != CUSPARSE_STATUS_SUCCESS)
+    {
+      throw cusp::runtime_exception("cusparseDestroy failed");
+    }
+}
+DECLARE_REAL_UNITTEST(TestCusparseMultiply);
+
+template<typename ValueType, typename Orientation>
+void _TestCusparseMultiplyDense(void)
+{
+    typedef cusp::csr_matrix<int, ValueType, cusp::device_memory>        Matrix;
+    typedef cusp::array2d<ValueType, cusp::host_memory, Orientation>     HostArray2d;
+    typedef cusp::array2d<ValueType, cusp::device_memory, Orientation>   Array2d;
+
+    Matrix A;
+    cusp::gallery::poisson5pt(A, 12, 10);
+
+    HostArray2d h_X(A.num_cols, 3);
+    for (size_t i = 0; i < h_X.num_rows; i++)
+        for (size_t j = 0; j < h_X.num_cols; j++)
+            h_X(i, j) = ValueType(int((i + 2 * j) % 5) - 2);
+
+    Array2d X(h_X);
+    Array2d expected(A.num_rows, 3);
+    cusp::multiply(A, X, expected);
+
+    cusp::cuda::cusparse_csr_matrix<ValueType> S(A);
+
+    Array2d Y(A.num_rows, 3, ValueType(-1));
+    cusp::multiply(S, X, Y);
+    ASSERT_ALMOST_EQUAL(Y.values, expected.values);
+
+    cusp::multiply(S, X, Y);
+    ASSERT_ALMOST_EQUAL(Y.values, expected.values);
+}
+
+template<typename ValueType>
+void TestCusparseMultiplyDense(void)
+{
+    _TestCusparseMultiplyDense<ValueType, cusp::column_major>();
+    _TestCusparseMultiplyDense<ValueType, cusp::row_major>();
+}
+DECLARE_REAL_UNITTEST(TestCusparseMultiplyDense);
+
+template<typename ValueType>
+void TestCusparseSpGEMM(void)
+{
+    typedef cusp::csr_matrix<int, ValueType, cusp::device_memory> Matrix;
+
+    Matrix A, B;
+    cusp::gallery::poisson5pt(A, 9, 11);
+    cusp::gallery::poisson9pt(B, 9, 11);
+
+    Matrix expected;
+    cusp::multiply(A, B, expected);
+
+    cusparseHandle_t handle;
+
+    if(cusparseCreate(&handle) != CUSPARSE_STATUS_SUCCESS)
+    {
+      throw cusp::runtime_exception("cusparseCreate failed");
+    }
+
+    Matrix C;
+    cusp::multiply(cusp::cuda::par.with(handle), A, B, C);
+
+    // compare the dense forms, the order of the columns within a row and
+    // the entries which cancel out are left to cusparse
+    cusp::array2d<ValueType, cusp::host_memory> D(C), D_expected(expected);
+
+    ASSERT_EQUAL(C.num_rows, expected.num_rows);
+    ASSERT_EQUAL(C.num_cols, expected.num_cols);
+    ASSERT_ALMOST_EQUAL(D.values, D_expected.values);
+
+    // operands with cached descriptors
+    cusp::cuda::cusparse_csr_matrix<ValueType> S(A);
+
+    Matrix E;
+    cusp::multiply(cusp::cuda::par.with(handle), S, B, E);
+
+    cusp::array2d<ValueType, cusp::host_memory> D_E(E);
+    ASSERT_ALMOST_EQUAL(D_E.values, D_expected.values);
+
+    if(cusparseDestroy(handle) != CUSPARSE_STATUS_SUCCESS)
+    {
+      throw cusp::runtime_exception("cusparseDestroy failed");
+    }
+}
+DECLARE_REAL_UNITTEST(TestCusparseSpGEMM);
@@ -0,0 +1,364 @@
+#include <unittest/unittest.h>
+
+#include <cusp/csr_matrix.h>
+#include <cusp/linear_operator.h>
+#include <cusp/monitor.h>
+#include <cusp/multiply.h>
+
+#include <cusp/distributed/array1d.h>
+#include <cusp/distributed/csr_matrix.h>
+#include <cusp/distributed/smoothed_aggregation.h>
+#include <cusp/gallery/poisson.h>
+#include <cusp/krylov/cg.h>
+#include <cusp/krylov/gmres.h>
+#include <cusp/krylov/pipelined_bicgstab.h>
+#include <cusp/krylov/pipelined_cg.h>
+#include <cusp/precond/diagonal.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+
+// every rank runs the tests, started by mpirun or as a single process
+void FinalizeMPI(void)
+{
+    MPI_Finalize();
+}
+
+void InitializeMPI(void)
+{
+    int initialized = 0;
+    MPI_Initialized(&initialized);
+
+    if (!initialized)
+    {
+        MPI_Init(NULL, NULL);
+        std::atexit(FinalizeMPI);
+    }
+}
+
+template <typename MemorySpace>
+struct distributed_policy
+{
+    typedef cusp::distributed::device_policy type;
+    static type make(MPI_Comm comm) { return cusp::distributed::device_par(comm); }
+};
+
+template <>
+struct distributed_policy<cusp::host_memory>
+{
+    typedef cusp::distributed::host_policy type;
+    static type make(MPI_Comm comm) { return cusp::distributed::host_par(comm); }
+};
+
+template <class MemorySpace>
+void TestDistributedCsrMatrixMultiply(void)
+{
+    InitializeMPI();
+
+    cusp::csr_matrix<int, float, cusp::host_memory> G;
+    cusp::csr_matrix<int, float, cusp::host_memory> L;
+
+    cusp::gallery::poisson5pt(G, 12, 9);
+    cusp::distributed::local_rows(G, MPI_COMM_WORLD, L);
+
+    cusp::distributed::csr_matrix<int, float, MemorySpace> A(L, MPI_COMM_WORLD);
+
+    ASSERT_EQUAL(A.num_global_rows(), G.num_rows);
+    ASSERT_EQUAL(A.num_rows, L.num_rows);
+    ASSERT_EQUAL(A.diagonal_block.num_entries + A.off_diagonal_block.num_entries, L.num_entries);
+
+    cusp::array1d<float, cusp::host_memory> x(G.num_rows);
+    cusp::array1d<float, cusp::host_memory> y(G.num_rows);
+
+    for (size_t i = 0; i < x.size(); i++)
+        x[i] = float(i % 5) - 1.5f;
+
+    cusp::multiply(G, x, y);
+
+    const size_t first = A.first_row();
+
+    cusp::array1d<float, MemorySpace> x_local(x.begin() + first, x.begin() + first + A.num_rows);
+    cusp::array1d<float, MemorySpace> y_local(A.num_rows, 0.0f);
+
+    cusp::multiply(A, x_local, y_local);
+
+    cusp::array1d<float, cusp::host_memory> expected(y.begin() + first, y.begin() + first + A.num_rows);
+
+    ASSERT_EQUAL(y_local, expected);
+}
+DECLARE_HOST_DEVICE_UNITTEST(TestDistributedCsrMatrixMultiply)
+
+template <class MemorySpace>
+void TestDistributedBlas(void)
+{
+    InitializeMPI();
+
+    typename distributed_policy<MemorySpace>::type exec =
+        distributed_policy<MemorySpace>::make(MPI_COMM_WORLD);
+
+    int rank;
+    int size;
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    MPI_Comm_size(MPI_COMM_WORLD, &size);
+
+    // every rank owns four entries
+    cusp::array1d<float, MemorySpace> x(4, 1.0f);
+    cusp::array1d<float, MemorySpace> y(4, 2.0f);
+    x[0] = float(rank + 1);
+
+    const float n = float(size);
+    const float s = n * (n + 1) / 2;
+
+    ASSERT_EQUAL(cusp::blas::dot(exec, x, y), 2.0f * (s + 3 * n));
+    ASSERT_EQUAL(cusp::blas::asum(exec, y), 8.0f * n);
+    ASSERT_EQUAL(cusp::blas::nrmmax(exec, x), std::max(n, 1.0f));
+    ASSERT_ALMOST_EQUAL(cusp::blas::nrm2(exec, y), std::sqrt(16.0f * n));
+}
+DECLARE_HOST_DEVICE_UNITTEST(TestDistributedBlas)
+
+template <class MemorySpace>
+void TestDistributedConjugateGradient(void)
+{
+    InitializeMPI();
+
+    typename distributed_policy<MemorySpace>::type exec =
+        distributed_policy<MemorySpace>::make(MPI_COMM_WORLD);
+
+    cusp::csr_matrix<int, float, cusp::host_memory> G;
+    cusp::csr_matrix<int, float, cusp::host_memory> L;
+
+    cusp::gallery::poisson5pt(G, 10, 10);
+    cusp::distributed::local_rows(G, MPI_COMM_WORLD, L);
+
+    cusp::distributed::csr_matrix<int, float, MemorySpace> A(L, MPI_COMM_WORLD);
+
+    // serial reference
+    cusp::array1d<float, cusp::host_memory> x(G.num_rows, 0.0f);
+    cusp::array1d<float, cusp::host_memory> b(G.num_rows, 1.0f);
+    cusp::monitor<float> monitor(b, 100, 1e-5);
+
+    cusp::krylov::cg(G, x, b, monitor);
+
+    // the unmodified solver on the local rows
+    cusp::array1d<float, MemorySpace> x_local(A.num_rows, 0.0f);
+    cusp::array1d<float, MemorySpace> b_local(A.num_rows, 1.0f);
+    cusp::monitor<float> monitor_local(exec, b_local, 100, 1e-5);
+    cusp::identity_operator<float, MemorySpace> M(A.num_rows, A.num_rows);
+
+    cusp::krylov::cg(exec, A, x_local, b_local, monitor_local, M);
+
+    const size_t first = A.first_row();
+
+    cusp::array1d<float, cusp::host_memory> expected(x.begin() + first, x.begin() + first + A.num_rows);
+
+    ASSERT_EQUAL(monitor_local.converged(), true);
+    ASSERT_EQUAL(monitor_local.iteration_count(), monitor.iteration_count());
+    ASSERT_ALMOST_EQUAL(x_local, expected);
+}
+DECLARE_HOST_DEVICE_UNITTEST(TestDistributedConjugateGradient)
+
+
+template <class MemorySpace>
+void TestDistributedRectangularMultiply(void)
+{
+    InitializeMPI();
+
+    int rank;
+    int size;
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    MPI_Comm_size(MPI_COMM_WORLD, &size);
+
+    // restriction of consecutive pairs, its columns follow the fine rows
+    const size_t N = 8 * size;
+
+    cusp::csr_matrix<int, float, cusp::host_memory> R(4, N, 8);
+
+    for (size_t i = 0; i < 4; i++)
+    {
+        // the pairs are shifted so that some of them start on the next rank
+        const int first  = (8 * rank + 2 * i + 6) % N;
+        const int second = (first + 1) % N;
+
+        R.row_offsets[i]            = 2 * i;
+        R.column_indices[2 * i]     = std::min(first, second);
+        R.column_indices[2 * i + 1] = std::max(first, second);
+        R.values[2 * i]             = 1.0f;
+        R.values[2 * i + 1]         = 1.0f;
+    }
+
+    R.row_offsets[4] = 8;
+
+    cusp::distributed::csr_matrix<int, float, MemorySpace> A(R, 8, MPI_COMM_WORLD);
+
+    ASSERT_EQUAL(A.num_rows, size_t(4));
+    ASSERT_EQUAL(A.num_cols, size_t(8));
+    ASSERT_EQUAL(A.num_global_rows(), size_t(4 * size));
+    ASSERT_EQUAL(A.num_global_cols(), N);
+
+    // the local entries of x are their global indices
+    cusp::array1d<float, MemorySpace> x(8);
+    cusp::array1d<float, MemorySpace> y(4);
+
+    for (size_t i = 0; i < 8; i++)
+        x[i] = float(8 * rank + i);
+
+    cusp::multiply(A, x, y);
+
+    for (size_t i = 0; i < 4; i++)
+        ASSERT_EQUAL(float(y[i]), float(R.column_indices[2 * i] + R.column_indices[2 * i + 1]));
+}
+DECLARE_HOST_DEVICE_UNITTEST(TestDistributedRectangularMultiply)
+
+template <class MemorySpace>
+void TestDistributedSmoothedAggregation(void)
+{
+    InitializeMPI();
+
+    typename distributed_policy<MemorySpace>::type exec =
+        distributed_policy<MemorySpace>::make(MPI_COMM_WORLD);
+
+    cusp::csr_matrix<int, float, cusp::host_memory> G;
+    cusp::csr_matrix<int, float, cusp::host_memory> L;
+
+    cusp::gallery::poisson5pt(G, 40, 40);
+    cusp::distributed::local_rows(G, MPI_COMM_WORLD, L);
+
+    cusp::distributed::csr_matrix<int, float, MemorySpace> A(L, MPI_COMM_WORLD);
+
+    // small levels are gathered onto fewer ranks
+    cusp::distributed::smoothed_aggregation<int, float, MemorySpace> M(A, 0.0, 100, 32);
+
+    ASSERT_EQUAL(M.num_levels() > 2, true);
+    ASSERT_EQUAL(M.levels.back().num_active_ranks, 1);
+    ASSERT_EQUAL(M.levels.back().num_global_rows <= 32, true);
+
+    for (size_t i = 1; i < M.num_levels(); i++)
+    {
+        ASSERT_EQUAL(M.levels[i].num_global_rows  < M.levels[i - 1].num_global_rows,  true);
+        ASSERT_EQUAL(M.levels[i].num_active_ranks <= M.levels[i - 1].num_active_ranks, true);
+    }
+
+    cusp::array1d<float, MemorySpace> b(A.num_rows, 1.0f);
+    cusp::array1d<float, MemorySpace> x(A.num_rows, 0.0f);
+    cusp::array1d<float, MemorySpace> y(A.num_rows, 0.0f);
+
+    cusp::monitor<float> monitor_sa(exec, b, 200, 1e-5);
+    cusp::monitor<float> monitor_jacobi(exec, b, 200, 1e-5);
+
+    cusp::precond::diagonal<float, MemorySpace> D(A.diagonal_block);
+
+    cusp::krylov::cg(exec, A, x, b, monitor_sa, M);
+    cusp::krylov::cg(exec, A, y, b, monitor_jacobi, D);
+
+    ASSERT_EQUAL(monitor_sa.converged(), true);
+    ASSERT_EQUAL(monitor_jacobi.converged(), true);
+    ASSERT_EQUAL(3 * monitor_sa.iteration_count() < monitor_jacobi.iteration_count(), true);
+
+    // check the residual over all ranks
+    cusp::array1d<float, MemorySpace> r(A.num_rows);
+    cusp::multiply(A, x, r);
+    cusp::blas::axpby(b, r, r, 1.0f, -1.0f);
+
+    ASSERT_EQUAL(cusp::blas::nrm2(exec, r) < 1e-4 * cusp::blas::nrm2(exec, b), true);
+}
+DECLARE_HOST_DEVICE_UNITTEST(TestDistributedSmoothedAggregation)
+
+template <class MemorySpace>
+void TestDistributedArray1d(void)
+{
+    InitializeMPI();
+
+    int rank;
+    int size;
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    MPI_Comm_size(MPI_COMM_WORLD, &size);
+
+    // every rank owns four entries
+    cusp::distributed::array1d<float, MemorySpace> x(4, 1.0f, MPI_COMM_WORLD);
+    cusp::distributed::array1d<float, MemorySpace> y(4, 2.0f, MPI_COMM_WORLD);
+    x[0] = float(rank + 1);
+
+    const float n = float(size);
+    const float s = n * (n + 1) / 2;
+
+    ASSERT_EQUAL(x.global_size(), size_t(4 * size));
+
+    ASSERT_EQUAL(cusp::blas::dot(x, y),  2.0f * (s + 3 * n));
+    ASSERT_EQUAL(cusp::blas::dotc(x, y), 2.0f * (s + 3 * n));
+    ASSERT_EQUAL(cusp::blas::asum(y), 8.0f * n);
+    ASSERT_EQUAL(cusp::blas::nrmmax(x), std::max(n, 1.0f));
+    ASSERT_ALMOST_EQUAL(cusp::blas::nrm2(y), std::sqrt(16.0f * n));
+
+    // the largest entry is the first one of the last rank
+    ASSERT_EQUAL(cusp::blas::amax(x), 4 * (size - 1));
+
+    // the local updates need no communication
+    cusp::blas::axpy(x, y, 1.0f);
+    ASSERT_EQUAL(float(y[1]), 3.0f);
+
+    // assignment keeps the communicator
+    cusp::array1d<float, cusp::host_memory> z(4, -1.0f);
+    y = z;
+    ASSERT_EQUAL(y.communicator() == MPI_COMM_WORLD, true);
+    ASSERT_EQUAL(cusp::blas::asum(y), 4.0f * n);
+}
+DECLARE_HOST_DEVICE_UNITTEST(TestDistributedArray1d)
+
+template <class MemorySpace>
+void TestDistributedPipelinedSolvers(void)
+{
+    InitializeMPI();
+
+    cusp::csr_matrix<int, float, cusp::host_memory> G;
+    cusp::csr_matrix<int, float, cusp::host_memory> L;
+
+    cusp::gallery::poisson5pt(G, 10, 10);
+    cusp::distributed::local_rows(G, MPI_COMM_WORLD, L);
+
+    cusp::distributed::csr_matrix<int, float, MemorySpace> A(L, MPI_COMM_WORLD);
+    cusp::identity_operator<float, MemorySpace> M(A.num_rows, A.num_rows);
+
+    const size_t first = A.first_row();
+
+    cusp::array1d<float, cusp::host_memory> b(G.num_rows, 1.0f);
+    cusp::distributed::array1d<float, MemorySpace> b_local(A, 1.0f);
+
+    // the fused inner products of the pipelined solvers are reduced with a
+    // nonblocking reduction and gmres projects over all ranks
+    for (int solver = 0; solver < 3; solver++)
+    {
+        cusp::array1d<float, cusp::host_memory> x(G.num_rows, 0.0f);
+        cusp::monitor<float> monitor(b, 100, 1e-5);
+
+        cusp::distributed::array1d<float, MemorySpace> x_local(A, 0.0f);
+        cusp::monitor<float> monitor_local(b_local.policy(), b_local, 100, 1e-5);
+
+        typename cusp::distributed::array1d<float, MemorySpace>::policy_type exec = b_local.policy();
+
+        if (solver == 0)
+        {
+            cusp::krylov::pipelined_cg(G, x, b, monitor);
+            cusp::krylov::pipelined_cg(exec, A, x_local, b_local, monitor_local, M);
+        }
+        else if (solver == 1)
+        {
+            cusp::krylov::pipelined_bicgstab(G, x, b, monitor);
+            cusp::krylov::pipelined_bicgstab(exec, A, x_local, b_local, monitor_local, M);
+        }
+        else
+        {
+            cusp::identity_operator<float, cusp::host_memory> I(G.num_rows, G.num_rows);
+
+            cusp::krylov::gmres(G, x, b, 20, monitor, I, cusp::krylov::classical_gram_schmidt);
+            cusp::krylov::gmres(exec, A, x_local, b_local, 20, monitor_local, M, cusp::krylov::classical_gram_schmidt);
+        }
+
+        cusp::array1d<float, cusp::host_memory> expected(x.begin() + first, x.begin() + first + A.num_rows);
+
+        ASSERT_EQUAL(monitor_local.converged(), true);
+        ASSERT_EQUAL(monitor_local.iteration_count(), monitor.iteration_count());
+        ASSERT_ALMOST_EQUAL(x_local, expected);
+    }
+}
+DECLARE_HOST_DEVICE_UNITTEST(TestDistributedPipelinedSolvers)
@@ -0,0 +1,58 @@
+#include <unittest/unittest.h>
+
+#include <cusp/array1d.h>
+#include <cusp/array2d.h>
+#include <cusp/coo_matrix.h>
+#include <cusp/csr_matrix.h>
+
+#include <cusp/eigen/lanczos.h>
+
+#include <cmath>
+
+template<typename ValueType>
+void TestLanczosPartialReorthogonalization(void)
+{
+    const int n = 200;
+
+    // 1D Laplacian, whose eigenvalues are simple and known in closed form
+    cusp::coo_matrix<int, ValueType, cusp::host_memory> C(n, n, 3 * n - 2);
+
+    for (int i = 0, k = 0; i < n; i++)
+    {
+        if (i > 0)
+        {
+            C.row_indices[k] = i; C.column_indices[k] = i - 1; C.values[k] = -1; k++;
+        }
+
+        C.row_indices[k] = i; C.column_indices[k] = i; C.values[k] = 2; k++;
+
+        if (i < n - 1)
+        {
+            C.row_indices[k] = i; C.column_indices[k] = i + 1; C.values[k] = -1; k++;
+        }
+    }
+
+    cusp::csr_matrix<int, ValueType, cusp::device_memory> A(C);
+
+    cusp::array1d<ValueType, cusp::host_memory> eigVals(4, 0);
+    cusp::array2d<ValueType, cusp::device_memory, cusp::column_major> eigVecs;
+
+    cusp::eigen::lanczos_options<ValueType> options;
+    options.tol     = 1e-6;
+    options.eigPart = cusp::eigen::LA;
+    options.reorth  = cusp::eigen::Partial;
+
+    cusp::eigen::lanczos(A, eigVals, eigVecs, options);
+
+    ASSERT_EQUAL(eigVals.size(), 4);
+
+    // converged copies of the same eigenvalue would show up as ghosts
+    // once the basis has lost orthogonality
+    for (int i = 0; i < 4; i++)
+    {
+        const double exact = 2.0 - 2.0 * std::cos(M_PI * (n - 3 + i) / (n + 1));
+
+        ASSERT_LEQUAL(std::abs(eigVals[i] - exact), 1e-3);
+    }
+}
+DECLARE_REAL_UNITTEST(TestLanczosPartialReorthogonalization);
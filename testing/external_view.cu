@@ -0,0 +1,247 @@
+#include <unittest/unittest.h>
+
+#include <cusp/external_view.h>
+
+#include <cusp/array1d.h>
+#include <cusp/array2d.h>
+#include <cusp/blas/blas.h>
+#include <cusp/convert.h>
+#include <cusp/coo_matrix.h>
+#include <cusp/csr_matrix.h>
+#include <cusp/ell_matrix.h>
+#include <cusp/multiply.h>
+
+#include <cusp/gallery/poisson.h>
+
+// members of a DLPack DLTensor
+struct TestDLDevice   { int device_type; int device_id; };
+struct TestDLDataType { unsigned char code; unsigned char bits; unsigned short lanes; };
+
+struct TestDLTensor
+{
+    void*              data;
+    TestDLDevice       device;
+    int                ndim;
+    TestDLDataType     dtype;
+    long long*         shape;
+    long long*         strides;
+    unsigned long long byte_offset;
+};
+
+template <typename MemorySpace>
+int DeviceType(void)
+{
+#if THRUST_DEVICE_SYSTEM == THRUST_DEVICE_SYSTEM_CUDA
+    if (thrust::detail::is_same<MemorySpace, cusp::device_memory>::value)
+        return cusp::DLPACK_CUDA;
+#endif
+    return cusp::DLPACK_CPU;
+}
+
+template <typename MemorySpace, typename T>
+TestDLTensor MakeTensor(T* data, int code, int ndim, long long* shape, long long* strides)
+{
+    TestDLTensor t;
+    t.data               = data;
+    t.device.device_type = DeviceType<MemorySpace>();
+    t.device.device_id   = 0;
+    t.ndim               = ndim;
+    t.dtype.code         = code;
+    t.dtype.bits         = 8 * sizeof(T);
+    t.dtype.lanes        = 1;
+    t.shape              = shape;
+    t.strides            = strides;
+    t.byte_offset        = 0;
+    return t;
+}
+
+template <class MemorySpace>
+void TestExternalArrayView(void)
+{
+    cusp::array1d<float, MemorySpace> storage(10, 1.0f);
+    float* data = thrust::raw_pointer_cast(storage.data());
+
+    typename cusp::array1d<float, MemorySpace>::view v =
+        cusp::make_array1d_view(MemorySpace(), data + 2, 5);
+
+    ASSERT_EQUAL(v.size(), 5);
+    ASSERT_EQUAL(thrust::raw_pointer_cast(&v[0]) == data + 2, true);
+
+    // writes through the view reach the storage
+    cusp::blas::fill(v, 3.0f);
+
+    cusp::array1d<float, cusp::host_memory> expected(10, 1.0f);
+    for(int i = 2; i < 7; i++)
+        expected[i] = 3.0f;
+
+    ASSERT_EQUAL(storage, expected);
+
+    const float* const_data = data;
+    typename cusp::array1d<float, MemorySpace>::const_view c =
+        cusp::make_array1d_view(MemorySpace(), const_data, 10);
+
+    ASSERT_EQUAL(cusp::blas::nrm1(c), 20.0f);
+
+    // 3x2 block of a 3x4 row-major matrix
+    typename cusp::array2d<float, MemorySpace, cusp::row_major>::view D =
+        cusp::make_array2d_view(MemorySpace(), data, 3, 2, 4, cusp::row_major());
+
+    ASSERT_EQUAL(D.num_rows, 3);
+    ASSERT_EQUAL(D.num_cols, 2);
+    ASSERT_EQUAL(D.pitch, 4);
+    ASSERT_EQUAL(D(1, 0), 3.0f);
+    ASSERT_EQUAL(D(2, 1), 1.0f);
+}
+DECLARE_HOST_DEVICE_UNITTEST(TestExternalArrayView);
+
+template <class MemorySpace>
+void TestExternalMatrixView(void)
+{
+    cusp::csr_matrix<int, float, MemorySpace> A;
+    cusp::gallery::poisson5pt(A, 5, 4);
+
+    cusp::coo_matrix<int, float, MemorySpace> B(A);
+    cusp::ell_matrix<int, float, MemorySpace> C(A);
+
+    cusp::array1d<float, MemorySpace> x(A.num_cols);
+    for(size_t i = 0; i < x.size(); i++)
+        x[i] = float(i % 4);
+
+    cusp::array1d<float, MemorySpace> expected(A.num_rows);
+    cusp::multiply(A, x, expected);
+
+    cusp::array1d<float, MemorySpace> y(A.num_rows);
+    float* x_data = thrust::raw_pointer_cast(x.data());
+    float* y_data = thrust::raw_pointer_cast(y.data());
+
+    typename cusp::array1d<float, MemorySpace>::view x_view = cusp::make_array1d_view(MemorySpace(), x_data, x.size());
+    typename cusp::array1d<float, MemorySpace>::view y_view = cusp::make_array1d_view(MemorySpace(), y_data, y.size());
+
+    {
+        typename cusp::csr_matrix<int, float, MemorySpace>::view V =
+            cusp::make_csr_matrix_view(MemorySpace(), A.num_rows, A.num_cols, A.num_entries,
+                                       thrust::raw_pointer_cast(A.row_offsets.data()),
+                                       thrust::raw_pointer_cast(A.column_indices.data()),
+                                       thrust::raw_pointer_cast(A.values.data()));
+
+        cusp::blas::fill(y, 0.0f);
+        cusp::multiply(V, x_view, y_view);
+        ASSERT_EQUAL(y, expected);
+
+        // the view converts like the container
+        cusp::coo_matrix<int, float, MemorySpace> D;
+        cusp::convert(V, D);
+        ASSERT_EQUAL(D.row_indices, B.row_indices);
+        ASSERT_EQUAL(D.column_indices, B.column_indices);
+    }
+
+    {
+        const cusp::coo_matrix<int, float, MemorySpace>& const_B = B;
+
+        typename cusp::coo_matrix<int, float, MemorySpace>::const_view V =
+            cusp::make_coo_matrix_view(MemorySpace(), B.num_rows, B.num_cols, B.num_entries,
+                                       thrust::raw_pointer_cast(const_B.row_indices.data()),
+                                       thrust::raw_pointer_cast(const_B.column_indices.data()),
+                                       thrust::raw_pointer_cast(const_B.values.data()));
+
+        cusp::blas::fill(y, 0.0f);
+        cusp::multiply(V, x_view, y_view);
+        ASSERT_EQUAL(y, expected);
+    }
+
+    {
+        typename cusp::ell_matrix<int, float, MemorySpace>::view V =
+            cusp::make_ell_matrix_view(MemorySpace(), C.num_rows, C.num_cols, C.num_entries,
+                                       C.column_indices.num_cols, C.column_indices.pitch,
+                                       thrust::raw_pointer_cast(C.column_indices.values.data()),
+                                       thrust::raw_pointer_cast(C.values.values.data()));
+
+        cusp::blas::fill(y, 0.0f);
+        cusp::multiply(V, x_view, y_view);
+        ASSERT_EQUAL(y, expected);
+    }
+}
+DECLARE_HOST_DEVICE_UNITTEST(TestExternalMatrixView);
+
+template <class MemorySpace>
+void TestExternalDLPackImport(void)
+{
+    cusp::csr_matrix<int, float, MemorySpace> A;
+    cusp::gallery::poisson5pt(A, 4, 4);
+
+    long long offsets_shape[1] = { (long long) A.num_rows + 1 };
+    long long entries_shape[1] = { (long long) A.num_entries };
+
+    TestDLTensor row_offsets    = MakeTensor<MemorySpace>(thrust::raw_pointer_cast(A.row_offsets.data()), cusp::DLPACK_INT, 1, offsets_shape, 0);
+    TestDLTensor column_indices = MakeTensor<MemorySpace>(thrust::raw_pointer_cast(A.column_indices.data()), cusp::DLPACK_INT, 1, entries_shape, 0);
+    TestDLTensor values         = MakeTensor<MemorySpace>(thrust::raw_pointer_cast(A.values.data()), cusp::DLPACK_FLOAT, 1, entries_shape, 0);
+
+    typename cusp::csr_matrix<int, float, MemorySpace>::view V =
+        cusp::import_csr_matrix_view<int, float, MemorySpace>(A.num_rows, A.num_cols, row_offsets, column_indices, values);
+
+    cusp::array1d<float, MemorySpace> x(A.num_cols, 1.0f), y(A.num_rows), expected(A.num_rows);
+    cusp::multiply(A, x, expected);
+    cusp::multiply(V, x, y);
+    ASSERT_EQUAL(y, expected);
+
+    // byte offsets and unit strides
+    long long unit_stride[1] = { 1 };
+    long long tail_shape[1]  = { 4 };
+    TestDLTensor tail = MakeTensor<MemorySpace>(thrust::raw_pointer_cast(A.values.data()), cusp::DLPACK_FLOAT, 1, tail_shape, unit_stride);
+    tail.byte_offset = (A.num_entries - 4) * sizeof(float);
+
+    typename cusp::array1d<float, MemorySpace>::view t = cusp::import_array1d_view<float, MemorySpace>(tail);
+    ASSERT_EQUAL(t.size(), 4);
+    ASSERT_EQUAL(thrust::raw_pointer_cast(&t[0]) == thrust::raw_pointer_cast(A.values.data()) + A.num_entries - 4, true);
+
+    // 4x2 column-major with pitch 8 over the first 16 values
+    long long matrix_shape[2]   = { 4, 2 };
+    long long matrix_strides[2] = { 1, 8 };
+    TestDLTensor matrix = MakeTensor<MemorySpace>(thrust::raw_pointer_cast(A.values.data()), cusp::DLPACK_FLOAT, 2, matrix_shape, matrix_strides);
+
+    typename cusp::array2d<float, MemorySpace, cusp::column_major>::view D =
+        cusp::import_array2d_view<float, MemorySpace, cusp::column_major>(matrix);
+
+    cusp::array1d<float, cusp::host_memory> h_values(A.values);
+    ASSERT_EQUAL(D.pitch, 8);
+    ASSERT_EQUAL(D(3, 0), h_values[3]);
+    ASSERT_EQUAL(D(1, 1), h_values[9]);
+
+    // C order is not column-major
+    TestDLTensor c_order = MakeTensor<MemorySpace>(thrust::raw_pointer_cast(A.values.data()), cusp::DLPACK_FLOAT, 2, matrix_shape, 0);
+    ASSERT_THROWS((cusp::import_array2d_view<float, MemorySpace, cusp::column_major>(c_order)), cusp::invalid_input_exception);
+
+    typename cusp::array2d<float, MemorySpace, cusp::row_major>::view R =
+        cusp::import_array2d_view<float, MemorySpace, cusp::row_major>(c_order);
+    ASSERT_EQUAL(R.pitch, 2);
+    ASSERT_EQUAL(R(2, 1), h_values[5]);
+}
+DECLARE_HOST_DEVICE_UNITTEST(TestExternalDLPackImport);
+
+template <class MemorySpace>
+void TestExternalDLPackInvalidInput(void)
+{
+    cusp::array1d<float, MemorySpace> storage(8, 0.0f);
+    float* data = thrust::raw_pointer_cast(storage.data());
+
+    long long shape[2]   = { 4, 2 };
+    long long strided[1] = { 2 };
+
+    // wrong type code, width, dimensions, stride and device
+    TestDLTensor t = MakeTensor<MemorySpace>(data, cusp::DLPACK_INT, 1, shape, 0);
+    ASSERT_THROWS((cusp::import_array1d_view<float, MemorySpace>(t)), cusp::invalid_input_exception);
+
+    t = MakeTensor<MemorySpace>(data, cusp::DLPACK_FLOAT, 1, shape, 0);
+    ASSERT_THROWS((cusp::import_array1d_view<double, MemorySpace>(t)), cusp::invalid_input_exception);
+
+    t = MakeTensor<MemorySpace>(data, cusp::DLPACK_FLOAT, 2, shape, 0);
+    ASSERT_THROWS((cusp::import_array1d_view<float, MemorySpace>(t)), cusp::invalid_input_exception);
+
+    t = MakeTensor<MemorySpace>(data, cusp::DLPACK_FLOAT, 1, shape, strided);
+    ASSERT_THROWS((cusp::import_array1d_view<float, MemorySpace>(t)), cusp::invalid_input_exception);
+
+    t = MakeTensor<MemorySpace>(data, cusp::DLPACK_FLOAT, 1, shape, 0);
+    t.device.device_type = 7;
+    ASSERT_THROWS((cusp::import_array1d_view<float, MemorySpace>(t)), cusp::invalid_input_exception);
+}
+DECLARE_HOST_DEVICE_UNITTEST(TestExternalDLPackInvalidInput);
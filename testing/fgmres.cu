@@ -0,0 +1,134 @@
+#include <unittest/unittest.h>
+
+#include <cusp/csr_matrix.h>
+#include <cusp/linear_operator.h>
+#include <cusp/monitor.h>
+#include <cusp/multiply.h>
+
+#include <cusp/gallery/poisson.h>
+#include <cusp/krylov/cg.h>
+#include <cusp/krylov/fgmres.h>
+
+// inexact inner solve whose accuracy changes with every application
+template <typename MatrixType>
+struct variable_cg_preconditioner
+    : public cusp::linear_operator<typename MatrixType::value_type, typename MatrixType::memory_space>
+{
+    typedef typename MatrixType::value_type ValueType;
+    typedef cusp::linear_operator<ValueType, typename MatrixType::memory_space> Parent;
+
+    const MatrixType& A;
+    size_t num_applications;
+
+    variable_cg_preconditioner(const MatrixType& A)
+        : Parent(A.num_rows, A.num_cols), A(A), num_applications(0) {}
+
+    template <typename VectorType1, typename VectorType2>
+    void operator()(const VectorType1& x, VectorType2& y)
+    {
+        cusp::monitor<ValueType> monitor(x, 1 + num_applications++ % 4, 0);
+
+        cusp::blas::fill(y, ValueType(0));
+        cusp::krylov::cg(A, y, x, monitor);
+    }
+};
+
+template <class LinearOperator, class VectorType1, class VectorType2, class Monitor, class Preconditioner>
+void fgmres(my_system& system, const LinearOperator& A, VectorType1& x, const VectorType2& b, const size_t restart, Monitor& monitor, Preconditioner& M)
+{
+    system.validate_dispatch();
+    return;
+}
+
+void TestFlexibleGeneralizedMinResDispatch()
+{
+    // initialize testing variables
+    size_t restart = 20;
+    cusp::csr_matrix<int, float, cusp::device_memory> A;
+    cusp::gallery::poisson5pt(A, 10, 10);
+    cusp::array1d<float, cusp::device_memory> x(A.num_rows, 0.0f);
+    cusp::monitor<float> monitor(x, 20, 1e-4);
+    cusp::identity_operator<float,cusp::device_memory> M(A.num_rows, A.num_cols);
+
+    {
+        my_system sys(0);
+
+        // call fgmres with explicit dispatching
+        cusp::krylov::fgmres(sys, A, x, x, restart, monitor, M);
+
+        // check if dispatch policy was used
+        ASSERT_EQUAL(true, sys.is_valid());
+    }
+}
+DECLARE_UNITTEST(TestFlexibleGeneralizedMinResDispatch);
+
+template <class MemorySpace>
+void TestFlexibleGeneralizedMinRes(void)
+{
+    size_t restart = 20;
+
+    cusp::csr_matrix<int, float, MemorySpace> A;
+
+    cusp::gallery::poisson5pt(A, 10, 10);
+
+    cusp::array1d<float, MemorySpace> x(A.num_rows, 0.0f);
+    cusp::array1d<float, MemorySpace> b(A.num_rows, 1.0f);
+
+    cusp::monitor<float> monitor(b, 40, 1e-4);
+
+    cusp::krylov::fgmres(A, x, b, restart, monitor);
+
+    ASSERT_EQUAL(monitor.converged(), true);
+
+    // check residual norm
+    cusp::array1d<float, MemorySpace> residual(A.num_rows, 0.0f);
+    cusp::multiply(A, x, residual);
+    cusp::blas::axpby(residual, b, residual, -1.0f, 1.0f);
+
+    ASSERT_EQUAL(cusp::blas::nrm2(residual) < 1e-4 * cusp::blas::nrm2(b), true);
+}
+DECLARE_HOST_DEVICE_UNITTEST(TestFlexibleGeneralizedMinRes);
+
+template <class MemorySpace>
+void TestFlexibleGeneralizedMinResVariablePreconditioner(void)
+{
+    typedef cusp::csr_matrix<int, float, MemorySpace> MatrixType;
+
+    MatrixType A;
+
+    cusp::gallery::poisson5pt(A, 10, 10);
+
+    cusp::array1d<float, MemorySpace> x(A.num_rows, 0.0f);
+    cusp::array1d<float, MemorySpace> b(A.num_rows, 1.0f);
+    cusp::array1d<float, MemorySpace> residual(A.num_rows, 0.0f);
+
+    {
+        variable_cg_preconditioner<MatrixType> M(A);
+        cusp::monitor<float> monitor(b, 40, 1e-4);
+
+        cusp::krylov::fgmres(A, x, b, 20, monitor, M);
+
+        ASSERT_EQUAL(monitor.converged(), true);
+
+        cusp::multiply(A, x, residual);
+        cusp::blas::axpby(residual, b, residual, -1.0f, 1.0f);
+
+        ASSERT_EQUAL(cusp::blas::nrm2(residual) < 1e-4 * cusp::blas::nrm2(b), true);
+    }
+
+    {
+        variable_cg_preconditioner<MatrixType> M(A);
+        cusp::monitor<float> monitor(b, 40, 1e-4);
+
+        cusp::blas::fill(x, 0.0f);
+        cusp::krylov::fgmres(A, x, b, 20, monitor, M, cusp::krylov::classical_gram_schmidt);
+
+        ASSERT_EQUAL(monitor.converged(), true);
+
+        cusp::multiply(A, x, residual);
+        cusp::blas::axpby(residual, b, residual, -1.0f, 1.0f);
+
+        ASSERT_EQUAL(cusp::blas::nrm2(residual) < 1e-4 * cusp::blas::nrm2(b), true);
+    }
+}
+DECLARE_HOST_DEVICE_UNITTEST(TestFlexibleGeneralizedMinResVariablePreconditioner);
@@ -0,0 +1,129 @@
+#include <unittest/unittest.h>
+
+#include <cusp/detail/fixed_size.h>
+
+#include <vector>
+
+template <size_t N>
+void check_fixed_size_invert(void)
+{
+    std::vector<double> A(N * N), B(N * N), Ainv(N * N), C(N * N, 0);
+
+    // diagonally dominant with a small entry on the diagonal, which forces
+    // a row exchange
+    for(size_t i = 0; i < N; i++)
+        for(size_t j = 0; j < N; j++)
+            A[i * N + j] = (i == j) ? 0.25 : 1.0 / (1.0 + i + 2 * j);
+
+    A[N] = 4 * N;
+    B = A;
+
+    ASSERT_EQUAL(cusp::detail::fixed_size::invert<N>(&A[0], &Ainv[0]), true);
+
+    cusp::detail::fixed_size::gemm<N,N,N>(&B[0], &Ainv[0], &C[0]);
+
+    for(size_t i = 0; i < N; i++)
+        for(size_t j = 0; j < N; j++)
+            ASSERT_ALMOST_EQUAL(C[i * N + j], (i == j) ? 1.0 : 0.0);
+}
+
+void TestFixedSizeInvert(void)
+{
+    check_fixed_size_invert<2>();
+    check_fixed_size_invert<3>();
+    check_fixed_size_invert<5>();
+    check_fixed_size_invert<8>();
+
+    double S[4] = {1, 2, 2, 4};
+    double Sinv[4];
+
+    ASSERT_EQUAL(cusp::detail::fixed_size::invert<2>(S, Sinv), false);
+}
+DECLARE_UNITTEST(TestFixedSizeInvert);
+
+void TestFixedSizeGemv(void)
+{
+    double A[6] = {1, 2, 3,
+                   4, 5, 6};
+    double x[3] = {1, 0, 2};
+    double y[2] = {10, 0};
+
+    cusp::detail::fixed_size::gemv<2,3>(A, x, y);
+
+    ASSERT_EQUAL(y[0], 17);
+    ASSERT_EQUAL(y[1], 16);
+}
+DECLARE_UNITTEST(TestFixedSizeGemv);
+
+void TestFixedSizeQR(void)
+{
+    const size_t num_rows = 6;
+
+    // the third column is a combination of the first two
+    std::vector<double> A(num_rows * 3), Q(num_rows * 3);
+    for(size_t i = 0; i < num_rows; i++)
+    {
+        A[i * 3 + 0] = 1;
+        A[i * 3 + 1] = i;
+        A[i * 3 + 2] = 2 + 3.0 * i;
+    }
+
+    Q = A;
+    double R[9];
+
+    ASSERT_EQUAL(cusp::detail::fixed_size::qr<3>(Q.begin(), num_rows, R), 2);
+    ASSERT_EQUAL(R[8], 0);
+
+    for(size_t i = 0; i < num_rows; i++)
+    {
+        for(size_t j = 0; j < 3; j++)
+        {
+            double sum = 0;
+            for(size_t k = 0; k < 3; k++)
+                sum += Q[i * 3 + k] * R[k * 3 + j];
+
+            ASSERT_ALMOST_EQUAL(sum, A[i * 3 + j]);
+        }
+    }
+
+    for(size_t a = 0; a < 2; a++)
+    {
+        for(size_t b = 0; b < 2; b++)
+        {
+            double sum = 0;
+            for(size_t i = 0; i < num_rows; i++)
+                sum += Q[i * 3 + a] * Q[i * 3 + b];
+
+            ASSERT_ALMOST_EQUAL(sum, (a == b) ? 1.0 : 0.0);
+        }
+    }
+}
+DECLARE_UNITTEST(TestFixedSizeQR);
+
+struct record_block_size
+{
+    size_t size;
+
+    record_block_size(void) : size(0) {}
+
+    template <size_t N>
+    void apply(void)
+    {
+        size = N;
+    }
+};
+
+void TestFixedSizeDispatch(void)
+{
+    for(size_t n = cusp::detail::fixed_size::MIN_BLOCK_SIZE; n <= cusp::detail::fixed_size::MAX_BLOCK_SIZE; n++)
+    {
+        record_block_size f;
+        ASSERT_EQUAL(cusp::detail::fixed_size::dispatch_block_size(n, f), true);
+        ASSERT_EQUAL(f.size, n);
+    }
+
+    record_block_size f;
+    ASSERT_EQUAL(cusp::detail::fixed_size::dispatch_block_size(9, f), false);
+    ASSERT_EQUAL(f.size, 0);
+}
+DECLARE_UNITTEST(TestFixedSizeDispatch);
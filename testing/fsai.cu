@@ -0,0 +1,133 @@
+#include <unittest/unittest.h>
+
+#include <cusp/precond/diagonal.h>
+#include <cusp/precond/fsai.h>
+
+#include <cusp/array1d.h>
+#include <cusp/blas.h>
+#include <cusp/csr_matrix.h>
+#include <cusp/format_utils.h>
+#include <cusp/monitor.h>
+#include <cusp/multiply.h>
+
+#include <cusp/gallery/poisson.h>
+#include <cusp/krylov/cg.h>
+
+template <class MemorySpace>
+void TestFSAIUnitDiagonal(void)
+{
+    typedef float ValueType;
+
+    cusp::csr_matrix<int,ValueType,MemorySpace> A;
+    cusp::gallery::poisson5pt(A, 12, 9);
+
+    for(size_t power = 1; power <= 2; power++)
+    {
+        cusp::precond::fsai<ValueType,MemorySpace> M(A, power);
+
+        // the rows of G are scaled such that G A G^T has a unit diagonal
+        cusp::csr_matrix<int,ValueType,MemorySpace> GA;
+        cusp::csr_matrix<int,ValueType,MemorySpace> GAGt;
+        cusp::multiply(M.G, A, GA);
+        cusp::multiply(GA, M.Gt, GAGt);
+
+        cusp::array1d<ValueType,MemorySpace> diagonal;
+        cusp::extract_diagonal(GAGt, diagonal);
+
+        cusp::array1d<ValueType,MemorySpace> ones(A.num_rows, ValueType(1));
+
+        ASSERT_ALMOST_EQUAL(diagonal, ones);
+    }
+}
+DECLARE_HOST_DEVICE_UNITTEST(TestFSAIUnitDiagonal);
+
+template <class MemorySpace>
+void TestFSAIPattern(void)
+{
+    typedef float ValueType;
+
+    cusp::csr_matrix<int,ValueType,MemorySpace> A;
+    cusp::gallery::poisson5pt(A, 10, 10);
+
+    cusp::precond::fsai<ValueType,MemorySpace> M1(A);
+    cusp::precond::fsai<ValueType,MemorySpace> M2(A, 2);
+
+    ASSERT_EQUAL(M1.G.num_entries, (A.num_entries + A.num_rows) / 2);
+    ASSERT_EQUAL(M1.Gt.num_entries, M1.G.num_entries);
+    ASSERT_EQUAL(M2.G.num_entries > M1.G.num_entries, true);
+
+    // G is lower triangular
+    cusp::csr_matrix<int,ValueType,cusp::host_memory> G(M2.G);
+
+    for(int i = 0; i < G.num_rows; i++)
+        for(int jj = G.row_offsets[i]; jj < G.row_offsets[i + 1]; jj++)
+            ASSERT_EQUAL(G.column_indices[jj] <= i, true);
+}
+DECLARE_HOST_DEVICE_UNITTEST(TestFSAIPattern);
+
+template <class MemorySpace>
+void TestFSAISolve(void)
+{
+    typedef float ValueType;
+
+    cusp::csr_matrix<int,ValueType,MemorySpace> A;
+    cusp::gallery::poisson5pt(A, 64, 64);
+
+    cusp::array1d<ValueType,MemorySpace> b = unittest::random_samples<ValueType>(A.num_rows);
+    cusp::array1d<ValueType,MemorySpace> x(A.num_rows);
+
+    // diagonal preconditioning for reference
+    size_t jacobi_iterations = 0;
+    {
+        cusp::precond::diagonal<ValueType,MemorySpace> M(A);
+        cusp::monitor<ValueType> monitor(b, 1000, 1e-5);
+        cusp::blas::fill(x, ValueType(0));
+        cusp::krylov::cg(A, x, b, monitor, M);
+        ASSERT_EQUAL(monitor.converged(), true);
+        jacobi_iterations = monitor.iteration_count();
+    }
+
+    size_t fsai_iterations = 0;
+    {
+        cusp::precond::fsai<ValueType,MemorySpace> M(A);
+        cusp::monitor<ValueType> monitor(b, 1000, 1e-5);
+        cusp::blas::fill(x, ValueType(0));
+        cusp::krylov::cg(A, x, b, monitor, M);
+        ASSERT_EQUAL(monitor.converged(), true);
+        ASSERT_EQUAL(monitor.iteration_count() < jacobi_iterations, true);
+        fsai_iterations = monitor.iteration_count();
+    }
+
+    {
+        cusp::precond::fsai<ValueType,MemorySpace> M(A, 2);
+        cusp::monitor<ValueType> monitor(b, 1000, 1e-5);
+        cusp::blas::fill(x, ValueType(0));
+        cusp::krylov::cg(A, x, b, monitor, M);
+        ASSERT_EQUAL(monitor.converged(), true);
+        ASSERT_EQUAL(monitor.iteration_count() <= fsai_iterations, true);
+    }
+}
+DECLARE_HOST_DEVICE_UNITTEST(TestFSAISolve);
+
+template <class MemorySpace>
+void TestFSAIInvalidInput(void)
+{
+    typedef float ValueType;
+
+    cusp::precond::fsai<ValueType,MemorySpace> M;
+
+    // not square
+    {
+        cusp::csr_matrix<int,ValueType,MemorySpace> A(3, 4, 0);
+        ASSERT_THROWS(M.initialize(A), cusp::invalid_input_exception);
+    }
+
+    // missing diagonal entry
+    {
+        cusp::csr_matrix<int,ValueType,MemorySpace> A(2, 2, 1);
+        A.row_offsets[0] = 0; A.row_offsets[1] = 1; A.row_offsets[2] = 1;
+        A.column_indices[0] = 0; A.values[0] = 1;
+        ASSERT_THROWS(M.initialize(A), cusp::invalid_input_exception);
+    }
+}
+DECLARE_HOST_DEVICE_UNITTEST(TestFSAIInvalidInput);
@@ -0,0 +1,67 @@
+#include <unittest/unittest.h>
+
+#include <cusp/precond/aggregation/galerkin_product.h>
+#include <cusp/precond/aggregation/smooth_prolongator.h>
+#include <cusp/precond/aggregation/detail/sa_view_traits.h>
+
+#include <cusp/array2d.h>
+#include <cusp/coo_matrix.h>
+#include <cusp/csr_matrix.h>
+#include <cusp/multiply.h>
+#include <cusp/transpose.h>
+
+#include <cusp/gallery/poisson.h>
+
+template <typename SetupMatrixType>
+void _TestGalerkinProduct(void)
+{
+    typedef typename SetupMatrixType::memory_space MemorySpace;
+
+    // 2D Poisson problem w/ 3x3 aggregates
+    const int N = 10;
+
+    cusp::coo_matrix<int,float,cusp::host_memory> _A;
+    cusp::gallery::poisson5pt(_A, N, N);
+
+    cusp::coo_matrix<int,float,cusp::host_memory> _T(N * N, 16, N * N);
+    for (int i = 0; i < N * N; i++)
+    {
+        _T.row_indices[i]    = i;
+        _T.column_indices[i] = ((i / N) / 3) * 4 + (i % N) / 3;
+        _T.values[i]         = 1;
+    }
+
+    SetupMatrixType A(_A);
+    SetupMatrixType T(_T);
+    SetupMatrixType P;
+    SetupMatrixType R;
+
+    cusp::precond::aggregation::smooth_prolongator(A, T, P, 2.0f);
+    cusp::transpose(P, R);
+
+    SetupMatrixType RAP;
+    cusp::precond::aggregation::galerkin_product(R, A, P, RAP);
+
+    SetupMatrixType AP, expected;
+    cusp::multiply(A, P, AP);
+    cusp::multiply(R, AP, expected);
+
+    ASSERT_EQUAL(RAP.num_rows, 16);
+    ASSERT_EQUAL(RAP.num_cols, 16);
+
+    cusp::array2d<float,cusp::host_memory> result(RAP);
+    cusp::array2d<float,cusp::host_memory> reference(expected);
+
+    ASSERT_ALMOST_EQUAL(result.values, reference.values);
+}
+
+template <class MemorySpace>
+void TestGalerkinProduct(void)
+{
+    typedef typename cusp::precond::aggregation::detail::select_sa_matrix_type<int,float,MemorySpace>::type SetupMatrixType;
+
+    _TestGalerkinProduct< SetupMatrixType >();
+    _TestGalerkinProduct< cusp::coo_matrix<int,float,MemorySpace> >();
+    _TestGalerkinProduct< cusp::csr_matrix<int,float,MemorySpace> >();
+}
+DECLARE_HOST_DEVICE_UNITTEST(TestGalerkinProduct);
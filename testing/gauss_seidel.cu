@@ -9,6 +9,8 @@
 #include <cusp/ell_matrix.h>
 #include <cusp/hyb_matrix.h>
 
+#include <cusp/gallery/poisson.h>
+
 template <typename Space>
 void TestGaussSeidelRelaxation(void)
 {
@@ -96,3 +98,47 @@ void TestGaussSeidelRelaxationSweeps(void)
 }
 DECLARE_HOST_DEVICE_UNITTEST(TestGaussSeidelRelaxationSweeps);
 
+
+template <typename Space>
+void TestGaussSeidelRelaxationMulticolor(void)
+{
+    typedef cusp::csr_matrix<int,float,Space> Matrix;
+
+    Matrix A;
+    cusp::gallery::poisson5pt(A, 20, 15);
+
+    cusp::array1d<float, Space> b(A.num_rows);
+    for(size_t i = 0; i < b.size(); i++)
+        b[i] = float(i % 7) - 3;
+
+    cusp::relaxation::gauss_seidel<float, Space> indexed(A);
+    cusp::relaxation::gauss_seidel<float, Space> multicolor(A, cusp::relaxation::SYMMETRIC, true);
+
+    // the off-diagonal entries of every row are stored in color order
+    ASSERT_EQUAL(multicolor.colored_A.num_entries, A.num_entries - A.num_rows);
+
+    const cusp::relaxation::sweep sweeps[3] = { cusp::relaxation::FORWARD,
+                                                cusp::relaxation::BACKWARD,
+                                                cusp::relaxation::SYMMETRIC };
+
+    for(int n = 0; n < 3; n++)
+    {
+        cusp::array1d<float, Space> x(A.num_rows, 1);
+        cusp::array1d<float, Space> y(A.num_rows, 1);
+
+        for(int k = 0; k < 3; k++)
+        {
+            indexed(A, b, x, sweeps[n]);
+            multicolor(A, b, y, sweeps[n]);
+        }
+
+        ASSERT_ALMOST_EQUAL(x, y);
+    }
+
+    // copies retain the multicolor mode
+    cusp::relaxation::gauss_seidel<float, cusp::host_memory> copy(multicolor);
+
+    ASSERT_EQUAL(copy.multicolor, true);
+    ASSERT_EQUAL(copy.colored_A.num_entries, multicolor.colored_A.num_entries);
+}
+DECLARE_HOST_DEVICE_UNITTEST(TestGaussSeidelRelaxationMulticolor);
@@ -144,6 +144,74 @@ void TestGeneralizedSpMV()
 }
 DECLARE_SPARSE_MATRIX_UNITTEST(TestGeneralizedSpMV);
 
+// reference z = reduce(y, combine(A(i,:), x)) computed row by row
+template <typename MatrixType, typename ArrayType, typename BinaryFunction1, typename BinaryFunction2>
+ArrayType ReferenceSemiringSpMV(const MatrixType& A, const ArrayType& x, const ArrayType& y,
+                                BinaryFunction1 combine, BinaryFunction2 reduce)
+{
+    ArrayType z(y);
+
+    for(size_t i = 0; i < A.num_rows; i++)
+        for(int jj = A.row_offsets[i]; jj < A.row_offsets[i + 1]; jj++)
+            z[i] = reduce(z[i], combine(A.values[jj], x[A.column_indices[jj]]));
+
+    return z;
+}
+
+template <class Space>
+void TestGeneralizedSpMVSemiring(void)
+{
+    typedef cusp::csr_matrix<int, float, cusp::host_memory> HostMatrix;
+    typedef cusp::array1d<float, cusp::host_memory>         HostArray;
+
+    std::vector<HostMatrix> matrices(3);
+    cusp::gallery::poisson5pt(matrices[0], 10, 10);
+    cusp::gallery::random(matrices[1], 129, 127, 40);
+    cusp::gallery::random(matrices[2], 300, 400, 20000);
+
+    for(size_t i = 0; i < matrices.size(); i++)
+    {
+        HostMatrix M_h = matrices[i];
+
+        // nonnegative integral weights so that every reduction order is exact
+        for(size_t n = 0; n < M_h.num_entries; n++)
+            M_h.values[n] = float((n * 7) % 5);
+
+        cusp::csr_matrix<int, float, Space> M(M_h);
+
+        HostArray x_h(M.num_cols);
+        HostArray y_h(M.num_rows);
+        for(size_t n = 0; n < M.num_cols; n++)
+            x_h[n] = float(n % 3);
+        for(size_t n = 0; n < M.num_rows; n++)
+            y_h[n] = float(n % 11);
+
+        cusp::array1d<float, Space> x(x_h);
+        cusp::array1d<float, Space> y(y_h);
+        cusp::array1d<float, Space> z(M.num_rows);
+
+        // min-plus
+        cusp::generalized_spmv(M, x, y, z, thrust::plus<float>(), thrust::minimum<float>());
+        ASSERT_EQUAL(z, ReferenceSemiringSpMV(M_h, x_h, y_h, thrust::plus<float>(), thrust::minimum<float>()));
+
+        // max-times
+        cusp::generalized_spmv(M, x, y, z, thrust::multiplies<float>(), thrust::maximum<float>());
+        ASSERT_EQUAL(z, ReferenceSemiringSpMV(M_h, x_h, y_h, thrust::multiplies<float>(), thrust::maximum<float>()));
+
+        // or-and, starting from an all false vector
+        cusp::array1d<float, Space> f(M.num_rows, 0);
+        HostArray f_h(M.num_rows, 0);
+
+        cusp::generalized_spmv(M, x, f, z, thrust::logical_and<float>(), thrust::logical_or<float>());
+        ASSERT_EQUAL(z, ReferenceSemiringSpMV(M_h, x_h, f_h, thrust::logical_and<float>(), thrust::logical_or<float>()));
+
+        // the min-plus semiring through multiply
+        cusp::multiply(M, x, y, thrust::identity<float>(), thrust::plus<float>(), thrust::minimum<float>());
+        ASSERT_EQUAL(y, ReferenceSemiringSpMV(M_h, x_h, y_h, thrust::plus<float>(), thrust::minimum<float>()));
+    }
+}
+DECLARE_HOST_DEVICE_UNITTEST(TestGeneralizedSpMVSemiring);
+
 template <typename LinearOperator,
          typename Vector1,
          typename Vector2,
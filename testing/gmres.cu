@@ -5,6 +5,7 @@
 
 #include <cusp/gallery/poisson.h>
 #include <cusp/krylov/gmres.h>
+#include <cusp/krylov/s_step_gmres.h>
 
 template <class LinearOperator, class VectorType1, class VectorType2, class Monitor, class Preconditioner>
 void gmres(my_system& system, const LinearOperator& A, VectorType1& x, const VectorType2& b, const size_t restart, Monitor& monitor, Preconditioner& M)
@@ -60,3 +61,108 @@ void TestGeneralizedMinRes(void)
 }
 DECLARE_HOST_DEVICE_UNITTEST(TestGeneralizedMinRes);
 
+template <class MemorySpace>
+void TestGeneralizedMinResSolver(void)
+{
+    cusp::csr_matrix<int, float, MemorySpace> A;
+
+    cusp::gallery::poisson5pt(A, 10, 10);
+
+    cusp::array1d<float, MemorySpace> x(A.num_rows, 0.0f);
+    cusp::array1d<float, MemorySpace> y(A.num_rows, 0.0f);
+    cusp::array1d<float, MemorySpace> b(A.num_rows, 1.0f);
+
+    cusp::monitor<float> monitor1(b, 20, 1e-4);
+    cusp::krylov::gmres(A, x, b, 20, monitor1);
+
+    // the workspace is reused across solves
+    cusp::krylov::gmres_solver<float, MemorySpace> solver(A.num_rows, 20);
+
+    for (int i = 0; i < 2; i++)
+    {
+        cusp::monitor<float> monitor2(b, 20, 1e-4);
+
+        cusp::blas::fill(y, 0.0f);
+        solver.solve(A, y, b, 20, monitor2);
+
+        ASSERT_EQUAL(monitor2.iteration_count(), monitor1.iteration_count());
+        ASSERT_ALMOST_EQUAL(y, x);
+    }
+}
+DECLARE_HOST_DEVICE_UNITTEST(TestGeneralizedMinResSolver);
+
+template <class MemorySpace>
+void TestGeneralizedMinResClassicalGramSchmidt(void)
+{
+    cusp::csr_matrix<int, float, MemorySpace> A;
+
+    cusp::gallery::poisson5pt(A, 10, 10);
+
+    cusp::array1d<float, MemorySpace> x(A.num_rows, 0.0f);
+    cusp::array1d<float, MemorySpace> y(A.num_rows, 0.0f);
+    cusp::array1d<float, MemorySpace> b(A.num_rows, 1.0f);
+
+    cusp::identity_operator<float, MemorySpace> M(A.num_rows, A.num_cols);
+
+    cusp::monitor<float> monitor1(b, 40, 1e-4);
+    cusp::krylov::gmres(A, x, b, 20, monitor1, M, cusp::krylov::modified_gram_schmidt);
+
+    cusp::monitor<float> monitor2(b, 40, 1e-4);
+    cusp::krylov::gmres(A, y, b, 20, monitor2, M, cusp::krylov::classical_gram_schmidt);
+
+    ASSERT_EQUAL(monitor2.converged(), true);
+    ASSERT_EQUAL(monitor2.iteration_count(), monitor1.iteration_count());
+
+    // check residual norm
+    cusp::array1d<float, MemorySpace> residual(A.num_rows, 0.0f);
+    cusp::multiply(A, y, residual);
+    cusp::blas::axpby(residual, b, residual, -1.0f, 1.0f);
+
+    ASSERT_EQUAL(cusp::blas::nrm2(residual) < 1e-4 * cusp::blas::nrm2(b), true);
+
+    // the solver object sees the same option
+    cusp::krylov::gmres_solver<float, MemorySpace> solver(A.num_rows, 20, cusp::krylov::classical_gram_schmidt);
+    cusp::monitor<float> monitor3(b, 40, 1e-4);
+
+    cusp::blas::fill(x, 0.0f);
+    solver.solve(A, x, b, 20, monitor3);
+
+    ASSERT_EQUAL(monitor3.iteration_count(), monitor2.iteration_count());
+    ASSERT_ALMOST_EQUAL(x, y);
+}
+DECLARE_HOST_DEVICE_UNITTEST(TestGeneralizedMinResClassicalGramSchmidt);
+
+template <class MemorySpace>
+void TestSStepGeneralizedMinRes(void)
+{
+    cusp::csr_matrix<int, double, MemorySpace> A;
+
+    cusp::gallery::poisson5pt(A, 10, 10);
+
+    cusp::array1d<double, MemorySpace> x(A.num_rows, 0.0);
+    cusp::array1d<double, MemorySpace> b(A.num_rows, 1.0);
+
+    cusp::monitor<double> monitor1(b, 100, 1e-8);
+
+    // the restart length is rounded down to 16
+    cusp::krylov::s_step_gmres(A, x, b, 18, monitor1, 4);
+
+    ASSERT_EQUAL(monitor1.converged(), true);
+    ASSERT_EQUAL(monitor1.iteration_count() % 4, size_t(0));
+
+    cusp::array1d<double, MemorySpace> residual(A.num_rows, 0.0);
+    cusp::multiply(A, x, residual);
+    cusp::blas::axpby(residual, b, residual, -1.0, 1.0);
+
+    ASSERT_EQUAL(cusp::blas::nrm2(residual) < 1e-6 * cusp::blas::nrm2(b), true);
+
+    // restarting after every block
+    cusp::monitor<double> monitor2(b, 200, 1e-8);
+
+    cusp::blas::fill(x, 0.0);
+    cusp::krylov::s_step_gmres(A, x, b, 4, monitor2, 4);
+
+    ASSERT_EQUAL(monitor2.converged(), true);
+    ASSERT_EQUAL(monitor2.iteration_count() >= monitor1.iteration_count(), true);
+}
+DECLARE_HOST_DEVICE_UNITTEST(TestSStepGeneralizedMinRes);
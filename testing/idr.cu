@@ -0,0 +1,178 @@
+#include <unittest/unittest.h>
+
+#include <cusp/coo_matrix.h>
+#include <cusp/csr_matrix.h>
+#include <cusp/linear_operator.h>
+#include <cusp/monitor.h>
+#include <cusp/multiply.h>
+
+#include <cusp/gallery/poisson.h>
+#include <cusp/krylov/bicgstab.h>
+#include <cusp/krylov/idr.h>
+#include <cusp/precond/diagonal.h>
+
+// upwind convection-diffusion on an n-by-n grid, nonsymmetric for peclet > 0
+template <class MatrixType>
+void convection_diffusion(MatrixType& A, const int n, const float peclet)
+{
+    cusp::coo_matrix<int, float, cusp::host_memory> C(n * n, n * n, 5 * n * n - 4 * n);
+
+    size_t nnz = 0;
+
+    for (int i = 0; i < n; i++)
+    {
+        for (int j = 0; j < n; j++)
+        {
+            const int k = i * n + j;
+
+            if (i > 0)     { C.row_indices[nnz] = k; C.column_indices[nnz] = k - n; C.values[nnz++] = -1.0f - peclet; }
+            if (j > 0)     { C.row_indices[nnz] = k; C.column_indices[nnz] = k - 1; C.values[nnz++] = -1.0f - peclet; }
+                             C.row_indices[nnz] = k; C.column_indices[nnz] = k;     C.values[nnz++] =  4.0f;
+            if (j < n - 1) { C.row_indices[nnz] = k; C.column_indices[nnz] = k + 1; C.values[nnz++] = -1.0f + peclet; }
+            if (i < n - 1) { C.row_indices[nnz] = k; C.column_indices[nnz] = k + n; C.values[nnz++] = -1.0f + peclet; }
+        }
+    }
+
+    A = C;
+}
+
+template <class LinearOperator,
+          class VectorType1,
+          class VectorType2,
+          class Monitor,
+          class Preconditioner>
+void idr(my_system& system,
+         const LinearOperator& A,
+               VectorType1& x,
+         const VectorType2& b,
+         const size_t s,
+               Monitor& monitor,
+               Preconditioner& M)
+{
+    system.validate_dispatch();
+    return;
+}
+
+void TestIDRDispatch()
+{
+    // initialize testing variables
+    cusp::csr_matrix<int, float, cusp::device_memory> A;
+    cusp::gallery::poisson5pt(A, 10, 10);
+    cusp::array1d<float, cusp::device_memory> x(A.num_rows, 0.0f);
+    cusp::monitor<float> monitor(x, 20, 1e-4);
+    cusp::identity_operator<float,cusp::device_memory> M(A.num_rows, A.num_cols);
+
+    my_system sys(0);
+
+    // call with explicit dispatching
+    cusp::krylov::idr(sys, A, x, x, 4, monitor, M);
+
+    // check if dispatch policy was used
+    ASSERT_EQUAL(true, sys.is_valid());
+}
+DECLARE_UNITTEST(TestIDRDispatch);
+
+template <class MemorySpace>
+void TestIDR(void)
+{
+    cusp::csr_matrix<int, float, MemorySpace> A;
+
+    cusp::gallery::poisson5pt(A, 10, 10);
+
+    cusp::array1d<float, MemorySpace> x(A.num_rows, 0.0f);
+    cusp::array1d<float, MemorySpace> b(A.num_rows, 1.0f);
+
+    cusp::monitor<float> monitor(b, 100, 1e-4);
+
+    cusp::krylov::idr(A, x, b, 4, monitor);
+
+    // check residual norm
+    cusp::array1d<float, MemorySpace> residual(A.num_rows, 0.0f);
+    cusp::multiply(A, x, residual);
+    cusp::blas::axpby(residual, b, residual, -1.0f, 1.0f);
+
+    ASSERT_EQUAL(monitor.converged(), true);
+    ASSERT_EQUAL(cusp::blas::nrm2(residual) < 1e-3 * cusp::blas::nrm2(b), true);
+}
+DECLARE_HOST_DEVICE_UNITTEST(TestIDR)
+
+template <class MemorySpace>
+void TestIDRConvectionDiffusion(void)
+{
+    cusp::csr_matrix<int, float, MemorySpace> A;
+
+    convection_diffusion(A, 16, 0.8f);
+
+    cusp::array1d<float, MemorySpace> b(A.num_rows, 1.0f);
+
+    for (size_t s = 1; s <= 8; s *= 2)
+    {
+        cusp::array1d<float, MemorySpace> x(A.num_rows, 0.0f);
+        cusp::monitor<float> monitor(b, 500, 1e-5);
+
+        cusp::krylov::idr(A, x, b, s, monitor);
+
+        // check residual norm
+        cusp::array1d<float, MemorySpace> residual(A.num_rows, 0.0f);
+        cusp::multiply(A, x, residual);
+        cusp::blas::axpby(residual, b, residual, -1.0f, 1.0f);
+
+        ASSERT_EQUAL(monitor.converged(), true);
+        ASSERT_EQUAL(cusp::blas::nrm2(residual) < 1e-4 * cusp::blas::nrm2(b), true);
+
+        if (s == 4)
+        {
+            // each bicgstab iteration performs two products with A
+            cusp::array1d<float, MemorySpace> y(A.num_rows, 0.0f);
+            cusp::monitor<float> monitor2(b, 500, 1e-5);
+
+            cusp::krylov::bicgstab(A, y, b, monitor2);
+
+            ASSERT_EQUAL(monitor.iteration_count() < 2 * monitor2.iteration_count(), true);
+        }
+    }
+}
+DECLARE_HOST_DEVICE_UNITTEST(TestIDRConvectionDiffusion)
+
+template <class MemorySpace>
+void TestIDRPreconditioned(void)
+{
+    cusp::csr_matrix<int, float, MemorySpace> A;
+
+    convection_diffusion(A, 16, 0.8f);
+
+    cusp::array1d<float, MemorySpace> x(A.num_rows, 0.0f);
+    cusp::array1d<float, MemorySpace> b(A.num_rows, 1.0f);
+
+    cusp::precond::diagonal<float, MemorySpace> M(A);
+    cusp::monitor<float> monitor(b, 500, 1e-5);
+
+    cusp::krylov::idr(A, x, b, 4, monitor, M);
+
+    // check residual norm
+    cusp::array1d<float, MemorySpace> residual(A.num_rows, 0.0f);
+    cusp::multiply(A, x, residual);
+    cusp::blas::axpby(residual, b, residual, -1.0f, 1.0f);
+
+    ASSERT_EQUAL(monitor.converged(), true);
+    ASSERT_EQUAL(cusp::blas::nrm2(residual) < 1e-4 * cusp::blas::nrm2(b), true);
+}
+DECLARE_HOST_DEVICE_UNITTEST(TestIDRPreconditioned)
+
+template <class MemorySpace>
+void TestIDRInvalidShadowSpace(void)
+{
+    cusp::csr_matrix<int, float, MemorySpace> A;
+
+    cusp::gallery::poisson5pt(A, 2, 2);
+
+    cusp::array1d<float, MemorySpace> x(A.num_rows, 0.0f);
+    cusp::array1d<float, MemorySpace> b(A.num_rows, 1.0f);
+
+    cusp::monitor<float> monitor(b, 20, 1e-5);
+
+    ASSERT_THROWS(cusp::krylov::idr(A, x, b, 0, monitor), cusp::invalid_input_exception);
+    ASSERT_THROWS(cusp::krylov::idr(A, x, b, 5, monitor), cusp::invalid_input_exception);
+}
+DECLARE_HOST_DEVICE_UNITTEST(TestIDRInvalidShadowSpace)
+
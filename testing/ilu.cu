@@ -0,0 +1,176 @@
+#include <unittest/unittest.h>
+
+#include <cusp/precond/diagonal.h>
+#include <cusp/precond/ilu.h>
+
+#include <cusp/array1d.h>
+#include <cusp/blas.h>
+#include <cusp/csr_matrix.h>
+#include <cusp/monitor.h>
+#include <cusp/multiply.h>
+
+#include <cusp/gallery/poisson.h>
+#include <cusp/krylov/bicgstab.h>
+#include <cusp/krylov/cg.h>
+
+template <typename Preconditioner, typename MemorySpace>
+void _TestIncompleteFactorizationTridiagonal(void)
+{
+    typedef float ValueType;
+
+    // the incomplete factors of a tridiagonal matrix are exact
+    cusp::csr_matrix<int,ValueType,MemorySpace> A;
+    cusp::gallery::poisson5pt(A, 50, 1);
+
+    Preconditioner M(A);
+
+    cusp::array1d<ValueType,MemorySpace> b = unittest::random_samples<ValueType>(A.num_rows);
+    cusp::array1d<ValueType,MemorySpace> x(A.num_rows, ValueType(0));
+    cusp::array1d<ValueType,MemorySpace> Ax(A.num_rows, ValueType(0));
+
+    M(b, x);
+    cusp::multiply(A, x, Ax);
+
+    ASSERT_ALMOST_EQUAL(Ax, b);
+}
+
+template <class MemorySpace>
+void TestILU0Tridiagonal(void)
+{
+    _TestIncompleteFactorizationTridiagonal< cusp::precond::ilu0<float,MemorySpace>, MemorySpace >();
+}
+DECLARE_HOST_DEVICE_UNITTEST(TestILU0Tridiagonal);
+
+template <class MemorySpace>
+void TestIC0Tridiagonal(void)
+{
+    _TestIncompleteFactorizationTridiagonal< cusp::precond::ic0<float,MemorySpace>, MemorySpace >();
+}
+DECLARE_HOST_DEVICE_UNITTEST(TestIC0Tridiagonal);
+
+template <class MemorySpace>
+void TestILU0Pattern(void)
+{
+    typedef float ValueType;
+
+    cusp::csr_matrix<int,ValueType,MemorySpace> A;
+    cusp::gallery::poisson5pt(A, 10, 10);
+
+    cusp::precond::ilu0<ValueType,MemorySpace> M(A);
+
+    ASSERT_EQUAL(M.LU.num_entries, A.num_entries);
+    ASSERT_EQUAL(M.lower_plan.num_levels(), size_t(19));
+    ASSERT_EQUAL(M.upper_plan.num_levels(), size_t(19));
+
+    // L * U agrees with A on the sparsity pattern of A
+    cusp::csr_matrix<int,ValueType,cusp::host_memory> LU(M.LU);
+    cusp::csr_matrix<int,ValueType,cusp::host_memory> A_h(A);
+
+    for(int i = 0; i < A_h.num_rows; i++)
+    {
+        for(int jj = A_h.row_offsets[i]; jj < A_h.row_offsets[i + 1]; jj++)
+        {
+            const int j = A_h.column_indices[jj];
+
+            ValueType sum = 0;
+
+            for(int kk = LU.row_offsets[i]; kk < LU.row_offsets[i + 1]; kk++)
+            {
+                const int k = LU.column_indices[kk];
+
+                if(k > i || k > j)
+                    continue;
+
+                const ValueType Lik = k == i ? ValueType(1) : ValueType(LU.values[kk]);
+
+                for(int kj = LU.row_offsets[k]; kj < LU.row_offsets[k + 1]; kj++)
+                    if(LU.column_indices[kj] == j)
+                        sum += Lik * LU.values[kj];
+            }
+
+            ASSERT_ALMOST_EQUAL(sum, ValueType(A_h.values[jj]));
+        }
+    }
+}
+DECLARE_HOST_DEVICE_UNITTEST(TestILU0Pattern);
+
+template <class MemorySpace>
+void TestIncompleteFactorizationSolve(void)
+{
+    typedef float ValueType;
+
+    cusp::csr_matrix<int,ValueType,MemorySpace> A;
+    cusp::gallery::poisson5pt(A, 64, 64);
+
+    cusp::array1d<ValueType,MemorySpace> b = unittest::random_samples<ValueType>(A.num_rows);
+    cusp::array1d<ValueType,MemorySpace> x(A.num_rows);
+
+    // diagonal preconditioning for reference
+    size_t jacobi_iterations = 0;
+    {
+        cusp::precond::diagonal<ValueType,MemorySpace> M(A);
+        cusp::monitor<ValueType> monitor(b, 1000, 1e-5);
+        cusp::blas::fill(x, ValueType(0));
+        cusp::krylov::cg(A, x, b, monitor, M);
+        ASSERT_EQUAL(monitor.converged(), true);
+        jacobi_iterations = monitor.iteration_count();
+    }
+
+    {
+        cusp::precond::ic0<ValueType,MemorySpace> M(A);
+        cusp::monitor<ValueType> monitor(b, 1000, 1e-5);
+        cusp::blas::fill(x, ValueType(0));
+        cusp::krylov::cg(A, x, b, monitor, M);
+        ASSERT_EQUAL(monitor.converged(), true);
+        ASSERT_EQUAL(monitor.iteration_count() < jacobi_iterations, true);
+    }
+
+    {
+        cusp::precond::ilu0<ValueType,MemorySpace> M(A);
+        cusp::monitor<ValueType> monitor(b, 1000, 1e-5);
+        cusp::blas::fill(x, ValueType(0));
+        cusp::krylov::bicgstab(A, x, b, monitor, M);
+        ASSERT_EQUAL(monitor.converged(), true);
+    }
+}
+DECLARE_HOST_DEVICE_UNITTEST(TestIncompleteFactorizationSolve);
+
+template <class MemorySpace>
+void TestIncompleteFactorizationSamePattern(void)
+{
+    typedef float ValueType;
+
+    cusp::csr_matrix<int,ValueType,MemorySpace> A;
+    cusp::gallery::poisson5pt(A, 20, 20);
+
+    cusp::csr_matrix<int,ValueType,MemorySpace> B(A);
+    cusp::blas::scal(B.values, ValueType(2));
+
+    cusp::array1d<ValueType,MemorySpace> b = unittest::random_samples<ValueType>(A.num_rows);
+    cusp::array1d<ValueType,MemorySpace> x(A.num_rows, ValueType(0));
+    cusp::array1d<ValueType,MemorySpace> y(A.num_rows, ValueType(0));
+
+    // refactorizing 2A with the analysis of A halves the result
+    {
+        cusp::precond::ilu0<ValueType,MemorySpace> M(A);
+        M(b, x);
+
+        M.initialize(B, true);
+        M(b, y);
+        cusp::blas::scal(y, ValueType(2));
+
+        ASSERT_ALMOST_EQUAL(x, y);
+    }
+
+    {
+        cusp::precond::ic0<ValueType,MemorySpace> M(A);
+        M(b, x);
+
+        M.initialize(B, true);
+        M(b, y);
+        cusp::blas::scal(y, ValueType(2));
+
+        ASSERT_ALMOST_EQUAL(x, y);
+    }
+}
+DECLARE_HOST_DEVICE_UNITTEST(TestIncompleteFactorizationSamePattern);
@@ -0,0 +1,50 @@
+#include <unittest/unittest.h>
+
+#include <cusp/csr_matrix.h>
+#include <cusp/monitor.h>
+#include <cusp/multiply.h>
+
+#include <cusp/gallery/poisson.h>
+#include <cusp/krylov/cg.h>
+#include <cusp/krylov/iterative_refinement.h>
+#include <cusp/precond/diagonal.h>
+
+template <class MemorySpace>
+void TestIterativeRefinement(void)
+{
+    cusp::csr_matrix<int, double, MemorySpace> A;
+
+    cusp::gallery::poisson5pt(A, 10, 10);
+
+    cusp::csr_matrix<int, float, MemorySpace> A_float(A);
+
+    cusp::array1d<double, MemorySpace> x(A.num_rows, 0.0);
+    cusp::array1d<double, MemorySpace> b(A.num_rows, 1.0);
+
+    // reach a tolerance beyond single precision
+    cusp::monitor<double> monitor(b, 20, 1e-10);
+    cusp::monitor<float>  inner_monitor(b, 100, 1e-3);
+
+    cusp::krylov::cg_solver<float, MemorySpace> solver(A.num_rows);
+    cusp::precond::diagonal<float, MemorySpace> M(A_float);
+
+    cusp::krylov::iterative_refinement(A, x, b, monitor, A_float, solver, inner_monitor, M);
+
+    ASSERT_EQUAL(monitor.converged(), true);
+    ASSERT_EQUAL(monitor.iteration_count() > 1, true);
+
+    cusp::array1d<double, MemorySpace> residual(A.num_rows, 0.0);
+    cusp::multiply(A, x, residual);
+    cusp::blas::axpby(residual, b, residual, -1.0, 1.0);
+
+    ASSERT_EQUAL(cusp::blas::nrm2(residual) <= 1e-10 * cusp::blas::nrm2(b), true);
+
+    // without preconditioner
+    cusp::monitor<double> monitor2(b, 20, 1e-10);
+
+    cusp::blas::fill(x, 0.0);
+    cusp::krylov::iterative_refinement(A, x, b, monitor2, A_float, solver, inner_monitor);
+
+    ASSERT_EQUAL(monitor2.converged(), true);
+}
+DECLARE_HOST_DEVICE_UNITTEST(TestIterativeRefinement);
@@ -26,6 +26,59 @@ void TestJoinIterator(void)
 }
 DECLARE_VECTOR_UNITTEST(TestJoinIterator);
 
+template <class Vector>
+void TestJoinCopy(void)
+{
+    typedef typename Vector::value_type T;
+    typedef thrust::counting_iterator<T> CountingIterator;
+    typedef typename Vector::iterator    Iterator;
+    typedef typename cusp::join_iterator< thrust::tuple<Iterator,Iterator,CountingIterator> >::iterator JoinIterator;
+
+    Vector a(4); a[0] = 0; a[1] = 1; a[2] = 2; a[3] = 3;
+    Vector b(3); b[0] = 7; b[1] = 8; b[2] = 9;
+
+    // a concatenation is copied with one copy per range
+    JoinIterator iter = cusp::make_join_iterator(4, 3, a.begin(), b.begin(), CountingIterator(0));
+
+    Vector c(7);
+    ASSERT_EQUAL(cusp::join_copy(iter, iter + 7, c.begin()) - c.begin(), 7);
+    ASSERT_EQUAL(c[0], 0);
+    ASSERT_EQUAL(c[3], 3);
+    ASSERT_EQUAL(c[4], 7);
+    ASSERT_EQUAL(c[6], 9);
+
+    // subranges within and across the two ranges
+    Vector d(3, T(-1));
+    cusp::join_copy(iter + 3, iter + 5, d.begin());
+    ASSERT_EQUAL(d[0], 3);
+    ASSERT_EQUAL(d[1], 7);
+    ASSERT_EQUAL(d[2], T(-1));
+
+    cusp::join_copy(iter + 5, iter + 7, d.begin());
+    ASSERT_EQUAL(d[0], 8);
+    ASSERT_EQUAL(d[1], 9);
+
+    cusp::join_transform(iter + 1, iter + 4, d.begin(), thrust::negate<T>());
+    ASSERT_EQUAL(d[0], T(-1));
+    ASSERT_EQUAL(d[1], T(-2));
+    ASSERT_EQUAL(d[2], T(-3));
+
+    // permuted joins are copied entry by entry
+    Vector indices(7);
+    for (size_t i = 0; i < 7; i++)
+        indices[i] = T(6 - i);
+
+    typedef typename cusp::join_iterator< thrust::tuple<Iterator,Iterator,Iterator> >::iterator PermutedIterator;
+    PermutedIterator perm = cusp::make_join_iterator(4, 3, a.begin(), b.begin(), indices.begin());
+
+    cusp::join_copy(perm, perm + 7, c.begin());
+    ASSERT_EQUAL(c[0], 9);
+    ASSERT_EQUAL(c[2], 7);
+    ASSERT_EQUAL(c[3], 3);
+    ASSERT_EQUAL(c[6], 0);
+}
+DECLARE_VECTOR_UNITTEST(TestJoinCopy);
+
 template <class Vector>
 void TestStridedIterator(void)
 {
@@ -8,6 +8,9 @@
 #include <cusp/dia_matrix.h>
 #include <cusp/ell_matrix.h>
 #include <cusp/hyb_matrix.h>
+#include <cusp/multiply.h>
+
+#include <cusp/gallery/poisson.h>
 
 template <typename Matrix>
 void TestJacobiRelaxation(void)
@@ -97,3 +100,88 @@ void TestJacobiRelaxationWithWeighting(void)
 }
 DECLARE_SPARSE_MATRIX_UNITTEST(TestJacobiRelaxationWithWeighting);
 
+
+
+template <typename Matrix>
+void TestJacobiRelaxationSweeps(void)
+{
+    typedef typename Matrix::value_type   ValueType;
+    typedef typename Matrix::memory_space Space;
+
+    Matrix A;
+    cusp::gallery::poisson5pt(A, 10, 10);
+
+    cusp::array1d<ValueType, Space> b(A.num_rows, 1.0);
+
+    for(size_t num_sweeps = 1; num_sweeps <= 4; num_sweeps++)
+    {
+        cusp::relaxation::jacobi<ValueType, Space> relax(A, 2.0/3.0);
+
+        cusp::array1d<ValueType, Space> expected(A.num_rows, 0.5);
+        for(size_t i = 0; i < num_sweeps; i++)
+            relax(A, b, expected);
+
+        // several sweeps at once match the same number of single sweeps
+        cusp::array1d<ValueType, Space> x(A.num_rows, 0.5);
+        relax(A, b, x, ValueType(2.0/3.0), num_sweeps);
+
+        ASSERT_ALMOST_EQUAL(x, expected);
+
+        // the barrier state is reused by a second call
+        cusp::array1d<ValueType, Space> y(A.num_rows, 0.5);
+        relax(A, b, y, ValueType(2.0/3.0), num_sweeps);
+
+        ASSERT_ALMOST_EQUAL(y, expected);
+    }
+}
+DECLARE_SPARSE_MATRIX_UNITTEST(TestJacobiRelaxationSweeps);
+
+
+template <typename Matrix>
+void TestJacobiRelaxationMatchesResidualUpdate(void)
+{
+    typedef typename Matrix::value_type   ValueType;
+    typedef typename Matrix::memory_space Space;
+
+    // rows of different lengths leave HYB matrices with a COO part
+    cusp::array2d<ValueType, cusp::host_memory> M(6,6,ValueType(0));
+    for(int i = 0; i < 6; i++)
+        M(i,i) = 8.0 + i;
+    M(0,1) = -1.0; M(0,3) =  2.0; M(0,4) = -3.0; M(0,5) = 1.0;
+    M(1,0) =  2.0;
+    M(3,2) = -1.0; M(3,5) = -2.0;
+    M(5,0) =  1.0; M(5,1) =  1.0; M(5,2) = 1.0; M(5,3) = 1.0; M(5,4) = 1.0;
+
+    cusp::array1d<ValueType, cusp::host_memory> b(6);
+    cusp::array1d<ValueType, cusp::host_memory> x0(6);
+    for(int i = 0; i < 6; i++)
+    {
+        b[i]  = ValueType(i + 1);
+        x0[i] = ValueType(2 - i);
+    }
+
+    const ValueType omega = 0.75;
+
+    for(size_t num_sweeps = 1; num_sweeps <= 3; num_sweeps++)
+    {
+        // x <- x + omega * D^-1 * (b - A*x), one residual at a time
+        cusp::array1d<ValueType, cusp::host_memory> expected(x0);
+        cusp::array1d<ValueType, cusp::host_memory> y(6);
+        for(size_t k = 0; k < num_sweeps; k++)
+        {
+            cusp::multiply(M, expected, y);
+            for(int i = 0; i < 6; i++)
+                expected[i] = expected[i] + omega * (b[i] - y[i]) / M(i,i);
+        }
+
+        Matrix A(M);
+        cusp::array1d<ValueType, Space> d_b(b);
+        cusp::array1d<ValueType, Space> x(x0);
+
+        cusp::relaxation::jacobi<ValueType, Space> relax(A, omega);
+        relax(A, d_b, x, omega, num_sweeps);
+
+        ASSERT_ALMOST_EQUAL(x, expected);
+    }
+}
+DECLARE_SPARSE_MATRIX_UNITTEST(TestJacobiRelaxationMatchesResidualUpdate);
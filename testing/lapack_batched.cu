@@ -0,0 +1,300 @@
+#include <unittest/unittest.h>
+
+#include <cusp/array1d.h>
+#include <cusp/array2d.h>
+#include <cusp/lapack/batched.h>
+
+// batch of num_matrices n-by-n matrices stored side by side, matrix k is
+// tridiag(-1, 4 + k, -1) plus a nonsymmetric entry in its last row
+void batched_test_matrices(cusp::array2d<float, cusp::host_memory>& A, const int n, const int num_matrices)
+{
+    A.resize(n, n * num_matrices);
+
+    for(int k = 0; k < num_matrices; k++)
+        for(int i = 0; i < n; i++)
+            for(int j = 0; j < n; j++)
+                A(i, k * n + j) = i == j ? 4.0f + k : (i - j == 1 || j - i == 1 ? -1.0f : 0.0f);
+}
+
+template <class MemorySpace>
+void TestBatchedGemm(void)
+{
+    // two 2x3 times 3x2 products
+    cusp::array2d<float, cusp::host_memory> A(2, 6);
+    cusp::array2d<float, cusp::host_memory> B(3, 4);
+
+    for(size_t i = 0; i < A.num_rows; i++)
+        for(size_t j = 0; j < A.num_cols; j++)
+            A(i,j) = float(i + j);
+
+    for(size_t i = 0; i < B.num_rows; i++)
+        for(size_t j = 0; j < B.num_cols; j++)
+            B(i,j) = float(i) - float(j);
+
+    cusp::array2d<float, MemorySpace> A_d(A);
+    cusp::array2d<float, MemorySpace, cusp::column_major> B_d(B);
+    cusp::array2d<float, MemorySpace> C_d(2, 4, 1.0f);
+
+    cusp::lapack::batched_gemm(A_d, B_d, C_d, 2.0f, 1.0f);
+
+    cusp::array2d<float, cusp::host_memory> C(C_d);
+
+    for(int k = 0; k < 2; k++)
+    {
+        for(int i = 0; i < 2; i++)
+        {
+            for(int j = 0; j < 2; j++)
+            {
+                float sum = 0.0f;
+
+                for(int p = 0; p < 3; p++)
+                    sum += A(i, k * 3 + p) * B(p, k * 2 + j);
+
+                ASSERT_EQUAL(C(i, k * 2 + j), 2.0f * sum + 1.0f);
+            }
+        }
+    }
+
+    cusp::array2d<float, MemorySpace> D_d(2, 3);
+    ASSERT_THROWS(cusp::lapack::batched_gemm(A_d, B_d, D_d), cusp::invalid_input_exception);
+}
+DECLARE_HOST_DEVICE_UNITTEST(TestBatchedGemm);
+
+template <class MemorySpace>
+void TestBatchedGetrfGetrs(void)
+{
+    const int n = 5;
+    const int num_matrices = 4;
+
+    cusp::array2d<float, cusp::host_memory> A;
+    batched_test_matrices(A, n, num_matrices);
+
+    // a zero leading entry forces row interchanges
+    A(0,0) = 0.0f;
+
+    cusp::array2d<float, cusp::host_memory> X(n, num_matrices);
+
+    for(int k = 0; k < num_matrices; k++)
+        for(int i = 0; i < n; i++)
+            X(i,k) = float(i - k);
+
+    cusp::array2d<float, cusp::host_memory> B(n, num_matrices, 0.0f);
+
+    for(int k = 0; k < num_matrices; k++)
+        for(int i = 0; i < n; i++)
+            for(int j = 0; j < n; j++)
+                B(i,k) += A(i, k * n + j) * X(j,k);
+
+    cusp::array2d<float, MemorySpace, cusp::column_major> LU(A);
+    cusp::array2d<float, MemorySpace> B_d(B);
+    cusp::array1d<int, MemorySpace> piv;
+    cusp::array1d<int, MemorySpace> info;
+
+    cusp::lapack::batched_getrf(LU, piv, info);
+
+    ASSERT_EQUAL(piv.size(),  size_t(n * num_matrices));
+    ASSERT_EQUAL(info.size(), size_t(num_matrices));
+    ASSERT_EQUAL(piv[0], 2);
+
+    cusp::array1d<int, cusp::host_memory> status(info);
+
+    for(int k = 0; k < num_matrices; k++)
+        ASSERT_EQUAL(status[k], 0);
+
+    cusp::lapack::batched_getrs(LU, piv, B_d);
+
+    cusp::array2d<float, cusp::host_memory> Y(B_d);
+
+    for(int k = 0; k < num_matrices; k++)
+        for(int i = 0; i < n; i++)
+            ASSERT_ALMOST_EQUAL(Y(i,k), X(i,k));
+
+    // singular matrices are reported with the position of the zero pivot
+    cusp::array2d<float, MemorySpace> S(3, 6, 1.0f);
+    cusp::lapack::batched_getrf(S, piv, info);
+
+    ASSERT_EQUAL(info[0], 2);
+    ASSERT_EQUAL(info[1], 2);
+
+    cusp::array2d<float, MemorySpace> R(3, 4);
+    ASSERT_THROWS(cusp::lapack::batched_getrf(R, piv, info), cusp::invalid_input_exception);
+}
+DECLARE_HOST_DEVICE_UNITTEST(TestBatchedGetrfGetrs);
+
+template <class MemorySpace>
+void TestBatchedPotrf(void)
+{
+    const int n = 4;
+    const int num_matrices = 3;
+
+    cusp::array2d<float, cusp::host_memory> A;
+    batched_test_matrices(A, n, num_matrices);
+
+    // the last matrix is indefinite
+    A(0, 2 * n) = -1.0f;
+
+    cusp::array2d<float, MemorySpace> L_d(A);
+    cusp::array2d<float, MemorySpace> U_d(A);
+    cusp::array1d<int, MemorySpace> info;
+
+    cusp::lapack::batched_potrf(L_d, info, 'L');
+
+    ASSERT_EQUAL(info[0], 0);
+    ASSERT_EQUAL(info[1], 0);
+    ASSERT_EQUAL(info[2], 1);
+
+    cusp::lapack::batched_potrf(U_d, info);
+
+    ASSERT_EQUAL(info[0], 0);
+    ASSERT_EQUAL(info[2], 1);
+
+    cusp::array2d<float, cusp::host_memory> L(L_d);
+    cusp::array2d<float, cusp::host_memory> U(U_d);
+
+    for(int k = 0; k < 2; k++)
+    {
+        for(int i = 0; i < n; i++)
+        {
+            for(int j = 0; j <= i; j++)
+            {
+                float sum_L = 0.0f;
+                float sum_U = 0.0f;
+
+                for(int p = 0; p <= j; p++)
+                {
+                    sum_L += L(i, k * n + p) * L(j, k * n + p);
+                    sum_U += U(p, k * n + i) * U(p, k * n + j);
+                }
+
+                ASSERT_ALMOST_EQUAL(sum_L, A(i, k * n + j));
+                ASSERT_ALMOST_EQUAL(sum_U, A(i, k * n + j));
+            }
+        }
+
+        // the other strict triangle is not referenced
+        ASSERT_EQUAL(L(0, k * n + 1), -1.0f);
+        ASSERT_EQUAL(U(1, k * n + 0), -1.0f);
+    }
+}
+DECLARE_HOST_DEVICE_UNITTEST(TestBatchedPotrf);
+
+template <class MemorySpace>
+void TestBatchedSyev(void)
+{
+    const int n = 6;
+    const int num_matrices = 3;
+
+    cusp::array2d<float, cusp::host_memory> A;
+    batched_test_matrices(A, n, num_matrices);
+
+    cusp::array2d<float, MemorySpace> A_d(A);
+    cusp::array1d<float, MemorySpace> eigvals_d;
+    cusp::array2d<float, MemorySpace, cusp::column_major> eigvecs_d;
+
+    cusp::lapack::batched_syev(A_d, eigvals_d, eigvecs_d);
+
+    ASSERT_EQUAL(eigvals_d.size(), size_t(n * num_matrices));
+    ASSERT_EQUAL(eigvecs_d.num_rows, size_t(n));
+    ASSERT_EQUAL(eigvecs_d.num_cols, size_t(n * num_matrices));
+
+    cusp::array1d<float, cusp::host_memory> eigvals(eigvals_d);
+    cusp::array2d<float, cusp::host_memory> V(eigvecs_d);
+
+    const float pi = 3.14159265358979f;
+
+    for(int k = 0; k < num_matrices; k++)
+    {
+        for(int i = 0; i < n; i++)
+        {
+            // eigenvalues of tridiag(-1, d, -1) in ascending order
+            ASSERT_ALMOST_EQUAL(eigvals[k * n + i], 4.0f + k - 2.0f * std::cos(float(i + 1) * pi / float(n + 1)));
+
+            // A v = lambda v
+            for(int r = 0; r < n; r++)
+            {
+                float Av = 0.0f;
+
+                for(int p = 0; p < n; p++)
+                    Av += A(r, k * n + p) * V(p, k * n + i);
+
+                ASSERT_ALMOST_EQUAL(Av, eigvals[k * n + i] * V(r, k * n + i));
+            }
+        }
+    }
+}
+DECLARE_HOST_DEVICE_UNITTEST(TestBatchedSyev);
+
+template <class MemorySpace>
+void TestBatchedSygv(void)
+{
+    const int n = 3;
+
+    // A = diag(2, 8, 3) and B = diag(1, 2, 3) in the first problem and a
+    // coupled pair in the second
+    cusp::array2d<float, cusp::host_memory> A;
+    cusp::array2d<float, cusp::host_memory> B(n, 2 * n, 0.0f);
+
+    batched_test_matrices(A, n, 2);
+
+    for(int i = 0; i < n; i++)
+        for(int j = 0; j < n; j++)
+            A(i,j) = 0.0f;
+
+    A(0,0) = 2.0f; A(1,1) = 8.0f; A(2,2) = 3.0f;
+    B(0,0) = 1.0f; B(1,1) = 2.0f; B(2,2) = 3.0f;
+
+    for(int i = 0; i < n; i++)
+        for(int j = 0; j < n; j++)
+            B(i, n + j) = i == j ? 2.0f : 0.5f;
+
+    cusp::array2d<float, MemorySpace> A_d(A);
+    cusp::array2d<float, MemorySpace> B_d(B);
+    cusp::array1d<float, MemorySpace> eigvals_d;
+    cusp::array2d<float, MemorySpace, cusp::column_major> eigvecs_d;
+    cusp::array1d<int, MemorySpace> info;
+
+    cusp::lapack::batched_sygv(A_d, B_d, eigvals_d, eigvecs_d, info);
+
+    ASSERT_EQUAL(info[0], 0);
+    ASSERT_EQUAL(info[1], 0);
+
+    cusp::array1d<float, cusp::host_memory> eigvals(eigvals_d);
+    cusp::array2d<float, cusp::host_memory> X(eigvecs_d);
+
+    ASSERT_ALMOST_EQUAL(eigvals[0], 1.0f);
+    ASSERT_ALMOST_EQUAL(eigvals[1], 2.0f);
+    ASSERT_ALMOST_EQUAL(eigvals[2], 4.0f);
+
+    for(int k = 0; k < 2; k++)
+    {
+        for(int c = 0; c < n; c++)
+        {
+            for(int d = 0; d < n; d++)
+            {
+                float xAx = 0.0f;
+                float xBx = 0.0f;
+
+                for(int i = 0; i < n; i++)
+                {
+                    for(int j = 0; j < n; j++)
+                    {
+                        xAx += X(i, k * n + c) * A(i, k * n + j) * X(j, k * n + d);
+                        xBx += X(i, k * n + c) * B(i, k * n + j) * X(j, k * n + d);
+                    }
+                }
+
+                // X^T A X = diag(eigvals) and X^T B X = I
+                ASSERT_ALMOST_EQUAL(xAx, c == d ? eigvals[k * n + c] : 0.0f);
+                ASSERT_ALMOST_EQUAL(xBx, c == d ? 1.0f : 0.0f);
+            }
+        }
+    }
+
+    // B is not positive definite
+    B_d(1,1) = -1.0f;
+    cusp::lapack::batched_sygv(A_d, B_d, eigvals_d, eigvecs_d, info);
+
+    ASSERT_EQUAL(info[0], n + 2);
+    ASSERT_EQUAL(info[1], 0);
+}
+DECLARE_HOST_DEVICE_UNITTEST(TestBatchedSygv);
@@ -0,0 +1,89 @@
+#include <unittest/unittest.h>
+
+#include <cusp/array1d.h>
+#include <cusp/array2d.h>
+#include <cusp/copy.h>
+#include <cusp/csr_matrix.h>
+#include <cusp/monitor.h>
+
+#include <cusp/eigen/lobpcg.h>
+#include <cusp/gallery/poisson.h>
+#include <cusp/precond/aggregation/smoothed_aggregation.h>
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+template <class MemorySpace>
+void TestLobpcgBlock(void)
+{
+    const int n = 10;
+    const size_t N = n * n;
+    const size_t k = 4;
+
+    cusp::csr_matrix<int, double, MemorySpace> A;
+    cusp::gallery::poisson5pt(A, n, n);
+
+    // the eigenvalues of the 5-point Laplacian are known in closed form
+    std::vector<double> exact;
+    for (int i = 1; i <= n; i++)
+        for (int j = 1; j <= n; j++)
+            exact.push_back(4.0 - 2.0 * std::cos(M_PI * i / (n + 1)) - 2.0 * std::cos(M_PI * j / (n + 1)));
+    std::sort(exact.begin(), exact.end());
+
+    cusp::random_array<double> rand(N * k);
+    cusp::array1d<double, MemorySpace> b(N, 1.0);
+
+    // smallest eigenpairs, converged columns are soft locked
+    {
+        cusp::array2d<double, MemorySpace, cusp::column_major> X(N, k);
+        cusp::copy(rand, X.values);
+        cusp::array1d<double, MemorySpace> S;
+
+        cusp::monitor<double> monitor(b, 200, 1e-6);
+        cusp::eigen::lobpcg(A, S, X, monitor, false);
+
+        ASSERT_EQUAL(S.size(), k);
+        ASSERT_EQUAL(monitor.iteration_count() < 200, true);
+        for (size_t i = 0; i < k; i++)
+            ASSERT_EQUAL(std::abs(S[i] - exact[i]) < 1e-6, true);
+    }
+
+    // largest eigenpairs
+    {
+        cusp::array2d<double, MemorySpace, cusp::column_major> X(N, 2);
+        cusp::copy(cusp::random_array<double>(2 * N), X.values);
+        cusp::array1d<double, MemorySpace> S;
+
+        cusp::monitor<double> monitor(b, 200, 1e-6);
+        cusp::eigen::lobpcg(A, S, X, monitor, true);
+
+        ASSERT_EQUAL(monitor.iteration_count() < 200, true);
+        ASSERT_EQUAL(std::abs(S[0] - exact[N - 1]) < 1e-6, true);
+        ASSERT_EQUAL(std::abs(S[1] - exact[N - 2]) < 1e-6, true);
+    }
+
+    // a smoothed aggregation hierarchy built once is reused as the
+    // preconditioner of several solves
+    cusp::precond::aggregation::smoothed_aggregation<int, double, MemorySpace> M(A);
+
+    for (size_t trial = 0; trial < 2; trial++)
+    {
+        cusp::array2d<double, MemorySpace, cusp::column_major> X(N, k);
+        cusp::copy(rand, X.values);
+        cusp::array1d<double, MemorySpace> S;
+
+        cusp::monitor<double> monitor(b, 200, 1e-6);
+        cusp::eigen::lobpcg(A, S, X, monitor, M, false);
+
+        ASSERT_EQUAL(monitor.iteration_count() < 200, true);
+        for (size_t i = 0; i < k; i++)
+            ASSERT_EQUAL(std::abs(S[i] - exact[i]) < 1e-6, true);
+    }
+
+    // the Rayleigh-Ritz basis of order 3k must fit in the space
+    cusp::array2d<double, MemorySpace, cusp::column_major> tooWide(N, N / 2, 1.0);
+    cusp::array1d<double, MemorySpace> S;
+    ASSERT_THROWS(cusp::eigen::lobpcg(A, S, tooWide, false), cusp::invalid_input_exception);
+}
+DECLARE_HOST_DEVICE_UNITTEST(TestLobpcgBlock);
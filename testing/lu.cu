@@ -83,3 +83,45 @@ void TestLUSolver(void)
 }
 DECLARE_UNITTEST(TestLUSolver);
 
+
+template <typename Space>
+void TestInverseSolver(void)
+{
+    // the first column needs a row interchange
+    cusp::array2d<float, cusp::host_memory> A(3,3);
+    A(0,0) = 0.0;
+    A(0,1) = 2.0;
+    A(0,2) = 1.0;
+    A(1,0) = 4.0;
+    A(1,1) = 1.0;
+    A(1,2) = 0.0;
+    A(2,0) = 1.0;
+    A(2,1) = 0.0;
+    A(2,2) = 3.0;
+
+    cusp::array1d<float, cusp::host_memory> b(3);
+    b[0] = 1.0;
+    b[1] = 2.0;
+    b[2] = 3.0;
+
+    cusp::array1d<float, cusp::host_memory> expected(3);
+    cusp::detail::lu_solver<float, cusp::host_memory> lu(A);
+    lu(b, expected);
+
+    cusp::array2d<float, Space> A_(A);
+    cusp::array1d<float, Space> b_(b);
+    cusp::array1d<float, Space> x(3, 0.0);
+
+    cusp::detail::inverse_solver<float, Space> solver(A_);
+    solver(b_, x);
+
+    ASSERT_ALMOST_EQUAL(x, expected);
+
+    // copies across memory spaces keep the inverse
+    cusp::detail::inverse_solver<float, cusp::host_memory> copy(solver);
+    cusp::array1d<float, cusp::host_memory> y(3, 0.0);
+    copy(b, y);
+
+    ASSERT_ALMOST_EQUAL(y, expected);
+}
+DECLARE_HOST_DEVICE_UNITTEST(TestInverseSolver);
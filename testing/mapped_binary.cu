@@ -0,0 +1,115 @@
+#include <unittest/unittest.h>
+
+#include <cusp/array1d.h>
+#include <cusp/array2d.h>
+#include <cusp/coo_matrix.h>
+#include <cusp/csr_matrix.h>
+#include <cusp/multiply.h>
+
+#include <cusp/gallery/poisson.h>
+#include <cusp/io/mapped_binary.h>
+
+#include <stdio.h>
+#include <fstream>
+#include <iterator>
+#include <vector>
+
+const char random_file_name[] = "test_93298409283221.cbin";
+
+template <typename SparseMatrix>
+void TestMappedBinaryFile(void)
+{
+    typedef typename SparseMatrix::value_type ValueType;
+    typedef typename SparseMatrix::template rebind<cusp::host_memory>::type HostMatrix;
+
+    SparseMatrix A;
+    cusp::gallery::poisson5pt(A, 13, 9);
+
+    cusp::io::write_mapped_binary_file(A, random_file_name);
+
+    {
+        cusp::io::mapped_binary_file<HostMatrix> file(random_file_name);
+
+        ASSERT_EQUAL(file.matrix().num_rows,    A.num_rows);
+        ASSERT_EQUAL(file.matrix().num_cols,    A.num_cols);
+        ASSERT_EQUAL(file.matrix().num_entries, A.num_entries);
+
+        cusp::array2d<ValueType, cusp::host_memory> D(file.matrix());
+        cusp::array2d<ValueType, cusp::host_memory> E(A);
+        ASSERT_EQUAL(D == E, true);
+
+        // multiply directly with the mapped arrays
+        cusp::array1d<ValueType, cusp::host_memory> x(A.num_cols);
+        for (size_t i = 0; i < x.size(); i++)
+            x[i] = ValueType(i % 7);
+
+        cusp::array1d<ValueType, cusp::host_memory> y(A.num_rows);
+        cusp::array1d<ValueType, cusp::host_memory> z(A.num_rows);
+
+        HostMatrix B(A);
+        cusp::multiply(file.matrix(), x, y);
+        cusp::multiply(B, x, z);
+        ASSERT_EQUAL(y, z);
+
+        // copy the view into a container of the original memory space
+        SparseMatrix C(file.matrix());
+        cusp::array2d<ValueType, cusp::host_memory> F(C);
+        ASSERT_EQUAL(F == E, true);
+    }
+
+    remove(random_file_name);
+}
+DECLARE_SPARSE_MATRIX_UNITTEST(TestMappedBinaryFile);
+
+void TestMappedBinaryFileTypeMismatch(void)
+{
+    cusp::csr_matrix<int, float, cusp::host_memory> A;
+    cusp::gallery::poisson5pt(A, 4, 4);
+
+    cusp::io::write_mapped_binary_file(A, random_file_name);
+
+    typedef cusp::csr_matrix<int, double, cusp::host_memory> DoubleMatrix;
+    typedef cusp::coo_matrix<int, float, cusp::host_memory>  CooMatrix;
+    typedef cusp::csr_matrix<long long, float, cusp::host_memory> LongMatrix;
+
+    ASSERT_THROWS(cusp::io::mapped_binary_file<DoubleMatrix> file(random_file_name), cusp::io_exception);
+    ASSERT_THROWS(cusp::io::mapped_binary_file<CooMatrix> file(random_file_name), cusp::io_exception);
+    ASSERT_THROWS(cusp::io::mapped_binary_file<LongMatrix> file(random_file_name), cusp::io_exception);
+
+    remove(random_file_name);
+}
+DECLARE_UNITTEST(TestMappedBinaryFileTypeMismatch);
+
+void TestMappedBinaryFileInvalid(void)
+{
+    typedef cusp::csr_matrix<int, float, cusp::host_memory> Matrix;
+
+    {
+        std::ofstream file(random_file_name);
+        file << "%%MatrixMarket matrix coordinate real general\n";
+        file << "1 1 1\n";
+        file << "1 1 1.0\n";
+    }
+
+    ASSERT_THROWS(cusp::io::mapped_binary_file<Matrix> file(random_file_name), cusp::io_exception);
+
+    // truncate a valid file
+    Matrix A;
+    cusp::gallery::poisson5pt(A, 4, 4);
+    cusp::io::write_mapped_binary_file(A, random_file_name);
+
+    std::vector<char> contents;
+    {
+        std::ifstream file(random_file_name, std::ios::binary);
+        contents.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    }
+    {
+        std::ofstream file(random_file_name, std::ios::binary);
+        file.write(&contents[0], contents.size() - 8);
+    }
+
+    ASSERT_THROWS(cusp::io::mapped_binary_file<Matrix> file(random_file_name), cusp::io_exception);
+
+    remove(random_file_name);
+}
+DECLARE_UNITTEST(TestMappedBinaryFileInvalid);
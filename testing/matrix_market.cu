@@ -7,6 +7,7 @@
 #include <cusp/array2d.h>
 
 #include <stdio.h>
+#include <fstream>
 
 const char random_file_name[] = "test_93298409283221.mtx";
 
@@ -324,3 +325,302 @@ void TestWriteMatrixMarketFileCoordinateComplexGeneral(void)
 }
 DECLARE_HOST_DEVICE_UNITTEST(TestWriteMatrixMarketFileCoordinateComplexGeneral);
 
+
+template <typename MemorySpace>
+void TestReadMatrixMarketFileParallelSkewSymmetric(void)
+{
+    {
+        std::ofstream file(random_file_name);
+        file << "%%MatrixMarket matrix coordinate real skew-symmetric\n";
+        file << "% lower triangle of a 4x4 skew-symmetric matrix\n";
+        file << "4 4 3\n";
+        file << "2 1 1.5\n";
+        file << "3 1 -2.25e+00\n";
+        file << "4 3 7\n";
+    }
+
+    cusp::coo_matrix<int, float, cusp::host_memory> A;
+    cusp::io::read_matrix_market_file(A, random_file_name);
+
+    // read file in parallel
+    cusp::coo_matrix<int, float, MemorySpace> B;
+    cusp::io::read_matrix_market_file_parallel(B, random_file_name);
+
+    remove(random_file_name);
+
+    cusp::array2d<float, cusp::host_memory> D(B);
+    ASSERT_EQUAL(D(1,0),  1.5f);
+    ASSERT_EQUAL(D(0,1), -1.5f);
+    ASSERT_EQUAL(D(0,2),  2.25f);
+    ASSERT_EQUAL(D(3,2),  7.0f);
+    ASSERT_EQUAL(D(2,3), -7.0f);
+
+    ASSERT_EQUAL(B.num_entries, 6);
+    ASSERT_EQUAL(A.row_indices,    B.row_indices);
+    ASSERT_EQUAL(A.column_indices, B.column_indices);
+    ASSERT_EQUAL(A.values,         B.values);
+}
+DECLARE_HOST_DEVICE_UNITTEST(TestReadMatrixMarketFileParallelSkewSymmetric);
+
+template <typename MemorySpace>
+void TestReadMatrixMarketFileParallelHermitian(void)
+{
+    {
+        std::ofstream file(random_file_name);
+        file << "%%MatrixMarket matrix coordinate complex hermitian\n";
+        file << "3 3 4\n";
+        file << "1 1 2.0 0.0\n";
+        file << "2 1 1.0 -3.0\n";
+        file << "\n";
+        file << "3 2 0.125 4.5\n";
+        file << "3 3 -1 0\n";
+    }
+
+    cusp::coo_matrix<int, cusp::complex<float>, cusp::host_memory> A;
+    cusp::io::read_matrix_market_file(A, random_file_name);
+
+    // read file in parallel
+    cusp::coo_matrix<int, cusp::complex<float>, MemorySpace> B;
+    cusp::io::read_matrix_market_file_parallel(B, random_file_name);
+
+    remove(random_file_name);
+
+    cusp::array2d<cusp::complex<float>, cusp::host_memory> D(B);
+    ASSERT_EQUAL(D(1,0), cusp::complex<float>(1.0f, -3.0f));
+    ASSERT_EQUAL(D(0,1), cusp::complex<float>(1.0f,  3.0f));
+    ASSERT_EQUAL(D(1,2), cusp::complex<float>(0.125f, -4.5f));
+
+    ASSERT_EQUAL(B.num_entries, 6);
+    ASSERT_EQUAL(A.row_indices,    B.row_indices);
+    ASSERT_EQUAL(A.column_indices, B.column_indices);
+    ASSERT_EQUAL(A.values,         B.values);
+}
+DECLARE_HOST_DEVICE_UNITTEST(TestReadMatrixMarketFileParallelHermitian);
+
+template <typename MemorySpace>
+void TestReadMatrixMarketFileParallelRandom(void)
+{
+    cusp::coo_matrix<int, float, cusp::host_memory> E(300, 200, 5000);
+
+    for (size_t n = 0; n < E.num_entries; n++)
+    {
+        E.row_indices[n]    = (n * 7919) % E.num_rows;
+        E.column_indices[n] = (n * 104729) % E.num_cols;
+        E.values[n]         = float(n % 97) / 13.0f - 3.0f;
+    }
+    E.sort_by_row_and_column();
+
+    cusp::io::write_matrix_market_file(E, random_file_name);
+
+    cusp::coo_matrix<int, float, cusp::host_memory> A;
+    cusp::io::read_matrix_market_file(A, random_file_name);
+
+    // read file in parallel
+    cusp::coo_matrix<int, float, MemorySpace> B;
+    cusp::io::read_matrix_market_file_parallel(B, random_file_name);
+
+    remove(random_file_name);
+
+    ASSERT_EQUAL(B.num_rows,    A.num_rows);
+    ASSERT_EQUAL(B.num_cols,    A.num_cols);
+    ASSERT_EQUAL(B.num_entries, A.num_entries);
+    ASSERT_EQUAL(A.row_indices,    B.row_indices);
+    ASSERT_EQUAL(A.column_indices, B.column_indices);
+    ASSERT_EQUAL(A.values,         B.values);
+}
+DECLARE_HOST_DEVICE_UNITTEST(TestReadMatrixMarketFileParallelRandom);
+
+void TestReadMatrixMarketFileParallelTruncated(void)
+{
+    {
+        std::ofstream file(random_file_name);
+        file << "%%MatrixMarket matrix coordinate real general\n";
+        file << "3 3 4\n";
+        file << "1 1 1.0\n";
+        file << "2 2 2.0\n";
+    }
+
+    cusp::coo_matrix<int, float, cusp::host_memory> A;
+    ASSERT_THROWS(cusp::io::read_matrix_market_file_parallel(A, random_file_name), cusp::io_exception);
+
+    remove(random_file_name);
+}
+DECLARE_UNITTEST(TestReadMatrixMarketFileParallelTruncated);
+
+template <typename MemorySpace>
+void TestWriteMatrixMarketFileLarge(void)
+{
+    // enough entries to be split across several formatting chunks
+    cusp::coo_matrix<int, double, cusp::host_memory> E(5000, 40, 40000);
+
+    for (size_t n = 0; n < E.num_entries; n++)
+    {
+        E.row_indices[n]    = n / 8;
+        E.column_indices[n] = (n * 5) % 40;
+        E.values[n]         = (n % 3 == 0) ? double(n) : double(n % 1000) / 4.0 - 100.0;
+    }
+    E.sort_by_row_and_column();
+
+    cusp::coo_matrix<int, double, MemorySpace> A(E);
+    cusp::io::write_matrix_market_file(A, random_file_name);
+
+    cusp::coo_matrix<int, double, cusp::host_memory> B;
+    cusp::io::read_matrix_market_file(B, random_file_name);
+
+    remove(random_file_name);
+
+    ASSERT_EQUAL(B.num_rows,    E.num_rows);
+    ASSERT_EQUAL(B.num_cols,    E.num_cols);
+    ASSERT_EQUAL(B.num_entries, E.num_entries);
+    ASSERT_EQUAL(B.row_indices,    E.row_indices);
+    ASSERT_EQUAL(B.column_indices, E.column_indices);
+    ASSERT_EQUAL(B.values,         E.values);
+}
+DECLARE_HOST_DEVICE_UNITTEST(TestWriteMatrixMarketFileLarge);
+
+template <typename MemorySpace>
+void TestWriteMatrixMarketFileArray2d(void)
+{
+    cusp::array2d<float, cusp::host_memory, cusp::row_major> E(3, 4);
+    for (size_t i = 0; i < E.num_rows; i++)
+        for (size_t j = 0; j < E.num_cols; j++)
+            E(i,j) = float(10 * i + j) / 4.0f;
+
+    cusp::array2d<float, MemorySpace, cusp::row_major> A(E);
+    cusp::io::write_matrix_market_file(A, random_file_name);
+
+    cusp::array2d<float, cusp::host_memory> B;
+    cusp::io::read_matrix_market_file(B, random_file_name);
+
+    remove(random_file_name);
+
+    ASSERT_EQUAL(B == E, true);
+}
+DECLARE_HOST_DEVICE_UNITTEST(TestWriteMatrixMarketFileArray2d);
+
+template <typename MemorySpace>
+void TestReadMatrixMarketFileDirectCsr(void)
+{
+    {
+        std::ofstream file(random_file_name);
+        file << "%%MatrixMarket matrix coordinate real symmetric\n";
+        file << "5 5 7\n";
+        file << "5 1 1.5\n";
+        file << "3 3 2.0\n";
+        file << "4 2 -1.0\n";
+        file << "2 1 3.0\n";
+        file << "5 4 0.5\n";
+        file << "1 1 4.0\n";
+        file << "4 2 6.0\n";
+    }
+
+    // reference result through the stream reader and COO
+    cusp::coo_matrix<int, float, cusp::host_memory> coo;
+    {
+        std::ifstream file(random_file_name);
+        cusp::io::read_matrix_market_stream(coo, file);
+    }
+
+    cusp::csr_matrix<int, float, cusp::host_memory> expected(coo);
+
+    // loaded in two passes straight into the CSR arrays
+    cusp::csr_matrix<int, float, MemorySpace> csr;
+    cusp::io::read_matrix_market_file(csr, random_file_name);
+
+    remove(random_file_name);
+
+    ASSERT_EQUAL(csr.num_rows,       expected.num_rows);
+    ASSERT_EQUAL(csr.num_cols,       expected.num_cols);
+    ASSERT_EQUAL(csr.num_entries,    12);
+    ASSERT_EQUAL(csr.row_offsets,    expected.row_offsets);
+    ASSERT_EQUAL(csr.column_indices, expected.column_indices);
+    ASSERT_EQUAL(csr.values,         expected.values);
+}
+DECLARE_HOST_DEVICE_UNITTEST(TestReadMatrixMarketFileDirectCsr);
+
+// appends every block to a host coo_matrix
+struct append_block
+{
+    cusp::coo_matrix<int, float, cusp::host_memory>* result;
+    size_t* num_blocks;
+
+    template <typename Matrix>
+    void operator()(Matrix& block)
+    {
+        ASSERT_EQUAL(block.num_rows, 5);
+        ASSERT_EQUAL(block.num_cols, 5);
+        ASSERT_EQUAL(block.num_entries <= 3, true);
+
+        const size_t offset = result->num_entries;
+        result->resize(block.num_rows, block.num_cols, offset + block.num_entries);
+
+        for (size_t n = 0; n < block.num_entries; n++)
+        {
+            result->row_indices[offset + n]    = block.row_indices[n];
+            result->column_indices[offset + n] = block.column_indices[n];
+            result->values[offset + n]         = block.values[n];
+        }
+
+        (*num_blocks)++;
+    }
+};
+
+void TestReadMatrixMarketFileBlocks(void)
+{
+    {
+        std::ofstream file(random_file_name);
+        file << "%%MatrixMarket matrix coordinate real skew-symmetric\n";
+        file << "% entries of the lower triangle\n";
+        file << "\n";
+        file << "5 5 4\n";
+        file << "2 1 1.5\n";
+        file << "3 1 -2.25e+00\n";
+        file << "\n";
+        file << "4 3 7\n";
+        file << "5 2 0.5\n";
+    }
+
+    cusp::io::matrix_market_header header = cusp::io::read_matrix_market_header(random_file_name);
+
+    ASSERT_EQUAL(header.storage,     "coordinate");
+    ASSERT_EQUAL(header.type,        "real");
+    ASSERT_EQUAL(header.symmetry,    "skew-symmetric");
+    ASSERT_EQUAL(header.num_rows,    5);
+    ASSERT_EQUAL(header.num_cols,    5);
+    ASSERT_EQUAL(header.num_entries, 4);
+
+    cusp::coo_matrix<int, float, cusp::host_memory> A;
+    cusp::io::read_matrix_market_file(A, random_file_name);
+
+    // mirrored entries straddle the block boundaries
+    cusp::coo_matrix<int, float, cusp::host_memory> B(5, 5, 0);
+    cusp::coo_matrix<int, float, cusp::host_memory> block;
+    size_t num_blocks = 0;
+    append_block f = { &B, &num_blocks };
+
+    size_t num_entries = cusp::io::read_matrix_market_file_blocks(block, random_file_name, 3, f);
+
+    ASSERT_EQUAL(num_entries, 8);
+    ASSERT_EQUAL(num_blocks,  3);
+    ASSERT_EQUAL(block.num_entries, 0);
+
+    B.sort_by_row_and_column();
+
+    ASSERT_EQUAL(B.row_indices,    A.row_indices);
+    ASSERT_EQUAL(B.column_indices, A.column_indices);
+    ASSERT_EQUAL(B.values,         A.values);
+
+    // missing entries
+    {
+        std::ofstream file(random_file_name);
+        file << "%%MatrixMarket matrix coordinate real general\n";
+        file << "5 5 3\n";
+        file << "2 1 1.5\n";
+        file << "3 1 -2.25e+00\n";
+    }
+
+    ASSERT_THROWS(cusp::io::read_matrix_market_file_blocks(block, random_file_name, 3, f), cusp::io_exception);
+
+    remove(random_file_name);
+}
+DECLARE_UNITTEST(TestReadMatrixMarketFileBlocks);
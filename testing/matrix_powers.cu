@@ -0,0 +1,106 @@
+#include <unittest/unittest.h>
+
+#include <cusp/matrix_powers.h>
+
+#include <cusp/array1d.h>
+#include <cusp/array2d.h>
+#include <cusp/csr_matrix.h>
+#include <cusp/dia_matrix.h>
+#include <cusp/multiply.h>
+
+#include <cusp/blas/blas.h>
+#include <cusp/gallery/poisson.h>
+
+template <typename MatrixType, typename ShiftArray>
+void verify_matrix_powers(const MatrixType& A, const ShiftArray& shifts)
+{
+    typedef typename MatrixType::memory_space MemorySpace;
+
+    const size_t s = shifts.size();
+
+    cusp::array1d<double, cusp::host_memory> x(A.num_rows);
+    for(size_t i = 0; i < x.size(); i++)
+        x[i] = (i % 7) - 3.0;
+
+    // the reference basis, one multiply per power
+    cusp::csr_matrix<int, double, cusp::host_memory> B(A);
+    cusp::array2d<double, cusp::host_memory, cusp::column_major> W(A.num_rows, s + 1);
+
+    cusp::blas::copy(x, W.column(0));
+    for(size_t k = 0; k < s; k++)
+    {
+        cusp::array1d<double, cusp::host_memory> y(A.num_rows);
+        cusp::multiply(B, W.column(k), y);
+        cusp::blas::axpy(W.column(k), y, -double(shifts[k]));
+        cusp::blas::copy(y, W.column(k + 1));
+    }
+
+    cusp::array1d<double, MemorySpace> _x(x);
+    cusp::array2d<double, MemorySpace, cusp::column_major> V(A.num_rows, s + 1, -1);
+
+    cusp::matrix_powers(A, _x, V, shifts);
+
+    cusp::array2d<double, cusp::host_memory, cusp::column_major> _V(V);
+
+    ASSERT_ALMOST_EQUAL(_V.values, W.values);
+}
+
+template <class MemorySpace>
+void TestMatrixPowers(void)
+{
+    cusp::csr_matrix<int, double, MemorySpace> A;
+    cusp::gallery::poisson5pt(A, 23, 17);
+
+    cusp::dia_matrix<int, double, MemorySpace> D(A);
+
+    cusp::array1d<double, cusp::host_memory> monomial(4, 0);
+    cusp::array1d<double, cusp::host_memory> newton(4);
+    newton[0] = 7.5; newton[1] = 0.5; newton[2] = 6.0; newton[3] = 2.0;
+
+    verify_matrix_powers(A, monomial);
+    verify_matrix_powers(A, newton);
+    verify_matrix_powers(D, monomial);
+    verify_matrix_powers(D, newton);
+
+    // more powers than the tiles of the DIA kernel cover
+    cusp::array1d<double, cusp::host_memory> many(12, 4.0);
+    verify_matrix_powers(D, many);
+}
+DECLARE_HOST_DEVICE_UNITTEST(TestMatrixPowers);
+
+template <class MemorySpace>
+void TestMatrixPowersMonomial(void)
+{
+    cusp::dia_matrix<int, double, MemorySpace> A;
+    cusp::gallery::poisson5pt(A, 10, 10);
+
+    cusp::array1d<double, MemorySpace> x(A.num_rows, 1);
+    cusp::array2d<double, MemorySpace, cusp::column_major> V(A.num_rows, 3);
+
+    cusp::matrix_powers(A, x, V, 2);
+
+    cusp::array1d<double, MemorySpace> y(A.num_rows);
+    cusp::array1d<double, MemorySpace> z(A.num_rows);
+    cusp::multiply(A, x, y);
+    cusp::multiply(A, y, z);
+
+    ASSERT_ALMOST_EQUAL(V.column(1), y);
+    ASSERT_ALMOST_EQUAL(V.column(2), z);
+}
+DECLARE_HOST_DEVICE_UNITTEST(TestMatrixPowersMonomial);
+
+void TestMatrixPowersInvalidInput(void)
+{
+    cusp::csr_matrix<int, double, cusp::host_memory> A(4, 5, 0);
+    cusp::array1d<double, cusp::host_memory> x(4, 1);
+    cusp::array2d<double, cusp::host_memory, cusp::column_major> V(4, 3);
+
+    ASSERT_THROWS(cusp::matrix_powers(A, x, V, 2), cusp::invalid_input_exception);
+
+    cusp::csr_matrix<int, double, cusp::host_memory> B;
+    cusp::gallery::poisson5pt(B, 2, 2);
+
+    // too few columns for the basis
+    ASSERT_THROWS(cusp::matrix_powers(B, x, V, 3), cusp::invalid_input_exception);
+}
+DECLARE_UNITTEST(TestMatrixPowersInvalidInput);
@@ -1,6 +1,14 @@
 #include <unittest/unittest.h>
 
+#include <cusp/array1d.h>
+#include <cusp/array2d.h>
+#include <cusp/csr_matrix.h>
+#include <cusp/hyb_matrix.h>
 #include <cusp/memory.h>
+#include <cusp/multiply.h>
+#include <cusp/prefetch.h>
+
+#include <cusp/gallery/poisson.h>
 
 void TestMinimumSpace(void)
 {
@@ -33,3 +41,74 @@ void TestMinimumSpace(void)
 }
 DECLARE_UNITTEST(TestMinimumSpace);
 
+
+void TestMinimumSpacePinnedManaged(void)
+{
+    typedef cusp::host_memory    H;
+    typedef cusp::device_memory  D;
+    typedef cusp::pinned_memory  P;
+    typedef cusp::managed_memory M;
+
+    ASSERT_EQUAL(((bool) thrust::detail::is_convertible<P, H>::value), true);
+    ASSERT_EQUAL(((bool) thrust::detail::is_convertible<M, D>::value), true);
+
+    ASSERT_EQUAL(((bool) thrust::detail::is_same<cusp::minimum_space<P,H>::type, H>::value), true);
+    ASSERT_EQUAL(((bool) thrust::detail::is_same<cusp::minimum_space<M,D>::type, D>::value), true);
+}
+DECLARE_UNITTEST(TestMinimumSpacePinnedManaged);
+
+template <typename MemorySpace>
+void TestPinnedManagedContainers(void)
+{
+    typedef cusp::csr_matrix<int, float, cusp::host_memory> HostMatrix;
+
+    HostMatrix A;
+    cusp::gallery::poisson5pt(A, 40, 30);
+
+    cusp::csr_matrix<int, float, MemorySpace> B(A);
+    cusp::hyb_matrix<int, float, MemorySpace> C(A);
+
+    cusp::array1d<float, cusp::host_memory> x(A.num_cols);
+    for (size_t i = 0; i < x.size(); i++)
+        x[i] = float(i % 9) - 4.0f;
+
+    cusp::array1d<float, MemorySpace> y(x);
+    cusp::array1d<float, MemorySpace> z(A.num_rows, 0);
+    cusp::array1d<float, MemorySpace> w(A.num_rows, 0);
+
+    cusp::prefetch(B, cusp::device_memory());
+    cusp::advise(C, cusp::advise_read_mostly, cusp::device_memory());
+
+    cusp::multiply(B, y, z);
+    cusp::multiply(C, y, w);
+
+    cusp::prefetch(z, cusp::host_memory());
+
+    cusp::array1d<float, cusp::host_memory> expected(A.num_rows, 0);
+    cusp::multiply(A, x, expected);
+
+    ASSERT_EQUAL(z, expected);
+    ASSERT_EQUAL(w, expected);
+
+    // conversions to the other memory spaces
+    HostMatrix D(B);
+    ASSERT_EQUAL(D.row_offsets,    A.row_offsets);
+    ASSERT_EQUAL(D.column_indices, A.column_indices);
+    ASSERT_EQUAL(D.values,         A.values);
+
+    cusp::array2d<float, cusp::host_memory>   E(C);
+    cusp::array2d<float, cusp::host_memory>   F(A);
+    ASSERT_EQUAL(E == F, true);
+}
+
+void TestPinnedMemoryContainers(void)
+{
+    TestPinnedManagedContainers<cusp::pinned_memory>();
+}
+DECLARE_UNITTEST(TestPinnedMemoryContainers);
+
+void TestManagedMemoryContainers(void)
+{
+    TestPinnedManagedContainers<cusp::managed_memory>();
+}
+DECLARE_UNITTEST(TestManagedMemoryContainers);
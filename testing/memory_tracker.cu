@@ -0,0 +1,115 @@
+#include <unittest/unittest.h>
+
+#include <cusp/memory.h>
+#include <cusp/memory_tracker.h>
+#include <cusp/tracking_allocator.h>
+
+#include <thrust/device_malloc_allocator.h>
+#include <thrust/device_vector.h>
+#include <thrust/host_vector.h>
+
+#include <memory>
+#include <sstream>
+
+// the suite is built without CUSP_MEMORY_TRACKING, so the tests allocate
+// through tracking_allocator explicitly
+
+void TestMemoryTrackerHostPeak(void)
+{
+    typedef cusp::tracking_allocator<std::allocator<float>, cusp::host_memory> Allocator;
+
+    cusp::reset_memory_peaks();
+
+    const size_t base = cusp::memory_usage<cusp::host_memory>().current_bytes;
+
+    {
+        thrust::host_vector<float, Allocator> a(100);
+
+        {
+            thrust::host_vector<float, Allocator> b(50);
+
+            ASSERT_EQUAL(cusp::memory_usage<cusp::host_memory>().current_bytes, base + 600);
+        }
+
+        ASSERT_EQUAL(cusp::memory_usage<cusp::host_memory>().current_bytes, base + 400);
+    }
+
+    cusp::memory_statistics host = cusp::memory_usage<cusp::host_memory>();
+
+    ASSERT_EQUAL(host.current_bytes,   base);
+    ASSERT_EQUAL(host.peak_bytes,      base + 600);
+    ASSERT_EQUAL(host.allocated_bytes, size_t(600));
+    ASSERT_EQUAL(host.allocations,     size_t(2));
+
+    // the peak restarts from the current usage
+    cusp::reset_memory_peaks();
+
+    ASSERT_EQUAL(cusp::memory_usage<cusp::host_memory>().peak_bytes, base);
+    ASSERT_EQUAL(cusp::memory_usage<cusp::host_memory>().allocations, size_t(0));
+}
+DECLARE_UNITTEST(TestMemoryTrackerHostPeak);
+
+void TestMemoryTrackerSpaces(void)
+{
+    typedef cusp::tracking_allocator<thrust::device_malloc_allocator<int>, cusp::device_memory> DeviceAllocator;
+    typedef cusp::tracking_allocator<std::allocator<int>, cusp::pinned_memory>                 PinnedAllocator;
+
+    cusp::reset_memory_peaks();
+
+    const size_t host   = cusp::memory_usage<cusp::host_memory>().current_bytes;
+    const size_t device = cusp::memory_usage<cusp::device_memory>().current_bytes;
+
+    {
+        thrust::device_vector<int, DeviceAllocator> d(256);
+        thrust::host_vector<int, PinnedAllocator>   p(16);
+
+        ASSERT_EQUAL(cusp::memory_usage<cusp::device_memory>().current_bytes, device + 1024);
+        ASSERT_EQUAL(cusp::memory_usage<cusp::pinned_memory>().allocated_bytes, size_t(64));
+        ASSERT_EQUAL(cusp::memory_usage<cusp::host_memory>().current_bytes, host);
+    }
+
+    ASSERT_EQUAL(cusp::memory_usage<cusp::device_memory>().current_bytes, device);
+    ASSERT_EQUAL(cusp::memory_usage<cusp::device_memory>().peak_bytes, device + 1024);
+}
+DECLARE_UNITTEST(TestMemoryTrackerSpaces);
+
+void TestMemoryTrackerOperations(void)
+{
+    typedef cusp::tracking_allocator<std::allocator<double>, cusp::host_memory> Allocator;
+
+    cusp::reset_memory_peaks();
+
+    {
+        cusp::memory_scope setup("setup");
+
+        thrust::host_vector<double, Allocator> a(10);
+
+        {
+            cusp::memory_scope level("level", 3);
+
+            thrust::host_vector<double, Allocator> b(20);
+        }
+    }
+
+    std::map<std::string, cusp::memory_statistics> operations = cusp::operation_memory_usage<cusp::host_memory>();
+
+    if (cusp::memory_tracking_enabled())
+    {
+        ASSERT_EQUAL(operations["setup"].allocated_bytes,   size_t(80));
+        ASSERT_EQUAL(operations["level 3"].allocated_bytes, size_t(160));
+
+        // the peak of the space is seen by every active operation
+        ASSERT_EQUAL(operations["setup"].peak_bytes, operations["level 3"].peak_bytes);
+        ASSERT_EQUAL(cusp::memory_usage<cusp::host_memory>().peak_operation, std::string("setup / level 3"));
+    }
+    else
+    {
+        ASSERT_EQUAL(operations.empty(), true);
+    }
+
+    std::ostringstream json;
+    cusp::write_memory_usage_json(json);
+
+    ASSERT_EQUAL(json.str().find("\"device\"") != std::string::npos, true);
+}
+DECLARE_UNITTEST(TestMemoryTrackerOperations);
@@ -1,7 +1,12 @@
 #include <unittest/unittest.h>
 
+#include <cusp/csr_matrix.h>
+#include <cusp/linear_operator.h>
 #include <cusp/monitor.h>
 
+#include <cusp/gallery/poisson.h>
+#include <cusp/krylov/cg.h>
+
 template <typename MemorySpace>
 void TestMonitorSimple(void)
 {
@@ -67,3 +72,105 @@ void TestMonitorSimple(void)
 }
 DECLARE_HOST_DEVICE_UNITTEST(TestMonitorSimple);
 
+
+template <typename MemorySpace>
+void TestMonitorCheckInterval(void)
+{
+    cusp::array1d<float,MemorySpace> b(2);
+    b[0] = 10;
+    b[1] =  0;
+
+    cusp::array1d<float,MemorySpace> r(2);
+    r[0] = 10;
+    r[1] =  0;
+
+    cusp::monitor<float> monitor(b, 7, 0.5, 1.0, false, 3);
+
+    ASSERT_EQUAL(monitor.check_interval(), 3);
+    ASSERT_EQUAL(monitor.finished(r), false);
+    ASSERT_EQUAL(monitor.residual_norm(), 10.0);
+    ASSERT_EQUAL(monitor.residuals.size(), 1);
+
+    r[0] = 2;
+
+    // residual is not tested between intervals
+    ++monitor;
+    ASSERT_EQUAL(monitor.finished(r), false);
+    ASSERT_EQUAL(monitor.residual_norm(), 10.0);
+    ++monitor;
+    ASSERT_EQUAL(monitor.finished(r), false);
+    ASSERT_EQUAL(monitor.residuals.size(), 1);
+
+    ++monitor;
+    ASSERT_EQUAL(monitor.finished(r), true);
+    ASSERT_EQUAL(monitor.iteration_count(), 3);
+    ASSERT_EQUAL(monitor.residual_norm(), 2.0);
+    ASSERT_EQUAL(monitor.residuals.size(), 2);
+
+    // the iteration limit is always tested
+    r[0] = 7;
+    monitor.reset(b);
+
+    for (size_t i = 0; i < 7; i++)
+    {
+        ASSERT_EQUAL(monitor.finished(r), false);
+        ++monitor;
+    }
+
+    ASSERT_EQUAL(monitor.finished(r), true);
+    ASSERT_EQUAL(monitor.iteration_count(), 7);
+    ASSERT_EQUAL(monitor.residual_norm(), 7.0);
+
+    // an interval of zero behaves like one
+    monitor.set_check_interval(0);
+    ASSERT_EQUAL(monitor.check_interval(), 1);
+}
+DECLARE_HOST_DEVICE_UNITTEST(TestMonitorCheckInterval);
+
+
+template <typename MemorySpace>
+void TestMonitorInstrumentation(void)
+{
+    typedef cusp::csr_matrix<int,float,MemorySpace>       Matrix;
+    typedef cusp::identity_operator<float,MemorySpace>   Preconditioner;
+
+    Matrix A;
+    cusp::gallery::poisson5pt(A, 10, 10);
+
+    Preconditioner M(A.num_rows, A.num_rows);
+
+    cusp::array1d<float,MemorySpace> x(A.num_rows, 0);
+    cusp::array1d<float,MemorySpace> b(A.num_rows, 1);
+
+    cusp::monitor<float> monitor(b, 100, 1e-5);
+
+    ASSERT_EQUAL(monitor.is_instrumented(), false);
+    monitor.set_instrumented();
+    ASSERT_EQUAL(monitor.is_instrumented(), true);
+
+    cusp::monitored_operator<Matrix, cusp::monitor<float> >         A_counted = monitor.instrument_operator(A);
+    cusp::monitored_operator<Preconditioner, cusp::monitor<float> > M_counted = monitor.instrument_preconditioner(M);
+
+    cusp::krylov::cg(A_counted, x, b, monitor, M_counted);
+
+    // one application for the initial residual, one per iteration
+    ASSERT_EQUAL(monitor.converged(), true);
+    ASSERT_EQUAL(monitor.operator_applications(),       monitor.iteration_count() + 1);
+    ASSERT_EQUAL(monitor.preconditioner_applications(), monitor.iteration_count() + 1);
+    ASSERT_EQUAL(monitor.iteration_times.size(),        monitor.iteration_count());
+    ASSERT_EQUAL(monitor.operator_seconds()       >= 0, true);
+    ASSERT_EQUAL(monitor.preconditioner_seconds() >= 0, true);
+    ASSERT_EQUAL(monitor.solve_seconds() >= monitor.operator_seconds(), true);
+
+    // applications are counted without timing
+    monitor.reset(b);
+    monitor.set_instrumented(false);
+    cusp::blas::fill(x, 0);
+
+    cusp::krylov::cg(A_counted, x, b, monitor, M_counted);
+
+    ASSERT_EQUAL(monitor.operator_applications(), monitor.iteration_count() + 1);
+    ASSERT_EQUAL(monitor.operator_seconds(),      0.0);
+    ASSERT_EQUAL(monitor.iteration_times.size(),  0);
+}
+DECLARE_HOST_DEVICE_UNITTEST(TestMonitorInstrumentation);
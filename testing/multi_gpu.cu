@@ -0,0 +1,208 @@
+#include <unittest/unittest.h>
+
+#if THRUST_DEVICE_SYSTEM == THRUST_DEVICE_SYSTEM_CUDA
+
+#include <cusp/array1d.h>
+#include <cusp/blas/blas.h>
+#include <cusp/csr_matrix.h>
+#include <cusp/gallery/poisson.h>
+#include <cusp/graph/multilevel_partition.h>
+#include <cusp/multiply.h>
+
+#include <cusp/system/cuda/multi_gpu.h>
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+namespace mg = cusp::system::cuda::multi_gpu;
+
+// the available devices, a single device holds several parts so that the
+// exchange is exercised on every machine
+std::vector<int> multi_gpu_devices(void)
+{
+    int count = 0;
+    cudaGetDeviceCount(&count);
+
+    std::vector<int> devices;
+
+    for (int d = 0; d < std::min(count, 4); d++)
+        devices.push_back(d);
+
+    while (devices.size() < 3)
+        devices.push_back(devices.empty() ? 0 : devices.back());
+
+    return devices;
+}
+
+template <typename MatrixType>
+void check_multi_gpu_multiply(const MatrixType& A, const cusp::csr_matrix<int, float, cusp::host_memory>& G)
+{
+    cusp::array1d<float, cusp::host_memory> x = unittest::random_samples<float>(G.num_rows);
+    cusp::array1d<float, cusp::host_memory> y(G.num_rows);
+    cusp::array1d<float, cusp::host_memory> z;
+
+    cusp::multiply(G, x, y);
+
+    mg::array1d<float> X(A);
+    mg::array1d<float> Y(A);
+
+    X.scatter(x);
+    mg::multiply(A, X, Y);
+    Y.gather(z);
+
+    ASSERT_ALMOST_EQUAL(z, y);
+
+    // a second product reuses the ghost buffers
+    mg::blas::scal(X, 2.0f);
+    mg::multiply(A, X, Y);
+    Y.gather(z);
+
+    cusp::blas::scal(y, 2.0f);
+
+    ASSERT_ALMOST_EQUAL(z, y);
+}
+
+void TestMultiGpuMultiply(void)
+{
+    cusp::csr_matrix<int, float, cusp::host_memory> G;
+    cusp::gallery::poisson5pt(G, 12, 13);
+
+    std::vector<int> devices = multi_gpu_devices();
+
+    // consecutive blocks of rows
+    mg::csr_matrix<int, float> A(G, devices);
+
+    ASSERT_EQUAL(A.num_parts(), devices.size());
+    ASSERT_EQUAL(A.num_rows,    G.num_rows);
+    ASSERT_EQUAL(A.num_entries, G.num_entries);
+
+    size_t entries = 0;
+
+    for (size_t p = 0; p < A.num_parts(); p++)
+        entries += A.diagonal_block(p).num_entries + A.off_diagonal_block(p).num_entries;
+
+    ASSERT_EQUAL(entries, G.num_entries);
+
+    check_multi_gpu_multiply(A, G);
+
+    // parts of a graph partitioner
+    cusp::array1d<int, cusp::host_memory> parts;
+    cusp::graph::multilevel_partition(G, devices.size(), parts);
+
+    mg::csr_matrix<int, float> B(G, parts, devices);
+
+    check_multi_gpu_multiply(B, G);
+}
+DECLARE_UNITTEST(TestMultiGpuMultiply);
+
+void TestMultiGpuBlas(void)
+{
+    cusp::csr_matrix<int, float, cusp::host_memory> G;
+    cusp::gallery::poisson5pt(G, 10, 10);
+
+    mg::csr_matrix<int, float> A(G, multi_gpu_devices());
+
+    cusp::array1d<float, cusp::host_memory> x = unittest::random_samples<float>(G.num_rows);
+    cusp::array1d<float, cusp::host_memory> y = unittest::random_samples<float>(G.num_rows);
+    cusp::array1d<float, cusp::host_memory> z(G.num_rows);
+    cusp::array1d<float, cusp::host_memory> w;
+
+    mg::array1d<float> X(A), Y(A), Z(A);
+
+    X.scatter(x);
+    Y.scatter(y);
+
+    ASSERT_ALMOST_EQUAL(mg::blas::dot(X, Y),  cusp::blas::dot(x, y));
+    ASSERT_ALMOST_EQUAL(mg::blas::dotc(X, Y), cusp::blas::dotc(x, y));
+    ASSERT_ALMOST_EQUAL(mg::blas::nrm2(X),    cusp::blas::nrm2(x));
+
+    mg::blas::axpby(X, Y, Z, 2.0f, -1.0f);
+    cusp::blas::axpby(x, y, z, 2.0f, -1.0f);
+    Z.gather(w);
+    ASSERT_ALMOST_EQUAL(w, z);
+
+    mg::blas::axpy(X, Z, 3.0f);
+    cusp::blas::axpy(x, z, 3.0f);
+    Z.gather(w);
+    ASSERT_ALMOST_EQUAL(w, z);
+
+    mg::blas::copy(X, Z);
+    Z.gather(w);
+    ASSERT_EQUAL(w, x);
+
+    mg::blas::fill(Z, 5.0f);
+    Z.gather(w);
+    ASSERT_EQUAL(w, cusp::array1d<float, cusp::host_memory>(G.num_rows, 5.0f));
+}
+DECLARE_UNITTEST(TestMultiGpuBlas);
+
+void TestMultiGpuConjugateGradient(void)
+{
+    cusp::csr_matrix<int, float, cusp::host_memory> G;
+    cusp::gallery::poisson5pt(G, 10, 10);
+
+    mg::csr_matrix<int, float> A(G, multi_gpu_devices());
+
+    // cg written with the multi_gpu kernels
+    mg::array1d<float> x(A, 0.0f), b(A, 1.0f), r(A), p(A), y(A);
+
+    mg::blas::copy(b, r);
+    mg::blas::copy(r, p);
+
+    float rho = mg::blas::dot(r, r);
+    const float tolerance = 1e-4f * mg::blas::nrm2(b);
+
+    size_t iteration = 0;
+
+    while (std::sqrt(rho) > tolerance && iteration < 100)
+    {
+        mg::multiply(A, p, y);
+
+        const float alpha = rho / mg::blas::dot(p, y);
+
+        mg::blas::axpy(p, x,  alpha);
+        mg::blas::axpy(y, r, -alpha);
+
+        const float rho_new = mg::blas::dot(r, r);
+
+        mg::blas::axpby(r, p, p, 1.0f, rho_new / rho);
+        rho = rho_new;
+        iteration++;
+    }
+
+    ASSERT_EQUAL(iteration < 100, true);
+
+    // check the residual of the gathered solution
+    cusp::array1d<float, cusp::host_memory> h;
+    x.gather(h);
+
+    cusp::array1d<float, cusp::host_memory> rhs(G.num_rows, 1.0f);
+    cusp::array1d<float, cusp::host_memory> residual(G.num_rows);
+
+    cusp::multiply(G, h, residual);
+    cusp::blas::axpby(residual, rhs, residual, -1.0f, 1.0f);
+
+    ASSERT_EQUAL(cusp::blas::nrm2(residual) < 1e-3 * cusp::blas::nrm2(rhs), true);
+}
+DECLARE_UNITTEST(TestMultiGpuConjugateGradient);
+
+void TestMultiGpuInvalidInput(void)
+{
+    cusp::csr_matrix<int, float, cusp::host_memory> G;
+    cusp::gallery::poisson5pt(G, 4, 4);
+
+    std::vector<int> devices(2, 0);
+
+    cusp::array1d<int, cusp::host_memory> parts(G.num_rows, 2);
+
+    ASSERT_THROWS((mg::csr_matrix<int, float>(G, parts, devices)), cusp::invalid_input_exception);
+    ASSERT_THROWS((mg::csr_matrix<int, float>(G, std::vector<int>())), cusp::invalid_input_exception);
+
+    cusp::csr_matrix<int, float, cusp::host_memory> R(4, 5, 0);
+
+    ASSERT_THROWS((mg::csr_matrix<int, float>(R, devices)), cusp::invalid_input_exception);
+}
+DECLARE_UNITTEST(TestMultiGpuInvalidInput);
+
+#endif
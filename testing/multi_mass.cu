@@ -1,5 +1,6 @@
 #include <unittest/unittest.h>
 
+#include <cusp/array2d.h>
 #include <cusp/csr_matrix.h>
 
 #include <cusp/gallery/poisson.h>
@@ -104,6 +105,38 @@ void TestConjugateGradientM(void)
 }
 DECLARE_HOST_DEVICE_UNITTEST(TestConjugateGradientM);
 
+template <class MemorySpace>
+void TestConjugateGradientMArray2d(void)
+{
+    typedef float ValueType;
+
+    cusp::csr_matrix<int, ValueType, MemorySpace> A;
+
+    cusp::gallery::poisson5pt(A, 10, 10);
+
+    // the large shifts converge long before the small ones and are frozen
+    size_t N_s = 16;
+    cusp::array2d<ValueType, MemorySpace, cusp::column_major> x(A.num_rows, N_s, ValueType(0));
+    cusp::array1d<ValueType, MemorySpace> b(A.num_rows, ValueType(1));
+
+    cusp::array1d<ValueType, MemorySpace> sigma(N_s);
+    for (size_t i = 0; i < N_s; i++)
+        sigma[i] = ValueType(0.1) * ValueType(1 << i);
+
+    cusp::monitor<ValueType> monitor(b, 100, 1e-6);
+
+    cusp::krylov::cg_m(A, x, b, sigma, monitor);
+
+    check_residuals(A, x.values, b, sigma);
+
+    // row-major storage is rejected
+    cusp::array2d<ValueType, MemorySpace, cusp::row_major> y(A.num_rows, N_s, ValueType(0));
+    cusp::monitor<ValueType> monitor2(b, 100, 1e-6);
+
+    ASSERT_THROWS(cusp::krylov::cg_m(A, y, b, sigma, monitor2), cusp::invalid_input_exception);
+}
+DECLARE_HOST_DEVICE_UNITTEST(TestConjugateGradientMArray2d);
+
 template <class LinearOperator, class VectorType1, class VectorType2, class VectorType3>
 void bicgstab_m(my_system& system, LinearOperator& A, VectorType1& x, VectorType2& b, VectorType3& sigma)
 {
@@ -148,3 +181,28 @@ void TestBiConjugateGradientStabilizedMDispatch()
 }
 DECLARE_UNITTEST(TestBiConjugateGradientStabilizedMDispatch);
 
+
+template <class MemorySpace>
+void TestBiConjugateGradientStabilizedMArray2d(void)
+{
+    typedef float ValueType;
+
+    cusp::csr_matrix<int, ValueType, MemorySpace> A;
+
+    cusp::gallery::poisson5pt(A, 10, 10);
+
+    size_t N_s = 8;
+    cusp::array2d<ValueType, MemorySpace, cusp::column_major> x(A.num_rows, N_s, ValueType(0));
+    cusp::array1d<ValueType, MemorySpace> b(A.num_rows, ValueType(1));
+
+    cusp::array1d<ValueType, MemorySpace> sigma(N_s);
+    for (size_t i = 0; i < N_s; i++)
+        sigma[i] = ValueType(0.1) * ValueType(1 << i);
+
+    cusp::monitor<ValueType> monitor(b, 100, 1e-6);
+
+    cusp::krylov::bicgstab_m(A, x, b, sigma, monitor);
+
+    check_residuals(A, x.values, b, sigma);
+}
+DECLARE_HOST_DEVICE_UNITTEST(TestBiConjugateGradientStabilizedMArray2d);
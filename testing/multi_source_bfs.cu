@@ -0,0 +1,122 @@
+#include <unittest/unittest.h>
+
+#include <cusp/graph/multi_source_bfs.h>
+
+#include <cusp/array1d.h>
+#include <cusp/array2d.h>
+#include <cusp/coo_matrix.h>
+#include <cusp/csr_matrix.h>
+
+#include <cusp/gallery/poisson.h>
+
+#include <algorithm>
+#include <queue>
+
+// one breadth-first traversal per source on the host
+template <typename MatrixType>
+cusp::array2d<int, cusp::host_memory>
+ReferenceDistances(const MatrixType& A, const cusp::array1d<int, cusp::host_memory>& sources)
+{
+    cusp::csr_matrix<int, float, cusp::host_memory> G(A);
+    cusp::array2d<int, cusp::host_memory> dist(G.num_rows, sources.size(), -1);
+
+    for(size_t s = 0; s < sources.size(); s++)
+    {
+        std::queue<int> queue;
+        queue.push(sources[s]);
+        dist(sources[s], s) = 0;
+
+        while(!queue.empty())
+        {
+            const int i = queue.front();
+            queue.pop();
+
+            for(int jj = G.row_offsets[i]; jj < G.row_offsets[i + 1]; jj++)
+            {
+                const int j = G.column_indices[jj];
+
+                if(dist(j, s) < 0)
+                {
+                    dist(j, s) = dist(i, s) + 1;
+                    queue.push(j);
+                }
+            }
+        }
+    }
+
+    return dist;
+}
+
+template <class Space>
+void TestMultiSourceBFS(void)
+{
+    // two disjoint grids, so some distances are unreachable
+    cusp::coo_matrix<int, float, cusp::host_memory> P;
+    cusp::gallery::poisson5pt(P, 13, 7);
+
+    cusp::coo_matrix<int, float, cusp::host_memory> A(2 * P.num_rows, 2 * P.num_cols, 2 * P.num_entries);
+
+    for(size_t n = 0; n < P.num_entries; n++)
+    {
+        A.row_indices[n]    = P.row_indices[n];
+        A.column_indices[n] = P.column_indices[n];
+        A.row_indices[n + P.num_entries]    = P.row_indices[n] + P.num_rows;
+        A.column_indices[n + P.num_entries] = P.column_indices[n] + P.num_cols;
+    }
+    thrust::fill(A.values.begin(), A.values.end(), 1.0f);
+
+    // more than one batch, with repeated sources
+    cusp::array1d<int, cusp::host_memory> sources(150);
+    for(size_t s = 0; s < sources.size(); s++)
+        sources[s] = (s * 37) % A.num_rows;
+    sources[70] = sources[3];
+
+    cusp::array2d<int, cusp::host_memory> expected = ReferenceDistances(A, sources);
+
+    cusp::csr_matrix<int, float, Space> G(A);
+    cusp::array1d<int, Space> d_sources(sources);
+
+    {
+        cusp::array2d<int, Space, cusp::row_major> distances(G.num_rows, sources.size());
+        cusp::graph::multi_source_bfs(G, d_sources, distances);
+        ASSERT_EQUAL(distances == expected, true);
+    }
+
+    {
+        cusp::array2d<int, Space, cusp::column_major> distances(G.num_rows, sources.size());
+        cusp::graph::multi_source_bfs(G, d_sources, distances);
+        ASSERT_EQUAL(distances == expected, true);
+    }
+
+    cusp::array1d<int, cusp::host_memory> eccentricities(sources.size(), 0);
+    for(size_t s = 0; s < sources.size(); s++)
+        for(size_t v = 0; v < A.num_rows; v++)
+            eccentricities[s] = std::max(eccentricities[s], expected(v, s));
+
+    cusp::array1d<int, Space> d_eccentricities(sources.size());
+    cusp::graph::multi_source_eccentricity(G, d_sources, d_eccentricities);
+    ASSERT_EQUAL(d_eccentricities, eccentricities);
+}
+DECLARE_HOST_DEVICE_UNITTEST(TestMultiSourceBFS);
+
+template <class Space>
+void TestMultiSourceBFSInvalidInput(void)
+{
+    cusp::csr_matrix<int, float, Space> G;
+    cusp::gallery::poisson5pt(G, 4, 4);
+
+    cusp::array1d<int, Space> sources(2, 0);
+    cusp::array2d<int, Space> distances(G.num_rows, sources.size());
+    cusp::array1d<int, Space> eccentricities(sources.size());
+
+    cusp::array2d<int, Space> narrow(G.num_rows, sources.size() - 1);
+    ASSERT_THROWS(cusp::graph::multi_source_bfs(G, sources, narrow), cusp::invalid_input_exception);
+
+    cusp::array1d<int, Space> small(sources.size() - 1);
+    ASSERT_THROWS(cusp::graph::multi_source_eccentricity(G, sources, small), cusp::invalid_input_exception);
+
+    sources[1] = G.num_rows;
+    ASSERT_THROWS(cusp::graph::multi_source_bfs(G, sources, distances), cusp::invalid_input_exception);
+    ASSERT_THROWS(cusp::graph::multi_source_eccentricity(G, sources, eccentricities), cusp::invalid_input_exception);
+}
+DECLARE_HOST_DEVICE_UNITTEST(TestMultiSourceBFSInvalidInput);
@@ -0,0 +1,77 @@
+#include <unittest/unittest.h>
+
+#include <cusp/graph/multilevel_partition.h>
+
+#include <cusp/array1d.h>
+#include <cusp/csr_matrix.h>
+
+#include <cusp/gallery/poisson.h>
+
+template <class MemorySpace>
+void TestMultilevelPartition(void)
+{
+    const int nx = 60;
+    const size_t num_parts = 4;
+
+    cusp::csr_matrix<int,float,MemorySpace> G;
+    cusp::gallery::poisson5pt(G, nx, nx);
+
+    cusp::array1d<int,MemorySpace> parts(G.num_rows);
+
+    size_t num_cut_edges = cusp::graph::multilevel_partition(G, num_parts, parts);
+
+    cusp::csr_matrix<int,float,cusp::host_memory> h_G(G);
+    cusp::array1d<int,cusp::host_memory> h_parts(parts);
+    cusp::array1d<size_t,cusp::host_memory> sizes(num_parts, 0);
+
+    size_t count = 0;
+
+    for(size_t i = 0; i < h_G.num_rows; i++)
+    {
+        ASSERT_EQUAL(h_parts[i] >= 0 && h_parts[i] < int(num_parts), true);
+        sizes[h_parts[i]]++;
+
+        for(int jj = h_G.row_offsets[i]; jj < h_G.row_offsets[i + 1]; jj++)
+            if(h_parts[h_G.column_indices[jj]] != h_parts[i])
+                count++;
+    }
+
+    ASSERT_EQUAL(num_cut_edges, count / 2);
+
+    // every part is within the default 3% imbalance
+    for(size_t p = 0; p < num_parts; p++)
+        ASSERT_EQUAL(sizes[p] <= size_t(1.03 * h_G.num_rows / num_parts + 1), true);
+
+    // three straight cuts separate the grid into strips with 180 cut edges,
+    // a random assignment cuts about 5300
+    ASSERT_EQUAL(num_cut_edges < size_t(2 * (num_parts - 1) * nx), true);
+}
+DECLARE_HOST_DEVICE_UNITTEST(TestMultilevelPartition);
+
+template <class MemorySpace>
+void TestMultilevelPartitionSinglePart(void)
+{
+    cusp::csr_matrix<int,float,MemorySpace> G;
+    cusp::gallery::poisson5pt(G, 10, 10);
+
+    cusp::array1d<int,MemorySpace> parts(G.num_rows, 7);
+
+    ASSERT_EQUAL(cusp::graph::multilevel_partition(G, 1, parts), size_t(0));
+
+    cusp::array1d<int,MemorySpace> zeros(G.num_rows, 0);
+    ASSERT_EQUAL(parts, zeros);
+}
+DECLARE_HOST_DEVICE_UNITTEST(TestMultilevelPartitionSinglePart);
+
+void TestMultilevelPartitionInvalidInput(void)
+{
+    cusp::csr_matrix<int,float,cusp::host_memory> G;
+    cusp::gallery::poisson5pt(G, 10, 10);
+
+    cusp::array1d<int,cusp::host_memory> parts(G.num_rows);
+    cusp::array1d<int,cusp::host_memory> short_parts(G.num_rows - 1);
+
+    ASSERT_THROWS(cusp::graph::multilevel_partition(G, 0, parts), cusp::invalid_input_exception);
+    ASSERT_THROWS(cusp::graph::multilevel_partition(G, 2, short_parts), cusp::invalid_input_exception);
+}
+DECLARE_UNITTEST(TestMultilevelPartitionInvalidInput);
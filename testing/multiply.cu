@@ -5,6 +5,8 @@
 #include <cusp/gallery/random.h>
 
 #include <cusp/array2d.h>
+#include <cusp/blas/blas.h>
+#include <cusp/complex.h>
 #include <cusp/coo_matrix.h>
 #include <cusp/csr_matrix.h>
 #include <cusp/dia_matrix.h>
@@ -13,6 +15,55 @@
 #include <cusp/permutation_matrix.h>
 
 #include <cusp/multiply.h>
+#include <cusp/transpose.h>
+
+#include <cusp/system/cuda/tuning.h>
+
+#include <thrust/sort.h>
+
+////////////////////////////////////////
+// Dense Matrix-Matrix Multiplication //
+////////////////////////////////////////
+
+template <typename Orientation1, typename Orientation2>
+void _TestBlockedDenseMatrixMatrixMultiply(const size_t M, const size_t K, const size_t N)
+{
+    cusp::array2d<int, cusp::host_memory, Orientation1> A(M, K);
+    cusp::array2d<int, cusp::host_memory, Orientation2> B(K, N);
+
+    for(size_t i = 0; i < M; i++)
+        for(size_t k = 0; k < K; k++)
+            A(i,k) = int((i * 7 + k * 3) % 11) - 5;
+
+    for(size_t k = 0; k < K; k++)
+        for(size_t j = 0; j < N; j++)
+            B(k,j) = int((k * 5 + j) % 9) - 4;
+
+    cusp::array2d<int, cusp::host_memory> expected(M, N, 0);
+
+    for(size_t i = 0; i < M; i++)
+        for(size_t j = 0; j < N; j++)
+            for(size_t k = 0; k < K; k++)
+                expected(i,j) += A(i,k) * B(k,j);
+
+    cusp::array2d<int, cusp::host_memory, Orientation1> C;
+    cusp::multiply(A, B, C);
+
+    ASSERT_EQUAL(C.num_rows, M);
+    ASSERT_EQUAL(C.num_cols, N);
+    ASSERT_EQUAL(C == expected, true);
+}
+
+// sizes that leave partial register blocks, cache blocks and tiles
+void TestBlockedDenseMatrixMatrixMultiply(void)
+{
+    _TestBlockedDenseMatrixMatrixMultiply<cusp::row_major,    cusp::row_major   >(67, 301, 13);
+    _TestBlockedDenseMatrixMatrixMultiply<cusp::row_major,    cusp::column_major>(5,  520, 270);
+    _TestBlockedDenseMatrixMatrixMultiply<cusp::column_major, cusp::row_major   >(130, 33, 259);
+    _TestBlockedDenseMatrixMatrixMultiply<cusp::column_major, cusp::column_major>(71,  257, 9);
+    _TestBlockedDenseMatrixMatrixMultiply<cusp::row_major,    cusp::row_major   >(40, 0, 40);
+}
+DECLARE_UNITTEST(TestBlockedDenseMatrixMatrixMultiply);
 
 /////////////////////////////////////////
 // Sparse Matrix-Matrix Multiplication //
@@ -127,6 +178,233 @@ void TestSparseMatrixMatrixMultiply(void)
 }
 DECLARE_SPARSE_MATRIX_UNITTEST(TestSparseMatrixMatrixMultiply);
 
+template <typename MatrixType>
+void _TestSkewedSparseMatrixMatrixMultiply(const cusp::csr_matrix<int, float, cusp::host_memory>& A,
+                                           const cusp::csr_matrix<int, float, cusp::host_memory>& B,
+                                           const cusp::coo_matrix<int, float, cusp::host_memory>& C)
+{
+    MatrixType _A(A), _B(B), _C;
+    cusp::multiply(_A, _B, _C);
+
+    // explicit zeros may differ between the implementations
+    cusp::array2d<float, cusp::host_memory> expected(C);
+    cusp::array2d<float, cusp::host_memory> result(_C);
+
+    ASSERT_EQUAL(result == expected, true);
+}
+
+template <class MemorySpace>
+void TestSkewedSparseMatrixMatrixMultiply(void)
+{
+    // row lengths of the product range from empty to larger than a shared memory table
+    const int num_rows = 200;
+    const int num_cols = 3000;
+
+    cusp::array1d<int, cusp::host_memory> A_row_lengths(num_rows, 0);
+    cusp::array1d<int, cusp::host_memory> B_row_lengths(num_rows, 0);
+    for(int i = 0; i < num_rows; i += 2)
+    {
+        A_row_lengths[i] = (i % 11) + 1;
+        B_row_lengths[i] = (i % 13) + 1;
+    }
+    A_row_lengths[7]  = 40;
+    A_row_lengths[9]  = 100;
+    B_row_lengths[90] = 1500;
+    B_row_lengths[95] = 800;
+
+    cusp::csr_matrix<int, float, cusp::host_memory> A(num_rows, num_rows,
+                                                       thrust::reduce(A_row_lengths.begin(), A_row_lengths.end()));
+    cusp::csr_matrix<int, float, cusp::host_memory> B(num_rows, num_cols,
+                                                       thrust::reduce(B_row_lengths.begin(), B_row_lengths.end()));
+
+    A.row_offsets[0] = 0;
+    B.row_offsets[0] = 0;
+    for(int i = 0; i < num_rows; i++)
+    {
+        A.row_offsets[i + 1] = A.row_offsets[i] + A_row_lengths[i];
+        B.row_offsets[i + 1] = B.row_offsets[i] + B_row_lengths[i];
+
+        for(int jj = A.row_offsets[i]; jj < A.row_offsets[i + 1]; jj++)
+        {
+            A.column_indices[jj] = (jj - A.row_offsets[i]) * (num_rows / A_row_lengths[i]);
+            A.values[jj] = (jj % 3) - 1;
+        }
+
+        for(int jj = B.row_offsets[i]; jj < B.row_offsets[i + 1]; jj++)
+        {
+            B.column_indices[jj] = (i + (jj - B.row_offsets[i]) * (num_cols / B_row_lengths[i])) % num_cols;
+            B.values[jj] = (jj % 5) - 2;
+        }
+
+        // keep the columns of B sorted
+        thrust::sort_by_key(B.column_indices.begin() + B.row_offsets[i],
+                            B.column_indices.begin() + B.row_offsets[i + 1],
+                            B.values.begin() + B.row_offsets[i]);
+    }
+
+    cusp::coo_matrix<int, float, cusp::host_memory> C;
+    cusp::multiply(A, B, C);
+
+    _TestSkewedSparseMatrixMatrixMultiply< cusp::csr_matrix<int, float, MemorySpace> >(A, B, C);
+    _TestSkewedSparseMatrixMatrixMultiply< cusp::coo_matrix<int, float, MemorySpace> >(A, B, C);
+}
+DECLARE_HOST_DEVICE_UNITTEST(TestSkewedSparseMatrixMatrixMultiply);
+
+template <typename MatrixType>
+void _TestSparseMatrixMatrixMultiplySymbolicNumeric(void)
+{
+    typedef typename MatrixType::memory_space MemorySpace;
+
+    cusp::csr_matrix<int, float, cusp::host_memory> A_host;
+    cusp::gallery::poisson5pt(A_host, 6, 5);
+
+    MatrixType A(A_host), C, expected;
+    cusp::spgemm_plan<int, MemorySpace> plan;
+
+    cusp::spgemm_symbolic(A, A, C, plan);
+    cusp::multiply(A, A, expected);
+
+    ASSERT_EQUAL(C.num_rows, expected.num_rows);
+    ASSERT_EQUAL(C.num_cols, expected.num_cols);
+    ASSERT_EQUAL(C.num_entries, expected.num_entries);
+
+    cusp::spgemm_numeric(A, A, C, plan);
+    {
+        cusp::array2d<float, cusp::host_memory> result(C);
+        cusp::array2d<float, cusp::host_memory> reference(expected);
+        ASSERT_EQUAL(result == reference, true);
+    }
+
+    // change the values of A and reuse the plan
+    for(size_t n = 0; n < A_host.num_entries; n++)
+        A_host.values[n] = float(n % 7) - 3;
+    A = A_host;
+
+    cusp::spgemm_numeric(A, A, C, plan);
+    cusp::multiply(A, A, expected);
+    {
+        cusp::array2d<float, cusp::host_memory> result(C);
+        cusp::array2d<float, cusp::host_memory> reference(expected);
+        ASSERT_EQUAL(result == reference, true);
+    }
+
+    // the plan does not apply to a different pattern
+    MatrixType B(cusp::csr_matrix<int, float, cusp::host_memory>(A_host.num_rows, A_host.num_cols, 0));
+    ASSERT_THROWS(cusp::spgemm_numeric(A, B, C, plan), cusp::invalid_input_exception);
+}
+
+template <class MemorySpace>
+void TestSparseMatrixMatrixMultiplySymbolicNumeric(void)
+{
+    _TestSparseMatrixMatrixMultiplySymbolicNumeric< cusp::csr_matrix<int, float, MemorySpace> >();
+    _TestSparseMatrixMatrixMultiplySymbolicNumeric< cusp::coo_matrix<int, float, MemorySpace> >();
+}
+DECLARE_HOST_DEVICE_UNITTEST(TestSparseMatrixMatrixMultiplySymbolicNumeric);
+
+template <class MemorySpace>
+void TestSparseMatrixMatrixMultiplyWorkspaceLimit(void)
+{
+    cusp::coo_matrix<int, float, cusp::host_memory> A_host;
+    cusp::gallery::poisson5pt(A_host, 10, 10);
+
+    for(size_t n = 0; n < A_host.num_entries; n++)
+        A_host.values[n] = float(n % 7) - 3;
+
+    cusp::coo_matrix<int, float, MemorySpace> A(A_host), C, expected;
+    cusp::multiply(A, A, expected);
+
+    // a few rows per chunk
+    cusp::set_spgemm_workspace_limit(4096);
+    ASSERT_EQUAL(cusp::spgemm_workspace_limit(), size_t(4096));
+
+    cusp::multiply(A, A, C);
+
+    cusp::set_spgemm_workspace_limit(0);
+
+    ASSERT_EQUAL(C.num_entries, expected.num_entries);
+    ASSERT_EQUAL(C.row_indices,    expected.row_indices);
+    ASSERT_EQUAL(C.column_indices, expected.column_indices);
+    ASSERT_EQUAL(C.values,         expected.values);
+}
+DECLARE_HOST_DEVICE_UNITTEST(TestSparseMatrixMatrixMultiplyWorkspaceLimit);
+
+void TestSparseMatrixMatrixMultiplyWorkspaceLimitTooSmall(void)
+{
+    cusp::coo_matrix<int, float, cusp::host_memory> A, C;
+    cusp::gallery::poisson5pt(A, 10, 10);
+
+    // less than the products of a single row
+    cusp::set_spgemm_workspace_limit(64);
+
+    ASSERT_THROWS(cusp::multiply(A, A, C), cusp::runtime_exception);
+
+    cusp::set_spgemm_workspace_limit(0);
+}
+DECLARE_UNITTEST(TestSparseMatrixMatrixMultiplyWorkspaceLimitTooSmall);
+
+template <typename MatrixType>
+void _TestMaskedSparseMatrixMatrixMultiply(void)
+{
+    cusp::csr_matrix<int, float, cusp::host_memory> A_host, M_host;
+    cusp::gallery::poisson5pt(A_host, 5, 4);
+    cusp::gallery::poisson9pt(M_host, 5, 4);
+
+    // use nonuniform values
+    for(size_t n = 0; n < A_host.num_entries; n++)
+        A_host.values[n] = float(n % 5) - 2;
+
+    MatrixType A(A_host), M(M_host), C;
+
+    cusp::masked_spgemm(A, A, M, C);
+
+    cusp::array2d<float, cusp::host_memory> dense_A(A_host);
+    cusp::array2d<float, cusp::host_memory> reference;
+    cusp::multiply(dense_A, dense_A, reference);
+
+    cusp::array2d<float, cusp::host_memory> mask(M_host);
+    for(size_t i = 0; i < reference.num_rows; i++)
+        for(size_t j = 0; j < reference.num_cols; j++)
+            if(mask(i,j) == 0)
+                reference(i,j) = 0;
+
+    cusp::array2d<float, cusp::host_memory> result(C);
+
+    ASSERT_EQUAL(C.num_rows, reference.num_rows);
+    ASSERT_EQUAL(C.num_cols, reference.num_cols);
+    ASSERT_EQUAL(C.num_entries <= M.num_entries, true);
+    ASSERT_EQUAL(result == reference, true);
+
+    // entries of the mask outside the pattern of A * B are not stored
+    cusp::csr_matrix<int, float, cusp::host_memory> D_host(A_host.num_rows, A_host.num_cols, A_host.num_rows);
+    for(size_t i = 0; i < A_host.num_rows; i++)
+    {
+        D_host.row_offsets[i]    = i;
+        D_host.column_indices[i] = i;
+        D_host.values[i]         = 1;
+    }
+    D_host.row_offsets[A_host.num_rows] = A_host.num_rows;
+
+    cusp::csr_matrix<int, float, cusp::host_memory> E_host(A_host.num_rows, A_host.num_cols, 1);
+    E_host.row_offsets[0] = 0;
+    for(size_t i = 1; i <= A_host.num_rows; i++)
+        E_host.row_offsets[i] = 1;
+    E_host.column_indices[0] = A_host.num_cols - 1;
+    E_host.values[0]         = 1;
+
+    MatrixType D(D_host), E(E_host);
+    cusp::masked_spgemm(D, D, E, C);
+
+    ASSERT_EQUAL(C.num_entries, 0);
+}
+
+template <class MemorySpace>
+void TestMaskedSparseMatrixMatrixMultiply(void)
+{
+    _TestMaskedSparseMatrixMatrixMultiply< cusp::csr_matrix<int, float, MemorySpace> >();
+    _TestMaskedSparseMatrixMatrixMultiply< cusp::coo_matrix<int, float, MemorySpace> >();
+}
+DECLARE_HOST_DEVICE_UNITTEST(TestMaskedSparseMatrixMatrixMultiply);
+
 template <typename SparseMatrixType, typename DenseMatrixType>
 void CompareScaledSparseMatrixMatrixMultiply(DenseMatrixType A, DenseMatrixType B)
 {
@@ -511,6 +789,106 @@ void TestSparseMatrixVectorMultiply()
 }
 DECLARE_SPARSE_MATRIX_UNITTEST(TestSparseMatrixVectorMultiply);
 
+template <class MemorySpace>
+void TestSkewedSparseMatrixVectorMultiply(void)
+{
+    // a few long rows among many short and empty ones
+    const int num_rows = 300;
+    const int num_cols = 500;
+
+    cusp::array1d<int, cusp::host_memory> row_lengths(num_rows, 0);
+    for(int i = 0; i < num_rows; i += 3)
+        row_lengths[i] = i % 4;
+    row_lengths[5]   = num_cols;
+    row_lengths[150] = 400;
+    row_lengths[299] = 250;
+
+    cusp::csr_matrix<int, float, cusp::host_memory> A(num_rows, num_cols,
+                                                       thrust::reduce(row_lengths.begin(), row_lengths.end()));
+
+    A.row_offsets[0] = 0;
+    for(int i = 0; i < num_rows; i++)
+    {
+        A.row_offsets[i + 1] = A.row_offsets[i] + row_lengths[i];
+
+        for(int n = 0; n < row_lengths[i]; n++)
+        {
+            A.column_indices[A.row_offsets[i] + n] = (n * num_cols) / row_lengths[i];
+            A.values[A.row_offsets[i] + n]         = float((i + n) % 5) - 2;
+        }
+    }
+
+    cusp::array1d<float, cusp::host_memory> x(num_cols);
+    for(int j = 0; j < num_cols; j++)
+        x[j] = float(j % 7) - 3;
+
+    cusp::array2d<float, cusp::host_memory> dense_A(A);
+    cusp::array1d<float, cusp::host_memory> expected(num_rows);
+    cusp::multiply(dense_A, x, expected);
+
+    cusp::csr_matrix<int, float, MemorySpace> _A(A);
+    cusp::array1d<float, MemorySpace> _x(x);
+    cusp::array1d<float, MemorySpace> _y(num_rows, 10);
+    cusp::multiply(_A, _x, _y);
+
+    ASSERT_EQUAL(_y, expected);
+}
+DECLARE_HOST_DEVICE_UNITTEST(TestSkewedSparseMatrixVectorMultiply);
+
+template <typename ValueType, class MemorySpace>
+void _TestComplexSparseMatrixVectorMultiply(const int max_row_length)
+{
+    typedef typename ValueType::value_type RealType;
+
+    const int num_rows = 200;
+    const int num_cols = 150;
+
+    cusp::array1d<int, cusp::host_memory> row_lengths(num_rows);
+    for(int i = 0; i < num_rows; i++)
+        row_lengths[i] = (i * 7) % (max_row_length + 1);
+
+    cusp::csr_matrix<int, ValueType, cusp::host_memory> A(num_rows, num_cols,
+                                                           thrust::reduce(row_lengths.begin(), row_lengths.end()));
+
+    A.row_offsets[0] = 0;
+    for(int i = 0; i < num_rows; i++)
+    {
+        A.row_offsets[i + 1] = A.row_offsets[i] + row_lengths[i];
+
+        for(int n = 0; n < row_lengths[i]; n++)
+        {
+            A.column_indices[A.row_offsets[i] + n] = (n * num_cols) / row_lengths[i];
+            A.values[A.row_offsets[i] + n]         = ValueType(RealType((i + n) % 5) - 2, RealType((i * n) % 3) - 1);
+        }
+    }
+
+    cusp::array1d<ValueType, cusp::host_memory> x(num_cols);
+    for(int j = 0; j < num_cols; j++)
+        x[j] = ValueType(RealType(j % 7) - 3, RealType(j % 4));
+
+    cusp::array2d<ValueType, cusp::host_memory> dense_A(A);
+    cusp::array1d<ValueType, cusp::host_memory> expected(num_rows);
+    cusp::multiply(dense_A, x, expected);
+
+    cusp::csr_matrix<int, ValueType, MemorySpace> _A(A);
+    cusp::array1d<ValueType, MemorySpace> _x(x);
+    cusp::array1d<ValueType, MemorySpace> _y(num_rows, ValueType(10, 10));
+    cusp::multiply(_A, _x, _y);
+
+    ASSERT_EQUAL(_y, expected);
+}
+
+template <class MemorySpace>
+void TestComplexSparseMatrixVectorMultiply(void)
+{
+    // short rows use narrow vectors, long rows a full warp
+    _TestComplexSparseMatrixVectorMultiply<cusp::complex<float>,  MemorySpace>(3);
+    _TestComplexSparseMatrixVectorMultiply<cusp::complex<float>,  MemorySpace>(90);
+    _TestComplexSparseMatrixVectorMultiply<cusp::complex<double>, MemorySpace>(3);
+    _TestComplexSparseMatrixVectorMultiply<cusp::complex<double>, MemorySpace>(90);
+}
+DECLARE_HOST_DEVICE_UNITTEST(TestComplexSparseMatrixVectorMultiply);
+
 template <typename SparseMatrixType, typename DenseMatrixType>
 void CompareScaledSparseMatrixVectorMultiply(DenseMatrixType A)
 {
@@ -644,6 +1022,528 @@ void TestScaledSparseMatrixVectorMultiply()
 }
 DECLARE_SPARSE_MATRIX_UNITTEST(TestScaledSparseMatrixVectorMultiply);
 
+template <class MemorySpace>
+void TestSkewedCsrMatrixVectorMultiply(void)
+{
+    // a few rows contain most of the nonzeros, empty rows are interleaved
+    const int num_rows = 300;
+    const int num_cols = 20000;
+
+    cusp::array1d<int, cusp::host_memory> row_lengths(num_rows, 0);
+    for(int i = 0; i < num_rows; i += 3)
+        row_lengths[i] = (i % 7) + 1;
+    row_lengths[5]   = num_cols;
+    row_lengths[150] = num_cols / 2;
+    row_lengths[299] = 33;
+
+    cusp::csr_matrix<int, float, cusp::host_memory> A(num_rows, num_cols,
+                                                       thrust::reduce(row_lengths.begin(), row_lengths.end()));
+    A.row_offsets[0] = 0;
+    for(int i = 0; i < num_rows; i++)
+    {
+        A.row_offsets[i + 1] = A.row_offsets[i] + row_lengths[i];
+        for(int jj = A.row_offsets[i]; jj < A.row_offsets[i + 1]; jj++)
+        {
+            A.column_indices[jj] = (jj - A.row_offsets[i]) * (num_cols / row_lengths[i]);
+            A.values[jj] = (jj % 3) - 1;
+        }
+    }
+
+    cusp::array1d<float, cusp::host_memory> x(num_cols);
+    for(int i = 0; i < num_cols; i++)
+        x[i] = i % 10;
+
+    cusp::array1d<float, cusp::host_memory> y(num_rows, 10);
+    cusp::multiply(A, x, y);
+
+    cusp::csr_matrix<int, float, MemorySpace> _A(A);
+    cusp::array1d<float, MemorySpace> _x(x);
+    cusp::array1d<float, MemorySpace> _y(num_rows, 10);
+    cusp::multiply(_A, _x, _y);
+
+    ASSERT_EQUAL(_y, y);
+
+    // generalized operators must also be honored
+    thrust::identity<float>   initialize;
+    thrust::multiplies<float> combine;
+    thrust::plus<float>       reduce;
+
+    cusp::multiply(A, x, y, initialize, combine, reduce);
+    cusp::multiply(_A, _x, _y, initialize, combine, reduce);
+
+    ASSERT_EQUAL(_y, y);
+}
+DECLARE_HOST_DEVICE_UNITTEST(TestSkewedCsrMatrixVectorMultiply);
+
+template <class MemorySpace>
+void _TestStencilDiaMatrixVectorMultiply(const cusp::csr_matrix<int, float, cusp::host_memory>& A)
+{
+    cusp::array1d<float, cusp::host_memory> x(A.num_cols);
+    for(size_t i = 0; i < A.num_cols; i++)
+        x[i] = i % 7;
+
+    cusp::array1d<float, cusp::host_memory> y(A.num_rows, 5);
+    cusp::multiply(A, x, y, cusp::plus_value<float>(1), thrust::multiplies<float>(), thrust::plus<float>());
+
+    cusp::dia_matrix<int, float, MemorySpace> B(A);
+    cusp::array1d<float, MemorySpace> _x(x);
+    cusp::array1d<float, MemorySpace> _y(A.num_rows, 5);
+
+    cusp::multiply(B, _x, _y, cusp::plus_value<float>(1), thrust::multiplies<float>(), thrust::plus<float>());
+
+    ASSERT_EQUAL(_y, y);
+}
+
+template <class MemorySpace>
+void TestStencilDiaMatrixVectorMultiply(void)
+{
+    cusp::csr_matrix<int, float, cusp::host_memory> A;
+
+    // groups of adjacent diagonals far apart from each other
+    cusp::gallery::poisson27pt(A, 12, 12, 12);
+    _TestStencilDiaMatrixVectorMultiply<MemorySpace>(A);
+
+    cusp::gallery::poisson5pt(A, 300, 4);
+    _TestStencilDiaMatrixVectorMultiply<MemorySpace>(A);
+
+    // offsets close enough to share one window
+    cusp::gallery::poisson9pt(A, 20, 70);
+    _TestStencilDiaMatrixVectorMultiply<MemorySpace>(A);
+}
+DECLARE_HOST_DEVICE_UNITTEST(TestStencilDiaMatrixVectorMultiply);
+
+template <class MemorySpace>
+void TestHybMatrixVectorMultiplyWithTail(void)
+{
+    // [10  0 20  0]  only the first entry of every row is
+    // [ 0 30  0  0]  stored in the ELL part, the rest in the COO tail
+    // [ 0  0 40  0]
+    // [50 60 70 80]
+    cusp::hyb_matrix<int, float, cusp::host_memory> A(4, 4, 4, 4, 1);
+    cusp::ell_matrix<int, float, cusp::host_memory>& E = A.ell;
+    cusp::coo_matrix<int, float, cusp::host_memory>& C = A.coo;
+
+    E.column_indices(0,0) = 0; E.values(0,0) = 10;
+    E.column_indices(1,0) = 1; E.values(1,0) = 30;
+    E.column_indices(2,0) = 2; E.values(2,0) = 40;
+    E.column_indices(3,0) = 0; E.values(3,0) = 50;
+
+    C.row_indices[0] = 0; C.column_indices[0] = 2; C.values[0] = 20;
+    C.row_indices[1] = 3; C.column_indices[1] = 1; C.values[1] = 60;
+    C.row_indices[2] = 3; C.column_indices[2] = 2; C.values[2] = 70;
+    C.row_indices[3] = 3; C.column_indices[3] = 3; C.values[3] = 80;
+
+    cusp::hyb_matrix<int, float, MemorySpace> B(A);
+
+    cusp::array1d<float, MemorySpace> x(4);
+    x[0] = 1; x[1] = 2; x[2] = 3; x[3] = 4;
+
+    cusp::array1d<float, MemorySpace> y(4, 5);
+    cusp::multiply(B, x, y);
+
+    ASSERT_EQUAL(y[0],  70);
+    ASSERT_EQUAL(y[1],  60);
+    ASSERT_EQUAL(y[2], 120);
+    ASSERT_EQUAL(y[3], 700);
+
+    // initialize must be applied exactly once per row
+    cusp::array1d<float, MemorySpace> z(4, 5);
+    cusp::multiply(B, x, z, cusp::plus_value<float>(1), thrust::multiplies<float>(), thrust::plus<float>());
+
+    ASSERT_EQUAL(z[0],  76);
+    ASSERT_EQUAL(z[1],  66);
+    ASSERT_EQUAL(z[2], 126);
+    ASSERT_EQUAL(z[3], 706);
+}
+DECLARE_HOST_DEVICE_UNITTEST(TestHybMatrixVectorMultiplyWithTail);
+
+template <typename MemorySpace, typename Orientation>
+void _TestCsrMatrixBlockVectorMultiply(const cusp::csr_matrix<int, float, cusp::host_memory>& A, const size_t k)
+{
+    cusp::array2d<float, cusp::host_memory, Orientation> X(A.num_cols, k);
+    for(size_t i = 0; i < X.num_rows; i++)
+        for(size_t j = 0; j < X.num_cols; j++)
+            X(i,j) = (i + 3 * j) % 11;
+
+    // reference result computed one column at a time
+    cusp::array2d<float, cusp::host_memory, Orientation> Y(A.num_rows, k);
+    for(size_t j = 0; j < k; j++)
+    {
+        cusp::array1d<float, cusp::host_memory> x(A.num_cols);
+        cusp::array1d<float, cusp::host_memory> y(A.num_rows, 0);
+
+        for(size_t i = 0; i < A.num_cols; i++)
+            x[i] = X(i,j);
+
+        cusp::multiply(A, x, y);
+
+        for(size_t i = 0; i < A.num_rows; i++)
+            Y(i,j) = y[i] + 1;
+    }
+
+    cusp::csr_matrix<int, float, MemorySpace> _A(A);
+    cusp::array2d<float, MemorySpace, Orientation> _X(X);
+    cusp::array2d<float, MemorySpace, Orientation> _Y(A.num_rows, k, 1);
+
+    cusp::multiply(_A, _X, _Y, thrust::identity<float>(), thrust::multiplies<float>(), thrust::plus<float>());
+
+    cusp::array2d<float, cusp::host_memory, Orientation> result(_Y);
+    ASSERT_EQUAL(result.values, Y.values);
+}
+
+template <class MemorySpace>
+void TestCsrMatrixBlockVectorMultiply(void)
+{
+    cusp::csr_matrix<int, float, cusp::host_memory> A;
+    cusp::gallery::poisson5pt(A, 13, 11);
+
+    const size_t widths[] = {1, 3, 4, 17, 32, 64, 70};
+
+    for(size_t i = 0; i < sizeof(widths) / sizeof(size_t); i++)
+    {
+        _TestCsrMatrixBlockVectorMultiply<MemorySpace, cusp::row_major>(A, widths[i]);
+        _TestCsrMatrixBlockVectorMultiply<MemorySpace, cusp::column_major>(A, widths[i]);
+    }
+}
+DECLARE_HOST_DEVICE_UNITTEST(TestCsrMatrixBlockVectorMultiply);
+
+template <class MemorySpace>
+void TestMultiplyDotc(void)
+{
+    cusp::csr_matrix<int, float, MemorySpace> A;
+    cusp::gallery::poisson5pt(A, 30, 20);
+
+    cusp::array1d<float, MemorySpace> x(A.num_rows);
+    for(size_t i = 0; i < x.size(); i++)
+        x[i] = int(i % 5) - 2;
+
+    cusp::array1d<float, MemorySpace> y(A.num_rows, 10);
+    cusp::array1d<float, MemorySpace> z(A.num_rows, 10);
+
+    cusp::multiply(A, x, y);
+    float yx = cusp::blas::dotc(y, x);
+
+    ASSERT_ALMOST_EQUAL(cusp::multiply_dotc(A, x, z), yx);
+    ASSERT_EQUAL(z, y);
+
+    // generic operators multiply and reduce separately
+    cusp::coo_matrix<int, float, MemorySpace> B(A);
+    cusp::blas::fill(z, 10);
+
+    ASSERT_ALMOST_EQUAL(cusp::multiply_dotc(B, x, z), yx);
+    ASSERT_EQUAL(z, y);
+}
+DECLARE_HOST_DEVICE_UNITTEST(TestMultiplyDotc);
+
+template <typename TestMatrix, typename DenseMatrixType>
+void CompareSparseMatrixTransposeVectorMultiply(const DenseMatrixType& dense)
+{
+    typedef typename TestMatrix::value_type   ValueType;
+    typedef typename TestMatrix::memory_space MemorySpace;
+
+    cusp::array2d<ValueType, cusp::host_memory> dense_t;
+    cusp::transpose(dense, dense_t);
+
+    cusp::array1d<ValueType, cusp::host_memory> x(dense.num_rows);
+    for(size_t i = 0; i < x.size(); i++)
+        x[i] = int(i % 5) - 2;
+
+    cusp::array1d<ValueType, cusp::host_memory> y(dense.num_cols, 10);
+    cusp::multiply(dense_t, x, y);
+
+    TestMatrix A(dense);
+    cusp::array1d<ValueType, MemorySpace> x_test(x);
+    cusp::array1d<ValueType, MemorySpace> y_test(dense.num_cols, 10);
+
+    cusp::multiply_transpose(A, x_test, y_test);
+
+    ASSERT_ALMOST_EQUAL(y_test, y);
+}
+
+template <class TestMatrix>
+void TestSparseMatrixTransposeVectorMultiply()
+{
+    typedef typename TestMatrix::value_type   ValueType;
+
+    cusp::array2d<ValueType, cusp::host_memory> A(5,4,0);
+    A(0,0) = 13;
+    A(0,1) = 80;
+    A(1,1) = 27;
+    A(2,0) = 55;
+    A(2,2) = 24;
+    A(2,3) = 42;
+    A(3,1) = 69;
+    A(3,3) = 83;
+    A(4,2) = 27;
+
+    cusp::array2d<ValueType, cusp::host_memory> B(2,3,0);
+
+    cusp::array2d<ValueType, cusp::host_memory> C;
+    cusp::gallery::poisson5pt(C, 8, 3);
+
+    cusp::coo_matrix<int, ValueType, cusp::host_memory> R;
+    cusp::gallery::random(R, 40, 70, 300);
+    cusp::array2d<ValueType, cusp::host_memory> D(R);
+
+    CompareSparseMatrixTransposeVectorMultiply<TestMatrix>(A);
+    CompareSparseMatrixTransposeVectorMultiply<TestMatrix>(B);
+    CompareSparseMatrixTransposeVectorMultiply<TestMatrix>(C);
+    CompareSparseMatrixTransposeVectorMultiply<TestMatrix>(D);
+}
+DECLARE_SPARSE_MATRIX_UNITTEST(TestSparseMatrixTransposeVectorMultiply);
+
+template <typename ValueType, typename MemorySpace>
+void _TestComplexSparseMatrixTransposeVectorMultiply(void)
+{
+    typedef typename ValueType::value_type RealType;
+
+    // many rows share every column, so the updates of y collide
+    const int num_rows = 200;
+    const int num_cols = 17;
+
+    cusp::coo_matrix<int, ValueType, cusp::host_memory> A(num_rows, num_cols, 3 * num_rows);
+    for(int i = 0; i < num_rows; i++)
+    {
+        for(int n = 0; n < 3; n++)
+        {
+            A.row_indices[3 * i + n]    = i;
+            A.column_indices[3 * i + n] = (i + 5 * n) % num_cols;
+            A.values[3 * i + n]         = ValueType(RealType((i + n) % 5) - 2, RealType((i * n) % 3) - 1);
+        }
+    }
+    A.sort_by_row_and_column();
+
+    cusp::array1d<ValueType, cusp::host_memory> x(num_rows);
+    for(int i = 0; i < num_rows; i++)
+        x[i] = ValueType(RealType(i % 7) - 3, RealType(i % 4));
+
+    // small integer parts keep every sum exact
+    cusp::coo_matrix<int, ValueType, cusp::host_memory> At;
+    cusp::transpose(A, At);
+
+    cusp::array1d<ValueType, cusp::host_memory> expected(num_cols);
+    cusp::multiply(At, x, expected);
+
+    cusp::array1d<ValueType, MemorySpace> _x(x);
+
+    {
+        cusp::coo_matrix<int, ValueType, MemorySpace> _A(A);
+        cusp::array1d<ValueType, MemorySpace> _y(num_cols, ValueType(10, 10));
+        cusp::multiply_transpose(_A, _x, _y);
+
+        ASSERT_EQUAL(_y, expected);
+    }
+
+    {
+        cusp::csr_matrix<int, ValueType, MemorySpace> _A(A);
+        cusp::array1d<ValueType, MemorySpace> _y(num_cols, ValueType(10, 10));
+        cusp::multiply_transpose(_A, _x, _y);
+
+        ASSERT_EQUAL(_y, expected);
+    }
+}
+
+template <class MemorySpace>
+void TestComplexSparseMatrixTransposeVectorMultiply(void)
+{
+    _TestComplexSparseMatrixTransposeVectorMultiply<cusp::complex<float>,  MemorySpace>();
+    _TestComplexSparseMatrixTransposeVectorMultiply<cusp::complex<double>, MemorySpace>();
+}
+DECLARE_HOST_DEVICE_UNITTEST(TestComplexSparseMatrixTransposeVectorMultiply);
+
+template <typename MatrixType>
+void _TestMixedPrecisionMatrixVectorMultiply(const cusp::coo_matrix<int, float, cusp::host_memory>& A)
+{
+    typedef typename MatrixType::memory_space MemorySpace;
+
+    MatrixType _A(A);
+
+    cusp::array1d<double, MemorySpace> x(A.num_cols, 1);
+    cusp::array1d<double, MemorySpace> y(A.num_rows, 0);
+
+    cusp::multiply(_A, x, y);
+
+    // 2^24 + 1 is not representable in single precision
+    ASSERT_EQUAL(y[0], 16777217.0);
+    ASSERT_EQUAL(y[1], 16777217.0);
+    ASSERT_EQUAL(y[2],        2.0);
+}
+
+template <class MemorySpace>
+void TestMixedPrecisionMatrixVectorMultiply(void)
+{
+    // [2^24  1  0]
+    // [   1  0  2^24]
+    // [   0  1  1]
+    cusp::coo_matrix<int, float, cusp::host_memory> A(3, 3, 6);
+    A.row_indices[0] = 0; A.column_indices[0] = 0; A.values[0] = 16777216;
+    A.row_indices[1] = 0; A.column_indices[1] = 1; A.values[1] = 1;
+    A.row_indices[2] = 1; A.column_indices[2] = 0; A.values[2] = 1;
+    A.row_indices[3] = 1; A.column_indices[3] = 2; A.values[3] = 16777216;
+    A.row_indices[4] = 2; A.column_indices[4] = 1; A.values[4] = 1;
+    A.row_indices[5] = 2; A.column_indices[5] = 2; A.values[5] = 1;
+
+    _TestMixedPrecisionMatrixVectorMultiply< cusp::csr_matrix<int, float, MemorySpace> >(A);
+    _TestMixedPrecisionMatrixVectorMultiply< cusp::ell_matrix<int, float, MemorySpace> >(A);
+    _TestMixedPrecisionMatrixVectorMultiply< cusp::hyb_matrix<int, float, MemorySpace> >(A);
+}
+DECLARE_HOST_DEVICE_UNITTEST(TestMixedPrecisionMatrixVectorMultiply);
+
+template <typename SparseMatrixType>
+void _TestTunedSparseMatrixVectorMultiply(const cusp::csr_matrix<int, float, cusp::host_memory>& A)
+{
+    cusp::array1d<float, cusp::host_memory> x(A.num_cols);
+    for(size_t i = 0; i < A.num_cols; i++)
+        x[i] = i % 7;
+
+    cusp::array1d<float, cusp::host_memory> y(A.num_rows);
+    cusp::multiply(A, x, y);
+
+    SparseMatrixType _A(A);
+    cusp::array1d<float, cusp::device_memory> _x(x);
+
+    // every candidate and the cached winner must produce the same result
+    for(int i = 0; i < 16; i++)
+    {
+        cusp::array1d<float, cusp::device_memory> _y(A.num_rows, 10);
+        cusp::multiply(_A, _x, _y);
+
+        ASSERT_EQUAL(_y, y);
+    }
+}
+
+void TestTunedSparseMatrixVectorMultiply(void)
+{
+    cusp::csr_matrix<int, float, cusp::host_memory> A;
+    cusp::gallery::poisson5pt(A, 40, 30);
+
+    cusp::system::cuda::enable_spmv_tuning();
+
+    _TestTunedSparseMatrixVectorMultiply< cusp::csr_matrix<int, float, cusp::device_memory> >(A);
+    _TestTunedSparseMatrixVectorMultiply< cusp::dia_matrix<int, float, cusp::device_memory> >(A);
+    _TestTunedSparseMatrixVectorMultiply< cusp::ell_matrix<int, float, cusp::device_memory> >(A);
+
+    cusp::system::cuda::disable_spmv_tuning();
+    cusp::system::cuda::clear_spmv_tuning();
+}
+DECLARE_UNITTEST(TestTunedSparseMatrixVectorMultiply);
+
+template <typename SparseMatrixType>
+void _TestStreamSparseMatrixVectorMultiply(const cusp::csr_matrix<int, float, cusp::host_memory>& A)
+{
+    cusp::array1d<float, cusp::host_memory> x(A.num_cols);
+    for(size_t i = 0; i < A.num_cols; i++)
+        x[i] = i % 5;
+
+    cusp::array1d<float, cusp::host_memory> y(A.num_rows);
+    cusp::multiply(A, x, y);
+
+    SparseMatrixType _A(A);
+    cusp::array1d<float, cusp::device_memory> _x(x);
+    cusp::array1d<float, cusp::device_memory> _y(A.num_rows, 10);
+
+    cudaStream_t s;
+    cudaStreamCreate(&s);
+
+    cusp::multiply(cusp::cuda::par.on(s), _A, _x, _y);
+    cudaStreamSynchronize(s);
+
+    ASSERT_EQUAL(_y, y);
+
+    cudaStreamDestroy(s);
+}
+
+void TestStreamSparseMatrixVectorMultiply(void)
+{
+    cusp::csr_matrix<int, float, cusp::host_memory> A;
+    cusp::gallery::poisson5pt(A, 40, 30);
+
+    _TestStreamSparseMatrixVectorMultiply< cusp::coo_matrix<int, float, cusp::device_memory> >(A);
+    _TestStreamSparseMatrixVectorMultiply< cusp::csr_matrix<int, float, cusp::device_memory> >(A);
+    _TestStreamSparseMatrixVectorMultiply< cusp::dia_matrix<int, float, cusp::device_memory> >(A);
+    _TestStreamSparseMatrixVectorMultiply< cusp::ell_matrix<int, float, cusp::device_memory> >(A);
+    _TestStreamSparseMatrixVectorMultiply< cusp::hyb_matrix<int, float, cusp::device_memory> >(A);
+}
+DECLARE_UNITTEST(TestStreamSparseMatrixVectorMultiply);
+
+// short rows of 0 to 9 entries with one medium and one very long row
+void _MakeSkewedRowMatrix(cusp::csr_matrix<int, float, cusp::host_memory>& A)
+{
+    const int num_rows = 2000;
+    const int num_cols = 12000;
+
+    cusp::array1d<int, cusp::host_memory> row_lengths(num_rows);
+    for(int i = 0; i < num_rows; i++)
+        row_lengths[i] = (i * 7) % 10;
+    row_lengths[500]  = 300;
+    row_lengths[1500] = 10000;
+
+    A.resize(num_rows, num_cols, 0);
+    A.row_offsets[0] = 0;
+    for(int i = 0; i < num_rows; i++)
+        A.row_offsets[i + 1] = A.row_offsets[i] + row_lengths[i];
+
+    A.resize(num_rows, num_cols, A.row_offsets[num_rows]);
+    for(int i = 0; i < num_rows; i++)
+    {
+        for(int jj = A.row_offsets[i]; jj < A.row_offsets[i + 1]; jj++)
+        {
+            A.column_indices[jj] = (i + (jj - A.row_offsets[i]) * 3) % num_cols;
+            A.values[jj] = float(jj % 3) - 1;
+        }
+    }
+}
+
+template <typename SparseMatrixType>
+void _TestSkewedSparseMatrixVectorMultiply(const cusp::csr_matrix<int, float, cusp::host_memory>& A)
+{
+    cusp::array1d<float, cusp::host_memory> x(A.num_cols);
+    for(size_t i = 0; i < A.num_cols; i++)
+        x[i] = i % 7;
+
+    cusp::array1d<float, cusp::host_memory> y(A.num_rows);
+    cusp::multiply(A, x, y);
+
+    SparseMatrixType _A(A);
+    cusp::array1d<float, cusp::device_memory> _x(x);
+
+    // the second call reuses any state cached by the first
+    for(int i = 0; i < 2; i++)
+    {
+        cusp::array1d<float, cusp::device_memory> _y(A.num_rows, 10);
+        cusp::multiply(_A, _x, _y);
+
+        ASSERT_EQUAL(_y, y);
+    }
+}
+
+void TestAdaptiveSparseMatrixVectorMultiply(void)
+{
+    // every bin of the CSR-Adaptive kernels is populated
+    cusp::csr_matrix<int, float, cusp::host_memory> A;
+    _MakeSkewedRowMatrix(A);
+
+    cusp::system::cuda::set_csr_spmv_method(cusp::system::cuda::csr_spmv_adaptive);
+
+    _TestSkewedSparseMatrixVectorMultiply< cusp::csr_matrix<int, float, cusp::device_memory> >(A);
+
+    cusp::system::cuda::set_csr_spmv_method(cusp::system::cuda::csr_spmv_default);
+    cusp::system::cuda::clear_spmv_tuning();
+}
+DECLARE_UNITTEST(TestAdaptiveSparseMatrixVectorMultiply);
+
+void TestSkewedCooSparseMatrixVectorMultiply(void)
+{
+    // the long row spans many tiles of the COO kernel and most of it ends
+    // up in the COO tail of the HYB matrix
+    cusp::csr_matrix<int, float, cusp::host_memory> A;
+    _MakeSkewedRowMatrix(A);
+
+    _TestSkewedSparseMatrixVectorMultiply< cusp::coo_matrix<int, float, cusp::device_memory> >(A);
+    _TestSkewedSparseMatrixVectorMultiply< cusp::hyb_matrix<int, float, cusp::device_memory> >(A);
+}
+DECLARE_UNITTEST(TestSkewedCooSparseMatrixVectorMultiply);
+
 //////////////////////////////
 // General Linear Operators //
 //////////////////////////////
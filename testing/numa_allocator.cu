@@ -0,0 +1,54 @@
+#include <unittest/unittest.h>
+
+#include <cusp/numa_allocator.h>
+#include <cusp/array1d.h>
+#include <cusp/csr_matrix.h>
+#include <cusp/multiply.h>
+
+#include <cusp/gallery/poisson.h>
+
+#include <vector>
+
+void TestNumaAllocator(void)
+{
+    typedef std::vector<double, cusp::numa_allocator<double> > Vector;
+
+    // large enough to be placed by first touch
+    const size_t N = cusp::numa_allocator<double>::first_touch_threshold;
+
+    Vector v(N, 2.0);
+
+    ASSERT_EQUAL(v.size(), N);
+    ASSERT_EQUAL(v[0],     2.0);
+    ASSERT_EQUAL(v[N / 2], 2.0);
+    ASSERT_EQUAL(v[N - 1], 2.0);
+
+    v.resize(2 * N, 3.0);
+
+    ASSERT_EQUAL(v[N - 1], 2.0);
+    ASSERT_EQUAL(v[N],     3.0);
+
+    ASSERT_EQUAL(cusp::numa_allocator<int>() == cusp::numa_allocator<double>(), true);
+}
+DECLARE_UNITTEST(TestNumaAllocator);
+
+void TestNumaAllocatorMultiply(void)
+{
+    cusp::csr_matrix<int, float, cusp::host_memory> A;
+    cusp::gallery::poisson5pt(A, 200, 200);
+
+    // the default allocator places the storage by first touch whenever
+    // CUSP_NUMA_ALLOCATOR is enabled, the results are unaffected
+    cusp::csr_matrix<int, float, cusp::host_memory> B(A);
+
+    cusp::array1d<float, cusp::host_memory> x(A.num_cols, 1);
+    cusp::array1d<float, cusp::host_memory> y(A.num_rows, 0);
+    cusp::array1d<float, cusp::host_memory> z(A.num_rows, 0);
+
+    cusp::multiply(A, x, y);
+    cusp::multiply(B, x, z);
+
+    ASSERT_EQUAL(y, z);
+    ASSERT_EQUAL(B.row_offsets, A.row_offsets);
+}
+DECLARE_UNITTEST(TestNumaAllocatorMultiply);
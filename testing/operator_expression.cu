@@ -0,0 +1,125 @@
+#include <unittest/unittest.h>
+
+#include <cusp/operator_expression.h>
+
+#include <cusp/array1d.h>
+#include <cusp/blas/blas.h>
+#include <cusp/coo_matrix.h>
+#include <cusp/csr_matrix.h>
+#include <cusp/monitor.h>
+#include <cusp/multiply.h>
+
+#include <cusp/gallery/poisson.h>
+#include <cusp/krylov/bicgstab.h>
+#include <cusp/krylov/cg.h>
+#include <cusp/krylov/gmres.h>
+#include <cusp/precond/diagonal.h>
+
+// y = op(x) with y initially garbage
+template <typename Operator, typename ArrayType>
+cusp::array1d<float, cusp::host_memory> Apply(const Operator& op, const ArrayType& x)
+{
+    ArrayType y(op.num_rows, 10.0f);
+    cusp::multiply(op, x, y);
+    return cusp::array1d<float, cusp::host_memory>(y);
+}
+
+template <class MemorySpace>
+void TestOperatorExpressionMultiply(void)
+{
+    typedef cusp::csr_matrix<int, float, MemorySpace>      MatrixType;
+    typedef cusp::precond::diagonal<float, MemorySpace>    DiagonalType;
+    typedef cusp::array1d<float, MemorySpace>              ArrayType;
+
+    MatrixType A;
+    cusp::gallery::poisson5pt(A, 5, 6);
+
+    // scales by 1/4 exactly, and is applied as a generic linear_operator
+    DiagonalType D(A);
+
+    cusp::array1d<float, cusp::host_memory> x(A.num_rows);
+    for(size_t i = 0; i < x.size(); i++)
+        x[i] = float(i % 7);
+
+    ArrayType d_x(x);
+
+    cusp::csr_matrix<int, float, cusp::host_memory> h_A(A);
+    cusp::array1d<float, cusp::host_memory> Ax(A.num_rows);
+    cusp::multiply(h_A, x, Ax);
+
+    cusp::array1d<float, cusp::host_memory> expected(A.num_rows);
+
+    // A + 2 I
+    cusp::blas::axpby(Ax, x, expected, 1.0f, 2.0f);
+    ASSERT_EQUAL(Apply(cusp::shifted(A, 2.0f), d_x), expected);
+
+    // 3 A
+    cusp::blas::axpby(Ax, Ax, expected, 3.0f, 0.0f);
+    ASSERT_EQUAL(Apply(cusp::scaled(3.0f, A), d_x), expected);
+    ASSERT_EQUAL(Apply(cusp::sum(A, cusp::scaled(2.0f, A)), d_x), expected);
+
+    // D A D = A / 16
+    cusp::blas::axpby(Ax, Ax, expected, 0.0625f, 0.0f);
+    ASSERT_EQUAL(Apply(cusp::product(D, cusp::product(A, D)), d_x), expected);
+
+    // (A + I) + 2 D A = 1.5 A + I
+    cusp::blas::axpby(Ax, x, expected, 1.5f, 1.0f);
+    ASSERT_EQUAL(Apply(cusp::sum(cusp::shifted(A, 1.0f), cusp::scaled(2.0f, cusp::product(D, A))), d_x), expected);
+
+    // -(A - 4 I) scaled through a generic operand
+    cusp::blas::axpby(Ax, x, expected, -1.0f, 4.0f);
+    ASSERT_EQUAL(Apply(cusp::scaled(-4.0f, cusp::product(D, cusp::shifted(A, -4.0f))), d_x), expected);
+}
+DECLARE_HOST_DEVICE_UNITTEST(TestOperatorExpressionMultiply);
+
+template <class MemorySpace>
+void TestOperatorExpressionKrylov(void)
+{
+    typedef cusp::csr_matrix<int, float, MemorySpace> MatrixType;
+    typedef cusp::array1d<float, MemorySpace>         ArrayType;
+
+    MatrixType A;
+    cusp::gallery::poisson5pt(A, 10, 10);
+
+    cusp::precond::diagonal<float, MemorySpace> D(A);
+
+    ArrayType b(A.num_rows, 1.0f);
+
+    // symmetric positive definite, A + I
+    {
+        ArrayType x(A.num_rows, 0.0f);
+        cusp::monitor<float> monitor(b, 200, 1e-5);
+        cusp::krylov::cg(cusp::shifted(A, 1.0f), x, b, monitor);
+        ASSERT_EQUAL(monitor.converged(), true);
+    }
+
+    // nonsymmetric, D A + 0.5 I
+    {
+        ArrayType x(A.num_rows, 0.0f);
+        cusp::monitor<float> monitor(b, 200, 1e-5);
+        cusp::krylov::bicgstab(cusp::shifted(cusp::product(D, A), 0.5f), x, b, monitor);
+        ASSERT_EQUAL(monitor.converged(), true);
+    }
+
+    {
+        ArrayType x(A.num_rows, 0.0f);
+        cusp::monitor<float> monitor(b, 200, 1e-5);
+        cusp::krylov::gmres(cusp::sum(A, cusp::scaled(0.5f, D)), x, b, 50, monitor);
+        ASSERT_EQUAL(monitor.converged(), true);
+    }
+}
+DECLARE_HOST_DEVICE_UNITTEST(TestOperatorExpressionKrylov);
+
+template <class MemorySpace>
+void TestOperatorExpressionInvalidInput(void)
+{
+    cusp::csr_matrix<int, float, MemorySpace> A;
+    cusp::gallery::poisson5pt(A, 4, 4);
+
+    cusp::coo_matrix<int, float, MemorySpace> B(16, 9, 0);
+
+    ASSERT_THROWS(cusp::sum(A, B), cusp::invalid_input_exception);
+    ASSERT_THROWS(cusp::product(B, A), cusp::invalid_input_exception);
+    ASSERT_THROWS(cusp::shifted(B, 1.0f), cusp::invalid_input_exception);
+}
+DECLARE_HOST_DEVICE_UNITTEST(TestOperatorExpressionInvalidInput);
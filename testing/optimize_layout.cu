@@ -0,0 +1,145 @@
+#include <unittest/unittest.h>
+
+#include <cusp/graph/optimize_layout.h>
+
+#include <cusp/array1d.h>
+#include <cusp/array2d.h>
+#include <cusp/blas.h>
+#include <cusp/coo_matrix.h>
+#include <cusp/csr_matrix.h>
+#include <cusp/multiply.h>
+#include <cusp/permutation_matrix.h>
+
+#include <cusp/gallery/poisson.h>
+
+#include <algorithm>
+#include <cstdlib>
+
+template <typename MatrixType>
+int layout_bandwidth(const MatrixType& A)
+{
+    cusp::coo_matrix<int,float,cusp::host_memory> B(A);
+
+    int bandwidth = 0;
+
+    for(size_t n = 0; n < B.num_entries; n++)
+        bandwidth = std::max(bandwidth, std::abs(B.row_indices[n] - B.column_indices[n]));
+
+    return bandwidth;
+}
+
+// a 2d poisson matrix with scattered row numbers and the grid coordinates
+// of every row
+template <typename IndexType>
+void shuffled_poisson(cusp::coo_matrix<int,float,cusp::host_memory>& A,
+                      cusp::array2d<float,cusp::host_memory>& coord,
+                      const IndexType nx, const IndexType ny)
+{
+    const IndexType N = nx * ny;
+
+    cusp::gallery::poisson5pt(A, nx, ny);
+
+    cusp::permutation_matrix<int,cusp::host_memory> S(N);
+    for(IndexType i = 0; i < N; i++)
+        S.permutation[i] = (i * 367) % N;
+
+    S.symmetric_permute(A);
+
+    coord.resize(N, 2);
+    for(IndexType i = 0; i < N; i++)
+    {
+        coord(S.permutation[i], 0) = i % nx;
+        coord(S.permutation[i], 1) = i / nx;
+    }
+}
+
+template <class MemorySpace>
+void TestOptimizeLayout(void)
+{
+    cusp::coo_matrix<int,float,cusp::host_memory> h_A;
+    cusp::array2d<float,cusp::host_memory> h_coord;
+    shuffled_poisson(h_A, h_coord, 40, 25);
+
+    cusp::csr_matrix<int,float,MemorySpace> A(h_A);
+    cusp::csr_matrix<int,float,MemorySpace> B;
+    cusp::permutation_matrix<int,MemorySpace> P;
+
+    cusp::graph::optimize_layout(A, B, P);
+
+    ASSERT_EQUAL(P.num_rows, A.num_rows);
+    ASSERT_EQUAL(B.num_entries, A.num_entries);
+    ASSERT_EQUAL(layout_bandwidth(B) < layout_bandwidth(A), true);
+
+    // solving with the reordered matrix and permuted vectors
+    cusp::array1d<float,MemorySpace> x(A.num_rows);
+    for(size_t i = 0; i < x.size(); i++)
+        x[i] = i % 7;
+
+    cusp::array1d<float,MemorySpace> b(A.num_rows);
+    cusp::multiply(A, x, b);
+
+    cusp::array1d<float,MemorySpace> x_p(A.num_rows);
+    cusp::array1d<float,MemorySpace> b_p(A.num_rows);
+    cusp::array1d<float,MemorySpace> y_p(A.num_rows);
+    cusp::array1d<float,MemorySpace> y(A.num_rows);
+
+    cusp::multiply(x, P, x_p);
+    cusp::multiply(B, x_p, y_p);
+    cusp::multiply(P, y_p, y);
+
+    ASSERT_ALMOST_EQUAL(y, b);
+}
+DECLARE_HOST_DEVICE_UNITTEST(TestOptimizeLayout);
+
+template <class MemorySpace>
+void TestOptimizeLayoutHilbert(void)
+{
+    cusp::coo_matrix<int,float,cusp::host_memory> h_A;
+    cusp::array2d<float,cusp::host_memory> h_coord;
+    shuffled_poisson(h_A, h_coord, 32, 32);
+
+    cusp::csr_matrix<int,float,MemorySpace> A(h_A);
+    cusp::array2d<float,MemorySpace> coord(h_coord);
+    cusp::csr_matrix<int,float,MemorySpace> B;
+    cusp::permutation_matrix<int,MemorySpace> P;
+
+    cusp::graph::optimize_layout(A, coord, B, P);
+
+    // P is a permutation
+    cusp::array1d<int,cusp::host_memory> h_permutation(P.permutation);
+    cusp::array1d<int,cusp::host_memory> counts(A.num_rows, 0);
+    for(size_t i = 0; i < A.num_rows; i++)
+        counts[h_permutation[i]]++;
+    for(size_t i = 0; i < A.num_rows; i++)
+        ASSERT_EQUAL(counts[i], 1);
+
+    ASSERT_EQUAL(B.num_entries, A.num_entries);
+
+    // the curve visits the 16 points of every 4x4 block consecutively
+    for(size_t i = 0; i < A.num_rows; i += 16)
+    {
+        float xmin = 1e6f, xmax = -1e6f;
+
+        for(size_t j = 0; j < A.num_rows; j++)
+        {
+            if(size_t(h_permutation[j]) / 16 == i / 16)
+            {
+                xmin = std::min(xmin, h_coord(j, 0));
+                xmax = std::max(xmax, h_coord(j, 0));
+            }
+        }
+
+        ASSERT_EQUAL(xmax - xmin, 3.0f);
+    }
+}
+DECLARE_HOST_DEVICE_UNITTEST(TestOptimizeLayoutHilbert);
+
+void TestOptimizeLayoutInvalidInput(void)
+{
+    cusp::csr_matrix<int,float,cusp::host_memory> A(4, 5, 0);
+    cusp::csr_matrix<int,float,cusp::host_memory> B;
+    cusp::permutation_matrix<int,cusp::host_memory> P;
+
+    ASSERT_THROWS(cusp::graph::optimize_layout(A, B, P), cusp::invalid_input_exception);
+}
+DECLARE_UNITTEST(TestOptimizeLayoutInvalidInput);
@@ -0,0 +1,103 @@
+#include <unittest/unittest.h>
+
+#if THRUST_DEVICE_SYSTEM == THRUST_DEVICE_SYSTEM_CUDA
+
+#include <cusp/array1d.h>
+#include <cusp/csr_matrix.h>
+#include <cusp/gallery/poisson.h>
+#include <cusp/multiply.h>
+
+#include <cusp/system/cuda/out_of_core.h>
+
+namespace ooc = cusp::system::cuda::out_of_core;
+
+void TestOutOfCoreMultiply(void)
+{
+    cusp::csr_matrix<int, float, cusp::host_memory> G;
+    cusp::gallery::poisson5pt(G, 23, 19);
+
+    cusp::array1d<float, cusp::host_memory> x = unittest::random_samples<float>(G.num_cols);
+    cusp::array1d<float, cusp::host_memory> expected(G.num_rows);
+    cusp::multiply(G, x, expected);
+
+    cusp::array1d<float, cusp::device_memory> d_x(x);
+
+    const size_t block_entries[3] = { 100, 1000, G.num_entries };
+    const size_t num_buffers[3]   = { 1, 2, 3 };
+
+    for (int i = 0; i < 3; i++)
+    {
+        for (int j = 0; j < 3; j++)
+        {
+            ooc::csr_matrix<int, float> A(G, block_entries[i], num_buffers[j]);
+
+            ASSERT_EQUAL(A.block_rows().front(), 0);
+            ASSERT_EQUAL(A.block_rows().back(),  G.num_rows);
+            ASSERT_EQUAL(A.num_buffers() <= num_buffers[j], true);
+
+            cusp::array1d<float, cusp::device_memory> d_y(G.num_rows, -1.0f);
+
+            A(d_x, d_y);
+
+            cusp::array1d<float, cusp::host_memory> y(d_y);
+            ASSERT_ALMOST_EQUAL(y, expected);
+
+            // the buffers are reused by a second product
+            cusp::multiply(A, d_x, d_y);
+
+            y = d_y;
+            ASSERT_ALMOST_EQUAL(y, expected);
+        }
+    }
+
+    ASSERT_EQUAL(ooc::csr_matrix<int, float>(G, G.num_entries).num_blocks(), 1);
+    ASSERT_EQUAL(ooc::csr_matrix<int, float>(G, 100).num_blocks() > 1, true);
+}
+DECLARE_UNITTEST(TestOutOfCoreMultiply);
+
+void TestOutOfCoreLongRows(void)
+{
+    // dense rows longer than a block and empty rows
+    cusp::csr_matrix<int, float, cusp::host_memory> G(5, 40, 85);
+
+    int n = 0;
+    for (int i = 0; i < 5; i++)
+    {
+        G.row_offsets[i] = n;
+
+        const int length = (i % 2 == 0) ? 0 : 40;
+        for (int j = 0; j < length; j++, n++)
+        {
+            G.column_indices[n] = j;
+            G.values[n]         = float(i + j);
+        }
+
+        if (i == 4)
+            for (int j = 0; j < 5; j++, n++)
+            {
+                G.column_indices[n] = 7 * j;
+                G.values[n]         = 1.0f;
+            }
+    }
+    G.row_offsets[5] = n;
+
+    cusp::array1d<float, cusp::host_memory> x = unittest::random_samples<float>(G.num_cols);
+    cusp::array1d<float, cusp::host_memory> expected(G.num_rows);
+    cusp::multiply(G, x, expected);
+
+    ooc::csr_matrix<int, float> A(G, 16, 2);
+
+    cusp::array1d<float, cusp::device_memory> d_x(x);
+    cusp::array1d<float, cusp::device_memory> d_y(G.num_rows);
+
+    A(d_x, d_y);
+
+    cusp::array1d<float, cusp::host_memory> y(d_y);
+    ASSERT_ALMOST_EQUAL(y, expected);
+
+    ASSERT_THROWS((ooc::csr_matrix<int, float>(G, 0)), cusp::invalid_input_exception);
+    ASSERT_THROWS((ooc::csr_matrix<int, float>(G, 16, 0)), cusp::invalid_input_exception);
+}
+DECLARE_UNITTEST(TestOutOfCoreLongRows);
+
+#endif
@@ -0,0 +1,198 @@
+#include <unittest/unittest.h>
+
+#include <cusp/graph/pagerank.h>
+
+#include <cusp/array1d.h>
+#include <cusp/array2d.h>
+#include <cusp/coo_matrix.h>
+#include <cusp/csr_matrix.h>
+#include <cusp/csr_pattern_matrix.h>
+
+#include <thrust/reduce.h>
+
+#include <algorithm>
+#include <cmath>
+
+// a directed graph in which every tenth vertex is dangling
+cusp::coo_matrix<int, float, cusp::host_memory> DirectedGraph(const int N)
+{
+    cusp::coo_matrix<int, float, cusp::host_memory> G(N, N, 0);
+
+    for(int i = 0; i < N; i++)
+    {
+        if(i % 10 == 0)
+            continue;
+
+        int a = (7 * i + 3) % N;
+        int b = (13 * i + 1) % N;
+
+        if(a > b)
+            std::swap(a, b);
+
+        G.row_indices.push_back(i); G.column_indices.push_back(a); G.values.push_back(1);
+
+        if(b != a)
+        {
+            G.row_indices.push_back(i); G.column_indices.push_back(b); G.values.push_back(1);
+        }
+    }
+
+    G.num_entries = G.values.size();
+
+    return G;
+}
+
+// power iteration of the Google matrix on the host
+cusp::array1d<double, cusp::host_memory>
+ReferencePageRank(const cusp::coo_matrix<int, float, cusp::host_memory>& G,
+                  const cusp::array1d<double, cusp::host_memory>& teleport,
+                  const double damping)
+{
+    const int N = G.num_rows;
+
+    cusp::array1d<int, cusp::host_memory> degree(N, 0);
+    for(size_t n = 0; n < G.num_entries; n++)
+        degree[G.row_indices[n]]++;
+
+    cusp::array1d<double, cusp::host_memory> x(teleport);
+
+    for(int iteration = 0; iteration < 500; iteration++)
+    {
+        double dangling = 0;
+        for(int i = 0; i < N; i++)
+            if(degree[i] == 0)
+                dangling += x[i];
+
+        cusp::array1d<double, cusp::host_memory> y(N);
+        for(int i = 0; i < N; i++)
+            y[i] = (1 - damping + damping * dangling) * teleport[i];
+
+        for(size_t n = 0; n < G.num_entries; n++)
+            y[G.column_indices[n]] += damping * x[G.row_indices[n]] / degree[G.row_indices[n]];
+
+        x = y;
+    }
+
+    return x;
+}
+
+template <class Space>
+void TestPageRank(void)
+{
+    const int N = 200;
+
+    cusp::coo_matrix<int, float, cusp::host_memory> A = DirectedGraph(N);
+    cusp::array1d<double, cusp::host_memory> uniform(N, 1.0 / N);
+    cusp::array1d<double, cusp::host_memory> expected = ReferencePageRank(A, uniform, 0.85);
+
+    cusp::csr_pattern_matrix<int, int, Space> G(A);
+    cusp::array1d<double, Space> ranks;
+
+    const size_t iterations = cusp::graph::pagerank(G, ranks, 0.85, 1e-12, 500);
+
+    ASSERT_EQUAL(iterations < size_t(500), true);
+    ASSERT_ALMOST_EQUAL(ranks, expected);
+
+    // the ranks remain a probability distribution
+    ASSERT_ALMOST_EQUAL(thrust::reduce(ranks.begin(), ranks.end()), 1.0);
+
+    // any format of the adjacency matrix
+    cusp::csr_matrix<int, float, Space> H(A);
+    cusp::array1d<float, Space> ranks_f;
+    cusp::graph::pagerank(H, ranks_f, 0.85, 1e-7);
+
+    cusp::array1d<float, cusp::host_memory> expected_f(expected);
+    ASSERT_ALMOST_EQUAL(ranks_f, expected_f);
+}
+DECLARE_HOST_DEVICE_UNITTEST(TestPageRank);
+
+template <class Space>
+void TestPersonalizedPageRank(void)
+{
+    const int N = 200;
+    const int k = 3;
+
+    cusp::coo_matrix<int, float, cusp::host_memory> A = DirectedGraph(N);
+
+    // a uniform, a single vertex and an unnormalized distribution
+    cusp::array2d<double, cusp::host_memory> teleport(N, k, 0);
+    for(int i = 0; i < N; i++)
+    {
+        teleport(i, 0) = 1;
+        teleport(i, 2) = i % 3;
+    }
+    teleport(17, 1) = 1;
+
+    cusp::csr_pattern_matrix<int, int, Space> G(A);
+    cusp::array2d<double, Space> d_teleport(teleport);
+
+    {
+        cusp::array2d<double, Space, cusp::row_major> ranks(N, k);
+        cusp::graph::personalized_pagerank(G, d_teleport, ranks, 0.85, 1e-12, 500);
+
+        cusp::array2d<double, cusp::host_memory> h_ranks(ranks);
+
+        for(int c = 0; c < k; c++)
+        {
+            double sum = 0;
+            for(int i = 0; i < N; i++)
+                sum += teleport(i, c);
+
+            cusp::array1d<double, cusp::host_memory> v(N);
+            for(int i = 0; i < N; i++)
+                v[i] = teleport(i, c) / sum;
+
+            cusp::array1d<double, cusp::host_memory> expected = ReferencePageRank(A, v, 0.85);
+
+            for(int i = 0; i < N; i++)
+                ASSERT_EQUAL(std::abs(h_ranks(i, c) - expected[i]) < 1e-10, true);
+        }
+
+        // the uniform column is the plain PageRank
+        cusp::array1d<double, Space> plain;
+        cusp::graph::pagerank(G, plain, 0.85, 1e-12, 500);
+
+        cusp::array1d<double, cusp::host_memory> h_plain(plain);
+        for(int i = 0; i < N; i++)
+            ASSERT_EQUAL(std::abs(h_ranks(i, 0) - h_plain[i]) < 1e-10, true);
+    }
+
+    {
+        // column-major ranks
+        cusp::array2d<double, Space, cusp::column_major> ranks(N, k);
+        cusp::graph::personalized_pagerank(G, d_teleport, ranks, 0.85, 1e-12, 500);
+
+        cusp::array2d<double, Space, cusp::row_major> other(N, k);
+        cusp::graph::personalized_pagerank(G, d_teleport, other, 0.85, 1e-12, 500);
+
+        cusp::array2d<double, cusp::host_memory> h_ranks(ranks);
+        cusp::array2d<double, cusp::host_memory> h_other(other);
+
+        ASSERT_EQUAL(h_ranks.values, h_other.values);
+    }
+}
+DECLARE_HOST_DEVICE_UNITTEST(TestPersonalizedPageRank);
+
+void TestPageRankInvalidInput(void)
+{
+    cusp::coo_matrix<int, float, cusp::host_memory> A = DirectedGraph(20);
+    cusp::csr_matrix<int, float, cusp::host_memory> G(A);
+    cusp::array1d<float, cusp::host_memory> ranks;
+
+    ASSERT_THROWS(cusp::graph::pagerank(G, ranks, 1.0), cusp::invalid_input_exception);
+
+    cusp::csr_matrix<int, float, cusp::host_memory> B(3, 4, 0);
+    ASSERT_THROWS(cusp::graph::pagerank(B, ranks), cusp::invalid_input_exception);
+
+    cusp::array2d<float, cusp::host_memory> teleport(20, 2, 0);
+    cusp::array2d<float, cusp::host_memory> franks(20, 2);
+    cusp::array2d<float, cusp::host_memory> wrong(20, 3);
+
+    teleport(0, 0) = 1;
+
+    ASSERT_THROWS(cusp::graph::personalized_pagerank(G, teleport, wrong), cusp::invalid_input_exception);
+
+    // the second distribution is zero
+    ASSERT_THROWS(cusp::graph::personalized_pagerank(G, teleport, franks), cusp::invalid_input_exception);
+}
+DECLARE_UNITTEST(TestPageRankInvalidInput);
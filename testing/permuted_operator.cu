@@ -0,0 +1,146 @@
+#include <unittest/unittest.h>
+
+#include <cusp/array1d.h>
+#include <cusp/coo_matrix.h>
+#include <cusp/copy.h>
+#include <cusp/csr_matrix.h>
+#include <cusp/hyb_matrix.h>
+#include <cusp/monitor.h>
+#include <cusp/multiply.h>
+#include <cusp/permutation_matrix.h>
+#include <cusp/permuted_operator.h>
+
+#include <cusp/gallery/poisson.h>
+#include <cusp/gallery/random.h>
+#include <cusp/krylov/cg.h>
+
+#include <thrust/scatter.h>
+#include <thrust/sequence.h>
+
+template <typename MatrixType, typename MemorySpace>
+void _TestPermutedOperatorMultiply(void)
+{
+    cusp::coo_matrix<int, float, cusp::host_memory> C;
+    cusp::gallery::random(C, 99, 99, 600);
+
+    const int N = C.num_rows;
+
+    cusp::permutation_matrix<int, MemorySpace> P(N);
+    for(int i = 0; i < N; i++)
+        P.permutation[i] = (i * 367) % N;
+
+    // the explicitly permuted matrix
+    cusp::coo_matrix<int, float, MemorySpace> B(C);
+    P.symmetric_permute(B);
+    B.sort_by_row_and_column();
+
+    MatrixType A(C);
+    cusp::permuted_operator<MatrixType> Q(A, P);
+
+    ASSERT_EQUAL(Q.num_rows,    A.num_rows);
+    ASSERT_EQUAL(Q.num_cols,    A.num_cols);
+    ASSERT_EQUAL(Q.num_entries, A.num_entries);
+
+    cusp::array1d<float, MemorySpace> x(unittest::random_samples<float>(N));
+    cusp::array1d<float, MemorySpace> y(N, 0);
+    cusp::array1d<float, MemorySpace> z(N, 0);
+
+    cusp::multiply(B, x, y);
+    cusp::multiply(Q, x, z);
+
+    ASSERT_ALMOST_EQUAL(z, y);
+
+    // w holds x in the order of A
+    cusp::array1d<float, MemorySpace> w(N);
+    thrust::scatter(x.begin(), x.end(), Q.inverse.begin(), w.begin());
+
+    cusp::array1d<float, MemorySpace> v(Q.permuted_view(w));
+    ASSERT_EQUAL(v, x);
+
+    // writes through a view land in the original order
+    thrust::fill(z.begin(), z.end(), 0.0f);
+    cusp::array1d<float, MemorySpace> u(N, 0);
+
+    typename cusp::permuted_operator<MatrixType>::permutation_array_type identity(N);
+    thrust::sequence(identity.begin(), identity.end());
+
+    cusp::array1d_view< thrust::permutation_iterator<typename cusp::array1d<float, MemorySpace>::iterator,
+                        typename cusp::array1d<int, MemorySpace>::const_iterator> > u_view(Q.permuted_view(u));
+
+    cusp::multiply(Q, x, u_view);
+    cusp::copy(Q.permuted_view(u), z);
+
+    ASSERT_ALMOST_EQUAL(z, y);
+
+    ASSERT_EQUAL(cusp::array1d<float, MemorySpace>(cusp::make_permuted_array1d_view(x, identity)), x);
+}
+
+template <class MemorySpace>
+void TestPermutedOperatorMultiply(void)
+{
+    _TestPermutedOperatorMultiply<cusp::csr_matrix<int, float, MemorySpace>, MemorySpace>();
+    _TestPermutedOperatorMultiply<cusp::coo_matrix<int, float, MemorySpace>, MemorySpace>();
+    _TestPermutedOperatorMultiply<cusp::hyb_matrix<int, float, MemorySpace>, MemorySpace>();
+}
+DECLARE_HOST_DEVICE_UNITTEST(TestPermutedOperatorMultiply);
+
+template <class MemorySpace>
+void TestPermutedOperatorSolve(void)
+{
+    typedef cusp::csr_matrix<int, float, MemorySpace> MatrixType;
+
+    MatrixType A;
+    cusp::gallery::poisson5pt(A, 12, 9);
+
+    const int N = A.num_rows;
+
+    cusp::permutation_matrix<int, MemorySpace> P(N);
+    for(int i = 0; i < N; i++)
+        P.permutation[i] = (i * 367) % N;
+
+    cusp::permuted_operator<MatrixType> B(A, P);
+
+    cusp::array1d<float, MemorySpace> b(unittest::random_samples<float>(N));
+    cusp::array1d<float, MemorySpace> x(N, 0);
+
+    // solve in the original order
+    {
+        cusp::monitor<float> monitor(b, 200, 1e-5);
+        cusp::krylov::cg(A, x, b, monitor);
+    }
+
+    // solve the permuted system and scatter the solution back
+    cusp::array1d<float, MemorySpace> Pb(B.permuted_view(b));
+    cusp::array1d<float, MemorySpace> Px(N, 0);
+    cusp::array1d<float, MemorySpace> y(N, 0);
+
+    {
+        cusp::monitor<float> monitor(Pb, 200, 1e-5);
+        cusp::krylov::cg(B, Px, Pb, monitor);
+    }
+
+    cusp::array1d_view< thrust::permutation_iterator<typename cusp::array1d<float, MemorySpace>::iterator,
+                        typename cusp::array1d<int, MemorySpace>::const_iterator> > y_view(B.permuted_view(y));
+    cusp::copy(Px, y_view);
+
+    ASSERT_ALMOST_EQUAL(y, x);
+}
+DECLARE_HOST_DEVICE_UNITTEST(TestPermutedOperatorSolve);
+
+void TestPermutedOperatorInvalidInput(void)
+{
+    typedef cusp::csr_matrix<int, float, cusp::host_memory> MatrixType;
+
+    MatrixType A;
+    cusp::gallery::random(A, 10, 12, 30);
+
+    cusp::permutation_matrix<int, cusp::host_memory> P(10);
+
+    ASSERT_THROWS(cusp::permuted_operator<MatrixType> B(A, P), cusp::invalid_input_exception);
+
+    MatrixType S;
+    cusp::gallery::poisson5pt(S, 4, 4);
+
+    ASSERT_THROWS(cusp::permuted_operator<MatrixType> B(S, P), cusp::invalid_input_exception);
+}
+DECLARE_UNITTEST(TestPermutedOperatorInvalidInput);
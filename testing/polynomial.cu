@@ -11,6 +11,8 @@
 #include <cusp/hyb_matrix.h>
 #include <cusp/multiply.h>
 
+#include <cusp/gallery/poisson.h>
+
 #include <thrust/sequence.h>
 
 template <typename Matrix>
@@ -101,6 +103,42 @@ void TestPolynomialRelaxation(void)
 DECLARE_SPARSE_MATRIX_UNITTEST(TestPolynomialRelaxation);
 
 
+template <typename Matrix>
+void TestPolynomialRelaxationZeroInitialGuess(void)
+{
+    typedef typename Matrix::value_type   ValueType;
+    typedef typename Matrix::memory_space Space;
+
+    Matrix A;
+    cusp::gallery::poisson5pt(A, 10, 10);
+
+    cusp::array1d<ValueType, Space> b(A.num_rows, 1.0);
+    cusp::array1d<ValueType, Space> coef(3);
+    coef[0] = -0.14285714;
+    coef[1] = 1.0;
+    coef[2] = -2.0;
+
+    cusp::relaxation::polynomial<ValueType, Space> relax(A, coef);
+
+    cusp::array1d<ValueType, Space> expected(A.num_rows, 0.0);
+    relax(A, b, expected, coef);
+
+    // the input x is ignored
+    cusp::array1d<ValueType, Space> x(A.num_rows, 3.0);
+    relax.relax(A, b, x, coef, true);
+
+    ASSERT_ALMOST_EQUAL(x, expected);
+
+    // a nonzero guess is relaxed from its residual
+    cusp::array1d<ValueType, Space> y(expected);
+    relax(A, b, expected, coef);
+    relax.relax(A, b, y, coef, false);
+
+    ASSERT_ALMOST_EQUAL(y, expected);
+}
+DECLARE_SPARSE_MATRIX_UNITTEST(TestPolynomialRelaxationZeroInitialGuess);
+
+
 void TestChebyshevCoefficients(void)
 {
     cusp::array1d<double,cusp::host_memory> coef;
@@ -0,0 +1,96 @@
+#include <unittest/unittest.h>
+
+#include <cusp/array1d.h>
+#include <cusp/blas/blas.h>
+#include <cusp/csr_matrix.h>
+#include <cusp/monitor.h>
+#include <cusp/multiply.h>
+#include <cusp/profiling_policy.h>
+#include <cusp/gallery/poisson.h>
+#include <cusp/krylov/cg.h>
+
+#include <sstream>
+#include <string>
+
+template <typename MemorySpace>
+void TestProfilingPolicyBlas(void)
+{
+    MemorySpace system;
+    cusp::profiling_log log;
+
+    cusp::array1d<float, MemorySpace> x(10, 1.0f);
+    cusp::array1d<float, MemorySpace> y(10, 2.0f);
+
+    ASSERT_EQUAL(cusp::blas::dot(system.profiling(log), x, y), 20.0f);
+    ASSERT_EQUAL(cusp::blas::dot(system.profiling(log), y, y), 40.0f);
+
+    cusp::blas::axpy(system.profiling(log), x, y, 2.0f);
+    ASSERT_EQUAL(y[0], 4.0f);
+
+    ASSERT_EQUAL(log["cusp::blas::dot"].calls, size_t(2));
+    ASSERT_EQUAL(log["cusp::blas::dot"].bytes_read, size_t(160));
+    ASSERT_EQUAL(log["cusp::blas::dot"].bytes_written, size_t(0));
+
+    ASSERT_EQUAL(log["cusp::blas::axpy"].calls, size_t(1));
+    ASSERT_EQUAL(log["cusp::blas::axpy"].bytes_read, size_t(80));
+    ASSERT_EQUAL(log["cusp::blas::axpy"].bytes_written, size_t(40));
+
+    ASSERT_EQUAL(log["cusp::blas::nrm2"].calls, size_t(0));
+    ASSERT_EQUAL(log.entries().size(), size_t(2));
+
+    // nrmmax is recorded together with the amax it calls
+    ASSERT_EQUAL(cusp::blas::nrmmax(system.profiling(log), y), 4.0f);
+    ASSERT_EQUAL(log["cusp::blas::nrmmax"].calls, size_t(1));
+    ASSERT_EQUAL(log["cusp::blas::amax"].calls, size_t(1));
+
+    log.reset();
+    ASSERT_EQUAL(log.entries().size(), size_t(0));
+}
+DECLARE_HOST_DEVICE_UNITTEST(TestProfilingPolicyBlas)
+
+template <typename MemorySpace>
+void TestProfilingPolicyMultiply(void)
+{
+    MemorySpace system;
+    cusp::profiling_log log;
+
+    cusp::csr_matrix<int, float, MemorySpace> A;
+    cusp::gallery::poisson5pt(A, 4, 4);
+
+    cusp::array1d<float, MemorySpace> x(A.num_rows, 1.0f);
+    cusp::array1d<float, MemorySpace> y(A.num_rows, 0.0f);
+
+    cusp::multiply(system.profiling(log), A, x, y);
+
+    // row pointer, column index, A[i,j], x[j] and y[i]
+    const size_t bytes_read = 2 * sizeof(int) * A.num_rows
+                            + (sizeof(int) + 2 * sizeof(float)) * A.num_entries
+                            + sizeof(float) * A.num_rows;
+
+    ASSERT_EQUAL(log["cusp::multiply"].calls, size_t(1));
+    ASSERT_EQUAL(log["cusp::multiply"].bytes_read, bytes_read);
+    ASSERT_EQUAL(log["cusp::multiply"].bytes_written, sizeof(float) * A.num_rows);
+    ASSERT_EQUAL(log["cusp::multiply"].wall_time >= 0.0, true);
+
+    // the calls made inside a solver are recorded
+    cusp::array1d<float, MemorySpace> b(A.num_rows, 1.0f);
+    cusp::blas::fill(x, 0.0f);
+
+    cusp::monitor<float> monitor(b, 100, 1e-5);
+    cusp::krylov::cg(system.profiling(log), A, x, b, monitor);
+
+    ASSERT_EQUAL(monitor.converged(), true);
+    ASSERT_EQUAL(log["cusp::multiply"].calls >= monitor.iteration_count() + 1, true);
+    ASSERT_EQUAL(log["cusp::blas::dotc"].calls + log["cusp::blas::dot"].calls > 0, true);
+
+    std::ostringstream oss;
+    log.write_json(oss);
+
+    const std::string json = oss.str();
+
+    ASSERT_EQUAL(json[0], '{');
+    ASSERT_EQUAL(json.find("\"cusp::multiply\": {\"calls\": ") != std::string::npos, true);
+    ASSERT_EQUAL(json.find("\"kernel_seconds\": ") != std::string::npos, true);
+    ASSERT_EQUAL(json.find("\"bytes_written\": ") != std::string::npos, true);
+}
+DECLARE_HOST_DEVICE_UNITTEST(TestProfilingPolicyMultiply)
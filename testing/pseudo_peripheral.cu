@@ -4,6 +4,10 @@
 
 #include <cusp/csr_matrix.h>
 
+#include <cusp/gallery/grid.h>
+
+#include <thrust/extrema.h>
+
 template <typename MatrixType>
 typename MatrixType::index_type
 pseudo_peripheral_vertex(my_system& system, const MatrixType& G)
@@ -27,3 +31,20 @@ void TestPseudoPeripheralDispatch()
 }
 DECLARE_UNITTEST(TestPseudoPeripheralDispatch);
 
+
+template <class MemorySpace>
+void TestPseudoPeripheralVertexGrid(void)
+{
+    cusp::csr_matrix<int,float,MemorySpace> G;
+    cusp::gallery::grid2d(G, 10, 20);
+
+    cusp::array1d<int,MemorySpace> levels(G.num_rows);
+
+    int vertex = cusp::graph::pseudo_peripheral_vertex(G, levels);
+
+    // only the corners of the grid are 28 steps away from another vertex,
+    // the levels are those of a search from the returned vertex
+    ASSERT_EQUAL(int(levels[vertex]), 0);
+    ASSERT_EQUAL(int(*thrust::max_element(levels.begin(), levels.end())), 28);
+}
+DECLARE_HOST_DEVICE_UNITTEST(TestPseudoPeripheralVertexGrid);
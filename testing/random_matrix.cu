@@ -0,0 +1,104 @@
+#include <unittest/unittest.h>
+
+#include <cusp/csr_matrix.h>
+#include <cusp/coo_matrix.h>
+#include <cusp/verify.h>
+#include <cusp/gallery/random.h>
+
+#include <thrust/adjacent_difference.h>
+#include <thrust/binary_search.h>
+#include <thrust/count.h>
+#include <thrust/extrema.h>
+
+template <typename MatrixType>
+cusp::array1d<int, cusp::host_memory> row_lengths(const MatrixType& A)
+{
+    cusp::csr_matrix<int, float, cusp::host_memory> B(A);
+    cusp::array1d<int, cusp::host_memory> lengths(B.num_rows + 1);
+
+    thrust::adjacent_difference(B.row_offsets.begin(), B.row_offsets.end(), lengths.begin());
+    lengths.erase(lengths.begin());
+
+    return lengths;
+}
+
+template <class MemorySpace>
+void TestRandomPowerLaw(void)
+{
+    cusp::csr_matrix<int, float, MemorySpace> A;
+    cusp::gallery::random_power_law(A, 2000, 1500, 2, 400, 2.0, 3);
+
+    ASSERT_EQUAL(A.num_rows, 2000);
+    ASSERT_EQUAL(A.num_cols, 1500);
+    ASSERT_EQUAL(cusp::is_valid_matrix(A), true);
+
+    cusp::array1d<int, cusp::host_memory> lengths = row_lengths(A);
+
+    // most rows are short but the tail reaches far beyond the minimum
+    ASSERT_LEQUAL(*thrust::max_element(lengths.begin(), lengths.end()), 400);
+    ASSERT_GEQUAL(*thrust::max_element(lengths.begin(), lengths.end()), 100);
+    ASSERT_GEQUAL(thrust::count(lengths.begin(), lengths.end(), 2), 500);
+
+    // the same seed reproduces the matrix in any memory space
+    cusp::csr_matrix<int, float, cusp::host_memory> B;
+    cusp::gallery::random_power_law(B, 2000, 1500, 2, 400, 2.0, 3);
+
+    cusp::csr_matrix<int, float, cusp::host_memory> C(A);
+    ASSERT_EQUAL(C.row_offsets,    B.row_offsets);
+    ASSERT_EQUAL(C.column_indices, B.column_indices);
+
+    ASSERT_THROWS(cusp::gallery::random_power_law(A, 10, 10, 1, 5, 1.0), cusp::invalid_input_exception);
+}
+DECLARE_HOST_DEVICE_UNITTEST(TestRandomPowerLaw);
+
+template <class MemorySpace>
+void TestRandomBimodal(void)
+{
+    cusp::coo_matrix<int, float, MemorySpace> A;
+    cusp::gallery::random_bimodal(A, 1000, 5000, 3, 300, 0.1);
+
+    ASSERT_EQUAL(cusp::is_valid_matrix(A), true);
+
+    cusp::array1d<int, cusp::host_memory> lengths = row_lengths(A);
+
+    size_t num_short = 0;
+    size_t num_long  = 0;
+
+    for (size_t i = 0; i < lengths.size(); i++)
+    {
+        if (lengths[i] <= 3)   num_short++;
+        if (lengths[i] >= 250) num_long++;
+    }
+
+    ASSERT_EQUAL(num_short + num_long, size_t(1000));
+    ASSERT_GEQUAL(num_long, size_t(50));
+    ASSERT_LEQUAL(num_long, size_t(150));
+}
+DECLARE_HOST_DEVICE_UNITTEST(TestRandomBimodal);
+
+template <class MemorySpace>
+void TestRandomBanded(void)
+{
+    cusp::csr_matrix<int, float, MemorySpace> A;
+    cusp::gallery::random_banded(A, 100, 100, 2, 0);
+
+    // without noise the matrix is exactly the band
+    ASSERT_EQUAL(A.num_entries, 100 * 5 - 6);
+
+    cusp::gallery::random_banded(A, 100, 100, 2, 3);
+
+    ASSERT_EQUAL(cusp::is_valid_matrix(A), true);
+
+    cusp::csr_matrix<int, float, cusp::host_memory> B(A);
+
+    for (int i = 0; i < 100; i++)
+    {
+        ASSERT_LEQUAL(B.row_offsets[i + 1] - B.row_offsets[i], 8);
+
+        // every band column is present
+        for (int j = std::max(i - 2, 0); j <= std::min(i + 2, 99); j++)
+            ASSERT_EQUAL(thrust::binary_search(B.column_indices.begin() + B.row_offsets[i],
+                                               B.column_indices.begin() + B.row_offsets[i + 1], j), true);
+    }
+}
+DECLARE_HOST_DEVICE_UNITTEST(TestRandomBanded);
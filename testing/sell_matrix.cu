@@ -0,0 +1,129 @@
+#include <unittest/unittest.h>
+
+#include <cusp/coo_matrix.h>
+#include <cusp/csr_matrix.h>
+#include <cusp/multiply.h>
+#include <cusp/sell_matrix.h>
+
+#include <cusp/gallery/poisson.h>
+#include <cusp/gallery/random.h>
+
+template <class Space>
+void TestSellMatrixBasicConstructor(void)
+{
+    cusp::sell_matrix<int, float, Space> matrix(5, 4, 7, 12, 2);
+
+    ASSERT_EQUAL(matrix.num_rows,               5);
+    ASSERT_EQUAL(matrix.num_cols,               4);
+    ASSERT_EQUAL(matrix.num_entries,            7);
+    ASSERT_EQUAL(matrix.slice_size,             2);
+    ASSERT_EQUAL(matrix.num_slices(),           3);
+    ASSERT_EQUAL(matrix.slice_offsets.size(),   4);
+    ASSERT_EQUAL(matrix.column_indices.size(),  12);
+    ASSERT_EQUAL(matrix.values.size(),          12);
+    ASSERT_EQUAL(matrix.row_permutation.size(), 5);
+}
+DECLARE_HOST_DEVICE_UNITTEST(TestSellMatrixBasicConstructor);
+
+template <class Space>
+void TestSellMatrixConversion(void)
+{
+    // [10  0  0  0]
+    // [ 0  0  0  0]
+    // [20 30 40  0]
+    // [ 0 50  0 60]
+    // [ 0  0 70  0]
+    cusp::csr_matrix<int, float, cusp::host_memory> A(5, 4, 7);
+    A.row_offsets[0] = 0;
+    A.row_offsets[1] = 1;
+    A.row_offsets[2] = 1;
+    A.row_offsets[3] = 4;
+    A.row_offsets[4] = 6;
+    A.row_offsets[5] = 7;
+    A.column_indices[0] = 0; A.values[0] = 10;
+    A.column_indices[1] = 0; A.values[1] = 20;
+    A.column_indices[2] = 1; A.values[2] = 30;
+    A.column_indices[3] = 2; A.values[3] = 40;
+    A.column_indices[4] = 1; A.values[4] = 50;
+    A.column_indices[5] = 3; A.values[5] = 60;
+    A.column_indices[6] = 2; A.values[6] = 70;
+
+    cusp::sell_matrix<int, float, Space> B;
+    B.slice_size = 2;
+    B.sigma      = 4;
+    cusp::convert(A, B);
+
+    // rows [0,4) are sorted by length to [2, 3, 0, 1], row 4 is its own window
+    ASSERT_EQUAL(B.num_rows,    5);
+    ASSERT_EQUAL(B.num_cols,    4);
+    ASSERT_EQUAL(B.num_entries, 7);
+    ASSERT_EQUAL(B.num_slices(), 3);
+    ASSERT_EQUAL(B.row_permutation[0], 2);
+    ASSERT_EQUAL(B.row_permutation[1], 3);
+    ASSERT_EQUAL(B.row_permutation[2], 0);
+    ASSERT_EQUAL(B.row_permutation[3], 1);
+    ASSERT_EQUAL(B.row_permutation[4], 4);
+    ASSERT_EQUAL(B.slice_offsets[0], 0);
+    ASSERT_EQUAL(B.slice_offsets[1], 6);
+    ASSERT_EQUAL(B.slice_offsets[2], 8);
+    ASSERT_EQUAL(B.slice_offsets[3], 10);
+
+    // first slice interleaves rows 2 and 3
+    ASSERT_EQUAL(B.column_indices[0],  0); ASSERT_EQUAL(B.values[0], 20);
+    ASSERT_EQUAL(B.column_indices[1],  1); ASSERT_EQUAL(B.values[1], 50);
+    ASSERT_EQUAL(B.column_indices[2],  1); ASSERT_EQUAL(B.values[2], 30);
+    ASSERT_EQUAL(B.column_indices[3],  3); ASSERT_EQUAL(B.values[3], 60);
+    ASSERT_EQUAL(B.column_indices[4],  2); ASSERT_EQUAL(B.values[4], 40);
+    ASSERT_EQUAL(B.column_indices[5], -1);
+    ASSERT_EQUAL(B.column_indices[6],  0); ASSERT_EQUAL(B.values[6], 10);
+    ASSERT_EQUAL(B.column_indices[7], -1);
+    ASSERT_EQUAL(B.column_indices[8],  2); ASSERT_EQUAL(B.values[8], 70);
+    ASSERT_EQUAL(B.column_indices[9], -1);
+
+    // convert back to CSR
+    cusp::csr_matrix<int, float, Space> C(B);
+
+    ASSERT_EQUAL(C.row_offsets,    A.row_offsets);
+    ASSERT_EQUAL(C.column_indices, A.column_indices);
+    ASSERT_EQUAL(C.values,         A.values);
+}
+DECLARE_HOST_DEVICE_UNITTEST(TestSellMatrixConversion);
+
+template <typename TestMatrix>
+void _TestSellMatrixVectorMultiply(const TestMatrix& A, size_t slice_size, size_t sigma)
+{
+    typedef typename TestMatrix::memory_space MemorySpace;
+
+    cusp::sell_matrix<int, float, MemorySpace> B;
+    B.slice_size = slice_size;
+    B.sigma      = sigma;
+    cusp::convert(A, B);
+
+    cusp::array1d<float, MemorySpace> x(A.num_cols);
+    for(size_t i = 0; i < A.num_cols; i++)
+        x[i] = i % 5;
+
+    cusp::array1d<float, MemorySpace> y(A.num_rows, 10);
+    cusp::array1d<float, MemorySpace> z(A.num_rows, 10);
+
+    cusp::multiply(A, x, y);
+    cusp::multiply(B, x, z);
+
+    ASSERT_EQUAL(z, y);
+}
+
+template <class MemorySpace>
+void TestSellMatrixVectorMultiply(void)
+{
+    cusp::csr_matrix<int, float, MemorySpace> A;
+
+    cusp::gallery::poisson5pt(A, 9, 7);
+    _TestSellMatrixVectorMultiply(A, 32, 1024);
+    _TestSellMatrixVectorMultiply(A, 4, 8);
+
+    cusp::gallery::random(A, 100, 80, 700);
+    _TestSellMatrixVectorMultiply(A, 32, 1);
+    _TestSellMatrixVectorMultiply(A, 8, 64);
+    _TestSellMatrixVectorMultiply(A, 3, 1000);
+}
+DECLARE_HOST_DEVICE_UNITTEST(TestSellMatrixVectorMultiply);
@@ -0,0 +1,317 @@
+#include <unittest/unittest.h>
+
+#include <cusp/csr_matrix.h>
+#include <cusp/ell_matrix.h>
+#include <cusp/sell_matrix.h>
+#include <cusp/functional.h>
+#include <cusp/multiply.h>
+
+#include <cusp/system/detail/sequential/multiply/simd_spmv.h>
+
+#include <thrust/fill.h>
+#include <thrust/functional.h>
+
+#include <algorithm>
+
+// The AVX2 and AVX-512 kernels are only compiled into host builds
+// (e.g. scons compiler=gcc), under nvcc these tests check the scalar path.
+// Every value is a small integer so the vectorized sums are exact.
+
+// row lengths which are not multiples of the 4, 8 and 16 lanes
+static const int simd_row_lengths[] = {0, 1, 3, 5, 7, 9, 13, 15, 17, 31, 33};
+static const int simd_num_row_lengths = sizeof(simd_row_lengths) / sizeof(int);
+
+// row counts which leave partial vectors of rows in ELL and SELL
+static const int simd_num_rows[] = {1, 3, 11, 17, 37, 70};
+static const int simd_num_row_counts = sizeof(simd_num_rows) / sizeof(int);
+
+static const int simd_num_cols = 41;
+
+template <typename ValueType>
+void simd_test_matrix(cusp::csr_matrix<int, ValueType, cusp::host_memory>& A, int num_rows)
+{
+    int num_entries = 0;
+    for(int i = 0; i < num_rows; i++)
+        num_entries += simd_row_lengths[i % simd_num_row_lengths];
+
+    A.resize(num_rows, simd_num_cols, num_entries);
+
+    int nnz = 0;
+    for(int i = 0; i < num_rows; i++)
+    {
+        const int length = simd_row_lengths[i % simd_num_row_lengths];
+        const int start  = i % (simd_num_cols - length + 1);
+
+        A.row_offsets[i] = nnz;
+
+        for(int k = 0; k < length; k++, nnz++)
+        {
+            A.column_indices[nnz] = start + k;
+            A.values[nnz]         = ValueType((i + 2 * k) % 9 - 4);
+        }
+    }
+    A.row_offsets[num_rows] = nnz;
+}
+
+template <typename ValueType>
+void simd_test_vector(cusp::array1d<ValueType, cusp::host_memory>& x)
+{
+    x.resize(simd_num_cols);
+
+    for(int j = 0; j < simd_num_cols; j++)
+        x[j] = ValueType(j % 7 - 3);
+}
+
+template <typename ValueType>
+cusp::array1d<ValueType, cusp::host_memory>
+simd_reference(const cusp::csr_matrix<int, ValueType, cusp::host_memory>& A,
+               const cusp::array1d<ValueType, cusp::host_memory>& x,
+               const ValueType initial_value)
+{
+    cusp::array1d<ValueType, cusp::host_memory> y(A.num_rows, initial_value);
+
+    for(size_t i = 0; i < A.num_rows; i++)
+        for(int jj = A.row_offsets[i]; jj < A.row_offsets[i + 1]; jj++)
+            y[i] += A.values[jj] * x[A.column_indices[jj]];
+
+    return y;
+}
+
+// ELL storage with pitched, column major slabs where every row is padded
+// to the longest row and odd rows additionally start with a padding column
+template <typename ValueType>
+void simd_padded_ell(const cusp::csr_matrix<int, ValueType, cusp::host_memory>& A,
+                     cusp::ell_matrix<int, ValueType, cusp::host_memory>& B)
+{
+    const int X = cusp::ell_matrix<int, ValueType, cusp::host_memory>::invalid_index;
+
+    int num_entries_per_row = 0;
+    for(size_t i = 0; i < A.num_rows; i++)
+        num_entries_per_row = std::max(num_entries_per_row, A.row_offsets[i + 1] - A.row_offsets[i] + 1);
+
+    B.resize(A.num_rows, A.num_cols, A.num_entries, num_entries_per_row, 16);
+
+    // padding values are never read as long as their column is invalid
+    thrust::fill(B.column_indices.values.begin(), B.column_indices.values.end(), X);
+    thrust::fill(B.values.values.begin(),         B.values.values.end(),         ValueType(1000));
+
+    for(size_t i = 0; i < A.num_rows; i++)
+    {
+        int n = i % 2;
+
+        for(int jj = A.row_offsets[i]; jj < A.row_offsets[i + 1]; jj++, n++)
+        {
+            B.column_indices(i, n) = A.column_indices[jj];
+            B.values(i, n)         = A.values[jj];
+        }
+    }
+}
+
+#if CUSP_SIMD_SPMV
+
+bool simd_supports_avx2(void)
+{
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+}
+
+bool simd_supports_avx512(void)
+{
+    return cusp::system::detail::sequential::simd::get_simd_level() == cusp::system::detail::sequential::simd::SIMD_AVX512;
+}
+
+#endif // CUSP_SIMD_SPMV
+
+template <typename ValueType>
+void TestSimdCsrSpmv(void)
+{
+    cusp::array1d<ValueType, cusp::host_memory> x;
+    simd_test_vector(x);
+
+    for(int r = 0; r < simd_num_row_counts; r++)
+    {
+        cusp::csr_matrix<int, ValueType, cusp::host_memory> A;
+        simd_test_matrix(A, simd_num_rows[r]);
+
+        cusp::array1d<ValueType, cusp::host_memory> y(A.num_rows, 7);
+        cusp::multiply(A, x, y);
+
+        ASSERT_EQUAL(y, simd_reference(A, x, ValueType(0)));
+
+#if CUSP_SIMD_SPMV
+        using namespace cusp::system::detail::sequential::simd;
+
+        if(A.num_entries == 0)
+            continue;
+
+        const ValueType initial_value(2);
+        cusp::array1d<ValueType, cusp::host_memory> reference = simd_reference(A, x, initial_value);
+
+        if(simd_supports_avx2())
+        {
+            cusp::array1d<ValueType, cusp::host_memory> z(A.num_rows, 7);
+            csr_spmv_avx2<ValueType>(A.num_rows, &A.row_offsets[0], &A.column_indices[0],
+                                     &A.values[0], &x[0], &z[0], initial_value);
+            ASSERT_EQUAL(z, reference);
+        }
+
+        if(simd_supports_avx512())
+        {
+            cusp::array1d<ValueType, cusp::host_memory> z(A.num_rows, 7);
+            csr_spmv_avx512<ValueType>(A.num_rows, &A.row_offsets[0], &A.column_indices[0],
+                                       &A.values[0], &x[0], &z[0], initial_value);
+            ASSERT_EQUAL(z, reference);
+        }
+#endif
+    }
+}
+DECLARE_REAL_UNITTEST(TestSimdCsrSpmv);
+
+template <typename ValueType>
+void TestSimdEllSpmv(void)
+{
+    cusp::array1d<ValueType, cusp::host_memory> x;
+    simd_test_vector(x);
+
+    for(int r = 0; r < simd_num_row_counts; r++)
+    {
+        cusp::csr_matrix<int, ValueType, cusp::host_memory> A;
+        simd_test_matrix(A, simd_num_rows[r]);
+
+        cusp::array1d<ValueType, cusp::host_memory> reference = simd_reference(A, x, ValueType(0));
+
+        // converted storage, padded at the end of every row
+        {
+            cusp::ell_matrix<int, ValueType, cusp::host_memory> B(A);
+
+            cusp::array1d<ValueType, cusp::host_memory> y(A.num_rows, 7);
+            cusp::multiply(B, x, y);
+
+            ASSERT_EQUAL(y, reference);
+        }
+
+        cusp::ell_matrix<int, ValueType, cusp::host_memory> B;
+        simd_padded_ell(A, B);
+
+        cusp::array1d<ValueType, cusp::host_memory> y(A.num_rows, 7);
+        cusp::multiply(B, x, y);
+
+        ASSERT_EQUAL(y, reference);
+
+#if CUSP_SIMD_SPMV
+        using namespace cusp::system::detail::sequential::simd;
+
+        const ValueType initial_value(2);
+        reference = simd_reference(A, x, initial_value);
+
+        if(simd_supports_avx2())
+        {
+            cusp::array1d<ValueType, cusp::host_memory> z(A.num_rows, 7);
+            ell_spmv_avx2<ValueType>(B.num_rows, B.column_indices.num_cols,
+                                     &B.column_indices.values[0], B.column_indices.pitch,
+                                     &B.values.values[0], B.values.pitch,
+                                     &x[0], &z[0], initial_value);
+            ASSERT_EQUAL(z, reference);
+        }
+
+        if(simd_supports_avx512())
+        {
+            cusp::array1d<ValueType, cusp::host_memory> z(A.num_rows, 7);
+            ell_spmv_avx512<ValueType>(B.num_rows, B.column_indices.num_cols,
+                                       &B.column_indices.values[0], B.column_indices.pitch,
+                                       &B.values.values[0], B.values.pitch,
+                                       &x[0], &z[0], initial_value);
+            ASSERT_EQUAL(z, reference);
+        }
+#endif
+    }
+}
+DECLARE_REAL_UNITTEST(TestSimdEllSpmv);
+
+template <typename ValueType>
+void TestSimdSellSpmv(void)
+{
+    // slice sizes below, between and above the vector widths
+    const int slice_sizes[] = {3, 8, 13, 32};
+
+    cusp::array1d<ValueType, cusp::host_memory> x;
+    simd_test_vector(x);
+
+    for(int r = 0; r < simd_num_row_counts; r++)
+    {
+        cusp::csr_matrix<int, ValueType, cusp::host_memory> A;
+        simd_test_matrix(A, simd_num_rows[r]);
+
+        for(int s = 0; s < 4; s++)
+        {
+            cusp::sell_matrix<int, ValueType, cusp::host_memory> B;
+            B.slice_size = slice_sizes[s];
+            B.sigma      = 2 * slice_sizes[s];
+            cusp::convert(A, B);
+
+            cusp::array1d<ValueType, cusp::host_memory> y(A.num_rows, 7);
+            cusp::multiply(B, x, y);
+
+            ASSERT_EQUAL(y, simd_reference(A, x, ValueType(0)));
+
+#if CUSP_SIMD_SPMV
+            using namespace cusp::system::detail::sequential::simd;
+
+            const ValueType initial_value(2);
+            cusp::array1d<ValueType, cusp::host_memory> reference = simd_reference(A, x, initial_value);
+
+            if(B.values.size() == 0)
+                continue;
+
+            if(simd_supports_avx2())
+            {
+                cusp::array1d<ValueType, cusp::host_memory> z(A.num_rows, 7);
+                sell_spmv_avx2<ValueType>(B.num_rows, B.num_slices(), B.slice_size,
+                                          &B.slice_offsets[0], &B.column_indices[0], &B.values[0],
+                                          &B.row_permutation[0], &x[0], &z[0], initial_value);
+                ASSERT_EQUAL(z, reference);
+            }
+
+            if(simd_supports_avx512())
+            {
+                cusp::array1d<ValueType, cusp::host_memory> z(A.num_rows, 7);
+                sell_spmv_avx512<ValueType>(B.num_rows, B.num_slices(), B.slice_size,
+                                            &B.slice_offsets[0], &B.column_indices[0], &B.values[0],
+                                            &B.row_permutation[0], &x[0], &z[0], initial_value);
+                ASSERT_EQUAL(z, reference);
+            }
+#endif
+        }
+    }
+}
+DECLARE_REAL_UNITTEST(TestSimdSellSpmv);
+
+// The kernels are only taken for float and double values and fall back to
+// the scalar kernels for the remaining types and operators
+void TestSimdSpmvDispatch(void)
+{
+    using namespace cusp::system::detail::sequential::simd;
+
+    cusp::csr_matrix<int, float, cusp::host_memory> A;
+    simd_test_matrix(A, 37);
+
+    cusp::array1d<float, cusp::host_memory> x;
+    simd_test_vector(x);
+
+    cusp::array1d<float, cusp::host_memory> y(A.num_rows, 0);
+
+    const bool vectorized = get_simd_level() != SIMD_NONE;
+
+    ASSERT_EQUAL(spmv(A, x, y, cusp::constant_functor<float>(0), thrust::multiplies<float>(),
+                      thrust::plus<float>(), cusp::csr_format()), vectorized);
+    ASSERT_EQUAL(spmv(A, x, y, cusp::constant_functor<float>(0), thrust::multiplies<float>(),
+                      thrust::maximum<float>(), cusp::csr_format()), false);
+
+    cusp::csr_matrix<int, int, cusp::host_memory> B(A);
+    cusp::array1d<int, cusp::host_memory> u(x);
+    cusp::array1d<int, cusp::host_memory> v(A.num_rows, 0);
+
+    ASSERT_EQUAL(spmv(B, u, v, cusp::constant_functor<int>(0), thrust::multiplies<int>(),
+                      thrust::plus<int>(), cusp::csr_format()), false);
+}
+DECLARE_UNITTEST(TestSimdSpmvDispatch);
@@ -1,18 +1,33 @@
 #include <unittest/unittest.h>
 
 #include <cusp/precond/aggregation/smoothed_aggregation.h>
+#include <cusp/precond/aggregation/galerkin_product.h>
+#include <cusp/precond/aggregation/smooth_prolongator.h>
+#include <cusp/precond/smoother/chebyshev_smoother.h>
+#include <cusp/precond/smoother/block_jacobi_smoother.h>
+#include <cusp/precond/smoother/hybrid_gauss_seidel_smoother.h>
+#include <cusp/precond/smoother/l1_jacobi_smoother.h>
 
 #include <cusp/array2d.h>
+#include <cusp/blas.h>
 #include <cusp/coo_matrix.h>
 #include <cusp/csr_matrix.h>
 #include <cusp/dia_matrix.h>
 #include <cusp/ell_matrix.h>
 #include <cusp/hyb_matrix.h>
 #include <cusp/monitor.h>
+#include <cusp/multiply.h>
+#include <cusp/transpose.h>
 
 #include <cusp/gallery/poisson.h>
 #include <cusp/krylov/cg.h>
 
+#include <thrust/extrema.h>
+
+#include <cmath>
+#include <sstream>
+#include <vector>
+
 template <typename SparseMatrix>
 void TestSmoothedAggregation(void)
 {
@@ -55,6 +70,307 @@ void TestSmoothedAggregation(void)
 }
 DECLARE_SPARSE_MATRIX_UNITTEST(TestSmoothedAggregation);
 
+template <typename SparseMatrix, typename SmootherType>
+void check_smoothed_aggregation_smoother(void)
+{
+    typedef typename SparseMatrix::index_type   IndexType;
+    typedef typename SparseMatrix::value_type   ValueType;
+    typedef typename SparseMatrix::memory_space MemorySpace;
+
+    // Create 2D Poisson problem
+    SparseMatrix A;
+    cusp::gallery::poisson5pt(A, 100, 100);
+
+    // create smoothed aggregation solver with the given smoother
+    cusp::precond::aggregation::smoothed_aggregation<IndexType,ValueType,MemorySpace,SmootherType> M(A);
+
+    cusp::array1d<ValueType,MemorySpace> b = unittest::random_samples<ValueType>(A.num_rows);
+    cusp::array1d<ValueType,MemorySpace> x = unittest::random_samples<ValueType>(A.num_rows);
+
+    // set stopping criteria (iteration_limit = 20, relative_tolerance = 1e-4)
+    cusp::monitor<ValueType> monitor(b, 20, 1e-4);
+    cusp::krylov::cg(A, x, b, monitor, M);
+
+    ASSERT_EQUAL(monitor.converged(), true);
+    ASSERT_EQUAL(monitor.geometric_rate() < 0.5, true);
+}
+
+template <typename SparseMatrix>
+void TestSmoothedAggregationChebyshevSmoother(void)
+{
+    typedef typename SparseMatrix::value_type   ValueType;
+    typedef typename SparseMatrix::memory_space MemorySpace;
+
+    check_smoothed_aggregation_smoother<SparseMatrix, cusp::precond::chebyshev_smoother<ValueType,MemorySpace> >();
+}
+DECLARE_SPARSE_MATRIX_UNITTEST(TestSmoothedAggregationChebyshevSmoother);
+
+template <typename SparseMatrix>
+void TestSmoothedAggregationL1JacobiSmoother(void)
+{
+    typedef typename SparseMatrix::value_type   ValueType;
+    typedef typename SparseMatrix::memory_space MemorySpace;
+
+    check_smoothed_aggregation_smoother<SparseMatrix, cusp::precond::l1_jacobi_smoother<ValueType,MemorySpace> >();
+}
+DECLARE_SPARSE_MATRIX_UNITTEST(TestSmoothedAggregationL1JacobiSmoother);
+
+template <typename SparseMatrix>
+void TestSmoothedAggregationHybridGaussSeidelSmoother(void)
+{
+    typedef typename SparseMatrix::value_type   ValueType;
+    typedef typename SparseMatrix::memory_space MemorySpace;
+
+    check_smoothed_aggregation_smoother<SparseMatrix, cusp::precond::hybrid_gauss_seidel_smoother<ValueType,MemorySpace> >();
+}
+DECLARE_SPARSE_MATRIX_UNITTEST(TestSmoothedAggregationHybridGaussSeidelSmoother);
+
+template <typename SparseMatrix>
+void TestSmoothedAggregationBlockJacobiSmoother(void)
+{
+    typedef typename SparseMatrix::value_type   ValueType;
+    typedef typename SparseMatrix::memory_space MemorySpace;
+
+    check_smoothed_aggregation_smoother<SparseMatrix, cusp::precond::block_jacobi_smoother<ValueType,MemorySpace> >();
+}
+DECLARE_SPARSE_MATRIX_UNITTEST(TestSmoothedAggregationBlockJacobiSmoother);
+
+template <typename SparseMatrix>
+void TestSmoothedAggregationCycles(void)
+{
+    typedef typename SparseMatrix::index_type   IndexType;
+    typedef typename SparseMatrix::value_type   ValueType;
+    typedef typename SparseMatrix::memory_space MemorySpace;
+
+    // Create 2D Poisson problem
+    SparseMatrix A;
+    cusp::gallery::poisson5pt(A, 100, 100);
+
+    cusp::precond::aggregation::smoothed_aggregation<IndexType,ValueType,MemorySpace> M(A);
+
+    cusp::array1d<ValueType,MemorySpace> b = unittest::random_samples<ValueType>(A.num_rows);
+
+    size_t v_cycle_iterations = 0;
+
+    const cusp::cycle_type cycles[] = {cusp::V_CYCLE, cusp::W_CYCLE, cusp::F_CYCLE, cusp::K_CYCLE};
+
+    for(size_t i = 0; i < 4; i++)
+    {
+        M.set_cycle(cycles[i]);
+
+        cusp::array1d<ValueType,MemorySpace> x(A.num_rows, ValueType(0));
+
+        // set stopping criteria (iteration_limit = 40, relative_tolerance = 1e-4)
+        cusp::monitor<ValueType> monitor(b, 40, 1e-4);
+        M.solve(b, x, monitor);
+
+        ASSERT_EQUAL(monitor.converged(), true);
+
+        // the stronger coarse grid corrections never need more iterations
+        if(cycles[i] == cusp::V_CYCLE)
+            v_cycle_iterations = monitor.iteration_count();
+        else
+            ASSERT_EQUAL(monitor.iteration_count() <= v_cycle_iterations, true);
+    }
+}
+DECLARE_SPARSE_MATRIX_UNITTEST(TestSmoothedAggregationCycles);
+
+template <class MemorySpace>
+void TestSmoothedAggregationUpdateValues(void)
+{
+    typedef int                 IndexType;
+    typedef float               ValueType;
+
+    // Create 2D Poisson problem
+    cusp::csr_matrix<IndexType,ValueType,MemorySpace> A;
+    cusp::gallery::poisson5pt(A, 100, 100);
+
+    cusp::precond::aggregation::smoothed_aggregation<IndexType,ValueType,MemorySpace> M(A);
+
+    std::vector<size_t> num_entries;
+    for(size_t lvl = 0; lvl < M.levels.size(); lvl++)
+        num_entries.push_back(M.levels[lvl].A.num_entries);
+
+    // change the values of A but not its sparsity pattern
+    cusp::blas::scal(A.values, ValueType(2));
+    M.update_values(A);
+
+    // the coarse operators are refilled through the plans of the first setup
+    for(size_t lvl = 0; lvl + 1 < M.sa_levels.size(); lvl++)
+    {
+        ASSERT_EQUAL(M.levels[lvl + 1].A.num_entries, num_entries[lvl + 1]);
+        ASSERT_EQUAL(M.sa_levels[lvl].RAP_plan.C_num_entries, num_entries[lvl + 1]);
+        ASSERT_EQUAL(M.sa_levels[lvl].RA_plan.C_num_entries, M.sa_levels[lvl].RA.num_entries);
+    }
+
+    // compare against a hierarchy created from scratch
+    cusp::precond::aggregation::smoothed_aggregation<IndexType,ValueType,MemorySpace> N(A);
+
+    ASSERT_EQUAL(M.levels.size(), N.levels.size());
+
+    // the update warm starts the spectral radius estimates from the
+    // previous setup, they agree with the cold estimates of the new
+    // hierarchy to within the accuracy of the estimator
+    for(size_t lvl = 0; lvl + 1 < M.sa_levels.size(); lvl++)
+    {
+        ASSERT_EQUAL(M.sa_levels[lvl].rho_x.size() > 0, true);
+        ASSERT_EQUAL(std::abs(M.sa_levels[lvl].rho_DinvA - N.sa_levels[lvl].rho_DinvA) < 0.05 * N.sa_levels[lvl].rho_DinvA, true);
+    }
+
+    // rebuild every level from the stored tentative prolongators with the
+    // same warm started estimates, the update must reproduce it exactly
+    cusp::csr_matrix<IndexType,ValueType,MemorySpace> A_lvl(A);
+
+    for(size_t lvl = 0; lvl + 1 < M.sa_levels.size(); lvl++)
+    {
+        cusp::csr_matrix<IndexType,ValueType,MemorySpace> P, R, RAP;
+        cusp::precond::aggregation::smooth_prolongator(A_lvl, M.sa_levels[lvl].T, P, M.sa_levels[lvl].rho_DinvA);
+        cusp::transpose(P, R);
+        cusp::precond::aggregation::galerkin_product(R, A_lvl, P, RAP);
+
+        // compared through products, the updated coarse operators keep the
+        // structural zeros of their spgemm plans
+        cusp::array1d<ValueType,MemorySpace> u = unittest::random_samples<ValueType>(P.num_cols);
+        cusp::array1d<ValueType,MemorySpace> v(P.num_rows);
+        cusp::array1d<ValueType,MemorySpace> w(P.num_rows);
+
+        cusp::multiply(M.levels[lvl].P, u, v);
+        cusp::multiply(P, u, w);
+        ASSERT_ALMOST_EQUAL(v, w);
+
+        cusp::array1d<ValueType,MemorySpace> y(RAP.num_rows);
+        cusp::array1d<ValueType,MemorySpace> z(RAP.num_rows);
+
+        cusp::multiply(M.levels[lvl + 1].A, u, y);
+        cusp::multiply(RAP, u, z);
+        ASSERT_ALMOST_EQUAL(y, z);
+
+        A_lvl.swap(RAP);
+    }
+
+    cusp::array1d<ValueType,MemorySpace> b = unittest::random_samples<ValueType>(A.num_rows);
+    cusp::array1d<ValueType,MemorySpace> x(A.num_rows, ValueType(0));
+
+    // set stopping criteria (iteration_limit = 20, relative_tolerance = 1e-4)
+    cusp::monitor<ValueType> monitor(b, 20, 1e-4);
+    cusp::krylov::cg(A, x, b, monitor, M);
+
+    ASSERT_EQUAL(monitor.converged(), true);
+}
+DECLARE_HOST_DEVICE_UNITTEST(TestSmoothedAggregationUpdateValues);
+
+template <typename Preconditioner, typename ArrayType>
+void compare_sa_hierarchies(Preconditioner& M, Preconditioner& N, const ArrayType& b)
+{
+    typedef typename ArrayType::value_type ValueType;
+    typedef typename ArrayType::memory_space MemorySpace;
+
+    ASSERT_EQUAL(M.levels.size(), N.levels.size());
+
+    for(size_t lvl = 0; lvl < M.levels.size(); lvl++)
+    {
+        ASSERT_EQUAL(M.levels[lvl].x.size(), N.levels[lvl].x.size());
+        ASSERT_EQUAL(M.levels[lvl].A.num_entries, N.levels[lvl].A.num_entries);
+
+        if(lvl > 0)
+        {
+            cusp::array1d<ValueType,MemorySpace> u = unittest::random_samples<ValueType>(M.levels[lvl].A.num_cols);
+            cusp::array1d<ValueType,MemorySpace> y(M.levels[lvl].A.num_rows);
+            cusp::array1d<ValueType,MemorySpace> z(N.levels[lvl].A.num_rows);
+
+            cusp::multiply(M.levels[lvl].A, u, y);
+            cusp::multiply(N.levels[lvl].A, u, z);
+            ASSERT_ALMOST_EQUAL(y, z);
+        }
+    }
+
+    // one cycle applies the smoothers of every level and the coarse solver
+    cusp::array1d<ValueType,MemorySpace> x(b.size(), ValueType(0));
+    cusp::array1d<ValueType,MemorySpace> y(b.size(), ValueType(0));
+
+    M(b, x);
+    N(b, y);
+    ASSERT_ALMOST_EQUAL(x, y);
+}
+
+template <class MemorySpace>
+void TestSmoothedAggregationOverlapSetup(void)
+{
+    typedef int                 IndexType;
+    typedef float               ValueType;
+
+    typedef cusp::precond::aggregation::smoothed_aggregation<IndexType,ValueType,MemorySpace> Preconditioner;
+
+    // Create 2D Poisson problem
+    cusp::csr_matrix<IndexType,ValueType,MemorySpace> A;
+    cusp::gallery::poisson5pt(A, 100, 100);
+
+    cusp::array1d<ValueType,MemorySpace> b = unittest::random_samples<ValueType>(A.num_rows);
+
+    Preconditioner M;
+    ASSERT_EQUAL(M.overlap_setup, false);
+    M.initialize(A);
+
+    // the overlapped setup must reproduce the serial hierarchy
+    Preconditioner N;
+    N.overlap_setup = true;
+    N.initialize(A);
+
+    ASSERT_EQUAL(M.levels.size() > 2, true);
+    compare_sa_hierarchies(M, N, b);
+
+    // change the values of A but not its sparsity pattern
+    cusp::blas::scal(A.values, ValueType(2));
+    M.update_values(A);
+    N.update_values(A);
+
+    compare_sa_hierarchies(M, N, b);
+}
+DECLARE_HOST_DEVICE_UNITTEST(TestSmoothedAggregationOverlapSetup);
+
+template <class MemorySpace>
+void TestSmoothedAggregationBinaryStream(void)
+{
+    typedef int                 IndexType;
+    typedef float               ValueType;
+
+    // Create 2D Poisson problem
+    cusp::csr_matrix<IndexType,ValueType,MemorySpace> A;
+    cusp::gallery::poisson5pt(A, 100, 100);
+
+    cusp::precond::aggregation::smoothed_aggregation<IndexType,ValueType,MemorySpace> M(A);
+
+    std::stringstream stream(std::ios::in | std::ios::out | std::ios::binary);
+    M.write_binary_stream(stream);
+
+    // reload the hierarchy into device memory
+    cusp::csr_matrix<IndexType,ValueType,cusp::device_memory> A_d(A);
+    cusp::precond::aggregation::smoothed_aggregation<IndexType,ValueType,cusp::device_memory> N;
+    N.read_binary_stream(A_d, stream);
+
+    ASSERT_EQUAL(N.levels.size(), M.levels.size());
+    ASSERT_EQUAL(N.sa_levels.size(), M.sa_levels.size());
+
+    for(size_t lvl = 0; lvl < M.sa_levels.size(); lvl++)
+        ASSERT_EQUAL(N.sa_levels[lvl].aggregates, M.sa_levels[lvl].aggregates);
+
+    cusp::array1d<ValueType,MemorySpace> b = unittest::random_samples<ValueType>(A.num_rows);
+    cusp::array1d<ValueType,MemorySpace> x(A.num_rows, ValueType(0));
+    cusp::array1d<ValueType,cusp::device_memory> b_d(b);
+    cusp::array1d<ValueType,cusp::device_memory> y(A.num_rows, ValueType(0));
+
+    M(b, x);
+    N(b_d, y);
+
+    ASSERT_ALMOST_EQUAL(x, y);
+
+    // a truncated hierarchy is rejected
+    std::stringstream truncated(stream.str().substr(0, stream.str().size() / 2),
+                                std::ios::in | std::ios::binary);
+    ASSERT_THROWS(N.read_binary_stream(A_d, truncated), cusp::io_exception);
+}
+DECLARE_HOST_DEVICE_UNITTEST(TestSmoothedAggregationBinaryStream);
+
 void TestSmoothedAggregationHostToDevice(void)
 {
     typedef int                 IndexType;
@@ -97,3 +413,210 @@ void TestSmoothedAggregationHostToDevice(void)
 }
 DECLARE_UNITTEST(TestSmoothedAggregationHostToDevice);
 
+template <class MemorySpace>
+void TestSmoothedAggregationBlockCycle(void)
+{
+    typedef int   IndexType;
+    typedef float ValueType;
+
+    cusp::csr_matrix<IndexType,ValueType,MemorySpace> A;
+    cusp::gallery::poisson5pt(A, 60, 50);
+
+    cusp::precond::aggregation::smoothed_aggregation<IndexType,ValueType,MemorySpace> M(A);
+
+    const size_t num_vectors = 3;
+
+    cusp::array2d<ValueType,MemorySpace,cusp::row_major> B(A.num_rows, num_vectors);
+    cusp::array2d<ValueType,MemorySpace,cusp::row_major> X(A.num_rows, num_vectors);
+
+    for(size_t k = 0; k < num_vectors; k++)
+    {
+        cusp::array1d<ValueType,MemorySpace> b = unittest::random_samples<ValueType>(A.num_rows);
+        typename cusp::array2d<ValueType,MemorySpace,cusp::row_major>::column_view bk(B.column(k));
+        cusp::copy(b, bk);
+    }
+
+    const cusp::cycle_type cycles[] = {cusp::V_CYCLE, cusp::W_CYCLE, cusp::F_CYCLE, cusp::K_CYCLE};
+
+    for(size_t i = 0; i < 4; i++)
+    {
+        M.set_cycle(cycles[i]);
+
+        // all columns at once
+        M(B, X);
+
+        for(size_t k = 0; k < num_vectors; k++)
+        {
+            cusp::array1d<ValueType,MemorySpace> b(B.column(k));
+            cusp::array1d<ValueType,MemorySpace> x(A.num_rows);
+            cusp::array1d<ValueType,MemorySpace> y(X.column(k));
+
+            M(b, x);
+
+            ASSERT_ALMOST_EQUAL(y, x);
+        }
+    }
+
+    // block cycles continue on the host levels
+    M.set_cycle(cusp::V_CYCLE);
+    M.set_host_level_size(M.levels[1].A.num_rows + 1);
+
+    cusp::array2d<ValueType,MemorySpace,cusp::row_major> Y(A.num_rows, num_vectors);
+    M(B, Y);
+
+    M.set_host_level_size(0);
+    M(B, X);
+
+    ASSERT_ALMOST_EQUAL(Y.values, X.values);
+}
+DECLARE_HOST_DEVICE_UNITTEST(TestSmoothedAggregationBlockCycle);
+
+void TestSmoothedAggregationHostLevels(void)
+{
+    typedef int                 IndexType;
+    typedef float               ValueType;
+    typedef cusp::device_memory MemorySpace;
+
+    // Create 2D Poisson problem
+    cusp::csr_matrix<IndexType,ValueType,MemorySpace> A;
+    cusp::gallery::poisson5pt(A, 200, 200);
+
+    cusp::precond::aggregation::smoothed_aggregation<IndexType,ValueType,MemorySpace> M(A);
+
+    cusp::array1d<ValueType,MemorySpace> b = unittest::random_samples<ValueType>(A.num_rows);
+    cusp::array1d<ValueType,MemorySpace> x(A.num_rows, ValueType(0));
+    cusp::array1d<ValueType,MemorySpace> y(A.num_rows, ValueType(0));
+
+    M(b, x);
+
+    // cycle through all coarse levels on the host
+    M.set_host_level_size(M.levels[1].A.num_rows + 1);
+    M(b, y);
+
+    ASSERT_ALMOST_EQUAL(x, y);
+
+    // set stopping criteria (iteration_limit = 20, relative_tolerance = 1e-4)
+    cusp::monitor<ValueType> monitor(b, 20, 1e-4);
+    cusp::blas::fill(x, ValueType(0));
+    cusp::krylov::cg(A, x, b, monitor, M);
+
+    ASSERT_EQUAL(monitor.converged(), true);
+}
+DECLARE_UNITTEST(TestSmoothedAggregationHostLevels);
+
+template <class MemorySpace>
+void TestSmoothedAggregationReport(void)
+{
+    typedef int   IndexType;
+    typedef float ValueType;
+
+    // Create 2D Poisson problem
+    cusp::csr_matrix<IndexType,ValueType,MemorySpace> A;
+    cusp::gallery::poisson5pt(A, 50, 50);
+
+    cusp::precond::aggregation::smoothed_aggregation<IndexType,ValueType,MemorySpace> M(A);
+
+    cusp::detail::multilevel_report report = M.report();
+
+    ASSERT_EQUAL(report.num_levels, M.levels.size());
+    ASSERT_EQUAL(report.levels.size(), M.levels.size());
+    ASSERT_ALMOST_EQUAL(report.operator_complexity, M.operator_complexity());
+    ASSERT_ALMOST_EQUAL(report.grid_complexity, M.grid_complexity());
+    ASSERT_EQUAL(report.levels[0].num_rows, size_t(A.num_rows));
+    ASSERT_EQUAL(report.levels[1].num_rows, size_t(M.levels[1].A.num_rows));
+    ASSERT_EQUAL(report.levels[0].num_entries, size_t(A.num_entries));
+    ASSERT_EQUAL(report.levels[0].P_bytes > 0, true);
+    ASSERT_EQUAL(report.levels[1].A_bytes > 0, true);
+    ASSERT_EQUAL(report.total_bytes > 0, true);
+    ASSERT_EQUAL(report.setup_times.empty(), false);
+
+    // the phases of every level add up to the total
+    double level_seconds = 0;
+    for(size_t i = 0; i < report.num_levels; i++)
+        level_seconds += report.levels[i].setup_seconds;
+
+    ASSERT_EQUAL(report.levels[0].setup_times.empty(), false);
+    ASSERT_EQUAL(report.levels[0].setup_times[0].first, std::string("strength"));
+    ASSERT_EQUAL(report.levels.back().setup_times.empty(), false);
+    ASSERT_EQUAL(std::fabs(level_seconds - report.setup_seconds) <= 1e-6 * report.setup_seconds + 1e-9, true);
+}
+DECLARE_HOST_DEVICE_UNITTEST(TestSmoothedAggregationReport);
+
+template <class MemorySpace>
+void TestSmoothedAggregationTruncation(void)
+{
+    typedef int   IndexType;
+    typedef float ValueType;
+
+    // Create 3D Poisson problem
+    cusp::csr_matrix<IndexType,ValueType,MemorySpace> A;
+    cusp::gallery::poisson27pt(A, 20, 20, 20);
+
+    cusp::precond::aggregation::smoothed_aggregation<IndexType,ValueType,MemorySpace> M(A);
+
+    cusp::precond::aggregation::smoothed_aggregation<IndexType,ValueType,MemorySpace> M_truncated;
+    M_truncated.prolongator_theta       = 0.2;
+    M_truncated.prolongator_max_entries = 4;
+    M_truncated.operator_theta          = 0.1;
+    M_truncated.initialize(A);
+
+    ASSERT_EQUAL(M_truncated.levels.size() > 1, true);
+    ASSERT_EQUAL(M_truncated.operator_complexity() < M.operator_complexity(), true);
+
+    for(size_t lvl = 0; lvl + 1 < M_truncated.levels.size(); lvl++)
+    {
+        cusp::csr_matrix<IndexType,ValueType,cusp::host_memory> P(M_truncated.levels[lvl].P);
+
+        for(IndexType i = 0; i < P.num_rows; i++)
+            ASSERT_EQUAL(P.row_offsets[i + 1] - P.row_offsets[i] <= 4, true);
+    }
+
+    // set stopping criteria (iteration_limit = 50, relative_tolerance = 1e-5)
+    cusp::array1d<ValueType,MemorySpace> b = unittest::random_samples<ValueType>(A.num_rows);
+    cusp::array1d<ValueType,MemorySpace> x(A.num_rows, ValueType(0));
+    cusp::monitor<ValueType> monitor(b, 50, 1e-5);
+
+    cusp::krylov::cg(A, x, b, monitor, M_truncated);
+
+    ASSERT_EQUAL(monitor.converged(), true);
+}
+DECLARE_HOST_DEVICE_UNITTEST(TestSmoothedAggregationTruncation);
+
+template <class MemorySpace>
+void TestSmoothedAggregationBoundedAggregates(void)
+{
+    typedef int   IndexType;
+    typedef float ValueType;
+
+    // Create 2D Poisson problem
+    cusp::csr_matrix<IndexType,ValueType,MemorySpace> A;
+    cusp::gallery::poisson5pt(A, 100, 100);
+
+    cusp::precond::aggregation::smoothed_aggregation<IndexType,ValueType,MemorySpace> M_bounded;
+    M_bounded.min_aggregate_size = 4;
+    M_bounded.max_aggregate_size = 9;
+    M_bounded.aggressive_levels  = 1;
+    M_bounded.initialize(A);
+
+    ASSERT_EQUAL(M_bounded.levels.size() > 1, true);
+
+    // the aggressively aggregated fine level
+    cusp::array1d<IndexType,cusp::host_memory> aggregates(M_bounded.sa_levels[0].aggregates);
+    cusp::array1d<IndexType,cusp::host_memory> sizes(M_bounded.levels[1].A.num_rows, 0);
+
+    for(size_t i = 0; i < aggregates.size(); i++)
+        sizes[aggregates[i]]++;
+
+    ASSERT_EQUAL(*thrust::min_element(sizes.begin(), sizes.end()) >= 4, true);
+    ASSERT_EQUAL(*thrust::max_element(sizes.begin(), sizes.end()) <= 9, true);
+
+    // set stopping criteria (iteration_limit = 100, relative_tolerance = 1e-5)
+    cusp::array1d<ValueType,MemorySpace> b = unittest::random_samples<ValueType>(A.num_rows);
+    cusp::array1d<ValueType,MemorySpace> x(A.num_rows, ValueType(0));
+    cusp::monitor<ValueType> monitor(b, 100, 1e-5);
+
+    cusp::krylov::cg(A, x, b, monitor, M_bounded);
+
+    ASSERT_EQUAL(monitor.converged(), true);
+}
+DECLARE_HOST_DEVICE_UNITTEST(TestSmoothedAggregationBoundedAggregates);
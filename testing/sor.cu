@@ -0,0 +1,95 @@
+#include <unittest/unittest.h>
+
+#include <cusp/relaxation/sor.h>
+
+#include <cusp/array1d.h>
+#include <cusp/csr_matrix.h>
+
+#include <cusp/gallery/poisson.h>
+
+// SOR sweeps over the rows in the given order
+template <typename MatrixType, typename ArrayType1, typename ArrayType2, typename ArrayType3>
+void reference_sor(const MatrixType& A, const ArrayType1& b, ArrayType2& x,
+                   const ArrayType3& ordering, const float omega, bool backward)
+{
+    const int N = A.num_rows;
+
+    for(int k = 0; k < N; k++)
+    {
+        const int i = ordering[backward ? N - 1 - k : k];
+
+        float diag = 0;
+        float rsum = 0;
+
+        for(int jj = A.row_offsets[i]; jj < A.row_offsets[i + 1]; jj++)
+        {
+            if(A.column_indices[jj] == i)
+                diag = A.values[jj];
+            else
+                rsum += A.values[jj] * x[A.column_indices[jj]];
+        }
+
+        x[i] = (1 - omega) * x[i] + omega * (b[i] - rsum) / diag;
+    }
+}
+
+template <typename Space>
+void TestSORRelaxationMulticolor(void)
+{
+    typedef cusp::csr_matrix<int,float,Space> Matrix;
+
+    Matrix A;
+    cusp::gallery::poisson5pt(A, 12, 9);
+
+    cusp::csr_matrix<int,float,cusp::host_memory> A_h(A);
+
+    cusp::array1d<float, Space> b(A.num_rows);
+    for(size_t i = 0; i < b.size(); i++)
+        b[i] = float(i % 5) - 2;
+
+    cusp::array1d<float, cusp::host_memory> b_h(b);
+
+    const float omega = 1.2;
+
+    cusp::relaxation::sor<float, Space> M(A, omega, cusp::relaxation::SYMMETRIC, true);
+
+    // the rows of a color are independent, so relaxing the colors one after
+    // the other matches sequential SOR in color order
+    cusp::array1d<int, cusp::host_memory> ordering(M.gs.ordering);
+
+    const cusp::relaxation::sweep sweeps[3] = { cusp::relaxation::FORWARD,
+                                                cusp::relaxation::BACKWARD,
+                                                cusp::relaxation::SYMMETRIC };
+
+    for(int n = 0; n < 3; n++)
+    {
+        cusp::array1d<float, Space> x(A.num_rows, 1);
+        cusp::array1d<float, cusp::host_memory> expected(A.num_rows, 1);
+
+        for(int k = 0; k < 2; k++)
+        {
+            M(A, b, x, omega, sweeps[n]);
+
+            if(sweeps[n] != cusp::relaxation::BACKWARD)
+                reference_sor(A_h, b_h, expected, ordering, omega, false);
+            if(sweeps[n] != cusp::relaxation::FORWARD)
+                reference_sor(A_h, b_h, expected, ordering, omega, true);
+        }
+
+        ASSERT_ALMOST_EQUAL(x, expected);
+    }
+
+    // omega = 1 reduces to multicolor Gauss-Seidel
+    {
+        cusp::relaxation::gauss_seidel<float, Space> gs(A, cusp::relaxation::SYMMETRIC, true);
+
+        cusp::array1d<float, Space> x(A.num_rows, 1);
+        cusp::array1d<float, Space> y(A.num_rows, 1);
+
+        M(A, b, x, 1.0, cusp::relaxation::SYMMETRIC);
+        gs(A, b, y);
+
+        ASSERT_ALMOST_EQUAL(x, y);
+    }
+}
+DECLARE_HOST_DEVICE_UNITTEST(TestSORRelaxationMulticolor);
@@ -2,6 +2,12 @@
 
 #include <cusp/sort.h>
 
+#include <thrust/sort.h>
+
+#include <algorithm>
+#include <limits>
+#include <vector>
+
 template <class Array>
 void InitializeSimpleKeySortTest(Array& unsorted_keys, Array& sorted_keys)
 {
@@ -106,3 +112,226 @@ void TestCountingSortByKey(void)
 }
 DECLARE_VECTOR_UNITTEST(TestCountingSortByKey);
 
+template <typename ArrayType>
+void TestCountingSortByKeyLargeRange(void)
+{
+    typedef typename ArrayType::value_type                               ValueType;
+    typedef typename ArrayType::template rebind<cusp::host_memory>::type HostArray;
+
+    // several tiles and a key range needing two digits
+    const size_t N = 5001;
+    const ValueType max_key = 20000;
+
+    HostArray unsorted_keys(N);
+    HostArray unsorted_vals(N);
+
+    for(size_t i = 0; i < N; i++)
+    {
+        unsorted_keys[i] = ValueType((i * 7919) % (size_t(max_key) + 1));
+        unsorted_vals[i] = ValueType(i % 1000);
+    }
+
+    // many equal keys check that the sort is stable
+    for(size_t i = 0; i < N; i += 3)
+        unsorted_keys[i] = ValueType(i % 5);
+
+    HostArray sorted_keys(unsorted_keys);
+    HostArray sorted_vals(unsorted_vals);
+    thrust::stable_sort_by_key(sorted_keys.begin(), sorted_keys.end(), sorted_vals.begin());
+
+    ArrayType keys(unsorted_keys);
+    ArrayType vals(unsorted_vals);
+
+    cusp::counting_sort_by_key(keys, vals, 0, max_key);
+
+    ASSERT_EQUAL(keys, sorted_keys);
+    ASSERT_EQUAL(vals, sorted_vals);
+
+    ArrayType keys_only(unsorted_keys);
+    cusp::counting_sort(keys_only, 0, max_key);
+
+    ASSERT_EQUAL(keys_only, sorted_keys);
+}
+DECLARE_VECTOR_UNITTEST(TestCountingSortByKeyLargeRange);
+
+
+template <typename ArrayType>
+void TestSortByRowAndColumnGroupedRows(void)
+{
+    typedef typename ArrayType::template rebind<cusp::host_memory>::type HostArray;
+
+    // rows are grouped, only the columns of the last row are out of order
+    HostArray rows(10);
+    HostArray cols(10);
+    HostArray vals(10);
+
+    rows[0] = 0; cols[0] = 0; vals[0] = 0;
+    rows[1] = 0; cols[1] = 2; vals[1] = 1;
+    rows[2] = 0; cols[2] = 5; vals[2] = 2;
+    rows[3] = 1; cols[3] = 1; vals[3] = 3;
+    rows[4] = 1; cols[4] = 3; vals[4] = 4;
+    rows[5] = 2; cols[5] = 0; vals[5] = 5;
+    rows[6] = 3; cols[6] = 4; vals[6] = 6;
+    rows[7] = 3; cols[7] = 1; vals[7] = 7;
+    rows[8] = 3; cols[8] = 3; vals[8] = 8;
+    rows[9] = 3; cols[9] = 2; vals[9] = 9;
+
+    HostArray sorted_cols(cols);
+    HostArray sorted_vals(vals);
+
+    sorted_cols[6] = 1; sorted_vals[6] = 7;
+    sorted_cols[7] = 2; sorted_vals[7] = 9;
+    sorted_cols[8] = 3; sorted_vals[8] = 8;
+    sorted_cols[9] = 4; sorted_vals[9] = 6;
+
+    {
+        ArrayType I(rows);
+        ArrayType J(cols);
+        ArrayType V(vals);
+
+        ASSERT_EQUAL(cusp::is_sorted_by_row(I), true);
+        ASSERT_EQUAL(cusp::is_sorted_by_row_and_column(I, J), false);
+
+        cusp::sort_by_row_and_column(I, J, V, 0, 4, 0, 6);
+
+        ASSERT_EQUAL(cusp::is_sorted_by_row_and_column(I, J), true);
+        ASSERT_EQUAL(I, rows);
+        ASSERT_EQUAL(J, sorted_cols);
+        ASSERT_EQUAL(V, sorted_vals);
+
+        // sorting again leaves the entries untouched
+        cusp::sort_by_row_and_column(I, J, V, 0, 4, 0, 6);
+
+        ASSERT_EQUAL(J, sorted_cols);
+        ASSERT_EQUAL(V, sorted_vals);
+    }
+
+    // scramble the first row as well so most rows are unsorted
+    cols[0] = 5; cols[2] = 0;
+    vals[0] = 2; vals[2] = 0;
+    cols[3] = 3; cols[4] = 1;
+    vals[3] = 4; vals[4] = 3;
+
+    {
+        ArrayType I(rows);
+        ArrayType J(cols);
+        ArrayType V(vals);
+
+        cusp::sort_by_row_and_column(I, J, V, 0, 4, 0, 6);
+
+        ASSERT_EQUAL(I, rows);
+        ASSERT_EQUAL(J, sorted_cols);
+        ASSERT_EQUAL(V, sorted_vals);
+    }
+}
+DECLARE_VECTOR_UNITTEST(TestSortByRowAndColumnGroupedRows);
+
+template <typename ArrayType>
+void TestSortByRowAndColumnUngroupedRows(void)
+{
+    typedef typename ArrayType::template rebind<cusp::host_memory>::type HostArray;
+
+    HostArray rows(6);
+    HostArray cols(6);
+    HostArray vals(6);
+
+    rows[0] = 3; cols[0] = 2; vals[0] = 0;
+    rows[1] = 0; cols[1] = 1; vals[1] = 1;
+    rows[2] = 3; cols[2] = 0; vals[2] = 2;
+    rows[3] = 2; cols[3] = 2; vals[3] = 3;
+    rows[4] = 0; cols[4] = 0; vals[4] = 4;
+    rows[5] = 2; cols[5] = 2; vals[5] = 5;
+
+    ArrayType I(rows);
+    ArrayType J(cols);
+    ArrayType V(vals);
+
+    ASSERT_EQUAL(cusp::is_sorted_by_row(I), false);
+
+    cusp::sort_by_row_and_column(I, J, V);
+
+    // duplicate (row,column) entries keep their relative order
+    HostArray sorted_rows(6);
+    HostArray sorted_cols(6);
+    HostArray sorted_vals(6);
+
+    sorted_rows[0] = 0; sorted_cols[0] = 0; sorted_vals[0] = 4;
+    sorted_rows[1] = 0; sorted_cols[1] = 1; sorted_vals[1] = 1;
+    sorted_rows[2] = 2; sorted_cols[2] = 2; sorted_vals[2] = 3;
+    sorted_rows[3] = 2; sorted_cols[3] = 2; sorted_vals[3] = 5;
+    sorted_rows[4] = 3; sorted_cols[4] = 0; sorted_vals[4] = 2;
+    sorted_rows[5] = 3; sorted_cols[5] = 2; sorted_vals[5] = 0;
+
+    ASSERT_EQUAL(I, sorted_rows);
+    ASSERT_EQUAL(J, sorted_cols);
+    ASSERT_EQUAL(V, sorted_vals);
+}
+DECLARE_VECTOR_UNITTEST(TestSortByRowAndColumnUngroupedRows);
+
+template <typename HostArray>
+struct row_column_less
+{
+    const HostArray& rows;
+    const HostArray& cols;
+
+    row_column_less(const HostArray& rows, const HostArray& cols)
+        : rows(rows), cols(cols) {}
+
+    bool operator()(const size_t i, const size_t j) const
+    {
+        return rows[i] < rows[j] || (rows[i] == rows[j] && cols[i] < cols[j]);
+    }
+};
+
+template <typename ArrayType>
+void TestSortByRowAndColumnRandom(void)
+{
+    typedef typename ArrayType::value_type IndexType;
+    typedef typename ArrayType::template rebind<cusp::host_memory>::type HostArray;
+
+    const size_t N = 1000;
+
+    // wide index types need more than 32 bits once (row,column) are packed
+    const IndexType max_index = IndexType(std::min<long long>(std::numeric_limits<IndexType>::max() / 2, 1 << 24));
+
+    HostArray rows(N);
+    HostArray cols(N);
+    HostArray vals(N);
+
+    unsigned long long seed = 13;
+    for(size_t i = 0; i < N; i++)
+    {
+        seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+        rows[i] = IndexType((seed >> 33) % 64);
+        cols[i] = IndexType((seed >> 17) % max_index);
+        vals[i] = IndexType(i % 1000);
+    }
+    rows[0] = max_index;
+
+    std::vector<size_t> permutation(N);
+    for(size_t i = 0; i < N; i++)
+        permutation[i] = i;
+    std::stable_sort(permutation.begin(), permutation.end(), row_column_less<HostArray>(rows, cols));
+
+    HostArray sorted_rows(N);
+    HostArray sorted_cols(N);
+    HostArray sorted_vals(N);
+
+    for(size_t i = 0; i < N; i++)
+    {
+        sorted_rows[i] = rows[permutation[i]];
+        sorted_cols[i] = cols[permutation[i]];
+        sorted_vals[i] = vals[permutation[i]];
+    }
+
+    ArrayType I(rows);
+    ArrayType J(cols);
+    ArrayType V(vals);
+
+    cusp::sort_by_row_and_column(I, J, V);
+
+    ASSERT_EQUAL(I, sorted_rows);
+    ASSERT_EQUAL(J, sorted_cols);
+    ASSERT_EQUAL(V, sorted_vals);
+}
+DECLARE_VECTOR_UNITTEST(TestSortByRowAndColumnRandom);
@@ -0,0 +1,106 @@
+#include <unittest/unittest.h>
+
+#include <cusp/graph/space_filling_curve.h>
+
+#include <cusp/array1d.h>
+#include <cusp/array2d.h>
+#include <cusp/permutation_matrix.h>
+
+#include <cmath>
+
+// the points of an n^dims lattice listed in a scrambled order
+cusp::array2d<float, cusp::host_memory> LatticePoints(const int n, const int dims)
+{
+    const int N = dims == 2 ? n * n : n * n * n;
+
+    cusp::array2d<float, cusp::host_memory> coords(N, dims);
+
+    for(int i = 0; i < N; i++)
+    {
+        const int p = (i * 7) % N;
+
+        coords(i, 0) = p % n;
+        coords(i, 1) = (p / n) % n;
+        if(dims == 3)
+            coords(i, 2) = p / (n * n);
+    }
+
+    return coords;
+}
+
+// positions of the points along the curve
+template <typename PermutationType>
+cusp::array1d<int, cusp::host_memory> CurveOrder(const PermutationType& P)
+{
+    cusp::array1d<int, cusp::host_memory> permutation(P.permutation);
+    cusp::array1d<int, cusp::host_memory> order(permutation.size(), -1);
+
+    for(size_t i = 0; i < permutation.size(); i++)
+        order[permutation[i]] = i;
+
+    return order;
+}
+
+template <class Space>
+void TestSpaceFillingCurveHilbert(void)
+{
+    for(int dims = 2; dims <= 3; dims++)
+    {
+        cusp::array2d<float, cusp::host_memory> coords = LatticePoints(4, dims);
+        cusp::array2d<float, Space> d_coords(coords);
+
+        cusp::permutation_matrix<int, Space> P;
+        cusp::graph::space_filling_curve(d_coords, P);
+
+        ASSERT_EQUAL(P.num_rows, coords.num_rows);
+
+        cusp::array1d<int, cusp::host_memory> order = CurveOrder(P);
+
+        // every point appears once and consecutive points are lattice neighbors
+        for(size_t k = 0; k < order.size(); k++)
+            ASSERT_EQUAL(order[k] >= 0, true);
+
+        for(size_t k = 1; k < order.size(); k++)
+        {
+            float distance = 0;
+            for(int d = 0; d < dims; d++)
+                distance += std::abs(coords(order[k], d) - coords(order[k - 1], d));
+
+            ASSERT_EQUAL(distance, 1.0f);
+        }
+    }
+}
+DECLARE_HOST_DEVICE_UNITTEST(TestSpaceFillingCurveHilbert);
+
+template <class Space>
+void TestSpaceFillingCurveMorton(void)
+{
+    for(int dims = 2; dims <= 3; dims++)
+    {
+        cusp::array2d<float, cusp::host_memory> coords = LatticePoints(4, dims);
+        cusp::array2d<float, Space> d_coords(coords);
+
+        cusp::permutation_matrix<int, Space> P;
+        cusp::graph::space_filling_curve(d_coords, P, cusp::graph::MORTON_CURVE);
+
+        // the position interleaves the bits of the lattice coordinates
+        cusp::array1d<int, cusp::host_memory> expected(coords.num_rows, 0);
+        for(size_t i = 0; i < coords.num_rows; i++)
+            for(int b = 0; b < 2; b++)
+                for(int d = 0; d < dims; d++)
+                    expected[i] |= ((int(coords(i, d)) >> b) & 1) << (dims * b + dims - 1 - d);
+
+        ASSERT_EQUAL(P.permutation, expected);
+    }
+}
+DECLARE_HOST_DEVICE_UNITTEST(TestSpaceFillingCurveMorton);
+
+template <class Space>
+void TestSpaceFillingCurveInvalidInput(void)
+{
+    cusp::array2d<float, Space> coords(10, 1, 0.0f);
+    cusp::permutation_matrix<int, Space> P;
+
+    ASSERT_THROWS(cusp::graph::space_filling_curve(coords, P), cusp::invalid_input_exception);
+}
+DECLARE_HOST_DEVICE_UNITTEST(TestSpaceFillingCurveInvalidInput);
@@ -13,6 +13,8 @@
 
 #include <cusp/gallery/poisson.h>
 
+#include <cmath>
+
 template <class SparseMatrix>
 void TestEstimateSpectralRadius(void)
 {
@@ -87,3 +89,80 @@ void TestEstimateRhoDinvA(void)
 }
 DECLARE_HOST_DEVICE_UNITTEST(TestEstimateRhoDinvA);
 
+
+template <class MemorySpace>
+void TestImplicitlyRestartedArnoldi(void)
+{
+    // block diagonal matrix of scaled 2x2 rotations, the eigenvalues are
+    // r_i * (cos t_i +/- i sin t_i)
+    const size_t N = 200;
+
+    cusp::coo_matrix<int, double, cusp::host_memory> A_h(N, N, 2 * N);
+
+    for(size_t i = 0; i < N; i += 2)
+    {
+        const double r = 1.0 + double(i) / N;
+        const double a = r * std::cos(3.0 * i / N);
+        const double b = r * std::sin(3.0 * i / N);
+
+        A_h.row_indices[2*i+0] = i;   A_h.column_indices[2*i+0] = i;   A_h.values[2*i+0] =  a;
+        A_h.row_indices[2*i+1] = i;   A_h.column_indices[2*i+1] = i+1; A_h.values[2*i+1] =  b;
+        A_h.row_indices[2*i+2] = i+1; A_h.column_indices[2*i+2] = i;   A_h.values[2*i+2] = -b;
+        A_h.row_indices[2*i+3] = i+1; A_h.column_indices[2*i+3] = i+1; A_h.values[2*i+3] =  a;
+    }
+
+    cusp::csr_matrix<int, double, MemorySpace> A(A_h);
+
+    cusp::array1d<cusp::complex<double>, cusp::host_memory> eigVals(2);
+
+    ASSERT_EQUAL(cusp::eigen::implicitly_restarted_arnoldi(A, eigVals, 20, 300, 1e-8), true);
+
+    const double r = 1.0 + double(N - 2) / N;
+    const double t = 3.0 * (N - 2) / N;
+
+    ASSERT_ALMOST_EQUAL(eigVals[0].real(), r * std::cos(t));
+    ASSERT_ALMOST_EQUAL(std::abs(eigVals[0].imag()), r * std::sin(t));
+    ASSERT_ALMOST_EQUAL(eigVals[1].real(), eigVals[0].real());
+    ASSERT_ALMOST_EQUAL(eigVals[1].imag(), -eigVals[0].imag());
+
+    ASSERT_ALMOST_EQUAL(cusp::eigen::restarted_spectral_radius(A, 20, 1e-8), r);
+
+    // the basis must leave room for two shifts
+    cusp::array1d<cusp::complex<double>, cusp::host_memory> tooMany(19);
+    ASSERT_THROWS(cusp::eigen::implicitly_restarted_arnoldi(A, tooMany, 20), cusp::invalid_input_exception);
+}
+DECLARE_HOST_DEVICE_UNITTEST(TestImplicitlyRestartedArnoldi);
+
+template <class MemorySpace>
+void TestAdaptiveSpectralRadius(void)
+{
+    cusp::csr_matrix<int, double, MemorySpace> A;
+    cusp::gallery::poisson5pt(A, 10, 10);
+
+    // the spectral radius of A and of (D^-1)A in closed form
+    const double rho = 4.0 + 4.0 * std::cos(M_PI / 11);
+    const double rho_DinvA = rho / 4.0;
+
+    // the estimate stops before maxiter once successive values agree
+    cusp::array1d<double, MemorySpace> x;
+    const double cold = cusp::eigen::adaptive_spectral_radius(A, x, 1e-3, 40);
+
+    ASSERT_EQUAL(x.size(), A.num_rows);
+    ASSERT_EQUAL(std::abs(cold - rho) < 0.05 * rho, true);
+
+    // a warm start from the returned Ritz vector is at least as accurate
+    const double warm = cusp::eigen::adaptive_spectral_radius(A, x, 1e-3, 40);
+    ASSERT_EQUAL(std::abs(warm - rho) <= std::abs(cold - rho) + 1e-8, true);
+
+    cusp::array1d<double, MemorySpace> y;
+    const double estimate = cusp::eigen::estimate_rho_Dinv_A(A, y);
+    ASSERT_EQUAL(std::abs(estimate - rho_DinvA) < 0.05 * rho_DinvA, true);
+    ASSERT_EQUAL(std::abs(cusp::eigen::estimate_rho_Dinv_A(A, y) - rho_DinvA) < 0.02 * rho_DinvA, true);
+
+    // the power iteration never overestimates a symmetric problem
+    cusp::array1d<double, MemorySpace> z;
+    const double power = cusp::eigen::jacobi_power_spectral_radius(A, z, 1e-4, 200);
+    ASSERT_EQUAL(power <= rho_DinvA + 1e-8, true);
+    ASSERT_EQUAL(power > 0.95 * rho_DinvA, true);
+}
+DECLARE_HOST_DEVICE_UNITTEST(TestAdaptiveSpectralRadius);
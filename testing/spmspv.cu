@@ -0,0 +1,115 @@
+#include <unittest/unittest.h>
+
+#include <cusp/array1d.h>
+#include <cusp/coo_matrix.h>
+#include <cusp/csr_matrix.h>
+#include <cusp/multiply.h>
+#include <cusp/sparse_vector.h>
+#include <cusp/transpose.h>
+
+#include <cusp/gallery/poisson.h>
+#include <cusp/gallery/random.h>
+
+template <class Space>
+void TestSparseVectorConstructor(void)
+{
+    cusp::array1d<float, cusp::host_memory> dense(6, 0);
+    dense[1] = 3;
+    dense[4] = 5;
+    dense[5] = 1;
+
+    cusp::sparse_vector<int, float, Space> x(dense);
+
+    ASSERT_EQUAL(x.length,         6);
+    ASSERT_EQUAL(x.num_entries,    3);
+    ASSERT_EQUAL(x.indices[0],     1);
+    ASSERT_EQUAL(x.indices[2],     5);
+    ASSERT_EQUAL(x.values[1],      5);
+
+    cusp::sparse_vector<int, float, cusp::host_memory> y(x);
+
+    ASSERT_EQUAL(y.indices, x.indices);
+    ASSERT_EQUAL(y.values,  x.values);
+
+    cusp::sparse_vector<int, float, Space> z(10, 0);
+    z.swap(x);
+
+    ASSERT_EQUAL(z.num_entries, 3);
+    ASSERT_EQUAL(x.length,      10);
+}
+DECLARE_HOST_DEVICE_UNITTEST(TestSparseVectorConstructor);
+
+template <typename MatrixType, typename Space>
+void CompareSpMSpV(const MatrixType& A, cusp::spmspv_method method)
+{
+    cusp::csr_matrix<int, float, cusp::host_memory> A_t;
+    cusp::transpose(cusp::csr_matrix<int, float, cusp::host_memory>(A), A_t);
+
+    // every third row of A with integral values
+    cusp::array1d<float, cusp::host_memory> x_dense(A.num_rows, 0);
+    for(size_t i = 0; i < A.num_rows; i += 3)
+        x_dense[i] = (i % 7) + 1;
+
+    cusp::array1d<float, cusp::host_memory> y_dense(A.num_cols);
+    cusp::multiply(A_t, x_dense, y_dense);
+
+    cusp::sparse_vector<int, float, Space> x(x_dense);
+    cusp::sparse_vector<int, float, Space> y;
+
+    cusp::generalized_spmspv(A, x, y, thrust::multiplies<float>(), thrust::plus<float>(), method);
+
+    cusp::sparse_vector<int, float, cusp::host_memory> y_h(y);
+    cusp::array1d<float, cusp::host_memory> y_test(A.num_cols, 0);
+    for(size_t k = 0; k < y_h.num_entries; k++)
+        y_test[y_h.indices[k]] = y_h.values[k];
+
+    ASSERT_EQUAL(y_h.length, A.num_cols);
+    ASSERT_EQUAL(y_test, y_dense);
+
+    for(size_t k = 1; k < y_h.num_entries; k++)
+        ASSERT_EQUAL(y_h.indices[k - 1] < y_h.indices[k], true);
+}
+
+template <class Space>
+void TestSpMSpV(void)
+{
+    cusp::csr_matrix<int, float, Space> A;
+    cusp::gallery::poisson5pt(A, 20, 15);
+
+    CompareSpMSpV<cusp::csr_matrix<int, float, Space>, Space>(A, cusp::SPMSPV_SORT);
+    CompareSpMSpV<cusp::csr_matrix<int, float, Space>, Space>(A, cusp::SPMSPV_BUCKET);
+
+    // rectangular matrix with enough products to use several buckets
+    cusp::csr_matrix<int, float, Space> B;
+    cusp::gallery::random(B, 600, 900, 40000);
+
+    CompareSpMSpV<cusp::csr_matrix<int, float, Space>, Space>(B, cusp::SPMSPV_SORT);
+    CompareSpMSpV<cusp::csr_matrix<int, float, Space>, Space>(B, cusp::SPMSPV_BUCKET);
+
+    // other formats are converted
+    cusp::coo_matrix<int, float, Space> C(B);
+
+    CompareSpMSpV<cusp::coo_matrix<int, float, Space>, Space>(C, cusp::SPMSPV_BUCKET);
+}
+DECLARE_HOST_DEVICE_UNITTEST(TestSpMSpV);
+
+template <class Space>
+void TestSpMSpVEmpty(void)
+{
+    cusp::csr_matrix<int, float, Space> A;
+    cusp::gallery::poisson5pt(A, 4, 4);
+
+    cusp::sparse_vector<int, float, Space> x(A.num_rows, 0);
+    cusp::sparse_vector<int, float, Space> y(3, 3);
+
+    cusp::generalized_spmspv(A, x, y, thrust::multiplies<float>(), thrust::plus<float>());
+
+    ASSERT_EQUAL(y.length,      A.num_cols);
+    ASSERT_EQUAL(y.num_entries, 0);
+
+    cusp::sparse_vector<int, float, Space> z(A.num_rows + 1, 0);
+
+    ASSERT_THROWS(cusp::generalized_spmspv(A, z, y, thrust::multiplies<float>(), thrust::plus<float>()),
+                  cusp::invalid_input_exception);
+}
+DECLARE_HOST_DEVICE_UNITTEST(TestSpMSpVEmpty);
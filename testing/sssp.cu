@@ -0,0 +1,101 @@
+#include <unittest/unittest.h>
+
+#include <cusp/graph/sssp.h>
+
+#include <cusp/array1d.h>
+#include <cusp/coo_matrix.h>
+#include <cusp/csr_matrix.h>
+
+#include <cusp/gallery/poisson.h>
+#include <cusp/gallery/random.h>
+
+#include <limits>
+
+// Bellman-Ford on the host
+template <typename MatrixType>
+cusp::array1d<float, cusp::host_memory>
+ReferenceSSSP(const MatrixType& A, const int src)
+{
+    cusp::csr_matrix<int, float, cusp::host_memory> G(A);
+    cusp::array1d<float, cusp::host_memory> dist(G.num_rows, std::numeric_limits<float>::infinity());
+    dist[src] = 0;
+
+    bool changed = true;
+
+    while(changed)
+    {
+        changed = false;
+
+        for(size_t i = 0; i < G.num_rows; i++)
+            for(int jj = G.row_offsets[i]; jj < G.row_offsets[i + 1]; jj++)
+                if(dist[i] + G.values[jj] < dist[G.column_indices[jj]])
+                {
+                    dist[G.column_indices[jj]] = dist[i] + G.values[jj];
+                    changed = true;
+                }
+    }
+
+    return dist;
+}
+
+template <typename MatrixType>
+void AssignWeights(MatrixType& G)
+{
+    // integral weights keep every sum exact, some of them zero
+    for(size_t n = 0; n < G.num_entries; n++)
+        G.values[n] = float((n * 13) % 9);
+}
+
+template <class Space>
+void TestSSSP(void)
+{
+    cusp::csr_matrix<int, float, cusp::host_memory> A;
+    cusp::gallery::poisson5pt(A, 20, 17);
+    AssignWeights(A);
+
+    cusp::csr_matrix<int, float, Space> G(A);
+    cusp::array1d<float, Space> distances(G.num_rows);
+
+    // automatic, narrow and wide buckets
+    cusp::graph::sssp(G, 0, distances);
+    ASSERT_EQUAL(distances, ReferenceSSSP(A, 0));
+
+    cusp::graph::sssp(G, 37, distances, 1.0);
+    ASSERT_EQUAL(distances, ReferenceSSSP(A, 37));
+
+    cusp::graph::sssp(G, 100, distances, 1000.0);
+    ASSERT_EQUAL(distances, ReferenceSSSP(A, 100));
+
+    // a directed graph with unreachable vertices
+    cusp::coo_matrix<int, float, cusp::host_memory> B;
+    cusp::gallery::random(B, 500, 500, 1500);
+    AssignWeights(B);
+
+    cusp::coo_matrix<int, float, Space> H(B);
+    cusp::array1d<float, Space> reachable(H.num_rows);
+
+    cusp::graph::sssp(H, 3, reachable);
+    ASSERT_EQUAL(reachable, ReferenceSSSP(B, 3));
+}
+DECLARE_HOST_DEVICE_UNITTEST(TestSSSP);
+
+template <class Space>
+void TestSSSPInvalidInput(void)
+{
+    cusp::csr_matrix<int, float, Space> G;
+    cusp::gallery::poisson5pt(G, 4, 4);
+
+    cusp::array1d<float, Space> distances(G.num_rows);
+
+    // the stencil has negative couplings
+    ASSERT_THROWS(cusp::graph::sssp(G, 0, distances), cusp::invalid_input_exception);
+
+    thrust::fill(G.values.begin(), G.values.end(), 1.0f);
+
+    ASSERT_THROWS(cusp::graph::sssp(G, G.num_rows, distances), cusp::invalid_input_exception);
+
+    cusp::array1d<float, Space> small(G.num_rows - 1);
+
+    ASSERT_THROWS(cusp::graph::sssp(G, 0, small), cusp::invalid_input_exception);
+}
+DECLARE_HOST_DEVICE_UNITTEST(TestSSSPInvalidInput);
@@ -1,5 +1,8 @@
 #include <unittest/unittest.h>
 
+#include <cusp/csr_matrix.h>
+#include <cusp/hyb_matrix.h>
+#include <cusp/verify.h>
 #include <cusp/gallery/stencil.h>
 
 void TestGenerateMatrixFromStencil1d(void)
@@ -117,3 +120,50 @@ void TestGenerateMatrixFromStencil2d(void)
 }
 DECLARE_UNITTEST(TestGenerateMatrixFromStencil2d);
 
+
+template <class MemorySpace>
+void TestGenerateCsrMatrixFromStencil(void)
+{
+    typedef int   IndexType;
+    typedef float ValueType;
+    typedef thrust::tuple<IndexType,IndexType,IndexType> StencilIndex;
+    typedef thrust::tuple<StencilIndex,ValueType>        StencilPoint;
+
+    // points are listed out of offset order and include a zero coefficient
+    cusp::array1d<StencilPoint, cusp::host_memory> stencil;
+
+    stencil.push_back(StencilPoint(StencilIndex( 0,  0,  1), 1));
+    stencil.push_back(StencilPoint(StencilIndex( 1,  0,  0), 2));
+    stencil.push_back(StencilPoint(StencilIndex( 0,  0,  0), 3));
+    stencil.push_back(StencilPoint(StencilIndex(-1,  0,  0), 0));
+    stencil.push_back(StencilPoint(StencilIndex( 0, -2,  0), 5));
+    stencil.push_back(StencilPoint(StencilIndex( 0,  0, -1), 6));
+
+    cusp::dia_matrix<IndexType, ValueType, cusp::host_memory> dia;
+    cusp::gallery::generate_matrix_from_stencil(dia, stencil, StencilIndex(4,5,3));
+
+    cusp::csr_matrix<IndexType, ValueType, MemorySpace> csr;
+    cusp::gallery::generate_matrix_from_stencil(csr, stencil, StencilIndex(4,5,3));
+
+    cusp::csr_matrix<IndexType, ValueType, cusp::host_memory> expected(dia);
+    cusp::csr_matrix<IndexType, ValueType, cusp::host_memory> result(csr);
+
+    ASSERT_EQUAL(result.num_rows,    expected.num_rows);
+    ASSERT_EQUAL(result.num_entries, expected.num_entries);
+    ASSERT_EQUAL(result.row_offsets, expected.row_offsets);
+    ASSERT_EQUAL(cusp::is_valid_matrix(result), true);
+
+    cusp::array2d<ValueType, cusp::host_memory> R(result);
+    cusp::array2d<ValueType, cusp::host_memory> E(dia);
+
+    ASSERT_EQUAL_QUIET(R, E);
+
+    // other formats are converted from the csr_matrix in their memory space
+    cusp::hyb_matrix<IndexType, ValueType, MemorySpace> hyb;
+    cusp::gallery::generate_matrix_from_stencil(hyb, stencil, StencilIndex(4,5,3));
+
+    cusp::array2d<ValueType, cusp::host_memory> H(hyb);
+
+    ASSERT_EQUAL_QUIET(H, E);
+}
+DECLARE_HOST_DEVICE_UNITTEST(TestGenerateCsrMatrixFromStencil);
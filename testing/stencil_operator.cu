@@ -0,0 +1,137 @@
+#include <unittest/unittest.h>
+
+#include <cusp/stencil_operator.h>
+
+#include <cusp/array1d.h>
+#include <cusp/array2d.h>
+#include <cusp/dia_matrix.h>
+#include <cusp/monitor.h>
+#include <cusp/multiply.h>
+
+#include <cusp/gallery/stencil.h>
+#include <cusp/krylov/cg.h>
+
+typedef thrust::tuple<int,int>                   StencilIndex2d;
+typedef thrust::tuple<StencilIndex2d,float>      StencilPoint2d;
+typedef thrust::tuple<int,int,int>               StencilIndex3d;
+typedef thrust::tuple<StencilIndex3d,float>      StencilPoint3d;
+
+void initialize_5pt_stencil(cusp::array1d<StencilPoint2d, cusp::host_memory>& stencil)
+{
+    stencil.resize(0);
+    stencil.push_back(StencilPoint2d(StencilIndex2d( 0, -1), -1));
+    stencil.push_back(StencilPoint2d(StencilIndex2d(-1,  0), -1));
+    stencil.push_back(StencilPoint2d(StencilIndex2d( 0,  0),  4));
+    stencil.push_back(StencilPoint2d(StencilIndex2d( 1,  0), -1));
+    stencil.push_back(StencilPoint2d(StencilIndex2d( 0,  1), -1));
+}
+
+void initialize_27pt_stencil(cusp::array1d<StencilPoint3d, cusp::host_memory>& stencil)
+{
+    stencil.resize(0);
+
+    for(int k = -1; k <= 1; k++)
+        for(int j = -1; j <= 1; j++)
+            for(int i = -1; i <= 1; i++)
+                stencil.push_back(StencilPoint3d(StencilIndex3d(i, j, k), (i == 0 && j == 0 && k == 0) ? 26 : -1));
+}
+
+template <typename StencilOperator, typename MatrixType>
+void verify_stencil_operator(const StencilOperator& A, const MatrixType& D)
+{
+    typedef typename StencilOperator::memory_space MemorySpace;
+
+    cusp::array1d<float, cusp::host_memory> x(D.num_cols);
+    for(size_t i = 0; i < x.size(); i++)
+        x[i] = i % 7;
+
+    cusp::array1d<float, cusp::host_memory> y(D.num_rows, 0);
+    cusp::multiply(D, x, y);
+
+    cusp::array1d<float, MemorySpace> _x(x);
+    cusp::array1d<float, MemorySpace> _y(A.num_rows, 10);
+    cusp::multiply(A, _x, _y);
+
+    ASSERT_EQUAL(_y, y);
+}
+
+template <class MemorySpace>
+void TestStencilOperator(void)
+{
+    // constant coefficients
+    {
+        cusp::array1d<StencilPoint2d, cusp::host_memory> stencil;
+        initialize_5pt_stencil(stencil);
+
+        cusp::dia_matrix<int, float, cusp::host_memory> D;
+        cusp::gallery::generate_matrix_from_stencil(D, stencil, StencilIndex2d(7, 5));
+
+        cusp::stencil_operator<2, 5, float, MemorySpace> A(stencil, StencilIndex2d(7, 5));
+
+        ASSERT_EQUAL(A.num_rows,    35);
+        ASSERT_EQUAL(A.num_cols,    35);
+        ASSERT_EQUAL(A.num_entries, D.num_entries);
+
+        verify_stencil_operator(A, D);
+    }
+
+    // variable coefficients on a grid wider than a thread block
+    {
+        cusp::array1d<StencilPoint3d, cusp::host_memory> stencil;
+        initialize_27pt_stencil(stencil);
+
+        cusp::dia_matrix<int, float, cusp::host_memory> D;
+        cusp::gallery::generate_matrix_from_stencil(D, stencil, StencilIndex3d(300, 3, 4));
+
+        cusp::stencil_operator<3, 27, float, MemorySpace> A(stencil, StencilIndex3d(300, 3, 4));
+
+        ASSERT_EQUAL(A.num_entries, D.num_entries);
+
+        cusp::array2d<float, cusp::host_memory, cusp::column_major> V(A.num_rows, 27);
+
+        for(size_t i = 0; i < V.num_rows; i++)
+        {
+            for(size_t p = 0; p < 27; p++)
+            {
+                V(i,p) = float((i + p) % 5) - 2;
+
+                if(D.values(i,p) != 0)
+                    D.values(i,p) = V(i,p);
+            }
+        }
+
+        A.values = V;
+
+        verify_stencil_operator(A, D);
+    }
+}
+DECLARE_HOST_DEVICE_UNITTEST(TestStencilOperator);
+
+template <class MemorySpace>
+void TestStencilOperatorSolve(void)
+{
+    cusp::array1d<StencilPoint2d, cusp::host_memory> stencil;
+    initialize_5pt_stencil(stencil);
+
+    cusp::stencil_operator<2, 5, float, MemorySpace> A(stencil, StencilIndex2d(10, 10));
+
+    cusp::array1d<float, MemorySpace> x(A.num_rows, 0);
+    cusp::array1d<float, MemorySpace> b(A.num_rows, 1);
+
+    cusp::monitor<float> monitor(b, 100, 1e-5);
+    cusp::krylov::cg(A, x, b, monitor);
+
+    ASSERT_EQUAL(monitor.converged(), true);
+}
+DECLARE_HOST_DEVICE_UNITTEST(TestStencilOperatorSolve);
+
+void TestStencilOperatorInvalidStencil(void)
+{
+    cusp::array1d<StencilPoint2d, cusp::host_memory> stencil;
+    initialize_5pt_stencil(stencil);
+
+    typedef cusp::stencil_operator<2, 9, float, cusp::host_memory> Operator;
+
+    ASSERT_THROWS(Operator(stencil, StencilIndex2d(4, 4)), cusp::invalid_input_exception);
+}
+DECLARE_UNITTEST(TestStencilOperatorInvalidStencil);
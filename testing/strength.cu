@@ -9,6 +9,8 @@
 #include <cusp/ell_matrix.h>
 #include <cusp/hyb_matrix.h>
 
+#include <thrust/fill.h>
+
 template <typename SparseMatrix>
 void TestSymmetricStrengthOfConnection(void)
 {
@@ -138,3 +140,48 @@ void TestSymmetricStrengthOfConnection(void)
 }
 DECLARE_SPARSE_MATRIX_UNITTEST(TestSymmetricStrengthOfConnection);
 
+
+template <class MemorySpace>
+void TestSymmetricStrengthOfConnectionEmptyRows(void)
+{
+    typedef cusp::array2d<float,cusp::host_memory> Matrix;
+
+    // rows 1 and 3 are empty, row 2 has no diagonal entry
+    Matrix M(4,4,0.0f);
+    M(0,0) =  4.0;
+    M(0,2) = -1.0;
+    M(2,0) = -1.0;
+    M(2,3) = -0.1;
+
+    cusp::coo_matrix<int,float,MemorySpace> A_coo(M);
+    cusp::csr_matrix<int,float,MemorySpace> A_csr(M);
+
+    {
+        cusp::coo_matrix<int,float,MemorySpace> S;
+        cusp::precond::aggregation::symmetric_strength_of_connection(A_coo, S, 0.5);
+        Matrix result = S;
+        ASSERT_EQUAL(S.num_entries, 4);
+        ASSERT_EQUAL(result == M, true);
+    }
+
+    {
+        cusp::csr_matrix<int,float,MemorySpace> S;
+        cusp::precond::aggregation::symmetric_strength_of_connection(A_csr, S, 0.5);
+        Matrix result = S;
+        ASSERT_EQUAL(S.num_entries, 4);
+        ASSERT_EQUAL(result == M, true);
+    }
+
+    // a matrix without entries has no strong connections
+    {
+        cusp::csr_matrix<int,float,MemorySpace> Z(4,4,0);
+        thrust::fill(Z.row_offsets.begin(), Z.row_offsets.end(), 0);
+
+        cusp::csr_matrix<int,float,MemorySpace> S;
+        cusp::precond::aggregation::symmetric_strength_of_connection(Z, S, 0.5);
+        ASSERT_EQUAL(S.num_rows, 4);
+        ASSERT_EQUAL(S.num_entries, 0);
+        ASSERT_EQUAL(S.row_offsets[4], 0);
+    }
+}
+DECLARE_HOST_DEVICE_UNITTEST(TestSymmetricStrengthOfConnectionEmptyRows);
@@ -0,0 +1,100 @@
+#include <unittest/unittest.h>
+
+#include <cusp/array2d.h>
+#include <cusp/coo_matrix.h>
+#include <cusp/csr_matrix.h>
+#include <cusp/symmetric_matrix.h>
+#include <cusp/multiply.h>
+
+#include <cusp/gallery/poisson.h>
+
+template <class Space>
+void TestSymmetricMatrixBasicConstructor(void)
+{
+    cusp::symmetric_matrix<int, float, Space> matrix(4, 10, 7);
+
+    ASSERT_EQUAL(matrix.num_rows,                    4);
+    ASSERT_EQUAL(matrix.num_cols,                    4);
+    ASSERT_EQUAL(matrix.num_entries,                 10);
+    ASSERT_EQUAL(matrix.upper.num_entries,           7);
+    ASSERT_EQUAL(matrix.upper.row_offsets.size(),    5);
+    ASSERT_EQUAL(matrix.upper.column_indices.size(), 7);
+    ASSERT_EQUAL(matrix.upper.values.size(),         7);
+}
+DECLARE_HOST_DEVICE_UNITTEST(TestSymmetricMatrixBasicConstructor);
+
+template <class Space>
+void TestSymmetricMatrixConversion(void)
+{
+    cusp::csr_matrix<int, float, Space> A;
+    cusp::gallery::poisson5pt(A, 7, 5);
+
+    cusp::symmetric_matrix<int, float, Space> B(A);
+
+    // 35 diagonal entries and 6 * 5 + 7 * 4 entries above the diagonal
+    ASSERT_EQUAL(B.num_rows,          35);
+    ASSERT_EQUAL(B.num_cols,          35);
+    ASSERT_EQUAL(B.num_entries,       A.num_entries);
+    ASSERT_EQUAL(B.upper.num_entries, 35 + 30 + 28);
+
+    // convert back to CSR
+    cusp::csr_matrix<int, float, Space> C(B);
+
+    ASSERT_EQUAL(C.row_offsets,    A.row_offsets);
+    ASSERT_EQUAL(C.column_indices, A.column_indices);
+    ASSERT_EQUAL(C.values,         A.values);
+
+    // only square matrices are symmetric
+    cusp::coo_matrix<int, float, Space> D(3, 4, 0);
+    ASSERT_THROWS(B = D, cusp::format_conversion_exception);
+}
+DECLARE_HOST_DEVICE_UNITTEST(TestSymmetricMatrixConversion);
+
+template <class MemorySpace>
+void TestSymmetricMatrixVectorMultiply(void)
+{
+    // symmetric matrix with an empty row and entries far from the diagonal
+    cusp::array2d<float, cusp::host_memory> H(300, 300, 0);
+    for(int i = 0; i < 300; i++)
+    {
+        if(i == 150)
+            continue;
+
+        H(i, i) = 4;
+
+        const int j = (7 * i + 3) % 300;
+        if(j != 150)
+            H(i, j) = H(j, i) = i % 3 + 1;
+    }
+
+    cusp::csr_matrix<int, float, MemorySpace> A(H);
+    cusp::symmetric_matrix<int, float, MemorySpace> B(A);
+
+    cusp::array1d<float, MemorySpace> x(A.num_cols);
+    for(size_t i = 0; i < A.num_cols; i++)
+        x[i] = i % 5;
+
+    cusp::array1d<float, MemorySpace> y(A.num_rows, 10);
+    cusp::array1d<float, MemorySpace> z(A.num_rows, 10);
+
+    cusp::multiply(A, x, y);
+    cusp::multiply(B, x, z);
+
+    ASSERT_EQUAL(z, y);
+
+    cusp::gallery::poisson5pt(A, 30, 20);
+    B = A;
+
+    x.resize(A.num_cols);
+    for(size_t i = 0; i < A.num_cols; i++)
+        x[i] = i % 7;
+
+    y.resize(A.num_rows);
+    z.resize(A.num_rows);
+
+    cusp::multiply(A, x, y);
+    cusp::multiply(B, x, z);
+
+    ASSERT_EQUAL(z, y);
+}
+DECLARE_HOST_DEVICE_UNITTEST(TestSymmetricMatrixVectorMultiply);
@@ -2,9 +2,17 @@
 
 #include <cusp/graph/symmetric_rcm.h>
 
+#include <cusp/coo_matrix.h>
 #include <cusp/csr_matrix.h>
 #include <cusp/permutation_matrix.h>
 
+#include <cusp/gallery/grid.h>
+
+#include <thrust/fill.h>
+
+#include <algorithm>
+#include <cstdlib>
+
 template <typename MatrixType, typename PermutationType>
 void symmetric_rcm(my_system& system, const MatrixType& G, PermutationType& P)
 {
@@ -28,3 +36,91 @@ void TestSymmetricRCMDispatch()
 }
 DECLARE_UNITTEST(TestSymmetricRCMDispatch);
 
+
+template <typename MatrixType>
+int matrix_bandwidth(const MatrixType& A)
+{
+    cusp::coo_matrix<int,float,cusp::host_memory> B(A);
+
+    int bandwidth = 0;
+
+    for(size_t n = 0; n < B.num_entries; n++)
+        bandwidth = std::max(bandwidth, std::abs(B.row_indices[n] - B.column_indices[n]));
+
+    return bandwidth;
+}
+
+template <class MemorySpace>
+void TestSymmetricRCMBandwidth(void)
+{
+    cusp::csr_matrix<int,float,cusp::host_memory> grid;
+    cusp::gallery::grid2d(grid, 40, 25);
+
+    const int N = grid.num_rows;
+
+    // scatter the grid vertices so the natural ordering has a large bandwidth
+    cusp::permutation_matrix<int,cusp::host_memory> S(N);
+    for(int i = 0; i < N; i++)
+        S.permutation[i] = (i * 367) % N;
+
+    cusp::coo_matrix<int,float,cusp::host_memory> shuffled(grid);
+    S.symmetric_permute(shuffled);
+    shuffled.sort_by_row_and_column();
+
+    cusp::csr_matrix<int,float,MemorySpace> G(shuffled);
+    cusp::permutation_matrix<int,MemorySpace> P(N);
+
+    cusp::graph::symmetric_rcm(G, P);
+
+    // P is a permutation
+    cusp::array1d<int,cusp::host_memory> h_permutation(P.permutation);
+    cusp::array1d<int,cusp::host_memory> counts(N, 0);
+    for(int i = 0; i < N; i++)
+        counts[h_permutation[i]]++;
+    for(int i = 0; i < N; i++)
+        ASSERT_EQUAL(counts[i], 1);
+
+    cusp::coo_matrix<int,float,MemorySpace> G_rcm(G);
+    P.symmetric_permute(G_rcm);
+
+    // the levels of a breadth first search from a corner of the grid hold
+    // at most 25 vertices, which bounds the RCM bandwidth by 49
+    ASSERT_EQUAL(matrix_bandwidth(G_rcm) < 50, true);
+    ASSERT_EQUAL(matrix_bandwidth(G_rcm) < matrix_bandwidth(G), true);
+}
+DECLARE_HOST_DEVICE_UNITTEST(TestSymmetricRCMBandwidth);
+
+template <class MemorySpace>
+void TestSymmetricRCMDisconnected(void)
+{
+    // two disjoint paths and an isolated vertex
+    cusp::coo_matrix<int,float,cusp::host_memory> A(7, 7, 8);
+    A.row_indices[0] = 0; A.column_indices[0] = 1;
+    A.row_indices[1] = 1; A.column_indices[1] = 0;
+    A.row_indices[2] = 1; A.column_indices[2] = 2;
+    A.row_indices[3] = 2; A.column_indices[3] = 1;
+    A.row_indices[4] = 4; A.column_indices[4] = 5;
+    A.row_indices[5] = 5; A.column_indices[5] = 4;
+    A.row_indices[6] = 5; A.column_indices[6] = 6;
+    A.row_indices[7] = 6; A.column_indices[7] = 5;
+    thrust::fill(A.values.begin(), A.values.end(), 1.0f);
+
+    cusp::csr_matrix<int,float,MemorySpace> G(A);
+    cusp::permutation_matrix<int,MemorySpace> P(7);
+
+    cusp::graph::symmetric_rcm(G, P);
+
+    cusp::array1d<int,cusp::host_memory> h_permutation(P.permutation);
+    cusp::array1d<int,cusp::host_memory> counts(7, 0);
+    for(int i = 0; i < 7; i++)
+        counts[h_permutation[i]]++;
+    for(int i = 0; i < 7; i++)
+        ASSERT_EQUAL(counts[i], 1);
+
+    // every component is numbered contiguously along its path
+    ASSERT_EQUAL(std::abs(h_permutation[0] - h_permutation[1]), 1);
+    ASSERT_EQUAL(std::abs(h_permutation[1] - h_permutation[2]), 1);
+    ASSERT_EQUAL(std::abs(h_permutation[4] - h_permutation[5]), 1);
+    ASSERT_EQUAL(std::abs(h_permutation[5] - h_permutation[6]), 1);
+}
+DECLARE_HOST_DEVICE_UNITTEST(TestSymmetricRCMDisconnected);
@@ -5,6 +5,8 @@
 
 #include <cusp/array1d.h>
 #include <cusp/array2d.h>
+#include <cusp/multiply.h>
+#include <cusp/transpose.h>
 
 template <typename MemorySpace>
 void TestFitCandidates(void)
@@ -78,3 +80,70 @@ void TestFitCandidates(void)
 }
 DECLARE_HOST_DEVICE_UNITTEST(TestFitCandidates);
 
+
+template <typename MemorySpace>
+void TestFitMultipleCandidates(void)
+{
+    typedef typename cusp::precond::aggregation::detail::select_sa_matrix_type<int,float,MemorySpace>::type SetupMatrixType;
+
+    // 3 aggregates with 4, 3 and 2 nodes and one unaggregated node
+    cusp::array1d<int,MemorySpace> aggregates(10);
+    aggregates[0] = 0;
+    aggregates[1] = 1;
+    aggregates[2] = 0;
+    aggregates[3] = 2;
+    aggregates[4] = 1;
+    aggregates[5] = 0;
+    aggregates[6] = -1;
+    aggregates[7] = 2;
+    aggregates[8] = 1;
+    aggregates[9] = 0;
+
+    // constant and linear candidates
+    cusp::array2d<float,cusp::host_memory> B_h(10, 2);
+    for(int i = 0; i < 10; i++)
+    {
+        B_h(i,0) = 1.0f;
+        B_h(i,1) = float(i);
+    }
+
+    cusp::array2d<float,MemorySpace> B(B_h);
+
+    SetupMatrixType Q;
+    cusp::array2d<float,MemorySpace> R;
+
+    cusp::precond::aggregation::fit_candidates(aggregates, B, Q, R);
+
+    ASSERT_EQUAL(Q.num_rows, 10);
+    ASSERT_EQUAL(Q.num_cols, 6);
+    ASSERT_EQUAL(Q.num_entries, 18);
+    ASSERT_EQUAL(R.num_rows, 6);
+    ASSERT_EQUAL(R.num_cols, 2);
+
+    cusp::array2d<float,cusp::host_memory> Q_h(Q);
+    cusp::array2d<float,cusp::host_memory> R_h(R);
+
+    // the columns of Q are orthonormal
+    cusp::array2d<float,cusp::host_memory> Qt_h;
+    cusp::transpose(Q_h, Qt_h);
+
+    cusp::array2d<float,cusp::host_memory> QtQ;
+    cusp::multiply(Qt_h, Q_h, QtQ);
+
+    for(int i = 0; i < 6; i++)
+        for(int j = 0; j < 6; j++)
+            ASSERT_ALMOST_EQUAL(QtQ(i,j), i == j ? 1.0f : 0.0f);
+
+    // Q R reproduces the candidates on the aggregated nodes
+    cusp::array2d<float,cusp::host_memory> QR;
+    cusp::multiply(Q_h, R_h, QR);
+
+    for(int i = 0; i < 10; i++)
+        for(int k = 0; k < 2; k++)
+            ASSERT_ALMOST_EQUAL(QR(i,k), i == 6 ? 0.0f : B_h(i,k));
+
+    // R is upper triangular within each aggregate
+    for(int a = 0; a < 3; a++)
+        ASSERT_ALMOST_EQUAL(R_h(2 * a + 1, 0), 0.0f);
+}
+DECLARE_HOST_DEVICE_UNITTEST(TestFitMultipleCandidates);
@@ -0,0 +1,112 @@
+#include <unittest/unittest.h>
+
+#include <cusp/array1d.h>
+#include <cusp/csr_matrix.h>
+#include <cusp/linear_operator.h>
+#include <cusp/monitor.h>
+#include <cusp/multiply.h>
+
+#include <cusp/gallery/poisson.h>
+#include <cusp/krylov/cg.h>
+#include <cusp/system/cuda/tuning.h>
+
+#if __cplusplus >= 201103L
+#include <thread>
+#include <vector>
+#endif
+
+// solves a Poisson problem and applies the matrix on a private stream,
+// the results are checked by the main thread
+struct independent_solve
+{
+    size_t grid_size;
+    size_t num_repeats;
+
+    cusp::array1d<float, cusp::host_memory> x;
+    cusp::array1d<float, cusp::host_memory> y;
+
+    void operator()(void)
+    {
+        cusp::csr_matrix<int, float, cusp::device_memory> A;
+        cusp::gallery::poisson5pt(A, grid_size, grid_size + 1);
+
+        cusp::array1d<float, cusp::device_memory> b(A.num_rows, 1);
+        cusp::array1d<float, cusp::device_memory> d_x(A.num_rows);
+        cusp::array1d<float, cusp::device_memory> d_y(A.num_rows);
+
+        cusp::identity_operator<float, cusp::device_memory> M(A.num_rows, A.num_rows);
+
+        cudaStream_t s;
+        cudaStreamCreate(&s);
+
+        for(size_t i = 0; i < num_repeats; i++)
+        {
+            thrust::fill(cusp::cuda::par.on(s), d_x.begin(), d_x.end(), 0.0f);
+
+            cusp::monitor<float> monitor(cusp::cuda::par.on(s), b, 200, 1e-5);
+            cusp::krylov::cg(cusp::cuda::par.on(s), A, d_x, b, monitor, M);
+
+            cusp::multiply(cusp::cuda::par.on(s), A, d_x, d_y);
+        }
+
+        cudaStreamSynchronize(s);
+        cudaStreamDestroy(s);
+
+        x = d_x;
+        y = d_y;
+    }
+};
+
+void _TestConcurrentIndependentSolves(void)
+{
+#if __cplusplus >= 201103L
+    const size_t num_threads = 8;
+
+    // every problem is also solved on the calling thread first
+    std::vector<independent_solve> expected(num_threads);
+    std::vector<independent_solve> solves(num_threads);
+
+    for(size_t i = 0; i < num_threads; i++)
+    {
+        expected[i].grid_size   = 10 + 3 * i;
+        expected[i].num_repeats = 1;
+        expected[i]();
+
+        solves[i].grid_size   = expected[i].grid_size;
+        solves[i].num_repeats = 4;
+    }
+
+    std::vector<std::thread> threads;
+
+    for(size_t i = 0; i < num_threads; i++)
+        threads.push_back(std::thread(std::ref(solves[i])));
+
+    for(size_t i = 0; i < num_threads; i++)
+        threads[i].join();
+
+    for(size_t i = 0; i < num_threads; i++)
+    {
+        ASSERT_ALMOST_EQUAL(solves[i].x, expected[i].x);
+        ASSERT_ALMOST_EQUAL(solves[i].y, expected[i].y);
+    }
+#endif
+}
+
+void TestConcurrentIndependentSolves(void)
+{
+    _TestConcurrentIndependentSolves();
+}
+DECLARE_UNITTEST(TestConcurrentIndependentSolves);
+
+// the threads share the tuning records and launch configuration cache
+void TestConcurrentTunedSolves(void)
+{
+    cusp::system::cuda::clear_spmv_tuning();
+    cusp::system::cuda::enable_spmv_tuning();
+
+    _TestConcurrentIndependentSolves();
+
+    cusp::system::cuda::disable_spmv_tuning();
+    cusp::system::cuda::clear_spmv_tuning();
+}
+DECLARE_UNITTEST(TestConcurrentTunedSolves);
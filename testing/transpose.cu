@@ -201,6 +201,55 @@ void TestTranspose(void)
 }
 DECLARE_MATRIX_UNITTEST(TestTranspose);
 
+template <class Space>
+void TestTransposeCsrLongColumns(void)
+{
+    // 3000x300 matrix whose first column is dense, so At has one row far
+    // longer than the others, the entries span several tiles of the
+    // counting sort and the column indices need two radix passes
+    const int num_rows = 3000;
+    const int num_cols = 300;
+
+    cusp::array2d<float, cusp::host_memory> D(num_rows, num_cols, 0);
+
+    for(int i = 0; i < num_rows; i++)
+    {
+        D(i, 0) = i + 1;
+        D(i, (7 * i) % num_cols) = 2;
+        D(i, (13 * i + 5) % num_cols) = 3;
+    }
+
+    cusp::csr_matrix<int, float, Space> A(D);
+    cusp::csr_matrix<int, float, Space> At;
+
+    cusp::transpose(A, At);
+
+    cusp::array2d<float, cusp::host_memory> Dt(At);
+    cusp::array2d<float, cusp::host_memory> Et;
+    cusp::transpose(D, Et);
+
+    ASSERT_EQUAL(Dt == Et, true);
+
+    cusp::coo_matrix<int, float, cusp::host_memory> At_coo(At);
+    ASSERT_EQUAL(At_coo.is_sorted_by_row_and_column(), true);
+
+    // without the dense column every row of At is short
+    for(int i = 0; i < num_rows; i++)
+        D(i, 0) = 0;
+
+    A = D;
+    cusp::transpose(A, At);
+
+    Dt = At;
+    cusp::transpose(D, Et);
+
+    ASSERT_EQUAL(Dt == Et, true);
+
+    At_coo = At;
+    ASSERT_EQUAL(At_coo.is_sorted_by_row_and_column(), true);
+}
+DECLARE_HOST_DEVICE_UNITTEST(TestTransposeCsrLongColumns);
+
 template <typename MatrixType1, typename MatrixType2>
 void transpose(my_system& system, const MatrixType1& A, MatrixType2& At)
 {
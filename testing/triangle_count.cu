@@ -0,0 +1,166 @@
+#include <unittest/unittest.h>
+
+#include <cusp/graph/k_truss.h>
+#include <cusp/graph/triangle_count.h>
+
+#include <cusp/array1d.h>
+#include <cusp/array2d.h>
+#include <cusp/coo_matrix.h>
+#include <cusp/csr_matrix.h>
+
+#include <cusp/gallery/poisson.h>
+#include <cusp/gallery/random.h>
+
+// dense symmetric adjacency without self loops
+template <typename MatrixType>
+cusp::array2d<int, cusp::host_memory> DenseAdjacency(const MatrixType& G)
+{
+    cusp::coo_matrix<int, float, cusp::host_memory> A(G);
+    cusp::array2d<int, cusp::host_memory> D(A.num_rows, A.num_cols, 0);
+
+    for(size_t n = 0; n < A.num_entries; n++)
+        if(A.row_indices[n] != A.column_indices[n])
+            D(A.row_indices[n], A.column_indices[n]) = 1;
+
+    return D;
+}
+
+template <typename MatrixType>
+size_t ReferenceTriangleCount(const MatrixType& G, cusp::array1d<int, cusp::host_memory>& triangles)
+{
+    cusp::array2d<int, cusp::host_memory> D = DenseAdjacency(G);
+    const int N = D.num_rows;
+    size_t total = 0;
+
+    triangles.resize(N);
+    thrust::fill(triangles.begin(), triangles.end(), 0);
+
+    for(int i = 0; i < N; i++)
+        for(int j = i + 1; j < N; j++)
+            for(int k = j + 1; k < N; k++)
+                if(D(i,j) && D(j,k) && D(i,k))
+                {
+                    triangles[i]++;
+                    triangles[j]++;
+                    triangles[k]++;
+                    total++;
+                }
+
+    return total;
+}
+
+// peel the edges with too few triangles
+template <typename MatrixType>
+cusp::array2d<int, cusp::host_memory> ReferenceKTruss(const MatrixType& G, const int k)
+{
+    cusp::array2d<int, cusp::host_memory> D = DenseAdjacency(G);
+    const int N = D.num_rows;
+
+    bool changed = true;
+
+    while(changed)
+    {
+        changed = false;
+
+        cusp::array2d<int, cusp::host_memory> E(D);
+
+        for(int i = 0; i < N; i++)
+            for(int j = 0; j < N; j++)
+            {
+                if(!D(i,j))
+                    continue;
+
+                int support = 0;
+                for(int m = 0; m < N; m++)
+                    support += D(i,m) && D(m,j);
+
+                if(support < k - 2)
+                {
+                    E(i,j) = 0;
+                    changed = true;
+                }
+            }
+
+        D = E;
+    }
+
+    return D;
+}
+
+template <class Space>
+void TestTriangleCount(void)
+{
+    std::vector< cusp::coo_matrix<int, float, cusp::host_memory> > graphs(3);
+    cusp::gallery::poisson9pt(graphs[0], 10, 10);
+    cusp::gallery::poisson5pt(graphs[1], 8, 8);
+
+    // symmetrize a random graph
+    {
+        cusp::coo_matrix<int, float, cusp::host_memory> R;
+        cusp::gallery::random(R, 120, 120, 900);
+
+        cusp::array2d<float, cusp::host_memory> D(R);
+        for(size_t i = 0; i < D.num_rows; i++)
+            for(size_t j = 0; j < D.num_cols; j++)
+                if(D(i,j) != 0)
+                    D(j,i) = D(i,j);
+
+        graphs[2] = D;
+    }
+
+    for(size_t n = 0; n < graphs.size(); n++)
+    {
+        cusp::csr_matrix<int, float, Space> G(graphs[n]);
+        cusp::array1d<int, Space> triangles(G.num_rows);
+
+        cusp::array1d<int, cusp::host_memory> reference;
+        const size_t expected = ReferenceTriangleCount(graphs[n], reference);
+
+        ASSERT_EQUAL(cusp::graph::triangle_count(G, triangles), expected);
+        ASSERT_EQUAL(triangles, reference);
+    }
+
+    // the five point stencil has no triangles
+    cusp::csr_matrix<int, float, Space> P(graphs[1]);
+    cusp::array1d<int, Space> none(P.num_rows, 1);
+    cusp::array1d<int, Space> zeros(P.num_rows, 0);
+
+    ASSERT_EQUAL(cusp::graph::triangle_count(P, none), 0);
+    ASSERT_EQUAL(none, zeros);
+}
+DECLARE_HOST_DEVICE_UNITTEST(TestTriangleCount);
+
+template <class Space>
+void TestKTruss(void)
+{
+    cusp::coo_matrix<int, float, cusp::host_memory> A;
+    cusp::gallery::poisson9pt(A, 9, 7);
+
+    // remove some edges so that the peeling cascades
+    for(size_t n = 0; n < A.num_entries; n += 7)
+        A.values[n] = 0;
+
+    cusp::array2d<float, cusp::host_memory> D(A);
+    for(size_t i = 0; i < D.num_rows; i++)
+        for(size_t j = 0; j < D.num_cols; j++)
+            if(D(i,j) == 0 || D(j,i) == 0)
+                D(i,j) = D(j,i) = 0;
+
+    cusp::coo_matrix<int, float, cusp::host_memory> B(D);
+    cusp::csr_matrix<int, float, Space> G(B);
+
+    for(int k = 2; k <= 5; k++)
+    {
+        cusp::csr_matrix<int, float, Space> T;
+        const size_t num_edges = cusp::graph::k_truss(G, k, T);
+
+        cusp::array2d<int, cusp::host_memory> reference = ReferenceKTruss(B, k);
+        cusp::array2d<int, cusp::host_memory> result = DenseAdjacency(T);
+
+        ASSERT_EQUAL(result.values, reference.values);
+        ASSERT_EQUAL(2 * num_edges, T.num_entries);
+    }
+
+    ASSERT_THROWS(cusp::graph::k_truss(G, 1, G), cusp::invalid_input_exception);
+}
+DECLARE_HOST_DEVICE_UNITTEST(TestKTruss);
@@ -0,0 +1,149 @@
+#include <unittest/unittest.h>
+
+#include <cusp/triangular_solve.h>
+
+#include <cusp/array1d.h>
+#include <cusp/array2d.h>
+#include <cusp/blas.h>
+#include <cusp/csr_matrix.h>
+#include <cusp/multiply.h>
+
+#include <cusp/gallery/poisson.h>
+
+template <class MemorySpace>
+void TestTriangularSolve(void)
+{
+    typedef float ValueType;
+
+    cusp::array2d<ValueType,cusp::host_memory> D(4,4,0.0f);
+    D(0,0) =  2.0f;                  D(0,2) =  1.0f;
+    D(1,0) = -1.0f;  D(1,1) =  4.0f;                  D(1,3) =  2.0f;
+    D(2,0) =  3.0f;  D(2,1) =  1.0f;  D(2,2) =  5.0f;
+                     D(3,1) = -2.0f;  D(3,2) =  1.0f;  D(3,3) =  1.0f;
+
+    cusp::csr_matrix<int,ValueType,MemorySpace> A(D);
+
+    cusp::array1d<ValueType,MemorySpace> b(4);
+    b[0] = 1.0f;  b[1] = 2.0f;  b[2] = 3.0f;  b[3] = 4.0f;
+
+    // lower triangle
+    {
+        cusp::triangular_solve_plan<int,MemorySpace> plan;
+        cusp::triangular_solve_analysis(A, plan, true);
+
+        ASSERT_EQUAL(plan.num_levels(), size_t(4));
+
+        cusp::array1d<ValueType,MemorySpace> x(4);
+        cusp::triangular_solve(A, b, x, plan);
+
+        cusp::array1d<ValueType,cusp::host_memory> expected(4);
+        expected[0] = 0.5f;
+        expected[1] = (2.0f + 0.5f) / 4.0f;
+        expected[2] = (3.0f - 3.0f * expected[0] - expected[1]) / 5.0f;
+        expected[3] =  4.0f + 2.0f * expected[1] - expected[2];
+
+        ASSERT_ALMOST_EQUAL(x, expected);
+    }
+
+    // upper triangle with unit diagonal, in place
+    {
+        cusp::triangular_solve_plan<int,MemorySpace> plan;
+        cusp::triangular_solve_analysis(A, plan, false, true);
+
+        ASSERT_EQUAL(plan.diagonal_indices.size(), size_t(0));
+
+        cusp::array1d<ValueType,MemorySpace> x(b);
+        cusp::triangular_solve(A, x, x, plan);
+
+        cusp::array1d<ValueType,cusp::host_memory> expected(4);
+        expected[3] = 4.0f;
+        expected[2] = 3.0f;
+        expected[1] = 2.0f - 2.0f * expected[3];
+        expected[0] = 1.0f - 1.0f * expected[2];
+
+        ASSERT_ALMOST_EQUAL(x, expected);
+    }
+}
+DECLARE_HOST_DEVICE_UNITTEST(TestTriangularSolve);
+
+template <class MemorySpace>
+void TestTriangularSolvePoisson(void)
+{
+    typedef float ValueType;
+
+    cusp::csr_matrix<int,ValueType,cusp::host_memory> A_h;
+    cusp::gallery::poisson5pt(A_h, 20, 30);
+
+    // keep the lower triangle of the Poisson matrix
+    cusp::csr_matrix<int,ValueType,cusp::host_memory> L_h(A_h.num_rows, A_h.num_cols, (A_h.num_entries + A_h.num_rows) / 2);
+    L_h.row_offsets[0] = 0;
+
+    for(int i = 0, n = 0; i < A_h.num_rows; i++)
+    {
+        for(int jj = A_h.row_offsets[i]; jj < A_h.row_offsets[i + 1]; jj++)
+        {
+            if(A_h.column_indices[jj] <= i)
+            {
+                L_h.column_indices[n] = A_h.column_indices[jj];
+                L_h.values[n]         = A_h.values[jj];
+                n++;
+            }
+        }
+
+        L_h.row_offsets[i + 1] = n;
+    }
+
+    cusp::csr_matrix<int,ValueType,MemorySpace> L(L_h);
+
+    cusp::triangular_solve_plan<int,MemorySpace> plan;
+    cusp::triangular_solve_analysis(L, plan);
+
+    // rows on the same anti-diagonal of the grid form a level
+    ASSERT_EQUAL(plan.num_levels(), size_t(20 + 30 - 1));
+
+    cusp::array1d<ValueType,MemorySpace> b = unittest::random_samples<ValueType>(L.num_rows);
+    cusp::array1d<ValueType,MemorySpace> x(L.num_rows);
+    cusp::array1d<ValueType,MemorySpace> Lx(L.num_rows);
+
+    cusp::triangular_solve(L, b, x, plan);
+    cusp::multiply(L, x, Lx);
+
+    ASSERT_ALMOST_EQUAL(Lx, b);
+
+    // the plan is reused for new values with the same pattern
+    cusp::blas::scal(L.values, ValueType(2));
+    cusp::triangular_solve(L, b, Lx, plan);
+    cusp::blas::scal(Lx, ValueType(2));
+
+    ASSERT_ALMOST_EQUAL(Lx, x);
+}
+DECLARE_HOST_DEVICE_UNITTEST(TestTriangularSolvePoisson);
+
+template <class MemorySpace>
+void TestTriangularSolveInvalidInput(void)
+{
+    typedef float ValueType;
+
+    cusp::array2d<ValueType,cusp::host_memory> D(3,3,0.0f);
+    D(0,0) = 1.0f;
+    D(1,0) = 1.0f;
+    D(2,1) = 1.0f;  D(2,2) = 1.0f;
+
+    cusp::csr_matrix<int,ValueType,MemorySpace> A(D);
+    cusp::triangular_solve_plan<int,MemorySpace> plan;
+
+    // row 1 has no diagonal entry
+    ASSERT_THROWS(cusp::triangular_solve_analysis(A, plan, true, false), cusp::invalid_input_exception);
+
+    cusp::triangular_solve_analysis(A, plan, true, true);
+
+    // the plan does not fit a matrix with a different pattern
+    cusp::csr_matrix<int,ValueType,MemorySpace> B;
+    cusp::gallery::poisson5pt(B, 3, 1);
+
+    cusp::array1d<ValueType,MemorySpace> b(3, ValueType(1));
+    cusp::array1d<ValueType,MemorySpace> x(3);
+
+    ASSERT_THROWS(cusp::triangular_solve(B, b, x, plan), cusp::invalid_input_exception);
+}
+DECLARE_HOST_DEVICE_UNITTEST(TestTriangularSolveInvalidInput);
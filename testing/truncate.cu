@@ -0,0 +1,113 @@
+#include <unittest/unittest.h>
+
+#include <cusp/precond/aggregation/truncate.h>
+
+#include <cusp/array2d.h>
+#include <cusp/coo_matrix.h>
+#include <cusp/csr_matrix.h>
+
+template <typename SparseMatrix>
+void _TestTruncateProlongator(void)
+{
+    cusp::array2d<float,cusp::host_memory> P(3,3);
+    P(0,0) = 0.50f;  P(0,1) = 0.05f;  P(0,2) = 0.45f;
+    P(1,0) = 0.10f;  P(1,1) = 0.60f;  P(1,2) = 0.30f;
+    P(2,0) = 0.00f;  P(2,1) = 1.00f;  P(2,2) = 0.00f;
+
+    SparseMatrix A(P);
+
+    // drop entries below 20% of the largest entry of each row
+    {
+        SparseMatrix B;
+        cusp::precond::aggregation::truncate_prolongator(A, B, 0.2);
+
+        cusp::array2d<float,cusp::host_memory> result(B);
+        cusp::array2d<float,cusp::host_memory> expected(3,3,0.0f);
+        expected(0,0) = 0.50f / 0.95f;  expected(0,2) = 0.45f / 0.95f;
+        expected(1,1) = 0.60f / 0.90f;  expected(1,2) = 0.30f / 0.90f;
+        expected(2,1) = 1.00f;
+
+        ASSERT_EQUAL(B.num_entries, 5);
+        ASSERT_ALMOST_EQUAL(result.values, expected.values);
+    }
+
+    // keep the largest entry of each row
+    {
+        SparseMatrix B;
+        cusp::precond::aggregation::truncate_prolongator(A, B, 0.0, 1);
+
+        cusp::array2d<float,cusp::host_memory> result(B);
+        cusp::array2d<float,cusp::host_memory> expected(3,3,0.0f);
+        expected(0,0) = 1.0f;
+        expected(1,1) = 1.0f;
+        expected(2,1) = 1.0f;
+
+        ASSERT_EQUAL(B.num_entries, 3);
+        ASSERT_ALMOST_EQUAL(result.values, expected.values);
+    }
+}
+
+template <class MemorySpace>
+void TestTruncateProlongator(void)
+{
+    _TestTruncateProlongator< cusp::coo_matrix<int,float,MemorySpace> >();
+    _TestTruncateProlongator< cusp::csr_matrix<int,float,MemorySpace> >();
+}
+DECLARE_HOST_DEVICE_UNITTEST(TestTruncateProlongator);
+
+template <typename SparseMatrix>
+void _TestTruncateOperator(void)
+{
+    cusp::array2d<float,cusp::host_memory> D(3,3);
+    D(0,0) =  4.0f;  D(0,1) = -1.0f;  D(0,2) = -0.1f;
+    D(1,0) = -1.0f;  D(1,1) =  4.0f;  D(1,2) = -1.0f;
+    D(2,0) = -0.1f;  D(2,1) = -1.0f;  D(2,2) =  4.0f;
+
+    SparseMatrix A(D);
+
+    // dropped off-diagonal entries are lumped onto the diagonal
+    {
+        SparseMatrix B;
+        cusp::precond::aggregation::truncate_operator(A, B, 0.25);
+
+        cusp::array2d<float,cusp::host_memory> result(B);
+        cusp::array2d<float,cusp::host_memory> expected(D);
+        expected(0,0) = 3.9f;  expected(0,2) = 0.0f;
+        expected(2,2) = 3.9f;  expected(2,0) = 0.0f;
+
+        ASSERT_EQUAL(B.num_entries, 7);
+        ASSERT_ALMOST_EQUAL(result.values, expected.values);
+    }
+
+    // keep the diagonal and the largest off-diagonal entry of each row,
+    // ties keep the first column
+    {
+        SparseMatrix B;
+        cusp::precond::aggregation::truncate_operator(A, B, 0.0, 1);
+
+        cusp::array2d<float,cusp::host_memory> result(B);
+        cusp::array2d<float,cusp::host_memory> expected(3,3,0.0f);
+        expected(0,0) =  3.9f;  expected(0,1) = -1.0f;
+        expected(1,0) = -1.0f;  expected(1,1) =  3.0f;
+        expected(2,1) = -1.0f;  expected(2,2) =  3.9f;
+
+        ASSERT_EQUAL(B.num_entries, 6);
+        ASSERT_ALMOST_EQUAL(result.values, expected.values);
+    }
+
+    // truncation in place
+    {
+        SparseMatrix B(A);
+        cusp::precond::aggregation::truncate_operator(B, B, 0.25);
+
+        ASSERT_EQUAL(B.num_entries, 7);
+    }
+}
+
+template <class MemorySpace>
+void TestTruncateOperator(void)
+{
+    _TestTruncateOperator< cusp::coo_matrix<int,float,MemorySpace> >();
+    _TestTruncateOperator< cusp::csr_matrix<int,float,MemorySpace> >();
+}
+DECLARE_HOST_DEVICE_UNITTEST(TestTruncateOperator);
@@ -9,6 +9,8 @@
 #include <cusp/ell_matrix.h>
 #include <cusp/hyb_matrix.h>
 
+#include <cusp/gallery/poisson.h>
+
 template <typename MemorySpace>
 void TestIsValidMatrixCoo(void)
 {
@@ -303,3 +305,107 @@ void TestAssertIsValidMatrix(void)
 }
 DECLARE_SPARSE_MATRIX_UNITTEST(TestAssertIsValidMatrix);
 
+
+
+template <typename MemorySpace>
+void TestValidateMatrix(void)
+{
+    cusp::csr_matrix<int, float, MemorySpace> P;
+    cusp::gallery::poisson5pt(P, 4, 5);
+
+    // sorted, symmetric pattern
+    {
+        cusp::matrix_structure s = cusp::validate_matrix(P, true);
+        ASSERT_EQUAL(s.valid, true);
+        ASSERT_EQUAL(s.sorted, true);
+        ASSERT_EQUAL(s.has_duplicates, false);
+        ASSERT_EQUAL(s.symmetric_pattern, true);
+    }
+    {
+        cusp::coo_matrix<int, float, MemorySpace> M(P);
+        cusp::matrix_structure s = cusp::validate_matrix(M, true);
+        ASSERT_EQUAL(s.valid, true);
+        ASSERT_EQUAL(s.sorted, true);
+        ASSERT_EQUAL(s.has_duplicates, false);
+        ASSERT_EQUAL(s.symmetric_pattern, true);
+    }
+
+    // symmetry is only checked on request
+    {
+        cusp::matrix_structure s = cusp::validate_matrix(P);
+        ASSERT_EQUAL(s.valid, true);
+        ASSERT_EQUAL(s.symmetric_pattern, false);
+    }
+
+    cusp::coo_matrix<int, float, cusp::host_memory> A(3, 3, 5);
+    A.row_indices[0] = 0; A.column_indices[0] = 0; A.values[0] = 1;
+    A.row_indices[1] = 0; A.column_indices[1] = 2; A.values[1] = 2;
+    A.row_indices[2] = 1; A.column_indices[2] = 1; A.values[2] = 3;
+    A.row_indices[3] = 2; A.column_indices[3] = 0; A.values[3] = 4;
+    A.row_indices[4] = 2; A.column_indices[4] = 2; A.values[4] = 5;
+
+    // unsorted columns
+    {
+        cusp::coo_matrix<int, float, cusp::host_memory> B(A);
+        B.column_indices[0] = 2;
+        B.column_indices[1] = 0;
+
+        cusp::coo_matrix<int, float, MemorySpace> M(B);
+        cusp::matrix_structure s = cusp::validate_matrix(M, true);
+        ASSERT_EQUAL(s.valid, true);
+        ASSERT_EQUAL(s.sorted, false);
+        ASSERT_EQUAL(s.has_duplicates, false);
+        ASSERT_EQUAL(s.symmetric_pattern, true);
+
+        cusp::csr_matrix<int, float, MemorySpace> N(M);
+        s = cusp::validate_matrix(N, true);
+        ASSERT_EQUAL(s.valid, true);
+        ASSERT_EQUAL(s.sorted, false);
+        ASSERT_EQUAL(s.symmetric_pattern, true);
+    }
+
+    // duplicate entry
+    {
+        cusp::coo_matrix<int, float, cusp::host_memory> B(A);
+        B.column_indices[4] = 0;
+
+        cusp::csr_matrix<int, float, MemorySpace> M(B);
+        cusp::matrix_structure s = cusp::validate_matrix(M, true);
+        ASSERT_EQUAL(s.valid, true);
+        ASSERT_EQUAL(s.sorted, true);
+        ASSERT_EQUAL(s.has_duplicates, true);
+        ASSERT_EQUAL(s.symmetric_pattern, true);
+    }
+
+    // nonsymmetric pattern
+    {
+        cusp::coo_matrix<int, float, cusp::host_memory> B(A);
+        B.column_indices[3] = 1;
+
+        cusp::coo_matrix<int, float, MemorySpace> M(B);
+        cusp::matrix_structure s = cusp::validate_matrix(M, true);
+        ASSERT_EQUAL(s.valid, true);
+        ASSERT_EQUAL(s.has_duplicates, false);
+        ASSERT_EQUAL(s.symmetric_pattern, false);
+    }
+
+    // decreasing row offsets
+    {
+        cusp::csr_matrix<int, float, cusp::host_memory> B(A);
+        B.row_offsets[1] = 4;
+
+        cusp::csr_matrix<int, float, MemorySpace> M(B);
+        ASSERT_EQUAL(cusp::validate_matrix(M).valid, false);
+        ASSERT_EQUAL(cusp::is_valid_matrix(M), false);
+    }
+
+    // out of bounds column
+    {
+        cusp::coo_matrix<int, float, cusp::host_memory> B(A);
+        B.column_indices[2] = 3;
+
+        cusp::coo_matrix<int, float, MemorySpace> M(B);
+        ASSERT_EQUAL(cusp::validate_matrix(M).valid, false);
+    }
+}
+DECLARE_HOST_DEVICE_UNITTEST(TestValidateMatrix);
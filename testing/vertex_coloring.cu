@@ -4,6 +4,11 @@
 
 #include <cusp/csr_matrix.h>
 
+#include <cusp/gallery/poisson.h>
+
+#include <thrust/extrema.h>
+#include <thrust/fill.h>
+
 template <typename MatrixType, typename ArrayType>
 size_t vertex_coloring(my_system& system, const MatrixType& G, ArrayType& colors)
 {
@@ -27,3 +32,82 @@ void TestVertexColoringDispatch()
 }
 DECLARE_UNITTEST(TestVertexColoringDispatch);
 
+
+template <typename MatrixType, typename ArrayType>
+void check_coloring(const MatrixType& G, const ArrayType& colors, const size_t num_colors)
+{
+    typedef typename MatrixType::index_type IndexType;
+
+    cusp::csr_matrix<IndexType,float,cusp::host_memory> h_G(G);
+    cusp::array1d<IndexType,cusp::host_memory> h_colors(colors);
+
+    for(size_t i = 0; i < h_G.num_rows; i++)
+    {
+        ASSERT_EQUAL(h_colors[i] >= 0 && h_colors[i] < IndexType(num_colors), true);
+
+        for(IndexType jj = h_G.row_offsets[i]; jj < h_G.row_offsets[i + 1]; jj++)
+        {
+            const IndexType j = h_G.column_indices[jj];
+
+            if(size_t(j) != i)
+                ASSERT_EQUAL(h_colors[i] != h_colors[j], true);
+        }
+    }
+}
+
+template <class MemorySpace>
+void TestVertexColoringMethods(void)
+{
+    cusp::csr_matrix<int,float,MemorySpace> G;
+    cusp::gallery::poisson9pt(G, 40, 40);
+
+    cusp::array1d<int,MemorySpace> colors(G.num_rows);
+
+    size_t num_greedy = cusp::graph::vertex_coloring(G, colors, cusp::graph::GREEDY);
+    check_coloring(G, colors, num_greedy);
+
+    size_t num_jpl = cusp::graph::vertex_coloring(G, colors, cusp::graph::JONES_PLASSMANN_LUBY);
+    check_coloring(G, colors, num_jpl);
+
+    size_t num_speculative = cusp::graph::vertex_coloring(G, colors, cusp::graph::SPECULATIVE_GREEDY);
+    check_coloring(G, colors, num_speculative);
+
+    // the 9 point stencil needs at least 4 colors and at most 9 by first fit
+    ASSERT_EQUAL(num_jpl >= 4 && num_jpl <= 9, true);
+    ASSERT_EQUAL(num_speculative >= 4 && num_speculative <= 9, true);
+}
+DECLARE_HOST_DEVICE_UNITTEST(TestVertexColoringMethods);
+
+template <class MemorySpace>
+void TestVertexColoringMaxColorsAndBalance(void)
+{
+    cusp::csr_matrix<int,float,MemorySpace> G;
+    cusp::gallery::poisson5pt(G, 50, 30);
+
+    cusp::array1d<int,MemorySpace> colors(G.num_rows);
+
+    size_t num_colors = cusp::graph::vertex_coloring(G, colors, cusp::graph::JONES_PLASSMANN_LUBY);
+
+    cusp::array1d<int,cusp::host_memory> h_colors(colors);
+    cusp::array1d<size_t,cusp::host_memory> sizes(num_colors, 0);
+    for(size_t i = 0; i < h_colors.size(); i++)
+        sizes[h_colors[i]]++;
+    size_t max_size = *thrust::max_element(sizes.begin(), sizes.end());
+
+    // the reduction never increases the number of colors
+    size_t num_reduced = cusp::graph::vertex_coloring(G, colors, cusp::graph::JONES_PLASSMANN_LUBY, 2);
+    check_coloring(G, colors, num_reduced);
+    ASSERT_EQUAL(num_reduced <= num_colors, true);
+
+    // balancing keeps the colors and does not grow the largest class
+    size_t num_balanced = cusp::graph::vertex_coloring(G, colors, cusp::graph::JONES_PLASSMANN_LUBY, 0, true);
+    check_coloring(G, colors, num_balanced);
+    ASSERT_EQUAL(num_balanced, num_colors);
+
+    h_colors = colors;
+    thrust::fill(sizes.begin(), sizes.end(), 0);
+    for(size_t i = 0; i < h_colors.size(); i++)
+        sizes[h_colors[i]]++;
+    ASSERT_EQUAL(*thrust::max_element(sizes.begin(), sizes.end()) <= max_size, true);
+}
+DECLARE_HOST_DEVICE_UNITTEST(TestVertexColoringMaxColorsAndBalance);